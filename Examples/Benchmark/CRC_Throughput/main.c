@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include "main.h"
+
+/*
+ * Throughput of the CRC paths of BSP_CRC over a sweep of buffer sizes, built
+ * with USE_BSP=y. The results are printed on USART1 TX PA9 at 115200.
+ *
+ * For each model the line gives the cycles per byte of:
+ *   bit    BSP_CRC_Bitwise(), the reference the other paths are checked with
+ *   tab1   one table, one byte per step
+ *   tab4   slice-by-4, four tables
+ *   tab8   slice-by-8, eight tables
+ *   hw     the CRC calculator fed by the CPU, models of its polynomial only
+ *   dma    HAL_CRC_Calculate_DMA() on the word buffer, CRC-32/MPEG-2 only,
+ *          from the start call to the main loop woken in WFE by the
+ *          BSP_SYNC event of the completion callback
+ * A path giving another CRC than the reference prints "err".
+ * The tables are built in RAM by BSP_CRC_Init(), its cycles are given on the
+ * model line.
+ */
+
+/* Buffer sizes of the sweep, in bytes */
+static const uint32_t aBenchSize[] = {16U, 64U, 256U, 1024U, 4096U};
+#define APP_BENCH_SIZE_MAX  4096U
+
+/* Slices of the table paths */
+static const uint32_t aSlices[] = {1U, 4U, 8U};
+#define APP_SLICES_MAX      8U
+
+UART_HandleTypeDef UartHandle;
+CRC_HandleTypeDef  CrcHandle;
+
+static BSP_CRCMUX_TypeDef   CrcMux;
+static BSP_CRC_TableTypeDef aTable[APP_SLICES_MAX];
+
+static const BSP_CRC_ModelTypeDef *const aModel[] =
+{
+  &BSP_CRC_Model_CRC32, &BSP_CRC_Model_CRC32_MPEG2, &BSP_CRC_Model_CRC32C,
+  &BSP_CRC_Model_CRC16_MODBUS, &BSP_CRC_Model_CRC16_CCITT, &BSP_CRC_Model_CRC8
+};
+static const char *const aModelName[] =
+{
+  "crc32", "mpeg2", "crc32c", "modbus", "ccitt", "crc8"
+};
+
+/* Word buffer for the DMA path, read as bytes by the other ones */
+static uint32_t aData[APP_BENCH_SIZE_MAX / 4U];
+
+/* Set by the callbacks of the DMA path, waited for in WFE */
+#define APP_EVENT_DONE      0x01U
+#define APP_EVENT_ERROR     0x02U
+static BSP_SYNC_EventTypeDef DmaEvent;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CrcConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_BenchModel(uint32_t Model);
+static void APP_PrintRate(uint32_t Cycles, uint32_t Size, uint32_t Match);
+static uint32_t APP_DmaRun(uint32_t Size, uint32_t *pCrc);
+
+
+int main(void)
+{
+  uint8_t *data = (uint8_t *)aData;
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_CrcConfig();
+
+  for (i = 0U; i < APP_BENCH_SIZE_MAX; i++)
+  {
+    data[i] = (uint8_t)((i * 37U) ^ (i >> 8));
+  }
+
+  while (1)
+  {
+    printf("\r\nHCLK %lu Hz, cycles per byte x100\r\n", HAL_RCC_GetHCLKFreq());
+    for (i = 0U; i < (sizeof(aModel) / sizeof(aModel[0])); i++)
+    {
+      APP_BenchModel(i);
+    }
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Run the sweep of one model on all its paths.
+  * @param  Model Index in aModel.
+  */
+static void APP_BenchModel(uint32_t Model)
+{
+  const BSP_CRC_ModelTypeDef *model = aModel[Model];
+  const uint8_t *data = (const uint8_t *)aData;
+  BSP_CRC_TypeDef hcrcsw;
+  uint32_t reference;
+  uint32_t crc;
+  uint32_t start;
+  uint32_t cycles;
+  uint32_t size;
+  uint32_t s;
+  uint32_t i;
+
+  start = DWT->CYCCNT;
+  (void)BSP_CRC_Init(&hcrcsw, model, aTable, APP_SLICES_MAX);
+  cycles = DWT->CYCCNT - start;
+  printf("%s, tables %lu cycles\r\n", aModelName[Model], cycles);
+  printf("  size      bit     tab1     tab4     tab8       hw      dma\r\n");
+
+  for (i = 0U; i < (sizeof(aBenchSize) / sizeof(aBenchSize[0])); i++)
+  {
+    size = aBenchSize[i];
+    printf("%6lu", size);
+
+    start = DWT->CYCCNT;
+    reference = BSP_CRC_Bitwise(model, data, size);
+    cycles = DWT->CYCCNT - start;
+    APP_PrintRate(cycles, size, 1U);
+
+    for (s = 0U; s < (sizeof(aSlices) / sizeof(aSlices[0])); s++)
+    {
+      (void)BSP_CRC_Init(&hcrcsw, model, aTable, aSlices[s]);
+      start = DWT->CYCCNT;
+      (void)BSP_CRC_Compute(&hcrcsw, data, size, &crc);
+      cycles = DWT->CYCCNT - start;
+      APP_PrintRate(cycles, size, (crc == reference) ? 1U : 0U);
+    }
+
+    (void)BSP_CRC_Init(&hcrcsw, model, NULL, 0U);
+    (void)BSP_CRC_AttachHardware(&hcrcsw, &CrcMux);
+    if (hcrcsw.Path == BSP_CRC_PATH_HARDWARE)
+    {
+      start = DWT->CYCCNT;
+      (void)BSP_CRC_Compute(&hcrcsw, data, size, &crc);
+      cycles = DWT->CYCCNT - start;
+      APP_PrintRate(cycles, size, (crc == reference) ? 1U : 0U);
+      BSP_CRCMUX_Close(&hcrcsw.Session);
+    }
+    else
+    {
+      printf("        -");
+    }
+
+    if (model == &BSP_CRC_Model_CRC32_MPEG2)
+    {
+      cycles = APP_DmaRun(size, &crc);
+      APP_PrintRate(cycles, size, (crc == reference) ? 1U : 0U);
+    }
+    else
+    {
+      printf("        -");
+    }
+    printf("\r\n");
+  }
+}
+
+/**
+  * @brief  Print the cycles per byte of a run.
+  * @param  Cycles Cycles of the run.
+  * @param  Size   Number of bytes.
+  * @param  Match  0 when the CRC differs from the reference.
+  */
+static void APP_PrintRate(uint32_t Cycles, uint32_t Size, uint32_t Match)
+{
+  uint32_t rate = (Cycles * 100U) / Size;
+
+  if (Match == 0U)
+  {
+    printf("      err");
+    return;
+  }
+  printf(" %4lu.%02lu", rate / 100U, rate % 100U);
+}
+
+/**
+  * @brief  Feed the word buffer with the DMA and wait for the callback.
+  * @param  Size Number of bytes, a multiple of 4.
+  * @param  pCrc CRC of the buffer.
+  * @retval Cycles from the start call to the callback.
+  */
+static uint32_t APP_DmaRun(uint32_t Size, uint32_t *pCrc)
+{
+  uint32_t start;
+  uint32_t cycles;
+
+  /* The sessions of the hardware path leave their configuration in the handle */
+  CrcHandle.Init.DefaultInitValueUse     = DEFAULT_INIT_VALUE_ENABLE;
+  CrcHandle.Init.InputDataInversionMode  = CRC_INPUTDATA_INVERSION_NONE;
+  CrcHandle.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_DISABLE;
+  CrcHandle.InputDataFormat              = CRC_INPUTDATA_FORMAT_WORDS;
+
+  start = DWT->CYCCNT;
+  if (HAL_CRC_Calculate_DMA(&CrcHandle, aData, Size / 4U) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  if (BSP_SYNC_EventWait(&DmaEvent, APP_EVENT_DONE | APP_EVENT_ERROR, BSP_SYNC_WAIT_ANY, 1000U) != APP_EVENT_DONE)
+  {
+    APP_ErrorHandler();
+  }
+  cycles = DWT->CYCCNT - start;
+  *pCrc = HAL_CRC_GetValue(&CrcHandle);
+
+  return cycles;
+}
+
+void HAL_CRC_CpltCallback(CRC_HandleTypeDef *hcrc)
+{
+  BSP_SYNC_EventSet(&DmaEvent, APP_EVENT_DONE);
+}
+
+void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *hcrc)
+{
+  BSP_SYNC_EventSet(&DmaEvent, APP_EVENT_ERROR);
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_CrcConfig(void)
+{
+  /* Default configuration, words fed as they are, for the DMA path */
+  CrcHandle.Instance = CRC;
+  if (HAL_CRC_Init(&CrcHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  if (BSP_CRCMUX_Init(&CrcMux, &CrcHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
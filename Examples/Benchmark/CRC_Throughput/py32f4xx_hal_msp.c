@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_msp.c
+  * @author  MCU Application Team
+  * @brief   This file provides code for the MSP Initialization
+  *          and de-Initialization codes.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2023 Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by Puya under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef HdmaCrc;
+
+/* Private function prototypes -----------------------------------------------*/
+/* External functions --------------------------------------------------------*/
+
+/**
+  * @brief Initialize global MSP
+  */
+void HAL_MspInit(void)
+{
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  __HAL_RCC_PWR_CLK_ENABLE();
+}
+
+/**
+  * @brief Initialize UART MSP, PA9 USART1 TX
+  */
+void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_USART1_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin = GPIO_PIN_9;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF2_USART1;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+/**
+  * @brief Initialize CRC MSP, memory to memory DMA channel feeding DR
+  */
+void HAL_CRC_MspInit(CRC_HandleTypeDef *hcrc)
+{
+  __HAL_RCC_CRC_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  HdmaCrc.Instance                 = DMA1_Channel1;
+  HdmaCrc.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+  HdmaCrc.Init.PeriphInc           = DMA_PINC_ENABLE;     /* Source, the buffer */
+  HdmaCrc.Init.MemInc              = DMA_MINC_DISABLE;    /* Destination, the CRC data register */
+  HdmaCrc.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  HdmaCrc.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+  HdmaCrc.Init.Mode                = DMA_NORMAL;
+  HdmaCrc.Init.Priority            = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&HdmaCrc) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  __HAL_LINKDMA(hcrc, hdma, HdmaCrc);
+
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+}
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
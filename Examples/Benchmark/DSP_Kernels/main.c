@@ -0,0 +1,470 @@
+#include <stdio.h>
+#include <math.h>
+#include "main.h"
+
+/*
+ * Cycles of the kernels of BSP_DSP, built with USE_BSP=y. The results are
+ * printed on USART1 TX PA9 at 115200.
+ *
+ * For each kernel the line gives the cycles per sample, or per complex point
+ * for the FFT, of the Q15, Q31 and float versions on the same two tone
+ * signal, then the largest deviation of the Q15 and Q31 results from the
+ * float one, in millionths of the full scale:
+ *   fir32   32 taps low pass FIR, blocks of APP_BLOCK_SIZE samples
+ *   biq2    two stage Butterworth low pass cascade
+ *   fft256  forward complex FFT, the float result divided by the length
+ *   fft1k   for the comparison
+ *   ifft1k  inverse transform of the forward one
+ *   dot     dot product of the signal with itself shifted
+ *   rms     root mean square of the signal
+ */
+
+#define APP_BLOCK_SIZE      256U
+#define APP_FIR_TAPS        32U
+#define APP_BIQUAD_STAGES   2U
+#define APP_FFT_LENGTH_MAX  1024U
+#define APP_PI              3.14159265358979f
+
+UART_HandleTypeDef UartHandle;
+
+/* Signal, in the three formats */
+static int16_t aSignalQ15[APP_BLOCK_SIZE];
+static int32_t aSignalQ31[APP_BLOCK_SIZE];
+static float   aSignalF32[APP_BLOCK_SIZE];
+
+/* Outputs of the block kernels */
+static int16_t aOutQ15[APP_BLOCK_SIZE];
+static int32_t aOutQ31[APP_BLOCK_SIZE];
+static float   aOutF32[APP_BLOCK_SIZE];
+
+/* Filters */
+static int16_t aFirCoeffQ15[APP_FIR_TAPS];
+static int32_t aFirCoeffQ31[APP_FIR_TAPS];
+static float   aFirCoeffF32[APP_FIR_TAPS];
+static int16_t aFirStateQ15[APP_FIR_TAPS + APP_BLOCK_SIZE - 1U];
+static int32_t aFirStateQ31[APP_FIR_TAPS + APP_BLOCK_SIZE - 1U];
+static float   aFirStateF32[APP_FIR_TAPS + APP_BLOCK_SIZE - 1U];
+static int16_t aBiqCoeffQ15[5U * APP_BIQUAD_STAGES];
+static int32_t aBiqCoeffQ31[5U * APP_BIQUAD_STAGES];
+static float   aBiqCoeffF32[5U * APP_BIQUAD_STAGES];
+static int16_t aBiqStateQ15[4U * APP_BIQUAD_STAGES];
+static int32_t aBiqStateQ31[4U * APP_BIQUAD_STAGES];
+static float   aBiqStateF32[2U * APP_BIQUAD_STAGES];
+
+/* FFT points and twiddles, each format run in turn */
+static int16_t aFftQ15[2U * APP_FFT_LENGTH_MAX] __ALIGNED(4);
+static int32_t aFftQ31[2U * APP_FFT_LENGTH_MAX];
+static float   aFftF32[2U * APP_FFT_LENGTH_MAX];
+static union
+{
+  int16_t Q15[(3U * APP_FFT_LENGTH_MAX) / 2U];
+  int32_t Q31[(3U * APP_FFT_LENGTH_MAX) / 2U];
+  float   F32[(3U * APP_FFT_LENGTH_MAX) / 2U];
+} Twiddle;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_SignalConfig(void);
+static void APP_FilterConfig(void);
+static void APP_BenchFir(void);
+static void APP_BenchBiquad(void);
+static void APP_BenchFft(uint32_t Length, uint32_t Inverse);
+static void APP_BenchStats(void);
+static void APP_PrintRate(uint32_t Cycles, uint32_t Count);
+static void APP_PrintDeviation(float Deviation);
+static int16_t APP_ToQ15(float Value);
+static int32_t APP_ToQ31(float Value);
+
+
+int main(void)
+{
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_SignalConfig();
+  APP_FilterConfig();
+
+  while (1)
+  {
+    printf("\r\nHCLK %lu Hz, cycles per sample x100, deviation in ppm of full scale\r\n", HAL_RCC_GetHCLKFreq());
+    printf("kernel       q15      q31      f32   dev15   dev31\r\n");
+    APP_BenchFir();
+    APP_BenchBiquad();
+    APP_BenchFft(256U, 0U);
+    APP_BenchFft(1024U, 0U);
+    APP_BenchFft(1024U, 1U);
+    APP_BenchStats();
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Two tones of 0.4 each, the first one in the pass band of the filters.
+  */
+static void APP_SignalConfig(void)
+{
+  float value;
+  uint32_t i;
+
+  for (i = 0U; i < APP_BLOCK_SIZE; i++)
+  {
+    value = (0.4f * sinf((2.0f * APP_PI * 5.0f * (float)i) / (float)APP_BLOCK_SIZE)) +
+            (0.4f * sinf((2.0f * APP_PI * 83.0f * (float)i) / (float)APP_BLOCK_SIZE));
+    aSignalQ15[i] = APP_ToQ15(value);
+    aSignalQ31[i] = APP_ToQ31(value);
+    aSignalF32[i] = value;
+  }
+}
+
+/**
+  * @brief  Hann windowed sinc FIR and Butterworth biquads, cut off at fs / 8.
+  */
+static void APP_FilterConfig(void)
+{
+  const float k = tanf(APP_PI / 8.0f);
+  const float norm = 1.0f / (1.0f + (1.41421356f * k) + (k * k));
+  float biquad[5];
+  float sum = 0.0f;
+  float t;
+  uint32_t i;
+  uint32_t s;
+
+  for (i = 0U; i < APP_FIR_TAPS; i++)
+  {
+    t = (float)i - ((float)(APP_FIR_TAPS - 1U) / 2.0f);
+    aFirCoeffF32[i] = ((t == 0.0f) ? 0.25f : (sinf(APP_PI * 0.25f * t) / (APP_PI * t))) *
+                      (0.5f - (0.5f * cosf((2.0f * APP_PI * (float)i) / (float)(APP_FIR_TAPS - 1U))));
+    sum += aFirCoeffF32[i];
+  }
+  /* Unity gain, the taps symmetric so already time reversed */
+  for (i = 0U; i < APP_FIR_TAPS; i++)
+  {
+    aFirCoeffF32[i] /= sum;
+    aFirCoeffQ15[i] = APP_ToQ15(aFirCoeffF32[i]);
+    aFirCoeffQ31[i] = APP_ToQ31(aFirCoeffF32[i]);
+  }
+
+  /* Feedback signs included, the fixed point ones scaled by 2^-1 */
+  biquad[0] = k * k * norm;
+  biquad[1] = 2.0f * biquad[0];
+  biquad[2] = biquad[0];
+  biquad[3] = -2.0f * ((k * k) - 1.0f) * norm;
+  biquad[4] = -(1.0f - (1.41421356f * k) + (k * k)) * norm;
+  for (s = 0U; s < APP_BIQUAD_STAGES; s++)
+  {
+    for (i = 0U; i < 5U; i++)
+    {
+      aBiqCoeffF32[(5U * s) + i] = biquad[i];
+      aBiqCoeffQ15[(5U * s) + i] = APP_ToQ15(biquad[i] / 2.0f);
+      aBiqCoeffQ31[(5U * s) + i] = APP_ToQ31(biquad[i] / 2.0f);
+    }
+  }
+}
+
+/**
+  * @brief  FIR of the three formats.
+  */
+static void APP_BenchFir(void)
+{
+  BSP_DSP_FIR_Q15_TypeDef firq15;
+  BSP_DSP_FIR_Q31_TypeDef firq31;
+  BSP_DSP_FIR_F32_TypeDef firf32;
+  float dev15 = 0.0f;
+  float dev31 = 0.0f;
+  uint32_t start;
+  uint32_t i;
+
+  (void)BSP_DSP_FIR_Q15_Init(&firq15, APP_FIR_TAPS, aFirCoeffQ15, aFirStateQ15, APP_BLOCK_SIZE);
+  (void)BSP_DSP_FIR_Q31_Init(&firq31, APP_FIR_TAPS, aFirCoeffQ31, aFirStateQ31, APP_BLOCK_SIZE);
+  (void)BSP_DSP_FIR_F32_Init(&firf32, APP_FIR_TAPS, aFirCoeffF32, aFirStateF32, APP_BLOCK_SIZE);
+
+  printf("fir32   ");
+  start = DWT->CYCCNT;
+  BSP_DSP_FIR_Q15_Process(&firq15, aSignalQ15, aOutQ15, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  BSP_DSP_FIR_Q31_Process(&firq31, aSignalQ31, aOutQ31, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  BSP_DSP_FIR_F32_Process(&firf32, aSignalF32, aOutF32, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+
+  for (i = 0U; i < APP_BLOCK_SIZE; i++)
+  {
+    dev15 = fmaxf(dev15, fabsf(((float)aOutQ15[i] / 32768.0f) - aOutF32[i]));
+    dev31 = fmaxf(dev31, fabsf(((float)aOutQ31[i] / 2147483648.0f) - aOutF32[i]));
+  }
+  APP_PrintDeviation(dev15);
+  APP_PrintDeviation(dev31);
+  printf("\r\n");
+}
+
+/**
+  * @brief  Biquad cascade of the three formats.
+  */
+static void APP_BenchBiquad(void)
+{
+  BSP_DSP_BIQUAD_Q15_TypeDef biqq15;
+  BSP_DSP_BIQUAD_Q31_TypeDef biqq31;
+  BSP_DSP_BIQUAD_F32_TypeDef biqf32;
+  float dev15 = 0.0f;
+  float dev31 = 0.0f;
+  uint32_t start;
+  uint32_t i;
+
+  (void)BSP_DSP_BIQUAD_Q15_Init(&biqq15, APP_BIQUAD_STAGES, aBiqCoeffQ15, aBiqStateQ15, 1U);
+  (void)BSP_DSP_BIQUAD_Q31_Init(&biqq31, APP_BIQUAD_STAGES, aBiqCoeffQ31, aBiqStateQ31, 1U);
+  (void)BSP_DSP_BIQUAD_F32_Init(&biqf32, APP_BIQUAD_STAGES, aBiqCoeffF32, aBiqStateF32);
+
+  printf("biq2    ");
+  start = DWT->CYCCNT;
+  BSP_DSP_BIQUAD_Q15_Process(&biqq15, aSignalQ15, aOutQ15, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  BSP_DSP_BIQUAD_Q31_Process(&biqq31, aSignalQ31, aOutQ31, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  BSP_DSP_BIQUAD_F32_Process(&biqf32, aSignalF32, aOutF32, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+
+  for (i = 0U; i < APP_BLOCK_SIZE; i++)
+  {
+    dev15 = fmaxf(dev15, fabsf(((float)aOutQ15[i] / 32768.0f) - aOutF32[i]));
+    dev31 = fmaxf(dev31, fabsf(((float)aOutQ31[i] / 2147483648.0f) - aOutF32[i]));
+  }
+  APP_PrintDeviation(dev15);
+  APP_PrintDeviation(dev31);
+  printf("\r\n");
+}
+
+/**
+  * @brief  FFT of the three formats on the signal, repeated up to Length.
+  * @param  Length  Complex points.
+  * @param  Inverse 1 to time the inverse transform of the forward result.
+  */
+static void APP_BenchFft(uint32_t Length, uint32_t Inverse)
+{
+  BSP_DSP_FFT_Q15_TypeDef fftq15;
+  BSP_DSP_FFT_Q31_TypeDef fftq31;
+  BSP_DSP_FFT_F32_TypeDef fftf32;
+  float dev15 = 0.0f;
+  float dev31 = 0.0f;
+  float scale;
+  uint32_t start;
+  uint32_t i;
+
+  for (i = 0U; i < Length; i++)
+  {
+    aFftQ15[2U * i]        = aSignalQ15[i % APP_BLOCK_SIZE];
+    aFftQ15[(2U * i) + 1U] = 0;
+    aFftQ31[2U * i]        = aSignalQ31[i % APP_BLOCK_SIZE];
+    aFftQ31[(2U * i) + 1U] = 0;
+    aFftF32[2U * i]        = aSignalF32[i % APP_BLOCK_SIZE];
+    aFftF32[(2U * i) + 1U] = 0.0f;
+  }
+
+  printf((Inverse != 0U) ? "ifft%luk  " : ((Length >= 1024U) ? "fft%luk   " : "fft%lu  "),
+         (Length >= 1024U) ? (Length / 1024U) : Length);
+
+  /* The twiddles are built out of the timed runs */
+  (void)BSP_DSP_FFT_Q15_Init(&fftq15, Length, Twiddle.Q15);
+  if (Inverse != 0U)
+  {
+    BSP_DSP_FFT_Q15_Process(&fftq15, aFftQ15, BSP_DSP_FFT_FORWARD);
+  }
+  start = DWT->CYCCNT;
+  BSP_DSP_FFT_Q15_Process(&fftq15, aFftQ15, Inverse);
+  APP_PrintRate(DWT->CYCCNT - start, Length);
+
+  (void)BSP_DSP_FFT_Q31_Init(&fftq31, Length, Twiddle.Q31);
+  if (Inverse != 0U)
+  {
+    BSP_DSP_FFT_Q31_Process(&fftq31, aFftQ31, BSP_DSP_FFT_FORWARD);
+  }
+  start = DWT->CYCCNT;
+  BSP_DSP_FFT_Q31_Process(&fftq31, aFftQ31, Inverse);
+  APP_PrintRate(DWT->CYCCNT - start, Length);
+
+  (void)BSP_DSP_FFT_F32_Init(&fftf32, Length, Twiddle.F32);
+  if (Inverse != 0U)
+  {
+    BSP_DSP_FFT_F32_Process(&fftf32, aFftF32, BSP_DSP_FFT_FORWARD);
+  }
+  start = DWT->CYCCNT;
+  BSP_DSP_FFT_F32_Process(&fftf32, aFftF32, Inverse);
+  APP_PrintRate(DWT->CYCCNT - start, Length);
+
+  /* The fixed point transforms divide by Length in both directions, the float
+     one in the inverse direction only */
+  scale = 1.0f / (float)Length;
+  for (i = 0U; i < (2U * Length); i++)
+  {
+    dev15 = fmaxf(dev15, fabsf(((float)aFftQ15[i] / 32768.0f) - (aFftF32[i] * scale)));
+    dev31 = fmaxf(dev31, fabsf(((float)aFftQ31[i] / 2147483648.0f) - (aFftF32[i] * scale)));
+  }
+  APP_PrintDeviation(dev15);
+  APP_PrintDeviation(dev31);
+  printf("\r\n");
+}
+
+/**
+  * @brief  Dot product and RMS of the three formats.
+  */
+static void APP_BenchStats(void)
+{
+  int64_t dotq15;
+  int64_t dotq31;
+  float dotf32;
+  int16_t rmsq15;
+  int32_t rmsq31;
+  float rmsf32;
+  uint32_t start;
+
+  printf("dot     ");
+  start = DWT->CYCCNT;
+  dotq15 = BSP_DSP_Dot_Q15(aSignalQ15, &aSignalQ15[1], APP_BLOCK_SIZE - 1U);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE - 1U);
+  start = DWT->CYCCNT;
+  dotq31 = BSP_DSP_Dot_Q31(aSignalQ31, &aSignalQ31[1], APP_BLOCK_SIZE - 1U);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE - 1U);
+  start = DWT->CYCCNT;
+  dotf32 = BSP_DSP_Dot_F32(aSignalF32, &aSignalF32[1], APP_BLOCK_SIZE - 1U);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE - 1U);
+  /* Deviation of the sum divided by the length, the scale of the samples */
+  APP_PrintDeviation(fabsf(((float)dotq15 / 1073741824.0f) - dotf32) / (float)(APP_BLOCK_SIZE - 1U));
+  APP_PrintDeviation(fabsf(((float)dotq31 / 281474976710656.0f) - dotf32) / (float)(APP_BLOCK_SIZE - 1U));
+  printf("\r\n");
+
+  printf("rms     ");
+  start = DWT->CYCCNT;
+  rmsq15 = BSP_DSP_RMS_Q15(aSignalQ15, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  rmsq31 = BSP_DSP_RMS_Q31(aSignalQ31, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  start = DWT->CYCCNT;
+  rmsf32 = BSP_DSP_RMS_F32(aSignalF32, APP_BLOCK_SIZE);
+  APP_PrintRate(DWT->CYCCNT - start, APP_BLOCK_SIZE);
+  APP_PrintDeviation(fabsf(((float)rmsq15 / 32768.0f) - rmsf32));
+  APP_PrintDeviation(fabsf(((float)rmsq31 / 2147483648.0f) - rmsf32));
+  printf("\r\n");
+}
+
+/**
+  * @brief  Print the cycles per sample of a run.
+  * @param  Cycles Cycles of the run.
+  * @param  Count  Number of samples or points.
+  */
+static void APP_PrintRate(uint32_t Cycles, uint32_t Count)
+{
+  uint32_t rate = (Cycles * 100U) / Count;
+
+  printf(" %4lu.%02lu", rate / 100U, rate % 100U);
+}
+
+/**
+  * @brief  Print a deviation from the float result.
+  * @param  Deviation Deviation, 1 being the full scale.
+  */
+static void APP_PrintDeviation(float Deviation)
+{
+  printf(" %7lu", (uint32_t)(Deviation * 1000000.0f));
+}
+
+static int16_t APP_ToQ15(float Value)
+{
+  return (int16_t)__SSAT((int32_t)lroundf(Value * 32768.0f), 16);
+}
+
+static int32_t APP_ToQ31(float Value)
+{
+  if (Value >= 1.0f)
+  {
+    return 0x7FFFFFFF;
+  }
+  if (Value <= -1.0f)
+  {
+    return (int32_t)0x80000000;
+  }
+  return (int32_t)lroundf(Value * 2147483648.0f);
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
@@ -0,0 +1,20 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_dsp.h"
+
+
+extern UART_HandleTypeDef UartHandle;
+
+void APP_ErrorHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/*
+ * Cycles of the .data initialization of the startup, the word copy from the
+ * FLASH or, built with USE_DATALZ=y, SystemDataDecode() of the LZ4 block of
+ * .datalz, printed on USART1 TX PA9 at 115200 as the lines of HAL_Bench:
+ *   BENCH <name> <bytes> <min> <median> <max>
+ * framed by BENCH_START and BENCH_END, for Misc/Tools/benchreport.py. The
+ * BENCH_START line gives the bytes of .data and the FLASH bytes it takes,
+ * "datalz=y" or "datalz=n". Compare a baseline of USE_DATALZ=n with a run of
+ * USE_DATALZ=y, both with USE_FAST_BOOT=y for the boot line.
+ *
+ *   boot        cycles from SystemEarlyInit() to main(), the .data and .bss
+ *               initialization of this reset, USE_FAST_BOOT=y only
+ *   data_init   the .data initialization of the startup again, to a buffer
+ *   zero_fill   the .bss loop of the startup on as many bytes
+ *
+ * The data are the tables an application keeps in SRAM: a dense sine table,
+ * a sparse calibration table and channel descriptors pointing to it.
+ */
+
+/* Runs of each benchmark */
+#define APP_SAMPLES         32U
+
+/* Largest .data measured, bytes */
+#define APP_DATA_MAX        8192U
+
+/* Calibration points, a few set */
+#define APP_CAL_POINTS      1024U
+#define APP_CHANNELS        16U
+
+/* Run Code APP_SAMPLES times, the cycles of each run in aSample */
+#define APP_MEASURE(Code)                                   \
+  do                                                        \
+  {                                                         \
+    uint32_t n;                                             \
+    uint32_t start;                                         \
+    __disable_irq();                                        \
+    for (n = 0U; n < APP_SAMPLES; n++)                      \
+    {                                                       \
+      start = DWT->CYCCNT;                                  \
+      Code;                                                 \
+      aSample[n] = DWT->CYCCNT - start;                     \
+    }                                                       \
+    __enable_irq();                                         \
+  } while (0)
+
+/* A channel descriptor */
+typedef struct
+{
+  const char     *pName;
+  int32_t        Gain;
+  int32_t        Offset;
+  const uint16_t *pCalibration;
+  uint32_t       Flags;
+} APP_ChannelTypeDef;
+
+#define APP_CHANNEL(__N__)  {"ch" #__N__, 65536 + (__N__) * 17, -(__N__) * 3, &aCalibration[(__N__) * 64U], 0U}
+
+/* Initialization of the startup, from the linker script */
+extern uint32_t _sdata[];
+extern uint32_t _edata[];
+extern const uint32_t _sidata[];
+extern const uint8_t _sdatalz[];
+extern const uint8_t _edatalz[];
+
+/* .data decoded from an LZ4 block, USE_DATALZ=y */
+#define APP_DATALZ()        ((uint32_t)_sdatalz != (uint32_t)_edatalz)
+
+UART_HandleTypeDef UartHandle;
+
+static uint32_t aSample[APP_SAMPLES];
+static uint32_t Overhead;
+static uint32_t Lines;
+static uint32_t BootCycles;
+static uint32_t Copied;
+
+static uint32_t aScratch[APP_DATA_MAX / 4U];
+
+/* A period of a full scale sine in 256 points, dense */
+__FAST_DATA static int16_t aSine[256] =
+{
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+    6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+   27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+   32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+   27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+   18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+  -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+  -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+  -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+  -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804,
+};
+
+/* Calibration points of the channels, the first ones of each set only */
+__FAST_DATA static uint16_t aCalibration[APP_CAL_POINTS] =
+{
+  [0]   = 4095U, [1]   = 4090U, [2]   = 4081U, [64]  = 4093U, [65]  = 4088U,
+  [128] = 4094U, [129] = 4087U, [192] = 4092U, [256] = 4095U, [320] = 4091U,
+  [384] = 4089U, [448] = 4094U, [512] = 4090U, [576] = 4093U, [640] = 4092U,
+  [704] = 4086U, [768] = 4095U, [832] = 4091U, [896] = 4088U, [960] = 4093U
+};
+
+__FAST_DATA static APP_ChannelTypeDef aChannel[APP_CHANNELS] =
+{
+  APP_CHANNEL(0),  APP_CHANNEL(1),  APP_CHANNEL(2),  APP_CHANNEL(3),
+  APP_CHANNEL(4),  APP_CHANNEL(5),  APP_CHANNEL(6),  APP_CHANNEL(7),
+  APP_CHANNEL(8),  APP_CHANNEL(9),  APP_CHANNEL(10), APP_CHANNEL(11),
+  APP_CHANNEL(12), APP_CHANNEL(13), APP_CHANNEL(14), APP_CHANNEL(15)
+};
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid);
+static void APP_DataInit(void);
+static void APP_ZeroFill(uint32_t Size);
+static uint32_t APP_CheckData(void);
+
+
+int main(void)
+{
+  uint32_t size = (uint32_t)_edata - (uint32_t)_sdata;
+  uint32_t flash = APP_DATALZ() ? ((uint32_t)_edatalz - (uint32_t)_sdatalz) : size;
+  uint32_t valid;
+  uint32_t i;
+
+  /* Cycles since SystemEarlyInit(), before anything else */
+#if defined (USE_FAST_BOOT)
+  BootCycles = DWT->CYCCNT;
+#endif /* USE_FAST_BOOT */
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+
+  while (1)
+  {
+    /* Cycles of an empty measurement, the two reads of the counter */
+    APP_MEASURE(__NOP());
+    Overhead = 0U;
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      Overhead = ((i == 0U) || (aSample[i] < Overhead)) ? aSample[i] : Overhead;
+    }
+
+    Lines = 0U;
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu data=%lu flash=%lu datalz=%s\r\n",
+           HAL_RCC_GetHCLKFreq(), (uint32_t)APP_SAMPLES, Overhead, size, flash,
+           APP_DATALZ() ? "y" : "n");
+
+    Lines++;
+    if (BootCycles == 0U)
+    {
+      printf("BENCH boot %lu err\r\n", size);
+    }
+    else
+    {
+      printf("BENCH boot %lu %lu %lu %lu\r\n", size, BootCycles, BootCycles, BootCycles);
+    }
+
+    valid = (size <= sizeof(aScratch)) ? 1U : 0U;
+    if (valid != 0U)
+    {
+      APP_MEASURE(APP_DataInit());
+      valid = APP_CheckData();
+    }
+    APP_Report("data_init", size, valid);
+
+    APP_MEASURE(APP_ZeroFill(size));
+    APP_Report("zero_fill", size, (size <= sizeof(aScratch)) ? 1U : 0U);
+
+    printf("BENCH_END %lu\r\n", Lines);
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Print the line of a benchmark from the runs in aSample.
+  * @param  pName Name of the benchmark.
+  * @param  Arg   Bytes of the benchmark.
+  * @param  Valid 0 when the result of a run was wrong.
+  */
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid)
+{
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  Lines++;
+  if (Valid == 0U)
+  {
+    printf("BENCH %s %lu err\r\n", pName, Arg);
+    return;
+  }
+
+  /* Insertion sort, the runs are few */
+  for (i = 1U; i < APP_SAMPLES; i++)
+  {
+    value = aSample[i];
+    for (j = i; (j > 0U) && (aSample[j - 1U] > value); j--)
+    {
+      aSample[j] = aSample[j - 1U];
+    }
+    aSample[j] = value;
+  }
+  for (i = 0U; i < APP_SAMPLES; i++)
+  {
+    aSample[i] = (aSample[i] > Overhead) ? (aSample[i] - Overhead) : 0U;
+  }
+
+  printf("BENCH %s %lu %lu %lu %lu\r\n", pName, Arg,
+         aSample[0], aSample[APP_SAMPLES / 2U], aSample[APP_SAMPLES - 1U]);
+}
+
+/**
+  * @brief  .data initialization of the startup, to aScratch: the LZ4 block
+  *         decoded, or the words copied four at a time as the startup.
+  */
+static void APP_DataInit(void)
+{
+  const uint32_t *src = _sidata;
+  uint32_t *dst = aScratch;
+  uint32_t words = ((uint32_t)_edata - (uint32_t)_sdata) / 4U;
+
+  if (APP_DATALZ())
+  {
+    Copied = (uint32_t)SystemDataDecode(aScratch, _sdatalz, _edatalz) - (uint32_t)aScratch;
+    return;
+  }
+
+  for (; words >= 4U; words -= 4U)
+  {
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = src[3];
+    dst += 4;
+    src += 4;
+  }
+  for (; words != 0U; words--)
+  {
+    *dst++ = *src++;
+  }
+  Copied = (uint32_t)dst - (uint32_t)aScratch;
+}
+
+/**
+  * @brief  .bss loop of the startup, four words at a time, on aScratch.
+  * @param  Size Bytes, a multiple of 4.
+  */
+static void APP_ZeroFill(uint32_t Size)
+{
+  uint32_t *dst = aScratch;
+  uint32_t words = Size / 4U;
+
+  for (; words >= 4U; words -= 4U)
+  {
+    dst[0] = 0U;
+    dst[1] = 0U;
+    dst[2] = 0U;
+    dst[3] = 0U;
+    dst += 4;
+  }
+  for (; words != 0U; words--)
+  {
+    *dst++ = 0U;
+  }
+}
+
+/**
+  * @brief  Compare the tables initialized in aScratch with the live ones,
+  *         never written.
+  * @retval 1 when they are the same
+  */
+static uint32_t APP_CheckData(void)
+{
+  const uint8_t *base = (const uint8_t *)aScratch - (uint32_t)_sdata;
+
+  if (Copied != ((uint32_t)_edata - (uint32_t)_sdata))
+  {
+    return 0U;
+  }
+
+  return ((memcmp(base + (uint32_t)aSine, aSine, sizeof(aSine)) == 0) &&
+          (memcmp(base + (uint32_t)aCalibration, aCalibration, sizeof(aCalibration)) == 0) &&
+          (memcmp(base + (uint32_t)aChannel, aChannel, sizeof(aChannel)) == 0)) ? 1U : 0U;
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#if !defined (USE_FAST_BOOT)
+  DWT->CYCCNT = 0U;
+#endif /* USE_FAST_BOOT */
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+#if defined (USE_FAST_BOOT)
+  /* SYSCLK already on the PLL, set by SystemEarlyInit() */
+  return;
+#endif /* USE_FAST_BOOT */
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
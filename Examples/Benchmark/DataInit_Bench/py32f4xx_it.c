@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_it.c
+  * @author  MCU Application Team
+  * @brief   Interrupt Service Routines.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2023 Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by Puya under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "py32f4xx_it.h"
+
+/* Private includes ----------------------------------------------------------*/
+#if defined (USE_BSP_RTOS)
+#include "py32f4xx_bsp_rtos.h"
+#endif
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private user code ---------------------------------------------------------*/
+/* External variables --------------------------------------------------------*/
+
+/******************************************************************************/
+/*          Cortex-M4 Processor Interruption and Exception Handlers           */
+/******************************************************************************/
+/**
+  * @brief   This function handles NMI exception.
+  * @param  None
+  * @retval None
+  */
+void NMI_Handler(void)
+{
+}
+
+#if !defined (USE_BSP_FAULT)
+/**
+  * @brief  This function handles Hard Fault exception.
+  * @param  None
+  * @retval None
+  */
+void HardFault_Handler(void)
+{
+  /* Go to infinite loop when Hard Fault exception occurs */
+  while (1)
+  {
+  }
+}
+
+/**
+  * @brief  This function handles Memory Manage exception.
+  * @param  None
+  * @retval None
+  */
+void MemManage_Handler(void)
+{
+  /* Go to infinite loop when Memory Manage exception occurs */
+  while (1)
+  {
+  }
+}
+
+/**
+  * @brief  This function handles Bus Fault exception.
+  * @param  None
+  * @retval None
+  */
+void BusFault_Handler(void)
+{
+  /* Go to infinite loop when Bus Fault exception occurs */
+  while (1)
+  {
+  }
+}
+
+/**
+  * @brief  This function handles Usage Fault exception.
+  * @param  None
+  * @retval None
+  */
+void UsageFault_Handler(void)
+{
+  /* Go to infinite loop when Usage Fault exception occurs */
+  while (1)
+  {
+  }
+}
+#endif /* USE_BSP_FAULT */
+
+/**
+  * @brief  This function handles SVCall exception.
+  * @param  None
+  * @retval None
+  */
+void SVC_Handler(void)
+{
+}
+
+#if !defined (USE_BSP_GUARD)
+/**
+  * @brief  This function handles Debug Monitor exception.
+  * @note   With USE_BSP_GUARD, the one of py32f4xx_bsp_guard.c reports the memory guard hits.
+  * @param  None
+  * @retval None
+  */
+void DebugMon_Handler(void)
+{
+}
+#endif /* USE_BSP_GUARD */
+
+#if !defined (USE_BSP_RTOS)
+/**
+  * @brief  This function handles PendSVC exception.
+  * @note   With USE_BSP_RTOS, the one of py32f4xx_bsp_rtos.c switches the threads.
+  * @param  None
+  * @retval None
+  */
+void PendSV_Handler(void)
+{
+}
+#endif /* USE_BSP_RTOS */
+
+/**
+  * @brief  This function handles SysTick Handler.
+  * @param  None
+  * @retval None
+  */
+__FLASH_RAM_FUNC void SysTick_Handler(void)
+{
+#if defined (USE_BSP_RTOS)
+  BSP_RTOS_TickHandler();
+#else
+  HAL_IncTick();
+#endif
+}
+
+/******************************************************************************/
+/* PY32F4xx Peripheral Interrupt Handlers                                     */
+/* Add here the Interrupt Handlers for the used peripherals.                  */
+/* For the available peripheral interrupt handler names,                      */
+/* please refer to the startup file.                                          */
+/******************************************************************************/
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
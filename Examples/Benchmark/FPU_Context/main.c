@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/*
+ * Cycles of the entry and the return of an interrupt for each FPU context
+ * preservation of HAL_FPU_ConfigContext(), printed on USART1 TX PA9 at
+ * 115200 as the lines of HAL_Bench:
+ *   BENCH <name> <arg> <min> <median> <max>
+ * framed by BENCH_START and BENCH_END, for Misc/Tools/benchreport.py.
+ *
+ * <name> is <step>_<context>_<handler>: context is lazy, immediate or none,
+ * handler int for an integer-only handler, fpu for one running an FP
+ * instruction. arg is 1 when the interrupted code has an FP context, an FP
+ * instruction run just before, 0 when it has none. The steps are
+ *   entry          from NVIC_SetPendingIRQ() to the first read of the handler
+ *   body           from the first read of the handler to its last, the lazy
+ *                  stacking of the FP registers lands here
+ *   return         from the last read of the handler back to the pending code
+ *
+ * With the none context the FP registers of the interrupted code are not
+ * preserved: the fpu handler corrupts them, harmless here only, the code
+ * reading its float from memory again.
+ */
+
+/* Runs of each benchmark */
+#define APP_SAMPLES         32U
+
+/* Preservations compared */
+static const uint32_t aContext[] = {FPU_CONTEXT_LAZY, FPU_CONTEXT_IMMEDIATE, FPU_CONTEXT_NONE};
+static const char * const aContextName[] = {"lazy", "immediate", "none"};
+
+UART_HandleTypeDef UartHandle;
+__IO uint32_t      IrqStamp;
+__IO uint32_t      IrqExit;
+__IO uint32_t      IrqUseFpu;
+volatile float     IrqFloat = 1.0f;
+
+static volatile float ThreadFloat = 1.0f;
+
+static uint32_t aSample[APP_SAMPLES];
+static uint32_t aBody[APP_SAMPLES];
+static uint32_t aReturn[APP_SAMPLES];
+static uint32_t Overhead;
+static uint32_t Lines;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid);
+static void APP_BenchIrq(uint32_t Context, uint32_t UseFpu, uint32_t ThreadFpu);
+
+
+int main(void)
+{
+  uint32_t start;
+  uint32_t i;
+  uint32_t j;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+
+  HAL_NVIC_SetPriority(APP_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(APP_IRQn);
+
+  while (1)
+  {
+    /* Cycles of an empty measurement, the two reads of the counter */
+    __disable_irq();
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      start = DWT->CYCCNT;
+      __NOP();
+      aSample[i] = DWT->CYCCNT - start;
+    }
+    Overhead = 0U;
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      Overhead = ((i == 0U) || (aSample[i] < Overhead)) ? aSample[i] : Overhead;
+    }
+    __enable_irq();
+
+    Lines = 0U;
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu\r\n",
+           HAL_RCC_GetHCLKFreq(), (uint32_t)APP_SAMPLES, Overhead);
+    for (i = 0U; i < (sizeof(aContext) / sizeof(aContext[0])); i++)
+    {
+      for (j = 0U; j < 4U; j++)
+      {
+        APP_BenchIrq(i, j >> 1, j & 1U);
+      }
+    }
+    HAL_FPU_ConfigContext(FPU_CONTEXT_LAZY);
+    printf("BENCH_END %lu\r\n", Lines);
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Print the line of a benchmark from the runs in aSample.
+  * @param  pName Name of the benchmark.
+  * @param  Arg   Argument of the benchmark.
+  * @param  Valid 0 when the result of a run was wrong.
+  */
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid)
+{
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  Lines++;
+  if (Valid == 0U)
+  {
+    printf("BENCH %s %lu err\r\n", pName, Arg);
+    return;
+  }
+
+  /* Insertion sort, the runs are few */
+  for (i = 1U; i < APP_SAMPLES; i++)
+  {
+    value = aSample[i];
+    for (j = i; (j > 0U) && (aSample[j - 1U] > value); j--)
+    {
+      aSample[j] = aSample[j - 1U];
+    }
+    aSample[j] = value;
+  }
+  for (i = 0U; i < APP_SAMPLES; i++)
+  {
+    aSample[i] = (aSample[i] > Overhead) ? (aSample[i] - Overhead) : 0U;
+  }
+
+  printf("BENCH %s %lu %lu %lu %lu\r\n", pName, Arg,
+         aSample[0], aSample[APP_SAMPLES / 2U], aSample[APP_SAMPLES - 1U]);
+}
+
+/**
+  * @brief  Measure the entry, the body and the return of the interrupt.
+  * @param  Context   Index in aContext.
+  * @param  UseFpu    1 for an FP instruction in the handler.
+  * @param  ThreadFpu 1 for an FP context in the interrupted code.
+  */
+static void APP_BenchIrq(uint32_t Context, uint32_t UseFpu, uint32_t ThreadFpu)
+{
+  char name[32];
+  uint32_t valid = 1U;
+  uint32_t start;
+  uint32_t stop;
+  uint32_t n;
+
+  HAL_FPU_ConfigContext(aContext[Context]);
+  IrqUseFpu = UseFpu;
+
+  /* The SysTick would add its own entries to some runs */
+  HAL_SuspendTick();
+  for (n = 0U; n < APP_SAMPLES; n++)
+  {
+    if (ThreadFpu != 0U)
+    {
+      ThreadFloat = ThreadFloat * 1.25f;
+    }
+    else
+    {
+      __set_CONTROL(__get_CONTROL() & ~CONTROL_FPCA_Msk);
+      __ISB();
+    }
+
+    IrqStamp = 0U;
+    start = DWT->CYCCNT;
+    NVIC_SetPendingIRQ(APP_IRQn);
+    __DSB();
+    __ISB();
+    stop = DWT->CYCCNT;
+    if (IrqStamp == 0U)
+    {
+      valid = 0U;
+    }
+    aSample[n] = IrqStamp - start;
+    aBody[n]   = IrqExit - IrqStamp;
+    aReturn[n] = stop - IrqExit;
+  }
+  HAL_ResumeTick();
+
+  snprintf(name, sizeof(name), "entry_%s_%s", aContextName[Context], (UseFpu != 0U) ? "fpu" : "int");
+  APP_Report(name, ThreadFpu, valid);
+  memcpy(aSample, aBody, sizeof(aSample));
+  snprintf(name, sizeof(name), "body_%s_%s", aContextName[Context], (UseFpu != 0U) ? "fpu" : "int");
+  APP_Report(name, ThreadFpu, valid);
+  memcpy(aSample, aReturn, sizeof(aSample));
+  snprintf(name, sizeof(name), "return_%s_%s", aContextName[Context], (UseFpu != 0U) ? "fpu" : "int");
+  APP_Report(name, ThreadFpu, valid);
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
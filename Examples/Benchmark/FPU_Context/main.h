@@ -0,0 +1,26 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+
+
+extern UART_HandleTypeDef UartHandle;
+extern __IO uint32_t      IrqStamp;
+extern __IO uint32_t      IrqExit;
+extern __IO uint32_t      IrqUseFpu;
+extern volatile float     IrqFloat;
+
+#define APP_IRQn          TIM7_IRQn
+#define APP_IRQHandler    TIM7_IRQHandler
+
+void APP_ErrorHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,455 @@
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/*
+ * Cycle counts of HAL hot paths, measured with the DWT cycle counter and
+ * printed on USART1 TX PA9 at 115200 in a format read by scripts.
+ *
+ * Each benchmark is run APP_SAMPLES times, the cycles of an empty measurement
+ * are subtracted and the line gives:
+ *   BENCH <name> <arg> <min> <median> <max>
+ * or "BENCH <name> <arg> err" when the result of the run is wrong. A pass is
+ * framed by "BENCH_START hclk=<Hz> samples=<n> overhead=<cycles>" and
+ * "BENCH_END <lines>". The interrupts are masked during the measurements,
+ * but for the IRQ ones, which stop the SysTick instead.
+ *
+ *   gpio_write     HAL_GPIO_WritePin(), arg is the pin state
+ *   gpio_toggle    HAL_GPIO_TogglePin()
+ *   dma_start      HAL_DMA_Start() of a memory to memory copy, arg in words
+ *   dma_copy       HAL_DMA_Start() and HAL_DMA_PollForTransfer(), arg in words
+ *   crc_calc       HAL_CRC_Calculate(), arg in words
+ *   irq_entry      from NVIC_SetPendingIRQ() to the first read of the handler
+ *   irq_return     from the read of the handler back to the pending code
+ *   memcpy_*       copy of arg bytes by: libc memcpy() between word aligned
+ *                  buffers (align) or from an odd address (unalign), a byte
+ *                  loop (byte), a word loop (word), the DMA (dma)
+ */
+
+/* Runs of each benchmark */
+#define APP_SAMPLES         32U
+
+/* Sizes of the copies, in bytes, multiples of 4 */
+static const uint32_t aCopySize[] = {64U, 256U, 1024U};
+#define APP_COPY_SIZE_MAX   1024U
+
+/* Sizes of the CRC, in words */
+static const uint32_t aCrcSize[] = {16U, 256U, 1024U};
+#define APP_CRC_SIZE_MAX    1024U
+
+#define APP_GPIO_PORT       GPIOB
+#define APP_GPIO_PIN        GPIO_PIN_1
+
+/* Run Code APP_SAMPLES times, the cycles of each run in aSample */
+#define APP_MEASURE(Code)                                   \
+  do                                                        \
+  {                                                         \
+    uint32_t n;                                             \
+    uint32_t start;                                         \
+    for (n = 0U; n < APP_SAMPLES; n++)                      \
+    {                                                       \
+      start = DWT->CYCCNT;                                  \
+      Code;                                                 \
+      aSample[n] = DWT->CYCCNT - start;                     \
+    }                                                       \
+  } while (0)
+
+UART_HandleTypeDef UartHandle;
+CRC_HandleTypeDef  CrcHandle;
+DMA_HandleTypeDef  DmaHandle;
+__IO uint32_t      IrqStamp;
+
+static uint32_t aSample[APP_SAMPLES];
+static uint32_t Overhead;
+static uint32_t Lines;
+
+static uint32_t aSrc[APP_CRC_SIZE_MAX];
+static uint32_t aDst[APP_COPY_SIZE_MAX / 4U + 1U];
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CrcConfig(void);
+static void APP_DmaConfig(void);
+static void APP_GpioConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid);
+static void APP_BenchGpio(void);
+static void APP_BenchDma(void);
+static void APP_BenchCrc(void);
+static void APP_BenchIrq(void);
+static void APP_BenchCopy(void);
+static void APP_CopyBytes(uint8_t *pDst, const uint8_t *pSrc, uint32_t Size);
+static void APP_CopyWords(uint32_t *pDst, const uint32_t *pSrc, uint32_t Size);
+
+
+int main(void)
+{
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_GpioConfig();
+  APP_CrcConfig();
+  APP_DmaConfig();
+
+  for (i = 0U; i < APP_CRC_SIZE_MAX; i++)
+  {
+    aSrc[i] = (i * 0x9E3779B9U) ^ (i >> 3);
+  }
+
+  while (1)
+  {
+    /* Cycles of an empty measurement, the two reads of the counter */
+    __disable_irq();
+    APP_MEASURE(__NOP());
+    Overhead = 0U;
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      Overhead = ((i == 0U) || (aSample[i] < Overhead)) ? aSample[i] : Overhead;
+    }
+    __enable_irq();
+
+    Lines = 0U;
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu\r\n",
+           HAL_RCC_GetHCLKFreq(), (uint32_t)APP_SAMPLES, Overhead);
+    APP_BenchGpio();
+    APP_BenchDma();
+    APP_BenchCrc();
+    APP_BenchIrq();
+    APP_BenchCopy();
+    printf("BENCH_END %lu\r\n", Lines);
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Print the line of a benchmark from the runs in aSample.
+  * @param  pName Name of the benchmark.
+  * @param  Arg   Argument of the benchmark, size or state.
+  * @param  Valid 0 when the result of a run was wrong.
+  */
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid)
+{
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  Lines++;
+  if (Valid == 0U)
+  {
+    printf("BENCH %s %lu err\r\n", pName, Arg);
+    return;
+  }
+
+  /* Insertion sort, the runs are few */
+  for (i = 1U; i < APP_SAMPLES; i++)
+  {
+    value = aSample[i];
+    for (j = i; (j > 0U) && (aSample[j - 1U] > value); j--)
+    {
+      aSample[j] = aSample[j - 1U];
+    }
+    aSample[j] = value;
+  }
+  for (i = 0U; i < APP_SAMPLES; i++)
+  {
+    aSample[i] = (aSample[i] > Overhead) ? (aSample[i] - Overhead) : 0U;
+  }
+
+  printf("BENCH %s %lu %lu %lu %lu\r\n", pName, Arg,
+         aSample[0], aSample[APP_SAMPLES / 2U], aSample[APP_SAMPLES - 1U]);
+}
+
+static void APP_BenchGpio(void)
+{
+  __disable_irq();
+  APP_MEASURE(HAL_GPIO_WritePin(APP_GPIO_PORT, APP_GPIO_PIN, GPIO_PIN_SET));
+  __enable_irq();
+  APP_Report("gpio_write", 1U, 1U);
+
+  __disable_irq();
+  APP_MEASURE(HAL_GPIO_WritePin(APP_GPIO_PORT, APP_GPIO_PIN, GPIO_PIN_RESET));
+  __enable_irq();
+  APP_Report("gpio_write", 0U, 1U);
+
+  __disable_irq();
+  APP_MEASURE(HAL_GPIO_TogglePin(APP_GPIO_PORT, APP_GPIO_PIN));
+  __enable_irq();
+  APP_Report("gpio_toggle", 0U, 1U);
+}
+
+static void APP_BenchDma(void)
+{
+  uint32_t valid;
+  uint32_t words;
+  uint32_t i;
+  uint32_t n;
+  uint32_t start;
+
+  for (i = 0U; i < (sizeof(aCopySize) / sizeof(aCopySize[0])); i++)
+  {
+    words = aCopySize[i] / 4U;
+    valid = 1U;
+
+    /* The call only, the transfer is completed outside of the measurement */
+    __disable_irq();
+    for (n = 0U; n < APP_SAMPLES; n++)
+    {
+      start = DWT->CYCCNT;
+      (void)HAL_DMA_Start(&DmaHandle, (uint32_t)aSrc, (uint32_t)aDst, words);
+      aSample[n] = DWT->CYCCNT - start;
+      if (HAL_DMA_PollForTransfer(&DmaHandle, HAL_DMA_FULL_TRANSFER, 10U) != HAL_OK)
+      {
+        valid = 0U;
+      }
+    }
+    __enable_irq();
+    APP_Report("dma_start", words, valid);
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(
+      (void)HAL_DMA_Start(&DmaHandle, (uint32_t)aSrc, (uint32_t)aDst, words);
+      (void)HAL_DMA_PollForTransfer(&DmaHandle, HAL_DMA_FULL_TRANSFER, 10U));
+    __enable_irq();
+    valid = (memcmp(aDst, aSrc, words * 4U) == 0) ? 1U : 0U;
+    APP_Report("dma_copy", words, valid);
+  }
+}
+
+static void APP_BenchCrc(void)
+{
+  uint32_t reference;
+  uint32_t crc = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(aCrcSize) / sizeof(aCrcSize[0])); i++)
+  {
+    reference = HAL_CRC_Calculate(&CrcHandle, aSrc, aCrcSize[i]);
+    __disable_irq();
+    APP_MEASURE(crc = HAL_CRC_Calculate(&CrcHandle, aSrc, aCrcSize[i]));
+    __enable_irq();
+    APP_Report("crc_calc", aCrcSize[i], (crc == reference) ? 1U : 0U);
+  }
+}
+
+static void APP_BenchIrq(void)
+{
+  uint32_t aReturn[APP_SAMPLES];
+  uint32_t valid = 1U;
+  uint32_t start;
+  uint32_t stop;
+  uint32_t n;
+
+  HAL_NVIC_SetPriority(APP_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(APP_IRQn);
+
+  /* The SysTick would add its own entries to some runs */
+  HAL_SuspendTick();
+  for (n = 0U; n < APP_SAMPLES; n++)
+  {
+    IrqStamp = 0U;
+    start = DWT->CYCCNT;
+    NVIC_SetPendingIRQ(APP_IRQn);
+    __DSB();
+    __ISB();
+    stop = DWT->CYCCNT;
+    if (IrqStamp == 0U)
+    {
+      valid = 0U;
+    }
+    aSample[n] = IrqStamp - start;
+    aReturn[n] = stop - IrqStamp;
+  }
+  HAL_ResumeTick();
+  HAL_NVIC_DisableIRQ(APP_IRQn);
+
+  APP_Report("irq_entry", 0U, valid);
+  memcpy(aSample, aReturn, sizeof(aSample));
+  APP_Report("irq_return", 0U, valid);
+}
+
+static void APP_BenchCopy(void)
+{
+  uint8_t *dst = (uint8_t *)aDst;
+  const uint8_t *src = (const uint8_t *)aSrc;
+  uint32_t size;
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(aCopySize) / sizeof(aCopySize[0])); i++)
+  {
+    size = aCopySize[i];
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(memcpy(dst, src, size));
+    __enable_irq();
+    APP_Report("memcpy_align", size, (memcmp(dst, src, size) == 0) ? 1U : 0U);
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(memcpy(dst, src + 1U, size));
+    __enable_irq();
+    APP_Report("memcpy_unalign", size, (memcmp(dst, src + 1U, size) == 0) ? 1U : 0U);
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(APP_CopyBytes(dst, src, size));
+    __enable_irq();
+    APP_Report("memcpy_byte", size, (memcmp(dst, src, size) == 0) ? 1U : 0U);
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(APP_CopyWords(aDst, aSrc, size / 4U));
+    __enable_irq();
+    APP_Report("memcpy_word", size, (memcmp(dst, src, size) == 0) ? 1U : 0U);
+
+    memset(aDst, 0, sizeof(aDst));
+    __disable_irq();
+    APP_MEASURE(
+      (void)HAL_DMA_Start(&DmaHandle, (uint32_t)aSrc, (uint32_t)aDst, size / 4U);
+      (void)HAL_DMA_PollForTransfer(&DmaHandle, HAL_DMA_FULL_TRANSFER, 10U));
+    __enable_irq();
+    APP_Report("memcpy_dma", size, (memcmp(dst, src, size) == 0) ? 1U : 0U);
+  }
+}
+
+/* The loops are kept, GCC would turn them into memcpy() calls otherwise */
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static void APP_CopyBytes(uint8_t *pDst, const uint8_t *pSrc, uint32_t Size)
+{
+  while (Size-- != 0U)
+  {
+    *pDst++ = *pSrc++;
+  }
+}
+
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+static void APP_CopyWords(uint32_t *pDst, const uint32_t *pSrc, uint32_t Size)
+{
+  while (Size-- != 0U)
+  {
+    *pDst++ = *pSrc++;
+  }
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_GpioConfig(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct;
+
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin   = APP_GPIO_PIN;
+  GPIO_InitStruct.Mode  = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull  = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  HAL_GPIO_Init(APP_GPIO_PORT, &GPIO_InitStruct);
+}
+
+static void APP_CrcConfig(void)
+{
+  CrcHandle.Instance = CRC;
+  if (HAL_CRC_Init(&CrcHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_DmaConfig(void)
+{
+  /* Memory to memory, words, without interrupt, completion polled */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  DmaHandle.Instance                 = DMA1_Channel2;
+  DmaHandle.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+  DmaHandle.Init.PeriphInc           = DMA_PINC_ENABLE;     /* Source */
+  DmaHandle.Init.MemInc              = DMA_MINC_ENABLE;     /* Destination */
+  DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  DmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+  DmaHandle.Init.Mode                = DMA_NORMAL;
+  DmaHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&DmaHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
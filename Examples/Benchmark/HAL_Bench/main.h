@@ -0,0 +1,24 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+
+
+extern UART_HandleTypeDef UartHandle;
+extern CRC_HandleTypeDef  CrcHandle;
+extern __IO uint32_t      IrqStamp;
+
+#define APP_IRQn          TIM7_IRQn
+#define APP_IRQHandler    TIM7_IRQHandler
+
+void APP_ErrorHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
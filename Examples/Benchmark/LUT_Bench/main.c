@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <math.h>
+#include "main.h"
+
+/*
+ * Cycles of the conversion of a block of 12-bit ADC codes to temperatures,
+ * by a polynomial and by the tables of BSP_LUT, built with USE_BSP=y,
+ * printed on USART1 TX PA9 at 115200 as the lines of HAL_Bench:
+ *   BENCH <name> <samples> <min> <median> <max>
+ * framed by BENCH_START and BENCH_END, for Misc/Tools/benchreport.py, then
+ * the largest error of each conversion over the codes 128 to 4000, -40 to
+ * 125 degrees, in millidegrees:
+ *   DEV <name> <error>
+ *
+ * The sensor is a 10k NTC of B 3950 under a 10k pull-up to VREF. The tables
+ * are generated by Misc/Tools/lut2c.py, with E the Beta equation of the code
+ * "1/(1/298.15+log(x/(4095-x))/3950)-273.15":
+ *   lut2c.py ntc_lin --expr E --range 128 4000 --shift 4 --scale 1000
+ *   lut2c.py ntc_cub --expr E --range 128 4000 --shift 5 --interp cubic --scale 1000
+ *   lut2c.py ntc_bp --expr E --interp cubic --scale 1000 --breaks <the 48
+ *            abscissas of ntc_bp.c, a cosine spacing, dense at the ends>
+ *   lut2c.py ntc_f32 --type f32 --expr E --range 128 4000 --points 64 --interp cubic
+ *
+ *   beta_f32    Beta equation with logf(), float
+ *   poly7_f32   degree 7 least squares polynomial of the code, Horner, float
+ *   lut_lin     uniform table of 243 points, step 16, linear, millidegrees
+ *   lut_cub     uniform table of 122 points, step 32, cubic, millidegrees
+ *   lut_bp      non uniform table of 48 points, binary search, cubic
+ *   lut_f32     uniform float table of 64 points, cubic, from float codes
+ */
+
+/* Runs of each benchmark */
+#define APP_SAMPLES         32U
+
+/* ADC codes of a block */
+#define APP_BLOCK_SIZE      256U
+#define APP_CODE_MIN        128U
+#define APP_CODE_MAX        4000U
+
+/* Polynomial of u = (code - 2064) / 1936, u^0 first */
+static const float aPoly[8] =
+{
+  24.488196f, -40.533288f, 10.351439f, -37.411549f, -16.694786f, 65.479961f, 24.819356f, -70.350495f
+};
+
+/* Conversions of the DEV lines */
+static const char *const aDevName[6] = {"beta_f32", "poly7_f32", "lut_lin", "lut_cub", "lut_bp", "lut_f32"};
+
+/* Run Code APP_SAMPLES times, the cycles of each run in aSample */
+#define APP_MEASURE(Code)                                   \
+  do                                                        \
+  {                                                         \
+    uint32_t n;                                             \
+    uint32_t start;                                         \
+    __disable_irq();                                        \
+    for (n = 0U; n < APP_SAMPLES; n++)                      \
+    {                                                       \
+      start = DWT->CYCCNT;                                  \
+      Code;                                                 \
+      aSample[n] = DWT->CYCCNT - start;                     \
+    }                                                       \
+    __enable_irq();                                         \
+  } while (0)
+
+UART_HandleTypeDef UartHandle;
+
+static uint32_t aSample[APP_SAMPLES];
+static uint32_t Overhead;
+static uint32_t Lines;
+
+static uint16_t aCode[APP_BLOCK_SIZE];
+static float    aCodeF32[APP_BLOCK_SIZE];
+static int32_t  aOutI32[APP_BLOCK_SIZE];
+static float    aOutF32[APP_BLOCK_SIZE];
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_Report(const char *pName, uint32_t Arg);
+static void APP_BenchConversions(void);
+static void APP_CheckConversions(void);
+static void APP_Beta(const uint16_t *pSrc, float *pDst, uint32_t Length);
+static void APP_Poly7(const uint16_t *pSrc, float *pDst, uint32_t Length);
+static double APP_Exact(uint32_t Code);
+
+
+int main(void)
+{
+  uint32_t seed = 12345U;
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+
+  if ((BSP_LUT_I32_Check(&NTC_LIN_Table) != HAL_OK) || (BSP_LUT_I32_Check(&NTC_CUB_Table) != HAL_OK) ||
+      (BSP_LUT_I32_Check(&NTC_BP_Table) != HAL_OK) || (BSP_LUT_F32_Check(&NTC_F32_Table) != HAL_OK))
+  {
+    APP_ErrorHandler();
+  }
+
+  /* Codes spread over the range, in no order */
+  for (i = 0U; i < APP_BLOCK_SIZE; i++)
+  {
+    seed = (seed * 1664525U) + 1013904223U;
+    aCode[i] = (uint16_t)(APP_CODE_MIN + ((seed >> 16) % (APP_CODE_MAX - APP_CODE_MIN + 1U)));
+    aCodeF32[i] = (float)aCode[i];
+  }
+
+  while (1)
+  {
+    /* Cycles of an empty measurement, the two reads of the counter */
+    APP_MEASURE(__NOP());
+    Overhead = 0U;
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      Overhead = ((i == 0U) || (aSample[i] < Overhead)) ? aSample[i] : Overhead;
+    }
+
+    Lines = 0U;
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu\r\n",
+           HAL_RCC_GetHCLKFreq(), (uint32_t)APP_SAMPLES, Overhead);
+    APP_BenchConversions();
+    printf("BENCH_END %lu\r\n", Lines);
+    APP_CheckConversions();
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Print the line of a benchmark from the runs in aSample.
+  * @param  pName Name of the benchmark.
+  * @param  Arg   Samples converted by a run.
+  */
+static void APP_Report(const char *pName, uint32_t Arg)
+{
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  Lines++;
+
+  /* Insertion sort, the runs are few */
+  for (i = 1U; i < APP_SAMPLES; i++)
+  {
+    value = aSample[i];
+    for (j = i; (j > 0U) && (aSample[j - 1U] > value); j--)
+    {
+      aSample[j] = aSample[j - 1U];
+    }
+    aSample[j] = value;
+  }
+  for (i = 0U; i < APP_SAMPLES; i++)
+  {
+    aSample[i] = (aSample[i] > Overhead) ? (aSample[i] - Overhead) : 0U;
+  }
+
+  printf("BENCH %s %lu %lu %lu %lu\r\n", pName, Arg,
+         aSample[0], aSample[APP_SAMPLES / 2U], aSample[APP_SAMPLES - 1U]);
+}
+
+static void APP_BenchConversions(void)
+{
+  APP_MEASURE(APP_Beta(aCode, aOutF32, APP_BLOCK_SIZE));
+  APP_Report("beta_f32", APP_BLOCK_SIZE);
+
+  APP_MEASURE(APP_Poly7(aCode, aOutF32, APP_BLOCK_SIZE));
+  APP_Report("poly7_f32", APP_BLOCK_SIZE);
+
+  APP_MEASURE(BSP_LUT_I32_Process(&NTC_LIN_Table, aCode, aOutI32, APP_BLOCK_SIZE));
+  APP_Report("lut_lin", APP_BLOCK_SIZE);
+
+  APP_MEASURE(BSP_LUT_I32_Process(&NTC_CUB_Table, aCode, aOutI32, APP_BLOCK_SIZE));
+  APP_Report("lut_cub", APP_BLOCK_SIZE);
+
+  APP_MEASURE(BSP_LUT_I32_Process(&NTC_BP_Table, aCode, aOutI32, APP_BLOCK_SIZE));
+  APP_Report("lut_bp", APP_BLOCK_SIZE);
+
+  APP_MEASURE(BSP_LUT_F32_Process(&NTC_F32_Table, aCodeF32, aOutF32, APP_BLOCK_SIZE));
+  APP_Report("lut_f32", APP_BLOCK_SIZE);
+}
+
+/**
+  * @brief  Largest error of each conversion over all the codes of the range.
+  */
+static void APP_CheckConversions(void)
+{
+  double dev[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double exact;
+  uint16_t code;
+  float value[2];
+  uint32_t k;
+
+  for (code = APP_CODE_MIN; code <= APP_CODE_MAX; code++)
+  {
+    exact = APP_Exact(code);
+    APP_Beta(&code, &value[0], 1U);
+    APP_Poly7(&code, &value[1], 1U);
+    dev[0] = fmax(dev[0], fabs((double)value[0] - exact));
+    dev[1] = fmax(dev[1], fabs((double)value[1] - exact));
+    dev[2] = fmax(dev[2], fabs((BSP_LUT_I32_Eval(&NTC_LIN_Table, code) / 1000.0) - exact));
+    dev[3] = fmax(dev[3], fabs((BSP_LUT_I32_Eval(&NTC_CUB_Table, code) / 1000.0) - exact));
+    dev[4] = fmax(dev[4], fabs((BSP_LUT_I32_Eval(&NTC_BP_Table, code) / 1000.0) - exact));
+    dev[5] = fmax(dev[5], fabs((double)BSP_LUT_F32_Eval(&NTC_F32_Table, (float)code) - exact));
+  }
+
+  for (k = 0U; k < 6U; k++)
+  {
+    printf("DEV %s %lu\r\n", aDevName[k], (uint32_t)(dev[k] * 1000.0 + 0.5));
+  }
+}
+
+/**
+  * @brief  Beta equation of the NTC, in float.
+  */
+static void APP_Beta(const uint16_t *pSrc, float *pDst, uint32_t Length)
+{
+  float code;
+  uint32_t i;
+
+  for (i = 0U; i < Length; i++)
+  {
+    code = (float)pSrc[i];
+    pDst[i] = (1.0f / ((1.0f / 298.15f) + (logf(code / (4095.0f - code)) * (1.0f / 3950.0f)))) - 273.15f;
+  }
+}
+
+/**
+  * @brief  Degree 7 polynomial of the code, in float.
+  */
+static void APP_Poly7(const uint16_t *pSrc, float *pDst, uint32_t Length)
+{
+  float u;
+  float acc;
+  uint32_t i;
+  int32_t k;
+
+  for (i = 0U; i < Length; i++)
+  {
+    u = ((float)pSrc[i] - 2064.0f) * (1.0f / 1936.0f);
+    acc = aPoly[7];
+    for (k = 6; k >= 0; k--)
+    {
+      acc = (acc * u) + aPoly[k];
+    }
+    pDst[i] = acc;
+  }
+}
+
+/**
+  * @brief  Beta equation of the NTC, in double, the reference.
+  */
+static double APP_Exact(uint32_t Code)
+{
+  return (1.0 / ((1.0 / 298.15) + (log((double)Code / (4095.0 - (double)Code)) / 3950.0))) - 273.15;
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
@@ -0,0 +1,24 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_lut.h"
+#include "ntc_lin.h"
+#include "ntc_cub.h"
+#include "ntc_bp.h"
+#include "ntc_f32.h"
+
+
+extern UART_HandleTypeDef UartHandle;
+
+void APP_ErrorHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    ntc_bp.c
+  * @brief   NTC_BP lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ntc_bp.h"
+
+/* Private variables ---------------------------------------------------------*/
+static const int32_t NTC_BP_X[48] =
+{
+  128, 132, 145, 167, 197, 235, 282, 336,
+  398, 468, 545, 628, 718, 814, 916, 1022,
+  1134, 1249, 1368, 1490, 1615, 1742, 1870, 1999,
+  2129, 2258, 2386, 2513, 2638, 2760, 2879, 2994,
+  3106, 3212, 3314, 3410, 3500, 3583, 3660, 3730,
+  3792, 3846, 3893, 3931, 3961, 3983, 3996, 4000,
+};
+
+static const int32_t NTC_BP_Y[48] =
+{
+  129310, 128011, 124089, 118308, 111715, 104858, 97948, 91457,
+  85304, 79507, 74120, 69142, 64454, 60059, 55905, 52021,
+  48286, 44763, 41378, 38126, 34976, 31923, 28964, 26070,
+  23218, 20427, 17674, 14937, 12213, 9504, 6789, 4067,
+  1294, -1480, -4327, -7218, -10173, -13179, -16294, -19500,
+  -22758, -26054, -29429, -32665, -35696, -38306, -40061, -40640,
+};
+
+/* Exported variables --------------------------------------------------------*/
+const BSP_LUT_I32_TypeDef NTC_BP_Table =
+{
+  .pX      = NTC_BP_X,
+  .pY      = NTC_BP_Y,
+  .Count   = 48U,
+  .Interp  = BSP_LUT_CUBIC,
+};
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    ntc_cub.c
+  * @brief   NTC_CUB lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ntc_cub.h"
+
+/* Private variables ---------------------------------------------------------*/
+static const int32_t NTC_CUB_Y[122] =
+{
+  129310, 120046, 112729, 106704, 101592, 97160, 93251, 89756,
+  86597, 83714, 81063, 78608, 76323, 74184, 72174, 70276,
+  68479, 66771, 65143, 63588, 62098, 60667, 59291, 57965,
+  56684, 55446, 54246, 53082, 51951, 50851, 49780, 48735,
+  47716, 46720, 45746, 44792, 43858, 42941, 42042, 41158,
+  40290, 39435, 38594, 37765, 36947, 36141, 35345, 34559,
+  33782, 33014, 32254, 31501, 30755, 30016, 29283, 28555,
+  27833, 27116, 26403, 25694, 24989, 24287, 23588, 22892,
+  22198, 21506, 20815, 20126, 19437, 18749, 18061, 17373,
+  16685, 15995, 15304, 14612, 13917, 13220, 12520, 11817,
+  11111, 10400, 9684, 8963, 8237, 7505, 6765, 6019,
+  5264, 4501, 3728, 2945, 2151, 1344, 525, -308,
+  -1157, -2023, -2906, -3810, -4735, -5683, -6658, -7660,
+  -8694, -9763, -10869, -12019, -13217, -14469, -15783, -17168,
+  -18634, -20196, -21871, -23683, -25661, -27850, -30310, -33136,
+  -36484, -40640,
+};
+
+/* Exported variables --------------------------------------------------------*/
+const BSP_LUT_I32_TypeDef NTC_CUB_Table =
+{
+  .pX      = NULL,
+  .pY      = NTC_CUB_Y,
+  .Count   = 122U,
+  .X0      = 128,
+  .Shift   = 5U,
+  .Interp  = BSP_LUT_CUBIC,
+};
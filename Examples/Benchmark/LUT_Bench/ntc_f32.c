@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    ntc_f32.c
+  * @brief   NTC_F32 lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ntc_f32.h"
+
+/* Private variables ---------------------------------------------------------*/
+static const float NTC_F32_Y[64] =
+{
+  129.3104184194595f, 113.25657823997409f, 102.35340529956426f, 94.14096562507962f,
+  87.56722477608213f, 82.08921211264834f, 77.39163902544715f, 73.27587244534527f,
+  69.6090295744134f, 66.2980117838697f, 63.27515447544357f, 60.489783666360324f,
+  57.90299094332926f, 55.484262836801065f, 53.20922930244495f, 51.05811438576637f,
+  49.014642371682044f, 47.065248007566254f, 45.19849487405969f, 43.40463941572688f,
+  41.675298910924255f, 40.00319490674593f, 38.38195229736334f, 36.80593999721111f,
+  35.27014308677019f, 33.77005902521887f, 32.301612432885236f, 30.86108430591605f,
+  29.44505250541789f, 28.050341076443317f, 26.673976474872518f, 25.313149164593426f,
+  23.965179329318516f, 22.627485647665594f, 21.297556223726872f, 19.972920859520286f,
+  18.651123907362205f, 17.329696952645463f, 16.00613055080038f, 14.677844173063818f,
+  13.342153396925994f, 11.996233196699166f, 10.637075928789216f, 9.261442236576897f,
+  7.865802578686612f, 6.446266347416838f, 4.998494492760074f, 3.517590048870886f,
+  1.997958732073016f, 0.43312845114621723f, -1.18448850722325f, -2.863914788406248f,
+  -4.616045679977276f, -6.454263205106827f, -8.395320724317003f, -10.460656723027626f,
+  -12.678417400116018f, -15.086707483818259f, -17.73909804785322f, -20.714598010417006f,
+  -24.137332752561264f, -28.220222931456902f, -33.38009844112179f, -40.64028799435704f,
+};
+
+/* Exported variables --------------------------------------------------------*/
+const BSP_LUT_F32_TypeDef NTC_F32_Table =
+{
+  .pX      = NULL,
+  .pY      = NTC_F32_Y,
+  .Count   = 64U,
+  .X0      = 128.0f,
+  .InvStep = 0.01627066115702479f,
+  .Interp  = BSP_LUT_CUBIC,
+};
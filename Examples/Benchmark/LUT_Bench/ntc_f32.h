@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    ntc_f32.h
+  * @brief   Header file of the NTC_F32 lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NTC_F32_H
+#define __NTC_F32_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_lut.h"
+
+/* Exported variables --------------------------------------------------------*/
+extern const BSP_LUT_F32_TypeDef NTC_F32_Table;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NTC_F32_H */
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    ntc_lin.c
+  * @brief   NTC_LIN lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ntc_lin.h"
+
+/* Private variables ---------------------------------------------------------*/
+static const int32_t NTC_LIN_Y[243] =
+{
+  129310, 124376, 120046, 116194, 112729, 109583, 106704, 104051,
+  101592, 99303, 97160, 95148, 93251, 91457, 89756, 88139,
+  86597, 85124, 83714, 82361, 81063, 79813, 78608, 77446,
+  76323, 75237, 74184, 73164, 72174, 71212, 70276, 69366,
+  68479, 67614, 66771, 65948, 65143, 64357, 63588, 62835,
+  62098, 61376, 60667, 59973, 59291, 58622, 57965, 57319,
+  56684, 56060, 55446, 54841, 54246, 53659, 53082, 52512,
+  51951, 51397, 50851, 50312, 49780, 49254, 48735, 48223,
+  47716, 47215, 46720, 46230, 45746, 45267, 44792, 44323,
+  43858, 43397, 42941, 42490, 42042, 41598, 41158, 40722,
+  40290, 39861, 39435, 39013, 38594, 38178, 37765, 37355,
+  36947, 36543, 36141, 35742, 35345, 34951, 34559, 34170,
+  33782, 33397, 33014, 32633, 32254, 31876, 31501, 31127,
+  30755, 30385, 30016, 29648, 29283, 28918, 28555, 28194,
+  27833, 27474, 27116, 26759, 26403, 26048, 25694, 25341,
+  24989, 24638, 24287, 23937, 23588, 23240, 22892, 22545,
+  22198, 21852, 21506, 21161, 20815, 20471, 20126, 19782,
+  19437, 19093, 18749, 18405, 18061, 17717, 17373, 17029,
+  16685, 16340, 15995, 15650, 15304, 14958, 14612, 14265,
+  13917, 13569, 13220, 12871, 12520, 12169, 11817, 11464,
+  11111, 10756, 10400, 10042, 9684, 9324, 8963, 8601,
+  8237, 7872, 7505, 7136, 6765, 6393, 6019, 5642,
+  5264, 4883, 4501, 4115, 3728, 3338, 2945, 2549,
+  2151, 1749, 1344, 936, 525, 110, -308, -731,
+  -1157, -1588, -2023, -2462, -2906, -3356, -3810, -4269,
+  -4735, -5206, -5683, -6167, -6658, -7155, -7660, -8173,
+  -8694, -9224, -9763, -10311, -10869, -11439, -12019, -12612,
+  -13217, -13836, -14469, -15118, -15783, -16466, -17168, -17890,
+  -18634, -19402, -20196, -21018, -21871, -22758, -23683, -24649,
+  -25661, -26726, -27850, -29041, -30310, -31669, -33136, -34731,
+  -36484, -38434, -40640,
+};
+
+/* Exported variables --------------------------------------------------------*/
+const BSP_LUT_I32_TypeDef NTC_LIN_Table =
+{
+  .pX      = NULL,
+  .pY      = NTC_LIN_Y,
+  .Count   = 243U,
+  .X0      = 128,
+  .Shift   = 4U,
+  .Interp  = BSP_LUT_LINEAR,
+};
@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    ntc_lin.h
+  * @brief   Header file of the NTC_LIN lookup table, y = 1/(1/298.15+log(x/(4095-x))/3950)-273.15.
+  *          Generated by Misc/Tools/lut2c.py, do not edit.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NTC_LIN_H
+#define __NTC_LIN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_lut.h"
+
+/* Exported variables --------------------------------------------------------*/
+extern const BSP_LUT_I32_TypeDef NTC_LIN_Table;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NTC_LIN_H */
@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/*
+ * Cycle counts of memcpy(), memmove() and memset() of the C library against
+ * BSP_MEMOPS_Copy(), BSP_MEMOPS_Move() and BSP_MEMOPS_Set(), built with
+ * USE_BSP=y, printed on USART1 TX PA9 at 115200 as the lines of HAL_Bench:
+ *   BENCH <name> <size> <min> <median> <max>
+ * framed by BENCH_START and BENCH_END, for Misc/Tools/benchreport.py.
+ * Build with USE_MEMOPS=n for the newlib-nano functions, "libc=newlib" on
+ * the BENCH_START line; with USE_MEMOPS=y the C library functions are the
+ * ones of the BSP, "libc=bsp".
+ *
+ *   copy_libc, copy_bsp        word aligned source and destination
+ *   copyu_libc, copyu_bsp      source at an odd address
+ *   copy_dma                   BSP_MEMOPS_Copy() with the DMA attached
+ *   move_libc, move_bsp        destination 4 bytes above the source, overlapping
+ *   set_libc, set_bsp          word aligned destination
+ */
+
+/* Runs of each benchmark */
+#define APP_SAMPLES         32U
+
+/* Sizes, in bytes */
+static const uint32_t aSize[] = {16U, 64U, 256U, 1024U, 4096U};
+#define APP_SIZE_MAX        4096U
+
+/* Run Code APP_SAMPLES times, the cycles of each run in aSample */
+#define APP_MEASURE(Code)                                   \
+  do                                                        \
+  {                                                         \
+    uint32_t n;                                             \
+    uint32_t start;                                         \
+    __disable_irq();                                        \
+    for (n = 0U; n < APP_SAMPLES; n++)                      \
+    {                                                       \
+      start = DWT->CYCCNT;                                  \
+      Code;                                                 \
+      aSample[n] = DWT->CYCCNT - start;                     \
+    }                                                       \
+    __enable_irq();                                         \
+  } while (0)
+
+UART_HandleTypeDef UartHandle;
+DMA_HandleTypeDef  DmaHandle;
+
+static uint32_t aSample[APP_SAMPLES];
+static uint32_t Overhead;
+static uint32_t Lines;
+
+/* A word more for the odd source and the moves */
+static uint32_t aSrc[APP_SIZE_MAX / 4U + 2U];
+static uint32_t aDst[APP_SIZE_MAX / 4U + 2U];
+static uint32_t aRef[APP_SIZE_MAX / 4U + 2U];
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_DmaConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid);
+static void APP_BenchCopy(uint32_t Size);
+static void APP_BenchMove(uint32_t Size);
+static void APP_BenchSet(uint32_t Size);
+
+
+int main(void)
+{
+  uint8_t *src = (uint8_t *)aSrc;
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_DmaConfig();
+
+  for (i = 0U; i < sizeof(aSrc); i++)
+  {
+    src[i] = (uint8_t)((i * 37U) ^ (i >> 8));
+  }
+
+  while (1)
+  {
+    /* Cycles of an empty measurement, the two reads of the counter */
+    APP_MEASURE(__NOP());
+    Overhead = 0U;
+    for (i = 0U; i < APP_SAMPLES; i++)
+    {
+      Overhead = ((i == 0U) || (aSample[i] < Overhead)) ? aSample[i] : Overhead;
+    }
+
+    Lines = 0U;
+#if defined (USE_BSP_MEMOPS)
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu libc=bsp\r\n",
+#else
+    printf("BENCH_START hclk=%lu samples=%lu overhead=%lu libc=newlib\r\n",
+#endif
+           HAL_RCC_GetHCLKFreq(), (uint32_t)APP_SAMPLES, Overhead);
+    for (i = 0U; i < (sizeof(aSize) / sizeof(aSize[0])); i++)
+    {
+      APP_BenchCopy(aSize[i]);
+      APP_BenchMove(aSize[i]);
+      APP_BenchSet(aSize[i]);
+    }
+    printf("BENCH_END %lu\r\n", Lines);
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Print the line of a benchmark from the runs in aSample.
+  * @param  pName Name of the benchmark.
+  * @param  Arg   Size of the benchmark.
+  * @param  Valid 0 when the result of a run was wrong.
+  */
+static void APP_Report(const char *pName, uint32_t Arg, uint32_t Valid)
+{
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  Lines++;
+  if (Valid == 0U)
+  {
+    printf("BENCH %s %lu err\r\n", pName, Arg);
+    return;
+  }
+
+  /* Insertion sort, the runs are few */
+  for (i = 1U; i < APP_SAMPLES; i++)
+  {
+    value = aSample[i];
+    for (j = i; (j > 0U) && (aSample[j - 1U] > value); j--)
+    {
+      aSample[j] = aSample[j - 1U];
+    }
+    aSample[j] = value;
+  }
+  for (i = 0U; i < APP_SAMPLES; i++)
+  {
+    aSample[i] = (aSample[i] > Overhead) ? (aSample[i] - Overhead) : 0U;
+  }
+
+  printf("BENCH %s %lu %lu %lu %lu\r\n", pName, Arg,
+         aSample[0], aSample[APP_SAMPLES / 2U], aSample[APP_SAMPLES - 1U]);
+}
+
+static void APP_BenchCopy(uint32_t Size)
+{
+  uint8_t *dst = (uint8_t *)aDst;
+  const uint8_t *src = (const uint8_t *)aSrc;
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(memcpy(dst, src, Size));
+  APP_Report("copy_libc", Size, (memcmp(dst, src, Size) == 0) ? 1U : 0U);
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(BSP_MEMOPS_Copy(dst, src, Size));
+  APP_Report("copy_bsp", Size, (memcmp(dst, src, Size) == 0) ? 1U : 0U);
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(memcpy(dst, src + 1U, Size));
+  APP_Report("copyu_libc", Size, (memcmp(dst, src + 1U, Size) == 0) ? 1U : 0U);
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(BSP_MEMOPS_Copy(dst, src + 1U, Size));
+  APP_Report("copyu_bsp", Size, (memcmp(dst, src + 1U, Size) == 0) ? 1U : 0U);
+
+  memset(aDst, 0, sizeof(aDst));
+  if (BSP_MEMOPS_AttachDma(&DmaHandle, BSP_MEMOPS_SMALL) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  APP_MEASURE(BSP_MEMOPS_Copy(dst, src, Size));
+  BSP_MEMOPS_DetachDma();
+  APP_Report("copy_dma", Size, (memcmp(dst, src, Size) == 0) ? 1U : 0U);
+}
+
+static void APP_BenchMove(uint32_t Size)
+{
+  uint8_t *dst = (uint8_t *)aDst;
+  uint8_t *ref = (uint8_t *)aRef;
+  uint32_t n;
+
+  /* Each run moves the result of the previous one, the reference does the same */
+  memcpy(aRef, aSrc, sizeof(aRef));
+  for (n = 0U; n < APP_SAMPLES; n++)
+  {
+    memmove(ref + 4U, ref, Size);
+  }
+
+  memcpy(aDst, aSrc, sizeof(aDst));
+  APP_MEASURE(memmove(dst + 4U, dst, Size));
+  APP_Report("move_libc", Size, (memcmp(aDst, aRef, sizeof(aRef)) == 0) ? 1U : 0U);
+
+  memcpy(aDst, aSrc, sizeof(aDst));
+  APP_MEASURE(BSP_MEMOPS_Move(dst + 4U, dst, Size));
+  APP_Report("move_bsp", Size, (memcmp(aDst, aRef, sizeof(aRef)) == 0) ? 1U : 0U);
+}
+
+static void APP_BenchSet(uint32_t Size)
+{
+  const uint8_t *dst = (const uint8_t *)aDst;
+  uint32_t valid;
+  uint32_t i;
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(memset(aDst, 0xA5, Size));
+  for (valid = 1U, i = 0U; i < Size; i++)
+  {
+    valid &= (dst[i] == 0xA5U) ? 1U : 0U;
+  }
+  APP_Report("set_libc", Size, valid);
+
+  memset(aDst, 0, sizeof(aDst));
+  APP_MEASURE(BSP_MEMOPS_Set(aDst, 0x5A, Size));
+  for (valid = 1U, i = 0U; i < Size; i++)
+  {
+    valid &= (dst[i] == 0x5AU) ? 1U : 0U;
+  }
+  APP_Report("set_bsp", Size, valid);
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_DmaConfig(void)
+{
+  /* Memory to memory, words, without interrupt, completion polled */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  DmaHandle.Instance                 = DMA1_Channel2;
+  DmaHandle.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+  DmaHandle.Init.PeriphInc           = DMA_PINC_ENABLE;     /* Source */
+  DmaHandle.Init.MemInc              = DMA_MINC_ENABLE;     /* Destination */
+  DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  DmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+  DmaHandle.Init.Mode                = DMA_NORMAL;
+  DmaHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&DmaHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
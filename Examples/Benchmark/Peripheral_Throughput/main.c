@@ -0,0 +1,566 @@
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/*
+ * Throughput of the SPI, UART and I2C HAL drivers in polling, IT and DMA
+ * mode, over a sweep of transfer sizes. Each run is a loopback:
+ *   SPI1   master, MOSI PA7 wired to MISO PA6
+ *   USART2 TX PA2 wired to RX PA3, APP_UART_BAUDRATE
+ *   I2C1   master PB6/PB7 wired to I2C2 slave PB10/PB11, pull-ups on both lines
+ * The results are printed on USART1 TX PA9 at 115200.
+ *
+ * For each run the line gives:
+ *   B/s    payload bytes over the time from the start call to the last callback
+ *   cpu    CPU occupancy, from the iterations of an idle loop spinning until
+ *          the end of the transfer against the same loop with interrupts masked
+ *   isr    cycles spent in the interrupt handlers of the run and their count
+ * In polling mode the UART and I2C receivers run in DMA so that the blocking
+ * call is the only thing measured on the CPU, their DMA interrupts are counted
+ * in isr.
+ *
+ * The sweep is followed by the short register writes of a sensor driver, the
+ * cycles of one HAL_I2C_Mem_Write() call against one HAL_I2CEx_FastWrite()
+ * call. Both include the same bus time, their difference is the software
+ * overhead saved by the fast path.
+ */
+
+/* Transfer sizes of the sweep */
+static const uint16_t aBenchSize[] = {1U, 16U, 64U, 256U, 1024U};
+#define APP_BENCH_SIZE_MAX  1024U
+
+/* Register write sizes, after a one byte register address */
+static const uint16_t aRegSize[] = {1U, 2U, 4U, 8U};
+#define APP_REG_ADDRESS     0x10U
+
+#define APP_MODE_POLLING    0U
+#define APP_MODE_IT         1U
+#define APP_MODE_DMA        2U
+
+#define APP_UART_BAUDRATE   1000000U
+#define APP_I2C_SPEED       400000U
+#define APP_I2C_ADDRESS     0xA0U
+
+/* Idle loop iterations timed by the calibration */
+#define APP_IDLE_CALIB      100000U
+
+/* Idle loop iterations before a run is declared stuck, several seconds */
+#define APP_IDLE_TIMEOUT    0x10000000U
+
+typedef HAL_StatusTypeDef (*APP_StartTypeDef)(uint32_t Mode, uint16_t Size);
+
+UART_HandleTypeDef UartHandle;
+UART_HandleTypeDef UartBenchHandle;
+SPI_HandleTypeDef  SpiHandle;
+I2C_HandleTypeDef  I2cMasterHandle;
+I2C_HandleTypeDef  I2cSlaveHandle;
+
+static const char *const aModeName[] = {"poll", "it", "dma"};
+
+static uint8_t aTxBuffer[APP_BENCH_SIZE_MAX];
+static uint8_t aRxBuffer[APP_BENCH_SIZE_MAX];
+
+/* Completion callbacks still expected by the current run */
+static __IO uint32_t BenchPending;
+static __IO uint32_t BenchError;
+static __IO uint32_t BenchIsrCount;
+static __IO uint32_t BenchIsrCycles;
+
+/* Cycles taken by APP_IDLE_CALIB idle loop iterations */
+static uint32_t IdleCalibCycles;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_BenchConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_IdleCalibrate(void);
+static uint32_t APP_IdleLoop(uint32_t Limit);
+static void APP_BenchRun(const char *pName, APP_StartTypeDef Start, uint32_t Mode, uint16_t Size);
+static HAL_StatusTypeDef APP_SpiStart(uint32_t Mode, uint16_t Size);
+static HAL_StatusTypeDef APP_UartStart(uint32_t Mode, uint16_t Size);
+static HAL_StatusTypeDef APP_I2cStart(uint32_t Mode, uint16_t Size);
+static void APP_RegBench(uint16_t Size);
+static uint32_t APP_RegWrite(uint32_t Fast, uint16_t Size);
+
+
+int main(void)
+{
+  uint32_t mode;
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_BenchConfig();
+  APP_IdleCalibrate();
+
+  for (i = 0U; i < APP_BENCH_SIZE_MAX; i++)
+  {
+    aTxBuffer[i] = (uint8_t)(i ^ (i >> 8));
+  }
+
+  while (1)
+  {
+    printf("\r\nHCLK %lu Hz, idle loop %lu cycles per %lu iterations\r\n",
+           HAL_RCC_GetHCLKFreq(), IdleCalibCycles, (uint32_t)APP_IDLE_CALIB);
+    printf("periph mode  size        B/s    cpu    isr cycles/irqs\r\n");
+
+    for (mode = APP_MODE_POLLING; mode <= APP_MODE_DMA; mode++)
+    {
+      for (i = 0U; i < (sizeof(aBenchSize) / sizeof(aBenchSize[0])); i++)
+      {
+        APP_BenchRun("spi", APP_SpiStart, mode, aBenchSize[i]);
+        APP_BenchRun("uart", APP_UartStart, mode, aBenchSize[i]);
+        APP_BenchRun("i2c", APP_I2cStart, mode, aBenchSize[i]);
+      }
+    }
+
+    printf("reg write size  hal cycles fast cycles\r\n");
+    for (i = 0U; i < (sizeof(aRegSize) / sizeof(aRegSize[0])); i++)
+    {
+      APP_RegBench(aRegSize[i]);
+    }
+    HAL_Delay(5000);
+  }
+}
+
+/**
+  * @brief  Record the cycles spent in one interrupt handler call.
+  * @param  Cycles DWT cycle count of the call.
+  */
+void APP_BenchRecord(uint32_t Cycles)
+{
+  BenchIsrCount++;
+  BenchIsrCycles += Cycles;
+}
+
+/**
+  * @brief  Spin until the run completes, the loop body is the unit of the
+  *         CPU occupancy. Not inlined so that the calibration and the runs
+  *         execute the same code.
+  * @param  Limit Maximum number of iterations.
+  * @retval Number of iterations executed.
+  */
+static __attribute__((noinline)) uint32_t APP_IdleLoop(uint32_t Limit)
+{
+  uint32_t count = 0U;
+
+  while ((BenchPending != 0U) && (count < Limit))
+  {
+    count++;
+  }
+  return count;
+}
+
+/**
+  * @brief  Time APP_IDLE_CALIB idle loop iterations with the interrupts masked,
+  *         the reference for a CPU doing nothing else.
+  */
+static void APP_IdleCalibrate(void)
+{
+  uint32_t start;
+
+  __disable_irq();
+  BenchPending = 1U;
+  start = DWT->CYCCNT;
+  (void)APP_IdleLoop(APP_IDLE_CALIB);
+  IdleCalibCycles = DWT->CYCCNT - start;
+  BenchPending = 0U;
+  __enable_irq();
+}
+
+/**
+  * @brief  Run one loopback transfer, check the data and print the figures.
+  * @param  pName Peripheral name printed.
+  * @param  Start Function starting the transfer.
+  * @param  Mode  APP_MODE_POLLING, APP_MODE_IT or APP_MODE_DMA.
+  * @param  Size  Number of bytes.
+  */
+static void APP_BenchRun(const char *pName, APP_StartTypeDef Start, uint32_t Mode, uint16_t Size)
+{
+  uint32_t start;
+  uint32_t cycles;
+  uint32_t idle;
+  uint32_t rate;
+  uint32_t busy;
+  uint64_t idlecycles;
+
+  memset(aRxBuffer, 0, Size);
+  BenchError = 0U;
+  BenchIsrCount = 0U;
+  BenchIsrCycles = 0U;
+
+  start = DWT->CYCCNT;
+  if (Start(Mode, Size) != HAL_OK)
+  {
+    BenchError = 1U;
+    BenchPending = 0U;
+  }
+  idle = APP_IdleLoop(APP_IDLE_TIMEOUT);
+  cycles = DWT->CYCCNT - start;
+
+  if (BenchPending != 0U)
+  {
+    printf("%-6s %-4s %5u  timeout, check the loopback wiring\r\n", pName, aModeName[Mode], Size);
+    APP_ErrorHandler();
+  }
+  if ((BenchError != 0U) || (memcmp(aTxBuffer, aRxBuffer, Size) != 0))
+  {
+    printf("%-6s %-4s %5u  data error\r\n", pName, aModeName[Mode], Size);
+    return;
+  }
+
+  rate = (uint32_t)(((uint64_t)Size * HAL_RCC_GetHCLKFreq()) / cycles);
+
+  /* Occupancy in 0.1 %: share of the run not spent in the idle loop */
+  idlecycles = ((uint64_t)idle * IdleCalibCycles) / APP_IDLE_CALIB;
+  busy = (idlecycles >= cycles) ? 0U : (uint32_t)(((cycles - idlecycles) * 1000U) / cycles);
+
+  printf("%-6s %-4s %5u %10lu %3lu.%lu%% %8lu/%lu\r\n", pName, aModeName[Mode], Size,
+         rate, busy / 10U, busy % 10U, BenchIsrCycles, BenchIsrCount);
+}
+
+static HAL_StatusTypeDef APP_SpiStart(uint32_t Mode, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if (Mode == APP_MODE_POLLING)
+  {
+    BenchPending = 0U;
+    status = HAL_SPI_TransmitReceive(&SpiHandle, aTxBuffer, aRxBuffer, Size, 1000U);
+  }
+  else
+  {
+    BenchPending = 1U;
+    if (Mode == APP_MODE_IT)
+    {
+      status = HAL_SPI_TransmitReceive_IT(&SpiHandle, aTxBuffer, aRxBuffer, Size);
+    }
+    else
+    {
+      status = HAL_SPI_TransmitReceive_DMA(&SpiHandle, aTxBuffer, aRxBuffer, Size);
+    }
+  }
+  return status;
+}
+
+static HAL_StatusTypeDef APP_UartStart(uint32_t Mode, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  /* Drop anything received since the previous run */
+  __HAL_UART_CLEAR_OREFLAG(&UartBenchHandle);
+
+  if (Mode == APP_MODE_POLLING)
+  {
+    BenchPending = 1U;
+    status = HAL_UART_Receive_DMA(&UartBenchHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_UART_Transmit(&UartBenchHandle, aTxBuffer, Size, 1000U);
+    }
+  }
+  else if (Mode == APP_MODE_IT)
+  {
+    BenchPending = 2U;
+    status = HAL_UART_Receive_IT(&UartBenchHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_UART_Transmit_IT(&UartBenchHandle, aTxBuffer, Size);
+    }
+  }
+  else
+  {
+    BenchPending = 2U;
+    status = HAL_UART_Receive_DMA(&UartBenchHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_UART_Transmit_DMA(&UartBenchHandle, aTxBuffer, Size);
+    }
+  }
+  return status;
+}
+
+static HAL_StatusTypeDef APP_I2cStart(uint32_t Mode, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if (Mode == APP_MODE_POLLING)
+  {
+    BenchPending = 1U;
+    status = HAL_I2C_Slave_Receive_DMA(&I2cSlaveHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_I2C_Master_Transmit(&I2cMasterHandle, APP_I2C_ADDRESS, aTxBuffer, Size, 1000U);
+    }
+  }
+  else if (Mode == APP_MODE_IT)
+  {
+    BenchPending = 2U;
+    status = HAL_I2C_Slave_Receive_IT(&I2cSlaveHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_I2C_Master_Transmit_IT(&I2cMasterHandle, APP_I2C_ADDRESS, aTxBuffer, Size);
+    }
+  }
+  else
+  {
+    BenchPending = 2U;
+    status = HAL_I2C_Slave_Receive_DMA(&I2cSlaveHandle, aRxBuffer, Size);
+    if (status == HAL_OK)
+    {
+      status = HAL_I2C_Master_Transmit_DMA(&I2cMasterHandle, APP_I2C_ADDRESS, aTxBuffer, Size);
+    }
+  }
+  return status;
+}
+
+/**
+  * @brief  Time a register write with the generic and the fast function.
+  * @param  Size  Number of data bytes.
+  */
+static void APP_RegBench(uint16_t Size)
+{
+  uint32_t hal;
+  uint32_t fast;
+
+  hal = APP_RegWrite(0U, Size);
+  fast = APP_RegWrite(1U, Size);
+  if ((hal == 0U) || (fast == 0U))
+  {
+    printf("reg write %4u  error\r\n", Size);
+    return;
+  }
+  printf("reg write %4u %11lu %11lu\r\n", Size, hal, fast);
+}
+
+/**
+  * @brief  Write registers to the I2C2 slave and check what it received.
+  * @param  Fast  0 for HAL_I2C_Mem_Write(), 1 for HAL_I2CEx_FastWrite().
+  * @param  Size  Number of data bytes.
+  * @retval Cycles of the write call, 0 on error.
+  */
+static uint32_t APP_RegWrite(uint32_t Fast, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+  uint32_t start;
+  uint32_t cycles;
+
+  memset(aRxBuffer, 0, Size + 1U);
+  BenchError = 0U;
+  BenchPending = 1U;
+
+  /* The slave gets the register address then the data */
+  if (HAL_I2C_Slave_Receive_DMA(&I2cSlaveHandle, aRxBuffer, Size + 1U) != HAL_OK)
+  {
+    return 0U;
+  }
+
+  start = DWT->CYCCNT;
+  if (Fast == 0U)
+  {
+    status = HAL_I2C_Mem_Write(&I2cMasterHandle, APP_I2C_ADDRESS, APP_REG_ADDRESS, I2C_MEMADD_SIZE_8BIT,
+                               aTxBuffer, Size, 1000U);
+  }
+  else
+  {
+    status = HAL_I2CEx_FastWrite(&I2cMasterHandle, APP_I2C_ADDRESS, APP_REG_ADDRESS, I2C_MEMADD_SIZE_8BIT,
+                                 aTxBuffer, Size, HAL_I2CEX_FAST_BUDGET(HAL_RCC_GetHCLKFreq(), APP_I2C_SPEED));
+  }
+  cycles = DWT->CYCCNT - start;
+
+  if (status != HAL_OK)
+  {
+    HAL_I2C_DeInit(&I2cSlaveHandle);
+    HAL_I2C_Init(&I2cSlaveHandle);
+    return 0U;
+  }
+  if (APP_IdleLoop(APP_IDLE_TIMEOUT) == APP_IDLE_TIMEOUT)
+  {
+    return 0U;
+  }
+  if ((BenchError != 0U) || (aRxBuffer[0] != APP_REG_ADDRESS) || (memcmp(aTxBuffer, &aRxBuffer[1], Size) != 0))
+  {
+    return 0U;
+  }
+  return cycles;
+}
+
+/* The Tx and Rx completes of a transfer may preempt each other */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  (void)HAL_AtomicAdd(&BenchPending, 0xFFFFFFFFU);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  BenchError = 1U;
+  BenchPending = 0U;
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  (void)HAL_AtomicAdd(&BenchPending, 0xFFFFFFFFU);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  (void)HAL_AtomicAdd(&BenchPending, 0xFFFFFFFFU);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  BenchError = 1U;
+  BenchPending = 0U;
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)HAL_AtomicAdd(&BenchPending, 0xFFFFFFFFU);
+}
+
+void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)HAL_AtomicAdd(&BenchPending, 0xFFFFFFFFU);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  BenchError = 1U;
+  BenchPending = 0U;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_BenchConfig(void)
+{
+  SpiHandle.Instance               = SPI1;
+  SpiHandle.Init.Mode              = SPI_MODE_MASTER;
+  SpiHandle.Init.Direction         = SPI_DIRECTION_2LINES;
+  SpiHandle.Init.DataSize          = SPI_DATASIZE_8BIT;
+  SpiHandle.Init.CLKPolarity       = SPI_POLARITY_LOW;
+  SpiHandle.Init.CLKPhase          = SPI_PHASE_1EDGE;
+  SpiHandle.Init.NSS               = SPI_NSS_SOFT;
+  /* PCLK2 / 8 */
+  SpiHandle.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8;
+  SpiHandle.Init.FirstBit          = SPI_FIRSTBIT_MSB;
+  SpiHandle.Init.SlaveFastMode     = SPI_SLAVE_FAST_MODE_DISABLE;
+  SpiHandle.Init.CRCCalculation    = SPI_CRCCALCULATION_DISABLE;
+  SpiHandle.Init.CRCPolynomial     = 7;
+  if (HAL_SPI_Init(&SpiHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  UartBenchHandle.Instance          = USART2;
+  UartBenchHandle.Init.BaudRate     = APP_UART_BAUDRATE;
+  UartBenchHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartBenchHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartBenchHandle.Init.Parity       = UART_PARITY_NONE;
+  UartBenchHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartBenchHandle.Init.Mode         = UART_MODE_TX_RX;
+  UartBenchHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartBenchHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  I2cMasterHandle.Instance             = I2C1;
+  I2cMasterHandle.Init.ClockSpeed      = APP_I2C_SPEED;
+  I2cMasterHandle.Init.DutyCycle       = I2C_DUTYCYCLE_2;
+  I2cMasterHandle.Init.OwnAddress1     = 0U;
+  I2cMasterHandle.Init.AddressingMode  = I2C_ADDRESSINGMODE_7BIT;
+  I2cMasterHandle.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+  I2cMasterHandle.Init.OwnAddress2     = 0U;
+  I2cMasterHandle.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+  I2cMasterHandle.Init.NoStretchMode   = I2C_NOSTRETCH_DISABLE;
+  if (HAL_I2C_Init(&I2cMasterHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  I2cSlaveHandle.Instance              = I2C2;
+  I2cSlaveHandle.Init                  = I2cMasterHandle.Init;
+  I2cSlaveHandle.Init.OwnAddress1      = APP_I2C_ADDRESS;
+  if (HAL_I2C_Init(&I2cSlaveHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV4;                        /* APB1 clock divided by 4, I2C FREQ field is 6 bits */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_5) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
@@ -0,0 +1,24 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "py32f4xx_hal.h"
+
+
+extern UART_HandleTypeDef UartHandle;
+extern UART_HandleTypeDef UartBenchHandle;
+extern SPI_HandleTypeDef  SpiHandle;
+extern I2C_HandleTypeDef  I2cMasterHandle;
+extern I2C_HandleTypeDef  I2cSlaveHandle;
+
+void APP_ErrorHandler(void);
+void APP_BenchRecord(uint32_t Cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
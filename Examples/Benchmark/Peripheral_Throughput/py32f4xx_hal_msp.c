@@ -0,0 +1,203 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_msp.c
+  * @author  MCU Application Team
+  * @brief   This file provides code for the MSP Initialization
+  *          and de-Initialization codes.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2023 Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by Puya under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef HdmaSpiRx;
+static DMA_HandleTypeDef HdmaSpiTx;
+static DMA_HandleTypeDef HdmaUartRx;
+static DMA_HandleTypeDef HdmaUartTx;
+static DMA_HandleTypeDef HdmaI2cTx;
+static DMA_HandleTypeDef HdmaI2cRx;
+
+/* Private function prototypes -----------------------------------------------*/
+static void APP_DmaConfig(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *Channel, uint32_t Direction,
+                          uint32_t MapReqNum, IRQn_Type IRQn);
+
+/* External functions --------------------------------------------------------*/
+
+/**
+  * @brief Initialize global MSP
+  */
+void HAL_MspInit(void)
+{
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+}
+
+/**
+  * @brief Initialize one byte wide normal mode DMA channel and its interrupt
+  */
+static void APP_DmaConfig(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *Channel, uint32_t Direction,
+                          uint32_t MapReqNum, IRQn_Type IRQn)
+{
+  hdma->Instance                 = Channel;
+  hdma->Init.Direction           = Direction;
+  hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma->Init.MemInc              = DMA_MINC_ENABLE;
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hdma->Init.Mode                = DMA_NORMAL;
+  hdma->Init.Priority            = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  HAL_DMA_ChannelMap(hdma, MapReqNum);
+
+  HAL_NVIC_SetPriority(IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(IRQn);
+}
+
+/**
+  * @brief Initialize UART MSP
+  */
+void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+
+  if (huart->Instance == USART1)
+  {
+    __HAL_RCC_USART1_CLK_ENABLE();
+
+    /* PA9: USART1 TX, results output */
+    GPIO_InitStruct.Pin = GPIO_PIN_9;
+    GPIO_InitStruct.Alternate = GPIO_AF2_USART1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+  }
+  else
+  {
+    __HAL_RCC_USART2_CLK_ENABLE();
+
+    /* PA2: USART2 TX, PA3: USART2 RX, wired together */
+    GPIO_InitStruct.Pin = GPIO_PIN_2 | GPIO_PIN_3;
+    GPIO_InitStruct.Alternate = GPIO_AF2_USART2;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    APP_DmaConfig(&HdmaUartRx, DMA1_Channel3, DMA_PERIPH_TO_MEMORY, DMA_CHANNEL_MAP_USART2_RD, DMA1_Channel3_IRQn);
+    __HAL_LINKDMA(huart, hdmarx, HdmaUartRx);
+    APP_DmaConfig(&HdmaUartTx, DMA1_Channel4, DMA_MEMORY_TO_PERIPH, DMA_CHANNEL_MAP_USART2_WR, DMA1_Channel4_IRQn);
+    __HAL_LINKDMA(huart, hdmatx, HdmaUartTx);
+
+    HAL_NVIC_SetPriority(USART2_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(USART2_IRQn);
+  }
+}
+
+/**
+  * @brief Initialize SPI MSP
+  */
+void HAL_SPI_MspInit(SPI_HandleTypeDef *hspi)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_SPI1_CLK_ENABLE();
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+
+  /* PA5: SPI1 SCK, PA6: SPI1 MISO, PA7: SPI1 MOSI, MOSI wired to MISO */
+  GPIO_InitStruct.Pin = GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF3_SPI1;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  APP_DmaConfig(&HdmaSpiRx, DMA1_Channel1, DMA_PERIPH_TO_MEMORY, DMA_CHANNEL_MAP_SPI1_RD, DMA1_Channel1_IRQn);
+  __HAL_LINKDMA(hspi, hdmarx, HdmaSpiRx);
+  APP_DmaConfig(&HdmaSpiTx, DMA1_Channel2, DMA_MEMORY_TO_PERIPH, DMA_CHANNEL_MAP_SPI1_WR, DMA1_Channel2_IRQn);
+  __HAL_LINKDMA(hspi, hdmatx, HdmaSpiTx);
+
+  HAL_NVIC_SetPriority(SPI1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(SPI1_IRQn);
+}
+
+/**
+  * @brief Initialize I2C MSP
+  */
+void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF1_I2C1;
+
+  if (hi2c->Instance == I2C1)
+  {
+    __HAL_RCC_I2C1_CLK_ENABLE();
+
+    /* PB6: I2C1 SCL, PB7: I2C1 SDA, master */
+    GPIO_InitStruct.Pin = GPIO_PIN_6 | GPIO_PIN_7;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    APP_DmaConfig(&HdmaI2cTx, DMA1_Channel5, DMA_MEMORY_TO_PERIPH, DMA_CHANNEL_MAP_I2C1_WR, DMA1_Channel5_IRQn);
+    __HAL_LINKDMA(hi2c, hdmatx, HdmaI2cTx);
+
+    HAL_NVIC_SetPriority(I2C1_EV_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+    HAL_NVIC_SetPriority(I2C1_ER_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+  }
+  else
+  {
+    __HAL_RCC_I2C2_CLK_ENABLE();
+
+    /* PB10: I2C2 SCL, PB11: I2C2 SDA, slave */
+    GPIO_InitStruct.Pin = GPIO_PIN_10 | GPIO_PIN_11;
+    GPIO_InitStruct.Alternate = GPIO_AF1_I2C2;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    APP_DmaConfig(&HdmaI2cRx, DMA1_Channel6, DMA_PERIPH_TO_MEMORY, DMA_CHANNEL_MAP_I2C2_RD, DMA1_Channel6_IRQn);
+    __HAL_LINKDMA(hi2c, hdmarx, HdmaI2cRx);
+
+    HAL_NVIC_SetPriority(I2C2_EV_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(I2C2_EV_IRQn);
+    HAL_NVIC_SetPriority(I2C2_ER_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(I2C2_ER_IRQn);
+  }
+}
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
@@ -0,0 +1,476 @@
+#include <stdio.h>
+#include "main.h"
+
+/*
+ * Characterisation of an SD card on the SDIO, built with USE_BSP=y. The
+ * results are printed on USART1 TX PA9 at 115200.
+ *
+ * The card is wired on PC8-PC11 D0-D3, PC12 CK and PD2 CMD, the transfers run
+ * with HAL_SD_ReadBlocks_DMA() and HAL_SD_WriteBlocks_DMA() on DMA1 channels
+ * 1 and 2. WARNING: the area from APP_BENCH_LBA, 64 Mbytes, is overwritten.
+ *
+ * For each bus setting, the high speed one last since the card keeps it
+ * until its power cycle:
+ *   seq      Kbytes/s reading then writing APP_SEQ_BLOCKS blocks from
+ *            APP_BENCH_LBA, in commands of 1, 8 and 64 blocks
+ *   rand     IOPS and worst latency of APP_RAND_OPS 4 Kbyte reads then
+ *            writes at random aligned addresses of the area
+ *   lat      latencies of all the writes of the setting, from the command to
+ *            the card back in the transfer state, in bins up to 1 ms, 2 ms,
+ *            5 ms, 10 ms, 20 ms, 50 ms, 100 ms, 250 ms and over
+ *   outliers the APP_OUTLIERS slowest writes, the pauses of the card
+ *            garbage collection: the buffering of a logger must cover the
+ *            longest one at its data rate
+ * The latencies are measured in us with the DWT cycle counter.
+ */
+
+#define APP_BENCH_LBA       0x00100000U   /* 512 Mbytes in, clear of the filesystem structures */
+#define APP_BENCH_SPAN      0x00020000U   /* 64 Mbytes */
+#define APP_SEQ_BLOCKS      2048U         /* 1 Mbyte per sequential run */
+#define APP_RAND_OPS        256U
+#define APP_RAND_BLOCKS     8U            /* 4 Kbytes */
+#define APP_BLOCKS_MAX      64U
+#define APP_OUTLIERS        8U
+#define APP_TIMEOUT         1000U         /* ms, past the 250/500 ms write timeout of the cards */
+#define APP_XFER_ERROR      0xFFFFFFFFU
+
+/* Block counts of the sequential runs */
+static const uint32_t aBlockCount[] = {1U, 8U, APP_BLOCKS_MAX};
+
+/* Upper bounds of the latency bins, us, the last bin holds the rest */
+static const uint32_t aBinLimit[] = {1000U, 2000U, 5000U, 10000U, 20000U, 50000U, 100000U, 250000U};
+#define APP_BINS            ((sizeof(aBinLimit) / sizeof(aBinLimit[0])) + 1U)
+
+typedef struct
+{
+  const char *pName;
+  uint32_t    BusWide;
+  uint32_t    MaxClock;
+  uint32_t    HighSpeed;
+} APP_BusTypeDef;
+
+static const APP_BusTypeDef aBus[] =
+{
+  {"1 bit 25 MHz",     SDIO_BUS_WIDE_1B, 25000000U, 0U},
+  {"4 bit 12.5 MHz",   SDIO_BUS_WIDE_4B, 12500000U, 0U},
+  {"4 bit 25 MHz",     SDIO_BUS_WIDE_4B, 25000000U, 0U},
+  {"4 bit high speed", SDIO_BUS_WIDE_4B, 50000000U, 1U},
+};
+
+typedef struct
+{
+  uint32_t Lba;
+  uint32_t Blocks;
+  uint32_t Latency;
+} APP_OutlierTypeDef;
+
+typedef struct
+{
+  uint32_t           Count;
+  uint32_t           Bins[APP_BINS];
+  APP_OutlierTypeDef Outliers[APP_OUTLIERS];
+} APP_LatencyTypeDef;
+
+UART_HandleTypeDef UartHandle;
+SD_HandleTypeDef   SdHandle;
+
+static uint32_t aBuffer[(APP_BLOCKS_MAX * BLOCKSIZE) / 4U];
+static APP_LatencyTypeDef WriteLatency;
+static uint32_t CyclesPerUs;
+static uint32_t RandSeed;
+
+static __IO uint32_t XferPending;
+static __IO uint32_t XferError;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_SdConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_BusConfig(const APP_BusTypeDef *pBus);
+static void APP_BenchSequential(uint32_t Write);
+static void APP_BenchRandom(uint32_t Write);
+static void APP_PrintLatency(void);
+static void APP_Record(uint32_t Lba, uint32_t Blocks, uint32_t Latency);
+static uint32_t APP_Transfer(uint32_t Write, uint32_t Lba, uint32_t Blocks);
+static uint32_t APP_Random(void);
+
+
+int main(void)
+{
+  uint32_t i;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+  APP_SdConfig();
+
+  for (i = 0U; i < (sizeof(aBuffer) / sizeof(aBuffer[0])); i++)
+  {
+    aBuffer[i] = (i * 0x9E3779B9U) ^ 0x5A5A5A5AU;
+  }
+
+  printf("\r\nHCLK %lu Hz, card %lu blocks, class %lu\r\n", HAL_RCC_GetHCLKFreq(),
+         SdHandle.SdCard.LogBlockNbr, SdHandle.SdCard.Class);
+  if (SdHandle.SdCard.LogBlockNbr < (APP_BENCH_LBA + APP_BENCH_SPAN))
+  {
+    printf("card too small for the test area\r\n");
+    APP_ErrorHandler();
+  }
+
+  for (i = 0U; i < (sizeof(aBus) / sizeof(aBus[0])); i++)
+  {
+    APP_BusConfig(&aBus[i]);
+    WriteLatency = (APP_LatencyTypeDef){0};
+    RandSeed = 1U;
+
+    APP_BenchSequential(0U);
+    APP_BenchSequential(1U);
+    APP_BenchRandom(0U);
+    APP_BenchRandom(1U);
+    APP_PrintLatency();
+  }
+  printf("done\r\n");
+
+  while (1)
+  {
+  }
+}
+
+/**
+  * @brief  Set the bus width and the clock of a setting.
+  * @param  pBus Setting.
+  */
+static void APP_BusConfig(const APP_BusTypeDef *pBus)
+{
+  BSP_SDHS_ResultTypeDef result;
+  uint32_t hclk = HAL_RCC_GetHCLKFreq();
+  uint32_t div;
+
+  if (pBus->HighSpeed != 0U)
+  {
+    if (BSP_SDHS_Config(&SdHandle, pBus->MaxClock, APP_BENCH_LBA, (uint8_t *)aBuffer, APP_BLOCKS_MAX,
+                        &result) != HAL_OK)
+    {
+      APP_ErrorHandler();
+    }
+    printf("\r\n%s: %s, %lu Hz, %lu retries\r\n", pBus->pName,
+           (result.HighSpeed != 0U) ? "switched" : "not supported", result.Clock, result.Retries);
+    return;
+  }
+
+  /* Smallest divider under the limit, the card clock being HCLK / (2 x div) */
+  div = (hclk <= pBus->MaxClock) ? 0U : ((hclk + (2U * pBus->MaxClock) - 1U) / (2U * pBus->MaxClock));
+  SdHandle.Init.ClockDiv = div;
+  if (HAL_SD_ConfigWideBusOperation(&SdHandle, pBus->BusWide) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  SdHandle.Init.BusWide = pBus->BusWide;
+  printf("\r\n%s: %lu Hz\r\n", pBus->pName, (div == 0U) ? hclk : (hclk / (2U * div)));
+}
+
+/**
+  * @brief  Read or write the sequential area at each block count.
+  * @param  Write 1 to write, 0 to read.
+  */
+static void APP_BenchSequential(uint32_t Write)
+{
+  uint32_t latency;
+  uint32_t total;
+  uint32_t blocks;
+  uint32_t lba;
+  uint32_t i;
+
+  printf("  seq %s  ", (Write != 0U) ? "write" : "read ");
+  for (i = 0U; i < (sizeof(aBlockCount) / sizeof(aBlockCount[0])); i++)
+  {
+    blocks = aBlockCount[i];
+    total = 0U;
+    for (lba = APP_BENCH_LBA; lba < (APP_BENCH_LBA + APP_SEQ_BLOCKS); lba += blocks)
+    {
+      latency = APP_Transfer(Write, lba, blocks);
+      if (latency == APP_XFER_ERROR)
+      {
+        printf("  %2lux      err", blocks);
+        total = 0U;
+        break;
+      }
+      if (Write != 0U)
+      {
+        APP_Record(lba, blocks, latency);
+      }
+      total += latency;
+    }
+    if (total != 0U)
+    {
+      printf("  %2lux %6lu KB/s", blocks,
+             (uint32_t)((((uint64_t)APP_SEQ_BLOCKS * BLOCKSIZE * 1000000U) / 1024U) / total));
+    }
+  }
+  printf("\r\n");
+}
+
+/**
+  * @brief  Read or write 4 Kbyte blocks at random places of the area.
+  * @param  Write 1 to write, 0 to read.
+  */
+static void APP_BenchRandom(uint32_t Write)
+{
+  uint32_t latency;
+  uint32_t total = 0U;
+  uint32_t worst = 0U;
+  uint32_t lba;
+  uint32_t i;
+
+  for (i = 0U; i < APP_RAND_OPS; i++)
+  {
+    lba = APP_BENCH_LBA + ((APP_Random() % (APP_BENCH_SPAN / APP_RAND_BLOCKS)) * APP_RAND_BLOCKS);
+    latency = APP_Transfer(Write, lba, APP_RAND_BLOCKS);
+    if (latency == APP_XFER_ERROR)
+    {
+      printf("  rand %s  err at %lu\r\n", (Write != 0U) ? "write" : "read ", lba);
+      return;
+    }
+    if (Write != 0U)
+    {
+      APP_Record(lba, APP_RAND_BLOCKS, latency);
+    }
+    if (latency > worst)
+    {
+      worst = latency;
+    }
+    total += latency;
+  }
+
+  printf("  rand %s  %6lu IOPS, worst %lu us\r\n", (Write != 0U) ? "write" : "read ",
+         (uint32_t)(((uint64_t)APP_RAND_OPS * 1000000U) / total), worst);
+}
+
+/**
+  * @brief  Print the write latency bins and the outliers of the setting.
+  */
+static void APP_PrintLatency(void)
+{
+  const APP_OutlierTypeDef *outlier;
+  uint32_t i;
+
+  printf("  lat  ");
+  for (i = 0U; i < APP_BINS; i++)
+  {
+    printf(" %5lu", WriteLatency.Bins[i]);
+  }
+  printf("  of %lu writes\r\n", WriteLatency.Count);
+
+  printf("  outliers\r\n");
+  for (i = 0U; i < APP_OUTLIERS; i++)
+  {
+    outlier = &WriteLatency.Outliers[i];
+    if (outlier->Latency != 0U)
+    {
+      printf("    %7lu us  lba %lu x%lu\r\n", outlier->Latency, outlier->Lba, outlier->Blocks);
+    }
+  }
+}
+
+/**
+  * @brief  Add a write to the bins, keep it when among the slowest.
+  * @param  Lba     First block.
+  * @param  Blocks  Number of blocks.
+  * @param  Latency us.
+  */
+static void APP_Record(uint32_t Lba, uint32_t Blocks, uint32_t Latency)
+{
+  APP_OutlierTypeDef *outliers = WriteLatency.Outliers;
+  uint32_t bin = 0U;
+  uint32_t i;
+
+  while ((bin < (APP_BINS - 1U)) && (Latency > aBinLimit[bin]))
+  {
+    bin++;
+  }
+  WriteLatency.Bins[bin]++;
+  WriteLatency.Count++;
+
+  /* Sorted slowest first, the last one dropped */
+  if (Latency <= outliers[APP_OUTLIERS - 1U].Latency)
+  {
+    return;
+  }
+  for (i = APP_OUTLIERS - 1U; (i > 0U) && (outliers[i - 1U].Latency < Latency); i--)
+  {
+    outliers[i] = outliers[i - 1U];
+  }
+  outliers[i].Lba     = Lba;
+  outliers[i].Blocks  = Blocks;
+  outliers[i].Latency = Latency;
+}
+
+/**
+  * @brief  Run one DMA transfer and wait for the card to be back in the transfer state.
+  * @param  Write  1 to write, 0 to read.
+  * @param  Lba    First block.
+  * @param  Blocks Number of blocks, APP_BLOCKS_MAX at most.
+  * @retval Latency in us, APP_XFER_ERROR on a failure
+  */
+static uint32_t APP_Transfer(uint32_t Write, uint32_t Lba, uint32_t Blocks)
+{
+  HAL_StatusTypeDef status;
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t start;
+
+  XferPending = 1U;
+  XferError   = 0U;
+  start = DWT->CYCCNT;
+  if (Write != 0U)
+  {
+    status = HAL_SD_WriteBlocks_DMA(&SdHandle, (uint8_t *)aBuffer, Lba, Blocks);
+  }
+  else
+  {
+    status = HAL_SD_ReadBlocks_DMA(&SdHandle, (uint8_t *)aBuffer, Lba, Blocks);
+  }
+  if (status != HAL_OK)
+  {
+    return APP_XFER_ERROR;
+  }
+
+  while (XferPending != 0U)
+  {
+    if ((HAL_GetTick() - tickstart) >= APP_TIMEOUT)
+    {
+      (void)HAL_SD_Abort(&SdHandle);
+      return APP_XFER_ERROR;
+    }
+  }
+  /* The card programs the written blocks after the transfer */
+  while (HAL_SD_GetCardState(&SdHandle) != HAL_SD_CARD_TRANSFER)
+  {
+    if ((HAL_GetTick() - tickstart) >= APP_TIMEOUT)
+    {
+      return APP_XFER_ERROR;
+    }
+  }
+
+  return (XferError != 0U) ? APP_XFER_ERROR : ((DWT->CYCCNT - start) / CyclesPerUs);
+}
+
+/**
+  * @brief  Linear congruential generator, the same sequence for each setting.
+  * @retval Pseudo random number
+  */
+static uint32_t APP_Random(void)
+{
+  RandSeed = (RandSeed * 1664525U) + 1013904223U;
+  return RandSeed >> 8;
+}
+
+void HAL_SD_RxCpltCallback(SD_HandleTypeDef *hsd)
+{
+  XferPending = 0U;
+}
+
+void HAL_SD_TxCpltCallback(SD_HandleTypeDef *hsd)
+{
+  XferPending = 0U;
+}
+
+void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd)
+{
+  XferError   = 1U;
+  XferPending = 0U;
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  CyclesPerUs = HAL_RCC_GetHCLKFreq() / 1000000U;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SdConfig(void)
+{
+  SdHandle.Instance                      = SDIO;
+  SdHandle.Init.ClockSel                 = SDIO_CLOCK_OFFSET_90C;
+  SdHandle.Init.ClockPowerSave           = SDIO_CLOCK_POWER_SAVE_DISABLE;
+  SdHandle.Init.BusWide                  = SDIO_BUS_WIDE_1B;
+  SdHandle.Init.PreSampling              = SDIO_PRE_SAMPLING_DISABLE;
+  SdHandle.Init.PreSamplingClockSel      = SDIO_PRE_SAMPLING_CLOCK_OFFSET_NONE;
+  SdHandle.Init.ClockDiv                 = SDIO_TRANSFER_CLK_DIV;
+  if (HAL_SD_Init(&SdHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE |
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_ON;                               /* Enable PLL */
+  OscInitstruct.PLL.PLLSource   = RCC_PLLSOURCE_HSI;                        /* PLL clock source: HSI */
+  OscInitstruct.PLL.PLLMUL      = RCC_PLL_MUL16;                            /* PLL multiplication factor: 16 */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_PLLCLK;              /* SYSCLK source select as PLL */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB2 clock divided by 2 */
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_msp.c
+  * @author  MCU Application Team
+  * @brief   This file provides code for the MSP Initialization
+  *          and de-Initialization codes.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2023 Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by Puya under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef HdmaSdRx;
+static DMA_HandleTypeDef HdmaSdTx;
+
+/* Private function prototypes -----------------------------------------------*/
+/* External functions --------------------------------------------------------*/
+
+/**
+  * @brief Initialize global MSP
+  */
+void HAL_MspInit(void)
+{
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  __HAL_RCC_PWR_CLK_ENABLE();
+}
+
+/**
+  * @brief Initialize one word wide normal mode DMA channel on the SDIO request
+  */
+static void APP_DmaConfig(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *Channel, uint32_t Direction,
+                          IRQn_Type IRQn)
+{
+  hdma->Instance                 = Channel;
+  hdma->Init.Direction           = Direction;
+  hdma->Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma->Init.MemInc              = DMA_MINC_ENABLE;
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+  hdma->Init.Mode                = DMA_NORMAL;
+  hdma->Init.Priority            = DMA_PRIORITY_VERY_HIGH;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  HAL_DMA_ChannelMap(hdma, DMA_CHANNEL_MAP_SDIO);
+
+  HAL_NVIC_SetPriority(IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(IRQn);
+}
+
+/**
+  * @brief Initialize UART MSP, PA9 USART1 TX
+  */
+void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_USART1_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin = GPIO_PIN_9;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF2_USART1;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+/**
+  * @brief Initialize SD MSP, PC8-PC11 D0-D3, PC12 CK, PD2 CMD, DMA1 channel 1 and 2
+  */
+void HAL_SD_MspInit(SD_HandleTypeDef *hsd)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  __HAL_RCC_GPIOD_CLK_ENABLE();
+  __HAL_RCC_SDIO_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF11_SDIO;
+  GPIO_InitStruct.Pin = GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12;
+  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+  GPIO_InitStruct.Pin = GPIO_PIN_2;
+  HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
+
+  APP_DmaConfig(&HdmaSdRx, DMA1_Channel1, DMA_PERIPH_TO_MEMORY, DMA1_Channel1_IRQn);
+  __HAL_LINKDMA(hsd, hdmarx, HdmaSdRx);
+  APP_DmaConfig(&HdmaSdTx, DMA1_Channel2, DMA_MEMORY_TO_PERIPH, DMA1_Channel2_IRQn);
+  __HAL_LINKDMA(hsd, hdmatx, HdmaSdTx);
+
+  HAL_NVIC_SetPriority(SDIO_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(SDIO_IRQn);
+}
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
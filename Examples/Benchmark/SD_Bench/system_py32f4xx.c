@@ -0,0 +1,392 @@
+/**
+  ******************************************************************************
+  * @file    system_py32f4xx.c
+  * @author  MCU Application Team
+  * @brief   CMSIS Cortex-M4 Device Peripheral Access Layer System Source File
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2023 Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by Puya under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/** @addtogroup CMSIS
+  * @{
+  */
+
+/** @addtogroup py32f4xx_system
+  * @{
+  */  
+  
+/** @addtogroup py32f4xx_System_Private_Includes
+  * @{
+  */
+
+#include "py32f4xx.h"
+#if defined (DATA_IN_ExtFlash)
+#include "py32f4xx_hal.h"
+#if !defined (HAL_ESMC_MODULE_ENABLED)
+  #error "DATA_IN_ExtFlash requires HAL_ESMC_MODULE_ENABLED in py32f4xx_hal_conf.h"
+#endif /* HAL_ESMC_MODULE_ENABLED */
+#endif /* DATA_IN_ExtFlash */
+
+#if !defined  (HSE_VALUE) 
+  #define HSE_VALUE    ((uint32_t)24000000) /*!< Default value of the External oscillator in Hz */
+#endif /* HSE_VALUE */
+
+#if !defined  (HSI_VALUE)
+  #define HSI_VALUE    ((uint32_t)8000000) /*!< Value of the Internal oscillator in Hz*/
+#endif /* HSI_VALUE */
+
+/**
+  * @}
+  */
+
+/*!< Uncomment the following line if you need to relocate your vector Table in
+     Internal SRAM. */
+/* #define VECT_TAB_SRAM */
+#if !defined (VECT_TAB_OFFSET)
+#define VECT_TAB_OFFSET  0x00 /*!< Vector Table base offset field. 
+                                   This value must be a multiple of 0x200,
+                                   set by FW_SLOT for the A/B slots. */
+#endif /* VECT_TAB_OFFSET */
+
+/*!< Uncomment the following line, or build with USE_EXTFLASH=y, to map the
+     external flash connected to the ESMC before main(). The code and constant
+     data of the .extflash section (__EXTFLASH_FUNC, __EXTFLASH_CONST) are then
+     usable from the constructors on. HAL_ESMC_MspInit() enables the ESMC clock
+     and configures its pins, without SysTick. */
+/* #define DATA_IN_ExtFlash */
+#if defined (DATA_IN_ExtFlash)
+#if !defined (EXTFLASH_PRESET)
+  #define EXTFLASH_PRESET        ESMCEX_XIP_QUAD_IO   /*!< Fast read command, a value of @ref ESMCEx_XIP_Preset */
+#endif /* EXTFLASH_PRESET */
+#if !defined (EXTFLASH_ADDRESS_SIZE)
+  #define EXTFLASH_ADDRESS_SIZE  ESMC_ADDRESS_24_BITS /*!< Flash address size */
+#endif /* EXTFLASH_ADDRESS_SIZE */
+#if !defined (EXTFLASH_CS_PIN)
+  #define EXTFLASH_CS_PIN        ESMC_SELECT_PIN_CS0  /*!< Chip select of the flash */
+#endif /* EXTFLASH_CS_PIN */
+#if !defined (EXTFLASH_PRESCALER)
+  #define EXTFLASH_PRESCALER     4U                   /*!< SCK = HCLK / EXTFLASH_PRESCALER, choose it for the
+                                                           HCLK set in main() */
+#endif /* EXTFLASH_PRESCALER */
+#endif /* DATA_IN_ExtFlash */
+
+/*!< Build with USE_FLASH_RAMFUNC=y to run the FLASH program and erase functions
+     (__FLASH_RAM_FUNC) from RAM. The vector table is then copied to RAM too, so
+     that the interrupts marked __RAM_FUNC are taken during a program or an
+     erase without a fetch from the FLASH. */
+#if defined (USE_FLASH_RAMFUNC)
+#define VECT_TAB_RAM_WORDS     128U   /*!< RAM vector table, 512 bytes for the VTOR alignment */
+#endif /* USE_FLASH_RAMFUNC */
+
+/*!< Build with USE_FAST_BOOT=y to leave the reset clock before the copy of
+     .data and the zeroing of .bss: SystemEarlyInit(), called by the startup
+     first, sets SYSCLK to the PLL on HSI x FAST_BOOT_PLLMUL and starts the DWT
+     cycle counter from 0 for the boot timeline, see py32f4xx_bsp_boottrace.h.
+     main() then keeps this clock, HAL_RCC_OscConfig() cannot turn off the
+     PLL used as system clock. */
+#if defined (USE_FAST_BOOT)
+#if !defined (FAST_BOOT_PLLMUL)
+  #define FAST_BOOT_PLLMUL       RCC_CFGR_PLLMULL16   /*!< SYSCLK = HSI x 16 = 128 MHz */
+#endif /* FAST_BOOT_PLLMUL */
+#if !defined (FAST_BOOT_LATENCY)
+  #define FAST_BOOT_LATENCY      5U                   /*!< FLASH wait states at this SYSCLK, as
+                                                           HAL_RCC_GetFlashLatency() */
+#endif /* FAST_BOOT_LATENCY */
+#define FAST_BOOT_TIMEOUT        0x10000U             /*!< Polling loops for the PLL lock and the switch,
+                                                           there is no tick yet */
+#endif /* USE_FAST_BOOT */
+/******************************************************************************/
+
+
+/** @addtogroup PY32F4xx_System_Private_Variables
+  * @{
+  */
+  /* This variable is updated in three ways:
+      1) by calling CMSIS function SystemCoreClockUpdate()
+      2) by calling HAL API function HAL_RCC_GetHCLKFreq()
+      3) each time HAL_RCC_ClockConfig() is called to configure the system clock frequency 
+         Note: If you use this function to configure the system clock; then there
+               is no need to call the 2 first functions listed above, since SystemCoreClock
+               variable is updated automatically.
+  */
+uint32_t SystemCoreClock = HSI_VALUE;
+const uint8_t AHBPrescTable[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9};
+const uint8_t APBPrescTable[8]  = {0, 0, 0, 0, 1, 2, 3, 4};
+#if defined (DATA_IN_ExtFlash)
+ESMC_HandleTypeDef ExtFlashHandle;  /* Handle of the mapped flash, for HAL_ESMCEx_DisableXIP() */
+#endif /* DATA_IN_ExtFlash */
+#if defined (USE_FLASH_RAMFUNC)
+extern const uint32_t _sisr_vector[];  /* Vector table in the FLASH, from the linker script */
+extern const uint32_t _eisr_vector[];
+static uint32_t RamVectors[VECT_TAB_RAM_WORDS] __ALIGNED(0x200);
+#endif /* USE_FLASH_RAMFUNC */
+/**
+  * @}
+  */
+
+/** @addtogroup PY32F4xx_System_Private_FunctionPrototypes
+  * @{
+  */
+#if defined (DATA_IN_ExtFlash)
+static void SystemInit_ExtMemCtl(void);
+#endif /* DATA_IN_ExtFlash */
+#if defined (USE_FLASH_RAMFUNC)
+static void SystemInit_RamVectors(void);
+#endif /* USE_FLASH_RAMFUNC */
+/**
+  * @}
+  */
+
+/** @addtogroup PY32F4xx_System_Private_Functions
+  * @{
+  */
+
+#if defined (USE_FAST_BOOT)
+/**
+  * @brief  Switch to the PLL before the C runtime initialization.
+  * @note   Called by the startup before the .data copy and the .bss zeroing:
+  *         no initialized or zeroed variable may be used here. On a timeout
+  *         SYSCLK stays on HSI.
+  * @param  None
+  * @retval None
+  */
+void SystemEarlyInit(void)
+{
+  uint32_t timeout;
+
+  /* Boot timeline, in core cycles from here */
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  /* Wait states first, the FLASH is read at the new clock from the switch on */
+  MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FAST_BOOT_LATENCY << FLASH_ACR_LATENCY_Pos);
+
+  /* PLL on HSI, APB2 = HCLK / 2 as in the clock examples */
+  MODIFY_REG(RCC->CFGR, RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE | RCC_CFGR_PLLMULL | RCC_CFGR_PPRE2,
+             FAST_BOOT_PLLMUL | RCC_CFGR_PPRE2_2);
+  SET_BIT(RCC->CR, RCC_CR_PLLON);
+  for (timeout = FAST_BOOT_TIMEOUT; READ_BIT(RCC->CR, RCC_CR_PLLRDY) == 0U; timeout--)
+  {
+    if (timeout == 0U)
+    {
+      return;
+    }
+  }
+
+  MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+  for (timeout = FAST_BOOT_TIMEOUT; READ_BIT(RCC->CFGR, RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL; timeout--)
+  {
+    if (timeout == 0U)
+    {
+      return;
+    }
+  }
+}
+#endif /* USE_FAST_BOOT */
+
+/**
+  * @brief  Setup the microcontroller system
+  *         Initialize the FPU setting, vector table location and External memory 
+  *         configuration.
+  * @param  None
+  * @retval None
+  */
+void SystemInit(void)
+{
+#if (__FPU_PRESENT == 1) && (__FPU_USED == 1)
+  SCB->CPACR |= ((3UL << 10*2)|(3UL << 11*2));  /* set CP10 and CP11 Full Access */
+#endif
+
+#if defined (USE_FAST_BOOT)
+  /* SystemCoreClock was set again by the .data copy */
+  SystemCoreClockUpdate();
+#endif /* USE_FAST_BOOT */
+  
+  /* Configure the Vector Table location add offset address ------------------*/
+#ifdef VECT_TAB_SRAM
+  SCB->VTOR = SRAM_BASE | VECT_TAB_OFFSET; /* Vector Table Relocation in Internal SRAM */
+#else
+  SCB->VTOR = FLASH_BASE | VECT_TAB_OFFSET; /* Vector Table Relocation in Internal FLASH */
+#endif
+
+#if defined (USE_FLASH_RAMFUNC)
+  SystemInit_RamVectors();
+#endif /* USE_FLASH_RAMFUNC */
+
+#if defined (DATA_IN_ExtFlash)
+  SystemInit_ExtMemCtl();
+#endif /* DATA_IN_ExtFlash */
+}
+
+/**
+   * @brief  Update SystemCoreClock variable according to Clock Register Values.
+  *         The SystemCoreClock variable contains the core clock (HCLK), it can
+  *         be used by the user application to setup the SysTick timer or configure
+  *         other parameters.
+  *           
+  * @note   Each time the core clock (HCLK) changes, this function must be called
+  *         to update SystemCoreClock variable value. Otherwise, any configuration
+  *         based on this variable will be incorrect.         
+  *     
+  * @note   - The system frequency computed by this function is not the real 
+  *           frequency in the chip. It is calculated based on the predefined 
+  *           constant and the selected clock source:
+  *             
+  *           - If SYSCLK source is HSI, SystemCoreClock will contain the HSI_VALUE(*)
+  *                                              
+  *           - If SYSCLK source is HSE, SystemCoreClock will contain the HSE_VALUE(**)
+  *                          
+  *           - If SYSCLK source is PLL, SystemCoreClock will contain the HSE_VALUE(**) 
+  *             or HSI_VALUE(*) multiplied/divided by the PLL factors.
+  *         
+  *         (*) HSI_VALUE is a constant defined in PY32F4XX_hal_conf.h file (default value
+  *             8 MHz) but the real value may vary depending on the variations
+  *             in voltage and temperature.   
+  *    
+  *         (**) HSE_VALUE is a constant defined in PY32F4XX_hal_conf.h file (its value
+  *              depends on the application requirements), user has to ensure that HSE_VALUE
+  *              is same as the real frequency of the crystal used. Otherwise, this function
+  *              may have wrong result.
+  *                
+  *         - The result of this function could be not correct when using fractional
+  *           value for HSE crystal.
+  *     
+  * @param  None
+  * @retval None
+  */
+void SystemCoreClockUpdate(void)
+{
+  const uint8_t aPLLMULFactorTable[64] = {2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, \
+                                          18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, \
+                                          34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, \
+                                          50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 63, 63};
+  const uint8_t aPredivFactorTable[2] = {1, 2};
+  
+  uint32_t tmpreg = 0U, prediv = 0U, pllclk = 0U, pllmul = 0U;
+  uint32_t tmp = 0;
+  
+  tmpreg = RCC->CFGR;
+  /* Get SYSCLK source -------------------------------------------------------*/
+  switch (tmpreg & RCC_CFGR_SWS)
+  {
+    case 0x00:  /* HSI used as system clock source */
+    {
+      SystemCoreClock = HSI_VALUE;
+      break;
+    }
+    
+    case 0x04:  /* HSE used as system clock */
+    {
+      SystemCoreClock = HSE_VALUE;
+      break;
+    }
+    
+    case 0x08:  /* PLL used as system clock */
+    {
+      pllmul = aPLLMULFactorTable[(((tmpreg&(RCC_CFGR_PLLMULL_4|RCC_CFGR_PLLMULL_5))>>7) | (tmpreg&(RCC_CFGR_PLLMULL_0| \
+                                     RCC_CFGR_PLLMULL_1|RCC_CFGR_PLLMULL_2|RCC_CFGR_PLLMULL_3)))>>RCC_CFGR_PLLMULL_Pos];
+      if ((tmpreg & RCC_CFGR_PLLSRC) == RCC_CFGR_PLLSRC)
+      {
+        prediv = aPredivFactorTable[(uint32_t)(RCC->CFGR & RCC_CFGR_PLLXTPRE) >> RCC_CFGR_PLLXTPRE_Pos];
+        /* HSE used as PLL clock source : PLLCLK = HSE/PREDIV1 * PLLMUL */
+        pllclk = (uint32_t)((HSE_VALUE  * pllmul) / prediv);
+      }
+      else
+      {
+        /* HSI used as PLL clock source : PLLCLK = HSI * PLLMUL */
+        pllclk = (uint32_t)(HSI_VALUE * pllmul);
+      }
+      SystemCoreClock = pllclk;
+      break;
+    }
+    
+    default:
+    {      
+      break;
+    } 
+  }
+
+    /* Get HCLK prescaler */
+    tmp = AHBPrescTable[((RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos)];
+    SystemCoreClock >>= tmp;
+}
+
+#if defined (USE_FLASH_RAMFUNC)
+/**
+  * @brief  Copy the vector table to RAM and relocate it there.
+  * @note   The handlers keep their addresses: only those marked __RAM_FUNC
+  *         run while the FLASH is programmed or erased.
+  * @param  None
+  * @retval None
+  */
+static void SystemInit_RamVectors(void)
+{
+  uint32_t count = (uint32_t)(_eisr_vector - _sisr_vector);
+  uint32_t i;
+
+  if (count > VECT_TAB_RAM_WORDS)
+  {
+    count = VECT_TAB_RAM_WORDS;
+  }
+  for (i = 0U; i < count; i++)
+  {
+    RamVectors[i] = _sisr_vector[i];
+  }
+
+  __DSB();
+  SCB->VTOR = (uint32_t)RamVectors;
+  __DSB();
+}
+#endif /* USE_FLASH_RAMFUNC */
+
+#if defined (DATA_IN_ExtFlash)
+/**
+  * @brief  Map the external flash in the ESMC window before main().
+  * @note   Runs before HAL_Init() on the reset clock. A failure stops here,
+  *         the code of the .extflash section being unreachable.
+  * @param  None
+  * @retval None
+  */
+static void SystemInit_ExtMemCtl(void)
+{
+  ExtFlashHandle.Instance            = ESMC;
+  ExtFlashHandle.Init.ClockPrescaler = EXTFLASH_PRESCALER;
+  ExtFlashHandle.Init.ClockMode      = ESMC_CLOCK_MODE_0;
+  ExtFlashHandle.Init.DualFlash      = ESMC_DUALFLASH_DISABLE;
+
+  if (HAL_ESMCEx_EnableXIP(&ExtFlashHandle, EXTFLASH_PRESET, EXTFLASH_ADDRESS_SIZE, EXTFLASH_CS_PIN) != HAL_OK)
+  {
+    while (1)
+    {
+    }
+  }
+}
+#endif /* DATA_IN_ExtFlash */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
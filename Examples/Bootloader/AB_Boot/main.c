@@ -0,0 +1,74 @@
+#include "main.h"
+#include "py32f4xx_bsp_fwupdate.h"
+
+/*
+ * A/B bootloader, built with FW_SLOT=boot USE_BSP=y, runs from the first
+ * 16 Kbytes of the flash on the reset clock.
+ *
+ * The slot with a valid trailer, a matching CRC and the highest version is
+ * started, see py32f4xx_bsp_fwupdate.c. The applications are built with
+ * FW_SLOT=a or FW_SLOT=b and update the other slot in the field: the new
+ * image is taken here on the next reset, the previous one stays in its slot
+ * as a fallback. Without a valid slot PA1 blinks.
+ */
+
+static CRC_HandleTypeDef CrcHandle;
+
+static void APP_GpioConfig(void);
+
+
+int main(void)
+{
+  uint32_t slot;
+
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  CrcHandle.Instance = CRC;
+  if (HAL_CRC_Init(&CrcHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+
+  slot = BSP_FWUPDATE_SelectSlot(&CrcHandle);
+  if (slot != BSP_FWUPDATE_SLOT_NONE)
+  {
+    /* Leave the peripherals as after reset to the application */
+    HAL_CRC_DeInit(&CrcHandle);
+    HAL_DeInit();
+    BSP_FWUPDATE_Jump(slot);
+  }
+
+  APP_GpioConfig();
+  while (1)
+  {
+    HAL_Delay(100);
+    HAL_GPIO_TogglePin(GPIOA, GPIO_PIN_1);
+  }
+}
+
+static void APP_GpioConfig(void)
+{
+  GPIO_InitTypeDef  GPIO_InitStruct;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();                          /* Enable GPIOA clock */
+
+  GPIO_InitStruct.Pin = GPIO_PIN_1;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;            /* Push-pull output */
+  GPIO_InitStruct.Pull = GPIO_PULLUP;                    /* Enable pull-up */
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;          /* GPIO speed */
+  /* GPIO Initialization */
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
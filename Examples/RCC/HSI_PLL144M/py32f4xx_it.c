@@ -1,6 +1,10 @@
 #include "main.h"
 #include "py32f4xx_it.h"
 
+#if defined (USE_BSP_RTOS)
+#include "py32f4xx_bsp_rtos.h"
+#endif
+
 /******************************************************************************/
 /*          Cortex-M4 Processor Interruption and Exception Handlers           */
 /******************************************************************************/
@@ -13,6 +17,7 @@ void NMI_Handler(void)
 {
 }
 
+#if !defined (USE_BSP_FAULT)
 /**
   * @brief  This function handles Hard Fault exception.
   * @param  None
@@ -64,6 +69,7 @@ void UsageFault_Handler(void)
   {
   }
 }
+#endif /* USE_BSP_FAULT */
 
 /**
   * @brief  This function handles SVCall exception.
@@ -74,23 +80,29 @@ void SVC_Handler(void)
 {
 }
 
+#if !defined (USE_BSP_GUARD)
 /**
   * @brief  This function handles Debug Monitor exception.
+  * @note   With USE_BSP_GUARD, the one of py32f4xx_bsp_guard.c reports the memory guard hits.
   * @param  None
   * @retval None
   */
 void DebugMon_Handler(void)
 {
 }
+#endif /* USE_BSP_GUARD */
 
+#if !defined (USE_BSP_RTOS)
 /**
   * @brief  This function handles PendSVC exception.
+  * @note   With USE_BSP_RTOS, the one of py32f4xx_bsp_rtos.c switches the threads.
   * @param  None
   * @retval None
   */
 void PendSV_Handler(void)
 {
 }
+#endif /* USE_BSP_RTOS */
 
 /**
   * @brief  This function handles SysTick Handler.
@@ -99,5 +111,9 @@ void PendSV_Handler(void)
   */
 void SysTick_Handler(void)
 {
+#if defined (USE_BSP_RTOS)
+  BSP_RTOS_TickHandler();
+#else
   HAL_IncTick();
+#endif
 }
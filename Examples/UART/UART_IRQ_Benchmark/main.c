@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include "main.h"
+
+/* Bytes received per run, the last one goes through the generic path */
+#define APP_BENCH_SIZE      256U
+
+UART_HandleTypeDef UartHandle;
+
+static uint8_t aTxBuffer[APP_BENCH_SIZE];
+static uint8_t aRxBuffer[APP_BENCH_SIZE];
+
+static __IO uint32_t BenchCount;
+static __IO uint32_t BenchTotal;
+static __IO uint32_t BenchMin;
+static __IO uint32_t BenchMax;
+
+/* Set by the reception complete callback, built with USE_BSP=y */
+#define APP_EVENT_RX_DONE   0x01U
+static BSP_SYNC_EventTypeDef RxEvent;
+
+static void APP_SystemClockConfig(void);
+static void APP_UartConfig(void);
+static void APP_CycleCounterConfig(void);
+static void APP_BenchRun(void);
+
+
+int main(void)
+{
+  /* Reset of all peripherals, Initializes the Systick */
+  HAL_Init();
+
+  APP_SystemClockConfig();
+  APP_CycleCounterConfig();
+  APP_UartConfig();
+
+  while (1)
+  {
+    APP_BenchRun();
+    HAL_Delay(1000);
+  }
+}
+
+/**
+  * @brief  Record the cycles spent in one HAL_UART_IRQHandler() call.
+  * @param  Cycles DWT cycle count of the call.
+  */
+void APP_BenchRecord(uint32_t Cycles)
+{
+  BenchCount++;
+  BenchTotal += Cycles;
+  if (Cycles < BenchMin)
+  {
+    BenchMin = Cycles;
+  }
+  if (Cycles > BenchMax)
+  {
+    BenchMax = Cycles;
+  }
+}
+
+/**
+  * @brief  Send APP_BENCH_SIZE bytes to the receiver of the same UART and print
+  *         the cycles spent per received byte in the interrupt handler.
+  *         Build once with USE_HAL_UART_FAST_IRQ at 1U and once at 0U in
+  *         py32f4xx_hal_conf.h to compare the two paths.
+  */
+static void APP_BenchRun(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < APP_BENCH_SIZE; i++)
+  {
+    aTxBuffer[i] = (uint8_t)i;
+  }
+
+  BenchCount = 0U;
+  BenchTotal = 0U;
+  BenchMin = 0xFFFFFFFFU;
+  BenchMax = 0U;
+
+  /* Drop the echo of the previous printf() */
+  __HAL_UART_CLEAR_OREFLAG(&UartHandle);
+
+  if (HAL_UART_Receive_IT(&UartHandle, aRxBuffer, APP_BENCH_SIZE) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  /* Half-duplex: every byte sent is received back by the UART */
+  if (HAL_UART_Transmit(&UartHandle, aTxBuffer, APP_BENCH_SIZE, 1000U) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  if (BSP_SYNC_EventWait(&RxEvent, APP_EVENT_RX_DONE, BSP_SYNC_WAIT_ANY, 1000U) == 0U)
+  {
+    APP_ErrorHandler();
+  }
+
+  printf("UART IRQ fast path %s: %lu IRQs, cycles min %lu avg %lu max %lu\r\n",
+         (USE_HAL_UART_FAST_IRQ == 1U) ? "on" : "off",
+         BenchCount, BenchMin, BenchTotal / BenchCount, BenchMax);
+  /* Same figures for Misc/Tools/benchreport.py, the average as the median */
+  printf("BENCH_START hclk=%lu\r\nBENCH uart_irq %lu %lu %lu %lu\r\nBENCH_END 1\r\n",
+         HAL_RCC_GetHCLKFreq(), (uint32_t)USE_HAL_UART_FAST_IRQ,
+         BenchMin, BenchTotal / BenchCount, BenchMax);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  BSP_SYNC_EventSet(&RxEvent, APP_EVENT_RX_DONE);
+}
+
+static void APP_CycleCounterConfig(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void APP_UartConfig(void)
+{
+  UartHandle.Instance          = USART1;
+  UartHandle.Init.BaudRate     = 115200;
+  UartHandle.Init.WordLength   = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits     = UART_STOPBITS_1;
+  UartHandle.Init.Parity       = UART_PARITY_NONE;
+  UartHandle.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode         = UART_MODE_TX_RX;
+  UartHandle.Init.OverSampling = UART_OVERSAMPLING_16;
+  /* The transmitter output is looped back to the receiver, no wiring needed */
+  if (HAL_HalfDuplex_Init(&UartHandle) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+int __io_putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  HAL_UART_Transmit(&UartHandle, &c, 1U, 1000U);
+  return ch;
+}
+
+static void APP_SystemClockConfig(void)
+{
+  RCC_OscInitTypeDef  OscInitstruct = {0};
+  RCC_ClkInitTypeDef  ClkInitstruct = {0};
+  
+  OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE | 
+                                  RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
+  OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
+  OscInitstruct.HSI48MState     = RCC_HSI48M_OFF;                           /* Disable HSI48M */
+  OscInitstruct.HSIState        = RCC_HSI_ON;                               /* Enable HSI */
+  OscInitstruct.LSEState        = RCC_LSE_OFF;                              /* Disable LSE */
+  OscInitstruct.LSIState        = RCC_LSI_OFF;                              /* Disable LSI */
+  OscInitstruct.PLL.PLLState    = RCC_PLL_OFF;                              /* Disable PLL */
+  /* Configure Oscillators */
+  if(HAL_RCC_OscConfig(&OscInitstruct) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+  
+  ClkInitstruct.ClockType       = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  ClkInitstruct.SYSCLKSource    = RCC_SYSCLKSOURCE_HSI;                 /* System clock source: HSI */
+  ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
+  ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV1;                        /* APB1 clock not divided */
+  ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
+  /* Configure Clocks */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_0) != HAL_OK)
+  {
+    APP_ErrorHandler();
+  }
+}
+
+void APP_ErrorHandler(void)
+{
+  while (1);
+}
+
+#ifdef  USE_FULL_ASSERT
+void assert_failed(uint8_t *file, uint32_t line)
+{
+  while (1);
+}
+#endif /* USE_FULL_ASSERT */
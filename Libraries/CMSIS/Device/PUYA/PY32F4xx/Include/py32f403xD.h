@@ -7342,6 +7342,7 @@ unlock the write access to the option byte block */
 #define IS_ADC_MULTIMODE_MASTER_INSTANCE(INSTANCE) ((INSTANCE) == ADC1)
 
 #define IS_ADC_DMA_CAPABILITY_INSTANCE(INSTANCE) (((INSTANCE) == ADC1) || \
+                                                  ((INSTANCE) == ADC2) || \
                                                   ((INSTANCE) == ADC3))
 
 /****************************** CANFD Instances *******************************/
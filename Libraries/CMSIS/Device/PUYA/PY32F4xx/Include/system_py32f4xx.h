@@ -94,6 +94,10 @@ extern const uint8_t  APBPrescTable[8];     /*!< APB prescalers table values */
   
 extern void SystemInit(void);
 extern void SystemCoreClockUpdate(void);
+#if defined (USE_FAST_BOOT)
+extern void SystemEarlyInit(void);
+#endif /* USE_FAST_BOOT */
+extern void *SystemDataDecode(void *pDst, const uint8_t *pBlock, const uint8_t *pEnd);
 /**
   * @}
   */
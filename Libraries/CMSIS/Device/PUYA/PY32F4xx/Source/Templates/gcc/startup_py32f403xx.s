@@ -52,6 +52,10 @@ defined in linker script */
 .word _sdata
 /* end address for the .data section. defined in linker script */
 .word _edata
+/* start and end address of the LZ4 block of the .data section, the same
+   address when .data is copied. defined in linker script */
+.word _sdatalz
+.word _edatalz
 /* start address for the .bss section. defined in linker script */
 .word _sbss
 /* end address for the .bss section. defined in linker script */
@@ -74,36 +78,72 @@ Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
 
-/* Copy the data segment initializers from flash to SRAM */
+/* Leave the reset clock before the copy loops, see USE_FAST_BOOT */
+  bl  SystemEarlyInit
+
+/* Decode the data segment and the .RamFunc code from the LZ4 block of .datalz
+   when linked with USE_DATALZ, see SystemDataDecode below */
+  ldr r0, =_sdata
+  ldr r1, =_sdatalz
+  ldr r2, =_edatalz
+  cmp r1, r2
+  beq CopyData
+  bl  SystemDataDecode
+  b   ZeroBss
+
+/* Otherwise copy them from flash to SRAM, four words per iteration and then
+   the remaining words */
+CopyData:
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
+  subs r1, r1, r0
+  b  LoopCopyDataBlock
+
+CopyDataBlock:
+  ldmia r2!, {r3, r4, r5, r6}
+  stmia r0!, {r3, r4, r5, r6}
+
+LoopCopyDataBlock:
+  subs r1, r1, #16
+  bhs CopyDataBlock
+  adds r1, r1, #16
   b  LoopCopyDataInit
 
 CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
+  ldr r4, [r2], #4
+  str r4, [r0], #4
 
 LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
+  subs r1, r1, #4
+  bhs CopyDataInit
   
-/* Zero fill the bss segment. */
+/* Zero fill the bss segment, four words per iteration and then the remaining words */
+ZeroBss:
   ldr r2, =_sbss
   ldr r4, =_ebss
+  subs r4, r4, r2
+  movs r0, #0
+  movs r1, #0
   movs r3, #0
+  movs r5, #0
+  b LoopFillZerobssBlock
+
+FillZerobssBlock:
+  stmia r2!, {r0, r1, r3, r5}
+
+LoopFillZerobssBlock:
+  subs r4, r4, #16
+  bhs FillZerobssBlock
+  adds r4, r4, #16
   b LoopFillZerobss
 
 FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+  str  r0, [r2], #4
 
 LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+  subs r4, r4, #4
+  bhs FillZerobss
 
 /* Call the clock system intitialization function.*/
     bl  SystemInit
@@ -117,6 +157,140 @@ LoopForever:
 
 .size  Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Default early clock setup, an empty function replaced by the
+ *         SystemEarlyInit() of system_py32f4xx.c built with USE_FAST_BOOT.
+ *         It runs before the .data and .bss initialization.
+ * @param  None
+ * @retval : None
+*/
+  .section  .text.SystemEarlyInit,"ax",%progbits
+  .weak SystemEarlyInit
+  .type  SystemEarlyInit, %function
+SystemEarlyInit:
+  bx  lr
+  .size  SystemEarlyInit, .-SystemEarlyInit
+
+/**
+ * @brief  Decode an LZ4 block, the .data section from .datalz at boot.
+ *         Sequences of a token, literals, a 16-bit offset and a match, the
+ *         last one without offset and match. Literals and matches at least
+ *         4 bytes behind are copied by words, unaligned, the runs of offset 1
+ *         (zeros mostly) are filled by words. Called before the .data and
+ *         .bss initialization: stack only, no data.
+ * @param  r0 Destination.
+ * @param  r1 Block.
+ * @param  r2 End of the block.
+ * @retval r0 End of the bytes decoded
+*/
+  .section  .text.SystemDataDecode,"ax",%progbits
+  .global SystemDataDecode
+  .type  SystemDataDecode, %function
+SystemDataDecode:
+  push {r4, r5, lr}
+
+DecodeToken:
+  ldrb r3, [r1], #1
+  lsrs r12, r3, #4
+  cmp r12, #15
+  bne DecodeLiterals
+
+DecodeLiteralsLength:
+  ldrb r4, [r1], #1
+  add r12, r12, r4
+  cmp r4, #255
+  beq DecodeLiteralsLength
+
+DecodeLiterals:
+  subs r12, r12, #4
+  blo DecodeLiteralsTail
+
+DecodeLiteralsWord:
+  ldr r4, [r1], #4
+  str r4, [r0], #4
+  subs r12, r12, #4
+  bhs DecodeLiteralsWord
+
+DecodeLiteralsTail:
+  adds r12, r12, #4
+  beq DecodeOffset
+
+DecodeLiteralsByte:
+  ldrb r4, [r1], #1
+  strb r4, [r0], #1
+  subs r12, r12, #1
+  bne DecodeLiteralsByte
+
+/* The last sequence ends the block after its literals */
+DecodeOffset:
+  cmp r1, r2
+  bhs DecodeDone
+  ldrh r4, [r1], #2
+  sub r5, r0, r4
+  and r12, r3, #15
+  cmp r12, #15
+  bne DecodeMatch
+
+DecodeMatchLength:
+  ldrb r3, [r1], #1
+  add r12, r12, r3
+  cmp r3, #255
+  beq DecodeMatchLength
+
+DecodeMatch:
+  add r12, r12, #4
+  cmp r4, #4
+  blo DecodeMatchNear
+  subs r12, r12, #4
+  blo DecodeMatchTail
+
+DecodeMatchWord:
+  ldr r4, [r5], #4
+  str r4, [r0], #4
+  subs r12, r12, #4
+  bhs DecodeMatchWord
+
+DecodeMatchTail:
+  adds r12, r12, #4
+  beq DecodeToken
+
+DecodeMatchByte:
+  ldrb r4, [r5], #1
+  strb r4, [r0], #1
+  subs r12, r12, #1
+  bne DecodeMatchByte
+  b DecodeToken
+
+/* Offset 1 to 3: the word would read bytes not written yet. A run of the
+   previous byte is a fill, offsets 2 and 3 go byte by byte */
+DecodeMatchNear:
+  cmp r4, #1
+  bne DecodeMatchByte
+  ldrb r4, [r5]
+  orr r4, r4, r4, lsl #8
+  orr r4, r4, r4, lsl #16
+  subs r12, r12, #4
+  blo DecodeFillTail
+
+DecodeFillWord:
+  str r4, [r0], #4
+  subs r12, r12, #4
+  bhs DecodeFillWord
+
+DecodeFillTail:
+  adds r12, r12, #4
+  beq DecodeToken
+
+DecodeFillByte:
+  strb r4, [r0], #1
+  subs r12, r12, #1
+  bne DecodeFillByte
+  b DecodeToken
+
+DecodeDone:
+  pop {r4, r5, pc}
+  .size  SystemDataDecode, .-SystemDataDecode
+
 /**
  * @brief  This is the code that gets called when the processor receives an
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adccal.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC calibration cache BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCCAL_H
+#define __PY32F4XX_BSP_ADCCAL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_RTC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCCAL
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Exported_Constants BSP ADCCAL Exported Constants
+  * @{
+  */
+#define BSP_ADCCAL_SLOTS                42U            /*!< 16-bit backup registers, DR1 to DR42      */
+#define BSP_ADCCAL_RECORD_SLOTS         7U             /*!< Backup registers of one band record       */
+#define BSP_ADCCAL_BANDS_MAX            15U            /*!< Temperature bands of a record tag         */
+
+/** @defgroup BSP_ADCCAL_Source BSP ADCCAL Source
+  * @{
+  */
+#define BSP_ADCCAL_SOURCE_NONE          0x00000000U    /*!< Not calibrated yet                        */
+#define BSP_ADCCAL_SOURCE_FULL          0x00000001U    /*!< Full calibration, record of the band stored */
+#define BSP_ADCCAL_SOURCE_REUSED        0x00000002U    /*!< Quick calibration matching the stored record */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Exported_Types BSP ADCCAL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  ADC calibration cache configuration definition
+  */
+typedef struct
+{
+  uint32_t                FirstSlot;    /*!< First backup register of the records, 0 for RTC_BKP_DR1.
+                                             Bands x BSP_ADCCAL_RECORD_SLOTS registers follow       */
+
+  uint32_t                Bands;        /*!< Temperature bands, 1 to BSP_ADCCAL_BANDS_MAX           */
+
+  uint32_t                CalibSamplingTime; /*!< Full calibration, a value of
+                                             @ref ADC_Calibration_sampling_times                    */
+
+  uint32_t                CalibSelection; /*!< A value of @ref ADC_Calibration_Selection            */
+
+  uint32_t                MaxAge;       /*!< Warm boots a record is reused before a full calibration,
+                                             1 to 0xFFFF                                            */
+
+  uint32_t                Tolerance;    /*!< Largest difference of a calibration code between the
+                                             quick and the stored calibrations                      */
+
+} BSP_ADCCAL_InitTypeDef;
+
+/**
+  * @brief  ADC calibration cache definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC calibrated                                         */
+
+  RTC_HandleTypeDef       *hrtc;        /*!< RTC handle of the backup register accesses             */
+
+  BSP_ADCCAL_InitTypeDef  Init;         /*!< Configuration                                           */
+
+  uint32_t                Source;       /*!< Last calibration, a value of @ref BSP_ADCCAL_Source    */
+
+  uint32_t                Age;          /*!< Warm boots of the record used by the last calibration  */
+
+  uint32_t                Codes[2];     /*!< CALRR1 and CALRR2 of the last calibration              */
+
+} BSP_ADCCAL_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCCAL_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCCAL_Init(BSP_ADCCAL_TypeDef *hcal, ADC_HandleTypeDef *hadc, RTC_HandleTypeDef *hrtc,
+                                  const BSP_ADCCAL_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_ADCCAL_Calibrate(BSP_ADCCAL_TypeDef *hcal, uint32_t Band);
+HAL_StatusTypeDef BSP_ADCCAL_Invalidate(BSP_ADCCAL_TypeDef *hcal);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_RTC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCCAL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcmon.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC internal channel monitor BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCMON_H
+#define __PY32F4XX_BSP_ADCMON_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCMON
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCMON_Exported_Constants BSP ADCMON Exported Constants
+  * @{
+  */
+#define BSP_ADCMON_FILTER_SHIFT_MAX     8U             /*!< Slowest averaging, weight 1/256           */
+
+/** @defgroup BSP_ADCMON_State BSP ADCMON State
+  * @{
+  */
+#define BSP_ADCMON_STATE_RESET          0x00000000U    /*!< Not initialized                           */
+#define BSP_ADCMON_STATE_READY          0x00000001U    /*!< Injected group configured, stopped        */
+#define BSP_ADCMON_STATE_RUN            0x00000002U    /*!< Sequences converted on each trigger       */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCMON_Exported_Types BSP ADCMON Exported Types
+  * @{
+  */
+
+/**
+  * @brief  ADC internal channel monitor configuration definition
+  */
+typedef struct
+{
+  uint32_t                ExternalTrigInjecConv; /*!< Timer trigger at the monitoring rate, a value of
+                                             @ref ADC_External_trigger_source_Injected, or
+                                             ADC_INJECTED_SOFTWARE_START and BSP_ADCMON_Trigger()     */
+
+  uint32_t                SamplingTime; /*!< Both channels, a value of @ref ADC_sampling_times, long
+                                             enough for the TS_temp and TS_vrefint of the datasheet */
+
+  uint32_t                VrefIntMv;    /*!< VREFINT voltage in mV                                  */
+
+  int32_t                 TempRef;      /*!< Temperature of the reference point in 0.01 degC        */
+
+  uint32_t                TempRefUv;    /*!< Sensor voltage at TempRef in uV                        */
+
+  int32_t                 TempSlopeUv;  /*!< Sensor slope in uV/degC, negative when the voltage
+                                             falls with the temperature                             */
+
+  uint32_t                FilterShift;  /*!< Weight 2^-FilterShift of a sequence in the averages,
+                                             0 to BSP_ADCMON_FILTER_SHIFT_MAX                       */
+
+} BSP_ADCMON_InitTypeDef;
+
+/**
+  * @brief  ADC internal channel monitor definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC1, its injected group owned by the service          */
+
+  BSP_ADCMON_InitTypeDef  Init;         /*!< Configuration                                           */
+
+  uint32_t                TempAcc;      /*!< Average of the sensor codes, 2^FilterShift scaled      */
+
+  uint32_t                VrefAcc;      /*!< Average of the VREFINT codes, 2^FilterShift scaled     */
+
+  __IO uint32_t           Scale;        /*!< mV per code of the ADC, 16.16, 0 before the first
+                                             sequence                                               */
+
+  __IO uint32_t           VddaMv;       /*!< VDDA in mV                                             */
+
+  __IO int32_t            Temperature;  /*!< Temperature in 0.01 degC                               */
+
+  __IO uint32_t           Sequences;    /*!< Sequences converted since the start                    */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ADCMON_State                       */
+
+} BSP_ADCMON_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_ADCMON_Exported_Macros BSP ADCMON Exported Macros
+  * @brief    Reads of the cached results, no conversion
+  * @{
+  */
+#define BSP_ADCMON_GET_VDDA(__HANDLE__)          ((__HANDLE__)->VddaMv)
+#define BSP_ADCMON_GET_TEMPERATURE(__HANDLE__)   ((__HANDLE__)->Temperature)
+#define BSP_ADCMON_TO_MV(__HANDLE__, __CODE__)   ((((uint32_t)(__CODE__) * (__HANDLE__)->Scale) + 0x8000U) >> 16)
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCMON_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCMON_Init(BSP_ADCMON_TypeDef *hmon, ADC_HandleTypeDef *hadc,
+                                  const BSP_ADCMON_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_ADCMON_Start(BSP_ADCMON_TypeDef *hmon);
+HAL_StatusTypeDef BSP_ADCMON_Stop(BSP_ADCMON_TypeDef *hmon);
+HAL_StatusTypeDef BSP_ADCMON_Trigger(BSP_ADCMON_TypeDef *hmon);
+void              BSP_ADCMON_ToMillivolts(const BSP_ADCMON_TypeDef *hmon, const uint16_t *pSrc, uint16_t *pDst,
+                                          uint32_t Count);
+void              BSP_ADCMON_InjectedConvCpltCallback(BSP_ADCMON_TypeDef *hmon);
+void              BSP_ADCMON_UpdateCallback(BSP_ADCMON_TypeDef *hmon);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCMON_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,143 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcovs.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC oversampling BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCOVS_H
+#define __PY32F4XX_BSP_ADCOVS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCOVS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCOVS_Exported_Constants BSP ADCOVS Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_ADCOVS_Filter BSP ADCOVS Filter
+  * @{
+  */
+#define BSP_ADCOVS_FILTER_BOXCAR        1U             /*!< Sum of Ratio samples, gain Ratio          */
+#define BSP_ADCOVS_FILTER_CIC2          2U             /*!< Second order CIC, gain Ratio x Ratio      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCOVS_Exported_Types BSP ADCOVS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Oversampling engine definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC converting one channel into the DMA buffer         */
+
+  uint16_t                *pDmaBuffer;  /*!< Circular DMA buffer, word aligned                      */
+
+  uint32_t                DmaLength;    /*!< Samples in the DMA buffer, a multiple of 4             */
+
+  uint32_t                Ratio;        /*!< Input samples per output sample, even                  */
+
+  uint32_t                Shift;        /*!< Right shift of the filter output                       */
+
+  uint32_t                Filter;       /*!< A value of @ref BSP_ADCOVS_Filter                      */
+
+  uint32_t                Count;        /*!< Input samples in the current window                    */
+
+  uint32_t                Sum;          /*!< Sum of the current window                              */
+
+  uint32_t                Ramp;         /*!< Sum of the current window weighted by the sample rank  */
+
+  uint32_t                Weights;      /*!< Ranks of the next two samples, packed for __SMLAD      */
+
+  uint32_t                PrevRamp;     /*!< Ramp of the previous window, CIC2 only                 */
+
+  uint32_t                Warmup;       /*!< Windows to drop before the filter output is valid      */
+
+  uint16_t                *pRing;       /*!< Output ring storage                                    */
+
+  uint32_t                RingSize;     /*!< Output ring size in samples, a power of two            */
+
+  __IO uint32_t           Head;         /*!< Next output written by the DMA callbacks               */
+
+  __IO uint32_t           Tail;         /*!< Next output read by BSP_ADCOVS_Read()                  */
+
+  __IO uint32_t           Overruns;     /*!< Outputs dropped on a full ring                         */
+
+} BSP_ADCOVS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCOVS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCOVS_Init(BSP_ADCOVS_TypeDef *hovs, ADC_HandleTypeDef *hadc,
+                                  uint16_t *pDmaBuffer, uint32_t DmaLength,
+                                  uint32_t Ratio, uint32_t Shift, uint32_t Filter,
+                                  uint16_t *pRing, uint32_t RingSize);
+HAL_StatusTypeDef BSP_ADCOVS_Start(BSP_ADCOVS_TypeDef *hovs);
+HAL_StatusTypeDef BSP_ADCOVS_Stop(BSP_ADCOVS_TypeDef *hovs);
+uint32_t          BSP_ADCOVS_GetCount(const BSP_ADCOVS_TypeDef *hovs);
+uint32_t          BSP_ADCOVS_Read(BSP_ADCOVS_TypeDef *hovs, uint16_t *pDst, uint32_t Count);
+void              BSP_ADCOVS_ConvHalfCpltCallback(BSP_ADCOVS_TypeDef *hovs);
+void              BSP_ADCOVS_ConvCpltCallback(BSP_ADCOVS_TypeDef *hovs);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCOVS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
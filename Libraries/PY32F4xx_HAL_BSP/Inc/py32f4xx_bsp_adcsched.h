@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcsched.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC scan scheduler BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCSCHED_H
+#define __PY32F4XX_BSP_ADCSCHED_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCSCHED
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Exported_Constants BSP ADCSCHED Exported Constants
+  * @{
+  */
+#define BSP_ADCSCHED_CHANNELS_MAX       16U            /*!< Ranks of the regular sequence             */
+#define BSP_ADCSCHED_PASSES_MAX         16U            /*!< Largest Divider, passes of a schedule     */
+
+/** @defgroup BSP_ADCSCHED_State BSP ADCSCHED State
+  * @{
+  */
+#define BSP_ADCSCHED_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_ADCSCHED_STATE_READY        0x00000001U    /*!< Schedule built, scanning stopped          */
+#define BSP_ADCSCHED_STATE_RUN          0x00000002U    /*!< One pass on each trigger                  */
+#define BSP_ADCSCHED_STATE_ERROR        0x00000003U    /*!< DMA error, scanning stopped               */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Exported_Types BSP ADCSCHED Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Scheduled channel definition, configuration then ring state
+  */
+typedef struct
+{
+  uint32_t                Channel;      /*!< A value of @ref ADC_channels                           */
+
+  uint32_t                SamplingTime; /*!< A value of @ref ADC_sampling_times                     */
+
+  uint32_t                Divider;      /*!< Converted every Divider passes, a power of two from 1 to
+                                             BSP_ADCSCHED_PASSES_MAX                                */
+
+  uint16_t                *pRing;       /*!< Ring of the conversions of the channel                 */
+
+  uint32_t                RingSize;     /*!< Ring size in samples, a power of two                   */
+
+  uint32_t                Phase;        /*!< First pass converting the channel, set by the schedule */
+
+  __IO uint32_t           Head;         /*!< Next sample written by the DMA callback                */
+
+  __IO uint32_t           Tail;         /*!< Next sample read by BSP_ADCSCHED_Read()                */
+
+  __IO uint32_t           Overruns;     /*!< Samples dropped on a full ring                         */
+
+} BSP_ADCSCHED_ChannelTypeDef;
+
+/**
+  * @brief  Scan scheduler definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC in scan mode on an external trigger, its DMA owned
+                                             by the service                                         */
+
+  BSP_ADCSCHED_ChannelTypeDef *pChannels; /*!< Scheduled channels                                   */
+
+  uint32_t                NbrOfChannels; /*!< Channels, 1 to BSP_ADCSCHED_CHANNELS_MAX              */
+
+  uint32_t                Passes;       /*!< Passes of the schedule, the largest Divider            */
+
+  uint32_t                Pass;         /*!< Pass converting now                                    */
+
+  uint8_t                 Lengths[BSP_ADCSCHED_PASSES_MAX]; /*!< Conversions of each pass           */
+
+  uint8_t                 Ranks[BSP_ADCSCHED_PASSES_MAX][BSP_ADCSCHED_CHANNELS_MAX]; /*!< Channel
+                                             index of each rank of each pass                        */
+
+  uint32_t                Sequences[BSP_ADCSCHED_PASSES_MAX][3]; /*!< SQR1, SQR2 and SQR3 of each pass */
+
+  uint16_t                Buffers[2][BSP_ADCSCHED_CHANNELS_MAX]; /*!< DMA targets of the even and odd
+                                             passes since the start                                 */
+
+  __IO uint32_t           PassCount;    /*!< Passes completed since the start                       */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ADCSCHED_State                     */
+
+} BSP_ADCSCHED_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCSCHED_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCSCHED_Init(BSP_ADCSCHED_TypeDef *hsched, ADC_HandleTypeDef *hadc,
+                                    BSP_ADCSCHED_ChannelTypeDef *pChannels, uint32_t NbrOfChannels);
+HAL_StatusTypeDef BSP_ADCSCHED_Start(BSP_ADCSCHED_TypeDef *hsched);
+HAL_StatusTypeDef BSP_ADCSCHED_Stop(BSP_ADCSCHED_TypeDef *hsched);
+uint32_t          BSP_ADCSCHED_GetCount(const BSP_ADCSCHED_TypeDef *hsched, uint32_t Index);
+uint32_t          BSP_ADCSCHED_Read(BSP_ADCSCHED_TypeDef *hsched, uint32_t Index, uint16_t *pDst, uint32_t Count);
+void              BSP_ADCSCHED_PassCpltCallback(BSP_ADCSCHED_TypeDef *hsched);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCSCHED_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
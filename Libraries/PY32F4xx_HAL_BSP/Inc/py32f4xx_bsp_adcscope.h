@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcscope.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC analog watchdog event capture BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCSCOPE_H
+#define __PY32F4XX_BSP_ADCSCOPE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCSCOPE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Exported_Constants BSP ADCSCOPE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_ADCSCOPE_State BSP ADCSCOPE State
+  * @{
+  */
+#define BSP_ADCSCOPE_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_ADCSCOPE_STATE_READY        0x00000001U    /*!< Initialized, capture stopped              */
+#define BSP_ADCSCOPE_STATE_ARMED        0x00000002U    /*!< Pre-trigger ring running, watchdog armed  */
+#define BSP_ADCSCOPE_STATE_POST         0x00000003U    /*!< Triggered, post-trigger samples running   */
+#define BSP_ADCSCOPE_STATE_DONE         0x00000004U    /*!< Window captured, ADC stopped              */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Exported_Types BSP ADCSCOPE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Analog watchdog event capture definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC converting into the ring, its DMA owned by the service */
+
+  uint16_t                *pBuffer;     /*!< Ring of Length conversions                             */
+
+  uint32_t                Length;       /*!< Conversions in the ring, 2 to 0xFFFF                   */
+
+  uint32_t                PreTrigger;   /*!< Conversions kept up to the trigger                     */
+
+  uint32_t                PostTrigger;  /*!< Conversions kept after the trigger, at least 1         */
+
+  uint32_t                Start;        /*!< Ring index of the first conversion of the window       */
+
+  uint32_t                Count;        /*!< Conversions in the window, less than PreTrigger +
+                                             PostTrigger when triggered before the ring was full    */
+
+  uint32_t                Remaining;    /*!< Post-trigger conversions left after the ring end        */
+
+  __IO uint32_t           Filled;       /*!< Ring written once since the arming                     */
+
+  __IO uint32_t           Triggers;     /*!< Windows captured since the initialization              */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ADCSCOPE_State                     */
+
+} BSP_ADCSCOPE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCSCOPE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCSCOPE_Init(BSP_ADCSCOPE_TypeDef *hscope, ADC_HandleTypeDef *hadc, uint16_t *pBuffer,
+                                    uint32_t Length, uint32_t PreTrigger, uint32_t PostTrigger);
+HAL_StatusTypeDef BSP_ADCSCOPE_Arm(BSP_ADCSCOPE_TypeDef *hscope);
+HAL_StatusTypeDef BSP_ADCSCOPE_Stop(BSP_ADCSCOPE_TypeDef *hscope);
+uint32_t          BSP_ADCSCOPE_GetWindow(const BSP_ADCSCOPE_TypeDef *hscope, const uint16_t **ppFirst,
+                                         uint32_t *pFirstLength, const uint16_t **ppSecond,
+                                         uint32_t *pSecondLength);
+uint16_t          BSP_ADCSCOPE_GetSample(const BSP_ADCSCOPE_TypeDef *hscope, uint32_t Index);
+void              BSP_ADCSCOPE_LevelOutOfWindowCallback(BSP_ADCSCOPE_TypeDef *hscope);
+void              BSP_ADCSCOPE_CaptureCallback(BSP_ADCSCOPE_TypeDef *hscope);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCSCOPE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcstream.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ADC block streaming BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCSTREAM_H
+#define __PY32F4XX_BSP_ADCSTREAM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCSTREAM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Exported_Constants BSP ADCSTREAM Exported Constants
+  * @{
+  */
+#if !defined (BSP_ADCSTREAM_BLOCKS_MAX)
+#define BSP_ADCSTREAM_BLOCKS_MAX        32U            /*!< Blocks of a pool, a power of two          */
+#endif /* BSP_ADCSTREAM_BLOCKS_MAX */
+
+/** @defgroup BSP_ADCSTREAM_State BSP ADCSTREAM State
+  * @{
+  */
+#define BSP_ADCSTREAM_STATE_RESET       0x00000000U    /*!< Not initialized                           */
+#define BSP_ADCSTREAM_STATE_READY       0x00000001U    /*!< Initialized, capture stopped              */
+#define BSP_ADCSTREAM_STATE_RUN         0x00000002U    /*!< Capture running                           */
+#define BSP_ADCSTREAM_STATE_ERROR       0x00000003U    /*!< DMA error, the capture is stopped         */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Exported_Types BSP ADCSTREAM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Capture block definition
+  */
+typedef struct
+{
+  uint16_t                *pData;       /*!< BlockLength conversions, written by the DMA             */
+
+  uint32_t                Sequence;     /*!< Block number since the start, its first sample is
+                                             Sequence x BlockLength                                 */
+
+  uint32_t                Timestamp;    /*!< Time base counter when the DMA switched to the block   */
+
+} BSP_ADCSTREAM_BlockTypeDef;
+
+/**
+  * @brief  Block streaming capture definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc;        /*!< ADC converting into the blocks, its DMA owned by the
+                                             service in double buffer mode                          */
+
+  TIM_TypeDef             *TimeBase;    /*!< Timer stamping the blocks, NULL for the DWT cycle count */
+
+  BSP_ADCSTREAM_BlockTypeDef *pBlocks;  /*!< Block pool                                             */
+
+  uint32_t                BlockCount;   /*!< Blocks in the pool, 3 to BSP_ADCSTREAM_BLOCKS_MAX      */
+
+  uint32_t                BlockLength;  /*!< Conversions per block, 1 to 0xFFFF                     */
+
+  uint8_t                 Slots[2];     /*!< Blocks in memory 0 and memory 1 of the DMA             */
+
+  uint32_t                Sequence;     /*!< Sequence of the last block handed to the DMA           */
+
+  uint8_t                 Free[BSP_ADCSTREAM_BLOCKS_MAX]; /*!< Released blocks, written by thread mode */
+
+  __IO uint32_t           FreeHead;     /*!< Next entry of Free written by BSP_ADCSTREAM_Release()  */
+
+  __IO uint32_t           FreeTail;     /*!< Next entry of Free taken by the DMA callbacks          */
+
+  uint8_t                 Ready[BSP_ADCSTREAM_BLOCKS_MAX]; /*!< Full blocks, written by the DMA callbacks */
+
+  __IO uint32_t           ReadyHead;    /*!< Next entry of Ready written by the DMA callbacks       */
+
+  __IO uint32_t           ReadyTail;    /*!< Next entry of Ready taken by BSP_ADCSTREAM_Get()       */
+
+  __IO uint32_t           Overruns;     /*!< Blocks dropped for lack of a free block                */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ADCSTREAM_State                    */
+
+} BSP_ADCSTREAM_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCSTREAM_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCSTREAM_Init(BSP_ADCSTREAM_TypeDef *hstream, ADC_HandleTypeDef *hadc,
+                                     TIM_TypeDef *TimeBase, BSP_ADCSTREAM_BlockTypeDef *pBlocks,
+                                     uint16_t *pStorage, uint32_t BlockCount, uint32_t BlockLength);
+HAL_StatusTypeDef BSP_ADCSTREAM_Start(BSP_ADCSTREAM_TypeDef *hstream);
+HAL_StatusTypeDef BSP_ADCSTREAM_Stop(BSP_ADCSTREAM_TypeDef *hstream);
+BSP_ADCSTREAM_BlockTypeDef *BSP_ADCSTREAM_Get(BSP_ADCSTREAM_TypeDef *hstream);
+void              BSP_ADCSTREAM_Release(BSP_ADCSTREAM_TypeDef *hstream, BSP_ADCSTREAM_BlockTypeDef *pBlock);
+void              BSP_ADCSTREAM_BlockReadyCallback(BSP_ADCSTREAM_TypeDef *hstream);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCSTREAM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
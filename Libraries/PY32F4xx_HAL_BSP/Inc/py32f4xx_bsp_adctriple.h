@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adctriple.h
+  * @author  MCU Application Team
+  * @brief   Header file of the triple interleaved ADC capture BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ADCTRIPLE_H
+#define __PY32F4XX_BSP_ADCTRIPLE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ADCTRIPLE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Exported_Constants BSP ADCTRIPLE Exported Constants
+  * @{
+  */
+#define BSP_ADCTRIPLE_ADCS              3U             /*!< ADC1, ADC2 and ADC3 in turn              */
+
+/** @defgroup BSP_ADCTRIPLE_State BSP ADCTRIPLE State
+  * @{
+  */
+#define BSP_ADCTRIPLE_STATE_RESET       0x00000000U    /*!< Not initialized                           */
+#define BSP_ADCTRIPLE_STATE_READY       0x00000001U    /*!< Initialized, capture stopped              */
+#define BSP_ADCTRIPLE_STATE_RUN         0x00000002U    /*!< Capture running                           */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Exported_Types BSP ADCTRIPLE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Triple interleaved capture definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc[BSP_ADCTRIPLE_ADCS]; /*!< ADC1, ADC2 and ADC3, each with its DMA channel
+                                                           linked by the MSP                    */
+
+  TIM_HandleTypeDef       *htim;        /*!< TIM1, CC1, CC2 and CC3 trigger the ADCs in turn        */
+
+  uint32_t                Step;         /*!< Timer ticks between two samples of the capture         */
+
+  uint32_t                SampleRate;   /*!< Aggregate rate obtained, samples per second            */
+
+  uint16_t                *pBuffer;     /*!< Capture buffer, BSP_ADCTRIPLE_ADCS blocks of Length    */
+
+  uint32_t                Length;       /*!< Samples per ADC in the buffer                          */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ADCTRIPLE_State                    */
+
+} BSP_ADCTRIPLE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ADCTRIPLE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ADCTRIPLE_Init(BSP_ADCTRIPLE_TypeDef *hadct, ADC_HandleTypeDef *hadc1,
+                                     ADC_HandleTypeDef *hadc2, ADC_HandleTypeDef *hadc3,
+                                     TIM_HandleTypeDef *htim, uint32_t Channel,
+                                     uint32_t SamplingTime, uint32_t SampleRate);
+HAL_StatusTypeDef BSP_ADCTRIPLE_Start(BSP_ADCTRIPLE_TypeDef *hadct, uint16_t *pBuffer, uint32_t Length);
+HAL_StatusTypeDef BSP_ADCTRIPLE_Stop(BSP_ADCTRIPLE_TypeDef *hadct);
+uint16_t          BSP_ADCTRIPLE_GetSample(const BSP_ADCTRIPLE_TypeDef *hadct, uint32_t Index);
+void              BSP_ADCTRIPLE_Pack(const BSP_ADCTRIPLE_TypeDef *hadct, uint16_t *pDst,
+                                     uint32_t Index, uint32_t Count);
+void              BSP_ADCTRIPLE_HalfCpltCallback(BSP_ADCTRIPLE_TypeDef *hadct);
+void              BSP_ADCTRIPLE_CpltCallback(BSP_ADCTRIPLE_TypeDef *hadct);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ADCTRIPLE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,245 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_aes.h
+  * @author  MCU Application Team
+  * @brief   Header file of the AES link encryption BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_AES_H
+#define __PY32F4XX_BSP_AES_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_AES
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_AES_Exported_Constants BSP AES Exported Constants
+  * @{
+  */
+#define BSP_AES_BLOCK_SIZE              16U            /*!< Bytes of a block                          */
+#define BSP_AES_KEY_128                 16U            /*!< Bytes of an AES-128 key                   */
+#define BSP_AES_KEY_256                 32U            /*!< Bytes of an AES-256 key                   */
+#define BSP_AES_IV_SIZE                 12U            /*!< Bytes of a GCM initialization vector      */
+#define BSP_AES_TAG_MIN                 4U             /*!< Shortest GCM tag, for CAN frames          */
+#define BSP_AES_TAG_MAX                 16U            /*!< Full GCM tag                              */
+#define BSP_AES_SALT_SIZE               8U             /*!< Bytes of the salt of a link direction     */
+#define BSP_AES_SEQUENCE_SIZE           4U             /*!< Bytes of the sequence of a record         */
+
+/** @defgroup BSP_AES_Engine BSP AES Engine
+  * @{
+  */
+#define BSP_AES_ENGINE_TABLE            0x00000000U    /*!< T-table rounds, tables in SRAM, fastest   */
+#define BSP_AES_ENGINE_CONSTTIME        0x00000001U    /*!< Bitsliced rounds on two blocks and bitwise
+                                                            GHASH, no secret dependent address        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_AES_Exported_Types BSP AES Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Cipher key definition
+  */
+typedef struct
+{
+  uint32_t                Engine;       /*!< A value of @ref BSP_AES_Engine                         */
+
+  uint32_t                Rounds;       /*!< 10 for AES-128, 14 for AES-256                         */
+
+  uint32_t                RoundKey[120]; /*!< Round keys, 4 words a round for the tables, 8 bitsliced
+                                             words for the constant time engine                     */
+
+} BSP_AES_TypeDef;
+
+/**
+  * @brief  GCM operation definition
+  */
+typedef struct
+{
+  const BSP_AES_TypeDef   *haes;        /*!< Cipher key                                             */
+
+  uint64_t                HH[16];       /*!< Multiples of H by 4-bit values, high halves            */
+
+  uint64_t                HL[16];       /*!< Multiples of H by 4-bit values, low halves             */
+
+  uint32_t                H[4];         /*!< Hash key, big endian words                             */
+
+  uint32_t                Iv[3];        /*!< Initialization vector, as in memory                    */
+
+  uint32_t                Count;        /*!< Counter of the next keystream block                    */
+
+  uint32_t                Y[4];         /*!< GHASH accumulator, big endian words                    */
+
+  uint32_t                EkJ0[4];      /*!< Encrypted first counter block, masks the tag           */
+
+  uint32_t                Stream[8];    /*!< Keystream of the current blocks                        */
+
+  uint32_t                StreamUsed;   /*!< Bytes of Stream used                                   */
+
+  uint32_t                StreamSize;   /*!< Bytes of keystream made at once, 1 or 2 blocks         */
+
+  uint32_t                Partial[4];   /*!< Block being filled for GHASH                           */
+
+  uint32_t                PartialFill;  /*!< Bytes in Partial                                       */
+
+  uint32_t                AadSize;      /*!< Bytes of additional data                               */
+
+  uint32_t                TextSize;     /*!< Bytes encrypted or decrypted                           */
+
+} BSP_AES_GcmTypeDef;
+
+/**
+  * @brief  Link statistics definition
+  */
+typedef struct
+{
+  uint32_t                Sealed;       /*!< Records sealed                                         */
+
+  uint32_t                Opened;       /*!< Records opened                                         */
+
+  uint32_t                Replayed;     /*!< Records refused, sequence not above the last one       */
+
+  uint32_t                Forged;       /*!< Records refused, wrong tag                             */
+
+} BSP_AES_LinkStatsTypeDef;
+
+/**
+  * @brief  Encrypted link definition
+  */
+typedef struct
+{
+  BSP_AES_GcmTypeDef      Tx;           /*!< GCM of the records sent                                */
+
+  BSP_AES_GcmTypeDef      Rx;           /*!< GCM of the records received                            */
+
+  uint8_t                 TxSalt[BSP_AES_SALT_SIZE]; /*!< First IV bytes of the records sent        */
+
+  uint8_t                 RxSalt[BSP_AES_SALT_SIZE]; /*!< First IV bytes of the records received    */
+
+  uint32_t                TagSize;      /*!< Bytes of the tag of a record                           */
+
+  uint32_t                TxSequence;   /*!< Sequence of the last record sealed                     */
+
+  uint32_t                RxSequence;   /*!< Sequence of the last record opened                     */
+
+  BSP_AES_LinkStatsTypeDef Stats;       /*!< Statistics                                             */
+
+} BSP_AES_LinkTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_AES_Exported_Macros BSP AES Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Bytes added to a payload by BSP_AES_LinkSeal().
+  * @param  __TAGSIZE__ Bytes of the tag.
+  * @retval Bytes of the sequence and of the tag
+  */
+#define BSP_AES_LINK_OVERHEAD(__TAGSIZE__) (BSP_AES_SEQUENCE_SIZE + (__TAGSIZE__))
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_AES_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_AES_Exported_Functions_Group1
+  * @{
+  */
+/* Cipher functions ***********************************************************/
+HAL_StatusTypeDef BSP_AES_Init(BSP_AES_TypeDef *haes, const uint8_t *pKey, uint32_t KeySize, uint32_t Engine);
+void              BSP_AES_Encrypt(const BSP_AES_TypeDef *haes, const uint8_t *pIn, uint8_t *pOut);
+void              BSP_AES_CtrCrypt(const BSP_AES_TypeDef *haes, uint8_t *pCounter, const uint8_t *pIn,
+                                   uint8_t *pOut, uint32_t Size);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_AES_Exported_Functions_Group2
+  * @{
+  */
+/* GCM functions **************************************************************/
+void              BSP_AES_GcmInit(BSP_AES_GcmTypeDef *hgcm, const BSP_AES_TypeDef *haes);
+void              BSP_AES_GcmStart(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIv);
+void              BSP_AES_GcmAad(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pAad, uint32_t Size);
+void              BSP_AES_GcmEncrypt(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size);
+void              BSP_AES_GcmDecrypt(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size);
+void              BSP_AES_GcmFinish(BSP_AES_GcmTypeDef *hgcm, uint8_t *pTag, uint32_t TagSize);
+HAL_StatusTypeDef BSP_AES_GcmCheck(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pTag, uint32_t TagSize);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_AES_Exported_Functions_Group3
+  * @{
+  */
+/* Link functions *************************************************************/
+HAL_StatusTypeDef BSP_AES_LinkInit(BSP_AES_LinkTypeDef *hlink, const BSP_AES_TypeDef *haes, const uint8_t *pTxSalt,
+                                   const uint8_t *pRxSalt, uint32_t TagSize);
+HAL_StatusTypeDef BSP_AES_LinkSeal(BSP_AES_LinkTypeDef *hlink, uint8_t *pRecord, uint32_t Length);
+HAL_StatusTypeDef BSP_AES_LinkOpen(BSP_AES_LinkTypeDef *hlink, uint8_t *pRecord, uint32_t Length);
+HAL_StatusTypeDef BSP_AES_LinkOpenSplit(BSP_AES_LinkTypeDef *hlink, uint8_t *pData, uint32_t Length,
+                                        uint8_t *pWrap, uint32_t WrapLength);
+void              BSP_AES_LinkGetStats(const BSP_AES_LinkTypeDef *hlink, BSP_AES_LinkStatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_AES_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
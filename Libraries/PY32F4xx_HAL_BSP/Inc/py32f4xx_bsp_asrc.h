@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_asrc.h
+  * @author  MCU Application Team
+  * @brief   Header file of the asynchronous sample rate converter BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ASRC_H
+#define __PY32F4XX_BSP_ASRC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ASRC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ASRC_Exported_Constants BSP ASRC Exported Constants
+  * @{
+  */
+#define BSP_ASRC_CHANNELS_MAX           2U             /*!< Mono or stereo                            */
+#define BSP_ASRC_TAPS                   8U             /*!< Input samples per output sample           */
+#define BSP_ASRC_PHASES                 32U            /*!< Filter phases between two input samples   */
+
+/** @defgroup BSP_ASRC_Loop BSP ASRC Loop
+  * @brief    Fill level control loop, overridable
+  * @{
+  */
+#if !defined (BSP_ASRC_KP)
+#define BSP_ASRC_KP                     4.0f           /*!< ppm per frame of fill error               */
+#endif
+
+#if !defined (BSP_ASRC_KI)
+#define BSP_ASRC_KI                     0.2f           /*!< ppm per frame of fill error and second    */
+#endif
+
+#if !defined (BSP_ASRC_PPM_MAX)
+#define BSP_ASRC_PPM_MAX                1000.0f        /*!< Largest rate correction                   */
+#endif
+
+#if !defined (BSP_ASRC_LEVEL_TC)
+#define BSP_ASRC_LEVEL_TC               0.25f          /*!< Fill level averaging, seconds             */
+#endif
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ASRC_Exported_Types BSP ASRC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Sample rate converter statistics definition
+  */
+typedef struct
+{
+  uint32_t                Level;        /*!< Frames in the FIFO after the last read                 */
+
+  float                   Ppm;          /*!< Rate correction applied, the drift of the source       */
+
+  uint32_t                Underruns;    /*!< Input frames missing, silence read in their place      */
+
+  uint32_t                Overruns;     /*!< Input frames dropped, the FIFO full                    */
+
+} BSP_ASRC_StatsTypeDef;
+
+/**
+  * @brief  Sample rate converter definition
+  */
+typedef struct
+{
+  uint32_t                Channels;     /*!< Samples per frame, 1 or 2                              */
+
+  uint32_t                InRate;       /*!< Nominal rate of the source, Hz                         */
+
+  uint32_t                OutRate;      /*!< Rate of the reader, Hz                                 */
+
+  int16_t                 *pFifo;       /*!< Capacity x Channels Q15 samples                        */
+
+  uint32_t                Capacity;     /*!< Frames of the FIFO, a power of 2                       */
+
+  __IO uint32_t           WriteCount;   /*!< Frames written, by the source only                     */
+
+  __IO uint32_t           ReadCount;    /*!< Frames taken, by the reader only                       */
+
+  uint32_t                Primed;       /*!< 0 while the FIFO fills up to half                      */
+
+  __IO uint32_t           WriteStamp;   /*!< DWT cycle counter at the last write                    */
+
+  __IO uint32_t           WriteFrames;  /*!< Frames of the last write                               */
+
+  float                   WritePeriod;  /*!< Cycles between two writes, averaged, 0 before two     */
+
+  uint64_t                Nominal;      /*!< InRate / OutRate, 32.32                                */
+
+  uint64_t                Step;         /*!< Input frames per output frame corrected, 32.32         */
+
+  uint64_t                Position;     /*!< Input frames to take before the next output, 32.32     */
+
+  float                   AvgLevel;     /*!< Fill level averaged                                    */
+
+  float                   Integral;     /*!< Integral term of the correction, ppm                   */
+
+  uint32_t                HistIndex;    /*!< Oldest sample of the filter window                     */
+
+  int16_t                 History[BSP_ASRC_CHANNELS_MAX][2U * BSP_ASRC_TAPS]; /*!< Filter windows,
+                                             each sample written twice                              */
+
+  int16_t                 Coeffs[(BSP_ASRC_PHASES + 1U) * BSP_ASRC_TAPS]; /*!< Polyphase filter,
+                                             built by the Init                                      */
+
+  BSP_ASRC_StatsTypeDef   Stats;        /*!< Statistics                                             */
+
+} BSP_ASRC_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ASRC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ASRC_Init(BSP_ASRC_TypeDef *hasrc, uint32_t Channels, uint32_t InRate, uint32_t OutRate,
+                                int16_t *pFifo, uint32_t Capacity);
+uint32_t          BSP_ASRC_Write(BSP_ASRC_TypeDef *hasrc, const int16_t *pSrc, uint32_t Frames);
+void              BSP_ASRC_Read(BSP_ASRC_TypeDef *hasrc, int16_t *pDst, uint32_t Frames);
+void              BSP_ASRC_GetStats(const BSP_ASRC_TypeDef *hasrc, BSP_ASRC_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ASRC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,253 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_atcmd.h
+  * @author  MCU Application Team
+  * @brief   Header file of the AT command engine BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ATCMD_H
+#define __PY32F4XX_BSP_ATCMD_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_serial.h"
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ATCMD
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ATCMD_Exported_Constants BSP ATCMD Exported Constants
+  * @{
+  */
+#ifndef BSP_ATCMD_LINE_SIZE
+#define BSP_ATCMD_LINE_SIZE             128U           /*!< Longest line received, terminator included      */
+#endif
+
+/** @defgroup BSP_ATCMD_Status BSP ATCMD Status
+  * @{
+  */
+#define BSP_ATCMD_STATUS_NONE           0x00000000U    /*!< Never submitted                                 */
+#define BSP_ATCMD_STATUS_PENDING        0x00000001U    /*!< Queued or in progress                           */
+#define BSP_ATCMD_STATUS_OK             0x00000002U    /*!< OK or SEND OK received                          */
+#define BSP_ATCMD_STATUS_ERROR          0x00000003U    /*!< ERROR, FAIL, SEND FAIL or +CME/+CMS ERROR       */
+#define BSP_ATCMD_STATUS_TIMEOUT        0x00000004U    /*!< No final result within the timeout              */
+#define BSP_ATCMD_STATUS_ABORTED        0x00000005U    /*!< Removed by BSP_ATCMD_Flush()                    */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ATCMD_State BSP ATCMD State
+  * @{
+  */
+#define BSP_ATCMD_STATE_IDLE            0x00000000U    /*!< No command in progress                          */
+#define BSP_ATCMD_STATE_COMMAND         0x00000001U    /*!< Command line being written                      */
+#define BSP_ATCMD_STATE_PROMPT          0x00000002U    /*!< Waiting for the '>' prompt of the payload       */
+#define BSP_ATCMD_STATE_DATA            0x00000003U    /*!< Payload being written                           */
+#define BSP_ATCMD_STATE_RESULT          0x00000004U    /*!< Waiting for the final result                    */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ATCMD_Exported_Types BSP ATCMD Exported Types
+  * @{
+  */
+
+struct __BSP_ATCMD_TypeDef;
+
+/**
+  * @brief  Command definition
+  * @note   Owned by the engine from BSP_ATCMD_Submit() until its Status leaves
+  *         BSP_ATCMD_STATUS_PENDING.
+  */
+typedef struct __BSP_ATCMD_CmdTypeDef
+{
+  const char              *pCommand;    /*!< Command line without CR, e.g. "AT+CIPSTATUS"           */
+
+  const uint8_t           *pData;       /*!< Payload written after the '>' prompt, NULL for none    */
+
+  uint32_t                DataLength;   /*!< Number of bytes of the payload                         */
+
+  uint32_t                Timeout;      /*!< Time in ms from the command start to its final result  */
+
+  void                    (*LineCallback)(struct __BSP_ATCMD_CmdTypeDef *pCmd, const char *pLine,
+                                          uint32_t Length); /*!< Called for each response line
+                                             which is neither a URC nor a final result, may be NULL */
+
+  void                    (*CpltCallback)(struct __BSP_ATCMD_CmdTypeDef *pCmd); /*!< Called with the
+                                             final Status, may be NULL                              */
+
+  void                    *pContext;    /*!< Left to the submitter                                  */
+
+  __IO uint32_t           Status;       /*!< A value of @ref BSP_ATCMD_Status                       */
+
+  struct __BSP_ATCMD_CmdTypeDef *pNext; /*!< Next queued command                                    */
+
+} BSP_ATCMD_CmdTypeDef;
+
+/**
+  * @brief  Unsolicited result code definition
+  * @note   A line matches when it starts with pPrefix, an empty prefix matches
+  *         every line. With a Terminator the callback gets the header as soon
+  *         as that character is received after the prefix, e.g. ':' for
+  *         "+IPD,0,512:", without waiting for an end of line, and calls
+  *         BSP_ATCMD_ReadRaw() for the binary payload which follows.
+  */
+typedef struct
+{
+  const char              *pPrefix;     /*!< Start of the line                                      */
+
+  char                    Terminator;   /*!< Last character of a data header, '\0' for a whole line */
+
+  uint32_t                (*Callback)(struct __BSP_ATCMD_TypeDef *hat, const char *pLine,
+                                      uint32_t Length); /*!< Returns 1 when the line is handled,
+                                             0 to pass it on                                        */
+
+} BSP_ATCMD_UrcTypeDef;
+
+/**
+  * @brief  Statistics definition
+  */
+typedef struct
+{
+  uint32_t                Commands;     /*!< Commands started                                       */
+
+  uint32_t                Errors;       /*!< Commands ended by an error result                      */
+
+  uint32_t                Timeouts;     /*!< Commands ended by their timeout                        */
+
+  uint32_t                Urcs;         /*!< Lines and data headers handled by the URC table        */
+
+  uint32_t                Unsolicited;  /*!< Lines dropped, neither URC nor response                */
+
+  uint32_t                Overflows;    /*!< Lines dropped, longer than BSP_ATCMD_LINE_SIZE         */
+
+  uint32_t                RawBytes;     /*!< Payload bytes delivered by BSP_ATCMD_ReadRaw()         */
+
+} BSP_ATCMD_StatsTypeDef;
+
+/**
+  * @brief  AT command engine definition
+  */
+typedef struct __BSP_ATCMD_TypeDef
+{
+  uint32_t                Port;         /*!< Serial port of the modem, a value of @ref BSP_SERIAL_Port */
+
+  const BSP_ATCMD_UrcTypeDef *pUrc;     /*!< URC table                                              */
+
+  uint32_t                UrcCount;     /*!< Number of entries of the URC table                     */
+
+  void                    *pContext;    /*!< Left to the owner, e.g. for the URC callbacks          */
+
+  BSP_ATCMD_CmdTypeDef    *pHead;       /*!< Command in progress, then the queued ones              */
+
+  BSP_ATCMD_CmdTypeDef    *pTail;       /*!< Last queued command                                    */
+
+  uint32_t                State;        /*!< A value of @ref BSP_ATCMD_State                        */
+
+  uint32_t                TxOffset;     /*!< Bytes of the command line or payload written           */
+
+  uint32_t                TickStart;    /*!< Start of the command in progress                       */
+
+  uint8_t                 *pRawBuffer;  /*!< Destination of the payload, NULL to stream or drop it  */
+
+  void                    (*RawCallback)(struct __BSP_ATCMD_TypeDef *hat, const uint8_t *pData,
+                                         uint32_t Length); /*!< Payload stream, in place in the
+                                             receive ring                                           */
+
+  uint32_t                RawLength;    /*!< Payload bytes still expected                           */
+
+  uint32_t                LineLength;   /*!< Characters in Line                                     */
+
+  uint32_t                Overflow;     /*!< 1 when the current line is too long                    */
+
+  char                    Line[BSP_ATCMD_LINE_SIZE]; /*!< Line being received                       */
+
+  BSP_ATCMD_StatsTypeDef  Stats;        /*!< Statistics                                             */
+
+} BSP_ATCMD_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ATCMD_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_ATCMD_Exported_Functions_Group1
+  * @{
+  */
+/* Engine functions ***********************************************************/
+HAL_StatusTypeDef BSP_ATCMD_Init(BSP_ATCMD_TypeDef *hat, uint32_t Port, const BSP_ATCMD_UrcTypeDef *pUrc,
+                                 uint32_t UrcCount, void *pContext);
+void              BSP_ATCMD_Process(BSP_ATCMD_TypeDef *hat);
+void              BSP_ATCMD_GetStats(const BSP_ATCMD_TypeDef *hat, BSP_ATCMD_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ATCMD_Exported_Functions_Group2
+  * @{
+  */
+/* Command functions **********************************************************/
+HAL_StatusTypeDef BSP_ATCMD_Submit(BSP_ATCMD_TypeDef *hat, BSP_ATCMD_CmdTypeDef *pCmd);
+BSP_ATCMD_CmdTypeDef *BSP_ATCMD_GetCurrent(const BSP_ATCMD_TypeDef *hat);
+void              BSP_ATCMD_Flush(BSP_ATCMD_TypeDef *hat);
+HAL_StatusTypeDef BSP_ATCMD_ReadRaw(BSP_ATCMD_TypeDef *hat, uint32_t Length, uint8_t *pBuffer,
+                                    void (*pCallback)(BSP_ATCMD_TypeDef *hat, const uint8_t *pData,
+                                                      uint32_t Length));
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ATCMD_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_bkpstore.h
+  * @author  MCU Application Team
+  * @brief   Header file of the backup register store BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_BKPSTORE_H
+#define __PY32F4XX_BSP_BKPSTORE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_RTC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_BKPSTORE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Exported_Constants BSP BKPSTORE Exported Constants
+  * @{
+  */
+#if !defined (BSP_BKPSTORE_LAST)
+#define BSP_BKPSTORE_LAST               41U            /*!< Last backup register usable, DR42 left to
+                                                            the uptime clock                           */
+#endif
+
+/**
+  * @brief  Backup registers of a store of a size in bytes, two copies
+  */
+#define BSP_BKPSTORE_REGISTERS(__SIZE__) (2U * ((((uint32_t)(__SIZE__) + 1U) / 2U) + 2U))
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Exported_Types BSP BKPSTORE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Backup register store definition
+  */
+typedef struct
+{
+  RTC_HandleTypeDef       *hrtc;        /*!< RTC handle of the backup registers                     */
+
+  uint32_t                First;        /*!< First backup register, 1 for RTC_BKP_DR1               */
+
+  uint32_t                Size;         /*!< Bytes of the data                                      */
+
+  uint32_t                Version;      /*!< Layout version of the data, 0 to 255                   */
+
+  uint32_t                Bank;         /*!< Copy holding the data, 0 or 1                          */
+
+  uint32_t                Seq;          /*!< Commit sequence of that copy, 0 to 255                 */
+
+  uint32_t                Valid;        /*!< 1 when a copy passed its CRC and version               */
+
+} BSP_BKPSTORE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_BKPSTORE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_BKPSTORE_Init(BSP_BKPSTORE_TypeDef *hbs, RTC_HandleTypeDef *hrtc, uint32_t First,
+                                    uint32_t Size, uint32_t Version);
+HAL_StatusTypeDef BSP_BKPSTORE_Read(const BSP_BKPSTORE_TypeDef *hbs, void *pData);
+HAL_StatusTypeDef BSP_BKPSTORE_Commit(BSP_BKPSTORE_TypeDef *hbs, const void *pData);
+void              BSP_BKPSTORE_Erase(BSP_BKPSTORE_TypeDef *hbs);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_BKPSTORE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
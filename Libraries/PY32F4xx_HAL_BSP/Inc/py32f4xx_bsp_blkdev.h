@@ -0,0 +1,221 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_blkdev.h
+  * @author  MCU Application Team
+  * @brief   Header file of the block device BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_BLKDEV_H
+#define __PY32F4XX_BSP_BLKDEV_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_esmcflash.h"
+#include "py32f4xx_bsp_spiflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_BLKDEV
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_BLKDEV_Exported_Constants BSP BLKDEV Exported Constants
+  * @{
+  */
+#define BSP_BLKDEV_NO_SECTOR            0xFFFFFFFFU    /*!< Sector of an empty cache line             */
+
+#if !defined (BSP_BLKDEV_READ_AHEAD)
+#define BSP_BLKDEV_READ_AHEAD           4U             /*!< Sectors loaded by a sequential read miss  */
+#endif
+
+#if !defined (BSP_BLKDEV_TIMEOUT)
+#define BSP_BLKDEV_TIMEOUT              1000U          /*!< SD transfer and programming timeout, ms   */
+#endif
+
+/** @defgroup BSP_BLKDEV_State BSP BLKDEV State
+  * @{
+  */
+#define BSP_BLKDEV_STATE_RESET          0x00000000U    /*!< Not initialized                           */
+#define BSP_BLKDEV_STATE_READY          0x00000001U    /*!< Initialized                               */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_BLKDEV_Exported_Types BSP BLKDEV Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Block device driver definition, whole sectors
+  */
+typedef struct
+{
+  HAL_StatusTypeDef       (*Read)(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count);        /*!< Read sectors */
+
+  HAL_StatusTypeDef       (*Write)(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count); /*!< Write sectors */
+
+  HAL_StatusTypeDef       (*Sync)(void *pDev);                                      /*!< End the pending writes */
+
+  HAL_StatusTypeDef       (*Erase)(void *pDev, uint32_t Sector, uint32_t Count);    /*!< Discard sectors, NULL for none */
+
+} BSP_BLKDEV_OpsTypeDef;
+
+/**
+  * @brief  Block device cache line definition
+  */
+typedef struct
+{
+  uint32_t                Sector;       /*!< Sector held, BSP_BLKDEV_NO_SECTOR when empty           */
+
+  uint32_t                Stamp;        /*!< Last use, the oldest line is replaced first            */
+
+  uint32_t                Dirty;        /*!< 1 when written and not yet given to the device         */
+
+  uint8_t                 *pData;       /*!< SectorSize bytes, word aligned for the DMA             */
+
+} BSP_BLKDEV_LineTypeDef;
+
+/**
+  * @brief  Block device statistics definition, in sectors
+  */
+typedef struct
+{
+  uint32_t                ReadHits;     /*!< Read from the cache                                    */
+
+  uint32_t                ReadMisses;   /*!< Loaded into the cache on a read                        */
+
+  uint32_t                ReadAheads;   /*!< Loaded ahead of a sequential read                      */
+
+  uint32_t                DirectReads;  /*!< Read by the device into the caller buffer              */
+
+  uint32_t                WriteHits;    /*!< Written into a cached sector                           */
+
+  uint32_t                WriteBacks;   /*!< Written back from the cache to the device              */
+
+  uint32_t                DirectWrites; /*!< Written by the device from the caller buffer           */
+
+  uint32_t                Errors;       /*!< Device operations failed                               */
+
+} BSP_BLKDEV_StatsTypeDef;
+
+/**
+  * @brief  Block device definition
+  */
+typedef struct
+{
+  const BSP_BLKDEV_OpsTypeDef *pOps;    /*!< Driver of the device                                   */
+
+  void                    *pDev;        /*!< Handle of the device, first argument of the driver     */
+
+  uint32_t                SectorSize;   /*!< Bytes of a sector, a multiple of 4                     */
+
+  uint32_t                SectorCount;  /*!< Sectors of the device                                  */
+
+  BSP_BLKDEV_LineTypeDef  *pLines;      /*!< Cache lines, buffers contiguous in line order          */
+
+  uint32_t                NbrOfLines;   /*!< Cache lines                                            */
+
+  uint32_t                Stamp;        /*!< Cache use counter                                      */
+
+  uint32_t                AheadLine;    /*!< First line of the next read-ahead window               */
+
+  uint32_t                NextRead;     /*!< Sector following the last read, sequential detection   */
+
+  BSP_BLKDEV_StatsTypeDef Stats;        /*!< Statistics                                             */
+
+  uint32_t                State;        /*!< A value of @ref BSP_BLKDEV_State                       */
+
+} BSP_BLKDEV_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_BLKDEV_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_BLKDEV_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_BLKDEV_Init(BSP_BLKDEV_TypeDef *hdev, const BSP_BLKDEV_OpsTypeDef *pOps, void *pDev,
+                                  uint32_t SectorSize, uint32_t SectorCount,
+                                  BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer);
+#if defined (HAL_SD_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_BLKDEV_InitSD(BSP_BLKDEV_TypeDef *hdev, SD_HandleTypeDef *hsd,
+                                    BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer);
+#endif /* HAL_SD_MODULE_ENABLED */
+#if defined (HAL_ESMC_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_BLKDEV_InitESMCFlash(BSP_BLKDEV_TypeDef *hdev, BSP_ESMCFLASH_TypeDef *hflash,
+                                           uint32_t FlashSize, BSP_BLKDEV_LineTypeDef *pLines,
+                                           uint32_t NbrOfLines, uint8_t *pBuffer);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+#if defined (HAL_SPI_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_BLKDEV_InitSPIFlash(BSP_BLKDEV_TypeDef *hdev, BSP_SPIFLASH_TypeDef *hflash,
+                                          BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer);
+#endif /* HAL_SPI_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_BLKDEV_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+HAL_StatusTypeDef BSP_BLKDEV_Read(BSP_BLKDEV_TypeDef *hdev, uint8_t *pData, uint32_t Sector, uint32_t Count);
+HAL_StatusTypeDef BSP_BLKDEV_Write(BSP_BLKDEV_TypeDef *hdev, const uint8_t *pData, uint32_t Sector,
+                                   uint32_t Count);
+HAL_StatusTypeDef BSP_BLKDEV_Sync(BSP_BLKDEV_TypeDef *hdev);
+HAL_StatusTypeDef BSP_BLKDEV_Erase(BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, uint32_t Count);
+void              BSP_BLKDEV_GetStats(const BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_BLKDEV_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
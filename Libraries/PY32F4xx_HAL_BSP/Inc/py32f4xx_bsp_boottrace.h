@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_boottrace.h
+  * @author  MCU Application Team
+  * @brief   Header file of the boot timeline trace BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_BOOTTRACE_H
+#define __PY32F4XX_BSP_BOOTTRACE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_BOOTTRACE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_BOOTTRACE_Exported_Constants BSP BOOTTRACE Exported Constants
+  * @{
+  */
+#if !defined (BSP_BOOTTRACE_MARKS)
+#define BSP_BOOTTRACE_MARKS             16U            /*!< Marks kept, the next ones are dropped     */
+#endif /* BSP_BOOTTRACE_MARKS */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_BOOTTRACE_Exported_Types BSP BOOTTRACE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Boot timeline mark definition
+  */
+typedef struct
+{
+  const char              *pName;       /*!< Step reached, a string constant                        */
+
+  uint32_t                Cycles;       /*!< DWT cycle count at the mark                            */
+
+  uint32_t                HCLKFreq;     /*!< SystemCoreClock at the mark                            */
+
+} BSP_BOOTTRACE_MarkTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_BOOTTRACE_Exported_Functions
+  * @{
+  */
+void     BSP_BOOTTRACE_Mark(const char *pName);
+uint32_t BSP_BOOTTRACE_GetCount(void);
+const BSP_BOOTTRACE_MarkTypeDef *BSP_BOOTTRACE_GetMark(uint32_t Index);
+void     BSP_BOOTTRACE_Print(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_BOOTTRACE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canbit.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD bit timing BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANBIT_H
+#define __PY32F4XX_BSP_CANBIT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANBIT
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANBIT_Exported_Constants BSP CANBIT Exported Constants
+  * @{
+  */
+#if !defined (BSP_CANBIT_TOLERANCE_PPM)
+#define BSP_CANBIT_TOLERANCE_PPM        1000U          /*!< Bitrate error accepted, ppm               */
+#endif /* BSP_CANBIT_TOLERANCE_PPM */
+
+#if !defined (BSP_CANBIT_TDC_BITRATE)
+#define BSP_CANBIT_TDC_BITRATE          1000000U       /*!< Data bitrate from which the transmitter delay
+                                                            is compensated, bit/s                      */
+#endif /* BSP_CANBIT_TDC_BITRATE */
+
+#define BSP_CANBIT_SP_NOMINAL           875U           /*!< Nominal sample point of a 0 request, per mille */
+#define BSP_CANBIT_SP_DATA              750U           /*!< Data sample point of a 0 request, per mille    */
+#define BSP_CANBIT_TIMEOUT              10U            /*!< Reset mode entry and exit, ms             */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANBIT_Exported_Types BSP CANBIT Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CANFD bit timing definition, in the units of CANFD_InitTypeDef
+  */
+typedef struct
+{
+  uint32_t                Prescaler;    /*!< Kernel clock divider, both phases, 1 to 32             */
+
+  uint32_t                NominalSeg1;  /*!< Nominal time quanta before the sample point, sync
+                                             segment excluded                                       */
+
+  uint32_t                NominalSeg2;  /*!< Nominal time quanta after the sample point             */
+
+  uint32_t                NominalSjw;   /*!< Nominal resynchronization jump width                   */
+
+  uint32_t                DataSeg1;     /*!< Data time quanta before the sample point, sync
+                                             segment excluded                                       */
+
+  uint32_t                DataSeg2;     /*!< Data time quanta after the sample point                */
+
+  uint32_t                DataSjw;      /*!< Data resynchronization jump width                      */
+
+  uint32_t                SspOffset;    /*!< Secondary sample point of the transmitter delay
+                                             compensation, time quanta, 0 without compensation      */
+
+  uint32_t                NominalBitrate; /*!< Nominal bitrate obtained, bit/s                      */
+
+  uint32_t                DataBitrate;  /*!< Data bitrate obtained, bit/s                           */
+
+  uint32_t                NominalSamplePoint; /*!< Nominal sample point obtained, per mille         */
+
+  uint32_t                DataSamplePoint; /*!< Data sample point obtained, per mille               */
+
+} BSP_CANBIT_TimingTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANBIT_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANBIT_Calc(uint32_t ClockFreq, uint32_t NominalBitrate, uint32_t NominalSamplePoint,
+                                  uint32_t DataBitrate, uint32_t DataSamplePoint, BSP_CANBIT_TimingTypeDef *pTiming);
+HAL_StatusTypeDef BSP_CANBIT_CalcData(uint32_t ClockFreq, uint32_t DataBitrate, uint32_t DataSamplePoint,
+                                      BSP_CANBIT_TimingTypeDef *pTiming);
+void              BSP_CANBIT_ToInit(const BSP_CANBIT_TimingTypeDef *pTiming, CANFD_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_CANBIT_SwitchData(CANFD_HandleTypeDef *hcanfd, const BSP_CANBIT_TimingTypeDef *pTiming);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANBIT_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,250 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_candb.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CAN signal database BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANDB_H
+#define __PY32F4XX_BSP_CANDB_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_canrx.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANDB
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Exported_Constants BSP CANDB Exported Constants
+  * @{
+  */
+#define BSP_CANDB_HASH_EMPTY            0xFFFFFFFFU    /*!< Free slot of the hash table               */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Exported_Types BSP CANDB Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CAN database message definition, one identifier and its decoder
+  */
+typedef struct
+{
+  uint32_t                Id;           /*!< Identifier                                             */
+
+  uint32_t                IdType;       /*!< A value of @ref CANFD_id_type                          */
+
+  uint32_t                Length;       /*!< Payload bytes of the message, shorter frames dropped   */
+
+  void                    (*Handler)(const BSP_CANRX_FrameTypeDef *pFrame); /*!< Decoder of the frames */
+
+} BSP_CANDB_MessageTypeDef;
+
+/**
+  * @brief  CAN database dispatcher statistics definition
+  */
+typedef struct
+{
+  uint32_t                Dispatched;   /*!< Frames given to a handler                              */
+
+  uint32_t                Unknown;      /*!< Frames of an identifier out of the database            */
+
+  uint32_t                Short;        /*!< Frames shorter than their message                      */
+
+  uint32_t                MaxProbes;    /*!< Longest hash table probe, 1 for a direct hit           */
+
+} BSP_CANDB_StatsTypeDef;
+
+/**
+  * @brief  CAN database dispatcher definition
+  */
+typedef struct
+{
+  const BSP_CANDB_MessageTypeDef *pMessages; /*!< Messages                                         */
+
+  uint32_t                NbrOfMessages; /*!< Messages                                              */
+
+  uint32_t                *pHash;       /*!< Message indexes by identifier, open addressing         */
+
+  uint32_t                HashShift;    /*!< 32 - log2 of the hash table size                       */
+
+  BSP_CANDB_StatsTypeDef  Stats;        /*!< Statistics                                             */
+
+} BSP_CANDB_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Exported_Macros BSP CANDB Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Sign extend a raw signal value.
+  * @param  __RAW__ Raw value, Length bits.
+  * @param  __LENGTH__ Bits of the signal, 1 to 32.
+  * @retval Signed value
+  */
+#define BSP_CANDB_SIGNED(__RAW__, __LENGTH__)                                                   \
+  ((int32_t)(((uint32_t)(__RAW__) ^ (1UL << ((__LENGTH__) - 1U))) - (1UL << ((__LENGTH__) - 1U))))
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANDB_Exported_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read a little endian (Intel) signal.
+  * @note   Called with constants, the loop folds into the loads of the bytes spanned.
+  * @param  pData Payload.
+  * @param  Start Least significant bit, DBC numbering.
+  * @param  Length Bits, 1 to 32.
+  * @retval Raw value
+  */
+__STATIC_INLINE uint32_t BSP_CANDB_GetLE(const uint8_t *pData, uint32_t Start, uint32_t Length)
+{
+  uint32_t first = Start >> 3U;
+  uint32_t last = (Start + Length - 1U) >> 3U;
+  uint64_t raw = 0U;
+  uint32_t i;
+
+  for (i = first; i <= last; i++)
+  {
+    raw |= (uint64_t)pData[i] << ((i - first) * 8U);
+  }
+
+  return (uint32_t)((raw >> (Start & 7U)) & (0xFFFFFFFFUL >> (32U - Length)));
+}
+
+/**
+  * @brief  Read a big endian (Motorola) signal.
+  * @note   Called with constants, the loop folds into the loads of the bytes spanned.
+  * @param  pData Payload.
+  * @param  Start Most significant bit, DBC numbering.
+  * @param  Length Bits, 1 to 32.
+  * @retval Raw value
+  */
+__STATIC_INLINE uint32_t BSP_CANDB_GetBE(const uint8_t *pData, uint32_t Start, uint32_t Length)
+{
+  uint32_t msb = (Start & ~7U) + (7U - (Start & 7U));
+  uint32_t lsb = msb + Length - 1U;
+  uint64_t raw = 0U;
+  uint32_t i;
+
+  for (i = msb >> 3U; i <= (lsb >> 3U); i++)
+  {
+    raw = (raw << 8U) | pData[i];
+  }
+
+  return (uint32_t)((raw >> (7U - (lsb & 7U))) & (0xFFFFFFFFUL >> (32U - Length)));
+}
+
+/**
+  * @brief  Write a little endian (Intel) signal, the other bits kept.
+  * @param  pData Payload.
+  * @param  Start Least significant bit, DBC numbering.
+  * @param  Length Bits, 1 to 32.
+  * @param  Value Raw value, truncated to Length bits.
+  * @retval None
+  */
+__STATIC_INLINE void BSP_CANDB_SetLE(uint8_t *pData, uint32_t Start, uint32_t Length, uint32_t Value)
+{
+  uint32_t first = Start >> 3U;
+  uint32_t last = (Start + Length - 1U) >> 3U;
+  uint64_t mask = (uint64_t)(0xFFFFFFFFUL >> (32U - Length)) << (Start & 7U);
+  uint64_t bits = ((uint64_t)Value << (Start & 7U)) & mask;
+  uint32_t i;
+
+  for (i = first; i <= last; i++)
+  {
+    pData[i] = (uint8_t)((pData[i] & ~(uint32_t)(mask >> ((i - first) * 8U))) | (uint32_t)(bits >> ((i - first) * 8U)));
+  }
+}
+
+/**
+  * @brief  Write a big endian (Motorola) signal, the other bits kept.
+  * @param  pData Payload.
+  * @param  Start Most significant bit, DBC numbering.
+  * @param  Length Bits, 1 to 32.
+  * @param  Value Raw value, truncated to Length bits.
+  * @retval None
+  */
+__STATIC_INLINE void BSP_CANDB_SetBE(uint8_t *pData, uint32_t Start, uint32_t Length, uint32_t Value)
+{
+  uint32_t msb = (Start & ~7U) + (7U - (Start & 7U));
+  uint32_t lsb = msb + Length - 1U;
+  uint32_t shift = 7U - (lsb & 7U);
+  uint64_t mask = (uint64_t)(0xFFFFFFFFUL >> (32U - Length)) << shift;
+  uint64_t bits = ((uint64_t)Value << shift) & mask;
+  uint32_t i;
+
+  for (i = lsb >> 3U; i >= (msb >> 3U); i--)
+  {
+    pData[i] = (uint8_t)((pData[i] & ~(uint32_t)mask) | (uint32_t)bits);
+    mask >>= 8U;
+    bits >>= 8U;
+    if (i == 0U)
+    {
+      break;
+    }
+  }
+}
+
+HAL_StatusTypeDef BSP_CANDB_Init(BSP_CANDB_TypeDef *hdb, const BSP_CANDB_MessageTypeDef *pMessages,
+                                 uint32_t NbrOfMessages, uint32_t *pHash, uint32_t HashSize);
+uint32_t          BSP_CANDB_Dispatch(BSP_CANDB_TypeDef *hdb, const BSP_CANRX_FrameTypeDef *pFrame);
+void              BSP_CANDB_GetStats(const BSP_CANDB_TypeDef *hdb, BSP_CANDB_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANDB_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
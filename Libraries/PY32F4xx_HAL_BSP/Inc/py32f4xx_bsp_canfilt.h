@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canfilt.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD acceptance filter planner BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANFILT_H
+#define __PY32F4XX_BSP_CANFILT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANFILT
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Exported_Constants BSP CANFILT Exported Constants
+  * @{
+  */
+#define BSP_CANFILT_CHANNELS            12U            /*!< Acceptance filters of the CANFD           */
+
+#if !defined (BSP_CANFILT_BLOCKS)
+#define BSP_CANFILT_BLOCKS              64U            /*!< Code/mask blocks kept while planning      */
+#endif /* BSP_CANFILT_BLOCKS */
+
+#define BSP_CANFILT_HASH_EMPTY          0xFFFFFFFFU    /*!< Free slot of the hash table               */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Exported_Types BSP CANFILT Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CANFD subscribed identifiers definition
+  */
+typedef struct
+{
+  uint32_t                IdType;       /*!< A value of @ref CANFD_id_type                          */
+
+  uint32_t                First;        /*!< First identifier                                       */
+
+  uint32_t                Last;         /*!< Last identifier, First for a single one                */
+
+} BSP_CANFILT_EntryTypeDef;
+
+/**
+  * @brief  CANFD acceptance filter definition, as programmed
+  */
+typedef struct
+{
+  uint32_t                IdType;       /*!< A value of @ref CANFD_id_type                          */
+
+  uint32_t                Code;         /*!< Identifier bits compared                               */
+
+  uint32_t                Mask;         /*!< Identifier bits ignored, set to 1                      */
+
+} BSP_CANFILT_FilterTypeDef;
+
+/**
+  * @brief  CANFD acceptance filter planner statistics definition
+  */
+typedef struct
+{
+  uint32_t                Filters;      /*!< Acceptance filters programmed                          */
+
+  uint32_t                Wanted;       /*!< Identifiers subscribed                                 */
+
+  uint32_t                Accepted;     /*!< Identifiers passed by the filters, at most             */
+
+  uint32_t                Rejection;    /*!< Unwanted identifiers rejected, per 1000, worst type    */
+
+  uint32_t                Matched;      /*!< Frames found subscribed by BSP_CANFILT_Match()         */
+
+  uint32_t                Residue;      /*!< Frames passed by the filters, then rejected            */
+
+} BSP_CANFILT_StatsTypeDef;
+
+/**
+  * @brief  CANFD acceptance filter planner definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD handle                                           */
+
+  const BSP_CANFILT_EntryTypeDef *pEntries; /*!< Subscribed identifiers, kept for the ranges        */
+
+  uint32_t                NbrOfEntries; /*!< Entries                                                */
+
+  uint32_t                *pHash;       /*!< Single identifiers, open addressing                    */
+
+  uint32_t                HashShift;    /*!< 32 - log2 of the hash table size                       */
+
+  uint32_t                Exact;        /*!< 1 when the filters pass no unwanted identifier         */
+
+  BSP_CANFILT_FilterTypeDef Filters[BSP_CANFILT_CHANNELS]; /*!< Filters, channel order            */
+
+  BSP_CANFILT_StatsTypeDef Stats;       /*!< Statistics                                             */
+
+} BSP_CANFILT_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANFILT_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANFILT_Init(BSP_CANFILT_TypeDef *hfilt, CANFD_HandleTypeDef *hcanfd,
+                                   const BSP_CANFILT_EntryTypeDef *pEntries, uint32_t NbrOfEntries,
+                                   uint32_t *pHash, uint32_t HashSize, uint32_t NbrOfFilters);
+uint32_t          BSP_CANFILT_Match(BSP_CANFILT_TypeDef *hfilt, uint32_t IdType, uint32_t Id);
+void              BSP_CANFILT_GetStats(const BSP_CANFILT_TypeDef *hfilt, BSP_CANFILT_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANFILT_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,210 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canmon.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD bus load monitor BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANMON_H
+#define __PY32F4XX_BSP_CANMON_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANMON
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANMON_Exported_Constants BSP CANMON Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CANMON_State BSP CANMON State
+  * @{
+  */
+#define BSP_CANMON_STATE_RESET          0x00000000U    /*!< Not initialized                           */
+#define BSP_CANMON_STATE_READY          0x00000001U    /*!< Initialized, not counting                 */
+#define BSP_CANMON_STATE_RUN            0x00000002U    /*!< Counting, periods aggregated              */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANMON_Exported_Types BSP CANMON Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CANFD monitor identifier class definition
+  * @note   IdType, First and Last are set before BSP_CANMON_Init().
+  */
+typedef struct
+{
+  uint32_t                IdType;       /*!< A value of @ref CANFD_id_type                          */
+
+  uint32_t                First;        /*!< First identifier of the class                          */
+
+  uint32_t                Last;         /*!< Last identifier of the class                           */
+
+  uint32_t                Frames;       /*!< Frames of the period in progress                       */
+
+  uint32_t                NominalBits;  /*!< Nominal bits of the period in progress                 */
+
+  uint32_t                DataBits;     /*!< Data phase bits of the period in progress              */
+
+  uint32_t                FrameRate;    /*!< Frames per second of the last period                   */
+
+  uint32_t                Load;         /*!< Bus load of the last period, per mille                 */
+
+} BSP_CANMON_ClassTypeDef;
+
+/**
+  * @brief  CANFD monitor statistics definition, of the last period unless noted
+  */
+typedef struct
+{
+  uint32_t                Periods;      /*!< Periods aggregated                                     */
+
+  uint32_t                RxFrames;     /*!< Frames received                                        */
+
+  uint32_t                TxFrames;     /*!< Frames sent                                            */
+
+  uint32_t                FrameRate;    /*!< Frames per second, both directions                     */
+
+  uint32_t                Load;         /*!< Bus load, per mille                                    */
+
+  uint32_t                LoadMax;      /*!< Highest bus load of all the periods, per mille         */
+
+  uint32_t                ArbLost;      /*!< Arbitrations lost                                      */
+
+  uint32_t                ArbLostRate;  /*!< Arbitrations lost per mille of the transmit attempts   */
+
+  uint32_t                BusErrors;    /*!< Bus errors                                             */
+
+  uint32_t                BusOffs;      /*!< Bus-off entries of all the periods                     */
+
+  uint32_t                TxErrorCnt;   /*!< Transmit error counter at the end of the period        */
+
+  uint32_t                RxErrorCnt;   /*!< Receive error counter at the end of the period         */
+
+  int32_t                 TxErrorTrend; /*!< Transmit error counter change over the period          */
+
+  int32_t                 RxErrorTrend; /*!< Receive error counter change over the period           */
+
+  uint32_t                TxErrorMax;   /*!< Highest transmit error counter of all the periods      */
+
+  uint32_t                RxErrorMax;   /*!< Highest receive error counter of all the periods       */
+
+  uint32_t                ErrorPassive; /*!< Error passive at the end of the period                 */
+
+  uint32_t                LastErrorCode; /*!< Last error code, @ref CANFD_protocol_error_type      */
+
+} BSP_CANMON_StatsTypeDef;
+
+/**
+  * @brief  CANFD monitor definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD handle                                           */
+
+  uint32_t                NominalBitrate; /*!< Nominal bitrate, bit/s                               */
+
+  uint32_t                DataBitrate;  /*!< Data bitrate of the FD frames with BRS, bit/s          */
+
+  uint32_t                Period;       /*!< Aggregation period, ms                                 */
+
+  BSP_CANMON_ClassTypeDef *pClasses;    /*!< Identifier classes, the first match counted            */
+
+  uint32_t                NbrOfClasses; /*!< Identifier classes                                     */
+
+  uint32_t                Tick;         /*!< HAL tick of the start of the period in progress        */
+
+  uint32_t                RxFrames;     /*!< Frames received in the period in progress              */
+
+  uint32_t                TxFrames;     /*!< Frames sent in the period in progress                  */
+
+  uint32_t                NominalBits;  /*!< Nominal bits of the period in progress                 */
+
+  uint32_t                DataBits;     /*!< Data phase bits of the period in progress              */
+
+  uint32_t                ArbLost;      /*!< Arbitrations lost in the period in progress            */
+
+  uint32_t                BusErrors;    /*!< Bus errors in the period in progress                   */
+
+  BSP_CANMON_StatsTypeDef Stats;        /*!< Statistics                                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CANMON_State                       */
+
+} BSP_CANMON_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANMON_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANMON_Init(BSP_CANMON_TypeDef *hmon, CANFD_HandleTypeDef *hcanfd,
+                                  uint32_t NominalBitrate, uint32_t DataBitrate, uint32_t Period,
+                                  BSP_CANMON_ClassTypeDef *pClasses, uint32_t NbrOfClasses);
+HAL_StatusTypeDef BSP_CANMON_Start(BSP_CANMON_TypeDef *hmon);
+HAL_StatusTypeDef BSP_CANMON_Stop(BSP_CANMON_TypeDef *hmon);
+void              BSP_CANMON_RxFrame(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format);
+void              BSP_CANMON_TxFrame(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format);
+void              BSP_CANMON_ArbLostHandler(BSP_CANMON_TypeDef *hmon);
+void              BSP_CANMON_BusErrorHandler(BSP_CANMON_TypeDef *hmon);
+void              BSP_CANMON_ErrorChangeHandler(BSP_CANMON_TypeDef *hmon);
+uint32_t          BSP_CANMON_Process(BSP_CANMON_TypeDef *hmon);
+void              BSP_CANMON_GetStats(const BSP_CANMON_TypeDef *hmon, BSP_CANMON_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANMON_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
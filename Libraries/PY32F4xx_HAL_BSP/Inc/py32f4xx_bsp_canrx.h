@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canrx.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD receive queue BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANRX_H
+#define __PY32F4XX_BSP_CANRX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANRX
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Exported_Constants BSP CANRX Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CANRX_State BSP CANRX State
+  * @{
+  */
+#define BSP_CANRX_STATE_RESET           0x00000000U    /*!< Not initialized                           */
+#define BSP_CANRX_STATE_READY           0x00000001U    /*!< Pool set, reception interrupts off        */
+#define BSP_CANRX_STATE_RUN             0x00000002U    /*!< Frames drained on each interrupt          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Exported_Types BSP CANRX Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CANFD received frame definition, the words of the receive buffer
+  */
+typedef struct
+{
+  uint32_t                Id;           /*!< RBUF.ID, BSP_CANRX_GET_ID() for the identifier         */
+
+  uint32_t                Format;       /*!< RBUF.FORMAT, @ref CANFD_LLC_FORMAT_BITS                */
+
+  uint32_t                Data[16];     /*!< Payload, BSP_CANRX_GET_LENGTH() bytes                  */
+
+} BSP_CANRX_FrameTypeDef;
+
+/**
+  * @brief  CANFD receive queue statistics definition
+  */
+typedef struct
+{
+  uint32_t                Received;     /*!< Frames queued                                          */
+
+  uint32_t                Dropped;      /*!< Frames read from the FIFO with the pool full           */
+
+  uint32_t                Overflows;    /*!< Frames lost by the FIFO, ROIF seen                     */
+
+  uint32_t                HighWatermark; /*!< Most frames waiting in the pool                       */
+
+  uint32_t                MaxBurst;     /*!< Most frames drained by one interrupt                   */
+
+} BSP_CANRX_StatsTypeDef;
+
+/**
+  * @brief  CANFD receive queue definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD handle, its reception owned by the service       */
+
+  BSP_CANRX_FrameTypeDef  *pPool;       /*!< Frames of the pool, used in order                      */
+
+  uint32_t                Size;         /*!< Frames of the pool, a power of 2                       */
+
+  __IO uint32_t           Head;         /*!< Frames written by the interrupt                        */
+
+  __IO uint32_t           Tail;         /*!< Frames released by the consumer                        */
+
+  BSP_CANRX_StatsTypeDef  Stats;        /*!< Statistics                                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CANRX_State                        */
+
+} BSP_CANRX_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Exported_Macros BSP CANRX Exported Macros
+  * @{
+  */
+#define BSP_CANRX_IS_EXTENDED(__FRAME__)    (((__FRAME__)->Format & CANFD_LLC_FORMAT_IDE) != 0U)
+#define BSP_CANRX_IS_FD(__FRAME__)          (((__FRAME__)->Format & CANFD_LLC_FORMAT_FDF) != 0U)
+#define BSP_CANRX_IS_REMOTE(__FRAME__)      (((__FRAME__)->Format & CANFD_LLC_FORMAT_RMF) != 0U)
+#define BSP_CANRX_GET_DLC(__FRAME__)        ((__FRAME__)->Format & CANFD_LLC_FORMAT_DLC)
+#define BSP_CANRX_GET_ID(__FRAME__)         (BSP_CANRX_IS_EXTENDED(__FRAME__) ?                          \
+                                             ((__FRAME__)->Id & 0x1FFFFFFFU) :                          \
+                                             (((__FRAME__)->Id >> 18U) & 0x7FFU))
+#define BSP_CANRX_GET_LENGTH(__FRAME__)     BSP_CANRX_DlcToBytes(BSP_CANRX_GET_DLC(__FRAME__))
+#define BSP_CANRX_GET_DATA(__FRAME__)       ((const uint8_t *)(__FRAME__)->Data)
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANRX_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANRX_Init(BSP_CANRX_TypeDef *hrx, CANFD_HandleTypeDef *hcanfd,
+                                 BSP_CANRX_FrameTypeDef *pPool, uint32_t Size);
+HAL_StatusTypeDef BSP_CANRX_Start(BSP_CANRX_TypeDef *hrx);
+HAL_StatusTypeDef BSP_CANRX_Stop(BSP_CANRX_TypeDef *hrx);
+void              BSP_CANRX_IRQHandler(BSP_CANRX_TypeDef *hrx);
+const BSP_CANRX_FrameTypeDef *BSP_CANRX_Peek(const BSP_CANRX_TypeDef *hrx);
+void              BSP_CANRX_Release(BSP_CANRX_TypeDef *hrx);
+uint32_t          BSP_CANRX_GetCount(const BSP_CANRX_TypeDef *hrx);
+void              BSP_CANRX_GetStats(const BSP_CANRX_TypeDef *hrx, BSP_CANRX_StatsTypeDef *pStats);
+uint32_t          BSP_CANRX_DlcToBytes(uint32_t Dlc);
+void              BSP_CANRX_RxCallback(BSP_CANRX_TypeDef *hrx);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANRX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,219 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_cansync.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD time synchronization BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANSYNC_H
+#define __PY32F4XX_BSP_CANSYNC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANSYNC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Exported_Constants BSP CANSYNC Exported Constants
+  * @{
+  */
+#ifndef BSP_CANSYNC_STEP_NS
+#define BSP_CANSYNC_STEP_NS             1000000        /*!< Offset set at once above it, the clock stepped  */
+#endif
+
+#ifndef BSP_CANSYNC_LOCK_NS
+#define BSP_CANSYNC_LOCK_NS             5000           /*!< Offset of a sample counted for the lock         */
+#endif
+
+#ifndef BSP_CANSYNC_LOCK_COUNT
+#define BSP_CANSYNC_LOCK_COUNT          4U             /*!< Samples in a row under BSP_CANSYNC_LOCK_NS      */
+#endif
+
+#ifndef BSP_CANSYNC_OUTLIER_NS
+#define BSP_CANSYNC_OUTLIER_NS          20000          /*!< Offset of a sample skipped once locked          */
+#endif
+
+#ifndef BSP_CANSYNC_OUTLIER_MAX
+#define BSP_CANSYNC_OUTLIER_MAX         3U             /*!< Samples skipped in a row before the lock is lost */
+#endif
+
+#ifndef BSP_CANSYNC_PPB_MAX
+#define BSP_CANSYNC_PPB_MAX             500000         /*!< Largest rate correction, 500 ppm                */
+#endif
+
+/** @defgroup BSP_CANSYNC_Role BSP CANSYNC Role
+  * @{
+  */
+#define BSP_CANSYNC_ROLE_MASTER         0x00000000U    /*!< Sends the time of the network                   */
+#define BSP_CANSYNC_ROLE_SLAVE          0x00000001U    /*!< Follows the time of the master                  */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CANSYNC_State BSP CANSYNC State
+  * @{
+  */
+#define BSP_CANSYNC_STATE_RESET         0x00000000U    /*!< Not started                                     */
+#define BSP_CANSYNC_STATE_UNSYNC        0x00000001U    /*!< No sample yet, the clock free running           */
+#define BSP_CANSYNC_STATE_LOCKING       0x00000002U    /*!< Clock stepped, the rate converging              */
+#define BSP_CANSYNC_STATE_LOCKED        0x00000003U    /*!< Offset under BSP_CANSYNC_LOCK_NS, the master
+                                                            always                                          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Exported_Types BSP CANSYNC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Statistics definition
+  */
+typedef struct
+{
+  uint32_t                Syncs;        /*!< SYNC frames sent or stamped                            */
+
+  uint32_t                FollowUps;    /*!< FOLLOW_UP frames sent or received                      */
+
+  uint32_t                Samples;      /*!< Samples given to the servo                             */
+
+  uint32_t                Missed;       /*!< SYNC without FOLLOW_UP, or not sent in a period        */
+
+  uint32_t                Outliers;     /*!< Samples skipped, above BSP_CANSYNC_OUTLIER_NS          */
+
+  uint32_t                Steps;        /*!< Clock steps                                            */
+
+  int32_t                 Offset;       /*!< Offset of the last sample in ns, master minus local    */
+
+  uint32_t                OffsetMax;    /*!< Largest offset seen locked, in ns                      */
+
+  int32_t                 Ppb;          /*!< Rate correction of the local clock                     */
+
+} BSP_CANSYNC_StatsTypeDef;
+
+/**
+  * @brief  CANFD time synchronization definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD started, its PTB owned by the master             */
+
+  uint32_t                Role;         /*!< A value of @ref BSP_CANSYNC_Role                       */
+
+  uint32_t                SyncId;       /*!< Standard identifier of SYNC                            */
+
+  uint32_t                FollowUpId;   /*!< Standard identifier of FOLLOW_UP                       */
+
+  uint32_t                Period;       /*!< CPU cycles between two SYNC of the master              */
+
+  int32_t                 Delay;        /*!< ns from the master stamp to the slave stamp            */
+
+  uint64_t                Nominal;      /*!< ns per CPU cycle of the nominal clock, Q32             */
+
+  uint64_t                Scale;        /*!< ns per CPU cycle, rate corrected, Q32                  */
+
+  uint64_t                AnchorLocal;  /*!< CPU cycle of the anchor                                */
+
+  uint64_t                AnchorTime;   /*!< Time of the network at the anchor, ns                  */
+
+  uint32_t                Last;         /*!< DWT cycle counter at the last read                     */
+
+  uint32_t                High;         /*!< Wraps of the DWT cycle counter, bits 63:32 of a cycle  */
+
+  uint64_t                NextSync;     /*!< CPU cycle of the next SYNC of the master               */
+
+  __IO uint32_t           TxState;      /*!< Frame of the master in the PTB                         */
+
+  uint64_t                TxStamp;      /*!< CPU cycle of the end of the last SYNC sent             */
+
+  uint32_t                Sequence;     /*!< Sequence of the SYNC sent or followed                  */
+
+  uint64_t                RxStamp;      /*!< CPU cycle of the end of the last SYNC received         */
+
+  __IO uint32_t           RxSequence;   /*!< Sequence of the SYNC received                          */
+
+  __IO uint32_t           RxStamped;    /*!< RxStamp waits for its FOLLOW_UP                        */
+
+  uint64_t                PrevTime;     /*!< Time of the master of the previous sample              */
+
+  int32_t                 Drift;        /*!< Integral of the servo, ppb                             */
+
+  uint32_t                Good;         /*!< Samples in a row under BSP_CANSYNC_LOCK_NS             */
+
+  uint32_t                Skipped;      /*!< Outliers in a row                                      */
+
+  BSP_CANSYNC_StatsTypeDef Stats;       /*!< Statistics                                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CANSYNC_State                      */
+
+} BSP_CANSYNC_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANSYNC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANSYNC_Init(BSP_CANSYNC_TypeDef *hsync, CANFD_HandleTypeDef *hcanfd, uint32_t Role,
+                                   uint32_t SyncId, uint32_t FollowUpId, uint32_t PeriodMs, int32_t DelayNs);
+HAL_StatusTypeDef BSP_CANSYNC_Start(BSP_CANSYNC_TypeDef *hsync);
+void              BSP_CANSYNC_IRQHandler(BSP_CANSYNC_TypeDef *hsync);
+void              BSP_CANSYNC_RxFrame(BSP_CANSYNC_TypeDef *hsync, uint32_t Id, const uint8_t *pData,
+                                      uint32_t Length);
+void              BSP_CANSYNC_Process(BSP_CANSYNC_TypeDef *hsync);
+uint64_t          BSP_CANSYNC_GetTime(BSP_CANSYNC_TypeDef *hsync);
+uint64_t          BSP_CANSYNC_CyclesToTime(BSP_CANSYNC_TypeDef *hsync, uint32_t Cycles);
+void              BSP_CANSYNC_GetStats(const BSP_CANSYNC_TypeDef *hsync, BSP_CANSYNC_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANSYNC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_cantx.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD transmit scheduler BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CANTX_H
+#define __PY32F4XX_BSP_CANTX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CANTX
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CANTX_Exported_Constants BSP CANTX Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CANTX_Priority BSP CANTX Priority
+  * @{
+  */
+#define BSP_CANTX_PRIORITY_URGENT       0x00000000U    /*!< Sent from the PTB, ahead of the STB       */
+#define BSP_CANTX_PRIORITY_HIGH         0x00000001U    /*!< First loaded into the STB                 */
+#define BSP_CANTX_PRIORITY_NORMAL       0x00000002U    /*!< Loaded into the STB after HIGH            */
+#define BSP_CANTX_PRIORITY_LOW          0x00000003U    /*!< Loaded into the STB last                  */
+#define BSP_CANTX_PRIORITIES            4U
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CANTX_State BSP CANTX State
+  * @{
+  */
+#define BSP_CANTX_STATE_RESET           0x00000000U    /*!< Not initialized                           */
+#define BSP_CANTX_STATE_READY           0x00000001U    /*!< Queues set, transmit interrupts off       */
+#define BSP_CANTX_STATE_RUN             0x00000002U    /*!< Buffers refilled on each completion       */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CANTX_Exported_Types BSP CANTX Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CANFD queued frame definition
+  */
+typedef struct
+{
+  CANFD_TxHeaderTypeDef   Header;       /*!< Header given to HAL_CANFD_AddMessageToTxFifo()         */
+
+  uint32_t                Data[16];     /*!< Payload                                                */
+
+} BSP_CANTX_FrameTypeDef;
+
+/**
+  * @brief  CANFD transmit queue statistics definition
+  */
+typedef struct
+{
+  uint32_t                Queued;       /*!< Frames accepted by BSP_CANTX_Send()                    */
+
+  uint32_t                Loaded;       /*!< Frames written to the PTB or the STB                   */
+
+  uint32_t                Rejected;     /*!< Frames refused with the queue full                     */
+
+  uint32_t                Depth;        /*!< Frames waiting in the queue                            */
+
+  uint32_t                HighWatermark; /*!< Most frames waiting in the queue                      */
+
+} BSP_CANTX_StatsTypeDef;
+
+/**
+  * @brief  CANFD transmit queue definition
+  */
+typedef struct
+{
+  BSP_CANTX_FrameTypeDef  *pFrames;     /*!< Frames of the queue                                    */
+
+  uint32_t                Size;         /*!< Frames of the queue, a power of 2                      */
+
+  __IO uint32_t           Head;         /*!< Frames written by BSP_CANTX_Send()                     */
+
+  __IO uint32_t           Tail;         /*!< Frames loaded into the CANFD                           */
+
+  BSP_CANTX_StatsTypeDef  Stats;        /*!< Statistics, Depth updated on read                      */
+
+} BSP_CANTX_QueueTypeDef;
+
+/**
+  * @brief  CANFD transmit scheduler definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD handle, its transmission owned by the service    */
+
+  BSP_CANTX_QueueTypeDef  Queue[BSP_CANTX_PRIORITIES]; /*!< Queues, @ref BSP_CANTX_Priority order   */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CANTX_State                        */
+
+} BSP_CANTX_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CANTX_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CANTX_Init(BSP_CANTX_TypeDef *htx, CANFD_HandleTypeDef *hcanfd);
+HAL_StatusTypeDef BSP_CANTX_ConfigQueue(BSP_CANTX_TypeDef *htx, uint32_t Priority,
+                                        BSP_CANTX_FrameTypeDef *pFrames, uint32_t Size);
+HAL_StatusTypeDef BSP_CANTX_Start(BSP_CANTX_TypeDef *htx);
+HAL_StatusTypeDef BSP_CANTX_Stop(BSP_CANTX_TypeDef *htx);
+HAL_StatusTypeDef BSP_CANTX_Send(BSP_CANTX_TypeDef *htx, uint32_t Priority,
+                                 const CANFD_TxHeaderTypeDef *pHeader, const uint8_t *pData);
+void              BSP_CANTX_TxCpltHandler(BSP_CANTX_TypeDef *htx);
+void              BSP_CANTX_GetStats(BSP_CANTX_TypeDef *htx, uint32_t Priority, BSP_CANTX_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CANTX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_clkswitch.h
+  * @author  MCU Application Team
+  * @brief   Header file of the clock switch notification BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CLKSWITCH_H
+#define __PY32F4XX_BSP_CLKSWITCH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CLKSWITCH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Exported_Constants BSP CLKSWITCH Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CLKSWITCH_Event BSP CLKSWITCH Event
+  * @{
+  */
+#define BSP_CLKSWITCH_EVENT_PRE         0x00000000U    /*!< Before the switch, HAL_BUSY defers it     */
+#define BSP_CLKSWITCH_EVENT_ABORT       0x00000001U    /*!< Switch deferred after the PRE event       */
+#define BSP_CLKSWITCH_EVENT_POST        0x00000002U    /*!< After the switch, the new PCLKs read      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Exported_Types BSP CLKSWITCH Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Clock switch notifier definition
+  */
+typedef struct __BSP_CLKSWITCH_NotifierTypeDef
+{
+  HAL_StatusTypeDef       (*Callback)(struct __BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event);
+                                        /*!< Called with a value of @ref BSP_CLKSWITCH_Event        */
+
+  void                    *pHandle;     /*!< Handle of the peripheral                               */
+
+  uint32_t                Rate;         /*!< Rate kept over the switch, recorded on the PRE event   */
+
+  struct __BSP_CLKSWITCH_NotifierTypeDef *pNext; /*!< Next notifier, owned by the service           */
+
+} BSP_CLKSWITCH_NotifierTypeDef;
+
+/**
+  * @brief  Clock switch statistics definition
+  */
+typedef struct
+{
+  uint32_t                Switches;     /*!< Switches notified                                      */
+
+  uint32_t                Deferred;     /*!< Switches deferred by a notifier                        */
+
+  uint32_t                Failures;     /*!< POST events failing to derive a rate again             */
+
+  uint32_t                Cycles;       /*!< CPU cycles of the last switch, PRE to POST             */
+
+} BSP_CLKSWITCH_StatsTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CLKSWITCH_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_Register(BSP_CLKSWITCH_NotifierTypeDef *pNotifier);
+void              BSP_CLKSWITCH_Unregister(BSP_CLKSWITCH_NotifierTypeDef *pNotifier);
+#if defined (HAL_UART_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterUart(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, UART_HandleTypeDef *huart);
+#endif /* HAL_UART_MODULE_ENABLED */
+#if defined (HAL_SPI_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterSpi(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, SPI_HandleTypeDef *hspi);
+#endif /* HAL_SPI_MODULE_ENABLED */
+#if defined (HAL_I2C_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterI2c(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, I2C_HandleTypeDef *hi2c);
+#endif /* HAL_I2C_MODULE_ENABLED */
+#if defined (HAL_TIM_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterTim(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, TIM_HandleTypeDef *htim);
+#endif /* HAL_TIM_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_CLKSWITCH_Prepare(void);
+HAL_StatusTypeDef BSP_CLKSWITCH_Complete(void);
+HAL_StatusTypeDef BSP_CLKSWITCH_ClockConfig(const RCC_ClkInitTypeDef *pClkInit, uint32_t FLatency);
+void              BSP_CLKSWITCH_GetStats(BSP_CLKSWITCH_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CLKSWITCH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
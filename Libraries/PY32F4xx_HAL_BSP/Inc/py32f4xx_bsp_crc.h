@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crc.h
+  * @author  MCU Application Team
+  * @brief   Header file of the parametric CRC BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CRC_H
+#define __PY32F4XX_BSP_CRC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#ifdef HAL_CRC_MODULE_ENABLED
+#include "py32f4xx_bsp_crcmux.h"
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CRC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CRC_Exported_Constants BSP CRC Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CRC_Path BSP CRC Path
+  * @{
+  */
+#define BSP_CRC_PATH_BITWISE            0x00000000U    /*!< One bit per step, no table                */
+#define BSP_CRC_PATH_TABLE              0x00000001U    /*!< Tables of 256 entries, 1, 4 or 8 bytes per step */
+#define BSP_CRC_PATH_HARDWARE           0x00000002U    /*!< CRC calculator, through a BSP_CRCMUX session */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CRC_Exported_Types BSP CRC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CRC model definition, the parameters of the CRC catalogues
+  */
+typedef struct
+{
+  uint32_t                Width;        /*!< CRC size in bits, 1 to 32                              */
+
+  uint32_t                Poly;         /*!< Generating polynomial, without the X^Width term        */
+
+  uint32_t                Init;         /*!< Initial value, not reflected                           */
+
+  uint32_t                RefIn;        /*!< 1 for the bytes taken least significant bit first      */
+
+  uint32_t                RefOut;       /*!< 1 for the CRC reflected before XorOut                  */
+
+  uint32_t                XorOut;       /*!< Value XORed with the final CRC                         */
+
+} BSP_CRC_ModelTypeDef;
+
+/**
+  * @brief  CRC lookup table, one per byte of a step
+  */
+typedef uint32_t BSP_CRC_TableTypeDef[256];
+
+/**
+  * @brief  CRC computation definition
+  */
+typedef struct
+{
+  const BSP_CRC_ModelTypeDef *pModel;   /*!< Parameters of the CRC                                  */
+
+  const BSP_CRC_TableTypeDef *pTable;   /*!< Tables built by BSP_CRC_Init(), NULL for the bitwise path */
+
+  uint32_t                Slices;       /*!< Tables, bytes per step of the table path               */
+
+  uint32_t                Path;         /*!< A value of @ref BSP_CRC_Path                           */
+
+  uint32_t                Value;        /*!< Running register, reflected or left aligned, the CRC
+                                             before XorOut on the hardware path                     */
+
+#ifdef HAL_CRC_MODULE_ENABLED
+  BSP_CRCMUX_SessionTypeDef Session;    /*!< Session of the hardware path                           */
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+} BSP_CRC_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_CRC_Exported_Variables BSP CRC Exported Variables
+  * @brief    Common models, check value of "123456789" in the comment
+  * @{
+  */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32;        /*!< Ethernet, zlib, 0xCBF43926     */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32C;       /*!< Castagnoli, iSCSI, 0xE3069283  */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32_MPEG2;  /*!< CRC peripheral, 0x0376E6E7     */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_MODBUS; /*!< 0x4B37                         */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_CCITT;  /*!< CCITT-FALSE, IBM-3740, 0x29B1  */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_XMODEM; /*!< 0x31C3                         */
+extern const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC8;         /*!< SMBus, 0xF4                    */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CRC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CRC_Init(BSP_CRC_TypeDef *hcrcsw, const BSP_CRC_ModelTypeDef *pModel,
+                               BSP_CRC_TableTypeDef *pTable, uint32_t Slices);
+#ifdef HAL_CRC_MODULE_ENABLED
+HAL_StatusTypeDef BSP_CRC_AttachHardware(BSP_CRC_TypeDef *hcrcsw, BSP_CRCMUX_TypeDef *hmux);
+#endif /* HAL_CRC_MODULE_ENABLED */
+void              BSP_CRC_Reset(BSP_CRC_TypeDef *hcrcsw);
+HAL_StatusTypeDef BSP_CRC_Update(BSP_CRC_TypeDef *hcrcsw, const uint8_t *pData, uint32_t Length);
+uint32_t          BSP_CRC_Final(const BSP_CRC_TypeDef *hcrcsw);
+HAL_StatusTypeDef BSP_CRC_Compute(BSP_CRC_TypeDef *hcrcsw, const uint8_t *pData, uint32_t Length,
+                                  uint32_t *pCrc);
+uint32_t          BSP_CRC_Bitwise(const BSP_CRC_ModelTypeDef *pModel, const uint8_t *pData, uint32_t Length);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CRC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
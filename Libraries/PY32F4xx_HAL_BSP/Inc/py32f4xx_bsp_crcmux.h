@@ -0,0 +1,129 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crcmux.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CRC sharing BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CRCMUX_H
+#define __PY32F4XX_BSP_CRCMUX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_CRC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CRCMUX
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CRCMUX_Exported_Types BSP CRCMUX Exported Types
+  * @{
+  */
+
+struct __BSP_CRCMUX_SessionTypeDef;
+
+/**
+  * @brief  Shared CRC definition
+  */
+typedef struct
+{
+  CRC_HandleTypeDef       *hcrc;        /*!< CRC shared by the sessions                             */
+
+  struct __BSP_CRCMUX_SessionTypeDef *pOwner; /*!< Session whose context is in the CRC, NULL for none */
+
+  __IO uint32_t           Depth;        /*!< Sessions running, more than 1 when an interrupt preempts one */
+
+  uint32_t                Switches;     /*!< Context switches, for the statistics                   */
+
+} BSP_CRCMUX_TypeDef;
+
+/**
+  * @brief  CRC session definition
+  */
+typedef struct __BSP_CRCMUX_SessionTypeDef
+{
+  BSP_CRCMUX_TypeDef      *hmux;        /*!< Shared CRC, NULL when closed                           */
+
+  CRC_ContextTypeDef      Context;      /*!< Configuration and running value, up to date when the
+                                             session does not own the CRC                           */
+
+} BSP_CRCMUX_SessionTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CRCMUX_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_CRCMUX_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_CRCMUX_Init(BSP_CRCMUX_TypeDef *hmux, CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef BSP_CRCMUX_Open(BSP_CRCMUX_TypeDef *hmux, BSP_CRCMUX_SessionTypeDef *hsession,
+                                  const CRC_InitTypeDef *pInit, uint32_t InputDataFormat);
+void              BSP_CRCMUX_Close(BSP_CRCMUX_SessionTypeDef *hsession);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CRCMUX_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+void              BSP_CRCMUX_Reset(BSP_CRCMUX_SessionTypeDef *hsession);
+HAL_StatusTypeDef BSP_CRCMUX_Accumulate(BSP_CRCMUX_SessionTypeDef *hsession, uint32_t pBuffer[],
+                                        uint32_t BufferLength, uint32_t *pCrc);
+HAL_StatusTypeDef BSP_CRCMUX_Calculate(BSP_CRCMUX_SessionTypeDef *hsession, uint32_t pBuffer[],
+                                       uint32_t BufferLength, uint32_t *pCrc);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CRCMUX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
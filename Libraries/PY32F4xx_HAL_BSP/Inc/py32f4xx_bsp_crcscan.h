@@ -0,0 +1,149 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crcscan.h
+  * @author  MCU Application Team
+  * @brief   Header file of the background memory integrity scan BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CRCSCAN_H
+#define __PY32F4XX_BSP_CRCSCAN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CRC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CRCSCAN
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CRCSCAN_Exported_Constants BSP CRCSCAN Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CRCSCAN_State BSP CRCSCAN State
+  * @{
+  */
+#define BSP_CRCSCAN_STATE_RESET         0x00000000U    /*!< Not initialized                           */
+#define BSP_CRCSCAN_STATE_READY         0x00000001U    /*!< No scan running                           */
+#define BSP_CRCSCAN_STATE_RUN           0x00000002U    /*!< Scan running, one slice per Process call  */
+#define BSP_CRCSCAN_STATE_DONE          0x00000003U    /*!< Scan complete, Crc holds the result       */
+#define BSP_CRCSCAN_STATE_ERROR         0x00000004U    /*!< DMA error, the scan is stopped            */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CRCSCAN_Exported_Types BSP CRCSCAN Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Memory integrity scan state definition
+  */
+typedef struct
+{
+  CRC_HandleTypeDef       *hcrc;        /*!< CRC fed by the scan, taken while a slice runs          */
+
+  DMA_HandleTypeDef       *hdma;        /*!< Memory to memory DMA channel, owned by the scan        */
+
+  uint32_t                Address;      /*!< First word scanned                                     */
+
+  uint32_t                Size;         /*!< Words scanned                                          */
+
+  uint32_t                SliceSize;    /*!< Words per DMA transfer, 1 to 0xFFFF                    */
+
+  uint32_t                Offset;       /*!< Words fed to the CRC in the running scan               */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CRCSCAN_State                      */
+
+  __IO uint32_t           Busy;         /*!< A slice transfer runs                                  */
+
+  uint32_t                Value;        /*!< CRC of the words fed in the running scan               */
+
+  CRC_ContextTypeDef      Suspended;    /*!< Context of the other CRC users while a slice runs      */
+
+  uint32_t                Crc;          /*!< Result of the last complete scan                       */
+
+  uint32_t                ScanCount;    /*!< Number of complete scans                               */
+
+} BSP_CRCSCAN_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CRCSCAN_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_CRCSCAN_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_CRCSCAN_Init(BSP_CRCSCAN_TypeDef *hscan, CRC_HandleTypeDef *hcrc, DMA_HandleTypeDef *hdma,
+                                   uint32_t Address, uint32_t Size, uint32_t SliceSize);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CRCSCAN_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+HAL_StatusTypeDef BSP_CRCSCAN_Start(BSP_CRCSCAN_TypeDef *hscan);
+uint32_t          BSP_CRCSCAN_Process(BSP_CRCSCAN_TypeDef *hscan);
+HAL_StatusTypeDef BSP_CRCSCAN_Stop(BSP_CRCSCAN_TypeDef *hscan);
+void              BSP_CRCSCAN_CpltCallback(BSP_CRCSCAN_TypeDef *hscan, uint32_t Crc);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CRCSCAN_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ctctrim.h
+  * @author  MCU Application Team
+  * @brief   Header file of the HSI48M trimming BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CTCTRIM_H
+#define __PY32F4XX_BSP_CTCTRIM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CTC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CTCTRIM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CTCTRIM_Exported_Constants BSP CTCTRIM Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_CTCTRIM_Mode BSP CTCTRIM Mode
+  * @{
+  */
+#define BSP_CTCTRIM_MODE_HARDWARE       0x00000000U    /*!< Trim value updated by the CTC             */
+#define BSP_CTCTRIM_MODE_SOFTWARE       0x00000001U    /*!< Trim value updated by the interrupt, in
+                                                            the window of BSP_CTCTRIM_SetWindow()     */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CTCTRIM_State BSP CTCTRIM State
+  * @{
+  */
+#define BSP_CTCTRIM_STATE_RESET         0x00000000U    /*!< Not initialized                           */
+#define BSP_CTCTRIM_STATE_READY         0x00000001U    /*!< CTC configured, stopped                   */
+#define BSP_CTCTRIM_STATE_ACQUIRE       0x00000002U    /*!< Trimming, not converged yet               */
+#define BSP_CTCTRIM_STATE_LOCKED        0x00000003U    /*!< Error in the limit on the last periods    */
+#define BSP_CTCTRIM_STATE_NOREF         0x00000004U    /*!< Reference pulse missed, trim value kept   */
+/**
+  * @}
+  */
+
+#if !defined (BSP_CTCTRIM_HSI48M_VALUE)
+#define BSP_CTCTRIM_HSI48M_VALUE        48000000U      /*!< Target of the HSI48M, Hz                  */
+#endif
+
+#if !defined (BSP_CTCTRIM_STEP_PPM)
+#define BSP_CTCTRIM_STEP_PPM            1400U          /*!< Frequency change of one trim step, ppm,
+                                                            the limit is half of it                   */
+#endif
+
+#if !defined (BSP_CTCTRIM_LOCK_PERIODS)
+#define BSP_CTCTRIM_LOCK_PERIODS        8U             /*!< Periods in the limit in a row to lock     */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CTCTRIM_Exported_Types BSP CTCTRIM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  HSI48M trimming statistics definition
+  */
+typedef struct
+{
+  uint32_t                Periods;      /*!< Reference periods measured                             */
+
+  uint32_t                Warnings;     /*!< Periods out of the limit, trimmed                      */
+
+  uint32_t                Errors;       /*!< Periods out of 3 times the limit                       */
+
+  uint32_t                Misses;       /*!< Reference pulses missed                                */
+
+  uint32_t                Saturations;  /*!< Trim value held at an end of its range                 */
+
+  uint32_t                Locks;        /*!< Transitions to BSP_CTCTRIM_STATE_LOCKED                */
+
+  uint32_t                Unlocks;      /*!< Transitions out of BSP_CTCTRIM_STATE_LOCKED            */
+
+} BSP_CTCTRIM_StatsTypeDef;
+
+/**
+  * @brief  HSI48M trimming definition
+  */
+typedef struct
+{
+  CTC_HandleTypeDef       *hctc;        /*!< CTC handle, Init.RefCLKSource, Init.RefCLKDivider and
+                                             Init.RefCLKPolarity set by the application             */
+
+  uint32_t                Mode;         /*!< A value of @ref BSP_CTCTRIM_Mode                       */
+
+  uint32_t                Reload;       /*!< HSI48M cycles of a reference period less one           */
+
+  uint32_t                Limit;        /*!< Error in the limit, HSI48M cycles                      */
+
+  uint32_t                TrimMin;      /*!< Lowest trim value of the software mode                 */
+
+  uint32_t                TrimMax;      /*!< Highest trim value of the software mode                */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CTCTRIM_State                      */
+
+  __IO int32_t            Error;        /*!< Error of the last period, HSI48M cycles, positive fast */
+
+  uint32_t                Good;         /*!< Periods in the limit in a row                          */
+
+  BSP_CTCTRIM_StatsTypeDef Stats;       /*!< Counters since BSP_CTCTRIM_Init()                      */
+
+} BSP_CTCTRIM_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CTCTRIM_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_CTCTRIM_Init(BSP_CTCTRIM_TypeDef *htrim, CTC_HandleTypeDef *hctc, uint32_t Mode,
+                                   uint32_t RefFreq);
+HAL_StatusTypeDef BSP_CTCTRIM_SetWindow(BSP_CTCTRIM_TypeDef *htrim, uint32_t TrimMin, uint32_t TrimMax);
+HAL_StatusTypeDef BSP_CTCTRIM_Start(BSP_CTCTRIM_TypeDef *htrim);
+HAL_StatusTypeDef BSP_CTCTRIM_Stop(BSP_CTCTRIM_TypeDef *htrim);
+uint32_t          BSP_CTCTRIM_GetState(const BSP_CTCTRIM_TypeDef *htrim);
+uint32_t          BSP_CTCTRIM_GetTrim(const BSP_CTCTRIM_TypeDef *htrim);
+int32_t           BSP_CTCTRIM_GetErrorPpm(const BSP_CTCTRIM_TypeDef *htrim);
+void              BSP_CTCTRIM_GetStats(const BSP_CTCTRIM_TypeDef *htrim, BSP_CTCTRIM_StatsTypeDef *pStats);
+void              BSP_CTCTRIM_IRQHandler(BSP_CTCTRIM_TypeDef *htrim);
+void              BSP_CTCTRIM_LockCallback(BSP_CTCTRIM_TypeDef *htrim, uint32_t Locked);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CTC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CTCTRIM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,306 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ctrl.h
+  * @author  MCU Application Team
+  * @brief   Header file of the control loop BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_CTRL_H
+#define __PY32F4XX_BSP_CTRL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_CTRL
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Exported_Constants BSP CTRL Exported Constants
+  * @{
+  */
+#ifndef BSP_CTRL_LEVELS
+#define BSP_CTRL_LEVELS                 4U             /*!< Priority levels, the timer interrupt then
+                                                            one spare IRQ each                        */
+#endif
+
+/** @defgroup BSP_CTRL_Loop_State BSP CTRL Loop State
+  * @{
+  */
+#define BSP_CTRL_LOOP_IDLE              0x00000000U    /*!< Waiting for its next release              */
+#define BSP_CTRL_LOOP_READY             0x00000001U    /*!< Released, waiting for its level           */
+#define BSP_CTRL_LOOP_RUNNING           0x00000002U    /*!< Function in progress                      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Exported_Types BSP CTRL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  PID configuration definition
+  * @note   In physical units for the float controllers. For the Q31 ones the
+  *         setpoint, the measure, the feed-forward and the output are
+  *         normalized to [-1, 1), the gains apply to the normalized values.
+  */
+typedef struct
+{
+  float                   Kp;           /*!< Proportional gain                                      */
+
+  float                   Ki;           /*!< Integral gain, per second                              */
+
+  float                   Kd;           /*!< Derivative gain, in seconds                            */
+
+  float                   Kff;          /*!< Gain of the feed-forward input                         */
+
+  float                   Ts;           /*!< Sampling period of the loop in seconds                 */
+
+  float                   Tf;           /*!< Time constant of the low-pass filter of the derivative
+                                             in seconds, 0 for none                                 */
+
+  float                   OutMin;       /*!< Lowest output                                          */
+
+  float                   OutMax;       /*!< Highest output                                         */
+
+} BSP_CTRL_PID_ConfigTypeDef;
+
+/**
+  * @brief  Float PID controller definition
+  */
+typedef struct
+{
+  float                   Kp;           /*!< Proportional gain                                      */
+
+  float                   Ki;           /*!< Integral gain times Ts                                 */
+
+  float                   Kd;           /*!< Kd / (Tf + Ts)                                         */
+
+  float                   Ad;           /*!< Tf / (Tf + Ts), pole of the derivative filter          */
+
+  float                   Kff;          /*!< Gain of the feed-forward input                         */
+
+  float                   OutMin;       /*!< Lowest output                                          */
+
+  float                   OutMax;       /*!< Highest output                                         */
+
+  float                   Integral;     /*!< Integral term                                          */
+
+  float                   Derivative;   /*!< Filtered derivative term                               */
+
+  float                   PrevMeasure;  /*!< Measure of the previous update                         */
+
+} BSP_CTRL_PID_F32_TypeDef;
+
+/**
+  * @brief  Q31 PID controller definition
+  * @note   The gains are Q31 values scaled by 2^-Shift: the products are
+  *         shifted left by Shift.
+  */
+typedef struct
+{
+  int32_t                 Kp;           /*!< Proportional gain, Q31 scaled by 2^-Shift              */
+
+  int32_t                 Ki;           /*!< Integral gain times Ts, Q31 scaled by 2^-Shift         */
+
+  int32_t                 Kd;           /*!< Kd / (Tf + Ts), Q31 scaled by 2^-Shift                 */
+
+  int32_t                 Ad;           /*!< Tf / (Tf + Ts), Q31                                    */
+
+  int32_t                 Kff;          /*!< Gain of the feed-forward input, Q31 scaled by 2^-Shift */
+
+  uint32_t                Shift;        /*!< Common scale of the gains, 0 to 15                     */
+
+  int32_t                 OutMin;       /*!< Lowest output                                          */
+
+  int32_t                 OutMax;       /*!< Highest output                                         */
+
+  int64_t                 Integral;     /*!< Integral term in Q62 scaled by 2^-Shift, the sum of
+                                             the full products                                      */
+
+  int32_t                 Derivative;   /*!< Filtered derivative term                               */
+
+  int32_t                 PrevMeasure;  /*!< Measure of the previous update                         */
+
+} BSP_CTRL_PID_Q31_TypeDef;
+
+/**
+  * @brief  Float first order low-pass filter definition
+  */
+typedef struct
+{
+  float                   Alpha;        /*!< Ts / (Tc + Ts)                                         */
+
+  float                   State;        /*!< Output                                                 */
+
+} BSP_CTRL_LPF_F32_TypeDef;
+
+/**
+  * @brief  Q31 first order low-pass filter definition
+  */
+typedef struct
+{
+  int32_t                 Alpha;        /*!< Ts / (Tc + Ts), Q31                                    */
+
+  int32_t                 State;        /*!< Output                                                 */
+
+} BSP_CTRL_LPF_Q31_TypeDef;
+
+/**
+  * @brief  Control loop statistics definition
+  * @note   The cycles are counted by the DWT, the time spent in the loops and
+  *         the scheduler interrupt preempting the loop excluded.
+  */
+typedef struct
+{
+  uint32_t                Runs;         /*!< Runs completed                                         */
+
+  uint32_t                Overruns;     /*!< Releases dropped, the previous run not completed       */
+
+  uint32_t                OverBudget;   /*!< Runs longer than the budget                            */
+
+  uint32_t                Last;         /*!< Cycles of the last run                                 */
+
+  uint32_t                Max;          /*!< Cycles of the longest run                              */
+
+  uint64_t                Total;        /*!< Cycles of all the runs                                 */
+
+  uint32_t                MaxResponse;  /*!< Longest cycles from the release to the end of a run,
+                                             the preemptions included                               */
+
+} BSP_CTRL_StatsTypeDef;
+
+/**
+  * @brief  Control loop definition
+  * @note   Linked in the scheduler by BSP_CTRL_SchedAddLoop(), it must stay
+  *         valid until BSP_CTRL_SchedInit() is called again.
+  */
+typedef struct __BSP_CTRL_LoopTypeDef
+{
+  struct __BSP_CTRL_LoopTypeDef *pNext; /*!< Next loop, by increasing period                        */
+
+  void                    (*Function)(struct __BSP_CTRL_LoopTypeDef *pLoop); /*!< Loop step, run
+                                             at the priority of its level                           */
+
+  void                    *pContext;    /*!< User data of the function                              */
+
+  uint32_t                Period;       /*!< Period in timer updates                                */
+
+  uint32_t                Countdown;    /*!< Timer updates to the next release                      */
+
+  uint32_t                Budget;       /*!< Most cycles of a run, 0 for no check                   */
+
+  uint32_t                Level;        /*!< Priority level, given by the rate at the start         */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_CTRL_Loop_State                    */
+
+  uint32_t                Release;      /*!< DWT cycle counter at the release                       */
+
+  BSP_CTRL_StatsTypeDef   Stats;        /*!< Statistics                                             */
+
+} BSP_CTRL_LoopTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_CTRL_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_CTRL_Exported_Functions_Group1
+  * @{
+  */
+/* Controller functions *******************************************************/
+HAL_StatusTypeDef BSP_CTRL_PID_F32_Init(BSP_CTRL_PID_F32_TypeDef *hpid, const BSP_CTRL_PID_ConfigTypeDef *pConfig);
+void              BSP_CTRL_PID_F32_Reset(BSP_CTRL_PID_F32_TypeDef *hpid, float Measure, float Output);
+float             BSP_CTRL_PID_F32_Update(BSP_CTRL_PID_F32_TypeDef *hpid, float Setpoint, float Measure,
+                                          float FeedForward);
+HAL_StatusTypeDef BSP_CTRL_PID_Q31_Init(BSP_CTRL_PID_Q31_TypeDef *hpid, const BSP_CTRL_PID_ConfigTypeDef *pConfig);
+void              BSP_CTRL_PID_Q31_Reset(BSP_CTRL_PID_Q31_TypeDef *hpid, int32_t Measure, int32_t Output);
+int32_t           BSP_CTRL_PID_Q31_Update(BSP_CTRL_PID_Q31_TypeDef *hpid, int32_t Setpoint, int32_t Measure,
+                                          int32_t FeedForward);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CTRL_Exported_Functions_Group2
+  * @{
+  */
+/* Filter functions ***********************************************************/
+HAL_StatusTypeDef BSP_CTRL_LPF_F32_Init(BSP_CTRL_LPF_F32_TypeDef *hlpf, float Ts, float Tc, float Initial);
+float             BSP_CTRL_LPF_F32_Process(BSP_CTRL_LPF_F32_TypeDef *hlpf, float Input);
+HAL_StatusTypeDef BSP_CTRL_LPF_Q31_Init(BSP_CTRL_LPF_Q31_TypeDef *hlpf, float Ts, float Tc, int32_t Initial);
+int32_t           BSP_CTRL_LPF_Q31_Process(BSP_CTRL_LPF_Q31_TypeDef *hlpf, int32_t Input);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CTRL_Exported_Functions_Group3
+  * @{
+  */
+/* Scheduler functions ********************************************************/
+HAL_StatusTypeDef BSP_CTRL_SchedInit(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef BSP_CTRL_SchedSetLevel(uint32_t Level, IRQn_Type IRQn, uint32_t PreemptPriority);
+HAL_StatusTypeDef BSP_CTRL_SchedAddLoop(BSP_CTRL_LoopTypeDef *pLoop, uint32_t Period, uint32_t Budget,
+                                        void (*Function)(BSP_CTRL_LoopTypeDef *pLoop), void *pContext);
+HAL_StatusTypeDef BSP_CTRL_SchedStart(void);
+HAL_StatusTypeDef BSP_CTRL_SchedStop(void);
+void              BSP_CTRL_SchedGetStats(const BSP_CTRL_LoopTypeDef *pLoop, BSP_CTRL_StatsTypeDef *pStats);
+void              BSP_CTRL_SchedResetStats(BSP_CTRL_LoopTypeDef *pLoop);
+void              BSP_CTRL_SchedTimerIRQHandler(void);
+void              BSP_CTRL_SchedLevelIRQHandler(uint32_t Level);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_CTRL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_debounce.h
+  * @author  MCU Application Team
+  * @brief   Header file of the input debouncing BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DEBOUNCE_H
+#define __PY32F4XX_BSP_DEBOUNCE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_GPIO_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DEBOUNCE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DEBOUNCE_Exported_Constants BSP DEBOUNCE Exported Constants
+  * @{
+  */
+
+#if !defined (BSP_DEBOUNCE_PORTS)
+#define BSP_DEBOUNCE_PORTS              5U             /*!< Ports scanned at most                     */
+#endif
+
+#define BSP_DEBOUNCE_SAMPLES            4U             /*!< Samples in a row changing a state, the
+                                                            depth of the 2 bit vertical counters      */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_DEBOUNCE_Exported_Types BSP DEBOUNCE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Port scanned definition, one bit per pin in each word
+  */
+typedef struct
+{
+  GPIO_TypeDef            *GPIOx;       /*!< GPIO port                                              */
+
+  uint32_t                Mask;         /*!< Pins debounced                                         */
+
+  uint32_t                Invert;       /*!< Pins active low                                        */
+
+  uint32_t                State;        /*!< Debounced states, 1 active                             */
+
+  uint32_t                Count0;       /*!< Bit 0 of the vertical counters                         */
+
+  uint32_t                Count1;       /*!< Bit 1 of the vertical counters                         */
+
+  __IO uint32_t           Pressed;      /*!< Pins gone active since BSP_DEBOUNCE_GetEdges()         */
+
+  __IO uint32_t           Released;     /*!< Pins gone inactive since BSP_DEBOUNCE_GetEdges()       */
+
+  uint16_t                Presses[16];  /*!< Activations of each pin, wrapping                      */
+
+} BSP_DEBOUNCE_PortTypeDef;
+
+/**
+  * @brief  Input debouncing definition
+  */
+typedef struct
+{
+  uint32_t                NbPorts;      /*!< Ports added                                            */
+
+  uint32_t                Scans;        /*!< Calls of BSP_DEBOUNCE_Scan()                           */
+
+  BSP_DEBOUNCE_PortTypeDef Port[BSP_DEBOUNCE_PORTS]; /*!< Ports, in the order of BSP_DEBOUNCE_AddPort() */
+
+} BSP_DEBOUNCE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DEBOUNCE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_DEBOUNCE_Init(BSP_DEBOUNCE_TypeDef *hdeb);
+HAL_StatusTypeDef BSP_DEBOUNCE_AddPort(BSP_DEBOUNCE_TypeDef *hdeb, GPIO_TypeDef *GPIOx, uint32_t Mask,
+                                       uint32_t ActiveLow);
+void              BSP_DEBOUNCE_Scan(BSP_DEBOUNCE_TypeDef *hdeb);
+void              BSP_DEBOUNCE_ProcessSamples(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, const uint16_t *pSamples,
+                                              uint32_t Count);
+uint32_t          BSP_DEBOUNCE_GetState(const BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port);
+void              BSP_DEBOUNCE_GetEdges(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t *pPressed,
+                                        uint32_t *pReleased);
+uint32_t          BSP_DEBOUNCE_GetPresses(const BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Pin);
+void              BSP_DEBOUNCE_EdgeCallback(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Pressed,
+                                            uint32_t Released);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_GPIO_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DEBOUNCE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
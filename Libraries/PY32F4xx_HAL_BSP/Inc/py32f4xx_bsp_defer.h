@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_defer.h
+  * @author  MCU Application Team
+  * @brief   Header file of the deferred interrupt work BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DEFER_H
+#define __PY32F4XX_BSP_DEFER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DEFER
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Exported_Constants BSP DEFER Exported Constants
+  * @{
+  */
+#if !defined (BSP_DEFER_LEVELS)
+#define BSP_DEFER_LEVELS                3U             /*!< Levels, each a software pended IRQ       */
+#endif /* BSP_DEFER_LEVELS */
+
+#if !defined (BSP_DEFER_DEPTH)
+#define BSP_DEFER_DEPTH                 16U            /*!< Works queued per level, a power of 2     */
+#endif /* BSP_DEFER_DEPTH */
+
+#if ((BSP_DEFER_DEPTH & (BSP_DEFER_DEPTH - 1U)) != 0U)
+#error "BSP_DEFER_DEPTH should be a power of 2"
+#endif
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Exported_Types BSP DEFER Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Deferred work function definition
+  */
+typedef void (*BSP_DEFER_FuncTypeDef)(void *pArg);
+
+/**
+  * @brief  Deferred work level statistics definition
+  */
+typedef struct
+{
+  uint32_t                Runs;         /*!< Works run                                              */
+
+  uint32_t                Overruns;     /*!< Works refused, the queue full                          */
+
+  uint32_t                MaxQueued;    /*!< Most works queued at once                              */
+
+} BSP_DEFER_StatsTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DEFER_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_DEFER_Init(uint32_t Level, IRQn_Type IRQn, uint32_t PreemptPriority);
+void              BSP_DEFER_DeInit(uint32_t Level);
+HAL_StatusTypeDef BSP_DEFER_Submit(uint32_t Level, BSP_DEFER_FuncTypeDef Func, void *pArg);
+HAL_StatusTypeDef BSP_DEFER_GetStats(uint32_t Level, BSP_DEFER_StatsTypeDef *pStats);
+void              BSP_DEFER_IRQHandler(uint32_t Level);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DEFER_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_diskio.h
+  * @author  MCU Application Team
+  * @brief   Header file of the FatFs disk I/O BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DISKIO_H
+#define __PY32F4XX_BSP_DISKIO_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_blkdev.h"
+
+#if defined (USE_BSP_FATFS)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DISKIO
+  * @{
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DISKIO_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_DISKIO_Link(uint32_t Drive, BSP_BLKDEV_TypeDef *hdev);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_FATFS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DISKIO_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,156 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_display.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI display transport BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DISPLAY_H
+#define __PY32F4XX_BSP_DISPLAY_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DISPLAY
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DISPLAY_Exported_Constants BSP DISPLAY Exported Constants
+  * @{
+  */
+#define BSP_DISPLAY_TILE_PIXELS         1024U          /*!< Pixels of a tile buffer, at least one row */
+#define BSP_DISPLAY_RECT_NUMBER         4U             /*!< Dirty rectangles tracked between flushes  */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_DISPLAY_Exported_Types BSP DISPLAY Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Display rectangle definition, bounds included
+  */
+typedef struct
+{
+  uint16_t                X0;           /*!< First column                                           */
+
+  uint16_t                Y0;           /*!< First row                                              */
+
+  uint16_t                X1;           /*!< Last column                                            */
+
+  uint16_t                Y1;           /*!< Last row                                               */
+
+} BSP_DISPLAY_RectTypeDef;
+
+/**
+  * @brief  Display state definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< SPI of the display, NULL when not initialized          */
+
+  GPIO_TypeDef            *CSPort;      /*!< Chip select port                                       */
+
+  GPIO_TypeDef            *DCPort;      /*!< Data/command select port                               */
+
+  uint16_t                CSPin;        /*!< Chip select pin, a value of @ref GPIO_pins             */
+
+  uint16_t                DCPin;        /*!< Data/command select pin, low for commands              */
+
+  uint16_t                Width;        /*!< Number of columns                                      */
+
+  uint16_t                Height;       /*!< Number of rows                                         */
+
+  BSP_DISPLAY_RectTypeDef Rects[BSP_DISPLAY_RECT_NUMBER]; /*!< Dirty rectangles                     */
+
+  uint32_t                RectNumber;   /*!< Number of dirty rectangles                             */
+
+  uint16_t                Tiles[2][BSP_DISPLAY_TILE_PIXELS]; /*!< Rendered and transferred tiles    */
+
+  uint32_t                PixelCount;   /*!< Number of pixels sent                                  */
+
+} BSP_DISPLAY_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DISPLAY_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DISPLAY_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_DISPLAY_Init(BSP_DISPLAY_TypeDef *hdisp, SPI_HandleTypeDef *hspi, uint16_t Width,
+                                   uint16_t Height, GPIO_TypeDef *CSPort, uint16_t CSPin,
+                                   GPIO_TypeDef *DCPort, uint16_t DCPin);
+HAL_StatusTypeDef BSP_DISPLAY_DeInit(BSP_DISPLAY_TypeDef *hdisp);
+HAL_StatusTypeDef BSP_DISPLAY_WriteCommand(BSP_DISPLAY_TypeDef *hdisp, uint8_t Cmd, const uint8_t *pParam,
+                                           uint32_t Size);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DISPLAY_Exported_Functions_Group2
+  * @{
+  */
+/* Update functions ***********************************************************/
+void              BSP_DISPLAY_Invalidate(BSP_DISPLAY_TypeDef *hdisp, uint16_t X, uint16_t Y, uint16_t Width,
+                                         uint16_t Height);
+HAL_StatusTypeDef BSP_DISPLAY_Flush(BSP_DISPLAY_TypeDef *hdisp);
+void              BSP_DISPLAY_RenderCallback(BSP_DISPLAY_TypeDef *hdisp, uint16_t *pTile,
+                                             const BSP_DISPLAY_RectTypeDef *pRect);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DISPLAY_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvcan.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver CAN BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVCAN_H
+#define __PY32F4XX_BSP_DRVCAN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_CANFD_MODULE_ENABLED)
+
+#include "Driver_CAN.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVCAN
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Exported_Constants BSP DRVCAN Exported Constants
+  * @{
+  */
+#define BSP_DRVCAN_OBJ_TX               0U             /*!< Object of MessageSend(), the primary transmit buffer */
+#define BSP_DRVCAN_OBJ_RX               1U             /*!< Object of MessageRead(), the receive FIFO            */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Exported_Variables BSP DRVCAN Exported Variables
+  * @brief    CMSIS-Driver access structures, of the CANFD
+  * @{
+  */
+extern ARM_DRIVER_CAN Driver_CAN1;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVCAN_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVCAN_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVCAN_Attach(CANFD_HandleTypeDef *hcanfd);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVCAN_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVCAN_RxCpltCallback(CANFD_HandleTypeDef *hcanfd);
+void              BSP_DRVCAN_PtbTxCpltCallback(CANFD_HandleTypeDef *hcanfd);
+void              BSP_DRVCAN_RxFifoOverflowCallback(CANFD_HandleTypeDef *hcanfd);
+void              BSP_DRVCAN_PassiveErrorCallback(CANFD_HandleTypeDef *hcanfd);
+void              BSP_DRVCAN_ErrorChangeCallback(CANFD_HandleTypeDef *hcanfd);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVCAN_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drveth.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver Ethernet MAC and PHY BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVETH_H
+#define __PY32F4XX_BSP_DRVETH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SPI_MODULE_ENABLED)
+
+#include "Driver_ETH_MAC.h"
+#include "Driver_ETH_PHY.h"
+#include "py32f4xx_bsp_spibus.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVETH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Exported_Constants BSP DRVETH Exported Constants
+  * @{
+  */
+#define BSP_DRVETH_FRAME_MAX            1518U          /*!< Largest frame, VLAN tag included, FCS excluded */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Exported_Variables BSP DRVETH Exported Variables
+  * @brief    CMSIS-Driver access structures, MAC and PHY of a W5500
+  * @{
+  */
+extern ARM_DRIVER_ETH_MAC Driver_ETH_MAC0;
+extern ARM_DRIVER_ETH_PHY Driver_ETH_PHY0;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVETH_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVETH_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVETH_Attach(BSP_SPIBUS_TypeDef *hbus, const BSP_SPIBUS_DeviceTypeDef *pDevice,
+                                    GPIO_TypeDef *ResetPort, uint16_t ResetPin);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVETH_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVETH_IRQHandler(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVETH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
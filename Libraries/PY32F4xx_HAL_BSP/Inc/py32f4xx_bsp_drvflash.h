@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvflash.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver Flash BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVFLASH_H
+#define __PY32F4XX_BSP_DRVFLASH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_FLASH_MODULE_ENABLED)
+
+#include "Driver_Flash.h"
+#include "py32f4xx_bsp_esmcflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVFLASH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Exported_Constants BSP DRVFLASH Exported Constants
+  * @{
+  */
+#define BSP_DRVFLASH_ESMC_SECTOR_SIZE   0x1000U        /*!< EraseSector() of Driver_Flash1, 4 Kbyte sector erase */
+#define BSP_DRVFLASH_ESMC_MAX_SIZE      0x1000000U     /*!< Largest flash of Driver_Flash1, 24-bit addresses     */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Exported_Variables BSP DRVFLASH Exported Variables
+  * @brief    CMSIS-Driver access structures, internal flash and ESMC flash
+  * @{
+  */
+extern ARM_DRIVER_FLASH Driver_Flash0;
+#ifdef HAL_ESMC_MODULE_ENABLED
+extern ARM_DRIVER_FLASH Driver_Flash1;
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVFLASH_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVFLASH_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVFLASH_Attach(uint32_t Address, uint32_t Size);
+uint32_t          BSP_DRVFLASH_GetAddress(void);
+#ifdef HAL_ESMC_MODULE_ENABLED
+HAL_StatusTypeDef BSP_DRVFLASH_AttachESMC(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Size);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVFLASH_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVFLASH_EndOfOperationCallback(uint32_t ReturnValue);
+void              BSP_DRVFLASH_OperationErrorCallback(uint32_t ReturnValue);
+#ifdef HAL_ESMC_MODULE_ENABLED
+void              BSP_DRVFLASH_ESMCCpltCallback(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVFLASH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
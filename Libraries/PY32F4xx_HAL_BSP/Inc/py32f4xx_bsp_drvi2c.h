@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvi2c.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver I2C BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVI2C_H
+#define __PY32F4XX_BSP_DRVI2C_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_i2crecover.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_I2C_MODULE_ENABLED)
+
+#include "Driver_I2C.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVI2C
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Exported_Constants BSP DRVI2C Exported Constants
+  * @{
+  */
+#define BSP_DRVI2C_NUMBER               2U             /*!< Drivers, Driver_I2C1 and Driver_I2C2 */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Exported_Variables BSP DRVI2C Exported Variables
+  * @brief    CMSIS-Driver access structures, one per I2C
+  * @{
+  */
+extern ARM_DRIVER_I2C Driver_I2C1;
+extern ARM_DRIVER_I2C Driver_I2C2;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVI2C_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVI2C_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVI2C_Attach(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef BSP_DRVI2C_SetRecovery(I2C_HandleTypeDef *hi2c, BSP_I2CRECOVER_TypeDef *hrecover);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVI2C_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVI2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void              BSP_DRVI2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void              BSP_DRVI2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void              BSP_DRVI2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void              BSP_DRVI2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_I2C_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVI2C_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
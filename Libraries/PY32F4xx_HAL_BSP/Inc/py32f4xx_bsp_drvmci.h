@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvmci.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver MCI BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVMCI_H
+#define __PY32F4XX_BSP_DRVMCI_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SD_MODULE_ENABLED)
+
+#include "Driver_MCI.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVMCI
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Exported_Constants BSP DRVMCI Exported Constants
+  * @{
+  */
+#define BSP_DRVMCI_MAX_XFER_SIZE        0x3FFFCU       /*!< Largest SetupTransfer(), 65535 DMA words          */
+#define BSP_DRVMCI_INIT_SPEED           400000U        /*!< Card clock at power up, identification mode, Hz  */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Exported_Variables BSP DRVMCI Exported Variables
+  * @brief    CMSIS-Driver access structure of the SDIO
+  * @{
+  */
+extern ARM_DRIVER_MCI Driver_MCI0;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVMCI_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVMCI_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVMCI_Attach(SD_HandleTypeDef *hsd);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVMCI_Exported_Functions_Group2
+  * @{
+  */
+/* Interrupt and tick functions ***********************************************/
+void              BSP_DRVMCI_IRQHandler(void);
+void              BSP_DRVMCI_Tick(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVMCI_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvspi.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver SPI BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVSPI_H
+#define __PY32F4XX_BSP_DRVSPI_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SPI_MODULE_ENABLED)
+
+#include "Driver_SPI.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVSPI
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Exported_Constants BSP DRVSPI Exported Constants
+  * @{
+  */
+#define BSP_DRVSPI_NUMBER               3U             /*!< Drivers, Driver_SPI1 to Driver_SPI3 */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Exported_Variables BSP DRVSPI Exported Variables
+  * @brief    CMSIS-Driver access structures, one per SPI
+  * @{
+  */
+extern ARM_DRIVER_SPI Driver_SPI1;
+extern ARM_DRIVER_SPI Driver_SPI2;
+extern ARM_DRIVER_SPI Driver_SPI3;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVSPI_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVSPI_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVSPI_Attach(SPI_HandleTypeDef *hspi);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVSPI_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVSPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+void              BSP_DRVSPI_RxCpltCallback(SPI_HandleTypeDef *hspi);
+void              BSP_DRVSPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void              BSP_DRVSPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+void              BSP_DRVSPI_SlaveSelectCallback(SPI_HandleTypeDef *hspi, uint32_t Active);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVSPI_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvstorage.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver Storage BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVSTORAGE_H
+#define __PY32F4XX_BSP_DRVSTORAGE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_FLASH_MODULE_ENABLED)
+
+#include "Driver_Storage.h"
+#include "py32f4xx_bsp_drvflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVSTORAGE
+  * @{
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Exported_Variables BSP DRVSTORAGE Exported Variables
+  * @brief    CMSIS-Driver access structures, on Driver_Flash0 and Driver_Flash1
+  * @{
+  */
+extern ARM_DRIVER_STORAGE Driver_Storage0;
+#ifdef HAL_ESMC_MODULE_ENABLED
+extern ARM_DRIVER_STORAGE Driver_Storage1;
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVSTORAGE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvusart.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver USART BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVUSART_H
+#define __PY32F4XX_BSP_DRVUSART_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_UART_MODULE_ENABLED)
+
+#include "Driver_USART.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVUSART
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Exported_Constants BSP DRVUSART Exported Constants
+  * @{
+  */
+#define BSP_DRVUSART_NUMBER             5U             /*!< Drivers, Driver_USART1 to Driver_USART5 */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Exported_Variables BSP DRVUSART Exported Variables
+  * @brief    CMSIS-Driver access structures, one per USART
+  * @{
+  */
+extern ARM_DRIVER_USART Driver_USART1;
+extern ARM_DRIVER_USART Driver_USART2;
+extern ARM_DRIVER_USART Driver_USART3;
+extern ARM_DRIVER_USART Driver_USART4;
+extern ARM_DRIVER_USART Driver_USART5;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVUSART_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVUSART_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVUSART_Attach(UART_HandleTypeDef *huart);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVUSART_Exported_Functions_Group2
+  * @{
+  */
+/* Callback functions *********************************************************/
+void              BSP_DRVUSART_TxCpltCallback(UART_HandleTypeDef *huart);
+void              BSP_DRVUSART_RxCpltCallback(UART_HandleTypeDef *huart);
+void              BSP_DRVUSART_ErrorCallback(UART_HandleTypeDef *huart);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVUSART_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
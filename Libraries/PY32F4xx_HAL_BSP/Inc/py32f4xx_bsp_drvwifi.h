@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvwifi.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-Driver WiFi BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DRVWIFI_H
+#define __PY32F4XX_BSP_DRVWIFI_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_UART_MODULE_ENABLED)
+
+#include "Driver_WiFi.h"
+#include "py32f4xx_bsp_atcmd.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DRVWIFI
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Exported_Constants BSP DRVWIFI Exported Constants
+  * @{
+  */
+#define BSP_DRVWIFI_SOCKETS             5U             /*!< Links of the ESP-AT firmware in CIPMUX=1 mode   */
+#define BSP_DRVWIFI_DATA_MAX            2048U          /*!< Largest payload of one CIPSEND or CIPRECVDATA   */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Exported_Variables BSP DRVWIFI Exported Variables
+  * @brief    CMSIS-Driver access structure, station of an ESP-AT module
+  * @{
+  */
+extern ARM_DRIVER_WIFI Driver_WiFi0;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DRVWIFI_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DRVWIFI_Exported_Functions_Group1
+  * @{
+  */
+/* Binding functions **********************************************************/
+HAL_StatusTypeDef BSP_DRVWIFI_Attach(uint32_t Port, GPIO_TypeDef *ResetPort, uint16_t ResetPin);
+void              BSP_DRVWIFI_GetStats(BSP_ATCMD_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DRVWIFI_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,304 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_dsp.h
+  * @author  MCU Application Team
+  * @brief   Header file of the DSP kernels BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DSP_H
+#define __PY32F4XX_BSP_DSP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DSP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DSP_Exported_Constants BSP DSP Exported Constants
+  * @{
+  */
+#define BSP_DSP_FFT_LENGTH_MIN          16U            /*!< Shortest FFT, a power of 4                */
+#define BSP_DSP_FFT_LENGTH_MAX          4096U          /*!< Longest FFT, a power of 4                 */
+
+/** @defgroup BSP_DSP_FFT_Direction BSP DSP FFT Direction
+  * @{
+  */
+#define BSP_DSP_FFT_FORWARD             0x00000000U    /*!< X[k] = sum x[n] exp(-2 pi j n k / N)      */
+#define BSP_DSP_FFT_INVERSE             0x00000001U    /*!< x[n] = sum X[k] exp(+2 pi j n k / N)      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_DSP_Exported_Types BSP DSP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Q15 FIR filter definition
+  */
+typedef struct
+{
+  uint32_t                NumTaps;      /*!< Filter length                                          */
+
+  const int16_t           *pCoeffs;     /*!< NumTaps coefficients, in time reversed order           */
+
+  int16_t                 *pState;      /*!< NumTaps + BlockSize - 1 samples                        */
+
+  uint32_t                BlockSize;    /*!< Largest block of a BSP_DSP_FIR_Q15_Process() call      */
+
+} BSP_DSP_FIR_Q15_TypeDef;
+
+/**
+  * @brief  Q31 FIR filter definition
+  */
+typedef struct
+{
+  uint32_t                NumTaps;      /*!< Filter length                                          */
+
+  const int32_t           *pCoeffs;     /*!< NumTaps coefficients, in time reversed order           */
+
+  int32_t                 *pState;      /*!< NumTaps + BlockSize - 1 samples                        */
+
+  uint32_t                BlockSize;    /*!< Largest block of a BSP_DSP_FIR_Q31_Process() call      */
+
+} BSP_DSP_FIR_Q31_TypeDef;
+
+/**
+  * @brief  Float FIR filter definition
+  */
+typedef struct
+{
+  uint32_t                NumTaps;      /*!< Filter length                                          */
+
+  const float             *pCoeffs;     /*!< NumTaps coefficients, in time reversed order           */
+
+  float                   *pState;      /*!< NumTaps + BlockSize - 1 samples                        */
+
+  uint32_t                BlockSize;    /*!< Largest block of a BSP_DSP_FIR_F32_Process() call      */
+
+} BSP_DSP_FIR_F32_TypeDef;
+
+/**
+  * @brief  Q15 biquad cascade definition, direct form I
+  */
+typedef struct
+{
+  uint32_t                NumStages;    /*!< Second order sections                                  */
+
+  const int16_t           *pCoeffs;     /*!< b0, b1, b2, a1, a2 of each stage, scaled by
+                                             2^-PostShift, y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2 */
+
+  int16_t                 *pState;      /*!< x1, x2, y1, y2 of each stage                           */
+
+  uint32_t                PostShift;    /*!< Left shift of the accumulator undoing the coefficient
+                                             scaling, 0 to 15                                        */
+
+} BSP_DSP_BIQUAD_Q15_TypeDef;
+
+/**
+  * @brief  Q31 biquad cascade definition, direct form I
+  */
+typedef struct
+{
+  uint32_t                NumStages;    /*!< Second order sections                                  */
+
+  const int32_t           *pCoeffs;     /*!< b0, b1, b2, a1, a2 of each stage, scaled by
+                                             2^-PostShift, y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2 */
+
+  int32_t                 *pState;      /*!< x1, x2, y1, y2 of each stage                           */
+
+  uint32_t                PostShift;    /*!< Left shift of the accumulator undoing the coefficient
+                                             scaling, 0 to 31                                        */
+
+} BSP_DSP_BIQUAD_Q31_TypeDef;
+
+/**
+  * @brief  Float biquad cascade definition, direct form II transposed
+  */
+typedef struct
+{
+  uint32_t                NumStages;    /*!< Second order sections                                  */
+
+  const float             *pCoeffs;     /*!< b0, b1, b2, a1, a2 of each stage,
+                                             y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2              */
+
+  float                   *pState;      /*!< d1, d2 of each stage                                   */
+
+} BSP_DSP_BIQUAD_F32_TypeDef;
+
+/**
+  * @brief  Q15 complex FFT definition, radix 4
+  */
+typedef struct
+{
+  uint32_t                Length;       /*!< Complex points, a power of 4                           */
+
+  uint32_t                Log2Length;   /*!< log2(Length)                                           */
+
+  const int16_t           *pTwiddle;    /*!< 3 Length / 4 complex factors, built by the Init        */
+
+} BSP_DSP_FFT_Q15_TypeDef;
+
+/**
+  * @brief  Q31 complex FFT definition, radix 4
+  */
+typedef struct
+{
+  uint32_t                Length;       /*!< Complex points, a power of 4                           */
+
+  uint32_t                Log2Length;   /*!< log2(Length)                                           */
+
+  const int32_t           *pTwiddle;    /*!< 3 Length / 4 complex factors, built by the Init        */
+
+} BSP_DSP_FFT_Q31_TypeDef;
+
+/**
+  * @brief  Float complex FFT definition, radix 4
+  */
+typedef struct
+{
+  uint32_t                Length;       /*!< Complex points, a power of 4                           */
+
+  uint32_t                Log2Length;   /*!< log2(Length)                                           */
+
+  const float             *pTwiddle;    /*!< 3 Length / 4 complex factors, built by the Init        */
+
+} BSP_DSP_FFT_F32_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DSP_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_DSP_Exported_Functions_Group1
+  * @{
+  */
+/* Filter functions ***********************************************************/
+HAL_StatusTypeDef BSP_DSP_FIR_Q15_Init(BSP_DSP_FIR_Q15_TypeDef *hfir, uint32_t NumTaps, const int16_t *pCoeffs,
+                                       int16_t *pState, uint32_t BlockSize);
+void              BSP_DSP_FIR_Q15_Process(BSP_DSP_FIR_Q15_TypeDef *hfir, const int16_t *pSrc, int16_t *pDst,
+                                          uint32_t BlockSize);
+HAL_StatusTypeDef BSP_DSP_FIR_Q31_Init(BSP_DSP_FIR_Q31_TypeDef *hfir, uint32_t NumTaps, const int32_t *pCoeffs,
+                                       int32_t *pState, uint32_t BlockSize);
+void              BSP_DSP_FIR_Q31_Process(BSP_DSP_FIR_Q31_TypeDef *hfir, const int32_t *pSrc, int32_t *pDst,
+                                          uint32_t BlockSize);
+HAL_StatusTypeDef BSP_DSP_FIR_F32_Init(BSP_DSP_FIR_F32_TypeDef *hfir, uint32_t NumTaps, const float *pCoeffs,
+                                       float *pState, uint32_t BlockSize);
+void              BSP_DSP_FIR_F32_Process(BSP_DSP_FIR_F32_TypeDef *hfir, const float *pSrc, float *pDst,
+                                          uint32_t BlockSize);
+HAL_StatusTypeDef BSP_DSP_BIQUAD_Q15_Init(BSP_DSP_BIQUAD_Q15_TypeDef *hbiq, uint32_t NumStages,
+                                          const int16_t *pCoeffs, int16_t *pState, uint32_t PostShift);
+void              BSP_DSP_BIQUAD_Q15_Process(BSP_DSP_BIQUAD_Q15_TypeDef *hbiq, const int16_t *pSrc, int16_t *pDst,
+                                             uint32_t BlockSize);
+HAL_StatusTypeDef BSP_DSP_BIQUAD_Q31_Init(BSP_DSP_BIQUAD_Q31_TypeDef *hbiq, uint32_t NumStages,
+                                          const int32_t *pCoeffs, int32_t *pState, uint32_t PostShift);
+void              BSP_DSP_BIQUAD_Q31_Process(BSP_DSP_BIQUAD_Q31_TypeDef *hbiq, const int32_t *pSrc, int32_t *pDst,
+                                             uint32_t BlockSize);
+HAL_StatusTypeDef BSP_DSP_BIQUAD_F32_Init(BSP_DSP_BIQUAD_F32_TypeDef *hbiq, uint32_t NumStages,
+                                          const float *pCoeffs, float *pState);
+void              BSP_DSP_BIQUAD_F32_Process(BSP_DSP_BIQUAD_F32_TypeDef *hbiq, const float *pSrc, float *pDst,
+                                             uint32_t BlockSize);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DSP_Exported_Functions_Group2
+  * @{
+  */
+/* Transform functions ********************************************************/
+HAL_StatusTypeDef BSP_DSP_FFT_Q15_Init(BSP_DSP_FFT_Q15_TypeDef *hfft, uint32_t Length, int16_t *pTwiddle);
+void              BSP_DSP_FFT_Q15_Process(const BSP_DSP_FFT_Q15_TypeDef *hfft, int16_t *pData, uint32_t Direction);
+HAL_StatusTypeDef BSP_DSP_FFT_Q31_Init(BSP_DSP_FFT_Q31_TypeDef *hfft, uint32_t Length, int32_t *pTwiddle);
+void              BSP_DSP_FFT_Q31_Process(const BSP_DSP_FFT_Q31_TypeDef *hfft, int32_t *pData, uint32_t Direction);
+HAL_StatusTypeDef BSP_DSP_FFT_F32_Init(BSP_DSP_FFT_F32_TypeDef *hfft, uint32_t Length, float *pTwiddle);
+void              BSP_DSP_FFT_F32_Process(const BSP_DSP_FFT_F32_TypeDef *hfft, float *pData, uint32_t Direction);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DSP_Exported_Functions_Group3
+  * @{
+  */
+/* Statistics functions *******************************************************/
+int64_t           BSP_DSP_Dot_Q15(const int16_t *pSrcA, const int16_t *pSrcB, uint32_t Length);
+int64_t           BSP_DSP_Dot_Q31(const int32_t *pSrcA, const int32_t *pSrcB, uint32_t Length);
+float             BSP_DSP_Dot_F32(const float *pSrcA, const float *pSrcB, uint32_t Length);
+int16_t           BSP_DSP_RMS_Q15(const int16_t *pSrc, uint32_t Length);
+int32_t           BSP_DSP_RMS_Q31(const int32_t *pSrc, uint32_t Length);
+float             BSP_DSP_RMS_F32(const float *pSrc, uint32_t Length);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DSP_Exported_Functions_Group4
+  * @{
+  */
+/* Conversion functions *******************************************************/
+void              BSP_DSP_I2S_ToQ31(const uint16_t *pSrc, int32_t *pDst, uint32_t Length);
+void              BSP_DSP_Q31_ToI2S(const int32_t *pSrc, uint16_t *pDst, uint32_t Length);
+void              BSP_DSP_Q15_ToF32(const int16_t *pSrc, float *pDst, uint32_t Length);
+void              BSP_DSP_F32_ToQ15(const float *pSrc, int16_t *pDst, uint32_t Length);
+void              BSP_DSP_Q31_ToF32(const int32_t *pSrc, float *pDst, uint32_t Length);
+void              BSP_DSP_F32_ToQ31(const float *pSrc, int32_t *pDst, uint32_t Length);
+void              BSP_DSP_Deinterleave_Q15(const int16_t *pSrc, int16_t *pLeft, int16_t *pRight, uint32_t Frames);
+void              BSP_DSP_Interleave_Q15(const int16_t *pLeft, const int16_t *pRight, int16_t *pDst, uint32_t Frames);
+void              BSP_DSP_Deinterleave_Q31(const int32_t *pSrc, int32_t *pLeft, int32_t *pRight, uint32_t Frames);
+void              BSP_DSP_Interleave_Q31(const int32_t *pLeft, const int32_t *pRight, int32_t *pDst, uint32_t Frames);
+void              BSP_DSP_Scale_Q15(const int16_t *pSrc, int16_t Gain, uint32_t Shift, int16_t *pDst, uint32_t Length);
+void              BSP_DSP_Scale_Q31(const int32_t *pSrc, int32_t Gain, uint32_t Shift, int32_t *pDst, uint32_t Length);
+void              BSP_DSP_Scale_F32(const float *pSrc, float Gain, float *pDst, uint32_t Length);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DSP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_dvfs.h
+  * @author  MCU Application Team
+  * @brief   Header file of the DVFS governor BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_DVFS_H
+#define __PY32F4XX_BSP_DVFS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_clkswitch.h"
+
+#if defined (HAL_PWR_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_DVFS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_DVFS_Exported_Constants BSP DVFS Exported Constants
+  * @{
+  */
+#define BSP_DVFS_POINT_NONE             0xFFFFFFFFU    /*!< No operating point, a switch failed       */
+
+#if !defined (BSP_DVFS_WINDOW)
+#define BSP_DVFS_WINDOW                 100U           /*!< Load measurement window, ms               */
+#endif
+
+#if !defined (BSP_DVFS_UP_LOAD)
+#define BSP_DVFS_UP_LOAD                85U            /*!< Load from which the fastest point is
+                                                            taken, percent                             */
+#endif
+
+#if !defined (BSP_DVFS_TARGET_LOAD)
+#define BSP_DVFS_TARGET_LOAD            70U            /*!< Load expected at a slower point before
+                                                            going down to it, percent                  */
+#endif
+
+#if !defined (BSP_DVFS_VOS_SETTLE)
+#define BSP_DVFS_VOS_SETTLE             10U            /*!< Regulator settling after a voltage raise, us */
+#endif
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_DVFS_Exported_Types BSP DVFS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Operating point definition
+  */
+typedef struct
+{
+  RCC_PLLInitTypeDef      PLL;          /*!< PLL of the point: RCC_PLL_ON with its source and
+                                             multiplier, RCC_PLL_OFF to stop it or RCC_PLL_NONE     */
+
+  RCC_ClkInitTypeDef      ClkInit;      /*!< SYSCLK source and bus dividers, ClockType ignored      */
+
+  uint32_t                FlashLatency; /*!< A value of @ref FLASH_Latency or FLASH_LATENCY_AUTO    */
+
+  uint32_t                VoltageScaling; /*!< A PWR_REGULATOR_VOLTAGE_SCALEx value                 */
+
+} BSP_DVFS_PointTypeDef;
+
+/**
+  * @brief  DVFS statistics definition
+  */
+typedef struct
+{
+  uint32_t                Switches;     /*!< Operating points applied                               */
+
+  uint32_t                Failures;     /*!< Switches failed, see BSP_DVFS_POINT_NONE               */
+
+  uint32_t                Deferred;     /*!< Switches deferred by a BSP CLKSWITCH notifier          */
+
+  uint32_t                Windows;      /*!< Load windows evaluated                                 */
+
+} BSP_DVFS_StatsTypeDef;
+
+/**
+  * @brief  DVFS governor definition
+  */
+typedef struct
+{
+  const BSP_DVFS_PointTypeDef *pPoints; /*!< Operating points, slowest HCLK first                   */
+
+  uint32_t                NbPoints;     /*!< Number of operating points                             */
+
+  uint32_t                Point;        /*!< Current point or BSP_DVFS_POINT_NONE                   */
+
+  uint32_t                Governor;     /*!< 1 when BSP_DVFS_Process() changes the point            */
+
+  __IO uint32_t           Locks;        /*!< Point changes forbidden while not 0                    */
+
+  uint32_t                WindowStart;  /*!< Start of the load window, us                           */
+
+  uint32_t                IdleStart;    /*!< Start of the current idle, us                          */
+
+  uint32_t                IdleTime;     /*!< Idle time of the load window, us                       */
+
+  uint32_t                Load;         /*!< Load of the last window, percent                       */
+
+  BSP_DVFS_StatsTypeDef   Stats;        /*!< Statistics                                             */
+
+} BSP_DVFS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_DVFS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_DVFS_Init(BSP_DVFS_TypeDef *hdvfs, const BSP_DVFS_PointTypeDef *pPoints,
+                                uint32_t NbPoints, uint32_t Point);
+HAL_StatusTypeDef BSP_DVFS_SetPoint(BSP_DVFS_TypeDef *hdvfs, uint32_t Point);
+uint32_t          BSP_DVFS_GetPoint(const BSP_DVFS_TypeDef *hdvfs);
+uint32_t          BSP_DVFS_GetPointHCLK(const BSP_DVFS_TypeDef *hdvfs, uint32_t Point);
+void              BSP_DVFS_EnableGovernor(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_DisableGovernor(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_Lock(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_Unlock(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_IdleEnter(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_IdleExit(BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_Idle(BSP_DVFS_TypeDef *hdvfs);
+uint32_t          BSP_DVFS_Process(BSP_DVFS_TypeDef *hdvfs);
+uint32_t          BSP_DVFS_GetLoad(const BSP_DVFS_TypeDef *hdvfs);
+void              BSP_DVFS_GetStats(const BSP_DVFS_TypeDef *hdvfs, BSP_DVFS_StatsTypeDef *pStats);
+void              BSP_DVFS_PreChangeCallback(BSP_DVFS_TypeDef *hdvfs, uint32_t From, uint32_t To);
+void              BSP_DVFS_PostChangeCallback(BSP_DVFS_TypeDef *hdvfs, uint32_t From, uint32_t To);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_PWR_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_DVFS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
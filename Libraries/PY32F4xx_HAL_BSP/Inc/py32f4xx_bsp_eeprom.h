@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_eeprom.h
+  * @author  MCU Application Team
+  * @brief   Header file of the internal flash EEPROM emulation BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_EEPROM_H
+#define __PY32F4XX_BSP_EEPROM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_EEPROM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_EEPROM_Exported_Constants BSP EEPROM Exported Constants
+  * @{
+  */
+#define BSP_EEPROM_SECTORS_MAX          8U             /*!< Flash sectors of the emulation            */
+#define BSP_EEPROM_VARIABLES            64U            /*!< Variable identifiers, 0 to 254            */
+#define BSP_EEPROM_VALUE_MAX            240U           /*!< Bytes of a variable                       */
+#define BSP_EEPROM_FLUSH_DELAY          100U           /*!< Age of a pending page programmed by
+                                                            BSP_EEPROM_Process(), ms                   */
+#define BSP_EEPROM_GC_LEVEL             ((FLASH_SECTOR_SIZE * 3U) / 4U) /*!< Head fill starting a transfer
+                                                            when only one sector is erased             */
+#define BSP_EEPROM_GC_DEAD_MIN          FLASH_PAGE_SIZE /*!< Dead bytes worth a sector transfer       */
+#define BSP_EEPROM_NOT_FOUND            0xFFFFFFFFU    /*!< BSP_EEPROM_GetLength() of an unwritten variable */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_EEPROM_Exported_Types BSP EEPROM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  EEPROM emulation state definition
+  */
+typedef struct
+{
+  uint32_t                Address;      /*!< First sector, 0 when not initialized                   */
+
+  uint32_t                SectorCount;  /*!< Number of sectors, 2 to BSP_EEPROM_SECTORS_MAX         */
+
+  uint32_t                Sequence[BSP_EEPROM_SECTORS_MAX]; /*!< Write order of the sectors, 0 when erased */
+
+  uint32_t                Used[BSP_EEPROM_SECTORS_MAX];     /*!< End of the records in each sector   */
+
+  uint32_t                Live[BSP_EEPROM_SECTORS_MAX];     /*!< Bytes of current records in each sector */
+
+  uint32_t                LastSequence; /*!< Sequence of the head sector                            */
+
+  uint32_t                Head;         /*!< Sector appended to, BSP_EEPROM_SECTORS_MAX when none   */
+
+  uint32_t                FreeSectors;  /*!< Number of erased sectors                               */
+
+  uint32_t                Index[BSP_EEPROM_VARIABLES]; /*!< Record address of each variable, 0 when none */
+
+  uint32_t                Page[FLASH_PAGE_SIZE / 4U]; /*!< Image of the page being filled           */
+
+  uint32_t                PageAddress;  /*!< Page being filled, 0 when the head sector is full      */
+
+  uint32_t                PageUsed;     /*!< Bytes used in Page                                     */
+
+  uint32_t                PageDirty;    /*!< Page holds records not programmed yet                  */
+
+  uint32_t                PageTick;     /*!< HAL_GetTick() of the first record not programmed       */
+
+  __IO uint32_t           FlashBusy;    /*!< A program or erase runs in the flash                   */
+
+  __IO uint32_t           FlashError;   /*!< The last flash operation failed                        */
+
+  uint32_t                GcState;      /*!< Sector transfer step                                   */
+
+  uint32_t                GcSector;     /*!< Sector transferred                                     */
+
+  uint32_t                GcOffset;     /*!< Next record to transfer in GcSector                    */
+
+  uint32_t                EraseCount;   /*!< Number of sectors erased                               */
+
+  uint32_t                ErrorCount;   /*!< Number of failed flash operations and records          */
+
+} BSP_EEPROM_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_EEPROM_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_EEPROM_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_EEPROM_Init(BSP_EEPROM_TypeDef *heep, uint32_t Address, uint32_t SectorCount);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_EEPROM_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+uint32_t          BSP_EEPROM_GetLength(const BSP_EEPROM_TypeDef *heep, uint32_t Id);
+HAL_StatusTypeDef BSP_EEPROM_Read(BSP_EEPROM_TypeDef *heep, uint32_t Id, uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_EEPROM_Write(BSP_EEPROM_TypeDef *heep, uint32_t Id, const uint8_t *pData, uint32_t Length);
+HAL_StatusTypeDef BSP_EEPROM_Flush(BSP_EEPROM_TypeDef *heep);
+HAL_StatusTypeDef BSP_EEPROM_Process(BSP_EEPROM_TypeDef *heep);
+void              BSP_EEPROM_EndOfOperationHandler(BSP_EEPROM_TypeDef *heep);
+void              BSP_EEPROM_ErrorHandler(BSP_EEPROM_TypeDef *heep);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_EEPROM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_encoder.h
+  * @author  MCU Application Team
+  * @brief   Header file of the quadrature encoder BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ENCODER_H
+#define __PY32F4XX_BSP_ENCODER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ENCODER
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ENCODER_Exported_Constants BSP ENCODER Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_ENCODER_State BSP ENCODER State
+  * @{
+  */
+#define BSP_ENCODER_STATE_RESET         0x00000000U    /*!< Not initialized                           */
+#define BSP_ENCODER_STATE_READY         0x00000001U    /*!< Timers configured, stopped                */
+#define BSP_ENCODER_STATE_RUN           0x00000002U    /*!< Counting, updated by BSP_ENCODER_Update() */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ENCODER_Exported_Types BSP ENCODER Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Quadrature encoder configuration definition
+  */
+typedef struct
+{
+  uint32_t                UpdateHz;     /*!< Rate of BSP_ENCODER_Update(), velocity without a
+                                             capture timer                                          */
+
+  TIM_HandleTypeDef       *htimCapture; /*!< Free running timer capturing an edge of the encoder,
+                                             NULL for the velocity from the counts only             */
+
+  uint32_t                CaptureChannel; /*!< TIM_CHANNEL_1 to TIM_CHANNEL_4 of htimCapture, its
+                                             input wired to the encoder A signal                    */
+
+  uint32_t                CaptureFilter; /*!< Input filter of the capture, 0x0 to 0xF               */
+
+  uint32_t                CaptureTickHz; /*!< Frequency of the counter of htimCapture               */
+
+  uint32_t                CountsPerCapture; /*!< Counts between two captured edges, 4 for the rising
+                                             edges of A in TIM_ENCODERMODE_TI12                    */
+
+} BSP_ENCODER_InitTypeDef;
+
+/**
+  * @brief  Quadrature encoder snapshot definition
+  */
+typedef struct
+{
+  int64_t                 Position;     /*!< Counts since the start                                 */
+
+  float                   Velocity;     /*!< Counts per second, positive counting up               */
+
+  uint32_t                Updates;      /*!< BSP_ENCODER_Update() calls since the start             */
+
+} BSP_ENCODER_SnapshotTypeDef;
+
+/**
+  * @brief  Quadrature encoder definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< Timer in encoder mode, Period 0xFFFF                   */
+
+  BSP_ENCODER_InitTypeDef Init;         /*!< Configuration                                           */
+
+  uint32_t                Count;        /*!< Counter at the last update                             */
+
+  int64_t                 Position;     /*!< Counts since the start                                 */
+
+  float                   Velocity;     /*!< Counts per second at the last update                  */
+
+  uint32_t                CaptureCount; /*!< htimCapture counter at the last update                 */
+
+  uint32_t                CaptureTime;  /*!< Time of the last update in ticks of htimCapture, 32-bit */
+
+  uint32_t                EdgeTime;     /*!< Time of the last captured edge, 32-bit                 */
+
+  int64_t                 EdgePosition; /*!< Position at the update of the last captured edge       */
+
+  uint32_t                EdgeValid;    /*!< 1 when EdgeTime holds a captured edge                  */
+
+  BSP_ENCODER_SnapshotTypeDef Snapshot[2]; /*!< Published results, the other one is written         */
+
+  __IO uint32_t           Sequence;     /*!< Snapshots published, Snapshot[Sequence & 1] is current */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ENCODER_State                      */
+
+} BSP_ENCODER_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ENCODER_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ENCODER_Init(BSP_ENCODER_TypeDef *henc, TIM_HandleTypeDef *htim,
+                                   const BSP_ENCODER_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_ENCODER_Start(BSP_ENCODER_TypeDef *henc);
+HAL_StatusTypeDef BSP_ENCODER_Stop(BSP_ENCODER_TypeDef *henc);
+void              BSP_ENCODER_Update(BSP_ENCODER_TypeDef *henc);
+void              BSP_ENCODER_GetSnapshot(const BSP_ENCODER_TypeDef *henc, BSP_ENCODER_SnapshotTypeDef *pSnapshot);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ENCODER_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmccal.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ESMC clock calibration BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ESMCCAL_H
+#define __PY32F4XX_BSP_ESMCCAL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_esmcflash.h"
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCCAL
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ESMCCAL_Exported_Constants BSP ESMCCAL Exported Constants
+  * @{
+  */
+#define BSP_ESMCCAL_SECTOR_SIZE         0x1000U        /*!< Flash sector taken by the calibration     */
+#define BSP_ESMCCAL_PATTERN_SIZE        256U           /*!< Test pattern, first page of the sector    */
+#define BSP_ESMCCAL_PRESCALER_MIN       2U             /*!< Fastest ESMC prescaler                    */
+#define BSP_ESMCCAL_PASSES              8U             /*!< Pattern reads at each prescaler           */
+#define BSP_ESMCCAL_MARGIN              1U             /*!< Prescaler steps kept above the fastest pass */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ESMCCAL_Exported_Types BSP ESMCCAL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  ESMC calibration result definition
+  */
+typedef struct
+{
+  uint32_t                Preset;       /*!< Read preset calibrated, a value of @ref ESMCEx_XIP_Preset */
+
+  uint32_t                ClockPrescaler; /*!< Selected prescaler, FastestPass plus the margin      */
+
+  uint32_t                FastestPass;  /*!< Fastest prescaler reading the pattern without error    */
+
+  uint32_t                HclkFreq;     /*!< HCLK of the calibration, Hz                            */
+
+} BSP_ESMCCAL_ResultTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ESMCCAL_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCCAL_Exported_Functions_Group1
+  * @{
+  */
+/* Calibration functions ******************************************************/
+HAL_StatusTypeDef BSP_ESMCCAL_Run(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t Address, uint32_t CSPinSel,
+                                  BSP_ESMCCAL_ResultTypeDef *pResult);
+HAL_StatusTypeDef BSP_ESMCCAL_Load(ESMC_HandleTypeDef *hesmc, uint32_t Address, uint32_t CSPinSel,
+                                   BSP_ESMCCAL_ResultTypeDef *pResult);
+HAL_StatusTypeDef BSP_ESMCCAL_Apply(ESMC_HandleTypeDef *hesmc, const BSP_ESMCCAL_ResultTypeDef *pResult);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ESMCCAL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
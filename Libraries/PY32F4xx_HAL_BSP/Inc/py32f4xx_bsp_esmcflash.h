@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmcflash.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ESMC flash background operation BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ESMCFLASH_H
+#define __PY32F4XX_BSP_ESMCFLASH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCFLASH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ESMCFLASH_Exported_Constants BSP ESMCFLASH Exported Constants
+  * @{
+  */
+#define BSP_ESMCFLASH_PAGE_SIZE         256U           /*!< Page program size in bytes                */
+
+/** @defgroup BSP_ESMCFLASH_Erase BSP ESMCFLASH Erase
+  * @{
+  */
+#define BSP_ESMCFLASH_ERASE_SECTOR      0x00000000U    /*!< 4 Kbyte sector, 20h                       */
+#define BSP_ESMCFLASH_ERASE_BLOCK       0x00000001U    /*!< 64 Kbyte block, D8h                       */
+#define BSP_ESMCFLASH_ERASE_CHIP        0x00000002U    /*!< Whole flash, C7h                          */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ESMCFLASH_State BSP ESMCFLASH State
+  * @{
+  */
+#define BSP_ESMCFLASH_STATE_IDLE        0x00000000U    /*!< No operation                              */
+#define BSP_ESMCFLASH_STATE_ERASE       0x00000001U    /*!< Erase running in the flash               */
+#define BSP_ESMCFLASH_STATE_PROGRAM     0x00000002U    /*!< Page program running in the flash        */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ESMCFLASH_Status BSP ESMCFLASH Status
+  * @{
+  */
+#define BSP_ESMCFLASH_STATUS_OK         0x00000000U    /*!< Operation ended                           */
+#define BSP_ESMCFLASH_STATUS_ERROR      0x00000001U    /*!< ESMC command failed                       */
+#define BSP_ESMCFLASH_STATUS_TIMEOUT    0x00000002U    /*!< Flash still busy after the timeout        */
+/**
+  * @}
+  */
+
+#define BSP_ESMCFLASH_PROGRAM_TIMEOUT   5U             /*!< Page program, ms                          */
+#define BSP_ESMCFLASH_SECTOR_TIMEOUT    500U           /*!< Sector erase, ms                          */
+#define BSP_ESMCFLASH_BLOCK_TIMEOUT     3000U          /*!< Block erase, ms                           */
+#define BSP_ESMCFLASH_CHIP_TIMEOUT      200000U        /*!< Chip erase, ms                            */
+#define BSP_ESMCFLASH_CMD_TIMEOUT       1U             /*!< ESMC command, ms                          */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ESMCFLASH_Exported_Types BSP ESMCFLASH Exported Types
+  * @{
+  */
+
+/**
+  * @brief  ESMC flash state definition
+  */
+typedef struct
+{
+  ESMC_HandleTypeDef      *hesmc;       /*!< ESMC of the flash, NULL when not initialized           */
+
+  uint32_t                CSPinSel;     /*!< Chip select of the flash, a value of @ref ESMC_CS_PIN_SEL */
+
+  uint32_t                PollPeriod;   /*!< Ticks between two status reads                         */
+
+  uint32_t                Countdown;    /*!< Ticks before the next status read                      */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_ESMCFLASH_State                    */
+
+  uint32_t                Address;      /*!< Next page to program                                   */
+
+  const uint8_t           *pData;       /*!< Next data to program                                   */
+
+  uint32_t                Remaining;    /*!< Bytes left to program                                  */
+
+  uint32_t                Timeout;      /*!< Timeout of the step in the flash, ms                   */
+
+  uint32_t                StartTick;    /*!< HAL_GetTick() at the start of the step                 */
+
+  uint32_t                PollCount;    /*!< Status reads of the last operation                     */
+
+  __IO uint32_t           LastStatus;   /*!< End of the last operation, a value of @ref BSP_ESMCFLASH_Status */
+
+} BSP_ESMCFLASH_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ESMCFLASH_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCFLASH_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_ESMCFLASH_Init(BSP_ESMCFLASH_TypeDef *hflash, ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel,
+                                     uint32_t PollPeriod);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ESMCFLASH_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+HAL_StatusTypeDef BSP_ESMCFLASH_Erase_IT(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, uint32_t Erase);
+HAL_StatusTypeDef BSP_ESMCFLASH_Program_IT(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                           uint32_t Size);
+HAL_StatusTypeDef BSP_ESMCFLASH_Read(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData,
+                                     uint32_t Size);
+void              BSP_ESMCFLASH_Tick(BSP_ESMCFLASH_TypeDef *hflash);
+uint32_t          BSP_ESMCFLASH_IsBusy(const BSP_ESMCFLASH_TypeDef *hflash);
+void              BSP_ESMCFLASH_OpCpltCallback(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ESMCFLASH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,159 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmcqueue.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ESMC read queue BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ESMCQUEUE_H
+#define __PY32F4XX_BSP_ESMCQUEUE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCQUEUE
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ESMCQUEUE_Exported_Types BSP ESMCQUEUE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  ESMC read request definition
+  * @note   The request is linked in the queue until it ends, it must stay
+  *         valid until then.
+  */
+typedef struct __BSP_ESMCQUEUE_ReqTypeDef
+{
+  const ESMC_CommandTypeDef *pCommand;  /*!< Read command, its Address, DataMode and NbData are ignored,
+                                             e.g. from HAL_ESMCEx_GetXIPCommand()                     */
+
+  uint32_t                Address;      /*!< Address in the memory                                  */
+
+  uint32_t                Size;         /*!< Number of bytes, a multiple of 4 with a word DMA       */
+
+  uint8_t                 *pData;       /*!< Destination buffer                                     */
+
+  __IO uint32_t           Status;       /*!< A value of @ref BSP_ESMCQUEUE_Status                   */
+
+  struct __BSP_ESMCQUEUE_ReqTypeDef *pNext; /*!< Next queued request                                */
+
+} BSP_ESMCQUEUE_ReqTypeDef;
+
+/**
+  * @brief  ESMC read queue state definition
+  */
+typedef struct
+{
+  ESMC_HandleTypeDef      *hesmc;       /*!< ESMC of the queue, NULL when not initialized           */
+
+  BSP_ESMCQUEUE_ReqTypeDef *pHead;      /*!< Request on the bus, NULL when idle                     */
+
+  BSP_ESMCQUEUE_ReqTypeDef *pTail;      /*!< Last queued request                                    */
+
+  ESMC_CommandTypeDef     Command;      /*!< Command of the request on the bus                      */
+
+  uint32_t                ErrorCount;   /*!< Number of requests ended with an error                 */
+
+} BSP_ESMCQUEUE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ESMCQUEUE_Exported_Constants BSP ESMCQUEUE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_ESMCQUEUE_Status BSP ESMCQUEUE Status
+  * @{
+  */
+#define BSP_ESMCQUEUE_STATUS_NONE       0x00000000U    /*!< Not submitted                             */
+#define BSP_ESMCQUEUE_STATUS_QUEUED     0x00000001U    /*!< Waiting in the queue or on the bus        */
+#define BSP_ESMCQUEUE_STATUS_OK         0x00000002U    /*!< Read                                      */
+#define BSP_ESMCQUEUE_STATUS_ERROR      0x00000003U    /*!< Command or DMA error, the request was dropped */
+/**
+  * @}
+  */
+
+#define BSP_ESMCQUEUE_TIMEOUT           1U             /*!< Wait for the ESMC to get idle, ms        */
+#define BSP_ESMCQUEUE_SIZE_MAX          0xFFFFU        /*!< DMA data items of a request              */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ESMCQUEUE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_ESMCQUEUE_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_ESMCQUEUE_Init(BSP_ESMCQUEUE_TypeDef *hqueue, ESMC_HandleTypeDef *hesmc);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ESMCQUEUE_Exported_Functions_Group2
+  * @{
+  */
+/* Request functions **********************************************************/
+HAL_StatusTypeDef BSP_ESMCQUEUE_Submit(BSP_ESMCQUEUE_TypeDef *hqueue, BSP_ESMCQUEUE_ReqTypeDef *pReq);
+uint32_t          BSP_ESMCQUEUE_IsIdle(const BSP_ESMCQUEUE_TypeDef *hqueue);
+void              BSP_ESMCQUEUE_RxCpltHandler(BSP_ESMCQUEUE_TypeDef *hqueue);
+void              BSP_ESMCQUEUE_ErrorHandler(BSP_ESMCQUEUE_TypeDef *hqueue);
+void              BSP_ESMCQUEUE_ReqCpltCallback(BSP_ESMCQUEUE_TypeDef *hqueue, BSP_ESMCQUEUE_ReqTypeDef *pReq);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ESMCQUEUE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
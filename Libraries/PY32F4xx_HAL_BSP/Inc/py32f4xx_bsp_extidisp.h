@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_extidisp.h
+  * @author  MCU Application Team
+  * @brief   Header file of the EXTI dispatcher BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_EXTIDISP_H
+#define __PY32F4XX_BSP_EXTIDISP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_GPIO_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_EXTIDISP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Exported_Constants BSP EXTIDISP Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_EXTIDISP_Mode BSP EXTIDISP Mode
+  * @{
+  */
+#define BSP_EXTIDISP_MODE_IMMEDIATE     0x00000000U    /*!< Handler called from the EXTI interrupt    */
+#define BSP_EXTIDISP_MODE_DEFERRED      0x00000001U    /*!< Handler called from the software interrupt */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_EXTIDISP_Vector_Lines BSP EXTIDISP Vector Lines
+  * @{
+  */
+#define BSP_EXTIDISP_LINES_9_5          0x000003E0U    /*!< Lines of EXTI9_5_IRQn                     */
+#define BSP_EXTIDISP_LINES_15_10        0x0000FC00U    /*!< Lines of EXTI15_10_IRQn                   */
+/**
+  * @}
+  */
+
+#define BSP_EXTIDISP_LINES              16U            /*!< GPIO lines of the EXTI                    */
+
+#if !defined (BSP_EXTIDISP_SWI_IRQn)
+#define BSP_EXTIDISP_SWI_IRQn           PendSV_IRQn    /*!< Software interrupt of the deferred
+                                                            handlers, an unused vector at a low
+                                                            priority, its handler calling
+                                                            BSP_EXTIDISP_DeferredHandler()            */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Exported_Types BSP EXTIDISP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  EXTI line statistics definition
+  */
+typedef struct
+{
+  uint32_t                Events;       /*!< Edges dispatched                                       */
+
+  uint32_t                Overruns;     /*!< Edges merged, the deferred handler not run yet         */
+
+} BSP_EXTIDISP_StatsTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_EXTIDISP_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_EXTIDISP_Register(uint32_t Line, void (*Handler)(uint32_t Line, void *pContext),
+                                        void *pContext, uint32_t Mode);
+void              BSP_EXTIDISP_Unregister(uint32_t Line);
+void              BSP_EXTIDISP_IRQHandler(uint32_t Lines);
+void              BSP_EXTIDISP_DeferredHandler(void);
+void              BSP_EXTIDISP_GetStats(uint32_t Line, BSP_EXTIDISP_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_GPIO_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_EXTIDISP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,153 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fault.h
+  * @author  MCU Application Team
+  * @brief   Header file of the fault record BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FAULT_H
+#define __PY32F4XX_BSP_FAULT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FAULT
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_FAULT_Exported_Constants BSP FAULT Exported Constants
+  * @{
+  */
+#if !defined (BSP_FAULT_BACKTRACE)
+#define BSP_FAULT_BACKTRACE             8U             /*!< Return addresses kept from the stack          */
+#endif /* BSP_FAULT_BACKTRACE */
+
+#if !defined (BSP_FAULT_SCAN_WORDS)
+#define BSP_FAULT_SCAN_WORDS            256U           /*!< Stack words scanned for return addresses      */
+#endif /* BSP_FAULT_SCAN_WORDS */
+
+#if !defined (BSP_FAULT_STACK_SIZE)
+#define BSP_FAULT_STACK_SIZE            256U           /*!< Bytes of the stack of the handler, in the bss */
+#endif /* BSP_FAULT_STACK_SIZE */
+
+/** @defgroup BSP_FAULT_Type BSP FAULT Type
+  * @{
+  */
+#define BSP_FAULT_TYPE_NMI              2U             /*!< NMI                                           */
+#define BSP_FAULT_TYPE_HARDFAULT        3U             /*!< HardFault, escalated or vector read error     */
+#define BSP_FAULT_TYPE_MEMMANAGE        4U             /*!< MemManage fault                               */
+#define BSP_FAULT_TYPE_BUSFAULT         5U             /*!< BusFault                                      */
+#define BSP_FAULT_TYPE_USAGEFAULT       6U             /*!< UsageFault                                    */
+#define BSP_FAULT_TYPE_SOFTWARE         0x100U         /*!< BSP_FAULT_Reset() by the application          */
+#define BSP_FAULT_TYPE_STACK            0x101U         /*!< BSP_FAULT_Reset() on a stack overflow         */
+#define BSP_FAULT_TYPE_WATCHDOG         0x102U         /*!< BSP_FAULT_Reset() before a watchdog reset     */
+#define BSP_FAULT_TYPE_GUARD            0x103U         /*!< BSP_FAULT_Reset() on a BSP_GUARD region hit   */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FAULT_Exported_Types BSP FAULT Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Fault record definition, kept in __NOINIT RAM over the reset
+  */
+typedef struct
+{
+  uint32_t                Magic;        /*!< Record valid and not reported yet                      */
+
+  uint32_t                Count;        /*!< Faults recorded since the power on                     */
+
+  uint32_t                Type;         /*!< Fault, a value of @ref BSP_FAULT_Type                  */
+
+  uint32_t                Info;         /*!< Argument of BSP_FAULT_Reset(), 0 for a fault           */
+
+  uint32_t                Tick;         /*!< HAL_GetTick() at the fault                             */
+
+  uint32_t                R0;           /*!< Stacked frame of the fault                             */
+  uint32_t                R1;
+  uint32_t                R2;
+  uint32_t                R3;
+  uint32_t                R12;
+  uint32_t                LR;
+  uint32_t                PC;
+  uint32_t                xPSR;
+
+  uint32_t                SP;           /*!< Stack pointer before the fault, 0 if unreadable        */
+
+  uint32_t                ExcReturn;    /*!< EXC_RETURN of the handler, bit 2 set for the PSP       */
+
+  uint32_t                CFSR;         /*!< Configurable fault status                              */
+
+  uint32_t                HFSR;         /*!< HardFault status                                       */
+
+  uint32_t                MMFAR;        /*!< MemManage address, valid with CFSR MMARVALID           */
+
+  uint32_t                BFAR;         /*!< BusFault address, valid with CFSR BFARVALID            */
+
+  uint32_t                Backtrace[BSP_FAULT_BACKTRACE]; /*!< Return addresses on the stack, 0 ends */
+
+  uint32_t                Check;        /*!< Checksum of the words before                           */
+
+} BSP_FAULT_RecordTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FAULT_Exported_Functions
+  * @{
+  */
+void              BSP_FAULT_Init(void);
+HAL_StatusTypeDef BSP_FAULT_GetRecord(BSP_FAULT_RecordTypeDef *pRecord);
+void              BSP_FAULT_Print(const BSP_FAULT_RecordTypeDef *pRecord);
+void              BSP_FAULT_Reset(uint32_t Type, uint32_t Info) __NO_RETURN;
+void              BSP_FAULT_Capture(const uint32_t *pFrame, uint32_t ExcReturn) __NO_RETURN;
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FAULT_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
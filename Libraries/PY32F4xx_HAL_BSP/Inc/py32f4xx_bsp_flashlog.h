@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_flashlog.h
+  * @author  MCU Application Team
+  * @brief   Header file of the internal flash log writer BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FLASHLOG_H
+#define __PY32F4XX_BSP_FLASHLOG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FLASHLOG
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_FLASHLOG_Exported_Constants BSP FLASHLOG Exported Constants
+  * @{
+  */
+#define BSP_FLASHLOG_BUFFERS            4U             /*!< Page buffers, one filled while the others wait */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FLASHLOG_Exported_Types BSP FLASHLOG Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Flash log writer state definition
+  */
+typedef struct
+{
+  uint32_t                Address;      /*!< First page of the log, 0 when not initialized          */
+
+  uint32_t                Size;         /*!< Size of the log area, a multiple of FLASH_PAGE_SIZE    */
+
+  uint32_t                Length;       /*!< Bytes accepted, padding of the flushed pages included  */
+
+  uint32_t                WriteAddress; /*!< Next page to program                                   */
+
+  uint32_t                Buffer[BSP_FLASHLOG_BUFFERS][FLASH_PAGE_SIZE / 4U]; /*!< Page images     */
+
+  uint32_t                Head;         /*!< Buffer being filled                                    */
+
+  uint32_t                Fill;         /*!< Bytes in the buffer being filled                       */
+
+  __IO uint32_t           Tail;         /*!< Next full buffer to program                            */
+
+  __IO uint32_t           Count;        /*!< Full buffers waiting for the flash                     */
+
+  __IO uint32_t           Busy;         /*!< A page program runs                                    */
+
+  uint32_t                PageCount;    /*!< Number of pages programmed                             */
+
+  uint32_t                ErrorCount;   /*!< Number of failed page programs                         */
+
+} BSP_FLASHLOG_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FLASHLOG_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_FLASHLOG_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_FLASHLOG_Init(BSP_FLASHLOG_TypeDef *hlog, uint32_t Address, uint32_t Size);
+HAL_StatusTypeDef BSP_FLASHLOG_Erase(BSP_FLASHLOG_TypeDef *hlog);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FLASHLOG_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+HAL_StatusTypeDef BSP_FLASHLOG_Write(BSP_FLASHLOG_TypeDef *hlog, const uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_FLASHLOG_Flush(BSP_FLASHLOG_TypeDef *hlog);
+void              BSP_FLASHLOG_Process(BSP_FLASHLOG_TypeDef *hlog);
+uint32_t          BSP_FLASHLOG_IsIdle(const BSP_FLASHLOG_TypeDef *hlog);
+void              BSP_FLASHLOG_EndOfOperationHandler(BSP_FLASHLOG_TypeDef *hlog);
+void              BSP_FLASHLOG_ErrorHandler(BSP_FLASHLOG_TypeDef *hlog);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FLASHLOG_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
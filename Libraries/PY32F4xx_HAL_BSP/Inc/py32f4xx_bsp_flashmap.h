@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_flashmap.h
+  * @author  MCU Application Team
+  * @brief   Header file of the internal flash layout BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FLASHMAP_H
+#define __PY32F4XX_BSP_FLASHMAP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FLASHMAP
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FLASHMAP_Exported_Types BSP FLASHMAP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Flash layout definition
+  */
+typedef struct
+{
+  uint32_t                Size;         /*!< Flash size of the device, FLASH_SIZE                   */
+
+  uint32_t                PageCount;    /*!< Program units of FLASH_PAGE_SIZE                       */
+
+  uint32_t                SectorCount;  /*!< Erase units of FLASH_SECTOR_SIZE                       */
+
+  uint32_t                BlockCount;   /*!< Write protection units of FLASH_BLOCK_SIZE             */
+
+  uint32_t                LinkStart;    /*!< First byte of the FLASH area of the linker script      */
+
+  uint32_t                LinkEnd;      /*!< End of the FLASH area of the linker script, excluded   */
+
+  uint32_t                ImageEnd;     /*!< End of the code and data of the image, excluded        */
+
+  uint32_t                WRPBlocks;    /*!< Write protected blocks, a combination of
+                                             @ref FLASH_Option_Bytes_Write_Protection             */
+
+  uint32_t                RDPLevel;     /*!< Read protection, a value of @ref FLASH_OB_Read_Protection */
+
+} BSP_FLASHMAP_InfoTypeDef;
+
+/**
+  * @brief  Flash region definition
+  */
+typedef struct
+{
+  uint32_t                Address;      /*!< First byte, sector aligned                             */
+
+  uint32_t                Size;         /*!< Size in bytes, a multiple of FLASH_SECTOR_SIZE         */
+
+} BSP_FLASHMAP_RegionTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_FLASHMAP_Exported_Macros BSP FLASHMAP Exported Macros
+  * @brief    Compile time geometry, FLASH_SIZE and FLASH_xxx_NB come from the
+  *           device header of MCU_TYPE
+  * @{
+  */
+#define BSP_FLASHMAP_ALIGN_UP(__ADDRESS__, __UNIT__)   (((__ADDRESS__) + (__UNIT__) - 1U) & ~((__UNIT__) - 1U))
+#define BSP_FLASHMAP_ALIGN_DOWN(__ADDRESS__, __UNIT__) ((__ADDRESS__) & ~((__UNIT__) - 1U))
+#define BSP_FLASHMAP_SECTOR_OF(__ADDRESS__)            (((__ADDRESS__) - FLASH_BASE) / FLASH_SECTOR_SIZE)
+#define BSP_FLASHMAP_BLOCK_OF(__ADDRESS__)             (((__ADDRESS__) - FLASH_BASE) / FLASH_BLOCK_SIZE)
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FLASHMAP_Exported_Functions
+  * @{
+  */
+void              BSP_FLASHMAP_GetInfo(BSP_FLASHMAP_InfoTypeDef *pInfo);
+uint32_t          BSP_FLASHMAP_IsWriteProtected(uint32_t Address, uint32_t Size);
+HAL_StatusTypeDef BSP_FLASHMAP_GetFreeRegion(BSP_FLASHMAP_RegionTypeDef *pRegion);
+HAL_StatusTypeDef BSP_FLASHMAP_Take(BSP_FLASHMAP_RegionTypeDef *pFree, uint32_t Size,
+                                    BSP_FLASHMAP_RegionTypeDef *pRegion);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FLASHMAP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,143 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_frame.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SLIP/COBS frame decoder BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FRAME_H
+#define __PY32F4XX_BSP_FRAME_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FRAME
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FRAME_Exported_Types BSP FRAME Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Frame decoder state definition
+  * @note   The frame being decoded always starts at the ring Tail. Read and Write
+  *         count the encoded bytes scanned and the decoded bytes stored from there,
+  *         the decoding is done in place since Write never passes Read.
+  */
+typedef struct
+{
+  DMA_RingTypeDef         *pRing;       /*!< Receive ring, attached to the UART Rx DMA             */
+
+  uint32_t                Protocol;     /*!< Framing, a value of @ref BSP_FRAME_Protocol           */
+
+  uint32_t                Read;         /*!< Encoded bytes scanned since the frame start            */
+
+  uint32_t                Write;        /*!< Decoded bytes stored since the frame start             */
+
+  uint32_t                State;        /*!< Decoder state flags                                    */
+
+  uint32_t                Remaining;    /*!< COBS data bytes left in the current block              */
+
+  uint32_t                Consumed;     /*!< Ring bytes of the frame returned, 0 when none is       */
+
+  uint32_t                ErrorCount;   /*!< Number of frames dropped, malformed or too long        */
+
+} BSP_FRAME_TypeDef;
+
+/**
+  * @brief  Decoded frame descriptor
+  * @note   The frame stays in the ring, it is split in two parts when it wraps
+  *         at the end of the ring storage.
+  */
+typedef struct
+{
+  uint8_t                 *pData;       /*!< First part of the frame                                */
+
+  uint32_t                Length;       /*!< Length of the first part                               */
+
+  uint8_t                 *pWrap;       /*!< Second part of the frame, at the ring start            */
+
+  uint32_t                WrapLength;   /*!< Length of the second part, 0 when the frame does not wrap */
+
+} BSP_FRAME_DescTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_FRAME_Exported_Constants BSP FRAME Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_FRAME_Protocol BSP FRAME Protocol
+  * @{
+  */
+#define BSP_FRAME_PROTOCOL_SLIP         0x00000000U    /*!< RFC 1055 SLIP, frames ended by 0xC0          */
+#define BSP_FRAME_PROTOCOL_COBS         0x00000001U    /*!< Consistent overhead byte stuffing, ended by 0x00 */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FRAME_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_FRAME_Exported_Functions_Group1
+  * @{
+  */
+/* Frame decoding functions ***************************************************/
+HAL_StatusTypeDef BSP_FRAME_Init(BSP_FRAME_TypeDef *hframe, DMA_RingTypeDef *pRing, uint32_t Protocol);
+HAL_StatusTypeDef BSP_FRAME_Get(BSP_FRAME_TypeDef *hframe, BSP_FRAME_DescTypeDef *pDesc);
+void              BSP_FRAME_Release(BSP_FRAME_TypeDef *hframe);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FRAME_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
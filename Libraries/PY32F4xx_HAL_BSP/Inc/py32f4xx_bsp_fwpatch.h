@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fwpatch.h
+  * @author  MCU Application Team
+  * @brief   Header file of the delta firmware update BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FWPATCH_H
+#define __PY32F4XX_BSP_FWPATCH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_fwupdate.h"
+#include "py32f4xx_bsp_lzss.h"
+
+#if defined (HAL_FLASH_MODULE_ENABLED) && defined (HAL_CRC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FWPATCH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_FWPATCH_Exported_Constants BSP FWPATCH Exported Constants
+  * @{
+  */
+#define BSP_FWPATCH_MAGIC               0x54505746U    /*!< "FWPT", first word of a patch                   */
+
+#ifndef BSP_FWPATCH_WINDOW_BITS
+#define BSP_FWPATCH_WINDOW_BITS         10U            /*!< Largest LZSS window of a patch, 1 KB of RAM     */
+#endif
+
+#ifndef BSP_FWPATCH_BODY_SIZE
+#define BSP_FWPATCH_BODY_SIZE           64U            /*!< Bytes of the patch expanded at once             */
+#endif
+
+/** @defgroup BSP_FWPATCH_State BSP FWPATCH State
+  * @{
+  */
+#define BSP_FWPATCH_STATE_IDLE          0x00000000U    /*!< No update                                       */
+#define BSP_FWPATCH_STATE_HEADER        0x00000001U    /*!< Taking the header of the patch                  */
+#define BSP_FWPATCH_STATE_BODY          0x00000002U    /*!< Applying the records of the patch               */
+#define BSP_FWPATCH_STATE_COMMIT        0x00000003U    /*!< New image complete, checked by BSP_FWUPDATE     */
+#define BSP_FWPATCH_STATE_DONE          0x00000004U    /*!< New image valid, taken on the next reset        */
+#define BSP_FWPATCH_STATE_ERROR         0x00000005U    /*!< Patch not for the running image, corrupted or
+                                                            update failed: the running image stays selected */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FWPATCH_Exported_Types BSP FWPATCH Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Patch header, the first 32 bytes of a patch, little endian
+  */
+typedef struct
+{
+  uint32_t                Magic;        /*!< BSP_FWPATCH_MAGIC                                      */
+
+  uint32_t                OldSize;      /*!< Size of the running image, from its trailer            */
+
+  uint32_t                OldCrc;       /*!< CRC of the running image, from its trailer             */
+
+  uint32_t                NewSize;      /*!< Size of the new image                                  */
+
+  uint32_t                NewVersion;   /*!< Version of the new image                               */
+
+  uint32_t                NewCrc;       /*!< CRC of the new image, see BSP_FWUPDATE_TrailerTypeDef  */
+
+  uint8_t                 WindowBits;   /*!< LZSS window of the records                             */
+
+  uint8_t                 LookaheadBits; /*!< LZSS lookahead of the records                         */
+
+  uint16_t                Reserved;     /*!< 0                                                      */
+
+  uint32_t                Check;        /*!< Complement of the XOR of the words above               */
+
+} BSP_FWPATCH_HeaderTypeDef;
+
+/**
+  * @brief  Delta firmware update state definition
+  */
+typedef struct
+{
+  BSP_FWUPDATE_TypeDef    *hfw;         /*!< A/B update agent programming the new image             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_FWPATCH_State                      */
+
+  BSP_FWPATCH_HeaderTypeDef Header;     /*!< Header of the patch                                    */
+
+  uint32_t                HeaderFill;   /*!< Bytes of the header taken                              */
+
+  const uint8_t           *pOld;        /*!< Running image, read in place                           */
+
+  BSP_LZSS_DecTypeDef     Dec;          /*!< Decoder of the records                                 */
+
+  uint8_t                 Window[BSP_LZSS_DEC_WINDOW_SIZE(BSP_FWPATCH_WINDOW_BITS)]; /*!< LZSS window */
+
+  uint8_t                 In[FLASH_PAGE_SIZE]; /*!< Chunk of the patch given by BSP_FWPATCH_Write()  */
+
+  __IO uint32_t           InSize;       /*!< Bytes of the chunk, 0 when the chunk is taken          */
+
+  uint32_t                InPos;        /*!< Bytes of the chunk used                                */
+
+  uint8_t                 Body[BSP_FWPATCH_BODY_SIZE]; /*!< Records expanded                        */
+
+  uint32_t                BodySize;     /*!< Bytes of records expanded                              */
+
+  uint32_t                BodyPos;      /*!< Bytes of records used                                  */
+
+  uint8_t                 Out[FLASH_PAGE_SIZE]; /*!< Bytes of the new image for BSP_FWUPDATE_Write() */
+
+  uint32_t                OutFill;      /*!< Bytes in Out                                           */
+
+  uint32_t                Field;        /*!< Field of the record being read                         */
+
+  uint32_t                Value;        /*!< Varint being read                                      */
+
+  uint32_t                Shift;        /*!< Bits of the varint read                                */
+
+  uint32_t                DiffLeft;     /*!< Bytes of the difference left, added to the old ones    */
+
+  uint32_t                ExtraLeft;    /*!< Bytes of the new image left, copied                    */
+
+  uint32_t                OldPos;       /*!< Next byte read in the running image                    */
+
+  uint32_t                NewPos;       /*!< Bytes of the new image made                            */
+
+  uint32_t                Received;     /*!< Bytes of the patch taken                               */
+
+} BSP_FWPATCH_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FWPATCH_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_FWPATCH_Init(BSP_FWPATCH_TypeDef *hpatch, BSP_FWUPDATE_TypeDef *hfw);
+HAL_StatusTypeDef BSP_FWPATCH_Begin(BSP_FWPATCH_TypeDef *hpatch);
+HAL_StatusTypeDef BSP_FWPATCH_Write(BSP_FWPATCH_TypeDef *hpatch, const uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_FWPATCH_Process(BSP_FWPATCH_TypeDef *hpatch);
+void              BSP_FWPATCH_Abort(BSP_FWPATCH_TypeDef *hpatch);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED && HAL_CRC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FWPATCH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,204 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fwupdate.h
+  * @author  MCU Application Team
+  * @brief   Header file of the A/B firmware update BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_FWUPDATE_H
+#define __PY32F4XX_BSP_FWUPDATE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_FLASH_MODULE_ENABLED) && defined (HAL_CRC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_FWUPDATE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_FWUPDATE_Exported_Constants BSP FWUPDATE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_FWUPDATE_Layout BSP FWUPDATE Flash Layout
+  * @brief    Matches the FW_SLOT linker scripts the Makefile generates for
+  *           MCU_TYPE: 56, 120 or 184 Kbytes slots for PY32F403xB, xC or xD
+  * @{
+  */
+#define BSP_FWUPDATE_BOOT_SIZE          0x4000U        /*!< Bootloader, first sectors of the flash    */
+#define BSP_FWUPDATE_SLOT_SIZE          (((FLASH_SIZE - BSP_FWUPDATE_BOOT_SIZE) / 2U) & ~(FLASH_SECTOR_SIZE - 1U)) /*!<
+                                                            Application slot, half of the rest of the
+                                                            flash in whole sectors                        */
+#define BSP_FWUPDATE_SLOT_A_ADDRESS     (FLASH_BASE + BSP_FWUPDATE_BOOT_SIZE)                   /*!< Slot A */
+#define BSP_FWUPDATE_SLOT_B_ADDRESS     (BSP_FWUPDATE_SLOT_A_ADDRESS + BSP_FWUPDATE_SLOT_SIZE) /*!< Slot B */
+#define BSP_FWUPDATE_IMAGE_MAX          (BSP_FWUPDATE_SLOT_SIZE - FLASH_PAGE_SIZE) /*!< Image bytes, the last
+                                                            page of a slot holds its trailer              */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_FWUPDATE_Slot BSP FWUPDATE Slot
+  * @{
+  */
+#define BSP_FWUPDATE_SLOT_A             0U             /*!< Slot A                                    */
+#define BSP_FWUPDATE_SLOT_B             1U             /*!< Slot B                                    */
+#define BSP_FWUPDATE_SLOT_NONE          0xFFFFFFFFU    /*!< No valid slot                             */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_FWUPDATE_State BSP FWUPDATE State
+  * @{
+  */
+#define BSP_FWUPDATE_STATE_IDLE         0x00000000U    /*!< No update                                 */
+#define BSP_FWUPDATE_STATE_RECEIVE      0x00000001U    /*!< Taking the image with BSP_FWUPDATE_Write() */
+#define BSP_FWUPDATE_STATE_PROGRAM      0x00000002U    /*!< Image complete, last pages programmed     */
+#define BSP_FWUPDATE_STATE_COMMIT       0x00000003U    /*!< CRC checked, trailer programmed           */
+#define BSP_FWUPDATE_STATE_DONE         0x00000004U    /*!< New image valid, taken on the next reset  */
+#define BSP_FWUPDATE_STATE_ERROR        0x00000005U    /*!< Flash error or CRC mismatch, the running
+                                                            image stays selected                          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_FWUPDATE_Exported_Types BSP FWUPDATE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Slot trailer definition, first words of the last page of a slot
+  */
+typedef struct
+{
+  uint32_t                Magic;        /*!< BSP_FWUPDATE trailer marker                            */
+
+  uint32_t                Version;      /*!< Image version, the highest valid slot boots            */
+
+  uint32_t                Size;         /*!< Image size in bytes                                    */
+
+  uint32_t                Crc;          /*!< CRC peripheral default CRC-32 of the image, padded to
+                                             a word with 0xFF                                          */
+
+  uint32_t                Check;        /*!< Complement of the XOR of the fields above              */
+
+} BSP_FWUPDATE_TrailerTypeDef;
+
+/**
+  * @brief  Firmware update agent state definition
+  */
+typedef struct
+{
+  CRC_HandleTypeDef       *hcrc;        /*!< CRC used to check the images, NULL when not initialized */
+
+  uint32_t                Slot;         /*!< Slot written, a value of @ref BSP_FWUPDATE_Slot        */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_FWUPDATE_State                     */
+
+  BSP_FWUPDATE_TrailerTypeDef Trailer;  /*!< Trailer of the image received                          */
+
+  uint32_t                Received;     /*!< Image bytes taken                                      */
+
+  uint32_t                ProgramAddress; /*!< Next page to program                                 */
+
+  uint32_t                EraseAddress; /*!< End of the sectors erased for the image                */
+
+  uint32_t                TrailerErased; /*!< The trailer sector is erased                          */
+
+  uint32_t                Buffer[2][FLASH_PAGE_SIZE / 4U]; /*!< Page being received and page waiting */
+
+  uint32_t                Head;         /*!< Buffer being received                                  */
+
+  uint32_t                Fill;         /*!< Bytes in the buffer being received                     */
+
+  __IO uint32_t           Count;        /*!< Full buffers waiting for the flash                     */
+
+  __IO uint32_t           Busy;         /*!< A program or an erase runs                             */
+
+} BSP_FWUPDATE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_FWUPDATE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_FWUPDATE_Exported_Functions_Group1
+  * @{
+  */
+/* Slot functions *************************************************************/
+uint32_t          BSP_FWUPDATE_GetSlotAddress(uint32_t Slot);
+uint32_t          BSP_FWUPDATE_GetRunningSlot(void);
+HAL_StatusTypeDef BSP_FWUPDATE_CheckSlot(CRC_HandleTypeDef *hcrc, uint32_t Slot, uint32_t *pVersion);
+uint32_t          BSP_FWUPDATE_SelectSlot(CRC_HandleTypeDef *hcrc);
+void              BSP_FWUPDATE_Jump(uint32_t Slot);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FWUPDATE_Exported_Functions_Group2
+  * @{
+  */
+/* Update functions ***********************************************************/
+HAL_StatusTypeDef BSP_FWUPDATE_Init(BSP_FWUPDATE_TypeDef *hfw, CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef BSP_FWUPDATE_Begin(BSP_FWUPDATE_TypeDef *hfw, uint32_t Size, uint32_t Version, uint32_t Crc);
+HAL_StatusTypeDef BSP_FWUPDATE_Write(BSP_FWUPDATE_TypeDef *hfw, const uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_FWUPDATE_Process(BSP_FWUPDATE_TypeDef *hfw);
+void              BSP_FWUPDATE_Abort(BSP_FWUPDATE_TypeDef *hfw);
+void              BSP_FWUPDATE_EndOfOperationHandler(BSP_FWUPDATE_TypeDef *hfw);
+void              BSP_FWUPDATE_ErrorHandler(BSP_FWUPDATE_TypeDef *hfw);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED && HAL_CRC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_FWUPDATE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
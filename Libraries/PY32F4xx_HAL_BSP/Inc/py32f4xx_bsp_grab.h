@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_grab.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI line and frame grabber BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_GRAB_H
+#define __PY32F4XX_BSP_GRAB_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_SPI_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_GRAB
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_GRAB_Exported_Constants BSP GRAB Exported Constants
+  * @{
+  */
+#if !defined (BSP_GRAB_LINES_MAX)
+#define BSP_GRAB_LINES_MAX              32U            /*!< Lines of a ring, a power of two           */
+#endif /* BSP_GRAB_LINES_MAX */
+
+/** @defgroup BSP_GRAB_Sync BSP GRAB Sync
+  * @{
+  */
+#define BSP_GRAB_SYNC_NSS               0x00000000U    /*!< Line valid of the sensor on the NSS pin of a
+                                                            slave SPI, the lines follow each other in
+                                                            the DMA without software on the line start */
+#define BSP_GRAB_SYNC_SOFT              0x00000001U    /*!< Line started by BSP_GRAB_SyncHandler() from
+                                                            an EXTI or a timer callback                */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_GRAB_State BSP GRAB State
+  * @{
+  */
+#define BSP_GRAB_STATE_RESET            0x00000000U    /*!< Not initialized                           */
+#define BSP_GRAB_STATE_READY            0x00000001U    /*!< Initialized, capture stopped              */
+#define BSP_GRAB_STATE_RUN              0x00000002U    /*!< Capture running                           */
+#define BSP_GRAB_STATE_ERROR            0x00000003U    /*!< DMA error, the capture is stopped         */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_GRAB_Exported_Types BSP GRAB Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Captured line definition
+  */
+typedef struct
+{
+  uint8_t                 *pData;       /*!< LineSize bytes, written by the DMA                      */
+
+  uint32_t                Frame;        /*!< Frame of the line since the start                       */
+
+  uint32_t                Line;         /*!< Line in its frame, from 0, or since the start without
+                                             frames                                                 */
+
+  uint32_t                Timestamp;    /*!< DWT cycle count when the DMA was given the line         */
+
+} BSP_GRAB_LineTypeDef;
+
+/**
+  * @brief  Grabber definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< SPI receiving the pixels, its Rx DMA owned by the
+                                             service                                                */
+
+  TIM_HandleTypeDef       *htim;        /*!< Timer of the pixel clock, NULL when the sensor or the
+                                             master SPI gives it                                    */
+
+  uint32_t                Channel;      /*!< PWM channel of the pixel clock, TIM_CHANNEL_x          */
+
+  uint32_t                Sync;         /*!< A value of @ref BSP_GRAB_Sync                          */
+
+  BSP_GRAB_LineTypeDef    *pLines;      /*!< Line ring                                              */
+
+  uint32_t                LineCount;    /*!< Lines in the ring, 3 to BSP_GRAB_LINES_MAX             */
+
+  uint32_t                LineSize;     /*!< Bytes per line, 1 to 0xFFFF                            */
+
+  uint32_t                LinesPerFrame; /*!< Lines of a frame, 0 for frames ended by
+                                             BSP_GRAB_FrameHandler() only                           */
+
+  uint8_t                 Slots[2];     /*!< Lines in memory 0 and memory 1 of the DMA, Slots[0]
+                                             only with BSP_GRAB_SYNC_SOFT                           */
+
+  uint32_t                Frame;        /*!< Frame of the next line completed                       */
+
+  uint32_t                Line;         /*!< Line in the frame of the next line completed          */
+
+  uint8_t                 Free[BSP_GRAB_LINES_MAX]; /*!< Released lines, written by thread mode      */
+
+  __IO uint32_t           FreeHead;     /*!< Next entry of Free written by BSP_GRAB_Release()       */
+
+  __IO uint32_t           FreeTail;     /*!< Next entry of Free taken by the DMA callbacks          */
+
+  uint8_t                 Ready[BSP_GRAB_LINES_MAX]; /*!< Full lines, written by the DMA callbacks   */
+
+  __IO uint32_t           ReadyHead;    /*!< Next entry of Ready written by the DMA callbacks       */
+
+  __IO uint32_t           ReadyTail;    /*!< Next entry of Ready taken by BSP_GRAB_Get()            */
+
+  __IO uint32_t           Overruns;     /*!< Lines dropped for lack of a free line                  */
+
+  __IO uint32_t           Resyncs;      /*!< Lines or frames cut short by a sync, the capture
+                                             realigned on it                                        */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_GRAB_State                         */
+
+} BSP_GRAB_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_GRAB_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_GRAB_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_GRAB_Init(BSP_GRAB_TypeDef *hgrab, SPI_HandleTypeDef *hspi, uint32_t Sync,
+                                BSP_GRAB_LineTypeDef *pLines, uint8_t *pStorage, uint32_t LineCount,
+                                uint32_t LineSize, uint32_t LinesPerFrame);
+HAL_StatusTypeDef BSP_GRAB_SetPixelClock(BSP_GRAB_TypeDef *hgrab, TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef BSP_GRAB_Start(BSP_GRAB_TypeDef *hgrab);
+HAL_StatusTypeDef BSP_GRAB_Stop(BSP_GRAB_TypeDef *hgrab);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_GRAB_Exported_Functions_Group2
+  * @{
+  */
+/* Capture functions **********************************************************/
+void              BSP_GRAB_SyncHandler(BSP_GRAB_TypeDef *hgrab);
+void              BSP_GRAB_FrameHandler(BSP_GRAB_TypeDef *hgrab);
+BSP_GRAB_LineTypeDef *BSP_GRAB_Get(BSP_GRAB_TypeDef *hgrab);
+void              BSP_GRAB_Release(BSP_GRAB_TypeDef *hgrab, BSP_GRAB_LineTypeDef *pLine);
+void              BSP_GRAB_LineCpltCallback(BSP_GRAB_TypeDef *hgrab, BSP_GRAB_LineTypeDef *pLine);
+void              BSP_GRAB_FrameCpltCallback(BSP_GRAB_TypeDef *hgrab, uint32_t Frame);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_GRAB_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,105 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_guard.h
+  * @author  MCU Application Team
+  * @brief   Header file of the memory guard BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_GUARD_H
+#define __PY32F4XX_BSP_GUARD_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_GUARD
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Exported_Constants BSP GUARD Exported Constants
+  * @{
+  */
+#if !defined (BSP_GUARD_NULL_SIZE)
+#define BSP_GUARD_NULL_SIZE             0x400U         /*!< Bytes from address 0 trapped, a power of 2     */
+#endif /* BSP_GUARD_NULL_SIZE */
+
+#if !defined (BSP_GUARD_STACK_SIZE)
+#define BSP_GUARD_STACK_SIZE            64U            /*!< Bytes at the bottom of the stack, a power of 2 */
+#endif /* BSP_GUARD_STACK_SIZE */
+
+/** @defgroup BSP_GUARD_Region BSP GUARD Region
+  * @{
+  */
+#define BSP_GUARD_NULL                  0U             /*!< Null page, read and write trapped              */
+#define BSP_GUARD_STACK                 1U             /*!< Bottom of the main stack, write trapped        */
+#define BSP_GUARD_SRAM_XN               2U             /*!< SRAM above the data, execution trapped         */
+#define BSP_GUARD_USER                  3U             /*!< Left to BSP_GUARD_Watch()                      */
+#define BSP_GUARD_REGIONS               4U             /*!< DWT comparators used                           */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_GUARD_Access BSP GUARD Access
+  * @{
+  */
+#define BSP_GUARD_ACCESS_EXECUTE        0x4U           /*!< Instruction fetch, DWT FUNCTION PC match       */
+#define BSP_GUARD_ACCESS_READ           0x5U           /*!< Data read                                      */
+#define BSP_GUARD_ACCESS_WRITE          0x6U           /*!< Data write                                     */
+#define BSP_GUARD_ACCESS_READ_WRITE     0x7U           /*!< Data read or write                             */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_GUARD_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_GUARD_Init(void);
+HAL_StatusTypeDef BSP_GUARD_Watch(uint32_t Region, uint32_t Address, uint32_t Size, uint32_t Access);
+void              BSP_GUARD_Disable(uint32_t Region);
+void              BSP_GUARD_Capture(const uint32_t *pFrame);
+void              BSP_GUARD_Callback(uint32_t Region, uint32_t Pc);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_GUARD_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
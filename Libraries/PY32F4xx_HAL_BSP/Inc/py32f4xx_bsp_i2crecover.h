@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2crecover.h
+  * @author  MCU Application Team
+  * @brief   Header file of the I2C bus recovery BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_I2CRECOVER_H
+#define __PY32F4XX_BSP_I2CRECOVER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_I2CRECOVER
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_I2CRECOVER_Exported_Constants BSP I2CRECOVER Exported Constants
+  * @{
+  */
+
+#define BSP_I2CRECOVER_PULSES           9U             /*!< SCL pulses releasing a device holding SDA */
+#define BSP_I2CRECOVER_PULSE_FREQ       100000U        /*!< SCL frequency of the pulses, Hz           */
+#define BSP_I2CRECOVER_STRETCH_MAX      10U            /*!< Half periods a device may hold SCL low    */
+#define BSP_I2CRECOVER_IDLE_BITS        20U            /*!< Bit times the bus is given to get idle    */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_I2CRECOVER_Exported_Types BSP I2CRECOVER Exported Types
+  * @{
+  */
+
+/**
+  * @brief  I2C bus recovery state definition
+  */
+typedef struct
+{
+  I2C_HandleTypeDef       *hi2c;        /*!< I2C in master mode, NULL when not initialized          */
+
+  GPIO_TypeDef            *SclPort;     /*!< GPIO port of SCL                                       */
+
+  uint32_t                SclPin;       /*!< GPIO pin of SCL, a value of @ref GPIO_pins             */
+
+  GPIO_TypeDef            *SdaPort;     /*!< GPIO port of SDA                                       */
+
+  uint32_t                SdaPin;       /*!< GPIO pin of SDA, a value of @ref GPIO_pins             */
+
+  uint32_t                HalfPeriod;   /*!< Half period of the SCL pulses, CPU cycles              */
+
+  uint32_t                IdleWait;     /*!< Time the bus is given to get idle, CPU cycles          */
+
+  uint32_t                RunCount;     /*!< Number of recoveries run                               */
+
+  uint32_t                FailCount;    /*!< Recoveries leaving a line low                          */
+
+} BSP_I2CRECOVER_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_I2CRECOVER_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_I2CRECOVER_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_I2CRECOVER_Init(BSP_I2CRECOVER_TypeDef *hrecover, I2C_HandleTypeDef *hi2c,
+                                      GPIO_TypeDef *SclPort, uint32_t SclPin,
+                                      GPIO_TypeDef *SdaPort, uint32_t SdaPin);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CRECOVER_Exported_Functions_Group2
+  * @{
+  */
+/* Recovery functions *********************************************************/
+HAL_StatusTypeDef BSP_I2CRECOVER_Check(BSP_I2CRECOVER_TypeDef *hrecover);
+HAL_StatusTypeDef BSP_I2CRECOVER_Recover(BSP_I2CRECOVER_TypeDef *hrecover);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_I2CRECOVER_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,224 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2csched.h
+  * @author  MCU Application Team
+  * @brief   Header file of the I2C job scheduler BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_I2CSCHED_H
+#define __PY32F4XX_BSP_I2CSCHED_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_i2crecover.h"
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_I2CSCHED
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_I2CSCHED_Exported_Types BSP I2CSCHED Exported Types
+  * @{
+  */
+
+/**
+  * @brief  I2C register read job definition
+  */
+typedef struct
+{
+  uint16_t                DevAddress;   /*!< Target device address, 7-bit address shifted left      */
+
+  uint16_t                MemAddress;   /*!< First register read                                    */
+
+  uint16_t                MemAddSize;   /*!< Register address size, a value of I2C_MEMADD_SIZE_*    */
+
+  uint16_t                Size;         /*!< Number of bytes read                                   */
+
+  uint8_t                 *pData;       /*!< Destination of the registers                           */
+
+  uint32_t                Period;       /*!< Ticks between two reads, 0 to disable the job          */
+
+  uint32_t                Countdown;    /*!< Ticks before the next read, set by BSP_I2CSCHED_Init() */
+
+  __IO uint32_t           Status;       /*!< Result of the last read, a value of @ref BSP_I2CSCHED_Status */
+
+  uint32_t                ErrorCount;   /*!< Number of failed reads once the retries are exhausted  */
+
+} BSP_I2CSCHED_JobTypeDef;
+
+/**
+  * @brief  I2C register write definition, queued once with BSP_I2CSCHED_Write()
+  */
+typedef struct __BSP_I2CSCHED_WriteTypeDef
+{
+  uint16_t                DevAddress;   /*!< Target device address, 7-bit address shifted left      */
+
+  uint16_t                MemAddress;   /*!< First register written, or control byte                */
+
+  uint16_t                MemAddSize;   /*!< Register address size, a value of I2C_MEMADD_SIZE_*    */
+
+  uint16_t                Size;         /*!< Number of bytes written                                */
+
+  const uint8_t           *pData;       /*!< Source of the registers, read by the DMA until the end */
+
+  __IO uint32_t           Status;       /*!< DUE while queued or on the bus, then the result, a value
+                                             of @ref BSP_I2CSCHED_Status                            */
+
+  void                    *pOwner;      /*!< Free for the service queuing the write                 */
+
+  struct __BSP_I2CSCHED_WriteTypeDef *pNext; /*!< Next queued write, set by the scheduler           */
+
+} BSP_I2CSCHED_WriteTypeDef;
+
+/**
+  * @brief  I2C job scheduler state definition
+  */
+typedef struct
+{
+  I2C_HandleTypeDef       *hi2c;        /*!< I2C in master mode, NULL when not initialized          */
+
+  BSP_I2CSCHED_JobTypeDef *pJobs;       /*!< Job table, issued in table order                       */
+
+  uint32_t                JobCount;     /*!< Number of jobs in the table                            */
+
+  uint32_t                Retries;      /*!< Extra attempts of a failed read                        */
+
+  __IO uint32_t           Current;      /*!< Job on the bus, JobCount when no cycle runs            */
+
+  uint32_t                Attempt;      /*!< Attempts of the current job                            */
+
+  uint32_t                CycleErrors;  /*!< Jobs failed in the current cycle                       */
+
+  uint32_t                CycleCount;   /*!< Number of completed cycles                             */
+
+  uint32_t                OverrunCount; /*!< Ticks skipped because the previous cycle ran           */
+
+  BSP_I2CRECOVER_TypeDef  *hrecover;    /*!< Bus recovery, NULL for none                            */
+
+  uint32_t                StallCount;   /*!< Ticks the current job has been on the bus              */
+
+  BSP_I2CSCHED_WriteTypeDef *pWriteHead; /*!< First queued write, on the bus when pWriting is set   */
+
+  BSP_I2CSCHED_WriteTypeDef *pWriteTail; /*!< Last queued write                                     */
+
+  BSP_I2CSCHED_WriteTypeDef *__IO pWriting; /*!< Write on the bus, NULL for none                    */
+
+  uint32_t                CyclePending; /*!< First due job of a cycle waiting for the write on the
+                                             bus, JobCount for none                                 */
+
+  uint32_t                WriteCount;   /*!< Number of completed writes                             */
+
+} BSP_I2CSCHED_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_I2CSCHED_Exported_Constants BSP I2CSCHED Exported Constants
+  * @{
+  */
+
+#define BSP_I2CSCHED_STALL_TICKS        2U             /*!< Ticks a job may stay on the bus before the
+                                                            bus is recovered                           */
+
+/** @defgroup BSP_I2CSCHED_Status BSP I2CSCHED Status
+  * @{
+  */
+#define BSP_I2CSCHED_STATUS_NONE        0x00000000U    /*!< Never read                                */
+#define BSP_I2CSCHED_STATUS_DUE         0x00000001U    /*!< Read in the current cycle, write queued   */
+#define BSP_I2CSCHED_STATUS_OK          0x00000002U    /*!< pData holds the last read, write done     */
+#define BSP_I2CSCHED_STATUS_NACK        0x00000003U    /*!< Device not acknowledging                  */
+#define BSP_I2CSCHED_STATUS_ERROR       0x00000004U    /*!< Bus, arbitration or DMA error             */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_I2CSCHED_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_I2CSCHED_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_I2CSCHED_Init(BSP_I2CSCHED_TypeDef *hsched, I2C_HandleTypeDef *hi2c,
+                                    BSP_I2CSCHED_JobTypeDef *pJobs, uint32_t JobCount, uint32_t Retries);
+HAL_StatusTypeDef BSP_I2CSCHED_DeInit(BSP_I2CSCHED_TypeDef *hsched);
+HAL_StatusTypeDef BSP_I2CSCHED_SetRecovery(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CRECOVER_TypeDef *hrecover);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CSCHED_Exported_Functions_Group2
+  * @{
+  */
+/* Scheduling functions *******************************************************/
+void              BSP_I2CSCHED_Tick(BSP_I2CSCHED_TypeDef *hsched);
+uint32_t          BSP_I2CSCHED_IsIdle(const BSP_I2CSCHED_TypeDef *hsched);
+void              BSP_I2CSCHED_XferCpltHandler(BSP_I2CSCHED_TypeDef *hsched);
+void              BSP_I2CSCHED_ErrorHandler(BSP_I2CSCHED_TypeDef *hsched);
+void              BSP_I2CSCHED_CycleCpltCallback(BSP_I2CSCHED_TypeDef *hsched, uint32_t Errors);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CSCHED_Exported_Functions_Group3
+  * @{
+  */
+/* Write functions ************************************************************/
+HAL_StatusTypeDef BSP_I2CSCHED_Write(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CSCHED_WriteTypeDef *pWrite);
+void              BSP_I2CSCHED_WriteCpltCallback(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CSCHED_WriteTypeDef *pWrite);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_I2CSCHED_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
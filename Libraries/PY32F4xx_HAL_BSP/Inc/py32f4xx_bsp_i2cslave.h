@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2cslave.h
+  * @author  MCU Application Team
+  * @brief   Header file of the I2C slave register map BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_I2CSLAVE_H
+#define __PY32F4XX_BSP_I2CSLAVE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_I2CSLAVE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_I2CSLAVE_Exported_Constants BSP I2CSLAVE Exported Constants
+  * @{
+  */
+
+#define BSP_I2CSLAVE_REG_SIZE_MAX       256U           /*!< Registers reached by the 8-bit pointer    */
+#define BSP_I2CSLAVE_PAD                0xFFU          /*!< Byte sent past the end of the map         */
+
+/** @defgroup BSP_I2CSLAVE_State BSP I2CSLAVE State
+  * @{
+  */
+#define BSP_I2CSLAVE_STATE_IDLE         0x00000000U    /*!< Not addressed                             */
+#define BSP_I2CSLAVE_STATE_POINTER      0x00000001U    /*!< Written to, waiting for the pointer byte  */
+#define BSP_I2CSLAVE_STATE_WRITE        0x00000002U    /*!< Receiving the registers                   */
+#define BSP_I2CSLAVE_STATE_READ         0x00000003U    /*!< Sending the registers                     */
+#define BSP_I2CSLAVE_STATE_DISCARD      0x00000004U    /*!< Pointer out of the map, data ignored      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_I2CSLAVE_Exported_Types BSP I2CSLAVE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  I2C slave state definition
+  */
+typedef struct
+{
+  I2C_HandleTypeDef       *hi2c;        /*!< I2C in slave mode, NULL when not initialized           */
+
+  uint8_t                 *pRegs;       /*!< Register map read and written by the master            */
+
+  const uint8_t           *pMask;       /*!< Writable bits of each register, NULL for all           */
+
+  uint32_t                RegSize;      /*!< Register map size, 1 to BSP_I2CSLAVE_REG_SIZE_MAX      */
+
+  __IO uint32_t           State;        /*!< Transaction state, a value of @ref BSP_I2CSLAVE_State  */
+
+  uint32_t                Pointer;      /*!< Register pointer, auto-incremented                     */
+
+  uint32_t                XferSize;     /*!< Length of the running DMA transfer                     */
+
+  uint32_t                ChangeFirst;  /*!< First register changed in the transaction              */
+
+  uint32_t                ChangeLast;   /*!< Last register changed in the transaction               */
+
+  uint32_t                ErrorCount;   /*!< Number of bus errors and pointers out of the map       */
+
+  uint8_t                 Stage[BSP_I2CSLAVE_REG_SIZE_MAX]; /*!< Written bytes before masking       */
+
+} BSP_I2CSLAVE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_I2CSLAVE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_I2CSLAVE_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_I2CSLAVE_Init(BSP_I2CSLAVE_TypeDef *hslave, I2C_HandleTypeDef *hi2c, uint8_t *pRegs,
+                                    const uint8_t *pMask, uint32_t RegSize);
+HAL_StatusTypeDef BSP_I2CSLAVE_DeInit(BSP_I2CSLAVE_TypeDef *hslave);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CSLAVE_Exported_Functions_Group2
+  * @{
+  */
+/* Interrupt functions ********************************************************/
+void              BSP_I2CSLAVE_EV_IRQHandler(BSP_I2CSLAVE_TypeDef *hslave);
+void              BSP_I2CSLAVE_ER_IRQHandler(BSP_I2CSLAVE_TypeDef *hslave);
+void              BSP_I2CSLAVE_ChangeCallback(BSP_I2CSLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_I2CSLAVE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
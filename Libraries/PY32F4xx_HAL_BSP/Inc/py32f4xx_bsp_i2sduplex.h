@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2sduplex.h
+  * @author  MCU Application Team
+  * @brief   Header file of the full-duplex I2S streaming BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_I2SDUPLEX_H
+#define __PY32F4XX_BSP_I2SDUPLEX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_I2S_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_I2SDUPLEX
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Exported_Constants BSP I2SDUPLEX Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_I2SDUPLEX_State BSP I2SDUPLEX State
+  * @{
+  */
+#define BSP_I2SDUPLEX_STATE_RESET       0x00000000U    /*!< Not initialized                           */
+#define BSP_I2SDUPLEX_STATE_READY       0x00000001U    /*!< Initialized, streams stopped              */
+#define BSP_I2SDUPLEX_STATE_RUN         0x00000002U    /*!< Streams running                           */
+#define BSP_I2SDUPLEX_STATE_ERROR       0x00000003U    /*!< DMA error, streams to stop                */
+/**
+  * @}
+  */
+
+#define BSP_I2SDUPLEX_BLOCK_MAX         0x7FFFU        /*!< Halfwords of a block, 2 blocks per buffer */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Exported_Types BSP I2SDUPLEX Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Full-duplex I2S statistics definition
+  */
+typedef struct
+{
+  uint32_t                Blocks;       /*!< Blocks given to BSP_I2SDUPLEX_BlockCallback()          */
+
+  uint32_t                Late;         /*!< Blocks processed after the DMA came back to them       */
+
+  uint32_t                Slips;        /*!< Streams found more than one half apart, realigned      */
+
+  uint32_t                Errors;       /*!< DMA transfer errors                                    */
+
+} BSP_I2SDUPLEX_StatsTypeDef;
+
+/**
+  * @brief  Full-duplex I2S stream definition
+  */
+typedef struct
+{
+  I2S_HandleTypeDef       *hi2stx;      /*!< Transmitter, I2S_MODE_xxx_TX, hdmatx circular          */
+
+  I2S_HandleTypeDef       *hi2srx;      /*!< Receiver, I2S_MODE_xxx_RX, hdmarx circular             */
+
+  uint16_t                *pTxBuffer;   /*!< 2 x BlockSize halfwords played in turn                 */
+
+  uint16_t                *pRxBuffer;   /*!< 2 x BlockSize halfwords captured in turn               */
+
+  uint32_t                BlockSize;    /*!< Halfwords of a block, half of each buffer              */
+
+  __IO uint32_t           TxHalves;     /*!< Halves of pTxBuffer read by the DMA                    */
+
+  __IO uint32_t           RxHalves;     /*!< Halves of pRxBuffer written by the DMA                 */
+
+  uint32_t                Delivered;    /*!< Block pairs given to the callback                      */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_I2SDUPLEX_State                    */
+
+  BSP_I2SDUPLEX_StatsTypeDef Stats;     /*!< Statistics                                             */
+
+} BSP_I2SDUPLEX_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_I2SDUPLEX_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_I2SDUPLEX_Init(BSP_I2SDUPLEX_TypeDef *hdx, I2S_HandleTypeDef *hi2stx,
+                                     I2S_HandleTypeDef *hi2srx);
+HAL_StatusTypeDef BSP_I2SDUPLEX_Start(BSP_I2SDUPLEX_TypeDef *hdx, uint16_t *pTxBuffer,
+                                      uint16_t *pRxBuffer, uint32_t BlockSize);
+HAL_StatusTypeDef BSP_I2SDUPLEX_Stop(BSP_I2SDUPLEX_TypeDef *hdx);
+void              BSP_I2SDUPLEX_GetStats(const BSP_I2SDUPLEX_TypeDef *hdx, BSP_I2SDUPLEX_StatsTypeDef *pStats);
+void              BSP_I2SDUPLEX_BlockCallback(BSP_I2SDUPLEX_TypeDef *hdx, const uint16_t *pRx, uint16_t *pTx);
+void              BSP_I2SDUPLEX_ErrorCallback(BSP_I2SDUPLEX_TypeDef *hdx);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2S_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_I2SDUPLEX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
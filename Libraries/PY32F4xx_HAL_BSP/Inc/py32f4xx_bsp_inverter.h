@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_inverter.h
+  * @author  MCU Application Team
+  * @brief   Header file of the 3-phase inverter PWM BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_INVERTER_H
+#define __PY32F4XX_BSP_INVERTER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_INVERTER
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_INVERTER_Exported_Constants BSP INVERTER Exported Constants
+  * @{
+  */
+#define BSP_INVERTER_PHASES             3U             /*!< Channels 1 to 3 and their complementary   */
+#define BSP_INVERTER_DEADTIME_MAX       1008U          /*!< Longest dead time in timer clocks          */
+
+/** @defgroup BSP_INVERTER_State BSP INVERTER State
+  * @{
+  */
+#define BSP_INVERTER_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_INVERTER_STATE_READY        0x00000001U    /*!< Timer configured, outputs off             */
+#define BSP_INVERTER_STATE_RUN          0x00000002U    /*!< Outputs switching                         */
+#define BSP_INVERTER_STATE_FAULT        0x00000003U    /*!< Outputs at their idle level after a break */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_INVERTER_Exported_Types BSP INVERTER Exported Types
+  * @{
+  */
+
+/**
+  * @brief  3-phase inverter PWM configuration definition
+  */
+typedef struct
+{
+  uint32_t                PwmHz;        /*!< Switching frequency, center-aligned                    */
+
+  uint32_t                DeadTimeNs;   /*!< Dead time in ns, rounded up to the timer clock         */
+
+  uint32_t                OCPolarity;   /*!< High side switch on level, a value of
+                                             @ref TIM_Output_Compare_Polarity                       */
+
+  uint32_t                OCNPolarity;  /*!< Low side switch on level, a value of
+                                             @ref TIM_Output_Compare_N_Polarity                     */
+
+  uint32_t                BreakPolarity; /*!< Fault level of BKIN, a value of @ref TIM_Break_Polarity */
+
+  uint32_t                UpdateGuard;  /*!< Timer clocks before the update where BSP_INVERTER_SetDuty3()
+                                             waits for it, covering the writes of the three CCRx   */
+
+} BSP_INVERTER_InitTypeDef;
+
+/**
+  * @brief  3-phase inverter PWM definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< TIM1 or TIM8, owned by the service but CC4             */
+
+  uint32_t                Period;       /*!< ARR, duty of 100 %                                     */
+
+  uint32_t                DeadTime;     /*!< Dead time in timer clocks                              */
+
+  uint32_t                UpdateGuard;  /*!< Timer clocks before the update left alone              */
+
+  uint32_t                Faults;       /*!< Breaks since the initialization                        */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_INVERTER_State                     */
+
+} BSP_INVERTER_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_INVERTER_Exported_Macros BSP INVERTER Exported Macros
+  * @{
+  */
+#define BSP_INVERTER_GET_PERIOD(__HANDLE__)      ((__HANDLE__)->Period)
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_INVERTER_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_INVERTER_Init(BSP_INVERTER_TypeDef *hinv, TIM_HandleTypeDef *htim,
+                                    const BSP_INVERTER_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_INVERTER_Start(BSP_INVERTER_TypeDef *hinv);
+HAL_StatusTypeDef BSP_INVERTER_Stop(BSP_INVERTER_TypeDef *hinv);
+void              BSP_INVERTER_SetDuty3(BSP_INVERTER_TypeDef *hinv, uint32_t Duty1, uint32_t Duty2, uint32_t Duty3);
+void              BSP_INVERTER_Trip(BSP_INVERTER_TypeDef *hinv);
+HAL_StatusTypeDef BSP_INVERTER_ClearFault(BSP_INVERTER_TypeDef *hinv);
+void              BSP_INVERTER_BreakIRQHandler(BSP_INVERTER_TypeDef *hinv);
+void              BSP_INVERTER_FaultCallback(BSP_INVERTER_TypeDef *hinv);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_INVERTER_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
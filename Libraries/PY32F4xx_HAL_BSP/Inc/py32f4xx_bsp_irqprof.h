@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_irqprof.h
+  * @author  MCU Application Team
+  * @brief   Header file of the interrupt load profiler BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_IRQPROF_H
+#define __PY32F4XX_BSP_IRQPROF_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_IRQPROF
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Exported_Constants BSP IRQPROF Exported Constants
+  * @{
+  */
+#if !defined (BSP_IRQPROF_IRQS)
+#define BSP_IRQPROF_IRQS                60U            /*!< Device IRQs profiled, IRQn 0 to
+                                                            BSP_IRQPROF_IRQS - 1, SysTick as well     */
+#endif /* BSP_IRQPROF_IRQS */
+
+#define BSP_IRQPROF_VECTORS             (BSP_IRQPROF_IRQS + 1U) /*!< SysTick and the device IRQs      */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Exported_Types BSP IRQPROF Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Interrupt vector statistics definition
+  */
+typedef struct
+{
+  uint32_t                Count;        /*!< Entries of the handler                                 */
+
+  uint32_t                Max;          /*!< Longest run in cycles, the preempting handlers
+                                             excluded                                               */
+
+  uint64_t                Total;        /*!< Sum of the runs in cycles, the preempting handlers
+                                             excluded                                               */
+
+  uint32_t                Preempted;    /*!< Entries preempting another handler                     */
+
+  uint32_t                MaxNesting;   /*!< Most handlers preempted by one entry                   */
+
+} BSP_IRQPROF_StatsTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_IRQPROF_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_IRQPROF_Init(uint32_t PeriodMs);
+void              BSP_IRQPROF_DeInit(void);
+HAL_StatusTypeDef BSP_IRQPROF_GetStats(IRQn_Type IRQn, BSP_IRQPROF_StatsTypeDef *pStats);
+uint32_t          BSP_IRQPROF_GetLoad(IRQn_Type IRQn);
+uint32_t          BSP_IRQPROF_GetTotalLoad(void);
+void              BSP_IRQPROF_Reset(void);
+void              BSP_IRQPROF_Print(void);
+void              BSP_IRQPROF_Process(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_IRQPROF_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_isotp.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ISO-TP (ISO 15765-2) transport BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_ISOTP_H
+#define __PY32F4XX_BSP_ISOTP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_canrx.h"
+#include "py32f4xx_bsp_cantx.h"
+#include "py32f4xx_bsp_timwheel.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_ISOTP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_ISOTP_Exported_Constants BSP ISOTP Exported Constants
+  * @{
+  */
+#if !defined (BSP_ISOTP_TIMEOUT_MS)
+#define BSP_ISOTP_TIMEOUT_MS            1000U          /*!< N_Bs and N_Cr, flow control and consecutive
+                                                            frame timeouts                             */
+#endif /* BSP_ISOTP_TIMEOUT_MS */
+
+#if !defined (BSP_ISOTP_PADDING)
+#define BSP_ISOTP_PADDING               0xCCU          /*!< Byte filling the frames to a valid length  */
+#endif /* BSP_ISOTP_PADDING */
+
+/** @defgroup BSP_ISOTP_Result BSP ISOTP Result
+  * @{
+  */
+#define BSP_ISOTP_RESULT_OK             0x00000000U    /*!< Message sent or received                  */
+#define BSP_ISOTP_RESULT_TIMEOUT        0x00000001U    /*!< No flow control or consecutive frame in
+                                                            BSP_ISOTP_TIMEOUT_MS                       */
+#define BSP_ISOTP_RESULT_WRONG_SN       0x00000002U    /*!< Consecutive frame out of sequence         */
+#define BSP_ISOTP_RESULT_OVERFLOW       0x00000003U    /*!< Message longer than the receive buffer    */
+#define BSP_ISOTP_RESULT_UNEXPECTED     0x00000004U    /*!< Frame invalid or out of the protocol      */
+#define BSP_ISOTP_RESULT_ABORTED        0x00000005U    /*!< Stopped by BSP_ISOTP_Abort()              */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ISOTP_State BSP ISOTP State
+  * @{
+  */
+#define BSP_ISOTP_STATE_IDLE            0x00000000U    /*!< No message in progress                    */
+#define BSP_ISOTP_STATE_WAIT_FC         0x00000001U    /*!< Sending, flow control awaited             */
+#define BSP_ISOTP_STATE_SEND            0x00000002U    /*!< Sending the consecutive frames            */
+#define BSP_ISOTP_STATE_RECEIVE         0x00000003U    /*!< Receiving the consecutive frames          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_ISOTP_Exported_Types BSP ISOTP Exported Types
+  * @{
+  */
+
+struct __BSP_ISOTP_TypeDef;
+
+/**
+  * @brief  ISO-TP session definition, one pair of identifiers
+  * @note   The configuration fields are set before BSP_ISOTP_Init().
+  */
+typedef struct
+{
+  uint32_t                TxId;         /*!< Identifier of the frames sent                          */
+
+  uint32_t                RxId;         /*!< Identifier of the frames received                      */
+
+  uint32_t                IdType;       /*!< A value of @ref CANFD_id_type, both identifiers        */
+
+  uint32_t                FrameFormat;  /*!< A value of @ref CANFD_frame_format: classic frames of 8
+                                             bytes or FD frames of up to 64 bytes                   */
+
+  uint32_t                BlockSize;    /*!< BS of the flow control sent, 0 for no limit            */
+
+  uint32_t                STmin;        /*!< STmin of the flow control sent, ISO 15765-2 encoding   */
+
+  uint8_t                 *pRxBuffer;   /*!< Buffer of the received messages                        */
+
+  uint32_t                RxBufferSize; /*!< Bytes of pRxBuffer                                     */
+
+  struct __BSP_ISOTP_TypeDef *hisotp;   /*!< ISO-TP handle, set by BSP_ISOTP_Init()                 */
+
+  const uint8_t           *pTxData;     /*!< Message being sent, kept until sent                    */
+
+  uint32_t                TxLength;     /*!< Bytes of the message being sent                        */
+
+  uint32_t                TxOffset;     /*!< Bytes already queued                                   */
+
+  uint32_t                TxSn;         /*!< Sequence number of the next consecutive frame          */
+
+  uint32_t                TxBs;         /*!< BS of the last flow control received                   */
+
+  uint32_t                TxBlock;      /*!< Consecutive frames left in the block                   */
+
+  uint32_t                TxGap;        /*!< STmin of the last flow control received, in ticks      */
+
+  __IO uint32_t           TxState;      /*!< A value of @ref BSP_ISOTP_State                        */
+
+  uint32_t                RxLength;     /*!< Bytes of the message being received                    */
+
+  uint32_t                RxOffset;     /*!< Bytes already received                                 */
+
+  uint32_t                RxSn;         /*!< Sequence number of the next consecutive frame          */
+
+  uint32_t                RxBlock;      /*!< Consecutive frames left before a flow control          */
+
+  __IO uint32_t           RxState;      /*!< A value of @ref BSP_ISOTP_State                        */
+
+  BSP_TIMWHEEL_TimerTypeDef TxTimer;    /*!< N_Bs, STmin and the retries of a full queue            */
+
+  BSP_TIMWHEEL_TimerTypeDef RxTimer;    /*!< N_Cr                                                   */
+
+} BSP_ISOTP_SessionTypeDef;
+
+/**
+  * @brief  ISO-TP transport definition
+  */
+typedef struct __BSP_ISOTP_TypeDef
+{
+  BSP_CANTX_TypeDef       *htx;         /*!< Transmit scheduler, started                            */
+
+  BSP_TIMWHEEL_TypeDef    *hwheel;      /*!< Timer wheel, started                                   */
+
+  uint32_t                Priority;     /*!< Queue of the frames sent, @ref BSP_CANTX_Priority      */
+
+  uint32_t                TicksPerMs;   /*!< Ticks of the timer wheel per millisecond               */
+
+  BSP_ISOTP_SessionTypeDef *pSessions;  /*!< Sessions                                               */
+
+  uint32_t                NbrOfSessions; /*!< Sessions                                              */
+
+} BSP_ISOTP_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_ISOTP_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_ISOTP_Init(BSP_ISOTP_TypeDef *hisotp, BSP_CANTX_TypeDef *htx, BSP_TIMWHEEL_TypeDef *hwheel,
+                                 uint32_t Priority, uint32_t TicksPerMs,
+                                 BSP_ISOTP_SessionTypeDef *pSessions, uint32_t NbrOfSessions);
+HAL_StatusTypeDef BSP_ISOTP_Send(BSP_ISOTP_SessionTypeDef *psession, const uint8_t *pData, uint32_t Length);
+uint32_t          BSP_ISOTP_Input(BSP_ISOTP_TypeDef *hisotp, const BSP_CANRX_FrameTypeDef *pFrame);
+void              BSP_ISOTP_Abort(BSP_ISOTP_SessionTypeDef *psession);
+void              BSP_ISOTP_TxCpltCallback(BSP_ISOTP_SessionTypeDef *psession, uint32_t Result);
+void              BSP_ISOTP_RxCpltCallback(BSP_ISOTP_SessionTypeDef *psession, uint32_t Result, uint32_t Length);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_ISOTP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
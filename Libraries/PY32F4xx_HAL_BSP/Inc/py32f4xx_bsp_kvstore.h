@@ -0,0 +1,195 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_kvstore.h
+  * @author  MCU Application Team
+  * @brief   Header file of the external flash key-value store BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_KVSTORE_H
+#define __PY32F4XX_BSP_KVSTORE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_spiflash.h"
+#include "py32f4xx_bsp_esmcflash.h"
+
+#ifdef HAL_CRC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_KVSTORE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Exported_Constants BSP KVSTORE Exported Constants
+  * @{
+  */
+#define BSP_KVSTORE_SECTORS_MAX         16U            /*!< Sectors of a store                        */
+#define BSP_KVSTORE_INDEX_SIZE          64U            /*!< Index slots, a power of 2, one is kept free */
+#define BSP_KVSTORE_GC_FREE             2U             /*!< BSP_KVSTORE_Process() compacts from this
+                                                            number of free sectors                     */
+#define BSP_KVSTORE_KEY_NONE            0xFFFFFFFFU    /*!< Reserved key, erased flash                */
+#define BSP_KVSTORE_NOT_FOUND           0xFFFFFFFFU    /*!< BSP_KVSTORE_GetLength() of a missing key  */
+#define BSP_KVSTORE_ESMC_TIMEOUT        5000U          /*!< ESMC flash program or erase wait, ms      */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Exported_Types BSP KVSTORE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Block device definition
+  * @note   Filled by BSP_KVSTORE_LinkSPIFLASH() or BSP_KVSTORE_LinkESMCFLASH(),
+  *         or by the user for another memory. Write programs erased memory
+  *         only, Erase takes whole sectors.
+  */
+typedef struct
+{
+  HAL_StatusTypeDef (* Read)(void *pContext, uint32_t Address, uint8_t *pData, uint32_t Size);
+
+  HAL_StatusTypeDef (* Write)(void *pContext, uint32_t Address, const uint8_t *pData, uint32_t Size);
+
+  HAL_StatusTypeDef (* Erase)(void *pContext, uint32_t Address, uint32_t Size);
+
+  HAL_StatusTypeDef (* Sync)(void *pContext); /*!< Makes the writes durable, NULL when they already are */
+
+  void                    *pContext;    /*!< Driver handle given to the functions                   */
+
+  uint32_t                Base;         /*!< Address of the first sector                            */
+
+  uint32_t                SectorSize;   /*!< Erase size in bytes, a multiple of 4                   */
+
+  uint32_t                SectorCount;  /*!< Number of sectors, 2 to BSP_KVSTORE_SECTORS_MAX        */
+
+} BSP_KVSTORE_BlockTypeDef;
+
+/**
+  * @brief  Index entry definition
+  */
+typedef struct
+{
+  uint32_t                Key;          /*!< Key, BSP_KVSTORE_KEY_NONE when the slot is free        */
+
+  uint32_t                Address;      /*!< Address of the last record of the key                  */
+
+  uint32_t                Length;       /*!< Value length in bytes                                  */
+
+} BSP_KVSTORE_EntryTypeDef;
+
+/**
+  * @brief  Key-value store state definition
+  */
+typedef struct
+{
+  const BSP_KVSTORE_BlockTypeDef *pBlock; /*!< Block device, NULL when not mounted                  */
+
+  CRC_HandleTypeDef       *hcrc;        /*!< CRC of the records                                     */
+
+  uint32_t                Sequence[BSP_KVSTORE_SECTORS_MAX]; /*!< Write order of the sectors, 0 when free */
+
+  uint32_t                Used[BSP_KVSTORE_SECTORS_MAX];     /*!< End of the records in each sector  */
+
+  uint32_t                Live[BSP_KVSTORE_SECTORS_MAX];     /*!< Bytes of indexed records in each sector */
+
+  uint32_t                LastSequence; /*!< Sequence of the head sector                            */
+
+  uint32_t                Head;         /*!< Sector appended to, BSP_KVSTORE_SECTORS_MAX when none  */
+
+  uint32_t                FreeSectors;  /*!< Number of erased sectors                               */
+
+  uint32_t                Count;        /*!< Number of keys                                         */
+
+  BSP_KVSTORE_EntryTypeDef Index[BSP_KVSTORE_INDEX_SIZE]; /*!< Hash index of the keys              */
+
+  uint32_t                CompactCount; /*!< Number of sectors compacted                            */
+
+  uint32_t                CrcErrors;    /*!< Number of records failing their CRC                    */
+
+} BSP_KVSTORE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_KVSTORE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_KVSTORE_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+#ifdef HAL_SPI_MODULE_ENABLED
+HAL_StatusTypeDef BSP_KVSTORE_LinkSPIFLASH(BSP_KVSTORE_BlockTypeDef *pBlock, BSP_SPIFLASH_TypeDef *hflash,
+                                           uint32_t Base, uint32_t SectorCount);
+#endif /* HAL_SPI_MODULE_ENABLED */
+#ifdef HAL_ESMC_MODULE_ENABLED
+HAL_StatusTypeDef BSP_KVSTORE_LinkESMCFLASH(BSP_KVSTORE_BlockTypeDef *pBlock, BSP_ESMCFLASH_TypeDef *hflash,
+                                            uint32_t Base, uint32_t SectorCount);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_KVSTORE_Mount(BSP_KVSTORE_TypeDef *hkv, const BSP_KVSTORE_BlockTypeDef *pBlock,
+                                    CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef BSP_KVSTORE_Format(BSP_KVSTORE_TypeDef *hkv, const BSP_KVSTORE_BlockTypeDef *pBlock,
+                                     CRC_HandleTypeDef *hcrc);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_KVSTORE_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+uint32_t          BSP_KVSTORE_GetLength(const BSP_KVSTORE_TypeDef *hkv, uint32_t Key);
+HAL_StatusTypeDef BSP_KVSTORE_Get(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_KVSTORE_Set(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, const uint8_t *pData, uint32_t Length);
+HAL_StatusTypeDef BSP_KVSTORE_Delete(BSP_KVSTORE_TypeDef *hkv, uint32_t Key);
+HAL_StatusTypeDef BSP_KVSTORE_Process(BSP_KVSTORE_TypeDef *hkv);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_KVSTORE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,222 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lin.h
+  * @author  MCU Application Team
+  * @brief   Header file of the LIN schedule engine BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_LIN_H
+#define __PY32F4XX_BSP_LIN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_LIN
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_LIN_Exported_Types BSP LIN Exported Types
+  * @{
+  */
+
+/**
+  * @brief  LIN frame definition
+  * @note   pData is read and written from interrupts while the frame is on the bus.
+  */
+typedef struct
+{
+  uint8_t                 Id;           /*!< Frame identifier, 0 to 63                              */
+
+  uint8_t                 Length;       /*!< Number of data bytes, 1 to 8                           */
+
+  uint8_t                 Direction;    /*!< Response sender, a value of @ref BSP_LIN_Direction     */
+
+  uint8_t                 Checksum;     /*!< Checksum model, a value of @ref BSP_LIN_Checksum       */
+
+  uint8_t                 *pData;       /*!< Response data, Length bytes                            */
+
+  __IO uint32_t           Status;       /*!< Result of the last transfer, a value of @ref BSP_LIN_Status */
+
+} BSP_LIN_FrameTypeDef;
+
+/**
+  * @brief  LIN schedule table slot definition
+  */
+typedef struct
+{
+  BSP_LIN_FrameTypeDef * const *ppFrames; /*!< Frames sent one after the other in the slot          */
+
+  uint32_t                FrameNumber;  /*!< Number of frames of the slot                           */
+
+  uint32_t                Duration;     /*!< Slot duration in ticks of BSP_LIN_Tick(), at least 1   */
+
+} BSP_LIN_SlotTypeDef;
+
+/**
+  * @brief  LIN node state definition
+  */
+typedef struct
+{
+  UART_HandleTypeDef      *huart;       /*!< UART initialized by HAL_LIN_Init()                     */
+
+  uint32_t                Mode;         /*!< Node role, a value of @ref BSP_LIN_Mode                */
+
+  uint32_t                TickPeriod;   /*!< Period of BSP_LIN_Tick() calls in us                   */
+
+  const BSP_LIN_SlotTypeDef *pSchedule; /*!< Master schedule table                                  */
+
+  uint32_t                SlotNumber;   /*!< Number of slots of the schedule table                  */
+
+  BSP_LIN_FrameTypeDef * const *ppFrames; /*!< Slave frames, answered or listened to by the node    */
+
+  uint32_t                FrameNumber;  /*!< Number of slave frames                                 */
+
+  uint32_t                Slot;         /*!< Current slot of the schedule table                     */
+
+  uint32_t                SlotTicks;    /*!< Ticks left in the current slot                         */
+
+  uint32_t                Frame;        /*!< Next frame of the current slot                         */
+
+  BSP_LIN_FrameTypeDef    *pFrame;      /*!< Frame on the bus, NULL when the bus is idle            */
+
+  uint32_t                State;        /*!< Transfer state of pFrame                               */
+
+  uint32_t                Timeout;      /*!< Ticks left before pFrame times out                     */
+
+  uint8_t                 TxBuffer[11]; /*!< Sync, PID, data and checksum sent                      */
+
+  uint8_t                 RxBuffer[11]; /*!< Sync, PID, data and checksum read back from the bus    */
+
+  uint32_t                ErrorCount;   /*!< Number of frames ended with an error                   */
+
+} BSP_LIN_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_LIN_Exported_Constants BSP LIN Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_LIN_Mode BSP LIN Mode
+  * @{
+  */
+#define BSP_LIN_MODE_MASTER             0x00000000U    /*!< Sends the headers from the schedule table */
+#define BSP_LIN_MODE_SLAVE              0x00000001U    /*!< Answers the headers of its frames         */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_LIN_Direction BSP LIN Direction
+  * @{
+  */
+#define BSP_LIN_PUBLISH                 0x00U          /*!< The response is sent by this node         */
+#define BSP_LIN_SUBSCRIBE               0x01U          /*!< The response is received by this node     */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_LIN_Checksum BSP LIN Checksum
+  * @{
+  */
+#define BSP_LIN_CHECKSUM_CLASSIC        0x00U          /*!< Data bytes only, LIN 1.x and diagnostic frames */
+#define BSP_LIN_CHECKSUM_ENHANCED       0x01U          /*!< PID and data bytes, LIN 2.x               */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_LIN_Status BSP LIN Status
+  * @{
+  */
+#define BSP_LIN_STATUS_NONE             0x00000000U    /*!< Frame not transferred yet                 */
+#define BSP_LIN_STATUS_OK               0x00000001U    /*!< Response transferred                      */
+#define BSP_LIN_STATUS_TIMEOUT          0x00000002U    /*!< No or incomplete response in time         */
+#define BSP_LIN_STATUS_CHECKSUM         0x00000003U    /*!< Checksum error                            */
+#define BSP_LIN_STATUS_BIT              0x00000004U    /*!< Read back differs from the bytes sent     */
+#define BSP_LIN_STATUS_HEADER           0x00000005U    /*!< Sync or PID error                         */
+#define BSP_LIN_STATUS_DMA              0x00000006U    /*!< DMA transfer error                        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_LIN_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_LIN_Exported_Functions_Group1
+  * @{
+  */
+/* Node functions *************************************************************/
+HAL_StatusTypeDef BSP_LIN_Init(BSP_LIN_TypeDef *hlin, UART_HandleTypeDef *huart, uint32_t Mode, uint32_t TickPeriod);
+HAL_StatusTypeDef BSP_LIN_SetSchedule(BSP_LIN_TypeDef *hlin, const BSP_LIN_SlotTypeDef *pSchedule, uint32_t SlotNumber);
+HAL_StatusTypeDef BSP_LIN_SetFrames(BSP_LIN_TypeDef *hlin, BSP_LIN_FrameTypeDef * const *ppFrames, uint32_t FrameNumber);
+HAL_StatusTypeDef BSP_LIN_Start(BSP_LIN_TypeDef *hlin);
+HAL_StatusTypeDef BSP_LIN_Stop(BSP_LIN_TypeDef *hlin);
+uint8_t           BSP_LIN_GetPID(uint8_t Id);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LIN_Exported_Functions_Group2
+  * @{
+  */
+/* Interrupt functions ********************************************************/
+void              BSP_LIN_Tick(BSP_LIN_TypeDef *hlin);
+void              BSP_LIN_IRQHandler(BSP_LIN_TypeDef *hlin);
+void              BSP_LIN_FrameCallback(BSP_LIN_TypeDef *hlin, BSP_LIN_FrameTypeDef *pFrame);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_LIN_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
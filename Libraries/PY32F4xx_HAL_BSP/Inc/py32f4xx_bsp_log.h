@@ -0,0 +1,244 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_log.h
+  * @author  MCU Application Team
+  * @brief   Header file of the deferred log BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_LOG_H
+#define __PY32F4XX_BSP_LOG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_LOG
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_LOG_Exported_Constants BSP LOG Exported Constants
+  * @{
+  */
+#if !defined (BSP_LOG_ITM_PORT)
+#define BSP_LOG_ITM_PORT                2U             /*!< ITM stimulus port, 0 printf and 1 BSP_PROBE */
+#endif /* BSP_LOG_ITM_PORT */
+
+#define BSP_LOG_ARGS_MAX                8U             /*!< Arguments of a record                        */
+#define BSP_LOG_MAGIC                   0x474F4C42U    /*!< "BLOG", control block initialized            */
+#define BSP_LOG_SYNC                    0xB0000000U    /*!< Bits 31:28 of the first word of a record     */
+#define BSP_LOG_ID_DROPPED              0x00FFFFFFU    /*!< Record of the records lost, one argument     */
+
+/** @defgroup BSP_LOG_Level BSP LOG Level
+  * @{
+  */
+#define BSP_LOG_LEVEL_NONE              0U             /*!< No record                                    */
+#define BSP_LOG_LEVEL_ERROR             1U             /*!< BSP_LOG_ERROR() only                         */
+#define BSP_LOG_LEVEL_WARN              2U             /*!< Up to BSP_LOG_WARN()                         */
+#define BSP_LOG_LEVEL_INFO              3U             /*!< Up to BSP_LOG_INFO()                         */
+#define BSP_LOG_LEVEL_DEBUG             4U             /*!< All the records                              */
+/**
+  * @}
+  */
+
+#if !defined (BSP_LOG_LEVEL)
+#define BSP_LOG_LEVEL                   BSP_LOG_LEVEL_DEBUG /*!< Records compiled in                     */
+#endif /* BSP_LOG_LEVEL */
+
+/** @defgroup BSP_LOG_Transport BSP LOG Transport
+  * @{
+  */
+#define BSP_LOG_TRANSPORT_MEMORY        0x00000000U    /*!< Ring read by the debugger, logdecode.py --pyocd */
+#define BSP_LOG_TRANSPORT_UART          0x00000001U    /*!< Ring sent by the UART DMA                       */
+#define BSP_LOG_TRANSPORT_ITM           0x00000002U    /*!< Ring written to the ITM stimulus port on SWO    */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_LOG_Exported_Types BSP LOG Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Deferred log control block definition
+  * @note   The first seven words are read by the host in the memory transport,
+  *         which writes Released. Reserved, Committed, Released and Queued are
+  *         free running word counters, the ring position is the counter modulo Size.
+  */
+typedef struct
+{
+  uint32_t                Magic;        /*!< BSP_LOG_MAGIC once initialized                         */
+
+  uint32_t                *pBuffer;     /*!< Ring storage                                           */
+
+  uint32_t                Size;         /*!< Ring size in words, a power of two                     */
+
+  __IO uint32_t           Reserved;     /*!< End of the space reserved by writers                   */
+
+  __IO uint32_t           Committed;    /*!< End of the records completely written                  */
+
+  __IO uint32_t           Writers;      /*!< Number of writers currently copying a record           */
+
+  __IO uint32_t           Released;     /*!< Words before this one are free for the writers         */
+
+  __IO uint32_t           Queued;       /*!< Next word to hand over to the transport                */
+
+  __IO uint32_t           XferSize;     /*!< Words of the UART transfer in progress, 0 when idle    */
+
+  __IO uint32_t           Lost;         /*!< Records lost not yet reported in the ring              */
+
+  __IO uint32_t           Dropped;      /*!< Records lost since BSP_LOG_Init()                      */
+
+  uint32_t                Transport;    /*!< Transport, a value of @ref BSP_LOG_Transport           */
+
+#if defined (HAL_UART_MODULE_ENABLED)
+  UART_HandleTypeDef      *huart;       /*!< UART of the UART transport, its hdmatx linked          */
+#endif /* HAL_UART_MODULE_ENABLED */
+
+} BSP_LOG_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_LOG_Exported_Macros BSP LOG Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Pass a float to a record, its bits being logged.
+  */
+#define BSP_LOG_FLOAT(__VALUE__)        (((union { float f; uint32_t u; }){ .f = (float)(__VALUE__) }).u)
+
+#if defined (USE_BSP_LOG)
+/**
+  * @brief  Pass a string constant to a record for a %s, kept with the formats out of the image.
+  */
+#define BSP_LOG_STRING(__STRING__)                                                               \
+  __extension__ ({                                                                               \
+    static const char BSP_LOG_String[] __attribute__((section(".bsplog"), used)) = __STRING__;  \
+    (uint32_t)BSP_LOG_String;                                                                    \
+  })
+
+#define BSP_LOG_RECORD(__LEVEL__, __FORMAT__, ...)                                               \
+  do                                                                                             \
+  {                                                                                              \
+    static const char BSP_LOG_Format[] __attribute__((section(".bsplog"), used)) =              \
+      __LEVEL__ "|" __FILE__ "|" BSP_LOG_STR(__LINE__) "|" __FORMAT__;                           \
+    BSP_LOG_Write((uint32_t)BSP_LOG_Format, BSP_LOG_NARGS(__VA_ARGS__),                          \
+                  &((const uint32_t []){ 0U BSP_LOG_CAT(BSP_LOG_ARGS_, BSP_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) })[1]); \
+  } while (0)
+#else
+#define BSP_LOG_STRING(__STRING__)      0U
+#define BSP_LOG_RECORD(__LEVEL__, __FORMAT__, ...) ((void)0U)
+#endif /* USE_BSP_LOG */
+
+#if (BSP_LOG_LEVEL >= BSP_LOG_LEVEL_ERROR)
+#define BSP_LOG_ERROR(...)              BSP_LOG_RECORD("E", __VA_ARGS__)
+#else
+#define BSP_LOG_ERROR(...)              ((void)0U)
+#endif
+#if (BSP_LOG_LEVEL >= BSP_LOG_LEVEL_WARN)
+#define BSP_LOG_WARN(...)               BSP_LOG_RECORD("W", __VA_ARGS__)
+#else
+#define BSP_LOG_WARN(...)               ((void)0U)
+#endif
+#if (BSP_LOG_LEVEL >= BSP_LOG_LEVEL_INFO)
+#define BSP_LOG_INFO(...)               BSP_LOG_RECORD("I", __VA_ARGS__)
+#else
+#define BSP_LOG_INFO(...)               ((void)0U)
+#endif
+#if (BSP_LOG_LEVEL >= BSP_LOG_LEVEL_DEBUG)
+#define BSP_LOG_DEBUG(...)              BSP_LOG_RECORD("D", __VA_ARGS__)
+#else
+#define BSP_LOG_DEBUG(...)              ((void)0U)
+#endif
+
+/* Helpers of BSP_LOG_RECORD(): argument count and conversion to words */
+#define BSP_LOG_STR(__X__)              BSP_LOG_STR_(__X__)
+#define BSP_LOG_STR_(__X__)             #__X__
+#define BSP_LOG_CAT(__A__, __B__)       BSP_LOG_CAT_(__A__, __B__)
+#define BSP_LOG_CAT_(__A__, __B__)      __A__ ## __B__
+#define BSP_LOG_NARGS(...)              BSP_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BSP_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, __N__, ...) __N__
+#define BSP_LOG_ARGS_0()
+#define BSP_LOG_ARGS_1(a)                  , (uint32_t)(a)
+#define BSP_LOG_ARGS_2(a, b)               , (uint32_t)(a), (uint32_t)(b)
+#define BSP_LOG_ARGS_3(a, b, c)            BSP_LOG_ARGS_2(a, b), (uint32_t)(c)
+#define BSP_LOG_ARGS_4(a, b, c, d)         BSP_LOG_ARGS_3(a, b, c), (uint32_t)(d)
+#define BSP_LOG_ARGS_5(a, b, c, d, e)      BSP_LOG_ARGS_4(a, b, c, d), (uint32_t)(e)
+#define BSP_LOG_ARGS_6(a, b, c, d, e, f)   BSP_LOG_ARGS_5(a, b, c, d, e), (uint32_t)(f)
+#define BSP_LOG_ARGS_7(a, b, c, d, e, f, g) BSP_LOG_ARGS_6(a, b, c, d, e, f), (uint32_t)(g)
+#define BSP_LOG_ARGS_8(a, b, c, d, e, f, g, h) BSP_LOG_ARGS_7(a, b, c, d, e, f, g), (uint32_t)(h)
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_LOG_Exported_Variables
+  * @{
+  */
+extern BSP_LOG_TypeDef BSP_Log;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_LOG_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_LOG_Init(uint32_t *pBuffer, uint32_t Size);
+#if defined (HAL_UART_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_LOG_ConfigUart(UART_HandleTypeDef *huart);
+void              BSP_LOG_TxCpltCallback(UART_HandleTypeDef *huart);
+#endif /* HAL_UART_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_LOG_ConfigITM(uint32_t SwoHz);
+void              BSP_LOG_Write(uint32_t Id, uint32_t Count, const uint32_t *pArgs);
+void              BSP_LOG_Process(void);
+void              BSP_LOG_Flush(void);
+uint32_t          BSP_LOG_GetDropped(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_LOG_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
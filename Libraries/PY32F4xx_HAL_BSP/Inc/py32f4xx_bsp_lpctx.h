@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lpctx.h
+  * @author  MCU Application Team
+  * @brief   Header file of the low-power clock context BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_LPCTX_H
+#define __PY32F4XX_BSP_LPCTX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_PWR_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_LPCTX
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_LPCTX_Exported_Constants BSP LPCTX Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_LPCTX_Defaults BSP LPCTX Defaults
+  * @brief    Wakeup settings of BSP_LPCTX_StructInit(), overridable
+  * @{
+  */
+#if !defined (BSP_LPCTX_FLASH_DELAY)
+#define BSP_LPCTX_FLASH_DELAY           PWR_WAKEUP_FLASH_DELAY_2US     /*!< Flash access after STOP      */
+#endif
+
+#if !defined (BSP_LPCTX_MRREADY_DELAY)
+#define BSP_LPCTX_MRREADY_DELAY         PWR_WAKEUP_MRREADY_DELAY_5US   /*!< Main regulator after STANDBY */
+#endif
+
+#if !defined (BSP_LPCTX_HSI_WAIT)
+#define BSP_LPCTX_HSI_WAIT              0U             /*!< 1 for HSI after the main regulator        */
+#endif
+
+#if !defined (BSP_LPCTX_REGULATOR)
+#define BSP_LPCTX_REGULATOR             PWR_LOWPOWERREGULATOR_ON       /*!< Regulator in STOP mode       */
+#endif
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_LPCTX_Exported_Types BSP LPCTX Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Wakeup settings definition
+  */
+typedef struct
+{
+  uint32_t                FlashDelay;   /*!< A value of @ref PWR_FLASH_WAKEUP_DELAY                 */
+
+  uint32_t                MrReadyDelay; /*!< A value of @ref PWR_MRREADY_WAKEUP_DELAY, STANDBY only */
+
+  uint32_t                HSIWait;      /*!< 0 to start HSI with the main regulator, 1 after it     */
+
+  uint32_t                Regulator;    /*!< PWR_MAINREGULATOR_ON or PWR_LOWPOWERREGULATOR_ON       */
+
+} BSP_LPCTX_InitTypeDef;
+
+/**
+  * @brief  Wakeup statistics definition
+  */
+typedef struct
+{
+  uint32_t                Wakeups;      /*!< Clock trees restored                                   */
+
+  uint32_t                Failures;     /*!< HSE or PLL not restarted, left on HSI                  */
+
+  uint32_t                LastLatency;  /*!< Last restore, wakeup to the clock of the entry, ns     */
+
+  uint32_t                MaxLatency;   /*!< Longest restore, ns                                    */
+
+} BSP_LPCTX_StatsTypeDef;
+
+/**
+  * @brief  Low-power clock context definition
+  */
+typedef struct
+{
+  BSP_LPCTX_InitTypeDef   Init;         /*!< Wakeup settings                                        */
+
+  uint32_t                Cr;           /*!< RCC CR oscillators of the entry                        */
+
+  uint32_t                Cfgr;         /*!< RCC CFGR of the entry                                  */
+
+  uint32_t                Latency;      /*!< FLASH ACR latency of the entry                         */
+
+  uint32_t                Enr[4];       /*!< RCC AHB1ENR, AHB2ENR, APB1ENR and APB2ENR of the entry */
+
+  BSP_LPCTX_StatsTypeDef  Stats;        /*!< Statistics                                             */
+
+} BSP_LPCTX_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_LPCTX_Exported_Functions
+  * @{
+  */
+void              BSP_LPCTX_StructInit(BSP_LPCTX_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_LPCTX_Init(BSP_LPCTX_TypeDef *hctx, const BSP_LPCTX_InitTypeDef *pInit);
+void              BSP_LPCTX_Save(BSP_LPCTX_TypeDef *hctx);
+HAL_StatusTypeDef BSP_LPCTX_Restore(BSP_LPCTX_TypeDef *hctx);
+HAL_StatusTypeDef BSP_LPCTX_EnterStop(BSP_LPCTX_TypeDef *hctx);
+void              BSP_LPCTX_GetStats(const BSP_LPCTX_TypeDef *hctx, BSP_LPCTX_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_PWR_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_LPCTX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
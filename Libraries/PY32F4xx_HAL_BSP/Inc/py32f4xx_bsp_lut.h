@@ -0,0 +1,159 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lut.h
+  * @author  MCU Application Team
+  * @brief   Header file of the lookup table BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_LUT_H
+#define __PY32F4XX_BSP_LUT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_LUT
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_LUT_Exported_Constants BSP LUT Exported Constants
+  * @{
+  */
+#define BSP_LUT_SHIFT_MAX               24U            /*!< Largest step 2^Shift of a uniform table   */
+
+/** @defgroup BSP_LUT_Interp BSP LUT Interpolation
+  * @{
+  */
+#define BSP_LUT_LINEAR                  0x00000000U    /*!< Straight line between two points          */
+#define BSP_LUT_CUBIC                   0x00000001U    /*!< Cubic Hermite on four points, the slopes
+                                                            of the neighbours, Catmull-Rom when
+                                                            uniform                                   */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_LUT_Exported_Types BSP LUT Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Fixed point table definition
+  * @note   Generated by Misc/Tools/lut2c.py, const: the table and its points
+  *         stay in the flash.
+  */
+typedef struct
+{
+  const int32_t           *pX;          /*!< Abscissas, increasing, NULL for a uniform table        */
+
+  const int32_t           *pY;          /*!< Values, in any fixed point unit                        */
+
+  uint32_t                Count;        /*!< Points, 2 or above                                     */
+
+  int32_t                 X0;           /*!< First abscissa of a uniform table                      */
+
+  uint32_t                Shift;        /*!< Step 2^Shift of a uniform table, 0 to
+                                             BSP_LUT_SHIFT_MAX                                      */
+
+  uint32_t                Interp;       /*!< A value of @ref BSP_LUT_Interp                         */
+
+} BSP_LUT_I32_TypeDef;
+
+/**
+  * @brief  Float table definition
+  * @note   Generated by Misc/Tools/lut2c.py, const: the table and its points
+  *         stay in the flash.
+  */
+typedef struct
+{
+  const float             *pX;          /*!< Abscissas, increasing, NULL for a uniform table        */
+
+  const float             *pY;          /*!< Values                                                 */
+
+  uint32_t                Count;        /*!< Points, 2 or above                                     */
+
+  float                   X0;           /*!< First abscissa of a uniform table                      */
+
+  float                   InvStep;      /*!< Inverse of the step of a uniform table                 */
+
+  uint32_t                Interp;       /*!< A value of @ref BSP_LUT_Interp                         */
+
+} BSP_LUT_F32_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_LUT_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_LUT_Exported_Functions_Group1
+  * @{
+  */
+/* Fixed point functions ******************************************************/
+HAL_StatusTypeDef BSP_LUT_I32_Check(const BSP_LUT_I32_TypeDef *pTable);
+int32_t           BSP_LUT_I32_Eval(const BSP_LUT_I32_TypeDef *pTable, int32_t X);
+void              BSP_LUT_I32_Process(const BSP_LUT_I32_TypeDef *pTable, const uint16_t *pSrc, int32_t *pDst,
+                                      uint32_t Length);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LUT_Exported_Functions_Group2
+  * @{
+  */
+/* Float functions ************************************************************/
+HAL_StatusTypeDef BSP_LUT_F32_Check(const BSP_LUT_F32_TypeDef *pTable);
+float             BSP_LUT_F32_Eval(const BSP_LUT_F32_TypeDef *pTable, float X);
+void              BSP_LUT_F32_Process(const BSP_LUT_F32_TypeDef *pTable, const float *pSrc, float *pDst,
+                                      uint32_t Length);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_LUT_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,202 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lzss.h
+  * @author  MCU Application Team
+  * @brief   Header file of the LZSS streaming compression BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_LZSS_H
+#define __PY32F4XX_BSP_LZSS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_pipe.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_LZSS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_LZSS_Exported_Constants BSP LZSS Exported Constants
+  * @{
+  */
+#define BSP_LZSS_WINDOW_BITS_MIN        4U             /*!< Smallest window, 16 bytes                       */
+#define BSP_LZSS_WINDOW_BITS_MAX        12U            /*!< Largest window, 4 KB                            */
+#define BSP_LZSS_LOOKAHEAD_BITS_MIN     3U             /*!< Shortest longest match, 8 bytes                 */
+
+#ifndef BSP_LZSS_CHAIN_MAX
+#define BSP_LZSS_CHAIN_MAX              32U            /*!< Candidates tried per match with an index        */
+#endif
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_LZSS_Exported_Macros BSP LZSS Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Bytes of the window buffer of an encoder, twice the window.
+  * @param  __WINDOW_BITS__ Window bits.
+  */
+#define BSP_LZSS_ENC_WINDOW_SIZE(__WINDOW_BITS__)   (2UL << (__WINDOW_BITS__))
+
+/**
+  * @brief  Half words of the optional index of an encoder, a chain per position and a head per byte.
+  * @param  __WINDOW_BITS__ Window bits.
+  */
+#define BSP_LZSS_ENC_INDEX_SIZE(__WINDOW_BITS__)    ((2UL << (__WINDOW_BITS__)) + 256UL)
+
+/**
+  * @brief  Bytes of the window buffer of a decoder.
+  * @param  __WINDOW_BITS__ Window bits.
+  */
+#define BSP_LZSS_DEC_WINDOW_SIZE(__WINDOW_BITS__)   (1UL << (__WINDOW_BITS__))
+
+/**
+  * @brief  Worst size of the stream of Size bytes, incompressible data, a flag bit per byte.
+  * @param  __SIZE__ Bytes of data.
+  */
+#define BSP_LZSS_BOUND(__SIZE__)                    ((__SIZE__) + (((__SIZE__) + 7U) / 8U) + 1U)
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_LZSS_Exported_Types BSP LZSS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Encoder definition
+  */
+typedef struct
+{
+  uint8_t                 *pWindow;     /*!< History then data waiting, BSP_LZSS_ENC_WINDOW_SIZE    */
+
+  uint16_t                *pIndex;      /*!< Match chains, BSP_LZSS_ENC_INDEX_SIZE, NULL for none   */
+
+  uint32_t                WindowBits;   /*!< Bits of a distance                                     */
+
+  uint32_t                LookaheadBits; /*!< Bits of a length                                      */
+
+  uint32_t                MinMatch;     /*!< Shortest match shorter than its literals               */
+
+  uint32_t                Fill;         /*!< Bytes in the window buffer                             */
+
+  uint32_t                Pos;          /*!< Next byte to encode in the window buffer               */
+
+  uint32_t                Bits;         /*!< Bits not output yet, the last BitCount ones            */
+
+  uint32_t                BitCount;     /*!< Bits not output yet                                    */
+
+  uint32_t                TotalIn;      /*!< Bytes encoded                                          */
+
+  uint32_t                TotalOut;     /*!< Bytes output                                           */
+
+} BSP_LZSS_EncTypeDef;
+
+/**
+  * @brief  Decoder definition
+  */
+typedef struct
+{
+  uint8_t                 *pWindow;     /*!< Bytes output last, BSP_LZSS_DEC_WINDOW_SIZE            */
+
+  uint32_t                WindowBits;   /*!< Bits of a distance                                     */
+
+  uint32_t                LookaheadBits; /*!< Bits of a length                                      */
+
+  uint32_t                Head;         /*!< Bytes output                                           */
+
+  uint32_t                Bits;         /*!< Bits read and not decoded, the last BitCount ones      */
+
+  uint32_t                BitCount;     /*!< Bits read and not decoded                              */
+
+  uint32_t                Distance;     /*!< Distance of the match being copied                     */
+
+  uint32_t                Remaining;    /*!< Bytes of the match left to copy                        */
+
+} BSP_LZSS_DecTypeDef;
+
+/**
+  * @brief  Pipeline stage context, compressing the blocks into blocks of the pool
+  */
+typedef struct
+{
+  BSP_LZSS_EncTypeDef     Enc;          /*!< Encoder                                                */
+
+  BSP_PIPE_TypeDef        *hpipe;       /*!< Pipeline of the stage                                  */
+
+  BSP_PIPE_BlockTypeDef   *pOut;        /*!< Block being filled                                     */
+
+  uint32_t                Offset;       /*!< Bytes of the block given consumed                      */
+
+} BSP_LZSS_StageTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_LZSS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_LZSS_EncInit(BSP_LZSS_EncTypeDef *henc, uint8_t *pWindow, uint16_t *pIndex,
+                                   uint32_t WindowBits, uint32_t LookaheadBits);
+void              BSP_LZSS_EncReset(BSP_LZSS_EncTypeDef *henc);
+HAL_StatusTypeDef BSP_LZSS_Encode(BSP_LZSS_EncTypeDef *henc, const uint8_t *pIn, uint32_t InSize, uint32_t *pInUsed,
+                                  uint8_t *pOut, uint32_t OutSize, uint32_t *pOutUsed, uint32_t Finish);
+
+HAL_StatusTypeDef BSP_LZSS_DecInit(BSP_LZSS_DecTypeDef *hdec, uint8_t *pWindow, uint32_t WindowBits,
+                                   uint32_t LookaheadBits);
+void              BSP_LZSS_DecReset(BSP_LZSS_DecTypeDef *hdec);
+HAL_StatusTypeDef BSP_LZSS_Decode(BSP_LZSS_DecTypeDef *hdec, const uint8_t *pIn, uint32_t InSize, uint32_t *pInUsed,
+                                  uint8_t *pOut, uint32_t OutSize, uint32_t *pOutUsed);
+
+HAL_StatusTypeDef BSP_LZSS_StageInit(BSP_LZSS_StageTypeDef *hctx, BSP_PIPE_TypeDef *hpipe, uint8_t *pWindow,
+                                     uint16_t *pIndex, uint32_t WindowBits, uint32_t LookaheadBits);
+uint32_t          BSP_LZSS_StageProcess(BSP_PIPE_StageTypeDef *hstage, BSP_PIPE_BlockTypeDef **ppBlock);
+HAL_StatusTypeDef BSP_LZSS_StageFinish(BSP_PIPE_StageTypeDef *hstage);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_LZSS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
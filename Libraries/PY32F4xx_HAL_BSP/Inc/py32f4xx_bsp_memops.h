@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_memops.h
+  * @author  MCU Application Team
+  * @brief   Header file of the memory copy and fill BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_MEMOPS_H
+#define __PY32F4XX_BSP_MEMOPS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_MEMOPS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Exported_Constants BSP MEMOPS Exported Constants
+  * @{
+  */
+#if !defined (BSP_MEMOPS_SMALL)
+#define BSP_MEMOPS_SMALL                16U            /*!< Sizes below copied or filled byte by byte  */
+#endif /* BSP_MEMOPS_SMALL */
+
+#define BSP_MEMOPS_DMA_MAX              (0xFFFFU * 4U) /*!< Largest copy of the DMA, 65535 words       */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_MEMOPS_Exported_Functions
+  * @{
+  */
+void              *BSP_MEMOPS_Copy(void *pDst, const void *pSrc, size_t Size);
+void              *BSP_MEMOPS_Move(void *pDst, const void *pSrc, size_t Size);
+void              *BSP_MEMOPS_Set(void *pDst, int Value, size_t Size);
+#if defined (HAL_DMA_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_MEMOPS_AttachDma(DMA_HandleTypeDef *hdma, uint32_t Threshold);
+void              BSP_MEMOPS_DetachDma(void);
+#endif /* HAL_DMA_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_MEMOPS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
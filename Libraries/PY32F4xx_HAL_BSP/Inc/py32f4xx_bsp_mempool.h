@@ -0,0 +1,144 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_mempool.h
+  * @author  MCU Application Team
+  * @brief   Header file of the block pool and arena allocator BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_MEMPOOL_H
+#define __PY32F4XX_BSP_MEMPOOL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_MEMPOOL
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Exported_Constants BSP MEMPOOL Exported Constants
+  * @{
+  */
+#define BSP_MEMPOOL_ALIGN               8U             /*!< Alignment of the blocks and of the
+                                                            buffers given, the one of uint64_t        */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Exported_Types BSP MEMPOOL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Fixed block pool definition
+  */
+typedef struct
+{
+  uint8_t                 *pBuffer;     /*!< Blocks, aligned on BSP_MEMPOOL_ALIGN                   */
+
+  uint32_t                BlockSize;    /*!< Bytes of a block, rounded up to BSP_MEMPOOL_ALIGN      */
+
+  uint32_t                Count;        /*!< Blocks of the pool                                     */
+
+  void                    *__IO pFree;  /*!< First free block, holding the next one                 */
+
+  __IO uint32_t           Used;         /*!< Blocks allocated                                       */
+
+  __IO uint32_t           Peak;         /*!< Most blocks allocated at once                          */
+
+  __IO uint32_t           Failures;     /*!< Allocations refused, the pool empty                    */
+
+} BSP_MEMPOOL_TypeDef;
+
+/**
+  * @brief  Arena definition
+  */
+typedef struct
+{
+  uint8_t                 *pBuffer;     /*!< Memory of the arena, aligned on BSP_MEMPOOL_ALIGN      */
+
+  uint32_t                Size;         /*!< Bytes of the arena                                     */
+
+  __IO uint32_t           Used;         /*!< Bytes allocated from the start, the mark of now        */
+
+  __IO uint32_t           Peak;         /*!< Most bytes allocated at once                           */
+
+  __IO uint32_t           Failures;     /*!< Allocations refused, the arena short                   */
+
+} BSP_MEMPOOL_ArenaTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Exported_Macros BSP MEMPOOL Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Bytes of the buffer of a pool.
+  * @param  __BLOCKSIZE__ Bytes of a block.
+  * @param  __COUNT__ Blocks of the pool.
+  * @retval Bytes
+  */
+#define BSP_MEMPOOL_BUFFER_SIZE(__BLOCKSIZE__, __COUNT__) \
+  ((((__BLOCKSIZE__) + BSP_MEMPOOL_ALIGN - 1U) & ~(BSP_MEMPOOL_ALIGN - 1U)) * (__COUNT__))
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_MEMPOOL_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_MEMPOOL_Init(BSP_MEMPOOL_TypeDef *hpool, void *pBuffer, uint32_t BlockSize, uint32_t Count);
+void              *BSP_MEMPOOL_Alloc(BSP_MEMPOOL_TypeDef *hpool);
+HAL_StatusTypeDef BSP_MEMPOOL_Free(BSP_MEMPOOL_TypeDef *hpool, void *pBlock);
+HAL_StatusTypeDef BSP_MEMPOOL_ArenaInit(BSP_MEMPOOL_ArenaTypeDef *harena, void *pBuffer, uint32_t Size);
+void              *BSP_MEMPOOL_ArenaAlloc(BSP_MEMPOOL_ArenaTypeDef *harena, uint32_t Size, uint32_t Align);
+uint32_t          BSP_MEMPOOL_ArenaMark(const BSP_MEMPOOL_ArenaTypeDef *harena);
+HAL_StatusTypeDef BSP_MEMPOOL_ArenaRelease(BSP_MEMPOOL_ArenaTypeDef *harena, uint32_t Mark);
+void              BSP_MEMPOOL_ArenaReset(BSP_MEMPOOL_ArenaTypeDef *harena);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_MEMPOOL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_metrics.h
+  * @author  MCU Application Team
+  * @brief   Header file of the performance metrics BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_METRICS_H
+#define __PY32F4XX_BSP_METRICS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_METRICS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Exported_Constants BSP METRICS Exported Constants
+  * @{
+  */
+#if !defined (BSP_METRICS_MAX)
+#define BSP_METRICS_MAX                 32U            /*!< Metrics of the registry                      */
+#endif /* BSP_METRICS_MAX */
+
+#if !defined (BSP_METRICS_WORDS)
+#define BSP_METRICS_WORDS               128U           /*!< Value words of the metrics of the registry,
+                                                            linked counters excluded                     */
+#endif /* BSP_METRICS_WORDS */
+
+#if !defined (BSP_METRICS_ITM_PORT)
+#define BSP_METRICS_ITM_PORT            3U             /*!< ITM stimulus port, 0 printf, 1 BSP_PROBE and
+                                                            2 BSP_LOG                                    */
+#endif /* BSP_METRICS_ITM_PORT */
+
+#if !defined (BSP_METRICS_LAYOUT_PERIOD)
+#define BSP_METRICS_LAYOUT_PERIOD       16U            /*!< Snapshots between two layout frames, for a
+                                                            viewer started after the first one           */
+#endif /* BSP_METRICS_LAYOUT_PERIOD */
+
+#define BSP_METRICS_EDGES_MAX           15U            /*!< Bucket edges of a histogram                  */
+#define BSP_METRICS_NAME_MAX            31U            /*!< Characters of a name sent, longer truncated  */
+#define BSP_METRICS_MAGIC               0x54454D42U    /*!< "BMET", control block initialized            */
+#define BSP_METRICS_SYNC                0x54454D42U    /*!< First word of a frame                        */
+#define BSP_METRICS_ID_NONE             0xFFFFFFFFU    /*!< Metric not registered, its updates ignored   */
+
+/** @defgroup BSP_METRICS_Type BSP METRICS Type
+  * @{
+  */
+#define BSP_METRICS_TYPE_COUNTER        0x00000000U    /*!< Event count, 1 word, wraps at 2^32              */
+#define BSP_METRICS_TYPE_GAUGE          0x00000001U    /*!< Level, 2 words: the value and its maximum       */
+#define BSP_METRICS_TYPE_HISTOGRAM      0x00000002U    /*!< Distribution, Edges + 2 words: the count of
+                                                            each bucket then the sum of the values          */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_METRICS_Frame BSP METRICS Frame
+  * @{
+  */
+#define BSP_METRICS_FRAME_LAYOUT        0x00000001U    /*!< Names, types and bucket edges                   */
+#define BSP_METRICS_FRAME_SNAPSHOT      0x00000002U    /*!< Value words of all the metrics                  */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_METRICS_Transport BSP METRICS Transport
+  * @{
+  */
+#define BSP_METRICS_TRANSPORT_MEMORY    0x00000000U    /*!< Frames read by the debugger, metricsview.py --pyocd */
+#define BSP_METRICS_TRANSPORT_UART      0x00000001U    /*!< Frames sent by the UART DMA                         */
+#define BSP_METRICS_TRANSPORT_ITM       0x00000002U    /*!< Frames written to the ITM stimulus port on SWO      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Exported_Types BSP METRICS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Metric definition
+  */
+typedef struct
+{
+  const char              *pName;       /*!< Name, a string constant                                 */
+
+  __IO uint32_t           *pValue;      /*!< Value words, in the registry or the counter of a driver */
+
+  const uint32_t          *pEdges;      /*!< Ascending upper bounds, excluded, of the buckets but the
+                                             last of a histogram, NULL otherwise                    */
+
+  uint8_t                 Type;         /*!< A value of @ref BSP_METRICS_Type                        */
+
+  uint8_t                 Edges;        /*!< Bucket edges of a histogram, 0 otherwise                */
+
+  uint8_t                 Words;        /*!< Value words of the metric                              */
+
+  uint8_t                 Linked;       /*!< 1 when pValue is the counter of a driver, not reset     */
+
+} BSP_METRICS_MetricTypeDef;
+
+/**
+  * @brief  Metrics registry control block definition
+  * @note   The first six words are read by the host in the memory transport,
+  *         which writes Request. Sequence is odd while the frames of pBuffer
+  *         are written.
+  */
+typedef struct
+{
+  uint32_t                Magic;        /*!< BSP_METRICS_MAGIC once initialized                     */
+
+  uint32_t                *pBuffer;     /*!< Frame storage                                          */
+
+  uint32_t                Size;         /*!< Frame storage size in words                            */
+
+  __IO uint32_t           Length;       /*!< Words of the frames in pBuffer                         */
+
+  __IO uint32_t           Sequence;     /*!< Snapshots since BSP_METRICS_Init(), times two          */
+
+  __IO uint32_t           Request;      /*!< Non zero for a snapshot on the next
+                                             BSP_METRICS_Process(), set by the host or the
+                                             application                                           */
+
+  uint32_t                Period;       /*!< Milliseconds between two snapshots of
+                                             BSP_METRICS_Process(), 0 on request only               */
+
+  uint32_t                TickStart;    /*!< HAL tick of the last periodic snapshot                 */
+
+  uint32_t                Count;        /*!< Metrics registered                                     */
+
+  uint32_t                Used;         /*!< Words of Values taken by the metrics                   */
+
+  uint32_t                Layout;       /*!< Snapshots until the next layout frame, 0 for the next
+                                             one                                                    */
+
+  __IO uint32_t           Busy;         /*!< UART transfer of pBuffer in progress                   */
+
+  uint32_t                Transport;    /*!< Transport, a value of @ref BSP_METRICS_Transport       */
+
+#if defined (HAL_UART_MODULE_ENABLED)
+  UART_HandleTypeDef      *huart;       /*!< UART of the UART transport, its hdmatx linked          */
+#endif /* HAL_UART_MODULE_ENABLED */
+
+  BSP_METRICS_MetricTypeDef Metrics[BSP_METRICS_MAX]; /*!< Registry, in the order of registration   */
+
+  uint32_t                Values[BSP_METRICS_WORDS]; /*!< Value words of the metrics                */
+
+} BSP_METRICS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Exported_Macros BSP METRICS Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Count an event of a counter.
+  */
+#define BSP_METRICS_INC(__ID__)         BSP_METRICS_Add((__ID__), 1U)
+
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_METRICS_Exported_Variables
+  * @{
+  */
+extern BSP_METRICS_TypeDef BSP_Metrics;
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_METRICS_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_METRICS_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization and registration functions **********************************/
+HAL_StatusTypeDef BSP_METRICS_Init(uint32_t *pBuffer, uint32_t Size);
+#if defined (HAL_UART_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_METRICS_ConfigUart(UART_HandleTypeDef *huart);
+void              BSP_METRICS_TxCpltCallback(UART_HandleTypeDef *huart);
+#endif /* HAL_UART_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_METRICS_ConfigITM(uint32_t SwoHz);
+HAL_StatusTypeDef BSP_METRICS_SetPeriod(uint32_t Period);
+HAL_StatusTypeDef BSP_METRICS_Register(const char *pName, uint32_t Type, const uint32_t *pEdges,
+                                       uint32_t Edges, uint32_t *pId);
+HAL_StatusTypeDef BSP_METRICS_Link(const char *pName, uint32_t Type, __IO uint32_t *pValue, uint32_t *pId);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_METRICS_Exported_Functions_Group2
+  * @{
+  */
+/* Update functions ***********************************************************/
+void              BSP_METRICS_Add(uint32_t Id, uint32_t Value);
+void              BSP_METRICS_Set(uint32_t Id, uint32_t Value);
+void              BSP_METRICS_Observe(uint32_t Id, uint32_t Value);
+void              BSP_METRICS_Reset(void);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_METRICS_Exported_Functions_Group3
+  * @{
+  */
+/* Export functions ***********************************************************/
+HAL_StatusTypeDef BSP_METRICS_Send(void);
+void              BSP_METRICS_Process(void);
+void              BSP_METRICS_SnapshotCallback(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_METRICS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
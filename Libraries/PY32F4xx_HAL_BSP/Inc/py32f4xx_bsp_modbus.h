@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_modbus.h
+  * @author  MCU Application Team
+  * @brief   Header file of the Modbus server BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_MODBUS_H
+#define __PY32F4XX_BSP_MODBUS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_crc.h"
+#include "py32f4xx_bsp_timwheel.h"
+
+#if defined (HAL_UART_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_MODBUS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Exported_Constants BSP MODBUS Exported Constants
+  * @{
+  */
+#define BSP_MODBUS_ADU_SIZE             256U           /*!< Largest RTU frame, address to CRC               */
+
+#define BSP_MODBUS_TX_SIZE              513U           /*!< Largest ASCII frame, ':' to CR LF               */
+
+#ifndef BSP_MODBUS_RX_SIZE
+#define BSP_MODBUS_RX_SIZE              64U            /*!< Circular Rx DMA buffer, reported at half and end */
+#endif
+
+#ifndef BSP_MODBUS_TICK_HZ
+#define BSP_MODBUS_TICK_HZ              1000000U       /*!< Tick of the BSP_TIMWHEEL timers                 */
+#endif
+
+/** @defgroup BSP_MODBUS_Mode BSP MODBUS Mode
+  * @{
+  */
+#define BSP_MODBUS_MODE_RTU             0x00000000U    /*!< Binary frames ended by 3.5 characters of silence */
+#define BSP_MODBUS_MODE_ASCII           0x00000001U    /*!< Hexadecimal frames from ':' to CR LF, with LRC  */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_MODBUS_Type BSP MODBUS Type
+  * @{
+  */
+#define BSP_MODBUS_TYPE_COIL            0x01U          /*!< Read write bits, function codes 1, 5 and 15     */
+#define BSP_MODBUS_TYPE_DISCRETE        0x02U          /*!< Read only bits, function code 2                 */
+#define BSP_MODBUS_TYPE_HOLDING         0x03U          /*!< Read write registers, function codes 3, 6 and 16 */
+#define BSP_MODBUS_TYPE_INPUT           0x04U          /*!< Read only registers, function code 4            */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_MODBUS_Flag BSP MODBUS Flag
+  * @{
+  */
+#define BSP_MODBUS_FLAG_NONE            0x00U          /*!< Registers in the CPU order                      */
+#define BSP_MODBUS_FLAG_WIRE            0x01U          /*!< Registers stored big endian, sent in place by the
+                                                            Tx DMA in RTU mode                              */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_MODBUS_Exception BSP MODBUS Exception
+  * @{
+  */
+#define BSP_MODBUS_EX_NONE              0x00U          /*!< Request served                                  */
+#define BSP_MODBUS_EX_ILLEGAL_FUNCTION  0x01U          /*!< Function code not supported                     */
+#define BSP_MODBUS_EX_ILLEGAL_ADDRESS   0x02U          /*!< Range not inside one entry of the map           */
+#define BSP_MODBUS_EX_ILLEGAL_VALUE     0x03U          /*!< Quantity, byte count or coil value out of range */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_MODBUS_State BSP MODBUS State
+  * @{
+  */
+#define BSP_MODBUS_STATE_RESET          0x00000000U    /*!< Not started                                     */
+#define BSP_MODBUS_STATE_IDLE           0x00000001U    /*!< Waiting for a frame                             */
+#define BSP_MODBUS_STATE_RECEIVE        0x00000002U    /*!< Frame being received                            */
+#define BSP_MODBUS_STATE_READY          0x00000003U    /*!< Frame complete, for BSP_MODBUS_Process()        */
+#define BSP_MODBUS_STATE_TX             0x00000004U    /*!< Response being sent                             */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Exported_Types BSP MODBUS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Register map entry definition
+  * @note   Bits are packed 8 per byte, the first one in bit 0. Registers are
+  *         uint16_t, big endian with BSP_MODBUS_FLAG_WIRE.
+  */
+typedef struct __BSP_MODBUS_MapEntryTypeDef
+{
+  uint8_t                 Type;         /*!< A value of @ref BSP_MODBUS_Type                        */
+
+  uint8_t                 Flags;        /*!< A combination of @ref BSP_MODBUS_Flag                  */
+
+  uint16_t                Address;      /*!< Modbus address of the first bit or register            */
+
+  uint16_t                Count;        /*!< Number of bits or registers                            */
+
+  void                    *pData;       /*!< Variables of the application                           */
+
+  void                    (*WriteCallback)(const struct __BSP_MODBUS_MapEntryTypeDef *pEntry,
+                                           uint32_t Offset, uint32_t Count); /*!< Called from
+                                             BSP_MODBUS_Process() after a write, may be NULL         */
+} BSP_MODBUS_MapEntryTypeDef;
+
+/**
+  * @brief  Transmit segment definition
+  */
+typedef struct
+{
+  const uint8_t           *pData;       /*!< Bytes of the segment                                   */
+
+  uint32_t                Length;       /*!< Number of bytes                                        */
+
+} BSP_MODBUS_SegmentTypeDef;
+
+/**
+  * @brief  Statistics definition
+  */
+typedef struct
+{
+  uint32_t                Requests;     /*!< Valid frames addressed to the server or broadcast      */
+
+  uint32_t                Responses;    /*!< Responses sent, exceptions included                    */
+
+  uint32_t                Exceptions;   /*!< Exception responses                                    */
+
+  uint32_t                Errors;       /*!< Frames with a wrong CRC or LRC                         */
+
+  uint32_t                Dropped;      /*!< Frames too long, malformed or received while busy      */
+
+} BSP_MODBUS_StatsTypeDef;
+
+/**
+  * @brief  Modbus server definition
+  */
+typedef struct
+{
+  UART_HandleTypeDef      *huart;       /*!< UART, its Rx DMA circular, its Tx DMA normal           */
+
+  BSP_TIMWHEEL_TypeDef    *hwheel;      /*!< Timer wheel of the RTU silence, NULL in ASCII mode     */
+
+  uint32_t                Mode;         /*!< A value of @ref BSP_MODBUS_Mode                        */
+
+  uint32_t                Address;      /*!< Server address, 1 to 247                               */
+
+  const BSP_MODBUS_MapEntryTypeDef *pMap; /*!< Register map                                         */
+
+  uint32_t                MapSize;      /*!< Number of entries of the map                           */
+
+  uint32_t                Silence;      /*!< 3.5 characters in ticks of the timer wheel             */
+
+  BSP_TIMWHEEL_TimerTypeDef Timer;      /*!< End of frame timer                                     */
+
+  BSP_CRC_TypeDef         Crc;          /*!< CRC-16/MODBUS                                          */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_MODBUS_State                       */
+
+  __IO uint32_t           Skip;         /*!< Bytes dropped up to the next silence                   */
+
+  uint32_t                Nibble;       /*!< ASCII: high nibble taken, in bit 8                     */
+
+  uint32_t                Length;       /*!< Bytes of the frame received                            */
+
+  uint8_t                 Adu[BSP_MODBUS_ADU_SIZE]; /*!< Frame received, decoded in ASCII mode      */
+
+  uint8_t                 RxBuffer[BSP_MODBUS_RX_SIZE]; /*!< Circular Rx DMA buffer                 */
+
+  uint8_t                 TxBuffer[BSP_MODBUS_TX_SIZE]; /*!< Response, from byte 1 in RTU mode      */
+
+  uint8_t                 TxCrc[2];     /*!< CRC of a response sent in place                        */
+
+  BSP_MODBUS_SegmentTypeDef Segments[3]; /*!< Segments of the response                              */
+
+  uint32_t                SegmentCount; /*!< Number of segments                                     */
+
+  __IO uint32_t           SegmentNext;  /*!< Next segment sent                                      */
+
+  BSP_MODBUS_StatsTypeDef Stats;        /*!< Statistics                                             */
+
+} BSP_MODBUS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Exported_Macros BSP MODBUS Exported Macros
+  * @{
+  */
+
+/** @brief  Map entry of an array of bits or registers.
+  * @param  __TYPE__ A value of @ref BSP_MODBUS_Type.
+  * @param  __FLAGS__ A combination of @ref BSP_MODBUS_Flag.
+  * @param  __ADDRESS__ Modbus address of the first bit or register.
+  * @param  __COUNT__ Number of bits or registers.
+  * @param  __DATA__ Variables of the application.
+  * @param  __CALLBACK__ Write callback, may be NULL.
+  */
+#define BSP_MODBUS_ENTRY(__TYPE__, __FLAGS__, __ADDRESS__, __COUNT__, __DATA__, __CALLBACK__) \
+  { (__TYPE__), (__FLAGS__), (__ADDRESS__), (__COUNT__), (void *)(__DATA__), (__CALLBACK__) }
+
+/** @brief  Map entry of a uint16_t array of registers.
+  * @param  __TYPE__ BSP_MODBUS_TYPE_HOLDING or BSP_MODBUS_TYPE_INPUT.
+  * @param  __FLAGS__ A combination of @ref BSP_MODBUS_Flag.
+  * @param  __ADDRESS__ Modbus address of the first register.
+  * @param  __ARRAY__ Registers of the application.
+  * @param  __CALLBACK__ Write callback, may be NULL.
+  */
+#define BSP_MODBUS_REGISTERS(__TYPE__, __FLAGS__, __ADDRESS__, __ARRAY__, __CALLBACK__) \
+  BSP_MODBUS_ENTRY((__TYPE__), (__FLAGS__), (__ADDRESS__), sizeof(__ARRAY__) / sizeof(uint16_t), \
+                   (__ARRAY__), (__CALLBACK__))
+
+/** @brief  Value of a register stored with BSP_MODBUS_FLAG_WIRE, or value to store.
+  * @param  __VALUE__ Register or value.
+  */
+#define BSP_MODBUS_WIRE16(__VALUE__)    ((uint16_t)(((uint16_t)(__VALUE__) >> 8U) | ((uint16_t)(__VALUE__) << 8U)))
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_MODBUS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_MODBUS_Init(BSP_MODBUS_TypeDef *hmb, UART_HandleTypeDef *huart, BSP_TIMWHEEL_TypeDef *hwheel,
+                                  uint32_t Mode, uint32_t Address, const BSP_MODBUS_MapEntryTypeDef *pMap,
+                                  uint32_t MapSize);
+HAL_StatusTypeDef BSP_MODBUS_Start(BSP_MODBUS_TypeDef *hmb);
+HAL_StatusTypeDef BSP_MODBUS_Stop(BSP_MODBUS_TypeDef *hmb);
+void              BSP_MODBUS_RxFrameCallback(BSP_MODBUS_TypeDef *hmb, uint32_t Offset, uint32_t Length);
+void              BSP_MODBUS_TxCpltCallback(BSP_MODBUS_TypeDef *hmb);
+void              BSP_MODBUS_Process(BSP_MODBUS_TypeDef *hmb);
+void              BSP_MODBUS_GetStats(const BSP_MODBUS_TypeDef *hmb, BSP_MODBUS_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_MODBUS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_motoradc.h
+  * @author  MCU Application Team
+  * @brief   Header file of the motor control ADC BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_MOTORADC_H
+#define __PY32F4XX_BSP_MOTORADC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_MOTORADC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_MOTORADC_Exported_Constants BSP MOTORADC Exported Constants
+  * @{
+  */
+#define BSP_MOTORADC_ADCS               2U             /*!< ADC1 and ADC2, injected simultaneous      */
+#define BSP_MOTORADC_RANKS              4U             /*!< Injected ranks of each ADC                */
+
+/** @defgroup BSP_MOTORADC_State BSP MOTORADC State
+  * @{
+  */
+#define BSP_MOTORADC_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_MOTORADC_STATE_READY        0x00000001U    /*!< Initialized, sampling stopped             */
+#define BSP_MOTORADC_STATE_RUN          0x00000002U    /*!< Sampling on each PWM period               */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_MOTORADC_Exported_Types BSP MOTORADC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Motor control ADC configuration definition
+  */
+typedef struct
+{
+  uint32_t                SamplePoint;  /*!< Compare value of CC4 starting the injected conversions */
+
+  uint32_t                NbrOfConversion; /*!< Injected ranks converted by each ADC, 1 to 4        */
+
+  uint32_t                Channels[BSP_MOTORADC_ADCS][BSP_MOTORADC_RANKS]; /*!< Channels of ADC1 and
+                                             ADC2 by rank, a value of @ref ADC_channels. Rank 1 of
+                                             each ADC is a phase current                           */
+
+  uint32_t                SamplingTime; /*!< A value of @ref ADC_sampling_times, the same on both ADCs */
+
+} BSP_MOTORADC_InitTypeDef;
+
+/**
+  * @brief  Motor control ADC state definition
+  */
+typedef struct
+{
+  ADC_HandleTypeDef       *hadc[BSP_MOTORADC_ADCS]; /*!< ADC1 master and ADC2 slave               */
+
+  TIM_HandleTypeDef       *htim;        /*!< TIM1 or TIM8 generating the PWM                        */
+
+  uint32_t                SamplePoint;  /*!< Compare value of CC4                                   */
+
+  uint32_t                NbrOfConversion; /*!< Injected ranks converted by each ADC                */
+
+  uint32_t                CounterMode;  /*!< Counter mode of the timer, selects the latency formula */
+
+  uint32_t                TimerClock;   /*!< Timer kernel clock in Hz                               */
+
+  __IO uint16_t           Values[BSP_MOTORADC_ADCS][BSP_MOTORADC_RANKS]; /*!< Last injected results   */
+
+  uint16_t                Offsets[BSP_MOTORADC_ADCS]; /*!< Zero current of rank 1 of each ADC      */
+
+  __IO uint32_t           CalibCount;   /*!< Samples left to the offset calibration, 0 when done    */
+
+  uint32_t                CalibSamples; /*!< Samples averaged by the offset calibration             */
+
+  uint32_t                CalibSums[BSP_MOTORADC_ADCS]; /*!< Offset calibration sums              */
+
+  __IO uint32_t           Latency;      /*!< Timer ticks from the trigger to the last handler       */
+
+  __IO uint32_t           LatencyMax;   /*!< Largest Latency since the last reset                   */
+
+  __IO uint32_t           SampleCount;  /*!< Injected sequences handled                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_MOTORADC_State                     */
+
+} BSP_MOTORADC_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_MOTORADC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_MOTORADC_Init(BSP_MOTORADC_TypeDef *hmadc, ADC_HandleTypeDef *hadc1,
+                                    ADC_HandleTypeDef *hadc2, TIM_HandleTypeDef *htim,
+                                    const BSP_MOTORADC_InitTypeDef *pInit);
+HAL_StatusTypeDef BSP_MOTORADC_Start(BSP_MOTORADC_TypeDef *hmadc);
+HAL_StatusTypeDef BSP_MOTORADC_Stop(BSP_MOTORADC_TypeDef *hmadc);
+HAL_StatusTypeDef BSP_MOTORADC_SetSamplePoint(BSP_MOTORADC_TypeDef *hmadc, uint32_t SamplePoint);
+HAL_StatusTypeDef BSP_MOTORADC_StartCalibration(BSP_MOTORADC_TypeDef *hmadc, uint32_t Samples);
+uint32_t          BSP_MOTORADC_IsCalibrating(const BSP_MOTORADC_TypeDef *hmadc);
+void              BSP_MOTORADC_GetPhaseCurrents(const BSP_MOTORADC_TypeDef *hmadc, int16_t *pIa, int16_t *pIb);
+uint16_t          BSP_MOTORADC_GetValue(const BSP_MOTORADC_TypeDef *hmadc, uint32_t Adc, uint32_t Rank);
+void              BSP_MOTORADC_GetLatency(const BSP_MOTORADC_TypeDef *hmadc, uint32_t *pLastNs, uint32_t *pMaxNs);
+void              BSP_MOTORADC_ResetLatency(BSP_MOTORADC_TypeDef *hmadc);
+void              BSP_MOTORADC_IRQHandler(BSP_MOTORADC_TypeDef *hmadc);
+void              BSP_MOTORADC_SampleCallback(BSP_MOTORADC_TypeDef *hmadc);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_MOTORADC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
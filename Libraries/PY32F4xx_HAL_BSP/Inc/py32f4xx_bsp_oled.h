@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_oled.h
+  * @author  MCU Application Team
+  * @brief   Header file of the I2C OLED display BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_OLED_H
+#define __PY32F4XX_BSP_OLED_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_i2csched.h"
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_OLED
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_OLED_Exported_Constants BSP OLED Exported Constants
+  * @{
+  */
+#define BSP_OLED_WIDTH                  128U           /*!< Columns of the panel                            */
+#define BSP_OLED_HEIGHT                 64U            /*!< Rows of the panel                               */
+#define BSP_OLED_PAGES                  8U             /*!< Pages of 8 rows, a byte per column each         */
+#define BSP_OLED_ADDRESS                0x78U          /*!< Device address of 0x3C shifted left, 0x7A for a
+                                                            SA0 pin high                                     */
+#ifndef BSP_OLED_CHUNK_SIZE
+#define BSP_OLED_CHUNK_SIZE             32U            /*!< Most bytes of a data write, 0.8 ms of the bus at
+                                                            400 kHz between the sensor cycles                */
+#endif
+#define BSP_OLED_COMMAND_SIZE           8U             /*!< Most bytes of BSP_OLED_Command()                */
+
+/** @defgroup BSP_OLED_Controller BSP OLED Controller
+  * @{
+  */
+#define BSP_OLED_SSD1306                0x00000000U    /*!< SSD1306, 128 columns of RAM                     */
+#define BSP_OLED_SH1106                 0x00000001U    /*!< SH1106, 132 columns of RAM, panel from column 2 */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_OLED_Exported_Types BSP OLED Exported Types
+  * @{
+  */
+
+/**
+  * @brief  OLED display state definition
+  */
+typedef struct
+{
+  BSP_I2CSCHED_TypeDef    *hsched;      /*!< Scheduler of the I2C, NULL when not initialized         */
+
+  uint32_t                Controller;   /*!< A value of @ref BSP_OLED_Controller                     */
+
+  uint8_t                 Frame[BSP_OLED_PAGES][BSP_OLED_WIDTH]; /*!< Framebuffer, bit n of a byte is row
+                                             8 * page + n, call BSP_OLED_Invalidate() after writing it */
+
+  uint8_t                 DirtyStart[BSP_OLED_PAGES]; /*!< First changed column of a page, BSP_OLED_WIDTH
+                                             when clean                                               */
+
+  uint8_t                 DirtyEnd[BSP_OLED_PAGES]; /*!< Column after the last changed one of a page    */
+
+  __IO uint32_t           DirtyMask;    /*!< Pages with changed columns, bit n for page n            */
+
+  BSP_I2CSCHED_WriteTypeDef Cmd;        /*!< Command write, control byte 0x00                        */
+
+  BSP_I2CSCHED_WriteTypeDef Data;       /*!< Data write, control byte 0x40                           */
+
+  uint8_t                 CmdBuffer[BSP_OLED_COMMAND_SIZE]; /*!< Bytes of the command write            */
+
+  __IO uint32_t           State;        /*!< Write of the display queued on the scheduler            */
+
+  __IO uint32_t           Flushing;     /*!< 1 from BSP_OLED_Flush() until no page is dirty          */
+
+  uint32_t                Page;         /*!< Page sent                                               */
+
+  uint32_t                Column;       /*!< Next column sent                                        */
+
+  uint32_t                End;          /*!< Column after the last one sent of the page              */
+
+  uint32_t                PageCount;    /*!< Number of pages sent                                    */
+
+  uint32_t                ByteCount;    /*!< Number of framebuffer bytes sent                        */
+
+  uint32_t                ErrorCount;   /*!< Number of failed writes                                 */
+
+} BSP_OLED_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_OLED_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_OLED_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_OLED_Init(BSP_OLED_TypeDef *holed, BSP_I2CSCHED_TypeDef *hsched, uint16_t DevAddress,
+                                uint32_t Controller);
+HAL_StatusTypeDef BSP_OLED_Command(BSP_OLED_TypeDef *holed, const uint8_t *pCmd, uint32_t Size);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_OLED_Exported_Functions_Group2
+  * @{
+  */
+/* Drawing functions **********************************************************/
+void              BSP_OLED_Clear(BSP_OLED_TypeDef *holed);
+void              BSP_OLED_SetPixel(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Y, uint32_t On);
+void              BSP_OLED_FillRect(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Y, uint32_t Width,
+                                    uint32_t Height, uint32_t On);
+void              BSP_OLED_DrawBitmap(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Page, const uint8_t *pBitmap,
+                                      uint32_t Width, uint32_t Pages);
+void              BSP_OLED_Invalidate(BSP_OLED_TypeDef *holed, uint32_t Page, uint32_t X, uint32_t Width);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_OLED_Exported_Functions_Group3
+  * @{
+  */
+/* Flush functions ************************************************************/
+HAL_StatusTypeDef BSP_OLED_Flush(BSP_OLED_TypeDef *holed);
+uint32_t          BSP_OLED_IsFlushing(const BSP_OLED_TypeDef *holed);
+void              BSP_OLED_WriteCpltHandler(BSP_OLED_TypeDef *holed, BSP_I2CSCHED_WriteTypeDef *pWrite);
+void              BSP_OLED_FlushCpltCallback(BSP_OLED_TypeDef *holed, HAL_StatusTypeDef Status);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_OLED_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
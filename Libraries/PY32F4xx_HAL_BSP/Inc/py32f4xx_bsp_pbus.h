@@ -0,0 +1,199 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pbus.h
+  * @author  MCU Application Team
+  * @brief   Header file of the GPIO parallel bus BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PBUS_H
+#define __PY32F4XX_BSP_PBUS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PBUS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PBUS_Exported_Constants BSP PBUS Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_PBUS_Mode BSP PBUS Mode
+  * @{
+  */
+#define BSP_PBUS_MODE_8080              0x00000000U    /*!< WR low pulse, data latched on its rising
+                                                            edge, RD low to read                      */
+#define BSP_PBUS_MODE_6800              0x00000001U    /*!< E high pulse, data latched on its falling
+                                                            edge, R/W high to read                    */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PBUS_Format BSP PBUS Format
+  * @{
+  */
+#define BSP_PBUS_FORMAT_ODR             0x00000000U    /*!< uint16_t words written to ODR, the other
+                                                            pins of the port not driven as outputs    */
+#define BSP_PBUS_FORMAT_BSRR            0x00000001U    /*!< uint32_t BSRR words, see BSP_PBUS_Pack(),
+                                                            the other pins of the port untouched      */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PBUS_State BSP PBUS State
+  * @{
+  */
+#define BSP_PBUS_STATE_RESET            0x00000000U    /*!< Not initialized                           */
+#define BSP_PBUS_STATE_READY            0x00000001U    /*!< Idle                                      */
+#define BSP_PBUS_STATE_BUSY             0x00000002U    /*!< Write running                             */
+/**
+  * @}
+  */
+
+#define BSP_PBUS_CHUNK                  256U           /*!< Strobes per run of the timer, the range of
+                                                            its repetition counter                    */
+#define BSP_PBUS_COUNT_MAX              0xFFFFU        /*!< Words of a write at most, the DMA counter */
+
+#if !defined (BSP_PBUS_READ_DELAY)
+#define BSP_PBUS_READ_DELAY             8U             /*!< Loops between the read strobe and the
+                                                            sample of IDR                             */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PBUS_Exported_Types BSP PBUS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Parallel bus configuration definition
+  */
+typedef struct
+{
+  uint32_t                Mode;         /*!< A value of @ref BSP_PBUS_Mode                          */
+
+  uint32_t                Format;       /*!< A value of @ref BSP_PBUS_Format                        */
+
+  GPIO_TypeDef            *DataPort;    /*!< Port of the data pins, outputs                         */
+
+  uint32_t                DataMask;     /*!< Data pins, contiguous, the lowest one data bit 0       */
+
+  uint32_t                StrobeChannel; /*!< TIM_CHANNEL_x driving WR or E, its pin in the AF of
+                                              the timer                                             */
+
+  GPIO_TypeDef            *StrobePort;  /*!< Port of the WR or E pin                                */
+
+  uint32_t                StrobePin;    /*!< GPIO_PIN_x of the WR or E pin                          */
+
+  uint32_t                StrobeCycles; /*!< Counter cycles of WR low or E high at the end of each
+                                             period, 1 to Init.Period less 1 of the timer          */
+
+  uint32_t                DmaChannel;   /*!< TIM_CHANNEL_x other than StrobeChannel, its CC DMA
+                                             request moving the data, hdma[TIM_DMA_ID_CCx] linked   */
+
+  GPIO_TypeDef            *DcPort;      /*!< Port of the D/C or RS pin, output                      */
+
+  uint32_t                DcPin;        /*!< GPIO_PIN_x of the D/C or RS pin, low for a command     */
+
+  GPIO_TypeDef            *CsPort;      /*!< Port of the CS pin, active low, NULL for none          */
+
+  uint32_t                CsPin;        /*!< GPIO_PIN_x of the CS pin                               */
+
+  GPIO_TypeDef            *RdPort;      /*!< Port of the RD (8080) or R/W (6800) pin, NULL for none,
+                                             no read then                                           */
+
+  uint32_t                RdPin;        /*!< GPIO_PIN_x of the RD or R/W pin                        */
+
+} BSP_PBUS_InitTypeDef;
+
+/**
+  * @brief  Parallel bus definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< TIM handle, TIM1 or TIM8, Init.Period the word period
+                                             less one                                               */
+
+  BSP_PBUS_InitTypeDef    Init;         /*!< Configuration                                          */
+
+  uint32_t                Shift;        /*!< Position of data bit 0 on the port                     */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_PBUS_State                         */
+
+  uint32_t                Count;        /*!< Words of the write running                             */
+
+  uint32_t                Sent;         /*!< Words of the runs of the timer ended                   */
+
+  uint32_t                Chunk;        /*!< Words of the run of the timer in progress              */
+
+  uint32_t                Word;         /*!< Single word written by BSP_PBUS_WriteCommand()         */
+
+} BSP_PBUS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PBUS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_PBUS_Init(BSP_PBUS_TypeDef *hbus, TIM_HandleTypeDef *htim, const BSP_PBUS_InitTypeDef *pInit);
+void              BSP_PBUS_Pack(const BSP_PBUS_TypeDef *hbus, const uint16_t *pValues, uint32_t *pWords,
+                                uint32_t Count);
+HAL_StatusTypeDef BSP_PBUS_WriteCommand(BSP_PBUS_TypeDef *hbus, uint32_t Command, uint32_t Timeout);
+HAL_StatusTypeDef BSP_PBUS_Write(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count, uint32_t Timeout);
+HAL_StatusTypeDef BSP_PBUS_Write_DMA(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count);
+HAL_StatusTypeDef BSP_PBUS_Read(BSP_PBUS_TypeDef *hbus, uint16_t *pData, uint32_t Count);
+uint32_t          BSP_PBUS_GetState(const BSP_PBUS_TypeDef *hbus);
+void              BSP_PBUS_IRQHandler(BSP_PBUS_TypeDef *hbus);
+void              BSP_PBUS_TxCpltCallback(BSP_PBUS_TypeDef *hbus);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PBUS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,245 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pipe.h
+  * @author  MCU Application Team
+  * @brief   Header file of the block pipeline BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PIPE_H
+#define __PY32F4XX_BSP_PIPE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_mempool.h"
+#include "py32f4xx_bsp_sync.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PIPE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PIPE_Exported_Constants BSP PIPE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_PIPE_Policy BSP PIPE Policy
+  * @{
+  */
+#define BSP_PIPE_POLICY_BLOCK           0U             /*!< The source keeps the block, BSP_PIPE_Push() again */
+#define BSP_PIPE_POLICY_DROP            1U             /*!< A block finding the first stage full is dropped */
+#define BSP_PIPE_POLICY_DECIMATE        2U             /*!< Past half full, 1 block of Decimation kept      */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PIPE_Result BSP PIPE Result
+  * @{
+  */
+#define BSP_PIPE_FORWARD                0U             /*!< Block done, to the next stage                   */
+#define BSP_PIPE_DONE                   1U             /*!< Block done, back to the pool                    */
+#define BSP_PIPE_KEEP                   2U             /*!< Block kept by the stage, BSP_PIPE_Free() later  */
+#define BSP_PIPE_BUSY                   3U             /*!< Stage not ready, the same block given again     */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PIPE_Exported_Types BSP PIPE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Block header, the data following it
+  */
+typedef struct
+{
+  uint32_t                Sequence;     /*!< Blocks allocated before this one                       */
+
+  uint32_t                Timestamp;    /*!< DWT cycle counter at the allocation                    */
+
+  uint16_t                Length;       /*!< Bytes of data written                                  */
+
+  uint8_t                 Channel;      /*!< Source of the data, free for the application           */
+
+  uint8_t                 Step;         /*!< Source blocks it stands for, more than 1 if decimated  */
+
+  uint32_t                Arg;          /*!< Free for the stages                                    */
+
+} BSP_PIPE_BlockTypeDef;
+
+/**
+  * @brief  Stage statistics definition
+  */
+typedef struct
+{
+  __IO uint32_t           Blocks;       /*!< Blocks processed                                       */
+
+  __IO uint32_t           Bytes;        /*!< Bytes of the blocks processed                          */
+
+  __IO uint32_t           Cycles;       /*!< Cycles spent processing, total                         */
+
+  __IO uint32_t           CyclesMax;    /*!< Longest processing of a block                          */
+
+  __IO uint32_t           Latency;      /*!< Cycles from allocation to the end of the stage, last   */
+
+  __IO uint32_t           LatencyMax;   /*!< Longest latency                                        */
+
+  __IO uint32_t           Stalls;       /*!< Calls the stage or the next one was not ready          */
+
+  __IO uint32_t           QueuePeak;    /*!< Most blocks waiting at the input                       */
+
+} BSP_PIPE_StatsTypeDef;
+
+/**
+  * @brief  Stage definition
+  */
+typedef struct __BSP_PIPE_StageTypeDef
+{
+  const char              *pName;       /*!< Name printed by BSP_PIPE_Print()                       */
+
+  uint32_t                (*Process)(struct __BSP_PIPE_StageTypeDef *hstage, BSP_PIPE_BlockTypeDef **ppBlock);
+                                        /*!< Process a block, returns a @ref BSP_PIPE_Result         */
+
+  void                    *pArg;        /*!< Context of the stage                                   */
+
+  BSP_SYNC_RingTypeDef    Input;        /*!< Blocks waiting, by pointer                             */
+
+  BSP_PIPE_BlockTypeDef   *pRetry;      /*!< Block the stage was busy for                           */
+
+  BSP_PIPE_BlockTypeDef   *pHeld;       /*!< Block processed, the next stage full                   */
+
+  BSP_PIPE_StatsTypeDef   Stats;        /*!< Statistics                                             */
+
+  struct __BSP_PIPE_StageTypeDef *pPrev; /*!< Stage before, processed after this one                */
+
+  struct __BSP_PIPE_StageTypeDef *pNext; /*!< Next stage                                            */
+
+} BSP_PIPE_StageTypeDef;
+
+/**
+  * @brief  Pipeline definition
+  */
+typedef struct
+{
+  BSP_MEMPOOL_TypeDef     Pool;         /*!< Blocks shared by all the stages                        */
+
+  uint32_t                DataSize;     /*!< Bytes of data of a block                               */
+
+  uint32_t                Policy;       /*!< @ref BSP_PIPE_Policy                                   */
+
+  uint32_t                Decimation;   /*!< Blocks for 1 kept past half full, 2 or more             */
+
+  BSP_PIPE_StageTypeDef   *pFirst;      /*!< First stage, fed by BSP_PIPE_Push()                    */
+
+  BSP_PIPE_StageTypeDef   *pLast;       /*!< Last stage                                             */
+
+  uint32_t                Sequence;     /*!< Blocks allocated                                       */
+
+  uint32_t                Skipped;      /*!< Blocks decimated since the last one kept               */
+
+  __IO uint32_t           Accepted;     /*!< Blocks pushed into the first stage                     */
+
+  __IO uint32_t           Refused;      /*!< Pushes refused, BSP_PIPE_POLICY_BLOCK                  */
+
+  __IO uint32_t           Dropped;      /*!< Blocks dropped, the first stage full                   */
+
+  __IO uint32_t           Decimated;    /*!< Blocks dropped by the decimation                       */
+
+} BSP_PIPE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_PIPE_Exported_Macros BSP PIPE Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Bytes of the buffer of the blocks of a pipeline.
+  * @param  __DATASIZE__ Bytes of data of a block.
+  * @param  __COUNT__ Blocks.
+  * @retval Bytes
+  */
+#define BSP_PIPE_BUFFER_SIZE(__DATASIZE__, __COUNT__) \
+  BSP_MEMPOOL_BUFFER_SIZE(sizeof(BSP_PIPE_BlockTypeDef) + (__DATASIZE__), (__COUNT__))
+
+/**
+  * @brief  Data of a block.
+  * @param  __BLOCK__ Block.
+  * @retval Pointer to the data
+  */
+#define BSP_PIPE_DATA(__BLOCK__)        ((void *)((BSP_PIPE_BlockTypeDef *)(__BLOCK__) + 1))
+
+/**
+  * @brief  Block of data, given by BSP_PIPE_DATA().
+  * @param  __DATA__ Data.
+  * @retval Pointer to the block
+  */
+#define BSP_PIPE_BLOCK(__DATA__)        ((BSP_PIPE_BlockTypeDef *)(uintptr_t)(__DATA__) - 1)
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PIPE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef     BSP_PIPE_Init(BSP_PIPE_TypeDef *hpipe, void *pBuffer, uint32_t DataSize, uint32_t Count,
+                                    uint32_t Policy, uint32_t Decimation);
+HAL_StatusTypeDef     BSP_PIPE_AddStage(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_StageTypeDef *hstage, const char *pName,
+                                        uint32_t (*Process)(BSP_PIPE_StageTypeDef *, BSP_PIPE_BlockTypeDef **),
+                                        void *pArg, BSP_PIPE_BlockTypeDef **pQueue, uint32_t Depth);
+BSP_PIPE_BlockTypeDef *BSP_PIPE_Alloc(BSP_PIPE_TypeDef *hpipe);
+HAL_StatusTypeDef     BSP_PIPE_Free(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_BlockTypeDef *pBlock);
+HAL_StatusTypeDef     BSP_PIPE_Push(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_BlockTypeDef *pBlock);
+uint32_t              BSP_PIPE_Process(BSP_PIPE_TypeDef *hpipe);
+HAL_StatusTypeDef     BSP_PIPE_Emit(BSP_PIPE_StageTypeDef *hstage, BSP_PIPE_BlockTypeDef *pBlock);
+void                  BSP_PIPE_ResetStats(BSP_PIPE_TypeDef *hpipe);
+void                  BSP_PIPE_Print(const BSP_PIPE_TypeDef *hpipe);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PIPE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
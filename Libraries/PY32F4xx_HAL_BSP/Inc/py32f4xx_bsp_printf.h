@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_printf.h
+  * @author  MCU Application Team
+  * @brief   Header file of the formatted output BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PRINTF_H
+#define __PY32F4XX_BSP_PRINTF_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stddef.h>
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PRINTF
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Exported_Constants BSP PRINTF Exported Constants
+  * @{
+  */
+#if !defined (BSP_PRINTF_CHUNK)
+#define BSP_PRINTF_CHUNK                64U            /*!< Bytes on the stack given at once to the output */
+#endif /* BSP_PRINTF_CHUNK */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Exported_Types BSP PRINTF Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Output of the formatter, given the text by chunks of up to BSP_PRINTF_CHUNK bytes
+  */
+typedef void (*BSP_PRINTF_OutputTypeDef)(void *pContext, const char *pData, uint32_t Size);
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PRINTF_Exported_Functions
+  * @{
+  */
+int BSP_PRINTF_Format(BSP_PRINTF_OutputTypeDef Output, void *pContext, const char *pFormat, va_list Args);
+int BSP_PRINTF_vsnprintf(char *pBuffer, size_t Size, const char *pFormat, va_list Args);
+int BSP_PRINTF_snprintf(char *pBuffer, size_t Size, const char *pFormat, ...)
+  __attribute__((format(printf, 3, 4)));
+int BSP_PRINTF_vprintf(const char *pFormat, va_list Args);
+int BSP_PRINTF_printf(const char *pFormat, ...) __attribute__((format(printf, 1, 2)));
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PRINTF_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,164 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_probe.h
+  * @author  MCU Application Team
+  * @brief   Header file of the profiling probe BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PROBE_H
+#define __PY32F4XX_BSP_PROBE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PROBE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Exported_Constants BSP PROBE Exported Constants
+  * @{
+  */
+#if !defined (BSP_PROBE_ZONES)
+#define BSP_PROBE_ZONES                 8U             /*!< Zones, 0 to BSP_PROBE_ZONES - 1, up to 256 */
+#endif /* BSP_PROBE_ZONES */
+
+#if !defined (BSP_PROBE_RING)
+#define BSP_PROBE_RING                  64U            /*!< Events kept, a power of 2, oldest replaced */
+#endif /* BSP_PROBE_RING */
+
+#if !defined (BSP_PROBE_ITM_PORT)
+#define BSP_PROBE_ITM_PORT              1U             /*!< ITM stimulus port, 0 being the one of printf */
+#endif /* BSP_PROBE_ITM_PORT */
+
+#define BSP_PROBE_BINS                  32U            /*!< Histogram bins, bin n from 2^n to 2^(n+1) - 1 */
+
+/** @defgroup BSP_PROBE_Output BSP PROBE Output
+  * @{
+  */
+#define BSP_PROBE_OUTPUT_RING           0x00000001U    /*!< Events in the ring, BSP_PROBE_ReadRing()   */
+#define BSP_PROBE_OUTPUT_ITM            0x00000002U    /*!< Events on SWO, BSP_PROBE_ConfigITM()       */
+#define BSP_PROBE_OUTPUT_GPIO           0x00000004U    /*!< Zone pin high inside the zone            */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Exported_Types BSP PROBE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Profiling probe event definition
+  */
+typedef struct
+{
+  uint32_t                Cycles;       /*!< DWT cycle count of the event                           */
+
+  uint8_t                 Zone;         /*!< Zone of the event                                      */
+
+  uint8_t                 Exit;         /*!< 0 on the enter, 1 on the exit                          */
+
+} BSP_PROBE_EventTypeDef;
+
+/**
+  * @brief  Profiling probe zone definition
+  */
+typedef struct
+{
+  const char              *pName;       /*!< Zone name, a string constant, NULL for "zone n"       */
+
+  GPIO_TypeDef            *GPIOx;       /*!< Port of the zone pin, NULL for none                    */
+
+  uint32_t                GPIO_Pin;     /*!< Zone pin                                               */
+
+  uint32_t                Start;        /*!< Cycle count of the last enter                          */
+
+  uint32_t                Count;        /*!< Exits measured                                         */
+
+  uint32_t                Min;          /*!< Shortest duration in cycles                            */
+
+  uint32_t                Max;          /*!< Longest duration in cycles                             */
+
+  uint64_t                Total;        /*!< Sum of the durations in cycles                         */
+
+  uint32_t                Bins[BSP_PROBE_BINS]; /*!< Durations per power of 2 of cycles             */
+
+} BSP_PROBE_ZoneTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Exported_Macros BSP PROBE Exported Macros
+  * @{
+  */
+#if defined (USE_BSP_PROBE)
+#define BSP_PROBE_ENTER(__ZONE__)       BSP_PROBE_Enter(__ZONE__)
+#define BSP_PROBE_EXIT(__ZONE__)        BSP_PROBE_Exit(__ZONE__)
+#else
+#define BSP_PROBE_ENTER(__ZONE__)       ((void)0U)
+#define BSP_PROBE_EXIT(__ZONE__)        ((void)0U)
+#endif /* USE_BSP_PROBE */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PROBE_Exported_Functions
+  * @{
+  */
+void              BSP_PROBE_Init(uint32_t Outputs);
+HAL_StatusTypeDef BSP_PROBE_ConfigZone(uint32_t Zone, const char *pName, GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+HAL_StatusTypeDef BSP_PROBE_ConfigITM(uint32_t SwoHz);
+void              BSP_PROBE_Enter(uint32_t Zone);
+void              BSP_PROBE_Exit(uint32_t Zone);
+uint32_t          BSP_PROBE_ReadRing(BSP_PROBE_EventTypeDef *pEvents, uint32_t Size);
+const BSP_PROBE_ZoneTypeDef *BSP_PROBE_GetZone(uint32_t Zone);
+void              BSP_PROBE_Reset(void);
+void              BSP_PROBE_Print(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PROBE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_psram.h
+  * @author  MCU Application Team
+  * @brief   Header file of the ESMC PSRAM BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PSRAM_H
+#define __PY32F4XX_BSP_PSRAM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PSRAM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Exported_Constants BSP PSRAM Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_PSRAM_Part BSP PSRAM Part
+  * @brief    QSPI PSRAM parts, all with the same command set
+  * @{
+  */
+#define BSP_PSRAM_PART_APS1604          0x00U          /*!< AP Memory APS1604M-SQ, 2 Mbytes                     */
+#define BSP_PSRAM_PART_APS6404          0x01U          /*!< AP Memory APS6404L-SQ, ESP-PSRAM64H, 8 Mbytes       */
+#define BSP_PSRAM_PART_LY68L6400        0x02U          /*!< Lyontek LY68L6400, 8 Mbytes                         */
+/**
+  * @}
+  */
+
+#ifndef BSP_PSRAM_SIZE_MAX
+#define BSP_PSRAM_SIZE_MAX              0x00800000U    /*!< Largest part supported, sizes the block maps        */
+#endif
+
+#ifndef BSP_PSRAM_BLOCK_SIZE
+#define BSP_PSRAM_BLOCK_SIZE            4096U          /*!< Allocation unit of the heap, power of 2             */
+#endif
+
+#define BSP_PSRAM_BLOCKS                (BSP_PSRAM_SIZE_MAX / BSP_PSRAM_BLOCK_SIZE)
+#define BSP_PSRAM_MAP_WORDS             ((BSP_PSRAM_BLOCKS + 31U) / 32U)
+
+#define BSP_PSRAM_CE_MAX_US             8U             /*!< Longest chip select low time, refresh of the array  */
+#define BSP_PSRAM_TIMEOUT               10U            /*!< Timeout of a command, ms                            */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Exported_Types BSP PSRAM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  PSRAM state definition
+  */
+typedef struct
+{
+  ESMC_HandleTypeDef      *hesmc;       /*!< ESMC of the PSRAM, NULL when not initialized           */
+
+  uint32_t                CSPinSel;     /*!< Chip select of the PSRAM, a value of @ref ESMC_CS_PIN_SEL */
+
+  uint32_t                Size;         /*!< Size of the part, bytes                                */
+
+  uint32_t                PageSize;     /*!< Wrap boundary of a burst, bytes                        */
+
+  uint32_t                MaxBurst;     /*!< Bytes written by one command within the CE low time    */
+
+  uint8_t                 ManufacturerId; /*!< Manufacturer ID read at initialization               */
+
+  uint8_t                 KgdId;        /*!< Known good die ID read at initialization               */
+
+  uint8_t                 *HeapBase;    /*!< First block of the heap, after the .psram section      */
+
+  uint32_t                HeapBlocks;   /*!< Number of blocks of the heap                           */
+
+  uint32_t                FreeBlocks;   /*!< Number of blocks not allocated                         */
+
+  uint32_t                UsedMap[BSP_PSRAM_MAP_WORDS];  /*!< Block allocated, 1 bit per block      */
+
+  uint32_t                StartMap[BSP_PSRAM_MAP_WORDS]; /*!< First block of an allocation          */
+
+} BSP_PSRAM_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PSRAM_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_PSRAM_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_PSRAM_Init(BSP_PSRAM_TypeDef *hpsram, ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel,
+                                 uint32_t Part);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PSRAM_Exported_Functions_Group2
+  * @{
+  */
+/* IO functions ***************************************************************/
+HAL_StatusTypeDef BSP_PSRAM_Write(BSP_PSRAM_TypeDef *hpsram, void *pDest, const void *pSrc, uint32_t Size);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PSRAM_Exported_Functions_Group3
+  * @{
+  */
+/* Heap functions *************************************************************/
+void *BSP_PSRAM_Malloc(BSP_PSRAM_TypeDef *hpsram, uint32_t Size);
+HAL_StatusTypeDef BSP_PSRAM_Free(BSP_PSRAM_TypeDef *hpsram, void *ptr);
+uint32_t BSP_PSRAM_GetFreeSize(const BSP_PSRAM_TypeDef *hpsram);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PSRAM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pulsetrain.h
+  * @author  MCU Application Team
+  * @brief   Header file of the pulse train generator BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PULSETRAIN_H
+#define __PY32F4XX_BSP_PULSETRAIN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PULSETRAIN
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Exported_Constants BSP PULSETRAIN Exported Constants
+  * @{
+  */
+#define BSP_PULSETRAIN_REPETITION_MAX   255U           /*!< RCR, 256 pulses of a step                 */
+#define BSP_PULSETRAIN_STEPS_MAX        21845U         /*!< Steps of a profile, 3 words each          */
+
+/** @defgroup BSP_PULSETRAIN_State BSP PULSETRAIN State
+  * @{
+  */
+#define BSP_PULSETRAIN_STATE_RESET      0x00000000U    /*!< Not initialized                           */
+#define BSP_PULSETRAIN_STATE_READY      0x00000001U    /*!< Timer configured, stopped                 */
+#define BSP_PULSETRAIN_STATE_RUN        0x00000002U    /*!< Profile in progress                       */
+#define BSP_PULSETRAIN_STATE_ERROR      0x00000003U    /*!< DMA error, stopped                        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Exported_Types BSP PULSETRAIN Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Pulse train step definition, the frame of a burst of ARR, RCR and CCR1
+  */
+typedef struct
+{
+  uint32_t                Period;       /*!< ARR, period of the pulses less one, in timer ticks     */
+
+  uint32_t                Repetition;   /*!< RCR, pulses of the step less one, 0 to
+                                             BSP_PULSETRAIN_REPETITION_MAX                          */
+
+  uint32_t                Pulse;        /*!< CCR1, width of the pulses in timer ticks, 0 for none   */
+
+} BSP_PULSETRAIN_StepTypeDef;
+
+/**
+  * @brief  Pulse train generator definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< TIM1 or TIM8, channel 1 and the update DMA owned by the
+                                             service                                                */
+
+  DMA_HandleTypeDef       *hdma;        /*!< DMA channel of the update, normal mode, words          */
+
+  const BSP_PULSETRAIN_StepTypeDef *pSteps; /*!< Profile in progress                                */
+
+  uint32_t                NbrOfSteps;   /*!< Steps of the profile, the last one without pulse       */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_PULSETRAIN_State                   */
+
+} BSP_PULSETRAIN_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PULSETRAIN_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_PULSETRAIN_Init(BSP_PULSETRAIN_TypeDef *htrain, TIM_HandleTypeDef *htim, uint32_t OCPolarity);
+HAL_StatusTypeDef BSP_PULSETRAIN_Start(BSP_PULSETRAIN_TypeDef *htrain, const BSP_PULSETRAIN_StepTypeDef *pSteps,
+                                       uint32_t NbrOfSteps);
+HAL_StatusTypeDef BSP_PULSETRAIN_Stop(BSP_PULSETRAIN_TypeDef *htrain);
+void              BSP_PULSETRAIN_IRQHandler(BSP_PULSETRAIN_TypeDef *htrain);
+void              BSP_PULSETRAIN_CpltCallback(BSP_PULSETRAIN_TypeDef *htrain);
+void              BSP_PULSETRAIN_ErrorCallback(BSP_PULSETRAIN_TypeDef *htrain);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PULSETRAIN_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pwmdither.h
+  * @author  MCU Application Team
+  * @brief   Header file of the PWM dithering BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PWMDITHER_H
+#define __PY32F4XX_BSP_PWMDITHER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_timburst.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PWMDITHER
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PWMDITHER_Exported_Constants BSP PWMDITHER Exported Constants
+  * @{
+  */
+#define BSP_PWMDITHER_BITS_MAX          8U             /*!< Extra bits, dither of 256 periods         */
+#define BSP_PWMDITHER_CHANNELS_MAX      4U             /*!< CCR1 to CCR4                              */
+
+/**
+  * @brief  Words of the table of a dither.
+  * @param  __CHANNELS__ Channels dithered.
+  * @param  __BITS__ Extra bits.
+  */
+#define BSP_PWMDITHER_TABLE_SIZE(__CHANNELS__, __BITS__)   ((__CHANNELS__) << (__BITS__))
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PWMDITHER_Exported_Types BSP PWMDITHER Exported Types
+  * @{
+  */
+
+/**
+  * @brief  PWM dither definition
+  */
+typedef struct
+{
+  BSP_TIMBURST_TypeDef    Burst;        /*!< Burst stream of the CCRx, one frame per period         */
+
+  uint32_t                FirstChannel; /*!< First channel dithered, TIM_CHANNEL_1 to TIM_CHANNEL_4  */
+
+  uint32_t                NbrOfChannels; /*!< Consecutive channels dithered, 1 to
+                                             BSP_PWMDITHER_CHANNELS_MAX                             */
+
+  uint32_t                DitherBits;   /*!< Extra bits, a dither of 2^DitherBits periods           */
+
+  uint32_t                DutyMax;      /*!< Duty of 100 %, (ARR + 1) << DitherBits                 */
+
+  uint32_t                Duty[BSP_PWMDITHER_CHANNELS_MAX]; /*!< Duty of each channel, 1/2^DitherBits
+                                             timer ticks                                            */
+
+} BSP_PWMDITHER_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PWMDITHER_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_PWMDITHER_Init(BSP_PWMDITHER_TypeDef *hdither, TIM_HandleTypeDef *htim, uint32_t FirstChannel,
+                                     uint32_t NbrOfChannels, uint32_t DitherBits, uint32_t *pTable);
+HAL_StatusTypeDef BSP_PWMDITHER_Start(BSP_PWMDITHER_TypeDef *hdither);
+HAL_StatusTypeDef BSP_PWMDITHER_Stop(BSP_PWMDITHER_TypeDef *hdither);
+HAL_StatusTypeDef BSP_PWMDITHER_SetDuty(BSP_PWMDITHER_TypeDef *hdither, uint32_t Index, uint32_t Duty);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PWMDITHER_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pwrprof.h
+  * @author  MCU Application Team
+  * @brief   Header file of the power profiling BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_PWRPROF_H
+#define __PY32F4XX_BSP_PWRPROF_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_uptime.h"
+
+#if defined (HAL_RTC_MODULE_ENABLED) && defined (HAL_PWR_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_PWRPROF
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Exported_Constants BSP PWRPROF Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_PWRPROF_State BSP PWRPROF State
+  * @{
+  */
+#define BSP_PWRPROF_STATE_RUN           0x00000000U              /*!< CPU running                     */
+#define BSP_PWRPROF_STATE_SLEEP         PWR_LOWPOWERMODE_SLEEP   /*!< SLEEP mode                      */
+#define BSP_PWRPROF_STATE_STOP          PWR_LOWPOWERMODE_STOP    /*!< STOP mode                       */
+#define BSP_PWRPROF_STATES              3U                       /*!< Number of states                */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PWRPROF_Bus BSP PWRPROF Bus
+  * @{
+  */
+#define BSP_PWRPROF_BUS_AHB1            0x00000000U    /*!< RCC AHB1ENR                               */
+#define BSP_PWRPROF_BUS_AHB2            0x00000001U    /*!< RCC AHB2ENR                               */
+#define BSP_PWRPROF_BUS_APB1            0x00000002U    /*!< RCC APB1ENR                               */
+#define BSP_PWRPROF_BUS_APB2            0x00000003U    /*!< RCC APB2ENR                               */
+/**
+  * @}
+  */
+
+#if !defined (BSP_PWRPROF_CLOCKS)
+#define BSP_PWRPROF_CLOCKS              16U            /*!< Peripheral clocks tracked at most         */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Exported_Types BSP PWRPROF Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Peripheral clock tracked definition
+  */
+typedef struct
+{
+  uint32_t                Bus;          /*!< A value of @ref BSP_PWRPROF_Bus                        */
+
+  uint32_t                Mask;         /*!< Enable bit in the RCC register of the bus              */
+
+  uint64_t                Time;         /*!< Time enabled out of the STOP mode, ns                  */
+
+} BSP_PWRPROF_ClockTypeDef;
+
+/**
+  * @brief  Power profile report definition
+  */
+typedef struct
+{
+  uint64_t                Time[BSP_PWRPROF_STATES];    /*!< Time in each state, ns                  */
+
+  uint32_t                Entries[BSP_PWRPROF_STATES]; /*!< Entries in each state                   */
+
+  uint64_t                RunCycles;    /*!< CPU cycles in the RUN state                            */
+
+  uint64_t                Total;        /*!< Time since BSP_PWRPROF_Reset(), ns                     */
+
+  uint32_t                Duty;         /*!< RUN time of the total, per mille                       */
+
+} BSP_PWRPROF_ReportTypeDef;
+
+/**
+  * @brief  Power profiling definition
+  */
+typedef struct
+{
+  BSP_UPTIME_TypeDef      *hup;         /*!< Uptime clock, running in all states                    */
+
+  uint32_t                State;        /*!< A value of @ref BSP_PWRPROF_State                      */
+
+  uint64_t                Stamp;        /*!< Time of the last accounting, ns                        */
+
+  uint32_t                CycleStamp;   /*!< DWT cycle counter of the last accounting in RUN        */
+
+  uint64_t                Start;        /*!< Time of BSP_PWRPROF_Reset(), ns                        */
+
+  uint32_t                Enr[4];       /*!< RCC enable registers of the last accounting            */
+
+  uint32_t                NbClocks;     /*!< Peripheral clocks tracked                              */
+
+  BSP_PWRPROF_ClockTypeDef Clock[BSP_PWRPROF_CLOCKS]; /*!< Peripheral clocks tracked                */
+
+  BSP_PWRPROF_ReportTypeDef Report;     /*!< Accumulated times, Total and Duty computed on read     */
+
+} BSP_PWRPROF_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_PWRPROF_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_PWRPROF_Init(BSP_PWRPROF_TypeDef *hprof, BSP_UPTIME_TypeDef *hup);
+HAL_StatusTypeDef BSP_PWRPROF_TrackClock(BSP_PWRPROF_TypeDef *hprof, uint32_t Bus, uint32_t Mask);
+void              BSP_PWRPROF_Reset(BSP_PWRPROF_TypeDef *hprof);
+void              BSP_PWRPROF_Enter(BSP_PWRPROF_TypeDef *hprof, uint32_t Mode);
+void              BSP_PWRPROF_Exit(BSP_PWRPROF_TypeDef *hprof);
+void              BSP_PWRPROF_Update(BSP_PWRPROF_TypeDef *hprof);
+void              BSP_PWRPROF_GetReport(BSP_PWRPROF_TypeDef *hprof, BSP_PWRPROF_ReportTypeDef *pReport);
+const BSP_PWRPROF_ClockTypeDef *BSP_PWRPROF_GetClock(const BSP_PWRPROF_TypeDef *hprof, uint32_t Index);
+void              BSP_PWRPROF_Print(BSP_PWRPROF_TypeDef *hprof);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED && HAL_PWR_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_PWRPROF_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
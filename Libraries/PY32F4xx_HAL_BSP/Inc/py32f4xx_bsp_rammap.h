@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_rammap.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SRAM layout BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_RAMMAP_H
+#define __PY32F4XX_BSP_RAMMAP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_RAMMAP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_RAMMAP_Exported_Constants BSP RAMMAP Exported Constants
+  * @{
+  */
+#define BSP_RAMMAP_SIZE                 (SRAM_END - SRAM_BASE + 1U) /*!< SRAM of the device, 32, 48 or 64
+                                                            Kbytes for PY32F403xB, xC or xD      */
+#define BSP_RAMMAP_ALIGN                8U             /*!< Alignment of the heap and of the regions
+                                                            taken with an Alignment of 0         */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_RAMMAP_Exported_Types BSP RAMMAP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SRAM layout definition
+  */
+typedef struct
+{
+  uint32_t                Size;         /*!< SRAM size of the device, BSP_RAMMAP_SIZE               */
+
+  uint32_t                StaticEnd;    /*!< End of the .data, .noinit and .bss, excluded           */
+
+  uint32_t                HeapStart;    /*!< First byte of the heap, StaticEnd aligned              */
+
+  uint32_t                HeapBreak;    /*!< End of the heap given to malloc(), excluded            */
+
+  uint32_t                HeapLimit;    /*!< End of the heap, excluded, the regions taken above     */
+
+  uint32_t                StackStart;   /*!< Bottom of the main stack, _sstack                      */
+
+  uint32_t                StackEnd;     /*!< Top of the main stack, _estack, end of the SRAM        */
+
+} BSP_RAMMAP_InfoTypeDef;
+
+/**
+  * @brief  SRAM region definition
+  */
+typedef struct
+{
+  uint32_t                Address;      /*!< First byte                                             */
+
+  uint32_t                Size;         /*!< Size in bytes                                          */
+
+} BSP_RAMMAP_RegionTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_RAMMAP_Exported_Functions
+  * @{
+  */
+void              BSP_RAMMAP_GetInfo(BSP_RAMMAP_InfoTypeDef *pInfo);
+uint32_t          BSP_RAMMAP_GetFree(void);
+HAL_StatusTypeDef BSP_RAMMAP_Take(uint32_t Size, uint32_t Alignment, BSP_RAMMAP_RegionTypeDef *pRegion);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_RAMMAP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,151 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_regsnap.h
+  * @author  MCU Application Team
+  * @brief   Header file of the peripheral register snapshot BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_REGSNAP_H
+#define __PY32F4XX_BSP_REGSNAP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_REGSNAP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Exported_Constants BSP REGSNAP Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_REGSNAP_Type BSP REGSNAP Type
+  * @{
+  */
+#define BSP_REGSNAP_TYPE_GPIO           0x00000000U    /*!< GPIO port, GPIO_TypeDef                   */
+#define BSP_REGSNAP_TYPE_USART          0x00000001U    /*!< USART, USART_TypeDef                      */
+#define BSP_REGSNAP_TYPE_SPI            0x00000002U    /*!< SPI or I2S, SPI_TypeDef                   */
+#define BSP_REGSNAP_TYPE_TIM            0x00000003U    /*!< Timer, TIM_TypeDef                        */
+#define BSP_REGSNAP_TYPE_ADC            0x00000004U    /*!< ADC, ADC_TypeDef, calibration not kept    */
+#define BSP_REGSNAP_TYPE_DMA            0x00000005U    /*!< DMA channel, DMA_Channel_TypeDef          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Exported_Types BSP REGSNAP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Peripheral of a snapshot definition
+  */
+typedef struct
+{
+  uint32_t                Type;         /*!< A value of @ref BSP_REGSNAP_Type                       */
+
+  void                    *Instance;    /*!< Peripheral registers, GPIOA or USART1 for instance     */
+
+} BSP_REGSNAP_EntryTypeDef;
+
+/**
+  * @brief  Register snapshot definition
+  */
+typedef struct
+{
+  const BSP_REGSNAP_EntryTypeDef *pEntries; /*!< Peripherals, restored in table order               */
+
+  uint32_t                EntryCount;   /*!< Number of peripherals                                  */
+
+  uint32_t                Address;      /*!< FLASH_SECTOR_SIZE sector of the snapshot               */
+
+  uint32_t                Key;          /*!< Firmware or configuration version, a snapshot of another
+                                             key is not restored                                    */
+
+  uint32_t                Words;        /*!< 32-bit words of the snapshot                           */
+
+  uint32_t                RestoreCycles; /*!< DWT cycles of the last BSP_REGSNAP_Restore(), with the
+                                             cycle counter running                                  */
+
+} BSP_REGSNAP_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_REGSNAP_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_REGSNAP_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_REGSNAP_Init(BSP_REGSNAP_TypeDef *hsnap, const BSP_REGSNAP_EntryTypeDef *pEntries,
+                                   uint32_t EntryCount, uint32_t Address, uint32_t Key);
+uint32_t          BSP_REGSNAP_GetBufferSize(const BSP_REGSNAP_TypeDef *hsnap);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_REGSNAP_Exported_Functions_Group2
+  * @{
+  */
+/* Snapshot functions *********************************************************/
+HAL_StatusTypeDef BSP_REGSNAP_Save(BSP_REGSNAP_TypeDef *hsnap, uint32_t *pBuffer, uint32_t Size);
+uint32_t          BSP_REGSNAP_IsValid(const BSP_REGSNAP_TypeDef *hsnap);
+HAL_StatusTypeDef BSP_REGSNAP_Restore(BSP_REGSNAP_TypeDef *hsnap);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_REGSNAP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,280 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_rtos.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS-RTOS2 kernel BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_RTOS_H
+#define __PY32F4XX_BSP_RTOS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_RTOS)
+
+#include "cmsis_os2.h"
+#include "os_tick.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_RTOS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Exported_Constants BSP RTOS Exported Constants
+  * @{
+  */
+
+#define BSP_RTOS_TICK_FREQ              1000U          /*!< Kernel tick in Hz, the 1 ms of HAL_GetTick() */
+
+#if !defined (BSP_RTOS_THREADS)
+#define BSP_RTOS_THREADS                8U             /*!< Thread control blocks of the pool, the
+                                                            idle thread not included                  */
+#endif
+
+#if !defined (BSP_RTOS_MUTEXES)
+#define BSP_RTOS_MUTEXES                8U             /*!< Mutex control blocks of the pool          */
+#endif
+
+#if !defined (BSP_RTOS_SEMAPHORES)
+#define BSP_RTOS_SEMAPHORES             8U             /*!< Semaphore control blocks of the pool      */
+#endif
+
+#if !defined (BSP_RTOS_EVENTFLAGS)
+#define BSP_RTOS_EVENTFLAGS             4U             /*!< Event flags control blocks of the pool    */
+#endif
+
+#if !defined (BSP_RTOS_MSGQUEUES)
+#define BSP_RTOS_MSGQUEUES              4U             /*!< Message queue control blocks of the pool  */
+#endif
+
+#if !defined (BSP_RTOS_HEAP_SIZE)
+#define BSP_RTOS_HEAP_SIZE              8192U          /*!< Bytes of the stacks and message buffers
+                                                            not given in the attributes, never freed  */
+#endif
+
+#if !defined (BSP_RTOS_STACK_SIZE)
+#define BSP_RTOS_STACK_SIZE             1024U          /*!< Stack bytes of a thread without stack_size */
+#endif
+
+#if !defined (BSP_RTOS_IDLE_STACK_SIZE)
+#define BSP_RTOS_IDLE_STACK_SIZE        256U           /*!< Stack bytes of the idle thread            */
+#endif
+
+#if !defined (BSP_RTOS_ROBIN_TICKS)
+#define BSP_RTOS_ROBIN_TICKS            5U             /*!< Ticks of a thread before the next one of
+                                                            its priority runs, 0 for no time slicing  */
+#endif
+
+#if !defined (BSP_RTOS_TICKLESS)
+#define BSP_RTOS_TICKLESS               1U             /*!< 1: the idle thread stops the tick until
+                                                            the next delay ends, 0: plain WFI         */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Exported_Types BSP RTOS Exported Types
+  * @{
+  */
+
+struct BSP_RTOS_Mutex_s;
+
+/**
+  * @brief  Thread control block definition, cb_mem of osThreadAttr_t
+  */
+typedef struct BSP_RTOS_Thread_s
+{
+  uint32_t                Sp;           /*!< Stack pointer while switched out, first for
+                                             PendSV_Handler()                                       */
+
+  uint8_t                 Id;           /*!< Object identifier                                      */
+
+  uint8_t                 State;        /*!< A value of osThreadState_t                             */
+
+  uint8_t                 Priority;     /*!< Priority running, raised by the mutexes owned          */
+
+  uint8_t                 BasePriority; /*!< Priority set                                           */
+
+  uint8_t                 Alloc;        /*!< 1: control block from the pool                         */
+
+  uint8_t                 WaitKind;     /*!< What the blocked thread waits for                      */
+
+  uint8_t                 Delayed;      /*!< 1: in the delay list                                   */
+
+  uint8_t                 Reserved;     /*!< Padding                                                */
+
+  struct BSP_RTOS_Thread_s *pNext;      /*!< Next in the ready list or in a wait list               */
+
+  struct BSP_RTOS_Thread_s *pDelayNext; /*!< Next in the delay list                                 */
+
+  struct BSP_RTOS_Thread_s **pWaitList; /*!< Wait list of the blocked thread, NULL for none         */
+
+  uint32_t                Wake;         /*!< Tick of the end of the delay                           */
+
+  uint32_t                Flags;        /*!< Thread flags                                           */
+
+  uint32_t                WaitFlags;    /*!< Flags waited for                                       */
+
+  uint32_t                WaitOptions;  /*!< osFlagsXxx options of the wait                         */
+
+  void                    *pWaitData;   /*!< Message of the message queue wait                      */
+
+  uint32_t                WaitResult;   /*!< osStatus_t or flags ending the wait                    */
+
+  struct BSP_RTOS_Mutex_s *pMutexes;    /*!< Mutexes owned                                          */
+
+  const char              *Name;        /*!< Name of the attributes                                 */
+
+  uint32_t                *pStack;      /*!< Lowest word of the stack                               */
+
+  uint32_t                StackSize;    /*!< Stack bytes                                            */
+
+} BSP_RTOS_ThreadTypeDef;
+
+/**
+  * @brief  Mutex control block definition, cb_mem of osMutexAttr_t
+  */
+typedef struct BSP_RTOS_Mutex_s
+{
+  uint8_t                 Id;           /*!< Object identifier                                      */
+
+  uint8_t                 Alloc;        /*!< 1: control block from the pool                         */
+
+  uint16_t                Lock;         /*!< Acquisitions of the owner                              */
+
+  uint32_t                Attr;         /*!< osMutexXxx attribute bits                              */
+
+  BSP_RTOS_ThreadTypeDef  *pOwner;      /*!< Thread owning it, NULL when free                       */
+
+  BSP_RTOS_ThreadTypeDef  *pWaitList;   /*!< Threads waiting, the highest priority first            */
+
+  struct BSP_RTOS_Mutex_s *pOwnerNext;  /*!< Next mutex of the owner                                */
+
+  const char              *Name;        /*!< Name of the attributes                                 */
+
+} BSP_RTOS_MutexTypeDef;
+
+/**
+  * @brief  Semaphore control block definition, cb_mem of osSemaphoreAttr_t
+  */
+typedef struct
+{
+  uint8_t                 Id;           /*!< Object identifier                                      */
+
+  uint8_t                 Alloc;        /*!< 1: control block from the pool                         */
+
+  uint16_t                Reserved;     /*!< Padding                                                */
+
+  uint32_t                Count;        /*!< Tokens available                                       */
+
+  uint32_t                MaxCount;     /*!< Tokens at most                                         */
+
+  BSP_RTOS_ThreadTypeDef  *pWaitList;   /*!< Threads waiting, the highest priority first            */
+
+  const char              *Name;        /*!< Name of the attributes                                 */
+
+} BSP_RTOS_SemaphoreTypeDef;
+
+/**
+  * @brief  Event flags control block definition, cb_mem of osEventFlagsAttr_t
+  */
+typedef struct
+{
+  uint8_t                 Id;           /*!< Object identifier                                      */
+
+  uint8_t                 Alloc;        /*!< 1: control block from the pool                         */
+
+  uint16_t                Reserved;     /*!< Padding                                                */
+
+  uint32_t                Flags;        /*!< Event flags                                            */
+
+  BSP_RTOS_ThreadTypeDef  *pWaitList;   /*!< Threads waiting, the highest priority first            */
+
+  const char              *Name;        /*!< Name of the attributes                                 */
+
+} BSP_RTOS_EventFlagsTypeDef;
+
+/**
+  * @brief  Message queue control block definition, cb_mem of osMessageQueueAttr_t
+  */
+typedef struct
+{
+  uint8_t                 Id;           /*!< Object identifier                                      */
+
+  uint8_t                 Alloc;        /*!< 1: control block from the pool                         */
+
+  uint16_t                Reserved;     /*!< Padding                                                */
+
+  uint32_t                MsgSize;      /*!< Bytes of a message                                     */
+
+  uint32_t                Capacity;     /*!< Messages at most                                       */
+
+  uint32_t                Count;        /*!< Messages queued                                        */
+
+  uint32_t                Head;         /*!< Index of the oldest message                            */
+
+  uint8_t                 *pBuffer;     /*!< Capacity messages                                      */
+
+  BSP_RTOS_ThreadTypeDef  *pWaitList;   /*!< Threads waiting to put when full, to get when empty    */
+
+  const char              *Name;        /*!< Name of the attributes                                 */
+
+} BSP_RTOS_MsgQueueTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_RTOS_Exported_Functions
+  * @{
+  */
+void              BSP_RTOS_TickHandler(void);
+uint32_t          BSP_RTOS_Sleep(uint32_t Ticks);
+void              BSP_RTOS_Idle(void);
+void              BSP_RTOS_StackOverflowCallback(osThreadId_t thread_id);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_RTOS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_RTOS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
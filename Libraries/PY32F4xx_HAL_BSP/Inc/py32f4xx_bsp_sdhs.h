@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdhs.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SD card high speed configuration BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SDHS_H
+#define __PY32F4XX_BSP_SDHS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_SD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SDHS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SDHS_Exported_Constants BSP SDHS Exported Constants
+  * @{
+  */
+#define BSP_SDHS_CLOCK_DEFAULT          25000000U      /*!< Highest card clock of the default speed, Hz */
+#define BSP_SDHS_CLOCK_HIGH             50000000U      /*!< Highest card clock of the high speed, Hz  */
+
+#if !defined (BSP_SDHS_RETRIES)
+#define BSP_SDHS_RETRIES                3U             /*!< Slower clocks tried when the read test fails */
+#endif
+
+#if !defined (BSP_SDHS_TIMEOUT)
+#define BSP_SDHS_TIMEOUT                1000U          /*!< Read test timeout, ms                     */
+#endif
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SDHS_Exported_Types BSP SDHS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SD card bus configuration result definition
+  */
+typedef struct
+{
+  uint32_t                BusWide;      /*!< A value of @ref SDIO_LL_Bus_Wide                       */
+
+  uint32_t                HighSpeed;    /*!< 1 when CMD6 switched the card to high speed            */
+
+  uint32_t                ClockDiv;     /*!< SDIO clock divider, also in hsd->Init.ClockDiv         */
+
+  uint32_t                Clock;        /*!< Card clock, Hz                                         */
+
+  uint32_t                Retries;      /*!< Read tests failed before the clock retained            */
+
+  uint32_t                ReadRate;     /*!< Bytes per second of the read test, 0 under a tick      */
+
+} BSP_SDHS_ResultTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SDHS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_SDHS_Config(SD_HandleTypeDef *hsd, uint32_t MaxClock, uint32_t TestBlock,
+                                  uint8_t *pBuffer, uint32_t NbrOfBlocks, BSP_SDHS_ResultTypeDef *pResult);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SDHS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,199 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdqueue.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SD card request queue BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SDQUEUE_H
+#define __PY32F4XX_BSP_SDQUEUE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_SD_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SDQUEUE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SDQUEUE_Exported_Constants BSP SDQUEUE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SDQUEUE_Op BSP SDQUEUE Op
+  * @{
+  */
+#define BSP_SDQUEUE_OP_READ             0x00000000U    /*!< Read blocks into pData                    */
+#define BSP_SDQUEUE_OP_WRITE            0x00000001U    /*!< Write blocks from pData                   */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SDQUEUE_Status BSP SDQUEUE Status
+  * @{
+  */
+#define BSP_SDQUEUE_STATUS_NONE         0x00000000U    /*!< Not submitted                             */
+#define BSP_SDQUEUE_STATUS_QUEUED       0x00000001U    /*!< Waiting in the queue or on the bus        */
+#define BSP_SDQUEUE_STATUS_OK           0x00000002U    /*!< Transferred                               */
+#define BSP_SDQUEUE_STATUS_ERROR        0x00000003U    /*!< Transfer failed, ErrorCode holds the cause */
+/**
+  * @}
+  */
+
+#define BSP_SDQUEUE_BLOCKS_MAX          511U           /*!< Blocks of a command, 65535 DMA words      */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SDQUEUE_Exported_Types BSP SDQUEUE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SD card request definition
+  * @note   The request is linked in the queue until it ends, it must stay
+  *         valid until then.
+  */
+typedef struct __BSP_SDQUEUE_ReqTypeDef
+{
+  uint32_t                Op;           /*!< A value of @ref BSP_SDQUEUE_Op                         */
+
+  uint32_t                Lba;          /*!< First block of the card                                */
+
+  uint32_t                Count;        /*!< Blocks, 1 to BSP_SDQUEUE_BLOCKS_MAX                    */
+
+  uint8_t                 *pData;       /*!< Count x BLOCKSIZE bytes, word aligned                  */
+
+  void                    *pContext;    /*!< User data, free for the completion callback            */
+
+  __IO uint32_t           Status;       /*!< A value of @ref BSP_SDQUEUE_Status                     */
+
+  uint32_t                ErrorCode;    /*!< hsd->ErrorCode of the failed command                   */
+
+  struct __BSP_SDQUEUE_ReqTypeDef *pNext; /*!< Next queued request                                  */
+
+} BSP_SDQUEUE_ReqTypeDef;
+
+/**
+  * @brief  SD card request queue statistics definition
+  */
+typedef struct
+{
+  uint32_t                Requests;     /*!< Requests ended                                         */
+
+  uint32_t                Commands;     /*!< Multiple block commands issued                         */
+
+  uint32_t                Merged;       /*!< Requests joined to the command of another one          */
+
+  uint32_t                Blocks;       /*!< Blocks transferred                                     */
+
+  uint32_t                Errors;       /*!< Requests ended with an error                           */
+
+} BSP_SDQUEUE_StatsTypeDef;
+
+/**
+  * @brief  SD card request queue state definition
+  */
+typedef struct
+{
+  SD_HandleTypeDef        *hsd;         /*!< SD card of the queue, NULL when not initialized        */
+
+  BSP_SDQUEUE_ReqTypeDef  * volatile pPending; /*!< Submitted requests, last first, not sorted yet  */
+
+  __IO uint32_t           Owner;        /*!< 1 while a context runs the queue or a command is on   */
+
+  BSP_SDQUEUE_ReqTypeDef  *pHead;       /*!< First request waiting, in submission order             */
+
+  BSP_SDQUEUE_ReqTypeDef  *pTail;       /*!< Last request waiting                                   */
+
+  BSP_SDQUEUE_ReqTypeDef  *pBatch;      /*!< Requests of the command on the bus, in block order     */
+
+  __IO uint32_t           Phase;        /*!< Command on the bus: 0 none, 1 transfer, 2 programming  */
+
+  uint32_t                BatchStatus;  /*!< Transfer result while the card programs                */
+
+  BSP_SDQUEUE_StatsTypeDef Stats;       /*!< Statistics                                             */
+
+} BSP_SDQUEUE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SDQUEUE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SDQUEUE_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_SDQUEUE_Init(BSP_SDQUEUE_TypeDef *hqueue, SD_HandleTypeDef *hsd);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SDQUEUE_Exported_Functions_Group2
+  * @{
+  */
+/* Request functions **********************************************************/
+HAL_StatusTypeDef BSP_SDQUEUE_Submit(BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_ReqTypeDef *pReq);
+uint32_t          BSP_SDQUEUE_IsIdle(const BSP_SDQUEUE_TypeDef *hqueue);
+void              BSP_SDQUEUE_GetStats(const BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_StatsTypeDef *pStats);
+void              BSP_SDQUEUE_IRQHandler(BSP_SDQUEUE_TypeDef *hqueue);
+void              BSP_SDQUEUE_TxCpltHandler(BSP_SDQUEUE_TypeDef *hqueue);
+void              BSP_SDQUEUE_RxCpltHandler(BSP_SDQUEUE_TypeDef *hqueue);
+void              BSP_SDQUEUE_ErrorHandler(BSP_SDQUEUE_TypeDef *hqueue);
+void              BSP_SDQUEUE_ReqCpltCallback(BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_ReqTypeDef *pReq);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SDQUEUE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
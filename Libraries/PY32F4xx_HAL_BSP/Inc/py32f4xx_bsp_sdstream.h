@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdstream.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SD card streaming write BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SDSTREAM_H
+#define __PY32F4XX_BSP_SDSTREAM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_SD_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SDSTREAM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Exported_Constants BSP SDSTREAM Exported Constants
+  * @{
+  */
+#if !defined (BSP_SDSTREAM_QUEUE)
+#define BSP_SDSTREAM_QUEUE              8U             /*!< Buffers queued at most, a power of 2      */
+#endif
+
+#define BSP_SDSTREAM_BUFFER_BLOCKS_MAX  511U           /*!< Blocks of a buffer, one DMA transfer      */
+#define BSP_SDSTREAM_PRE_ERASE_MAX      0x007FFFFFU    /*!< Blocks of ACMD23                          */
+
+/** @defgroup BSP_SDSTREAM_State BSP SDSTREAM State
+  * @{
+  */
+#define BSP_SDSTREAM_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_SDSTREAM_STATE_READY        0x00000001U    /*!< Initialized, card in transfer state       */
+#define BSP_SDSTREAM_STATE_RUN          0x00000002U    /*!< CMD25 open, buffers accepted              */
+#define BSP_SDSTREAM_STATE_STOP         0x00000003U    /*!< Queue draining, CMD12 when empty          */
+#define BSP_SDSTREAM_STATE_BUSY         0x00000004U    /*!< CMD12 sent, card programming              */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Exported_Types BSP SDSTREAM Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SD streaming buffer definition
+  */
+typedef struct
+{
+  const uint8_t           *pData;       /*!< Blocks to write, word aligned                          */
+
+  uint32_t                NbrOfBlocks;  /*!< Blocks, 1 to BSP_SDSTREAM_BUFFER_BLOCKS_MAX            */
+
+} BSP_SDSTREAM_BufferTypeDef;
+
+/**
+  * @brief  SD streaming statistics definition
+  */
+typedef struct
+{
+  uint32_t                Blocks;       /*!< Blocks given to the card                               */
+
+  uint32_t                Buffers;      /*!< Buffers given to the card                              */
+
+  uint32_t                Underruns;    /*!< DMA completions with the queue empty, card clock held  */
+
+  uint32_t                MaxQueued;    /*!< Highest count of buffers queued                        */
+
+  uint32_t                Streams;      /*!< Streams completed, CMD12 busy ended                    */
+
+  uint32_t                Errors;       /*!< Streams aborted on an error                            */
+
+} BSP_SDSTREAM_StatsTypeDef;
+
+/**
+  * @brief  SD streaming writer definition
+  */
+typedef struct
+{
+  SD_HandleTypeDef        *hsd;         /*!< SD handle, card initialized, Tx DMA linked             */
+
+  uint32_t                BlockAdd;     /*!< Block of the stream following the data queued          */
+
+  uint32_t                PreErased;    /*!< Blocks announced by ACMD23 to the stream in progress   */
+
+  BSP_SDSTREAM_BufferTypeDef Queue[BSP_SDSTREAM_QUEUE]; /*!< Buffers, the one at Tail in transfer   */
+
+  __IO uint32_t           Head;         /*!< Queue entries written by BSP_SDSTREAM_Write()          */
+
+  __IO uint32_t           Tail;         /*!< Queue entries released by the DMA completion           */
+
+  __IO uint32_t           InFlight;     /*!< 1 while the DMA transfers the buffer at Tail           */
+
+  BSP_SDSTREAM_StatsTypeDef Stats;      /*!< Statistics                                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_SDSTREAM_State                     */
+
+} BSP_SDSTREAM_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SDSTREAM_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_SDSTREAM_Init(BSP_SDSTREAM_TypeDef *hs, SD_HandleTypeDef *hsd);
+HAL_StatusTypeDef BSP_SDSTREAM_Start(BSP_SDSTREAM_TypeDef *hs, uint32_t BlockAdd, uint32_t PreEraseBlocks);
+HAL_StatusTypeDef BSP_SDSTREAM_Write(BSP_SDSTREAM_TypeDef *hs, const uint8_t *pData, uint32_t NbrOfBlocks);
+HAL_StatusTypeDef BSP_SDSTREAM_Stop(BSP_SDSTREAM_TypeDef *hs);
+uint32_t          BSP_SDSTREAM_GetQueued(const BSP_SDSTREAM_TypeDef *hs);
+void              BSP_SDSTREAM_GetStats(const BSP_SDSTREAM_TypeDef *hs, BSP_SDSTREAM_StatsTypeDef *pStats);
+void              BSP_SDSTREAM_IRQHandler(BSP_SDSTREAM_TypeDef *hs);
+void              BSP_SDSTREAM_TxCpltCallback(BSP_SDSTREAM_TypeDef *hs, const uint8_t *pData);
+void              BSP_SDSTREAM_StopCpltCallback(BSP_SDSTREAM_TypeDef *hs);
+void              BSP_SDSTREAM_ErrorCallback(BSP_SDSTREAM_TypeDef *hs);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SDSTREAM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_serial.h
+  * @author  MCU Application Team
+  * @brief   Header file of the serial stream multiplexer BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SERIAL_H
+#define __PY32F4XX_BSP_SERIAL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SERIAL
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Exported_Types BSP SERIAL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Serial port state definition
+  */
+typedef struct
+{
+  UART_HandleTypeDef      *huart;       /*!< UART of the port, NULL when the port is closed       */
+
+  DMA_RingTypeDef         Rx;           /*!< Receive ring, filled by the circular Rx DMA          */
+
+  uint8_t                 *pTxBuffer;   /*!< Transmit ring storage                                 */
+
+  uint32_t                TxSize;       /*!< Transmit ring size in bytes                           */
+
+  __IO uint32_t           TxHead;       /*!< Next byte written by BSP_SERIAL_Write()               */
+
+  __IO uint32_t           TxTail;       /*!< Next byte sent by the Tx DMA                          */
+
+  __IO uint32_t           TxXferSize;   /*!< Size of the Tx DMA transfer in progress, 0 when idle  */
+
+  __IO uint32_t           ErrorCount;   /*!< Number of UART and Tx DMA errors                      */
+
+  GPIO_TypeDef            *RtsPort;     /*!< RTS output port, NULL without flow control            */
+
+  uint16_t                RtsPin;       /*!< RTS output pin, high to stop the peer                 */
+
+  uint32_t                HighWater;    /*!< Bytes in the receive ring raising RTS                 */
+
+  uint32_t                LowWater;     /*!< Bytes in the receive ring lowering RTS again          */
+
+  __IO uint32_t           Throttled;    /*!< 1 while RTS is high                                   */
+
+  __IO uint32_t           Throttles;    /*!< Number of times RTS was raised                        */
+
+} BSP_SERIAL_PortTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Exported_Constants BSP SERIAL Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SERIAL_Port BSP SERIAL Port
+  * @{
+  */
+#define BSP_SERIAL_PORT1                0U             /*!< USART1 */
+#define BSP_SERIAL_PORT2                1U             /*!< USART2 */
+#define BSP_SERIAL_PORT3                2U             /*!< USART3 */
+#define BSP_SERIAL_PORT4                3U             /*!< USART4 */
+#define BSP_SERIAL_PORT5                4U             /*!< USART5 */
+#define BSP_SERIAL_PORT_NUMBER          5U             /*!< Number of ports */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SERIAL_Event BSP SERIAL Event
+  * @brief    Readiness bits, one per port and event type
+  * @{
+  */
+#define BSP_SERIAL_EVENT_RX_Pos         0U
+#define BSP_SERIAL_EVENT_TX_Pos         8U
+#define BSP_SERIAL_EVENT_ERR_Pos        16U
+#define BSP_SERIAL_EVENT_RX_ALL         (0x1FUL << BSP_SERIAL_EVENT_RX_Pos)    /*!< Received data waiting, all ports  */
+#define BSP_SERIAL_EVENT_TX_ALL         (0x1FUL << BSP_SERIAL_EVENT_TX_Pos)    /*!< Room in the Tx ring, all ports    */
+#define BSP_SERIAL_EVENT_ERR_ALL        (0x1FUL << BSP_SERIAL_EVENT_ERR_Pos)   /*!< Error occurred, all ports         */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Exported_Macros BSP SERIAL Exported Macros
+  * @{
+  */
+
+/** @brief  Readiness bit of received data waiting on a port.
+  * @param  __PORT__ A value of @ref BSP_SERIAL_Port.
+  */
+#define BSP_SERIAL_EVENT_RX(__PORT__)   (1UL << (BSP_SERIAL_EVENT_RX_Pos + (__PORT__)))
+
+/** @brief  Readiness bit of room in the Tx ring of a port.
+  * @param  __PORT__ A value of @ref BSP_SERIAL_Port.
+  */
+#define BSP_SERIAL_EVENT_TX(__PORT__)   (1UL << (BSP_SERIAL_EVENT_TX_Pos + (__PORT__)))
+
+/** @brief  Readiness bit of an error on a port.
+  * @param  __PORT__ A value of @ref BSP_SERIAL_Port.
+  */
+#define BSP_SERIAL_EVENT_ERR(__PORT__)  (1UL << (BSP_SERIAL_EVENT_ERR_Pos + (__PORT__)))
+
+/** @brief  All the readiness bits of a port.
+  * @param  __PORT__ A value of @ref BSP_SERIAL_Port.
+  */
+#define BSP_SERIAL_EVENT_PORT(__PORT__) (BSP_SERIAL_EVENT_RX(__PORT__) | BSP_SERIAL_EVENT_TX(__PORT__) | \
+                                         BSP_SERIAL_EVENT_ERR(__PORT__))
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SERIAL_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SERIAL_Exported_Functions_Group1
+  * @{
+  */
+/* Port functions *************************************************************/
+HAL_StatusTypeDef BSP_SERIAL_Open(UART_HandleTypeDef *huart, uint8_t *pRxBuffer, uint32_t RxSize,
+                                  uint8_t *pTxBuffer, uint32_t TxSize);
+HAL_StatusTypeDef BSP_SERIAL_Close(uint32_t Port);
+uint32_t          BSP_SERIAL_Read(uint32_t Port, uint8_t *pData, uint32_t Length);
+uint32_t          BSP_SERIAL_Acquire(uint32_t Port, uint8_t **ppData);
+void              BSP_SERIAL_Commit(uint32_t Port, uint32_t Length);
+uint32_t          BSP_SERIAL_Write(uint32_t Port, const uint8_t *pData, uint32_t Length);
+uint32_t          BSP_SERIAL_GetPort(const UART_HandleTypeDef *huart);
+HAL_StatusTypeDef BSP_SERIAL_SetFlowControl(uint32_t Port, GPIO_TypeDef *RtsPort, uint16_t RtsPin,
+                                            uint32_t HighWater, uint32_t LowWater);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SERIAL_Exported_Functions_Group2
+  * @{
+  */
+/* Poll and notify functions **************************************************/
+uint32_t          BSP_SERIAL_Poll(uint32_t Events, uint32_t Timeout);
+void              BSP_SERIAL_IRQHandler(UART_HandleTypeDef *huart);
+void              BSP_SERIAL_Tick(void);
+void              BSP_SERIAL_NotifyCallback(uint32_t Events);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SERIAL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sha256.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SHA-256 image verification BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SHA256_H
+#define __PY32F4XX_BSP_SHA256_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SHA256
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Exported_Constants BSP SHA256 Exported Constants
+  * @{
+  */
+#define BSP_SHA256_BLOCK_SIZE           64U            /*!< Bytes of a message block                  */
+#define BSP_SHA256_DIGEST_SIZE          32U            /*!< Bytes of a digest                         */
+#define BSP_SHA256_CHUNK_SIZE           1024U          /*!< Bytes of an image chunk copied by the DMA,
+                                                            a multiple of BSP_SHA256_BLOCK_SIZE       */
+
+/** @defgroup BSP_SHA256_State BSP SHA256 Verification State
+  * @{
+  */
+#define BSP_SHA256_STATE_IDLE           0x00000000U    /*!< No verification                           */
+#define BSP_SHA256_STATE_RUNNING        0x00000001U    /*!< Image being hashed                        */
+#define BSP_SHA256_STATE_MATCH          0x00000002U    /*!< Digest of the image as expected           */
+#define BSP_SHA256_STATE_MISMATCH       0x00000003U    /*!< Other digest or DMA error                 */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Exported_Types BSP SHA256 Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SHA-256 context definition
+  */
+typedef struct
+{
+  uint32_t                State[8];     /*!< Hash value H0 to H7                                    */
+
+  uint32_t                Buffer[BSP_SHA256_BLOCK_SIZE / 4U]; /*!< Block being filled, as received  */
+
+  uint32_t                Fill;         /*!< Bytes in Buffer                                        */
+
+  uint64_t                Length;       /*!< Message bytes taken                                    */
+
+} BSP_SHA256_TypeDef;
+
+/**
+  * @brief  Image verification state definition
+  */
+typedef struct
+{
+  BSP_SHA256_TypeDef      Hash;         /*!< Hash of the image                                      */
+
+  const uint8_t           *pImage;      /*!< First byte of the image                                */
+
+  uint32_t                Size;         /*!< Image bytes                                            */
+
+  uint32_t                Hashed;       /*!< Image bytes hashed                                     */
+
+  uint32_t                Expected[BSP_SHA256_DIGEST_SIZE / 4U]; /*!< Digest expected               */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_SHA256_State                       */
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+  DMA_HandleTypeDef       *hdma;        /*!< Memory to memory channel reading the image ahead, NULL
+                                             to hash from the flash directly                        */
+
+  uint32_t                Fetched;      /*!< End of the image bytes given to the DMA                */
+
+  uint32_t                Staging[2][BSP_SHA256_CHUNK_SIZE / 4U]; /*!< Chunk hashed and chunk
+                                             being copied, even chunks in the first one             */
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+} BSP_SHA256_VerifyTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SHA256_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SHA256_Exported_Functions_Group1
+  * @{
+  */
+/* Hash functions *************************************************************/
+void              BSP_SHA256_Init(BSP_SHA256_TypeDef *hsha);
+void              BSP_SHA256_Update(BSP_SHA256_TypeDef *hsha, const uint8_t *pData, uint32_t Size);
+void              BSP_SHA256_Final(BSP_SHA256_TypeDef *hsha, uint8_t *pDigest);
+void              BSP_SHA256_Calculate(const uint8_t *pData, uint32_t Size, uint8_t *pDigest);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SHA256_Exported_Functions_Group2
+  * @{
+  */
+/* Verification functions *****************************************************/
+void              BSP_SHA256_VerifyInit(BSP_SHA256_VerifyTypeDef *hverify);
+#if defined (HAL_DMA_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_SHA256_VerifyAttachDma(BSP_SHA256_VerifyTypeDef *hverify, DMA_HandleTypeDef *hdma);
+#endif /* HAL_DMA_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_SHA256_VerifyStart(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Address, uint32_t Size,
+                                         const uint8_t *pDigest);
+HAL_StatusTypeDef BSP_SHA256_VerifyProcess(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Bytes);
+HAL_StatusTypeDef BSP_SHA256_Verify(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Address, uint32_t Size,
+                                    const uint8_t *pDigest);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SHA256_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
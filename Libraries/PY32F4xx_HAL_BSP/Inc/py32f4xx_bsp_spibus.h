@@ -0,0 +1,189 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spibus.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI bus transaction queue BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SPIBUS_H
+#define __PY32F4XX_BSP_SPIBUS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SPIBUS
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SPIBUS_Exported_Types BSP SPIBUS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SPI bus device definition
+  * @note   Built by BSP_SPIBUS_DeviceInit(), the register images are written to
+  *         the SPI only when they differ from the previous device.
+  */
+typedef struct
+{
+  uint32_t                CR1;          /*!< SPI CR1 image, SPE excluded                            */
+
+  uint32_t                CR2;          /*!< SPI CR2 image, DMA requests excluded                   */
+
+  GPIO_TypeDef            *CSPort;      /*!< Chip select port, driven low during a transaction      */
+
+  uint16_t                CSPin;        /*!< Chip select pin, a value of @ref GPIO_pins             */
+
+} BSP_SPIBUS_DeviceTypeDef;
+
+/**
+  * @brief  SPI bus transaction definition
+  * @note   The transaction is linked in the bus queue until it ends, it must stay
+  *         valid until then.
+  */
+typedef struct __BSP_SPIBUS_XferTypeDef
+{
+  const BSP_SPIBUS_DeviceTypeDef *pDevice; /*!< Addressed device                                    */
+
+  const uint8_t           *pTxData;     /*!< Data sent, NULL to send 0xFF                           */
+
+  uint8_t                 *pRxData;     /*!< Data received, NULL to drop it                         */
+
+  uint16_t                Size;         /*!< Number of data items, u8 or u16 as the device DataSize */
+
+  uint32_t                Flags;        /*!< A combination of @ref BSP_SPIBUS_Flags                 */
+
+  __IO uint32_t           Status;       /*!< A value of @ref BSP_SPIBUS_Status                      */
+
+  struct __BSP_SPIBUS_XferTypeDef *pNext; /*!< Next queued transaction                              */
+
+} BSP_SPIBUS_XferTypeDef;
+
+/**
+  * @brief  SPI bus state definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< SPI of the bus, NULL when the bus is not initialized   */
+
+  BSP_SPIBUS_XferTypeDef  *pHead;       /*!< Transaction on the bus, NULL when idle                 */
+
+  BSP_SPIBUS_XferTypeDef  *pTail;       /*!< Last queued transaction                                */
+
+  const BSP_SPIBUS_DeviceTypeDef *pSelected; /*!< Device with its chip select still low, or NULL    */
+
+  uint32_t                CR1;          /*!< SPI CR1 image in use                                   */
+
+  uint32_t                CR2;          /*!< SPI CR2 image in use                                   */
+
+  uint32_t                ErrorCount;   /*!< Number of transactions ended with a DMA error          */
+
+} BSP_SPIBUS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SPIBUS_Exported_Constants BSP SPIBUS Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SPIBUS_Flags BSP SPIBUS Flags
+  * @{
+  */
+#define BSP_SPIBUS_XFER_NONE            0x00000000U    /*!< Chip select released at the end           */
+#define BSP_SPIBUS_XFER_KEEP_CS         0x00000001U    /*!< Chip select kept low for the next transaction
+                                                            of the same device, e.g. command then data */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SPIBUS_Status BSP SPIBUS Status
+  * @{
+  */
+#define BSP_SPIBUS_STATUS_NONE          0x00000000U    /*!< Not submitted                             */
+#define BSP_SPIBUS_STATUS_QUEUED        0x00000001U    /*!< Waiting in the queue or on the bus        */
+#define BSP_SPIBUS_STATUS_OK            0x00000002U    /*!< Transferred                               */
+#define BSP_SPIBUS_STATUS_ERROR         0x00000003U    /*!< DMA error, the transaction was dropped    */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SPIBUS_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SPIBUS_Exported_Functions_Group1
+  * @{
+  */
+/* Bus and device functions ***************************************************/
+HAL_StatusTypeDef BSP_SPIBUS_Init(BSP_SPIBUS_TypeDef *hbus, SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef BSP_SPIBUS_DeInit(BSP_SPIBUS_TypeDef *hbus);
+HAL_StatusTypeDef BSP_SPIBUS_DeviceInit(BSP_SPIBUS_DeviceTypeDef *pDevice, const SPI_InitTypeDef *pInit,
+                                        GPIO_TypeDef *CSPort, uint16_t CSPin);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPIBUS_Exported_Functions_Group2
+  * @{
+  */
+/* Transaction functions ******************************************************/
+HAL_StatusTypeDef BSP_SPIBUS_Submit(BSP_SPIBUS_TypeDef *hbus, BSP_SPIBUS_XferTypeDef *pXfer);
+uint32_t          BSP_SPIBUS_IsIdle(const BSP_SPIBUS_TypeDef *hbus);
+void              BSP_SPIBUS_XferCpltCallback(BSP_SPIBUS_TypeDef *hbus, BSP_SPIBUS_XferTypeDef *pXfer);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SPIBUS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
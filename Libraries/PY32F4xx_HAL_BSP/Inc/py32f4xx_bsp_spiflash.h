@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spiflash.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI NOR flash BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SPIFLASH_H
+#define __PY32F4XX_BSP_SPIFLASH_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SPIFLASH
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SPIFLASH_Exported_Constants BSP SPIFLASH Exported Constants
+  * @{
+  */
+#define BSP_SPIFLASH_PAGE_SIZE          256U           /*!< Page program size in bytes                */
+#define BSP_SPIFLASH_LINE_SIZE          32U            /*!< Cache line size in bytes, a power of 2
+                                                            dividing the page size                     */
+#define BSP_SPIFLASH_LINE_NUMBER        8U             /*!< Number of cache lines                     */
+#define BSP_SPIFLASH_DMA_THRESHOLD      64U            /*!< Data phases from this size run with DMA   */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SPIFLASH_Exported_Types BSP SPIFLASH Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SPI flash cache line definition
+  */
+typedef struct
+{
+  uint32_t                Address;      /*!< Flash address of Data, 0xFFFFFFFF when the line is empty */
+
+  uint32_t                Stamp;        /*!< Last use, the oldest line is replaced first            */
+
+  uint8_t                 Data[BSP_SPIFLASH_LINE_SIZE]; /*!< Copy of the flash content              */
+
+} BSP_SPIFLASH_LineTypeDef;
+
+/**
+  * @brief  SPI flash state definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< SPI of the flash, NULL when not initialized            */
+
+  GPIO_TypeDef            *CSPort;      /*!< Chip select port                                       */
+
+  uint16_t                CSPin;        /*!< Chip select pin, a value of @ref GPIO_pins             */
+
+  uint8_t                 AddressBytes; /*!< Address length of the commands, 3 or 4                 */
+
+  uint8_t                 EraseCmd;     /*!< Opcode of the smallest erase                           */
+
+  uint32_t                JedecId;      /*!< Manufacturer, memory type and capacity bytes           */
+
+  uint32_t                Size;         /*!< Flash size in bytes                                    */
+
+  uint32_t                EraseSize;    /*!< Size of the smallest erase in bytes                    */
+
+  uint32_t                Stamp;        /*!< Cache use counter                                      */
+
+  BSP_SPIFLASH_LineTypeDef Lines[BSP_SPIFLASH_LINE_NUMBER]; /*!< Read cache                         */
+
+  uint32_t                ProgAddress;  /*!< Page of the pending program                            */
+
+  uint32_t                ProgStart;    /*!< First pending byte in ProgBuffer                       */
+
+  uint32_t                ProgEnd;      /*!< End of the pending bytes, ProgStart when none          */
+
+  uint8_t                 ProgBuffer[BSP_SPIFLASH_PAGE_SIZE]; /*!< Data batched for the page       */
+
+  uint32_t                CacheHits;    /*!< Number of reads served from the cache                  */
+
+  uint32_t                CacheMisses;  /*!< Number of cache lines loaded                           */
+
+  uint32_t                EraseSkips;   /*!< Number of erases skipped on blank blocks               */
+
+} BSP_SPIFLASH_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SPIFLASH_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SPIFLASH_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_SPIFLASH_Init(BSP_SPIFLASH_TypeDef *hflash, SPI_HandleTypeDef *hspi,
+                                    GPIO_TypeDef *CSPort, uint16_t CSPin);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPIFLASH_Exported_Functions_Group2
+  * @{
+  */
+/* Operation functions ********************************************************/
+HAL_StatusTypeDef BSP_SPIFLASH_Read(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData, uint32_t Size);
+HAL_StatusTypeDef BSP_SPIFLASH_Write(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                     uint32_t Size);
+HAL_StatusTypeDef BSP_SPIFLASH_Flush(BSP_SPIFLASH_TypeDef *hflash);
+HAL_StatusTypeDef BSP_SPIFLASH_Erase(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SPIFLASH_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
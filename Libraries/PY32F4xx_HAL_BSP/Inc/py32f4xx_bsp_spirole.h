@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spirole.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI/I2S role switch BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SPIROLE_H
+#define __PY32F4XX_BSP_SPIROLE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined(HAL_SPI_MODULE_ENABLED) && defined(HAL_I2S_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SPIROLE
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SPIROLE_Exported_Types BSP SPIROLE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Register snapshot of one role
+  */
+typedef struct
+{
+  uint32_t                CR1;          /*!< SPI CR1, SPE excluded                                  */
+
+  uint32_t                CR2;          /*!< SPI CR2, DMA requests and interrupts excluded          */
+
+  uint32_t                CRCPR;        /*!< SPI CRC polynomial                                     */
+
+  uint32_t                I2SCFGR;      /*!< I2S configuration, I2SE excluded                       */
+
+  uint32_t                I2SPR;        /*!< I2S prescaler                                          */
+
+  uint32_t                TxCCR;        /*!< Tx DMA channel configuration, EN excluded              */
+
+  uint32_t                RxCCR;        /*!< Rx DMA channel configuration, EN excluded              */
+
+  uint32_t                TxMap;        /*!< Tx DMA channel request, a DMA_CHANNEL_MAP_* value      */
+
+  uint32_t                RxMap;        /*!< Rx DMA channel request, a DMA_CHANNEL_MAP_* value      */
+
+} BSP_SPIROLE_ContextTypeDef;
+
+/**
+  * @brief  SPI/I2S role switch state definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< Handle used in the SPI role                            */
+
+  I2S_HandleTypeDef       *hi2s;        /*!< Handle used in the I2S role, same instance             */
+
+  uint32_t                Role;         /*!< Active role, a value of @ref BSP_SPIROLE_Role          */
+
+  BSP_SPIROLE_ContextTypeDef Context[2]; /*!< Snapshots indexed by role                             */
+
+  uint32_t                SwitchCount;  /*!< Number of role switches                                */
+
+} BSP_SPIROLE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SPIROLE_Exported_Constants BSP SPIROLE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SPIROLE_Role BSP SPIROLE Role
+  * @{
+  */
+#define BSP_SPIROLE_SPI                 0x00000000U    /*!< hspi is usable, hi2s is held busy         */
+#define BSP_SPIROLE_I2S                 0x00000001U    /*!< hi2s is usable, hspi is held busy         */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SPIROLE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_SPIROLE_Init(BSP_SPIROLE_TypeDef *hrole, SPI_HandleTypeDef *hspi, I2S_HandleTypeDef *hi2s,
+                                   uint32_t Role);
+HAL_StatusTypeDef BSP_SPIROLE_Switch(BSP_SPIROLE_TypeDef *hrole, uint32_t Role);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED && HAL_I2S_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SPIROLE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spislave.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SPI slave register map BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SPISLAVE_H
+#define __PY32F4XX_BSP_SPISLAVE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SPISLAVE
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SPISLAVE_Exported_Types BSP SPISLAVE Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SPI slave state definition
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< SPI in slave mode, NULL when not initialized           */
+
+  uint8_t                 *pRegs;       /*!< Register map read and written by the master            */
+
+  uint32_t                RegSize;      /*!< Register map size, 1 to 128 bytes                      */
+
+  uint8_t                 *pRing;       /*!< Reception ring of the circular Rx DMA                  */
+
+  uint32_t                RingSize;     /*!< Ring size, larger than the longest write               */
+
+  uint32_t                Turnaround;   /*!< Dummy bytes between a read header and the data, 0 to 3 */
+
+  __IO uint8_t            Status;       /*!< Byte sent during the header and the turnaround         */
+
+  uint8_t                 Header;       /*!< Header of the current transaction                      */
+
+  __IO uint32_t           State;        /*!< Transaction state, a value of @ref BSP_SPISLAVE_State  */
+
+  uint32_t                RingStart;    /*!< Ring position of the first byte after the header       */
+
+  uint32_t                ErrorCount;   /*!< Number of transactions to an invalid address           */
+
+} BSP_SPISLAVE_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SPISLAVE_Exported_Constants BSP SPISLAVE Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SPISLAVE_Header BSP SPISLAVE Header
+  * @{
+  */
+#define BSP_SPISLAVE_HEADER_READ        0x80U          /*!< Set for a read, cleared for a write       */
+#define BSP_SPISLAVE_HEADER_ADDRESS     0x7FU          /*!< First register of the transaction         */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SPISLAVE_State BSP SPISLAVE State
+  * @{
+  */
+#define BSP_SPISLAVE_STATE_IDLE         0x00000000U    /*!< Chip select high                          */
+#define BSP_SPISLAVE_STATE_HEADER       0x00000001U    /*!< Waiting for the header                    */
+#define BSP_SPISLAVE_STATE_READ         0x00000002U    /*!< Sending the registers                     */
+#define BSP_SPISLAVE_STATE_WRITE        0x00000003U    /*!< Receiving the registers                   */
+#define BSP_SPISLAVE_STATE_ERROR        0x00000004U    /*!< Address out of the map, data ignored      */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SPISLAVE_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_SPISLAVE_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization functions ***************************************************/
+HAL_StatusTypeDef BSP_SPISLAVE_Init(BSP_SPISLAVE_TypeDef *hslave, SPI_HandleTypeDef *hspi, uint8_t *pRegs,
+                                    uint32_t RegSize, uint8_t *pRing, uint32_t RingSize, uint32_t Turnaround);
+HAL_StatusTypeDef BSP_SPISLAVE_DeInit(BSP_SPISLAVE_TypeDef *hslave);
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPISLAVE_Exported_Functions_Group2
+  * @{
+  */
+/* Interrupt functions ********************************************************/
+void              BSP_SPISLAVE_CSHandler(BSP_SPISLAVE_TypeDef *hslave, GPIO_PinState PinState);
+void              BSP_SPISLAVE_IRQHandler(BSP_SPISLAVE_TypeDef *hslave);
+void              BSP_SPISLAVE_ReadCallback(BSP_SPISLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size);
+void              BSP_SPISLAVE_WriteCallback(BSP_SPISLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SPISLAVE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
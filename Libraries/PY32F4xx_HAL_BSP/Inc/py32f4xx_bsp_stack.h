@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_stack.h
+  * @author  MCU Application Team
+  * @brief   Header file of the main stack watermark and guard BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_STACK_H
+#define __PY32F4XX_BSP_STACK_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_STACK
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_STACK_Exported_Constants BSP STACK Exported Constants
+  * @{
+  */
+#define BSP_STACK_FILL                  0xCCCCCCCCU    /*!< Stack words never written, the pattern of
+                                                            the threads of BSP_RTOS                   */
+
+#if !defined (BSP_STACK_FILL_MARGIN)
+#define BSP_STACK_FILL_MARGIN           64U            /*!< Bytes left below the stack pointer of
+                                                            BSP_STACK_Init(), for its own frame       */
+#endif /* BSP_STACK_FILL_MARGIN */
+
+#define BSP_STACK_GUARD_FILL            0x5AFE57ACU    /*!< Guard words, the bottom of the stack      */
+
+#if !defined (BSP_STACK_GUARD_SIZE)
+#define BSP_STACK_GUARD_SIZE            32U            /*!< Bytes of guard words at the bottom of the
+                                                            stack, a multiple of 4                    */
+#endif /* BSP_STACK_GUARD_SIZE */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_STACK_Exported_Functions
+  * @{
+  */
+void              BSP_STACK_Init(void);
+uint32_t          BSP_STACK_GetSize(void);
+uint32_t          BSP_STACK_GetPeak(void);
+uint32_t          BSP_STACK_GetFree(void);
+HAL_StatusTypeDef BSP_STACK_Check(void);
+void              BSP_STACK_OverflowCallback(void);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_STACK_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_stdout.h
+  * @author  MCU Application Team
+  * @brief   Header file of the buffered stdout BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_STDOUT_H
+#define __PY32F4XX_BSP_STDOUT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_STDOUT
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_STDOUT_Exported_Types BSP STDOUT Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Buffered stdout state definition
+  * @note   Reserved, Committed, Queued and Released are free running byte counters,
+  *         the buffer position is the counter modulo Size.
+  */
+typedef struct
+{
+  UART_HandleTypeDef      *huart;       /*!< UART used for the output, its hdmatx must be linked  */
+
+  uint8_t                 *pBuffer;     /*!< Queue storage                                         */
+
+  uint32_t                Size;         /*!< Queue size in bytes, a power of two                   */
+
+  uint32_t                Policy;       /*!< Overflow policy, a value of @ref BSP_STDOUT_Policy    */
+
+  __IO uint32_t           Reserved;     /*!< End of the space reserved by writers                  */
+
+  __IO uint32_t           Committed;    /*!< End of the data completely written                    */
+
+  __IO uint32_t           Writers;      /*!< Number of writers currently copying data              */
+
+  __IO uint32_t           Queued;       /*!< Next byte to hand over to the DMA                     */
+
+  __IO uint32_t           Released;     /*!< Bytes before this one are free for the writers        */
+
+  __IO uint32_t           XferStart;    /*!< Start of the transfer in progress                     */
+
+  __IO uint32_t           XferSize;     /*!< Size of the transfer in progress, 0 when idle         */
+
+  __IO uint32_t           Dropped;      /*!< Number of bytes lost on overflow                      */
+
+} BSP_STDOUT_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_STDOUT_Exported_Constants BSP STDOUT Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_STDOUT_Policy BSP STDOUT Overflow Policy
+  * @{
+  */
+#define BSP_STDOUT_POLICY_DROP          0x00000000U    /*!< Drop the bytes that do not fit                        */
+#define BSP_STDOUT_POLICY_BLOCK         0x00000001U    /*!< Wait for room, drop when called from an interrupt     */
+#define BSP_STDOUT_POLICY_OVERWRITE     0x00000002U    /*!< Discard the oldest bytes not yet handed to the DMA    */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_STDOUT_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup BSP_STDOUT_Exported_Functions_Group1
+  * @{
+  */
+/* Initialization and output functions ****************************************/
+HAL_StatusTypeDef BSP_STDOUT_Init(UART_HandleTypeDef *huart, uint8_t *pBuffer, uint32_t Size, uint32_t Policy);
+uint32_t          BSP_STDOUT_Write(const uint8_t *pData, uint32_t Length);
+void              BSP_STDOUT_Flush(void);
+uint32_t          BSP_STDOUT_GetDropped(void);
+void              BSP_STDOUT_TxCpltCallback(UART_HandleTypeDef *huart);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_STDOUT_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,180 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sync.h
+  * @author  MCU Application Team
+  * @brief   Header file of the interrupt to main loop synchronization BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_SYNC_H
+#define __PY32F4XX_BSP_SYNC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_SYNC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_SYNC_Exported_Constants BSP SYNC Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_SYNC_Wait BSP SYNC Wait
+  * @{
+  */
+#define BSP_SYNC_WAIT_ANY               0U             /*!< One flag of the mask is enough                */
+#define BSP_SYNC_WAIT_ALL               1U             /*!< All the flags of the mask are needed          */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_SYNC_Exported_Macros BSP SYNC Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  Words of the buffer of a queue, a sequence word per item.
+  * @param  __ITEM_SIZE__ Bytes of an item.
+  * @param  __COUNT__ Items, a power of 2.
+  */
+#define BSP_SYNC_QUEUE_WORDS(__ITEM_SIZE__, __COUNT__)  ((__COUNT__) * (1U + (((__ITEM_SIZE__) + 3U) / 4U)))
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_SYNC_Exported_Types BSP SYNC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Single producer, single consumer ring definition
+  */
+typedef struct
+{
+  uint8_t                 *pBuffer;     /*!< Items, Count * ItemSize bytes                          */
+
+  uint32_t                ItemSize;     /*!< Bytes of an item                                       */
+
+  uint32_t                Mask;         /*!< Count - 1                                              */
+
+  __IO uint32_t           Head;         /*!< Items put, written by the producer only                */
+
+  __IO uint32_t           Tail;         /*!< Items got, written by the consumer only                */
+
+  uint32_t                TailCache;    /*!< Tail last read by the producer                         */
+
+  uint32_t                HeadCache;    /*!< Head last read by the consumer                         */
+
+} BSP_SYNC_RingTypeDef;
+
+/**
+  * @brief  Multiple producers, single consumer queue definition
+  */
+typedef struct
+{
+  uint32_t                *pBuffer;     /*!< Slots, a sequence word then the item                   */
+
+  uint32_t                ItemSize;     /*!< Bytes of an item                                       */
+
+  uint32_t                SlotWords;    /*!< Words of a slot                                        */
+
+  uint32_t                Mask;         /*!< Count - 1                                              */
+
+  __IO uint32_t           Head;         /*!< Position of the next slot taken by a producer          */
+
+  __IO uint32_t           Tail;         /*!< Position of the next item got                          */
+
+  __IO uint32_t           Overruns;     /*!< Items refused, the queue full                          */
+
+} BSP_SYNC_QueueTypeDef;
+
+/**
+  * @brief  Event flag group definition
+  */
+typedef struct
+{
+  __IO uint32_t           Flags;        /*!< Flags set and not taken yet                            */
+
+} BSP_SYNC_EventTypeDef;
+
+/**
+  * @brief  Sequence lock definition
+  */
+typedef struct
+{
+  __IO uint32_t           Sequence;     /*!< Odd while the writer updates the data                  */
+
+} BSP_SYNC_SeqTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_SYNC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_SYNC_RingInit(BSP_SYNC_RingTypeDef *pRing, void *pBuffer, uint32_t ItemSize, uint32_t Count);
+HAL_StatusTypeDef BSP_SYNC_RingPut(BSP_SYNC_RingTypeDef *pRing, const void *pItem);
+HAL_StatusTypeDef BSP_SYNC_RingGet(BSP_SYNC_RingTypeDef *pRing, void *pItem);
+uint32_t          BSP_SYNC_RingCount(const BSP_SYNC_RingTypeDef *pRing);
+
+HAL_StatusTypeDef BSP_SYNC_QueueInit(BSP_SYNC_QueueTypeDef *pQueue, uint32_t *pBuffer, uint32_t ItemSize, uint32_t Count);
+HAL_StatusTypeDef BSP_SYNC_QueuePut(BSP_SYNC_QueueTypeDef *pQueue, const void *pItem);
+HAL_StatusTypeDef BSP_SYNC_QueueGet(BSP_SYNC_QueueTypeDef *pQueue, void *pItem);
+
+void              BSP_SYNC_EventSet(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags);
+uint32_t          BSP_SYNC_EventTake(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags, uint32_t Mode);
+uint32_t          BSP_SYNC_EventWait(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags, uint32_t Mode, uint32_t Timeout);
+
+void              BSP_SYNC_SeqWriteBegin(BSP_SYNC_SeqTypeDef *pSeq);
+void              BSP_SYNC_SeqWriteEnd(BSP_SYNC_SeqTypeDef *pSeq);
+void              BSP_SYNC_SeqRead(const BSP_SYNC_SeqTypeDef *pSeq, void *pDst, const volatile void *pSrc, uint32_t Size);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_SYNC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
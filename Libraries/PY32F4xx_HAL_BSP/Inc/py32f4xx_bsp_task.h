@@ -0,0 +1,315 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_task.h
+  * @author  MCU Application Team
+  * @brief   Header file of the cooperative task BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TASK_H
+#define __PY32F4XX_BSP_TASK_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TASK
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TASK_Exported_Constants BSP TASK Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_TASK_Result BSP TASK Result
+  * @{
+  */
+#define BSP_TASK_WAITING                0U             /*!< Blocked on a condition, polled again on a wake-up */
+#define BSP_TASK_YIELDED                1U             /*!< Ready, run again on the next pass                 */
+#define BSP_TASK_ENDED                  2U             /*!< Returned from its body, removed from the list     */
+/**
+  * @}
+  */
+
+/**
+  * @brief  Resume point of the completion wait of BSP_TASK_AWAIT_HAL(), the one of the call with this bit
+  */
+#define BSP_TASK_LINE_WAIT              0x80000000U
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TASK_Exported_Types BSP TASK Exported Types
+  * @{
+  */
+
+typedef struct __BSP_TASK_TypeDef BSP_TASK_TypeDef;
+
+/**
+  * @brief  Body of a task, resumed where it waited, returns a value of @ref BSP_TASK_Result
+  */
+typedef uint32_t (*BSP_TASK_FuncTypeDef)(BSP_TASK_TypeDef *pTask);
+
+/**
+  * @brief  Task definition, the only memory of a task, the locals of its body being lost on a wait
+  */
+struct __BSP_TASK_TypeDef
+{
+  BSP_TASK_FuncTypeDef    Func;         /*!< Body of the task                                       */
+
+  void                    *pArg;        /*!< Argument of the body, the context surviving the waits  */
+
+  uint32_t                Line;         /*!< Resume point, the source line of the wait, 0 at start  */
+
+  uint32_t                Start;        /*!< Tick of the start of the current wait                  */
+
+  HAL_StatusTypeDef       Status;       /*!< Result of the last await, HAL_TIMEOUT on its timeout   */
+
+  BSP_TASK_TypeDef        *pNext;       /*!< Next task of the run list                              */
+};
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_TASK_Exported_Macros BSP TASK Exported Macros
+  * @{
+  */
+
+/**
+  * @brief  First statement of the body of a task.
+  * @param  __TASK__ Pointer to the task.
+  */
+#define BSP_TASK_BEGIN(__TASK__)                  switch ((__TASK__)->Line) { case 0U:
+
+/**
+  * @brief  Last statement of the body of a task, ends it.
+  * @param  __TASK__ Pointer to the task.
+  */
+#define BSP_TASK_END(__TASK__)                    } (__TASK__)->Line = 0U; return BSP_TASK_ENDED
+
+/**
+  * @brief  Leave the other tasks run, the task staying ready.
+  * @param  __TASK__ Pointer to the task.
+  */
+#define BSP_TASK_YIELD(__TASK__)                                                  \
+  do                                                                              \
+  {                                                                               \
+    (__TASK__)->Line = __LINE__;                                                  \
+    return BSP_TASK_YIELDED;                                                      \
+    case __LINE__:;                                                               \
+  } while (0)
+
+/**
+  * @brief  Wait for a condition, evaluated again on each wake-up of the scheduler.
+  * @param  __TASK__ Pointer to the task.
+  * @param  __COND__ Condition, read from the memory or the registers.
+  */
+#define BSP_TASK_WAIT_UNTIL(__TASK__, __COND__)                                   \
+  do                                                                              \
+  {                                                                               \
+    (__TASK__)->Line = __LINE__;                                                  \
+    case __LINE__:                                                                \
+    if (!(__COND__))                                                              \
+    {                                                                             \
+      return BSP_TASK_WAITING;                                                    \
+    }                                                                             \
+  } while (0)
+
+/**
+  * @brief  Wait for a condition at most a time, Status set to HAL_OK or HAL_TIMEOUT.
+  * @param  __TASK__ Pointer to the task.
+  * @param  __COND__ Condition, read from the memory or the registers.
+  * @param  __TIMEOUT__ Milliseconds, HAL_MAX_DELAY for none.
+  */
+#define BSP_TASK_WAIT_TIMEOUT(__TASK__, __COND__, __TIMEOUT__)                    \
+  do                                                                              \
+  {                                                                               \
+    (__TASK__)->Start  = HAL_GetTick();                                           \
+    (__TASK__)->Status = HAL_OK;                                                  \
+    BSP_TASK_WAIT_UNTIL((__TASK__), (__COND__) || (BSP_TASK_Expired((__TASK__), (__TIMEOUT__)) != 0U)); \
+  } while (0)
+
+/**
+  * @brief  Sleep for a time, other tasks running meanwhile.
+  * @param  __TASK__ Pointer to the task.
+  * @param  __DELAY__ Milliseconds.
+  */
+#define BSP_TASK_DELAY(__TASK__, __DELAY__)                                       \
+  do                                                                              \
+  {                                                                               \
+    (__TASK__)->Start = HAL_GetTick();                                            \
+    BSP_TASK_WAIT_UNTIL((__TASK__), (HAL_GetTick() - (__TASK__)->Start) >= (uint32_t)(__DELAY__)); \
+  } while (0)
+
+/**
+  * @brief  Run a child task to its end, the parent waiting meanwhile.
+  * @param  __TASK__ Pointer to the task.
+  * @param  __CHILD__ Pointer to the child task, not in the run list.
+  * @param  __FUNC__ Body of the child.
+  * @param  __ARG__ Argument of the child.
+  */
+#define BSP_TASK_SPAWN(__TASK__, __CHILD__, __FUNC__, __ARG__)                    \
+  do                                                                              \
+  {                                                                               \
+    (__CHILD__)->Func = (__FUNC__);                                               \
+    (__CHILD__)->pArg = (__ARG__);                                                \
+    (__CHILD__)->Line = 0U;                                                       \
+    BSP_TASK_WAIT_UNTIL((__TASK__), (__CHILD__)->Func((__CHILD__)) == BSP_TASK_ENDED); \
+  } while (0)
+
+/**
+  * @brief  Start a HAL _IT or _DMA operation and wait for its end, the peripheral shared
+  *         between tasks: the call is retried while it returns HAL_BUSY.
+  * @param  __TASK__ Pointer to the task.
+  * @param  __CALL__ Call of the HAL function starting the operation.
+  * @param  __DONE__ Condition true at the end of the operation, one of the
+  *         BSP_TASK_xxxDone() functions setting Status on an error.
+  * @param  __TIMEOUT__ Milliseconds of the operation, HAL_MAX_DELAY for none.
+  * @note   Status is the HAL_StatusTypeDef of the call when it failed, of the
+  *         end of the operation otherwise, HAL_TIMEOUT when it did not end;
+  *         the operation is then still running, to abort by the task.
+  */
+#define BSP_TASK_AWAIT_HAL(__TASK__, __CALL__, __DONE__, __TIMEOUT__)             \
+  do                                                                              \
+  {                                                                               \
+    (__TASK__)->Line = __LINE__;                                                  \
+    case __LINE__:                                                                \
+    (__TASK__)->Status = (__CALL__);                                              \
+    if ((__TASK__)->Status == HAL_BUSY)                                           \
+    {                                                                             \
+      return BSP_TASK_WAITING;                                                    \
+    }                                                                             \
+    if ((__TASK__)->Status == HAL_OK)                                             \
+    {                                                                             \
+      (__TASK__)->Start = HAL_GetTick();                                          \
+      (__TASK__)->Line  = (uint32_t)__LINE__ | BSP_TASK_LINE_WAIT;                \
+      case ((uint32_t)__LINE__ | BSP_TASK_LINE_WAIT):                             \
+      if (!(__DONE__) && (BSP_TASK_Expired((__TASK__), (__TIMEOUT__)) == 0U))     \
+      {                                                                           \
+        return BSP_TASK_WAITING;                                                  \
+      }                                                                           \
+    }                                                                             \
+  } while (0)
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  Await a SPI _IT or _DMA operation, HAL_SPI_TransmitReceive_DMA() for instance.
+  */
+#define BSP_TASK_AWAIT_SPI(__TASK__, __HANDLE__, __CALL__, __TIMEOUT__)           \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_SpiDone((__TASK__), (__HANDLE__)) != 0U, (__TIMEOUT__))
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#if defined(HAL_I2C_MODULE_ENABLED)
+/**
+  * @brief  Await an I2C _IT or _DMA operation, HAL_I2C_Mem_Read_DMA() for instance.
+  */
+#define BSP_TASK_AWAIT_I2C(__TASK__, __HANDLE__, __CALL__, __TIMEOUT__)           \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_I2cDone((__TASK__), (__HANDLE__)) != 0U, (__TIMEOUT__))
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#if defined(HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  Await a UART transmission, HAL_UART_Transmit_DMA() for instance.
+  */
+#define BSP_TASK_AWAIT_UART_TX(__TASK__, __HANDLE__, __CALL__, __TIMEOUT__)       \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_UartTxDone((__TASK__), (__HANDLE__)) != 0U, (__TIMEOUT__))
+
+/**
+  * @brief  Await a UART reception, HAL_UART_Receive_IT() for instance.
+  */
+#define BSP_TASK_AWAIT_UART_RX(__TASK__, __HANDLE__, __CALL__, __TIMEOUT__)       \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_UartRxDone((__TASK__), (__HANDLE__)) != 0U, (__TIMEOUT__))
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#if defined(HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  Await a memory to memory DMA transfer, HAL_DMA_Start_IT().
+  */
+#define BSP_TASK_AWAIT_DMA(__TASK__, __HANDLE__, __CALL__, __TIMEOUT__)           \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_DmaDone((__TASK__), (__HANDLE__)) != 0U, (__TIMEOUT__))
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+#if defined(HAL_FLASH_MODULE_ENABLED)
+/**
+  * @brief  Await a FLASH program or erase, HAL_FLASH_PageProgram_IT() for instance, FLASH unlocked.
+  */
+#define BSP_TASK_AWAIT_FLASH(__TASK__, __CALL__, __TIMEOUT__)                     \
+  BSP_TASK_AWAIT_HAL((__TASK__), (__CALL__), BSP_TASK_FlashDone((__TASK__)) != 0U, (__TIMEOUT__))
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TASK_Exported_Functions
+  * @{
+  */
+void              BSP_TASK_Init(void);
+HAL_StatusTypeDef BSP_TASK_Start(BSP_TASK_TypeDef *pTask, BSP_TASK_FuncTypeDef Func, void *pArg);
+HAL_StatusTypeDef BSP_TASK_Stop(BSP_TASK_TypeDef *pTask);
+uint32_t          BSP_TASK_IsRunning(const BSP_TASK_TypeDef *pTask);
+uint32_t          BSP_TASK_RunOnce(void);
+void              BSP_TASK_Run(void);
+void              BSP_TASK_Idle(void);
+
+uint32_t          BSP_TASK_Expired(BSP_TASK_TypeDef *pTask, uint32_t Timeout);
+#if defined(HAL_SPI_MODULE_ENABLED)
+uint32_t          BSP_TASK_SpiDone(BSP_TASK_TypeDef *pTask, SPI_HandleTypeDef *hspi);
+#endif /* HAL_SPI_MODULE_ENABLED */
+#if defined(HAL_I2C_MODULE_ENABLED)
+uint32_t          BSP_TASK_I2cDone(BSP_TASK_TypeDef *pTask, I2C_HandleTypeDef *hi2c);
+#endif /* HAL_I2C_MODULE_ENABLED */
+#if defined(HAL_UART_MODULE_ENABLED)
+uint32_t          BSP_TASK_UartTxDone(BSP_TASK_TypeDef *pTask, UART_HandleTypeDef *huart);
+uint32_t          BSP_TASK_UartRxDone(BSP_TASK_TypeDef *pTask, UART_HandleTypeDef *huart);
+#endif /* HAL_UART_MODULE_ENABLED */
+#if defined(HAL_DMA_MODULE_ENABLED)
+uint32_t          BSP_TASK_DmaDone(BSP_TASK_TypeDef *pTask, DMA_HandleTypeDef *hdma);
+#endif /* HAL_DMA_MODULE_ENABLED */
+#if defined(HAL_FLASH_MODULE_ENABLED)
+uint32_t          BSP_TASK_FlashDone(BSP_TASK_TypeDef *pTask);
+#endif /* HAL_FLASH_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TASK_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
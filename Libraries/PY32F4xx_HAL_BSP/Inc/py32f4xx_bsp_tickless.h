@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_tickless.h
+  * @author  MCU Application Team
+  * @brief   Header file of the tickless idle BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TICKLESS_H
+#define __PY32F4XX_BSP_TICKLESS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_timwheel.h"
+#include "py32f4xx_bsp_lpctx.h"
+
+#if defined (HAL_RTC_MODULE_ENABLED) && defined (HAL_PWR_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TICKLESS
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TICKLESS_Exported_Constants BSP TICKLESS Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_TICKLESS_Mode BSP TICKLESS Mode
+  * @{
+  */
+#define BSP_TICKLESS_MODE_NONE          0x00000000U    /*!< Too short, SLEEP mode with the tick       */
+#define BSP_TICKLESS_MODE_SLEEP         0x00000001U    /*!< SLEEP mode, tick suspended                */
+#define BSP_TICKLESS_MODE_STOP          0x00000002U    /*!< STOP mode, tick suspended                 */
+/**
+  * @}
+  */
+
+#define BSP_TICKLESS_IDLE_FOREVER       0xFFFFFFFFU    /*!< No limit but the deadlines                */
+
+#if !defined (BSP_TICKLESS_STOP_MIN)
+#define BSP_TICKLESS_STOP_MIN           5U             /*!< Shortest idle in STOP mode, ms            */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TICKLESS_Exported_Types BSP TICKLESS Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Tickless idle statistics definition
+  */
+typedef struct
+{
+  uint32_t                Sleeps;       /*!< Idles in SLEEP mode, tick suspended                    */
+
+  uint32_t                Stops;        /*!< Idles in STOP mode                                     */
+
+  uint32_t                Short;        /*!< Idles too short to suspend the tick                    */
+
+  uint32_t                IdleTime;     /*!< Milliseconds given back to the tick                    */
+
+} BSP_TICKLESS_StatsTypeDef;
+
+/**
+  * @brief  Tickless idle definition
+  */
+typedef struct
+{
+  RTC_HandleTypeDef       *hrtc;        /*!< RTC initialized, alarm owned by the service            */
+
+  uint32_t                RtcClock;     /*!< RTC kernel clock in Hz, LSE_VALUE or LSI_VALUE         */
+
+  uint32_t                Prescaler;    /*!< RTC clock cycles per counter increment                 */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+  BSP_TIMWHEEL_TypeDef    *hwheel;      /*!< Timer wheel giving the deadlines, NULL for none        */
+
+  uint32_t                WheelFreq;    /*!< Tick of the timer wheel in Hz                          */
+
+  uint32_t                WheelRem;     /*!< Wheel ticks not given yet, in 1/RtcClock units         */
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+  uint32_t                TickRem;      /*!< Milliseconds not given yet, in 1/RtcClock units        */
+
+  __IO uint32_t           StopLocks;    /*!< STOP mode forbidden while not 0                        */
+
+  BSP_LPCTX_TypeDef       LpCtx;        /*!< Clock tree saved and restored around the STOP mode     */
+
+  BSP_TICKLESS_StatsTypeDef Stats;      /*!< Statistics                                             */
+
+} BSP_TICKLESS_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TICKLESS_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TICKLESS_Init(BSP_TICKLESS_TypeDef *htl, RTC_HandleTypeDef *hrtc, uint32_t RtcClock);
+#if defined (HAL_TIM_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_TICKLESS_AttachWheel(BSP_TICKLESS_TypeDef *htl, BSP_TIMWHEEL_TypeDef *hwheel,
+                                           uint32_t WheelFreq);
+#endif /* HAL_TIM_MODULE_ENABLED */
+void              BSP_TICKLESS_LockStop(BSP_TICKLESS_TypeDef *htl);
+void              BSP_TICKLESS_UnlockStop(BSP_TICKLESS_TypeDef *htl);
+uint32_t          BSP_TICKLESS_Idle(BSP_TICKLESS_TypeDef *htl, uint32_t MaxIdle);
+void              BSP_TICKLESS_GetStats(const BSP_TICKLESS_TypeDef *htl, BSP_TICKLESS_StatsTypeDef *pStats);
+void              BSP_TICKLESS_IRQHandler(BSP_TICKLESS_TypeDef *htl);
+void              BSP_TICKLESS_SleepCallback(BSP_TICKLESS_TypeDef *htl, uint32_t Mode);
+void              BSP_TICKLESS_WakeupCallback(BSP_TICKLESS_TypeDef *htl, uint32_t Mode);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED && HAL_PWR_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TICKLESS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
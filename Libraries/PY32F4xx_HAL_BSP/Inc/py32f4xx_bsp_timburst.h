@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timburst.h
+  * @author  MCU Application Team
+  * @brief   Header file of the TIM DMA burst streaming BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TIMBURST_H
+#define __PY32F4XX_BSP_TIMBURST_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TIMBURST
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Exported_Constants BSP TIMBURST Exported Constants
+  * @{
+  */
+#define BSP_TIMBURST_REGISTERS_MAX      18U            /*!< Registers of a burst, TIM_DMABURSTLENGTH_18TRANSFERS */
+
+/** @defgroup BSP_TIMBURST_State BSP TIMBURST State
+  * @{
+  */
+#define BSP_TIMBURST_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_TIMBURST_STATE_READY        0x00000001U    /*!< Burst configured, stopped                 */
+#define BSP_TIMBURST_STATE_RUN          0x00000002U    /*!< One burst on each request                 */
+#define BSP_TIMBURST_STATE_ERROR        0x00000003U    /*!< DMA error, stopped                        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Exported_Types BSP TIMBURST Exported Types
+  * @{
+  */
+
+/**
+  * @brief  TIM DMA burst stream definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< Timer, its DMA channel of the request owned by the service */
+
+  DMA_HandleTypeDef       *hdma;        /*!< DMA channel of the request, circular, words on both sides  */
+
+  uint32_t                BurstBaseAddress; /*!< First register, a value of @ref TIM_DMA_Base_address   */
+
+  uint32_t                BurstRequestSrc; /*!< TIM_DMA_UPDATE, TIM_DMA_CC1 to TIM_DMA_CC4, TIM_DMA_COM or
+                                             TIM_DMA_TRIGGER                                        */
+
+  uint32_t                Registers;    /*!< Registers of a burst, 1 to BSP_TIMBURST_REGISTERS_MAX  */
+
+  uint32_t                *pTable;      /*!< Frames x Registers words, one frame per burst         */
+
+  uint32_t                Frames;       /*!< Frames of the table, repeated in a loop               */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TIMBURST_State                     */
+
+} BSP_TIMBURST_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TIMBURST_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TIMBURST_Init(BSP_TIMBURST_TypeDef *hburst, TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress,
+                                    uint32_t BurstRequestSrc, uint32_t Registers, uint32_t *pTable, uint32_t Frames);
+HAL_StatusTypeDef BSP_TIMBURST_Start(BSP_TIMBURST_TypeDef *hburst);
+HAL_StatusTypeDef BSP_TIMBURST_Start_IT(BSP_TIMBURST_TypeDef *hburst);
+HAL_StatusTypeDef BSP_TIMBURST_Stop(BSP_TIMBURST_TypeDef *hburst);
+uint32_t          BSP_TIMBURST_GetFrame(const BSP_TIMBURST_TypeDef *hburst);
+void              BSP_TIMBURST_HalfCpltCallback(BSP_TIMBURST_TypeDef *hburst);
+void              BSP_TIMBURST_CpltCallback(BSP_TIMBURST_TypeDef *hburst);
+void              BSP_TIMBURST_ErrorCallback(BSP_TIMBURST_TypeDef *hburst);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TIMBURST_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
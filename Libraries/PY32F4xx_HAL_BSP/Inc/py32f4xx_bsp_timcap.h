@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timcap.h
+  * @author  MCU Application Team
+  * @brief   Header file of the input capture measurement BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TIMCAP_H
+#define __PY32F4XX_BSP_TIMCAP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TIMCAP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Exported_Constants BSP TIMCAP Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_TIMCAP_State BSP TIMCAP State
+  * @{
+  */
+#define BSP_TIMCAP_STATE_RESET          0x00000000U    /*!< Not initialized                           */
+#define BSP_TIMCAP_STATE_READY          0x00000001U    /*!< Channel configured, stopped               */
+#define BSP_TIMCAP_STATE_RUN            0x00000002U    /*!< Edges captured, batches measured          */
+#define BSP_TIMCAP_STATE_ERROR          0x00000003U    /*!< DMA error, stopped                        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Exported_Types BSP TIMCAP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Input capture measurement configuration definition
+  */
+typedef struct
+{
+  uint32_t                Channel;      /*!< TIM_CHANNEL_1 to TIM_CHANNEL_4, on its own TIx input   */
+
+  uint32_t                Polarity;     /*!< TIM_ICPOLARITY_RISING or TIM_ICPOLARITY_FALLING for the
+                                             period, TIM_ICPOLARITY_BOTHEDGE for the duty too       */
+
+  uint32_t                Prescaler;    /*!< One capture every 1, 2, 4 or 8 edges, a value of
+                                             @ref TIM_Input_Capture_Prescaler, TIM_ICPSC_DIV1 on
+                                             both edges                                             */
+
+  uint32_t                Filter;       /*!< Input filter, 0x0 to 0xF                              */
+
+  uint32_t                TickHz;       /*!< Frequency of the counter, after its prescaler         */
+
+  GPIO_TypeDef            *GPIOx;       /*!< Port of the input, read at the start on both edges,
+                                             NULL otherwise                                         */
+
+  uint16_t                GPIO_Pin;     /*!< Pin of the input, a value of @ref GPIO_pins            */
+
+} BSP_TIMCAP_InitTypeDef;
+
+/**
+  * @brief  Input capture measurement of a batch definition
+  * @note   A period is the time between two captures of the polarity, Prescaler
+  *         periods of the signal; Frequency is the one of the signal.
+  */
+typedef struct
+{
+  uint32_t                Periods;      /*!< Periods measured in the batch                          */
+
+  uint32_t                PeriodMin;    /*!< Shortest period in ticks                               */
+
+  uint32_t                PeriodMax;    /*!< Longest period in ticks                                */
+
+  float                   PeriodMean;   /*!< Mean period in ticks                                   */
+
+  float                   Jitter;       /*!< Standard deviation of the period in ticks              */
+
+  float                   Frequency;    /*!< Frequency of the signal in Hz                          */
+
+  float                   Duty;         /*!< High time over the period, 0 to 1, both edges only     */
+
+} BSP_TIMCAP_StatsTypeDef;
+
+/**
+  * @brief  Input capture measurement definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< Timer, free running, shared by its measured channels   */
+
+  DMA_HandleTypeDef       *hdma;        /*!< DMA channel of the CCx request, circular, half-words   */
+
+  BSP_TIMCAP_InitTypeDef  Init;         /*!< Configuration                                           */
+
+  uint16_t                *pBuffer;     /*!< Circular buffer of the captures, a batch per half      */
+
+  uint32_t                Size;         /*!< Captures of the buffer, even                          */
+
+  uint32_t                Last;         /*!< Last capture of the previous batch                     */
+
+  uint32_t                HighTicks;    /*!< High time of the period in progress, both edges        */
+
+  uint32_t                Edges;        /*!< Bit 0: capture seen, bit 1: next edge rising, bit 2:
+                                             high time measured                                     */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TIMCAP_State                       */
+
+} BSP_TIMCAP_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TIMCAP_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TIMCAP_Init(BSP_TIMCAP_TypeDef *hcap, TIM_HandleTypeDef *htim,
+                                  const BSP_TIMCAP_InitTypeDef *pInit, uint16_t *pBuffer, uint32_t Size);
+HAL_StatusTypeDef BSP_TIMCAP_Start(BSP_TIMCAP_TypeDef *hcap);
+HAL_StatusTypeDef BSP_TIMCAP_Stop(BSP_TIMCAP_TypeDef *hcap);
+void              BSP_TIMCAP_BatchCallback(BSP_TIMCAP_TypeDef *hcap, const BSP_TIMCAP_StatsTypeDef *pStats);
+void              BSP_TIMCAP_ErrorCallback(BSP_TIMCAP_TypeDef *hcap);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TIMCAP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timsync.h
+  * @author  MCU Application Team
+  * @brief   Header file of the timer synchronization BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TIMSYNC_H
+#define __PY32F4XX_BSP_TIMSYNC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TIMSYNC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Exported_Constants BSP TIMSYNC Exported Constants
+  * @{
+  */
+#define BSP_TIMSYNC_MEMBERS_MAX         8U             /*!< Timers of a group                         */
+#define BSP_TIMSYNC_NONE                0xFFFFFFFFU    /*!< No master, the root of the group          */
+
+/** @defgroup BSP_TIMSYNC_Link BSP TIMSYNC Link
+  * @{
+  */
+#define BSP_TIMSYNC_LINK_ROOT           0x00000000U    /*!< Started by BSP_TIMSYNC_Start()             */
+#define BSP_TIMSYNC_LINK_START          0x00000001U    /*!< Started by the start of its master         */
+#define BSP_TIMSYNC_LINK_CASCADE        0x00000002U    /*!< Counts the updates of its master           */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_TIMSYNC_State BSP TIMSYNC State
+  * @{
+  */
+#define BSP_TIMSYNC_STATE_RESET         0x00000000U    /*!< Not initialized                           */
+#define BSP_TIMSYNC_STATE_READY         0x00000001U    /*!< Triggers configured, stopped              */
+#define BSP_TIMSYNC_STATE_RUN           0x00000002U    /*!< Counting                                  */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Exported_Types BSP TIMSYNC Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Timer synchronization member definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< Timer, its time base initialized                       */
+
+  uint32_t                Master;       /*!< Index of the master in the group, BSP_TIMSYNC_NONE for
+                                             the root                                               */
+
+  uint32_t                Link;         /*!< A value of @ref BSP_TIMSYNC_Link                        */
+
+} BSP_TIMSYNC_MemberTypeDef;
+
+/**
+  * @brief  Timer synchronization group definition
+  */
+typedef struct
+{
+  const BSP_TIMSYNC_MemberTypeDef *pMembers; /*!< Members, kept by the service                      */
+
+  uint32_t                NbrOfMembers; /*!< Members, 1 to BSP_TIMSYNC_MEMBERS_MAX                  */
+
+  uint32_t                Root;         /*!< Index of the root                                      */
+
+  uint8_t                 Upper[BSP_TIMSYNC_MEMBERS_MAX]; /*!< Index of the cascade slave of each
+                                             member, 0xFF for none                                  */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TIMSYNC_State                      */
+
+} BSP_TIMSYNC_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TIMSYNC_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TIMSYNC_Init(BSP_TIMSYNC_TypeDef *hsync, const BSP_TIMSYNC_MemberTypeDef *pMembers,
+                                   uint32_t NbrOfMembers);
+HAL_StatusTypeDef BSP_TIMSYNC_Start(BSP_TIMSYNC_TypeDef *hsync);
+HAL_StatusTypeDef BSP_TIMSYNC_Stop(BSP_TIMSYNC_TypeDef *hsync);
+uint64_t          BSP_TIMSYNC_GetCounter(const BSP_TIMSYNC_TypeDef *hsync, uint32_t Member);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TIMSYNC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,121 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timtrig.h
+  * @author  MCU Application Team
+  * @brief   Header file of the timer paced DMA BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TIMTRIG_H
+#define __PY32F4XX_BSP_TIMTRIG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TIMTRIG
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Exported_Constants BSP TIMTRIG Exported Constants
+  * @{
+  */
+
+/** @defgroup BSP_TIMTRIG_State BSP TIMTRIG State
+  * @{
+  */
+#define BSP_TIMTRIG_STATE_RESET         0x00000000U    /*!< Not initialized                           */
+#define BSP_TIMTRIG_STATE_READY         0x00000001U    /*!< Timer configured, stopped                 */
+#define BSP_TIMTRIG_STATE_RUN           0x00000002U    /*!< One transfer on each update               */
+#define BSP_TIMTRIG_STATE_ERROR         0x00000003U    /*!< DMA error, stopped                        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Exported_Types BSP TIMTRIG Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Timer paced DMA definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< TIM6 or TIM7, owned by the service                     */
+
+  DMA_HandleTypeDef       *hdma;        /*!< DMA channel of the update, its mode, direction and
+                                             widths those of the transfers                          */
+
+  uint32_t                Rate;         /*!< Transfers per second obtained, rounded to the clock    */
+
+  uint32_t                Length;       /*!< Transfers of the buffer                                */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TIMTRIG_State                      */
+
+} BSP_TIMTRIG_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TIMTRIG_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TIMTRIG_Init(BSP_TIMTRIG_TypeDef *htrig, TIM_HandleTypeDef *htim, uint32_t RateHz);
+HAL_StatusTypeDef BSP_TIMTRIG_SetRate(BSP_TIMTRIG_TypeDef *htrig, uint32_t RateHz);
+HAL_StatusTypeDef BSP_TIMTRIG_Start(BSP_TIMTRIG_TypeDef *htrig, uint32_t PeriphAddress, void *pBuffer,
+                                    uint32_t Length);
+HAL_StatusTypeDef BSP_TIMTRIG_Stop(BSP_TIMTRIG_TypeDef *htrig);
+uint32_t          BSP_TIMTRIG_GetIndex(const BSP_TIMTRIG_TypeDef *htrig);
+void              BSP_TIMTRIG_HalfCpltCallback(BSP_TIMTRIG_TypeDef *htrig);
+void              BSP_TIMTRIG_CpltCallback(BSP_TIMTRIG_TypeDef *htrig);
+void              BSP_TIMTRIG_ErrorCallback(BSP_TIMTRIG_TypeDef *htrig);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TIMTRIG_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
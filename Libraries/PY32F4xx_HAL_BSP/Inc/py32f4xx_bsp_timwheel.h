@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timwheel.h
+  * @author  MCU Application Team
+  * @brief   Header file of the software timer wheel BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TIMWHEEL_H
+#define __PY32F4XX_BSP_TIMWHEEL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TIMWHEEL
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Exported_Constants BSP TIMWHEEL Exported Constants
+  * @{
+  */
+#define BSP_TIMWHEEL_DELAY_MAX          0x7FFFFFFFU    /*!< Longest delay or period in ticks          */
+
+#define BSP_TIMWHEEL_LEVELS             7U             /*!< Levels of 32 slots, 5 bits of the time each */
+#define BSP_TIMWHEEL_SLOTS              32U            /*!< Slots of a level                          */
+
+#define BSP_TIMWHEEL_SLOT_NONE          0xFFFFFFFFU    /*!< Slot of a timer not armed                 */
+
+#define BSP_TIMWHEEL_IDLE_FOREVER       0xFFFFFFFFU    /*!< Idle time with no timer armed             */
+
+/** @defgroup BSP_TIMWHEEL_State BSP TIMWHEEL State
+  * @{
+  */
+#define BSP_TIMWHEEL_STATE_RESET        0x00000000U    /*!< Not initialized                           */
+#define BSP_TIMWHEEL_STATE_READY        0x00000001U    /*!< Compare channel configured, stopped       */
+#define BSP_TIMWHEEL_STATE_RUN          0x00000002U    /*!< Counter running, timers expire            */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Exported_Types BSP TIMWHEEL Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Software timer definition
+  * @note   Prepared by BSP_TIMWHEEL_TimerInit(), the timer is linked in the wheel
+  *         while armed, it must stay valid until then.
+  */
+typedef struct __BSP_TIMWHEEL_TimerTypeDef
+{
+  struct __BSP_TIMWHEEL_TimerTypeDef *pNext; /*!< Next timer of the slot                             */
+
+  struct __BSP_TIMWHEEL_TimerTypeDef **ppPrev; /*!< Link to this timer in the slot                   */
+
+  uint32_t                Expiry;       /*!< Expiry time in ticks                                   */
+
+  uint32_t                Period;       /*!< Reload in ticks, 0 for a one-shot timer                */
+
+  uint32_t                Slot;         /*!< Slot of the wheel, BSP_TIMWHEEL_SLOT_NONE when not
+                                             armed                                                  */
+
+  void                    (*Callback)(struct __BSP_TIMWHEEL_TimerTypeDef *pTimer); /*!< Called from the
+                                             timer interrupt at the expiry                          */
+
+  void                    *pContext;    /*!< User data of the callback                              */
+
+} BSP_TIMWHEEL_TimerTypeDef;
+
+/**
+  * @brief  Software timer wheel definition
+  */
+typedef struct
+{
+  TIM_HandleTypeDef       *htim;        /*!< 16-bit timer, channel 1 owned by the service           */
+
+  __IO uint32_t           High;         /*!< Counter overflows, bits 31:16 of the time              */
+
+  uint32_t                Now;          /*!< Time the wheel was advanced to                         */
+
+  uint32_t                Bitmap[BSP_TIMWHEEL_LEVELS]; /*!< Slots holding timers, one bit per slot  */
+
+  BSP_TIMWHEEL_TimerTypeDef *pSlots[BSP_TIMWHEEL_LEVELS * BSP_TIMWHEEL_SLOTS]; /*!< Timers of each slot */
+
+  BSP_TIMWHEEL_TimerTypeDef *pPending;  /*!< Timers of the slot being expired or moved down         */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TIMWHEEL_State                     */
+
+} BSP_TIMWHEEL_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Exported_Macros BSP TIMWHEEL Exported Macros
+  * @{
+  */
+#define BSP_TIMWHEEL_IS_ACTIVE(__TIMER__)        ((__TIMER__)->Slot != BSP_TIMWHEEL_SLOT_NONE)
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TIMWHEEL_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_Init(BSP_TIMWHEEL_TypeDef *hwheel, TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef BSP_TIMWHEEL_Start(BSP_TIMWHEEL_TypeDef *hwheel);
+HAL_StatusTypeDef BSP_TIMWHEEL_Stop(BSP_TIMWHEEL_TypeDef *hwheel);
+uint32_t          BSP_TIMWHEEL_GetTime(BSP_TIMWHEEL_TypeDef *hwheel);
+uint32_t          BSP_TIMWHEEL_GetIdleTime(BSP_TIMWHEEL_TypeDef *hwheel);
+HAL_StatusTypeDef BSP_TIMWHEEL_Advance(BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Ticks);
+void              BSP_TIMWHEEL_TimerInit(BSP_TIMWHEEL_TimerTypeDef *pTimer,
+                                         void (*Callback)(BSP_TIMWHEEL_TimerTypeDef *pTimer), void *pContext);
+HAL_StatusTypeDef BSP_TIMWHEEL_TimerStart(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer,
+                                          uint32_t Delay, uint32_t Period);
+void              BSP_TIMWHEEL_TimerStop(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer);
+void              BSP_TIMWHEEL_IRQHandler(BSP_TIMWHEEL_TypeDef *hwheel);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TIMWHEEL_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
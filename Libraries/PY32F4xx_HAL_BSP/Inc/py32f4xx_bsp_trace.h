@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_trace.h
+  * @author  MCU Application Team
+  * @brief   Header file of the SWO trace BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TRACE_H
+#define __PY32F4XX_BSP_TRACE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TRACE
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TRACE_Exported_Constants BSP TRACE Exported Constants
+  * @{
+  */
+#define BSP_TRACE_PORTS                 32U            /*!< ITM stimulus ports, 0 to 31                   */
+#define BSP_TRACE_PORT_STDOUT           0U             /*!< Port of BSP_TRACE_Putchar()                    */
+
+#define BSP_TRACE_PC_PERIOD_MIN         64U            /*!< Shortest PC sample period in cycles            */
+#define BSP_TRACE_PC_PERIOD_MAX         16384U         /*!< Longest PC sample period in cycles             */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TRACE_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TRACE_Init(uint32_t SwoHz);
+void              BSP_TRACE_DeInit(void);
+HAL_StatusTypeDef BSP_TRACE_EnablePort(uint32_t Port);
+HAL_StatusTypeDef BSP_TRACE_DisablePort(uint32_t Port);
+HAL_StatusTypeDef BSP_TRACE_ConfigPcSampling(uint32_t Period);
+void              BSP_TRACE_ConfigExceptions(FunctionalState NewState);
+uint32_t          BSP_TRACE_Write(uint32_t Port, const uint8_t *pData, uint32_t Length);
+int               BSP_TRACE_Putchar(int ch);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TRACE_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
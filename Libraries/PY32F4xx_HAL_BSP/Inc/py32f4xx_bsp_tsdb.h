@@ -0,0 +1,205 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_tsdb.h
+  * @author  MCU Application Team
+  * @brief   Header file of the time series store BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TSDB_H
+#define __PY32F4XX_BSP_TSDB_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+#include "py32f4xx_bsp_blkdev.h"
+#include "py32f4xx_bsp_crc.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TSDB
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TSDB_Exported_Constants BSP TSDB Exported Constants
+  * @{
+  */
+#define BSP_TSDB_MAGIC                  0x42445354U    /*!< "TSDB", first word of a block after the CRC     */
+#define BSP_TSDB_VERSION                1U             /*!< Format of the blocks                            */
+#define BSP_TSDB_COLUMNS_MAX            16U            /*!< Columns of a row, the time included             */
+#define BSP_TSDB_NO_COLUMN              0xFFFFFFFFU    /*!< Query without a value filter                    */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TSDB_Exported_Types BSP TSDB Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Block header, in the first bytes of the sector, the columns following it
+  */
+typedef struct
+{
+  uint32_t                Crc;          /*!< CRC of the bytes after it up to Size                   */
+
+  uint32_t                Magic;        /*!< BSP_TSDB_MAGIC                                         */
+
+  uint32_t                Sequence;     /*!< Blocks written before this one                         */
+
+  uint16_t                Rows;         /*!< Rows of the block                                      */
+
+  uint16_t                Size;         /*!< Bytes used, header and columns included                */
+
+  uint8_t                 Columns;      /*!< Columns of a row                                       */
+
+  uint8_t                 Version;      /*!< BSP_TSDB_VERSION                                       */
+
+  uint16_t                Reserved;     /*!< 0                                                      */
+
+} BSP_TSDB_HeaderTypeDef;
+
+/**
+  * @brief  Column entry of a block header, the index of the queries
+  */
+typedef struct
+{
+  int32_t                 Min;          /*!< Smallest value of the column in the block              */
+
+  int32_t                 Max;          /*!< Largest value of the column in the block               */
+
+  uint16_t                Offset;       /*!< Bytes from the start of the block to the column data   */
+
+  uint16_t                Length;       /*!< Bytes of the column data                               */
+
+} BSP_TSDB_ColumnTypeDef;
+
+/**
+  * @brief  Query definition
+  */
+typedef struct
+{
+  int32_t                 Start;        /*!< First time, column 0, included                         */
+
+  int32_t                 End;          /*!< Last time included                                     */
+
+  uint32_t                Column;       /*!< Column filtered, BSP_TSDB_NO_COLUMN for none           */
+
+  int32_t                 Low;          /*!< Smallest value of the filtered column kept             */
+
+  int32_t                 High;         /*!< Largest value of the filtered column kept              */
+
+} BSP_TSDB_QueryTypeDef;
+
+/**
+  * @brief  Statistics definition
+  */
+typedef struct
+{
+  uint32_t                RowsWritten;  /*!< Rows appended                                          */
+
+  uint32_t                BlocksWritten; /*!< Blocks written to the device                          */
+
+  uint32_t                RawBytes;     /*!< Bytes of the rows written as arrays of int32_t         */
+
+  uint32_t                StoredBytes;  /*!< Bytes of the blocks written, headers included         */
+
+  uint32_t                BlocksRead;   /*!< Blocks read by the queries and the mount               */
+
+  uint32_t                BlocksDecoded; /*!< Blocks decoded by the queries, the others skipped     */
+
+  uint32_t                CrcErrors;    /*!< Blocks read with a wrong CRC                           */
+
+} BSP_TSDB_StatsTypeDef;
+
+/**
+  * @brief  Time series store definition
+  */
+typedef struct
+{
+  BSP_BLKDEV_TypeDef      *hdev;        /*!< Block device, a block per sector                       */
+
+  BSP_CRC_TypeDef         *hcrcsw;      /*!< CRC of the blocks                                      */
+
+  uint32_t                FirstSector;  /*!< First sector of the store                              */
+
+  uint32_t                NbrOfSectors; /*!< Sectors of the store, used as a ring                   */
+
+  uint32_t                Columns;      /*!< Columns of a row, the time first                       */
+
+  uint8_t                 *pBlock;      /*!< A sector, word aligned, blocks built and read          */
+
+  int32_t                 *pRows;       /*!< Rows not written yet, RowsMax x Columns                */
+
+  uint32_t                RowsMax;      /*!< Rows of a block at most                                */
+
+  uint32_t                Rows;         /*!< Rows not written yet                                   */
+
+  uint32_t                Bytes;        /*!< Bytes of the columns of the rows not written yet       */
+
+  uint32_t                Head;         /*!< Sector of the ring written next                        */
+
+  uint32_t                Oldest;       /*!< Sector of the ring of the oldest block                 */
+
+  uint32_t                Count;        /*!< Blocks in the ring                                     */
+
+  uint32_t                Sequence;     /*!< Sequence of the block written next                     */
+
+  BSP_TSDB_StatsTypeDef   Stats;        /*!< Statistics                                             */
+
+} BSP_TSDB_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TSDB_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TSDB_Init(BSP_TSDB_TypeDef *htsdb, BSP_BLKDEV_TypeDef *hdev, BSP_CRC_TypeDef *hcrcsw,
+                                uint32_t FirstSector, uint32_t NbrOfSectors, uint32_t Columns,
+                                uint8_t *pBlock, int32_t *pRows, uint32_t RowsMax);
+HAL_StatusTypeDef BSP_TSDB_Append(BSP_TSDB_TypeDef *htsdb, const int32_t *pRow);
+HAL_StatusTypeDef BSP_TSDB_Flush(BSP_TSDB_TypeDef *htsdb);
+HAL_StatusTypeDef BSP_TSDB_Query(BSP_TSDB_TypeDef *htsdb, const BSP_TSDB_QueryTypeDef *pQuery,
+                                 void (*pCallback)(void *pArg, const int32_t *pRow), void *pArg);
+void              BSP_TSDB_GetStats(const BSP_TSDB_TypeDef *htsdb, BSP_TSDB_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TSDB_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ttcan.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CANFD time-triggered schedule BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_TTCAN_H
+#define __PY32F4XX_BSP_TTCAN_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_TTCAN
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_TTCAN_Exported_Constants BSP TTCAN Exported Constants
+  * @{
+  */
+#define BSP_TTCAN_CYCLES                64U            /*!< Basic cycles of the matrix cycle          */
+#define BSP_TTCAN_SLOTS                 4U             /*!< Transmit buffer slots                     */
+
+/** @defgroup BSP_TTCAN_State BSP TTCAN State
+  * @{
+  */
+#define BSP_TTCAN_STATE_RESET           0x00000000U    /*!< Not initialized                           */
+#define BSP_TTCAN_STATE_READY           0x00000001U    /*!< Schedule set, no trigger armed            */
+#define BSP_TTCAN_STATE_RUN             0x00000002U    /*!< Triggers armed one after the other        */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_TTCAN_Exported_Types BSP TTCAN Exported Types
+  * @{
+  */
+
+/**
+  * @brief  TTCAN schedule entry definition, one trigger of the matrix cycle
+  */
+typedef struct
+{
+  uint32_t                Time;         /*!< Cycle time of the trigger, 0 to 0xFFFF timestamp units
+                                             after the reference message                            */
+
+  uint32_t                TriggerType;  /*!< A value of @ref CANFD_TT_trigger_type                  */
+
+  uint32_t                Slot;         /*!< Transmit buffer slot, @ref CANFD_TT_FIFO_INDEX         */
+
+  uint32_t                BaseCycle;    /*!< First basic cycle of the entry, below Repeat           */
+
+  uint32_t                Repeat;       /*!< Basic cycles between two uses, a power of 2 up to
+                                             BSP_TTCAN_CYCLES                                       */
+
+  const CANFD_TxHeaderTypeDef *pHeader; /*!< Header of the message, transmit triggers              */
+
+  const uint8_t           *pData;       /*!< Payload, read when the message is loaded               */
+
+} BSP_TTCAN_EntryTypeDef;
+
+/**
+  * @brief  TTCAN schedule statistics definition
+  */
+typedef struct
+{
+  uint32_t                Triggers;     /*!< Triggers completed                                     */
+
+  uint32_t                Cycles;       /*!< Basic cycles completed                                 */
+
+  uint32_t                Missed;       /*!< Triggers set too late, the slot missed                 */
+
+  uint32_t                LoadErrors;   /*!< Messages not loaded, the slot still full               */
+
+  uint32_t                PeriodMin;    /*!< Shortest time between two triggers of entry 0, in CPU
+                                             cycles                                                 */
+
+  uint32_t                PeriodMax;    /*!< Longest time between two triggers of entry 0, in CPU
+                                             cycles, PeriodMax - PeriodMin for the jitter           */
+
+} BSP_TTCAN_StatsTypeDef;
+
+/**
+  * @brief  TTCAN schedule definition
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< CANFD handle, started and set by HAL_CANFD_TT_Config() */
+
+  const BSP_TTCAN_EntryTypeDef *pEntries; /*!< Entries, in the order of their time                 */
+
+  uint32_t                NbrOfEntries; /*!< Entries                                                */
+
+  uint32_t                Index;        /*!< Entry of the trigger armed                             */
+
+  uint32_t                Cycle;        /*!< Basic cycle of the trigger armed                       */
+
+  uint32_t                Stamp;        /*!< CPU cycle count of the last trigger of entry 0         */
+
+  BSP_TTCAN_StatsTypeDef  Stats;        /*!< Statistics                                             */
+
+  __IO uint32_t           State;        /*!< A value of @ref BSP_TTCAN_State                        */
+
+} BSP_TTCAN_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_TTCAN_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_TTCAN_Init(BSP_TTCAN_TypeDef *htt, CANFD_HandleTypeDef *hcanfd,
+                                 const BSP_TTCAN_EntryTypeDef *pEntries, uint32_t NbrOfEntries);
+HAL_StatusTypeDef BSP_TTCAN_Start(BSP_TTCAN_TypeDef *htt, uint32_t Cycle);
+HAL_StatusTypeDef BSP_TTCAN_Stop(BSP_TTCAN_TypeDef *htt);
+void              BSP_TTCAN_SyncCycle(BSP_TTCAN_TypeDef *htt, uint32_t Cycle);
+void              BSP_TTCAN_TrigHandler(BSP_TTCAN_TypeDef *htt);
+void              BSP_TTCAN_TrigErrorHandler(BSP_TTCAN_TypeDef *htt);
+void              BSP_TTCAN_GetStats(const BSP_TTCAN_TypeDef *htt, BSP_TTCAN_StatsTypeDef *pStats);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_TTCAN_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,116 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_uptime.h
+  * @author  MCU Application Team
+  * @brief   Header file of the RTC uptime clock BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_UPTIME_H
+#define __PY32F4XX_BSP_UPTIME_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (HAL_RTC_MODULE_ENABLED)
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_UPTIME
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_UPTIME_Exported_Constants BSP UPTIME Exported Constants
+  * @{
+  */
+#if !defined (BSP_UPTIME_BKP_EPOCH)
+#define BSP_UPTIME_BKP_EPOCH            RTC_BKP_DR42   /*!< Backup register of the counter overflows  */
+#endif
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_UPTIME_Exported_Types BSP UPTIME Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Uptime clock definition
+  */
+typedef struct
+{
+  RTC_HandleTypeDef       *hrtc;        /*!< RTC initialized, second and overflow interrupts owned
+                                             by the service                                         */
+
+  uint32_t                RtcClock;     /*!< RTC kernel clock in Hz, LSE_VALUE or LSI_VALUE         */
+
+  uint32_t                Prescaler;    /*!< RTC clock cycles per counter increment                 */
+
+  __IO uint32_t           Epoch;        /*!< Counter overflows, bits 63:32 of the count             */
+
+  __IO uint32_t           Seq;          /*!< Changed on every update of Epoch or of the edge        */
+
+  __IO uint32_t           CountEdge;    /*!< Counter value at the last second interrupt             */
+
+  __IO uint32_t           CycleEdge;    /*!< DWT cycle counter at the last second interrupt         */
+
+  uint32_t                Interp;       /*!< 1 when the cycle counter interpolates the RTC          */
+
+} BSP_UPTIME_TypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_UPTIME_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_UPTIME_Init(BSP_UPTIME_TypeDef *hup, RTC_HandleTypeDef *hrtc, uint32_t RtcClock);
+void              BSP_UPTIME_EnableInterp(BSP_UPTIME_TypeDef *hup);
+void              BSP_UPTIME_DisableInterp(BSP_UPTIME_TypeDef *hup);
+uint64_t          BSP_UPTIME_GetCycles(const BSP_UPTIME_TypeDef *hup);
+uint64_t          BSP_UPTIME_GetNs(const BSP_UPTIME_TypeDef *hup);
+uint64_t          BSP_UPTIME_GetUs(const BSP_UPTIME_TypeDef *hup);
+void              BSP_UPTIME_IRQHandler(BSP_UPTIME_TypeDef *hup);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_UPTIME_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
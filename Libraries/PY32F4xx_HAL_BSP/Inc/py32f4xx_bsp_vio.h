@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_vio.h
+  * @author  MCU Application Team
+  * @brief   Header file of the CMSIS VIO on GPIO BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_VIO_H
+#define __PY32F4XX_BSP_VIO_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+#if defined (USE_BSP_VIO) && defined (HAL_GPIO_MODULE_ENABLED)
+
+#include "cmsis_vio.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_VIO
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_VIO_Exported_Constants BSP VIO Exported Constants
+  * @{
+  */
+
+#if !defined (BSP_VIO_PORTS)
+#define BSP_VIO_PORTS                   3U             /*!< Ports of the outputs, and of the inputs, at most */
+#endif
+
+#if !defined (BSP_VIO_VALUE_NUM)
+#define BSP_VIO_VALUE_NUM               5U             /*!< Values of vioSetValue() and vioGetValue()         */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_VIO_Exported_Functions
+  * @{
+  */
+HAL_StatusTypeDef BSP_VIO_AddOutput(GPIO_TypeDef *GPIOx, uint32_t Pins, uint32_t ActiveLow, uint32_t Signals);
+HAL_StatusTypeDef BSP_VIO_AddInput(GPIO_TypeDef *GPIOx, uint32_t Pins, uint32_t ActiveLow, uint32_t Signals);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_VIO && HAL_GPIO_MODULE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_VIO_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
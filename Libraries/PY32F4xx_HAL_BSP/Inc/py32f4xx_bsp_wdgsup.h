@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_wdgsup.h
+  * @author  MCU Application Team
+  * @brief   Header file of the watchdog supervisor BSP service.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PY32F4XX_BSP_WDGSUP_H
+#define __PY32F4XX_BSP_WDGSUP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @addtogroup BSP_WDGSUP
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup BSP_WDGSUP_Exported_Constants BSP WDGSUP Exported Constants
+  * @{
+  */
+#if !defined (BSP_WDGSUP_TASKS)
+#define BSP_WDGSUP_TASKS                8U             /*!< Tasks supervised at most, up to 31           */
+#endif /* BSP_WDGSUP_TASKS */
+
+#define BSP_WDGSUP_STALLED_PROCESS      0x80000000U    /*!< Stall mask bit, BSP_WDGSUP_Process() not run */
+/**
+  * @}
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup BSP_WDGSUP_Exported_Types BSP WDGSUP Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Supervised task definition
+  */
+typedef struct
+{
+  const char              *pName;       /*!< Task name, a string constant kept by reference         */
+
+  uint32_t                Deadline;     /*!< Milliseconds allowed between heartbeats, 0 paused      */
+
+  __IO uint32_t           Last;         /*!< HAL_GetTick() of the last heartbeat                    */
+
+  __IO uint32_t           Beats;        /*!< Heartbeats received, wrapping                          */
+
+  __IO uint32_t           MaxGap;       /*!< Longest time between two heartbeats, in ms             */
+
+} BSP_WDGSUP_TaskTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup BSP_WDGSUP_Exported_Functions
+  * @{
+  */
+void              BSP_WDGSUP_Init(void);
+#if defined (HAL_IWDG_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_WDGSUP_AttachIwdg(IWDG_HandleTypeDef *hiwdg);
+#endif /* HAL_IWDG_MODULE_ENABLED */
+#if defined (HAL_WWDG_MODULE_ENABLED)
+HAL_StatusTypeDef BSP_WDGSUP_AttachWwdg(WWDG_HandleTypeDef *hwwdg);
+#endif /* HAL_WWDG_MODULE_ENABLED */
+HAL_StatusTypeDef BSP_WDGSUP_Register(const char *pName, uint32_t Deadline, uint32_t *pId);
+HAL_StatusTypeDef BSP_WDGSUP_SetDeadline(uint32_t Id, uint32_t Deadline);
+void              BSP_WDGSUP_Heartbeat(uint32_t Id);
+uint32_t          BSP_WDGSUP_Process(void);
+uint32_t          BSP_WDGSUP_GetStalled(void);
+const BSP_WDGSUP_TaskTypeDef *BSP_WDGSUP_GetTask(uint32_t Id);
+void              BSP_WDGSUP_Print(void);
+#if defined (HAL_WWDG_MODULE_ENABLED)
+void              BSP_WDGSUP_EwiCallback(WWDG_HandleTypeDef *hwwdg);
+#endif /* HAL_WWDG_MODULE_ENABLED */
+void              BSP_WDGSUP_StallCallback(uint32_t Stalled);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PY32F4XX_BSP_WDGSUP_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
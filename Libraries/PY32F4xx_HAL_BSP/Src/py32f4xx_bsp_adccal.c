@@ -0,0 +1,375 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adccal.c
+  * @author  MCU Application Team
+  * @brief   ADC calibration cache BSP service.
+  *          This file provides functions to shorten the ADC calibration of
+  *          the warm boots:
+  *           + Full calibration codes kept per temperature band
+  *           + Records in the backup registers, lost on a backup domain reset
+  *           + Quick calibration accepted when it matches the record
+  *           + Age limit forcing a periodic full calibration
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The ADC has no register to load calibration codes: CALRR1 and CALRR2
+       only give the result, and a reset clears the calibration. A boot always
+       calibrates, the cache chooses between the full calibration and the
+       quick one, with the shortest calibration sampling time, checked
+       against the codes of the last full calibration in the same band.
+
+   (#) Initialize the ADC with HAL_ADC_Init() and the RTC with HAL_RTC_Init(),
+       and fill a BSP_ADCCAL_InitTypeDef: the backup registers of the records,
+       the temperature bands, the settings of the full calibration, the
+       warm boots a record is reused and the code tolerance. Call
+       BSP_ADCCAL_Init(), it enables the backup domain access.
+
+   (#) Call BSP_ADCCAL_Calibrate() in place of HAL_ADCEx_Calibration_Start(),
+       ADC disabled, with the band of the die temperature, read for instance
+       from the temperature sensor before the calibration. Without a valid
+       record for the band and settings, or with a record MaxAge boots old,
+       it runs the full calibration and stores its codes. Otherwise it runs
+       the quick calibration and keeps it when each code is within Tolerance
+       of the record, else it runs the full calibration. Source tells which
+       calibration the ADC holds.
+
+   (#) The records survive the resets while VDD or VBAT is kept; a power-on
+       without VBAT, BSP_ADCCAL_Invalidate() or a backup domain reset leads
+       to full calibrations. With a full calibration at the shortest
+       sampling time the quick calibration takes the same time.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adccal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCCAL BSP ADCCAL
+  * @brief ADC calibration cache BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_RTC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Private_Types BSP ADCCAL Private Types
+  * @{
+  */
+/* Band record, one backup register per word */
+typedef struct
+{
+  uint32_t Tag;                         /* Magic, band and calibration settings                     */
+  uint32_t Age;                         /* Warm boots since the full calibration                    */
+  uint32_t Codes[4];                    /* CALRR1 then CALRR2, 16 bits per word                     */
+  uint32_t Check;                       /* Inverted XOR of the other words                          */
+} ADCCAL_RecordTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Private_Constants BSP ADCCAL Private Constants
+  * @{
+  */
+#define ADCCAL_MAGIC                    0xAC00U        /* Tag bits 8 to 15                          */
+#define ADCCAL_CALRR1_CODES             0x00FFFFFFU    /* CALBOUT, CALC11OUT and CALC10OUT          */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Private_Functions BSP ADCCAL Private Functions
+  * @{
+  */
+static uint32_t ADCCAL_Register(uint32_t Slot);
+static uint32_t ADCCAL_Tag(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band);
+static uint32_t ADCCAL_Check(const ADCCAL_RecordTypeDef *pRecord);
+static uint32_t ADCCAL_Load(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band, ADCCAL_RecordTypeDef *pRecord);
+static void     ADCCAL_Store(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band, ADCCAL_RecordTypeDef *pRecord);
+static HAL_StatusTypeDef ADCCAL_Run(BSP_ADCCAL_TypeDef *hcal, uint32_t CalibSamplingTime);
+static uint32_t ADCCAL_Match(const BSP_ADCCAL_TypeDef *hcal, const ADCCAL_RecordTypeDef *pRecord);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCCAL_Exported_Functions BSP ADCCAL Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize an ADC calibration cache.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  hadc ADC handle, initialized.
+  * @param  hrtc RTC handle, initialized.
+  * @param  pInit Cache configuration.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCCAL_Init(BSP_ADCCAL_TypeDef *hcal, ADC_HandleTypeDef *hadc, RTC_HandleTypeDef *hrtc,
+                                  const BSP_ADCCAL_InitTypeDef *pInit)
+{
+  if ((hcal == NULL) || (hadc == NULL) || (hrtc == NULL) || (pInit == NULL) ||
+      (pInit->Bands == 0U) || (pInit->Bands > BSP_ADCCAL_BANDS_MAX) ||
+      (pInit->FirstSlot > BSP_ADCCAL_SLOTS) ||
+      ((pInit->Bands * BSP_ADCCAL_RECORD_SLOTS) > (BSP_ADCCAL_SLOTS - pInit->FirstSlot)) ||
+      (pInit->MaxAge == 0U) || (pInit->MaxAge > 0xFFFFU) ||
+      ((pInit->CalibSamplingTime & ~ADC_CCSR_CALSMP) != 0U) ||
+      ((pInit->CalibSelection & ~ADC_CCSR_CALSEL) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hcal->hadc     = hadc;
+  hcal->hrtc     = hrtc;
+  hcal->Init     = *pInit;
+  hcal->Source   = BSP_ADCCAL_SOURCE_NONE;
+  hcal->Age      = 0U;
+  hcal->Codes[0] = 0U;
+  hcal->Codes[1] = 0U;
+
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_BKP_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Calibrate the ADC, reusing the record of the band when it is valid.
+  * @note   The ADC is left disabled, as HAL_ADCEx_Calibration_SetAndStart() does.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  Band Temperature band, 0 to Bands - 1.
+  * @retval HAL status, HAL_ERROR when the full calibration fails
+  */
+HAL_StatusTypeDef BSP_ADCCAL_Calibrate(BSP_ADCCAL_TypeDef *hcal, uint32_t Band)
+{
+  ADCCAL_RecordTypeDef record;
+
+  if (Band >= hcal->Init.Bands)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Warm boot: quick calibration checked against the record */
+  if ((ADCCAL_Load(hcal, Band, &record) != 0U) && (record.Age < hcal->Init.MaxAge))
+  {
+    if ((ADCCAL_Run(hcal, ADC_CALIBSAMPLETIME_1CYCLE) == HAL_OK) && (ADCCAL_Match(hcal, &record) != 0U))
+    {
+      record.Age++;
+      ADCCAL_Store(hcal, Band, &record);
+      hcal->Source = BSP_ADCCAL_SOURCE_REUSED;
+      hcal->Age    = record.Age;
+      return HAL_OK;
+    }
+  }
+
+  hcal->Source = BSP_ADCCAL_SOURCE_NONE;
+  if (ADCCAL_Run(hcal, hcal->Init.CalibSamplingTime) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  record.Tag      = ADCCAL_Tag(hcal, Band);
+  record.Age      = 0U;
+  record.Codes[0] = hcal->Codes[0] & 0xFFFFU;
+  record.Codes[1] = hcal->Codes[0] >> 16;
+  record.Codes[2] = hcal->Codes[1] & 0xFFFFU;
+  record.Codes[3] = hcal->Codes[1] >> 16;
+  ADCCAL_Store(hcal, Band, &record);
+  hcal->Source = BSP_ADCCAL_SOURCE_FULL;
+  hcal->Age    = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Clear the records of all the bands, the next calibrations are full ones.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCCAL_Invalidate(BSP_ADCCAL_TypeDef *hcal)
+{
+  uint32_t slot;
+  uint32_t last = hcal->Init.FirstSlot + (hcal->Init.Bands * BSP_ADCCAL_RECORD_SLOTS);
+
+  for (slot = hcal->Init.FirstSlot; slot < last; slot++)
+  {
+    HAL_RTCEx_BKUPWrite(hcal->hrtc, ADCCAL_Register(slot), 0U);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCCAL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Backup register of a slot, DR11 following DR10 at a gap.
+  * @param  Slot Backup register index, 0 to BSP_ADCCAL_SLOTS - 1.
+  * @retval A value of @ref RTCEx_Backup_Registers_Definitions
+  */
+static uint32_t ADCCAL_Register(uint32_t Slot)
+{
+  return (Slot < 10U) ? (RTC_BKP_DR1 + Slot) : (RTC_BKP_DR11 + (Slot - 10U));
+}
+
+/**
+  * @brief  Tag of a record, changed with the band or the calibration settings.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  Band Temperature band.
+  * @retval Tag
+  */
+static uint32_t ADCCAL_Tag(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band)
+{
+  return ADCCAL_MAGIC | (Band << 4) |
+         ((hcal->Init.CalibSelection != 0U) ? 0x4U : 0x0U) |
+         (hcal->Init.CalibSamplingTime >> ADC_CCSR_CALSMP_Pos);
+}
+
+/**
+  * @brief  Check word of a record.
+  * @param  pRecord Record, its Check is ignored.
+  * @retval Check word
+  */
+static uint32_t ADCCAL_Check(const ADCCAL_RecordTypeDef *pRecord)
+{
+  return ~(pRecord->Tag ^ pRecord->Age ^ pRecord->Codes[0] ^ pRecord->Codes[1] ^
+           pRecord->Codes[2] ^ pRecord->Codes[3]) & 0xFFFFU;
+}
+
+/**
+  * @brief  Read the record of a band.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  Band Temperature band.
+  * @param  pRecord Record read.
+  * @retval 1 when the record is valid for the band and the settings, 0 otherwise
+  */
+static uint32_t ADCCAL_Load(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band, ADCCAL_RecordTypeDef *pRecord)
+{
+  uint32_t *pWord = (uint32_t *)pRecord;
+  uint32_t slot = hcal->Init.FirstSlot + (Band * BSP_ADCCAL_RECORD_SLOTS);
+  uint32_t i;
+
+  for (i = 0U; i < BSP_ADCCAL_RECORD_SLOTS; i++)
+  {
+    pWord[i] = HAL_RTCEx_BKUPRead(hcal->hrtc, ADCCAL_Register(slot + i));
+  }
+
+  return ((pRecord->Tag == ADCCAL_Tag(hcal, Band)) && (pRecord->Check == ADCCAL_Check(pRecord))) ? 1U : 0U;
+}
+
+/**
+  * @brief  Write the record of a band.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  Band Temperature band.
+  * @param  pRecord Record, its Check is computed.
+  * @retval None
+  */
+static void ADCCAL_Store(const BSP_ADCCAL_TypeDef *hcal, uint32_t Band, ADCCAL_RecordTypeDef *pRecord)
+{
+  const uint32_t *pWord = (const uint32_t *)pRecord;
+  uint32_t slot = hcal->Init.FirstSlot + (Band * BSP_ADCCAL_RECORD_SLOTS);
+  uint32_t i;
+
+  pRecord->Check = ADCCAL_Check(pRecord);
+  for (i = 0U; i < BSP_ADCCAL_RECORD_SLOTS; i++)
+  {
+    HAL_RTCEx_BKUPWrite(hcal->hrtc, ADCCAL_Register(slot + i), pWord[i]);
+  }
+}
+
+/**
+  * @brief  Run a calibration and read its codes.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  CalibSamplingTime A value of @ref ADC_Calibration_sampling_times.
+  * @retval HAL status, HAL_ERROR when the calibration does not succeed
+  */
+static HAL_StatusTypeDef ADCCAL_Run(BSP_ADCCAL_TypeDef *hcal, uint32_t CalibSamplingTime)
+{
+  if (HAL_ADCEx_Calibration_SetAndStart(hcal->hadc, CalibSamplingTime, hcal->Init.CalibSelection) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (HAL_ADCEx_Calibration_GetStatus(hcal->hadc) != HAL_ADCCALIBOK)
+  {
+    return HAL_ERROR;
+  }
+
+  hcal->Codes[0] = hcal->hadc->Instance->CALRR1 & ADCCAL_CALRR1_CODES;
+  hcal->Codes[1] = hcal->hadc->Instance->CALRR2;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Compare the codes of the last calibration with a record.
+  * @param  hcal Pointer to a BSP_ADCCAL_TypeDef structure.
+  * @param  pRecord Record of the band.
+  * @retval 1 when each 8-bit code is within Tolerance, 0 otherwise
+  */
+static uint32_t ADCCAL_Match(const BSP_ADCCAL_TypeDef *hcal, const ADCCAL_RecordTypeDef *pRecord)
+{
+  uint32_t stored[2];
+  uint32_t i;
+  uint32_t shift;
+  int32_t  delta;
+
+  stored[0] = pRecord->Codes[0] | (pRecord->Codes[1] << 16);
+  stored[1] = pRecord->Codes[2] | (pRecord->Codes[3] << 16);
+
+  for (i = 0U; i < 2U; i++)
+  {
+    for (shift = 0U; shift < 32U; shift += 8U)
+    {
+      delta = (int32_t)((hcal->Codes[i] >> shift) & 0xFFU) - (int32_t)((stored[i] >> shift) & 0xFFU);
+      if ((uint32_t)((delta < 0) ? -delta : delta) > hcal->Init.Tolerance)
+      {
+        return 0U;
+      }
+    }
+  }
+
+  return 1U;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_RTC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,313 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcmon.c
+  * @author  MCU Application Team
+  * @brief   ADC internal channel monitor BSP service.
+  *          This file provides functions to follow the temperature sensor and
+  *          VREFINT of ADC1 in the background:
+  *           + Injected sequence of both channels at a low rate
+  *           + Averaged results and scale cached at each sequence
+  *           + Reads of VDDA and of the temperature without conversion
+  *           + VREFINT compensated conversion of other channels in bulk
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize ADC1 with HAL_ADC_Init(), ScanConvMode enabled: the
+       injected group converts two ranks. The regular group stays free for
+       the application, an injected sequence delays its conversion in
+       progress by the two samplings. Enable ADC1_2_IRQn and call
+       HAL_ADC_IRQHandler() from ADC1_2_IRQHandler().
+
+   (#) Fill a BSP_ADCMON_InitTypeDef from the datasheet: VREFINT voltage,
+       sensor voltage at a reference temperature and its slope, and call
+       BSP_ADCMON_Init(). Rank 1 of the injected group is the temperature
+       sensor, rank 2 VREFINT, both at SamplingTime.
+
+   (#) Call BSP_ADCMON_InjectedConvCpltCallback() from
+       HAL_ADCEx_InjectedConvCpltCallback() for ADC1. The sequences are
+       started by the injected trigger of the Init, a timer at the monitoring
+       rate, after BSP_ADCMON_Start(). With ADC_INJECTED_SOFTWARE_START each
+       BSP_ADCMON_Trigger(), from a periodic task or the SysTick, starts one
+       sequence: it returns at once, HAL_BUSY while the last one converts.
+
+   (#) Each sequence updates the exponential averages of both codes, weight
+       2^-FilterShift, then the cached results: Scale, the mV of one code
+       from VDDA = VrefIntMv x 4095 / VREFINT code, VddaMv and Temperature,
+       and calls BSP_ADCMON_UpdateCallback(). The first sequence seeds the
+       averages, the results are 0 before it.
+
+   (#) BSP_ADCMON_GET_VDDA() and BSP_ADCMON_GET_TEMPERATURE() read the cached
+       results, BSP_ADCMON_TO_MV() converts one code of another channel.
+       BSP_ADCMON_ToMillivolts() converts a block of codes, a DMA buffer of
+       the regular group, with one Scale for the whole block.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adcmon.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCMON BSP ADCMON
+  * @brief ADC internal channel monitor BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCMON_Private_Constants BSP ADCMON Private Constants
+  * @{
+  */
+#define ADCMON_FULL_SCALE               4095U          /* Code of VDDA */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCMON_Exported_Functions BSP ADCMON Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the monitor and configure the injected group of ADC1.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @param  hadc ADC1 handle, initialized, scan mode enabled.
+  * @param  pInit Configuration.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCMON_Init(BSP_ADCMON_TypeDef *hmon, ADC_HandleTypeDef *hadc,
+                                  const BSP_ADCMON_InitTypeDef *pInit)
+{
+  ADC_InjectionConfTypeDef sInjected = {0};
+
+  if ((hmon == NULL) || (hadc == NULL) || (pInit == NULL) || (hadc->Instance != ADC1) ||
+      (hadc->Init.ScanConvMode == ADC_SCAN_DISABLE) || (pInit->VrefIntMv == 0U) ||
+      (pInit->TempSlopeUv == 0) || (pInit->FilterShift > BSP_ADCMON_FILTER_SHIFT_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hmon->State == BSP_ADCMON_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The ADC internal path is enabled by the configuration of the channels */
+  sInjected.InjectedSamplingTime          = pInit->SamplingTime;
+  sInjected.InjectedOffset                = 0U;
+  sInjected.InjectedNbrOfConversion       = 2U;
+  sInjected.InjectedDiscontinuousConvMode = DISABLE;
+  sInjected.AutoInjectedConv              = DISABLE;
+  sInjected.ExternalTrigInjecConv         = pInit->ExternalTrigInjecConv;
+  sInjected.InjectedChannel               = ADC_CHANNEL_TEMPSENSOR;
+  sInjected.InjectedRank                  = ADC_INJECTED_RANK_1;
+  if (HAL_ADCEx_InjectedConfigChannel(hadc, &sInjected) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  sInjected.InjectedChannel               = ADC_CHANNEL_VREFINT;
+  sInjected.InjectedRank                  = ADC_INJECTED_RANK_2;
+  if (HAL_ADCEx_InjectedConfigChannel(hadc, &sInjected) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hmon->hadc        = hadc;
+  hmon->Init        = *pInit;
+  hmon->TempAcc     = 0U;
+  hmon->VrefAcc     = 0U;
+  hmon->Scale       = 0U;
+  hmon->VddaMv      = 0U;
+  hmon->Temperature = 0;
+  hmon->Sequences   = 0U;
+  hmon->State       = BSP_ADCMON_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the injected sequences, on each trigger of the Init.
+  * @note   With ADC_INJECTED_SOFTWARE_START the first sequence is started.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCMON_Start(BSP_ADCMON_TypeDef *hmon)
+{
+  if (hmon->State != BSP_ADCMON_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hmon->State = BSP_ADCMON_STATE_RUN;
+  if (HAL_ADCEx_InjectedStart_IT(hmon->hadc) != HAL_OK)
+  {
+    hmon->State = BSP_ADCMON_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the injected sequences, the cached results are kept.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCMON_Stop(BSP_ADCMON_TypeDef *hmon)
+{
+  if (hmon->State != BSP_ADCMON_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The regular group, if converting, keeps the ADC enabled */
+  __HAL_ADC_DISABLE_IT(hmon->hadc, ADC_IT_JEOC);
+  CLEAR_BIT(hmon->hadc->Instance->CR2, ADC_CR2_JEXTTRIG);
+  CLEAR_BIT(hmon->hadc->State, HAL_ADC_STATE_INJ_BUSY);
+  hmon->State = BSP_ADCMON_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start one sequence, software trigger of the Init.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @retval HAL status, HAL_BUSY while the previous sequence converts
+  */
+HAL_StatusTypeDef BSP_ADCMON_Trigger(BSP_ADCMON_TypeDef *hmon)
+{
+  if ((hmon->State != BSP_ADCMON_STATE_RUN) ||
+      (hmon->Init.ExternalTrigInjecConv != ADC_INJECTED_SOFTWARE_START))
+  {
+    return HAL_ERROR;
+  }
+
+  /* JEOC stays enabled up to the end of the sequence started before */
+  if (__HAL_ADC_GET_IT_SOURCE(hmon->hadc, ADC_IT_JEOC) != RESET)
+  {
+    return HAL_BUSY;
+  }
+
+  return HAL_ADCEx_InjectedStart_IT(hmon->hadc);
+}
+
+/**
+  * @brief  Convert a block of codes to mV with the cached scale.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @param  pSrc Codes of the ADC, right aligned.
+  * @param  pDst Voltages in mV, pSrc allowed.
+  * @param  Count Codes.
+  * @retval None
+  */
+void BSP_ADCMON_ToMillivolts(const BSP_ADCMON_TypeDef *hmon, const uint16_t *pSrc, uint16_t *pDst,
+                             uint32_t Count)
+{
+  /* One scale for the whole block, even when a sequence ends meanwhile */
+  uint32_t scale = hmon->Scale;
+  uint32_t i;
+
+  for (i = 0U; i < Count; i++)
+  {
+    pDst[i] = (uint16_t)((((uint32_t)pSrc[i] * scale) + 0x8000U) >> 16);
+  }
+}
+
+/**
+  * @brief  Injected sequence complete, to call from HAL_ADCEx_InjectedConvCpltCallback().
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @retval None
+  */
+void BSP_ADCMON_InjectedConvCpltCallback(BSP_ADCMON_TypeDef *hmon)
+{
+  uint32_t shift = hmon->Init.FilterShift;
+  uint32_t temp = HAL_ADCEx_InjectedGetValue(hmon->hadc, ADC_INJECTED_RANK_1);
+  uint32_t vref = HAL_ADCEx_InjectedGetValue(hmon->hadc, ADC_INJECTED_RANK_2);
+  uint32_t scale;
+  int32_t sense;
+
+  if (hmon->State != BSP_ADCMON_STATE_RUN)
+  {
+    return;
+  }
+
+  if (hmon->Sequences == 0U)
+  {
+    hmon->TempAcc = temp << shift;
+    hmon->VrefAcc = vref << shift;
+  }
+  else
+  {
+    hmon->TempAcc += temp - (hmon->TempAcc >> shift);
+    hmon->VrefAcc += vref - (hmon->VrefAcc >> shift);
+  }
+  hmon->Sequences++;
+  if (hmon->VrefAcc == 0U)
+  {
+    return;
+  }
+
+  /* mV per code, 16.16: VrefIntMv / average VREFINT code */
+  scale = (uint32_t)(((uint64_t)hmon->Init.VrefIntMv << (16U + shift)) / hmon->VrefAcc);
+  sense = (int32_t)(((uint64_t)hmon->TempAcc * scale * 1000U) >> (16U + shift));
+
+  hmon->Scale       = scale;
+  hmon->VddaMv      = ((scale * ADCMON_FULL_SCALE) + 0x8000U) >> 16;
+  hmon->Temperature = hmon->Init.TempRef +
+                      (((sense - (int32_t)hmon->Init.TempRefUv) * 100) / hmon->Init.TempSlopeUv);
+
+  BSP_ADCMON_UpdateCallback(hmon);
+}
+
+/**
+  * @brief  Update callback, the cached results of a new sequence are ready.
+  * @param  hmon Pointer to a BSP_ADCMON_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCMON_UpdateCallback(BSP_ADCMON_TypeDef *hmon)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hmon);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCMON_UpdateCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
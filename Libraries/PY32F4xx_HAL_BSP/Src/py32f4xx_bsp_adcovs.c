@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcovs.c
+  * @author  MCU Application Team
+  * @brief   ADC oversampling BSP service.
+  *          This file provides functions to trade the bandwidth of an ADC
+  *          channel for resolution:
+  *           + Circular DMA of the conversions, processed at half and full
+  *           + Boxcar or second order CIC decimation with the DSP instructions
+  *           + Decimated samples in a ring buffer
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ADC with HAL_ADC_Init() on one regular channel, in
+       continuous mode or on a timer trigger, and link a DMA channel to it:
+       peripheral to memory, halfwords on both sides, memory increment and
+       DMA_CIRCULAR, its interrupt enabled in the NVIC.
+
+   (#) Call BSP_ADCOVS_Init() with a DMA buffer, the decimation Ratio, the
+       output Shift, the filter and a ring buffer for the output:
+       (+) BSP_ADCOVS_FILTER_BOXCAR sums Ratio samples: b extra bits need
+           Ratio = 4^b, the sum then has 12 + 2b bits, Shift = b leaves
+           12 + b. 16 extra fold of the rate gives 14 bits, 256 fold 16 bits.
+       (+) BSP_ADCOVS_FILTER_CIC2 weights two windows with a triangle, the
+           gain is Ratio x Ratio and the alias rejection better. The first
+           output is dropped while the filter fills.
+       The output must fit in 16 bits: Init refuses a Shift too small for
+       the gain, and a Ratio above 1024 for the CIC2.
+
+   (#) Call BSP_ADCOVS_ConvHalfCpltCallback() from HAL_ADC_ConvHalfCpltCallback()
+       and BSP_ADCOVS_ConvCpltCallback() from HAL_ADC_ConvCpltCallback(). Each
+       half of the DMA buffer is filtered while the DMA fills the other one,
+       two samples per __SMLAD: the CPU load does not depend on the Ratio.
+
+   (#) BSP_ADCOVS_Start() runs the conversions, BSP_ADCOVS_Read() takes the
+       decimated samples from the ring in thread mode. The callbacks count in
+       Overruns the samples the ring had no room for.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adcovs.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCOVS BSP ADCOVS
+  * @brief ADC oversampling BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCOVS_Private_Constants BSP ADCOVS Private Constants
+  * @{
+  */
+#define ADCOVS_SAMPLE_MAX               0x0FFFU        /* 12-bit conversions                          */
+#define ADCOVS_ONES                     0x00010001U    /* __SMLAD weights of a plain sum              */
+#define ADCOVS_RANKS_FIRST              0x00010000U    /* Ranks 0 and 1 of a window                   */
+#define ADCOVS_RANKS_STEP               0x00020002U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCOVS_Private_Functions BSP ADCOVS Private Functions
+  * @{
+  */
+static void ADCOVS_Reset(BSP_ADCOVS_TypeDef *hovs);
+static void ADCOVS_Process(BSP_ADCOVS_TypeDef *hovs, const uint16_t *pData, uint32_t Length);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCOVS_Exported_Functions BSP ADCOVS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize an oversampling engine.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @param  hadc ADC handle, initialized, DMA linked.
+  * @param  pDmaBuffer DMA buffer of DmaLength halfwords, word aligned.
+  * @param  DmaLength Samples in the DMA buffer, a multiple of 4 up to 0xFFFC.
+  * @param  Ratio Input samples per output sample, even.
+  * @param  Shift Right shift of the filter output.
+  * @param  Filter A value of @ref BSP_ADCOVS_Filter.
+  * @param  pRing Output ring storage.
+  * @param  RingSize Output ring size in samples, a power of two.
+  * @retval HAL status, HAL_ERROR when the output does not fit in 16 bits
+  */
+HAL_StatusTypeDef BSP_ADCOVS_Init(BSP_ADCOVS_TypeDef *hovs, ADC_HandleTypeDef *hadc,
+                                  uint16_t *pDmaBuffer, uint32_t DmaLength,
+                                  uint32_t Ratio, uint32_t Shift, uint32_t Filter,
+                                  uint16_t *pRing, uint32_t RingSize)
+{
+  uint64_t peak;
+
+  if ((hovs == NULL) || (hadc == NULL) || (hadc->DMA_Handle == NULL) ||
+      (pDmaBuffer == NULL) || (((uint32_t)pDmaBuffer & 3U) != 0U) ||
+      (DmaLength == 0U) || ((DmaLength & 3U) != 0U) || (DmaLength > 0xFFFFU) ||
+      (Ratio < 2U) || ((Ratio & 1U) != 0U) || (Shift > 31U) ||
+      ((Filter != BSP_ADCOVS_FILTER_BOXCAR) && (Filter != BSP_ADCOVS_FILTER_CIC2)) ||
+      (pRing == NULL) || (RingSize < 2U) || ((RingSize & (RingSize - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The filter runs modulo 2^32, its peak output must fit */
+  peak = (uint64_t)ADCOVS_SAMPLE_MAX * Ratio;
+  if (Filter == BSP_ADCOVS_FILTER_CIC2)
+  {
+    peak *= Ratio;
+  }
+  if ((peak > 0xFFFFFFFFU) || ((peak >> Shift) > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  hovs->hadc       = hadc;
+  hovs->pDmaBuffer = pDmaBuffer;
+  hovs->DmaLength  = DmaLength;
+  hovs->Ratio      = Ratio;
+  hovs->Shift      = Shift;
+  hovs->Filter     = Filter;
+  hovs->pRing      = pRing;
+  hovs->RingSize   = RingSize;
+  ADCOVS_Reset(hovs);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the conversions.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCOVS_Start(BSP_ADCOVS_TypeDef *hovs)
+{
+  ADCOVS_Reset(hovs);
+
+  return HAL_ADC_Start_DMA(hovs->hadc, (uint32_t *)hovs->pDmaBuffer, hovs->DmaLength);
+}
+
+/**
+  * @brief  Stop the conversions, the ring keeps the samples not read.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCOVS_Stop(BSP_ADCOVS_TypeDef *hovs)
+{
+  return HAL_ADC_Stop_DMA(hovs->hadc);
+}
+
+/**
+  * @brief  Get the number of decimated samples in the ring.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval Number of samples
+  */
+uint32_t BSP_ADCOVS_GetCount(const BSP_ADCOVS_TypeDef *hovs)
+{
+  return hovs->Head - hovs->Tail;
+}
+
+/**
+  * @brief  Read decimated samples from the ring.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @param  pDst Destination of up to Count halfwords.
+  * @param  Count Maximum number of samples.
+  * @retval Number of samples read
+  */
+uint32_t BSP_ADCOVS_Read(BSP_ADCOVS_TypeDef *hovs, uint16_t *pDst, uint32_t Count)
+{
+  uint32_t tail = hovs->Tail;
+  uint32_t available = hovs->Head - tail;
+  uint32_t i;
+
+  if (Count > available)
+  {
+    Count = available;
+  }
+  for (i = 0U; i < Count; i++)
+  {
+    pDst[i] = hovs->pRing[(tail + i) & (hovs->RingSize - 1U)];
+  }
+  hovs->Tail = tail + Count;
+
+  return Count;
+}
+
+/**
+  * @brief  Filter the first half of the DMA buffer.
+  * @note   Call from HAL_ADC_ConvHalfCpltCallback().
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval None
+  */
+void BSP_ADCOVS_ConvHalfCpltCallback(BSP_ADCOVS_TypeDef *hovs)
+{
+  ADCOVS_Process(hovs, hovs->pDmaBuffer, hovs->DmaLength / 2U);
+}
+
+/**
+  * @brief  Filter the second half of the DMA buffer.
+  * @note   Call from HAL_ADC_ConvCpltCallback().
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval None
+  */
+void BSP_ADCOVS_ConvCpltCallback(BSP_ADCOVS_TypeDef *hovs)
+{
+  ADCOVS_Process(hovs, &hovs->pDmaBuffer[hovs->DmaLength / 2U], hovs->DmaLength / 2U);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCOVS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Clear the filter and the ring.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @retval None
+  */
+static void ADCOVS_Reset(BSP_ADCOVS_TypeDef *hovs)
+{
+  hovs->Count    = 0U;
+  hovs->Sum      = 0U;
+  hovs->Ramp     = 0U;
+  hovs->Weights  = ADCOVS_RANKS_FIRST;
+  hovs->PrevRamp = 0U;
+  hovs->Warmup   = (hovs->Filter == BSP_ADCOVS_FILTER_CIC2) ? 1U : 0U;
+  hovs->Head     = 0U;
+  hovs->Tail     = 0U;
+  hovs->Overruns = 0U;
+}
+
+/**
+  * @brief  Filter and decimate conversions.
+  * @note   The CIC2 output of a window of rank t samples x(t), t = 0 to
+  *         Ratio - 1, is Ratio x Sum + PrevRamp - Ramp, with Sum the sum of
+  *         x(t) and Ramp the sum of t x x(t): the triangle 1, 2 .. Ratio .. 1
+  *         over this window and the previous one. Both sums take two samples
+  *         per __SMLAD, the ranks stepping by two with __SADD16.
+  * @param  hovs Pointer to a BSP_ADCOVS_TypeDef structure.
+  * @param  pData Conversions, word aligned.
+  * @param  Length Number of conversions, even.
+  * @retval None
+  */
+static void ADCOVS_Process(BSP_ADCOVS_TypeDef *hovs, const uint16_t *pData, uint32_t Length)
+{
+  const uint32_t *pPair = (const uint32_t *)pData;
+  uint32_t pairs = Length / 2U;
+  uint32_t count = hovs->Count;
+  uint32_t sum = hovs->Sum;
+  uint32_t ramp = hovs->Ramp;
+  uint32_t weights = hovs->Weights;
+  uint32_t take;
+  uint32_t pair;
+  uint32_t output;
+  uint32_t head;
+
+  while (pairs > 0U)
+  {
+    take = (hovs->Ratio - count) / 2U;
+    if (take > pairs)
+    {
+      take = pairs;
+    }
+    pairs -= take;
+    count += 2U * take;
+
+    if (hovs->Filter == BSP_ADCOVS_FILTER_BOXCAR)
+    {
+      while (take > 0U)
+      {
+        sum = __SMLAD(*pPair++, ADCOVS_ONES, sum);
+        take--;
+      }
+    }
+    else
+    {
+      while (take > 0U)
+      {
+        pair    = *pPair++;
+        sum     = __SMLAD(pair, ADCOVS_ONES, sum);
+        ramp    = __SMLAD(pair, weights, ramp);
+        weights = __SADD16(weights, ADCOVS_RANKS_STEP);
+        take--;
+      }
+    }
+
+    if (count == hovs->Ratio)
+    {
+      if (hovs->Filter == BSP_ADCOVS_FILTER_BOXCAR)
+      {
+        output = sum;
+      }
+      else
+      {
+        output = (hovs->Ratio * sum) + hovs->PrevRamp - ramp;
+        hovs->PrevRamp = ramp;
+      }
+
+      if (hovs->Warmup > 0U)
+      {
+        hovs->Warmup--;
+      }
+      else
+      {
+        head = hovs->Head;
+        if ((head - hovs->Tail) >= hovs->RingSize)
+        {
+          hovs->Overruns++;
+        }
+        else
+        {
+          hovs->pRing[head & (hovs->RingSize - 1U)] = (uint16_t)(output >> hovs->Shift);
+          hovs->Head = head + 1U;
+        }
+      }
+
+      count   = 0U;
+      sum     = 0U;
+      ramp    = 0U;
+      weights = ADCOVS_RANKS_FIRST;
+    }
+  }
+
+  hovs->Count   = count;
+  hovs->Sum     = sum;
+  hovs->Ramp    = ramp;
+  hovs->Weights = weights;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
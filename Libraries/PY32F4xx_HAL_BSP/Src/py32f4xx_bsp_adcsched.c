@@ -0,0 +1,524 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcsched.c
+  * @author  MCU Application Team
+  * @brief   ADC scan scheduler BSP service.
+  *          This file provides functions to scan channels of different rates
+  *          on one ADC:
+  *           + Channels converted every 1, 2, 4 ... 16 passes
+  *           + Slow channels spread over the passes to even their length
+  *           + Regular sequence rewritten between two passes
+  *           + Conversions dispatched to per channel rings
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ADC with HAL_ADC_Init(): scan mode, no continuous nor
+       discontinuous mode, regular conversions started by a timer at the
+       rate of the fastest channels. Link a DMA channel to it: peripheral to
+       memory, halfwords on both sides, memory increment and DMA_NORMAL, its
+       interrupt enabled in the NVIC. The service owns the DMA callbacks and
+       the regular sequence.
+
+   (#) Fill an array of BSP_ADCSCHED_ChannelTypeDef, one per channel: the
+       channel, its sampling time, its Divider and its ring. A Divider of 1
+       converts the channel on every trigger, a Divider of N on one trigger
+       out of N. BSP_ADCSCHED_Init() sets the sampling times and builds a
+       schedule of as many passes as the largest Divider: each slow channel
+       gets the phase where the longest pass is the shortest, so that the
+       slow channels do not all fall on the same trigger. Each pass must
+       convert at least one channel.
+
+   (#) BSP_ADCSCHED_Start() loads the sequence of the first pass. At the end
+       of each pass the DMA callback writes the sequence of the next pass in
+       SQR1 to SQR3 and restarts the DMA for its length into the other pass
+       buffer, then copies the conversions to the ring of their channel and
+       calls BSP_ADCSCHED_PassCpltCallback(). The sequence must be written before
+       the next trigger: the trigger period must exceed the longest pass by
+       the DMA interrupt latency and the callback time.
+
+   (#) BSP_ADCSCHED_Read() takes the conversions of one channel in thread
+       mode, BSP_ADCSCHED_GetCount() tells how many are waiting. A full ring
+       drops the new conversions of its channel and counts them in its
+       Overruns.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adcsched.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCSCHED BSP ADCSCHED
+  * @brief ADC scan scheduler BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Private_Constants BSP ADCSCHED Private Constants
+  * @{
+  */
+#define ADCSCHED_INSTANCES              3U             /* ADC1, ADC2 and ADC3                         */
+#define ADCSCHED_RANKS_PER_SQR          6U             /* 5-bit channel fields of SQR2 and SQR3       */
+#define ADCSCHED_CHANNEL_MAX            18U            /* Largest value of ADC_channels               */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Private_Variables BSP ADCSCHED Private Variables
+  * @{
+  */
+/* Scheduler running on each ADC, found from the DMA callbacks */
+static BSP_ADCSCHED_TypeDef *ADCSCHED_Handles[ADCSCHED_INSTANCES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Private_Functions BSP ADCSCHED Private Functions
+  * @{
+  */
+static uint32_t ADCSCHED_GetIndex(const ADC_TypeDef *Instance);
+static void     ADCSCHED_Build(BSP_ADCSCHED_TypeDef *hsched);
+static void     ADCSCHED_LoadPass(BSP_ADCSCHED_TypeDef *hsched, uint32_t Pass);
+static void     ADCSCHED_DMACplt(DMA_HandleTypeDef *hdma);
+static void     ADCSCHED_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCSCHED_Exported_Functions BSP ADCSCHED Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Set the sampling times and build the schedule of the channels.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @param  hadc ADC handle, initialized in scan mode on an external trigger, DMA linked.
+  * @param  pChannels Channels, configuration filled, kept by the service.
+  * @param  NbrOfChannels Channels, 1 to BSP_ADCSCHED_CHANNELS_MAX.
+  * @retval HAL status, HAL_ERROR when a pass of the schedule would be empty
+  */
+HAL_StatusTypeDef BSP_ADCSCHED_Init(BSP_ADCSCHED_TypeDef *hsched, ADC_HandleTypeDef *hadc,
+                                    BSP_ADCSCHED_ChannelTypeDef *pChannels, uint32_t NbrOfChannels)
+{
+  ADC_ChannelConfTypeDef sConfig = {0};
+  BSP_ADCSCHED_ChannelTypeDef *channel;
+  uint32_t passes = 1U;
+  uint32_t i;
+
+  if ((hsched == NULL) || (hadc == NULL) || (hadc->DMA_Handle == NULL) || (pChannels == NULL) ||
+      (ADCSCHED_GetIndex(hadc->Instance) >= ADCSCHED_INSTANCES) ||
+      (NbrOfChannels == 0U) || (NbrOfChannels > BSP_ADCSCHED_CHANNELS_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < NbrOfChannels; i++)
+  {
+    channel = &pChannels[i];
+    if ((channel->Channel > ADCSCHED_CHANNEL_MAX) ||
+        (channel->Divider == 0U) || (channel->Divider > BSP_ADCSCHED_PASSES_MAX) ||
+        ((channel->Divider & (channel->Divider - 1U)) != 0U) ||
+        (channel->pRing == NULL) || (channel->RingSize == 0U) ||
+        ((channel->RingSize & (channel->RingSize - 1U)) != 0U))
+    {
+      return HAL_ERROR;
+    }
+    if (channel->Divider > passes)
+    {
+      passes = channel->Divider;
+    }
+  }
+
+  if (hsched->State == BSP_ADCSCHED_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Sampling times in SMPR1 and SMPR2, the sequence is rewritten after */
+  for (i = 0U; i < NbrOfChannels; i++)
+  {
+    sConfig.Channel      = pChannels[i].Channel;
+    sConfig.Rank         = ADC_REGULAR_RANK_1;
+    sConfig.SamplingTime = pChannels[i].SamplingTime;
+    if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  hsched->hadc          = hadc;
+  hsched->pChannels     = pChannels;
+  hsched->NbrOfChannels = NbrOfChannels;
+  hsched->Passes        = passes;
+  hsched->Pass          = 0U;
+  hsched->PassCount     = 0U;
+  ADCSCHED_Build(hsched);
+
+  for (i = 0U; i < passes; i++)
+  {
+    if (hsched->Lengths[i] == 0U)
+    {
+      hsched->State = BSP_ADCSCHED_STATE_RESET;
+      return HAL_ERROR;
+    }
+  }
+
+  hsched->State = BSP_ADCSCHED_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the scheduled scan, the rings emptied.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSCHED_Start(BSP_ADCSCHED_TypeDef *hsched)
+{
+  DMA_HandleTypeDef *hdma = hsched->hadc->DMA_Handle;
+  uint32_t i;
+
+  if ((hsched->State != BSP_ADCSCHED_STATE_READY) && (hsched->State != BSP_ADCSCHED_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 0U; i < hsched->NbrOfChannels; i++)
+  {
+    hsched->pChannels[i].Head     = 0U;
+    hsched->pChannels[i].Tail     = 0U;
+    hsched->pChannels[i].Overruns = 0U;
+  }
+  hsched->Pass      = 0U;
+  hsched->PassCount = 0U;
+
+  ADCSCHED_Handles[ADCSCHED_GetIndex(hsched->hadc->Instance)] = hsched;
+  hdma->XferCpltCallback     = ADCSCHED_DMACplt;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferErrorCallback    = ADCSCHED_DMAError;
+
+  ADCSCHED_LoadPass(hsched, 0U);
+  if (HAL_DMA_Start_IT(hdma, (uint32_t)&hsched->hadc->Instance->DR, (uint32_t)hsched->Buffers[0],
+                       hsched->Lengths[0]) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hsched->State = BSP_ADCSCHED_STATE_RUN;
+  SET_BIT(hsched->hadc->Instance->CR2, ADC_CR2_DMA);
+  if (HAL_ADC_Start(hsched->hadc) != HAL_OK)
+  {
+    CLEAR_BIT(hsched->hadc->Instance->CR2, ADC_CR2_DMA);
+    (void)HAL_DMA_Abort(hdma);
+    hsched->State = BSP_ADCSCHED_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the scheduled scan, the pass running is dropped.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSCHED_Stop(BSP_ADCSCHED_TypeDef *hsched)
+{
+  HAL_StatusTypeDef status;
+
+  if (hsched->State != BSP_ADCSCHED_STATE_RUN)
+  {
+    return HAL_ERROR;
+  }
+
+  hsched->State = BSP_ADCSCHED_STATE_READY;
+  status = HAL_ADC_Stop(hsched->hadc);
+  CLEAR_BIT(hsched->hadc->Instance->CR2, ADC_CR2_DMA);
+  if (HAL_DMA_Abort(hsched->hadc->DMA_Handle) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Conversions waiting in the ring of a channel.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @param  Index Channel index in the array given to BSP_ADCSCHED_Init().
+  * @retval Conversions
+  */
+uint32_t BSP_ADCSCHED_GetCount(const BSP_ADCSCHED_TypeDef *hsched, uint32_t Index)
+{
+  const BSP_ADCSCHED_ChannelTypeDef *channel = &hsched->pChannels[Index];
+
+  return channel->Head - channel->Tail;
+}
+
+/**
+  * @brief  Read conversions of a channel from its ring.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @param  Index Channel index in the array given to BSP_ADCSCHED_Init().
+  * @param  pDst Destination of up to Count halfwords.
+  * @param  Count Conversions wanted.
+  * @retval Conversions read
+  */
+uint32_t BSP_ADCSCHED_Read(BSP_ADCSCHED_TypeDef *hsched, uint32_t Index, uint16_t *pDst, uint32_t Count)
+{
+  BSP_ADCSCHED_ChannelTypeDef *channel = &hsched->pChannels[Index];
+  uint32_t tail = channel->Tail;
+  uint32_t available = channel->Head - tail;
+  uint32_t i;
+
+  if (Count > available)
+  {
+    Count = available;
+  }
+  for (i = 0U; i < Count; i++)
+  {
+    pDst[i] = channel->pRing[(tail + i) & (channel->RingSize - 1U)];
+  }
+  channel->Tail = tail + Count;
+
+  return Count;
+}
+
+/**
+  * @brief  Pass complete callback, the conversions of a pass are in their rings.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCSCHED_PassCpltCallback(BSP_ADCSCHED_TypeDef *hsched)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hsched);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCSCHED_PassCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCSCHED_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the scheduler slot of an ADC.
+  * @param  Instance ADC instance.
+  * @retval Index, ADCSCHED_INSTANCES for an unknown instance
+  */
+static uint32_t ADCSCHED_GetIndex(const ADC_TypeDef *Instance)
+{
+  if (Instance == ADC1)
+  {
+    return 0U;
+  }
+  if (Instance == ADC2)
+  {
+    return 1U;
+  }
+  if (Instance == ADC3)
+  {
+    return 2U;
+  }
+
+  return ADCSCHED_INSTANCES;
+}
+
+/**
+  * @brief  Choose the phase of each channel and build the sequence of each pass.
+  * @note   A channel of Divider D is converted on the passes equal to its
+  *         phase modulo D; its phase is the one with the shortest longest
+  *         pass so far, channels taken in the array order.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @retval None
+  */
+static void ADCSCHED_Build(BSP_ADCSCHED_TypeDef *hsched)
+{
+  BSP_ADCSCHED_ChannelTypeDef *channel;
+  uint32_t divider;
+  uint32_t phase;
+  uint32_t longest;
+  uint32_t best;
+  uint32_t bestLongest;
+  uint32_t pass;
+  uint32_t rank;
+  uint32_t i;
+
+  for (pass = 0U; pass < BSP_ADCSCHED_PASSES_MAX; pass++)
+  {
+    hsched->Lengths[pass] = 0U;
+  }
+
+  for (i = 0U; i < hsched->NbrOfChannels; i++)
+  {
+    channel     = &hsched->pChannels[i];
+    divider     = channel->Divider;
+    best        = 0U;
+    bestLongest = 0xFFFFFFFFU;
+    for (phase = 0U; phase < divider; phase++)
+    {
+      longest = 0U;
+      for (pass = phase; pass < hsched->Passes; pass += divider)
+      {
+        if (hsched->Lengths[pass] > longest)
+        {
+          longest = hsched->Lengths[pass];
+        }
+      }
+      if (longest < bestLongest)
+      {
+        bestLongest = longest;
+        best        = phase;
+      }
+    }
+
+    channel->Phase = best;
+    for (pass = best; pass < hsched->Passes; pass += divider)
+    {
+      hsched->Ranks[pass][hsched->Lengths[pass]] = (uint8_t)i;
+      hsched->Lengths[pass]++;
+    }
+  }
+
+  /* Regular sequence registers of each pass */
+  for (pass = 0U; pass < hsched->Passes; pass++)
+  {
+    hsched->Sequences[pass][0] = 0U;
+    hsched->Sequences[pass][1] = 0U;
+    hsched->Sequences[pass][2] = 0U;
+    for (rank = 0U; rank < hsched->Lengths[pass]; rank++)
+    {
+      hsched->Sequences[pass][2U - (rank / ADCSCHED_RANKS_PER_SQR)] |=
+        hsched->pChannels[hsched->Ranks[pass][rank]].Channel << (5U * (rank % ADCSCHED_RANKS_PER_SQR));
+    }
+    if (hsched->Lengths[pass] != 0U)
+    {
+      hsched->Sequences[pass][0] |= ((uint32_t)hsched->Lengths[pass] - 1U) << ADC_SQR1_L_Pos;
+    }
+  }
+}
+
+/**
+  * @brief  Write the regular sequence of a pass.
+  * @param  hsched Pointer to a BSP_ADCSCHED_TypeDef structure.
+  * @param  Pass Pass to convert on the next trigger.
+  * @retval None
+  */
+static void ADCSCHED_LoadPass(BSP_ADCSCHED_TypeDef *hsched, uint32_t Pass)
+{
+  ADC_TypeDef *adc = hsched->hadc->Instance;
+
+  adc->SQR1 = hsched->Sequences[Pass][0];
+  adc->SQR2 = hsched->Sequences[Pass][1];
+  adc->SQR3 = hsched->Sequences[Pass][2];
+}
+
+/**
+  * @brief  DMA transfer complete callback: dispatch the pass, load the next one.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSCHED_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_ADCSCHED_TypeDef *hsched = ADCSCHED_Handles[ADCSCHED_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+  BSP_ADCSCHED_ChannelTypeDef *channel;
+  uint32_t pass = hsched->Pass;
+  uint32_t next = (pass + 1U) & (hsched->Passes - 1U);
+  uint32_t count = hsched->PassCount;
+  const uint16_t *pDone = hsched->Buffers[count & 1U];
+  uint32_t head;
+  uint32_t rank;
+
+  if (hsched->State != BSP_ADCSCHED_STATE_RUN)
+  {
+    return;
+  }
+
+  /* Next sequence first, in the other buffer, the ADC waits for the trigger */
+  ADCSCHED_LoadPass(hsched, next);
+  hsched->Pass = next;
+  if (HAL_DMA_Start_IT(hdma, (uint32_t)&hsched->hadc->Instance->DR, (uint32_t)hsched->Buffers[(count + 1U) & 1U],
+                       hsched->Lengths[next]) != HAL_OK)
+  {
+    ADCSCHED_DMAError(hdma);
+    return;
+  }
+
+  for (rank = 0U; rank < hsched->Lengths[pass]; rank++)
+  {
+    channel = &hsched->pChannels[hsched->Ranks[pass][rank]];
+    head = channel->Head;
+    if ((head - channel->Tail) >= channel->RingSize)
+    {
+      channel->Overruns++;
+    }
+    else
+    {
+      channel->pRing[head & (channel->RingSize - 1U)] = pDone[rank];
+      channel->Head = head + 1U;
+    }
+  }
+  hsched->PassCount = count + 1U;
+
+  BSP_ADCSCHED_PassCpltCallback(hsched);
+}
+
+/**
+  * @brief  DMA error callback, the scan is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSCHED_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_ADCSCHED_TypeDef *hsched = ADCSCHED_Handles[ADCSCHED_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  hsched->State = BSP_ADCSCHED_STATE_ERROR;
+  (void)HAL_ADC_Stop(hsched->hadc);
+  CLEAR_BIT(hsched->hadc->Instance->CR2, ADC_CR2_DMA);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,462 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcscope.c
+  * @author  MCU Application Team
+  * @brief   ADC analog watchdog event capture BSP service.
+  *          This file provides functions to capture an ADC waveform around an
+  *          analog watchdog event, like the single trigger of a scope:
+  *           + Circular pre-trigger DMA ring, no CPU load while armed
+  *           + Window frozen PostTrigger conversions after the watchdog
+  *           + Window read in place from the ring
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ADC with HAL_ADC_Init(), converting continuously or on a
+       timer at the capture rate, and configure the analog watchdog with
+       HAL_ADC_AnalogWDGConfig() on the channel to watch. Link a DMA channel
+       to the ADC: peripheral to memory, halfwords on both sides and memory
+       increment; the service sets the circular mode by itself and owns the
+       DMA callbacks.
+
+   (#) Call BSP_ADCSCOPE_Init() with a ring of Length halfwords, kept by the
+       service, and the conversions to keep before and after the trigger,
+       PreTrigger + PostTrigger not above Length.
+
+   (#) Call BSP_ADCSCOPE_LevelOutOfWindowCallback() from
+       HAL_ADC_LevelOutOfWindowCallback(), and HAL_ADC_IRQHandler() and
+       HAL_DMA_IRQHandler() from the interrupt handlers, both at the same
+       preemption priority.
+
+   (#) BSP_ADCSCOPE_Arm() starts the ring. While armed, the DMA overwrites the
+       oldest conversions without any interrupt but the one of the first
+       lap. On the watchdog, the service disarms the watchdog and reloads
+       the DMA in normal mode from the current position for PostTrigger
+       conversions, in two segments when they wrap the ring end, so it stops
+       by itself over the oldest conversions not kept. The ADC is stopped
+       and BSP_ADCSCOPE_CaptureCallback() called once the window is full.
+
+   (#) BSP_ADCSCOPE_GetWindow() gives the window as one or two segments of
+       the ring, BSP_ADCSCOPE_GetSample() one conversion of it, the window
+       being valid up to the next BSP_ADCSCOPE_Arm(). The trigger is the
+       conversion at index PreTrigger - 1, or the one before by the
+       interrupt latency at the highest rates. A trigger before the ring
+       was filled once keeps fewer pre-trigger conversions.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adcscope.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCSCOPE BSP ADCSCOPE
+  * @brief ADC analog watchdog event capture BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Private_Constants BSP ADCSCOPE Private Constants
+  * @{
+  */
+#define ADCSCOPE_INSTANCES              3U             /* ADC1, ADC2 and ADC3 */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Private_Variables BSP ADCSCOPE Private Variables
+  * @{
+  */
+/* Capture armed on each ADC, found from the DMA callbacks */
+static BSP_ADCSCOPE_TypeDef *ADCSCOPE_Handles[ADCSCOPE_INSTANCES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Private_Functions BSP ADCSCOPE Private Functions
+  * @{
+  */
+static uint32_t ADCSCOPE_GetIndex(const ADC_TypeDef *Instance);
+static void     ADCSCOPE_Halt(BSP_ADCSCOPE_TypeDef *hscope);
+static void     ADCSCOPE_DMACplt(DMA_HandleTypeDef *hdma);
+static void     ADCSCOPE_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCSCOPE_Exported_Functions BSP ADCSCOPE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize an analog watchdog event capture.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @param  hadc ADC handle, initialized, analog watchdog configured, DMA linked.
+  * @param  pBuffer Ring of Length halfwords.
+  * @param  Length Conversions in the ring, 2 to 0xFFFF.
+  * @param  PreTrigger Conversions kept up to the trigger.
+  * @param  PostTrigger Conversions kept after the trigger, 1 to Length - PreTrigger.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSCOPE_Init(BSP_ADCSCOPE_TypeDef *hscope, ADC_HandleTypeDef *hadc, uint16_t *pBuffer,
+                                    uint32_t Length, uint32_t PreTrigger, uint32_t PostTrigger)
+{
+  if ((hscope == NULL) || (hadc == NULL) || (hadc->DMA_Handle == NULL) || (pBuffer == NULL) ||
+      (ADCSCOPE_GetIndex(hadc->Instance) >= ADCSCOPE_INSTANCES) ||
+      (Length < 2U) || (Length > 0xFFFFU) ||
+      (PostTrigger == 0U) || (PreTrigger > (Length - PostTrigger)) || (PostTrigger > Length))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hscope->State == BSP_ADCSCOPE_STATE_ARMED) || (hscope->State == BSP_ADCSCOPE_STATE_POST))
+  {
+    return HAL_BUSY;
+  }
+
+  hscope->hadc        = hadc;
+  hscope->pBuffer     = pBuffer;
+  hscope->Length      = Length;
+  hscope->PreTrigger  = PreTrigger;
+  hscope->PostTrigger = PostTrigger;
+  hscope->Start       = 0U;
+  hscope->Count       = 0U;
+  hscope->Remaining   = 0U;
+  hscope->Filled      = 0U;
+  hscope->Triggers    = 0U;
+  hscope->State       = BSP_ADCSCOPE_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the pre-trigger ring and arm the analog watchdog.
+  * @note   The window of the previous capture is lost.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSCOPE_Arm(BSP_ADCSCOPE_TypeDef *hscope)
+{
+  DMA_HandleTypeDef *hdma = hscope->hadc->DMA_Handle;
+
+  if ((hscope->State != BSP_ADCSCOPE_STATE_READY) && (hscope->State != BSP_ADCSCOPE_STATE_DONE))
+  {
+    return HAL_BUSY;
+  }
+
+  ADCSCOPE_Handles[ADCSCOPE_GetIndex(hscope->hadc->Instance)] = hscope;
+  hdma->XferCpltCallback     = ADCSCOPE_DMACplt;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferErrorCallback    = ADCSCOPE_DMAError;
+
+  /* Circular on the whole ring, the transfer complete marks the first lap */
+  SET_BIT(hdma->Instance->CCR, DMA_CCR_CIRC);
+  hscope->Count  = 0U;
+  hscope->Filled = 0U;
+  if (HAL_DMA_Start_IT(hdma, (uint32_t)&hscope->hadc->Instance->DR, (uint32_t)hscope->pBuffer,
+                       hscope->Length) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hscope->State = BSP_ADCSCOPE_STATE_ARMED;
+  __HAL_ADC_CLEAR_FLAG(hscope->hadc, ADC_FLAG_AWD);
+  __HAL_ADC_ENABLE_IT(hscope->hadc, ADC_IT_AWD);
+  SET_BIT(hscope->hadc->Instance->CR2, ADC_CR2_DMA);
+  if (HAL_ADC_Start(hscope->hadc) != HAL_OK)
+  {
+    ADCSCOPE_Halt(hscope);
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the capture, armed or triggered.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSCOPE_Stop(BSP_ADCSCOPE_TypeDef *hscope)
+{
+  if (hscope->State == BSP_ADCSCOPE_STATE_RESET)
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hscope->State == BSP_ADCSCOPE_STATE_ARMED) || (hscope->State == BSP_ADCSCOPE_STATE_POST))
+  {
+    ADCSCOPE_Halt(hscope);
+    hscope->Count = 0U;
+  }
+  hscope->State = BSP_ADCSCOPE_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the captured window, in place in the ring.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @param  ppFirst Receives the oldest conversions of the window.
+  * @param  pFirstLength Receives the conversions at ppFirst.
+  * @param  ppSecond Receives the conversions following the ring end, NULL when none.
+  * @param  pSecondLength Receives the conversions at ppSecond.
+  * @retval Conversions in the window, 0 when no window is captured
+  */
+uint32_t BSP_ADCSCOPE_GetWindow(const BSP_ADCSCOPE_TypeDef *hscope, const uint16_t **ppFirst,
+                                uint32_t *pFirstLength, const uint16_t **ppSecond,
+                                uint32_t *pSecondLength)
+{
+  uint32_t count = (hscope->State == BSP_ADCSCOPE_STATE_DONE) ? hscope->Count : 0U;
+  uint32_t first = hscope->Length - hscope->Start;
+
+  if (first > count)
+  {
+    first = count;
+  }
+
+  *ppFirst       = &hscope->pBuffer[hscope->Start];
+  *pFirstLength  = first;
+  *ppSecond      = (count > first) ? hscope->pBuffer : NULL;
+  *pSecondLength = count - first;
+
+  return count;
+}
+
+/**
+  * @brief  Read one conversion of the captured window.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @param  Index Conversion in the window, 0 the oldest, PreTrigger - 1 the trigger.
+  * @retval Conversion, 0 past the window
+  */
+uint16_t BSP_ADCSCOPE_GetSample(const BSP_ADCSCOPE_TypeDef *hscope, uint32_t Index)
+{
+  uint32_t position;
+
+  if ((hscope->State != BSP_ADCSCOPE_STATE_DONE) || (Index >= hscope->Count))
+  {
+    return 0U;
+  }
+
+  position = hscope->Start + Index;
+  if (position >= hscope->Length)
+  {
+    position -= hscope->Length;
+  }
+
+  return hscope->pBuffer[position];
+}
+
+/**
+  * @brief  Analog watchdog forwarding, freezes the window on the trigger.
+  * @note   Call it from HAL_ADC_LevelOutOfWindowCallback().
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @retval None
+  */
+void BSP_ADCSCOPE_LevelOutOfWindowCallback(BSP_ADCSCOPE_TypeDef *hscope)
+{
+  DMA_HandleTypeDef *hdma = hscope->hadc->DMA_Handle;
+  uint32_t position;
+  uint32_t pre = hscope->PreTrigger;
+  uint32_t first;
+
+  if (hscope->State != BSP_ADCSCOPE_STATE_ARMED)
+  {
+    return;
+  }
+
+  __HAL_ADC_DISABLE_IT(hscope->hadc, ADC_IT_AWD);
+
+  /* Freeze the position, the ADC request waits for the channel */
+  __HAL_DMA_DISABLE(hdma);
+  position = hscope->Length - hdma->Instance->CNDTR;
+  if (position >= hscope->Length)
+  {
+    position = 0U;
+  }
+  if (__HAL_DMA_GET_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma)) != 0U)
+  {
+    hscope->Filled = 1U;
+  }
+
+  if ((hscope->Filled == 0U) && (position < pre))
+  {
+    pre = position;
+  }
+  hscope->Start = (position >= pre) ? (position - pre) : (position + hscope->Length - pre);
+  hscope->Count = pre + hscope->PostTrigger;
+
+  /* Post-trigger conversions up to the ring end, the rest from the ring start */
+  first = hscope->Length - position;
+  if (first > hscope->PostTrigger)
+  {
+    first = hscope->PostTrigger;
+  }
+  hscope->Remaining = hscope->PostTrigger - first;
+
+  hscope->State = BSP_ADCSCOPE_STATE_POST;
+  CLEAR_BIT(hdma->Instance->CCR, DMA_CCR_CIRC);
+  __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma));
+  hdma->Instance->CMAR  = (uint32_t)&hscope->pBuffer[position];
+  hdma->Instance->CNDTR = first;
+  __HAL_DMA_ENABLE_IT(hdma, (DMA_IT_TC | DMA_IT_TE));
+  __HAL_DMA_ENABLE(hdma);
+}
+
+/**
+  * @brief  Capture callback, the window is ready for BSP_ADCSCOPE_GetWindow().
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCSCOPE_CaptureCallback(BSP_ADCSCOPE_TypeDef *hscope)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hscope);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCSCOPE_CaptureCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCSCOPE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the capture slot of an ADC.
+  * @param  Instance ADC instance.
+  * @retval Index, ADCSCOPE_INSTANCES for an unknown instance
+  */
+static uint32_t ADCSCOPE_GetIndex(const ADC_TypeDef *Instance)
+{
+  if (Instance == ADC1)
+  {
+    return 0U;
+  }
+  if (Instance == ADC2)
+  {
+    return 1U;
+  }
+  if (Instance == ADC3)
+  {
+    return 2U;
+  }
+
+  return ADCSCOPE_INSTANCES;
+}
+
+/**
+  * @brief  Stop the ADC, its watchdog interrupt and its DMA.
+  * @param  hscope Pointer to a BSP_ADCSCOPE_TypeDef structure.
+  * @retval None
+  */
+static void ADCSCOPE_Halt(BSP_ADCSCOPE_TypeDef *hscope)
+{
+  __HAL_ADC_DISABLE_IT(hscope->hadc, ADC_IT_AWD);
+  (void)HAL_ADC_Stop(hscope->hadc);
+  CLEAR_BIT(hscope->hadc->Instance->CR2, ADC_CR2_DMA);
+  (void)HAL_DMA_Abort(hscope->hadc->DMA_Handle);
+}
+
+/**
+  * @brief  DMA transfer complete callback: first lap while armed, end of a
+  *         post-trigger segment once triggered.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSCOPE_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_ADCSCOPE_TypeDef *hscope = ADCSCOPE_Handles[ADCSCOPE_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+  uint32_t remaining;
+
+  if (hscope->State == BSP_ADCSCOPE_STATE_ARMED)
+  {
+    /* The ring holds PreTrigger conversions from now on */
+    hscope->Filled = 1U;
+    __HAL_DMA_DISABLE_IT(hdma, DMA_IT_TC);
+    return;
+  }
+
+  if (hscope->State != BSP_ADCSCOPE_STATE_POST)
+  {
+    return;
+  }
+
+  remaining = hscope->Remaining;
+  if (remaining != 0U)
+  {
+    hscope->Remaining = 0U;
+    if (HAL_DMA_Start_IT(hdma, (uint32_t)&hscope->hadc->Instance->DR, (uint32_t)hscope->pBuffer,
+                         remaining) == HAL_OK)
+    {
+      return;
+    }
+  }
+
+  (void)HAL_ADC_Stop(hscope->hadc);
+  CLEAR_BIT(hscope->hadc->Instance->CR2, ADC_CR2_DMA);
+  hscope->Triggers++;
+  hscope->State = BSP_ADCSCOPE_STATE_DONE;
+
+  BSP_ADCSCOPE_CaptureCallback(hscope);
+}
+
+/**
+  * @brief  DMA error callback, the capture is stopped without window.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSCOPE_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_ADCSCOPE_TypeDef *hscope = ADCSCOPE_Handles[ADCSCOPE_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  __HAL_ADC_DISABLE_IT(hscope->hadc, ADC_IT_AWD);
+  (void)HAL_ADC_Stop(hscope->hadc);
+  CLEAR_BIT(hscope->hadc->Instance->CR2, ADC_CR2_DMA);
+  hscope->Count = 0U;
+  hscope->State = BSP_ADCSCOPE_STATE_READY;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,438 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adcstream.c
+  * @author  MCU Application Team
+  * @brief   ADC block streaming BSP service.
+  *          This file provides functions to capture an ADC into fixed size
+  *          blocks handed to the processing without copy:
+  *           + Pool of preallocated blocks, no allocation at run time
+  *           + DMA double buffer mode switching between the blocks
+  *           + Each block stamped with a sequence number and a timer count
+  *           + Overrun counted and visible as a gap in the sequence
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ADC with HAL_ADC_Init(), triggered by a timer at the
+       sample rate, and link a DMA channel to it: peripheral to memory,
+       halfwords on both sides, memory increment and DMA_NORMAL, its
+       interrupt enabled in the NVIC. The service owns the DMA callbacks.
+
+   (#) Call BSP_ADCSTREAM_Init() with an array of BlockCount block headers and
+       a storage of BlockCount x BlockLength halfwords, both kept by the
+       service. TimeBase is the timer stamping the blocks, for instance the
+       timer of the trigger or a free running one shared with the other
+       sensors; NULL uses the DWT cycle counter.
+
+   (#) BSP_ADCSTREAM_Start() runs the DMA in double buffer mode on two blocks
+       of the pool. The DMA switches to the other block by itself at the end
+       of one, before the callback: the callback stamps the block just
+       started, queues the full one, hands a free block over to the DMA in
+       its place with HAL_DMAEx_ChangeMemory() and calls
+       BSP_ADCSTREAM_BlockReadyCallback().
+
+   (#) BSP_ADCSTREAM_Get() returns the oldest full block or NULL, and the
+       block belongs to the caller until BSP_ADCSTREAM_Release(). Process it
+       in place; Sequence tells its first sample, Sequence x BlockLength, and
+       Timestamp the time base count at its start.
+
+   (#) When no block is free at the end of a block, the full block is handed
+       back to the DMA instead of being queued: its samples are lost,
+       Overruns counts it and the next sequence received skips one. Release
+       the blocks before the pool runs out.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adcstream.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCSTREAM BSP ADCSTREAM
+  * @brief ADC block streaming BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Private_Constants BSP ADCSTREAM Private Constants
+  * @{
+  */
+#define ADCSTREAM_MASK                  (BSP_ADCSTREAM_BLOCKS_MAX - 1U)
+#define ADCSTREAM_INSTANCES             3U             /* ADC1, ADC2 and ADC3 */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Private_Variables BSP ADCSTREAM Private Variables
+  * @{
+  */
+/* Capture running on each ADC, found from the DMA callbacks */
+static BSP_ADCSTREAM_TypeDef *ADCSTREAM_Handles[ADCSTREAM_INSTANCES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Private_Functions BSP ADCSTREAM Private Functions
+  * @{
+  */
+static uint32_t ADCSTREAM_GetIndex(const ADC_TypeDef *Instance);
+static uint32_t ADCSTREAM_Stamp(const BSP_ADCSTREAM_TypeDef *hstream);
+static void     ADCSTREAM_BlockCplt(DMA_HandleTypeDef *hdma, uint32_t Slot);
+static void     ADCSTREAM_DMAM0Cplt(DMA_HandleTypeDef *hdma);
+static void     ADCSTREAM_DMAM1Cplt(DMA_HandleTypeDef *hdma);
+static void     ADCSTREAM_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCSTREAM_Exported_Functions BSP ADCSTREAM Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a block streaming capture.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @param  hadc ADC handle, initialized, DMA linked in normal mode.
+  * @param  TimeBase Timer stamping the blocks, NULL for the DWT cycle counter.
+  * @param  pBlocks Array of BlockCount block headers.
+  * @param  pStorage Storage of BlockCount x BlockLength halfwords.
+  * @param  BlockCount Blocks in the pool, 3 to BSP_ADCSTREAM_BLOCKS_MAX.
+  * @param  BlockLength Conversions per block, 1 to 0xFFFF.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSTREAM_Init(BSP_ADCSTREAM_TypeDef *hstream, ADC_HandleTypeDef *hadc,
+                                     TIM_TypeDef *TimeBase, BSP_ADCSTREAM_BlockTypeDef *pBlocks,
+                                     uint16_t *pStorage, uint32_t BlockCount, uint32_t BlockLength)
+{
+  uint32_t i;
+
+  if ((hstream == NULL) || (hadc == NULL) || (hadc->DMA_Handle == NULL) ||
+      (ADCSTREAM_GetIndex(hadc->Instance) >= ADCSTREAM_INSTANCES) ||
+      (pBlocks == NULL) || (pStorage == NULL) ||
+      (BlockCount < 3U) || (BlockCount > BSP_ADCSTREAM_BLOCKS_MAX) ||
+      (BlockLength == 0U) || (BlockLength > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hstream->State == BSP_ADCSTREAM_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hstream->hadc        = hadc;
+  hstream->TimeBase    = TimeBase;
+  hstream->pBlocks     = pBlocks;
+  hstream->BlockCount  = BlockCount;
+  hstream->BlockLength = BlockLength;
+  for (i = 0U; i < BlockCount; i++)
+  {
+    pBlocks[i].pData     = &pStorage[i * BlockLength];
+    pBlocks[i].Sequence  = 0U;
+    pBlocks[i].Timestamp = 0U;
+  }
+
+  if (TimeBase == NULL)
+  {
+    HAL_EnableCycleCounter();
+  }
+
+  hstream->State = BSP_ADCSTREAM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the capture, all the blocks back in the pool.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSTREAM_Start(BSP_ADCSTREAM_TypeDef *hstream)
+{
+  DMA_HandleTypeDef *hdma = hstream->hadc->DMA_Handle;
+  uint32_t i;
+
+  if ((hstream->State != BSP_ADCSTREAM_STATE_READY) && (hstream->State != BSP_ADCSTREAM_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  /* Blocks 0 and 1 to the DMA, the others free */
+  for (i = 2U; i < hstream->BlockCount; i++)
+  {
+    hstream->Free[i - 2U] = (uint8_t)i;
+  }
+  hstream->FreeTail  = 0U;
+  hstream->FreeHead  = hstream->BlockCount - 2U;
+  hstream->ReadyTail = 0U;
+  hstream->ReadyHead = 0U;
+  hstream->Overruns  = 0U;
+  hstream->Slots[0]  = 0U;
+  hstream->Slots[1]  = 1U;
+  hstream->Sequence  = 1U;
+  hstream->pBlocks[0].Sequence = 0U;
+  hstream->pBlocks[1].Sequence = 1U;
+
+  ADCSTREAM_Handles[ADCSTREAM_GetIndex(hstream->hadc->Instance)] = hstream;
+  hdma->XferCpltCallback   = ADCSTREAM_DMAM0Cplt;
+  hdma->XferM1CpltCallback = ADCSTREAM_DMAM1Cplt;
+  hdma->XferErrorCallback  = ADCSTREAM_DMAError;
+
+  if (HAL_DMAEx_MultiBufferStart_IT(hdma, (uint32_t)&hstream->hadc->Instance->DR,
+                                    (uint32_t)hstream->pBlocks[0].pData, hstream->BlockLength,
+                                    (uint32_t)hstream->pBlocks[1].pData, hstream->BlockLength) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hstream->State = BSP_ADCSTREAM_STATE_RUN;
+  hstream->pBlocks[0].Timestamp = ADCSTREAM_Stamp(hstream);
+  SET_BIT(hstream->hadc->Instance->CR2, ADC_CR2_DMA);
+  if (HAL_ADC_Start(hstream->hadc) != HAL_OK)
+  {
+    CLEAR_BIT(hstream->hadc->Instance->CR2, ADC_CR2_DMA);
+    (void)HAL_DMA_Abort(hdma);
+    hstream->State = BSP_ADCSTREAM_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the capture, the blocks being written are dropped.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCSTREAM_Stop(BSP_ADCSTREAM_TypeDef *hstream)
+{
+  HAL_StatusTypeDef status;
+
+  if (hstream->State != BSP_ADCSTREAM_STATE_RUN)
+  {
+    return HAL_ERROR;
+  }
+
+  hstream->State = BSP_ADCSTREAM_STATE_READY;
+  status = HAL_ADC_Stop(hstream->hadc);
+  CLEAR_BIT(hstream->hadc->Instance->CR2, ADC_CR2_DMA);
+  if (HAL_DMA_Abort(hstream->hadc->DMA_Handle) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Take the oldest full block.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @retval Block, owned by the caller until BSP_ADCSTREAM_Release(), NULL when
+  *         none is full
+  */
+BSP_ADCSTREAM_BlockTypeDef *BSP_ADCSTREAM_Get(BSP_ADCSTREAM_TypeDef *hstream)
+{
+  uint32_t tail = hstream->ReadyTail;
+  uint32_t index;
+
+  if (tail == hstream->ReadyHead)
+  {
+    return NULL;
+  }
+
+  index = hstream->Ready[tail & ADCSTREAM_MASK];
+  hstream->ReadyTail = tail + 1U;
+
+  return &hstream->pBlocks[index];
+}
+
+/**
+  * @brief  Give a block back to the pool.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @param  pBlock Block returned by BSP_ADCSTREAM_Get().
+  * @retval None
+  */
+void BSP_ADCSTREAM_Release(BSP_ADCSTREAM_TypeDef *hstream, BSP_ADCSTREAM_BlockTypeDef *pBlock)
+{
+  uint32_t head = hstream->FreeHead;
+
+  hstream->Free[head & ADCSTREAM_MASK] = (uint8_t)(pBlock - hstream->pBlocks);
+  __DMB();
+  hstream->FreeHead = head + 1U;
+}
+
+/**
+  * @brief  Block ready callback, a full block is waiting for BSP_ADCSTREAM_Get().
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCSTREAM_BlockReadyCallback(BSP_ADCSTREAM_TypeDef *hstream)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hstream);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCSTREAM_BlockReadyCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCSTREAM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the capture slot of an ADC.
+  * @param  Instance ADC instance.
+  * @retval Index, ADCSTREAM_INSTANCES for an unknown instance
+  */
+static uint32_t ADCSTREAM_GetIndex(const ADC_TypeDef *Instance)
+{
+  if (Instance == ADC1)
+  {
+    return 0U;
+  }
+  if (Instance == ADC2)
+  {
+    return 1U;
+  }
+  if (Instance == ADC3)
+  {
+    return 2U;
+  }
+
+  return ADCSTREAM_INSTANCES;
+}
+
+/**
+  * @brief  Read the time base.
+  * @param  hstream Pointer to a BSP_ADCSTREAM_TypeDef structure.
+  * @retval Counter of the timer, or DWT cycle count
+  */
+static uint32_t ADCSTREAM_Stamp(const BSP_ADCSTREAM_TypeDef *hstream)
+{
+  return (hstream->TimeBase != NULL) ? hstream->TimeBase->CNT : DWT->CYCCNT;
+}
+
+/**
+  * @brief  Queue a full block and give the DMA the next one.
+  * @note   The DMA already runs in the block of the other slot.
+  * @param  hdma DMA handle.
+  * @param  Slot DMA memory the block was written from, 0 or 1.
+  * @retval None
+  */
+static void ADCSTREAM_BlockCplt(DMA_HandleTypeDef *hdma, uint32_t Slot)
+{
+  BSP_ADCSTREAM_TypeDef *hstream = ADCSTREAM_Handles[ADCSTREAM_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+  uint32_t full = hstream->Slots[Slot];
+  uint32_t tail = hstream->FreeTail;
+  uint32_t next = full;
+  uint32_t head;
+
+  hstream->pBlocks[hstream->Slots[Slot ^ 1U]].Timestamp = ADCSTREAM_Stamp(hstream);
+
+  if (tail != hstream->FreeHead)
+  {
+    next = hstream->Free[tail & ADCSTREAM_MASK];
+    hstream->FreeTail = tail + 1U;
+  }
+
+  hstream->Sequence++;
+  hstream->pBlocks[next].Sequence = hstream->Sequence;
+  hstream->Slots[Slot] = (uint8_t)next;
+
+  if (next == full)
+  {
+    /* No free block: the full one is written again */
+    (void)HAL_DMAEx_ReleaseMemory(hdma, (HAL_DMA_MemoryTypeDef)Slot);
+    hstream->Overruns++;
+    return;
+  }
+
+  (void)HAL_DMAEx_ChangeMemory(hdma, (uint32_t)hstream->pBlocks[next].pData, hstream->BlockLength,
+                               (HAL_DMA_MemoryTypeDef)Slot);
+
+  head = hstream->ReadyHead;
+  hstream->Ready[head & ADCSTREAM_MASK] = (uint8_t)full;
+  __DMB();
+  hstream->ReadyHead = head + 1U;
+
+  BSP_ADCSTREAM_BlockReadyCallback(hstream);
+}
+
+/**
+  * @brief  DMA memory 0 transfer complete callback.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSTREAM_DMAM0Cplt(DMA_HandleTypeDef *hdma)
+{
+  ADCSTREAM_BlockCplt(hdma, (uint32_t)MEMORY0);
+}
+
+/**
+  * @brief  DMA memory 1 transfer complete callback.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSTREAM_DMAM1Cplt(DMA_HandleTypeDef *hdma)
+{
+  ADCSTREAM_BlockCplt(hdma, (uint32_t)MEMORY1);
+}
+
+/**
+  * @brief  DMA error callback, the capture is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCSTREAM_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_ADCSTREAM_TypeDef *hstream = ADCSTREAM_Handles[ADCSTREAM_GetIndex(((ADC_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  hstream->State = BSP_ADCSTREAM_STATE_ERROR;
+  (void)HAL_ADC_Stop(hstream->hadc);
+  CLEAR_BIT(hstream->hadc->Instance->CR2, ADC_CR2_DMA);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,505 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_adctriple.c
+  * @author  MCU Application Team
+  * @brief   Triple interleaved ADC capture BSP service.
+  *          This file provides functions to sample one channel with ADC1, ADC2
+  *          and ADC3 in turn, at three times the rate of a single ADC:
+  *           + Conversions staggered by a third of the period of TIM1
+  *           + One DMA channel per ADC into one capture buffer
+  *           + Samples read back in time order
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The multimode of the ADCs only pairs ADC1 and ADC2, and the fast
+       interleaved mode has a fixed delay of 7 ADC clock cycles. This service
+       keeps the three ADCs independent and triggers them from TIM1 instead:
+       CC1 starts ADC1, CC2 ADC2 and CC3 ADC3, the compares a third of the
+       period apart. The phase offsets are then exact to the timer tick, for
+       any rate. Leave the multimode in ADC_MODE_INDEPENDENT.
+
+   (#) In HAL_ADC_MspInit(), enable the clocks of ADC1, ADC2 and ADC3, set the
+       pin of the channel in analog mode and link one DMA channel to each ADC
+       with __HAL_LINKDMA(hadc, DMA_Handle, hdma): request
+       DMA_CHANNEL_MAP_ADCx, peripheral to memory, peripheral and memory data
+       in halfwords, memory increment and DMA_CIRCULAR. Enable the interrupt
+       of the ADC3 channel only, the service turns off those of ADC1 and ADC2.
+       In HAL_TIM_PWM_MspInit(), enable the clock of TIM1.
+
+   (#) BSP_ADCTRIPLE_Init() configures the ADCs on the same channel and
+       calibrates them, and sets TIM1 for the aggregate SampleRate. The rate
+       is refused when one ADC cannot convert in three steps of the timer
+       with the SamplingTime given. SampleRate in the handle is the rate
+       obtained, rounded to the timer tick.
+
+   (#) BSP_ADCTRIPLE_Start() runs the capture into a buffer of
+       3 x Length samples: ADC1 fills the first Length, ADC2 the next and
+       ADC3 the last. Sample n of the capture is sample n / 3 of ADC n % 3,
+       BSP_ADCTRIPLE_GetSample() and BSP_ADCTRIPLE_Pack() read them in time
+       order. The buffer is circular.
+
+   (#) ADC3 converts last in each period: when its DMA is at half and at the
+       end of the buffer, the first and the second half of the capture are
+       complete. BSP_ADCTRIPLE_HalfCpltCallback() and
+       BSP_ADCTRIPLE_CpltCallback() then run from the DMA interrupt, read
+       that half with BSP_ADCTRIPLE_Pack() before the ADCs write it again.
+
+   (#) The three ADCs have their own offset and gain: an offset mismatch shows
+       as a tone at SampleRate / 3. They are calibrated by Init, correct the
+       rest in the data when it matters.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_adctriple.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ADCTRIPLE BSP ADCTRIPLE
+  * @brief Triple interleaved ADC capture BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Private_Constants BSP ADCTRIPLE Private Constants
+  * @{
+  */
+#define ADCTRIPLE_CONVERSION_HALFCYCLES 25U            /* 12.5 ADC clock cycles at 12 bits            */
+#define ADCTRIPLE_PULSE_OFFSET          1U             /* A compare at 0 keeps the PWM mode 1 output low */
+#define ADCTRIPLE_PERIOD_MAX            0x10000U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Private_Variables BSP ADCTRIPLE Private Variables
+  * @{
+  */
+/* Sampling time in half ADC clock cycles, by ADC_SAMPLETIME_xxx */
+static const uint16_t ADCTRIPLE_SamplingHalfCycles[8] = { 7U, 11U, 15U, 27U, 57U, 83U, 269U, 479U };
+
+static const uint32_t ADCTRIPLE_Triggers[BSP_ADCTRIPLE_ADCS] =
+{
+  ADC_EXTERNALTRIGCONV_T1_CC1, ADC_EXTERNALTRIGCONV_T1_CC2, ADC_EXTERNALTRIGCONV_T1_CC3
+};
+
+static const uint32_t ADCTRIPLE_TimChannels[BSP_ADCTRIPLE_ADCS] =
+{
+  TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3
+};
+
+/* ADC1, ADC2 and ADC3 are used by one capture at a time */
+static BSP_ADCTRIPLE_TypeDef *ADCTRIPLE_Active;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Private_Functions BSP ADCTRIPLE Private Functions
+  * @{
+  */
+static uint32_t ADCTRIPLE_GetTimerClock(void);
+static void     ADCTRIPLE_DMAHalfCplt(DMA_HandleTypeDef *hdma);
+static void     ADCTRIPLE_DMACplt(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ADCTRIPLE_Exported_Functions BSP ADCTRIPLE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the ADCs and the timer of a triple interleaved capture.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @param  hadc1 ADC1 handle, Instance set and DMA linked.
+  * @param  hadc2 ADC2 handle, Instance set and DMA linked.
+  * @param  hadc3 ADC3 handle, Instance set and DMA linked.
+  * @param  htim TIM1 handle, Instance set.
+  * @param  Channel Channel sampled, a value of @ref ADC_channels available on
+  *         the three ADCs.
+  * @param  SamplingTime A value of @ref ADC_sampling_times.
+  * @param  SampleRate Aggregate rate, samples per second.
+  * @retval HAL status, HAL_ERROR when an ADC is too slow for the rate
+  */
+HAL_StatusTypeDef BSP_ADCTRIPLE_Init(BSP_ADCTRIPLE_TypeDef *hadct, ADC_HandleTypeDef *hadc1,
+                                     ADC_HandleTypeDef *hadc2, ADC_HandleTypeDef *hadc3,
+                                     TIM_HandleTypeDef *htim, uint32_t Channel,
+                                     uint32_t SamplingTime, uint32_t SampleRate)
+{
+  ADC_ChannelConfTypeDef sConfig = {0};
+  TIM_OC_InitTypeDef sOC = {0};
+  uint32_t timclk;
+  uint32_t adcclk;
+  uint32_t minperiod;
+  uint32_t prescaler;
+  uint32_t step;
+  uint32_t i;
+
+  if ((hadct == NULL) || (hadc1 == NULL) || (hadc2 == NULL) || (hadc3 == NULL) || (htim == NULL) ||
+      (hadc1->Instance != ADC1) || (hadc2->Instance != ADC2) || (hadc3->Instance != ADC3) ||
+      (htim->Instance != TIM1) || (SampleRate == 0U))
+  {
+    return HAL_ERROR;
+  }
+  assert_param(IS_ADC_SAMPLE_TIME(SamplingTime));
+
+  if (hadct->State == BSP_ADCTRIPLE_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hadct->hadc[0] = hadc1;
+  hadct->hadc[1] = hadc2;
+  hadct->hadc[2] = hadc3;
+  hadct->htim    = htim;
+
+  /* Shortest period of one ADC in timer ticks: sampling and conversion */
+  timclk = ADCTRIPLE_GetTimerClock();
+  adcclk = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC);
+  if (adcclk == 0U)
+  {
+    return HAL_ERROR;
+  }
+  minperiod = (uint32_t)((((uint64_t)(ADCTRIPLE_SamplingHalfCycles[SamplingTime & 0x7U] +
+                                      ADCTRIPLE_CONVERSION_HALFCYCLES) * timclk) +
+                          ((2U * (uint64_t)adcclk) - 1U)) / (2U * (uint64_t)adcclk));
+
+  /* Step between two samples, the period of TIM1 holds three of them */
+  step = timclk / SampleRate;
+  prescaler = (((BSP_ADCTRIPLE_ADCS * step) - 1U) / ADCTRIPLE_PERIOD_MAX) + 1U;
+  step = timclk / (prescaler * SampleRate);
+  if ((step < 2U) || ((BSP_ADCTRIPLE_ADCS * step * prescaler) < minperiod))
+  {
+    return HAL_ERROR;
+  }
+  hadct->Step       = step;
+  hadct->SampleRate = timclk / (prescaler * step);
+
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    hadct->hadc[i]->Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    hadct->hadc[i]->Init.ScanConvMode          = ADC_SCAN_DISABLE;
+    hadct->hadc[i]->Init.ContinuousConvMode    = DISABLE;
+    hadct->hadc[i]->Init.NbrOfConversion       = 1U;
+    hadct->hadc[i]->Init.DiscontinuousConvMode = DISABLE;
+    hadct->hadc[i]->Init.NbrOfDiscConversion   = 1U;
+    hadct->hadc[i]->Init.ExternalTrigConv      = ADCTRIPLE_Triggers[i];
+    if ((hadct->hadc[i]->DMA_Handle == NULL) ||
+        (HAL_ADC_Init(hadct->hadc[i]) != HAL_OK) ||
+        (HAL_ADCEx_Calibration_Start(hadct->hadc[i]) != HAL_OK))
+    {
+      return HAL_ERROR;
+    }
+
+    sConfig.Channel      = Channel;
+    sConfig.Rank         = ADC_REGULAR_RANK_1;
+    sConfig.SamplingTime = SamplingTime;
+    if (HAL_ADC_ConfigChannel(hadct->hadc[i], &sConfig) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  htim->Init.Prescaler         = prescaler - 1U;
+  htim->Init.CounterMode       = TIM_COUNTERMODE_UP;
+  htim->Init.Period            = (BSP_ADCTRIPLE_ADCS * step) - 1U;
+  htim->Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+  htim->Init.RepetitionCounter = 0U;
+  htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_PWM_Init(htim) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* ADC i starts i steps into the period */
+  sOC.OCMode       = TIM_OCMODE_PWM1;
+  sOC.OCPolarity   = TIM_OCPOLARITY_HIGH;
+  sOC.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+  sOC.OCFastMode   = TIM_OCFAST_DISABLE;
+  sOC.OCIdleState  = TIM_OCIDLESTATE_RESET;
+  sOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    sOC.Pulse = (i * step) + ADCTRIPLE_PULSE_OFFSET;
+    if (HAL_TIM_PWM_ConfigChannel(htim, &sOC, ADCTRIPLE_TimChannels[i]) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  hadct->pBuffer = NULL;
+  hadct->Length  = 0U;
+  hadct->State   = BSP_ADCTRIPLE_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the capture.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @param  pBuffer Capture buffer of BSP_ADCTRIPLE_ADCS x Length halfwords.
+  * @param  Length Samples per ADC, even, 2 to 0xFFFE.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCTRIPLE_Start(BSP_ADCTRIPLE_TypeDef *hadct, uint16_t *pBuffer, uint32_t Length)
+{
+  uint32_t i;
+
+  if ((pBuffer == NULL) || (Length < 2U) || (Length > 0xFFFFU) || ((Length & 1U) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hadct->State != BSP_ADCTRIPLE_STATE_READY) || (ADCTRIPLE_Active != NULL))
+  {
+    return HAL_BUSY;
+  }
+
+  hadct->pBuffer   = pBuffer;
+  hadct->Length    = Length;
+  ADCTRIPLE_Active = hadct;
+
+  /* The ADCs wait for their compare, the timer is stopped */
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    if (HAL_ADC_Start_DMA(hadct->hadc[i], (uint32_t *)&pBuffer[i * Length], Length) != HAL_OK)
+    {
+      while (i > 0U)
+      {
+        i--;
+        (void)HAL_ADC_Stop_DMA(hadct->hadc[i]);
+      }
+      ADCTRIPLE_Active = NULL;
+      return HAL_ERROR;
+    }
+  }
+
+  /* ADC3 completes each period: its DMA alone signals the halves */
+  __HAL_DMA_DISABLE_IT(hadct->hadc[0]->DMA_Handle, DMA_IT_TC | DMA_IT_HT);
+  __HAL_DMA_DISABLE_IT(hadct->hadc[1]->DMA_Handle, DMA_IT_TC | DMA_IT_HT);
+  hadct->hadc[2]->DMA_Handle->XferHalfCpltCallback = ADCTRIPLE_DMAHalfCplt;
+  hadct->hadc[2]->DMA_Handle->XferCpltCallback     = ADCTRIPLE_DMACplt;
+
+  hadct->State = BSP_ADCTRIPLE_STATE_RUN;
+
+  __HAL_TIM_SET_COUNTER(hadct->htim, 0U);
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    TIM_CCxChannelCmd(hadct->htim->Instance, ADCTRIPLE_TimChannels[i], TIM_CCx_ENABLE);
+  }
+  __HAL_TIM_MOE_ENABLE(hadct->htim);
+  __HAL_TIM_ENABLE(hadct->htim);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the capture.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ADCTRIPLE_Stop(BSP_ADCTRIPLE_TypeDef *hadct)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t i;
+
+  if (hadct->State != BSP_ADCTRIPLE_STATE_RUN)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    TIM_CCxChannelCmd(hadct->htim->Instance, ADCTRIPLE_TimChannels[i], TIM_CCx_DISABLE);
+  }
+  __HAL_TIM_MOE_DISABLE(hadct->htim);
+  __HAL_TIM_DISABLE(hadct->htim);
+
+  for (i = 0U; i < BSP_ADCTRIPLE_ADCS; i++)
+  {
+    if (HAL_ADC_Stop_DMA(hadct->hadc[i]) != HAL_OK)
+    {
+      status = HAL_ERROR;
+    }
+  }
+
+  ADCTRIPLE_Active = NULL;
+  hadct->State     = BSP_ADCTRIPLE_STATE_READY;
+
+  return status;
+}
+
+/**
+  * @brief  Get a sample of the capture in time order.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @param  Index Sample of the capture, taken modulo BSP_ADCTRIPLE_ADCS x Length.
+  * @retval Conversion result
+  */
+uint16_t BSP_ADCTRIPLE_GetSample(const BSP_ADCTRIPLE_TypeDef *hadct, uint32_t Index)
+{
+  Index %= BSP_ADCTRIPLE_ADCS * hadct->Length;
+
+  return hadct->pBuffer[((Index % BSP_ADCTRIPLE_ADCS) * hadct->Length) + (Index / BSP_ADCTRIPLE_ADCS)];
+}
+
+/**
+  * @brief  Copy samples of the capture in time order.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @param  pDst Destination of Count halfwords.
+  * @param  Index First sample of the capture, wraps at BSP_ADCTRIPLE_ADCS x Length.
+  * @param  Count Samples copied.
+  * @retval None
+  */
+void BSP_ADCTRIPLE_Pack(const BSP_ADCTRIPLE_TypeDef *hadct, uint16_t *pDst,
+                        uint32_t Index, uint32_t Count)
+{
+  const uint16_t *pSrc[BSP_ADCTRIPLE_ADCS];
+  uint32_t length = hadct->Length;
+  uint32_t adc;
+  uint32_t n;
+
+  for (adc = 0U; adc < BSP_ADCTRIPLE_ADCS; adc++)
+  {
+    pSrc[adc] = &hadct->pBuffer[adc * length];
+  }
+
+  Index %= BSP_ADCTRIPLE_ADCS * length;
+  adc = Index % BSP_ADCTRIPLE_ADCS;
+  n   = Index / BSP_ADCTRIPLE_ADCS;
+  while (Count > 0U)
+  {
+    *pDst++ = pSrc[adc][n];
+    Count--;
+    adc++;
+    if (adc == BSP_ADCTRIPLE_ADCS)
+    {
+      adc = 0U;
+      n++;
+      if (n == length)
+      {
+        n = 0U;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  First half of the capture complete callback.
+  * @note   Samples 0 to (BSP_ADCTRIPLE_ADCS x Length / 2) - 1 are complete.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCTRIPLE_HalfCpltCallback(BSP_ADCTRIPLE_TypeDef *hadct)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hadct);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCTRIPLE_HalfCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Second half of the capture complete callback.
+  * @note   Samples BSP_ADCTRIPLE_ADCS x Length / 2 to the end are complete.
+  * @param  hadct Pointer to a BSP_ADCTRIPLE_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_ADCTRIPLE_CpltCallback(BSP_ADCTRIPLE_TypeDef *hadct)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hadct);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ADCTRIPLE_CpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ADCTRIPLE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the clock of TIM1, PCLK2 doubled when APB2 is divided.
+  * @retval Frequency in Hz
+  */
+static uint32_t ADCTRIPLE_GetTimerClock(void)
+{
+  uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+
+  return (pclk2 == HAL_RCC_GetHCLKFreq()) ? pclk2 : (2U * pclk2);
+}
+
+/**
+  * @brief  DMA half transfer complete callback of ADC3.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCTRIPLE_DMAHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if (ADCTRIPLE_Active != NULL)
+  {
+    BSP_ADCTRIPLE_HalfCpltCallback(ADCTRIPLE_Active);
+  }
+}
+
+/**
+  * @brief  DMA transfer complete callback of ADC3.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void ADCTRIPLE_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if (ADCTRIPLE_Active != NULL)
+  {
+    BSP_ADCTRIPLE_CpltCallback(ADCTRIPLE_Active);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
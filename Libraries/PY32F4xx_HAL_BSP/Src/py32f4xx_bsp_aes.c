@@ -0,0 +1,1371 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_aes.c
+  * @author  MCU Application Team
+  * @brief   AES link encryption BSP service.
+  *          This file provides functions to encrypt and authenticate the
+  *          messages of the CAN, ISO-TP and UART links in software:
+  *           + AES-128 and AES-256, T-table or bitsliced constant time engine
+  *           + CTR mode, GCM mode with tags of 4 to 16 bytes
+  *           + Records sealed and opened in place in the transfer buffers,
+  *             replays refused
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) BSP_AES_Init() expands a 16 or 32 byte key for one of the engines:
+       (+) BSP_AES_ENGINE_TABLE: one 1 Kbyte table and the S-box, built in
+           SRAM by the first BSP_AES_Init(), rotated with __ROR() for the
+           four columns. The SRAM has no cache and no wait state: the time
+           of a lookup does not depend on its address on this core, the
+           tables are never read from the flash and its cache.
+       (+) BSP_AES_ENGINE_CONSTTIME: bitsliced rounds, two blocks at once,
+           and a bitwise GHASH: no address depends on the key or the data,
+           for the cores and memories where it matters. About three times
+           slower.
+
+   (#) BSP_AES_CtrCrypt() encrypts or decrypts in CTR mode, the last 4 bytes
+       of the counter block counting the blocks, big endian. A message given
+       in several calls is given in multiples of BSP_AES_BLOCK_SIZE but for
+       the last call. pIn and pOut may be the same buffer.
+
+   (#) GCM: BSP_AES_GcmInit() once per key, then for each message
+       BSP_AES_GcmStart() with a 12 byte IV never used before with the key,
+       BSP_AES_GcmAad() with the data only authenticated, BSP_AES_GcmEncrypt()
+       or BSP_AES_GcmDecrypt() with the text in pieces of any size, in place
+       or not, and BSP_AES_GcmFinish() or BSP_AES_GcmCheck() for the tag.
+       Decrypted text is not to be used before BSP_AES_GcmCheck() returns
+       HAL_OK.
+
+   (#) Records of a link, the transfer buffers encrypted in place:
+       (+) BSP_AES_LinkInit() with the key and a salt of 8 bytes for each
+           direction, the TxSalt of one end being the RxSalt of the other:
+           the IV of a record is the salt of its direction followed by its
+           sequence, never the same twice for a key.
+       (+) BSP_AES_LinkSeal() encrypts Length bytes in place and appends the
+           sequence and the tag: the buffer holds
+           BSP_AES_LINK_OVERHEAD(TagSize) bytes more. Sealing stops after
+           0xFFFFFFFF records, a new key is then needed.
+       (+) BSP_AES_LinkOpen() checks the sequence, higher than the last one
+           opened, and the tag, before decrypting the payload in place: a
+           refused record is left as received. BSP_AES_LinkOpenSplit() opens
+           a record split in two parts, a frame of BSP_FRAME_Get() wrapping
+           at the end of the ring for example.
+       [..]
+       On the links:
+       (+) ISO-TP: seal the message before BSP_ISOTP_Send(), open
+           pRxBuffer in BSP_ISOTP_RxCpltCallback(), 4095 bytes with the
+           overhead.
+       (+) CAN FD: seal the payload of the frame before BSP_CANTX_Send(),
+           a 4 or 8 byte tag leaving 56 or 52 bytes of a 64 byte frame.
+       (+) UART: seal the frame before BSP_SERIAL_Write(), open the frames
+           of BSP_FRAME_Get() with BSP_AES_LinkOpenSplit().
+       Sealing and opening run from one context each, the two directions
+       of a link from different ones if needed.
+
+   (#) Built with -O3 in the speed profile from HOT_SOURCES of the Makefile.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_aes.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_AES BSP AES
+  * @brief AES link encryption BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_AES_Private_Constants BSP AES Private Constants
+  * @{
+  */
+#define AES_WORDS_MAX                   60U            /* Round key words of AES-256             */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_AES_Private_Macros BSP AES Private Macros
+  * @{
+  */
+/* Byte __N__ of a word, the first one in memory being 0 */
+#define AES_BYTE(__X__, __N__)          (((__X__) >> (8U * (__N__))) & 0xFFU)
+
+/* Bits of the masks __CL__, and of __CH__ shifted by __S__, exchanged between
+   two words of the bitsliced state */
+#define AES_SWAP(__CL__, __CH__, __S__, __X__, __Y__)                                          \
+  do                                                                                          \
+  {                                                                                           \
+    uint32_t a_ = (__X__);                                                                    \
+    uint32_t b_ = (__Y__);                                                                    \
+    (__X__) = (a_ & (__CL__)) | ((b_ & (__CL__)) << (__S__));                                 \
+    (__Y__) = ((a_ & (__CH__)) >> (__S__)) | (b_ & (__CH__));                                 \
+  } while (0U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_AES_Private_Variables BSP AES Private Variables
+  * @{
+  */
+/* Table engine, built in SRAM by the first BSP_AES_Init() */
+static uint32_t AES_T0[256];
+static uint8_t  AES_SBox[256];
+static uint32_t AES_TablesReady;
+
+/* GHASH reduction of the 4 bits shifted out, high 16 bits */
+static const uint16_t AES_Last4[16] =
+{
+  0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+  0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_AES_Private_Functions
+  * @{
+  */
+static void AES_BuildTables(void);
+static uint32_t AES_SubWord(uint32_t Engine, uint32_t Word);
+static void AES_Ortho(uint32_t *q);
+static void AES_SBoxBitsliced(uint32_t *q);
+static void AES_ShiftRows(uint32_t *q);
+static void AES_MixColumns(uint32_t *q);
+static void AES_Blocks(const BSP_AES_TypeDef *haes, const uint32_t *pIn, uint32_t *pOut, uint32_t Blocks);
+static void AES_Xor(uint8_t *pOut, const uint8_t *pIn, const uint8_t *pStream, uint32_t Size);
+static uint32_t AES_Load32BE(const uint8_t *pData);
+static void AES_GhashMult(BSP_AES_GcmTypeDef *hgcm);
+static void AES_GhashBlock(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pBlock);
+static void AES_GhashFlush(BSP_AES_GcmTypeDef *hgcm);
+static void AES_GcmHash(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pData, uint32_t Size);
+static void AES_GcmText(BSP_AES_GcmTypeDef *hgcm, uint32_t Size);
+static void AES_GcmCtr(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size);
+static void AES_LinkIv(const uint8_t *pSalt, uint32_t Sequence, uint8_t *pIv);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_AES_Exported_Functions BSP AES Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_AES_Exported_Functions_Group1 Cipher functions
+  * @brief    Cipher functions
+  *
+@verbatim
+ ===============================================================================
+                         ##### Cipher functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Expand a key for one of the engines
+      (+) Encrypt a block
+      (+) Encrypt or decrypt in CTR mode
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Expand a key.
+  * @param  haes Pointer to a BSP_AES_TypeDef structure.
+  * @param  pKey Key.
+  * @param  KeySize BSP_AES_KEY_128 or BSP_AES_KEY_256.
+  * @param  Engine A value of @ref BSP_AES_Engine.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_AES_Init(BSP_AES_TypeDef *haes, const uint8_t *pKey, uint32_t KeySize, uint32_t Engine)
+{
+  uint32_t w[AES_WORDS_MAX];
+  uint32_t q[8];
+  uint32_t nk = KeySize / 4U;
+  uint32_t total;
+  uint32_t rcon = 0x01U;
+  uint32_t t;
+  uint32_t i;
+  uint32_t j;
+
+  if ((haes == NULL) || (pKey == NULL) || ((KeySize != BSP_AES_KEY_128) && (KeySize != BSP_AES_KEY_256)) ||
+      ((Engine != BSP_AES_ENGINE_TABLE) && (Engine != BSP_AES_ENGINE_CONSTTIME)))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((Engine == BSP_AES_ENGINE_TABLE) && (AES_TablesReady == 0U))
+  {
+    AES_BuildTables();
+  }
+
+  haes->Engine = Engine;
+  haes->Rounds = nk + 6U;
+  total = 4U * (haes->Rounds + 1U);
+
+  /* Key expansion on words as in memory, the first byte in the low bits */
+  memcpy(w, pKey, KeySize);
+  for (i = nk; i < total; i++)
+  {
+    t = w[i - 1U];
+    if ((i % nk) == 0U)
+    {
+      t = AES_SubWord(Engine, __ROR(t, 8U)) ^ rcon;
+      rcon = (rcon << 1U) ^ (((rcon >> 7U) & 1U) * 0x11BU);
+    }
+    else if ((nk > 6U) && ((i % nk) == 4U))
+    {
+      t = AES_SubWord(Engine, t);
+    }
+    w[i] = w[i - nk] ^ t;
+  }
+
+  if (Engine == BSP_AES_ENGINE_TABLE)
+  {
+    memcpy(haes->RoundKey, w, total * 4U);
+  }
+  else
+  {
+    /* The same round key for the two blocks of the bitsliced state */
+    for (i = 0U; i < total; i += 4U)
+    {
+      for (j = 0U; j < 4U; j++)
+      {
+        q[2U * j]      = w[i + j];
+        q[(2U * j) + 1U] = w[i + j];
+      }
+      AES_Ortho(q);
+      memcpy(&haes->RoundKey[2U * i], q, sizeof(q));
+    }
+  }
+
+  memset(w, 0, sizeof(w));
+  memset(q, 0, sizeof(q));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Encrypt a block.
+  * @param  haes Pointer to a BSP_AES_TypeDef structure.
+  * @param  pIn Block.
+  * @param  pOut Encrypted block, may be pIn.
+  * @retval None
+  */
+void BSP_AES_Encrypt(const BSP_AES_TypeDef *haes, const uint8_t *pIn, uint8_t *pOut)
+{
+  uint32_t block[4];
+
+  memcpy(block, pIn, BSP_AES_BLOCK_SIZE);
+  AES_Blocks(haes, block, block, 1U);
+  memcpy(pOut, block, BSP_AES_BLOCK_SIZE);
+}
+
+/**
+  * @brief  Encrypt or decrypt in CTR mode.
+  * @param  haes Pointer to a BSP_AES_TypeDef structure.
+  * @param  pCounter Counter block, its last 4 bytes incremented for each
+  *         block, big endian: the counter of the next call.
+  * @param  pIn Text.
+  * @param  pOut Text encrypted or decrypted, may be pIn.
+  * @param  Size Bytes of text, a multiple of BSP_AES_BLOCK_SIZE but for the
+  *         last call of a message.
+  * @retval None
+  */
+void BSP_AES_CtrCrypt(const BSP_AES_TypeDef *haes, uint8_t *pCounter, const uint8_t *pIn,
+                      uint8_t *pOut, uint32_t Size)
+{
+  uint32_t ctr[8];
+  uint32_t stream[8];
+  uint32_t count = AES_Load32BE(&pCounter[12]);
+  uint32_t blocks;
+  uint32_t chunk;
+
+  memcpy(ctr, pCounter, 12U);
+  memcpy(&ctr[4], pCounter, 12U);
+
+  while (Size != 0U)
+  {
+    blocks = ((haes->Engine == BSP_AES_ENGINE_CONSTTIME) && (Size > BSP_AES_BLOCK_SIZE)) ? 2U : 1U;
+    ctr[3] = __REV(count);
+    ctr[7] = __REV(count + 1U);
+    AES_Blocks(haes, ctr, stream, blocks);
+
+    chunk = blocks * BSP_AES_BLOCK_SIZE;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    AES_Xor(pOut, pIn, (const uint8_t *)stream, chunk);
+    pIn   += chunk;
+    pOut  += chunk;
+    Size  -= chunk;
+    count += blocks;
+  }
+
+  count = __REV(count);
+  memcpy(&pCounter[12], &count, 4U);
+  memset(stream, 0, sizeof(stream));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_AES_Exported_Functions_Group2 GCM functions
+  * @brief    GCM functions
+  *
+@verbatim
+ ===============================================================================
+                          ##### GCM functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Derive the hash key of a cipher key
+      (+) Encrypt or decrypt a message with its additional data
+      (+) Make or check the tag
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Derive the hash key and its tables.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  haes Cipher key, kept by reference.
+  * @retval None
+  */
+void BSP_AES_GcmInit(BSP_AES_GcmTypeDef *hgcm, const BSP_AES_TypeDef *haes)
+{
+  uint32_t zero[4] = {0U, 0U, 0U, 0U};
+  uint64_t vh;
+  uint64_t vl;
+  uint32_t reduce;
+  uint32_t i;
+  uint32_t j;
+
+  memset(hgcm, 0, sizeof(BSP_AES_GcmTypeDef));
+  hgcm->haes       = haes;
+  hgcm->StreamSize = (haes->Engine == BSP_AES_ENGINE_CONSTTIME) ? (2U * BSP_AES_BLOCK_SIZE) : BSP_AES_BLOCK_SIZE;
+
+  /* H = E(K, 0) */
+  AES_Blocks(haes, zero, hgcm->H, 1U);
+  for (i = 0U; i < 4U; i++)
+  {
+    hgcm->H[i] = __REV(hgcm->H[i]);
+  }
+
+  if (haes->Engine == BSP_AES_ENGINE_CONSTTIME)
+  {
+    return;
+  }
+
+  /* Products of H by the 4-bit values, bit 3 being H itself */
+  vh = ((uint64_t)hgcm->H[0] << 32U) | hgcm->H[1];
+  vl = ((uint64_t)hgcm->H[2] << 32U) | hgcm->H[3];
+  hgcm->HH[8] = vh;
+  hgcm->HL[8] = vl;
+  for (i = 4U; i != 0U; i >>= 1U)
+  {
+    reduce = ((uint32_t)vl & 1U) * 0xE1000000U;
+    vl = (vh << 63U) | (vl >> 1U);
+    vh = (vh >> 1U) ^ ((uint64_t)reduce << 32U);
+    hgcm->HH[i] = vh;
+    hgcm->HL[i] = vl;
+  }
+  for (i = 2U; i <= 8U; i <<= 1U)
+  {
+    for (j = 1U; j < i; j++)
+    {
+      hgcm->HH[i + j] = hgcm->HH[i] ^ hgcm->HH[j];
+      hgcm->HL[i + j] = hgcm->HL[i] ^ hgcm->HL[j];
+    }
+  }
+}
+
+/**
+  * @brief  Start a message.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pIv BSP_AES_IV_SIZE bytes, never used before with the key.
+  * @retval None
+  */
+void BSP_AES_GcmStart(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIv)
+{
+  uint32_t j0[4];
+
+  memcpy(hgcm->Iv, pIv, BSP_AES_IV_SIZE);
+  memcpy(j0, pIv, BSP_AES_IV_SIZE);
+  j0[3] = __REV(1U);
+  AES_Blocks(hgcm->haes, j0, hgcm->EkJ0, 1U);
+
+  hgcm->Count       = 2U;
+  hgcm->StreamUsed  = hgcm->StreamSize;
+  hgcm->PartialFill = 0U;
+  hgcm->AadSize     = 0U;
+  hgcm->TextSize    = 0U;
+  memset(hgcm->Y, 0, sizeof(hgcm->Y));
+}
+
+/**
+  * @brief  Authenticate additional data, before the text.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pAad Additional data.
+  * @param  Size Bytes of additional data.
+  * @retval None
+  */
+void BSP_AES_GcmAad(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pAad, uint32_t Size)
+{
+  AES_GcmHash(hgcm, pAad, Size);
+  hgcm->AadSize += Size;
+}
+
+/**
+  * @brief  Encrypt the next piece of the text.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pIn Plain text.
+  * @param  pOut Cipher text, may be pIn.
+  * @param  Size Bytes of text.
+  * @retval None
+  */
+void BSP_AES_GcmEncrypt(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size)
+{
+  AES_GcmText(hgcm, Size);
+  AES_GcmCtr(hgcm, pIn, pOut, Size);
+  AES_GcmHash(hgcm, pOut, Size);
+}
+
+/**
+  * @brief  Decrypt the next piece of the text.
+  * @note   The plain text is authenticated by BSP_AES_GcmCheck() only.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pIn Cipher text.
+  * @param  pOut Plain text, may be pIn.
+  * @param  Size Bytes of text.
+  * @retval None
+  */
+void BSP_AES_GcmDecrypt(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size)
+{
+  AES_GcmText(hgcm, Size);
+  AES_GcmHash(hgcm, pIn, Size);
+  AES_GcmCtr(hgcm, pIn, pOut, Size);
+}
+
+/**
+  * @brief  End the message and give its tag.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pTag Tag.
+  * @param  TagSize Bytes of the tag, BSP_AES_TAG_MIN to BSP_AES_TAG_MAX.
+  * @retval None
+  */
+void BSP_AES_GcmFinish(BSP_AES_GcmTypeDef *hgcm, uint8_t *pTag, uint32_t TagSize)
+{
+  uint32_t tag[4];
+  uint32_t i;
+
+  AES_GhashFlush(hgcm);
+  hgcm->Y[0] ^= hgcm->AadSize >> 29U;
+  hgcm->Y[1] ^= hgcm->AadSize << 3U;
+  hgcm->Y[2] ^= hgcm->TextSize >> 29U;
+  hgcm->Y[3] ^= hgcm->TextSize << 3U;
+  AES_GhashMult(hgcm);
+
+  for (i = 0U; i < 4U; i++)
+  {
+    tag[i] = __REV(hgcm->Y[i]) ^ hgcm->EkJ0[i];
+  }
+  memcpy(pTag, tag, (TagSize > BSP_AES_TAG_MAX) ? BSP_AES_TAG_MAX : TagSize);
+}
+
+/**
+  * @brief  End the message and compare its tag, in constant time.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pTag Tag received.
+  * @param  TagSize Bytes of the tag, BSP_AES_TAG_MIN to BSP_AES_TAG_MAX.
+  * @retval HAL status, HAL_OK when the tag is the one of the message
+  */
+HAL_StatusTypeDef BSP_AES_GcmCheck(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pTag, uint32_t TagSize)
+{
+  uint8_t tag[BSP_AES_TAG_MAX];
+  uint32_t diff = 0U;
+  uint32_t i;
+
+  if ((TagSize < BSP_AES_TAG_MIN) || (TagSize > BSP_AES_TAG_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  BSP_AES_GcmFinish(hgcm, tag, TagSize);
+  for (i = 0U; i < TagSize; i++)
+  {
+    diff |= (uint32_t)tag[i] ^ pTag[i];
+  }
+
+  return (diff == 0U) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_AES_Exported_Functions_Group3 Link functions
+  * @brief    Link functions
+  *
+@verbatim
+ ===============================================================================
+                          ##### Link functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Set the key and the salts of a link
+      (+) Seal and open its records in place
+      (+) Get its statistics
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a link.
+  * @param  hlink Pointer to a BSP_AES_LinkTypeDef structure.
+  * @param  haes Cipher key, kept by reference.
+  * @param  pTxSalt BSP_AES_SALT_SIZE bytes of the records sent.
+  * @param  pRxSalt BSP_AES_SALT_SIZE bytes of the records received, not
+  *         pTxSalt.
+  * @param  TagSize Bytes of the tag of a record, BSP_AES_TAG_MIN to
+  *         BSP_AES_TAG_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_AES_LinkInit(BSP_AES_LinkTypeDef *hlink, const BSP_AES_TypeDef *haes, const uint8_t *pTxSalt,
+                                   const uint8_t *pRxSalt, uint32_t TagSize)
+{
+  if ((hlink == NULL) || (haes == NULL) || (pTxSalt == NULL) || (pRxSalt == NULL) ||
+      (memcmp(pTxSalt, pRxSalt, BSP_AES_SALT_SIZE) == 0) ||
+      (TagSize < BSP_AES_TAG_MIN) || (TagSize > BSP_AES_TAG_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  memset(hlink, 0, sizeof(BSP_AES_LinkTypeDef));
+  BSP_AES_GcmInit(&hlink->Tx, haes);
+  BSP_AES_GcmInit(&hlink->Rx, haes);
+  memcpy(hlink->TxSalt, pTxSalt, BSP_AES_SALT_SIZE);
+  memcpy(hlink->RxSalt, pRxSalt, BSP_AES_SALT_SIZE);
+  hlink->TagSize = TagSize;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Seal a record in place.
+  * @param  hlink Pointer to a BSP_AES_LinkTypeDef structure.
+  * @param  pRecord Payload, encrypted in place, followed by room for
+  *         BSP_AES_LINK_OVERHEAD(TagSize) bytes.
+  * @param  Length Bytes of payload.
+  * @retval HAL status, HAL_ERROR once all the sequences of the key are used
+  */
+HAL_StatusTypeDef BSP_AES_LinkSeal(BSP_AES_LinkTypeDef *hlink, uint8_t *pRecord, uint32_t Length)
+{
+  uint8_t iv[BSP_AES_IV_SIZE];
+  uint32_t sequence;
+
+  if ((pRecord == NULL) || (hlink->TxSequence == 0xFFFFFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  hlink->TxSequence++;
+  AES_LinkIv(hlink->TxSalt, hlink->TxSequence, iv);
+  BSP_AES_GcmStart(&hlink->Tx, iv);
+  BSP_AES_GcmEncrypt(&hlink->Tx, pRecord, pRecord, Length);
+
+  sequence = __REV(hlink->TxSequence);
+  memcpy(&pRecord[Length], &sequence, BSP_AES_SEQUENCE_SIZE);
+  BSP_AES_GcmFinish(&hlink->Tx, &pRecord[Length + BSP_AES_SEQUENCE_SIZE], hlink->TagSize);
+  hlink->Stats.Sealed++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Open a record in place.
+  * @param  hlink Pointer to a BSP_AES_LinkTypeDef structure.
+  * @param  pRecord Record, its payload decrypted in place when accepted.
+  * @param  Length Bytes of the record, with the overhead.
+  * @retval HAL status, HAL_ERROR for a replayed, forged or short record
+  */
+HAL_StatusTypeDef BSP_AES_LinkOpen(BSP_AES_LinkTypeDef *hlink, uint8_t *pRecord, uint32_t Length)
+{
+  return BSP_AES_LinkOpenSplit(hlink, pRecord, Length, NULL, 0U);
+}
+
+/**
+  * @brief  Open a record in place, split in two parts.
+  * @param  hlink Pointer to a BSP_AES_LinkTypeDef structure.
+  * @param  pData First part of the record.
+  * @param  Length Bytes of the first part.
+  * @param  pWrap Second part of the record, may be NULL.
+  * @param  WrapLength Bytes of the second part, 0 when the record is not
+  *         split.
+  * @retval HAL status, HAL_ERROR for a replayed, forged or short record
+  */
+HAL_StatusTypeDef BSP_AES_LinkOpenSplit(BSP_AES_LinkTypeDef *hlink, uint8_t *pData, uint32_t Length,
+                                        uint8_t *pWrap, uint32_t WrapLength)
+{
+  uint8_t trailer[BSP_AES_LINK_OVERHEAD(BSP_AES_TAG_MAX)];
+  uint8_t iv[BSP_AES_IV_SIZE];
+  uint32_t overhead = BSP_AES_LINK_OVERHEAD(hlink->TagSize);
+  uint32_t payload;
+  uint32_t first;
+  uint32_t sequence;
+  uint32_t i;
+
+  if ((pData == NULL) || ((pWrap == NULL) && (WrapLength != 0U)) || ((Length + WrapLength) < overhead))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The trailer may be split too */
+  payload = Length + WrapLength - overhead;
+  for (i = 0U; i < overhead; i++)
+  {
+    trailer[i] = ((payload + i) < Length) ? pData[payload + i] : pWrap[payload + i - Length];
+  }
+  first = (payload < Length) ? payload : Length;
+
+  sequence = AES_Load32BE(trailer);
+  if (sequence <= hlink->RxSequence)
+  {
+    hlink->Stats.Replayed++;
+    return HAL_ERROR;
+  }
+
+  /* Authenticated before any byte is decrypted */
+  AES_LinkIv(hlink->RxSalt, sequence, iv);
+  BSP_AES_GcmStart(&hlink->Rx, iv);
+  AES_GcmText(&hlink->Rx, payload);
+  AES_GcmHash(&hlink->Rx, pData, first);
+  if (first != payload)
+  {
+    AES_GcmHash(&hlink->Rx, pWrap, payload - first);
+  }
+  if (BSP_AES_GcmCheck(&hlink->Rx, &trailer[BSP_AES_SEQUENCE_SIZE], hlink->TagSize) != HAL_OK)
+  {
+    hlink->Stats.Forged++;
+    return HAL_ERROR;
+  }
+
+  hlink->Rx.Count      = 2U;
+  hlink->Rx.StreamUsed = hlink->Rx.StreamSize;
+  AES_GcmCtr(&hlink->Rx, pData, pData, first);
+  if (first != payload)
+  {
+    AES_GcmCtr(&hlink->Rx, pWrap, pWrap, payload - first);
+  }
+
+  hlink->RxSequence = sequence;
+  hlink->Stats.Opened++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the statistics of a link.
+  * @param  hlink Pointer to a BSP_AES_LinkTypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_AES_LinkGetStats(const BSP_AES_LinkTypeDef *hlink, BSP_AES_LinkStatsTypeDef *pStats)
+{
+  *pStats = hlink->Stats;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_AES_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Build the S-box and the T-table of the table engine.
+  * @retval None
+  */
+static void AES_BuildTables(void)
+{
+  uint32_t p = 1U;
+  uint32_t q = 1U;
+  uint32_t s;
+  uint32_t s2;
+
+  /* p runs over the multiplicative group by 3, q over the inverses by 1/3 */
+  do
+  {
+    p = p ^ (p << 1U) ^ (((p >> 7U) & 1U) * 0x1BU);
+    p &= 0xFFU;
+    q ^= q << 1U;
+    q ^= q << 2U;
+    q ^= q << 4U;
+    q &= 0xFFU;
+    q ^= ((q >> 7U) & 1U) * 0x09U;
+    s = q ^ (q << 1U) ^ (q << 2U) ^ (q << 3U) ^ (q << 4U);
+    s = (s ^ (s >> 8U) ^ 0x63U) & 0xFFU;
+    AES_SBox[p] = (uint8_t)s;
+  } while (p != 1U);
+  AES_SBox[0] = 0x63U;
+
+  /* Column of MixColumns on a byte of row 0: 2S, S, S, 3S */
+  for (p = 0U; p < 256U; p++)
+  {
+    s  = AES_SBox[p];
+    s2 = ((s << 1U) ^ (((s >> 7U) & 1U) * 0x11BU)) & 0xFFU;
+    AES_T0[p] = s2 | (s << 8U) | (s << 16U) | ((s2 ^ s) << 24U);
+  }
+
+  AES_TablesReady = 1U;
+}
+
+/**
+  * @brief  S-box of the 4 bytes of a word.
+  * @param  Engine A value of @ref BSP_AES_Engine.
+  * @param  Word Word.
+  * @retval Word substituted
+  */
+static uint32_t AES_SubWord(uint32_t Engine, uint32_t Word)
+{
+  uint32_t q[8];
+
+  if (Engine == BSP_AES_ENGINE_TABLE)
+  {
+    return (uint32_t)AES_SBox[AES_BYTE(Word, 0U)] | ((uint32_t)AES_SBox[AES_BYTE(Word, 1U)] << 8U) |
+           ((uint32_t)AES_SBox[AES_BYTE(Word, 2U)] << 16U) | ((uint32_t)AES_SBox[AES_BYTE(Word, 3U)] << 24U);
+  }
+
+  memset(q, 0, sizeof(q));
+  q[0] = Word;
+  AES_Ortho(q);
+  AES_SBoxBitsliced(q);
+  AES_Ortho(q);
+
+  return q[0];
+}
+
+/**
+  * @brief  Move between 8 words of two blocks and their 8 bit planes, its
+  *         own inverse.
+  * @param  q Blocks in the even and odd words, bit planes.
+  * @retval None
+  */
+static void AES_Ortho(uint32_t *q)
+{
+  AES_SWAP(0x55555555U, 0xAAAAAAAAU, 1U, q[0], q[1]);
+  AES_SWAP(0x55555555U, 0xAAAAAAAAU, 1U, q[2], q[3]);
+  AES_SWAP(0x55555555U, 0xAAAAAAAAU, 1U, q[4], q[5]);
+  AES_SWAP(0x55555555U, 0xAAAAAAAAU, 1U, q[6], q[7]);
+
+  AES_SWAP(0x33333333U, 0xCCCCCCCCU, 2U, q[0], q[2]);
+  AES_SWAP(0x33333333U, 0xCCCCCCCCU, 2U, q[1], q[3]);
+  AES_SWAP(0x33333333U, 0xCCCCCCCCU, 2U, q[4], q[6]);
+  AES_SWAP(0x33333333U, 0xCCCCCCCCU, 2U, q[5], q[7]);
+
+  AES_SWAP(0x0F0F0F0FU, 0xF0F0F0F0U, 4U, q[0], q[4]);
+  AES_SWAP(0x0F0F0F0FU, 0xF0F0F0F0U, 4U, q[1], q[5]);
+  AES_SWAP(0x0F0F0F0FU, 0xF0F0F0F0U, 4U, q[2], q[6]);
+  AES_SWAP(0x0F0F0F0FU, 0xF0F0F0F0U, 4U, q[3], q[7]);
+}
+
+/**
+  * @brief  S-box of the 32 bytes of the bitsliced state, the circuit of
+  *         Boyar and Peralta: 113 logic operations, no table.
+  * @param  q Bit planes, q[0] the lowest bits.
+  * @retval None
+  */
+static void AES_SBoxBitsliced(uint32_t *q)
+{
+  uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+  uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+  uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+  uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+  uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+  uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+  uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation */
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9  = x0 ^ x3;
+  y8  = x0 ^ x5;
+  t0  = x1 ^ x2;
+  y1  = t0 ^ x7;
+  y4  = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2  = y1 ^ x0;
+  y5  = y1 ^ x6;
+  y3  = y5 ^ y8;
+  t1  = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6  = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7  = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non linear section, the inversion in GF(2^4)^2 */
+  t2  = y12 & y15;
+  t3  = y3 & y6;
+  t4  = t3 ^ t2;
+  t5  = y4 & x7;
+  t6  = t5 ^ t2;
+  t7  = y13 & y16;
+  t8  = y5 & y1;
+  t9  = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0  = t44 & y15;
+  z1  = t37 & y6;
+  z2  = t33 & x7;
+  z3  = t43 & y16;
+  z4  = t40 & y1;
+  z5  = t29 & y7;
+  z6  = t42 & y11;
+  z7  = t45 & y17;
+  z8  = t41 & y10;
+  z9  = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation, the affine constant in the complements */
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0  = t59 ^ t63;
+  s6  = t56 ^ ~t62;
+  s7  = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3  = t53 ^ t66;
+  s4  = t51 ^ t66;
+  s5  = t47 ^ t65;
+  s1  = t64 ^ ~s3;
+  s2  = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+}
+
+/**
+  * @brief  ShiftRows of the bitsliced state.
+  * @param  q Bit planes.
+  * @retval None
+  */
+static void AES_ShiftRows(uint32_t *q)
+{
+  uint32_t x;
+  uint32_t i;
+
+  for (i = 0U; i < 8U; i++)
+  {
+    x = q[i];
+    q[i] = (x & 0x000000FFU) |
+           ((x & 0x0000FC00U) >> 2U) | ((x & 0x00000300U) << 6U) |
+           ((x & 0x00F00000U) >> 4U) | ((x & 0x000F0000U) << 4U) |
+           ((x & 0xC0000000U) >> 6U) | ((x & 0x3F000000U) << 2U);
+  }
+}
+
+/**
+  * @brief  MixColumns of the bitsliced state.
+  * @param  q Bit planes.
+  * @retval None
+  */
+static void AES_MixColumns(uint32_t *q)
+{
+  uint32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+  uint32_t r0 = __ROR(q0, 8U), r1 = __ROR(q1, 8U), r2 = __ROR(q2, 8U), r3 = __ROR(q3, 8U);
+  uint32_t r4 = __ROR(q4, 8U), r5 = __ROR(q5, 8U), r6 = __ROR(q6, 8U), r7 = __ROR(q7, 8U);
+
+  q[0] = q7 ^ r7 ^ r0 ^ __ROR(q0 ^ r0, 16U);
+  q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ __ROR(q1 ^ r1, 16U);
+  q[2] = q1 ^ r1 ^ r2 ^ __ROR(q2 ^ r2, 16U);
+  q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ __ROR(q3 ^ r3, 16U);
+  q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ __ROR(q4 ^ r4, 16U);
+  q[5] = q4 ^ r4 ^ r5 ^ __ROR(q5 ^ r5, 16U);
+  q[6] = q5 ^ r5 ^ r6 ^ __ROR(q6 ^ r6, 16U);
+  q[7] = q6 ^ r6 ^ r7 ^ __ROR(q7 ^ r7, 16U);
+}
+
+/**
+  * @brief  Encrypt one or two blocks.
+  * @param  haes Pointer to a BSP_AES_TypeDef structure.
+  * @param  pIn Blocks, words as in memory.
+  * @param  pOut Encrypted blocks, may be pIn.
+  * @param  Blocks 1 or 2.
+  * @retval None
+  */
+static void AES_Blocks(const BSP_AES_TypeDef *haes, const uint32_t *pIn, uint32_t *pOut, uint32_t Blocks)
+{
+  const uint32_t *prk = haes->RoundKey;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  uint32_t q[8];
+  uint32_t r;
+  uint32_t i;
+
+  if (haes->Engine == BSP_AES_ENGINE_CONSTTIME)
+  {
+    for (i = 0U; i < 4U; i++)
+    {
+      q[2U * i]        = pIn[i];
+      q[(2U * i) + 1U] = (Blocks > 1U) ? pIn[4U + i] : 0U;
+    }
+    AES_Ortho(q);
+    for (i = 0U; i < 8U; i++)
+    {
+      q[i] ^= prk[i];
+    }
+    for (r = 1U; r < haes->Rounds; r++)
+    {
+      prk += 8U;
+      AES_SBoxBitsliced(q);
+      AES_ShiftRows(q);
+      AES_MixColumns(q);
+      for (i = 0U; i < 8U; i++)
+      {
+        q[i] ^= prk[i];
+      }
+    }
+    prk += 8U;
+    AES_SBoxBitsliced(q);
+    AES_ShiftRows(q);
+    for (i = 0U; i < 8U; i++)
+    {
+      q[i] ^= prk[i];
+    }
+    AES_Ortho(q);
+    for (i = 0U; i < 4U; i++)
+    {
+      pOut[i] = q[2U * i];
+      if (Blocks > 1U)
+      {
+        pOut[4U + i] = q[(2U * i) + 1U];
+      }
+    }
+    return;
+  }
+
+  while (Blocks != 0U)
+  {
+    prk = haes->RoundKey;
+    s0 = pIn[0] ^ prk[0];
+    s1 = pIn[1] ^ prk[1];
+    s2 = pIn[2] ^ prk[2];
+    s3 = pIn[3] ^ prk[3];
+
+    /* The four tables are T0 rotated, the rotation is free in the EOR */
+    for (r = 1U; r < haes->Rounds; r++)
+    {
+      prk += 4U;
+      t0 = AES_T0[AES_BYTE(s0, 0U)] ^ __ROR(AES_T0[AES_BYTE(s1, 1U)], 24U) ^
+           __ROR(AES_T0[AES_BYTE(s2, 2U)], 16U) ^ __ROR(AES_T0[AES_BYTE(s3, 3U)], 8U) ^ prk[0];
+      t1 = AES_T0[AES_BYTE(s1, 0U)] ^ __ROR(AES_T0[AES_BYTE(s2, 1U)], 24U) ^
+           __ROR(AES_T0[AES_BYTE(s3, 2U)], 16U) ^ __ROR(AES_T0[AES_BYTE(s0, 3U)], 8U) ^ prk[1];
+      t2 = AES_T0[AES_BYTE(s2, 0U)] ^ __ROR(AES_T0[AES_BYTE(s3, 1U)], 24U) ^
+           __ROR(AES_T0[AES_BYTE(s0, 2U)], 16U) ^ __ROR(AES_T0[AES_BYTE(s1, 3U)], 8U) ^ prk[2];
+      t3 = AES_T0[AES_BYTE(s3, 0U)] ^ __ROR(AES_T0[AES_BYTE(s0, 1U)], 24U) ^
+           __ROR(AES_T0[AES_BYTE(s1, 2U)], 16U) ^ __ROR(AES_T0[AES_BYTE(s2, 3U)], 8U) ^ prk[3];
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+    prk += 4U;
+    pOut[0] = ((uint32_t)AES_SBox[AES_BYTE(s0, 0U)] | ((uint32_t)AES_SBox[AES_BYTE(s1, 1U)] << 8U) |
+               ((uint32_t)AES_SBox[AES_BYTE(s2, 2U)] << 16U) | ((uint32_t)AES_SBox[AES_BYTE(s3, 3U)] << 24U)) ^ prk[0];
+    pOut[1] = ((uint32_t)AES_SBox[AES_BYTE(s1, 0U)] | ((uint32_t)AES_SBox[AES_BYTE(s2, 1U)] << 8U) |
+               ((uint32_t)AES_SBox[AES_BYTE(s3, 2U)] << 16U) | ((uint32_t)AES_SBox[AES_BYTE(s0, 3U)] << 24U)) ^ prk[1];
+    pOut[2] = ((uint32_t)AES_SBox[AES_BYTE(s2, 0U)] | ((uint32_t)AES_SBox[AES_BYTE(s3, 1U)] << 8U) |
+               ((uint32_t)AES_SBox[AES_BYTE(s0, 2U)] << 16U) | ((uint32_t)AES_SBox[AES_BYTE(s1, 3U)] << 24U)) ^ prk[2];
+    pOut[3] = ((uint32_t)AES_SBox[AES_BYTE(s3, 0U)] | ((uint32_t)AES_SBox[AES_BYTE(s0, 1U)] << 8U) |
+               ((uint32_t)AES_SBox[AES_BYTE(s1, 2U)] << 16U) | ((uint32_t)AES_SBox[AES_BYTE(s2, 3U)] << 24U)) ^ prk[3];
+
+    pIn  += 4U;
+    pOut += 4U;
+    Blocks--;
+  }
+}
+
+/**
+  * @brief  XOR a text with the keystream, by words when aligned.
+  * @param  pOut Result, may be pIn.
+  * @param  pIn Text.
+  * @param  pStream Keystream.
+  * @param  Size Bytes.
+  * @retval None
+  */
+static void AES_Xor(uint8_t *pOut, const uint8_t *pIn, const uint8_t *pStream, uint32_t Size)
+{
+  if ((((uint32_t)pOut | (uint32_t)pIn | (uint32_t)pStream) & 3U) == 0U)
+  {
+    while (Size >= 4U)
+    {
+      *(uint32_t *)pOut = *(const uint32_t *)pIn ^ *(const uint32_t *)pStream;
+      pOut    += 4U;
+      pIn     += 4U;
+      pStream += 4U;
+      Size    -= 4U;
+    }
+  }
+
+  while (Size != 0U)
+  {
+    *pOut++ = *pIn++ ^ *pStream++;
+    Size--;
+  }
+}
+
+/**
+  * @brief  Big endian word of 4 bytes.
+  * @param  pData Bytes, any alignment.
+  * @retval Word
+  */
+static uint32_t AES_Load32BE(const uint8_t *pData)
+{
+  uint32_t word;
+
+  memcpy(&word, pData, 4U);
+
+  return __REV(word);
+}
+
+/**
+  * @brief  Multiply the GHASH accumulator by H.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @retval None
+  */
+static void AES_GhashMult(BSP_AES_GcmTypeDef *hgcm)
+{
+  uint32_t *py = hgcm->Y;
+  uint64_t zh;
+  uint64_t zl;
+  uint32_t z[4];
+  uint32_t v[4];
+  uint32_t mask;
+  uint32_t byte;
+  uint32_t rem;
+  uint32_t i;
+
+  if (hgcm->haes->Engine == BSP_AES_ENGINE_CONSTTIME)
+  {
+    /* One bit of Y at a time, the multiple of H added under a mask */
+    memset(z, 0, sizeof(z));
+    memcpy(v, hgcm->H, sizeof(v));
+    for (i = 0U; i < 128U; i++)
+    {
+      mask = 0U - ((py[i >> 5U] >> (31U - (i & 31U))) & 1U);
+      z[0] ^= v[0] & mask;
+      z[1] ^= v[1] & mask;
+      z[2] ^= v[2] & mask;
+      z[3] ^= v[3] & mask;
+      mask = 0U - (v[3] & 1U);
+      v[3] = (v[3] >> 1U) | (v[2] << 31U);
+      v[2] = (v[2] >> 1U) | (v[1] << 31U);
+      v[1] = (v[1] >> 1U) | (v[0] << 31U);
+      v[0] = (v[0] >> 1U) ^ (0xE1000000U & mask);
+    }
+    memcpy(py, z, sizeof(z));
+    return;
+  }
+
+  /* Shoup, 4 bits at a time from the last byte */
+  byte = AES_BYTE(py[3], 0U);
+  zh = hgcm->HH[byte & 0x0FU];
+  zl = hgcm->HL[byte & 0x0FU];
+  for (i = 16U; i-- != 0U;)
+  {
+    byte = AES_BYTE(py[i >> 2U], 3U - (i & 3U));
+    if (i != 15U)
+    {
+      rem = (uint32_t)zl & 0x0FU;
+      zl  = (zh << 60U) | (zl >> 4U);
+      zh  = (zh >> 4U) ^ ((uint64_t)AES_Last4[rem] << 48U);
+      zh ^= hgcm->HH[byte & 0x0FU];
+      zl ^= hgcm->HL[byte & 0x0FU];
+    }
+    rem = (uint32_t)zl & 0x0FU;
+    zl  = (zh << 60U) | (zl >> 4U);
+    zh  = (zh >> 4U) ^ ((uint64_t)AES_Last4[rem] << 48U);
+    zh ^= hgcm->HH[byte >> 4U];
+    zl ^= hgcm->HL[byte >> 4U];
+  }
+
+  py[0] = (uint32_t)(zh >> 32U);
+  py[1] = (uint32_t)zh;
+  py[2] = (uint32_t)(zl >> 32U);
+  py[3] = (uint32_t)zl;
+}
+
+/**
+  * @brief  Add a block to GHASH.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pBlock BSP_AES_BLOCK_SIZE bytes, any alignment.
+  * @retval None
+  */
+static void AES_GhashBlock(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pBlock)
+{
+  hgcm->Y[0] ^= AES_Load32BE(&pBlock[0]);
+  hgcm->Y[1] ^= AES_Load32BE(&pBlock[4]);
+  hgcm->Y[2] ^= AES_Load32BE(&pBlock[8]);
+  hgcm->Y[3] ^= AES_Load32BE(&pBlock[12]);
+  AES_GhashMult(hgcm);
+}
+
+/**
+  * @brief  Add the partial block to GHASH, padded with zeros.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @retval None
+  */
+static void AES_GhashFlush(BSP_AES_GcmTypeDef *hgcm)
+{
+  if (hgcm->PartialFill != 0U)
+  {
+    memset((uint8_t *)hgcm->Partial + hgcm->PartialFill, 0, BSP_AES_BLOCK_SIZE - hgcm->PartialFill);
+    AES_GhashBlock(hgcm, (const uint8_t *)hgcm->Partial);
+    hgcm->PartialFill = 0U;
+  }
+}
+
+/**
+  * @brief  Add data to GHASH, in pieces of any size.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pData Data.
+  * @param  Size Bytes.
+  * @retval None
+  */
+static void AES_GcmHash(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pData, uint32_t Size)
+{
+  uint8_t *ppartial = (uint8_t *)hgcm->Partial;
+  uint32_t chunk;
+
+  if (hgcm->PartialFill != 0U)
+  {
+    chunk = BSP_AES_BLOCK_SIZE - hgcm->PartialFill;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    memcpy(ppartial + hgcm->PartialFill, pData, chunk);
+    hgcm->PartialFill += chunk;
+    pData += chunk;
+    Size  -= chunk;
+    if (hgcm->PartialFill != BSP_AES_BLOCK_SIZE)
+    {
+      return;
+    }
+    AES_GhashBlock(hgcm, ppartial);
+    hgcm->PartialFill = 0U;
+  }
+
+  while (Size >= BSP_AES_BLOCK_SIZE)
+  {
+    AES_GhashBlock(hgcm, pData);
+    pData += BSP_AES_BLOCK_SIZE;
+    Size  -= BSP_AES_BLOCK_SIZE;
+  }
+
+  if (Size != 0U)
+  {
+    memcpy(ppartial, pData, Size);
+    hgcm->PartialFill = Size;
+  }
+}
+
+/**
+  * @brief  Account a piece of text, the additional data padded before the
+  *         first one.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  Size Bytes of text.
+  * @retval None
+  */
+static void AES_GcmText(BSP_AES_GcmTypeDef *hgcm, uint32_t Size)
+{
+  if (hgcm->TextSize == 0U)
+  {
+    AES_GhashFlush(hgcm);
+  }
+  hgcm->TextSize += Size;
+}
+
+/**
+  * @brief  XOR a text with the GCM keystream.
+  * @param  hgcm Pointer to a BSP_AES_GcmTypeDef structure.
+  * @param  pIn Text.
+  * @param  pOut Result, may be pIn.
+  * @param  Size Bytes.
+  * @retval None
+  */
+static void AES_GcmCtr(BSP_AES_GcmTypeDef *hgcm, const uint8_t *pIn, uint8_t *pOut, uint32_t Size)
+{
+  uint32_t ctr[8];
+  uint32_t chunk;
+
+  while (Size != 0U)
+  {
+    if (hgcm->StreamUsed == hgcm->StreamSize)
+    {
+      memcpy(ctr, hgcm->Iv, BSP_AES_IV_SIZE);
+      memcpy(&ctr[4], hgcm->Iv, BSP_AES_IV_SIZE);
+      ctr[3] = __REV(hgcm->Count);
+      ctr[7] = __REV(hgcm->Count + 1U);
+      AES_Blocks(hgcm->haes, ctr, hgcm->Stream, hgcm->StreamSize / BSP_AES_BLOCK_SIZE);
+      hgcm->Count     += hgcm->StreamSize / BSP_AES_BLOCK_SIZE;
+      hgcm->StreamUsed = 0U;
+    }
+
+    chunk = hgcm->StreamSize - hgcm->StreamUsed;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    AES_Xor(pOut, pIn, (const uint8_t *)hgcm->Stream + hgcm->StreamUsed, chunk);
+    hgcm->StreamUsed += chunk;
+    pIn  += chunk;
+    pOut += chunk;
+    Size -= chunk;
+  }
+}
+
+/**
+  * @brief  IV of a record, the salt then the sequence, big endian.
+  * @param  pSalt BSP_AES_SALT_SIZE bytes.
+  * @param  Sequence Sequence of the record.
+  * @param  pIv BSP_AES_IV_SIZE bytes.
+  * @retval None
+  */
+static void AES_LinkIv(const uint8_t *pSalt, uint32_t Sequence, uint8_t *pIv)
+{
+  uint32_t sequence = __REV(Sequence);
+
+  memcpy(pIv, pSalt, BSP_AES_SALT_SIZE);
+  memcpy(&pIv[BSP_AES_SALT_SIZE], &sequence, BSP_AES_SEQUENCE_SIZE);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,477 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_asrc.c
+  * @author  MCU Application Team
+  * @brief   Asynchronous sample rate converter BSP service.
+  *          This file provides functions to pass audio from a source on its
+  *          own clock to an I2S on the PLL, with no under- or overrun:
+  *           + FIFO between the source and the reader, one writer and one
+  *             reader without a lock
+  *           + Drift measured on the fill level of the FIFO
+  *           + Polyphase interpolation at the corrected rate
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The audio clock of the I2S comes from the PLL, which has no fine trim:
+       the rate of the I2S cannot follow a source with its own crystal, USB
+       or another I2S slave. This service resamples the source instead, at
+       InRate / OutRate corrected by a few ppm so that its FIFO stays half
+       full. InRate and OutRate can differ, 44100 to 48000 for instance,
+       within a factor of 2.
+
+   (#) Call BSP_ASRC_Init() with the number of channels, the nominal rates
+       and a FIFO of Capacity frames, a power of 2. Four blocks of the
+       source at least: the fill level swings by one block per write.
+
+   (#) Call BSP_ASRC_Write() with the frames of the source as they come, from
+       its interrupt or from a task. Call BSP_ASRC_Read() with the frames the
+       I2S needs, from its DMA callback, BSP_I2SDUPLEX_BlockCallback() or
+       HAL_I2S_TxHalfCpltCallback() and HAL_I2S_TxCpltCallback(). Samples are
+       Q15, frames interleaved; the 24 and 32 bits I2S buffers go through
+       the conversions of BSP_DSP. One writer and one reader: each one moves
+       its own count only.
+
+   (#) The reader gets silence until the FIFO is half full. Each read then
+       averages the fill level over BSP_ASRC_LEVEL_TC and a PI loop sets the
+       rate correction, up to BSP_ASRC_PPM_MAX: Stats.Ppm is the drift of
+       the source in the steady state. A source that stops leaves silence,
+       counted in Stats.Underruns, and the FIFO fills up to half again.
+       (+) The level seen by a read jumps by a block at each write, and the
+           instant of the read in the period of the writes moves with the
+           drift itself: taken as is, the level swings slowly by a fraction
+           of a block and the loop follows it. Each write is stamped with the
+           DWT cycle counter, enabled by the Init, and the read counts the
+           last block of the source as spread over the period of the writes.
+
+   (#) Each output sample is interpolated from BSP_ASRC_TAPS input samples by
+       the two filter phases around its position, of BSP_ASRC_PHASES, the
+       filter being a Blackman windowed sinc cut at 0.45 of the lower of
+       the two rates. At 48 kHz stereo that is 2 x 16 products per frame,
+       4 x __SMLALD.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "py32f4xx_bsp_asrc.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ASRC BSP ASRC
+  * @brief Asynchronous sample rate converter BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ASRC_Private_Constants BSP ASRC Private Constants
+  * @{
+  */
+#define ASRC_PI                         3.14159265358979f
+#define ASRC_PHASE_BITS                 5U             /* log2(BSP_ASRC_PHASES)                       */
+#define ASRC_CUTOFF                     0.9f           /* Of the Nyquist frequency of the lower rate  */
+#define ASRC_ONE                        ((uint64_t)1U << 32)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_ASRC_Private_Macros BSP ASRC Private Macros
+  * @{
+  */
+/* Two Q15 samples, the first one in the low halfword */
+#define ASRC_READ_Q15X2(__PTR__)        (__UNALIGNED_UINT32_READ(__PTR__))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ASRC_Private_Functions BSP ASRC Private Functions
+  * @{
+  */
+static void    ASRC_BuildFilter(BSP_ASRC_TypeDef *hasrc, float Cutoff);
+static void    ASRC_Take(BSP_ASRC_TypeDef *hasrc);
+static int64_t ASRC_Dot(const int16_t *pCoeffs, const int16_t *pWindow);
+static void    ASRC_Track(BSP_ASRC_TypeDef *hasrc, uint32_t Frames);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ASRC_Exported_Functions BSP ASRC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a sample rate converter, its FIFO empty.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  Channels Samples per frame, 1 or 2.
+  * @param  InRate Nominal rate of the source, Hz.
+  * @param  OutRate Rate of the reader, Hz, InRate / 2 to 2 x InRate.
+  * @param  pFifo FIFO of Capacity x Channels samples.
+  * @param  Capacity Frames of the FIFO, a power of 2, at least 2 x BSP_ASRC_TAPS.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ASRC_Init(BSP_ASRC_TypeDef *hasrc, uint32_t Channels, uint32_t InRate, uint32_t OutRate,
+                                int16_t *pFifo, uint32_t Capacity)
+{
+  uint32_t ch;
+  uint32_t k;
+
+  if ((hasrc == NULL) || (pFifo == NULL) || (Channels == 0U) || (Channels > BSP_ASRC_CHANNELS_MAX) ||
+      (InRate == 0U) || (OutRate == 0U) || (InRate > (2U * OutRate)) || (OutRate > (2U * InRate)) ||
+      (Capacity < (2U * BSP_ASRC_TAPS)) || ((Capacity & (Capacity - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hasrc->Channels    = Channels;
+  hasrc->InRate      = InRate;
+  hasrc->OutRate     = OutRate;
+  hasrc->pFifo       = pFifo;
+  hasrc->Capacity    = Capacity;
+  hasrc->WriteCount  = 0U;
+  hasrc->ReadCount   = 0U;
+  hasrc->Primed      = 0U;
+  hasrc->WriteStamp  = 0U;
+  hasrc->WriteFrames = 0U;
+  hasrc->WritePeriod = 0.0f;
+  hasrc->Nominal     = ((uint64_t)InRate << 32) / OutRate;
+  hasrc->Step        = hasrc->Nominal;
+  hasrc->Position    = ASRC_ONE;
+  hasrc->AvgLevel    = (float)(Capacity / 2U);
+  hasrc->Integral    = 0.0f;
+  hasrc->HistIndex   = 0U;
+  for (ch = 0U; ch < BSP_ASRC_CHANNELS_MAX; ch++)
+  {
+    for (k = 0U; k < (2U * BSP_ASRC_TAPS); k++)
+    {
+      hasrc->History[ch][k] = 0;
+    }
+  }
+  hasrc->Stats.Level     = 0U;
+  hasrc->Stats.Ppm       = 0.0f;
+  hasrc->Stats.Underruns = 0U;
+  hasrc->Stats.Overruns  = 0U;
+
+  HAL_EnableCycleCounter();
+
+  /* Cut at the Nyquist frequency of the lower rate, in input samples */
+  ASRC_BuildFilter(hasrc, (InRate > OutRate) ? (ASRC_CUTOFF * (float)OutRate / (float)InRate) : ASRC_CUTOFF);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write frames of the source.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  pSrc Frames, Q15, Channels samples each.
+  * @param  Frames Frames to write.
+  * @retval Frames written, the others dropped when the FIFO is full
+  */
+uint32_t BSP_ASRC_Write(BSP_ASRC_TypeDef *hasrc, const int16_t *pSrc, uint32_t Frames)
+{
+  uint32_t stamp = DWT->CYCCNT;
+  uint32_t mask = hasrc->Capacity - 1U;
+  uint32_t count = hasrc->WriteCount;
+  uint32_t room = hasrc->Capacity - (count - hasrc->ReadCount);
+  float interval;
+  uint32_t n;
+  uint32_t ch;
+
+  if (Frames > room)
+  {
+    hasrc->Stats.Overruns += Frames - room;
+    Frames = room;
+  }
+
+  for (n = 0U; n < Frames; n++)
+  {
+    for (ch = 0U; ch < hasrc->Channels; ch++)
+    {
+      hasrc->pFifo[(((count + n) & mask) * hasrc->Channels) + ch] = *pSrc++;
+    }
+  }
+
+  /* Period of the writes, 1/16 of each new interval */
+  if (count != 0U)
+  {
+    interval = (float)(stamp - hasrc->WriteStamp);
+    hasrc->WritePeriod = (hasrc->WritePeriod == 0.0f) ? interval :
+                         (hasrc->WritePeriod + ((interval - hasrc->WritePeriod) / 16.0f));
+  }
+  hasrc->WriteStamp  = stamp;
+  hasrc->WriteFrames = Frames;
+
+  /* The frames are in place before the reader sees them */
+  __DMB();
+  hasrc->WriteCount = count + Frames;
+
+  return Frames;
+}
+
+/**
+  * @brief  Read frames at the rate of the reader.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  pDst Frames, Q15, Channels samples each.
+  * @param  Frames Frames to read, all given, silence while the FIFO fills.
+  * @retval None
+  */
+void BSP_ASRC_Read(BSP_ASRC_TypeDef *hasrc, int16_t *pDst, uint32_t Frames)
+{
+  const int16_t *c0;
+  const int16_t *window;
+  uint32_t frac;
+  int64_t y0;
+  int64_t y1;
+  int32_t mu;
+  uint32_t n;
+  uint32_t ch;
+
+  if (hasrc->Primed == 0U)
+  {
+    if ((hasrc->WriteCount - hasrc->ReadCount) < (hasrc->Capacity / 2U))
+    {
+      for (n = 0U; n < (Frames * hasrc->Channels); n++)
+      {
+        pDst[n] = 0;
+      }
+      return;
+    }
+    hasrc->Primed   = 1U;
+    hasrc->AvgLevel = (float)(hasrc->Capacity / 2U);
+  }
+
+  for (n = 0U; n < Frames; n++)
+  {
+    while (hasrc->Position >= ASRC_ONE)
+    {
+      ASRC_Take(hasrc);
+      hasrc->Position -= ASRC_ONE;
+    }
+
+    /* Phase from the 5 upper bits of the fraction, the next 15 between two phases */
+    frac = (uint32_t)hasrc->Position;
+    c0   = &hasrc->Coeffs[(frac >> (32U - ASRC_PHASE_BITS)) * BSP_ASRC_TAPS];
+    mu   = (int32_t)((frac >> (32U - ASRC_PHASE_BITS - 15U)) & 0x7FFFU);
+
+    for (ch = 0U; ch < hasrc->Channels; ch++)
+    {
+      window = &hasrc->History[ch][hasrc->HistIndex];
+      y0 = ASRC_Dot(c0, window);
+      y1 = ASRC_Dot(c0 + BSP_ASRC_TAPS, window);
+      y0 += ((y1 - y0) * mu) >> 15;
+      *pDst++ = (int16_t)__SSAT((int32_t)(y0 >> 15), 16);
+    }
+
+    hasrc->Position += hasrc->Step;
+  }
+
+  ASRC_Track(hasrc, Frames);
+}
+
+/**
+  * @brief  Get a snapshot of the statistics.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  pStats Statistics copied.
+  * @retval None
+  */
+void BSP_ASRC_GetStats(const BSP_ASRC_TypeDef *hasrc, BSP_ASRC_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hasrc->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ASRC_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Build the polyphase filter, each phase of unity gain.
+  * @note   Phase p delays by p / BSP_ASRC_PHASES of an input sample, phase
+  *         BSP_ASRC_PHASES by one sample, the end of the last interpolation.
+  *         Coefficient k of a phase weights the window sample k, oldest
+  *         first.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  Cutoff Cut frequency over the Nyquist frequency of the input.
+  * @retval None
+  */
+static void ASRC_BuildFilter(BSP_ASRC_TypeDef *hasrc, float Cutoff)
+{
+  float taps[BSP_ASRC_TAPS];
+  float half = (float)BSP_ASRC_TAPS / 2.0f;
+  float sum;
+  float x;
+  float w;
+  uint32_t p;
+  uint32_t k;
+
+  for (p = 0U; p <= BSP_ASRC_PHASES; p++)
+  {
+    sum = 0.0f;
+    for (k = 0U; k < BSP_ASRC_TAPS; k++)
+    {
+      /* Distance of window sample k to the output, in input samples */
+      x = (float)(BSP_ASRC_TAPS - 1U - k) - half + ((float)p / (float)BSP_ASRC_PHASES);
+      w = 0.42f + (0.5f * cosf(2.0f * ASRC_PI * x / (float)BSP_ASRC_TAPS)) +
+          (0.08f * cosf(4.0f * ASRC_PI * x / (float)BSP_ASRC_TAPS));
+      taps[k] = (x == 0.0f) ? Cutoff : (w * sinf(ASRC_PI * Cutoff * x) / (ASRC_PI * x));
+      sum += taps[k];
+    }
+    for (k = 0U; k < BSP_ASRC_TAPS; k++)
+    {
+      hasrc->Coeffs[(p * BSP_ASRC_TAPS) + k] = (int16_t)__SSAT((int32_t)lroundf(taps[k] / sum * 32768.0f), 16);
+    }
+  }
+}
+
+/**
+  * @brief  Take the next input frame into the filter windows.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @retval None
+  */
+static void ASRC_Take(BSP_ASRC_TypeDef *hasrc)
+{
+  uint32_t count = hasrc->ReadCount;
+  uint32_t index = hasrc->HistIndex;
+  const int16_t *frame = NULL;
+  int16_t sample;
+  uint32_t ch;
+
+  if (count != hasrc->WriteCount)
+  {
+    frame = &hasrc->pFifo[(count & (hasrc->Capacity - 1U)) * hasrc->Channels];
+  }
+  else
+  {
+    /* Source late: silence, and the FIFO fills up to half again */
+    hasrc->Stats.Underruns++;
+    hasrc->Primed = 0U;
+  }
+
+  /* Each sample twice, the window of the oldest one always contiguous */
+  for (ch = 0U; ch < hasrc->Channels; ch++)
+  {
+    sample = (frame != NULL) ? frame[ch] : 0;
+    hasrc->History[ch][index]                 = sample;
+    hasrc->History[ch][index + BSP_ASRC_TAPS] = sample;
+  }
+  hasrc->HistIndex = (index + 1U) & (BSP_ASRC_TAPS - 1U);
+
+  if (frame != NULL)
+  {
+    __DMB();
+    hasrc->ReadCount = count + 1U;
+  }
+}
+
+/**
+  * @brief  Product of a filter phase and a window.
+  * @param  pCoeffs BSP_ASRC_TAPS coefficients, Q15.
+  * @param  pWindow BSP_ASRC_TAPS samples, Q15, oldest first.
+  * @retval Sum of the products, Q30
+  */
+static int64_t ASRC_Dot(const int16_t *pCoeffs, const int16_t *pWindow)
+{
+  int64_t acc = 0;
+  uint32_t k;
+
+  for (k = 0U; k < BSP_ASRC_TAPS; k += 2U)
+  {
+    acc = __SMLALD(ASRC_READ_Q15X2(&pCoeffs[k]), ASRC_READ_Q15X2(&pWindow[k]), acc);
+  }
+
+  return acc;
+}
+
+/**
+  * @brief  Correct the rate from the fill level of the FIFO.
+  * @note   A level above half means a source faster than its nominal rate:
+  *         the step into the input grows. Proportional and integral terms in
+  *         ppm, the integral alone left in the steady state.
+  * @param  hasrc Pointer to a BSP_ASRC_TypeDef structure.
+  * @param  Frames Frames just read.
+  * @retval None
+  */
+static void ASRC_Track(BSP_ASRC_TypeDef *hasrc, uint32_t Frames)
+{
+  uint32_t level = hasrc->WriteCount - hasrc->ReadCount;
+  float seconds = (float)Frames / (float)hasrc->OutRate;
+  float alpha = seconds / BSP_ASRC_LEVEL_TC;
+  float smooth = (float)level;
+  float elapsed;
+  float error;
+  float ppm;
+
+  /* The part of the last block of the source not due yet */
+  if (hasrc->WritePeriod > 0.0f)
+  {
+    elapsed = (float)(DWT->CYCCNT - hasrc->WriteStamp) / hasrc->WritePeriod;
+    if (elapsed < 1.0f)
+    {
+      smooth -= (float)hasrc->WriteFrames * (1.0f - elapsed);
+    }
+  }
+
+  hasrc->AvgLevel += (smooth - hasrc->AvgLevel) * ((alpha > 1.0f) ? 1.0f : alpha);
+  error = hasrc->AvgLevel - (float)(hasrc->Capacity / 2U);
+
+  hasrc->Integral += BSP_ASRC_KI * error * seconds;
+  if (hasrc->Integral > BSP_ASRC_PPM_MAX)
+  {
+    hasrc->Integral = BSP_ASRC_PPM_MAX;
+  }
+  else if (hasrc->Integral < -BSP_ASRC_PPM_MAX)
+  {
+    hasrc->Integral = -BSP_ASRC_PPM_MAX;
+  }
+
+  ppm = (BSP_ASRC_KP * error) + hasrc->Integral;
+  ppm = (ppm > BSP_ASRC_PPM_MAX) ? BSP_ASRC_PPM_MAX : ((ppm < -BSP_ASRC_PPM_MAX) ? -BSP_ASRC_PPM_MAX : ppm);
+
+  hasrc->Step = hasrc->Nominal + (uint64_t)(int64_t)((float)hasrc->Nominal * ppm * 1.0e-6f);
+
+  hasrc->Stats.Level = level;
+  hasrc->Stats.Ppm   = hasrc->Integral;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,680 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_atcmd.c
+  * @author  MCU Application Team
+  * @brief   AT command engine BSP service.
+  *          This file provides functions to drive a modem with AT commands
+  *          over a BSP_SERIAL port, without blocking:
+  *           + Incremental tokenizer scanning the DMA receive ring in place
+  *           + Table of unsolicited result codes, whole lines or data headers
+  *           + Queue of commands started back to back, each with its timeout,
+  *             response lines and final result
+  *           + Binary payloads after a '>' prompt and after a data header,
+  *             the latter copied or streamed straight out of the ring
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Open the UART of the modem with BSP_SERIAL_Open(), RTS flow control
+       with BSP_SERIAL_SetFlowControl() is advised above 115200 bauds. Turn
+       the command echo off (ATE0) as the first command: an echo is taken
+       for a response line.
+
+   (#) Describe the unsolicited result codes (URC) of the modem with an array
+       of BSP_ATCMD_UrcTypeDef and call BSP_ATCMD_Init() with the port and
+       the table, for instance:
+         static const BSP_ATCMD_UrcTypeDef aUrc[] =
+         {
+           { "+IPD,",      ':',  IpdHeader },
+           { "WIFI ",      '\0', WifiState },
+         };
+       Each complete line is offered to the entries without Terminator in
+       their order, the first callback returning 1 takes it. An entry with a
+       Terminator is a data header: its callback is called as soon as that
+       character is received after the prefix, and calls BSP_ATCMD_ReadRaw()
+       with the length it parsed. The next bytes are then the payload, not
+       lines: they are copied to a buffer or given to a stream callback in
+       place in the receive ring, at most two blocks per ring wrap, then the
+       tokenizer goes back to lines. BSP_ATCMD_ReadRaw() can also be called
+       from a whole line entry, for a payload after the end of the line.
+
+   (#) Fill a BSP_ATCMD_CmdTypeDef per command and queue it with
+       BSP_ATCMD_Submit(). It stays owned by the engine until its Status
+       leaves BSP_ATCMD_STATUS_PENDING, then its CpltCallback is called.
+       Lines received while it runs which are neither a URC nor a final
+       result go to its LineCallback. With a pData payload the engine waits
+       for the '>' prompt after the command line, writes the payload, then
+       waits for SEND OK. BSP_ATCMD_GetCurrent() returns the command in
+       progress, e.g. to find the buffer of a data header answering it.
+
+   (#) Call BSP_ATCMD_Process() from the main loop or a task, after
+       BSP_SERIAL_Poll() for instance. It scans the received data, calls the
+       callbacks, writes the command lines and payloads as the Tx ring takes
+       them and ends the commands past their timeout. The next queued
+       command is written in the call which received the final result of
+       the previous one: a sequence of commands runs without round trip
+       through the application.
+
+   (#) A response arriving after the timeout of its command is taken for a
+       response of the next one. Give the commands a timeout above the
+       worst case of the modem, and BSP_ATCMD_Flush() the queue after a
+       modem reset.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_atcmd.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ATCMD BSP ATCMD
+  * @brief AT command engine BSP service
+  * @{
+  */
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_ATCMD_Private_Types BSP ATCMD Private Types
+  * @{
+  */
+
+/**
+  * @brief  Final result code definition
+  */
+typedef struct
+{
+  const char              *pText;       /*!< Result line                                            */
+
+  uint32_t                Prefix;       /*!< 1 when pText only starts the line                      */
+
+  uint32_t                Status;       /*!< A value of @ref BSP_ATCMD_Status                       */
+
+} ATCMD_ResultTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ATCMD_Private_Variables BSP ATCMD Private Variables
+  * @{
+  */
+static const ATCMD_ResultTypeDef aAtcmdResults[] =
+{
+  { "OK",          0U, BSP_ATCMD_STATUS_OK    },
+  { "SEND OK",     0U, BSP_ATCMD_STATUS_OK    },
+  { "ERROR",       0U, BSP_ATCMD_STATUS_ERROR },
+  { "FAIL",        0U, BSP_ATCMD_STATUS_ERROR },
+  { "SEND FAIL",   0U, BSP_ATCMD_STATUS_ERROR },
+  { "+CME ERROR:", 1U, BSP_ATCMD_STATUS_ERROR },
+  { "+CMS ERROR:", 1U, BSP_ATCMD_STATUS_ERROR },
+};
+
+static const uint8_t aAtcmdCr[1] = {'\r'};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ATCMD_Private_Functions BSP ATCMD Private Functions
+  * @{
+  */
+static uint32_t ATCMD_Parse(BSP_ATCMD_TypeDef *hat, const uint8_t *pData, uint32_t Length);
+static void     ATCMD_MatchHeader(BSP_ATCMD_TypeDef *hat, char Terminator);
+static void     ATCMD_Dispatch(BSP_ATCMD_TypeDef *hat);
+static uint32_t ATCMD_GetResult(const char *pLine, uint32_t Length);
+static void     ATCMD_Transmit(BSP_ATCMD_TypeDef *hat);
+static void     ATCMD_Complete(BSP_ATCMD_TypeDef *hat, uint32_t Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ATCMD_Exported_Functions BSP ATCMD Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_ATCMD_Exported_Functions_Group1 Engine functions
+  * @brief    Engine functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Engine functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Initialize an engine on a serial port
+      (+) Run the tokenizer and the command queue
+      (+) Read the statistics
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize an AT command engine.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  Port A value of @ref BSP_SERIAL_Port, opened by BSP_SERIAL_Open().
+  * @param  pUrc URC table, NULL for none.
+  * @param  UrcCount Number of entries of the URC table.
+  * @param  pContext Left to the owner, e.g. for the URC callbacks.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ATCMD_Init(BSP_ATCMD_TypeDef *hat, uint32_t Port, const BSP_ATCMD_UrcTypeDef *pUrc,
+                                 uint32_t UrcCount, void *pContext)
+{
+  if ((hat == NULL) || (Port >= BSP_SERIAL_PORT_NUMBER) || ((pUrc == NULL) && (UrcCount != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  memset(hat, 0, sizeof(BSP_ATCMD_TypeDef));
+  hat->Port     = Port;
+  hat->pUrc     = pUrc;
+  hat->UrcCount = UrcCount;
+  hat->pContext = pContext;
+  hat->State    = BSP_ATCMD_STATE_IDLE;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Scan the received data and advance the command queue.
+  * @note   All the callbacks are called from this function.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @retval None
+  */
+void BSP_ATCMD_Process(BSP_ATCMD_TypeDef *hat)
+{
+  uint8_t *pBlock;
+  uint32_t length;
+
+  /* The tokenizer reads the ring where the DMA wrote it, two blocks when it wraps */
+  length = BSP_SERIAL_Acquire(hat->Port, &pBlock);
+  while (length != 0U)
+  {
+    BSP_SERIAL_Commit(hat->Port, ATCMD_Parse(hat, pBlock, length));
+    length = BSP_SERIAL_Acquire(hat->Port, &pBlock);
+  }
+
+  ATCMD_Transmit(hat);
+}
+
+/**
+  * @brief  Return the statistics of an engine.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pStats Returns the statistics.
+  * @retval None
+  */
+void BSP_ATCMD_GetStats(const BSP_ATCMD_TypeDef *hat, BSP_ATCMD_StatsTypeDef *pStats)
+{
+  *pStats = hat->Stats;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ATCMD_Exported_Functions_Group2 Command functions
+  * @brief    Command functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Command functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Queue a command
+      (+) Get the command in progress
+      (+) Empty the queue
+      (+) Receive the payload of a data header
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Queue a command.
+  * @note   The command is started by BSP_ATCMD_Process(), after the ones
+  *         queued before it.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pCmd Pointer to a BSP_ATCMD_CmdTypeDef structure, pCommand, pData,
+  *              DataLength, Timeout and the callbacks filled.
+  * @retval HAL status, HAL_BUSY when the command is still pending
+  */
+HAL_StatusTypeDef BSP_ATCMD_Submit(BSP_ATCMD_TypeDef *hat, BSP_ATCMD_CmdTypeDef *pCmd)
+{
+  if ((pCmd == NULL) || (pCmd->pCommand == NULL) || ((pCmd->pData == NULL) && (pCmd->DataLength != 0U)))
+  {
+    return HAL_ERROR;
+  }
+  if (pCmd->Status == BSP_ATCMD_STATUS_PENDING)
+  {
+    return HAL_BUSY;
+  }
+
+  pCmd->Status = BSP_ATCMD_STATUS_PENDING;
+  pCmd->pNext  = NULL;
+  if (hat->pTail == NULL)
+  {
+    hat->pHead = pCmd;
+  }
+  else
+  {
+    hat->pTail->pNext = pCmd;
+  }
+  hat->pTail = pCmd;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the command in progress.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @retval Command whose line was written, NULL when none is started
+  */
+BSP_ATCMD_CmdTypeDef *BSP_ATCMD_GetCurrent(const BSP_ATCMD_TypeDef *hat)
+{
+  return (hat->State != BSP_ATCMD_STATE_IDLE) ? hat->pHead : NULL;
+}
+
+/**
+  * @brief  End all the queued commands and reset the tokenizer.
+  * @note   The commands end with BSP_ATCMD_STATUS_ABORTED, e.g. after a reset
+  *         of the modem. The received data not yet scanned is kept.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @retval None
+  */
+void BSP_ATCMD_Flush(BSP_ATCMD_TypeDef *hat)
+{
+  hat->LineLength  = 0U;
+  hat->Overflow    = 0U;
+  hat->RawLength   = 0U;
+  hat->pRawBuffer  = NULL;
+  hat->RawCallback = NULL;
+
+  while (hat->pHead != NULL)
+  {
+    ATCMD_Complete(hat, BSP_ATCMD_STATUS_ABORTED);
+  }
+}
+
+/**
+  * @brief  Take the next bytes received as a binary payload.
+  * @note   To call from a URC callback. The payload is copied to pBuffer, or
+  *         given to pCallback in place in the receive ring, or dropped when
+  *         both are NULL.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  Length Number of bytes of the payload.
+  * @param  pBuffer Destination of the payload, Length bytes, or NULL.
+  * @param  pCallback Stream callback, called once per contiguous block, or NULL.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ATCMD_ReadRaw(BSP_ATCMD_TypeDef *hat, uint32_t Length, uint8_t *pBuffer,
+                                    void (*pCallback)(BSP_ATCMD_TypeDef *hat, const uint8_t *pData,
+                                                      uint32_t Length))
+{
+  if (hat->RawLength != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  hat->pRawBuffer  = pBuffer;
+  hat->RawCallback = pCallback;
+  hat->RawLength   = Length;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ATCMD_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Scan a block of received data.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pData Block in the receive ring.
+  * @param  Length Size of the block in bytes.
+  * @retval Number of bytes consumed, the whole block
+  */
+static uint32_t ATCMD_Parse(BSP_ATCMD_TypeDef *hat, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t index = 0U;
+  uint32_t length;
+  char c;
+
+  while (index < Length)
+  {
+    /* A payload is taken as a whole block, not scanned */
+    if (hat->RawLength != 0U)
+    {
+      length = Length - index;
+      if (length > hat->RawLength)
+      {
+        length = hat->RawLength;
+      }
+      if (hat->pRawBuffer != NULL)
+      {
+        memcpy(hat->pRawBuffer, &pData[index], length);
+        hat->pRawBuffer += length;
+      }
+      else if (hat->RawCallback != NULL)
+      {
+        hat->RawCallback(hat, &pData[index], length);
+      }
+      hat->RawLength -= length;
+      hat->Stats.RawBytes += length;
+      index += length;
+      continue;
+    }
+
+    c = (char)pData[index];
+    index++;
+
+    if (c == '\n')
+    {
+      if ((hat->LineLength != 0U) && (hat->Overflow == 0U))
+      {
+        ATCMD_Dispatch(hat);
+      }
+      else if (hat->Overflow != 0U)
+      {
+        hat->Stats.Overflows++;
+      }
+      hat->LineLength = 0U;
+      hat->Overflow   = 0U;
+      continue;
+    }
+    if (c == '\r')
+    {
+      continue;
+    }
+
+    if (hat->LineLength == 0U)
+    {
+      /* The prompt comes without end of line, the space some modems add after it is skipped */
+      if (c == ' ')
+      {
+        continue;
+      }
+      if ((c == '>') && (hat->State == BSP_ATCMD_STATE_PROMPT))
+      {
+        hat->State    = BSP_ATCMD_STATE_DATA;
+        hat->TxOffset = 0U;
+        continue;
+      }
+    }
+
+    if (hat->LineLength < (BSP_ATCMD_LINE_SIZE - 1U))
+    {
+      hat->Line[hat->LineLength] = c;
+      hat->LineLength++;
+      if (((c == ':') || (c == ',')) && (hat->Overflow == 0U))
+      {
+        ATCMD_MatchHeader(hat, c);
+      }
+    }
+    else
+    {
+      hat->Overflow = 1U;
+    }
+  }
+
+  return Length;
+}
+
+/**
+  * @brief  Offer the line received so far to the data header entries.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  Terminator Character just received.
+  * @retval None
+  */
+static void ATCMD_MatchHeader(BSP_ATCMD_TypeDef *hat, char Terminator)
+{
+  const BSP_ATCMD_UrcTypeDef *pUrc;
+  uint32_t length;
+  uint32_t index;
+
+  for (index = 0U; index < hat->UrcCount; index++)
+  {
+    pUrc = &hat->pUrc[index];
+    if (pUrc->Terminator != Terminator)
+    {
+      continue;
+    }
+    length = strlen(pUrc->pPrefix);
+    if ((hat->LineLength > length) && (memcmp(hat->Line, pUrc->pPrefix, length) == 0))
+    {
+      hat->Line[hat->LineLength] = '\0';
+      if (pUrc->Callback(hat, hat->Line, hat->LineLength) != 0U)
+      {
+        hat->Stats.Urcs++;
+        hat->LineLength = 0U;
+        return;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Handle a complete line.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @retval None
+  */
+static void ATCMD_Dispatch(BSP_ATCMD_TypeDef *hat)
+{
+  const BSP_ATCMD_UrcTypeDef *pUrc;
+  BSP_ATCMD_CmdTypeDef *pCmd;
+  uint32_t length;
+  uint32_t status;
+  uint32_t index;
+
+  hat->Line[hat->LineLength] = '\0';
+
+  for (index = 0U; index < hat->UrcCount; index++)
+  {
+    pUrc = &hat->pUrc[index];
+    if (pUrc->Terminator != '\0')
+    {
+      continue;
+    }
+    length = strlen(pUrc->pPrefix);
+    if ((hat->LineLength >= length) && (memcmp(hat->Line, pUrc->pPrefix, length) == 0) &&
+        (pUrc->Callback(hat, hat->Line, hat->LineLength) != 0U))
+    {
+      hat->Stats.Urcs++;
+      return;
+    }
+  }
+
+  pCmd = BSP_ATCMD_GetCurrent(hat);
+  if (pCmd == NULL)
+  {
+    hat->Stats.Unsolicited++;
+    return;
+  }
+
+  status = ATCMD_GetResult(hat->Line, hat->LineLength);
+  if (status == BSP_ATCMD_STATUS_PENDING)
+  {
+    if (pCmd->LineCallback != NULL)
+    {
+      pCmd->LineCallback(pCmd, hat->Line, hat->LineLength);
+    }
+  }
+  else if ((status == BSP_ATCMD_STATUS_OK) && (pCmd->pData != NULL) && (hat->State != BSP_ATCMD_STATE_RESULT))
+  {
+    /* The OK of the command line before the prompt, the payload is still to send */
+  }
+  else
+  {
+    ATCMD_Complete(hat, status);
+  }
+}
+
+/**
+  * @brief  Classify a response line.
+  * @param  pLine Line, '\0' terminated.
+  * @param  Length Number of characters of the line.
+  * @retval A value of @ref BSP_ATCMD_Status, BSP_ATCMD_STATUS_PENDING for an intermediate line
+  */
+static uint32_t ATCMD_GetResult(const char *pLine, uint32_t Length)
+{
+  uint32_t length;
+  uint32_t index;
+
+  for (index = 0U; index < (sizeof(aAtcmdResults) / sizeof(aAtcmdResults[0])); index++)
+  {
+    length = strlen(aAtcmdResults[index].pText);
+    if ((aAtcmdResults[index].Prefix != 0U) ? (Length >= length) : (Length == length))
+    {
+      if (memcmp(pLine, aAtcmdResults[index].pText, length) == 0)
+      {
+        return aAtcmdResults[index].Status;
+      }
+    }
+  }
+
+  return BSP_ATCMD_STATUS_PENDING;
+}
+
+/**
+  * @brief  Start the next command, write what the Tx ring takes and check the timeout.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @retval None
+  */
+static void ATCMD_Transmit(BSP_ATCMD_TypeDef *hat)
+{
+  BSP_ATCMD_CmdTypeDef *pCmd;
+  uint32_t length;
+
+  while (hat->pHead != NULL)
+  {
+    pCmd = hat->pHead;
+
+    if (hat->State == BSP_ATCMD_STATE_IDLE)
+    {
+      hat->State     = BSP_ATCMD_STATE_COMMAND;
+      hat->TxOffset  = 0U;
+      hat->TickStart = HAL_GetTick();
+      hat->Stats.Commands++;
+    }
+
+    if (hat->State == BSP_ATCMD_STATE_COMMAND)
+    {
+      length = strlen(pCmd->pCommand);
+      if (hat->TxOffset < length)
+      {
+        hat->TxOffset += BSP_SERIAL_Write(hat->Port, (const uint8_t *)&pCmd->pCommand[hat->TxOffset],
+                                          length - hat->TxOffset);
+      }
+      if ((hat->TxOffset == length) && (BSP_SERIAL_Write(hat->Port, aAtcmdCr, 1U) != 0U))
+      {
+        hat->State = (pCmd->pData != NULL) ? BSP_ATCMD_STATE_PROMPT : BSP_ATCMD_STATE_RESULT;
+      }
+    }
+    else if (hat->State == BSP_ATCMD_STATE_DATA)
+    {
+      hat->TxOffset += BSP_SERIAL_Write(hat->Port, &pCmd->pData[hat->TxOffset],
+                                        pCmd->DataLength - hat->TxOffset);
+      if (hat->TxOffset == pCmd->DataLength)
+      {
+        hat->State = BSP_ATCMD_STATE_RESULT;
+      }
+    }
+    else
+    {
+      /* Waiting for the modem */
+    }
+
+    if ((HAL_GetTick() - hat->TickStart) < pCmd->Timeout)
+    {
+      break;
+    }
+    ATCMD_Complete(hat, BSP_ATCMD_STATUS_TIMEOUT);
+  }
+}
+
+/**
+  * @brief  End the command at the head of the queue.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  Status A value of @ref BSP_ATCMD_Status.
+  * @retval None
+  */
+static void ATCMD_Complete(BSP_ATCMD_TypeDef *hat, uint32_t Status)
+{
+  BSP_ATCMD_CmdTypeDef *pCmd = hat->pHead;
+
+  hat->pHead = pCmd->pNext;
+  if (hat->pHead == NULL)
+  {
+    hat->pTail = NULL;
+  }
+  hat->State = BSP_ATCMD_STATE_IDLE;
+
+  if (Status == BSP_ATCMD_STATUS_ERROR)
+  {
+    hat->Stats.Errors++;
+  }
+  else if (Status == BSP_ATCMD_STATUS_TIMEOUT)
+  {
+    hat->Stats.Timeouts++;
+  }
+  else
+  {
+    /* OK or aborted */
+  }
+
+  /* The callback may submit the command again */
+  pCmd->pNext  = NULL;
+  pCmd->Status = Status;
+  if (pCmd->CpltCallback != NULL)
+  {
+    pCmd->CpltCallback(pCmd);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_bkpstore.c
+  * @author  MCU Application Team
+  * @brief   Backup register store BSP service.
+  *          This file provides functions to keep a structure in the backup
+  *          registers over a reset:
+  *           + Two copies, the commit written to the older one
+  *           + Layout version and CRC-16 of each copy
+  *           + Commit sequence choosing the newer valid copy
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The backup registers keep their value over a reset and in STANDBY
+       with VBAT, and take a write in a few cycles without wearing out:
+       counters updated often, the reset reason or the state of a warm boot
+       are kept there instead of the flash. HAL_RTCEx_BKUPWrite() gives
+       16-bit registers: this service keeps a structure in them.
+
+   (#) Enable the backup domain access with HAL_PWR_EnableBkUpAccess() and
+       call BSP_BKPSTORE_Init() with the first register, the size of the
+       structure and its layout version. The store takes
+       BSP_BKPSTORE_REGISTERS(Size) registers up to BSP_BKPSTORE_LAST, 36
+       bytes from RTC_BKP_DR1. Give a new version when the structure
+       changes: the copies of the previous layout no longer read.
+
+   (#) Each copy is a register of version and sequence, the data, then a
+       register of CRC-16/CCITT over both. BSP_BKPSTORE_Init() checks the
+       two copies and keeps the newer one passing its CRC and version.
+
+   (#) BSP_BKPSTORE_Read() copies the data out, HAL_ERROR when no copy is
+       valid: first power up, backup domain reset, tamper event or layout
+       change. The application then starts from its defaults.
+
+   (#) BSP_BKPSTORE_Commit() writes the whole structure to the other copy,
+       its CRC last, then takes it: a reset during the commit leaves a copy
+       failing its CRC and the previous data is read. The commit is not
+       reentrant, call it from one context.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_bkpstore.h"
+#include "py32f4xx_bsp_crc.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_BKPSTORE BSP BKPSTORE
+  * @brief Backup register store BSP service
+  * @{
+  */
+
+#if defined (HAL_RTC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Private_Constants BSP BKPSTORE Private Constants
+  * @{
+  */
+#define BKPSTORE_BYTES_MAX              (2U * BSP_BKPSTORE_LAST)   /* Register image of a copy        */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Private_Macros BSP BKPSTORE Private Macros
+  * @{
+  */
+/* RTC_BKP_DRx of a register number, DR11 to DR42 after a gap */
+#define BKPSTORE_DR(__N__)              (((__N__) <= 10U) ? (__N__) : ((__N__) + 5U))
+
+/* Data registers of a copy */
+#define BKPSTORE_WORDS(__HBS__)         (((__HBS__)->Size + 1U) / 2U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Private_Functions BSP BKPSTORE Private Functions
+  * @{
+  */
+static uint32_t BKPSTORE_ReadCopy(const BSP_BKPSTORE_TypeDef *hbs, uint32_t Bank, uint8_t *pImage);
+static uint32_t BKPSTORE_Crc(const uint8_t *pImage, uint32_t Length);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_BKPSTORE_Exported_Functions BSP BKPSTORE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Place the store in the backup registers and find its valid copy.
+  * @param  hbs Pointer to a BSP_BKPSTORE_TypeDef structure.
+  * @param  hrtc RTC handle.
+  * @param  First First backup register, 1 for RTC_BKP_DR1.
+  * @param  Size Bytes of the data.
+  * @param  Version Layout version of the data, 0 to 255.
+  * @retval HAL status, HAL_OK with or without a valid copy
+  */
+HAL_StatusTypeDef BSP_BKPSTORE_Init(BSP_BKPSTORE_TypeDef *hbs, RTC_HandleTypeDef *hrtc, uint32_t First,
+                                    uint32_t Size, uint32_t Version)
+{
+  uint8_t image[BKPSTORE_BYTES_MAX];
+  uint32_t valid[2];
+  uint32_t seq[2];
+  uint32_t bank;
+
+  if ((hbs == NULL) || (hrtc == NULL) || (First == 0U) || (Size == 0U) || (Version > 0xFFU) ||
+      ((First + BSP_BKPSTORE_REGISTERS(Size) - 1U) > BSP_BKPSTORE_LAST))
+  {
+    return HAL_ERROR;
+  }
+
+  hbs->hrtc    = hrtc;
+  hbs->First   = First;
+  hbs->Size    = Size;
+  hbs->Version = Version;
+
+  for (bank = 0U; bank < 2U; bank++)
+  {
+    valid[bank] = BKPSTORE_ReadCopy(hbs, bank, image);
+    seq[bank]   = image[0];
+  }
+
+  /* The newer copy, sequences compared modulo 256 */
+  if ((valid[0] != 0U) && (valid[1] != 0U))
+  {
+    bank = ((int8_t)(uint8_t)(seq[1] - seq[0]) > 0) ? 1U : 0U;
+  }
+  else
+  {
+    bank = (valid[1] != 0U) ? 1U : 0U;
+  }
+
+  hbs->Bank  = bank;
+  hbs->Seq   = seq[bank];
+  hbs->Valid = valid[bank];
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read the data of the valid copy.
+  * @param  hbs Pointer to a BSP_BKPSTORE_TypeDef structure.
+  * @param  pData Buffer of Size bytes.
+  * @retval HAL status, HAL_ERROR when no copy is valid
+  */
+HAL_StatusTypeDef BSP_BKPSTORE_Read(const BSP_BKPSTORE_TypeDef *hbs, void *pData)
+{
+  uint8_t image[BKPSTORE_BYTES_MAX];
+  uint8_t *pdata = (uint8_t *)pData;
+  uint32_t index;
+
+  if ((pData == NULL) || (hbs->Valid == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Checked again, the registers could have changed since */
+  if (BKPSTORE_ReadCopy(hbs, hbs->Bank, image) == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  for (index = 0U; index < hbs->Size; index++)
+  {
+    pdata[index] = image[2U + index];
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write the data to the other copy and take it.
+  * @param  hbs Pointer to a BSP_BKPSTORE_TypeDef structure.
+  * @param  pData Data of Size bytes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BKPSTORE_Commit(BSP_BKPSTORE_TypeDef *hbs, const void *pData)
+{
+  uint8_t image[BKPSTORE_BYTES_MAX];
+  const uint8_t *pdata = (const uint8_t *)pData;
+  uint32_t words = BKPSTORE_WORDS(hbs);
+  uint32_t bank = hbs->Bank ^ 1U;
+  uint32_t seq = (hbs->Seq + 1U) & 0xFFU;
+  uint32_t reg = hbs->First + (bank * (words + 2U));
+  uint32_t index;
+
+  if (pData == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  image[0] = (uint8_t)seq;
+  image[1] = (uint8_t)hbs->Version;
+  for (index = 0U; index < (2U * words); index++)
+  {
+    image[2U + index] = (index < hbs->Size) ? pdata[index] : 0U;
+  }
+
+  for (index = 0U; index <= words; index++)
+  {
+    HAL_RTCEx_BKUPWrite(hbs->hrtc, BKPSTORE_DR(reg + index),
+                        (uint32_t)image[2U * index] | ((uint32_t)image[(2U * index) + 1U] << 8));
+  }
+  HAL_RTCEx_BKUPWrite(hbs->hrtc, BKPSTORE_DR(reg + words + 1U), BKPSTORE_Crc(image, 2U * (words + 1U)));
+
+  hbs->Bank  = bank;
+  hbs->Seq   = seq;
+  hbs->Valid = 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Clear both copies, the next read fails up to a commit.
+  * @param  hbs Pointer to a BSP_BKPSTORE_TypeDef structure.
+  * @retval None
+  */
+void BSP_BKPSTORE_Erase(BSP_BKPSTORE_TypeDef *hbs)
+{
+  uint32_t index;
+
+  for (index = 0U; index < BSP_BKPSTORE_REGISTERS(hbs->Size); index++)
+  {
+    HAL_RTCEx_BKUPWrite(hbs->hrtc, BKPSTORE_DR(hbs->First + index), 0U);
+  }
+
+  /* The CRC of zeros from 0xFFFF is never 0, the copies fail */
+  hbs->Bank  = 0U;
+  hbs->Seq   = 0U;
+  hbs->Valid = 0U;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_BKPSTORE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read a copy into an image of its registers and check it.
+  * @param  hbs Pointer to a BSP_BKPSTORE_TypeDef structure.
+  * @param  Bank Copy, 0 or 1.
+  * @param  pImage Image of the sequence, version and data registers.
+  * @retval 1 when the CRC and the version match
+  */
+static uint32_t BKPSTORE_ReadCopy(const BSP_BKPSTORE_TypeDef *hbs, uint32_t Bank, uint8_t *pImage)
+{
+  uint32_t words = BKPSTORE_WORDS(hbs);
+  uint32_t reg = hbs->First + (Bank * (words + 2U));
+  uint32_t value;
+  uint32_t index;
+
+  for (index = 0U; index <= words; index++)
+  {
+    value = HAL_RTCEx_BKUPRead(hbs->hrtc, BKPSTORE_DR(reg + index));
+    pImage[2U * index]        = (uint8_t)value;
+    pImage[(2U * index) + 1U] = (uint8_t)(value >> 8);
+  }
+  value = HAL_RTCEx_BKUPRead(hbs->hrtc, BKPSTORE_DR(reg + words + 1U));
+
+  return ((value == BKPSTORE_Crc(pImage, 2U * (words + 1U))) && (pImage[1] == hbs->Version)) ? 1U : 0U;
+}
+
+/**
+  * @brief  CRC-16/CCITT of a copy image.
+  * @param  pImage Image of the sequence, version and data registers.
+  * @param  Length Bytes of the image.
+  * @retval CRC
+  */
+static uint32_t BKPSTORE_Crc(const uint8_t *pImage, uint32_t Length)
+{
+  return BSP_CRC_Bitwise(&BSP_CRC_Model_CRC16_CCITT, pImage, Length);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,994 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_blkdev.c
+  * @author  MCU Application Team
+  * @brief   Block device BSP service.
+  *          This file provides a sector interface over the storage devices,
+  *          for a filesystem:
+  *           + Drivers of the SD card, the ESMC NOR flash and the SPI NOR flash
+  *           + Write-back sector cache with least recently used replacement
+  *           + Read-ahead of the sequential reads
+  *           + Runs of sectors moved by the device straight to the caller
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A filesystem reading and writing one sector per call runs at the
+       latency of the device, not its bandwidth: a command per sector on the
+       SD card, a whole erase and program per sector on a NOR flash. The
+       block device caches the sectors, writes them back when they are
+       replaced or synchronized, and gives the runs of two sectors and more
+       to the device in one operation, multiple block commands with DMA on
+       the SD card.
+
+   (#) Give the cache as NbrOfLines lines and one buffer of
+       NbrOfLines x SectorSize bytes, word aligned: the lines use it in
+       order, so that NbrOfLines lines next to each other take one multiple
+       sector read. Then initialize the device over its driver:
+       (++) BSP_BLKDEV_InitSD(): the card initialized by HAL_SD_Init(),
+            512 byte sectors. With hdmarx and hdmatx linked, the word aligned
+            transfers run with HAL_SD_ReadBlocks_DMA() and
+            HAL_SD_WriteBlocks_DMA(), the others by polling.
+       (++) BSP_BLKDEV_InitSPIFlash(): sectors of the smallest erase found
+            by BSP_SPIFLASH_Init(), written by an erase and a program.
+       (++) BSP_BLKDEV_InitESMCFlash(): 4 Kbyte sectors, FlashSize bytes,
+            the erases and programs of BSP_ESMCFLASH waited for: its tick must
+            run. Aligned 64 Kbyte runs are erased as one block.
+       (++) BSP_BLKDEV_Init() with a BSP_BLKDEV_OpsTypeDef of another device.
+
+   (#) BSP_BLKDEV_Read() and BSP_BLKDEV_Write() move whole sectors:
+       (++) the sectors in the cache are copied from or into their line, a
+            written line is dirty until written back;
+       (++) a run of two sectors and more out of the cache goes to the
+            device with the caller buffer when it is word aligned;
+       (++) a single sector written goes to a line, replacing the least
+            recently used one, written back first when dirty;
+       (++) a single sector read right after the previous read loads
+            BSP_BLKDEV_READ_AHEAD sectors in a window of lines next to each
+            other, the windows taken in turn, when the cache has twice as
+            many lines. Other reads load one line.
+
+   (#) BSP_BLKDEV_Sync() writes the dirty lines back in the sector order, then
+       ends the pending writes of the device: call it before a power down or
+       a card removal, the filesystem does it on its sync calls.
+       BSP_BLKDEV_Erase() drops the cached sectors of a range, dirty or not,
+       and lets the device discard them: a sector erase on the NOR flashes,
+       the SD card erase command.
+
+   (#) py32f4xx_bsp_diskio.c plugs the block devices into FatFs.
+       The functions are blocking and must not be called from interrupts.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_blkdev.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_BLKDEV BSP BLKDEV
+  * @brief Block device BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_BLKDEV_Private_Constants BSP BLKDEV Private Constants
+  * @{
+  */
+#define BLKDEV_ESMC_SECTOR              4096U          /* 20h sector erase                            */
+#define BLKDEV_ESMC_BLOCK               65536U         /* D8h block erase                             */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_BLKDEV_Private_Macros BSP BLKDEV Private Macros
+  * @{
+  */
+#define BLKDEV_IS_ALIGNED(__PTR__)      ((((uint32_t)(__PTR__)) & 3U) == 0U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_BLKDEV_Private_Functions
+  * @{
+  */
+static BSP_BLKDEV_LineTypeDef *BLKDEV_Find(const BSP_BLKDEV_TypeDef *hdev, uint32_t Sector);
+static uint32_t          BLKDEV_Uncached(const BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_Clean(BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_LineTypeDef *pLine);
+static HAL_StatusTypeDef BLKDEV_Victim(BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_LineTypeDef **ppLine);
+static HAL_StatusTypeDef BLKDEV_Load(BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, BSP_BLKDEV_LineTypeDef **ppLine);
+#if defined (HAL_SD_MODULE_ENABLED)
+static HAL_StatusTypeDef BLKDEV_SDWait(SD_HandleTypeDef *hsd, HAL_StatusTypeDef Status);
+static HAL_StatusTypeDef BLKDEV_SDRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_SDWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_SDSync(void *pDev);
+static HAL_StatusTypeDef BLKDEV_SDErase(void *pDev, uint32_t Sector, uint32_t Count);
+#endif /* HAL_SD_MODULE_ENABLED */
+#if defined (HAL_ESMC_MODULE_ENABLED)
+static HAL_StatusTypeDef BLKDEV_ESMCWait(BSP_ESMCFLASH_TypeDef *hflash, HAL_StatusTypeDef Status);
+static HAL_StatusTypeDef BLKDEV_ESMCRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_ESMCWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_ESMCSync(void *pDev);
+static HAL_StatusTypeDef BLKDEV_ESMCErase(void *pDev, uint32_t Sector, uint32_t Count);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+#if defined (HAL_SPI_MODULE_ENABLED)
+static HAL_StatusTypeDef BLKDEV_SPIRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_SPIWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count);
+static HAL_StatusTypeDef BLKDEV_SPISync(void *pDev);
+static HAL_StatusTypeDef BLKDEV_SPIErase(void *pDev, uint32_t Sector, uint32_t Count);
+#endif /* HAL_SPI_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/** @defgroup BSP_BLKDEV_Private_Variables BSP BLKDEV Private Variables
+  * @{
+  */
+#if defined (HAL_SD_MODULE_ENABLED)
+static const BSP_BLKDEV_OpsTypeDef BLKDEV_SDOps =
+{
+  BLKDEV_SDRead, BLKDEV_SDWrite, BLKDEV_SDSync, BLKDEV_SDErase
+};
+#endif /* HAL_SD_MODULE_ENABLED */
+
+#if defined (HAL_ESMC_MODULE_ENABLED)
+static const BSP_BLKDEV_OpsTypeDef BLKDEV_ESMCOps =
+{
+  BLKDEV_ESMCRead, BLKDEV_ESMCWrite, BLKDEV_ESMCSync, BLKDEV_ESMCErase
+};
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#if defined (HAL_SPI_MODULE_ENABLED)
+static const BSP_BLKDEV_OpsTypeDef BLKDEV_SPIOps =
+{
+  BLKDEV_SPIRead, BLKDEV_SPIWrite, BLKDEV_SPISync, BLKDEV_SPIErase
+};
+#endif /* HAL_SPI_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_BLKDEV_Exported_Functions BSP BLKDEV Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_BLKDEV_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind a block device to its driver and its cache
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a block device over a driver.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  pOps Driver, Read, Write and Sync set.
+  * @param  pDev Handle of the device given to the driver.
+  * @param  SectorSize Bytes of a sector, a multiple of 4.
+  * @param  SectorCount Sectors of the device.
+  * @param  pLines Cache lines.
+  * @param  NbrOfLines Cache lines, 1 or more.
+  * @param  pBuffer Cache buffer, NbrOfLines x SectorSize bytes, word aligned.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_Init(BSP_BLKDEV_TypeDef *hdev, const BSP_BLKDEV_OpsTypeDef *pOps, void *pDev,
+                                  uint32_t SectorSize, uint32_t SectorCount,
+                                  BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer)
+{
+  uint32_t i;
+
+  if ((hdev == NULL) || (pOps == NULL) || (pOps->Read == NULL) || (pOps->Write == NULL) ||
+      (pOps->Sync == NULL) || (SectorSize == 0U) || ((SectorSize & 3U) != 0U) || (SectorCount == 0U) ||
+      (pLines == NULL) || (NbrOfLines == 0U) || (pBuffer == NULL) || !BLKDEV_IS_ALIGNED(pBuffer))
+  {
+    return HAL_ERROR;
+  }
+
+  hdev->pOps        = pOps;
+  hdev->pDev        = pDev;
+  hdev->SectorSize  = SectorSize;
+  hdev->SectorCount = SectorCount;
+  hdev->pLines      = pLines;
+  hdev->NbrOfLines  = NbrOfLines;
+  hdev->Stamp       = 0U;
+  hdev->AheadLine   = 0U;
+  hdev->NextRead    = BSP_BLKDEV_NO_SECTOR;
+
+  for (i = 0U; i < NbrOfLines; i++)
+  {
+    pLines[i].Sector = BSP_BLKDEV_NO_SECTOR;
+    pLines[i].Stamp  = 0U;
+    pLines[i].Dirty  = 0U;
+    pLines[i].pData  = &pBuffer[i * SectorSize];
+  }
+
+  hdev->Stats.ReadHits     = 0U;
+  hdev->Stats.ReadMisses   = 0U;
+  hdev->Stats.ReadAheads   = 0U;
+  hdev->Stats.DirectReads  = 0U;
+  hdev->Stats.WriteHits    = 0U;
+  hdev->Stats.WriteBacks   = 0U;
+  hdev->Stats.DirectWrites = 0U;
+  hdev->Stats.Errors       = 0U;
+
+  hdev->State = BSP_BLKDEV_STATE_READY;
+
+  return HAL_OK;
+}
+
+#if defined (HAL_SD_MODULE_ENABLED)
+/**
+  * @brief  Initialize a block device over an SD card.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  hsd SD handle, card initialized, hdmarx and hdmatx may be linked.
+  * @param  pLines Cache lines.
+  * @param  NbrOfLines Cache lines, 1 or more.
+  * @param  pBuffer Cache buffer, NbrOfLines x BLOCKSIZE bytes, word aligned.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_InitSD(BSP_BLKDEV_TypeDef *hdev, SD_HandleTypeDef *hsd,
+                                    BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer)
+{
+  if (hsd == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  return BSP_BLKDEV_Init(hdev, &BLKDEV_SDOps, hsd, BLOCKSIZE, hsd->SdCard.LogBlockNbr,
+                         pLines, NbrOfLines, pBuffer);
+}
+#endif /* HAL_SD_MODULE_ENABLED */
+
+#if defined (HAL_ESMC_MODULE_ENABLED)
+/**
+  * @brief  Initialize a block device over an ESMC NOR flash.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  hflash Flash initialized by BSP_ESMCFLASH_Init(), its tick running.
+  * @param  FlashSize Bytes of the flash given to the device, a multiple of 4 Kbytes.
+  * @param  pLines Cache lines.
+  * @param  NbrOfLines Cache lines, 1 or more.
+  * @param  pBuffer Cache buffer, NbrOfLines x 4 Kbytes, word aligned.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_InitESMCFlash(BSP_BLKDEV_TypeDef *hdev, BSP_ESMCFLASH_TypeDef *hflash,
+                                           uint32_t FlashSize, BSP_BLKDEV_LineTypeDef *pLines,
+                                           uint32_t NbrOfLines, uint8_t *pBuffer)
+{
+  if ((hflash == NULL) || (hflash->hesmc == NULL) || ((FlashSize % BLKDEV_ESMC_SECTOR) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  return BSP_BLKDEV_Init(hdev, &BLKDEV_ESMCOps, hflash, BLKDEV_ESMC_SECTOR, FlashSize / BLKDEV_ESMC_SECTOR,
+                         pLines, NbrOfLines, pBuffer);
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#if defined (HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  Initialize a block device over a SPI NOR flash.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  hflash Flash initialized by BSP_SPIFLASH_Init().
+  * @param  pLines Cache lines.
+  * @param  NbrOfLines Cache lines, 1 or more.
+  * @param  pBuffer Cache buffer, NbrOfLines x hflash->EraseSize bytes, word aligned.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_InitSPIFlash(BSP_BLKDEV_TypeDef *hdev, BSP_SPIFLASH_TypeDef *hflash,
+                                          BSP_BLKDEV_LineTypeDef *pLines, uint32_t NbrOfLines, uint8_t *pBuffer)
+{
+  if ((hflash == NULL) || (hflash->hspi == NULL) || (hflash->EraseSize == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  return BSP_BLKDEV_Init(hdev, &BLKDEV_SPIOps, hflash, hflash->EraseSize, hflash->Size / hflash->EraseSize,
+                         pLines, NbrOfLines, pBuffer);
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_BLKDEV_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Read and write sectors through the cache
+      (+) Write the cache back and discard sectors
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Read sectors.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  pData Buffer, Count x SectorSize bytes, word aligned for the direct reads.
+  * @param  Sector First sector.
+  * @param  Count Sectors.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_Read(BSP_BLKDEV_TypeDef *hdev, uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  BSP_BLKDEV_LineTypeDef *line;
+  HAL_StatusTypeDef status;
+  uint32_t run;
+
+  if ((hdev->State != BSP_BLKDEV_STATE_READY) || (pData == NULL) || (Count == 0U) ||
+      (Sector >= hdev->SectorCount) || (Count > (hdev->SectorCount - Sector)))
+  {
+    return HAL_ERROR;
+  }
+
+  while (Count != 0U)
+  {
+    run = 1U;
+    line = BLKDEV_Find(hdev, Sector);
+    if (line != NULL)
+    {
+      hdev->Stats.ReadHits++;
+    }
+    else
+    {
+      run = BLKDEV_Uncached(hdev, Sector, Count);
+      if ((run > 1U) && BLKDEV_IS_ALIGNED(pData))
+      {
+        status = hdev->pOps->Read(hdev->pDev, pData, Sector, run);
+        if (status != HAL_OK)
+        {
+          hdev->Stats.Errors++;
+          return status;
+        }
+        hdev->Stats.DirectReads += run;
+      }
+      else
+      {
+        run = 1U;
+        status = BLKDEV_Load(hdev, Sector, &line);
+        if (status != HAL_OK)
+        {
+          return status;
+        }
+      }
+    }
+
+    if (line != NULL)
+    {
+      (void)memcpy(pData, line->pData, hdev->SectorSize);
+      line->Stamp = ++hdev->Stamp;
+    }
+
+    pData  += run * hdev->SectorSize;
+    Sector += run;
+    Count  -= run;
+    hdev->NextRead = Sector;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write sectors.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  pData Data, Count x SectorSize bytes, word aligned for the direct writes.
+  * @param  Sector First sector.
+  * @param  Count Sectors.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_Write(BSP_BLKDEV_TypeDef *hdev, const uint8_t *pData, uint32_t Sector,
+                                   uint32_t Count)
+{
+  BSP_BLKDEV_LineTypeDef *line;
+  HAL_StatusTypeDef status;
+  uint32_t run;
+
+  if ((hdev->State != BSP_BLKDEV_STATE_READY) || (pData == NULL) || (Count == 0U) ||
+      (Sector >= hdev->SectorCount) || (Count > (hdev->SectorCount - Sector)))
+  {
+    return HAL_ERROR;
+  }
+
+  while (Count != 0U)
+  {
+    run = 1U;
+    line = BLKDEV_Find(hdev, Sector);
+    if (line != NULL)
+    {
+      hdev->Stats.WriteHits++;
+    }
+    else
+    {
+      run = BLKDEV_Uncached(hdev, Sector, Count);
+      if ((run > 1U) && BLKDEV_IS_ALIGNED(pData))
+      {
+        status = hdev->pOps->Write(hdev->pDev, pData, Sector, run);
+        if (status != HAL_OK)
+        {
+          hdev->Stats.Errors++;
+          return status;
+        }
+        hdev->Stats.DirectWrites += run;
+      }
+      else
+      {
+        run = 1U;
+        status = BLKDEV_Victim(hdev, &line);
+        if (status != HAL_OK)
+        {
+          return status;
+        }
+        line->Sector = Sector;
+      }
+    }
+
+    if (line != NULL)
+    {
+      (void)memcpy(line->pData, pData, hdev->SectorSize);
+      line->Dirty = 1U;
+      line->Stamp = ++hdev->Stamp;
+    }
+
+    pData  += run * hdev->SectorSize;
+    Sector += run;
+    Count  -= run;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write the dirty sectors back and end the pending writes of the device.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_Sync(BSP_BLKDEV_TypeDef *hdev)
+{
+  BSP_BLKDEV_LineTypeDef *first;
+  HAL_StatusTypeDef status;
+  uint32_t i;
+
+  if (hdev->State != BSP_BLKDEV_STATE_READY)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Lowest dirty sector first, the device sees the writes in order */
+  for (;;)
+  {
+    first = NULL;
+    for (i = 0U; i < hdev->NbrOfLines; i++)
+    {
+      if ((hdev->pLines[i].Dirty != 0U) && ((first == NULL) || (hdev->pLines[i].Sector < first->Sector)))
+      {
+        first = &hdev->pLines[i];
+      }
+    }
+    if (first == NULL)
+    {
+      break;
+    }
+    status = BLKDEV_Clean(hdev, first);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+  }
+
+  status = hdev->pOps->Sync(hdev->pDev);
+  if (status != HAL_OK)
+  {
+    hdev->Stats.Errors++;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Discard sectors, their cached content dropped.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  Sector First sector.
+  * @param  Count Sectors.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_BLKDEV_Erase(BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, uint32_t Count)
+{
+  BSP_BLKDEV_LineTypeDef *line;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t i;
+
+  if ((hdev->State != BSP_BLKDEV_STATE_READY) || (Count == 0U) ||
+      (Sector >= hdev->SectorCount) || (Count > (hdev->SectorCount - Sector)))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < hdev->NbrOfLines; i++)
+  {
+    line = &hdev->pLines[i];
+    if ((line->Sector != BSP_BLKDEV_NO_SECTOR) && (line->Sector >= Sector) && ((line->Sector - Sector) < Count))
+    {
+      line->Sector = BSP_BLKDEV_NO_SECTOR;
+      line->Dirty  = 0U;
+      line->Stamp  = 0U;
+    }
+  }
+
+  if (hdev->pOps->Erase != NULL)
+  {
+    status = hdev->pOps->Erase(hdev->pDev, Sector, Count);
+    if (status != HAL_OK)
+    {
+      hdev->Stats.Errors++;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_BLKDEV_GetStats(const BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_StatsTypeDef *pStats)
+{
+  *pStats = hdev->Stats;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_BLKDEV_Private_Functions BSP BLKDEV Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Find the cache line of a sector.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  Sector Sector.
+  * @retval Line, NULL when the sector is not cached
+  */
+static BSP_BLKDEV_LineTypeDef *BLKDEV_Find(const BSP_BLKDEV_TypeDef *hdev, uint32_t Sector)
+{
+  uint32_t i;
+
+  for (i = 0U; i < hdev->NbrOfLines; i++)
+  {
+    if (hdev->pLines[i].Sector == Sector)
+    {
+      return &hdev->pLines[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Count the sectors out of the cache from a sector.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  Sector First sector, not cached.
+  * @param  Count Sectors at most.
+  * @retval Sectors, 1 or more
+  */
+static uint32_t BLKDEV_Uncached(const BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, uint32_t Count)
+{
+  uint32_t run = 1U;
+
+  while ((run < Count) && (BLKDEV_Find(hdev, Sector + run) == NULL))
+  {
+    run++;
+  }
+
+  return run;
+}
+
+/**
+  * @brief  Write a dirty line back to the device.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  pLine Line.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef BLKDEV_Clean(BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_LineTypeDef *pLine)
+{
+  HAL_StatusTypeDef status;
+
+  if (pLine->Dirty == 0U)
+  {
+    return HAL_OK;
+  }
+
+  status = hdev->pOps->Write(hdev->pDev, pLine->pData, pLine->Sector, 1U);
+  if (status != HAL_OK)
+  {
+    hdev->Stats.Errors++;
+    return status;
+  }
+  pLine->Dirty = 0U;
+  hdev->Stats.WriteBacks++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take the least recently used line, written back and emptied.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  ppLine Line taken.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef BLKDEV_Victim(BSP_BLKDEV_TypeDef *hdev, BSP_BLKDEV_LineTypeDef **ppLine)
+{
+  BSP_BLKDEV_LineTypeDef *victim = &hdev->pLines[0];
+  HAL_StatusTypeDef status;
+  uint32_t i;
+
+  for (i = 1U; i < hdev->NbrOfLines; i++)
+  {
+    if (hdev->pLines[i].Stamp < victim->Stamp)
+    {
+      victim = &hdev->pLines[i];
+    }
+  }
+
+  status = BLKDEV_Clean(hdev, victim);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  victim->Sector = BSP_BLKDEV_NO_SECTOR;
+  victim->Stamp  = 0U;
+  *ppLine = victim;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Load a sector missed by a read, with the following ones when sequential.
+  * @param  hdev Pointer to a BSP_BLKDEV_TypeDef structure.
+  * @param  Sector Sector, not cached.
+  * @param  ppLine Line of the sector.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef BLKDEV_Load(BSP_BLKDEV_TypeDef *hdev, uint32_t Sector, BSP_BLKDEV_LineTypeDef **ppLine)
+{
+  BSP_BLKDEV_LineTypeDef *window;
+  HAL_StatusTypeDef status;
+  uint32_t count = 1U;
+  uint32_t i;
+
+  if ((Sector == hdev->NextRead) && (hdev->NbrOfLines >= (2U * BSP_BLKDEV_READ_AHEAD)))
+  {
+    /* Sectors next to each other, out of the cache and on the device */
+    count = BLKDEV_Uncached(hdev, Sector, BSP_BLKDEV_READ_AHEAD);
+    if (count > (hdev->SectorCount - Sector))
+    {
+      count = hdev->SectorCount - Sector;
+    }
+  }
+
+  if (count == 1U)
+  {
+    status = BLKDEV_Victim(hdev, &window);
+  }
+  else
+  {
+    /* Windows of lines next to each other, their buffers contiguous */
+    if ((hdev->AheadLine + BSP_BLKDEV_READ_AHEAD) > hdev->NbrOfLines)
+    {
+      hdev->AheadLine = 0U;
+    }
+    window = &hdev->pLines[hdev->AheadLine];
+    hdev->AheadLine += BSP_BLKDEV_READ_AHEAD;
+
+    status = HAL_OK;
+    for (i = 0U; (i < count) && (status == HAL_OK); i++)
+    {
+      status = BLKDEV_Clean(hdev, &window[i]);
+      window[i].Sector = BSP_BLKDEV_NO_SECTOR;
+      window[i].Stamp  = 0U;
+    }
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  status = hdev->pOps->Read(hdev->pDev, window->pData, Sector, count);
+  if (status != HAL_OK)
+  {
+    hdev->Stats.Errors++;
+    return status;
+  }
+
+  for (i = 0U; i < count; i++)
+  {
+    window[i].Sector = Sector + i;
+    window[i].Stamp  = ++hdev->Stamp;
+  }
+  hdev->Stats.ReadMisses++;
+  hdev->Stats.ReadAheads += count - 1U;
+  *ppLine = window;
+
+  return HAL_OK;
+}
+
+#if defined (HAL_SD_MODULE_ENABLED)
+/**
+  * @brief  Wait for the end of a transfer and of the card programming.
+  * @param  hsd SD handle.
+  * @param  Status Status of the transfer start.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef BLKDEV_SDWait(SD_HandleTypeDef *hsd, HAL_StatusTypeDef Status)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  if (Status != HAL_OK)
+  {
+    return Status;
+  }
+
+  while (hsd->State != HAL_SD_STATE_READY)
+  {
+    if ((HAL_GetTick() - tickstart) >= BSP_BLKDEV_TIMEOUT)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+  if (hsd->ErrorCode != HAL_SD_ERROR_NONE)
+  {
+    return HAL_ERROR;
+  }
+
+  while (HAL_SD_GetCardState(hsd) != HAL_SD_CARD_TRANSFER)
+  {
+    if ((hsd->ErrorCode != HAL_SD_ERROR_NONE) || ((HAL_GetTick() - tickstart) >= BSP_BLKDEV_TIMEOUT))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  SD card driver, read.
+  */
+static HAL_StatusTypeDef BLKDEV_SDRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  SD_HandleTypeDef *hsd = (SD_HandleTypeDef *)pDev;
+
+  if ((hsd->hdmarx != NULL) && BLKDEV_IS_ALIGNED(pData))
+  {
+    return BLKDEV_SDWait(hsd, HAL_SD_ReadBlocks_DMA(hsd, pData, Sector, Count));
+  }
+
+  return BLKDEV_SDWait(hsd, HAL_SD_ReadBlocks(hsd, pData, Sector, Count, BSP_BLKDEV_TIMEOUT));
+}
+
+/**
+  * @brief  SD card driver, write.
+  */
+static HAL_StatusTypeDef BLKDEV_SDWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  SD_HandleTypeDef *hsd = (SD_HandleTypeDef *)pDev;
+
+  if ((hsd->hdmatx != NULL) && BLKDEV_IS_ALIGNED(pData))
+  {
+    return BLKDEV_SDWait(hsd, HAL_SD_WriteBlocks_DMA(hsd, (uint8_t *)pData, Sector, Count));
+  }
+
+  return BLKDEV_SDWait(hsd, HAL_SD_WriteBlocks(hsd, (uint8_t *)pData, Sector, Count, BSP_BLKDEV_TIMEOUT));
+}
+
+/**
+  * @brief  SD card driver, sync: the writes end with the programming already.
+  */
+static HAL_StatusTypeDef BLKDEV_SDSync(void *pDev)
+{
+  return BLKDEV_SDWait((SD_HandleTypeDef *)pDev, HAL_OK);
+}
+
+/**
+  * @brief  SD card driver, erase.
+  */
+static HAL_StatusTypeDef BLKDEV_SDErase(void *pDev, uint32_t Sector, uint32_t Count)
+{
+  SD_HandleTypeDef *hsd = (SD_HandleTypeDef *)pDev;
+
+  return BLKDEV_SDWait(hsd, HAL_SD_Erase(hsd, Sector, Sector + Count - 1U));
+}
+#endif /* HAL_SD_MODULE_ENABLED */
+
+#if defined (HAL_ESMC_MODULE_ENABLED)
+/**
+  * @brief  Wait for the end of a flash operation.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Status Status of the operation start.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef BLKDEV_ESMCWait(BSP_ESMCFLASH_TypeDef *hflash, HAL_StatusTypeDef Status)
+{
+  if (Status != HAL_OK)
+  {
+    return Status;
+  }
+
+  /* Ended by BSP_ESMCFLASH_Tick(), with its own timeouts */
+  while (BSP_ESMCFLASH_IsBusy(hflash) != 0U)
+  {
+  }
+
+  return (hflash->LastStatus == BSP_ESMCFLASH_STATUS_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  ESMC flash driver, read.
+  */
+static HAL_StatusTypeDef BLKDEV_ESMCRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  BSP_ESMCFLASH_TypeDef *hflash = (BSP_ESMCFLASH_TypeDef *)pDev;
+
+  while (BSP_ESMCFLASH_IsBusy(hflash) != 0U)
+  {
+  }
+
+  return BSP_ESMCFLASH_Read(hflash, Sector * BLKDEV_ESMC_SECTOR, pData, Count * BLKDEV_ESMC_SECTOR);
+}
+
+/**
+  * @brief  ESMC flash driver, write: erase then program.
+  */
+static HAL_StatusTypeDef BLKDEV_ESMCWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  BSP_ESMCFLASH_TypeDef *hflash = (BSP_ESMCFLASH_TypeDef *)pDev;
+  HAL_StatusTypeDef status;
+
+  status = BLKDEV_ESMCErase(pDev, Sector, Count);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return BLKDEV_ESMCWait(hflash, BSP_ESMCFLASH_Program_IT(hflash, Sector * BLKDEV_ESMC_SECTOR, pData,
+                                                          Count * BLKDEV_ESMC_SECTOR));
+}
+
+/**
+  * @brief  ESMC flash driver, sync.
+  */
+static HAL_StatusTypeDef BLKDEV_ESMCSync(void *pDev)
+{
+  return BLKDEV_ESMCWait((BSP_ESMCFLASH_TypeDef *)pDev, HAL_OK);
+}
+
+/**
+  * @brief  ESMC flash driver, erase: 64 Kbyte blocks where aligned, sectors elsewhere.
+  */
+static HAL_StatusTypeDef BLKDEV_ESMCErase(void *pDev, uint32_t Sector, uint32_t Count)
+{
+  BSP_ESMCFLASH_TypeDef *hflash = (BSP_ESMCFLASH_TypeDef *)pDev;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t address = Sector * BLKDEV_ESMC_SECTOR;
+  uint32_t end = address + (Count * BLKDEV_ESMC_SECTOR);
+
+  while ((address < end) && (status == HAL_OK))
+  {
+    if (((address % BLKDEV_ESMC_BLOCK) == 0U) && ((end - address) >= BLKDEV_ESMC_BLOCK))
+    {
+      status = BLKDEV_ESMCWait(hflash, BSP_ESMCFLASH_Erase_IT(hflash, address, BSP_ESMCFLASH_ERASE_BLOCK));
+      address += BLKDEV_ESMC_BLOCK;
+    }
+    else
+    {
+      status = BLKDEV_ESMCWait(hflash, BSP_ESMCFLASH_Erase_IT(hflash, address, BSP_ESMCFLASH_ERASE_SECTOR));
+      address += BLKDEV_ESMC_SECTOR;
+    }
+  }
+
+  return status;
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#if defined (HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  SPI flash driver, read.
+  */
+static HAL_StatusTypeDef BLKDEV_SPIRead(void *pDev, uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  BSP_SPIFLASH_TypeDef *hflash = (BSP_SPIFLASH_TypeDef *)pDev;
+
+  return BSP_SPIFLASH_Read(hflash, Sector * hflash->EraseSize, pData, Count * hflash->EraseSize);
+}
+
+/**
+  * @brief  SPI flash driver, write: erase then program.
+  */
+static HAL_StatusTypeDef BLKDEV_SPIWrite(void *pDev, const uint8_t *pData, uint32_t Sector, uint32_t Count)
+{
+  BSP_SPIFLASH_TypeDef *hflash = (BSP_SPIFLASH_TypeDef *)pDev;
+  HAL_StatusTypeDef status;
+
+  status = BSP_SPIFLASH_Erase(hflash, Sector * hflash->EraseSize, Count * hflash->EraseSize);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return BSP_SPIFLASH_Write(hflash, Sector * hflash->EraseSize, pData, Count * hflash->EraseSize);
+}
+
+/**
+  * @brief  SPI flash driver, sync: program the batched page.
+  */
+static HAL_StatusTypeDef BLKDEV_SPISync(void *pDev)
+{
+  return BSP_SPIFLASH_Flush((BSP_SPIFLASH_TypeDef *)pDev);
+}
+
+/**
+  * @brief  SPI flash driver, erase.
+  */
+static HAL_StatusTypeDef BLKDEV_SPIErase(void *pDev, uint32_t Sector, uint32_t Count)
+{
+  BSP_SPIFLASH_TypeDef *hflash = (BSP_SPIFLASH_TypeDef *)pDev;
+
+  return BSP_SPIFLASH_Erase(hflash, Sector * hflash->EraseSize, Count * hflash->EraseSize);
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
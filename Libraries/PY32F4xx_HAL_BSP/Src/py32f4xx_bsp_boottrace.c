@@ -0,0 +1,162 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_boottrace.c
+  * @author  MCU Application Team
+  * @brief   Boot timeline trace BSP service.
+  *          This file provides functions to measure the time to the first
+  *          useful work:
+  *           + Named marks stamped with the DWT cycle counter
+  *           + Time from reset when built with USE_FAST_BOOT
+  *           + Timeline printed once the output is up
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Call BSP_BOOTTRACE_Mark() with a string constant at each boot step, for
+       instance "main", "HAL_Init", "clock", "sensor" and "first sample". A
+       mark costs a few cycles and no output.
+
+   (#) Built with USE_FAST_BOOT=y the cycle counter runs from SystemEarlyInit(),
+       the first mark then includes the .data copy, the .bss zeroing and the
+       constructors. Otherwise it starts on the first mark.
+
+   (#) Once the UART is up, BSP_BOOTTRACE_Print() prints each mark with its
+       cycle count and the time since the previous mark, the delta taken at
+       the HCLK of the mark closing it. BSP_BOOTTRACE_GetMark() gives the raw
+       marks to a test bench instead.
+
+   (#) To shorten the boot, initialize in main() only what the first sample
+       needs and leave the other peripherals to their first use: the trace
+       shows where the time goes.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "py32f4xx_bsp_boottrace.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_BOOTTRACE BSP BOOTTRACE
+  * @brief Boot timeline trace BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_BOOTTRACE_Private_Variables BSP BOOTTRACE Private Variables
+  * @{
+  */
+static BSP_BOOTTRACE_MarkTypeDef BOOTTRACE_Marks[BSP_BOOTTRACE_MARKS];
+static uint32_t BOOTTRACE_Count;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_BOOTTRACE_Exported_Functions BSP BOOTTRACE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Record a boot step.
+  * @param  pName Step name, a string constant kept by reference.
+  * @retval None
+  */
+void BSP_BOOTTRACE_Mark(const char *pName)
+{
+  uint32_t cycles;
+
+  HAL_EnableCycleCounter();
+  cycles = DWT->CYCCNT;
+
+  if (BOOTTRACE_Count < BSP_BOOTTRACE_MARKS)
+  {
+    BOOTTRACE_Marks[BOOTTRACE_Count].pName    = pName;
+    BOOTTRACE_Marks[BOOTTRACE_Count].Cycles   = cycles;
+    BOOTTRACE_Marks[BOOTTRACE_Count].HCLKFreq = SystemCoreClock;
+    BOOTTRACE_Count++;
+  }
+}
+
+/**
+  * @brief  Get the number of marks recorded.
+  * @retval Number of marks
+  */
+uint32_t BSP_BOOTTRACE_GetCount(void)
+{
+  return BOOTTRACE_Count;
+}
+
+/**
+  * @brief  Get a mark.
+  * @param  Index Mark index, from 0 to BSP_BOOTTRACE_GetCount() - 1.
+  * @retval Mark, NULL for an index out of range
+  */
+const BSP_BOOTTRACE_MarkTypeDef *BSP_BOOTTRACE_GetMark(uint32_t Index)
+{
+  if (Index >= BOOTTRACE_Count)
+  {
+    return NULL;
+  }
+
+  return &BOOTTRACE_Marks[Index];
+}
+
+/**
+  * @brief  Print the timeline with printf().
+  * @retval None
+  */
+void BSP_BOOTTRACE_Print(void)
+{
+  uint32_t previous = 0U;
+  uint32_t mhz;
+  uint32_t i;
+
+  for (i = 0U; i < BOOTTRACE_Count; i++)
+  {
+    mhz = BOOTTRACE_Marks[i].HCLKFreq / 1000000U;
+    if (mhz == 0U)
+    {
+      mhz = 1U;
+    }
+    printf("boot %-16s %10lu cycles +%8lu us\r\n", BOOTTRACE_Marks[i].pName,
+           (unsigned long)BOOTTRACE_Marks[i].Cycles,
+           (unsigned long)((BOOTTRACE_Marks[i].Cycles - previous) / mhz));
+    previous = BOOTTRACE_Marks[i].Cycles;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
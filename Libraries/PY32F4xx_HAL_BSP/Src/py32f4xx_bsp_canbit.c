@@ -0,0 +1,433 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canbit.c
+  * @author  MCU Application Team
+  * @brief   CANFD bit timing BSP service.
+  *          This file provides functions to set the CANFD bit timings from
+  *          bitrates:
+  *           + Prescaler, segments and SJW from the kernel clock
+  *           + Secondary sample point of the transmitter delay compensation
+  *           + Data phase switch of a started CANFD, no HAL_CANFD_Init()
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) BSP_CANBIT_Calc() computes the bit timings of a nominal and a data
+       bitrate from the CANFD kernel clock frequency, the sample points in
+       per mille, 0 for BSP_CANBIT_SP_NOMINAL and BSP_CANBIT_SP_DATA. Both
+       phases share the prescaler: the lowest one giving the two bitrates
+       within BSP_CANBIT_TOLERANCE_PPM and the sample points closest to the
+       ones asked is kept. A DataBitrate of 0 sets the data phase as the
+       nominal one, for classic frames. The SJW is the whole segment 2.
+
+   (#) From BSP_CANBIT_TDC_BITRATE, the secondary sample point offset of
+       the transmitter delay compensation is set to the data sample point,
+       the received bit is sampled at the sample point plus the measured
+       transceiver loop delay. Below, the offset is 0.
+
+   (#) BSP_CANBIT_ToInit() copies the timings to the CANFD_InitTypeDef of
+       HAL_CANFD_Init(), the frame format and the mode left to the caller.
+
+   (#) BSP_CANBIT_CalcData() computes another data phase for the prescaler
+       of the timings, the nominal phase kept. BSP_CANBIT_SwitchData()
+       writes it to a started CANFD while no transmission is pending: the
+       CANFD enters standby, then the reset mode for the time of the write,
+       and gets back on the bus after 11 recessive bits. The filters, the
+       notifications and the HAL state are kept, the frame being received
+       is lost. Call it on a bus agreeing on the new data bitrate, between
+       two exchanges.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_canbit.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANBIT BSP CANBIT
+  * @brief CANFD bit timing BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANBIT_Private_Constants BSP CANBIT Private Constants
+  * @{
+  */
+#define CANBIT_PRESC_MAX                32U            /*!< RLSSP PRESC + 1                           */
+#define CANBIT_NOMINAL_SEG1_MAX         513U           /*!< ACBTR AC_SEG_1 + 2                        */
+#define CANBIT_DATA_SEG1_MAX            257U           /*!< FDBTR FD_SEG_1 + 2                        */
+#define CANBIT_SEG2_MAX                 128U           /*!< AC_SEG_2 and FD_SEG_2 + 1                 */
+#define CANBIT_SSPOFF_MAX               255U           /*!< RLSSP FD_SSPOFF                           */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANBIT_Private_Functions BSP CANBIT Private Functions
+  * @{
+  */
+static uint32_t CANBIT_Phase(uint32_t ClockFreq, uint32_t Prescaler, uint32_t Bitrate, uint32_t SamplePoint,
+                             uint32_t Seg1Max, uint32_t *pSeg1, uint32_t *pSeg2, uint32_t *pScore);
+static void CANBIT_SetData(BSP_CANBIT_TimingTypeDef *pTiming, uint32_t ClockFreq, uint32_t Seg1, uint32_t Seg2);
+static HAL_StatusTypeDef CANBIT_WaitReset(CANFD_HandleTypeDef *hcanfd, uint32_t Reset);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANBIT_Exported_Functions BSP CANBIT Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Compute the bit timings of a nominal and a data bitrate.
+  * @param  ClockFreq CANFD kernel clock frequency, Hz.
+  * @param  NominalBitrate Nominal bitrate, bit/s.
+  * @param  NominalSamplePoint Nominal sample point, per mille, 0 for BSP_CANBIT_SP_NOMINAL.
+  * @param  DataBitrate Data bitrate, bit/s, 0 for the nominal bitrate.
+  * @param  DataSamplePoint Data sample point, per mille, 0 for BSP_CANBIT_SP_DATA.
+  * @param  pTiming Timings.
+  * @retval HAL status, HAL_ERROR if no prescaler fits
+  */
+HAL_StatusTypeDef BSP_CANBIT_Calc(uint32_t ClockFreq, uint32_t NominalBitrate, uint32_t NominalSamplePoint,
+                                  uint32_t DataBitrate, uint32_t DataSamplePoint, BSP_CANBIT_TimingTypeDef *pTiming)
+{
+  uint32_t presc;
+  uint32_t nseg1;
+  uint32_t nseg2;
+  uint32_t nscore;
+  uint32_t dseg1;
+  uint32_t dseg2;
+  uint32_t dscore;
+  uint32_t best = 0xFFFFFFFFU;
+
+  if ((pTiming == NULL) || (ClockFreq == 0U) || (NominalBitrate == 0U) ||
+      (NominalSamplePoint >= 1000U) || (DataSamplePoint >= 1000U) ||
+      ((DataBitrate != 0U) && (DataBitrate < NominalBitrate)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (NominalSamplePoint == 0U)
+  {
+    NominalSamplePoint = BSP_CANBIT_SP_NOMINAL;
+  }
+  if (DataSamplePoint == 0U)
+  {
+    DataSamplePoint = BSP_CANBIT_SP_DATA;
+  }
+
+  for (presc = 1U; presc <= CANBIT_PRESC_MAX; presc++)
+  {
+    if (CANBIT_Phase(ClockFreq, presc, NominalBitrate, NominalSamplePoint, CANBIT_NOMINAL_SEG1_MAX,
+                     &nseg1, &nseg2, &nscore) == 0U)
+    {
+      continue;
+    }
+    if (DataBitrate == 0U)
+    {
+      dseg1  = nseg1;
+      dseg2  = nseg2;
+      dscore = 0U;
+      if (dseg1 > CANBIT_DATA_SEG1_MAX)
+      {
+        continue;
+      }
+    }
+    else if (CANBIT_Phase(ClockFreq, presc, DataBitrate, DataSamplePoint, CANBIT_DATA_SEG1_MAX,
+                          &dseg1, &dseg2, &dscore) == 0U)
+    {
+      continue;
+    }
+
+    /* Lowest prescaler on a tie, the finest time quanta */
+    if ((nscore + dscore) < best)
+    {
+      best = nscore + dscore;
+      pTiming->Prescaler          = presc;
+      pTiming->NominalSeg1        = nseg1;
+      pTiming->NominalSeg2        = nseg2;
+      pTiming->NominalSjw         = nseg2;
+      pTiming->NominalBitrate     = ClockFreq / (presc * (1U + nseg1 + nseg2));
+      pTiming->NominalSamplePoint = ((1U + nseg1) * 1000U) / (1U + nseg1 + nseg2);
+      CANBIT_SetData(pTiming, ClockFreq, dseg1, dseg2);
+    }
+  }
+
+  return (best == 0xFFFFFFFFU) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+  * @brief  Compute another data phase at the prescaler of the timings.
+  * @note   The nominal phase is kept, pTiming is unchanged on an error.
+  * @param  ClockFreq CANFD kernel clock frequency, Hz.
+  * @param  DataBitrate Data bitrate, bit/s.
+  * @param  DataSamplePoint Data sample point, per mille, 0 for BSP_CANBIT_SP_DATA.
+  * @param  pTiming Timings, set by BSP_CANBIT_Calc().
+  * @retval HAL status, HAL_ERROR if the prescaler does not fit
+  */
+HAL_StatusTypeDef BSP_CANBIT_CalcData(uint32_t ClockFreq, uint32_t DataBitrate, uint32_t DataSamplePoint,
+                                      BSP_CANBIT_TimingTypeDef *pTiming)
+{
+  uint32_t seg1;
+  uint32_t seg2;
+  uint32_t score;
+
+  if ((pTiming == NULL) || (ClockFreq == 0U) || (pTiming->Prescaler == 0U) ||
+      (pTiming->Prescaler > CANBIT_PRESC_MAX) || (DataSamplePoint >= 1000U) ||
+      (DataBitrate < pTiming->NominalBitrate))
+  {
+    return HAL_ERROR;
+  }
+
+  if (DataSamplePoint == 0U)
+  {
+    DataSamplePoint = BSP_CANBIT_SP_DATA;
+  }
+
+  if (CANBIT_Phase(ClockFreq, pTiming->Prescaler, DataBitrate, DataSamplePoint, CANBIT_DATA_SEG1_MAX,
+                   &seg1, &seg2, &score) == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  CANBIT_SetData(pTiming, ClockFreq, seg1, seg2);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy the timings to a CANFD init structure.
+  * @param  pTiming Timings.
+  * @param  pInit Init structure of HAL_CANFD_Init(), the timing fields set.
+  * @retval None
+  */
+void BSP_CANBIT_ToInit(const BSP_CANBIT_TimingTypeDef *pTiming, CANFD_InitTypeDef *pInit)
+{
+  pInit->Prescaler               = pTiming->Prescaler;
+  pInit->NominalSyncJumpWidth    = pTiming->NominalSjw;
+  pInit->NominalTimeSeg1         = pTiming->NominalSeg1;
+  pInit->NominalTimeSeg2         = pTiming->NominalSeg2;
+  pInit->DataSyncJumpWidth       = pTiming->DataSjw;
+  pInit->DataTimeSeg1            = pTiming->DataSeg1;
+  pInit->DataTimeSeg2            = pTiming->DataSeg2;
+  pInit->SecondSamplePointOffset = pTiming->SspOffset;
+}
+
+/**
+  * @brief  Write the data phase of the timings to a started CANFD.
+  * @note   The CANFD goes through standby and the reset mode, its HAL state kept.
+  * @param  hcanfd CANFD handle, started.
+  * @param  pTiming Timings, of the prescaler of the CANFD.
+  * @retval HAL status, HAL_BUSY if not started or a transmission is pending
+  */
+HAL_StatusTypeDef BSP_CANBIT_SwitchData(CANFD_HandleTypeDef *hcanfd, const BSP_CANBIT_TimingTypeDef *pTiming)
+{
+  if ((hcanfd == NULL) || (pTiming == NULL) || (pTiming->DataSeg1 < 2U) ||
+      (pTiming->DataSeg1 > CANBIT_DATA_SEG1_MAX) || (pTiming->DataSeg2 == 0U) ||
+      (pTiming->DataSeg2 > CANBIT_SEG2_MAX) || (pTiming->DataSjw == 0U) ||
+      (pTiming->DataSjw > CANBIT_SEG2_MAX) || (pTiming->SspOffset > CANBIT_SSPOFF_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if (pTiming->Prescaler != (((hcanfd->Instance->RLSSP & CANFD_RLSSP_PRESC) >> CANFD_RLSSP_PRESC_Pos) + 1U))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hcanfd->State != HAL_CANFD_STATE_BUSY) ||
+      ((hcanfd->Instance->MCR & (CANFD_MCR_TPE | CANFD_MCR_TSONE | CANFD_MCR_TSALL)) != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_CANFD_EnterStandbyMode(hcanfd) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  SET_BIT(hcanfd->Instance->MCR, CANFD_MCR_RESET);
+  if (CANBIT_WaitReset(hcanfd, CANFD_MCR_RESET) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hcanfd->Instance->FDBTR = (((pTiming->DataSjw - 1U) << CANFD_FDBTR_FD_SJW_Pos) + \
+                             ((pTiming->DataSeg1 - 2U) << CANFD_FDBTR_FD_SEG_1_Pos) + \
+                             ((pTiming->DataSeg2 - 1U) << CANFD_FDBTR_FD_SEG_2_Pos));
+  MODIFY_REG(hcanfd->Instance->RLSSP, CANFD_RLSSP_FD_SSPOFF, (pTiming->SspOffset << CANFD_RLSSP_FD_SSPOFF_Pos));
+
+  CLEAR_BIT(hcanfd->Instance->MCR, CANFD_MCR_RESET);
+  if (CANBIT_WaitReset(hcanfd, 0U) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_CANFD_ExitStandbyMode(hcanfd);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANBIT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Compute the segments of one phase at a prescaler.
+  * @param  ClockFreq CANFD kernel clock frequency, Hz.
+  * @param  Prescaler Kernel clock divider.
+  * @param  Bitrate Bitrate, bit/s.
+  * @param  SamplePoint Sample point, per mille.
+  * @param  Seg1Max Largest segment 1 of the phase.
+  * @param  pSeg1 Segment 1.
+  * @param  pSeg2 Segment 2.
+  * @param  pScore Bitrate error in ppm plus the sample point error in ppm.
+  * @retval 1 if the phase fits, 0 otherwise
+  */
+static uint32_t CANBIT_Phase(uint32_t ClockFreq, uint32_t Prescaler, uint32_t Bitrate, uint32_t SamplePoint,
+                             uint32_t Seg1Max, uint32_t *pSeg1, uint32_t *pSeg2, uint32_t *pScore)
+{
+  uint64_t unit = (uint64_t)Bitrate * Prescaler;
+  uint64_t total = ((uint64_t)ClockFreq + (unit / 2U)) / unit;
+  uint64_t diff;
+  uint32_t error;
+  uint32_t tq;
+  uint32_t seg1;
+  uint32_t seg2;
+  uint32_t sp;
+
+  /* Sync segment, segment 1 of 2 at least, segment 2 of 1 at least */
+  if ((total < 4U) || (total > (1U + Seg1Max + CANBIT_SEG2_MAX)))
+  {
+    return 0U;
+  }
+  tq = (uint32_t)total;
+
+  diff = ((uint64_t)ClockFreq > (total * unit)) ? ((uint64_t)ClockFreq - (total * unit))
+                                                : ((total * unit) - (uint64_t)ClockFreq);
+  error = (uint32_t)((diff * 1000000U) / (total * unit));
+  if (error > BSP_CANBIT_TOLERANCE_PPM)
+  {
+    return 0U;
+  }
+
+  seg2 = tq - (((tq * SamplePoint) + 500U) / 1000U);
+  if (seg2 == 0U)
+  {
+    seg2 = 1U;
+  }
+  if (seg2 > CANBIT_SEG2_MAX)
+  {
+    seg2 = CANBIT_SEG2_MAX;
+  }
+  seg1 = tq - 1U - seg2;
+  if (seg1 < 2U)
+  {
+    seg1 = 2U;
+    seg2 = tq - 3U;
+  }
+  if (seg1 > Seg1Max)
+  {
+    seg1 = Seg1Max;
+    seg2 = tq - 1U - Seg1Max;
+  }
+
+  sp = ((1U + seg1) * 1000U) / tq;
+  *pSeg1  = seg1;
+  *pSeg2  = seg2;
+  *pScore = error + (1000U * ((sp > SamplePoint) ? (sp - SamplePoint) : (SamplePoint - sp)));
+
+  return 1U;
+}
+
+/**
+  * @brief  Set the data phase fields of the timings.
+  * @param  pTiming Timings, of a set prescaler.
+  * @param  ClockFreq CANFD kernel clock frequency, Hz.
+  * @param  Seg1 Data segment 1.
+  * @param  Seg2 Data segment 2.
+  * @retval None
+  */
+static void CANBIT_SetData(BSP_CANBIT_TimingTypeDef *pTiming, uint32_t ClockFreq, uint32_t Seg1, uint32_t Seg2)
+{
+  pTiming->DataSeg1        = Seg1;
+  pTiming->DataSeg2        = Seg2;
+  pTiming->DataSjw         = Seg2;
+  pTiming->DataBitrate     = ClockFreq / (pTiming->Prescaler * (1U + Seg1 + Seg2));
+  pTiming->DataSamplePoint = ((1U + Seg1) * 1000U) / (1U + Seg1 + Seg2);
+
+  /* Secondary sample point at the sample point, after the transceiver loop delay */
+  if (pTiming->DataBitrate >= BSP_CANBIT_TDC_BITRATE)
+  {
+    pTiming->SspOffset = ((1U + Seg1) > CANBIT_SSPOFF_MAX) ? CANBIT_SSPOFF_MAX : (1U + Seg1);
+  }
+  else
+  {
+    pTiming->SspOffset = 0U;
+  }
+}
+
+/**
+  * @brief  Wait for the reset mode bit.
+  * @param  hcanfd CANFD handle.
+  * @param  Reset CANFD_MCR_RESET to wait for the reset mode, 0 for its exit.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CANBIT_WaitReset(CANFD_HandleTypeDef *hcanfd, uint32_t Reset)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while ((hcanfd->Instance->MCR & CANFD_MCR_RESET) != Reset)
+  {
+    if ((HAL_GetTick() - tickstart) > BSP_CANBIT_TIMEOUT)
+    {
+      hcanfd->ErrorCode |= HAL_CANFD_ERROR_TIMEOUT;
+      hcanfd->State = HAL_CANFD_STATE_ERROR;
+
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,263 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_candb.c
+  * @author  MCU Application Team
+  * @brief   CAN signal database BSP service.
+  *          This file provides functions to decode the frames of a CAN
+  *          database:
+  *           + Signal accessors folding into a few instructions per signal
+  *           + Message decoders generated from a DBC file
+  *           + Hash table dispatch of the frames to their decoder
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A generic decoder walks the signal list of a message for each frame:
+       bit offsets and lengths read from tables, loops over the bits. Here
+       each message has its own unpack and pack functions, one call of
+       BSP_CANDB_GetLE(), BSP_CANDB_GetBE() or their Set counterparts per
+       signal with constant arguments: inlined, a signal costs the loads
+       of its bytes, a shift and a mask.
+
+   (#) Misc/Tools/dbc2c.py writes these functions from a DBC file:
+         python Misc/Tools/dbc2c.py body.dbc --prefix BODY --out User
+       gives body.h and body.c: per message a structure of the raw signal
+       values, the FACTOR and OFFSET macros of the physical values, the
+       inline BODY_<Message>_Unpack() and BODY_<Message>_Pack(), a weak
+       BODY_<Message>_RxCallback(), and the BODY_Messages table of the
+       dispatcher.
+
+   (#) Call BSP_CANDB_Init() with the table, BODY_MESSAGES messages, and a
+       hash table of HashSize words, a power of 2 more than the messages:
+       twice their number keeps the lookups to one or two probes. The
+       identifiers must be unique.
+
+   (#) In the BSP_CANRX consumer loop, call BSP_CANDB_Dispatch() for each
+       frame peeked: the handler of its identifier unpacks it and calls the
+       RxCallback of the message, then the frame is released by the caller.
+       It returns 0 for a frame of no message, or shorter than its message,
+       to be handled by other layers.
+
+   (#) BSP_CANDB_GetStats() gives the frames dispatched, unknown and short,
+       and the longest probe of the hash table.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_candb.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANDB BSP CANDB
+  * @brief CAN signal database BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Private_Constants BSP CANDB Private Constants
+  * @{
+  */
+#define CANDB_EXTENDED                  0x80000000U    /*!< Key bit of the extended identifiers       */
+#define CANDB_HASH_MULT                 0x9E3779B1U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Private_Macros BSP CANDB Private Macros
+  * @{
+  */
+#define CANDB_KEY(__ID__, __IDTYPE__)   ((__ID__) | (((__IDTYPE__) == CANFD_EXTENDED_ID) ? CANDB_EXTENDED : 0U))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANDB_Private_Functions BSP CANDB Private Functions
+  * @{
+  */
+static uint32_t CANDB_Hash(const BSP_CANDB_TypeDef *hdb, uint32_t Key);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANDB_Exported_Functions BSP CANDB Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a dispatcher, the messages hashed by identifier.
+  * @param  hdb Pointer to a BSP_CANDB_TypeDef structure.
+  * @param  pMessages Messages, kept by the dispatcher.
+  * @param  NbrOfMessages Messages.
+  * @param  pHash Hash table, kept by the dispatcher.
+  * @param  HashSize Words of the hash table, a power of 2, more than the messages.
+  * @retval HAL status, HAL_ERROR on an identifier given twice
+  */
+HAL_StatusTypeDef BSP_CANDB_Init(BSP_CANDB_TypeDef *hdb, const BSP_CANDB_MessageTypeDef *pMessages,
+                                 uint32_t NbrOfMessages, uint32_t *pHash, uint32_t HashSize)
+{
+  const BSP_CANDB_MessageTypeDef *msg;
+  uint32_t size;
+  uint32_t slot;
+  uint32_t key;
+  uint32_t i;
+
+  if ((hdb == NULL) || (pMessages == NULL) || (NbrOfMessages == 0U) || (pHash == NULL) ||
+      (HashSize <= NbrOfMessages) || ((HashSize & (HashSize - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hdb->pMessages     = pMessages;
+  hdb->NbrOfMessages = NbrOfMessages;
+  hdb->pHash         = pHash;
+  hdb->HashShift     = 32U;
+  for (size = HashSize; size > 1U; size >>= 1)
+  {
+    hdb->HashShift--;
+  }
+
+  for (i = 0U; i < HashSize; i++)
+  {
+    pHash[i] = BSP_CANDB_HASH_EMPTY;
+  }
+
+  for (i = 0U; i < NbrOfMessages; i++)
+  {
+    msg = &pMessages[i];
+    if ((msg->Handler == NULL) || (msg->Length > 64U))
+    {
+      return HAL_ERROR;
+    }
+    key = CANDB_KEY(msg->Id, msg->IdType);
+    slot = CANDB_Hash(hdb, key);
+    while (pHash[slot] != BSP_CANDB_HASH_EMPTY)
+    {
+      if (CANDB_KEY(pMessages[pHash[slot]].Id, pMessages[pHash[slot]].IdType) == key)
+      {
+        return HAL_ERROR;
+      }
+      slot = (slot + 1U) & (HashSize - 1U);
+    }
+    pHash[slot] = i;
+  }
+
+  hdb->Stats.Dispatched = 0U;
+  hdb->Stats.Unknown    = 0U;
+  hdb->Stats.Short      = 0U;
+  hdb->Stats.MaxProbes  = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give a frame to the handler of its message.
+  * @param  hdb Pointer to a BSP_CANDB_TypeDef structure.
+  * @param  pFrame Frame, peeked from the BSP_CANRX queue.
+  * @retval 1 if the frame was decoded, 0 otherwise
+  */
+uint32_t BSP_CANDB_Dispatch(BSP_CANDB_TypeDef *hdb, const BSP_CANRX_FrameTypeDef *pFrame)
+{
+  const BSP_CANDB_MessageTypeDef *msg;
+  uint32_t key;
+  uint32_t slot;
+  uint32_t probes = 0U;
+
+  key = BSP_CANRX_GET_ID(pFrame) | (BSP_CANRX_IS_EXTENDED(pFrame) ? CANDB_EXTENDED : 0U);
+  slot = CANDB_Hash(hdb, key);
+
+  while (hdb->pHash[slot] != BSP_CANDB_HASH_EMPTY)
+  {
+    probes++;
+    msg = &hdb->pMessages[hdb->pHash[slot]];
+    if (CANDB_KEY(msg->Id, msg->IdType) == key)
+    {
+      if (probes > hdb->Stats.MaxProbes)
+      {
+        hdb->Stats.MaxProbes = probes;
+      }
+      if (BSP_CANRX_GET_LENGTH(pFrame) < msg->Length)
+      {
+        hdb->Stats.Short++;
+        return 0U;
+      }
+      msg->Handler(pFrame);
+      hdb->Stats.Dispatched++;
+      return 1U;
+    }
+    slot = (slot + 1U) & (0xFFFFFFFFU >> hdb->HashShift);
+  }
+
+  hdb->Stats.Unknown++;
+
+  return 0U;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hdb Pointer to a BSP_CANDB_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CANDB_GetStats(const BSP_CANDB_TypeDef *hdb, BSP_CANDB_StatsTypeDef *pStats)
+{
+  *pStats = hdb->Stats;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANDB_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Home slot of a key.
+  * @param  hdb Pointer to a BSP_CANDB_TypeDef structure.
+  * @param  Key Identifier, bit 31 set for an extended one.
+  * @retval Slot
+  */
+static uint32_t CANDB_Hash(const BSP_CANDB_TypeDef *hdb, uint32_t Key)
+{
+  return (Key * CANDB_HASH_MULT) >> hdb->HashShift;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,534 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canfilt.c
+  * @author  MCU Application Team
+  * @brief   CANFD acceptance filter planner BSP service.
+  *          This file provides functions to subscribe the CANFD to more
+  *          identifiers than it has acceptance filters:
+  *           + Identifiers and ranges compiled into code/mask filters
+  *           + Fewest unwanted identifiers passed by the filters
+  *           + Hash table lookup of the frames passed by the filters
+  *           + Hardware rejection ratio and software residue statistics
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_CANFD_ConfigFilter() programs one of the 12 acceptance filters,
+       an identifier code and a mask of the bits ignored. Subscribed to more
+       identifiers than filters, the application accepts all the frames and
+       compares each of them in software: the CPU load follows the load of
+       the bus, not the traffic of interest. This service plans the filters
+       for a list of identifiers, the frames they pass still checked by
+       BSP_CANFILT_Match().
+
+   (#) Describe the subscriptions with an array of BSP_CANFILT_EntryTypeDef,
+       single identifiers (First equal to Last) or ranges, standard or
+       extended. The entries should not overlap.
+
+   (#) Initialize the CANFD with HAL_CANFD_Init(), then call
+       BSP_CANFILT_Init() before HAL_CANFD_Start(), with NbrOfFilters the
+       acceptance filters to use, from channel 0, and a hash table of
+       HashSize words, a power of 2, for the single identifiers: twice
+       their number keeps the lookups short. The table and the entries are
+       used by BSP_CANFILT_Match() and must be kept.
+
+   (#) The planner splits each range into aligned blocks, each one a code
+       and a mask, then merges the two blocks of the same identifier type
+       adding the fewest unwanted identifiers, until the blocks fit the
+       filters. A block inside a merged one is removed. Up to
+       BSP_CANFILT_BLOCKS blocks are kept while planning: more are merged
+       on the way. Planning takes the square of the blocks on each merge,
+       it is done once at the initialization.
+
+   (#) On reception call BSP_CANFILT_Match() with the identifier of the
+       frame: 1 when subscribed, else 0. With filters passing no unwanted
+       identifier it returns 1 at once, else the single identifiers are
+       looked up in the hash table and the ranges compared in turn: keep
+       the ranges few.
+
+   (#) BSP_CANFILT_GetStats() gives the filters used, the identifiers
+       wanted and passed, the per-mille of the unwanted identifiers
+       rejected by the filters, in the worst identifier space subscribed, and
+       the frames matched or rejected as residue by BSP_CANFILT_Match().
+       Accepted counts the overlap of the filters twice, it is an upper
+       bound. The plan counts identifiers, not frames: a busy identifier
+       passed by the filters costs more than Rejection shows, Residue
+       gives the real count.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_canfilt.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANFILT BSP CANFILT
+  * @brief CANFD acceptance filter planner BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Private_Types BSP CANFILT Private Types
+  * @{
+  */
+typedef struct
+{
+  uint32_t Code;                        /*!< Identifier bits compared                               */
+  uint32_t Mask;                        /*!< Identifier bits ignored, CANFILT_EXTENDED for the type */
+  uint32_t Wanted;                      /*!< Subscribed identifiers inside the block                */
+} CANFILT_BlockTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Private_Constants BSP CANFILT Private Constants
+  * @{
+  */
+#define CANFILT_EXTENDED                0x80000000U    /* Block type bit of the mask and the hash keys */
+#define CANFILT_STANDARD_MAX            0x7FFU
+#define CANFILT_EXTENDED_MAX            0x1FFFFFFFU
+#define CANFILT_FORMAT_MASK             0x1F1607FFU    /* All the format bits ignored but IDE */
+#define CANFILT_HASH_MULT               0x9E3779B1U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Private_Variables BSP CANFILT Private Variables
+  * @{
+  */
+static CANFILT_BlockTypeDef CANFILT_Blocks[BSP_CANFILT_BLOCKS];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANFILT_Private_Functions BSP CANFILT Private Functions
+  * @{
+  */
+static uint32_t CANFILT_Size(uint32_t Mask);
+static uint32_t CANFILT_Merge(uint32_t NbrOfBlocks);
+static uint32_t CANFILT_Hash(const BSP_CANFILT_TypeDef *hfilt, uint32_t Key);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANFILT_Exported_Functions BSP CANFILT Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Plan and program the acceptance filters for a list of identifiers.
+  * @note   Call it with the CANFD initialized, not started. The entries and
+  *         the hash table are kept by the handle.
+  * @param  hfilt Pointer to a BSP_CANFILT_TypeDef structure.
+  * @param  hcanfd CANFD handle.
+  * @param  pEntries Subscribed identifiers.
+  * @param  NbrOfEntries Entries.
+  * @param  pHash Hash table of the single identifiers, NULL when none.
+  * @param  HashSize Words of the hash table, a power of 2, more than the
+  *         single identifiers.
+  * @param  NbrOfFilters Acceptance filters to use, 1 to BSP_CANFILT_CHANNELS.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANFILT_Init(BSP_CANFILT_TypeDef *hfilt, CANFD_HandleTypeDef *hcanfd,
+                                   const BSP_CANFILT_EntryTypeDef *pEntries, uint32_t NbrOfEntries,
+                                   uint32_t *pHash, uint32_t HashSize, uint32_t NbrOfFilters)
+{
+  CANFD_FilterTypeDef sFilter;
+  CANFILT_BlockTypeDef *block;
+  uint64_t wanted[2] = {0U, 0U};
+  uint64_t accepted[2] = {0U, 0U};
+  uint64_t space;
+  uint32_t rejection;
+  uint32_t singles = 0U;
+  uint32_t blocks = 0U;
+  uint32_t type;
+  uint32_t first;
+  uint32_t size;
+  uint32_t slot;
+  uint32_t key;
+  uint32_t i;
+
+  if ((hfilt == NULL) || (hcanfd == NULL) || (pEntries == NULL) || (NbrOfEntries == 0U) ||
+      (NbrOfFilters == 0U) || (NbrOfFilters > BSP_CANFILT_CHANNELS))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < NbrOfEntries; i++)
+  {
+    if (((pEntries[i].IdType != CANFD_STANDARD_ID) && (pEntries[i].IdType != CANFD_EXTENDED_ID)) ||
+        (pEntries[i].First > pEntries[i].Last) ||
+        (pEntries[i].Last > ((pEntries[i].IdType == CANFD_EXTENDED_ID) ? CANFILT_EXTENDED_MAX : CANFILT_STANDARD_MAX)))
+    {
+      return HAL_ERROR;
+    }
+    if (pEntries[i].First == pEntries[i].Last)
+    {
+      singles++;
+    }
+    wanted[(pEntries[i].IdType == CANFD_EXTENDED_ID) ? 1U : 0U] += (uint64_t)pEntries[i].Last - pEntries[i].First + 1U;
+  }
+
+  if ((singles != 0U) &&
+      ((pHash == NULL) || (HashSize <= singles) || ((HashSize & (HashSize - 1U)) != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hcanfd->State != HAL_CANFD_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Ranges into aligned blocks, merged on the way when too many */
+  for (i = 0U; i < NbrOfEntries; i++)
+  {
+    type = (pEntries[i].IdType == CANFD_EXTENDED_ID) ? CANFILT_EXTENDED : 0U;
+    first = pEntries[i].First;
+    for (;;)
+    {
+      size = 1U;
+      while (((first & ((size << 1) - 1U)) == 0U) && (((size << 1) - 1U) <= (pEntries[i].Last - first)))
+      {
+        size <<= 1;
+      }
+
+      while (blocks >= BSP_CANFILT_BLOCKS)
+      {
+        blocks = CANFILT_Merge(blocks);
+      }
+      CANFILT_Blocks[blocks].Code   = first;
+      CANFILT_Blocks[blocks].Mask   = type | (size - 1U);
+      CANFILT_Blocks[blocks].Wanted = size;
+      blocks++;
+
+      if ((size - 1U) == (pEntries[i].Last - first))
+      {
+        break;
+      }
+      first += size;
+    }
+  }
+
+  while (blocks > NbrOfFilters)
+  {
+    size = CANFILT_Merge(blocks);
+    if (size == blocks)
+    {
+      /* Standard and extended left, one filter each needed */
+      return HAL_ERROR;
+    }
+    blocks = size;
+  }
+
+  /* Filters programmed, the remaining channels disabled */
+  for (i = 0U; i < BSP_CANFILT_CHANNELS; i++)
+  {
+    sFilter.FilterChannel = i;
+    if (i < blocks)
+    {
+      block = &CANFILT_Blocks[i];
+      hfilt->Filters[i].IdType = ((block->Mask & CANFILT_EXTENDED) != 0U) ? CANFD_EXTENDED_ID : CANFD_STANDARD_ID;
+      hfilt->Filters[i].Code   = block->Code;
+      hfilt->Filters[i].Mask   = block->Mask & ~CANFILT_EXTENDED;
+      accepted[(hfilt->Filters[i].IdType == CANFD_EXTENDED_ID) ? 1U : 0U] += CANFILT_Size(hfilt->Filters[i].Mask);
+
+      sFilter.IdType       = hfilt->Filters[i].IdType;
+      sFilter.Rank         = CANFD_FILTER_RANK_CHANNEL_NUMBER;
+      sFilter.FilterID     = hfilt->Filters[i].Code;
+      sFilter.FilterFormat = (sFilter.IdType == CANFD_EXTENDED_ID) ? CANFD_LLC_FORMAT_IDE : 0U;
+      sFilter.MaskID       = hfilt->Filters[i].Mask;
+      sFilter.MaskFormat   = CANFILT_FORMAT_MASK;
+    }
+    else
+    {
+      sFilter.IdType       = CANFD_STANDARD_ID;
+      sFilter.Rank         = CANFD_FILTER_RANK_NONE;
+      sFilter.FilterID     = 0U;
+      sFilter.FilterFormat = 0U;
+      sFilter.MaskID       = 0U;
+      sFilter.MaskFormat   = 0U;
+    }
+    if (HAL_CANFD_ConfigFilter(hcanfd, &sFilter) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  /* Single identifiers hashed */
+  hfilt->HashShift = 32U;
+  for (size = HashSize; size > 1U; size >>= 1)
+  {
+    hfilt->HashShift--;
+  }
+  hfilt->pHash = (singles != 0U) ? pHash : NULL;
+  if (singles != 0U)
+  {
+    for (i = 0U; i < HashSize; i++)
+    {
+      pHash[i] = BSP_CANFILT_HASH_EMPTY;
+    }
+    for (i = 0U; i < NbrOfEntries; i++)
+    {
+      if (pEntries[i].First == pEntries[i].Last)
+      {
+        key = pEntries[i].First | ((pEntries[i].IdType == CANFD_EXTENDED_ID) ? CANFILT_EXTENDED : 0U);
+        slot = CANFILT_Hash(hfilt, key);
+        while ((pHash[slot] != BSP_CANFILT_HASH_EMPTY) && (pHash[slot] != key))
+        {
+          slot = (slot + 1U) & (HashSize - 1U);
+        }
+        pHash[slot] = key;
+      }
+    }
+  }
+
+  /* Rejection of the worst identifier space subscribed */
+  hfilt->Stats.Rejection = 1000U;
+  for (i = 0U; i < 2U; i++)
+  {
+    space = (i == 0U) ? (CANFILT_STANDARD_MAX + 1U) : ((uint64_t)CANFILT_EXTENDED_MAX + 1U);
+    if (accepted[i] > space)
+    {
+      accepted[i] = space;
+    }
+    if ((wanted[i] != 0U) && (wanted[i] < space) && (accepted[i] > wanted[i]))
+    {
+      rejection = (uint32_t)(((space - accepted[i]) * 1000U) / (space - wanted[i]));
+      if (rejection < hfilt->Stats.Rejection)
+      {
+        hfilt->Stats.Rejection = rejection;
+      }
+    }
+  }
+  wanted[0] += wanted[1];
+  accepted[0] += accepted[1];
+
+  hfilt->hcanfd       = hcanfd;
+  hfilt->pEntries     = pEntries;
+  hfilt->NbrOfEntries = NbrOfEntries;
+  hfilt->Exact        = (accepted[0] <= wanted[0]) ? 1U : 0U;
+  hfilt->Stats.Filters   = blocks;
+  hfilt->Stats.Wanted    = (wanted[0] > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)wanted[0];
+  hfilt->Stats.Accepted  = (accepted[0] > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)accepted[0];
+  hfilt->Stats.Matched   = 0U;
+  hfilt->Stats.Residue   = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check a received identifier against the subscriptions.
+  * @note   Call it from one context, the reception interrupt.
+  * @param  hfilt Pointer to a BSP_CANFILT_TypeDef structure.
+  * @param  IdType Identifier type, a value of @ref CANFD_id_type.
+  * @param  Id Identifier of the frame.
+  * @retval 1 when subscribed, else 0
+  */
+uint32_t BSP_CANFILT_Match(BSP_CANFILT_TypeDef *hfilt, uint32_t IdType, uint32_t Id)
+{
+  const BSP_CANFILT_EntryTypeDef *entry;
+  uint32_t key;
+  uint32_t slot;
+  uint32_t i;
+
+  if (hfilt->Exact != 0U)
+  {
+    hfilt->Stats.Matched++;
+    return 1U;
+  }
+
+  if (hfilt->pHash != NULL)
+  {
+    key = Id | ((IdType == CANFD_EXTENDED_ID) ? CANFILT_EXTENDED : 0U);
+    slot = CANFILT_Hash(hfilt, key);
+    while (hfilt->pHash[slot] != BSP_CANFILT_HASH_EMPTY)
+    {
+      if (hfilt->pHash[slot] == key)
+      {
+        hfilt->Stats.Matched++;
+        return 1U;
+      }
+      slot = (slot + 1U) & (0xFFFFFFFFU >> hfilt->HashShift);
+    }
+  }
+
+  for (i = 0U; i < hfilt->NbrOfEntries; i++)
+  {
+    entry = &hfilt->pEntries[i];
+    if ((entry->First != entry->Last) && (entry->IdType == IdType) &&
+        (Id >= entry->First) && (Id <= entry->Last))
+    {
+      hfilt->Stats.Matched++;
+      return 1U;
+    }
+  }
+
+  hfilt->Stats.Residue++;
+  return 0U;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hfilt Pointer to a BSP_CANFILT_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CANFILT_GetStats(const BSP_CANFILT_TypeDef *hfilt, BSP_CANFILT_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hfilt->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANFILT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Identifiers passed by a mask.
+  * @param  Mask Identifier bits ignored.
+  * @retval Identifiers
+  */
+static uint32_t CANFILT_Size(uint32_t Mask)
+{
+  uint32_t size = 1U;
+
+  while (Mask != 0U)
+  {
+    if ((Mask & 1U) != 0U)
+    {
+      size <<= 1;
+    }
+    Mask >>= 1;
+  }
+
+  return size;
+}
+
+/**
+  * @brief  Merge the two blocks adding the fewest unwanted identifiers.
+  * @param  NbrOfBlocks Blocks.
+  * @retval Blocks left, NbrOfBlocks when no two blocks of a type
+  */
+static uint32_t CANFILT_Merge(uint32_t NbrOfBlocks)
+{
+  CANFILT_BlockTypeDef *blocks = CANFILT_Blocks;
+  int64_t best_cost = INT64_MAX;
+  int64_t cost;
+  uint32_t best_i = 0U;
+  uint32_t best_j = 0U;
+  uint32_t mask;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0U; i < NbrOfBlocks; i++)
+  {
+    for (j = i + 1U; j < NbrOfBlocks; j++)
+    {
+      if (((blocks[i].Mask ^ blocks[j].Mask) & CANFILT_EXTENDED) != 0U)
+      {
+        continue;
+      }
+      mask = (blocks[i].Mask | blocks[j].Mask | (blocks[i].Code ^ blocks[j].Code)) & ~CANFILT_EXTENDED;
+      cost = (int64_t)CANFILT_Size(mask) - blocks[i].Wanted - blocks[j].Wanted;
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        best_i = i;
+        best_j = j;
+      }
+    }
+  }
+
+  if (best_cost == INT64_MAX)
+  {
+    return NbrOfBlocks;
+  }
+
+  blocks[best_i].Mask  |= blocks[best_j].Mask | (blocks[best_i].Code ^ blocks[best_j].Code);
+  blocks[best_i].Code  &= ~blocks[best_i].Mask;
+  blocks[best_i].Wanted += blocks[best_j].Wanted;
+  blocks[best_j] = blocks[--NbrOfBlocks];
+
+  /* Blocks inside the merged one removed */
+  mask = blocks[best_i].Mask;
+  for (j = 0U; j < NbrOfBlocks; )
+  {
+    if ((j != best_i) && (((blocks[j].Mask ^ mask) & CANFILT_EXTENDED) == 0U) &&
+        ((blocks[j].Mask & ~mask) == 0U) &&
+        (((blocks[j].Code ^ blocks[best_i].Code) & ~mask) == 0U))
+    {
+      blocks[best_i].Wanted += blocks[j].Wanted;
+      blocks[j] = blocks[--NbrOfBlocks];
+      if (best_i == NbrOfBlocks)
+      {
+        best_i = j;
+      }
+    }
+    else
+    {
+      j++;
+    }
+  }
+
+  return NbrOfBlocks;
+}
+
+/**
+  * @brief  Hash table slot of a key.
+  * @param  hfilt Pointer to a BSP_CANFILT_TypeDef structure.
+  * @param  Key Identifier, CANFILT_EXTENDED for the type.
+  * @retval Slot
+  */
+static uint32_t CANFILT_Hash(const BSP_CANFILT_TypeDef *hfilt, uint32_t Key)
+{
+  return (Key * CANFILT_HASH_MULT) >> hfilt->HashShift;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
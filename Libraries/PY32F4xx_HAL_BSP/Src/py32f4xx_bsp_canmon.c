@@ -0,0 +1,537 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canmon.c
+  * @author  MCU Application Team
+  * @brief   CANFD bus load monitor BSP service.
+  *          This file provides functions to measure the traffic of a CANFD
+  *          bus over periods:
+  *           + Frames per second, per identifier class
+  *           + Bus load from the bit length of the frames seen
+  *           + Arbitration lost rate and bus errors
+  *           + Error counters, their trend and their peaks
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Declare the identifier classes to follow, an array of
+       BSP_CANMON_ClassTypeDef with IdType, First and Last set, and call
+       BSP_CANMON_Init() with the bitrates of the bus and the aggregation
+       period in ms. A frame is counted in the first class of its
+       identifier, and in the totals in any case.
+
+   (#) Start the CANFD, then call BSP_CANMON_Start(): the arbitration
+       lost, bus error and error state interrupts are enabled. Call
+       BSP_CANMON_ArbLostHandler() from HAL_CANFD_ArbitrationLostCallback(),
+       BSP_CANMON_BusErrorHandler() from HAL_CANFD_BusErrorCallback() and
+       BSP_CANMON_ErrorChangeHandler() from HAL_CANFD_ErrorChangeCallback().
+
+   (#) Feed the frames: BSP_CANMON_RxFrame() for each frame received and
+       BSP_CANMON_TxFrame() for each frame sent, with the identifier and
+       the CANFD_LLC_FORMAT_BITS word of the frame. That is BSP_CANRX_GET_ID()
+       and the Format of a BSP_CANRX frame, or IdType | FrameFormat |
+       DataLength of a HAL header. Both may be called from interrupts.
+
+   (#) Call BSP_CANMON_Process() from the main loop: once per period, it
+       turns the counts into rates, reads the error counters and returns 1.
+       BSP_CANMON_GetStats() then gives the period and the pClasses array
+       the frame rate and the load of each class.
+
+   (#) The bit length of a frame is its worst case with stuff bits, the
+       data phase of the FD frames with BRS at the data bitrate. The load
+       is then an upper bound of the bus use, the one to size a schedule
+       with. The totals count frames out of the classes.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_canmon.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANMON BSP CANMON
+  * @brief CANFD bus load monitor BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANMON_Private_Constants BSP CANMON Private Constants
+  * @{
+  */
+#define CANMON_IT                       (CANFD_IT_ARB_LOST | CANFD_IT_BUS_ERROR | CANFD_IT_ERROR_TOGGLE)
+#define CANMON_TAIL_BITS                13U            /*!< CRC delimiter, ACK, EOF and intermission  */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CANMON_Private_Variables BSP CANMON Private Variables
+  * @{
+  */
+static const uint8_t CANMON_DlcBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANMON_Private_Functions BSP CANMON Private Functions
+  * @{
+  */
+static void CANMON_Count(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format);
+static uint32_t CANMON_Load(const BSP_CANMON_TypeDef *hmon, uint32_t NominalBits, uint32_t DataBits,
+                            uint32_t Elapsed);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANMON_Exported_Functions BSP CANMON Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a CANFD monitor.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  hcanfd CANFD handle.
+  * @param  NominalBitrate Nominal bitrate, bit/s.
+  * @param  DataBitrate Data bitrate, bit/s, 0 for the nominal bitrate.
+  * @param  Period Aggregation period, ms.
+  * @param  pClasses Identifier classes, kept by the monitor, NULL for none.
+  * @param  NbrOfClasses Identifier classes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANMON_Init(BSP_CANMON_TypeDef *hmon, CANFD_HandleTypeDef *hcanfd,
+                                  uint32_t NominalBitrate, uint32_t DataBitrate, uint32_t Period,
+                                  BSP_CANMON_ClassTypeDef *pClasses, uint32_t NbrOfClasses)
+{
+  uint32_t i;
+
+  if ((hmon == NULL) || (hcanfd == NULL) || (NominalBitrate == 0U) || (Period == 0U) ||
+      ((pClasses == NULL) && (NbrOfClasses != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hmon->State == BSP_CANMON_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hmon->hcanfd         = hcanfd;
+  hmon->NominalBitrate = NominalBitrate;
+  hmon->DataBitrate    = (DataBitrate != 0U) ? DataBitrate : NominalBitrate;
+  hmon->Period         = Period;
+  hmon->pClasses       = pClasses;
+  hmon->NbrOfClasses   = NbrOfClasses;
+
+  for (i = 0U; i < NbrOfClasses; i++)
+  {
+    pClasses[i].FrameRate = 0U;
+    pClasses[i].Load      = 0U;
+  }
+
+  hmon->State = BSP_CANMON_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start counting and enable the error interrupts.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANMON_Start(BSP_CANMON_TypeDef *hmon)
+{
+  CANFD_ProtocolStatusTypeDef status;
+  uint32_t primask_bit;
+  uint32_t i;
+
+  if (hmon->State != BSP_CANMON_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_CANFD_ActivateNotification(hmon->hcanfd, CANMON_IT) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  (void)HAL_CANFD_GetProtocolStatus(hmon->hcanfd, &status);
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hmon->Tick        = HAL_GetTick();
+  hmon->RxFrames    = 0U;
+  hmon->TxFrames    = 0U;
+  hmon->NominalBits = 0U;
+  hmon->DataBits    = 0U;
+  hmon->ArbLost     = 0U;
+  hmon->BusErrors   = 0U;
+  for (i = 0U; i < hmon->NbrOfClasses; i++)
+  {
+    hmon->pClasses[i].Frames      = 0U;
+    hmon->pClasses[i].NominalBits = 0U;
+    hmon->pClasses[i].DataBits    = 0U;
+  }
+
+  hmon->Stats.Periods      = 0U;
+  hmon->Stats.RxFrames     = 0U;
+  hmon->Stats.TxFrames     = 0U;
+  hmon->Stats.FrameRate    = 0U;
+  hmon->Stats.Load         = 0U;
+  hmon->Stats.LoadMax      = 0U;
+  hmon->Stats.ArbLost      = 0U;
+  hmon->Stats.ArbLostRate  = 0U;
+  hmon->Stats.BusErrors    = 0U;
+  hmon->Stats.BusOffs      = 0U;
+  hmon->Stats.TxErrorCnt   = status.TxErrorCnt;
+  hmon->Stats.RxErrorCnt   = status.RxErrorCnt;
+  hmon->Stats.TxErrorTrend = 0;
+  hmon->Stats.RxErrorTrend = 0;
+  hmon->Stats.TxErrorMax   = status.TxErrorCnt;
+  hmon->Stats.RxErrorMax   = status.RxErrorCnt;
+  hmon->Stats.ErrorPassive = status.ErrorPassive;
+  hmon->Stats.LastErrorCode = status.LastErrorCode;
+
+  hmon->State = BSP_CANMON_STATE_RUN;
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop counting and disable the error interrupts.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANMON_Stop(BSP_CANMON_TypeDef *hmon)
+{
+  if (hmon->State != BSP_CANMON_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_CANFD_DeactivateNotification(hmon->hcanfd, CANMON_IT);
+  hmon->State = BSP_CANMON_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Count a frame received.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  Id Identifier.
+  * @param  Format Frame format, @ref CANFD_LLC_FORMAT_BITS.
+  * @retval None
+  */
+void BSP_CANMON_RxFrame(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hmon->State == BSP_CANMON_STATE_RUN)
+  {
+    hmon->RxFrames++;
+    CANMON_Count(hmon, Id, Format);
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Count a frame sent.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  Id Identifier.
+  * @param  Format Frame format, @ref CANFD_LLC_FORMAT_BITS.
+  * @retval None
+  */
+void BSP_CANMON_TxFrame(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hmon->State == BSP_CANMON_STATE_RUN)
+  {
+    hmon->TxFrames++;
+    CANMON_Count(hmon, Id, Format);
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Count an arbitration lost.
+  * @note   Call it from HAL_CANFD_ArbitrationLostCallback().
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANMON_ArbLostHandler(BSP_CANMON_TypeDef *hmon)
+{
+  hmon->ArbLost++;
+}
+
+/**
+  * @brief  Count a bus error.
+  * @note   Call it from HAL_CANFD_BusErrorCallback().
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANMON_BusErrorHandler(BSP_CANMON_TypeDef *hmon)
+{
+  hmon->BusErrors++;
+}
+
+/**
+  * @brief  Count a bus-off entry.
+  * @note   Call it from HAL_CANFD_ErrorChangeCallback().
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANMON_ErrorChangeHandler(BSP_CANMON_TypeDef *hmon)
+{
+  if (READ_BIT(hmon->hcanfd->Instance->MCR, CANFD_MCR_BUSOFF) != 0U)
+  {
+    hmon->Stats.BusOffs++;
+  }
+}
+
+/**
+  * @brief  Aggregate the period once it has elapsed.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @retval 1 if a period was aggregated, 0 otherwise
+  */
+uint32_t BSP_CANMON_Process(BSP_CANMON_TypeDef *hmon)
+{
+  CANFD_ProtocolStatusTypeDef status;
+  BSP_CANMON_ClassTypeDef *cls;
+  uint32_t primask_bit;
+  uint32_t elapsed;
+  uint32_t rx;
+  uint32_t tx;
+  uint32_t frames;
+  uint32_t nominal;
+  uint32_t data;
+  uint32_t arblost;
+  uint32_t errors;
+  uint32_t load;
+  uint32_t i;
+
+  if (hmon->State != BSP_CANMON_STATE_RUN)
+  {
+    return 0U;
+  }
+
+  elapsed = HAL_GetTick() - hmon->Tick;
+  if (elapsed < hmon->Period)
+  {
+    return 0U;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hmon->Tick += elapsed;
+  rx      = hmon->RxFrames;
+  tx      = hmon->TxFrames;
+  nominal = hmon->NominalBits;
+  data    = hmon->DataBits;
+  arblost = hmon->ArbLost;
+  errors  = hmon->BusErrors;
+  hmon->RxFrames    = 0U;
+  hmon->TxFrames    = 0U;
+  hmon->NominalBits = 0U;
+  hmon->DataBits    = 0U;
+  hmon->ArbLost     = 0U;
+  hmon->BusErrors   = 0U;
+  __set_PRIMASK(primask_bit);
+
+  /* One short critical section per class, the rates converted out of it */
+  for (i = 0U; i < hmon->NbrOfClasses; i++)
+  {
+    cls = &hmon->pClasses[i];
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    frames = cls->Frames;
+    load   = CANMON_Load(hmon, cls->NominalBits, cls->DataBits, elapsed);
+    cls->Frames      = 0U;
+    cls->NominalBits = 0U;
+    cls->DataBits    = 0U;
+    __set_PRIMASK(primask_bit);
+    cls->FrameRate = (uint32_t)(((uint64_t)frames * 1000U) / elapsed);
+    cls->Load      = load;
+  }
+
+  (void)HAL_CANFD_GetProtocolStatus(hmon->hcanfd, &status);
+  load = CANMON_Load(hmon, nominal, data, elapsed);
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hmon->Stats.Periods++;
+  hmon->Stats.RxFrames     = rx;
+  hmon->Stats.TxFrames     = tx;
+  hmon->Stats.FrameRate    = (uint32_t)(((uint64_t)(rx + tx) * 1000U) / elapsed);
+  hmon->Stats.Load         = load;
+  if (load > hmon->Stats.LoadMax)
+  {
+    hmon->Stats.LoadMax = load;
+  }
+  hmon->Stats.ArbLost      = arblost;
+  hmon->Stats.ArbLostRate  = ((arblost + tx) != 0U) ? ((arblost * 1000U) / (arblost + tx)) : 0U;
+  hmon->Stats.BusErrors    = errors;
+  hmon->Stats.TxErrorTrend = (int32_t)status.TxErrorCnt - (int32_t)hmon->Stats.TxErrorCnt;
+  hmon->Stats.RxErrorTrend = (int32_t)status.RxErrorCnt - (int32_t)hmon->Stats.RxErrorCnt;
+  hmon->Stats.TxErrorCnt   = status.TxErrorCnt;
+  hmon->Stats.RxErrorCnt   = status.RxErrorCnt;
+  if (status.TxErrorCnt > hmon->Stats.TxErrorMax)
+  {
+    hmon->Stats.TxErrorMax = status.TxErrorCnt;
+  }
+  if (status.RxErrorCnt > hmon->Stats.RxErrorMax)
+  {
+    hmon->Stats.RxErrorMax = status.RxErrorCnt;
+  }
+  hmon->Stats.ErrorPassive  = status.ErrorPassive;
+  hmon->Stats.LastErrorCode = status.LastErrorCode;
+  __set_PRIMASK(primask_bit);
+
+  return 1U;
+}
+
+/**
+  * @brief  Copy the statistics of the last period.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CANMON_GetStats(const BSP_CANMON_TypeDef *hmon, BSP_CANMON_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hmon->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANMON_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Add the worst case bit length of a frame to the period in progress.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  Id Identifier.
+  * @param  Format Frame format, @ref CANFD_LLC_FORMAT_BITS.
+  * @retval None
+  */
+static void CANMON_Count(BSP_CANMON_TypeDef *hmon, uint32_t Id, uint32_t Format)
+{
+  BSP_CANMON_ClassTypeDef *cls;
+  uint32_t idtype = Format & CANFD_LLC_FORMAT_IDE;
+  uint32_t bytes = ((Format & CANFD_LLC_FORMAT_RMF) != 0U) ? 0U : CANMON_DlcBytes[Format & CANFD_LLC_FORMAT_DLC];
+  uint32_t header;
+  uint32_t payload;
+  uint32_t crc;
+  uint32_t nominal;
+  uint32_t data = 0U;
+  uint32_t i;
+
+  if ((Format & CANFD_LLC_FORMAT_FDF) == 0U)
+  {
+    /* SOF to DLC, data and CRC stuffed, one stuff bit per 4 bits at worst */
+    header = (idtype != 0U) ? 39U : 19U;
+    nominal = header + (8U * bytes) + 15U;
+    nominal += ((nominal - 1U) / 4U) + CANMON_TAIL_BITS;
+  }
+  else
+  {
+    /* SOF to BRS stuffed, then ESI, DLC and data stuffed, then the stuff
+       count and the CRC with their fixed stuff bits */
+    header = (idtype != 0U) ? 36U : 17U;
+    payload = 5U + (8U * bytes);
+    crc = (bytes > 16U) ? 21U : 17U;
+    nominal = header + ((header - 1U) / 4U) + CANMON_TAIL_BITS;
+    data = payload + (payload / 4U) + 4U + crc + ((4U + crc + 3U) / 4U);
+    if ((Format & CANFD_LLC_FORMAT_BRS) == 0U)
+    {
+      nominal += data;
+      data = 0U;
+    }
+  }
+
+  hmon->NominalBits += nominal;
+  hmon->DataBits    += data;
+
+  for (i = 0U; i < hmon->NbrOfClasses; i++)
+  {
+    cls = &hmon->pClasses[i];
+    if ((cls->IdType == idtype) && (Id >= cls->First) && (Id <= cls->Last))
+    {
+      cls->Frames++;
+      cls->NominalBits += nominal;
+      cls->DataBits    += data;
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Bus load of bit counts over a period.
+  * @param  hmon Pointer to a BSP_CANMON_TypeDef structure.
+  * @param  NominalBits Bits at the nominal bitrate.
+  * @param  DataBits Bits at the data bitrate.
+  * @param  Elapsed Period, ms.
+  * @retval Load, per mille
+  */
+static uint32_t CANMON_Load(const BSP_CANMON_TypeDef *hmon, uint32_t NominalBits, uint32_t DataBits,
+                            uint32_t Elapsed)
+{
+  uint64_t busy;
+
+  /* Busy time in us, Elapsed in ms: us / ms is per mille */
+  busy = (((uint64_t)NominalBits * 1000000U) / hmon->NominalBitrate) +
+         (((uint64_t)DataBits * 1000000U) / hmon->DataBitrate);
+  busy /= Elapsed;
+
+  return (busy > 1000U) ? 1000U : (uint32_t)busy;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
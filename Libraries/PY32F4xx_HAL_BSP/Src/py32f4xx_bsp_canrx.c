@@ -0,0 +1,356 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_canrx.c
+  * @author  MCU Application Team
+  * @brief   CANFD receive queue BSP service.
+  *          This file provides functions to receive CANFD frames at the full
+  *          load of the bus:
+  *           + The whole receive FIFO drained on each interrupt
+  *           + Frames copied by words into a pool of the application
+  *           + Frames used in place, by pointer, then released
+  *           + Received, dropped, overflow, high watermark and burst
+  *             statistics
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_CANFD_GetRxMessage() reads one frame per call, byte by byte into
+       the header and the buffer of the caller, and HAL_CANFD_IRQHandler()
+       calls HAL_CANFD_RxCpltCallback() for each of them: with 64-byte frames
+       at 5 Mbit/s the FIFO overflows. This service reads all the frames of
+       the FIFO in one interrupt, the receive buffer words as they are, and
+       queues them in a pool.
+
+   (#) Initialize and configure the CANFD with HAL_CANFD_Init() and
+       HAL_CANFD_ConfigFilter(). Give BSP_CANRX_Init() a pool of
+       BSP_CANRX_FrameTypeDef, its size a power of 2, then call
+       HAL_CANFD_Start() and BSP_CANRX_Start(): the receive complete and
+       overflow interrupts are enabled. In the interrupt handler of the
+       CANFD call BSP_CANRX_IRQHandler() first, then HAL_CANFD_IRQHandler()
+       for the transmission and the errors: the reception flags are already
+       cleared, the HAL reception callbacks are no longer called.
+
+   (#) BSP_CANRX_IRQHandler() reads the FIFO until it is empty and calls
+       BSP_CANRX_RxCallback() once when frames were queued. With the pool
+       full, the frames are still read, to keep the FIFO from overflowing,
+       and counted as dropped.
+
+   (#) BSP_CANRX_Peek() gives the oldest frame in place, NULL when none,
+       decoded with BSP_CANRX_GET_ID(), BSP_CANRX_GET_LENGTH() and
+       BSP_CANRX_GET_DATA(). BSP_CANRX_Release() gives it back to the pool
+       once processed. One context consumes the frames, the interrupt only
+       writes the free ones: no lock is needed.
+
+   (#) BSP_CANRX_GetStats() copies the statistics: HighWatermark near the
+       pool size asks for a larger pool or a faster consumer, Overflows
+       above 0 for a higher priority of the CANFD interrupt.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_canrx.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANRX BSP CANRX
+  * @brief CANFD receive queue BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Private_Constants BSP CANRX Private Constants
+  * @{
+  */
+#define CANRX_FLAGS                     (CANFD_FLAG_RX_COMPLETE | CANFD_FLAG_RX_FIFO_ALMOST_FULL | \
+                                         CANFD_FLAG_RX_FIFO_FULL)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Private_Variables BSP CANRX Private Variables
+  * @{
+  */
+static const uint8_t CANRX_DlcBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANRX_Exported_Functions BSP CANRX Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a CANFD receive queue.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @param  hcanfd CANFD handle, initialized.
+  * @param  pPool Frames of the pool.
+  * @param  Size Frames of the pool, a power of 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANRX_Init(BSP_CANRX_TypeDef *hrx, CANFD_HandleTypeDef *hcanfd,
+                                 BSP_CANRX_FrameTypeDef *pPool, uint32_t Size)
+{
+  if ((hrx == NULL) || (hcanfd == NULL) || (pPool == NULL) || (Size == 0U) || ((Size & (Size - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hrx->State == BSP_CANRX_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hrx->hcanfd = hcanfd;
+  hrx->pPool  = pPool;
+  hrx->Size   = Size;
+  hrx->Head   = 0U;
+  hrx->Tail   = 0U;
+  hrx->Stats.Received      = 0U;
+  hrx->Stats.Dropped       = 0U;
+  hrx->Stats.Overflows     = 0U;
+  hrx->Stats.HighWatermark = 0U;
+  hrx->Stats.MaxBurst      = 0U;
+  hrx->State  = BSP_CANRX_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Enable the reception interrupts, the CANFD started.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANRX_Start(BSP_CANRX_TypeDef *hrx)
+{
+  if (hrx->State != BSP_CANRX_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_CANFD_CLEAR_FLAG(hrx->hcanfd, CANRX_FLAGS | CANFD_FLAG_RX_FIFO_OVERFLOW);
+  hrx->State = BSP_CANRX_STATE_RUN;
+  if (HAL_CANFD_ActivateNotification(hrx->hcanfd, CANFD_IT_RX_COMPLETE | CANFD_IT_RX_FIFO_OVERFLOW) != HAL_OK)
+  {
+    hrx->State = BSP_CANRX_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable the reception interrupts, the queued frames kept.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANRX_Stop(BSP_CANRX_TypeDef *hrx)
+{
+  if (hrx->State != BSP_CANRX_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_CANFD_DeactivateNotification(hrx->hcanfd, CANFD_IT_RX_COMPLETE | CANFD_IT_RX_FIFO_OVERFLOW);
+  hrx->State = BSP_CANRX_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Drain the receive FIFO into the pool.
+  * @note   Call it from the CANFD interrupt handler, before HAL_CANFD_IRQHandler().
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANRX_IRQHandler(BSP_CANRX_TypeDef *hrx)
+{
+  CANFD_TypeDef *canfd = hrx->hcanfd->Instance;
+  BSP_CANRX_FrameTypeDef *frame;
+  BSP_CANRX_FrameTypeDef discard;
+  uint32_t head = hrx->Head;
+  uint32_t burst = 0U;
+  uint32_t words;
+  uint32_t level;
+  uint32_t i;
+
+  if (hrx->State != BSP_CANRX_STATE_RUN)
+  {
+    return;
+  }
+
+  if ((canfd->IFR & CANFD_FLAG_RX_FIFO_OVERFLOW) != 0U)
+  {
+    canfd->IFR = CANFD_FLAG_RX_FIFO_OVERFLOW;
+    hrx->Stats.Overflows++;
+  }
+  /* Cleared before the reads, a frame arriving meanwhile sets RIF again */
+  canfd->IFR = canfd->IFR & CANRX_FLAGS;
+
+  while ((canfd->MCR & CANFD_MCR_RSTAT) != CANFD_RX_FIFO_EMPTY)
+  {
+    if ((head - hrx->Tail) < hrx->Size)
+    {
+      frame = &hrx->pPool[head & (hrx->Size - 1U)];
+    }
+    else
+    {
+      frame = &discard;
+    }
+
+    frame->Id     = canfd->RBUF.ID;
+    frame->Format = canfd->RBUF.FORMAT;
+    words = (CANRX_DlcBytes[frame->Format & CANFD_LLC_FORMAT_DLC] + 3U) >> 2;
+    for (i = 0U; i < words; i++)
+    {
+      frame->Data[i] = canfd->RBUF.DATA[i];
+    }
+    SET_BIT(canfd->MCR, CANFD_MCR_RREL);
+
+    if (frame == &discard)
+    {
+      hrx->Stats.Dropped++;
+    }
+    else
+    {
+      head++;
+      hrx->Head = head;
+      hrx->Stats.Received++;
+      level = head - hrx->Tail;
+      if (level > hrx->Stats.HighWatermark)
+      {
+        hrx->Stats.HighWatermark = level;
+      }
+    }
+    burst++;
+  }
+
+  if (burst > hrx->Stats.MaxBurst)
+  {
+    hrx->Stats.MaxBurst = burst;
+  }
+  if (burst != 0U)
+  {
+    BSP_CANRX_RxCallback(hrx);
+  }
+}
+
+/**
+  * @brief  Oldest frame of the pool, in place.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval Frame, NULL when the pool is empty
+  */
+const BSP_CANRX_FrameTypeDef *BSP_CANRX_Peek(const BSP_CANRX_TypeDef *hrx)
+{
+  uint32_t tail = hrx->Tail;
+
+  if (hrx->Head == tail)
+  {
+    return NULL;
+  }
+
+  return &hrx->pPool[tail & (hrx->Size - 1U)];
+}
+
+/**
+  * @brief  Give the oldest frame back to the pool.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANRX_Release(BSP_CANRX_TypeDef *hrx)
+{
+  if (hrx->Head != hrx->Tail)
+  {
+    hrx->Tail = hrx->Tail + 1U;
+  }
+}
+
+/**
+  * @brief  Frames waiting in the pool.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval Number of frames
+  */
+uint32_t BSP_CANRX_GetCount(const BSP_CANRX_TypeDef *hrx)
+{
+  return hrx->Head - hrx->Tail;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CANRX_GetStats(const BSP_CANRX_TypeDef *hrx, BSP_CANRX_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hrx->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Payload bytes of a DLC.
+  * @param  Dlc Data length code, a value of @ref CANFD_data_length_code.
+  * @retval Bytes, 0 to 64
+  */
+uint32_t BSP_CANRX_DlcToBytes(uint32_t Dlc)
+{
+  return CANRX_DlcBytes[Dlc & CANFD_LLC_FORMAT_DLC];
+}
+
+/**
+  * @brief  Frames queued callback, once per interrupt.
+  * @param  hrx Pointer to a BSP_CANRX_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_CANRX_RxCallback(BSP_CANRX_TypeDef *hrx)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hrx);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_CANRX_RxCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
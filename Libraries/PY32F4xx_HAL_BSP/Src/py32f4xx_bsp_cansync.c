@@ -0,0 +1,646 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_cansync.c
+  * @author  MCU Application Team
+  * @brief   CANFD time synchronization BSP service.
+  *          This file provides functions to share a time in ns between the
+  *          nodes of a CANFD bus:
+  *           + Two-step protocol, a SYNC frame then a FOLLOW_UP frame with
+  *             the time the master sent the SYNC
+  *           + SYNC stamped at the end of the frame, by the transmit complete
+  *             interrupt of the master and the receive interrupt of the slaves
+  *           + 64-bit local clock from the DWT cycle counter, its rate
+  *             corrected by a PI servo on the offset to the master
+  *           + Step, lock, outlier and drift statistics
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The CANFD of the PY32F403 gives no time stamp of the frames sent or
+       received: the RTS and TTS registers are not implemented and the HAL
+       leaves RxTimestamp unset. The time-triggered cycle time restarts on
+       each reference message and wraps on 16 bits. This service stamps the
+       SYNC frame with the DWT cycle counter from the CANFD interrupt, at
+       the end of the frame on all the nodes: the error is the latency of
+       that interrupt, a few hundred ns at the highest priority, which the
+       servo averages out.
+
+   (#) One node is the master, the others slaves, on the same SyncId and
+       FollowUpId, two standard identifiers of high priority. Initialize and
+       start the CANFD, then call BSP_CANSYNC_Init() and BSP_CANSYNC_Start().
+       The master owns the PTB (primary transmit buffer): on its node do not
+       use BSP_CANTX_PRIORITY_URGENT. PeriodMs is the SYNC period of the
+       master, 100 to 1000 ms. DelayNs is the constant delay from the stamp
+       of the master to the one of the slave, from the receive flag raised
+       one bit before the transmit flag and the interrupt paths: measure it
+       once by toggling a pin at the same time of the network on two nodes.
+
+   (#) Call BSP_CANSYNC_IRQHandler() first in the interrupt handler of the
+       CANFD, before BSP_CANRX_IRQHandler() and HAL_CANFD_IRQHandler(): it
+       only reads the flags and the frame at the head of the receive FIFO.
+       Give the FOLLOW_UP frames received to BSP_CANSYNC_RxFrame(), with the
+       identifier and the payload from BSP_CANRX_Peek() or
+       HAL_CANFD_GetRxMessage(). Call BSP_CANSYNC_Process() from the main
+       loop, at least every 2^32 CPU cycles: the master sends the frames
+       from it.
+
+   (#) Frames, 8 bytes classic CAN:
+       (++) SYNC: the sequence, one byte;
+       (++) FOLLOW_UP: the sequence, then the time of the network at the end
+            of the SYNC in ns, 56 bits little endian.
+       The time of the master is its own clock. A slave compares the time of
+       the FOLLOW_UP with its clock at the stamp of the SYNC: above
+       BSP_CANSYNC_STEP_NS, or on the first sample, its clock is set; below,
+       the rate of its clock is corrected by Kp 0.7 and Ki 0.3 of the offset
+       over the period, up to BSP_CANSYNC_PPB_MAX, and the clock never goes
+       back. BSP_CANSYNC_LOCK_COUNT samples in a row under
+       BSP_CANSYNC_LOCK_NS lock it; locked, a sample above
+       BSP_CANSYNC_OUTLIER_NS, an interrupt held by a higher one, is skipped.
+
+   (#) BSP_CANSYNC_GetTime() gives the time of the network in ns from any
+       context. Stamp the samples with DWT->CYCCNT where they are taken,
+       an interrupt for instance, and convert the stamp later with
+       BSP_CANSYNC_CyclesToTime(), within 2^31 cycles: the samples of all
+       the nodes line up without sending a time with each of them.
+       BSP_CANSYNC_GetStats() gives the offset, its largest value locked and
+       the rate correction, the drift of the crystal against the master.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_cansync.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANSYNC BSP CANSYNC
+  * @brief CANFD time synchronization BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Private_Constants BSP CANSYNC Private Constants
+  * @{
+  */
+#define CANSYNC_TX_IDLE                 0U             /*!< PTB free for the master                         */
+#define CANSYNC_TX_SYNC                 1U             /*!< SYNC loaded, its end not seen yet               */
+#define CANSYNC_TX_STAMPED              2U             /*!< SYNC sent, TxStamp set                          */
+#define CANSYNC_TX_FOLLOW_UP            3U             /*!< FOLLOW_UP loaded                                */
+
+#define CANSYNC_NS_PER_S                1000000000LL
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Private_Macros BSP CANSYNC Private Macros
+  * @{
+  */
+#define CANSYNC_ABS(__X__)              (((__X__) < 0) ? (uint64_t)(-(__X__)) : (uint64_t)(__X__))
+#define CANSYNC_CLAMP(__X__, __MAX__)   (((__X__) > (__MAX__)) ? (__MAX__) :                                  \
+                                         (((__X__) < -(__MAX__)) ? -(__MAX__) : (__X__)))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Private_Functions BSP CANSYNC Private Functions
+  * @{
+  */
+static uint64_t CANSYNC_Local(BSP_CANSYNC_TypeDef *hsync);
+static uint64_t CANSYNC_Time(const BSP_CANSYNC_TypeDef *hsync, uint64_t Local);
+static void     CANSYNC_Anchor(BSP_CANSYNC_TypeDef *hsync, int64_t Ppb);
+static void     CANSYNC_Send(BSP_CANSYNC_TypeDef *hsync, uint32_t Id, const uint8_t *pData, uint32_t Dlc);
+static void     CANSYNC_Sample(BSP_CANSYNC_TypeDef *hsync, uint64_t Stamp, uint64_t Time);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANSYNC_Exported_Functions BSP CANSYNC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the time synchronization.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  hcanfd CANFD handle, initialized.
+  * @param  Role A value of @ref BSP_CANSYNC_Role.
+  * @param  SyncId Standard identifier of SYNC.
+  * @param  FollowUpId Standard identifier of FOLLOW_UP.
+  * @param  PeriodMs SYNC period of the master in ms.
+  * @param  DelayNs Delay from the stamp of the master to the one of a slave in ns.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANSYNC_Init(BSP_CANSYNC_TypeDef *hsync, CANFD_HandleTypeDef *hcanfd, uint32_t Role,
+                                   uint32_t SyncId, uint32_t FollowUpId, uint32_t PeriodMs, int32_t DelayNs)
+{
+  uint32_t hclk = HAL_RCC_GetHCLKFreq();
+
+  if ((hsync == NULL) || (hcanfd == NULL) || (Role > BSP_CANSYNC_ROLE_SLAVE) || (SyncId > 0x7FFU) ||
+      (FollowUpId > 0x7FFU) || (SyncId == FollowUpId) || (PeriodMs == 0U) ||
+      ((uint64_t)PeriodMs * (hclk / 1000U) > 0x7FFFFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  hsync->hcanfd     = hcanfd;
+  hsync->Role       = Role;
+  hsync->SyncId     = SyncId;
+  hsync->FollowUpId = FollowUpId;
+  hsync->Period     = PeriodMs * (hclk / 1000U);
+  hsync->Delay      = DelayNs;
+  hsync->Nominal    = ((uint64_t)CANSYNC_NS_PER_S << 32) / hclk;
+  hsync->Scale      = hsync->Nominal;
+  hsync->TxState    = CANSYNC_TX_IDLE;
+  hsync->Sequence   = 0U;
+  hsync->RxStamped  = 0U;
+  hsync->Drift      = 0;
+  hsync->Good       = 0U;
+  hsync->Skipped    = 0U;
+  hsync->State      = BSP_CANSYNC_STATE_RESET;
+  memset(&hsync->Stats, 0, sizeof(hsync->Stats));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the local clock, at the local time, and the SYNC of the master.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANSYNC_Start(BSP_CANSYNC_TypeDef *hsync)
+{
+  uint32_t primask_bit;
+
+  if (hsync->hcanfd == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hsync->Role == BSP_CANSYNC_ROLE_MASTER) &&
+      (HAL_CANFD_ActivateNotification(hsync->hcanfd, CANFD_IT_TX_PTB_COMPLETE) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hsync->Last        = DWT->CYCCNT;
+  hsync->High        = 0U;
+  hsync->AnchorLocal = 0U;
+  hsync->AnchorTime  = 0U;
+  hsync->AnchorLocal = CANSYNC_Local(hsync);
+  hsync->AnchorTime  = CANSYNC_Time(hsync, hsync->AnchorLocal);
+  hsync->NextSync    = hsync->AnchorLocal + hsync->Period;
+  hsync->State       = (hsync->Role == BSP_CANSYNC_ROLE_MASTER) ? BSP_CANSYNC_STATE_LOCKED :
+                                                                    BSP_CANSYNC_STATE_UNSYNC;
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stamp the end of the SYNC sent or received.
+  * @note   To be called first in the CANFD interrupt handler, the flags are not cleared.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANSYNC_IRQHandler(BSP_CANSYNC_TypeDef *hsync)
+{
+  CANFD_TypeDef *canfd = hsync->hcanfd->Instance;
+  uint64_t now;
+  uint32_t sequence;
+
+  if (hsync->State == BSP_CANSYNC_STATE_RESET)
+  {
+    return;
+  }
+
+  now = CANSYNC_Local(hsync);
+
+  if (hsync->Role == BSP_CANSYNC_ROLE_MASTER)
+  {
+    if ((canfd->IFR & CANFD_FLAG_TX_PTB_COMPLETE) != 0U)
+    {
+      if (hsync->TxState == CANSYNC_TX_SYNC)
+      {
+        hsync->TxStamp = now;
+        hsync->TxState = CANSYNC_TX_STAMPED;
+      }
+      else if (hsync->TxState == CANSYNC_TX_FOLLOW_UP)
+      {
+        hsync->TxState = CANSYNC_TX_IDLE;
+      }
+    }
+    return;
+  }
+
+  /* The SYNC at the head of the FIFO, read in place, not released */
+  if (((canfd->IFR & CANFD_FLAG_RX_COMPLETE) != 0U) &&
+      ((canfd->MCR & CANFD_MCR_RSTAT) != CANFD_RX_FIFO_EMPTY) &&
+      ((canfd->RBUF.FORMAT & CANFD_LLC_FORMAT_IDE) == 0U) &&
+      (((canfd->RBUF.ID >> 18U) & 0x7FFU) == hsync->SyncId))
+  {
+    sequence = canfd->RBUF.DATA[0] & 0xFFU;
+    if ((hsync->RxStamped == 0U) || (hsync->RxSequence != sequence))
+    {
+      hsync->RxStamp    = now;
+      hsync->RxSequence = sequence;
+      hsync->RxStamped  = 1U;
+      hsync->Stats.Syncs++;
+    }
+  }
+}
+
+/**
+  * @brief  Take a frame received, the FOLLOW_UP ones used by a slave.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Id Standard identifier of the frame.
+  * @param  pData Payload.
+  * @param  Length Bytes of the payload.
+  * @retval None
+  */
+void BSP_CANSYNC_RxFrame(BSP_CANSYNC_TypeDef *hsync, uint32_t Id, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t primask_bit;
+  uint32_t stamped;
+  uint32_t sequence;
+  uint64_t stamp;
+  uint64_t time = 0U;
+  uint32_t i;
+
+  if ((Id != hsync->FollowUpId) || (hsync->Role != BSP_CANSYNC_ROLE_SLAVE) ||
+      (hsync->State == BSP_CANSYNC_STATE_RESET) || (Length < 8U))
+  {
+    return;
+  }
+  hsync->Stats.FollowUps++;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  stamped  = hsync->RxStamped;
+  sequence = hsync->RxSequence;
+  stamp    = hsync->RxStamp;
+  hsync->RxStamped = 0U;
+  __set_PRIMASK(primask_bit);
+
+  if ((stamped == 0U) || (sequence != pData[0]))
+  {
+    hsync->Stats.Missed++;
+    return;
+  }
+
+  for (i = 7U; i > 0U; i--)
+  {
+    time = (time << 8) | pData[i];
+  }
+
+  CANSYNC_Sample(hsync, stamp, time + (uint64_t)(int64_t)hsync->Delay);
+}
+
+/**
+  * @brief  Send the SYNC and FOLLOW_UP frames of the master, and keep the local clock.
+  * @note   To be called from the main loop, at least every 2^32 CPU cycles.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANSYNC_Process(BSP_CANSYNC_TypeDef *hsync)
+{
+  uint32_t primask_bit;
+  uint64_t now;
+  uint64_t time;
+  uint8_t data[8];
+  uint32_t i;
+
+  if (hsync->State == BSP_CANSYNC_STATE_RESET)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  now  = CANSYNC_Local(hsync);
+  time = CANSYNC_Time(hsync, hsync->TxStamp);
+  __set_PRIMASK(primask_bit);
+
+  if (hsync->Role != BSP_CANSYNC_ROLE_MASTER)
+  {
+    return;
+  }
+
+  if ((hsync->TxState == CANSYNC_TX_STAMPED) && (READ_BIT(hsync->hcanfd->Instance->MCR, CANFD_MCR_TPE) == 0U))
+  {
+    data[0] = (uint8_t)hsync->Sequence;
+    for (i = 1U; i < 8U; i++)
+    {
+      data[i] = (uint8_t)time;
+      time >>= 8;
+    }
+    hsync->TxState = CANSYNC_TX_FOLLOW_UP;
+    CANSYNC_Send(hsync, hsync->FollowUpId, data, CANFD_DLC_BYTES_8);
+    hsync->Sequence = (hsync->Sequence + 1U) & 0xFFU;
+    hsync->Stats.FollowUps++;
+  }
+
+  if ((int64_t)(now - hsync->NextSync) < 0)
+  {
+    return;
+  }
+
+  /* A frame still in the PTB a period later was not sent: bus off or lost arbitration all along */
+  if (hsync->TxState != CANSYNC_TX_IDLE)
+  {
+    hsync->TxState = CANSYNC_TX_IDLE;
+    hsync->Stats.Missed++;
+  }
+
+  if (READ_BIT(hsync->hcanfd->Instance->MCR, CANFD_MCR_TPE) == 0U)
+  {
+    data[0] = (uint8_t)hsync->Sequence;
+    hsync->TxState = CANSYNC_TX_SYNC;
+    CANSYNC_Send(hsync, hsync->SyncId, data, CANFD_DLC_BYTES_1);
+    hsync->Stats.Syncs++;
+  }
+
+  hsync->NextSync += hsync->Period;
+  if ((int64_t)(now - hsync->NextSync) >= 0)
+  {
+    hsync->NextSync = now + hsync->Period;
+  }
+}
+
+/**
+  * @brief  Get the time of the network.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @retval Time in ns
+  */
+uint64_t BSP_CANSYNC_GetTime(BSP_CANSYNC_TypeDef *hsync)
+{
+  uint32_t primask_bit;
+  uint64_t time;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  time = CANSYNC_Time(hsync, CANSYNC_Local(hsync));
+  __set_PRIMASK(primask_bit);
+
+  return time;
+}
+
+/**
+  * @brief  Get the time of the network at a DWT cycle counter value.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Cycles DWT->CYCCNT read less than 2^31 CPU cycles ago.
+  * @retval Time in ns
+  */
+uint64_t BSP_CANSYNC_CyclesToTime(BSP_CANSYNC_TypeDef *hsync, uint32_t Cycles)
+{
+  uint32_t primask_bit;
+  uint64_t local;
+  uint64_t time;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  local = CANSYNC_Local(hsync);
+  local -= (uint32_t)(hsync->Last - Cycles);
+  time = CANSYNC_Time(hsync, local);
+  __set_PRIMASK(primask_bit);
+
+  return time;
+}
+
+/**
+  * @brief  Get a snapshot of the statistics.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  pStats Statistics copied.
+  * @retval None
+  */
+void BSP_CANSYNC_GetStats(const BSP_CANSYNC_TypeDef *hsync, BSP_CANSYNC_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hsync->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANSYNC_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read the local clock, the DWT cycle counter extended to 64 bits.
+  * @note   Called interrupts disabled, or from the CANFD interrupt.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @retval CPU cycles
+  */
+static uint64_t CANSYNC_Local(BSP_CANSYNC_TypeDef *hsync)
+{
+  uint32_t now = DWT->CYCCNT;
+
+  if (now < hsync->Last)
+  {
+    hsync->High++;
+  }
+  hsync->Last = now;
+
+  return ((uint64_t)hsync->High << 32) | now;
+}
+
+/**
+  * @brief  Convert a local clock value to the time of the network.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Local CPU cycles, before or after the anchor.
+  * @retval Time in ns
+  */
+static uint64_t CANSYNC_Time(const BSP_CANSYNC_TypeDef *hsync, uint64_t Local)
+{
+  uint64_t delta = (Local >= hsync->AnchorLocal) ? (Local - hsync->AnchorLocal) : (hsync->AnchorLocal - Local);
+  uint64_t whole = hsync->Scale >> 32;
+  uint64_t frac  = hsync->Scale & 0xFFFFFFFFU;
+  uint64_t ns;
+
+  /* delta x Scale / 2^32 without the 128-bit product */
+  ns = (delta * whole) + ((delta >> 32) * frac) + (((delta & 0xFFFFFFFFU) * frac) >> 32);
+
+  return (Local >= hsync->AnchorLocal) ? (hsync->AnchorTime + ns) : (hsync->AnchorTime - ns);
+}
+
+/**
+  * @brief  Move the anchor to now, the time kept, and set the rate correction.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Ppb Rate correction.
+  * @retval None
+  */
+static void CANSYNC_Anchor(BSP_CANSYNC_TypeDef *hsync, int64_t Ppb)
+{
+  uint32_t primask_bit;
+  uint64_t now;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  now = CANSYNC_Local(hsync);
+  hsync->AnchorTime  = CANSYNC_Time(hsync, now);
+  hsync->AnchorLocal = now;
+  hsync->Scale       = (uint64_t)((int64_t)hsync->Nominal + (((int64_t)hsync->Nominal * Ppb) / CANSYNC_NS_PER_S));
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Load a classic frame into the PTB and send it.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Id Standard identifier.
+  * @param  pData Payload.
+  * @param  Dlc Data length code, CANFD_DLC_BYTES_1 or CANFD_DLC_BYTES_8.
+  * @retval None
+  */
+static void CANSYNC_Send(BSP_CANSYNC_TypeDef *hsync, uint32_t Id, const uint8_t *pData, uint32_t Dlc)
+{
+  CANFD_TxHeaderTypeDef header;
+
+  header.Identifier  = Id;
+  header.IdType      = CANFD_STANDARD_ID;
+  header.TxFrameType = CANFD_DATA_FRAME;
+  header.FrameFormat = CANFD_FRAME_CLASSIC;
+  header.Handle      = 0U;
+  header.DataLength  = Dlc;
+
+  if (HAL_CANFD_AddMessageToTxFifo(hsync->hcanfd, &header, (uint8_t *)pData, CANFD_TX_FIFO_PTB) == HAL_OK)
+  {
+    (void)HAL_CANFD_ActivateTxRequest(hsync->hcanfd, CANFD_TXFIFO_PTB_SEND);
+  }
+  else
+  {
+    hsync->TxState = CANSYNC_TX_IDLE;
+    hsync->Stats.Missed++;
+  }
+}
+
+/**
+  * @brief  Run the servo on a sample of the slave.
+  * @param  hsync Pointer to a BSP_CANSYNC_TypeDef structure.
+  * @param  Stamp CPU cycle of the end of the SYNC.
+  * @param  Time Time of the master at the stamp, ns.
+  * @retval None
+  */
+static void CANSYNC_Sample(BSP_CANSYNC_TypeDef *hsync, uint64_t Stamp, uint64_t Time)
+{
+  uint32_t primask_bit;
+  int64_t offset;
+  int64_t interval;
+  int64_t ppb;
+  int64_t drift;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  offset = (int64_t)(Time - CANSYNC_Time(hsync, Stamp));
+  __set_PRIMASK(primask_bit);
+
+  hsync->Stats.Offset = (int32_t)CANSYNC_CLAMP(offset, (int64_t)0x7FFFFFFF);
+
+  /* First sample or offset too large: the clock is set, the rate kept */
+  if ((hsync->State == BSP_CANSYNC_STATE_UNSYNC) || (CANSYNC_ABS(offset) > (uint64_t)BSP_CANSYNC_STEP_NS))
+  {
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    hsync->AnchorLocal = Stamp;
+    hsync->AnchorTime  = Time;
+    __set_PRIMASK(primask_bit);
+    hsync->PrevTime = Time;
+    hsync->Good     = 0U;
+    hsync->Skipped  = 0U;
+    hsync->State    = BSP_CANSYNC_STATE_LOCKING;
+    hsync->Stats.Steps++;
+    return;
+  }
+
+  if ((hsync->State == BSP_CANSYNC_STATE_LOCKED) && (CANSYNC_ABS(offset) > (uint64_t)BSP_CANSYNC_OUTLIER_NS))
+  {
+    hsync->Stats.Outliers++;
+    if (++hsync->Skipped <= BSP_CANSYNC_OUTLIER_MAX)
+    {
+      return;
+    }
+    hsync->State = BSP_CANSYNC_STATE_LOCKING;
+  }
+  hsync->Skipped = 0U;
+
+  interval = (int64_t)(Time - hsync->PrevTime);
+  hsync->PrevTime = Time;
+  if (interval <= 0)
+  {
+    return;
+  }
+
+  /* PI on the offset over the interval, in ppb: Kp 0.7, Ki 0.3 */
+  ppb   = (offset * CANSYNC_NS_PER_S) / interval;
+  drift = CANSYNC_CLAMP((int64_t)hsync->Drift + ((ppb * 3) / 10), (int64_t)BSP_CANSYNC_PPB_MAX);
+  hsync->Drift = (int32_t)drift;
+  ppb = CANSYNC_CLAMP(drift + ((ppb * 7) / 10), (int64_t)BSP_CANSYNC_PPB_MAX);
+  CANSYNC_Anchor(hsync, ppb);
+
+  hsync->Stats.Samples++;
+  hsync->Stats.Ppb = (int32_t)ppb;
+
+  if (CANSYNC_ABS(offset) < (uint64_t)BSP_CANSYNC_LOCK_NS)
+  {
+    if ((hsync->State != BSP_CANSYNC_STATE_LOCKED) && (++hsync->Good >= BSP_CANSYNC_LOCK_COUNT))
+    {
+      hsync->State = BSP_CANSYNC_STATE_LOCKED;
+    }
+  }
+  else
+  {
+    hsync->Good = 0U;
+  }
+
+  if ((hsync->State == BSP_CANSYNC_STATE_LOCKED) && (CANSYNC_ABS(offset) > hsync->Stats.OffsetMax))
+  {
+    hsync->Stats.OffsetMax = (uint32_t)CANSYNC_ABS(offset);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
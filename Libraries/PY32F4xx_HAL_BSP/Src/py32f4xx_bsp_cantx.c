@@ -0,0 +1,398 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_cantx.c
+  * @author  MCU Application Team
+  * @brief   CANFD transmit scheduler BSP service.
+  *          This file provides functions to keep the CANFD transmitting
+  *          without application polling:
+  *           + Software queues per priority
+  *           + Secondary transmit buffer refilled on each completion
+  *           + Primary transmit buffer reserved to the urgent frames
+  *           + Queue depth, high watermark and rejection statistics
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_CANFD_AddMessageToTxFifo() fails once the STB (secondary
+       transmit buffer) is full and the application has to retry later.
+       This service queues the frames in software per priority and writes
+       them into the CANFD from the transmit complete interrupts.
+
+   (#) Call BSP_CANTX_Init(), then BSP_CANTX_ConfigQueue() for each of the
+       priorities used, with a pool of BSP_CANTX_FrameTypeDef, its size a
+       power of 2. After HAL_CANFD_Start() call BSP_CANTX_Start(): the STB is
+       set to send the smallest identifier first and the PTB and STB
+       transmit complete interrupts are enabled.
+
+   (#) Call BSP_CANTX_TxCpltHandler() from HAL_CANFD_PtbTxCpltCallback()
+       and HAL_CANFD_StbTxCpltCallback(). It loads the next urgent frame
+       into the PTB (primary transmit buffer), then fills the free slots of
+       the STB from the HIGH, NORMAL and LOW queues in this order and
+       requests their transmission.
+
+   (#) BSP_CANTX_Send() copies a frame into the queue of its priority and
+       refills the buffers at once when they are idle: HAL_BUSY when the
+       queue is full. BSP_CANTX_PRIORITY_URGENT frames use the PTB only, the
+       CANFD sends it before the STB: they never wait behind frames already
+       loaded. Each priority is sent from one context, several priorities
+       may be sent from different ones.
+
+   (#) Avoiding priority inversion:
+       (+) The STB sends the smallest identifier first, as the bus
+           arbitration does: a frame of low identifier loaded after others
+           is sent at once.
+       (+) The queues are loaded highest priority first, a lower one only
+           when the higher ones are empty. Give the priorities in the order
+           of the identifiers they carry.
+       (+) A HIGH frame can still wait for a slot of the STB behind lower
+           ones already loaded: urgent frames go to the PTB.
+
+   (#) BSP_CANTX_GetStats() gives the frames queued, loaded and rejected of
+       a priority, with its depth and high watermark: a high watermark
+       near the queue size asks for a larger queue or less traffic.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_cantx.h"
+#include <string.h>
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CANTX BSP CANTX
+  * @brief CANFD transmit scheduler BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CANTX_Private_Constants BSP CANTX Private Constants
+  * @{
+  */
+#define CANTX_IT                        (CANFD_IT_TX_PTB_COMPLETE | CANFD_IT_TX_STB_COMPLETE)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CANTX_Private_Variables BSP CANTX Private Variables
+  * @{
+  */
+static const uint8_t CANTX_DlcBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CANTX_Private_Functions BSP CANTX Private Functions
+  * @{
+  */
+static void CANTX_Refill(BSP_CANTX_TypeDef *htx);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CANTX_Exported_Functions BSP CANTX Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a CANFD transmit scheduler, all the queues unset.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @param  hcanfd CANFD handle.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANTX_Init(BSP_CANTX_TypeDef *htx, CANFD_HandleTypeDef *hcanfd)
+{
+  uint32_t i;
+
+  if ((htx == NULL) || (hcanfd == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if (htx->State == BSP_CANTX_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  htx->hcanfd = hcanfd;
+  for (i = 0U; i < BSP_CANTX_PRIORITIES; i++)
+  {
+    memset(&htx->Queue[i], 0, sizeof(BSP_CANTX_QueueTypeDef));
+  }
+  htx->State = BSP_CANTX_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the queue of a priority.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @param  Priority A value of @ref BSP_CANTX_Priority.
+  * @param  pFrames Frames of the queue.
+  * @param  Size Frames of the queue, a power of 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANTX_ConfigQueue(BSP_CANTX_TypeDef *htx, uint32_t Priority,
+                                        BSP_CANTX_FrameTypeDef *pFrames, uint32_t Size)
+{
+  BSP_CANTX_QueueTypeDef *queue;
+
+  if ((Priority >= BSP_CANTX_PRIORITIES) || (pFrames == NULL) || (Size == 0U) || ((Size & (Size - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  if (htx->State != BSP_CANTX_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  queue = &htx->Queue[Priority];
+  memset(queue, 0, sizeof(BSP_CANTX_QueueTypeDef));
+  queue->pFrames = pFrames;
+  queue->Size    = Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Enable the transmit complete interrupts, the CANFD started.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANTX_Start(BSP_CANTX_TypeDef *htx)
+{
+  if (htx->State != BSP_CANTX_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if ((HAL_CANFD_ConfigTxFifoPriority(htx->hcanfd, CANFD_STB_PRIORITY_ID) != HAL_OK) ||
+      (HAL_CANFD_ActivateNotification(htx->hcanfd, CANTX_IT) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+  htx->State = BSP_CANTX_STATE_RUN;
+
+  BSP_CANTX_TxCpltHandler(htx);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable the transmit complete interrupts, the queued frames kept.
+  * @note   Frames already in the PTB or the STB are still sent.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CANTX_Stop(BSP_CANTX_TypeDef *htx)
+{
+  if (htx->State != BSP_CANTX_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_CANFD_DeactivateNotification(htx->hcanfd, CANTX_IT);
+  htx->State = BSP_CANTX_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue a frame.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @param  Priority A value of @ref BSP_CANTX_Priority.
+  * @param  pHeader Header of the frame.
+  * @param  pData Payload, the length of pHeader->DataLength.
+  * @retval HAL status, HAL_BUSY when the queue is full
+  */
+HAL_StatusTypeDef BSP_CANTX_Send(BSP_CANTX_TypeDef *htx, uint32_t Priority,
+                                 const CANFD_TxHeaderTypeDef *pHeader, const uint8_t *pData)
+{
+  BSP_CANTX_QueueTypeDef *queue;
+  BSP_CANTX_FrameTypeDef *frame;
+  uint32_t primask_bit;
+  uint32_t head;
+  uint32_t depth;
+
+  if ((Priority >= BSP_CANTX_PRIORITIES) || (pHeader == NULL) || (htx->Queue[Priority].pFrames == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if (htx->State != BSP_CANTX_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  queue = &htx->Queue[Priority];
+  head = queue->Head;
+  if ((head - queue->Tail) >= queue->Size)
+  {
+    queue->Stats.Rejected++;
+    return HAL_BUSY;
+  }
+
+  /* The interrupt only reads the frames, copied before being published */
+  frame = &queue->pFrames[head & (queue->Size - 1U)];
+  frame->Header = *pHeader;
+  if (pData != NULL)
+  {
+    memcpy(frame->Data, pData, CANTX_DlcBytes[pHeader->DataLength & 0x0FU]);
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  queue->Head = head + 1U;
+  queue->Stats.Queued++;
+  depth = queue->Head - queue->Tail;
+  if (depth > queue->Stats.HighWatermark)
+  {
+    queue->Stats.HighWatermark = depth;
+  }
+  CANTX_Refill(htx);
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Refill the PTB and the STB from the queues.
+  * @note   Call it from HAL_CANFD_PtbTxCpltCallback() and
+  *         HAL_CANFD_StbTxCpltCallback().
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @retval None
+  */
+void BSP_CANTX_TxCpltHandler(BSP_CANTX_TypeDef *htx)
+{
+  uint32_t primask_bit;
+
+  if (htx->State != BSP_CANTX_STATE_RUN)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  CANTX_Refill(htx);
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Copy the statistics of a priority.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @param  Priority A value of @ref BSP_CANTX_Priority.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CANTX_GetStats(BSP_CANTX_TypeDef *htx, uint32_t Priority, BSP_CANTX_StatsTypeDef *pStats)
+{
+  BSP_CANTX_QueueTypeDef *queue = &htx->Queue[Priority % BSP_CANTX_PRIORITIES];
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  queue->Stats.Depth = queue->Head - queue->Tail;
+  *pStats = queue->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CANTX_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Load the PTB and the free slots of the STB, interrupts masked.
+  * @param  htx Pointer to a BSP_CANTX_TypeDef structure.
+  * @retval None
+  */
+static void CANTX_Refill(BSP_CANTX_TypeDef *htx)
+{
+  CANFD_HandleTypeDef *hcanfd = htx->hcanfd;
+  BSP_CANTX_QueueTypeDef *queue;
+  BSP_CANTX_FrameTypeDef *frame;
+  uint32_t loaded = 0U;
+  uint32_t priority;
+
+  /* Urgent frames, the PTB idle */
+  queue = &htx->Queue[BSP_CANTX_PRIORITY_URGENT];
+  if ((queue->Head != queue->Tail) && (READ_BIT(hcanfd->Instance->MCR, CANFD_MCR_TPE) == 0U))
+  {
+    frame = &queue->pFrames[queue->Tail & (queue->Size - 1U)];
+    if (HAL_CANFD_AddMessageToTxFifo(hcanfd, &frame->Header, (uint8_t *)frame->Data, CANFD_TX_FIFO_PTB) == HAL_OK)
+    {
+      queue->Tail = queue->Tail + 1U;
+      queue->Stats.Loaded++;
+      (void)HAL_CANFD_ActivateTxRequest(hcanfd, CANFD_TXFIFO_PTB_SEND);
+    }
+  }
+
+  /* Free STB slots, highest priority first */
+  priority = BSP_CANTX_PRIORITY_HIGH;
+  while ((priority < BSP_CANTX_PRIORITIES) &&
+         (__HAL_CANFD_GET_STB_FIFO_FREE_LEVEL(hcanfd) != CANFD_STB_FIFO_FULL))
+  {
+    queue = &htx->Queue[priority];
+    if (queue->Head == queue->Tail)
+    {
+      priority++;
+      continue;
+    }
+    frame = &queue->pFrames[queue->Tail & (queue->Size - 1U)];
+    if (HAL_CANFD_AddMessageToTxFifo(hcanfd, &frame->Header, (uint8_t *)frame->Data, CANFD_TX_FIFO_STB) != HAL_OK)
+    {
+      break;
+    }
+    queue->Tail = queue->Tail + 1U;
+    queue->Stats.Loaded++;
+    loaded++;
+  }
+
+  if (loaded != 0U)
+  {
+    (void)HAL_CANFD_ActivateTxRequest(hcanfd, CANFD_TXFIFO_STB_SEND_ALL);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,574 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_clkswitch.c
+  * @author  MCU Application Team
+  * @brief   Clock switch notification BSP service.
+  *          This file provides functions to change the bus clocks at run time
+  *          without initializing the peripherals again:
+  *           + Notifiers called before and after a switch
+  *           + Switch deferred by a notifier with a transfer running
+  *           + Notifiers of the UART baudrate, SPI prescaler, I2C timing and
+  *             TIM prescaler, the rate kept over the switch
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A change of HCLK, PCLK1 or PCLK2 changes the rate of every peripheral
+       counting on it. Initializing them again after HAL_RCC_ClockConfig()
+       takes long and resets their state. A notifier derives its rate from
+       the new clock instead, a few register writes.
+
+   (#) Register a notifier per peripheral, its structure kept by the
+       application until BSP_CLKSWITCH_Unregister():
+       (+) BSP_CLKSWITCH_RegisterUart() writes BRR again for Init.BaudRate
+           with HAL_UARTEx_SetBaudRate(),
+       (+) BSP_CLKSWITCH_RegisterSpi() takes the fastest prescaler not above
+           the SCK rate before the switch,
+       (+) BSP_CLKSWITCH_RegisterI2c() writes FREQ, TRISE and CCR again for
+           Init.ClockSpeed and Init.DutyCycle,
+       (+) BSP_CLKSWITCH_RegisterTim() takes the prescaler nearest to the
+           counter rate before the switch. The prescaler is preloaded: the
+           period running ends at the old rate.
+       For another peripheral, set Callback and pHandle and call
+       BSP_CLKSWITCH_Register().
+
+   (#) BSP_CLKSWITCH_ClockConfig() replaces HAL_RCC_ClockConfig(). Or, with
+       the oscillators and the regulator changed as well, call
+       BSP_CLKSWITCH_Prepare() before and BSP_CLKSWITCH_Complete() after the
+       switch, as the BSP DVFS service does. The notifiers are called in the
+       order of their registration:
+       (+) BSP_CLKSWITCH_EVENT_PRE records the rate. A notifier returning
+           HAL_BUSY, its transfer running, defers the switch: the notifiers
+           before get BSP_CLKSWITCH_EVENT_ABORT and HAL_BUSY is returned.
+           The UART with a transmission, the SPI and the I2C not ready
+           defer. A reception of the UART goes on, a frame may be lost.
+       (+) BSP_CLKSWITCH_EVENT_POST derives the rate from the new clocks,
+           the switch done or failed. A notifier failing, the rate out of
+           the range of the new clock, is counted and HAL_ERROR returned.
+       Keep new transfers from starting between the two, the notifiers do
+       not lock the handles.
+
+   (#) BSP_CLKSWITCH_GetStats() gives the switches, the switches deferred,
+       the failures and the CPU cycles of the last switch, PRE to POST.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_clkswitch.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CLKSWITCH BSP CLKSWITCH
+  * @brief Clock switch notification BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Private_Macros BSP CLKSWITCH Private Macros
+  * @{
+  */
+#define CLKSWITCH_IS_APB2(__INSTANCE__) (((uint32_t)(__INSTANCE__) >= APB2PERIPH_BASE) && \
+                                         ((uint32_t)(__INSTANCE__) < AHB1PERIPH_BASE))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Private_Variables BSP CLKSWITCH Private Variables
+  * @{
+  */
+static BSP_CLKSWITCH_NotifierTypeDef *CLKSWITCH_pHead;
+static BSP_CLKSWITCH_StatsTypeDef    CLKSWITCH_Stats;
+static uint32_t                      CLKSWITCH_Stamp;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Private_Functions BSP CLKSWITCH Private Functions
+  * @{
+  */
+static uint32_t          CLKSWITCH_GetPclk(const void *Instance);
+#if defined (HAL_UART_MODULE_ENABLED)
+static HAL_StatusTypeDef CLKSWITCH_Uart(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event);
+#endif /* HAL_UART_MODULE_ENABLED */
+#if defined (HAL_SPI_MODULE_ENABLED)
+static HAL_StatusTypeDef CLKSWITCH_Spi(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event);
+#endif /* HAL_SPI_MODULE_ENABLED */
+#if defined (HAL_I2C_MODULE_ENABLED)
+static HAL_StatusTypeDef CLKSWITCH_I2c(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event);
+#endif /* HAL_I2C_MODULE_ENABLED */
+#if defined (HAL_TIM_MODULE_ENABLED)
+static HAL_StatusTypeDef CLKSWITCH_Tim(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event);
+#endif /* HAL_TIM_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CLKSWITCH_Exported_Functions BSP CLKSWITCH Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Add a notifier at the end of the list.
+  * @param  pNotifier Notifier, Callback and pHandle set, kept by the application.
+  * @retval HAL status, HAL_BUSY when the notifier is registered already
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_Register(BSP_CLKSWITCH_NotifierTypeDef *pNotifier)
+{
+  BSP_CLKSWITCH_NotifierTypeDef **plink;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t primask;
+
+  if ((pNotifier == NULL) || (pNotifier->Callback == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  plink = &CLKSWITCH_pHead;
+  while ((*plink != NULL) && (*plink != pNotifier))
+  {
+    plink = &(*plink)->pNext;
+  }
+  if (*plink == NULL)
+  {
+    pNotifier->Rate  = 0U;
+    pNotifier->pNext = NULL;
+    *plink = pNotifier;
+  }
+  else
+  {
+    status = HAL_BUSY;
+  }
+  __set_PRIMASK(primask);
+
+  return status;
+}
+
+/**
+  * @brief  Remove a notifier from the list.
+  * @param  pNotifier Notifier, ignored when not registered.
+  * @retval None
+  */
+void BSP_CLKSWITCH_Unregister(BSP_CLKSWITCH_NotifierTypeDef *pNotifier)
+{
+  BSP_CLKSWITCH_NotifierTypeDef **plink;
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  plink = &CLKSWITCH_pHead;
+  while ((*plink != NULL) && (*plink != pNotifier))
+  {
+    plink = &(*plink)->pNext;
+  }
+  if (*plink != NULL)
+  {
+    *plink = pNotifier->pNext;
+    pNotifier->pNext = NULL;
+  }
+  __set_PRIMASK(primask);
+}
+
+#if defined (HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  Register the notifier of a UART, Init.BaudRate kept over a switch.
+  * @param  pNotifier Notifier, kept by the application.
+  * @param  huart UART handle, initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterUart(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, UART_HandleTypeDef *huart)
+{
+  if ((pNotifier == NULL) || (huart == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  pNotifier->Callback = CLKSWITCH_Uart;
+  pNotifier->pHandle  = huart;
+
+  return BSP_CLKSWITCH_Register(pNotifier);
+}
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#if defined (HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  Register the notifier of a SPI master, the SCK rate kept at most.
+  * @param  pNotifier Notifier, kept by the application.
+  * @param  hspi SPI handle, initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterSpi(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, SPI_HandleTypeDef *hspi)
+{
+  if ((pNotifier == NULL) || (hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  pNotifier->Callback = CLKSWITCH_Spi;
+  pNotifier->pHandle  = hspi;
+
+  return BSP_CLKSWITCH_Register(pNotifier);
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#if defined (HAL_I2C_MODULE_ENABLED)
+/**
+  * @brief  Register the notifier of an I2C, Init.ClockSpeed kept over a switch.
+  * @param  pNotifier Notifier, kept by the application.
+  * @param  hi2c I2C handle, initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterI2c(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, I2C_HandleTypeDef *hi2c)
+{
+  if ((pNotifier == NULL) || (hi2c == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  pNotifier->Callback = CLKSWITCH_I2c;
+  pNotifier->pHandle  = hi2c;
+
+  return BSP_CLKSWITCH_Register(pNotifier);
+}
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+/**
+  * @brief  Register the notifier of a timer, the counter rate kept over a switch.
+  * @param  pNotifier Notifier, kept by the application.
+  * @param  htim TIM handle, initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_RegisterTim(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, TIM_HandleTypeDef *htim)
+{
+  if ((pNotifier == NULL) || (htim == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  pNotifier->Callback = CLKSWITCH_Tim;
+  pNotifier->pHandle  = htim;
+
+  return BSP_CLKSWITCH_Register(pNotifier);
+}
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @brief  Notify the notifiers of a switch coming, before the RCC is changed.
+  * @retval HAL status, HAL_BUSY when a notifier defers the switch
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_Prepare(void)
+{
+  BSP_CLKSWITCH_NotifierTypeDef *pnotifier;
+  BSP_CLKSWITCH_NotifierTypeDef *pprepared;
+
+  HAL_EnableCycleCounter();
+  CLKSWITCH_Stamp = DWT->CYCCNT;
+
+  for (pnotifier = CLKSWITCH_pHead; pnotifier != NULL; pnotifier = pnotifier->pNext)
+  {
+    if (pnotifier->Callback(pnotifier, BSP_CLKSWITCH_EVENT_PRE) != HAL_OK)
+    {
+      for (pprepared = CLKSWITCH_pHead; pprepared != pnotifier; pprepared = pprepared->pNext)
+      {
+        (void)pprepared->Callback(pprepared, BSP_CLKSWITCH_EVENT_ABORT);
+      }
+      CLKSWITCH_Stats.Deferred++;
+      return HAL_BUSY;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Notify the notifiers of the new clocks, after the RCC is changed.
+  * @note   Call it after BSP_CLKSWITCH_Prepare() returned HAL_OK, the switch
+  *         done or failed.
+  * @retval HAL status, HAL_ERROR when a notifier could not derive its rate
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_Complete(void)
+{
+  BSP_CLKSWITCH_NotifierTypeDef *pnotifier;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  for (pnotifier = CLKSWITCH_pHead; pnotifier != NULL; pnotifier = pnotifier->pNext)
+  {
+    if (pnotifier->Callback(pnotifier, BSP_CLKSWITCH_EVENT_POST) != HAL_OK)
+    {
+      CLKSWITCH_Stats.Failures++;
+      status = HAL_ERROR;
+    }
+  }
+
+  CLKSWITCH_Stats.Switches++;
+  CLKSWITCH_Stats.Cycles = DWT->CYCCNT - CLKSWITCH_Stamp;
+
+  return status;
+}
+
+/**
+  * @brief  Change the bus clocks with HAL_RCC_ClockConfig(), the notifiers around.
+  * @param  pClkInit Clocks as for HAL_RCC_ClockConfig().
+  * @param  FLatency Flash latency as for HAL_RCC_ClockConfig().
+  * @retval HAL status, HAL_BUSY when a notifier defers the switch
+  */
+HAL_StatusTypeDef BSP_CLKSWITCH_ClockConfig(const RCC_ClkInitTypeDef *pClkInit, uint32_t FLatency)
+{
+  RCC_ClkInitTypeDef clkinit;
+  HAL_StatusTypeDef status;
+
+  if (pClkInit == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  status = BSP_CLKSWITCH_Prepare();
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  clkinit = *pClkInit;
+  status = HAL_RCC_ClockConfig(&clkinit, FLatency);
+
+  if (BSP_CLKSWITCH_Complete() != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Read the statistics.
+  * @param  pStats Statistics read.
+  * @retval None
+  */
+void BSP_CLKSWITCH_GetStats(BSP_CLKSWITCH_StatsTypeDef *pStats)
+{
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  *pStats = CLKSWITCH_Stats;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CLKSWITCH_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the PCLK of the bus of a peripheral.
+  * @param  Instance Registers of the peripheral.
+  * @retval PCLK2 on APB2, PCLK1 else, Hz
+  */
+static uint32_t CLKSWITCH_GetPclk(const void *Instance)
+{
+  return CLKSWITCH_IS_APB2(Instance) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+}
+
+#if defined (HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  Notifier of a UART.
+  * @param  pNotifier Notifier.
+  * @param  Event A value of @ref BSP_CLKSWITCH_Event.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CLKSWITCH_Uart(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)pNotifier->pHandle;
+
+  if (Event == BSP_CLKSWITCH_EVENT_PRE)
+  {
+    /* A byte on the line would go out at two rates */
+    return (huart->gState == HAL_UART_STATE_READY) ? HAL_OK : HAL_BUSY;
+  }
+  if (Event == BSP_CLKSWITCH_EVENT_POST)
+  {
+    return HAL_UARTEx_SetBaudRate(huart, huart->Init.BaudRate);
+  }
+
+  return HAL_OK;
+}
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#if defined (HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  Notifier of a SPI.
+  * @param  pNotifier Notifier, Rate the SCK rate before the switch.
+  * @param  Event A value of @ref BSP_CLKSWITCH_Event.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CLKSWITCH_Spi(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event)
+{
+  SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef *)pNotifier->pHandle;
+  uint32_t pclk = CLKSWITCH_GetPclk(hspi->Instance);
+  uint32_t br;
+
+  if (Event == BSP_CLKSWITCH_EVENT_PRE)
+  {
+    if (hspi->State != HAL_SPI_STATE_READY)
+    {
+      return HAL_BUSY;
+    }
+    br = READ_BIT(hspi->Instance->CR1, SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+    pNotifier->Rate = pclk >> (br + 1U);
+    return HAL_OK;
+  }
+  if (Event != BSP_CLKSWITCH_EVENT_POST)
+  {
+    return HAL_OK;
+  }
+
+  /* Fastest SCK not above the one before, PCLK divided by 2 to 256 */
+  br = 0U;
+  while ((br < 7U) && ((pclk >> (br + 1U)) > pNotifier->Rate))
+  {
+    br++;
+  }
+
+  if (READ_BIT(hspi->Instance->CR1, SPI_CR1_SPE) != 0U)
+  {
+    CLEAR_BIT(hspi->Instance->CR1, SPI_CR1_SPE);
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_SPE);
+  }
+  else
+  {
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, br << SPI_CR1_BR_Pos);
+  }
+  hspi->Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos;
+
+  return ((pclk >> (br + 1U)) > pNotifier->Rate) ? HAL_ERROR : HAL_OK;
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#if defined (HAL_I2C_MODULE_ENABLED)
+/**
+  * @brief  Notifier of an I2C.
+  * @param  pNotifier Notifier.
+  * @param  Event A value of @ref BSP_CLKSWITCH_Event.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CLKSWITCH_I2c(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event)
+{
+  I2C_HandleTypeDef *hi2c = (I2C_HandleTypeDef *)pNotifier->pHandle;
+  uint32_t pclk1;
+  uint32_t freqrange;
+
+  if (Event == BSP_CLKSWITCH_EVENT_PRE)
+  {
+    return (hi2c->State == HAL_I2C_STATE_READY) ? HAL_OK : HAL_BUSY;
+  }
+  if (Event != BSP_CLKSWITCH_EVENT_POST)
+  {
+    return HAL_OK;
+  }
+
+  /* Timing kept as it was when PCLK1 is too slow for the speed */
+  pclk1 = HAL_RCC_GetPCLK1Freq();
+  if (I2C_MIN_PCLK_FREQ(pclk1, hi2c->Init.ClockSpeed) == 1U)
+  {
+    return HAL_ERROR;
+  }
+  freqrange = I2C_FREQRANGE(pclk1);
+
+  /* TRISE and CCR are written with the peripheral disabled */
+  __HAL_I2C_DISABLE(hi2c);
+  MODIFY_REG(hi2c->Instance->CR2, I2C_CR2_FREQ, freqrange);
+  MODIFY_REG(hi2c->Instance->TRISE, I2C_TRISE_TRISE, I2C_RISE_TIME(freqrange, hi2c->Init.ClockSpeed));
+  MODIFY_REG(hi2c->Instance->CCR, (I2C_CCR_FS | I2C_CCR_DUTY | I2C_CCR_CCR),
+             I2C_SPEED(pclk1, hi2c->Init.ClockSpeed, hi2c->Init.DutyCycle));
+  __HAL_I2C_ENABLE(hi2c);
+
+  return HAL_OK;
+}
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+/**
+  * @brief  Notifier of a timer.
+  * @param  pNotifier Notifier, Rate the counter rate before the switch.
+  * @param  Event A value of @ref BSP_CLKSWITCH_Event.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CLKSWITCH_Tim(BSP_CLKSWITCH_NotifierTypeDef *pNotifier, uint32_t Event)
+{
+  TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)pNotifier->pHandle;
+  uint32_t clock = CLKSWITCH_GetPclk(htim->Instance);
+  uint32_t prescaler;
+  HAL_StatusTypeDef status;
+
+  /* The timers run from their PCLK, doubled when the APB is divided */
+  clock = (clock == HAL_RCC_GetHCLKFreq()) ? clock : (2U * clock);
+
+  if (Event == BSP_CLKSWITCH_EVENT_PRE)
+  {
+    pNotifier->Rate = clock / (READ_REG(htim->Instance->PSC) + 1U);
+    return HAL_OK;
+  }
+  if ((Event != BSP_CLKSWITCH_EVENT_POST) || (pNotifier->Rate == 0U))
+  {
+    return HAL_OK;
+  }
+
+  /* Nearest rate, out of the range when the clock is slower or the
+     prescaler saturates */
+  prescaler = (clock + (pNotifier->Rate / 2U)) / pNotifier->Rate;
+  status = ((prescaler == 0U) || (prescaler > 0x10000U)) ? HAL_ERROR : HAL_OK;
+  prescaler = (prescaler == 0U) ? 0U : (prescaler - 1U);
+  if (prescaler > 0xFFFFU)
+  {
+    prescaler = 0xFFFFU;
+  }
+
+  /* Preloaded, taken at the next update event */
+  WRITE_REG(htim->Instance->PSC, prescaler);
+  htim->Init.Prescaler = prescaler;
+
+  return status;
+}
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,514 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crc.c
+  * @author  MCU Application Team
+  * @brief   Parametric CRC BSP service.
+  *          This file provides functions to compute the CRC the calculator
+  *          cannot, CRC-16/MODBUS, CRC-32C, ..., and to share the code with
+  *          the ones it can:
+  *           + CRC models of the catalogues, width, polynomial, reflections
+  *           + Table driven kernels, 1, 4 or 8 bytes per step
+  *           + Bitwise reference
+  *           + CRC calculator used when the model matches it
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Pick a model, BSP_CRC_Model_CRC16_MODBUS for instance, or fill a
+       BSP_CRC_ModelTypeDef from the parameters of a CRC catalogue: Width,
+       Poly, Init, RefIn, RefOut and XorOut.
+
+   (#) Call BSP_CRC_Init() with the tables of the kernel, built here from the
+       model: 1 table of 1 KB for one byte per step, 4 for slice-by-4, 8 for
+       slice-by-8. Give them a static array, in RAM for the fastest lookups:
+         static BSP_CRC_TableTypeDef aTable[4];
+         BSP_CRC_Init(&hmodbus, &BSP_CRC_Model_CRC16_MODBUS, aTable, 4U);
+       Without tables (NULL, 0) the CRC is computed bit by bit.
+
+   (#) With a BSP_CRCMUX sharing the CRC calculator, BSP_CRC_AttachHardware()
+       moves the models of its 32-bit polynomial, CRC-32 and CRC-32/MPEG-2,
+       to it through a session: the reflections and the initial value are
+       applied by the CRC driver, XorOut here. The other models keep the
+       software path, Path tells which one is used.
+
+   (#) Feed the data with BSP_CRC_Update() and read the CRC with
+       BSP_CRC_Final(), or use BSP_CRC_Compute() for a buffer at once.
+       BSP_CRC_Reset() starts again. The hardware path returns HAL_BUSY while
+       a DMA transfer feeds the calculator, nothing is consumed then.
+
+   (#) The word steps read the data with unaligned loads, __REV orders the
+       bytes of the models not reflected; the bit reversals of the
+       reflections use __RBIT.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_crc.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CRC BSP CRC
+  * @brief Parametric CRC BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CRC_Private_Constants BSP CRC Private Constants
+  * @{
+  */
+#define CRC_HW_POLY               0x04C11DB7U  /*!< Polynomial of the CRC calculator */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_CRC_Private_Macros BSP CRC Private Macros
+  * @{
+  */
+#define CRC_MASK(__WIDTH__)       (0xFFFFFFFFU >> (32U - (__WIDTH__)))
+#define CRC_REFLECT(__VALUE__, __WIDTH__) (__RBIT(__VALUE__) >> (32U - (__WIDTH__)))
+#define CRC_READ_LE(__PTR__)      (__UNALIGNED_UINT32_READ(__PTR__))
+#define CRC_READ_BE(__PTR__)      (__REV(__UNALIGNED_UINT32_READ(__PTR__)))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CRC_Private_Functions BSP CRC Private Functions
+  * @{
+  */
+static uint32_t CRC_Start(const BSP_CRC_ModelTypeDef *pModel);
+static uint32_t CRC_End(const BSP_CRC_ModelTypeDef *pModel, uint32_t Value);
+static uint32_t CRC_BitwiseStep(const BSP_CRC_ModelTypeDef *pModel, uint32_t Value, uint32_t Data);
+static uint32_t CRC_Reflected(const BSP_CRC_TypeDef *hcrcsw, uint32_t Value, const uint8_t *pData, uint32_t Length);
+static uint32_t CRC_Normal(const BSP_CRC_TypeDef *hcrcsw, uint32_t Value, const uint8_t *pData, uint32_t Length);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_CRC_Exported_Variables
+  * @{
+  */
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32        = {32U, 0x04C11DB7U, 0xFFFFFFFFU, 1U, 1U, 0xFFFFFFFFU};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32C       = {32U, 0x1EDC6F41U, 0xFFFFFFFFU, 1U, 1U, 0xFFFFFFFFU};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC32_MPEG2  = {32U, 0x04C11DB7U, 0xFFFFFFFFU, 0U, 0U, 0x00000000U};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_MODBUS = {16U, 0x8005U,     0xFFFFU,     1U, 1U, 0x0000U};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_CCITT  = {16U, 0x1021U,     0xFFFFU,     0U, 0U, 0x0000U};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC16_XMODEM = {16U, 0x1021U,     0x0000U,     0U, 0U, 0x0000U};
+const BSP_CRC_ModelTypeDef BSP_CRC_Model_CRC8         = {8U,  0x07U,       0x00U,       0U, 0U, 0x00U};
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CRC_Exported_Functions BSP CRC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a CRC computation and build its tables.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @param  pModel CRC model, kept by reference.
+  * @param  pTable Slices tables filled here, NULL for the bitwise path.
+  * @param  Slices Bytes per step of the table path, 1, 4 or 8, 0 without tables.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRC_Init(BSP_CRC_TypeDef *hcrcsw, const BSP_CRC_ModelTypeDef *pModel,
+                               BSP_CRC_TableTypeDef *pTable, uint32_t Slices)
+{
+  uint32_t slice;
+  uint32_t n;
+  uint32_t entry;
+  uint32_t shift;
+
+  if ((hcrcsw == NULL) || (pModel == NULL) || (pModel->Width == 0U) || (pModel->Width > 32U) ||
+      ((pTable == NULL) != (Slices == 0U)) || ((Slices != 0U) && (Slices != 1U) && (Slices != 4U) && (Slices != 8U)))
+  {
+    return HAL_ERROR;
+  }
+
+  hcrcsw->pModel = pModel;
+  hcrcsw->pTable = pTable;
+  hcrcsw->Slices = Slices;
+  hcrcsw->Path   = (pTable != NULL) ? BSP_CRC_PATH_TABLE : BSP_CRC_PATH_BITWISE;
+#ifdef HAL_CRC_MODULE_ENABLED
+  hcrcsw->Session.hmux = NULL;
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+  /* First table: one byte from a zero register, the next ones: the entry of
+   * the previous table shifted by one more byte */
+  shift = 32U - pModel->Width;
+  for (n = 0U; (pTable != NULL) && (n < 256U); n++)
+  {
+    entry = (pModel->RefIn != 0U) ? n : (n << 24U);
+    for (slice = 0U; slice < 8U; slice++)
+    {
+      if (pModel->RefIn != 0U)
+      {
+        entry = ((entry & 1U) != 0U) ? ((entry >> 1U) ^ CRC_REFLECT(pModel->Poly, pModel->Width)) : (entry >> 1U);
+      }
+      else
+      {
+        entry = ((entry & 0x80000000U) != 0U) ? ((entry << 1U) ^ (pModel->Poly << shift)) : (entry << 1U);
+      }
+    }
+    pTable[0][n] = entry;
+  }
+  for (slice = 1U; slice < Slices; slice++)
+  {
+    for (n = 0U; n < 256U; n++)
+    {
+      entry = pTable[slice - 1U][n];
+      pTable[slice][n] = (pModel->RefIn != 0U) ? ((entry >> 8U) ^ pTable[0][entry & 0xFFU]) :
+                                                 ((entry << 8U) ^ pTable[0][entry >> 24U]);
+    }
+  }
+
+  BSP_CRC_Reset(hcrcsw);
+
+  return HAL_OK;
+}
+
+#ifdef HAL_CRC_MODULE_ENABLED
+/**
+  * @brief  Use the CRC calculator when the model matches it.
+  * @note   The models of 32 bits with the polynomial of the calculator take
+  *         the hardware path, the others keep the software path.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure initialized.
+  * @param  hmux Pointer to a BSP_CRCMUX_TypeDef structure sharing the calculator.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRC_AttachHardware(BSP_CRC_TypeDef *hcrcsw, BSP_CRCMUX_TypeDef *hmux)
+{
+  CRC_InitTypeDef init;
+
+  if ((hcrcsw == NULL) || (hcrcsw->pModel == NULL) || (hmux == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if ((hcrcsw->pModel->Width != 32U) || (hcrcsw->pModel->Poly != CRC_HW_POLY))
+  {
+    return HAL_OK;
+  }
+
+  init.DefaultInitValueUse     = DEFAULT_INIT_VALUE_DISABLE;
+  init.InitValue               = hcrcsw->pModel->Init;
+  init.InputDataInversionMode  = (hcrcsw->pModel->RefIn != 0U) ? CRC_INPUTDATA_INVERSION_BYTE : CRC_INPUTDATA_INVERSION_NONE;
+  init.OutputDataInversionMode = (hcrcsw->pModel->RefOut != 0U) ? CRC_OUTPUTDATA_INVERSION_ENABLE : CRC_OUTPUTDATA_INVERSION_DISABLE;
+  if (BSP_CRCMUX_Open(hmux, &hcrcsw->Session, &init, CRC_INPUTDATA_FORMAT_BYTES) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hcrcsw->Path = BSP_CRC_PATH_HARDWARE;
+  BSP_CRC_Reset(hcrcsw);
+
+  return HAL_OK;
+}
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+/**
+  * @brief  Start the computation again from the initial value.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @retval None
+  */
+void BSP_CRC_Reset(BSP_CRC_TypeDef *hcrcsw)
+{
+#ifdef HAL_CRC_MODULE_ENABLED
+  if (hcrcsw->Path == BSP_CRC_PATH_HARDWARE)
+  {
+    BSP_CRCMUX_Reset(&hcrcsw->Session);
+    hcrcsw->Value = (hcrcsw->pModel->RefOut != 0U) ? __RBIT(hcrcsw->pModel->Init) : hcrcsw->pModel->Init;
+    return;
+  }
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+  hcrcsw->Value = CRC_Start(hcrcsw->pModel);
+}
+
+/**
+  * @brief  Feed data to the computation.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @param  pData Data, any alignment.
+  * @param  Length Number of bytes.
+  * @retval HAL status, HAL_BUSY when the hardware path is taken by a DMA
+  *         transfer, the data are not consumed
+  */
+HAL_StatusTypeDef BSP_CRC_Update(BSP_CRC_TypeDef *hcrcsw, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t i;
+
+  switch (hcrcsw->Path)
+  {
+#ifdef HAL_CRC_MODULE_ENABLED
+    case BSP_CRC_PATH_HARDWARE:
+      return BSP_CRCMUX_Accumulate(&hcrcsw->Session, (uint32_t *)(uint32_t)pData, Length, &hcrcsw->Value);
+#endif /* HAL_CRC_MODULE_ENABLED */
+    case BSP_CRC_PATH_TABLE:
+      hcrcsw->Value = (hcrcsw->pModel->RefIn != 0U) ? CRC_Reflected(hcrcsw, hcrcsw->Value, pData, Length) :
+                                                      CRC_Normal(hcrcsw, hcrcsw->Value, pData, Length);
+      break;
+    default:
+      for (i = 0U; i < Length; i++)
+      {
+        hcrcsw->Value = CRC_BitwiseStep(hcrcsw->pModel, hcrcsw->Value, pData[i]);
+      }
+      break;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the CRC of the data fed since the last reset.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @retval CRC
+  */
+uint32_t BSP_CRC_Final(const BSP_CRC_TypeDef *hcrcsw)
+{
+  if (hcrcsw->Path == BSP_CRC_PATH_HARDWARE)
+  {
+    return hcrcsw->Value ^ hcrcsw->pModel->XorOut;
+  }
+
+  return CRC_End(hcrcsw->pModel, hcrcsw->Value);
+}
+
+/**
+  * @brief  Compute the CRC of a buffer.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @param  pData Data, any alignment.
+  * @param  Length Number of bytes.
+  * @param  pCrc CRC of the buffer.
+  * @retval HAL status, HAL_BUSY when the hardware path is taken by a DMA transfer
+  */
+HAL_StatusTypeDef BSP_CRC_Compute(BSP_CRC_TypeDef *hcrcsw, const uint8_t *pData, uint32_t Length,
+                                  uint32_t *pCrc)
+{
+  HAL_StatusTypeDef status;
+
+  BSP_CRC_Reset(hcrcsw);
+  status = BSP_CRC_Update(hcrcsw, pData, Length);
+  *pCrc = BSP_CRC_Final(hcrcsw);
+
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC of a buffer bit by bit.
+  * @note   Reference of the other paths, no table and no state.
+  * @param  pModel CRC model.
+  * @param  pData Data.
+  * @param  Length Number of bytes.
+  * @retval CRC
+  */
+uint32_t BSP_CRC_Bitwise(const BSP_CRC_ModelTypeDef *pModel, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t value = CRC_Start(pModel);
+  uint32_t i;
+
+  for (i = 0U; i < Length; i++)
+  {
+    value = CRC_BitwiseStep(pModel, value, pData[i]);
+  }
+
+  return CRC_End(pModel, value);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CRC_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Register of the software paths at the start of a computation.
+  * @note   The register of a reflected model holds the CRC reflected in its
+  *         low bits, the one of the other models the CRC in its high bits.
+  * @param  pModel CRC model.
+  * @retval Register
+  */
+static uint32_t CRC_Start(const BSP_CRC_ModelTypeDef *pModel)
+{
+  uint32_t init = pModel->Init & CRC_MASK(pModel->Width);
+
+  return (pModel->RefIn != 0U) ? CRC_REFLECT(init, pModel->Width) : (init << (32U - pModel->Width));
+}
+
+/**
+  * @brief  CRC from the register of the software paths.
+  * @param  pModel CRC model.
+  * @param  Value Register.
+  * @retval CRC
+  */
+static uint32_t CRC_End(const BSP_CRC_ModelTypeDef *pModel, uint32_t Value)
+{
+  uint32_t crc = (pModel->RefIn != 0U) ? CRC_REFLECT(Value, pModel->Width) : (Value >> (32U - pModel->Width));
+
+  if (pModel->RefOut != 0U)
+  {
+    crc = CRC_REFLECT(crc, pModel->Width);
+  }
+
+  return (crc ^ pModel->XorOut) & CRC_MASK(pModel->Width);
+}
+
+/**
+  * @brief  Shift one byte into the register, bit by bit.
+  * @param  pModel CRC model.
+  * @param  Value Register.
+  * @param  Data Byte.
+  * @retval Register
+  */
+static uint32_t CRC_BitwiseStep(const BSP_CRC_ModelTypeDef *pModel, uint32_t Value, uint32_t Data)
+{
+  uint32_t poly;
+  uint32_t bit;
+
+  if (pModel->RefIn != 0U)
+  {
+    poly   = CRC_REFLECT(pModel->Poly, pModel->Width);
+    Value ^= Data;
+    for (bit = 0U; bit < 8U; bit++)
+    {
+      Value = ((Value & 1U) != 0U) ? ((Value >> 1U) ^ poly) : (Value >> 1U);
+    }
+  }
+  else
+  {
+    poly   = pModel->Poly << (32U - pModel->Width);
+    Value ^= Data << 24U;
+    for (bit = 0U; bit < 8U; bit++)
+    {
+      Value = ((Value & 0x80000000U) != 0U) ? ((Value << 1U) ^ poly) : (Value << 1U);
+    }
+  }
+
+  return Value;
+}
+
+/**
+  * @brief  Table kernel of the reflected models.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @param  Value Register.
+  * @param  pData Data.
+  * @param  Length Number of bytes.
+  * @retval Register
+  */
+static uint32_t CRC_Reflected(const BSP_CRC_TypeDef *hcrcsw, uint32_t Value, const uint8_t *pData, uint32_t Length)
+{
+  const BSP_CRC_TableTypeDef *t = hcrcsw->pTable;
+  uint32_t next;
+
+  if (hcrcsw->Slices == 8U)
+  {
+    for (; Length >= 8U; Length -= 8U)
+    {
+      Value ^= CRC_READ_LE(pData);
+      next   = CRC_READ_LE(pData + 4U);
+      Value  = t[7][Value & 0xFFU] ^ t[6][(Value >> 8U) & 0xFFU] ^
+               t[5][(Value >> 16U) & 0xFFU] ^ t[4][Value >> 24U] ^
+               t[3][next & 0xFFU] ^ t[2][(next >> 8U) & 0xFFU] ^
+               t[1][(next >> 16U) & 0xFFU] ^ t[0][next >> 24U];
+      pData += 8U;
+    }
+  }
+  if (hcrcsw->Slices >= 4U)
+  {
+    for (; Length >= 4U; Length -= 4U)
+    {
+      Value ^= CRC_READ_LE(pData);
+      Value  = t[3][Value & 0xFFU] ^ t[2][(Value >> 8U) & 0xFFU] ^
+               t[1][(Value >> 16U) & 0xFFU] ^ t[0][Value >> 24U];
+      pData += 4U;
+    }
+  }
+  for (; Length != 0U; Length--)
+  {
+    Value = (Value >> 8U) ^ t[0][(Value ^ *pData) & 0xFFU];
+    pData++;
+  }
+
+  return Value;
+}
+
+/**
+  * @brief  Table kernel of the models not reflected.
+  * @param  hcrcsw Pointer to a BSP_CRC_TypeDef structure.
+  * @param  Value Register.
+  * @param  pData Data.
+  * @param  Length Number of bytes.
+  * @retval Register
+  */
+static uint32_t CRC_Normal(const BSP_CRC_TypeDef *hcrcsw, uint32_t Value, const uint8_t *pData, uint32_t Length)
+{
+  const BSP_CRC_TableTypeDef *t = hcrcsw->pTable;
+  uint32_t next;
+
+  if (hcrcsw->Slices == 8U)
+  {
+    for (; Length >= 8U; Length -= 8U)
+    {
+      Value ^= CRC_READ_BE(pData);
+      next   = CRC_READ_BE(pData + 4U);
+      Value  = t[7][Value >> 24U] ^ t[6][(Value >> 16U) & 0xFFU] ^
+               t[5][(Value >> 8U) & 0xFFU] ^ t[4][Value & 0xFFU] ^
+               t[3][next >> 24U] ^ t[2][(next >> 16U) & 0xFFU] ^
+               t[1][(next >> 8U) & 0xFFU] ^ t[0][next & 0xFFU];
+      pData += 8U;
+    }
+  }
+  if (hcrcsw->Slices >= 4U)
+  {
+    for (; Length >= 4U; Length -= 4U)
+    {
+      Value ^= CRC_READ_BE(pData);
+      Value  = t[3][Value >> 24U] ^ t[2][(Value >> 16U) & 0xFFU] ^
+               t[1][(Value >> 8U) & 0xFFU] ^ t[0][Value & 0xFFU];
+      pData += 4U;
+    }
+  }
+  for (; Length != 0U; Length--)
+  {
+    Value = (Value << 8U) ^ t[0][(Value >> 24U) ^ *pData];
+    pData++;
+  }
+
+  return Value;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,348 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crcmux.c
+  * @author  MCU Application Team
+  * @brief   CRC sharing BSP service.
+  *          This file provides functions to run several CRC computations on
+  *          the one CRC calculator:
+  *           + Sessions with their own configuration and running value
+  *           + Context switched only when another session takes the CRC
+  *           + Sessions run from interrupts preempting another one
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the CRC with HAL_CRC_Init() and call BSP_CRCMUX_Init() with
+       it. The CPU computations on the CRC then go through the sessions, the
+       HAL_CRC_Accumulate() and HAL_CRC_Calculate() functions must not be used
+       on it directly.
+
+   (#) Open a session per computation with BSP_CRCMUX_Open(), for instance one
+       for the UART frames, one for the key-value store: each has its
+       CRC_InitTypeDef and input data format, NULL for the default
+       configuration of words fed as they are.
+
+   (#) Feed a session with BSP_CRCMUX_Accumulate(), in as many calls as the
+       data come, and start it again with BSP_CRCMUX_Reset(), or use
+       BSP_CRCMUX_Calculate() for a buffer at once. Calls of the sessions may
+       interleave freely: the context of the session owning the CRC is saved
+       and the one of the next session loaded only when the session changes.
+
+   (#) A session may be used from an interrupt preempting another one: the
+       preempted context is saved and restored around the call. A session is
+       used from one context at a time.
+
+   (#) The DMA users are not preempted: while HAL_CRC_Calculate_DMA() or a
+       slice of BSP_CRCSCAN feeds the CRC, the sessions return HAL_BUSY and
+       the caller calls again later. BSP_CRCSCAN saves and restores the
+       sessions context around each slice.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_crcmux.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CRCMUX BSP CRCMUX
+  * @brief CRC sharing BSP service
+  * @{
+  */
+
+#ifdef HAL_CRC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CRCMUX_Exported_Functions BSP CRCMUX Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_CRCMUX_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                       ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Share a CRC
+      (+) Open and close the sessions
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the sharing of a CRC.
+  * @param  hmux Pointer to a BSP_CRCMUX_TypeDef structure.
+  * @param  hcrc Pointer to a CRC_HandleTypeDef structure initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRCMUX_Init(BSP_CRCMUX_TypeDef *hmux, CRC_HandleTypeDef *hcrc)
+{
+  if ((hmux == NULL) || (hcrc == NULL) || (hcrc->State == HAL_CRC_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+
+  hmux->hcrc     = hcrc;
+  hmux->pOwner   = NULL;
+  hmux->Depth    = 0U;
+  hmux->Switches = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Open a session on a shared CRC.
+  * @param  hmux Pointer to a BSP_CRCMUX_TypeDef structure.
+  * @param  hsession Pointer to a BSP_CRCMUX_SessionTypeDef structure.
+  * @param  pInit Configuration of the session, NULL for the default one.
+  * @param  InputDataFormat Input data format, a value of @ref CRC_Input_Buffer_Format.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRCMUX_Open(BSP_CRCMUX_TypeDef *hmux, BSP_CRCMUX_SessionTypeDef *hsession,
+                                  const CRC_InitTypeDef *pInit, uint32_t InputDataFormat)
+{
+  if ((hmux == NULL) || (hsession == NULL) || (hmux->hcrc == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  assert_param(IS_CRC_INPUTDATA_FORMAT(InputDataFormat));
+
+  if (pInit != NULL)
+  {
+    hsession->Context.Init = *pInit;
+  }
+  else
+  {
+    hsession->Context.Init.DefaultInitValueUse     = DEFAULT_INIT_VALUE_ENABLE;
+    hsession->Context.Init.InitValue               = DEFAULT_CRC_INITVALUE;
+    hsession->Context.Init.InputDataInversionMode  = CRC_INPUTDATA_INVERSION_NONE;
+    hsession->Context.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_DISABLE;
+  }
+  hsession->Context.InputDataFormat = InputDataFormat;
+  hsession->hmux = hmux;
+  BSP_CRCMUX_Reset(hsession);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Close a session.
+  * @param  hsession Pointer to a BSP_CRCMUX_SessionTypeDef structure.
+  * @retval None
+  */
+void BSP_CRCMUX_Close(BSP_CRCMUX_SessionTypeDef *hsession)
+{
+  uint32_t primask_bit;
+
+  if (hsession->hmux == NULL)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hsession->hmux->pOwner == hsession)
+  {
+    hsession->hmux->pOwner = NULL;
+  }
+  hsession->hmux = NULL;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CRCMUX_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                       ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Start a computation again
+      (+) Feed the data of a session
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start the computation of a session again from its initial value.
+  * @param  hsession Pointer to a BSP_CRCMUX_SessionTypeDef structure.
+  * @retval None
+  */
+void BSP_CRCMUX_Reset(BSP_CRCMUX_SessionTypeDef *hsession)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hsession->Context.Value = (hsession->Context.Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_DISABLE) ?
+                            hsession->Context.Init.InitValue : DEFAULT_CRC_INITVALUE;
+  /* The context is loaded again on the next call */
+  if ((hsession->hmux != NULL) && (hsession->hmux->pOwner == hsession))
+  {
+    hsession->hmux->pOwner = NULL;
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Feed data to a session, starting with its running value.
+  * @param  hsession Pointer to a BSP_CRCMUX_SessionTypeDef structure.
+  * @param  pBuffer Data, in the input data format of the session.
+  * @param  BufferLength Number of bytes, half-words or words as the format.
+  * @param  pCrc CRC of the data fed since the last reset, output data
+  *         inversion applied, may be NULL.
+  * @retval HAL status, HAL_BUSY while the DMA feeds the CRC
+  */
+HAL_StatusTypeDef BSP_CRCMUX_Accumulate(BSP_CRCMUX_SessionTypeDef *hsession, uint32_t pBuffer[],
+                                        uint32_t BufferLength, uint32_t *pCrc)
+{
+  BSP_CRCMUX_TypeDef *hmux = hsession->hmux;
+  CRC_ContextTypeDef preempted;
+  HAL_CRC_StateTypeDef state;
+  uint32_t primask_bit;
+  uint32_t depth;
+  uint32_t own;
+  uint32_t crc;
+
+  if (hmux == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hmux->Depth == 0U)
+  {
+    if (hmux->hcrc->State != HAL_CRC_STATE_READY)
+    {
+      __set_PRIMASK(primask_bit);
+      return HAL_BUSY;
+    }
+    hmux->hcrc->State = HAL_CRC_STATE_BUSY;
+
+    /* Switch the context, kept in the CRC while the session goes on */
+    if (hmux->pOwner != hsession)
+    {
+      if (hmux->pOwner != NULL)
+      {
+        (void)HAL_CRC_SaveContext(hmux->hcrc, &hmux->pOwner->Context);
+      }
+      (void)HAL_CRC_RestoreContext(hmux->hcrc, &hsession->Context);
+      hmux->pOwner = hsession;
+      hmux->Switches++;
+    }
+  }
+  hmux->Depth++;
+  depth = hmux->Depth;
+  own   = (hmux->pOwner == hsession) ? 1U : 0U;
+  __set_PRIMASK(primask_bit);
+
+  if ((depth == 1U) || (own != 0U))
+  {
+    /* The CRC holds the context of the session */
+    state = hmux->hcrc->State;
+    crc = HAL_CRC_Accumulate(hmux->hcrc, pBuffer, BufferLength);
+    hmux->hcrc->State = state;
+  }
+  else
+  {
+    /* Preempting another session, the CRC is given back as it was */
+    state = hmux->hcrc->State;
+    (void)HAL_CRC_SaveContext(hmux->hcrc, &preempted);
+    (void)HAL_CRC_RestoreContext(hmux->hcrc, &hsession->Context);
+    crc = HAL_CRC_Accumulate(hmux->hcrc, pBuffer, BufferLength);
+    (void)HAL_CRC_SaveContext(hmux->hcrc, &hsession->Context);
+    (void)HAL_CRC_RestoreContext(hmux->hcrc, &preempted);
+    hmux->hcrc->State = state;
+    hmux->Switches += 2U;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hmux->Depth--;
+  if (hmux->Depth == 0U)
+  {
+    hmux->hcrc->State = HAL_CRC_STATE_READY;
+  }
+  __set_PRIMASK(primask_bit);
+
+  if (pCrc != NULL)
+  {
+    *pCrc = crc;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Compute the CRC of a buffer from the initial value of a session.
+  * @param  hsession Pointer to a BSP_CRCMUX_SessionTypeDef structure.
+  * @param  pBuffer Data, in the input data format of the session.
+  * @param  BufferLength Number of bytes, half-words or words as the format.
+  * @param  pCrc CRC of the buffer, output data inversion applied.
+  * @retval HAL status, HAL_BUSY while the DMA feeds the CRC
+  */
+HAL_StatusTypeDef BSP_CRCMUX_Calculate(BSP_CRCMUX_SessionTypeDef *hsession, uint32_t pBuffer[],
+                                       uint32_t BufferLength, uint32_t *pCrc)
+{
+  if (hsession->hmux == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  BSP_CRCMUX_Reset(hsession);
+
+  return BSP_CRCMUX_Accumulate(hsession, pBuffer, BufferLength, pCrc);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
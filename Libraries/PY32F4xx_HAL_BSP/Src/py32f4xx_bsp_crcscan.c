@@ -0,0 +1,383 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_crcscan.c
+  * @author  MCU Application Team
+  * @brief   Background memory integrity scan BSP service.
+  *          This file provides functions to check the flash contents at run
+  *          time without CPU load:
+  *           + Memory to memory DMA from the flash to the CRC data register
+  *           + Scan in slices, one per call from the idle loop
+  *           + Checksum reported at the end of each scan
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the CRC with HAL_CRC_Init(). Enable the DMA clock, set the
+       Instance of a DMA_HandleTypeDef to a free channel and enable its
+       interrupt in the NVIC, calling HAL_DMA_IRQHandler() from the channel
+       handler.
+
+   (#) Call BSP_CRCSCAN_Init() with the area to check, for instance
+       FLASH_BASE and the image size, and the slice size. The channel is
+       configured here in memory to memory mode, word to word, into the CRC
+       data register.
+
+   (#) Call BSP_CRCSCAN_Start() to start a scan, then BSP_CRCSCAN_Process()
+       from the idle loop: it starts the next slice when the previous one is
+       over. The CPU only runs a few instructions per slice, the DMA shares
+       the bus with it while the slice runs.
+
+   (#) At the end of a scan BSP_CRCSCAN_CpltCallback() is called from the DMA
+       interrupt with the checksum, also kept in Crc: it is the same value as
+       HAL_CRC_Calculate() over the area. Start again for a periodic check.
+
+   (#) The CRC is only taken while a slice runs: the context of the other
+       users is saved when the slice starts and restored at its end, the scan
+       keeps its own value in between. A slice is not started while the CRC
+       handle is busy, and the CPU must not feed the CRC while a slice runs:
+       the sessions of BSP_CRCMUX return HAL_BUSY then. The slice size sets
+       how long the CRC is taken and how long Stop waits for the DMA.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_crcscan.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CRCSCAN BSP CRCSCAN
+  * @brief Background memory integrity scan BSP service
+  * @{
+  */
+
+#if defined (HAL_CRC_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_CRCSCAN_Private_Functions
+  * @{
+  */
+static void CRCSCAN_DMACplt(DMA_HandleTypeDef *hdma);
+static void CRCSCAN_DMAError(DMA_HandleTypeDef *hdma);
+static void CRCSCAN_Release(BSP_CRCSCAN_TypeDef *hscan);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CRCSCAN_Exported_Functions BSP CRCSCAN Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_CRCSCAN_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Set the scanned area and configure the DMA channel
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a scan.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @param  hcrc Pointer to a CRC_HandleTypeDef structure initialized.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure with its Instance set.
+  * @param  Address First byte of the area, word aligned.
+  * @param  Size Area size in bytes, a multiple of 4.
+  * @param  SliceSize Bytes per DMA transfer, a multiple of 4 up to 0x3FFFC.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRCSCAN_Init(BSP_CRCSCAN_TypeDef *hscan, CRC_HandleTypeDef *hcrc, DMA_HandleTypeDef *hdma,
+                                   uint32_t Address, uint32_t Size, uint32_t SliceSize)
+{
+  if ((hscan == NULL) || (hcrc == NULL) || (hdma == NULL) || ((Address & 3U) != 0U) ||
+      (Size == 0U) || ((Size & 3U) != 0U) || (SliceSize == 0U) || ((SliceSize & 3U) != 0U) ||
+      ((SliceSize / 4U) > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+  if ((hscan->State == BSP_CRCSCAN_STATE_RUN) || (hscan->Busy != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  hdma->Init.Direction           = DMA_MEMORY_TO_MEMORY;
+  hdma->Init.PeriphInc           = DMA_PINC_ENABLE;     /* Source, the scanned area */
+  hdma->Init.MemInc              = DMA_MINC_DISABLE;    /* Destination, the CRC data register */
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+  hdma->Init.Mode                = DMA_NORMAL;
+  hdma->Init.Priority            = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  hdma->Parent               = hscan;
+  hdma->XferCpltCallback     = CRCSCAN_DMACplt;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferErrorCallback    = CRCSCAN_DMAError;
+  hdma->XferAbortCallback    = NULL;
+
+  hscan->hcrc      = hcrc;
+  hscan->hdma      = hdma;
+  hscan->Address   = Address;
+  hscan->Size      = Size / 4U;
+  hscan->SliceSize = SliceSize / 4U;
+  hscan->Offset    = 0U;
+  hscan->Busy      = 0U;
+  hscan->Value     = DEFAULT_CRC_INITVALUE;
+  hscan->Crc       = 0U;
+  hscan->ScanCount = 0U;
+  hscan->State     = BSP_CRCSCAN_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CRCSCAN_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                       ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Start and stop a scan
+      (+) Run the scan from the idle loop
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start a scan of the area.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRCSCAN_Start(BSP_CRCSCAN_TypeDef *hscan)
+{
+  if (hscan->State == BSP_CRCSCAN_STATE_RESET)
+  {
+    return HAL_ERROR;
+  }
+  if ((hscan->State == BSP_CRCSCAN_STATE_RUN) || (hscan->Busy != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  hscan->Value  = DEFAULT_CRC_INITVALUE;
+  hscan->Offset = 0U;
+  hscan->State  = BSP_CRCSCAN_STATE_RUN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the next slice of the running scan.
+  * @note   To be called from the idle loop, returns at once when a slice runs
+  *         or when the CRC is busy.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @retval State, a value of @ref BSP_CRCSCAN_State
+  */
+uint32_t BSP_CRCSCAN_Process(BSP_CRCSCAN_TypeDef *hscan)
+{
+  CRC_ContextTypeDef scan = {0};
+  uint32_t primask_bit;
+  uint32_t length;
+
+  if ((hscan->State != BSP_CRCSCAN_STATE_RUN) || (hscan->Busy != 0U))
+  {
+    return hscan->State;
+  }
+
+  /* Take the CRC for the slice */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hscan->hcrc->State != HAL_CRC_STATE_READY)
+  {
+    __set_PRIMASK(primask_bit);
+    return hscan->State;
+  }
+  hscan->hcrc->State = HAL_CRC_STATE_BUSY;
+  hscan->Busy = 1U;
+  __set_PRIMASK(primask_bit);
+
+  (void)HAL_CRC_SaveContext(hscan->hcrc, &hscan->Suspended);
+  scan.Value = hscan->Value;
+  (void)HAL_CRC_RestoreContext(hscan->hcrc, &scan);
+
+  length = hscan->Size - hscan->Offset;
+  if (length > hscan->SliceSize)
+  {
+    length = hscan->SliceSize;
+  }
+  if (HAL_DMA_Start_IT(hscan->hdma, hscan->Address + (hscan->Offset * 4U),
+                       (uint32_t)&hscan->hcrc->Instance->DR, length) != HAL_OK)
+  {
+    CRCSCAN_Release(hscan);
+  }
+
+  return hscan->State;
+}
+
+/**
+  * @brief  Stop the running scan, its result is dropped.
+  * @note   Waits for the end of the slice transfer.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CRCSCAN_Stop(BSP_CRCSCAN_TypeDef *hscan)
+{
+  if (hscan->State != BSP_CRCSCAN_STATE_RUN)
+  {
+    return HAL_OK;
+  }
+
+  hscan->State = BSP_CRCSCAN_STATE_READY;
+  if (hscan->Busy != 0U)
+  {
+    (void)HAL_DMA_Abort(hscan->hdma);
+    CRCSCAN_Release(hscan);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Scan complete callback.
+  * @note   Called from the DMA interrupt.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @param  Crc Checksum of the area.
+  * @retval None
+  */
+__weak void BSP_CRCSCAN_CpltCallback(BSP_CRCSCAN_TypeDef *hscan, uint32_t Crc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hscan);
+  UNUSED(Crc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_CRCSCAN_CpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CRCSCAN_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  DMA complete callback, one slice is fed to the CRC.
+  * @param  hdma Pointer to the DMA handle of the scan.
+  * @retval None
+  */
+static void CRCSCAN_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_CRCSCAN_TypeDef *hscan = (BSP_CRCSCAN_TypeDef *)hdma->Parent;
+  uint32_t length;
+
+  if ((hscan->State != BSP_CRCSCAN_STATE_RUN) || (hscan->Busy == 0U))
+  {
+    return;
+  }
+
+  length = hscan->Size - hscan->Offset;
+  if (length > hscan->SliceSize)
+  {
+    length = hscan->SliceSize;
+  }
+  hscan->Offset += length;
+  hscan->Value   = hscan->hcrc->Instance->DR;
+  CRCSCAN_Release(hscan);
+
+  if (hscan->Offset == hscan->Size)
+  {
+    hscan->Crc = hscan->Value;
+    hscan->ScanCount++;
+    hscan->State = BSP_CRCSCAN_STATE_DONE;
+    BSP_CRCSCAN_CpltCallback(hscan, hscan->Crc);
+  }
+}
+
+/**
+  * @brief  DMA error callback, the scan is stopped.
+  * @param  hdma Pointer to the DMA handle of the scan.
+  * @retval None
+  */
+static void CRCSCAN_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_CRCSCAN_TypeDef *hscan = (BSP_CRCSCAN_TypeDef *)hdma->Parent;
+
+  if (hscan->State == BSP_CRCSCAN_STATE_RUN)
+  {
+    CRCSCAN_Release(hscan);
+    hscan->State = BSP_CRCSCAN_STATE_ERROR;
+  }
+}
+
+/**
+  * @brief  Give the CRC back at the end of a slice.
+  * @note   The context of the other users is restored.
+  * @param  hscan Pointer to a BSP_CRCSCAN_TypeDef structure.
+  * @retval None
+  */
+static void CRCSCAN_Release(BSP_CRCSCAN_TypeDef *hscan)
+{
+  (void)HAL_CRC_RestoreContext(hscan->hcrc, &hscan->Suspended);
+  hscan->Busy = 0U;
+  hscan->hcrc->State = HAL_CRC_STATE_READY;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
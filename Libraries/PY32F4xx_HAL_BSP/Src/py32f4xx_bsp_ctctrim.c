@@ -0,0 +1,504 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ctctrim.c
+  * @author  MCU Application Team
+  * @brief   HSI48M trimming BSP service.
+  *          This file provides functions to keep the HSI48M on its frequency
+  *          with the CTC, without a crystal on the high speed side:
+  *           + Reload and limit computed from the reference frequency
+  *           + Trim value updated by the CTC, or by the interrupt in a
+  *             window of values
+  *           + Convergence tracked from the error of each period
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The HSI48M drifts over the temperature by more than a UART at a high
+       baud rate or a CAN bit timing allows. The CTC counts the HSI48M over
+       the periods of a reference, the LSE, the USB SOF or a pulse on a
+       GPIO, and trims it. This service runs the CTC in the background and
+       tells when the HSI48M is in its limit.
+
+   (#) Enable the HSI48M and the CTC clock with __HAL_RCC_CTC_CLK_ENABLE(),
+       the reference running, and the RCC_CTC_IRQn interrupt calling
+       BSP_CTCTRIM_IRQHandler(), next to HAL_RCC_IRQHandler() when the RCC
+       interrupts are used as well. Set Instance, Init.RefCLKSource,
+       Init.RefCLKDivider and Init.RefCLKPolarity of the CTC handle and call
+       BSP_CTCTRIM_Init() with the frequency of the reference before the
+       divider: the service computes ReloadValue and LimitValue, the limit
+       half a trim step of BSP_CTCTRIM_STEP_PPM. A period must be 2 to 65536
+       cycles of the HSI48M: divide the LSE by 32 at most, 1464 cycles undivided.
+       Longer periods measure finer and trim slower.
+
+   (#) BSP_CTCTRIM_MODE_HARDWARE lets the CTC update the trim value on a
+       warning. BSP_CTCTRIM_MODE_SOFTWARE updates it in the interrupt by the
+       steps measured, a large error corrected in one period, and keeps it
+       in the window of BSP_CTCTRIM_SetWindow(), where the board is known to
+       work.
+
+   (#) BSP_CTCTRIM_Start() starts from the trim value of the CTC: write a
+       value saved before with HAL_CTC_ConfigTrimValue() to converge sooner.
+       After BSP_CTCTRIM_LOCK_PERIODS periods in the limit in a row the
+       state is BSP_CTCTRIM_STATE_LOCKED and BSP_CTCTRIM_LockCallback() is
+       called with Locked 1. A warning keeps the lock, the drift being
+       trimmed, an error out of 3 times the limit or a missed reference
+       pulse drops it, Locked 0. Without its reference the state is
+       BSP_CTCTRIM_STATE_NOREF, the trim value held, until the next period.
+
+   (#) BSP_CTCTRIM_GetErrorPpm() gives the error of the last period and
+       BSP_CTCTRIM_GetStats() the counts of periods, warnings, errors, missed
+       pulses and saturations of the trim value.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_ctctrim.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CTCTRIM BSP CTCTRIM
+  * @brief HSI48M trimming BSP service
+  * @{
+  */
+
+#if defined (HAL_CTC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CTCTRIM_Private_Constants BSP CTCTRIM Private Constants
+  * @{
+  */
+#define CTCTRIM_TRIM_MAX                0x7FU          /* TRIMVALUE field                             */
+#define CTCTRIM_FLAGS                   (CTC_SR_CKOKIF | CTC_SR_CKWARNIF | CTC_SR_ERRIF | CTC_SR_EREFIF)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CTCTRIM_Private_Functions BSP CTCTRIM Private Functions
+  * @{
+  */
+static void CTCTRIM_Period(BSP_CTCTRIM_TypeDef *htrim, uint32_t Status);
+static void CTCTRIM_Software(BSP_CTCTRIM_TypeDef *htrim, int32_t Error);
+static void CTCTRIM_Unlock(BSP_CTCTRIM_TypeDef *htrim);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CTCTRIM_Exported_Functions BSP CTCTRIM Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Compute the reload and the limit and initialize the CTC.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  hctc CTC handle, the reference source, divider and polarity set.
+  * @param  Mode A value of @ref BSP_CTCTRIM_Mode.
+  * @param  RefFreq Frequency of the reference before the divider, Hz.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTCTRIM_Init(BSP_CTCTRIM_TypeDef *htrim, CTC_HandleTypeDef *hctc, uint32_t Mode,
+                                   uint32_t RefFreq)
+{
+  uint32_t div;
+  uint64_t cycles;
+  uint64_t limit;
+
+  if ((htrim == NULL) || (hctc == NULL) || (RefFreq == 0U) || (Mode > BSP_CTCTRIM_MODE_SOFTWARE))
+  {
+    return HAL_ERROR;
+  }
+
+  div = 1UL << ((hctc->Init.RefCLKDivider & CTC_CTL1_REFPSC) >> CTC_CTL1_REFPSC_Pos);
+  cycles = (((uint64_t)BSP_CTCTRIM_HSI48M_VALUE * div) + (RefFreq / 2U)) / RefFreq;
+  if ((cycles < 2U) || (cycles > 0x10000U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Half a trim step, a period in the limit is not trimmed */
+  limit = ((cycles * BSP_CTCTRIM_STEP_PPM) + 1000000U) / 2000000U;
+  if (limit == 0U)
+  {
+    limit = 1U;
+  }
+  else if (limit > 0xFFU)
+  {
+    limit = 0xFFU;
+  }
+
+  htrim->hctc    = hctc;
+  htrim->Mode    = Mode;
+  htrim->Reload  = (uint32_t)cycles - 1U;
+  htrim->Limit   = (uint32_t)limit;
+  htrim->TrimMin = 0U;
+  htrim->TrimMax = CTCTRIM_TRIM_MAX;
+  htrim->Error   = 0;
+  htrim->Good    = 0U;
+  htrim->Stats.Periods     = 0U;
+  htrim->Stats.Warnings    = 0U;
+  htrim->Stats.Errors      = 0U;
+  htrim->Stats.Misses      = 0U;
+  htrim->Stats.Saturations = 0U;
+  htrim->Stats.Locks       = 0U;
+  htrim->Stats.Unlocks     = 0U;
+
+  hctc->Init.AutoTrim    = (Mode == BSP_CTCTRIM_MODE_HARDWARE) ? CTC_AUTO_TRIM_ENABLE : CTC_AUTO_TRIM_DISABLE;
+  hctc->Init.ReloadValue = htrim->Reload;
+  hctc->Init.LimitValue  = htrim->Limit;
+  if (HAL_CTC_Init(hctc) != HAL_OK)
+  {
+    htrim->State = BSP_CTCTRIM_STATE_RESET;
+    return HAL_ERROR;
+  }
+
+  htrim->State = BSP_CTCTRIM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the trim values allowed in the software mode.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  TrimMin Lowest trim value, 0 to TrimMax.
+  * @param  TrimMax Highest trim value, up to 0x7F.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTCTRIM_SetWindow(BSP_CTCTRIM_TypeDef *htrim, uint32_t TrimMin, uint32_t TrimMax)
+{
+  if ((TrimMin > TrimMax) || (TrimMax > CTCTRIM_TRIM_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if (htrim->State != BSP_CTCTRIM_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  htrim->TrimMin = TrimMin;
+  htrim->TrimMax = TrimMax;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the trimming in the background.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTCTRIM_Start(BSP_CTCTRIM_TypeDef *htrim)
+{
+  uint32_t trim;
+
+  if (htrim->State != BSP_CTCTRIM_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The software mode starts in its window */
+  if (htrim->Mode == BSP_CTCTRIM_MODE_SOFTWARE)
+  {
+    trim = HAL_CTC_GetTrimValue(htrim->hctc);
+    if (trim < htrim->TrimMin)
+    {
+      trim = htrim->TrimMin;
+    }
+    else if (trim > htrim->TrimMax)
+    {
+      trim = htrim->TrimMax;
+    }
+    (void)HAL_CTC_ConfigTrimValue(htrim->hctc, (uint8_t)trim);
+  }
+
+  htrim->Error = 0;
+  htrim->Good  = 0U;
+  htrim->State = BSP_CTCTRIM_STATE_ACQUIRE;
+
+  if (HAL_CTC_Start_IT(htrim->hctc) != HAL_OK)
+  {
+    htrim->State = BSP_CTCTRIM_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  /* The period flags are enough, no interrupt on each expected reference */
+  __HAL_CTC_DISABLE_IT(htrim->hctc, CTC_IT_EREF);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the trimming, the trim value kept.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTCTRIM_Stop(BSP_CTCTRIM_TypeDef *htrim)
+{
+  if ((htrim->State == BSP_CTCTRIM_STATE_RESET) || (htrim->State == BSP_CTCTRIM_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_CTC_Stop_IT(htrim->hctc);
+  WRITE_REG(htrim->hctc->Instance->INTC, CTCTRIM_FLAGS);
+  htrim->State = BSP_CTCTRIM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the state of the trimming.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval A value of @ref BSP_CTCTRIM_State
+  */
+uint32_t BSP_CTCTRIM_GetState(const BSP_CTCTRIM_TypeDef *htrim)
+{
+  return htrim->State;
+}
+
+/**
+  * @brief  Return the trim value of the HSI48M, to save for the next start.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval Trim value, 0 to 0x7F
+  */
+uint32_t BSP_CTCTRIM_GetTrim(const BSP_CTCTRIM_TypeDef *htrim)
+{
+  return HAL_CTC_GetTrimValue(htrim->hctc);
+}
+
+/**
+  * @brief  Return the error of the last period.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval Error in ppm, positive when the HSI48M is fast
+  */
+int32_t BSP_CTCTRIM_GetErrorPpm(const BSP_CTCTRIM_TypeDef *htrim)
+{
+  return (int32_t)(((int64_t)htrim->Error * 1000000) / (int64_t)(htrim->Reload + 1U));
+}
+
+/**
+  * @brief  Copy the statistics of the trimming.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CTCTRIM_GetStats(const BSP_CTCTRIM_TypeDef *htrim, BSP_CTCTRIM_StatsTypeDef *pStats)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *pStats = htrim->Stats;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CTC interrupt, the end of a reference period.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval None
+  */
+void BSP_CTCTRIM_IRQHandler(BSP_CTCTRIM_TypeDef *htrim)
+{
+  uint32_t status = READ_REG(htrim->hctc->Instance->SR);
+
+  if ((status & CTCTRIM_FLAGS) == 0U)
+  {
+    return;
+  }
+
+  /* INTC bits at the places of the SR flags */
+  WRITE_REG(htrim->hctc->Instance->INTC, status & CTCTRIM_FLAGS);
+
+  if ((htrim->State == BSP_CTCTRIM_STATE_RESET) || (htrim->State == BSP_CTCTRIM_STATE_READY))
+  {
+    return;
+  }
+
+  if ((status & CTC_SR_TRIMERR) != 0U)
+  {
+    htrim->Stats.Saturations++;
+  }
+
+  if ((status & CTC_SR_REFMISS) != 0U)
+  {
+    htrim->Stats.Misses++;
+    htrim->Good = 0U;
+    CTCTRIM_Unlock(htrim);
+    htrim->State = BSP_CTCTRIM_STATE_NOREF;
+  }
+  else if ((status & (CTC_SR_CKOKIF | CTC_SR_CKWARNIF | CTC_SR_CKERR)) != 0U)
+  {
+    CTCTRIM_Period(htrim, status);
+  }
+  else
+  {
+    /* Expected reference only */
+  }
+}
+
+/**
+  * @brief  Lock callback, on a change of the convergence.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  Locked 1 when the state turned BSP_CTCTRIM_STATE_LOCKED, 0 when it left it.
+  * @retval None
+  */
+__weak void BSP_CTCTRIM_LockCallback(BSP_CTCTRIM_TypeDef *htrim, uint32_t Locked)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrim);
+  UNUSED(Locked);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_CTCTRIM_LockCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CTCTRIM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Account a measured period and track the convergence.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  Status SR of the period.
+  * @retval None
+  */
+static void CTCTRIM_Period(BSP_CTCTRIM_TypeDef *htrim, uint32_t Status)
+{
+  int32_t error = (int32_t)((Status & CTC_SR_REFCAP) >> CTC_SR_REFCAP_Pos);
+
+  /* Still counting down at the pulse, fewer cycles than the reload: slow */
+  if ((Status & CTC_SR_REFDIR) != 0U)
+  {
+    error = -error;
+  }
+
+  htrim->Error = error;
+  htrim->Stats.Periods++;
+
+  if (htrim->State == BSP_CTCTRIM_STATE_NOREF)
+  {
+    htrim->State = BSP_CTCTRIM_STATE_ACQUIRE;
+  }
+
+  if ((Status & CTC_SR_CKERR) != 0U)
+  {
+    htrim->Stats.Errors++;
+    htrim->Good = 0U;
+    CTCTRIM_Unlock(htrim);
+  }
+  else if ((Status & CTC_SR_CKWARNIF) != 0U)
+  {
+    htrim->Stats.Warnings++;
+    htrim->Good = 0U;
+  }
+  else
+  {
+    htrim->Good++;
+    if ((htrim->State == BSP_CTCTRIM_STATE_ACQUIRE) && (htrim->Good >= BSP_CTCTRIM_LOCK_PERIODS))
+    {
+      htrim->State = BSP_CTCTRIM_STATE_LOCKED;
+      htrim->Stats.Locks++;
+      BSP_CTCTRIM_LockCallback(htrim, 1U);
+    }
+  }
+
+  if (htrim->Mode == BSP_CTCTRIM_MODE_SOFTWARE)
+  {
+    CTCTRIM_Software(htrim, error);
+  }
+}
+
+/**
+  * @brief  Step the trim value by the error of the period, in the window.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @param  Error Error of the period, HSI48M cycles, positive fast.
+  * @retval None
+  */
+static void CTCTRIM_Software(BSP_CTCTRIM_TypeDef *htrim, int32_t Error)
+{
+  uint32_t magnitude = (uint32_t)((Error < 0) ? -Error : Error);
+  int32_t trim;
+  int32_t steps;
+
+  if (magnitude <= htrim->Limit)
+  {
+    return;
+  }
+
+  /* A step is twice the limit, rounded to the nearest */
+  steps = (int32_t)((magnitude + htrim->Limit) / (2U * htrim->Limit));
+  trim = (int32_t)((htrim->hctc->Instance->CTL0 & CTC_CTL0_TRIMVALUE) >> CTC_CTL0_TRIMVALUE_Pos);
+  trim = (Error > 0) ? (trim - steps) : (trim + steps);
+
+  if (trim < (int32_t)htrim->TrimMin)
+  {
+    trim = (int32_t)htrim->TrimMin;
+    htrim->Stats.Saturations++;
+  }
+  else if (trim > (int32_t)htrim->TrimMax)
+  {
+    trim = (int32_t)htrim->TrimMax;
+    htrim->Stats.Saturations++;
+  }
+  else
+  {
+    /* In the window */
+  }
+
+  MODIFY_REG(htrim->hctc->Instance->CTL0, CTC_CTL0_TRIMVALUE, (uint32_t)trim << CTC_CTL0_TRIMVALUE_Pos);
+}
+
+/**
+  * @brief  Leave the locked state.
+  * @param  htrim Pointer to a BSP_CTCTRIM_TypeDef structure.
+  * @retval None
+  */
+static void CTCTRIM_Unlock(BSP_CTCTRIM_TypeDef *htrim)
+{
+  if (htrim->State == BSP_CTCTRIM_STATE_LOCKED)
+  {
+    htrim->State = BSP_CTCTRIM_STATE_ACQUIRE;
+    htrim->Stats.Unlocks++;
+    BSP_CTCTRIM_LockCallback(htrim, 0U);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CTC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1005 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ctrl.c
+  * @author  MCU Application Team
+  * @brief   Control loop BSP service.
+  *          This file provides functions to run control loops at fixed rates
+  *          from one timer:
+  *           + PID with feed-forward, anti-windup and filtered derivative, in
+  *             float and Q31
+  *           + First order low-pass filters, in float and Q31
+  *           + Rate monotonic scheduler of the loops on a timer update, the
+  *             faster rates preempting the slower ones
+  *           + Overruns, budget overruns, execution and response cycles of
+  *             each loop
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) PID: fill a BSP_CTRL_PID_ConfigTypeDef with the gains, the sampling
+       period Ts, the time constant Tf of the derivative filter and the
+       output limits, and call BSP_CTRL_PID_F32_Init() or
+       BSP_CTRL_PID_Q31_Init(): the discrete coefficients are computed there
+       once. Then call BSP_CTRL_PID_xxx_Update() every Ts with the setpoint,
+       the measure and the feed-forward input, 0 for none.
+      (+) The output is Kp e + I + D + Kff ff, limited to [OutMin, OutMax].
+      (+) The integral grows by Ki Ts e and holds while the output is limited
+          in the direction of the error, then stays in the limits: no
+          windup.
+      (+) The derivative is taken on the measure, not on the error, so that
+          a step of the setpoint does not kick the output, and filtered by a
+          first order low-pass of time constant Tf.
+      (+) Before closing the loop, or to switch from a manual output without
+          a bump, BSP_CTRL_PID_xxx_Reset() loads the integral with the output
+          and the previous measure with the current one.
+
+   (#) The Q31 controller works on values normalized to [-1, 1). Its gains
+       share a scale 2^Shift, the smallest above all of them, up to 2^15:
+       the products are kept in 64 bits, SMLAL, and shifted once, the
+       integral is kept in 64 bits so that a small Ki Ts is not lost. The
+       error and the measure difference use the saturating __QSUB. An update
+       takes the same cycles whatever the values, with no division.
+
+   (#) Filters: BSP_CTRL_LPF_xxx_Init() with the sampling period Ts, the time
+       constant Tc and the initial output, then BSP_CTRL_LPF_xxx_Process()
+       once per sample. For higher orders use the biquads of the DSP
+       service.
+
+   (#) Scheduler: initialize a timer with HAL_TIM_Base_Init(), its update
+       being the base rate of the loops, 10 kHz for example, and enable its
+       interrupt in the NVIC. Call BSP_CTRL_SchedInit() with it. In the
+       TIMx_IRQHandler() call BSP_CTRL_SchedTimerIRQHandler() instead of
+       HAL_TIM_IRQHandler().
+
+   (#) Level 0 is the timer interrupt. For levels 1 to BSP_CTRL_LEVELS - 1
+       call BSP_CTRL_SchedSetLevel() with an IRQ of a peripheral left unused,
+       only pended by software, and a preemption priority lower than the one
+       of the level above. With the vector table in SRAM,
+       USE_VECT_TAB_RAM=y, the handler is installed, otherwise call
+       BSP_CTRL_SchedLevelIRQHandler() with the level from the handler of
+       the IRQ in py32f4xx_it.c.
+
+   (#) BSP_CTRL_SchedAddLoop() links a loop with its period in timer updates,
+       its budget in CPU cycles, 0 for none, and its function. At
+       BSP_CTRL_SchedStart() the loops are ordered by rate: the fastest one
+       runs in the timer interrupt, each slower rate at the next level
+       configured, the rates left sharing the last one, run fastest first.
+       All the loops are released on the first update then every period.
+
+   (#) A release of a loop whose previous run is not completed is dropped
+       and counted in its overruns: the loop runs late once, not twice. A
+       run longer than the budget is counted too. BSP_CTRL_SchedGetStats()
+       gives the runs and their cycles, counted by the DWT, the time of the
+       loops and of the timer interrupt preempting the run excluded, and the
+       longest response from the release, the preemptions included.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "py32f4xx_bsp_ctrl.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_CTRL BSP CTRL
+  * @brief Control loop BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Private_Types BSP CTRL Private Types
+  * @{
+  */
+/**
+  * @brief  Scheduler level definition
+  */
+typedef struct
+{
+  IRQn_Type               IRQn;         /*!< Spare IRQ pended by the timer interrupt                */
+
+  uint32_t                Priority;     /*!< Preemption priority                                    */
+
+  uint32_t                Ready;        /*!< 1 when configured                                      */
+
+} CTRL_LevelTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Private_Constants BSP CTRL Private Constants
+  * @{
+  */
+#define CTRL_Q31_ONE                    0x7FFFFFFF     /* Largest Q31                                 */
+#define CTRL_SHIFT_MAX                  15U            /* Largest scale of the Q31 gains              */
+#define CTRL_IPSR_MASK                  0x000001FFU    /* Exception number of IPSR                    */
+#define CTRL_IRQ_EXC                    16U            /* Exception number of IRQn 0                  */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Private_Variables BSP CTRL Private Variables
+  * @{
+  */
+static TIM_HandleTypeDef *CTRL_htim;
+static BSP_CTRL_LoopTypeDef *CTRL_pLoops;
+static BSP_CTRL_LoopTypeDef *CTRL_pFirst[BSP_CTRL_LEVELS];
+static CTRL_LevelTypeDef CTRL_Levels[BSP_CTRL_LEVELS];
+static uint32_t CTRL_Started;
+static uint32_t CTRL_Inner;             /* Cycles of the runs preempting the current one */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_CTRL_Private_Functions BSP CTRL Private Functions
+  * @{
+  */
+static int32_t CTRL_SatQ31(int64_t Value);
+static int32_t CTRL_ToQ31(float Value);
+static void    CTRL_Run(BSP_CTRL_LoopTypeDef *pLoop);
+static void    CTRL_RunLevel(uint32_t Level);
+static void    CTRL_Handler(void);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_CTRL_Exported_Functions BSP CTRL Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_CTRL_Exported_Functions_Group1 Controller functions
+  * @brief    PID controllers
+  *
+@verbatim
+ ===============================================================================
+                      ##### Controller functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Compute the coefficients of a PID from its configuration
+      (+) Reset its state for a bumpless start
+      (+) Run one step of the PID
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Compute the coefficients of a float PID and clear its state.
+  * @param  hpid Pointer to a BSP_CTRL_PID_F32_TypeDef structure.
+  * @param  pConfig Gains, periods and limits.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTRL_PID_F32_Init(BSP_CTRL_PID_F32_TypeDef *hpid, const BSP_CTRL_PID_ConfigTypeDef *pConfig)
+{
+  if ((hpid == NULL) || (pConfig == NULL) || !(pConfig->Ts > 0.0f) || (pConfig->Tf < 0.0f) ||
+      !(pConfig->OutMin < pConfig->OutMax))
+  {
+    return HAL_ERROR;
+  }
+
+  hpid->Kp     = pConfig->Kp;
+  hpid->Ki     = pConfig->Ki * pConfig->Ts;
+  hpid->Kd     = pConfig->Kd / (pConfig->Tf + pConfig->Ts);
+  hpid->Ad     = pConfig->Tf / (pConfig->Tf + pConfig->Ts);
+  hpid->Kff    = pConfig->Kff;
+  hpid->OutMin = pConfig->OutMin;
+  hpid->OutMax = pConfig->OutMax;
+  BSP_CTRL_PID_F32_Reset(hpid, 0.0f, 0.0f);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Reset the state of a float PID.
+  * @param  hpid Pointer to a BSP_CTRL_PID_F32_TypeDef structure.
+  * @param  Measure Current measure, the derivative starts from it.
+  * @param  Output Current output, loaded in the integral.
+  * @retval None
+  */
+void BSP_CTRL_PID_F32_Reset(BSP_CTRL_PID_F32_TypeDef *hpid, float Measure, float Output)
+{
+  if (Output > hpid->OutMax)
+  {
+    Output = hpid->OutMax;
+  }
+  else if (Output < hpid->OutMin)
+  {
+    Output = hpid->OutMin;
+  }
+
+  hpid->Integral    = Output;
+  hpid->Derivative  = 0.0f;
+  hpid->PrevMeasure = Measure;
+}
+
+/**
+  * @brief  Run one step of a float PID.
+  * @param  hpid Pointer to a BSP_CTRL_PID_F32_TypeDef structure.
+  * @param  Setpoint Setpoint.
+  * @param  Measure Measure.
+  * @param  FeedForward Feed-forward input, multiplied by Kff.
+  * @retval Output, in [OutMin, OutMax]
+  */
+float BSP_CTRL_PID_F32_Update(BSP_CTRL_PID_F32_TypeDef *hpid, float Setpoint, float Measure, float FeedForward)
+{
+  float error = Setpoint - Measure;
+  float integral = hpid->Integral + (hpid->Ki * error);
+  float output;
+
+  hpid->Derivative  = (hpid->Ad * hpid->Derivative) - (hpid->Kd * (Measure - hpid->PrevMeasure));
+  hpid->PrevMeasure = Measure;
+
+  output = (hpid->Kp * error) + (hpid->Kff * FeedForward) + hpid->Derivative + integral;
+
+  /* The integral holds while the output is limited in the direction of its change */
+  if (output > hpid->OutMax)
+  {
+    if (integral > hpid->Integral)
+    {
+      integral = hpid->Integral;
+    }
+    output = hpid->OutMax;
+  }
+  else if (output < hpid->OutMin)
+  {
+    if (integral < hpid->Integral)
+    {
+      integral = hpid->Integral;
+    }
+    output = hpid->OutMin;
+  }
+
+  if (integral > hpid->OutMax)
+  {
+    integral = hpid->OutMax;
+  }
+  else if (integral < hpid->OutMin)
+  {
+    integral = hpid->OutMin;
+  }
+  hpid->Integral = integral;
+
+  return output;
+}
+
+/**
+  * @brief  Compute the coefficients of a Q31 PID and clear its state.
+  * @param  hpid Pointer to a BSP_CTRL_PID_Q31_TypeDef structure.
+  * @param  pConfig Gains, periods and limits, the limits in [-1, 1].
+  * @retval HAL status, HAL_ERROR when a gain is 2^15 or above
+  */
+HAL_StatusTypeDef BSP_CTRL_PID_Q31_Init(BSP_CTRL_PID_Q31_TypeDef *hpid, const BSP_CTRL_PID_ConfigTypeDef *pConfig)
+{
+  float gains[4];
+  float largest = 0.0f;
+  float scale;
+  uint32_t shift;
+  uint32_t i;
+
+  if ((hpid == NULL) || (pConfig == NULL) || !(pConfig->Ts > 0.0f) || (pConfig->Tf < 0.0f) ||
+      !(pConfig->OutMin < pConfig->OutMax) || (pConfig->OutMin < -1.0f) || (pConfig->OutMax > 1.0f))
+  {
+    return HAL_ERROR;
+  }
+
+  gains[0] = pConfig->Kp;
+  gains[1] = pConfig->Ki * pConfig->Ts;
+  gains[2] = pConfig->Kd / (pConfig->Tf + pConfig->Ts);
+  gains[3] = pConfig->Kff;
+  for (i = 0U; i < 4U; i++)
+  {
+    if (fabsf(gains[i]) > largest)
+    {
+      largest = fabsf(gains[i]);
+    }
+  }
+  for (shift = 0U; (shift <= CTRL_SHIFT_MAX) && (largest >= (float)(1UL << shift)); shift++)
+  {
+  }
+  if (shift > CTRL_SHIFT_MAX)
+  {
+    return HAL_ERROR;
+  }
+
+  scale = 1.0f / (float)(1UL << shift);
+  hpid->Kp     = CTRL_ToQ31(gains[0] * scale);
+  hpid->Ki     = CTRL_ToQ31(gains[1] * scale);
+  hpid->Kd     = CTRL_ToQ31(gains[2] * scale);
+  hpid->Kff    = CTRL_ToQ31(gains[3] * scale);
+  hpid->Ad     = CTRL_ToQ31(pConfig->Tf / (pConfig->Tf + pConfig->Ts));
+  hpid->Shift  = shift;
+  hpid->OutMin = CTRL_ToQ31(pConfig->OutMin);
+  hpid->OutMax = CTRL_ToQ31(pConfig->OutMax);
+  BSP_CTRL_PID_Q31_Reset(hpid, 0, 0);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Reset the state of a Q31 PID.
+  * @param  hpid Pointer to a BSP_CTRL_PID_Q31_TypeDef structure.
+  * @param  Measure Current measure, the derivative starts from it.
+  * @param  Output Current output, loaded in the integral.
+  * @retval None
+  */
+void BSP_CTRL_PID_Q31_Reset(BSP_CTRL_PID_Q31_TypeDef *hpid, int32_t Measure, int32_t Output)
+{
+  if (Output > hpid->OutMax)
+  {
+    Output = hpid->OutMax;
+  }
+  else if (Output < hpid->OutMin)
+  {
+    Output = hpid->OutMin;
+  }
+
+  hpid->Integral    = (int64_t)Output * (int64_t)(1ULL << (31U - hpid->Shift));
+  hpid->Derivative  = 0;
+  hpid->PrevMeasure = Measure;
+}
+
+/**
+  * @brief  Run one step of a Q31 PID.
+  * @param  hpid Pointer to a BSP_CTRL_PID_Q31_TypeDef structure.
+  * @param  Setpoint Setpoint.
+  * @param  Measure Measure.
+  * @param  FeedForward Feed-forward input, multiplied by Kff.
+  * @retval Output, in [OutMin, OutMax]
+  */
+int32_t BSP_CTRL_PID_Q31_Update(BSP_CTRL_PID_Q31_TypeDef *hpid, int32_t Setpoint, int32_t Measure,
+                                int32_t FeedForward)
+{
+  uint32_t right = 31U - hpid->Shift;
+  int64_t unit = (int64_t)(1ULL << right);
+  int32_t error = __QSUB(Setpoint, Measure);
+  int32_t delta = __QSUB(Measure, hpid->PrevMeasure);
+  int64_t integral = hpid->Integral + ((int64_t)hpid->Ki * error);
+  int64_t output;
+
+  hpid->Derivative  = CTRL_SatQ31((((int64_t)hpid->Ad * hpid->Derivative) >> 31) -
+                                  (((int64_t)hpid->Kd * delta) >> right));
+  hpid->PrevMeasure = Measure;
+
+  output = (((int64_t)hpid->Kp * error) >> right) + (((int64_t)hpid->Kff * FeedForward) >> right) +
+           (int64_t)hpid->Derivative + (integral >> right);
+
+  /* The integral holds while the output is limited in the direction of its change */
+  if (output > hpid->OutMax)
+  {
+    if (integral > hpid->Integral)
+    {
+      integral = hpid->Integral;
+    }
+    output = hpid->OutMax;
+  }
+  else if (output < hpid->OutMin)
+  {
+    if (integral < hpid->Integral)
+    {
+      integral = hpid->Integral;
+    }
+    output = hpid->OutMin;
+  }
+
+  if (integral > ((int64_t)hpid->OutMax * unit))
+  {
+    integral = (int64_t)hpid->OutMax * unit;
+  }
+  else if (integral < ((int64_t)hpid->OutMin * unit))
+  {
+    integral = (int64_t)hpid->OutMin * unit;
+  }
+  hpid->Integral = integral;
+
+  return (int32_t)output;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CTRL_Exported_Functions_Group2 Filter functions
+  * @brief    First order low-pass filters
+  *
+@verbatim
+ ===============================================================================
+                      ##### Filter functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Compute the coefficient of a filter from its time constant
+      (+) Filter one sample
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a float first order low-pass filter.
+  * @param  hlpf Pointer to a BSP_CTRL_LPF_F32_TypeDef structure.
+  * @param  Ts Sampling period in seconds.
+  * @param  Tc Time constant in seconds, 0 to pass the input.
+  * @param  Initial Initial output.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTRL_LPF_F32_Init(BSP_CTRL_LPF_F32_TypeDef *hlpf, float Ts, float Tc, float Initial)
+{
+  if ((hlpf == NULL) || !(Ts > 0.0f) || (Tc < 0.0f))
+  {
+    return HAL_ERROR;
+  }
+
+  hlpf->Alpha = Ts / (Tc + Ts);
+  hlpf->State = Initial;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter one sample with a float first order low-pass filter.
+  * @param  hlpf Pointer to a BSP_CTRL_LPF_F32_TypeDef structure.
+  * @param  Input Sample.
+  * @retval Output
+  */
+float BSP_CTRL_LPF_F32_Process(BSP_CTRL_LPF_F32_TypeDef *hlpf, float Input)
+{
+  hlpf->State += hlpf->Alpha * (Input - hlpf->State);
+
+  return hlpf->State;
+}
+
+/**
+  * @brief  Initialize a Q31 first order low-pass filter.
+  * @param  hlpf Pointer to a BSP_CTRL_LPF_Q31_TypeDef structure.
+  * @param  Ts Sampling period in seconds.
+  * @param  Tc Time constant in seconds, 0 to pass the input.
+  * @param  Initial Initial output.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTRL_LPF_Q31_Init(BSP_CTRL_LPF_Q31_TypeDef *hlpf, float Ts, float Tc, int32_t Initial)
+{
+  if ((hlpf == NULL) || !(Ts > 0.0f) || (Tc < 0.0f))
+  {
+    return HAL_ERROR;
+  }
+
+  hlpf->Alpha = CTRL_ToQ31(Ts / (Tc + Ts));
+  hlpf->State = Initial;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter one sample with a Q31 first order low-pass filter.
+  * @param  hlpf Pointer to a BSP_CTRL_LPF_Q31_TypeDef structure.
+  * @param  Input Sample.
+  * @retval Output
+  */
+int32_t BSP_CTRL_LPF_Q31_Process(BSP_CTRL_LPF_Q31_TypeDef *hlpf, int32_t Input)
+{
+  /* The step is a fraction of the difference: the output stays between the state and the input */
+  hlpf->State += (int32_t)(((int64_t)hlpf->Alpha * ((int64_t)Input - hlpf->State)) >> 31);
+
+  return hlpf->State;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_CTRL_Exported_Functions_Group3 Scheduler functions
+  * @brief    Rate monotonic scheduler of the loops
+  *
+@verbatim
+ ===============================================================================
+                      ##### Scheduler functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind the scheduler to its timer and its levels to spare IRQs
+      (+) Add the loops and start or stop them
+      (+) Read and clear the statistics of a loop
+      (+) Handle the timer update and the IRQs of the levels
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Bind the scheduler to a timer, the loops and the levels cleared.
+  * @param  htim TIM handle, initialized, its update the base rate.
+  * @retval HAL status, HAL_BUSY when started
+  */
+HAL_StatusTypeDef BSP_CTRL_SchedInit(TIM_HandleTypeDef *htim)
+{
+  uint32_t i;
+
+  if (htim == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if (CTRL_Started != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 1U; i < BSP_CTRL_LEVELS; i++)
+  {
+    if (CTRL_Levels[i].Ready != 0U)
+    {
+      HAL_NVIC_DisableIRQ(CTRL_Levels[i].IRQn);
+      CTRL_Levels[i].Ready = 0U;
+    }
+    CTRL_pFirst[i] = NULL;
+  }
+  CTRL_pFirst[0]  = NULL;
+  CTRL_pLoops     = NULL;
+  CTRL_Inner      = 0U;
+  CTRL_htim       = htim;
+
+  HAL_EnableCycleCounter();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Bind a level to a spare IRQ.
+  * @param  Level Level, 1 to BSP_CTRL_LEVELS - 1.
+  * @param  IRQn Device IRQ of a peripheral left unused.
+  * @param  PreemptPriority Preemption priority of the level, below the one of
+  *         the level above.
+  * @retval HAL status, HAL_BUSY when started
+  */
+HAL_StatusTypeDef BSP_CTRL_SchedSetLevel(uint32_t Level, IRQn_Type IRQn, uint32_t PreemptPriority)
+{
+  if ((CTRL_htim == NULL) || (Level == 0U) || (Level >= BSP_CTRL_LEVELS) || (IRQn < (IRQn_Type)0) ||
+      (PreemptPriority >= (1UL << __NVIC_PRIO_BITS)))
+  {
+    return HAL_ERROR;
+  }
+  if (CTRL_Started != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  HAL_NVIC_DisableIRQ(IRQn);
+  CTRL_Levels[Level].IRQn     = IRQn;
+  CTRL_Levels[Level].Priority = PreemptPriority;
+  CTRL_Levels[Level].Ready    = 1U;
+
+  /* Installed when the vector table is in SRAM, routed by py32f4xx_it.c otherwise */
+  (void)HAL_NVIC_SetVector(IRQn, CTRL_Handler);
+
+  HAL_NVIC_SetPriority(IRQn, PreemptPriority, 0U);
+  HAL_NVIC_ClearPendingIRQ(IRQn);
+  HAL_NVIC_EnableIRQ(IRQn);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Link a loop in the scheduler, by increasing period.
+  * @param  pLoop Loop.
+  * @param  Period Period in timer updates, 1 or above.
+  * @param  Budget Most CPU cycles of a run, 0 for no check.
+  * @param  Function Loop step.
+  * @param  pContext User data of the function.
+  * @retval HAL status, HAL_BUSY when started
+  */
+HAL_StatusTypeDef BSP_CTRL_SchedAddLoop(BSP_CTRL_LoopTypeDef *pLoop, uint32_t Period, uint32_t Budget,
+                                        void (*Function)(BSP_CTRL_LoopTypeDef *pLoop), void *pContext)
+{
+  BSP_CTRL_LoopTypeDef **link = &CTRL_pLoops;
+
+  if ((CTRL_htim == NULL) || (pLoop == NULL) || (Function == NULL) || (Period == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (CTRL_Started != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  pLoop->Function = Function;
+  pLoop->pContext = pContext;
+  pLoop->Period   = Period;
+  pLoop->Budget   = Budget;
+  pLoop->Level    = 0U;
+  pLoop->State    = BSP_CTRL_LOOP_IDLE;
+  BSP_CTRL_SchedResetStats(pLoop);
+
+  /* After the loops of the same period: the first added runs first */
+  while ((*link != NULL) && ((*link)->Period <= Period))
+  {
+    link = &(*link)->pNext;
+  }
+  pLoop->pNext = *link;
+  *link = pLoop;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give the loops their level by rate and start the timer.
+  * @retval HAL status, HAL_ERROR when the priorities of the levels do not
+  *         decrease
+  */
+HAL_StatusTypeDef BSP_CTRL_SchedStart(void)
+{
+  BSP_CTRL_LoopTypeDef *loop;
+  uint32_t level = 0U;
+  uint32_t i;
+
+  if ((CTRL_htim == NULL) || (CTRL_pLoops == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (CTRL_Started != 0U)
+  {
+    return HAL_BUSY;
+  }
+  for (i = 2U; i < BSP_CTRL_LEVELS; i++)
+  {
+    if ((CTRL_Levels[i].Ready != 0U) && (CTRL_Levels[i - 1U].Ready != 0U) &&
+        (CTRL_Levels[i].Priority <= CTRL_Levels[i - 1U].Priority))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  for (i = 0U; i < BSP_CTRL_LEVELS; i++)
+  {
+    CTRL_pFirst[i] = NULL;
+  }
+  CTRL_pFirst[0] = CTRL_pLoops;
+  for (loop = CTRL_pLoops; loop != NULL; loop = loop->pNext)
+  {
+    /* Each slower rate to the next level, while one is configured */
+    if ((loop != CTRL_pLoops) && (loop->Period != CTRL_pFirst[level]->Period) &&
+        ((level + 1U) < BSP_CTRL_LEVELS) && (CTRL_Levels[level + 1U].Ready != 0U))
+    {
+      level++;
+      CTRL_pFirst[level] = loop;
+    }
+    loop->Level     = level;
+    loop->Countdown = 1U;
+    loop->State     = BSP_CTRL_LOOP_IDLE;
+  }
+
+  CTRL_Inner   = 0U;
+  CTRL_Started = 1U;
+  __HAL_TIM_CLEAR_IT(CTRL_htim, TIM_IT_UPDATE);
+  if (HAL_TIM_Base_Start_IT(CTRL_htim) != HAL_OK)
+  {
+    CTRL_Started = 0U;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the timer, the releases pending dropped.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_CTRL_SchedStop(void)
+{
+  BSP_CTRL_LoopTypeDef *loop;
+  uint32_t i;
+
+  if (CTRL_Started == 0U)
+  {
+    return HAL_OK;
+  }
+
+  (void)HAL_TIM_Base_Stop_IT(CTRL_htim);
+  CTRL_Started = 0U;
+  for (i = 1U; i < BSP_CTRL_LEVELS; i++)
+  {
+    if (CTRL_Levels[i].Ready != 0U)
+    {
+      HAL_NVIC_ClearPendingIRQ(CTRL_Levels[i].IRQn);
+    }
+  }
+  for (loop = CTRL_pLoops; loop != NULL; loop = loop->pNext)
+  {
+    if (loop->State == BSP_CTRL_LOOP_READY)
+    {
+      loop->State = BSP_CTRL_LOOP_IDLE;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy the statistics of a loop.
+  * @param  pLoop Loop.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_CTRL_SchedGetStats(const BSP_CTRL_LoopTypeDef *pLoop, BSP_CTRL_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = pLoop->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Clear the statistics of a loop.
+  * @param  pLoop Loop.
+  * @retval None
+  */
+void BSP_CTRL_SchedResetStats(BSP_CTRL_LoopTypeDef *pLoop)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  pLoop->Stats.Runs        = 0U;
+  pLoop->Stats.Overruns    = 0U;
+  pLoop->Stats.OverBudget  = 0U;
+  pLoop->Stats.Last        = 0U;
+  pLoop->Stats.Max         = 0U;
+  pLoop->Stats.Total       = 0U;
+  pLoop->Stats.MaxResponse = 0U;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Handle the timer update: release the loops due, pend the levels
+  *         and run the loops of level 0.
+  * @note   Called from TIMx_IRQHandler() instead of HAL_TIM_IRQHandler().
+  * @retval None
+  */
+void BSP_CTRL_SchedTimerIRQHandler(void)
+{
+  BSP_CTRL_LoopTypeDef *loop;
+  uint32_t primask_bit;
+  uint32_t pending = 0U;
+  uint32_t outer;
+  uint32_t start;
+  uint32_t i;
+
+  if ((CTRL_htim == NULL) || (__HAL_TIM_GET_FLAG(CTRL_htim, TIM_FLAG_UPDATE) == RESET))
+  {
+    return;
+  }
+  __HAL_TIM_CLEAR_IT(CTRL_htim, TIM_IT_UPDATE);
+
+  /* The whole handler preempts the loop of a lower level */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  outer = CTRL_Inner;
+  CTRL_Inner = 0U;
+  start = DWT->CYCCNT;
+  __set_PRIMASK(primask_bit);
+
+  for (loop = CTRL_pLoops; loop != NULL; loop = loop->pNext)
+  {
+    loop->Countdown--;
+    if (loop->Countdown == 0U)
+    {
+      loop->Countdown = loop->Period;
+      if (loop->State != BSP_CTRL_LOOP_IDLE)
+      {
+        loop->Stats.Overruns++;
+      }
+      else
+      {
+        loop->Release = start;
+        loop->State = BSP_CTRL_LOOP_READY;
+        pending |= 1UL << loop->Level;
+      }
+    }
+  }
+
+  for (i = 1U; i < BSP_CTRL_LEVELS; i++)
+  {
+    if ((pending & (1UL << i)) != 0U)
+    {
+      NVIC_SetPendingIRQ(CTRL_Levels[i].IRQn);
+    }
+  }
+  if ((pending & 1U) != 0U)
+  {
+    CTRL_RunLevel(0U);
+  }
+
+  __disable_irq();
+  CTRL_Inner = outer + (DWT->CYCCNT - start);
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Run the loops released of a level.
+  * @param  Level Level, 1 to BSP_CTRL_LEVELS - 1.
+  * @retval None
+  */
+void BSP_CTRL_SchedLevelIRQHandler(uint32_t Level)
+{
+  if ((Level != 0U) && (Level < BSP_CTRL_LEVELS))
+  {
+    CTRL_RunLevel(Level);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_CTRL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Saturate a value to Q31.
+  * @param  Value Value.
+  * @retval Saturated value
+  */
+static int32_t CTRL_SatQ31(int64_t Value)
+{
+  if (Value > (int64_t)CTRL_Q31_ONE)
+  {
+    return CTRL_Q31_ONE;
+  }
+  if (Value < ((int64_t)-CTRL_Q31_ONE - 1))
+  {
+    return -CTRL_Q31_ONE - 1;
+  }
+
+  return (int32_t)Value;
+}
+
+/**
+  * @brief  Convert a float in [-1, 1] to Q31, saturated.
+  * @param  Value Value.
+  * @retval Q31 value
+  */
+static int32_t CTRL_ToQ31(float Value)
+{
+  float scaled = Value * 2147483648.0f;
+
+  return (scaled >= 2147483648.0f) ? CTRL_Q31_ONE :
+         ((scaled <= -2147483648.0f) ? (-CTRL_Q31_ONE - 1) : (int32_t)scaled);
+}
+
+/**
+  * @brief  Run a loop and measure it.
+  * @param  pLoop Loop released.
+  * @retval None
+  */
+static void CTRL_Run(BSP_CTRL_LoopTypeDef *pLoop)
+{
+  BSP_CTRL_StatsTypeDef *stats = &pLoop->Stats;
+  uint32_t primask_bit;
+  uint32_t outer;
+  uint32_t start;
+  uint32_t end;
+  uint32_t run;
+  uint32_t self;
+
+  /* The runs preempting this one are counted from here */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  outer = CTRL_Inner;
+  CTRL_Inner = 0U;
+  pLoop->State = BSP_CTRL_LOOP_RUNNING;
+  start = DWT->CYCCNT;
+  __set_PRIMASK(primask_bit);
+
+  pLoop->Function(pLoop);
+
+  __disable_irq();
+  end = DWT->CYCCNT;
+  run = end - start;
+  self = run - CTRL_Inner;
+  CTRL_Inner = outer + run;
+
+  stats->Runs++;
+  stats->Last = self;
+  stats->Total += self;
+  if (self > stats->Max)
+  {
+    stats->Max = self;
+  }
+  if ((pLoop->Budget != 0U) && (self > pLoop->Budget))
+  {
+    stats->OverBudget++;
+  }
+  if ((end - pLoop->Release) > stats->MaxResponse)
+  {
+    stats->MaxResponse = end - pLoop->Release;
+  }
+  pLoop->State = BSP_CTRL_LOOP_IDLE;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Run the loops released of a level, fastest first.
+  * @param  Level Level.
+  * @retval None
+  */
+static void CTRL_RunLevel(uint32_t Level)
+{
+  BSP_CTRL_LoopTypeDef *loop = CTRL_pFirst[Level];
+
+  while ((loop != NULL) && (loop->Level == Level))
+  {
+    if (loop->State == BSP_CTRL_LOOP_READY)
+    {
+      CTRL_Run(loop);
+      /* A faster loop of the level may have been released meanwhile */
+      loop = CTRL_pFirst[Level];
+    }
+    else
+    {
+      loop = loop->pNext;
+    }
+  }
+}
+
+/**
+  * @brief  Handler of the spare IRQs installed in the vector table.
+  * @retval None
+  */
+static void CTRL_Handler(void)
+{
+  IRQn_Type irqn = (IRQn_Type)(int32_t)((__get_IPSR() & CTRL_IPSR_MASK) - CTRL_IRQ_EXC);
+  uint32_t i;
+
+  for (i = 1U; i < BSP_CTRL_LEVELS; i++)
+  {
+    if ((CTRL_Levels[i].Ready != 0U) && (CTRL_Levels[i].IRQn == irqn))
+    {
+      CTRL_RunLevel(i);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,341 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_debounce.c
+  * @author  MCU Application Team
+  * @brief   Input debouncing BSP service.
+  *          This file provides functions to debounce many digital inputs at
+  *          once:
+  *           + Whole ports sampled, from IDR or from a DMA buffer
+  *           + Vertical counters, 16 pins debounced in a few operations
+  *           + Press and release edges, and presses counted per pin
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) An interrupt per edge and a timer per pin do not scale to tens of
+       buttons and limit switches. This service samples whole ports at a
+       fixed period and debounces the 16 pins of a port together: bit x of
+       each word is pin x, a pin changes its state after
+       BSP_DEBOUNCE_SAMPLES samples in a row at the new level. Choose the
+       period as the bounce time divided by BSP_DEBOUNCE_SAMPLES, 2 to 5 ms
+       for mechanical contacts.
+
+   (#) Configure the pins as inputs with HAL_GPIO_Init(), call
+       BSP_DEBOUNCE_Init() and BSP_DEBOUNCE_AddPort() per port, with the
+       pins debounced and the pins active low. The states start at the
+       current levels, without edges.
+
+   (#) Sample the ports in one of the two ways:
+       (+) BSP_DEBOUNCE_Scan() reads the IDR of every port, called from a
+           timer period interrupt or the SysTick,
+       (+) BSP_DEBOUNCE_ProcessSamples() debounces a buffer of samples of a
+           port, filled at the timer rate by HAL_TIMEx_GPIOCapture_Start_DMA()
+           in the circular mode and passed on the half and full transfer
+           callbacks: the samples are taken at exact instants and debounced
+           by blocks, one interrupt per half buffer.
+       Call them from one context only.
+
+   (#) BSP_DEBOUNCE_GetState() gives the debounced states, 1 active.
+       BSP_DEBOUNCE_GetEdges() reads and clears the pins pressed and released
+       since the last call, BSP_DEBOUNCE_GetPresses() the presses counted of
+       a pin. BSP_DEBOUNCE_EdgeCallback() is called from the sampling
+       context on the samples changing a state.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_debounce.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DEBOUNCE BSP DEBOUNCE
+  * @brief Input debouncing BSP service
+  * @{
+  */
+
+#if defined (HAL_GPIO_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_DEBOUNCE_Private_Functions BSP DEBOUNCE Private Functions
+  * @{
+  */
+static void DEBOUNCE_Sample(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Sample);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DEBOUNCE_Exported_Functions BSP DEBOUNCE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the debouncing without ports.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DEBOUNCE_Init(BSP_DEBOUNCE_TypeDef *hdeb)
+{
+  if (hdeb == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  hdeb->NbPorts = 0U;
+  hdeb->Scans   = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Add a port, its states started at the current levels.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  GPIOx GPIO port, the pins configured as inputs.
+  * @param  Mask Pins debounced, any combination of GPIO_PIN_x.
+  * @param  ActiveLow Pins active at the low level, a combination of GPIO_PIN_x of Mask.
+  * @retval HAL status, the port index being the number of ports added before
+  */
+HAL_StatusTypeDef BSP_DEBOUNCE_AddPort(BSP_DEBOUNCE_TypeDef *hdeb, GPIO_TypeDef *GPIOx, uint32_t Mask,
+                                       uint32_t ActiveLow)
+{
+  BSP_DEBOUNCE_PortTypeDef *pport;
+  uint32_t pin;
+
+  if ((hdeb == NULL) || (GPIOx == NULL) || ((Mask & GPIO_PIN_MASK) == 0U) || ((Mask & ~GPIO_PIN_MASK) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hdeb->NbPorts >= BSP_DEBOUNCE_PORTS)
+  {
+    return HAL_BUSY;
+  }
+
+  pport = &hdeb->Port[hdeb->NbPorts];
+  pport->GPIOx    = GPIOx;
+  pport->Mask     = Mask;
+  pport->Invert   = ActiveLow & Mask;
+  pport->State    = (GPIOx->IDR ^ pport->Invert) & Mask;
+  pport->Count0   = 0U;
+  pport->Count1   = 0U;
+  pport->Pressed  = 0U;
+  pport->Released = 0U;
+  for (pin = 0U; pin < 16U; pin++)
+  {
+    pport->Presses[pin] = 0U;
+  }
+  hdeb->NbPorts++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Sample the IDR of every port and debounce it.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @retval None
+  */
+void BSP_DEBOUNCE_Scan(BSP_DEBOUNCE_TypeDef *hdeb)
+{
+  uint32_t port;
+
+  for (port = 0U; port < hdeb->NbPorts; port++)
+  {
+    DEBOUNCE_Sample(hdeb, port, hdeb->Port[port].GPIOx->IDR);
+  }
+  hdeb->Scans++;
+}
+
+/**
+  * @brief  Debounce a buffer of samples of a port, the oldest first.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @param  pSamples IDR samples, as stored by HAL_TIMEx_GPIOCapture_Start_DMA().
+  * @param  Count Number of samples.
+  * @retval None
+  */
+void BSP_DEBOUNCE_ProcessSamples(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, const uint16_t *pSamples,
+                                 uint32_t Count)
+{
+  uint32_t index;
+
+  if (Port >= hdeb->NbPorts)
+  {
+    return;
+  }
+
+  for (index = 0U; index < Count; index++)
+  {
+    DEBOUNCE_Sample(hdeb, Port, pSamples[index]);
+  }
+}
+
+/**
+  * @brief  Return the debounced states of a port.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @retval Bit x set for pin x active, 0 for a port out of range
+  */
+uint32_t BSP_DEBOUNCE_GetState(const BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port)
+{
+  return (Port < hdeb->NbPorts) ? hdeb->Port[Port].State : 0U;
+}
+
+/**
+  * @brief  Read and clear the edges of a port since the last call.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @param  pPressed Pins gone active, bit x for pin x.
+  * @param  pReleased Pins gone inactive, bit x for pin x.
+  * @retval None
+  */
+void BSP_DEBOUNCE_GetEdges(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t *pPressed,
+                           uint32_t *pReleased)
+{
+  BSP_DEBOUNCE_PortTypeDef *pport;
+  uint32_t primask;
+
+  *pPressed  = 0U;
+  *pReleased = 0U;
+  if (Port >= hdeb->NbPorts)
+  {
+    return;
+  }
+
+  pport = &hdeb->Port[Port];
+  primask = __get_PRIMASK();
+  __disable_irq();
+  *pPressed  = pport->Pressed;
+  *pReleased = pport->Released;
+  pport->Pressed  = 0U;
+  pport->Released = 0U;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Return the presses counted of a pin.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @param  Pin Pin number, 0 to 15.
+  * @retval Presses since BSP_DEBOUNCE_AddPort(), wrapping at 65536
+  */
+uint32_t BSP_DEBOUNCE_GetPresses(const BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Pin)
+{
+  if ((Port >= hdeb->NbPorts) || (Pin >= 16U))
+  {
+    return 0U;
+  }
+
+  return hdeb->Port[Port].Presses[Pin];
+}
+
+/**
+  * @brief  Edges of a port callback.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @param  Pressed Pins gone active on this sample.
+  * @param  Released Pins gone inactive on this sample.
+  * @retval None
+  */
+__weak void BSP_DEBOUNCE_EdgeCallback(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Pressed,
+                                      uint32_t Released)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hdeb);
+  UNUSED(Port);
+  UNUSED(Pressed);
+  UNUSED(Released);
+
+  /* NOTE: This function should not be modified, when the callback is needed,
+            the BSP_DEBOUNCE_EdgeCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DEBOUNCE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Debounce one sample of a port with the vertical counters.
+  * @note   A pin differing from its state counts up in Count1:Count0, a pin
+  *         equal to it clears its counter. The counter wrapping to 0 after
+  *         BSP_DEBOUNCE_SAMPLES samples toggles the state.
+  * @param  hdeb Pointer to a BSP_DEBOUNCE_TypeDef structure.
+  * @param  Port Port index.
+  * @param  Sample IDR of the port.
+  * @retval None
+  */
+static void DEBOUNCE_Sample(BSP_DEBOUNCE_TypeDef *hdeb, uint32_t Port, uint32_t Sample)
+{
+  BSP_DEBOUNCE_PortTypeDef *pport = &hdeb->Port[Port];
+  uint32_t delta;
+  uint32_t toggle;
+  uint32_t pressed;
+  uint32_t released;
+  uint32_t pins;
+  uint32_t pin;
+
+  delta = ((Sample ^ pport->Invert) & pport->Mask) ^ pport->State;
+  pport->Count1 = (pport->Count1 ^ pport->Count0) & delta;
+  pport->Count0 = ~pport->Count0 & delta;
+  toggle = delta & ~(pport->Count0 | pport->Count1);
+  if (toggle == 0U)
+  {
+    return;
+  }
+
+  pport->State ^= toggle;
+  pressed  = toggle & pport->State;
+  released = toggle & ~pport->State;
+  pport->Pressed  |= pressed;
+  pport->Released |= released;
+
+  pins = pressed;
+  while (pins != 0U)
+  {
+    pin = 31U - __CLZ(pins);
+    pins &= ~(1UL << pin);
+    pport->Presses[pin]++;
+  }
+
+  BSP_DEBOUNCE_EdgeCallback(hdeb, Port, pressed, released);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_GPIO_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,370 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_defer.c
+  * @author  MCU Application Team
+  * @brief   Deferred interrupt work BSP service.
+  *          This file provides functions to move work out of the handlers:
+  *           + Levels of deferred work, each a spare IRQ pended by software at
+  *             its own priority
+  *           + Lock-free queue of {function, argument} per level, many
+  *             producers of any priority, the IRQ of the level draining it
+  *           + Runs, overruns and queue high water of each level
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Pick for each level an IRQ of a peripheral left unused, TIM7_IRQn for
+       example: its interrupt is only pended by software. Call
+       BSP_DEFER_Init() with the level, 0 to BSP_DEFER_LEVELS - 1, the IRQ and
+       its preemption priority, lower than the one of the handlers deferring
+       work. With the vector table in SRAM, USE_VECT_TAB_RAM=y, the handler is
+       installed, otherwise call BSP_DEFER_IRQHandler() with the level from
+       the handler of the IRQ in py32f4xx_it.c.
+
+   (#) In a handler or a HAL callback, BSP_DEFER_Submit() queues the function
+       and its argument and pends the IRQ of the level: the function runs at
+       the priority of the level once the higher ones return, in the order of
+       the submissions. The main loop may submit too. HAL_BUSY means the
+       BSP_DEFER_DEPTH works of the queue are waiting: the work is dropped
+       and counted in the overruns.
+
+   (#) The queue takes a slot with LDREX/STREX on its head, the level never
+       masks the interrupts: a producer of any priority, the zero-latency
+       tier of HAL_CRITICAL_PRIORITY included, is never delayed. A work
+       submitted from below the level runs when its submission ends.
+
+   (#) BSP_DEFER_IRQHandler() runs up to BSP_DEFER_DEPTH works and pends its
+       IRQ again when more wait, so that the IRQs of the same priority are
+       not held off. BSP_DEFER_GetStats() gives the runs, the overruns and the
+       most works queued at once of a level.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_defer.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DEFER BSP DEFER
+  * @brief Deferred interrupt work BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Private_Types BSP DEFER Private Types
+  * @{
+  */
+
+/**
+  * @brief  Deferred work level definition
+  */
+typedef struct
+{
+  IRQn_Type               IRQn;         /* Spare IRQ of the level */
+
+  uint32_t                Ready;        /* 1 once initialized */
+
+  __IO uint32_t           Head;         /* Position of the next slot taken */
+
+  __IO uint32_t           Tail;         /* Position of the next work run */
+
+  __IO uint32_t           Seq[BSP_DEFER_DEPTH]; /* Position + 1 once written, + BSP_DEFER_DEPTH once run */
+
+  BSP_DEFER_FuncTypeDef   Func[BSP_DEFER_DEPTH];
+
+  void                    *pArg[BSP_DEFER_DEPTH];
+
+  BSP_DEFER_StatsTypeDef  Stats;
+
+} DEFER_LevelTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Private_Constants BSP DEFER Private Constants
+  * @{
+  */
+#define DEFER_MASK                      (BSP_DEFER_DEPTH - 1U)
+#define DEFER_IPSR_MASK                 0x000001FFU    /* Exception number of IPSR */
+#define DEFER_IRQ_EXC                   16U            /* Exception number of IRQn 0 */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Private_Variables BSP DEFER Private Variables
+  * @{
+  */
+static DEFER_LevelTypeDef DEFER_Levels[BSP_DEFER_LEVELS];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_DEFER_Private_Functions BSP DEFER Private Functions
+  * @{
+  */
+static void DEFER_Handler(void);
+static void DEFER_Increment(__IO uint32_t *pCount);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DEFER_Exported_Functions BSP DEFER Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Empty a level and enable its IRQ.
+  * @param  Level Level, 0 to BSP_DEFER_LEVELS - 1.
+  * @param  IRQn Device IRQ of a peripheral left unused.
+  * @param  PreemptPriority Preemption priority of the level, 0 to 7.
+  * @retval HAL status, HAL_BUSY when the level is initialized
+  */
+HAL_StatusTypeDef BSP_DEFER_Init(uint32_t Level, IRQn_Type IRQn, uint32_t PreemptPriority)
+{
+  DEFER_LevelTypeDef *level;
+  uint32_t i;
+
+  if ((Level >= BSP_DEFER_LEVELS) || (IRQn < (IRQn_Type)0) ||
+      (PreemptPriority >= (1UL << __NVIC_PRIO_BITS)))
+  {
+    return HAL_ERROR;
+  }
+  level = &DEFER_Levels[Level];
+  if (level->Ready != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  HAL_NVIC_DisableIRQ(IRQn);
+  level->IRQn = IRQn;
+  level->Head = 0U;
+  level->Tail = 0U;
+  for (i = 0U; i < BSP_DEFER_DEPTH; i++)
+  {
+    level->Seq[i] = i;
+  }
+  level->Stats.Runs      = 0U;
+  level->Stats.Overruns  = 0U;
+  level->Stats.MaxQueued = 0U;
+  level->Ready = 1U;
+
+  /* Installed when the vector table is in SRAM, routed by py32f4xx_it.c otherwise */
+  (void)HAL_NVIC_SetVector(IRQn, DEFER_Handler);
+
+  HAL_NVIC_SetPriority(IRQn, PreemptPriority, 0U);
+  HAL_NVIC_ClearPendingIRQ(IRQn);
+  HAL_NVIC_EnableIRQ(IRQn);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable the IRQ of a level, the works queued dropped.
+  * @param  Level Level, 0 to BSP_DEFER_LEVELS - 1.
+  * @retval None
+  */
+void BSP_DEFER_DeInit(uint32_t Level)
+{
+  if ((Level < BSP_DEFER_LEVELS) && (DEFER_Levels[Level].Ready != 0U))
+  {
+    HAL_NVIC_DisableIRQ(DEFER_Levels[Level].IRQn);
+    HAL_NVIC_ClearPendingIRQ(DEFER_Levels[Level].IRQn);
+    DEFER_Levels[Level].Ready = 0U;
+  }
+}
+
+/**
+  * @brief  Queue a work and pend the IRQ of its level, from any context.
+  * @param  Level Level, 0 to BSP_DEFER_LEVELS - 1.
+  * @param  Func Function run at the priority of the level.
+  * @param  pArg Argument of the function.
+  * @retval HAL status, HAL_BUSY when the queue is full
+  */
+HAL_StatusTypeDef BSP_DEFER_Submit(uint32_t Level, BSP_DEFER_FuncTypeDef Func, void *pArg)
+{
+  DEFER_LevelTypeDef *level;
+  uint32_t pos;
+  uint32_t index;
+  uint32_t queued;
+
+  if ((Level >= BSP_DEFER_LEVELS) || (Func == NULL) || (DEFER_Levels[Level].Ready == 0U))
+  {
+    return HAL_ERROR;
+  }
+  level = &DEFER_Levels[Level];
+
+  /* An exception between the LDREX and the STREX fails the STREX: the slot
+     is free when its sequence is the position, its work run otherwise */
+  do
+  {
+    pos = __LDREXW(&level->Head);
+    if (level->Seq[pos & DEFER_MASK] != pos)
+    {
+      __CLREX();
+      DEFER_Increment(&level->Stats.Overruns);
+      return HAL_BUSY;
+    }
+  } while (__STREXW(pos + 1U, &level->Head) != 0U);
+
+  index = pos & DEFER_MASK;
+  level->Func[index] = Func;
+  level->pArg[index] = pArg;
+  __DMB();
+  level->Seq[index] = pos + 1U;
+
+  queued = (pos + 1U) - level->Tail;
+  if (queued > level->Stats.MaxQueued)
+  {
+    level->Stats.MaxQueued = queued;
+  }
+
+  NVIC_SetPendingIRQ(level->IRQn);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy the statistics of a level.
+  * @param  Level Level, 0 to BSP_DEFER_LEVELS - 1.
+  * @param  pStats Statistics.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DEFER_GetStats(uint32_t Level, BSP_DEFER_StatsTypeDef *pStats)
+{
+  if ((Level >= BSP_DEFER_LEVELS) || (pStats == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  *pStats = DEFER_Levels[Level].Stats;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run the works queued of a level, from the handler of its IRQ.
+  * @param  Level Level, 0 to BSP_DEFER_LEVELS - 1.
+  * @retval None
+  */
+void BSP_DEFER_IRQHandler(uint32_t Level)
+{
+  DEFER_LevelTypeDef *level;
+  BSP_DEFER_FuncTypeDef func;
+  void *arg;
+  uint32_t budget = BSP_DEFER_DEPTH;
+  uint32_t pos;
+  uint32_t index;
+
+  if ((Level >= BSP_DEFER_LEVELS) || (DEFER_Levels[Level].Ready == 0U))
+  {
+    return;
+  }
+  level = &DEFER_Levels[Level];
+
+  while (budget != 0U)
+  {
+    pos = level->Tail;
+    index = pos & DEFER_MASK;
+    if (level->Seq[index] != (pos + 1U))
+    {
+      /* Empty, or the slot still written by a submission preempted */
+      return;
+    }
+    __DMB();
+    func = level->Func[index];
+    arg  = level->pArg[index];
+    __DMB();
+
+    /* The slot given back before the run, the work may submit again */
+    level->Seq[index] = pos + BSP_DEFER_DEPTH;
+    level->Tail = pos + 1U;
+
+    func(arg);
+    level->Stats.Runs++;
+    budget--;
+  }
+
+  if (level->Seq[level->Tail & DEFER_MASK] == (level->Tail + 1U))
+  {
+    NVIC_SetPendingIRQ(level->IRQn);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DEFER_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Handler installed in the SRAM vector table, for the level of the
+  *         active IRQ.
+  * @retval None
+  */
+static void DEFER_Handler(void)
+{
+  IRQn_Type irqn = (IRQn_Type)(int32_t)((__get_IPSR() & DEFER_IPSR_MASK) - DEFER_IRQ_EXC);
+  uint32_t i;
+
+  for (i = 0U; i < BSP_DEFER_LEVELS; i++)
+  {
+    if ((DEFER_Levels[i].Ready != 0U) && (DEFER_Levels[i].IRQn == irqn))
+    {
+      BSP_DEFER_IRQHandler(i);
+    }
+  }
+}
+
+/**
+  * @brief  Add one to a counter shared by the producers.
+  * @param  pCount Counter.
+  * @retval None
+  */
+static void DEFER_Increment(__IO uint32_t *pCount)
+{
+  uint32_t count;
+
+  do
+  {
+    count = __LDREXW(pCount);
+  } while (__STREXW(count + 1U, pCount) != 0U);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,254 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_diskio.c
+  * @author  MCU Application Team
+  * @brief   FatFs disk I/O BSP service.
+  *          This file provides the disk functions of FatFs over the block
+  *          devices:
+  *           + Drives linked to block devices
+  *           + disk_initialize(), disk_status(), disk_read(), disk_write()
+  *           + disk_ioctl() sync, geometry and trim
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_FATFS=y and FATFS_DIR at the sources of FatFs R0.14 or
+       later, its template diskio.c left out: this file replaces it.
+       FF_VOLUMES gives the drives, FF_MAX_SS the largest sector: 512 for the
+       SD card, 4096 for the NOR flashes, with FF_MIN_SS 512 for both. Set
+       FF_USE_TRIM to 1 so that the deleted clusters are erased.
+
+   (#) Initialize the block devices, see py32f4xx_bsp_blkdev.c, then link
+       each one to its drive with BSP_DISKIO_Link() before f_mount(). The
+       drives not linked report STA_NOINIT.
+
+   (#) f_sync() and f_close() write the cache of the block device back by
+       CTRL_SYNC. get_fattime() is weak and returns 1 January 2024: give it
+       the RTC by a function of the application.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_diskio.h"
+
+#if defined (USE_BSP_FATFS)
+
+#include "ff.h"
+#include "diskio.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DISKIO BSP DISKIO
+  * @brief FatFs disk I/O BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DISKIO_Private_Constants BSP DISKIO Private Constants
+  * @{
+  */
+#define DISKIO_FATTIME                  ((DWORD)(2024U - 1980U) << 25 | (DWORD)1U << 21 | (DWORD)1U << 16)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DISKIO_Private_Variables BSP DISKIO Private Variables
+  * @{
+  */
+static BSP_BLKDEV_TypeDef *DISKIO_Drives[FF_VOLUMES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DISKIO_Exported_Functions BSP DISKIO Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Link a drive to a block device.
+  * @param  Drive Physical drive number, below FF_VOLUMES.
+  * @param  hdev Block device initialized, NULL to unlink the drive.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DISKIO_Link(uint32_t Drive, BSP_BLKDEV_TypeDef *hdev)
+{
+  if ((Drive >= (uint32_t)FF_VOLUMES) || ((hdev != NULL) && (hdev->State != BSP_BLKDEV_STATE_READY)))
+  {
+    return HAL_ERROR;
+  }
+
+  DISKIO_Drives[Drive] = hdev;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  FatFs drive status.
+  * @param  pdrv Physical drive number.
+  * @retval Drive status
+  */
+DSTATUS disk_status(BYTE pdrv)
+{
+  if ((pdrv >= FF_VOLUMES) || (DISKIO_Drives[pdrv] == NULL) ||
+      (DISKIO_Drives[pdrv]->State != BSP_BLKDEV_STATE_READY))
+  {
+    return STA_NOINIT;
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  FatFs drive initialization: the block device is initialized already.
+  * @param  pdrv Physical drive number.
+  * @retval Drive status
+  */
+DSTATUS disk_initialize(BYTE pdrv)
+{
+  return disk_status(pdrv);
+}
+
+/**
+  * @brief  FatFs sector read.
+  * @param  pdrv Physical drive number.
+  * @param  buff Buffer.
+  * @param  sector First sector.
+  * @param  count Sectors.
+  * @retval Result
+  */
+DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+  if (disk_status(pdrv) != 0U)
+  {
+    return RES_NOTRDY;
+  }
+  if (BSP_BLKDEV_Read(DISKIO_Drives[pdrv], buff, (uint32_t)sector, count) != HAL_OK)
+  {
+    return RES_ERROR;
+  }
+
+  return RES_OK;
+}
+
+#if FF_FS_READONLY == 0
+/**
+  * @brief  FatFs sector write.
+  * @param  pdrv Physical drive number.
+  * @param  buff Data.
+  * @param  sector First sector.
+  * @param  count Sectors.
+  * @retval Result
+  */
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+  if (disk_status(pdrv) != 0U)
+  {
+    return RES_NOTRDY;
+  }
+  if (BSP_BLKDEV_Write(DISKIO_Drives[pdrv], buff, (uint32_t)sector, count) != HAL_OK)
+  {
+    return RES_ERROR;
+  }
+
+  return RES_OK;
+}
+#endif /* FF_FS_READONLY */
+
+/**
+  * @brief  FatFs drive control.
+  * @param  pdrv Physical drive number.
+  * @param  cmd CTRL_SYNC, GET_SECTOR_COUNT, GET_SECTOR_SIZE, GET_BLOCK_SIZE or CTRL_TRIM.
+  * @param  buff Parameter or result of the command.
+  * @retval Result
+  */
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+  BSP_BLKDEV_TypeDef *hdev;
+  LBA_t *range;
+
+  if (disk_status(pdrv) != 0U)
+  {
+    return RES_NOTRDY;
+  }
+  hdev = DISKIO_Drives[pdrv];
+
+  switch (cmd)
+  {
+    case CTRL_SYNC:
+      return (BSP_BLKDEV_Sync(hdev) == HAL_OK) ? RES_OK : RES_ERROR;
+
+    case GET_SECTOR_COUNT:
+      *(LBA_t *)buff = (LBA_t)hdev->SectorCount;
+      return RES_OK;
+
+    case GET_SECTOR_SIZE:
+      *(WORD *)buff = (WORD)hdev->SectorSize;
+      return RES_OK;
+
+    case GET_BLOCK_SIZE:
+      /* A sector is an erase unit of the NOR flashes, unknown on the SD card */
+      *(DWORD *)buff = 1U;
+      return RES_OK;
+
+    case CTRL_TRIM:
+      range = (LBA_t *)buff;
+      if (range[1] < range[0])
+      {
+        return RES_PARERR;
+      }
+      return (BSP_BLKDEV_Erase(hdev, (uint32_t)range[0], (uint32_t)(range[1] - range[0] + 1U)) == HAL_OK) ?
+             RES_OK : RES_ERROR;
+
+    default:
+      return RES_PARERR;
+  }
+}
+
+/**
+  * @brief  FatFs time stamp of the files.
+  * @note   This function should not be modified, when the RTC is needed,
+  *         get_fattime could be implemented in the user file
+  * @retval Packed date and time
+  */
+__weak DWORD get_fattime(void)
+{
+  return DISKIO_FATTIME;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_FATFS */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,636 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_display.c
+  * @author  MCU Application Team
+  * @brief   SPI display transport BSP service.
+  *          This file provides functions to update a MIPI DCS SPI display
+  *          (ST7789, ILI9341 class) without a full framebuffer:
+  *           + Dirty rectangles tracking
+  *           + Column and row window commands
+  *           + 16-bit DMA pixel streaming from two tile buffers
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the SPI with HAL_SPI_Init() in SPI_MODE_MASTER, SPI_NSS_SOFT
+       and SPI_DIRECTION_2LINES or SPI_DIRECTION_1LINE, and link a DMA channel
+       to its hdmatx in DMA_NORMAL mode with DMA_MINC_ENABLE and half-word
+       peripheral and memory alignments. The DMA channel interrupt is not used.
+       The chip select and data/command pins are push-pull outputs.
+
+   (#) Call BSP_DISPLAY_Init() with the panel size. The display then owns the
+       SPI until BSP_DISPLAY_DeInit(). Send the panel initialization sequence
+       (sleep out, pixel format 0x55, display on...) with
+       BSP_DISPLAY_WriteCommand().
+
+   (#) Implement BSP_DISPLAY_RenderCallback(): it fills a tile with the RGB565
+       pixels of a rectangle, row after row. The SPI runs in 16-bit mode for the
+       pixels, so they are sent most significant byte first without swapping.
+
+   (#) Mark the changed areas with BSP_DISPLAY_Invalidate(). Overlapping areas
+       are merged, and when BSP_DISPLAY_RECT_NUMBER rectangles are tracked a
+       new one is merged with the rectangle growing the least.
+
+   (#) Call BSP_DISPLAY_Flush() to send the dirty rectangles. Each rectangle
+       gets one window and memory write command and is split in bands of
+       rows fitting BSP_DISPLAY_TILE_PIXELS. A band is rendered into one tile
+       while the DMA sends the previous band from the other tile.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_display.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DISPLAY BSP DISPLAY
+  * @brief SPI display transport BSP service
+  * @{
+  */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DISPLAY_Private_Constants BSP DISPLAY Private Constants
+  * @{
+  */
+#define DISPLAY_CMD_CASET         0x2AU       /*!< Column address set                            */
+#define DISPLAY_CMD_RASET         0x2BU       /*!< Row address set                               */
+#define DISPLAY_CMD_RAMWR         0x2CU       /*!< Memory write                                  */
+
+#define DISPLAY_TIMEOUT           100U        /*!< SPI and DMA timeout in ms                     */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DISPLAY_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef DISPLAY_WaitIdle(BSP_DISPLAY_TypeDef *hdisp);
+static void              DISPLAY_SetDataSize(BSP_DISPLAY_TypeDef *hdisp, uint32_t DataSize);
+static HAL_StatusTypeDef DISPLAY_Command(BSP_DISPLAY_TypeDef *hdisp, uint8_t Cmd, const uint8_t *pParam,
+                                         uint32_t Size);
+static HAL_StatusTypeDef DISPLAY_SetWindow(BSP_DISPLAY_TypeDef *hdisp, const BSP_DISPLAY_RectTypeDef *pRect);
+static uint32_t          DISPLAY_Area(const BSP_DISPLAY_RectTypeDef *pRect);
+static void              DISPLAY_Union(BSP_DISPLAY_RectTypeDef *pRect, const BSP_DISPLAY_RectTypeDef *pOther);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DISPLAY_Exported_Functions BSP DISPLAY Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DISPLAY_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Take and give back the SPI of a display
+      (+) Send the panel configuration commands
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a display on a SPI.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure initialized in master
+  *              mode, hdmatx in DMA_NORMAL mode with half-word data must be linked.
+  * @param  Width Number of columns, at most BSP_DISPLAY_TILE_PIXELS.
+  * @param  Height Number of rows.
+  * @param  CSPort Chip select port.
+  * @param  CSPin Chip select pin.
+  * @param  DCPort Data/command select port.
+  * @param  DCPin Data/command select pin.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DISPLAY_Init(BSP_DISPLAY_TypeDef *hdisp, SPI_HandleTypeDef *hspi, uint16_t Width,
+                                   uint16_t Height, GPIO_TypeDef *CSPort, uint16_t CSPin,
+                                   GPIO_TypeDef *DCPort, uint16_t DCPin)
+{
+  if ((hdisp == NULL) || (hspi == NULL) || (hspi->hdmatx == NULL) || (CSPort == NULL) || (CSPin == 0U) ||
+      (DCPort == NULL) || (DCPin == 0U) || (Width == 0U) || (Width > BSP_DISPLAY_TILE_PIXELS) ||
+      (Height == 0U) || (hspi->Init.Mode != SPI_MODE_MASTER) ||
+      ((hspi->Init.Direction != SPI_DIRECTION_2LINES) && (hspi->Init.Direction != SPI_DIRECTION_1LINE)) ||
+      (hspi->hdmatx->Init.Mode != DMA_NORMAL) || (hspi->hdmatx->Init.MemInc != DMA_MINC_ENABLE) ||
+      (hspi->hdmatx->Init.MemDataAlignment != DMA_MDATAALIGN_HALFWORD) ||
+      (hspi->hdmatx->Init.PeriphDataAlignment != DMA_PDATAALIGN_HALFWORD))
+  {
+    return HAL_ERROR;
+  }
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hdisp->hspi       = hspi;
+  hdisp->CSPort     = CSPort;
+  hdisp->CSPin      = CSPin;
+  hdisp->DCPort     = DCPort;
+  hdisp->DCPin      = DCPin;
+  hdisp->Width      = Width;
+  hdisp->Height     = Height;
+  hdisp->RectNumber = 0U;
+  hdisp->PixelCount = 0U;
+
+  HAL_GPIO_WritePin(CSPort, CSPin, GPIO_PIN_SET);
+  HAL_GPIO_WritePin(DCPort, DCPin, GPIO_PIN_SET);
+
+  /* The display drives the SPI registers directly from now on */
+  hspi->State = HAL_SPI_STATE_BUSY;
+
+  if (hspi->Init.Direction == SPI_DIRECTION_1LINE)
+  {
+    SPI_1LINE_TX(hspi);
+  }
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN | SPI_CR2_LDMA_TX | SPI_CR2_LDMA_RX);
+  DISPLAY_SetDataSize(hdisp, SPI_DATASIZE_8BIT);
+  __HAL_SPI_ENABLE(hspi);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give the SPI of a display back to the HAL.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DISPLAY_DeInit(BSP_DISPLAY_TypeDef *hdisp)
+{
+  SPI_HandleTypeDef *hspi;
+
+  if ((hdisp == NULL) || (hdisp->hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+  hspi = hdisp->hspi;
+
+  (void)DISPLAY_WaitIdle(hdisp);
+  DISPLAY_SetDataSize(hdisp, hspi->Init.DataSize);
+  __HAL_SPI_DISABLE(hspi);
+  hspi->State = HAL_SPI_STATE_READY;
+
+  hdisp->hspi = NULL;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Send a command and its parameters to the panel.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  Cmd Command.
+  * @param  pParam Pointer to the parameter bytes, may be NULL when Size is 0.
+  * @param  Size Number of parameter bytes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DISPLAY_WriteCommand(BSP_DISPLAY_TypeDef *hdisp, uint8_t Cmd, const uint8_t *pParam,
+                                           uint32_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if ((hdisp == NULL) || (hdisp->hspi == NULL) || ((pParam == NULL) && (Size != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  DISPLAY_SetDataSize(hdisp, SPI_DATASIZE_8BIT);
+
+  HAL_GPIO_WritePin(hdisp->CSPort, hdisp->CSPin, GPIO_PIN_RESET);
+  status = DISPLAY_Command(hdisp, Cmd, pParam, Size);
+  HAL_GPIO_WritePin(hdisp->CSPort, hdisp->CSPin, GPIO_PIN_SET);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DISPLAY_Exported_Functions_Group2 Update functions
+  * @brief    Update functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Update functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Mark an area to be redrawn
+      (+) Render and send the marked areas
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Mark an area to be sent by the next BSP_DISPLAY_Flush().
+  * @note   The area is clipped to the display.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  X First column.
+  * @param  Y First row.
+  * @param  Width Number of columns.
+  * @param  Height Number of rows.
+  * @retval None
+  */
+void BSP_DISPLAY_Invalidate(BSP_DISPLAY_TypeDef *hdisp, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height)
+{
+  BSP_DISPLAY_RectTypeDef rect;
+  BSP_DISPLAY_RectTypeDef merged;
+  uint32_t growth;
+  uint32_t best_growth;
+  uint32_t best;
+  uint32_t index;
+
+  if ((hdisp == NULL) || (hdisp->hspi == NULL) || (Width == 0U) || (Height == 0U) ||
+      (X >= hdisp->Width) || (Y >= hdisp->Height))
+  {
+    return;
+  }
+
+  rect.X0 = X;
+  rect.Y0 = Y;
+  rect.X1 = (uint16_t)((((uint32_t)X + Width) > hdisp->Width) ? (hdisp->Width - 1U) : (X + Width - 1U));
+  rect.Y1 = (uint16_t)((((uint32_t)Y + Height) > hdisp->Height) ? (hdisp->Height - 1U) : (Y + Height - 1U));
+
+  /* Absorb the overlapping rectangles, the union may overlap others again */
+  index = 0U;
+  while (index < hdisp->RectNumber)
+  {
+    if ((hdisp->Rects[index].X0 <= rect.X1) && (rect.X0 <= hdisp->Rects[index].X1) &&
+        (hdisp->Rects[index].Y0 <= rect.Y1) && (rect.Y0 <= hdisp->Rects[index].Y1))
+    {
+      DISPLAY_Union(&rect, &hdisp->Rects[index]);
+      hdisp->RectNumber--;
+      hdisp->Rects[index] = hdisp->Rects[hdisp->RectNumber];
+      index = 0U;
+    }
+    else
+    {
+      index++;
+    }
+  }
+
+  if (hdisp->RectNumber < BSP_DISPLAY_RECT_NUMBER)
+  {
+    hdisp->Rects[hdisp->RectNumber] = rect;
+    hdisp->RectNumber++;
+    return;
+  }
+
+  /* No room left, grow the rectangle adding the fewest pixels */
+  best = 0U;
+  best_growth = 0xFFFFFFFFU;
+  for (index = 0U; index < BSP_DISPLAY_RECT_NUMBER; index++)
+  {
+    merged = hdisp->Rects[index];
+    DISPLAY_Union(&merged, &rect);
+    growth = DISPLAY_Area(&merged) - DISPLAY_Area(&hdisp->Rects[index]);
+    if (growth < best_growth)
+    {
+      best_growth = growth;
+      best = index;
+    }
+  }
+  DISPLAY_Union(&hdisp->Rects[best], &rect);
+}
+
+/**
+  * @brief  Render and send the dirty rectangles.
+  * @note   BSP_DISPLAY_RenderCallback() is called for each band of rows, the
+  *         function returns once the last band is sent.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @retval HAL status, the rectangles stay dirty on error
+  */
+HAL_StatusTypeDef BSP_DISPLAY_Flush(BSP_DISPLAY_TypeDef *hdisp)
+{
+  SPI_HandleTypeDef *hspi;
+  HAL_StatusTypeDef status = HAL_OK;
+  BSP_DISPLAY_RectTypeDef band;
+  uint32_t pending = 0U;
+  uint32_t tile = 0U;
+  uint32_t rows;
+  uint32_t pixels;
+  uint32_t index;
+  uint32_t y;
+
+  if ((hdisp == NULL) || (hdisp->hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+  hspi = hdisp->hspi;
+
+  HAL_GPIO_WritePin(hdisp->CSPort, hdisp->CSPin, GPIO_PIN_RESET);
+
+  for (index = 0U; (status == HAL_OK) && (index < hdisp->RectNumber); index++)
+  {
+    band.X0 = hdisp->Rects[index].X0;
+    band.X1 = hdisp->Rects[index].X1;
+    rows = BSP_DISPLAY_TILE_PIXELS / ((uint32_t)band.X1 - band.X0 + 1U);
+
+    for (y = hdisp->Rects[index].Y0; (status == HAL_OK) && (y <= hdisp->Rects[index].Y1); y += rows)
+    {
+      band.Y0 = (uint16_t)y;
+      band.Y1 = (uint16_t)(((y + rows - 1U) > hdisp->Rects[index].Y1) ? hdisp->Rects[index].Y1 : (y + rows - 1U));
+      pixels  = ((uint32_t)band.X1 - band.X0 + 1U) * ((uint32_t)band.Y1 - band.Y0 + 1U);
+
+      /* Render while the previous band is on the bus */
+      BSP_DISPLAY_RenderCallback(hdisp, hdisp->Tiles[tile], &band);
+
+      if (pending != 0U)
+      {
+        pending = 0U;
+        status = HAL_DMA_PollForTransfer(hspi->hdmatx, HAL_DMA_FULL_TRANSFER, DISPLAY_TIMEOUT);
+      }
+
+      /* The memory write of a rectangle continues over all its bands */
+      if ((status == HAL_OK) && (y == hdisp->Rects[index].Y0))
+      {
+        status = DISPLAY_WaitIdle(hdisp);
+        if (status == HAL_OK)
+        {
+          DISPLAY_SetDataSize(hdisp, SPI_DATASIZE_8BIT);
+          status = DISPLAY_SetWindow(hdisp, &hdisp->Rects[index]);
+        }
+        if (status == HAL_OK)
+        {
+          DISPLAY_SetDataSize(hdisp, SPI_DATASIZE_16BIT);
+          SET_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN);
+        }
+      }
+
+      if (status == HAL_OK)
+      {
+        status = HAL_DMA_Start(hspi->hdmatx, (uint32_t)hdisp->Tiles[tile], (uint32_t)&hspi->Instance->DR, pixels);
+      }
+      if (status == HAL_OK)
+      {
+        pending = 1U;
+        hdisp->PixelCount += pixels;
+        tile ^= 1U;
+      }
+    }
+  }
+
+  if (pending != 0U)
+  {
+    status = HAL_DMA_PollForTransfer(hspi->hdmatx, HAL_DMA_FULL_TRANSFER, DISPLAY_TIMEOUT);
+  }
+  if (status != HAL_OK)
+  {
+    (void)HAL_DMA_Abort(hspi->hdmatx);
+  }
+  if (DISPLAY_WaitIdle(hdisp) != HAL_OK)
+  {
+    status = HAL_TIMEOUT;
+  }
+
+  HAL_GPIO_WritePin(hdisp->CSPort, hdisp->CSPin, GPIO_PIN_SET);
+
+  if (status == HAL_OK)
+  {
+    hdisp->RectNumber = 0U;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Tile render callback.
+  * @note   Called from BSP_DISPLAY_Flush(), the tile is filled with the RGB565
+  *         pixels of pRect row after row.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  pTile Tile to fill, BSP_DISPLAY_TILE_PIXELS pixels at most.
+  * @param  pRect Rectangle to render.
+  * @retval None
+  */
+__weak void BSP_DISPLAY_RenderCallback(BSP_DISPLAY_TypeDef *hdisp, uint16_t *pTile,
+                                       const BSP_DISPLAY_RectTypeDef *pRect)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hdisp);
+  UNUSED(pTile);
+  UNUSED(pRect);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_DISPLAY_RenderCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DISPLAY_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Wait for the end of the SPI transfers and drop the received data.
+  * @note   The Tx DMA request is disabled.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef DISPLAY_WaitIdle(BSP_DISPLAY_TypeDef *hdisp)
+{
+  SPI_TypeDef *spi = hdisp->hspi->Instance;
+  uint32_t tickstart = HAL_GetTick();
+  __IO uint32_t tmpreg;
+
+  while (((spi->SR & SPI_SR_FTLVL) != 0U) || ((spi->SR & SPI_SR_BSY) != 0U))
+  {
+    if ((HAL_GetTick() - tickstart) > DISPLAY_TIMEOUT)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+  CLEAR_BIT(spi->CR2, SPI_CR2_TXDMAEN);
+
+  /* Nothing is read back from the panel */
+  while ((spi->SR & SPI_SR_FRLVL) != 0U)
+  {
+    tmpreg = spi->DR;
+  }
+  tmpreg = spi->SR;
+  UNUSED(tmpreg);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Switch the SPI between 8-bit commands and 16-bit pixels.
+  * @note   The SPI is idle here, it is disabled only when the size changes.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  DataSize SPI_DATASIZE_8BIT or SPI_DATASIZE_16BIT.
+  * @retval None
+  */
+static void DISPLAY_SetDataSize(BSP_DISPLAY_TypeDef *hdisp, uint32_t DataSize)
+{
+  SPI_TypeDef *spi = hdisp->hspi->Instance;
+  uint32_t cr1 = READ_REG(spi->CR1);
+
+  if ((cr1 & SPI_CR1_DFF) != (DataSize & SPI_CR1_DFF_Msk))
+  {
+    WRITE_REG(spi->CR1, cr1 & ~SPI_CR1_SPE);
+    MODIFY_REG(spi->CR1, SPI_CR1_DFF, DataSize & SPI_CR1_DFF_Msk);
+    MODIFY_REG(spi->CR2, SPI_CR2_FRXTH,
+               (DataSize > SPI_DATASIZE_8BIT) ? SPI_RXFIFO_THRESHOLD_HF : SPI_RXFIFO_THRESHOLD_QF);
+    WRITE_REG(spi->CR1, READ_REG(spi->CR1) | (cr1 & SPI_CR1_SPE));
+  }
+}
+
+/**
+  * @brief  Send a command and its parameters in 8-bit mode, chip select low.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  Cmd Command.
+  * @param  pParam Pointer to the parameter bytes.
+  * @param  Size Number of parameter bytes.
+  * @retval HAL status, the data/command pin is left high
+  */
+static HAL_StatusTypeDef DISPLAY_Command(BSP_DISPLAY_TypeDef *hdisp, uint8_t Cmd, const uint8_t *pParam,
+                                         uint32_t Size)
+{
+  SPI_TypeDef *spi = hdisp->hspi->Instance;
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t index;
+
+  HAL_GPIO_WritePin(hdisp->DCPort, hdisp->DCPin, GPIO_PIN_RESET);
+  *((__IO uint8_t *)&spi->DR) = Cmd;
+  if (DISPLAY_WaitIdle(hdisp) != HAL_OK)
+  {
+    HAL_GPIO_WritePin(hdisp->DCPort, hdisp->DCPin, GPIO_PIN_SET);
+    return HAL_TIMEOUT;
+  }
+  HAL_GPIO_WritePin(hdisp->DCPort, hdisp->DCPin, GPIO_PIN_SET);
+
+  for (index = 0U; index < Size; index++)
+  {
+    while ((spi->SR & SPI_SR_TXE) == 0U)
+    {
+      if ((HAL_GetTick() - tickstart) > DISPLAY_TIMEOUT)
+      {
+        return HAL_TIMEOUT;
+      }
+    }
+    *((__IO uint8_t *)&spi->DR) = pParam[index];
+  }
+
+  return DISPLAY_WaitIdle(hdisp);
+}
+
+/**
+  * @brief  Open the panel memory window of a rectangle for writing.
+  * @param  hdisp Pointer to a BSP_DISPLAY_TypeDef structure.
+  * @param  pRect Rectangle.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef DISPLAY_SetWindow(BSP_DISPLAY_TypeDef *hdisp, const BSP_DISPLAY_RectTypeDef *pRect)
+{
+  HAL_StatusTypeDef status;
+  uint8_t param[4];
+
+  param[0] = (uint8_t)(pRect->X0 >> 8U);
+  param[1] = (uint8_t)pRect->X0;
+  param[2] = (uint8_t)(pRect->X1 >> 8U);
+  param[3] = (uint8_t)pRect->X1;
+  status = DISPLAY_Command(hdisp, DISPLAY_CMD_CASET, param, sizeof(param));
+
+  if (status == HAL_OK)
+  {
+    param[0] = (uint8_t)(pRect->Y0 >> 8U);
+    param[1] = (uint8_t)pRect->Y0;
+    param[2] = (uint8_t)(pRect->Y1 >> 8U);
+    param[3] = (uint8_t)pRect->Y1;
+    status = DISPLAY_Command(hdisp, DISPLAY_CMD_RASET, param, sizeof(param));
+  }
+
+  if (status == HAL_OK)
+  {
+    status = DISPLAY_Command(hdisp, DISPLAY_CMD_RAMWR, NULL, 0U);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Return the number of pixels of a rectangle.
+  * @param  pRect Rectangle.
+  * @retval Number of pixels
+  */
+static uint32_t DISPLAY_Area(const BSP_DISPLAY_RectTypeDef *pRect)
+{
+  return ((uint32_t)pRect->X1 - pRect->X0 + 1U) * ((uint32_t)pRect->Y1 - pRect->Y0 + 1U);
+}
+
+/**
+  * @brief  Grow a rectangle to contain another one.
+  * @param  pRect Rectangle to grow.
+  * @param  pOther Rectangle to contain.
+  * @retval None
+  */
+static void DISPLAY_Union(BSP_DISPLAY_RectTypeDef *pRect, const BSP_DISPLAY_RectTypeDef *pOther)
+{
+  if (pOther->X0 < pRect->X0)
+  {
+    pRect->X0 = pOther->X0;
+  }
+  if (pOther->Y0 < pRect->Y0)
+  {
+    pRect->Y0 = pOther->Y0;
+  }
+  if (pOther->X1 > pRect->X1)
+  {
+    pRect->X1 = pOther->X1;
+  }
+  if (pOther->Y1 > pRect->Y1)
+  {
+    pRect->Y1 = pOther->Y1;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
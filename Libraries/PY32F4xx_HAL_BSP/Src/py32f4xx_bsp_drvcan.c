@@ -0,0 +1,1213 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvcan.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver CAN BSP service.
+  *          This file provides the Driver_CAN.h interface of the CANFD over
+  *          the CANFD HAL:
+  *           + Classic and FD frames, bitrate switch
+  *           + A transmit object on the primary transmit buffer
+  *           + A receive object on the receive FIFO, exact and mask filters
+  *           + Restricted, monitor and loopback modes
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Fill the Instance and the Init structure of a CANFD handle, Init being
+       the timings until the first SetBitrate(). HAL_CANFD_MspInit()
+       configures the pins and the kernel clock and enables the CANFD
+       interrupt in the NVIC. The CANFD has no DMA, the driver runs on its
+       interrupts.
+
+   (#) Call BSP_DRVCAN_Attach() with the handle. Driver_CAN1 then owns it,
+       HAL_CANFD_Init() and HAL_CANFD_MspInit() are run by its
+       PowerControl(ARM_POWER_FULL), which leaves the CANFD in the
+       initialization mode with no acceptance filter. PowerControl(ARM_POWER_OFF)
+       stops the CANFD, the HAL having no de-initialization.
+
+   (#) The interrupt handler stays the one of the HAL: HAL_CANFD_IRQHandler().
+       When USE_HAL_CANFD_REGISTER_CALLBACKS is 0 call
+       BSP_DRVCAN_RxCpltCallback(), BSP_DRVCAN_PtbTxCpltCallback(),
+       BSP_DRVCAN_RxFifoOverflowCallback(), BSP_DRVCAN_PassiveErrorCallback()
+       and BSP_DRVCAN_ErrorChangeCallback() from the HAL callbacks of the same
+       names. Otherwise they are registered at power up.
+
+   (#) SetBitrate(), Control(ARM_CAN_SET_FD_MODE) and
+       Control(ARM_CAN_SET_TRANSCEIVER_DELAY) are accepted in the
+       initialization mode and applied by the next SetMode() of another mode.
+       Both phases share the prescaler: the kernel clock must be a multiple
+       of the bitrate times the time quanta of the bit, the same prescaler for
+       the data phase as for the nominal one.
+
+   (#) Object BSP_DRVCAN_OBJ_TX sends one message at a time, signalling
+       ARM_CAN_EVENT_SEND_COMPLETE. Object BSP_DRVCAN_OBJ_RX signals
+       ARM_CAN_EVENT_RECEIVE per message and ARM_CAN_EVENT_RECEIVE_OVERRUN
+       when the FIFO overflows, MessageRead() taking the oldest message.
+       The filters of ObjectSetFilter(), at most 12, are added and removed in
+       the initialization mode. Range filters and the remote frame objects
+       are not supported.
+
+   (#) The unit events report the error passive, warning and bus-off
+       changes read at the error interrupts.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_drvcan.h"
+#include <string.h>
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVCAN BSP DRVCAN
+  * @brief CMSIS-Driver CAN BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Private_Constants BSP DRVCAN Private Constants
+  * @{
+  */
+#define DRVCAN_VERSION            ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+
+#define DRVCAN_FILTERS            12U           /*!< Acceptance filters of the CANFD           */
+#define DRVCAN_FORMAT_MASK        0x1F1607FFU   /*!< All the format bits ignored but IDE       */
+
+#define DRVCAN_PRESC_MAX          32U           /*!< RLSSP PRESC + 1                           */
+#define DRVCAN_NOMINAL_SEG1_MAX   513U          /*!< ACBTR AC_SEG_1 + 2                        */
+#define DRVCAN_DATA_SEG1_MAX      257U          /*!< FDBTR FD_SEG_1 + 2                        */
+#define DRVCAN_SEG2_MAX           128U          /*!< AC_SEG_2 and FD_SEG_2 + 1                 */
+#define DRVCAN_SSPOFF_MAX         255U          /*!< RLSSP FD_SSPOFF                           */
+
+#define DRVCAN_FLAG_INITIALIZED   0x01U
+#define DRVCAN_FLAG_POWERED       0x02U
+#define DRVCAN_FLAG_STARTED       0x04U         /*!< Mode other than the initialization one    */
+#define DRVCAN_FLAG_SINGLE_SHOT   0x08U         /*!< Retransmission disabled                   */
+
+#define DRVCAN_IT_USED            (CANFD_IT_RX_COMPLETE | CANFD_IT_TX_PTB_COMPLETE | CANFD_IT_RX_FIFO_OVERFLOW | \
+                                   CANFD_IT_ERROR_PASSIVE | CANFD_IT_ERROR_TOGGLE)
+/**
+  * @}
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Private_Types BSP DRVCAN Private Types
+  * @{
+  */
+
+/**
+  * @brief  Acceptance filter of the receive object
+  */
+typedef struct
+{
+  uint32_t                Id;           /*!< ARM_CAN_STANDARD_ID() or ARM_CAN_EXTENDED_ID()        */
+
+  uint32_t                Mask;         /*!< Identifier bits compared, set to 1                    */
+
+  uint32_t                Used;         /*!< 1 when the channel holds the filter                   */
+
+} DRVCAN_FilterTypeDef;
+
+/**
+  * @brief  Driver state of the CANFD
+  */
+typedef struct
+{
+  CANFD_HandleTypeDef     *hcanfd;      /*!< Attached CANFD, NULL when none                        */
+
+  ARM_CAN_SignalUnitEvent_t   cb_unit_event;   /*!< Unit event callback of Initialize()            */
+
+  ARM_CAN_SignalObjectEvent_t cb_object_event; /*!< Object event callback of Initialize()          */
+
+  uint32_t                Flags;        /*!< DRVCAN_FLAG_xxx                                       */
+
+  uint32_t                ObjConfig[2]; /*!< ARM_CAN_OBJ_xxx of both objects                       */
+
+  uint32_t                UnitState;    /*!< ARM_CAN_UNIT_STATE_xxx last signalled                 */
+
+  uint32_t                Warning;      /*!< 1 while an error counter is at the warning limit      */
+
+  DRVCAN_FilterTypeDef    Filters[DRVCAN_FILTERS]; /*!< Filters, channel order                     */
+
+} DRVCAN_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Private_Variables BSP DRVCAN Private Variables
+  * @{
+  */
+static DRVCAN_ResourcesTypeDef DRVCAN_Resources;
+
+static const uint8_t DRVCAN_DlcBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+static const ARM_CAN_CAPABILITIES DRVCAN_Capabilities =
+{
+  2U,   /* num_objects         */
+  0U,   /* reentrant_operation */
+  1U,   /* fd_mode             */
+  1U,   /* restricted_mode     */
+  1U,   /* monitor_mode        */
+  1U,   /* internal_loopback   */
+  1U,   /* external_loopback   */
+  0U    /* reserved            */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVCAN_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION       DRVCAN_GetVersion(void);
+static ARM_CAN_CAPABILITIES     DRVCAN_GetCapabilities(void);
+static int32_t                  DRVCAN_Initialize(ARM_CAN_SignalUnitEvent_t cb_unit_event,
+                                                  ARM_CAN_SignalObjectEvent_t cb_object_event);
+static int32_t                  DRVCAN_Uninitialize(void);
+static int32_t                  DRVCAN_PowerControl(ARM_POWER_STATE state);
+static uint32_t                 DRVCAN_GetClock(void);
+static int32_t                  DRVCAN_SetBitrate(ARM_CAN_BITRATE_SELECT select, uint32_t bitrate,
+                                                  uint32_t bit_segments);
+static int32_t                  DRVCAN_SetMode(ARM_CAN_MODE mode);
+static ARM_CAN_OBJ_CAPABILITIES DRVCAN_ObjectGetCapabilities(uint32_t obj_idx);
+static int32_t                  DRVCAN_ObjectSetFilter(uint32_t obj_idx, ARM_CAN_FILTER_OPERATION operation,
+                                                       uint32_t id, uint32_t arg);
+static int32_t                  DRVCAN_ObjectConfigure(uint32_t obj_idx, ARM_CAN_OBJ_CONFIG obj_cfg);
+static int32_t                  DRVCAN_MessageSend(uint32_t obj_idx, ARM_CAN_MSG_INFO *msg_info,
+                                                   const uint8_t *data, uint8_t size);
+static int32_t                  DRVCAN_MessageRead(uint32_t obj_idx, ARM_CAN_MSG_INFO *msg_info,
+                                                   uint8_t *data, uint8_t size);
+static int32_t                  DRVCAN_Control(uint32_t control, uint32_t arg);
+static ARM_CAN_STATUS           DRVCAN_GetStatus(void);
+static int32_t                  DRVCAN_WriteFilter(uint32_t Channel, const DRVCAN_FilterTypeDef *pFilter);
+static uint32_t                 DRVCAN_SizeToDlc(uint32_t Size);
+static void                     DRVCAN_UpdateUnit(void);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVCAN_Exported_Variables
+  * @{
+  */
+ARM_DRIVER_CAN Driver_CAN1 =
+{
+  DRVCAN_GetVersion,
+  DRVCAN_GetCapabilities,
+  DRVCAN_Initialize,
+  DRVCAN_Uninitialize,
+  DRVCAN_PowerControl,
+  DRVCAN_GetClock,
+  DRVCAN_SetBitrate,
+  DRVCAN_SetMode,
+  DRVCAN_ObjectGetCapabilities,
+  DRVCAN_ObjectSetFilter,
+  DRVCAN_ObjectConfigure,
+  DRVCAN_MessageSend,
+  DRVCAN_MessageRead,
+  DRVCAN_Control,
+  DRVCAN_GetStatus
+};
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Exported_Functions BSP DRVCAN Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVCAN_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides a function allowing to:
+      (+) Give the CANFD handle to the driver
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach the CANFD handle to the driver.
+  * @note   The handle is not initialized here, PowerControl(ARM_POWER_FULL)
+  *         does it with the Init structure given.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure, Instance and Init filled.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVCAN_Attach(CANFD_HandleTypeDef *hcanfd)
+{
+  if ((hcanfd == NULL) || (hcanfd->Instance != CANFD))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((DRVCAN_Resources.Flags & DRVCAN_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  DRVCAN_Resources.hcanfd = hcanfd;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVCAN_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handlers to call from the CANFD HAL callbacks
+    when USE_HAL_CANFD_REGISTER_CALLBACKS is 0.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  CANFD receive handler of the driver.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVCAN_RxCpltCallback(CANFD_HandleTypeDef *hcanfd)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  if ((hcanfd == pRes->hcanfd) && (pRes->ObjConfig[BSP_DRVCAN_OBJ_RX] == ARM_CAN_OBJ_RX) &&
+      (pRes->cb_object_event != NULL))
+  {
+    pRes->cb_object_event(BSP_DRVCAN_OBJ_RX, ARM_CAN_EVENT_RECEIVE);
+  }
+}
+
+/**
+  * @brief  CANFD primary transmit buffer complete handler of the driver.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVCAN_PtbTxCpltCallback(CANFD_HandleTypeDef *hcanfd)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  if ((hcanfd == pRes->hcanfd) && (pRes->ObjConfig[BSP_DRVCAN_OBJ_TX] == ARM_CAN_OBJ_TX) &&
+      (pRes->cb_object_event != NULL))
+  {
+    pRes->cb_object_event(BSP_DRVCAN_OBJ_TX, ARM_CAN_EVENT_SEND_COMPLETE);
+  }
+}
+
+/**
+  * @brief  CANFD receive FIFO overflow handler of the driver.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVCAN_RxFifoOverflowCallback(CANFD_HandleTypeDef *hcanfd)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  if ((hcanfd == pRes->hcanfd) && (pRes->ObjConfig[BSP_DRVCAN_OBJ_RX] == ARM_CAN_OBJ_RX) &&
+      (pRes->cb_object_event != NULL))
+  {
+    pRes->cb_object_event(BSP_DRVCAN_OBJ_RX, ARM_CAN_EVENT_RECEIVE_OVERRUN);
+  }
+}
+
+/**
+  * @brief  CANFD error passive change handler of the driver.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVCAN_PassiveErrorCallback(CANFD_HandleTypeDef *hcanfd)
+{
+  if (hcanfd == DRVCAN_Resources.hcanfd)
+  {
+    DRVCAN_UpdateUnit();
+  }
+}
+
+/**
+  * @brief  CANFD error warning and bus-off change handler of the driver.
+  * @param  hcanfd Pointer to a CANFD_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVCAN_ErrorChangeCallback(CANFD_HandleTypeDef *hcanfd)
+{
+  if (hcanfd == DRVCAN_Resources.hcanfd)
+  {
+    DRVCAN_UpdateUnit();
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVCAN_Private_Functions BSP DRVCAN Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVCAN_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_CAN_API_VERSION, DRVCAN_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities
+  */
+static ARM_CAN_CAPABILITIES DRVCAN_GetCapabilities(void)
+{
+  return DRVCAN_Capabilities;
+}
+
+/**
+  * @brief  Initialize the driver.
+  * @param  cb_unit_event Unit event callback, NULL for none.
+  * @param  cb_object_event Object event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached CANFD
+  */
+static int32_t DRVCAN_Initialize(ARM_CAN_SignalUnitEvent_t cb_unit_event,
+                                 ARM_CAN_SignalObjectEvent_t cb_object_event)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  if (pRes->hcanfd == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRes->Flags & DRVCAN_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  pRes->cb_unit_event   = cb_unit_event;
+  pRes->cb_object_event = cb_object_event;
+  pRes->Flags           = DRVCAN_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize the driver, powering it off first.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_Uninitialize(void)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  (void)DRVCAN_PowerControl(ARM_POWER_OFF);
+
+  pRes->cb_unit_event   = NULL;
+  pRes->cb_object_event = NULL;
+  pRes->Flags           = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power the driver on or off.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_PowerControl(ARM_POWER_STATE state)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_HandleTypeDef *hcanfd = pRes->hcanfd;
+  uint32_t i;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        (void)HAL_CANFD_DeactivateNotification(hcanfd, DRVCAN_IT_USED);
+        (void)HAL_CANFD_Stop(hcanfd);
+      }
+      pRes->ObjConfig[BSP_DRVCAN_OBJ_TX] = ARM_CAN_OBJ_INACTIVE;
+      pRes->ObjConfig[BSP_DRVCAN_OBJ_RX] = ARM_CAN_OBJ_INACTIVE;
+      pRes->Flags &= ~(DRVCAN_FLAG_POWERED | DRVCAN_FLAG_STARTED | DRVCAN_FLAG_SINGLE_SHOT);
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVCAN_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVCAN_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+      if (HAL_CANFD_Init(hcanfd) != HAL_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+
+#if USE_HAL_CANFD_REGISTER_CALLBACKS == 1
+      /* After HAL_CANFD_Init(), which set the callbacks to their default from the reset state */
+      if ((HAL_CANFD_RegisterCallback(hcanfd, HAL_CANFD_RX_COMPLETE_CB_ID, BSP_DRVCAN_RxCpltCallback) != HAL_OK) ||
+          (HAL_CANFD_RegisterCallback(hcanfd, HAL_CANFD_PTB_TX_COMPLETE_CB_ID, BSP_DRVCAN_PtbTxCpltCallback) != HAL_OK) ||
+          (HAL_CANFD_RegisterCallback(hcanfd, HAL_CANFD_RX_FIFO_OVERFLOW_CB_ID, BSP_DRVCAN_RxFifoOverflowCallback) != HAL_OK) ||
+          (HAL_CANFD_RegisterCallback(hcanfd, HAL_CANFD_PASSIVE_ERROR_CB_ID, BSP_DRVCAN_PassiveErrorCallback) != HAL_OK) ||
+          (HAL_CANFD_RegisterCallback(hcanfd, HAL_CANFD_ERROR_CHANGE_CB_ID, BSP_DRVCAN_ErrorChangeCallback) != HAL_OK))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+#endif /* USE_HAL_CANFD_REGISTER_CALLBACKS */
+
+      /* No message is received before a filter is added */
+      for (i = 0U; i < DRVCAN_FILTERS; i++)
+      {
+        pRes->Filters[i].Used = 0U;
+        (void)DRVCAN_WriteFilter(i, NULL);
+      }
+
+      pRes->ObjConfig[BSP_DRVCAN_OBJ_TX] = ARM_CAN_OBJ_INACTIVE;
+      pRes->ObjConfig[BSP_DRVCAN_OBJ_RX] = ARM_CAN_OBJ_INACTIVE;
+      pRes->UnitState = ARM_CAN_UNIT_STATE_INACTIVE;
+      pRes->Warning   = 0U;
+      pRes->Flags    |= DRVCAN_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Get the kernel clock of the CANFD.
+  * @retval Clock frequency, Hz
+  */
+static uint32_t DRVCAN_GetClock(void)
+{
+  return HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_CAN);
+}
+
+/**
+  * @brief  Set the nominal or the data bitrate, in the initialization mode.
+  * @param  select ARM_CAN_BITRATE_NOMINAL or ARM_CAN_BITRATE_FD_DATA.
+  * @param  bitrate Bitrate, bit/s.
+  * @param  bit_segments ARM_CAN_BIT_PROP_SEG(), ARM_CAN_BIT_PHASE_SEG1(),
+  *                      ARM_CAN_BIT_PHASE_SEG2() and ARM_CAN_BIT_SJW().
+  * @retval Execution status
+  */
+static int32_t DRVCAN_SetBitrate(ARM_CAN_BITRATE_SELECT select, uint32_t bitrate, uint32_t bit_segments)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_InitTypeDef *init;
+  uint32_t seg1;
+  uint32_t seg2;
+  uint32_t sjw;
+  uint32_t tq;
+  uint32_t clock;
+  uint32_t presc;
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+  init = &pRes->hcanfd->Init;
+
+  seg1 = ((bit_segments & ARM_CAN_BIT_PROP_SEG_Msk) >> ARM_CAN_BIT_PROP_SEG_Pos) +
+         ((bit_segments & ARM_CAN_BIT_PHASE_SEG1_Msk) >> ARM_CAN_BIT_PHASE_SEG1_Pos);
+  seg2 = (bit_segments & ARM_CAN_BIT_PHASE_SEG2_Msk) >> ARM_CAN_BIT_PHASE_SEG2_Pos;
+  sjw  = (bit_segments & ARM_CAN_BIT_SJW_Msk) >> ARM_CAN_BIT_SJW_Pos;
+
+  if ((seg1 < 2U) || (seg1 > ((select == ARM_CAN_BITRATE_NOMINAL) ? DRVCAN_NOMINAL_SEG1_MAX : DRVCAN_DATA_SEG1_MAX)))
+  {
+    return ARM_CAN_INVALID_BIT_PHASE_SEG1;
+  }
+  if ((seg2 == 0U) || (seg2 > DRVCAN_SEG2_MAX))
+  {
+    return ARM_CAN_INVALID_BIT_PHASE_SEG2;
+  }
+  if ((sjw == 0U) || (sjw > seg2))
+  {
+    return ARM_CAN_INVALID_BIT_SJW;
+  }
+
+  /* Sync segment, segment 1, segment 2 */
+  tq    = 1U + seg1 + seg2;
+  clock = DRVCAN_GetClock();
+  if ((bitrate == 0U) || ((clock % (bitrate * tq)) != 0U))
+  {
+    return ARM_CAN_INVALID_BITRATE;
+  }
+  presc = clock / (bitrate * tq);
+  if ((presc == 0U) || (presc > DRVCAN_PRESC_MAX))
+  {
+    return ARM_CAN_INVALID_BITRATE;
+  }
+
+  switch (select)
+  {
+    case ARM_CAN_BITRATE_NOMINAL:
+      init->Prescaler            = presc;
+      init->NominalTimeSeg1      = seg1;
+      init->NominalTimeSeg2      = seg2;
+      init->NominalSyncJumpWidth = sjw;
+      return ARM_DRIVER_OK;
+
+    case ARM_CAN_BITRATE_FD_DATA:
+      if (presc != init->Prescaler)
+      {
+        return ARM_CAN_INVALID_BITRATE;
+      }
+      init->DataTimeSeg1      = seg1;
+      init->DataTimeSeg2      = seg2;
+      init->DataSyncJumpWidth = sjw;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_CAN_INVALID_BITRATE_SELECT;
+  }
+}
+
+/**
+  * @brief  Set the operating mode.
+  * @note   Leaving the initialization mode applies the Init structure with
+  *         HAL_CANFD_Init(), without HAL_CANFD_MspInit(), then starts the CANFD.
+  * @param  mode ARM_CAN_MODE_xxx.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_SetMode(ARM_CAN_MODE mode)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_HandleTypeDef *hcanfd = pRes->hcanfd;
+  uint32_t hal_mode;
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (mode)
+  {
+    case ARM_CAN_MODE_INITIALIZATION:
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        (void)HAL_CANFD_DeactivateNotification(hcanfd, DRVCAN_IT_USED);
+        (void)HAL_CANFD_Stop(hcanfd);
+        pRes->Flags &= ~DRVCAN_FLAG_STARTED;
+      }
+      pRes->UnitState = ARM_CAN_UNIT_STATE_INACTIVE;
+      pRes->Warning   = 0U;
+      if (pRes->cb_unit_event != NULL)
+      {
+        pRes->cb_unit_event(ARM_CAN_EVENT_UNIT_INACTIVE);
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_CAN_MODE_NORMAL:
+      hal_mode = CANFD_MODE_NORMAL;
+      break;
+    case ARM_CAN_MODE_RESTRICTED:
+      hal_mode = CANFD_MODE_RESTRICTED_OPERATION;
+      break;
+    case ARM_CAN_MODE_MONITOR:
+      hal_mode = CANFD_MODE_SILENT;
+      break;
+    case ARM_CAN_MODE_LOOPBACK_INTERNAL:
+      hal_mode = CANFD_MODE_LOOPBACK_INT;
+      break;
+    case ARM_CAN_MODE_LOOPBACK_EXTERNAL:
+      hal_mode = CANFD_MODE_LOOPBACK_EXT_ACK;
+      break;
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+  {
+    (void)HAL_CANFD_DeactivateNotification(hcanfd, DRVCAN_IT_USED);
+    (void)HAL_CANFD_Stop(hcanfd);
+    pRes->Flags &= ~DRVCAN_FLAG_STARTED;
+  }
+
+  /* HAL_CANFD_Start() sets the bits of its mode only */
+  CLEAR_BIT(hcanfd->Instance->TSNCR, CANFD_TSNCR_ROP);
+  CLEAR_BIT(hcanfd->Instance->MCR, (CANFD_MCR_LBME | CANFD_MCR_LBMI | CANFD_MCR_SACK | CANFD_MCR_LOM));
+
+  hcanfd->Init.Mode = hal_mode;
+  if ((HAL_CANFD_Init(hcanfd) != HAL_OK) || (HAL_CANFD_Start(hcanfd) != HAL_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  (void)HAL_CANFD_ConfigRetransmissionLimit(hcanfd, ((pRes->Flags & DRVCAN_FLAG_SINGLE_SHOT) != 0U) ?
+                                            CANFD_AUTO_RETRANSMISSION_1TRANSFER : CANFD_AUTO_RETRANSMISSION_NO_LIMIT);
+  (void)HAL_CANFD_ActivateNotification(hcanfd, DRVCAN_IT_USED);
+  pRes->Flags |= DRVCAN_FLAG_STARTED;
+
+  pRes->UnitState = ARM_CAN_UNIT_STATE_ACTIVE;
+  if (pRes->cb_unit_event != NULL)
+  {
+    pRes->cb_unit_event(ARM_CAN_EVENT_UNIT_ACTIVE);
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the capabilities of an object.
+  * @param  obj_idx BSP_DRVCAN_OBJ_TX or BSP_DRVCAN_OBJ_RX.
+  * @retval Object capabilities, none for another index
+  */
+static ARM_CAN_OBJ_CAPABILITIES DRVCAN_ObjectGetCapabilities(uint32_t obj_idx)
+{
+  ARM_CAN_OBJ_CAPABILITIES capabilities = {0U};
+
+  if (obj_idx == BSP_DRVCAN_OBJ_TX)
+  {
+    capabilities.tx            = 1U;
+    capabilities.message_depth = 1U;
+  }
+  else if (obj_idx == BSP_DRVCAN_OBJ_RX)
+  {
+    capabilities.rx               = 1U;
+    capabilities.multiple_filters = 1U;
+    capabilities.exact_filtering  = 1U;
+    capabilities.mask_filtering   = 1U;
+    capabilities.message_depth    = 1U;
+  }
+  else
+  {
+    /* No object */
+  }
+
+  return capabilities;
+}
+
+/**
+  * @brief  Add or remove an acceptance filter of the receive object.
+  * @param  obj_idx BSP_DRVCAN_OBJ_RX.
+  * @param  operation Exact or maskable filter operation.
+  * @param  id ARM_CAN_STANDARD_ID() or ARM_CAN_EXTENDED_ID().
+  * @param  arg Mask of a maskable filter, 1 for the bits compared.
+  * @retval Execution status, ARM_DRIVER_ERROR_SPECIFIC when the 12 filters are used
+  */
+static int32_t DRVCAN_ObjectSetFilter(uint32_t obj_idx, ARM_CAN_FILTER_OPERATION operation, uint32_t id, uint32_t arg)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  DRVCAN_FilterTypeDef filter;
+  uint32_t add;
+  uint32_t i;
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (obj_idx != BSP_DRVCAN_OBJ_RX)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  filter.Id   = id;
+  filter.Used = 1U;
+  switch (operation)
+  {
+    case ARM_CAN_FILTER_ID_EXACT_ADD:
+    case ARM_CAN_FILTER_ID_EXACT_REMOVE:
+      filter.Mask = 0x1FFFFFFFU;
+      break;
+    case ARM_CAN_FILTER_ID_MASKABLE_ADD:
+    case ARM_CAN_FILTER_ID_MASKABLE_REMOVE:
+      filter.Mask = arg & 0x1FFFFFFFU;
+      break;
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  add = ((operation == ARM_CAN_FILTER_ID_EXACT_ADD) || (operation == ARM_CAN_FILTER_ID_MASKABLE_ADD)) ? 1U : 0U;
+
+  for (i = 0U; i < DRVCAN_FILTERS; i++)
+  {
+    if (add != 0U)
+    {
+      if (pRes->Filters[i].Used == 0U)
+      {
+        pRes->Filters[i] = filter;
+        return DRVCAN_WriteFilter(i, &filter);
+      }
+    }
+    else if ((pRes->Filters[i].Used != 0U) && (pRes->Filters[i].Id == filter.Id) &&
+             (pRes->Filters[i].Mask == filter.Mask))
+    {
+      pRes->Filters[i].Used = 0U;
+      return DRVCAN_WriteFilter(i, NULL);
+    }
+    else
+    {
+      /* Next channel */
+    }
+  }
+
+  return (add != 0U) ? ARM_DRIVER_ERROR_SPECIFIC : ARM_DRIVER_ERROR;
+}
+
+/**
+  * @brief  Configure an object.
+  * @param  obj_idx BSP_DRVCAN_OBJ_TX or BSP_DRVCAN_OBJ_RX.
+  * @param  obj_cfg ARM_CAN_OBJ_INACTIVE, or ARM_CAN_OBJ_TX for BSP_DRVCAN_OBJ_TX
+  *                 and ARM_CAN_OBJ_RX for BSP_DRVCAN_OBJ_RX.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_ObjectConfigure(uint32_t obj_idx, ARM_CAN_OBJ_CONFIG obj_cfg)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (((obj_idx == BSP_DRVCAN_OBJ_TX) && (obj_cfg != ARM_CAN_OBJ_TX) && (obj_cfg != ARM_CAN_OBJ_INACTIVE)) ||
+      ((obj_idx == BSP_DRVCAN_OBJ_RX) && (obj_cfg != ARM_CAN_OBJ_RX) && (obj_cfg != ARM_CAN_OBJ_INACTIVE)) ||
+      (obj_idx > BSP_DRVCAN_OBJ_RX))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  pRes->ObjConfig[obj_idx] = (uint32_t)obj_cfg;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Send a message on the primary transmit buffer.
+  * @param  obj_idx BSP_DRVCAN_OBJ_TX.
+  * @param  msg_info Identifier and format, dlc for a remote frame.
+  * @param  data Data bytes, padded with 0 up to the next FD length.
+  * @param  size Number of data bytes, at most 8 or 64 for an FD frame.
+  * @retval Bytes accepted, or execution status
+  */
+static int32_t DRVCAN_MessageSend(uint32_t obj_idx, ARM_CAN_MSG_INFO *msg_info, const uint8_t *data, uint8_t size)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_HandleTypeDef *hcanfd = pRes->hcanfd;
+  CANFD_TxHeaderTypeDef header;
+  uint8_t buffer[64];
+  uint32_t dlc;
+
+  if ((obj_idx != BSP_DRVCAN_OBJ_TX) || (msg_info == NULL) || ((data == NULL) && (size != 0U)) ||
+      (size > ((msg_info->edl != 0U) ? 64U : 8U)) ||
+      ((msg_info->edl != 0U) && (hcanfd->Init.FrameFormat == CANFD_FRAME_CLASSIC)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if (((pRes->Flags & DRVCAN_FLAG_STARTED) == 0U) || (pRes->ObjConfig[BSP_DRVCAN_OBJ_TX] != ARM_CAN_OBJ_TX))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (READ_BIT(hcanfd->Instance->MCR, CANFD_MCR_TPE) != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  if ((msg_info->id & ARM_CAN_ID_IDE_Msk) != 0U)
+  {
+    header.IdType     = CANFD_EXTENDED_ID;
+    header.Identifier = msg_info->id & 0x1FFFFFFFU;
+  }
+  else
+  {
+    header.IdType     = CANFD_STANDARD_ID;
+    header.Identifier = msg_info->id & 0x7FFU;
+  }
+  header.Handle = 0U;
+
+  /* The HAL copies the whole length of the code from the data */
+  memset(buffer, 0, sizeof(buffer));
+  if (msg_info->rtr != 0U)
+  {
+    header.TxFrameType = CANFD_REMOTE_FRAME;
+    header.FrameFormat = CANFD_FRAME_CLASSIC;
+    dlc                = msg_info->dlc;
+    size               = 0U;
+  }
+  else
+  {
+    header.TxFrameType = CANFD_DATA_FRAME;
+    header.FrameFormat = (msg_info->edl == 0U) ? CANFD_FRAME_CLASSIC :
+                         (msg_info->brs != 0U) ? CANFD_FRAME_FD_BRS : CANFD_FRAME_FD_NO_BRS;
+    dlc = DRVCAN_SizeToDlc(size);
+    if (size != 0U)
+    {
+      memcpy(buffer, data, size);
+    }
+  }
+  header.DataLength = dlc;
+
+  if ((HAL_CANFD_AddMessageToTxFifo(hcanfd, &header, buffer, CANFD_TX_FIFO_PTB) != HAL_OK) ||
+      (HAL_CANFD_ActivateTxRequest(hcanfd, CANFD_TXFIFO_PTB_SEND) != HAL_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return (int32_t)size;
+}
+
+/**
+  * @brief  Read the oldest message of the receive FIFO.
+  * @param  obj_idx BSP_DRVCAN_OBJ_RX.
+  * @param  msg_info Identifier and format read.
+  * @param  data Data bytes read.
+  * @param  size Room of data, longer messages being truncated.
+  * @retval Bytes read, or execution status, ARM_CAN_NO_MESSAGE_AVAILABLE on an empty FIFO
+  */
+static int32_t DRVCAN_MessageRead(uint32_t obj_idx, ARM_CAN_MSG_INFO *msg_info, uint8_t *data, uint8_t size)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_HandleTypeDef *hcanfd = pRes->hcanfd;
+  CANFD_RxHeaderTypeDef header;
+  uint8_t buffer[64];
+  uint32_t bytes;
+
+  if ((obj_idx != BSP_DRVCAN_OBJ_RX) || (msg_info == NULL) || ((data == NULL) && (size != 0U)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if (((pRes->Flags & DRVCAN_FLAG_STARTED) == 0U) || (pRes->ObjConfig[BSP_DRVCAN_OBJ_RX] != ARM_CAN_OBJ_RX))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (__HAL_CANFD_GET_RX_FIFO_FILL_LEVEL(hcanfd) == CANFD_RX_FIFO_EMPTY)
+  {
+    return ARM_CAN_NO_MESSAGE_AVAILABLE;
+  }
+  if (HAL_CANFD_GetRxMessage(hcanfd, &header, buffer) != HAL_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  msg_info->id  = (header.IdType == CANFD_EXTENDED_ID) ? ARM_CAN_EXTENDED_ID(header.Identifier) :
+                  ARM_CAN_STANDARD_ID(header.Identifier);
+  msg_info->rtr = (header.RxFrameType == CANFD_REMOTE_FRAME) ? 1U : 0U;
+  msg_info->edl = ((header.FrameFormat & CANFD_LLC_FORMAT_FDF) != 0U) ? 1U : 0U;
+  msg_info->brs = ((header.FrameFormat & CANFD_LLC_FORMAT_BRS) != 0U) ? 1U : 0U;
+  msg_info->esi = (header.ErrorStateIndicator == CANFD_ESI_PASSIVE) ? 1U : 0U;
+  msg_info->dlc = header.DataLength & 0x0FU;
+
+  bytes = (msg_info->rtr != 0U) ? 0U : DRVCAN_DlcBytes[msg_info->dlc];
+  if (bytes > size)
+  {
+    bytes = size;
+  }
+  if (bytes != 0U)
+  {
+    memcpy(data, buffer, bytes);
+  }
+
+  return (int32_t)bytes;
+}
+
+/**
+  * @brief  Control the driver.
+  * @param  control ARM_CAN_xxx operation.
+  * @param  arg Argument of the operation.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_Control(uint32_t control, uint32_t arg)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_HandleTypeDef *hcanfd = pRes->hcanfd;
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (control & ARM_CAN_CONTROL_Msk)
+  {
+    case ARM_CAN_SET_FD_MODE:
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      hcanfd->Init.FrameFormat = (arg != 0U) ? CANFD_FRAME_FD_BRS : CANFD_FRAME_CLASSIC;
+      return ARM_DRIVER_OK;
+
+    case ARM_CAN_ABORT_MESSAGE_SEND:
+      if (arg != BSP_DRVCAN_OBJ_TX)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        (void)HAL_CANFD_AbortTxRequest(hcanfd, CANFD_TXFIFO_PTB_SEND);
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_CAN_CONTROL_RETRANSMISSION:
+      if (arg != 0U)
+      {
+        pRes->Flags &= ~DRVCAN_FLAG_SINGLE_SHOT;
+      }
+      else
+      {
+        pRes->Flags |= DRVCAN_FLAG_SINGLE_SHOT;
+      }
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        (void)HAL_CANFD_ConfigRetransmissionLimit(hcanfd, (arg != 0U) ? CANFD_AUTO_RETRANSMISSION_NO_LIMIT :
+                                                  CANFD_AUTO_RETRANSMISSION_1TRANSFER);
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_CAN_SET_TRANSCEIVER_DELAY:
+      if ((pRes->Flags & DRVCAN_FLAG_STARTED) != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      if (arg > DRVCAN_SSPOFF_MAX)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      /* Secondary sample point of the data phase, the delay plus the data segment 1 */
+      hcanfd->Init.SecondSamplePointOffset = arg;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Get the driver status.
+  * @retval Status
+  */
+static ARM_CAN_STATUS DRVCAN_GetStatus(void)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_ProtocolStatusTypeDef protocol;
+  ARM_CAN_STATUS status = {0U};
+
+  if ((pRes->Flags & DRVCAN_FLAG_POWERED) == 0U)
+  {
+    return status;
+  }
+
+  (void)HAL_CANFD_GetProtocolStatus(pRes->hcanfd, &protocol);
+
+  if ((pRes->Flags & DRVCAN_FLAG_STARTED) == 0U)
+  {
+    status.unit_state = ARM_CAN_UNIT_STATE_INACTIVE;
+  }
+  else if (protocol.BusOff != 0U)
+  {
+    status.unit_state = ARM_CAN_UNIT_STATE_BUS_OFF;
+  }
+  else if (protocol.ErrorPassive != 0U)
+  {
+    status.unit_state = ARM_CAN_UNIT_STATE_PASSIVE;
+  }
+  else
+  {
+    status.unit_state = ARM_CAN_UNIT_STATE_ACTIVE;
+  }
+
+  switch (protocol.LastErrorCode)
+  {
+    case CANFD_PROTOCOL_BIT_ERROR:
+      status.last_error_code = ARM_CAN_LEC_BIT_ERROR;
+      break;
+    case CANFD_PROTOCOL_FORM_ERROR:
+      status.last_error_code = ARM_CAN_LEC_FORM_ERROR;
+      break;
+    case CANFD_PROTOCOL_STUFF_ERROR:
+      status.last_error_code = ARM_CAN_LEC_STUFF_ERROR;
+      break;
+    case CANFD_PROTOCOL_ACK_ERROR:
+      status.last_error_code = ARM_CAN_LEC_ACK_ERROR;
+      break;
+    case CANFD_PROTOCOL_CRC_ERROR:
+      status.last_error_code = ARM_CAN_LEC_CRC_ERROR;
+      break;
+    default:
+      status.last_error_code = ARM_CAN_LEC_NO_ERROR;
+      break;
+  }
+  status.tx_error_count = protocol.TxErrorCnt;
+  status.rx_error_count = protocol.RxErrorCnt;
+
+  return status;
+}
+
+/**
+  * @brief  Program or disable an acceptance filter channel, in the initialization mode.
+  * @param  Channel Filter channel, 0 to 11.
+  * @param  pFilter Filter, NULL to disable the channel.
+  * @retval Execution status
+  */
+static int32_t DRVCAN_WriteFilter(uint32_t Channel, const DRVCAN_FilterTypeDef *pFilter)
+{
+  CANFD_FilterTypeDef sFilter;
+  uint32_t idmask;
+
+  sFilter.FilterChannel = Channel;
+  if (pFilter == NULL)
+  {
+    sFilter.IdType       = CANFD_STANDARD_ID;
+    sFilter.Rank         = CANFD_FILTER_RANK_NONE;
+    sFilter.FilterID     = 0U;
+    sFilter.FilterFormat = 0U;
+    sFilter.MaskID       = 0U;
+    sFilter.MaskFormat   = 0U;
+  }
+  else
+  {
+    /* The mask of the HAL ignores the bits set to 1 */
+    if ((pFilter->Id & ARM_CAN_ID_IDE_Msk) != 0U)
+    {
+      idmask               = 0x1FFFFFFFU;
+      sFilter.IdType       = CANFD_EXTENDED_ID;
+      sFilter.FilterFormat = CANFD_LLC_FORMAT_IDE;
+    }
+    else
+    {
+      idmask               = 0x7FFU;
+      sFilter.IdType       = CANFD_STANDARD_ID;
+      sFilter.FilterFormat = 0U;
+    }
+    sFilter.Rank       = CANFD_FILTER_RANK_CHANNEL_NUMBER;
+    sFilter.FilterID   = pFilter->Id & idmask;
+    sFilter.MaskID     = ~pFilter->Mask & idmask;
+    sFilter.MaskFormat = DRVCAN_FORMAT_MASK;
+  }
+
+  return (HAL_CANFD_ConfigFilter(DRVCAN_Resources.hcanfd, &sFilter) == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+}
+
+/**
+  * @brief  Get the data length code of a number of bytes.
+  * @param  Size Number of bytes, at most 64.
+  * @retval Smallest code holding Size bytes
+  */
+static uint32_t DRVCAN_SizeToDlc(uint32_t Size)
+{
+  uint32_t dlc = 0U;
+
+  while (DRVCAN_DlcBytes[dlc] < Size)
+  {
+    dlc++;
+  }
+
+  return dlc;
+}
+
+/**
+  * @brief  Signal the unit state and warning changes read from the CANFD.
+  * @retval None
+  */
+static void DRVCAN_UpdateUnit(void)
+{
+  DRVCAN_ResourcesTypeDef *pRes = &DRVCAN_Resources;
+  CANFD_ProtocolStatusTypeDef protocol;
+  uint32_t state;
+
+  if ((pRes->Flags & DRVCAN_FLAG_STARTED) == 0U)
+  {
+    return;
+  }
+
+  (void)HAL_CANFD_GetProtocolStatus(pRes->hcanfd, &protocol);
+
+  if (protocol.BusOff != 0U)
+  {
+    state = ARM_CAN_UNIT_STATE_BUS_OFF;
+  }
+  else if (protocol.ErrorPassive != 0U)
+  {
+    state = ARM_CAN_UNIT_STATE_PASSIVE;
+  }
+  else
+  {
+    state = ARM_CAN_UNIT_STATE_ACTIVE;
+  }
+
+  if ((protocol.Warning != 0U) && (pRes->Warning == 0U) && (state == ARM_CAN_UNIT_STATE_ACTIVE) &&
+      (pRes->cb_unit_event != NULL))
+  {
+    pRes->cb_unit_event(ARM_CAN_EVENT_UNIT_WARNING);
+  }
+  pRes->Warning = (protocol.Warning != 0U) ? 1U : 0U;
+
+  if (state != pRes->UnitState)
+  {
+    pRes->UnitState = state;
+    if (pRes->cb_unit_event != NULL)
+    {
+      pRes->cb_unit_event((state == ARM_CAN_UNIT_STATE_BUS_OFF) ? ARM_CAN_EVENT_UNIT_BUS_OFF :
+                          (state == ARM_CAN_UNIT_STATE_PASSIVE) ? ARM_CAN_EVENT_UNIT_PASSIVE :
+                          ARM_CAN_EVENT_UNIT_ACTIVE);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1428 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drveth.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver Ethernet MAC and PHY BSP service.
+  *          This file provides the Driver_ETH_MAC.h and Driver_ETH_PHY.h
+  *          interfaces of a WIZnet W5500 on the SPI bus:
+  *           + Driver_ETH_MAC0 on socket 0 of the W5500 in MACRAW mode
+  *           + Driver_ETH_PHY0 on the PHY of the W5500, PHYCFGR register
+  *           + Frames moved by the BSP_SPIBUS DMA queue, straight between
+  *             the buffer of the caller and the W5500 memory
+  *           + ARM_ETH_MAC_EVENT_RX_FRAME from the INTn pin
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Initialize the SPI bus with BSP_SPIBUS_Init() and describe the W5500
+       with BSP_SPIBUS_DeviceInit(): 8-bit data, SPI mode 0 or 3, up to
+       33 MHz. Call BSP_DRVETH_Attach() with the bus, the device and the
+       optional RSTn pin, a push-pull output high, GPIO port NULL when RSTn
+       is not wired.
+
+   (#) Configure the INTn pin of the W5500 as a falling edge EXTI input and
+       call BSP_DRVETH_IRQHandler() from its handler, directly or through
+       BSP_EXTIDISP_Register(). The W5500 holds INTn low until the receive
+       buffer is drained by ReadFrame().
+
+   (#) Driver_ETH_MAC0:
+       (+) PowerControl(ARM_POWER_FULL) resets the W5500, checks its
+           VERSIONR, and gives the whole 16 KB receive and transmit memories
+           to socket 0. SetMacAddress() must then be called, the W5500 has
+           no address of its own.
+       (+) Control(ARM_ETH_MAC_CONFIGURE) sets the address filter of the
+           socket: own address always, broadcast and multicast as requested,
+           all frames for ARM_ETH_MAC_ADDRESS_ALL. Speed and duplex are the
+           ones of the PHY, loop-back and checksum offload are not supported.
+           SetAddressFilter() with at least one address accepts all the
+           multicast frames, the W5500 having no hash filter.
+       (+) Control(ARM_ETH_MAC_CONTROL_TX) or (ARM_ETH_MAC_CONTROL_RX) opens
+           socket 0 in MACRAW mode, the first frame is then received and sent
+           as is. A later ARM_ETH_MAC_CONFIGURE reopens the socket.
+       (+) GetRxFrameSize() returns the size of the next received frame, 0
+           when none. ReadFrame() reads it by DMA straight into the buffer of
+           the caller, e.g. the payload of a PBUF_RAM pbuf of lwIP allocated
+           with that size: no intermediate copy. A NULL buffer drops it.
+       (+) SendFrame() writes each fragment by DMA straight from the buffer
+           of the caller into the transmit memory, the last one starts the
+           transmission. The buffer may be reused on return. A frame is
+           dropped with ARM_DRIVER_ERROR_TIMEOUT when the previous one is not
+           sent within DRVETH_TIMEOUT.
+
+   (#) Driver_ETH_PHY0 needs Driver_ETH_MAC0 powered. The fn_read and
+       fn_write of Initialize() are not used, the PHY being reached through
+       the PHYCFGR register. SetMode() forces the speed and duplex or starts
+       the auto-negotiation, PowerControl(ARM_POWER_OFF) powers the PHY down.
+
+   (#) Each function waits for the end of its SPI transactions and must be
+       called from the thread context, one caller at a time. Only
+       BSP_DRVETH_IRQHandler() may be called from an interrupt.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_drveth.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVETH BSP DRVETH
+  * @brief CMSIS-Driver Ethernet MAC and PHY BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SPI_MODULE_ENABLED)
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Private_Constants BSP DRVETH Private Constants
+  * @{
+  */
+#define DRVETH_VERSION            ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+
+#define DRVETH_FLAG_INITIALIZED   0x01U
+#define DRVETH_FLAG_POWERED       0x02U
+
+#define DRVETH_ENABLE_TX          0x01U
+#define DRVETH_ENABLE_RX          0x02U
+
+#define DRVETH_TIMEOUT            10U        /*!< ms for a command or a transmission of the W5500 */
+#define DRVETH_HEADER_SIZE        3U         /*!< Address and control phases of a SPI frame       */
+#define DRVETH_INLINE_MAX         8U         /*!< Data copied in the header transaction up to it  */
+
+/* Control phase: block select and read/write, variable length data mode */
+#define DRVETH_BSB_COMMON         (0x00U << 3)
+#define DRVETH_BSB_S0_REG         (0x01U << 3)
+#define DRVETH_BSB_S0_TX          (0x02U << 3)
+#define DRVETH_BSB_S0_RX          (0x03U << 3)
+#define DRVETH_BSB_SN_REG(__N__)  ((((uint32_t)(__N__) << 2) | 0x01U) << 3)
+#define DRVETH_RWB_WRITE          0x04U
+
+/* Common registers */
+#define DRVETH_MR                 0x0000U
+#define DRVETH_MR_RST             0x80U
+#define DRVETH_SHAR               0x0009U
+#define DRVETH_SIMR               0x0018U
+#define DRVETH_PHYCFGR            0x002EU
+#define DRVETH_PHYCFGR_RST        0x80U
+#define DRVETH_PHYCFGR_OPMD       0x40U
+#define DRVETH_PHYCFGR_OPMDC_Pos  3U
+#define DRVETH_PHYCFGR_DPX        0x04U
+#define DRVETH_PHYCFGR_SPD        0x02U
+#define DRVETH_PHYCFGR_LNK        0x01U
+#define DRVETH_VERSIONR           0x0039U
+#define DRVETH_VERSION_W5500      0x04U
+
+/* PHYCFGR OPMDC operation modes */
+#define DRVETH_OPMDC_10HD         0x00U
+#define DRVETH_OPMDC_10FD         0x01U
+#define DRVETH_OPMDC_100HD        0x02U
+#define DRVETH_OPMDC_100FD        0x03U
+#define DRVETH_OPMDC_POWER_DOWN   0x06U
+#define DRVETH_OPMDC_AUTO         0x07U
+
+/* Socket registers */
+#define DRVETH_SN_MR              0x0000U
+#define DRVETH_SN_MR_MACRAW       0x04U
+#define DRVETH_SN_MR_MMB          0x20U      /*!< Multicast blocked               */
+#define DRVETH_SN_MR_BCASTB       0x40U      /*!< Broadcast blocked               */
+#define DRVETH_SN_MR_MFEN         0x80U      /*!< Own destination address only    */
+#define DRVETH_SN_CR              0x0001U
+#define DRVETH_SN_CR_OPEN         0x01U
+#define DRVETH_SN_CR_CLOSE        0x10U
+#define DRVETH_SN_CR_SEND         0x20U
+#define DRVETH_SN_CR_RECV         0x40U
+#define DRVETH_SN_IR              0x0002U
+#define DRVETH_SN_IR_RECV         0x04U
+#define DRVETH_SN_IR_SENDOK       0x10U
+#define DRVETH_SN_SR              0x0003U
+#define DRVETH_SN_SR_MACRAW       0x42U
+#define DRVETH_SN_RXBUF_SIZE      0x001EU
+#define DRVETH_SN_TXBUF_SIZE      0x001FU
+#define DRVETH_SN_TX_WR           0x0024U
+#define DRVETH_SN_RX_RSR          0x0026U
+#define DRVETH_SN_RX_RD           0x0028U
+#define DRVETH_SN_RX_WR           0x002AU
+#define DRVETH_SN_IMR             0x002CU
+
+#define DRVETH_SOCKETS            8U
+#define DRVETH_S0_BUF_KB          16U        /*!< Whole memory to socket 0        */
+#define DRVETH_RX_INFO_SIZE       2U         /*!< Length ahead of a MACRAW frame  */
+#define DRVETH_FRAME_MIN          14U        /*!< Ethernet header                 */
+/**
+  * @}
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Private_Types BSP DRVETH Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of the W5500 MAC
+  */
+typedef struct
+{
+  ARM_ETH_MAC_SignalEvent_t cb_event;   /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVETH_FLAG_INITIALIZED and DRVETH_FLAG_POWERED       */
+
+  BSP_SPIBUS_TypeDef      *hbus;        /*!< SPI bus of the W5500, NULL when not attached          */
+
+  const BSP_SPIBUS_DeviceTypeDef *pDevice; /*!< W5500 on the bus                                   */
+
+  GPIO_TypeDef            *ResetPort;   /*!< RSTn port, NULL when not wired                        */
+
+  uint16_t                ResetPin;     /*!< RSTn pin                                              */
+
+  uint32_t                Config;       /*!< Argument of the last ARM_ETH_MAC_CONFIGURE            */
+
+  uint32_t                MulticastAll; /*!< 1 when SetAddressFilter() was given addresses         */
+
+  __IO uint32_t           Enabled;      /*!< DRVETH_ENABLE_TX and DRVETH_ENABLE_RX                 */
+
+  uint16_t                RxRd;         /*!< Sn_RX_RD image, start of the next frame               */
+
+  uint16_t                RxAvail;      /*!< Bytes received from RxRd, last Sn_RX_RSR read         */
+
+  uint16_t                RxSize;       /*!< Size of the frame at RxRd, 0 when not read yet        */
+
+  uint16_t                TxWr;         /*!< Sn_TX_WR image, start of the frame written            */
+
+  uint16_t                TxLen;        /*!< Bytes of the fragments written from TxWr              */
+
+  uint16_t                TxPending;    /*!< 1 from SEND until its SENDOK is cleared               */
+
+  BSP_SPIBUS_XferTypeDef  Xfer[2];      /*!< Header and data transactions                          */
+
+  uint8_t                 Header[DRVETH_HEADER_SIZE + DRVETH_INLINE_MAX]; /*!< Header, short data  */
+
+} DRVETH_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Private_Variables BSP DRVETH Private Variables
+  * @{
+  */
+static DRVETH_ResourcesTypeDef DRVETH_Resources;
+
+static uint32_t DRVETH_PhyFlags;
+
+static const ARM_ETH_MAC_CAPABILITIES DRVETH_Capabilities =
+{
+  0U,                     /* checksum_offload_rx_ip4  */
+  0U,                     /* checksum_offload_rx_ip6  */
+  0U,                     /* checksum_offload_rx_udp  */
+  0U,                     /* checksum_offload_rx_tcp  */
+  0U,                     /* checksum_offload_rx_icmp */
+  0U,                     /* checksum_offload_tx_ip4  */
+  0U,                     /* checksum_offload_tx_ip6  */
+  0U,                     /* checksum_offload_tx_udp  */
+  0U,                     /* checksum_offload_tx_tcp  */
+  0U,                     /* checksum_offload_tx_icmp */
+  ARM_ETH_INTERFACE_MII,  /* media_interface, internal */
+  0U,                     /* mac_address              */
+  1U,                     /* event_rx_frame           */
+  0U,                     /* event_tx_frame           */
+  0U,                     /* event_wakeup             */
+  0U,                     /* precision_timer          */
+  0U                      /* reserved                 */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVETH_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION       DRVETH_GetVersion(void);
+static ARM_ETH_MAC_CAPABILITIES DRVETH_GetCapabilities(void);
+static int32_t                  DRVETH_Initialize(ARM_ETH_MAC_SignalEvent_t cb_event);
+static int32_t                  DRVETH_Uninitialize(void);
+static int32_t                  DRVETH_PowerControl(ARM_POWER_STATE state);
+static int32_t                  DRVETH_GetMacAddress(ARM_ETH_MAC_ADDR *ptr_addr);
+static int32_t                  DRVETH_SetMacAddress(const ARM_ETH_MAC_ADDR *ptr_addr);
+static int32_t                  DRVETH_SetAddressFilter(const ARM_ETH_MAC_ADDR *ptr_addr, uint32_t num_addr);
+static int32_t                  DRVETH_SendFrame(const uint8_t *frame, uint32_t len, uint32_t flags);
+static int32_t                  DRVETH_ReadFrame(uint8_t *frame, uint32_t len);
+static uint32_t                 DRVETH_GetRxFrameSize(void);
+static int32_t                  DRVETH_GetFrameTime(ARM_ETH_MAC_TIME *time);
+static int32_t                  DRVETH_ControlTimer(uint32_t control, ARM_ETH_MAC_TIME *time);
+static int32_t                  DRVETH_Control(uint32_t control, uint32_t arg);
+static int32_t                  DRVETH_PHYRead(uint8_t phy_addr, uint8_t reg_addr, uint16_t *data);
+static int32_t                  DRVETH_PHYWrite(uint8_t phy_addr, uint8_t reg_addr, uint16_t data);
+static ARM_DRIVER_VERSION       DRVETH_PhyGetVersion(void);
+static int32_t                  DRVETH_PhyInitialize(ARM_ETH_PHY_Read_t fn_read, ARM_ETH_PHY_Write_t fn_write);
+static int32_t                  DRVETH_PhyUninitialize(void);
+static int32_t                  DRVETH_PhyPowerControl(ARM_POWER_STATE state);
+static int32_t                  DRVETH_PhySetInterface(uint32_t interface);
+static int32_t                  DRVETH_PhySetMode(uint32_t mode);
+static ARM_ETH_LINK_STATE       DRVETH_PhyGetLinkState(void);
+static ARM_ETH_LINK_INFO        DRVETH_PhyGetLinkInfo(void);
+static int32_t                  DRVETH_Access(uint32_t Control, uint32_t Address, const uint8_t *pTxData,
+                                              uint8_t *pRxData, uint32_t Length);
+static int32_t                  DRVETH_WriteByte(uint32_t Block, uint32_t Address, uint8_t Value);
+static int32_t                  DRVETH_ReadByte(uint32_t Block, uint32_t Address, uint8_t *pValue);
+static int32_t                  DRVETH_Write16(uint32_t Address, uint16_t Value);
+static int32_t                  DRVETH_Read16(uint32_t Address, uint16_t *pValue);
+static int32_t                  DRVETH_Command(uint8_t Command);
+static int32_t                  DRVETH_Open(void);
+static int32_t                  DRVETH_SetPhy(uint8_t Opmdc);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVETH_Exported_Variables
+  * @{
+  */
+ARM_DRIVER_ETH_MAC Driver_ETH_MAC0 =
+{
+  DRVETH_GetVersion,
+  DRVETH_GetCapabilities,
+  DRVETH_Initialize,
+  DRVETH_Uninitialize,
+  DRVETH_PowerControl,
+  DRVETH_GetMacAddress,
+  DRVETH_SetMacAddress,
+  DRVETH_SetAddressFilter,
+  DRVETH_SendFrame,
+  DRVETH_ReadFrame,
+  DRVETH_GetRxFrameSize,
+  DRVETH_GetFrameTime,
+  DRVETH_GetFrameTime,
+  DRVETH_ControlTimer,
+  DRVETH_Control,
+  DRVETH_PHYRead,
+  DRVETH_PHYWrite
+};
+
+ARM_DRIVER_ETH_PHY Driver_ETH_PHY0 =
+{
+  DRVETH_PhyGetVersion,
+  DRVETH_PhyInitialize,
+  DRVETH_PhyUninitialize,
+  DRVETH_PhyPowerControl,
+  DRVETH_PhySetInterface,
+  DRVETH_PhySetMode,
+  DRVETH_PhyGetLinkState,
+  DRVETH_PhyGetLinkInfo
+};
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Exported_Functions BSP DRVETH Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVETH_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Give a W5500 on a SPI bus to Driver_ETH_MAC0 and Driver_ETH_PHY0
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach a W5500 to Driver_ETH_MAC0 and Driver_ETH_PHY0.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure, BSP_SPIBUS_Init() done.
+  * @param  pDevice W5500 on the bus, 8-bit data.
+  * @param  ResetPort RSTn port, NULL when not wired.
+  * @param  ResetPin RSTn pin, a value of @ref GPIO_pins.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVETH_Attach(BSP_SPIBUS_TypeDef *hbus, const BSP_SPIBUS_DeviceTypeDef *pDevice,
+                                    GPIO_TypeDef *ResetPort, uint16_t ResetPin)
+{
+  if ((hbus == NULL) || (pDevice == NULL) || ((pDevice->CR1 & SPI_CR1_DFF) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  if ((DRVETH_Resources.Flags & DRVETH_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  DRVETH_Resources.hbus      = hbus;
+  DRVETH_Resources.pDevice   = pDevice;
+  DRVETH_Resources.ResetPort = ResetPort;
+  DRVETH_Resources.ResetPin  = ResetPin;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVETH_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handler to call from the EXTI of the INTn pin.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  INTn handler of Driver_ETH_MAC0.
+  * @note   To be called on the falling edge of INTn. Signals
+  *         ARM_ETH_MAC_EVENT_RX_FRAME while the receiver is enabled, the frames
+  *         are read from the thread context.
+  * @retval None
+  */
+void BSP_DRVETH_IRQHandler(void)
+{
+  if (((DRVETH_Resources.Enabled & DRVETH_ENABLE_RX) != 0U) && (DRVETH_Resources.cb_event != NULL))
+  {
+    DRVETH_Resources.cb_event(ARM_ETH_MAC_EVENT_RX_FRAME);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVETH_Private_Functions BSP DRVETH Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVETH_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_ETH_MAC_API_VERSION, DRVETH_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the capabilities of Driver_ETH_MAC0.
+  * @retval Capabilities
+  */
+static ARM_ETH_MAC_CAPABILITIES DRVETH_GetCapabilities(void)
+{
+  return DRVETH_Capabilities;
+}
+
+/**
+  * @brief  Initialize Driver_ETH_MAC0.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached W5500
+  */
+static int32_t DRVETH_Initialize(ARM_ETH_MAC_SignalEvent_t cb_event)
+{
+  if (DRVETH_Resources.hbus == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((DRVETH_Resources.Flags & DRVETH_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  DRVETH_Resources.cb_event = cb_event;
+  DRVETH_Resources.Flags    = DRVETH_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize Driver_ETH_MAC0, powering it off first.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Uninitialize(void)
+{
+  int32_t status = DRVETH_PowerControl(ARM_POWER_OFF);
+
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  DRVETH_Resources.cb_event = NULL;
+  DRVETH_Resources.Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power Driver_ETH_MAC0 on or off.
+  * @note   Powering on resets the W5500 and gives its memories to socket 0,
+  *         powering off closes the socket and resets the W5500 again.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status, ARM_DRIVER_ERROR when the W5500 does not answer
+  */
+static int32_t DRVETH_PowerControl(ARM_POWER_STATE state)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint32_t tickstart;
+  uint32_t n;
+  uint8_t value;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVETH_FLAG_POWERED) == 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+      pRes->Enabled = 0U;
+      (void)DRVETH_Command(DRVETH_SN_CR_CLOSE);
+      (void)DRVETH_WriteByte(DRVETH_BSB_COMMON, DRVETH_MR, DRVETH_MR_RST);
+      pRes->Flags  &= ~DRVETH_FLAG_POWERED;
+      DRVETH_PhyFlags &= ~DRVETH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVETH_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVETH_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+      if (pRes->ResetPort != NULL)
+      {
+        HAL_GPIO_WritePin(pRes->ResetPort, pRes->ResetPin, GPIO_PIN_RESET);
+        HAL_Delay(1U);
+        HAL_GPIO_WritePin(pRes->ResetPort, pRes->ResetPin, GPIO_PIN_SET);
+        HAL_Delay(2U);
+      }
+
+      if (DRVETH_WriteByte(DRVETH_BSB_COMMON, DRVETH_MR, DRVETH_MR_RST) != ARM_DRIVER_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      tickstart = HAL_GetTick();
+      do
+      {
+        if ((DRVETH_ReadByte(DRVETH_BSB_COMMON, DRVETH_MR, &value) != ARM_DRIVER_OK) ||
+            ((HAL_GetTick() - tickstart) > DRVETH_TIMEOUT))
+        {
+          return ARM_DRIVER_ERROR;
+        }
+      } while ((value & DRVETH_MR_RST) != 0U);
+
+      if ((DRVETH_ReadByte(DRVETH_BSB_COMMON, DRVETH_VERSIONR, &value) != ARM_DRIVER_OK) ||
+          (value != DRVETH_VERSION_W5500))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+
+      for (n = 0U; n < DRVETH_SOCKETS; n++)
+      {
+        value = (n == 0U) ? (uint8_t)DRVETH_S0_BUF_KB : 0U;
+        if ((DRVETH_WriteByte(DRVETH_BSB_SN_REG(n), DRVETH_SN_RXBUF_SIZE, value) != ARM_DRIVER_OK) ||
+            (DRVETH_WriteByte(DRVETH_BSB_SN_REG(n), DRVETH_SN_TXBUF_SIZE, value) != ARM_DRIVER_OK))
+        {
+          return ARM_DRIVER_ERROR;
+        }
+      }
+      if ((DRVETH_WriteByte(DRVETH_BSB_COMMON, DRVETH_SIMR, 0x01U) != ARM_DRIVER_OK) ||
+          (DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_IMR, DRVETH_SN_IR_RECV) != ARM_DRIVER_OK))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+
+      pRes->Config       = ARM_ETH_MAC_ADDRESS_BROADCAST;
+      pRes->MulticastAll = 0U;
+      pRes->Enabled      = 0U;
+      pRes->Flags       |= DRVETH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Get the MAC address of the W5500.
+  * @param  ptr_addr MAC address read.
+  * @retval Execution status
+  */
+static int32_t DRVETH_GetMacAddress(ARM_ETH_MAC_ADDR *ptr_addr)
+{
+  if (ptr_addr == NULL)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVETH_Resources.Flags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return DRVETH_Access(DRVETH_BSB_COMMON, DRVETH_SHAR, NULL, ptr_addr->b, sizeof(ptr_addr->b));
+}
+
+/**
+  * @brief  Set the MAC address of the W5500.
+  * @param  ptr_addr MAC address, used by the own address filter.
+  * @retval Execution status
+  */
+static int32_t DRVETH_SetMacAddress(const ARM_ETH_MAC_ADDR *ptr_addr)
+{
+  if (ptr_addr == NULL)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVETH_Resources.Flags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return DRVETH_Access(DRVETH_BSB_COMMON | DRVETH_RWB_WRITE, DRVETH_SHAR, ptr_addr->b, NULL,
+                       sizeof(ptr_addr->b));
+}
+
+/**
+  * @brief  Set the multicast address filter.
+  * @note   The W5500 has no multicast filter, any address given accepts all
+  *         the multicast frames.
+  * @param  ptr_addr Multicast addresses.
+  * @param  num_addr Number of addresses, 0 to accept only the ones of
+  *         ARM_ETH_MAC_ADDRESS_MULTICAST.
+  * @retval Execution status
+  */
+static int32_t DRVETH_SetAddressFilter(const ARM_ETH_MAC_ADDR *ptr_addr, uint32_t num_addr)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+
+  if ((ptr_addr == NULL) && (num_addr != 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  pRes->MulticastAll = (num_addr != 0U) ? 1U : 0U;
+
+  return (pRes->Enabled != 0U) ? DRVETH_Open() : ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Send a frame, or a fragment of it.
+  * @note   The data is written by DMA straight from frame into the transmit
+  *         memory, frame may be reused on return.
+  * @param  frame Data of the fragment.
+  * @param  len Bytes of the fragment.
+  * @param  flags ARM_ETH_MAC_TX_FRAME_FRAGMENT when more fragments follow.
+  * @retval Execution status, ARM_DRIVER_ERROR_TIMEOUT when the previous frame
+  *         is not sent, the frame then dropped
+  */
+static int32_t DRVETH_SendFrame(const uint8_t *frame, uint32_t len, uint32_t flags)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint32_t tickstart;
+  uint8_t value;
+
+  if ((frame == NULL) || (len == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Enabled & DRVETH_ENABLE_TX) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (len > (BSP_DRVETH_FRAME_MAX - (uint32_t)pRes->TxLen))
+  {
+    pRes->TxLen = 0U;
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if (DRVETH_Access(DRVETH_BSB_S0_TX | DRVETH_RWB_WRITE, (uint16_t)(pRes->TxWr + pRes->TxLen), frame, NULL,
+                    len) != ARM_DRIVER_OK)
+  {
+    pRes->TxLen = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+  pRes->TxLen += (uint16_t)len;
+
+  if ((flags & ARM_ETH_MAC_TX_FRAME_FRAGMENT) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  /* One SEND at a time: wait for the end of the previous one */
+  if (pRes->TxPending != 0U)
+  {
+    tickstart = HAL_GetTick();
+    do
+    {
+      if ((DRVETH_ReadByte(DRVETH_BSB_S0_REG, DRVETH_SN_IR, &value) != ARM_DRIVER_OK) ||
+          ((HAL_GetTick() - tickstart) > DRVETH_TIMEOUT))
+      {
+        pRes->TxLen = 0U;
+        return ARM_DRIVER_ERROR_TIMEOUT;
+      }
+    } while ((value & DRVETH_SN_IR_SENDOK) == 0U);
+
+    if (DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_IR, DRVETH_SN_IR_SENDOK) != ARM_DRIVER_OK)
+    {
+      pRes->TxLen = 0U;
+      return ARM_DRIVER_ERROR;
+    }
+    pRes->TxPending = 0U;
+  }
+
+  pRes->TxWr  = (uint16_t)(pRes->TxWr + pRes->TxLen);
+  pRes->TxLen = 0U;
+  if ((DRVETH_Write16(DRVETH_SN_TX_WR, pRes->TxWr) != ARM_DRIVER_OK) ||
+      (DRVETH_Command(DRVETH_SN_CR_SEND) != ARM_DRIVER_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  pRes->TxPending = 1U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Read the received frame sized by DRVETH_GetRxFrameSize().
+  * @note   The data is read by DMA straight into frame, the frame is then
+  *         released in the receive memory.
+  * @param  frame Buffer of the frame, NULL to drop it.
+  * @param  len Bytes of frame, the rest of a longer frame is dropped.
+  * @retval Number of bytes read or execution status
+  */
+static int32_t DRVETH_ReadFrame(uint8_t *frame, uint32_t len)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint32_t size = pRes->RxSize;
+  uint32_t count;
+
+  if ((pRes->Enabled & DRVETH_ENABLE_RX) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (size == 0U)
+  {
+    size = DRVETH_GetRxFrameSize();
+    if (size == 0U)
+    {
+      return 0;
+    }
+  }
+
+  count = 0U;
+  if ((frame != NULL) && (len != 0U))
+  {
+    count = (len < size) ? len : size;
+    if (DRVETH_Access(DRVETH_BSB_S0_RX, (uint16_t)(pRes->RxRd + DRVETH_RX_INFO_SIZE), NULL, frame,
+                      count) != ARM_DRIVER_OK)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+  }
+
+  pRes->RxRd     = (uint16_t)(pRes->RxRd + DRVETH_RX_INFO_SIZE + size);
+  pRes->RxAvail -= (uint16_t)(DRVETH_RX_INFO_SIZE + size);
+  pRes->RxSize   = 0U;
+  if ((DRVETH_Write16(DRVETH_SN_RX_RD, pRes->RxRd) != ARM_DRIVER_OK) ||
+      (DRVETH_Command(DRVETH_SN_CR_RECV) != ARM_DRIVER_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return (int32_t)count;
+}
+
+/**
+  * @brief  Get the size of the next received frame.
+  * @note   The Sn_IR RECV interrupt is cleared once the receive memory is
+  *         empty, INTn then signals the next frame.
+  * @retval Bytes of the frame, 0 when none
+  */
+static uint32_t DRVETH_GetRxFrameSize(void)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint16_t avail;
+  uint16_t check;
+  uint8_t info[DRVETH_RX_INFO_SIZE];
+  uint32_t length;
+
+  if ((pRes->Enabled & DRVETH_ENABLE_RX) == 0U)
+  {
+    return 0U;
+  }
+  if (pRes->RxSize != 0U)
+  {
+    return pRes->RxSize;
+  }
+
+  if (pRes->RxAvail == 0U)
+  {
+    /* Sn_RX_RSR is read until stable, it may change between its two bytes */
+    if (DRVETH_Read16(DRVETH_SN_RX_RSR, &avail) != ARM_DRIVER_OK)
+    {
+      return 0U;
+    }
+    do
+    {
+      check = avail;
+      if (DRVETH_Read16(DRVETH_SN_RX_RSR, &avail) != ARM_DRIVER_OK)
+      {
+        return 0U;
+      }
+    } while (avail != check);
+
+    if (avail == 0U)
+    {
+      /* Empty: clear RECV then check again, for a frame received meanwhile */
+      if ((DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_IR, DRVETH_SN_IR_RECV) != ARM_DRIVER_OK) ||
+          (DRVETH_Read16(DRVETH_SN_RX_RSR, &avail) != ARM_DRIVER_OK) || (avail == 0U) ||
+          (DRVETH_Read16(DRVETH_SN_RX_RSR, &check) != ARM_DRIVER_OK) || (check != avail))
+      {
+        return 0U;
+      }
+    }
+    pRes->RxAvail = avail;
+  }
+
+  if (DRVETH_Access(DRVETH_BSB_S0_RX, pRes->RxRd, NULL, info, DRVETH_RX_INFO_SIZE) != ARM_DRIVER_OK)
+  {
+    return 0U;
+  }
+  length = ((uint32_t)info[0] << 8) | info[1];
+
+  if ((length < (DRVETH_RX_INFO_SIZE + DRVETH_FRAME_MIN)) ||
+      (length > (DRVETH_RX_INFO_SIZE + BSP_DRVETH_FRAME_MAX)) || (length > pRes->RxAvail))
+  {
+    /* Lost track of the frames: drop the whole receive memory */
+    (void)DRVETH_Control(ARM_ETH_MAC_FLUSH, ARM_ETH_MAC_FLUSH_RX);
+    return 0U;
+  }
+
+  pRes->RxSize = (uint16_t)(length - DRVETH_RX_INFO_SIZE);
+
+  return pRes->RxSize;
+}
+
+/**
+  * @brief  Get the time of a frame, not supported.
+  * @param  time Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVETH_GetFrameTime(ARM_ETH_MAC_TIME *time)
+{
+  (void)time;
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Control the precision timer, not supported.
+  * @param  control Not used.
+  * @param  time Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVETH_ControlTimer(uint32_t control, ARM_ETH_MAC_TIME *time)
+{
+  (void)control;
+  (void)time;
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Control Driver_ETH_MAC0.
+  * @param  control ARM_ETH_MAC_CONFIGURE, ARM_ETH_MAC_CONTROL_TX,
+  *         ARM_ETH_MAC_CONTROL_RX or ARM_ETH_MAC_FLUSH.
+  * @param  arg Argument of control.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Control(uint32_t control, uint32_t arg)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint32_t enable;
+
+  if ((pRes->Flags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (control)
+  {
+    case ARM_ETH_MAC_CONFIGURE:
+      if (((arg & ARM_ETH_MAC_SPEED_Msk) == ARM_ETH_MAC_SPEED_1G) ||
+          ((arg & (ARM_ETH_MAC_LOOPBACK | ARM_ETH_MAC_CHECKSUM_OFFLOAD_RX | ARM_ETH_MAC_CHECKSUM_OFFLOAD_TX)) != 0U))
+      {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      pRes->Config = arg;
+      return (pRes->Enabled != 0U) ? DRVETH_Open() : ARM_DRIVER_OK;
+
+    case ARM_ETH_MAC_CONTROL_TX:
+    case ARM_ETH_MAC_CONTROL_RX:
+      enable = (control == ARM_ETH_MAC_CONTROL_TX) ? DRVETH_ENABLE_TX : DRVETH_ENABLE_RX;
+      if (arg != 0U)
+      {
+        if (pRes->Enabled == 0U)
+        {
+          if (DRVETH_Open() != ARM_DRIVER_OK)
+          {
+            return ARM_DRIVER_ERROR;
+          }
+        }
+        pRes->Enabled |= enable;
+      }
+      else
+      {
+        pRes->Enabled &= ~enable;
+        if (pRes->Enabled == 0U)
+        {
+          return DRVETH_Command(DRVETH_SN_CR_CLOSE);
+        }
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_ETH_MAC_FLUSH:
+      if ((arg & ARM_ETH_MAC_FLUSH_RX) != 0U)
+      {
+        pRes->RxAvail = 0U;
+        pRes->RxSize  = 0U;
+        if ((DRVETH_Read16(DRVETH_SN_RX_WR, &pRes->RxRd) != ARM_DRIVER_OK) ||
+            (DRVETH_Write16(DRVETH_SN_RX_RD, pRes->RxRd) != ARM_DRIVER_OK) ||
+            (DRVETH_Command(DRVETH_SN_CR_RECV) != ARM_DRIVER_OK))
+        {
+          return ARM_DRIVER_ERROR;
+        }
+      }
+      if ((arg & ARM_ETH_MAC_FLUSH_TX) != 0U)
+      {
+        pRes->TxLen = 0U;
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Read a PHY register, not supported: the PHY of the W5500 has no
+  *         management interface, see Driver_ETH_PHY0.
+  * @param  phy_addr Not used.
+  * @param  reg_addr Not used.
+  * @param  data Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVETH_PHYRead(uint8_t phy_addr, uint8_t reg_addr, uint16_t *data)
+{
+  (void)phy_addr;
+  (void)reg_addr;
+  (void)data;
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Write a PHY register, not supported.
+  * @param  phy_addr Not used.
+  * @param  reg_addr Not used.
+  * @param  data Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVETH_PHYWrite(uint8_t phy_addr, uint8_t reg_addr, uint16_t data)
+{
+  (void)phy_addr;
+  (void)reg_addr;
+  (void)data;
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Get the PHY driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVETH_PhyGetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_ETH_PHY_API_VERSION, DRVETH_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Initialize Driver_ETH_PHY0.
+  * @param  fn_read Not used, the PHY is reached through PHYCFGR.
+  * @param  fn_write Not used.
+  * @retval Execution status
+  */
+static int32_t DRVETH_PhyInitialize(ARM_ETH_PHY_Read_t fn_read, ARM_ETH_PHY_Write_t fn_write)
+{
+  (void)fn_read;
+  (void)fn_write;
+
+  DRVETH_PhyFlags |= DRVETH_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize Driver_ETH_PHY0, powering it off first.
+  * @retval Execution status
+  */
+static int32_t DRVETH_PhyUninitialize(void)
+{
+  int32_t status = DRVETH_PhyPowerControl(ARM_POWER_OFF);
+
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  DRVETH_PhyFlags = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power the PHY of the W5500 on or off.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status, ARM_DRIVER_ERROR while Driver_ETH_MAC0 is off
+  */
+static int32_t DRVETH_PhyPowerControl(ARM_POWER_STATE state)
+{
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) == 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+      DRVETH_PhyFlags &= ~DRVETH_FLAG_POWERED;
+      return DRVETH_SetPhy(DRVETH_OPMDC_POWER_DOWN);
+
+    case ARM_POWER_FULL:
+      if (((DRVETH_PhyFlags & DRVETH_FLAG_INITIALIZED) == 0U) ||
+          ((DRVETH_Resources.Flags & DRVETH_FLAG_POWERED) == 0U))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+      if (DRVETH_SetPhy(DRVETH_OPMDC_AUTO) != ARM_DRIVER_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      DRVETH_PhyFlags |= DRVETH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Set the media interface, the internal one of the W5500 only.
+  * @param  interface Not used.
+  * @retval Execution status
+  */
+static int32_t DRVETH_PhySetInterface(uint32_t interface)
+{
+  (void)interface;
+
+  return ((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) != 0U) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+}
+
+/**
+  * @brief  Set the operation mode of the PHY.
+  * @param  mode ARM_ETH_PHY_AUTO_NEGOTIATE, or a 10M or 100M speed with a
+  *         duplex. Loop-back and isolation are not supported.
+  * @retval Execution status
+  */
+static int32_t DRVETH_PhySetMode(uint32_t mode)
+{
+  uint8_t opmdc;
+
+  if ((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (((mode & (ARM_ETH_PHY_LOOPBACK | ARM_ETH_PHY_ISOLATE)) != 0U) ||
+      ((mode & ARM_ETH_PHY_SPEED_Msk) == ARM_ETH_PHY_SPEED_1G))
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  if ((mode & ARM_ETH_PHY_AUTO_NEGOTIATE) != 0U)
+  {
+    opmdc = DRVETH_OPMDC_AUTO;
+  }
+  else if ((mode & ARM_ETH_PHY_SPEED_Msk) == ARM_ETH_PHY_SPEED_100M)
+  {
+    opmdc = ((mode & ARM_ETH_PHY_DUPLEX_Msk) == ARM_ETH_PHY_DUPLEX_FULL) ? DRVETH_OPMDC_100FD : DRVETH_OPMDC_100HD;
+  }
+  else
+  {
+    opmdc = ((mode & ARM_ETH_PHY_DUPLEX_Msk) == ARM_ETH_PHY_DUPLEX_FULL) ? DRVETH_OPMDC_10FD : DRVETH_OPMDC_10HD;
+  }
+
+  return DRVETH_SetPhy(opmdc);
+}
+
+/**
+  * @brief  Get the link state of the PHY.
+  * @retval ARM_ETH_LINK_UP or ARM_ETH_LINK_DOWN
+  */
+static ARM_ETH_LINK_STATE DRVETH_PhyGetLinkState(void)
+{
+  uint8_t value;
+
+  if (((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) == 0U) ||
+      (DRVETH_ReadByte(DRVETH_BSB_COMMON, DRVETH_PHYCFGR, &value) != ARM_DRIVER_OK) ||
+      ((value & DRVETH_PHYCFGR_LNK) == 0U))
+  {
+    return ARM_ETH_LINK_DOWN;
+  }
+
+  return ARM_ETH_LINK_UP;
+}
+
+/**
+  * @brief  Get the speed and duplex of the link.
+  * @retval Link information, 10M half duplex when unknown
+  */
+static ARM_ETH_LINK_INFO DRVETH_PhyGetLinkInfo(void)
+{
+  ARM_ETH_LINK_INFO info = {0U, 0U, 0U};
+  uint8_t value;
+
+  if (((DRVETH_PhyFlags & DRVETH_FLAG_POWERED) != 0U) &&
+      (DRVETH_ReadByte(DRVETH_BSB_COMMON, DRVETH_PHYCFGR, &value) == ARM_DRIVER_OK))
+  {
+    info.speed  = ((value & DRVETH_PHYCFGR_SPD) != 0U) ? ARM_ETH_SPEED_100M : ARM_ETH_SPEED_10M;
+    info.duplex = ((value & DRVETH_PHYCFGR_DPX) != 0U) ? ARM_ETH_DUPLEX_FULL : ARM_ETH_DUPLEX_HALF;
+  }
+
+  return info;
+}
+
+/**
+  * @brief  Run a SPI frame of the W5500 and wait for its end.
+  * @note   Up to DRVETH_INLINE_MAX bytes are moved in the header transaction,
+  *         longer data by a second transaction straight from or to the
+  *         buffer of the caller, the chip select kept low in between.
+  * @param  Control Block select and DRVETH_RWB_WRITE.
+  * @param  Address Offset in the block, wrapped by the W5500 in its memories.
+  * @param  pTxData Data written, NULL for a read.
+  * @param  pRxData Data read, NULL for a write.
+  * @param  Length Bytes of data, at most 65535.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Access(uint32_t Control, uint32_t Address, const uint8_t *pTxData,
+                             uint8_t *pRxData, uint32_t Length)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  BSP_SPIBUS_XferTypeDef *pHeader = &pRes->Xfer[0];
+  BSP_SPIBUS_XferTypeDef *pData = &pRes->Xfer[1];
+  BSP_SPIBUS_XferTypeDef *pLast;
+  HAL_StatusTypeDef status;
+  uint32_t primask_bit;
+
+  pRes->Header[0] = (uint8_t)(Address >> 8);
+  pRes->Header[1] = (uint8_t)Address;
+  pRes->Header[2] = (uint8_t)Control;
+
+  pHeader->pDevice = pRes->pDevice;
+  pHeader->pTxData = pRes->Header;
+  pHeader->pRxData = NULL;
+
+  if (Length <= DRVETH_INLINE_MAX)
+  {
+    if (pTxData != NULL)
+    {
+      (void)memcpy(&pRes->Header[DRVETH_HEADER_SIZE], pTxData, Length);
+    }
+    else
+    {
+      pHeader->pRxData = pRes->Header;
+    }
+    pHeader->Size  = (uint16_t)(DRVETH_HEADER_SIZE + Length);
+    pHeader->Flags = BSP_SPIBUS_XFER_NONE;
+    pLast  = pHeader;
+    status = BSP_SPIBUS_Submit(pRes->hbus, pHeader);
+  }
+  else
+  {
+    pHeader->Size  = (uint16_t)DRVETH_HEADER_SIZE;
+    pHeader->Flags = BSP_SPIBUS_XFER_KEEP_CS;
+    pData->pDevice = pRes->pDevice;
+    pData->pTxData = pTxData;
+    pData->pRxData = pRxData;
+    pData->Size    = (uint16_t)Length;
+    pData->Flags   = BSP_SPIBUS_XFER_NONE;
+    pLast = pData;
+
+    /* Both queued before the header ends, for the chip select kept low */
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    status = BSP_SPIBUS_Submit(pRes->hbus, pHeader);
+    if (status == HAL_OK)
+    {
+      status = BSP_SPIBUS_Submit(pRes->hbus, pData);
+    }
+    __set_PRIMASK(primask_bit);
+  }
+
+  if (status != HAL_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* The bus always ends a transaction, by its DMA or with an error */
+  while ((pHeader->Status == BSP_SPIBUS_STATUS_QUEUED) || (pLast->Status == BSP_SPIBUS_STATUS_QUEUED))
+  {
+  }
+  if ((pHeader->Status != BSP_SPIBUS_STATUS_OK) || (pLast->Status != BSP_SPIBUS_STATUS_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRxData != NULL) && (pLast == pHeader))
+  {
+    (void)memcpy(pRxData, &pRes->Header[DRVETH_HEADER_SIZE], Length);
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Write a register byte.
+  * @param  Block Block select.
+  * @param  Address Offset of the register.
+  * @param  Value Value written.
+  * @retval Execution status
+  */
+static int32_t DRVETH_WriteByte(uint32_t Block, uint32_t Address, uint8_t Value)
+{
+  return DRVETH_Access(Block | DRVETH_RWB_WRITE, Address, &Value, NULL, 1U);
+}
+
+/**
+  * @brief  Read a register byte.
+  * @param  Block Block select.
+  * @param  Address Offset of the register.
+  * @param  pValue Value read.
+  * @retval Execution status
+  */
+static int32_t DRVETH_ReadByte(uint32_t Block, uint32_t Address, uint8_t *pValue)
+{
+  return DRVETH_Access(Block, Address, NULL, pValue, 1U);
+}
+
+/**
+  * @brief  Write a 16-bit register of socket 0, big endian.
+  * @param  Address Offset of the register.
+  * @param  Value Value written.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Write16(uint32_t Address, uint16_t Value)
+{
+  uint8_t data[2];
+
+  data[0] = (uint8_t)(Value >> 8);
+  data[1] = (uint8_t)Value;
+
+  return DRVETH_Access(DRVETH_BSB_S0_REG | DRVETH_RWB_WRITE, Address, data, NULL, 2U);
+}
+
+/**
+  * @brief  Read a 16-bit register of socket 0, big endian.
+  * @param  Address Offset of the register.
+  * @param  pValue Value read.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Read16(uint32_t Address, uint16_t *pValue)
+{
+  uint8_t data[2];
+
+  if (DRVETH_Access(DRVETH_BSB_S0_REG, Address, NULL, data, 2U) != ARM_DRIVER_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  *pValue = (uint16_t)(((uint32_t)data[0] << 8) | data[1]);
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Run a command of socket 0 and wait for its acceptance.
+  * @param  Command Value written to Sn_CR.
+  * @retval Execution status, ARM_DRIVER_ERROR_TIMEOUT after DRVETH_TIMEOUT
+  */
+static int32_t DRVETH_Command(uint8_t Command)
+{
+  uint32_t tickstart;
+  uint8_t value;
+
+  if (DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_CR, Command) != ARM_DRIVER_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  tickstart = HAL_GetTick();
+  do
+  {
+    if (DRVETH_ReadByte(DRVETH_BSB_S0_REG, DRVETH_SN_CR, &value) != ARM_DRIVER_OK)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+    if ((HAL_GetTick() - tickstart) > DRVETH_TIMEOUT)
+    {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+  } while (value != 0U);
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Open, or reopen, socket 0 in MACRAW mode with the current filter.
+  * @note   The frames received and not read are dropped.
+  * @retval Execution status
+  */
+static int32_t DRVETH_Open(void)
+{
+  DRVETH_ResourcesTypeDef *pRes = &DRVETH_Resources;
+  uint32_t tickstart;
+  uint8_t mode = DRVETH_SN_MR_MACRAW;
+  uint8_t value;
+
+  if ((pRes->Config & ARM_ETH_MAC_ADDRESS_ALL) == 0U)
+  {
+    mode |= DRVETH_SN_MR_MFEN;
+    if ((pRes->Config & ARM_ETH_MAC_ADDRESS_BROADCAST) == 0U)
+    {
+      mode |= DRVETH_SN_MR_BCASTB;
+    }
+    if (((pRes->Config & ARM_ETH_MAC_ADDRESS_MULTICAST) == 0U) && (pRes->MulticastAll == 0U))
+    {
+      mode |= DRVETH_SN_MR_MMB;
+    }
+  }
+
+  if ((DRVETH_Command(DRVETH_SN_CR_CLOSE) != ARM_DRIVER_OK) ||
+      (DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_IR, 0xFFU) != ARM_DRIVER_OK) ||
+      (DRVETH_WriteByte(DRVETH_BSB_S0_REG, DRVETH_SN_MR, mode) != ARM_DRIVER_OK) ||
+      (DRVETH_Command(DRVETH_SN_CR_OPEN) != ARM_DRIVER_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  tickstart = HAL_GetTick();
+  do
+  {
+    if ((DRVETH_ReadByte(DRVETH_BSB_S0_REG, DRVETH_SN_SR, &value) != ARM_DRIVER_OK) ||
+        ((HAL_GetTick() - tickstart) > DRVETH_TIMEOUT))
+    {
+      return ARM_DRIVER_ERROR;
+    }
+  } while (value != DRVETH_SN_SR_MACRAW);
+
+  pRes->RxAvail   = 0U;
+  pRes->RxSize    = 0U;
+  pRes->TxLen     = 0U;
+  pRes->TxPending = 0U;
+
+  if ((DRVETH_Read16(DRVETH_SN_RX_RD, &pRes->RxRd) != ARM_DRIVER_OK) ||
+      (DRVETH_Read16(DRVETH_SN_TX_WR, &pRes->TxWr) != ARM_DRIVER_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Set the operation mode of the PHY and restart it.
+  * @param  Opmdc A DRVETH_OPMDC_ value.
+  * @retval Execution status
+  */
+static int32_t DRVETH_SetPhy(uint8_t Opmdc)
+{
+  uint8_t value = (uint8_t)(DRVETH_PHYCFGR_OPMD | ((uint32_t)Opmdc << DRVETH_PHYCFGR_OPMDC_Pos));
+
+  if ((DRVETH_Resources.Flags & DRVETH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* RST low resets the PHY, which restarts with the new mode once set */
+  if ((DRVETH_WriteByte(DRVETH_BSB_COMMON, DRVETH_PHYCFGR, value) != ARM_DRIVER_OK) ||
+      (DRVETH_WriteByte(DRVETH_BSB_COMMON, DRVETH_PHYCFGR, value | DRVETH_PHYCFGR_RST) != ARM_DRIVER_OK))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1008 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvflash.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver Flash BSP service.
+  *          This file provides the Driver_Flash.h interface of the internal
+  *          flash and of a serial NOR flash on the ESMC:
+  *           + Driver_Flash0 on a region of the internal flash, FLASH HAL
+  *           + Driver_Flash1 on the ESMC flash, BSP_ESMCFLASH service
+  *           + Non-blocking ProgramData(), EraseSector() and EraseChip()
+  *           + ARM_FLASH_EVENT_READY and ARM_FLASH_EVENT_ERROR at their end
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+       Driver_Flash1 is built when HAL_ESMC_MODULE_ENABLED is defined.
+
+   (#) Driver_Flash0, internal flash:
+       (+) Call BSP_DRVFLASH_Attach() with a region of whole FLASH_SECTOR_SIZE
+           sectors out of the code, for instance one taken with
+           BSP_FLASHMAP_Take(). The addresses of the driver are offsets in
+           the region.
+       (+) Enable FLASH_IRQn in the NVIC, call HAL_FLASH_IRQHandler() from
+           FLASH_IRQHandler(), BSP_DRVFLASH_EndOfOperationCallback() from
+           HAL_FLASH_EndOfOperationCallback() and
+           BSP_DRVFLASH_OperationErrorCallback() from
+           HAL_FLASH_OperationErrorCallback(). The operations of the other
+           flash services are ignored by the driver.
+       (+) PowerControl(ARM_POWER_FULL) unlocks the flash, which then stays
+           unlocked for the other flash services.
+       (+) The data items are 32-bit. ProgramData() writes whole
+           FLASH_PAGE_SIZE pages at page aligned offsets, each page once
+           between two erases of its sector: the ECC of the flash forbids a
+           second program. Each page is latched by HAL_FLASH_PageProgram_IT()
+           and the next one started from the end of operation interrupt, the
+           source buffer must stay valid until ARM_FLASH_EVENT_READY.
+       (+) EraseSector() erases the FLASH_SECTOR_SIZE sector of the offset
+           with HAL_FLASH_Erase_IT(). EraseChip() is not supported, the region
+           being a part of the flash.
+       (+) ReadData() copies from the memory mapped flash.
+
+   (#) Driver_Flash1, ESMC flash:
+       (+) Initialize the ESMC and the BSP_ESMCFLASH service with
+           BSP_ESMCFLASH_Init(), then call BSP_DRVFLASH_AttachESMC() with the
+           service and the size of the flash in bytes. Call
+           BSP_ESMCFLASH_Tick() periodically and
+           BSP_DRVFLASH_ESMCCpltCallback() from BSP_ESMCFLASH_OpCpltCallback().
+       (+) The data items are bytes. ProgramData() programs any range of
+           erased flash page by page from the tick, EraseSector() erases the
+           BSP_DRVFLASH_ESMC_SECTOR_SIZE sector of the address and EraseChip()
+           the whole flash. ReadData() is the blocking fast read of the
+           service.
+
+   (#) ProgramData(), EraseSector() and EraseChip() return ARM_DRIVER_OK, zero
+       items programmed, once the operation is started. Its end is signalled
+       to the cb_event of Initialize() with ARM_FLASH_EVENT_READY, together
+       with ARM_FLASH_EVENT_ERROR when it failed. ARM_DRIVER_ERROR_BUSY is
+       returned while an operation of the driver runs, or while the flash is
+       taken by another service.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_drvflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVFLASH BSP DRVFLASH
+  * @brief CMSIS-Driver Flash BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_FLASH_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Private_Types BSP DRVFLASH Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of the internal flash
+  */
+typedef struct
+{
+  ARM_Flash_SignalEvent_t cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVFLASH_FLAG_INITIALIZED and DRVFLASH_FLAG_POWERED   */
+
+  uint32_t                Address;      /*!< First address of the region                           */
+
+  uint32_t                Size;         /*!< Bytes of the region, 0 when not attached              */
+
+  __IO uint32_t           Busy;         /*!< 1 from the start of an operation to its end           */
+
+  __IO uint32_t           Error;        /*!< 1 when the last operation failed                      */
+
+  uint32_t                OpAddress;    /*!< Page programmed or sector erased                      */
+
+  const uint32_t          *pData;       /*!< Data of the page programmed                           */
+
+  uint32_t                Remaining;    /*!< Pages left to program after the current one           */
+
+} DRVFLASH_ResourcesTypeDef;
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  Driver state of the ESMC flash
+  */
+typedef struct
+{
+  BSP_ESMCFLASH_TypeDef   *hflash;      /*!< Attached ESMC flash service, NULL when none           */
+
+  ARM_Flash_SignalEvent_t cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVFLASH_FLAG_INITIALIZED and DRVFLASH_FLAG_POWERED   */
+
+  uint32_t                Size;         /*!< Bytes of the flash                                    */
+
+  __IO uint32_t           Busy;         /*!< 1 from the start of an operation to its end           */
+
+  __IO uint32_t           Error;        /*!< 1 when the last operation failed                      */
+
+} DRVFLASH_ESMCResourcesTypeDef;
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Private_Constants BSP DRVFLASH Private Constants
+  * @{
+  */
+#define DRVFLASH_VERSION          ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+#define DRVFLASH_PAGE_WORDS       (FLASH_PAGE_SIZE / 4U)  /*!< 32-bit items of a page             */
+
+#define DRVFLASH_FLAG_INITIALIZED 0x01U
+#define DRVFLASH_FLAG_POWERED     0x02U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Private_Variables BSP DRVFLASH Private Variables
+  * @{
+  */
+static DRVFLASH_ResourcesTypeDef DRVFLASH_Resources;
+
+/* Filled by BSP_DRVFLASH_Attach() */
+static struct _ARM_FLASH_INFO DRVFLASH_Info =
+{
+  NULL,             /* sector_info, uniform sectors */
+  0U,               /* sector_count                 */
+  FLASH_SECTOR_SIZE,/* sector_size                  */
+  FLASH_PAGE_SIZE,  /* page_size                    */
+  FLASH_PAGE_SIZE,  /* program_unit                 */
+  0xFFU,            /* erased_value                 */
+  {0U, 0U, 0U}      /* reserved                     */
+};
+
+static const ARM_FLASH_CAPABILITIES DRVFLASH_Capabilities =
+{
+  1U,   /* event_ready        */
+  2U,   /* data_width, 32-bit */
+  0U,   /* erase_chip         */
+  0U    /* reserved           */
+};
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+static DRVFLASH_ESMCResourcesTypeDef DRVFLASH_ESMCResources;
+
+/* Filled by BSP_DRVFLASH_AttachESMC() */
+static struct _ARM_FLASH_INFO DRVFLASH_ESMCInfo =
+{
+  NULL,                           /* sector_info, uniform sectors */
+  0U,                             /* sector_count                 */
+  BSP_DRVFLASH_ESMC_SECTOR_SIZE,  /* sector_size                  */
+  BSP_ESMCFLASH_PAGE_SIZE,        /* page_size                    */
+  1U,                             /* program_unit                 */
+  0xFFU,                          /* erased_value                 */
+  {0U, 0U, 0U}                    /* reserved                     */
+};
+
+static const ARM_FLASH_CAPABILITIES DRVFLASH_ESMCCapabilities =
+{
+  1U,   /* event_ready        */
+  0U,   /* data_width, 8-bit  */
+  1U,   /* erase_chip         */
+  0U    /* reserved           */
+};
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVFLASH_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION     DRVFLASH_GetVersion(void);
+static ARM_FLASH_CAPABILITIES DRVFLASH_GetCapabilities(void);
+static int32_t                DRVFLASH_Initialize(ARM_Flash_SignalEvent_t cb_event);
+static int32_t                DRVFLASH_Uninitialize(void);
+static int32_t                DRVFLASH_PowerControl(ARM_POWER_STATE state);
+static int32_t                DRVFLASH_ReadData(uint32_t addr, void *data, uint32_t cnt);
+static int32_t                DRVFLASH_ProgramData(uint32_t addr, const void *data, uint32_t cnt);
+static int32_t                DRVFLASH_EraseSector(uint32_t addr);
+static int32_t                DRVFLASH_EraseChip(void);
+static ARM_FLASH_STATUS       DRVFLASH_GetStatus(void);
+static ARM_FLASH_INFO        *DRVFLASH_GetInfo(void);
+static void                   DRVFLASH_End(uint32_t Events);
+#ifdef HAL_ESMC_MODULE_ENABLED
+static ARM_FLASH_CAPABILITIES DRVFLASH_ESMCGetCapabilities(void);
+static int32_t                DRVFLASH_ESMCInitialize(ARM_Flash_SignalEvent_t cb_event);
+static int32_t                DRVFLASH_ESMCUninitialize(void);
+static int32_t                DRVFLASH_ESMCPowerControl(ARM_POWER_STATE state);
+static int32_t                DRVFLASH_ESMCReadData(uint32_t addr, void *data, uint32_t cnt);
+static int32_t                DRVFLASH_ESMCProgramData(uint32_t addr, const void *data, uint32_t cnt);
+static int32_t                DRVFLASH_ESMCEraseSector(uint32_t addr);
+static int32_t                DRVFLASH_ESMCEraseChip(void);
+static ARM_FLASH_STATUS       DRVFLASH_ESMCGetStatus(void);
+static ARM_FLASH_INFO        *DRVFLASH_ESMCGetInfo(void);
+static int32_t                DRVFLASH_ESMCStatus(HAL_StatusTypeDef Status);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVFLASH_Exported_Variables
+  * @{
+  */
+ARM_DRIVER_FLASH Driver_Flash0 =
+{
+  DRVFLASH_GetVersion,
+  DRVFLASH_GetCapabilities,
+  DRVFLASH_Initialize,
+  DRVFLASH_Uninitialize,
+  DRVFLASH_PowerControl,
+  DRVFLASH_ReadData,
+  DRVFLASH_ProgramData,
+  DRVFLASH_EraseSector,
+  DRVFLASH_EraseChip,
+  DRVFLASH_GetStatus,
+  DRVFLASH_GetInfo
+};
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+ARM_DRIVER_FLASH Driver_Flash1 =
+{
+  DRVFLASH_GetVersion,
+  DRVFLASH_ESMCGetCapabilities,
+  DRVFLASH_ESMCInitialize,
+  DRVFLASH_ESMCUninitialize,
+  DRVFLASH_ESMCPowerControl,
+  DRVFLASH_ESMCReadData,
+  DRVFLASH_ESMCProgramData,
+  DRVFLASH_ESMCEraseSector,
+  DRVFLASH_ESMCEraseChip,
+  DRVFLASH_ESMCGetStatus,
+  DRVFLASH_ESMCGetInfo
+};
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Exported_Functions BSP DRVFLASH Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVFLASH_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Give a region of the internal flash to Driver_Flash0
+      (+) Give an ESMC flash to Driver_Flash1
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach a region of the internal flash to Driver_Flash0.
+  * @param  Address First address of the region, FLASH_SECTOR_SIZE aligned.
+  * @param  Size Bytes of the region, a multiple of FLASH_SECTOR_SIZE.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVFLASH_Attach(uint32_t Address, uint32_t Size)
+{
+  if ((Size == 0U) || (((Address - FLASH_BASE) % FLASH_SECTOR_SIZE) != 0U) || ((Size % FLASH_SECTOR_SIZE) != 0U) ||
+      (Address < FLASH_BASE) || (Address > FLASH_END) || (Size > (FLASH_END - Address + 1U)))
+  {
+    return HAL_ERROR;
+  }
+  if ((DRVFLASH_Resources.Flags & DRVFLASH_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  DRVFLASH_Resources.Address = Address;
+  DRVFLASH_Resources.Size    = Size;
+  DRVFLASH_Info.sector_count = Size / FLASH_SECTOR_SIZE;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the region of Driver_Flash0.
+  * @retval First address of the region, 0 when none is attached
+  */
+uint32_t BSP_DRVFLASH_GetAddress(void)
+{
+  return (DRVFLASH_Resources.Size != 0U) ? DRVFLASH_Resources.Address : 0U;
+}
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  Attach an ESMC flash to Driver_Flash1.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure, BSP_ESMCFLASH_Init() done.
+  * @param  Size Bytes of the flash, a multiple of BSP_DRVFLASH_ESMC_SECTOR_SIZE.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVFLASH_AttachESMC(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Size)
+{
+  if ((hflash == NULL) || (Size == 0U) || (Size > BSP_DRVFLASH_ESMC_MAX_SIZE) ||
+      ((Size % BSP_DRVFLASH_ESMC_SECTOR_SIZE) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  if ((DRVFLASH_ESMCResources.Flags & DRVFLASH_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  DRVFLASH_ESMCResources.hflash  = hflash;
+  DRVFLASH_ESMCResources.Size    = Size;
+  DRVFLASH_ESMCInfo.sector_count = Size / BSP_DRVFLASH_ESMC_SECTOR_SIZE;
+
+  return HAL_OK;
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVFLASH_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handlers to call from the FLASH HAL callbacks
+    and from the ESMC flash service callback.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Flash end of operation handler of Driver_Flash0.
+  * @note   To be called from HAL_FLASH_EndOfOperationCallback(). Starts the
+  *         next page of a ProgramData().
+  * @param  ReturnValue Page programmed or sector erased.
+  * @retval None
+  */
+void BSP_DRVFLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+  DRVFLASH_ResourcesTypeDef *pRes = &DRVFLASH_Resources;
+
+  if ((pRes->Busy == 0U) || (ReturnValue != pRes->OpAddress))
+  {
+    return;
+  }
+
+  if (pRes->Remaining == 0U)
+  {
+    DRVFLASH_End(ARM_FLASH_EVENT_READY);
+    return;
+  }
+
+  pRes->Remaining--;
+  pRes->OpAddress += FLASH_PAGE_SIZE;
+  pRes->pData     += DRVFLASH_PAGE_WORDS;
+
+  if (HAL_FLASH_PageProgram_IT(pRes->OpAddress, (uint32_t *)(uint32_t)pRes->pData) != HAL_OK)
+  {
+    DRVFLASH_End(ARM_FLASH_EVENT_READY | ARM_FLASH_EVENT_ERROR);
+  }
+}
+
+/**
+  * @brief  Flash operation error handler of Driver_Flash0.
+  * @note   To be called from HAL_FLASH_OperationErrorCallback().
+  * @param  ReturnValue Page programmed or sector erased.
+  * @retval None
+  */
+void BSP_DRVFLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+  if ((DRVFLASH_Resources.Busy == 0U) || (ReturnValue != DRVFLASH_Resources.OpAddress))
+  {
+    return;
+  }
+
+  DRVFLASH_End(ARM_FLASH_EVENT_READY | ARM_FLASH_EVENT_ERROR);
+}
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  ESMC flash operation end handler of Driver_Flash1.
+  * @note   To be called from BSP_ESMCFLASH_OpCpltCallback().
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Status A value of @ref BSP_ESMCFLASH_Status.
+  * @retval None
+  */
+void BSP_DRVFLASH_ESMCCpltCallback(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+  uint32_t events = ARM_FLASH_EVENT_READY;
+
+  if ((hflash != pRes->hflash) || (pRes->Busy == 0U))
+  {
+    return;
+  }
+
+  if (Status != BSP_ESMCFLASH_STATUS_OK)
+  {
+    pRes->Error = 1U;
+    events     |= ARM_FLASH_EVENT_ERROR;
+  }
+  pRes->Busy = 0U;
+
+  if (pRes->cb_event != NULL)
+  {
+    pRes->cb_event(events);
+  }
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVFLASH_Private_Functions BSP DRVFLASH Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVFLASH_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_FLASH_API_VERSION, DRVFLASH_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the capabilities of Driver_Flash0.
+  * @retval Capabilities
+  */
+static ARM_FLASH_CAPABILITIES DRVFLASH_GetCapabilities(void)
+{
+  return DRVFLASH_Capabilities;
+}
+
+/**
+  * @brief  Initialize Driver_Flash0.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached region
+  */
+static int32_t DRVFLASH_Initialize(ARM_Flash_SignalEvent_t cb_event)
+{
+  if (DRVFLASH_Resources.Size == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((DRVFLASH_Resources.Flags & DRVFLASH_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  DRVFLASH_Resources.cb_event = cb_event;
+  DRVFLASH_Resources.Flags    = DRVFLASH_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize Driver_Flash0, powering it off first.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY while an operation runs
+  */
+static int32_t DRVFLASH_Uninitialize(void)
+{
+  int32_t status = DRVFLASH_PowerControl(ARM_POWER_OFF);
+
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  DRVFLASH_Resources.cb_event = NULL;
+  DRVFLASH_Resources.Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power Driver_Flash0 on or off.
+  * @note   The flash stays unlocked at power off, other services may use it.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY to power off while an operation runs
+  */
+static int32_t DRVFLASH_PowerControl(ARM_POWER_STATE state)
+{
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if (DRVFLASH_Resources.Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      DRVFLASH_Resources.Flags &= ~DRVFLASH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((DRVFLASH_Resources.Flags & DRVFLASH_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if (HAL_FLASH_Unlock() != HAL_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      DRVFLASH_Resources.Error  = 0U;
+      DRVFLASH_Resources.Flags |= DRVFLASH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Read the region of Driver_Flash0.
+  * @param  addr Offset in the region.
+  * @param  data 32-bit items read.
+  * @param  cnt Number of items.
+  * @retval Number of items read or execution status
+  */
+static int32_t DRVFLASH_ReadData(uint32_t addr, void *data, uint32_t cnt)
+{
+  DRVFLASH_ResourcesTypeDef *pRes = &DRVFLASH_Resources;
+
+  if ((data == NULL) || (addr >= pRes->Size) || (cnt > ((pRes->Size - addr) / 4U)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  (void)memcpy(data, (const void *)(pRes->Address + addr), cnt * 4U);
+
+  return (int32_t)cnt;
+}
+
+/**
+  * @brief  Start programming whole pages of Driver_Flash0.
+  * @param  addr Offset in the region, FLASH_PAGE_SIZE aligned.
+  * @param  data 32-bit items to program, valid until ARM_FLASH_EVENT_READY.
+  * @param  cnt Number of items, a multiple of FLASH_PAGE_SIZE / 4.
+  * @retval Execution status, ARM_DRIVER_OK for 0 items programmed once started
+  */
+static int32_t DRVFLASH_ProgramData(uint32_t addr, const void *data, uint32_t cnt)
+{
+  DRVFLASH_ResourcesTypeDef *pRes = &DRVFLASH_Resources;
+  HAL_StatusTypeDef status;
+
+  if ((data == NULL) || (cnt == 0U) || ((cnt % DRVFLASH_PAGE_WORDS) != 0U) || ((addr % FLASH_PAGE_SIZE) != 0U) ||
+      (addr >= pRes->Size) || (cnt > ((pRes->Size - addr) / 4U)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->OpAddress = pRes->Address + addr;
+  pRes->pData     = (const uint32_t *)data;
+  pRes->Remaining = (cnt / DRVFLASH_PAGE_WORDS) - 1U;
+  pRes->Error     = 0U;
+  pRes->Busy      = 1U;
+
+  status = HAL_FLASH_PageProgram_IT(pRes->OpAddress, (uint32_t *)(uint32_t)pRes->pData);
+  if (status != HAL_OK)
+  {
+    pRes->Busy = 0U;
+    return (status == HAL_BUSY) ? ARM_DRIVER_ERROR_BUSY : ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start erasing a sector of Driver_Flash0.
+  * @param  addr Offset in the sector.
+  * @retval Execution status
+  */
+static int32_t DRVFLASH_EraseSector(uint32_t addr)
+{
+  DRVFLASH_ResourcesTypeDef *pRes = &DRVFLASH_Resources;
+  FLASH_EraseInitTypeDef erase = {0};
+  HAL_StatusTypeDef status;
+
+  if (addr >= pRes->Size)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->OpAddress = pRes->Address + (addr - (addr % FLASH_SECTOR_SIZE));
+  pRes->Remaining = 0U;
+  pRes->Error     = 0U;
+  pRes->Busy      = 1U;
+
+  erase.TypeErase     = FLASH_TYPEERASE_SECTORERASE;
+  erase.SectorAddress = pRes->OpAddress;
+  erase.NbSectors     = 1U;
+
+  status = HAL_FLASH_Erase_IT(&erase);
+  if (status != HAL_OK)
+  {
+    pRes->Busy = 0U;
+    return (status == HAL_BUSY) ? ARM_DRIVER_ERROR_BUSY : ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Erase the whole flash, not supported on a region.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVFLASH_EraseChip(void)
+{
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Get the status of Driver_Flash0.
+  * @retval Flash status
+  */
+static ARM_FLASH_STATUS DRVFLASH_GetStatus(void)
+{
+  ARM_FLASH_STATUS status = {0};
+
+  status.busy  = DRVFLASH_Resources.Busy;
+  status.error = DRVFLASH_Resources.Error;
+
+  return status;
+}
+
+/**
+  * @brief  Get the geometry of Driver_Flash0.
+  * @retval Flash information, sector_count 0 without an attached region
+  */
+static ARM_FLASH_INFO *DRVFLASH_GetInfo(void)
+{
+  return &DRVFLASH_Info;
+}
+
+/**
+  * @brief  End the operation of Driver_Flash0 and signal it.
+  * @param  Events ARM_FLASH_EVENT_READY, with ARM_FLASH_EVENT_ERROR on a failure.
+  * @retval None
+  */
+static void DRVFLASH_End(uint32_t Events)
+{
+  if ((Events & ARM_FLASH_EVENT_ERROR) != 0U)
+  {
+    DRVFLASH_Resources.Error = 1U;
+  }
+  DRVFLASH_Resources.Busy = 0U;
+
+  if (DRVFLASH_Resources.cb_event != NULL)
+  {
+    DRVFLASH_Resources.cb_event(Events);
+  }
+}
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  Get the capabilities of Driver_Flash1.
+  * @retval Capabilities
+  */
+static ARM_FLASH_CAPABILITIES DRVFLASH_ESMCGetCapabilities(void)
+{
+  return DRVFLASH_ESMCCapabilities;
+}
+
+/**
+  * @brief  Initialize Driver_Flash1.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached flash
+  */
+static int32_t DRVFLASH_ESMCInitialize(ARM_Flash_SignalEvent_t cb_event)
+{
+  if (DRVFLASH_ESMCResources.hflash == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((DRVFLASH_ESMCResources.Flags & DRVFLASH_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  DRVFLASH_ESMCResources.cb_event = cb_event;
+  DRVFLASH_ESMCResources.Flags    = DRVFLASH_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize Driver_Flash1, powering it off first.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY while an operation runs
+  */
+static int32_t DRVFLASH_ESMCUninitialize(void)
+{
+  int32_t status = DRVFLASH_ESMCPowerControl(ARM_POWER_OFF);
+
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  DRVFLASH_ESMCResources.cb_event = NULL;
+  DRVFLASH_ESMCResources.Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power Driver_Flash1 on or off.
+  * @note   The ESMC stays initialized, it belongs to the application.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY to power off while an operation runs
+  */
+static int32_t DRVFLASH_ESMCPowerControl(ARM_POWER_STATE state)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      pRes->Flags &= ~DRVFLASH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if (((pRes->Flags & DRVFLASH_FLAG_INITIALIZED) == 0U) || (pRes->hflash->hesmc == NULL))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      pRes->Error  = 0U;
+      pRes->Flags |= DRVFLASH_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Read Driver_Flash1.
+  * @param  addr First address.
+  * @param  data Bytes read.
+  * @param  cnt Number of bytes.
+  * @retval Number of bytes read or execution status
+  */
+static int32_t DRVFLASH_ESMCReadData(uint32_t addr, void *data, uint32_t cnt)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+  HAL_StatusTypeDef status;
+
+  if ((data == NULL) || (addr >= pRes->Size) || (cnt > (pRes->Size - addr)) || (cnt > (uint32_t)INT32_MAX))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+  if (cnt == 0U)
+  {
+    return 0;
+  }
+
+  status = BSP_ESMCFLASH_Read(pRes->hflash, addr, (uint8_t *)data, cnt);
+  if (status != HAL_OK)
+  {
+    return (status == HAL_BUSY) ? ARM_DRIVER_ERROR_BUSY : ARM_DRIVER_ERROR;
+  }
+
+  return (int32_t)cnt;
+}
+
+/**
+  * @brief  Start programming erased bytes of Driver_Flash1.
+  * @param  addr First address.
+  * @param  data Bytes to program, valid until ARM_FLASH_EVENT_READY.
+  * @param  cnt Number of bytes.
+  * @retval Execution status, ARM_DRIVER_OK for 0 items programmed once started
+  */
+static int32_t DRVFLASH_ESMCProgramData(uint32_t addr, const void *data, uint32_t cnt)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+
+  if ((data == NULL) || (cnt == 0U) || (addr >= pRes->Size) || (cnt > (pRes->Size - addr)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Error = 0U;
+  pRes->Busy  = 1U;
+
+  return DRVFLASH_ESMCStatus(BSP_ESMCFLASH_Program_IT(pRes->hflash, addr, (const uint8_t *)data, cnt));
+}
+
+/**
+  * @brief  Start erasing a sector of Driver_Flash1.
+  * @param  addr Address in the sector.
+  * @retval Execution status
+  */
+static int32_t DRVFLASH_ESMCEraseSector(uint32_t addr)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+
+  if (addr >= pRes->Size)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Error = 0U;
+  pRes->Busy  = 1U;
+
+  return DRVFLASH_ESMCStatus(BSP_ESMCFLASH_Erase_IT(pRes->hflash, addr - (addr % BSP_DRVFLASH_ESMC_SECTOR_SIZE),
+                                                   BSP_ESMCFLASH_ERASE_SECTOR));
+}
+
+/**
+  * @brief  Start erasing the whole Driver_Flash1.
+  * @retval Execution status
+  */
+static int32_t DRVFLASH_ESMCEraseChip(void)
+{
+  DRVFLASH_ESMCResourcesTypeDef *pRes = &DRVFLASH_ESMCResources;
+
+  if ((pRes->Flags & DRVFLASH_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Error = 0U;
+  pRes->Busy  = 1U;
+
+  return DRVFLASH_ESMCStatus(BSP_ESMCFLASH_Erase_IT(pRes->hflash, 0U, BSP_ESMCFLASH_ERASE_CHIP));
+}
+
+/**
+  * @brief  Get the status of Driver_Flash1.
+  * @retval Flash status
+  */
+static ARM_FLASH_STATUS DRVFLASH_ESMCGetStatus(void)
+{
+  ARM_FLASH_STATUS status = {0};
+
+  status.busy  = DRVFLASH_ESMCResources.Busy;
+  status.error = DRVFLASH_ESMCResources.Error;
+
+  return status;
+}
+
+/**
+  * @brief  Get the geometry of Driver_Flash1.
+  * @retval Flash information, sector_count 0 without an attached flash
+  */
+static ARM_FLASH_INFO *DRVFLASH_ESMCGetInfo(void)
+{
+  return &DRVFLASH_ESMCInfo;
+}
+
+/**
+  * @brief  Convert the start of an operation of the ESMC flash service.
+  * @note   Busy is set before the start, the end coming from
+  *         BSP_ESMCFLASH_Tick() at any time after it.
+  * @param  Status Return of the start function of the service.
+  * @retval Execution status
+  */
+static int32_t DRVFLASH_ESMCStatus(HAL_StatusTypeDef Status)
+{
+  if (Status != HAL_OK)
+  {
+    DRVFLASH_ESMCResources.Busy = 0U;
+    return (Status == HAL_BUSY) ? ARM_DRIVER_ERROR_BUSY : ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,978 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvi2c.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver I2C BSP service.
+  *          This file provides the Driver_I2C.h interface of I2C1 and I2C2
+  *          over the I2C HAL:
+  *           + Master transfers with repeated start, 7 and 10-bit addresses
+  *           + Slave transfers on the own address
+  *           + Non-blocking transfers on the DMA
+  *           + Bus clear by the BSP_I2CRECOVER service
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Fill the Instance and the Init structure of an I2C handle.
+       HAL_I2C_MspInit() configures the pins, links a DMA channel in DMA_NORMAL
+       mode to hdmatx and one to hdmarx with __HAL_LINKDMA(), and enables the
+       I2C event, I2C error and both DMA channel interrupts in the NVIC.
+
+   (#) Call BSP_DRVI2C_Attach() with the handle. Driver_I2Cn of the I2C
+       instance then owns it, HAL_I2C_Init() and HAL_I2C_MspInit() are run by
+       its PowerControl(ARM_POWER_FULL) and HAL_I2C_DeInit() by
+       PowerControl(ARM_POWER_OFF).
+
+   (#) The interrupt handlers stay the ones of the HAL: HAL_I2C_EV_IRQHandler()
+       and HAL_I2C_ER_IRQHandler() in the I2Cx handlers and HAL_DMA_IRQHandler()
+       in the handlers of both DMA channels. When USE_HAL_I2C_REGISTER_CALLBACKS
+       is 0 call BSP_DRVI2C_MasterTxCpltCallback(),
+       BSP_DRVI2C_MasterRxCpltCallback(), BSP_DRVI2C_SlaveTxCpltCallback(),
+       BSP_DRVI2C_SlaveRxCpltCallback() and BSP_DRVI2C_ErrorCallback() from
+       the HAL callbacks of the same names, other I2Cs are ignored. Otherwise
+       they are registered at power up.
+
+   (#) MasterTransmit() and MasterReceive() send a start, or a repeated start
+       after a transfer with xfer_pending, and then a stop unless xfer_pending
+       is true. A transfer is at most 65535 bytes, the size of the DMA counter.
+       The I2C has one addressing mode, the one of ARM_I2C_OWN_ADDRESS: a
+       10-bit slave address needs an own address with ARM_I2C_ADDRESS_10BIT.
+       Its end is signalled to the cb_event of Initialize():
+       (+) ARM_I2C_EVENT_TRANSFER_DONE when num bytes are exchanged.
+       (+) ARM_I2C_EVENT_ADDRESS_NACK with TRANSFER_INCOMPLETE when no device
+           acknowledged the address, ARM_I2C_EVENT_TRANSFER_INCOMPLETE alone
+           when data was not acknowledged.
+       (+) ARM_I2C_EVENT_ARBITRATION_LOST or ARM_I2C_EVENT_BUS_ERROR with
+           TRANSFER_INCOMPLETE, then run ARM_I2C_BUS_CLEAR.
+
+   (#) SlaveTransmit() and SlaveReceive() wait for the own address set by
+       ARM_I2C_OWN_ADDRESS. ARM_I2C_ADDRESS_GC makes the slave answer the
+       general call, not signalled apart. A slave addressed with no transfer
+       pending stretches the clock until one is started, the
+       ARM_I2C_EVENT_SLAVE_TRANSMIT and ARM_I2C_EVENT_SLAVE_RECEIVE events are
+       not generated.
+
+   (#) ARM_I2C_BUS_CLEAR needs a bus recovery given by BSP_DRVI2C_SetRecovery(),
+       initialized on the same handle, and signals ARM_I2C_EVENT_BUS_CLEAR.
+
+   (#) ARM_I2C_BUS_SPEED_FAST_PLUS and ARM_I2C_BUS_SPEED_HIGH are not
+       supported by the I2C.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_drvi2c.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVI2C BSP DRVI2C
+  * @brief CMSIS-Driver I2C BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_I2C_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Private_Types BSP DRVI2C Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of an I2C
+  */
+typedef struct
+{
+  I2C_HandleTypeDef       *hi2c;        /*!< Attached I2C, NULL when none                          */
+
+  BSP_I2CRECOVER_TypeDef  *hrecover;    /*!< Bus recovery of ARM_I2C_BUS_CLEAR, NULL when none     */
+
+  ARM_I2C_SignalEvent_t   cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVI2C_FLAG_xxx                                       */
+
+  DMA_HandleTypeDef       *hdmacount;   /*!< DMA counting the bytes of the current transfer        */
+
+  uint32_t                Num;          /*!< Bytes of the current or last transfer                 */
+
+  __IO uint32_t           Count;        /*!< Bytes exchanged by the last transfer, once ended      */
+
+  __IO uint32_t           Busy;         /*!< 1 from the start of a transfer to its end             */
+
+  __IO uint32_t           Pending;      /*!< 1 after a master transfer ended without a stop        */
+
+  uint32_t                Master;       /*!< 1 for a master transfer                               */
+
+  uint32_t                Receiver;     /*!< 1 for a receive transfer                              */
+
+  __IO uint32_t           Errors;       /*!< Error events of the last transfer                     */
+
+} DRVI2C_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Private_Constants BSP DRVI2C Private Constants
+  * @{
+  */
+#define DRVI2C_VERSION            ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+#define DRVI2C_MAX_XFER_SIZE      0xFFFFU     /*!< Largest DMA transfer, CNDTR is 16-bit */
+
+#define DRVI2C_FLAG_INITIALIZED   0x01U
+#define DRVI2C_FLAG_POWERED       0x02U
+
+#define DRVI2C_SPEED_STANDARD     100000U     /*!< ARM_I2C_BUS_SPEED_STANDARD, Hz */
+#define DRVI2C_SPEED_FAST         400000U     /*!< ARM_I2C_BUS_SPEED_FAST, Hz     */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Private_Macros BSP DRVI2C Private Macros
+  * @{
+  */
+
+/**
+  * @brief  Define the access functions and the access structure of a driver.
+  * @param  __N__ I2C number, 1 to BSP_DRVI2C_NUMBER.
+  */
+#define DRVI2C_DRIVER(__N__)                                                                     \
+static int32_t DRVI2C##__N__##_Initialize(ARM_I2C_SignalEvent_t cb_event)                        \
+{                                                                                                \
+  return DRVI2C_Initialize(&DRVI2C_Resources[(__N__) - 1U], cb_event);                           \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_Uninitialize(void)                                                \
+{                                                                                                \
+  return DRVI2C_Uninitialize(&DRVI2C_Resources[(__N__) - 1U]);                                   \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_PowerControl(ARM_POWER_STATE state)                               \
+{                                                                                                \
+  return DRVI2C_PowerControl(&DRVI2C_Resources[(__N__) - 1U], state);                            \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_MasterTransmit(uint32_t addr, const uint8_t *data, uint32_t num,  \
+                                              bool xfer_pending)                                 \
+{                                                                                                \
+  return DRVI2C_MasterTransfer(&DRVI2C_Resources[(__N__) - 1U], addr, (uint8_t *)(uint32_t)data, \
+                               num, xfer_pending, 0U);                                           \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_MasterReceive(uint32_t addr, uint8_t *data, uint32_t num,         \
+                                             bool xfer_pending)                                  \
+{                                                                                                \
+  return DRVI2C_MasterTransfer(&DRVI2C_Resources[(__N__) - 1U], addr, data, num, xfer_pending,   \
+                               1U);                                                              \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_SlaveTransmit(const uint8_t *data, uint32_t num)                  \
+{                                                                                                \
+  return DRVI2C_SlaveTransfer(&DRVI2C_Resources[(__N__) - 1U], (uint8_t *)(uint32_t)data, num,   \
+                              0U);                                                               \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_SlaveReceive(uint8_t *data, uint32_t num)                         \
+{                                                                                                \
+  return DRVI2C_SlaveTransfer(&DRVI2C_Resources[(__N__) - 1U], data, num, 1U);                   \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_GetDataCount(void)                                                \
+{                                                                                                \
+  return DRVI2C_GetDataCount(&DRVI2C_Resources[(__N__) - 1U]);                                   \
+}                                                                                                \
+static int32_t DRVI2C##__N__##_Control(uint32_t control, uint32_t arg)                           \
+{                                                                                                \
+  return DRVI2C_Control(&DRVI2C_Resources[(__N__) - 1U], control, arg);                          \
+}                                                                                                \
+static ARM_I2C_STATUS DRVI2C##__N__##_GetStatus(void)                                            \
+{                                                                                                \
+  return DRVI2C_GetStatus(&DRVI2C_Resources[(__N__) - 1U]);                                      \
+}                                                                                                \
+ARM_DRIVER_I2C Driver_I2C##__N__ =                                                               \
+{                                                                                                \
+  DRVI2C_GetVersion,                                                                             \
+  DRVI2C_GetCapabilities,                                                                        \
+  DRVI2C##__N__##_Initialize,                                                                    \
+  DRVI2C##__N__##_Uninitialize,                                                                  \
+  DRVI2C##__N__##_PowerControl,                                                                  \
+  DRVI2C##__N__##_MasterTransmit,                                                                \
+  DRVI2C##__N__##_MasterReceive,                                                                 \
+  DRVI2C##__N__##_SlaveTransmit,                                                                 \
+  DRVI2C##__N__##_SlaveReceive,                                                                  \
+  DRVI2C##__N__##_GetDataCount,                                                                  \
+  DRVI2C##__N__##_Control,                                                                       \
+  DRVI2C##__N__##_GetStatus                                                                      \
+}
+
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Private_Variables BSP DRVI2C Private Variables
+  * @{
+  */
+static I2C_TypeDef * const DRVI2C_Instances[BSP_DRVI2C_NUMBER] =
+{
+  I2C1, I2C2
+};
+
+static DRVI2C_ResourcesTypeDef DRVI2C_Resources[BSP_DRVI2C_NUMBER];
+
+static const ARM_I2C_CAPABILITIES DRVI2C_Capabilities =
+{
+  1U,   /* address_10_bit */
+  0U    /* reserved       */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVI2C_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION   DRVI2C_GetVersion(void);
+static ARM_I2C_CAPABILITIES DRVI2C_GetCapabilities(void);
+static int32_t              DRVI2C_Initialize(DRVI2C_ResourcesTypeDef *pRes, ARM_I2C_SignalEvent_t cb_event);
+static int32_t              DRVI2C_Uninitialize(DRVI2C_ResourcesTypeDef *pRes);
+static int32_t              DRVI2C_PowerControl(DRVI2C_ResourcesTypeDef *pRes, ARM_POWER_STATE state);
+static int32_t              DRVI2C_MasterTransfer(DRVI2C_ResourcesTypeDef *pRes, uint32_t addr, uint8_t *data,
+                                                  uint32_t num, bool xfer_pending, uint32_t Receiver);
+static int32_t              DRVI2C_SlaveTransfer(DRVI2C_ResourcesTypeDef *pRes, uint8_t *data, uint32_t num,
+                                                 uint32_t Receiver);
+static int32_t              DRVI2C_GetDataCount(const DRVI2C_ResourcesTypeDef *pRes);
+static int32_t              DRVI2C_Control(DRVI2C_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg);
+static ARM_I2C_STATUS       DRVI2C_GetStatus(const DRVI2C_ResourcesTypeDef *pRes);
+static void                 DRVI2C_Stop(DRVI2C_ResourcesTypeDef *pRes);
+static DRVI2C_ResourcesTypeDef *DRVI2C_Find(const I2C_HandleTypeDef *hi2c);
+static void                 DRVI2C_End(DRVI2C_ResourcesTypeDef *pRes, uint32_t Events);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVI2C_Exported_Variables
+  * @{
+  */
+DRVI2C_DRIVER(1);
+DRVI2C_DRIVER(2);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Exported_Functions BSP DRVI2C Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVI2C_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Give an I2C handle to the driver of its instance
+      (+) Give the driver the bus recovery of ARM_I2C_BUS_CLEAR
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach an I2C handle to the driver of its instance.
+  * @note   The handle is not initialized here, PowerControl(ARM_POWER_FULL)
+  *         does it with the Init structure given.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure, Instance and Init filled.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVI2C_Attach(I2C_HandleTypeDef *hi2c)
+{
+  uint32_t i;
+
+  if (hi2c == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < BSP_DRVI2C_NUMBER; i++)
+  {
+    if (hi2c->Instance == DRVI2C_Instances[i])
+    {
+      if ((DRVI2C_Resources[i].Flags & DRVI2C_FLAG_POWERED) != 0U)
+      {
+        return HAL_BUSY;
+      }
+
+      DRVI2C_Resources[i].hi2c     = hi2c;
+      DRVI2C_Resources[i].hrecover = NULL;
+
+      return HAL_OK;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @brief  Give the bus recovery run by ARM_I2C_BUS_CLEAR to a driver.
+  * @param  hi2c Pointer to an attached I2C_HandleTypeDef structure.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure initialized
+  *                  on hi2c, NULL to remove it.
+  * @retval HAL status, HAL_BUSY while a transfer runs
+  */
+HAL_StatusTypeDef BSP_DRVI2C_SetRecovery(I2C_HandleTypeDef *hi2c, BSP_I2CRECOVER_TypeDef *hrecover)
+{
+  uint32_t i;
+
+  if ((hi2c == NULL) || ((hrecover != NULL) && (hrecover->hi2c != hi2c)))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < BSP_DRVI2C_NUMBER; i++)
+  {
+    if (DRVI2C_Resources[i].hi2c == hi2c)
+    {
+      if (DRVI2C_Resources[i].Busy != 0U)
+      {
+        return HAL_BUSY;
+      }
+
+      DRVI2C_Resources[i].hrecover = hrecover;
+
+      return HAL_OK;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVI2C_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handlers to call from the I2C HAL callbacks
+    when USE_HAL_I2C_REGISTER_CALLBACKS is 0.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  I2C master transmit complete handler of the drivers.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVI2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  DRVI2C_ResourcesTypeDef *pRes = DRVI2C_Find(hi2c);
+
+  if (pRes != NULL)
+  {
+    DRVI2C_End(pRes, ARM_I2C_EVENT_TRANSFER_DONE);
+  }
+}
+
+/**
+  * @brief  I2C master receive complete handler of the drivers.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVI2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  DRVI2C_ResourcesTypeDef *pRes = DRVI2C_Find(hi2c);
+
+  if (pRes != NULL)
+  {
+    DRVI2C_End(pRes, ARM_I2C_EVENT_TRANSFER_DONE);
+  }
+}
+
+/**
+  * @brief  I2C slave transmit complete handler of the drivers.
+  * @note   Also called on the not acknowledge ending the transfer before num bytes.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVI2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  DRVI2C_ResourcesTypeDef *pRes = DRVI2C_Find(hi2c);
+
+  if (pRes != NULL)
+  {
+    DRVI2C_End(pRes, ARM_I2C_EVENT_TRANSFER_DONE);
+  }
+}
+
+/**
+  * @brief  I2C slave receive complete handler of the drivers.
+  * @note   Also called on the stop ending the transfer before num bytes.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVI2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  DRVI2C_ResourcesTypeDef *pRes = DRVI2C_Find(hi2c);
+
+  if (pRes != NULL)
+  {
+    DRVI2C_End(pRes, ARM_I2C_EVENT_TRANSFER_DONE);
+  }
+}
+
+/**
+  * @brief  I2C error handler of the drivers.
+  * @note   The HAL stops the DMA transfer and a master sends a stop on an error.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVI2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  DRVI2C_ResourcesTypeDef *pRes = DRVI2C_Find(hi2c);
+  uint32_t events = ARM_I2C_EVENT_TRANSFER_DONE | ARM_I2C_EVENT_TRANSFER_INCOMPLETE;
+
+  if ((pRes == NULL) || (pRes->Busy == 0U))
+  {
+    return;
+  }
+
+  /* The DMA moves no byte before the address is acknowledged */
+  if (((hi2c->ErrorCode & HAL_I2C_ERROR_AF) != 0U) && (pRes->Master != 0U) &&
+      (__HAL_DMA_GET_COUNTER(pRes->hdmacount) == pRes->Num))
+  {
+    events |= ARM_I2C_EVENT_ADDRESS_NACK;
+  }
+  if ((hi2c->ErrorCode & HAL_I2C_ERROR_ARLO) != 0U)
+  {
+    events |= ARM_I2C_EVENT_ARBITRATION_LOST;
+  }
+  if ((hi2c->ErrorCode & HAL_I2C_ERROR_BERR) != 0U)
+  {
+    events |= ARM_I2C_EVENT_BUS_ERROR;
+  }
+  pRes->Errors  = events;
+  pRes->Pending = 0U;
+
+  DRVI2C_End(pRes, events);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVI2C_Private_Functions BSP DRVI2C Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVI2C_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_I2C_API_VERSION, DRVI2C_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities, the same for every I2C
+  */
+static ARM_I2C_CAPABILITIES DRVI2C_GetCapabilities(void)
+{
+  return DRVI2C_Capabilities;
+}
+
+/**
+  * @brief  Initialize a driver.
+  * @param  pRes Driver state.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached I2C
+  */
+static int32_t DRVI2C_Initialize(DRVI2C_ResourcesTypeDef *pRes, ARM_I2C_SignalEvent_t cb_event)
+{
+  if (pRes->hi2c == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRes->Flags & DRVI2C_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  pRes->cb_event = cb_event;
+  pRes->Flags    = DRVI2C_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize a driver, powering it off first.
+  * @param  pRes Driver state.
+  * @retval Execution status
+  */
+static int32_t DRVI2C_Uninitialize(DRVI2C_ResourcesTypeDef *pRes)
+{
+  (void)DRVI2C_PowerControl(pRes, ARM_POWER_OFF);
+
+  pRes->cb_event = NULL;
+  pRes->Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power a driver on or off.
+  * @param  pRes Driver state.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status
+  */
+static int32_t DRVI2C_PowerControl(DRVI2C_ResourcesTypeDef *pRes, ARM_POWER_STATE state)
+{
+  I2C_HandleTypeDef *hi2c = pRes->hi2c;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVI2C_FLAG_POWERED) != 0U)
+      {
+        DRVI2C_Stop(pRes);
+        (void)HAL_I2C_DeInit(hi2c);
+      }
+      pRes->Busy    = 0U;
+      pRes->Pending = 0U;
+      pRes->Errors  = 0U;
+      pRes->Flags  &= ~DRVI2C_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVI2C_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVI2C_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+      if (HAL_I2C_Init(hi2c) != HAL_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((hi2c->hdmatx == NULL) || (hi2c->hdmarx == NULL))
+      {
+        (void)HAL_I2C_DeInit(hi2c);
+        return ARM_DRIVER_ERROR;
+      }
+
+#if (USE_HAL_I2C_REGISTER_CALLBACKS == 1U)
+      /* After HAL_I2C_Init(), which set the callbacks to their default from the reset state */
+      if ((HAL_I2C_RegisterCallback(hi2c, HAL_I2C_MASTER_TX_COMPLETE_CB_ID, BSP_DRVI2C_MasterTxCpltCallback) != HAL_OK) ||
+          (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_MASTER_RX_COMPLETE_CB_ID, BSP_DRVI2C_MasterRxCpltCallback) != HAL_OK) ||
+          (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_SLAVE_TX_COMPLETE_CB_ID, BSP_DRVI2C_SlaveTxCpltCallback) != HAL_OK) ||
+          (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_SLAVE_RX_COMPLETE_CB_ID, BSP_DRVI2C_SlaveRxCpltCallback) != HAL_OK) ||
+          (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_ERROR_CB_ID, BSP_DRVI2C_ErrorCallback) != HAL_OK))
+      {
+        (void)HAL_I2C_DeInit(hi2c);
+        return ARM_DRIVER_ERROR;
+      }
+#endif /* USE_HAL_I2C_REGISTER_CALLBACKS */
+
+      pRes->Count   = 0U;
+      pRes->Pending = 0U;
+      pRes->Errors  = 0U;
+      pRes->Flags  |= DRVI2C_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Start a master transfer on the DMA.
+  * @param  pRes Driver state.
+  * @param  addr Slave address, 7-bit or 10-bit with ARM_I2C_ADDRESS_10BIT.
+  * @param  data Bytes sent or received.
+  * @param  num Number of bytes, 1 to 65535.
+  * @param  xfer_pending true to end without a stop, the next transfer then
+  *                      starts with a repeated start.
+  * @param  Receiver 1 to receive, 0 to transmit.
+  * @retval Execution status
+  */
+static int32_t DRVI2C_MasterTransfer(DRVI2C_ResourcesTypeDef *pRes, uint32_t addr, uint8_t *data,
+                                     uint32_t num, bool xfer_pending, uint32_t Receiver)
+{
+  I2C_HandleTypeDef *hi2c = pRes->hi2c;
+  HAL_StatusTypeDef status;
+  uint32_t options;
+  uint16_t address;
+
+  if ((data == NULL) || (num == 0U) || (num > DRVI2C_MAX_XFER_SIZE))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  /* The addressing mode of the HAL is the one of the own address */
+  if ((addr & ARM_I2C_ADDRESS_10BIT) != 0U)
+  {
+    if (((addr & ~(uint32_t)ARM_I2C_ADDRESS_10BIT) > 0x3FFU) ||
+        (pRes->hi2c->Init.AddressingMode != I2C_ADDRESSINGMODE_10BIT))
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    address = (uint16_t)(addr & 0x3FFU);
+  }
+  else
+  {
+    if ((addr > 0x7FU) || (pRes->hi2c->Init.AddressingMode != I2C_ADDRESSINGMODE_7BIT))
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    address = (uint16_t)(addr << 1U);
+  }
+  if ((pRes->Flags & DRVI2C_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->Busy != 0U) || (hi2c->State != HAL_I2C_STATE_READY))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  /* A first frame sends a start, an other frame forces a repeated start after the pending one */
+  if (pRes->Pending == 0U)
+  {
+    options = xfer_pending ? I2C_FIRST_FRAME : I2C_FIRST_AND_LAST_FRAME;
+  }
+  else
+  {
+    options = xfer_pending ? I2C_OTHER_FRAME : I2C_OTHER_AND_LAST_FRAME;
+  }
+
+  pRes->Num       = num;
+  pRes->Count     = 0U;
+  pRes->Errors    = 0U;
+  pRes->Master    = 1U;
+  pRes->Receiver  = Receiver;
+  pRes->hdmacount = (Receiver != 0U) ? hi2c->hdmarx : hi2c->hdmatx;
+  pRes->Pending   = xfer_pending ? 1U : 0U;
+  pRes->Busy      = 1U;
+
+  if (Receiver != 0U)
+  {
+    status = HAL_I2C_Master_Seq_Receive_DMA(hi2c, address, data, (uint16_t)num, options);
+  }
+  else
+  {
+    status = HAL_I2C_Master_Seq_Transmit_DMA(hi2c, address, data, (uint16_t)num, options);
+  }
+
+  if (status != HAL_OK)
+  {
+    pRes->Busy    = 0U;
+    pRes->Pending = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start a slave transfer on the DMA, run once addressed.
+  * @param  pRes Driver state.
+  * @param  data Bytes sent or received.
+  * @param  num Number of bytes, 1 to 65535.
+  * @param  Receiver 1 to receive, 0 to transmit.
+  * @retval Execution status
+  */
+static int32_t DRVI2C_SlaveTransfer(DRVI2C_ResourcesTypeDef *pRes, uint8_t *data, uint32_t num, uint32_t Receiver)
+{
+  I2C_HandleTypeDef *hi2c = pRes->hi2c;
+  HAL_StatusTypeDef status;
+
+  if ((data == NULL) || (num == 0U) || (num > DRVI2C_MAX_XFER_SIZE))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVI2C_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->Busy != 0U) || (pRes->Pending != 0U) || (hi2c->State != HAL_I2C_STATE_READY))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Num       = num;
+  pRes->Count     = 0U;
+  pRes->Errors    = 0U;
+  pRes->Master    = 0U;
+  pRes->Receiver  = Receiver;
+  pRes->hdmacount = (Receiver != 0U) ? hi2c->hdmarx : hi2c->hdmatx;
+  pRes->Busy      = 1U;
+
+  if (Receiver != 0U)
+  {
+    status = HAL_I2C_Slave_Receive_DMA(hi2c, data, (uint16_t)num);
+  }
+  else
+  {
+    status = HAL_I2C_Slave_Transmit_DMA(hi2c, data, (uint16_t)num);
+  }
+
+  if (status != HAL_OK)
+  {
+    pRes->Busy = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the number of bytes exchanged by the current or last transfer.
+  * @param  pRes Driver state.
+  * @retval Bytes exchanged
+  */
+static int32_t DRVI2C_GetDataCount(const DRVI2C_ResourcesTypeDef *pRes)
+{
+  if (pRes->Busy != 0U)
+  {
+    return (int32_t)(pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount));
+  }
+
+  return (int32_t)pRes->Count;
+}
+
+/**
+  * @brief  Control a driver.
+  * @param  pRes Driver state.
+  * @param  control Operation.
+  * @param  arg Argument of the operation.
+  * @retval Execution status
+  */
+static int32_t DRVI2C_Control(DRVI2C_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg)
+{
+  I2C_HandleTypeDef *hi2c = pRes->hi2c;
+  HAL_StatusTypeDef status;
+
+  if ((pRes->Flags & DRVI2C_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (control)
+  {
+    case ARM_I2C_OWN_ADDRESS:
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      if ((arg & ARM_I2C_ADDRESS_10BIT) != 0U)
+      {
+        hi2c->Init.AddressingMode = I2C_ADDRESSINGMODE_10BIT;
+        hi2c->Init.OwnAddress1    = arg & 0x3FFU;
+      }
+      else
+      {
+        hi2c->Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+        hi2c->Init.OwnAddress1    = (arg & 0x7FU) << 1U;
+      }
+      hi2c->Init.GeneralCallMode = ((arg & ARM_I2C_ADDRESS_GC) != 0U) ? I2C_GENERALCALL_ENABLE : I2C_GENERALCALL_DISABLE;
+      return (HAL_I2C_Init(hi2c) == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+
+    case ARM_I2C_BUS_SPEED:
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      switch (arg)
+      {
+        case ARM_I2C_BUS_SPEED_STANDARD:
+          hi2c->Init.ClockSpeed = DRVI2C_SPEED_STANDARD;
+          break;
+        case ARM_I2C_BUS_SPEED_FAST:
+          hi2c->Init.ClockSpeed = DRVI2C_SPEED_FAST;
+          hi2c->Init.DutyCycle  = I2C_DUTYCYCLE_2;
+          break;
+        default:
+          return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      return (HAL_I2C_Init(hi2c) == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+
+    case ARM_I2C_BUS_CLEAR:
+      if (pRes->hrecover == NULL)
+      {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      pRes->Pending = 0U;
+      status = BSP_I2CRECOVER_Recover(pRes->hrecover);
+      if (pRes->cb_event != NULL)
+      {
+        pRes->cb_event(ARM_I2C_EVENT_BUS_CLEAR);
+      }
+      return (status == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+
+    case ARM_I2C_ABORT_TRANSFER:
+      if ((pRes->Busy != 0U) || (pRes->Pending != 0U))
+      {
+        if (pRes->Busy != 0U)
+        {
+          pRes->Count = pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount);
+        }
+        DRVI2C_Stop(pRes);
+        pRes->Busy    = 0U;
+        pRes->Pending = 0U;
+        return (HAL_I2C_Init(hi2c) == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Get the driver status.
+  * @param  pRes Driver state.
+  * @retval Status
+  */
+static ARM_I2C_STATUS DRVI2C_GetStatus(const DRVI2C_ResourcesTypeDef *pRes)
+{
+  ARM_I2C_STATUS status = {0U};
+  uint32_t errors = pRes->Errors;
+
+  status.busy             = (pRes->Busy != 0U) ? 1U : 0U;
+  status.mode             = pRes->Master;
+  status.direction        = pRes->Receiver;
+  status.arbitration_lost = ((errors & ARM_I2C_EVENT_ARBITRATION_LOST) != 0U) ? 1U : 0U;
+  status.bus_error        = ((errors & ARM_I2C_EVENT_BUS_ERROR) != 0U) ? 1U : 0U;
+
+  return status;
+}
+
+/**
+  * @brief  Stop the transfer of the I2C and its DMA, a master sending a stop.
+  * @note   HAL_I2C_Init() then applies the Init structure again, without
+  *         HAL_I2C_MspInit().
+  * @param  pRes Driver state.
+  * @retval None
+  */
+static void DRVI2C_Stop(DRVI2C_ResourcesTypeDef *pRes)
+{
+  I2C_HandleTypeDef *hi2c = pRes->hi2c;
+
+  CLEAR_BIT(hi2c->Instance->CR2, (I2C_CR2_DMAEN | I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN));
+  (void)HAL_DMA_Abort(hi2c->hdmatx);
+  (void)HAL_DMA_Abort(hi2c->hdmarx);
+  if ((hi2c->Instance->SR2 & I2C_SR2_MSL) != 0U)
+  {
+    SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
+  }
+  __HAL_I2C_DISABLE(hi2c);
+
+  /* A state other than reset keeps HAL_I2C_Init() from calling the MSP */
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->Mode  = HAL_I2C_MODE_NONE;
+  hi2c->Lock  = HAL_UNLOCKED;
+}
+
+/**
+  * @brief  Find the driver of an I2C handle.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure.
+  * @retval Driver state, NULL when the handle is not attached
+  */
+static DRVI2C_ResourcesTypeDef *DRVI2C_Find(const I2C_HandleTypeDef *hi2c)
+{
+  uint32_t i;
+
+  for (i = 0U; i < BSP_DRVI2C_NUMBER; i++)
+  {
+    if ((DRVI2C_Resources[i].hi2c == hi2c) && ((DRVI2C_Resources[i].Flags & DRVI2C_FLAG_POWERED) != 0U))
+    {
+      return &DRVI2C_Resources[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  End the current transfer and signal its events.
+  * @param  pRes Driver state.
+  * @param  Events ARM_I2C_EVENT_xxx bits.
+  * @retval None
+  */
+static void DRVI2C_End(DRVI2C_ResourcesTypeDef *pRes, uint32_t Events)
+{
+  if (pRes->Busy == 0U)
+  {
+    return;
+  }
+
+  pRes->Count = pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount);
+  pRes->Busy  = 0U;
+  if (pRes->Count < pRes->Num)
+  {
+    Events |= ARM_I2C_EVENT_TRANSFER_INCOMPLETE;
+  }
+
+  if (pRes->cb_event != NULL)
+  {
+    pRes->cb_event(Events);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1111 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvmci.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver MCI BSP service.
+  *          This file provides the Driver_MCI.h interface of the SDIO, for
+  *          the file system middlewares bringing up the card themselves:
+  *           + Non-blocking commands with short, long and busy responses
+  *           + Block data transfers on the DMA, read and write
+  *           + 1, 4 and 8-bit bus, default and high speed modes
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Fill the Instance of a SD handle with SDIO and its Init structure:
+       ClockSel, PreSampling and PreSamplingClockSel are kept, the bus width,
+       the divider and the clock power save belong to the driver.
+       HAL_SD_MspInit() configures the pins, links a DMA channel in DMA_NORMAL
+       mode to hdmarx and one to hdmatx with __HAL_LINKDMA(), words on both
+       sides and the memory incremented, and enables the SDIO and both DMA
+       channel interrupts in the NVIC, the DMA above the SDIO.
+
+   (#) Call BSP_DRVMCI_Attach() with the handle. Driver_MCI0 then owns the
+       SDIO: HAL_SD_Init() is not called, the card identification is the job
+       of the middleware. PowerControl(ARM_POWER_FULL) runs HAL_SD_MspInit()
+       and starts the card clock at BSP_DRVMCI_INIT_SPEED, CardPower() drives
+       the power enable of the SDIO.
+
+   (#) Call BSP_DRVMCI_IRQHandler() from SDIO_IRQHandler() in place of
+       HAL_SD_IRQHandler(), and HAL_DMA_IRQHandler() from the handlers of both
+       DMA channels.
+
+   (#) SendCommand() returns once the command is loaded, the response is
+       written to response and ARM_MCI_EVENT_COMMAND_COMPLETE signalled from
+       the interrupt, or ARM_MCI_EVENT_COMMAND_TIMEOUT and
+       ARM_MCI_EVENT_COMMAND_ERROR. With ARM_MCI_TRANSFER_DATA the data phase
+       prepared by SetupTransfer() follows, ARM_MCI_EVENT_TRANSFER_COMPLETE
+       being signalled once the SDIO and the DMA both ended it.
+       (+) The data is word aligned and the block size a multiple of 4
+           bytes, BSP_DRVMCI_MAX_XFER_SIZE bytes at most.
+       (+) ARM_MCI_WAIT_BUSY holds the command until the previous data
+           transfer and the card busy end.
+
+   (#) The SDIO has no interrupt at the end of the card busy of a
+       ARM_MCI_RESPONSE_SHORT_BUSY command: call BSP_DRVMCI_Tick()
+       periodically, for instance from a timer update interrupt at 1 kHz. It
+       signals the command completion once the card releases DAT0, or
+       ARM_MCI_EVENT_COMMAND_TIMEOUT after the data timeout.
+
+   (#) ARM_MCI_BUS_SPEED sets the smallest divider keeping the card clock,
+       HCLK / (2 x ClockDiv), under the speed requested and returns the
+       speed reached. The card itself is switched to the high speed by the
+       middleware with CMD6, ARM_MCI_BUS_SPEED_MODE only records it.
+
+   (#) Card detect, write protect, SD I/O interrupts and the UHS-I modes are
+       not supported.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_drvmci.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVMCI BSP DRVMCI
+  * @brief CMSIS-Driver MCI BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Private_Types BSP DRVMCI Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of the SDIO
+  */
+typedef struct
+{
+  SD_HandleTypeDef        *hsd;         /*!< Attached SD handle, NULL when none                    */
+
+  ARM_MCI_SignalEvent_t   cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVMCI_FLAG_xxx                                       */
+
+  uint32_t                ClockDiv;     /*!< Divider of the card clock, 0 for HCLK                 */
+
+  uint32_t                BusSpeed;     /*!< Card clock reached by ClockDiv, Hz                    */
+
+  uint32_t                DataTimeout;  /*!< Data timeout, card clock cycles                       */
+
+  uint32_t                *pResponse;   /*!< Response of the current command, NULL for none        */
+
+  uint32_t                CmdFlags;     /*!< Flags of the current command                          */
+
+  uint32_t                BusyStart;    /*!< HAL_GetTick() at the start of the card busy           */
+
+  uint8_t                 *pData;       /*!< Buffer of the prepared transfer                       */
+
+  uint32_t                XferSize;     /*!< Bytes of the prepared transfer                        */
+
+  uint32_t                XferMode;     /*!< ARM_MCI_TRANSFER_xxx of the prepared transfer         */
+
+  __IO uint32_t           Status;       /*!< DRVMCI_STATUS_xxx                                     */
+
+} DRVMCI_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Private_Constants BSP DRVMCI Private Constants
+  * @{
+  */
+#define DRVMCI_VERSION              ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+#define DRVMCI_MAX_DIV              0xFFU       /*!< Largest ClockDiv, CLKDIV is 8-bit        */
+#define DRVMCI_MAX_DATA_TIMEOUT     0xFFFFFFU   /*!< Largest data timeout, TMOUT is 24-bit    */
+
+#define DRVMCI_FLAG_INITIALIZED     0x01U
+#define DRVMCI_FLAG_POWERED         0x02U
+#define DRVMCI_FLAG_SETUP           0x04U       /*!< SetupTransfer() done, no command yet     */
+
+#define DRVMCI_STATUS_CMD_ACTIVE    0x001U
+#define DRVMCI_STATUS_CMD_TIMEOUT   0x002U
+#define DRVMCI_STATUS_CMD_ERROR     0x004U
+#define DRVMCI_STATUS_XFER_ACTIVE   0x008U
+#define DRVMCI_STATUS_XFER_TIMEOUT  0x010U
+#define DRVMCI_STATUS_XFER_ERROR    0x020U
+#define DRVMCI_STATUS_BUSY_WAIT     0x040U      /*!< Response received, card busy on DAT0     */
+#define DRVMCI_STATUS_DATA_PENDING  0x080U      /*!< Data path of the SDIO not ended yet      */
+#define DRVMCI_STATUS_DMA_PENDING   0x100U      /*!< DMA not ended yet                        */
+
+#define DRVMCI_IT_CMD               (SDIO_IT_CD | SDIO_IT_RE | SDIO_IT_RCRC | SDIO_IT_RTO_BAR)
+#define DRVMCI_IT_DATA              (SDIO_IT_DTO | SDIO_IT_DCRC | SDIO_IT_DRTO_BDS | SDIO_IT_HTO | \
+                                     SDIO_IT_FRUN | SDIO_IT_SBE | SDIO_IT_EBE)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Private_Variables BSP DRVMCI Private Variables
+  * @{
+  */
+static DRVMCI_ResourcesTypeDef DRVMCI_Resources;
+
+static const ARM_MCI_CAPABILITIES DRVMCI_Capabilities =
+{
+  0U,   /* cd_state          */
+  0U,   /* cd_event          */
+  0U,   /* wp_state          */
+  1U,   /* vdd               */
+  0U,   /* vdd_1v8           */
+  0U,   /* vccq              */
+  0U,   /* vccq_1v8          */
+  0U,   /* vccq_1v2          */
+  1U,   /* data_width_4      */
+  1U,   /* data_width_8      */
+  0U,   /* data_width_4_ddr  */
+  0U,   /* data_width_8_ddr  */
+  1U,   /* high_speed        */
+  0U,   /* uhs_signaling     */
+  0U,   /* uhs_tuning        */
+  0U,   /* uhs_sdr50         */
+  0U,   /* uhs_sdr104        */
+  0U,   /* uhs_ddr50         */
+  0U,   /* uhs_driver_type_a */
+  0U,   /* uhs_driver_type_c */
+  0U,   /* uhs_driver_type_d */
+  0U,   /* sdio_interrupt    */
+  0U,   /* read_wait         */
+  0U,   /* suspend_resume    */
+  0U,   /* mmc_interrupt     */
+  0U,   /* mmc_boot          */
+  0U,   /* rst_n             */
+  0U,   /* ccs               */
+  0U,   /* ccs_timeout       */
+  0U    /* reserved          */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVMCI_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION   DRVMCI_GetVersion(void);
+static ARM_MCI_CAPABILITIES DRVMCI_GetCapabilities(void);
+static int32_t              DRVMCI_Initialize(ARM_MCI_SignalEvent_t cb_event);
+static int32_t              DRVMCI_Uninitialize(void);
+static int32_t              DRVMCI_PowerControl(ARM_POWER_STATE state);
+static int32_t              DRVMCI_CardPower(uint32_t voltage);
+static int32_t              DRVMCI_ReadCD(void);
+static int32_t              DRVMCI_ReadWP(void);
+static int32_t              DRVMCI_SendCommand(uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t *response);
+static int32_t              DRVMCI_SetupTransfer(uint8_t *data, uint32_t block_count, uint32_t block_size,
+                                                 uint32_t mode);
+static int32_t              DRVMCI_AbortTransfer(void);
+static int32_t              DRVMCI_Control(uint32_t control, uint32_t arg);
+static ARM_MCI_STATUS       DRVMCI_GetStatus(void);
+static void                 DRVMCI_SetClock(DRVMCI_ResourcesTypeDef *pRes, uint32_t BusSpeed);
+static void                 DRVMCI_UpdateClock(const DRVMCI_ResourcesTypeDef *pRes, uint32_t Mask, uint32_t Value);
+static void                 DRVMCI_ResetFIFO(SDIO_TypeDef *SDIOx);
+static void                 DRVMCI_StopData(DRVMCI_ResourcesTypeDef *pRes);
+static void                 DRVMCI_CmdEnd(DRVMCI_ResourcesTypeDef *pRes, uint32_t Event);
+static void                 DRVMCI_XferEnd(DRVMCI_ResourcesTypeDef *pRes, uint32_t Pending, uint32_t Event);
+static void                 DRVMCI_DMACplt(DMA_HandleTypeDef *hdma);
+static void                 DRVMCI_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVMCI_Exported_Variables
+  * @{
+  */
+ARM_DRIVER_MCI Driver_MCI0 =
+{
+  DRVMCI_GetVersion,
+  DRVMCI_GetCapabilities,
+  DRVMCI_Initialize,
+  DRVMCI_Uninitialize,
+  DRVMCI_PowerControl,
+  DRVMCI_CardPower,
+  DRVMCI_ReadCD,
+  DRVMCI_ReadWP,
+  DRVMCI_SendCommand,
+  DRVMCI_SetupTransfer,
+  DRVMCI_AbortTransfer,
+  DRVMCI_Control,
+  DRVMCI_GetStatus
+};
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Exported_Functions BSP DRVMCI Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVMCI_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides a function allowing to:
+      (+) Give the SD handle of the SDIO to the driver
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach the SD handle of the SDIO to the driver.
+  * @note   The card is not initialized, HAL_SD_Init() must not be called on
+  *         the handle while it is attached.
+  * @param  hsd Pointer to a SD_HandleTypeDef structure, Instance and Init filled.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVMCI_Attach(SD_HandleTypeDef *hsd)
+{
+  if ((hsd == NULL) || (hsd->Instance != SDIO))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((DRVMCI_Resources.Flags & DRVMCI_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  DRVMCI_Resources.hsd = hsd;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVMCI_Exported_Functions_Group2 Interrupt and tick functions
+  * @brief    Interrupt and tick functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Interrupt and tick functions #####
+ ===============================================================================
+    [..]
+    This section provides the handler to call from SDIO_IRQHandler() and the
+    tick ending the card busy of the commands.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  SDIO interrupt handler of the driver.
+  * @retval None
+  */
+void BSP_DRVMCI_IRQHandler(void)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  SDIO_TypeDef *SDIOx = SDIO;
+  uint32_t flags;
+  uint32_t i;
+
+  flags = SDIOx->INTSTS & SDIOx->INTMASK;
+  __SDIO_CLEAR_FLAG(SDIOx, flags);
+
+  if (((flags & DRVMCI_IT_CMD) != 0U) && ((pRes->Status & DRVMCI_STATUS_CMD_ACTIVE) != 0U) &&
+      ((pRes->Status & DRVMCI_STATUS_BUSY_WAIT) == 0U))
+  {
+    if ((flags & SDIO_FLAG_RTO_BAR) != 0U)
+    {
+      DRVMCI_CmdEnd(pRes, ARM_MCI_EVENT_COMMAND_TIMEOUT);
+    }
+    else if ((((flags & SDIO_FLAG_RCRC) != 0U) && ((pRes->CmdFlags & ARM_MCI_RESPONSE_CRC) != 0U)) ||
+             (((flags & SDIO_FLAG_RE) != 0U) && ((pRes->CmdFlags & ARM_MCI_RESPONSE_INDEX) != 0U)))
+    {
+      DRVMCI_CmdEnd(pRes, ARM_MCI_EVENT_COMMAND_ERROR);
+    }
+    else if ((flags & SDIO_FLAG_CD) != 0U)
+    {
+      if (pRes->pResponse != NULL)
+      {
+        if ((pRes->CmdFlags & ARM_MCI_RESPONSE_Msk) == ARM_MCI_RESPONSE_LONG)
+        {
+          /* RESP0 holds the bits 31:0 of the R2 response, RESP3 the bits 127:96 */
+          for (i = 0U; i < 4U; i++)
+          {
+            pRes->pResponse[i] = SDIO_GetResponse(SDIOx, i * 4U);
+          }
+        }
+        else
+        {
+          pRes->pResponse[0] = SDIO_GetResponse(SDIOx, SDIO_RESP1);
+        }
+      }
+
+      if (((pRes->CmdFlags & ARM_MCI_RESPONSE_Msk) == ARM_MCI_RESPONSE_SHORT_BUSY) && __SDIO_IS_CARD_BUSY(SDIOx))
+      {
+        /* No interrupt at the end of the busy, BSP_DRVMCI_Tick() polls it */
+        pRes->BusyStart = HAL_GetTick();
+        pRes->Status   |= DRVMCI_STATUS_BUSY_WAIT;
+      }
+      else
+      {
+        DRVMCI_CmdEnd(pRes, ARM_MCI_EVENT_COMMAND_COMPLETE);
+      }
+    }
+    else
+    {
+      /* Response error not checked, wait for the command done */
+    }
+  }
+
+  if (((flags & DRVMCI_IT_DATA) != 0U) && ((pRes->Status & DRVMCI_STATUS_XFER_ACTIVE) != 0U))
+  {
+    if ((flags & (SDIO_FLAG_DRTO_BDS | SDIO_FLAG_HTO)) != 0U)
+    {
+      DRVMCI_StopData(pRes);
+      DRVMCI_XferEnd(pRes, DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING, ARM_MCI_EVENT_TRANSFER_TIMEOUT);
+    }
+    else if ((flags & (SDIO_FLAG_DCRC | SDIO_FLAG_FRUN | SDIO_FLAG_SBE | SDIO_FLAG_EBE)) != 0U)
+    {
+      DRVMCI_StopData(pRes);
+      DRVMCI_XferEnd(pRes, DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING, ARM_MCI_EVENT_TRANSFER_ERROR);
+    }
+    else
+    {
+      /* Data transfer over: the DMA may still be draining the FIFO of a read */
+      DRVMCI_XferEnd(pRes, DRVMCI_STATUS_DATA_PENDING, ARM_MCI_EVENT_TRANSFER_COMPLETE);
+    }
+  }
+}
+
+/**
+  * @brief  End the card busy of a ARM_MCI_RESPONSE_SHORT_BUSY command.
+  * @note   To call periodically, the timeout is the data timeout.
+  * @retval None
+  */
+void BSP_DRVMCI_Tick(void)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  uint32_t timeout;
+
+  if ((pRes->Status & DRVMCI_STATUS_BUSY_WAIT) == 0U)
+  {
+    return;
+  }
+
+  if (!__SDIO_IS_CARD_BUSY(SDIO))
+  {
+    DRVMCI_CmdEnd(pRes, ARM_MCI_EVENT_COMMAND_COMPLETE);
+    return;
+  }
+
+  timeout = (pRes->DataTimeout / ((pRes->BusSpeed / 1000U) + 1U)) + 1U;
+  if ((HAL_GetTick() - pRes->BusyStart) > timeout)
+  {
+    DRVMCI_CmdEnd(pRes, ARM_MCI_EVENT_COMMAND_TIMEOUT);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVMCI_Private_Functions BSP DRVMCI Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVMCI_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_MCI_API_VERSION, DRVMCI_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities
+  */
+static ARM_MCI_CAPABILITIES DRVMCI_GetCapabilities(void)
+{
+  return DRVMCI_Capabilities;
+}
+
+/**
+  * @brief  Initialize the driver.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached SD handle
+  */
+static int32_t DRVMCI_Initialize(ARM_MCI_SignalEvent_t cb_event)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+
+  if (pRes->hsd == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRes->Flags & DRVMCI_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  pRes->cb_event = cb_event;
+  pRes->Flags    = DRVMCI_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize the driver, powering it off first.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_Uninitialize(void)
+{
+  (void)DRVMCI_PowerControl(ARM_POWER_OFF);
+
+  DRVMCI_Resources.cb_event = NULL;
+  DRVMCI_Resources.Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power the SDIO on or off.
+  * @note   The card power stays off until CardPower().
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_PowerControl(ARM_POWER_STATE state)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  SD_HandleTypeDef *hsd = pRes->hsd;
+  SDIO_InitTypeDef init;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVMCI_FLAG_POWERED) != 0U)
+      {
+        DRVMCI_StopData(pRes);
+        __SDIO_DISABLE_GLOBAL_IT(hsd->Instance);
+        __SDIO_DISABLE_IT(hsd->Instance, DRVMCI_IT_CMD | DRVMCI_IT_DATA);
+        (void)SDIO_PowerState_OFF(hsd->Instance);
+        SDIO_ClockDisable(hsd->Instance);
+#if (USE_HAL_SD_REGISTER_CALLBACKS == 1U)
+        if (hsd->MspDeInitCallback == NULL)
+        {
+          hsd->MspDeInitCallback = HAL_SD_MspDeInit;
+        }
+        hsd->MspDeInitCallback(hsd);
+#else
+        HAL_SD_MspDeInit(hsd);
+#endif /* USE_HAL_SD_REGISTER_CALLBACKS */
+        hsd->State = HAL_SD_STATE_RESET;
+      }
+      pRes->Status = 0U;
+      pRes->Flags &= ~(DRVMCI_FLAG_POWERED | DRVMCI_FLAG_SETUP);
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVMCI_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVMCI_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+#if (USE_HAL_SD_REGISTER_CALLBACKS == 1U)
+      if (hsd->MspInitCallback == NULL)
+      {
+        hsd->MspInitCallback = HAL_SD_MspInit;
+      }
+      hsd->MspInitCallback(hsd);
+#else
+      HAL_SD_MspInit(hsd);
+#endif /* USE_HAL_SD_REGISTER_CALLBACKS */
+      if ((hsd->hdmarx == NULL) || (hsd->hdmatx == NULL))
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      /* The SDIO belongs to the driver, HAL_SD functions fail on a busy handle */
+      hsd->State = HAL_SD_STATE_BUSY;
+
+      /* 1-bit bus, clock running when idle until ARM_MCI_CONTROL_CLOCK_IDLE */
+      init                     = hsd->Init;
+      init.BusWide             = SDIO_BUS_WIDE_1B;
+      init.ClockPowerSave      = SDIO_CLOCK_POWER_SAVE_DISABLE;
+      init.ClockDiv            = 0U;
+      (void)SDIO_Init(hsd->Instance, init);
+      DRVMCI_SetClock(pRes, BSP_DRVMCI_INIT_SPEED);
+
+      DRVMCI_ResetFIFO(hsd->Instance);
+      (void)SDIO_SetFifoThreshold(hsd->Instance, RX_FIFO_DEPTH, TX_FIFO_DEPTH);
+      pRes->DataTimeout = DRVMCI_MAX_DATA_TIMEOUT;
+      pRes->Status      = 0U;
+
+      __SDIO_CLEAR_FLAG(hsd->Instance, SDIO_STATIC_FLAGS);
+      __SDIO_ENABLE_IT(hsd->Instance, DRVMCI_IT_CMD | DRVMCI_IT_DATA);
+      __SDIO_ENABLE_GLOBAL_IT(hsd->Instance);
+
+      pRes->Flags |= DRVMCI_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_LOW:
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Drive the card power enable of the SDIO.
+  * @param  voltage ARM_MCI_POWER_VDD_OFF or ARM_MCI_POWER_VDD_3V3.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_CardPower(uint32_t voltage)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+
+  if ((pRes->Flags & DRVMCI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (voltage & ARM_MCI_POWER_VDD_Msk)
+  {
+    case ARM_MCI_POWER_VDD_OFF:
+      (void)SDIO_PowerState_OFF(pRes->hsd->Instance);
+      return ARM_DRIVER_OK;
+
+    case ARM_MCI_POWER_VDD_3V3:
+      (void)SDIO_PowerState_ON(pRes->hsd->Instance);
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Read the card detect state, not supported.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVMCI_ReadCD(void)
+{
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Read the write protect state, not supported.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVMCI_ReadWP(void)
+{
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Send a command, starting the prepared data transfer with it.
+  * @param  cmd Command index, 0 to 63.
+  * @param  arg Command argument.
+  * @param  flags ARM_MCI_RESPONSE_xxx, ARM_MCI_WAIT_BUSY, ARM_MCI_TRANSFER_DATA
+  *         and ARM_MCI_CARD_INITIALIZE.
+  * @param  response Response buffer, 1 word or 4 for ARM_MCI_RESPONSE_LONG.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_SendCommand(uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t *response)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  SDIO_CmdInitTypeDef command;
+
+  if ((pRes->Flags & DRVMCI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((cmd > 63U) || (((flags & ARM_MCI_RESPONSE_Msk) != ARM_MCI_RESPONSE_NONE) && (response == NULL)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((flags & (ARM_MCI_INTERRUPT_COMMAND | ARM_MCI_INTERRUPT_RESPONSE | ARM_MCI_BOOT_OPERATION |
+                ARM_MCI_BOOT_ALTERNATIVE | ARM_MCI_BOOT_ACK | ARM_MCI_CCSD | ARM_MCI_CCS)) != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if (((flags & ARM_MCI_TRANSFER_DATA) != 0U) && ((pRes->Flags & DRVMCI_FLAG_SETUP) == 0U))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->Status & DRVMCI_STATUS_CMD_ACTIVE) != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->pResponse = ((flags & ARM_MCI_RESPONSE_Msk) != ARM_MCI_RESPONSE_NONE) ? response : NULL;
+  pRes->CmdFlags  = flags;
+  pRes->Status    = (pRes->Status & ~(DRVMCI_STATUS_CMD_TIMEOUT | DRVMCI_STATUS_CMD_ERROR)) |
+                    DRVMCI_STATUS_CMD_ACTIVE;
+
+  command.Argument     = arg;
+  command.CmdIndex     = cmd;
+  command.Response     = ((flags & ARM_MCI_RESPONSE_Msk) == ARM_MCI_RESPONSE_NONE) ? SDIO_RESPONSE_NO :
+                         ((flags & ARM_MCI_RESPONSE_Msk) == ARM_MCI_RESPONSE_LONG) ? SDIO_RESPONSE_LONG :
+                         SDIO_RESPONSE_SHORT;
+  command.WaitPend     = ((flags & (ARM_MCI_WAIT_BUSY | ARM_MCI_TRANSFER_DATA)) != 0U) ?
+                         SDIO_WAIT_PEND_ENABLE : SDIO_WAIT_PEND_DISABLE;
+  command.AutoInit     = ((flags & ARM_MCI_CARD_INITIALIZE) != 0U) ? SDIO_AUTO_INIT_ENABLE : SDIO_AUTO_INIT_DISABLE;
+  command.CheckCRC     = ((flags & ARM_MCI_RESPONSE_CRC) != 0U) ? SDIO_CHECK_CRC_ENABLE : SDIO_CHECK_CRC_DISABLE;
+  command.DataTransfer = SDIO_DATA_TRANSFER_DISABLE;
+  command.CPSM         = SDIO_CPSM_ENABLE;
+
+  if ((flags & ARM_MCI_TRANSFER_DATA) != 0U)
+  {
+    /* The data path of SetupTransfer() runs with the command */
+    command.DataTransfer = SDIO_DATA_TRANSFER_ENABLE;
+    pRes->Flags &= ~DRVMCI_FLAG_SETUP;
+  }
+
+  (void)SDIO_SendCommand(pRes->hsd->Instance, &command);
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Prepare the data transfer of the next command with ARM_MCI_TRANSFER_DATA.
+  * @note   The DMA is started here, the SDIO requesting the data once the
+  *         command is sent.
+  * @param  data Word aligned buffer.
+  * @param  block_count Number of blocks.
+  * @param  block_size Size of a block, multiple of 4 bytes.
+  * @param  mode ARM_MCI_TRANSFER_READ or ARM_MCI_TRANSFER_WRITE, block transfer.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_SetupTransfer(uint8_t *data, uint32_t block_count, uint32_t block_size, uint32_t mode)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  SD_HandleTypeDef *hsd = pRes->hsd;
+  SDIO_DataInitTypeDef config;
+  DMA_HandleTypeDef *hdma;
+  uint32_t size;
+  HAL_StatusTypeDef status;
+
+  if ((pRes->Flags & DRVMCI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((data == NULL) || (block_count == 0U) || (block_size == 0U) || ((block_size & 3U) != 0U) ||
+      (((uint32_t)data & 3U) != 0U) || (block_count > (BSP_DRVMCI_MAX_XFER_SIZE / block_size)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((mode & ARM_MCI_TRANSFER_STREAM) != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((pRes->Status & DRVMCI_STATUS_XFER_ACTIVE) != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  size = block_count * block_size;
+  pRes->pData    = data;
+  pRes->XferSize = size;
+  pRes->XferMode = mode;
+
+  DRVMCI_ResetFIFO(hsd->Instance);
+  __SDIO_CLEAR_FLAG(hsd->Instance, SDIO_STATIC_DATA_FLAGS);
+
+  config.DataTimeOut   = pRes->DataTimeout;
+  config.DataLength    = size;
+  config.DataBlockSize = block_size;
+  config.TransferDir   = ((mode & ARM_MCI_TRANSFER_WRITE) != 0U) ? SDIO_TRANSFER_DIR_TO_CARD : SDIO_TRANSFER_DIR_TO_SDIO;
+  config.TransferMode  = SDIO_TRANSFER_MODE_BLOCK;
+  (void)SDIO_ConfigData(hsd->Instance, &config);
+
+  pRes->Status = (pRes->Status & ~(DRVMCI_STATUS_XFER_TIMEOUT | DRVMCI_STATUS_XFER_ERROR)) |
+                 DRVMCI_STATUS_XFER_ACTIVE | DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING;
+
+  if ((mode & ARM_MCI_TRANSFER_WRITE) != 0U)
+  {
+    hdma = hsd->hdmatx;
+    hdma->XferCpltCallback  = DRVMCI_DMACplt;
+    hdma->XferErrorCallback = DRVMCI_DMAError;
+    hdma->XferAbortCallback = NULL;
+    status = HAL_DMA_Start_IT(hdma, (uint32_t)data, (uint32_t)&hsd->Instance->FIFODATA, size / 4U);
+  }
+  else
+  {
+    hdma = hsd->hdmarx;
+    hdma->XferCpltCallback  = DRVMCI_DMACplt;
+    hdma->XferErrorCallback = DRVMCI_DMAError;
+    hdma->XferAbortCallback = NULL;
+    status = HAL_DMA_Start_IT(hdma, (uint32_t)&hsd->Instance->FIFODATA, (uint32_t)data, size / 4U);
+  }
+  if (status != HAL_OK)
+  {
+    pRes->Status &= ~(DRVMCI_STATUS_XFER_ACTIVE | DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING);
+    return ARM_DRIVER_ERROR;
+  }
+
+  __SDIO_DMA_ENABLE(hsd->Instance);
+  pRes->Flags |= DRVMCI_FLAG_SETUP;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Abort the current data transfer, without event.
+  * @note   The card is not told: the middleware sends CMD12 after it.
+  * @retval Execution status
+  */
+static int32_t DRVMCI_AbortTransfer(void)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+
+  if ((pRes->Flags & DRVMCI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  DRVMCI_StopData(pRes);
+  pRes->Flags  &= ~DRVMCI_FLAG_SETUP;
+  pRes->Status &= ~(DRVMCI_STATUS_XFER_ACTIVE | DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING);
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Control the bus.
+  * @param  control ARM_MCI_BUS_SPEED, ARM_MCI_BUS_SPEED_MODE, ARM_MCI_BUS_CMD_MODE,
+  *         ARM_MCI_BUS_DATA_WIDTH, ARM_MCI_CONTROL_CLOCK_IDLE or ARM_MCI_DATA_TIMEOUT.
+  * @param  arg Argument of the control.
+  * @retval Execution status, the speed reached for ARM_MCI_BUS_SPEED
+  */
+static int32_t DRVMCI_Control(uint32_t control, uint32_t arg)
+{
+  DRVMCI_ResourcesTypeDef *pRes = &DRVMCI_Resources;
+  SDIO_TypeDef *SDIOx;
+
+  if ((pRes->Flags & DRVMCI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  SDIOx = pRes->hsd->Instance;
+
+  switch (control)
+  {
+    case ARM_MCI_BUS_SPEED:
+      if (arg == 0U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      DRVMCI_SetClock(pRes, arg);
+      return (int32_t)pRes->BusSpeed;
+
+    case ARM_MCI_BUS_SPEED_MODE:
+      /* The SDIO has no speed mode of its own, the clock is set by ARM_MCI_BUS_SPEED */
+      if ((arg == ARM_MCI_BUS_DEFAULT_SPEED) || (arg == ARM_MCI_BUS_HIGH_SPEED))
+      {
+        return ARM_DRIVER_OK;
+      }
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+
+    case ARM_MCI_BUS_CMD_MODE:
+      if (arg == ARM_MCI_BUS_CMD_OPEN_DRAIN)
+      {
+        __SDIO_OD_PULLUP_ENABLE(SDIOx);
+      }
+      else if (arg == ARM_MCI_BUS_CMD_PUSH_PULL)
+      {
+        __SDIO_OD_PULLUP_DISABLE(SDIOx);
+      }
+      else
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_MCI_BUS_DATA_WIDTH:
+      switch (arg)
+      {
+        case ARM_MCI_BUS_DATA_WIDTH_1:
+          DRVMCI_UpdateClock(pRes, SDIO_CLKCR_WIDBUS, SDIO_BUS_WIDE_1B);
+          return ARM_DRIVER_OK;
+        case ARM_MCI_BUS_DATA_WIDTH_4:
+          DRVMCI_UpdateClock(pRes, SDIO_CLKCR_WIDBUS, SDIO_BUS_WIDE_4B);
+          return ARM_DRIVER_OK;
+        case ARM_MCI_BUS_DATA_WIDTH_8:
+          DRVMCI_UpdateClock(pRes, SDIO_CLKCR_WIDBUS, SDIO_BUS_WIDE_8B);
+          return ARM_DRIVER_OK;
+        default:
+          return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+
+    case ARM_MCI_CONTROL_CLOCK_IDLE:
+      DRVMCI_UpdateClock(pRes, SDIO_CLKCR_PWRSAV,
+                         (arg != 0U) ? SDIO_CLOCK_POWER_SAVE_DISABLE : SDIO_CLOCK_POWER_SAVE_ENABLE);
+      return ARM_DRIVER_OK;
+
+    case ARM_MCI_DATA_TIMEOUT:
+      pRes->DataTimeout = (arg > DRVMCI_MAX_DATA_TIMEOUT) ? DRVMCI_MAX_DATA_TIMEOUT : arg;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Get the driver status.
+  * @retval Status of the command and of the data transfer
+  */
+static ARM_MCI_STATUS DRVMCI_GetStatus(void)
+{
+  ARM_MCI_STATUS status = {0};
+  uint32_t state = DRVMCI_Resources.Status;
+
+  status.command_active   = ((state & DRVMCI_STATUS_CMD_ACTIVE) != 0U) ? 1U : 0U;
+  status.command_timeout  = ((state & DRVMCI_STATUS_CMD_TIMEOUT) != 0U) ? 1U : 0U;
+  status.command_error    = ((state & DRVMCI_STATUS_CMD_ERROR) != 0U) ? 1U : 0U;
+  status.transfer_active  = ((state & DRVMCI_STATUS_XFER_ACTIVE) != 0U) ? 1U : 0U;
+  status.transfer_timeout = ((state & DRVMCI_STATUS_XFER_TIMEOUT) != 0U) ? 1U : 0U;
+  status.transfer_error   = ((state & DRVMCI_STATUS_XFER_ERROR) != 0U) ? 1U : 0U;
+
+  return status;
+}
+
+/**
+  * @brief  Set the smallest divider keeping the card clock under a speed.
+  * @note   The card clock is HCLK / (2 x ClockDiv), ClockDiv 0 passing HCLK through.
+  * @param  pRes Driver state.
+  * @param  BusSpeed Highest card clock, Hz.
+  * @retval None
+  */
+static void DRVMCI_SetClock(DRVMCI_ResourcesTypeDef *pRes, uint32_t BusSpeed)
+{
+  uint32_t hclk = HAL_RCC_GetHCLKFreq();
+  uint32_t div;
+
+  if (BusSpeed >= hclk)
+  {
+    div = 0U;
+  }
+  else
+  {
+    div = (hclk + (2U * BusSpeed) - 1U) / (2U * BusSpeed);
+    if (div > DRVMCI_MAX_DIV)
+    {
+      div = DRVMCI_MAX_DIV;
+    }
+  }
+
+  pRes->ClockDiv = div;
+  pRes->BusSpeed = (div == 0U) ? hclk : (hclk / (2U * div));
+
+  SDIO_SetClock(pRes->hsd->Instance, div);
+}
+
+/**
+  * @brief  Change CLKCR bits, loading them in the card clock domain.
+  * @param  pRes Driver state.
+  * @param  Mask Bits of CLKCR to change.
+  * @param  Value New value of the bits.
+  * @retval None
+  */
+static void DRVMCI_UpdateClock(const DRVMCI_ResourcesTypeDef *pRes, uint32_t Mask, uint32_t Value)
+{
+  SDIO_TypeDef *SDIOx = pRes->hsd->Instance;
+
+  MODIFY_REG(SDIOx->CLKCR, Mask, Value);
+  /* SDIO_SetClock() runs the update sequence of the clock registers */
+  SDIO_SetClock(SDIOx, pRes->ClockDiv);
+}
+
+/**
+  * @brief  Reset the FIFO of the SDIO.
+  * @param  SDIOx Pointer to SDIO register base.
+  * @retval None
+  */
+static void DRVMCI_ResetFIFO(SDIO_TypeDef *SDIOx)
+{
+  SET_BIT(SDIOx->CTRL, SDIO_CTRL_FIFORST);
+  while ((SDIOx->CTRL & SDIO_CTRL_FIFORST) != 0U)
+  {
+  }
+}
+
+/**
+  * @brief  Stop the DMA and the data path of the SDIO.
+  * @param  pRes Driver state.
+  * @retval None
+  */
+static void DRVMCI_StopData(DRVMCI_ResourcesTypeDef *pRes)
+{
+  SD_HandleTypeDef *hsd = pRes->hsd;
+
+  __SDIO_DMA_DISABLE(hsd->Instance);
+  if ((pRes->Status & DRVMCI_STATUS_DMA_PENDING) != 0U)
+  {
+    (void)HAL_DMA_Abort(((pRes->XferMode & ARM_MCI_TRANSFER_WRITE) != 0U) ? hsd->hdmatx : hsd->hdmarx);
+  }
+  DRVMCI_ResetFIFO(hsd->Instance);
+}
+
+/**
+  * @brief  End the current command and signal it.
+  * @param  pRes Driver state.
+  * @param  Event ARM_MCI_EVENT_COMMAND_xxx.
+  * @retval None
+  */
+static void DRVMCI_CmdEnd(DRVMCI_ResourcesTypeDef *pRes, uint32_t Event)
+{
+  uint32_t status = pRes->Status & ~(DRVMCI_STATUS_CMD_ACTIVE | DRVMCI_STATUS_BUSY_WAIT);
+
+  if (Event == ARM_MCI_EVENT_COMMAND_TIMEOUT)
+  {
+    status |= DRVMCI_STATUS_CMD_TIMEOUT;
+  }
+  else if (Event == ARM_MCI_EVENT_COMMAND_ERROR)
+  {
+    status |= DRVMCI_STATUS_CMD_ERROR;
+  }
+  else
+  {
+    /* Command complete */
+  }
+
+  if ((Event != ARM_MCI_EVENT_COMMAND_COMPLETE) && ((pRes->CmdFlags & ARM_MCI_TRANSFER_DATA) != 0U) &&
+      ((status & DRVMCI_STATUS_XFER_ACTIVE) != 0U))
+  {
+    /* No data phase after a failed command */
+    pRes->Status = status;
+    DRVMCI_StopData(pRes);
+    status &= ~(DRVMCI_STATUS_XFER_ACTIVE | DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING);
+  }
+  pRes->Status = status;
+
+  if (pRes->cb_event != NULL)
+  {
+    pRes->cb_event(Event);
+  }
+}
+
+/**
+  * @brief  Clear pending parts of the data transfer, signalling its end.
+  * @note   A read ends with the DMA, after the data path; a write with the
+  *         data path, after the DMA.
+  * @param  pRes Driver state.
+  * @param  Pending DRVMCI_STATUS_DATA_PENDING and/or DRVMCI_STATUS_DMA_PENDING ended.
+  * @param  Event ARM_MCI_EVENT_TRANSFER_xxx.
+  * @retval None
+  */
+static void DRVMCI_XferEnd(DRVMCI_ResourcesTypeDef *pRes, uint32_t Pending, uint32_t Event)
+{
+  uint32_t status = pRes->Status & ~Pending;
+
+  if (Event == ARM_MCI_EVENT_TRANSFER_TIMEOUT)
+  {
+    status |= DRVMCI_STATUS_XFER_TIMEOUT;
+  }
+  else if (Event == ARM_MCI_EVENT_TRANSFER_ERROR)
+  {
+    status |= DRVMCI_STATUS_XFER_ERROR;
+  }
+  else if ((status & (DRVMCI_STATUS_DATA_PENDING | DRVMCI_STATUS_DMA_PENDING)) != 0U)
+  {
+    /* The other half is still running */
+    pRes->Status = status;
+    return;
+  }
+  else
+  {
+    __SDIO_DMA_DISABLE(pRes->hsd->Instance);
+  }
+
+  pRes->Status = status & ~DRVMCI_STATUS_XFER_ACTIVE;
+
+  if (pRes->cb_event != NULL)
+  {
+    pRes->cb_event(Event);
+  }
+}
+
+/**
+  * @brief  DMA transfer complete callback of both channels.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void DRVMCI_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if ((DRVMCI_Resources.Status & DRVMCI_STATUS_DMA_PENDING) != 0U)
+  {
+    DRVMCI_XferEnd(&DRVMCI_Resources, DRVMCI_STATUS_DMA_PENDING, ARM_MCI_EVENT_TRANSFER_COMPLETE);
+  }
+}
+
+/**
+  * @brief  DMA error callback of both channels.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void DRVMCI_DMAError(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if ((DRVMCI_Resources.Status & DRVMCI_STATUS_XFER_ACTIVE) != 0U)
+  {
+    DRVMCI_Resources.Status &= ~DRVMCI_STATUS_DMA_PENDING;
+    DRVMCI_StopData(&DRVMCI_Resources);
+    DRVMCI_XferEnd(&DRVMCI_Resources, DRVMCI_STATUS_DATA_PENDING, ARM_MCI_EVENT_TRANSFER_ERROR);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
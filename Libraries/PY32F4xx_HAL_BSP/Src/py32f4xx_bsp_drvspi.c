@@ -0,0 +1,959 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvspi.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver SPI BSP service.
+  *          This file provides the Driver_SPI.h interface of SPI1 to SPI3
+  *          over the SPI HAL:
+  *           + Master and slave modes, 8 and 16 data bits
+  *           + Non-blocking Send(), Receive() and Transfer() on the DMA
+  *           + Slave select by the hardware or by the application
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Fill the Instance and the Init structure of a SPI handle, Direction
+       SPI_DIRECTION_2LINES, Init being the configuration until the first
+       mode control. HAL_SPI_MspInit() configures the pins, links a DMA channel
+       in DMA_NORMAL mode to hdmatx and one to hdmarx with __HAL_LINKDMA() with
+       the data size of the frames, and enables the SPI and both DMA channel
+       interrupts in the NVIC.
+
+   (#) Call BSP_DRVSPI_Attach() with the handle. Driver_SPIn of the SPI
+       instance then owns it, HAL_SPI_Init() and HAL_SPI_MspInit() are run by
+       its PowerControl(ARM_POWER_FULL) and HAL_SPI_DeInit() by
+       PowerControl(ARM_POWER_OFF).
+
+   (#) The interrupt handlers stay the ones of the HAL: HAL_SPI_IRQHandler()
+       in SPIx_IRQHandler() and HAL_DMA_IRQHandler() in the handlers of both
+       DMA channels. When USE_HAL_SPI_REGISTER_CALLBACKS is 0 call
+       BSP_DRVSPI_TxCpltCallback(), BSP_DRVSPI_RxCpltCallback(),
+       BSP_DRVSPI_TxRxCpltCallback() and BSP_DRVSPI_ErrorCallback() from the HAL
+       callbacks of the same names, other SPIs are ignored. Otherwise they are
+       registered at power up.
+
+   (#) Send(), Receive() and Transfer() return once the DMA is started, the
+       end is signalled to the cb_event of Initialize():
+       (+) ARM_SPI_EVENT_TRANSFER_COMPLETE when num items are exchanged.
+       (+) ARM_SPI_EVENT_DATA_LOST on an overrun or a DMA error and
+           ARM_SPI_EVENT_MODE_FAULT on a mode fault, the transfer is then
+           stopped by the HAL and GetDataCount() holds its progress.
+       A master Receive() first fills data with the default transmit value and
+       sends it, each item being read by the Tx DMA before the Rx DMA writes it
+       back. A transfer is at most 65535 items, the size of the DMA counter.
+
+   (#) With ARM_SPI_SS_MASTER_SW, ARM_SPI_CONTROL_SS calls
+       BSP_DRVSPI_SlaveSelectCallback(), to implement on the GPIO of the slave
+       select. With ARM_SPI_SS_SLAVE_SW it selects the slave by the internal
+       slave select, inactive after the mode control.
+
+   (#) The TI and Microwire frame formats are not supported.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_drvspi.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVSPI BSP DRVSPI
+  * @brief CMSIS-Driver SPI BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_SPI_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Private_Types BSP DRVSPI Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of a SPI
+  */
+typedef struct
+{
+  SPI_HandleTypeDef       *hspi;        /*!< Attached SPI, NULL when none                          */
+
+  ARM_SPI_SignalEvent_t   cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVSPI_FLAG_xxx                                       */
+
+  uint32_t                SsMode;       /*!< ARM_SPI_SS_MASTER_xxx or ARM_SPI_SS_SLAVE_xxx         */
+
+  uint32_t                TxDefault;    /*!< Value sent by a master Receive()                      */
+
+  DMA_HandleTypeDef       *hdmacount;   /*!< DMA counting the items of the current transfer        */
+
+  uint32_t                Num;          /*!< Items of the current or last transfer                 */
+
+  __IO uint32_t           Count;        /*!< Items exchanged by the last transfer, once ended      */
+
+  __IO uint32_t           Busy;         /*!< 1 from the start of a transfer to its end             */
+
+  __IO uint32_t           Errors;       /*!< Error events since the start of the transfer          */
+
+} DRVSPI_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Private_Constants BSP DRVSPI Private Constants
+  * @{
+  */
+#define DRVSPI_VERSION            ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+#define DRVSPI_MAX_XFER_SIZE      0xFFFFU     /*!< Largest DMA transfer, CNDTR is 16-bit */
+
+#define DRVSPI_FLAG_INITIALIZED   0x01U
+#define DRVSPI_FLAG_POWERED       0x02U
+#define DRVSPI_FLAG_ACTIVE        0x04U       /*!< Mode other than ARM_SPI_MODE_INACTIVE */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Private_Macros BSP DRVSPI Private Macros
+  * @{
+  */
+
+/**
+  * @brief  Define the access functions and the access structure of a driver.
+  * @param  __N__ SPI number, 1 to BSP_DRVSPI_NUMBER.
+  */
+#define DRVSPI_DRIVER(__N__)                                                                     \
+static int32_t DRVSPI##__N__##_Initialize(ARM_SPI_SignalEvent_t cb_event)                        \
+{                                                                                                \
+  return DRVSPI_Initialize(&DRVSPI_Resources[(__N__) - 1U], cb_event);                           \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_Uninitialize(void)                                                \
+{                                                                                                \
+  return DRVSPI_Uninitialize(&DRVSPI_Resources[(__N__) - 1U]);                                   \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_PowerControl(ARM_POWER_STATE state)                               \
+{                                                                                                \
+  return DRVSPI_PowerControl(&DRVSPI_Resources[(__N__) - 1U], state);                            \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_Send(const void *data, uint32_t num)                              \
+{                                                                                                \
+  return DRVSPI_Transfer(&DRVSPI_Resources[(__N__) - 1U], data, NULL, num);                      \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_Receive(void *data, uint32_t num)                                 \
+{                                                                                                \
+  return DRVSPI_Transfer(&DRVSPI_Resources[(__N__) - 1U], NULL, data, num);                      \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_Transfer(const void *data_out, void *data_in, uint32_t num)       \
+{                                                                                                \
+  if ((data_out == NULL) || (data_in == NULL))                                                   \
+  {                                                                                              \
+    return ARM_DRIVER_ERROR_PARAMETER;                                                           \
+  }                                                                                              \
+  return DRVSPI_Transfer(&DRVSPI_Resources[(__N__) - 1U], data_out, data_in, num);               \
+}                                                                                                \
+static uint32_t DRVSPI##__N__##_GetDataCount(void)                                               \
+{                                                                                                \
+  return DRVSPI_GetDataCount(&DRVSPI_Resources[(__N__) - 1U]);                                   \
+}                                                                                                \
+static int32_t DRVSPI##__N__##_Control(uint32_t control, uint32_t arg)                           \
+{                                                                                                \
+  return DRVSPI_Control(&DRVSPI_Resources[(__N__) - 1U], control, arg);                          \
+}                                                                                                \
+static ARM_SPI_STATUS DRVSPI##__N__##_GetStatus(void)                                            \
+{                                                                                                \
+  return DRVSPI_GetStatus(&DRVSPI_Resources[(__N__) - 1U]);                                      \
+}                                                                                                \
+ARM_DRIVER_SPI Driver_SPI##__N__ =                                                               \
+{                                                                                                \
+  DRVSPI_GetVersion,                                                                             \
+  DRVSPI_GetCapabilities,                                                                        \
+  DRVSPI##__N__##_Initialize,                                                                    \
+  DRVSPI##__N__##_Uninitialize,                                                                  \
+  DRVSPI##__N__##_PowerControl,                                                                  \
+  DRVSPI##__N__##_Send,                                                                          \
+  DRVSPI##__N__##_Receive,                                                                       \
+  DRVSPI##__N__##_Transfer,                                                                      \
+  DRVSPI##__N__##_GetDataCount,                                                                  \
+  DRVSPI##__N__##_Control,                                                                       \
+  DRVSPI##__N__##_GetStatus                                                                      \
+}
+
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Private_Variables BSP DRVSPI Private Variables
+  * @{
+  */
+static SPI_TypeDef * const DRVSPI_Instances[BSP_DRVSPI_NUMBER] =
+{
+  SPI1, SPI2, SPI3
+};
+
+static DRVSPI_ResourcesTypeDef DRVSPI_Resources[BSP_DRVSPI_NUMBER];
+
+static const ARM_SPI_CAPABILITIES DRVSPI_Capabilities =
+{
+  0U,   /* simplex          */
+  0U,   /* ti_ssi           */
+  0U,   /* microwire        */
+  1U,   /* event_mode_fault */
+  0U    /* reserved         */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVSPI_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION   DRVSPI_GetVersion(void);
+static ARM_SPI_CAPABILITIES DRVSPI_GetCapabilities(void);
+static int32_t              DRVSPI_Initialize(DRVSPI_ResourcesTypeDef *pRes, ARM_SPI_SignalEvent_t cb_event);
+static int32_t              DRVSPI_Uninitialize(DRVSPI_ResourcesTypeDef *pRes);
+static int32_t              DRVSPI_PowerControl(DRVSPI_ResourcesTypeDef *pRes, ARM_POWER_STATE state);
+static int32_t              DRVSPI_Transfer(DRVSPI_ResourcesTypeDef *pRes, const void *data_out, void *data_in,
+                                            uint32_t num);
+static uint32_t             DRVSPI_GetDataCount(const DRVSPI_ResourcesTypeDef *pRes);
+static int32_t              DRVSPI_Control(DRVSPI_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg);
+static int32_t              DRVSPI_Configure(DRVSPI_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg);
+static ARM_SPI_STATUS       DRVSPI_GetStatus(const DRVSPI_ResourcesTypeDef *pRes);
+static uint32_t             DRVSPI_GetClock(const SPI_HandleTypeDef *hspi);
+static uint32_t             DRVSPI_GetPrescaler(const SPI_HandleTypeDef *hspi, uint32_t BusSpeed);
+static DRVSPI_ResourcesTypeDef *DRVSPI_Find(const SPI_HandleTypeDef *hspi);
+static void                 DRVSPI_End(DRVSPI_ResourcesTypeDef *pRes, uint32_t Events);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVSPI_Exported_Variables
+  * @{
+  */
+DRVSPI_DRIVER(1);
+DRVSPI_DRIVER(2);
+DRVSPI_DRIVER(3);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Exported_Functions BSP DRVSPI Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVSPI_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides a function allowing to:
+      (+) Give a SPI handle to the driver of its instance
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach a SPI handle to the driver of its instance.
+  * @note   The handle is not initialized here, PowerControl(ARM_POWER_FULL)
+  *         does it with the Init structure given.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure, Instance and Init filled.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVSPI_Attach(SPI_HandleTypeDef *hspi)
+{
+  uint32_t i;
+
+  if (hspi == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < BSP_DRVSPI_NUMBER; i++)
+  {
+    if (hspi->Instance == DRVSPI_Instances[i])
+    {
+      if ((DRVSPI_Resources[i].Flags & DRVSPI_FLAG_POWERED) != 0U)
+      {
+        return HAL_BUSY;
+      }
+
+      DRVSPI_Resources[i].hspi = hspi;
+
+      return HAL_OK;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVSPI_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handlers to call from the SPI HAL callbacks
+    when USE_HAL_SPI_REGISTER_CALLBACKS is 0, and the slave select callback.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  SPI transmit complete handler of the drivers.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVSPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  DRVSPI_ResourcesTypeDef *pRes = DRVSPI_Find(hspi);
+
+  if (pRes != NULL)
+  {
+    DRVSPI_End(pRes, ARM_SPI_EVENT_TRANSFER_COMPLETE);
+  }
+}
+
+/**
+  * @brief  SPI receive complete handler of the drivers.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVSPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  DRVSPI_ResourcesTypeDef *pRes = DRVSPI_Find(hspi);
+
+  if (pRes != NULL)
+  {
+    DRVSPI_End(pRes, ARM_SPI_EVENT_TRANSFER_COMPLETE);
+  }
+}
+
+/**
+  * @brief  SPI transmit and receive complete handler of the drivers.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVSPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  DRVSPI_ResourcesTypeDef *pRes = DRVSPI_Find(hspi);
+
+  if (pRes != NULL)
+  {
+    DRVSPI_End(pRes, ARM_SPI_EVENT_TRANSFER_COMPLETE);
+  }
+}
+
+/**
+  * @brief  SPI error handler of the drivers.
+  * @note   The HAL stops the DMA transfer on an error.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVSPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  DRVSPI_ResourcesTypeDef *pRes = DRVSPI_Find(hspi);
+  uint32_t events = 0U;
+
+  if (pRes == NULL)
+  {
+    return;
+  }
+
+  if ((hspi->ErrorCode & (HAL_SPI_ERROR_OVR | HAL_SPI_ERROR_DMA)) != 0U)
+  {
+    events |= ARM_SPI_EVENT_DATA_LOST;
+  }
+  if ((hspi->ErrorCode & HAL_SPI_ERROR_MODF) != 0U)
+  {
+    events |= ARM_SPI_EVENT_MODE_FAULT;
+  }
+  pRes->Errors |= events;
+
+  DRVSPI_End(pRes, events);
+}
+
+/**
+  * @brief  Slave select callback of ARM_SPI_CONTROL_SS with ARM_SPI_SS_MASTER_SW.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @param  Active ARM_SPI_SS_ACTIVE or ARM_SPI_SS_INACTIVE.
+  * @retval None
+  */
+__weak void BSP_DRVSPI_SlaveSelectCallback(SPI_HandleTypeDef *hspi, uint32_t Active)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hspi);
+  UNUSED(Active);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_DRVSPI_SlaveSelectCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVSPI_Private_Functions BSP DRVSPI Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVSPI_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_SPI_API_VERSION, DRVSPI_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities, the same for every SPI
+  */
+static ARM_SPI_CAPABILITIES DRVSPI_GetCapabilities(void)
+{
+  return DRVSPI_Capabilities;
+}
+
+/**
+  * @brief  Initialize a driver.
+  * @param  pRes Driver state.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached SPI
+  */
+static int32_t DRVSPI_Initialize(DRVSPI_ResourcesTypeDef *pRes, ARM_SPI_SignalEvent_t cb_event)
+{
+  if (pRes->hspi == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRes->Flags & DRVSPI_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  pRes->cb_event = cb_event;
+  pRes->Flags    = DRVSPI_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize a driver, powering it off first.
+  * @param  pRes Driver state.
+  * @retval Execution status
+  */
+static int32_t DRVSPI_Uninitialize(DRVSPI_ResourcesTypeDef *pRes)
+{
+  (void)DRVSPI_PowerControl(pRes, ARM_POWER_OFF);
+
+  pRes->cb_event = NULL;
+  pRes->Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power a driver on or off.
+  * @param  pRes Driver state.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status
+  */
+static int32_t DRVSPI_PowerControl(DRVSPI_ResourcesTypeDef *pRes, ARM_POWER_STATE state)
+{
+  SPI_HandleTypeDef *hspi = pRes->hspi;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVSPI_FLAG_POWERED) != 0U)
+      {
+        (void)HAL_SPI_Abort(hspi);
+        (void)HAL_SPI_DeInit(hspi);
+      }
+      pRes->Busy   = 0U;
+      pRes->Errors = 0U;
+      pRes->Flags &= ~(DRVSPI_FLAG_POWERED | DRVSPI_FLAG_ACTIVE);
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVSPI_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVSPI_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+      if (HAL_SPI_Init(hspi) != HAL_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((hspi->hdmatx == NULL) || (hspi->hdmarx == NULL))
+      {
+        (void)HAL_SPI_DeInit(hspi);
+        return ARM_DRIVER_ERROR;
+      }
+
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
+      /* After HAL_SPI_Init(), which set the callbacks to their default from the reset state */
+      if ((HAL_SPI_RegisterCallback(hspi, HAL_SPI_TX_COMPLETE_CB_ID, BSP_DRVSPI_TxCpltCallback) != HAL_OK) ||
+          (HAL_SPI_RegisterCallback(hspi, HAL_SPI_RX_COMPLETE_CB_ID, BSP_DRVSPI_RxCpltCallback) != HAL_OK) ||
+          (HAL_SPI_RegisterCallback(hspi, HAL_SPI_TX_RX_COMPLETE_CB_ID, BSP_DRVSPI_TxRxCpltCallback) != HAL_OK) ||
+          (HAL_SPI_RegisterCallback(hspi, HAL_SPI_ERROR_CB_ID, BSP_DRVSPI_ErrorCallback) != HAL_OK))
+      {
+        (void)HAL_SPI_DeInit(hspi);
+        return ARM_DRIVER_ERROR;
+      }
+#endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
+
+      if (hspi->Init.Mode == SPI_MODE_MASTER)
+      {
+        pRes->SsMode = (hspi->Init.NSS == SPI_NSS_HARD_OUTPUT) ? ARM_SPI_SS_MASTER_HW_OUTPUT :
+                       (hspi->Init.NSS == SPI_NSS_HARD_INPUT) ? ARM_SPI_SS_MASTER_HW_INPUT : ARM_SPI_SS_MASTER_UNUSED;
+      }
+      else
+      {
+        pRes->SsMode = (hspi->Init.NSS == SPI_NSS_SOFT) ? ARM_SPI_SS_SLAVE_SW : ARM_SPI_SS_SLAVE_HW;
+      }
+      pRes->TxDefault = 0U;
+      pRes->Count     = 0U;
+      pRes->Errors    = 0U;
+      pRes->Flags    |= DRVSPI_FLAG_POWERED | DRVSPI_FLAG_ACTIVE;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Start a transfer on the DMA.
+  * @param  pRes Driver state.
+  * @param  data_out Items sent, NULL to receive only.
+  * @param  data_in Items received, NULL to send only.
+  * @param  num Number of items, 1 to 65535.
+  * @retval Execution status
+  */
+static int32_t DRVSPI_Transfer(DRVSPI_ResourcesTypeDef *pRes, const void *data_out, void *data_in, uint32_t num)
+{
+  SPI_HandleTypeDef *hspi = pRes->hspi;
+  HAL_StatusTypeDef status;
+  uint32_t i;
+
+  if (((data_out == NULL) && (data_in == NULL)) || (num == 0U) || (num > DRVSPI_MAX_XFER_SIZE))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVSPI_FLAG_ACTIVE) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->Busy != 0U) || (hspi->State != HAL_SPI_STATE_READY))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Num       = num;
+  pRes->Count     = 0U;
+  pRes->Errors    = 0U;
+  pRes->hdmacount = (data_in != NULL) ? hspi->hdmarx : hspi->hdmatx;
+  pRes->Busy      = 1U;
+
+  if (data_in == NULL)
+  {
+    status = HAL_SPI_Transmit_DMA(hspi, (uint8_t *)(uint32_t)data_out, (uint16_t)num);
+  }
+  else if (data_out != NULL)
+  {
+    status = HAL_SPI_TransmitReceive_DMA(hspi, (uint8_t *)(uint32_t)data_out, (uint8_t *)data_in, (uint16_t)num);
+  }
+  else if (hspi->Init.Mode == SPI_MODE_MASTER)
+  {
+    /* The Tx DMA reads each item before the Rx DMA writes the received one in its place */
+    for (i = 0U; i < num; i++)
+    {
+      if (hspi->Init.DataSize == SPI_DATASIZE_16BIT)
+      {
+        ((uint16_t *)data_in)[i] = (uint16_t)pRes->TxDefault;
+      }
+      else
+      {
+        ((uint8_t *)data_in)[i] = (uint8_t)pRes->TxDefault;
+      }
+    }
+    status = HAL_SPI_TransmitReceive_DMA(hspi, (uint8_t *)data_in, (uint8_t *)data_in, (uint16_t)num);
+  }
+  else
+  {
+    status = HAL_SPI_Receive_DMA(hspi, (uint8_t *)data_in, (uint16_t)num);
+  }
+
+  if (status != HAL_OK)
+  {
+    pRes->Busy = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the number of items exchanged by the current or last transfer.
+  * @param  pRes Driver state.
+  * @retval Items exchanged
+  */
+static uint32_t DRVSPI_GetDataCount(const DRVSPI_ResourcesTypeDef *pRes)
+{
+  if (pRes->Busy != 0U)
+  {
+    return pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount);
+  }
+
+  return pRes->Count;
+}
+
+/**
+  * @brief  Control a driver.
+  * @param  pRes Driver state.
+  * @param  control Operation.
+  * @param  arg Argument of the operation.
+  * @retval Execution status, the bus speed for ARM_SPI_GET_BUS_SPEED
+  */
+static int32_t DRVSPI_Control(DRVSPI_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg)
+{
+  SPI_HandleTypeDef *hspi = pRes->hspi;
+  uint32_t br;
+
+  if ((pRes->Flags & DRVSPI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (control & ARM_SPI_CONTROL_Msk)
+  {
+    case ARM_SPI_MODE_INACTIVE:
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      __HAL_SPI_DISABLE(hspi);
+      pRes->Flags &= ~DRVSPI_FLAG_ACTIVE;
+      return ARM_DRIVER_OK;
+
+    case ARM_SPI_MODE_MASTER:
+    case ARM_SPI_MODE_SLAVE:
+      return DRVSPI_Configure(pRes, control, arg);
+
+    case ARM_SPI_SET_BUS_SPEED:
+      if (hspi->Init.Mode != SPI_MODE_MASTER)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if (arg == 0U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      if (pRes->Busy != 0U)
+      {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      hspi->Init.BaudRatePrescaler = DRVSPI_GetPrescaler(hspi, arg);
+      return (HAL_SPI_Init(hspi) == HAL_OK) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+
+    case ARM_SPI_GET_BUS_SPEED:
+      br = (hspi->Init.BaudRatePrescaler & SPI_CR1_BR_Msk) >> SPI_CR1_BR_Pos;
+      return (int32_t)(DRVSPI_GetClock(hspi) >> (br + 1U));
+
+    case ARM_SPI_SET_DEFAULT_TX_VALUE:
+      pRes->TxDefault = arg;
+      return ARM_DRIVER_OK;
+
+    case ARM_SPI_CONTROL_SS:
+      if (pRes->SsMode == ARM_SPI_SS_MASTER_SW)
+      {
+        BSP_DRVSPI_SlaveSelectCallback(hspi, (arg == ARM_SPI_SS_ACTIVE) ? ARM_SPI_SS_ACTIVE : ARM_SPI_SS_INACTIVE);
+      }
+      else if (pRes->SsMode == ARM_SPI_SS_SLAVE_SW)
+      {
+        /* The slave is selected while the internal slave select is low */
+        if (arg == ARM_SPI_SS_ACTIVE)
+        {
+          CLEAR_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+        }
+        else
+        {
+          SET_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+        }
+      }
+      else
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_SPI_ABORT_TRANSFER:
+      if (pRes->Busy != 0U)
+      {
+        (void)HAL_SPI_Abort(hspi);
+        pRes->Count = pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount);
+        pRes->Busy  = 0U;
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Apply a master or slave mode control to the SPI.
+  * @param  pRes Driver state.
+  * @param  control ARM_SPI_MODE_MASTER or ARM_SPI_MODE_SLAVE with its mode parameters.
+  * @param  arg Bus speed of a master, bit/s.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY while a transfer runs
+  */
+static int32_t DRVSPI_Configure(DRVSPI_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg)
+{
+  SPI_HandleTypeDef *hspi = pRes->hspi;
+  SPI_InitTypeDef init = hspi->Init;
+  uint32_t ss_mode;
+
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  switch (control & ARM_SPI_FRAME_FORMAT_Msk)
+  {
+    case ARM_SPI_CPOL0_CPHA0:
+      init.CLKPolarity = SPI_POLARITY_LOW;
+      init.CLKPhase    = SPI_PHASE_1EDGE;
+      break;
+    case ARM_SPI_CPOL0_CPHA1:
+      init.CLKPolarity = SPI_POLARITY_LOW;
+      init.CLKPhase    = SPI_PHASE_2EDGE;
+      break;
+    case ARM_SPI_CPOL1_CPHA0:
+      init.CLKPolarity = SPI_POLARITY_HIGH;
+      init.CLKPhase    = SPI_PHASE_1EDGE;
+      break;
+    case ARM_SPI_CPOL1_CPHA1:
+      init.CLKPolarity = SPI_POLARITY_HIGH;
+      init.CLKPhase    = SPI_PHASE_2EDGE;
+      break;
+    default:
+      return ARM_SPI_ERROR_FRAME_FORMAT;
+  }
+
+  switch (control & ARM_SPI_DATA_BITS_Msk)
+  {
+    case ARM_SPI_DATA_BITS(8U):
+      init.DataSize = SPI_DATASIZE_8BIT;
+      break;
+    case ARM_SPI_DATA_BITS(16U):
+      init.DataSize = SPI_DATASIZE_16BIT;
+      break;
+    default:
+      return ARM_SPI_ERROR_DATA_BITS;
+  }
+
+  init.FirstBit = ((control & ARM_SPI_BIT_ORDER_Msk) == ARM_SPI_LSB_MSB) ? SPI_FIRSTBIT_LSB : SPI_FIRSTBIT_MSB;
+
+  if ((control & ARM_SPI_CONTROL_Msk) == ARM_SPI_MODE_MASTER)
+  {
+    if (arg == 0U)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    init.BaudRatePrescaler = DRVSPI_GetPrescaler(hspi, arg);
+    init.Mode = SPI_MODE_MASTER;
+    ss_mode   = control & ARM_SPI_SS_MASTER_MODE_Msk;
+    switch (ss_mode)
+    {
+      case ARM_SPI_SS_MASTER_HW_OUTPUT:
+        init.NSS = SPI_NSS_HARD_OUTPUT;
+        break;
+      case ARM_SPI_SS_MASTER_HW_INPUT:
+        init.NSS = SPI_NSS_HARD_INPUT;
+        break;
+      default:
+        init.NSS = SPI_NSS_SOFT;
+        break;
+    }
+  }
+  else
+  {
+    init.Mode = SPI_MODE_SLAVE;
+    ss_mode   = control & ARM_SPI_SS_SLAVE_MODE_Msk;
+    init.NSS  = (ss_mode == ARM_SPI_SS_SLAVE_SW) ? SPI_NSS_SOFT : SPI_NSS_HARD_INPUT;
+  }
+
+  /* From the ready state: the registers are written again, without HAL_SPI_MspInit() */
+  init.Direction = SPI_DIRECTION_2LINES;
+  hspi->Init     = init;
+  if (HAL_SPI_Init(hspi) != HAL_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (ss_mode == ARM_SPI_SS_SLAVE_SW)
+  {
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+  }
+
+  pRes->SsMode = ss_mode;
+  pRes->Flags |= DRVSPI_FLAG_ACTIVE;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the driver status.
+  * @param  pRes Driver state.
+  * @retval Status
+  */
+static ARM_SPI_STATUS DRVSPI_GetStatus(const DRVSPI_ResourcesTypeDef *pRes)
+{
+  ARM_SPI_STATUS status = {0U};
+  uint32_t errors = pRes->Errors;
+
+  status.busy       = (pRes->Busy != 0U) ? 1U : 0U;
+  status.data_lost  = ((errors & ARM_SPI_EVENT_DATA_LOST) != 0U) ? 1U : 0U;
+  status.mode_fault = ((errors & ARM_SPI_EVENT_MODE_FAULT) != 0U) ? 1U : 0U;
+
+  return status;
+}
+
+/**
+  * @brief  Get the kernel clock of a SPI.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval PCLK2 for SPI1, PCLK1 for the others, Hz
+  */
+static uint32_t DRVSPI_GetClock(const SPI_HandleTypeDef *hspi)
+{
+  return (hspi->Instance == SPI1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+}
+
+/**
+  * @brief  Get the prescaler of a master bus speed.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @param  BusSpeed Bus speed, bit/s, not 0.
+  * @retval Smallest prescaler giving at most BusSpeed, SPI_BAUDRATEPRESCALER_256
+  *         when even it is faster
+  */
+static uint32_t DRVSPI_GetPrescaler(const SPI_HandleTypeDef *hspi, uint32_t BusSpeed)
+{
+  uint32_t clock = DRVSPI_GetClock(hspi);
+  uint32_t br;
+
+  for (br = 0U; br < 7U; br++)
+  {
+    if ((clock >> (br + 1U)) <= BusSpeed)
+    {
+      break;
+    }
+  }
+
+  return br << SPI_CR1_BR_Pos;
+}
+
+/**
+  * @brief  Find the driver of a SPI handle.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval Driver state, NULL when the handle is not attached
+  */
+static DRVSPI_ResourcesTypeDef *DRVSPI_Find(const SPI_HandleTypeDef *hspi)
+{
+  uint32_t i;
+
+  for (i = 0U; i < BSP_DRVSPI_NUMBER; i++)
+  {
+    if ((DRVSPI_Resources[i].hspi == hspi) && ((DRVSPI_Resources[i].Flags & DRVSPI_FLAG_POWERED) != 0U))
+    {
+      return &DRVSPI_Resources[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  End the current transfer and signal its events.
+  * @param  pRes Driver state.
+  * @param  Events ARM_SPI_EVENT_xxx bits, 0 for none.
+  * @retval None
+  */
+static void DRVSPI_End(DRVSPI_ResourcesTypeDef *pRes, uint32_t Events)
+{
+  if (pRes->Busy == 0U)
+  {
+    return;
+  }
+
+  pRes->Count = pRes->Num - __HAL_DMA_GET_COUNTER(pRes->hdmacount);
+  pRes->Busy  = 0U;
+
+  if ((Events != 0U) && (pRes->cb_event != NULL))
+  {
+    pRes->cb_event(Events);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
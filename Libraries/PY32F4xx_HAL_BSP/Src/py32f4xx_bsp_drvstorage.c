@@ -0,0 +1,815 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvstorage.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver Storage BSP service.
+  *          This file provides the Driver_Storage.h interface over the flash
+  *          drivers of py32f4xx_bsp_drvflash.c:
+  *           + Driver_Storage0 on Driver_Flash0, internal flash region
+  *           + Driver_Storage1 on Driver_Flash1, ESMC flash
+  *           + Asynchronous ProgramData(), Erase() and EraseAll()
+  *           + One storage block, memory mapped for the internal flash
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Set up the flash driver under the storage as described in
+       py32f4xx_bsp_drvflash.c: BSP_DRVFLASH_Attach() for Driver_Storage0,
+       BSP_DRVFLASH_AttachESMC() for Driver_Storage1. The flash driver is
+       owned by the storage driver, Initialize() installing its event
+       callback.
+
+   (#) Initialize(), Uninitialize(), PowerControl(), ReadData() and the
+       information functions complete at once, returning 1 or the number of
+       bytes read. Driver_Storage0 reads the memory mapped flash directly,
+       ResolveAddress() giving its address.
+
+   (#) ProgramData(), Erase() and EraseAll() return ARM_DRIVER_OK once the
+       flash operation is started. The callback of Initialize() then gets the
+       bytes programmed or erased, ARM_DRIVER_OK for EraseAll(), or
+       ARM_DRIVER_ERROR, from the flash interrupt or tick:
+       (+) ProgramData() takes program_unit aligned ranges, whole pages for
+           Driver_Storage0 with a 32-bit aligned buffer.
+       (+) Erase() erases the sectors of an erase_unit aligned range one after
+           the other, each started from the end of the previous one.
+       (+) EraseAll() is the chip erase of Driver_Flash1, and an Erase() of
+           the whole region for Driver_Storage0.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_drvstorage.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVSTORAGE BSP DRVSTORAGE
+  * @brief CMSIS-Driver Storage BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_FLASH_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Private_Types BSP DRVSTORAGE Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of a storage
+  */
+typedef struct
+{
+  ARM_Storage_Callback_t  callback;     /*!< Completion callback of Initialize()                   */
+
+  uint32_t                Flags;        /*!< DRVSTORAGE_FLAG_INITIALIZED and DRVSTORAGE_FLAG_POWERED */
+
+  __IO uint32_t           Busy;         /*!< 1 from the start of an operation to its end           */
+
+  __IO uint32_t           Error;        /*!< 1 when the last operation failed                      */
+
+  ARM_STORAGE_OPERATION   Operation;    /*!< Operation running or last ended                       */
+
+  uint32_t                Address;      /*!< Sector erased                                         */
+
+  uint32_t                End;          /*!< End of the range erased                               */
+
+  uint32_t                Size;         /*!< Bytes of the operation, given to the callback         */
+
+} DRVSTORAGE_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Private_Constants BSP DRVSTORAGE Private Constants
+  * @{
+  */
+#define DRVSTORAGE_VERSION          ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+#define DRVSTORAGE_NUMBER           2U
+#else
+#define DRVSTORAGE_NUMBER           1U
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+#define DRVSTORAGE_INTERNAL         0U            /*!< Storage on the internal flash          */
+
+#define DRVSTORAGE_FLAG_INITIALIZED 0x01U
+#define DRVSTORAGE_FLAG_POWERED     0x02U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Private_Macros BSP DRVSTORAGE Private Macros
+  * @{
+  */
+
+/**
+  * @brief  Define the access functions and the access structure of a driver.
+  * @param  __N__ Storage number, 0 to DRVSTORAGE_NUMBER - 1.
+  */
+#define DRVSTORAGE_DRIVER(__N__)                                                                 \
+static void DRVSTORAGE##__N__##_FlashEvent(uint32_t event)                                       \
+{                                                                                                \
+  DRVSTORAGE_FlashEvent((__N__), event);                                                         \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_Initialize(ARM_Storage_Callback_t callback)                   \
+{                                                                                                \
+  return DRVSTORAGE_Initialize((__N__), callback, DRVSTORAGE##__N__##_FlashEvent);               \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_Uninitialize(void)                                            \
+{                                                                                                \
+  return DRVSTORAGE_Uninitialize(__N__);                                                         \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_PowerControl(ARM_POWER_STATE state)                           \
+{                                                                                                \
+  return DRVSTORAGE_PowerControl((__N__), state);                                                \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_ReadData(uint64_t addr, void *data, uint32_t size)            \
+{                                                                                                \
+  return DRVSTORAGE_ReadData((__N__), addr, data, size);                                         \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_ProgramData(uint64_t addr, const void *data, uint32_t size)   \
+{                                                                                                \
+  return DRVSTORAGE_ProgramData((__N__), addr, data, size);                                      \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_Erase(uint64_t addr, uint32_t size)                           \
+{                                                                                                \
+  return DRVSTORAGE_Erase((__N__), addr, size, ARM_STORAGE_OPERATION_ERASE);                     \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_EraseAll(void)                                                \
+{                                                                                                \
+  return DRVSTORAGE_EraseAll(__N__);                                                             \
+}                                                                                                \
+static ARM_STORAGE_STATUS DRVSTORAGE##__N__##_GetStatus(void)                                    \
+{                                                                                                \
+  return DRVSTORAGE_GetStatus(__N__);                                                            \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_GetInfo(ARM_STORAGE_INFO *info)                               \
+{                                                                                                \
+  return DRVSTORAGE_GetInfo((__N__), info);                                                      \
+}                                                                                                \
+static uint32_t DRVSTORAGE##__N__##_ResolveAddress(uint64_t addr)                                \
+{                                                                                                \
+  return DRVSTORAGE_ResolveAddress((__N__), addr);                                               \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_GetNextBlock(const ARM_STORAGE_BLOCK *prev,                   \
+                                                ARM_STORAGE_BLOCK *next)                         \
+{                                                                                                \
+  return DRVSTORAGE_GetNextBlock((__N__), prev, next);                                           \
+}                                                                                                \
+static int32_t DRVSTORAGE##__N__##_GetBlock(uint64_t addr, ARM_STORAGE_BLOCK *block)             \
+{                                                                                                \
+  return DRVSTORAGE_GetBlock((__N__), addr, block);                                              \
+}                                                                                                \
+ARM_DRIVER_STORAGE Driver_Storage##__N__ =                                                       \
+{                                                                                                \
+  DRVSTORAGE_GetVersion,                                                                         \
+  DRVSTORAGE_GetCapabilities,                                                                    \
+  DRVSTORAGE##__N__##_Initialize,                                                                \
+  DRVSTORAGE##__N__##_Uninitialize,                                                              \
+  DRVSTORAGE##__N__##_PowerControl,                                                              \
+  DRVSTORAGE##__N__##_ReadData,                                                                  \
+  DRVSTORAGE##__N__##_ProgramData,                                                               \
+  DRVSTORAGE##__N__##_Erase,                                                                     \
+  DRVSTORAGE##__N__##_EraseAll,                                                                  \
+  DRVSTORAGE##__N__##_GetStatus,                                                                 \
+  DRVSTORAGE##__N__##_GetInfo,                                                                   \
+  DRVSTORAGE##__N__##_ResolveAddress,                                                            \
+  DRVSTORAGE##__N__##_GetNextBlock,                                                              \
+  DRVSTORAGE##__N__##_GetBlock                                                                   \
+}
+
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Private_Variables BSP DRVSTORAGE Private Variables
+  * @{
+  */
+static ARM_DRIVER_FLASH * const DRVSTORAGE_Flash[DRVSTORAGE_NUMBER] =
+{
+  &Driver_Flash0,
+#ifdef HAL_ESMC_MODULE_ENABLED
+  &Driver_Flash1
+#endif /* HAL_ESMC_MODULE_ENABLED */
+};
+
+static DRVSTORAGE_ResourcesTypeDef DRVSTORAGE_Resources[DRVSTORAGE_NUMBER];
+
+static const ARM_STORAGE_CAPABILITIES DRVSTORAGE_Capabilities =
+{
+  1U,   /* asynchronous_ops */
+  1U,   /* erase_all        */
+  0U    /* reserved         */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVSTORAGE_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION       DRVSTORAGE_GetVersion(void);
+static ARM_STORAGE_CAPABILITIES DRVSTORAGE_GetCapabilities(void);
+static int32_t                  DRVSTORAGE_Initialize(uint32_t Instance, ARM_Storage_Callback_t callback,
+                                                      ARM_Flash_SignalEvent_t cb_flash);
+static int32_t                  DRVSTORAGE_Uninitialize(uint32_t Instance);
+static int32_t                  DRVSTORAGE_PowerControl(uint32_t Instance, ARM_POWER_STATE state);
+static int32_t                  DRVSTORAGE_ReadData(uint32_t Instance, uint64_t addr, void *data, uint32_t size);
+static int32_t                  DRVSTORAGE_ProgramData(uint32_t Instance, uint64_t addr, const void *data,
+                                                       uint32_t size);
+static int32_t                  DRVSTORAGE_Erase(uint32_t Instance, uint64_t addr, uint32_t size,
+                                                 ARM_STORAGE_OPERATION operation);
+static int32_t                  DRVSTORAGE_EraseAll(uint32_t Instance);
+static ARM_STORAGE_STATUS       DRVSTORAGE_GetStatus(uint32_t Instance);
+static int32_t                  DRVSTORAGE_GetInfo(uint32_t Instance, ARM_STORAGE_INFO *info);
+static uint32_t                 DRVSTORAGE_ResolveAddress(uint32_t Instance, uint64_t addr);
+static int32_t                  DRVSTORAGE_GetNextBlock(uint32_t Instance, const ARM_STORAGE_BLOCK *prev,
+                                                        ARM_STORAGE_BLOCK *next);
+static int32_t                  DRVSTORAGE_GetBlock(uint32_t Instance, uint64_t addr, ARM_STORAGE_BLOCK *block);
+static uint32_t                 DRVSTORAGE_GetTotal(uint32_t Instance);
+static uint32_t                 DRVSTORAGE_CheckRange(uint32_t Instance, uint64_t addr, uint32_t size,
+                                                      uint32_t unit);
+static void                     DRVSTORAGE_FillBlock(uint32_t Instance, ARM_STORAGE_BLOCK *block);
+static void                     DRVSTORAGE_FlashEvent(uint32_t Instance, uint32_t event);
+static void                     DRVSTORAGE_End(uint32_t Instance, int32_t Status);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVSTORAGE_Exported_Variables
+  * @{
+  */
+DRVSTORAGE_DRIVER(0);
+#ifdef HAL_ESMC_MODULE_ENABLED
+DRVSTORAGE_DRIVER(1);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVSTORAGE_Private_Functions BSP DRVSTORAGE Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVSTORAGE_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_STORAGE_API_VERSION, DRVSTORAGE_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities, the same for every storage
+  */
+static ARM_STORAGE_CAPABILITIES DRVSTORAGE_GetCapabilities(void)
+{
+  return DRVSTORAGE_Capabilities;
+}
+
+/**
+  * @brief  Initialize a storage and its flash driver.
+  * @param  Instance Storage number.
+  * @param  callback Completion callback, NULL for none.
+  * @param  cb_flash Event callback of the flash driver for this storage.
+  * @retval 1 once initialized, or execution status
+  */
+static int32_t DRVSTORAGE_Initialize(uint32_t Instance, ARM_Storage_Callback_t callback,
+                                     ARM_Flash_SignalEvent_t cb_flash)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  int32_t status;
+
+  if ((pRes->Flags & DRVSTORAGE_FLAG_INITIALIZED) != 0U)
+  {
+    return 1;
+  }
+
+  status = DRVSTORAGE_Flash[Instance]->Initialize(cb_flash);
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  pRes->callback = callback;
+  pRes->Flags    = DRVSTORAGE_FLAG_INITIALIZED;
+
+  return 1;
+}
+
+/**
+  * @brief  De-initialize a storage and its flash driver.
+  * @param  Instance Storage number.
+  * @retval 1 once de-initialized, or execution status
+  */
+static int32_t DRVSTORAGE_Uninitialize(uint32_t Instance)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  int32_t status;
+
+  status = DRVSTORAGE_Flash[Instance]->Uninitialize();
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  pRes->callback = NULL;
+  pRes->Flags    = 0U;
+
+  return 1;
+}
+
+/**
+  * @brief  Power a storage and its flash driver on or off.
+  * @param  Instance Storage number.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF.
+  * @retval 1 once done, or execution status
+  */
+static int32_t DRVSTORAGE_PowerControl(uint32_t Instance, ARM_POWER_STATE state)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  int32_t status;
+
+  if ((pRes->Flags & DRVSTORAGE_FLAG_INITIALIZED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  status = DRVSTORAGE_Flash[Instance]->PowerControl(state);
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+
+  if (state == ARM_POWER_FULL)
+  {
+    pRes->Error  = 0U;
+    pRes->Flags |= DRVSTORAGE_FLAG_POWERED;
+  }
+  else
+  {
+    pRes->Flags &= ~DRVSTORAGE_FLAG_POWERED;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Read a storage.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset.
+  * @param  data Bytes read.
+  * @param  size Number of bytes, a multiple of the data items of the flash
+  *         driver when not memory mapped.
+  * @retval Number of bytes read, or execution status
+  */
+static int32_t DRVSTORAGE_ReadData(uint32_t Instance, uint64_t addr, void *data, uint32_t size)
+{
+  const DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  ARM_DRIVER_FLASH *pFlash = DRVSTORAGE_Flash[Instance];
+  uint32_t width = pFlash->GetCapabilities().data_width;
+  int32_t status;
+
+  if ((data == NULL) || (size > (uint32_t)INT32_MAX) || (DRVSTORAGE_CheckRange(Instance, addr, size, 1U) == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVSTORAGE_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  if (Instance == DRVSTORAGE_INTERNAL)
+  {
+    (void)memcpy(data, (const void *)DRVSTORAGE_ResolveAddress(Instance, addr), size);
+    return (int32_t)size;
+  }
+
+  if ((size & ((1UL << width) - 1U)) != 0U)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  status = pFlash->ReadData((uint32_t)addr, data, size >> width);
+  if (status < 0)
+  {
+    return status;
+  }
+
+  return (int32_t)((uint32_t)status << width);
+}
+
+/**
+  * @brief  Start programming a storage.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset, program_unit aligned.
+  * @param  data Bytes to program, aligned on the data items of the flash
+  *         driver, valid until the callback.
+  * @param  size Number of bytes, a multiple of program_unit.
+  * @retval Execution status, ARM_DRIVER_OK once started
+  */
+static int32_t DRVSTORAGE_ProgramData(uint32_t Instance, uint64_t addr, const void *data, uint32_t size)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  ARM_DRIVER_FLASH *pFlash = DRVSTORAGE_Flash[Instance];
+  uint32_t width = pFlash->GetCapabilities().data_width;
+  int32_t status;
+
+  if ((data == NULL) || (size == 0U) || (size > (uint32_t)INT32_MAX) ||
+      (((uint32_t)data & ((1UL << width) - 1U)) != 0U) ||
+      (DRVSTORAGE_CheckRange(Instance, addr, size, pFlash->GetInfo()->program_unit) == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVSTORAGE_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Operation = ARM_STORAGE_OPERATION_PROGRAM_DATA;
+  pRes->Size      = size;
+  pRes->Error     = 0U;
+  pRes->Busy      = 1U;
+
+  status = pFlash->ProgramData((uint32_t)addr, data, size >> width);
+  if (status < 0)
+  {
+    pRes->Busy = 0U;
+    return status;
+  }
+  if (status > 0)
+  {
+    /* Programmed at once, no event */
+    pRes->Busy = 0U;
+    return (int32_t)size;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start erasing the sectors of a range.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset, erase_unit aligned.
+  * @param  size Number of bytes, a multiple of erase_unit.
+  * @param  operation ARM_STORAGE_OPERATION_ERASE or ARM_STORAGE_OPERATION_ERASE_ALL.
+  * @retval Execution status, ARM_DRIVER_OK once started
+  */
+static int32_t DRVSTORAGE_Erase(uint32_t Instance, uint64_t addr, uint32_t size, ARM_STORAGE_OPERATION operation)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  int32_t status;
+
+  if ((size == 0U) || (size > (uint32_t)INT32_MAX) ||
+      (DRVSTORAGE_CheckRange(Instance, addr, size, DRVSTORAGE_Flash[Instance]->GetInfo()->sector_size) == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVSTORAGE_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->Operation = operation;
+  pRes->Address   = (uint32_t)addr;
+  pRes->End       = (uint32_t)addr + size;
+  pRes->Size      = size;
+  pRes->Error     = 0U;
+  pRes->Busy      = 1U;
+
+  status = DRVSTORAGE_Flash[Instance]->EraseSector(pRes->Address);
+  if (status != ARM_DRIVER_OK)
+  {
+    pRes->Busy = 0U;
+    return status;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start erasing a whole storage.
+  * @param  Instance Storage number.
+  * @retval Execution status, ARM_DRIVER_OK once started
+  */
+static int32_t DRVSTORAGE_EraseAll(uint32_t Instance)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+  ARM_DRIVER_FLASH *pFlash = DRVSTORAGE_Flash[Instance];
+  int32_t status;
+
+  if (pFlash->GetCapabilities().erase_chip == 0U)
+  {
+    return DRVSTORAGE_Erase(Instance, 0U, DRVSTORAGE_GetTotal(Instance), ARM_STORAGE_OPERATION_ERASE_ALL);
+  }
+
+  if ((pRes->Flags & DRVSTORAGE_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if (pRes->Busy != 0U)
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  /* No sector left after the chip erase */
+  pRes->Operation = ARM_STORAGE_OPERATION_ERASE_ALL;
+  pRes->Address   = 0U;
+  pRes->End       = 0U;
+  pRes->Error     = 0U;
+  pRes->Busy      = 1U;
+
+  status = pFlash->EraseChip();
+  if (status != ARM_DRIVER_OK)
+  {
+    pRes->Busy = 0U;
+    return status;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the status of a storage.
+  * @param  Instance Storage number.
+  * @retval Storage status
+  */
+static ARM_STORAGE_STATUS DRVSTORAGE_GetStatus(uint32_t Instance)
+{
+  ARM_STORAGE_STATUS status = {0};
+
+  status.busy  = DRVSTORAGE_Resources[Instance].Busy;
+  status.error = DRVSTORAGE_Resources[Instance].Error;
+
+  return status;
+}
+
+/**
+  * @brief  Get the information of a storage.
+  * @param  Instance Storage number.
+  * @param  info Information filled.
+  * @retval Execution status
+  */
+static int32_t DRVSTORAGE_GetInfo(uint32_t Instance, ARM_STORAGE_INFO *info)
+{
+  ARM_FLASH_INFO *pInfo = DRVSTORAGE_Flash[Instance]->GetInfo();
+
+  if (info == NULL)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  (void)memset(info, 0, sizeof(ARM_STORAGE_INFO));
+  info->total_storage           = DRVSTORAGE_GetTotal(Instance);
+  info->program_unit            = pInfo->program_unit;
+  info->optimal_program_unit    = pInfo->page_size;
+  info->program_cycles          = ARM_STORAGE_PROGRAM_CYCLES_INFINITE;
+  info->erased_value            = (pInfo->erased_value == 0xFFU) ? 1U : 0U;
+  info->memory_mapped           = (Instance == DRVSTORAGE_INTERNAL) ? 1U : 0U;
+  info->programmability         = ARM_STORAGE_PROGRAMMABILITY_ERASABLE;
+  info->retention_level         = ARM_RETENTION_NVM;
+  info->security.internal_flash = (Instance == DRVSTORAGE_INTERNAL) ? 1U : 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the processor address of a storage offset.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset.
+  * @retval Address, ARM_STORAGE_INVALID_ADDRESS when not memory mapped
+  */
+static uint32_t DRVSTORAGE_ResolveAddress(uint32_t Instance, uint64_t addr)
+{
+  if ((Instance != DRVSTORAGE_INTERNAL) || (addr >= DRVSTORAGE_GetTotal(Instance)))
+  {
+    return ARM_STORAGE_INVALID_ADDRESS;
+  }
+
+  return BSP_DRVFLASH_GetAddress() + (uint32_t)addr;
+}
+
+/**
+  * @brief  Iterate over the storage blocks, a single one.
+  * @param  Instance Storage number.
+  * @param  prev Previous block, NULL for the first one.
+  * @param  next Block filled, may be NULL.
+  * @retval ARM_DRIVER_OK for the first block, ARM_DRIVER_ERROR after it
+  */
+static int32_t DRVSTORAGE_GetNextBlock(uint32_t Instance, const ARM_STORAGE_BLOCK *prev, ARM_STORAGE_BLOCK *next)
+{
+  if ((prev != NULL) || (DRVSTORAGE_GetTotal(Instance) == 0U))
+  {
+    if (next != NULL)
+    {
+      next->addr = ARM_STORAGE_INVALID_OFFSET;
+      next->size = 0U;
+    }
+    return ARM_DRIVER_ERROR;
+  }
+
+  if (next != NULL)
+  {
+    DRVSTORAGE_FillBlock(Instance, next);
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the storage block of an offset.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset.
+  * @param  block Block filled, may be NULL.
+  * @retval ARM_DRIVER_OK when the offset is in the storage, ARM_DRIVER_ERROR otherwise
+  */
+static int32_t DRVSTORAGE_GetBlock(uint32_t Instance, uint64_t addr, ARM_STORAGE_BLOCK *block)
+{
+  if (addr >= DRVSTORAGE_GetTotal(Instance))
+  {
+    if (block != NULL)
+    {
+      block->addr = ARM_STORAGE_INVALID_OFFSET;
+      block->size = 0U;
+    }
+    return ARM_DRIVER_ERROR;
+  }
+
+  if (block != NULL)
+  {
+    DRVSTORAGE_FillBlock(Instance, block);
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the size of a storage.
+  * @param  Instance Storage number.
+  * @retval Bytes, 0 while the flash driver has nothing attached
+  */
+static uint32_t DRVSTORAGE_GetTotal(uint32_t Instance)
+{
+  ARM_FLASH_INFO *pInfo = DRVSTORAGE_Flash[Instance]->GetInfo();
+
+  return pInfo->sector_count * pInfo->sector_size;
+}
+
+/**
+  * @brief  Check that a range is in a storage and aligned.
+  * @param  Instance Storage number.
+  * @param  addr Storage offset.
+  * @param  size Number of bytes.
+  * @param  unit Alignment of the offset and of the size, 1 for none.
+  * @retval 1 when valid, 0 otherwise
+  */
+static uint32_t DRVSTORAGE_CheckRange(uint32_t Instance, uint64_t addr, uint32_t size, uint32_t unit)
+{
+  uint32_t total = DRVSTORAGE_GetTotal(Instance);
+
+  if ((addr >= total) || (size > (total - (uint32_t)addr)))
+  {
+    return 0U;
+  }
+  if ((unit > 1U) && ((((uint32_t)addr % unit) != 0U) || ((size % unit) != 0U)))
+  {
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Fill the single block of a storage.
+  * @param  Instance Storage number.
+  * @param  block Block filled.
+  * @retval None
+  */
+static void DRVSTORAGE_FillBlock(uint32_t Instance, ARM_STORAGE_BLOCK *block)
+{
+  (void)memset(block, 0, sizeof(ARM_STORAGE_BLOCK));
+  block->addr                    = 0U;
+  block->size                    = DRVSTORAGE_GetTotal(Instance);
+  block->attributes.erasable     = 1U;
+  block->attributes.programmable = 1U;
+  block->attributes.executable   = (Instance == DRVSTORAGE_INTERNAL) ? 1U : 0U;
+  block->attributes.erase_unit   = DRVSTORAGE_Flash[Instance]->GetInfo()->sector_size;
+}
+
+/**
+  * @brief  Flash driver event of a storage.
+  * @note   Starts the erase of the next sector of an Erase().
+  * @param  Instance Storage number.
+  * @param  event ARM_FLASH_EVENT_READY, with ARM_FLASH_EVENT_ERROR on a failure.
+  * @retval None
+  */
+static void DRVSTORAGE_FlashEvent(uint32_t Instance, uint32_t event)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+
+  if (pRes->Busy == 0U)
+  {
+    return;
+  }
+
+  if ((event & ARM_FLASH_EVENT_ERROR) != 0U)
+  {
+    DRVSTORAGE_End(Instance, ARM_DRIVER_ERROR);
+    return;
+  }
+
+  if (pRes->Operation != ARM_STORAGE_OPERATION_PROGRAM_DATA)
+  {
+    pRes->Address += DRVSTORAGE_Flash[Instance]->GetInfo()->sector_size;
+    if (pRes->Address < pRes->End)
+    {
+      if (DRVSTORAGE_Flash[Instance]->EraseSector(pRes->Address) != ARM_DRIVER_OK)
+      {
+        DRVSTORAGE_End(Instance, ARM_DRIVER_ERROR);
+      }
+      return;
+    }
+  }
+
+  DRVSTORAGE_End(Instance, (pRes->Operation == ARM_STORAGE_OPERATION_ERASE_ALL) ? ARM_DRIVER_OK : (int32_t)pRes->Size);
+}
+
+/**
+  * @brief  End the operation of a storage and call the callback.
+  * @param  Instance Storage number.
+  * @param  Status Bytes done, ARM_DRIVER_OK or ARM_DRIVER_ERROR.
+  * @retval None
+  */
+static void DRVSTORAGE_End(uint32_t Instance, int32_t Status)
+{
+  DRVSTORAGE_ResourcesTypeDef *pRes = &DRVSTORAGE_Resources[Instance];
+
+  if (Status < ARM_DRIVER_OK)
+  {
+    pRes->Error = 1U;
+  }
+  pRes->Busy = 0U;
+
+  if (pRes->callback != NULL)
+  {
+    pRes->callback(Status, pRes->Operation);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
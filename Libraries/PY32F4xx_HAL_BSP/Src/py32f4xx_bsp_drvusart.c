@@ -0,0 +1,967 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvusart.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver USART BSP service.
+  *          This file provides the Driver_USART.h interface of USART1 to
+  *          USART5 over the UART HAL:
+  *           + Asynchronous mode with flow control
+  *           + Non-blocking Send() and Receive() on the DMA
+  *           + Events signalled from the UART and DMA interrupts
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Fill the Instance and the Init structure of a UART handle, Init being
+       the configuration until the first ARM_USART_MODE_ASYNCHRONOUS control.
+       HAL_UART_MspInit() configures the pins, links a DMA channel in
+       DMA_NORMAL mode to hdmatx and one to hdmarx with __HAL_LINKDMA(), byte
+       aligned, half-word aligned for 9 data bits without parity, and enables
+       the UART and both DMA channel interrupts in the NVIC.
+
+   (#) Call BSP_DRVUSART_Attach() with the handle. Driver_USARTn of the UART
+       instance then owns it, HAL_UART_Init() and HAL_UART_MspInit() are run
+       by its PowerControl(ARM_POWER_FULL) and HAL_UART_DeInit() by
+       PowerControl(ARM_POWER_OFF).
+
+   (#) The interrupt handlers stay the ones of the HAL: HAL_UART_IRQHandler()
+       in USARTx_IRQHandler() and HAL_DMA_IRQHandler() in the handlers of both
+       DMA channels. When USE_HAL_UART_REGISTER_CALLBACKS is 0 call
+       BSP_DRVUSART_TxCpltCallback(), BSP_DRVUSART_RxCpltCallback() and
+       BSP_DRVUSART_ErrorCallback() from the HAL callbacks of the same names,
+       other UARTs are ignored. Otherwise they are registered at power up.
+
+   (#) Send() and Receive() return once the DMA is started, the end is
+       signalled to the cb_event of Initialize():
+       (+) ARM_USART_EVENT_SEND_COMPLETE | ARM_USART_EVENT_TX_COMPLETE when
+           the last stop bit is out.
+       (+) ARM_USART_EVENT_RECEIVE_COMPLETE when num items are received.
+       (+) ARM_USART_EVENT_RX_OVERFLOW, ARM_USART_EVENT_RX_FRAMING_ERROR or
+           ARM_USART_EVENT_RX_PARITY_ERROR on a receive error, the reception
+           is then stopped by the HAL and GetRxCount() holds its progress.
+       A transfer is at most 65535 items, the size of the DMA counter.
+
+   (#) Transfer(), the synchronous, single wire, IrDA and smart card modes
+       and the modem lines are not supported.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_drvusart.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVUSART BSP DRVUSART
+  * @brief CMSIS-Driver USART BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_UART_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Private_Types BSP DRVUSART Private Types
+  * @{
+  */
+
+/**
+  * @brief  Driver state of a USART
+  */
+typedef struct
+{
+  UART_HandleTypeDef      *huart;       /*!< Attached UART, NULL when none                         */
+
+  ARM_USART_SignalEvent_t cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVUSART_FLAG_INITIALIZED and DRVUSART_FLAG_POWERED   */
+
+  uint32_t                TxNum;        /*!< Items of the current or last Send()                   */
+
+  __IO uint32_t           TxCount;      /*!< Items sent by the last Send(), once ended             */
+
+  uint32_t                RxNum;        /*!< Items of the current or last Receive()                */
+
+  __IO uint32_t           RxCount;      /*!< Items received by the last Receive(), once ended      */
+
+  __IO uint32_t           TxBusy;       /*!< 1 from Send() to its end                              */
+
+  __IO uint32_t           RxBusy;       /*!< 1 from Receive() to its end                           */
+
+  __IO uint32_t           RxErrors;     /*!< Receive error events since the start of Receive()     */
+
+} DRVUSART_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Private_Constants BSP DRVUSART Private Constants
+  * @{
+  */
+#define DRVUSART_VERSION          ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+#define DRVUSART_MAX_XFER_SIZE    0xFFFFU     /*!< Largest DMA transfer, CNDTR is 16-bit */
+
+#define DRVUSART_FLAG_INITIALIZED 0x01U
+#define DRVUSART_FLAG_POWERED     0x02U
+
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Private_Macros BSP DRVUSART Private Macros
+  * @{
+  */
+
+/**
+  * @brief  Define the access functions and the access structure of a driver.
+  * @param  __N__ USART number, 1 to BSP_DRVUSART_NUMBER.
+  */
+#define DRVUSART_DRIVER(__N__)                                                                   \
+static int32_t DRVUSART##__N__##_Initialize(ARM_USART_SignalEvent_t cb_event)                    \
+{                                                                                                \
+  return DRVUSART_Initialize(&DRVUSART_Resources[(__N__) - 1U], cb_event);                       \
+}                                                                                                \
+static int32_t DRVUSART##__N__##_Uninitialize(void)                                              \
+{                                                                                                \
+  return DRVUSART_Uninitialize(&DRVUSART_Resources[(__N__) - 1U]);                               \
+}                                                                                                \
+static int32_t DRVUSART##__N__##_PowerControl(ARM_POWER_STATE state)                             \
+{                                                                                                \
+  return DRVUSART_PowerControl(&DRVUSART_Resources[(__N__) - 1U], state);                        \
+}                                                                                                \
+static int32_t DRVUSART##__N__##_Send(const void *data, uint32_t num)                            \
+{                                                                                                \
+  return DRVUSART_Send(&DRVUSART_Resources[(__N__) - 1U], data, num);                            \
+}                                                                                                \
+static int32_t DRVUSART##__N__##_Receive(void *data, uint32_t num)                               \
+{                                                                                                \
+  return DRVUSART_Receive(&DRVUSART_Resources[(__N__) - 1U], data, num);                         \
+}                                                                                                \
+static uint32_t DRVUSART##__N__##_GetTxCount(void)                                               \
+{                                                                                                \
+  return DRVUSART_GetTxCount(&DRVUSART_Resources[(__N__) - 1U]);                                 \
+}                                                                                                \
+static uint32_t DRVUSART##__N__##_GetRxCount(void)                                               \
+{                                                                                                \
+  return DRVUSART_GetRxCount(&DRVUSART_Resources[(__N__) - 1U]);                                 \
+}                                                                                                \
+static int32_t DRVUSART##__N__##_Control(uint32_t control, uint32_t arg)                         \
+{                                                                                                \
+  return DRVUSART_Control(&DRVUSART_Resources[(__N__) - 1U], control, arg);                      \
+}                                                                                                \
+static ARM_USART_STATUS DRVUSART##__N__##_GetStatus(void)                                        \
+{                                                                                                \
+  return DRVUSART_GetStatus(&DRVUSART_Resources[(__N__) - 1U]);                                  \
+}                                                                                                \
+ARM_DRIVER_USART Driver_USART##__N__ =                                                           \
+{                                                                                                \
+  DRVUSART_GetVersion,                                                                           \
+  DRVUSART_GetCapabilities,                                                                      \
+  DRVUSART##__N__##_Initialize,                                                                  \
+  DRVUSART##__N__##_Uninitialize,                                                                \
+  DRVUSART##__N__##_PowerControl,                                                                \
+  DRVUSART##__N__##_Send,                                                                        \
+  DRVUSART##__N__##_Receive,                                                                     \
+  DRVUSART_Transfer,                                                                             \
+  DRVUSART##__N__##_GetTxCount,                                                                  \
+  DRVUSART##__N__##_GetRxCount,                                                                  \
+  DRVUSART##__N__##_Control,                                                                     \
+  DRVUSART##__N__##_GetStatus,                                                                   \
+  DRVUSART_SetModemControl,                                                                      \
+  DRVUSART_GetModemStatus                                                                        \
+}
+
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Private_Variables BSP DRVUSART Private Variables
+  * @{
+  */
+static USART_TypeDef * const DRVUSART_Instances[BSP_DRVUSART_NUMBER] =
+{
+  USART1, USART2, USART3, USART4, USART5
+};
+
+static DRVUSART_ResourcesTypeDef DRVUSART_Resources[BSP_DRVUSART_NUMBER];
+
+static const ARM_USART_CAPABILITIES DRVUSART_Capabilities =
+{
+  1U,   /* asynchronous       */
+  0U,   /* synchronous_master */
+  0U,   /* synchronous_slave  */
+  0U,   /* single_wire        */
+  0U,   /* irda               */
+  0U,   /* smart_card         */
+  0U,   /* smart_card_clock   */
+  1U,   /* flow_control_rts   */
+  1U,   /* flow_control_cts   */
+  1U,   /* event_tx_complete  */
+  0U,   /* event_rx_timeout   */
+  0U,   /* rts                */
+  0U,   /* cts                */
+  0U,   /* dtr                */
+  0U,   /* dsr                */
+  0U,   /* dcd                */
+  0U,   /* ri                 */
+  0U,   /* event_cts          */
+  0U,   /* event_dsr          */
+  0U,   /* event_dcd          */
+  0U,   /* event_ri           */
+  0U    /* reserved           */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVUSART_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION     DRVUSART_GetVersion(void);
+static ARM_USART_CAPABILITIES DRVUSART_GetCapabilities(void);
+static int32_t                DRVUSART_Initialize(DRVUSART_ResourcesTypeDef *pRes, ARM_USART_SignalEvent_t cb_event);
+static int32_t                DRVUSART_Uninitialize(DRVUSART_ResourcesTypeDef *pRes);
+static int32_t                DRVUSART_PowerControl(DRVUSART_ResourcesTypeDef *pRes, ARM_POWER_STATE state);
+static int32_t                DRVUSART_Send(DRVUSART_ResourcesTypeDef *pRes, const void *data, uint32_t num);
+static int32_t                DRVUSART_Receive(DRVUSART_ResourcesTypeDef *pRes, void *data, uint32_t num);
+static int32_t                DRVUSART_Transfer(const void *data_out, void *data_in, uint32_t num);
+static uint32_t               DRVUSART_GetTxCount(const DRVUSART_ResourcesTypeDef *pRes);
+static uint32_t               DRVUSART_GetRxCount(const DRVUSART_ResourcesTypeDef *pRes);
+static int32_t                DRVUSART_Control(DRVUSART_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg);
+static int32_t                DRVUSART_Configure(DRVUSART_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg);
+static ARM_USART_STATUS       DRVUSART_GetStatus(const DRVUSART_ResourcesTypeDef *pRes);
+static int32_t                DRVUSART_SetModemControl(ARM_USART_MODEM_CONTROL control);
+static ARM_USART_MODEM_STATUS DRVUSART_GetModemStatus(void);
+static DRVUSART_ResourcesTypeDef *DRVUSART_Find(const UART_HandleTypeDef *huart);
+static void                   DRVUSART_Signal(const DRVUSART_ResourcesTypeDef *pRes, uint32_t Events);
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVUSART_Exported_Variables
+  * @{
+  */
+DRVUSART_DRIVER(1);
+DRVUSART_DRIVER(2);
+DRVUSART_DRIVER(3);
+DRVUSART_DRIVER(4);
+DRVUSART_DRIVER(5);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Exported_Functions BSP DRVUSART Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVUSART_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides a function allowing to:
+      (+) Give a UART handle to the driver of its instance
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach a UART handle to the driver of its instance.
+  * @note   The handle is not initialized here, PowerControl(ARM_POWER_FULL)
+  *         does it with the Init structure given.
+  * @param  huart Pointer to a UART_HandleTypeDef structure, Instance and Init filled.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVUSART_Attach(UART_HandleTypeDef *huart)
+{
+  uint32_t i;
+
+  if (huart == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < BSP_DRVUSART_NUMBER; i++)
+  {
+    if (huart->Instance == DRVUSART_Instances[i])
+    {
+      if ((DRVUSART_Resources[i].Flags & DRVUSART_FLAG_POWERED) != 0U)
+      {
+        return HAL_BUSY;
+      }
+
+      DRVUSART_Resources[i].huart = huart;
+
+      return HAL_OK;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DRVUSART_Exported_Functions_Group2 Callback functions
+  * @brief    Callback functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Callback functions #####
+ ===============================================================================
+    [..]
+    This section provides the handlers to call from the UART HAL callbacks
+    when USE_HAL_UART_REGISTER_CALLBACKS is 0.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  UART transmit complete handler of the drivers.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVUSART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  DRVUSART_ResourcesTypeDef *pRes = DRVUSART_Find(huart);
+
+  if ((pRes == NULL) || (pRes->TxBusy == 0U))
+  {
+    return;
+  }
+
+  pRes->TxCount = pRes->TxNum;
+  pRes->TxBusy  = 0U;
+
+  DRVUSART_Signal(pRes, ARM_USART_EVENT_SEND_COMPLETE | ARM_USART_EVENT_TX_COMPLETE);
+}
+
+/**
+  * @brief  UART receive complete handler of the drivers.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVUSART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  DRVUSART_ResourcesTypeDef *pRes = DRVUSART_Find(huart);
+
+  if ((pRes == NULL) || (pRes->RxBusy == 0U))
+  {
+    return;
+  }
+
+  pRes->RxCount = pRes->RxNum;
+  pRes->RxBusy  = 0U;
+
+  DRVUSART_Signal(pRes, ARM_USART_EVENT_RECEIVE_COMPLETE);
+}
+
+/**
+  * @brief  UART error handler of the drivers.
+  * @note   A receive error stops the DMA reception, a DMA transmit error the
+  *         transmission: the transfer stopped ends with its counter where it is.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_DRVUSART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  DRVUSART_ResourcesTypeDef *pRes = DRVUSART_Find(huart);
+  uint32_t events = 0U;
+
+  if (pRes == NULL)
+  {
+    return;
+  }
+
+  if ((huart->ErrorCode & HAL_UART_ERROR_ORE) != 0U)
+  {
+    events |= ARM_USART_EVENT_RX_OVERFLOW;
+  }
+  if ((huart->ErrorCode & HAL_UART_ERROR_FE) != 0U)
+  {
+    events |= ARM_USART_EVENT_RX_FRAMING_ERROR;
+  }
+  if ((huart->ErrorCode & HAL_UART_ERROR_PE) != 0U)
+  {
+    events |= ARM_USART_EVENT_RX_PARITY_ERROR;
+  }
+  pRes->RxErrors |= events;
+
+  if ((pRes->RxBusy != 0U) && (huart->RxState == HAL_UART_STATE_READY))
+  {
+    pRes->RxCount = pRes->RxNum - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+    pRes->RxBusy  = 0U;
+  }
+
+  if ((pRes->TxBusy != 0U) && (huart->gState == HAL_UART_STATE_READY))
+  {
+    pRes->TxCount = pRes->TxNum - __HAL_DMA_GET_COUNTER(huart->hdmatx);
+    pRes->TxBusy  = 0U;
+  }
+
+  if (events != 0U)
+  {
+    DRVUSART_Signal(pRes, events);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup BSP_DRVUSART_Private_Functions BSP DRVUSART Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the driver version.
+  * @retval Driver version
+  */
+static ARM_DRIVER_VERSION DRVUSART_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = {ARM_USART_API_VERSION, DRVUSART_VERSION};
+
+  return version;
+}
+
+/**
+  * @brief  Get the driver capabilities.
+  * @retval Capabilities, the same for every USART
+  */
+static ARM_USART_CAPABILITIES DRVUSART_GetCapabilities(void)
+{
+  return DRVUSART_Capabilities;
+}
+
+/**
+  * @brief  Initialize a driver.
+  * @param  pRes Driver state.
+  * @param  cb_event Event callback, NULL for none.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached UART
+  */
+static int32_t DRVUSART_Initialize(DRVUSART_ResourcesTypeDef *pRes, ARM_USART_SignalEvent_t cb_event)
+{
+  if (pRes->huart == NULL)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((pRes->Flags & DRVUSART_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  pRes->cb_event = cb_event;
+  pRes->Flags    = DRVUSART_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  De-initialize a driver, powering it off first.
+  * @param  pRes Driver state.
+  * @retval Execution status
+  */
+static int32_t DRVUSART_Uninitialize(DRVUSART_ResourcesTypeDef *pRes)
+{
+  (void)DRVUSART_PowerControl(pRes, ARM_POWER_OFF);
+
+  pRes->cb_event = NULL;
+  pRes->Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Power a driver on or off.
+  * @param  pRes Driver state.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF, ARM_POWER_LOW not supported.
+  * @retval Execution status
+  */
+static int32_t DRVUSART_PowerControl(DRVUSART_ResourcesTypeDef *pRes, ARM_POWER_STATE state)
+{
+  UART_HandleTypeDef *huart = pRes->huart;
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if ((pRes->Flags & DRVUSART_FLAG_POWERED) != 0U)
+      {
+        (void)HAL_UART_Abort(huart);
+        (void)HAL_UART_DeInit(huart);
+      }
+      pRes->TxBusy   = 0U;
+      pRes->RxBusy   = 0U;
+      pRes->RxErrors = 0U;
+      pRes->Flags   &= ~DRVUSART_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((pRes->Flags & DRVUSART_FLAG_INITIALIZED) == 0U)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((pRes->Flags & DRVUSART_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+
+      if (HAL_UART_Init(huart) != HAL_OK)
+      {
+        return ARM_DRIVER_ERROR;
+      }
+      if ((huart->hdmatx == NULL) || (huart->hdmarx == NULL))
+      {
+        (void)HAL_UART_DeInit(huart);
+        return ARM_DRIVER_ERROR;
+      }
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+      /* After HAL_UART_Init(), which set the callbacks to their default from the reset state */
+      if ((HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID, BSP_DRVUSART_TxCpltCallback) != HAL_OK) ||
+          (HAL_UART_RegisterCallback(huart, HAL_UART_RX_COMPLETE_CB_ID, BSP_DRVUSART_RxCpltCallback) != HAL_OK) ||
+          (HAL_UART_RegisterCallback(huart, HAL_UART_ERROR_CB_ID, BSP_DRVUSART_ErrorCallback) != HAL_OK))
+      {
+        (void)HAL_UART_DeInit(huart);
+        return ARM_DRIVER_ERROR;
+      }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+      pRes->TxCount  = 0U;
+      pRes->RxCount  = 0U;
+      pRes->RxErrors = 0U;
+      pRes->Flags   |= DRVUSART_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Start sending on the Tx DMA.
+  * @param  pRes Driver state.
+  * @param  data Items to send, 16-bit for 9 data bits without parity.
+  * @param  num Number of items, 1 to 65535.
+  * @retval Execution status
+  */
+static int32_t DRVUSART_Send(DRVUSART_ResourcesTypeDef *pRes, const void *data, uint32_t num)
+{
+  if ((data == NULL) || (num == 0U) || (num > DRVUSART_MAX_XFER_SIZE))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVUSART_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->TxBusy != 0U) || (pRes->huart->gState != HAL_UART_STATE_READY))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->TxNum   = num;
+  pRes->TxCount = 0U;
+  pRes->TxBusy  = 1U;
+
+  if (HAL_UART_Transmit_DMA(pRes->huart, (uint8_t *)(uint32_t)data, (uint16_t)num) != HAL_OK)
+  {
+    pRes->TxBusy = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start receiving on the Rx DMA.
+  * @param  pRes Driver state.
+  * @param  data Items received, 16-bit for 9 data bits without parity.
+  * @param  num Number of items, 1 to 65535.
+  * @retval Execution status
+  */
+static int32_t DRVUSART_Receive(DRVUSART_ResourcesTypeDef *pRes, void *data, uint32_t num)
+{
+  if ((data == NULL) || (num == 0U) || (num > DRVUSART_MAX_XFER_SIZE))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((pRes->Flags & DRVUSART_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((pRes->RxBusy != 0U) || (pRes->huart->RxState != HAL_UART_STATE_READY))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  pRes->RxNum    = num;
+  pRes->RxCount  = 0U;
+  pRes->RxErrors = 0U;
+  pRes->RxBusy   = 1U;
+
+  if (HAL_UART_Receive_DMA(pRes->huart, (uint8_t *)data, (uint16_t)num) != HAL_OK)
+  {
+    pRes->RxBusy = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Transfer, synchronous modes only.
+  * @param  data_out Not used.
+  * @param  data_in Not used.
+  * @param  num Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVUSART_Transfer(const void *data_out, void *data_in, uint32_t num)
+{
+  UNUSED(data_out);
+  UNUSED(data_in);
+  UNUSED(num);
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Get the number of items sent by the current or last Send().
+  * @param  pRes Driver state.
+  * @retval Items sent
+  */
+static uint32_t DRVUSART_GetTxCount(const DRVUSART_ResourcesTypeDef *pRes)
+{
+  if (pRes->TxBusy != 0U)
+  {
+    return pRes->TxNum - __HAL_DMA_GET_COUNTER(pRes->huart->hdmatx);
+  }
+
+  return pRes->TxCount;
+}
+
+/**
+  * @brief  Get the number of items received by the current or last Receive().
+  * @param  pRes Driver state.
+  * @retval Items received
+  */
+static uint32_t DRVUSART_GetRxCount(const DRVUSART_ResourcesTypeDef *pRes)
+{
+  if (pRes->RxBusy != 0U)
+  {
+    return pRes->RxNum - __HAL_DMA_GET_COUNTER(pRes->huart->hdmarx);
+  }
+
+  return pRes->RxCount;
+}
+
+/**
+  * @brief  Control a driver.
+  * @param  pRes Driver state.
+  * @param  control Operation.
+  * @param  arg Argument of the operation.
+  * @retval Execution status
+  */
+static int32_t DRVUSART_Control(DRVUSART_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg)
+{
+  UART_HandleTypeDef *huart = pRes->huart;
+
+  if ((pRes->Flags & DRVUSART_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (control & ARM_USART_CONTROL_Msk)
+  {
+    case ARM_USART_MODE_ASYNCHRONOUS:
+      return DRVUSART_Configure(pRes, control, arg);
+
+    case ARM_USART_MODE_SYNCHRONOUS_MASTER:
+    case ARM_USART_MODE_SYNCHRONOUS_SLAVE:
+    case ARM_USART_MODE_SINGLE_WIRE:
+    case ARM_USART_MODE_IRDA:
+    case ARM_USART_MODE_SMART_CARD:
+      return ARM_USART_ERROR_MODE;
+
+    case ARM_USART_CONTROL_TX:
+      if (arg != 0U)
+      {
+        huart->Init.Mode |= UART_MODE_TX;
+        SET_BIT(huart->Instance->CR1, USART_CR1_TE);
+      }
+      else
+      {
+        huart->Init.Mode &= ~UART_MODE_TX;
+        CLEAR_BIT(huart->Instance->CR1, USART_CR1_TE);
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_CONTROL_RX:
+      if (arg != 0U)
+      {
+        huart->Init.Mode |= UART_MODE_RX;
+        SET_BIT(huart->Instance->CR1, USART_CR1_RE);
+      }
+      else
+      {
+        huart->Init.Mode &= ~UART_MODE_RX;
+        CLEAR_BIT(huart->Instance->CR1, USART_CR1_RE);
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_ABORT_SEND:
+      if (pRes->TxBusy != 0U)
+      {
+        (void)HAL_UART_AbortTransmit(huart);
+        pRes->TxCount = pRes->TxNum - __HAL_DMA_GET_COUNTER(huart->hdmatx);
+        pRes->TxBusy  = 0U;
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_ABORT_RECEIVE:
+      if (pRes->RxBusy != 0U)
+      {
+        (void)HAL_UART_AbortReceive(huart);
+        pRes->RxCount = pRes->RxNum - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+        pRes->RxBusy  = 0U;
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Apply an asynchronous mode control to the UART.
+  * @note   7 data bits are only available with a parity, the UART counting
+  *         the parity bit in its word length.
+  * @param  pRes Driver state.
+  * @param  control ARM_USART_MODE_ASYNCHRONOUS with its mode parameters.
+  * @param  arg Baudrate, bit/s.
+  * @retval Execution status, ARM_DRIVER_ERROR_BUSY while a transfer runs
+  */
+static int32_t DRVUSART_Configure(DRVUSART_ResourcesTypeDef *pRes, uint32_t control, uint32_t arg)
+{
+  UART_HandleTypeDef *huart = pRes->huart;
+  UART_InitTypeDef init = huart->Init;
+  uint32_t data_bits = control & ARM_USART_DATA_BITS_Msk;
+
+  if ((pRes->TxBusy != 0U) || (pRes->RxBusy != 0U))
+  {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+  if (arg == 0U)
+  {
+    return ARM_USART_ERROR_BAUDRATE;
+  }
+  init.BaudRate = arg;
+
+  switch (control & ARM_USART_PARITY_Msk)
+  {
+    case ARM_USART_PARITY_NONE:
+      init.Parity = UART_PARITY_NONE;
+      if (data_bits == ARM_USART_DATA_BITS_8)
+      {
+        init.WordLength = UART_WORDLENGTH_8B;
+      }
+      else if (data_bits == ARM_USART_DATA_BITS_9)
+      {
+        init.WordLength = UART_WORDLENGTH_9B;
+      }
+      else
+      {
+        return ARM_USART_ERROR_DATA_BITS;
+      }
+      break;
+
+    case ARM_USART_PARITY_EVEN:
+    case ARM_USART_PARITY_ODD:
+      init.Parity = ((control & ARM_USART_PARITY_Msk) == ARM_USART_PARITY_EVEN) ? UART_PARITY_EVEN : UART_PARITY_ODD;
+      if (data_bits == ARM_USART_DATA_BITS_7)
+      {
+        init.WordLength = UART_WORDLENGTH_8B;
+      }
+      else if (data_bits == ARM_USART_DATA_BITS_8)
+      {
+        init.WordLength = UART_WORDLENGTH_9B;
+      }
+      else
+      {
+        return ARM_USART_ERROR_DATA_BITS;
+      }
+      break;
+
+    default:
+      return ARM_USART_ERROR_PARITY;
+  }
+
+  switch (control & ARM_USART_STOP_BITS_Msk)
+  {
+    case ARM_USART_STOP_BITS_1:
+      init.StopBits = UART_STOPBITS_1;
+      break;
+    case ARM_USART_STOP_BITS_2:
+      init.StopBits = UART_STOPBITS_2;
+      break;
+    case ARM_USART_STOP_BITS_1_5:
+      init.StopBits = UART_STOPBITS_1_5;
+      break;
+    default:
+      init.StopBits = UART_STOPBITS_0_5;
+      break;
+  }
+
+  switch (control & ARM_USART_FLOW_CONTROL_Msk)
+  {
+    case ARM_USART_FLOW_CONTROL_NONE:
+      init.HwFlowCtl = UART_HWCONTROL_NONE;
+      break;
+    case ARM_USART_FLOW_CONTROL_RTS:
+      init.HwFlowCtl = UART_HWCONTROL_RTS;
+      break;
+    case ARM_USART_FLOW_CONTROL_CTS:
+      init.HwFlowCtl = UART_HWCONTROL_CTS;
+      break;
+    default:
+      init.HwFlowCtl = UART_HWCONTROL_RTS_CTS;
+      break;
+  }
+
+  /* From the ready state: the registers are written again, without HAL_UART_MspInit() */
+  huart->Init = init;
+  if (HAL_UART_Init(huart) != HAL_OK)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Get the driver status.
+  * @param  pRes Driver state.
+  * @retval Status
+  */
+static ARM_USART_STATUS DRVUSART_GetStatus(const DRVUSART_ResourcesTypeDef *pRes)
+{
+  ARM_USART_STATUS status = {0U};
+  uint32_t errors = pRes->RxErrors;
+
+  status.tx_busy          = (pRes->TxBusy != 0U) ? 1U : 0U;
+  status.rx_busy          = (pRes->RxBusy != 0U) ? 1U : 0U;
+  status.rx_overflow      = ((errors & ARM_USART_EVENT_RX_OVERFLOW) != 0U) ? 1U : 0U;
+  status.rx_framing_error = ((errors & ARM_USART_EVENT_RX_FRAMING_ERROR) != 0U) ? 1U : 0U;
+  status.rx_parity_error  = ((errors & ARM_USART_EVENT_RX_PARITY_ERROR) != 0U) ? 1U : 0U;
+
+  return status;
+}
+
+/**
+  * @brief  Set a modem line, none available.
+  * @param  control Not used.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVUSART_SetModemControl(ARM_USART_MODEM_CONTROL control)
+{
+  UNUSED(control);
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Get the modem lines, none available.
+  * @retval Modem status, all inactive
+  */
+static ARM_USART_MODEM_STATUS DRVUSART_GetModemStatus(void)
+{
+  ARM_USART_MODEM_STATUS status = {0U};
+
+  return status;
+}
+
+/**
+  * @brief  Find the driver of a UART handle.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval Driver state, NULL when the handle is not attached
+  */
+static DRVUSART_ResourcesTypeDef *DRVUSART_Find(const UART_HandleTypeDef *huart)
+{
+  uint32_t i;
+
+  for (i = 0U; i < BSP_DRVUSART_NUMBER; i++)
+  {
+    if ((DRVUSART_Resources[i].huart == huart) && ((DRVUSART_Resources[i].Flags & DRVUSART_FLAG_POWERED) != 0U))
+    {
+      return &DRVUSART_Resources[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Signal events to the callback of a driver.
+  * @param  pRes Driver state.
+  * @param  Events ARM_USART_EVENT_xxx bits.
+  * @retval None
+  */
+static void DRVUSART_Signal(const DRVUSART_ResourcesTypeDef *pRes, uint32_t Events)
+{
+  if (pRes->cb_event != NULL)
+  {
+    pRes->cb_event(Events);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
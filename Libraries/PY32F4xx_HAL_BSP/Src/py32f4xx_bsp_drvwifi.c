@@ -0,0 +1,2250 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_drvwifi.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-Driver WiFi BSP service.
+  *          This file provides the Driver_WiFi.h interface of an Espressif
+  *          module running the ESP-AT firmware, v2.0 or later:
+  *           + Driver_WiFi0 on the BSP_ATCMD engine and a BSP_SERIAL port
+  *           + Station: connect, disconnect, scan, network and IP options
+  *           + TCP client sockets on the 5 links of the module, received
+  *             data held by the module until read (passive mode) and copied
+  *             from the DMA receive ring straight into the buffer of
+  *             SocketRecv()
+  *           + Host name resolution and ping
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_CMSIS_DRIVER=y, defining USE_BSP_CMSIS_DRIVER
+       and adding the Driver_*.h headers of Libraries/CMSIS/Driver/Include.
+
+   (#) Open the UART of the module with BSP_SERIAL_Open(), 115200 bauds by
+       default for ESP-AT. A receive ring of 512 bytes or more is advised,
+       with RTS flow control from BSP_SERIAL_SetFlowControl() at higher
+       rates. Call BSP_DRVWIFI_Attach() with the port and the optional
+       EN or RST pin of the module, a push-pull output high, GPIO port NULL
+       when it is not wired.
+
+   (#) PowerControl(ARM_POWER_FULL) resets the module, by the pin or by
+       AT+RST, waits for its "ready", then sends ATE0, AT+CWMODE=1,
+       AT+CIPMUX=1 and AT+CIPRECVMODE=1 in one pipelined batch.
+       PowerControl(ARM_POWER_OFF) holds the pin low.
+
+   (#) Station (interface 0):
+       (+) Activate() joins the access point of the configuration with
+           AT+CWJAP, the security is negotiated by the module, WPS is not
+           supported. Deactivate() leaves it.
+       (+) IsConnected() returns 1 from "WIFI GOT IP" to "WIFI DISCONNECT".
+       (+) SetOption() and GetOption() support ARM_WIFI_MAC, ARM_WIFI_IP,
+           ARM_WIFI_IP_SUBNET_MASK, ARM_WIFI_IP_GATEWAY, ARM_WIFI_IP_DNS1,
+           ARM_WIFI_IP_DNS2 and ARM_WIFI_IP_DHCP. A static address is set
+           with the mask and gateway set before it.
+       (+) The access point interface, the bypass mode and IPv6 are not
+           supported.
+
+   (#) Sockets:
+       (+) SocketCreate() takes a free link for an ARM_SOCKET_SOCK_STREAM
+           socket, SocketConnect() opens it with AT+CIPSTART. Datagram and
+           listening sockets are not supported.
+       (+) The module keeps the received data and reports its amount with
+           "+IPD,<link>,<length>". SocketRecv() asks for at most the size of
+           the buffer with AT+CIPRECVDATA; the tokenizer takes the
+           "+CIPRECVDATA:<length>," header and copies the payload from the
+           UART receive ring into the buffer of the caller, without
+           intermediate buffer. The module flow controls the peer meanwhile.
+       (+) SocketSend() sends up to BSP_DRVWIFI_DATA_MAX bytes per AT+CIPSEND,
+           the payload written from the buffer of the caller after the '>'
+           prompt.
+       (+) ARM_SOCKET_IO_FIONBIO, ARM_SOCKET_SO_RCVTIMEO and
+           ARM_SOCKET_SO_SNDTIMEO are supported, a timeout of 0 waits
+           forever.
+
+   (#) Each function waits for its AT commands, sleeping in BSP_SERIAL_Poll()
+       meanwhile, and must be called from the thread context, one caller at
+       a time. The URCs received in between are handled by the next call.
+       BSP_DRVWIFI_GetStats() returns the counters of the AT engine.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_drvwifi.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DRVWIFI BSP DRVWIFI
+  * @brief CMSIS-Driver WiFi BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_CMSIS_DRIVER) && defined (HAL_UART_MODULE_ENABLED)
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Private_Constants BSP DRVWIFI Private Constants
+  * @{
+  */
+#define DRVWIFI_VERSION           ARM_DRIVER_VERSION_MAJOR_MINOR(1U, 0U)
+
+#define DRVWIFI_FLAG_INITIALIZED  0x01U
+#define DRVWIFI_FLAG_POWERED      0x02U
+
+#define DRVWIFI_COMMAND_SIZE      160U       /*!< Longest command line, CWJAP with escaped SSID and key */
+
+#define DRVWIFI_TIMEOUT           1000U      /*!< ms for a local command              */
+#define DRVWIFI_READY_TIMEOUT     5000U      /*!< ms from the reset to "ready"        */
+#define DRVWIFI_RESET_PULSE       10U        /*!< ms of the reset pulse               */
+#define DRVWIFI_JOIN_TIMEOUT      20000U     /*!< ms for AT+CWJAP                     */
+#define DRVWIFI_SCAN_TIMEOUT      15000U     /*!< ms for AT+CWLAP                     */
+#define DRVWIFI_CONNECT_TIMEOUT   15000U     /*!< ms for AT+CIPSTART                  */
+#define DRVWIFI_DNS_TIMEOUT       10000U     /*!< ms for AT+CIPDOMAIN                 */
+#define DRVWIFI_PING_TIMEOUT      6000U      /*!< ms for AT+PING                      */
+#define DRVWIFI_SEND_TIMEOUT      10000U     /*!< ms for AT+CIPSEND without SO_SNDTIMEO */
+
+#define DRVWIFI_SETUP_COUNT       4U         /*!< Commands sent after the reset       */
+
+/* Socket states */
+#define DRVWIFI_SOCKET_FREE       0U
+#define DRVWIFI_SOCKET_CREATED    1U
+#define DRVWIFI_SOCKET_CONNECTED  2U
+#define DRVWIFI_SOCKET_CLOSED     3U         /*!< Closed by the peer or the module    */
+/**
+  * @}
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Private_Types BSP DRVWIFI Private Types
+  * @{
+  */
+
+/**
+  * @brief  Socket state, one per link of the module
+  */
+typedef struct
+{
+  uint32_t                State;        /*!< DRVWIFI_SOCKET_FREE to DRVWIFI_SOCKET_CLOSED          */
+
+  uint32_t                NonBlocking;  /*!< ARM_SOCKET_IO_FIONBIO                                 */
+
+  uint32_t                RecvTimeout;  /*!< ARM_SOCKET_SO_RCVTIMEO in ms, 0 waits forever        */
+
+  uint32_t                SendTimeout;  /*!< ARM_SOCKET_SO_SNDTIMEO in ms, 0 waits forever        */
+
+  uint8_t                 RemoteIp[4];  /*!< Peer address of SocketConnect()                       */
+
+  uint16_t                RemotePort;   /*!< Peer port of SocketConnect()                          */
+
+  __IO uint32_t           Available;    /*!< Bytes held by the module, last "+IPD"                 */
+
+} DRVWIFI_SocketTypeDef;
+
+/**
+  * @brief  Driver state of the ESP-AT module
+  */
+typedef struct
+{
+  ARM_WIFI_SignalEvent_t  cb_event;     /*!< Event callback of Initialize()                        */
+
+  uint32_t                Flags;        /*!< DRVWIFI_FLAG_INITIALIZED and DRVWIFI_FLAG_POWERED     */
+
+  uint32_t                Attached;     /*!< 1 after BSP_DRVWIFI_Attach()                          */
+
+  uint32_t                Port;         /*!< Serial port of the module                             */
+
+  GPIO_TypeDef            *ResetPort;   /*!< EN or RST port, NULL when not wired                   */
+
+  uint16_t                ResetPin;     /*!< EN or RST pin                                         */
+
+  __IO uint32_t           Ready;        /*!< 1 once "ready" is received after a reset              */
+
+  __IO uint32_t           Connected;    /*!< 1 from "WIFI GOT IP" to "WIFI DISCONNECT"             */
+
+  BSP_ATCMD_TypeDef       At;           /*!< AT command engine                                     */
+
+  BSP_ATCMD_CmdTypeDef    Cmd;          /*!< Command of the function in progress                   */
+
+  BSP_ATCMD_CmdTypeDef    Setup[DRVWIFI_SETUP_COUNT]; /*!< Commands pipelined after the reset      */
+
+  char                    Command[DRVWIFI_COMMAND_SIZE]; /*!< Command line being built             */
+
+  uint32_t                CommandLength; /*!< Characters in Command, DRVWIFI_COMMAND_SIZE on overflow */
+
+  char                    Reply[BSP_ATCMD_LINE_SIZE]; /*!< Response line captured, prefix removed  */
+
+  uint32_t                Replied;      /*!< 1 when Reply holds a line                             */
+
+  uint32_t                RecvMax;      /*!< Size of the buffer of the AT+CIPRECVDATA in progress  */
+
+  uint32_t                RecvCount;    /*!< Bytes of its "+CIPRECVDATA:" header                   */
+
+  ARM_WIFI_SCAN_INFO_t    *pScan;       /*!< Scan results                                          */
+
+  uint32_t                ScanMax;      /*!< Size of the scan array                                */
+
+  uint32_t                ScanCount;    /*!< Access points stored                                  */
+
+  uint8_t                 Security;     /*!< Security of the last Activate()                       */
+
+  char                    Pass[65];     /*!< Key of the last Activate()                            */
+
+  uint8_t                 StaticIp[4];  /*!< Address of ARM_WIFI_IP                                */
+
+  uint8_t                 StaticMask[4]; /*!< Mask of ARM_WIFI_IP_SUBNET_MASK                      */
+
+  uint8_t                 StaticGateway[4]; /*!< Gateway of ARM_WIFI_IP_GATEWAY                    */
+
+  uint8_t                 Dns[2][4];    /*!< Servers of ARM_WIFI_IP_DNS1 and ARM_WIFI_IP_DNS2      */
+
+  DRVWIFI_SocketTypeDef   Sockets[BSP_DRVWIFI_SOCKETS]; /*!< Sockets, the index is the link         */
+
+} DRVWIFI_ResourcesTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Private_Variables BSP DRVWIFI Private Variables
+  * @{
+  */
+static DRVWIFI_ResourcesTypeDef DRVWIFI_Resources;
+
+static const char * const aDrvwifiSetup[DRVWIFI_SETUP_COUNT] =
+{
+  "ATE0", "AT+CWMODE=1", "AT+CIPMUX=1", "AT+CIPRECVMODE=1"
+};
+
+static const ARM_WIFI_CAPABILITIES DRVWIFI_Capabilities =
+{
+  1U,                     /* station             */
+  0U,                     /* ap                  */
+  0U,                     /* station_ap          */
+  0U,                     /* wps_station         */
+  0U,                     /* wps_ap              */
+  0U,                     /* event_ap_connect    */
+  0U,                     /* event_ap_disconnect */
+  0U,                     /* event_eth_rx_frame  */
+  0U,                     /* bypass_mode         */
+  1U,                     /* ip                  */
+  0U,                     /* ip6                 */
+  1U,                     /* ping                */
+  0U                      /* reserved            */
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_DRVWIFI_Private_Functions
+  * @{
+  */
+static ARM_DRIVER_VERSION    DRVWIFI_GetVersion(void);
+static ARM_WIFI_CAPABILITIES DRVWIFI_GetCapabilities(void);
+static int32_t               DRVWIFI_Initialize(ARM_WIFI_SignalEvent_t cb_event);
+static int32_t               DRVWIFI_Uninitialize(void);
+static int32_t               DRVWIFI_PowerControl(ARM_POWER_STATE state);
+static int32_t               DRVWIFI_GetModuleInfo(char *module_info, uint32_t max_len);
+static int32_t               DRVWIFI_SetOption(uint32_t interface, uint32_t option, const void *data, uint32_t len);
+static int32_t               DRVWIFI_GetOption(uint32_t interface, uint32_t option, void *data, uint32_t *len);
+static int32_t               DRVWIFI_Scan(ARM_WIFI_SCAN_INFO_t scan_info[], uint32_t max_num);
+static int32_t               DRVWIFI_Activate(uint32_t interface, const ARM_WIFI_CONFIG_t *config);
+static int32_t               DRVWIFI_Deactivate(uint32_t interface);
+static uint32_t              DRVWIFI_IsConnected(void);
+static int32_t               DRVWIFI_GetNetInfo(ARM_WIFI_NET_INFO_t *net_info);
+static int32_t               DRVWIFI_BypassControl(uint32_t interface, uint32_t mode);
+static int32_t               DRVWIFI_EthSendFrame(uint32_t interface, const uint8_t *frame, uint32_t len);
+static int32_t               DRVWIFI_EthReadFrame(uint32_t interface, uint8_t *frame, uint32_t len);
+static uint32_t              DRVWIFI_EthGetRxFrameSize(uint32_t interface);
+static int32_t               DRVWIFI_SocketCreate(int32_t af, int32_t type, int32_t protocol);
+static int32_t               DRVWIFI_SocketBind(int32_t socket, const uint8_t *ip, uint32_t ip_len, uint16_t port);
+static int32_t               DRVWIFI_SocketListen(int32_t socket, int32_t backlog);
+static int32_t               DRVWIFI_SocketAccept(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port);
+static int32_t               DRVWIFI_SocketConnect(int32_t socket, const uint8_t *ip, uint32_t ip_len, uint16_t port);
+static int32_t               DRVWIFI_SocketRecv(int32_t socket, void *buf, uint32_t len);
+static int32_t               DRVWIFI_SocketRecvFrom(int32_t socket, void *buf, uint32_t len, uint8_t *ip,
+                                                    uint32_t *ip_len, uint16_t *port);
+static int32_t               DRVWIFI_SocketSend(int32_t socket, const void *buf, uint32_t len);
+static int32_t               DRVWIFI_SocketSendTo(int32_t socket, const void *buf, uint32_t len, const uint8_t *ip,
+                                                  uint32_t ip_len, uint16_t port);
+static int32_t               DRVWIFI_SocketGetSockName(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port);
+static int32_t               DRVWIFI_SocketGetPeerName(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port);
+static int32_t               DRVWIFI_SocketGetOpt(int32_t socket, int32_t opt_id, void *opt_val, uint32_t *opt_len);
+static int32_t               DRVWIFI_SocketSetOpt(int32_t socket, int32_t opt_id, const void *opt_val, uint32_t opt_len);
+static int32_t               DRVWIFI_SocketClose(int32_t socket);
+static int32_t               DRVWIFI_SocketGetHostByName(const char *name, int32_t af, uint8_t *ip, uint32_t *ip_len);
+static int32_t               DRVWIFI_Ping(const uint8_t *ip, uint32_t ip_len);
+static uint32_t              DRVWIFI_UrcIpd(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length);
+static uint32_t              DRVWIFI_UrcRecvData(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length);
+static uint32_t              DRVWIFI_UrcWifi(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length);
+static uint32_t              DRVWIFI_UrcReady(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length);
+static uint32_t              DRVWIFI_UrcLink(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length);
+static void                  DRVWIFI_LineCapture(BSP_ATCMD_CmdTypeDef *pCmd, const char *pLine, uint32_t Length);
+static void                  DRVWIFI_LineScan(BSP_ATCMD_CmdTypeDef *pCmd, const char *pLine, uint32_t Length);
+static uint32_t              DRVWIFI_Execute(uint32_t Timeout, const uint8_t *pData, uint32_t Length,
+                                             const char *pCapture);
+static void                  DRVWIFI_Wait(const BSP_ATCMD_CmdTypeDef *pCmd);
+static int32_t               DRVWIFI_DriverStatus(uint32_t Status);
+static int32_t               DRVWIFI_Reset(void);
+static void                  DRVWIFI_Begin(const char *pText);
+static void                  DRVWIFI_Append(const char *pText);
+static void                  DRVWIFI_AppendUint(uint32_t Value);
+static void                  DRVWIFI_AppendIp(const uint8_t *pIp);
+static void                  DRVWIFI_AppendString(const char *pText);
+static uint32_t              DRVWIFI_ParseUint(const char **ppText);
+static uint32_t              DRVWIFI_ParseIp(const char *pText, uint8_t *pIp);
+static uint32_t              DRVWIFI_ParseMac(const char *pText, uint8_t *pMac);
+static void                  DRVWIFI_ParseString(const char **ppText, char *pOut, uint32_t Size);
+static DRVWIFI_SocketTypeDef *DRVWIFI_GetSocket(int32_t socket);
+/**
+  * @}
+  */
+
+/* URCs of ESP-AT, the link events last: their empty prefix sees every line */
+static const BSP_ATCMD_UrcTypeDef aDrvwifiUrc[] =
+{
+  { "+CIPRECVDATA:", ',',  DRVWIFI_UrcRecvData },
+  { "+IPD,",         '\0', DRVWIFI_UrcIpd      },
+  { "WIFI ",         '\0', DRVWIFI_UrcWifi     },
+  { "ready",         '\0', DRVWIFI_UrcReady    },
+  { "",              '\0', DRVWIFI_UrcLink     },
+};
+
+/* Exported variables --------------------------------------------------------*/
+/** @addtogroup BSP_DRVWIFI_Exported_Variables
+  * @{
+  */
+ARM_DRIVER_WIFI Driver_WiFi0 =
+{
+  DRVWIFI_GetVersion,
+  DRVWIFI_GetCapabilities,
+  DRVWIFI_Initialize,
+  DRVWIFI_Uninitialize,
+  DRVWIFI_PowerControl,
+  DRVWIFI_GetModuleInfo,
+  DRVWIFI_SetOption,
+  DRVWIFI_GetOption,
+  DRVWIFI_Scan,
+  DRVWIFI_Activate,
+  DRVWIFI_Deactivate,
+  DRVWIFI_IsConnected,
+  DRVWIFI_GetNetInfo,
+  DRVWIFI_BypassControl,
+  DRVWIFI_EthSendFrame,
+  DRVWIFI_EthReadFrame,
+  DRVWIFI_EthGetRxFrameSize,
+  DRVWIFI_SocketCreate,
+  DRVWIFI_SocketBind,
+  DRVWIFI_SocketListen,
+  DRVWIFI_SocketAccept,
+  DRVWIFI_SocketConnect,
+  DRVWIFI_SocketRecv,
+  DRVWIFI_SocketRecvFrom,
+  DRVWIFI_SocketSend,
+  DRVWIFI_SocketSendTo,
+  DRVWIFI_SocketGetSockName,
+  DRVWIFI_SocketGetPeerName,
+  DRVWIFI_SocketGetOpt,
+  DRVWIFI_SocketSetOpt,
+  DRVWIFI_SocketClose,
+  DRVWIFI_SocketGetHostByName,
+  DRVWIFI_Ping
+};
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DRVWIFI_Exported_Functions BSP DRVWIFI Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DRVWIFI_Exported_Functions_Group1 Binding functions
+  * @brief    Binding functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Binding functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Give an ESP-AT module on a serial port to Driver_WiFi0
+      (+) Read the counters of its AT engine
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Attach an ESP-AT module to Driver_WiFi0.
+  * @param  Port A value of @ref BSP_SERIAL_Port, opened by BSP_SERIAL_Open().
+  * @param  ResetPort EN or RST port, NULL when not wired.
+  * @param  ResetPin EN or RST pin, a value of @ref GPIO_pins.
+  * @retval HAL status, HAL_BUSY while the driver is powered
+  */
+HAL_StatusTypeDef BSP_DRVWIFI_Attach(uint32_t Port, GPIO_TypeDef *ResetPort, uint16_t ResetPin)
+{
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) != 0U)
+  {
+    return HAL_BUSY;
+  }
+  if (BSP_ATCMD_Init(&DRVWIFI_Resources.At, Port, aDrvwifiUrc, sizeof(aDrvwifiUrc) / sizeof(aDrvwifiUrc[0]),
+                     &DRVWIFI_Resources) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  DRVWIFI_Resources.Port      = Port;
+  DRVWIFI_Resources.ResetPort = ResetPort;
+  DRVWIFI_Resources.ResetPin  = ResetPin;
+  DRVWIFI_Resources.Attached  = 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the counters of the AT engine of Driver_WiFi0.
+  * @param  pStats Returns the counters.
+  * @retval None
+  */
+void BSP_DRVWIFI_GetStats(BSP_ATCMD_StatsTypeDef *pStats)
+{
+  BSP_ATCMD_GetStats(&DRVWIFI_Resources.At, pStats);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DRVWIFI_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the driver version.
+  * @retval ARM_DRIVER_VERSION
+  */
+static ARM_DRIVER_VERSION DRVWIFI_GetVersion(void)
+{
+  ARM_DRIVER_VERSION version = { ARM_WIFI_API_VERSION, DRVWIFI_VERSION };
+
+  return version;
+}
+
+/**
+  * @brief  Return the driver capabilities.
+  * @retval ARM_WIFI_CAPABILITIES
+  */
+static ARM_WIFI_CAPABILITIES DRVWIFI_GetCapabilities(void)
+{
+  return DRVWIFI_Capabilities;
+}
+
+/**
+  * @brief  Initialize Driver_WiFi0.
+  * @param  cb_event Event callback, NULL for none. No event is signaled by
+  *         the station alone.
+  * @retval Execution status, ARM_DRIVER_ERROR without an attached module
+  */
+static int32_t DRVWIFI_Initialize(ARM_WIFI_SignalEvent_t cb_event)
+{
+  if (DRVWIFI_Resources.Attached == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_INITIALIZED) != 0U)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  DRVWIFI_Resources.cb_event = cb_event;
+  DRVWIFI_Resources.Flags    = DRVWIFI_FLAG_INITIALIZED;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Uninitialize Driver_WiFi0.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_Uninitialize(void)
+{
+  (void)DRVWIFI_PowerControl(ARM_POWER_OFF);
+
+  DRVWIFI_Resources.cb_event = NULL;
+  DRVWIFI_Resources.Flags    = 0U;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Control the power of the module.
+  * @param  state ARM_POWER_FULL or ARM_POWER_OFF.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_PowerControl(ARM_POWER_STATE state)
+{
+  int32_t status;
+  uint32_t index;
+
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_INITIALIZED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (state)
+  {
+    case ARM_POWER_OFF:
+      if (DRVWIFI_Resources.ResetPort != NULL)
+      {
+        HAL_GPIO_WritePin(DRVWIFI_Resources.ResetPort, DRVWIFI_Resources.ResetPin, GPIO_PIN_RESET);
+      }
+      BSP_ATCMD_Flush(&DRVWIFI_Resources.At);
+      memset(DRVWIFI_Resources.Sockets, 0, sizeof(DRVWIFI_Resources.Sockets));
+      DRVWIFI_Resources.Connected = 0U;
+      DRVWIFI_Resources.Flags    &= ~DRVWIFI_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_FULL:
+      if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) != 0U)
+      {
+        return ARM_DRIVER_OK;
+      }
+      memset(DRVWIFI_Resources.Sockets, 0, sizeof(DRVWIFI_Resources.Sockets));
+      DRVWIFI_Resources.Connected = 0U;
+
+      status = DRVWIFI_Reset();
+      if (status != ARM_DRIVER_OK)
+      {
+        return status;
+      }
+
+      /* The setup commands follow each other without waiting in between */
+      for (index = 0U; index < DRVWIFI_SETUP_COUNT; index++)
+      {
+        memset(&DRVWIFI_Resources.Setup[index], 0, sizeof(BSP_ATCMD_CmdTypeDef));
+        DRVWIFI_Resources.Setup[index].pCommand = aDrvwifiSetup[index];
+        DRVWIFI_Resources.Setup[index].Timeout  = DRVWIFI_TIMEOUT;
+        (void)BSP_ATCMD_Submit(&DRVWIFI_Resources.At, &DRVWIFI_Resources.Setup[index]);
+      }
+      DRVWIFI_Wait(&DRVWIFI_Resources.Setup[DRVWIFI_SETUP_COUNT - 1U]);
+      for (index = 0U; index < DRVWIFI_SETUP_COUNT; index++)
+      {
+        status = DRVWIFI_DriverStatus(DRVWIFI_Resources.Setup[index].Status);
+        if (status != ARM_DRIVER_OK)
+        {
+          return status;
+        }
+      }
+
+      DRVWIFI_Resources.Flags |= DRVWIFI_FLAG_POWERED;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_LOW:
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+/**
+  * @brief  Return the firmware version of the module.
+  * @param  module_info Returns the "AT version:" line of AT+GMR.
+  * @param  max_len Size of module_info.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_GetModuleInfo(char *module_info, uint32_t max_len)
+{
+  int32_t status;
+  uint32_t length;
+
+  if ((module_info == NULL) || (max_len == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  DRVWIFI_Begin("AT+GMR");
+  status = DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, "AT version:"));
+  if ((status == ARM_DRIVER_OK) && (DRVWIFI_Resources.Replied == 0U))
+  {
+    status = ARM_DRIVER_ERROR;
+  }
+  if (status == ARM_DRIVER_OK)
+  {
+    length = strlen(DRVWIFI_Resources.Reply);
+    if (length >= max_len)
+    {
+      length = max_len - 1U;
+    }
+    memcpy(module_info, DRVWIFI_Resources.Reply, length);
+    module_info[length] = '\0';
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Set an option of the station.
+  * @param  interface 0, the station.
+  * @param  option ARM_WIFI_MAC, ARM_WIFI_IP, ARM_WIFI_IP_SUBNET_MASK, ARM_WIFI_IP_GATEWAY,
+  *         ARM_WIFI_IP_DNS1, ARM_WIFI_IP_DNS2 or ARM_WIFI_IP_DHCP.
+  * @param  data Value of the option.
+  * @param  len Size of the value.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_SetOption(uint32_t interface, uint32_t option, const void *data, uint32_t len)
+{
+  const uint8_t *pValue = (const uint8_t *)data;
+  static const char aHex[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+  char mac[18];
+  uint32_t index;
+
+  if (interface != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if (data == NULL)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (option)
+  {
+    case ARM_WIFI_MAC:
+      if (len != 6U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      for (index = 0U; index < 6U; index++)
+      {
+        mac[index * 3U]       = aHex[pValue[index] >> 4];
+        mac[(index * 3U) + 1U] = aHex[pValue[index] & 0x0FU];
+        mac[(index * 3U) + 2U] = ':';
+      }
+      mac[17] = '\0';
+      DRVWIFI_Begin("AT+CIPSTAMAC=");
+      DRVWIFI_AppendString(mac);
+      break;
+
+    case ARM_WIFI_IP:
+    case ARM_WIFI_IP_SUBNET_MASK:
+    case ARM_WIFI_IP_GATEWAY:
+      if (len != 4U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      if (option == ARM_WIFI_IP_SUBNET_MASK)
+      {
+        memcpy(DRVWIFI_Resources.StaticMask, pValue, 4U);
+        return ARM_DRIVER_OK;
+      }
+      if (option == ARM_WIFI_IP_GATEWAY)
+      {
+        memcpy(DRVWIFI_Resources.StaticGateway, pValue, 4U);
+        return ARM_DRIVER_OK;
+      }
+      /* The address is set with the mask and gateway set before it */
+      memcpy(DRVWIFI_Resources.StaticIp, pValue, 4U);
+      DRVWIFI_Begin("AT+CIPSTA=");
+      DRVWIFI_AppendIp(DRVWIFI_Resources.StaticIp);
+      DRVWIFI_Append(",");
+      DRVWIFI_AppendIp(DRVWIFI_Resources.StaticGateway);
+      DRVWIFI_Append(",");
+      DRVWIFI_AppendIp(DRVWIFI_Resources.StaticMask);
+      break;
+
+    case ARM_WIFI_IP_DNS1:
+    case ARM_WIFI_IP_DNS2:
+      if (len != 4U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      memcpy(DRVWIFI_Resources.Dns[option - ARM_WIFI_IP_DNS1], pValue, 4U);
+      DRVWIFI_Begin("AT+CIPDNS=1,");
+      DRVWIFI_AppendIp(DRVWIFI_Resources.Dns[0]);
+      if (DRVWIFI_Resources.Dns[1][0] != 0U)
+      {
+        DRVWIFI_Append(",");
+        DRVWIFI_AppendIp(DRVWIFI_Resources.Dns[1]);
+      }
+      break;
+
+    case ARM_WIFI_IP_DHCP:
+      if (len != 4U)
+      {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      DRVWIFI_Begin("AT+CWDHCP=");
+      DRVWIFI_Append((*(const uint32_t *)data != 0U) ? "1,1" : "0,1");
+      break;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  return DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, NULL));
+}
+
+/**
+  * @brief  Get an option of the station.
+  * @param  interface 0, the station.
+  * @param  option ARM_WIFI_MAC, ARM_WIFI_IP, ARM_WIFI_IP_SUBNET_MASK, ARM_WIFI_IP_GATEWAY,
+  *         ARM_WIFI_IP_DNS1, ARM_WIFI_IP_DNS2 or ARM_WIFI_IP_DHCP.
+  * @param  data Returns the value of the option.
+  * @param  len Size of data on input, of the value on output.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_GetOption(uint32_t interface, uint32_t option, void *data, uint32_t *len)
+{
+  const char *pText;
+  const char *pCapture;
+  uint32_t size;
+  uint32_t index;
+  int32_t status;
+
+  if (interface != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((data == NULL) || (len == NULL))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  switch (option)
+  {
+    case ARM_WIFI_MAC:
+      size = 6U;
+      DRVWIFI_Begin("AT+CIPSTAMAC?");
+      pCapture = "+CIPSTAMAC:";
+      break;
+    case ARM_WIFI_IP:
+      size = 4U;
+      DRVWIFI_Begin("AT+CIPSTA?");
+      pCapture = "+CIPSTA:ip:";
+      break;
+    case ARM_WIFI_IP_SUBNET_MASK:
+      size = 4U;
+      DRVWIFI_Begin("AT+CIPSTA?");
+      pCapture = "+CIPSTA:netmask:";
+      break;
+    case ARM_WIFI_IP_GATEWAY:
+      size = 4U;
+      DRVWIFI_Begin("AT+CIPSTA?");
+      pCapture = "+CIPSTA:gateway:";
+      break;
+    case ARM_WIFI_IP_DNS1:
+    case ARM_WIFI_IP_DNS2:
+      size = 4U;
+      DRVWIFI_Begin("AT+CIPDNS?");
+      pCapture = "+CIPDNS:";
+      break;
+    case ARM_WIFI_IP_DHCP:
+      size = 4U;
+      DRVWIFI_Begin("AT+CWDHCP?");
+      pCapture = "+CWDHCP:";
+      break;
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if (*len < size)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  status = DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, pCapture));
+  if (status != ARM_DRIVER_OK)
+  {
+    return status;
+  }
+  if (DRVWIFI_Resources.Replied == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  pText = DRVWIFI_Resources.Reply;
+  switch (option)
+  {
+    case ARM_WIFI_MAC:
+      status = (DRVWIFI_ParseMac(pText, (uint8_t *)data) != 0U) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+      break;
+    case ARM_WIFI_IP_DNS1:
+    case ARM_WIFI_IP_DNS2:
+      /* <enable>,"dns1","dns2" */
+      for (index = ARM_WIFI_IP_DNS1; index <= option; index++)
+      {
+        pText = strchr(pText, ',');
+        if (pText == NULL)
+        {
+          break;
+        }
+        pText++;
+      }
+      status = ((pText != NULL) && (DRVWIFI_ParseIp(pText, (uint8_t *)data) != 0U)) ?
+               ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+      break;
+    case ARM_WIFI_IP_DHCP:
+      /* Bit 0 is the DHCP client of the station */
+      *(uint32_t *)data = DRVWIFI_ParseUint(&pText) & 0x01U;
+      break;
+    default:
+      status = (DRVWIFI_ParseIp(pText, (uint8_t *)data) != 0U) ? ARM_DRIVER_OK : ARM_DRIVER_ERROR;
+      break;
+  }
+  if (status == ARM_DRIVER_OK)
+  {
+    *len = size;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Scan the access points around.
+  * @param  scan_info Returns the access points found.
+  * @param  max_num Size of scan_info.
+  * @retval Number of access points stored, or execution status
+  */
+static int32_t DRVWIFI_Scan(ARM_WIFI_SCAN_INFO_t scan_info[], uint32_t max_num)
+{
+  int32_t status;
+
+  if ((scan_info == NULL) || (max_num == 0U))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  DRVWIFI_Resources.pScan     = scan_info;
+  DRVWIFI_Resources.ScanMax   = max_num;
+  DRVWIFI_Resources.ScanCount = 0U;
+
+  DRVWIFI_Begin("AT+CWLAP");
+  DRVWIFI_Resources.Cmd.LineCallback = DRVWIFI_LineScan;
+  status = DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_SCAN_TIMEOUT, NULL, 0U, NULL));
+  DRVWIFI_Resources.pScan = NULL;
+
+  return (status == ARM_DRIVER_OK) ? (int32_t)DRVWIFI_Resources.ScanCount : status;
+}
+
+/**
+  * @brief  Join an access point.
+  * @param  interface 0, the station.
+  * @param  config SSID and key, the security and channel are negotiated by the module.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_Activate(uint32_t interface, const ARM_WIFI_CONFIG_t *config)
+{
+  int32_t status;
+
+  if (interface != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((config == NULL) || (config->ssid == NULL))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if (config->wps_method != ARM_WIFI_WPS_METHOD_NONE)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  DRVWIFI_Begin("AT+CWJAP=");
+  DRVWIFI_AppendString(config->ssid);
+  DRVWIFI_Append(",");
+  DRVWIFI_AppendString((config->pass != NULL) ? config->pass : "");
+  if (DRVWIFI_Resources.CommandLength >= DRVWIFI_COMMAND_SIZE)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  status = DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_JOIN_TIMEOUT, NULL, 0U, NULL));
+  if (status == ARM_DRIVER_OK)
+  {
+    DRVWIFI_Resources.Connected = 1U;
+    DRVWIFI_Resources.Security  = config->security;
+    memset(DRVWIFI_Resources.Pass, 0, sizeof(DRVWIFI_Resources.Pass));
+    if (config->pass != NULL)
+    {
+      strncpy(DRVWIFI_Resources.Pass, config->pass, sizeof(DRVWIFI_Resources.Pass) - 1U);
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Leave the access point.
+  * @param  interface 0, the station.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_Deactivate(uint32_t interface)
+{
+  if (interface != 0U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  DRVWIFI_Resources.Connected = 0U;
+  DRVWIFI_Begin("AT+CWQAP");
+
+  return DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, NULL));
+}
+
+/**
+  * @brief  Return the connection state of the station.
+  * @retval 1 when an address is obtained, 0 otherwise
+  */
+static uint32_t DRVWIFI_IsConnected(void)
+{
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return 0U;
+  }
+
+  /* Take the "WIFI" URCs received since the last call */
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+
+  return DRVWIFI_Resources.Connected;
+}
+
+/**
+  * @brief  Return the access point joined.
+  * @param  net_info Returns the SSID, channel and RSSI, and the key and security of Activate().
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_GetNetInfo(ARM_WIFI_NET_INFO_t *net_info)
+{
+  const char *pText;
+  int32_t status;
+  uint32_t negative;
+
+  if (net_info == NULL)
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* +CWJAP:"<ssid>","<bssid>",<channel>,<rssi>,... */
+  DRVWIFI_Begin("AT+CWJAP?");
+  status = DRVWIFI_DriverStatus(DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, "+CWJAP:"));
+  if ((status != ARM_DRIVER_OK) || (DRVWIFI_Resources.Replied == 0U))
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  memset(net_info, 0, sizeof(ARM_WIFI_NET_INFO_t));
+  pText = DRVWIFI_Resources.Reply;
+  DRVWIFI_ParseString(&pText, net_info->ssid, sizeof(net_info->ssid));
+  DRVWIFI_ParseString(&pText, NULL, 0U);
+  net_info->ch = (uint8_t)DRVWIFI_ParseUint(&pText);
+  negative = (*pText == '-') ? 1U : 0U;
+  pText += negative;
+  net_info->rssi = (uint8_t)DRVWIFI_ParseUint(&pText);
+  if (negative == 0U)
+  {
+    net_info->rssi = 0U;
+  }
+  memcpy(net_info->pass, DRVWIFI_Resources.Pass, sizeof(net_info->pass));
+  net_info->security = DRVWIFI_Resources.Security;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Bypass mode, not supported.
+  * @param  interface Unused.
+  * @param  mode Unused.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVWIFI_BypassControl(uint32_t interface, uint32_t mode)
+{
+  UNUSED(interface);
+  UNUSED(mode);
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Bypass mode, not supported.
+  * @param  interface Unused.
+  * @param  frame Unused.
+  * @param  len Unused.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVWIFI_EthSendFrame(uint32_t interface, const uint8_t *frame, uint32_t len)
+{
+  UNUSED(interface);
+  UNUSED(frame);
+  UNUSED(len);
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Bypass mode, not supported.
+  * @param  interface Unused.
+  * @param  frame Unused.
+  * @param  len Unused.
+  * @retval ARM_DRIVER_ERROR_UNSUPPORTED
+  */
+static int32_t DRVWIFI_EthReadFrame(uint32_t interface, uint8_t *frame, uint32_t len)
+{
+  UNUSED(interface);
+  UNUSED(frame);
+  UNUSED(len);
+
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+/**
+  * @brief  Bypass mode, not supported.
+  * @param  interface Unused.
+  * @retval 0
+  */
+static uint32_t DRVWIFI_EthGetRxFrameSize(uint32_t interface)
+{
+  UNUSED(interface);
+
+  return 0U;
+}
+
+/**
+  * @brief  Create a socket on a free link.
+  * @param  af ARM_SOCKET_AF_INET.
+  * @param  type ARM_SOCKET_SOCK_STREAM.
+  * @param  protocol ARM_SOCKET_IPPROTO_TCP or 0.
+  * @retval Socket, the link number, or a socket error
+  */
+static int32_t DRVWIFI_SocketCreate(int32_t af, int32_t type, int32_t protocol)
+{
+  int32_t socket;
+
+  if ((af != ARM_SOCKET_AF_INET) && (af != ARM_SOCKET_AF_INET6))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  if ((af != ARM_SOCKET_AF_INET) || (type != ARM_SOCKET_SOCK_STREAM) ||
+      ((protocol != 0) && (protocol != ARM_SOCKET_IPPROTO_TCP)))
+  {
+    return ARM_SOCKET_ENOTSUP;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_SOCKET_ERROR;
+  }
+
+  for (socket = 0; socket < (int32_t)BSP_DRVWIFI_SOCKETS; socket++)
+  {
+    if (DRVWIFI_Resources.Sockets[socket].State == DRVWIFI_SOCKET_FREE)
+    {
+      memset(&DRVWIFI_Resources.Sockets[socket], 0, sizeof(DRVWIFI_SocketTypeDef));
+      DRVWIFI_Resources.Sockets[socket].State = DRVWIFI_SOCKET_CREATED;
+      return socket;
+    }
+  }
+
+  return ARM_SOCKET_ENOMEM;
+}
+
+/**
+  * @brief  Bind a socket, not supported: the links are clients.
+  * @param  socket Socket.
+  * @param  ip Unused.
+  * @param  ip_len Unused.
+  * @param  port Unused.
+  * @retval ARM_SOCKET_ENOTSUP or ARM_SOCKET_ESOCK
+  */
+static int32_t DRVWIFI_SocketBind(int32_t socket, const uint8_t *ip, uint32_t ip_len, uint16_t port)
+{
+  UNUSED(ip);
+  UNUSED(ip_len);
+  UNUSED(port);
+
+  return (DRVWIFI_GetSocket(socket) == NULL) ? ARM_SOCKET_ESOCK : ARM_SOCKET_ENOTSUP;
+}
+
+/**
+  * @brief  Listen on a socket, not supported: the links are clients.
+  * @param  socket Socket.
+  * @param  backlog Unused.
+  * @retval ARM_SOCKET_ENOTSUP or ARM_SOCKET_ESOCK
+  */
+static int32_t DRVWIFI_SocketListen(int32_t socket, int32_t backlog)
+{
+  UNUSED(backlog);
+
+  return (DRVWIFI_GetSocket(socket) == NULL) ? ARM_SOCKET_ESOCK : ARM_SOCKET_ENOTSUP;
+}
+
+/**
+  * @brief  Accept a connection, not supported: the links are clients.
+  * @param  socket Socket.
+  * @param  ip Unused.
+  * @param  ip_len Unused.
+  * @param  port Unused.
+  * @retval ARM_SOCKET_ENOTSUP or ARM_SOCKET_ESOCK
+  */
+static int32_t DRVWIFI_SocketAccept(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port)
+{
+  UNUSED(ip);
+  UNUSED(ip_len);
+  UNUSED(port);
+
+  return (DRVWIFI_GetSocket(socket) == NULL) ? ARM_SOCKET_ESOCK : ARM_SOCKET_ENOTSUP;
+}
+
+/**
+  * @brief  Connect a socket to a TCP server.
+  * @param  socket Socket.
+  * @param  ip IPv4 address of the server.
+  * @param  ip_len 4.
+  * @param  port Port of the server.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketConnect(int32_t socket, const uint8_t *ip, uint32_t ip_len, uint16_t port)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  uint32_t status;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((ip == NULL) || (ip_len != 4U) || (port == 0U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  if (pSocket->State == DRVWIFI_SOCKET_CONNECTED)
+  {
+    return ARM_SOCKET_EISCONN;
+  }
+
+  DRVWIFI_Begin("AT+CIPSTART=");
+  DRVWIFI_AppendUint((uint32_t)socket);
+  DRVWIFI_Append(",\"TCP\",");
+  DRVWIFI_AppendIp(ip);
+  DRVWIFI_Append(",");
+  DRVWIFI_AppendUint(port);
+
+  pSocket->Available = 0U;
+  status = DRVWIFI_Execute(DRVWIFI_CONNECT_TIMEOUT, NULL, 0U, NULL);
+  if (status == BSP_ATCMD_STATUS_TIMEOUT)
+  {
+    return ARM_SOCKET_ETIMEDOUT;
+  }
+  if (status != BSP_ATCMD_STATUS_OK)
+  {
+    return ARM_SOCKET_ECONNREFUSED;
+  }
+
+  memcpy(pSocket->RemoteIp, ip, 4U);
+  pSocket->RemotePort = port;
+  pSocket->State      = DRVWIFI_SOCKET_CONNECTED;
+
+  return 0;
+}
+
+/**
+  * @brief  Receive data on a connected socket.
+  * @note   The data is copied from the UART receive ring into buf, without
+  *         intermediate buffer.
+  * @param  socket Socket.
+  * @param  buf Destination of the data.
+  * @param  len Size of buf, 0 to check if data is available.
+  * @retval Number of bytes received or a socket error
+  */
+static int32_t DRVWIFI_SocketRecv(int32_t socket, void *buf, uint32_t len)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t status;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((buf == NULL) && (len != 0U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  if (pSocket->State == DRVWIFI_SOCKET_CREATED)
+  {
+    return ARM_SOCKET_ENOTCONN;
+  }
+
+  /* Wait for a "+IPD" while the link is up */
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  while ((pSocket->Available == 0U) && (pSocket->State == DRVWIFI_SOCKET_CONNECTED))
+  {
+    if ((pSocket->NonBlocking != 0U) || (len == 0U) ||
+        ((pSocket->RecvTimeout != 0U) && ((HAL_GetTick() - tickstart) >= pSocket->RecvTimeout)))
+    {
+      return ARM_SOCKET_EAGAIN;
+    }
+    (void)BSP_SERIAL_Poll(BSP_SERIAL_EVENT_RX(DRVWIFI_Resources.Port), 1U);
+    BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  }
+  if (pSocket->Available == 0U)
+  {
+    return ARM_SOCKET_ECONNRESET;
+  }
+  if (len == 0U)
+  {
+    return 0;
+  }
+
+  if (len > pSocket->Available)
+  {
+    len = pSocket->Available;
+  }
+  if (len > BSP_DRVWIFI_DATA_MAX)
+  {
+    len = BSP_DRVWIFI_DATA_MAX;
+  }
+  DRVWIFI_Begin("AT+CIPRECVDATA=");
+  DRVWIFI_AppendUint((uint32_t)socket);
+  DRVWIFI_Append(",");
+  DRVWIFI_AppendUint(len);
+
+  /* The "+CIPRECVDATA:" header callback takes the buffer from the command */
+  DRVWIFI_Resources.RecvMax   = len;
+  DRVWIFI_Resources.RecvCount = 0U;
+  DRVWIFI_Resources.Cmd.pContext = buf;
+  status = DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, NULL);
+  if (status != BSP_ATCMD_STATUS_OK)
+  {
+    return (status == BSP_ATCMD_STATUS_TIMEOUT) ? ARM_SOCKET_EAGAIN : ARM_SOCKET_ERROR;
+  }
+
+  len = DRVWIFI_Resources.RecvCount;
+  pSocket->Available = (pSocket->Available > len) ? (pSocket->Available - len) : 0U;
+
+  return (int32_t)len;
+}
+
+/**
+  * @brief  Receive data on a connected socket, with the address of the peer.
+  * @param  socket Socket.
+  * @param  buf Destination of the data.
+  * @param  len Size of buf, 0 to check if data is available.
+  * @param  ip Returns the address of the peer, NULL for none.
+  * @param  ip_len Size of ip on input, of the address on output.
+  * @param  port Returns the port of the peer, NULL for none.
+  * @retval Number of bytes received or a socket error
+  */
+static int32_t DRVWIFI_SocketRecvFrom(int32_t socket, void *buf, uint32_t len, uint8_t *ip,
+                                      uint32_t *ip_len, uint16_t *port)
+{
+  int32_t received = DRVWIFI_SocketRecv(socket, buf, len);
+
+  if (received >= 0)
+  {
+    (void)DRVWIFI_SocketGetPeerName(socket, ip, ip_len, port);
+  }
+
+  return received;
+}
+
+/**
+  * @brief  Send data on a connected socket.
+  * @note   The data is written from buf into the UART transmit ring after the
+  *         '>' prompt of each AT+CIPSEND.
+  * @param  socket Socket.
+  * @param  buf Data to send.
+  * @param  len Number of bytes, 0 to check if data can be sent.
+  * @retval Number of bytes sent or a socket error
+  */
+static int32_t DRVWIFI_SocketSend(int32_t socket, const void *buf, uint32_t len)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  const uint8_t *pData = (const uint8_t *)buf;
+  uint32_t sent = 0U;
+  uint32_t length;
+  uint32_t status;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((buf == NULL) && (len != 0U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  if (pSocket->State != DRVWIFI_SOCKET_CONNECTED)
+  {
+    return (pSocket->State == DRVWIFI_SOCKET_CLOSED) ? ARM_SOCKET_ECONNRESET : ARM_SOCKET_ENOTCONN;
+  }
+
+  while (sent < len)
+  {
+    length = len - sent;
+    if (length > BSP_DRVWIFI_DATA_MAX)
+    {
+      length = BSP_DRVWIFI_DATA_MAX;
+    }
+    DRVWIFI_Begin("AT+CIPSEND=");
+    DRVWIFI_AppendUint((uint32_t)socket);
+    DRVWIFI_Append(",");
+    DRVWIFI_AppendUint(length);
+
+    status = DRVWIFI_Execute((pSocket->SendTimeout != 0U) ? pSocket->SendTimeout : DRVWIFI_SEND_TIMEOUT,
+                             &pData[sent], length, NULL);
+    if (status != BSP_ATCMD_STATUS_OK)
+    {
+      if (sent != 0U)
+      {
+        break;
+      }
+      if (pSocket->State == DRVWIFI_SOCKET_CLOSED)
+      {
+        return ARM_SOCKET_ECONNRESET;
+      }
+      return (status == BSP_ATCMD_STATUS_TIMEOUT) ? ARM_SOCKET_EAGAIN : ARM_SOCKET_ERROR;
+    }
+    sent += length;
+  }
+
+  return (int32_t)sent;
+}
+
+/**
+  * @brief  Send data on a connected socket, the address is the one of SocketConnect().
+  * @param  socket Socket.
+  * @param  buf Data to send.
+  * @param  len Number of bytes, 0 to check if data can be sent.
+  * @param  ip Unused.
+  * @param  ip_len Unused.
+  * @param  port Unused.
+  * @retval Number of bytes sent or a socket error
+  */
+static int32_t DRVWIFI_SocketSendTo(int32_t socket, const void *buf, uint32_t len, const uint8_t *ip,
+                                    uint32_t ip_len, uint16_t port)
+{
+  UNUSED(ip);
+  UNUSED(ip_len);
+  UNUSED(port);
+
+  return DRVWIFI_SocketSend(socket, buf, len);
+}
+
+/**
+  * @brief  Local address of a socket, not supported: the module does not report it.
+  * @param  socket Socket.
+  * @param  ip Unused.
+  * @param  ip_len Unused.
+  * @param  port Unused.
+  * @retval ARM_SOCKET_ENOTSUP or ARM_SOCKET_ESOCK
+  */
+static int32_t DRVWIFI_SocketGetSockName(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port)
+{
+  UNUSED(ip);
+  UNUSED(ip_len);
+  UNUSED(port);
+
+  return (DRVWIFI_GetSocket(socket) == NULL) ? ARM_SOCKET_ESOCK : ARM_SOCKET_ENOTSUP;
+}
+
+/**
+  * @brief  Return the address of the peer of a connected socket.
+  * @param  socket Socket.
+  * @param  ip Returns the address of the peer, NULL for none.
+  * @param  ip_len Size of ip on input, of the address on output.
+  * @param  port Returns the port of the peer, NULL for none.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketGetPeerName(int32_t socket, uint8_t *ip, uint32_t *ip_len, uint16_t *port)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((ip != NULL) && ((ip_len == NULL) || (*ip_len < 4U)))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  if (pSocket->State == DRVWIFI_SOCKET_CREATED)
+  {
+    return ARM_SOCKET_ENOTCONN;
+  }
+
+  if (ip != NULL)
+  {
+    memcpy(ip, pSocket->RemoteIp, 4U);
+    *ip_len = 4U;
+  }
+  if (port != NULL)
+  {
+    *port = pSocket->RemotePort;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Get a socket option.
+  * @param  socket Socket.
+  * @param  opt_id ARM_SOCKET_SO_RCVTIMEO, ARM_SOCKET_SO_SNDTIMEO or ARM_SOCKET_SO_TYPE.
+  * @param  opt_val Returns the value.
+  * @param  opt_len Size of opt_val on input, of the value on output.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketGetOpt(int32_t socket, int32_t opt_id, void *opt_val, uint32_t *opt_len)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  uint32_t value;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((opt_val == NULL) || (opt_len == NULL) || (*opt_len < 4U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+
+  switch (opt_id)
+  {
+    case ARM_SOCKET_SO_RCVTIMEO:
+      value = pSocket->RecvTimeout;
+      break;
+    case ARM_SOCKET_SO_SNDTIMEO:
+      value = pSocket->SendTimeout;
+      break;
+    case ARM_SOCKET_SO_TYPE:
+      value = (uint32_t)ARM_SOCKET_SOCK_STREAM;
+      break;
+    case ARM_SOCKET_IO_FIONBIO:
+      return ARM_SOCKET_EINVAL;
+    default:
+      return ARM_SOCKET_ENOTSUP;
+  }
+
+  *(uint32_t *)opt_val = value;
+  *opt_len = 4U;
+
+  return 0;
+}
+
+/**
+  * @brief  Set a socket option.
+  * @param  socket Socket.
+  * @param  opt_id ARM_SOCKET_IO_FIONBIO, ARM_SOCKET_SO_RCVTIMEO or ARM_SOCKET_SO_SNDTIMEO.
+  * @param  opt_val Value.
+  * @param  opt_len 4.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketSetOpt(int32_t socket, int32_t opt_id, const void *opt_val, uint32_t opt_len)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  uint32_t value;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+  if ((opt_val == NULL) || (opt_len != 4U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  value = *(const uint32_t *)opt_val;
+
+  switch (opt_id)
+  {
+    case ARM_SOCKET_IO_FIONBIO:
+      pSocket->NonBlocking = (value != 0U) ? 1U : 0U;
+      break;
+    case ARM_SOCKET_SO_RCVTIMEO:
+      pSocket->RecvTimeout = value;
+      break;
+    case ARM_SOCKET_SO_SNDTIMEO:
+      pSocket->SendTimeout = value;
+      break;
+    case ARM_SOCKET_SO_TYPE:
+      return ARM_SOCKET_EINVAL;
+    default:
+      return ARM_SOCKET_ENOTSUP;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Close a socket and free its link.
+  * @param  socket Socket.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketClose(int32_t socket)
+{
+  DRVWIFI_SocketTypeDef *pSocket = DRVWIFI_GetSocket(socket);
+  uint32_t status = BSP_ATCMD_STATUS_OK;
+
+  if (pSocket == NULL)
+  {
+    return ARM_SOCKET_ESOCK;
+  }
+
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  if (pSocket->State == DRVWIFI_SOCKET_CONNECTED)
+  {
+    DRVWIFI_Begin("AT+CIPCLOSE=");
+    DRVWIFI_AppendUint((uint32_t)socket);
+    status = DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, NULL);
+  }
+  pSocket->State = DRVWIFI_SOCKET_FREE;
+
+  /* An ERROR means the link was already closed by the peer */
+  return (status == BSP_ATCMD_STATUS_TIMEOUT) ? ARM_SOCKET_ERROR : 0;
+}
+
+/**
+  * @brief  Resolve a host name with the DNS client of the module.
+  * @param  name Host name.
+  * @param  af ARM_SOCKET_AF_INET.
+  * @param  ip Returns the IPv4 address.
+  * @param  ip_len Size of ip on input, 4 on output.
+  * @retval 0 or a socket error
+  */
+static int32_t DRVWIFI_SocketGetHostByName(const char *name, int32_t af, uint8_t *ip, uint32_t *ip_len)
+{
+  uint32_t status;
+
+  if ((name == NULL) || (ip == NULL) || (ip_len == NULL) || (*ip_len < 4U))
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+  if (af != ARM_SOCKET_AF_INET)
+  {
+    return (af == ARM_SOCKET_AF_INET6) ? ARM_SOCKET_ENOTSUP : ARM_SOCKET_EINVAL;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_SOCKET_ERROR;
+  }
+
+  DRVWIFI_Begin("AT+CIPDOMAIN=");
+  DRVWIFI_AppendString(name);
+  if (DRVWIFI_Resources.CommandLength >= DRVWIFI_COMMAND_SIZE)
+  {
+    return ARM_SOCKET_EINVAL;
+  }
+
+  status = DRVWIFI_Execute(DRVWIFI_DNS_TIMEOUT, NULL, 0U, "+CIPDOMAIN:");
+  if (status == BSP_ATCMD_STATUS_TIMEOUT)
+  {
+    return ARM_SOCKET_ETIMEDOUT;
+  }
+  if ((status != BSP_ATCMD_STATUS_OK) || (DRVWIFI_Resources.Replied == 0U) ||
+      (DRVWIFI_ParseIp(DRVWIFI_Resources.Reply, ip) == 0U))
+  {
+    return ARM_SOCKET_EHOSTNOTFOUND;
+  }
+  *ip_len = 4U;
+
+  return 0;
+}
+
+/**
+  * @brief  Ping a host.
+  * @param  ip IPv4 address of the host.
+  * @param  ip_len 4.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_Ping(const uint8_t *ip, uint32_t ip_len)
+{
+  uint32_t status;
+
+  if ((ip == NULL) || ((ip_len != 4U) && (ip_len != 16U)))
+  {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  if (ip_len != 4U)
+  {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  if ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U)
+  {
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* +PING:<time> then OK, or +PING:TIMEOUT then ERROR */
+  DRVWIFI_Begin("AT+PING=");
+  DRVWIFI_AppendIp(ip);
+  status = DRVWIFI_Execute(DRVWIFI_PING_TIMEOUT, NULL, 0U, "+PING:");
+  if ((status == BSP_ATCMD_STATUS_ERROR) && (DRVWIFI_Resources.Replied != 0U) &&
+      (strcmp(DRVWIFI_Resources.Reply, "TIMEOUT") == 0))
+  {
+    return ARM_DRIVER_ERROR_TIMEOUT;
+  }
+
+  return DRVWIFI_DriverStatus(status);
+}
+
+/**
+  * @brief  "+IPD,<link>,<length>": data held by the module for a link.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pLine URC.
+  * @param  Length Number of characters of the URC.
+  * @retval 1
+  */
+static uint32_t DRVWIFI_UrcIpd(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length)
+{
+  const char *pText = &pLine[5];
+  uint32_t link;
+
+  UNUSED(hat);
+  UNUSED(Length);
+
+  link = DRVWIFI_ParseUint(&pText);
+  if (link < BSP_DRVWIFI_SOCKETS)
+  {
+    DRVWIFI_Resources.Sockets[link].Available = DRVWIFI_ParseUint(&pText);
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  "+CIPRECVDATA:<length>,": header of the data read by SocketRecv().
+  * @note   The payload is copied from the receive ring into the buffer given
+  *         to the command, or dropped when it does not fit.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pLine Header.
+  * @param  Length Number of characters of the header.
+  * @retval 1
+  */
+static uint32_t DRVWIFI_UrcRecvData(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length)
+{
+  const BSP_ATCMD_CmdTypeDef *pCmd = BSP_ATCMD_GetCurrent(hat);
+  const char *pText = &pLine[13];
+  uint32_t length;
+
+  UNUSED(Length);
+
+  length = DRVWIFI_ParseUint(&pText);
+  if ((pCmd == &DRVWIFI_Resources.Cmd) && (pCmd->pContext != NULL) && (length <= DRVWIFI_Resources.RecvMax))
+  {
+    DRVWIFI_Resources.RecvCount = length;
+    (void)BSP_ATCMD_ReadRaw(hat, length, (uint8_t *)pCmd->pContext, NULL);
+  }
+  else
+  {
+    (void)BSP_ATCMD_ReadRaw(hat, length, NULL, NULL);
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  "WIFI GOT IP" and "WIFI DISCONNECT": state of the station.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pLine URC.
+  * @param  Length Number of characters of the URC.
+  * @retval 1
+  */
+static uint32_t DRVWIFI_UrcWifi(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length)
+{
+  uint32_t link;
+
+  UNUSED(hat);
+  UNUSED(Length);
+
+  if (strcmp(pLine, "WIFI GOT IP") == 0)
+  {
+    DRVWIFI_Resources.Connected = 1U;
+  }
+  else if (strcmp(pLine, "WIFI DISCONNECT") == 0)
+  {
+    DRVWIFI_Resources.Connected = 0U;
+    for (link = 0U; link < BSP_DRVWIFI_SOCKETS; link++)
+    {
+      if (DRVWIFI_Resources.Sockets[link].State == DRVWIFI_SOCKET_CONNECTED)
+      {
+        DRVWIFI_Resources.Sockets[link].State = DRVWIFI_SOCKET_CLOSED;
+      }
+    }
+  }
+  else
+  {
+    /* WIFI CONNECTED: the address is still to come */
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  "ready": the module has booted.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pLine URC.
+  * @param  Length Number of characters of the URC.
+  * @retval 1
+  */
+static uint32_t DRVWIFI_UrcReady(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length)
+{
+  UNUSED(hat);
+  UNUSED(pLine);
+  UNUSED(Length);
+
+  DRVWIFI_Resources.Ready = 1U;
+
+  return 1U;
+}
+
+/**
+  * @brief  "<link>,CONNECT", "<link>,CLOSED" and "<link>,CONNECT FAIL": state of a link.
+  * @param  hat Pointer to a BSP_ATCMD_TypeDef structure.
+  * @param  pLine Any line.
+  * @param  Length Number of characters of the line.
+  * @retval 1 for a link event, 0 otherwise
+  */
+static uint32_t DRVWIFI_UrcLink(BSP_ATCMD_TypeDef *hat, const char *pLine, uint32_t Length)
+{
+  uint32_t link = (uint32_t)pLine[0] - (uint32_t)'0';
+
+  UNUSED(hat);
+
+  if ((Length < 3U) || (link >= BSP_DRVWIFI_SOCKETS) || (pLine[1] != ','))
+  {
+    return 0U;
+  }
+
+  if (strcmp(&pLine[2], "CLOSED") == 0)
+  {
+    if (DRVWIFI_Resources.Sockets[link].State == DRVWIFI_SOCKET_CONNECTED)
+    {
+      DRVWIFI_Resources.Sockets[link].State = DRVWIFI_SOCKET_CLOSED;
+    }
+    return 1U;
+  }
+
+  /* CONNECT and CONNECT FAIL are followed by the result of AT+CIPSTART */
+  return (strncmp(&pLine[2], "CONNECT", 7U) == 0) ? 1U : 0U;
+}
+
+/**
+  * @brief  Keep the response line starting with the prefix given to the command.
+  * @param  pCmd Pointer to a BSP_ATCMD_CmdTypeDef structure, pContext is the prefix.
+  * @param  pLine Response line.
+  * @param  Length Number of characters of the line.
+  * @retval None
+  */
+static void DRVWIFI_LineCapture(BSP_ATCMD_CmdTypeDef *pCmd, const char *pLine, uint32_t Length)
+{
+  const char *pPrefix = (const char *)pCmd->pContext;
+  uint32_t length = strlen(pPrefix);
+
+  if ((DRVWIFI_Resources.Replied == 0U) && (Length >= length) && (memcmp(pLine, pPrefix, length) == 0))
+  {
+    memcpy(DRVWIFI_Resources.Reply, &pLine[length], (Length - length) + 1U);
+    DRVWIFI_Resources.Replied = 1U;
+  }
+}
+
+/**
+  * @brief  Store an access point of AT+CWLAP.
+  * @note   +CWLAP:(<ecn>,"<ssid>",<rssi>,"<mac>",<channel>,...)
+  * @param  pCmd Pointer to a BSP_ATCMD_CmdTypeDef structure.
+  * @param  pLine Response line.
+  * @param  Length Number of characters of the line.
+  * @retval None
+  */
+static void DRVWIFI_LineScan(BSP_ATCMD_CmdTypeDef *pCmd, const char *pLine, uint32_t Length)
+{
+  ARM_WIFI_SCAN_INFO_t *pInfo;
+  const char *pText = &pLine[8];
+  char bssid[18];
+  uint32_t ecn;
+  uint32_t rssi;
+
+  UNUSED(pCmd);
+
+  if ((Length < 8U) || (memcmp(pLine, "+CWLAP:(", 8U) != 0) ||
+      (DRVWIFI_Resources.ScanCount >= DRVWIFI_Resources.ScanMax))
+  {
+    return;
+  }
+  pInfo = &DRVWIFI_Resources.pScan[DRVWIFI_Resources.ScanCount];
+  memset(pInfo, 0, sizeof(ARM_WIFI_SCAN_INFO_t));
+
+  ecn = DRVWIFI_ParseUint(&pText);
+  if (ecn == 0U)
+  {
+    pInfo->security = ARM_WIFI_SECURITY_OPEN;
+  }
+  else if (ecn == 1U)
+  {
+    pInfo->security = ARM_WIFI_SECURITY_WEP;
+  }
+  else if (ecn == 2U)
+  {
+    pInfo->security = ARM_WIFI_SECURITY_WPA;
+  }
+  else if ((ecn == 3U) || (ecn == 4U))
+  {
+    pInfo->security = ARM_WIFI_SECURITY_WPA2;
+  }
+  else
+  {
+    pInfo->security = ARM_WIFI_SECURITY_UNKNOWN;
+  }
+
+  DRVWIFI_ParseString(&pText, pInfo->ssid, sizeof(pInfo->ssid));
+  if (*pText == '-')
+  {
+    pText++;
+  }
+  rssi = DRVWIFI_ParseUint(&pText);
+  pInfo->rssi = (uint8_t)rssi;
+  DRVWIFI_ParseString(&pText, bssid, sizeof(bssid));
+  (void)DRVWIFI_ParseMac(bssid, pInfo->bssid);
+  pInfo->ch = (uint8_t)DRVWIFI_ParseUint(&pText);
+
+  DRVWIFI_Resources.ScanCount++;
+}
+
+/**
+  * @brief  Run the command line built in Command and wait for its final result.
+  * @note   Cmd.LineCallback and Cmd.pContext set before the call are kept when
+  *         no prefix is captured.
+  * @param  Timeout Time to the final result in ms.
+  * @param  pData Payload written after the '>' prompt, NULL for none.
+  * @param  Length Number of bytes of the payload.
+  * @param  pCapture Prefix of the response line kept in Reply, NULL for none.
+  * @retval A value of @ref BSP_ATCMD_Status
+  */
+static uint32_t DRVWIFI_Execute(uint32_t Timeout, const uint8_t *pData, uint32_t Length,
+                                const char *pCapture)
+{
+  BSP_ATCMD_CmdTypeDef *pCmd = &DRVWIFI_Resources.Cmd;
+
+  if (DRVWIFI_Resources.CommandLength >= DRVWIFI_COMMAND_SIZE)
+  {
+    pCmd->LineCallback = NULL;
+    pCmd->pContext     = NULL;
+    return BSP_ATCMD_STATUS_ERROR;
+  }
+
+  DRVWIFI_Resources.Replied  = 0U;
+  DRVWIFI_Resources.Reply[0] = '\0';
+  pCmd->pCommand     = DRVWIFI_Resources.Command;
+  pCmd->pData        = pData;
+  pCmd->DataLength   = Length;
+  pCmd->Timeout      = Timeout;
+  pCmd->CpltCallback = NULL;
+  if (pCapture != NULL)
+  {
+    pCmd->LineCallback = DRVWIFI_LineCapture;
+    pCmd->pContext     = (void *)pCapture;
+  }
+
+  if (BSP_ATCMD_Submit(&DRVWIFI_Resources.At, pCmd) != HAL_OK)
+  {
+    return BSP_ATCMD_STATUS_ERROR;
+  }
+  DRVWIFI_Wait(pCmd);
+
+  pCmd->LineCallback = NULL;
+  pCmd->pContext     = NULL;
+
+  return pCmd->Status;
+}
+
+/**
+  * @brief  Run the AT engine until a command ends, sleeping while the line is quiet.
+  * @param  pCmd Command submitted.
+  * @retval None
+  */
+static void DRVWIFI_Wait(const BSP_ATCMD_CmdTypeDef *pCmd)
+{
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  while (pCmd->Status == BSP_ATCMD_STATUS_PENDING)
+  {
+    (void)BSP_SERIAL_Poll(BSP_SERIAL_EVENT_RX(DRVWIFI_Resources.Port), 1U);
+    BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  }
+}
+
+/**
+  * @brief  Convert the final status of a command.
+  * @param  Status A value of @ref BSP_ATCMD_Status.
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_DriverStatus(uint32_t Status)
+{
+  if (Status == BSP_ATCMD_STATUS_OK)
+  {
+    return ARM_DRIVER_OK;
+  }
+
+  return (Status == BSP_ATCMD_STATUS_TIMEOUT) ? ARM_DRIVER_ERROR_TIMEOUT : ARM_DRIVER_ERROR;
+}
+
+/**
+  * @brief  Reset the module and wait for its "ready".
+  * @retval Execution status
+  */
+static int32_t DRVWIFI_Reset(void)
+{
+  uint32_t tickstart;
+
+  BSP_ATCMD_Flush(&DRVWIFI_Resources.At);
+  DRVWIFI_Resources.Ready = 0U;
+
+  if (DRVWIFI_Resources.ResetPort != NULL)
+  {
+    HAL_GPIO_WritePin(DRVWIFI_Resources.ResetPort, DRVWIFI_Resources.ResetPin, GPIO_PIN_RESET);
+    HAL_Delay(DRVWIFI_RESET_PULSE);
+    HAL_GPIO_WritePin(DRVWIFI_Resources.ResetPort, DRVWIFI_Resources.ResetPin, GPIO_PIN_SET);
+  }
+  else
+  {
+    DRVWIFI_Begin("AT+RST");
+    if (DRVWIFI_Execute(DRVWIFI_TIMEOUT, NULL, 0U, NULL) != BSP_ATCMD_STATUS_OK)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+  }
+
+  /* The boot messages of the ROM, at another baud rate, end as dropped lines */
+  tickstart = HAL_GetTick();
+  BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  while (DRVWIFI_Resources.Ready == 0U)
+  {
+    if ((HAL_GetTick() - tickstart) >= DRVWIFI_READY_TIMEOUT)
+    {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+    (void)BSP_SERIAL_Poll(BSP_SERIAL_EVENT_RX(DRVWIFI_Resources.Port), 1U);
+    BSP_ATCMD_Process(&DRVWIFI_Resources.At);
+  }
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  * @brief  Start a command line.
+  * @param  pText First characters.
+  * @retval None
+  */
+static void DRVWIFI_Begin(const char *pText)
+{
+  DRVWIFI_Resources.CommandLength = 0U;
+  DRVWIFI_Append(pText);
+}
+
+/**
+  * @brief  Append characters to the command line, marking an overflow.
+  * @param  pText Characters.
+  * @retval None
+  */
+static void DRVWIFI_Append(const char *pText)
+{
+  uint32_t length = DRVWIFI_Resources.CommandLength;
+
+  while ((*pText != '\0') && (length < (DRVWIFI_COMMAND_SIZE - 1U)))
+  {
+    DRVWIFI_Resources.Command[length] = *pText;
+    length++;
+    pText++;
+  }
+  DRVWIFI_Resources.Command[length] = '\0';
+  DRVWIFI_Resources.CommandLength = (*pText != '\0') ? DRVWIFI_COMMAND_SIZE : length;
+}
+
+/**
+  * @brief  Append a decimal number to the command line.
+  * @param  Value Number.
+  * @retval None
+  */
+static void DRVWIFI_AppendUint(uint32_t Value)
+{
+  char digits[11];
+  uint32_t index = sizeof(digits) - 1U;
+
+  digits[index] = '\0';
+  do
+  {
+    index--;
+    digits[index] = (char)('0' + (Value % 10U));
+    Value /= 10U;
+  } while (Value != 0U);
+
+  DRVWIFI_Append(&digits[index]);
+}
+
+/**
+  * @brief  Append a quoted IPv4 address to the command line.
+  * @param  pIp Address.
+  * @retval None
+  */
+static void DRVWIFI_AppendIp(const uint8_t *pIp)
+{
+  uint32_t index;
+
+  DRVWIFI_Append("\"");
+  for (index = 0U; index < 4U; index++)
+  {
+    DRVWIFI_AppendUint(pIp[index]);
+    DRVWIFI_Append((index < 3U) ? "." : "\"");
+  }
+}
+
+/**
+  * @brief  Append a quoted string to the command line, escaping '"', ',' and '\'.
+  * @param  pText String.
+  * @retval None
+  */
+static void DRVWIFI_AppendString(const char *pText)
+{
+  char escaped[3] = {'\\', '\0', '\0'};
+
+  DRVWIFI_Append("\"");
+  while (*pText != '\0')
+  {
+    escaped[1] = *pText;
+    DRVWIFI_Append(((*pText == '"') || (*pText == ',') || (*pText == '\\')) ? escaped : &escaped[1]);
+    pText++;
+  }
+  DRVWIFI_Append("\"");
+}
+
+/**
+  * @brief  Parse a decimal number, skipping the separator after it.
+  * @param  ppText Text, advanced past the number and one ','.
+  * @retval Number, 0 without digit
+  */
+static uint32_t DRVWIFI_ParseUint(const char **ppText)
+{
+  const char *pText = *ppText;
+  uint32_t value = 0U;
+
+  while ((*pText >= '0') && (*pText <= '9'))
+  {
+    value = (value * 10U) + (uint32_t)(*pText - '0');
+    pText++;
+  }
+  if (*pText == ',')
+  {
+    pText++;
+  }
+  *ppText = pText;
+
+  return value;
+}
+
+/**
+  * @brief  Parse an IPv4 address, quoted or not.
+  * @param  pText Text.
+  * @param  pIp Returns the address.
+  * @retval 1 on success, 0 otherwise
+  */
+static uint32_t DRVWIFI_ParseIp(const char *pText, uint8_t *pIp)
+{
+  uint32_t value;
+  uint32_t index;
+
+  if (*pText == '"')
+  {
+    pText++;
+  }
+  for (index = 0U; index < 4U; index++)
+  {
+    if ((*pText < '0') || (*pText > '9'))
+    {
+      return 0U;
+    }
+    value = 0U;
+    while ((*pText >= '0') && (*pText <= '9'))
+    {
+      value = (value * 10U) + (uint32_t)(*pText - '0');
+      pText++;
+    }
+    if ((value > 255U) || ((index < 3U) && (*pText != '.')))
+    {
+      return 0U;
+    }
+    pIp[index] = (uint8_t)value;
+    pText++;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Parse a MAC address "aa:bb:cc:dd:ee:ff", quoted or not.
+  * @param  pText Text.
+  * @param  pMac Returns the address.
+  * @retval 1 on success, 0 otherwise
+  */
+static uint32_t DRVWIFI_ParseMac(const char *pText, uint8_t *pMac)
+{
+  uint32_t value;
+  uint32_t index;
+  uint32_t digit;
+  char c;
+
+  if (*pText == '"')
+  {
+    pText++;
+  }
+  for (index = 0U; index < 12U; index++)
+  {
+    c = *pText;
+    if ((c >= '0') && (c <= '9'))
+    {
+      value = (uint32_t)(c - '0');
+    }
+    else if ((c >= 'a') && (c <= 'f'))
+    {
+      value = (uint32_t)(c - 'a') + 10U;
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+      value = (uint32_t)(c - 'A') + 10U;
+    }
+    else
+    {
+      return 0U;
+    }
+    digit = index >> 1;
+    pMac[digit] = ((index & 1U) == 0U) ? (uint8_t)(value << 4) : (uint8_t)(pMac[digit] | value);
+    pText++;
+    if (((index & 1U) != 0U) && (index < 11U))
+    {
+      if (*pText != ':')
+      {
+        return 0U;
+      }
+      pText++;
+    }
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Parse a quoted string, skipping the separator after it.
+  * @note   The string ends at the quote followed by ',' ')' or the end of the line.
+  * @param  ppText Text, advanced past the string and one ','.
+  * @param  pOut Returns the string, truncated to Size, NULL to skip it.
+  * @param  Size Size of pOut.
+  * @retval None
+  */
+static void DRVWIFI_ParseString(const char **ppText, char *pOut, uint32_t Size)
+{
+  const char *pText = *ppText;
+  uint32_t length = 0U;
+
+  if (*pText == '"')
+  {
+    pText++;
+    while ((*pText != '\0') &&
+           !((pText[0] == '"') && ((pText[1] == ',') || (pText[1] == ')') || (pText[1] == '\0'))))
+    {
+      if ((pOut != NULL) && ((length + 1U) < Size))
+      {
+        pOut[length] = *pText;
+        length++;
+      }
+      pText++;
+    }
+    if (*pText == '"')
+    {
+      pText++;
+    }
+  }
+  if (*pText == ',')
+  {
+    pText++;
+  }
+  if ((pOut != NULL) && (Size != 0U))
+  {
+    pOut[length] = '\0';
+  }
+  *ppText = pText;
+}
+
+/**
+  * @brief  Return the state of a socket in use.
+  * @param  socket Socket.
+  * @retval Socket state, NULL when the socket is not created
+  */
+static DRVWIFI_SocketTypeDef *DRVWIFI_GetSocket(int32_t socket)
+{
+  if ((socket < 0) || (socket >= (int32_t)BSP_DRVWIFI_SOCKETS) ||
+      (DRVWIFI_Resources.Sockets[socket].State == DRVWIFI_SOCKET_FREE) ||
+      ((DRVWIFI_Resources.Flags & DRVWIFI_FLAG_POWERED) == 0U))
+  {
+    return NULL;
+  }
+
+  return &DRVWIFI_Resources.Sockets[socket];
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_CMSIS_DRIVER && HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1764 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_dsp.c
+  * @author  MCU Application Team
+  * @brief   DSP kernels BSP service.
+  *          This file provides the signal processing kernels of the ADC and
+  *          I2S paths, in Q15, Q31 and float, for the Cortex-M4 DSP and FPU:
+  *           + FIR filters, block processing
+  *           + Biquad cascades
+  *           + Radix 4 complex FFT
+  *           + Dot product and RMS
+  *           + I2S sample formats, interleaving and gain
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The Q15 kernels work on two samples per instruction: pairs of
+       halfwords are read with unaligned word loads and multiplied and
+       accumulated by __SMLALD into a 64-bit accumulator, and the FFT
+       butterflies use the halving additions __SHADD16, __SHASX and
+       __SHSAX and the complex products __SMUAD, __SMUSD and __SMUADX. The
+       Q31 kernels use the 64-bit products of SMLAL, the float ones the
+       FPv4 unit: build with -mfloat-abi=hard as the Makefile does.
+
+   (#) FIR: call BSP_DSP_FIR_xxx_Init() with the coefficients in time reversed
+       order, b[NumTaps - 1] first, and a state of NumTaps + BlockSize - 1
+       samples, then BSP_DSP_FIR_xxx_Process() on blocks of up to BlockSize
+       samples; the source and the destination can be the same buffer. The
+       Q15 and Q31 outputs are the accumulator shifted by 15 or 31 bits and
+       saturated. Even block sizes run two outputs per step in Q15.
+
+   (#) Biquad: five coefficients by stage, b0, b1, b2, a1, a2, with the sign
+       of the feedback included: y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2,
+       a1 and a2 being the opposite of the denominator of the transfer
+       function. The fixed point coefficients are scaled by 2^-PostShift so
+       that they fit in [-1, 1); the accumulator is shifted back by
+       PostShift. Stages are run one after the other on the whole block.
+
+   (#) FFT: BSP_DSP_FFT_xxx_Init() builds the 3 Length / 4 twiddle factors
+       in a buffer given by the caller, word aligned, of 3 Length / 2
+       values. BSP_DSP_FFT_xxx_Process() transforms in place Length complex
+       points, real and imaginary parts interleaved, word aligned, in the
+       natural order. The Q15 and Q31 transforms divide by 4 at each stage,
+       the result is the transform divided by Length in both directions;
+       the complex inputs must have a magnitude below 1. The float inverse
+       transform divides by Length. The inverse transform runs the forward
+       one on the exchanged real and imaginary parts.
+
+   (#) Dot product: BSP_DSP_Dot_Q15() returns the sum of the products in
+       34.30, BSP_DSP_Dot_Q31() in 16.48. RMS: the square root of the mean of
+       the squares, in the format of the input.
+
+   (#) Conversions: in 16 bits the I2S buffers are Q15 stereo frames, left
+       sample first, used as they are. In 24 and 32 bits BSP_DSP_I2S_ToQ31()
+       and BSP_DSP_Q31_ToI2S() swap the two halfwords of each sample with one
+       rotation, in place in the DMA half just completed. The Q15 split,
+       merge and gain work on two samples per word with __PKHBT, __PKHTB
+       and __SSAT.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "py32f4xx_bsp_dsp.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DSP BSP DSP
+  * @brief DSP kernels BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DSP_Private_Constants BSP DSP Private Constants
+  * @{
+  */
+#define DSP_PI                    3.14159265358979f
+#define DSP_Q15_ONE               32767                /*!< Largest Q15, the twiddle of 1  */
+#define DSP_Q31_ONE               0x7FFFFFFF           /*!< Largest Q31, the twiddle of 1  */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_DSP_Private_Macros BSP DSP Private Macros
+  * @{
+  */
+/* Two Q15 samples, the first one in the low halfword */
+#define DSP_READ_Q15X2(__PTR__)   (__UNALIGNED_UINT32_READ(__PTR__))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_DSP_Private_Functions BSP DSP Private Functions
+  * @{
+  */
+static uint32_t DSP_FFT_Log2(uint32_t Length);
+static int32_t  DSP_SatQ31(int64_t Value);
+static uint32_t DSP_Sqrt64(uint64_t Value);
+static uint32_t DSP_DigitReverse(uint32_t Index, uint32_t Log2Length);
+static void     DSP_FFT_Q15_Stages(uint32_t *pData, const uint32_t *pTwiddle, uint32_t Length);
+static void     DSP_FFT_Q31_Stages(int32_t *pData, const int32_t *pTwiddle, uint32_t Length);
+static void     DSP_FFT_F32_Stages(float *pData, const float *pTwiddle, uint32_t Length);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DSP_Exported_Functions BSP DSP Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_DSP_Exported_Functions_Group1 Filter functions
+  * @brief    Filter functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Filter functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Run FIR filters on blocks of samples
+      (+) Run cascades of second order sections
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a Q15 FIR filter, its state cleared.
+  * @param  hfir Pointer to a BSP_DSP_FIR_Q15_TypeDef structure.
+  * @param  NumTaps Filter length, at least 1.
+  * @param  pCoeffs Coefficients in time reversed order.
+  * @param  pState State of NumTaps + BlockSize - 1 samples.
+  * @param  BlockSize Largest block processed.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FIR_Q15_Init(BSP_DSP_FIR_Q15_TypeDef *hfir, uint32_t NumTaps, const int16_t *pCoeffs,
+                                       int16_t *pState, uint32_t BlockSize)
+{
+  if ((hfir == NULL) || (NumTaps == 0U) || (pCoeffs == NULL) || (pState == NULL) || (BlockSize == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hfir->NumTaps   = NumTaps;
+  hfir->pCoeffs   = pCoeffs;
+  hfir->pState    = pState;
+  hfir->BlockSize = BlockSize;
+  (void)memset(pState, 0, (NumTaps + BlockSize - 1U) * sizeof(int16_t));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of Q15 samples.
+  * @param  hfir Pointer to a BSP_DSP_FIR_Q15_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples, up to the BlockSize of the Init.
+  * @retval None
+  */
+void BSP_DSP_FIR_Q15_Process(BSP_DSP_FIR_Q15_TypeDef *hfir, const int16_t *pSrc, int16_t *pDst,
+                             uint32_t BlockSize)
+{
+  uint32_t taps = hfir->NumTaps;
+  int16_t *state = hfir->pState;
+  const int16_t *pc;
+  const int16_t *px;
+  uint32_t coeffs;
+  int64_t acc0;
+  int64_t acc1;
+  uint32_t n;
+  uint32_t k;
+
+  (void)memcpy(&state[taps - 1U], pSrc, BlockSize * sizeof(int16_t));
+
+  /* Two outputs per step, each coefficient pair loaded once */
+  for (n = 0U; (n + 1U) < BlockSize; n += 2U)
+  {
+    pc   = hfir->pCoeffs;
+    px   = &state[n];
+    acc0 = 0;
+    acc1 = 0;
+    for (k = taps >> 1; k > 0U; k--)
+    {
+      coeffs = DSP_READ_Q15X2(pc);
+      acc0 = __SMLALD(DSP_READ_Q15X2(px), coeffs, acc0);
+      acc1 = __SMLALD(DSP_READ_Q15X2(px + 1), coeffs, acc1);
+      pc += 2;
+      px += 2;
+    }
+    if ((taps & 1U) != 0U)
+    {
+      acc0 += (int32_t)pc[0] * px[0];
+      acc1 += (int32_t)pc[0] * px[1];
+    }
+    pDst[n]      = (int16_t)__SSAT((int32_t)(acc0 >> 15), 16);
+    pDst[n + 1U] = (int16_t)__SSAT((int32_t)(acc1 >> 15), 16);
+  }
+
+  if (n < BlockSize)
+  {
+    pc   = hfir->pCoeffs;
+    px   = &state[n];
+    acc0 = 0;
+    for (k = taps >> 1; k > 0U; k--)
+    {
+      acc0 = __SMLALD(DSP_READ_Q15X2(px), DSP_READ_Q15X2(pc), acc0);
+      pc += 2;
+      px += 2;
+    }
+    if ((taps & 1U) != 0U)
+    {
+      acc0 += (int32_t)pc[0] * px[0];
+    }
+    pDst[n] = (int16_t)__SSAT((int32_t)(acc0 >> 15), 16);
+  }
+
+  /* History of the next block */
+  (void)memmove(state, &state[BlockSize], (taps - 1U) * sizeof(int16_t));
+}
+
+/**
+  * @brief  Initialize a Q31 FIR filter, its state cleared.
+  * @param  hfir Pointer to a BSP_DSP_FIR_Q31_TypeDef structure.
+  * @param  NumTaps Filter length, at least 1.
+  * @param  pCoeffs Coefficients in time reversed order.
+  * @param  pState State of NumTaps + BlockSize - 1 samples.
+  * @param  BlockSize Largest block processed.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FIR_Q31_Init(BSP_DSP_FIR_Q31_TypeDef *hfir, uint32_t NumTaps, const int32_t *pCoeffs,
+                                       int32_t *pState, uint32_t BlockSize)
+{
+  if ((hfir == NULL) || (NumTaps == 0U) || (pCoeffs == NULL) || (pState == NULL) || (BlockSize == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hfir->NumTaps   = NumTaps;
+  hfir->pCoeffs   = pCoeffs;
+  hfir->pState    = pState;
+  hfir->BlockSize = BlockSize;
+  (void)memset(pState, 0, (NumTaps + BlockSize - 1U) * sizeof(int32_t));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of Q31 samples.
+  * @param  hfir Pointer to a BSP_DSP_FIR_Q31_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples, up to the BlockSize of the Init.
+  * @retval None
+  */
+void BSP_DSP_FIR_Q31_Process(BSP_DSP_FIR_Q31_TypeDef *hfir, const int32_t *pSrc, int32_t *pDst,
+                             uint32_t BlockSize)
+{
+  uint32_t taps = hfir->NumTaps;
+  int32_t *state = hfir->pState;
+  const int32_t *pc;
+  const int32_t *px;
+  int64_t acc;
+  uint32_t n;
+  uint32_t k;
+
+  (void)memcpy(&state[taps - 1U], pSrc, BlockSize * sizeof(int32_t));
+
+  for (n = 0U; n < BlockSize; n++)
+  {
+    pc  = hfir->pCoeffs;
+    px  = &state[n];
+    acc = 0;
+    for (k = taps; k > 0U; k--)
+    {
+      acc += (int64_t)*pc++ * *px++;
+    }
+    pDst[n] = DSP_SatQ31(acc >> 31);
+  }
+
+  (void)memmove(state, &state[BlockSize], (taps - 1U) * sizeof(int32_t));
+}
+
+/**
+  * @brief  Initialize a float FIR filter, its state cleared.
+  * @param  hfir Pointer to a BSP_DSP_FIR_F32_TypeDef structure.
+  * @param  NumTaps Filter length, at least 1.
+  * @param  pCoeffs Coefficients in time reversed order.
+  * @param  pState State of NumTaps + BlockSize - 1 samples.
+  * @param  BlockSize Largest block processed.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FIR_F32_Init(BSP_DSP_FIR_F32_TypeDef *hfir, uint32_t NumTaps, const float *pCoeffs,
+                                       float *pState, uint32_t BlockSize)
+{
+  if ((hfir == NULL) || (NumTaps == 0U) || (pCoeffs == NULL) || (pState == NULL) || (BlockSize == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hfir->NumTaps   = NumTaps;
+  hfir->pCoeffs   = pCoeffs;
+  hfir->pState    = pState;
+  hfir->BlockSize = BlockSize;
+  (void)memset(pState, 0, (NumTaps + BlockSize - 1U) * sizeof(float));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of float samples.
+  * @param  hfir Pointer to a BSP_DSP_FIR_F32_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples, up to the BlockSize of the Init.
+  * @retval None
+  */
+void BSP_DSP_FIR_F32_Process(BSP_DSP_FIR_F32_TypeDef *hfir, const float *pSrc, float *pDst,
+                             uint32_t BlockSize)
+{
+  uint32_t taps = hfir->NumTaps;
+  float *state = hfir->pState;
+  const float *pc;
+  const float *px;
+  float acc;
+  uint32_t n;
+  uint32_t k;
+
+  (void)memcpy(&state[taps - 1U], pSrc, BlockSize * sizeof(float));
+
+  for (n = 0U; n < BlockSize; n++)
+  {
+    pc  = hfir->pCoeffs;
+    px  = &state[n];
+    acc = 0.0f;
+    for (k = taps; k > 0U; k--)
+    {
+      acc += *pc++ * *px++;
+    }
+    pDst[n] = acc;
+  }
+
+  (void)memmove(state, &state[BlockSize], (taps - 1U) * sizeof(float));
+}
+
+/**
+  * @brief  Initialize a Q15 biquad cascade, its state cleared.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_Q15_TypeDef structure.
+  * @param  NumStages Second order sections, at least 1.
+  * @param  pCoeffs 5 coefficients per stage.
+  * @param  pState 4 samples per stage.
+  * @param  PostShift Scaling of the coefficients, 0 to 15.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_BIQUAD_Q15_Init(BSP_DSP_BIQUAD_Q15_TypeDef *hbiq, uint32_t NumStages,
+                                          const int16_t *pCoeffs, int16_t *pState, uint32_t PostShift)
+{
+  if ((hbiq == NULL) || (NumStages == 0U) || (pCoeffs == NULL) || (pState == NULL) || (PostShift > 15U))
+  {
+    return HAL_ERROR;
+  }
+
+  hbiq->NumStages = NumStages;
+  hbiq->pCoeffs   = pCoeffs;
+  hbiq->pState    = pState;
+  hbiq->PostShift = PostShift;
+  (void)memset(pState, 0, NumStages * 4U * sizeof(int16_t));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of Q15 samples through the cascade.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_Q15_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples.
+  * @retval None
+  */
+void BSP_DSP_BIQUAD_Q15_Process(BSP_DSP_BIQUAD_Q15_TypeDef *hbiq, const int16_t *pSrc, int16_t *pDst,
+                                uint32_t BlockSize)
+{
+  const int16_t *pc = hbiq->pCoeffs;
+  int16_t *ps = hbiq->pState;
+  const int16_t *in = pSrc;
+  uint32_t shift = 15U - hbiq->PostShift;
+  uint32_t b0b1;
+  uint32_t b2a1;
+  int32_t a2;
+  int32_t x0;
+  int32_t x1;
+  int32_t x2;
+  int32_t y1;
+  int32_t y2;
+  int64_t acc;
+  uint32_t stage;
+  uint32_t n;
+
+  for (stage = hbiq->NumStages; stage > 0U; stage--)
+  {
+    /* Coefficient pairs packed once per stage */
+    b0b1 = __PKHBT((uint32_t)(uint16_t)pc[0], (uint32_t)pc[1], 16);
+    b2a1 = __PKHBT((uint32_t)(uint16_t)pc[2], (uint32_t)pc[3], 16);
+    a2   = pc[4];
+    x1   = ps[0];
+    x2   = ps[1];
+    y1   = ps[2];
+    y2   = ps[3];
+
+    for (n = 0U; n < BlockSize; n++)
+    {
+      x0  = in[n];
+      acc = __SMLALD(__PKHBT((uint32_t)(uint16_t)x0, (uint32_t)x1, 16), b0b1, 0);
+      acc = __SMLALD(__PKHBT((uint32_t)(uint16_t)x2, (uint32_t)y1, 16), b2a1, acc);
+      acc += a2 * y2;
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = __SSAT((int32_t)(acc >> shift), 16);
+      pDst[n] = (int16_t)y1;
+    }
+
+    ps[0] = (int16_t)x1;
+    ps[1] = (int16_t)x2;
+    ps[2] = (int16_t)y1;
+    ps[3] = (int16_t)y2;
+    pc += 5;
+    ps += 4;
+    in = pDst;
+  }
+}
+
+/**
+  * @brief  Initialize a Q31 biquad cascade, its state cleared.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_Q31_TypeDef structure.
+  * @param  NumStages Second order sections, at least 1.
+  * @param  pCoeffs 5 coefficients per stage.
+  * @param  pState 4 samples per stage.
+  * @param  PostShift Scaling of the coefficients, 0 to 31.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_BIQUAD_Q31_Init(BSP_DSP_BIQUAD_Q31_TypeDef *hbiq, uint32_t NumStages,
+                                          const int32_t *pCoeffs, int32_t *pState, uint32_t PostShift)
+{
+  if ((hbiq == NULL) || (NumStages == 0U) || (pCoeffs == NULL) || (pState == NULL) || (PostShift > 31U))
+  {
+    return HAL_ERROR;
+  }
+
+  hbiq->NumStages = NumStages;
+  hbiq->pCoeffs   = pCoeffs;
+  hbiq->pState    = pState;
+  hbiq->PostShift = PostShift;
+  (void)memset(pState, 0, NumStages * 4U * sizeof(int32_t));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of Q31 samples through the cascade.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_Q31_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples.
+  * @retval None
+  */
+void BSP_DSP_BIQUAD_Q31_Process(BSP_DSP_BIQUAD_Q31_TypeDef *hbiq, const int32_t *pSrc, int32_t *pDst,
+                                uint32_t BlockSize)
+{
+  const int32_t *pc = hbiq->pCoeffs;
+  int32_t *ps = hbiq->pState;
+  const int32_t *in = pSrc;
+  uint32_t shift = 31U - hbiq->PostShift;
+  int32_t x0;
+  int32_t x1;
+  int32_t x2;
+  int32_t y1;
+  int32_t y2;
+  int64_t acc;
+  uint32_t stage;
+  uint32_t n;
+
+  for (stage = hbiq->NumStages; stage > 0U; stage--)
+  {
+    x1 = ps[0];
+    x2 = ps[1];
+    y1 = ps[2];
+    y2 = ps[3];
+
+    for (n = 0U; n < BlockSize; n++)
+    {
+      x0  = in[n];
+      acc = ((int64_t)pc[0] * x0) + ((int64_t)pc[1] * x1) + ((int64_t)pc[2] * x2) +
+            ((int64_t)pc[3] * y1) + ((int64_t)pc[4] * y2);
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = DSP_SatQ31(acc >> shift);
+      pDst[n] = y1;
+    }
+
+    ps[0] = x1;
+    ps[1] = x2;
+    ps[2] = y1;
+    ps[3] = y2;
+    pc += 5;
+    ps += 4;
+    in = pDst;
+  }
+}
+
+/**
+  * @brief  Initialize a float biquad cascade, its state cleared.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_F32_TypeDef structure.
+  * @param  NumStages Second order sections, at least 1.
+  * @param  pCoeffs 5 coefficients per stage.
+  * @param  pState 2 values per stage.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_BIQUAD_F32_Init(BSP_DSP_BIQUAD_F32_TypeDef *hbiq, uint32_t NumStages,
+                                          const float *pCoeffs, float *pState)
+{
+  if ((hbiq == NULL) || (NumStages == 0U) || (pCoeffs == NULL) || (pState == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  hbiq->NumStages = NumStages;
+  hbiq->pCoeffs   = pCoeffs;
+  hbiq->pState    = pState;
+  (void)memset(pState, 0, NumStages * 2U * sizeof(float));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Filter a block of float samples through the cascade.
+  * @param  hbiq Pointer to a BSP_DSP_BIQUAD_F32_TypeDef structure.
+  * @param  pSrc Input samples.
+  * @param  pDst Output samples, pSrc allowed.
+  * @param  BlockSize Samples.
+  * @retval None
+  */
+void BSP_DSP_BIQUAD_F32_Process(BSP_DSP_BIQUAD_F32_TypeDef *hbiq, const float *pSrc, float *pDst,
+                                uint32_t BlockSize)
+{
+  const float *pc = hbiq->pCoeffs;
+  float *ps = hbiq->pState;
+  const float *in = pSrc;
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+  float d1;
+  float d2;
+  float x0;
+  float y0;
+  uint32_t stage;
+  uint32_t n;
+
+  for (stage = hbiq->NumStages; stage > 0U; stage--)
+  {
+    b0 = pc[0];
+    b1 = pc[1];
+    b2 = pc[2];
+    a1 = pc[3];
+    a2 = pc[4];
+    d1 = ps[0];
+    d2 = ps[1];
+
+    for (n = 0U; n < BlockSize; n++)
+    {
+      x0 = in[n];
+      y0 = (b0 * x0) + d1;
+      d1 = (b1 * x0) + (a1 * y0) + d2;
+      d2 = (b2 * x0) + (a2 * y0);
+      pDst[n] = y0;
+    }
+
+    ps[0] = d1;
+    ps[1] = d2;
+    pc += 5;
+    ps += 2;
+    in = pDst;
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DSP_Exported_Functions_Group2 Transform functions
+  * @brief    Transform functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Transform functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Build the twiddle factors of a transform length
+      (+) Run a forward or inverse complex FFT in place
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a Q15 FFT and build its twiddle factors.
+  * @param  hfft Pointer to a BSP_DSP_FFT_Q15_TypeDef structure.
+  * @param  Length Complex points, a power of 4 from BSP_DSP_FFT_LENGTH_MIN to BSP_DSP_FFT_LENGTH_MAX.
+  * @param  pTwiddle Buffer of 3 Length / 2 values, word aligned.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FFT_Q15_Init(BSP_DSP_FFT_Q15_TypeDef *hfft, uint32_t Length, int16_t *pTwiddle)
+{
+  uint32_t log2 = DSP_FFT_Log2(Length);
+  float angle;
+  int32_t value;
+  uint32_t k;
+  uint32_t i;
+
+  if ((hfft == NULL) || (pTwiddle == NULL) || (log2 == 0U) || (((uint32_t)pTwiddle & 3U) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* W^k = cos - j sin, rounded and kept within the Q15 range */
+  for (k = 0U; k < ((3U * Length) / 4U); k++)
+  {
+    angle = (2.0f * DSP_PI * (float)k) / (float)Length;
+    for (i = 0U; i < 2U; i++)
+    {
+      value = (int32_t)lroundf(((i == 0U) ? cosf(angle) : -sinf(angle)) * 32768.0f);
+      pTwiddle[(2U * k) + i] = (int16_t)((value > DSP_Q15_ONE) ? DSP_Q15_ONE :
+                                         ((value < -DSP_Q15_ONE) ? -DSP_Q15_ONE : value));
+    }
+  }
+
+  hfft->Length     = Length;
+  hfft->Log2Length = log2;
+  hfft->pTwiddle   = pTwiddle;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run a Q15 FFT in place, the result divided by Length.
+  * @param  hfft Pointer to a BSP_DSP_FFT_Q15_TypeDef structure.
+  * @param  pData Length complex points, real part first, word aligned.
+  * @param  Direction A value of @ref BSP_DSP_FFT_Direction.
+  * @retval None
+  */
+void BSP_DSP_FFT_Q15_Process(const BSP_DSP_FFT_Q15_TypeDef *hfft, int16_t *pData, uint32_t Direction)
+{
+  uint32_t *data = (uint32_t *)pData;
+  uint32_t length = hfft->Length;
+  uint32_t reverse;
+  uint32_t tmp;
+  uint32_t i;
+
+  /* Inverse: forward transform of the exchanged parts, exchanged back */
+  if (Direction == BSP_DSP_FFT_INVERSE)
+  {
+    for (i = 0U; i < length; i++)
+    {
+      data[i] = __ROR(data[i], 16U);
+    }
+  }
+
+  DSP_FFT_Q15_Stages(data, (const uint32_t *)hfft->pTwiddle, length);
+
+  for (i = 0U; i < length; i++)
+  {
+    reverse = DSP_DigitReverse(i, hfft->Log2Length);
+    if (i < reverse)
+    {
+      tmp           = data[i];
+      data[i]       = data[reverse];
+      data[reverse] = tmp;
+    }
+    if ((Direction == BSP_DSP_FFT_INVERSE) && (i <= reverse))
+    {
+      data[i] = __ROR(data[i], 16U);
+      if (i != reverse)
+      {
+        data[reverse] = __ROR(data[reverse], 16U);
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Initialize a Q31 FFT and build its twiddle factors.
+  * @param  hfft Pointer to a BSP_DSP_FFT_Q31_TypeDef structure.
+  * @param  Length Complex points, a power of 4 from BSP_DSP_FFT_LENGTH_MIN to BSP_DSP_FFT_LENGTH_MAX.
+  * @param  pTwiddle Buffer of 3 Length / 2 values.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FFT_Q31_Init(BSP_DSP_FFT_Q31_TypeDef *hfft, uint32_t Length, int32_t *pTwiddle)
+{
+  uint32_t log2 = DSP_FFT_Log2(Length);
+  float angle;
+  float value;
+  uint32_t k;
+  uint32_t i;
+
+  if ((hfft == NULL) || (pTwiddle == NULL) || (log2 == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (k = 0U; k < ((3U * Length) / 4U); k++)
+  {
+    angle = (2.0f * DSP_PI * (float)k) / (float)Length;
+    for (i = 0U; i < 2U; i++)
+    {
+      value = ((i == 0U) ? cosf(angle) : -sinf(angle)) * 2147483648.0f;
+      pTwiddle[(2U * k) + i] = (value >= 2147483647.0f) ? DSP_Q31_ONE :
+                               ((value <= -2147483647.0f) ? -DSP_Q31_ONE : (int32_t)lroundf(value));
+    }
+  }
+
+  hfft->Length     = Length;
+  hfft->Log2Length = log2;
+  hfft->pTwiddle   = pTwiddle;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run a Q31 FFT in place, the result divided by Length.
+  * @param  hfft Pointer to a BSP_DSP_FFT_Q31_TypeDef structure.
+  * @param  pData Length complex points, real part first.
+  * @param  Direction A value of @ref BSP_DSP_FFT_Direction.
+  * @retval None
+  */
+void BSP_DSP_FFT_Q31_Process(const BSP_DSP_FFT_Q31_TypeDef *hfft, int32_t *pData, uint32_t Direction)
+{
+  uint32_t length = hfft->Length;
+  uint32_t reverse;
+  int32_t re;
+  int32_t im;
+  uint32_t i;
+
+  if (Direction == BSP_DSP_FFT_INVERSE)
+  {
+    for (i = 0U; i < length; i++)
+    {
+      re                   = pData[2U * i];
+      pData[2U * i]        = pData[(2U * i) + 1U];
+      pData[(2U * i) + 1U] = re;
+    }
+  }
+
+  DSP_FFT_Q31_Stages(pData, hfft->pTwiddle, length);
+
+  /* Natural order, parts exchanged back for the inverse */
+  for (i = 0U; i < length; i++)
+  {
+    reverse = DSP_DigitReverse(i, hfft->Log2Length);
+    if (i <= reverse)
+    {
+      re = pData[2U * i];
+      im = pData[(2U * i) + 1U];
+      if (Direction == BSP_DSP_FFT_INVERSE)
+      {
+        pData[2U * i]              = pData[(2U * reverse) + 1U];
+        pData[(2U * i) + 1U]       = pData[2U * reverse];
+        pData[2U * reverse]        = im;
+        pData[(2U * reverse) + 1U] = re;
+      }
+      else
+      {
+        pData[2U * i]              = pData[2U * reverse];
+        pData[(2U * i) + 1U]       = pData[(2U * reverse) + 1U];
+        pData[2U * reverse]        = re;
+        pData[(2U * reverse) + 1U] = im;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Initialize a float FFT and build its twiddle factors.
+  * @param  hfft Pointer to a BSP_DSP_FFT_F32_TypeDef structure.
+  * @param  Length Complex points, a power of 4 from BSP_DSP_FFT_LENGTH_MIN to BSP_DSP_FFT_LENGTH_MAX.
+  * @param  pTwiddle Buffer of 3 Length / 2 values.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DSP_FFT_F32_Init(BSP_DSP_FFT_F32_TypeDef *hfft, uint32_t Length, float *pTwiddle)
+{
+  uint32_t log2 = DSP_FFT_Log2(Length);
+  float angle;
+  uint32_t k;
+
+  if ((hfft == NULL) || (pTwiddle == NULL) || (log2 == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (k = 0U; k < ((3U * Length) / 4U); k++)
+  {
+    angle = (2.0f * DSP_PI * (float)k) / (float)Length;
+    pTwiddle[2U * k]        = cosf(angle);
+    pTwiddle[(2U * k) + 1U] = -sinf(angle);
+  }
+
+  hfft->Length     = Length;
+  hfft->Log2Length = log2;
+  hfft->pTwiddle   = pTwiddle;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run a float FFT in place, the inverse divided by Length.
+  * @param  hfft Pointer to a BSP_DSP_FFT_F32_TypeDef structure.
+  * @param  pData Length complex points, real part first.
+  * @param  Direction A value of @ref BSP_DSP_FFT_Direction.
+  * @retval None
+  */
+void BSP_DSP_FFT_F32_Process(const BSP_DSP_FFT_F32_TypeDef *hfft, float *pData, uint32_t Direction)
+{
+  uint32_t length = hfft->Length;
+  float scale = 1.0f / (float)length;
+  uint32_t reverse;
+  float re;
+  float im;
+  uint32_t i;
+
+  if (Direction == BSP_DSP_FFT_INVERSE)
+  {
+    for (i = 0U; i < length; i++)
+    {
+      re                   = pData[2U * i];
+      pData[2U * i]        = pData[(2U * i) + 1U];
+      pData[(2U * i) + 1U] = re;
+    }
+  }
+
+  DSP_FFT_F32_Stages(pData, hfft->pTwiddle, length);
+
+  for (i = 0U; i < length; i++)
+  {
+    reverse = DSP_DigitReverse(i, hfft->Log2Length);
+    if (i <= reverse)
+    {
+      re = pData[2U * i];
+      im = pData[(2U * i) + 1U];
+      if (Direction == BSP_DSP_FFT_INVERSE)
+      {
+        /* The pair of i, written last, also covers i == reverse */
+        pData[2U * i]              = pData[(2U * reverse) + 1U] * scale;
+        pData[(2U * i) + 1U]       = pData[2U * reverse] * scale;
+        pData[2U * reverse]        = im * scale;
+        pData[(2U * reverse) + 1U] = re * scale;
+      }
+      else
+      {
+        pData[2U * i]              = pData[2U * reverse];
+        pData[(2U * i) + 1U]       = pData[(2U * reverse) + 1U];
+        pData[2U * reverse]        = re;
+        pData[(2U * reverse) + 1U] = im;
+      }
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DSP_Exported_Functions_Group3 Statistics functions
+  * @brief    Statistics functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Statistics functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Compute the dot product of two vectors
+      (+) Compute the root mean square of a vector
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Dot product of two Q15 vectors.
+  * @param  pSrcA First vector.
+  * @param  pSrcB Second vector.
+  * @param  Length Samples of each vector.
+  * @retval Sum of the products, 34.30
+  */
+int64_t BSP_DSP_Dot_Q15(const int16_t *pSrcA, const int16_t *pSrcB, uint32_t Length)
+{
+  int64_t acc = 0;
+  uint32_t k;
+
+  for (k = Length >> 1; k > 0U; k--)
+  {
+    acc = __SMLALD(DSP_READ_Q15X2(pSrcA), DSP_READ_Q15X2(pSrcB), acc);
+    pSrcA += 2;
+    pSrcB += 2;
+  }
+  if ((Length & 1U) != 0U)
+  {
+    acc += (int32_t)*pSrcA * *pSrcB;
+  }
+
+  return acc;
+}
+
+/**
+  * @brief  Dot product of two Q31 vectors.
+  * @param  pSrcA First vector.
+  * @param  pSrcB Second vector.
+  * @param  Length Samples of each vector, up to 0x7FFF without overflow.
+  * @retval Sum of the products, 16.48
+  */
+int64_t BSP_DSP_Dot_Q31(const int32_t *pSrcA, const int32_t *pSrcB, uint32_t Length)
+{
+  int64_t acc = 0;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    acc += ((int64_t)*pSrcA++ * *pSrcB++) >> 14;
+  }
+
+  return acc;
+}
+
+/**
+  * @brief  Dot product of two float vectors.
+  * @param  pSrcA First vector.
+  * @param  pSrcB Second vector.
+  * @param  Length Samples of each vector.
+  * @retval Sum of the products
+  */
+float BSP_DSP_Dot_F32(const float *pSrcA, const float *pSrcB, uint32_t Length)
+{
+  float acc = 0.0f;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    acc += *pSrcA++ * *pSrcB++;
+  }
+
+  return acc;
+}
+
+/**
+  * @brief  Root mean square of a Q15 vector.
+  * @param  pSrc Vector.
+  * @param  Length Samples, at least 1.
+  * @retval RMS, Q15
+  */
+int16_t BSP_DSP_RMS_Q15(const int16_t *pSrc, uint32_t Length)
+{
+  int64_t acc = 0;
+  uint32_t pair;
+  uint32_t root;
+  uint32_t k;
+
+  for (k = Length >> 1; k > 0U; k--)
+  {
+    pair = DSP_READ_Q15X2(pSrc);
+    acc = __SMLALD(pair, pair, acc);
+    pSrc += 2;
+  }
+  if ((Length & 1U) != 0U)
+  {
+    acc += (int32_t)*pSrc * *pSrc;
+  }
+
+  /* Mean of the squares in Q30, its root in Q15 */
+  root = DSP_Sqrt64((uint64_t)acc / Length);
+
+  return (int16_t)((root > (uint32_t)DSP_Q15_ONE) ? DSP_Q15_ONE : (int32_t)root);
+}
+
+/**
+  * @brief  Root mean square of a Q31 vector.
+  * @param  pSrc Vector.
+  * @param  Length Samples, 1 to 0xFFFF.
+  * @retval RMS, Q31
+  */
+int32_t BSP_DSP_RMS_Q31(const int32_t *pSrc, uint32_t Length)
+{
+  uint64_t acc = 0U;
+  uint32_t root;
+  uint32_t k;
+
+  /* Squares in Q48, 16 bits of headroom */
+  for (k = Length; k > 0U; k--)
+  {
+    acc += (uint64_t)((int64_t)*pSrc * *pSrc) >> 14;
+    pSrc++;
+  }
+
+  /* Mean back in Q62, its root in Q31 */
+  root = DSP_Sqrt64((acc / Length) << 14);
+
+  return (root > (uint32_t)DSP_Q31_ONE) ? DSP_Q31_ONE : (int32_t)root;
+}
+
+/**
+  * @brief  Root mean square of a float vector.
+  * @param  pSrc Vector.
+  * @param  Length Samples, at least 1.
+  * @retval RMS
+  */
+float BSP_DSP_RMS_F32(const float *pSrc, uint32_t Length)
+{
+  float acc = 0.0f;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    acc += *pSrc * *pSrc;
+    pSrc++;
+  }
+
+  return sqrtf(acc / (float)Length);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_DSP_Exported_Functions_Group4 Conversion functions
+  * @brief    Conversion functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Conversion functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Convert the 24 and 32 bits I2S buffers from and to Q31
+      (+) Convert between the fixed point formats and float
+      (+) Split a stereo buffer into two channels and merge them back
+      (+) Apply a gain
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Convert an I2S buffer of 24 or 32 bits samples to Q31.
+  * @note   The I2S gives a sample as two halfwords, the most significant
+  *         first: the words read back have their halves swapped. 24 bits
+  *         samples come left aligned, in Q31 as well. pDst can be the
+  *         buffer of pSrc.
+  * @param  pSrc Buffer of the I2S DMA, 2 x Length halfwords.
+  * @param  pDst Length samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_I2S_ToQ31(const uint16_t *pSrc, int32_t *pDst, uint32_t Length)
+{
+  uint32_t k;
+
+  for (k = Length >> 1; k > 0U; k--)
+  {
+    pDst[0] = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&pSrc[0]), 16U);
+    pDst[1] = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&pSrc[2]), 16U);
+    pSrc += 4;
+    pDst += 2;
+  }
+  if ((Length & 1U) != 0U)
+  {
+    *pDst = (int32_t)__ROR(__UNALIGNED_UINT32_READ(pSrc), 16U);
+  }
+}
+
+/**
+  * @brief  Convert Q31 samples to an I2S buffer of 24 or 32 bits samples.
+  * @note   The I2S drops the 8 least significant bits in 24 bits. pDst can be
+  *         the buffer of pSrc.
+  * @param  pSrc Length samples.
+  * @param  pDst Buffer of the I2S DMA, 2 x Length halfwords.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Q31_ToI2S(const int32_t *pSrc, uint16_t *pDst, uint32_t Length)
+{
+  uint32_t k;
+
+  for (k = Length >> 1; k > 0U; k--)
+  {
+    __UNALIGNED_UINT32_WRITE(&pDst[0], __ROR((uint32_t)pSrc[0], 16U));
+    __UNALIGNED_UINT32_WRITE(&pDst[2], __ROR((uint32_t)pSrc[1], 16U));
+    pSrc += 2;
+    pDst += 4;
+  }
+  if ((Length & 1U) != 0U)
+  {
+    __UNALIGNED_UINT32_WRITE(pDst, __ROR((uint32_t)*pSrc, 16U));
+  }
+}
+
+/**
+  * @brief  Convert Q15 samples to float.
+  * @param  pSrc Samples.
+  * @param  pDst Samples, in [-1, 1).
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Q15_ToF32(const int16_t *pSrc, float *pDst, uint32_t Length)
+{
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    *pDst++ = (float)*pSrc++ * (1.0f / 32768.0f);
+  }
+}
+
+/**
+  * @brief  Convert float samples to Q15, saturated.
+  * @param  pSrc Samples.
+  * @param  pDst Samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_F32_ToQ15(const float *pSrc, int16_t *pDst, uint32_t Length)
+{
+  float value;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    /* Bounded first, the conversion of a float out of range is undefined */
+    value = *pSrc++ * 32768.0f;
+    value = (value > 32767.0f) ? 32767.0f : ((value < -32768.0f) ? -32768.0f : value);
+    *pDst++ = (int16_t)value;
+  }
+}
+
+/**
+  * @brief  Convert Q31 samples to float.
+  * @note   pDst can be the buffer of pSrc.
+  * @param  pSrc Samples.
+  * @param  pDst Samples, in [-1, 1).
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Q31_ToF32(const int32_t *pSrc, float *pDst, uint32_t Length)
+{
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    *pDst++ = (float)*pSrc++ * (1.0f / 2147483648.0f);
+  }
+}
+
+/**
+  * @brief  Convert float samples to Q31, saturated.
+  * @note   pDst can be the buffer of pSrc.
+  * @param  pSrc Samples.
+  * @param  pDst Samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_F32_ToQ31(const float *pSrc, int32_t *pDst, uint32_t Length)
+{
+  float value;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    /* 2^31 is the first float out of range, 2^31 - 1 has no float */
+    value = *pSrc++ * 2147483648.0f;
+    *pDst++ = (value >= 2147483648.0f) ? DSP_Q31_ONE :
+              ((value <= -2147483648.0f) ? (-DSP_Q31_ONE - 1) : (int32_t)value);
+  }
+}
+
+/**
+  * @brief  Split a stereo Q15 buffer into its two channels.
+  * @note   Two frames per step: __PKHBT gathers the left samples of two
+  *         words, __PKHTB the right ones.
+  * @param  pSrc Frames, left sample first, 2 x Frames samples.
+  * @param  pLeft Frames samples.
+  * @param  pRight Frames samples.
+  * @param  Frames Stereo frames.
+  * @retval None
+  */
+void BSP_DSP_Deinterleave_Q15(const int16_t *pSrc, int16_t *pLeft, int16_t *pRight, uint32_t Frames)
+{
+  uint32_t w0;
+  uint32_t w1;
+  uint32_t k;
+
+  for (k = Frames >> 1; k > 0U; k--)
+  {
+    w0 = DSP_READ_Q15X2(&pSrc[0]);
+    w1 = DSP_READ_Q15X2(&pSrc[2]);
+    __UNALIGNED_UINT32_WRITE(pLeft, __PKHBT(w0, w1, 16));
+    __UNALIGNED_UINT32_WRITE(pRight, __PKHTB(w1, w0, 16));
+    pSrc   += 4;
+    pLeft  += 2;
+    pRight += 2;
+  }
+  if ((Frames & 1U) != 0U)
+  {
+    *pLeft  = pSrc[0];
+    *pRight = pSrc[1];
+  }
+}
+
+/**
+  * @brief  Merge two Q15 channels into a stereo buffer.
+  * @param  pLeft Frames samples.
+  * @param  pRight Frames samples.
+  * @param  pDst Frames, left sample first, 2 x Frames samples.
+  * @param  Frames Stereo frames.
+  * @retval None
+  */
+void BSP_DSP_Interleave_Q15(const int16_t *pLeft, const int16_t *pRight, int16_t *pDst, uint32_t Frames)
+{
+  uint32_t l;
+  uint32_t r;
+  uint32_t k;
+
+  for (k = Frames >> 1; k > 0U; k--)
+  {
+    l = DSP_READ_Q15X2(pLeft);
+    r = DSP_READ_Q15X2(pRight);
+    __UNALIGNED_UINT32_WRITE(&pDst[0], __PKHBT(l, r, 16));
+    __UNALIGNED_UINT32_WRITE(&pDst[2], __PKHTB(r, l, 16));
+    pLeft  += 2;
+    pRight += 2;
+    pDst   += 4;
+  }
+  if ((Frames & 1U) != 0U)
+  {
+    pDst[0] = *pLeft;
+    pDst[1] = *pRight;
+  }
+}
+
+/**
+  * @brief  Split a stereo Q31 buffer into its two channels.
+  * @param  pSrc Frames, left sample first, 2 x Frames samples.
+  * @param  pLeft Frames samples.
+  * @param  pRight Frames samples.
+  * @param  Frames Stereo frames.
+  * @retval None
+  */
+void BSP_DSP_Deinterleave_Q31(const int32_t *pSrc, int32_t *pLeft, int32_t *pRight, uint32_t Frames)
+{
+  uint32_t k;
+
+  for (k = Frames >> 1; k > 0U; k--)
+  {
+    pLeft[0]  = pSrc[0];
+    pRight[0] = pSrc[1];
+    pLeft[1]  = pSrc[2];
+    pRight[1] = pSrc[3];
+    pSrc   += 4;
+    pLeft  += 2;
+    pRight += 2;
+  }
+  if ((Frames & 1U) != 0U)
+  {
+    *pLeft  = pSrc[0];
+    *pRight = pSrc[1];
+  }
+}
+
+/**
+  * @brief  Merge two Q31 channels into a stereo buffer.
+  * @param  pLeft Frames samples.
+  * @param  pRight Frames samples.
+  * @param  pDst Frames, left sample first, 2 x Frames samples.
+  * @param  Frames Stereo frames.
+  * @retval None
+  */
+void BSP_DSP_Interleave_Q31(const int32_t *pLeft, const int32_t *pRight, int32_t *pDst, uint32_t Frames)
+{
+  uint32_t k;
+
+  for (k = Frames >> 1; k > 0U; k--)
+  {
+    pDst[0] = pLeft[0];
+    pDst[1] = pRight[0];
+    pDst[2] = pLeft[1];
+    pDst[3] = pRight[1];
+    pLeft  += 2;
+    pRight += 2;
+    pDst   += 4;
+  }
+  if ((Frames & 1U) != 0U)
+  {
+    pDst[0] = *pLeft;
+    pDst[1] = *pRight;
+  }
+}
+
+/**
+  * @brief  Multiply Q15 samples by a gain, saturated.
+  * @note   pDst can be the buffer of pSrc.
+  * @param  pSrc Samples.
+  * @param  Gain Q15 gain.
+  * @param  Shift Left shift after the product, 0 to 15: the gain is
+  *               Gain x 2^Shift.
+  * @param  pDst Samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Scale_Q15(const int16_t *pSrc, int16_t Gain, uint32_t Shift, int16_t *pDst, uint32_t Length)
+{
+  uint32_t right = 15U - Shift;
+  uint32_t pair;
+  int32_t lo;
+  int32_t hi;
+  uint32_t k;
+
+  for (k = Length >> 1; k > 0U; k--)
+  {
+    pair = DSP_READ_Q15X2(pSrc);
+    lo = __SSAT(((int32_t)(int16_t)pair * Gain) >> right, 16);
+    hi = __SSAT(((int32_t)(int16_t)(pair >> 16) * Gain) >> right, 16);
+    __UNALIGNED_UINT32_WRITE(pDst, __PKHBT((uint32_t)lo, (uint32_t)hi, 16));
+    pSrc += 2;
+    pDst += 2;
+  }
+  if ((Length & 1U) != 0U)
+  {
+    *pDst = (int16_t)__SSAT(((int32_t)*pSrc * Gain) >> right, 16);
+  }
+}
+
+/**
+  * @brief  Multiply Q31 samples by a gain, saturated.
+  * @note   pDst can be the buffer of pSrc.
+  * @param  pSrc Samples.
+  * @param  Gain Q31 gain.
+  * @param  Shift Left shift after the product, 0 to 31: the gain is
+  *               Gain x 2^Shift.
+  * @param  pDst Samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Scale_Q31(const int32_t *pSrc, int32_t Gain, uint32_t Shift, int32_t *pDst, uint32_t Length)
+{
+  uint32_t right = 31U - Shift;
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    *pDst++ = DSP_SatQ31(((int64_t)*pSrc++ * Gain) >> right);
+  }
+}
+
+/**
+  * @brief  Multiply float samples by a gain.
+  * @note   pDst can be the buffer of pSrc.
+  * @param  pSrc Samples.
+  * @param  Gain Gain.
+  * @param  pDst Samples.
+  * @param  Length Samples.
+  * @retval None
+  */
+void BSP_DSP_Scale_F32(const float *pSrc, float Gain, float *pDst, uint32_t Length)
+{
+  uint32_t k;
+
+  for (k = Length; k > 0U; k--)
+  {
+    *pDst++ = *pSrc++ * Gain;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DSP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  log2 of an FFT length.
+  * @param  Length Complex points.
+  * @retval log2(Length), 0 when Length is not a supported power of 4
+  */
+static uint32_t DSP_FFT_Log2(uint32_t Length)
+{
+  uint32_t log2;
+
+  if ((Length < BSP_DSP_FFT_LENGTH_MIN) || (Length > BSP_DSP_FFT_LENGTH_MAX) ||
+      ((Length & (Length - 1U)) != 0U))
+  {
+    return 0U;
+  }
+
+  log2 = 31U - __CLZ(Length);
+
+  return ((log2 & 1U) == 0U) ? log2 : 0U;
+}
+
+/**
+  * @brief  Saturate to the Q31 range.
+  * @param  Value Value to saturate.
+  * @retval Saturated value
+  */
+static int32_t DSP_SatQ31(int64_t Value)
+{
+  if (Value > (int64_t)DSP_Q31_ONE)
+  {
+    return DSP_Q31_ONE;
+  }
+  if (Value < -(int64_t)DSP_Q31_ONE - 1)
+  {
+    return -DSP_Q31_ONE - 1;
+  }
+
+  return (int32_t)Value;
+}
+
+/**
+  * @brief  Integer square root.
+  * @param  Value Radicand.
+  * @retval Largest integer whose square does not exceed Value
+  */
+static uint32_t DSP_Sqrt64(uint64_t Value)
+{
+  uint64_t root = 0U;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > Value)
+  {
+    bit >>= 2;
+  }
+  while (bit != 0U)
+  {
+    if (Value >= (root + bit))
+    {
+      Value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return (uint32_t)root;
+}
+
+/**
+  * @brief  Base 4 digit reversal of an index.
+  * @note   The bit reversal of __RBIT with the two bits of each digit swapped back.
+  * @param  Index Index, below 2^Log2Length.
+  * @param  Log2Length Bits of the index, even.
+  * @retval Reversed index
+  */
+static uint32_t DSP_DigitReverse(uint32_t Index, uint32_t Log2Length)
+{
+  uint32_t reverse = __RBIT(Index);
+
+  reverse = ((reverse >> 1) & 0x55555555U) | ((reverse & 0x55555555U) << 1);
+
+  return reverse >> (32U - Log2Length);
+}
+
+/**
+  * @brief  Radix 4 decimation in frequency stages of a Q15 forward FFT.
+  * @note   Each butterfly halves twice with the halving additions, the
+  *         outputs are in digit reversed order.
+  * @param  pData Length packed complex points, real part in the low halfword.
+  * @param  pTwiddle Packed twiddle factors.
+  * @param  Length Complex points.
+  * @retval None
+  */
+static void DSP_FFT_Q15_Stages(uint32_t *pData, const uint32_t *pTwiddle, uint32_t Length)
+{
+  uint32_t n1;
+  uint32_t n2;
+  uint32_t step;
+  uint32_t i;
+  uint32_t j;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  uint32_t y1;
+  uint32_t y2;
+  uint32_t y3;
+  uint32_t w1;
+  uint32_t w2;
+  uint32_t w3;
+
+  for (n2 = Length; n2 > 1U; n2 >>= 2)
+  {
+    n1   = n2 >> 2;
+    step = Length / n2;
+
+    for (j = 0U; j < n1; j++)
+    {
+      w1 = pTwiddle[j * step];
+      w2 = pTwiddle[2U * j * step];
+      w3 = pTwiddle[3U * j * step];
+
+      for (i = j; i < Length; i += n2)
+      {
+        a = pData[i];
+        b = pData[i + n1];
+        c = pData[i + (2U * n1)];
+        d = pData[i + (3U * n1)];
+
+        t0 = __SHADD16(a, c);
+        t1 = __SHSUB16(a, c);
+        t2 = __SHADD16(b, d);
+        t3 = __SHSUB16(b, d);
+
+        pData[i] = __SHADD16(t0, t2);
+        y2 = __SHSUB16(t0, t2);
+        y1 = __SHSAX(t1, t3);                      /* (t1 - j t3) / 2 */
+        y3 = __SHASX(t1, t3);                      /* (t1 + j t3) / 2 */
+
+        if (j == 0U)
+        {
+          /* Twiddles of 1, the products are skipped */
+          pData[i + n1]        = y1;
+          pData[i + (2U * n1)] = y2;
+          pData[i + (3U * n1)] = y3;
+        }
+        else
+        {
+          /* (yr wr - yi wi) + j (yr wi + yi wr), Q30 back to Q15 */
+          pData[i + n1]        = __PKHBT((uint32_t)(__SMUSD(y1, w1) >> 15), (uint32_t)(__SMUADX(y1, w1) >> 15), 16);
+          pData[i + (2U * n1)] = __PKHBT((uint32_t)(__SMUSD(y2, w2) >> 15), (uint32_t)(__SMUADX(y2, w2) >> 15), 16);
+          pData[i + (3U * n1)] = __PKHBT((uint32_t)(__SMUSD(y3, w3) >> 15), (uint32_t)(__SMUADX(y3, w3) >> 15), 16);
+        }
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Radix 4 decimation in frequency stages of a Q31 forward FFT.
+  * @param  pData Length complex points, real part first.
+  * @param  pTwiddle Twiddle factors.
+  * @param  Length Complex points.
+  * @retval None
+  */
+static void DSP_FFT_Q31_Stages(int32_t *pData, const int32_t *pTwiddle, uint32_t Length)
+{
+  int32_t *pa;
+  int32_t *pb;
+  int32_t *pc;
+  int32_t *pd;
+  const int32_t *pw;
+  int32_t t0r;
+  int32_t t0i;
+  int32_t t1r;
+  int32_t t1i;
+  int32_t t2r;
+  int32_t t2i;
+  int32_t t3r;
+  int32_t t3i;
+  int32_t yr[3];
+  int32_t yi[3];
+  uint32_t n1;
+  uint32_t n2;
+  uint32_t step;
+  uint32_t i;
+  uint32_t j;
+  uint32_t r;
+
+  for (n2 = Length; n2 > 1U; n2 >>= 2)
+  {
+    n1   = n2 >> 2;
+    step = Length / n2;
+
+    for (j = 0U; j < n1; j++)
+    {
+      for (i = j; i < Length; i += n2)
+      {
+        pa = &pData[2U * i];
+        pb = &pData[2U * (i + n1)];
+        pc = &pData[2U * (i + (2U * n1))];
+        pd = &pData[2U * (i + (3U * n1))];
+
+        t0r = (pa[0] >> 1) + (pc[0] >> 1);
+        t0i = (pa[1] >> 1) + (pc[1] >> 1);
+        t1r = (pa[0] >> 1) - (pc[0] >> 1);
+        t1i = (pa[1] >> 1) - (pc[1] >> 1);
+        t2r = (pb[0] >> 1) + (pd[0] >> 1);
+        t2i = (pb[1] >> 1) + (pd[1] >> 1);
+        t3r = (pb[0] >> 1) - (pd[0] >> 1);
+        t3i = (pb[1] >> 1) - (pd[1] >> 1);
+
+        pa[0] = (t0r >> 1) + (t2r >> 1);
+        pa[1] = (t0i >> 1) + (t2i >> 1);
+        yr[0] = (t1r >> 1) + (t3i >> 1);           /* (t1 - j t3) / 2 */
+        yi[0] = (t1i >> 1) - (t3r >> 1);
+        yr[1] = (t0r >> 1) - (t2r >> 1);
+        yi[1] = (t0i >> 1) - (t2i >> 1);
+        yr[2] = (t1r >> 1) - (t3i >> 1);           /* (t1 + j t3) / 2 */
+        yi[2] = (t1i >> 1) + (t3r >> 1);
+
+        if (j != 0U)
+        {
+          for (r = 0U; r < 3U; r++)
+          {
+            pw = &pTwiddle[2U * (r + 1U) * j * step];
+            t0r = (int32_t)((((int64_t)yr[r] * pw[0]) - ((int64_t)yi[r] * pw[1])) >> 31);
+            yi[r] = (int32_t)((((int64_t)yr[r] * pw[1]) + ((int64_t)yi[r] * pw[0])) >> 31);
+            yr[r] = t0r;
+          }
+        }
+
+        pb[0] = yr[0];
+        pb[1] = yi[0];
+        pc[0] = yr[1];
+        pc[1] = yi[1];
+        pd[0] = yr[2];
+        pd[1] = yi[2];
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Radix 4 decimation in frequency stages of a float forward FFT.
+  * @param  pData Length complex points, real part first.
+  * @param  pTwiddle Twiddle factors.
+  * @param  Length Complex points.
+  * @retval None
+  */
+static void DSP_FFT_F32_Stages(float *pData, const float *pTwiddle, uint32_t Length)
+{
+  float *pa;
+  float *pb;
+  float *pc;
+  float *pd;
+  const float *pw;
+  float t0r;
+  float t0i;
+  float t1r;
+  float t1i;
+  float t2r;
+  float t2i;
+  float t3r;
+  float t3i;
+  float yr[3];
+  float yi[3];
+  uint32_t n1;
+  uint32_t n2;
+  uint32_t step;
+  uint32_t i;
+  uint32_t j;
+  uint32_t r;
+
+  for (n2 = Length; n2 > 1U; n2 >>= 2)
+  {
+    n1   = n2 >> 2;
+    step = Length / n2;
+
+    for (j = 0U; j < n1; j++)
+    {
+      for (i = j; i < Length; i += n2)
+      {
+        pa = &pData[2U * i];
+        pb = &pData[2U * (i + n1)];
+        pc = &pData[2U * (i + (2U * n1))];
+        pd = &pData[2U * (i + (3U * n1))];
+
+        t0r = pa[0] + pc[0];
+        t0i = pa[1] + pc[1];
+        t1r = pa[0] - pc[0];
+        t1i = pa[1] - pc[1];
+        t2r = pb[0] + pd[0];
+        t2i = pb[1] + pd[1];
+        t3r = pb[0] - pd[0];
+        t3i = pb[1] - pd[1];
+
+        pa[0] = t0r + t2r;
+        pa[1] = t0i + t2i;
+        yr[0] = t1r + t3i;                         /* t1 - j t3 */
+        yi[0] = t1i - t3r;
+        yr[1] = t0r - t2r;
+        yi[1] = t0i - t2i;
+        yr[2] = t1r - t3i;                         /* t1 + j t3 */
+        yi[2] = t1i + t3r;
+
+        if (j != 0U)
+        {
+          for (r = 0U; r < 3U; r++)
+          {
+            pw = &pTwiddle[2U * (r + 1U) * j * step];
+            t0r   = (yr[r] * pw[0]) - (yi[r] * pw[1]);
+            yi[r] = (yr[r] * pw[1]) + (yi[r] * pw[0]);
+            yr[r] = t0r;
+          }
+        }
+
+        pb[0] = yr[0];
+        pb[1] = yi[0];
+        pc[0] = yr[1];
+        pc[1] = yi[1];
+        pd[0] = yr[2];
+        pd[1] = yi[2];
+      }
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
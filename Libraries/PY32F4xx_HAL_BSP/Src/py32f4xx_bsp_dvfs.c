@@ -0,0 +1,624 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_dvfs.c
+  * @author  MCU Application Team
+  * @brief   DVFS governor BSP service.
+  *          This file provides functions to scale the clock and the core
+  *          voltage with the CPU load:
+  *           + Operating points of PLL, bus dividers, flash latency and
+  *             regulator voltage
+  *           + Switches in the order of the voltage raise or drop
+  *           + CPU load from the idle time accounting
+  *           + Governor going up to the fastest point on load, down to the
+  *             slowest point carrying it
+  *           + Notifiers and callbacks around a switch for the peripheral
+  *             timings
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Describe the operating points in a const table, slowest HCLK first:
+       RCC_PLLInitTypeDef and RCC_ClkInitTypeDef as for HAL_RCC_OscConfig()
+       and HAL_RCC_ClockConfig(), the flash latency or FLASH_LATENCY_AUTO,
+       and the lowest regulator voltage the HCLK of the point runs at.
+       The HSE of the points is started at the startup, this service does
+       not start or stop it.
+
+   (#) Call BSP_DVFS_Init() with the table and the point to start on. The
+       switch to a point:
+       (+) raises the voltage first when the point needs more, and waits
+           BSP_DVFS_VOS_SETTLE us,
+       (+) puts SYSCLK on HSI when the PLL of the point differs from the
+           one running, then programs the PLL again,
+       (+) applies the SYSCLK source and the dividers with
+           HAL_RCC_ClockConfig(), the flash latency raised before a faster
+           HCLK and lowered after a slower one, SystemCoreClock and the
+           tick updated,
+       (+) stops the PLL when the point has RCC_PLL_OFF,
+       (+) lowers the voltage last when the point needs less.
+       BSP_DVFS_SetPoint() switches by hand.
+
+   (#) The notifiers of the BSP CLKSWITCH service run around a switch: the
+       UART baudrates, SPI prescalers, I2C speeds and TIM prescalers
+       registered are derived again from PCLK1 and PCLK2, and a notifier
+       with a transfer running defers the switch, the governor trying again
+       on the next window. BSP_DVFS_PreChangeCallback() runs before a
+       switch and BSP_DVFS_PostChangeCallback() after it for the rest, the
+       CAN bit timing with the BSP CANBIT service for instance.
+       BSP_DVFS_Lock() forbids the switches while a transfer runs, the
+       calls nest.
+
+   (#) Account the idle time: in the main loop, interrupts disabled and no
+       work left, BSP_DVFS_Idle() enters the SLEEP mode between
+       BSP_DVFS_IdleEnter() and BSP_DVFS_IdleExit(). With another idle,
+       BSP_TICKLESS_Idle() for instance, call these two around it. The time
+       is read from the tick and the SysTick counter, to the us.
+
+   (#) Call BSP_DVFS_Process() in the main loop. Every BSP_DVFS_WINDOW ms it
+       computes the load of the window, the time out of the idle. With
+       BSP_DVFS_EnableGovernor():
+       (+) from BSP_DVFS_UP_LOAD percent, the fastest point is taken at
+           once, a burst of work gets the full speed,
+       (+) below, the slowest point expected under BSP_DVFS_TARGET_LOAD
+           percent, the load scaled by the HCLK ratio, is taken when slower
+           than the current one. The governor goes down one window after
+           the load dropped and never goes up but to the fastest point.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_dvfs.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_DVFS BSP DVFS
+  * @brief DVFS governor BSP service
+  * @{
+  */
+
+#if defined (HAL_PWR_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_DVFS_Private_Constants BSP DVFS Private Constants
+  * @{
+  */
+#define DVFS_PLL_CFGR                   (RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE | RCC_CFGR_PLLMULL)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_DVFS_Private_Functions BSP DVFS Private Functions
+  * @{
+  */
+static uint32_t          DVFS_GetHCLK(const BSP_DVFS_PointTypeDef *pPoint);
+static uint32_t          DVFS_GetTime(void);
+static void              DVFS_Settle(void);
+static HAL_StatusTypeDef DVFS_Apply(BSP_DVFS_TypeDef *hdvfs, uint32_t Point);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_DVFS_Exported_Functions BSP DVFS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Check the operating points and switch to the first one.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  pPoints Operating points, slowest HCLK first, kept by the service.
+  * @param  NbPoints Number of operating points.
+  * @param  Point Operating point to start on.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_DVFS_Init(BSP_DVFS_TypeDef *hdvfs, const BSP_DVFS_PointTypeDef *pPoints,
+                                uint32_t NbPoints, uint32_t Point)
+{
+  const BSP_DVFS_PointTypeDef *ppoint;
+  uint32_t hclk = 0U;
+  uint32_t index;
+
+  if ((hdvfs == NULL) || (pPoints == NULL) || (NbPoints == 0U) || (Point >= NbPoints))
+  {
+    return HAL_ERROR;
+  }
+
+  for (index = 0U; index < NbPoints; index++)
+  {
+    ppoint = &pPoints[index];
+    if (!IS_PWR_VOLTAGE_SCALING_RANGE(ppoint->VoltageScaling) ||
+        ((ppoint->FlashLatency != FLASH_LATENCY_AUTO) && !IS_FLASH_LATENCY(ppoint->FlashLatency)) ||
+        ((ppoint->ClkInit.SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK) && (ppoint->PLL.PLLState != RCC_PLL_ON)) ||
+        (DVFS_GetHCLK(ppoint) < hclk))
+    {
+      return HAL_ERROR;
+    }
+    hclk = DVFS_GetHCLK(ppoint);
+  }
+
+  hdvfs->pPoints     = pPoints;
+  hdvfs->NbPoints    = NbPoints;
+  hdvfs->Point       = BSP_DVFS_POINT_NONE;
+  hdvfs->Governor    = 0U;
+  hdvfs->Locks       = 0U;
+  hdvfs->IdleStart   = 0U;
+  hdvfs->IdleTime    = 0U;
+  hdvfs->Load        = 0U;
+  hdvfs->Stats.Switches = 0U;
+  hdvfs->Stats.Failures = 0U;
+  hdvfs->Stats.Deferred = 0U;
+  hdvfs->Stats.Windows  = 0U;
+
+  if (DVFS_Apply(hdvfs, Point) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  hdvfs->WindowStart = DVFS_GetTime();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Switch to an operating point.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  Point Operating point.
+  * @retval HAL status, HAL_BUSY while locked or deferred by a notifier
+  */
+HAL_StatusTypeDef BSP_DVFS_SetPoint(BSP_DVFS_TypeDef *hdvfs, uint32_t Point)
+{
+  if (Point >= hdvfs->NbPoints)
+  {
+    return HAL_ERROR;
+  }
+  if (hdvfs->Locks != 0U)
+  {
+    return HAL_BUSY;
+  }
+  if (Point == hdvfs->Point)
+  {
+    return HAL_OK;
+  }
+
+  return DVFS_Apply(hdvfs, Point);
+}
+
+/**
+  * @brief  Get the current operating point.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval Operating point or BSP_DVFS_POINT_NONE
+  */
+uint32_t BSP_DVFS_GetPoint(const BSP_DVFS_TypeDef *hdvfs)
+{
+  return hdvfs->Point;
+}
+
+/**
+  * @brief  Get the HCLK of an operating point.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  Point Operating point.
+  * @retval HCLK in Hz, 0 for no point
+  */
+uint32_t BSP_DVFS_GetPointHCLK(const BSP_DVFS_TypeDef *hdvfs, uint32_t Point)
+{
+  if (Point >= hdvfs->NbPoints)
+  {
+    return 0U;
+  }
+
+  return DVFS_GetHCLK(&hdvfs->pPoints[Point]);
+}
+
+/**
+  * @brief  Let BSP_DVFS_Process() change the operating point.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_EnableGovernor(BSP_DVFS_TypeDef *hdvfs)
+{
+  hdvfs->Governor = 1U;
+}
+
+/**
+  * @brief  Keep the operating point, BSP_DVFS_Process() measures the load only.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_DisableGovernor(BSP_DVFS_TypeDef *hdvfs)
+{
+  hdvfs->Governor = 0U;
+}
+
+/**
+  * @brief  Forbid the operating point changes, the calls nest.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_Lock(BSP_DVFS_TypeDef *hdvfs)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  hdvfs->Locks++;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Allow the operating point changes again after BSP_DVFS_Lock().
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_Unlock(BSP_DVFS_TypeDef *hdvfs)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  if (hdvfs->Locks != 0U)
+  {
+    hdvfs->Locks--;
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Start an idle time.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_IdleEnter(BSP_DVFS_TypeDef *hdvfs)
+{
+  hdvfs->IdleStart = DVFS_GetTime();
+}
+
+/**
+  * @brief  End an idle time started by BSP_DVFS_IdleEnter().
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_IdleExit(BSP_DVFS_TypeDef *hdvfs)
+{
+  hdvfs->IdleTime += DVFS_GetTime() - hdvfs->IdleStart;
+}
+
+/**
+  * @brief  Enter the SLEEP mode up to an interrupt, the time accounted idle.
+  * @note   Call with the interrupts disabled once no work is left, the
+  *         interrupts stay as they were on the return.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval None
+  */
+void BSP_DVFS_Idle(BSP_DVFS_TypeDef *hdvfs)
+{
+  BSP_DVFS_IdleEnter(hdvfs);
+  HAL_PWR_EnterSLEEPMode(PWR_SLEEPENTRY_WFI);
+  BSP_DVFS_IdleExit(hdvfs);
+}
+
+/**
+  * @brief  Measure the load every BSP_DVFS_WINDOW ms and run the governor.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval Current operating point or BSP_DVFS_POINT_NONE
+  */
+uint32_t BSP_DVFS_Process(BSP_DVFS_TypeDef *hdvfs)
+{
+  uint32_t now = DVFS_GetTime();
+  uint32_t elapsed = now - hdvfs->WindowStart;
+  uint32_t target;
+  uint32_t hclk;
+  uint32_t index;
+
+  if (elapsed < (BSP_DVFS_WINDOW * 1000U))
+  {
+    return hdvfs->Point;
+  }
+
+  hdvfs->Load = (hdvfs->IdleTime >= elapsed) ? 0U :
+                (uint32_t)(100U - (((uint64_t)hdvfs->IdleTime * 100U) / elapsed));
+  hdvfs->WindowStart = now;
+  hdvfs->IdleTime    = 0U;
+  hdvfs->Stats.Windows++;
+
+  if ((hdvfs->Governor == 0U) || (hdvfs->Locks != 0U))
+  {
+    return hdvfs->Point;
+  }
+
+  if (hdvfs->Load >= BSP_DVFS_UP_LOAD)
+  {
+    target = hdvfs->NbPoints - 1U;
+  }
+  else
+  {
+    /* Slowest point expected under the target load, HCLK ascending */
+    hclk = (hdvfs->Point == BSP_DVFS_POINT_NONE) ? HAL_RCC_GetHCLKFreq() :
+           DVFS_GetHCLK(&hdvfs->pPoints[hdvfs->Point]);
+    target = hdvfs->Point;
+    for (index = 0U; (index < hdvfs->NbPoints) && (index < target); index++)
+    {
+      if (((uint64_t)hdvfs->Load * hclk) <=
+          ((uint64_t)BSP_DVFS_TARGET_LOAD * DVFS_GetHCLK(&hdvfs->pPoints[index])))
+      {
+        target = index;
+      }
+    }
+    if (target == BSP_DVFS_POINT_NONE)
+    {
+      target = hdvfs->NbPoints - 1U;
+    }
+  }
+
+  if (target != hdvfs->Point)
+  {
+    (void)DVFS_Apply(hdvfs, target);
+  }
+
+  return hdvfs->Point;
+}
+
+/**
+  * @brief  Get the load of the last window.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @retval Load in percent
+  */
+uint32_t BSP_DVFS_GetLoad(const BSP_DVFS_TypeDef *hdvfs)
+{
+  return hdvfs->Load;
+}
+
+/**
+  * @brief  Get the statistics.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_DVFS_GetStats(const BSP_DVFS_TypeDef *hdvfs, BSP_DVFS_StatsTypeDef *pStats)
+{
+  *pStats = hdvfs->Stats;
+}
+
+/**
+  * @brief  Operating point change callback, before the switch.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  From Current operating point or BSP_DVFS_POINT_NONE.
+  * @param  To Operating point applied.
+  * @retval None
+  */
+__weak void BSP_DVFS_PreChangeCallback(BSP_DVFS_TypeDef *hdvfs, uint32_t From, uint32_t To)
+{
+  UNUSED(hdvfs);
+  UNUSED(From);
+  UNUSED(To);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_DVFS_PreChangeCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Operating point change callback, after the switch, SystemCoreClock updated.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  From Previous operating point or BSP_DVFS_POINT_NONE.
+  * @param  To Operating point applied, BSP_DVFS_POINT_NONE when the switch failed.
+  * @retval None
+  */
+__weak void BSP_DVFS_PostChangeCallback(BSP_DVFS_TypeDef *hdvfs, uint32_t From, uint32_t To)
+{
+  UNUSED(hdvfs);
+  UNUSED(From);
+  UNUSED(To);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_DVFS_PostChangeCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_DVFS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Compute the HCLK of an operating point.
+  * @param  pPoint Operating point.
+  * @retval HCLK in Hz
+  */
+static uint32_t DVFS_GetHCLK(const BSP_DVFS_PointTypeDef *pPoint)
+{
+  uint32_t sysclk;
+  uint32_t mul;
+
+  if (pPoint->ClkInit.SYSCLKSource == RCC_SYSCLKSOURCE_HSE)
+  {
+    sysclk = HSE_VALUE;
+  }
+  else if (pPoint->ClkInit.SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK)
+  {
+    /* PLLMULL[3:0] and PLLMULL[5:4] apart in CFGR, factors from 2 to 63 */
+    mul = (((pPoint->PLL.PLLMUL >> RCC_CFGR_PLLMULL_Pos) & 0x0FU) |
+           (((pPoint->PLL.PLLMUL >> (RCC_CFGR_PLLMULL_Pos + 11U)) & 0x03U) << 4U)) + 2U;
+    mul = (mul > 63U) ? 63U : mul;
+    if (pPoint->PLL.PLLSource == RCC_PLLSOURCE_HSE)
+    {
+      sysclk = HSE_VALUE * mul;
+    }
+    else if (pPoint->PLL.PLLSource == RCC_PLLSOURCE_HSE_DIV2)
+    {
+      sysclk = (HSE_VALUE / 2U) * mul;
+    }
+    else
+    {
+      sysclk = HSI_VALUE * mul;
+    }
+  }
+  else
+  {
+    sysclk = HSI_VALUE;
+  }
+
+  return sysclk >> AHBPrescTable[(pPoint->ClkInit.AHBCLKDivider & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+}
+
+/**
+  * @brief  Read the time from the tick and the SysTick counter.
+  * @retval Time in us, wrapping
+  */
+static uint32_t DVFS_GetTime(void)
+{
+  uint32_t load = SysTick->LOAD;
+  uint32_t tick;
+  uint32_t val;
+  uint32_t pending;
+
+  do
+  {
+    tick    = uwTick;
+    val     = SysTick->VAL;
+    pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  } while (tick != uwTick);
+
+  /* Interrupts disabled, a reload not counted yet */
+  if (pending != 0U)
+  {
+    val   = SysTick->VAL;
+    tick += (uint32_t)uwTickFreq;
+  }
+
+  return (tick * 1000U) +
+         (uint32_t)((((uint64_t)(load - val) * (uint32_t)uwTickFreq) * 1000U) / ((uint64_t)load + 1U));
+}
+
+/**
+  * @brief  Wait for the regulator after a voltage raise.
+  * @retval None
+  */
+static void DVFS_Settle(void)
+{
+  HAL_DelayUs(BSP_DVFS_VOS_SETTLE);
+}
+
+/**
+  * @brief  Switch to an operating point, the callbacks around.
+  * @param  hdvfs Pointer to a BSP_DVFS_TypeDef structure.
+  * @param  Point Operating point.
+  * @retval HAL status, HAL_BUSY when a notifier defers the switch
+  */
+static HAL_StatusTypeDef DVFS_Apply(BSP_DVFS_TypeDef *hdvfs, uint32_t Point)
+{
+  const BSP_DVFS_PointTypeDef *ppoint = &hdvfs->pPoints[Point];
+  RCC_OscInitTypeDef oscinit = {0};
+  RCC_ClkInitTypeDef clkinit = {0};
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t from = hdvfs->Point;
+  uint32_t pll;
+
+  /* A notifier with a transfer running defers the switch */
+  if (BSP_CLKSWITCH_Prepare() != HAL_OK)
+  {
+    hdvfs->Stats.Deferred++;
+    return HAL_BUSY;
+  }
+
+  BSP_DVFS_PreChangeCallback(hdvfs, from, Point);
+
+  /* A lower VOS value is a higher voltage */
+  if (ppoint->VoltageScaling < HAL_PWREx_GetVoltageRange())
+  {
+    HAL_PWREx_ControlVoltageScaling(ppoint->VoltageScaling);
+    DVFS_Settle();
+  }
+
+  /* The PLL cannot be configured while it clocks the device */
+  pll = ppoint->PLL.PLLSource | ppoint->PLL.PLLMUL;
+  if ((ppoint->PLL.PLLState == RCC_PLL_ON) &&
+      ((__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == RESET) || (READ_BIT(RCC->CFGR, DVFS_PLL_CFGR) != pll)))
+  {
+    if (__HAL_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+    {
+      clkinit.ClockType    = RCC_CLOCKTYPE_SYSCLK;
+      clkinit.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+      status = HAL_RCC_ClockConfig(&clkinit, FLASH_LATENCY_AUTO);
+    }
+    if (status == HAL_OK)
+    {
+      oscinit.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+      oscinit.PLL            = ppoint->PLL;
+      status = HAL_RCC_OscConfig(&oscinit);
+    }
+  }
+
+  if (status == HAL_OK)
+  {
+    clkinit           = ppoint->ClkInit;
+    clkinit.ClockType = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    status = HAL_RCC_ClockConfig(&clkinit, ppoint->FlashLatency);
+  }
+
+  if ((status == HAL_OK) && (ppoint->PLL.PLLState == RCC_PLL_OFF))
+  {
+    oscinit.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    oscinit.PLL            = ppoint->PLL;
+    status = HAL_RCC_OscConfig(&oscinit);
+  }
+
+  if (status == HAL_OK)
+  {
+    if (ppoint->VoltageScaling > HAL_PWREx_GetVoltageRange())
+    {
+      HAL_PWREx_ControlVoltageScaling(ppoint->VoltageScaling);
+    }
+    hdvfs->Point = Point;
+    hdvfs->Stats.Switches++;
+  }
+  else
+  {
+    /* Voltage kept, the clock between the two points */
+    SystemCoreClockUpdate();
+    (void)HAL_InitTick(uwTickPrio);
+    hdvfs->Point = BSP_DVFS_POINT_NONE;
+    hdvfs->Stats.Failures++;
+  }
+
+  (void)BSP_CLKSWITCH_Complete();
+  BSP_DVFS_PostChangeCallback(hdvfs, from, hdvfs->Point);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_PWR_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
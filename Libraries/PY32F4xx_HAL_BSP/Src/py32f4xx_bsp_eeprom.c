@@ -0,0 +1,890 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_eeprom.c
+  * @author  MCU Application Team
+  * @brief   Internal flash EEPROM emulation BSP service.
+  *          This file provides functions to keep variables in the internal
+  *          flash without erasing a sector for each update:
+  *           + Append-only records in two or more rotating sectors
+  *           + Records collected in a RAM image of the page to program
+  *           + Index in RAM, one lookup per read
+  *           + Sector transfer with interrupt driven erase
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Reserve two or more FLASH_SECTOR_SIZE sectors of the internal flash,
+       out of the code, for instance by shortening the FLASH region of the
+       linker script. Enable FLASH_IRQn in the NVIC, call HAL_FLASH_IRQHandler()
+       from FLASH_IRQHandler(), BSP_EEPROM_EndOfOperationHandler() from
+       HAL_FLASH_EndOfOperationCallback() and BSP_EEPROM_ErrorHandler() from
+       HAL_FLASH_OperationErrorCallback().
+
+   (#) Call BSP_EEPROM_Init(): the flash is unlocked, every sector is scanned
+       in write order and the last record of each variable is indexed. A page
+       or sector cut by a reset is skipped or erased.
+
+   (#) A variable is an identifier below BSP_EEPROM_VARIABLES holding up to
+       BSP_EEPROM_VALUE_MAX bytes:
+       (+) BSP_EEPROM_Write() appends a record to the RAM image of the page
+           being filled and returns. A full page is started with
+           HAL_FLASH_PageProgram_IT(), which latches the 256 bytes at once.
+       (+) BSP_EEPROM_Read() reads the last record from the flash or from the
+           page image and checks its Fletcher-16 checksum.
+       (+) A record is durable once its page is programmed: when the page is
+           full, with BSP_EEPROM_Flush(), or from BSP_EEPROM_Process() after
+           BSP_EEPROM_FLUSH_DELAY ms. Each page is programmed once.
+
+   (#) Call BSP_EEPROM_Process() from the main loop. When only one sector is
+       erased and the head is filled to BSP_EEPROM_GC_LEVEL, the sector with
+       the most dead bytes is transferred: its current records are copied to
+       the head, then it is erased with HAL_FLASH_Erase_IT(). Each step
+       returns at once, the erase runs in the background.
+
+   (#) BSP_EEPROM_Write() and BSP_EEPROM_Flush() return HAL_BUSY when a page
+       has to be programmed while the flash is busy, or when the head sector
+       is full and only the erased sector kept for the transfer is left:
+       call BSP_EEPROM_Process() and retry.
+
+   (#) Other flash programs or erases must not run while the service is used.
+       The CPU stalls on a code fetch from the flash during a program or an
+       erase; run the time critical code from RAM.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_eeprom.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_EEPROM BSP EEPROM
+  * @brief Internal flash EEPROM emulation BSP service
+  * @{
+  */
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_EEPROM_Private_Constants BSP EEPROM Private Constants
+  * @{
+  */
+#define EEPROM_MAGIC                    0x31504545U    /* "EEP1", first word of a sector            */
+#define EEPROM_SECTOR_HEADER            8U             /* Magic and sequence                        */
+#define EEPROM_RECORD_HEADER            4U             /* Identifier, length and checksum           */
+#define EEPROM_NONE                     BSP_EEPROM_SECTORS_MAX
+
+#define EEPROM_GC_NONE                  0U             /* No transfer                               */
+#define EEPROM_GC_COPY                  1U             /* Copying the current records               */
+#define EEPROM_GC_FLUSH                 2U             /* Programming the last copies               */
+#define EEPROM_GC_ERASE_START           3U             /* Waiting for the flash to start the erase  */
+#define EEPROM_GC_ERASE                 4U             /* Erase running                             */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_EEPROM_Private_Macros BSP EEPROM Private Macros
+  * @{
+  */
+#define EEPROM_RECORD_SIZE(__LENGTH__)  (EEPROM_RECORD_HEADER + (((__LENGTH__) + 3U) & ~3U))
+#define EEPROM_SECTOR_ADDRESS(__HEEP__, __SECTOR__) ((__HEEP__)->Address + ((__SECTOR__) * FLASH_SECTOR_SIZE))
+#define EEPROM_SECTOR_OF(__HEEP__, __ADDRESS__) (((__ADDRESS__) - (__HEEP__)->Address) / FLASH_SECTOR_SIZE)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_EEPROM_Private_Functions
+  * @{
+  */
+static uint32_t EEPROM_Checksum(const uint8_t *pRecord);
+static const uint8_t *EEPROM_Record(const BSP_EEPROM_TypeDef *heep, uint32_t Address);
+static uint32_t EEPROM_IsRecord(const uint8_t *pRecord, uint32_t Offset);
+static uint32_t EEPROM_IsBlank(uint32_t Address, uint32_t Size);
+static void EEPROM_IndexSet(BSP_EEPROM_TypeDef *heep, uint32_t Id, uint32_t Address);
+static HAL_StatusTypeDef EEPROM_Scan(BSP_EEPROM_TypeDef *heep, uint32_t Sector);
+static void EEPROM_Open(BSP_EEPROM_TypeDef *heep, uint32_t Sector);
+static HAL_StatusTypeDef EEPROM_Commit(BSP_EEPROM_TypeDef *heep);
+static HAL_StatusTypeDef EEPROM_Room(BSP_EEPROM_TypeDef *heep, uint32_t Size, uint32_t Reserve);
+static HAL_StatusTypeDef EEPROM_Append(BSP_EEPROM_TypeDef *heep, const uint8_t *pRecord, uint32_t Reserve);
+static uint32_t EEPROM_Dead(const BSP_EEPROM_TypeDef *heep, uint32_t Sector);
+static HAL_StatusTypeDef EEPROM_Transfer(BSP_EEPROM_TypeDef *heep);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_EEPROM_Exported_Functions BSP EEPROM Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_EEPROM_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Rebuild the index from the flash
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the EEPROM emulation and build its index.
+  * @note   Blocking: erases the sectors left broken by a reset.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Address First sector, aligned on FLASH_SECTOR_SIZE.
+  * @param  SectorCount Number of sectors, 2 to BSP_EEPROM_SECTORS_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_EEPROM_Init(BSP_EEPROM_TypeDef *heep, uint32_t Address, uint32_t SectorCount)
+{
+  FLASH_EraseInitTypeDef erase = {0};
+  const uint32_t *pheader;
+  uint32_t sector;
+  uint32_t last;
+  uint32_t next;
+  uint32_t error;
+  HAL_StatusTypeDef status;
+
+  if ((heep == NULL) || ((Address % FLASH_SECTOR_SIZE) != 0U) || (Address < FLASH_BASE) ||
+      (SectorCount < 2U) || (SectorCount > BSP_EEPROM_SECTORS_MAX) ||
+      ((Address + (SectorCount * FLASH_SECTOR_SIZE) - 1U) > FLASH_END))
+  {
+    return HAL_ERROR;
+  }
+
+  status = HAL_FLASH_Unlock();
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  heep->Address      = Address;
+  heep->SectorCount  = SectorCount;
+  heep->LastSequence = 0U;
+  heep->Head         = EEPROM_NONE;
+  heep->FreeSectors  = 0U;
+  heep->PageAddress  = 0U;
+  heep->PageUsed     = 0U;
+  heep->PageDirty    = 0U;
+  heep->FlashBusy    = 0U;
+  heep->FlashError   = 0U;
+  heep->GcState      = EEPROM_GC_NONE;
+  heep->EraseCount   = 0U;
+  heep->ErrorCount   = 0U;
+  memset(heep->Index, 0, sizeof(heep->Index));
+
+  /* Sort out the written, erased and broken sectors */
+  erase.TypeErase = FLASH_TYPEERASE_SECTORERASE;
+  erase.NbSectors = 1U;
+  for (sector = 0U; sector < SectorCount; sector++)
+  {
+    heep->Sequence[sector] = 0U;
+    heep->Used[sector]     = 0U;
+    heep->Live[sector]     = 0U;
+
+    pheader = (const uint32_t *)EEPROM_SECTOR_ADDRESS(heep, sector);
+    if ((pheader[0] == EEPROM_MAGIC) && (pheader[1] != 0U) && (pheader[1] != 0xFFFFFFFFU))
+    {
+      heep->Sequence[sector] = pheader[1];
+      if (pheader[1] > heep->LastSequence)
+      {
+        heep->LastSequence = pheader[1];
+      }
+      continue;
+    }
+
+    if (EEPROM_IsBlank(EEPROM_SECTOR_ADDRESS(heep, sector), FLASH_SECTOR_SIZE) == 0U)
+    {
+      erase.SectorAddress = EEPROM_SECTOR_ADDRESS(heep, sector);
+      status = HAL_FLASH_Erase(&erase, &error);
+      if (status != HAL_OK)
+      {
+        heep->Address = 0U;
+        return status;
+      }
+      heep->EraseCount++;
+    }
+    heep->FreeSectors++;
+  }
+
+  /* Replay the sectors from the oldest, the last one is the head */
+  last = 0U;
+  for (;;)
+  {
+    next = EEPROM_NONE;
+    for (sector = 0U; sector < SectorCount; sector++)
+    {
+      if ((heep->Sequence[sector] > last) &&
+          ((next == EEPROM_NONE) || (heep->Sequence[sector] < heep->Sequence[next])))
+      {
+        next = sector;
+      }
+    }
+    if (next == EEPROM_NONE)
+    {
+      break;
+    }
+
+    (void)EEPROM_Scan(heep, next);
+    heep->Head = next;
+    last = heep->Sequence[next];
+  }
+
+  /* Appends resume on the first erased page of the head */
+  memset(heep->Page, 0xFF, sizeof(heep->Page));
+  if ((heep->Head != EEPROM_NONE) && (heep->Used[heep->Head] < FLASH_SECTOR_SIZE))
+  {
+    heep->PageAddress = EEPROM_SECTOR_ADDRESS(heep, heep->Head) + heep->Used[heep->Head];
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_EEPROM_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Read and write variables
+      (+) Program the pending page
+      (+) Transfer sectors in the background
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Get the length of a variable.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Id Variable identifier.
+  * @retval Length in bytes, BSP_EEPROM_NOT_FOUND when the variable was never written
+  */
+uint32_t BSP_EEPROM_GetLength(const BSP_EEPROM_TypeDef *heep, uint32_t Id)
+{
+  if ((heep->Address == 0U) || (Id >= BSP_EEPROM_VARIABLES) || (heep->Index[Id] == 0U))
+  {
+    return BSP_EEPROM_NOT_FOUND;
+  }
+
+  return EEPROM_Record(heep, heep->Index[Id])[1];
+}
+
+/**
+  * @brief  Read a variable.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Id Variable identifier.
+  * @param  pData Destination buffer.
+  * @param  Size Size of the buffer, at least the variable length.
+  * @retval HAL status, HAL_ERROR when the variable was never written or its record is corrupted
+  */
+HAL_StatusTypeDef BSP_EEPROM_Read(BSP_EEPROM_TypeDef *heep, uint32_t Id, uint8_t *pData, uint32_t Size)
+{
+  const uint8_t *precord;
+
+  if ((heep->Address == 0U) || (Id >= BSP_EEPROM_VARIABLES) || (heep->Index[Id] == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  precord = EEPROM_Record(heep, heep->Index[Id]);
+  if ((precord[1] > Size) || ((pData == NULL) && (precord[1] != 0U)))
+  {
+    return HAL_ERROR;
+  }
+  if (EEPROM_Checksum(precord) != ((uint32_t)precord[2] | ((uint32_t)precord[3] << 8)))
+  {
+    heep->ErrorCount++;
+    return HAL_ERROR;
+  }
+
+  memcpy(pData, &precord[EEPROM_RECORD_HEADER], precord[1]);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write a variable.
+  * @note   Returns once the record is in the page image, see BSP_EEPROM_Flush().
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Id Variable identifier.
+  * @param  pData Value.
+  * @param  Length Value length in bytes, up to BSP_EEPROM_VALUE_MAX.
+  * @retval HAL status, HAL_BUSY when no room is available until BSP_EEPROM_Process() runs
+  */
+HAL_StatusTypeDef BSP_EEPROM_Write(BSP_EEPROM_TypeDef *heep, uint32_t Id, const uint8_t *pData, uint32_t Length)
+{
+  uint8_t record[EEPROM_RECORD_SIZE(BSP_EEPROM_VALUE_MAX)];
+  uint32_t check;
+
+  if ((heep->Address == 0U) || (Id >= BSP_EEPROM_VARIABLES) || (Length > BSP_EEPROM_VALUE_MAX) ||
+      ((pData == NULL) && (Length != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  memset(record, 0xFF, EEPROM_RECORD_SIZE(Length));
+  record[0] = (uint8_t)Id;
+  record[1] = (uint8_t)Length;
+  memcpy(&record[EEPROM_RECORD_HEADER], pData, Length);
+  check = EEPROM_Checksum(record);
+  record[2] = (uint8_t)check;
+  record[3] = (uint8_t)(check >> 8);
+
+  return EEPROM_Append(heep, record, 1U);
+}
+
+/**
+  * @brief  Program the records of the page image.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval HAL status, HAL_BUSY when the flash is busy
+  */
+HAL_StatusTypeDef BSP_EEPROM_Flush(BSP_EEPROM_TypeDef *heep)
+{
+  if (heep->Address == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  return EEPROM_Commit(heep);
+}
+
+/**
+  * @brief  Program an old page image and run the sector transfer.
+  * @note   To be called from the main loop, each call returns at once.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_EEPROM_Process(BSP_EEPROM_TypeDef *heep)
+{
+  if (heep->Address == 0U)
+  {
+    return HAL_ERROR;
+  }
+  if (heep->FlashBusy != 0U)
+  {
+    return HAL_OK;
+  }
+
+  if ((heep->PageDirty != 0U) && ((HAL_GetTick() - heep->PageTick) >= BSP_EEPROM_FLUSH_DELAY))
+  {
+    return EEPROM_Commit(heep);
+  }
+
+  return EEPROM_Transfer(heep);
+}
+
+/**
+  * @brief  Flash end of operation handler.
+  * @note   To be called from HAL_FLASH_EndOfOperationCallback().
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval None
+  */
+void BSP_EEPROM_EndOfOperationHandler(BSP_EEPROM_TypeDef *heep)
+{
+  heep->FlashBusy = 0U;
+}
+
+/**
+  * @brief  Flash operation error handler.
+  * @note   To be called from HAL_FLASH_OperationErrorCallback().
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval None
+  */
+void BSP_EEPROM_ErrorHandler(BSP_EEPROM_TypeDef *heep)
+{
+  heep->ErrorCount++;
+  heep->FlashError = 1U;
+  heep->FlashBusy  = 0U;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_EEPROM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Fletcher-16 checksum of a record.
+  * @param  pRecord Record, its checksum bytes are ignored.
+  * @retval Checksum
+  */
+static uint32_t EEPROM_Checksum(const uint8_t *pRecord)
+{
+  uint32_t sum1 = pRecord[0];
+  uint32_t sum2 = pRecord[0];
+  uint32_t i;
+
+  sum1 = (sum1 + pRecord[1]) % 255U;
+  sum2 = (sum2 + sum1) % 255U;
+  for (i = 0U; i < pRecord[1]; i++)
+  {
+    sum1 = (sum1 + pRecord[EEPROM_RECORD_HEADER + i]) % 255U;
+    sum2 = (sum2 + sum1) % 255U;
+  }
+
+  return (sum2 << 8) | sum1;
+}
+
+/**
+  * @brief  Location of a record, in the flash or in the page image.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Address Record address.
+  * @retval Pointer to the record
+  */
+static const uint8_t *EEPROM_Record(const BSP_EEPROM_TypeDef *heep, uint32_t Address)
+{
+  if ((heep->PageAddress != 0U) && (Address >= heep->PageAddress) &&
+      (Address < (heep->PageAddress + FLASH_PAGE_SIZE)))
+  {
+    return (const uint8_t *)heep->Page + (Address - heep->PageAddress);
+  }
+
+  return (const uint8_t *)Address;
+}
+
+/**
+  * @brief  Check the header and the checksum of a record.
+  * @param  pRecord Record.
+  * @param  Offset Offset of the record in its page.
+  * @retval 1 when the record is valid and fits the page, 0 otherwise
+  */
+static uint32_t EEPROM_IsRecord(const uint8_t *pRecord, uint32_t Offset)
+{
+  if ((pRecord[0] >= BSP_EEPROM_VARIABLES) || (pRecord[1] > BSP_EEPROM_VALUE_MAX) ||
+      (EEPROM_RECORD_SIZE(pRecord[1]) > (FLASH_PAGE_SIZE - Offset)) ||
+      (EEPROM_Checksum(pRecord) != ((uint32_t)pRecord[2] | ((uint32_t)pRecord[3] << 8))))
+  {
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Check whether a flash area is erased.
+  * @param  Address First address, word aligned.
+  * @param  Size Number of bytes, a multiple of 4.
+  * @retval 1 when every byte is 0xFF, 0 otherwise
+  */
+static uint32_t EEPROM_IsBlank(uint32_t Address, uint32_t Size)
+{
+  const uint32_t *pword = (const uint32_t *)Address;
+  uint32_t i;
+
+  for (i = 0U; i < (Size / 4U); i++)
+  {
+    if (pword[i] != 0xFFFFFFFFU)
+    {
+      return 0U;
+    }
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Point a variable to a new record.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Id Variable identifier.
+  * @param  Address Record address.
+  * @retval None
+  */
+static void EEPROM_IndexSet(BSP_EEPROM_TypeDef *heep, uint32_t Id, uint32_t Address)
+{
+  uint32_t old = heep->Index[Id];
+
+  if (old != 0U)
+  {
+    heep->Live[EEPROM_SECTOR_OF(heep, old)] -= EEPROM_RECORD_SIZE(EEPROM_Record(heep, old)[1]);
+  }
+  heep->Index[Id] = Address;
+  heep->Live[EEPROM_SECTOR_OF(heep, Address)] += EEPROM_RECORD_SIZE(EEPROM_Record(heep, Address)[1]);
+}
+
+/**
+  * @brief  Replay the records of a sector in the index.
+  * @note   A page is programmed at once: the scan of a page ends on its first
+  *         erased or corrupted record, the sector ends on its first erased page.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Sector Sector number.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef EEPROM_Scan(BSP_EEPROM_TypeDef *heep, uint32_t Sector)
+{
+  uint32_t base = EEPROM_SECTOR_ADDRESS(heep, Sector);
+  const uint8_t *precord;
+  uint32_t page;
+  uint32_t offset;
+
+  for (page = 0U; page < FLASH_SECTOR_SIZE; page += FLASH_PAGE_SIZE)
+  {
+    if ((page != 0U) && (EEPROM_IsBlank(base + page, FLASH_PAGE_SIZE) != 0U))
+    {
+      break;
+    }
+
+    offset = (page == 0U) ? EEPROM_SECTOR_HEADER : 0U;
+    while ((offset + EEPROM_RECORD_HEADER) <= FLASH_PAGE_SIZE)
+    {
+      precord = (const uint8_t *)(base + page + offset);
+      if (EEPROM_IsRecord(precord, offset) == 0U)
+      {
+        if (*(const uint32_t *)precord != 0xFFFFFFFFU)
+        {
+          heep->ErrorCount++;
+        }
+        break;
+      }
+      EEPROM_IndexSet(heep, precord[0], base + page + offset);
+      offset += EEPROM_RECORD_SIZE(precord[1]);
+    }
+  }
+  heep->Used[Sector] = page;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start appending to an erased sector.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Sector Sector number.
+  * @retval None
+  */
+static void EEPROM_Open(BSP_EEPROM_TypeDef *heep, uint32_t Sector)
+{
+  heep->LastSequence++;
+  heep->Sequence[Sector] = heep->LastSequence;
+  heep->Used[Sector]     = EEPROM_SECTOR_HEADER;
+  heep->Live[Sector]     = 0U;
+  heep->FreeSectors--;
+  heep->Head = Sector;
+
+  /* The header is programmed with the first page */
+  memset(heep->Page, 0xFF, sizeof(heep->Page));
+  heep->Page[0]     = EEPROM_MAGIC;
+  heep->Page[1]     = heep->LastSequence;
+  heep->PageAddress = EEPROM_SECTOR_ADDRESS(heep, Sector);
+  heep->PageUsed    = EEPROM_SECTOR_HEADER;
+  heep->PageDirty   = 0U;
+}
+
+/**
+  * @brief  Program the page image and move to the next page.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval HAL status, HAL_BUSY when the flash is busy
+  */
+static HAL_StatusTypeDef EEPROM_Commit(BSP_EEPROM_TypeDef *heep)
+{
+  uint32_t base;
+  HAL_StatusTypeDef status;
+
+  if (heep->PageDirty == 0U)
+  {
+    return HAL_OK;
+  }
+  if (heep->FlashBusy != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The page is latched by the call, the image is free on return */
+  heep->FlashBusy = 1U;
+  status = HAL_FLASH_PageProgram_IT(heep->PageAddress, heep->Page);
+  if (status != HAL_OK)
+  {
+    heep->FlashBusy = 0U;
+    return status;
+  }
+
+  base = EEPROM_SECTOR_ADDRESS(heep, heep->Head);
+  heep->PageAddress += FLASH_PAGE_SIZE;
+  heep->Used[heep->Head] = heep->PageAddress - base;
+  if (heep->Used[heep->Head] >= FLASH_SECTOR_SIZE)
+  {
+    heep->PageAddress = 0U;
+  }
+  memset(heep->Page, 0xFF, sizeof(heep->Page));
+  heep->PageUsed  = 0U;
+  heep->PageDirty = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Make room for a record in the page image.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Size Record size in bytes.
+  * @param  Reserve 1 to keep the last erased sector for the transfer, 0 to take it.
+  * @retval HAL status, HAL_BUSY when no room is available now
+  */
+static HAL_StatusTypeDef EEPROM_Room(BSP_EEPROM_TypeDef *heep, uint32_t Size, uint32_t Reserve)
+{
+  HAL_StatusTypeDef status;
+  uint32_t sector;
+  uint32_t i;
+
+  if ((heep->PageAddress != 0U) && ((heep->PageUsed + Size) <= FLASH_PAGE_SIZE))
+  {
+    return HAL_OK;
+  }
+
+  if (heep->PageAddress != 0U)
+  {
+    status = EEPROM_Commit(heep);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+    if (heep->PageAddress != 0U)
+    {
+      return HAL_OK;
+    }
+  }
+
+  if (heep->FreeSectors <= Reserve)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The next erased sector after the head spreads the wear */
+  sector = (heep->Head == EEPROM_NONE) ? 0U : heep->Head;
+  for (i = 0U; i < heep->SectorCount; i++)
+  {
+    sector = (sector + 1U) % heep->SectorCount;
+    if (heep->Sequence[sector] == 0U)
+    {
+      break;
+    }
+  }
+  EEPROM_Open(heep, sector);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Append a record to the page image and index it.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  pRecord Record with its checksum.
+  * @param  Reserve 1 to keep the last erased sector for the transfer, 0 to take it.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef EEPROM_Append(BSP_EEPROM_TypeDef *heep, const uint8_t *pRecord, uint32_t Reserve)
+{
+  uint32_t size = EEPROM_RECORD_SIZE(pRecord[1]);
+  HAL_StatusTypeDef status;
+
+  status = EEPROM_Room(heep, size, Reserve);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  memcpy((uint8_t *)heep->Page + heep->PageUsed, pRecord, size);
+  if (heep->PageDirty == 0U)
+  {
+    heep->PageDirty = 1U;
+    heep->PageTick  = HAL_GetTick();
+  }
+  EEPROM_IndexSet(heep, pRecord[0], heep->PageAddress + heep->PageUsed);
+  heep->PageUsed += size;
+  heep->Used[heep->Head] = (heep->PageAddress - EEPROM_SECTOR_ADDRESS(heep, heep->Head)) + heep->PageUsed;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Bytes of a sector taken by old records and unused page ends.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @param  Sector Sector number.
+  * @retval Dead bytes
+  */
+static uint32_t EEPROM_Dead(const BSP_EEPROM_TypeDef *heep, uint32_t Sector)
+{
+  if (heep->Sequence[Sector] == 0U)
+  {
+    return 0U;
+  }
+
+  return heep->Used[Sector] - EEPROM_SECTOR_HEADER - heep->Live[Sector];
+}
+
+/**
+  * @brief  Run one step of the sector transfer.
+  * @note   Called with the flash idle.
+  * @param  heep Pointer to a BSP_EEPROM_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef EEPROM_Transfer(BSP_EEPROM_TypeDef *heep)
+{
+  FLASH_EraseInitTypeDef erase = {0};
+  const uint8_t *precord;
+  uint32_t base;
+  uint32_t sector;
+  uint32_t offset;
+  HAL_StatusTypeDef status;
+
+  switch (heep->GcState)
+  {
+    case EEPROM_GC_NONE:
+      if ((heep->FreeSectors > 1U) || (heep->Head == EEPROM_NONE) ||
+          (heep->Used[heep->Head] < BSP_EEPROM_GC_LEVEL))
+      {
+        return HAL_OK;
+      }
+
+      /* Any sector may go, the copies are newer than the other records */
+      heep->GcSector = EEPROM_NONE;
+      for (sector = 0U; sector < heep->SectorCount; sector++)
+      {
+        if ((EEPROM_Dead(heep, sector) >= BSP_EEPROM_GC_DEAD_MIN) &&
+            ((heep->GcSector == EEPROM_NONE) || (EEPROM_Dead(heep, sector) > EEPROM_Dead(heep, heep->GcSector))))
+        {
+          heep->GcSector = sector;
+        }
+      }
+      if (heep->GcSector == EEPROM_NONE)
+      {
+        return HAL_OK;
+      }
+
+      /* The head itself is closed, the copies go to the erased sector */
+      if (heep->GcSector == heep->Head)
+      {
+        status = EEPROM_Commit(heep);
+        if (status != HAL_OK)
+        {
+          return status;
+        }
+        heep->Used[heep->Head] = FLASH_SECTOR_SIZE;
+        heep->PageAddress = 0U;
+      }
+      heep->GcOffset = EEPROM_SECTOR_HEADER;
+      heep->GcState  = EEPROM_GC_COPY;
+      return HAL_OK;
+
+    case EEPROM_GC_COPY:
+      base = EEPROM_SECTOR_ADDRESS(heep, heep->GcSector);
+      while ((heep->Live[heep->GcSector] != 0U) && (heep->GcOffset < heep->Used[heep->GcSector]))
+      {
+        offset = heep->GcOffset % FLASH_PAGE_SIZE;
+        precord = EEPROM_Record(heep, base + heep->GcOffset);
+        if (((offset + EEPROM_RECORD_HEADER) > FLASH_PAGE_SIZE) || (EEPROM_IsRecord(precord, offset) == 0U))
+        {
+          /* Next page */
+          heep->GcOffset += FLASH_PAGE_SIZE - offset;
+          continue;
+        }
+
+        if (heep->Index[precord[0]] == (base + heep->GcOffset))
+        {
+          status = EEPROM_Append(heep, precord, 0U);
+          if (status != HAL_OK)
+          {
+            return (status == HAL_BUSY) ? HAL_OK : status;
+          }
+        }
+        heep->GcOffset += EEPROM_RECORD_SIZE(precord[1]);
+      }
+      heep->GcState = EEPROM_GC_FLUSH;
+      return HAL_OK;
+
+    case EEPROM_GC_FLUSH:
+      /* The copies are programmed before the erase */
+      status = EEPROM_Commit(heep);
+      if (status != HAL_OK)
+      {
+        return (status == HAL_BUSY) ? HAL_OK : status;
+      }
+      heep->GcState = EEPROM_GC_ERASE_START;
+      return HAL_OK;
+
+    case EEPROM_GC_ERASE_START:
+      erase.TypeErase     = FLASH_TYPEERASE_SECTORERASE;
+      erase.SectorAddress = EEPROM_SECTOR_ADDRESS(heep, heep->GcSector);
+      erase.NbSectors     = 1U;
+      heep->FlashError = 0U;
+      heep->FlashBusy  = 1U;
+      status = HAL_FLASH_Erase_IT(&erase);
+      if (status != HAL_OK)
+      {
+        heep->FlashBusy = 0U;
+        return status;
+      }
+      heep->GcState = EEPROM_GC_ERASE;
+      return HAL_OK;
+
+    case EEPROM_GC_ERASE:
+      if (heep->FlashError != 0U)
+      {
+        heep->GcState = EEPROM_GC_ERASE_START;
+        return HAL_ERROR;
+      }
+      heep->Sequence[heep->GcSector] = 0U;
+      heep->Used[heep->GcSector]     = 0U;
+      heep->Live[heep->GcSector]     = 0U;
+      heep->FreeSectors++;
+      heep->EraseCount++;
+      heep->GcState = EEPROM_GC_NONE;
+      return HAL_OK;
+
+    default:
+      heep->GcState = EEPROM_GC_NONE;
+      return HAL_ERROR;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,389 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_encoder.c
+  * @author  MCU Application Team
+  * @brief   Quadrature encoder BSP service.
+  *          This file provides functions to follow quadrature encoders on the
+  *          16-bit timers:
+  *           + 64-bit position extended from the 16-bit counter
+  *           + M/T velocity from the time of the last edge of each update,
+  *             taken by a capture timer
+  *           + No interrupt, one update at the rate of the control loop
+  *           + Snapshots read without a lock from any context
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the encoder timer with HAL_TIM_Encoder_Init(), TIM1, TIM3,
+       TIM4 or TIM8 for instance, Period 0xFFFF. The position is extended by
+       the 16-bit difference of the counter between two updates: the encoder
+       must move by less than 32768 counts between two BSP_ENCODER_Update().
+
+   (#) The counts of one update only give the velocity to one count per
+       update period, coarse at low speed. For the M/T velocity, wire the A
+       signal of the encoder to an input of a capture timer as well, counting
+       up with Period 0xFFFF, and give it in htimCapture. The encoders of a
+       board can share the capture timer on its four channels. The velocity
+       is then the counts between the last captured edges of two updates over
+       the time between these edges, precise at any speed. Between updates
+       without an edge, it is limited by CountsPerCapture over the time since
+       the last edge, falling to 0 when the encoder stops. An update period
+       below 65536 ticks of the capture timer is needed.
+
+   (#) Call BSP_ENCODER_Init() then BSP_ENCODER_Start(). Call
+       BSP_ENCODER_Update() from one context at the rate of the control loop,
+       a timer interrupt for instance; it reads the counters and publishes a
+       snapshot of the position and of the velocity.
+
+   (#) BSP_ENCODER_GetSnapshot() can be called from any context, of a higher
+       or a lower priority than the update: the update writes the snapshot
+       not in use then switches to it, a read interrupted by an update is
+       repeated.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_encoder.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ENCODER BSP ENCODER
+  * @brief Quadrature encoder BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_ENCODER_Private_Macros BSP ENCODER Private Macros
+  * @{
+  */
+/* TIM_FLAG_CC1 to TIM_FLAG_CC4 are the bits 1 to 4 */
+#define ENCODER_CAPTURE_FLAG(__HANDLE__)  (TIM_FLAG_CC1 << ((__HANDLE__)->Init.CaptureChannel >> 2))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ENCODER_Private_Functions BSP ENCODER Private Functions
+  * @{
+  */
+static float ENCODER_Capture(BSP_ENCODER_TypeDef *henc, int32_t Delta);
+static void  ENCODER_Publish(BSP_ENCODER_TypeDef *henc);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ENCODER_Exported_Functions BSP ENCODER Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a quadrature encoder.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @param  htim TIM handle, initialized in encoder mode with Period 0xFFFF.
+  * @param  pInit Pointer to a BSP_ENCODER_InitTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ENCODER_Init(BSP_ENCODER_TypeDef *henc, TIM_HandleTypeDef *htim,
+                                   const BSP_ENCODER_InitTypeDef *pInit)
+{
+  TIM_HandleTypeDef *hcap;
+  TIM_IC_InitTypeDef ic;
+
+  if ((henc == NULL) || (htim == NULL) || (pInit == NULL) ||
+      !IS_TIM_ENCODER_INTERFACE_INSTANCE(htim->Instance) || (htim->Init.Period != 0xFFFFU) ||
+      (pInit->UpdateHz == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hcap = pInit->htimCapture;
+  if ((hcap != NULL) &&
+      (!IS_TIM_CCX_INSTANCE(hcap->Instance, pInit->CaptureChannel) || (hcap->Init.Period != 0xFFFFU) ||
+       (hcap->Init.CounterMode != TIM_COUNTERMODE_UP) || !IS_TIM_IC_FILTER(pInit->CaptureFilter) ||
+       (pInit->CaptureTickHz == 0U) || (pInit->CountsPerCapture == 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (henc->State == BSP_ENCODER_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  if (hcap != NULL)
+  {
+    ic.ICPolarity  = TIM_ICPOLARITY_RISING;
+    ic.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    ic.ICPrescaler = TIM_ICPSC_DIV1;
+    ic.ICFilter    = pInit->CaptureFilter;
+    if (HAL_TIM_IC_ConfigChannel(hcap, &ic, pInit->CaptureChannel) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  henc->htim  = htim;
+  henc->Init  = *pInit;
+  henc->State = BSP_ENCODER_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the counting, the position starts at 0.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ENCODER_Start(BSP_ENCODER_TypeDef *henc)
+{
+  TIM_HandleTypeDef *hcap = henc->Init.htimCapture;
+
+  if (henc->State != BSP_ENCODER_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_TIM_Encoder_Start(henc->htim, TIM_CHANNEL_ALL) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (hcap != NULL)
+  {
+    /* Shared by the encoders, the counter may already run */
+    TIM_CCxChannelCmd(hcap->Instance, henc->Init.CaptureChannel, TIM_CCx_ENABLE);
+    __HAL_TIM_ENABLE(hcap);
+    __HAL_TIM_CLEAR_FLAG(hcap, ENCODER_CAPTURE_FLAG(henc));
+    henc->CaptureCount = hcap->Instance->CNT & 0xFFFFU;
+  }
+
+  henc->Count       = henc->htim->Instance->CNT & 0xFFFFU;
+  henc->Position    = 0;
+  henc->Velocity    = 0.0f;
+  henc->CaptureTime = 0U;
+  henc->EdgeValid   = 0U;
+  henc->Sequence    = 0U;
+  henc->Snapshot[0].Position = 0;
+  henc->Snapshot[0].Velocity = 0.0f;
+  henc->Snapshot[0].Updates  = 0U;
+  henc->State = BSP_ENCODER_STATE_RUN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the counting, the last snapshot is kept.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ENCODER_Stop(BSP_ENCODER_TypeDef *henc)
+{
+  if (henc->State != BSP_ENCODER_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_TIM_Encoder_Stop(henc->htim, TIM_CHANNEL_ALL);
+  if (henc->Init.htimCapture != NULL)
+  {
+    TIM_CCxChannelCmd(henc->Init.htimCapture->Instance, henc->Init.CaptureChannel, TIM_CCx_DISABLE);
+  }
+  henc->State = BSP_ENCODER_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read the counters, extend the position, estimate the velocity and
+  *         publish a snapshot.
+  * @note   Called from one context only, at the rate of the control loop.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @retval None
+  */
+void BSP_ENCODER_Update(BSP_ENCODER_TypeDef *henc)
+{
+  uint32_t count;
+  int32_t delta;
+
+  if (henc->State != BSP_ENCODER_STATE_RUN)
+  {
+    return;
+  }
+
+  count = henc->htim->Instance->CNT & 0xFFFFU;
+  delta = (int16_t)(uint16_t)(count - henc->Count);
+  henc->Count = count;
+  henc->Position += delta;
+
+  if (henc->Init.htimCapture != NULL)
+  {
+    henc->Velocity = ENCODER_Capture(henc, delta);
+  }
+  else
+  {
+    henc->Velocity = (float)delta * (float)henc->Init.UpdateHz;
+  }
+
+  ENCODER_Publish(henc);
+}
+
+/**
+  * @brief  Read the last position and velocity.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @param  pSnapshot Pointer to a BSP_ENCODER_SnapshotTypeDef structure, filled.
+  * @retval None
+  */
+void BSP_ENCODER_GetSnapshot(const BSP_ENCODER_TypeDef *henc, BSP_ENCODER_SnapshotTypeDef *pSnapshot)
+{
+  uint32_t sequence;
+
+  do
+  {
+    sequence = henc->Sequence;
+    __DMB();
+    *pSnapshot = henc->Snapshot[sequence & 1U];
+    __DMB();
+  } while (sequence != henc->Sequence);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ENCODER_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  M/T velocity from the last captured edge.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @param  Delta Counts since the previous update.
+  * @retval Counts per second
+  */
+static float ENCODER_Capture(BSP_ENCODER_TypeDef *henc, int32_t Delta)
+{
+  TIM_HandleTypeDef *hcap = henc->Init.htimCapture;
+  float velocity = henc->Velocity;
+  float bound;
+  uint32_t flag = ENCODER_CAPTURE_FLAG(henc);
+  uint32_t edge = 0U;
+  uint32_t edged = 0U;
+  uint32_t now;
+  uint32_t time;
+  int64_t counts;
+  int64_t half = (int64_t)henc->Init.CountsPerCapture / 2;
+
+  /* The capture before the counter, the edge is never after it; the read clears the flag */
+  if (__HAL_TIM_GET_FLAG(hcap, flag) != RESET)
+  {
+    edge = __HAL_TIM_GET_COMPARE(hcap, henc->Init.CaptureChannel) & 0xFFFFU;
+    edged = 1U;
+  }
+  now = hcap->Instance->CNT & 0xFFFFU;
+  henc->CaptureTime += (uint16_t)(now - henc->CaptureCount);
+  henc->CaptureCount = now;
+
+  if (edged != 0U)
+  {
+    time = henc->CaptureTime - (uint16_t)(now - edge);
+    if (henc->EdgeValid != 0U)
+    {
+      /* The captured edges are CountsPerCapture apart, the counts at the updates round to them */
+      counts = henc->Position - henc->EdgePosition;
+      counts = ((counts + ((counts < 0) ? -half : half)) / (int64_t)henc->Init.CountsPerCapture) *
+               (int64_t)henc->Init.CountsPerCapture;
+      velocity = ((float)counts * (float)henc->Init.CaptureTickHz) / (float)(time - henc->EdgeTime);
+    }
+    else
+    {
+      velocity = (float)Delta * (float)henc->Init.UpdateHz;
+    }
+    henc->EdgeTime     = time;
+    henc->EdgePosition = henc->Position;
+    henc->EdgeValid    = 1U;
+  }
+  else if (henc->EdgeValid != 0U)
+  {
+    time = henc->CaptureTime - henc->EdgeTime;
+    if (time > 0x7FFFFFFFU)
+    {
+      /* Stopped for half the range of the time */
+      henc->EdgeValid = 0U;
+      velocity = 0.0f;
+    }
+    else
+    {
+      /* No edge since, the next one is at least that far */
+      bound = ((float)henc->Init.CountsPerCapture * (float)henc->Init.CaptureTickHz) / (float)time;
+      if (velocity > bound)
+      {
+        velocity = bound;
+      }
+      else if (velocity < -bound)
+      {
+        velocity = -bound;
+      }
+    }
+  }
+  else
+  {
+    velocity = (float)Delta * (float)henc->Init.UpdateHz;
+  }
+
+  return velocity;
+}
+
+/**
+  * @brief  Write the snapshot not in use, then switch to it.
+  * @param  henc Pointer to a BSP_ENCODER_TypeDef structure.
+  * @retval None
+  */
+static void ENCODER_Publish(BSP_ENCODER_TypeDef *henc)
+{
+  uint32_t sequence = henc->Sequence + 1U;
+  BSP_ENCODER_SnapshotTypeDef *snapshot = &henc->Snapshot[sequence & 1U];
+
+  snapshot->Position = henc->Position;
+  snapshot->Velocity = henc->Velocity;
+  snapshot->Updates  = sequence;
+  __DMB();
+  henc->Sequence = sequence;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
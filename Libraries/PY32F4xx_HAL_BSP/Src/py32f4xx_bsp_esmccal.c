@@ -0,0 +1,452 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmccal.c
+  * @author  MCU Application Team
+  * @brief   ESMC clock calibration BSP service.
+  *          This file provides functions to run the external flash at the
+  *          fastest clock the board reads reliably:
+  *           + Test pattern programmed in a reserved sector
+  *           + Prescaler sweep with repeated pattern reads
+  *           + Result kept in the sector for the next boots
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Reserve a BSP_ESMCCAL_SECTOR_SIZE sector of the flash. Initialize the
+       ESMC with HAL_ESMC_Init(), out of memory-mapped mode, with a prescaler
+       known to work on any board: it writes the pattern and starts the sweep.
+
+   (#) BSP_ESMCCAL_Run() erases the sector and programs the pattern, then
+       lowers the prescaler by one from the initial one. At each step the
+       pattern is read BSP_ESMCCAL_PASSES times with the read command of the
+       preset and compared. The sweep ends at the first failure or at
+       BSP_ESMCCAL_PRESCALER_MIN; the selected prescaler is the fastest pass
+       plus BSP_ESMCCAL_MARGIN. The result is programmed after the pattern and
+       the ESMC is left at the selected prescaler.
+
+   (#) On the next boots call BSP_ESMCCAL_Load() at the safe prescaler. It
+       returns HAL_ERROR when the sector holds no result, when the result is
+       for another HCLK frequency or when its check word does not match: run
+       the calibration again then. BSP_ESMCCAL_Apply() sets the prescaler of
+       the result; HAL_ESMCEx_EnableXIP() keeps it.
+
+   (#) The ESMC has no sampling delay: the prescaler is the only setting
+       swept. The clock mode of the Init structure is kept, modes 0 and 3
+       sample on the same edge. The quad presets need the QE bit of the flash.
+
+   (#) The functions are blocking: the erase takes the sector erase time.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_esmccal.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ESMCCAL BSP ESMCCAL
+  * @brief ESMC clock calibration BSP service
+  * @{
+  */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_ESMCCAL_Private_Types BSP ESMCCAL Private Types
+  * @{
+  */
+/* Result record in the flash, after the pattern */
+typedef struct
+{
+  uint32_t Magic;
+  uint32_t Preset;
+  uint32_t Prescalers;                  /* ClockPrescaler in bits 0 to 7, FastestPass in bits 8 to 15 */
+  uint32_t HclkFreq;
+  uint32_t Check;                       /* Inverted XOR of the other words                          */
+} ESMCCAL_RecordTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ESMCCAL_Private_Constants BSP ESMCCAL Private Constants
+  * @{
+  */
+#define ESMCCAL_MAGIC                   0x4C41434DU    /* "MCAL"                                    */
+#define ESMCCAL_POLL_TIMEOUT            1000U          /* Program or erase, ms                      */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_ESMCCAL_Private_Functions
+  * @{
+  */
+static void ESMCCAL_Pattern(uint8_t *pData);
+static uint32_t ESMCCAL_Check(const ESMCCAL_RecordTypeDef *pRecord);
+static HAL_StatusTypeDef ESMCCAL_SetPrescaler(ESMC_HandleTypeDef *hesmc, uint32_t Prescaler);
+static HAL_StatusTypeDef ESMCCAL_Wait(BSP_ESMCFLASH_TypeDef *hflash);
+static HAL_StatusTypeDef ESMCCAL_Program(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                         uint32_t Size);
+static uint32_t ESMCCAL_Verify(ESMC_HandleTypeDef *hesmc, const ESMC_CommandTypeDef *pCommand,
+                               const uint8_t *pPattern, uint8_t *pBuffer);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ESMCCAL_Exported_Functions BSP ESMCCAL Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_ESMCCAL_Exported_Functions_Group1 Calibration functions
+  * @brief    Calibration functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Calibration functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Find the fastest reliable prescaler of a read preset
+      (+) Load and apply the result of a previous calibration
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Sweep the ESMC prescaler on a test pattern and keep the fastest reliable one.
+  * @param  hesmc ESMC handle initialized at a safe prescaler, out of memory-mapped mode.
+  * @param  Preset Read preset to calibrate, a value of @ref ESMCEx_XIP_Preset.
+  * @param  Address Sector of the calibration, aligned on BSP_ESMCCAL_SECTOR_SIZE.
+  * @param  CSPinSel Chip select of the flash, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  pResult Result, also programmed in the sector.
+  * @retval HAL status, HAL_ERROR when the pattern fails at the safe prescaler
+  */
+HAL_StatusTypeDef BSP_ESMCCAL_Run(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t Address, uint32_t CSPinSel,
+                                  BSP_ESMCCAL_ResultTypeDef *pResult)
+{
+  uint8_t pattern[BSP_ESMCCAL_PATTERN_SIZE];
+  uint8_t buffer[BSP_ESMCCAL_PATTERN_SIZE];
+  BSP_ESMCFLASH_TypeDef flash;
+  ESMCCAL_RecordTypeDef record;
+  ESMC_CommandTypeDef cmd;
+  uint32_t safe;
+  uint32_t prescaler;
+  HAL_StatusTypeDef status;
+
+  if ((hesmc == NULL) || (pResult == NULL) || ((Address % BSP_ESMCCAL_SECTOR_SIZE) != 0U) ||
+      (hesmc->Init.ClockPrescaler < BSP_ESMCCAL_PRESCALER_MIN) ||
+      (HAL_ESMCEx_GetXIPCommand(Preset, ESMC_ADDRESS_24_BITS, &cmd) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+  cmd.Address  = Address;
+  cmd.NbData   = BSP_ESMCCAL_PATTERN_SIZE;
+  cmd.CSPinSel = CSPinSel;
+
+  status = BSP_ESMCFLASH_Init(&flash, hesmc, CSPinSel, 1U);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  /* Pattern written at the safe prescaler */
+  safe = hesmc->Init.ClockPrescaler;
+  ESMCCAL_Pattern(pattern);
+  status = BSP_ESMCFLASH_Erase_IT(&flash, Address, BSP_ESMCFLASH_ERASE_SECTOR);
+  if (status == HAL_OK)
+  {
+    status = ESMCCAL_Wait(&flash);
+  }
+  if (status == HAL_OK)
+  {
+    status = ESMCCAL_Program(&flash, Address, pattern, BSP_ESMCCAL_PATTERN_SIZE);
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  if (ESMCCAL_Verify(hesmc, &cmd, pattern, buffer) == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Faster until the first failure, a pass beyond it is not trusted */
+  prescaler = safe;
+  while (prescaler > BSP_ESMCCAL_PRESCALER_MIN)
+  {
+    status = ESMCCAL_SetPrescaler(hesmc, prescaler - 1U);
+    if ((status != HAL_OK) || (ESMCCAL_Verify(hesmc, &cmd, pattern, buffer) == 0U))
+    {
+      break;
+    }
+    prescaler--;
+  }
+
+  pResult->Preset         = Preset;
+  pResult->FastestPass    = prescaler;
+  pResult->ClockPrescaler = ((prescaler + BSP_ESMCCAL_MARGIN) < safe) ? (prescaler + BSP_ESMCCAL_MARGIN) : safe;
+  pResult->HclkFreq       = HAL_RCC_GetHCLKFreq();
+
+  /* A failed read may leave the ESMC in error, the result is written at the safe prescaler */
+  hesmc->State = HAL_ESMC_STATE_READY;
+  status = ESMCCAL_SetPrescaler(hesmc, safe);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  record.Magic      = ESMCCAL_MAGIC;
+  record.Preset     = pResult->Preset;
+  record.Prescalers = pResult->ClockPrescaler | (pResult->FastestPass << 8);
+  record.HclkFreq   = pResult->HclkFreq;
+  record.Check      = ESMCCAL_Check(&record);
+  status = ESMCCAL_Program(&flash, Address + BSP_ESMCCAL_PATTERN_SIZE, (uint8_t *)&record, sizeof(record));
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return BSP_ESMCCAL_Apply(hesmc, pResult);
+}
+
+/**
+  * @brief  Load the result of a previous calibration.
+  * @param  hesmc ESMC handle initialized at a safe prescaler, out of memory-mapped mode.
+  * @param  Address Sector of the calibration.
+  * @param  CSPinSel Chip select of the flash, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  pResult Result read from the sector.
+  * @retval HAL status, HAL_ERROR when no valid result for the current HCLK is stored
+  */
+HAL_StatusTypeDef BSP_ESMCCAL_Load(ESMC_HandleTypeDef *hesmc, uint32_t Address, uint32_t CSPinSel,
+                                   BSP_ESMCCAL_ResultTypeDef *pResult)
+{
+  BSP_ESMCFLASH_TypeDef flash;
+  ESMCCAL_RecordTypeDef record;
+  HAL_StatusTypeDef status;
+
+  if ((hesmc == NULL) || (pResult == NULL) || ((Address % BSP_ESMCCAL_SECTOR_SIZE) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = BSP_ESMCFLASH_Init(&flash, hesmc, CSPinSel, 1U);
+  if (status == HAL_OK)
+  {
+    status = BSP_ESMCFLASH_Read(&flash, Address + BSP_ESMCCAL_PATTERN_SIZE, (uint8_t *)&record, sizeof(record));
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  if ((record.Magic != ESMCCAL_MAGIC) || (record.Check != ESMCCAL_Check(&record)) ||
+      (record.HclkFreq != HAL_RCC_GetHCLKFreq()) || ((record.Prescalers & 0xFFU) < BSP_ESMCCAL_PRESCALER_MIN))
+  {
+    return HAL_ERROR;
+  }
+
+  pResult->Preset         = record.Preset;
+  pResult->ClockPrescaler = record.Prescalers & 0xFFU;
+  pResult->FastestPass    = (record.Prescalers >> 8) & 0xFFU;
+  pResult->HclkFreq       = record.HclkFreq;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run the ESMC at the prescaler of a calibration result.
+  * @param  hesmc ESMC handle initialized, out of memory-mapped mode.
+  * @param  pResult Result of BSP_ESMCCAL_Run() or BSP_ESMCCAL_Load().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ESMCCAL_Apply(ESMC_HandleTypeDef *hesmc, const BSP_ESMCCAL_ResultTypeDef *pResult)
+{
+  if ((hesmc == NULL) || (pResult == NULL) || (pResult->ClockPrescaler < BSP_ESMCCAL_PRESCALER_MIN) ||
+      (pResult->ClockPrescaler > 0xFFU))
+  {
+    return HAL_ERROR;
+  }
+  if (hesmc->State != HAL_ESMC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  return ESMCCAL_SetPrescaler(hesmc, pResult->ClockPrescaler);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ESMCCAL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Build the test pattern.
+  * @note   Alternate bits and lines, full swings, then pseudo-random bytes.
+  * @param  pData Pattern, BSP_ESMCCAL_PATTERN_SIZE bytes.
+  * @retval None
+  */
+static void ESMCCAL_Pattern(uint8_t *pData)
+{
+  uint32_t lfsr = 0xACE1U;
+  uint32_t i;
+
+  for (i = 0U; i < BSP_ESMCCAL_PATTERN_SIZE; i++)
+  {
+    if (i < 32U)
+    {
+      pData[i] = ((i & 1U) != 0U) ? 0xAAU : 0x55U;
+    }
+    else if (i < 64U)
+    {
+      pData[i] = ((i & 1U) != 0U) ? 0xFFU : 0x00U;
+    }
+    else if (i < 96U)
+    {
+      pData[i] = (uint8_t)(1U << (i & 7U));
+    }
+    else
+    {
+      lfsr = (lfsr >> 1) ^ ((0U - (lfsr & 1U)) & 0xB400U);
+      pData[i] = (uint8_t)lfsr;
+    }
+  }
+}
+
+/**
+  * @brief  Check word of a result record.
+  * @param  pRecord Record, its Check is ignored.
+  * @retval Check word
+  */
+static uint32_t ESMCCAL_Check(const ESMCCAL_RecordTypeDef *pRecord)
+{
+  return ~(pRecord->Magic ^ pRecord->Preset ^ pRecord->Prescalers ^ pRecord->HclkFreq);
+}
+
+/**
+  * @brief  Change the ESMC prescaler.
+  * @param  hesmc ESMC handle
+  * @param  Prescaler New prescaler.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCCAL_SetPrescaler(ESMC_HandleTypeDef *hesmc, uint32_t Prescaler)
+{
+  hesmc->Init.ClockPrescaler = Prescaler;
+
+  return HAL_ESMC_Init(hesmc);
+}
+
+/**
+  * @brief  Wait for the end of a flash operation, polling its status from here.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCCAL_Wait(BSP_ESMCFLASH_TypeDef *hflash)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (BSP_ESMCFLASH_IsBusy(hflash) != 0U)
+  {
+    BSP_ESMCFLASH_Tick(hflash);
+    if ((HAL_GetTick() - tickstart) > ESMCCAL_POLL_TIMEOUT)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return (hflash->LastStatus == BSP_ESMCFLASH_STATUS_OK) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Program erased flash and wait for the end.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Address First address.
+  * @param  pData Data to program.
+  * @param  Size Number of bytes.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCCAL_Program(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                         uint32_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  status = BSP_ESMCFLASH_Program_IT(hflash, Address, pData, Size);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return ESMCCAL_Wait(hflash);
+}
+
+/**
+  * @brief  Read the pattern BSP_ESMCCAL_PASSES times and compare it.
+  * @param  hesmc ESMC handle
+  * @param  pCommand Read command of the pattern.
+  * @param  pPattern Expected pattern.
+  * @param  pBuffer Read buffer, BSP_ESMCCAL_PATTERN_SIZE bytes.
+  * @retval 1 when every read matches, 0 otherwise
+  */
+static uint32_t ESMCCAL_Verify(ESMC_HandleTypeDef *hesmc, const ESMC_CommandTypeDef *pCommand,
+                               const uint8_t *pPattern, uint8_t *pBuffer)
+{
+  ESMC_CommandTypeDef cmd = *pCommand;
+  uint32_t pass;
+
+  for (pass = 0U; pass < BSP_ESMCCAL_PASSES; pass++)
+  {
+    memset(pBuffer, 0, BSP_ESMCCAL_PATTERN_SIZE);
+    if ((HAL_ESMC_Command(hesmc, &cmd, hesmc->Timeout) != HAL_OK) ||
+        (HAL_ESMC_Receive(hesmc, pBuffer, hesmc->Timeout) != HAL_OK) ||
+        (memcmp(pBuffer, pPattern, BSP_ESMCCAL_PATTERN_SIZE) != 0))
+    {
+      return 0U;
+    }
+  }
+
+  return 1U;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,536 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmcflash.c
+  * @author  MCU Application Team
+  * @brief   ESMC flash background operation BSP service.
+  *          This file provides functions to erase and program a serial NOR
+  *          flash on the ESMC without waiting for the end of the operation:
+  *           + Erase and program started in a few microseconds
+  *           + Status register polled from a periodic tick
+  *           + Next page started on the end of the previous one
+  *           + Completion callback with timeout detection
+  *           + Blocking fast read between the operations
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ESMC with HAL_ESMC_Init(), out of memory-mapped mode.
+       The ESMC has no hardware status polling: the end of the operations is
+       found by reading the status register from a tick.
+
+   (#) Call BSP_ESMCFLASH_Init() with the chip select of the flash and the
+       number of ticks between two status reads, then call BSP_ESMCFLASH_Tick()
+       periodically, for instance from a timer update interrupt at 1 kHz. A
+       status read takes the ESMC for about 16 SCK cycles.
+
+   (#) BSP_ESMCFLASH_Erase_IT() sends a write enable and the erase command of
+       a sector, a block or the whole flash and returns. BSP_ESMCFLASH_Program_IT()
+       sends the first page program; each page ending in the flash starts the
+       next one from the tick, with at most BSP_ESMCFLASH_PAGE_SIZE bytes sent
+       in the interrupt. The source buffer must stay valid until the callback.
+
+   (#) BSP_ESMCFLASH_OpCpltCallback() is called from the tick when the write
+       in progress bit clears, with BSP_ESMCFLASH_STATUS_TIMEOUT when the flash
+       is still busy after the timeout of the step, or with
+       BSP_ESMCFLASH_STATUS_ERROR when an ESMC command fails.
+
+   (#) BSP_ESMCFLASH_Read() reads with the fast read command when no operation
+       runs. LastStatus keeps the end of the last operation, for the callers
+       waiting on BSP_ESMCFLASH_IsBusy() instead of the callback.
+
+   (#) The ESMC must not be used by other functions until the callback. The
+       command timeouts come from HAL_GetTick(): give SysTick a higher
+       priority than the tick interrupt.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_esmcflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ESMCFLASH BSP ESMCFLASH
+  * @brief ESMC flash background operation BSP service
+  * @{
+  */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ESMCFLASH_Private_Constants BSP ESMCFLASH Private Constants
+  * @{
+  */
+#define ESMCFLASH_CMD_WRITE_ENABLE      0x06U          /* Write enable              */
+#define ESMCFLASH_CMD_READ_STATUS       0x05U          /* Read status register 1    */
+#define ESMCFLASH_CMD_PAGE_PROGRAM      0x02U          /* Page program              */
+#define ESMCFLASH_STATUS_WIP            0x01U          /* Write in progress bit     */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ESMCFLASH_Private_Variables BSP ESMCFLASH Private Variables
+  * @{
+  */
+/* Command and timeout of each BSP_ESMCFLASH_Erase value */
+static const uint8_t ESMCFLASH_EraseCmd[3] = {0x20U, 0xD8U, 0xC7U};
+static const uint32_t ESMCFLASH_EraseTimeout[3] =
+{
+  BSP_ESMCFLASH_SECTOR_TIMEOUT, BSP_ESMCFLASH_BLOCK_TIMEOUT, BSP_ESMCFLASH_CHIP_TIMEOUT
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_ESMCFLASH_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef ESMCFLASH_Command(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Instruction,
+                                           uint32_t Address, uint32_t AddressMode);
+static HAL_StatusTypeDef ESMCFLASH_ProgramPage(BSP_ESMCFLASH_TypeDef *hflash);
+static HAL_StatusTypeDef ESMCFLASH_ReadStatus(BSP_ESMCFLASH_TypeDef *hflash, uint8_t *pStatus);
+static void ESMCFLASH_End(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ESMCFLASH_Exported_Functions BSP ESMCFLASH Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_ESMCFLASH_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind the service to an ESMC and a chip select
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the background operations of a flash.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  hesmc Pointer to an ESMC_HandleTypeDef structure initialized.
+  * @param  CSPinSel Chip select of the flash, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  PollPeriod Ticks between two status reads, 1 or more.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ESMCFLASH_Init(BSP_ESMCFLASH_TypeDef *hflash, ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel,
+                                     uint32_t PollPeriod)
+{
+  if ((hflash == NULL) || (hesmc == NULL) || (PollPeriod == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hesmc->State != HAL_ESMC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hflash->CSPinSel   = CSPinSel;
+  hflash->PollPeriod = PollPeriod;
+  hflash->Countdown  = 0U;
+  hflash->State      = BSP_ESMCFLASH_STATE_IDLE;
+  hflash->Remaining  = 0U;
+  hflash->PollCount  = 0U;
+  hflash->LastStatus = BSP_ESMCFLASH_STATUS_OK;
+  hflash->hesmc      = hesmc;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ESMCFLASH_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Start an erase or a program
+      (+) Read the flash
+      (+) Poll the flash status from a tick
+      (+) Check whether an operation runs
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start an erase, its end is reported by BSP_ESMCFLASH_OpCpltCallback().
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Address Address in the sector or block, ignored for a chip erase.
+  * @param  Erase A value of @ref BSP_ESMCFLASH_Erase.
+  * @retval HAL status, HAL_BUSY when an operation runs
+  */
+HAL_StatusTypeDef BSP_ESMCFLASH_Erase_IT(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, uint32_t Erase)
+{
+  HAL_StatusTypeDef status;
+
+  if ((hflash->hesmc == NULL) || (Erase > BSP_ESMCFLASH_ERASE_CHIP))
+  {
+    return HAL_ERROR;
+  }
+  if (hflash->State != BSP_ESMCFLASH_STATE_IDLE)
+  {
+    return HAL_BUSY;
+  }
+
+  status = ESMCFLASH_Command(hflash, ESMCFLASH_CMD_WRITE_ENABLE, 0U, ESMC_ADDRESS_NONE);
+  if (status == HAL_OK)
+  {
+    status = ESMCFLASH_Command(hflash, ESMCFLASH_EraseCmd[Erase], Address,
+                               (Erase == BSP_ESMCFLASH_ERASE_CHIP) ? ESMC_ADDRESS_NONE : ESMC_ADDRESS_SINGLE_LINE);
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hflash->Remaining = 0U;
+  hflash->PollCount = 0U;
+  hflash->Timeout   = ESMCFLASH_EraseTimeout[Erase];
+  hflash->StartTick = HAL_GetTick();
+  hflash->Countdown = hflash->PollPeriod;
+  hflash->State     = BSP_ESMCFLASH_STATE_ERASE;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a program of erased flash, its end is reported by BSP_ESMCFLASH_OpCpltCallback().
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Address First address.
+  * @param  pData Data to program, valid until the callback.
+  * @param  Size Number of bytes.
+  * @retval HAL status, HAL_BUSY when an operation runs
+  */
+HAL_StatusTypeDef BSP_ESMCFLASH_Program_IT(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                           uint32_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if ((hflash->hesmc == NULL) || (pData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hflash->State != BSP_ESMCFLASH_STATE_IDLE)
+  {
+    return HAL_BUSY;
+  }
+
+  hflash->Address   = Address;
+  hflash->pData     = pData;
+  hflash->Remaining = Size;
+  hflash->PollCount = 0U;
+
+  status = ESMCFLASH_ProgramPage(hflash);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hflash->Countdown = hflash->PollPeriod;
+  hflash->State     = BSP_ESMCFLASH_STATE_PROGRAM;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read the flash with the fast read command.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Address First address.
+  * @param  pData Destination buffer.
+  * @param  Size Number of bytes.
+  * @retval HAL status, HAL_BUSY when an operation runs
+  */
+HAL_StatusTypeDef BSP_ESMCFLASH_Read(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData,
+                                     uint32_t Size)
+{
+  ESMC_CommandTypeDef cmd;
+  HAL_StatusTypeDef status;
+
+  if ((hflash->hesmc == NULL) || (pData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hflash->State != BSP_ESMCFLASH_STATE_IDLE)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_ESMCEx_GetXIPCommand(ESMCEX_XIP_FAST_READ, ESMC_ADDRESS_24_BITS, &cmd);
+  cmd.Address  = Address;
+  cmd.NbData   = Size;
+  cmd.CSPinSel = hflash->CSPinSel;
+
+  status = HAL_ESMC_Command(hflash->hesmc, &cmd, hflash->hesmc->Timeout);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Receive(hflash->hesmc, pData, hflash->hesmc->Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Poll the flash status, to be called periodically.
+  * @note   Does nothing when no operation runs.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @retval None
+  */
+void BSP_ESMCFLASH_Tick(BSP_ESMCFLASH_TypeDef *hflash)
+{
+  uint8_t status;
+
+  if ((hflash->State == BSP_ESMCFLASH_STATE_IDLE) || (--hflash->Countdown != 0U))
+  {
+    return;
+  }
+  hflash->Countdown = hflash->PollPeriod;
+
+  hflash->PollCount++;
+  if (ESMCFLASH_ReadStatus(hflash, &status) != HAL_OK)
+  {
+    ESMCFLASH_End(hflash, BSP_ESMCFLASH_STATUS_ERROR);
+    return;
+  }
+
+  if ((status & ESMCFLASH_STATUS_WIP) != 0U)
+  {
+    if ((HAL_GetTick() - hflash->StartTick) > hflash->Timeout)
+    {
+      ESMCFLASH_End(hflash, BSP_ESMCFLASH_STATUS_TIMEOUT);
+    }
+    return;
+  }
+
+  if (hflash->Remaining == 0U)
+  {
+    ESMCFLASH_End(hflash, BSP_ESMCFLASH_STATUS_OK);
+  }
+  else if (ESMCFLASH_ProgramPage(hflash) != HAL_OK)
+  {
+    ESMCFLASH_End(hflash, BSP_ESMCFLASH_STATUS_ERROR);
+  }
+  else
+  {
+    /* Next page running in the flash */
+  }
+}
+
+/**
+  * @brief  Check whether an operation runs.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @retval 1 when an erase or a program runs, 0 otherwise
+  */
+uint32_t BSP_ESMCFLASH_IsBusy(const BSP_ESMCFLASH_TypeDef *hflash)
+{
+  return (hflash->State != BSP_ESMCFLASH_STATE_IDLE) ? 1U : 0U;
+}
+
+/**
+  * @brief  Operation end callback.
+  * @note   Called from BSP_ESMCFLASH_Tick(), a new operation may be started from it.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Status A value of @ref BSP_ESMCFLASH_Status.
+  * @retval None
+  */
+__weak void BSP_ESMCFLASH_OpCpltCallback(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hflash);
+  UNUSED(Status);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ESMCFLASH_OpCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ESMCFLASH_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Send an instruction with an optional address and no data.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Instruction Flash command.
+  * @param  Address Flash address, when AddressMode is not ESMC_ADDRESS_NONE.
+  * @param  AddressMode ESMC_ADDRESS_NONE or ESMC_ADDRESS_SINGLE_LINE.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCFLASH_Command(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Instruction,
+                                           uint32_t Address, uint32_t AddressMode)
+{
+  ESMC_CommandTypeDef cmd = {0};
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = Instruction;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.Address           = Address;
+  cmd.AddressMode       = AddressMode;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_NONE;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = hflash->CSPinSel;
+
+  return HAL_ESMC_Command(hflash->hesmc, &cmd, BSP_ESMCFLASH_CMD_TIMEOUT);
+}
+
+/**
+  * @brief  Start the program of the next page part.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCFLASH_ProgramPage(BSP_ESMCFLASH_TypeDef *hflash)
+{
+  ESMC_CommandTypeDef cmd = {0};
+  HAL_StatusTypeDef status;
+  uint32_t chunk;
+
+  /* A page program wraps at the end of its page */
+  chunk = BSP_ESMCFLASH_PAGE_SIZE - (hflash->Address % BSP_ESMCFLASH_PAGE_SIZE);
+  if (chunk > hflash->Remaining)
+  {
+    chunk = hflash->Remaining;
+  }
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = ESMCFLASH_CMD_PAGE_PROGRAM;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.Address           = hflash->Address;
+  cmd.AddressMode       = ESMC_ADDRESS_SINGLE_LINE;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_WRITE;
+  cmd.NbData            = chunk;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = hflash->CSPinSel;
+
+  status = ESMCFLASH_Command(hflash, ESMCFLASH_CMD_WRITE_ENABLE, 0U, ESMC_ADDRESS_NONE);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Command(hflash->hesmc, &cmd, BSP_ESMCFLASH_CMD_TIMEOUT);
+  }
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Transmit(hflash->hesmc, (uint8_t *)hflash->pData, BSP_ESMCFLASH_CMD_TIMEOUT);
+  }
+  if (status == HAL_OK)
+  {
+    hflash->Address   += chunk;
+    hflash->pData     += chunk;
+    hflash->Remaining -= chunk;
+    hflash->Timeout    = BSP_ESMCFLASH_PROGRAM_TIMEOUT;
+    hflash->StartTick  = HAL_GetTick();
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Read the status register 1.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  pStatus Status register value.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCFLASH_ReadStatus(BSP_ESMCFLASH_TypeDef *hflash, uint8_t *pStatus)
+{
+  ESMC_CommandTypeDef cmd = {0};
+  HAL_StatusTypeDef status;
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = ESMCFLASH_CMD_READ_STATUS;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_NONE;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_READ;
+  cmd.NbData            = 1U;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = hflash->CSPinSel;
+
+  status = HAL_ESMC_Command(hflash->hesmc, &cmd, BSP_ESMCFLASH_CMD_TIMEOUT);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Receive(hflash->hesmc, pStatus, BSP_ESMCFLASH_CMD_TIMEOUT);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End the operation and report it.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @param  Status A value of @ref BSP_ESMCFLASH_Status.
+  * @retval None
+  */
+static void ESMCFLASH_End(BSP_ESMCFLASH_TypeDef *hflash, uint32_t Status)
+{
+  /* A command left in error blocks the next operations */
+  if (hflash->hesmc->State == HAL_ESMC_STATE_ERROR)
+  {
+    hflash->hesmc->State = HAL_ESMC_STATE_READY;
+  }
+
+  hflash->Remaining  = 0U;
+  hflash->LastStatus = Status;
+  hflash->State      = BSP_ESMCFLASH_STATE_IDLE;
+  BSP_ESMCFLASH_OpCpltCallback(hflash, Status);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,365 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_esmcqueue.c
+  * @author  MCU Application Team
+  * @brief   ESMC read queue BSP service.
+  *          This file provides functions to load many blocks from an external
+  *          memory without main loop involvement:
+  *           + Queue of {command, address, size, destination} read requests
+  *           + Each request issued from the DMA completion of the previous one
+  *           + Completion callback per request
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the ESMC with HAL_ESMC_Init(), out of memory-mapped mode,
+       link a DMA channel in DMA_NORMAL mode to its hdmarx and enable the DMA
+       channel interrupt in the NVIC. A byte DMA takes any size, a word DMA
+       sizes multiple of 4 and word aligned buffers.
+
+   (#) Call BSP_ESMCQUEUE_Init() with the ESMC handle. The queue then owns the
+       ESMC: the HAL functions must not be used on it while a request is
+       queued.
+
+   (#) From HAL_ESMC_RxCpltCallback() call BSP_ESMCQUEUE_RxCpltHandler() and
+       from HAL_ESMC_ErrorCallback() call BSP_ESMCQUEUE_ErrorHandler().
+
+   (#) Fill a BSP_ESMCQUEUE_ReqTypeDef and queue it with BSP_ESMCQUEUE_Submit()
+       from any context. The requests run in submission order:
+       (+) The read command of the next request, HAL_ESMC_Command(), and its
+           DMA receive, HAL_ESMC_Receive_DMA(), are issued from the DMA
+           completion interrupt of the previous one, with no main loop turn
+           between two reads.
+       (+) Several requests can share one ESMC_CommandTypeDef, for instance a
+           fast read from HAL_ESMCEx_GetXIPCommand(), only the address and the
+           size change.
+       (+) BSP_ESMCQUEUE_ReqCpltCallback() is called with the Status set, the
+           request can then be reused or submitted again.
+
+   (#) The wait for the ESMC to get idle is bounded with HAL_GetTick(): give
+       SysTick a higher priority than the DMA channel.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_esmcqueue.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ESMCQUEUE BSP ESMCQUEUE
+  * @brief ESMC read queue BSP service
+  * @{
+  */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_ESMCQUEUE_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef ESMCQUEUE_Start(BSP_ESMCQUEUE_TypeDef *hqueue);
+static void ESMCQUEUE_End(BSP_ESMCQUEUE_TypeDef *hqueue, uint32_t Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ESMCQUEUE_Exported_Functions BSP ESMCQUEUE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_ESMCQUEUE_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind the queue to an ESMC
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a read queue on an ESMC.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @param  hesmc Pointer to an ESMC_HandleTypeDef structure initialized, hdmarx
+  *               in DMA_NORMAL mode must be linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ESMCQUEUE_Init(BSP_ESMCQUEUE_TypeDef *hqueue, ESMC_HandleTypeDef *hesmc)
+{
+  if ((hqueue == NULL) || (hesmc == NULL) || (hesmc->hdmarx == NULL) ||
+      (hesmc->hdmarx->Init.Mode != DMA_NORMAL))
+  {
+    return HAL_ERROR;
+  }
+  if (hesmc->State != HAL_ESMC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hqueue->pHead      = NULL;
+  hqueue->pTail      = NULL;
+  hqueue->ErrorCount = 0U;
+  hqueue->hesmc      = hesmc;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_ESMCQUEUE_Exported_Functions_Group2 Request functions
+  * @brief    Request functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Request functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Queue a read request
+      (+) Check the end of the queued requests
+      (+) Drive the queue from the ESMC callbacks
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Queue a read request, it starts at once when the queue is idle.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @param  pReq Request, it must not be modified before its callback.
+  * @retval HAL status, HAL_BUSY when the request is already queued
+  */
+HAL_StatusTypeDef BSP_ESMCQUEUE_Submit(BSP_ESMCQUEUE_TypeDef *hqueue, BSP_ESMCQUEUE_ReqTypeDef *pReq)
+{
+  uint32_t primask_bit;
+  uint32_t items;
+
+  if ((hqueue == NULL) || (hqueue->hesmc == NULL) || (pReq == NULL) || (pReq->pCommand == NULL) ||
+      (pReq->pData == NULL) || (pReq->Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  items = pReq->Size;
+  if (hqueue->hesmc->hdmarx->Init.PeriphDataAlignment == DMA_PDATAALIGN_WORD)
+  {
+    if ((pReq->Size % 4U) != 0U)
+    {
+      return HAL_ERROR;
+    }
+    items = pReq->Size / 4U;
+  }
+  if (items > BSP_ESMCQUEUE_SIZE_MAX)
+  {
+    return HAL_ERROR;
+  }
+  if (pReq->Status == BSP_ESMCQUEUE_STATUS_QUEUED)
+  {
+    return HAL_BUSY;
+  }
+
+  pReq->Status = BSP_ESMCQUEUE_STATUS_QUEUED;
+  pReq->pNext  = NULL;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (hqueue->pHead == NULL)
+  {
+    hqueue->pHead = pReq;
+    hqueue->pTail = pReq;
+    if (ESMCQUEUE_Start(hqueue) != HAL_OK)
+    {
+      ESMCQUEUE_End(hqueue, BSP_ESMCQUEUE_STATUS_ERROR);
+    }
+  }
+  else
+  {
+    hqueue->pTail->pNext = pReq;
+    hqueue->pTail = pReq;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check whether all the queued requests ended.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @retval 1 when the queue is idle, 0 otherwise
+  */
+uint32_t BSP_ESMCQUEUE_IsIdle(const BSP_ESMCQUEUE_TypeDef *hqueue)
+{
+  return (hqueue->pHead == NULL) ? 1U : 0U;
+}
+
+/**
+  * @brief  End the request on the bus and start the next one.
+  * @note   To be called from HAL_ESMC_RxCpltCallback() for the queue ESMC.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_ESMCQUEUE_RxCpltHandler(BSP_ESMCQUEUE_TypeDef *hqueue)
+{
+  if ((hqueue->hesmc != NULL) && (hqueue->pHead != NULL))
+  {
+    ESMCQUEUE_End(hqueue, BSP_ESMCQUEUE_STATUS_OK);
+  }
+}
+
+/**
+  * @brief  Drop the request on the bus and start the next one.
+  * @note   To be called from HAL_ESMC_ErrorCallback() for the queue ESMC.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_ESMCQUEUE_ErrorHandler(BSP_ESMCQUEUE_TypeDef *hqueue)
+{
+  if ((hqueue->hesmc != NULL) && (hqueue->pHead != NULL))
+  {
+    ESMCQUEUE_End(hqueue, BSP_ESMCQUEUE_STATUS_ERROR);
+  }
+}
+
+/**
+  * @brief  Request end callback.
+  * @note   Called from the DMA interrupt, pReq->Status holds the result.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @param  pReq Request ended.
+  * @retval None
+  */
+__weak void BSP_ESMCQUEUE_ReqCpltCallback(BSP_ESMCQUEUE_TypeDef *hqueue, BSP_ESMCQUEUE_ReqTypeDef *pReq)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hqueue);
+  UNUSED(pReq);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ESMCQUEUE_ReqCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ESMCQUEUE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Issue the command and the DMA receive of the request at the head of the queue.
+  * @note   Called with the interrupts disabled or from the DMA interrupt.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCQUEUE_Start(BSP_ESMCQUEUE_TypeDef *hqueue)
+{
+  BSP_ESMCQUEUE_ReqTypeDef *pReq = hqueue->pHead;
+  HAL_StatusTypeDef status;
+
+  hqueue->Command          = *pReq->pCommand;
+  hqueue->Command.Address  = pReq->Address;
+  hqueue->Command.DataMode = ESMC_DATA_READ;
+  hqueue->Command.NbData   = pReq->Size;
+
+  status = HAL_ESMC_Command(hqueue->hesmc, &hqueue->Command, BSP_ESMCQUEUE_TIMEOUT);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Receive_DMA(hqueue->hesmc, pReq->pData);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End the request at the head of the queue and start the next one.
+  * @param  hqueue Pointer to a BSP_ESMCQUEUE_TypeDef structure.
+  * @param  Status A value of @ref BSP_ESMCQUEUE_Status.
+  * @retval None
+  */
+static void ESMCQUEUE_End(BSP_ESMCQUEUE_TypeDef *hqueue, uint32_t Status)
+{
+  BSP_ESMCQUEUE_ReqTypeDef *pReq;
+
+  /* Loop instead of recursing when the next start fails */
+  for (;;)
+  {
+    pReq = hqueue->pHead;
+
+    if (Status != BSP_ESMCQUEUE_STATUS_OK)
+    {
+      hqueue->ErrorCount++;
+
+      /* A command left in error blocks the next ones */
+      if (hqueue->hesmc->State == HAL_ESMC_STATE_ERROR)
+      {
+        hqueue->hesmc->State = HAL_ESMC_STATE_READY;
+      }
+    }
+
+    hqueue->pHead = pReq->pNext;
+    if (hqueue->pHead == NULL)
+    {
+      hqueue->pTail = NULL;
+    }
+    pReq->Status = Status;
+    BSP_ESMCQUEUE_ReqCpltCallback(hqueue, pReq);
+
+    if ((hqueue->pHead == NULL) || (ESMCQUEUE_Start(hqueue) == HAL_OK))
+    {
+      return;
+    }
+    Status = BSP_ESMCQUEUE_STATUS_ERROR;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
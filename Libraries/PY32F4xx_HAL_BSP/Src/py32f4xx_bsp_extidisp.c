@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_extidisp.c
+  * @author  MCU Application Team
+  * @brief   EXTI dispatcher BSP service.
+  *          This file provides functions to call a handler per EXTI line:
+  *           + Handler and context per line
+  *           + Pending lines scanned with CLZ, the shared vectors included
+  *           + Handlers deferred to a software interrupt at a low priority
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_GPIO_EXTI_IRQHandler() calls the single HAL_GPIO_EXTI_Callback()
+       for every line and is called for every line of the shared vectors in
+       turn. This service reads PR once per interrupt, clears it in one
+       write and calls the handler registered for each line set, the
+       highest line first, found with __CLZ().
+
+   (#) Configure the pins with HAL_GPIO_Init() in a GPIO_MODE_IT_x mode and
+       call BSP_EXTIDISP_IRQHandler() from the EXTI vectors, the lines of
+       the vector in parameter:
+       (+) GPIO_PIN_0 to GPIO_PIN_4 from EXTI0_IRQHandler() to
+           EXTI4_IRQHandler(),
+       (+) BSP_EXTIDISP_LINES_9_5 from EXTI9_5_IRQHandler(),
+       (+) BSP_EXTIDISP_LINES_15_10 from EXTI15_10_IRQHandler().
+       A line without a handler calls HAL_GPIO_EXTI_Callback() as before.
+
+   (#) BSP_EXTIDISP_Register() sets the handler of a line and its context.
+       BSP_EXTIDISP_MODE_IMMEDIATE calls it from the EXTI interrupt, for the
+       lines needing the shortest latency. BSP_EXTIDISP_MODE_DEFERRED only
+       marks the line and pends BSP_EXTIDISP_SWI_IRQn, PendSV by default:
+       give it the lowest priority and call BSP_EXTIDISP_DeferredHandler()
+       from its handler. The EXTI interrupt is then a few cycles long and
+       the long handlers run after every other interrupt. With an RTOS
+       using PendSV, define BSP_EXTIDISP_SWI_IRQn to an unused vector.
+
+   (#) Edges of a deferred line before its handler ran are merged into one
+       call and counted as overruns. BSP_EXTIDISP_GetStats() gives the
+       edges dispatched and merged of a line.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_extidisp.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_EXTIDISP BSP EXTIDISP
+  * @brief EXTI dispatcher BSP service
+  * @{
+  */
+
+#if defined (HAL_GPIO_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Private_Types BSP EXTIDISP Private Types
+  * @{
+  */
+typedef struct
+{
+  void                    (*Handler)(uint32_t Line, void *pContext); /*!< NULL for HAL_GPIO_EXTI_Callback() */
+
+  void                    *pContext;    /*!< Context of the handler                                 */
+
+  BSP_EXTIDISP_StatsTypeDef Stats;      /*!< Counters since the registration                        */
+
+} EXTIDISP_LineTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Private_Constants BSP EXTIDISP Private Constants
+  * @{
+  */
+#define EXTIDISP_LINES_MASK             ((1UL << BSP_EXTIDISP_LINES) - 1U)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Private_Variables BSP EXTIDISP Private Variables
+  * @{
+  */
+static EXTIDISP_LineTypeDef EXTIDISP_Lines[BSP_EXTIDISP_LINES];
+static uint32_t             EXTIDISP_DeferredLines;
+static __IO uint32_t        EXTIDISP_Pending;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Private_Functions BSP EXTIDISP Private Functions
+  * @{
+  */
+static void EXTIDISP_Dispatch(uint32_t Lines);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_EXTIDISP_Exported_Functions BSP EXTIDISP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Set the handler of an EXTI line.
+  * @param  Line EXTI line, 0 to 15.
+  * @param  Handler Called with the line and the context.
+  * @param  pContext Context of the handler.
+  * @param  Mode A value of @ref BSP_EXTIDISP_Mode.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_EXTIDISP_Register(uint32_t Line, void (*Handler)(uint32_t Line, void *pContext),
+                                        void *pContext, uint32_t Mode)
+{
+  uint32_t primask;
+
+  if ((Line >= BSP_EXTIDISP_LINES) || (Handler == NULL) || (Mode > BSP_EXTIDISP_MODE_DEFERRED))
+  {
+    return HAL_ERROR;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  EXTIDISP_Lines[Line].Handler        = Handler;
+  EXTIDISP_Lines[Line].pContext       = pContext;
+  EXTIDISP_Lines[Line].Stats.Events   = 0U;
+  EXTIDISP_Lines[Line].Stats.Overruns = 0U;
+  if (Mode == BSP_EXTIDISP_MODE_DEFERRED)
+  {
+    EXTIDISP_DeferredLines |= (1UL << Line);
+  }
+  else
+  {
+    EXTIDISP_DeferredLines &= ~(1UL << Line);
+  }
+  __set_PRIMASK(primask);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Remove the handler of an EXTI line, back to HAL_GPIO_EXTI_Callback().
+  * @param  Line EXTI line, 0 to 15.
+  * @retval None
+  */
+void BSP_EXTIDISP_Unregister(uint32_t Line)
+{
+  uint32_t primask;
+
+  if (Line >= BSP_EXTIDISP_LINES)
+  {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  EXTIDISP_Lines[Line].Handler  = NULL;
+  EXTIDISP_Lines[Line].pContext = NULL;
+  EXTIDISP_DeferredLines &= ~(1UL << Line);
+  EXTIDISP_Pending       &= ~(1UL << Line);
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Dispatch the pending lines of an EXTI vector.
+  * @param  Lines Lines of the vector, GPIO_PIN_x or @ref BSP_EXTIDISP_Vector_Lines.
+  * @retval None
+  */
+void BSP_EXTIDISP_IRQHandler(uint32_t Lines)
+{
+  uint32_t pending = EXTI->PR & Lines & EXTIDISP_LINES_MASK;
+  uint32_t deferred;
+  uint32_t overruns;
+  uint32_t primask;
+  uint32_t line;
+
+  EXTI->PR = pending;
+
+  deferred = pending & EXTIDISP_DeferredLines;
+  if (deferred != 0U)
+  {
+    /* The EXTI vectors may run at different priorities */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    overruns = EXTIDISP_Pending & deferred;
+    EXTIDISP_Pending |= deferred;
+    while (overruns != 0U)
+    {
+      line = 31U - __CLZ(overruns);
+      overruns &= ~(1UL << line);
+      EXTIDISP_Lines[line].Stats.Overruns++;
+    }
+    __set_PRIMASK(primask);
+
+    if ((int32_t)BSP_EXTIDISP_SWI_IRQn < 0)
+    {
+      SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+    else
+    {
+      NVIC_SetPendingIRQ(BSP_EXTIDISP_SWI_IRQn);
+    }
+  }
+
+  EXTIDISP_Dispatch(pending & ~deferred);
+}
+
+/**
+  * @brief  Dispatch the deferred lines, called from the BSP_EXTIDISP_SWI_IRQn handler.
+  * @retval None
+  */
+void BSP_EXTIDISP_DeferredHandler(void)
+{
+  uint32_t pending;
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  pending = EXTIDISP_Pending;
+  EXTIDISP_Pending = 0U;
+  __set_PRIMASK(primask);
+
+  EXTIDISP_Dispatch(pending);
+}
+
+/**
+  * @brief  Read the statistics of an EXTI line.
+  * @param  Line EXTI line, 0 to 15.
+  * @param  pStats Statistics read, zero for a line out of range.
+  * @retval None
+  */
+void BSP_EXTIDISP_GetStats(uint32_t Line, BSP_EXTIDISP_StatsTypeDef *pStats)
+{
+  uint32_t primask;
+
+  if (Line >= BSP_EXTIDISP_LINES)
+  {
+    pStats->Events   = 0U;
+    pStats->Overruns = 0U;
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  *pStats = EXTIDISP_Lines[Line].Stats;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_EXTIDISP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Call the handlers of lines, the highest line first.
+  * @param  Lines Lines to dispatch.
+  * @retval None
+  */
+static void EXTIDISP_Dispatch(uint32_t Lines)
+{
+  EXTIDISP_LineTypeDef *pline;
+  uint32_t line;
+
+  while (Lines != 0U)
+  {
+    line = 31U - __CLZ(Lines);
+    Lines &= ~(1UL << line);
+
+    pline = &EXTIDISP_Lines[line];
+    pline->Stats.Events++;
+    if (pline->Handler != NULL)
+    {
+      pline->Handler(line, pline->pContext);
+    }
+    else
+    {
+      HAL_GPIO_EXTI_Callback((uint16_t)(1UL << line));
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_GPIO_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fault.c
+  * @author  MCU Application Team
+  * @brief   Fault record BSP service.
+  *          This file provides fault handlers which keep the cause of a crash
+  *          over a reset:
+  *           + Stacked frame and fault status registers saved to __NOINIT RAM
+  *           + Short backtrace of the return addresses found on the stack
+  *           + Immediate reset, the record reported on the next boot
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_FAULT=y, defining USE_BSP_FAULT: this file then
+       provides HardFault_Handler(), MemManage_Handler(), BusFault_Handler()
+       and UsageFault_Handler(), the ones of py32f4xx_it.c being left out.
+       Call BSP_FAULT_Init() early in main() to give the MemManage, BusFault
+       and UsageFault their own handler instead of escalating to HardFault.
+
+   (#) On a fault the handler switches to a stack of BSP_FAULT_STACK_SIZE
+       bytes of its own, the faulting one may be the cause, then saves the
+       stacked frame, the SP, CFSR, HFSR, MMFAR, BFAR and up to
+       BSP_FAULT_BACKTRACE return addresses into a record in __NOINIT RAM. A
+       return address is a word of the stack, from the SP up, pointing right
+       after a BL or BLX of the code: most are real callers, an old one may
+       remain. The handler then resets with HAL_NVIC_SystemReset(), the
+       application is back in milliseconds instead of the watchdog timeout.
+
+   (#) On the next boot, once the output is up, BSP_FAULT_GetRecord() returns
+       HAL_OK and a copy of the record if a fault happened since the last
+       call, BSP_FAULT_Print() prints it with printf(), the addresses ready for
+       arm-none-eabi-addr2line. The record is checked by a checksum: after a
+       power on its RAM is random and nothing is reported. Count gives the
+       faults recorded since the power on.
+
+   (#) BSP_FAULT_Reset() records a software reason the same way, the caller
+       as PC, then resets: for a stack overflow found by BSP_STACK_Check(), a
+       watchdog about to expire or a failed assertion.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "py32f4xx_bsp_fault.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FAULT BSP FAULT
+  * @brief Fault record BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_FAULT_Private_Constants BSP FAULT Private Constants
+  * @{
+  */
+#define FAULT_MAGIC               0xFA017EC0U /*!< Record not reported yet */
+#define FAULT_MAGIC_REPORTED      0xFA017EC1U /*!< Record read by BSP_FAULT_GetRecord() */
+#define FAULT_FRAME_WORDS         8U          /*!< R0-R3, R12, LR, PC, xPSR */
+#define FAULT_FRAME_FP_WORDS      26U         /*!< With S0-S15, FPSCR and the reserved word */
+#define FAULT_EXC_NO_FP           0x00000010U /*!< EXC_RETURN, basic frame */
+#define FAULT_XPSR_ALIGN          0x00000200U /*!< xPSR, one padding word stacked */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_FAULT_Private_Variables BSP FAULT Private Variables
+  * @{
+  */
+extern uint32_t _estack[];                 /* Top of the main stack, the end of the RAM */
+extern const uint16_t _sisr_vector[];      /* Start of the code in the FLASH, from the linker script */
+extern const uint16_t _etext[];            /* End of the code */
+
+static BSP_FAULT_RecordTypeDef FAULT_Record __NOINIT;
+static uint32_t FAULT_Stack[BSP_FAULT_STACK_SIZE / 4U] __ALIGNED(8);
+
+/* Read by the handlers, the stack of the fault may be the cause; not static for the assembly with LTO */
+__USED uint32_t * const FAULT_StackTop = &FAULT_Stack[BSP_FAULT_STACK_SIZE / 4U];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_FAULT_Private_Functions
+  * @{
+  */
+static uint32_t FAULT_Checksum(const BSP_FAULT_RecordTypeDef *pRecord);
+static uint32_t FAULT_IsValid(const BSP_FAULT_RecordTypeDef *pRecord);
+static uint32_t FAULT_IsReturn(uint32_t Address);
+static void     FAULT_Save(uint32_t Type, uint32_t Info, const uint32_t *pFrame, uint32_t Sp, uint32_t ExcReturn);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FAULT_Exported_Functions BSP FAULT Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Give the MemManage, BusFault and UsageFault their own handler.
+  * @retval None
+  */
+void BSP_FAULT_Init(void)
+{
+  SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_MEMFAULTENA_Msk;
+}
+
+/**
+  * @brief  Return the record of the fault before the last reset, once.
+  * @param  pRecord Pointer to the copy of the record.
+  * @retval HAL_OK if a fault was recorded since the last call, HAL_ERROR otherwise
+  */
+HAL_StatusTypeDef BSP_FAULT_GetRecord(BSP_FAULT_RecordTypeDef *pRecord)
+{
+  if ((pRecord == NULL) || (FAULT_IsValid(&FAULT_Record) == 0U) || (FAULT_Record.Magic != FAULT_MAGIC))
+  {
+    return HAL_ERROR;
+  }
+
+  *pRecord = FAULT_Record;
+
+  /* Kept for the count of the next one */
+  FAULT_Record.Magic = FAULT_MAGIC_REPORTED;
+  FAULT_Record.Check = FAULT_Checksum(&FAULT_Record);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Print a fault record.
+  * @param  pRecord Pointer to the record.
+  * @retval None
+  */
+void BSP_FAULT_Print(const BSP_FAULT_RecordTypeDef *pRecord)
+{
+  static const char * const names[] =
+  {
+    "IACCVIOL", "DACCVIOL", NULL, "MUNSTKERR", "MSTKERR", "MLSPERR", NULL, "MMARVALID",
+    "IBUSERR", "PRECISERR", "IMPRECISERR", "UNSTKERR", "STKERR", "LSPERR", NULL, "BFARVALID",
+    "UNDEFINSTR", "INVSTATE", "INVPC", "NOCP", NULL, NULL, NULL, NULL,
+    "UNALIGNED", "DIVBYZERO"
+  };
+  static const char * const types[] = { "NMI", "HardFault", "MemManage", "BusFault", "UsageFault" };
+  uint32_t i;
+
+  if (pRecord->Type >= BSP_FAULT_TYPE_SOFTWARE)
+  {
+    printf("Fault: %s reset, info 0x%08lx",
+           (pRecord->Type == BSP_FAULT_TYPE_STACK) ? "stack overflow" :
+           (pRecord->Type == BSP_FAULT_TYPE_WATCHDOG) ? "watchdog" :
+           (pRecord->Type == BSP_FAULT_TYPE_GUARD) ? "memory guard" : "software", pRecord->Info);
+  }
+  else if ((pRecord->Type >= BSP_FAULT_TYPE_NMI) && (pRecord->Type <= BSP_FAULT_TYPE_USAGEFAULT))
+  {
+    printf("Fault: %s", types[pRecord->Type - BSP_FAULT_TYPE_NMI]);
+  }
+  else
+  {
+    printf("Fault: exception %lu", pRecord->Type);
+  }
+  printf(", %lu since power on, at %lu ms\r\n", pRecord->Count, pRecord->Tick);
+
+  printf("  pc   0x%08lx  lr   0x%08lx  sp   0x%08lx  xpsr 0x%08lx\r\n",
+         pRecord->PC, pRecord->LR, pRecord->SP, pRecord->xPSR);
+  printf("  r0   0x%08lx  r1   0x%08lx  r2   0x%08lx  r3   0x%08lx  r12  0x%08lx\r\n",
+         pRecord->R0, pRecord->R1, pRecord->R2, pRecord->R3, pRecord->R12);
+
+  printf("  cfsr 0x%08lx", pRecord->CFSR);
+  for (i = 0U; i < (sizeof(names) / sizeof(names[0])); i++)
+  {
+    if (((pRecord->CFSR & (1UL << i)) != 0U) && (names[i] != NULL))
+    {
+      printf(" %s", names[i]);
+    }
+  }
+  printf("\r\n  hfsr 0x%08lx%s%s%s\r\n", pRecord->HFSR,
+         ((pRecord->HFSR & SCB_HFSR_FORCED_Msk) != 0U) ? " FORCED" : "",
+         ((pRecord->HFSR & SCB_HFSR_VECTTBL_Msk) != 0U) ? " VECTTBL" : "",
+         ((pRecord->HFSR & SCB_HFSR_DEBUGEVT_Msk) != 0U) ? " DEBUGEVT" : "");
+  if ((pRecord->CFSR & SCB_CFSR_MMARVALID_Msk) != 0U)
+  {
+    printf("  mmfar 0x%08lx\r\n", pRecord->MMFAR);
+  }
+  if ((pRecord->CFSR & SCB_CFSR_BFARVALID_Msk) != 0U)
+  {
+    printf("  bfar 0x%08lx\r\n", pRecord->BFAR);
+  }
+
+  printf("  arm-none-eabi-addr2line -f -e <elf> 0x%08lx 0x%08lx", pRecord->PC, pRecord->LR & ~1UL);
+  for (i = 0U; (i < BSP_FAULT_BACKTRACE) && (pRecord->Backtrace[i] != 0U); i++)
+  {
+    printf(" 0x%08lx", pRecord->Backtrace[i]);
+  }
+  printf("\r\n");
+}
+
+/**
+  * @brief  Record a software reason of reset, the caller as PC, and reset.
+  * @param  Type Reason, a value of @ref BSP_FAULT_Type from BSP_FAULT_TYPE_SOFTWARE.
+  * @param  Info Value kept with the record, the stalled task of a watchdog for instance.
+  * @retval None
+  */
+void BSP_FAULT_Reset(uint32_t Type, uint32_t Info)
+{
+  uint32_t frame[FAULT_FRAME_WORDS] = {0};
+
+  __disable_irq();
+
+  frame[5] = (uint32_t)__builtin_return_address(0);
+  frame[6] = frame[5] & ~1UL;
+  frame[7] = __get_xPSR();
+  FAULT_Save(Type, Info, frame, __get_MSP(), 0U);
+
+  __DSB();
+  HAL_NVIC_SystemReset();
+  while (1)
+  {
+  }
+}
+
+/**
+  * @brief  Record a fault and reset, called by the fault handlers on their own stack.
+  * @param  pFrame Stack pointer of the fault, on the stacked frame.
+  * @param  ExcReturn EXC_RETURN of the handler.
+  * @retval None
+  */
+void BSP_FAULT_Capture(const uint32_t *pFrame, uint32_t ExcReturn)
+{
+  uint32_t address = (uint32_t)pFrame;
+  uint32_t sp = 0U;
+
+  /* The frame is only read when it lies in the RAM, a bad one would lock up the core */
+  if (((address & 3U) == 0U) && (address >= SRAM_BASE) &&
+      ((address + (FAULT_FRAME_WORDS * 4U)) <= (uint32_t)_estack))
+  {
+    sp = address + (4U * (((ExcReturn & FAULT_EXC_NO_FP) != 0U) ? FAULT_FRAME_WORDS : FAULT_FRAME_FP_WORDS));
+    if ((pFrame[7] & FAULT_XPSR_ALIGN) != 0U)
+    {
+      sp += 4U;
+    }
+  }
+  else
+  {
+    pFrame = NULL;
+  }
+
+  FAULT_Save(__get_IPSR() & 0x1FFU, 0U, pFrame, sp, ExcReturn);
+
+  __DSB();
+  HAL_NVIC_SystemReset();
+  while (1)
+  {
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FAULT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Checksum of a record, the words before Check.
+  * @param  pRecord Pointer to the record.
+  * @retval Checksum
+  */
+static uint32_t FAULT_Checksum(const BSP_FAULT_RecordTypeDef *pRecord)
+{
+  const uint32_t *word = (const uint32_t *)pRecord;
+  uint32_t sum = 0x5EED0000U;
+  uint32_t i;
+
+  for (i = 0U; i < (offsetof(BSP_FAULT_RecordTypeDef, Check) / 4U); i++)
+  {
+    sum = ((sum << 5U) | (sum >> 27U)) ^ word[i];
+  }
+
+  return sum;
+}
+
+/**
+  * @brief  Tell if a record was written by the handlers, reported or not.
+  * @param  pRecord Pointer to the record.
+  * @retval 1 if valid, 0 after a power on
+  */
+static uint32_t FAULT_IsValid(const BSP_FAULT_RecordTypeDef *pRecord)
+{
+  return (((pRecord->Magic == FAULT_MAGIC) || (pRecord->Magic == FAULT_MAGIC_REPORTED)) &&
+          (pRecord->Check == FAULT_Checksum(pRecord))) ? 1U : 0U;
+}
+
+/**
+  * @brief  Tell if a stack word is a return address, right after a BL or a BLX of the code.
+  * @param  Address Stack word.
+  * @retval 1 if a return address, 0 otherwise
+  */
+static uint32_t FAULT_IsReturn(uint32_t Address)
+{
+  const uint16_t *code = (const uint16_t *)(Address & ~1UL);
+
+  if (((Address & 1U) == 0U) || (code < &_sisr_vector[2]) || (code > _etext))
+  {
+    return 0U;
+  }
+
+  /* BLX Rm, 16-bit */
+  if ((code[-1] & 0xFF87U) == 0x4780U)
+  {
+    return 1U;
+  }
+
+  /* BL label, 32-bit */
+  return (((code[-2] & 0xF800U) == 0xF000U) && ((code[-1] & 0xD000U) == 0xD000U)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Fill the record.
+  * @param  Type Fault, a value of @ref BSP_FAULT_Type.
+  * @param  Info Value kept with the record.
+  * @param  pFrame Pointer to the stacked frame, NULL if unreadable.
+  * @param  Sp Stack pointer before the fault, 0 if unreadable.
+  * @param  ExcReturn EXC_RETURN of the handler, 0 for BSP_FAULT_Reset().
+  * @retval None
+  */
+static void FAULT_Save(uint32_t Type, uint32_t Info, const uint32_t *pFrame, uint32_t Sp, uint32_t ExcReturn)
+{
+  BSP_FAULT_RecordTypeDef *record = &FAULT_Record;
+  uint32_t count = (FAULT_IsValid(record) != 0U) ? record->Count : 0U;
+  const uint32_t *word;
+  const uint32_t *end;
+  uint32_t found = 0U;
+
+  memset(record, 0, sizeof(*record));
+  record->Count     = count + 1U;
+  record->Type      = Type;
+  record->Info      = Info;
+  record->Tick      = HAL_GetTick();
+  record->SP        = Sp;
+  record->ExcReturn = ExcReturn;
+  record->CFSR      = SCB->CFSR;
+  record->HFSR      = SCB->HFSR;
+  record->MMFAR     = SCB->MMFAR;
+  record->BFAR      = SCB->BFAR;
+
+  if (pFrame != NULL)
+  {
+    record->R0   = pFrame[0];
+    record->R1   = pFrame[1];
+    record->R2   = pFrame[2];
+    record->R3   = pFrame[3];
+    record->R12  = pFrame[4];
+    record->LR   = pFrame[5];
+    record->PC   = pFrame[6];
+    record->xPSR = pFrame[7];
+  }
+
+  if ((Sp >= SRAM_BASE) && (Sp < (uint32_t)_estack) && ((Sp & 3U) == 0U))
+  {
+    /* The PSP of a thread has no known top, the scan stops at the end of the RAM */
+    word = (const uint32_t *)Sp;
+    end  = ((uint32_t)(_estack - word) > BSP_FAULT_SCAN_WORDS) ? &word[BSP_FAULT_SCAN_WORDS] : _estack;
+    for (; (word < end) && (found < BSP_FAULT_BACKTRACE); word++)
+    {
+      if ((FAULT_IsReturn(*word) != 0U) && (*word != record->LR))
+      {
+        record->Backtrace[found] = *word & ~1UL;
+        found++;
+      }
+    }
+  }
+
+  record->Magic = FAULT_MAGIC;
+  record->Check = FAULT_Checksum(record);
+}
+
+/**
+  * @}
+  */
+
+#if defined (USE_BSP_FAULT)
+
+/**
+  * @brief  Fault handlers: the frame and EXC_RETURN passed to BSP_FAULT_Capture() on the fault stack.
+  * @retval None
+  */
+#define FAULT_HANDLER(__NAME__)                                      \
+__attribute__((naked)) void __NAME__(void)                           \
+{                                                                    \
+  __ASM volatile                                                     \
+  (                                                                  \
+    "tst      lr, #4                 \n"                             \
+    "ite      eq                     \n"                             \
+    "mrseq    r0, msp                \n"                             \
+    "mrsne    r0, psp                \n"                             \
+    "mov      r1, lr                 \n"                             \
+    "ldr      r2, =FAULT_StackTop    \n"                             \
+    "ldr      r2, [r2]               \n"                             \
+    "mov      sp, r2                 \n"                             \
+    "b        BSP_FAULT_Capture      \n"                             \
+    ".ltorg                          \n"                             \
+  );                                                                 \
+}
+
+FAULT_HANDLER(HardFault_Handler)
+FAULT_HANDLER(MemManage_Handler)
+FAULT_HANDLER(BusFault_Handler)
+FAULT_HANDLER(UsageFault_Handler)
+
+#endif /* USE_BSP_FAULT */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
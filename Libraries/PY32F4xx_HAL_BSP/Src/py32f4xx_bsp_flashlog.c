@@ -0,0 +1,450 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_flashlog.c
+  * @author  MCU Application Team
+  * @brief   Internal flash log writer BSP service.
+  *          This file provides functions to append records to an erased area
+  *          of the internal flash without waiting for the flash:
+  *           + Records packed into page images in RAM
+  *           + Full pages programmed back to back from the flash interrupt
+  *           + Append point found again after a reset
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Reserve an area of the internal flash out of the code, aligned on and
+       a multiple of FLASH_PAGE_SIZE. Enable FLASH_IRQn in the NVIC, call
+       HAL_FLASH_IRQHandler() from FLASH_IRQHandler(),
+       BSP_FLASHLOG_EndOfOperationHandler() from
+       HAL_FLASH_EndOfOperationCallback() and BSP_FLASHLOG_ErrorHandler() from
+       HAL_FLASH_OperationErrorCallback().
+
+   (#) Call BSP_FLASHLOG_Init(): the flash is unlocked and the log resumes on
+       the first erased page of the area. BSP_FLASHLOG_Erase() empties the
+       area, blocking.
+
+   (#) BSP_FLASHLOG_Write() copies the record into the page image being
+       filled, records are packed across pages. A full page is queued and
+       programmed with HAL_FLASH_PageProgram_IT():
+       (+) The page is latched into the flash by the call, its buffer is free
+           again on return.
+       (+) The next queued page is started from the end of operation
+           interrupt of the previous one, the main loop is not involved.
+       (+) HAL_BUSY is returned when the buffers cannot take the whole record,
+           nothing is copied then; HAL_ERROR when the area is full.
+
+   (#) BSP_FLASHLOG_Flush() queues the page being filled, padded with 0xFF.
+       The pad is part of the log: flush on events, not after each record.
+       BSP_FLASHLOG_IsIdle() returns 1 once everything is programmed.
+
+   (#) A failed program leaves its page and the queue waits:
+       BSP_FLASHLOG_Process(), BSP_FLASHLOG_Write() or BSP_FLASHLOG_Flush()
+       start it again. The same happens when another user holds the flash.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_flashlog.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FLASHLOG BSP FLASHLOG
+  * @brief Internal flash log writer BSP service
+  * @{
+  */
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_FLASHLOG_Private_Functions
+  * @{
+  */
+static void FLASHLOG_Queue(BSP_FLASHLOG_TypeDef *hlog);
+static void FLASHLOG_Start(BSP_FLASHLOG_TypeDef *hlog);
+static void FLASHLOG_Kick(BSP_FLASHLOG_TypeDef *hlog);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FLASHLOG_Exported_Functions BSP FLASHLOG Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_FLASHLOG_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Find the end of the log
+      (+) Erase the log area
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the log writer on its flash area.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @param  Address First page of the area, aligned on FLASH_PAGE_SIZE.
+  * @param  Size Size of the area, a multiple of FLASH_PAGE_SIZE.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FLASHLOG_Init(BSP_FLASHLOG_TypeDef *hlog, uint32_t Address, uint32_t Size)
+{
+  const uint32_t *pword;
+  uint32_t offset;
+  uint32_t i;
+  HAL_StatusTypeDef status;
+
+  if ((hlog == NULL) || ((Address % FLASH_PAGE_SIZE) != 0U) || (Address < FLASH_BASE) ||
+      (Size == 0U) || ((Size % FLASH_PAGE_SIZE) != 0U) || ((Address + Size - 1U) > FLASH_END))
+  {
+    return HAL_ERROR;
+  }
+
+  status = HAL_FLASH_Unlock();
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  /* The log goes on after its last programmed page */
+  for (offset = Size; offset != 0U; offset -= FLASH_PAGE_SIZE)
+  {
+    pword = (const uint32_t *)(Address + offset - FLASH_PAGE_SIZE);
+    for (i = 0U; i < (FLASH_PAGE_SIZE / 4U); i++)
+    {
+      if (pword[i] != 0xFFFFFFFFU)
+      {
+        break;
+      }
+    }
+    if (i != (FLASH_PAGE_SIZE / 4U))
+    {
+      break;
+    }
+  }
+
+  hlog->Address      = Address;
+  hlog->Size         = Size;
+  hlog->Length       = offset;
+  hlog->WriteAddress = Address + offset;
+  hlog->Head         = 0U;
+  hlog->Fill         = 0U;
+  hlog->Tail         = 0U;
+  hlog->Count        = 0U;
+  hlog->Busy         = 0U;
+  hlog->PageCount    = 0U;
+  hlog->ErrorCount   = 0U;
+  memset(hlog->Buffer, 0xFF, sizeof(hlog->Buffer));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Erase the log area, blocking.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval HAL status, HAL_BUSY when pages are still waiting to be programmed
+  */
+HAL_StatusTypeDef BSP_FLASHLOG_Erase(BSP_FLASHLOG_TypeDef *hlog)
+{
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t error;
+  HAL_StatusTypeDef status;
+
+  if (hlog->Address == 0U)
+  {
+    return HAL_ERROR;
+  }
+  if ((hlog->Busy != 0U) || (hlog->Count != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  erase.TypeErase   = FLASH_TYPEERASE_PAGEERASE;
+  erase.PageAddress = hlog->Address;
+  erase.NbPages     = hlog->Size / FLASH_PAGE_SIZE;
+  status = HAL_FLASH_Erase(&erase, &error);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hlog->Length       = 0U;
+  hlog->WriteAddress = hlog->Address;
+  hlog->Fill         = 0U;
+  memset(hlog->Buffer[hlog->Head], 0xFF, FLASH_PAGE_SIZE);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_FLASHLOG_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Append records
+      (+) Queue the page being filled
+      (+) Program the queued pages from the flash interrupt
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Append a record to the log.
+  * @note   Returns once the record is copied, the pages are programmed in the
+  *         background.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @param  pData Record.
+  * @param  Size Record size in bytes.
+  * @retval HAL status, HAL_BUSY when the buffers are full and HAL_ERROR when the
+  *         log area is full
+  */
+HAL_StatusTypeDef BSP_FLASHLOG_Write(BSP_FLASHLOG_TypeDef *hlog, const uint8_t *pData, uint32_t Size)
+{
+  uint32_t chunk;
+
+  if ((hlog->Address == 0U) || ((pData == NULL) && (Size != 0U)) || (Size > (hlog->Size - hlog->Length)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Count only goes down in the interrupt */
+  if (Size > (((BSP_FLASHLOG_BUFFERS - hlog->Count) * FLASH_PAGE_SIZE) - hlog->Fill))
+  {
+    FLASHLOG_Kick(hlog);
+    return HAL_BUSY;
+  }
+
+  hlog->Length += Size;
+  while (Size != 0U)
+  {
+    chunk = FLASH_PAGE_SIZE - hlog->Fill;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    memcpy((uint8_t *)hlog->Buffer[hlog->Head] + hlog->Fill, pData, chunk);
+    hlog->Fill += chunk;
+    pData      += chunk;
+    Size       -= chunk;
+    if (hlog->Fill == FLASH_PAGE_SIZE)
+    {
+      FLASHLOG_Queue(hlog);
+    }
+  }
+
+  FLASHLOG_Kick(hlog);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue the page being filled, padded with 0xFF.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FLASHLOG_Flush(BSP_FLASHLOG_TypeDef *hlog)
+{
+  if (hlog->Address == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  if (hlog->Fill != 0U)
+  {
+    /* The area is a multiple of the page, the pad fits */
+    hlog->Length += FLASH_PAGE_SIZE - hlog->Fill;
+    FLASHLOG_Queue(hlog);
+  }
+  FLASHLOG_Kick(hlog);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the queued pages again after an error or a busy flash.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+void BSP_FLASHLOG_Process(BSP_FLASHLOG_TypeDef *hlog)
+{
+  if (hlog->Address != 0U)
+  {
+    FLASHLOG_Kick(hlog);
+  }
+}
+
+/**
+  * @brief  Check whether every queued page is programmed.
+  * @note   The page being filled is not counted, see BSP_FLASHLOG_Flush().
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval 1 when the log writer is idle, 0 otherwise
+  */
+uint32_t BSP_FLASHLOG_IsIdle(const BSP_FLASHLOG_TypeDef *hlog)
+{
+  return ((hlog->Busy == 0U) && (hlog->Count == 0U)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Flash end of operation handler, starts the next queued page.
+  * @note   To be called from HAL_FLASH_EndOfOperationCallback().
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+void BSP_FLASHLOG_EndOfOperationHandler(BSP_FLASHLOG_TypeDef *hlog)
+{
+  if ((hlog->Address != 0U) && (hlog->Busy != 0U))
+  {
+    hlog->Busy = 0U;
+    FLASHLOG_Start(hlog);
+  }
+}
+
+/**
+  * @brief  Flash operation error handler.
+  * @note   To be called from HAL_FLASH_OperationErrorCallback().
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+void BSP_FLASHLOG_ErrorHandler(BSP_FLASHLOG_TypeDef *hlog)
+{
+  if ((hlog->Address != 0U) && (hlog->Busy != 0U))
+  {
+    hlog->ErrorCount++;
+    hlog->Busy = 0U;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FLASHLOG_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Queue the page being filled and open the next buffer.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+static void FLASHLOG_Queue(BSP_FLASHLOG_TypeDef *hlog)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hlog->Count++;
+
+  __set_PRIMASK(primask_bit);
+
+  hlog->Head = (hlog->Head + 1U) % BSP_FLASHLOG_BUFFERS;
+  hlog->Fill = 0U;
+}
+
+/**
+  * @brief  Program the next queued page when the flash is idle.
+  * @note   Called with the interrupts disabled or from the flash interrupt.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+static void FLASHLOG_Start(BSP_FLASHLOG_TypeDef *hlog)
+{
+  uint32_t *pbuffer;
+
+  if ((hlog->Busy != 0U) || (hlog->Count == 0U))
+  {
+    return;
+  }
+
+  pbuffer = hlog->Buffer[hlog->Tail];
+  hlog->Busy = 1U;
+  if (HAL_FLASH_PageProgram_IT(hlog->WriteAddress, pbuffer) != HAL_OK)
+  {
+    /* Flash held by another user, started again on the next call */
+    hlog->Busy = 0U;
+    return;
+  }
+
+  /* The page is latched, its buffer is free for the writer */
+  memset(pbuffer, 0xFF, FLASH_PAGE_SIZE);
+  hlog->WriteAddress += FLASH_PAGE_SIZE;
+  hlog->Tail = (hlog->Tail + 1U) % BSP_FLASHLOG_BUFFERS;
+  hlog->Count--;
+  hlog->PageCount++;
+}
+
+/**
+  * @brief  Start the queue from the thread context.
+  * @param  hlog Pointer to a BSP_FLASHLOG_TypeDef structure.
+  * @retval None
+  */
+static void FLASHLOG_Kick(BSP_FLASHLOG_TypeDef *hlog)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  FLASHLOG_Start(hlog);
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
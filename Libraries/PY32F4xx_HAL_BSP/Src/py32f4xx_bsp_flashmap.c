@@ -0,0 +1,242 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_flashmap.c
+  * @author  MCU Application Team
+  * @brief   Internal flash layout BSP service.
+  *          This file provides functions to place the flash storage from the
+  *          build and the option bytes instead of fixed addresses:
+  *           + Geometry of the device and FLASH area of the linker script
+  *           + End of the image and free sectors after it
+  *           + Write protected blocks skipped
+  *           + Regions taken from the free space for the storage services
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Select the device with MCU_TYPE, PY32F403xB, PY32F403xC or PY32F403xD:
+       the device header gives the compile time geometry, FLASH_SIZE and
+       FLASH_PAGE_NB / FLASH_SECTOR_NB / FLASH_BLOCK_NB, and the linker script
+       of the device its FLASH area.
+
+   (#) py32f403xx_sections.ld exports the layout of the link: _sflash and
+       _eflash bound the FLASH area, _eimage ends the code and the .data
+       initializers. BSP_FLASHMAP_GetInfo() returns them with the geometry and
+       the protections read from the option bytes.
+
+   (#) BSP_FLASHMAP_GetFreeRegion() returns the sectors after the image up to
+       the end of the FLASH area, stopped at the write protected blocks. Take
+       the storage areas from it with BSP_FLASHMAP_Take(), from its end so that
+       the image can grow, and give them to the services, for instance:
+         BSP_FLASHMAP_GetFreeRegion(&free);
+         BSP_FLASHMAP_Take(&free, 4U * FLASH_SECTOR_SIZE, &eeprom);
+         BSP_FLASHMAP_Take(&free, 0U, &log);
+         BSP_EEPROM_Init(&hee, eeprom.Address, eeprom.Size / FLASH_SECTOR_SIZE);
+         BSP_FLASHLOG_Init(&hlog, log.Address, log.Size);
+       Take the regions in the same order with the same sizes after each
+       update: those of a fixed size stay in place while the image grows, the
+       one with the rest of the space (Size 0) starts after the image and
+       moves with it.
+
+   (#) Built for an A/B slot, the FLASH area is the slot: the free region is
+       inside it and erased by the next update of the slot.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_flashmap.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FLASHMAP BSP FLASHMAP
+  * @brief Internal flash layout BSP service
+  * @{
+  */
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_FLASHMAP_Private_Variables BSP FLASHMAP Private Variables
+  * @{
+  */
+extern const uint32_t _sflash[];  /* FLASH area of the link, from the linker script */
+extern const uint32_t _eflash[];
+extern const uint32_t _eimage[];  /* End of the image in the FLASH */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FLASHMAP_Exported_Functions BSP FLASHMAP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the flash geometry, the layout of the link and the protections.
+  * @param  pInfo Pointer to a BSP_FLASHMAP_InfoTypeDef structure.
+  * @retval None
+  */
+void BSP_FLASHMAP_GetInfo(BSP_FLASHMAP_InfoTypeDef *pInfo)
+{
+  FLASH_OBProgramInitTypeDef ob;
+
+  HAL_FLASH_OBGetConfig(&ob);
+
+  pInfo->Size        = FLASH_SIZE;
+  pInfo->PageCount   = FLASH_PAGE_NB;
+  pInfo->SectorCount = FLASH_SECTOR_NB;
+  pInfo->BlockCount  = FLASH_BLOCK_NB;
+  pInfo->LinkStart   = (uint32_t)_sflash;
+  pInfo->LinkEnd     = (uint32_t)_eflash;
+  pInfo->ImageEnd    = (uint32_t)_eimage;
+  pInfo->WRPBlocks   = ob.WRPBlock & ((1UL << FLASH_BLOCK_NB) - 1U);
+  pInfo->RDPLevel    = ob.RDPLevel;
+}
+
+/**
+  * @brief  Check the write protection of a flash range.
+  * @param  Address First byte.
+  * @param  Size Size in bytes.
+  * @retval 1 when a block of the range is write protected, 0 otherwise
+  */
+uint32_t BSP_FLASHMAP_IsWriteProtected(uint32_t Address, uint32_t Size)
+{
+  FLASH_OBProgramInitTypeDef ob;
+  uint32_t block;
+  uint32_t last;
+
+  if ((Size == 0U) || (Address < FLASH_BASE) || (Address >= (FLASH_BASE + FLASH_SIZE)))
+  {
+    return 0U;
+  }
+
+  HAL_FLASH_OBGetConfig(&ob);
+  last = BSP_FLASHMAP_BLOCK_OF(Address + Size - 1U);
+  if (last >= FLASH_BLOCK_NB)
+  {
+    last = FLASH_BLOCK_NB - 1U;
+  }
+  for (block = BSP_FLASHMAP_BLOCK_OF(Address); block <= last; block++)
+  {
+    if ((ob.WRPBlock & (1UL << block)) != 0U)
+    {
+      return 1U;
+    }
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Get the free sectors after the image.
+  * @note   The region starts at the first sector after the image and write
+  *         protected blocks, and ends at the end of the FLASH area or at the
+  *         next write protected block.
+  * @param  pRegion Pointer to a BSP_FLASHMAP_RegionTypeDef structure.
+  * @retval HAL status, HAL_ERROR when no sector is free
+  */
+HAL_StatusTypeDef BSP_FLASHMAP_GetFreeRegion(BSP_FLASHMAP_RegionTypeDef *pRegion)
+{
+  BSP_FLASHMAP_InfoTypeDef info;
+  uint32_t start;
+  uint32_t end;
+  uint32_t block;
+
+  BSP_FLASHMAP_GetInfo(&info);
+
+  start = BSP_FLASHMAP_ALIGN_UP(info.ImageEnd, FLASH_SECTOR_SIZE);
+  end   = BSP_FLASHMAP_ALIGN_DOWN(info.LinkEnd, FLASH_SECTOR_SIZE);
+  if (end > (FLASH_BASE + FLASH_SIZE))
+  {
+    end = FLASH_BASE + FLASH_SIZE;
+  }
+
+  /* Past the protected blocks at the start, up to the next protected one */
+  while ((start < end) && ((info.WRPBlocks & (1UL << BSP_FLASHMAP_BLOCK_OF(start))) != 0U))
+  {
+    start = BSP_FLASHMAP_ALIGN_DOWN(start, FLASH_BLOCK_SIZE) + FLASH_BLOCK_SIZE;
+  }
+  for (block = BSP_FLASHMAP_BLOCK_OF(start) + 1U; block < FLASH_BLOCK_NB; block++)
+  {
+    if ((info.WRPBlocks & (1UL << block)) != 0U)
+    {
+      if (end > (FLASH_BASE + (block * FLASH_BLOCK_SIZE)))
+      {
+        end = FLASH_BASE + (block * FLASH_BLOCK_SIZE);
+      }
+      break;
+    }
+  }
+
+  if (start >= end)
+  {
+    pRegion->Address = end;
+    pRegion->Size    = 0U;
+    return HAL_ERROR;
+  }
+
+  pRegion->Address = start;
+  pRegion->Size    = end - start;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take a region from the end of the free space.
+  * @param  pFree Free region, reduced by the region taken.
+  * @param  Size Size in bytes, rounded up to a sector, 0 for all the free space.
+  * @param  pRegion Pointer to a BSP_FLASHMAP_RegionTypeDef structure, the
+  *         region taken.
+  * @retval HAL status, HAL_ERROR when the free space is too small
+  */
+HAL_StatusTypeDef BSP_FLASHMAP_Take(BSP_FLASHMAP_RegionTypeDef *pFree, uint32_t Size,
+                                    BSP_FLASHMAP_RegionTypeDef *pRegion)
+{
+  Size = (Size == 0U) ? pFree->Size : BSP_FLASHMAP_ALIGN_UP(Size, FLASH_SECTOR_SIZE);
+  if ((Size == 0U) || (Size > pFree->Size))
+  {
+    return HAL_ERROR;
+  }
+
+  pFree->Size     -= Size;
+  pRegion->Address = pFree->Address + pFree->Size;
+  pRegion->Size    = Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
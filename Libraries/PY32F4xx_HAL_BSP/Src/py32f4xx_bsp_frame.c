@@ -0,0 +1,523 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_frame.c
+  * @author  MCU Application Team
+  * @brief   SLIP/COBS frame decoder BSP service.
+  *          This file provides functions to decode frames from a UART DMA
+  *          receive ring:
+  *           + Incremental decoding as data lands in the ring
+  *           + Word at a time delimiter and escape scan
+  *           + In place decoding and zero copy frame descriptors
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Start the reception with HAL_UART_ReceiveToRing_DMA() and call
+       BSP_FRAME_Init() with the ring and the framing protocol.
+
+   (#) Call BSP_FRAME_Get() whenever data may have landed, for instance from the
+       main loop or after an idle line. Only the bytes received since the
+       previous call are scanned. Runs of four bytes without delimiter nor
+       escape are checked with one word access.
+
+   (#) When a frame is complete BSP_FRAME_Get() returns HAL_OK and a descriptor
+       of the decoded frame. The frame is decoded in place in the ring: no copy
+       is made, and it is split in two parts when it wraps at the end of the ring.
+
+   (#) Call BSP_FRAME_Release() once the frame is processed, to give its bytes
+       back to the DMA and decode the next one. Until then BSP_FRAME_Get()
+       returns the same frame.
+
+   (#) Empty frames are skipped. Malformed frames and frames which do not fit
+       in the ring are dropped up to the next delimiter and counted in
+       ErrorCount. The ring must be drained faster than the DMA fills it.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_frame.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FRAME BSP FRAME
+  * @brief SLIP/COBS frame decoder BSP service
+  * @{
+  */
+
+#ifdef HAL_DMA_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_FRAME_Private_Constants BSP FRAME Private Constants
+  * @{
+  */
+#define FRAME_SLIP_END            0xC0U
+#define FRAME_SLIP_ESC            0xDBU
+#define FRAME_SLIP_ESC_END        0xDCU
+#define FRAME_SLIP_ESC_ESC        0xDDU
+
+#define FRAME_STATE_ESCAPE        0x00000001U    /*!< SLIP escape byte received                 */
+#define FRAME_STATE_ZERO          0x00000002U    /*!< COBS zero owed before the next block      */
+#define FRAME_STATE_DISCARD       0x00000004U    /*!< Dropping bytes up to the next delimiter   */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_FRAME_Private_Macros BSP FRAME Private Macros
+  * @{
+  */
+/* Non zero when one of the four bytes of __WORD__ equals __BYTE__ */
+#define FRAME_HAS_BYTE(__WORD__, __BYTE__)                                            \
+  ((((__WORD__) ^ ((__BYTE__) * 0x01010101U)) - 0x01010101U) &                       \
+   ~((__WORD__) ^ ((__BYTE__) * 0x01010101U)) & 0x80808080U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_FRAME_Private_Functions
+  * @{
+  */
+static uint32_t FRAME_Offset(const DMA_RingTypeDef *pRing, uint32_t Position);
+static void     FRAME_Store(DMA_RingTypeDef *pRing, uint32_t Position, const uint8_t *pData, uint32_t Length);
+static void     FRAME_Drop(BSP_FRAME_TypeDef *hframe, uint32_t Length);
+static void     FRAME_DecodeSlip(BSP_FRAME_TypeDef *hframe, uint32_t Count);
+static void     FRAME_DecodeCobs(BSP_FRAME_TypeDef *hframe, uint32_t Count);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FRAME_Exported_Functions BSP FRAME Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_FRAME_Exported_Functions_Group1 Frame decoding functions
+  * @brief    Frame decoding functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Frame decoding functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Initialize a frame decoder on a receive ring
+      (+) Get the next decoded frame
+      (+) Release a decoded frame
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a frame decoder.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @param  pRing Receive ring, attached with HAL_UART_ReceiveToRing_DMA().
+  * @param  Protocol Framing, a value of @ref BSP_FRAME_Protocol.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FRAME_Init(BSP_FRAME_TypeDef *hframe, DMA_RingTypeDef *pRing, uint32_t Protocol)
+{
+  if ((hframe == NULL) || (pRing == NULL) || (pRing->hdma == NULL) ||
+      (Protocol > BSP_FRAME_PROTOCOL_COBS))
+  {
+    return HAL_ERROR;
+  }
+
+  hframe->pRing      = pRing;
+  hframe->Protocol   = Protocol;
+  hframe->Read       = 0U;
+  hframe->Write      = 0U;
+  hframe->State      = 0U;
+  hframe->Remaining  = 0U;
+  hframe->Consumed   = 0U;
+  hframe->ErrorCount = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Decode the data received since the previous call and return the next frame.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @param  pDesc Returns the decoded frame.
+  * @retval HAL_OK when a frame is returned, HAL_BUSY when no frame is complete yet
+  */
+HAL_StatusTypeDef BSP_FRAME_Get(BSP_FRAME_TypeDef *hframe, BSP_FRAME_DescTypeDef *pDesc)
+{
+  DMA_RingTypeDef *pRing = hframe->pRing;
+
+  if (hframe->Consumed == 0U)
+  {
+    if (hframe->Protocol == BSP_FRAME_PROTOCOL_SLIP)
+    {
+      FRAME_DecodeSlip(hframe, HAL_DMAEx_RingGetCount(pRing));
+    }
+    else
+    {
+      FRAME_DecodeCobs(hframe, HAL_DMAEx_RingGetCount(pRing));
+    }
+
+    if (hframe->Consumed == 0U)
+    {
+      return HAL_BUSY;
+    }
+  }
+
+  /* The decoded frame starts at the ring Tail */
+  pDesc->pData = &pRing->pBuffer[pRing->Tail];
+  pDesc->pWrap = pRing->pBuffer;
+  if (hframe->Write > (pRing->Size - pRing->Tail))
+  {
+    pDesc->Length = pRing->Size - pRing->Tail;
+    pDesc->WrapLength = hframe->Write - pDesc->Length;
+  }
+  else
+  {
+    pDesc->Length = hframe->Write;
+    pDesc->WrapLength = 0U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give the bytes of the frame returned by BSP_FRAME_Get() back to the ring.
+  * @note   The frame descriptor is no longer valid after this call.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @retval None
+  */
+void BSP_FRAME_Release(BSP_FRAME_TypeDef *hframe)
+{
+  if (hframe->Consumed != 0U)
+  {
+    FRAME_Drop(hframe, hframe->Consumed);
+    hframe->Consumed = 0U;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FRAME_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the ring offset of a position counted from the ring Tail.
+  * @param  pRing Receive ring.
+  * @param  Position Position from the Tail, lower than the ring size.
+  * @retval Offset in the ring storage
+  */
+static uint32_t FRAME_Offset(const DMA_RingTypeDef *pRing, uint32_t Position)
+{
+  uint32_t offset = pRing->Tail + Position;
+
+  if (offset >= pRing->Size)
+  {
+    offset -= pRing->Size;
+  }
+  return offset;
+}
+
+/**
+  * @brief  Store decoded bytes in the ring.
+  * @param  pRing Receive ring.
+  * @param  Position Position from the Tail.
+  * @param  pData Decoded bytes.
+  * @param  Length Number of bytes, 1 to 4.
+  * @retval None
+  */
+static void FRAME_Store(DMA_RingTypeDef *pRing, uint32_t Position, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t offset = FRAME_Offset(pRing, Position);
+  uint32_t i;
+
+  if ((Length == 4U) && ((pRing->Size - offset) >= 4U))
+  {
+    __UNALIGNED_UINT32_WRITE(&pRing->pBuffer[offset], __UNALIGNED_UINT32_READ(pData));
+    return;
+  }
+
+  for (i = 0U; i < Length; i++)
+  {
+    pRing->pBuffer[offset] = pData[i];
+    offset++;
+    if (offset == pRing->Size)
+    {
+      offset = 0U;
+    }
+  }
+}
+
+/**
+  * @brief  Give bytes back to the ring and restart decoding at the new Tail.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @param  Length Number of bytes from the Tail.
+  * @retval None
+  */
+static void FRAME_Drop(BSP_FRAME_TypeDef *hframe, uint32_t Length)
+{
+  uint32_t length;
+  uint8_t *pBlock;
+
+  /* At most two blocks when the bytes wrap at the end of the ring */
+  while (Length != 0U)
+  {
+    length = HAL_DMAEx_RingAcquire(hframe->pRing, &pBlock);
+    if (length == 0U)
+    {
+      break;
+    }
+    if (length > Length)
+    {
+      length = Length;
+    }
+    HAL_DMAEx_RingCommit(hframe->pRing, length);
+    Length -= length;
+  }
+
+  hframe->Read = 0U;
+  hframe->Write = 0U;
+  hframe->Remaining = 0U;
+  hframe->State &= FRAME_STATE_DISCARD;
+}
+
+/**
+  * @brief  Decode SLIP encoded bytes.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @param  Count Number of bytes available from the ring Tail.
+  * @retval None
+  */
+static void FRAME_DecodeSlip(BSP_FRAME_TypeDef *hframe, uint32_t Count)
+{
+  DMA_RingTypeDef *pRing = hframe->pRing;
+  uint32_t in = hframe->Read;
+  uint32_t out = hframe->Write;
+  uint32_t offset;
+  uint32_t word;
+  uint8_t byte;
+
+  while (in < Count)
+  {
+    offset = FRAME_Offset(pRing, in);
+
+    /* Plain bytes only: move four at a time, nothing to store while no escape was met */
+    if (((hframe->State & FRAME_STATE_ESCAPE) == 0U) && ((Count - in) >= 4U) && ((pRing->Size - offset) >= 4U))
+    {
+      word = __UNALIGNED_UINT32_READ(&pRing->pBuffer[offset]);
+      if ((FRAME_HAS_BYTE(word, FRAME_SLIP_END) | FRAME_HAS_BYTE(word, FRAME_SLIP_ESC)) == 0U)
+      {
+        if ((hframe->State & FRAME_STATE_DISCARD) == 0U)
+        {
+          if (out != in)
+          {
+            FRAME_Store(pRing, out, (const uint8_t *)&word, 4U);
+          }
+          out += 4U;
+        }
+        in += 4U;
+        continue;
+      }
+    }
+
+    byte = pRing->pBuffer[offset];
+    in++;
+
+    if (byte == FRAME_SLIP_END)
+    {
+      if (((hframe->State & FRAME_STATE_DISCARD) == 0U) && (out != 0U))
+      {
+        hframe->Consumed = in;
+        break;
+      }
+      /* Empty or dropped frame */
+      hframe->State = 0U;
+      FRAME_Drop(hframe, in);
+      Count -= in;
+      in = 0U;
+      out = 0U;
+      continue;
+    }
+
+    if ((hframe->State & FRAME_STATE_DISCARD) != 0U)
+    {
+      continue;
+    }
+
+    if ((hframe->State & FRAME_STATE_ESCAPE) != 0U)
+    {
+      hframe->State &= ~FRAME_STATE_ESCAPE;
+      if (byte == FRAME_SLIP_ESC_END)
+      {
+        byte = FRAME_SLIP_END;
+      }
+      else if (byte == FRAME_SLIP_ESC_ESC)
+      {
+        byte = FRAME_SLIP_ESC;
+      }
+      else
+      {
+        hframe->State |= FRAME_STATE_DISCARD;
+        hframe->ErrorCount++;
+        continue;
+      }
+    }
+    else if (byte == FRAME_SLIP_ESC)
+    {
+      hframe->State |= FRAME_STATE_ESCAPE;
+      continue;
+    }
+
+    FRAME_Store(pRing, out, &byte, 1U);
+    out++;
+  }
+
+  hframe->Read = in;
+  hframe->Write = out;
+
+  /* A frame filling the whole ring can not complete */
+  if ((hframe->Consumed == 0U) && (in >= (pRing->Size - 1U)))
+  {
+    hframe->State |= FRAME_STATE_DISCARD;
+    hframe->ErrorCount++;
+  }
+  if ((hframe->Consumed == 0U) && ((hframe->State & FRAME_STATE_DISCARD) != 0U))
+  {
+    FRAME_Drop(hframe, in);
+  }
+}
+
+/**
+  * @brief  Decode COBS encoded bytes.
+  * @param  hframe Pointer to a BSP_FRAME_TypeDef structure.
+  * @param  Count Number of bytes available from the ring Tail.
+  * @retval None
+  */
+static void FRAME_DecodeCobs(BSP_FRAME_TypeDef *hframe, uint32_t Count)
+{
+  DMA_RingTypeDef *pRing = hframe->pRing;
+  uint32_t in = hframe->Read;
+  uint32_t out = hframe->Write;
+  uint32_t offset;
+  uint32_t word;
+  uint8_t byte;
+
+  while (in < Count)
+  {
+    offset = FRAME_Offset(pRing, in);
+
+    /* Inside a block: move four data bytes at a time while no delimiter is met */
+    if ((hframe->Remaining >= 4U) && ((Count - in) >= 4U) && ((pRing->Size - offset) >= 4U))
+    {
+      word = __UNALIGNED_UINT32_READ(&pRing->pBuffer[offset]);
+      if (FRAME_HAS_BYTE(word, 0U) == 0U)
+      {
+        FRAME_Store(pRing, out, (const uint8_t *)&word, 4U);
+        hframe->Remaining -= 4U;
+        in += 4U;
+        out += 4U;
+        continue;
+      }
+    }
+
+    byte = pRing->pBuffer[offset];
+    in++;
+
+    if (byte == 0U)
+    {
+      if (((hframe->State & FRAME_STATE_DISCARD) == 0U) && (hframe->Remaining == 0U) && (out != 0U))
+      {
+        hframe->Consumed = in;
+        break;
+      }
+      /* Empty, truncated or dropped frame */
+      if (((hframe->State & FRAME_STATE_DISCARD) == 0U) && (hframe->Remaining != 0U))
+      {
+        hframe->ErrorCount++;
+      }
+      hframe->State = 0U;
+      FRAME_Drop(hframe, in);
+      Count -= in;
+      in = 0U;
+      out = 0U;
+      continue;
+    }
+
+    if ((hframe->State & FRAME_STATE_DISCARD) != 0U)
+    {
+      continue;
+    }
+
+    if (hframe->Remaining == 0U)
+    {
+      /* Code byte: the zero ending the previous block comes first */
+      if ((hframe->State & FRAME_STATE_ZERO) != 0U)
+      {
+        FRAME_Store(pRing, out, (const uint8_t *)"", 1U);
+        out++;
+      }
+      hframe->State = (byte != 0xFFU) ? FRAME_STATE_ZERO : 0U;
+      hframe->Remaining = (uint32_t)byte - 1U;
+    }
+    else
+    {
+      FRAME_Store(pRing, out, &byte, 1U);
+      hframe->Remaining--;
+      out++;
+    }
+  }
+
+  hframe->Read = in;
+  hframe->Write = out;
+
+  /* A frame filling the whole ring can not complete */
+  if ((hframe->Consumed == 0U) && (in >= (pRing->Size - 1U)))
+  {
+    hframe->State |= FRAME_STATE_DISCARD;
+    hframe->ErrorCount++;
+  }
+  if ((hframe->Consumed == 0U) && ((hframe->State & FRAME_STATE_DISCARD) != 0U))
+  {
+    FRAME_Drop(hframe, in);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,480 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fwpatch.c
+  * @author  MCU Application Team
+  * @brief   Delta firmware update BSP service.
+  *          This file rebuilds the new image from the running one and a
+  *          patch, while the patch is received, on top of BSP_FWUPDATE:
+  *           + Records of bsdiff: bytes added to the running image, new
+  *             bytes, then a jump in the running image
+  *           + Records compressed with BSP_LZSS
+  *           + Running image read in place, new image programmed page by
+  *             page by the A/B update agent and checked by its CRC
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Misc/Tools/fwpatch.py makes the patch from the binary of the running
+       image, built for its slot, and the binary of the new one, built for
+       the other slot: the addresses moved by the slot change are small
+       differences the compression takes. For a change of the application,
+       a patch is several times smaller than the image.
+
+   (#) A patch is a BSP_FWPATCH_HeaderTypeDef, then records compressed with
+       the LZSS of BSP_LZSS, WindowBits up to BSP_FWPATCH_WINDOW_BITS. A
+       record is three varints, the jump in the running image as a zig-zag
+       value, the bytes of difference and the new bytes, followed by the
+       difference bytes, each added to the next byte of the running image,
+       and the new bytes.
+
+   (#) Initialize BSP_FWUPDATE as for a full update, then BSP_FWPATCH_Init().
+       The transport calls BSP_FWPATCH_Begin(), then BSP_FWPATCH_Write() with
+       the patch chunks in order, up to FLASH_PAGE_SIZE bytes each: HAL_BUSY
+       asks to retry the chunk later. BSP_FWPATCH_Write() only copies the
+       chunk and may be called from the interrupt of the transport.
+
+   (#) BSP_FWPATCH_Process() from the main loop does the work:
+       (++) the header complete, the running image is checked, its trailer
+            matching OldSize and OldCrc and its CRC right, and
+            BSP_FWUPDATE_Begin() starts the update of the idle slot;
+       (++) the records are expanded BSP_FWPATCH_BODY_SIZE bytes at a time
+            and applied, each page of the new image given to
+            BSP_FWUPDATE_Write(), programmed by HAL_FLASH_PageProgram_IT();
+       (++) the new image complete, BSP_FWUPDATE_Process() checks its CRC,
+            NewCrc, and programs the trailer: BSP_FWPATCH_STATE_DONE.
+       The RAM taken is the one of this structure, about 1.7 Kbytes.
+
+   (#) A patch made for another image is refused before anything is erased.
+       A corrupted patch fails the CRC of the new image at the latest, the
+       running image staying selected.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_fwpatch.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FWPATCH BSP FWPATCH
+  * @brief Delta firmware update BSP service
+  * @{
+  */
+
+#if defined (HAL_FLASH_MODULE_ENABLED) && defined (HAL_CRC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_FWPATCH_Private_Constants BSP FWPATCH Private Constants
+  * @{
+  */
+#define FWPATCH_FIELD_JUMP              0U             /*!< Zig-zag jump in the running image               */
+#define FWPATCH_FIELD_DIFF              1U             /*!< Bytes of difference                             */
+#define FWPATCH_FIELD_EXTRA             2U             /*!< New bytes                                       */
+#define FWPATCH_FIELD_DATA              3U             /*!< Difference then new bytes                       */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_FWPATCH_Private_Functions BSP FWPATCH Private Functions
+  * @{
+  */
+static HAL_StatusTypeDef FWPATCH_Start(BSP_FWPATCH_TypeDef *hpatch);
+static HAL_StatusTypeDef FWPATCH_Step(BSP_FWPATCH_TypeDef *hpatch);
+static void              FWPATCH_Apply(BSP_FWPATCH_TypeDef *hpatch);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FWPATCH_Exported_Functions BSP FWPATCH Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the delta update.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @param  hfw A/B update agent, initialized by BSP_FWUPDATE_Init().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FWPATCH_Init(BSP_FWPATCH_TypeDef *hpatch, BSP_FWUPDATE_TypeDef *hfw)
+{
+  if ((hpatch == NULL) || (hfw == NULL) || (hfw->hcrc == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  hpatch->hfw    = hfw;
+  hpatch->InSize = 0U;
+  hpatch->State  = BSP_FWPATCH_STATE_IDLE;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a delta update, the patch given next by BSP_FWPATCH_Write().
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FWPATCH_Begin(BSP_FWPATCH_TypeDef *hpatch)
+{
+  if (hpatch->hfw == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  hpatch->HeaderFill = 0U;
+  hpatch->pOld       = NULL;
+  hpatch->InPos      = 0U;
+  hpatch->BodySize   = 0U;
+  hpatch->BodyPos    = 0U;
+  hpatch->OutFill    = 0U;
+  hpatch->Field      = FWPATCH_FIELD_JUMP;
+  hpatch->Value      = 0U;
+  hpatch->Shift      = 0U;
+  hpatch->DiffLeft   = 0U;
+  hpatch->ExtraLeft  = 0U;
+  hpatch->OldPos     = 0U;
+  hpatch->NewPos     = 0U;
+  hpatch->Received   = 0U;
+  hpatch->InSize     = 0U;
+  hpatch->State      = BSP_FWPATCH_STATE_HEADER;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take the next chunk of the patch.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @param  pData Chunk.
+  * @param  Size Chunk size in bytes, 1 to FLASH_PAGE_SIZE.
+  * @retval HAL status, HAL_BUSY while the previous chunk is applied: nothing
+  *         is taken, retry later
+  */
+HAL_StatusTypeDef BSP_FWPATCH_Write(BSP_FWPATCH_TypeDef *hpatch, const uint8_t *pData, uint32_t Size)
+{
+  if (((hpatch->State != BSP_FWPATCH_STATE_HEADER) && (hpatch->State != BSP_FWPATCH_STATE_BODY)) ||
+      (pData == NULL) || (Size == 0U) || (Size > FLASH_PAGE_SIZE))
+  {
+    return HAL_ERROR;
+  }
+
+  /* InSize only goes down in BSP_FWPATCH_Process() */
+  if (hpatch->InSize != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  memcpy(hpatch->In, pData, Size);
+  hpatch->InPos     = 0U;
+  hpatch->Received += Size;
+  hpatch->InSize    = Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Apply the patch received and commit the new image.
+  * @note   To be called from the main loop.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval HAL status, HAL_ERROR once the update failed
+  */
+HAL_StatusTypeDef BSP_FWPATCH_Process(BSP_FWPATCH_TypeDef *hpatch)
+{
+  switch (hpatch->State)
+  {
+    case BSP_FWPATCH_STATE_HEADER:
+    case BSP_FWPATCH_STATE_BODY:
+      FWPATCH_Apply(hpatch);
+      break;
+
+    case BSP_FWPATCH_STATE_COMMIT:
+      if (BSP_FWUPDATE_Process(hpatch->hfw) != HAL_OK)
+      {
+        hpatch->State = BSP_FWPATCH_STATE_ERROR;
+      }
+      else if (hpatch->hfw->State == BSP_FWUPDATE_STATE_DONE)
+      {
+        hpatch->State = BSP_FWPATCH_STATE_DONE;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return (hpatch->State == BSP_FWPATCH_STATE_ERROR) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+  * @brief  Stop the delta update, the slot written stays invalid.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval None
+  */
+void BSP_FWPATCH_Abort(BSP_FWPATCH_TypeDef *hpatch)
+{
+  if (hpatch->pOld != NULL)
+  {
+    BSP_FWUPDATE_Abort(hpatch->hfw);
+  }
+
+  hpatch->InSize = 0U;
+  hpatch->State  = BSP_FWPATCH_STATE_IDLE;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FWPATCH_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Check the header and the running image, and start the update of the idle slot.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval HAL status, HAL_BUSY while the update agent ends a previous operation
+  */
+static HAL_StatusTypeDef FWPATCH_Start(BSP_FWPATCH_TypeDef *hpatch)
+{
+  const BSP_FWPATCH_HeaderTypeDef *header = &hpatch->Header;
+  const BSP_FWUPDATE_TrailerTypeDef *trailer;
+  const uint32_t *word = (const uint32_t *)header;
+  uint32_t slot = BSP_FWUPDATE_GetRunningSlot();
+  uint32_t check = 0U;
+  uint32_t i;
+  HAL_StatusTypeDef status;
+
+  for (i = 0U; i < ((sizeof(BSP_FWPATCH_HeaderTypeDef) / 4U) - 1U); i++)
+  {
+    check ^= word[i];
+  }
+
+  if ((header->Magic != BSP_FWPATCH_MAGIC) || (header->Check != ~check) || (slot == BSP_FWUPDATE_SLOT_NONE) ||
+      (header->WindowBits > BSP_FWPATCH_WINDOW_BITS) ||
+      (BSP_LZSS_DecInit(&hpatch->Dec, hpatch->Window, header->WindowBits, header->LookaheadBits) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The patch is for the running image only, read in place while the other slot is written */
+  trailer = (const BSP_FWUPDATE_TrailerTypeDef *)(BSP_FWUPDATE_GetSlotAddress(slot) + BSP_FWUPDATE_IMAGE_MAX);
+  if ((trailer->Size != header->OldSize) || (trailer->Crc != header->OldCrc) ||
+      (BSP_FWUPDATE_CheckSlot(hpatch->hfw->hcrc, slot, NULL) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  status = BSP_FWUPDATE_Begin(hpatch->hfw, header->NewSize, header->NewVersion, header->NewCrc);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hpatch->pOld  = (const uint8_t *)BSP_FWUPDATE_GetSlotAddress(slot);
+  hpatch->State = BSP_FWPATCH_STATE_BODY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Use a byte of the records expanded, or make a byte of the new image.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval HAL status, HAL_ERROR for a record out of the images
+  */
+static HAL_StatusTypeDef FWPATCH_Step(BSP_FWPATCH_TypeDef *hpatch)
+{
+  uint8_t byte = hpatch->Body[hpatch->BodyPos++];
+
+  if (hpatch->Field == FWPATCH_FIELD_DATA)
+  {
+    if (hpatch->DiffLeft != 0U)
+    {
+      if (hpatch->OldPos >= hpatch->Header.OldSize)
+      {
+        return HAL_ERROR;
+      }
+      hpatch->Out[hpatch->OutFill++] = (uint8_t)(hpatch->pOld[hpatch->OldPos++] + byte);
+      hpatch->DiffLeft--;
+    }
+    else
+    {
+      hpatch->Out[hpatch->OutFill++] = byte;
+      hpatch->ExtraLeft--;
+    }
+    hpatch->NewPos++;
+  }
+  else
+  {
+    hpatch->Value |= (uint32_t)(byte & 0x7FU) << hpatch->Shift;
+    hpatch->Shift += 7U;
+    if ((byte & 0x80U) != 0U)
+    {
+      return (hpatch->Shift > 28U) ? HAL_ERROR : HAL_OK;
+    }
+
+    switch (hpatch->Field)
+    {
+      case FWPATCH_FIELD_JUMP:
+        hpatch->OldPos += (hpatch->Value >> 1) ^ (0U - (hpatch->Value & 1U));
+        break;
+
+      case FWPATCH_FIELD_DIFF:
+        hpatch->DiffLeft = hpatch->Value;
+        break;
+
+      default:
+        hpatch->ExtraLeft = hpatch->Value;
+        if ((hpatch->DiffLeft > (hpatch->Header.NewSize - hpatch->NewPos)) ||
+            (hpatch->ExtraLeft > (hpatch->Header.NewSize - hpatch->NewPos - hpatch->DiffLeft)))
+        {
+          return HAL_ERROR;
+        }
+        break;
+    }
+    hpatch->Field++;
+    hpatch->Value = 0U;
+    hpatch->Shift = 0U;
+  }
+
+  /* Record applied, the next one follows */
+  if ((hpatch->Field == FWPATCH_FIELD_DATA) && (hpatch->DiffLeft == 0U) && (hpatch->ExtraLeft == 0U))
+  {
+    hpatch->Field = FWPATCH_FIELD_JUMP;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Apply the chunk of the patch received, up to the update agent full or the chunk used.
+  * @param  hpatch Pointer to a BSP_FWPATCH_TypeDef structure.
+  * @retval None
+  */
+static void FWPATCH_Apply(BSP_FWPATCH_TypeDef *hpatch)
+{
+  HAL_StatusTypeDef status;
+  uint32_t used;
+  uint32_t size;
+
+  for (;;)
+  {
+    /* A page of the new image, or its end, to the update agent */
+    if ((hpatch->OutFill == FLASH_PAGE_SIZE) ||
+        ((hpatch->OutFill != 0U) && (hpatch->NewPos == hpatch->Header.NewSize)))
+    {
+      status = BSP_FWUPDATE_Write(hpatch->hfw, hpatch->Out, hpatch->OutFill);
+      if (status == HAL_BUSY)
+      {
+        return;
+      }
+      if (status != HAL_OK)
+      {
+        hpatch->State = BSP_FWPATCH_STATE_ERROR;
+        return;
+      }
+      hpatch->OutFill = 0U;
+    }
+
+    if (hpatch->State == BSP_FWPATCH_STATE_HEADER)
+    {
+      if (hpatch->HeaderFill == sizeof(BSP_FWPATCH_HeaderTypeDef))
+      {
+        status = FWPATCH_Start(hpatch);
+        if (status == HAL_BUSY)
+        {
+          return;
+        }
+        if (status != HAL_OK)
+        {
+          hpatch->State = BSP_FWPATCH_STATE_ERROR;
+          return;
+        }
+        continue;
+      }
+      if (hpatch->InPos < hpatch->InSize)
+      {
+        size = sizeof(BSP_FWPATCH_HeaderTypeDef) - hpatch->HeaderFill;
+        if (size > (hpatch->InSize - hpatch->InPos))
+        {
+          size = hpatch->InSize - hpatch->InPos;
+        }
+        memcpy((uint8_t *)&hpatch->Header + hpatch->HeaderFill, &hpatch->In[hpatch->InPos], size);
+        hpatch->HeaderFill += size;
+        hpatch->InPos      += size;
+        continue;
+      }
+    }
+    else if (hpatch->NewPos == hpatch->Header.NewSize)
+    {
+      /* The rest of the patch, padding, is not needed */
+      hpatch->State = BSP_FWPATCH_STATE_COMMIT;
+      return;
+    }
+    else if (hpatch->BodyPos < hpatch->BodySize)
+    {
+      if (FWPATCH_Step(hpatch) != HAL_OK)
+      {
+        hpatch->State = BSP_FWPATCH_STATE_ERROR;
+        return;
+      }
+      continue;
+    }
+    else
+    {
+      /* Also run without input, the decoder holding the end of a chunk */
+      (void)BSP_LZSS_Decode(&hpatch->Dec, &hpatch->In[hpatch->InPos], hpatch->InSize - hpatch->InPos, &used,
+                            hpatch->Body, BSP_FWPATCH_BODY_SIZE, &size);
+      hpatch->InPos   += used;
+      hpatch->BodyPos  = 0U;
+      hpatch->BodySize = size;
+      if ((used != 0U) || (size != 0U))
+      {
+        continue;
+      }
+    }
+
+    /* The chunk used, the next one taken by BSP_FWPATCH_Write() */
+    if (hpatch->InPos == hpatch->InSize)
+    {
+      hpatch->InSize = 0U;
+    }
+    return;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED && HAL_CRC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,713 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_fwupdate.c
+  * @author  MCU Application Team
+  * @brief   A/B firmware update BSP service.
+  *          This file provides functions to update the application in the
+  *          field while it runs:
+  *           + Two application slots after a small bootloader
+  *           + Image streamed into the idle slot, erase and program in the
+  *             background while the next page is received
+  *           + CRC check with the CRC peripheral, trailer written last
+  *           + Slot selection and jump for the bootloader
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Flash layout, see @ref BSP_FWUPDATE_Layout:
+       (+) The bootloader, built with FW_SLOT=boot, takes the first 16 Kbytes.
+           Examples/Bootloader/AB_Boot calls BSP_FWUPDATE_SelectSlot() and
+           BSP_FWUPDATE_Jump().
+       (+) The application is built with FW_SLOT=a or FW_SLOT=b: its linker
+           script places it in the slot and VECT_TAB_OFFSET points VTOR to its
+           vector table. The image sent for an update is the one built for the
+           slot returned by BSP_FWUPDATE_Begin() in hfw->Slot: the slot that is
+           not running.
+       (+) The last page of a slot holds its trailer {version, size, CRC}. A
+           slot boots only with a valid trailer and a matching CRC, the highest
+           version first.
+
+   (#) In the application: enable FLASH_IRQn in the NVIC, call
+       HAL_FLASH_IRQHandler() from FLASH_IRQHandler(),
+       BSP_FWUPDATE_EndOfOperationHandler() from
+       HAL_FLASH_EndOfOperationCallback() and BSP_FWUPDATE_ErrorHandler() from
+       HAL_FLASH_OperationErrorCallback(). Initialize the CRC with its default
+       polynomial and call BSP_FWUPDATE_Init().
+
+   (#) The transport, UART, CAN or other, drives the update:
+       (+) BSP_FWUPDATE_Begin() with the size, version and CRC of the image.
+           The trailer sector of the idle slot is erased first: the slot is
+           invalid until the end of the update.
+       (+) BSP_FWUPDATE_Write() with the image chunks in order, up to
+           FLASH_PAGE_SIZE bytes each. A chunk is copied into the page being
+           received and returns: each full page is programmed with
+           HAL_FLASH_PageProgram_IT(), its sector erased with
+           HAL_FLASH_Erase_IT() first, from the flash interrupt. HAL_BUSY asks
+           the transport to retry the chunk later.
+       (+) BSP_FWUPDATE_Process() from the main loop checks the CRC of the
+           programmed image and programs the trailer. BSP_FWUPDATE_STATE_DONE
+           then marks the update as complete.
+
+   (#) The running application is not stopped: the new image starts on the
+       next reset, at a time chosen by the application. A failed or aborted
+       update leaves the running image selected.
+
+   (#) The CPU stalls on a code fetch from the flash while a page is
+       programmed or a sector erased, see USE_FLASH_RAMFUNC.
+
+   (#) The CRC only catches accidental corruption. A slot started on its CRC
+       can check its SHA-256 digest afterwards, in the background, with
+       BSP_SHA256_VerifyStart(), see py32f4xx_bsp_sha256.c.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_fwupdate.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_FWUPDATE BSP FWUPDATE
+  * @brief A/B firmware update BSP service
+  * @{
+  */
+
+#if defined (HAL_FLASH_MODULE_ENABLED) && defined (HAL_CRC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_FWUPDATE_Private_Constants BSP FWUPDATE Private Constants
+  * @{
+  */
+#define FWUPDATE_MAGIC                  0x31555746U    /* "FWU1" */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_FWUPDATE_Private_Macros BSP FWUPDATE Private Macros
+  * @{
+  */
+#define FWUPDATE_TRAILER_ADDRESS(__SLOT__) (BSP_FWUPDATE_GetSlotAddress(__SLOT__) + BSP_FWUPDATE_IMAGE_MAX)
+#define FWUPDATE_TRAILER_SECTOR(__SLOT__)  (BSP_FWUPDATE_GetSlotAddress(__SLOT__) + BSP_FWUPDATE_SLOT_SIZE - FLASH_SECTOR_SIZE)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_FWUPDATE_Private_Functions
+  * @{
+  */
+static uint32_t FWUPDATE_TrailerCheck(const BSP_FWUPDATE_TrailerTypeDef *pTrailer);
+static uint32_t FWUPDATE_Crc(CRC_HandleTypeDef *hcrc, uint32_t Address, uint32_t Size);
+static void FWUPDATE_Queue(BSP_FWUPDATE_TypeDef *hfw);
+static void FWUPDATE_Next(BSP_FWUPDATE_TypeDef *hfw);
+static void FWUPDATE_Kick(BSP_FWUPDATE_TypeDef *hfw);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_FWUPDATE_Exported_Functions BSP FWUPDATE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_FWUPDATE_Exported_Functions_Group1 Slot functions
+  * @brief    Slot functions
+  *
+@verbatim
+ ===============================================================================
+                          ##### Slot functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Locate the slots and the running one
+      (+) Check a slot and select the one to boot
+      (+) Start the application of a slot
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Get the first address of a slot.
+  * @param  Slot A value of @ref BSP_FWUPDATE_Slot.
+  * @retval Slot address, 0 for BSP_FWUPDATE_SLOT_NONE
+  */
+uint32_t BSP_FWUPDATE_GetSlotAddress(uint32_t Slot)
+{
+  if (Slot == BSP_FWUPDATE_SLOT_A)
+  {
+    return BSP_FWUPDATE_SLOT_A_ADDRESS;
+  }
+  if (Slot == BSP_FWUPDATE_SLOT_B)
+  {
+    return BSP_FWUPDATE_SLOT_B_ADDRESS;
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Get the slot of the running application, from VTOR.
+  * @retval A value of @ref BSP_FWUPDATE_Slot, BSP_FWUPDATE_SLOT_NONE when not
+  *         running from a slot
+  */
+uint32_t BSP_FWUPDATE_GetRunningSlot(void)
+{
+  uint32_t vtor = SCB->VTOR;
+
+  if ((vtor >= BSP_FWUPDATE_SLOT_A_ADDRESS) && (vtor < BSP_FWUPDATE_SLOT_B_ADDRESS))
+  {
+    return BSP_FWUPDATE_SLOT_A;
+  }
+  if ((vtor >= BSP_FWUPDATE_SLOT_B_ADDRESS) && (vtor < (BSP_FWUPDATE_SLOT_B_ADDRESS + BSP_FWUPDATE_SLOT_SIZE)))
+  {
+    return BSP_FWUPDATE_SLOT_B;
+  }
+
+  return BSP_FWUPDATE_SLOT_NONE;
+}
+
+/**
+  * @brief  Check the trailer, the vector table and the CRC of a slot.
+  * @param  hcrc CRC handle, default polynomial.
+  * @param  Slot A value of @ref BSP_FWUPDATE_Slot.
+  * @param  pVersion Image version, may be NULL.
+  * @retval HAL status, HAL_ERROR when the slot holds no valid image
+  */
+HAL_StatusTypeDef BSP_FWUPDATE_CheckSlot(CRC_HandleTypeDef *hcrc, uint32_t Slot, uint32_t *pVersion)
+{
+  const BSP_FWUPDATE_TrailerTypeDef *ptrailer;
+  const uint32_t *pvector;
+  uint32_t address = BSP_FWUPDATE_GetSlotAddress(Slot);
+
+  if ((hcrc == NULL) || (address == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  ptrailer = (const BSP_FWUPDATE_TrailerTypeDef *)FWUPDATE_TRAILER_ADDRESS(Slot);
+  pvector  = (const uint32_t *)address;
+  if ((FWUPDATE_TrailerCheck(ptrailer) == 0U) ||
+      ((pvector[0] & 0xFFF00000U) != SRAM_BASE) ||
+      (pvector[1] < address) || (pvector[1] >= (address + ptrailer->Size)) ||
+      (FWUPDATE_Crc(hcrc, address, ptrailer->Size) != ptrailer->Crc))
+  {
+    return HAL_ERROR;
+  }
+
+  if (pVersion != NULL)
+  {
+    *pVersion = ptrailer->Version;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Select the slot to boot.
+  * @param  hcrc CRC handle, default polynomial.
+  * @retval Valid slot with the highest version, BSP_FWUPDATE_SLOT_NONE when none
+  */
+uint32_t BSP_FWUPDATE_SelectSlot(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t version_a;
+  uint32_t version_b;
+  uint32_t valid_a;
+  uint32_t valid_b;
+
+  valid_a = (BSP_FWUPDATE_CheckSlot(hcrc, BSP_FWUPDATE_SLOT_A, &version_a) == HAL_OK) ? 1U : 0U;
+  valid_b = (BSP_FWUPDATE_CheckSlot(hcrc, BSP_FWUPDATE_SLOT_B, &version_b) == HAL_OK) ? 1U : 0U;
+
+  if ((valid_a != 0U) && ((valid_b == 0U) || (version_a >= version_b)))
+  {
+    return BSP_FWUPDATE_SLOT_A;
+  }
+  if (valid_b != 0U)
+  {
+    return BSP_FWUPDATE_SLOT_B;
+  }
+
+  return BSP_FWUPDATE_SLOT_NONE;
+}
+
+/**
+  * @brief  Start the application of a slot, does not return.
+  * @note   The peripherals used by the caller are to be stopped first, for
+  *         instance with HAL_DeInit(). SysTick and the NVIC are cleared here.
+  * @param  Slot A value of @ref BSP_FWUPDATE_Slot, checked with
+  *         BSP_FWUPDATE_CheckSlot().
+  * @retval None
+  */
+void BSP_FWUPDATE_Jump(uint32_t Slot)
+{
+  const uint32_t *pvector = (const uint32_t *)BSP_FWUPDATE_GetSlotAddress(Slot);
+  void (*preset)(void);
+  uint32_t i;
+
+  if (pvector == NULL)
+  {
+    return;
+  }
+
+  __disable_irq();
+
+  SysTick->CTRL = 0U;
+  for (i = 0U; i < (sizeof(NVIC->ICER) / sizeof(NVIC->ICER[0])); i++)
+  {
+    NVIC->ICER[i] = 0xFFFFFFFFU;
+    NVIC->ICPR[i] = 0xFFFFFFFFU;
+  }
+
+  /* The application vector table, stack and reset handler */
+  SCB->VTOR = (uint32_t)pvector;
+  preset = (void (*)(void))pvector[1];
+  __set_MSP(pvector[0]);
+  __DSB();
+  __ISB();
+
+  __enable_irq();
+  preset();
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_FWUPDATE_Exported_Functions_Group2 Update functions
+  * @brief    Update functions
+  *
+@verbatim
+ ===============================================================================
+                         ##### Update functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Stream an image into the idle slot
+      (+) Check and commit the image
+      (+) Erase and program from the flash interrupt
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the update agent.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @param  hcrc CRC handle, default polynomial.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_FWUPDATE_Init(BSP_FWUPDATE_TypeDef *hfw, CRC_HandleTypeDef *hcrc)
+{
+  if ((hfw == NULL) || (hcrc == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  memset(hfw, 0, sizeof(BSP_FWUPDATE_TypeDef));
+  hfw->Slot  = BSP_FWUPDATE_SLOT_NONE;
+  hfw->State = BSP_FWUPDATE_STATE_IDLE;
+  hfw->hcrc  = hcrc;
+
+  return HAL_FLASH_Unlock();
+}
+
+/**
+  * @brief  Start an update of the idle slot.
+  * @note   The slot written is returned in hfw->Slot, the image sent must be
+  *         built for it.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @param  Size Image size in bytes, up to BSP_FWUPDATE_IMAGE_MAX.
+  * @param  Version Image version, higher than the running one.
+  * @param  Crc CRC-32 of the image, see BSP_FWUPDATE_TrailerTypeDef.
+  * @retval HAL status, HAL_BUSY while an erase or program of the previous
+  *         update runs
+  */
+HAL_StatusTypeDef BSP_FWUPDATE_Begin(BSP_FWUPDATE_TypeDef *hfw, uint32_t Size, uint32_t Version, uint32_t Crc)
+{
+  if ((hfw->hcrc == NULL) || (Size == 0U) || (Size > BSP_FWUPDATE_IMAGE_MAX))
+  {
+    return HAL_ERROR;
+  }
+  if (hfw->Busy != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  hfw->Slot = (BSP_FWUPDATE_GetRunningSlot() == BSP_FWUPDATE_SLOT_A) ? BSP_FWUPDATE_SLOT_B : BSP_FWUPDATE_SLOT_A;
+  hfw->Trailer.Magic   = FWUPDATE_MAGIC;
+  hfw->Trailer.Version = Version;
+  hfw->Trailer.Size    = Size;
+  hfw->Trailer.Crc     = Crc;
+  hfw->Trailer.Check   = ~(FWUPDATE_MAGIC ^ Version ^ Size ^ Crc);
+
+  hfw->Received       = 0U;
+  hfw->ProgramAddress = BSP_FWUPDATE_GetSlotAddress(hfw->Slot);
+  hfw->EraseAddress   = hfw->ProgramAddress;
+  hfw->TrailerErased  = 0U;
+  hfw->Head  = 0U;
+  hfw->Fill  = 0U;
+  hfw->Count = 0U;
+  memset(hfw->Buffer, 0xFF, sizeof(hfw->Buffer));
+  hfw->State = BSP_FWUPDATE_STATE_RECEIVE;
+
+  FWUPDATE_Kick(hfw);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take the next chunk of the image.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @param  pData Chunk.
+  * @param  Size Chunk size in bytes, up to FLASH_PAGE_SIZE.
+  * @retval HAL status, HAL_BUSY when the page buffers are full: nothing is
+  *         taken, retry later
+  */
+HAL_StatusTypeDef BSP_FWUPDATE_Write(BSP_FWUPDATE_TypeDef *hfw, const uint8_t *pData, uint32_t Size)
+{
+  uint32_t chunk;
+
+  if ((hfw->State != BSP_FWUPDATE_STATE_RECEIVE) || (pData == NULL) || (Size > FLASH_PAGE_SIZE) ||
+      (Size > (hfw->Trailer.Size - hfw->Received)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Count only goes down in the interrupt */
+  if (Size > (((2U - hfw->Count) * FLASH_PAGE_SIZE) - hfw->Fill))
+  {
+    FWUPDATE_Kick(hfw);
+    return HAL_BUSY;
+  }
+
+  hfw->Received += Size;
+  while (Size != 0U)
+  {
+    chunk = FLASH_PAGE_SIZE - hfw->Fill;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    memcpy((uint8_t *)hfw->Buffer[hfw->Head] + hfw->Fill, pData, chunk);
+    hfw->Fill += chunk;
+    pData     += chunk;
+    Size      -= chunk;
+    if (hfw->Fill == FLASH_PAGE_SIZE)
+    {
+      FWUPDATE_Queue(hfw);
+    }
+  }
+
+  if (hfw->Received == hfw->Trailer.Size)
+  {
+    /* Last page, padded with 0xFF */
+    if (hfw->Fill != 0U)
+    {
+      FWUPDATE_Queue(hfw);
+    }
+    hfw->State = BSP_FWUPDATE_STATE_PROGRAM;
+  }
+
+  FWUPDATE_Kick(hfw);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check and commit the programmed image.
+  * @note   To be called from the main loop. The CRC of the whole image is
+  *         computed in one call, about one cycle per byte read.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval HAL status, HAL_ERROR once the update failed
+  */
+HAL_StatusTypeDef BSP_FWUPDATE_Process(BSP_FWUPDATE_TypeDef *hfw)
+{
+  const BSP_FWUPDATE_TrailerTypeDef *ptrailer;
+  uint32_t *pbuffer;
+
+  if (hfw->hcrc == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  FWUPDATE_Kick(hfw);
+  if (hfw->Busy != 0U)
+  {
+    return (hfw->State == BSP_FWUPDATE_STATE_ERROR) ? HAL_ERROR : HAL_OK;
+  }
+
+  switch (hfw->State)
+  {
+    case BSP_FWUPDATE_STATE_PROGRAM:
+      if (hfw->Count != 0U)
+      {
+        break;
+      }
+      if (FWUPDATE_Crc(hfw->hcrc, BSP_FWUPDATE_GetSlotAddress(hfw->Slot), hfw->Trailer.Size) != hfw->Trailer.Crc)
+      {
+        hfw->State = BSP_FWUPDATE_STATE_ERROR;
+        break;
+      }
+
+      /* The trailer validates the slot, programmed last */
+      pbuffer = hfw->Buffer[hfw->Head];
+      memset(pbuffer, 0xFF, FLASH_PAGE_SIZE);
+      memcpy(pbuffer, &hfw->Trailer, sizeof(BSP_FWUPDATE_TrailerTypeDef));
+      hfw->Busy = 1U;
+      if (HAL_FLASH_PageProgram_IT(FWUPDATE_TRAILER_ADDRESS(hfw->Slot), pbuffer) != HAL_OK)
+      {
+        hfw->Busy = 0U;
+        break;
+      }
+      hfw->State = BSP_FWUPDATE_STATE_COMMIT;
+      break;
+
+    case BSP_FWUPDATE_STATE_COMMIT:
+      ptrailer = (const BSP_FWUPDATE_TrailerTypeDef *)FWUPDATE_TRAILER_ADDRESS(hfw->Slot);
+      hfw->State = (memcmp(ptrailer, &hfw->Trailer, sizeof(BSP_FWUPDATE_TrailerTypeDef)) == 0) ?
+                   BSP_FWUPDATE_STATE_DONE : BSP_FWUPDATE_STATE_ERROR;
+      break;
+
+    default:
+      break;
+  }
+
+  return (hfw->State == BSP_FWUPDATE_STATE_ERROR) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+  * @brief  Stop the update, the slot written stays invalid.
+  * @note   An erase or program already started ends in the background.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+void BSP_FWUPDATE_Abort(BSP_FWUPDATE_TypeDef *hfw)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hfw->Count = 0U;
+  hfw->Fill  = 0U;
+  hfw->State = BSP_FWUPDATE_STATE_IDLE;
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Flash end of operation handler, starts the next erase or program.
+  * @note   To be called from HAL_FLASH_EndOfOperationCallback().
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+void BSP_FWUPDATE_EndOfOperationHandler(BSP_FWUPDATE_TypeDef *hfw)
+{
+  if ((hfw->hcrc != NULL) && (hfw->Busy != 0U))
+  {
+    hfw->Busy = 0U;
+    FWUPDATE_Next(hfw);
+  }
+}
+
+/**
+  * @brief  Flash operation error handler, fails the update.
+  * @note   To be called from HAL_FLASH_OperationErrorCallback().
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+void BSP_FWUPDATE_ErrorHandler(BSP_FWUPDATE_TypeDef *hfw)
+{
+  if ((hfw->hcrc != NULL) && (hfw->Busy != 0U))
+  {
+    hfw->State = BSP_FWUPDATE_STATE_ERROR;
+    hfw->Busy  = 0U;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_FWUPDATE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Check the marker and the check word of a trailer.
+  * @param  pTrailer Trailer.
+  * @retval 1 when the trailer is valid, 0 otherwise
+  */
+static uint32_t FWUPDATE_TrailerCheck(const BSP_FWUPDATE_TrailerTypeDef *pTrailer)
+{
+  if ((pTrailer->Magic != FWUPDATE_MAGIC) || (pTrailer->Size == 0U) || (pTrailer->Size > BSP_FWUPDATE_IMAGE_MAX) ||
+      (pTrailer->Check != ~(pTrailer->Magic ^ pTrailer->Version ^ pTrailer->Size ^ pTrailer->Crc)))
+  {
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  CRC of an image in the flash.
+  * @param  hcrc CRC handle.
+  * @param  Address First byte, word aligned.
+  * @param  Size Image size, the last word is read with its 0xFF padding.
+  * @retval CRC
+  */
+static uint32_t FWUPDATE_Crc(CRC_HandleTypeDef *hcrc, uint32_t Address, uint32_t Size)
+{
+  return HAL_CRC_Calculate(hcrc, (uint32_t *)Address, (Size + 3U) / 4U);
+}
+
+/**
+  * @brief  Queue the page being received and open the other buffer.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+static void FWUPDATE_Queue(BSP_FWUPDATE_TypeDef *hfw)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hfw->Count++;
+
+  __set_PRIMASK(primask_bit);
+
+  hfw->Head ^= 1U;
+  hfw->Fill  = 0U;
+}
+
+/**
+  * @brief  Start the next erase or page program when the flash is idle.
+  * @note   Called with the interrupts disabled or from the flash interrupt.
+  *         The trailer sector goes first, then each sector just before its
+  *         first page is programmed.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+static void FWUPDATE_Next(BSP_FWUPDATE_TypeDef *hfw)
+{
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t *pbuffer;
+
+  if ((hfw->Busy != 0U) ||
+      ((hfw->State != BSP_FWUPDATE_STATE_RECEIVE) && (hfw->State != BSP_FWUPDATE_STATE_PROGRAM)))
+  {
+    return;
+  }
+
+  erase.TypeErase = FLASH_TYPEERASE_SECTORERASE;
+  erase.NbSectors = 1U;
+
+  if (hfw->TrailerErased == 0U)
+  {
+    erase.SectorAddress = FWUPDATE_TRAILER_SECTOR(hfw->Slot);
+  }
+  else if (hfw->Count == 0U)
+  {
+    return;
+  }
+  else
+  {
+    if (hfw->EraseAddress == FWUPDATE_TRAILER_SECTOR(hfw->Slot))
+    {
+      hfw->EraseAddress += FLASH_SECTOR_SIZE;
+    }
+    if (hfw->ProgramAddress >= hfw->EraseAddress)
+    {
+      erase.SectorAddress = hfw->EraseAddress;
+    }
+  }
+
+  hfw->Busy = 1U;
+  if (erase.SectorAddress != 0U)
+  {
+    if (HAL_FLASH_Erase_IT(&erase) != HAL_OK)
+    {
+      /* Flash held by another user, started again on the next call */
+      hfw->Busy = 0U;
+      return;
+    }
+    if (hfw->TrailerErased == 0U)
+    {
+      hfw->TrailerErased = 1U;
+    }
+    else
+    {
+      hfw->EraseAddress += FLASH_SECTOR_SIZE;
+    }
+    return;
+  }
+
+  /* The page is latched, its buffer is free for the next chunk */
+  pbuffer = hfw->Buffer[(hfw->Head + 2U - hfw->Count) % 2U];
+  if (HAL_FLASH_PageProgram_IT(hfw->ProgramAddress, pbuffer) != HAL_OK)
+  {
+    hfw->Busy = 0U;
+    return;
+  }
+  memset(pbuffer, 0xFF, FLASH_PAGE_SIZE);
+  hfw->ProgramAddress += FLASH_PAGE_SIZE;
+  hfw->Count--;
+}
+
+/**
+  * @brief  Start the next operation from the thread context.
+  * @param  hfw Pointer to a BSP_FWUPDATE_TypeDef structure.
+  * @retval None
+  */
+static void FWUPDATE_Kick(BSP_FWUPDATE_TypeDef *hfw)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  FWUPDATE_Next(hfw);
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED && HAL_CRC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,773 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_grab.c
+  * @author  MCU Application Team
+  * @brief   SPI line and frame grabber BSP service.
+  *          This file provides functions to capture the pixels of a line
+  *          sensor or of a SPI camera at the sensor rate, the CPU free:
+  *           + Pixel clock on a timer PWM channel
+  *           + Line sync by the NSS pin or by an EXTI or timer callback
+  *           + Rx DMA of the SPI into a ring of preallocated lines
+  *           + Lines numbered in their frame, per line and per frame callbacks
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the SPI with HAL_SPI_Init(), SPI_DATASIZE_8BIT, preferably
+       SPI_DIRECTION_2LINES_RXONLY. Link a DMA channel to its hdmarx:
+       peripheral to memory, bytes on both sides, memory increment and
+       DMA_NORMAL, its interrupt enabled in the NVIC. The service owns the
+       Rx DMA callbacks, the SPI interrupt is not used.
+
+   (#) Select the line sync:
+       (+) BSP_GRAB_SYNC_NSS: the sensor has a line valid output (HREF). Wire
+           it to the NSS pin of a SPI_MODE_SLAVE SPI with SPI_NSS_HARD_INPUT
+           and the pixel clock to its SCK: the SPI only shifts during a line
+           and the DMA runs in double buffer mode, switching to the next line
+           by itself. Nothing runs on the line start.
+       (+) BSP_GRAB_SYNC_SOFT: the line starts on an event, the SYNC pin of a
+           linear CCD on an EXTI line or the integration period of a timer.
+           Call BSP_GRAB_SyncHandler() from the EXTI or timer callback: it
+           flushes the SPI and starts the DMA of the next line. A master SPI
+           then clocks the sensor with its SCK, a slave SPI with SPI_NSS_SOFT
+           is released by the SSI bit. The first pixel must follow the sync
+           by more than the interrupt latency.
+
+   (#) Call BSP_GRAB_Init() with an array of LineCount line headers and a
+       storage of LineCount x LineSize bytes, both kept by the service. The
+       storage can be a __DMA_BUFFER array or a region of BSP_RAMMAP_Take()
+       sized from the RAM of the device. With a timer clocking the sensor and
+       a slave SPI, BSP_GRAB_SetPixelClock() gives the PWM channel of the
+       pixel clock, configured at the pixel rate with a 50% duty cycle: the
+       service starts and stops it with the capture.
+
+   (#) BSP_GRAB_Start() starts the capture. At the end of each line the DMA
+       callback numbers it in its frame, queues it and calls
+       BSP_GRAB_LineCpltCallback(), then BSP_GRAB_FrameCpltCallback() after
+       the LinesPerFrame th line. A frame sync (VSYNC) on an EXTI line calls
+       BSP_GRAB_FrameHandler(): the next line is line 0 of a new frame, and a
+       line or a frame cut short is counted in Resyncs, the capture
+       realigned on the sync.
+
+   (#) BSP_GRAB_Get() returns the oldest full line or NULL, and the line
+       belongs to the caller until BSP_GRAB_Release(). When no line is free
+       at the end of a line, the full line is written again instead of being
+       queued: its pixels are lost, Overruns counts it and the next line
+       received skips its number. Release the lines before the ring runs out.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_grab.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_GRAB BSP GRAB
+  * @brief SPI line and frame grabber BSP service
+  * @{
+  */
+
+#if defined (HAL_SPI_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_GRAB_Private_Constants BSP GRAB Private Constants
+  * @{
+  */
+#define GRAB_MASK                       (BSP_GRAB_LINES_MAX - 1U)
+#define GRAB_INSTANCES                  3U             /* SPI1, SPI2 and SPI3 */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_GRAB_Private_Variables BSP GRAB Private Variables
+  * @{
+  */
+/* Capture running on each SPI, found from the DMA callbacks */
+static BSP_GRAB_TypeDef *GRAB_Handles[GRAB_INSTANCES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_GRAB_Private_Functions BSP GRAB Private Functions
+  * @{
+  */
+static uint32_t          GRAB_GetIndex(const SPI_TypeDef *Instance);
+static BSP_GRAB_TypeDef *GRAB_GetHandle(const DMA_HandleTypeDef *hdma);
+static void              GRAB_Reset(const BSP_GRAB_TypeDef *hgrab);
+static HAL_StatusTypeDef GRAB_Arm(BSP_GRAB_TypeDef *hgrab);
+static void              GRAB_Halt(BSP_GRAB_TypeDef *hgrab);
+static uint32_t          GRAB_LineCplt(BSP_GRAB_TypeDef *hgrab, uint32_t Slot);
+static void              GRAB_DMAM0Cplt(DMA_HandleTypeDef *hdma);
+static void              GRAB_DMAM1Cplt(DMA_HandleTypeDef *hdma);
+static void              GRAB_DMASoftCplt(DMA_HandleTypeDef *hdma);
+static void              GRAB_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_GRAB_Exported_Functions BSP GRAB Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_GRAB_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Give the SPI, the line ring and the pixel clock to the grabber
+      (+) Start and stop the capture
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a grabber.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  hspi SPI handle, initialized with 8-bit data, DMA linked to hdmarx
+  *         in normal mode.
+  * @param  Sync Line sync, a value of @ref BSP_GRAB_Sync.
+  * @param  pLines Array of LineCount line headers.
+  * @param  pStorage Storage of LineCount x LineSize bytes.
+  * @param  LineCount Lines in the ring, 3 to BSP_GRAB_LINES_MAX.
+  * @param  LineSize Bytes per line, 1 to 0xFFFF.
+  * @param  LinesPerFrame Lines of a frame, 0 for frames ended by
+  *         BSP_GRAB_FrameHandler() only.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_GRAB_Init(BSP_GRAB_TypeDef *hgrab, SPI_HandleTypeDef *hspi, uint32_t Sync,
+                                BSP_GRAB_LineTypeDef *pLines, uint8_t *pStorage, uint32_t LineCount,
+                                uint32_t LineSize, uint32_t LinesPerFrame)
+{
+  uint32_t i;
+
+  if ((hgrab == NULL) || (hspi == NULL) || (hspi->hdmarx == NULL) ||
+      (GRAB_GetIndex(hspi->Instance) >= GRAB_INSTANCES) ||
+      (hspi->Init.DataSize != SPI_DATASIZE_8BIT) || (hspi->hdmarx->Init.Mode != DMA_NORMAL) ||
+      ((Sync != BSP_GRAB_SYNC_NSS) && (Sync != BSP_GRAB_SYNC_SOFT)) ||
+      ((Sync == BSP_GRAB_SYNC_NSS) &&
+       ((hspi->Init.Mode != SPI_MODE_SLAVE) || (hspi->Init.NSS != SPI_NSS_HARD_INPUT))) ||
+      (pLines == NULL) || (pStorage == NULL) ||
+      (LineCount < 3U) || (LineCount > BSP_GRAB_LINES_MAX) ||
+      (LineSize == 0U) || (LineSize > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hgrab->State == BSP_GRAB_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hgrab->hspi          = hspi;
+  hgrab->htim          = NULL;
+  hgrab->Channel       = 0U;
+  hgrab->Sync          = Sync;
+  hgrab->pLines        = pLines;
+  hgrab->LineCount     = LineCount;
+  hgrab->LineSize      = LineSize;
+  hgrab->LinesPerFrame = LinesPerFrame;
+  for (i = 0U; i < LineCount; i++)
+  {
+    pLines[i].pData     = &pStorage[i * LineSize];
+    pLines[i].Frame     = 0U;
+    pLines[i].Line      = 0U;
+    pLines[i].Timestamp = 0U;
+  }
+
+  HAL_EnableCycleCounter();
+
+  hgrab->State = BSP_GRAB_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give the timer channel generating the pixel clock.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  htim Timer handle, PWM channel configured at the pixel rate, NULL
+  *         for none.
+  * @param  Channel PWM channel, TIM_CHANNEL_1 to TIM_CHANNEL_4.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_GRAB_SetPixelClock(BSP_GRAB_TypeDef *hgrab, TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+  if ((hgrab == NULL) || (hgrab->State == BSP_GRAB_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+  if (hgrab->State == BSP_GRAB_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hgrab->htim    = htim;
+  hgrab->Channel = Channel;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the capture, all the lines back in the ring.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_GRAB_Start(BSP_GRAB_TypeDef *hgrab)
+{
+  DMA_HandleTypeDef *hdma = hgrab->hspi->hdmarx;
+  uint32_t first = (hgrab->Sync == BSP_GRAB_SYNC_NSS) ? 2U : 1U;
+  uint32_t i;
+
+  if ((hgrab->State != BSP_GRAB_STATE_READY) && (hgrab->State != BSP_GRAB_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  /* Lines 0 and 1 to the DMA, line 0 only for a soft sync, the others free */
+  for (i = first; i < hgrab->LineCount; i++)
+  {
+    hgrab->Free[i - first] = (uint8_t)i;
+  }
+  hgrab->FreeTail  = 0U;
+  hgrab->FreeHead  = hgrab->LineCount - first;
+  hgrab->ReadyTail = 0U;
+  hgrab->ReadyHead = 0U;
+  hgrab->Overruns  = 0U;
+  hgrab->Resyncs   = 0U;
+  hgrab->Slots[0]  = 0U;
+  hgrab->Slots[1]  = 1U;
+  hgrab->Frame     = 0U;
+  hgrab->Line      = 0U;
+
+  GRAB_Handles[GRAB_GetIndex(hgrab->hspi->Instance)] = hgrab;
+  hdma->XferCpltCallback     = (hgrab->Sync == BSP_GRAB_SYNC_NSS) ? GRAB_DMAM0Cplt : GRAB_DMASoftCplt;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferM1CpltCallback   = GRAB_DMAM1Cplt;
+  hdma->XferErrorCallback    = GRAB_DMAError;
+  hgrab->hspi->State         = HAL_SPI_STATE_BUSY_RX;
+
+  GRAB_Reset(hgrab);
+  if ((hgrab->Sync == BSP_GRAB_SYNC_NSS) && (GRAB_Arm(hgrab) != HAL_OK))
+  {
+    hgrab->hspi->State = HAL_SPI_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  hgrab->State = BSP_GRAB_STATE_RUN;
+  if ((hgrab->htim != NULL) && (HAL_TIM_PWM_Start(hgrab->htim, hgrab->Channel) != HAL_OK))
+  {
+    GRAB_Halt(hgrab);
+    hgrab->State = BSP_GRAB_STATE_READY;
+    hgrab->hspi->State = HAL_SPI_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the capture, the lines being written are dropped.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_GRAB_Stop(BSP_GRAB_TypeDef *hgrab)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if ((hgrab->State != BSP_GRAB_STATE_RUN) && (hgrab->State != BSP_GRAB_STATE_ERROR))
+  {
+    return HAL_ERROR;
+  }
+
+  hgrab->State = BSP_GRAB_STATE_READY;
+  if ((hgrab->htim != NULL) && (HAL_TIM_PWM_Stop(hgrab->htim, hgrab->Channel) != HAL_OK))
+  {
+    status = HAL_ERROR;
+  }
+  GRAB_Halt(hgrab);
+  hgrab->hspi->State = HAL_SPI_STATE_READY;
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_GRAB_Exported_Functions_Group2 Capture functions
+  * @brief    Capture functions
+  *
+@verbatim
+ ===============================================================================
+                       ##### Capture functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Start a line or a frame on the sync of the sensor
+      (+) Take the full lines and give them back
+      (+) Be notified of the end of each line and frame
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start a line, called from the EXTI or timer callback of the line
+  *         sync with BSP_GRAB_SYNC_SOFT.
+  * @note   A line still running is cut short: it is written again from its
+  *         start and counted in Resyncs.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval None
+  */
+void BSP_GRAB_SyncHandler(BSP_GRAB_TypeDef *hgrab)
+{
+  SPI_HandleTypeDef *hspi = hgrab->hspi;
+  BSP_GRAB_LineTypeDef *line;
+
+  if ((hgrab->State != BSP_GRAB_STATE_RUN) || (hgrab->Sync != BSP_GRAB_SYNC_SOFT))
+  {
+    return;
+  }
+
+  if (hspi->hdmarx->State == HAL_DMA_STATE_BUSY)
+  {
+    (void)HAL_DMA_Abort(hspi->hdmarx);
+    hgrab->Resyncs++;
+  }
+  GRAB_Reset(hgrab);
+
+  line = &hgrab->pLines[hgrab->Slots[0]];
+  line->Timestamp = DWT->CYCCNT;
+  if (HAL_DMA_Start_IT(hspi->hdmarx, (uint32_t)&hspi->Instance->DR, (uint32_t)line->pData,
+                       hgrab->LineSize) != HAL_OK)
+  {
+    GRAB_DMAError(hspi->hdmarx);
+    return;
+  }
+
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+  SET_BIT(hspi->Instance->CR1, SPI_CR1_SPE);
+  if ((hspi->Init.Mode == SPI_MODE_SLAVE) && (hspi->Init.NSS == SPI_NSS_SOFT))
+  {
+    CLEAR_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+  }
+}
+
+/**
+  * @brief  Start a frame, called from the EXTI callback of the frame sync.
+  * @note   The next line completed is line 0 of a new frame. Without
+  *         LinesPerFrame the frame of the previous lines is complete,
+  *         otherwise a frame short of lines is counted in Resyncs. With
+  *         BSP_GRAB_SYNC_NSS a line cut short restarts the DMA.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval None
+  */
+void BSP_GRAB_FrameHandler(BSP_GRAB_TypeDef *hgrab)
+{
+  DMA_HandleTypeDef *hdma = hgrab->hspi->hdmarx;
+  uint32_t frame = hgrab->Frame;
+
+  if (hgrab->State != BSP_GRAB_STATE_RUN)
+  {
+    return;
+  }
+
+  if ((hgrab->Sync == BSP_GRAB_SYNC_NSS) && (__HAL_DMA_GET_COUNTER(hdma) != hgrab->LineSize))
+  {
+    /* Bytes of a line cut short in the DMA: written again from the start */
+    GRAB_Halt(hgrab);
+    GRAB_Reset(hgrab);
+    if (GRAB_Arm(hgrab) != HAL_OK)
+    {
+      GRAB_DMAError(hdma);
+      return;
+    }
+    hgrab->Resyncs++;
+  }
+
+  if (hgrab->Line != 0U)
+  {
+    hgrab->Frame = frame + 1U;
+    hgrab->Line  = 0U;
+    if (hgrab->LinesPerFrame == 0U)
+    {
+      BSP_GRAB_FrameCpltCallback(hgrab, frame);
+    }
+    else
+    {
+      hgrab->Resyncs++;
+    }
+  }
+}
+
+/**
+  * @brief  Take the oldest full line.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval Line, owned by the caller until BSP_GRAB_Release(), NULL when
+  *         none is full
+  */
+BSP_GRAB_LineTypeDef *BSP_GRAB_Get(BSP_GRAB_TypeDef *hgrab)
+{
+  uint32_t tail = hgrab->ReadyTail;
+  uint32_t index;
+
+  if (tail == hgrab->ReadyHead)
+  {
+    return NULL;
+  }
+
+  index = hgrab->Ready[tail & GRAB_MASK];
+  hgrab->ReadyTail = tail + 1U;
+
+  return &hgrab->pLines[index];
+}
+
+/**
+  * @brief  Give a line back to the ring.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  pLine Line returned by BSP_GRAB_Get().
+  * @retval None
+  */
+void BSP_GRAB_Release(BSP_GRAB_TypeDef *hgrab, BSP_GRAB_LineTypeDef *pLine)
+{
+  uint32_t head = hgrab->FreeHead;
+
+  hgrab->Free[head & GRAB_MASK] = (uint8_t)(pLine - hgrab->pLines);
+  __DMB();
+  hgrab->FreeHead = head + 1U;
+}
+
+/**
+  * @brief  Line complete callback, a full line is waiting for BSP_GRAB_Get().
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  pLine Line queued, still to be taken with BSP_GRAB_Get().
+  * @retval None
+  */
+__weak void BSP_GRAB_LineCpltCallback(BSP_GRAB_TypeDef *hgrab, BSP_GRAB_LineTypeDef *pLine)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hgrab);
+  UNUSED(pLine);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_GRAB_LineCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Frame complete callback, the last line of the frame is queued.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  Frame Frame completed.
+  * @retval None
+  */
+__weak void BSP_GRAB_FrameCpltCallback(BSP_GRAB_TypeDef *hgrab, uint32_t Frame)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hgrab);
+  UNUSED(Frame);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_GRAB_FrameCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_GRAB_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the capture slot of a SPI.
+  * @param  Instance SPI instance.
+  * @retval Index, GRAB_INSTANCES for an unknown instance
+  */
+static uint32_t GRAB_GetIndex(const SPI_TypeDef *Instance)
+{
+  if (Instance == SPI1)
+  {
+    return 0U;
+  }
+  if (Instance == SPI2)
+  {
+    return 1U;
+  }
+  if (Instance == SPI3)
+  {
+    return 2U;
+  }
+
+  return GRAB_INSTANCES;
+}
+
+/**
+  * @brief  Get the grabber of a DMA callback.
+  * @param  hdma DMA handle, linked to the hdmarx of the SPI.
+  * @retval Grabber
+  */
+static BSP_GRAB_TypeDef *GRAB_GetHandle(const DMA_HandleTypeDef *hdma)
+{
+  return GRAB_Handles[GRAB_GetIndex(((const SPI_HandleTypeDef *)hdma->Parent)->Instance)];
+}
+
+/**
+  * @brief  Reset the SPI to drop the content of its FIFO.
+  * @note   The configuration is restored disabled, without the DMA requests.
+  *         A slave with SPI_NSS_SOFT is left deselected.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval None
+  */
+static void GRAB_Reset(const BSP_GRAB_TypeDef *hgrab)
+{
+  SPI_TypeDef *spi = hgrab->hspi->Instance;
+  uint32_t cr1 = READ_REG(spi->CR1) & ~SPI_CR1_SPE;
+  uint32_t cr2 = READ_REG(spi->CR2) & ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+
+  if ((hgrab->hspi->Init.Mode == SPI_MODE_SLAVE) && (hgrab->hspi->Init.NSS == SPI_NSS_SOFT))
+  {
+    cr1 |= SPI_CR1_SSI;
+  }
+
+  if (spi == SPI1)
+  {
+    __HAL_RCC_SPI1_FORCE_RESET();
+    __HAL_RCC_SPI1_RELEASE_RESET();
+  }
+  else if (spi == SPI2)
+  {
+    __HAL_RCC_SPI2_FORCE_RESET();
+    __HAL_RCC_SPI2_RELEASE_RESET();
+  }
+  else
+  {
+    __HAL_RCC_SPI3_FORCE_RESET();
+    __HAL_RCC_SPI3_RELEASE_RESET();
+  }
+
+  WRITE_REG(spi->CR2, cr2);
+  WRITE_REG(spi->CR1, cr1);
+}
+
+/**
+  * @brief  Start the DMA in double buffer mode on the lines of the slots and
+  *         enable the SPI, BSP_GRAB_SYNC_NSS.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef GRAB_Arm(BSP_GRAB_TypeDef *hgrab)
+{
+  SPI_HandleTypeDef *hspi = hgrab->hspi;
+
+  if (HAL_DMAEx_MultiBufferStart_IT(hspi->hdmarx, (uint32_t)&hspi->Instance->DR,
+                                    (uint32_t)hgrab->pLines[hgrab->Slots[0]].pData, hgrab->LineSize,
+                                    (uint32_t)hgrab->pLines[hgrab->Slots[1]].pData, hgrab->LineSize) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  hgrab->pLines[hgrab->Slots[0]].Timestamp = DWT->CYCCNT;
+
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+  SET_BIT(hspi->Instance->CR1, SPI_CR1_SPE);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the SPI and its Rx DMA.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @retval None
+  */
+static void GRAB_Halt(BSP_GRAB_TypeDef *hgrab)
+{
+  SPI_HandleTypeDef *hspi = hgrab->hspi;
+
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+  __HAL_SPI_DISABLE(hspi);
+  (void)HAL_DMA_Abort(hspi->hdmarx);
+}
+
+/**
+  * @brief  Queue a full line and give its slot the next free one.
+  * @param  hgrab Pointer to a BSP_GRAB_TypeDef structure.
+  * @param  Slot Slot the line was written from, 0 or 1.
+  * @retval Line now in the slot, the full one when it was dropped
+  */
+static uint32_t GRAB_LineCplt(BSP_GRAB_TypeDef *hgrab, uint32_t Slot)
+{
+  uint32_t full = hgrab->Slots[Slot];
+  uint32_t tail = hgrab->FreeTail;
+  uint32_t next = full;
+  uint32_t frame = hgrab->Frame;
+  uint32_t head;
+
+  if (tail != hgrab->FreeHead)
+  {
+    next = hgrab->Free[tail & GRAB_MASK];
+    hgrab->FreeTail = tail + 1U;
+  }
+  hgrab->Slots[Slot] = (uint8_t)next;
+
+  hgrab->pLines[full].Frame = frame;
+  hgrab->pLines[full].Line  = hgrab->Line;
+  hgrab->Line++;
+  if ((hgrab->LinesPerFrame != 0U) && (hgrab->Line >= hgrab->LinesPerFrame))
+  {
+    hgrab->Frame = frame + 1U;
+    hgrab->Line  = 0U;
+  }
+
+  if (next == full)
+  {
+    /* No free line: the full one is written again */
+    hgrab->Overruns++;
+  }
+  else
+  {
+    head = hgrab->ReadyHead;
+    hgrab->Ready[head & GRAB_MASK] = (uint8_t)full;
+    __DMB();
+    hgrab->ReadyHead = head + 1U;
+
+    BSP_GRAB_LineCpltCallback(hgrab, &hgrab->pLines[full]);
+  }
+
+  if (hgrab->Frame != frame)
+  {
+    BSP_GRAB_FrameCpltCallback(hgrab, frame);
+  }
+
+  return next;
+}
+
+/**
+  * @brief  DMA memory 0 transfer complete callback, BSP_GRAB_SYNC_NSS.
+  * @note   The DMA already runs in the line of the other slot.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void GRAB_DMAM0Cplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_GRAB_TypeDef *hgrab = GRAB_GetHandle(hdma);
+  uint32_t full = hgrab->Slots[0];
+  uint32_t next;
+
+  hgrab->pLines[hgrab->Slots[1]].Timestamp = DWT->CYCCNT;
+  next = GRAB_LineCplt(hgrab, 0U);
+  if (next == full)
+  {
+    (void)HAL_DMAEx_ReleaseMemory(hdma, MEMORY0);
+  }
+  else
+  {
+    (void)HAL_DMAEx_ChangeMemory(hdma, (uint32_t)hgrab->pLines[next].pData, hgrab->LineSize, MEMORY0);
+  }
+}
+
+/**
+  * @brief  DMA memory 1 transfer complete callback, BSP_GRAB_SYNC_NSS.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void GRAB_DMAM1Cplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_GRAB_TypeDef *hgrab = GRAB_GetHandle(hdma);
+  uint32_t full = hgrab->Slots[1];
+  uint32_t next;
+
+  hgrab->pLines[hgrab->Slots[0]].Timestamp = DWT->CYCCNT;
+  next = GRAB_LineCplt(hgrab, 1U);
+  if (next == full)
+  {
+    (void)HAL_DMAEx_ReleaseMemory(hdma, MEMORY1);
+  }
+  else
+  {
+    (void)HAL_DMAEx_ChangeMemory(hdma, (uint32_t)hgrab->pLines[next].pData, hgrab->LineSize, MEMORY1);
+  }
+}
+
+/**
+  * @brief  DMA transfer complete callback, BSP_GRAB_SYNC_SOFT: the SPI stops
+  *         until the next sync.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void GRAB_DMASoftCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_GRAB_TypeDef *hgrab = GRAB_GetHandle(hdma);
+  SPI_HandleTypeDef *hspi = hgrab->hspi;
+
+  if ((hspi->Init.Mode == SPI_MODE_SLAVE) && (hspi->Init.NSS == SPI_NSS_SOFT))
+  {
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+  }
+  __HAL_SPI_DISABLE(hspi);
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+
+  (void)GRAB_LineCplt(hgrab, 0U);
+}
+
+/**
+  * @brief  DMA error callback, the capture is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void GRAB_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_GRAB_TypeDef *hgrab = GRAB_GetHandle(hdma);
+
+  hgrab->State = BSP_GRAB_STATE_ERROR;
+  if (hgrab->htim != NULL)
+  {
+    (void)HAL_TIM_PWM_Stop(hgrab->htim, hgrab->Channel);
+  }
+  GRAB_Halt(hgrab);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
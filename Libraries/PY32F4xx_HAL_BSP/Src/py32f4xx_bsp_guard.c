@@ -0,0 +1,302 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_guard.c
+  * @author  MCU Application Team
+  * @brief   Memory guard BSP service.
+  *          This file provides traps on wrong accesses to the memory, made
+  *          with the DWT comparators in place of the MPU the device lacks:
+  *           + Null page, reads and writes through a null pointer
+  *           + Bottom of the main stack, written on an overflow
+  *           + SRAM above the data and the RAM functions, not executable
+  *           + One region of the application, a peripheral for instance
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The PY32F403 has no MPU: the four DWT comparators of the core watch
+       the regions instead, each a power of 2 bytes aligned on its size. A
+       hit raises the DebugMonitor exception right after the access, at no
+       cost for the code until then. Build with USE_GUARD=y, defining
+       USE_BSP_GUARD: this file then provides DebugMon_Handler(), the one of
+       py32f4xx_it.c being left out.
+
+   (#) Call BSP_GUARD_Init() in main(), after BSP_STACK_Init() which fills
+       the stack down to its bottom. The regions follow the linker script:
+       (++) BSP_GUARD_NULL: BSP_GUARD_NULL_SIZE bytes from address 0, the
+            alias of the boot memory, read or written only through a null
+            pointer, SystemInit() moving the vector table to the FLASH
+       (++) BSP_GUARD_STACK: BSP_GUARD_STACK_SIZE bytes from _sstack, the
+            bottom of the main stack, written only by an overflow
+       (++) BSP_GUARD_SRAM_XN: the largest block ending at _estack and
+            above _edata, the bss, heap and stack, executed only after a
+            return address is overwritten. The __RAM_FUNC functions are in
+            the .data below and run as usual
+       BSP_GUARD_Init() returns HAL_ERROR when the core has fewer comparators.
+
+   (#) BSP_GUARD_Watch() sets a region, the BSP_GUARD_USER one or a preset
+       replaced, to an address, a size and a BSP_GUARD_ACCESS_xxx access:
+       the registers of a peripheral only one driver writes, a DMA buffer
+       while the DMA owns it, the FLASH away from the storage services.
+       BSP_GUARD_Disable() frees a region. The DMA itself is not watched,
+       only the accesses of the core.
+
+   (#) On a hit BSP_GUARD_Callback() gets the region and the PC stacked by
+       the exception, the instruction after the access or a few after. The
+       weak one records it with BSP_FAULT_Reset(), BSP_FAULT_TYPE_STACK for
+       the stack and BSP_FAULT_TYPE_GUARD otherwise, the PC as Info, and
+       resets. An application one may log and return instead, the code then
+       goes on after the data access; it must not return on an execution.
+
+   (#) With a debugger attached the core halts on the hit instead, and the
+       debugger may take the comparators for its own watchpoints. The
+       handlers of a priority above the DebugMonitor, the HardFault and the
+       NMI, are not watched.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_guard.h"
+#include "py32f4xx_bsp_fault.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_GUARD BSP GUARD
+  * @brief Memory guard BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Private_Types BSP GUARD Private Types
+  * @{
+  */
+
+/**
+  * @brief  Registers of a DWT comparator, repeated every 16 bytes from DWT COMP0
+  */
+typedef struct
+{
+  __IOM uint32_t COMP;
+  __IOM uint32_t MASK;
+  __IOM uint32_t FUNCTION;
+        uint32_t RESERVED;
+} GUARD_ComparatorTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Private_Constants BSP GUARD Private Constants
+  * @{
+  */
+#define GUARD_MASK_MAX            31U         /*!< Written to MASK, the largest supported is read back */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Private_Macros BSP GUARD Private Macros
+  * @{
+  */
+#define GUARD_COMPARATOR(__REGION__)  (&((GUARD_ComparatorTypeDef *)&DWT->COMP0)[(__REGION__)])
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Private_Variables BSP GUARD Private Variables
+  * @{
+  */
+extern uint32_t _edata[];   /* End of the data and of the RAM functions, from the linker script */
+extern uint32_t _sstack[];  /* Bottom of the main stack */
+extern uint32_t _estack[];  /* Top of the main stack, the end of the RAM */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_GUARD_Exported_Functions BSP GUARD Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Watch the null page, the bottom of the main stack and the SRAM not executable.
+  * @retval HAL_OK, HAL_ERROR if the DWT has fewer than BSP_GUARD_REGIONS comparators
+  */
+HAL_StatusTypeDef BSP_GUARD_Init(void)
+{
+  uint32_t base;
+  uint32_t size;
+
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  if (((DWT->CTRL & DWT_CTRL_NUMCOMP_Msk) >> DWT_CTRL_NUMCOMP_Pos) < BSP_GUARD_REGIONS)
+  {
+    return HAL_ERROR;
+  }
+
+  if (BSP_GUARD_Watch(BSP_GUARD_NULL, 0U, BSP_GUARD_NULL_SIZE, BSP_GUARD_ACCESS_READ_WRITE) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  base = ((uint32_t)_sstack + (BSP_GUARD_STACK_SIZE - 1U)) & ~(BSP_GUARD_STACK_SIZE - 1U);
+  if (BSP_GUARD_Watch(BSP_GUARD_STACK, base, BSP_GUARD_STACK_SIZE, BSP_GUARD_ACCESS_WRITE) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Largest block aligned on its size, ending at the end of the RAM and above the data */
+  size = 0x80000000UL >> __CLZ((uint32_t)_estack - (uint32_t)_edata);
+  while (((uint32_t)_estack & (size - 1U)) != 0U)
+  {
+    size >>= 1U;
+  }
+  while ((size > 32U) &&
+         (BSP_GUARD_Watch(BSP_GUARD_SRAM_XN, (uint32_t)_estack - size, size, BSP_GUARD_ACCESS_EXECUTE) != HAL_OK))
+  {
+    size >>= 1U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Watch a region of the memory.
+  * @param  Region Comparator, a value of @ref BSP_GUARD_Region.
+  * @param  Address Start of the region, aligned on Size.
+  * @param  Size Bytes of the region, a power of 2.
+  * @param  Access Access trapped, a value of @ref BSP_GUARD_Access.
+  * @retval HAL_OK, HAL_ERROR on a wrong parameter or a size the DWT cannot mask
+  */
+HAL_StatusTypeDef BSP_GUARD_Watch(uint32_t Region, uint32_t Address, uint32_t Size, uint32_t Access)
+{
+  GUARD_ComparatorTypeDef *comparator;
+  uint32_t mask;
+
+  if ((Region >= BSP_GUARD_REGIONS) || (Size == 0U) || ((Size & (Size - 1U)) != 0U) ||
+      ((Address & (Size - 1U)) != 0U) ||
+      (Access < BSP_GUARD_ACCESS_EXECUTE) || (Access > BSP_GUARD_ACCESS_READ_WRITE))
+  {
+    return HAL_ERROR;
+  }
+  mask = 31U - __CLZ(Size);
+
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk | DCB_DEMCR_MON_EN_Msk;
+  NVIC_SetPriority(DebugMonitor_IRQn, 0U);
+
+  comparator = GUARD_COMPARATOR(Region);
+  comparator->FUNCTION = 0U;
+  comparator->MASK = GUARD_MASK_MAX;
+  if (mask > comparator->MASK)
+  {
+    return HAL_ERROR;
+  }
+  comparator->COMP = Address;
+  comparator->MASK = mask;
+  (void)comparator->FUNCTION;
+  comparator->FUNCTION = Access;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop watching a region.
+  * @param  Region Comparator, a value of @ref BSP_GUARD_Region.
+  * @retval None
+  */
+void BSP_GUARD_Disable(uint32_t Region)
+{
+  if (Region < BSP_GUARD_REGIONS)
+  {
+    GUARD_COMPARATOR(Region)->FUNCTION = 0U;
+  }
+}
+
+/**
+  * @brief  Find the region hit and call BSP_GUARD_Callback(), called by the DebugMonitor handler.
+  * @param  pFrame Stack pointer of the exception, on the stacked frame.
+  * @retval None
+  */
+void BSP_GUARD_Capture(const uint32_t *pFrame)
+{
+  uint32_t region;
+
+  /* MATCHED is cleared by the read */
+  for (region = 0U; region < BSP_GUARD_REGIONS; region++)
+  {
+    if ((GUARD_COMPARATOR(region)->FUNCTION & DWT_FUNCTION_MATCHED_Msk) != 0U)
+    {
+      break;
+    }
+  }
+  SCB->DFSR = SCB_DFSR_DWTTRAP_Msk;
+
+  BSP_GUARD_Callback(region, pFrame[6]);
+}
+
+/**
+  * @brief  Region hit callback, records the hit and resets.
+  * @param  Region Comparator hit, a value of @ref BSP_GUARD_Region, BSP_GUARD_REGIONS for
+  *         another debug event, a BKPT instruction without debugger for instance.
+  * @param  Pc PC stacked by the exception, the instruction after the access or a few after.
+  * @retval None
+  */
+__weak void BSP_GUARD_Callback(uint32_t Region, uint32_t Pc)
+{
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_GUARD_Callback could be implemented in the user file
+   */
+  BSP_FAULT_Reset((Region == BSP_GUARD_STACK) ? BSP_FAULT_TYPE_STACK : BSP_FAULT_TYPE_GUARD, Pc);
+}
+
+/**
+  * @}
+  */
+
+#if defined (USE_BSP_GUARD)
+
+/**
+  * @brief  DebugMonitor handler: the frame passed to BSP_GUARD_Capture(), which returns to the code.
+  * @retval None
+  */
+__attribute__((naked)) void DebugMon_Handler(void)
+{
+  __ASM volatile
+  (
+    "tst      lr, #4                 \n"
+    "ite      eq                     \n"
+    "mrseq    r0, msp                \n"
+    "mrsne    r0, psp                \n"
+    "b        BSP_GUARD_Capture      \n"
+  );
+}
+
+#endif /* USE_BSP_GUARD */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
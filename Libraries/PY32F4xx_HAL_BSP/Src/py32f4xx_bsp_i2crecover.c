@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2crecover.c
+  * @author  MCU Application Team
+  * @brief   I2C bus recovery BSP service.
+  *          This file provides functions to release an I2C bus left stuck by
+  *          a device reset in the middle of a transfer:
+  *           + Bounded wait for the bus to get idle
+  *           + SCL pulses from the GPIO until the device releases SDA
+  *           + Stop condition and reset of the I2C
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the I2C with HAL_I2C_Init() as a master, its SCL and SDA
+       pins in GPIO_MODE_AF_OD. Call BSP_I2CRECOVER_Init() with the I2C and
+       its pins.
+
+   (#) A device reset while it drives SDA low, by a brown-out or a debugger,
+       keeps driving it until it has clocked out the rest of its byte. The
+       I2C then sees a bus busy forever and every transfer fails after the
+       busy timeout of the HAL.
+
+   (#) Call BSP_I2CRECOVER_Check() before a transfer, or after a transfer
+       failed on a bus error, an arbitration loss or a timeout. It waits at
+       most BSP_I2CRECOVER_IDLE_BITS bit times for the bus busy flag to clear
+       and else runs BSP_I2CRECOVER_Recover().
+
+   (#) BSP_I2CRECOVER_Recover() stops the transfer of the I2C and its DMA,
+       then with the pins switched to GPIO output open drain:
+       (+) Pulses SCL at BSP_I2CRECOVER_PULSE_FREQ until SDA reads high, at
+           most BSP_I2CRECOVER_PULSES times. A device stretching SCL low is
+           given BSP_I2CRECOVER_STRETCH_MAX half periods per pulse.
+       (+) Generates a stop condition, which resets the device state machine.
+       (+) Switches the pins back to their alternate function, resets the I2C
+           with CR1 SWRST and applies its Init structure again, without
+           HAL_I2C_MspInit().
+       The whole sequence lasts less than 1 ms at the default settings, it
+       returns HAL_ERROR when a line is still low at its end. Call it from a
+       context at a priority not lower than the I2C and DMA interrupts.
+
+   (#) The transfer that failed is not started again: the BSP_I2CSCHED
+       scheduler does it when given the handle with BSP_I2CSCHED_SetRecovery().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_i2crecover.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_I2CRECOVER BSP I2CRECOVER
+  * @brief I2C bus recovery BSP service
+  * @{
+  */
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_I2CRECOVER_Private_Constants BSP I2CRECOVER Private Constants
+  * @{
+  */
+#define I2CRECOVER_MODE_OUTPUT          0x1U           /* MODER value of a general purpose output */
+#define I2CRECOVER_MODE_AF              0x2U           /* MODER value of an alternate function    */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_I2CRECOVER_Private_Functions
+  * @{
+  */
+static void I2CRECOVER_SetMode(GPIO_TypeDef *Port, uint32_t Pin, uint32_t Mode);
+static void I2CRECOVER_Delay(uint32_t Cycles);
+static uint32_t I2CRECOVER_ReleaseScl(const BSP_I2CRECOVER_TypeDef *hrecover);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_I2CRECOVER_Exported_Functions BSP I2CRECOVER Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_I2CRECOVER_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind the recovery to an I2C and its pins
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the recovery of an I2C bus.
+  * @note   The timings are computed from the current HCLK frequency and the
+  *         ClockSpeed of the I2C, call it again after a clock change.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure.
+  * @param  hi2c Pointer to an I2C_HandleTypeDef structure initialized as a master.
+  * @param  SclPort GPIO port of SCL.
+  * @param  SclPin GPIO pin of SCL, a single GPIO_PIN_x.
+  * @param  SdaPort GPIO port of SDA.
+  * @param  SdaPin GPIO pin of SDA, a single GPIO_PIN_x.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2CRECOVER_Init(BSP_I2CRECOVER_TypeDef *hrecover, I2C_HandleTypeDef *hi2c,
+                                      GPIO_TypeDef *SclPort, uint32_t SclPin,
+                                      GPIO_TypeDef *SdaPort, uint32_t SdaPin)
+{
+  uint32_t hclk;
+
+  if ((hrecover == NULL) || (hi2c == NULL) || (hi2c->Init.ClockSpeed == 0U) ||
+      (SclPort == NULL) || (SdaPort == NULL) ||
+      (SclPin == 0U) || ((SclPin & (SclPin - 1U)) != 0U) || (SclPin > GPIO_PIN_15) ||
+      (SdaPin == 0U) || ((SdaPin & (SdaPin - 1U)) != 0U) || (SdaPin > GPIO_PIN_15))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  hclk = HAL_RCC_GetHCLKFreq();
+
+  hrecover->SclPort    = SclPort;
+  hrecover->SclPin     = SclPin;
+  hrecover->SdaPort    = SdaPort;
+  hrecover->SdaPin     = SdaPin;
+  hrecover->HalfPeriod = hclk / (2U * BSP_I2CRECOVER_PULSE_FREQ);
+  hrecover->IdleWait   = (hclk / hi2c->Init.ClockSpeed) * BSP_I2CRECOVER_IDLE_BITS;
+  hrecover->RunCount   = 0U;
+  hrecover->FailCount  = 0U;
+  hrecover->hi2c       = hi2c;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_I2CRECOVER_Exported_Functions_Group2 Recovery functions
+  * @brief    Recovery functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Recovery functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Wait for the bus to get idle, recovering it when it does not
+      (+) Recover the bus unconditionally
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Wait for the bus to get idle and recover it when it does not.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure.
+  * @retval HAL status, HAL_ERROR when the bus stays stuck
+  */
+HAL_StatusTypeDef BSP_I2CRECOVER_Check(BSP_I2CRECOVER_TypeDef *hrecover)
+{
+  uint32_t start;
+
+  if (hrecover->hi2c == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  start = DWT->CYCCNT;
+  while (__HAL_I2C_GET_FLAG(hrecover->hi2c, I2C_FLAG_BUSY) != RESET)
+  {
+    if ((DWT->CYCCNT - start) > hrecover->IdleWait)
+    {
+      return BSP_I2CRECOVER_Recover(hrecover);
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Release the bus with SCL pulses and a stop condition, then reset the I2C.
+  * @note   The transfer in progress is dropped without callback and the I2C
+  *         is left in HAL_I2C_STATE_READY.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure.
+  * @retval HAL status, HAL_ERROR when SCL or SDA is still low
+  */
+HAL_StatusTypeDef BSP_I2CRECOVER_Recover(BSP_I2CRECOVER_TypeDef *hrecover)
+{
+  I2C_HandleTypeDef *hi2c = hrecover->hi2c;
+  HAL_StatusTypeDef status;
+  uint32_t released;
+  uint32_t pulse;
+
+  if (hi2c == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Stop the hung transfer */
+  CLEAR_BIT(hi2c->Instance->CR2, (I2C_CR2_DMAEN | I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN));
+  if (hi2c->hdmatx != NULL)
+  {
+    (void)HAL_DMA_Abort(hi2c->hdmatx);
+  }
+  if (hi2c->hdmarx != NULL)
+  {
+    (void)HAL_DMA_Abort(hi2c->hdmarx);
+  }
+  __HAL_I2C_DISABLE(hi2c);
+
+  /* Both lines released, then driven by the GPIO */
+  hrecover->SclPort->BSRR = hrecover->SclPin;
+  hrecover->SdaPort->BSRR = hrecover->SdaPin;
+  I2CRECOVER_SetMode(hrecover->SclPort, hrecover->SclPin, I2CRECOVER_MODE_OUTPUT);
+  I2CRECOVER_SetMode(hrecover->SdaPort, hrecover->SdaPin, I2CRECOVER_MODE_OUTPUT);
+  I2CRECOVER_Delay(hrecover->HalfPeriod);
+
+  /* Clock out the rest of the byte the device is sending */
+  for (pulse = 0U; pulse < BSP_I2CRECOVER_PULSES; pulse++)
+  {
+    if ((hrecover->SdaPort->IDR & hrecover->SdaPin) != 0U)
+    {
+      break;
+    }
+    hrecover->SclPort->BRR = hrecover->SclPin;
+    I2CRECOVER_Delay(hrecover->HalfPeriod);
+    (void)I2CRECOVER_ReleaseScl(hrecover);
+    I2CRECOVER_Delay(hrecover->HalfPeriod);
+  }
+
+  /* Stop condition: SDA rising while SCL is high */
+  hrecover->SclPort->BRR = hrecover->SclPin;
+  I2CRECOVER_Delay(hrecover->HalfPeriod);
+  hrecover->SdaPort->BRR = hrecover->SdaPin;
+  I2CRECOVER_Delay(hrecover->HalfPeriod);
+  released = I2CRECOVER_ReleaseScl(hrecover);
+  I2CRECOVER_Delay(hrecover->HalfPeriod);
+  hrecover->SdaPort->BSRR = hrecover->SdaPin;
+  I2CRECOVER_Delay(hrecover->HalfPeriod);
+  if ((hrecover->SdaPort->IDR & hrecover->SdaPin) == 0U)
+  {
+    released = 0U;
+  }
+
+  I2CRECOVER_SetMode(hrecover->SclPort, hrecover->SclPin, I2CRECOVER_MODE_AF);
+  I2CRECOVER_SetMode(hrecover->SdaPort, hrecover->SdaPin, I2CRECOVER_MODE_AF);
+
+  /* Clear a busy flag latched while the pins were not on the I2C */
+  SET_BIT(hi2c->Instance->CR1, I2C_CR1_SWRST);
+  CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_SWRST);
+
+  /* A state other than reset keeps HAL_I2C_Init() from calling the MSP */
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->Lock  = HAL_UNLOCKED;
+  status = HAL_I2C_Init(hi2c);
+
+  hrecover->RunCount++;
+  if (released == 0U)
+  {
+    hrecover->FailCount++;
+    return HAL_ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CRECOVER_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Switch a pin between general purpose output and alternate function.
+  * @note   The output type, pull and alternate function set by the MSP are kept.
+  * @param  Port GPIO port.
+  * @param  Pin Single GPIO_PIN_x.
+  * @param  Mode I2CRECOVER_MODE_OUTPUT or I2CRECOVER_MODE_AF.
+  * @retval None
+  */
+static void I2CRECOVER_SetMode(GPIO_TypeDef *Port, uint32_t Pin, uint32_t Mode)
+{
+  /* Pin squared puts its bit at the position of its 2-bit MODER field */
+  MODIFY_REG(Port->MODER, (Pin * Pin) * GPIO_MODER_MODE0, (Pin * Pin) * Mode);
+}
+
+/**
+  * @brief  Busy wait on the DWT cycle counter.
+  * @param  Cycles CPU cycles.
+  * @retval None
+  */
+static void I2CRECOVER_Delay(uint32_t Cycles)
+{
+  uint32_t start = DWT->CYCCNT;
+
+  while ((DWT->CYCCNT - start) < Cycles)
+  {
+  }
+}
+
+/**
+  * @brief  Release SCL and wait for a stretching device to release it too.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure.
+  * @retval 1 when SCL reads high, 0 when it is still held low
+  */
+static uint32_t I2CRECOVER_ReleaseScl(const BSP_I2CRECOVER_TypeDef *hrecover)
+{
+  uint32_t start;
+
+  hrecover->SclPort->BSRR = hrecover->SclPin;
+
+  start = DWT->CYCCNT;
+  while ((hrecover->SclPort->IDR & hrecover->SclPin) == 0U)
+  {
+    if ((DWT->CYCCNT - start) > (hrecover->HalfPeriod * BSP_I2CRECOVER_STRETCH_MAX))
+    {
+      return 0U;
+    }
+  }
+
+  return 1U;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,855 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2csched.c
+  * @author  MCU Application Team
+  * @brief   I2C job scheduler BSP service.
+  *          This file provides functions to poll a set of I2C devices without
+  *          main loop involvement:
+  *           + Static table of register read jobs with a period each
+  *           + Jobs issued back to back from the completion interrupts
+  *           + Retry of the not acknowledged reads and cycle end event
+  *           + Optional recovery of a stuck bus before the retry
+  *           + Queue of one shot register writes run between the cycles
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the I2C with HAL_I2C_Init() as a master, link a DMA channel
+       in DMA_NORMAL mode with byte data to its hdmarx and enable the I2C event,
+       I2C error and DMA channel interrupts in the NVIC.
+
+   (#) Declare the job table, one BSP_I2CSCHED_JobTypeDef per register block:
+       device address, first register, register address size, length,
+       destination buffer and period in ticks. Call BSP_I2CSCHED_Init() with
+       the table and the number of retries of a failed read. The scheduler
+       then owns the I2C.
+
+   (#) From HAL_I2C_MemRxCpltCallback() call BSP_I2CSCHED_XferCpltHandler() and
+       from HAL_I2C_ErrorCallback() call BSP_I2CSCHED_ErrorHandler() when the
+       handle is the scheduler one.
+
+   (#) Call BSP_I2CSCHED_Tick() at the polling rate, for instance from a timer
+       update interrupt at 1 kHz, at a priority not higher than the I2C ones:
+       (+) The Countdown of each enabled job is decremented, the jobs reaching
+           0 are due for this cycle and reloaded with their Period.
+       (+) The first due job is started with HAL_I2C_Mem_Read_DMA(), every
+           following one from the completion interrupt of the previous one.
+       (+) A read not acknowledged or failing on the bus is started again up
+           to Retries times, then its Status records the error and the next
+           job is started.
+       (+) After the last due job BSP_I2CSCHED_CycleCpltCallback() is called
+           with the number of failed jobs of the cycle.
+       (+) A tick arriving while a cycle still runs is counted in OverrunCount
+           and skipped, the periods are then too short for the bus speed.
+
+   (#) The pData of a job is written by the DMA while its Status is
+       BSP_I2CSCHED_STATUS_DUE, read it from the cycle callback or check the
+       Status first.
+
+   (#) Writes, for instance a display flush, share the bus with the jobs:
+       (+) Link a DMA channel in DMA_NORMAL mode with byte data to the hdmatx
+           of the I2C and call HAL_I2C_MemTxCpltCallback() as the Rx one.
+       (+) Fill a BSP_I2CSCHED_WriteTypeDef and queue it with
+           BSP_I2CSCHED_Write(), it runs with HAL_I2C_Mem_Write_DMA() at once
+           when the bus is free, otherwise after the write queue or the cycle
+           running. pData is read by the DMA until the write ends.
+       (+) The reads come first: a tick arriving during a write starts its
+           cycle when the write ends, the queued writes follow the cycle. Keep
+           the writes short next to the tick period, for instance 32 bytes
+           take 0.8 ms at 400 kHz.
+       (+) BSP_I2CSCHED_WriteCpltCallback() is called at the end of each write
+           with its Status, a next write may be queued from it.
+       (+) A scheduler with no job only runs writes, JobCount is then 0 and
+           no hdmarx is needed.
+
+   (#) Optionally give a BSP_I2CRECOVER handle of the same I2C with
+       BSP_I2CSCHED_SetRecovery(), the bus is then recovered in bounded time
+       instead of failing every read until reset:
+       (+) Before each read or write BSP_I2CRECOVER_Check() waits for the bus to get
+           idle and recovers it when it does not.
+       (+) A read ending on a bus error, an arbitration loss or a timeout is
+           followed by BSP_I2CRECOVER_Recover() before its retry.
+       (+) A read still on the bus after BSP_I2CSCHED_STALL_TICKS ticks, a
+           device holding SCL low or a lost interrupt, is dropped, the bus is
+           recovered and the read goes through the retries.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_i2csched.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_I2CSCHED BSP I2CSCHED
+  * @brief I2C job scheduler BSP service
+  * @{
+  */
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_I2CSCHED_Private_Functions
+  * @{
+  */
+static void I2CSCHED_Start(BSP_I2CSCHED_TypeDef *hsched, uint32_t Index);
+static void I2CSCHED_Next(BSP_I2CSCHED_TypeDef *hsched);
+static void I2CSCHED_Fail(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status);
+static void I2CSCHED_Stall(BSP_I2CSCHED_TypeDef *hsched);
+static void I2CSCHED_Resume(BSP_I2CSCHED_TypeDef *hsched);
+static void I2CSCHED_WriteStart(BSP_I2CSCHED_TypeDef *hsched);
+static void I2CSCHED_WriteEnd(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status);
+static void I2CSCHED_WriteFail(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_I2CSCHED_Exported_Functions BSP I2CSCHED Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_I2CSCHED_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Take and give back the I2C of the scheduler
+      (+) Attach a bus recovery
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a scheduler on an I2C.
+  * @note   Every enabled job is due at the first tick.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  hi2c Pointer to an I2C_HandleTypeDef structure initialized as a
+  *              master, hdmarx in DMA_NORMAL mode must be linked when there
+  *              are jobs.
+  * @param  pJobs Job table, NULL when JobCount is 0.
+  * @param  JobCount Number of jobs in the table, 0 for writes only.
+  * @param  Retries Extra attempts of a failed read.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2CSCHED_Init(BSP_I2CSCHED_TypeDef *hsched, I2C_HandleTypeDef *hi2c,
+                                    BSP_I2CSCHED_JobTypeDef *pJobs, uint32_t JobCount, uint32_t Retries)
+{
+  uint32_t index;
+
+  if ((hsched == NULL) || (hi2c == NULL) ||
+      ((JobCount != 0U) && ((hi2c->hdmarx == NULL) || (pJobs == NULL))))
+  {
+    return HAL_ERROR;
+  }
+  for (index = 0U; index < JobCount; index++)
+  {
+    if ((pJobs[index].pData == NULL) || (pJobs[index].Size == 0U) ||
+        ((pJobs[index].MemAddSize != I2C_MEMADD_SIZE_8BIT) && (pJobs[index].MemAddSize != I2C_MEMADD_SIZE_16BIT)))
+    {
+      return HAL_ERROR;
+    }
+  }
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  for (index = 0U; index < JobCount; index++)
+  {
+    pJobs[index].Countdown  = 1U;
+    pJobs[index].Status     = BSP_I2CSCHED_STATUS_NONE;
+    pJobs[index].ErrorCount = 0U;
+  }
+
+  hsched->pJobs        = pJobs;
+  hsched->JobCount     = JobCount;
+  hsched->Retries      = Retries;
+  hsched->Current      = JobCount;
+  hsched->Attempt      = 0U;
+  hsched->CycleErrors  = 0U;
+  hsched->CycleCount   = 0U;
+  hsched->OverrunCount = 0U;
+  hsched->hrecover     = NULL;
+  hsched->StallCount   = 0U;
+  hsched->pWriteHead   = NULL;
+  hsched->pWriteTail   = NULL;
+  hsched->pWriting     = NULL;
+  hsched->CyclePending = JobCount;
+  hsched->WriteCount   = 0U;
+  hsched->hi2c         = hi2c;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop a scheduler and give the I2C back to the HAL.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval HAL status, HAL_BUSY while a cycle runs or writes are queued
+  */
+HAL_StatusTypeDef BSP_I2CSCHED_DeInit(BSP_I2CSCHED_TypeDef *hsched)
+{
+  uint32_t primask_bit;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if ((hsched == NULL) || (hsched->hi2c == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if ((hsched->Current != hsched->JobCount) || (hsched->pWriteHead != NULL))
+  {
+    status = HAL_BUSY;
+  }
+  else
+  {
+    hsched->hi2c = NULL;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return status;
+}
+
+/**
+  * @brief  Attach a bus recovery to a scheduler.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  hrecover Pointer to a BSP_I2CRECOVER_TypeDef structure initialized
+  *                  on the scheduler I2C, NULL to detach it.
+  * @retval HAL status, HAL_BUSY while a cycle runs or writes are queued
+  */
+HAL_StatusTypeDef BSP_I2CSCHED_SetRecovery(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CRECOVER_TypeDef *hrecover)
+{
+  uint32_t primask_bit;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if ((hsched == NULL) || (hsched->hi2c == NULL) || ((hrecover != NULL) && (hrecover->hi2c != hsched->hi2c)))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if ((hsched->Current != hsched->JobCount) || (hsched->pWriteHead != NULL))
+  {
+    status = HAL_BUSY;
+  }
+  else
+  {
+    hsched->hrecover = hrecover;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_I2CSCHED_Exported_Functions_Group2 Scheduling functions
+  * @brief    Scheduling functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Scheduling functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Start a cycle of the due jobs
+      (+) Chain the jobs from the I2C completion and error callbacks
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Count one tick and start a cycle with the jobs due.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+void BSP_I2CSCHED_Tick(BSP_I2CSCHED_TypeDef *hsched)
+{
+  BSP_I2CSCHED_JobTypeDef *pJob;
+  uint32_t primask_bit;
+  uint32_t index;
+  uint32_t first;
+
+  if (hsched->hi2c == NULL)
+  {
+    return;
+  }
+  if ((hsched->Current != hsched->JobCount) || (hsched->CyclePending != hsched->JobCount))
+  {
+    hsched->OverrunCount++;
+    I2CSCHED_Stall(hsched);
+    return;
+  }
+  if (hsched->pWriting != NULL)
+  {
+    I2CSCHED_Stall(hsched);
+  }
+
+  first = hsched->JobCount;
+  for (index = 0U; index < hsched->JobCount; index++)
+  {
+    pJob = &hsched->pJobs[index];
+    if (pJob->Period == 0U)
+    {
+      continue;
+    }
+    if (pJob->Countdown > 1U)
+    {
+      pJob->Countdown--;
+      continue;
+    }
+    pJob->Countdown = pJob->Period;
+    pJob->Status = BSP_I2CSCHED_STATUS_DUE;
+    if (first == hsched->JobCount)
+    {
+      first = index;
+    }
+  }
+
+  if (first != hsched->JobCount)
+  {
+    hsched->CycleErrors = 0U;
+
+    /* A write on the bus starts the cycle when it ends */
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    if (hsched->pWriting != NULL)
+    {
+      hsched->CyclePending = first;
+      first = hsched->JobCount;
+    }
+    else
+    {
+      hsched->Current = first;
+      hsched->Attempt = 0U;
+    }
+    __set_PRIMASK(primask_bit);
+
+    if (first != hsched->JobCount)
+    {
+      I2CSCHED_Start(hsched, first);
+    }
+  }
+}
+
+/**
+  * @brief  Check whether a cycle runs or writes are queued.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval 1 when no job nor write is on the bus or queued, 0 otherwise
+  */
+uint32_t BSP_I2CSCHED_IsIdle(const BSP_I2CSCHED_TypeDef *hsched)
+{
+  return ((hsched->Current == hsched->JobCount) && (hsched->pWriteHead == NULL)) ? 1U : 0U;
+}
+
+/**
+  * @brief  End the current job or write successfully and start the next one.
+  * @note   To be called from HAL_I2C_MemRxCpltCallback() and
+  *         HAL_I2C_MemTxCpltCallback().
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+void BSP_I2CSCHED_XferCpltHandler(BSP_I2CSCHED_TypeDef *hsched)
+{
+  if (hsched->hi2c == NULL)
+  {
+    return;
+  }
+  if (hsched->pWriting != NULL)
+  {
+    I2CSCHED_WriteEnd(hsched, BSP_I2CSCHED_STATUS_OK);
+    return;
+  }
+  if (hsched->Current == hsched->JobCount)
+  {
+    return;
+  }
+
+  hsched->pJobs[hsched->Current].Status = BSP_I2CSCHED_STATUS_OK;
+  I2CSCHED_Next(hsched);
+}
+
+/**
+  * @brief  Retry the current job or write, or end it in error and start the
+  *         next one.
+  * @note   To be called from HAL_I2C_ErrorCallback().
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+void BSP_I2CSCHED_ErrorHandler(BSP_I2CSCHED_TypeDef *hsched)
+{
+  uint32_t error;
+  uint32_t status;
+
+  if ((hsched->hi2c == NULL) || ((hsched->Current == hsched->JobCount) && (hsched->pWriting == NULL)))
+  {
+    return;
+  }
+
+  error = HAL_I2C_GetError(hsched->hi2c);
+  if ((hsched->hrecover != NULL) &&
+      ((error & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_TIMEOUT)) != 0U))
+  {
+    (void)BSP_I2CRECOVER_Recover(hsched->hrecover);
+  }
+
+  status = ((error & HAL_I2C_ERROR_AF) != 0U) ? BSP_I2CSCHED_STATUS_NACK : BSP_I2CSCHED_STATUS_ERROR;
+  if (hsched->pWriting != NULL)
+  {
+    I2CSCHED_WriteFail(hsched, status);
+  }
+  else
+  {
+    I2CSCHED_Fail(hsched, status);
+  }
+}
+
+/**
+  * @brief  Cycle end callback.
+  * @note   Called from the interrupt ending the last due job.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  Errors Number of jobs of the cycle whose Status is an error.
+  * @retval None
+  */
+__weak void BSP_I2CSCHED_CycleCpltCallback(BSP_I2CSCHED_TypeDef *hsched, uint32_t Errors)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hsched);
+  UNUSED(Errors);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_I2CSCHED_CycleCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_I2CSCHED_Exported_Functions_Group3 Write functions
+  * @brief    Write functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Write functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Queue a register write between the cycles
+      (+) Get the end of a write
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Queue a register write.
+  * @note   The write starts at once when no cycle nor write runs, otherwise
+  *         after the writes queued before it and the cycle running.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  pWrite Pointer to a BSP_I2CSCHED_WriteTypeDef structure, owned by
+  *                the scheduler until BSP_I2CSCHED_WriteCpltCallback().
+  * @retval HAL status, HAL_BUSY when pWrite is already queued
+  */
+HAL_StatusTypeDef BSP_I2CSCHED_Write(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CSCHED_WriteTypeDef *pWrite)
+{
+  uint32_t primask_bit;
+  uint32_t start = 0U;
+
+  if ((hsched == NULL) || (hsched->hi2c == NULL) || (hsched->hi2c->hdmatx == NULL) || (pWrite == NULL) ||
+      (pWrite->pData == NULL) || (pWrite->Size == 0U) ||
+      ((pWrite->MemAddSize != I2C_MEMADD_SIZE_8BIT) && (pWrite->MemAddSize != I2C_MEMADD_SIZE_16BIT)))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (pWrite->Status == BSP_I2CSCHED_STATUS_DUE)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_BUSY;
+  }
+
+  pWrite->Status = BSP_I2CSCHED_STATUS_DUE;
+  pWrite->pNext  = NULL;
+  if (hsched->pWriteTail != NULL)
+  {
+    hsched->pWriteTail->pNext = pWrite;
+  }
+  else
+  {
+    hsched->pWriteHead = pWrite;
+  }
+  hsched->pWriteTail = pWrite;
+
+  /* Take the bus when it is free */
+  if ((hsched->pWriting == NULL) && (hsched->Current == hsched->JobCount) &&
+      (hsched->CyclePending == hsched->JobCount) && (hsched->pWriteHead == pWrite))
+  {
+    hsched->pWriting = pWrite;
+    hsched->Attempt  = 0U;
+    start = 1U;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  if (start != 0U)
+  {
+    I2CSCHED_WriteStart(hsched);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write end callback.
+  * @note   Called from the interrupt ending the write, or from
+  *         BSP_I2CSCHED_Write() when the HAL refuses it. The Status of pWrite
+  *         holds the result.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  pWrite Pointer to the BSP_I2CSCHED_WriteTypeDef structure ended.
+  * @retval None
+  */
+__weak void BSP_I2CSCHED_WriteCpltCallback(BSP_I2CSCHED_TypeDef *hsched, BSP_I2CSCHED_WriteTypeDef *pWrite)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hsched);
+  UNUSED(pWrite);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_I2CSCHED_WriteCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CSCHED_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Put a job on the bus.
+  * @note   A read the HAL refuses, bus stuck busy, goes through the retries as
+  *         a bus error would.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  Index Job started.
+  * @retval None
+  */
+static void I2CSCHED_Start(BSP_I2CSCHED_TypeDef *hsched, uint32_t Index)
+{
+  BSP_I2CSCHED_JobTypeDef *pJob;
+
+  if (Index != hsched->Current)
+  {
+    hsched->Attempt = 0U;
+  }
+
+  for (;;)
+  {
+    pJob = &hsched->pJobs[Index];
+    hsched->Current = Index;
+    hsched->StallCount = 0U;
+    if (hsched->hrecover != NULL)
+    {
+      (void)BSP_I2CRECOVER_Check(hsched->hrecover);
+    }
+    if (HAL_I2C_Mem_Read_DMA(hsched->hi2c, pJob->DevAddress, pJob->MemAddress, pJob->MemAddSize,
+                             pJob->pData, pJob->Size) == HAL_OK)
+    {
+      return;
+    }
+
+    if (hsched->Attempt < hsched->Retries)
+    {
+      hsched->Attempt++;
+      continue;
+    }
+    pJob->Status = BSP_I2CSCHED_STATUS_ERROR;
+    pJob->ErrorCount++;
+    hsched->CycleErrors++;
+
+    /* Look for the next due job */
+    hsched->Attempt = 0U;
+    for (Index++; Index < hsched->JobCount; Index++)
+    {
+      if (hsched->pJobs[Index].Status == BSP_I2CSCHED_STATUS_DUE)
+      {
+        break;
+      }
+    }
+    if (Index == hsched->JobCount)
+    {
+      hsched->Current = hsched->JobCount;
+      hsched->CycleCount++;
+      BSP_I2CSCHED_CycleCpltCallback(hsched, hsched->CycleErrors);
+      I2CSCHED_Resume(hsched);
+      return;
+    }
+  }
+}
+
+/**
+  * @brief  Start the due job following the current one, or end the cycle.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+static void I2CSCHED_Next(BSP_I2CSCHED_TypeDef *hsched)
+{
+  uint32_t index;
+
+  for (index = hsched->Current + 1U; index < hsched->JobCount; index++)
+  {
+    if (hsched->pJobs[index].Status == BSP_I2CSCHED_STATUS_DUE)
+    {
+      I2CSCHED_Start(hsched, index);
+      return;
+    }
+  }
+
+  hsched->Current = hsched->JobCount;
+  hsched->CycleCount++;
+  BSP_I2CSCHED_CycleCpltCallback(hsched, hsched->CycleErrors);
+  I2CSCHED_Resume(hsched);
+}
+
+/**
+  * @brief  Retry the current job or end it in error and start the next one.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  Status Job status once the retries are exhausted.
+  * @retval None
+  */
+static void I2CSCHED_Fail(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status)
+{
+  BSP_I2CSCHED_JobTypeDef *pJob = &hsched->pJobs[hsched->Current];
+
+  if (hsched->Attempt < hsched->Retries)
+  {
+    hsched->Attempt++;
+    I2CSCHED_Start(hsched, hsched->Current);
+    return;
+  }
+
+  pJob->Status = Status;
+  pJob->ErrorCount++;
+  hsched->CycleErrors++;
+  I2CSCHED_Next(hsched);
+}
+
+/**
+  * @brief  Count a tick of the job or write on the bus, drop it once stalled.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+static void I2CSCHED_Stall(BSP_I2CSCHED_TypeDef *hsched)
+{
+  if ((hsched->hrecover == NULL) || ((hsched->Current == hsched->JobCount) && (hsched->pWriting == NULL)))
+  {
+    return;
+  }
+
+  hsched->StallCount++;
+  if (hsched->StallCount >= BSP_I2CSCHED_STALL_TICKS)
+  {
+    (void)BSP_I2CRECOVER_Recover(hsched->hrecover);
+    if (hsched->pWriting != NULL)
+    {
+      I2CSCHED_WriteFail(hsched, BSP_I2CSCHED_STATUS_ERROR);
+    }
+    else
+    {
+      I2CSCHED_Fail(hsched, BSP_I2CSCHED_STATUS_ERROR);
+    }
+  }
+}
+
+/**
+  * @brief  Give the free bus to the cycle waiting, else to the first queued write.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+static void I2CSCHED_Resume(BSP_I2CSCHED_TypeDef *hsched)
+{
+  uint32_t primask_bit;
+  uint32_t first = hsched->JobCount;
+  uint32_t write = 0U;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if ((hsched->pWriting == NULL) && (hsched->Current == hsched->JobCount))
+  {
+    if (hsched->CyclePending != hsched->JobCount)
+    {
+      first = hsched->CyclePending;
+      hsched->CyclePending = hsched->JobCount;
+      hsched->Current = first;
+      hsched->Attempt = 0U;
+    }
+    else if (hsched->pWriteHead != NULL)
+    {
+      hsched->pWriting = hsched->pWriteHead;
+      hsched->Attempt = 0U;
+      write = 1U;
+    }
+    else
+    {
+      /* Bus left free */
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  if (first != hsched->JobCount)
+  {
+    I2CSCHED_Start(hsched, first);
+  }
+  else if (write != 0U)
+  {
+    I2CSCHED_WriteStart(hsched);
+  }
+  else
+  {
+    /* Nothing to start */
+  }
+}
+
+/**
+  * @brief  Put the write of pWriting on the bus.
+  * @note   A write the HAL refuses goes through the retries as a bus error
+  *         would.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @retval None
+  */
+static void I2CSCHED_WriteStart(BSP_I2CSCHED_TypeDef *hsched)
+{
+  BSP_I2CSCHED_WriteTypeDef *pWrite = hsched->pWriting;
+
+  for (;;)
+  {
+    hsched->StallCount = 0U;
+    if (hsched->hrecover != NULL)
+    {
+      (void)BSP_I2CRECOVER_Check(hsched->hrecover);
+    }
+    if (HAL_I2C_Mem_Write_DMA(hsched->hi2c, pWrite->DevAddress, pWrite->MemAddress, pWrite->MemAddSize,
+                              (uint8_t *)pWrite->pData, pWrite->Size) == HAL_OK)
+    {
+      return;
+    }
+
+    if (hsched->Attempt < hsched->Retries)
+    {
+      hsched->Attempt++;
+      continue;
+    }
+    I2CSCHED_WriteEnd(hsched, BSP_I2CSCHED_STATUS_ERROR);
+    return;
+  }
+}
+
+/**
+  * @brief  Take the write of pWriting off the queue and give the bus on.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  Status Write status, a value of @ref BSP_I2CSCHED_Status.
+  * @retval None
+  */
+static void I2CSCHED_WriteEnd(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status)
+{
+  BSP_I2CSCHED_WriteTypeDef *pWrite = hsched->pWriting;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hsched->pWriteHead = pWrite->pNext;
+  if (hsched->pWriteHead == NULL)
+  {
+    hsched->pWriteTail = NULL;
+  }
+  hsched->pWriting = NULL;
+
+  __set_PRIMASK(primask_bit);
+
+  pWrite->pNext = NULL;
+  pWrite->Status = Status;
+  hsched->WriteCount++;
+  BSP_I2CSCHED_WriteCpltCallback(hsched, pWrite);
+  I2CSCHED_Resume(hsched);
+}
+
+/**
+  * @brief  Retry the write on the bus or end it in error.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure.
+  * @param  Status Write status once the retries are exhausted.
+  * @retval None
+  */
+static void I2CSCHED_WriteFail(BSP_I2CSCHED_TypeDef *hsched, uint32_t Status)
+{
+  if (hsched->Attempt < hsched->Retries)
+  {
+    hsched->Attempt++;
+    I2CSCHED_WriteStart(hsched);
+    return;
+  }
+
+  I2CSCHED_WriteEnd(hsched, Status);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,524 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2cslave.c
+  * @author  MCU Application Team
+  * @brief   I2C slave register map BSP service.
+  *          This file provides functions to serve a register map to an I2C
+  *          master with the usual pointer protocol:
+  *           + Address match handled in the event interrupt, no callback
+  *           + Register pointer auto-increment
+  *           + Tx DMA from the map and Rx DMA into a staging area
+  *           + Read-only bits and change notification per transaction
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the I2C with HAL_I2C_Init() with its OwnAddress1, 7-bit
+       addressing and I2C_NOSTRETCH_DISABLE. Link a DMA channel in DMA_NORMAL
+       mode with byte data to its hdmarx and another one to its hdmatx,
+       neither channel interrupt is used. Enable the I2C event and error
+       interrupts in the NVIC, from I2Cx_EV_IRQHandler() call
+       BSP_I2CSLAVE_EV_IRQHandler() and from I2Cx_ER_IRQHandler() call
+       BSP_I2CSLAVE_ER_IRQHandler().
+
+   (#) Call BSP_I2CSLAVE_Init() with the register map and the mask of its
+       writable bits, a NULL mask makes every bit writable. The service then
+       owns the I2C.
+
+   (#) The master uses the register pointer protocol:
+       (+) A write starts with the pointer byte, the following bytes are
+           written from this register on.
+       (+) A read sends the registers from the pointer on, after a write of
+           the pointer alone with or without a STOP, or where the previous
+           transaction left the pointer. BSP_I2CSLAVE_PAD is sent past the
+           end of the map.
+       (+) The pointer moves by the number of bytes written or read.
+
+   (#) The address match is served in the event interrupt while the I2C
+       stretches the clock: the Tx DMA is started on the addressed registers
+       for a read, and the Rx DMA once the pointer byte is in for a write. The
+       data bytes then move without interrupt at the bus speed.
+
+   (#) The written bytes land in the Stage area of the handle. At the end of
+       the write, repeated start or STOP, only the writable bits are merged
+       into the map. At the end of the transaction, STOP or the NACK ending a
+       read, BSP_I2CSLAVE_ChangeCallback() is called once with the range of
+       registers whose value changed, when there is one.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_i2cslave.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_I2CSLAVE BSP I2CSLAVE
+  * @brief I2C slave register map BSP service
+  * @{
+  */
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_I2CSLAVE_Private_Constants BSP I2CSLAVE Private Constants
+  * @{
+  */
+#define I2CSLAVE_CR2_IT           (I2C_CR2_ITEVTEN | I2C_CR2_ITERREN)
+#define I2CSLAVE_SR1_ERRORS       (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR)
+#define I2CSLAVE_NO_CHANGE        0xFFFFFFFFU /*!< ChangeFirst value without change               */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_I2CSLAVE_Private_Functions
+  * @{
+  */
+static void I2CSLAVE_StartRead(BSP_I2CSLAVE_TypeDef *hslave);
+static void I2CSLAVE_EndWrite(BSP_I2CSLAVE_TypeDef *hslave);
+static void I2CSLAVE_EndRead(BSP_I2CSLAVE_TypeDef *hslave, uint32_t SR1);
+static void I2CSLAVE_End(BSP_I2CSLAVE_TypeDef *hslave);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_I2CSLAVE_Exported_Functions BSP I2CSLAVE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_I2CSLAVE_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Take and give back the I2C of the slave
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start serving a register map on an I2C.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @param  hi2c Pointer to an I2C_HandleTypeDef structure initialized with its
+  *              own address, hdmarx and hdmatx in DMA_NORMAL mode must be linked.
+  * @param  pRegs Register map.
+  * @param  pMask Writable bits of each register, RegSize bytes, or NULL.
+  * @param  RegSize Register map size in bytes, 1 to BSP_I2CSLAVE_REG_SIZE_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2CSLAVE_Init(BSP_I2CSLAVE_TypeDef *hslave, I2C_HandleTypeDef *hi2c, uint8_t *pRegs,
+                                    const uint8_t *pMask, uint32_t RegSize)
+{
+  if ((hslave == NULL) || (hi2c == NULL) || (hi2c->hdmarx == NULL) || (hi2c->hdmatx == NULL) ||
+      (pRegs == NULL) || (RegSize == 0U) || (RegSize > BSP_I2CSLAVE_REG_SIZE_MAX) ||
+      (hi2c->Init.AddressingMode != I2C_ADDRESSINGMODE_7BIT) ||
+      (hi2c->Init.NoStretchMode != I2C_NOSTRETCH_DISABLE) ||
+      (hi2c->hdmarx->Init.Mode != DMA_NORMAL) || (hi2c->hdmatx->Init.Mode != DMA_NORMAL))
+  {
+    return HAL_ERROR;
+  }
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hslave->hi2c        = hi2c;
+  hslave->pRegs       = pRegs;
+  hslave->pMask       = pMask;
+  hslave->RegSize     = RegSize;
+  hslave->State       = BSP_I2CSLAVE_STATE_IDLE;
+  hslave->Pointer     = 0U;
+  hslave->XferSize    = 0U;
+  hslave->ChangeFirst = I2CSLAVE_NO_CHANGE;
+  hslave->ChangeLast  = 0U;
+  hslave->ErrorCount  = 0U;
+
+  hi2c->State = HAL_I2C_STATE_LISTEN;
+  SET_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
+  SET_BIT(hi2c->Instance->CR2, I2CSLAVE_CR2_IT);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop serving the register map and give the I2C back to the HAL.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2CSLAVE_DeInit(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  I2C_HandleTypeDef *hi2c;
+
+  if ((hslave == NULL) || (hslave->hi2c == NULL))
+  {
+    return HAL_ERROR;
+  }
+  hi2c = hslave->hi2c;
+
+  CLEAR_BIT(hi2c->Instance->CR2, I2CSLAVE_CR2_IT | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN);
+  CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
+  (void)HAL_DMA_Abort(hi2c->hdmatx);
+  (void)HAL_DMA_Abort(hi2c->hdmarx);
+
+  hslave->State = BSP_I2CSLAVE_STATE_IDLE;
+  hslave->hi2c  = NULL;
+  hi2c->State   = HAL_I2C_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_I2CSLAVE_Exported_Functions_Group2 Interrupt functions
+  * @brief    Interrupt functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Interrupt functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Serve the address match, the pointer byte and the STOP condition
+      (+) End a read on the master NACK and recover from bus errors
+      (+) Be notified of the registers changed by the master
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Serve an I2C event, called from the I2Cx_EV_IRQHandler().
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval None
+  */
+void BSP_I2CSLAVE_EV_IRQHandler(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  I2C_TypeDef *i2c;
+  uint32_t sr1;
+  uint32_t sr2;
+
+  if (hslave->hi2c == NULL)
+  {
+    return;
+  }
+  i2c = hslave->hi2c->Instance;
+  sr1 = READ_REG(i2c->SR1);
+
+  if ((sr1 & I2C_SR1_ADDR) != 0U)
+  {
+    /* A repeated start ends the write of the pointer or of the registers */
+    if (hslave->State == BSP_I2CSLAVE_STATE_WRITE)
+    {
+      I2CSLAVE_EndWrite(hslave);
+    }
+    CLEAR_BIT(i2c->CR2, I2C_CR2_ITBUFEN);
+
+    /* The SR2 read clears ADDR, the clock stays stretched until DR is used */
+    sr2 = READ_REG(i2c->SR2);
+    if ((sr2 & I2C_SR2_TRA) != 0U)
+    {
+      I2CSLAVE_StartRead(hslave);
+    }
+    else
+    {
+      hslave->State = BSP_I2CSLAVE_STATE_POINTER;
+      SET_BIT(i2c->CR2, I2C_CR2_ITBUFEN);
+    }
+    return;
+  }
+
+  if ((sr1 & I2C_SR1_STOPF) != 0U)
+  {
+    /* The SR1 read then a CR1 write clear STOPF */
+    SET_BIT(i2c->CR1, I2C_CR1_PE);
+    if (hslave->State == BSP_I2CSLAVE_STATE_WRITE)
+    {
+      I2CSLAVE_EndWrite(hslave);
+    }
+    /* Bytes received after the DMA ended */
+    if ((sr1 & I2C_SR1_RXNE) != 0U)
+    {
+      (void)READ_REG(i2c->DR);
+    }
+    I2CSLAVE_End(hslave);
+    return;
+  }
+
+  if ((sr1 & I2C_SR1_RXNE) != 0U)
+  {
+    if (hslave->State == BSP_I2CSLAVE_STATE_POINTER)
+    {
+      hslave->Pointer = READ_REG(i2c->DR) & 0xFFU;
+      if (hslave->Pointer >= hslave->RegSize)
+      {
+        hslave->ErrorCount++;
+        hslave->State = BSP_I2CSLAVE_STATE_DISCARD;
+        return;
+      }
+
+      CLEAR_BIT(i2c->CR2, I2C_CR2_ITBUFEN);
+      hslave->XferSize = hslave->RegSize - hslave->Pointer;
+      hslave->State = BSP_I2CSLAVE_STATE_WRITE;
+      if (HAL_DMA_Start(hslave->hi2c->hdmarx, (uint32_t)&i2c->DR, (uint32_t)&hslave->Stage[hslave->Pointer],
+                        hslave->XferSize) == HAL_OK)
+      {
+        SET_BIT(i2c->CR2, I2C_CR2_DMAEN);
+      }
+      else
+      {
+        hslave->ErrorCount++;
+        hslave->State = BSP_I2CSLAVE_STATE_DISCARD;
+        SET_BIT(i2c->CR2, I2C_CR2_ITBUFEN);
+      }
+    }
+    else
+    {
+      /* Past the end of the map or after an invalid pointer */
+      (void)READ_REG(i2c->DR);
+    }
+    return;
+  }
+
+  if (((sr1 & I2C_SR1_TXE) != 0U) && (hslave->State == BSP_I2CSLAVE_STATE_READ))
+  {
+    /* The Tx DMA ended before the master NACK */
+    WRITE_REG(i2c->DR, BSP_I2CSLAVE_PAD);
+  }
+}
+
+/**
+  * @brief  Serve an I2C error, called from the I2Cx_ER_IRQHandler().
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval None
+  */
+void BSP_I2CSLAVE_ER_IRQHandler(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  I2C_TypeDef *i2c;
+  uint32_t sr1;
+
+  if (hslave->hi2c == NULL)
+  {
+    return;
+  }
+  i2c = hslave->hi2c->Instance;
+  sr1 = READ_REG(i2c->SR1);
+
+  if ((sr1 & I2C_SR1_AF) != 0U)
+  {
+    /* The master NACK ends a read */
+    WRITE_REG(i2c->SR1, ~I2C_SR1_AF & I2C_FLAG_MASK);
+    if (hslave->State == BSP_I2CSLAVE_STATE_READ)
+    {
+      I2CSLAVE_EndRead(hslave, sr1);
+    }
+    I2CSLAVE_End(hslave);
+  }
+
+  if ((sr1 & I2CSLAVE_SR1_ERRORS) != 0U)
+  {
+    WRITE_REG(i2c->SR1, ~I2CSLAVE_SR1_ERRORS & I2C_FLAG_MASK);
+    hslave->ErrorCount++;
+    CLEAR_BIT(i2c->CR2, I2C_CR2_DMAEN | I2C_CR2_ITBUFEN);
+    (void)HAL_DMA_Abort(hslave->hi2c->hdmatx);
+    (void)HAL_DMA_Abort(hslave->hi2c->hdmarx);
+
+    /* Drop the interrupted transaction and any byte left in DR */
+    __HAL_I2C_DISABLE(hslave->hi2c);
+    __HAL_I2C_ENABLE(hslave->hi2c);
+    SET_BIT(i2c->CR1, I2C_CR1_ACK);
+    I2CSLAVE_End(hslave);
+  }
+}
+
+/**
+  * @brief  Register change callback.
+  * @note   Called from the I2C interrupt at the end of a transaction which
+  *         changed at least one register.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @param  Address First register changed.
+  * @param  Size Number of registers from the first to the last one changed.
+  * @retval None
+  */
+__weak void BSP_I2CSLAVE_ChangeCallback(BSP_I2CSLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hslave);
+  UNUSED(Address);
+  UNUSED(Size);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_I2CSLAVE_ChangeCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2CSLAVE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Start sending the registers from the pointer on.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval None
+  */
+static void I2CSLAVE_StartRead(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  I2C_TypeDef *i2c = hslave->hi2c->Instance;
+
+  hslave->State = BSP_I2CSLAVE_STATE_READ;
+  hslave->XferSize = 0U;
+
+  if (hslave->Pointer < hslave->RegSize)
+  {
+    hslave->XferSize = hslave->RegSize - hslave->Pointer;
+    if (HAL_DMA_Start(hslave->hi2c->hdmatx, (uint32_t)&hslave->pRegs[hslave->Pointer], (uint32_t)&i2c->DR,
+                      hslave->XferSize) == HAL_OK)
+    {
+      SET_BIT(i2c->CR2, I2C_CR2_DMAEN);
+      return;
+    }
+    hslave->XferSize = 0U;
+    hslave->ErrorCount++;
+  }
+
+  /* Padding only, from the TXE interrupt */
+  SET_BIT(i2c->CR2, I2C_CR2_ITBUFEN);
+}
+
+/**
+  * @brief  Merge the bytes written by the master into the map.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval None
+  */
+static void I2CSLAVE_EndWrite(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  I2C_HandleTypeDef *hi2c = hslave->hi2c;
+  uint32_t count;
+  uint32_t address;
+  uint8_t mask;
+  uint8_t value;
+
+  CLEAR_BIT(hi2c->Instance->CR2, I2C_CR2_DMAEN);
+  count = hslave->XferSize - __HAL_DMA_GET_COUNTER(hi2c->hdmarx);
+  (void)HAL_DMA_Abort(hi2c->hdmarx);
+
+  for (address = hslave->Pointer; address < (hslave->Pointer + count); address++)
+  {
+    mask = (hslave->pMask != NULL) ? hslave->pMask[address] : 0xFFU;
+    value = (uint8_t)((hslave->pRegs[address] & (uint8_t)~mask) | (hslave->Stage[address] & mask));
+    if (value != hslave->pRegs[address])
+    {
+      hslave->pRegs[address] = value;
+      hslave->ChangeFirst = (address < hslave->ChangeFirst) ? address : hslave->ChangeFirst;
+      hslave->ChangeLast  = (address > hslave->ChangeLast) ? address : hslave->ChangeLast;
+    }
+  }
+
+  hslave->Pointer += count;
+  hslave->State = BSP_I2CSLAVE_STATE_IDLE;
+}
+
+/**
+  * @brief  Move the pointer past the registers sent before the master NACK.
+  * @note   The I2C is disabled and enabled again to drop the byte the DMA
+  *         already loaded in DR for the next read.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @param  SR1 SR1 value read with the AF flag.
+  * @retval None
+  */
+static void I2CSLAVE_EndRead(BSP_I2CSLAVE_TypeDef *hslave, uint32_t SR1)
+{
+  I2C_HandleTypeDef *hi2c = hslave->hi2c;
+  uint32_t count = 0U;
+
+  CLEAR_BIT(hi2c->Instance->CR2, I2C_CR2_DMAEN | I2C_CR2_ITBUFEN);
+  if (hslave->XferSize != 0U)
+  {
+    count = hslave->XferSize - __HAL_DMA_GET_COUNTER(hi2c->hdmatx);
+    (void)HAL_DMA_Abort(hi2c->hdmatx);
+
+    /* A byte still in DR was not sent */
+    if ((count != 0U) && ((SR1 & I2C_SR1_TXE) == 0U))
+    {
+      count--;
+    }
+  }
+
+  __HAL_I2C_DISABLE(hi2c);
+  __HAL_I2C_ENABLE(hi2c);
+  SET_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
+
+  hslave->Pointer += count;
+}
+
+/**
+  * @brief  End the transaction and report the registers changed.
+  * @param  hslave Pointer to a BSP_I2CSLAVE_TypeDef structure.
+  * @retval None
+  */
+static void I2CSLAVE_End(BSP_I2CSLAVE_TypeDef *hslave)
+{
+  uint32_t first = hslave->ChangeFirst;
+  uint32_t last = hslave->ChangeLast;
+
+  CLEAR_BIT(hslave->hi2c->Instance->CR2, I2C_CR2_ITBUFEN);
+  hslave->State = BSP_I2CSLAVE_STATE_IDLE;
+  hslave->ChangeFirst = I2CSLAVE_NO_CHANGE;
+  hslave->ChangeLast = 0U;
+
+  if (first != I2CSLAVE_NO_CHANGE)
+  {
+    BSP_I2CSLAVE_ChangeCallback(hslave, first, (last - first) + 1U);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,500 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_i2sduplex.c
+  * @author  MCU Application Team
+  * @brief   Full-duplex I2S streaming BSP service.
+  *          This file provides functions to play and capture audio at the
+  *          same time on two I2S on the same frame clock:
+  *           + Circular double-buffered DMA in both directions
+  *           + Both streams started on the same frame
+  *           + One callback per block with the captured block and the block
+  *             to fill, aligned
+  *           + Late processing and stream slips counted
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The I2S of the PY32F4 have no extended full-duplex instance: an I2S
+       either transmits or receives. This service pairs two of them on the
+       same CK and WS, one transmitting and one receiving:
+       (+) Master TX and slave RX: the CK and WS pins of the slave are wired
+           to those of the master, SD of the slave takes the codec output.
+       (+) Master RX and slave TX, the other way round.
+       (+) Both slaves when the codec is the clock master, its CK and WS
+           wired to both I2S.
+       Both have the same Standard, DataFormat and CPOL, the AudioFreq of the
+       master gives the rate.
+
+   (#) In HAL_I2S_MspInit(), enable the clocks and the pins of both I2S and
+       link one DMA channel to each with __HAL_LINKDMA(): hdmatx of the
+       transmitter, request DMA_CHANNEL_MAP_SPIx_WR, memory to peripheral;
+       hdmarx of the receiver, DMA_CHANNEL_MAP_SPIx_RD, peripheral to memory.
+       Both in halfwords, memory increment and DMA_CIRCULAR. Enable both DMA
+       interrupts in the NVIC at the same priority, they call
+       HAL_DMA_IRQHandler() of their channel.
+
+   (#) Initialize both I2S with HAL_I2S_Init(), then call
+       BSP_I2SDUPLEX_Init() with the transmitter and the receiver.
+
+   (#) BSP_I2SDUPLEX_Start() runs both streams over two buffers of
+       2 x BlockSize halfwords, silence played first:
+       (+) The slaves are enabled before the master: they wait for its first
+           frame, so that sample n of pRxBuffer is captured in the frame
+           where sample n of pTxBuffer is played.
+       (+) BlockSize counts halfwords of both channels: 2 per stereo frame in
+           16 bits, 4 in 24 and 32 bits where each sample is two halfwords,
+           most significant first. 64 stereo frames of 16 bits at 48 kHz are
+           128 halfwords and 1.33 ms per block.
+       (+) When the receiver has written a half of pRxBuffer and the
+           transmitter has read the same half of pTxBuffer,
+           BSP_I2SDUPLEX_BlockCallback() runs from the DMA interrupt with
+           both halves: process pRx into pTx within one block time. The
+           output leaves one block after the input came, the latency is two
+           blocks.
+
+   (#) A block processed after the DMA came back to it counts in Stats.Late,
+       the output then clicks. Both streams run from one clock, they cannot
+       drift: a slip, the DMA of one more than one half ahead of the other,
+       comes from an interrupt masked for a whole block. It counts in
+       Stats.Slips and the blocks missed are skipped, the pairs stay
+       aligned.
+
+   (#) On a DMA error the State goes to BSP_I2SDUPLEX_STATE_ERROR, the
+       blocks stop and BSP_I2SDUPLEX_ErrorCallback() runs: call
+       BSP_I2SDUPLEX_Stop() from the thread then start again.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_i2sduplex.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_I2SDUPLEX BSP I2SDUPLEX
+  * @brief Full-duplex I2S streaming BSP service
+  * @{
+  */
+
+#if defined (HAL_I2S_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Private_Macros BSP I2SDUPLEX Private Macros
+  * @{
+  */
+#define I2SDUPLEX_IS_MASTER(__HI2S__)   (((__HI2S__)->Init.Mode == I2S_MODE_MASTER_TX) || \
+                                         ((__HI2S__)->Init.Mode == I2S_MODE_MASTER_RX))
+
+#define I2SDUPLEX_IS_WIDE(__HI2S__)     (((__HI2S__)->Init.DataFormat == I2S_DATAFORMAT_24B) || \
+                                         ((__HI2S__)->Init.DataFormat == I2S_DATAFORMAT_32B))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Private_Variables BSP I2SDUPLEX Private Variables
+  * @{
+  */
+
+/* The DMA callbacks have no user pointer: one stream pair at a time */
+static BSP_I2SDUPLEX_TypeDef *I2SDUPLEX_Active;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Private_Functions BSP I2SDUPLEX Private Functions
+  * @{
+  */
+static HAL_StatusTypeDef I2SDUPLEX_StartOne(BSP_I2SDUPLEX_TypeDef *hdx, I2S_HandleTypeDef *hi2s, uint16_t Size);
+static void     I2SDUPLEX_Deliver(BSP_I2SDUPLEX_TypeDef *hdx);
+static void     I2SDUPLEX_DMATxHalf(DMA_HandleTypeDef *hdma);
+static void     I2SDUPLEX_DMARxHalf(DMA_HandleTypeDef *hdma);
+static void     I2SDUPLEX_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_I2SDUPLEX_Exported_Functions BSP I2SDUPLEX Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Pair a transmitting and a receiving I2S on the same frame clock.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @param  hi2stx I2S initialized in I2S_MODE_MASTER_TX or I2S_MODE_SLAVE_TX,
+  *                hdmatx linked in DMA_CIRCULAR.
+  * @param  hi2srx I2S initialized in I2S_MODE_MASTER_RX or I2S_MODE_SLAVE_RX,
+  *                hdmarx linked in DMA_CIRCULAR.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2SDUPLEX_Init(BSP_I2SDUPLEX_TypeDef *hdx, I2S_HandleTypeDef *hi2stx,
+                                     I2S_HandleTypeDef *hi2srx)
+{
+  if ((hdx == NULL) || (hi2stx == NULL) || (hi2srx == NULL) || (hi2stx == hi2srx) ||
+      (hi2stx->hdmatx == NULL) || (hi2srx->hdmarx == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (((hi2stx->Init.Mode != I2S_MODE_MASTER_TX) && (hi2stx->Init.Mode != I2S_MODE_SLAVE_TX)) ||
+      ((hi2srx->Init.Mode != I2S_MODE_MASTER_RX) && (hi2srx->Init.Mode != I2S_MODE_SLAVE_RX)) ||
+      (I2SDUPLEX_IS_MASTER(hi2stx) && I2SDUPLEX_IS_MASTER(hi2srx)))
+  {
+    return HAL_ERROR;
+  }
+  if ((hi2stx->Init.Standard != hi2srx->Init.Standard) ||
+      (hi2stx->Init.DataFormat != hi2srx->Init.DataFormat) ||
+      (hi2stx->Init.CPOL != hi2srx->Init.CPOL))
+  {
+    return HAL_ERROR;
+  }
+  if ((hi2stx->hdmatx->Init.Mode != DMA_CIRCULAR) || (hi2srx->hdmarx->Init.Mode != DMA_CIRCULAR))
+  {
+    return HAL_ERROR;
+  }
+  if ((hi2stx->State != HAL_I2S_STATE_READY) || (hi2srx->State != HAL_I2S_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  hdx->hi2stx       = hi2stx;
+  hdx->hi2srx       = hi2srx;
+  hdx->pTxBuffer    = NULL;
+  hdx->pRxBuffer    = NULL;
+  hdx->BlockSize    = 0U;
+  hdx->TxHalves     = 0U;
+  hdx->RxHalves     = 0U;
+  hdx->Delivered    = 0U;
+  hdx->Stats.Blocks = 0U;
+  hdx->Stats.Late   = 0U;
+  hdx->Stats.Slips  = 0U;
+  hdx->Stats.Errors = 0U;
+  hdx->State        = BSP_I2SDUPLEX_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start both streams, the slaves first.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @param  pTxBuffer Output buffer of 2 x BlockSize halfwords, cleared here.
+  * @param  pRxBuffer Input buffer of 2 x BlockSize halfwords.
+  * @param  BlockSize Halfwords per block, whole stereo frames, up to
+  *                   BSP_I2SDUPLEX_BLOCK_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2SDUPLEX_Start(BSP_I2SDUPLEX_TypeDef *hdx, uint16_t *pTxBuffer,
+                                      uint16_t *pRxBuffer, uint32_t BlockSize)
+{
+  I2S_HandleTypeDef *slave;
+  I2S_HandleTypeDef *master;
+  uint32_t frame;
+  uint16_t size;
+  uint32_t i;
+
+  if (hdx->State != BSP_I2SDUPLEX_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  frame = I2SDUPLEX_IS_WIDE(hdx->hi2stx) ? 4U : 2U;
+  if ((pTxBuffer == NULL) || (pRxBuffer == NULL) || (BlockSize == 0U) ||
+      (BlockSize > BSP_I2SDUPLEX_BLOCK_MAX) || ((BlockSize % frame) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (I2SDUPLEX_Active != NULL)
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 0U; i < (2U * BlockSize); i++)
+  {
+    pTxBuffer[i] = 0U;
+  }
+
+  hdx->pTxBuffer    = pTxBuffer;
+  hdx->pRxBuffer    = pRxBuffer;
+  hdx->BlockSize    = BlockSize;
+  hdx->TxHalves     = 0U;
+  hdx->RxHalves     = 0U;
+  hdx->Delivered    = 0U;
+  hdx->State        = BSP_I2SDUPLEX_STATE_RUN;
+  I2SDUPLEX_Active  = hdx;
+
+  /* The HAL doubles Size in 24 and 32 bits, the DMA counts halfwords */
+  size = (uint16_t)((frame == 4U) ? BlockSize : (2U * BlockSize));
+
+  /* The slave waits for the first frame of the master */
+  slave  = I2SDUPLEX_IS_MASTER(hdx->hi2stx) ? hdx->hi2srx : hdx->hi2stx;
+  master = (slave == hdx->hi2stx) ? hdx->hi2srx : hdx->hi2stx;
+
+  if (I2SDUPLEX_StartOne(hdx, slave, size) != HAL_OK)
+  {
+    I2SDUPLEX_Active = NULL;
+    hdx->State       = BSP_I2SDUPLEX_STATE_READY;
+    return HAL_ERROR;
+  }
+  if (I2SDUPLEX_StartOne(hdx, master, size) != HAL_OK)
+  {
+    (void)HAL_I2S_DMAStop(slave);
+    I2SDUPLEX_Active = NULL;
+    hdx->State       = BSP_I2SDUPLEX_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop both streams, the master first.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_I2SDUPLEX_Stop(BSP_I2SDUPLEX_TypeDef *hdx)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  I2S_HandleTypeDef *first;
+  I2S_HandleTypeDef *second;
+
+  if ((hdx->State != BSP_I2SDUPLEX_STATE_RUN) && (hdx->State != BSP_I2SDUPLEX_STATE_ERROR))
+  {
+    return HAL_ERROR;
+  }
+
+  first  = I2SDUPLEX_IS_MASTER(hdx->hi2srx) ? hdx->hi2srx : hdx->hi2stx;
+  second = (first == hdx->hi2stx) ? hdx->hi2srx : hdx->hi2stx;
+
+  if (HAL_I2S_DMAStop(first) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+  if (HAL_I2S_DMAStop(second) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  I2SDUPLEX_Active = NULL;
+  hdx->State       = BSP_I2SDUPLEX_STATE_READY;
+
+  return status;
+}
+
+/**
+  * @brief  Get a snapshot of the statistics.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @param  pStats Statistics copied.
+  * @retval None
+  */
+void BSP_I2SDUPLEX_GetStats(const BSP_I2SDUPLEX_TypeDef *hdx, BSP_I2SDUPLEX_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hdx->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Block callback, from the DMA interrupt.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @param  pRx BlockSize halfwords just captured.
+  * @param  pTx BlockSize halfwords just played, to fill with the next output.
+  * @retval None
+  */
+__weak void BSP_I2SDUPLEX_BlockCallback(BSP_I2SDUPLEX_TypeDef *hdx, const uint16_t *pRx, uint16_t *pTx)
+{
+  UNUSED(hdx);
+  UNUSED(pRx);
+  UNUSED(pTx);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_I2SDUPLEX_BlockCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  DMA error callback, from the DMA interrupt.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_I2SDUPLEX_ErrorCallback(BSP_I2SDUPLEX_TypeDef *hdx)
+{
+  UNUSED(hdx);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_I2SDUPLEX_ErrorCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_I2SDUPLEX_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Start the circular DMA of one stream and take its callbacks.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @param  hi2s hdx->hi2stx or hdx->hi2srx.
+  * @param  Size Size given to the HAL.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef I2SDUPLEX_StartOne(BSP_I2SDUPLEX_TypeDef *hdx, I2S_HandleTypeDef *hi2s, uint16_t Size)
+{
+  if (hi2s == hdx->hi2stx)
+  {
+    if (HAL_I2S_Transmit_DMA(hi2s, hdx->pTxBuffer, Size) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    /* The half and complete interrupts were enabled for the HAL callbacks */
+    hi2s->hdmatx->XferHalfCpltCallback = I2SDUPLEX_DMATxHalf;
+    hi2s->hdmatx->XferCpltCallback     = I2SDUPLEX_DMATxHalf;
+    hi2s->hdmatx->XferErrorCallback    = I2SDUPLEX_DMAError;
+  }
+  else
+  {
+    if (HAL_I2S_Receive_DMA(hi2s, hdx->pRxBuffer, Size) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    hi2s->hdmarx->XferHalfCpltCallback = I2SDUPLEX_DMARxHalf;
+    hi2s->hdmarx->XferCpltCallback     = I2SDUPLEX_DMARxHalf;
+    hi2s->hdmarx->XferErrorCallback    = I2SDUPLEX_DMAError;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give the callback the halves both DMA are done with.
+  * @note   Both DMA interrupts have the same priority: this function does not
+  *         preempt itself.
+  * @param  hdx Pointer to a BSP_I2SDUPLEX_TypeDef structure.
+  * @retval None
+  */
+static void I2SDUPLEX_Deliver(BSP_I2SDUPLEX_TypeDef *hdx)
+{
+  uint32_t tx = hdx->TxHalves;
+  uint32_t rx = hdx->RxHalves;
+  int32_t  lead = (int32_t)(rx - tx);
+  uint32_t ready;
+  uint32_t half;
+  uint32_t remaining;
+
+  if ((lead > 1) || (lead < -1))
+  {
+    /* Realign on the DMA ahead, the blocks missed are lost */
+    ready = (lead > 0) ? rx : tx;
+    hdx->TxHalves  = ready;
+    hdx->RxHalves  = ready;
+    hdx->Delivered = ready;
+    hdx->Stats.Slips++;
+    return;
+  }
+
+  ready = (lead > 0) ? tx : rx;
+  while (hdx->Delivered != ready)
+  {
+    half = hdx->Delivered & 1U;
+    BSP_I2SDUPLEX_BlockCallback(hdx, &hdx->pRxBuffer[half * hdx->BlockSize],
+                                &hdx->pTxBuffer[half * hdx->BlockSize]);
+    hdx->Delivered++;
+    hdx->Stats.Blocks++;
+
+    /* The receiver must still be in the other half, the transmitter lags it */
+    remaining = __HAL_DMA_GET_COUNTER(hdx->hi2srx->hdmarx);
+    if ((half == 0U) ? (remaining > hdx->BlockSize) : (remaining <= hdx->BlockSize))
+    {
+      hdx->Stats.Late++;
+    }
+  }
+}
+
+/**
+  * @brief  DMA half and complete callback of the transmitter.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void I2SDUPLEX_DMATxHalf(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if ((I2SDUPLEX_Active != NULL) && (I2SDUPLEX_Active->State == BSP_I2SDUPLEX_STATE_RUN))
+  {
+    I2SDUPLEX_Active->TxHalves++;
+    I2SDUPLEX_Deliver(I2SDUPLEX_Active);
+  }
+}
+
+/**
+  * @brief  DMA half and complete callback of the receiver.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void I2SDUPLEX_DMARxHalf(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if ((I2SDUPLEX_Active != NULL) && (I2SDUPLEX_Active->State == BSP_I2SDUPLEX_STATE_RUN))
+  {
+    I2SDUPLEX_Active->RxHalves++;
+    I2SDUPLEX_Deliver(I2SDUPLEX_Active);
+  }
+}
+
+/**
+  * @brief  DMA error callback of both streams.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void I2SDUPLEX_DMAError(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if ((I2SDUPLEX_Active != NULL) && (I2SDUPLEX_Active->State == BSP_I2SDUPLEX_STATE_RUN))
+  {
+    I2SDUPLEX_Active->State = BSP_I2SDUPLEX_STATE_ERROR;
+    I2SDUPLEX_Active->Stats.Errors++;
+    BSP_I2SDUPLEX_ErrorCallback(I2SDUPLEX_Active);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2S_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,416 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_inverter.c
+  * @author  MCU Application Team
+  * @brief   3-phase inverter PWM BSP service.
+  *          This file provides functions to drive a 3-phase bridge from an
+  *          advanced timer:
+  *           + Center-aligned complementary PWM with dead time, one call
+  *           + One update per period, at the center of the low side pulses,
+  *             on TRGO for the ADC
+  *           + Three duties written between two updates
+  *           + Break input and software trip, no CPU on the shutdown path
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Set htim->Instance to TIM1 or TIM8 and implement HAL_TIM_PWM_MspInit()
+       with the clock of the timer and the six outputs and BKIN in their
+       alternate function. BSP_INVERTER_Init() does the rest from one
+       BSP_INVERTER_InitTypeDef: counter center-aligned mode 1 at PwmHz,
+       prescaler 1, ARR and CCR1 to CCR3 preloaded, channels 1 to 3 in PWM
+       mode 1 with their complementary outputs, the dead time rounded up to
+       the timer clock, the break input enabled, and TRGO on the update. CC4
+       stays free, to trigger the injected conversions of BSP_MOTORADC.
+
+   (#) The repetition counter is 1: the update, and so the load of the three
+       CCRx, happens once per period when the counter reaches 0. The outputs
+       are then at the middle of the low side pulses, the point where TRGO
+       can start the current sampling of the ADC.
+
+   (#) BSP_INVERTER_Start() sets the three duties to 50 %, enables the six
+       outputs together, then the main output and the counter.
+       BSP_INVERTER_SetDuty3() writes the three duties, 0 to
+       BSP_INVERTER_GET_PERIOD(): when the update is less than UpdateGuard
+       timer clocks away it first waits for it, with the interrupts disabled,
+       so the three CCRx are always loaded by the same update. Call it from
+       the control loop, the ADC interrupt of BSP_MOTORADC for instance.
+
+   (#) An active level on BKIN clears the main output in the timer logic,
+       asynchronously to the clocks: the six outputs go to their off level, the
+       idle states following the polarities, without any software. The break
+       interrupt then calls BSP_INVERTER_FaultCallback(): enable
+       TIMx_BRK_IRQn and call BSP_INVERTER_BreakIRQHandler() from its handler.
+       BSP_INVERTER_Trip() generates the same break from the software, a
+       single register write. BSP_INVERTER_ClearFault() restarts the outputs at
+       50 % once BKIN is inactive.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_inverter.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_INVERTER BSP INVERTER
+  * @brief 3-phase inverter PWM BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_INVERTER_Private_Constants BSP INVERTER Private Constants
+  * @{
+  */
+#define INVERTER_CCER                   (TIM_CCER_CC1E | TIM_CCER_CC1NE | TIM_CCER_CC2E | TIM_CCER_CC2NE | \
+                                         TIM_CCER_CC3E | TIM_CCER_CC3NE)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_INVERTER_Private_Functions BSP INVERTER Private Functions
+  * @{
+  */
+static uint32_t INVERTER_DeadTime(uint32_t Ticks);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_INVERTER_Exported_Functions BSP INVERTER Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the timer of a 3-phase inverter.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @param  htim TIM handle, Instance TIM1 or TIM8, the rest set by the service.
+  * @param  pInit Pointer to a BSP_INVERTER_InitTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_INVERTER_Init(BSP_INVERTER_TypeDef *hinv, TIM_HandleTypeDef *htim,
+                                    const BSP_INVERTER_InitTypeDef *pInit)
+{
+  TIM_BreakDeadTimeConfigTypeDef bdtr = {0};
+  TIM_MasterConfigTypeDef master = {0};
+  TIM_OC_InitTypeDef oc = {0};
+  uint32_t clock;
+  uint32_t period;
+  uint32_t deadtime;
+  uint32_t phase;
+
+  if ((hinv == NULL) || (htim == NULL) || (pInit == NULL) ||
+      ((htim->Instance != TIM1) && (htim->Instance != TIM8)) || (pInit->PwmHz == 0U) ||
+      !IS_TIM_OC_POLARITY(pInit->OCPolarity) || !IS_TIM_OCN_POLARITY(pInit->OCNPolarity) ||
+      !IS_TIM_BREAK_POLARITY(pInit->BreakPolarity))
+  {
+    return HAL_ERROR;
+  }
+
+  /* TIM1 and TIM8 run from PCLK2, doubled when APB2 is divided */
+  clock = HAL_RCC_GetPCLK2Freq();
+  clock = (clock == HAL_RCC_GetHCLKFreq()) ? clock : (2U * clock);
+
+  /* Center-aligned, the counter goes up and down in a period */
+  period = clock / (2U * pInit->PwmHz);
+  deadtime = (uint32_t)((((uint64_t)pInit->DeadTimeNs * clock) + 999999999U) / 1000000000U);
+  if ((period < 2U) || (period > 0xFFFFU) || (deadtime > BSP_INVERTER_DEADTIME_MAX) ||
+      ((2U * deadtime) >= period) || (pInit->UpdateGuard >= period))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hinv->State == BSP_INVERTER_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  htim->Init.Prescaler         = 0U;
+  htim->Init.CounterMode       = TIM_COUNTERMODE_CENTERALIGNED1;
+  htim->Init.Period            = period;
+  htim->Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+  htim->Init.RepetitionCounter = 1U;
+  htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_PWM_Init(htim) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* The idle levels are the off levels of the switches */
+  oc.OCMode       = TIM_OCMODE_PWM1;
+  oc.Pulse        = period / 2U;
+  oc.OCPolarity   = pInit->OCPolarity;
+  oc.OCNPolarity  = pInit->OCNPolarity;
+  oc.OCFastMode   = TIM_OCFAST_DISABLE;
+  oc.OCIdleState  = (pInit->OCPolarity == TIM_OCPOLARITY_HIGH) ? TIM_OCIDLESTATE_RESET : TIM_OCIDLESTATE_SET;
+  oc.OCNIdleState = (pInit->OCNPolarity == TIM_OCNPOLARITY_HIGH) ? TIM_OCNIDLESTATE_RESET : TIM_OCNIDLESTATE_SET;
+  for (phase = 0U; phase < BSP_INVERTER_PHASES; phase++)
+  {
+    if (HAL_TIM_PWM_ConfigChannel(htim, &oc, TIM_CHANNEL_1 + (phase << 2)) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  bdtr.OffStateRunMode  = TIM_OSSR_ENABLE;
+  bdtr.OffStateIDLEMode = TIM_OSSI_ENABLE;
+  bdtr.LockLevel        = TIM_LOCKLEVEL_OFF;
+  bdtr.DeadTime         = INVERTER_DeadTime(deadtime);
+  bdtr.BreakState       = TIM_BREAK_ENABLE;
+  bdtr.BreakPolarity    = pInit->BreakPolarity;
+  bdtr.AutomaticOutput  = TIM_AUTOMATICOUTPUT_DISABLE;
+  if (HAL_TIMEx_ConfigBreakDeadTime(htim, &bdtr) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  master.MasterOutputTrigger = TIM_TRGO_UPDATE;
+  master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(htim, &master) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hinv->htim        = htim;
+  hinv->Period      = period;
+  hinv->DeadTime    = deadtime;
+  hinv->UpdateGuard = pInit->UpdateGuard;
+  hinv->Faults      = 0U;
+  hinv->State       = BSP_INVERTER_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the six outputs at 50 %.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_INVERTER_Start(BSP_INVERTER_TypeDef *hinv)
+{
+  TIM_TypeDef *tim;
+
+  if (hinv->State != BSP_INVERTER_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  tim = hinv->htim->Instance;
+  tim->CCR1 = hinv->Period / 2U;
+  tim->CCR2 = hinv->Period / 2U;
+  tim->CCR3 = hinv->Period / 2U;
+  tim->EGR  = TIM_EGR_UG;
+
+  __HAL_TIM_CLEAR_FLAG(hinv->htim, TIM_FLAG_BREAK);
+  __HAL_TIM_ENABLE_IT(hinv->htim, TIM_IT_BREAK);
+  tim->CCER |= INVERTER_CCER;
+  __HAL_TIM_MOE_ENABLE(hinv->htim);
+  __HAL_TIM_ENABLE(hinv->htim);
+  hinv->State = BSP_INVERTER_STATE_RUN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the outputs, at their off level, and the counter.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_INVERTER_Stop(BSP_INVERTER_TypeDef *hinv)
+{
+  TIM_TypeDef *tim;
+
+  if ((hinv->State != BSP_INVERTER_STATE_RUN) && (hinv->State != BSP_INVERTER_STATE_FAULT))
+  {
+    return HAL_BUSY;
+  }
+
+  tim = hinv->htim->Instance;
+  __HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(hinv->htim);
+  __HAL_TIM_DISABLE_IT(hinv->htim, TIM_IT_BREAK);
+  tim->CCER &= ~INVERTER_CCER;
+  tim->CR1 &= ~TIM_CR1_CEN;
+  hinv->State = BSP_INVERTER_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write the duties of the three phases, loaded by the same update.
+  * @note   Waits up to UpdateGuard timer clocks with the interrupts disabled.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @param  Duty1 Compare of phase 1, 0 to Period.
+  * @param  Duty2 Compare of phase 2, 0 to Period.
+  * @param  Duty3 Compare of phase 3, 0 to Period.
+  * @retval None
+  */
+void BSP_INVERTER_SetDuty3(BSP_INVERTER_TypeDef *hinv, uint32_t Duty1, uint32_t Duty2, uint32_t Duty3)
+{
+  TIM_TypeDef *tim = hinv->htim->Instance;
+  uint32_t primask_bit;
+
+  Duty1 = (Duty1 > hinv->Period) ? hinv->Period : Duty1;
+  Duty2 = (Duty2 > hinv->Period) ? hinv->Period : Duty2;
+  Duty3 = (Duty3 > hinv->Period) ? hinv->Period : Duty3;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  /* The update is at 0 counting down, let it pass when it is that close */
+  while (((tim->CR1 & TIM_CR1_DIR) != 0U) && (tim->CNT <= hinv->UpdateGuard) &&
+         ((tim->CR1 & TIM_CR1_CEN) != 0U))
+  {
+  }
+  tim->CCR1 = Duty1;
+  tim->CCR2 = Duty2;
+  tim->CCR3 = Duty3;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Shut the outputs down from the software, as a break does.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval None
+  */
+void BSP_INVERTER_Trip(BSP_INVERTER_TypeDef *hinv)
+{
+  hinv->htim->Instance->EGR = TIM_EGR_BG;
+  hinv->State = BSP_INVERTER_STATE_FAULT;
+}
+
+/**
+  * @brief  Restart the outputs at 50 % after a break.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval HAL_OK, HAL_ERROR while BKIN is still active
+  */
+HAL_StatusTypeDef BSP_INVERTER_ClearFault(BSP_INVERTER_TypeDef *hinv)
+{
+  TIM_TypeDef *tim;
+
+  if (hinv->State != BSP_INVERTER_STATE_FAULT)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The flag is set again while the break input is active */
+  __HAL_TIM_CLEAR_FLAG(hinv->htim, TIM_FLAG_BREAK);
+  if (__HAL_TIM_GET_FLAG(hinv->htim, TIM_FLAG_BREAK) != RESET)
+  {
+    return HAL_ERROR;
+  }
+
+  tim = hinv->htim->Instance;
+  tim->CCR1 = hinv->Period / 2U;
+  tim->CCR2 = hinv->Period / 2U;
+  tim->CCR3 = hinv->Period / 2U;
+  __HAL_TIM_ENABLE_IT(hinv->htim, TIM_IT_BREAK);
+  __HAL_TIM_MOE_ENABLE(hinv->htim);
+  hinv->State = BSP_INVERTER_STATE_RUN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Break interrupt, the outputs are already off.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval None
+  */
+void BSP_INVERTER_BreakIRQHandler(BSP_INVERTER_TypeDef *hinv)
+{
+  if ((__HAL_TIM_GET_FLAG(hinv->htim, TIM_FLAG_BREAK) != RESET) &&
+      (__HAL_TIM_GET_IT_SOURCE(hinv->htim, TIM_IT_BREAK) != RESET))
+  {
+    /* Masked until BSP_INVERTER_ClearFault(), the flag stays while BKIN is active */
+    __HAL_TIM_DISABLE_IT(hinv->htim, TIM_IT_BREAK);
+    __HAL_TIM_CLEAR_FLAG(hinv->htim, TIM_FLAG_BREAK);
+    hinv->Faults++;
+    hinv->State = BSP_INVERTER_STATE_FAULT;
+    BSP_INVERTER_FaultCallback(hinv);
+  }
+}
+
+/**
+  * @brief  Fault callback, the outputs are off.
+  * @param  hinv Pointer to a BSP_INVERTER_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_INVERTER_FaultCallback(BSP_INVERTER_TypeDef *hinv)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hinv);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_INVERTER_FaultCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_INVERTER_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  DTG field of BDTR for a dead time.
+  * @param  Ticks Dead time in timer clocks, up to BSP_INVERTER_DEADTIME_MAX.
+  * @retval DTG, the dead time rounded up
+  */
+static uint32_t INVERTER_DeadTime(uint32_t Ticks)
+{
+  if (Ticks <= 127U)
+  {
+    return Ticks;
+  }
+  if (Ticks <= 254U)
+  {
+    /* (64 + DTG[5:0]) x 2 */
+    return 0x80U | (((Ticks + 1U) / 2U) - 64U);
+  }
+  if (Ticks <= 504U)
+  {
+    /* (32 + DTG[4:0]) x 8 */
+    return 0xC0U | (((Ticks + 7U) / 8U) - 32U);
+  }
+
+  /* (32 + DTG[4:0]) x 16 */
+  return 0xE0U | (((Ticks + 15U) / 16U) - 32U);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_irqprof.c
+  * @author  MCU Application Team
+  * @brief   Interrupt load profiler BSP service.
+  *          This file provides functions to measure every interrupt handler:
+  *           + One wrapper in the RAM vector table for SysTick and each IRQ
+  *           + Entries, total and max DWT cycles, the preempting handlers
+  *             excluded, and the preemption nesting of each vector
+  *           + Load of each vector and of all of them, printed periodically
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_VECT_TAB_RAM=y or USE_FLASH_RAMFUNC=y: the wrapper takes
+       the place of the handlers in the vector table copied to SRAM. Install
+       the run time handlers with HAL_NVIC_SetVector() before
+       BSP_IRQPROF_Init(), which otherwise returns HAL_ERROR. The handlers of
+       the processor exceptions other than SysTick are not wrapped: PendSV,
+       SVCall and the faults keep their stack frame.
+
+   (#) BSP_IRQPROF_Init() starts the cycle counter, keeps the handlers of
+       SysTick and of IRQn 0 to BSP_IRQPROF_IRQS - 1 and puts the wrapper in
+       their vectors. Each entry then costs some 40 cycles with the interrupts
+       masked twice for a few cycles, the handlers of the zero-latency tier
+       of HAL_CRITICAL_PRIORITY included. BSP_IRQPROF_DeInit() puts the
+       handlers back.
+
+   (#) A run of a handler is counted without the runs of the handlers
+       preempting it, so that the totals add up to the time of the CPU spent
+       in the interrupts. The nesting is the number of handlers a run
+       preempts. BSP_IRQPROF_GetStats() copies the statistics of a vector,
+       SysTick_IRQn or a device IRQn.
+
+   (#) BSP_IRQPROF_GetLoad() and BSP_IRQPROF_GetTotalLoad() give the share of
+       the CPU in per mille since BSP_IRQPROF_Init() or BSP_IRQPROF_Reset(),
+       from HAL_GetTick() and SystemCoreClock.
+
+   (#) BSP_IRQPROF_Print() prints the vectors entered with printf(), on the
+       UART of the buffered stdout service. Call BSP_IRQPROF_Process() in the
+       main loop for a print and a reset each PeriodMs of BSP_IRQPROF_Init(),
+       0 for none.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "py32f4xx_bsp_irqprof.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_IRQPROF BSP IRQPROF
+  * @brief Interrupt load profiler BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Private_Types BSP IRQPROF Private Types
+  * @{
+  */
+typedef void (*IRQPROF_HandlerTypeDef)(void);
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Private_Constants BSP IRQPROF Private Constants
+  * @{
+  */
+#define IRQPROF_IPSR_MASK               0x000001FFU    /* Exception number of IPSR */
+#define IRQPROF_SYSTICK_EXC             15U            /* Exception number of SysTick, index 0 */
+#define IRQPROF_CORE_VECTORS            16U            /* Words of the stack pointer and the exceptions */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Private_Variables BSP IRQPROF Private Variables
+  * @{
+  */
+extern const uint32_t _sisr_vector[];  /* Vector table in the FLASH, from the linker script */
+extern const uint32_t _eisr_vector[];
+
+static IRQPROF_HandlerTypeDef IRQPROF_Handlers[BSP_IRQPROF_VECTORS];
+static BSP_IRQPROF_StatsTypeDef IRQPROF_Stats[BSP_IRQPROF_VECTORS];
+static uint32_t IRQPROF_Vectors;       /* Vectors wrapped, 0 when not initialized */
+static uint32_t IRQPROF_Inner;         /* Cycles of the runs preempting the current one */
+static uint32_t IRQPROF_Depth;         /* Runs in progress */
+static uint32_t IRQPROF_WindowTick;    /* HAL_GetTick() of the reset */
+static uint32_t IRQPROF_PeriodMs;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Private_Functions BSP IRQPROF Private Functions
+  * @{
+  */
+static void IRQPROF_Handler(void);
+static uint32_t IRQPROF_Load(uint64_t Cycles);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_IRQPROF_Exported_Functions BSP IRQPROF Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Put the wrapper in the vectors of SysTick and of the device IRQs.
+  * @param  PeriodMs Period of the print of BSP_IRQPROF_Process(), 0 for none.
+  * @retval HAL status, HAL_BUSY when already initialized
+  */
+HAL_StatusTypeDef BSP_IRQPROF_Init(uint32_t PeriodMs)
+{
+  uint32_t vectors = (uint32_t)(_eisr_vector - _sisr_vector);
+  uint32_t primask_bit;
+  uint32_t i;
+
+  if (IRQPROF_Vectors != 0U)
+  {
+    return HAL_BUSY;
+  }
+  if ((SCB->VTOR < SRAM_BASE) || (vectors <= IRQPROF_CORE_VECTORS))
+  {
+    return HAL_ERROR;
+  }
+  vectors -= IRQPROF_CORE_VECTORS - 1U;
+  if (vectors > BSP_IRQPROF_VECTORS)
+  {
+    vectors = BSP_IRQPROF_VECTORS;
+  }
+
+  HAL_EnableCycleCounter();
+  IRQPROF_PeriodMs = PeriodMs;
+  BSP_IRQPROF_Reset();
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0U; i < vectors; i++)
+  {
+    IRQPROF_Handlers[i] = (IRQPROF_HandlerTypeDef)HAL_NVIC_GetVector((IRQn_Type)((int32_t)i - 1));
+    (void)HAL_NVIC_SetVector((IRQn_Type)((int32_t)i - 1), IRQPROF_Handler);
+  }
+  IRQPROF_Vectors = vectors;
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Put the handlers back in their vectors.
+  * @retval None
+  */
+void BSP_IRQPROF_DeInit(void)
+{
+  uint32_t primask_bit;
+  uint32_t i;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0U; i < IRQPROF_Vectors; i++)
+  {
+    (void)HAL_NVIC_SetVector((IRQn_Type)((int32_t)i - 1), IRQPROF_Handlers[i]);
+  }
+  IRQPROF_Vectors = 0U;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Copy the statistics of a vector.
+  * @param  IRQn SysTick_IRQn or a device IRQn below BSP_IRQPROF_IRQS.
+  * @param  pStats Statistics.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_IRQPROF_GetStats(IRQn_Type IRQn, BSP_IRQPROF_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+  uint32_t index = (uint32_t)((int32_t)IRQn + 1);
+
+  if ((pStats == NULL) || (IRQn < SysTick_IRQn) || (index >= BSP_IRQPROF_VECTORS))
+  {
+    return HAL_ERROR;
+  }
+
+  /* A consistent copy, the vector may be entered meanwhile */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = IRQPROF_Stats[index];
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Share of the CPU spent in a vector since the reset.
+  * @param  IRQn SysTick_IRQn or a device IRQn below BSP_IRQPROF_IRQS.
+  * @retval Load in per mille, 0 for a wrong IRQn
+  */
+uint32_t BSP_IRQPROF_GetLoad(IRQn_Type IRQn)
+{
+  BSP_IRQPROF_StatsTypeDef stats;
+
+  if (BSP_IRQPROF_GetStats(IRQn, &stats) != HAL_OK)
+  {
+    return 0U;
+  }
+
+  return IRQPROF_Load(stats.Total);
+}
+
+/**
+  * @brief  Share of the CPU spent in all the vectors since the reset.
+  * @retval Load in per mille
+  */
+uint32_t BSP_IRQPROF_GetTotalLoad(void)
+{
+  uint64_t total = 0U;
+  uint32_t primask_bit;
+  uint32_t i;
+
+  for (i = 0U; i < BSP_IRQPROF_VECTORS; i++)
+  {
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    total += IRQPROF_Stats[i].Total;
+    __set_PRIMASK(primask_bit);
+  }
+
+  return IRQPROF_Load(total);
+}
+
+/**
+  * @brief  Clear the statistics and start a new load window.
+  * @retval None
+  */
+void BSP_IRQPROF_Reset(void)
+{
+  uint32_t primask_bit;
+  uint32_t i;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0U; i < BSP_IRQPROF_VECTORS; i++)
+  {
+    IRQPROF_Stats[i].Count      = 0U;
+    IRQPROF_Stats[i].Max        = 0U;
+    IRQPROF_Stats[i].Total      = 0U;
+    IRQPROF_Stats[i].Preempted  = 0U;
+    IRQPROF_Stats[i].MaxNesting = 0U;
+  }
+  IRQPROF_WindowTick = HAL_GetTick();
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Print the statistics of the vectors entered with printf().
+  * @retval None
+  */
+void BSP_IRQPROF_Print(void)
+{
+  BSP_IRQPROF_StatsTypeDef stats;
+  uint32_t load;
+  uint32_t i;
+
+  for (i = 0U; i < BSP_IRQPROF_VECTORS; i++)
+  {
+    if ((BSP_IRQPROF_GetStats((IRQn_Type)((int32_t)i - 1), &stats) != HAL_OK) || (stats.Count == 0U))
+    {
+      continue;
+    }
+
+    load = IRQPROF_Load(stats.Total);
+    if (i == 0U)
+    {
+      printf("irq SysTick");
+    }
+    else
+    {
+      printf("irq %-7lu", (unsigned long)(i - 1U));
+    }
+    printf(" n %8lu mean %8lu max %8lu cycles, load %3lu.%lu %%, preempting %lu, nesting %lu\r\n",
+           (unsigned long)stats.Count, (unsigned long)(stats.Total / stats.Count), (unsigned long)stats.Max,
+           (unsigned long)(load / 10U), (unsigned long)(load % 10U), (unsigned long)stats.Preempted,
+           (unsigned long)stats.MaxNesting);
+  }
+
+  load = BSP_IRQPROF_GetTotalLoad();
+  printf("irq load %3lu.%lu %% in %lu ms\r\n", (unsigned long)(load / 10U), (unsigned long)(load % 10U),
+         (unsigned long)(HAL_GetTick() - IRQPROF_WindowTick));
+}
+
+/**
+  * @brief  Print and reset the statistics each PeriodMs, from the main loop.
+  * @retval None
+  */
+void BSP_IRQPROF_Process(void)
+{
+  if ((IRQPROF_PeriodMs != 0U) && ((HAL_GetTick() - IRQPROF_WindowTick) >= IRQPROF_PeriodMs))
+  {
+    BSP_IRQPROF_Print();
+    BSP_IRQPROF_Reset();
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_IRQPROF_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Wrapper of the handlers: runs the one of the active vector and
+  *         measures it.
+  * @note   In RAM with USE_FLASH_RAMFUNC, for the handlers marked __RAM_FUNC.
+  * @retval None
+  */
+static __FLASH_RAM_FUNC void IRQPROF_Handler(void)
+{
+  BSP_IRQPROF_StatsTypeDef *stats;
+  uint32_t index = (__get_IPSR() & IRQPROF_IPSR_MASK) - IRQPROF_SYSTICK_EXC;
+  uint32_t primask_bit;
+  uint32_t outer;
+  uint32_t depth;
+  uint32_t start;
+  uint32_t run;
+  uint32_t self;
+
+  /* The runs preempting this one are counted from here */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  outer = IRQPROF_Inner;
+  depth = IRQPROF_Depth;
+  IRQPROF_Inner = 0U;
+  IRQPROF_Depth = depth + 1U;
+  start = DWT->CYCCNT;
+  __set_PRIMASK(primask_bit);
+
+  IRQPROF_Handlers[index]();
+
+  __disable_irq();
+  run = DWT->CYCCNT - start;
+  self = run - IRQPROF_Inner;
+  IRQPROF_Inner = outer + run;
+  IRQPROF_Depth = depth;
+
+  stats = &IRQPROF_Stats[index];
+  stats->Count++;
+  stats->Total += self;
+  if (self > stats->Max)
+  {
+    stats->Max = self;
+  }
+  if (depth != 0U)
+  {
+    stats->Preempted++;
+    if (depth > stats->MaxNesting)
+    {
+      stats->MaxNesting = depth;
+    }
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Per mille of the CPU of cycles since the reset.
+  * @param  Cycles Cycles.
+  * @retval Load in per mille
+  */
+static uint32_t IRQPROF_Load(uint64_t Cycles)
+{
+  uint64_t window = (uint64_t)(HAL_GetTick() - IRQPROF_WindowTick) * (SystemCoreClock / 1000U);
+
+  if (window == 0U)
+  {
+    return 0U;
+  }
+
+  return (uint32_t)((Cycles * 1000U) / window);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,784 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_isotp.c
+  * @author  MCU Application Team
+  * @brief   ISO-TP (ISO 15765-2) transport BSP service.
+  *          This file provides functions to send and receive messages longer
+  *          than a CANFD frame:
+  *           + Single, first, consecutive and flow control frames
+  *           + Classic frames of 8 bytes or FD frames of 64 bytes
+  *           + Messages up to 4095 bytes, longer ones with the escape length
+  *           + Block size and STmin, N_Bs and N_Cr timeouts on the timer wheel
+  *           + Several sessions at the same time
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The service sends its frames through the transmit scheduler
+       BSP_CANTX, takes its frames from the receive queue BSP_CANRX and its
+       timings from the timer wheel BSP_TIMWHEEL. Start the three of them
+       first.
+
+   (#) Describe each session in a BSP_ISOTP_SessionTypeDef: its transmit
+       and receive identifiers, classic or FD frames, the BS and STmin
+       given to the sender in the flow control, and the receive buffer.
+       Then call BSP_ISOTP_Init() with the array of the sessions, the
+       transmit queue priority of their frames and the ticks of the timer
+       wheel in a millisecond.
+
+   (#) BSP_ISOTP_Send() starts a message, the data kept by the caller until
+       BSP_ISOTP_TxCpltCallback(): HAL_BUSY when the session is already
+       sending or the transmit queue is full. The consecutive frames are
+       queued as fast as the receiver allows: with STmin 0 as many as the
+       transmit queue takes at once, the remaining ones retried on the next
+       tick, else one per STmin. The callback comes when the last frame is
+       queued.
+
+   (#) Give each frame of the receive queue to BSP_ISOTP_Input(): 1 when
+       the frame belongs to a session, release it then. A message received
+       is given by BSP_ISOTP_RxCpltCallback() from the receive buffer of the
+       session: handle or copy it there, the next message overwrites it.
+
+   (#) Call BSP_ISOTP_Input() and BSP_ISOTP_Send() from the thread context
+       or the interrupt of the timer wheel. The state machine runs with the
+       interrupts masked, the callbacks after the mask is restored.
+
+   (#) BSP_ISOTP_Abort() stops the messages of a session, the callbacks
+       called with BSP_ISOTP_RESULT_ABORTED.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_isotp.h"
+#include <string.h>
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_ISOTP BSP ISOTP
+  * @brief ISO-TP transport BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_ISOTP_Private_Constants BSP ISOTP Private Constants
+  * @{
+  */
+#define ISOTP_PCI_SF                    0x00U          /* Single frame */
+#define ISOTP_PCI_FF                    0x10U          /* First frame */
+#define ISOTP_PCI_CF                    0x20U          /* Consecutive frame */
+#define ISOTP_PCI_FC                    0x30U          /* Flow control */
+
+#define ISOTP_FS_CTS                    0x00U          /* Continue to send */
+#define ISOTP_FS_WAIT                   0x01U
+#define ISOTP_FS_OVFLW                  0x02U
+
+#define ISOTP_FF_DL_MAX                 0xFFFU         /* Longest message without the escape length */
+#define ISOTP_RESULT_NONE               0xFFFFFFFFU    /* No callback */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_ISOTP_Private_Variables BSP ISOTP Private Variables
+  * @{
+  */
+static const uint8_t ISOTP_DlcBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_ISOTP_Private_Functions BSP ISOTP Private Functions
+  * @{
+  */
+static uint32_t ISOTP_Dl(const BSP_ISOTP_SessionTypeDef *psession);
+static HAL_StatusTypeDef ISOTP_Frame(BSP_ISOTP_SessionTypeDef *psession, uint8_t *pFrame, uint32_t Length);
+static void ISOTP_FlowControl(BSP_ISOTP_SessionTypeDef *psession, uint32_t FlowStatus);
+static void ISOTP_Arm(BSP_ISOTP_SessionTypeDef *psession, BSP_TIMWHEEL_TimerTypeDef *pTimer, uint32_t Ticks);
+static uint32_t ISOTP_Gap(const BSP_ISOTP_TypeDef *hisotp, uint32_t STmin);
+static uint32_t ISOTP_TxRun(BSP_ISOTP_SessionTypeDef *psession);
+static void ISOTP_TxTimer(BSP_TIMWHEEL_TimerTypeDef *pTimer);
+static void ISOTP_RxTimer(BSP_TIMWHEEL_TimerTypeDef *pTimer);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_ISOTP_Exported_Functions BSP ISOTP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the ISO-TP transport and its sessions.
+  * @param  hisotp Pointer to a BSP_ISOTP_TypeDef structure.
+  * @param  htx Transmit scheduler.
+  * @param  hwheel Timer wheel.
+  * @param  Priority Queue of the frames sent, a value of @ref BSP_CANTX_Priority.
+  * @param  TicksPerMs Ticks of the timer wheel per millisecond.
+  * @param  pSessions Sessions, their configuration fields set.
+  * @param  NbrOfSessions Sessions.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_ISOTP_Init(BSP_ISOTP_TypeDef *hisotp, BSP_CANTX_TypeDef *htx, BSP_TIMWHEEL_TypeDef *hwheel,
+                                 uint32_t Priority, uint32_t TicksPerMs,
+                                 BSP_ISOTP_SessionTypeDef *pSessions, uint32_t NbrOfSessions)
+{
+  BSP_ISOTP_SessionTypeDef *psession;
+  uint32_t i;
+
+  if ((hisotp == NULL) || (htx == NULL) || (hwheel == NULL) || (Priority >= BSP_CANTX_PRIORITIES) ||
+      (TicksPerMs == 0U) || ((BSP_ISOTP_TIMEOUT_MS * TicksPerMs) > BSP_TIMWHEEL_DELAY_MAX) ||
+      (pSessions == NULL) || (NbrOfSessions == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < NbrOfSessions; i++)
+  {
+    psession = &pSessions[i];
+    if ((psession->BlockSize > 0xFFU) || (psession->STmin > 0xFFU) ||
+        ((psession->pRxBuffer == NULL) && (psession->RxBufferSize != 0U)))
+    {
+      return HAL_ERROR;
+    }
+    if ((psession->TxState != BSP_ISOTP_STATE_IDLE) || (psession->RxState != BSP_ISOTP_STATE_IDLE))
+    {
+      return HAL_BUSY;
+    }
+  }
+
+  hisotp->htx           = htx;
+  hisotp->hwheel        = hwheel;
+  hisotp->Priority      = Priority;
+  hisotp->TicksPerMs    = TicksPerMs;
+  hisotp->pSessions     = pSessions;
+  hisotp->NbrOfSessions = NbrOfSessions;
+
+  for (i = 0U; i < NbrOfSessions; i++)
+  {
+    psession = &pSessions[i];
+    psession->hisotp  = hisotp;
+    psession->TxState = BSP_ISOTP_STATE_IDLE;
+    psession->RxState = BSP_ISOTP_STATE_IDLE;
+    BSP_TIMWHEEL_TimerInit(&psession->TxTimer, ISOTP_TxTimer, psession);
+    BSP_TIMWHEEL_TimerInit(&psession->RxTimer, ISOTP_RxTimer, psession);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start sending a message.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  pData Message, kept until BSP_ISOTP_TxCpltCallback().
+  * @param  Length Bytes of the message.
+  * @retval HAL status, HAL_BUSY when sending or the transmit queue is full
+  */
+HAL_StatusTypeDef BSP_ISOTP_Send(BSP_ISOTP_SessionTypeDef *psession, const uint8_t *pData, uint32_t Length)
+{
+  HAL_StatusTypeDef status;
+  uint8_t frame[64];
+  uint32_t primask_bit;
+  uint32_t dl;
+  uint32_t offset;
+  uint32_t size;
+
+  if ((psession == NULL) || (psession->hisotp == NULL) || (pData == NULL) || (Length == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  dl = ISOTP_Dl(psession);
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (psession->TxState != BSP_ISOTP_STATE_IDLE)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_BUSY;
+  }
+
+  if (Length <= (dl - ((dl > 8U) ? 2U : 1U)))
+  {
+    /* Single frame, the escape length past 7 bytes */
+    if (Length <= 7U)
+    {
+      frame[0] = (uint8_t)(ISOTP_PCI_SF | Length);
+      offset = 1U;
+    }
+    else
+    {
+      frame[0] = ISOTP_PCI_SF;
+      frame[1] = (uint8_t)Length;
+      offset = 2U;
+    }
+    memcpy(&frame[offset], pData, Length);
+    status = ISOTP_Frame(psession, frame, offset + Length);
+    __set_PRIMASK(primask_bit);
+
+    if (status == HAL_OK)
+    {
+      BSP_ISOTP_TxCpltCallback(psession, BSP_ISOTP_RESULT_OK);
+    }
+    return status;
+  }
+
+  /* First frame, the escape length past 4095 bytes */
+  if (Length <= ISOTP_FF_DL_MAX)
+  {
+    frame[0] = (uint8_t)(ISOTP_PCI_FF | (Length >> 8));
+    frame[1] = (uint8_t)Length;
+    offset = 2U;
+  }
+  else
+  {
+    frame[0] = ISOTP_PCI_FF;
+    frame[1] = 0U;
+    frame[2] = (uint8_t)(Length >> 24);
+    frame[3] = (uint8_t)(Length >> 16);
+    frame[4] = (uint8_t)(Length >> 8);
+    frame[5] = (uint8_t)Length;
+    offset = 6U;
+  }
+  size = dl - offset;
+  memcpy(&frame[offset], pData, size);
+  status = ISOTP_Frame(psession, frame, dl);
+  if (status == HAL_OK)
+  {
+    psession->pTxData  = pData;
+    psession->TxLength = Length;
+    psession->TxOffset = size;
+    psession->TxSn     = 1U;
+    psession->TxState  = BSP_ISOTP_STATE_WAIT_FC;
+    ISOTP_Arm(psession, &psession->TxTimer, BSP_ISOTP_TIMEOUT_MS * psession->hisotp->TicksPerMs);
+  }
+  __set_PRIMASK(primask_bit);
+
+  return status;
+}
+
+/**
+  * @brief  Process a received frame.
+  * @param  hisotp Pointer to a BSP_ISOTP_TypeDef structure.
+  * @param  pFrame Frame of the receive queue.
+  * @retval 1 when the frame belongs to a session, else 0
+  */
+uint32_t BSP_ISOTP_Input(BSP_ISOTP_TypeDef *hisotp, const BSP_CANRX_FrameTypeDef *pFrame)
+{
+  BSP_ISOTP_SessionTypeDef *psession = NULL;
+  const uint8_t *data;
+  uint32_t tx_result = ISOTP_RESULT_NONE;
+  uint32_t rx_result = ISOTP_RESULT_NONE;
+  uint32_t prev_result = ISOTP_RESULT_NONE;
+  uint32_t rx_length = 0U;
+  uint32_t prev_length = 0U;
+  uint32_t primask_bit;
+  uint32_t id_type;
+  uint32_t length;
+  uint32_t offset;
+  uint32_t size;
+  uint32_t i;
+
+  if (BSP_CANRX_IS_REMOTE(pFrame))
+  {
+    return 0U;
+  }
+
+  id_type = BSP_CANRX_IS_EXTENDED(pFrame) ? CANFD_EXTENDED_ID : CANFD_STANDARD_ID;
+  for (i = 0U; i < hisotp->NbrOfSessions; i++)
+  {
+    if ((hisotp->pSessions[i].RxId == BSP_CANRX_GET_ID(pFrame)) && (hisotp->pSessions[i].IdType == id_type))
+    {
+      psession = &hisotp->pSessions[i];
+      break;
+    }
+  }
+  if (psession == NULL)
+  {
+    return 0U;
+  }
+
+  data = BSP_CANRX_GET_DATA(pFrame);
+  length = BSP_CANRX_GET_LENGTH(pFrame);
+  if (length == 0U)
+  {
+    return 1U;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  switch (data[0] & 0xF0U)
+  {
+    case ISOTP_PCI_SF:
+    case ISOTP_PCI_FF:
+      if ((data[0] & 0xF0U) == ISOTP_PCI_SF)
+      {
+        size = data[0] & 0x0FU;
+        offset = 1U;
+        if ((size == 0U) && (length > 8U))
+        {
+          size = data[1];
+          offset = 2U;
+        }
+        if ((size == 0U) || (size > (length - offset)))
+        {
+          break;
+        }
+      }
+      else
+      {
+        if (length < 8U)
+        {
+          break;
+        }
+        size = ((data[0] & 0x0FU) << 8) | data[1];
+        offset = 2U;
+        if (size == 0U)
+        {
+          size = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+          offset = 6U;
+        }
+        if (size <= (length - offset))
+        {
+          break;
+        }
+      }
+
+      /* A new message ends the one being received */
+      if (psession->RxState == BSP_ISOTP_STATE_RECEIVE)
+      {
+        psession->RxState = BSP_ISOTP_STATE_IDLE;
+        BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->RxTimer);
+        prev_result = BSP_ISOTP_RESULT_UNEXPECTED;
+        prev_length = psession->RxOffset;
+      }
+
+      rx_length = size;
+      if (size > psession->RxBufferSize)
+      {
+        if ((data[0] & 0xF0U) == ISOTP_PCI_FF)
+        {
+          ISOTP_FlowControl(psession, ISOTP_FS_OVFLW);
+        }
+        rx_result = BSP_ISOTP_RESULT_OVERFLOW;
+      }
+      else if ((data[0] & 0xF0U) == ISOTP_PCI_SF)
+      {
+        memcpy(psession->pRxBuffer, &data[offset], size);
+        rx_result = BSP_ISOTP_RESULT_OK;
+      }
+      else
+      {
+        memcpy(psession->pRxBuffer, &data[offset], length - offset);
+        psession->RxLength = size;
+        psession->RxOffset = length - offset;
+        psession->RxSn     = 1U;
+        psession->RxBlock  = psession->BlockSize;
+        psession->RxState  = BSP_ISOTP_STATE_RECEIVE;
+        ISOTP_FlowControl(psession, ISOTP_FS_CTS);
+        ISOTP_Arm(psession, &psession->RxTimer, BSP_ISOTP_TIMEOUT_MS * hisotp->TicksPerMs);
+      }
+      break;
+
+    case ISOTP_PCI_CF:
+      if (psession->RxState != BSP_ISOTP_STATE_RECEIVE)
+      {
+        break;
+      }
+      if ((data[0] & 0x0FU) != (psession->RxSn & 0x0FU))
+      {
+        psession->RxState = BSP_ISOTP_STATE_IDLE;
+        BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->RxTimer);
+        rx_result = BSP_ISOTP_RESULT_WRONG_SN;
+        rx_length = psession->RxOffset;
+        break;
+      }
+      size = psession->RxLength - psession->RxOffset;
+      if (size > (length - 1U))
+      {
+        size = length - 1U;
+      }
+      memcpy(&psession->pRxBuffer[psession->RxOffset], &data[1], size);
+      psession->RxOffset += size;
+      psession->RxSn++;
+      if (psession->RxOffset >= psession->RxLength)
+      {
+        psession->RxState = BSP_ISOTP_STATE_IDLE;
+        BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->RxTimer);
+        rx_result = BSP_ISOTP_RESULT_OK;
+        rx_length = psession->RxLength;
+        break;
+      }
+      if ((psession->BlockSize != 0U) && (--psession->RxBlock == 0U))
+      {
+        psession->RxBlock = psession->BlockSize;
+        ISOTP_FlowControl(psession, ISOTP_FS_CTS);
+      }
+      ISOTP_Arm(psession, &psession->RxTimer, BSP_ISOTP_TIMEOUT_MS * hisotp->TicksPerMs);
+      break;
+
+    case ISOTP_PCI_FC:
+      if ((psession->TxState != BSP_ISOTP_STATE_WAIT_FC) || (length < 3U))
+      {
+        break;
+      }
+      switch (data[0] & 0x0FU)
+      {
+        case ISOTP_FS_CTS:
+          psession->TxBs    = data[1];
+          psession->TxBlock = data[1];
+          psession->TxGap   = ISOTP_Gap(hisotp, data[2]);
+          psession->TxState = BSP_ISOTP_STATE_SEND;
+          tx_result = ISOTP_TxRun(psession);
+          break;
+
+        case ISOTP_FS_WAIT:
+          ISOTP_Arm(psession, &psession->TxTimer, BSP_ISOTP_TIMEOUT_MS * hisotp->TicksPerMs);
+          break;
+
+        default:
+          psession->TxState = BSP_ISOTP_STATE_IDLE;
+          BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->TxTimer);
+          tx_result = ((data[0] & 0x0FU) == ISOTP_FS_OVFLW) ? BSP_ISOTP_RESULT_OVERFLOW : BSP_ISOTP_RESULT_UNEXPECTED;
+          break;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  if (prev_result != ISOTP_RESULT_NONE)
+  {
+    BSP_ISOTP_RxCpltCallback(psession, prev_result, prev_length);
+  }
+  if (rx_result != ISOTP_RESULT_NONE)
+  {
+    BSP_ISOTP_RxCpltCallback(psession, rx_result, rx_length);
+  }
+  if (tx_result != ISOTP_RESULT_NONE)
+  {
+    BSP_ISOTP_TxCpltCallback(psession, tx_result);
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Stop the messages of a session.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @retval None
+  */
+void BSP_ISOTP_Abort(BSP_ISOTP_SessionTypeDef *psession)
+{
+  BSP_ISOTP_TypeDef *hisotp = psession->hisotp;
+  uint32_t primask_bit;
+  uint32_t tx;
+  uint32_t rx;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  tx = psession->TxState;
+  rx = psession->RxState;
+  psession->TxState = BSP_ISOTP_STATE_IDLE;
+  psession->RxState = BSP_ISOTP_STATE_IDLE;
+  BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->TxTimer);
+  BSP_TIMWHEEL_TimerStop(hisotp->hwheel, &psession->RxTimer);
+  __set_PRIMASK(primask_bit);
+
+  if (tx != BSP_ISOTP_STATE_IDLE)
+  {
+    BSP_ISOTP_TxCpltCallback(psession, BSP_ISOTP_RESULT_ABORTED);
+  }
+  if (rx != BSP_ISOTP_STATE_IDLE)
+  {
+    BSP_ISOTP_RxCpltCallback(psession, BSP_ISOTP_RESULT_ABORTED, psession->RxOffset);
+  }
+}
+
+/**
+  * @brief  Message sent callback.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  Result A value of @ref BSP_ISOTP_Result.
+  * @retval None
+  */
+__weak void BSP_ISOTP_TxCpltCallback(BSP_ISOTP_SessionTypeDef *psession, uint32_t Result)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(psession);
+  UNUSED(Result);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ISOTP_TxCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Message received callback.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  Result A value of @ref BSP_ISOTP_Result.
+  * @param  Length Bytes in the receive buffer, the message length on success.
+  * @retval None
+  */
+__weak void BSP_ISOTP_RxCpltCallback(BSP_ISOTP_SessionTypeDef *psession, uint32_t Result, uint32_t Length)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(psession);
+  UNUSED(Result);
+  UNUSED(Length);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_ISOTP_RxCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_ISOTP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Largest frame of a session.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @retval 8 for classic frames, 64 for FD frames
+  */
+static uint32_t ISOTP_Dl(const BSP_ISOTP_SessionTypeDef *psession)
+{
+  return (psession->FrameFormat == CANFD_FRAME_CLASSIC) ? 8U : 64U;
+}
+
+/**
+  * @brief  Queue a frame, padded to a valid length.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  pFrame Frame, room for the padding.
+  * @param  Length Bytes of the frame.
+  * @retval HAL status of BSP_CANTX_Send()
+  */
+static HAL_StatusTypeDef ISOTP_Frame(BSP_ISOTP_SessionTypeDef *psession, uint8_t *pFrame, uint32_t Length)
+{
+  CANFD_TxHeaderTypeDef header;
+  uint32_t dlc = CANFD_DLC_BYTES_8;
+
+  if (psession->FrameFormat != CANFD_FRAME_CLASSIC)
+  {
+    for (dlc = 0U; ISOTP_DlcBytes[dlc] < Length; dlc++)
+    {
+    }
+  }
+  while (Length < ISOTP_DlcBytes[dlc])
+  {
+    pFrame[Length++] = BSP_ISOTP_PADDING;
+  }
+
+  header.Identifier  = psession->TxId;
+  header.IdType      = psession->IdType;
+  header.TxFrameType = CANFD_DATA_FRAME;
+  header.FrameFormat = psession->FrameFormat;
+  header.Handle      = 0U;
+  header.DataLength  = dlc;
+
+  return BSP_CANTX_Send(psession->hisotp->htx, psession->hisotp->Priority, &header, pFrame);
+}
+
+/**
+  * @brief  Queue a flow control frame.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  FlowStatus Flow status.
+  * @retval None
+  */
+static void ISOTP_FlowControl(BSP_ISOTP_SessionTypeDef *psession, uint32_t FlowStatus)
+{
+  uint8_t frame[8];
+
+  frame[0] = (uint8_t)(ISOTP_PCI_FC | FlowStatus);
+  frame[1] = (uint8_t)psession->BlockSize;
+  frame[2] = (uint8_t)psession->STmin;
+  (void)ISOTP_Frame(psession, frame, 3U);
+}
+
+/**
+  * @brief  Arm a one-shot timer of a session.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @param  pTimer Timer of the session.
+  * @param  Ticks Delay.
+  * @retval None
+  */
+static void ISOTP_Arm(BSP_ISOTP_SessionTypeDef *psession, BSP_TIMWHEEL_TimerTypeDef *pTimer, uint32_t Ticks)
+{
+  (void)BSP_TIMWHEEL_TimerStart(psession->hisotp->hwheel, pTimer, Ticks, 0U);
+}
+
+/**
+  * @brief  Ticks of a STmin.
+  * @param  hisotp Pointer to a BSP_ISOTP_TypeDef structure.
+  * @param  STmin 0 to 127 ms, 0xF1 to 0xF9 for 100 to 900 us, else 127 ms.
+  * @retval Ticks, rounded up
+  */
+static uint32_t ISOTP_Gap(const BSP_ISOTP_TypeDef *hisotp, uint32_t STmin)
+{
+  if (STmin <= 0x7FU)
+  {
+    return STmin * hisotp->TicksPerMs;
+  }
+  if ((STmin >= 0xF1U) && (STmin <= 0xF9U))
+  {
+    return (((STmin - 0xF0U) * 100U * hisotp->TicksPerMs) + 999U) / 1000U;
+  }
+
+  return 0x7FU * hisotp->TicksPerMs;
+}
+
+/**
+  * @brief  Queue the consecutive frames the receiver allows, interrupts masked.
+  * @param  psession Pointer to a BSP_ISOTP_SessionTypeDef structure.
+  * @retval A value of @ref BSP_ISOTP_Result when the message ends, else ISOTP_RESULT_NONE
+  */
+static uint32_t ISOTP_TxRun(BSP_ISOTP_SessionTypeDef *psession)
+{
+  uint32_t ticks = BSP_ISOTP_TIMEOUT_MS * psession->hisotp->TicksPerMs;
+  uint8_t frame[64];
+  uint32_t size;
+
+  for (;;)
+  {
+    if (psession->TxOffset >= psession->TxLength)
+    {
+      psession->TxState = BSP_ISOTP_STATE_IDLE;
+      BSP_TIMWHEEL_TimerStop(psession->hisotp->hwheel, &psession->TxTimer);
+      return BSP_ISOTP_RESULT_OK;
+    }
+    if ((psession->TxBs != 0U) && (psession->TxBlock == 0U))
+    {
+      psession->TxState = BSP_ISOTP_STATE_WAIT_FC;
+      ISOTP_Arm(psession, &psession->TxTimer, ticks);
+      return ISOTP_RESULT_NONE;
+    }
+
+    size = psession->TxLength - psession->TxOffset;
+    if (size > (ISOTP_Dl(psession) - 1U))
+    {
+      size = ISOTP_Dl(psession) - 1U;
+    }
+    frame[0] = (uint8_t)(ISOTP_PCI_CF | (psession->TxSn & 0x0FU));
+    memcpy(&frame[1], &psession->pTxData[psession->TxOffset], size);
+    if (ISOTP_Frame(psession, frame, size + 1U) != HAL_OK)
+    {
+      /* Transmit queue full, retried on the next tick */
+      ISOTP_Arm(psession, &psession->TxTimer, 1U);
+      return ISOTP_RESULT_NONE;
+    }
+    psession->TxOffset += size;
+    psession->TxSn++;
+    if (psession->TxBs != 0U)
+    {
+      psession->TxBlock--;
+    }
+
+    if ((psession->TxGap != 0U) && (psession->TxOffset < psession->TxLength) &&
+        ((psession->TxBs == 0U) || (psession->TxBlock != 0U)))
+    {
+      ISOTP_Arm(psession, &psession->TxTimer, psession->TxGap);
+      return ISOTP_RESULT_NONE;
+    }
+  }
+}
+
+/**
+  * @brief  Transmit timer expiry: N_Bs timeout, STmin or a retry.
+  * @param  pTimer Timer of the session.
+  * @retval None
+  */
+static void ISOTP_TxTimer(BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  BSP_ISOTP_SessionTypeDef *psession = (BSP_ISOTP_SessionTypeDef *)pTimer->pContext;
+  uint32_t result = ISOTP_RESULT_NONE;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (psession->TxState == BSP_ISOTP_STATE_WAIT_FC)
+  {
+    psession->TxState = BSP_ISOTP_STATE_IDLE;
+    result = BSP_ISOTP_RESULT_TIMEOUT;
+  }
+  else if (psession->TxState == BSP_ISOTP_STATE_SEND)
+  {
+    result = ISOTP_TxRun(psession);
+  }
+  __set_PRIMASK(primask_bit);
+
+  if (result != ISOTP_RESULT_NONE)
+  {
+    BSP_ISOTP_TxCpltCallback(psession, result);
+  }
+}
+
+/**
+  * @brief  Receive timer expiry: N_Cr timeout.
+  * @param  pTimer Timer of the session.
+  * @retval None
+  */
+static void ISOTP_RxTimer(BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  BSP_ISOTP_SessionTypeDef *psession = (BSP_ISOTP_SessionTypeDef *)pTimer->pContext;
+  uint32_t timeout = 0U;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (psession->RxState == BSP_ISOTP_STATE_RECEIVE)
+  {
+    psession->RxState = BSP_ISOTP_STATE_IDLE;
+    timeout = 1U;
+  }
+  __set_PRIMASK(primask_bit);
+
+  if (timeout != 0U)
+  {
+    BSP_ISOTP_RxCpltCallback(psession, BSP_ISOTP_RESULT_TIMEOUT, psession->RxOffset);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1234 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_kvstore.c
+  * @author  MCU Application Team
+  * @brief   External flash key-value store BSP service.
+  *          This file provides functions to keep small values in a serial NOR
+  *          flash without rewriting them in place:
+  *           + Append-only records protected by the CRC peripheral
+  *           + Hash index in RAM rebuilt at mount
+  *           + Sector compaction from the main loop
+  *           + Block device backed by the SPI or the ESMC flash services
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the CRC with HAL_CRC_Init(), the default CRC-32 is used.
+
+   (#) Describe the flash area of the store with BSP_KVSTORE_LinkSPIFLASH() on
+       a BSP_SPIFLASH handle, with BSP_KVSTORE_LinkESMCFLASH() on a
+       BSP_ESMCFLASH handle whose tick runs from a timer, or fill a
+       BSP_KVSTORE_BlockTypeDef for another memory. The area takes SectorCount
+       erase sectors from Base, at least 2.
+
+   (#) Call BSP_KVSTORE_Mount(): every sector is scanned in write order and
+       the key of each valid record is indexed with its address. A record
+       failing its CRC, for instance cut by a reset, ends the scan of its
+       sector, which is not appended to anymore. BSP_KVSTORE_Format() erases
+       the area and mounts it empty.
+
+   (#) A key is a 32-bit number other than BSP_KVSTORE_KEY_NONE:
+       (+) BSP_KVSTORE_GetLength() returns the value length from the index.
+       (+) BSP_KVSTORE_Get() reads the record from its indexed address and
+           checks its CRC: one lookup and one read whatever the store size.
+       (+) BSP_KVSTORE_Set() appends a new record, the previous one becomes
+           dead. BSP_KVSTORE_Delete() appends a deletion record.
+
+   (#) A record is a 12 bytes header (key, length and type, CRC) followed by
+       the value padded to 4 bytes. The sectors are filled one after the
+       other; a full store is compacted from its oldest sector: the indexed
+       records are copied to the head and the sector is erased. One erased
+       sector is kept for this copy.
+
+   (#) Call BSP_KVSTORE_Process() from the main loop: it compacts one sector
+       when BSP_KVSTORE_GC_FREE sectors or less are left and some records are
+       dead, so BSP_KVSTORE_Set() seldom waits for an erase.
+
+   (#) The functions are blocking and must not be called from interrupts.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_kvstore.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_KVSTORE BSP KVSTORE
+  * @brief External flash key-value store BSP service
+  * @{
+  */
+
+#ifdef HAL_CRC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Private_Types BSP KVSTORE Private Types
+  * @{
+  */
+/* Record header in the flash */
+typedef struct
+{
+  uint32_t Key;
+  uint32_t Info;                        /* Length in bits 0 to 15, type in bits 16 to 31 */
+  uint32_t Crc;                         /* CRC of Key, Info and the padded value         */
+} KVSTORE_RecordTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Private_Constants BSP KVSTORE Private Constants
+  * @{
+  */
+#define KVSTORE_MAGIC                   0x3153564BU    /* "KVS1", first word of a sector            */
+#define KVSTORE_SECTOR_HEADER           8U             /* Magic and sequence                        */
+#define KVSTORE_RECORD_HEADER           12U            /* sizeof(KVSTORE_RecordTypeDef)             */
+#define KVSTORE_TYPE_VALUE              0xA55AU
+#define KVSTORE_TYPE_DELETE             0x5AA5U
+#define KVSTORE_CHUNK_WORDS             8U             /* Copy and CRC buffer                       */
+#define KVSTORE_NONE                    BSP_KVSTORE_SECTORS_MAX
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Private_Macros BSP KVSTORE Private Macros
+  * @{
+  */
+#define KVSTORE_RECORD_SIZE(__LENGTH__) (KVSTORE_RECORD_HEADER + (((__LENGTH__) + 3U) & ~3U))
+#define KVSTORE_SECTOR_ADDRESS(__HKV__, __SECTOR__) \
+  ((__HKV__)->pBlock->Base + ((__SECTOR__) * (__HKV__)->pBlock->SectorSize))
+#define KVSTORE_SECTOR_OF(__HKV__, __ADDRESS__) \
+  (((__ADDRESS__) - (__HKV__)->pBlock->Base) / (__HKV__)->pBlock->SectorSize)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_KVSTORE_Private_Functions
+  * @{
+  */
+static uint32_t KVSTORE_Hash(uint32_t Key);
+static BSP_KVSTORE_EntryTypeDef *KVSTORE_Find(const BSP_KVSTORE_TypeDef *hkv, uint32_t Key);
+static HAL_StatusTypeDef KVSTORE_IndexSet(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint32_t Address,
+                                          uint32_t Length);
+static void KVSTORE_IndexDelete(BSP_KVSTORE_TypeDef *hkv, uint32_t Key);
+static uint32_t KVSTORE_Crc(BSP_KVSTORE_TypeDef *hkv, const KVSTORE_RecordTypeDef *pRecord,
+                            const uint8_t *pData);
+static HAL_StatusTypeDef KVSTORE_ReadValue(BSP_KVSTORE_TypeDef *hkv, uint32_t Address,
+                                           const KVSTORE_RecordTypeDef *pRecord, uint8_t *pData);
+static uint32_t KVSTORE_IsRecord(const BSP_KVSTORE_TypeDef *hkv, const KVSTORE_RecordTypeDef *pRecord,
+                                 uint32_t Offset);
+static HAL_StatusTypeDef KVSTORE_Scan(BSP_KVSTORE_TypeDef *hkv, uint32_t Sector);
+static HAL_StatusTypeDef KVSTORE_Allocate(BSP_KVSTORE_TypeDef *hkv, uint32_t Size, uint32_t *pAddress);
+static void KVSTORE_Close(BSP_KVSTORE_TypeDef *hkv);
+static HAL_StatusTypeDef KVSTORE_Reserve(BSP_KVSTORE_TypeDef *hkv, uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_Append(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint32_t Type,
+                                        const uint8_t *pData, uint32_t Length);
+static uint32_t KVSTORE_IsDirty(const BSP_KVSTORE_TypeDef *hkv);
+static HAL_StatusTypeDef KVSTORE_Compact(BSP_KVSTORE_TypeDef *hkv);
+static HAL_StatusTypeDef KVSTORE_Sync(const BSP_KVSTORE_TypeDef *hkv);
+#ifdef HAL_SPI_MODULE_ENABLED
+static HAL_StatusTypeDef KVSTORE_SpiflashRead(void *pContext, uint32_t Address, uint8_t *pData, uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_SpiflashWrite(void *pContext, uint32_t Address, const uint8_t *pData,
+                                               uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_SpiflashErase(void *pContext, uint32_t Address, uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_SpiflashSync(void *pContext);
+#endif /* HAL_SPI_MODULE_ENABLED */
+#ifdef HAL_ESMC_MODULE_ENABLED
+static HAL_StatusTypeDef KVSTORE_EsmcflashRead(void *pContext, uint32_t Address, uint8_t *pData, uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_EsmcflashWrite(void *pContext, uint32_t Address, const uint8_t *pData,
+                                                uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_EsmcflashErase(void *pContext, uint32_t Address, uint32_t Size);
+static HAL_StatusTypeDef KVSTORE_EsmcflashWait(BSP_ESMCFLASH_TypeDef *hflash);
+#endif /* HAL_ESMC_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_KVSTORE_Exported_Functions BSP KVSTORE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_KVSTORE_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Back the block device with a flash service
+      (+) Mount or format a store
+
+@endverbatim
+  * @{
+  */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+  * @brief  Back a block device with a SPI flash.
+  * @param  pBlock Pointer to a BSP_KVSTORE_BlockTypeDef structure.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure initialized.
+  * @param  Base First address, aligned on the erase size of the flash.
+  * @param  SectorCount Number of erase sectors of the store.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_KVSTORE_LinkSPIFLASH(BSP_KVSTORE_BlockTypeDef *pBlock, BSP_SPIFLASH_TypeDef *hflash,
+                                           uint32_t Base, uint32_t SectorCount)
+{
+  if ((pBlock == NULL) || (hflash == NULL) || (hflash->hspi == NULL) || ((Base % hflash->EraseSize) != 0U) ||
+      (SectorCount > (hflash->Size / hflash->EraseSize)) ||
+      (Base > (hflash->Size - (SectorCount * hflash->EraseSize))))
+  {
+    return HAL_ERROR;
+  }
+
+  pBlock->Read        = KVSTORE_SpiflashRead;
+  pBlock->Write       = KVSTORE_SpiflashWrite;
+  pBlock->Erase       = KVSTORE_SpiflashErase;
+  pBlock->Sync        = KVSTORE_SpiflashSync;
+  pBlock->pContext    = hflash;
+  pBlock->Base        = Base;
+  pBlock->SectorSize  = hflash->EraseSize;
+  pBlock->SectorCount = SectorCount;
+
+  return HAL_OK;
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  Back a block device with an ESMC flash.
+  * @note   The sectors are the 4 Kbyte erase sectors. The tick of the flash
+  *         must run from its timer while the store is used.
+  * @param  pBlock Pointer to a BSP_KVSTORE_BlockTypeDef structure.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure initialized.
+  * @param  Base First address, aligned on 4 Kbytes.
+  * @param  SectorCount Number of erase sectors of the store.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_KVSTORE_LinkESMCFLASH(BSP_KVSTORE_BlockTypeDef *pBlock, BSP_ESMCFLASH_TypeDef *hflash,
+                                            uint32_t Base, uint32_t SectorCount)
+{
+  if ((pBlock == NULL) || (hflash == NULL) || (hflash->hesmc == NULL) || ((Base % 0x1000U) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  pBlock->Read        = KVSTORE_EsmcflashRead;
+  pBlock->Write       = KVSTORE_EsmcflashWrite;
+  pBlock->Erase       = KVSTORE_EsmcflashErase;
+  pBlock->Sync        = NULL;
+  pBlock->pContext    = hflash;
+  pBlock->Base        = Base;
+  pBlock->SectorSize  = 0x1000U;
+  pBlock->SectorCount = SectorCount;
+
+  return HAL_OK;
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @brief  Mount a store and build its index.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  pBlock Pointer to a BSP_KVSTORE_BlockTypeDef structure, kept until the store is not used.
+  * @param  hcrc Pointer to a CRC_HandleTypeDef structure initialized.
+  * @retval HAL status, HAL_ERROR when the keys do not fit the index
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Mount(BSP_KVSTORE_TypeDef *hkv, const BSP_KVSTORE_BlockTypeDef *pBlock,
+                                    CRC_HandleTypeDef *hcrc)
+{
+  uint32_t header[KVSTORE_SECTOR_HEADER / 4U];
+  uint32_t sector;
+  uint32_t slot;
+  uint32_t last;
+  uint32_t next;
+  HAL_StatusTypeDef status;
+
+  if ((hkv == NULL) || (pBlock == NULL) || (hcrc == NULL) ||
+      (pBlock->SectorCount < 2U) || (pBlock->SectorCount > BSP_KVSTORE_SECTORS_MAX) ||
+      ((pBlock->SectorSize % 4U) != 0U) || (pBlock->SectorSize < 256U))
+  {
+    return HAL_ERROR;
+  }
+
+  hkv->pBlock       = NULL;
+  hkv->hcrc         = hcrc;
+  hkv->LastSequence = 0U;
+  hkv->Head         = KVSTORE_NONE;
+  hkv->FreeSectors  = 0U;
+  hkv->Count        = 0U;
+  hkv->CompactCount = 0U;
+  hkv->CrcErrors    = 0U;
+  for (slot = 0U; slot < BSP_KVSTORE_INDEX_SIZE; slot++)
+  {
+    hkv->Index[slot].Key = BSP_KVSTORE_KEY_NONE;
+  }
+
+  /* Sort out the written, erased and broken sectors */
+  for (sector = 0U; sector < pBlock->SectorCount; sector++)
+  {
+    hkv->Sequence[sector] = 0U;
+    hkv->Used[sector]     = 0U;
+    hkv->Live[sector]     = 0U;
+
+    status = pBlock->Read(pBlock->pContext, pBlock->Base + (sector * pBlock->SectorSize),
+                          (uint8_t *)header, KVSTORE_SECTOR_HEADER);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+
+    if ((header[0] == KVSTORE_MAGIC) && (header[1] != 0U) && (header[1] != 0xFFFFFFFFU))
+    {
+      hkv->Sequence[sector] = header[1];
+      if (header[1] > hkv->LastSequence)
+      {
+        hkv->LastSequence = header[1];
+      }
+      continue;
+    }
+
+    /* A header cut by a reset is erased again */
+    if ((header[0] != 0xFFFFFFFFU) || (header[1] != 0xFFFFFFFFU))
+    {
+      status = pBlock->Erase(pBlock->pContext, pBlock->Base + (sector * pBlock->SectorSize),
+                             pBlock->SectorSize);
+      if (status != HAL_OK)
+      {
+        return status;
+      }
+    }
+    hkv->FreeSectors++;
+  }
+  hkv->pBlock = pBlock;
+
+  /* Replay the sectors from the oldest, the last one is the head */
+  last = 0U;
+  for (;;)
+  {
+    next = KVSTORE_NONE;
+    for (sector = 0U; sector < pBlock->SectorCount; sector++)
+    {
+      if ((hkv->Sequence[sector] > last) &&
+          ((next == KVSTORE_NONE) || (hkv->Sequence[sector] < hkv->Sequence[next])))
+      {
+        next = sector;
+      }
+    }
+    if (next == KVSTORE_NONE)
+    {
+      break;
+    }
+
+    status = KVSTORE_Scan(hkv, next);
+    if (status != HAL_OK)
+    {
+      hkv->pBlock = NULL;
+      return status;
+    }
+    hkv->Head = next;
+    last = hkv->Sequence[next];
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Erase the area of a store and mount it empty.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  pBlock Pointer to a BSP_KVSTORE_BlockTypeDef structure, kept until the store is not used.
+  * @param  hcrc Pointer to a CRC_HandleTypeDef structure initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Format(BSP_KVSTORE_TypeDef *hkv, const BSP_KVSTORE_BlockTypeDef *pBlock,
+                                     CRC_HandleTypeDef *hcrc)
+{
+  HAL_StatusTypeDef status;
+
+  if ((hkv == NULL) || (pBlock == NULL) || (pBlock->SectorCount > BSP_KVSTORE_SECTORS_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  hkv->pBlock = NULL;
+  status = pBlock->Erase(pBlock->pContext, pBlock->Base, pBlock->SectorCount * pBlock->SectorSize);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return BSP_KVSTORE_Mount(hkv, pBlock, hcrc);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_KVSTORE_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Read, write and delete values
+      (+) Compact the store in the background
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Get the length of a value.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key of the value.
+  * @retval Length in bytes, BSP_KVSTORE_NOT_FOUND when the key is not stored
+  */
+uint32_t BSP_KVSTORE_GetLength(const BSP_KVSTORE_TypeDef *hkv, uint32_t Key)
+{
+  const BSP_KVSTORE_EntryTypeDef *pentry;
+
+  if ((hkv->pBlock == NULL) || (Key == BSP_KVSTORE_KEY_NONE))
+  {
+    return BSP_KVSTORE_NOT_FOUND;
+  }
+
+  pentry = KVSTORE_Find(hkv, Key);
+
+  return (pentry != NULL) ? pentry->Length : BSP_KVSTORE_NOT_FOUND;
+}
+
+/**
+  * @brief  Read a value.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key of the value.
+  * @param  pData Destination buffer.
+  * @param  Size Size of the buffer, at least the value length.
+  * @retval HAL status, HAL_ERROR when the key is not stored or its record fails its CRC
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Get(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint8_t *pData, uint32_t Size)
+{
+  const BSP_KVSTORE_EntryTypeDef *pentry;
+  KVSTORE_RecordTypeDef record;
+  HAL_StatusTypeDef status;
+
+  if ((hkv->pBlock == NULL) || (Key == BSP_KVSTORE_KEY_NONE))
+  {
+    return HAL_ERROR;
+  }
+
+  pentry = KVSTORE_Find(hkv, Key);
+  if ((pentry == NULL) || (pentry->Length > Size) || ((pData == NULL) && (pentry->Length != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  status = hkv->pBlock->Read(hkv->pBlock->pContext, pentry->Address, (uint8_t *)&record, KVSTORE_RECORD_HEADER);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  if (record.Key != Key)
+  {
+    hkv->CrcErrors++;
+    return HAL_ERROR;
+  }
+
+  return KVSTORE_ReadValue(hkv, pentry->Address, &record, pData);
+}
+
+/**
+  * @brief  Write a value, replacing the previous one.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key of the value, not BSP_KVSTORE_KEY_NONE.
+  * @param  pData Value.
+  * @param  Length Value length in bytes, the record must fit a sector.
+  * @retval HAL status, HAL_ERROR when the store or its index is full
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Set(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, const uint8_t *pData, uint32_t Length)
+{
+  if ((hkv->pBlock == NULL) || (Key == BSP_KVSTORE_KEY_NONE) || ((pData == NULL) && (Length != 0U)) ||
+      (Length > 0xFFFFU) || (KVSTORE_RECORD_SIZE(Length) > (hkv->pBlock->SectorSize - KVSTORE_SECTOR_HEADER)))
+  {
+    return HAL_ERROR;
+  }
+  if ((KVSTORE_Find(hkv, Key) == NULL) && (hkv->Count >= (BSP_KVSTORE_INDEX_SIZE - 1U)))
+  {
+    return HAL_ERROR;
+  }
+
+  return KVSTORE_Append(hkv, Key, KVSTORE_TYPE_VALUE, pData, Length);
+}
+
+/**
+  * @brief  Delete a value.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key of the value.
+  * @retval HAL status, HAL_OK when the key was not stored
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Delete(BSP_KVSTORE_TypeDef *hkv, uint32_t Key)
+{
+  if ((hkv->pBlock == NULL) || (Key == BSP_KVSTORE_KEY_NONE))
+  {
+    return HAL_ERROR;
+  }
+  if (KVSTORE_Find(hkv, Key) == NULL)
+  {
+    return HAL_OK;
+  }
+
+  return KVSTORE_Append(hkv, Key, KVSTORE_TYPE_DELETE, NULL, 0U);
+}
+
+/**
+  * @brief  Compact one sector when the store runs out of erased sectors.
+  * @note   To be called from the main loop, it may take a sector erase time.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_KVSTORE_Process(BSP_KVSTORE_TypeDef *hkv)
+{
+  if (hkv->pBlock == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if ((hkv->FreeSectors > BSP_KVSTORE_GC_FREE) || (KVSTORE_IsDirty(hkv) == 0U))
+  {
+    return HAL_OK;
+  }
+
+  return KVSTORE_Compact(hkv);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_KVSTORE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Index slot of a key.
+  * @param  Key Key.
+  * @retval First slot to probe
+  */
+static uint32_t KVSTORE_Hash(uint32_t Key)
+{
+  return ((Key * 0x9E3779B1U) >> 16) & (BSP_KVSTORE_INDEX_SIZE - 1U);
+}
+
+/**
+  * @brief  Look a key up in the index.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key.
+  * @retval Index entry, NULL when the key is not stored
+  */
+static BSP_KVSTORE_EntryTypeDef *KVSTORE_Find(const BSP_KVSTORE_TypeDef *hkv, uint32_t Key)
+{
+  uint32_t slot = KVSTORE_Hash(Key);
+
+  /* One slot is always free, the probe ends */
+  while (hkv->Index[slot].Key != BSP_KVSTORE_KEY_NONE)
+  {
+    if (hkv->Index[slot].Key == Key)
+    {
+      return (BSP_KVSTORE_EntryTypeDef *)&hkv->Index[slot];
+    }
+    slot = (slot + 1U) & (BSP_KVSTORE_INDEX_SIZE - 1U);
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Point a key to a new record.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key.
+  * @param  Address Record address.
+  * @param  Length Value length in bytes.
+  * @retval HAL status, HAL_ERROR when the index is full
+  */
+static HAL_StatusTypeDef KVSTORE_IndexSet(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint32_t Address,
+                                          uint32_t Length)
+{
+  BSP_KVSTORE_EntryTypeDef *pentry;
+  uint32_t slot;
+
+  pentry = KVSTORE_Find(hkv, Key);
+  if (pentry != NULL)
+  {
+    hkv->Live[KVSTORE_SECTOR_OF(hkv, pentry->Address)] -= KVSTORE_RECORD_SIZE(pentry->Length);
+  }
+  else
+  {
+    if (hkv->Count >= (BSP_KVSTORE_INDEX_SIZE - 1U))
+    {
+      return HAL_ERROR;
+    }
+    slot = KVSTORE_Hash(Key);
+    while (hkv->Index[slot].Key != BSP_KVSTORE_KEY_NONE)
+    {
+      slot = (slot + 1U) & (BSP_KVSTORE_INDEX_SIZE - 1U);
+    }
+    pentry = &hkv->Index[slot];
+    pentry->Key = Key;
+    hkv->Count++;
+  }
+
+  pentry->Address = Address;
+  pentry->Length  = Length;
+  hkv->Live[KVSTORE_SECTOR_OF(hkv, Address)] += KVSTORE_RECORD_SIZE(Length);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Remove a key from the index.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key.
+  * @retval None
+  */
+static void KVSTORE_IndexDelete(BSP_KVSTORE_TypeDef *hkv, uint32_t Key)
+{
+  BSP_KVSTORE_EntryTypeDef *pentry;
+  uint32_t hole;
+  uint32_t slot;
+  uint32_t home;
+
+  pentry = KVSTORE_Find(hkv, Key);
+  if (pentry == NULL)
+  {
+    return;
+  }
+  hkv->Live[KVSTORE_SECTOR_OF(hkv, pentry->Address)] -= KVSTORE_RECORD_SIZE(pentry->Length);
+  hkv->Count--;
+
+  /* Shift back the entries of the probe sequence, no tombstone is left */
+  hole = (uint32_t)(pentry - hkv->Index);
+  slot = hole;
+  for (;;)
+  {
+    slot = (slot + 1U) & (BSP_KVSTORE_INDEX_SIZE - 1U);
+    if (hkv->Index[slot].Key == BSP_KVSTORE_KEY_NONE)
+    {
+      break;
+    }
+    home = KVSTORE_Hash(hkv->Index[slot].Key);
+    if (((slot - home) & (BSP_KVSTORE_INDEX_SIZE - 1U)) >= ((slot - hole) & (BSP_KVSTORE_INDEX_SIZE - 1U)))
+    {
+      hkv->Index[hole] = hkv->Index[slot];
+      hole = slot;
+    }
+  }
+  hkv->Index[hole].Key = BSP_KVSTORE_KEY_NONE;
+}
+
+/**
+  * @brief  CRC of a record, the value padded with 0xFF to 4 bytes.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  pRecord Record header, its Crc is ignored.
+  * @param  pData Value.
+  * @retval CRC
+  */
+static uint32_t KVSTORE_Crc(BSP_KVSTORE_TypeDef *hkv, const KVSTORE_RecordTypeDef *pRecord,
+                            const uint8_t *pData)
+{
+  uint32_t buffer[KVSTORE_CHUNK_WORDS];
+  uint32_t length = pRecord->Info & 0xFFFFU;
+  uint32_t chunk;
+  uint32_t crc;
+
+  buffer[0] = pRecord->Key;
+  buffer[1] = pRecord->Info;
+  crc = HAL_CRC_Calculate(hkv->hcrc, buffer, 2U);
+
+  while (length != 0U)
+  {
+    chunk = (length > sizeof(buffer)) ? sizeof(buffer) : length;
+    buffer[(chunk - 1U) / 4U] = 0xFFFFFFFFU;
+    memcpy(buffer, pData, chunk);
+    crc = HAL_CRC_Accumulate(hkv->hcrc, buffer, (chunk + 3U) / 4U);
+    pData  += chunk;
+    length -= chunk;
+  }
+
+  return crc;
+}
+
+/**
+  * @brief  Read the value of a record and check its CRC.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Address Record address.
+  * @param  pRecord Record header read from Address.
+  * @param  pData Destination buffer, NULL to only check the CRC.
+  * @retval HAL status, HAL_ERROR when the CRC does not match
+  */
+static HAL_StatusTypeDef KVSTORE_ReadValue(BSP_KVSTORE_TypeDef *hkv, uint32_t Address,
+                                           const KVSTORE_RecordTypeDef *pRecord, uint8_t *pData)
+{
+  uint32_t buffer[KVSTORE_CHUNK_WORDS];
+  uint32_t length = pRecord->Info & 0xFFFFU;
+  uint32_t chunk;
+  uint32_t crc;
+  HAL_StatusTypeDef status;
+
+  buffer[0] = pRecord->Key;
+  buffer[1] = pRecord->Info;
+  crc = HAL_CRC_Calculate(hkv->hcrc, buffer, 2U);
+
+  Address += KVSTORE_RECORD_HEADER;
+  while (length != 0U)
+  {
+    /* The padding is read with the last chunk */
+    chunk = (length > sizeof(buffer)) ? sizeof(buffer) : length;
+    status = hkv->pBlock->Read(hkv->pBlock->pContext, Address, (uint8_t *)buffer, (chunk + 3U) & ~3U);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+    crc = HAL_CRC_Accumulate(hkv->hcrc, buffer, (chunk + 3U) / 4U);
+    if (pData != NULL)
+    {
+      memcpy(pData, buffer, chunk);
+      pData += chunk;
+    }
+    Address += chunk;
+    length  -= chunk;
+  }
+
+  if (crc != pRecord->Crc)
+  {
+    hkv->CrcErrors++;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check the header of a record.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  pRecord Record header.
+  * @param  Offset Offset of the record in its sector.
+  * @retval 1 when the header is a record fitting the sector, 0 otherwise
+  */
+static uint32_t KVSTORE_IsRecord(const BSP_KVSTORE_TypeDef *hkv, const KVSTORE_RecordTypeDef *pRecord,
+                                 uint32_t Offset)
+{
+  uint32_t length = pRecord->Info & 0xFFFFU;
+  uint32_t type = pRecord->Info >> 16;
+
+  if ((pRecord->Key == BSP_KVSTORE_KEY_NONE) ||
+      ((type != KVSTORE_TYPE_VALUE) && (type != KVSTORE_TYPE_DELETE)) ||
+      ((type == KVSTORE_TYPE_DELETE) && (length != 0U)) ||
+      (KVSTORE_RECORD_SIZE(length) > (hkv->pBlock->SectorSize - Offset)))
+  {
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Replay the records of a sector in the index.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Sector Sector number.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KVSTORE_Scan(BSP_KVSTORE_TypeDef *hkv, uint32_t Sector)
+{
+  const BSP_KVSTORE_BlockTypeDef *pblock = hkv->pBlock;
+  KVSTORE_RecordTypeDef record;
+  uint32_t base = KVSTORE_SECTOR_ADDRESS(hkv, Sector);
+  uint32_t offset = KVSTORE_SECTOR_HEADER;
+  HAL_StatusTypeDef status;
+
+  while ((offset + KVSTORE_RECORD_HEADER) <= pblock->SectorSize)
+  {
+    status = pblock->Read(pblock->pContext, base + offset, (uint8_t *)&record, KVSTORE_RECORD_HEADER);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+
+    /* Erased space, the end of the sector log */
+    if ((record.Key == 0xFFFFFFFFU) && (record.Info == 0xFFFFFFFFU) && (record.Crc == 0xFFFFFFFFU))
+    {
+      hkv->Used[Sector] = offset;
+      return HAL_OK;
+    }
+
+    if ((KVSTORE_IsRecord(hkv, &record, offset) == 0U) ||
+        (KVSTORE_ReadValue(hkv, base + offset, &record, NULL) != HAL_OK))
+    {
+      break;
+    }
+
+    if ((record.Info >> 16) == KVSTORE_TYPE_VALUE)
+    {
+      status = KVSTORE_IndexSet(hkv, record.Key, base + offset, record.Info & 0xFFFFU);
+      if (status != HAL_OK)
+      {
+        return status;
+      }
+    }
+    else
+    {
+      KVSTORE_IndexDelete(hkv, record.Key);
+    }
+    offset += KVSTORE_RECORD_SIZE(record.Info & 0xFFFFU);
+  }
+
+  /* Full or broken, no more appends */
+  hkv->Used[Sector] = pblock->SectorSize;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take room at the head, starting an erased sector when needed.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Size Record size in bytes.
+  * @param  pAddress Address of the room.
+  * @retval HAL status, HAL_ERROR when no sector is erased
+  */
+static HAL_StatusTypeDef KVSTORE_Allocate(BSP_KVSTORE_TypeDef *hkv, uint32_t Size, uint32_t *pAddress)
+{
+  const BSP_KVSTORE_BlockTypeDef *pblock = hkv->pBlock;
+  uint32_t header[KVSTORE_SECTOR_HEADER / 4U];
+  uint32_t sector;
+  uint32_t i;
+  HAL_StatusTypeDef status;
+
+  if ((hkv->Head == KVSTORE_NONE) || ((hkv->Used[hkv->Head] + Size) > pblock->SectorSize))
+  {
+    if (hkv->FreeSectors == 0U)
+    {
+      return HAL_ERROR;
+    }
+
+    /* The next erased sector after the head spreads the wear */
+    sector = (hkv->Head == KVSTORE_NONE) ? 0U : hkv->Head;
+    for (i = 0U; i < pblock->SectorCount; i++)
+    {
+      sector = (sector + 1U) % pblock->SectorCount;
+      if (hkv->Sequence[sector] == 0U)
+      {
+        break;
+      }
+    }
+
+    header[0] = KVSTORE_MAGIC;
+    header[1] = hkv->LastSequence + 1U;
+    status = pblock->Write(pblock->pContext, KVSTORE_SECTOR_ADDRESS(hkv, sector), (uint8_t *)header,
+                           KVSTORE_SECTOR_HEADER);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+
+    hkv->LastSequence     = header[1];
+    hkv->Sequence[sector] = header[1];
+    hkv->Used[sector]     = KVSTORE_SECTOR_HEADER;
+    hkv->Live[sector]     = 0U;
+    hkv->FreeSectors--;
+    hkv->Head = sector;
+  }
+
+  *pAddress = KVSTORE_SECTOR_ADDRESS(hkv, hkv->Head) + hkv->Used[hkv->Head];
+  hkv->Used[hkv->Head] += Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop appending to the head after a failed write.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @retval None
+  */
+static void KVSTORE_Close(BSP_KVSTORE_TypeDef *hkv)
+{
+  if (hkv->Head != KVSTORE_NONE)
+  {
+    hkv->Used[hkv->Head] = hkv->pBlock->SectorSize;
+  }
+}
+
+/**
+  * @brief  Make room for a record, compacting while only the reserved sector is erased.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Size Record size in bytes.
+  * @retval HAL status, HAL_ERROR when the store is full
+  */
+static HAL_StatusTypeDef KVSTORE_Reserve(BSP_KVSTORE_TypeDef *hkv, uint32_t Size)
+{
+  uint32_t attempts = 0U;
+  HAL_StatusTypeDef status;
+
+  while ((hkv->Head == KVSTORE_NONE) || ((hkv->Used[hkv->Head] + Size) > hkv->pBlock->SectorSize))
+  {
+    if (hkv->FreeSectors > 1U)
+    {
+      return HAL_OK;
+    }
+    if ((KVSTORE_IsDirty(hkv) == 0U) || (attempts >= hkv->pBlock->SectorCount))
+    {
+      return HAL_ERROR;
+    }
+    attempts++;
+
+    status = KVSTORE_Compact(hkv);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Append a record and update the index.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @param  Key Key.
+  * @param  Type KVSTORE_TYPE_VALUE or KVSTORE_TYPE_DELETE.
+  * @param  pData Value.
+  * @param  Length Value length in bytes.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KVSTORE_Append(BSP_KVSTORE_TypeDef *hkv, uint32_t Key, uint32_t Type,
+                                        const uint8_t *pData, uint32_t Length)
+{
+  const BSP_KVSTORE_BlockTypeDef *pblock = hkv->pBlock;
+  KVSTORE_RecordTypeDef record;
+  uint32_t size = KVSTORE_RECORD_SIZE(Length);
+  uint32_t address;
+  HAL_StatusTypeDef status;
+
+  status = KVSTORE_Reserve(hkv, size);
+  if (status == HAL_OK)
+  {
+    status = KVSTORE_Allocate(hkv, size, &address);
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  record.Key  = Key;
+  record.Info = Length | (Type << 16);
+  record.Crc  = KVSTORE_Crc(hkv, &record, pData);
+
+  /* The padding stays erased, as counted in the CRC */
+  status = pblock->Write(pblock->pContext, address, (uint8_t *)&record, KVSTORE_RECORD_HEADER);
+  if ((status == HAL_OK) && (Length != 0U))
+  {
+    status = pblock->Write(pblock->pContext, address + KVSTORE_RECORD_HEADER, pData, Length);
+  }
+  if (status == HAL_OK)
+  {
+    status = KVSTORE_Sync(hkv);
+  }
+  if (status != HAL_OK)
+  {
+    KVSTORE_Close(hkv);
+    return status;
+  }
+
+  if (Type == KVSTORE_TYPE_VALUE)
+  {
+    return KVSTORE_IndexSet(hkv, Key, address, Length);
+  }
+  KVSTORE_IndexDelete(hkv, Key);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check whether a sector holds dead records.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @retval 1 when a compaction frees some room, 0 otherwise
+  */
+static uint32_t KVSTORE_IsDirty(const BSP_KVSTORE_TypeDef *hkv)
+{
+  uint32_t sector;
+
+  for (sector = 0U; sector < hkv->pBlock->SectorCount; sector++)
+  {
+    if ((hkv->Sequence[sector] != 0U) && ((hkv->Used[sector] - KVSTORE_SECTOR_HEADER) > hkv->Live[sector]))
+    {
+      return 1U;
+    }
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Copy the indexed records of the oldest sector to the head and erase it.
+  * @note   A reset during the copy leaves both copies, the newer one wins at mount.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KVSTORE_Compact(BSP_KVSTORE_TypeDef *hkv)
+{
+  const BSP_KVSTORE_BlockTypeDef *pblock = hkv->pBlock;
+  KVSTORE_RecordTypeDef record;
+  const BSP_KVSTORE_EntryTypeDef *pentry;
+  uint32_t buffer[KVSTORE_CHUNK_WORDS];
+  uint32_t victim = KVSTORE_NONE;
+  uint32_t sector;
+  uint32_t base;
+  uint32_t offset;
+  uint32_t size;
+  uint32_t address;
+  uint32_t i;
+  uint32_t chunk;
+  HAL_StatusTypeDef status;
+
+  for (sector = 0U; sector < pblock->SectorCount; sector++)
+  {
+    if ((hkv->Sequence[sector] != 0U) &&
+        ((victim == KVSTORE_NONE) || (hkv->Sequence[sector] < hkv->Sequence[victim])))
+    {
+      victim = sector;
+    }
+  }
+  if (victim == KVSTORE_NONE)
+  {
+    return HAL_ERROR;
+  }
+
+  /* A single written sector is copied to a new head */
+  if (victim == hkv->Head)
+  {
+    KVSTORE_Close(hkv);
+  }
+
+  base = KVSTORE_SECTOR_ADDRESS(hkv, victim);
+  offset = KVSTORE_SECTOR_HEADER;
+  while ((hkv->Live[victim] != 0U) && ((offset + KVSTORE_RECORD_HEADER) <= hkv->Used[victim]))
+  {
+    status = pblock->Read(pblock->pContext, base + offset, (uint8_t *)&record, KVSTORE_RECORD_HEADER);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+    if (KVSTORE_IsRecord(hkv, &record, offset) == 0U)
+    {
+      break;
+    }
+    size = KVSTORE_RECORD_SIZE(record.Info & 0xFFFFU);
+
+    pentry = KVSTORE_Find(hkv, record.Key);
+    if ((pentry != NULL) && (pentry->Address == (base + offset)))
+    {
+      status = KVSTORE_Allocate(hkv, size, &address);
+      if (status != HAL_OK)
+      {
+        return status;
+      }
+
+      /* Header, value and padding as they are, the CRC still matches */
+      for (i = 0U; (status == HAL_OK) && (i < size); i += chunk)
+      {
+        chunk = ((size - i) > sizeof(buffer)) ? sizeof(buffer) : (size - i);
+        status = pblock->Read(pblock->pContext, base + offset + i, (uint8_t *)buffer, chunk);
+        if (status == HAL_OK)
+        {
+          status = pblock->Write(pblock->pContext, address + i, (uint8_t *)buffer, chunk);
+        }
+      }
+      if (status != HAL_OK)
+      {
+        KVSTORE_Close(hkv);
+        return status;
+      }
+
+      (void)KVSTORE_IndexSet(hkv, record.Key, address, record.Info & 0xFFFFU);
+    }
+    offset += size;
+  }
+
+  status = KVSTORE_Sync(hkv);
+  if (status == HAL_OK)
+  {
+    status = pblock->Erase(pblock->pContext, base, pblock->SectorSize);
+  }
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hkv->Sequence[victim] = 0U;
+  hkv->Used[victim]     = 0U;
+  hkv->Live[victim]     = 0U;
+  hkv->FreeSectors++;
+  hkv->CompactCount++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Make the writes durable.
+  * @param  hkv Pointer to a BSP_KVSTORE_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KVSTORE_Sync(const BSP_KVSTORE_TypeDef *hkv)
+{
+  if (hkv->pBlock->Sync == NULL)
+  {
+    return HAL_OK;
+  }
+
+  return hkv->pBlock->Sync(hkv->pBlock->pContext);
+}
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+  * @brief  Block device read on a SPI flash.
+  */
+static HAL_StatusTypeDef KVSTORE_SpiflashRead(void *pContext, uint32_t Address, uint8_t *pData, uint32_t Size)
+{
+  return BSP_SPIFLASH_Read((BSP_SPIFLASH_TypeDef *)pContext, Address, pData, Size);
+}
+
+/**
+  * @brief  Block device write on a SPI flash.
+  */
+static HAL_StatusTypeDef KVSTORE_SpiflashWrite(void *pContext, uint32_t Address, const uint8_t *pData,
+                                               uint32_t Size)
+{
+  return BSP_SPIFLASH_Write((BSP_SPIFLASH_TypeDef *)pContext, Address, pData, Size);
+}
+
+/**
+  * @brief  Block device erase on a SPI flash.
+  */
+static HAL_StatusTypeDef KVSTORE_SpiflashErase(void *pContext, uint32_t Address, uint32_t Size)
+{
+  return BSP_SPIFLASH_Erase((BSP_SPIFLASH_TypeDef *)pContext, Address, Size);
+}
+
+/**
+  * @brief  Block device sync on a SPI flash, the batched page is programmed.
+  */
+static HAL_StatusTypeDef KVSTORE_SpiflashSync(void *pContext)
+{
+  return BSP_SPIFLASH_Flush((BSP_SPIFLASH_TypeDef *)pContext);
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+/**
+  * @brief  Block device read on an ESMC flash.
+  */
+static HAL_StatusTypeDef KVSTORE_EsmcflashRead(void *pContext, uint32_t Address, uint8_t *pData, uint32_t Size)
+{
+  return BSP_ESMCFLASH_Read((BSP_ESMCFLASH_TypeDef *)pContext, Address, pData, Size);
+}
+
+/**
+  * @brief  Block device write on an ESMC flash, the pages are sent from its tick.
+  */
+static HAL_StatusTypeDef KVSTORE_EsmcflashWrite(void *pContext, uint32_t Address, const uint8_t *pData,
+                                                uint32_t Size)
+{
+  BSP_ESMCFLASH_TypeDef *hflash = (BSP_ESMCFLASH_TypeDef *)pContext;
+  HAL_StatusTypeDef status;
+
+  status = BSP_ESMCFLASH_Program_IT(hflash, Address, pData, Size);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return KVSTORE_EsmcflashWait(hflash);
+}
+
+/**
+  * @brief  Block device erase on an ESMC flash, by 4 Kbyte sectors.
+  */
+static HAL_StatusTypeDef KVSTORE_EsmcflashErase(void *pContext, uint32_t Address, uint32_t Size)
+{
+  BSP_ESMCFLASH_TypeDef *hflash = (BSP_ESMCFLASH_TypeDef *)pContext;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t end = Address + Size;
+
+  for (; (status == HAL_OK) && (Address < end); Address += 0x1000U)
+  {
+    status = BSP_ESMCFLASH_Erase_IT(hflash, Address, BSP_ESMCFLASH_ERASE_SECTOR);
+    if (status == HAL_OK)
+    {
+      status = KVSTORE_EsmcflashWait(hflash);
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Wait for the end of an ESMC flash operation.
+  * @param  hflash Pointer to a BSP_ESMCFLASH_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KVSTORE_EsmcflashWait(BSP_ESMCFLASH_TypeDef *hflash)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (BSP_ESMCFLASH_IsBusy(hflash) != 0U)
+  {
+    if ((HAL_GetTick() - tickstart) > BSP_KVSTORE_ESMC_TIMEOUT)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return (hflash->LastStatus == BSP_ESMCFLASH_STATUS_OK) ? HAL_OK : HAL_ERROR;
+}
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,866 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lin.c
+  * @author  MCU Application Team
+  * @brief   LIN schedule engine BSP service.
+  *          This file provides functions to run a LIN master or slave node:
+  *           + Schedule table of slots holding one or more frames
+  *           + Header, PID parity and checksum handled from interrupts
+  *           + Response timeouts counted by a timer tick
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the UART with HAL_LIN_Init() and UART_LINBREAKDETECTLENGTH_11B,
+       link a DMA channel in DMA_NORMAL mode to its hdmarx and one to its hdmatx.
+       Configure a timer with a periodic update interrupt, typically 1 ms.
+
+   (#) The UART, both DMA channels and the timer interrupts must be enabled in
+       the NVIC with the same preemption priority: the engine state is only
+       changed from these interrupts and they must not preempt each other.
+
+   (#) Describe the frames with BSP_LIN_FrameTypeDef. Direction is seen from
+       this node: BSP_LIN_PUBLISH when it sends the response, BSP_LIN_SUBSCRIBE
+       when it receives it. The diagnostic frames 0x3C and 0x3D always use
+       BSP_LIN_CHECKSUM_CLASSIC.
+
+   (#) Call BSP_LIN_Init() with the UART handle, the node role and the timer
+       period in us, then:
+       (+) Master: BSP_LIN_SetSchedule() with a table of BSP_LIN_SlotTypeDef.
+           The frames of a slot are sent one after the other as soon as the
+           previous one ends, a frame still on the bus at the end of its slot
+           times out. The table can be switched at any time, the new one starts
+           at the next tick.
+       (+) Slave: BSP_LIN_SetFrames() with the frames the node answers or
+           listens to, the other headers are ignored.
+
+   (#) Call BSP_LIN_Start(). The node then owns the UART: the HAL transfer
+       functions must not be used on it until BSP_LIN_Stop().
+       (+) In the USARTx_IRQHandler() call BSP_LIN_IRQHandler() instead of
+           HAL_UART_IRQHandler(), it only handles the break detection.
+       (+) In the timer HAL_TIM_PeriodElapsedCallback() call BSP_LIN_Tick().
+
+   (#) BSP_LIN_FrameCallback() is called from the interrupts at the end of each
+       frame of the node, the result is in the frame Status (@ref BSP_LIN_Status).
+       A published pData is read when its header starts, a subscribed pData is
+       written just before the callback.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_lin.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_LIN BSP LIN
+  * @brief LIN schedule engine BSP service
+  * @{
+  */
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_LIN_Private_Constants BSP LIN Private Constants
+  * @{
+  */
+#define LIN_NODE_NUMBER           5U          /*!< One node per UART instance                    */
+#define LIN_SYNC                  0x55U       /*!< Sync field                                    */
+#define LIN_ID_MAX                0x3FU
+#define LIN_DATA_MAX              8U
+#define LIN_HEADER_BITS           34U         /*!< Break, delimiter, sync and PID nominal bits   */
+#define LIN_BYTE_BITS             10U
+
+#define LIN_STATE_IDLE            0x00000000U /*!< Bus idle, waiting for the slot or the break   */
+#define LIN_STATE_BREAK           0x00000001U /*!< Master break sent, waiting for its detection  */
+#define LIN_STATE_HEADER          0x00000002U /*!< Slave receiving the sync and PID              */
+#define LIN_STATE_RESPONSE        0x00000003U /*!< Response being sent or received               */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_LIN_Private_Variables BSP LIN Private Variables
+  * @{
+  */
+static USART_TypeDef * const LIN_Instances[LIN_NODE_NUMBER] =
+{
+  USART1, USART2, USART3, USART4, USART5
+};
+
+/* Started nodes, found back from the DMA callbacks */
+static BSP_LIN_TypeDef *LIN_Nodes[LIN_NODE_NUMBER];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_LIN_Private_Functions
+  * @{
+  */
+static uint32_t         LIN_GetIndex(const UART_HandleTypeDef *huart);
+static BSP_LIN_TypeDef *LIN_GetNode(const DMA_HandleTypeDef *hdma);
+static uint32_t         LIN_GetTicks(const BSP_LIN_TypeDef *hlin, uint32_t Bits);
+static uint8_t          LIN_Checksum(const BSP_LIN_FrameTypeDef *pFrame, uint8_t PID, const uint8_t *pData);
+static void             LIN_StartReceive(BSP_LIN_TypeDef *hlin, uint32_t Offset, uint32_t Length);
+static void             LIN_StartFrame(BSP_LIN_TypeDef *hlin);
+static void             LIN_StartResponse(BSP_LIN_TypeDef *hlin);
+static void             LIN_EndFrame(BSP_LIN_TypeDef *hlin, uint32_t Status);
+static void             LIN_Abort(BSP_LIN_TypeDef *hlin);
+static void             LIN_DMARxCplt(DMA_HandleTypeDef *hdma);
+static void             LIN_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_LIN_Exported_Functions BSP LIN Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_LIN_Exported_Functions_Group1 Node functions
+  * @brief    Node functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Node functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Initialize a master or slave node
+      (+) Set the master schedule table or the slave frames
+      (+) Start and stop the node
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a LIN node.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  huart Pointer to a UART_HandleTypeDef structure initialized by
+  *               HAL_LIN_Init(), hdmarx and hdmatx in DMA_NORMAL mode must be linked.
+  * @param  Mode A value of @ref BSP_LIN_Mode.
+  * @param  TickPeriod Period of the BSP_LIN_Tick() calls in us.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LIN_Init(BSP_LIN_TypeDef *hlin, UART_HandleTypeDef *huart, uint32_t Mode, uint32_t TickPeriod)
+{
+  if ((hlin == NULL) || (huart == NULL) || (huart->hdmarx == NULL) || (huart->hdmatx == NULL) ||
+      (TickPeriod == 0U) || (huart->Init.BaudRate == 0U) ||
+      ((Mode != BSP_LIN_MODE_MASTER) && (Mode != BSP_LIN_MODE_SLAVE)))
+  {
+    return HAL_ERROR;
+  }
+  if (LIN_GetIndex(huart) >= LIN_NODE_NUMBER)
+  {
+    return HAL_ERROR;
+  }
+  if ((huart->Instance->CR2 & USART_CR2_LINEN) == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  memset(hlin, 0, sizeof(BSP_LIN_TypeDef));
+  hlin->huart      = huart;
+  hlin->Mode       = Mode;
+  hlin->TickPeriod = TickPeriod;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the schedule table of a master node.
+  * @note   The current frame ends normally, the new table starts at the next tick.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  pSchedule Schedule table, it stays in use until replaced.
+  * @param  SlotNumber Number of slots, 0 to stop sending headers.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LIN_SetSchedule(BSP_LIN_TypeDef *hlin, const BSP_LIN_SlotTypeDef *pSchedule, uint32_t SlotNumber)
+{
+  uint32_t primask_bit;
+
+  if ((hlin == NULL) || (hlin->Mode != BSP_LIN_MODE_MASTER) || ((pSchedule == NULL) && (SlotNumber != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hlin->pSchedule  = pSchedule;
+  hlin->SlotNumber = SlotNumber;
+  /* End the current slot at the next tick, the table restarts from its first slot */
+  hlin->Slot       = (SlotNumber != 0U) ? (SlotNumber - 1U) : 0U;
+  hlin->SlotTicks  = 1U;
+  hlin->Frame      = 0U;
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the frames of a slave node.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  ppFrames Frames answered or listened to, they stay in use until replaced.
+  * @param  FrameNumber Number of frames.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LIN_SetFrames(BSP_LIN_TypeDef *hlin, BSP_LIN_FrameTypeDef * const *ppFrames, uint32_t FrameNumber)
+{
+  uint32_t primask_bit;
+
+  if ((hlin == NULL) || (hlin->Mode != BSP_LIN_MODE_SLAVE) || ((ppFrames == NULL) && (FrameNumber != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  hlin->ppFrames    = ppFrames;
+  hlin->FrameNumber = FrameNumber;
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a LIN node.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LIN_Start(BSP_LIN_TypeDef *hlin)
+{
+  UART_HandleTypeDef *huart;
+  uint32_t index;
+
+  if ((hlin == NULL) || (hlin->huart == NULL))
+  {
+    return HAL_ERROR;
+  }
+  huart = hlin->huart;
+  index = LIN_GetIndex(huart);
+
+  if ((LIN_Nodes[index] != NULL) || (huart->gState != HAL_UART_STATE_READY) ||
+      (huart->RxState != HAL_UART_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  hlin->pFrame     = NULL;
+  hlin->State      = LIN_STATE_IDLE;
+  hlin->Timeout    = 0U;
+  hlin->ErrorCount = 0U;
+
+  /* The DMA completions and the break detection drive the frames */
+  huart->gState  = HAL_UART_STATE_BUSY;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+  huart->hdmatx->XferCpltCallback     = NULL;
+  huart->hdmatx->XferHalfCpltCallback = NULL;
+  huart->hdmatx->XferErrorCallback    = LIN_DMAError;
+  huart->hdmatx->XferAbortCallback    = NULL;
+  huart->hdmarx->XferCpltCallback     = LIN_DMARxCplt;
+  huart->hdmarx->XferHalfCpltCallback = NULL;
+  huart->hdmarx->XferErrorCallback    = LIN_DMAError;
+  huart->hdmarx->XferAbortCallback    = NULL;
+
+  LIN_Nodes[index] = hlin;
+
+  /* Drop what was received before the first break */
+  (void)READ_REG(huart->Instance->SR);
+  (void)READ_REG(huart->Instance->DR);
+  __HAL_UART_CLEAR_FLAG(huart, UART_FLAG_LBD);
+  SET_BIT(huart->Instance->CR3, USART_CR3_DMAT | USART_CR3_DMAR);
+  SET_BIT(huart->Instance->CR2, USART_CR2_LBDIE);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop a LIN node and give the UART back to the HAL.
+  * @note   The frame on the bus is dropped without callback.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LIN_Stop(BSP_LIN_TypeDef *hlin)
+{
+  UART_HandleTypeDef *huart;
+  uint32_t primask_bit;
+  uint32_t index;
+
+  if ((hlin == NULL) || (hlin->huart == NULL))
+  {
+    return HAL_ERROR;
+  }
+  huart = hlin->huart;
+  index = LIN_GetIndex(huart);
+  if (LIN_Nodes[index] != hlin)
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  LIN_Nodes[index] = NULL;
+  CLEAR_BIT(huart->Instance->CR2, USART_CR2_LBDIE);
+  LIN_Abort(hlin);
+  hlin->pFrame = NULL;
+  hlin->State  = LIN_STATE_IDLE;
+
+  __set_PRIMASK(primask_bit);
+
+  CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAT | USART_CR3_DMAR);
+  huart->gState  = HAL_UART_STATE_READY;
+  huart->RxState = HAL_UART_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Compute the protected identifier of a frame.
+  * @param  Id Frame identifier, 0 to 63.
+  * @retval Identifier with the P0 and P1 parity bits
+  */
+uint8_t BSP_LIN_GetPID(uint8_t Id)
+{
+  uint32_t id = (uint32_t)Id & LIN_ID_MAX;
+  uint32_t p0;
+  uint32_t p1;
+
+  p0 = (id ^ (id >> 1U) ^ (id >> 2U) ^ (id >> 4U)) & 0x01U;
+  p1 = ~((id >> 1U) ^ (id >> 3U) ^ (id >> 4U) ^ (id >> 5U)) & 0x01U;
+
+  return (uint8_t)(id | (p0 << 6U) | (p1 << 7U));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_LIN_Exported_Functions_Group2 Interrupt functions
+  * @brief    Interrupt functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Interrupt functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Run the schedule table and the timeouts from the timer tick
+      (+) Handle the break detection of the UART interrupt
+      (+) Be notified of the end of each frame
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Advance the schedule table and the frame timeout.
+  * @note   Called from the timer period elapsed interrupt, every TickPeriod us.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval None
+  */
+void BSP_LIN_Tick(BSP_LIN_TypeDef *hlin)
+{
+  const BSP_LIN_SlotTypeDef *pSlot;
+
+  if (LIN_Nodes[LIN_GetIndex(hlin->huart)] != hlin)
+  {
+    return;
+  }
+
+  if ((hlin->State != LIN_STATE_IDLE) && (hlin->Timeout != 0U))
+  {
+    hlin->Timeout--;
+    if (hlin->Timeout == 0U)
+    {
+      LIN_Abort(hlin);
+      if (hlin->pFrame != NULL)
+      {
+        LIN_EndFrame(hlin, BSP_LIN_STATUS_TIMEOUT);
+      }
+      else
+      {
+        /* Slave header never completed */
+        hlin->State = LIN_STATE_IDLE;
+        hlin->ErrorCount++;
+      }
+    }
+  }
+
+  if ((hlin->Mode != BSP_LIN_MODE_MASTER) || (hlin->SlotNumber == 0U))
+  {
+    return;
+  }
+
+  if (hlin->SlotTicks > 1U)
+  {
+    hlin->SlotTicks--;
+    return;
+  }
+
+  /* End of the slot, a frame still on the bus did not fit in it */
+  if (hlin->State != LIN_STATE_IDLE)
+  {
+    LIN_Abort(hlin);
+    hlin->Frame = hlin->pSchedule[hlin->Slot].FrameNumber;
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_TIMEOUT);
+  }
+
+  hlin->Slot++;
+  if (hlin->Slot >= hlin->SlotNumber)
+  {
+    hlin->Slot = 0U;
+  }
+  pSlot = &hlin->pSchedule[hlin->Slot];
+  hlin->SlotTicks = (pSlot->Duration != 0U) ? pSlot->Duration : 1U;
+  hlin->Frame = 0U;
+
+  LIN_StartFrame(hlin);
+}
+
+/**
+  * @brief  Handle the UART interrupt of a started node.
+  * @note   Replaces HAL_UART_IRQHandler(), only the break detection is enabled.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval None
+  */
+void BSP_LIN_IRQHandler(BSP_LIN_TypeDef *hlin)
+{
+  UART_HandleTypeDef *huart = hlin->huart;
+
+  if ((READ_REG(huart->Instance->SR) & USART_SR_LBD) == 0U)
+  {
+    return;
+  }
+  __HAL_UART_CLEAR_FLAG(huart, UART_FLAG_LBD);
+
+  /* The break itself is received as a 0x00 character with a framing error */
+  (void)READ_REG(huart->Instance->DR);
+
+  if (LIN_Nodes[LIN_GetIndex(huart)] != hlin)
+  {
+    return;
+  }
+
+  if (hlin->Mode == BSP_LIN_MODE_MASTER)
+  {
+    if (hlin->State == LIN_STATE_BREAK)
+    {
+      /* Read back the sync, the PID and the response */
+      hlin->State = LIN_STATE_RESPONSE;
+      LIN_StartReceive(hlin, 0U, (uint32_t)hlin->pFrame->Length + 3U);
+    }
+  }
+  else
+  {
+    /* A new break aborts the frame on the bus */
+    if (hlin->State != LIN_STATE_IDLE)
+    {
+      LIN_Abort(hlin);
+      if (hlin->pFrame != NULL)
+      {
+        LIN_EndFrame(hlin, BSP_LIN_STATUS_TIMEOUT);
+      }
+    }
+    hlin->State   = LIN_STATE_HEADER;
+    hlin->Timeout = LIN_GetTicks(hlin, LIN_HEADER_BITS);
+    LIN_StartReceive(hlin, 0U, 2U);
+  }
+}
+
+/**
+  * @brief  Frame end callback.
+  * @note   Called from the interrupts, pFrame->Status holds the result.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  pFrame Frame ended.
+  * @retval None
+  */
+__weak void BSP_LIN_FrameCallback(BSP_LIN_TypeDef *hlin, BSP_LIN_FrameTypeDef *pFrame)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hlin);
+  UNUSED(pFrame);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_LIN_FrameCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LIN_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the node index of a UART.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval Index, LIN_NODE_NUMBER for an unknown instance
+  */
+static uint32_t LIN_GetIndex(const UART_HandleTypeDef *huart)
+{
+  uint32_t index;
+
+  for (index = 0U; index < LIN_NODE_NUMBER; index++)
+  {
+    if (huart->Instance == LIN_Instances[index])
+    {
+      break;
+    }
+  }
+
+  return index;
+}
+
+/**
+  * @brief  Return the started node of a UART DMA channel.
+  * @param  hdma Pointer to the hdmarx or hdmatx of the node UART.
+  * @retval Node, NULL when not started
+  */
+static BSP_LIN_TypeDef *LIN_GetNode(const DMA_HandleTypeDef *hdma)
+{
+  uint32_t index = LIN_GetIndex((const UART_HandleTypeDef *)hdma->Parent);
+
+  return (index < LIN_NODE_NUMBER) ? LIN_Nodes[index] : NULL;
+}
+
+/**
+  * @brief  Convert a number of bits to timeout ticks.
+  * @note   The LIN specification allows 40% above the nominal time, one tick is
+  *         added since the transfer starts anywhere within a tick.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  Bits Nominal number of bits.
+  * @retval Number of ticks
+  */
+static uint32_t LIN_GetTicks(const BSP_LIN_TypeDef *hlin, uint32_t Bits)
+{
+  uint32_t us = (Bits * 1400000U) / hlin->huart->Init.BaudRate;
+
+  return ((us + hlin->TickPeriod - 1U) / hlin->TickPeriod) + 1U;
+}
+
+/**
+  * @brief  Compute the checksum of a frame response.
+  * @param  pFrame Frame, its Checksum selects whether the PID is included.
+  * @param  PID Protected identifier.
+  * @param  pData Response data, pFrame->Length bytes.
+  * @retval Inverted eight bit sum with carry
+  */
+static uint8_t LIN_Checksum(const BSP_LIN_FrameTypeDef *pFrame, uint8_t PID, const uint8_t *pData)
+{
+  uint32_t sum = (pFrame->Checksum == BSP_LIN_CHECKSUM_ENHANCED) ? PID : 0U;
+  uint32_t i;
+
+  for (i = 0U; i < pFrame->Length; i++)
+  {
+    sum += pData[i];
+    if (sum > 0xFFU)
+    {
+      sum -= 0xFFU;
+    }
+  }
+
+  return (uint8_t)(~sum);
+}
+
+/**
+  * @brief  Start the DMA reception of a part of the frame.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  Offset First byte of RxBuffer written.
+  * @param  Length Number of bytes.
+  * @retval None
+  */
+static void LIN_StartReceive(BSP_LIN_TypeDef *hlin, uint32_t Offset, uint32_t Length)
+{
+  UART_HandleTypeDef *huart = hlin->huart;
+
+  if (HAL_DMA_Start_IT(huart->hdmarx, (uint32_t)&huart->Instance->DR,
+                       (uint32_t)&hlin->RxBuffer[Offset], Length) != HAL_OK)
+  {
+    LIN_Abort(hlin);
+    if (hlin->pFrame != NULL)
+    {
+      LIN_EndFrame(hlin, BSP_LIN_STATUS_DMA);
+    }
+    else
+    {
+      hlin->State = LIN_STATE_IDLE;
+      hlin->ErrorCount++;
+    }
+  }
+}
+
+/**
+  * @brief  Send the header of the next frame of the current slot.
+  * @note   Master only, the response of a published frame follows the header in
+  *         the same DMA transfer.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval None
+  */
+static void LIN_StartFrame(BSP_LIN_TypeDef *hlin)
+{
+  UART_HandleTypeDef *huart = hlin->huart;
+  const BSP_LIN_SlotTypeDef *pSlot;
+  BSP_LIN_FrameTypeDef *pFrame;
+  uint32_t length = 2U;
+
+  if (hlin->SlotNumber == 0U)
+  {
+    return;
+  }
+  pSlot = &hlin->pSchedule[hlin->Slot];
+  if (hlin->Frame >= pSlot->FrameNumber)
+  {
+    return;
+  }
+  pFrame = pSlot->ppFrames[hlin->Frame];
+  hlin->Frame++;
+
+  if ((pFrame->Length == 0U) || (pFrame->Length > LIN_DATA_MAX))
+  {
+    pFrame->Status = BSP_LIN_STATUS_HEADER;
+    hlin->ErrorCount++;
+    return;
+  }
+
+  hlin->TxBuffer[0] = LIN_SYNC;
+  hlin->TxBuffer[1] = BSP_LIN_GetPID(pFrame->Id);
+  if (pFrame->Direction == BSP_LIN_PUBLISH)
+  {
+    memcpy(&hlin->TxBuffer[2], pFrame->pData, pFrame->Length);
+    hlin->TxBuffer[2U + pFrame->Length] = LIN_Checksum(pFrame, hlin->TxBuffer[1], &hlin->TxBuffer[2]);
+    length += (uint32_t)pFrame->Length + 1U;
+  }
+
+  hlin->pFrame  = pFrame;
+  hlin->State   = LIN_STATE_BREAK;
+  hlin->Timeout = LIN_GetTicks(hlin, LIN_HEADER_BITS + (LIN_BYTE_BITS * ((uint32_t)pFrame->Length + 1U)));
+
+  /* As HAL_LIN_SendBreak() without giving gState back, the sync field follows the break */
+  SET_BIT(huart->Instance->CR1, USART_CR1_SBK);
+  if (HAL_DMA_Start_IT(huart->hdmatx, (uint32_t)hlin->TxBuffer, (uint32_t)&huart->Instance->DR, length) != HAL_OK)
+  {
+    LIN_Abort(hlin);
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_DMA);
+  }
+}
+
+/**
+  * @brief  Start the response of the header received by a slave.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval None
+  */
+static void LIN_StartResponse(BSP_LIN_TypeDef *hlin)
+{
+  UART_HandleTypeDef *huart = hlin->huart;
+  BSP_LIN_FrameTypeDef *pFrame = NULL;
+  uint32_t length;
+  uint32_t i;
+
+  if ((hlin->RxBuffer[0] != LIN_SYNC) || (hlin->RxBuffer[1] != BSP_LIN_GetPID(hlin->RxBuffer[1])))
+  {
+    hlin->State = LIN_STATE_IDLE;
+    hlin->ErrorCount++;
+    return;
+  }
+
+  for (i = 0U; i < hlin->FrameNumber; i++)
+  {
+    if (hlin->ppFrames[i]->Id == (hlin->RxBuffer[1] & LIN_ID_MAX))
+    {
+      pFrame = hlin->ppFrames[i];
+      break;
+    }
+  }
+  if ((pFrame == NULL) || (pFrame->Length == 0U) || (pFrame->Length > LIN_DATA_MAX))
+  {
+    /* Frame of another node */
+    hlin->State = LIN_STATE_IDLE;
+    return;
+  }
+
+  length = (uint32_t)pFrame->Length + 1U;
+  hlin->pFrame  = pFrame;
+  hlin->State   = LIN_STATE_RESPONSE;
+  hlin->Timeout = LIN_GetTicks(hlin, LIN_BYTE_BITS * length);
+
+  /* A published response is read back to check it against the bus */
+  LIN_StartReceive(hlin, 2U, length);
+  if ((pFrame->Direction == BSP_LIN_PUBLISH) && (hlin->State == LIN_STATE_RESPONSE))
+  {
+    memcpy(&hlin->TxBuffer[2], pFrame->pData, pFrame->Length);
+    hlin->TxBuffer[2U + pFrame->Length] = LIN_Checksum(pFrame, hlin->RxBuffer[1], &hlin->TxBuffer[2]);
+    if (HAL_DMA_Start_IT(huart->hdmatx, (uint32_t)&hlin->TxBuffer[2], (uint32_t)&huart->Instance->DR, length) != HAL_OK)
+    {
+      LIN_Abort(hlin);
+      LIN_EndFrame(hlin, BSP_LIN_STATUS_DMA);
+    }
+  }
+}
+
+/**
+  * @brief  End the frame on the bus and start the next one of the slot.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @param  Status A value of @ref BSP_LIN_Status.
+  * @retval None
+  */
+static void LIN_EndFrame(BSP_LIN_TypeDef *hlin, uint32_t Status)
+{
+  BSP_LIN_FrameTypeDef *pFrame = hlin->pFrame;
+
+  hlin->pFrame  = NULL;
+  hlin->State   = LIN_STATE_IDLE;
+  hlin->Timeout = 0U;
+
+  pFrame->Status = Status;
+  if (Status != BSP_LIN_STATUS_OK)
+  {
+    hlin->ErrorCount++;
+  }
+  BSP_LIN_FrameCallback(hlin, pFrame);
+
+  if (hlin->Mode == BSP_LIN_MODE_MASTER)
+  {
+    LIN_StartFrame(hlin);
+  }
+}
+
+/**
+  * @brief  Stop the DMA transfers of the frame on the bus.
+  * @param  hlin Pointer to a BSP_LIN_TypeDef structure.
+  * @retval None
+  */
+static void LIN_Abort(BSP_LIN_TypeDef *hlin)
+{
+  (void)HAL_DMA_Abort(hlin->huart->hdmatx);
+  (void)HAL_DMA_Abort(hlin->huart->hdmarx);
+}
+
+/**
+  * @brief  Rx DMA complete callback, the header or the response is received.
+  * @param  hdma Pointer to the hdmarx of the node UART.
+  * @retval None
+  */
+static void LIN_DMARxCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_LIN_TypeDef *hlin = LIN_GetNode(hdma);
+  BSP_LIN_FrameTypeDef *pFrame;
+  uint32_t length;
+
+  if (hlin == NULL)
+  {
+    return;
+  }
+
+  if (hlin->State == LIN_STATE_HEADER)
+  {
+    LIN_StartResponse(hlin);
+    return;
+  }
+  if ((hlin->State != LIN_STATE_RESPONSE) || (hlin->pFrame == NULL))
+  {
+    return;
+  }
+
+  pFrame = hlin->pFrame;
+  length = (uint32_t)pFrame->Length + 1U;
+
+  if ((hlin->RxBuffer[0] != LIN_SYNC) || (hlin->RxBuffer[1] != BSP_LIN_GetPID(pFrame->Id)))
+  {
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_HEADER);
+  }
+  else if (pFrame->Direction == BSP_LIN_PUBLISH)
+  {
+    /* The bytes read back must be the ones sent */
+    if (memcmp(&hlin->RxBuffer[2], &hlin->TxBuffer[2], length) != 0)
+    {
+      LIN_EndFrame(hlin, BSP_LIN_STATUS_BIT);
+    }
+    else
+    {
+      LIN_EndFrame(hlin, BSP_LIN_STATUS_OK);
+    }
+  }
+  else if (hlin->RxBuffer[1U + length] != LIN_Checksum(pFrame, hlin->RxBuffer[1], &hlin->RxBuffer[2]))
+  {
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_CHECKSUM);
+  }
+  else
+  {
+    memcpy(pFrame->pData, &hlin->RxBuffer[2], pFrame->Length);
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_OK);
+  }
+}
+
+/**
+  * @brief  DMA error callback.
+  * @param  hdma Pointer to the hdmarx or hdmatx of the node UART.
+  * @retval None
+  */
+static void LIN_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_LIN_TypeDef *hlin = LIN_GetNode(hdma);
+
+  if ((hlin == NULL) || (hlin->State == LIN_STATE_IDLE))
+  {
+    return;
+  }
+
+  LIN_Abort(hlin);
+  if (hlin->pFrame != NULL)
+  {
+    LIN_EndFrame(hlin, BSP_LIN_STATUS_DMA);
+  }
+  else
+  {
+    hlin->State = LIN_STATE_IDLE;
+    hlin->ErrorCount++;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,538 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_log.c
+  * @author  MCU Application Team
+  * @brief   Deferred log BSP service.
+  *          This file provides a binary log cheap enough for interrupt handlers:
+  *           + Log macros writing a format ID, a timestamp and raw arguments
+  *           + Format strings in a section of the ELF left out of the image
+  *           + A lock free word ring drained by the UART DMA, the ITM or the
+  *             debugger, decoded on the host by Misc/Tools/logdecode.py
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_LOG=y, defining USE_BSP_LOG: BSP_LOG_ERROR(),
+       BSP_LOG_WARN(), BSP_LOG_INFO() and BSP_LOG_DEBUG() then record a printf
+       format and up to BSP_LOG_ARGS_MAX arguments, otherwise they compile to
+       nothing and can stay in the code. BSP_LOG_LEVEL, a value of
+       @ref BSP_LOG_Level, leaves the records of the lower levels out.
+
+   (#) The format, with the level, the file and the line, is a string constant
+       of the .bsplog section, not loaded by the linker script: it costs no
+       flash. Its offset in the section is the ID of the record, which is only
+       the words {sync | argument count | ID, DWT cycle count, arguments}. The
+       formatting is done on the host, a record costs a few tens of cycles.
+
+   (#) The arguments are 32-bit words: integers and pointers for %d, %u, %x,
+       %c and %p, BSP_LOG_FLOAT() for %f, %e and %g, the float converted on
+       the host, BSP_LOG_STRING() of a string constant for %s, kept in .bsplog
+       as the formats. 64-bit arguments and strings in RAM are not supported.
+
+   (#) Call BSP_LOG_Init() with a ring buffer of a power of two words. The
+       records are written with exclusive accesses (LDREX/STREX), from thread
+       mode and from interrupt handlers of any priority without masking the
+       interrupts. A record which does not fit is dropped whole; the number of
+       records lost is written in the ring, as a BSP_LOG_ID_DROPPED record, by
+       the next record which fits. BSP_LOG_GetDropped() returns the total.
+
+   (#) The ring is drained by the transport, BSP_LOG_Process() handing the
+       records written to it, from the main loop or an idle hook:
+       (+) BSP_LOG_TRANSPORT_MEMORY, the default: the ring stays in RAM, the
+           host reads the BSP_Log control block through the debugger while the
+           core runs, as RTT does, and writes Released. Records are dropped
+           when no debugger reads them.
+       (+) BSP_LOG_TRANSPORT_UART with BSP_LOG_ConfigUart(): the UART DMA sends
+           the ring in the largest contiguous chunks. When
+           USE_HAL_UART_REGISTER_CALLBACKS is 0, call BSP_LOG_TxCpltCallback()
+           from HAL_UART_TxCpltCallback().
+       (+) BSP_LOG_TRANSPORT_ITM with BSP_LOG_ConfigITM(): the words are written
+           to the stimulus port BSP_LOG_ITM_PORT and sent on SWO at SwoHz.
+
+   (#) From a fault handler, call BSP_LOG_Flush() to send the rest of the ring
+       by polling, without interrupts nor SysTick.
+
+   (#) On the host, Misc/Tools/logdecode.py reads .bsplog from the ELF and
+       prints the records of a serial port, of a file, a raw capture of SWO
+       with --itm, or of the ring in RAM with --pyocd.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_log.h"
+#include "py32f4xx_bsp_trace.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_LOG BSP LOG
+  * @brief Deferred log BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_LOG_Private_Constants BSP LOG Private Constants
+  * @{
+  */
+#define LOG_HEADER_WORDS          2U          /*!< Sync, count and ID, then the cycle count */
+#define LOG_COUNT_POS             24U
+#define LOG_MAX_XFER_WORDS        (0xFFFFU / 4U) /*!< Largest DMA transfer, CNDTR is 16-bit */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_LOG_Private_Variables BSP LOG Private Variables
+  * @{
+  */
+/* Not static, the host finds the control block by its symbol */
+BSP_LOG_TypeDef BSP_Log;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_LOG_Private_Functions
+  * @{
+  */
+static void     LOG_Add(__IO uint32_t *pCounter, uint32_t Value);
+static uint32_t LOG_Take(__IO uint32_t *pCounter);
+static uint32_t LOG_Put(uint32_t Id, uint32_t Count, const uint32_t *pArgs);
+static void     LOG_Kick(void);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_LOG_Exported_Functions BSP LOG Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the deferred log, with the memory transport.
+  * @note   Starts the DWT cycle counter of the timestamps.
+  * @param  pBuffer Pointer to the ring storage.
+  * @param  Size Size of the ring in words, a power of two.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LOG_Init(uint32_t *pBuffer, uint32_t Size)
+{
+  if ((pBuffer == NULL) || (Size < (LOG_HEADER_WORDS + BSP_LOG_ARGS_MAX)) || ((Size & (Size - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  BSP_Log.Magic     = 0U;
+  BSP_Log.pBuffer   = NULL;
+  BSP_Log.Size      = Size;
+  BSP_Log.Reserved  = 0U;
+  BSP_Log.Committed = 0U;
+  BSP_Log.Writers   = 0U;
+  BSP_Log.Released  = 0U;
+  BSP_Log.Queued    = 0U;
+  BSP_Log.XferSize  = 0U;
+  BSP_Log.Lost      = 0U;
+  BSP_Log.Dropped   = 0U;
+  BSP_Log.Transport = BSP_LOG_TRANSPORT_MEMORY;
+
+  /* The ring is used by the writers as soon as pBuffer is set */
+  __DMB();
+  BSP_Log.pBuffer   = pBuffer;
+  BSP_Log.Magic     = BSP_LOG_MAGIC;
+
+  return HAL_OK;
+}
+
+#if defined (HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  Drain the ring with the UART DMA.
+  * @param  huart Pointer to a UART_HandleTypeDef structure, its hdmatx must be linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LOG_ConfigUart(UART_HandleTypeDef *huart)
+{
+  if ((BSP_Log.pBuffer == NULL) || (huart == NULL) || (huart->hdmatx == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  if (HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID, BSP_LOG_TxCpltCallback) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+  BSP_Log.huart     = huart;
+  BSP_Log.Transport = BSP_LOG_TRANSPORT_UART;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  UART transmit complete handler of the deferred log.
+  * @note   To be called from HAL_UART_TxCpltCallback() when
+  *         USE_HAL_UART_REGISTER_CALLBACKS is 0. Other UARTs are ignored.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_LOG_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if ((BSP_Log.Transport != BSP_LOG_TRANSPORT_UART) || (huart != BSP_Log.huart))
+  {
+    return;
+  }
+
+  BSP_Log.Released = BSP_Log.Queued;
+  BSP_Log.XferSize = 0U;
+
+  LOG_Kick();
+}
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @brief  Assign the SWO pin and drain the ring to the ITM stimulus port BSP_LOG_ITM_PORT.
+  * @param  SwoHz SWO bit rate in NRZ, a divider of HCLK.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LOG_ConfigITM(uint32_t SwoHz)
+{
+  if ((BSP_Log.pBuffer == NULL) || (BSP_TRACE_Init(SwoHz) != HAL_OK) ||
+      (BSP_TRACE_EnablePort(BSP_LOG_ITM_PORT) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  BSP_Log.Transport = BSP_LOG_TRANSPORT_ITM;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write a record, called by the BSP_LOG macros.
+  * @param  Id Offset of the format in the .bsplog section.
+  * @param  Count Number of arguments, up to BSP_LOG_ARGS_MAX.
+  * @param  pArgs Pointer to the arguments.
+  * @retval None
+  */
+void BSP_LOG_Write(uint32_t Id, uint32_t Count, const uint32_t *pArgs)
+{
+  uint32_t lost;
+
+  if (BSP_Log.pBuffer == NULL)
+  {
+    return;
+  }
+
+  if (BSP_Log.Lost != 0U)
+  {
+    /* Report the records lost before this one, given back if it does not fit either */
+    lost = LOG_Take(&BSP_Log.Lost);
+    if ((lost != 0U) && (LOG_Put(BSP_LOG_ID_DROPPED, 1U, &lost) == 0U))
+    {
+      LOG_Add(&BSP_Log.Lost, lost);
+    }
+  }
+
+  if (LOG_Put(Id & BSP_LOG_ID_DROPPED, (Count > BSP_LOG_ARGS_MAX) ? BSP_LOG_ARGS_MAX : Count, pArgs) == 0U)
+  {
+    LOG_Add(&BSP_Log.Lost, 1U);
+    LOG_Add(&BSP_Log.Dropped, 1U);
+  }
+}
+
+/**
+  * @brief  Hand the records written to the transport.
+  * @note   Call from the main loop or an idle hook. The ITM transport writes the
+  *         records to the stimulus port in the call, waiting for the port to be
+  *         ready; the UART transport starts a DMA transfer when the UART is idle.
+  * @retval None
+  */
+void BSP_LOG_Process(void)
+{
+  uint32_t committed;
+
+  if (BSP_Log.pBuffer == NULL)
+  {
+    return;
+  }
+
+  if (BSP_Log.Transport == BSP_LOG_TRANSPORT_ITM)
+  {
+    if (((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0U) || ((ITM->TER & (1UL << BSP_LOG_ITM_PORT)) == 0U))
+    {
+      return;
+    }
+    committed = BSP_Log.Committed;
+    while (BSP_Log.Released != committed)
+    {
+      while (ITM->PORT[BSP_LOG_ITM_PORT].u32 == 0U)
+      {
+      }
+      ITM->PORT[BSP_LOG_ITM_PORT].u32 = BSP_Log.pBuffer[BSP_Log.Released & (BSP_Log.Size - 1U)];
+      BSP_Log.Released++;
+    }
+    BSP_Log.Queued = committed;
+  }
+  else if (BSP_Log.Transport == BSP_LOG_TRANSPORT_UART)
+  {
+    LOG_Kick();
+  }
+  else
+  {
+    /* Memory transport, Released is written by the host */
+  }
+}
+
+/**
+  * @brief  Send the rest of the ring by polling.
+  * @note   Intended for fault handlers: interrupts are masked during the call and
+  *         neither the UART nor the DMA interrupts nor the SysTick are needed.
+  *         A record still being written by an interrupted writer is not sent.
+  *         Nothing is done with the memory transport, the debugger reads the ring.
+  * @retval None
+  */
+void BSP_LOG_Flush(void)
+{
+  uint32_t primask_bit;
+#if defined (HAL_UART_MODULE_ENABLED)
+  UART_HandleTypeDef *huart = BSP_Log.huart;
+  uint32_t word;
+  uint32_t sent;
+  uint32_t i;
+#endif /* HAL_UART_MODULE_ENABLED */
+
+  if (BSP_Log.pBuffer == NULL)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+#if defined (HAL_UART_MODULE_ENABLED)
+  if (BSP_Log.Transport == BSP_LOG_TRANSPORT_UART)
+  {
+    if (BSP_Log.XferSize != 0U)
+    {
+      /* Stop the DMA and resend the words it did not send completely */
+      sent = ((BSP_Log.XferSize * 4U) - __HAL_DMA_GET_COUNTER(huart->hdmatx)) / 4U;
+      (void)HAL_UART_AbortTransmit(huart);
+      BSP_Log.Queued   = BSP_Log.Released + sent;
+      BSP_Log.XferSize = 0U;
+    }
+
+    while (BSP_Log.Queued != BSP_Log.Committed)
+    {
+      word = BSP_Log.pBuffer[BSP_Log.Queued & (BSP_Log.Size - 1U)];
+      for (i = 0U; i < 4U; i++)
+      {
+        while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TXE) == RESET)
+        {
+        }
+        huart->Instance->DR = (word >> (8U * i)) & 0xFFU;
+      }
+      BSP_Log.Queued++;
+    }
+    while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TC) == RESET)
+    {
+    }
+    BSP_Log.Released = BSP_Log.Queued;
+  }
+#endif /* HAL_UART_MODULE_ENABLED */
+
+  if (BSP_Log.Transport == BSP_LOG_TRANSPORT_ITM)
+  {
+    BSP_LOG_Process();
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Return the number of records lost on overflow since BSP_LOG_Init().
+  * @retval Number of records
+  */
+uint32_t BSP_LOG_GetDropped(void)
+{
+  return BSP_Log.Dropped;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LOG_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Atomically add a value to a counter.
+  * @param  pCounter Pointer to the counter.
+  * @param  Value Value to add, modulo 2^32.
+  * @retval None
+  */
+static void LOG_Add(__IO uint32_t *pCounter, uint32_t Value)
+{
+  uint32_t counter;
+
+  do
+  {
+    counter = __LDREXW(pCounter) + Value;
+  } while (__STREXW(counter, pCounter) != 0U);
+}
+
+/**
+  * @brief  Atomically read and clear a counter.
+  * @param  pCounter Pointer to the counter.
+  * @retval Value of the counter
+  */
+static uint32_t LOG_Take(__IO uint32_t *pCounter)
+{
+  uint32_t counter;
+
+  do
+  {
+    counter = __LDREXW(pCounter);
+  } while (__STREXW(0U, pCounter) != 0U);
+
+  return counter;
+}
+
+/**
+  * @brief  Write a record in the ring if it fits.
+  * @note   Writers preempting each other complete in reverse order, so the last
+  *         writer to leave is the outermost one and all the records reserved at
+  *         that time are written. Only this writer publishes them.
+  * @param  Id ID of the record.
+  * @param  Count Number of arguments.
+  * @param  pArgs Pointer to the arguments.
+  * @retval Number of words written, 0 when the record did not fit
+  */
+static uint32_t LOG_Put(uint32_t Id, uint32_t Count, const uint32_t *pArgs)
+{
+  uint32_t *buffer = BSP_Log.pBuffer;
+  uint32_t mask = BSP_Log.Size - 1U;
+  uint32_t length = LOG_HEADER_WORDS + Count;
+  uint32_t reserved;
+  uint32_t writers;
+  uint32_t i;
+
+  LOG_Add(&BSP_Log.Writers, 1U);
+
+  /* A record is reserved whole or not at all */
+  do
+  {
+    reserved = __LDREXW(&BSP_Log.Reserved);
+    if ((BSP_Log.Size - (reserved - BSP_Log.Released)) < length)
+    {
+      __CLREX();
+      length = 0U;
+      break;
+    }
+  } while (__STREXW(reserved + length, &BSP_Log.Reserved) != 0U);
+
+  if (length != 0U)
+  {
+    buffer[reserved & mask]         = BSP_LOG_SYNC | (Count << LOG_COUNT_POS) | Id;
+    buffer[(reserved + 1U) & mask]  = DWT->CYCCNT;
+    for (i = 0U; i < Count; i++)
+    {
+      buffer[(reserved + LOG_HEADER_WORDS + i) & mask] = pArgs[i];
+    }
+  }
+
+  do
+  {
+    writers = __LDREXW(&BSP_Log.Writers) - 1U;
+  } while (__STREXW(writers, &BSP_Log.Writers) != 0U);
+
+  if (writers == 0U)
+  {
+    /* A writer preempting this loop clears the exclusive monitor, Reserved is then read again */
+    do
+    {
+      (void)__LDREXW(&BSP_Log.Committed);
+      reserved = BSP_Log.Reserved;
+    } while (__STREXW(reserved, &BSP_Log.Committed) != 0U);
+  }
+
+  return length;
+}
+
+/**
+  * @brief  Start a UART DMA transfer of the records written when the UART is idle.
+  * @note   The transfer takes the largest contiguous chunk, up to the end of the ring.
+  * @retval None
+  */
+static void LOG_Kick(void)
+{
+#if defined (HAL_UART_MODULE_ENABLED)
+  uint32_t primask_bit;
+  uint32_t offset;
+  uint32_t length;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  length = BSP_Log.Committed - BSP_Log.Queued;
+  if ((BSP_Log.XferSize == 0U) && (length != 0U))
+  {
+    offset = BSP_Log.Queued & (BSP_Log.Size - 1U);
+    if (length > (BSP_Log.Size - offset))
+    {
+      length = BSP_Log.Size - offset;
+    }
+    if (length > LOG_MAX_XFER_WORDS)
+    {
+      length = LOG_MAX_XFER_WORDS;
+    }
+
+    BSP_Log.XferSize = length;
+    BSP_Log.Queued  += length;
+
+    if (HAL_UART_Transmit_DMA(BSP_Log.huart, (uint8_t *)&BSP_Log.pBuffer[offset], (uint16_t)(length * 4U)) != HAL_OK)
+    {
+      /* UART busy with another transmission, retried on the next BSP_LOG_Process() */
+      BSP_Log.Queued  -= length;
+      BSP_Log.XferSize = 0U;
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+#endif /* HAL_UART_MODULE_ENABLED */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
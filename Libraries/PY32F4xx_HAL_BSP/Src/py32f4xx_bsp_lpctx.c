@@ -0,0 +1,322 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lpctx.c
+  * @author  MCU Application Team
+  * @brief   Low-power clock context BSP service.
+  *          This file provides functions to come back from the STOP mode
+  *          on the clock tree of the entry quickly:
+  *           + RCC, flash latency and peripheral clocks saved at the entry
+  *           + Flash and regulator wakeup delays set
+  *           + Restore without the timeouts of the RCC HAL, zero wait
+  *             states while on HSI
+  *           + Restore latency measured with the DWT cycle counter
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The CPU leaves the STOP mode on HSI, the HSE and the PLL stopped.
+       Running the clock configuration of the startup again goes through
+       HAL_RCC_OscConfig() and HAL_RCC_ClockConfig(): their tick timeouts,
+       the checks and the PLL programmed again, on HSI with the wait states
+       of the full speed. This service restarts the oscillators of the
+       entry from the registers kept in STOP mode.
+
+   (#) Fill a BSP_LPCTX_InitTypeDef with BSP_LPCTX_StructInit() and change
+       the settings, then call BSP_LPCTX_Init():
+       (+) FlashDelay: wait of the flash after the wakeup. The default
+           BSP_LPCTX_FLASH_DELAY of 2 us is below the 3 us of the reset,
+           PWR_WAKEUP_FLASH_DELAY_0US is for the main regulator kept on in
+           STOP mode.
+       (+) MrReadyDelay: wait of the main regulator, used by the device on
+           the STANDBY wakeup only.
+       (+) HSIWait: 0 starts HSI with the main regulator instead of after it.
+       (+) Regulator: regulator in STOP mode for BSP_LPCTX_EnterStop(), the
+           low-power one draws less and wakes slower.
+
+   (#) BSP_LPCTX_EnterStop() saves the context, enters the STOP mode with WFI
+       and restores the context. To enter the STOP mode otherwise, call
+       BSP_LPCTX_Save() before and BSP_LPCTX_Restore() after, interrupts
+       disabled: an interrupt handler would run on HSI.
+
+   (#) BSP_LPCTX_Restore():
+       (+) sets zero wait states while on HSI, the CPU runs at its HSI speed
+           and not at the speed of the wait states of the entry,
+       (+) starts the HSE when it was on, then the PLL as soon as the HSE is
+           ready, its multiplier and source kept from the entry,
+       (+) sets the wait states of the entry then the SYSCLK source of the
+           entry,
+       (+) enables again the peripheral clocks of the entry, those gated
+           after BSP_LPCTX_Save() to draw less in STOP mode come back.
+       When the HSE or the PLL do not start, the CPU stays on HSI with
+       SystemCoreClock and the tick updated, HAL_TIMEOUT is returned.
+
+   (#) Stats.LastLatency and MaxLatency give the restore time in ns, from the
+       return of WFI to the clock of the entry, counted by the DWT cycle
+       counter at the HSI speed. The hardware wakeup before, the flash delay
+       and the regulator start, is not part of it. HAL_GetTick() runs slow
+       during the restore, by the HSI to HCLK ratio.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_lpctx.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_LPCTX BSP LPCTX
+  * @brief Low-power clock context BSP service
+  * @{
+  */
+
+#if defined (HAL_PWR_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_LPCTX_Private_Constants BSP LPCTX Private Constants
+  * @{
+  */
+#define LPCTX_WAIT_LOOPS                0x00100000U    /* Polls of a flag, half a second on HSI       */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_LPCTX_Private_Functions BSP LPCTX Private Functions
+  * @{
+  */
+static HAL_StatusTypeDef LPCTX_Wait(__IO uint32_t *pReg, uint32_t Mask, uint32_t Value);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_LPCTX_Exported_Functions BSP LPCTX Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Fill wakeup settings with the defaults of @ref BSP_LPCTX_Defaults.
+  * @param  pInit Wakeup settings.
+  * @retval None
+  */
+void BSP_LPCTX_StructInit(BSP_LPCTX_InitTypeDef *pInit)
+{
+  pInit->FlashDelay   = BSP_LPCTX_FLASH_DELAY;
+  pInit->MrReadyDelay = BSP_LPCTX_MRREADY_DELAY;
+  pInit->HSIWait      = BSP_LPCTX_HSI_WAIT;
+  pInit->Regulator    = BSP_LPCTX_REGULATOR;
+}
+
+/**
+  * @brief  Apply the wakeup settings and start the cycle counter.
+  * @param  hctx Pointer to a BSP_LPCTX_TypeDef structure.
+  * @param  pInit Wakeup settings.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LPCTX_Init(BSP_LPCTX_TypeDef *hctx, const BSP_LPCTX_InitTypeDef *pInit)
+{
+  if ((hctx == NULL) || (pInit == NULL) || ((pInit->FlashDelay & ~PWR_CR_FLS_WUPT) != 0U) ||
+      ((pInit->MrReadyDelay & ~PWR_CR_STDBY_MRRDY_WAIT) != 0U) || (pInit->HSIWait > 1U) ||
+      !IS_PWR_REGULATOR(pInit->Regulator))
+  {
+    return HAL_ERROR;
+  }
+
+  hctx->Init = *pInit;
+  hctx->Stats.Wakeups     = 0U;
+  hctx->Stats.Failures    = 0U;
+  hctx->Stats.LastLatency = 0U;
+  hctx->Stats.MaxLatency  = 0U;
+  BSP_LPCTX_Save(hctx);
+
+  HAL_PWREx_SetWakeupFlashDelay(pInit->FlashDelay);
+  HAL_PWREx_SetWakeupMrReadyDelay(pInit->MrReadyDelay);
+  if (pInit->HSIWait != 0U)
+  {
+    HAL_PWREx_EnableHSIWakeupWait();
+  }
+  else
+  {
+    HAL_PWREx_DisableHSIWakeupWait();
+  }
+
+  HAL_EnableCycleCounter();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Save the clock tree before the STOP mode.
+  * @param  hctx Pointer to a BSP_LPCTX_TypeDef structure.
+  * @retval None
+  */
+void BSP_LPCTX_Save(BSP_LPCTX_TypeDef *hctx)
+{
+  hctx->Cr      = READ_BIT(RCC->CR, RCC_CR_HSEON | RCC_CR_PLLON);
+  hctx->Cfgr    = READ_REG(RCC->CFGR);
+  hctx->Latency = __HAL_FLASH_GET_LATENCY();
+  hctx->Enr[0]  = READ_REG(RCC->AHB1ENR);
+  hctx->Enr[1]  = READ_REG(RCC->AHB2ENR);
+  hctx->Enr[2]  = READ_REG(RCC->APB1ENR);
+  hctx->Enr[3]  = READ_REG(RCC->APB2ENR);
+}
+
+/**
+  * @brief  Restore the clock tree saved, the CPU on HSI after the STOP mode.
+  * @param  hctx Pointer to a BSP_LPCTX_TypeDef structure.
+  * @retval HAL status, HAL_TIMEOUT when left on HSI
+  */
+HAL_StatusTypeDef BSP_LPCTX_Restore(BSP_LPCTX_TypeDef *hctx)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t start = DWT->CYCCNT;
+  uint32_t sw = hctx->Cfgr & RCC_CFGR_SW;
+  uint32_t hclk;
+  uint32_t latency;
+
+  /* HSI is below the first latency step */
+  __HAL_FLASH_SET_LATENCY(FLASH_LATENCY_0);
+
+  if ((hctx->Cr & RCC_CR_HSEON) != 0U)
+  {
+    SET_BIT(RCC->CR, RCC_CR_HSEON);
+    status = LPCTX_Wait(&RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY);
+  }
+  if (((hctx->Cr & RCC_CR_PLLON) != 0U) && (status == HAL_OK))
+  {
+    SET_BIT(RCC->CR, RCC_CR_PLLON);
+    status = LPCTX_Wait(&RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY);
+  }
+
+  if (status == HAL_OK)
+  {
+    __HAL_FLASH_SET_LATENCY(hctx->Latency);
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, sw);
+    (void)LPCTX_Wait(&RCC->CFGR, RCC_CFGR_SWS, sw << RCC_CFGR_SWS_Pos);
+  }
+
+  /* Cycles on HSI up to here, through the AHB prescaler of the entry */
+  hclk = HSI_VALUE >> AHBPrescTable[(hctx->Cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+  latency = (uint32_t)(((uint64_t)(DWT->CYCCNT - start) * 1000000000U) / hclk);
+
+  WRITE_REG(RCC->AHB1ENR, hctx->Enr[0]);
+  WRITE_REG(RCC->AHB2ENR, hctx->Enr[1]);
+  WRITE_REG(RCC->APB1ENR, hctx->Enr[2]);
+  WRITE_REG(RCC->APB2ENR, hctx->Enr[3]);
+
+  if (status != HAL_OK)
+  {
+    CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+    SystemCoreClockUpdate();
+    (void)HAL_InitTick(uwTickPrio);
+    hctx->Stats.Failures++;
+  }
+
+  hctx->Stats.Wakeups++;
+  hctx->Stats.LastLatency = latency;
+  if (latency > hctx->Stats.MaxLatency)
+  {
+    hctx->Stats.MaxLatency = latency;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Enter the STOP mode with WFI and come back on the clock tree of the entry.
+  * @param  hctx Pointer to a BSP_LPCTX_TypeDef structure.
+  * @retval HAL status of BSP_LPCTX_Restore()
+  */
+HAL_StatusTypeDef BSP_LPCTX_EnterStop(BSP_LPCTX_TypeDef *hctx)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  HAL_StatusTypeDef status;
+
+  __disable_irq();
+  BSP_LPCTX_Save(hctx);
+  HAL_PWR_EnterSTOPMode(hctx->Init.Regulator, PWR_STOPENTRY_WFI);
+  status = BSP_LPCTX_Restore(hctx);
+  __set_PRIMASK(primask_bit);
+
+  return status;
+}
+
+/**
+  * @brief  Get the statistics.
+  * @param  hctx Pointer to a BSP_LPCTX_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_LPCTX_GetStats(const BSP_LPCTX_TypeDef *hctx, BSP_LPCTX_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  *pStats = hctx->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LPCTX_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Poll a register for a value, without HAL_GetTick().
+  * @param  pReg Register.
+  * @param  Mask Bits polled.
+  * @param  Value Bits expected.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef LPCTX_Wait(__IO uint32_t *pReg, uint32_t Mask, uint32_t Value)
+{
+  uint32_t loops = LPCTX_WAIT_LOOPS;
+
+  while ((*pReg & Mask) != Value)
+  {
+    if (--loops == 0U)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_PWR_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
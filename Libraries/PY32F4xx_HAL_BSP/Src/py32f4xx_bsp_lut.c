@@ -0,0 +1,533 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lut.c
+  * @author  MCU Application Team
+  * @brief   Lookup table BSP service.
+  *          This file provides functions to convert samples with tables held
+  *          in the flash, in place of a polynomial or a library function:
+  *           + Uniform tables, the interval given by a shift or a product
+  *           + Non uniform tables, branchless binary search of the interval
+  *           + Linear or cubic Hermite interpolation
+  *           + Fixed point tables of ADC codes, float tables
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Generate the table with Misc/Tools/lut2c.py, from an expression of x
+       or from a CSV file of points, and build the .c file written with the
+       application. The table is a const BSP_LUT_I32_TypeDef or
+       BSP_LUT_F32_TypeDef and its points const arrays: they stay in the
+       flash. The tool prints the largest interpolation error over the
+       range: choose the step and the interpolation with it.
+      (+) Fixed point: the abscissas are integers, ADC codes for example,
+          the values in any unit, millidegrees for example. A uniform table
+          has a step of 2^Shift: the interval is the offset from X0 shifted
+          right, the fraction its low bits, with no division.
+      (+) Float: a uniform table has its step inverted once, the interval is
+          the integer part of a product.
+      (+) A non uniform table gives its abscissas, increasing: the interval
+          is found by a binary search with no branch, a conditional select
+          by halving, log2(Count) steps whatever the input. The fraction is
+          one division.
+
+   (#) BSP_LUT_xxx_Eval() converts one value, BSP_LUT_I32_Process() a block
+       of 16-bit ADC samples, in the conversion complete callback for
+       example, BSP_LUT_F32_Process() a block of floats. The inputs out of
+       the table give its first or its last value.
+
+   (#) Linear: the straight line between the two points of the interval.
+       Cubic: a cubic Hermite between them, with at each point the slope
+       between its two neighbours, one sided at the ends: the curve and its
+       slope are continuous, a uniform table gives the Catmull-Rom spline.
+       A cubic table reaches the accuracy of a linear one with far fewer
+       points on smooth curves, for a few more multiplications.
+
+   (#) The fixed point products are in 64 bits, SMLAL, the fraction of a non
+       uniform interval in 16 bits. BSP_LUT_xxx_Check() verifies a table,
+       once at the start: the conversions do not.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_lut.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_LUT BSP LUT
+  * @brief Lookup table BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_LUT_Private_Constants BSP LUT Private Constants
+  * @{
+  */
+#define LUT_FRAC_BITS                   16U            /* Fraction of a non uniform interval          */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_LUT_Private_Functions BSP LUT Private Functions
+  * @{
+  */
+static uint32_t LUT_I32_Search(const int32_t *pX, uint32_t Count, int32_t X);
+static uint32_t LUT_F32_Search(const float *pX, uint32_t Count, float X);
+static int32_t  LUT_I32_Hermite(int32_t P1, int32_t P2, int64_t D1, int64_t D2, int64_t Frac, uint32_t Bits);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_LUT_Exported_Functions BSP LUT Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_LUT_Exported_Functions_Group1 Fixed point functions
+  * @brief    Fixed point tables
+  *
+@verbatim
+ ===============================================================================
+                      ##### Fixed point functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Verify a table
+      (+) Convert a value or a block of ADC samples
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Verify a fixed point table.
+  * @param  pTable Table.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LUT_I32_Check(const BSP_LUT_I32_TypeDef *pTable)
+{
+  uint32_t i;
+
+  if ((pTable == NULL) || (pTable->pY == NULL) || (pTable->Count < 2U) ||
+      ((pTable->Interp != BSP_LUT_LINEAR) && (pTable->Interp != BSP_LUT_CUBIC)))
+  {
+    return HAL_ERROR;
+  }
+  if (pTable->pX == NULL)
+  {
+    return (pTable->Shift <= BSP_LUT_SHIFT_MAX) ? HAL_OK : HAL_ERROR;
+  }
+  for (i = 1U; i < pTable->Count; i++)
+  {
+    if (pTable->pX[i] <= pTable->pX[i - 1U])
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Convert a value with a fixed point table.
+  * @param  pTable Table.
+  * @param  X Abscissa.
+  * @retval Value, the first or the last one out of the table
+  */
+int32_t BSP_LUT_I32_Eval(const BSP_LUT_I32_TypeDef *pTable, int32_t X)
+{
+  const int32_t *py = pTable->pY;
+  const int32_t *px = pTable->pX;
+  uint32_t last = pTable->Count - 1U;
+  uint32_t offset;
+  uint32_t bits;
+  uint32_t i;
+  int64_t frac;
+  int64_t width;
+  int64_t d1;
+  int64_t d2;
+
+  if (px == NULL)
+  {
+    if (X <= pTable->X0)
+    {
+      return py[0];
+    }
+    offset = (uint32_t)X - (uint32_t)pTable->X0;
+    bits   = pTable->Shift;
+    i      = offset >> bits;
+    if (i >= last)
+    {
+      return py[last];
+    }
+    frac = (int64_t)(offset & ((1UL << bits) - 1U));
+    if (pTable->Interp == BSP_LUT_LINEAR)
+    {
+      return py[i] + (int32_t)((((int64_t)py[i + 1U] - py[i]) * frac) >> bits);
+    }
+    d1 = (i == 0U) ? (2 * ((int64_t)py[1] - py[0])) : ((int64_t)py[i + 1U] - py[i - 1U]);
+    d2 = ((i + 1U) == last) ? (2 * ((int64_t)py[last] - py[last - 1U])) : ((int64_t)py[i + 2U] - py[i]);
+  }
+  else
+  {
+    if (X <= px[0])
+    {
+      return py[0];
+    }
+    if (X >= px[last])
+    {
+      return py[last];
+    }
+    i     = LUT_I32_Search(px, pTable->Count, X);
+    bits  = LUT_FRAC_BITS;
+    width = (int64_t)px[i + 1U] - px[i];
+    frac  = (((int64_t)X - px[i]) << LUT_FRAC_BITS) / width;
+    if (pTable->Interp == BSP_LUT_LINEAR)
+    {
+      return py[i] + (int32_t)((((int64_t)py[i + 1U] - py[i]) * frac) >> LUT_FRAC_BITS);
+    }
+    /* Slopes scaled to the width of the interval, through its ratio to the one of the neighbours */
+    d1 = 2 * ((int64_t)py[i + 1U] - py[i]);
+    d2 = d1;
+    if (i != 0U)
+    {
+      d1 = ((2 * ((int64_t)py[i + 1U] - py[i - 1U])) *
+            ((width << LUT_FRAC_BITS) / ((int64_t)px[i + 1U] - px[i - 1U]))) >> LUT_FRAC_BITS;
+    }
+    if ((i + 1U) != last)
+    {
+      d2 = ((2 * ((int64_t)py[i + 2U] - py[i])) *
+            ((width << LUT_FRAC_BITS) / ((int64_t)px[i + 2U] - px[i]))) >> LUT_FRAC_BITS;
+    }
+  }
+
+  return LUT_I32_Hermite(py[i], py[i + 1U], d1, d2, frac, bits);
+}
+
+/**
+  * @brief  Convert a block of ADC samples with a fixed point table.
+  * @param  pTable Table.
+  * @param  pSrc Samples.
+  * @param  pDst Values.
+  * @param  Length Number of samples.
+  * @retval None
+  */
+void BSP_LUT_I32_Process(const BSP_LUT_I32_TypeDef *pTable, const uint16_t *pSrc, int32_t *pDst,
+                         uint32_t Length)
+{
+  const int32_t *py = pTable->pY;
+  uint32_t last = pTable->Count - 1U;
+  uint32_t bits = pTable->Shift;
+  uint32_t mask = (1UL << bits) - 1U;
+  int32_t x0 = pTable->X0;
+  int32_t offset;
+  uint32_t i;
+  uint32_t n;
+
+  if ((pTable->pX != NULL) || (pTable->Interp != BSP_LUT_LINEAR))
+  {
+    for (n = 0U; n < Length; n++)
+    {
+      pDst[n] = BSP_LUT_I32_Eval(pTable, (int32_t)pSrc[n]);
+    }
+    return;
+  }
+
+  /* Uniform and linear, the usual ADC case: a shift, a mask and one product by sample */
+  for (n = 0U; n < Length; n++)
+  {
+    offset = (int32_t)pSrc[n] - x0;
+    if (offset <= 0)
+    {
+      pDst[n] = py[0];
+      continue;
+    }
+    i = (uint32_t)offset >> bits;
+    if (i >= last)
+    {
+      pDst[n] = py[last];
+      continue;
+    }
+    pDst[n] = py[i] + (int32_t)((((int64_t)py[i + 1U] - py[i]) * (int64_t)((uint32_t)offset & mask)) >> bits);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_LUT_Exported_Functions_Group2 Float functions
+  * @brief    Float tables
+  *
+@verbatim
+ ===============================================================================
+                      ##### Float functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Verify a table
+      (+) Convert a value or a block of values
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Verify a float table.
+  * @param  pTable Table.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LUT_F32_Check(const BSP_LUT_F32_TypeDef *pTable)
+{
+  uint32_t i;
+
+  if ((pTable == NULL) || (pTable->pY == NULL) || (pTable->Count < 2U) ||
+      ((pTable->Interp != BSP_LUT_LINEAR) && (pTable->Interp != BSP_LUT_CUBIC)))
+  {
+    return HAL_ERROR;
+  }
+  if (pTable->pX == NULL)
+  {
+    return (pTable->InvStep > 0.0f) ? HAL_OK : HAL_ERROR;
+  }
+  for (i = 1U; i < pTable->Count; i++)
+  {
+    if (!(pTable->pX[i] > pTable->pX[i - 1U]))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Convert a value with a float table.
+  * @param  pTable Table.
+  * @param  X Abscissa.
+  * @retval Value, the first or the last one out of the table
+  */
+float BSP_LUT_F32_Eval(const BSP_LUT_F32_TypeDef *pTable, float X)
+{
+  const float *py = pTable->pY;
+  const float *px = pTable->pX;
+  uint32_t last = pTable->Count - 1U;
+  uint32_t i;
+  float pos;
+  float t;
+  float d;
+  float d1;
+  float d2;
+
+  if (px == NULL)
+  {
+    pos = (X - pTable->X0) * pTable->InvStep;
+    if (!(pos > 0.0f))
+    {
+      return py[0];
+    }
+    if (pos >= (float)last)
+    {
+      return py[last];
+    }
+    i = (uint32_t)pos;
+    t = pos - (float)i;
+    d = py[i + 1U] - py[i];
+    if (pTable->Interp == BSP_LUT_LINEAR)
+    {
+      return py[i] + (d * t);
+    }
+    d1 = (i == 0U) ? (2.0f * d) : (py[i + 1U] - py[i - 1U]);
+    d2 = ((i + 1U) == last) ? (2.0f * d) : (py[i + 2U] - py[i]);
+  }
+  else
+  {
+    if (!(X > px[0]))
+    {
+      return py[0];
+    }
+    if (X >= px[last])
+    {
+      return py[last];
+    }
+    i = LUT_F32_Search(px, pTable->Count, X);
+    t = (X - px[i]) / (px[i + 1U] - px[i]);
+    d = py[i + 1U] - py[i];
+    if (pTable->Interp == BSP_LUT_LINEAR)
+    {
+      return py[i] + (d * t);
+    }
+    d1 = (i == 0U) ? (2.0f * d) :
+         ((2.0f * (py[i + 1U] - py[i - 1U]) * (px[i + 1U] - px[i])) / (px[i + 1U] - px[i - 1U]));
+    d2 = ((i + 1U) == last) ? (2.0f * d) :
+         ((2.0f * (py[i + 2U] - py[i]) * (px[i + 1U] - px[i])) / (px[i + 2U] - px[i]));
+  }
+
+  /* Twice the Hermite cubic, in the powers of t */
+  return py[i] + (0.5f * t * (d1 + (t * (((6.0f * d) - (2.0f * d1) - d2) + (t * (d1 + d2 - (4.0f * d)))))));
+}
+
+/**
+  * @brief  Convert a block of values with a float table.
+  * @param  pTable Table.
+  * @param  pSrc Abscissas.
+  * @param  pDst Values.
+  * @param  Length Number of values.
+  * @retval None
+  */
+void BSP_LUT_F32_Process(const BSP_LUT_F32_TypeDef *pTable, const float *pSrc, float *pDst, uint32_t Length)
+{
+  const float *py = pTable->pY;
+  float limit = (float)(pTable->Count - 1U);
+  float x0 = pTable->X0;
+  float inv = pTable->InvStep;
+  float pos;
+  uint32_t i;
+  uint32_t n;
+
+  if ((pTable->pX != NULL) || (pTable->Interp != BSP_LUT_LINEAR))
+  {
+    for (n = 0U; n < Length; n++)
+    {
+      pDst[n] = BSP_LUT_F32_Eval(pTable, pSrc[n]);
+    }
+    return;
+  }
+
+  /* Uniform and linear: the position limited, then a conversion and one product by sample */
+  for (n = 0U; n < Length; n++)
+  {
+    pos = (pSrc[n] - x0) * inv;
+    pos = (pos > 0.0f) ? pos : 0.0f;
+    pos = (pos < limit) ? pos : limit;
+    i = (uint32_t)pos;
+    i = (i < (pTable->Count - 1U)) ? i : (pTable->Count - 2U);
+    pDst[n] = py[i] + ((py[i + 1U] - py[i]) * (pos - (float)i));
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LUT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Interval of a value in a fixed point non uniform table.
+  * @param  pX Abscissas, pX[0] < X < pX[Count - 1].
+  * @param  Count Points.
+  * @param  X Abscissa.
+  * @retval Index i of the interval, pX[i] <= X < pX[i + 1]
+  */
+static uint32_t LUT_I32_Search(const int32_t *pX, uint32_t Count, int32_t X)
+{
+  const int32_t *base = pX;
+  uint32_t n = Count - 1U;
+  uint32_t half;
+
+  /* The interval is in [base, base + n): a select, not a branch, halves it */
+  while (n > 1U)
+  {
+    half = n >> 1;
+    base = (base[half] <= X) ? &base[half] : base;
+    n -= half;
+  }
+
+  return (uint32_t)(base - pX);
+}
+
+/**
+  * @brief  Interval of a value in a float non uniform table.
+  * @param  pX Abscissas, pX[0] < X < pX[Count - 1].
+  * @param  Count Points.
+  * @param  X Abscissa.
+  * @retval Index i of the interval, pX[i] <= X < pX[i + 1]
+  */
+static uint32_t LUT_F32_Search(const float *pX, uint32_t Count, float X)
+{
+  const float *base = pX;
+  uint32_t n = Count - 1U;
+  uint32_t half;
+
+  while (n > 1U)
+  {
+    half = n >> 1;
+    base = (base[half] <= X) ? &base[half] : base;
+    n -= half;
+  }
+
+  return (uint32_t)(base - pX);
+}
+
+/**
+  * @brief  Cubic Hermite between two points, in fixed point.
+  * @param  P1 Value at the start of the interval.
+  * @param  P2 Value at the end of the interval.
+  * @param  D1 Twice the slope at the start, times the width of the interval.
+  * @param  D2 Twice the slope at the end, times the width of the interval.
+  * @param  Frac Position in the interval, 0 to 2^Bits - 1.
+  * @param  Bits Bits of the position.
+  * @retval Value, saturated to 32 bits
+  */
+static int32_t LUT_I32_Hermite(int32_t P1, int32_t P2, int64_t D1, int64_t D2, int64_t Frac, uint32_t Bits)
+{
+  int64_t d = (int64_t)P2 - P1;
+  int64_t acc;
+
+  /* Twice the cubic, in the powers of t: Horner with a shift by step */
+  acc = D1 + D2 - (4 * d);
+  acc = ((acc * Frac) >> Bits) + (6 * d) - (2 * D1) - D2;
+  acc = ((acc * Frac) >> Bits) + D1;
+  acc = (int64_t)P1 + (((acc * Frac) >> Bits) >> 1);
+
+  if (acc > (int64_t)0x7FFFFFFF)
+  {
+    return 0x7FFFFFFF;
+  }
+  if (acc < ((int64_t)-0x7FFFFFFF - 1))
+  {
+    return -0x7FFFFFFF - 1;
+  }
+
+  return (int32_t)acc;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,687 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_lzss.c
+  * @author  MCU Application Team
+  * @brief   LZSS streaming compression BSP service.
+  *          This file compresses the logs and the telemetry before they are
+  *          written to the flash, the SD card or the ESMC flash, and expands
+  *          the firmware images received compressed:
+  *           + Streaming encoder and decoder, any input and output sizes
+  *           + Fixed window given by the application, no malloc
+  *           + Optional match index, speed for RAM
+  *           + Pipeline stage in front of a writer
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The stream is the one of heatshrink: a 1 bit then a literal byte, or
+       a 0 bit, the distance minus 1 on WindowBits bits and the length minus
+       1 on LookaheadBits bits, most significant bit first, the last byte
+       padded with 0. Both ends use the same WindowBits, 4 to 12, and
+       LookaheadBits, 3 to WindowBits - 1: 10 and 4 suit the text logs and
+       the telemetry records, 3 to 5 times smaller.
+
+   (#) BSP_LZSS_EncInit() takes a window buffer of BSP_LZSS_ENC_WINDOW_SIZE()
+       bytes and an index of BSP_LZSS_ENC_INDEX_SIZE() half words, or NULL.
+       Without the index every position of the window is tried for a match,
+       for 2 KB of RAM with a 1 KB window; the index chains the positions of
+       each byte value, BSP_LZSS_CHAIN_MAX tried, several times faster for
+       4.5 KB more.
+
+   (#) BSP_LZSS_Encode() takes what it can of the input and writes what it
+       can of the output, *pInUsed and *pOutUsed telling how much, and
+       returns HAL_BUSY when the output is full, HAL_OK when all the input is
+       taken. Up to 2^LookaheadBits bytes stay in the window until more input
+       comes or Finish is set: Finish writes them and the padding, and
+       HAL_OK means the stream is complete. BSP_LZSS_EncReset() starts the
+       next stream. The output never exceeds BSP_LZSS_BOUND() of the input.
+
+   (#) BSP_LZSS_Decode() works the same, with a window of
+       BSP_LZSS_DEC_WINDOW_SIZE() bytes: the firmware update path decodes
+       the chunks received in a buffer of a flash page and hands it to
+       BSP_FWUPDATE_Write(), the CRC of the image being the one of the data
+       decoded.
+
+   (#) BSP_LZSS_StageInit() prepares the context of a BSP_PIPE stage, given
+       to BSP_PIPE_AddStage() with BSP_LZSS_StageProcess(), in front of the
+       stage writing to BSP_SDSTREAM, BSP_FLASHLOG or BSP_ESMCQUEUE. The
+       stage fills blocks of the pool with the stream and sends each full
+       one down with BSP_PIPE_Emit(), keeping the Timestamp of its oldest
+       data. BSP_LZSS_StageFinish(), from the context of BSP_PIPE_Process(),
+       ends the stream and sends the last block when the log is closed.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_lzss.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_LZSS BSP LZSS
+  * @brief LZSS streaming compression BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_LZSS_Private_Constants BSP LZSS Private Constants
+  * @{
+  */
+#define LZSS_NONE                       0xFFFFU        /*!< End of a match chain                            */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_LZSS_Private_Functions BSP LZSS Private Functions
+  * @{
+  */
+static uint32_t LZSS_Match(const BSP_LZSS_EncTypeDef *henc, uint32_t MaxLength, uint32_t *pDistance);
+static void     LZSS_Insert(BSP_LZSS_EncTypeDef *henc, uint32_t Count);
+static void     LZSS_Slide(BSP_LZSS_EncTypeDef *henc);
+static void     LZSS_PutBits(BSP_LZSS_EncTypeDef *henc, uint32_t Value, uint32_t Count);
+static BSP_PIPE_BlockTypeDef *LZSS_StageBlock(BSP_LZSS_StageTypeDef *hctx, const BSP_PIPE_BlockTypeDef *pFrom);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_LZSS_Exported_Functions BSP LZSS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize an encoder.
+  * @param  henc Encoder.
+  * @param  pWindow BSP_LZSS_ENC_WINDOW_SIZE(WindowBits) bytes.
+  * @param  pIndex BSP_LZSS_ENC_INDEX_SIZE(WindowBits) half words, NULL for none.
+  * @param  WindowBits Bits of a distance, 4 to 12.
+  * @param  LookaheadBits Bits of a length, 3 to WindowBits - 1.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LZSS_EncInit(BSP_LZSS_EncTypeDef *henc, uint8_t *pWindow, uint16_t *pIndex,
+                                   uint32_t WindowBits, uint32_t LookaheadBits)
+{
+  if ((henc == NULL) || (pWindow == NULL) ||
+      (WindowBits < BSP_LZSS_WINDOW_BITS_MIN) || (WindowBits > BSP_LZSS_WINDOW_BITS_MAX) ||
+      (LookaheadBits < BSP_LZSS_LOOKAHEAD_BITS_MIN) || (LookaheadBits >= WindowBits))
+  {
+    return HAL_ERROR;
+  }
+
+  henc->pWindow       = pWindow;
+  henc->pIndex        = pIndex;
+  henc->WindowBits    = WindowBits;
+  henc->LookaheadBits = LookaheadBits;
+
+  /* A match is worth it when its bits are fewer than the ones of its literals, 9 each */
+  henc->MinMatch      = ((1U + WindowBits + LookaheadBits) / 9U) + 1U;
+
+  BSP_LZSS_EncReset(henc);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a new stream, forgetting the data and the bits of the last one.
+  * @param  henc Encoder.
+  * @retval None
+  */
+void BSP_LZSS_EncReset(BSP_LZSS_EncTypeDef *henc)
+{
+  henc->Fill     = 0U;
+  henc->Pos      = 0U;
+  henc->Bits     = 0U;
+  henc->BitCount = 0U;
+  henc->TotalIn  = 0U;
+  henc->TotalOut = 0U;
+
+  if (henc->pIndex != NULL)
+  {
+    memset(henc->pIndex, 0xFF, BSP_LZSS_ENC_INDEX_SIZE(henc->WindowBits) * sizeof(uint16_t));
+  }
+}
+
+/**
+  * @brief  Compress a part of a stream.
+  * @param  henc Encoder.
+  * @param  pIn Data, NULL if InSize is 0.
+  * @param  InSize Bytes of data.
+  * @param  pInUsed Bytes of data taken.
+  * @param  pOut Stream.
+  * @param  OutSize Bytes of room for the stream.
+  * @param  pOutUsed Bytes of stream written.
+  * @param  Finish 1 to end the stream once all the data is taken, 0 otherwise.
+  * @retval HAL_OK all the data taken, and the stream complete if Finish,
+  *         HAL_BUSY the output full
+  */
+HAL_StatusTypeDef BSP_LZSS_Encode(BSP_LZSS_EncTypeDef *henc, const uint8_t *pIn, uint32_t InSize, uint32_t *pInUsed,
+                                  uint8_t *pOut, uint32_t OutSize, uint32_t *pOutUsed, uint32_t Finish)
+{
+  HAL_StatusTypeDef status;
+  uint32_t size = 1UL << henc->WindowBits;
+  uint32_t lookahead = 1UL << henc->LookaheadBits;
+  uint32_t in = 0U;
+  uint32_t out = 0U;
+  uint32_t avail;
+  uint32_t length;
+  uint32_t distance;
+
+  for (;;)
+  {
+    /* The whole bytes first, a token is encoded only with less than a byte pending */
+    while ((henc->BitCount >= 8U) && (out < OutSize))
+    {
+      henc->BitCount -= 8U;
+      pOut[out++] = (uint8_t)(henc->Bits >> henc->BitCount);
+    }
+    if (henc->BitCount >= 8U)
+    {
+      status = HAL_BUSY;
+      break;
+    }
+
+    if (in < InSize)
+    {
+      if ((henc->Fill == (2U * size)) && (henc->Pos >= size))
+      {
+        LZSS_Slide(henc);
+      }
+      length = 2U * size - henc->Fill;
+      if (length > (InSize - in))
+      {
+        length = InSize - in;
+      }
+      memcpy(&henc->pWindow[henc->Fill], &pIn[in], length);
+      henc->Fill += length;
+      in += length;
+    }
+
+    avail = henc->Fill - henc->Pos;
+    if (avail < lookahead)
+    {
+      if (in < InSize)
+      {
+        continue;
+      }
+      if (Finish == 0U)
+      {
+        status = HAL_OK;
+        break;
+      }
+    }
+
+    if (avail == 0U)
+    {
+      /* Finishing: the last bits padded with 0 */
+      if (henc->BitCount != 0U)
+      {
+        if (out >= OutSize)
+        {
+          status = HAL_BUSY;
+          break;
+        }
+        pOut[out++] = (uint8_t)(henc->Bits << (8U - henc->BitCount));
+        henc->BitCount = 0U;
+      }
+      status = HAL_OK;
+      break;
+    }
+
+    length = LZSS_Match(henc, (avail < lookahead) ? avail : lookahead, &distance);
+    if (length >= henc->MinMatch)
+    {
+      LZSS_PutBits(henc, 0U, 1U);
+      LZSS_PutBits(henc, distance - 1U, henc->WindowBits);
+      LZSS_PutBits(henc, length - 1U, henc->LookaheadBits);
+    }
+    else
+    {
+      length = 1U;
+      LZSS_PutBits(henc, 0x100U | henc->pWindow[henc->Pos], 9U);
+    }
+    LZSS_Insert(henc, length);
+    henc->TotalIn += length;
+  }
+
+  henc->TotalOut += out;
+  *pInUsed  = in;
+  *pOutUsed = out;
+
+  return status;
+}
+
+/**
+  * @brief  Initialize a decoder.
+  * @param  hdec Decoder.
+  * @param  pWindow BSP_LZSS_DEC_WINDOW_SIZE(WindowBits) bytes.
+  * @param  WindowBits Bits of a distance, the ones of the encoder.
+  * @param  LookaheadBits Bits of a length, the ones of the encoder.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LZSS_DecInit(BSP_LZSS_DecTypeDef *hdec, uint8_t *pWindow, uint32_t WindowBits,
+                                   uint32_t LookaheadBits)
+{
+  if ((hdec == NULL) || (pWindow == NULL) ||
+      (WindowBits < BSP_LZSS_WINDOW_BITS_MIN) || (WindowBits > BSP_LZSS_WINDOW_BITS_MAX) ||
+      (LookaheadBits < BSP_LZSS_LOOKAHEAD_BITS_MIN) || (LookaheadBits >= WindowBits))
+  {
+    return HAL_ERROR;
+  }
+
+  hdec->pWindow       = pWindow;
+  hdec->WindowBits    = WindowBits;
+  hdec->LookaheadBits = LookaheadBits;
+
+  BSP_LZSS_DecReset(hdec);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a new stream.
+  * @param  hdec Decoder.
+  * @retval None
+  */
+void BSP_LZSS_DecReset(BSP_LZSS_DecTypeDef *hdec)
+{
+  hdec->Head      = 0U;
+  hdec->Bits      = 0U;
+  hdec->BitCount  = 0U;
+  hdec->Distance  = 0U;
+  hdec->Remaining = 0U;
+
+  memset(hdec->pWindow, 0, BSP_LZSS_DEC_WINDOW_SIZE(hdec->WindowBits));
+}
+
+/**
+  * @brief  Expand a part of a stream.
+  * @param  hdec Decoder.
+  * @param  pIn Stream, NULL if InSize is 0.
+  * @param  InSize Bytes of stream.
+  * @param  pInUsed Bytes of stream taken.
+  * @param  pOut Data.
+  * @param  OutSize Bytes of room for the data.
+  * @param  pOutUsed Bytes of data written.
+  * @retval HAL_OK all the stream taken, HAL_BUSY the output full
+  */
+HAL_StatusTypeDef BSP_LZSS_Decode(BSP_LZSS_DecTypeDef *hdec, const uint8_t *pIn, uint32_t InSize, uint32_t *pInUsed,
+                                  uint8_t *pOut, uint32_t OutSize, uint32_t *pOutUsed)
+{
+  HAL_StatusTypeDef status;
+  uint32_t mask = (1UL << hdec->WindowBits) - 1U;
+  uint32_t backref = 1U + hdec->WindowBits + hdec->LookaheadBits;
+  uint32_t in = 0U;
+  uint32_t out = 0U;
+  uint32_t value;
+  uint8_t  byte;
+
+  for (;;)
+  {
+    while ((hdec->Remaining != 0U) && (out < OutSize))
+    {
+      byte = hdec->pWindow[(hdec->Head - hdec->Distance) & mask];
+      hdec->pWindow[hdec->Head & mask] = byte;
+      hdec->Head++;
+      pOut[out++] = byte;
+      hdec->Remaining--;
+    }
+    if (hdec->Remaining != 0U)
+    {
+      status = HAL_BUSY;
+      break;
+    }
+
+    while ((hdec->BitCount <= 24U) && (in < InSize))
+    {
+      hdec->Bits = (hdec->Bits << 8) | pIn[in++];
+      hdec->BitCount += 8U;
+    }
+
+    if ((hdec->BitCount == 0U) || (((hdec->Bits >> (hdec->BitCount - 1U)) & 1U) != 0U))
+    {
+      /* Literal, or the padding of the end of the stream */
+      if (hdec->BitCount < 9U)
+      {
+        status = HAL_OK;
+        break;
+      }
+      if (out >= OutSize)
+      {
+        status = HAL_BUSY;
+        break;
+      }
+      hdec->BitCount -= 9U;
+      byte = (uint8_t)(hdec->Bits >> hdec->BitCount);
+      hdec->pWindow[hdec->Head & mask] = byte;
+      hdec->Head++;
+      pOut[out++] = byte;
+    }
+    else
+    {
+      if (hdec->BitCount < backref)
+      {
+        status = HAL_OK;
+        break;
+      }
+      hdec->BitCount -= backref;
+      value = hdec->Bits >> hdec->BitCount;
+      hdec->Remaining = (value & ((1UL << hdec->LookaheadBits) - 1U)) + 1U;
+      hdec->Distance  = ((value >> hdec->LookaheadBits) & mask) + 1U;
+    }
+  }
+
+  *pInUsed  = in;
+  *pOutUsed = out;
+
+  return status;
+}
+
+/**
+  * @brief  Initialize the context of a compressing pipeline stage.
+  * @param  hctx Context, the pArg of the stage.
+  * @param  hpipe Pipeline, the output blocks taken from its pool.
+  * @param  pWindow BSP_LZSS_ENC_WINDOW_SIZE(WindowBits) bytes.
+  * @param  pIndex BSP_LZSS_ENC_INDEX_SIZE(WindowBits) half words, NULL for none.
+  * @param  WindowBits Bits of a distance.
+  * @param  LookaheadBits Bits of a length.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_LZSS_StageInit(BSP_LZSS_StageTypeDef *hctx, BSP_PIPE_TypeDef *hpipe, uint8_t *pWindow,
+                                     uint16_t *pIndex, uint32_t WindowBits, uint32_t LookaheadBits)
+{
+  if ((hctx == NULL) || (hpipe == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  hctx->hpipe  = hpipe;
+  hctx->pOut   = NULL;
+  hctx->Offset = 0U;
+
+  return BSP_LZSS_EncInit(&hctx->Enc, pWindow, pIndex, WindowBits, LookaheadBits);
+}
+
+/**
+  * @brief  Process function of a compressing pipeline stage, given to BSP_PIPE_AddStage().
+  * @param  hstage Stage, pArg a BSP_LZSS_StageTypeDef.
+  * @param  ppBlock Block of data, back to the pool once compressed.
+  * @retval BSP_PIPE_DONE, BSP_PIPE_BUSY while the pool is empty or the next stage full
+  */
+uint32_t BSP_LZSS_StageProcess(BSP_PIPE_StageTypeDef *hstage, BSP_PIPE_BlockTypeDef **ppBlock)
+{
+  BSP_LZSS_StageTypeDef *hctx = (BSP_LZSS_StageTypeDef *)hstage->pArg;
+  BSP_PIPE_BlockTypeDef *in = *ppBlock;
+  BSP_PIPE_BlockTypeDef *out;
+  uint32_t used;
+  uint32_t written;
+
+  for (;;)
+  {
+    out = LZSS_StageBlock(hctx, in);
+    if (out == NULL)
+    {
+      return BSP_PIPE_BUSY;
+    }
+
+    if (BSP_LZSS_Encode(&hctx->Enc, (const uint8_t *)BSP_PIPE_DATA(in) + hctx->Offset, in->Length - hctx->Offset,
+                        &used, (uint8_t *)BSP_PIPE_DATA(out) + out->Length, hctx->hpipe->DataSize - out->Length,
+                        &written, 0U) == HAL_OK)
+    {
+      hctx->Offset = 0U;
+      out->Length += written;
+      return BSP_PIPE_DONE;
+    }
+    hctx->Offset += used;
+    out->Length  += written;
+
+    /* The block full, the rest of the data given again if the next stage cannot take it */
+    if (BSP_PIPE_Emit(hstage, out) != HAL_OK)
+    {
+      return BSP_PIPE_BUSY;
+    }
+    hctx->pOut = NULL;
+  }
+}
+
+/**
+  * @brief  End the stream of a compressing pipeline stage and send its last block, from the
+  *         context of BSP_PIPE_Process(). The next block starts a new stream.
+  * @param  hstage Stage, pArg a BSP_LZSS_StageTypeDef.
+  * @retval HAL_OK, HAL_BUSY while the pool is empty or the next stage full, call again
+  */
+HAL_StatusTypeDef BSP_LZSS_StageFinish(BSP_PIPE_StageTypeDef *hstage)
+{
+  BSP_LZSS_StageTypeDef *hctx = (BSP_LZSS_StageTypeDef *)hstage->pArg;
+  BSP_PIPE_BlockTypeDef *out;
+  HAL_StatusTypeDef status;
+  uint32_t used;
+  uint32_t written;
+
+  do
+  {
+    out = LZSS_StageBlock(hctx, NULL);
+    if (out == NULL)
+    {
+      return HAL_BUSY;
+    }
+
+    status = BSP_LZSS_Encode(&hctx->Enc, NULL, 0U, &used, (uint8_t *)BSP_PIPE_DATA(out) + out->Length,
+                             hctx->hpipe->DataSize - out->Length, &written, 1U);
+    out->Length += written;
+
+    if (out->Length == 0U)
+    {
+      (void)BSP_PIPE_Free(hctx->hpipe, out);
+    }
+    else if (BSP_PIPE_Emit(hstage, out) != HAL_OK)
+    {
+      return HAL_BUSY;
+    }
+    hctx->pOut = NULL;
+  } while (status != HAL_OK);
+
+  BSP_LZSS_EncReset(&hctx->Enc);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_LZSS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Find the longest match of the data at the position of an encoder.
+  * @param  henc Encoder.
+  * @param  MaxLength Longest match possible.
+  * @param  pDistance Distance of the match.
+  * @retval Length of the match, 0 for none
+  */
+static uint32_t LZSS_Match(const BSP_LZSS_EncTypeDef *henc, uint32_t MaxLength, uint32_t *pDistance)
+{
+  const uint8_t *window = henc->pWindow;
+  const uint8_t *data = &window[henc->Pos];
+  uint32_t size = 1UL << henc->WindowBits;
+  uint32_t first = (henc->Pos > size) ? (henc->Pos - size) : 0U;
+  uint32_t best = 0U;
+  uint32_t chain = 0U;
+  uint32_t candidate;
+  uint32_t length;
+
+  if (henc->pIndex != NULL)
+  {
+    candidate = henc->pIndex[2U * size + data[0]];
+  }
+  else
+  {
+    candidate = (henc->Pos != 0U) ? (henc->Pos - 1U) : LZSS_NONE;
+  }
+
+  while ((candidate != LZSS_NONE) && (candidate >= first))
+  {
+    length = 0U;
+    while ((length < MaxLength) && (window[candidate + length] == data[length]))
+    {
+      length++;
+    }
+    if (length > best)
+    {
+      best = length;
+      *pDistance = henc->Pos - candidate;
+      if (best == MaxLength)
+      {
+        break;
+      }
+    }
+
+    if (henc->pIndex != NULL)
+    {
+      if (++chain >= BSP_LZSS_CHAIN_MAX)
+      {
+        break;
+      }
+      candidate = henc->pIndex[candidate];
+    }
+    else
+    {
+      candidate = (candidate != first) ? (candidate - 1U) : LZSS_NONE;
+    }
+  }
+
+  return best;
+}
+
+/**
+  * @brief  Move the position of an encoder over bytes encoded, chaining them in the index.
+  * @param  henc Encoder.
+  * @param  Count Bytes.
+  * @retval None
+  */
+static void LZSS_Insert(BSP_LZSS_EncTypeDef *henc, uint32_t Count)
+{
+  uint16_t *head;
+  uint8_t byte;
+
+  if (henc->pIndex == NULL)
+  {
+    henc->Pos += Count;
+    return;
+  }
+
+  head = &henc->pIndex[2UL << henc->WindowBits];
+  while (Count-- != 0U)
+  {
+    byte = henc->pWindow[henc->Pos];
+    henc->pIndex[henc->Pos] = head[byte];
+    head[byte] = (uint16_t)henc->Pos;
+    henc->Pos++;
+  }
+}
+
+/**
+  * @brief  Drop the oldest half of the window buffer of an encoder, all encoded.
+  * @param  henc Encoder.
+  * @retval None
+  */
+static void LZSS_Slide(BSP_LZSS_EncTypeDef *henc)
+{
+  uint32_t size = 1UL << henc->WindowBits;
+  uint32_t i;
+  uint32_t position;
+
+  memmove(henc->pWindow, &henc->pWindow[size], henc->Fill - size);
+  henc->Fill -= size;
+  henc->Pos  -= size;
+
+  if (henc->pIndex != NULL)
+  {
+    for (i = 0U; i < BSP_LZSS_ENC_INDEX_SIZE(henc->WindowBits); i++)
+    {
+      /* The chains of the second half move down, the heads too */
+      position = (i < size) ? henc->pIndex[i + size] : ((i < 2U * size) ? LZSS_NONE : henc->pIndex[i]);
+      henc->pIndex[i] = ((position == LZSS_NONE) || (position < size)) ? LZSS_NONE : (uint16_t)(position - size);
+    }
+  }
+}
+
+/**
+  * @brief  Append bits to the stream of an encoder.
+  * @param  henc Encoder.
+  * @param  Value Bits.
+  * @param  Count Number of bits, 24 at most.
+  * @retval None
+  */
+static void LZSS_PutBits(BSP_LZSS_EncTypeDef *henc, uint32_t Value, uint32_t Count)
+{
+  henc->Bits = (henc->Bits << Count) | (Value & ((1UL << Count) - 1U));
+  henc->BitCount += Count;
+}
+
+/**
+  * @brief  Block a compressing stage fills, allocated from the pool when none.
+  * @param  hctx Context of the stage.
+  * @param  pFrom Block of data the stream comes from, NULL if none.
+  * @retval Block, NULL when the pool is empty
+  */
+static BSP_PIPE_BlockTypeDef *LZSS_StageBlock(BSP_LZSS_StageTypeDef *hctx, const BSP_PIPE_BlockTypeDef *pFrom)
+{
+  BSP_PIPE_BlockTypeDef *block = hctx->pOut;
+
+  if (block == NULL)
+  {
+    block = (BSP_PIPE_BlockTypeDef *)BSP_MEMPOOL_Alloc(&hctx->hpipe->Pool);
+    if (block == NULL)
+    {
+      return NULL;
+    }
+
+    /* The latency of the stream counted from its oldest data */
+    block->Sequence  = (pFrom != NULL) ? pFrom->Sequence : 0U;
+    block->Timestamp = (pFrom != NULL) ? pFrom->Timestamp : DWT->CYCCNT;
+    block->Length    = 0U;
+    block->Channel   = (pFrom != NULL) ? pFrom->Channel : 0U;
+    block->Step      = 1U;
+    block->Arg       = 0U;
+    hctx->pOut = block;
+  }
+
+  return block;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
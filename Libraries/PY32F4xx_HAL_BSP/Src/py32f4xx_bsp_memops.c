@@ -0,0 +1,481 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_memops.c
+  * @author  MCU Application Team
+  * @brief   Memory copy and fill BSP service.
+  *          This file provides the memcpy(), memmove() and memset() of the
+  *          Cortex-M4 in place of the byte loops of newlib-nano:
+  *           + Destination aligned, then blocks of 32 bytes by LDM/STM
+  *           + Unaligned source read by words, the M4 allowing it
+  *           + Large copies given to a memory to memory DMA channel
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) BSP_MEMOPS_Copy(), BSP_MEMOPS_Move() and BSP_MEMOPS_Set() take the
+       arguments and return the value of memcpy(), memmove() and memset().
+       Built with USE_MEMOPS=y, defining USE_BSP_MEMOPS, they are also linked
+       as memcpy(), memmove() and memset(): the copies of the HAL, of the
+       other services, of the structure assignments the compiler turns into
+       calls, all use them. Without it they can be called, and compared with
+       the ones of the C library, see Examples/Benchmark/MemOps_Bench.
+
+   (#) Below BSP_MEMOPS_SMALL bytes the copy is a byte loop, cheaper than the
+       alignment work. Above, the destination is aligned first. A source
+       aligned the same way is copied by 32 byte blocks of LDM/STM, then by
+       words. Another source is read by unaligned LDR, the unaligned access
+       trap of SCB->CCR must stay disabled, the reset state. The fill writes
+       its byte repeated in a word by STM the same way.
+
+   (#) BSP_MEMOPS_AttachDma() gives copies of Threshold bytes or more to a
+       DMA channel, initialized by the application with HAL_DMA_Init() in
+       DMA_MEMORY_TO_MEMORY, words on both sides, both addresses
+       incremented. Only the copies between word aligned addresses, made in
+       thread mode and not overlapping are given to it, the CPU waiting for
+       the end of the transfer: the gain is the higher throughput of the DMA
+       on the bus, measure it with the benchmark before choosing Threshold.
+       The remaining bytes, the copies made while the channel is busy and
+       the ones the DMA refuses are made by the CPU.
+
+   (#) The loops are compiled without -ftree-loop-distribute-patterns: GCC
+       would turn them into calls of memcpy() or memset(), themselves here.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_memops.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_MEMOPS BSP MEMOPS
+  * @brief Memory copy and fill BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Private_Constants BSP MEMOPS Private Constants
+  * @{
+  */
+#define MEMOPS_WORD_MASK                3U
+#define MEMOPS_BLOCK_SHIFT              5U             /* 32 bytes, two LDM/STM of 4 registers */
+#define MEMOPS_BLOCK_MASK               31U
+#define MEMOPS_DMA_TIMEOUT              100U           /* ms, 65535 words take far less        */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Private_Macros BSP MEMOPS Private Macros
+  * @{
+  */
+/* The loops stay loops, not calls of the functions of this file */
+#define MEMOPS_NO_LIBCALL               __attribute__((optimize("no-tree-loop-distribute-patterns")))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Private_Variables BSP MEMOPS Private Variables
+  * @{
+  */
+#if defined (HAL_DMA_MODULE_ENABLED)
+static DMA_HandleTypeDef *MEMOPS_Dma;
+static uint32_t MEMOPS_DmaThreshold;
+#endif /* HAL_DMA_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Private_Functions BSP MEMOPS Private Functions
+  * @{
+  */
+static void *MEMOPS_CopyForward(void *pDst, const void *pSrc, size_t Size);
+static void MEMOPS_CopyBackward(uint8_t *pDstEnd, const uint8_t *pSrcEnd, size_t Size);
+#if defined (HAL_DMA_MODULE_ENABLED)
+static size_t MEMOPS_CopyDma(uint8_t *pDst, const uint8_t *pSrc, size_t Size);
+#endif /* HAL_DMA_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_MEMOPS_Exported_Functions BSP MEMOPS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Copy a buffer, as memcpy().
+  * @param  pDst Destination.
+  * @param  pSrc Source, not overlapping the destination.
+  * @param  Size Number of bytes.
+  * @retval pDst
+  */
+void *BSP_MEMOPS_Copy(void *pDst, const void *pSrc, size_t Size)
+{
+#if defined (HAL_DMA_MODULE_ENABLED)
+  size_t done;
+
+  if ((MEMOPS_Dma != NULL) && (Size >= MEMOPS_DmaThreshold))
+  {
+    done = MEMOPS_CopyDma((uint8_t *)pDst, (const uint8_t *)pSrc, Size);
+    (void)MEMOPS_CopyForward((uint8_t *)pDst + done, (const uint8_t *)pSrc + done, Size - done);
+    return pDst;
+  }
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+  return MEMOPS_CopyForward(pDst, pSrc, Size);
+}
+
+/**
+  * @brief  Copy a buffer that may overlap the destination, as memmove().
+  * @param  pDst Destination.
+  * @param  pSrc Source.
+  * @param  Size Number of bytes.
+  * @retval pDst
+  */
+void *BSP_MEMOPS_Move(void *pDst, const void *pSrc, size_t Size)
+{
+  uint8_t *dst = (uint8_t *)pDst;
+  const uint8_t *src = (const uint8_t *)pSrc;
+
+  /* Forward is right when the destination is below the source: each block is
+     read before the bytes of the source it overwrites */
+  if ((dst <= src) || (dst >= (src + Size)))
+  {
+    return MEMOPS_CopyForward(pDst, pSrc, Size);
+  }
+
+  MEMOPS_CopyBackward(dst + Size, src + Size, Size);
+  return pDst;
+}
+
+/**
+  * @brief  Fill a buffer with a byte, as memset().
+  * @param  pDst Destination.
+  * @param  Value Byte written, converted to unsigned char.
+  * @param  Size Number of bytes.
+  * @retval pDst
+  */
+MEMOPS_NO_LIBCALL void *BSP_MEMOPS_Set(void *pDst, int Value, size_t Size)
+{
+  uint8_t *dst = (uint8_t *)pDst;
+  uint32_t word = (uint8_t)Value * 0x01010101U;
+  uint32_t blocks;
+
+  if (Size >= BSP_MEMOPS_SMALL)
+  {
+    while (((uint32_t)dst & MEMOPS_WORD_MASK) != 0U)
+    {
+      *dst++ = (uint8_t)word;
+      Size--;
+    }
+
+    blocks = Size >> MEMOPS_BLOCK_SHIFT;
+    if (blocks != 0U)
+    {
+      __ASM volatile (
+        "  mov   r3, %[w]              \n"
+        "  mov   r4, %[w]              \n"
+        "  mov   r5, %[w]              \n"
+        "  mov   r6, %[w]              \n"
+        "1:                            \n"
+        "  stmia %[d]!, {r3-r6}        \n"
+        "  stmia %[d]!, {r3-r6}        \n"
+        "  subs  %[n], %[n], #1        \n"
+        "  bne   1b                    \n"
+        : [d] "+r" (dst), [n] "+r" (blocks)
+        : [w] "r" (word)
+        : "r3", "r4", "r5", "r6", "cc", "memory");
+      Size &= MEMOPS_BLOCK_MASK;
+    }
+
+    while (Size >= 4U)
+    {
+      *(uint32_t *)dst = word;
+      dst += 4U;
+      Size -= 4U;
+    }
+  }
+
+  while (Size != 0U)
+  {
+    *dst++ = (uint8_t)word;
+    Size--;
+  }
+
+  return pDst;
+}
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  Give the large copies to a memory to memory DMA channel.
+  * @param  hdma DMA handle initialized in DMA_MEMORY_TO_MEMORY, words, both
+  *         addresses incremented, without interrupt.
+  * @param  Threshold Smallest copy given to the DMA, in bytes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MEMOPS_AttachDma(DMA_HandleTypeDef *hdma, uint32_t Threshold)
+{
+  if ((hdma == NULL) || (Threshold < BSP_MEMOPS_SMALL) ||
+      (hdma->Init.Direction != DMA_MEMORY_TO_MEMORY) ||
+      (hdma->Init.PeriphInc != DMA_PINC_ENABLE) || (hdma->Init.MemInc != DMA_MINC_ENABLE) ||
+      (hdma->Init.PeriphDataAlignment != DMA_PDATAALIGN_WORD) ||
+      (hdma->Init.MemDataAlignment != DMA_MDATAALIGN_WORD) || (hdma->Init.Mode != DMA_NORMAL))
+  {
+    return HAL_ERROR;
+  }
+
+  MEMOPS_DmaThreshold = Threshold;
+  MEMOPS_Dma = hdma;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Make all the copies by the CPU again.
+  * @retval None
+  */
+void BSP_MEMOPS_DetachDma(void)
+{
+  MEMOPS_Dma = NULL;
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+#if defined (USE_BSP_MEMOPS)
+/** @defgroup BSP_MEMOPS_Library_Functions BSP MEMOPS Library Functions
+  * @brief    The C library functions, linked in place of the ones of newlib
+  * @{
+  */
+__USED void *memcpy(void *pDst, const void *pSrc, size_t Size)
+{
+  return BSP_MEMOPS_Copy(pDst, pSrc, Size);
+}
+
+__USED void *memmove(void *pDst, const void *pSrc, size_t Size)
+{
+  return BSP_MEMOPS_Move(pDst, pSrc, Size);
+}
+
+__USED void *memset(void *pDst, int Value, size_t Size)
+{
+  return BSP_MEMOPS_Set(pDst, Value, Size);
+}
+/**
+  * @}
+  */
+#endif /* USE_BSP_MEMOPS */
+
+/** @addtogroup BSP_MEMOPS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Copy by the CPU from the first byte to the last one.
+  * @param  pDst Destination, below the source when they overlap.
+  * @param  pSrc Source.
+  * @param  Size Number of bytes.
+  * @retval pDst
+  */
+MEMOPS_NO_LIBCALL static void *MEMOPS_CopyForward(void *pDst, const void *pSrc, size_t Size)
+{
+  uint8_t *dst = (uint8_t *)pDst;
+  const uint8_t *src = (const uint8_t *)pSrc;
+  uint32_t blocks;
+
+  if (Size >= BSP_MEMOPS_SMALL)
+  {
+    while (((uint32_t)dst & MEMOPS_WORD_MASK) != 0U)
+    {
+      *dst++ = *src++;
+      Size--;
+    }
+
+    if (((uint32_t)src & MEMOPS_WORD_MASK) == 0U)
+    {
+      blocks = Size >> MEMOPS_BLOCK_SHIFT;
+      if (blocks != 0U)
+      {
+        __ASM volatile (
+          "1:                            \n"
+          "  ldmia %[s]!, {r3-r6}        \n"
+          "  stmia %[d]!, {r3-r6}        \n"
+          "  ldmia %[s]!, {r3-r6}        \n"
+          "  stmia %[d]!, {r3-r6}        \n"
+          "  subs  %[n], %[n], #1        \n"
+          "  bne   1b                    \n"
+          : [d] "+r" (dst), [s] "+r" (src), [n] "+r" (blocks)
+          :
+          : "r3", "r4", "r5", "r6", "cc", "memory");
+        Size &= MEMOPS_BLOCK_MASK;
+      }
+      while (Size >= 4U)
+      {
+        *(uint32_t *)dst = *(const uint32_t *)src;
+        dst += 4U;
+        src += 4U;
+        Size -= 4U;
+      }
+    }
+    else
+    {
+      /* Unaligned LDR, one bus access more than an aligned one at most */
+      while (Size >= 16U)
+      {
+        ((uint32_t *)dst)[0] = __UNALIGNED_UINT32_READ(src);
+        ((uint32_t *)dst)[1] = __UNALIGNED_UINT32_READ(src + 4U);
+        ((uint32_t *)dst)[2] = __UNALIGNED_UINT32_READ(src + 8U);
+        ((uint32_t *)dst)[3] = __UNALIGNED_UINT32_READ(src + 12U);
+        dst += 16U;
+        src += 16U;
+        Size -= 16U;
+      }
+      while (Size >= 4U)
+      {
+        *(uint32_t *)dst = __UNALIGNED_UINT32_READ(src);
+        dst += 4U;
+        src += 4U;
+        Size -= 4U;
+      }
+    }
+  }
+
+  while (Size != 0U)
+  {
+    *dst++ = *src++;
+    Size--;
+  }
+
+  return pDst;
+}
+
+/**
+  * @brief  Copy by the CPU from the last byte to the first one.
+  * @param  pDstEnd End of the destination, above the source.
+  * @param  pSrcEnd End of the source.
+  * @param  Size Number of bytes.
+  * @retval None
+  */
+MEMOPS_NO_LIBCALL static void MEMOPS_CopyBackward(uint8_t *pDstEnd, const uint8_t *pSrcEnd, size_t Size)
+{
+  uint8_t *dst = pDstEnd;
+  const uint8_t *src = pSrcEnd;
+  uint32_t blocks;
+
+  if (Size >= BSP_MEMOPS_SMALL)
+  {
+    while (((uint32_t)dst & MEMOPS_WORD_MASK) != 0U)
+    {
+      *--dst = *--src;
+      Size--;
+    }
+
+    if (((uint32_t)src & MEMOPS_WORD_MASK) == 0U)
+    {
+      blocks = Size >> MEMOPS_BLOCK_SHIFT;
+      if (blocks != 0U)
+      {
+        __ASM volatile (
+          "1:                            \n"
+          "  ldmdb %[s]!, {r3-r6}        \n"
+          "  stmdb %[d]!, {r3-r6}        \n"
+          "  ldmdb %[s]!, {r3-r6}        \n"
+          "  stmdb %[d]!, {r3-r6}        \n"
+          "  subs  %[n], %[n], #1        \n"
+          "  bne   1b                    \n"
+          : [d] "+r" (dst), [s] "+r" (src), [n] "+r" (blocks)
+          :
+          : "r3", "r4", "r5", "r6", "cc", "memory");
+        Size &= MEMOPS_BLOCK_MASK;
+      }
+    }
+
+    /* Words, a source read before the store of the same word */
+    while (Size >= 4U)
+    {
+      dst -= 4U;
+      src -= 4U;
+      *(uint32_t *)dst = __UNALIGNED_UINT32_READ(src);
+      Size -= 4U;
+    }
+  }
+
+  while (Size != 0U)
+  {
+    *--dst = *--src;
+    Size--;
+  }
+}
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  Copy the words of a buffer with the DMA, when it can.
+  * @param  pDst Destination.
+  * @param  pSrc Source, not overlapping the destination.
+  * @param  Size Number of bytes.
+  * @retval Bytes copied, 0 when the copy is left to the CPU.
+  */
+static size_t MEMOPS_CopyDma(uint8_t *pDst, const uint8_t *pSrc, size_t Size)
+{
+  DMA_HandleTypeDef *hdma = MEMOPS_Dma;
+  size_t words;
+
+  /* Not from a handler, which may have interrupted a copy of the channel */
+  if ((__get_IPSR() != 0U) || (hdma->State != HAL_DMA_STATE_READY) ||
+      ((((uint32_t)pDst | (uint32_t)pSrc) & MEMOPS_WORD_MASK) != 0U))
+  {
+    return 0U;
+  }
+
+  words = ((Size > BSP_MEMOPS_DMA_MAX) ? BSP_MEMOPS_DMA_MAX : Size) / 4U;
+  if (HAL_DMA_Start(hdma, (uint32_t)pSrc, (uint32_t)pDst, words) != HAL_OK)
+  {
+    return 0U;
+  }
+  if (HAL_DMA_PollForTransfer(hdma, HAL_DMA_FULL_TRANSFER, MEMOPS_DMA_TIMEOUT) != HAL_OK)
+  {
+    /* Stopped, everything copied again by the CPU */
+    (void)HAL_DMA_Abort(hdma);
+    return 0U;
+  }
+
+  return words * 4U;
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
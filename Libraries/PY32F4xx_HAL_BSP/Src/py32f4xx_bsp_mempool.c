@@ -0,0 +1,363 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_mempool.c
+  * @author  MCU Application Team
+  * @brief   Block pool and arena allocator BSP service.
+  *          This file provides deterministic allocators over static buffers:
+  *           + Pools of fixed size blocks, allocated and freed in O(1) from
+  *             any context with a lock-free free list
+  *           + Arenas allocated upwards, released at once to a mark taken
+  *             before a scope
+  *           + Use, peak use and failures of each
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A pool hands out blocks of one size, packets or frames for example,
+       without the fragmentation and the unbounded time of malloc(). Give
+       BSP_MEMPOOL_Init() a buffer of BSP_MEMPOOL_BUFFER_SIZE(BlockSize,
+       Count) bytes aligned on BSP_MEMPOOL_ALIGN, a uint64_t array for
+       example. Each block is aligned on BSP_MEMPOOL_ALIGN.
+
+   (#) BSP_MEMPOOL_Alloc() returns a block, NULL in a few cycles when the
+       pool is empty, and BSP_MEMPOOL_Free() gives it back: both take the
+       head of the free list with LDREX/STREX, never masking the interrupts,
+       so that a handler may free a block the main loop allocated and the
+       other way round. BSP_MEMPOOL_Free() returns HAL_ERROR for a pointer
+       that is not a block of the pool; a block must not be freed twice.
+
+   (#) An arena hands out memory of any size and alignment from a buffer
+       given to BSP_MEMPOOL_ArenaInit(), the frame buffers of a driver for
+       example, and never frees it alone: BSP_MEMPOOL_ArenaMark() before a
+       scope and BSP_MEMPOOL_ArenaRelease() at its end free all that the scope
+       allocated, BSP_MEMPOOL_ArenaReset() all of it. BSP_MEMPOOL_ArenaAlloc()
+       takes the memory with LDREX/STREX too; release from the context of the
+       scope only.
+
+   (#) The handles hold the statistics: Used and Peak, in blocks for a pool
+       and in bytes for an arena, and Failures, the allocations refused.
+       Size a pool or an arena from the peak in the worst case of the
+       application.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_mempool.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_MEMPOOL BSP MEMPOOL
+  * @brief Block pool and arena allocator BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Private_Constants BSP MEMPOOL Private Constants
+  * @{
+  */
+#define MEMPOOL_ALIGN_MASK              (BSP_MEMPOOL_ALIGN - 1U)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Private_Functions BSP MEMPOOL Private Functions
+  * @{
+  */
+static void MEMPOOL_Add(__IO uint32_t *pCount, uint32_t Value);
+static void MEMPOOL_Peak(__IO uint32_t *pPeak, uint32_t Value);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_MEMPOOL_Exported_Functions BSP MEMPOOL Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Chain the blocks of a buffer in the free list of a pool.
+  * @param  hpool Pool handle.
+  * @param  pBuffer BSP_MEMPOOL_BUFFER_SIZE(BlockSize, Count) bytes aligned on
+  *         BSP_MEMPOOL_ALIGN.
+  * @param  BlockSize Bytes of a block, at least 1.
+  * @param  Count Blocks, at least 1.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MEMPOOL_Init(BSP_MEMPOOL_TypeDef *hpool, void *pBuffer, uint32_t BlockSize, uint32_t Count)
+{
+  uint8_t *block;
+  uint32_t i;
+
+  if ((hpool == NULL) || (pBuffer == NULL) || (((uint32_t)pBuffer & MEMPOOL_ALIGN_MASK) != 0U) ||
+      (BlockSize == 0U) || (BlockSize > (0xFFFFFFFFU - MEMPOOL_ALIGN_MASK)) || (Count == 0U))
+  {
+    return HAL_ERROR;
+  }
+  BlockSize = (BlockSize + MEMPOOL_ALIGN_MASK) & ~MEMPOOL_ALIGN_MASK;
+  if (BlockSize > (0xFFFFFFFFU / Count))
+  {
+    return HAL_ERROR;
+  }
+
+  hpool->pBuffer   = (uint8_t *)pBuffer;
+  hpool->BlockSize = BlockSize;
+  hpool->Count     = Count;
+  hpool->Used      = 0U;
+  hpool->Peak      = 0U;
+  hpool->Failures  = 0U;
+
+  /* Each free block holds the address of the next one */
+  block = hpool->pBuffer;
+  for (i = 0U; i < (Count - 1U); i++)
+  {
+    *(void **)(void *)block = block + hpool->BlockSize;
+    block += hpool->BlockSize;
+  }
+  *(void **)(void *)block = NULL;
+  hpool->pFree = hpool->pBuffer;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take a block from a pool, from any context.
+  * @param  hpool Pool handle.
+  * @retval Block, NULL when the pool is empty
+  */
+void *BSP_MEMPOOL_Alloc(BSP_MEMPOOL_TypeDef *hpool)
+{
+  void *block;
+
+  if (hpool == NULL)
+  {
+    return NULL;
+  }
+
+  /* An exception between the LDREX and the STREX fails the STREX: the next
+     block read is the one of the head taken */
+  do
+  {
+    block = (void *)__LDREXW((volatile uint32_t *)(void *)&hpool->pFree);
+    if (block == NULL)
+    {
+      __CLREX();
+      MEMPOOL_Add(&hpool->Failures, 1U);
+      return NULL;
+    }
+  } while (__STREXW((uint32_t)*(void **)block, (volatile uint32_t *)(void *)&hpool->pFree) != 0U);
+
+  MEMPOOL_Add(&hpool->Used, 1U);
+  MEMPOOL_Peak(&hpool->Peak, hpool->Used);
+
+  return block;
+}
+
+/**
+  * @brief  Give a block back to its pool, from any context.
+  * @param  hpool Pool handle.
+  * @param  pBlock Block of BSP_MEMPOOL_Alloc().
+  * @retval HAL status, HAL_ERROR for a pointer outside the blocks of the pool
+  */
+HAL_StatusTypeDef BSP_MEMPOOL_Free(BSP_MEMPOOL_TypeDef *hpool, void *pBlock)
+{
+  uint32_t offset;
+  void *head;
+
+  if ((hpool == NULL) || (pBlock == NULL) || ((uint8_t *)pBlock < hpool->pBuffer))
+  {
+    return HAL_ERROR;
+  }
+  offset = (uint32_t)((uint8_t *)pBlock - hpool->pBuffer);
+  if ((offset >= (hpool->BlockSize * hpool->Count)) || ((offset % hpool->BlockSize) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  do
+  {
+    head = (void *)__LDREXW((volatile uint32_t *)(void *)&hpool->pFree);
+    *(void **)pBlock = head;
+  } while (__STREXW((uint32_t)pBlock, (volatile uint32_t *)(void *)&hpool->pFree) != 0U);
+
+  MEMPOOL_Add(&hpool->Used, 0xFFFFFFFFU);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give a buffer to an arena, all of it free.
+  * @param  harena Arena handle.
+  * @param  pBuffer Memory of the arena, aligned on BSP_MEMPOOL_ALIGN.
+  * @param  Size Bytes of the arena.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MEMPOOL_ArenaInit(BSP_MEMPOOL_ArenaTypeDef *harena, void *pBuffer, uint32_t Size)
+{
+  if ((harena == NULL) || (pBuffer == NULL) || (((uint32_t)pBuffer & MEMPOOL_ALIGN_MASK) != 0U) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  harena->pBuffer  = (uint8_t *)pBuffer;
+  harena->Size     = Size;
+  harena->Used     = 0U;
+  harena->Peak     = 0U;
+  harena->Failures = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Take memory from an arena, from any context.
+  * @param  harena Arena handle.
+  * @param  Size Bytes, at least 1.
+  * @param  Align Alignment, a power of 2, 0 for BSP_MEMPOOL_ALIGN.
+  * @retval Memory, NULL when the arena is short or for a wrong parameter
+  */
+void *BSP_MEMPOOL_ArenaAlloc(BSP_MEMPOOL_ArenaTypeDef *harena, uint32_t Size, uint32_t Align)
+{
+  uint32_t base;
+  uint32_t used;
+  uint32_t start;
+
+  if (Align == 0U)
+  {
+    Align = BSP_MEMPOOL_ALIGN;
+  }
+  if ((harena == NULL) || (Size == 0U) || ((Align & (Align - 1U)) != 0U))
+  {
+    return NULL;
+  }
+  base = (uint32_t)harena->pBuffer;
+
+  do
+  {
+    used  = __LDREXW(&harena->Used);
+    start = (((base + used) + (Align - 1U)) & ~(Align - 1U)) - base;
+    if ((start < used) || (start > harena->Size) || (Size > (harena->Size - start)))
+    {
+      __CLREX();
+      MEMPOOL_Add(&harena->Failures, 1U);
+      return NULL;
+    }
+  } while (__STREXW(start + Size, &harena->Used) != 0U);
+
+  MEMPOOL_Peak(&harena->Peak, start + Size);
+
+  return harena->pBuffer + start;
+}
+
+/**
+  * @brief  Mark of an arena, for the release at the end of a scope.
+  * @param  harena Arena handle.
+  * @retval Bytes allocated
+  */
+uint32_t BSP_MEMPOOL_ArenaMark(const BSP_MEMPOOL_ArenaTypeDef *harena)
+{
+  return (harena != NULL) ? harena->Used : 0U;
+}
+
+/**
+  * @brief  Free all the memory of an arena allocated after a mark.
+  * @param  harena Arena handle.
+  * @param  Mark Mark of BSP_MEMPOOL_ArenaMark().
+  * @retval HAL status, HAL_ERROR for a mark above the memory allocated
+  */
+HAL_StatusTypeDef BSP_MEMPOOL_ArenaRelease(BSP_MEMPOOL_ArenaTypeDef *harena, uint32_t Mark)
+{
+  if ((harena == NULL) || (Mark > harena->Used))
+  {
+    return HAL_ERROR;
+  }
+
+  harena->Used = Mark;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Free all the memory of an arena.
+  * @param  harena Arena handle.
+  * @retval None
+  */
+void BSP_MEMPOOL_ArenaReset(BSP_MEMPOOL_ArenaTypeDef *harena)
+{
+  (void)BSP_MEMPOOL_ArenaRelease(harena, 0U);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_MEMPOOL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Add to a counter shared by the contexts.
+  * @param  pCount Counter.
+  * @param  Value Value added, 0xFFFFFFFF to subtract one.
+  * @retval None
+  */
+static void MEMPOOL_Add(__IO uint32_t *pCount, uint32_t Value)
+{
+  uint32_t count;
+
+  do
+  {
+    count = __LDREXW(pCount);
+  } while (__STREXW(count + Value, pCount) != 0U);
+}
+
+/**
+  * @brief  Raise a peak shared by the contexts.
+  * @param  pPeak Peak.
+  * @param  Value Value reached.
+  * @retval None
+  */
+static void MEMPOOL_Peak(__IO uint32_t *pPeak, uint32_t Value)
+{
+  do
+  {
+    if (__LDREXW(pPeak) >= Value)
+    {
+      __CLREX();
+      return;
+    }
+  } while (__STREXW(Value, pPeak) != 0U);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
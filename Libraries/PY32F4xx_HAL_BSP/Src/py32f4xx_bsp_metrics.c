@@ -0,0 +1,889 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_metrics.c
+  * @author  MCU Application Team
+  * @brief   Performance metrics BSP service.
+  *          This file provides one registry for the statistics of the drivers:
+  *           + Counters, gauges and histograms registered by name, in fixed
+  *             arrays, updated with exclusive accesses from any context
+  *           + Counters of the drivers linked in place, without a copy
+  *           + Snapshots of all the values taken at once, sent as binary
+  *             frames by the UART DMA, the ITM or read by the debugger, shown
+  *             on the host by Misc/Tools/metricsview.py
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Call BSP_METRICS_Init() with a frame buffer, then register the metrics
+       once, before they are updated, with BSP_METRICS_Register():
+       (+) BSP_METRICS_TYPE_COUNTER: events, BSP_METRICS_INC() and
+           BSP_METRICS_Add(), or BSP_METRICS_Set() of a total.
+       (+) BSP_METRICS_TYPE_GAUGE: a level, BSP_METRICS_Set() or
+           BSP_METRICS_Add() of a signed step, its maximum kept beside it.
+       (+) BSP_METRICS_TYPE_HISTOGRAM: BSP_METRICS_Observe() of a latency or
+           a size, counted in the bucket below the first of the ascending
+           pEdges above it, or in the last bucket, the values summed for the
+           mean.
+       The name is a string constant, kept by pointer. The ID returned indexes
+       the registry; an update of BSP_METRICS_ID_NONE or of an ID not
+       registered is ignored, so a driver can initialize its IDs to
+       BSP_METRICS_ID_NONE and update them whether the registration was done
+       or not.
+
+   (#) A counter a driver already keeps, the Overruns of BSP_ADCSTREAM or of
+       BSP_GRAB for instance, is registered with BSP_METRICS_Link(): the word
+       is read in place at each snapshot and costs nothing on the hot path.
+       Statistics in another form, HAL_DMAEx_GetStats(), BSP_LOG_GetDropped()
+       or the profiles of BSP_IRQPROF, are copied to gauges or counters by
+       BSP_METRICS_SnapshotCallback(), called before each snapshot.
+
+   (#) The updates are exclusive accesses (LDREX/STREX) of the value words,
+       from thread mode and from interrupt handlers of any priority without
+       masking the interrupts. A snapshot copies all the value words with the
+       interrupts masked, a few cycles per word: the values of a frame are
+       consistent with each other.
+
+   (#) BSP_METRICS_Send() takes a snapshot and hands it to the transport. The
+       frames are little-endian words:
+         BSP_METRICS_SYNC, kind << 24 | payload words, snapshot number,
+         DWT cycle count, payload, checksum
+       the checksum making the sum of the words after the sync 0. A layout
+       frame, the names, types and bucket edges, precedes the snapshot after
+       a registration and every BSP_METRICS_LAYOUT_PERIOD snapshots, for a
+       viewer started late. BSP_METRICS_Process(), from the main loop, sends
+       one every BSP_METRICS_SetPeriod() milliseconds or when Request is set,
+       by the application or by the host through the debugger.
+
+   (#) The transports:
+       (+) BSP_METRICS_TRANSPORT_MEMORY, the default: the frames stay in the
+           buffer, the host reads the BSP_Metrics control block through the
+           debugger while the core runs.
+       (+) BSP_METRICS_TRANSPORT_UART with BSP_METRICS_ConfigUart(): the UART
+           DMA sends the frames, BSP_METRICS_Send() returning HAL_BUSY until
+           the previous ones are sent. When USE_HAL_UART_REGISTER_CALLBACKS is
+           0, call BSP_METRICS_TxCpltCallback() from HAL_UART_TxCpltCallback().
+           The UART is not shared with BSP_LOG.
+       (+) BSP_METRICS_TRANSPORT_ITM with BSP_METRICS_ConfigITM(): the words
+           are written to the stimulus port BSP_METRICS_ITM_PORT and sent on
+           SWO at SwoHz, beside the records of BSP_LOG.
+
+   (#) On the host, Misc/Tools/metricsview.py shows the last snapshot as a
+       table refreshed in place, with the rates of the counters, from a
+       serial port, a file, a raw capture of SWO with --itm, or the buffer in
+       RAM with --pyocd.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_metrics.h"
+#include "py32f4xx_bsp_trace.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_METRICS BSP METRICS
+  * @brief Performance metrics BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Private_Constants BSP METRICS Private Constants
+  * @{
+  */
+#define METRICS_HEADER_WORDS      4U          /*!< Sync, kind and length, snapshot number, cycle count */
+#define METRICS_FRAME_WORDS       (METRICS_HEADER_WORDS + 2U) /*!< With the metric count and the checksum */
+#define METRICS_KIND_POS          24U
+#define METRICS_MAX_XFER_WORDS    (0xFFFFU / 4U) /*!< Largest DMA transfer, CNDTR is 16-bit */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Private_Variables BSP METRICS Private Variables
+  * @{
+  */
+/* Not static, the host finds the control block by its symbol */
+BSP_METRICS_TypeDef BSP_Metrics;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_METRICS_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef METRICS_Insert(const char *pName, uint32_t Type, __IO uint32_t *pValue,
+                                        const uint32_t *pEdges, uint32_t Edges, uint32_t Words,
+                                        uint32_t *pId);
+static void     METRICS_Add(__IO uint32_t *pWord, uint32_t Value);
+static void     METRICS_Max(__IO uint32_t *pWord, uint32_t Value);
+static uint32_t METRICS_NameLength(const char *pName);
+static uint32_t METRICS_Layout(uint32_t *pFrame, uint32_t Size);
+static uint32_t METRICS_Snapshot(uint32_t *pFrame, uint32_t Size);
+static void     METRICS_Seal(uint32_t *pFrame, uint32_t Kind, uint32_t Payload);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_METRICS_Exported_Functions BSP METRICS Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_METRICS_Exported_Functions_Group1 Initialization and registration functions
+  * @brief    Initialization and registration functions
+  *
+@verbatim
+ ===============================================================================
+              ##### Initialization and registration functions #####
+ ===============================================================================
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the metrics registry, empty, with the memory transport.
+  * @note   Starts the DWT cycle counter of the timestamps.
+  * @param  pBuffer Pointer to the frame storage.
+  * @param  Size Size of the frame storage in words, enough for a layout frame
+  *         and a snapshot frame of the metrics registered.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_METRICS_Init(uint32_t *pBuffer, uint32_t Size)
+{
+  if ((pBuffer == NULL) || (Size < (2U * METRICS_FRAME_WORDS)))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  BSP_Metrics.Magic     = 0U;
+  BSP_Metrics.pBuffer   = NULL;
+  BSP_Metrics.Size      = Size;
+  BSP_Metrics.Length    = 0U;
+  BSP_Metrics.Sequence  = 0U;
+  BSP_Metrics.Request   = 0U;
+  BSP_Metrics.Period    = 0U;
+  BSP_Metrics.TickStart = HAL_GetTick();
+  BSP_Metrics.Count     = 0U;
+  BSP_Metrics.Used      = 0U;
+  BSP_Metrics.Layout    = 0U;
+  BSP_Metrics.Busy      = 0U;
+  BSP_Metrics.Transport = BSP_METRICS_TRANSPORT_MEMORY;
+
+  /* The registry is used by the updates and the host as soon as pBuffer is set */
+  __DMB();
+  BSP_Metrics.pBuffer   = pBuffer;
+  BSP_Metrics.Magic     = BSP_METRICS_MAGIC;
+
+  return HAL_OK;
+}
+
+#if defined (HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  Send the frames with the UART DMA.
+  * @param  huart Pointer to a UART_HandleTypeDef structure, its hdmatx must be linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_METRICS_ConfigUart(UART_HandleTypeDef *huart)
+{
+  if ((BSP_Metrics.pBuffer == NULL) || (huart == NULL) || (huart->hdmatx == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  if (HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID, BSP_METRICS_TxCpltCallback) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+  BSP_Metrics.huart     = huart;
+  BSP_Metrics.Layout    = 0U;
+  BSP_Metrics.Transport = BSP_METRICS_TRANSPORT_UART;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  UART transmit complete handler of the metrics.
+  * @note   To be called from HAL_UART_TxCpltCallback() when
+  *         USE_HAL_UART_REGISTER_CALLBACKS is 0. Other UARTs are ignored.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_METRICS_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if ((BSP_Metrics.Transport != BSP_METRICS_TRANSPORT_UART) || (huart != BSP_Metrics.huart))
+  {
+    return;
+  }
+
+  BSP_Metrics.Busy = 0U;
+}
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @brief  Assign the SWO pin and write the frames to the ITM stimulus port BSP_METRICS_ITM_PORT.
+  * @param  SwoHz SWO bit rate in NRZ, a divider of HCLK.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_METRICS_ConfigITM(uint32_t SwoHz)
+{
+  if ((BSP_Metrics.pBuffer == NULL) || (BSP_TRACE_Init(SwoHz) != HAL_OK) ||
+      (BSP_TRACE_EnablePort(BSP_METRICS_ITM_PORT) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  BSP_Metrics.Layout    = 0U;
+  BSP_Metrics.Transport = BSP_METRICS_TRANSPORT_ITM;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the period of the snapshots sent by BSP_METRICS_Process().
+  * @param  Period Milliseconds between two snapshots, 0 to send them on
+  *         request only.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_METRICS_SetPeriod(uint32_t Period)
+{
+  if (BSP_Metrics.pBuffer == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  BSP_Metrics.Period    = Period;
+  BSP_Metrics.TickStart = HAL_GetTick();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Register a metric with its value words in the registry.
+  * @param  pName Name of the metric, a string constant.
+  * @param  Type A value of @ref BSP_METRICS_Type.
+  * @param  pEdges Ascending upper bounds, excluded, of the buckets of a
+  *         histogram but the last, kept by pointer, NULL for the other types.
+  * @param  Edges Number of edges of a histogram, 1 to BSP_METRICS_EDGES_MAX,
+  *         0 for the other types.
+  * @param  pId Pointer to the ID of the metric, BSP_METRICS_ID_NONE on error.
+  * @retval HAL status, HAL_ERROR when the registry is full
+  */
+HAL_StatusTypeDef BSP_METRICS_Register(const char *pName, uint32_t Type, const uint32_t *pEdges,
+                                       uint32_t Edges, uint32_t *pId)
+{
+  uint32_t words;
+
+  if (pId == NULL)
+  {
+    return HAL_ERROR;
+  }
+  *pId = BSP_METRICS_ID_NONE;
+
+  if (Type == BSP_METRICS_TYPE_HISTOGRAM)
+  {
+    if ((pEdges == NULL) || (Edges == 0U) || (Edges > BSP_METRICS_EDGES_MAX))
+    {
+      return HAL_ERROR;
+    }
+    words = Edges + 2U;
+  }
+  else if ((Type == BSP_METRICS_TYPE_COUNTER) || (Type == BSP_METRICS_TYPE_GAUGE))
+  {
+    pEdges = NULL;
+    Edges  = 0U;
+    words  = Type + 1U;
+  }
+  else
+  {
+    return HAL_ERROR;
+  }
+
+  return METRICS_Insert(pName, Type, NULL, pEdges, Edges, words, pId);
+}
+
+/**
+  * @brief  Register a counter or a gauge kept by a driver, read in place by the snapshots.
+  * @note   The word is not written by the service: the updates and
+  *         BSP_METRICS_Reset() ignore the metric, a gauge has no maximum.
+  * @param  pName Name of the metric, a string constant.
+  * @param  Type BSP_METRICS_TYPE_COUNTER or BSP_METRICS_TYPE_GAUGE.
+  * @param  pValue Pointer to the word of the driver, valid while the registry is.
+  * @param  pId Pointer to the ID of the metric, BSP_METRICS_ID_NONE on error.
+  * @retval HAL status, HAL_ERROR when the registry is full
+  */
+HAL_StatusTypeDef BSP_METRICS_Link(const char *pName, uint32_t Type, __IO uint32_t *pValue, uint32_t *pId)
+{
+  if (pId == NULL)
+  {
+    return HAL_ERROR;
+  }
+  *pId = BSP_METRICS_ID_NONE;
+
+  if ((pValue == NULL) || ((Type != BSP_METRICS_TYPE_COUNTER) && (Type != BSP_METRICS_TYPE_GAUGE)))
+  {
+    return HAL_ERROR;
+  }
+
+  return METRICS_Insert(pName, Type, pValue, NULL, 0U, 1U, pId);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_METRICS_Exported_Functions_Group2 Update functions
+  * @brief    Update functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Update functions #####
+ ===============================================================================
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Add to a counter, or a signed step to a gauge.
+  * @param  Id ID of the metric.
+  * @param  Value Value added, modulo 2^32.
+  * @retval None
+  */
+void BSP_METRICS_Add(uint32_t Id, uint32_t Value)
+{
+  BSP_METRICS_MetricTypeDef *metric;
+  uint32_t value;
+
+  if (Id >= BSP_Metrics.Count)
+  {
+    return;
+  }
+  metric = &BSP_Metrics.Metrics[Id];
+  if (metric->Linked != 0U)
+  {
+    return;
+  }
+
+  if (metric->Type == BSP_METRICS_TYPE_COUNTER)
+  {
+    METRICS_Add(&metric->pValue[0], Value);
+  }
+  else if (metric->Type == BSP_METRICS_TYPE_GAUGE)
+  {
+    do
+    {
+      value = __LDREXW(&metric->pValue[0]) + Value;
+    } while (__STREXW(value, &metric->pValue[0]) != 0U);
+    METRICS_Max(&metric->pValue[1], value);
+  }
+  else
+  {
+    /* Histograms take BSP_METRICS_Observe() */
+  }
+}
+
+/**
+  * @brief  Set the value of a counter or of a gauge.
+  * @param  Id ID of the metric.
+  * @param  Value New value.
+  * @retval None
+  */
+void BSP_METRICS_Set(uint32_t Id, uint32_t Value)
+{
+  BSP_METRICS_MetricTypeDef *metric;
+
+  if (Id >= BSP_Metrics.Count)
+  {
+    return;
+  }
+  metric = &BSP_Metrics.Metrics[Id];
+  if ((metric->Linked != 0U) || (metric->Type == BSP_METRICS_TYPE_HISTOGRAM))
+  {
+    return;
+  }
+
+  metric->pValue[0] = Value;
+  if (metric->Type == BSP_METRICS_TYPE_GAUGE)
+  {
+    METRICS_Max(&metric->pValue[1], Value);
+  }
+}
+
+/**
+  * @brief  Count a value in its bucket of a histogram.
+  * @param  Id ID of the metric.
+  * @param  Value Value observed.
+  * @retval None
+  */
+void BSP_METRICS_Observe(uint32_t Id, uint32_t Value)
+{
+  BSP_METRICS_MetricTypeDef *metric;
+  uint32_t bucket;
+
+  if (Id >= BSP_Metrics.Count)
+  {
+    return;
+  }
+  metric = &BSP_Metrics.Metrics[Id];
+  if (metric->Type != BSP_METRICS_TYPE_HISTOGRAM)
+  {
+    return;
+  }
+
+  for (bucket = 0U; (bucket < metric->Edges) && (Value >= metric->pEdges[bucket]); bucket++)
+  {
+  }
+  METRICS_Add(&metric->pValue[bucket], 1U);
+  METRICS_Add(&metric->pValue[metric->Edges + 1U], Value);
+}
+
+/**
+  * @brief  Clear the values of the metrics of the registry, the maximum of the gauges included.
+  * @note   The linked counters are the ones of their drivers and are not cleared.
+  * @retval None
+  */
+void BSP_METRICS_Reset(void)
+{
+  uint32_t primask_bit;
+  uint32_t i;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0U; i < BSP_Metrics.Used; i++)
+  {
+    BSP_Metrics.Values[i] = 0U;
+  }
+  /* An update preempted between its LDREX and its STREX then loads the value again */
+  __CLREX();
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_METRICS_Exported_Functions_Group3 Export functions
+  * @brief    Export functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Export functions #####
+ ===============================================================================
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Take a snapshot of the metrics and hand it to the transport.
+  * @note   Preceded by a layout frame after a registration and every
+  *         BSP_METRICS_LAYOUT_PERIOD snapshots. The ITM transport writes the
+  *         frames in the call, waiting for the port to be ready; the UART
+  *         transport starts a DMA transfer. Not to be called from an interrupt
+  *         handler preempting BSP_METRICS_Send() or BSP_METRICS_Process().
+  * @retval HAL status, HAL_BUSY while the UART sends the previous frames,
+  *         HAL_ERROR when the frames do not fit in the buffer
+  */
+HAL_StatusTypeDef BSP_METRICS_Send(void)
+{
+  uint32_t *buffer = BSP_Metrics.pBuffer;
+  uint32_t length = 0U;
+  uint32_t words;
+  uint32_t i;
+
+  if (buffer == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if (BSP_Metrics.Busy != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  BSP_METRICS_SnapshotCallback();
+
+  /* Odd while the buffer is written, the host reading it again */
+  BSP_Metrics.Sequence++;
+  __DMB();
+
+  if (BSP_Metrics.Layout == 0U)
+  {
+    length = METRICS_Layout(buffer, BSP_Metrics.Size);
+  }
+  words = METRICS_Snapshot(&buffer[length], BSP_Metrics.Size - length);
+  if ((words == 0U) || ((length == 0U) && (BSP_Metrics.Layout == 0U)))
+  {
+    BSP_Metrics.Length = 0U;
+    __DMB();
+    BSP_Metrics.Sequence++;
+    return HAL_ERROR;
+  }
+  BSP_Metrics.Layout = ((length != 0U) ? BSP_METRICS_LAYOUT_PERIOD : BSP_Metrics.Layout) - 1U;
+  length += words;
+
+  BSP_Metrics.Length = length;
+  __DMB();
+  BSP_Metrics.Sequence++;
+  BSP_Metrics.Request = 0U;
+
+  if (BSP_Metrics.Transport == BSP_METRICS_TRANSPORT_ITM)
+  {
+    if (((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0U) || ((ITM->TER & (1UL << BSP_METRICS_ITM_PORT)) == 0U))
+    {
+      return HAL_ERROR;
+    }
+    for (i = 0U; i < length; i++)
+    {
+      while (ITM->PORT[BSP_METRICS_ITM_PORT].u32 == 0U)
+      {
+      }
+      ITM->PORT[BSP_METRICS_ITM_PORT].u32 = buffer[i];
+    }
+  }
+#if defined (HAL_UART_MODULE_ENABLED)
+  else if (BSP_Metrics.Transport == BSP_METRICS_TRANSPORT_UART)
+  {
+    if (length > METRICS_MAX_XFER_WORDS)
+    {
+      return HAL_ERROR;
+    }
+    BSP_Metrics.Busy = 1U;
+    if (HAL_UART_Transmit_DMA(BSP_Metrics.huart, (uint8_t *)buffer, (uint16_t)(length * 4U)) != HAL_OK)
+    {
+      /* UART busy with another transmission, the layout sent again with the next snapshot */
+      BSP_Metrics.Busy   = 0U;
+      BSP_Metrics.Layout = 0U;
+      return HAL_BUSY;
+    }
+  }
+#endif /* HAL_UART_MODULE_ENABLED */
+  else
+  {
+    /* Memory transport, the buffer is read by the host */
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Send a snapshot when the period elapsed or when one is requested.
+  * @note   Call from the main loop or an idle hook. A snapshot refused while
+  *         the UART is busy is retried on the next call.
+  * @retval None
+  */
+void BSP_METRICS_Process(void)
+{
+  if (BSP_Metrics.pBuffer == NULL)
+  {
+    return;
+  }
+
+  if ((BSP_Metrics.Period != 0U) && ((HAL_GetTick() - BSP_Metrics.TickStart) >= BSP_Metrics.Period))
+  {
+    BSP_Metrics.Request = 1U;
+  }
+  if ((BSP_Metrics.Request != 0U) && (BSP_METRICS_Send() != HAL_BUSY))
+  {
+    BSP_Metrics.Request   = 0U;
+    BSP_Metrics.TickStart = HAL_GetTick();
+  }
+}
+
+/**
+  * @brief  Snapshot callback, before the values are copied.
+  * @note   Copy here the statistics the drivers keep in another form to
+  *         metrics of the registry, HAL_DMAEx_GetStats() to gauges for
+  *         instance.
+  * @retval None
+  */
+__weak void BSP_METRICS_SnapshotCallback(void)
+{
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_METRICS_SnapshotCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_METRICS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Append a metric to the registry.
+  * @param  pName Name of the metric.
+  * @param  Type A value of @ref BSP_METRICS_Type.
+  * @param  pValue Pointer to the word of a linked metric, NULL to take the
+  *         words in the registry.
+  * @param  pEdges Bucket edges of a histogram.
+  * @param  Edges Number of edges.
+  * @param  Words Value words of the metric.
+  * @param  pId Pointer to the ID of the metric.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef METRICS_Insert(const char *pName, uint32_t Type, __IO uint32_t *pValue,
+                                        const uint32_t *pEdges, uint32_t Edges, uint32_t Words,
+                                        uint32_t *pId)
+{
+  BSP_METRICS_MetricTypeDef *metric;
+  uint32_t primask_bit;
+  uint32_t id;
+  uint32_t i;
+
+  if ((BSP_Metrics.pBuffer == NULL) || (pName == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  id = BSP_Metrics.Count;
+  if ((id >= BSP_METRICS_MAX) || ((pValue == NULL) && (Words > (BSP_METRICS_WORDS - BSP_Metrics.Used))))
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_ERROR;
+  }
+
+  metric = &BSP_Metrics.Metrics[id];
+  metric->pName  = pName;
+  metric->pEdges = pEdges;
+  metric->Type   = (uint8_t)Type;
+  metric->Edges  = (uint8_t)Edges;
+  metric->Words  = (uint8_t)Words;
+  metric->Linked = (pValue != NULL) ? 1U : 0U;
+  if (pValue == NULL)
+  {
+    pValue = &BSP_Metrics.Values[BSP_Metrics.Used];
+    for (i = 0U; i < Words; i++)
+    {
+      pValue[i] = 0U;
+    }
+    BSP_Metrics.Used += Words;
+  }
+  metric->pValue = pValue;
+
+  /* The metric is complete before its ID is valid for the updates */
+  __DMB();
+  BSP_Metrics.Count  = id + 1U;
+  BSP_Metrics.Layout = 0U;
+  __set_PRIMASK(primask_bit);
+
+  *pId = id;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Atomically add a value to a word.
+  * @param  pWord Pointer to the word.
+  * @param  Value Value to add, modulo 2^32.
+  * @retval None
+  */
+static void METRICS_Add(__IO uint32_t *pWord, uint32_t Value)
+{
+  uint32_t word;
+
+  do
+  {
+    word = __LDREXW(pWord) + Value;
+  } while (__STREXW(word, pWord) != 0U);
+}
+
+/**
+  * @brief  Atomically raise a word to a value.
+  * @param  pWord Pointer to the word.
+  * @param  Value Value the word is raised to when below it.
+  * @retval None
+  */
+static void METRICS_Max(__IO uint32_t *pWord, uint32_t Value)
+{
+  do
+  {
+    if (__LDREXW(pWord) >= Value)
+    {
+      __CLREX();
+      break;
+    }
+  } while (__STREXW(Value, pWord) != 0U);
+}
+
+/**
+  * @brief  Length of a name sent, up to BSP_METRICS_NAME_MAX characters.
+  * @param  pName Name of the metric.
+  * @retval Number of characters
+  */
+static uint32_t METRICS_NameLength(const char *pName)
+{
+  uint32_t length = 0U;
+
+  while ((length < BSP_METRICS_NAME_MAX) && (pName[length] != '\0'))
+  {
+    length++;
+  }
+
+  return length;
+}
+
+/**
+  * @brief  Write the layout frame of the registry.
+  * @note   Per metric, the word type | edges << 8 | value words << 16 | name
+  *         words << 24, the name with at least one NUL, then the edges.
+  * @param  pFrame Pointer to the frame.
+  * @param  Size Words available.
+  * @retval Words of the frame, 0 when it does not fit
+  */
+static uint32_t METRICS_Layout(uint32_t *pFrame, uint32_t Size)
+{
+  const BSP_METRICS_MetricTypeDef *metric;
+  uint32_t count = BSP_Metrics.Count;
+  uint32_t length = METRICS_HEADER_WORDS + 1U;
+  uint32_t name;
+  uint32_t words;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0U; i < count; i++)
+  {
+    metric = &BSP_Metrics.Metrics[i];
+    name   = METRICS_NameLength(metric->pName);
+    words  = (name / 4U) + 1U;
+    if ((Size - length) < (1U + words + metric->Edges + 1U))
+    {
+      return 0U;
+    }
+    pFrame[length++] = metric->Type | ((uint32_t)metric->Edges << 8U) |
+                       ((uint32_t)metric->Words << 16U) | (words << 24U);
+    for (j = 0U; j < words; j++)
+    {
+      pFrame[length + j] = 0U;
+    }
+    for (j = 0U; j < name; j++)
+    {
+      pFrame[length + (j / 4U)] |= (uint32_t)(uint8_t)metric->pName[j] << (8U * (j % 4U));
+    }
+    length += words;
+    for (j = 0U; j < metric->Edges; j++)
+    {
+      pFrame[length++] = metric->pEdges[j];
+    }
+  }
+
+  pFrame[METRICS_HEADER_WORDS] = count;
+  METRICS_Seal(pFrame, BSP_METRICS_FRAME_LAYOUT, length - METRICS_HEADER_WORDS);
+
+  return length + 1U;
+}
+
+/**
+  * @brief  Write the snapshot frame of the registry, the values copied with the interrupts masked.
+  * @param  pFrame Pointer to the frame.
+  * @param  Size Words available.
+  * @retval Words of the frame, 0 when it does not fit
+  */
+static uint32_t METRICS_Snapshot(uint32_t *pFrame, uint32_t Size)
+{
+  const BSP_METRICS_MetricTypeDef *metric;
+  uint32_t count = BSP_Metrics.Count;
+  uint32_t length = METRICS_HEADER_WORDS + 1U;
+  uint32_t primask_bit;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0U; i < count; i++)
+  {
+    length += BSP_Metrics.Metrics[i].Words;
+  }
+  if (Size < (length + 1U))
+  {
+    return 0U;
+  }
+
+  length = METRICS_HEADER_WORDS + 1U;
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  pFrame[3] = DWT->CYCCNT;
+  for (i = 0U; i < count; i++)
+  {
+    metric = &BSP_Metrics.Metrics[i];
+    for (j = 0U; j < metric->Words; j++)
+    {
+      pFrame[length++] = metric->pValue[j];
+    }
+  }
+  __set_PRIMASK(primask_bit);
+
+  pFrame[METRICS_HEADER_WORDS] = count;
+  METRICS_Seal(pFrame, BSP_METRICS_FRAME_SNAPSHOT, length - METRICS_HEADER_WORDS);
+
+  return length + 1U;
+}
+
+/**
+  * @brief  Write the header of a frame and its checksum.
+  * @note   The cycle count of a snapshot frame is written with its values.
+  * @param  pFrame Pointer to the frame, its payload written.
+  * @param  Kind A value of @ref BSP_METRICS_Frame.
+  * @param  Payload Words of the payload.
+  * @retval None
+  */
+static void METRICS_Seal(uint32_t *pFrame, uint32_t Kind, uint32_t Payload)
+{
+  uint32_t sum = 0U;
+  uint32_t i;
+
+  pFrame[0] = BSP_METRICS_SYNC;
+  pFrame[1] = (Kind << METRICS_KIND_POS) | Payload;
+  pFrame[2] = BSP_Metrics.Sequence / 2U;
+  if (Kind != BSP_METRICS_FRAME_SNAPSHOT)
+  {
+    pFrame[3] = DWT->CYCCNT;
+  }
+
+  for (i = 1U; i < (METRICS_HEADER_WORDS + Payload); i++)
+  {
+    sum += pFrame[i];
+  }
+  pFrame[METRICS_HEADER_WORDS + Payload] = 0U - sum;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
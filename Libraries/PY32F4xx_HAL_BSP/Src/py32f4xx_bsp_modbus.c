@@ -0,0 +1,899 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_modbus.c
+  * @author  MCU Application Team
+  * @brief   Modbus server BSP service.
+  *          This file provides functions to serve a register map over a UART
+  *          with the Modbus protocol:
+  *           + RTU and ASCII framing, received by a circular DMA reporting
+  *             each idle line
+  *           + End of an RTU frame after 3.5 characters of silence, timed by
+  *             a BSP_TIMWHEEL timer
+  *           + Table driven CRC-16/MODBUS, LRC of the ASCII mode
+  *           + Declarative register map, its registers sent in place by the
+  *             Tx DMA when stored big endian
+  *           + Function codes 1, 2, 3, 4, 5, 6, 15 and 16, and exceptions
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the UART with HAL_UART_Init(), 8 data bits, with its Rx DMA
+       channel in circular mode and its Tx DMA channel in normal mode. In RTU
+       mode start a BSP_TIMWHEEL with a tick of BSP_MODBUS_TICK_HZ, 1 us by
+       default.
+
+   (#) Describe the map with an array of BSP_MODBUS_MapEntryTypeDef, one
+       entry per array of the application, for instance:
+         static uint16_t aHolding[16];
+         static uint8_t  aCoils[2];
+         static const BSP_MODBUS_MapEntryTypeDef aMap[] =
+         {
+           BSP_MODBUS_REGISTERS(BSP_MODBUS_TYPE_HOLDING, BSP_MODBUS_FLAG_WIRE, 0U, aHolding, NULL),
+           BSP_MODBUS_ENTRY(BSP_MODBUS_TYPE_COIL, 0U, 0U, 16U, aCoils, CoilsWritten),
+         };
+       The bits are packed 8 per byte. A request is served when its range
+       fits in one entry, else it gets the ILLEGAL DATA ADDRESS exception.
+
+   (#) Call BSP_MODBUS_Init() with the UART, the timer wheel (NULL in ASCII
+       mode), the mode, the server address and the map, then
+       BSP_MODBUS_Start(). Forward HAL_UARTEx_RxFrameCallback() to
+       BSP_MODBUS_RxFrameCallback() and HAL_UART_TxCpltCallback() to
+       BSP_MODBUS_TxCpltCallback().
+
+   (#) The Rx DMA runs without end; each idle line, half and full transfer
+       reports the new bytes. In RTU mode they are appended to the frame and
+       the silence timer restarted: when it expires, 3.5 characters after the
+       last report (1.75 ms above 19200 bauds), the frame is complete. In
+       ASCII mode the characters are decoded as they come, from ':' to LF.
+       Bytes received while a frame waits or a response is sent, an echo of
+       a half duplex line for instance, are dropped.
+
+   (#) Call BSP_MODBUS_Process() from the main loop. It checks the CRC or
+       LRC and the address, serves the request from the map, calls the
+       WriteCallback of an entry written and starts the response. Broadcasts
+       (address 0) are served without response.
+
+   (#) Registers of an entry with BSP_MODBUS_FLAG_WIRE are stored big endian,
+       use BSP_MODBUS_WIRE16() to read and write them. In RTU mode a read of
+       them is sent in three DMA transfers: the header, the registers in
+       place in the map, then the CRC, without copy. The CRC is computed when
+       the response starts: a register changed before the DMA reads it makes
+       the master see a CRC error and retry, never a wrong value.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_modbus.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_MODBUS BSP MODBUS
+  * @brief Modbus server BSP service
+  * @{
+  */
+
+#if defined (HAL_UART_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Private_Constants BSP MODBUS Private Constants
+  * @{
+  */
+#define MODBUS_ADDRESS_MAX              247U           /*!< Largest server address                          */
+#define MODBUS_CHAR_BITS                11U            /*!< Start, 8 data, parity or second stop, stop      */
+#define MODBUS_SILENCE_BAUDRATE         19200U         /*!< Fixed silence above it                          */
+#define MODBUS_SILENCE_US               1750U          /*!< Silence above MODBUS_SILENCE_BAUDRATE           */
+
+#define MODBUS_READ_BITS_MAX            2000U
+#define MODBUS_READ_REGISTERS_MAX       125U
+#define MODBUS_WRITE_BITS_MAX           1968U
+#define MODBUS_WRITE_REGISTERS_MAX      123U
+
+#define MODBUS_COIL_ON                  0xFF00U
+#define MODBUS_COIL_OFF                 0x0000U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Private_Macros BSP MODBUS Private Macros
+  * @{
+  */
+#define MODBUS_GET16(__P__)             ((uint32_t)((__P__)[0] << 8) | (__P__)[1])
+#define MODBUS_GET_BIT(__P__, __N__)    (((__P__)[(__N__) >> 3] >> ((__N__) & 7U)) & 1U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Private_Variables BSP MODBUS Private Variables
+  * @{
+  */
+/* CRC-16/MODBUS table, the same for all the servers */
+static BSP_CRC_TableTypeDef aModbusTable[1];
+
+static const char aHex[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_MODBUS_Private_Functions BSP MODBUS Private Functions
+  * @{
+  */
+static void     MODBUS_SilenceCallback(BSP_TIMWHEEL_TimerTypeDef *pTimer);
+static void     MODBUS_ReceiveAscii(BSP_MODBUS_TypeDef *hmb, const uint8_t *pData, uint32_t Length);
+static const BSP_MODBUS_MapEntryTypeDef *MODBUS_Find(const BSP_MODBUS_TypeDef *hmb, uint32_t Type,
+                                                     uint32_t Start, uint32_t Count);
+static uint32_t MODBUS_Execute(BSP_MODBUS_TypeDef *hmb, uint32_t Length);
+static void     MODBUS_Send(BSP_MODBUS_TypeDef *hmb);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_MODBUS_Exported_Functions BSP MODBUS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a Modbus server.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  huart UART handle, initialized, its Rx DMA circular.
+  * @param  hwheel Timer wheel of the RTU silence, NULL in ASCII mode.
+  * @param  Mode A value of @ref BSP_MODBUS_Mode.
+  * @param  Address Server address, 1 to 247.
+  * @param  pMap Register map, kept by the server.
+  * @param  MapSize Number of entries of the map.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MODBUS_Init(BSP_MODBUS_TypeDef *hmb, UART_HandleTypeDef *huart, BSP_TIMWHEEL_TypeDef *hwheel,
+                                  uint32_t Mode, uint32_t Address, const BSP_MODBUS_MapEntryTypeDef *pMap,
+                                  uint32_t MapSize)
+{
+  uint32_t baudrate;
+
+  if ((hmb == NULL) || (huart == NULL) || (huart->hdmarx == NULL) || (huart->hdmatx == NULL) ||
+      (Mode > BSP_MODBUS_MODE_ASCII) || ((Mode == BSP_MODBUS_MODE_RTU) && (hwheel == NULL)) ||
+      (Address == 0U) || (Address > MODBUS_ADDRESS_MAX) || ((pMap == NULL) && (MapSize != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (BSP_CRC_Init(&hmb->Crc, &BSP_CRC_Model_CRC16_MODBUS, aModbusTable, 1U) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* 3.5 characters of 11 bits, rounded up */
+  baudrate = huart->Init.BaudRate;
+  if (baudrate > MODBUS_SILENCE_BAUDRATE)
+  {
+    hmb->Silence = (uint32_t)(((uint64_t)BSP_MODBUS_TICK_HZ * MODBUS_SILENCE_US + 999999U) / 1000000U);
+  }
+  else
+  {
+    hmb->Silence = (uint32_t)(((uint64_t)BSP_MODBUS_TICK_HZ * MODBUS_CHAR_BITS * 7U + 2U * baudrate - 1U) /
+                              (2U * baudrate));
+  }
+
+  hmb->huart        = huart;
+  hmb->hwheel       = hwheel;
+  hmb->Mode         = Mode;
+  hmb->Address      = Address;
+  hmb->pMap         = pMap;
+  hmb->MapSize      = MapSize;
+  hmb->State        = BSP_MODBUS_STATE_RESET;
+  hmb->Skip         = 0U;
+  hmb->Length       = 0U;
+  hmb->SegmentCount = 0U;
+  hmb->SegmentNext  = 0U;
+  memset(&hmb->Stats, 0, sizeof(hmb->Stats));
+  BSP_TIMWHEEL_TimerInit(&hmb->Timer, MODBUS_SilenceCallback, hmb);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the reception of the requests.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MODBUS_Start(BSP_MODBUS_TypeDef *hmb)
+{
+  if ((hmb->huart == NULL) || (hmb->State != BSP_MODBUS_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+
+  hmb->Skip   = 0U;
+  hmb->Length = 0U;
+  hmb->Nibble = 0U;
+  hmb->State  = BSP_MODBUS_STATE_IDLE;
+
+  if (HAL_UARTEx_ReceiveToIdle_DMA(hmb->huart, hmb->RxBuffer, BSP_MODBUS_RX_SIZE) != HAL_OK)
+  {
+    hmb->State = BSP_MODBUS_STATE_RESET;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the server, the frame received or the response being sent is lost.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MODBUS_Stop(BSP_MODBUS_TypeDef *hmb)
+{
+  if (hmb->State == BSP_MODBUS_STATE_RESET)
+  {
+    return HAL_ERROR;
+  }
+
+  hmb->State = BSP_MODBUS_STATE_RESET;
+  if (hmb->hwheel != NULL)
+  {
+    BSP_TIMWHEEL_TimerStop(hmb->hwheel, &hmb->Timer);
+  }
+
+  return HAL_UART_Abort(hmb->huart);
+}
+
+/**
+  * @brief  Take the bytes reported by the Rx DMA.
+  * @note   To be called from HAL_UARTEx_RxFrameCallback() of the UART.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  Offset Offset of the bytes in the Rx buffer.
+  * @param  Length Number of bytes.
+  * @retval None
+  */
+void BSP_MODBUS_RxFrameCallback(BSP_MODBUS_TypeDef *hmb, uint32_t Offset, uint32_t Length)
+{
+  uint32_t primask_bit;
+
+  if (hmb->Mode == BSP_MODBUS_MODE_ASCII)
+  {
+    MODBUS_ReceiveAscii(hmb, &hmb->RxBuffer[Offset], Length);
+    return;
+  }
+
+  /* The silence callback can run at another priority */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if ((hmb->State == BSP_MODBUS_STATE_IDLE) && (hmb->Skip == 0U))
+  {
+    hmb->State  = BSP_MODBUS_STATE_RECEIVE;
+    hmb->Length = 0U;
+  }
+
+  if ((hmb->State == BSP_MODBUS_STATE_RECEIVE) && (hmb->Skip == 0U) &&
+      (Length <= (BSP_MODBUS_ADU_SIZE - hmb->Length)))
+  {
+    memcpy(&hmb->Adu[hmb->Length], &hmb->RxBuffer[Offset], Length);
+    hmb->Length += Length;
+  }
+  else if ((hmb->State != BSP_MODBUS_STATE_RESET) && (hmb->Skip == 0U))
+  {
+    /* Frame too long or received while busy: dropped up to the next silence */
+    hmb->Skip = 1U;
+    hmb->Stats.Dropped++;
+  }
+
+  if (hmb->State != BSP_MODBUS_STATE_RESET)
+  {
+    (void)BSP_TIMWHEEL_TimerStart(hmb->hwheel, &hmb->Timer, hmb->Silence, 0U);
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Send the next segment of the response, or end it.
+  * @note   To be called from HAL_UART_TxCpltCallback() of the UART.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @retval None
+  */
+void BSP_MODBUS_TxCpltCallback(BSP_MODBUS_TypeDef *hmb)
+{
+  const BSP_MODBUS_SegmentTypeDef *segment;
+
+  if (hmb->State != BSP_MODBUS_STATE_TX)
+  {
+    return;
+  }
+
+  if (hmb->SegmentNext < hmb->SegmentCount)
+  {
+    segment = &hmb->Segments[hmb->SegmentNext];
+    hmb->SegmentNext++;
+    if (HAL_UART_Transmit_DMA(hmb->huart, (uint8_t *)segment->pData, (uint16_t)segment->Length) == HAL_OK)
+    {
+      return;
+    }
+  }
+  else
+  {
+    hmb->Stats.Responses++;
+  }
+
+  hmb->State = BSP_MODBUS_STATE_IDLE;
+}
+
+/**
+  * @brief  Serve the request received, if any.
+  * @note   To be called from the main loop, the write callbacks of the map run
+  *         from it.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @retval None
+  */
+void BSP_MODBUS_Process(BSP_MODBUS_TypeDef *hmb)
+{
+  uint32_t length = hmb->Length;
+  uint32_t check = 0U;
+  uint32_t error;
+  uint32_t exception;
+  uint32_t i;
+
+  if (hmb->State != BSP_MODBUS_STATE_READY)
+  {
+    return;
+  }
+
+  if (hmb->Mode == BSP_MODBUS_MODE_RTU)
+  {
+    error = ((length < 4U) || (BSP_CRC_Compute(&hmb->Crc, hmb->Adu, length - 2U, &check) != HAL_OK) ||
+             (check != (hmb->Adu[length - 2U] | ((uint32_t)hmb->Adu[length - 1U] << 8)))) ? 1U : 0U;
+    length -= 2U;
+  }
+  else
+  {
+    /* The bytes and their LRC sum to 0 */
+    for (i = 0U; i < length; i++)
+    {
+      check += hmb->Adu[i];
+    }
+    error = ((length < 3U) || ((check & 0xFFU) != 0U)) ? 1U : 0U;
+    length -= 1U;
+  }
+
+  if (error != 0U)
+  {
+    hmb->Stats.Errors++;
+    hmb->State = BSP_MODBUS_STATE_IDLE;
+    return;
+  }
+
+  if ((hmb->Adu[0] != 0U) && (hmb->Adu[0] != hmb->Address))
+  {
+    hmb->State = BSP_MODBUS_STATE_IDLE;
+    return;
+  }
+
+  hmb->Stats.Requests++;
+  exception = MODBUS_Execute(hmb, length - 1U);
+
+  if (hmb->Adu[0] == 0U)
+  {
+    hmb->State = BSP_MODBUS_STATE_IDLE;
+    return;
+  }
+
+  if (exception != BSP_MODBUS_EX_NONE)
+  {
+    hmb->TxBuffer[2] = hmb->Adu[1] | 0x80U;
+    hmb->TxBuffer[3] = (uint8_t)exception;
+    hmb->Segments[0].Length = 3U;
+    hmb->Segments[1].Length = 0U;
+    hmb->Stats.Exceptions++;
+  }
+
+  MODBUS_Send(hmb);
+}
+
+/**
+  * @brief  Read the statistics.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_MODBUS_GetStats(const BSP_MODBUS_TypeDef *hmb, BSP_MODBUS_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = hmb->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_MODBUS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  End the RTU frame after 3.5 characters of silence.
+  * @param  pTimer Silence timer of the server.
+  * @retval None
+  */
+static void MODBUS_SilenceCallback(BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  BSP_MODBUS_TypeDef *hmb = (BSP_MODBUS_TypeDef *)pTimer->pContext;
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (hmb->State == BSP_MODBUS_STATE_RECEIVE)
+  {
+    hmb->State = (hmb->Skip == 0U) ? BSP_MODBUS_STATE_READY : BSP_MODBUS_STATE_IDLE;
+  }
+  hmb->Skip = 0U;
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Decode ASCII characters, from ':' to LF.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  pData Characters received.
+  * @param  Length Number of characters.
+  * @retval None
+  */
+static void MODBUS_ReceiveAscii(BSP_MODBUS_TypeDef *hmb, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t i;
+  uint32_t c;
+  uint32_t value;
+
+  for (i = 0U; i < Length; i++)
+  {
+    c = pData[i];
+
+    if (c == ':')
+    {
+      if ((hmb->State == BSP_MODBUS_STATE_IDLE) || (hmb->State == BSP_MODBUS_STATE_RECEIVE))
+      {
+        if (hmb->State == BSP_MODBUS_STATE_RECEIVE)
+        {
+          hmb->Stats.Dropped++;
+        }
+        hmb->State  = BSP_MODBUS_STATE_RECEIVE;
+        hmb->Length = 0U;
+        hmb->Nibble = 0U;
+      }
+      else if (hmb->State != BSP_MODBUS_STATE_RESET)
+      {
+        hmb->Stats.Dropped++;
+      }
+      continue;
+    }
+
+    if ((hmb->State != BSP_MODBUS_STATE_RECEIVE) || (c == '\r'))
+    {
+      continue;
+    }
+
+    if (c == '\n')
+    {
+      if ((hmb->Nibble == 0U) && (hmb->Length != 0U))
+      {
+        hmb->State = BSP_MODBUS_STATE_READY;
+      }
+      else
+      {
+        hmb->Stats.Dropped++;
+        hmb->State = BSP_MODBUS_STATE_IDLE;
+      }
+      continue;
+    }
+
+    if ((c >= '0') && (c <= '9'))
+    {
+      value = c - '0';
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+      value = c - 'A' + 10U;
+    }
+    else
+    {
+      value = 16U;
+    }
+
+    if ((value > 15U) || ((hmb->Nibble == 0U) && (hmb->Length == BSP_MODBUS_ADU_SIZE)))
+    {
+      hmb->Stats.Dropped++;
+      hmb->State = BSP_MODBUS_STATE_IDLE;
+    }
+    else if (hmb->Nibble != 0U)
+    {
+      hmb->Adu[hmb->Length] = (uint8_t)(((hmb->Nibble & 0x0FU) << 4) | value);
+      hmb->Length++;
+      hmb->Nibble = 0U;
+    }
+    else
+    {
+      hmb->Nibble = 0x100U | value;
+    }
+  }
+}
+
+/**
+  * @brief  Find the entry of the map holding a range.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  Type A value of @ref BSP_MODBUS_Type.
+  * @param  Start Modbus address of the first bit or register.
+  * @param  Count Number of bits or registers.
+  * @retval Entry, NULL when no entry holds the whole range
+  */
+static const BSP_MODBUS_MapEntryTypeDef *MODBUS_Find(const BSP_MODBUS_TypeDef *hmb, uint32_t Type,
+                                                     uint32_t Start, uint32_t Count)
+{
+  const BSP_MODBUS_MapEntryTypeDef *entry;
+  uint32_t i;
+
+  for (i = 0U; i < hmb->MapSize; i++)
+  {
+    entry = &hmb->pMap[i];
+    if ((entry->Type == Type) && (Start >= entry->Address) &&
+        ((Start + Count) <= ((uint32_t)entry->Address + entry->Count)))
+    {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Serve the request, its response PDU built after the address at TxBuffer[1].
+  * @note   Segments[0].Length is set to the bytes of the response from the
+  *         address, Segments[1] to the registers sent in place, if any.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @param  Length Length of the request PDU, from the function code.
+  * @retval A value of @ref BSP_MODBUS_Exception
+  */
+static uint32_t MODBUS_Execute(BSP_MODBUS_TypeDef *hmb, uint32_t Length)
+{
+  const uint8_t *pdu = &hmb->Adu[1];
+  uint8_t *response = &hmb->TxBuffer[2];
+  const BSP_MODBUS_MapEntryTypeDef *entry;
+  uint32_t function = pdu[0];
+  uint32_t start;
+  uint32_t count;
+  uint32_t offset;
+  uint32_t bytes;
+  uint32_t i;
+  uint8_t *bits;
+  uint8_t *wire;
+  uint16_t *registers;
+
+  hmb->Segments[0].Length = 2U;
+  hmb->Segments[1].Length = 0U;
+  response[0] = (uint8_t)function;
+
+  if ((function != 0x01U) && (function != 0x02U) && (function != 0x03U) && (function != 0x04U) &&
+      (function != 0x05U) && (function != 0x06U) && (function != 0x0FU) && (function != 0x10U))
+  {
+    return BSP_MODBUS_EX_ILLEGAL_FUNCTION;
+  }
+  if (Length < 5U)
+  {
+    return BSP_MODBUS_EX_ILLEGAL_VALUE;
+  }
+
+  start = MODBUS_GET16(&pdu[1]);
+  count = MODBUS_GET16(&pdu[3]);
+
+  switch (function)
+  {
+    case 0x01U:
+    case 0x02U:
+      /* Read coils, read discrete inputs */
+      if ((Length != 5U) || (count == 0U) || (count > MODBUS_READ_BITS_MAX))
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, (function == 0x01U) ? BSP_MODBUS_TYPE_COIL : BSP_MODBUS_TYPE_DISCRETE, start, count);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      bits   = (uint8_t *)entry->pData;
+      offset = start - entry->Address;
+      bytes  = (count + 7U) >> 3;
+      response[1] = (uint8_t)bytes;
+      memset(&response[2], 0, bytes);
+      for (i = 0U; i < count; i++)
+      {
+        response[2U + (i >> 3)] |= (uint8_t)(MODBUS_GET_BIT(bits, offset + i) << (i & 7U));
+      }
+      hmb->Segments[0].Length += 1U + bytes;
+      break;
+
+    case 0x03U:
+    case 0x04U:
+      /* Read holding registers, read input registers */
+      if ((Length != 5U) || (count == 0U) || (count > MODBUS_READ_REGISTERS_MAX))
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, (function == 0x03U) ? BSP_MODBUS_TYPE_HOLDING : BSP_MODBUS_TYPE_INPUT, start, count);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      offset = start - entry->Address;
+      response[1] = (uint8_t)(count * 2U);
+      hmb->Segments[0].Length += 1U;
+      if ((entry->Flags & BSP_MODBUS_FLAG_WIRE) != 0U)
+      {
+        wire = (uint8_t *)entry->pData + (offset * 2U);
+        if (hmb->Mode == BSP_MODBUS_MODE_RTU)
+        {
+          /* Sent in place by the Tx DMA */
+          hmb->Segments[1].pData  = wire;
+          hmb->Segments[1].Length = count * 2U;
+        }
+        else
+        {
+          memcpy(&response[2], wire, count * 2U);
+          hmb->Segments[0].Length += count * 2U;
+        }
+      }
+      else
+      {
+        registers = (uint16_t *)entry->pData + offset;
+        for (i = 0U; i < count; i++)
+        {
+          response[2U + (i * 2U)] = (uint8_t)(registers[i] >> 8);
+          response[3U + (i * 2U)] = (uint8_t)registers[i];
+        }
+        hmb->Segments[0].Length += count * 2U;
+      }
+      break;
+
+    case 0x05U:
+      /* Write single coil */
+      if ((Length != 5U) || ((count != MODBUS_COIL_ON) && (count != MODBUS_COIL_OFF)))
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, BSP_MODBUS_TYPE_COIL, start, 1U);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      bits   = (uint8_t *)entry->pData;
+      offset = start - entry->Address;
+      if (count == MODBUS_COIL_ON)
+      {
+        bits[offset >> 3] |= (uint8_t)(1U << (offset & 7U));
+      }
+      else
+      {
+        bits[offset >> 3] &= (uint8_t)~(1U << (offset & 7U));
+      }
+      if (entry->WriteCallback != NULL)
+      {
+        entry->WriteCallback(entry, offset, 1U);
+      }
+      memcpy(&response[1], &pdu[1], 4U);
+      hmb->Segments[0].Length += 4U;
+      break;
+
+    case 0x06U:
+      /* Write single register */
+      if (Length != 5U)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, BSP_MODBUS_TYPE_HOLDING, start, 1U);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      offset = start - entry->Address;
+      if ((entry->Flags & BSP_MODBUS_FLAG_WIRE) != 0U)
+      {
+        memcpy((uint8_t *)entry->pData + (offset * 2U), &pdu[3], 2U);
+      }
+      else
+      {
+        ((uint16_t *)entry->pData)[offset] = (uint16_t)count;
+      }
+      if (entry->WriteCallback != NULL)
+      {
+        entry->WriteCallback(entry, offset, 1U);
+      }
+      memcpy(&response[1], &pdu[1], 4U);
+      hmb->Segments[0].Length += 4U;
+      break;
+
+    case 0x0FU:
+      /* Write multiple coils */
+      bytes = (count + 7U) >> 3;
+      if ((count == 0U) || (count > MODBUS_WRITE_BITS_MAX) || (Length < 6U) || (pdu[5] != bytes) ||
+          (Length != (6U + bytes)))
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, BSP_MODBUS_TYPE_COIL, start, count);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      bits   = (uint8_t *)entry->pData;
+      offset = start - entry->Address;
+      for (i = 0U; i < count; i++)
+      {
+        if (MODBUS_GET_BIT(&pdu[6], i) != 0U)
+        {
+          bits[(offset + i) >> 3] |= (uint8_t)(1U << ((offset + i) & 7U));
+        }
+        else
+        {
+          bits[(offset + i) >> 3] &= (uint8_t)~(1U << ((offset + i) & 7U));
+        }
+      }
+      if (entry->WriteCallback != NULL)
+      {
+        entry->WriteCallback(entry, offset, count);
+      }
+      memcpy(&response[1], &pdu[1], 4U);
+      hmb->Segments[0].Length += 4U;
+      break;
+
+    default:
+      /* Write multiple registers */
+      bytes = count * 2U;
+      if ((count == 0U) || (count > MODBUS_WRITE_REGISTERS_MAX) || (Length < 6U) || (pdu[5] != bytes) ||
+          (Length != (6U + bytes)))
+      {
+        return BSP_MODBUS_EX_ILLEGAL_VALUE;
+      }
+      entry = MODBUS_Find(hmb, BSP_MODBUS_TYPE_HOLDING, start, count);
+      if (entry == NULL)
+      {
+        return BSP_MODBUS_EX_ILLEGAL_ADDRESS;
+      }
+      offset = start - entry->Address;
+      if ((entry->Flags & BSP_MODBUS_FLAG_WIRE) != 0U)
+      {
+        memcpy((uint8_t *)entry->pData + (offset * 2U), &pdu[6], bytes);
+      }
+      else
+      {
+        registers = (uint16_t *)entry->pData + offset;
+        for (i = 0U; i < count; i++)
+        {
+          registers[i] = (uint16_t)MODBUS_GET16(&pdu[6U + (i * 2U)]);
+        }
+      }
+      if (entry->WriteCallback != NULL)
+      {
+        entry->WriteCallback(entry, offset, count);
+      }
+      memcpy(&response[1], &pdu[1], 4U);
+      hmb->Segments[0].Length += 4U;
+      break;
+  }
+
+  return BSP_MODBUS_EX_NONE;
+}
+
+/**
+  * @brief  Frame the response built at TxBuffer[1] and start sending it.
+  * @param  hmb Pointer to a BSP_MODBUS_TypeDef structure.
+  * @retval None
+  */
+static void MODBUS_Send(BSP_MODBUS_TypeDef *hmb)
+{
+  uint8_t *frame = &hmb->TxBuffer[1];
+  uint32_t length = hmb->Segments[0].Length;
+  uint32_t crc;
+  uint32_t lrc = 0U;
+  uint32_t i;
+
+  frame[0] = (uint8_t)hmb->Address;
+
+  if (hmb->Mode == BSP_MODBUS_MODE_RTU)
+  {
+    BSP_CRC_Reset(&hmb->Crc);
+    (void)BSP_CRC_Update(&hmb->Crc, frame, length);
+    if (hmb->Segments[1].Length != 0U)
+    {
+      (void)BSP_CRC_Update(&hmb->Crc, hmb->Segments[1].pData, hmb->Segments[1].Length);
+    }
+    crc = BSP_CRC_Final(&hmb->Crc);
+
+    hmb->Segments[0].pData = frame;
+    if (hmb->Segments[1].Length != 0U)
+    {
+      /* Header, registers in place, CRC */
+      hmb->TxCrc[0] = (uint8_t)crc;
+      hmb->TxCrc[1] = (uint8_t)(crc >> 8);
+      hmb->Segments[2].pData  = hmb->TxCrc;
+      hmb->Segments[2].Length = 2U;
+      hmb->SegmentCount = 3U;
+    }
+    else
+    {
+      frame[length]      = (uint8_t)crc;
+      frame[length + 1U] = (uint8_t)(crc >> 8);
+      hmb->Segments[0].Length = length + 2U;
+      hmb->SegmentCount = 1U;
+    }
+  }
+  else
+  {
+    for (i = 0U; i < length; i++)
+    {
+      lrc += frame[i];
+    }
+    frame[length] = (uint8_t)(0U - lrc);
+    length++;
+
+    /* Encoded in place from the end, byte i goes to TxBuffer[1 + 2i] */
+    for (i = length; i-- > 0U;)
+    {
+      crc = frame[i];
+      hmb->TxBuffer[1U + (i * 2U)] = (uint8_t)aHex[crc >> 4];
+      hmb->TxBuffer[2U + (i * 2U)] = (uint8_t)aHex[crc & 0x0FU];
+    }
+    hmb->TxBuffer[0]                 = ':';
+    hmb->TxBuffer[1U + (length * 2U)] = '\r';
+    hmb->TxBuffer[2U + (length * 2U)] = '\n';
+    hmb->Segments[0].pData  = hmb->TxBuffer;
+    hmb->Segments[0].Length = 3U + (length * 2U);
+    hmb->SegmentCount = 1U;
+  }
+
+  hmb->SegmentNext = 1U;
+  hmb->State = BSP_MODBUS_STATE_TX;
+  if (HAL_UART_Transmit_DMA(hmb->huart, (uint8_t *)hmb->Segments[0].pData, (uint16_t)hmb->Segments[0].Length) != HAL_OK)
+  {
+    hmb->State = BSP_MODBUS_STATE_IDLE;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,473 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_motoradc.c
+  * @author  MCU Application Team
+  * @brief   Motor control ADC BSP service.
+  *          This file provides functions to sample the phase currents of a
+  *          field oriented control at a fixed point of the PWM period:
+  *           + Injected groups of ADC1 and ADC2 in simultaneous mode
+  *           + Conversions started by CC4 of TIM1 or TIM8
+  *           + Short interrupt path reading the results
+  *           + Zero current offsets and trigger to handler latency
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Start the PWM of TIM1 or TIM8 as usual, in TIM_COUNTERMODE_UP or in a
+       center-aligned mode 1 or 2. CC4 is taken by the service: it stays
+       inside the timer, its pin is not needed. In center-aligned mode 1 the
+       compare flags, and so the trigger, only happen while the counter counts
+       down, in mode 2 only while it counts up: SamplePoint = ARR - n in mode
+       1 samples n ticks after the center of the PWM.
+
+   (#) Initialize ADC1 and ADC2 with HAL_ADC_Init(), ScanConvMode enabled when
+       more than one injected rank is used. The regular groups stay free for
+       the application. Enable ADC1_2_IRQn and call BSP_MOTORADC_IRQHandler()
+       from ADC1_2_IRQHandler() in place of HAL_ADC_IRQHandler(): it handles
+       the end of the injected sequence only.
+
+   (#) BSP_MOTORADC_Init() sets ADC1 and ADC2 in injected simultaneous mode:
+       ADC1 is triggered by CC4, ADC2 follows it. Rank 1 of ADC1 and rank 1 of
+       ADC2 are the two phase currents, the other ranks the bus voltage or a
+       temperature. Both ADCs convert with the same SamplingTime so that they
+       end together. For TIM8 the injected trigger of ADC1 is remapped from
+       EXTI line 15 to TIM8 CC4.
+
+   (#) BSP_MOTORADC_Start() arms the conversions. On each sequence the handler
+       stores the results, then calls BSP_MOTORADC_SampleCallback(), where the
+       control loop runs. BSP_MOTORADC_GetPhaseCurrents() returns rank 1 of
+       each ADC less its zero current offset.
+
+   (#) With the PWM running and no current in the motor, run
+       BSP_MOTORADC_StartCalibration() and wait for BSP_MOTORADC_IsCalibrating()
+       to return 0: the offsets are the average of the samples.
+
+   (#) The handler reads the counter of the timer first: Latency is the time
+       from the trigger to the handler, the conversions included.
+       BSP_MOTORADC_GetLatency() gives it in ns with its maximum, the margin
+       left to the control loop in the period.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_motoradc.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_MOTORADC BSP MOTORADC
+  * @brief Motor control ADC BSP service
+  * @{
+  */
+
+#if defined (HAL_ADC_MODULE_ENABLED) && defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_MOTORADC_Exported_Functions BSP MOTORADC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the injected groups of ADC1 and ADC2 on the PWM timer.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  hadc1 ADC1 handle, initialized.
+  * @param  hadc2 ADC2 handle, initialized.
+  * @param  htim TIM1 or TIM8 handle, PWM initialized.
+  * @param  pInit Pointer to a BSP_MOTORADC_InitTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MOTORADC_Init(BSP_MOTORADC_TypeDef *hmadc, ADC_HandleTypeDef *hadc1,
+                                    ADC_HandleTypeDef *hadc2, TIM_HandleTypeDef *htim,
+                                    const BSP_MOTORADC_InitTypeDef *pInit)
+{
+  ADC_InjectionConfTypeDef sInjected = {0};
+  ADC_MultiModeTypeDef multimode = {0};
+  TIM_OC_InitTypeDef sOC = {0};
+  uint32_t pclk2;
+  uint32_t adc;
+  uint32_t rank;
+
+  if ((hmadc == NULL) || (hadc1 == NULL) || (hadc2 == NULL) || (htim == NULL) || (pInit == NULL) ||
+      (hadc1->Instance != ADC1) || (hadc2->Instance != ADC2) ||
+      ((htim->Instance != TIM1) && (htim->Instance != TIM8)) ||
+      ((htim->Init.CounterMode != TIM_COUNTERMODE_UP) &&
+       (htim->Init.CounterMode != TIM_COUNTERMODE_CENTERALIGNED1) &&
+       (htim->Init.CounterMode != TIM_COUNTERMODE_CENTERALIGNED2)) ||
+      (pInit->NbrOfConversion == 0U) || (pInit->NbrOfConversion > BSP_MOTORADC_RANKS) ||
+      (pInit->SamplePoint > htim->Init.Period))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The injected sequencer only converts several ranks in scan mode */
+  if ((pInit->NbrOfConversion > 1U) &&
+      ((hadc1->Init.ScanConvMode == ADC_SCAN_DISABLE) || (hadc2->Init.ScanConvMode == ADC_SCAN_DISABLE)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hmadc->State == BSP_MOTORADC_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hmadc->hadc[0]         = hadc1;
+  hmadc->hadc[1]         = hadc2;
+  hmadc->htim            = htim;
+  hmadc->SamplePoint     = pInit->SamplePoint;
+  hmadc->NbrOfConversion = pInit->NbrOfConversion;
+  hmadc->CounterMode     = htim->Init.CounterMode;
+
+  /* TIM1 and TIM8 run from PCLK2, doubled when APB2 is divided */
+  pclk2 = HAL_RCC_GetPCLK2Freq();
+  hmadc->TimerClock = (pclk2 == HAL_RCC_GetHCLKFreq()) ? pclk2 : (2U * pclk2);
+
+  multimode.Mode = ADC_DUALMODE_INJECSIMULT;
+  if (HAL_ADCEx_MultiModeConfigChannel(hadc1, &multimode) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  if (htim->Instance == TIM8)
+  {
+    __HAL_AFIO_REMAP_ADC1_ETRGINJ_ENABLE();
+  }
+
+  for (adc = 0U; adc < BSP_MOTORADC_ADCS; adc++)
+  {
+    for (rank = 0U; rank < pInit->NbrOfConversion; rank++)
+    {
+      sInjected.InjectedChannel               = pInit->Channels[adc][rank];
+      sInjected.InjectedRank                  = ADC_INJECTED_RANK_1 + rank;
+      sInjected.InjectedSamplingTime          = pInit->SamplingTime;
+      sInjected.InjectedOffset                = 0U;
+      sInjected.InjectedNbrOfConversion       = pInit->NbrOfConversion;
+      sInjected.InjectedDiscontinuousConvMode = DISABLE;
+      sInjected.AutoInjectedConv              = DISABLE;
+      if (adc == 0U)
+      {
+        /* EXTI line 15 is TIM8 CC4 once remapped */
+        sInjected.ExternalTrigInjecConv = (htim->Instance == TIM1) ? ADC_EXTERNALTRIGINJECCONV_T1_CC4 :
+                                                                      ADC_EXTERNALTRIGINJECCONV_EXT_IT15;
+      }
+      else
+      {
+        /* The slave starts with the master */
+        sInjected.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+      }
+      if (HAL_ADCEx_InjectedConfigChannel(hmadc->hadc[adc], &sInjected) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+    }
+    hmadc->Offsets[adc] = 0U;
+  }
+
+  /* CC4 only raises the trigger, its output is not enabled on a pin */
+  sOC.OCMode       = TIM_OCMODE_TIMING;
+  sOC.Pulse        = pInit->SamplePoint;
+  sOC.OCPolarity   = TIM_OCPOLARITY_HIGH;
+  sOC.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+  sOC.OCFastMode   = TIM_OCFAST_DISABLE;
+  sOC.OCIdleState  = TIM_OCIDLESTATE_RESET;
+  sOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if (HAL_TIM_OC_ConfigChannel(htim, &sOC, TIM_CHANNEL_4) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hmadc->CalibCount  = 0U;
+  hmadc->SampleCount = 0U;
+  BSP_MOTORADC_ResetLatency(hmadc);
+  hmadc->State = BSP_MOTORADC_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the injected conversions on each PWM period.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MOTORADC_Start(BSP_MOTORADC_TypeDef *hmadc)
+{
+  if (hmadc->State != BSP_MOTORADC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Slave first, enabled only, then the master armed on its trigger */
+  if (HAL_ADCEx_InjectedStart(hmadc->hadc[1]) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (HAL_ADCEx_InjectedStart_IT(hmadc->hadc[0]) != HAL_OK)
+  {
+    (void)HAL_ADCEx_InjectedStop(hmadc->hadc[1]);
+    return HAL_ERROR;
+  }
+
+  hmadc->State = BSP_MOTORADC_STATE_RUN;
+  TIM_CCxChannelCmd(hmadc->htim->Instance, TIM_CHANNEL_4, TIM_CCx_ENABLE);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the injected conversions.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MOTORADC_Stop(BSP_MOTORADC_TypeDef *hmadc)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (hmadc->State != BSP_MOTORADC_STATE_RUN)
+  {
+    return HAL_ERROR;
+  }
+
+  TIM_CCxChannelCmd(hmadc->htim->Instance, TIM_CHANNEL_4, TIM_CCx_DISABLE);
+  if (HAL_ADCEx_InjectedStop_IT(hmadc->hadc[0]) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+  if (HAL_ADCEx_InjectedStop(hmadc->hadc[1]) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+  hmadc->State = BSP_MOTORADC_STATE_READY;
+
+  return status;
+}
+
+/**
+  * @brief  Move the sampling point in the PWM period.
+  * @note   Takes effect on the next compare, from the control loop as well.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  SamplePoint Compare value of CC4, up to the period of the timer.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MOTORADC_SetSamplePoint(BSP_MOTORADC_TypeDef *hmadc, uint32_t SamplePoint)
+{
+  if (SamplePoint > hmadc->htim->Instance->ARR)
+  {
+    return HAL_ERROR;
+  }
+
+  hmadc->SamplePoint = SamplePoint;
+  __HAL_TIM_SET_COMPARE(hmadc->htim, TIM_CHANNEL_4, SamplePoint);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Measure the zero current offsets on the next samples.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  Samples Samples averaged, 1 to 65536.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_MOTORADC_StartCalibration(BSP_MOTORADC_TypeDef *hmadc, uint32_t Samples)
+{
+  if ((Samples == 0U) || (Samples > 0x10000U))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hmadc->State != BSP_MOTORADC_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hmadc->CalibSums[0] = 0U;
+  hmadc->CalibSums[1] = 0U;
+  hmadc->CalibSamples = Samples;
+  hmadc->CalibCount   = Samples;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check the offset calibration.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval 1 while the calibration runs, 0 otherwise
+  */
+uint32_t BSP_MOTORADC_IsCalibrating(const BSP_MOTORADC_TypeDef *hmadc)
+{
+  return (hmadc->CalibCount != 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Get the last phase currents, in ADC counts from the zero current.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  pIa Rank 1 of ADC1 less its offset.
+  * @param  pIb Rank 1 of ADC2 less its offset.
+  * @retval None
+  */
+void BSP_MOTORADC_GetPhaseCurrents(const BSP_MOTORADC_TypeDef *hmadc, int16_t *pIa, int16_t *pIb)
+{
+  *pIa = (int16_t)((int32_t)hmadc->Values[0][0] - (int32_t)hmadc->Offsets[0]);
+  *pIb = (int16_t)((int32_t)hmadc->Values[1][0] - (int32_t)hmadc->Offsets[1]);
+}
+
+/**
+  * @brief  Get the last result of an injected rank.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  Adc 0 for ADC1, 1 for ADC2.
+  * @param  Rank Injected rank, ADC_INJECTED_RANK_1 to ADC_INJECTED_RANK_4.
+  * @retval Conversion result, 0 for a rank not converted
+  */
+uint16_t BSP_MOTORADC_GetValue(const BSP_MOTORADC_TypeDef *hmadc, uint32_t Adc, uint32_t Rank)
+{
+  if ((Adc >= BSP_MOTORADC_ADCS) || (Rank < ADC_INJECTED_RANK_1) || (Rank > hmadc->NbrOfConversion))
+  {
+    return 0U;
+  }
+
+  return hmadc->Values[Adc][Rank - ADC_INJECTED_RANK_1];
+}
+
+/**
+  * @brief  Get the latency from the trigger to the handler.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @param  pLastNs Latency of the last sample in ns.
+  * @param  pMaxNs Largest latency since the last reset in ns.
+  * @retval None
+  */
+void BSP_MOTORADC_GetLatency(const BSP_MOTORADC_TypeDef *hmadc, uint32_t *pLastNs, uint32_t *pMaxNs)
+{
+  *pLastNs = (uint32_t)(((uint64_t)hmadc->Latency * 1000000000U) / hmadc->TimerClock);
+  *pMaxNs  = (uint32_t)(((uint64_t)hmadc->LatencyMax * 1000000000U) / hmadc->TimerClock);
+}
+
+/**
+  * @brief  Reset the latency maximum.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval None
+  */
+void BSP_MOTORADC_ResetLatency(BSP_MOTORADC_TypeDef *hmadc)
+{
+  hmadc->Latency    = 0U;
+  hmadc->LatencyMax = 0U;
+}
+
+/**
+  * @brief  Handle the end of the injected sequence.
+  * @note   Call from ADC1_2_IRQHandler(), in place of HAL_ADC_IRQHandler().
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval None
+  */
+void BSP_MOTORADC_IRQHandler(BSP_MOTORADC_TypeDef *hmadc)
+{
+  TIM_TypeDef *tim = hmadc->htim->Instance;
+  ADC_TypeDef *adc1 = hmadc->hadc[0]->Instance;
+  ADC_TypeDef *adc2 = hmadc->hadc[1]->Instance;
+  uint32_t counter = tim->CNT;
+  uint32_t down = tim->CR1 & TIM_CR1_DIR;
+  uint32_t point = hmadc->SamplePoint;
+  uint32_t latency;
+  uint32_t rank;
+  const __IO uint32_t *pJdr1;
+  const __IO uint32_t *pJdr2;
+
+  if ((adc1->SR & ADC_SR_JEOC) == 0U)
+  {
+    return;
+  }
+  adc1->SR = ~(uint32_t)(ADC_SR_JEOC | ADC_SR_JSTRT);
+  adc2->SR = ~(uint32_t)(ADC_SR_JEOC | ADC_SR_JSTRT);
+
+  pJdr1 = &adc1->JDR1;
+  pJdr2 = &adc2->JDR1;
+  for (rank = 0U; rank < hmadc->NbrOfConversion; rank++)
+  {
+    hmadc->Values[0][rank] = (uint16_t)pJdr1[rank];
+    hmadc->Values[1][rank] = (uint16_t)pJdr2[rank];
+  }
+
+  /* Ticks since the compare, which only matches in one direction */
+  if (hmadc->CounterMode == TIM_COUNTERMODE_CENTERALIGNED1)
+  {
+    latency = (down != 0U) ? (point - counter) : (point + counter);
+  }
+  else if (hmadc->CounterMode == TIM_COUNTERMODE_CENTERALIGNED2)
+  {
+    latency = (down == 0U) ? (counter - point) : ((tim->ARR - point) + (tim->ARR - counter));
+  }
+  else
+  {
+    latency = (counter >= point) ? (counter - point) : ((counter + tim->ARR + 1U) - point);
+  }
+  hmadc->Latency = latency;
+  if (latency > hmadc->LatencyMax)
+  {
+    hmadc->LatencyMax = latency;
+  }
+  hmadc->SampleCount++;
+
+  if (hmadc->CalibCount != 0U)
+  {
+    hmadc->CalibSums[0] += hmadc->Values[0][0];
+    hmadc->CalibSums[1] += hmadc->Values[1][0];
+    if (hmadc->CalibCount == 1U)
+    {
+      hmadc->Offsets[0] = (uint16_t)(hmadc->CalibSums[0] / hmadc->CalibSamples);
+      hmadc->Offsets[1] = (uint16_t)(hmadc->CalibSums[1] / hmadc->CalibSamples);
+    }
+    hmadc->CalibCount--;
+  }
+
+  BSP_MOTORADC_SampleCallback(hmadc);
+}
+
+/**
+  * @brief  Injected sequence complete callback, runs the control loop.
+  * @param  hmadc Pointer to a BSP_MOTORADC_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_MOTORADC_SampleCallback(BSP_MOTORADC_TypeDef *hmadc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hmadc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_MOTORADC_SampleCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ADC_MODULE_ENABLED && HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,771 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_oled.c
+  * @author  MCU Application Team
+  * @brief   I2C OLED display BSP service.
+  *          This file provides functions to drive a 128x64 SSD1306 or SH1106
+  *          OLED sharing its I2C with the BSP_I2CSCHED sensor jobs:
+  *           + Framebuffer in SRAM with a dirty column range per page
+  *           + Changed columns only sent, in page addressing mode
+  *           + DMA writes of BSP_OLED_CHUNK_SIZE bytes queued between the
+  *             sensor cycles
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize a BSP_I2CSCHED scheduler on the I2C of the display with its
+       hdmatx linked, see py32f4xx_bsp_i2csched.c. The sensor jobs keep their
+       periods, the display writes use the bus between their cycles.
+
+   (#) Call BSP_OLED_Init() with the scheduler, the device address and the
+       controller. The initialization commands are queued at once and the
+       whole framebuffer, cleared, is dirty.
+
+   (#) From BSP_I2CSCHED_WriteCpltCallback() call BSP_OLED_WriteCpltHandler()
+       with the write ended, the writes of other services are skipped.
+
+   (#) Draw with BSP_OLED_Clear(), BSP_OLED_SetPixel(), BSP_OLED_FillRect()
+       and BSP_OLED_DrawBitmap(), or write Frame directly then call
+       BSP_OLED_Invalidate(). A byte written with its previous value is not
+       marked, redrawing a screen mostly unchanged sends little.
+
+   (#) Call BSP_OLED_Flush() when a screen is drawn. For each dirty page, from
+       the one after the last page sent:
+       (+) The dirty range of the page is taken and cleared.
+       (+) A command write sets the page and the first column.
+       (+) Data writes of BSP_OLED_CHUNK_SIZE bytes at most send the columns,
+           the column address of the controller moving on across the sensor
+           cycles in between.
+       (+) BSP_OLED_FlushCpltCallback() is called when no page is left dirty,
+           or with HAL_ERROR when a write failed. The range of the failed page
+           is dirty again for the next BSP_OLED_Flush().
+
+   (#) The DMA reads Frame while a page is sent. Drawing may go on meanwhile: a
+       byte changed under the transfer is dirty again and sent before the end
+       of the flush.
+
+   (#) A full frame is 1 KB: 8 command writes and 32 data writes of 32 bytes,
+       about 27 ms of the bus at 400 kHz spread over the free time of the
+       scheduler instead of one blocking HAL_I2C_Master_Transmit().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_oled.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_OLED BSP OLED
+  * @brief I2C OLED display BSP service
+  * @{
+  */
+
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_OLED_Private_Constants BSP OLED Private Constants
+  * @{
+  */
+#define OLED_CONTROL_COMMAND      0x00U       /*!< Control byte of a command stream              */
+#define OLED_CONTROL_DATA         0x40U       /*!< Control byte of a data stream                 */
+
+#define OLED_CMD_PAGE             0xB0U       /*!< Page address, page in bits 2:0                */
+#define OLED_CMD_COLUMN_LOW       0x00U       /*!< Column address, bits 3:0                      */
+#define OLED_CMD_COLUMN_HIGH      0x10U       /*!< Column address, bits 7:4                      */
+
+#define OLED_SH1106_COLUMN        2U          /*!< First RAM column of the panel of an SH1106    */
+
+#define OLED_STATE_IDLE           0x00000000U /*!< No write queued                               */
+#define OLED_STATE_COMMAND        0x00000001U /*!< Command write queued                          */
+#define OLED_STATE_ADDRESS        0x00000002U /*!< Page and column write queued                  */
+#define OLED_STATE_DATA           0x00000003U /*!< Data write queued                             */
+
+#define OLED_PAGES_MASK           ((1UL << BSP_OLED_PAGES) - 1UL) /*!< Every page dirty          */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_OLED_Private_Variables BSP OLED Private Variables
+  * @{
+  */
+/* Display off, clock, 64 rows, no offset, line 0, charge pump on, page
+   addressing, column 127 at SEG0, COM scan from 63, alternative COM pins,
+   contrast, precharge, VCOMH, display from RAM, not inverted, display on */
+static const uint8_t OLED_InitSSD1306[] =
+{
+  0xAEU, 0xD5U, 0x80U, 0xA8U, 0x3FU, 0xD3U, 0x00U, 0x40U, 0x8DU, 0x14U, 0x20U, 0x02U,
+  0xA1U, 0xC8U, 0xDAU, 0x12U, 0x81U, 0xCFU, 0xD9U, 0xF1U, 0xDBU, 0x40U, 0xA4U, 0xA6U, 0xAFU
+};
+
+/* Display off, clock, 64 rows, no offset, line 0, DC-DC on, column 131 at
+   SEG0, COM scan from 63, alternative COM pins, contrast, precharge, VCOMH,
+   pump at 8 V, display from RAM, not inverted, display on */
+static const uint8_t OLED_InitSH1106[] =
+{
+  0xAEU, 0xD5U, 0x80U, 0xA8U, 0x3FU, 0xD3U, 0x00U, 0x40U, 0xADU, 0x8BU,
+  0xA1U, 0xC8U, 0xDAU, 0x12U, 0x81U, 0x80U, 0xD9U, 0x22U, 0xDBU, 0x35U, 0x32U, 0xA4U, 0xA6U, 0xAFU
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_OLED_Private_Functions
+  * @{
+  */
+static void OLED_Mark(BSP_OLED_TypeDef *holed, uint32_t Page, uint32_t Start, uint32_t End);
+static void OLED_Next(BSP_OLED_TypeDef *holed);
+static void OLED_SendData(BSP_OLED_TypeDef *holed);
+static void OLED_Abort(BSP_OLED_TypeDef *holed);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_OLED_Exported_Functions BSP OLED Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_OLED_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Initialize the display on a scheduler
+      (+) Send configuration commands
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a display and queue its initialization commands.
+  * @note   The framebuffer is cleared and dirty, BSP_OLED_Flush() may be
+  *         called at once.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  hsched Pointer to a BSP_I2CSCHED_TypeDef structure initialized on
+  *                the I2C of the display, its hdmatx linked.
+  * @param  DevAddress Device address, BSP_OLED_ADDRESS for most modules.
+  * @param  Controller A value of @ref BSP_OLED_Controller.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_OLED_Init(BSP_OLED_TypeDef *holed, BSP_I2CSCHED_TypeDef *hsched, uint16_t DevAddress,
+                                uint32_t Controller)
+{
+  uint32_t page;
+
+  if ((holed == NULL) || (hsched == NULL) || (hsched->hi2c == NULL) ||
+      ((Controller != BSP_OLED_SSD1306) && (Controller != BSP_OLED_SH1106)))
+  {
+    return HAL_ERROR;
+  }
+
+  (void)memset(holed->Frame, 0, sizeof(holed->Frame));
+  for (page = 0U; page < BSP_OLED_PAGES; page++)
+  {
+    holed->DirtyStart[page] = 0U;
+    holed->DirtyEnd[page]   = (uint8_t)BSP_OLED_WIDTH;
+  }
+  holed->DirtyMask = OLED_PAGES_MASK;
+
+  holed->Cmd.DevAddress  = DevAddress;
+  holed->Cmd.MemAddress  = OLED_CONTROL_COMMAND;
+  holed->Cmd.MemAddSize  = I2C_MEMADD_SIZE_8BIT;
+  holed->Cmd.Status      = BSP_I2CSCHED_STATUS_NONE;
+  holed->Cmd.pOwner      = holed;
+  holed->Data.DevAddress = DevAddress;
+  holed->Data.MemAddress = OLED_CONTROL_DATA;
+  holed->Data.MemAddSize = I2C_MEMADD_SIZE_8BIT;
+  holed->Data.Status     = BSP_I2CSCHED_STATUS_NONE;
+  holed->Data.pOwner     = holed;
+
+  holed->hsched     = hsched;
+  holed->Controller = Controller;
+  holed->Flushing   = 0U;
+  holed->Page       = BSP_OLED_PAGES - 1U;
+  holed->Column     = 0U;
+  holed->End        = 0U;
+  holed->PageCount  = 0U;
+  holed->ByteCount  = 0U;
+  holed->ErrorCount = 0U;
+
+  if (Controller == BSP_OLED_SH1106)
+  {
+    holed->Cmd.pData = OLED_InitSH1106;
+    holed->Cmd.Size  = (uint16_t)sizeof(OLED_InitSH1106);
+  }
+  else
+  {
+    holed->Cmd.pData = OLED_InitSSD1306;
+    holed->Cmd.Size  = (uint16_t)sizeof(OLED_InitSSD1306);
+  }
+  holed->State = OLED_STATE_COMMAND;
+  if (BSP_I2CSCHED_Write(hsched, &holed->Cmd) != HAL_OK)
+  {
+    holed->State  = OLED_STATE_IDLE;
+    holed->hsched = NULL;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue configuration commands, contrast or display off for instance.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  pCmd Command bytes, copied.
+  * @param  Size Number of bytes, BSP_OLED_COMMAND_SIZE at most.
+  * @retval HAL status, HAL_BUSY while a flush or a command runs
+  */
+HAL_StatusTypeDef BSP_OLED_Command(BSP_OLED_TypeDef *holed, const uint8_t *pCmd, uint32_t Size)
+{
+  uint32_t primask_bit;
+  uint32_t index;
+
+  if ((holed == NULL) || (holed->hsched == NULL) || (pCmd == NULL) || (Size == 0U) ||
+      (Size > BSP_OLED_COMMAND_SIZE))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (holed->State != OLED_STATE_IDLE)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_BUSY;
+  }
+  holed->State = OLED_STATE_COMMAND;
+  __set_PRIMASK(primask_bit);
+
+  for (index = 0U; index < Size; index++)
+  {
+    holed->CmdBuffer[index] = pCmd[index];
+  }
+  holed->Cmd.pData = holed->CmdBuffer;
+  holed->Cmd.Size  = (uint16_t)Size;
+  if (BSP_I2CSCHED_Write(holed->hsched, &holed->Cmd) != HAL_OK)
+  {
+    holed->State = OLED_STATE_IDLE;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_OLED_Exported_Functions_Group2 Drawing functions
+  * @brief    Drawing functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Drawing functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Draw into the framebuffer
+      (+) Mark the columns changed
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Clear the framebuffer.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval None
+  */
+void BSP_OLED_Clear(BSP_OLED_TypeDef *holed)
+{
+  BSP_OLED_FillRect(holed, 0U, 0U, BSP_OLED_WIDTH, BSP_OLED_HEIGHT, 0U);
+}
+
+/**
+  * @brief  Set or clear a pixel, outside of the panel ignored.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  X Column.
+  * @param  Y Row.
+  * @param  On 1 to light the pixel, 0 to clear it.
+  * @retval None
+  */
+void BSP_OLED_SetPixel(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Y, uint32_t On)
+{
+  uint8_t *pByte;
+  uint8_t value;
+
+  if ((X >= BSP_OLED_WIDTH) || (Y >= BSP_OLED_HEIGHT))
+  {
+    return;
+  }
+
+  pByte = &holed->Frame[Y >> 3][X];
+  value = (On != 0U) ? (uint8_t)(*pByte | (1U << (Y & 7U))) : (uint8_t)(*pByte & ~(1U << (Y & 7U)));
+  if (value != *pByte)
+  {
+    *pByte = value;
+    OLED_Mark(holed, Y >> 3, X, X + 1U);
+  }
+}
+
+/**
+  * @brief  Set or clear a rectangle, clipped to the panel.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  X First column.
+  * @param  Y First row.
+  * @param  Width Number of columns.
+  * @param  Height Number of rows.
+  * @param  On 1 to light the pixels, 0 to clear them.
+  * @retval None
+  */
+void BSP_OLED_FillRect(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Y, uint32_t Width, uint32_t Height,
+                       uint32_t On)
+{
+  uint32_t page;
+  uint32_t column;
+  uint32_t end;
+  uint32_t first;
+  uint32_t last;
+  uint32_t rowEnd;
+  uint8_t mask;
+  uint8_t value;
+
+  if ((X >= BSP_OLED_WIDTH) || (Y >= BSP_OLED_HEIGHT) || (Width == 0U) || (Height == 0U))
+  {
+    return;
+  }
+  end    = ((Width > (BSP_OLED_WIDTH - X)) ? BSP_OLED_WIDTH : (X + Width));
+  rowEnd = ((Height > (BSP_OLED_HEIGHT - Y)) ? BSP_OLED_HEIGHT : (Y + Height));
+
+  for (page = Y >> 3; (page << 3) < rowEnd; page++)
+  {
+    /* Rows of the rectangle in this page */
+    mask = 0xFFU;
+    if (Y > (page << 3))
+    {
+      mask = (uint8_t)(mask << (Y & 7U));
+    }
+    if (rowEnd < ((page + 1U) << 3))
+    {
+      mask = (uint8_t)(mask & (0xFFU >> (8U - (rowEnd & 7U))));
+    }
+
+    first = end;
+    last  = X;
+    for (column = X; column < end; column++)
+    {
+      value = (On != 0U) ? (uint8_t)(holed->Frame[page][column] | mask)
+                         : (uint8_t)(holed->Frame[page][column] & (uint8_t)~mask);
+      if (value != holed->Frame[page][column])
+      {
+        holed->Frame[page][column] = value;
+        if (first == end)
+        {
+          first = column;
+        }
+        last = column + 1U;
+      }
+    }
+    if (first != end)
+    {
+      OLED_Mark(holed, page, first, last);
+    }
+  }
+}
+
+/**
+  * @brief  Copy a bitmap of whole pages, a font glyph for instance, clipped to
+  *         the panel.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  X First column.
+  * @param  Page First page.
+  * @param  pBitmap Bitmap, Width bytes for each page, bit n of a byte is row n
+  *                 of the page.
+  * @param  Width Number of columns.
+  * @param  Pages Number of pages.
+  * @retval None
+  */
+void BSP_OLED_DrawBitmap(BSP_OLED_TypeDef *holed, uint32_t X, uint32_t Page, const uint8_t *pBitmap,
+                         uint32_t Width, uint32_t Pages)
+{
+  const uint8_t *pSrc;
+  uint32_t page;
+  uint32_t column;
+  uint32_t end;
+  uint32_t first;
+  uint32_t last;
+
+  if ((pBitmap == NULL) || (X >= BSP_OLED_WIDTH) || (Page >= BSP_OLED_PAGES))
+  {
+    return;
+  }
+  end = ((Width > (BSP_OLED_WIDTH - X)) ? BSP_OLED_WIDTH : (X + Width));
+
+  for (page = 0U; (page < Pages) && ((Page + page) < BSP_OLED_PAGES); page++)
+  {
+    pSrc  = &pBitmap[page * Width];
+    first = end;
+    last  = X;
+    for (column = X; column < end; column++)
+    {
+      if (holed->Frame[Page + page][column] != *pSrc)
+      {
+        holed->Frame[Page + page][column] = *pSrc;
+        if (first == end)
+        {
+          first = column;
+        }
+        last = column + 1U;
+      }
+      pSrc++;
+    }
+    if (first != end)
+    {
+      OLED_Mark(holed, Page + page, first, last);
+    }
+  }
+}
+
+/**
+  * @brief  Mark columns of a page as changed, after a direct Frame write.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  Page Page changed.
+  * @param  X First column changed.
+  * @param  Width Number of columns changed.
+  * @retval None
+  */
+void BSP_OLED_Invalidate(BSP_OLED_TypeDef *holed, uint32_t Page, uint32_t X, uint32_t Width)
+{
+  if ((Page >= BSP_OLED_PAGES) || (X >= BSP_OLED_WIDTH) || (Width == 0U))
+  {
+    return;
+  }
+
+  OLED_Mark(holed, Page, X, (Width > (BSP_OLED_WIDTH - X)) ? BSP_OLED_WIDTH : (X + Width));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_OLED_Exported_Functions_Group3 Flush functions
+  * @brief    Flush functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Flush functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Send the dirty pages through the scheduler
+      (+) Chain the writes from the scheduler callback
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Send the dirty columns of the framebuffer.
+  * @note   A flush running goes on with the columns changed since its start.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_OLED_Flush(BSP_OLED_TypeDef *holed)
+{
+  uint32_t primask_bit;
+  uint32_t start;
+
+  if ((holed == NULL) || (holed->hsched == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  start = (holed->State == OLED_STATE_IDLE) ? 1U : 0U;
+  holed->Flushing = 1U;
+  if (start != 0U)
+  {
+    holed->State = OLED_STATE_ADDRESS;
+  }
+  __set_PRIMASK(primask_bit);
+
+  /* A command running starts the flush when it ends */
+  if (start != 0U)
+  {
+    OLED_Next(holed);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check whether a flush runs.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval 1 until the flush callback, 0 otherwise
+  */
+uint32_t BSP_OLED_IsFlushing(const BSP_OLED_TypeDef *holed)
+{
+  return holed->Flushing;
+}
+
+/**
+  * @brief  Queue the next write of the display after one of its writes.
+  * @note   To be called from BSP_I2CSCHED_WriteCpltCallback(), the writes of
+  *         other services are ignored.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  pWrite Pointer to the BSP_I2CSCHED_WriteTypeDef structure ended.
+  * @retval None
+  */
+void BSP_OLED_WriteCpltHandler(BSP_OLED_TypeDef *holed, BSP_I2CSCHED_WriteTypeDef *pWrite)
+{
+  if ((pWrite->pOwner != holed) || (holed->State == OLED_STATE_IDLE))
+  {
+    return;
+  }
+  if (pWrite->Status != BSP_I2CSCHED_STATUS_OK)
+  {
+    holed->ErrorCount++;
+    OLED_Abort(holed);
+    return;
+  }
+
+  switch (holed->State)
+  {
+    case OLED_STATE_ADDRESS:
+      OLED_SendData(holed);
+      break;
+
+    case OLED_STATE_DATA:
+      holed->Column    += pWrite->Size;
+      holed->ByteCount += pWrite->Size;
+      if (holed->Column < holed->End)
+      {
+        OLED_SendData(holed);
+      }
+      else
+      {
+        holed->PageCount++;
+        OLED_Next(holed);
+      }
+      break;
+
+    default:
+      /* Command sent, the flush requested meanwhile starts */
+      if (holed->Flushing != 0U)
+      {
+        holed->State = OLED_STATE_ADDRESS;
+        OLED_Next(holed);
+      }
+      else
+      {
+        holed->State = OLED_STATE_IDLE;
+      }
+      break;
+  }
+}
+
+/**
+  * @brief  Flush end callback.
+  * @note   Called from the scheduler interrupt, or from BSP_OLED_Flush() when
+  *         no page is dirty.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  Status HAL_OK when every page was sent, HAL_ERROR when a write
+  *                failed.
+  * @retval None
+  */
+__weak void BSP_OLED_FlushCpltCallback(BSP_OLED_TypeDef *holed, HAL_StatusTypeDef Status)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(holed);
+  UNUSED(Status);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_OLED_FlushCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_OLED_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Extend the dirty range of a page.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @param  Page Page changed.
+  * @param  Start First column changed.
+  * @param  End Column after the last one changed.
+  * @retval None
+  */
+static void OLED_Mark(BSP_OLED_TypeDef *holed, uint32_t Page, uint32_t Start, uint32_t End)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (Start < holed->DirtyStart[Page])
+  {
+    holed->DirtyStart[Page] = (uint8_t)Start;
+  }
+  if (End > holed->DirtyEnd[Page])
+  {
+    holed->DirtyEnd[Page] = (uint8_t)End;
+  }
+  holed->DirtyMask |= (1UL << Page);
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Take the next dirty page and queue its address write, or end the
+  *         flush.
+  * @note   The pages are taken round robin, a page redrawn all the time does
+  *         not hold the others back.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval None
+  */
+static void OLED_Next(BSP_OLED_TypeDef *holed)
+{
+  uint32_t primask_bit;
+  uint32_t page;
+  uint32_t column;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (holed->DirtyMask == 0U)
+  {
+    holed->State    = OLED_STATE_IDLE;
+    holed->Flushing = 0U;
+    __set_PRIMASK(primask_bit);
+    BSP_OLED_FlushCpltCallback(holed, HAL_OK);
+    return;
+  }
+
+  page = holed->Page;
+  do
+  {
+    page = (page + 1U) % BSP_OLED_PAGES;
+  } while ((holed->DirtyMask & (1UL << page)) == 0U);
+
+  holed->Page   = page;
+  holed->Column = holed->DirtyStart[page];
+  holed->End    = holed->DirtyEnd[page];
+  holed->DirtyStart[page] = (uint8_t)BSP_OLED_WIDTH;
+  holed->DirtyEnd[page]   = 0U;
+  holed->DirtyMask &= ~(1UL << page);
+  holed->State = OLED_STATE_ADDRESS;
+
+  __set_PRIMASK(primask_bit);
+
+  column = holed->Column + ((holed->Controller == BSP_OLED_SH1106) ? OLED_SH1106_COLUMN : 0U);
+  holed->CmdBuffer[0] = (uint8_t)(OLED_CMD_PAGE | page);
+  holed->CmdBuffer[1] = (uint8_t)(OLED_CMD_COLUMN_LOW | (column & 0x0FU));
+  holed->CmdBuffer[2] = (uint8_t)(OLED_CMD_COLUMN_HIGH | (column >> 4));
+  holed->Cmd.pData = holed->CmdBuffer;
+  holed->Cmd.Size  = 3U;
+  if (BSP_I2CSCHED_Write(holed->hsched, &holed->Cmd) != HAL_OK)
+  {
+    holed->ErrorCount++;
+    OLED_Abort(holed);
+  }
+}
+
+/**
+  * @brief  Queue the data write of the next columns of the page.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval None
+  */
+static void OLED_SendData(BSP_OLED_TypeDef *holed)
+{
+  uint32_t size = holed->End - holed->Column;
+
+  if (size > BSP_OLED_CHUNK_SIZE)
+  {
+    size = BSP_OLED_CHUNK_SIZE;
+  }
+
+  holed->State = OLED_STATE_DATA;
+  holed->Data.pData = &holed->Frame[holed->Page][holed->Column];
+  holed->Data.Size  = (uint16_t)size;
+  if (BSP_I2CSCHED_Write(holed->hsched, &holed->Data) != HAL_OK)
+  {
+    holed->ErrorCount++;
+    OLED_Abort(holed);
+  }
+}
+
+/**
+  * @brief  End the flush in error, the columns not sent dirty again.
+  * @param  holed Pointer to a BSP_OLED_TypeDef structure.
+  * @retval None
+  */
+static void OLED_Abort(BSP_OLED_TypeDef *holed)
+{
+  uint32_t flushing = holed->Flushing;
+
+  if (((holed->State == OLED_STATE_ADDRESS) || (holed->State == OLED_STATE_DATA)) &&
+      (holed->Column < holed->End))
+  {
+    OLED_Mark(holed, holed->Page, holed->Column, holed->End);
+  }
+  holed->State    = OLED_STATE_IDLE;
+  holed->Flushing = 0U;
+
+  if (flushing != 0U)
+  {
+    BSP_OLED_FlushCpltCallback(holed, HAL_ERROR);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
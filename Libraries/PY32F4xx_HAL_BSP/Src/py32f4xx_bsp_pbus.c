@@ -0,0 +1,614 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pbus.c
+  * @author  MCU Application Team
+  * @brief   GPIO parallel bus BSP service.
+  *          This file provides functions to drive an 8080 or 6800 parallel
+  *          bus, LCD controllers and FPGAs, from a GPIO port:
+  *           + Data words moved to ODR or BSRR by DMA, paced by a timer
+  *           + WR or E strobe generated by a PWM channel of the same timer
+  *           + Bulk writes by DMA or blocking, command writes, software reads
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Writing a pixel stream pin by pin costs tens of cycles per word. This
+       service lets a timer pace the bus: at counter 1 a compare DMA request
+       writes the next word to the data port, at the end of the period the
+       strobe channel pulses WR low (8080) or E high (6800) for StrobeCycles
+       cycles, the word latched on the edge at the update. The CPU only
+       runs one interrupt per BSP_PBUS_CHUNK words.
+
+   (#) Use TIM1 or TIM8: the timer runs in the one pulse mode, its
+       repetition counter giving the strobes of a run, so the transfer ends
+       exactly on the last word. The service restarts the timer for the
+       next chunk from BSP_PBUS_IRQHandler().
+
+   (#) Prepare the peripherals:
+       (+) HAL_TIM_PWM_Init() with Init.Period the cycles per word less one,
+       (+) a DMA channel in the memory to peripheral direction, memory
+           increment, halfword for BSP_PBUS_FORMAT_ODR or word for
+           BSP_PBUS_FORMAT_BSRR, linked with __HAL_LINKDMA() to
+           hdma[TIM_DMA_ID_CCx] of the DmaChannel,
+       (+) the data pins and DC, CS, RD or R/W as push pull outputs, the
+           strobe pin in the alternate function of the timer,
+       (+) the update interrupt of the timer, its handler calling
+           BSP_PBUS_IRQHandler().
+       Then call BSP_PBUS_Init().
+
+   (#) BSP_PBUS_FORMAT_ODR writes whole uint16_t port images, the fastest
+       when the data port carries no other output. BSP_PBUS_FORMAT_BSRR
+       writes uint32_t BSRR words touching the data pins only, built from
+       the values by BSP_PBUS_Pack().
+
+   (#) BSP_PBUS_WriteCommand() writes one word with DC low.
+       BSP_PBUS_Write() writes a buffer with DC high and waits,
+       BSP_PBUS_Write_DMA() returns at once and calls
+       BSP_PBUS_TxCpltCallback() at the end. CS, when given, is held low
+       during each transfer.
+
+   (#) BSP_PBUS_Read() reads words by software, the data pins turned to
+       inputs and RD or E pulsed by GPIO for BSP_PBUS_READ_DELAY loops.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_pbus.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PBUS BSP PBUS
+  * @brief GPIO parallel bus BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PBUS_Private_Constants BSP PBUS Private Constants
+  * @{
+  */
+#define PBUS_DMA_PULSE                  1U             /*!< Counter value of the data DMA request     */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_PBUS_Private_Macros BSP PBUS Private Macros
+  * @{
+  */
+#define PBUS_HDMA(__HBUS__)      ((__HBUS__)->htim->hdma[TIM_DMA_ID_CC1 + ((__HBUS__)->Init.DmaChannel >> 2U)])
+#define PBUS_DMA_REQUEST(__HBUS__)    ((uint32_t)TIM_DMA_CC1 << ((__HBUS__)->Init.DmaChannel >> 2U))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PBUS_Private_Functions BSP PBUS Private Functions
+  * @{
+  */
+static uint32_t          PBUS_Encode(const BSP_PBUS_TypeDef *hbus, uint32_t Value);
+static HAL_StatusTypeDef PBUS_Start(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count);
+static uint32_t          PBUS_Next(BSP_PBUS_TypeDef *hbus);
+static void              PBUS_Stop(BSP_PBUS_TypeDef *hbus);
+static HAL_StatusTypeDef PBUS_WaitEnd(BSP_PBUS_TypeDef *hbus, uint32_t Timeout);
+static void              PBUS_Delay(void);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PBUS_Exported_Functions BSP PBUS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the parallel bus on a timer and a GPIO port.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  htim TIM handle, TIM1 or TIM8, initialized with HAL_TIM_PWM_Init().
+  * @param  pInit Configuration, see @ref BSP_PBUS_InitTypeDef.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PBUS_Init(BSP_PBUS_TypeDef *hbus, TIM_HandleTypeDef *htim, const BSP_PBUS_InitTypeDef *pInit)
+{
+  TIM_OC_InitTypeDef sConfig;
+  uint32_t data;
+
+  if ((hbus == NULL) || (htim == NULL) || (pInit == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (!IS_TIM_REPETITION_COUNTER_INSTANCE(htim->Instance) || (pInit->Mode > BSP_PBUS_MODE_6800) ||
+      (pInit->Format > BSP_PBUS_FORMAT_BSRR) || (pInit->DataPort == NULL) || (pInit->DcPort == NULL) ||
+      (pInit->StrobePort == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if ((pInit->StrobeChannel > TIM_CHANNEL_4) || ((pInit->StrobeChannel & 0x3U) != 0U) ||
+      (pInit->DmaChannel > TIM_CHANNEL_4) || ((pInit->DmaChannel & 0x3U) != 0U) ||
+      (pInit->StrobeChannel == pInit->DmaChannel) ||
+      (pInit->StrobeCycles == 0U) || (pInit->StrobeCycles >= htim->Init.Period))
+  {
+    return HAL_ERROR;
+  }
+  /* Data pins contiguous */
+  if ((pInit->DataMask == 0U) || ((pInit->DataMask & ~GPIO_PIN_MASK) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  data = pInit->DataMask >> __CLZ(__RBIT(pInit->DataMask));
+  if ((data & (data + 1U)) != 0U)
+  {
+    return HAL_ERROR;
+  }
+  if (htim->hdma[TIM_DMA_ID_CC1 + (pInit->DmaChannel >> 2U)] == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  hbus->htim  = htim;
+  hbus->Init  = *pInit;
+  hbus->Shift = __CLZ(__RBIT(pInit->DataMask));
+  hbus->Count = 0U;
+  hbus->Sent  = 0U;
+  hbus->Chunk = 0U;
+  hbus->Word  = 0U;
+
+  /* Strobe at the end of the period: PWM1 high then low for WR, PWM2 low then high for E */
+  sConfig.OCMode       = (pInit->Mode == BSP_PBUS_MODE_8080) ? TIM_OCMODE_PWM1 : TIM_OCMODE_PWM2;
+  sConfig.Pulse        = htim->Init.Period + 1U - pInit->StrobeCycles;
+  sConfig.OCPolarity   = TIM_OCPOLARITY_HIGH;
+  sConfig.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+  sConfig.OCFastMode   = TIM_OCFAST_DISABLE;
+  sConfig.OCIdleState  = TIM_OCIDLESTATE_RESET;
+  sConfig.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if (HAL_TIM_PWM_ConfigChannel(htim, &sConfig, pInit->StrobeChannel) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Data DMA request at the start of the period */
+  sConfig.OCMode = TIM_OCMODE_TIMING;
+  sConfig.Pulse  = PBUS_DMA_PULSE;
+  if (HAL_TIM_OC_ConfigChannel(htim, &sConfig, pInit->DmaChannel) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* One run per chunk, the update flag set by the counter only */
+  __HAL_TIM_DISABLE(htim);
+  SET_BIT(htim->Instance->CR1, TIM_CR1_OPM | TIM_CR1_URS);
+  htim->Instance->CNT = 0U;
+  htim->Instance->EGR = TIM_EGR_UG;
+  TIM_CCxChannelCmd(htim->Instance, pInit->StrobeChannel, TIM_CCx_ENABLE);
+  if (IS_TIM_BREAK_INSTANCE(htim->Instance))
+  {
+    __HAL_TIM_MOE_ENABLE(htim);
+  }
+
+  /* Idle levels: DC data, CS released, RD high or R/W write */
+  HAL_GPIO_WritePin(pInit->DcPort, (uint16_t)pInit->DcPin, GPIO_PIN_SET);
+  if (pInit->CsPort != NULL)
+  {
+    HAL_GPIO_WritePin(pInit->CsPort, (uint16_t)pInit->CsPin, GPIO_PIN_SET);
+  }
+  if (pInit->RdPort != NULL)
+  {
+    HAL_GPIO_WritePin(pInit->RdPort, (uint16_t)pInit->RdPin,
+                      (pInit->Mode == BSP_PBUS_MODE_8080) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  }
+
+  hbus->State = BSP_PBUS_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Build BSRR words from values, for BSP_PBUS_FORMAT_BSRR.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  pValues Values, data bit 0 first.
+  * @param  pWords BSRR words built, not overlapping pValues.
+  * @param  Count Number of values.
+  * @retval None
+  */
+void BSP_PBUS_Pack(const BSP_PBUS_TypeDef *hbus, const uint16_t *pValues, uint32_t *pWords,
+                   uint32_t Count)
+{
+  uint32_t index;
+
+  for (index = 0U; index < Count; index++)
+  {
+    pWords[index] = PBUS_Encode(hbus, pValues[index]);
+  }
+}
+
+/**
+  * @brief  Write a command word, DC low.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  Command Command value, data bit 0 first.
+  * @param  Timeout Timeout duration in ms.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PBUS_WriteCommand(BSP_PBUS_TypeDef *hbus, uint32_t Command, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status;
+
+  if (hbus->State != BSP_PBUS_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hbus->Word = PBUS_Encode(hbus, Command);
+  hbus->Init.DcPort->BRR = hbus->Init.DcPin;
+  status = PBUS_Start(hbus, &hbus->Word, 1U);
+  if (status == HAL_OK)
+  {
+    status = PBUS_WaitEnd(hbus, Timeout);
+  }
+  hbus->Init.DcPort->BSRR = hbus->Init.DcPin;
+
+  return status;
+}
+
+/**
+  * @brief  Write data words, DC high, and wait for the end.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  pData uint16_t port images or uint32_t BSRR words, after @ref BSP_PBUS_Format.
+  * @param  Count Number of words, 1 to BSP_PBUS_COUNT_MAX.
+  * @param  Timeout Timeout duration in ms.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PBUS_Write(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status;
+
+  if (hbus->State != BSP_PBUS_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  status = PBUS_Start(hbus, pData, Count);
+  if (status == HAL_OK)
+  {
+    status = PBUS_WaitEnd(hbus, Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Start writing data words, DC high, BSP_PBUS_TxCpltCallback() at the end.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  pData uint16_t port images or uint32_t BSRR words, after @ref BSP_PBUS_Format,
+  *         kept until the end.
+  * @param  Count Number of words, 1 to BSP_PBUS_COUNT_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PBUS_Write_DMA(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count)
+{
+  if (hbus->State != BSP_PBUS_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_TIM_ENABLE_IT(hbus->htim, TIM_IT_UPDATE);
+
+  return PBUS_Start(hbus, pData, Count);
+}
+
+/**
+  * @brief  Read data words by software, DC left high.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  pData Values read, data bit 0 first.
+  * @param  Count Number of words.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PBUS_Read(BSP_PBUS_TypeDef *hbus, uint16_t *pData, uint32_t Count)
+{
+  const BSP_PBUS_InitTypeDef *pinit = &hbus->Init;
+  uint32_t index;
+
+  if ((pData == NULL) || (Count == 0U) || (pinit->RdPort == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (hbus->State != BSP_PBUS_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hbus->State = BSP_PBUS_STATE_BUSY;
+  if (pinit->CsPort != NULL)
+  {
+    pinit->CsPort->BRR = pinit->CsPin;
+  }
+  HAL_GPIOEx_SetPortMode(pinit->DataPort, pinit->DataMask, GPIO_MODE_INPUT);
+
+  if (pinit->Mode == BSP_PBUS_MODE_8080)
+  {
+    for (index = 0U; index < Count; index++)
+    {
+      pinit->RdPort->BRR = pinit->RdPin;
+      PBUS_Delay();
+      pData[index] = (uint16_t)((pinit->DataPort->IDR & pinit->DataMask) >> hbus->Shift);
+      pinit->RdPort->BSRR = pinit->RdPin;
+      PBUS_Delay();
+    }
+  }
+  else
+  {
+    /* R/W high, E taken from the timer while reading */
+    pinit->RdPort->BSRR = pinit->RdPin;
+    pinit->StrobePort->BRR = pinit->StrobePin;
+    HAL_GPIOEx_SetPortMode(pinit->StrobePort, pinit->StrobePin, GPIO_MODE_OUTPUT_PP);
+    for (index = 0U; index < Count; index++)
+    {
+      pinit->StrobePort->BSRR = pinit->StrobePin;
+      PBUS_Delay();
+      pData[index] = (uint16_t)((pinit->DataPort->IDR & pinit->DataMask) >> hbus->Shift);
+      pinit->StrobePort->BRR = pinit->StrobePin;
+      PBUS_Delay();
+    }
+    HAL_GPIOEx_SetPortMode(pinit->StrobePort, pinit->StrobePin, GPIO_MODE_AF_PP);
+    pinit->RdPort->BRR = pinit->RdPin;
+  }
+
+  HAL_GPIOEx_SetPortMode(pinit->DataPort, pinit->DataMask, GPIO_MODE_OUTPUT_PP);
+  if (pinit->CsPort != NULL)
+  {
+    pinit->CsPort->BSRR = pinit->CsPin;
+  }
+  hbus->State = BSP_PBUS_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the parallel bus state.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @retval A value of @ref BSP_PBUS_State
+  */
+uint32_t BSP_PBUS_GetState(const BSP_PBUS_TypeDef *hbus)
+{
+  return hbus->State;
+}
+
+/**
+  * @brief  Handle the end of a run of the timer, called from its update interrupt.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @retval None
+  */
+void BSP_PBUS_IRQHandler(BSP_PBUS_TypeDef *hbus)
+{
+  TIM_HandleTypeDef *htim = hbus->htim;
+
+  if ((__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) == RESET) ||
+      (__HAL_TIM_GET_IT_SOURCE(htim, TIM_IT_UPDATE) == RESET))
+  {
+    return;
+  }
+  __HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+
+  if (PBUS_Next(hbus) != 0U)
+  {
+    BSP_PBUS_TxCpltCallback(hbus);
+  }
+}
+
+/**
+  * @brief  Write complete callback of BSP_PBUS_Write_DMA().
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_PBUS_TxCpltCallback(BSP_PBUS_TypeDef *hbus)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hbus);
+
+  /* NOTE: This function should not be modified, when the callback is needed,
+            the BSP_PBUS_TxCpltCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PBUS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Build the word of a value in the format of the bus.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  Value Value, data bit 0 first.
+  * @retval Port image or BSRR word
+  */
+static uint32_t PBUS_Encode(const BSP_PBUS_TypeDef *hbus, uint32_t Value)
+{
+  uint32_t set = (Value << hbus->Shift) & hbus->Init.DataMask;
+
+  if (hbus->Init.Format == BSP_PBUS_FORMAT_ODR)
+  {
+    return set;
+  }
+
+  return ((hbus->Init.DataMask & ~set) << 16U) | set;
+}
+
+/**
+  * @brief  Start a transfer: first chunk loaded, DMA armed, timer running.
+  * @note   The repetition counter is preloaded: at the update ending a run
+  *         it takes the length of the next one, written when the run started.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  pData Words moved by the DMA.
+  * @param  Count Number of words.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PBUS_Start(BSP_PBUS_TypeDef *hbus, const void *pData, uint32_t Count)
+{
+  TIM_TypeDef *TIMx = hbus->htim->Instance;
+  GPIO_TypeDef *port = hbus->Init.DataPort;
+  uint32_t dst;
+
+  if ((pData == NULL) || (Count == 0U) || (Count > BSP_PBUS_COUNT_MAX))
+  {
+    __HAL_TIM_DISABLE_IT(hbus->htim, TIM_IT_UPDATE);
+    return HAL_ERROR;
+  }
+
+  dst = (hbus->Init.Format == BSP_PBUS_FORMAT_ODR) ? (uint32_t)&port->ODR : (uint32_t)&port->BSRR;
+  if (HAL_DMA_Start(PBUS_HDMA(hbus), (uint32_t)pData, dst, Count) != HAL_OK)
+  {
+    __HAL_TIM_DISABLE_IT(hbus->htim, TIM_IT_UPDATE);
+    return HAL_ERROR;
+  }
+
+  hbus->State = BSP_PBUS_STATE_BUSY;
+  hbus->Count = Count;
+  hbus->Sent  = 0U;
+  hbus->Chunk = (Count < BSP_PBUS_CHUNK) ? Count : BSP_PBUS_CHUNK;
+
+  TIMx->RCR = hbus->Chunk - 1U;
+  TIMx->CNT = 0U;
+  TIMx->EGR = TIM_EGR_UG;
+  if (Count > hbus->Chunk)
+  {
+    TIMx->RCR = (((Count - hbus->Chunk) < BSP_PBUS_CHUNK) ? (Count - hbus->Chunk) : BSP_PBUS_CHUNK) - 1U;
+  }
+  TIMx->SR = ~(TIM_SR_UIF | (TIM_SR_CC1IF << (hbus->Init.DmaChannel >> 2U)));
+
+  if (hbus->Init.CsPort != NULL)
+  {
+    hbus->Init.CsPort->BRR = hbus->Init.CsPin;
+  }
+  SET_BIT(TIMx->DIER, PBUS_DMA_REQUEST(hbus));
+  SET_BIT(TIMx->CR1, TIM_CR1_CEN);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Account the run ended, start the next one or end the transfer.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @retval 1 at the end of the transfer, 0 otherwise
+  */
+static uint32_t PBUS_Next(BSP_PBUS_TypeDef *hbus)
+{
+  TIM_TypeDef *TIMx = hbus->htim->Instance;
+  uint32_t remaining;
+
+  hbus->Sent += hbus->Chunk;
+  remaining = hbus->Count - hbus->Sent;
+  if (remaining == 0U)
+  {
+    PBUS_Stop(hbus);
+    return 1U;
+  }
+
+  /* The repetition counter took this chunk at the update, preload the next one */
+  hbus->Chunk = (remaining < BSP_PBUS_CHUNK) ? remaining : BSP_PBUS_CHUNK;
+  SET_BIT(TIMx->CR1, TIM_CR1_CEN);
+  remaining -= hbus->Chunk;
+  if (remaining != 0U)
+  {
+    TIMx->RCR = ((remaining < BSP_PBUS_CHUNK) ? remaining : BSP_PBUS_CHUNK) - 1U;
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  End a transfer: timer stopped, DMA released, CS high.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @retval None
+  */
+static void PBUS_Stop(BSP_PBUS_TypeDef *hbus)
+{
+  TIM_TypeDef *TIMx = hbus->htim->Instance;
+
+  CLEAR_BIT(TIMx->CR1, TIM_CR1_CEN);
+  CLEAR_BIT(TIMx->DIER, TIM_DIER_UIE | PBUS_DMA_REQUEST(hbus));
+  (void)HAL_DMA_Abort(PBUS_HDMA(hbus));
+  if (hbus->Init.CsPort != NULL)
+  {
+    hbus->Init.CsPort->BSRR = hbus->Init.CsPin;
+  }
+  hbus->State = BSP_PBUS_STATE_READY;
+}
+
+/**
+  * @brief  Run a transfer to its end by polling the update flag.
+  * @param  hbus Pointer to a BSP_PBUS_TypeDef structure.
+  * @param  Timeout Timeout duration in ms.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PBUS_WaitEnd(BSP_PBUS_TypeDef *hbus, uint32_t Timeout)
+{
+  TIM_HandleTypeDef *htim = hbus->htim;
+  uint32_t tickstart = HAL_GetTick();
+
+  do
+  {
+    while (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) == RESET)
+    {
+      if ((Timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) > Timeout))
+      {
+        PBUS_Stop(hbus);
+        return HAL_TIMEOUT;
+      }
+    }
+    __HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+  } while (PBUS_Next(hbus) == 0U);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Wait BSP_PBUS_READ_DELAY loops around a read strobe edge.
+  * @retval None
+  */
+static void PBUS_Delay(void)
+{
+  __IO uint32_t delay;
+
+  for (delay = BSP_PBUS_READ_DELAY; delay > 0U; delay--)
+  {
+    __NOP();
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,512 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pipe.c
+  * @author  MCU Application Team
+  * @brief   Block pipeline BSP service.
+  *          This file chains the stages of a data acquisition, ADC to DSP to
+  *          SD card or flash log for example, on blocks of a shared pool:
+  *           + Blocks handed from stage to stage by pointer, never copied
+  *           + Backpressure from a busy sink up to the source
+  *           + Overload policy at the source, refuse, drop or decimate
+  *           + Throughput and latency statistics of each stage
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) BSP_PIPE_Init() takes a buffer of BSP_PIPE_BUFFER_SIZE(DataSize,
+       Count) bytes aligned on BSP_MEMPOOL_ALIGN: the Count blocks of the
+       pipeline, a BSP_PIPE_BlockTypeDef header then DataSize bytes, all the
+       RAM the data ever takes. BSP_PIPE_AddStage() appends the stages in
+       order, each with a queue of Depth block pointers, a power of 2.
+
+   (#) The source, the transfer complete callback of an ADC DMA for example,
+       fills the data of a block of BSP_PIPE_Alloc(), BSP_PIPE_DATA(), sets
+       its Length and gives it to BSP_PIPE_Push(). Pushes come from a single
+       context. BSP_PIPE_Alloc() returns NULL when all the blocks are in the
+       pipeline, counted in Pool.Failures.
+
+   (#) BSP_PIPE_Process(), from the main loop or a task, gives each stage
+       one block of its queue, the last stage first so that room is made
+       downstream before upstream forwards. The Process function of the
+       stage works on the data in place, or swaps *ppBlock for another block
+       of the pool, and returns:
+       (++) BSP_PIPE_FORWARD, the block goes to the next stage, back to the
+            pool after the last stage
+       (++) BSP_PIPE_DONE, the block goes back to the pool, an averaging
+            stage having kept the result for example
+       (++) BSP_PIPE_KEEP, the stage owns the block: a sink giving the data
+            to BSP_SDSTREAM_Write() returns it and calls BSP_PIPE_Free() on
+            BSP_PIPE_BLOCK(pData) in BSP_SDSTREAM_TxCpltCallback()
+       (++) BSP_PIPE_BUSY, the stage is not ready, the same block is given
+            again on the next call, BSP_SDSTREAM_Write() returning HAL_BUSY
+            for example
+       [..]
+       A stage giving more or fewer blocks than it takes, a compressor
+       filling its own blocks for example, sends them with BSP_PIPE_Emit()
+       and returns BSP_PIPE_BUSY while it returns HAL_BUSY.
+
+   (#) A stage busy, or its next stage full, stops taking blocks: its queue
+       fills, then the queues upstream, up to the first stage. Blocks are
+       never lost between stages; the overload is handled at the source only,
+       by the policy given to BSP_PIPE_Init():
+       (++) BSP_PIPE_POLICY_BLOCK, BSP_PIPE_Push() returns HAL_BUSY and the
+            source keeps the block, counted in Refused
+       (++) BSP_PIPE_POLICY_DROP, the block is freed, counted in Dropped
+       (++) BSP_PIPE_POLICY_DECIMATE, past half the queue of the first stage
+            1 block of Decimation is kept and the others freed, counted in
+            Decimated; the Step of the block kept tells the blocks it stands
+            for. Full, the block is dropped.
+
+   (#) Each stage counts its blocks, bytes and cycles, and the latency from
+       the allocation of the block to the end of the stage, in DWT cycles.
+       BSP_PIPE_Print() prints them with printf(), throughput being the
+       bytes over the time between two BSP_PIPE_ResetStats().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "py32f4xx_bsp_pipe.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PIPE BSP PIPE
+  * @brief Block pipeline BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PIPE_Private_Functions BSP PIPE Private Functions
+  * @{
+  */
+static void PIPE_Account(BSP_PIPE_StageTypeDef *hstage, uint32_t Timestamp, uint32_t Length, uint32_t Cycles);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PIPE_Exported_Functions BSP PIPE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a pipeline, without stages.
+  * @param  hpipe Pipeline.
+  * @param  pBuffer BSP_PIPE_BUFFER_SIZE(DataSize, Count) bytes, aligned on BSP_MEMPOOL_ALIGN.
+  * @param  DataSize Bytes of data of a block, up to 65535.
+  * @param  Count Blocks.
+  * @param  Policy @ref BSP_PIPE_Policy
+  * @param  Decimation Blocks for 1 kept with BSP_PIPE_POLICY_DECIMATE, 2 to 255.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PIPE_Init(BSP_PIPE_TypeDef *hpipe, void *pBuffer, uint32_t DataSize, uint32_t Count,
+                                uint32_t Policy, uint32_t Decimation)
+{
+  if ((hpipe == NULL) || (DataSize == 0U) || (DataSize > 0xFFFFU) || (Policy > BSP_PIPE_POLICY_DECIMATE) ||
+      ((Policy == BSP_PIPE_POLICY_DECIMATE) && ((Decimation < 2U) || (Decimation > 0xFFU))))
+  {
+    return HAL_ERROR;
+  }
+
+  if (BSP_MEMPOOL_Init(&hpipe->Pool, pBuffer, sizeof(BSP_PIPE_BlockTypeDef) + DataSize, Count) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hpipe->DataSize   = DataSize;
+  hpipe->Policy     = Policy;
+  hpipe->Decimation = Decimation;
+  hpipe->pFirst     = NULL;
+  hpipe->pLast      = NULL;
+  hpipe->Sequence   = 0U;
+  hpipe->Skipped    = 0U;
+  hpipe->Accepted   = 0U;
+  hpipe->Refused    = 0U;
+  hpipe->Dropped    = 0U;
+  hpipe->Decimated  = 0U;
+
+  /* The latencies are taken on the cycle counter */
+  HAL_EnableCycleCounter();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Append a stage to a pipeline, before BSP_PIPE_Push() and BSP_PIPE_Process() are used.
+  * @param  hpipe Pipeline.
+  * @param  hstage Stage, kept by the pipeline.
+  * @param  pName Name, NULL for none.
+  * @param  Process Processing of a block, returns a @ref BSP_PIPE_Result.
+  * @param  pArg Context of the stage, hstage->pArg.
+  * @param  pQueue Depth block pointers.
+  * @param  Depth Blocks waiting at most, a power of 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PIPE_AddStage(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_StageTypeDef *hstage, const char *pName,
+                                    uint32_t (*Process)(BSP_PIPE_StageTypeDef *, BSP_PIPE_BlockTypeDef **),
+                                    void *pArg, BSP_PIPE_BlockTypeDef **pQueue, uint32_t Depth)
+{
+  if ((hpipe == NULL) || (hstage == NULL) || (Process == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if (BSP_SYNC_RingInit(&hstage->Input, pQueue, sizeof(BSP_PIPE_BlockTypeDef *), Depth) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hstage->pName   = pName;
+  hstage->Process = Process;
+  hstage->pArg    = pArg;
+  hstage->pRetry  = NULL;
+  hstage->pHeld   = NULL;
+  hstage->pPrev   = hpipe->pLast;
+  hstage->pNext   = NULL;
+  memset((void *)&hstage->Stats, 0, sizeof(hstage->Stats));
+
+  if (hpipe->pLast == NULL)
+  {
+    hpipe->pFirst = hstage;
+  }
+  else
+  {
+    hpipe->pLast->pNext = hstage;
+  }
+  hpipe->pLast = hstage;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Allocate a block for the source, from the context of BSP_PIPE_Push().
+  * @param  hpipe Pipeline.
+  * @retval Block, Length 0 and Step 1, NULL when all the blocks are in use
+  */
+BSP_PIPE_BlockTypeDef *BSP_PIPE_Alloc(BSP_PIPE_TypeDef *hpipe)
+{
+  BSP_PIPE_BlockTypeDef *block = (BSP_PIPE_BlockTypeDef *)BSP_MEMPOOL_Alloc(&hpipe->Pool);
+
+  if (block != NULL)
+  {
+    block->Sequence  = hpipe->Sequence++;
+    block->Timestamp = DWT->CYCCNT;
+    block->Length    = 0U;
+    block->Channel   = 0U;
+    block->Step      = 1U;
+    block->Arg       = 0U;
+  }
+
+  return block;
+}
+
+/**
+  * @brief  Give a block back to the pool, from any context.
+  * @param  hpipe Pipeline.
+  * @param  pBlock Block.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PIPE_Free(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_BlockTypeDef *pBlock)
+{
+  return BSP_MEMPOOL_Free(&hpipe->Pool, pBlock);
+}
+
+/**
+  * @brief  Push a block into the first stage, applying the overload policy.
+  * @param  hpipe Pipeline.
+  * @param  pBlock Block of BSP_PIPE_Alloc().
+  * @retval HAL_OK queued, HAL_BUSY refused and still owned by the caller,
+  *         HAL_ERROR dropped or decimated, freed
+  */
+HAL_StatusTypeDef BSP_PIPE_Push(BSP_PIPE_TypeDef *hpipe, BSP_PIPE_BlockTypeDef *pBlock)
+{
+  BSP_PIPE_StageTypeDef *first = hpipe->pFirst;
+  uint32_t level;
+
+  if (first == NULL)
+  {
+    (void)BSP_MEMPOOL_Free(&hpipe->Pool, pBlock);
+    hpipe->Dropped++;
+    return HAL_ERROR;
+  }
+
+  level = BSP_SYNC_RingCount(&first->Input);
+
+  if ((hpipe->Policy == BSP_PIPE_POLICY_DECIMATE) && ((level * 2U) > first->Input.Mask))
+  {
+    if ((hpipe->Skipped + 1U) < hpipe->Decimation)
+    {
+      (void)BSP_MEMPOOL_Free(&hpipe->Pool, pBlock);
+      hpipe->Skipped++;
+      hpipe->Decimated++;
+      return HAL_ERROR;
+    }
+  }
+
+  pBlock->Step = (uint8_t)(hpipe->Skipped + 1U);
+
+  if (BSP_SYNC_RingPut(&first->Input, &pBlock) != HAL_OK)
+  {
+    if (hpipe->Policy == BSP_PIPE_POLICY_BLOCK)
+    {
+      hpipe->Refused++;
+      return HAL_BUSY;
+    }
+
+    (void)BSP_MEMPOOL_Free(&hpipe->Pool, pBlock);
+    hpipe->Dropped++;
+    return HAL_ERROR;
+  }
+
+  hpipe->Skipped = 0U;
+  hpipe->Accepted++;
+  if ((level + 1U) > first->Stats.QueuePeak)
+  {
+    first->Stats.QueuePeak = level + 1U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give each stage one block of its queue, the last stage first, from one context.
+  * @param  hpipe Pipeline.
+  * @retval Blocks processed, 0 when the pipeline is idle or stalled
+  */
+uint32_t BSP_PIPE_Process(BSP_PIPE_TypeDef *hpipe)
+{
+  BSP_PIPE_StageTypeDef *stage;
+  BSP_PIPE_StageTypeDef *next;
+  BSP_PIPE_BlockTypeDef *block;
+  uint32_t processed = 0U;
+  uint32_t result;
+  uint32_t timestamp;
+  uint32_t length;
+  uint32_t cycles;
+  uint32_t level;
+
+  for (stage = hpipe->pLast; stage != NULL; stage = stage->pPrev)
+  {
+    next = stage->pNext;
+
+    /* A block done waits for room downstream before the stage takes another */
+    if (stage->pHeld != NULL)
+    {
+      if (BSP_SYNC_RingPut(&next->Input, &stage->pHeld) != HAL_OK)
+      {
+        stage->Stats.Stalls++;
+        continue;
+      }
+      stage->pHeld = NULL;
+    }
+
+    if (stage->pRetry != NULL)
+    {
+      block = stage->pRetry;
+      stage->pRetry = NULL;
+    }
+    else if (BSP_SYNC_RingGet(&stage->Input, &block) != HAL_OK)
+    {
+      continue;
+    }
+
+    /* A block kept may be freed by a handler before the stage returns */
+    timestamp = block->Timestamp;
+    length    = block->Length;
+
+    cycles = DWT->CYCCNT;
+    result = stage->Process(stage, &block);
+    cycles = DWT->CYCCNT - cycles;
+
+    switch (result)
+    {
+      case BSP_PIPE_FORWARD:
+        PIPE_Account(stage, block->Timestamp, block->Length, cycles);
+        if (next == NULL)
+        {
+          (void)BSP_MEMPOOL_Free(&hpipe->Pool, block);
+        }
+        else if (BSP_SYNC_RingPut(&next->Input, &block) != HAL_OK)
+        {
+          stage->pHeld = block;
+        }
+        else
+        {
+          level = BSP_SYNC_RingCount(&next->Input);
+          if (level > next->Stats.QueuePeak)
+          {
+            next->Stats.QueuePeak = level;
+          }
+        }
+        processed++;
+        break;
+
+      case BSP_PIPE_DONE:
+        PIPE_Account(stage, block->Timestamp, block->Length, cycles);
+        (void)BSP_MEMPOOL_Free(&hpipe->Pool, block);
+        processed++;
+        break;
+
+      case BSP_PIPE_KEEP:
+        PIPE_Account(stage, timestamp, length, cycles);
+        processed++;
+        break;
+
+      default:
+        stage->pRetry = block;
+        stage->Stats.Stalls++;
+        break;
+    }
+  }
+
+  return processed;
+}
+
+/**
+  * @brief  Send a block to the next stage from the Process function of a stage, a block
+  *         of its own, so that a stage gives more or fewer blocks than it takes.
+  * @param  hstage Stage calling, not the last one.
+  * @param  pBlock Block, owned by the next stage once queued.
+  * @retval HAL_OK, HAL_BUSY when the next stage is full, HAL_ERROR for the last stage
+  */
+HAL_StatusTypeDef BSP_PIPE_Emit(BSP_PIPE_StageTypeDef *hstage, BSP_PIPE_BlockTypeDef *pBlock)
+{
+  BSP_PIPE_StageTypeDef *next = hstage->pNext;
+  uint32_t level;
+
+  if (next == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  if (BSP_SYNC_RingPut(&next->Input, &pBlock) != HAL_OK)
+  {
+    hstage->Stats.Stalls++;
+    return HAL_BUSY;
+  }
+
+  level = BSP_SYNC_RingCount(&next->Input);
+  if (level > next->Stats.QueuePeak)
+  {
+    next->Stats.QueuePeak = level;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Reset the statistics of a pipeline and of its stages.
+  * @param  hpipe Pipeline.
+  * @retval None
+  */
+void BSP_PIPE_ResetStats(BSP_PIPE_TypeDef *hpipe)
+{
+  BSP_PIPE_StageTypeDef *stage;
+
+  hpipe->Accepted  = 0U;
+  hpipe->Refused   = 0U;
+  hpipe->Dropped   = 0U;
+  hpipe->Decimated = 0U;
+  hpipe->Pool.Peak = hpipe->Pool.Used;
+  hpipe->Pool.Failures = 0U;
+
+  for (stage = hpipe->pFirst; stage != NULL; stage = stage->pNext)
+  {
+    memset((void *)&stage->Stats, 0, sizeof(stage->Stats));
+  }
+}
+
+/**
+  * @brief  Print the statistics of a pipeline and of its stages with printf().
+  * @param  hpipe Pipeline.
+  * @retval None
+  */
+void BSP_PIPE_Print(const BSP_PIPE_TypeDef *hpipe)
+{
+  const BSP_PIPE_StageTypeDef *stage;
+  uint32_t mhz = SystemCoreClock / 1000000U;
+
+  printf("source: %lu accepted %lu refused %lu dropped %lu decimated, pool %lu/%lu peak %lu empty\r\n",
+         hpipe->Accepted, hpipe->Refused, hpipe->Dropped, hpipe->Decimated,
+         hpipe->Pool.Peak, hpipe->Pool.Count, hpipe->Pool.Failures);
+  printf("%-12s %8s %10s %10s %10s %10s %8s %5s\r\n",
+         "stage", "blocks", "bytes", "cyc/blk", "lat us", "max us", "stalls", "queue");
+  for (stage = hpipe->pFirst; stage != NULL; stage = stage->pNext)
+  {
+    printf("%-12s %8lu %10lu %10lu %10lu %10lu %8lu %2lu/%-2lu\r\n",
+           (stage->pName != NULL) ? stage->pName : "-", stage->Stats.Blocks, stage->Stats.Bytes,
+           (stage->Stats.Blocks != 0U) ? (stage->Stats.Cycles / stage->Stats.Blocks) : 0U,
+           stage->Stats.Latency / mhz, stage->Stats.LatencyMax / mhz, stage->Stats.Stalls,
+           stage->Stats.QueuePeak, stage->Input.Mask + 1U);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PIPE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Count a block processed by a stage.
+  * @param  hstage Stage.
+  * @param  Timestamp Allocation of the block.
+  * @param  Length Bytes of the block.
+  * @param  Cycles Cycles of the processing.
+  * @retval None
+  */
+static void PIPE_Account(BSP_PIPE_StageTypeDef *hstage, uint32_t Timestamp, uint32_t Length, uint32_t Cycles)
+{
+  uint32_t latency = DWT->CYCCNT - Timestamp;
+
+  hstage->Stats.Blocks++;
+  hstage->Stats.Bytes  += Length;
+  hstage->Stats.Cycles += Cycles;
+  if (Cycles > hstage->Stats.CyclesMax)
+  {
+    hstage->Stats.CyclesMax = Cycles;
+  }
+  hstage->Stats.Latency = latency;
+  if (latency > hstage->Stats.LatencyMax)
+  {
+    hstage->Stats.LatencyMax = latency;
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,1190 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_printf.c
+  * @author  MCU Application Team
+  * @brief   Formatted output BSP service.
+  *          This file provides a printf() family smaller and faster than the
+  *          one of newlib-nano with _printf_float:
+  *           + The conversions of C99, floats included, without locale
+  *           + Integers converted by multiplications, floats by the FPU
+  *           + Reentrant, the state on the stack of the caller
+  *           + The text given by chunks to _write() or to a user output
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) BSP_PRINTF_printf(), BSP_PRINTF_vprintf(), BSP_PRINTF_snprintf() and
+       BSP_PRINTF_vsnprintf() behave as the functions of the C library.
+       Built with USE_PRINTF=y, defining USE_BSP_PRINTF, they are also linked
+       as printf(), vprintf(), sprintf(), vsprintf(), snprintf() and
+       vsnprintf(), with puts() and putchar() the compiler calls for some
+       printf(): the newlib formatter is not linked any more and
+       ENABLE_PRINTF_FLOAT=y is not needed for the floats.
+
+   (#) The printf() text is gathered in a chunk of BSP_PRINTF_CHUNK bytes on
+       the stack, then given to _write() on stdout: the __io_putchar() loop
+       of system_gcc_io_fix.c or the queue of BSP_STDOUT get a few writes per
+       call instead of one per character. BSP_PRINTF_Format() gives the
+       chunks to any other output, a log buffer or a second UART.
+
+   (#) The flags "-+ #0", the width and the precision, given or '*', the
+       lengths hh, h, l, ll, j, z, t and L, and the conversions d i u o x X
+       c s p n f F e E g G and % are handled. Nothing is allocated and no
+       static variable is used, so the functions can be called from several
+       threads and from interrupt handlers, as far as their output can.
+
+   (#) The floats are converted in single precision by the FPU, the double
+       of the argument turned into a float first: about 7 significant digits
+       are right, as many as a float has, the others are the ones of the
+       nearest float. A double beyond the range of the floats is printed as
+       inf. Precisions above BSP_PRINTF_PRECISION_MAX are reduced to it.
+
+   (#) The integers of up to 32 bits are converted by multiplications by the
+       inverse of 10, without any division. The 64-bit ones above 2^32 use
+       the division of the C library for their first digits.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include "py32f4xx_bsp_printf.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PRINTF BSP PRINTF
+  * @brief Formatted output BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Private_Types BSP PRINTF Private Types
+  * @{
+  */
+
+/**
+  * @brief  Formatter state, on the stack of the caller
+  */
+typedef struct
+{
+  BSP_PRINTF_OutputTypeDef Output;      /*!< Output of the chunks                                   */
+
+  void                    *pContext;    /*!< Context of the output                                  */
+
+  uint32_t                Used;         /*!< Bytes in Chunk                                         */
+
+  int                     Count;        /*!< Characters produced, the return value                  */
+
+  char                    Chunk[BSP_PRINTF_CHUNK]; /*!< Text not yet given to the output             */
+
+} PRINTF_StateTypeDef;
+
+/**
+  * @brief  Conversion specification
+  */
+typedef struct
+{
+  uint32_t                Flags;        /*!< Combination of PRINTF_FLAG_xxx                         */
+
+  int32_t                 Width;        /*!< Minimum field width, 0 for none                        */
+
+  int32_t                 Precision;    /*!< Precision, -1 when not given                           */
+
+} PRINTF_SpecTypeDef;
+
+/**
+  * @brief  Destination of BSP_PRINTF_vsnprintf()
+  */
+typedef struct
+{
+  char                    *pBuffer;     /*!< Buffer, NULL with Size 0 to only count                 */
+
+  size_t                  Size;         /*!< Buffer size, the terminating null included             */
+
+  size_t                  Used;         /*!< Characters stored                                      */
+
+} PRINTF_StringTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Private_Constants BSP PRINTF Private Constants
+  * @{
+  */
+#define PRINTF_FLAG_LEFT                0x01U          /* '-' */
+#define PRINTF_FLAG_PLUS                0x02U          /* '+' */
+#define PRINTF_FLAG_SPACE               0x04U          /* ' ' */
+#define PRINTF_FLAG_ALT                 0x08U          /* '#' */
+#define PRINTF_FLAG_ZERO                0x10U          /* '0' */
+#define PRINTF_FLAG_UPPER               0x20U          /* X E G F */
+
+#define PRINTF_LEN_INT                  0U
+#define PRINTF_LEN_CHAR                 1U
+#define PRINTF_LEN_SHORT                2U
+#define PRINTF_LEN_LONG                 3U
+#define PRINTF_LEN_LLONG                4U
+#define PRINTF_LEN_SIZE                 5U
+#define PRINTF_LEN_PTRDIFF              6U
+
+#if !defined (BSP_PRINTF_PRECISION_MAX)
+#define BSP_PRINTF_PRECISION_MAX        16             /* Largest precision of a float            */
+#endif /* BSP_PRINTF_PRECISION_MAX */
+
+#define PRINTF_FLOAT_DIGITS             9              /* Fraction digits held in 32 bits         */
+#define PRINTF_FLOAT_SIZE               (44 + BSP_PRINTF_PRECISION_MAX) /* 9 + 30 digits, '.', precision, e+dd */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Private_Macros BSP PRINTF Private Macros
+  * @{
+  */
+/* v / 10 for any 32-bit v, by the inverse of 10 in 2^35 */
+#define PRINTF_DIV10(__V__)             ((uint32_t)(((uint64_t)(__V__) * 0xCCCCCCCDU) >> 35))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Private_Variables BSP PRINTF Private Variables
+  * @{
+  */
+static const uint32_t PRINTF_Pow10u[10] =
+{
+  1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+};
+
+static const float PRINTF_Pow10Bits[6] = {1e1f, 1e2f, 1e4f, 1e8f, 1e16f, 1e32f};
+
+static const char PRINTF_Digits[2][16] =
+{
+  {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'},
+  {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'}
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PRINTF_Private_Functions BSP PRINTF Private Functions
+  * @{
+  */
+static void PRINTF_Put(PRINTF_StateTypeDef *pState, char Char);
+static void PRINTF_Repeat(PRINTF_StateTypeDef *pState, char Char, int32_t Count);
+static void PRINTF_Write(PRINTF_StateTypeDef *pState, const char *pData, uint32_t Size);
+static void PRINTF_Field(PRINTF_StateTypeDef *pState, const PRINTF_SpecTypeDef *pSpec,
+                         const char *pPrefix, uint32_t PrefixSize, int32_t Zeros,
+                         const char *pBody, uint32_t BodySize);
+static char *PRINTF_Utoa(char *pEnd, uint32_t Value, uint32_t Base, uint32_t Upper);
+static char *PRINTF_Utoa64(char *pEnd, uint64_t Value);
+static void PRINTF_Integer(PRINTF_StateTypeDef *pState, PRINTF_SpecTypeDef *pSpec,
+                           uint64_t Value, uint32_t Negative, uint32_t Base);
+static void PRINTF_Double(PRINTF_StateTypeDef *pState, PRINTF_SpecTypeDef *pSpec, double Value, char Conversion);
+static float PRINTF_Pow10(uint32_t Exponent);
+static int32_t PRINTF_Scale(float Value, float *pMantissa);
+static void PRINTF_Round(uint64_t *pInteger, float Rest, int32_t Precision, uint32_t *pBlocks);
+static uint32_t PRINTF_Decimal(char *pBody, uint64_t Integer, int32_t Tail, int32_t Precision,
+                               const uint32_t *pBlocks, uint32_t Flags);
+static uint32_t PRINTF_Fixed(char *pBody, float Value, int32_t Precision, uint32_t Flags);
+static uint32_t PRINTF_Exponent(char *pBody, float Value, int32_t Precision, uint32_t Flags);
+static uint32_t PRINTF_General(char *pBody, float Value, int32_t Precision, uint32_t Flags);
+static void PRINTF_StringOutput(void *pContext, const char *pData, uint32_t Size);
+static void PRINTF_StdoutOutput(void *pContext, const char *pData, uint32_t Size);
+int _write(int file, char *ptr, int len);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PRINTF_Exported_Functions BSP PRINTF Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Format a text and give it to an output by chunks.
+  * @param  Output Output of the chunks.
+  * @param  pContext Context given to the output.
+  * @param  pFormat Format, as the one of printf().
+  * @param  Args Arguments of the format.
+  * @retval Number of characters produced.
+  */
+int BSP_PRINTF_Format(BSP_PRINTF_OutputTypeDef Output, void *pContext, const char *pFormat, va_list Args)
+{
+  PRINTF_StateTypeDef state;
+  PRINTF_SpecTypeDef spec;
+  const char *fmt = pFormat;
+  const char *text;
+  uint32_t length;
+  uint32_t size;
+  int64_t value;
+  char c;
+  va_list args;
+
+  state.Output = Output;
+  state.pContext = pContext;
+  state.Used = 0U;
+  state.Count = 0;
+  va_copy(args, Args);
+
+  while (*fmt != '\0')
+  {
+    /* Plain text up to the next conversion */
+    text = fmt;
+    while ((*fmt != '\0') && (*fmt != '%'))
+    {
+      fmt++;
+    }
+    PRINTF_Write(&state, text, (uint32_t)(fmt - text));
+    if (*fmt == '\0')
+    {
+      break;
+    }
+    fmt++;
+
+    /* Flags */
+    spec.Flags = 0U;
+    for (;; fmt++)
+    {
+      if (*fmt == '-')      { spec.Flags |= PRINTF_FLAG_LEFT; }
+      else if (*fmt == '+') { spec.Flags |= PRINTF_FLAG_PLUS; }
+      else if (*fmt == ' ') { spec.Flags |= PRINTF_FLAG_SPACE; }
+      else if (*fmt == '#') { spec.Flags |= PRINTF_FLAG_ALT; }
+      else if (*fmt == '0') { spec.Flags |= PRINTF_FLAG_ZERO; }
+      else                  { break; }
+    }
+
+    /* Width and precision */
+    spec.Width = 0;
+    if (*fmt == '*')
+    {
+      spec.Width = va_arg(args, int);
+      if (spec.Width < 0)
+      {
+        spec.Flags |= PRINTF_FLAG_LEFT;
+        spec.Width = -spec.Width;
+      }
+      fmt++;
+    }
+    while ((*fmt >= '0') && (*fmt <= '9'))
+    {
+      spec.Width = (spec.Width * 10) + (*fmt++ - '0');
+    }
+    spec.Precision = -1;
+    if (*fmt == '.')
+    {
+      fmt++;
+      spec.Precision = 0;
+      if (*fmt == '*')
+      {
+        spec.Precision = va_arg(args, int);
+        spec.Precision = (spec.Precision < 0) ? -1 : spec.Precision;
+        fmt++;
+      }
+      while ((*fmt >= '0') && (*fmt <= '9'))
+      {
+        spec.Precision = (spec.Precision * 10) + (*fmt++ - '0');
+      }
+    }
+
+    /* Length */
+    length = PRINTF_LEN_INT;
+    switch (*fmt)
+    {
+      case 'h':
+        fmt++;
+        length = PRINTF_LEN_SHORT;
+        if (*fmt == 'h')
+        {
+          fmt++;
+          length = PRINTF_LEN_CHAR;
+        }
+        break;
+      case 'l':
+        fmt++;
+        length = PRINTF_LEN_LONG;
+        if (*fmt == 'l')
+        {
+          fmt++;
+          length = PRINTF_LEN_LLONG;
+        }
+        break;
+      case 'j':
+        fmt++;
+        length = PRINTF_LEN_LLONG;
+        break;
+      case 'z':
+        fmt++;
+        length = PRINTF_LEN_SIZE;
+        break;
+      case 't':
+        fmt++;
+        length = PRINTF_LEN_PTRDIFF;
+        break;
+      case 'L':
+        /* long double is double on the Cortex-M */
+        fmt++;
+        break;
+      default:
+        break;
+    }
+
+    c = *fmt++;
+    switch (c)
+    {
+      case 'd':
+      case 'i':
+        switch (length)
+        {
+          case PRINTF_LEN_LLONG:   value = va_arg(args, long long);                 break;
+          case PRINTF_LEN_LONG:    value = va_arg(args, long);                      break;
+          case PRINTF_LEN_SIZE:    value = (int32_t)va_arg(args, size_t);           break;
+          case PRINTF_LEN_PTRDIFF: value = va_arg(args, ptrdiff_t);                 break;
+          case PRINTF_LEN_CHAR:    value = (signed char)va_arg(args, int);          break;
+          case PRINTF_LEN_SHORT:   value = (short)va_arg(args, int);                break;
+          default:                 value = va_arg(args, int);                       break;
+        }
+        PRINTF_Integer(&state, &spec, (value < 0) ? (0U - (uint64_t)value) : (uint64_t)value,
+                       (value < 0) ? 1U : 0U, 10U);
+        break;
+
+      case 'X':
+        spec.Flags |= PRINTF_FLAG_UPPER;
+        /* fall through */
+      case 'u':
+      case 'o':
+      case 'x':
+        switch (length)
+        {
+          case PRINTF_LEN_LLONG:   value = (int64_t)va_arg(args, unsigned long long); break;
+          case PRINTF_LEN_LONG:    value = va_arg(args, unsigned long);             break;
+          case PRINTF_LEN_SIZE:    value = va_arg(args, size_t);                    break;
+          case PRINTF_LEN_PTRDIFF: value = (uint32_t)va_arg(args, ptrdiff_t);       break;
+          case PRINTF_LEN_CHAR:    value = (unsigned char)va_arg(args, unsigned int); break;
+          case PRINTF_LEN_SHORT:   value = (unsigned short)va_arg(args, unsigned int); break;
+          default:                 value = va_arg(args, unsigned int);              break;
+        }
+        spec.Flags &= ~(PRINTF_FLAG_PLUS | PRINTF_FLAG_SPACE);
+        PRINTF_Integer(&state, &spec, (uint64_t)value, 0U, (c == 'u') ? 10U : ((c == 'o') ? 8U : 16U));
+        break;
+
+      case 'p':
+        spec.Flags |= PRINTF_FLAG_ALT;
+        spec.Flags &= ~(PRINTF_FLAG_PLUS | PRINTF_FLAG_SPACE);
+        PRINTF_Integer(&state, &spec, (uintptr_t)va_arg(args, void *), 0U, 16U);
+        break;
+
+      case 'c':
+        c = (char)va_arg(args, int);
+        PRINTF_Field(&state, &spec, NULL, 0U, 0, &c, 1U);
+        break;
+
+      case 's':
+        text = va_arg(args, const char *);
+        text = (text == NULL) ? "(null)" : text;
+        for (size = 0U; (text[size] != '\0') && ((spec.Precision < 0) || (size < (uint32_t)spec.Precision)); size++)
+        {
+        }
+        PRINTF_Field(&state, &spec, NULL, 0U, 0, text, size);
+        break;
+
+      case 'F':
+      case 'E':
+      case 'G':
+        spec.Flags |= PRINTF_FLAG_UPPER;
+        c = (char)(c - 'A' + 'a');
+        /* fall through */
+      case 'f':
+      case 'e':
+      case 'g':
+        PRINTF_Double(&state, &spec, va_arg(args, double), c);
+        break;
+
+      case 'n':
+        *va_arg(args, int *) = state.Count;
+        break;
+
+      case '%':
+        PRINTF_Put(&state, '%');
+        break;
+
+      default:
+        /* Unknown, given back as it is */
+        PRINTF_Put(&state, '%');
+        fmt--;
+        break;
+    }
+  }
+
+  va_end(args);
+  if (state.Used != 0U)
+  {
+    state.Output(state.pContext, state.Chunk, state.Used);
+  }
+
+  return state.Count;
+}
+
+/**
+  * @brief  Format a text in a buffer, as vsnprintf().
+  * @param  pBuffer Buffer, may be NULL when Size is 0.
+  * @param  Size Buffer size, the text is truncated to Size - 1 characters.
+  * @param  pFormat Format, as the one of printf().
+  * @param  Args Arguments of the format.
+  * @retval Number of characters of the whole text, terminating null excluded.
+  */
+int BSP_PRINTF_vsnprintf(char *pBuffer, size_t Size, const char *pFormat, va_list Args)
+{
+  PRINTF_StringTypeDef string;
+  int count;
+
+  string.pBuffer = pBuffer;
+  string.Size = Size;
+  string.Used = 0U;
+  count = BSP_PRINTF_Format(PRINTF_StringOutput, &string, pFormat, Args);
+  if (Size != 0U)
+  {
+    pBuffer[string.Used] = '\0';
+  }
+
+  return count;
+}
+
+/**
+  * @brief  Format a text in a buffer, as snprintf().
+  * @param  pBuffer Buffer, may be NULL when Size is 0.
+  * @param  Size Buffer size, the text is truncated to Size - 1 characters.
+  * @param  pFormat Format, as the one of printf().
+  * @retval Number of characters of the whole text, terminating null excluded.
+  */
+int BSP_PRINTF_snprintf(char *pBuffer, size_t Size, const char *pFormat, ...)
+{
+  va_list args;
+  int count;
+
+  va_start(args, pFormat);
+  count = BSP_PRINTF_vsnprintf(pBuffer, Size, pFormat, args);
+  va_end(args);
+
+  return count;
+}
+
+/**
+  * @brief  Format a text on stdout through _write(), as vprintf().
+  * @param  pFormat Format, as the one of printf().
+  * @param  Args Arguments of the format.
+  * @retval Number of characters written.
+  */
+int BSP_PRINTF_vprintf(const char *pFormat, va_list Args)
+{
+  return BSP_PRINTF_Format(PRINTF_StdoutOutput, NULL, pFormat, Args);
+}
+
+/**
+  * @brief  Format a text on stdout through _write(), as printf().
+  * @param  pFormat Format, as the one of printf().
+  * @retval Number of characters written.
+  */
+int BSP_PRINTF_printf(const char *pFormat, ...)
+{
+  va_list args;
+  int count;
+
+  va_start(args, pFormat);
+  count = BSP_PRINTF_vprintf(pFormat, args);
+  va_end(args);
+
+  return count;
+}
+
+/**
+  * @}
+  */
+
+#if defined (USE_BSP_PRINTF)
+/** @defgroup BSP_PRINTF_Library_Functions BSP PRINTF Library Functions
+  * @brief    The C library functions, linked in place of the ones of newlib
+  * @{
+  */
+int printf(const char *pFormat, ...)
+{
+  va_list args;
+  int count;
+
+  va_start(args, pFormat);
+  count = BSP_PRINTF_vprintf(pFormat, args);
+  va_end(args);
+
+  return count;
+}
+
+int vprintf(const char *pFormat, va_list Args)
+{
+  return BSP_PRINTF_vprintf(pFormat, Args);
+}
+
+int snprintf(char *pBuffer, size_t Size, const char *pFormat, ...)
+{
+  va_list args;
+  int count;
+
+  va_start(args, pFormat);
+  count = BSP_PRINTF_vsnprintf(pBuffer, Size, pFormat, args);
+  va_end(args);
+
+  return count;
+}
+
+int vsnprintf(char *pBuffer, size_t Size, const char *pFormat, va_list Args)
+{
+  return BSP_PRINTF_vsnprintf(pBuffer, Size, pFormat, Args);
+}
+
+int sprintf(char *pBuffer, const char *pFormat, ...)
+{
+  va_list args;
+  int count;
+
+  va_start(args, pFormat);
+  count = BSP_PRINTF_vsnprintf(pBuffer, SIZE_MAX, pFormat, args);
+  va_end(args);
+
+  return count;
+}
+
+int vsprintf(char *pBuffer, const char *pFormat, va_list Args)
+{
+  return BSP_PRINTF_vsnprintf(pBuffer, SIZE_MAX, pFormat, Args);
+}
+
+int puts(const char *pText)
+{
+  int size = (int)strlen(pText);
+
+  (void)_write(1, (char *)pText, size);
+  (void)_write(1, "\n", 1);
+
+  return size + 1;
+}
+
+int putchar(int Char)
+{
+  char c = (char)Char;
+
+  (void)_write(1, &c, 1);
+
+  return (unsigned char)c;
+}
+/**
+  * @}
+  */
+#endif /* USE_BSP_PRINTF */
+
+/** @addtogroup BSP_PRINTF_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Add a character to the chunk, given to the output when full.
+  */
+static void PRINTF_Put(PRINTF_StateTypeDef *pState, char Char)
+{
+  pState->Chunk[pState->Used++] = Char;
+  pState->Count++;
+  if (pState->Used == BSP_PRINTF_CHUNK)
+  {
+    pState->Output(pState->pContext, pState->Chunk, BSP_PRINTF_CHUNK);
+    pState->Used = 0U;
+  }
+}
+
+/**
+  * @brief  Add a character Count times, nothing when Count is 0 or less.
+  */
+static void PRINTF_Repeat(PRINTF_StateTypeDef *pState, char Char, int32_t Count)
+{
+  for (; Count > 0; Count--)
+  {
+    PRINTF_Put(pState, Char);
+  }
+}
+
+/**
+  * @brief  Add characters to the chunk.
+  */
+static void PRINTF_Write(PRINTF_StateTypeDef *pState, const char *pData, uint32_t Size)
+{
+  uint32_t part;
+
+  while (Size != 0U)
+  {
+    part = BSP_PRINTF_CHUNK - pState->Used;
+    part = (Size < part) ? Size : part;
+    memcpy(&pState->Chunk[pState->Used], pData, part);
+    pState->Used += part;
+    pState->Count += (int)part;
+    pData += part;
+    Size -= part;
+    if (pState->Used == BSP_PRINTF_CHUNK)
+    {
+      pState->Output(pState->pContext, pState->Chunk, BSP_PRINTF_CHUNK);
+      pState->Used = 0U;
+    }
+  }
+}
+
+/**
+  * @brief  Add a field: prefix, leading zeros and body, padded to the width.
+  * @note   The zero flag pads with zeros between the prefix and the body, the
+  *         callers clear it when it does not apply.
+  */
+static void PRINTF_Field(PRINTF_StateTypeDef *pState, const PRINTF_SpecTypeDef *pSpec,
+                         const char *pPrefix, uint32_t PrefixSize, int32_t Zeros,
+                         const char *pBody, uint32_t BodySize)
+{
+  int32_t pad = pSpec->Width - (int32_t)(PrefixSize + BodySize) - ((Zeros > 0) ? Zeros : 0);
+
+  if ((pSpec->Flags & PRINTF_FLAG_LEFT) != 0U)
+  {
+    PRINTF_Write(pState, pPrefix, PrefixSize);
+    PRINTF_Repeat(pState, '0', Zeros);
+    PRINTF_Write(pState, pBody, BodySize);
+    PRINTF_Repeat(pState, ' ', pad);
+  }
+  else if ((pSpec->Flags & PRINTF_FLAG_ZERO) != 0U)
+  {
+    PRINTF_Write(pState, pPrefix, PrefixSize);
+    PRINTF_Repeat(pState, '0', ((Zeros > 0) ? Zeros : 0) + ((pad > 0) ? pad : 0));
+    PRINTF_Write(pState, pBody, BodySize);
+  }
+  else
+  {
+    PRINTF_Repeat(pState, ' ', pad);
+    PRINTF_Write(pState, pPrefix, PrefixSize);
+    PRINTF_Repeat(pState, '0', Zeros);
+    PRINTF_Write(pState, pBody, BodySize);
+  }
+}
+
+/**
+  * @brief  Write the digits of a value before pEnd.
+  * @retval First digit, one digit at least.
+  */
+static char *PRINTF_Utoa(char *pEnd, uint32_t Value, uint32_t Base, uint32_t Upper)
+{
+  const char *digits = PRINTF_Digits[(Upper != 0U) ? 1U : 0U];
+  uint32_t quotient;
+
+  if (Base == 10U)
+  {
+    do
+    {
+      quotient = PRINTF_DIV10(Value);
+      *--pEnd = (char)('0' + (Value - (quotient * 10U)));
+      Value = quotient;
+    } while (Value != 0U);
+  }
+  else
+  {
+    /* 8 or 16 */
+    do
+    {
+      *--pEnd = digits[Value & (Base - 1U)];
+      Value >>= (Base == 16U) ? 4U : 3U;
+    } while (Value != 0U);
+  }
+
+  return pEnd;
+}
+
+/**
+  * @brief  Write the decimal digits of a 64-bit value before pEnd.
+  * @retval First digit, one digit at least.
+  */
+static char *PRINTF_Utoa64(char *pEnd, uint64_t Value)
+{
+  /* The division of the C library only for the digits above 2^32 */
+  while (Value > 0xFFFFFFFFU)
+  {
+    *--pEnd = (char)('0' + (uint32_t)(Value % 10U));
+    Value /= 10U;
+  }
+
+  return PRINTF_Utoa(pEnd, (uint32_t)Value, 10U, 0U);
+}
+
+/**
+  * @brief  Add an integer conversion.
+  */
+static void PRINTF_Integer(PRINTF_StateTypeDef *pState, PRINTF_SpecTypeDef *pSpec,
+                           uint64_t Value, uint32_t Negative, uint32_t Base)
+{
+  char digits[24];
+  char prefix[2];
+  uint32_t upper = pSpec->Flags & PRINTF_FLAG_UPPER;
+  uint32_t prefixSize = 0U;
+  uint32_t size;
+  int32_t zeros;
+  char *first = &digits[sizeof(digits)];
+
+  if (Base == 10U)
+  {
+    first = PRINTF_Utoa64(first, Value);
+  }
+  else
+  {
+    /* The 64-bit values go down to 32 bits first */
+    while (Value > 0xFFFFFFFFU)
+    {
+      *--first = PRINTF_Digits[(upper != 0U) ? 1U : 0U][(uint32_t)Value & (Base - 1U)];
+      Value >>= (Base == 16U) ? 4U : 3U;
+    }
+    first = PRINTF_Utoa(first, (uint32_t)Value, Base, upper);
+  }
+  size = (uint32_t)(&digits[sizeof(digits)] - first);
+  if ((pSpec->Precision == 0) && (size == 1U) && (*first == '0'))
+  {
+    size = 0U;
+  }
+
+  if (Negative != 0U)
+  {
+    prefix[prefixSize++] = '-';
+  }
+  else if ((pSpec->Flags & PRINTF_FLAG_PLUS) != 0U)
+  {
+    prefix[prefixSize++] = '+';
+  }
+  else if ((pSpec->Flags & PRINTF_FLAG_SPACE) != 0U)
+  {
+    prefix[prefixSize++] = ' ';
+  }
+
+  zeros = (pSpec->Precision > (int32_t)size) ? (pSpec->Precision - (int32_t)size) : 0;
+  if ((pSpec->Flags & PRINTF_FLAG_ALT) != 0U)
+  {
+    if ((Base == 16U) && (size != 0U) && !((size == 1U) && (*first == '0')))
+    {
+      prefix[prefixSize++] = '0';
+      prefix[prefixSize++] = (upper != 0U) ? 'X' : 'x';
+    }
+    else if ((Base == 8U) && (zeros == 0) && ((size == 0U) || (*first != '0')))
+    {
+      zeros = 1;
+    }
+  }
+
+  if (pSpec->Precision >= 0)
+  {
+    pSpec->Flags &= ~PRINTF_FLAG_ZERO;
+  }
+  PRINTF_Field(pState, pSpec, prefix, prefixSize, zeros, first, size);
+}
+
+/**
+  * @brief  Add a float conversion, f, e or g.
+  */
+static void PRINTF_Double(PRINTF_StateTypeDef *pState, PRINTF_SpecTypeDef *pSpec, double Value, char Conversion)
+{
+  char body[PRINTF_FLOAT_SIZE];
+  char sign = '\0';
+  uint32_t upper = pSpec->Flags & PRINTF_FLAG_UPPER;
+  uint32_t size;
+  uint32_t i;
+  int32_t precision = pSpec->Precision;
+  float value = (float)Value;
+
+  if (__builtin_signbit(value))
+  {
+    sign = '-';
+    value = -value;
+  }
+  else if ((pSpec->Flags & PRINTF_FLAG_PLUS) != 0U)
+  {
+    sign = '+';
+  }
+  else if ((pSpec->Flags & PRINTF_FLAG_SPACE) != 0U)
+  {
+    sign = ' ';
+  }
+
+  if (value != value)
+  {
+    memcpy(body, "nan", 3U);
+    size = 3U;
+    pSpec->Flags &= ~PRINTF_FLAG_ZERO;
+  }
+  else if (value > 3.40282347e38f)
+  {
+    memcpy(body, "inf", 3U);
+    size = 3U;
+    pSpec->Flags &= ~PRINTF_FLAG_ZERO;
+  }
+  else
+  {
+    precision = (precision < 0) ? 6 : precision;
+    precision = (precision > BSP_PRINTF_PRECISION_MAX) ? BSP_PRINTF_PRECISION_MAX : precision;
+    if (Conversion == 'f')
+    {
+      size = PRINTF_Fixed(body, value, precision, pSpec->Flags);
+    }
+    else if (Conversion == 'e')
+    {
+      size = PRINTF_Exponent(body, value, precision, pSpec->Flags);
+    }
+    else
+    {
+      size = PRINTF_General(body, value, precision, pSpec->Flags);
+    }
+  }
+
+  if (upper != 0U)
+  {
+    for (i = 0U; i < size; i++)
+    {
+      body[i] = ((body[i] >= 'a') && (body[i] <= 'z')) ? (char)(body[i] - 'a' + 'A') : body[i];
+    }
+  }
+  PRINTF_Field(pState, pSpec, &sign, (sign != '\0') ? 1U : 0U, 0, body, size);
+}
+
+/**
+  * @brief  10 to a power, by the squares of 10, exact up to 10^10.
+  * @param  Exponent 0 to 38.
+  */
+static float PRINTF_Pow10(uint32_t Exponent)
+{
+  float result = 1.0f;
+  uint32_t i;
+
+  for (i = 0U; Exponent != 0U; i++, Exponent >>= 1)
+  {
+    if ((Exponent & 1U) != 0U)
+    {
+      result *= PRINTF_Pow10Bits[i];
+    }
+  }
+
+  return result;
+}
+
+/**
+  * @brief  Split a positive finite value in a mantissa 1 to 10 and a power of 10.
+  * @retval Decimal exponent.
+  */
+static int32_t PRINTF_Scale(float Value, float *pMantissa)
+{
+  union
+  {
+    float    f;
+    uint32_t u;
+  } bits;
+  int32_t exponent = 0;
+  int32_t exp2;
+  int32_t exp10;
+  float mantissa;
+
+  /* The denormals and the smallest normals brought in range first */
+  if (Value < 1e-30f)
+  {
+    Value *= 1e30f;
+    exponent = -30;
+  }
+
+  /* log10(2) ~ 1233 / 4096, from the exponent of the float */
+  bits.f = Value;
+  exp2 = (int32_t)((bits.u >> 23) & 0xFFU) - 127;
+  exp10 = (exp2 >= 0) ? ((exp2 * 1233) >> 12) : -((((-exp2) * 1233) + 4095) >> 12);
+
+  mantissa = (exp10 >= 0) ? (Value / PRINTF_Pow10((uint32_t)exp10)) : (Value * PRINTF_Pow10((uint32_t)-exp10));
+  while (mantissa >= 10.0f)
+  {
+    mantissa /= 10.0f;
+    exp10++;
+  }
+  while (mantissa < 1.0f)
+  {
+    mantissa *= 10.0f;
+    exp10--;
+  }
+
+  *pMantissa = mantissa;
+  return exp10 + exponent;
+}
+
+/**
+  * @brief  Digits of the fraction, by blocks of up to 9, rounded half to even.
+  * @param  pInteger Integer part, incremented by a carry of the rounding.
+  * @param  Rest Fraction, 0 to 1.
+  * @param  Precision Digits of the fraction, up to 2 blocks.
+  * @param  pBlocks Blocks of the fraction, of 9 digits but the last one.
+  * @retval None
+  */
+static void PRINTF_Round(uint64_t *pInteger, float Rest, int32_t Precision, uint32_t *pBlocks)
+{
+  int32_t places[2];
+  uint32_t blocks = 0U;
+  uint32_t odd;
+  uint32_t i;
+  float scaled;
+
+  for (; Precision > 0; Precision -= places[blocks++])
+  {
+    places[blocks] = (Precision > PRINTF_FLOAT_DIGITS) ? PRINTF_FLOAT_DIGITS : Precision;
+    scaled = Rest * PRINTF_Pow10((uint32_t)places[blocks]);
+    pBlocks[blocks] = (uint32_t)scaled;
+    Rest = scaled - (float)pBlocks[blocks];
+  }
+
+  odd = (blocks == 0U) ? (uint32_t)(*pInteger & 1U) : (pBlocks[blocks - 1U] & 1U);
+  if ((Rest > 0.5f) || ((Rest == 0.5f) && (odd != 0U)))
+  {
+    for (i = blocks; i > 0U; i--)
+    {
+      if (++pBlocks[i - 1U] < PRINTF_Pow10u[places[i - 1U]])
+      {
+        return;
+      }
+      pBlocks[i - 1U] = 0U;
+    }
+    (*pInteger)++;
+  }
+}
+
+/**
+  * @brief  Write the integer and the fraction of PRINTF_Round().
+  * @param  pBody Output.
+  * @param  Integer Integer part.
+  * @param  Tail Zeros after the integer part.
+  * @param  Precision Digits of the fraction.
+  * @param  pBlocks Blocks of the fraction.
+  * @param  Flags Combination of PRINTF_FLAG_xxx, '#' keeps the point.
+  * @retval Characters written.
+  */
+static uint32_t PRINTF_Decimal(char *pBody, uint64_t Integer, int32_t Tail, int32_t Precision,
+                               const uint32_t *pBlocks, uint32_t Flags)
+{
+  char digits[20];
+  char *first;
+  char *p = pBody;
+  int32_t places;
+  uint32_t size;
+
+  first = PRINTF_Utoa64(&digits[sizeof(digits)], Integer);
+  size = (uint32_t)(&digits[sizeof(digits)] - first);
+  memcpy(p, first, size);
+  p += size;
+  for (; Tail > 0; Tail--)
+  {
+    *p++ = '0';
+  }
+
+  if ((Precision > 0) || ((Flags & PRINTF_FLAG_ALT) != 0U))
+  {
+    *p++ = '.';
+  }
+  for (; Precision > 0; Precision -= places, pBlocks++)
+  {
+    places = (Precision > PRINTF_FLOAT_DIGITS) ? PRINTF_FLOAT_DIGITS : Precision;
+    first = PRINTF_Utoa(&digits[sizeof(digits)], *pBlocks, 10U, 0U);
+    size = (uint32_t)(&digits[sizeof(digits)] - first);
+    memset(p, '0', (size_t)places - size);
+    memcpy(p + places - size, first, size);
+    p += places;
+  }
+
+  return (uint32_t)(p - pBody);
+}
+
+/**
+  * @brief  Write a positive finite value as [d]ddd.ddd, the f conversion.
+  * @retval Characters written.
+  */
+static uint32_t PRINTF_Fixed(char *pBody, float Value, int32_t Precision, uint32_t Flags)
+{
+  uint32_t blocks[2];
+  uint64_t integer;
+  int32_t tail = 0;
+  float mantissa;
+
+  if (Value < 1.8e19f)
+  {
+    /* Exact integer part, the fraction is 0 from 2^24 */
+    integer = (uint64_t)Value;
+    PRINTF_Round(&integer, Value - (float)integer, Precision, blocks);
+  }
+  else
+  {
+    /* Nine significant digits, then zeros: a float has no more */
+    tail = PRINTF_Scale(Value, &mantissa) - 8;
+    integer = (uint64_t)(mantissa * 1e8f);
+    PRINTF_Round(&integer, 0.0f, Precision, blocks);
+  }
+
+  return PRINTF_Decimal(pBody, integer, tail, Precision, blocks, Flags);
+}
+
+/**
+  * @brief  Write a positive finite value as d.ddde+dd, the e conversion.
+  * @retval Characters written.
+  */
+static uint32_t PRINTF_Exponent(char *pBody, float Value, int32_t Precision, uint32_t Flags)
+{
+  char digits[4];
+  char *first;
+  char *p;
+  uint32_t blocks[2];
+  uint64_t integer = 0U;
+  int32_t exp10 = 0;
+  float mantissa = 0.0f;
+
+  if (Value != 0.0f)
+  {
+    exp10 = PRINTF_Scale(Value, &mantissa);
+    integer = (uint64_t)mantissa;
+  }
+  PRINTF_Round(&integer, mantissa - (float)integer, Precision, blocks);
+  if (integer == 10U)
+  {
+    /* 9.99 rounded up, the fraction is 0 */
+    integer = 1U;
+    exp10++;
+  }
+  p = pBody + PRINTF_Decimal(pBody, integer, 0, Precision, blocks, Flags);
+
+  *p++ = 'e';
+  *p++ = (exp10 < 0) ? '-' : '+';
+  exp10 = (exp10 < 0) ? -exp10 : exp10;
+  if (exp10 < 10)
+  {
+    *p++ = '0';
+  }
+  first = PRINTF_Utoa(&digits[sizeof(digits)], (uint32_t)exp10, 10U, 0U);
+  memcpy(p, first, (size_t)(&digits[sizeof(digits)] - first));
+  p += &digits[sizeof(digits)] - first;
+
+  return (uint32_t)(p - pBody);
+}
+
+/**
+  * @brief  Write a positive finite value as f or e, the g conversion.
+  * @retval Characters written.
+  */
+static uint32_t PRINTF_General(char *pBody, float Value, int32_t Precision, uint32_t Flags)
+{
+  char *point;
+  char *exponent;
+  char *end;
+  uint32_t blocks[2];
+  uint64_t integer;
+  int32_t exp10 = 0;
+  uint32_t size;
+  float mantissa;
+
+  Precision = (Precision == 0) ? 1 : Precision;
+
+  /* Exponent of the e conversion, after its rounding */
+  if (Value != 0.0f)
+  {
+    exp10 = PRINTF_Scale(Value, &mantissa);
+    integer = (uint64_t)mantissa;
+    PRINTF_Round(&integer, mantissa - (float)integer, Precision - 1, blocks);
+    exp10 += (integer == 10U) ? 1 : 0;
+  }
+
+  if ((exp10 < Precision) && (exp10 >= -4))
+  {
+    size = PRINTF_Fixed(pBody, Value, Precision - 1 - exp10, Flags);
+  }
+  else
+  {
+    size = PRINTF_Exponent(pBody, Value, Precision - 1, Flags);
+  }
+
+  /* Trailing zeros of the fraction removed, but with '#' */
+  point = memchr(pBody, '.', size);
+  if (((Flags & PRINTF_FLAG_ALT) == 0U) && (point != NULL))
+  {
+    exponent = memchr(pBody, 'e', size);
+    end = (exponent != NULL) ? exponent : (pBody + size);
+    while (end[-1] == '0')
+    {
+      end--;
+    }
+    if (end[-1] == '.')
+    {
+      end--;
+    }
+    if (exponent != NULL)
+    {
+      memmove(end, exponent, (size_t)((pBody + size) - exponent));
+      size -= (uint32_t)(exponent - end);
+    }
+    else
+    {
+      size = (uint32_t)(end - pBody);
+    }
+  }
+
+  return size;
+}
+
+/**
+  * @brief  Output of BSP_PRINTF_vsnprintf(), the buffer filled up to its size.
+  */
+static void PRINTF_StringOutput(void *pContext, const char *pData, uint32_t Size)
+{
+  PRINTF_StringTypeDef *string = (PRINTF_StringTypeDef *)pContext;
+  size_t room;
+
+  if (string->Size == 0U)
+  {
+    return;
+  }
+  room = string->Size - 1U - string->Used;
+  room = (Size < room) ? Size : room;
+  memcpy(&string->pBuffer[string->Used], pData, room);
+  string->Used += room;
+}
+
+/**
+  * @brief  Output of BSP_PRINTF_vprintf(), _write() on stdout.
+  */
+static void PRINTF_StdoutOutput(void *pContext, const char *pData, uint32_t Size)
+{
+  (void)pContext;
+  (void)_write(1, (char *)pData, (int)Size);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,433 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_probe.c
+  * @author  MCU Application Team
+  * @brief   Profiling probe BSP service.
+  *          This file provides functions to measure code zones to the cycle:
+  *           + Enter and exit macros, compiled out without USE_BSP_PROBE
+  *           + DWT cycle count of each event in a ring
+  *           + Events on SWO through the ITM, or a pin per zone for a logic
+  *             analyzer
+  *           + Count, min, mean, max and histogram of each zone, printed
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_PROBE=y, defining USE_BSP_PROBE: BSP_PROBE_ENTER() and
+       BSP_PROBE_EXIT() then call BSP_PROBE_Enter() and BSP_PROBE_Exit(),
+       otherwise they compile to nothing and can stay in the code. Put them
+       at the start and at the end of a HAL callback, of an interrupt handler
+       or of any zone of the code, a number 0 to BSP_PROBE_ZONES - 1 for each
+       zone. Zones may nest or interrupt each other, a zone must not
+       interrupt itself.
+
+   (#) Call BSP_PROBE_Init() with the outputs, a combination of
+       @ref BSP_PROBE_Output, then BSP_PROBE_ConfigZone() to name a zone and
+       give it a pin. The statistics of the zones are always kept: the
+       duration of each exit, from its enter, goes to the count, the min, the
+       max, the total and a bin of the histogram, the power of 2 of the cycles.
+       An event costs a few tens of cycles, with the interrupts masked.
+
+   (#) BSP_PROBE_OUTPUT_RING keeps the last BSP_PROBE_RING events, read in
+       order with BSP_PROBE_ReadRing(). BSP_PROBE_OUTPUT_GPIO sets the pin of
+       the zone on the enter and resets it on the exit: the pulses on a logic
+       analyzer are the zones, the pin configured as output by
+       BSP_PROBE_ConfigZone(), its port clock enabled before.
+
+   (#) BSP_PROBE_OUTPUT_ITM writes each event as a 32-bit word on the stimulus
+       port BSP_PROBE_ITM_PORT: bits 31:24 the zone, bit 23 set on an exit,
+       bits 22:0 the cycle count modulo 2^23. A duration is the difference of
+       two words modulo 2^23, right for zones shorter than 2^23 cycles.
+       BSP_PROBE_ConfigITM() assigns the trace pin with
+       HAL_DBGMCU_SetTracePinAssignment() and sets SWO to NRZ at SwoHz, a
+       divider of HCLK; set the same rate in the SWO viewer of the probe.
+
+   (#) BSP_PROBE_Print() prints the statistics and the histogram of each
+       zone measured, in cycles and us, with printf(). BSP_PROBE_GetZone()
+       gives them to a test bench instead, BSP_PROBE_Reset() clears them.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "py32f4xx_bsp_probe.h"
+#include "py32f4xx_bsp_trace.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PROBE BSP PROBE
+  * @brief Profiling probe BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Private_Constants BSP PROBE Private Constants
+  * @{
+  */
+#define PROBE_ITM_CYCLES                0x007FFFFFU    /* Cycle count bits of an ITM word */
+#define PROBE_ITM_EXIT                  0x00800000U
+#define PROBE_BAR                       32U            /* Characters of the longest bin */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Private_Variables BSP PROBE Private Variables
+  * @{
+  */
+static BSP_PROBE_ZoneTypeDef PROBE_Zones[BSP_PROBE_ZONES];
+static BSP_PROBE_EventTypeDef PROBE_Ring[BSP_PROBE_RING];
+static uint32_t PROBE_Head;
+static uint32_t PROBE_Tail;
+static uint32_t PROBE_Outputs;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PROBE_Private_Functions BSP PROBE Private Functions
+  * @{
+  */
+static void PROBE_Event(uint32_t Zone, uint32_t Exit, uint32_t Cycles);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PROBE_Exported_Functions BSP PROBE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Start the cycle counter and select the outputs of the events.
+  * @param  Outputs A combination of @ref BSP_PROBE_Output, 0 for the statistics only.
+  * @retval None
+  */
+void BSP_PROBE_Init(uint32_t Outputs)
+{
+  HAL_EnableCycleCounter();
+
+  PROBE_Outputs = Outputs;
+  BSP_PROBE_Reset();
+}
+
+/**
+  * @brief  Name a zone and give it a pin.
+  * @param  Zone Zone, 0 to BSP_PROBE_ZONES - 1.
+  * @param  pName Zone name, a string constant kept by reference, or NULL.
+  * @param  GPIOx Port of the pin, its clock enabled, or NULL for none.
+  * @param  GPIO_Pin Pin, a value of @ref GPIO_pins_define.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PROBE_ConfigZone(uint32_t Zone, const char *pName, GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+  GPIO_InitTypeDef gpio = {0};
+
+  if ((Zone >= BSP_PROBE_ZONES) || ((GPIOx != NULL) && !IS_GPIO_PIN(GPIO_Pin)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (GPIOx != NULL)
+  {
+    GPIOx->BSRR = (uint32_t)GPIO_Pin << 16U;
+    gpio.Pin   = GPIO_Pin;
+    gpio.Mode  = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull  = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    HAL_GPIO_Init(GPIOx, &gpio);
+  }
+
+  PROBE_Zones[Zone].pName    = pName;
+  PROBE_Zones[Zone].GPIOx    = GPIOx;
+  PROBE_Zones[Zone].GPIO_Pin = GPIO_Pin;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Assign the SWO pin and enable the ITM stimulus port of the probes.
+  * @param  SwoHz SWO bit rate, HCLK divided by 1 to 8192.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PROBE_ConfigITM(uint32_t SwoHz)
+{
+  if (BSP_TRACE_Init(SwoHz) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return BSP_TRACE_EnablePort(BSP_PROBE_ITM_PORT);
+}
+
+/**
+  * @brief  Enter a zone.
+  * @param  Zone Zone, 0 to BSP_PROBE_ZONES - 1.
+  * @retval None
+  */
+void BSP_PROBE_Enter(uint32_t Zone)
+{
+  uint32_t primask_bit;
+  uint32_t cycles;
+
+  if (Zone >= BSP_PROBE_ZONES)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  cycles = DWT->CYCCNT;
+  PROBE_Zones[Zone].Start = cycles;
+  PROBE_Event(Zone, 0U, cycles);
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Exit a zone, its duration added to the statistics.
+  * @param  Zone Zone, 0 to BSP_PROBE_ZONES - 1.
+  * @retval None
+  */
+void BSP_PROBE_Exit(uint32_t Zone)
+{
+  BSP_PROBE_ZoneTypeDef *zone;
+  uint32_t primask_bit;
+  uint32_t cycles;
+  uint32_t duration;
+
+  if (Zone >= BSP_PROBE_ZONES)
+  {
+    return;
+  }
+
+  zone = &PROBE_Zones[Zone];
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  cycles = DWT->CYCCNT;
+  PROBE_Event(Zone, 1U, cycles);
+
+  duration = cycles - zone->Start;
+  zone->Count++;
+  zone->Total += duration;
+  if (duration < zone->Min)
+  {
+    zone->Min = duration;
+  }
+  if (duration > zone->Max)
+  {
+    zone->Max = duration;
+  }
+  zone->Bins[(duration == 0U) ? 0U : (31U - __CLZ(duration))]++;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Read the events of the ring, the oldest first.
+  * @param  pEvents Events read.
+  * @param  Size Events of pEvents.
+  * @retval Events read, removed from the ring
+  */
+uint32_t BSP_PROBE_ReadRing(BSP_PROBE_EventTypeDef *pEvents, uint32_t Size)
+{
+  uint32_t primask_bit;
+  uint32_t count = 0U;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  while ((count < Size) && (PROBE_Tail != PROBE_Head))
+  {
+    pEvents[count] = PROBE_Ring[PROBE_Tail & (BSP_PROBE_RING - 1U)];
+    PROBE_Tail++;
+    count++;
+  }
+  __set_PRIMASK(primask_bit);
+
+  return count;
+}
+
+/**
+  * @brief  Get the statistics of a zone.
+  * @param  Zone Zone, 0 to BSP_PROBE_ZONES - 1.
+  * @retval Zone, NULL for a zone out of range
+  */
+const BSP_PROBE_ZoneTypeDef *BSP_PROBE_GetZone(uint32_t Zone)
+{
+  if (Zone >= BSP_PROBE_ZONES)
+  {
+    return NULL;
+  }
+
+  return &PROBE_Zones[Zone];
+}
+
+/**
+  * @brief  Clear the statistics of the zones and the ring.
+  * @retval None
+  */
+void BSP_PROBE_Reset(void)
+{
+  uint32_t primask_bit;
+  uint32_t zone;
+  uint32_t bin;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (zone = 0U; zone < BSP_PROBE_ZONES; zone++)
+  {
+    PROBE_Zones[zone].Count = 0U;
+    PROBE_Zones[zone].Min   = 0xFFFFFFFFU;
+    PROBE_Zones[zone].Max   = 0U;
+    PROBE_Zones[zone].Total = 0U;
+    for (bin = 0U; bin < BSP_PROBE_BINS; bin++)
+    {
+      PROBE_Zones[zone].Bins[bin] = 0U;
+    }
+  }
+  PROBE_Tail = PROBE_Head;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Print the statistics and the histogram of the zones with printf().
+  * @retval None
+  */
+void BSP_PROBE_Print(void)
+{
+  BSP_PROBE_ZoneTypeDef zone;
+  uint32_t primask_bit;
+  uint32_t mhz = SystemCoreClock / 1000000U;
+  uint32_t peak;
+  uint32_t bar;
+  uint32_t i;
+  uint32_t bin;
+
+  if (mhz == 0U)
+  {
+    mhz = 1U;
+  }
+
+  for (i = 0U; i < BSP_PROBE_ZONES; i++)
+  {
+    /* A consistent copy, the zone may run meanwhile */
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+    zone = PROBE_Zones[i];
+    __set_PRIMASK(primask_bit);
+    if (zone.Count == 0U)
+    {
+      continue;
+    }
+
+    if (zone.pName != NULL)
+    {
+      printf("probe %-16s", zone.pName);
+    }
+    else
+    {
+      printf("probe zone %-11lu", (unsigned long)i);
+    }
+    printf(" n %8lu min %8lu mean %8lu max %8lu cycles, max %6lu us\r\n", (unsigned long)zone.Count,
+           (unsigned long)zone.Min, (unsigned long)(zone.Total / zone.Count), (unsigned long)zone.Max,
+           (unsigned long)(zone.Max / mhz));
+
+    peak = 0U;
+    for (bin = 0U; bin < BSP_PROBE_BINS; bin++)
+    {
+      peak = (zone.Bins[bin] > peak) ? zone.Bins[bin] : peak;
+    }
+    for (bin = 0U; bin < BSP_PROBE_BINS; bin++)
+    {
+      if (zone.Bins[bin] != 0U)
+      {
+        printf("  >= %10lu %8lu ", (unsigned long)(1UL << bin), (unsigned long)zone.Bins[bin]);
+        for (bar = ((uint32_t)(((uint64_t)zone.Bins[bin] * PROBE_BAR + peak - 1U) / peak)); bar > 0U; bar--)
+        {
+          putchar('#');
+        }
+        printf("\r\n");
+      }
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PROBE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Output an event, the interrupts masked.
+  * @param  Zone Zone.
+  * @param  Exit 1 on an exit.
+  * @param  Cycles Cycle count of the event.
+  * @retval None
+  */
+static void PROBE_Event(uint32_t Zone, uint32_t Exit, uint32_t Cycles)
+{
+  BSP_PROBE_EventTypeDef *event;
+
+  if (((PROBE_Outputs & BSP_PROBE_OUTPUT_GPIO) != 0U) && (PROBE_Zones[Zone].GPIOx != NULL))
+  {
+    PROBE_Zones[Zone].GPIOx->BSRR = (Exit != 0U) ? (PROBE_Zones[Zone].GPIO_Pin << 16U) : PROBE_Zones[Zone].GPIO_Pin;
+  }
+
+  if ((PROBE_Outputs & BSP_PROBE_OUTPUT_RING) != 0U)
+  {
+    /* Full, the oldest event is replaced */
+    if ((PROBE_Head - PROBE_Tail) >= BSP_PROBE_RING)
+    {
+      PROBE_Tail++;
+    }
+    event = &PROBE_Ring[PROBE_Head & (BSP_PROBE_RING - 1U)];
+    event->Cycles = Cycles;
+    event->Zone   = (uint8_t)Zone;
+    event->Exit   = (uint8_t)Exit;
+    PROBE_Head++;
+  }
+
+  if (((PROBE_Outputs & BSP_PROBE_OUTPUT_ITM) != 0U) && ((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0U) &&
+      ((ITM->TER & (1UL << BSP_PROBE_ITM_PORT)) != 0U))
+  {
+    while (ITM->PORT[BSP_PROBE_ITM_PORT].u32 == 0U)
+    {
+    }
+    ITM->PORT[BSP_PROBE_ITM_PORT].u32 = (Zone << 24U) | ((Exit != 0U) ? PROBE_ITM_EXIT : 0U) |
+                                        (Cycles & PROBE_ITM_CYCLES);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
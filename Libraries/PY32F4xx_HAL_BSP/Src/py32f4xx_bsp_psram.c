@@ -0,0 +1,635 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_psram.c
+  * @author  MCU Application Team
+  * @brief   ESMC PSRAM BSP service.
+  *          This file provides functions to use a QSPI PSRAM connected to the
+  *          ESMC as an off-chip memory for large buffers:
+  *           + Reset and identification sequence of the common parts
+  *           + Memory-mapped reads through the ESMC window
+  *           + Writes in indirect mode, split at the page and CE low limits
+  *           + Block heap over the part, its maps kept in the internal SRAM
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Set the ClockPrescaler, ClockMode ESMC_CLOCK_MODE_0 and DualFlash
+       ESMC_DUALFLASH_DISABLE of the ESMC handle. HAL_ESMC_MspInit() enables
+       the ESMC clock and configures its pins. After the system clock setup,
+       call BSP_PSRAM_Init() with the chip select and a part of
+       @ref BSP_PSRAM_Part: it resets the part, checks its known good die ID
+       and maps it at ESMC_XIP_BASE with the 1-4-4 fast read EBh.
+
+   (#) The memory-mapped mode of the ESMC has a read command only. Read the
+       PSRAM through pointers to the window, write it with BSP_PSRAM_Write(),
+       which leaves the memory-mapped mode for the time of the 1-4-4 quad
+       writes 38h. A write is split at the 1 Kbyte page of the part and at the
+       bytes sent within BSP_PSRAM_CE_MAX_US, needed by the refresh of the
+       array. A store to the window does not reach the part.
+
+   (#) No access to the window is allowed during BSP_PSRAM_Write(): do not read
+       the PSRAM from an interrupt handler that may preempt it.
+
+   (#) Static buffers placed with __PSRAM_DATA go to the .psram section of the
+       linker script, not initialized by the startup. BSP_PSRAM_Malloc() and
+       BSP_PSRAM_Free() manage the rest of the part in BSP_PSRAM_BLOCK_SIZE
+       blocks, first fit. The block maps of the handle take
+       2 * BSP_PSRAM_BLOCKS bits of internal SRAM.
+
+   (#) The window is shared with the external flash of DATA_IN_ExtFlash: one
+       device is mapped at a time, and the linker fails when both the
+       .extflash and the .psram sections are not empty.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_psram.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PSRAM BSP PSRAM
+  * @brief ESMC PSRAM BSP service
+  * @{
+  */
+
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Private_Types BSP PSRAM Private Types
+  * @{
+  */
+
+/**
+  * @brief  Geometry of a part
+  */
+typedef struct
+{
+  uint32_t Size;      /* Size of the part, bytes        */
+  uint32_t PageSize;  /* Wrap boundary of a burst       */
+} PSRAM_PartTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Private_Constants BSP PSRAM Private Constants
+  * @{
+  */
+#define PSRAM_CMD_RESET_ENABLE          0x66U          /* Reset enable              */
+#define PSRAM_CMD_RESET                 0x99U          /* Reset                     */
+#define PSRAM_CMD_READ_ID               0x9FU          /* Read ID, 24-bit address   */
+#define PSRAM_CMD_QUAD_READ             0xEBU          /* Fast quad read, 1-4-4     */
+#define PSRAM_CMD_QUAD_WRITE            0x38U          /* Quad write, 1-4-4         */
+
+#define PSRAM_QUAD_READ_DUMMY           6U             /* Wait cycles of EBh        */
+#define PSRAM_KGD_PASS                  0x5DU          /* Known good die ID of a part passing its test */
+
+#define PSRAM_WRITE_HEADER_CYCLES       14U            /* Instruction and quad address of 38h */
+#define PSRAM_PART_COUNT                3U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Private_Variables BSP PSRAM Private Variables
+  * @{
+  */
+static const PSRAM_PartTypeDef PSRAM_Parts[PSRAM_PART_COUNT] =
+{
+  {0x00200000U, 1024U},   /* BSP_PSRAM_PART_APS1604   */
+  {0x00800000U, 1024U},   /* BSP_PSRAM_PART_APS6404   */
+  {0x00800000U, 1024U}    /* BSP_PSRAM_PART_LY68L6400 */
+};
+
+/* End of the .psram section of the linker script */
+extern uint8_t _epsram[];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_PSRAM_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef PSRAM_Instruction(BSP_PSRAM_TypeDef *hpsram, uint32_t Instruction);
+static HAL_StatusTypeDef PSRAM_ReadId(BSP_PSRAM_TypeDef *hpsram);
+static HAL_StatusTypeDef PSRAM_Map(BSP_PSRAM_TypeDef *hpsram);
+static HAL_StatusTypeDef PSRAM_Unmap(BSP_PSRAM_TypeDef *hpsram);
+static uint32_t PSRAM_TestBit(const uint32_t *Map, uint32_t Block);
+static void PSRAM_SetBits(uint32_t *Map, uint32_t Block, uint32_t Count);
+static void PSRAM_ClearBits(uint32_t *Map, uint32_t Block, uint32_t Count);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PSRAM_Exported_Functions BSP PSRAM Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_PSRAM_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Reset a PSRAM, check it and map it
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Reset and identify a PSRAM, map it and initialize its heap.
+  * @note   The ESMC is initialized with HAL_ESMC_Init() when its state is
+  *         reset. The write burst is computed from the current HCLK: call it
+  *         after the system clock setup, a new call empties the heap.
+  *         SysTick must run.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @param  hesmc Pointer to an ESMC_HandleTypeDef structure, Init filled.
+  * @param  CSPinSel Chip select of the PSRAM, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Part Part connected, a value of @ref BSP_PSRAM_Part.
+  * @retval HAL status, HAL_ERROR when the part does not answer a good die ID
+  */
+HAL_StatusTypeDef BSP_PSRAM_Init(BSP_PSRAM_TypeDef *hpsram, ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel,
+                                 uint32_t Part)
+{
+  HAL_StatusTypeDef status;
+  uint32_t cycles;
+  uint32_t heap;
+  uint32_t word;
+
+  if ((hpsram == NULL) || (hesmc == NULL) || (Part >= PSRAM_PART_COUNT) ||
+      (PSRAM_Parts[Part].Size > BSP_PSRAM_SIZE_MAX) ||
+      ((uint32_t)_epsram > (ESMC_XIP_BASE + PSRAM_Parts[Part].Size)) ||
+      (hesmc->Init.ClockPrescaler == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* SCK cycles within the CE low time, less the 38h header, two per byte */
+  cycles = (HAL_RCC_GetHCLKFreq() / hesmc->Init.ClockPrescaler / 1000000U) * BSP_PSRAM_CE_MAX_US;
+  if (cycles <= PSRAM_WRITE_HEADER_CYCLES)
+  {
+    return HAL_ERROR;
+  }
+
+  hpsram->hesmc    = hesmc;
+  hpsram->CSPinSel = CSPinSel;
+  hpsram->Size     = PSRAM_Parts[Part].Size;
+  hpsram->PageSize = PSRAM_Parts[Part].PageSize;
+  hpsram->MaxBurst = (cycles - PSRAM_WRITE_HEADER_CYCLES) / 2U;
+  if (hpsram->MaxBurst > hpsram->PageSize)
+  {
+    hpsram->MaxBurst = hpsram->PageSize;
+  }
+
+  if (hesmc->State == HAL_ESMC_STATE_RESET)
+  {
+    status = HAL_ESMC_Init(hesmc);
+  }
+  else
+  {
+    status = PSRAM_Unmap(hpsram);
+  }
+
+  /* Power-up time of the part, 150 us */
+  HAL_Delay(1U);
+
+  if (status == HAL_OK)
+  {
+    status = PSRAM_Instruction(hpsram, PSRAM_CMD_RESET_ENABLE);
+  }
+  if (status == HAL_OK)
+  {
+    status = PSRAM_Instruction(hpsram, PSRAM_CMD_RESET);
+  }
+  if (status == HAL_OK)
+  {
+    status = PSRAM_ReadId(hpsram);
+  }
+  if ((status == HAL_OK) && (hpsram->KgdId != PSRAM_KGD_PASS))
+  {
+    status = HAL_ERROR;
+  }
+  if (status == HAL_OK)
+  {
+    status = PSRAM_Map(hpsram);
+  }
+  if (status != HAL_OK)
+  {
+    hpsram->hesmc = NULL;
+    return status;
+  }
+
+  /* Heap over the part after the static buffers */
+  heap = ((uint32_t)_epsram + BSP_PSRAM_BLOCK_SIZE - 1U) & ~(BSP_PSRAM_BLOCK_SIZE - 1U);
+  hpsram->HeapBase   = (uint8_t *)heap;
+  hpsram->HeapBlocks = (heap < (ESMC_XIP_BASE + hpsram->Size)) ?
+                       ((ESMC_XIP_BASE + hpsram->Size - heap) / BSP_PSRAM_BLOCK_SIZE) : 0U;
+  hpsram->FreeBlocks = hpsram->HeapBlocks;
+  for (word = 0U; word < BSP_PSRAM_MAP_WORDS; word++)
+  {
+    hpsram->UsedMap[word]  = 0U;
+    hpsram->StartMap[word] = 0U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PSRAM_Exported_Functions_Group2 IO functions
+  * @brief    IO functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### IO functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Write the PSRAM, read through the window
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Write a buffer to the PSRAM.
+  * @note   The window is unmapped for the time of the write.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @param  pDest Destination in the window, from a __PSRAM_DATA object or BSP_PSRAM_Malloc().
+  * @param  pSrc Source buffer, out of the window.
+  * @param  Size Number of bytes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PSRAM_Write(BSP_PSRAM_TypeDef *hpsram, void *pDest, const void *pSrc, uint32_t Size)
+{
+  ESMC_CommandTypeDef cmd;
+  HAL_StatusTypeDef status;
+  const uint8_t *psrc = (const uint8_t *)pSrc;
+  uint32_t address;
+  uint32_t chunk;
+
+  if ((hpsram->hesmc == NULL) || (pSrc == NULL) || (Size == 0U) ||
+      ((uint32_t)pDest < ESMC_XIP_BASE) ||
+      (((uint32_t)pDest - ESMC_XIP_BASE) > hpsram->Size) ||
+      (Size > (hpsram->Size - ((uint32_t)pDest - ESMC_XIP_BASE))))
+  {
+    return HAL_ERROR;
+  }
+
+  address = (uint32_t)pDest - ESMC_XIP_BASE;
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_QUAD;
+  cmd.Instruction       = PSRAM_CMD_QUAD_WRITE;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_MULTI_LINES;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByte     = 0U;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_WRITE;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.DummyCycles       = 0U;
+  cmd.CSPinSel          = hpsram->CSPinSel;
+
+  status = PSRAM_Unmap(hpsram);
+
+  while ((status == HAL_OK) && (Size != 0U))
+  {
+    /* A burst wraps at the end of its page */
+    chunk = hpsram->PageSize - (address & (hpsram->PageSize - 1U));
+    if (chunk > hpsram->MaxBurst)
+    {
+      chunk = hpsram->MaxBurst;
+    }
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+
+    cmd.Address = address;
+    cmd.NbData  = chunk;
+    status = HAL_ESMC_Command(hpsram->hesmc, &cmd, BSP_PSRAM_TIMEOUT);
+    if (status == HAL_OK)
+    {
+      status = HAL_ESMC_Transmit(hpsram->hesmc, (uint8_t *)psrc, BSP_PSRAM_TIMEOUT);
+    }
+
+    address += chunk;
+    psrc    += chunk;
+    Size    -= chunk;
+  }
+
+  if (status == HAL_OK)
+  {
+    status = PSRAM_Map(hpsram);
+  }
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_PSRAM_Exported_Functions_Group3 Heap functions
+  * @brief    Heap functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Heap functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Allocate and free buffers in the PSRAM
+      (+) Get the free size of the heap
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Allocate a buffer in the PSRAM.
+  * @note   Not reentrant: serialize the callers.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @param  Size Number of bytes, rounded up to BSP_PSRAM_BLOCK_SIZE.
+  * @retval Buffer in the window aligned on BSP_PSRAM_BLOCK_SIZE, NULL when no run of free blocks fits
+  */
+void *BSP_PSRAM_Malloc(BSP_PSRAM_TypeDef *hpsram, uint32_t Size)
+{
+  uint32_t count;
+  uint32_t block;
+  uint32_t run = 0U;
+
+  if ((hpsram->hesmc == NULL) || (Size == 0U) || (Size > (hpsram->HeapBlocks * BSP_PSRAM_BLOCK_SIZE)))
+  {
+    return NULL;
+  }
+
+  count = (Size + BSP_PSRAM_BLOCK_SIZE - 1U) / BSP_PSRAM_BLOCK_SIZE;
+  if (count > hpsram->FreeBlocks)
+  {
+    return NULL;
+  }
+
+  for (block = 0U; block < hpsram->HeapBlocks; block++)
+  {
+    run = (PSRAM_TestBit(hpsram->UsedMap, block) != 0U) ? 0U : (run + 1U);
+    if (run == count)
+    {
+      block = block + 1U - count;
+      PSRAM_SetBits(hpsram->UsedMap, block, count);
+      PSRAM_SetBits(hpsram->StartMap, block, 1U);
+      hpsram->FreeBlocks -= count;
+      return hpsram->HeapBase + (block * BSP_PSRAM_BLOCK_SIZE);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Free a buffer of BSP_PSRAM_Malloc().
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @param  ptr Buffer returned by BSP_PSRAM_Malloc().
+  * @retval HAL status, HAL_ERROR when ptr is not an allocated buffer
+  */
+HAL_StatusTypeDef BSP_PSRAM_Free(BSP_PSRAM_TypeDef *hpsram, void *ptr)
+{
+  uint32_t offset;
+  uint32_t block;
+  uint32_t end;
+
+  if ((hpsram->hesmc == NULL) || ((uint8_t *)ptr < hpsram->HeapBase))
+  {
+    return HAL_ERROR;
+  }
+
+  offset = (uint32_t)((uint8_t *)ptr - hpsram->HeapBase);
+  block  = offset / BSP_PSRAM_BLOCK_SIZE;
+  if (((offset & (BSP_PSRAM_BLOCK_SIZE - 1U)) != 0U) || (block >= hpsram->HeapBlocks) ||
+      (PSRAM_TestBit(hpsram->StartMap, block) == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The allocation ends before the next start or free block */
+  end = block + 1U;
+  while ((end < hpsram->HeapBlocks) && (PSRAM_TestBit(hpsram->UsedMap, end) != 0U) &&
+         (PSRAM_TestBit(hpsram->StartMap, end) == 0U))
+  {
+    end++;
+  }
+
+  PSRAM_ClearBits(hpsram->StartMap, block, 1U);
+  PSRAM_ClearBits(hpsram->UsedMap, block, end - block);
+  hpsram->FreeBlocks += end - block;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the number of free bytes of the heap.
+  * @note   A buffer of this size may not fit, the free blocks being split.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @retval Free bytes
+  */
+uint32_t BSP_PSRAM_GetFreeSize(const BSP_PSRAM_TypeDef *hpsram)
+{
+  return hpsram->FreeBlocks * BSP_PSRAM_BLOCK_SIZE;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PSRAM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Send an instruction without address or data.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @param  Instruction Command of the part.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PSRAM_Instruction(BSP_PSRAM_TypeDef *hpsram, uint32_t Instruction)
+{
+  ESMC_CommandTypeDef cmd = {0};
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = Instruction;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_NONE;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_NONE;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = hpsram->CSPinSel;
+
+  return HAL_ESMC_Command(hpsram->hesmc, &cmd, BSP_PSRAM_TIMEOUT);
+}
+
+/**
+  * @brief  Read the manufacturer and known good die IDs.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PSRAM_ReadId(BSP_PSRAM_TypeDef *hpsram)
+{
+  ESMC_CommandTypeDef cmd = {0};
+  HAL_StatusTypeDef status;
+  uint8_t id[2];
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = PSRAM_CMD_READ_ID;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.Address           = 0U;
+  cmd.AddressMode       = ESMC_ADDRESS_SINGLE_LINE;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_READ;
+  cmd.NbData            = sizeof(id);
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = hpsram->CSPinSel;
+
+  status = HAL_ESMC_Command(hpsram->hesmc, &cmd, BSP_PSRAM_TIMEOUT);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Receive(hpsram->hesmc, id, BSP_PSRAM_TIMEOUT);
+  }
+  if (status == HAL_OK)
+  {
+    hpsram->ManufacturerId = id[0];
+    hpsram->KgdId          = id[1];
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Map the PSRAM in the window with the fast quad read.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PSRAM_Map(BSP_PSRAM_TypeDef *hpsram)
+{
+  ESMC_CommandTypeDef cmd = {0};
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_QUAD;
+  cmd.Instruction       = PSRAM_CMD_QUAD_READ;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_MULTI_LINES;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_READ;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.DummyCycles       = PSRAM_QUAD_READ_DUMMY;
+  cmd.CSPinSel          = hpsram->CSPinSel;
+
+  return HAL_ESMC_MemoryMapped(hpsram->hesmc, &cmd);
+}
+
+/**
+  * @brief  Leave the memory-mapped mode when it is on.
+  * @param  hpsram Pointer to a BSP_PSRAM_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef PSRAM_Unmap(BSP_PSRAM_TypeDef *hpsram)
+{
+  if (hpsram->hesmc->State == HAL_ESMC_STATE_BUSY_MEM_MAPPED)
+  {
+    return HAL_ESMCEx_DisableXIP(hpsram->hesmc);
+  }
+
+  return (hpsram->hesmc->State == HAL_ESMC_STATE_READY) ? HAL_OK : HAL_BUSY;
+}
+
+/**
+  * @brief  Read the bit of a block.
+  * @param  Map Block map.
+  * @param  Block Block index.
+  * @retval Bit value
+  */
+static uint32_t PSRAM_TestBit(const uint32_t *Map, uint32_t Block)
+{
+  return (Map[Block / 32U] >> (Block % 32U)) & 1U;
+}
+
+/**
+  * @brief  Set the bits of a run of blocks.
+  * @param  Map Block map.
+  * @param  Block First block index.
+  * @param  Count Number of blocks.
+  * @retval None
+  */
+static void PSRAM_SetBits(uint32_t *Map, uint32_t Block, uint32_t Count)
+{
+  while (Count != 0U)
+  {
+    Map[Block / 32U] |= 1UL << (Block % 32U);
+    Block++;
+    Count--;
+  }
+}
+
+/**
+  * @brief  Clear the bits of a run of blocks.
+  * @param  Map Block map.
+  * @param  Block First block index.
+  * @param  Count Number of blocks.
+  * @retval None
+  */
+static void PSRAM_ClearBits(uint32_t *Map, uint32_t Block, uint32_t Count)
+{
+  while (Count != 0U)
+  {
+    Map[Block / 32U] &= ~(1UL << (Block % 32U));
+    Block++;
+    Count--;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
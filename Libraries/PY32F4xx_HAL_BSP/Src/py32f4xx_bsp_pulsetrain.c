@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pulsetrain.c
+  * @author  MCU Application Team
+  * @brief   Pulse train generator BSP service.
+  *          This file provides functions to output a profile of pulses on
+  *          channel 1 of an advanced timer:
+  *           + Steps of 1 to 256 pulses of the same period and width
+  *           + ARR, RCR and CCR1 of the next step loaded by a DMA burst on
+  *             each update of the repetition counter
+  *           + One-pulse mode ending the profile, one DMA interrupt and
+  *             one update interrupt per profile, none per step
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize TIM1 or TIM8 with HAL_TIM_PWM_Init(), counting up with the
+       preload of ARR enabled, the prescaler setting the tick of the steps.
+       Link a DMA channel to the update with __HAL_LINKDMA(), TIM_DMA_ID_UPDATE,
+       in normal mode, memory to peripheral, words on both sides, memory
+       increment. Enable the interrupts of the DMA channel, calling
+       HAL_DMA_IRQHandler(), and of the update of the timer, TIM1_UP_IRQn,
+       calling BSP_PULSETRAIN_IRQHandler(). BSP_PULSETRAIN_Init() configures
+       channel 1 in PWM mode 1, CCR1 preloaded.
+
+   (#) A profile is a table of BSP_PULSETRAIN_StepTypeDef: Repetition + 1
+       pulses of Period + 1 ticks, active during Pulse ticks at the start of
+       each period. An acceleration ramp is a table of decreasing periods,
+       computed once. The table ends with a step of Pulse 0, at least 2 steps
+       in all. The table is kept by the service until the end of the profile.
+
+   (#) BSP_PULSETRAIN_Start() loads the first step, preloads the second one,
+       and starts the DMA on DMAR with the others. On each update, the
+       repetition counter at the end of a step, the DMA writes ARR, RCR and
+       CCR1 of the step after the next in one burst. The DMA interrupt, at
+       the start of the last step with pulses, sets the one-pulse mode: the
+       counter stops at the end of that step, or of the last step without
+       pulse when the interrupt is late. The update interrupt then calls
+       BSP_PULSETRAIN_CpltCallback(). The steps run timed by the hardware
+       only, whatever the latency of the interrupts.
+
+   (#) BSP_PULSETRAIN_Stop() abandons a profile at once, the output is left
+       inactive. A DMA error stops it as well and calls
+       BSP_PULSETRAIN_ErrorCallback().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_pulsetrain.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PULSETRAIN BSP PULSETRAIN
+  * @brief Pulse train generator BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Private_Constants BSP PULSETRAIN Private Constants
+  * @{
+  */
+#define PULSETRAIN_WORDS                3U             /* ARR, RCR and CCR1, a step */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Private_Macros BSP PULSETRAIN Private Macros
+  * @{
+  */
+#define PULSETRAIN_INDEX(__INSTANCE__)  (((__INSTANCE__) == TIM1) ? 0U : 1U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Private_Variables BSP PULSETRAIN Private Variables
+  * @{
+  */
+/* Generator of TIM1 and TIM8, found from the DMA callbacks */
+static BSP_PULSETRAIN_TypeDef *PULSETRAIN_Handles[2];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Private_Functions BSP PULSETRAIN Private Functions
+  * @{
+  */
+static void PULSETRAIN_Load(TIM_TypeDef *Instance, const BSP_PULSETRAIN_StepTypeDef *pStep);
+static void PULSETRAIN_End(BSP_PULSETRAIN_TypeDef *htrain);
+static void PULSETRAIN_Halt(BSP_PULSETRAIN_TypeDef *htrain);
+static void PULSETRAIN_DMACplt(DMA_HandleTypeDef *hdma);
+static void PULSETRAIN_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PULSETRAIN_Exported_Functions BSP PULSETRAIN Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a pulse train generator on channel 1 of TIM1 or TIM8.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @param  htim TIM handle, PWM initialized, update DMA channel linked.
+  * @param  OCPolarity Active level of the pulses, a value of @ref TIM_Output_Compare_Polarity.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PULSETRAIN_Init(BSP_PULSETRAIN_TypeDef *htrain, TIM_HandleTypeDef *htim, uint32_t OCPolarity)
+{
+  TIM_OC_InitTypeDef oc = {0};
+  DMA_HandleTypeDef *hdma;
+
+  if ((htrain == NULL) || (htim == NULL) || !IS_TIM_REPETITION_COUNTER_INSTANCE(htim->Instance) ||
+      !IS_TIM_OC_POLARITY(OCPolarity))
+  {
+    return HAL_ERROR;
+  }
+
+  hdma = htim->hdma[TIM_DMA_ID_UPDATE];
+  if ((hdma == NULL) || (hdma->Init.Mode != DMA_NORMAL) || (hdma->Init.Direction != DMA_MEMORY_TO_PERIPH) ||
+      (hdma->Init.PeriphDataAlignment != DMA_PDATAALIGN_WORD) ||
+      (hdma->Init.MemDataAlignment != DMA_MDATAALIGN_WORD) ||
+      (htim->Init.CounterMode != TIM_COUNTERMODE_UP) ||
+      (htim->Init.AutoReloadPreload != TIM_AUTORELOAD_PRELOAD_ENABLE))
+  {
+    return HAL_ERROR;
+  }
+
+  if (htrain->State == BSP_PULSETRAIN_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  oc.OCMode       = TIM_OCMODE_PWM1;
+  oc.Pulse        = 0U;
+  oc.OCPolarity   = OCPolarity;
+  oc.OCNPolarity  = TIM_OCNPOLARITY_HIGH;
+  oc.OCFastMode   = TIM_OCFAST_DISABLE;
+  oc.OCIdleState  = (OCPolarity == TIM_OCPOLARITY_HIGH) ? TIM_OCIDLESTATE_RESET : TIM_OCIDLESTATE_SET;
+  oc.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if (HAL_TIM_PWM_ConfigChannel(htim, &oc, TIM_CHANNEL_1) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  htrain->htim       = htim;
+  htrain->hdma       = hdma;
+  htrain->pSteps     = NULL;
+  htrain->NbrOfSteps = 0U;
+  htrain->State      = BSP_PULSETRAIN_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a profile.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @param  pSteps Steps, the last one of Pulse 0, kept until the end.
+  * @param  NbrOfSteps Steps, 2 to BSP_PULSETRAIN_STEPS_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PULSETRAIN_Start(BSP_PULSETRAIN_TypeDef *htrain, const BSP_PULSETRAIN_StepTypeDef *pSteps,
+                                       uint32_t NbrOfSteps)
+{
+  TIM_TypeDef *tim;
+  DMA_HandleTypeDef *hdma;
+  uint32_t i;
+
+  if ((pSteps == NULL) || (NbrOfSteps < 2U) || (NbrOfSteps > BSP_PULSETRAIN_STEPS_MAX) ||
+      (pSteps[NbrOfSteps - 1U].Pulse != 0U))
+  {
+    return HAL_ERROR;
+  }
+  for (i = 0U; i < NbrOfSteps; i++)
+  {
+    if ((pSteps[i].Period == 0U) || (pSteps[i].Period > 0xFFFFU) ||
+        (pSteps[i].Repetition > BSP_PULSETRAIN_REPETITION_MAX) || (pSteps[i].Pulse > pSteps[i].Period))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  if ((htrain->State != BSP_PULSETRAIN_STATE_READY) && (htrain->State != BSP_PULSETRAIN_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  tim  = htrain->htim->Instance;
+  hdma = htrain->hdma;
+  htrain->pSteps     = pSteps;
+  htrain->NbrOfSteps = NbrOfSteps;
+  PULSETRAIN_Handles[PULSETRAIN_INDEX(tim)] = htrain;
+
+  /* Step 0 active, step 1 in the preload registers */
+  tim->CR1 &= ~(TIM_CR1_CEN | TIM_CR1_OPM);
+  tim->CNT = 0U;
+  PULSETRAIN_Load(tim, &pSteps[0]);
+  tim->EGR = TIM_EGR_UG;
+  PULSETRAIN_Load(tim, &pSteps[1]);
+  __HAL_TIM_CLEAR_FLAG(htrain->htim, TIM_FLAG_UPDATE);
+
+  if (NbrOfSteps > 2U)
+  {
+    /* Steps 2 and above, one burst at the end of each step */
+    hdma->XferCpltCallback     = PULSETRAIN_DMACplt;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferErrorCallback    = PULSETRAIN_DMAError;
+    if (HAL_DMA_Start_IT(hdma, (uint32_t)&pSteps[2], (uint32_t)&tim->DMAR,
+                         (NbrOfSteps - 2U) * PULSETRAIN_WORDS) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    tim->DCR = TIM_DMABASE_ARR | ((PULSETRAIN_WORDS - 1U) << TIM_DCR_DBL_Pos);
+    __HAL_TIM_ENABLE_DMA(htrain->htim, TIM_DMA_UPDATE);
+    htrain->State = BSP_PULSETRAIN_STATE_RUN;
+  }
+  else
+  {
+    /* Step 0 is the last one with pulses */
+    htrain->State = BSP_PULSETRAIN_STATE_RUN;
+    PULSETRAIN_End(htrain);
+  }
+
+  TIM_CCxChannelCmd(tim, TIM_CHANNEL_1, TIM_CCx_ENABLE);
+  __HAL_TIM_MOE_ENABLE(htrain->htim);
+  tim->CR1 |= TIM_CR1_CEN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Abandon the profile in progress, the output inactive.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PULSETRAIN_Stop(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  if (htrain->State != BSP_PULSETRAIN_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  PULSETRAIN_Halt(htrain);
+  htrain->State = BSP_PULSETRAIN_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Update interrupt, the end of the profile.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval None
+  */
+void BSP_PULSETRAIN_IRQHandler(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  if ((__HAL_TIM_GET_FLAG(htrain->htim, TIM_FLAG_UPDATE) != RESET) &&
+      (__HAL_TIM_GET_IT_SOURCE(htrain->htim, TIM_IT_UPDATE) != RESET))
+  {
+    __HAL_TIM_CLEAR_FLAG(htrain->htim, TIM_FLAG_UPDATE);
+
+    /* An update before the one-pulse mode was set is not the end */
+    if ((htrain->htim->Instance->CR1 & TIM_CR1_CEN) == 0U)
+    {
+      PULSETRAIN_Halt(htrain);
+      htrain->State = BSP_PULSETRAIN_STATE_READY;
+      BSP_PULSETRAIN_CpltCallback(htrain);
+    }
+  }
+}
+
+/**
+  * @brief  End of profile callback, the counter stopped.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_PULSETRAIN_CpltCallback(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrain);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_PULSETRAIN_CpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Error callback, the profile is stopped.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_PULSETRAIN_ErrorCallback(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrain);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_PULSETRAIN_ErrorCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PULSETRAIN_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Write a step in the preload registers.
+  * @param  Instance TIM instance.
+  * @param  pStep Step.
+  * @retval None
+  */
+static void PULSETRAIN_Load(TIM_TypeDef *Instance, const BSP_PULSETRAIN_StepTypeDef *pStep)
+{
+  Instance->ARR  = pStep->Period;
+  Instance->RCR  = pStep->Repetition;
+  Instance->CCR1 = pStep->Pulse;
+}
+
+/**
+  * @brief  Stop the counter at the next repetition update.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval None
+  */
+static void PULSETRAIN_End(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  __HAL_TIM_CLEAR_FLAG(htrain->htim, TIM_FLAG_UPDATE);
+  htrain->htim->Instance->CR1 |= TIM_CR1_OPM;
+  __HAL_TIM_ENABLE_IT(htrain->htim, TIM_IT_UPDATE);
+}
+
+/**
+  * @brief  Stop the counter, the DMA and the output.
+  * @param  htrain Pointer to a BSP_PULSETRAIN_TypeDef structure.
+  * @retval None
+  */
+static void PULSETRAIN_Halt(BSP_PULSETRAIN_TypeDef *htrain)
+{
+  TIM_TypeDef *tim = htrain->htim->Instance;
+
+  tim->CR1 &= ~TIM_CR1_CEN;
+  __HAL_TIM_DISABLE_IT(htrain->htim, TIM_IT_UPDATE);
+  __HAL_TIM_DISABLE_DMA(htrain->htim, TIM_DMA_UPDATE);
+  (void)HAL_DMA_Abort(htrain->hdma);
+  TIM_CCxChannelCmd(tim, TIM_CHANNEL_1, TIM_CCx_DISABLE);
+  tim->CR1 &= ~TIM_CR1_OPM;
+}
+
+/**
+  * @brief  DMA transfer complete callback, the last step with pulses started.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void PULSETRAIN_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_PULSETRAIN_TypeDef *htrain = PULSETRAIN_Handles[PULSETRAIN_INDEX(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  __HAL_TIM_DISABLE_DMA(htrain->htim, TIM_DMA_UPDATE);
+  PULSETRAIN_End(htrain);
+}
+
+/**
+  * @brief  DMA error callback, the profile is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void PULSETRAIN_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_PULSETRAIN_TypeDef *htrain = PULSETRAIN_Handles[PULSETRAIN_INDEX(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  PULSETRAIN_Halt(htrain);
+  htrain->State = BSP_PULSETRAIN_STATE_ERROR;
+  BSP_PULSETRAIN_ErrorCallback(htrain);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,300 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pwmdither.c
+  * @author  MCU Application Team
+  * @brief   PWM dithering BSP service.
+  *          This file provides functions to set the duty of PWM channels
+  *          with a resolution finer than one timer tick:
+  *           + Duty in 1/2^DitherBits of a tick, up to 8 extra bits
+  *           + CCRx of 2^DitherBits periods spread as a first order
+  *             sigma-delta of the fraction
+  *           + Table streamed by a BSP_TIMBURST burst on the update event,
+  *             no interrupt
+  *           + Change of duty in the order the DMA reads the table
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A duty of Duty / 2^DitherBits ticks is the CCRx Duty >> DitherBits on
+       some periods and one tick more on the others, the CCRx of the
+       2^DitherBits periods averaging to the fraction. The extra periods are
+       spread as evenly as possible, the residue moves to the frequency of
+       the PWM divided by 2^DitherBits at the lowest and is filtered with the
+       PWM. At 144 MHz and 100 kHz, ARR is 1439: 10.5 bits of the timer and
+       4 extra bits give 14.5 bits on a dither of 16 periods, 6.25 kHz.
+
+   (#) Initialize the timer and the channels in PWM mode as usual, with the
+       preload of the CCRx enabled. Link a DMA channel to the update request,
+       TIM_DMA_ID_UPDATE, in circular mode, memory to peripheral, with words
+       on both sides and memory increment. TIM1 and TIM8 add the complementary
+       outputs and the dead time.
+
+   (#) Call BSP_PWMDITHER_Init() with the first channel and the number of
+       consecutive channels dithered, one burst writes their CCRx on each
+       update. The table holds BSP_PWMDITHER_TABLE_SIZE(NbrOfChannels,
+       DitherBits) words. The duties start at 0.
+
+   (#) BSP_PWMDITHER_SetDuty() sets the duty of a channel, Index 0 for the
+       first one, from 0 to DutyMax, (ARR + 1) << DitherBits for 100 %. The
+       CCRx are written from the frame after the next burst, in the order of
+       the DMA: the DMA takes the last CCRx of the old duty then a whole
+       dither of the new one, the average of a dither is never a mix of both.
+       A single store writes each CCRx, the table can be written at any time.
+
+   (#) BSP_PWMDITHER_Start() starts the channels and the stream,
+       BSP_PWMDITHER_Stop() stops both.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_pwmdither.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PWMDITHER BSP PWMDITHER
+  * @brief PWM dithering BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_PWMDITHER_Private_Macros BSP PWMDITHER Private Macros
+  * @{
+  */
+/* TIM_CHANNEL_1 to TIM_CHANNEL_4 are 0, 4, 8 and 12 */
+#define PWMDITHER_CHANNEL(__HANDLE__, __INDEX__)  ((__HANDLE__)->FirstChannel + ((__INDEX__) << 2))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PWMDITHER_Private_Functions BSP PWMDITHER Private Functions
+  * @{
+  */
+static void PWMDITHER_Fill(BSP_PWMDITHER_TypeDef *hdither, uint32_t Index, uint32_t Duty, uint32_t Frame);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PWMDITHER_Exported_Functions BSP PWMDITHER Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the dithering of consecutive PWM channels of a timer.
+  * @param  hdither Pointer to a BSP_PWMDITHER_TypeDef structure.
+  * @param  htim TIM handle, initialized in PWM mode, DMA channel of the update
+  *         request linked.
+  * @param  FirstChannel TIM_CHANNEL_1 to TIM_CHANNEL_4.
+  * @param  NbrOfChannels Channels from FirstChannel, up to TIM_CHANNEL_4.
+  * @param  DitherBits Extra bits, 1 to BSP_PWMDITHER_BITS_MAX.
+  * @param  pTable BSP_PWMDITHER_TABLE_SIZE(NbrOfChannels, DitherBits) words.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PWMDITHER_Init(BSP_PWMDITHER_TypeDef *hdither, TIM_HandleTypeDef *htim, uint32_t FirstChannel,
+                                     uint32_t NbrOfChannels, uint32_t DitherBits, uint32_t *pTable)
+{
+  uint32_t first = FirstChannel >> 2;
+  uint32_t i;
+  HAL_StatusTypeDef status;
+
+  if ((hdither == NULL) || (htim == NULL) || ((FirstChannel & 3U) != 0U) || (first >= BSP_PWMDITHER_CHANNELS_MAX) ||
+      (NbrOfChannels == 0U) || ((first + NbrOfChannels) > BSP_PWMDITHER_CHANNELS_MAX) ||
+      (DitherBits == 0U) || (DitherBits > BSP_PWMDITHER_BITS_MAX) ||
+      ((((uint64_t)htim->Init.Period + 1U) << DitherBits) > 0xFFFFFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  status = BSP_TIMBURST_Init(&hdither->Burst, htim, TIM_DMABASE_CCR1 + first, TIM_DMA_UPDATE, NbrOfChannels,
+                             pTable, 1UL << DitherBits);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  hdither->FirstChannel  = FirstChannel;
+  hdither->NbrOfChannels = NbrOfChannels;
+  hdither->DitherBits    = DitherBits;
+  hdither->DutyMax       = (htim->Init.Period + 1U) << DitherBits;
+  for (i = 0U; i < NbrOfChannels; i++)
+  {
+    hdither->Duty[i] = 0U;
+    PWMDITHER_Fill(hdither, i, 0U, 0U);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the PWM outputs and the stream of the CCRx.
+  * @param  hdither Pointer to a BSP_PWMDITHER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PWMDITHER_Start(BSP_PWMDITHER_TypeDef *hdither)
+{
+  uint32_t i;
+
+  if (hdither->Burst.State != BSP_TIMBURST_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The first period of each channel, before the first update */
+  for (i = 0U; i < hdither->NbrOfChannels; i++)
+  {
+    __HAL_TIM_SET_COMPARE(hdither->Burst.htim, PWMDITHER_CHANNEL(hdither, i),
+                          hdither->Burst.pTable[i]);
+  }
+
+  if (BSP_TIMBURST_Start(&hdither->Burst) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < hdither->NbrOfChannels; i++)
+  {
+    if (HAL_TIM_PWM_Start(hdither->Burst.htim, PWMDITHER_CHANNEL(hdither, i)) != HAL_OK)
+    {
+      (void)BSP_TIMBURST_Stop(&hdither->Burst);
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the PWM outputs and the stream of the CCRx.
+  * @param  hdither Pointer to a BSP_PWMDITHER_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PWMDITHER_Stop(BSP_PWMDITHER_TypeDef *hdither)
+{
+  uint32_t i;
+
+  if (BSP_TIMBURST_Stop(&hdither->Burst) != HAL_OK)
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 0U; i < hdither->NbrOfChannels; i++)
+  {
+    (void)HAL_TIM_PWM_Stop(hdither->Burst.htim, PWMDITHER_CHANNEL(hdither, i));
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the duty of a channel.
+  * @note   Running, the new duty starts on the frame after the next burst.
+  * @param  hdither Pointer to a BSP_PWMDITHER_TypeDef structure.
+  * @param  Index Channel, 0 for FirstChannel, up to NbrOfChannels - 1.
+  * @param  Duty Duty in 1/2^DitherBits timer ticks, 0 to DutyMax.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PWMDITHER_SetDuty(BSP_PWMDITHER_TypeDef *hdither, uint32_t Index, uint32_t Duty)
+{
+  uint32_t frame = 0U;
+
+  if ((Index >= hdither->NbrOfChannels) || (Duty > hdither->DutyMax))
+  {
+    return HAL_ERROR;
+  }
+  if ((hdither->Burst.State != BSP_TIMBURST_STATE_READY) && (hdither->Burst.State != BSP_TIMBURST_STATE_RUN))
+  {
+    return HAL_BUSY;
+  }
+
+  if (hdither->Burst.State == BSP_TIMBURST_STATE_RUN)
+  {
+    /* The next burst may be in progress, start after it */
+    frame = (BSP_TIMBURST_GetFrame(&hdither->Burst) + 1U) & (hdither->Burst.Frames - 1U);
+  }
+  hdither->Duty[Index] = Duty;
+  PWMDITHER_Fill(hdither, Index, Duty, frame);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PWMDITHER_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Write the CCRx of a channel for a duty, in the order of the DMA.
+  * @param  hdither Pointer to a BSP_PWMDITHER_TypeDef structure.
+  * @param  Index Channel, 0 to NbrOfChannels - 1.
+  * @param  Duty Duty in 1/2^DitherBits timer ticks.
+  * @param  Frame First frame written, the dither starts on it.
+  * @retval None
+  */
+static void PWMDITHER_Fill(BSP_PWMDITHER_TypeDef *hdither, uint32_t Index, uint32_t Duty, uint32_t Frame)
+{
+  uint32_t frames = hdither->Burst.Frames;
+  uint32_t channels = hdither->NbrOfChannels;
+  uint32_t *table = hdither->Burst.pTable;
+  uint32_t base = Duty >> hdither->DitherBits;
+  uint32_t frac = Duty & (frames - 1U);
+  uint32_t acc = frames >> 1;
+  uint32_t n;
+
+  for (n = 0U; n < frames; n++)
+  {
+    /* First order sigma-delta, frac periods of base + 1 out of frames */
+    acc += frac;
+    if (acc >= frames)
+    {
+      acc -= frames;
+      table[(Frame * channels) + Index] = base + 1U;
+    }
+    else
+    {
+      table[(Frame * channels) + Index] = base;
+    }
+    Frame = (Frame + 1U) & (frames - 1U);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
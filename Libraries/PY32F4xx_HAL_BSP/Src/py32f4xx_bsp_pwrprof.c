@@ -0,0 +1,411 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_pwrprof.c
+  * @author  MCU Application Team
+  * @brief   Power profiling BSP service.
+  *          This file provides functions to account the time in each power
+  *          state in the field:
+  *           + RUN, SLEEP and STOP times from the RTC uptime clock
+  *           + CPU cycles in RUN from the DWT cycle counter
+  *           + Time enabled of the peripheral clocks tracked
+  *           + Report and printf() dump to compare builds
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Start the uptime clock with BSP_UPTIME_Init(): the RTC runs in the
+       SLEEP and STOP modes where SysTick and the DWT stop. Its
+       interpolation gives the short SLEEPs to the ns, without it they are
+       counted to the RTC clock cycle. Call BSP_PWRPROF_Init() with it.
+
+   (#) Surround every low-power mode entry with BSP_PWRPROF_Enter() and
+       BSP_PWRPROF_Exit(). With USE_HAL_PWR_MODE_HOOKS set to 1U in
+       py32f4xx_hal_conf.h, HAL_PWR_EnterSLEEPMode() and
+       HAL_PWR_EnterSTOPMode() call HAL_PWR_EnterModeCallback() and
+       HAL_PWR_ExitModeCallback(): implement them in the user file with
+       these two calls, the tickless idle, the DVFS idle and the LPCTX STOP
+       entry are then all accounted.
+
+   (#) After a STOP, BSP_PWRPROF_Exit() waits for the RTC registers to
+       resynchronize, up to two RTC clock cycles, before reading the time.
+
+   (#) BSP_PWRPROF_TrackClock() tracks the enable bits of a bus, up to
+       BSP_PWRPROF_CLOCKS bits, for instance RCC_APB1ENR_USART2EN on
+       BSP_PWRPROF_BUS_APB1. The enable registers are read at each
+       accounting, the RCC macros unchanged: a clock enabled between two
+       accountings counts from the second one. The STOP time is not
+       counted, all the peripheral clocks are off then.
+
+   (#) BSP_PWRPROF_Update() accounts up to now, call it from the main loop
+       at least every 2^32 CPU cycles, 29 s at 144 MHz, for the RUN cycles.
+       BSP_PWRPROF_GetReport() gives the times with the total and the RUN
+       duty, BSP_PWRPROF_Print() prints them with printf().
+       BSP_PWRPROF_Reset() starts a new measurement.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "py32f4xx_bsp_pwrprof.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_PWRPROF BSP PWRPROF
+  * @brief Power profiling BSP service
+  * @{
+  */
+
+#if defined (HAL_RTC_MODULE_ENABLED) && defined (HAL_PWR_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Private_Constants BSP PWRPROF Private Constants
+  * @{
+  */
+#define PWRPROF_BUSES                   4U
+#define PWRPROF_WAIT_LOOPS              0x00100000U    /* Polls of a flag, half a second on HSI       */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Private_Variables BSP PWRPROF Private Variables
+  * @{
+  */
+static const char *const PWRPROF_StateNames[BSP_PWRPROF_STATES] = {"run", "sleep", "stop"};
+static const char *const PWRPROF_BusNames[PWRPROF_BUSES] = {"ahb1", "ahb2", "apb1", "apb2"};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Private_Functions BSP PWRPROF Private Functions
+  * @{
+  */
+static void PWRPROF_ReadEnr(uint32_t *pEnr);
+static void PWRPROF_Account(BSP_PWRPROF_TypeDef *hprof);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_PWRPROF_Exported_Functions BSP PWRPROF Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Start the profiling in the RUN state.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @param  hup Uptime clock, BSP_UPTIME_Init() done.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_PWRPROF_Init(BSP_PWRPROF_TypeDef *hprof, BSP_UPTIME_TypeDef *hup)
+{
+  if ((hprof == NULL) || (hup == NULL) || (hup->hrtc == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  hprof->hup      = hup;
+  hprof->State    = BSP_PWRPROF_STATE_RUN;
+  hprof->NbClocks = 0U;
+  BSP_PWRPROF_Reset(hprof);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Track the enable bits of a bus.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @param  Bus A value of @ref BSP_PWRPROF_Bus.
+  * @param  Mask Enable bits in the RCC register of the bus, one clock per bit.
+  * @retval HAL status, HAL_ERROR when BSP_PWRPROF_CLOCKS are exceeded
+  */
+HAL_StatusTypeDef BSP_PWRPROF_TrackClock(BSP_PWRPROF_TypeDef *hprof, uint32_t Bus, uint32_t Mask)
+{
+  uint32_t primask_bit;
+  uint32_t bit;
+
+  if ((Bus >= PWRPROF_BUSES) || (Mask == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (bit = 0U; bit < 32U; bit++)
+  {
+    if ((Mask & (1UL << bit)) == 0U)
+    {
+      continue;
+    }
+    if (hprof->NbClocks >= BSP_PWRPROF_CLOCKS)
+    {
+      __set_PRIMASK(primask_bit);
+      return HAL_ERROR;
+    }
+    hprof->Clock[hprof->NbClocks].Bus  = Bus;
+    hprof->Clock[hprof->NbClocks].Mask = 1UL << bit;
+    hprof->Clock[hprof->NbClocks].Time = 0U;
+    hprof->NbClocks++;
+  }
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Clear the times and start a new measurement.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @retval None
+  */
+void BSP_PWRPROF_Reset(BSP_PWRPROF_TypeDef *hprof)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  uint32_t index;
+
+  __disable_irq();
+  for (index = 0U; index < BSP_PWRPROF_STATES; index++)
+  {
+    hprof->Report.Time[index]    = 0U;
+    hprof->Report.Entries[index] = 0U;
+  }
+  hprof->Report.RunCycles = 0U;
+  hprof->Report.Total     = 0U;
+  hprof->Report.Duty      = 0U;
+  for (index = 0U; index < hprof->NbClocks; index++)
+  {
+    hprof->Clock[index].Time = 0U;
+  }
+
+  hprof->Stamp      = BSP_UPTIME_GetNs(hprof->hup);
+  hprof->Start      = hprof->Stamp;
+  hprof->CycleStamp = DWT->CYCCNT;
+  PWRPROF_ReadEnr(hprof->Enr);
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Account the RUN state up to a low-power mode entry.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @param  Mode BSP_PWRPROF_STATE_SLEEP or BSP_PWRPROF_STATE_STOP.
+  * @retval None
+  */
+void BSP_PWRPROF_Enter(BSP_PWRPROF_TypeDef *hprof, uint32_t Mode)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  if ((Mode != BSP_PWRPROF_STATE_SLEEP) && (Mode != BSP_PWRPROF_STATE_STOP))
+  {
+    return;
+  }
+
+  __disable_irq();
+  PWRPROF_Account(hprof);
+  hprof->State = Mode;
+  hprof->Report.Entries[Mode]++;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Account the low-power mode up to the wakeup, back in the RUN state.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @retval None
+  */
+void BSP_PWRPROF_Exit(BSP_PWRPROF_TypeDef *hprof)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  RTC_TypeDef *rtc = hprof->hup->hrtc->Instance;
+  uint32_t loops = PWRPROF_WAIT_LOOPS;
+
+  __disable_irq();
+  if (hprof->State == BSP_PWRPROF_STATE_STOP)
+  {
+    /* The RTC registers read again once resynchronized */
+    CLEAR_BIT(rtc->CRL, RTC_CRL_RSF);
+    while (((rtc->CRL & RTC_CRL_RSF) == 0U) && (--loops != 0U))
+    {
+    }
+  }
+  PWRPROF_Account(hprof);
+  hprof->State      = BSP_PWRPROF_STATE_RUN;
+  hprof->Report.Entries[BSP_PWRPROF_STATE_RUN]++;
+  hprof->CycleStamp = DWT->CYCCNT;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Account the current state up to now.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @retval None
+  */
+void BSP_PWRPROF_Update(BSP_PWRPROF_TypeDef *hprof)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  PWRPROF_Account(hprof);
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Account up to now and get the report.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @param  pReport Report.
+  * @retval None
+  */
+void BSP_PWRPROF_GetReport(BSP_PWRPROF_TypeDef *hprof, BSP_PWRPROF_ReportTypeDef *pReport)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  PWRPROF_Account(hprof);
+  hprof->Report.Total = hprof->Stamp - hprof->Start;
+  hprof->Report.Duty  = (hprof->Report.Total == 0U) ? 0U :
+                        (uint32_t)((hprof->Report.Time[BSP_PWRPROF_STATE_RUN] * 1000U) / hprof->Report.Total);
+  *pReport = hprof->Report;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Get a peripheral clock tracked, its time as of the last accounting.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @param  Index Clock index, in the order of the BSP_PWRPROF_TrackClock() bits.
+  * @retval Clock, NULL for an index out of range
+  */
+const BSP_PWRPROF_ClockTypeDef *BSP_PWRPROF_GetClock(const BSP_PWRPROF_TypeDef *hprof, uint32_t Index)
+{
+  if (Index >= hprof->NbClocks)
+  {
+    return NULL;
+  }
+
+  return &hprof->Clock[Index];
+}
+
+/**
+  * @brief  Print the report and the peripheral clocks with printf().
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @retval None
+  */
+void BSP_PWRPROF_Print(BSP_PWRPROF_TypeDef *hprof)
+{
+  BSP_PWRPROF_ReportTypeDef report;
+  uint32_t share;
+  uint32_t index;
+
+  BSP_PWRPROF_GetReport(hprof, &report);
+
+  printf("pwr total %10lu ms, run %lu.%lu %%, %lu Mcycles\r\n",
+         (unsigned long)(report.Total / 1000000U),
+         (unsigned long)(report.Duty / 10U), (unsigned long)(report.Duty % 10U),
+         (unsigned long)(report.RunCycles / 1000000U));
+  for (index = 0U; index < BSP_PWRPROF_STATES; index++)
+  {
+    share = (report.Total == 0U) ? 0U : (uint32_t)((report.Time[index] * 1000U) / report.Total);
+    printf("pwr %-5s %10lu ms %3lu.%lu %% %10lu entries\r\n", PWRPROF_StateNames[index],
+           (unsigned long)(report.Time[index] / 1000000U),
+           (unsigned long)(share / 10U), (unsigned long)(share % 10U),
+           (unsigned long)report.Entries[index]);
+  }
+  for (index = 0U; index < hprof->NbClocks; index++)
+  {
+    printf("clk %-4s 0x%08lx %10lu ms\r\n", PWRPROF_BusNames[hprof->Clock[index].Bus],
+           (unsigned long)hprof->Clock[index].Mask,
+           (unsigned long)(hprof->Clock[index].Time / 1000000U));
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_PWRPROF_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read the RCC enable registers, in the order of @ref BSP_PWRPROF_Bus.
+  * @param  pEnr Registers read.
+  * @retval None
+  */
+static void PWRPROF_ReadEnr(uint32_t *pEnr)
+{
+  pEnr[BSP_PWRPROF_BUS_AHB1] = READ_REG(RCC->AHB1ENR);
+  pEnr[BSP_PWRPROF_BUS_AHB2] = READ_REG(RCC->AHB2ENR);
+  pEnr[BSP_PWRPROF_BUS_APB1] = READ_REG(RCC->APB1ENR);
+  pEnr[BSP_PWRPROF_BUS_APB2] = READ_REG(RCC->APB2ENR);
+}
+
+/**
+  * @brief  Add the time since the last accounting to the state and the clocks.
+  * @param  hprof Pointer to a BSP_PWRPROF_TypeDef structure.
+  * @retval None
+  */
+static void PWRPROF_Account(BSP_PWRPROF_TypeDef *hprof)
+{
+  uint64_t now = BSP_UPTIME_GetNs(hprof->hup);
+  uint64_t elapsed = (now > hprof->Stamp) ? (now - hprof->Stamp) : 0U;
+  uint32_t cycle;
+  uint32_t index;
+
+  hprof->Report.Time[hprof->State] += elapsed;
+
+  if (hprof->State == BSP_PWRPROF_STATE_RUN)
+  {
+    cycle = DWT->CYCCNT;
+    hprof->Report.RunCycles += cycle - hprof->CycleStamp;
+    hprof->CycleStamp = cycle;
+  }
+
+  /* The clocks enabled since the last accounting, all off in STOP mode */
+  if (hprof->State != BSP_PWRPROF_STATE_STOP)
+  {
+    for (index = 0U; index < hprof->NbClocks; index++)
+    {
+      if ((hprof->Enr[hprof->Clock[index].Bus] & hprof->Clock[index].Mask) != 0U)
+      {
+        hprof->Clock[index].Time += elapsed;
+      }
+    }
+  }
+
+  PWRPROF_ReadEnr(hprof->Enr);
+  hprof->Stamp = now;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED && HAL_PWR_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
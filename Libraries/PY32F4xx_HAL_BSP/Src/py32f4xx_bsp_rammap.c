@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_rammap.c
+  * @author  MCU Application Team
+  * @brief   SRAM layout BSP service.
+  *          This file provides functions to size the RAM buffers from the
+  *          device instead of fixed sizes:
+  *           + Geometry of the device and layout of the link
+  *           + Heap of malloc() bounded by the main stack
+  *           + Buffers taken from the end of the heap
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Select the device with MCU_TYPE, PY32F403xB, PY32F403xC or PY32F403xD:
+       the device header gives BSP_RAMMAP_SIZE and the linker script of the
+       device its RAM area. py32f403xx_sections.ld places the main stack,
+       STACK_SIZE bytes of the Makefile, at the end of the RAM and exports the
+       heap between the .bss and it, _sheap and _eheap: the heap is the rest of
+       the RAM of the device, nothing to edit from one variant to another.
+
+   (#) malloc() grows the heap through _sbrk() of this service, up to the
+       regions taken: it returns NULL instead of running into the stack.
+       BSP_RAMMAP_GetInfo() returns the layout, BSP_RAMMAP_GetFree() the bytes
+       left between the end of the malloc() heap and the regions taken.
+
+   (#) BSP_RAMMAP_Take() takes a region from the end of the heap for the life
+       of the application, with the alignment a DMA buffer needs: the
+       buffers of the services sized from what the device leaves, for
+       instance:
+         BSP_RAMMAP_Take(4096U, 32U, &rx);
+         BSP_RAMMAP_Take(BSP_RAMMAP_GetFree() / 2U, 0U, &frames);
+       A region is not given back. Size 0 takes all the free space, leaving
+       malloc() only what it already has.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <stddef.h>
+#include "py32f4xx_bsp_rammap.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_RAMMAP BSP RAMMAP
+  * @brief SRAM layout BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_RAMMAP_Private_Macros BSP RAMMAP Private Macros
+  * @{
+  */
+#define RAMMAP_ALIGN_UP(__ADDRESS__, __UNIT__)   (((__ADDRESS__) + (__UNIT__) - 1U) & ~((__UNIT__) - 1U))
+#define RAMMAP_ALIGN_DOWN(__ADDRESS__, __UNIT__) ((__ADDRESS__) & ~((__UNIT__) - 1U))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_RAMMAP_Private_Variables BSP RAMMAP Private Variables
+  * @{
+  */
+extern uint32_t _ebss[];    /* End of the .bss, from the linker script */
+extern uint32_t _sheap[];   /* Heap between the .bss and the main stack */
+extern uint32_t _eheap[];
+extern uint32_t _sstack[];  /* Bottom of the main stack */
+extern uint32_t _estack[];  /* End of the RAM */
+
+static uint8_t *RamMapBreak = (uint8_t *)_sheap;  /* End of the malloc() heap */
+static uint8_t *RamMapLimit = (uint8_t *)_eheap;  /* Start of the regions taken */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_RAMMAP_Exported_Functions BSP RAMMAP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Get the SRAM geometry and the layout of the link and of the heap.
+  * @param  pInfo Pointer to a BSP_RAMMAP_InfoTypeDef structure.
+  * @retval None
+  */
+void BSP_RAMMAP_GetInfo(BSP_RAMMAP_InfoTypeDef *pInfo)
+{
+  pInfo->Size       = BSP_RAMMAP_SIZE;
+  pInfo->StaticEnd  = (uint32_t)_ebss;
+  pInfo->HeapStart  = (uint32_t)_sheap;
+  pInfo->HeapBreak  = (uint32_t)RamMapBreak;
+  pInfo->HeapLimit  = (uint32_t)RamMapLimit;
+  pInfo->StackStart = (uint32_t)_sstack;
+  pInfo->StackEnd   = (uint32_t)_estack;
+}
+
+/**
+  * @brief  Get the free bytes of the heap.
+  * @retval Bytes between the end of the malloc() heap and the regions taken
+  */
+uint32_t BSP_RAMMAP_GetFree(void)
+{
+  return (uint32_t)(RamMapLimit - RamMapBreak);
+}
+
+/**
+  * @brief  Take a region from the end of the heap.
+  * @param  Size Size in bytes, rounded up to the alignment, 0 for all the
+  *         free space.
+  * @param  Alignment Alignment of the region, a power of 2, 0 for
+  *         BSP_RAMMAP_ALIGN.
+  * @param  pRegion Pointer to a BSP_RAMMAP_RegionTypeDef structure, the
+  *         region taken.
+  * @retval HAL status, HAL_ERROR when the free space is too small
+  */
+HAL_StatusTypeDef BSP_RAMMAP_Take(uint32_t Size, uint32_t Alignment, BSP_RAMMAP_RegionTypeDef *pRegion)
+{
+  uint32_t primask_bit;
+  uint32_t address;
+  uint32_t limit;
+  uint32_t brk;
+
+  if (Alignment < BSP_RAMMAP_ALIGN)
+  {
+    Alignment = BSP_RAMMAP_ALIGN;
+  }
+  if ((pRegion == NULL) || ((Alignment & (Alignment - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  limit = (uint32_t)RamMapLimit;
+  brk   = (uint32_t)RamMapBreak;
+  if (Size == 0U)
+  {
+    address = RAMMAP_ALIGN_UP(brk, Alignment);
+    Size    = (address < limit) ? (limit - address) : 0U;
+  }
+  else
+  {
+    Size    = RAMMAP_ALIGN_UP(Size, Alignment);
+    address = RAMMAP_ALIGN_DOWN(limit - Size, Alignment);
+    if ((Size == 0U) || (Size > (limit - brk)) || (address < brk))
+    {
+      Size = 0U;
+    }
+  }
+  if (Size == 0U)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_ERROR;
+  }
+  RamMapLimit = (uint8_t *)address;
+  __set_PRIMASK(primask_bit);
+
+  pRegion->Address = address;
+  pRegion->Size    = Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Grow or shrink the malloc() heap, in place of the one of libnosys.
+  * @param  Increment Bytes added to the heap, negative to give them back.
+  * @retval Previous end of the heap, (void *)-1 with errno ENOMEM when the
+  *         regions taken or the main stack would be reached
+  */
+void *_sbrk(ptrdiff_t Increment)
+{
+  uint32_t primask_bit;
+  uint8_t *previous;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  previous = RamMapBreak;
+  if ((Increment > 0) ? (Increment > (RamMapLimit - previous))
+                      : (-Increment > (previous - (uint8_t *)_sheap)))
+  {
+    __set_PRIMASK(primask_bit);
+    errno = ENOMEM;
+    return (void *)-1;
+  }
+  RamMapBreak = previous + Increment;
+  __set_PRIMASK(primask_bit);
+
+  return previous;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,624 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_regsnap.c
+  * @author  MCU Application Team
+  * @brief   Peripheral register snapshot BSP service.
+  *          This file provides functions to bring the peripherals back after
+  *          a STANDBY wakeup without their HAL initialization:
+  *           + Registers of GPIO, USART, SPI, TIM, ADC and DMA channels, clock
+  *             enables and NVIC saved to a flash sector after the first init
+  *           + Sector written only when the snapshot changes
+  *           + Key and checksum checked before the replay
+  *           + Replay in an order safe for the pins and the enable bits
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The STANDBY wakeup is a reset: the HAL_XXX_Init() and MSP callbacks of
+       each peripheral run again, with their timeouts and delays, before
+       useful work. Their result is a few hundred register values, this
+       service writes them back directly. The device has no backup SRAM and
+       its 42 backup registers are too small, the snapshot is kept in a flash
+       sector.
+
+   (#) Reserve a FLASH_SECTOR_SIZE sector, for instance with
+       BSP_FLASHMAP_Take(), and declare the peripherals in the order they are
+       to be restored, the GPIO ports and DMA channels before the peripherals
+       using them:
+       (+) { BSP_REGSNAP_TYPE_GPIO, GPIOA }, { BSP_REGSNAP_TYPE_DMA,
+           DMA1_Channel5 }, { BSP_REGSNAP_TYPE_USART, USART1 }...
+       (+) Call BSP_REGSNAP_Init() with the table, the sector and a key: the
+           firmware version or a hash of the configuration. A snapshot of
+           another key or of another table is not restored.
+
+   (#) At boot, after HAL_Init() and the clock configuration:
+       (+) On a STANDBY wakeup, __HAL_PWR_GET_FLAG(PWR_FLAG_SB), call
+           BSP_REGSNAP_Restore(). HAL_OK: the peripherals run as after their
+           initialization, skip it.
+       (+) Otherwise, or on HAL_ERROR, run the HAL initialization then
+           BSP_REGSNAP_Save() with a scratch buffer of
+           BSP_REGSNAP_GetBufferSize() bytes. The sector is erased and
+           written only when the snapshot differs from the one kept, it
+           does not wear out at each boot.
+
+   (#) The replay:
+       (+) checks the key, the size, the table and the checksum of the
+           snapshot,
+       (+) enables the peripheral clocks of the snapshot, those enabled
+           already are kept,
+       (+) writes the registers of each peripheral, its enable bit last:
+           output data before the mode of the pins, UE, SPE, CEN, ADON and
+           EN. A timer gets an update event before CEN to load its prescaler,
+           its flags cleared,
+       (+) sets the NVIC priorities and enables the interrupts of the
+           snapshot, their pending bits cleared.
+       RestoreCycles holds its length when the DWT cycle counter runs.
+
+   (#) Only the registers are restored:
+       (+) The HAL handles are in SRAM, lost in STANDBY. To use the HAL
+           functions after the replay, fill the Instance and Init of the
+           handle as before and set its state to ready, or drive the
+           registers directly.
+       (+) Save before the transfers start: the DMA counters and enable bits
+           of a transfer running would be replayed as such.
+       (+) The ADC calibration result is not writable, calibrate again when
+           the accuracy needs it. The ADC is powered by the replay, wait its
+           stabilization time before a conversion.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "py32f4xx_bsp_regsnap.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_REGSNAP BSP REGSNAP
+  * @brief Peripheral register snapshot BSP service
+  * @{
+  */
+
+#ifdef HAL_FLASH_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Private_Types BSP REGSNAP Private Types
+  * @{
+  */
+
+/**
+  * @brief  Registers of a peripheral type
+  */
+typedef struct
+{
+  const uint8_t           *pOffsets;    /*!< Register offsets in write order                        */
+
+  uint32_t                Count;        /*!< Number of registers                                    */
+
+  uint32_t                Late;         /*!< Last registers, written after the step of the type     */
+
+} REGSNAP_LayoutTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Private_Constants BSP REGSNAP Private Constants
+  * @{
+  */
+#define REGSNAP_MAGIC             0x504E5352U /*!< "RSNP"                                        */
+#define REGSNAP_HEADER_WORDS      4U          /*!< Magic, key, words, number of peripherals      */
+#define REGSNAP_RCC_WORDS         4U          /*!< AHB1, APB2, APB1 and AHB2 clock enables       */
+#define REGSNAP_IRQ_NUMBER        60U         /*!< External interrupts of the device             */
+#define REGSNAP_ISER_WORDS        ((REGSNAP_IRQ_NUMBER + 31U) / 32U) /*!< Interrupt enable words */
+#define REGSNAP_IPR_WORDS         ((REGSNAP_IRQ_NUMBER + 3U) / 4U)   /*!< Priority words         */
+#define REGSNAP_CHECK_WORDS       2U          /*!< Checksum words ending the snapshot            */
+#define REGSNAP_TYPE_NUMBER       6U          /*!< Peripheral types                              */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Private_Variables BSP REGSNAP Private Variables
+  * @{
+  */
+/* Output data, type, speed, pulls and alternate functions before the mode */
+static const uint8_t REGSNAP_GpioOffsets[] =
+{
+  offsetof(GPIO_TypeDef, ODR), offsetof(GPIO_TypeDef, OTYPER), offsetof(GPIO_TypeDef, OSPEEDR),
+  offsetof(GPIO_TypeDef, PUPDR), offsetof(GPIO_TypeDef, AFR[0]), offsetof(GPIO_TypeDef, AFR[1]),
+  offsetof(GPIO_TypeDef, MODER)
+};
+
+static const uint8_t REGSNAP_UsartOffsets[] =
+{
+  offsetof(USART_TypeDef, BRR), offsetof(USART_TypeDef, CR2), offsetof(USART_TypeDef, CR3),
+  offsetof(USART_TypeDef, GTPR), offsetof(USART_TypeDef, CR1)
+};
+
+static const uint8_t REGSNAP_SpiOffsets[] =
+{
+  offsetof(SPI_TypeDef, CR2), offsetof(SPI_TypeDef, CRCPR), offsetof(SPI_TypeDef, I2SPR),
+  offsetof(SPI_TypeDef, I2SCFGR), offsetof(SPI_TypeDef, CR1)
+};
+
+/* DIER and CR1 after the update event loading PSC */
+static const uint8_t REGSNAP_TimOffsets[] =
+{
+  offsetof(TIM_TypeDef, PSC), offsetof(TIM_TypeDef, ARR), offsetof(TIM_TypeDef, RCR),
+  offsetof(TIM_TypeDef, CCR1), offsetof(TIM_TypeDef, CCR2), offsetof(TIM_TypeDef, CCR3),
+  offsetof(TIM_TypeDef, CCR4), offsetof(TIM_TypeDef, CCMR1), offsetof(TIM_TypeDef, CCMR2),
+  offsetof(TIM_TypeDef, CCER), offsetof(TIM_TypeDef, BDTR), offsetof(TIM_TypeDef, SMCR),
+  offsetof(TIM_TypeDef, CR2), offsetof(TIM_TypeDef, DCR), offsetof(TIM_TypeDef, OR),
+  offsetof(TIM_TypeDef, DIER), offsetof(TIM_TypeDef, CR1)
+};
+
+static const uint8_t REGSNAP_AdcOffsets[] =
+{
+  offsetof(ADC_TypeDef, CR1), offsetof(ADC_TypeDef, SMPR1), offsetof(ADC_TypeDef, SMPR2),
+  offsetof(ADC_TypeDef, JOFR1), offsetof(ADC_TypeDef, JOFR2), offsetof(ADC_TypeDef, JOFR3),
+  offsetof(ADC_TypeDef, JOFR4), offsetof(ADC_TypeDef, HTR), offsetof(ADC_TypeDef, LTR),
+  offsetof(ADC_TypeDef, SQR1), offsetof(ADC_TypeDef, SQR2), offsetof(ADC_TypeDef, SQR3),
+  offsetof(ADC_TypeDef, JSQR), offsetof(ADC_TypeDef, CCSR), offsetof(ADC_TypeDef, CR2)
+};
+
+static const uint8_t REGSNAP_DmaOffsets[] =
+{
+  offsetof(DMA_Channel_TypeDef, CPAR), offsetof(DMA_Channel_TypeDef, CMAR), offsetof(DMA_Channel_TypeDef, CNDTR),
+  offsetof(DMA_Channel_TypeDef, CCR)
+};
+
+/* Indexed by the BSP_REGSNAP_TYPE_* values */
+static const REGSNAP_LayoutTypeDef REGSNAP_Layouts[REGSNAP_TYPE_NUMBER] =
+{
+  { REGSNAP_GpioOffsets,  sizeof(REGSNAP_GpioOffsets),  1U },
+  { REGSNAP_UsartOffsets, sizeof(REGSNAP_UsartOffsets), 1U },
+  { REGSNAP_SpiOffsets,   sizeof(REGSNAP_SpiOffsets),   1U },
+  { REGSNAP_TimOffsets,   sizeof(REGSNAP_TimOffsets),   2U },
+  { REGSNAP_AdcOffsets,   sizeof(REGSNAP_AdcOffsets),   1U },
+  { REGSNAP_DmaOffsets,   sizeof(REGSNAP_DmaOffsets),   1U }
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_REGSNAP_Private_Functions
+  * @{
+  */
+static void REGSNAP_Capture(const BSP_REGSNAP_TypeDef *hsnap, uint32_t *pImage);
+static void REGSNAP_Checksum(const uint32_t *pImage, uint32_t Words, uint32_t *pSum1, uint32_t *pSum2);
+static void REGSNAP_Replay(uint32_t Type, uint32_t Base, const uint32_t *pValues);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_REGSNAP_Exported_Functions BSP REGSNAP Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_REGSNAP_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Describe the peripherals of a snapshot and its sector
+      (+) Get the scratch buffer size of a save
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a snapshot.
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @param  pEntries Peripherals, in restore order.
+  * @param  EntryCount Number of peripherals.
+  * @param  Address First address of a FLASH_SECTOR_SIZE sector kept for the
+  *                 snapshot.
+  * @param  Key Firmware or configuration version.
+  * @retval HAL status, HAL_ERROR when the snapshot does not fit the sector
+  */
+HAL_StatusTypeDef BSP_REGSNAP_Init(BSP_REGSNAP_TypeDef *hsnap, const BSP_REGSNAP_EntryTypeDef *pEntries,
+                                   uint32_t EntryCount, uint32_t Address, uint32_t Key)
+{
+  uint32_t words;
+  uint32_t index;
+
+  if ((hsnap == NULL) || (pEntries == NULL) || (Address < FLASH_BASE) ||
+      (((Address - FLASH_BASE) % FLASH_SECTOR_SIZE) != 0U) ||
+      ((Address - FLASH_BASE) > (FLASH_SIZE - FLASH_SECTOR_SIZE)))
+  {
+    return HAL_ERROR;
+  }
+
+  words = REGSNAP_HEADER_WORDS + REGSNAP_RCC_WORDS + REGSNAP_ISER_WORDS + REGSNAP_IPR_WORDS + REGSNAP_CHECK_WORDS;
+  for (index = 0U; index < EntryCount; index++)
+  {
+    if ((pEntries[index].Type >= REGSNAP_TYPE_NUMBER) || (pEntries[index].Instance == NULL))
+    {
+      return HAL_ERROR;
+    }
+    words += 2U + REGSNAP_Layouts[pEntries[index].Type].Count;
+  }
+  if ((words * 4U) > FLASH_SECTOR_SIZE)
+  {
+    return HAL_ERROR;
+  }
+
+  hsnap->pEntries      = pEntries;
+  hsnap->EntryCount    = EntryCount;
+  hsnap->Address       = Address;
+  hsnap->Key           = Key;
+  hsnap->Words         = words;
+  hsnap->RestoreCycles = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the size of the scratch buffer of BSP_REGSNAP_Save().
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @retval Bytes, whole FLASH_PAGE_SIZE pages
+  */
+uint32_t BSP_REGSNAP_GetBufferSize(const BSP_REGSNAP_TypeDef *hsnap)
+{
+  return (((hsnap->Words * 4U) + FLASH_PAGE_SIZE - 1U) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_REGSNAP_Exported_Functions_Group2 Snapshot functions
+  * @brief    Snapshot functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Snapshot functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Save the registers to the flash sector
+      (+) Check and replay the snapshot kept
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Save the registers of the peripherals, the sector written only when
+  *         they changed.
+  * @note   Blocking, the CPU stalls on the flash for the erase and program
+  *         time when the sector is written.
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @param  pBuffer Scratch buffer, word aligned.
+  * @param  Size Bytes of pBuffer, BSP_REGSNAP_GetBufferSize() at least.
+  * @retval HAL status, HAL_ERROR when the flash does not read back the snapshot
+  */
+HAL_StatusTypeDef BSP_REGSNAP_Save(BSP_REGSNAP_TypeDef *hsnap, uint32_t *pBuffer, uint32_t Size)
+{
+  FLASH_EraseInitTypeDef erase;
+  const uint32_t *pFlash;
+  uint32_t pageError;
+  uint32_t offset;
+  uint32_t index;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if ((hsnap == NULL) || (hsnap->pEntries == NULL) || (pBuffer == NULL) ||
+      (Size < BSP_REGSNAP_GetBufferSize(hsnap)))
+  {
+    return HAL_ERROR;
+  }
+
+  REGSNAP_Capture(hsnap, pBuffer);
+
+  /* Nothing to write when the sector holds it already */
+  pFlash = (const uint32_t *)hsnap->Address;
+  for (index = 0U; index < hsnap->Words; index++)
+  {
+    if (pFlash[index] != pBuffer[index])
+    {
+      break;
+    }
+  }
+  if (index == hsnap->Words)
+  {
+    return HAL_OK;
+  }
+
+  for (index = hsnap->Words; index < (BSP_REGSNAP_GetBufferSize(hsnap) / 4U); index++)
+  {
+    pBuffer[index] = 0xFFFFFFFFU;
+  }
+
+  if (HAL_FLASH_Unlock() != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  erase.TypeErase     = FLASH_TYPEERASE_SECTORERASE;
+  erase.SectorAddress = hsnap->Address;
+  erase.NbSectors     = 1U;
+  status = HAL_FLASH_Erase(&erase, &pageError);
+  for (offset = 0U; (status == HAL_OK) && (offset < BSP_REGSNAP_GetBufferSize(hsnap)); offset += FLASH_PAGE_SIZE)
+  {
+    status = HAL_FLASH_PageProgram(hsnap->Address + offset, &pBuffer[offset / 4U]);
+  }
+  (void)HAL_FLASH_Lock();
+
+  if ((status == HAL_OK) && (BSP_REGSNAP_IsValid(hsnap) == 0U))
+  {
+    status = HAL_ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Check the snapshot kept in the sector.
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @retval 1 when its key, size, peripherals and checksum match, 0 otherwise
+  */
+uint32_t BSP_REGSNAP_IsValid(const BSP_REGSNAP_TypeDef *hsnap)
+{
+  const uint32_t *pImage = (const uint32_t *)hsnap->Address;
+  const uint32_t *pEntry;
+  uint32_t sum1;
+  uint32_t sum2;
+  uint32_t index;
+
+  if ((pImage[0] != REGSNAP_MAGIC) || (pImage[1] != hsnap->Key) || (pImage[2] != hsnap->Words) ||
+      (pImage[3] != hsnap->EntryCount))
+  {
+    return 0U;
+  }
+
+  REGSNAP_Checksum(pImage, hsnap->Words - REGSNAP_CHECK_WORDS, &sum1, &sum2);
+  if ((pImage[hsnap->Words - 2U] != sum1) || (pImage[hsnap->Words - 1U] != sum2))
+  {
+    return 0U;
+  }
+
+  pEntry = &pImage[REGSNAP_HEADER_WORDS + REGSNAP_RCC_WORDS];
+  for (index = 0U; index < hsnap->EntryCount; index++)
+  {
+    if ((pEntry[0] != (uint32_t)hsnap->pEntries[index].Instance) || (pEntry[1] != hsnap->pEntries[index].Type))
+    {
+      return 0U;
+    }
+    pEntry += 2U + REGSNAP_Layouts[hsnap->pEntries[index].Type].Count;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Replay the snapshot kept in the sector.
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @retval HAL status, HAL_ERROR with nothing written when the snapshot is
+  *         not valid
+  */
+HAL_StatusTypeDef BSP_REGSNAP_Restore(BSP_REGSNAP_TypeDef *hsnap)
+{
+  const uint32_t *pImage;
+  const uint32_t *pWord;
+  __IO uint32_t *pIpr = (__IO uint32_t *)(uint32_t)&NVIC->IPR[0];
+  uint32_t start = DWT->CYCCNT;
+  uint32_t index;
+
+  if ((hsnap == NULL) || (hsnap->pEntries == NULL) || (BSP_REGSNAP_IsValid(hsnap) == 0U))
+  {
+    return HAL_ERROR;
+  }
+  pImage = (const uint32_t *)hsnap->Address;
+  pWord  = &pImage[REGSNAP_HEADER_WORDS];
+
+  /* Clocks first, the read back lets them start before the first access */
+  RCC->AHB1ENR |= pWord[0];
+  RCC->APB2ENR |= pWord[1];
+  RCC->APB1ENR |= pWord[2];
+  RCC->AHB2ENR |= pWord[3];
+  (void)RCC->AHB2ENR;
+  pWord += REGSNAP_RCC_WORDS;
+
+  for (index = 0U; index < hsnap->EntryCount; index++)
+  {
+    REGSNAP_Replay(pWord[1], pWord[0], &pWord[2]);
+    pWord += 2U + REGSNAP_Layouts[pWord[1]].Count;
+  }
+
+  /* Interrupts last, the events of the replay dropped */
+  for (index = 0U; index < REGSNAP_IPR_WORDS; index++)
+  {
+    pIpr[index] = pWord[REGSNAP_ISER_WORDS + index];
+  }
+  for (index = 0U; index < REGSNAP_ISER_WORDS; index++)
+  {
+    NVIC->ICPR[index] = pWord[index];
+    NVIC->ISER[index] = pWord[index];
+  }
+
+  hsnap->RestoreCycles = DWT->CYCCNT - start;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_REGSNAP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read the registers into a snapshot image, interrupts disabled.
+  * @param  hsnap Pointer to a BSP_REGSNAP_TypeDef structure.
+  * @param  pImage Image of hsnap->Words words.
+  * @retval None
+  */
+static void REGSNAP_Capture(const BSP_REGSNAP_TypeDef *hsnap, uint32_t *pImage)
+{
+  const REGSNAP_LayoutTypeDef *pLayout;
+  const __IO uint32_t *pIpr = (const __IO uint32_t *)(uint32_t)&NVIC->IPR[0];
+  uint32_t *pWord = pImage;
+  uint32_t primask_bit;
+  uint32_t base;
+  uint32_t value;
+  uint32_t index;
+  uint32_t reg;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  *pWord++ = REGSNAP_MAGIC;
+  *pWord++ = hsnap->Key;
+  *pWord++ = hsnap->Words;
+  *pWord++ = hsnap->EntryCount;
+  *pWord++ = RCC->AHB1ENR;
+  *pWord++ = RCC->APB2ENR;
+  *pWord++ = RCC->APB1ENR;
+  *pWord++ = RCC->AHB2ENR;
+
+  for (index = 0U; index < hsnap->EntryCount; index++)
+  {
+    base    = (uint32_t)hsnap->pEntries[index].Instance;
+    pLayout = &REGSNAP_Layouts[hsnap->pEntries[index].Type];
+    *pWord++ = base;
+    *pWord++ = hsnap->pEntries[index].Type;
+    for (reg = 0U; reg < pLayout->Count; reg++)
+    {
+      value = *(__IO uint32_t *)(base + pLayout->pOffsets[reg]);
+
+      /* No calibration nor conversion started by the replay */
+      if (hsnap->pEntries[index].Type == BSP_REGSNAP_TYPE_ADC)
+      {
+        if (pLayout->pOffsets[reg] == offsetof(ADC_TypeDef, CCSR))
+        {
+          value &= (ADC_CCSR_CALSEL | ADC_CCSR_CALSMP);
+        }
+        else if (pLayout->pOffsets[reg] == offsetof(ADC_TypeDef, CR2))
+        {
+          value &= ~(ADC_CR2_SWSTART | ADC_CR2_JSWSTART);
+        }
+        else
+        {
+          /* Configuration kept as read */
+        }
+      }
+      *pWord++ = value;
+    }
+  }
+
+  for (index = 0U; index < REGSNAP_ISER_WORDS; index++)
+  {
+    *pWord++ = NVIC->ISER[index];
+  }
+  for (index = 0U; index < REGSNAP_IPR_WORDS; index++)
+  {
+    *pWord++ = pIpr[index];
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  REGSNAP_Checksum(pImage, hsnap->Words - REGSNAP_CHECK_WORDS, &pWord[0], &pWord[1]);
+}
+
+/**
+  * @brief  Sums of the words of an image and of their running total.
+  * @note   The second sum depends on the word order, a snapshot of moved
+  *         words does not pass.
+  * @param  pImage Image.
+  * @param  Words Number of words summed.
+  * @param  pSum1 Sum of the words.
+  * @param  pSum2 Sum of the running totals.
+  * @retval None
+  */
+static void REGSNAP_Checksum(const uint32_t *pImage, uint32_t Words, uint32_t *pSum1, uint32_t *pSum2)
+{
+  uint32_t sum1 = 1U;
+  uint32_t sum2 = 0U;
+  uint32_t index;
+
+  for (index = 0U; index < Words; index++)
+  {
+    sum1 += pImage[index];
+    sum2 += sum1;
+  }
+
+  *pSum1 = sum1;
+  *pSum2 = sum2;
+}
+
+/**
+  * @brief  Write the registers of a peripheral, its late ones last.
+  * @param  Type A value of @ref BSP_REGSNAP_Type.
+  * @param  Base Peripheral registers.
+  * @param  pValues Register values in layout order.
+  * @retval None
+  */
+static void REGSNAP_Replay(uint32_t Type, uint32_t Base, const uint32_t *pValues)
+{
+  const REGSNAP_LayoutTypeDef *pLayout = &REGSNAP_Layouts[Type];
+  uint32_t reg;
+
+  for (reg = 0U; reg < (pLayout->Count - pLayout->Late); reg++)
+  {
+    *(__IO uint32_t *)(Base + pLayout->pOffsets[reg]) = pValues[reg];
+  }
+
+  if (Type == BSP_REGSNAP_TYPE_TIM)
+  {
+    /* Load PSC and the preloaded registers, drop the update flag */
+    ((TIM_TypeDef *)Base)->EGR = TIM_EGR_UG;
+    ((TIM_TypeDef *)Base)->SR  = 0U;
+  }
+
+  for (; reg < pLayout->Count; reg++)
+  {
+    *(__IO uint32_t *)(Base + pLayout->pOffsets[reg]) = pValues[reg];
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
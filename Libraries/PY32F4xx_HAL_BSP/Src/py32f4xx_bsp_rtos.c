@@ -0,0 +1,2467 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_rtos.c
+  * @author  MCU Application Team
+  * @brief   CMSIS-RTOS2 kernel BSP service.
+  *          This file provides a preemptive kernel behind the cmsis_os2.h API:
+  *           + Kernel, threads, thread flags and delays
+  *           + Mutexes with priority inheritance, semaphores, event flags,
+  *             message queues
+  *           + PendSV context switch, FPU registers stacked lazily
+  *           + Tickless idle on the OS_Tick_* SysTick of os_systick.c
+  *           + HAL_InitTick() and HAL_Delay() of the HAL bound to the kernel
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_RTOS=y, defining USE_BSP_RTOS and adding
+       os_systick.c of Libraries/CMSIS/RTOS2. SysTick_Handler() calls
+       BSP_RTOS_TickHandler() and PendSV_Handler() is the one of this
+       service. USE_RTOS of py32f4xx_hal_conf.h stays 0: the HAL locks
+       are unchanged, share a HAL handle between threads with a mutex.
+
+   (#) In main(), after HAL_Init() and the clock configuration, call
+       osKernelInitialize(), create the threads with osThreadNew() and the
+       objects, then osKernelStart(), which does not return. The stack of
+       main() becomes the stack of the interrupts.
+
+   (#) Threads run by priority, the highest ready one first, and every
+       BSP_RTOS_ROBIN_TICKS ticks in turn among the same priority. The
+       scheduler runs in PendSV at the lowest priority: an interrupt
+       releasing a semaphore or setting flags switches to the thread woken
+       on its exit. The FPU registers S16-S31 are saved only for the
+       threads having used the FPU, the hardware stacking S0-S15 lazily.
+
+   (#) The control blocks come from cb_mem of the attributes, or from pools
+       of BSP_RTOS_THREADS, BSP_RTOS_MUTEXES, BSP_RTOS_SEMAPHORES,
+       BSP_RTOS_EVENTFLAGS and BSP_RTOS_MSGQUEUES blocks; the stacks and the
+       message buffers from stack_mem and mq_mem, or from a heap of
+       BSP_RTOS_HEAP_SIZE bytes never freed: create the objects once at
+       the start. The lowest word of each stack is checked on every tick,
+       BSP_RTOS_StackOverflowCallback() called for a thread overwriting it.
+
+   (#) The kernel implements the kernel, thread, thread flags, delay,
+       mutex, semaphore, event flags and message queue functions of
+       cmsis_os2.h, not the timers, memory pools, joins, safety classes and
+       zones. Message priorities are not sorted, the order is FIFO.
+
+   (#) The functions without timeout or with a timeout of 0 may be called
+       from the interrupts: osThreadFlagsSet(), osEventFlagsSet(),
+       osSemaphoreRelease(), osSemaphoreAcquire(), osMessageQueuePut(),
+       osMessageQueueGet() and the Get ones.
+
+   (#) With nothing to run, the idle thread calls BSP_RTOS_Idle(). With
+       BSP_RTOS_TICKLESS it gets the ticks to the next delay end with
+       osKernelSuspend(), stops the tick for that long with BSP_RTOS_Sleep()
+       in the SLEEP mode, and gives the ticks elapsed back with
+       osKernelResume(), to the kernel and to uwTick. Override
+       BSP_RTOS_Idle() for the STOP mode of the Tickless service.
+
+   (#) HAL_GetTick() keeps counting uwTick at 1 ms. Once the kernel runs,
+       HAL_Delay() from a thread calls osDelay() instead of spinning, and
+       HAL_InitTick(), called by HAL_RCC_ClockConfig(), sets the kernel
+       tick up again for the new HCLK. With USE_HAL_WAIT_STRATEGY 2U, the
+       timeout loops of the drivers block the thread a tick at a time.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include "py32f4xx_bsp_rtos.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_RTOS BSP RTOS
+  * @brief CMSIS-RTOS2 kernel BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_RTOS)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Private_Constants BSP RTOS Private Constants
+  * @{
+  */
+#define RTOS_ID_FREE                    0x00U          /*!< Control block free                        */
+#define RTOS_ID_THREAD                  0xF1U          /*!< Thread                                    */
+#define RTOS_ID_EVENTFLAGS              0xF4U          /*!< Event flags                               */
+#define RTOS_ID_MUTEX                   0xF5U          /*!< Mutex                                     */
+#define RTOS_ID_SEMAPHORE               0xF6U          /*!< Semaphore                                 */
+#define RTOS_ID_MSGQUEUE                0xF7U          /*!< Message queue                             */
+#define RTOS_ID_RESERVED                0xFFU          /*!< Control block taken, being initialized    */
+
+#define RTOS_WAIT_NONE                  0x00U          /*!< Not blocked                               */
+#define RTOS_WAIT_DELAY                 0x01U          /*!< osDelay() or osDelayUntil()               */
+#define RTOS_WAIT_SUSPEND               0x02U          /*!< osThreadSuspend()                         */
+#define RTOS_WAIT_THREADFLAGS           0x03U          /*!< osThreadFlagsWait()                       */
+#define RTOS_WAIT_OBJECT                0x04U          /*!< Wait list of an object                    */
+
+#define RTOS_STACK_MAGIC                0xE25A2EA5U    /*!< Lowest word of a stack                    */
+#define RTOS_STACK_FILL                 0xCCCCCCCCU    /*!< Stack words never written                 */
+#define RTOS_FRAME_WORDS                17U            /*!< R4-R11, EXC_RETURN, then R0-R3, R12, LR,
+                                                            PC, xPSR of the exception frame           */
+#define RTOS_EXC_RETURN                 0xFFFFFFFDU    /*!< Thread mode, PSP, no FPU frame            */
+#define RTOS_XPSR_THUMB                 0x01000000U    /*!< Thumb state of the first xPSR             */
+#define RTOS_DELAY_MAX                  0x7FFFFFFEU    /*!< Ticks of one delay at most                */
+
+#define RTOS_API_VERSION                20030000U      /*!< cmsis_os2.h 2.3.0                         */
+#define RTOS_KERNEL_VERSION             10000000U      /*!< Kernel 1.0.0                              */
+#define RTOS_KERNEL_ID                  "PY32F4xx BSP RTOS"
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Private_Macros BSP RTOS Private Macros
+  * @{
+  */
+#define RTOS_IS_ISR()                   (__get_IPSR() != 0U)
+#define RTOS_IS_OBJECT(__CB__, __ID__)  (((__CB__) != NULL) && ((__CB__)->Id == (__ID__)))
+#define RTOS_CB_ALLOC(__POOL__, __TYPE__, __MEM__, __SIZE__)                                     \
+  ((__TYPE__ *)RTOS_CbAlloc((__POOL__), sizeof(__POOL__) / sizeof(__TYPE__), sizeof(__TYPE__), \
+                            offsetof(__TYPE__, Id), (__MEM__), (__SIZE__)))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Private_Variables BSP RTOS Private Variables
+  * @{
+  */
+/* Referenced by name from PendSV_Handler() */
+BSP_RTOS_ThreadTypeDef * volatile RTOS_Current;
+BSP_RTOS_ThreadTypeDef * volatile RTOS_Next;
+
+static volatile osKernelState_t   RTOS_State;
+static BSP_RTOS_ThreadTypeDef     *RTOS_Ready;
+static BSP_RTOS_ThreadTypeDef     *RTOS_Delay;
+static volatile uint32_t          RTOS_TickCount;
+static uint32_t                   RTOS_TickPeriod;
+#if (BSP_RTOS_ROBIN_TICKS != 0U)
+static BSP_RTOS_ThreadTypeDef     *RTOS_SliceOwner;
+static uint32_t                   RTOS_Slice;
+#endif
+
+static BSP_RTOS_ThreadTypeDef     RTOS_IdleCb;
+static uint64_t                   RTOS_IdleStack[BSP_RTOS_IDLE_STACK_SIZE / 8U];
+
+static BSP_RTOS_ThreadTypeDef     RTOS_Threads[BSP_RTOS_THREADS];
+static BSP_RTOS_MutexTypeDef      RTOS_Mutexes[BSP_RTOS_MUTEXES];
+static BSP_RTOS_SemaphoreTypeDef  RTOS_Semaphores[BSP_RTOS_SEMAPHORES];
+static BSP_RTOS_EventFlagsTypeDef RTOS_EventFlags[BSP_RTOS_EVENTFLAGS];
+static BSP_RTOS_MsgQueueTypeDef   RTOS_MsgQueues[BSP_RTOS_MSGQUEUES];
+
+static uint64_t                   RTOS_Heap[BSP_RTOS_HEAP_SIZE / 8U];
+static uint32_t                   RTOS_HeapUsed;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_RTOS_Private_Functions BSP RTOS Private Functions
+  * @{
+  */
+static uint32_t RTOS_Enter(void);
+static void     RTOS_Exit(uint32_t primask);
+static void     *RTOS_CbAlloc(void *pPool, uint32_t Count, uint32_t Size, uint32_t IdOffset, void *pMem,
+                              uint32_t MemSize);
+static void     *RTOS_HeapAlloc(uint32_t Size);
+static void     RTOS_ListInsert(BSP_RTOS_ThreadTypeDef **pList, BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_ListRemove(BSP_RTOS_ThreadTypeDef **pList, BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_DelayInsert(BSP_RTOS_ThreadTypeDef *thread, uint32_t Ticks);
+static void     RTOS_DelayRemove(BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_Wait(BSP_RTOS_ThreadTypeDef **pList, uint32_t Kind, uint32_t Timeout);
+static void     RTOS_Wake(BSP_RTOS_ThreadTypeDef *thread, uint32_t Result);
+static void     RTOS_WakeAll(BSP_RTOS_ThreadTypeDef **pList, uint32_t Result);
+static void     RTOS_ProcessDelays(void);
+static void     RTOS_Schedule(void);
+static void     RTOS_SetPriority(BSP_RTOS_ThreadTypeDef *thread, uint32_t Priority);
+static uint32_t RTOS_InheritedPriority(const BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_MutexTake(BSP_RTOS_MutexTypeDef *mutex, BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_MutexGive(BSP_RTOS_MutexTypeDef *mutex);
+static void     RTOS_ThreadRemove(BSP_RTOS_ThreadTypeDef *thread);
+static void     RTOS_ThreadSetup(BSP_RTOS_ThreadTypeDef *thread, osThreadFunc_t func, void *argument,
+                                 uint32_t *pStack, uint32_t StackSize);
+static uint32_t RTOS_FlagsMatch(uint32_t Flags, uint32_t Wanted, uint32_t Options);
+static void     RTOS_IdleThread(void *argument);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_RTOS_Exported_Functions BSP RTOS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Count a kernel tick, called from SysTick_Handler().
+  * @note   Counts uwTick with HAL_IncTick() before the kernel starts too.
+  * @retval None
+  */
+void BSP_RTOS_TickHandler(void)
+{
+  BSP_RTOS_ThreadTypeDef *current;
+  uint32_t primask;
+
+  HAL_IncTick();
+  if ((RTOS_State != osKernelRunning) && (RTOS_State != osKernelLocked))
+  {
+    return;
+  }
+  OS_Tick_AcknowledgeIRQ();
+
+  primask = RTOS_Enter();
+  RTOS_TickCount++;
+  RTOS_ProcessDelays();
+
+  current = RTOS_Current;
+  if (current != NULL)
+  {
+#if (BSP_RTOS_ROBIN_TICKS != 0U)
+    if (current != RTOS_SliceOwner)
+    {
+      RTOS_SliceOwner = current;
+      RTOS_Slice      = BSP_RTOS_ROBIN_TICKS;
+    }
+    else if (--RTOS_Slice == 0U)
+    {
+      RTOS_Slice = BSP_RTOS_ROBIN_TICKS;
+      if ((current->State == (uint8_t)osThreadReady) && (current->pNext != NULL) &&
+          (current->pNext->Priority == current->Priority))
+      {
+        RTOS_ListRemove(&RTOS_Ready, current);
+        RTOS_ListInsert(&RTOS_Ready, current);
+      }
+    }
+#endif
+    if (current->pStack[0] != RTOS_STACK_MAGIC)
+    {
+      BSP_RTOS_StackOverflowCallback(current);
+    }
+  }
+
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+}
+
+/**
+  * @brief  Sleep with the tick stopped, called with the interrupts disabled.
+  * @note   SysTick is loaded with the ticks to sleep, at most its 24 bits,
+  *         and set back on the tick boundary on the wakeup.
+  * @param  Ticks Ticks to sleep, from osKernelSuspend().
+  * @retval Ticks elapsed, for osKernelResume()
+  */
+uint32_t BSP_RTOS_Sleep(uint32_t Ticks)
+{
+  uint32_t period = RTOS_TickPeriod;
+  uint32_t reload;
+  uint32_t ctrl;
+  uint32_t load;
+  uint32_t completed;
+  uint32_t elapsed;
+
+  if (Ticks == 0U)
+  {
+    return 0U;
+  }
+  if (Ticks > (SysTick_LOAD_RELOAD_Msk / period))
+  {
+    Ticks = SysTick_LOAD_RELOAD_Msk / period;
+  }
+  if (Ticks < 2U)
+  {
+    __DSB();
+    __WFI();
+    return 0U;
+  }
+
+  ctrl = SysTick->CTRL;
+  SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+  {
+    /* A tick is waiting to be counted */
+    SysTick->CTRL = ctrl | SysTick_CTRL_ENABLE_Msk;
+    return 0U;
+  }
+
+  reload = SysTick->VAL + (period * (Ticks - 1U));
+  SysTick->LOAD = reload;
+  SysTick->VAL  = 0U;
+  SysTick->CTRL = ctrl | SysTick_CTRL_ENABLE_Msk;
+
+  __DSB();
+  __WFI();
+  __ISB();
+
+  ctrl = SysTick->CTRL;
+  SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+  if ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
+  {
+    /* Slept to the end, the pending SysTick interrupt counts the last tick */
+    load = (period - 1U) - (reload - SysTick->VAL);
+    if ((load < 2U) || (load > (period - 1U)))
+    {
+      load = period - 1U;
+    }
+    SysTick->LOAD = load;
+    elapsed = Ticks - 1U;
+  }
+  else
+  {
+    /* Woken by another interrupt, resume on the next tick boundary */
+    completed = (Ticks * period) - SysTick->VAL;
+    elapsed = completed / period;
+    SysTick->LOAD = ((elapsed + 1U) * period) - completed;
+  }
+  SysTick->VAL  = 0U;
+  SysTick->CTRL = ctrl | SysTick_CTRL_ENABLE_Msk;
+  SysTick->LOAD = period - 1U;
+
+  return elapsed;
+}
+
+/**
+  * @brief  Idle with nothing to run, called in a loop by the idle thread.
+  * @retval None
+  */
+__weak void BSP_RTOS_Idle(void)
+{
+#if (BSP_RTOS_TICKLESS != 0U)
+  uint32_t primask;
+  uint32_t ticks;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  ticks = osKernelSuspend();
+  osKernelResume(BSP_RTOS_Sleep(ticks));
+  __set_PRIMASK(primask);
+#else
+  __DSB();
+  __WFI();
+#endif
+
+  /* NOTE: This function may be modified, when the STOP mode is needed,
+            the BSP_RTOS_Idle could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Stack overflow callback, from the tick interrupt.
+  * @param  thread_id Thread having overwritten the lowest word of its stack.
+  * @retval None
+  */
+__weak void BSP_RTOS_StackOverflowCallback(osThreadId_t thread_id)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(thread_id);
+
+  /* NOTE: This function should not be modified, when the callback is needed,
+            the BSP_RTOS_StackOverflowCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Provide a tick: SysTick of HAL_Init(), then the kernel tick at the new HCLK.
+  * @note   Overrides the weak function of py32f4xx_hal.c.
+  * @param  TickPriority Tick interrupt priority, before the kernel starts.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+  if ((RTOS_State == osKernelRunning) || (RTOS_State == osKernelLocked) || (RTOS_State == osKernelSuspended))
+  {
+    if (OS_Tick_Setup(BSP_RTOS_TICK_FREQ, NULL) != 0)
+    {
+      return HAL_ERROR;
+    }
+    RTOS_TickPeriod = OS_Tick_GetInterval();
+    OS_Tick_Enable();
+    return HAL_OK;
+  }
+
+  /* Configure the SysTick to have interrupt in 1ms time basis*/
+  if (HAL_SYSTICK_Config(SystemCoreClock / (1000U / uwTickFreq)) > 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Configure the SysTick IRQ priority */
+  if (TickPriority < (1UL << __NVIC_PRIO_BITS))
+  {
+    HAL_NVIC_SetPriority(SysTick_IRQn, TickPriority, 0U);
+    uwTickPrio = TickPriority;
+  }
+  else
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Wait Delay ms, the thread blocked once the kernel runs.
+  * @note   Overrides the weak function of py32f4xx_hal.c, spinning on
+  *         HAL_GetTick() from the interrupts and before the kernel starts.
+  * @param  Delay Delay in ms.
+  * @retval None
+  */
+void HAL_Delay(uint32_t Delay)
+{
+  uint32_t tickstart;
+  uint32_t wait = Delay;
+
+  /* Add a freq to guarantee minimum wait */
+  if (wait < HAL_MAX_DELAY)
+  {
+    wait += (uint32_t)(uwTickFreq);
+  }
+
+  if ((RTOS_State == osKernelRunning) && !RTOS_IS_ISR() && (__get_PRIMASK() == 0U))
+  {
+    while (wait > RTOS_DELAY_MAX)
+    {
+      (void)osDelay(RTOS_DELAY_MAX);
+      wait -= RTOS_DELAY_MAX;
+    }
+    (void)osDelay(wait);
+    return;
+  }
+
+  tickstart = HAL_GetTick();
+  while ((HAL_GetTick() - tickstart) < wait)
+  {
+    __HAL_WAIT(tickstart);
+  }
+}
+
+#if (USE_HAL_WAIT_STRATEGY == HAL_WAIT_CALLBACK)
+/**
+  * @brief  Block the thread in a timeout loop of the HAL for a tick.
+  * @note   Overrides the weak function of py32f4xx_hal.c, returning at once
+  *         from the interrupts and before the kernel starts.
+  * @retval None
+  */
+void HAL_WaitCallback(void)
+{
+  if ((RTOS_State == osKernelRunning) && !RTOS_IS_ISR() && (__get_PRIMASK() == 0U))
+  {
+    (void)osDelay(1U);
+  }
+}
+#endif /* USE_HAL_WAIT_STRATEGY */
+
+/**
+  * @brief  Switch the threads, FPU registers S16-S31 saved for a thread having used the FPU.
+  * @retval None
+  */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+  __ASM volatile
+  (
+    "mrs      r0, psp                \n"
+    "ldr      r3, =RTOS_Current      \n"
+    "ldr      r2, [r3]               \n"
+    "cbz      r2, 1f                 \n"
+#if (__FPU_USED == 1U)
+    "tst      lr, #0x10              \n"
+    "it       eq                     \n"
+    "vstmdbeq r0!, {s16-s31}         \n"
+#endif
+    "stmdb    r0!, {r4-r11, lr}      \n"
+    "str      r0, [r2]               \n"
+    "1:                              \n"
+    "ldr      r1, =RTOS_Next         \n"
+    "ldr      r2, [r1]               \n"
+    "str      r2, [r3]               \n"
+    "ldr      r0, [r2]               \n"
+    "ldmia    r0!, {r4-r11, lr}      \n"
+#if (__FPU_USED == 1U)
+    "tst      lr, #0x10              \n"
+    "it       eq                     \n"
+    "vldmiaeq r0!, {s16-s31}         \n"
+#endif
+    "msr      psp, r0                \n"
+    "bx       lr                     \n"
+    ".ltorg                          \n"
+  );
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_Kernel_Functions BSP RTOS Kernel Functions
+  * @brief    cmsis_os2.h kernel management
+  * @{
+  */
+
+osStatus_t osKernelInitialize(void)
+{
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (RTOS_State != osKernelInactive)
+  {
+    return osError;
+  }
+
+#if (__FPU_USED == 1U)
+  /* FPU context stacked on its first use in a thread only */
+  FPU->FPCCR |= FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+#endif
+
+  RTOS_Ready     = NULL;
+  RTOS_Delay     = NULL;
+  RTOS_Current   = NULL;
+  RTOS_Next      = NULL;
+  RTOS_TickCount = 0U;
+  RTOS_HeapUsed  = 0U;
+
+  RTOS_IdleCb.Alloc        = 0U;
+  RTOS_IdleCb.Priority     = (uint8_t)osPriorityIdle;
+  RTOS_IdleCb.BasePriority = (uint8_t)osPriorityIdle;
+  RTOS_IdleCb.Name         = "idle";
+  RTOS_ThreadSetup(&RTOS_IdleCb, RTOS_IdleThread, NULL, (uint32_t *)RTOS_IdleStack, sizeof(RTOS_IdleStack));
+  RTOS_ListInsert(&RTOS_Ready, &RTOS_IdleCb);
+
+  RTOS_State = osKernelReady;
+
+  return osOK;
+}
+
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size)
+{
+  if (version != NULL)
+  {
+    version->api    = RTOS_API_VERSION;
+    version->kernel = RTOS_KERNEL_VERSION;
+  }
+  if ((id_buf != NULL) && (id_size != 0U))
+  {
+    (void)strncpy(id_buf, RTOS_KERNEL_ID, id_size - 1U);
+    id_buf[id_size - 1U] = '\0';
+  }
+
+  return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+  return RTOS_State;
+}
+
+osStatus_t osKernelStart(void)
+{
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (RTOS_State != osKernelReady)
+  {
+    return osError;
+  }
+  if (OS_Tick_Setup(BSP_RTOS_TICK_FREQ, NULL) != 0)
+  {
+    return osError;
+  }
+  RTOS_TickPeriod = OS_Tick_GetInterval();
+  NVIC_SetPriority(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1U);
+
+  __disable_irq();
+  RTOS_State   = osKernelRunning;
+  RTOS_Current = NULL;
+  RTOS_Next    = RTOS_Ready;
+  OS_Tick_Enable();
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+  __enable_irq();
+
+  /* PendSV switches to the first thread, never back */
+  for (;;)
+  {
+  }
+}
+
+int32_t osKernelLock(void)
+{
+  int32_t lock;
+
+  if (RTOS_IS_ISR())
+  {
+    return (int32_t)osErrorISR;
+  }
+
+  switch (RTOS_State)
+  {
+    case osKernelRunning:
+      RTOS_State = osKernelLocked;
+      lock = 0;
+      break;
+    case osKernelLocked:
+      lock = 1;
+      break;
+    default:
+      lock = (int32_t)osError;
+      break;
+  }
+
+  return lock;
+}
+
+int32_t osKernelUnlock(void)
+{
+  uint32_t primask;
+  int32_t lock;
+
+  if (RTOS_IS_ISR())
+  {
+    return (int32_t)osErrorISR;
+  }
+
+  switch (RTOS_State)
+  {
+    case osKernelLocked:
+      primask = RTOS_Enter();
+      RTOS_State = osKernelRunning;
+      RTOS_Schedule();
+      RTOS_Exit(primask);
+      lock = 1;
+      break;
+    case osKernelRunning:
+      lock = 0;
+      break;
+    default:
+      lock = (int32_t)osError;
+      break;
+  }
+
+  return lock;
+}
+
+int32_t osKernelRestoreLock(int32_t lock)
+{
+  if (RTOS_IS_ISR())
+  {
+    return (int32_t)osErrorISR;
+  }
+  if ((RTOS_State != osKernelRunning) && (RTOS_State != osKernelLocked))
+  {
+    return (int32_t)osError;
+  }
+
+  if (lock == 1)
+  {
+    RTOS_State = osKernelLocked;
+    return 1;
+  }
+  if (lock == 0)
+  {
+    (void)osKernelUnlock();
+    return 0;
+  }
+
+  return (int32_t)osError;
+}
+
+uint32_t osKernelSuspend(void)
+{
+  uint32_t primask;
+  uint32_t ticks;
+
+  if (RTOS_IS_ISR() || (RTOS_State != osKernelRunning))
+  {
+    return 0U;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_State = osKernelSuspended;
+  if (RTOS_Ready != RTOS_Current)
+  {
+    /* A thread made ready, nothing to sleep */
+    ticks = 0U;
+  }
+  else if (RTOS_Delay != NULL)
+  {
+    ticks = RTOS_Delay->Wake - RTOS_TickCount;
+    if ((int32_t)ticks < 0)
+    {
+      ticks = 0U;
+    }
+  }
+  else
+  {
+    ticks = osWaitForever;
+  }
+  RTOS_Exit(primask);
+
+  return ticks;
+}
+
+void osKernelResume(uint32_t sleep_ticks)
+{
+  uint32_t primask;
+
+  if (RTOS_IS_ISR() || (RTOS_State != osKernelSuspended))
+  {
+    return;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_TickCount += sleep_ticks;
+  uwTick += sleep_ticks * (uint32_t)uwTickFreq;
+  RTOS_ProcessDelays();
+  RTOS_State = osKernelRunning;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+  return RTOS_TickCount;
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+  return BSP_RTOS_TICK_FREQ;
+}
+
+uint32_t osKernelGetSysTimerCount(void)
+{
+  uint32_t primask;
+  uint32_t ticks;
+  uint32_t count;
+
+  primask = RTOS_Enter();
+  ticks = RTOS_TickCount;
+  count = OS_Tick_GetCount();
+  if (OS_Tick_GetOverflow() != 0U)
+  {
+    count = OS_Tick_GetCount();
+    ticks++;
+  }
+  RTOS_Exit(primask);
+
+  return (ticks * RTOS_TickPeriod) + count;
+}
+
+uint32_t osKernelGetSysTimerFreq(void)
+{
+  return OS_Tick_GetClock();
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_Thread_Functions BSP RTOS Thread Functions
+  * @brief    cmsis_os2.h thread management, thread flags and delays
+  * @{
+  */
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+  BSP_RTOS_ThreadTypeDef *thread;
+  uint32_t *pstack = NULL;
+  uint32_t size = BSP_RTOS_STACK_SIZE;
+  uint32_t priority = (uint32_t)osPriorityNormal;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR() || (func == NULL) || (RTOS_State == osKernelInactive))
+  {
+    return NULL;
+  }
+  if (attr != NULL)
+  {
+    if (attr->priority != osPriorityNone)
+    {
+      priority = (uint32_t)attr->priority;
+    }
+    if (attr->stack_size != 0U)
+    {
+      size = attr->stack_size;
+    }
+    pstack = (uint32_t *)attr->stack_mem;
+  }
+  if ((priority < (uint32_t)osPriorityIdle) || (priority >= (uint32_t)osPriorityISR) ||
+      (size < (RTOS_FRAME_WORDS * 4U * 2U)) || (((uint32_t)pstack & 0x7U) != 0U))
+  {
+    return NULL;
+  }
+
+  primask = RTOS_Enter();
+  thread = RTOS_CB_ALLOC(RTOS_Threads, BSP_RTOS_ThreadTypeDef, (attr != NULL) ? attr->cb_mem : NULL,
+                         (attr != NULL) ? attr->cb_size : 0U);
+  if ((thread != NULL) && (pstack == NULL))
+  {
+    pstack = (uint32_t *)RTOS_HeapAlloc(size);
+    if (pstack == NULL)
+    {
+      thread->Id = RTOS_ID_FREE;
+      thread = NULL;
+    }
+  }
+  RTOS_Exit(primask);
+  if (thread == NULL)
+  {
+    return NULL;
+  }
+
+  thread->Alloc        = ((attr == NULL) || (attr->cb_mem == NULL)) ? 1U : 0U;
+  thread->Priority     = (uint8_t)priority;
+  thread->BasePriority = (uint8_t)priority;
+  thread->Name         = (attr != NULL) ? attr->name : NULL;
+  RTOS_ThreadSetup(thread, func, argument, pstack, size);
+
+  primask = RTOS_Enter();
+  RTOS_ListInsert(&RTOS_Ready, thread);
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return thread;
+}
+
+const char *osThreadGetName(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+
+  return RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) ? thread->Name : NULL;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+  return RTOS_Current;
+}
+
+osThreadState_t osThreadGetState(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+
+  if (RTOS_IS_ISR() || !RTOS_IS_OBJECT(thread, RTOS_ID_THREAD))
+  {
+    return osThreadError;
+  }
+  if (thread == RTOS_Current)
+  {
+    return osThreadRunning;
+  }
+
+  return (osThreadState_t)thread->State;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+
+  return RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) ? thread->StackSize : 0U;
+}
+
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  uint32_t words;
+  uint32_t index;
+
+  if (RTOS_IS_ISR() || !RTOS_IS_OBJECT(thread, RTOS_ID_THREAD))
+  {
+    return 0U;
+  }
+
+  words = thread->StackSize / 4U;
+  for (index = 1U; (index < words) && (thread->pStack[index] == RTOS_STACK_FILL); index++)
+  {
+  }
+
+  return (index - 1U) * 4U;
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) || (priority < osPriorityIdle) || (priority >= osPriorityISR))
+  {
+    return osErrorParameter;
+  }
+  if (thread->State == (uint8_t)osThreadTerminated)
+  {
+    return osErrorResource;
+  }
+
+  primask = RTOS_Enter();
+  thread->BasePriority = (uint8_t)priority;
+  RTOS_SetPriority(thread, RTOS_InheritedPriority(thread));
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+
+  if (RTOS_IS_ISR() || !RTOS_IS_OBJECT(thread, RTOS_ID_THREAD))
+  {
+    return osPriorityError;
+  }
+
+  return (osPriority_t)thread->Priority;
+}
+
+osStatus_t osThreadYield(void)
+{
+  BSP_RTOS_ThreadTypeDef *current;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+
+  primask = RTOS_Enter();
+  current = RTOS_Current;
+  if ((current != NULL) && (current->pNext != NULL) && (current->pNext->Priority == current->Priority))
+  {
+    RTOS_ListRemove(&RTOS_Ready, current);
+    RTOS_ListInsert(&RTOS_Ready, current);
+    RTOS_Schedule();
+  }
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osStatus_t osThreadSuspend(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) || (thread == &RTOS_IdleCb))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if (thread->State != (uint8_t)osThreadReady)
+  {
+    RTOS_Exit(primask);
+    return osErrorResource;
+  }
+  if ((thread == RTOS_Current) && ((primask != 0U) || (RTOS_State != osKernelRunning)))
+  {
+    RTOS_Exit(primask);
+    return osError;
+  }
+  RTOS_ListRemove(&RTOS_Ready, thread);
+  thread->State     = (uint8_t)osThreadBlocked;
+  thread->WaitKind  = RTOS_WAIT_SUSPEND;
+  thread->pWaitList = NULL;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osStatus_t osThreadResume(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(thread, RTOS_ID_THREAD))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if ((thread->State == (uint8_t)osThreadBlocked) && (thread->WaitKind == RTOS_WAIT_SUSPEND))
+  {
+    RTOS_Wake(thread, (uint32_t)osOK);
+    RTOS_Schedule();
+  }
+  else
+  {
+    status = osErrorResource;
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+__NO_RETURN void osThreadExit(void)
+{
+  (void)RTOS_Enter();
+  RTOS_ThreadRemove(RTOS_Current);
+  RTOS_Current = NULL;
+  if (RTOS_State == osKernelLocked)
+  {
+    RTOS_State = osKernelRunning;
+  }
+  RTOS_Schedule();
+  __enable_irq();
+
+  /* PendSV switches away, the context of this thread not saved */
+  for (;;)
+  {
+  }
+}
+
+osStatus_t osThreadTerminate(osThreadId_t thread_id)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) || (thread == &RTOS_IdleCb))
+  {
+    return osErrorParameter;
+  }
+  if (thread == RTOS_Current)
+  {
+    osThreadExit();
+  }
+
+  primask = RTOS_Enter();
+  RTOS_ThreadRemove(thread);
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+  BSP_RTOS_ThreadTypeDef *thread = (BSP_RTOS_ThreadTypeDef *)thread_id;
+  uint32_t primask;
+  uint32_t match;
+  uint32_t result;
+
+  if (!RTOS_IS_OBJECT(thread, RTOS_ID_THREAD) || ((flags & osFlagsError) != 0U))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  thread->Flags |= flags;
+  if ((thread->State == (uint8_t)osThreadBlocked) && (thread->WaitKind == RTOS_WAIT_THREADFLAGS))
+  {
+    match = RTOS_FlagsMatch(thread->Flags, thread->WaitFlags, thread->WaitOptions);
+    if (match != 0U)
+    {
+      if ((thread->WaitOptions & osFlagsNoClear) == 0U)
+      {
+        thread->Flags &= ~thread->WaitFlags;
+      }
+      RTOS_Wake(thread, match);
+      RTOS_Schedule();
+    }
+  }
+  result = thread->Flags;
+  RTOS_Exit(primask);
+
+  return result;
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  uint32_t primask;
+  uint32_t result;
+
+  if (RTOS_IS_ISR())
+  {
+    return osFlagsErrorISR;
+  }
+  if ((current == NULL) || ((flags & osFlagsError) != 0U))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  result = current->Flags;
+  current->Flags &= ~flags;
+  RTOS_Exit(primask);
+
+  return result;
+}
+
+uint32_t osThreadFlagsGet(void)
+{
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+
+  if (RTOS_IS_ISR() || (current == NULL))
+  {
+    return 0U;
+  }
+
+  return current->Flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  uint32_t primask;
+  uint32_t match;
+
+  if (RTOS_IS_ISR())
+  {
+    return osFlagsErrorISR;
+  }
+  if ((current == NULL) || ((flags & osFlagsError) != 0U))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  match = RTOS_FlagsMatch(current->Flags, flags, options);
+  if (match != 0U)
+  {
+    if ((options & osFlagsNoClear) == 0U)
+    {
+      current->Flags &= ~flags;
+    }
+    RTOS_Exit(primask);
+    return match;
+  }
+  if ((timeout == 0U) || (primask != 0U) || (RTOS_State != osKernelRunning))
+  {
+    RTOS_Exit(primask);
+    return (timeout == 0U) ? osFlagsErrorResource : osFlagsErrorUnknown;
+  }
+  current->WaitFlags   = flags;
+  current->WaitOptions = options;
+  RTOS_Wait(NULL, RTOS_WAIT_THREADFLAGS, timeout);
+  RTOS_Exit(primask);
+
+  return current->WaitResult;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (ticks == 0U)
+  {
+    return osOK;
+  }
+
+  primask = RTOS_Enter();
+  if ((primask != 0U) || (RTOS_State != osKernelRunning))
+  {
+    RTOS_Exit(primask);
+    return osError;
+  }
+  RTOS_Wait(NULL, RTOS_WAIT_DELAY, ticks);
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+  uint32_t primask;
+  uint32_t delay;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+
+  primask = RTOS_Enter();
+  delay = ticks - RTOS_TickCount;
+  if ((delay == 0U) || (delay > RTOS_DELAY_MAX))
+  {
+    RTOS_Exit(primask);
+    return osErrorParameter;
+  }
+  if ((primask != 0U) || (RTOS_State != osKernelRunning))
+  {
+    RTOS_Exit(primask);
+    return osError;
+  }
+  RTOS_Wait(NULL, RTOS_WAIT_DELAY, delay);
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_Mutex_Functions BSP RTOS Mutex Functions
+  * @brief    cmsis_os2.h mutexes
+  * @{
+  */
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+  BSP_RTOS_MutexTypeDef *mutex;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return NULL;
+  }
+
+  primask = RTOS_Enter();
+  mutex = RTOS_CB_ALLOC(RTOS_Mutexes, BSP_RTOS_MutexTypeDef, (attr != NULL) ? attr->cb_mem : NULL,
+                        (attr != NULL) ? attr->cb_size : 0U);
+  if (mutex != NULL)
+  {
+    mutex->Alloc      = ((attr == NULL) || (attr->cb_mem == NULL)) ? 1U : 0U;
+    mutex->Attr       = (attr != NULL) ? attr->attr_bits : 0U;
+    mutex->Name       = (attr != NULL) ? attr->name : NULL;
+    mutex->Lock       = 0U;
+    mutex->pOwner     = NULL;
+    mutex->pWaitList  = NULL;
+    mutex->pOwnerNext = NULL;
+    mutex->Id         = RTOS_ID_MUTEX;
+  }
+  RTOS_Exit(primask);
+
+  return mutex;
+}
+
+const char *osMutexGetName(osMutexId_t mutex_id)
+{
+  BSP_RTOS_MutexTypeDef *mutex = (BSP_RTOS_MutexTypeDef *)mutex_id;
+
+  return RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX) ? mutex->Name : NULL;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+  BSP_RTOS_MutexTypeDef *mutex = (BSP_RTOS_MutexTypeDef *)mutex_id;
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX) || (current == NULL))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if (mutex->pOwner == NULL)
+  {
+    RTOS_MutexTake(mutex, current);
+  }
+  else if (mutex->pOwner == current)
+  {
+    if (((mutex->Attr & osMutexRecursive) != 0U) && (mutex->Lock < 0xFFFFU))
+    {
+      mutex->Lock++;
+    }
+    else
+    {
+      status = osErrorResource;
+    }
+  }
+  else if (timeout == 0U)
+  {
+    status = osErrorResource;
+  }
+  else if ((primask != 0U) || (RTOS_State != osKernelRunning))
+  {
+    status = osError;
+  }
+  else
+  {
+    if (((mutex->Attr & osMutexPrioInherit) != 0U) && (mutex->pOwner->Priority < current->Priority))
+    {
+      RTOS_SetPriority(mutex->pOwner, current->Priority);
+    }
+    RTOS_Wait(&mutex->pWaitList, RTOS_WAIT_OBJECT, timeout);
+    RTOS_Exit(primask);
+
+    status = (osStatus_t)current->WaitResult;
+    if (status != osOK)
+    {
+      /* The owner no longer raised by this thread */
+      primask = RTOS_Enter();
+      if (RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX) && (mutex->pOwner != NULL))
+      {
+        RTOS_SetPriority(mutex->pOwner, RTOS_InheritedPriority(mutex->pOwner));
+        RTOS_Schedule();
+      }
+    }
+    else
+    {
+      return osOK;
+    }
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+  BSP_RTOS_MutexTypeDef *mutex = (BSP_RTOS_MutexTypeDef *)mutex_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if ((mutex->pOwner == NULL) || (mutex->pOwner != RTOS_Current))
+  {
+    RTOS_Exit(primask);
+    return osErrorResource;
+  }
+  mutex->Lock--;
+  if (mutex->Lock == 0U)
+  {
+    RTOS_MutexGive(mutex);
+    RTOS_Schedule();
+  }
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id)
+{
+  BSP_RTOS_MutexTypeDef *mutex = (BSP_RTOS_MutexTypeDef *)mutex_id;
+
+  if (RTOS_IS_ISR() || !RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX))
+  {
+    return NULL;
+  }
+
+  return mutex->pOwner;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id)
+{
+  BSP_RTOS_MutexTypeDef *mutex = (BSP_RTOS_MutexTypeDef *)mutex_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(mutex, RTOS_ID_MUTEX))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_WakeAll(&mutex->pWaitList, (uint32_t)osErrorResource);
+  if (mutex->pOwner != NULL)
+  {
+    RTOS_MutexGive(mutex);
+  }
+  mutex->Id = RTOS_ID_FREE;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_Semaphore_Functions BSP RTOS Semaphore Functions
+  * @brief    cmsis_os2.h semaphores
+  * @{
+  */
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR() || (max_count == 0U) || (initial_count > max_count))
+  {
+    return NULL;
+  }
+
+  primask = RTOS_Enter();
+  semaphore = RTOS_CB_ALLOC(RTOS_Semaphores, BSP_RTOS_SemaphoreTypeDef, (attr != NULL) ? attr->cb_mem : NULL,
+                            (attr != NULL) ? attr->cb_size : 0U);
+  if (semaphore != NULL)
+  {
+    semaphore->Alloc     = ((attr == NULL) || (attr->cb_mem == NULL)) ? 1U : 0U;
+    semaphore->Name      = (attr != NULL) ? attr->name : NULL;
+    semaphore->Count     = initial_count;
+    semaphore->MaxCount  = max_count;
+    semaphore->pWaitList = NULL;
+    semaphore->Id        = RTOS_ID_SEMAPHORE;
+  }
+  RTOS_Exit(primask);
+
+  return semaphore;
+}
+
+const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore = (BSP_RTOS_SemaphoreTypeDef *)semaphore_id;
+
+  return RTOS_IS_OBJECT(semaphore, RTOS_ID_SEMAPHORE) ? semaphore->Name : NULL;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore = (BSP_RTOS_SemaphoreTypeDef *)semaphore_id;
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (!RTOS_IS_OBJECT(semaphore, RTOS_ID_SEMAPHORE) || (RTOS_IS_ISR() && (timeout != 0U)))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if (semaphore->Count != 0U)
+  {
+    semaphore->Count--;
+  }
+  else if (timeout == 0U)
+  {
+    status = osErrorResource;
+  }
+  else if ((primask != 0U) || (RTOS_State != osKernelRunning) || (current == NULL))
+  {
+    status = osError;
+  }
+  else
+  {
+    RTOS_Wait(&semaphore->pWaitList, RTOS_WAIT_OBJECT, timeout);
+    RTOS_Exit(primask);
+    return (osStatus_t)current->WaitResult;
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore = (BSP_RTOS_SemaphoreTypeDef *)semaphore_id;
+  osStatus_t status = osOK;
+  uint32_t primask;
+
+  if (!RTOS_IS_OBJECT(semaphore, RTOS_ID_SEMAPHORE))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if (semaphore->pWaitList != NULL)
+  {
+    RTOS_Wake(semaphore->pWaitList, (uint32_t)osOK);
+    RTOS_Schedule();
+  }
+  else if (semaphore->Count < semaphore->MaxCount)
+  {
+    semaphore->Count++;
+  }
+  else
+  {
+    status = osErrorResource;
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore = (BSP_RTOS_SemaphoreTypeDef *)semaphore_id;
+
+  return RTOS_IS_OBJECT(semaphore, RTOS_ID_SEMAPHORE) ? semaphore->Count : 0U;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id)
+{
+  BSP_RTOS_SemaphoreTypeDef *semaphore = (BSP_RTOS_SemaphoreTypeDef *)semaphore_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(semaphore, RTOS_ID_SEMAPHORE))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_WakeAll(&semaphore->pWaitList, (uint32_t)osErrorResource);
+  semaphore->Id = RTOS_ID_FREE;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_EventFlags_Functions BSP RTOS Event Flags Functions
+  * @brief    cmsis_os2.h event flags
+  * @{
+  */
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return NULL;
+  }
+
+  primask = RTOS_Enter();
+  eventflags = RTOS_CB_ALLOC(RTOS_EventFlags, BSP_RTOS_EventFlagsTypeDef, (attr != NULL) ? attr->cb_mem : NULL,
+                             (attr != NULL) ? attr->cb_size : 0U);
+  if (eventflags != NULL)
+  {
+    eventflags->Alloc     = ((attr == NULL) || (attr->cb_mem == NULL)) ? 1U : 0U;
+    eventflags->Name      = (attr != NULL) ? attr->name : NULL;
+    eventflags->Flags     = 0U;
+    eventflags->pWaitList = NULL;
+    eventflags->Id        = RTOS_ID_EVENTFLAGS;
+  }
+  RTOS_Exit(primask);
+
+  return eventflags;
+}
+
+const char *osEventFlagsGetName(osEventFlagsId_t ef_id)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+
+  return RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS) ? eventflags->Name : NULL;
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+  BSP_RTOS_ThreadTypeDef *thread;
+  BSP_RTOS_ThreadTypeDef *next;
+  uint32_t primask;
+  uint32_t match;
+  uint32_t result;
+
+  if (!RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS) || ((flags & osFlagsError) != 0U))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  eventflags->Flags |= flags;
+  for (thread = eventflags->pWaitList; thread != NULL; thread = next)
+  {
+    next = thread->pNext;
+    match = RTOS_FlagsMatch(eventflags->Flags, thread->WaitFlags, thread->WaitOptions);
+    if (match != 0U)
+    {
+      if ((thread->WaitOptions & osFlagsNoClear) == 0U)
+      {
+        eventflags->Flags &= ~thread->WaitFlags;
+      }
+      RTOS_Wake(thread, match);
+    }
+  }
+  result = eventflags->Flags;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return result;
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+  uint32_t primask;
+  uint32_t result;
+
+  if (!RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS) || ((flags & osFlagsError) != 0U))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  result = eventflags->Flags;
+  eventflags->Flags &= ~flags;
+  RTOS_Exit(primask);
+
+  return result;
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+
+  return RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS) ? eventflags->Flags : 0U;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  uint32_t primask;
+  uint32_t match;
+
+  if (!RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS) || ((flags & osFlagsError) != 0U) ||
+      (RTOS_IS_ISR() && (timeout != 0U)))
+  {
+    return osFlagsErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  match = RTOS_FlagsMatch(eventflags->Flags, flags, options);
+  if (match != 0U)
+  {
+    if ((options & osFlagsNoClear) == 0U)
+    {
+      eventflags->Flags &= ~flags;
+    }
+    RTOS_Exit(primask);
+    return match;
+  }
+  if ((timeout == 0U) || (primask != 0U) || (RTOS_State != osKernelRunning) || (current == NULL))
+  {
+    RTOS_Exit(primask);
+    return (timeout == 0U) ? osFlagsErrorResource : osFlagsErrorUnknown;
+  }
+  current->WaitFlags   = flags;
+  current->WaitOptions = options;
+  RTOS_Wait(&eventflags->pWaitList, RTOS_WAIT_OBJECT, timeout);
+  RTOS_Exit(primask);
+
+  return current->WaitResult;
+}
+
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id)
+{
+  BSP_RTOS_EventFlagsTypeDef *eventflags = (BSP_RTOS_EventFlagsTypeDef *)ef_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(eventflags, RTOS_ID_EVENTFLAGS))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_WakeAll(&eventflags->pWaitList, osFlagsErrorResource);
+  eventflags->Id = RTOS_ID_FREE;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_RTOS_MsgQueue_Functions BSP RTOS Message Queue Functions
+  * @brief    cmsis_os2.h message queues
+  * @{
+  */
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue;
+  uint8_t *pbuffer = NULL;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR() || (msg_count == 0U) || (msg_size == 0U) || (msg_count > (0xFFFFFFFFU / msg_size)))
+  {
+    return NULL;
+  }
+  if ((attr != NULL) && (attr->mq_mem != NULL))
+  {
+    if (attr->mq_size < (msg_count * msg_size))
+    {
+      return NULL;
+    }
+    pbuffer = (uint8_t *)attr->mq_mem;
+  }
+
+  primask = RTOS_Enter();
+  queue = RTOS_CB_ALLOC(RTOS_MsgQueues, BSP_RTOS_MsgQueueTypeDef, (attr != NULL) ? attr->cb_mem : NULL,
+                        (attr != NULL) ? attr->cb_size : 0U);
+  if ((queue != NULL) && (pbuffer == NULL))
+  {
+    pbuffer = (uint8_t *)RTOS_HeapAlloc(msg_count * msg_size);
+    if (pbuffer == NULL)
+    {
+      queue->Id = RTOS_ID_FREE;
+      queue = NULL;
+    }
+  }
+  if (queue != NULL)
+  {
+    queue->Alloc     = ((attr == NULL) || (attr->cb_mem == NULL)) ? 1U : 0U;
+    queue->Name      = (attr != NULL) ? attr->name : NULL;
+    queue->MsgSize   = msg_size;
+    queue->Capacity  = msg_count;
+    queue->Count     = 0U;
+    queue->Head      = 0U;
+    queue->pBuffer   = pbuffer;
+    queue->pWaitList = NULL;
+    queue->Id        = RTOS_ID_MSGQUEUE;
+  }
+  RTOS_Exit(primask);
+
+  return queue;
+}
+
+const char *osMessageQueueGetName(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+
+  return RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) ? queue->Name : NULL;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  BSP_RTOS_ThreadTypeDef *receiver;
+  osStatus_t status = osOK;
+  uint32_t primask;
+  uint32_t tail;
+
+  UNUSED(msg_prio);
+
+  if (!RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) || (msg_ptr == NULL) || (RTOS_IS_ISR() && (timeout != 0U)))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  if ((queue->Count == 0U) && (queue->pWaitList != NULL))
+  {
+    /* Straight to the thread waiting to get */
+    receiver = queue->pWaitList;
+    (void)memcpy(receiver->pWaitData, msg_ptr, queue->MsgSize);
+    RTOS_Wake(receiver, (uint32_t)osOK);
+    RTOS_Schedule();
+  }
+  else if (queue->Count < queue->Capacity)
+  {
+    tail = (queue->Head + queue->Count) % queue->Capacity;
+    (void)memcpy(&queue->pBuffer[tail * queue->MsgSize], msg_ptr, queue->MsgSize);
+    queue->Count++;
+  }
+  else if (timeout == 0U)
+  {
+    status = osErrorResource;
+  }
+  else if ((primask != 0U) || (RTOS_State != osKernelRunning) || (current == NULL))
+  {
+    status = osError;
+  }
+  else
+  {
+    current->pWaitData = (void *)msg_ptr;
+    RTOS_Wait(&queue->pWaitList, RTOS_WAIT_OBJECT, timeout);
+    RTOS_Exit(primask);
+    return (osStatus_t)current->WaitResult;
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+  BSP_RTOS_ThreadTypeDef *sender;
+  osStatus_t status = osOK;
+  uint32_t primask;
+  uint32_t tail;
+
+  if (!RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) || (msg_ptr == NULL) || (RTOS_IS_ISR() && (timeout != 0U)))
+  {
+    return osErrorParameter;
+  }
+  if (msg_prio != NULL)
+  {
+    *msg_prio = 0U;
+  }
+
+  primask = RTOS_Enter();
+  if (queue->Count != 0U)
+  {
+    (void)memcpy(msg_ptr, &queue->pBuffer[queue->Head * queue->MsgSize], queue->MsgSize);
+    queue->Head = (queue->Head + 1U) % queue->Capacity;
+    queue->Count--;
+    if (queue->pWaitList != NULL)
+    {
+      /* The place freed takes the message of the thread waiting to put */
+      sender = queue->pWaitList;
+      tail = (queue->Head + queue->Count) % queue->Capacity;
+      (void)memcpy(&queue->pBuffer[tail * queue->MsgSize], sender->pWaitData, queue->MsgSize);
+      queue->Count++;
+      RTOS_Wake(sender, (uint32_t)osOK);
+      RTOS_Schedule();
+    }
+  }
+  else if (timeout == 0U)
+  {
+    status = osErrorResource;
+  }
+  else if ((primask != 0U) || (RTOS_State != osKernelRunning) || (current == NULL))
+  {
+    status = osError;
+  }
+  else
+  {
+    current->pWaitData = msg_ptr;
+    RTOS_Wait(&queue->pWaitList, RTOS_WAIT_OBJECT, timeout);
+    RTOS_Exit(primask);
+    return (osStatus_t)current->WaitResult;
+  }
+  RTOS_Exit(primask);
+
+  return status;
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+
+  return RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) ? queue->Capacity : 0U;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+
+  return RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) ? queue->MsgSize : 0U;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+
+  return RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) ? queue->Count : 0U;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+
+  return RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE) ? (queue->Capacity - queue->Count) : 0U;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  queue->Count = 0U;
+  queue->Head  = 0U;
+  RTOS_WakeAll(&queue->pWaitList, (uint32_t)osErrorResource);
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id)
+{
+  BSP_RTOS_MsgQueueTypeDef *queue = (BSP_RTOS_MsgQueueTypeDef *)mq_id;
+  uint32_t primask;
+
+  if (RTOS_IS_ISR())
+  {
+    return osErrorISR;
+  }
+  if (!RTOS_IS_OBJECT(queue, RTOS_ID_MSGQUEUE))
+  {
+    return osErrorParameter;
+  }
+
+  primask = RTOS_Enter();
+  RTOS_WakeAll(&queue->pWaitList, (uint32_t)osErrorResource);
+  queue->Id = RTOS_ID_FREE;
+  RTOS_Schedule();
+  RTOS_Exit(primask);
+
+  return osOK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_RTOS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Enter a kernel critical section.
+  * @retval PRIMASK before
+  */
+static uint32_t RTOS_Enter(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+
+  return primask;
+}
+
+/**
+  * @brief  Leave a kernel critical section, a switch pended by it taken here.
+  * @param  primask PRIMASK from RTOS_Enter().
+  * @retval None
+  */
+static void RTOS_Exit(uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Take a control block, in a critical section.
+  * @param  pPool Pool of the type.
+  * @param  Count Control blocks of the pool.
+  * @param  Size Bytes of a control block.
+  * @param  IdOffset Offset of the Id field.
+  * @param  pMem cb_mem of the attributes, NULL for the pool.
+  * @param  MemSize cb_size of the attributes.
+  * @retval Control block, its Id not free, NULL for none
+  */
+static void *RTOS_CbAlloc(void *pPool, uint32_t Count, uint32_t Size, uint32_t IdOffset, void *pMem,
+                          uint32_t MemSize)
+{
+  uint8_t *pcb;
+  uint32_t index;
+
+  if (pMem != NULL)
+  {
+    if ((MemSize < Size) || (((uint32_t)pMem & 0x3U) != 0U))
+    {
+      return NULL;
+    }
+    pcb = (uint8_t *)pMem;
+    pcb[IdOffset] = RTOS_ID_RESERVED;
+    return pcb;
+  }
+
+  for (index = 0U; index < Count; index++)
+  {
+    pcb = (uint8_t *)pPool + (index * Size);
+    if (pcb[IdOffset] == RTOS_ID_FREE)
+    {
+      pcb[IdOffset] = RTOS_ID_RESERVED;
+      return pcb;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Take memory from the kernel heap, in a critical section.
+  * @param  Size Bytes, rounded up to 8.
+  * @retval Memory aligned on 8 bytes, NULL when the heap is short
+  */
+static void *RTOS_HeapAlloc(uint32_t Size)
+{
+  uint8_t *pmem;
+
+  Size = (Size + 7U) & ~7U;
+  if (Size > (sizeof(RTOS_Heap) - RTOS_HeapUsed))
+  {
+    return NULL;
+  }
+
+  pmem = (uint8_t *)RTOS_Heap + RTOS_HeapUsed;
+  RTOS_HeapUsed += Size;
+
+  return pmem;
+}
+
+/**
+  * @brief  Insert a thread after the threads of its priority and above.
+  * @param  pList Ready list or wait list.
+  * @param  thread Thread.
+  * @retval None
+  */
+static void RTOS_ListInsert(BSP_RTOS_ThreadTypeDef **pList, BSP_RTOS_ThreadTypeDef *thread)
+{
+  while ((*pList != NULL) && ((*pList)->Priority >= thread->Priority))
+  {
+    pList = &(*pList)->pNext;
+  }
+  thread->pNext = *pList;
+  *pList = thread;
+}
+
+/**
+  * @brief  Remove a thread from a list.
+  * @param  pList Ready list or wait list.
+  * @param  thread Thread.
+  * @retval None
+  */
+static void RTOS_ListRemove(BSP_RTOS_ThreadTypeDef **pList, BSP_RTOS_ThreadTypeDef *thread)
+{
+  while ((*pList != NULL) && (*pList != thread))
+  {
+    pList = &(*pList)->pNext;
+  }
+  if (*pList != NULL)
+  {
+    *pList = thread->pNext;
+  }
+  thread->pNext = NULL;
+}
+
+/**
+  * @brief  Insert a thread in the delay list, the earliest end first.
+  * @param  thread Thread.
+  * @param  Ticks Ticks from now, up to RTOS_DELAY_MAX.
+  * @retval None
+  */
+static void RTOS_DelayInsert(BSP_RTOS_ThreadTypeDef *thread, uint32_t Ticks)
+{
+  BSP_RTOS_ThreadTypeDef **plist = &RTOS_Delay;
+
+  if (Ticks > RTOS_DELAY_MAX)
+  {
+    Ticks = RTOS_DELAY_MAX;
+  }
+  thread->Wake = RTOS_TickCount + Ticks;
+  while ((*plist != NULL) && ((int32_t)((*plist)->Wake - thread->Wake) <= 0))
+  {
+    plist = &(*plist)->pDelayNext;
+  }
+  thread->pDelayNext = *plist;
+  *plist = thread;
+  thread->Delayed = 1U;
+}
+
+/**
+  * @brief  Remove a thread from the delay list.
+  * @param  thread Thread.
+  * @retval None
+  */
+static void RTOS_DelayRemove(BSP_RTOS_ThreadTypeDef *thread)
+{
+  BSP_RTOS_ThreadTypeDef **plist = &RTOS_Delay;
+
+  while ((*plist != NULL) && (*plist != thread))
+  {
+    plist = &(*plist)->pDelayNext;
+  }
+  if (*plist != NULL)
+  {
+    *plist = thread->pDelayNext;
+  }
+  thread->pDelayNext = NULL;
+  thread->Delayed = 0U;
+}
+
+/**
+  * @brief  Block the running thread, in a critical section left right after.
+  * @note   The switch is pended: it happens when the critical section ends,
+  *         WaitResult then holds the result, osErrorTimeout at the timeout.
+  * @param  pList Wait list of the object, NULL for none.
+  * @param  Kind What the thread waits for.
+  * @param  Timeout Ticks, osWaitForever for no timeout.
+  * @retval None
+  */
+static void RTOS_Wait(BSP_RTOS_ThreadTypeDef **pList, uint32_t Kind, uint32_t Timeout)
+{
+  BSP_RTOS_ThreadTypeDef *current = RTOS_Current;
+
+  RTOS_ListRemove(&RTOS_Ready, current);
+  current->State      = (uint8_t)osThreadBlocked;
+  current->WaitKind   = (uint8_t)Kind;
+  current->WaitResult = (uint32_t)osErrorTimeout;
+  current->pWaitList  = pList;
+  if (pList != NULL)
+  {
+    RTOS_ListInsert(pList, current);
+  }
+  if (Timeout != osWaitForever)
+  {
+    RTOS_DelayInsert(current, Timeout);
+  }
+  RTOS_Schedule();
+}
+
+/**
+  * @brief  Make a blocked thread ready.
+  * @param  thread Thread.
+  * @param  Result WaitResult of the thread.
+  * @retval None
+  */
+static void RTOS_Wake(BSP_RTOS_ThreadTypeDef *thread, uint32_t Result)
+{
+  if (thread->pWaitList != NULL)
+  {
+    RTOS_ListRemove(thread->pWaitList, thread);
+    thread->pWaitList = NULL;
+  }
+  if (thread->Delayed != 0U)
+  {
+    RTOS_DelayRemove(thread);
+  }
+  thread->WaitResult = Result;
+  thread->WaitKind   = RTOS_WAIT_NONE;
+  thread->State      = (uint8_t)osThreadReady;
+  RTOS_ListInsert(&RTOS_Ready, thread);
+}
+
+/**
+  * @brief  Make all the threads of a wait list ready.
+  * @param  pList Wait list.
+  * @param  Result WaitResult of the threads.
+  * @retval None
+  */
+static void RTOS_WakeAll(BSP_RTOS_ThreadTypeDef **pList, uint32_t Result)
+{
+  while (*pList != NULL)
+  {
+    RTOS_Wake(*pList, Result);
+  }
+}
+
+/**
+  * @brief  Make ready the threads whose delay ended.
+  * @retval None
+  */
+static void RTOS_ProcessDelays(void)
+{
+  while ((RTOS_Delay != NULL) && ((int32_t)(RTOS_Delay->Wake - RTOS_TickCount) <= 0))
+  {
+    RTOS_Wake(RTOS_Delay, (uint32_t)osErrorTimeout);
+  }
+}
+
+/**
+  * @brief  Pend the switch to the first ready thread when it is not the running one.
+  * @retval None
+  */
+static void RTOS_Schedule(void)
+{
+  if (RTOS_State != osKernelRunning)
+  {
+    return;
+  }
+
+  RTOS_Next = RTOS_Ready;
+  if (RTOS_Ready != RTOS_Current)
+  {
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+  }
+}
+
+/**
+  * @brief  Change the priority running of a thread, its place in its list with it.
+  * @param  thread Thread.
+  * @param  Priority New priority.
+  * @retval None
+  */
+static void RTOS_SetPriority(BSP_RTOS_ThreadTypeDef *thread, uint32_t Priority)
+{
+  if (thread->Priority == Priority)
+  {
+    return;
+  }
+
+  if (thread->State == (uint8_t)osThreadReady)
+  {
+    RTOS_ListRemove(&RTOS_Ready, thread);
+    thread->Priority = (uint8_t)Priority;
+    RTOS_ListInsert(&RTOS_Ready, thread);
+  }
+  else if (thread->pWaitList != NULL)
+  {
+    RTOS_ListRemove(thread->pWaitList, thread);
+    thread->Priority = (uint8_t)Priority;
+    RTOS_ListInsert(thread->pWaitList, thread);
+  }
+  else
+  {
+    thread->Priority = (uint8_t)Priority;
+  }
+}
+
+/**
+  * @brief  Compute the priority of a thread raised by the waiters of its mutexes.
+  * @param  thread Thread.
+  * @retval Priority
+  */
+static uint32_t RTOS_InheritedPriority(const BSP_RTOS_ThreadTypeDef *thread)
+{
+  const BSP_RTOS_MutexTypeDef *mutex;
+  uint32_t priority = thread->BasePriority;
+
+  for (mutex = thread->pMutexes; mutex != NULL; mutex = mutex->pOwnerNext)
+  {
+    if (((mutex->Attr & osMutexPrioInherit) != 0U) && (mutex->pWaitList != NULL) &&
+        (mutex->pWaitList->Priority > priority))
+    {
+      priority = mutex->pWaitList->Priority;
+    }
+  }
+
+  return priority;
+}
+
+/**
+  * @brief  Give a free mutex to a thread.
+  * @param  mutex Mutex.
+  * @param  thread New owner.
+  * @retval None
+  */
+static void RTOS_MutexTake(BSP_RTOS_MutexTypeDef *mutex, BSP_RTOS_ThreadTypeDef *thread)
+{
+  mutex->pOwner     = thread;
+  mutex->Lock       = 1U;
+  mutex->pOwnerNext = thread->pMutexes;
+  thread->pMutexes  = mutex;
+}
+
+/**
+  * @brief  Release a mutex of its owner, to the first waiter if any.
+  * @param  mutex Mutex.
+  * @retval None
+  */
+static void RTOS_MutexGive(BSP_RTOS_MutexTypeDef *mutex)
+{
+  BSP_RTOS_ThreadTypeDef *owner = mutex->pOwner;
+  BSP_RTOS_MutexTypeDef **plist = &owner->pMutexes;
+  BSP_RTOS_ThreadTypeDef *waiter;
+
+  while ((*plist != NULL) && (*plist != mutex))
+  {
+    plist = &(*plist)->pOwnerNext;
+  }
+  if (*plist != NULL)
+  {
+    *plist = mutex->pOwnerNext;
+  }
+  mutex->pOwnerNext = NULL;
+  mutex->pOwner     = NULL;
+  mutex->Lock       = 0U;
+  RTOS_SetPriority(owner, RTOS_InheritedPriority(owner));
+
+  waiter = mutex->pWaitList;
+  if (waiter != NULL)
+  {
+    RTOS_Wake(waiter, (uint32_t)osOK);
+    RTOS_MutexTake(mutex, waiter);
+  }
+}
+
+/**
+  * @brief  Remove a thread from the kernel, its mutexes released.
+  * @param  thread Thread.
+  * @retval None
+  */
+static void RTOS_ThreadRemove(BSP_RTOS_ThreadTypeDef *thread)
+{
+  if (thread->State == (uint8_t)osThreadReady)
+  {
+    RTOS_ListRemove(&RTOS_Ready, thread);
+  }
+  else if (thread->State == (uint8_t)osThreadBlocked)
+  {
+    if (thread->pWaitList != NULL)
+    {
+      RTOS_ListRemove(thread->pWaitList, thread);
+      thread->pWaitList = NULL;
+    }
+    if (thread->Delayed != 0U)
+    {
+      RTOS_DelayRemove(thread);
+    }
+  }
+  else
+  {
+  }
+
+  while (thread->pMutexes != NULL)
+  {
+    RTOS_MutexGive(thread->pMutexes);
+  }
+
+  thread->State = (uint8_t)osThreadTerminated;
+  thread->Id    = RTOS_ID_FREE;
+}
+
+/**
+  * @brief  Build the first context of a thread, as PendSV_Handler() restores it.
+  * @param  thread Thread, Priority, BasePriority, Alloc and Name set.
+  * @param  func Thread function.
+  * @param  argument Argument of the function.
+  * @param  pStack Stack, aligned on 8 bytes.
+  * @param  StackSize Stack bytes.
+  * @retval None
+  */
+static void RTOS_ThreadSetup(BSP_RTOS_ThreadTypeDef *thread, osThreadFunc_t func, void *argument,
+                             uint32_t *pStack, uint32_t StackSize)
+{
+  uint32_t *psp;
+  uint32_t words = StackSize / 4U;
+  uint32_t index;
+
+  for (index = 0U; index < words; index++)
+  {
+    pStack[index] = RTOS_STACK_FILL;
+  }
+  pStack[0] = RTOS_STACK_MAGIC;
+
+  psp = (uint32_t *)(((uint32_t)&pStack[words]) & ~0x7U) - RTOS_FRAME_WORDS;
+  for (index = 0U; index < 8U; index++)
+  {
+    psp[index] = 0U;
+  }
+  psp[8]  = RTOS_EXC_RETURN;
+  psp[9]  = (uint32_t)argument;
+  psp[10] = 0U;
+  psp[11] = 0U;
+  psp[12] = 0U;
+  psp[13] = 0U;
+  psp[14] = (uint32_t)osThreadExit;
+  psp[15] = (uint32_t)func & ~1U;
+  psp[16] = RTOS_XPSR_THUMB;
+
+  thread->Sp          = (uint32_t)psp;
+  thread->State       = (uint8_t)osThreadReady;
+  thread->WaitKind    = RTOS_WAIT_NONE;
+  thread->Delayed     = 0U;
+  thread->pNext       = NULL;
+  thread->pDelayNext  = NULL;
+  thread->pWaitList   = NULL;
+  thread->Flags       = 0U;
+  thread->WaitFlags   = 0U;
+  thread->WaitOptions = 0U;
+  thread->pWaitData   = NULL;
+  thread->WaitResult  = 0U;
+  thread->pMutexes    = NULL;
+  thread->pStack      = pStack;
+  thread->StackSize   = StackSize;
+  thread->Id          = RTOS_ID_THREAD;
+}
+
+/**
+  * @brief  Check flags against a wait.
+  * @param  Flags Flags set.
+  * @param  Wanted Flags waited for.
+  * @param  Options osFlagsWaitAll or osFlagsWaitAny.
+  * @retval Flags set when the wait is satisfied, 0 otherwise
+  */
+static uint32_t RTOS_FlagsMatch(uint32_t Flags, uint32_t Wanted, uint32_t Options)
+{
+  uint32_t pattern = Flags & Wanted;
+
+  if ((Options & osFlagsWaitAll) != 0U)
+  {
+    return (pattern == Wanted) ? Flags : 0U;
+  }
+
+  return (pattern != 0U) ? Flags : 0U;
+}
+
+/**
+  * @brief  Idle thread, the lowest priority.
+  * @param  argument Not used.
+  * @retval None
+  */
+static void RTOS_IdleThread(void *argument)
+{
+  UNUSED(argument);
+
+  for (;;)
+  {
+    BSP_RTOS_Idle();
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_RTOS */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
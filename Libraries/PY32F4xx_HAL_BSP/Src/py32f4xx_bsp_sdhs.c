@@ -0,0 +1,413 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdhs.c
+  * @author  MCU Application Team
+  * @brief   SD card high speed configuration BSP service.
+  *          This file provides functions to bring an initialized SD card to
+  *          its fastest bus:
+  *           + 4-bit bus when the SCR allows it
+  *           + High speed function switch with CMD6
+  *           + Fastest SDIO clock divider passing a read test
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) After HAL_SD_Init() the card runs on hsd->Init.ClockDiv, default speed
+       timings: 25 MHz at most. SD cards of specification 1.10 and later
+       support the high speed function, 50 MHz: CMD6 queries the function
+       group 1, then selects it, each query answered by a 64 byte status
+       block on the data lines.
+
+   (#) Call BSP_SDHS_Config() in place of HAL_SD_ConfigWideBusOperation()
+       with the highest card clock of the board in MaxClock, limited by the
+       traces and the card socket:
+       (++) the bus is set to 4 bits when the card supports it, 1 bit kept
+            otherwise;
+       (++) when the card has the switch command class, CMD6 switches it to
+            high speed, the clock limit going from BSP_SDHS_CLOCK_DEFAULT to
+            BSP_SDHS_CLOCK_HIGH;
+       (++) the divider is the smallest one keeping the card clock,
+            HCLK / (2 x ClockDiv), under the limit, ClockDiv 0 passing HCLK
+            through when HCLK itself is under it;
+       (++) NbrOfBlocks blocks are read from TestBlock into pBuffer: on a
+            failure the divider is raised and the test run again, up to
+            BSP_SDHS_RETRIES times.
+
+   (#) The divider retained is written to hsd->Init.ClockDiv, pResult gives
+       the bus width, the mode, the card clock and the rate of the read test
+       for the log of the board bring-up. With HCLK at 100 MHz and more, the
+       card gets 50 MHz, or 48 MHz at 96 MHz: about twice the throughput of
+       the default speed.
+
+   (#) A card left in high speed keeps it until its power cycle: a new
+       HAL_SD_Init() restarts it from the identification clock, call
+       BSP_SDHS_Config() again after it.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_sdhs.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SDHS BSP SDHS
+  * @brief SD card high speed configuration BSP service
+  * @{
+  */
+
+#if defined (HAL_SD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SDHS_Private_Constants BSP SDHS Private Constants
+  * @{
+  */
+#define SDHS_STATUS_BYTES               64U            /* CMD6 switch function status              */
+#define SDHS_CHECK_HIGH_SPEED           0x00FFFFF1U    /* Mode 0, function 1 of group 1 queried    */
+#define SDHS_SWITCH_HIGH_SPEED          0x80FFFFF1U    /* Mode 1, function 1 of group 1 selected   */
+#define SDHS_CCC_SWITCH                 (1UL << 10U)   /* Command class 10, switch function        */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_SDHS_Private_Functions BSP SDHS Private Functions
+  * @{
+  */
+static uint32_t SDHS_Switch(SD_HandleTypeDef *hsd, uint32_t Argument, uint8_t *pStatus);
+static uint32_t SDHS_GetCmdResp1(SDIO_TypeDef *SDIOx);
+static uint32_t SDHS_ReadTest(SD_HandleTypeDef *hsd, uint32_t TestBlock, uint8_t *pBuffer,
+                              uint32_t NbrOfBlocks, uint32_t *pElapsed);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SDHS_Exported_Functions BSP SDHS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Configure the bus width, the speed mode and the clock of the card.
+  * @param  hsd SD handle, card initialized by HAL_SD_Init().
+  * @param  MaxClock Highest card clock of the board, Hz.
+  * @param  TestBlock First block of the read test.
+  * @param  pBuffer Read test buffer, NbrOfBlocks x BLOCKSIZE bytes, word aligned.
+  * @param  NbrOfBlocks Blocks of the read test, 1 or more.
+  * @param  pResult Configuration retained.
+  * @retval HAL status, HAL_ERROR when the read test fails at every clock tried
+  */
+HAL_StatusTypeDef BSP_SDHS_Config(SD_HandleTypeDef *hsd, uint32_t MaxClock, uint32_t TestBlock,
+                                  uint8_t *pBuffer, uint32_t NbrOfBlocks, BSP_SDHS_ResultTypeDef *pResult)
+{
+  HAL_SD_CardCSDTypeDef csd;
+  uint32_t status[SDHS_STATUS_BYTES / 4U];
+  uint32_t hclk = HAL_RCC_GetHCLKFreq();
+  uint32_t limit;
+  uint32_t div;
+  uint32_t elapsed = 0U;
+  uint32_t errorstate;
+
+  if ((hsd == NULL) || (pBuffer == NULL) || (pResult == NULL) || (MaxClock == 0U) ||
+      (NbrOfBlocks == 0U) || ((TestBlock + NbrOfBlocks) > hsd->SdCard.LogBlockNbr))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hsd->State != HAL_SD_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  pResult->BusWide   = SDIO_BUS_WIDE_1B;
+  pResult->HighSpeed = 0U;
+  pResult->Retries   = 0U;
+  pResult->ReadRate  = 0U;
+
+  /* 4-bit bus, refused by the HAL when the SCR does not list it */
+  if (HAL_SD_ConfigWideBusOperation(hsd, SDIO_BUS_WIDE_4B) == HAL_OK)
+  {
+    pResult->BusWide = SDIO_BUS_WIDE_4B;
+  }
+  hsd->Init.BusWide = pResult->BusWide;
+  hsd->ErrorCode    = HAL_SD_ERROR_NONE;
+
+  /* High speed through CMD6, function 1 of the access mode group */
+  if ((hsd->SdCard.CardType != CARD_SECURED) && (HAL_SD_GetCardCSD(hsd, &csd) == HAL_OK) &&
+      ((csd.CardComdClasses & SDHS_CCC_SWITCH) != 0U))
+  {
+    hsd->State = HAL_SD_STATE_BUSY;
+    errorstate = SDHS_Switch(hsd, SDHS_CHECK_HIGH_SPEED, (uint8_t *)status);
+    /* Bits 415:400, the functions supported by group 1: bit 401 is high speed */
+    if ((errorstate == HAL_SD_ERROR_NONE) && ((((uint8_t *)status)[13] & 0x02U) != 0U))
+    {
+      errorstate = SDHS_Switch(hsd, SDHS_SWITCH_HIGH_SPEED, (uint8_t *)status);
+      /* Bits 379:376, the function selected in group 1 */
+      if ((errorstate == HAL_SD_ERROR_NONE) && ((((uint8_t *)status)[16] & 0x0FU) == 0x01U))
+      {
+        pResult->HighSpeed = 1U;
+      }
+    }
+    hsd->State = HAL_SD_STATE_READY;
+
+    if (errorstate != HAL_SD_ERROR_NONE)
+    {
+      hsd->ErrorCode |= errorstate;
+      return HAL_ERROR;
+    }
+  }
+
+  /* Smallest divider under the limit, the card clock being HCLK / (2 x div) */
+  limit = (pResult->HighSpeed != 0U) ? BSP_SDHS_CLOCK_HIGH : BSP_SDHS_CLOCK_DEFAULT;
+  if (MaxClock < limit)
+  {
+    limit = MaxClock;
+  }
+  div = (hclk <= limit) ? 0U : ((hclk + (2U * limit) - 1U) / (2U * limit));
+
+  for (;;)
+  {
+    if (div > SDIO_CLKCR_CLKDIV_Msk)
+    {
+      return HAL_ERROR;
+    }
+    SDIO_SetClock(hsd->Instance, div);
+    hsd->Init.ClockDiv = div;
+
+    errorstate = SDHS_ReadTest(hsd, TestBlock, pBuffer, NbrOfBlocks, &elapsed);
+    if (errorstate == HAL_SD_ERROR_NONE)
+    {
+      break;
+    }
+    if (pResult->Retries >= BSP_SDHS_RETRIES)
+    {
+      hsd->ErrorCode |= errorstate;
+      return HAL_ERROR;
+    }
+    pResult->Retries++;
+    hsd->ErrorCode = HAL_SD_ERROR_NONE;
+    div++;
+  }
+
+  pResult->ClockDiv = div;
+  pResult->Clock    = (div == 0U) ? hclk : (hclk / (2U * div));
+  if (elapsed != 0U)
+  {
+    pResult->ReadRate = (uint32_t)(((uint64_t)NbrOfBlocks * BLOCKSIZE * 1000U) / elapsed);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SDHS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Send CMD6 and read its switch function status.
+  * @param  hsd SD handle.
+  * @param  Argument Mode, and the function of each group, 0xF to keep it.
+  * @param  pStatus Status, SDHS_STATUS_BYTES bytes in the order received, word aligned.
+  * @retval SD error state
+  */
+static uint32_t SDHS_Switch(SD_HandleTypeDef *hsd, uint32_t Argument, uint8_t *pStatus)
+{
+  SDIO_DataInitTypeDef config;
+  SDIO_CmdInitTypeDef  sdmmc_cmdinit;
+  uint32_t *status = (uint32_t *)pStatus;
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t index = 0U;
+  uint32_t word;
+  uint32_t errorstate;
+
+  errorstate = SDMMC_CmdBlockLength(hsd->Instance, SDHS_STATUS_BYTES);
+  if (errorstate != HAL_SD_ERROR_NONE)
+  {
+    return errorstate;
+  }
+
+  config.DataTimeOut   = SDMMC_DATATIMEOUT;
+  config.DataLength    = SDHS_STATUS_BYTES;
+  config.DataBlockSize = SDHS_STATUS_BYTES;
+  config.TransferDir   = SDIO_TRANSFER_DIR_TO_SDIO;
+  config.TransferMode  = SDIO_TRANSFER_MODE_BLOCK;
+  (void)SDIO_ConfigData(hsd->Instance, &config);
+
+  /* SDMMC_CmdSwitch() expects no data, the status block is read here */
+  sdmmc_cmdinit.Argument         = Argument;
+  sdmmc_cmdinit.CmdIndex         = SDMMC_CMD_HS_SWITCH;
+  sdmmc_cmdinit.Response         = SDIO_RESPONSE_SHORT;
+  sdmmc_cmdinit.WaitPend         = SDIO_WAIT_PEND_DISABLE;
+  sdmmc_cmdinit.AutoInit         = SDIO_AUTO_INIT_DISABLE;
+  sdmmc_cmdinit.CheckCRC         = SDIO_CHECK_CRC_ENABLE;
+  sdmmc_cmdinit.DataTransfer     = SDIO_DATA_TRANSFER_ENABLE;
+  sdmmc_cmdinit.CPSM             = SDIO_CPSM_ENABLE;
+  (void)SDIO_SendCommand(hsd->Instance, &sdmmc_cmdinit);
+
+  errorstate = SDHS_GetCmdResp1(hsd->Instance);
+  if (errorstate != HAL_SD_ERROR_NONE)
+  {
+    return errorstate;
+  }
+
+  while (!__HAL_SD_GET_FLAG(hsd, SDIO_FLAG_FRUN | SDIO_FLAG_DCRC | SDIO_FLAG_DRTO_BDS | SDIO_FLAG_DTO))
+  {
+    if (__HAL_SD_GET_FLAG(hsd, SDIO_FLAG_RXDR))
+    {
+      word = SDIO_ReadFIFO(hsd->Instance);
+      if (index < (SDHS_STATUS_BYTES / 4U))
+      {
+        status[index++] = word;
+      }
+      __HAL_SD_CLEAR_FLAG(hsd, SDIO_FLAG_RXDR);
+    }
+
+    if ((HAL_GetTick() - tickstart) >= SDIO_CMDTIMEOUT)
+    {
+      return HAL_SD_ERROR_TIMEOUT;
+    }
+  }
+  while (!__HAL_SD_IS_FIFO_EMPTY(hsd))
+  {
+    word = SDIO_ReadFIFO(hsd->Instance);
+    if (index < (SDHS_STATUS_BYTES / 4U))
+    {
+      status[index++] = word;
+    }
+  }
+
+  if (__HAL_SD_GET_FLAG(hsd, SDIO_FLAG_DRTO_BDS))
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_FLAG_DRTO_BDS);
+    return HAL_SD_ERROR_DATA_TIMEOUT;
+  }
+  else if (__HAL_SD_GET_FLAG(hsd, SDIO_FLAG_DCRC))
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_FLAG_DCRC);
+    return HAL_SD_ERROR_DATA_CRC_FAIL;
+  }
+  else if (__HAL_SD_GET_FLAG(hsd, SDIO_FLAG_FRUN))
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_FLAG_FRUN);
+    return HAL_SD_ERROR_FIFO_ERR;
+  }
+  else
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_DATA_FLAGS);
+  }
+
+  return (index == (SDHS_STATUS_BYTES / 4U)) ? HAL_SD_ERROR_NONE : HAL_SD_ERROR_DATA_TIMEOUT;
+}
+
+/**
+  * @brief  Wait for an R1 response and check it.
+  * @param  SDIOx Pointer to SDIO register base.
+  * @retval SD error state
+  */
+static uint32_t SDHS_GetCmdResp1(SDIO_TypeDef *SDIOx)
+{
+  /* 8 is the number of required instructions cycles for the below loop statement */
+  uint32_t count = SDIO_CMDTIMEOUT * (SystemCoreClock / 8U / 1000U);
+  uint32_t sta_reg;
+
+  do
+  {
+    if (count-- == 0U)
+    {
+      return HAL_SD_ERROR_TIMEOUT;
+    }
+    sta_reg = SDIOx->INTSTS;
+  } while ((sta_reg & (SDIO_FLAG_RE | SDIO_FLAG_CD | SDIO_FLAG_RCRC | SDIO_FLAG_RTO_BAR)) == 0U);
+
+  __SDIO_CLEAR_FLAG(SDIOx, SDIO_STATIC_CMD_FLAGS);
+
+  if ((sta_reg & SDIO_FLAG_RTO_BAR) != 0U)
+  {
+    return HAL_SD_ERROR_CMD_RSP_TIMEOUT;
+  }
+  if ((sta_reg & (SDIO_FLAG_RCRC | SDIO_FLAG_RE)) != 0U)
+  {
+    return HAL_SD_ERROR_CMD_CRC_FAIL;
+  }
+  if ((SDIO_GetResponse(SDIOx, SDIO_RESP1) & SDMMC_OCR_ERRORBITS) != 0U)
+  {
+    return HAL_SD_ERROR_GENERAL_UNKNOWN_ERR;
+  }
+
+  return HAL_SD_ERROR_NONE;
+}
+
+/**
+  * @brief  Read blocks at the current clock, timed.
+  * @param  hsd SD handle.
+  * @param  TestBlock First block.
+  * @param  pBuffer Buffer, NbrOfBlocks x BLOCKSIZE bytes.
+  * @param  NbrOfBlocks Blocks.
+  * @param  pElapsed HAL ticks of the read.
+  * @retval SD error state
+  */
+static uint32_t SDHS_ReadTest(SD_HandleTypeDef *hsd, uint32_t TestBlock, uint8_t *pBuffer,
+                              uint32_t NbrOfBlocks, uint32_t *pElapsed)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  if (HAL_SD_ReadBlocks(hsd, pBuffer, TestBlock, NbrOfBlocks, BSP_SDHS_TIMEOUT) != HAL_OK)
+  {
+    return (hsd->ErrorCode != HAL_SD_ERROR_NONE) ? hsd->ErrorCode : HAL_SD_ERROR_GENERAL_UNKNOWN_ERR;
+  }
+  *pElapsed = HAL_GetTick() - tickstart;
+
+  /* The card answers CMD13 at this clock too */
+  while (HAL_SD_GetCardState(hsd) != HAL_SD_CARD_TRANSFER)
+  {
+    if (hsd->ErrorCode != HAL_SD_ERROR_NONE)
+    {
+      return hsd->ErrorCode;
+    }
+    if ((HAL_GetTick() - tickstart) >= BSP_SDHS_TIMEOUT)
+    {
+      return HAL_SD_ERROR_TIMEOUT;
+    }
+  }
+
+  return HAL_SD_ERROR_NONE;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
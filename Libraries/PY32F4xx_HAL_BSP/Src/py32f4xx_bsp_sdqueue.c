@@ -0,0 +1,687 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdqueue.c
+  * @author  MCU Application Team
+  * @brief   SD card request queue BSP service.
+  *          This file provides functions to share one SD card between many
+  *          producers, without HAL_BUSY to handle:
+  *           + Queue of {op, block, count, buffer} requests, submitted from
+  *             any context without a lock
+  *           + Requests next to each other merged into one multiple block
+  *             command
+  *           + Each command issued from the completion of the previous one
+  *           + Completion callback per request
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the card with HAL_SD_Init(), link a DMA channel to hdmarx
+       and one to hdmatx, HAL_SD_ReadBlocks_DMA() and HAL_SD_WriteBlocks_DMA()
+       being the transfers of the queue, and enable their interrupts and the
+       SDIO one in the NVIC.
+
+   (#) Call BSP_SDQUEUE_Init() with the SD handle. The queue then owns the
+       card: the HAL functions must not be used on it while a request is
+       queued, and BSP_SDSTREAM must not run on it.
+
+   (#) Call BSP_SDQUEUE_IRQHandler() from SDIO_IRQHandler(), in place of
+       HAL_SD_IRQHandler(). From HAL_SD_TxCpltCallback() call
+       BSP_SDQUEUE_TxCpltHandler(), from HAL_SD_RxCpltCallback()
+       BSP_SDQUEUE_RxCpltHandler() and from HAL_SD_ErrorCallback()
+       BSP_SDQUEUE_ErrorHandler().
+
+   (#) Fill a BSP_SDQUEUE_ReqTypeDef and queue it with BSP_SDQUEUE_Submit()
+       from any context, interrupts included:
+       (+) The request is pushed with LDREX/STREX, neither the interrupts nor
+           a lock are taken. The first context finding the card idle issues
+           the command, the others return at once.
+       (+) When a command is issued, the waiting requests of the same
+           operation whose blocks and buffers continue the first request,
+           before or after it, join its command, up to BSP_SDQUEUE_BLOCKS_MAX
+           blocks. A request is never moved ahead of an earlier one on the
+           same blocks when one of them writes. Place the buffers of the
+           consecutive blocks next to each other to get the merge.
+       (+) The next command is issued from the completion interrupt of the
+           previous one. After a write, a CMD13 held by the SDIO until the
+           card ends its programming comes first.
+       (+) BSP_SDQUEUE_ReqCpltCallback() is called with the Status set, from
+           the interrupt, or from BSP_SDQUEUE_Submit() when the command
+           could not be issued. The request can then be reused or submitted
+           again, pContext tells the producers apart.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_sdqueue.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SDQUEUE BSP SDQUEUE
+  * @brief SD card request queue BSP service
+  * @{
+  */
+
+#if defined (HAL_SD_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SDQUEUE_Private_Constants BSP SDQUEUE Private Constants
+  * @{
+  */
+#define SDQUEUE_PHASE_IDLE              0x00000000U    /* No command                                  */
+#define SDQUEUE_PHASE_XFER              0x00000001U    /* Read or write DMA running                   */
+#define SDQUEUE_PHASE_PROG              0x00000002U    /* CMD13 held until the card programmed        */
+
+#define SDQUEUE_IT_CMD                  (SDIO_IT_CD | SDIO_IT_RE | SDIO_IT_RCRC | SDIO_IT_RTO_BAR)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_SDQUEUE_Private_Macros BSP SDQUEUE Private Macros
+  * @{
+  */
+#define SDQUEUE_END(__REQ__)            ((__REQ__)->Lba + (__REQ__)->Count)
+#define SDQUEUE_DATA_END(__REQ__)       (&(__REQ__)->pData[(__REQ__)->Count * BLOCKSIZE])
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SDQUEUE_Private_Functions
+  * @{
+  */
+static uint32_t SDQUEUE_Claim(BSP_SDQUEUE_TypeDef *hqueue);
+static void     SDQUEUE_Run(BSP_SDQUEUE_TypeDef *hqueue);
+static void     SDQUEUE_Collect(BSP_SDQUEUE_TypeDef *hqueue);
+static uint32_t SDQUEUE_Conflict(const BSP_SDQUEUE_TypeDef *hqueue, const BSP_SDQUEUE_ReqTypeDef *pReq);
+static uint32_t SDQUEUE_Batch(BSP_SDQUEUE_TypeDef *hqueue);
+static void     SDQUEUE_Program(BSP_SDQUEUE_TypeDef *hqueue, uint32_t Status);
+static void     SDQUEUE_End(BSP_SDQUEUE_TypeDef *hqueue, uint32_t Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SDQUEUE_Exported_Functions BSP SDQUEUE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SDQUEUE_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Bind the queue to an SD card
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a request queue on an SD card.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  hsd Pointer to an SD_HandleTypeDef structure initialized, hdmarx and
+  *             hdmatx must be linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SDQUEUE_Init(BSP_SDQUEUE_TypeDef *hqueue, SD_HandleTypeDef *hsd)
+{
+  if ((hqueue == NULL) || (hsd == NULL) || (hsd->hdmarx == NULL) || (hsd->hdmatx == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (hsd->State != HAL_SD_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hqueue->pPending       = NULL;
+  hqueue->Owner          = 0U;
+  hqueue->pHead          = NULL;
+  hqueue->pTail          = NULL;
+  hqueue->pBatch         = NULL;
+  hqueue->Phase          = SDQUEUE_PHASE_IDLE;
+  hqueue->BatchStatus    = BSP_SDQUEUE_STATUS_OK;
+  hqueue->Stats.Requests = 0U;
+  hqueue->Stats.Commands = 0U;
+  hqueue->Stats.Merged   = 0U;
+  hqueue->Stats.Blocks   = 0U;
+  hqueue->Stats.Errors   = 0U;
+  hqueue->hsd            = hsd;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SDQUEUE_Exported_Functions_Group2 Request functions
+  * @brief    Request functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Request functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Queue a read or write request
+      (+) Check the end of the queued requests
+      (+) Drive the queue from the SDIO interrupt and the SD callbacks
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Queue a request, its command is issued at once when the card is idle.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  pReq Request, it must not be modified before its callback.
+  * @retval HAL status, HAL_BUSY when the request is already queued
+  */
+HAL_StatusTypeDef BSP_SDQUEUE_Submit(BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_ReqTypeDef *pReq)
+{
+  BSP_SDQUEUE_ReqTypeDef *pending;
+
+  if ((hqueue == NULL) || (hqueue->hsd == NULL) || (pReq == NULL) || (pReq->pData == NULL) ||
+      ((((uint32_t)pReq->pData) & 3U) != 0U) || (pReq->Count == 0U) || (pReq->Count > BSP_SDQUEUE_BLOCKS_MAX) ||
+      ((pReq->Op != BSP_SDQUEUE_OP_READ) && (pReq->Op != BSP_SDQUEUE_OP_WRITE)) ||
+      (pReq->Lba >= hqueue->hsd->SdCard.LogBlockNbr) ||
+      (pReq->Count > (hqueue->hsd->SdCard.LogBlockNbr - pReq->Lba)))
+  {
+    return HAL_ERROR;
+  }
+  if (pReq->Status == BSP_SDQUEUE_STATUS_QUEUED)
+  {
+    return HAL_BUSY;
+  }
+
+  pReq->Status    = BSP_SDQUEUE_STATUS_QUEUED;
+  pReq->ErrorCode = HAL_SD_ERROR_NONE;
+
+  do
+  {
+    pending = (BSP_SDQUEUE_ReqTypeDef *)__LDREXW((volatile uint32_t *)(void *)&hqueue->pPending);
+    pReq->pNext = pending;
+  } while (__STREXW((uint32_t)pReq, (volatile uint32_t *)(void *)&hqueue->pPending) != 0U);
+
+  if (SDQUEUE_Claim(hqueue) != 0U)
+  {
+    SDQUEUE_Run(hqueue);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check whether all the queued requests ended.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval 1 when the queue is idle, 0 otherwise
+  */
+uint32_t BSP_SDQUEUE_IsIdle(const BSP_SDQUEUE_TypeDef *hqueue)
+{
+  return ((hqueue->Owner == 0U) && (hqueue->pPending == NULL) && (hqueue->pHead == NULL)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_SDQUEUE_GetStats(const BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_StatsTypeDef *pStats)
+{
+  *pStats = hqueue->Stats;
+}
+
+/**
+  * @brief  Handle the SDIO interrupt.
+  * @note   Call it from SDIO_IRQHandler(), in place of HAL_SD_IRQHandler().
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_SDQUEUE_IRQHandler(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  SD_HandleTypeDef *hsd = hqueue->hsd;
+  uint32_t status;
+
+  if (hqueue->Phase != SDQUEUE_PHASE_PROG)
+  {
+    HAL_SD_IRQHandler(hsd);
+    return;
+  }
+
+  status = hsd->Instance->INTSTS & hsd->Instance->INTMASK;
+  if ((status & SDQUEUE_IT_CMD) == 0U)
+  {
+    return;
+  }
+
+  __HAL_SD_DISABLE_IT(hsd, SDQUEUE_IT_CMD);
+  __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_CMD_FLAGS);
+  hsd->State = HAL_SD_STATE_READY;
+
+  if ((status & SDIO_FLAG_RTO_BAR) != 0U)
+  {
+    hsd->ErrorCode |= HAL_SD_ERROR_CMD_RSP_TIMEOUT;
+  }
+  else if ((status & (SDIO_FLAG_RE | SDIO_FLAG_RCRC)) != 0U)
+  {
+    hsd->ErrorCode |= HAL_SD_ERROR_CMD_CRC_FAIL;
+  }
+  else if ((SDIO_GetResponse(hsd->Instance, SDIO_RESP1) & SDMMC_OCR_ERRORBITS) != 0U)
+  {
+    /* CMD13 answered: DAT0 released, the card is done programming */
+    hsd->ErrorCode |= HAL_SD_ERROR_GENERAL_UNKNOWN_ERR;
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+
+  SDQUEUE_End(hqueue, (hsd->ErrorCode == HAL_SD_ERROR_NONE) ? hqueue->BatchStatus : BSP_SDQUEUE_STATUS_ERROR);
+  SDQUEUE_Run(hqueue);
+}
+
+/**
+  * @brief  End the write on the bus: wait for the card programming.
+  * @note   To be called from HAL_SD_TxCpltCallback() for the queue card.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_SDQUEUE_TxCpltHandler(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  if ((hqueue->hsd != NULL) && (hqueue->Phase == SDQUEUE_PHASE_XFER))
+  {
+    SDQUEUE_Program(hqueue, (hqueue->hsd->ErrorCode == HAL_SD_ERROR_NONE) ? BSP_SDQUEUE_STATUS_OK :
+                                                                             BSP_SDQUEUE_STATUS_ERROR);
+  }
+}
+
+/**
+  * @brief  End the read on the bus and issue the next command.
+  * @note   To be called from HAL_SD_RxCpltCallback() for the queue card.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_SDQUEUE_RxCpltHandler(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  if ((hqueue->hsd != NULL) && (hqueue->Phase == SDQUEUE_PHASE_XFER))
+  {
+    SDQUEUE_End(hqueue, (hqueue->hsd->ErrorCode == HAL_SD_ERROR_NONE) ? BSP_SDQUEUE_STATUS_OK :
+                                                                         BSP_SDQUEUE_STATUS_ERROR);
+    SDQUEUE_Run(hqueue);
+  }
+}
+
+/**
+  * @brief  Drop the command on the bus and issue the next one.
+  * @note   To be called from HAL_SD_ErrorCallback() for the queue card. The
+  *         errors reported while the HAL still ends the transfer are left to
+  *         the completion handlers.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+void BSP_SDQUEUE_ErrorHandler(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  if ((hqueue->hsd == NULL) || (hqueue->Phase != SDQUEUE_PHASE_XFER) ||
+      (hqueue->hsd->State != HAL_SD_STATE_READY))
+  {
+    return;
+  }
+
+  if (hqueue->pBatch->Op == BSP_SDQUEUE_OP_WRITE)
+  {
+    SDQUEUE_Program(hqueue, BSP_SDQUEUE_STATUS_ERROR);
+  }
+  else
+  {
+    SDQUEUE_End(hqueue, BSP_SDQUEUE_STATUS_ERROR);
+    SDQUEUE_Run(hqueue);
+  }
+}
+
+/**
+  * @brief  Request end callback.
+  * @note   Called from the SDIO or DMA interrupt, or from BSP_SDQUEUE_Submit(),
+  *         pReq->Status holds the result.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  pReq Request ended.
+  * @retval None
+  */
+__weak void BSP_SDQUEUE_ReqCpltCallback(BSP_SDQUEUE_TypeDef *hqueue, BSP_SDQUEUE_ReqTypeDef *pReq)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hqueue);
+  UNUSED(pReq);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SDQUEUE_ReqCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SDQUEUE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Take the queue, a single context runs it at a time.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval 1 when taken, 0 when another context or a command holds it
+  */
+static uint32_t SDQUEUE_Claim(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  do
+  {
+    if (__LDREXW(&hqueue->Owner) != 0U)
+    {
+      __CLREX();
+      return 0U;
+    }
+  } while (__STREXW(1U, &hqueue->Owner) != 0U);
+  __DMB();
+
+  return 1U;
+}
+
+/**
+  * @brief  Issue the next command, or give the queue up when nothing waits.
+  * @note   Called by the owner of the queue. Once a command is issued, the
+  *         queue belongs to it until its completion interrupt.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+static void SDQUEUE_Run(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  for (;;)
+  {
+    SDQUEUE_Collect(hqueue);
+    while (hqueue->pHead != NULL)
+    {
+      if (SDQUEUE_Batch(hqueue) != 0U)
+      {
+        return;
+      }
+    }
+
+    __DMB();
+    hqueue->Owner = 0U;
+
+    /* A request pushed before the release found the queue taken */
+    if ((hqueue->pPending == NULL) || (SDQUEUE_Claim(hqueue) == 0U))
+    {
+      return;
+    }
+  }
+}
+
+/**
+  * @brief  Move the pushed requests to the waiting list, in submission order.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval None
+  */
+static void SDQUEUE_Collect(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  BSP_SDQUEUE_ReqTypeDef *pending;
+  BSP_SDQUEUE_ReqTypeDef *ordered = NULL;
+  BSP_SDQUEUE_ReqTypeDef *last;
+  BSP_SDQUEUE_ReqTypeDef *next;
+
+  do
+  {
+    pending = (BSP_SDQUEUE_ReqTypeDef *)__LDREXW((volatile uint32_t *)(void *)&hqueue->pPending);
+  } while (__STREXW(0U, (volatile uint32_t *)(void *)&hqueue->pPending) != 0U);
+
+  if (pending == NULL)
+  {
+    return;
+  }
+
+  /* The pushes stack the requests, the last one first */
+  last = pending;
+  while (pending != NULL)
+  {
+    next = pending->pNext;
+    pending->pNext = ordered;
+    ordered = pending;
+    pending = next;
+  }
+
+  if (hqueue->pHead == NULL)
+  {
+    hqueue->pHead = ordered;
+  }
+  else
+  {
+    hqueue->pTail->pNext = ordered;
+  }
+  hqueue->pTail = last;
+}
+
+/**
+  * @brief  Check whether a waiting request may run before the ones submitted earlier.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  pReq Request of the waiting list.
+  * @retval 1 when an earlier request on the same blocks writes or is overwritten
+  */
+static uint32_t SDQUEUE_Conflict(const BSP_SDQUEUE_TypeDef *hqueue, const BSP_SDQUEUE_ReqTypeDef *pReq)
+{
+  const BSP_SDQUEUE_ReqTypeDef *earlier;
+
+  for (earlier = hqueue->pHead; earlier != pReq; earlier = earlier->pNext)
+  {
+    if (((earlier->Op == BSP_SDQUEUE_OP_WRITE) || (pReq->Op == BSP_SDQUEUE_OP_WRITE)) &&
+        (earlier->Lba < SDQUEUE_END(pReq)) && (pReq->Lba < SDQUEUE_END(earlier)))
+    {
+      return 1U;
+    }
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Take the first waiting request and the ones it can merge, issue their command.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @retval 1 when the command is on the bus, 0 when it failed and its requests ended
+  */
+static uint32_t SDQUEUE_Batch(BSP_SDQUEUE_TypeDef *hqueue)
+{
+  SD_HandleTypeDef *hsd = hqueue->hsd;
+  BSP_SDQUEUE_ReqTypeDef *first = hqueue->pHead;
+  BSP_SDQUEUE_ReqTypeDef *last = first;
+  BSP_SDQUEUE_ReqTypeDef *prev;
+  BSP_SDQUEUE_ReqTypeDef *req;
+  HAL_StatusTypeDef status;
+  uint32_t count = first->Count;
+  uint32_t merged;
+
+  hqueue->pHead = first->pNext;
+  first->pNext = NULL;
+
+  /* Rescan after each merge, the batch grows at both ends */
+  do
+  {
+    merged = 0U;
+    prev = NULL;
+    for (req = hqueue->pHead; req != NULL; req = req->pNext)
+    {
+      if ((req->Op == first->Op) && ((count + req->Count) <= BSP_SDQUEUE_BLOCKS_MAX) &&
+          (((req->Lba == SDQUEUE_END(last)) && (req->pData == SDQUEUE_DATA_END(last))) ||
+           ((SDQUEUE_END(req) == first->Lba) && (SDQUEUE_DATA_END(req) == first->pData))) &&
+          (SDQUEUE_Conflict(hqueue, req) == 0U))
+      {
+        merged = 1U;
+        break;
+      }
+      prev = req;
+    }
+
+    if (merged != 0U)
+    {
+      if (prev == NULL)
+      {
+        hqueue->pHead = req->pNext;
+      }
+      else
+      {
+        prev->pNext = req->pNext;
+      }
+
+      if (req->Lba == SDQUEUE_END(last))
+      {
+        last->pNext = req;
+        req->pNext = NULL;
+        last = req;
+      }
+      else
+      {
+        req->pNext = first;
+        first = req;
+      }
+      count += req->Count;
+      hqueue->Stats.Merged++;
+    }
+  } while (merged != 0U);
+
+  if (hqueue->pHead == NULL)
+  {
+    hqueue->pTail = NULL;
+  }
+  else
+  {
+    for (req = hqueue->pHead; req->pNext != NULL; req = req->pNext)
+    {
+    }
+    hqueue->pTail = req;
+  }
+
+  hqueue->pBatch = first;
+  hqueue->Phase  = SDQUEUE_PHASE_XFER;
+  hqueue->Stats.Commands++;
+
+  if (first->Op == BSP_SDQUEUE_OP_READ)
+  {
+    status = HAL_SD_ReadBlocks_DMA(hsd, first->pData, first->Lba, count);
+  }
+  else
+  {
+    status = HAL_SD_WriteBlocks_DMA(hsd, first->pData, first->Lba, count);
+  }
+
+  if (status != HAL_OK)
+  {
+    hsd->ErrorCode |= HAL_SD_ERROR_REQUEST_NOT_APPLICABLE;
+    SDQUEUE_End(hqueue, BSP_SDQUEUE_STATUS_ERROR);
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Hold CMD13 until the card releases DAT0 after a write.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  Status A value of @ref BSP_SDQUEUE_Status, result of the transfer.
+  * @retval None
+  */
+static void SDQUEUE_Program(BSP_SDQUEUE_TypeDef *hqueue, uint32_t Status)
+{
+  SD_HandleTypeDef *hsd = hqueue->hsd;
+
+  hqueue->BatchStatus = Status;
+  hqueue->Phase = SDQUEUE_PHASE_PROG;
+  hsd->State = HAL_SD_STATE_BUSY;
+
+  __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_CMD_FLAGS);
+  __HAL_SD_ENABLE_IT(hsd, SDQUEUE_IT_CMD);
+
+  hsd->Instance->ARG = (uint32_t)(hsd->SdCard.RelCardAdd << 16U);
+  MODIFY_REG(hsd->Instance->CMD, CMD_CLEAR_MASK | SDIO_CMD_ABORTCMD,
+             SDMMC_CMD_SEND_STATUS | SDIO_RESPONSE_SHORT | SDIO_CHECK_CRC_ENABLE |
+             SDIO_WAIT_PEND_ENABLE | SDIO_CPSM_ENABLE);
+}
+
+/**
+  * @brief  End the requests of the command on the bus.
+  * @param  hqueue Pointer to a BSP_SDQUEUE_TypeDef structure.
+  * @param  Status A value of @ref BSP_SDQUEUE_Status.
+  * @retval None
+  */
+static void SDQUEUE_End(BSP_SDQUEUE_TypeDef *hqueue, uint32_t Status)
+{
+  BSP_SDQUEUE_ReqTypeDef *req = hqueue->pBatch;
+  BSP_SDQUEUE_ReqTypeDef *next;
+  uint32_t errorcode = hqueue->hsd->ErrorCode;
+
+  hqueue->pBatch = NULL;
+  hqueue->Phase  = SDQUEUE_PHASE_IDLE;
+
+  /* The card gets its next command whatever the callbacks do */
+  hqueue->hsd->ErrorCode = HAL_SD_ERROR_NONE;
+
+  while (req != NULL)
+  {
+    next = req->pNext;
+    hqueue->Stats.Requests++;
+    if (Status == BSP_SDQUEUE_STATUS_OK)
+    {
+      hqueue->Stats.Blocks += req->Count;
+    }
+    else
+    {
+      hqueue->Stats.Errors++;
+      req->ErrorCode = errorcode;
+    }
+    req->Status = Status;
+    BSP_SDQUEUE_ReqCpltCallback(hqueue, req);
+    req = next;
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
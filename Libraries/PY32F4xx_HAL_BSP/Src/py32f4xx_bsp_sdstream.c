@@ -0,0 +1,744 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sdstream.c
+  * @author  MCU Application Team
+  * @brief   SD card streaming write BSP service.
+  *          This file provides functions to write a continuous stream of
+  *          blocks to an SD card:
+  *           + One open-ended CMD25 for the whole stream, pre-erased by ACMD23
+  *           + A queue of buffers, the next one started by the DMA completion
+  *           + End of the card programming signalled by an interrupt
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_SD_WriteBlocks_DMA() sends CMD16 and CMD25 for each call, and the
+       card must leave the programming state, polled with
+       HAL_SD_GetCardState(), before the next one. A logger loses the card
+       bandwidth in these gaps. Here one CMD25 stays open for the stream:
+       the data length of the controller is 0, the data path waits for more
+       blocks until CMD12, and the card clock is held while the FIFO is
+       empty. The card writes the blocks as they come.
+
+   (#) Initialize the card with HAL_SD_Init() and HAL_SD_ConfigWideBusOperation(),
+       link the Tx DMA channel with __HAL_LINKDMA(hsd, hdmatx, hdma): memory
+       to peripheral, words, memory increment, DMA_NORMAL. Enable the DMA and
+       the SDIO interrupts. Call BSP_SDSTREAM_IRQHandler() from
+       SDIO_IRQHandler(): it hands the interrupts to HAL_SD_IRQHandler() when
+       no stream is in progress.
+
+   (#) BSP_SDSTREAM_Start() opens a stream at a block of the card. Give the
+       blocks the stream is expected to write in PreEraseBlocks: ACMD23 lets
+       the card erase them ahead, the writes then run at the card speed
+       without erase stalls. 0 skips it; more blocks than written are only
+       erased, less are written the slow way.
+
+   (#) BSP_SDSTREAM_Write() queues a buffer of whole blocks, word aligned, up
+       to BSP_SDSTREAM_QUEUE buffers. It returns HAL_BUSY when the queue is
+       full. The DMA completion of a buffer starts the next one from the
+       interrupt and calls BSP_SDSTREAM_TxCpltCallback(): that buffer may then
+       be filled again. Stats.Underruns counts the completions with nothing
+       queued, the card then waits for data.
+
+   (#) BSP_SDSTREAM_Stop() lets the queue drain, then sends CMD12 and CMD13
+       with the wait of the previous data: the controller holds CMD13 while
+       the card signals busy on DAT0, so the response interrupt marks the end
+       of the programming. BSP_SDSTREAM_StopCpltCallback() is called then,
+       the SD handle is READY again for the other HAL_SD functions.
+
+   (#) A data error, a failed DMA start or an error of the card aborts the
+       stream with CMD12: the queue is flushed, the error is added to
+       hsd->ErrorCode, and BSP_SDSTREAM_ErrorCallback() is called.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_sdstream.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SDSTREAM BSP SDSTREAM
+  * @brief SD card streaming write BSP service
+  * @{
+  */
+
+#if defined (HAL_SD_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Private_Constants BSP SDSTREAM Private Constants
+  * @{
+  */
+#define SDSTREAM_IT_DATA                (SDIO_IT_DCRC | SDIO_IT_DRTO_BDS | SDIO_IT_FRUN | SDIO_IT_SBE | SDIO_IT_EBE)
+#define SDSTREAM_IT_CMD                 (SDIO_IT_CD | SDIO_IT_RE | SDIO_IT_RCRC | SDIO_IT_RTO_BAR)
+#define SDSTREAM_FIFO_TIMEOUT           10U            /* ms, one FIFO of data at the card clock      */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Private_Variables BSP SDSTREAM Private Variables
+  * @{
+  */
+/* The SDIO has one instance, one stream at a time */
+static BSP_SDSTREAM_TypeDef *SDSTREAM_Active;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Private_Functions BSP SDSTREAM Private Functions
+  * @{
+  */
+static uint32_t          SDSTREAM_Command(SDIO_TypeDef *SDIOx, uint32_t CmdIndex, uint32_t Argument,
+                                          uint32_t Flags, uint32_t Wait);
+static HAL_StatusTypeDef SDSTREAM_Next(BSP_SDSTREAM_TypeDef *hs);
+static void              SDSTREAM_Finish(BSP_SDSTREAM_TypeDef *hs);
+static void              SDSTREAM_Release(BSP_SDSTREAM_TypeDef *hs);
+static void              SDSTREAM_Abort(BSP_SDSTREAM_TypeDef *hs, uint32_t ErrorCode);
+static void              SDSTREAM_DMATxCplt(DMA_HandleTypeDef *hdma);
+static void              SDSTREAM_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SDSTREAM_Exported_Functions BSP SDSTREAM Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a streaming writer.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  hsd SD handle, card initialized, Tx DMA linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SDSTREAM_Init(BSP_SDSTREAM_TypeDef *hs, SD_HandleTypeDef *hsd)
+{
+  if ((hs == NULL) || (hsd == NULL) || (hsd->hdmatx == NULL) ||
+      ((BSP_SDSTREAM_QUEUE & (BSP_SDSTREAM_QUEUE - 1U)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  hs->hsd       = hsd;
+  hs->BlockAdd  = 0U;
+  hs->PreErased = 0U;
+  hs->Head      = 0U;
+  hs->Tail      = 0U;
+  hs->InFlight  = 0U;
+
+  hs->Stats.Blocks    = 0U;
+  hs->Stats.Buffers   = 0U;
+  hs->Stats.Underruns = 0U;
+  hs->Stats.MaxQueued = 0U;
+  hs->Stats.Streams   = 0U;
+  hs->Stats.Errors    = 0U;
+
+  hs->State = BSP_SDSTREAM_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Open a stream: ACMD23, CMD16 and an open-ended CMD25.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  BlockAdd First block of the stream.
+  * @param  PreEraseBlocks Blocks expected, erased ahead by the card, 0 for none.
+  * @retval HAL status, HAL_BUSY while the card is programming
+  */
+HAL_StatusTypeDef BSP_SDSTREAM_Start(BSP_SDSTREAM_TypeDef *hs, uint32_t BlockAdd, uint32_t PreEraseBlocks)
+{
+  SD_HandleTypeDef *hsd = hs->hsd;
+  SDIO_DataInitTypeDef config;
+  uint32_t errorstate;
+  uint32_t add = BlockAdd;
+
+  if ((BlockAdd >= hsd->SdCard.LogBlockNbr) || (PreEraseBlocks > BSP_SDSTREAM_PRE_ERASE_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hs->State != BSP_SDSTREAM_STATE_READY) || (hsd->State != HAL_SD_STATE_READY) ||
+      (READ_BIT(hsd->Instance->STATUS, SDIO_STATUS_CARDBSY) != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  hsd->ErrorCode = HAL_SD_ERROR_NONE;
+  hsd->State     = HAL_SD_STATE_BUSY;
+  hsd->Context   = (SD_CONTEXT_WRITE_MULTIPLE_BLOCK | SD_CONTEXT_DMA);
+
+  if (hsd->SdCard.CardType != CARD_SDHC_SDXC)
+  {
+    add *= BLOCKSIZE;
+  }
+
+  errorstate = HAL_SD_ERROR_NONE;
+  if (PreEraseBlocks != 0U)
+  {
+    /* ACMD23 SET_WR_BLK_ERASE_COUNT, for the next multiple block write only */
+    errorstate = SDMMC_CmdAppCommand(hsd->Instance, (uint32_t)(hsd->SdCard.RelCardAdd << 16U));
+    if (errorstate == HAL_SD_ERROR_NONE)
+    {
+      errorstate = SDSTREAM_Command(hsd->Instance, SDMMC_CMD_SET_BLOCK_COUNT, PreEraseBlocks, 0U, 1U);
+    }
+  }
+
+  if (errorstate == HAL_SD_ERROR_NONE)
+  {
+    errorstate = SDMMC_CmdBlockLength(hsd->Instance, BLOCKSIZE);
+  }
+
+  if (errorstate == HAL_SD_ERROR_NONE)
+  {
+    /* Data length 0: open-ended, the data path runs until CMD12 */
+    config.DataTimeOut   = SDMMC_DATATIMEOUT;
+    config.DataLength    = 0U;
+    config.DataBlockSize = BLOCKSIZE;
+    config.TransferDir   = SDIO_TRANSFER_DIR_TO_CARD;
+    config.TransferMode  = SDIO_TRANSFER_MODE_BLOCK;
+    (void)SDIO_ConfigData(hsd->Instance, &config);
+
+    hsd->hdmatx->XferCpltCallback  = SDSTREAM_DMATxCplt;
+    hsd->hdmatx->XferErrorCallback = SDSTREAM_DMAError;
+    hsd->hdmatx->XferAbortCallback = NULL;
+    __HAL_SD_DMA_ENABLE(hsd);
+
+    __SDIO_AUTO_STOP_CMD_DISABLE(hsd->Instance);
+    errorstate = SDMMC_CmdWriteMultiBlock(hsd->Instance, add);
+  }
+
+  if (errorstate != HAL_SD_ERROR_NONE)
+  {
+    __HAL_SD_DMA_DISABLE(hsd);
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_FLAGS);
+    hsd->ErrorCode |= errorstate;
+    hsd->State      = HAL_SD_STATE_READY;
+    hsd->Context    = SD_CONTEXT_NONE;
+    return HAL_ERROR;
+  }
+
+  hs->BlockAdd  = BlockAdd;
+  hs->PreErased = PreEraseBlocks;
+  hs->Head      = 0U;
+  hs->Tail      = 0U;
+  hs->InFlight  = 0U;
+  SDSTREAM_Active = hs;
+
+  __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_DATA_FLAGS);
+  __HAL_SD_ENABLE_IT(hsd, SDSTREAM_IT_DATA);
+
+  hs->State = BSP_SDSTREAM_STATE_RUN;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue blocks to the stream.
+  * @note   The buffer belongs to the service until BSP_SDSTREAM_TxCpltCallback().
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  pData Blocks, word aligned.
+  * @param  NbrOfBlocks Blocks, 1 to BSP_SDSTREAM_BUFFER_BLOCKS_MAX.
+  * @retval HAL status, HAL_BUSY when the queue is full
+  */
+HAL_StatusTypeDef BSP_SDSTREAM_Write(BSP_SDSTREAM_TypeDef *hs, const uint8_t *pData, uint32_t NbrOfBlocks)
+{
+  BSP_SDSTREAM_BufferTypeDef *buffer;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t primask_bit;
+  uint32_t queued;
+
+  if ((pData == NULL) || (((uint32_t)pData & 3U) != 0U) ||
+      (NbrOfBlocks == 0U) || (NbrOfBlocks > BSP_SDSTREAM_BUFFER_BLOCKS_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hs->State != BSP_SDSTREAM_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  queued = hs->Head - hs->Tail;
+  if (queued >= BSP_SDSTREAM_QUEUE)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_BUSY;
+  }
+  if ((hs->BlockAdd + NbrOfBlocks) > hs->hsd->SdCard.LogBlockNbr)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_ERROR;
+  }
+
+  buffer = &hs->Queue[hs->Head & (BSP_SDSTREAM_QUEUE - 1U)];
+  buffer->pData       = pData;
+  buffer->NbrOfBlocks = NbrOfBlocks;
+  hs->Head++;
+  hs->BlockAdd += NbrOfBlocks;
+
+  if ((queued + 1U) > hs->Stats.MaxQueued)
+  {
+    hs->Stats.MaxQueued = queued + 1U;
+  }
+
+  if (hs->InFlight == 0U)
+  {
+    status = SDSTREAM_Next(hs);
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  if (status != HAL_OK)
+  {
+    SDSTREAM_Abort(hs, HAL_SD_ERROR_DMA);
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Close the stream once the queue is written.
+  * @note   BSP_SDSTREAM_StopCpltCallback() is called at the end of the card programming.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SDSTREAM_Stop(BSP_SDSTREAM_TypeDef *hs)
+{
+  uint32_t primask_bit;
+  uint32_t drained;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (hs->State != BSP_SDSTREAM_STATE_RUN)
+  {
+    __set_PRIMASK(primask_bit);
+    return HAL_BUSY;
+  }
+  hs->State = BSP_SDSTREAM_STATE_STOP;
+  drained = (hs->InFlight == 0U) ? 1U : 0U;
+
+  __set_PRIMASK(primask_bit);
+
+  if (drained != 0U)
+  {
+    SDSTREAM_Finish(hs);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Buffers queued, the one in transfer included.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval Buffers
+  */
+uint32_t BSP_SDSTREAM_GetQueued(const BSP_SDSTREAM_TypeDef *hs)
+{
+  return hs->Head - hs->Tail;
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_SDSTREAM_GetStats(const BSP_SDSTREAM_TypeDef *hs, BSP_SDSTREAM_StatsTypeDef *pStats)
+{
+  *pStats = hs->Stats;
+}
+
+/**
+  * @brief  Handle the SDIO interrupt.
+  * @note   Call it from SDIO_IRQHandler(), in place of HAL_SD_IRQHandler().
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval None
+  */
+void BSP_SDSTREAM_IRQHandler(BSP_SDSTREAM_TypeDef *hs)
+{
+  SD_HandleTypeDef *hsd = hs->hsd;
+  uint32_t status;
+  uint32_t response;
+
+  if ((hs->State == BSP_SDSTREAM_STATE_RESET) || (hs->State == BSP_SDSTREAM_STATE_READY))
+  {
+    HAL_SD_IRQHandler(hsd);
+    return;
+  }
+
+  status = hsd->Instance->INTSTS & hsd->Instance->INTMASK;
+
+  if ((status & SDSTREAM_IT_DATA) != 0U)
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, status & SDSTREAM_IT_DATA);
+    if ((status & SDIO_FLAG_DCRC) != 0U)
+    {
+      SDSTREAM_Abort(hs, HAL_SD_ERROR_DATA_CRC_FAIL);
+    }
+    else if ((status & SDIO_FLAG_DRTO_BDS) != 0U)
+    {
+      SDSTREAM_Abort(hs, HAL_SD_ERROR_DATA_TIMEOUT);
+    }
+    else
+    {
+      SDSTREAM_Abort(hs, HAL_SD_ERROR_FIFO_ERR);
+    }
+    return;
+  }
+
+  if (hs->State != BSP_SDSTREAM_STATE_BUSY)
+  {
+    return;
+  }
+
+  if ((status & (SDIO_FLAG_RE | SDIO_FLAG_RCRC | SDIO_FLAG_RTO_BAR)) != 0U)
+  {
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_CMD_FLAGS);
+    SDSTREAM_Abort(hs, ((status & SDIO_FLAG_RTO_BAR) != 0U) ? HAL_SD_ERROR_CMD_RSP_TIMEOUT : HAL_SD_ERROR_CMD_CRC_FAIL);
+  }
+  else if ((status & SDIO_FLAG_CD) != 0U)
+  {
+    /* CMD13 answered: DAT0 released, the card is done programming */
+    __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_CMD_FLAGS);
+    response = SDIO_GetResponse(hsd->Instance, SDIO_RESP1);
+    SDSTREAM_Release(hs);
+
+    if ((response & SDMMC_OCR_ERRORBITS) != 0U)
+    {
+      hsd->ErrorCode |= HAL_SD_ERROR_GENERAL_UNKNOWN_ERR;
+      hs->Stats.Errors++;
+      hs->State = BSP_SDSTREAM_STATE_READY;
+      BSP_SDSTREAM_ErrorCallback(hs);
+    }
+    else
+    {
+      hs->Stats.Streams++;
+      hs->State = BSP_SDSTREAM_STATE_READY;
+      BSP_SDSTREAM_StopCpltCallback(hs);
+    }
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+}
+
+/**
+  * @brief  Buffer written callback.
+  * @note   Called from the DMA interrupt, the buffer may be filled and queued again.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  pData Buffer given to BSP_SDSTREAM_Write().
+  * @retval None
+  */
+__weak void BSP_SDSTREAM_TxCpltCallback(BSP_SDSTREAM_TypeDef *hs, const uint8_t *pData)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hs);
+  UNUSED(pData);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SDSTREAM_TxCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Stream closed callback, the card done programming.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_SDSTREAM_StopCpltCallback(BSP_SDSTREAM_TypeDef *hs)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hs);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SDSTREAM_StopCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Stream aborted callback, the error in hsd->ErrorCode.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_SDSTREAM_ErrorCallback(BSP_SDSTREAM_TypeDef *hs)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hs);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SDSTREAM_ErrorCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SDSTREAM_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Send a command with a short response.
+  * @param  SDIOx Pointer to SDIO register base.
+  * @param  CmdIndex Command index.
+  * @param  Argument Command argument.
+  * @param  Flags SDIO_CMD_WAITPEND and SDIO_CMD_ABORTCMD, or 0.
+  * @param  Wait 1 to wait for the R1 response and check it, 0 to return once sent.
+  * @retval SD error state
+  */
+static uint32_t SDSTREAM_Command(SDIO_TypeDef *SDIOx, uint32_t CmdIndex, uint32_t Argument,
+                                 uint32_t Flags, uint32_t Wait)
+{
+  /* 8 is the number of required instructions cycles for the below loop statement */
+  uint32_t count = SDIO_CMDTIMEOUT * (SystemCoreClock / 8U / 1000U);
+  uint32_t sta_reg;
+
+  SDIOx->ARG = Argument;
+  MODIFY_REG(SDIOx->CMD, CMD_CLEAR_MASK | SDIO_CMD_ABORTCMD,
+             CmdIndex | SDIO_RESPONSE_SHORT | SDIO_CHECK_CRC_ENABLE | Flags | SDIO_CPSM_ENABLE);
+
+  if (Wait == 0U)
+  {
+    return HAL_SD_ERROR_NONE;
+  }
+
+  do
+  {
+    if (count-- == 0U)
+    {
+      return HAL_SD_ERROR_TIMEOUT;
+    }
+    sta_reg = SDIOx->INTSTS;
+  } while ((sta_reg & (SDIO_FLAG_RE | SDIO_FLAG_CD | SDIO_FLAG_RCRC | SDIO_FLAG_RTO_BAR)) == 0U);
+
+  __SDIO_CLEAR_FLAG(SDIOx, SDIO_STATIC_CMD_FLAGS);
+
+  if ((sta_reg & SDIO_FLAG_RTO_BAR) != 0U)
+  {
+    return HAL_SD_ERROR_CMD_RSP_TIMEOUT;
+  }
+  if ((sta_reg & SDIO_FLAG_RCRC) != 0U)
+  {
+    return HAL_SD_ERROR_CMD_CRC_FAIL;
+  }
+  if ((sta_reg & SDIO_FLAG_RE) != 0U)
+  {
+    return HAL_SD_ERROR_CMD_RSP_ERR;
+  }
+  if ((SDIO_GetResponse(SDIOx, SDIO_RESP1) & SDMMC_OCR_ERRORBITS) != 0U)
+  {
+    return HAL_SD_ERROR_GENERAL_UNKNOWN_ERR;
+  }
+
+  return HAL_SD_ERROR_NONE;
+}
+
+/**
+  * @brief  Start the DMA of the buffer at the tail of the queue.
+  * @note   Called with the interrupts disabled or from the DMA interrupt.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SDSTREAM_Next(BSP_SDSTREAM_TypeDef *hs)
+{
+  const BSP_SDSTREAM_BufferTypeDef *buffer = &hs->Queue[hs->Tail & (BSP_SDSTREAM_QUEUE - 1U)];
+
+  hs->InFlight = 1U;
+
+  return HAL_DMA_Start_IT(hs->hsd->hdmatx, (uint32_t)buffer->pData, (uint32_t)&hs->hsd->Instance->FIFODATA,
+                          (buffer->NbrOfBlocks * BLOCKSIZE) / 4U);
+}
+
+/**
+  * @brief  Close the drained stream: CMD12, then CMD13 held until DAT0 is released.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval None
+  */
+static void SDSTREAM_Finish(BSP_SDSTREAM_TypeDef *hs)
+{
+  SD_HandleTypeDef *hsd = hs->hsd;
+  uint32_t count = SDSTREAM_FIFO_TIMEOUT * (SystemCoreClock / 8U / 1000U);
+  uint32_t errorstate;
+
+  /* The DMA is done once the FIFO holds the last words, let the card take them */
+  while (READ_BIT(hsd->Instance->STATUS, SDIO_STATUS_FIFOE) == 0U)
+  {
+    if (count-- == 0U)
+    {
+      SDSTREAM_Abort(hs, HAL_SD_ERROR_TIMEOUT);
+      return;
+    }
+  }
+
+  errorstate = SDSTREAM_Command(hsd->Instance, SDMMC_CMD_STOP_TRANSMISSION, 0U, SDIO_CMD_ABORTCMD, 1U);
+  if (errorstate != HAL_SD_ERROR_NONE)
+  {
+    SDSTREAM_Abort(hs, errorstate);
+    return;
+  }
+
+  hs->State = BSP_SDSTREAM_STATE_BUSY;
+
+  __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_CMD_FLAGS);
+  __HAL_SD_ENABLE_IT(hsd, SDSTREAM_IT_CMD);
+  (void)SDSTREAM_Command(hsd->Instance, SDMMC_CMD_SEND_STATUS, (uint32_t)(hsd->SdCard.RelCardAdd << 16U),
+                         SDIO_WAIT_PEND_ENABLE, 0U);
+}
+
+/**
+  * @brief  Give the SD handle back to the HAL.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @retval None
+  */
+static void SDSTREAM_Release(BSP_SDSTREAM_TypeDef *hs)
+{
+  SD_HandleTypeDef *hsd = hs->hsd;
+
+  __HAL_SD_DISABLE_IT(hsd, SDSTREAM_IT_DATA | SDSTREAM_IT_CMD);
+  __HAL_SD_DMA_DISABLE(hsd);
+  __HAL_SD_CLEAR_FLAG(hsd, SDIO_STATIC_FLAGS);
+
+  hs->Tail     = hs->Head;
+  hs->InFlight = 0U;
+  SDSTREAM_Active = NULL;
+
+  hsd->State   = HAL_SD_STATE_READY;
+  hsd->Context = SD_CONTEXT_NONE;
+}
+
+/**
+  * @brief  Abort the stream on an error.
+  * @param  hs Pointer to a BSP_SDSTREAM_TypeDef structure.
+  * @param  ErrorCode SD error, added to hsd->ErrorCode.
+  * @retval None
+  */
+static void SDSTREAM_Abort(BSP_SDSTREAM_TypeDef *hs, uint32_t ErrorCode)
+{
+  SD_HandleTypeDef *hsd = hs->hsd;
+
+  __HAL_SD_DISABLE_IT(hsd, SDSTREAM_IT_DATA | SDSTREAM_IT_CMD);
+  if (hs->InFlight != 0U)
+  {
+    (void)HAL_DMA_Abort(hsd->hdmatx);
+  }
+  (void)SDSTREAM_Command(hsd->Instance, SDMMC_CMD_STOP_TRANSMISSION, 0U, SDIO_CMD_ABORTCMD, 1U);
+
+  SDSTREAM_Release(hs);
+  hsd->ErrorCode |= ErrorCode;
+  hs->Stats.Errors++;
+  hs->State = BSP_SDSTREAM_STATE_READY;
+
+  BSP_SDSTREAM_ErrorCallback(hs);
+}
+
+/**
+  * @brief  DMA transfer complete callback: release the buffer, start the next one.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void SDSTREAM_DMATxCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_SDSTREAM_TypeDef *hs = SDSTREAM_Active;
+  const BSP_SDSTREAM_BufferTypeDef *buffer;
+  const uint8_t *data;
+
+  UNUSED(hdma);
+
+  if (hs == NULL)
+  {
+    return;
+  }
+
+  buffer = &hs->Queue[hs->Tail & (BSP_SDSTREAM_QUEUE - 1U)];
+  data = buffer->pData;
+  hs->Stats.Blocks += buffer->NbrOfBlocks;
+  hs->Stats.Buffers++;
+  hs->Tail++;
+  hs->InFlight = 0U;
+
+  BSP_SDSTREAM_TxCpltCallback(hs, data);
+
+  /* The callback may have queued a buffer, started it, or stopped the stream */
+  if (hs->InFlight != 0U)
+  {
+    return;
+  }
+  if (hs->Head != hs->Tail)
+  {
+    if (SDSTREAM_Next(hs) != HAL_OK)
+    {
+      SDSTREAM_Abort(hs, HAL_SD_ERROR_DMA);
+    }
+  }
+  else if (hs->State == BSP_SDSTREAM_STATE_STOP)
+  {
+    SDSTREAM_Finish(hs);
+  }
+  else if (hs->State == BSP_SDSTREAM_STATE_RUN)
+  {
+    hs->Stats.Underruns++;
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+}
+
+/**
+  * @brief  DMA error callback.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void SDSTREAM_DMAError(DMA_HandleTypeDef *hdma)
+{
+  UNUSED(hdma);
+
+  if (SDSTREAM_Active != NULL)
+  {
+    SDSTREAM_Active->InFlight = 0U;
+    SDSTREAM_Abort(SDSTREAM_Active, HAL_SD_ERROR_DMA);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SD_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
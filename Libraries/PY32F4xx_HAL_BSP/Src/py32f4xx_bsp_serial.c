@@ -0,0 +1,841 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_serial.c
+  * @author  MCU Application Team
+  * @brief   Serial stream multiplexer BSP service.
+  *          This file provides functions to run USART1 to USART5 together:
+  *           + DMA receive and transmit rings per port
+  *           + One poll function returning per port readiness bits
+  *           + A short UART interrupt handler for the multiplexed ports
+  *           + RTS flow control on the fill level of the receive ring
+  *           + In place access to the receive ring for parsers
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize each UART with HAL_UART_Init(), link a DMA channel in
+       DMA_CIRCULAR mode to its hdmarx and one in DMA_NORMAL mode to its hdmatx,
+       and enable the UART and both DMA channel interrupts in the NVIC.
+
+   (#) Call BSP_SERIAL_Open() with the UART handle and the receive and transmit
+       ring buffers. The port number (@ref BSP_SERIAL_Port) follows the UART
+       instance, BSP_SERIAL_GetPort() returns it. The port then owns the UART:
+       the HAL transfer functions must not be used on it until BSP_SERIAL_Close().
+
+   (#) In the USARTx_IRQHandler() of an open port call BSP_SERIAL_IRQHandler()
+       instead of HAL_UART_IRQHandler(). It reads the status register once and
+       only handles the idle line and the error flags, the data itself is moved
+       by the DMA.
+
+   (#) Main loop:
+       (+) BSP_SERIAL_Poll() returns the readiness bits (@ref BSP_SERIAL_Event)
+           of the ports selected by the Events mask: BSP_SERIAL_EVENT_RX() when
+           received data is waiting, BSP_SERIAL_EVENT_TX() when the Tx ring has
+           room and BSP_SERIAL_EVENT_ERR() when an error occurred since the
+           previous poll. With a Timeout the CPU sleeps in WFI until a port is
+           ready, any interrupt (SysTick included) wakes it to check again.
+       (+) Only the ports reported ready are serviced with BSP_SERIAL_Read() and
+           BSP_SERIAL_Write().
+       (+) BSP_SERIAL_Write() of a port must be called from a single context.
+       (+) A parser can scan the received data where the DMA wrote it instead:
+           BSP_SERIAL_Acquire() returns the next contiguous block of the ring,
+           BSP_SERIAL_Commit() releases the bytes it has consumed. The ring
+           wraps at most once, so two calls return all the data waiting.
+
+   (#) Flow control:
+       (+) CTS is handled by the USART: initialize the UART with
+           UART_HWCONTROL_CTS, the Tx DMA then waits while the peer holds CTS
+           high. All five USARTs have it.
+       (+) The nRTS output of the USART only follows its one byte data
+           register, which the Rx DMA empties at once: it cannot stop the peer
+           before the receive ring overflows. Configure the RTS pin as a GPIO
+           push-pull output instead and call BSP_SERIAL_SetFlowControl() with
+           two watermarks. RTS is raised once HighWater bytes wait in the ring
+           and lowered when BSP_SERIAL_Read() drains it to LowWater.
+       (+) The ring is checked on each idle line, on the half and full ring
+           DMA interrupts, on each BSP_SERIAL_Read() and on each
+           BSP_SERIAL_Tick(), to call periodically e.g. from SysTick at 1 kHz.
+           The room above HighWater must hold what is received in one tick
+           period plus what the peer sends after RTS rises: 300 bytes per ms
+           at 3 Mbaud, plus the FIFO of a modem.
+
+   (#) BSP_SERIAL_NotifyCallback() is called from the UART interrupt with the
+       readiness bits raised by an idle line or an error, it can be implemented
+       to wake a task instead of polling.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_serial.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SERIAL BSP SERIAL
+  * @brief Serial stream multiplexer BSP service
+  * @{
+  */
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Private_Constants BSP SERIAL Private Constants
+  * @{
+  */
+#define SERIAL_MAX_XFER_SIZE      0xFFFFU     /*!< Largest DMA transfer, CNDTR is 16-bit */
+#define SERIAL_UART_ERRORS        (USART_SR_PE | USART_SR_FE | USART_SR_NE | USART_SR_ORE)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Private_Variables BSP SERIAL Private Variables
+  * @{
+  */
+static USART_TypeDef * const SERIAL_Instances[BSP_SERIAL_PORT_NUMBER] =
+{
+  USART1, USART2, USART3, USART4, USART5
+};
+
+static BSP_SERIAL_PortTypeDef SERIAL_Ports[BSP_SERIAL_PORT_NUMBER];
+
+/* Readiness bits raised from interrupts, cleared when returned by BSP_SERIAL_Poll() */
+static __IO uint32_t SERIAL_Pending;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SERIAL_Private_Functions
+  * @{
+  */
+static void     SERIAL_SetPending(uint32_t Events);
+static uint32_t SERIAL_GetReady(uint32_t Events);
+static uint32_t SERIAL_GetTxRoom(const BSP_SERIAL_PortTypeDef *pPort);
+static void     SERIAL_Kick(BSP_SERIAL_PortTypeDef *pPort);
+static void     SERIAL_UpdateRts(BSP_SERIAL_PortTypeDef *pPort);
+static void     SERIAL_DMARxEvent(DMA_HandleTypeDef *hdma);
+static void     SERIAL_DMATxCplt(DMA_HandleTypeDef *hdma);
+static void     SERIAL_DMATxError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SERIAL_Exported_Functions BSP SERIAL Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SERIAL_Exported_Functions_Group1 Port functions
+  * @brief    Port functions
+  *
+@verbatim
+ ===============================================================================
+                        ##### Port functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Open and close a port
+      (+) Read and write the port rings
+      (+) Scan the receive ring in place
+      (+) Set the RTS flow control of a port
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Open a port and start its DMA reception.
+  * @param  huart Pointer to a UART_HandleTypeDef structure, hdmarx in DMA_CIRCULAR
+  *               mode and hdmatx in DMA_NORMAL mode must be linked.
+  * @param  pRxBuffer Receive ring storage.
+  * @param  RxSize Receive ring size in bytes, at most 65535.
+  * @param  pTxBuffer Transmit ring storage.
+  * @param  TxSize Transmit ring size in bytes, at least 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SERIAL_Open(UART_HandleTypeDef *huart, uint8_t *pRxBuffer, uint32_t RxSize,
+                                  uint8_t *pTxBuffer, uint32_t TxSize)
+{
+  BSP_SERIAL_PortTypeDef *pPort;
+  uint32_t port;
+
+  if ((huart == NULL) || (huart->hdmarx == NULL) || (huart->hdmatx == NULL) ||
+      (pTxBuffer == NULL) || (TxSize < 2U))
+  {
+    return HAL_ERROR;
+  }
+
+  port = BSP_SERIAL_GetPort(huart);
+  if (port >= BSP_SERIAL_PORT_NUMBER)
+  {
+    return HAL_ERROR;
+  }
+
+  pPort = &SERIAL_Ports[port];
+  if ((pPort->huart != NULL) || (huart->gState != HAL_UART_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_DMAEx_RingInit(&pPort->Rx, pRxBuffer, RxSize) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (HAL_UART_ReceiveToRing_DMA(huart, &pPort->Rx) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  pPort->pTxBuffer  = pTxBuffer;
+  pPort->TxSize     = TxSize;
+  pPort->TxHead     = 0U;
+  pPort->TxTail     = 0U;
+  pPort->TxXferSize = 0U;
+  pPort->ErrorCount = 0U;
+  pPort->RtsPort    = NULL;
+  pPort->Throttled  = 0U;
+  pPort->Throttles  = 0U;
+
+  /* The ring fill level is checked for the RTS flow control at each half */
+  huart->hdmarx->XferHalfCpltCallback = SERIAL_DMARxEvent;
+  huart->hdmarx->XferCpltCallback     = SERIAL_DMARxEvent;
+
+  /* The Tx DMA completion drives the Tx ring, no UART interrupt is used for it */
+  huart->gState = HAL_UART_STATE_BUSY_TX;
+  huart->hdmatx->XferCpltCallback     = SERIAL_DMATxCplt;
+  huart->hdmatx->XferHalfCpltCallback = NULL;
+  huart->hdmatx->XferErrorCallback    = SERIAL_DMATxError;
+  huart->hdmatx->XferAbortCallback    = NULL;
+  SET_BIT(huart->Instance->CR3, USART_CR3_DMAT);
+
+  /* An idle line reports the end of a burst of received data */
+  __HAL_UART_CLEAR_IDLEFLAG(huart);
+  SET_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+
+  pPort->huart = huart;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the transfers of a port and give the UART back to the HAL.
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SERIAL_Close(uint32_t Port)
+{
+  UART_HandleTypeDef *huart;
+
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  huart = SERIAL_Ports[Port].huart;
+  SERIAL_Ports[Port].huart = NULL;
+
+  /* The peer is held off until the port is opened again */
+  if (SERIAL_Ports[Port].RtsPort != NULL)
+  {
+    HAL_GPIO_WritePin(SERIAL_Ports[Port].RtsPort, SERIAL_Ports[Port].RtsPin, GPIO_PIN_SET);
+    SERIAL_Ports[Port].RtsPort = NULL;
+  }
+
+  CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  (void)HAL_UART_Abort(huart);
+  SERIAL_Ports[Port].TxXferSize = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy received data out of the receive ring of a port.
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @param  pData Destination buffer.
+  * @param  Length Size of the destination buffer in bytes.
+  * @retval Number of bytes copied
+  */
+uint32_t BSP_SERIAL_Read(uint32_t Port, uint8_t *pData, uint32_t Length)
+{
+  BSP_SERIAL_PortTypeDef *pPort;
+  uint32_t copied = 0U;
+  uint32_t length;
+  uint8_t *pBlock;
+
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return 0U;
+  }
+  pPort = &SERIAL_Ports[Port];
+
+  /* At most two blocks when the data wraps at the end of the ring */
+  while (copied < Length)
+  {
+    length = HAL_DMAEx_RingAcquire(&pPort->Rx, &pBlock);
+    if (length == 0U)
+    {
+      break;
+    }
+    if (length > (Length - copied))
+    {
+      length = Length - copied;
+    }
+    memcpy(&pData[copied], pBlock, length);
+    HAL_DMAEx_RingCommit(&pPort->Rx, length);
+    copied += length;
+  }
+
+  if (pPort->Throttled != 0U)
+  {
+    SERIAL_UpdateRts(pPort);
+  }
+
+  return copied;
+}
+
+/**
+  * @brief  Return the next contiguous block of received data of a port, in place.
+  * @note   The block stays valid until BSP_SERIAL_Commit(), it must be
+  *         released before the DMA wraps around the ring onto it.
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @param  ppData Returns the address of the block in the receive ring.
+  * @retval Size of the block in bytes, 0 when no data is waiting
+  */
+uint32_t BSP_SERIAL_Acquire(uint32_t Port, uint8_t **ppData)
+{
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return 0U;
+  }
+
+  return HAL_DMAEx_RingAcquire(&SERIAL_Ports[Port].Rx, ppData);
+}
+
+/**
+  * @brief  Release bytes of the block returned by BSP_SERIAL_Acquire().
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @param  Length Number of bytes consumed, at most the size of the block.
+  * @retval None
+  */
+void BSP_SERIAL_Commit(uint32_t Port, uint32_t Length)
+{
+  BSP_SERIAL_PortTypeDef *pPort;
+
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return;
+  }
+  pPort = &SERIAL_Ports[Port];
+
+  HAL_DMAEx_RingCommit(&pPort->Rx, Length);
+
+  if (pPort->Throttled != 0U)
+  {
+    SERIAL_UpdateRts(pPort);
+  }
+}
+
+/**
+  * @brief  Queue data in the transmit ring of a port.
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @param  pData Pointer to the data.
+  * @param  Length Number of bytes to send.
+  * @retval Number of bytes queued, limited by the room in the ring
+  */
+uint32_t BSP_SERIAL_Write(uint32_t Port, const uint8_t *pData, uint32_t Length)
+{
+  BSP_SERIAL_PortTypeDef *pPort;
+  uint32_t head;
+  uint32_t first;
+
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return 0U;
+  }
+  pPort = &SERIAL_Ports[Port];
+
+  first = SERIAL_GetTxRoom(pPort);
+  if (Length > first)
+  {
+    Length = first;
+  }
+  if (Length == 0U)
+  {
+    return 0U;
+  }
+
+  head = pPort->TxHead;
+  first = pPort->TxSize - head;
+  if (Length > first)
+  {
+    memcpy(&pPort->pTxBuffer[head], pData, first);
+    memcpy(pPort->pTxBuffer, &pData[first], Length - first);
+  }
+  else
+  {
+    memcpy(&pPort->pTxBuffer[head], pData, Length);
+  }
+
+  head += Length;
+  if (head >= pPort->TxSize)
+  {
+    head -= pPort->TxSize;
+  }
+
+  /* The data must be in the ring before the DMA can see it */
+  __DMB();
+  pPort->TxHead = head;
+
+  SERIAL_Kick(pPort);
+
+  return Length;
+}
+
+/**
+  * @brief  Return the port of a UART.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval A value of @ref BSP_SERIAL_Port, BSP_SERIAL_PORT_NUMBER for an unknown instance
+  */
+uint32_t BSP_SERIAL_GetPort(const UART_HandleTypeDef *huart)
+{
+  uint32_t port;
+
+  for (port = 0U; port < BSP_SERIAL_PORT_NUMBER; port++)
+  {
+    if (huart->Instance == SERIAL_Instances[port])
+    {
+      break;
+    }
+  }
+
+  return port;
+}
+
+/**
+  * @brief  Set the RTS flow control of a port on the fill level of its receive ring.
+  * @note   RTS is a GPIO output, active low, driven by the service: low while
+  *         the ring has room, high from HighWater bytes waiting until LowWater.
+  * @param  Port A value of @ref BSP_SERIAL_Port.
+  * @param  RtsPort RTS port, push-pull output, NULL to stop the flow control.
+  * @param  RtsPin RTS pin, a value of @ref GPIO_pins.
+  * @param  HighWater Bytes waiting in the receive ring raising RTS, below its size.
+  * @param  LowWater Bytes waiting in the receive ring lowering RTS, below HighWater.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SERIAL_SetFlowControl(uint32_t Port, GPIO_TypeDef *RtsPort, uint16_t RtsPin,
+                                            uint32_t HighWater, uint32_t LowWater)
+{
+  BSP_SERIAL_PortTypeDef *pPort;
+  uint32_t primask_bit;
+
+  if ((Port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[Port].huart == NULL))
+  {
+    return HAL_ERROR;
+  }
+  pPort = &SERIAL_Ports[Port];
+
+  if ((RtsPort != NULL) && ((HighWater >= pPort->Rx.Size) || (LowWater >= HighWater)))
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  pPort->RtsPort   = RtsPort;
+  pPort->RtsPin    = RtsPin;
+  pPort->HighWater = HighWater;
+  pPort->LowWater  = LowWater;
+  pPort->Throttled = 0U;
+  if (RtsPort != NULL)
+  {
+    HAL_GPIO_WritePin(RtsPort, RtsPin, GPIO_PIN_RESET);
+    SERIAL_UpdateRts(pPort);
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SERIAL_Exported_Functions_Group2 Poll and notify functions
+  * @brief    Poll and notify functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Poll and notify functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Wait for a set of ports to be ready
+      (+) Handle the UART interrupt of a port
+      (+) Check the RTS flow control periodically
+      (+) Be notified from the interrupt
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Return the ready ports among a set of events.
+  * @note   Receive and transmit readiness is level triggered, it is read from the
+  *         rings. Error readiness is reported once per error.
+  * @param  Events Readiness bits of interest, a combination of @ref BSP_SERIAL_Event.
+  * @param  Timeout Time to wait in ms for a port to be ready, 0 to return at once,
+  *                 HAL_MAX_DELAY to wait forever.
+  * @retval Readiness bits, a subset of Events, 0 on timeout
+  */
+uint32_t BSP_SERIAL_Poll(uint32_t Events, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t ready;
+
+  ready = SERIAL_GetReady(Events);
+  while ((ready == 0U) && (Timeout != 0U))
+  {
+    if ((Timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) >= Timeout))
+    {
+      break;
+    }
+    __WFI();
+    ready = SERIAL_GetReady(Events);
+  }
+
+  return ready;
+}
+
+/**
+  * @brief  Handle the UART interrupt of an open port.
+  * @note   Replaces HAL_UART_IRQHandler() for the multiplexed ports. Reading the
+  *         status then the data register clears the idle line and error flags.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_SERIAL_IRQHandler(UART_HandleTypeDef *huart)
+{
+  uint32_t isrflags = READ_REG(huart->Instance->SR);
+  uint32_t port = BSP_SERIAL_GetPort(huart);
+  uint32_t events = 0U;
+
+  if ((isrflags & (USART_SR_IDLE | SERIAL_UART_ERRORS)) == 0U)
+  {
+    return;
+  }
+  (void)READ_REG(huart->Instance->DR);
+
+  if (port >= BSP_SERIAL_PORT_NUMBER)
+  {
+    return;
+  }
+
+  if ((isrflags & USART_SR_IDLE) != 0U)
+  {
+    events |= BSP_SERIAL_EVENT_RX(port);
+    SERIAL_UpdateRts(&SERIAL_Ports[port]);
+  }
+  if ((isrflags & SERIAL_UART_ERRORS) != 0U)
+  {
+    SERIAL_Ports[port].ErrorCount++;
+    events |= BSP_SERIAL_EVENT_ERR(port);
+  }
+
+  SERIAL_SetPending(events);
+  BSP_SERIAL_NotifyCallback(events);
+}
+
+/**
+  * @brief  Check the receive rings of the ports with RTS flow control.
+  * @note   To call periodically, e.g. from SysTick, for a continuous stream
+  *         without idle line.
+  * @retval None
+  */
+void BSP_SERIAL_Tick(void)
+{
+  uint32_t port;
+
+  for (port = 0U; port < BSP_SERIAL_PORT_NUMBER; port++)
+  {
+    if (SERIAL_Ports[port].huart != NULL)
+    {
+      SERIAL_UpdateRts(&SERIAL_Ports[port]);
+    }
+  }
+}
+
+/**
+  * @brief  Readiness notification callback.
+  * @note   Called from the UART interrupt of the port.
+  * @param  Events Readiness bits raised, a combination of @ref BSP_SERIAL_Event.
+  * @retval None
+  */
+__weak void BSP_SERIAL_NotifyCallback(uint32_t Events)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(Events);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SERIAL_NotifyCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SERIAL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Raise readiness bits from an interrupt.
+  * @param  Events Readiness bits.
+  * @retval None
+  */
+static void SERIAL_SetPending(uint32_t Events)
+{
+  uint32_t pending;
+
+  do
+  {
+    pending = __LDREXW(&SERIAL_Pending) | Events;
+  } while (__STREXW(pending, &SERIAL_Pending) != 0U);
+}
+
+/**
+  * @brief  Compute the readiness bits of the open ports.
+  * @param  Events Readiness bits of interest.
+  * @retval Readiness bits, the pending ones returned are cleared
+  */
+static uint32_t SERIAL_GetReady(uint32_t Events)
+{
+  uint32_t ready = 0U;
+  uint32_t pending;
+  uint32_t port;
+
+  for (port = 0U; port < BSP_SERIAL_PORT_NUMBER; port++)
+  {
+    if (SERIAL_Ports[port].huart == NULL)
+    {
+      continue;
+    }
+    if (((Events & BSP_SERIAL_EVENT_RX(port)) != 0U) && (HAL_DMAEx_RingGetCount(&SERIAL_Ports[port].Rx) != 0U))
+    {
+      ready |= BSP_SERIAL_EVENT_RX(port);
+    }
+    if (((Events & BSP_SERIAL_EVENT_TX(port)) != 0U) && (SERIAL_GetTxRoom(&SERIAL_Ports[port]) != 0U))
+    {
+      ready |= BSP_SERIAL_EVENT_TX(port);
+    }
+  }
+
+  /* Errors are only known from the interrupt, report each one once */
+  do
+  {
+    pending = __LDREXW(&SERIAL_Pending);
+    ready |= pending & Events & BSP_SERIAL_EVENT_ERR_ALL;
+  } while (__STREXW(pending & ~ready, &SERIAL_Pending) != 0U);
+
+  return ready;
+}
+
+/**
+  * @brief  Return the room in the transmit ring of a port.
+  * @param  pPort Open port.
+  * @retval Number of bytes, one slot is kept free to tell a full ring from an empty one
+  */
+static uint32_t SERIAL_GetTxRoom(const BSP_SERIAL_PortTypeDef *pPort)
+{
+  uint32_t head = pPort->TxHead;
+  uint32_t tail = pPort->TxTail;
+
+  if (tail > head)
+  {
+    return tail - head - 1U;
+  }
+  return (pPort->TxSize - head) + tail - 1U;
+}
+
+/**
+  * @brief  Start a Tx DMA transfer of the queued data when the DMA is idle.
+  * @note   The transfer takes the largest contiguous chunk, up to the end of the ring.
+  * @param  pPort Open port.
+  * @retval None
+  */
+static void SERIAL_Kick(BSP_SERIAL_PortTypeDef *pPort)
+{
+  UART_HandleTypeDef *huart = pPort->huart;
+  uint32_t primask_bit;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t length;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  head = pPort->TxHead;
+  tail = pPort->TxTail;
+  if ((pPort->TxXferSize == 0U) && (head != tail))
+  {
+    length = (head > tail) ? (head - tail) : (pPort->TxSize - tail);
+    if (length > SERIAL_MAX_XFER_SIZE)
+    {
+      length = SERIAL_MAX_XFER_SIZE;
+    }
+
+    pPort->TxXferSize = length;
+    if (HAL_DMA_Start_IT(huart->hdmatx, (uint32_t)&pPort->pTxBuffer[tail],
+                         (uint32_t)&huart->Instance->DR, length) != HAL_OK)
+    {
+      /* Retried on the next write */
+      pPort->TxXferSize = 0U;
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Raise or lower the RTS of a port from the fill level of its receive ring.
+  * @param  pPort Open port.
+  * @retval None
+  */
+static void SERIAL_UpdateRts(BSP_SERIAL_PortTypeDef *pPort)
+{
+  uint32_t primask_bit;
+  uint32_t count;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (pPort->RtsPort != NULL)
+  {
+    count = HAL_DMAEx_RingGetCount(&pPort->Rx);
+    if ((pPort->Throttled == 0U) && (count >= pPort->HighWater))
+    {
+      HAL_GPIO_WritePin(pPort->RtsPort, pPort->RtsPin, GPIO_PIN_SET);
+      pPort->Throttled = 1U;
+      pPort->Throttles++;
+    }
+    else if ((pPort->Throttled != 0U) && (count <= pPort->LowWater))
+    {
+      HAL_GPIO_WritePin(pPort->RtsPort, pPort->RtsPin, GPIO_PIN_RESET);
+      pPort->Throttled = 0U;
+    }
+    else
+    {
+      /* Between the watermarks: RTS kept */
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Rx DMA half and full ring callback, check the RTS flow control.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void SERIAL_DMARxEvent(DMA_HandleTypeDef *hdma)
+{
+  uint32_t port = BSP_SERIAL_GetPort((UART_HandleTypeDef *)hdma->Parent);
+
+  if ((port < BSP_SERIAL_PORT_NUMBER) && (SERIAL_Ports[port].huart != NULL))
+  {
+    SERIAL_UpdateRts(&SERIAL_Ports[port]);
+  }
+}
+
+/**
+  * @brief  Tx DMA transfer complete callback, release the chunk and start the next one.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void SERIAL_DMATxCplt(DMA_HandleTypeDef *hdma)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+  BSP_SERIAL_PortTypeDef *pPort;
+  uint32_t port;
+  uint32_t tail;
+
+  port = BSP_SERIAL_GetPort(huart);
+  if ((port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[port].huart == NULL))
+  {
+    return;
+  }
+  pPort = &SERIAL_Ports[port];
+
+  tail = pPort->TxTail + pPort->TxXferSize;
+  if (tail >= pPort->TxSize)
+  {
+    tail -= pPort->TxSize;
+  }
+  pPort->TxTail = tail;
+  pPort->TxXferSize = 0U;
+
+  SERIAL_Kick(pPort);
+}
+
+/**
+  * @brief  Tx DMA error callback, the chunk is dropped.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void SERIAL_DMATxError(DMA_HandleTypeDef *hdma)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+  uint32_t port;
+
+  port = BSP_SERIAL_GetPort(huart);
+  if ((port >= BSP_SERIAL_PORT_NUMBER) || (SERIAL_Ports[port].huart == NULL))
+  {
+    return;
+  }
+
+  SERIAL_Ports[port].ErrorCount++;
+  SERIAL_SetPending(BSP_SERIAL_EVENT_ERR(port));
+  SERIAL_DMATxCplt(hdma);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,646 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sha256.c
+  * @author  MCU Application Team
+  * @brief   SHA-256 image verification BSP service.
+  *          This file provides functions to check the digest of a firmware
+  *          image at boot or while it runs:
+  *           + SHA-256 of FIPS 180-4, rounds unrolled on __ROR(), message
+  *             words loaded in the rounds with __REV()
+  *           + Flash read ahead by a memory to memory DMA while the CPU
+  *             hashes the previous chunk
+  *           + Verification in chunks from the idle loop, after a boot on
+  *             the CRC of the slot
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Hash of a message: BSP_SHA256_Init(), BSP_SHA256_Update() with the
+       message in pieces of any size, BSP_SHA256_Final() for the 32 bytes of
+       the digest. BSP_SHA256_Calculate() does the three at once. Blocks taken
+       from a word aligned address are hashed in place, the others are copied
+       to the context first.
+
+   (#) Verification of an image in the flash: BSP_SHA256_VerifyInit(), then
+       BSP_SHA256_Verify() with its address, size and expected digest. It
+       returns HAL_OK on a match only, the digests are compared in constant
+       time. The expected digest comes with the image: it is the SHA-256 of
+       the binary file, over its size in bytes and without padding.
+
+   (#) Flash read ahead, with HAL_DMA_MODULE_ENABLED: a memory to memory DMA
+       channel given to BSP_SHA256_VerifyAttachDma(), initialized as for
+       BSP_MEMOPS_AttachDma(), copies the next BSP_SHA256_CHUNK_SIZE bytes of
+       the image to RAM while the CPU hashes the previous ones: the flash wait
+       states of the loads are taken by the DMA. The chunks are waited for by
+       polling, the channel interrupt is not needed. The end of the image
+       beyond the last full chunk is hashed from the flash.
+
+   (#) Boot on the CRC, hash in the background: SHA-256 takes some tens of
+       cycles per byte, the CRC peripheral about one. The bootloader starts
+       the slot on its trailer CRC with BSP_FWUPDATE_SelectSlot(); the
+       application then calls BSP_SHA256_VerifyStart() on its own slot, from
+       BSP_FWUPDATE_GetSlotAddress(BSP_FWUPDATE_GetRunningSlot()), and
+       BSP_SHA256_VerifyProcess() from the idle loop with the bytes to hash
+       in each call. HAL_BUSY is returned until the whole image is hashed,
+       then HAL_OK or HAL_ERROR: the application decides what a mismatch
+       stops, before the features that need a verified image are enabled.
+
+   (#) The verification context holds two chunk buffers with the DMA: it is
+       better kept in a static variable than on the stack.
+
+   (#) Built with -O3 in the speed profile from HOT_SOURCES of the Makefile.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_sha256.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SHA256 BSP SHA256
+  * @brief SHA-256 image verification BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Private_Constants BSP SHA256 Private Constants
+  * @{
+  */
+#define SHA256_LENGTH_OFFSET            56U            /* Message length in the last block       */
+#define SHA256_DMA_TIMEOUT              100U           /* ms, a chunk takes far less             */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Private_Macros BSP SHA256 Private Macros
+  * @{
+  */
+#define SHA256_S0(__X__)                (__ROR((__X__), 2U) ^ __ROR((__X__), 13U) ^ __ROR((__X__), 22U))
+#define SHA256_S1(__X__)                (__ROR((__X__), 6U) ^ __ROR((__X__), 11U) ^ __ROR((__X__), 25U))
+#define SHA256_SIGMA0(__X__)            (__ROR((__X__), 7U) ^ __ROR((__X__), 18U) ^ ((__X__) >> 3U))
+#define SHA256_SIGMA1(__X__)            (__ROR((__X__), 17U) ^ __ROR((__X__), 19U) ^ ((__X__) >> 10U))
+#define SHA256_CH(__X__, __Y__, __Z__)  ((__Z__) ^ ((__X__) & ((__Y__) ^ (__Z__))))
+#define SHA256_MAJ(__X__, __Y__, __Z__) (((__X__) & (__Y__)) | ((__Z__) & ((__X__) | (__Y__))))
+
+/* One round on the working variables named in their order of the round, the
+   eight of a group are unrolled with the names rotated instead of moved */
+#define SHA256_ROUND(__A__, __B__, __C__, __D__, __E__, __F__, __G__, __H__, __I__)          \
+  do                                                                                          \
+  {                                                                                           \
+    uint32_t t1_ = (__H__) + SHA256_S1(__E__) + SHA256_CH((__E__), (__F__), (__G__)) +       \
+                   pk[(__I__)] + w[(__I__)];                                                  \
+    (__D__) += t1_;                                                                           \
+    (__H__)  = t1_ + SHA256_S0(__A__) + SHA256_MAJ((__A__), (__B__), (__C__));                \
+  } while (0U)
+
+/* Rounds 0 to 15: the message word is loaded in its round, the flash read
+   overlaps the previous round */
+#define SHA256_LOAD(__A__, __B__, __C__, __D__, __E__, __F__, __G__, __H__, __I__)           \
+  do                                                                                          \
+  {                                                                                           \
+    w[(__I__)] = __REV(pWords[(__I__)]);                                                      \
+    SHA256_ROUND(__A__, __B__, __C__, __D__, __E__, __F__, __G__, __H__, __I__);              \
+  } while (0U)
+
+/* Rounds 16 to 63: the schedule is kept in 16 words, expanded in place */
+#define SHA256_EXPAND(__A__, __B__, __C__, __D__, __E__, __F__, __G__, __H__, __I__)         \
+  do                                                                                          \
+  {                                                                                           \
+    w[(__I__)] += SHA256_SIGMA1(w[((__I__) + 14U) & 15U]) + w[((__I__) + 9U) & 15U] +         \
+                  SHA256_SIGMA0(w[((__I__) + 1U) & 15U]);                                     \
+    SHA256_ROUND(__A__, __B__, __C__, __D__, __E__, __F__, __G__, __H__, __I__);              \
+  } while (0U)
+
+#define SHA256_EIGHT(__STEP__, __I__)                                                         \
+  do                                                                                          \
+  {                                                                                           \
+    __STEP__(a, b, c, d, e, f, g, h, (__I__) + 0U);                                           \
+    __STEP__(h, a, b, c, d, e, f, g, (__I__) + 1U);                                           \
+    __STEP__(g, h, a, b, c, d, e, f, (__I__) + 2U);                                           \
+    __STEP__(f, g, h, a, b, c, d, e, (__I__) + 3U);                                           \
+    __STEP__(e, f, g, h, a, b, c, d, (__I__) + 4U);                                           \
+    __STEP__(d, e, f, g, h, a, b, c, (__I__) + 5U);                                           \
+    __STEP__(c, d, e, f, g, h, a, b, (__I__) + 6U);                                           \
+    __STEP__(b, c, d, e, f, g, h, a, (__I__) + 7U);                                           \
+  } while (0U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Private_Variables BSP SHA256 Private Variables
+  * @{
+  */
+static const uint32_t SHA256_K[64] =
+{
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U, 0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+static const uint32_t SHA256_H0[8] =
+{
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SHA256_Private_Functions
+  * @{
+  */
+static void SHA256_Transform(uint32_t *pState, const uint32_t *pWords, uint32_t Blocks);
+static void SHA256_Check(BSP_SHA256_VerifyTypeDef *hverify);
+#if defined (HAL_DMA_MODULE_ENABLED)
+static void SHA256_Fetch(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Offset);
+#endif /* HAL_DMA_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SHA256_Exported_Functions BSP SHA256 Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SHA256_Exported_Functions_Group1 Hash functions
+  * @brief    Hash functions
+  *
+@verbatim
+ ===============================================================================
+                          ##### Hash functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Hash a message given in pieces
+      (+) Hash a buffer at once
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start a hash.
+  * @param  hsha Pointer to a BSP_SHA256_TypeDef structure.
+  * @retval None
+  */
+void BSP_SHA256_Init(BSP_SHA256_TypeDef *hsha)
+{
+  memcpy(hsha->State, SHA256_H0, sizeof(hsha->State));
+  hsha->Fill   = 0U;
+  hsha->Length = 0U;
+}
+
+/**
+  * @brief  Hash the next piece of the message.
+  * @param  hsha Pointer to a BSP_SHA256_TypeDef structure.
+  * @param  pData Piece of the message, hashed in place from a word aligned
+  *         address.
+  * @param  Size Bytes of the piece.
+  * @retval None
+  */
+void BSP_SHA256_Update(BSP_SHA256_TypeDef *hsha, const uint8_t *pData, uint32_t Size)
+{
+  uint8_t *pbuffer = (uint8_t *)hsha->Buffer;
+  uint32_t chunk;
+  uint32_t blocks;
+
+  hsha->Length += Size;
+
+  if (hsha->Fill != 0U)
+  {
+    chunk = BSP_SHA256_BLOCK_SIZE - hsha->Fill;
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+    memcpy(pbuffer + hsha->Fill, pData, chunk);
+    hsha->Fill += chunk;
+    pData      += chunk;
+    Size       -= chunk;
+    if (hsha->Fill != BSP_SHA256_BLOCK_SIZE)
+    {
+      return;
+    }
+    SHA256_Transform(hsha->State, hsha->Buffer, 1U);
+    hsha->Fill = 0U;
+  }
+
+  blocks = Size / BSP_SHA256_BLOCK_SIZE;
+  Size  -= blocks * BSP_SHA256_BLOCK_SIZE;
+  if (((uint32_t)pData & 3U) == 0U)
+  {
+    SHA256_Transform(hsha->State, (const uint32_t *)pData, blocks);
+    pData += blocks * BSP_SHA256_BLOCK_SIZE;
+  }
+  else
+  {
+    while (blocks != 0U)
+    {
+      memcpy(pbuffer, pData, BSP_SHA256_BLOCK_SIZE);
+      SHA256_Transform(hsha->State, hsha->Buffer, 1U);
+      pData += BSP_SHA256_BLOCK_SIZE;
+      blocks--;
+    }
+  }
+
+  if (Size != 0U)
+  {
+    memcpy(pbuffer, pData, Size);
+    hsha->Fill = Size;
+  }
+}
+
+/**
+  * @brief  Pad the message and give its digest.
+  * @note   The context is to be initialized again for the next hash.
+  * @param  hsha Pointer to a BSP_SHA256_TypeDef structure.
+  * @param  pDigest BSP_SHA256_DIGEST_SIZE bytes of the digest.
+  * @retval None
+  */
+void BSP_SHA256_Final(BSP_SHA256_TypeDef *hsha, uint8_t *pDigest)
+{
+  uint8_t *pbuffer = (uint8_t *)hsha->Buffer;
+  uint64_t bits = hsha->Length << 3U;
+  uint32_t word;
+  uint32_t i;
+
+  pbuffer[hsha->Fill] = 0x80U;
+  hsha->Fill++;
+  if (hsha->Fill > SHA256_LENGTH_OFFSET)
+  {
+    memset(pbuffer + hsha->Fill, 0, BSP_SHA256_BLOCK_SIZE - hsha->Fill);
+    SHA256_Transform(hsha->State, hsha->Buffer, 1U);
+    hsha->Fill = 0U;
+  }
+  memset(pbuffer + hsha->Fill, 0, SHA256_LENGTH_OFFSET - hsha->Fill);
+
+  /* Big endian bit length, the words are reversed again by the transform */
+  hsha->Buffer[14] = __REV((uint32_t)(bits >> 32U));
+  hsha->Buffer[15] = __REV((uint32_t)bits);
+  SHA256_Transform(hsha->State, hsha->Buffer, 1U);
+  hsha->Fill = 0U;
+
+  for (i = 0U; i < 8U; i++)
+  {
+    word = __REV(hsha->State[i]);
+    memcpy(pDigest + (i * 4U), &word, 4U);
+  }
+}
+
+/**
+  * @brief  Hash a buffer.
+  * @param  pData Buffer.
+  * @param  Size Bytes of the buffer.
+  * @param  pDigest BSP_SHA256_DIGEST_SIZE bytes of the digest.
+  * @retval None
+  */
+void BSP_SHA256_Calculate(const uint8_t *pData, uint32_t Size, uint8_t *pDigest)
+{
+  BSP_SHA256_TypeDef hsha;
+
+  BSP_SHA256_Init(&hsha);
+  BSP_SHA256_Update(&hsha, pData, Size);
+  BSP_SHA256_Final(&hsha, pDigest);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SHA256_Exported_Functions_Group2 Verification functions
+  * @brief    Verification functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Verification functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Read the image ahead with a DMA channel
+      (+) Verify an image at once or in chunks from the idle loop
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a verification context, without DMA.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @retval None
+  */
+void BSP_SHA256_VerifyInit(BSP_SHA256_VerifyTypeDef *hverify)
+{
+  memset(hverify, 0, sizeof(BSP_SHA256_VerifyTypeDef));
+  hverify->State = BSP_SHA256_STATE_IDLE;
+}
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  Read the image ahead with a memory to memory DMA channel.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @param  hdma DMA handle initialized in DMA_MEMORY_TO_MEMORY, words, both
+  *         addresses incremented, normal mode.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SHA256_VerifyAttachDma(BSP_SHA256_VerifyTypeDef *hverify, DMA_HandleTypeDef *hdma)
+{
+  if ((hdma == NULL) || (hverify->State == BSP_SHA256_STATE_RUNNING) ||
+      (hdma->Init.Direction != DMA_MEMORY_TO_MEMORY) ||
+      (hdma->Init.PeriphInc != DMA_PINC_ENABLE) || (hdma->Init.MemInc != DMA_MINC_ENABLE) ||
+      (hdma->Init.PeriphDataAlignment != DMA_PDATAALIGN_WORD) ||
+      (hdma->Init.MemDataAlignment != DMA_MDATAALIGN_WORD) || (hdma->Init.Mode != DMA_NORMAL))
+  {
+    return HAL_ERROR;
+  }
+
+  hverify->hdma = hdma;
+
+  return HAL_OK;
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @brief  Start the verification of an image.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @param  Address First byte of the image, word aligned for the DMA.
+  * @param  Size Image bytes.
+  * @param  pDigest BSP_SHA256_DIGEST_SIZE bytes of the digest expected.
+  * @retval HAL status, HAL_BUSY while another verification runs
+  */
+HAL_StatusTypeDef BSP_SHA256_VerifyStart(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Address, uint32_t Size,
+                                         const uint8_t *pDigest)
+{
+  if ((Address == 0U) || (Size == 0U) || (pDigest == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (hverify->State == BSP_SHA256_STATE_RUNNING)
+  {
+    return HAL_BUSY;
+  }
+
+  BSP_SHA256_Init(&hverify->Hash);
+  hverify->pImage = (const uint8_t *)Address;
+  hverify->Size   = Size;
+  hverify->Hashed = 0U;
+  memcpy(hverify->Expected, pDigest, BSP_SHA256_DIGEST_SIZE);
+  hverify->State  = BSP_SHA256_STATE_RUNNING;
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+  hverify->Fetched = 0U;
+  if ((Address & 3U) == 0U)
+  {
+    SHA256_Fetch(hverify, 0U);
+  }
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Hash the next chunks of the image, check the digest at its end.
+  * @note   To be called from the idle loop until it returns another status
+  *         than HAL_BUSY.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @param  Bytes Image bytes to hash in this call, rounded up to
+  *         BSP_SHA256_CHUNK_SIZE.
+  * @retval HAL status, HAL_BUSY while the image is hashed, HAL_OK when its
+  *         digest is the one expected, HAL_ERROR otherwise
+  */
+HAL_StatusTypeDef BSP_SHA256_VerifyProcess(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Bytes)
+{
+  uint32_t done = 0U;
+  uint32_t chunk;
+#if defined (HAL_DMA_MODULE_ENABLED)
+  const uint32_t *pchunk;
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+  while ((hverify->State == BSP_SHA256_STATE_RUNNING) && (hverify->Hashed != hverify->Size))
+  {
+    chunk = hverify->Size - hverify->Hashed;
+    if (chunk > BSP_SHA256_CHUNK_SIZE)
+    {
+      chunk = BSP_SHA256_CHUNK_SIZE;
+    }
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+    if (hverify->Fetched > hverify->Hashed)
+    {
+      if (HAL_DMA_PollForTransfer(hverify->hdma, HAL_DMA_FULL_TRANSFER, SHA256_DMA_TIMEOUT) != HAL_OK)
+      {
+        (void)HAL_DMA_Abort(hverify->hdma);
+        hverify->State = BSP_SHA256_STATE_MISMATCH;
+        break;
+      }
+
+      /* The next chunk is copied while this one is hashed */
+      pchunk = hverify->Staging[(hverify->Hashed / BSP_SHA256_CHUNK_SIZE) & 1U];
+      SHA256_Fetch(hverify, hverify->Hashed + BSP_SHA256_CHUNK_SIZE);
+      BSP_SHA256_Update(&hverify->Hash, (const uint8_t *)pchunk, chunk);
+    }
+    else
+#endif /* HAL_DMA_MODULE_ENABLED */
+    {
+      BSP_SHA256_Update(&hverify->Hash, hverify->pImage + hverify->Hashed, chunk);
+    }
+    hverify->Hashed += chunk;
+
+    if (hverify->Hashed == hverify->Size)
+    {
+      SHA256_Check(hverify);
+    }
+
+    done += chunk;
+    if (done >= Bytes)
+    {
+      break;
+    }
+  }
+
+  if (hverify->State == BSP_SHA256_STATE_RUNNING)
+  {
+    return HAL_BUSY;
+  }
+
+  return (hverify->State == BSP_SHA256_STATE_MATCH) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Verify an image at once.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @param  Address First byte of the image, word aligned for the DMA.
+  * @param  Size Image bytes.
+  * @param  pDigest BSP_SHA256_DIGEST_SIZE bytes of the digest expected.
+  * @retval HAL status, HAL_OK when the digest of the image is the one
+  *         expected
+  */
+HAL_StatusTypeDef BSP_SHA256_Verify(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Address, uint32_t Size,
+                                    const uint8_t *pDigest)
+{
+  HAL_StatusTypeDef status;
+
+  status = BSP_SHA256_VerifyStart(hverify, Address, Size, pDigest);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  return BSP_SHA256_VerifyProcess(hverify, Size);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SHA256_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Compress message blocks.
+  * @param  pState Hash value H0 to H7.
+  * @param  pWords Blocks, word aligned, in the byte order of the message.
+  * @param  Blocks Number of blocks.
+  * @retval None
+  */
+static void SHA256_Transform(uint32_t *pState, const uint32_t *pWords, uint32_t Blocks)
+{
+  const uint32_t *pk;
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t g;
+  uint32_t h;
+
+  while (Blocks != 0U)
+  {
+    a = pState[0];
+    b = pState[1];
+    c = pState[2];
+    d = pState[3];
+    e = pState[4];
+    f = pState[5];
+    g = pState[6];
+    h = pState[7];
+
+    pk = SHA256_K;
+    SHA256_EIGHT(SHA256_LOAD, 0U);
+    SHA256_EIGHT(SHA256_LOAD, 8U);
+    for (pk = &SHA256_K[16]; pk != &SHA256_K[64]; pk += 16)
+    {
+      SHA256_EIGHT(SHA256_EXPAND, 0U);
+      SHA256_EIGHT(SHA256_EXPAND, 8U);
+    }
+
+    pState[0] += a;
+    pState[1] += b;
+    pState[2] += c;
+    pState[3] += d;
+    pState[4] += e;
+    pState[5] += f;
+    pState[6] += g;
+    pState[7] += h;
+
+    pWords += BSP_SHA256_BLOCK_SIZE / 4U;
+    Blocks--;
+  }
+}
+
+/**
+  * @brief  Compare the digest of the image with the one expected.
+  * @note   In constant time: every word is compared.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @retval None
+  */
+static void SHA256_Check(BSP_SHA256_VerifyTypeDef *hverify)
+{
+  uint32_t digest[BSP_SHA256_DIGEST_SIZE / 4U];
+  uint32_t diff = 0U;
+  uint32_t i;
+
+  BSP_SHA256_Final(&hverify->Hash, (uint8_t *)digest);
+  for (i = 0U; i < (BSP_SHA256_DIGEST_SIZE / 4U); i++)
+  {
+    diff |= digest[i] ^ hverify->Expected[i];
+  }
+
+  hverify->State = (diff == 0U) ? BSP_SHA256_STATE_MATCH : BSP_SHA256_STATE_MISMATCH;
+}
+
+#if defined (HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  Start the copy of a full chunk of the image to its staging buffer.
+  * @note   Nothing is started without a free channel or a full chunk: the
+  *         chunk is then hashed from the flash.
+  * @param  hverify Pointer to a BSP_SHA256_VerifyTypeDef structure.
+  * @param  Offset First byte of the chunk in the image, a multiple of
+  *         BSP_SHA256_CHUNK_SIZE.
+  * @retval None
+  */
+static void SHA256_Fetch(BSP_SHA256_VerifyTypeDef *hverify, uint32_t Offset)
+{
+  DMA_HandleTypeDef *hdma = hverify->hdma;
+
+  if ((hdma == NULL) || (hdma->State != HAL_DMA_STATE_READY) ||
+      (Offset > hverify->Size) || ((hverify->Size - Offset) < BSP_SHA256_CHUNK_SIZE))
+  {
+    return;
+  }
+
+  if (HAL_DMA_Start(hdma, (uint32_t)(hverify->pImage + Offset),
+                    (uint32_t)hverify->Staging[(Offset / BSP_SHA256_CHUNK_SIZE) & 1U],
+                    BSP_SHA256_CHUNK_SIZE / 4U) == HAL_OK)
+  {
+    hverify->Fetched = Offset + BSP_SHA256_CHUNK_SIZE;
+  }
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,608 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spibus.c
+  * @author  MCU Application Team
+  * @brief   SPI bus transaction queue BSP service.
+  *          This file provides functions to share one SPI between devices:
+  *           + Per device register images and chip select
+  *           + Queue of DMA transactions run back to back
+  *           + Only the registers which differ are written between devices
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the SPI with HAL_SPI_Init() in SPI_MODE_MASTER, 2 lines and
+       SPI_NSS_SOFT, and link a DMA channel in DMA_NORMAL mode to its hdmarx and
+       one to its hdmatx. Only the Rx DMA channel interrupt is used, enable it
+       in the NVIC. The chip select pins are configured as push-pull outputs
+       driven high.
+
+   (#) Call BSP_SPIBUS_Init() with the SPI handle. The bus then owns the SPI:
+       the HAL transfer functions must not be used on it until BSP_SPIBUS_DeInit().
+
+   (#) Describe each device once with BSP_SPIBUS_DeviceInit(): a SPI_InitTypeDef
+       with its clock polarity and phase, prescaler, data size and first bit,
+       and its chip select pin. The bus DMA channels are switched between u8
+       and u16 data as the device DataSize.
+
+   (#) Fill a BSP_SPIBUS_XferTypeDef and queue it with BSP_SPIBUS_Submit() from
+       any context. The transactions run in submission order, from the Rx DMA
+       interrupt of the previous one:
+       (+) The SPI CR1 and CR2 are written only if the device differs from the
+           previous one, the SPI is disabled only for a CR1 change.
+       (+) The chip select goes low once the SPI is configured and high from
+           the Rx DMA completion, unless BSP_SPIBUS_XFER_KEEP_CS is set and the
+           next transaction addresses the same device.
+       (+) BSP_SPIBUS_XferCpltCallback() is called with the Status set, the
+           transaction can then be reused or submitted again.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_spibus.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SPIBUS BSP SPIBUS
+  * @brief SPI bus transaction queue BSP service
+  * @{
+  */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SPIBUS_Private_Constants BSP SPIBUS Private Constants
+  * @{
+  */
+#define SPIBUS_NUMBER             3U          /*!< One bus per SPI instance                      */
+#define SPIBUS_CR1_MASK           (SPI_CR1_MSTR | SPI_CR1_SSI | SPI_CR1_RXONLY | SPI_CR1_BIDIMODE | \
+                                   SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_SSM | SPI_CR1_BR | \
+                                   SPI_CR1_DFF | SPI_CR1_LSBFIRST)
+#define SPIBUS_CR2_MASK           (SPI_CR2_SSOE | SPI_CR2_SLVFM | SPI_CR2_FRXTH)
+#define SPIBUS_CR2_DMA            (SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN)
+#define SPIBUS_CCR_MASK           (DMA_CCR_MSIZE | DMA_CCR_PSIZE | DMA_CCR_MINC)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_SPIBUS_Private_Variables BSP SPIBUS Private Variables
+  * @{
+  */
+static SPI_TypeDef * const SPIBUS_Instances[SPIBUS_NUMBER] =
+{
+  SPI1, SPI2, SPI3
+};
+
+/* Initialized buses, found back from the DMA callbacks */
+static BSP_SPIBUS_TypeDef *SPIBUS_Buses[SPIBUS_NUMBER];
+
+/* Sent when a transaction has no Tx data, written when it has no Rx data */
+static const uint16_t SPIBUS_TxDummy = 0xFFFFU;
+static uint16_t SPIBUS_RxDummy;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SPIBUS_Private_Functions
+  * @{
+  */
+static uint32_t SPIBUS_GetIndex(const SPI_HandleTypeDef *hspi);
+static void     SPIBUS_SetChannel(DMA_HandleTypeDef *hdma, uint32_t HalfWord, uint32_t MemInc);
+static void     SPIBUS_Configure(BSP_SPIBUS_TypeDef *hbus, const BSP_SPIBUS_DeviceTypeDef *pDevice);
+static HAL_StatusTypeDef SPIBUS_Start(BSP_SPIBUS_TypeDef *hbus);
+static void     SPIBUS_End(BSP_SPIBUS_TypeDef *hbus, uint32_t Status);
+static void     SPIBUS_DMARxCplt(DMA_HandleTypeDef *hdma);
+static void     SPIBUS_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SPIBUS_Exported_Functions BSP SPIBUS Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SPIBUS_Exported_Functions_Group1 Bus and device functions
+  * @brief    Bus and device functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Bus and device functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Take and give back the SPI of a bus
+      (+) Describe a device of the bus
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a bus on a SPI.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure initialized in master
+  *              mode, hdmarx and hdmatx in DMA_NORMAL mode must be linked.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIBUS_Init(BSP_SPIBUS_TypeDef *hbus, SPI_HandleTypeDef *hspi)
+{
+  uint32_t index;
+
+  if ((hbus == NULL) || (hspi == NULL) || (hspi->hdmarx == NULL) || (hspi->hdmatx == NULL) ||
+      (hspi->Init.Mode != SPI_MODE_MASTER))
+  {
+    return HAL_ERROR;
+  }
+
+  index = SPIBUS_GetIndex(hspi);
+  if (index >= SPIBUS_NUMBER)
+  {
+    return HAL_ERROR;
+  }
+  if ((SPIBUS_Buses[index] != NULL) || (hspi->State != HAL_SPI_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  hbus->hspi       = hspi;
+  hbus->pHead      = NULL;
+  hbus->pTail      = NULL;
+  hbus->pSelected  = NULL;
+  hbus->CR1        = READ_REG(hspi->Instance->CR1) & SPIBUS_CR1_MASK;
+  hbus->CR2        = READ_REG(hspi->Instance->CR2) & SPIBUS_CR2_MASK;
+  hbus->ErrorCount = 0U;
+
+  /* The Rx DMA completion drives the queue, the Tx channel runs without interrupt */
+  hspi->State = HAL_SPI_STATE_BUSY;
+  hspi->hdmarx->XferCpltCallback     = SPIBUS_DMARxCplt;
+  hspi->hdmarx->XferHalfCpltCallback = NULL;
+  hspi->hdmarx->XferErrorCallback    = SPIBUS_DMAError;
+  hspi->hdmarx->XferAbortCallback    = NULL;
+
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_LDMA_TX | SPI_CR2_LDMA_RX);
+  SET_BIT(hspi->Instance->CR2, SPIBUS_CR2_DMA);
+  __HAL_SPI_ENABLE(hspi);
+
+  SPIBUS_Buses[index] = hbus;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop a bus and give the SPI back to the HAL.
+  * @note   The transaction on the bus and the queued ones are dropped without
+  *         callback, their Status stays BSP_SPIBUS_STATUS_QUEUED.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIBUS_DeInit(BSP_SPIBUS_TypeDef *hbus)
+{
+  SPI_HandleTypeDef *hspi;
+  uint32_t primask_bit;
+  uint32_t index;
+
+  if ((hbus == NULL) || (hbus->hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+  hspi = hbus->hspi;
+  index = SPIBUS_GetIndex(hspi);
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  SPIBUS_Buses[index] = NULL;
+  (void)HAL_DMA_Abort(hspi->hdmatx);
+  (void)HAL_DMA_Abort(hspi->hdmarx);
+  if (hbus->pHead != NULL)
+  {
+    HAL_GPIO_WritePin(hbus->pHead->pDevice->CSPort, hbus->pHead->pDevice->CSPin, GPIO_PIN_SET);
+  }
+  if (hbus->pSelected != NULL)
+  {
+    HAL_GPIO_WritePin(hbus->pSelected->CSPort, hbus->pSelected->CSPin, GPIO_PIN_SET);
+  }
+  hbus->pHead     = NULL;
+  hbus->pTail     = NULL;
+  hbus->pSelected = NULL;
+  hbus->hspi      = NULL;
+
+  __set_PRIMASK(primask_bit);
+
+  __HAL_SPI_DISABLE(hspi);
+  CLEAR_BIT(hspi->Instance->CR2, SPIBUS_CR2_DMA);
+  hspi->State = HAL_SPI_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Build the register images of a device.
+  * @note   The CRC, the TI mode and the bidirectional modes are not supported.
+  * @param  pDevice Pointer to a BSP_SPIBUS_DeviceTypeDef structure.
+  * @param  pInit Device settings, Mode must be SPI_MODE_MASTER, Direction
+  *               SPI_DIRECTION_2LINES and NSS SPI_NSS_SOFT.
+  * @param  CSPort Chip select port.
+  * @param  CSPin Chip select pin.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIBUS_DeviceInit(BSP_SPIBUS_DeviceTypeDef *pDevice, const SPI_InitTypeDef *pInit,
+                                        GPIO_TypeDef *CSPort, uint16_t CSPin)
+{
+  if ((pDevice == NULL) || (pInit == NULL) || (CSPort == NULL) || (CSPin == 0U) ||
+      (pInit->Mode != SPI_MODE_MASTER) || (pInit->Direction != SPI_DIRECTION_2LINES) ||
+      (pInit->NSS != SPI_NSS_SOFT))
+  {
+    return HAL_ERROR;
+  }
+
+  assert_param(IS_SPI_DATASIZE(pInit->DataSize));
+  assert_param(IS_SPI_BAUDRATE_PRESCALER(pInit->BaudRatePrescaler));
+  assert_param(IS_SPI_FIRST_BIT(pInit->FirstBit));
+  assert_param(IS_SPI_CPOL(pInit->CLKPolarity));
+  assert_param(IS_SPI_CPHA(pInit->CLKPhase));
+
+  /* Same register layout as HAL_SPI_Init() */
+  pDevice->CR1 = (pInit->Mode & (SPI_CR1_MSTR | SPI_CR1_SSI)) |
+                 (pInit->CLKPolarity & SPI_CR1_CPOL) |
+                 (pInit->CLKPhase & SPI_CR1_CPHA) |
+                 (pInit->NSS & SPI_CR1_SSM) |
+                 (pInit->BaudRatePrescaler & SPI_CR1_BR_Msk) |
+                 (pInit->DataSize & SPI_CR1_DFF_Msk) |
+                 (pInit->FirstBit & SPI_CR1_LSBFIRST);
+  pDevice->CR2 = (pInit->DataSize > SPI_DATASIZE_8BIT) ? SPI_RXFIFO_THRESHOLD_HF : SPI_RXFIFO_THRESHOLD_QF;
+  pDevice->CSPort = CSPort;
+  pDevice->CSPin  = CSPin;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SPIBUS_Exported_Functions_Group2 Transaction functions
+  * @brief    Transaction functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Transaction functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Queue a transaction
+      (+) Check that the queue is empty
+      (+) Be notified of the end of each transaction
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Queue a transaction, it starts at once when the bus is idle.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @param  pXfer Transaction, it must not be modified before its callback.
+  * @retval HAL status, HAL_BUSY when the transaction is already queued
+  */
+HAL_StatusTypeDef BSP_SPIBUS_Submit(BSP_SPIBUS_TypeDef *hbus, BSP_SPIBUS_XferTypeDef *pXfer)
+{
+  uint32_t primask_bit;
+
+  if ((hbus == NULL) || (hbus->hspi == NULL) || (pXfer == NULL) || (pXfer->pDevice == NULL) ||
+      (pXfer->Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (pXfer->Status == BSP_SPIBUS_STATUS_QUEUED)
+  {
+    return HAL_BUSY;
+  }
+
+  pXfer->Status = BSP_SPIBUS_STATUS_QUEUED;
+  pXfer->pNext  = NULL;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (hbus->pHead == NULL)
+  {
+    hbus->pHead = pXfer;
+    hbus->pTail = pXfer;
+    if (SPIBUS_Start(hbus) != HAL_OK)
+    {
+      SPIBUS_End(hbus, BSP_SPIBUS_STATUS_ERROR);
+    }
+  }
+  else
+  {
+    hbus->pTail->pNext = pXfer;
+    hbus->pTail = pXfer;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check whether all the queued transactions ended.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @retval 1 when the bus is idle, 0 otherwise
+  */
+uint32_t BSP_SPIBUS_IsIdle(const BSP_SPIBUS_TypeDef *hbus)
+{
+  return (hbus->pHead == NULL) ? 1U : 0U;
+}
+
+/**
+  * @brief  Transaction end callback.
+  * @note   Called from the Rx DMA interrupt, pXfer->Status holds the result.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @param  pXfer Transaction ended.
+  * @retval None
+  */
+__weak void BSP_SPIBUS_XferCpltCallback(BSP_SPIBUS_TypeDef *hbus, BSP_SPIBUS_XferTypeDef *pXfer)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hbus);
+  UNUSED(pXfer);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SPIBUS_XferCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPIBUS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the bus index of a SPI.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure.
+  * @retval Index, SPIBUS_NUMBER for an unknown instance
+  */
+static uint32_t SPIBUS_GetIndex(const SPI_HandleTypeDef *hspi)
+{
+  uint32_t index;
+
+  for (index = 0U; index < SPIBUS_NUMBER; index++)
+  {
+    if (hspi->Instance == SPIBUS_Instances[index])
+    {
+      break;
+    }
+  }
+
+  return index;
+}
+
+/**
+  * @brief  Set the data size and the memory increment of a bus DMA channel.
+  * @note   The channel is only written when it changes, it is idle here.
+  * @param  hdma Pointer to the hdmarx or hdmatx of the bus SPI.
+  * @param  HalfWord 1 for u16 data, 0 for u8 data.
+  * @param  MemInc DMA_MINC_ENABLE or DMA_MINC_DISABLE.
+  * @retval None
+  */
+static void SPIBUS_SetChannel(DMA_HandleTypeDef *hdma, uint32_t HalfWord, uint32_t MemInc)
+{
+  uint32_t ccr = MemInc;
+
+  if (HalfWord != 0U)
+  {
+    ccr |= DMA_MDATAALIGN_HALFWORD | DMA_PDATAALIGN_HALFWORD;
+  }
+
+  if ((hdma->Instance->CCR & SPIBUS_CCR_MASK) != ccr)
+  {
+    __HAL_DMA_DISABLE(hdma);
+    MODIFY_REG(hdma->Instance->CCR, SPIBUS_CCR_MASK, ccr);
+    hdma->Init.MemInc              = MemInc;
+    hdma->Init.MemDataAlignment    = ccr & DMA_CCR_MSIZE;
+    hdma->Init.PeriphDataAlignment = ccr & DMA_CCR_PSIZE;
+  }
+}
+
+/**
+  * @brief  Switch the SPI to the settings of a device.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @param  pDevice Next device.
+  * @retval None
+  */
+static void SPIBUS_Configure(BSP_SPIBUS_TypeDef *hbus, const BSP_SPIBUS_DeviceTypeDef *pDevice)
+{
+  SPI_TypeDef *instance = hbus->hspi->Instance;
+
+  /* The previous transaction is over, the SPI is not busy */
+  if (pDevice->CR1 != hbus->CR1)
+  {
+    CLEAR_BIT(instance->CR1, SPI_CR1_SPE);
+    WRITE_REG(instance->CR1, pDevice->CR1);
+    SET_BIT(instance->CR1, SPI_CR1_SPE);
+    hbus->CR1 = pDevice->CR1;
+  }
+  if (pDevice->CR2 != hbus->CR2)
+  {
+    MODIFY_REG(instance->CR2, SPIBUS_CR2_MASK, pDevice->CR2);
+    hbus->CR2 = pDevice->CR2;
+  }
+}
+
+/**
+  * @brief  Start the transaction at the head of the queue.
+  * @note   Called with the interrupts disabled or from the Rx DMA interrupt.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @retval HAL status, HAL_ERROR when a DMA channel could not be started
+  */
+static HAL_StatusTypeDef SPIBUS_Start(BSP_SPIBUS_TypeDef *hbus)
+{
+  SPI_HandleTypeDef *hspi = hbus->hspi;
+  BSP_SPIBUS_XferTypeDef *pXfer = hbus->pHead;
+  const BSP_SPIBUS_DeviceTypeDef *pDevice = pXfer->pDevice;
+  uint32_t halfword = ((pDevice->CR1 & SPI_CR1_DFF) != 0U) ? 1U : 0U;
+  uint32_t txaddress = (uint32_t)pXfer->pTxData;
+  uint32_t rxaddress = (uint32_t)pXfer->pRxData;
+
+  /* A chip select kept low for another device is released first */
+  if ((hbus->pSelected != NULL) && (hbus->pSelected != pDevice))
+  {
+    HAL_GPIO_WritePin(hbus->pSelected->CSPort, hbus->pSelected->CSPin, GPIO_PIN_SET);
+    hbus->pSelected = NULL;
+  }
+
+  SPIBUS_Configure(hbus, pDevice);
+
+  SPIBUS_SetChannel(hspi->hdmatx, halfword, (pXfer->pTxData != NULL) ? DMA_MINC_ENABLE : DMA_MINC_DISABLE);
+  SPIBUS_SetChannel(hspi->hdmarx, halfword, (pXfer->pRxData != NULL) ? DMA_MINC_ENABLE : DMA_MINC_DISABLE);
+  if (pXfer->pTxData == NULL)
+  {
+    txaddress = (uint32_t)&SPIBUS_TxDummy;
+  }
+  if (pXfer->pRxData == NULL)
+  {
+    rxaddress = (uint32_t)&SPIBUS_RxDummy;
+  }
+
+  if (hbus->pSelected == NULL)
+  {
+    HAL_GPIO_WritePin(pDevice->CSPort, pDevice->CSPin, GPIO_PIN_RESET);
+  }
+  hbus->pSelected = NULL;
+
+  /* Rx first so that no received data is lost, Tx then clocks the transfer */
+  if (HAL_DMA_Start_IT(hspi->hdmarx, (uint32_t)&hspi->Instance->DR, rxaddress, pXfer->Size) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (HAL_DMA_Start(hspi->hdmatx, txaddress, (uint32_t)&hspi->Instance->DR, pXfer->Size) != HAL_OK)
+  {
+    (void)HAL_DMA_Abort(hspi->hdmarx);
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  End the transaction at the head of the queue and start the next one.
+  * @param  hbus Pointer to a BSP_SPIBUS_TypeDef structure.
+  * @param  Status A value of @ref BSP_SPIBUS_Status.
+  * @retval None
+  */
+static void SPIBUS_End(BSP_SPIBUS_TypeDef *hbus, uint32_t Status)
+{
+  BSP_SPIBUS_XferTypeDef *pXfer;
+
+  /* Loop instead of recursing when the next start fails */
+  for (;;)
+  {
+    pXfer = hbus->pHead;
+
+    /* The Tx channel has no interrupt, its transfer is over once Rx completes */
+    (void)HAL_DMA_Abort(hbus->hspi->hdmatx);
+
+    if ((Status == BSP_SPIBUS_STATUS_OK) && ((pXfer->Flags & BSP_SPIBUS_XFER_KEEP_CS) != 0U) &&
+        (pXfer->pNext != NULL) && (pXfer->pNext->pDevice == pXfer->pDevice))
+    {
+      hbus->pSelected = pXfer->pDevice;
+    }
+    else
+    {
+      HAL_GPIO_WritePin(pXfer->pDevice->CSPort, pXfer->pDevice->CSPin, GPIO_PIN_SET);
+    }
+    if (Status != BSP_SPIBUS_STATUS_OK)
+    {
+      hbus->ErrorCount++;
+    }
+
+    hbus->pHead = pXfer->pNext;
+    if (hbus->pHead == NULL)
+    {
+      hbus->pTail = NULL;
+    }
+    pXfer->Status = Status;
+    BSP_SPIBUS_XferCpltCallback(hbus, pXfer);
+
+    if ((hbus->pHead == NULL) || (SPIBUS_Start(hbus) == HAL_OK))
+    {
+      return;
+    }
+    Status = BSP_SPIBUS_STATUS_ERROR;
+  }
+}
+
+/**
+  * @brief  Rx DMA complete callback, the transaction is over on the bus.
+  * @param  hdma Pointer to the hdmarx of the bus SPI.
+  * @retval None
+  */
+static void SPIBUS_DMARxCplt(DMA_HandleTypeDef *hdma)
+{
+  uint32_t index = SPIBUS_GetIndex((const SPI_HandleTypeDef *)hdma->Parent);
+
+  if ((index < SPIBUS_NUMBER) && (SPIBUS_Buses[index] != NULL) && (SPIBUS_Buses[index]->pHead != NULL))
+  {
+    SPIBUS_End(SPIBUS_Buses[index], BSP_SPIBUS_STATUS_OK);
+  }
+}
+
+/**
+  * @brief  Rx DMA error callback.
+  * @param  hdma Pointer to the hdmarx of the bus SPI.
+  * @retval None
+  */
+static void SPIBUS_DMAError(DMA_HandleTypeDef *hdma)
+{
+  uint32_t index = SPIBUS_GetIndex((const SPI_HandleTypeDef *)hdma->Parent);
+
+  if ((index < SPIBUS_NUMBER) && (SPIBUS_Buses[index] != NULL) && (SPIBUS_Buses[index]->pHead != NULL))
+  {
+    SPIBUS_End(SPIBUS_Buses[index], BSP_SPIBUS_STATUS_ERROR);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,854 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spiflash.c
+  * @author  MCU Application Team
+  * @brief   SPI NOR flash BSP service.
+  *          This file provides functions to use an external SPI NOR flash:
+  *           + SFDP and JEDEC ID detection
+  *           + Fast read with DMA for bulk data
+  *           + Small read cache with least recently used replacement
+  *           + Page program batching and blank erase skipping
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the SPI with HAL_SPI_Init() in SPI_MODE_MASTER, 2 lines,
+       SPI_DATASIZE_8BIT, SPI_NSS_SOFT and clock mode 0 or 3. To stream the bulk
+       data, link a DMA channel in DMA_NORMAL mode to its hdmarx and one to its
+       hdmatx and enable their interrupts in the NVIC, otherwise the data is
+       moved by polling. The chip select pin is a push-pull output.
+
+   (#) Call BSP_SPIFLASH_Init(): the flash is woken up from deep power down and
+       identified. The size, the smallest erase and the address length come
+       from the SFDP basic parameter table when the flash has one, from the
+       JEDEC ID capacity byte with 4 KB sector erases otherwise. A flash over
+       16 MB is switched to 4 bytes addressing.
+
+   (#) BSP_SPIFLASH_Read() returns the flash content:
+       (+) Reads shorter than BSP_SPIFLASH_DMA_THRESHOLD are served from a cache
+           of BSP_SPIFLASH_LINE_NUMBER lines of BSP_SPIFLASH_LINE_SIZE bytes, a
+           missing line is loaded whole, replacing the least recently used one.
+       (+) Longer reads are a single fast read command whose data phase runs
+           with DMA, they do not touch the cache.
+
+   (#) BSP_SPIFLASH_Write() programs erased flash. The data is batched in a
+       page buffer and programmed when the page is full, when a write does not
+       follow the previous one in the same page, before a read of the pending
+       bytes, or on BSP_SPIFLASH_Flush(). The leading and trailing 0xFF bytes
+       of a page are not programmed.
+
+   (#) BSP_SPIFLASH_Erase() erases whole EraseSize blocks. A block which reads
+       blank is not erased again, which saves an erase cycle and its time.
+
+   (#) The functions are blocking and must not be called from interrupts. The
+       SPI is only used while they run, it may serve other devices in between.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_spiflash.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SPIFLASH BSP SPIFLASH
+  * @brief SPI NOR flash BSP service
+  * @{
+  */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SPIFLASH_Private_Constants BSP SPIFLASH Private Constants
+  * @{
+  */
+#define SPIFLASH_CMD_WREN         0x06U       /*!< Write enable                                  */
+#define SPIFLASH_CMD_RDSR         0x05U       /*!< Read status register                          */
+#define SPIFLASH_CMD_FAST_READ    0x0BU       /*!< Fast read, one dummy byte                     */
+#define SPIFLASH_CMD_PP           0x02U       /*!< Page program                                  */
+#define SPIFLASH_CMD_SE           0x20U       /*!< 4 KB sector erase                             */
+#define SPIFLASH_CMD_BE           0xD8U       /*!< 64 KB block erase                             */
+#define SPIFLASH_CMD_RDID         0x9FU       /*!< Read JEDEC ID                                 */
+#define SPIFLASH_CMD_RDSFDP       0x5AU       /*!< Read SFDP, 3 bytes address and a dummy byte   */
+#define SPIFLASH_CMD_RDP          0xABU       /*!< Release from deep power down                  */
+#define SPIFLASH_CMD_EN4B         0xB7U       /*!< Enter 4 bytes address mode                    */
+
+#define SPIFLASH_SR_WIP           0x01U       /*!< Write in progress                             */
+
+#define SPIFLASH_XFER_TIMEOUT     100U        /*!< SPI transfer timeout in ms                    */
+#define SPIFLASH_PROGRAM_TIMEOUT  10U         /*!< Page program timeout in ms                    */
+#define SPIFLASH_ERASE_TIMEOUT    3000U       /*!< Block erase timeout in ms                     */
+
+#define SPIFLASH_NO_LINE          0xFFFFFFFFU /*!< Address of an empty cache line                */
+#define SPIFLASH_SIZE_3B          0x01000000U /*!< Largest size with 3 bytes addresses           */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SPIFLASH_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef SPIFLASH_Header(BSP_SPIFLASH_TypeDef *hflash, uint8_t Cmd, uint32_t Address,
+                                         uint32_t AddressBytes, uint32_t Dummy);
+static HAL_StatusTypeDef SPIFLASH_Data(BSP_SPIFLASH_TypeDef *hflash, const uint8_t *pTxData, uint8_t *pRxData,
+                                       uint32_t Size);
+static HAL_StatusTypeDef SPIFLASH_Command(BSP_SPIFLASH_TypeDef *hflash, uint8_t Cmd, uint32_t Address,
+                                          uint32_t AddressBytes, uint32_t Dummy, const uint8_t *pTxData,
+                                          uint8_t *pRxData, uint32_t Size);
+static HAL_StatusTypeDef SPIFLASH_WaitReady(BSP_SPIFLASH_TypeDef *hflash, uint32_t Timeout);
+static HAL_StatusTypeDef SPIFLASH_ReadSFDP(BSP_SPIFLASH_TypeDef *hflash);
+static HAL_StatusTypeDef SPIFLASH_ReadCached(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData,
+                                             uint32_t Size);
+static void              SPIFLASH_Invalidate(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size);
+static HAL_StatusTypeDef SPIFLASH_IsBlank(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size,
+                                          uint32_t *pBlank);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SPIFLASH_Exported_Functions BSP SPIFLASH Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SPIFLASH_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Detect the flash and its geometry
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Detect a SPI flash and initialize its state.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure initialized in master
+  *              mode with 8-bit data, hdmarx and hdmatx may be linked.
+  * @param  CSPort Chip select port.
+  * @param  CSPin Chip select pin.
+  * @retval HAL status, HAL_ERROR when no flash answers
+  */
+HAL_StatusTypeDef BSP_SPIFLASH_Init(BSP_SPIFLASH_TypeDef *hflash, SPI_HandleTypeDef *hspi,
+                                    GPIO_TypeDef *CSPort, uint16_t CSPin)
+{
+  uint8_t id[3];
+  uint32_t index;
+
+  if ((hflash == NULL) || (hspi == NULL) || (CSPort == NULL) || (CSPin == 0U) ||
+      (hspi->Init.Mode != SPI_MODE_MASTER) || (hspi->Init.DataSize != SPI_DATASIZE_8BIT))
+  {
+    return HAL_ERROR;
+  }
+
+  memset(hflash, 0, sizeof(BSP_SPIFLASH_TypeDef));
+  hflash->hspi         = hspi;
+  hflash->CSPort       = CSPort;
+  hflash->CSPin        = CSPin;
+  hflash->AddressBytes = 3U;
+  hflash->EraseCmd     = SPIFLASH_CMD_SE;
+  hflash->EraseSize    = 4096U;
+  for (index = 0U; index < BSP_SPIFLASH_LINE_NUMBER; index++)
+  {
+    hflash->Lines[index].Address = SPIFLASH_NO_LINE;
+  }
+
+  HAL_GPIO_WritePin(CSPort, CSPin, GPIO_PIN_SET);
+
+  /* The flash needs up to a few tens of us to leave deep power down */
+  if (SPIFLASH_Command(hflash, SPIFLASH_CMD_RDP, 0U, 0U, 0U, NULL, NULL, 0U) != HAL_OK)
+  {
+    hflash->hspi = NULL;
+    return HAL_ERROR;
+  }
+  HAL_Delay(1U);
+
+  if (SPIFLASH_Command(hflash, SPIFLASH_CMD_RDID, 0U, 0U, 0U, NULL, id, sizeof(id)) != HAL_OK)
+  {
+    hflash->hspi = NULL;
+    return HAL_ERROR;
+  }
+  hflash->JedecId = ((uint32_t)id[0] << 16U) | ((uint32_t)id[1] << 8U) | (uint32_t)id[2];
+  if ((hflash->JedecId == 0x000000U) || (hflash->JedecId == 0xFFFFFFU))
+  {
+    hflash->hspi = NULL;
+    return HAL_ERROR;
+  }
+
+  /* Most flashes encode their size as a power of 2 in the capacity byte */
+  if ((id[2] >= 0x10U) && (id[2] <= 0x1FU))
+  {
+    hflash->Size = 1UL << id[2];
+  }
+
+  /* The SFDP table, when present, is authoritative */
+  (void)SPIFLASH_ReadSFDP(hflash);
+
+  if (hflash->Size == 0U)
+  {
+    hflash->hspi = NULL;
+    return HAL_ERROR;
+  }
+
+  if ((hflash->Size > SPIFLASH_SIZE_3B) && (hflash->AddressBytes == 3U))
+  {
+    if (SPIFLASH_Command(hflash, SPIFLASH_CMD_EN4B, 0U, 0U, 0U, NULL, NULL, 0U) != HAL_OK)
+    {
+      hflash->hspi = NULL;
+      return HAL_ERROR;
+    }
+    hflash->AddressBytes = 4U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SPIFLASH_Exported_Functions_Group2 Operation functions
+  * @brief    Operation functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Operation functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Read the flash through the cache or with DMA
+      (+) Program the flash by pages
+      (+) Erase the flash by blocks
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Read the flash content.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address of the first byte.
+  * @param  pData Pointer to the data buffer.
+  * @param  Size Number of bytes to read.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIFLASH_Read(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData, uint32_t Size)
+{
+  uint32_t start;
+
+  if ((hflash == NULL) || (hflash->hspi == NULL) || (pData == NULL) || (Size == 0U) ||
+      (Size > hflash->Size) || (Address > (hflash->Size - Size)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Program the pending bytes first when they are read back */
+  if (hflash->ProgEnd != hflash->ProgStart)
+  {
+    start = hflash->ProgAddress + hflash->ProgStart;
+    if ((Address < (hflash->ProgAddress + hflash->ProgEnd)) && ((Address + Size) > start))
+    {
+      if (BSP_SPIFLASH_Flush(hflash) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+    }
+  }
+
+  if (Size < BSP_SPIFLASH_DMA_THRESHOLD)
+  {
+    return SPIFLASH_ReadCached(hflash, Address, pData, Size);
+  }
+
+  return SPIFLASH_Command(hflash, SPIFLASH_CMD_FAST_READ, Address, hflash->AddressBytes, 1U, NULL, pData, Size);
+}
+
+/**
+  * @brief  Program erased flash.
+  * @note   The data may stay in the page buffer until the page is full or
+  *         BSP_SPIFLASH_Flush() is called.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address of the first byte.
+  * @param  pData Pointer to the data buffer, copied before the function returns.
+  * @param  Size Number of bytes to program.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIFLASH_Write(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, const uint8_t *pData,
+                                     uint32_t Size)
+{
+  uint32_t page;
+  uint32_t offset;
+  uint32_t length;
+
+  if ((hflash == NULL) || (hflash->hspi == NULL) || (pData == NULL) || (Size == 0U) ||
+      (Size > hflash->Size) || (Address > (hflash->Size - Size)))
+  {
+    return HAL_ERROR;
+  }
+
+  while (Size > 0U)
+  {
+    page   = Address & ~(BSP_SPIFLASH_PAGE_SIZE - 1U);
+    offset = Address - page;
+    length = BSP_SPIFLASH_PAGE_SIZE - offset;
+    if (length > Size)
+    {
+      length = Size;
+    }
+
+    /* Only a write continuing the pending bytes is batched with them */
+    if ((hflash->ProgEnd != hflash->ProgStart) && ((page != hflash->ProgAddress) || (offset != hflash->ProgEnd)))
+    {
+      if (BSP_SPIFLASH_Flush(hflash) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+    }
+    if (hflash->ProgEnd == hflash->ProgStart)
+    {
+      hflash->ProgAddress = page;
+      hflash->ProgStart   = offset;
+      hflash->ProgEnd     = offset;
+    }
+
+    memcpy(&hflash->ProgBuffer[offset], pData, length);
+    hflash->ProgEnd += length;
+
+    if (hflash->ProgEnd == BSP_SPIFLASH_PAGE_SIZE)
+    {
+      if (BSP_SPIFLASH_Flush(hflash) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+    }
+
+    Address += length;
+    pData   += length;
+    Size    -= length;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Program the bytes pending in the page buffer.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @retval HAL status, the pending bytes are dropped on error
+  */
+HAL_StatusTypeDef BSP_SPIFLASH_Flush(BSP_SPIFLASH_TypeDef *hflash)
+{
+  HAL_StatusTypeDef status;
+  uint32_t start;
+  uint32_t end;
+
+  if ((hflash == NULL) || (hflash->hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  start = hflash->ProgStart;
+  end   = hflash->ProgEnd;
+  hflash->ProgStart = 0U;
+  hflash->ProgEnd   = 0U;
+
+  /* Programming 0xFF leaves the cells as they are, skip the erased edges */
+  while ((start < end) && (hflash->ProgBuffer[start] == 0xFFU))
+  {
+    start++;
+  }
+  while ((end > start) && (hflash->ProgBuffer[end - 1U] == 0xFFU))
+  {
+    end--;
+  }
+  if (start == end)
+  {
+    return HAL_OK;
+  }
+
+  status = SPIFLASH_Command(hflash, SPIFLASH_CMD_WREN, 0U, 0U, 0U, NULL, NULL, 0U);
+  if (status == HAL_OK)
+  {
+    status = SPIFLASH_Command(hflash, SPIFLASH_CMD_PP, hflash->ProgAddress + start, hflash->AddressBytes, 0U,
+                              &hflash->ProgBuffer[start], NULL, end - start);
+  }
+  if (status == HAL_OK)
+  {
+    status = SPIFLASH_WaitReady(hflash, SPIFLASH_PROGRAM_TIMEOUT);
+  }
+
+  SPIFLASH_Invalidate(hflash, hflash->ProgAddress + start, end - start);
+
+  return status;
+}
+
+/**
+  * @brief  Erase flash blocks.
+  * @note   The pending bytes are programmed first.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address, a multiple of EraseSize.
+  * @param  Size Number of bytes, a multiple of EraseSize.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIFLASH_Erase(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size)
+{
+  HAL_StatusTypeDef status;
+  uint32_t block;
+  uint32_t blank;
+
+  if ((hflash == NULL) || (hflash->hspi == NULL) || (Size == 0U) || (Size > hflash->Size) ||
+      (Address > (hflash->Size - Size)) || ((Address % hflash->EraseSize) != 0U) ||
+      ((Size % hflash->EraseSize) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = BSP_SPIFLASH_Flush(hflash);
+
+  for (block = Address; (status == HAL_OK) && (block < (Address + Size)); block += hflash->EraseSize)
+  {
+    status = SPIFLASH_IsBlank(hflash, block, hflash->EraseSize, &blank);
+    if ((status == HAL_OK) && (blank != 0U))
+    {
+      hflash->EraseSkips++;
+      continue;
+    }
+    if (status == HAL_OK)
+    {
+      status = SPIFLASH_Command(hflash, SPIFLASH_CMD_WREN, 0U, 0U, 0U, NULL, NULL, 0U);
+    }
+    if (status == HAL_OK)
+    {
+      status = SPIFLASH_Command(hflash, hflash->EraseCmd, block, hflash->AddressBytes, 0U, NULL, NULL, 0U);
+    }
+    if (status == HAL_OK)
+    {
+      status = SPIFLASH_WaitReady(hflash, SPIFLASH_ERASE_TIMEOUT);
+    }
+  }
+
+  SPIFLASH_Invalidate(hflash, Address, Size);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPIFLASH_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Select the flash and send a command header.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Cmd Command opcode.
+  * @param  Address Command address.
+  * @param  AddressBytes Number of address bytes, 0, 3 or 4.
+  * @param  Dummy Number of dummy bytes, 0 or 1.
+  * @retval HAL status, the chip select stays low
+  */
+static HAL_StatusTypeDef SPIFLASH_Header(BSP_SPIFLASH_TypeDef *hflash, uint8_t Cmd, uint32_t Address,
+                                         uint32_t AddressBytes, uint32_t Dummy)
+{
+  uint8_t header[6];
+  uint32_t length = 0U;
+
+  header[length++] = Cmd;
+  if (AddressBytes == 4U)
+  {
+    header[length++] = (uint8_t)(Address >> 24U);
+  }
+  if (AddressBytes != 0U)
+  {
+    header[length++] = (uint8_t)(Address >> 16U);
+    header[length++] = (uint8_t)(Address >> 8U);
+    header[length++] = (uint8_t)Address;
+  }
+  if (Dummy != 0U)
+  {
+    header[length++] = 0xFFU;
+  }
+
+  HAL_GPIO_WritePin(hflash->CSPort, hflash->CSPin, GPIO_PIN_RESET);
+
+  return HAL_SPI_Transmit(hflash->hspi, header, (uint16_t)length, SPIFLASH_XFER_TIMEOUT);
+}
+
+/**
+  * @brief  Run the data phase of a command, with DMA from BSP_SPIFLASH_DMA_THRESHOLD bytes.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  pTxData Data sent, used when pRxData is NULL.
+  * @param  pRxData Data received, or NULL.
+  * @param  Size Number of bytes.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIFLASH_Data(BSP_SPIFLASH_TypeDef *hflash, const uint8_t *pTxData, uint8_t *pRxData,
+                                       uint32_t Size)
+{
+  SPI_HandleTypeDef *hspi = hflash->hspi;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t dma;
+  uint32_t length;
+  uint32_t tickstart;
+
+  dma = ((Size >= BSP_SPIFLASH_DMA_THRESHOLD) && (hspi->hdmarx != NULL) && (hspi->hdmatx != NULL)) ? 1U : 0U;
+
+  while ((status == HAL_OK) && (Size > 0U))
+  {
+    length = (Size > 0xFFFFU) ? 0xFFFFU : Size;
+
+    if (dma == 0U)
+    {
+      if (pRxData != NULL)
+      {
+        status = HAL_SPI_Receive(hspi, pRxData, (uint16_t)length, SPIFLASH_XFER_TIMEOUT);
+      }
+      else
+      {
+        status = HAL_SPI_Transmit(hspi, (uint8_t *)pTxData, (uint16_t)length, SPIFLASH_XFER_TIMEOUT);
+      }
+    }
+    else
+    {
+      if (pRxData != NULL)
+      {
+        status = HAL_SPI_Receive_DMA(hspi, pRxData, (uint16_t)length);
+      }
+      else
+      {
+        status = HAL_SPI_Transmit_DMA(hspi, (uint8_t *)pTxData, (uint16_t)length);
+      }
+
+      tickstart = HAL_GetTick();
+      while ((status == HAL_OK) && (HAL_SPI_GetState(hspi) != HAL_SPI_STATE_READY))
+      {
+        if ((HAL_GetTick() - tickstart) > SPIFLASH_XFER_TIMEOUT)
+        {
+          (void)HAL_SPI_Abort(hspi);
+          status = HAL_TIMEOUT;
+        }
+      }
+      if ((status == HAL_OK) && (HAL_SPI_GetError(hspi) != HAL_SPI_ERROR_NONE))
+      {
+        status = HAL_ERROR;
+      }
+    }
+
+    if (pRxData != NULL)
+    {
+      pRxData += length;
+    }
+    else
+    {
+      pTxData += length;
+    }
+    Size -= length;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Run a complete command.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Cmd Command opcode.
+  * @param  Address Command address.
+  * @param  AddressBytes Number of address bytes, 0, 3 or 4.
+  * @param  Dummy Number of dummy bytes, 0 or 1.
+  * @param  pTxData Data sent, used when pRxData is NULL.
+  * @param  pRxData Data received, or NULL.
+  * @param  Size Number of data bytes, may be 0.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIFLASH_Command(BSP_SPIFLASH_TypeDef *hflash, uint8_t Cmd, uint32_t Address,
+                                          uint32_t AddressBytes, uint32_t Dummy, const uint8_t *pTxData,
+                                          uint8_t *pRxData, uint32_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  status = SPIFLASH_Header(hflash, Cmd, Address, AddressBytes, Dummy);
+  if ((status == HAL_OK) && (Size > 0U))
+  {
+    status = SPIFLASH_Data(hflash, pTxData, pRxData, Size);
+  }
+
+  HAL_GPIO_WritePin(hflash->CSPort, hflash->CSPin, GPIO_PIN_SET);
+
+  return status;
+}
+
+/**
+  * @brief  Wait for the end of a program or erase operation.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Timeout Timeout duration in ms.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIFLASH_WaitReady(BSP_SPIFLASH_TypeDef *hflash, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint8_t sr;
+
+  do
+  {
+    if (SPIFLASH_Command(hflash, SPIFLASH_CMD_RDSR, 0U, 0U, 0U, NULL, &sr, 1U) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    if ((sr & SPIFLASH_SR_WIP) == 0U)
+    {
+      return HAL_OK;
+    }
+  } while ((HAL_GetTick() - tickstart) <= Timeout);
+
+  return HAL_TIMEOUT;
+}
+
+/**
+  * @brief  Read the geometry from the SFDP basic flash parameter table.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @retval HAL status, HAL_ERROR when the flash has no usable table
+  */
+static HAL_StatusTypeDef SPIFLASH_ReadSFDP(BSP_SPIFLASH_TypeDef *hflash)
+{
+  uint8_t header[16];
+  uint8_t table[8];
+  uint32_t pointer;
+  uint32_t dword1;
+  uint32_t dword2;
+  uint32_t bits;
+
+  /* SFDP header then the first parameter header, the basic table one */
+  if (SPIFLASH_Command(hflash, SPIFLASH_CMD_RDSFDP, 0U, 3U, 1U, NULL, header, sizeof(header)) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if ((header[0] != 'S') || (header[1] != 'F') || (header[2] != 'D') || (header[3] != 'P') ||
+      (header[8] != 0x00U) || (header[11] < 2U))
+  {
+    return HAL_ERROR;
+  }
+
+  pointer = ((uint32_t)header[14] << 16U) | ((uint32_t)header[13] << 8U) | (uint32_t)header[12];
+  if (SPIFLASH_Command(hflash, SPIFLASH_CMD_RDSFDP, pointer, 3U, 1U, NULL, table, sizeof(table)) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  dword1 = ((uint32_t)table[3] << 24U) | ((uint32_t)table[2] << 16U) | ((uint32_t)table[1] << 8U) | table[0];
+  dword2 = ((uint32_t)table[7] << 24U) | ((uint32_t)table[6] << 16U) | ((uint32_t)table[5] << 8U) | table[4];
+
+  /* Density in bits, either N - 1 or 2^N */
+  if ((dword2 & 0x80000000U) == 0U)
+  {
+    hflash->Size = (dword2 >> 3U) + 1U;
+  }
+  else
+  {
+    bits = dword2 & 0x7FFFFFFFU;
+    if ((bits < 3U) || (bits > 34U))
+    {
+      return HAL_ERROR;
+    }
+    hflash->Size = 1UL << (bits - 3U);
+  }
+
+  /* 4 KB erase opcode when supported, 64 KB blocks otherwise */
+  if ((dword1 & 0x3U) == 0x1U)
+  {
+    hflash->EraseCmd  = (uint8_t)(dword1 >> 8U);
+    hflash->EraseSize = 4096U;
+  }
+  else
+  {
+    hflash->EraseCmd  = SPIFLASH_CMD_BE;
+    hflash->EraseSize = 65536U;
+  }
+
+  /* Flash only accepting 4 bytes addresses */
+  if (((dword1 >> 17U) & 0x3U) == 0x2U)
+  {
+    hflash->AddressBytes = 4U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read through the cache.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address of the first byte.
+  * @param  pData Pointer to the data buffer.
+  * @param  Size Number of bytes to read.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIFLASH_ReadCached(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint8_t *pData,
+                                             uint32_t Size)
+{
+  BSP_SPIFLASH_LineTypeDef *line;
+  uint32_t base;
+  uint32_t offset;
+  uint32_t length;
+  uint32_t index;
+
+  while (Size > 0U)
+  {
+    base   = Address & ~(BSP_SPIFLASH_LINE_SIZE - 1U);
+    offset = Address - base;
+    length = BSP_SPIFLASH_LINE_SIZE - offset;
+    if (length > Size)
+    {
+      length = Size;
+    }
+
+    /* Look for the line, keeping the least recently used one as victim */
+    line = &hflash->Lines[0];
+    for (index = 0U; index < BSP_SPIFLASH_LINE_NUMBER; index++)
+    {
+      if (hflash->Lines[index].Address == base)
+      {
+        line = &hflash->Lines[index];
+        break;
+      }
+      if (hflash->Lines[index].Stamp < line->Stamp)
+      {
+        line = &hflash->Lines[index];
+      }
+    }
+
+    if (index < BSP_SPIFLASH_LINE_NUMBER)
+    {
+      hflash->CacheHits++;
+    }
+    else
+    {
+      hflash->CacheMisses++;
+      line->Address = SPIFLASH_NO_LINE;
+      line->Stamp   = 0U;
+      if (SPIFLASH_Command(hflash, SPIFLASH_CMD_FAST_READ, base, hflash->AddressBytes, 1U, NULL, line->Data,
+                           BSP_SPIFLASH_LINE_SIZE) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+      line->Address = base;
+    }
+
+    hflash->Stamp++;
+    line->Stamp = hflash->Stamp;
+    memcpy(pData, &line->Data[offset], length);
+
+    Address += length;
+    pData   += length;
+    Size    -= length;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Drop the cache lines overlapping a flash range.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address of the range.
+  * @param  Size Number of bytes of the range.
+  * @retval None
+  */
+static void SPIFLASH_Invalidate(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size)
+{
+  BSP_SPIFLASH_LineTypeDef *line;
+  uint32_t index;
+
+  for (index = 0U; index < BSP_SPIFLASH_LINE_NUMBER; index++)
+  {
+    line = &hflash->Lines[index];
+    if ((line->Address != SPIFLASH_NO_LINE) && (line->Address < (Address + Size)) &&
+        ((line->Address + BSP_SPIFLASH_LINE_SIZE) > Address))
+    {
+      line->Address = SPIFLASH_NO_LINE;
+      line->Stamp   = 0U;
+    }
+  }
+}
+
+/**
+  * @brief  Check whether a flash range is erased.
+  * @param  hflash Pointer to a BSP_SPIFLASH_TypeDef structure.
+  * @param  Address Flash address of the range.
+  * @param  Size Number of bytes of the range.
+  * @param  pBlank Set to 1 when all the bytes read 0xFF, 0 otherwise.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIFLASH_IsBlank(BSP_SPIFLASH_TypeDef *hflash, uint32_t Address, uint32_t Size,
+                                          uint32_t *pBlank)
+{
+  HAL_StatusTypeDef status;
+  uint8_t chunk[BSP_SPIFLASH_DMA_THRESHOLD];
+  uint32_t index;
+
+  *pBlank = 1U;
+
+  /* One fast read for the whole range, stopped at the first programmed byte */
+  status = SPIFLASH_Header(hflash, SPIFLASH_CMD_FAST_READ, Address, hflash->AddressBytes, 1U);
+  while ((status == HAL_OK) && (Size > 0U) && (*pBlank != 0U))
+  {
+    status = SPIFLASH_Data(hflash, NULL, chunk, sizeof(chunk));
+    for (index = 0U; (status == HAL_OK) && (index < sizeof(chunk)); index++)
+    {
+      if (chunk[index] != 0xFFU)
+      {
+        *pBlank = 0U;
+        break;
+      }
+    }
+    Size = (Size > sizeof(chunk)) ? (Size - sizeof(chunk)) : 0U;
+  }
+
+  HAL_GPIO_WritePin(hflash->CSPort, hflash->CSPin, GPIO_PIN_SET);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
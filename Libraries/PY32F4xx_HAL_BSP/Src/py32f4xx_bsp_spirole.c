@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spirole.c
+  * @author  MCU Application Team
+  * @brief   SPI/I2S role switch BSP service.
+  *          This file provides functions to share a SPI between a SPI and an
+  *          I2S handle without initializing it again at each switch:
+  *           + Register snapshot of each role
+  *           + DMA channels configuration and request restored with the role
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Fill a SPI_HandleTypeDef and an I2S_HandleTypeDef for the same instance
+       (SPI2 or SPI3), in the reset state. Their HAL_SPI_MspInit() and
+       HAL_I2S_MspInit() configure the pins, link and initialize their DMA
+       handles and map the DMA channels with HAL_DMA_ChannelMap(). The two roles
+       may use the same DMA channels with different settings.
+
+   (#) Call BSP_SPIROLE_Init(): both handles are initialized once, a snapshot
+       of the registers is taken after each initialization and the requested
+       role is applied.
+
+   (#) Use the HAL functions of the active handle only, the other one is held
+       in the busy state. Call BSP_SPIROLE_Switch() to change role: once the
+       active handle is ready (after HAL_I2S_DMAStop() for a circular audio
+       stream), the SPI registers and the DMA channels are written from the
+       snapshot of the new role, which takes a few tens of bus cycles.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_spirole.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SPIROLE BSP SPIROLE
+  * @brief SPI/I2S role switch BSP service
+  * @{
+  */
+
+#if defined(HAL_SPI_MODULE_ENABLED) && defined(HAL_I2S_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SPIROLE_Private_Constants BSP SPIROLE Private Constants
+  * @{
+  */
+#define SPIROLE_CR2_RUN           (SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN | SPI_CR2_TXEIE | SPI_CR2_RXNEIE | \
+                                   SPI_CR2_ERRIE)
+#define SPIROLE_CCR_MASK          (DMA_CCR_PL | DMA_CCR_MSIZE | DMA_CCR_PSIZE | DMA_CCR_MINC | \
+                                   DMA_CCR_PINC | DMA_CCR_CIRC | DMA_CCR_DIR)
+#define SPIROLE_MAP_MASK          0x7FU
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SPIROLE_Private_Functions
+  * @{
+  */
+static uint32_t SPIROLE_GetCCR(const DMA_HandleTypeDef *hdma);
+static uint32_t SPIROLE_GetMap(const DMA_HandleTypeDef *hdma);
+static void     SPIROLE_Save(BSP_SPIROLE_ContextTypeDef *pContext, SPI_TypeDef *Instance,
+                             const DMA_HandleTypeDef *hdmatx, const DMA_HandleTypeDef *hdmarx);
+static void     SPIROLE_Restore(const BSP_SPIROLE_ContextTypeDef *pContext, SPI_TypeDef *Instance,
+                                DMA_HandleTypeDef *hdmatx, DMA_HandleTypeDef *hdmarx);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SPIROLE_Exported_Functions BSP SPIROLE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize both roles of a SPI and apply one of them.
+  * @param  hrole Pointer to a BSP_SPIROLE_TypeDef structure.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure to initialize.
+  * @param  hi2s Pointer to an I2S_HandleTypeDef structure to initialize, same instance.
+  * @param  Role Initial role, a value of @ref BSP_SPIROLE_Role.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPIROLE_Init(BSP_SPIROLE_TypeDef *hrole, SPI_HandleTypeDef *hspi, I2S_HandleTypeDef *hi2s,
+                                   uint32_t Role)
+{
+  if ((hrole == NULL) || (hspi == NULL) || (hi2s == NULL) || (hspi->Instance != hi2s->Instance) ||
+      ((Role != BSP_SPIROLE_SPI) && (Role != BSP_SPIROLE_I2S)))
+  {
+    return HAL_ERROR;
+  }
+
+  hrole->hspi        = hspi;
+  hrole->hi2s        = hi2s;
+  hrole->SwitchCount = 0U;
+
+  if (HAL_SPI_Init(hspi) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  SPIROLE_Save(&hrole->Context[BSP_SPIROLE_SPI], hspi->Instance, hspi->hdmatx, hspi->hdmarx);
+
+  if (HAL_I2S_Init(hi2s) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  SPIROLE_Save(&hrole->Context[BSP_SPIROLE_I2S], hi2s->Instance, hi2s->hdmatx, hi2s->hdmarx);
+
+  /* The I2S registers are in place, only the SPI role needs a restore */
+  hrole->Role = BSP_SPIROLE_I2S;
+  hspi->State = HAL_SPI_STATE_BUSY;
+
+  return BSP_SPIROLE_Switch(hrole, Role);
+}
+
+/**
+  * @brief  Switch a SPI to another role.
+  * @param  hrole Pointer to a BSP_SPIROLE_TypeDef structure.
+  * @param  Role New role, a value of @ref BSP_SPIROLE_Role.
+  * @retval HAL status, HAL_BUSY while the active handle or the DMA channels
+  *         of the new role are busy
+  */
+HAL_StatusTypeDef BSP_SPIROLE_Switch(BSP_SPIROLE_TypeDef *hrole, uint32_t Role)
+{
+  SPI_HandleTypeDef *hspi;
+  I2S_HandleTypeDef *hi2s;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+
+  if ((hrole == NULL) || (hrole->hspi == NULL) || ((Role != BSP_SPIROLE_SPI) && (Role != BSP_SPIROLE_I2S)))
+  {
+    return HAL_ERROR;
+  }
+  if (Role == hrole->Role)
+  {
+    return HAL_OK;
+  }
+  hspi = hrole->hspi;
+  hi2s = hrole->hi2s;
+
+  if (hrole->Role == BSP_SPIROLE_SPI)
+  {
+    if ((hspi->State != HAL_SPI_STATE_READY) || ((hspi->Instance->SR & SPI_SR_BSY) != 0U))
+    {
+      return HAL_BUSY;
+    }
+    hdmatx = hi2s->hdmatx;
+    hdmarx = hi2s->hdmarx;
+  }
+  else
+  {
+    if (hi2s->State != HAL_I2S_STATE_READY)
+    {
+      return HAL_BUSY;
+    }
+    hdmatx = hspi->hdmatx;
+    hdmarx = hspi->hdmarx;
+  }
+
+  /* A channel shared by both roles is idle once the active handle is ready */
+  if (((hdmatx != NULL) && (hdmatx->State != HAL_DMA_STATE_READY)) ||
+      ((hdmarx != NULL) && (hdmarx->State != HAL_DMA_STATE_READY)))
+  {
+    return HAL_BUSY;
+  }
+
+  SPIROLE_Restore(&hrole->Context[Role], hspi->Instance, hdmatx, hdmarx);
+
+  if (Role == BSP_SPIROLE_SPI)
+  {
+    hi2s->State = HAL_I2S_STATE_BUSY;
+    hspi->State = HAL_SPI_STATE_READY;
+  }
+  else
+  {
+    hspi->State = HAL_SPI_STATE_BUSY;
+    hi2s->State = HAL_I2S_STATE_READY;
+  }
+  hrole->Role = Role;
+  hrole->SwitchCount++;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPIROLE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the CCR configuration bits of a DMA handle.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure, may be NULL.
+  * @retval CCR configuration
+  */
+static uint32_t SPIROLE_GetCCR(const DMA_HandleTypeDef *hdma)
+{
+  if (hdma == NULL)
+  {
+    return 0U;
+  }
+
+  /* Same layout as HAL_DMA_Init() */
+  return (hdma->Init.Direction | hdma->Init.PeriphInc | hdma->Init.MemInc | hdma->Init.PeriphDataAlignment |
+          hdma->Init.MemDataAlignment | hdma->Init.Mode | hdma->Init.Priority) & SPIROLE_CCR_MASK;
+}
+
+/**
+  * @brief  Return the request mapped on the channel of a DMA handle.
+  * @param  hdma Pointer to a DMA_HandleTypeDef structure, may be NULL.
+  * @retval Request, a DMA_CHANNEL_MAP_* value
+  */
+static uint32_t SPIROLE_GetMap(const DMA_HandleTypeDef *hdma)
+{
+  uint32_t position;
+
+  if (hdma == NULL)
+  {
+    return 0U;
+  }
+
+  /* Same channel numbering as HAL_DMA_ChannelMap() */
+  if ((uint32_t)(hdma->Instance) < (uint32_t)(DMA2_Channel1))
+  {
+    position = ((uint32_t)hdma->Instance - (uint32_t)DMA1_Channel1) / ((uint32_t)DMA1_Channel2 - (uint32_t)DMA1_Channel1);
+  }
+  else
+  {
+    position = (((uint32_t)hdma->Instance - (uint32_t)DMA2_Channel1) / ((uint32_t)DMA2_Channel2 - (uint32_t)DMA2_Channel1)) + 7U;
+  }
+
+  return (SYSCFG->CFGR[2U + (position >> 2U)] >> (8U * (position & 0x03U))) & SPIROLE_MAP_MASK;
+}
+
+/**
+  * @brief  Take the snapshot of a role.
+  * @param  pContext Snapshot to fill.
+  * @param  Instance SPI registers base address.
+  * @param  hdmatx Tx DMA handle of the role, may be NULL.
+  * @param  hdmarx Rx DMA handle of the role, may be NULL.
+  * @retval None
+  */
+static void SPIROLE_Save(BSP_SPIROLE_ContextTypeDef *pContext, SPI_TypeDef *Instance,
+                         const DMA_HandleTypeDef *hdmatx, const DMA_HandleTypeDef *hdmarx)
+{
+  pContext->CR1     = READ_REG(Instance->CR1) & ~SPI_CR1_SPE;
+  pContext->CR2     = READ_REG(Instance->CR2) & ~SPIROLE_CR2_RUN;
+  pContext->CRCPR   = READ_REG(Instance->CRCPR);
+  pContext->I2SCFGR = READ_REG(Instance->I2SCFGR) & ~SPI_I2SCFGR_I2SE;
+  pContext->I2SPR   = READ_REG(Instance->I2SPR);
+  pContext->TxCCR   = SPIROLE_GetCCR(hdmatx);
+  pContext->RxCCR   = SPIROLE_GetCCR(hdmarx);
+  pContext->TxMap   = SPIROLE_GetMap(hdmatx);
+  pContext->RxMap   = SPIROLE_GetMap(hdmarx);
+}
+
+/**
+  * @brief  Apply the snapshot of a role.
+  * @note   The SPI and its DMA channels are idle here.
+  * @param  pContext Snapshot to apply.
+  * @param  Instance SPI registers base address.
+  * @param  hdmatx Tx DMA handle of the role, may be NULL.
+  * @param  hdmarx Rx DMA handle of the role, may be NULL.
+  * @retval None
+  */
+static void SPIROLE_Restore(const BSP_SPIROLE_ContextTypeDef *pContext, SPI_TypeDef *Instance,
+                            DMA_HandleTypeDef *hdmatx, DMA_HandleTypeDef *hdmarx)
+{
+  /* Both roles stopped before any configuration change */
+  CLEAR_BIT(Instance->I2SCFGR, SPI_I2SCFGR_I2SE);
+  CLEAR_BIT(Instance->CR1, SPI_CR1_SPE);
+
+  WRITE_REG(Instance->CR2, pContext->CR2);
+  WRITE_REG(Instance->CRCPR, pContext->CRCPR);
+  WRITE_REG(Instance->I2SPR, pContext->I2SPR);
+  WRITE_REG(Instance->I2SCFGR, pContext->I2SCFGR);
+  WRITE_REG(Instance->CR1, pContext->CR1);
+
+  if (hdmatx != NULL)
+  {
+    __HAL_DMA_DISABLE(hdmatx);
+    MODIFY_REG(hdmatx->Instance->CCR, SPIROLE_CCR_MASK, pContext->TxCCR);
+    HAL_DMA_ChannelMap(hdmatx, pContext->TxMap);
+  }
+  if (hdmarx != NULL)
+  {
+    __HAL_DMA_DISABLE(hdmarx);
+    MODIFY_REG(hdmarx->Instance->CCR, SPIROLE_CCR_MASK, pContext->RxCCR);
+    HAL_DMA_ChannelMap(hdmarx, pContext->RxMap);
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED && HAL_I2S_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
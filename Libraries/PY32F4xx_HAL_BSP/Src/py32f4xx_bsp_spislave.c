@@ -0,0 +1,494 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_spislave.c
+  * @author  MCU Application Team
+  * @brief   SPI slave register map BSP service.
+  *          This file provides functions to serve a register map to a SPI
+  *          master without knowing the transaction length in advance:
+  *           + Header decoding from the first received byte
+  *           + Tx DMA pointed at the addressed registers on the fly
+  *           + Circular Rx DMA ring for the written data
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the SPI with HAL_SPI_Init() in SPI_MODE_SLAVE, 2 lines and
+       SPI_DATASIZE_8BIT. Link a DMA channel in DMA_CIRCULAR mode with byte data
+       to its hdmarx and one in DMA_NORMAL mode with byte data to its hdmatx,
+       neither channel interrupt is used. Enable the SPI interrupt in the NVIC.
+
+   (#) The chip select of the master must also reach an EXTI line configured
+       on both edges. With SPI_NSS_HARD_INPUT it is the NSS pin itself, with
+       SPI_NSS_SOFT any pin, the service then drives the SSI bit. From
+       HAL_GPIO_EXTI_Falling_Callback() and HAL_GPIO_EXTI_Rising_Callback() call
+       BSP_SPISLAVE_CSHandler() with GPIO_PIN_RESET and GPIO_PIN_SET, and from
+       the SPIx_IRQHandler() call BSP_SPISLAVE_IRQHandler().
+
+   (#) Call BSP_SPISLAVE_Init() with the register map, the reception ring and
+       the number of turnaround bytes. The service then owns the SPI.
+
+   (#) A transaction is a header byte followed by data:
+       (+) The header holds the first register address in its bits 6:0 and
+           BSP_SPISLAVE_HEADER_READ in its bit 7 for a read.
+       (+) The Status byte is sent while the header is received, and during
+           the Turnaround bytes of a read.
+       (+) The header is decoded in the RXNE interrupt, which starts the Tx DMA
+           on the addressed registers for a read, and the Rx DMA ring for a
+           write. With a Turnaround of 0 the register data follows the header
+           directly, the master must then leave the interrupt and DMA latency
+           between the header and the first data byte, or use 1 to 3 dummy
+           bytes at higher clock rates.
+       (+) At the chip select rising edge the written bytes are copied from
+           the ring into the registers, then BSP_SPISLAVE_WriteCallback() or
+           BSP_SPISLAVE_ReadCallback() is called with the address and the
+           number of data bytes. The SPI is reset to drop its FIFO content.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_spislave.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SPISLAVE BSP SPISLAVE
+  * @brief SPI slave register map BSP service
+  * @{
+  */
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_SPISLAVE_Private_Constants BSP SPISLAVE Private Constants
+  * @{
+  */
+#define SPISLAVE_REG_SIZE_MAX     128U        /*!< Registers addressed by the header             */
+#define SPISLAVE_TURNAROUND_MAX   3U          /*!< Status bytes fitting the Tx FIFO with the header one */
+#define SPISLAVE_DRAIN_LOOPS      64U         /*!< Bound of the wait for the Rx DMA at chip select release */
+#define SPISLAVE_CR2_DMA          (SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN)
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_SPISLAVE_Private_Functions
+  * @{
+  */
+static uint32_t SPISLAVE_GetRingHead(const BSP_SPISLAVE_TypeDef *hslave);
+static void     SPISLAVE_Reset(BSP_SPISLAVE_TypeDef *hslave);
+static void     SPISLAVE_End(BSP_SPISLAVE_TypeDef *hslave);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SPISLAVE_Exported_Functions BSP SPISLAVE Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_SPISLAVE_Exported_Functions_Group1 Initialization functions
+  * @brief    Initialization functions
+  *
+@verbatim
+ ===============================================================================
+                    ##### Initialization functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Take and give back the SPI of the slave
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start serving a register map on a SPI.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure initialized in slave
+  *              mode, hdmarx in DMA_CIRCULAR mode and hdmatx must be linked.
+  * @param  pRegs Register map.
+  * @param  RegSize Register map size in bytes, 1 to 128.
+  * @param  pRing Reception ring.
+  * @param  RingSize Reception ring size in bytes.
+  * @param  Turnaround Dummy bytes between a read header and the data, 0 to 3.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPISLAVE_Init(BSP_SPISLAVE_TypeDef *hslave, SPI_HandleTypeDef *hspi, uint8_t *pRegs,
+                                    uint32_t RegSize, uint8_t *pRing, uint32_t RingSize, uint32_t Turnaround)
+{
+  if ((hslave == NULL) || (hspi == NULL) || (hspi->hdmarx == NULL) || (hspi->hdmatx == NULL) ||
+      (pRegs == NULL) || (RegSize == 0U) || (RegSize > SPISLAVE_REG_SIZE_MAX) || (pRing == NULL) ||
+      (RingSize == 0U) || (RingSize > 0xFFFFU) || (Turnaround > SPISLAVE_TURNAROUND_MAX) ||
+      (hspi->Init.Mode != SPI_MODE_SLAVE) || (hspi->Init.Direction != SPI_DIRECTION_2LINES) ||
+      (hspi->Init.DataSize != SPI_DATASIZE_8BIT) || (hspi->hdmarx->Init.Mode != DMA_CIRCULAR) ||
+      (hspi->hdmatx->Init.Mode != DMA_NORMAL))
+  {
+    return HAL_ERROR;
+  }
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hslave->hspi       = hspi;
+  hslave->pRegs      = pRegs;
+  hslave->RegSize    = RegSize;
+  hslave->pRing      = pRing;
+  hslave->RingSize   = RingSize;
+  hslave->Turnaround = Turnaround;
+  hslave->Header     = 0U;
+  hslave->RingStart  = 0U;
+  hslave->ErrorCount = 0U;
+  hslave->State      = BSP_SPISLAVE_STATE_IDLE;
+
+  /* The ring runs for ever, the SPI only feeds it between a header and the
+  chip select release */
+  hspi->State = HAL_SPI_STATE_BUSY;
+  if (HAL_DMA_Start(hspi->hdmarx, (uint32_t)&hspi->Instance->DR, (uint32_t)pRing, RingSize) != HAL_OK)
+  {
+    hspi->State = HAL_SPI_STATE_READY;
+    hslave->hspi = NULL;
+    return HAL_ERROR;
+  }
+
+  if (hspi->Init.NSS == SPI_NSS_SOFT)
+  {
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+  }
+  SPISLAVE_Reset(hslave);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop serving the register map and give the SPI back to the HAL.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SPISLAVE_DeInit(BSP_SPISLAVE_TypeDef *hslave)
+{
+  SPI_HandleTypeDef *hspi;
+
+  if ((hslave == NULL) || (hslave->hspi == NULL))
+  {
+    return HAL_ERROR;
+  }
+  hspi = hslave->hspi;
+
+  __HAL_SPI_DISABLE_IT(hspi, SPI_IT_RXNE);
+  CLEAR_BIT(hspi->Instance->CR2, SPISLAVE_CR2_DMA);
+  (void)HAL_DMA_Abort(hspi->hdmatx);
+  (void)HAL_DMA_Abort(hspi->hdmarx);
+  __HAL_SPI_DISABLE(hspi);
+
+  hslave->State = BSP_SPISLAVE_STATE_IDLE;
+  hslave->hspi  = NULL;
+  hspi->State   = HAL_SPI_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup BSP_SPISLAVE_Exported_Functions_Group2 Interrupt functions
+  * @brief    Interrupt functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Interrupt functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Follow the chip select of the master
+      (+) Decode the transaction header
+      (+) Be notified of the end of each transaction
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Handle a chip select edge, called from the EXTI callbacks.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @param  PinState GPIO_PIN_RESET on the falling edge, GPIO_PIN_SET on the rising edge.
+  * @retval None
+  */
+void BSP_SPISLAVE_CSHandler(BSP_SPISLAVE_TypeDef *hslave, GPIO_PinState PinState)
+{
+  SPI_TypeDef *spi;
+  uint32_t index;
+
+  if (hslave->hspi == NULL)
+  {
+    return;
+  }
+  spi = hslave->hspi->Instance;
+
+  /* A missed release is handled before the new transaction */
+  if (hslave->State != BSP_SPISLAVE_STATE_IDLE)
+  {
+    SPISLAVE_End(hslave);
+  }
+
+  if (PinState == GPIO_PIN_RESET)
+  {
+    /* Status bytes sent with the header and the turnaround */
+    for (index = 0U; index <= hslave->Turnaround; index++)
+    {
+      *((__IO uint8_t *)&spi->DR) = hslave->Status;
+    }
+    hslave->State = BSP_SPISLAVE_STATE_HEADER;
+    __HAL_SPI_ENABLE_IT(hslave->hspi, SPI_IT_RXNE);
+
+    if (hslave->hspi->Init.NSS == SPI_NSS_SOFT)
+    {
+      CLEAR_BIT(spi->CR1, SPI_CR1_SSI);
+    }
+  }
+}
+
+/**
+  * @brief  Decode the transaction header, called from the SPIx_IRQHandler().
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @retval None
+  */
+void BSP_SPISLAVE_IRQHandler(BSP_SPISLAVE_TypeDef *hslave)
+{
+  SPI_HandleTypeDef *hspi = hslave->hspi;
+  uint32_t address;
+
+  if ((hspi == NULL) || ((hspi->Instance->CR2 & SPI_CR2_RXNEIE) == 0U) ||
+      ((hspi->Instance->SR & SPI_SR_RXNE) == 0U))
+  {
+    return;
+  }
+  __HAL_SPI_DISABLE_IT(hspi, SPI_IT_RXNE);
+
+  hslave->Header = *((__IO uint8_t *)&hspi->Instance->DR);
+  address = hslave->Header & BSP_SPISLAVE_HEADER_ADDRESS;
+
+  /* The bytes after the header go to the ring, read data included */
+  hslave->RingStart = SPISLAVE_GetRingHead(hslave);
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+
+  if (address >= hslave->RegSize)
+  {
+    hslave->ErrorCount++;
+    hslave->State = BSP_SPISLAVE_STATE_ERROR;
+  }
+  else if ((hslave->Header & BSP_SPISLAVE_HEADER_READ) != 0U)
+  {
+    /* The registers follow the status bytes already in the Tx FIFO */
+    hslave->State = BSP_SPISLAVE_STATE_READ;
+    if (HAL_DMA_Start(hspi->hdmatx, (uint32_t)&hslave->pRegs[address], (uint32_t)&hspi->Instance->DR,
+                      hslave->RegSize - address) == HAL_OK)
+    {
+      SET_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN);
+    }
+    else
+    {
+      hslave->ErrorCount++;
+      hslave->State = BSP_SPISLAVE_STATE_ERROR;
+    }
+  }
+  else
+  {
+    hslave->State = BSP_SPISLAVE_STATE_WRITE;
+  }
+}
+
+/**
+  * @brief  Read transaction end callback.
+  * @note   Called from the chip select interrupt, e.g. to clear read-to-clear flags.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @param  Address First register read.
+  * @param  Size Number of register bytes clocked out, may exceed the map end.
+  * @retval None
+  */
+__weak void BSP_SPISLAVE_ReadCallback(BSP_SPISLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hslave);
+  UNUSED(Address);
+  UNUSED(Size);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SPISLAVE_ReadCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Write transaction end callback.
+  * @note   Called from the chip select interrupt once the registers are updated.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @param  Address First register written.
+  * @param  Size Number of registers written.
+  * @retval None
+  */
+__weak void BSP_SPISLAVE_WriteCallback(BSP_SPISLAVE_TypeDef *hslave, uint32_t Address, uint32_t Size)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hslave);
+  UNUSED(Address);
+  UNUSED(Size);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_SPISLAVE_WriteCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_SPISLAVE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the ring position the Rx DMA writes next.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @retval Ring position
+  */
+static uint32_t SPISLAVE_GetRingHead(const BSP_SPISLAVE_TypeDef *hslave)
+{
+  uint32_t remaining = __HAL_DMA_GET_COUNTER(hslave->hspi->hdmarx);
+
+  return (remaining == 0U) ? 0U : (hslave->RingSize - remaining);
+}
+
+/**
+  * @brief  Reset the SPI to drop the content of its FIFOs.
+  * @note   The configuration is restored, without the DMA requests and the
+  *         RXNE interrupt.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @retval None
+  */
+static void SPISLAVE_Reset(BSP_SPISLAVE_TypeDef *hslave)
+{
+  SPI_TypeDef *spi = hslave->hspi->Instance;
+  uint32_t cr1 = READ_REG(spi->CR1) | SPI_CR1_SPE;
+  uint32_t cr2 = READ_REG(spi->CR2) & ~(SPISLAVE_CR2_DMA | SPI_CR2_RXNEIE);
+
+  if (spi == SPI1)
+  {
+    __HAL_RCC_SPI1_FORCE_RESET();
+    __HAL_RCC_SPI1_RELEASE_RESET();
+  }
+  else if (spi == SPI2)
+  {
+    __HAL_RCC_SPI2_FORCE_RESET();
+    __HAL_RCC_SPI2_RELEASE_RESET();
+  }
+  else
+  {
+    __HAL_RCC_SPI3_FORCE_RESET();
+    __HAL_RCC_SPI3_RELEASE_RESET();
+  }
+
+  WRITE_REG(spi->CR2, cr2);
+  WRITE_REG(spi->CR1, cr1 & ~SPI_CR1_SPE);
+  WRITE_REG(spi->CR1, cr1);
+}
+
+/**
+  * @brief  End the current transaction at the chip select release.
+  * @param  hslave Pointer to a BSP_SPISLAVE_TypeDef structure.
+  * @retval None
+  */
+static void SPISLAVE_End(BSP_SPISLAVE_TypeDef *hslave)
+{
+  SPI_HandleTypeDef *hspi = hslave->hspi;
+  uint32_t state = hslave->State;
+  uint32_t address = hslave->Header & BSP_SPISLAVE_HEADER_ADDRESS;
+  uint32_t position;
+  uint32_t count;
+  uint32_t loops;
+  uint32_t index;
+
+  __HAL_SPI_DISABLE_IT(hspi, SPI_IT_RXNE);
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN);
+  (void)HAL_DMA_Abort(hspi->hdmatx);
+
+  /* Let the Rx DMA take the last bytes out of the FIFO */
+  for (loops = 0U; (loops < SPISLAVE_DRAIN_LOOPS) && ((hspi->Instance->SR & SPI_SR_FRLVL) != 0U) &&
+       ((hspi->Instance->CR2 & SPI_CR2_RXDMAEN) != 0U); loops++)
+  {
+  }
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+
+  if (hspi->Init.NSS == SPI_NSS_SOFT)
+  {
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_SSI);
+  }
+
+  position = hslave->RingStart;
+  count = (SPISLAVE_GetRingHead(hslave) + hslave->RingSize - position) % hslave->RingSize;
+
+  SPISLAVE_Reset(hslave);
+  hslave->State = BSP_SPISLAVE_STATE_IDLE;
+
+  if (state == BSP_SPISLAVE_STATE_WRITE)
+  {
+    if (count > (hslave->RegSize - address))
+    {
+      count = hslave->RegSize - address;
+    }
+    for (index = 0U; index < count; index++)
+    {
+      hslave->pRegs[address + index] = hslave->pRing[position];
+      position = ((position + 1U) == hslave->RingSize) ? 0U : (position + 1U);
+    }
+    BSP_SPISLAVE_WriteCallback(hslave, address, count);
+  }
+  else if (state == BSP_SPISLAVE_STATE_READ)
+  {
+    count = (count > hslave->Turnaround) ? (count - hslave->Turnaround) : 0U;
+    BSP_SPISLAVE_ReadCallback(hslave, address, count);
+  }
+  else
+  {
+    /* Nothing was addressed */
+  }
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,192 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_stack.c
+  * @author  MCU Application Team
+  * @brief   Main stack watermark and guard BSP service.
+  *          This file provides functions to size the main stack:
+  *           + Fill of the stack not used yet with a pattern
+  *           + Peak use found from the words still holding it
+  *           + Guard words at the bottom of the stack, checked for an
+  *             overflow into the heap
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The main stack, the one of main() and of the handlers, runs from
+       _estack, the end of the RAM, down to _sstack of the linker script,
+       STACK_SIZE bytes of the Makefile below it. Build with USE_STACK_USAGE=y
+       and run 'make stack' for the worst case given by the call graph of the
+       compiler; the watermark gives the peak reached on the target.
+
+   (#) Call BSP_STACK_Init() first in main(): the stack between _sstack and
+       BSP_STACK_FILL_MARGIN bytes below the stack pointer is filled with
+       BSP_STACK_FILL. BSP_STACK_GetPeak() then scans it from the bottom for
+       the first word written and returns the bytes used at most since,
+       BSP_STACK_GetFree() the bytes never reached. Run the worst case of the
+       application, the interrupts nested, before trimming STACK_SIZE.
+
+   (#) BSP_STACK_Init() also writes BSP_STACK_GUARD_SIZE bytes of
+       BSP_STACK_GUARD_FILL at the bottom of the stack, the way BSP_RTOS marks
+       the bottom of the thread stacks. The device has no MPU to trap the
+       write, BSP_GUARD watches it with a DWT comparator; otherwise call
+       BSP_STACK_Check() from the main loop or a periodic handler, it
+       returns HAL_ERROR and calls BSP_STACK_OverflowCallback() once a guard
+       word is overwritten. The heap below may be already corrupted then:
+       record the crash and reset from the callback, with
+       BSP_FAULT_Reset(BSP_FAULT_TYPE_STACK, ...) for instance.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_stack.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_STACK BSP STACK
+  * @brief Main stack watermark and guard BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_STACK_Private_Variables BSP STACK Private Variables
+  * @{
+  */
+extern uint32_t _sstack[];  /* Bottom of the main stack, from the linker script */
+extern uint32_t _estack[];  /* Top of the main stack, the end of the RAM */
+
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_STACK_Exported_Functions BSP STACK Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Write the guard words and fill the main stack below the stack
+  *         pointer with BSP_STACK_FILL.
+  * @note   Call it first in main(), before the stack goes deeper.
+  * @retval None
+  */
+void BSP_STACK_Init(void)
+{
+  uint32_t *word = _sstack;
+  uint32_t *guard = _sstack + (BSP_STACK_GUARD_SIZE / 4U);
+  uint32_t *top = (uint32_t *)((__get_MSP() - BSP_STACK_FILL_MARGIN) & ~3U);
+
+  for (; (word < guard) && (word < top); word++)
+  {
+    *word = BSP_STACK_GUARD_FILL;
+  }
+  for (; word < top; word++)
+  {
+    *word = BSP_STACK_FILL;
+  }
+}
+
+/**
+  * @brief  Bytes of the main stack.
+  * @retval Bytes between _sstack and _estack
+  */
+uint32_t BSP_STACK_GetSize(void)
+{
+  return (uint32_t)_estack - (uint32_t)_sstack;
+}
+
+/**
+  * @brief  Bytes of the main stack used at most since BSP_STACK_Init().
+  * @retval Bytes from _estack down to the lowest word written
+  */
+uint32_t BSP_STACK_GetPeak(void)
+{
+  uint32_t *word = _sstack;
+
+  while ((word < _estack) && (*word == BSP_STACK_GUARD_FILL))
+  {
+    word++;
+  }
+  while ((word < _estack) && (*word == BSP_STACK_FILL))
+  {
+    word++;
+  }
+
+  return (uint32_t)_estack - (uint32_t)word;
+}
+
+/**
+  * @brief  Bytes of the main stack never reached since BSP_STACK_Init().
+  * @retval Bytes
+  */
+uint32_t BSP_STACK_GetFree(void)
+{
+  return BSP_STACK_GetSize() - BSP_STACK_GetPeak();
+}
+
+/**
+  * @brief  Check the guard words at the bottom of the main stack.
+  * @note   BSP_STACK_OverflowCallback() is called at each check failed.
+  * @retval HAL_OK, HAL_ERROR once the stack went into the guard
+  */
+HAL_StatusTypeDef BSP_STACK_Check(void)
+{
+  uint32_t index;
+
+  for (index = 0U; index < (BSP_STACK_GUARD_SIZE / 4U); index++)
+  {
+    if (_sstack[index] != BSP_STACK_GUARD_FILL)
+    {
+      BSP_STACK_OverflowCallback();
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Main stack overflow callback, from BSP_STACK_Check().
+  * @retval None
+  */
+__weak void BSP_STACK_OverflowCallback(void)
+{
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_STACK_OverflowCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,529 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_stdout.c
+  * @author  MCU Application Team
+  * @brief   Buffered stdout BSP service.
+  *          This file provides a non blocking printf() backend:
+  *           + A lock free byte queue filled by _write()
+  *           + A UART DMA transmission draining the queue
+  *           + A polling flush for fault handlers
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the UART with HAL_UART_Init() and link a DMA channel to its
+       hdmatx, with the DMA channel and UART interrupts enabled in the NVIC.
+
+   (#) Call BSP_STDOUT_Init() with the UART handle, a queue buffer whose size is a
+       power of two and the overflow policy:
+       (+) BSP_STDOUT_POLICY_DROP: the bytes which do not fit are dropped.
+       (+) BSP_STDOUT_POLICY_BLOCK: the writer waits for the DMA to free some room.
+           From an interrupt handler, or with interrupts masked, the bytes are
+           dropped instead.
+       (+) BSP_STDOUT_POLICY_OVERWRITE: the oldest bytes not yet handed to the DMA
+           are discarded to make room for the new ones.
+       BSP_STDOUT_GetDropped() returns the number of bytes lost so far.
+
+   (#) When USE_HAL_UART_REGISTER_CALLBACKS is 0, call BSP_STDOUT_TxCpltCallback()
+       from HAL_UART_TxCpltCallback(). Otherwise it is registered by BSP_STDOUT_Init().
+
+   (#) printf() output then goes through _write() to BSP_STDOUT_Write(), which
+       copies the data into the queue and returns. The DMA sends the queue in the
+       largest contiguous chunks available, the next chunk being started from the
+       UART transmit complete interrupt. Before BSP_STDOUT_Init() _write() falls
+       back to __io_putchar().
+
+   (#) Writers only use exclusive accesses (LDREX/STREX), so _write() can be
+       called from thread mode and from interrupt handlers of any priority
+       without masking interrupts. Only the short DMA hand over, in the service
+       and interrupt context, runs with interrupts masked.
+
+   (#) From a fault handler, call BSP_STDOUT_Flush() to send the rest of the
+       queue by polling. It does not rely on interrupts nor on the SysTick.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <unistd.h>
+#include "py32f4xx_bsp_stdout.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_STDOUT BSP STDOUT
+  * @brief Buffered stdout BSP service
+  * @{
+  */
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_STDOUT_Private_Constants BSP STDOUT Private Constants
+  * @{
+  */
+#define STDOUT_MAX_XFER_SIZE      0xFFFFU     /*!< Largest DMA transfer, CNDTR is 16-bit */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_STDOUT_Private_Variables BSP STDOUT Private Variables
+  * @{
+  */
+static BSP_STDOUT_TypeDef BSP_Stdout;
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_STDOUT_Private_Functions
+  * @{
+  */
+static void     STDOUT_Add(__IO uint32_t *pCounter, uint32_t Value);
+static uint32_t STDOUT_Reserve(uint32_t Length, uint32_t *pStart);
+static void     STDOUT_Commit(void);
+static void     STDOUT_Discard(uint32_t Length);
+static void     STDOUT_Kick(void);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_STDOUT_Exported_Functions BSP STDOUT Exported Functions
+  * @{
+  */
+
+/** @defgroup BSP_STDOUT_Exported_Functions_Group1 Initialization and output functions
+  * @brief    Initialization and output functions
+  *
+@verbatim
+ ===============================================================================
+                ##### Initialization and output functions #####
+ ===============================================================================
+    [..]
+    This section provides functions allowing to:
+      (+) Initialize the buffered stdout
+      (+) Queue data for transmission
+      (+) Flush the queue by polling
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize the buffered stdout.
+  * @param  huart Pointer to a UART_HandleTypeDef structure, its hdmatx must be linked.
+  * @param  pBuffer Pointer to the queue storage.
+  * @param  Size Size of the queue in bytes, a power of two.
+  * @param  Policy Overflow policy, a value of @ref BSP_STDOUT_Policy.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_STDOUT_Init(UART_HandleTypeDef *huart, uint8_t *pBuffer, uint32_t Size, uint32_t Policy)
+{
+  if ((huart == NULL) || (huart->hdmatx == NULL) || (pBuffer == NULL) ||
+      (Size < 2U) || ((Size & (Size - 1U)) != 0U) || (Policy > BSP_STDOUT_POLICY_OVERWRITE))
+  {
+    return HAL_ERROR;
+  }
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  if (HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID, BSP_STDOUT_TxCpltCallback) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+  BSP_Stdout.pBuffer   = NULL;
+  BSP_Stdout.huart     = huart;
+  BSP_Stdout.Size      = Size;
+  BSP_Stdout.Policy    = Policy;
+  BSP_Stdout.Reserved  = 0U;
+  BSP_Stdout.Committed = 0U;
+  BSP_Stdout.Writers   = 0U;
+  BSP_Stdout.Queued    = 0U;
+  BSP_Stdout.Released  = 0U;
+  BSP_Stdout.XferStart = 0U;
+  BSP_Stdout.XferSize  = 0U;
+  BSP_Stdout.Dropped   = 0U;
+
+  /* The queue is used by the writers as soon as pBuffer is set */
+  __DMB();
+  BSP_Stdout.pBuffer   = pBuffer;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue data for transmission.
+  * @note   The function returns as soon as the data is copied into the queue,
+  *         unless the BSP_STDOUT_POLICY_BLOCK policy has to wait for room.
+  * @param  pData Pointer to the data.
+  * @param  Length Number of bytes to send.
+  * @retval Number of bytes queued
+  */
+uint32_t BSP_STDOUT_Write(const uint8_t *pData, uint32_t Length)
+{
+  uint32_t written = 0U;
+  uint32_t remaining;
+  uint32_t length;
+  uint32_t start;
+  uint32_t offset;
+  uint32_t room;
+
+  if (BSP_Stdout.pBuffer == NULL)
+  {
+    return 0U;
+  }
+
+  while (written < Length)
+  {
+    remaining = Length - written;
+
+    if (BSP_Stdout.Policy == BSP_STDOUT_POLICY_OVERWRITE)
+    {
+      room = BSP_Stdout.Size - (BSP_Stdout.Reserved - BSP_Stdout.Released);
+      if (remaining > room)
+      {
+        STDOUT_Discard(remaining - room);
+      }
+    }
+
+    /* Data reserved is only published once all the writers are done */
+    STDOUT_Add(&BSP_Stdout.Writers, 1U);
+    length = STDOUT_Reserve(remaining, &start);
+    if (length != 0U)
+    {
+      offset = start & (BSP_Stdout.Size - 1U);
+      if (length > (BSP_Stdout.Size - offset))
+      {
+        memcpy(&BSP_Stdout.pBuffer[offset], &pData[written], BSP_Stdout.Size - offset);
+        memcpy(BSP_Stdout.pBuffer, &pData[written + BSP_Stdout.Size - offset], length - (BSP_Stdout.Size - offset));
+      }
+      else
+      {
+        memcpy(&BSP_Stdout.pBuffer[offset], &pData[written], length);
+      }
+    }
+    STDOUT_Commit();
+    STDOUT_Kick();
+
+    written += length;
+    if ((length < remaining) &&
+        ((BSP_Stdout.Policy != BSP_STDOUT_POLICY_BLOCK) || (__get_IPSR() != 0U) || (__get_PRIMASK() != 0U)))
+    {
+      break;
+    }
+  }
+
+  if (written < Length)
+  {
+    STDOUT_Add(&BSP_Stdout.Dropped, Length - written);
+  }
+
+  return written;
+}
+
+/**
+  * @brief  Send the rest of the queue by polling.
+  * @note   Intended for fault handlers: interrupts are masked during the call and
+  *         neither the UART nor the DMA interrupts nor the SysTick are needed.
+  *         Data still being copied by an interrupted writer is not sent.
+  * @retval None
+  */
+void BSP_STDOUT_Flush(void)
+{
+  UART_HandleTypeDef *huart = BSP_Stdout.huart;
+  uint32_t primask_bit;
+  uint32_t sent;
+
+  if (BSP_Stdout.pBuffer == NULL)
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  if (BSP_Stdout.XferSize != 0U)
+  {
+    /* Stop the DMA and resend what it did not send yet */
+    sent = BSP_Stdout.XferSize - __HAL_DMA_GET_COUNTER(huart->hdmatx);
+    (void)HAL_UART_AbortTransmit(huart);
+    if (BSP_Stdout.Queued == (BSP_Stdout.XferStart + BSP_Stdout.XferSize))
+    {
+      BSP_Stdout.Queued = BSP_Stdout.XferStart + sent;
+    }
+    BSP_Stdout.XferSize = 0U;
+  }
+
+  while (BSP_Stdout.Queued != BSP_Stdout.Committed)
+  {
+    while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TXE) == RESET)
+    {
+    }
+    huart->Instance->DR = BSP_Stdout.pBuffer[BSP_Stdout.Queued & (BSP_Stdout.Size - 1U)];
+    BSP_Stdout.Queued++;
+  }
+  while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TC) == RESET)
+  {
+  }
+  BSP_Stdout.Released = BSP_Stdout.Queued;
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Return the number of bytes lost on overflow since BSP_STDOUT_Init().
+  * @retval Number of bytes
+  */
+uint32_t BSP_STDOUT_GetDropped(void)
+{
+  return BSP_Stdout.Dropped;
+}
+
+/**
+  * @brief  UART transmit complete handler of the buffered stdout.
+  * @note   To be called from HAL_UART_TxCpltCallback() when
+  *         USE_HAL_UART_REGISTER_CALLBACKS is 0. Other UARTs are ignored.
+  * @param  huart Pointer to a UART_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_STDOUT_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  uint32_t primask_bit;
+
+  if ((huart != BSP_Stdout.huart) || (BSP_Stdout.pBuffer == NULL))
+  {
+    return;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  /* Bytes before Queued are sent or discarded */
+  BSP_Stdout.Released = BSP_Stdout.Queued;
+  BSP_Stdout.XferSize = 0U;
+
+  __set_PRIMASK(primask_bit);
+
+  STDOUT_Kick();
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_STDOUT_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Atomically add a value to a counter.
+  * @param  pCounter Pointer to the counter.
+  * @param  Value Value to add, modulo 2^32.
+  * @retval None
+  */
+static void STDOUT_Add(__IO uint32_t *pCounter, uint32_t Value)
+{
+  uint32_t counter;
+
+  do
+  {
+    counter = __LDREXW(pCounter) + Value;
+  } while (__STREXW(counter, pCounter) != 0U);
+}
+
+/**
+  * @brief  Reserve room in the queue.
+  * @param  Length Number of bytes wanted.
+  * @param  pStart Returns the counter value of the first reserved byte.
+  * @retval Number of bytes reserved, limited by the room available
+  */
+static uint32_t STDOUT_Reserve(uint32_t Length, uint32_t *pStart)
+{
+  uint32_t reserved;
+  uint32_t length;
+  uint32_t room;
+
+  do
+  {
+    reserved = __LDREXW(&BSP_Stdout.Reserved);
+    room = BSP_Stdout.Size - (reserved - BSP_Stdout.Released);
+    length = (Length > room) ? room : Length;
+  } while (__STREXW(reserved + length, &BSP_Stdout.Reserved) != 0U);
+
+  *pStart = reserved;
+
+  return length;
+}
+
+/**
+  * @brief  Leave the writer section and publish the reserved data.
+  * @note   Writers preempting each other complete in reverse order, so the last
+  *         writer to leave is the outermost one and all the data reserved at that
+  *         time has been copied. Only this writer publishes it.
+  * @retval None
+  */
+static void STDOUT_Commit(void)
+{
+  uint32_t writers;
+  uint32_t reserved;
+
+  do
+  {
+    writers = __LDREXW(&BSP_Stdout.Writers) - 1U;
+  } while (__STREXW(writers, &BSP_Stdout.Writers) != 0U);
+
+  if (writers == 0U)
+  {
+    /* A writer preempting this loop clears the exclusive monitor, Reserved is then read again */
+    do
+    {
+      (void)__LDREXW(&BSP_Stdout.Committed);
+      reserved = BSP_Stdout.Reserved;
+    } while (__STREXW(reserved, &BSP_Stdout.Committed) != 0U);
+  }
+}
+
+/**
+  * @brief  Discard the oldest bytes not yet handed to the DMA.
+  * @note   When a DMA transfer is in progress the room is only given back to the
+  *         writers at its completion.
+  * @param  Length Number of bytes to discard.
+  * @retval None
+  */
+static void STDOUT_Discard(uint32_t Length)
+{
+  uint32_t primask_bit;
+  uint32_t pending;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  pending = BSP_Stdout.Committed - BSP_Stdout.Queued;
+  if (Length > pending)
+  {
+    Length = pending;
+  }
+  BSP_Stdout.Queued += Length;
+  if (BSP_Stdout.XferSize == 0U)
+  {
+    BSP_Stdout.Released = BSP_Stdout.Queued;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  STDOUT_Add(&BSP_Stdout.Dropped, Length);
+}
+
+/**
+  * @brief  Start a DMA transfer of the published data when the DMA is idle.
+  * @note   The transfer takes the largest contiguous chunk, up to the end of the buffer.
+  * @retval None
+  */
+static void STDOUT_Kick(void)
+{
+  uint32_t primask_bit;
+  uint32_t offset;
+  uint32_t length;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  length = BSP_Stdout.Committed - BSP_Stdout.Queued;
+  if ((BSP_Stdout.XferSize == 0U) && (length != 0U))
+  {
+    offset = BSP_Stdout.Queued & (BSP_Stdout.Size - 1U);
+    if (length > (BSP_Stdout.Size - offset))
+    {
+      length = BSP_Stdout.Size - offset;
+    }
+    if (length > STDOUT_MAX_XFER_SIZE)
+    {
+      length = STDOUT_MAX_XFER_SIZE;
+    }
+
+    BSP_Stdout.XferStart = BSP_Stdout.Queued;
+    BSP_Stdout.XferSize  = length;
+    BSP_Stdout.Queued   += length;
+
+    if (HAL_UART_Transmit_DMA(BSP_Stdout.huart, &BSP_Stdout.pBuffer[offset], (uint16_t)length) != HAL_OK)
+    {
+      /* UART busy with another transmission, retried on the next write */
+      BSP_Stdout.Queued   = BSP_Stdout.XferStart;
+      BSP_Stdout.XferSize = 0U;
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+#if defined (__GNUC__) && !defined (__clang__)
+
+extern int __io_putchar(int ch);
+
+/**
+  * @brief  Newlib write hook queuing stdout and stderr to the buffered stdout.
+  * @note   Overrides the weak _write() of system_gcc_io_fix.c.
+  * @param  file File descriptor.
+  * @param  ptr Pointer to the data.
+  * @param  len Number of bytes.
+  * @retval Number of bytes written
+  */
+int _write(int file, char *ptr, int len)
+{
+  int DataIdx;
+
+  if ((BSP_Stdout.pBuffer != NULL) && ((file == STDOUT_FILENO) || (file == STDERR_FILENO)))
+  {
+    /* Bytes dropped on overflow are reported as written, as a UART would lose them */
+    (void)BSP_STDOUT_Write((const uint8_t *)ptr, (uint32_t)len);
+    return len;
+  }
+
+  for (DataIdx = 0; DataIdx < len; DataIdx++)
+  {
+    __io_putchar(*ptr++);
+  }
+  return len;
+}
+#endif
+
+#endif /* HAL_UART_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
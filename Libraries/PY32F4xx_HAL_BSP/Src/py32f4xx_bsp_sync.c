@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_sync.c
+  * @author  MCU Application Team
+  * @brief   Interrupt to main loop synchronization BSP service.
+  *          This file provides lock-free primitives to hand data and events
+  *          from the handlers and the HAL callbacks to the main loop:
+  *           + Single producer, single consumer ring of fixed size items
+  *           + Multiple producers, single consumer queue, slots taken with
+  *             LDREX/STREX
+  *           + Event flag groups, the waiter sleeping in WFE
+  *           + Sequence locks, consistent snapshots of data an interrupt
+  *             updates
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) None of the primitives masks the interrupts: a handler of any
+       priority, the zero-latency tier of HAL_CRITICAL_PRIORITY included, is
+       never delayed by the main loop using them. The objects and their
+       buffers are the application's, static or global.
+
+   (#) BSP_SYNC_RingInit() sets a ring over Count items of ItemSize bytes,
+       Count a power of 2. One producer, a handler for instance, calls
+       BSP_SYNC_RingPut(), one consumer, the main loop, BSP_SYNC_RingGet():
+       each side only writes its own index and keeps a copy of the other one,
+       read again only when the ring looks full or empty. HAL_BUSY means full
+       for a put, empty for a get. BSP_SYNC_RingCount() gives the items
+       waiting.
+
+   (#) BSP_SYNC_QueueInit() sets a queue over a uint32_t buffer of
+       BSP_SYNC_QUEUE_WORDS(ItemSize, Count) words, for producers of several
+       priorities, handlers and main loop together. BSP_SYNC_QueuePut() takes
+       a slot with LDREX/STREX, writes the item and marks it with its
+       sequence word; it returns HAL_BUSY and counts an overrun when the
+       queue is full. The single consumer gets the items in the order the
+       slots were taken with BSP_SYNC_QueueGet(), HAL_BUSY when empty or when
+       the next item is still written by a producer it preempted.
+
+   (#) An event flag group is a word of up to 32 flags, zeroed for none set.
+       BSP_SYNC_EventSet() sets flags from a handler or a callback and sends
+       an event, BSP_SYNC_EventTake() takes the flags of a mask at once,
+       BSP_SYNC_EventWait() sleeps in WFE until they are set or the Timeout
+       in ms expires: the interrupt setting them wakes the core, the SysTick
+       times out. The flags taken are cleared, each set is seen once.
+       BSP_SYNC_WAIT_ALL waits for all the flags of the mask, the others
+       staying set until then.
+
+   (#) A sequence lock gives the main loop a consistent copy of data a single
+       writer of higher priority updates, a handler filling a structure of
+       measurements for instance: the writer calls BSP_SYNC_SeqWriteBegin()
+       and BSP_SYNC_SeqWriteEnd() around the update, the reader
+       BSP_SYNC_SeqRead() which copies the data again until no update ran
+       during the copy. The writer never waits; a reader of higher priority
+       than the writer would spin forever and must not use it.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_sync.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_SYNC BSP SYNC
+  * @brief Interrupt to main loop synchronization BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_SYNC_Private_Macros BSP SYNC Private Macros
+  * @{
+  */
+#define SYNC_IS_POWER_OF_2(__N__)       (((__N__) != 0U) && (((__N__) & ((__N__) - 1U)) == 0U))
+#define SYNC_SLOT(__QUEUE__, __POS__)   (&(__QUEUE__)->pBuffer[((__POS__) & (__QUEUE__)->Mask) * (__QUEUE__)->SlotWords])
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_SYNC_Exported_Functions BSP SYNC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a single producer, single consumer ring.
+  * @param  pRing Ring.
+  * @param  pBuffer Count * ItemSize bytes.
+  * @param  ItemSize Bytes of an item.
+  * @param  Count Items, a power of 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SYNC_RingInit(BSP_SYNC_RingTypeDef *pRing, void *pBuffer, uint32_t ItemSize, uint32_t Count)
+{
+  if ((pRing == NULL) || (pBuffer == NULL) || (ItemSize == 0U) || !SYNC_IS_POWER_OF_2(Count))
+  {
+    return HAL_ERROR;
+  }
+
+  pRing->pBuffer   = (uint8_t *)pBuffer;
+  pRing->ItemSize  = ItemSize;
+  pRing->Mask      = Count - 1U;
+  pRing->Head      = 0U;
+  pRing->Tail      = 0U;
+  pRing->TailCache = 0U;
+  pRing->HeadCache = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Put an item into a ring, by its producer.
+  * @param  pRing Ring.
+  * @param  pItem Item, ItemSize bytes.
+  * @retval HAL_OK, HAL_BUSY when full
+  */
+HAL_StatusTypeDef BSP_SYNC_RingPut(BSP_SYNC_RingTypeDef *pRing, const void *pItem)
+{
+  uint32_t head = pRing->Head;
+
+  if ((head - pRing->TailCache) > pRing->Mask)
+  {
+    pRing->TailCache = pRing->Tail;
+    if ((head - pRing->TailCache) > pRing->Mask)
+    {
+      return HAL_BUSY;
+    }
+  }
+
+  memcpy(&pRing->pBuffer[(head & pRing->Mask) * pRing->ItemSize], pItem, pRing->ItemSize);
+
+  /* The item written before the consumer sees it */
+  __DMB();
+  pRing->Head = head + 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get an item from a ring, by its consumer.
+  * @param  pRing Ring.
+  * @param  pItem Item, ItemSize bytes.
+  * @retval HAL_OK, HAL_BUSY when empty
+  */
+HAL_StatusTypeDef BSP_SYNC_RingGet(BSP_SYNC_RingTypeDef *pRing, void *pItem)
+{
+  uint32_t tail = pRing->Tail;
+
+  if (tail == pRing->HeadCache)
+  {
+    pRing->HeadCache = pRing->Head;
+    if (tail == pRing->HeadCache)
+    {
+      return HAL_BUSY;
+    }
+  }
+
+  __DMB();
+  memcpy(pItem, &pRing->pBuffer[(tail & pRing->Mask) * pRing->ItemSize], pRing->ItemSize);
+
+  /* The item read before the producer writes the slot again */
+  __DMB();
+  pRing->Tail = tail + 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Items waiting in a ring.
+  * @param  pRing Ring.
+  * @retval Items put and not got yet
+  */
+uint32_t BSP_SYNC_RingCount(const BSP_SYNC_RingTypeDef *pRing)
+{
+  return pRing->Head - pRing->Tail;
+}
+
+/**
+  * @brief  Initialize a multiple producers, single consumer queue.
+  * @param  pQueue Queue.
+  * @param  pBuffer BSP_SYNC_QUEUE_WORDS(ItemSize, Count) words.
+  * @param  ItemSize Bytes of an item.
+  * @param  Count Items, a power of 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_SYNC_QueueInit(BSP_SYNC_QueueTypeDef *pQueue, uint32_t *pBuffer, uint32_t ItemSize, uint32_t Count)
+{
+  uint32_t pos;
+
+  if ((pQueue == NULL) || (pBuffer == NULL) || (ItemSize == 0U) || !SYNC_IS_POWER_OF_2(Count))
+  {
+    return HAL_ERROR;
+  }
+
+  pQueue->pBuffer   = pBuffer;
+  pQueue->ItemSize  = ItemSize;
+  pQueue->SlotWords = 1U + ((ItemSize + 3U) / 4U);
+  pQueue->Mask      = Count - 1U;
+  pQueue->Head      = 0U;
+  pQueue->Tail      = 0U;
+  pQueue->Overruns  = 0U;
+
+  /* A slot is free when its sequence is the position of the next put into it */
+  for (pos = 0U; pos < Count; pos++)
+  {
+    SYNC_SLOT(pQueue, pos)[0] = pos;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Put an item into a queue, from any priority.
+  * @param  pQueue Queue.
+  * @param  pItem Item, ItemSize bytes.
+  * @retval HAL_OK, HAL_BUSY when full
+  */
+HAL_StatusTypeDef BSP_SYNC_QueuePut(BSP_SYNC_QueueTypeDef *pQueue, const void *pItem)
+{
+  uint32_t *slot;
+  uint32_t pos;
+
+  /* An exception between the LDREX and the STREX fails the STREX: the slot
+     is free when its sequence is the position, its item not got otherwise */
+  do
+  {
+    pos = __LDREXW(&pQueue->Head);
+    if (SYNC_SLOT(pQueue, pos)[0] != pos)
+    {
+      __CLREX();
+      (void)HAL_AtomicAdd(&pQueue->Overruns, 1U);
+      return HAL_BUSY;
+    }
+  } while (__STREXW(pos + 1U, &pQueue->Head) != 0U);
+
+  slot = SYNC_SLOT(pQueue, pos);
+  memcpy(&slot[1], pItem, pQueue->ItemSize);
+  __DMB();
+  ((__IO uint32_t *)slot)[0] = pos + 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get an item from a queue, by its single consumer.
+  * @param  pQueue Queue.
+  * @param  pItem Item, ItemSize bytes.
+  * @retval HAL_OK, HAL_BUSY when empty or the next item not written yet
+  */
+HAL_StatusTypeDef BSP_SYNC_QueueGet(BSP_SYNC_QueueTypeDef *pQueue, void *pItem)
+{
+  uint32_t *slot;
+  uint32_t pos = pQueue->Tail;
+
+  slot = SYNC_SLOT(pQueue, pos);
+  if (((__IO uint32_t *)slot)[0] != (pos + 1U))
+  {
+    /* Empty, or the slot still written by a put preempted */
+    return HAL_BUSY;
+  }
+
+  __DMB();
+  memcpy(pItem, &slot[1], pQueue->ItemSize);
+  __DMB();
+
+  /* Free for the put one round later */
+  ((__IO uint32_t *)slot)[0] = pos + pQueue->Mask + 1U;
+  pQueue->Tail = pos + 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set flags of an event group and wake a waiter.
+  * @param  pEvent Event flag group.
+  * @param  Flags Flags to set.
+  * @retval None
+  */
+void BSP_SYNC_EventSet(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags)
+{
+  (void)HAL_AtomicSetBits(&pEvent->Flags, Flags);
+
+  /* The event register set, a WFE about to run returns at once */
+  __DSB();
+  __SEV();
+}
+
+/**
+  * @brief  Take flags of an event group, clearing them.
+  * @param  pEvent Event flag group.
+  * @param  Flags Flags taken.
+  * @param  Mode BSP_SYNC_WAIT_ANY or BSP_SYNC_WAIT_ALL.
+  * @retval Flags taken, 0 when none, or not all with BSP_SYNC_WAIT_ALL
+  */
+uint32_t BSP_SYNC_EventTake(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags, uint32_t Mode)
+{
+  uint32_t value;
+  uint32_t taken;
+
+  do
+  {
+    value = __LDREXW(&pEvent->Flags);
+    taken = value & Flags;
+    if ((taken == 0U) || ((Mode == BSP_SYNC_WAIT_ALL) && (taken != Flags)))
+    {
+      __CLREX();
+      return 0U;
+    }
+  } while (__STREXW(value & ~taken, &pEvent->Flags) != 0U);
+
+  return taken;
+}
+
+/**
+  * @brief  Wait for flags of an event group in WFE, clearing them.
+  * @param  pEvent Event flag group.
+  * @param  Flags Flags waited for.
+  * @param  Mode BSP_SYNC_WAIT_ANY or BSP_SYNC_WAIT_ALL.
+  * @param  Timeout Timeout in ms, 0 for a poll, HAL_MAX_DELAY for none.
+  * @retval Flags taken, 0 on the timeout
+  */
+uint32_t BSP_SYNC_EventWait(BSP_SYNC_EventTypeDef *pEvent, uint32_t Flags, uint32_t Mode, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t taken;
+
+  while ((taken = BSP_SYNC_EventTake(pEvent, Flags, Mode)) == 0U)
+  {
+    if ((Timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) >= Timeout))
+    {
+      break;
+    }
+    __WFE();
+  }
+
+  return taken;
+}
+
+/**
+  * @brief  Start an update of the data of a sequence lock, by its writer.
+  * @param  pSeq Sequence lock.
+  * @retval None
+  */
+void BSP_SYNC_SeqWriteBegin(BSP_SYNC_SeqTypeDef *pSeq)
+{
+  pSeq->Sequence = pSeq->Sequence + 1U;
+  __DMB();
+}
+
+/**
+  * @brief  End an update of the data of a sequence lock, by its writer.
+  * @param  pSeq Sequence lock.
+  * @retval None
+  */
+void BSP_SYNC_SeqWriteEnd(BSP_SYNC_SeqTypeDef *pSeq)
+{
+  __DMB();
+  pSeq->Sequence = pSeq->Sequence + 1U;
+}
+
+/**
+  * @brief  Copy the data of a sequence lock, again until no update ran during the copy.
+  * @param  pSeq Sequence lock.
+  * @param  pDst Copy.
+  * @param  pSrc Data updated by the writer.
+  * @param  Size Bytes of the data.
+  * @retval None
+  */
+void BSP_SYNC_SeqRead(const BSP_SYNC_SeqTypeDef *pSeq, void *pDst, const volatile void *pSrc, uint32_t Size)
+{
+  uint32_t sequence;
+
+  do
+  {
+    sequence = pSeq->Sequence;
+    __DMB();
+    memcpy(pDst, (const void *)pSrc, Size);
+    __DMB();
+  } while (((sequence & 1U) != 0U) || (pSeq->Sequence != sequence));
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,401 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_task.c
+  * @author  MCU Application Team
+  * @brief   Cooperative task BSP service.
+  *          This file provides stackless tasks chaining the asynchronous
+  *          operations of the HAL without an RTOS:
+  *           + Tasks of a few words, resumed at their last wait
+  *           + Waits on a condition, a delay, a child task
+  *           + Awaits of the _IT and _DMA functions of SPI, I2C, UART, DMA
+  *             and FLASH
+  *           + Run to completion scheduler, sleeping while all tasks wait
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A task is a BSP_TASK_TypeDef and a function of the task returning a
+       value of @ref BSP_TASK_Result. Its body is written between
+       BSP_TASK_BEGIN() and BSP_TASK_END(), in sequence, and waits with the
+       BSP_TASK_WAIT_UNTIL(), BSP_TASK_DELAY(), BSP_TASK_AWAIT_xxx() and
+       BSP_TASK_SPAWN() macros: the task returns there and resumes there on
+       its next run, the macros being the cases of a switch on the line.
+       The task has no stack of its own, hence:
+       (++) the locals of the body are lost on a wait, keep the state in
+            the structure given by pArg or in static variables
+       (++) the body has no switch of its own around a wait and one wait
+            per source line, the line being the resume point
+       (++) a wait is only in the body, not in a function it calls: make
+            the function a child task run by BSP_TASK_SPAWN()
+
+   (#) Call BSP_TASK_Init() once, BSP_TASK_Start() for each task, then
+       BSP_TASK_Run(), returning when all the tasks ended. BSP_TASK_RunOnce()
+       runs one pass instead, for a superloop doing other work.
+
+   (#) The waits poll: a waiting task runs its condition again on each pass
+       of the scheduler. A pass where no task yielded calls BSP_TASK_Idle(),
+       sleeping with WFE until the next interrupt: BSP_TASK_Init() sets
+       SEVONPEND, so an interrupt pending between the conditions and the
+       WFE is not missed. The SysTick wakes the core every millisecond for
+       the delays and the timeouts. Override BSP_TASK_Idle() for a deeper
+       mode, the STOP mode of the Tickless service for instance.
+
+   (#) BSP_TASK_AWAIT_SPI(), _I2C(), _UART_TX(), _UART_RX(), _DMA() and
+       _FLASH() start a HAL _IT or _DMA operation and wait for the state of
+       the handle to be ready again. The HAL callbacks are not used and stay
+       free for the application. While the call returns HAL_BUSY, the
+       peripheral working for another task, the call is retried: the tasks
+       share a bus in turn. Status then holds the result, HAL_ERROR with the
+       ErrorCode of the handle set, HAL_TIMEOUT with the operation still
+       running, to abort.
+
+   (#) A BSP_SYNC event, ring or queue filled by an interrupt is waited on
+       with BSP_TASK_WAIT_UNTIL(), BSP_SYNC_EventTake() as the condition
+       for instance. The tasks run in thread mode only, never from an
+       interrupt.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_task.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TASK BSP TASK
+  * @brief Cooperative task BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_TASK_Private_Variables BSP TASK Private Variables
+  * @{
+  */
+static BSP_TASK_TypeDef *TaskList;    /* Tasks started, in the order of their start */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TASK_Exported_Functions BSP TASK Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Empty the run list and let a pending interrupt wake the WFE of the idle.
+  * @retval None
+  */
+void BSP_TASK_Init(void)
+{
+  TaskList = NULL;
+  SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+}
+
+/**
+  * @brief  Add a task at the end of the run list, its body run from its start.
+  * @param  pTask Pointer to the task.
+  * @param  Func Body of the task.
+  * @param  pArg Argument of the body.
+  * @retval HAL_OK, HAL_ERROR on a wrong parameter, HAL_BUSY if the task runs already
+  */
+HAL_StatusTypeDef BSP_TASK_Start(BSP_TASK_TypeDef *pTask, BSP_TASK_FuncTypeDef Func, void *pArg)
+{
+  BSP_TASK_TypeDef **ppLink;
+
+  if ((pTask == NULL) || (Func == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (BSP_TASK_IsRunning(pTask) != 0U)
+  {
+    return HAL_BUSY;
+  }
+
+  pTask->Func   = Func;
+  pTask->pArg   = pArg;
+  pTask->Line   = 0U;
+  pTask->Start  = 0U;
+  pTask->Status = HAL_OK;
+  pTask->pNext  = NULL;
+  for (ppLink = &TaskList; *ppLink != NULL; ppLink = &(*ppLink)->pNext)
+  {
+  }
+  *ppLink = pTask;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Remove a task from the run list, an operation it awaits going on.
+  * @param  pTask Pointer to the task.
+  * @retval HAL_OK, HAL_ERROR if the task does not run
+  */
+HAL_StatusTypeDef BSP_TASK_Stop(BSP_TASK_TypeDef *pTask)
+{
+  BSP_TASK_TypeDef **ppLink;
+
+  for (ppLink = &TaskList; *ppLink != NULL; ppLink = &(*ppLink)->pNext)
+  {
+    if (*ppLink == pTask)
+    {
+      *ppLink = pTask->pNext;
+      pTask->pNext = NULL;
+      return HAL_OK;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @brief  Tell whether a task is in the run list.
+  * @param  pTask Pointer to the task.
+  * @retval 1 if the task runs, 0 otherwise
+  */
+uint32_t BSP_TASK_IsRunning(const BSP_TASK_TypeDef *pTask)
+{
+  const BSP_TASK_TypeDef *task;
+
+  for (task = TaskList; task != NULL; task = task->pNext)
+  {
+    if (task == pTask)
+    {
+      return 1U;
+    }
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Run each task of the run list once, removing the ended ones.
+  * @retval Tasks yielded, ready to run again without a wake-up
+  */
+uint32_t BSP_TASK_RunOnce(void)
+{
+  BSP_TASK_TypeDef **ppLink = &TaskList;
+  BSP_TASK_TypeDef *task;
+  uint32_t ready = 0U;
+
+  while (*ppLink != NULL)
+  {
+    task = *ppLink;
+    switch (task->Func(task))
+    {
+      case BSP_TASK_YIELDED:
+        ready++;
+        break;
+
+      case BSP_TASK_ENDED:
+        if (*ppLink == task)
+        {
+          *ppLink = task->pNext;
+          task->pNext = NULL;
+          continue;
+        }
+        break;
+
+      default:
+        break;
+    }
+    /* The body may have stopped itself */
+    if (*ppLink == task)
+    {
+      ppLink = &task->pNext;
+    }
+  }
+
+  return ready;
+}
+
+/**
+  * @brief  Run the tasks until they all ended, in BSP_TASK_Idle() while they all wait.
+  * @retval None
+  */
+void BSP_TASK_Run(void)
+{
+  while (TaskList != NULL)
+  {
+    if (BSP_TASK_RunOnce() == 0U)
+    {
+      BSP_TASK_Idle();
+    }
+  }
+}
+
+/**
+  * @brief  Sleep until the next interrupt, all the tasks waiting.
+  * @note   An interrupt pending since the last pass sets the event register,
+  *         the WFE then returns at once.
+  * @retval None
+  */
+__weak void BSP_TASK_Idle(void)
+{
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TASK_Idle could be implemented in the user file
+   */
+  __WFE();
+}
+
+/**
+  * @brief  Tell whether the current wait of a task timed out, setting Status then.
+  * @param  pTask Pointer to the task.
+  * @param  Timeout Milliseconds from Start, HAL_MAX_DELAY for none.
+  * @retval 1 on the timeout, 0 otherwise
+  */
+uint32_t BSP_TASK_Expired(BSP_TASK_TypeDef *pTask, uint32_t Timeout)
+{
+  if ((Timeout == HAL_MAX_DELAY) || ((HAL_GetTick() - pTask->Start) < Timeout))
+  {
+    return 0U;
+  }
+
+  pTask->Status = HAL_TIMEOUT;
+  return 1U;
+}
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief  End of a SPI operation, for BSP_TASK_AWAIT_SPI().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @param  hspi Pointer to the SPI handle.
+  * @retval 1 once the handle is ready, 0 otherwise
+  */
+uint32_t BSP_TASK_SpiDone(BSP_TASK_TypeDef *pTask, SPI_HandleTypeDef *hspi)
+{
+  if (HAL_SPI_GetState(hspi) != HAL_SPI_STATE_READY)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_SPI_GetError(hspi) == HAL_SPI_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+#endif /* HAL_SPI_MODULE_ENABLED */
+
+#if defined(HAL_I2C_MODULE_ENABLED)
+/**
+  * @brief  End of an I2C operation, for BSP_TASK_AWAIT_I2C().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @param  hi2c Pointer to the I2C handle.
+  * @retval 1 once the handle is ready, 0 otherwise
+  */
+uint32_t BSP_TASK_I2cDone(BSP_TASK_TypeDef *pTask, I2C_HandleTypeDef *hi2c)
+{
+  if (HAL_I2C_GetState(hi2c) != HAL_I2C_STATE_READY)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_I2C_GetError(hi2c) == HAL_I2C_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+#if defined(HAL_UART_MODULE_ENABLED)
+/**
+  * @brief  End of a UART transmission, for BSP_TASK_AWAIT_UART_TX().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @param  huart Pointer to the UART handle.
+  * @retval 1 once the transmission ended, 0 otherwise
+  */
+uint32_t BSP_TASK_UartTxDone(BSP_TASK_TypeDef *pTask, UART_HandleTypeDef *huart)
+{
+  /* gState only, a reception may go on */
+  if (huart->gState != HAL_UART_STATE_READY)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_UART_GetError(huart) == HAL_UART_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+
+/**
+  * @brief  End of a UART reception, for BSP_TASK_AWAIT_UART_RX().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @param  huart Pointer to the UART handle.
+  * @retval 1 once the reception ended, 0 otherwise
+  */
+uint32_t BSP_TASK_UartRxDone(BSP_TASK_TypeDef *pTask, UART_HandleTypeDef *huart)
+{
+  if (huart->RxState != HAL_UART_STATE_READY)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_UART_GetError(huart) == HAL_UART_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+#endif /* HAL_UART_MODULE_ENABLED */
+
+#if defined(HAL_DMA_MODULE_ENABLED)
+/**
+  * @brief  End of a DMA transfer, for BSP_TASK_AWAIT_DMA().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @param  hdma Pointer to the DMA handle.
+  * @retval 1 once the handle is ready, 0 otherwise
+  */
+uint32_t BSP_TASK_DmaDone(BSP_TASK_TypeDef *pTask, DMA_HandleTypeDef *hdma)
+{
+  if (HAL_DMA_GetState(hdma) != HAL_DMA_STATE_READY)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_DMA_GetError(hdma) == HAL_DMA_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+#endif /* HAL_DMA_MODULE_ENABLED */
+
+#if defined(HAL_FLASH_MODULE_ENABLED)
+/**
+  * @brief  End of a FLASH program or erase, for BSP_TASK_AWAIT_FLASH().
+  * @param  pTask Pointer to the task, Status set to HAL_ERROR on an error.
+  * @retval 1 once no procedure goes on, 0 otherwise
+  */
+uint32_t BSP_TASK_FlashDone(BSP_TASK_TypeDef *pTask)
+{
+  if (pFlash.ProcedureOnGoing != FLASH_TYPENONE)
+  {
+    return 0U;
+  }
+
+  pTask->Status = (HAL_FLASH_GetError() == HAL_FLASH_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+  return 1U;
+}
+#endif /* HAL_FLASH_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
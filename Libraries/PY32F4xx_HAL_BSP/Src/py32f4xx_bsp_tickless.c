@@ -0,0 +1,513 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_tickless.c
+  * @author  MCU Application Team
+  * @brief   Tickless idle BSP service.
+  *          This file provides functions to idle without the 1 ms tick:
+  *           + Idle time from the caller and the timer wheel deadlines
+  *           + SysTick suspended, RTC alarm at the end of the idle time
+  *           + SLEEP or STOP mode, the system clock restored after STOP
+  *           + uwTick and the timer wheel compensated from the RTC
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The 1 ms SysTick of HAL_InitTick() wakes the CPU a thousand times a
+       second. This service suspends it while the application has nothing
+       to do and measures the idle time with the RTC, the only counter
+       running in STOP mode, to give it back to uwTick on the wakeup.
+
+   (#) Enable the backup domain access, clock the RTC from the LSE, or the
+       LSI when 1 % is enough, and initialize it with HAL_RTC_Init(). The
+       alarm wakes the CPU at the end of the idle time with the resolution
+       of the RTC counter: an AsynchPrediv of 31 counts at 1024 Hz from
+       the LSE. The counter is then no calendar, HAL_RTC_SetTime() and
+       HAL_RTC_SetAlarm() are not to be used. The idle time is measured
+       with the RTC divider, to one RTC clock cycle.
+
+   (#) Call BSP_TICKLESS_Init() with the RTC clock frequency. It enables the
+       RTC alarm on EXTI line 17: enable RTC_Alarm_IRQn in the NVIC, its
+       handler calls BSP_TICKLESS_IRQHandler(). With the software timer
+       wheel, BSP_TICKLESS_AttachWheel() with its tick frequency makes the
+       next expiry a deadline of the idle time.
+
+   (#) In the main loop, disable the interrupts, check there is no work
+       left, then call BSP_TICKLESS_Idle() with the longest idle time in ms
+       and enable the interrupts again: an interrupt coming after the check
+       ends the idle at once and runs when the interrupts are enabled.
+       (+) An idle time shorter than 2 RTC counts is a plain SLEEP mode,
+           SysTick running.
+       (+) From BSP_TICKLESS_STOP_MIN ms, and unless BSP_TICKLESS_LockStop()
+           was called, the CPU enters the STOP mode: only EXTI lines wake it,
+           GPIO, RTC alarm or PVD, the peripheral clocks are off. Lock the
+           STOP mode around UART, SPI or DMA transfers and while the TIM of
+           a PWM or a capture is to keep counting.
+       (+) Otherwise the CPU enters the SLEEP mode, SysTick suspended, and
+           any interrupt wakes it.
+       BSP_TICKLESS_SleepCallback() runs before with the mode, to gate pins
+       or peripherals, BSP_TICKLESS_WakeupCallback() after.
+
+   (#) The STOP mode goes through BSP_LPCTX_EnterStop() of the LpCtx
+       member, set up by BSP_TICKLESS_Init() with BSP_LPCTX_StructInit():
+       the clock tree of the entry is restored on the wakeup. Call
+       BSP_LPCTX_Init() on it after BSP_TICKLESS_Init() for other wakeup
+       settings, BSP_LPCTX_GetStats() gives the restore latency.
+
+   (#) The time spent is added to uwTick with the fraction of the SysTick
+       period elapsed at the entry, the remainders carry to the next idle:
+       HAL_GetTick() stays within one RTC clock cycle of the RTC in the
+       long run. After a STOP, the time of the timer wheel is moved forward
+       the same way with BSP_TIMWHEEL_Advance(): the timers keep their
+       expiry in real time. BSP_TICKLESS_Idle() returns the ms given back.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_tickless.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TICKLESS BSP TICKLESS
+  * @brief Tickless idle BSP service
+  * @{
+  */
+
+#if defined (HAL_RTC_MODULE_ENABLED) && defined (HAL_PWR_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TICKLESS_Private_Constants BSP TICKLESS Private Constants
+  * @{
+  */
+#define TICKLESS_COUNTS_MIN             2U             /* Alarm counts, the current one is partial    */
+#define TICKLESS_COUNTS_MAX             0x7FFFFFFFU    /* Longest alarm, in RTC counts                */
+#define TICKLESS_WAIT_LOOPS             0x00100000U    /* Polls of a flag, half a second on HSI       */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TICKLESS_Private_Functions BSP TICKLESS Private Functions
+  * @{
+  */
+static HAL_StatusTypeDef TICKLESS_Wait(__IO uint32_t *pReg, uint32_t Mask, uint32_t Value);
+static void              TICKLESS_ReadTime(const BSP_TICKLESS_TypeDef *htl, uint32_t *pCount, uint32_t *pDiv);
+static HAL_StatusTypeDef TICKLESS_SetAlarm(const BSP_TICKLESS_TypeDef *htl, uint32_t Alarm);
+static void              TICKLESS_ClearAlarm(const BSP_TICKLESS_TypeDef *htl);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TICKLESS_Exported_Functions BSP TICKLESS Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the tickless idle on an initialized RTC.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  hrtc RTC handle, initialized by HAL_RTC_Init().
+  * @param  RtcClock RTC kernel clock in Hz.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TICKLESS_Init(BSP_TICKLESS_TypeDef *htl, RTC_HandleTypeDef *hrtc, uint32_t RtcClock)
+{
+  BSP_LPCTX_InitTypeDef lpctx;
+
+  if ((htl == NULL) || (hrtc == NULL) || (RtcClock == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hrtc->State != HAL_RTC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  htl->hrtc      = hrtc;
+  htl->RtcClock  = RtcClock;
+  htl->Prescaler = (hrtc->Init.AsynchPrediv == RTC_AUTO_1_SECOND) ? RtcClock : (hrtc->Init.AsynchPrediv + 1U);
+#if defined (HAL_TIM_MODULE_ENABLED)
+  htl->hwheel    = NULL;
+  htl->WheelFreq = 0U;
+  htl->WheelRem  = 0U;
+#endif /* HAL_TIM_MODULE_ENABLED */
+  htl->TickRem   = 0U;
+  htl->StopLocks = 0U;
+  htl->Stats.Sleeps   = 0U;
+  htl->Stats.Stops    = 0U;
+  htl->Stats.Short    = 0U;
+  htl->Stats.IdleTime = 0U;
+
+  BSP_LPCTX_StructInit(&lpctx);
+  (void)BSP_LPCTX_Init(&htl->LpCtx, &lpctx);
+
+  /* The alarm wakes from STOP through EXTI line 17, rising edge */
+  TICKLESS_ClearAlarm(htl);
+  __HAL_RTC_ALARM_EXTI_ENABLE_IT();
+  __HAL_RTC_ALARM_EXTI_ENABLE_RISING_EDGE();
+
+  return HAL_OK;
+}
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+/**
+  * @brief  Take the next expiry of a timer wheel as a deadline of the idle time.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  hwheel Timer wheel, NULL to detach it.
+  * @param  WheelFreq Tick of the timer wheel in Hz, its counter clock.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TICKLESS_AttachWheel(BSP_TICKLESS_TypeDef *htl, BSP_TIMWHEEL_TypeDef *hwheel,
+                                           uint32_t WheelFreq)
+{
+  if ((htl == NULL) || ((hwheel != NULL) && (WheelFreq == 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  htl->hwheel    = hwheel;
+  htl->WheelFreq = WheelFreq;
+  htl->WheelRem  = 0U;
+
+  return HAL_OK;
+}
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @brief  Forbid the STOP mode, the calls nest.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @retval None
+  */
+void BSP_TICKLESS_LockStop(BSP_TICKLESS_TypeDef *htl)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  htl->StopLocks++;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Allow the STOP mode again after BSP_TICKLESS_LockStop().
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @retval None
+  */
+void BSP_TICKLESS_UnlockStop(BSP_TICKLESS_TypeDef *htl)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  if (htl->StopLocks != 0U)
+  {
+    htl->StopLocks--;
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Idle up to a time or an interrupt, the tick suspended.
+  * @note   Call with the interrupts disabled once no work is left, the
+  *         interrupts stay as they were on the return.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  MaxIdle Longest idle time in ms, BSP_TICKLESS_IDLE_FOREVER for
+  *         the deadlines only.
+  * @retval Milliseconds added to uwTick
+  */
+uint32_t BSP_TICKLESS_Idle(BSP_TICKLESS_TypeDef *htl, uint32_t MaxIdle)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  uint64_t counts;
+  uint64_t elapsed;
+  uint64_t acc;
+  uint32_t idle = MaxIdle;
+  uint32_t mode;
+  uint32_t count0;
+  uint32_t div0;
+  uint32_t count1;
+  uint32_t div1;
+  uint32_t load;
+  uint32_t val;
+  uint32_t ms;
+#if defined (HAL_TIM_MODULE_ENABLED)
+  uint32_t ticks;
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+  __disable_irq();
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+  if (htl->hwheel != NULL)
+  {
+    ticks = BSP_TIMWHEEL_GetIdleTime(htl->hwheel);
+    if (ticks != BSP_TIMWHEEL_IDLE_FOREVER)
+    {
+      ms = (uint32_t)(((uint64_t)ticks * 1000U) / htl->WheelFreq);
+      idle = (ms < idle) ? ms : idle;
+    }
+  }
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+  /* RTC counts before the deadline, the alarm at the start of the last one */
+  counts = ((uint64_t)idle * htl->RtcClock) / (1000ULL * htl->Prescaler);
+  if ((idle == BSP_TICKLESS_IDLE_FOREVER) || (counts > TICKLESS_COUNTS_MAX))
+  {
+    counts = TICKLESS_COUNTS_MAX;
+  }
+
+  TICKLESS_ReadTime(htl, &count0, &div0);
+  if ((counts < TICKLESS_COUNTS_MIN) || (TICKLESS_SetAlarm(htl, count0 + (uint32_t)counts) != HAL_OK))
+  {
+    htl->Stats.Short++;
+    HAL_PWR_EnterSLEEPMode(PWR_SLEEPENTRY_WFI);
+    __set_PRIMASK(primask_bit);
+    return 0U;
+  }
+  __HAL_RTC_ALARM_ENABLE_IT(htl->hrtc, RTC_IT_ALRA);
+
+  mode = ((htl->StopLocks == 0U) && (idle >= BSP_TICKLESS_STOP_MIN)) ? BSP_TICKLESS_MODE_STOP :
+         BSP_TICKLESS_MODE_SLEEP;
+
+  /* SysTick stopped with the part of its period elapsed */
+  load = SysTick->LOAD;
+  val  = SysTick->VAL;
+  HAL_SuspendTick();
+  CLEAR_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+  TICKLESS_ReadTime(htl, &count0, &div0);
+
+  BSP_TICKLESS_SleepCallback(htl, mode);
+
+  if (mode == BSP_TICKLESS_MODE_STOP)
+  {
+    (void)BSP_LPCTX_EnterStop(&htl->LpCtx);
+
+    /* The RTC registers read again once resynchronized */
+    CLEAR_BIT(htl->hrtc->Instance->CRL, RTC_CRL_RSF);
+    (void)TICKLESS_Wait(&htl->hrtc->Instance->CRL, RTC_CRL_RSF, RTC_CRL_RSF);
+    htl->Stats.Stops++;
+  }
+  else
+  {
+    HAL_PWR_EnterSLEEPMode(PWR_SLEEPENTRY_WFI);
+    htl->Stats.Sleeps++;
+  }
+
+  TICKLESS_ReadTime(htl, &count1, &div1);
+  __HAL_RTC_ALARM_DISABLE_IT(htl->hrtc, RTC_IT_ALRA);
+  TICKLESS_ClearAlarm(htl);
+
+  /* RTC clock cycles, the divider counts down */
+  elapsed = ((uint64_t)(count1 - count0) * htl->Prescaler) + div0 - div1;
+
+  acc = (elapsed * 1000U) + htl->TickRem +
+        ((((uint64_t)(load - val) * (uint32_t)uwTickFreq) * htl->RtcClock) / ((uint64_t)load + 1U));
+  ms = (uint32_t)(acc / htl->RtcClock);
+  htl->TickRem = (uint32_t)(acc % htl->RtcClock);
+  uwTick += ms;
+  htl->Stats.IdleTime += ms;
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+  if ((mode == BSP_TICKLESS_MODE_STOP) && (htl->hwheel != NULL))
+  {
+    acc = (elapsed * htl->WheelFreq) + htl->WheelRem;
+    htl->WheelRem = (uint32_t)(acc % htl->RtcClock);
+    (void)BSP_TIMWHEEL_Advance(htl->hwheel, (uint32_t)(acc / htl->RtcClock));
+  }
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+  /* A whole period up to the next tick, the part of the last one is in TickRem */
+  SysTick->VAL = 0U;
+  SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+  HAL_ResumeTick();
+
+  BSP_TICKLESS_WakeupCallback(htl, mode);
+
+  __set_PRIMASK(primask_bit);
+
+  return ms;
+}
+
+/**
+  * @brief  Get the statistics.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_TICKLESS_GetStats(const BSP_TICKLESS_TypeDef *htl, BSP_TICKLESS_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  *pStats = htl->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  RTC alarm interrupt, an alarm left over by an idle.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @retval None
+  */
+void BSP_TICKLESS_IRQHandler(BSP_TICKLESS_TypeDef *htl)
+{
+  __HAL_RTC_ALARM_DISABLE_IT(htl->hrtc, RTC_IT_ALRA);
+  TICKLESS_ClearAlarm(htl);
+}
+
+/**
+  * @brief  Idle entry callback, interrupts disabled.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  Mode A value of @ref BSP_TICKLESS_Mode.
+  * @retval None
+  */
+__weak void BSP_TICKLESS_SleepCallback(BSP_TICKLESS_TypeDef *htl, uint32_t Mode)
+{
+  UNUSED(htl);
+  UNUSED(Mode);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TICKLESS_SleepCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Idle exit callback, interrupts disabled, clock and tick restored.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  Mode A value of @ref BSP_TICKLESS_Mode.
+  * @retval None
+  */
+__weak void BSP_TICKLESS_WakeupCallback(BSP_TICKLESS_TypeDef *htl, uint32_t Mode)
+{
+  UNUSED(htl);
+  UNUSED(Mode);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TICKLESS_WakeupCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TICKLESS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Poll a register for a value, HAL_GetTick() does not run.
+  * @param  pReg Register.
+  * @param  Mask Bits polled.
+  * @param  Value Bits expected.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef TICKLESS_Wait(__IO uint32_t *pReg, uint32_t Mask, uint32_t Value)
+{
+  uint32_t loops = TICKLESS_WAIT_LOOPS;
+
+  while ((*pReg & Mask) != Value)
+  {
+    if (--loops == 0U)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read the RTC counter with its divider.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  pCount RTC counter.
+  * @param  pDiv RTC divider, RTC clock cycles left to the next count.
+  * @retval None
+  */
+static void TICKLESS_ReadTime(const BSP_TICKLESS_TypeDef *htl, uint32_t *pCount, uint32_t *pDiv)
+{
+  RTC_TypeDef *rtc = htl->hrtc->Instance;
+  uint32_t high;
+  uint32_t low;
+  uint32_t div;
+
+  /* Again when the counter moved during the reads */
+  do
+  {
+    high = rtc->CNTH & RTC_CNTH_RTC_CNT;
+    low  = rtc->CNTL & RTC_CNTL_RTC_CNT;
+    div  = ((rtc->DIVH & RTC_DIVH_DIV) << 16) | (rtc->DIVL & RTC_DIVL_DIV);
+  } while ((high != (rtc->CNTH & RTC_CNTH_RTC_CNT)) || (low != (rtc->CNTL & RTC_CNTL_RTC_CNT)));
+
+  *pCount = (high << 16) | low;
+  *pDiv   = div;
+}
+
+/**
+  * @brief  Write the RTC alarm, HAL_GetTick() does not run.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @param  Alarm Counter value of the alarm.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef TICKLESS_SetAlarm(const BSP_TICKLESS_TypeDef *htl, uint32_t Alarm)
+{
+  RTC_TypeDef *rtc = htl->hrtc->Instance;
+
+  if (TICKLESS_Wait(&rtc->CRL, RTC_CRL_RTOFF, RTC_CRL_RTOFF) != HAL_OK)
+  {
+    return HAL_TIMEOUT;
+  }
+
+  __HAL_RTC_WRITEPROTECTION_DISABLE(htl->hrtc);
+  WRITE_REG(rtc->ALRH, Alarm >> 16U);
+  WRITE_REG(rtc->ALRL, Alarm & RTC_ALRL_RTC_ALR);
+  __HAL_RTC_WRITEPROTECTION_ENABLE(htl->hrtc);
+
+  TICKLESS_ClearAlarm(htl);
+
+  return TICKLESS_Wait(&rtc->CRL, RTC_CRL_RTOFF, RTC_CRL_RTOFF);
+}
+
+/**
+  * @brief  Clear the RTC alarm flags, RTC, EXTI and NVIC.
+  * @param  htl Pointer to a BSP_TICKLESS_TypeDef structure.
+  * @retval None
+  */
+static void TICKLESS_ClearAlarm(const BSP_TICKLESS_TypeDef *htl)
+{
+  /* Not __HAL_RTC_ALARM_CLEAR_FLAG(), its write sets CNF */
+  CLEAR_BIT(htl->hrtc->Instance->CRL, RTC_CRL_ALRF);
+  __HAL_RTC_ALARM_EXTI_CLEAR_FLAG();
+  NVIC_ClearPendingIRQ(RTC_Alarm_IRQn);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED && HAL_PWR_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,442 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timburst.c
+  * @author  MCU Application Team
+  * @brief   TIM DMA burst streaming BSP service.
+  *          This file provides functions to write or read several registers
+  *          of a timer on each of its DMA requests, through DCR and DMAR:
+  *           + One DMA channel for all the registers of a burst
+  *           + Circular table of frames, one frame per burst
+  *           + No interrupt, or one per half table to refill it
+  *           + Frame in progress read from the DMA counter
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_TIM_DMABurst_WriteStart() and HAL_TIM_DMABurst_MultiWriteStart()
+       run a table once with an interrupt at its half and at its end, one
+       burst a period for a table of one frame. This service runs the table
+       in a loop with no interrupt: the CPU changes the registers of the next
+       periods by writing the frames, the DMA loads them on each request.
+
+   (#) Initialize the timer and its channels as usual, with the preload of
+       ARR and of the CCRx enabled: a burst on the update event is applied at
+       the next one. Link a DMA channel to the request with __HAL_LINKDMA(),
+       TIM_DMA_ID_UPDATE for TIM_DMA_UPDATE, in circular mode with words on
+       both sides and memory increment, memory to peripheral to write the
+       registers, peripheral to memory to read them.
+
+   (#) Call BSP_TIMBURST_Init() with the first register, a value of
+       @ref TIM_DMA_Base_address, and the number of registers of a burst:
+       TIM_DMABASE_ARR and 6 registers write ARR, RCR and CCR1 to CCR4 of
+       TIM1 in one burst. The table holds Frames x Registers words, frame n
+       at pTable[n x Registers].
+
+   (#) BSP_TIMBURST_Start() runs the table with no interrupt at all.
+       BSP_TIMBURST_GetFrame() gives the frame the next burst will transfer:
+       a frame other than this one can be written without tearing a burst.
+       With one frame, the values written are taken by the next burst,
+       possibly partly when the write is in progress at the request.
+
+   (#) BSP_TIMBURST_Start_IT() also calls BSP_TIMBURST_HalfCpltCallback()
+       when the first half of the table was transferred and
+       BSP_TIMBURST_CpltCallback() at its end: the half just done can be
+       refilled, an interrupt every Frames / 2 periods. Call
+       HAL_DMA_IRQHandler() from the interrupt handler of the channel. A
+       DMA error stops the stream and calls BSP_TIMBURST_ErrorCallback().
+
+   (#) BSP_TIMBURST_Stop() disables the request and the DMA channel, the
+       timer keeps running with the values of the last burst.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_timburst.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TIMBURST BSP TIMBURST
+  * @brief TIM DMA burst streaming BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Private_Constants BSP TIMBURST Private Constants
+  * @{
+  */
+#define TIMBURST_INSTANCES              6U             /* TIM1 to TIM5 and TIM8, the DMA burst timers */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Private_Variables BSP TIMBURST Private Variables
+  * @{
+  */
+/* Stream running on each timer, found from the DMA callbacks */
+static BSP_TIMBURST_TypeDef *TIMBURST_Handles[TIMBURST_INSTANCES];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Private_Functions BSP TIMBURST Private Functions
+  * @{
+  */
+static uint32_t TIMBURST_GetIndex(const TIM_TypeDef *Instance);
+static uint32_t TIMBURST_GetDmaId(uint32_t BurstRequestSrc);
+static HAL_StatusTypeDef TIMBURST_Run(BSP_TIMBURST_TypeDef *hburst, uint32_t Interrupts);
+static void     TIMBURST_DMAHalfCplt(DMA_HandleTypeDef *hdma);
+static void     TIMBURST_DMACplt(DMA_HandleTypeDef *hdma);
+static void     TIMBURST_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TIMBURST_Exported_Functions BSP TIMBURST Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a DMA burst stream of a timer.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @param  htim TIM handle, initialized, DMA channel of the request linked.
+  * @param  BurstBaseAddress First register, a value of @ref TIM_DMA_Base_address.
+  * @param  BurstRequestSrc DMA request of the bursts, a value of @ref TIM_DMA_sources.
+  * @param  Registers Registers of a burst, 1 to BSP_TIMBURST_REGISTERS_MAX.
+  * @param  pTable Frames x Registers words.
+  * @param  Frames Bursts of the table, Frames x Registers up to 0xFFFF.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMBURST_Init(BSP_TIMBURST_TypeDef *hburst, TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress,
+                                    uint32_t BurstRequestSrc, uint32_t Registers, uint32_t *pTable, uint32_t Frames)
+{
+  uint32_t id = TIMBURST_GetDmaId(BurstRequestSrc);
+  DMA_HandleTypeDef *hdma;
+
+  if ((hburst == NULL) || (htim == NULL) || (pTable == NULL) ||
+      (TIMBURST_GetIndex(htim->Instance) >= TIMBURST_INSTANCES) || (id > TIM_DMA_ID_TRIGGER) ||
+      !IS_TIM_DMA_BASE(BurstBaseAddress) || (Registers == 0U) || (Registers > BSP_TIMBURST_REGISTERS_MAX) ||
+      (Frames == 0U) || ((Frames * Registers) > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  hdma = htim->hdma[id];
+  if ((hdma == NULL) || (hdma->Init.Mode != DMA_CIRCULAR) ||
+      (hdma->Init.PeriphDataAlignment != DMA_PDATAALIGN_WORD) ||
+      (hdma->Init.MemDataAlignment != DMA_MDATAALIGN_WORD) ||
+      ((hdma->Init.Direction != DMA_MEMORY_TO_PERIPH) && (hdma->Init.Direction != DMA_PERIPH_TO_MEMORY)))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hburst->State == BSP_TIMBURST_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hburst->htim             = htim;
+  hburst->hdma             = hdma;
+  hburst->BurstBaseAddress = BurstBaseAddress;
+  hburst->BurstRequestSrc  = BurstRequestSrc;
+  hburst->Registers        = Registers;
+  hburst->pTable           = pTable;
+  hburst->Frames           = Frames;
+  hburst->State            = BSP_TIMBURST_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Run the table in a loop, one frame on each request, no interrupt.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMBURST_Start(BSP_TIMBURST_TypeDef *hburst)
+{
+  return TIMBURST_Run(hburst, 0U);
+}
+
+/**
+  * @brief  Run the table in a loop, with the half and end of table callbacks.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMBURST_Start_IT(BSP_TIMBURST_TypeDef *hburst)
+{
+  return TIMBURST_Run(hburst, 1U);
+}
+
+/**
+  * @brief  Stop the stream, the registers keep the values of the last burst.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMBURST_Stop(BSP_TIMBURST_TypeDef *hburst)
+{
+  if (hburst->State != BSP_TIMBURST_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_TIM_DISABLE_DMA(hburst->htim, hburst->BurstRequestSrc);
+  (void)HAL_DMA_Abort(hburst->hdma);
+  hburst->State = BSP_TIMBURST_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Frame of the next burst.
+  * @note   A burst in progress is counted as the next one.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval Frame index, 0 to Frames - 1
+  */
+uint32_t BSP_TIMBURST_GetFrame(const BSP_TIMBURST_TypeDef *hburst)
+{
+  uint32_t done = (hburst->Frames * hburst->Registers) - hburst->hdma->Instance->CNDTR;
+
+  return (done / hburst->Registers) % hburst->Frames;
+}
+
+/**
+  * @brief  Half table callback, the frames of the first half can be refilled.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMBURST_HalfCpltCallback(BSP_TIMBURST_TypeDef *hburst)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hburst);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMBURST_HalfCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  End of table callback, the frames of the second half can be refilled.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMBURST_CpltCallback(BSP_TIMBURST_TypeDef *hburst)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hburst);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMBURST_CpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Error callback, the stream is stopped.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMBURST_ErrorCallback(BSP_TIMBURST_TypeDef *hburst)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hburst);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMBURST_ErrorCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TIMBURST_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Index of a DMA burst timer in TIMBURST_Handles.
+  * @param  Instance TIM instance.
+  * @retval Index, TIMBURST_INSTANCES for another instance
+  */
+static uint32_t TIMBURST_GetIndex(const TIM_TypeDef *Instance)
+{
+  if (Instance == TIM1)
+  {
+    return 0U;
+  }
+  if (Instance == TIM2)
+  {
+    return 1U;
+  }
+  if (Instance == TIM3)
+  {
+    return 2U;
+  }
+  if (Instance == TIM4)
+  {
+    return 3U;
+  }
+  if (Instance == TIM5)
+  {
+    return 4U;
+  }
+  if (Instance == TIM8)
+  {
+    return 5U;
+  }
+
+  return TIMBURST_INSTANCES;
+}
+
+/**
+  * @brief  Index of the DMA handle of a request in the TIM handle.
+  * @param  BurstRequestSrc A value of @ref TIM_DMA_sources.
+  * @retval Index, above TIM_DMA_ID_TRIGGER for another value
+  */
+static uint32_t TIMBURST_GetDmaId(uint32_t BurstRequestSrc)
+{
+  switch (BurstRequestSrc)
+  {
+    case TIM_DMA_UPDATE:
+      return TIM_DMA_ID_UPDATE;
+    case TIM_DMA_CC1:
+      return TIM_DMA_ID_CC1;
+    case TIM_DMA_CC2:
+      return TIM_DMA_ID_CC2;
+    case TIM_DMA_CC3:
+      return TIM_DMA_ID_CC3;
+    case TIM_DMA_CC4:
+      return TIM_DMA_ID_CC4;
+    case TIM_DMA_COM:
+      return TIM_DMA_ID_COMMUTATION;
+    case TIM_DMA_TRIGGER:
+      return TIM_DMA_ID_TRIGGER;
+    default:
+      return TIM_DMA_ID_TRIGGER + 1U;
+  }
+}
+
+/**
+  * @brief  Start the circular DMA on DMAR, then the burst requests.
+  * @param  hburst Pointer to a BSP_TIMBURST_TypeDef structure.
+  * @param  Interrupts 1 for the half and end of table callbacks.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef TIMBURST_Run(BSP_TIMBURST_TypeDef *hburst, uint32_t Interrupts)
+{
+  DMA_HandleTypeDef *hdma = hburst->hdma;
+  uint32_t dmar = (uint32_t)&hburst->htim->Instance->DMAR;
+  uint32_t table = (uint32_t)hburst->pTable;
+  uint32_t length = hburst->Frames * hburst->Registers;
+  HAL_StatusTypeDef status;
+
+  if ((hburst->State != BSP_TIMBURST_STATE_READY) && (hburst->State != BSP_TIMBURST_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  TIMBURST_Handles[TIMBURST_GetIndex(hburst->htim->Instance)] = hburst;
+  hdma->XferCpltCallback     = TIMBURST_DMACplt;
+  hdma->XferHalfCpltCallback = TIMBURST_DMAHalfCplt;
+  hdma->XferErrorCallback    = TIMBURST_DMAError;
+
+  if (Interrupts != 0U)
+  {
+    status = (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH) ? HAL_DMA_Start_IT(hdma, table, dmar, length) :
+                                                                HAL_DMA_Start_IT(hdma, dmar, table, length);
+  }
+  else
+  {
+    /* HAL_DMA_Start() keeps the interrupt enables of a previous start */
+    __HAL_DMA_DISABLE_IT(hdma, DMA_IT_TC | DMA_IT_HT | DMA_IT_TE);
+    status = (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH) ? HAL_DMA_Start(hdma, table, dmar, length) :
+                                                                HAL_DMA_Start(hdma, dmar, table, length);
+  }
+  if (status != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* DBL is the number of transfers less one */
+  hburst->htim->Instance->DCR = hburst->BurstBaseAddress | ((hburst->Registers - 1U) << TIM_DCR_DBL_Pos);
+  hburst->State = BSP_TIMBURST_STATE_RUN;
+  __HAL_TIM_ENABLE_DMA(hburst->htim, hburst->BurstRequestSrc);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  DMA half transfer callback, first half of the table done.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMBURST_DMAHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMBURST_TypeDef *hburst = TIMBURST_Handles[TIMBURST_GetIndex(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  BSP_TIMBURST_HalfCpltCallback(hburst);
+}
+
+/**
+  * @brief  DMA transfer complete callback, table done, the DMA loops.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMBURST_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMBURST_TypeDef *hburst = TIMBURST_Handles[TIMBURST_GetIndex(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  BSP_TIMBURST_CpltCallback(hburst);
+}
+
+/**
+  * @brief  DMA error callback, the stream is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMBURST_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMBURST_TypeDef *hburst = TIMBURST_Handles[TIMBURST_GetIndex(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  __HAL_TIM_DISABLE_DMA(hburst->htim, hburst->BurstRequestSrc);
+  hburst->State = BSP_TIMBURST_STATE_ERROR;
+  BSP_TIMBURST_ErrorCallback(hburst);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
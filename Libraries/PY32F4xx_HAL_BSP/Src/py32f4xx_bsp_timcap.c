@@ -0,0 +1,540 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timcap.c
+  * @author  MCU Application Team
+  * @brief   Input capture measurement BSP service.
+  *          This file provides functions to measure periodic signals on the
+  *          input capture channels of the timers:
+  *           + Captures written by a circular DMA, no interrupt per edge
+  *           + Period, frequency, jitter and duty of each half buffer
+  *           + Counter wraps handled by 16-bit differences
+  *           + Any number of channels of TIM1 to TIM5 and TIM8
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the timer with HAL_TIM_IC_Init(), counting up, Period
+       0xFFFF. The periods are 16-bit differences of the captures: a period
+       must stay below 65536 ticks, choose the prescaler of the counter from
+       the lowest frequency measured. The counter is shared by the channels
+       measured on the timer and keeps running when they stop.
+
+   (#) Link a DMA channel to the request of each channel measured with
+       __HAL_LINKDMA(), TIM_DMA_ID_CC1 for channel 1, in circular mode,
+       peripheral to memory, with half-words on both sides and memory
+       increment. Call HAL_DMA_IRQHandler() from the interrupt handler of the
+       DMA channel.
+
+   (#) Call BSP_TIMCAP_Init() for each channel with a buffer of Size captures:
+       a batch is measured every Size / 2 captures, the period of the batch
+       callbacks. With TIM_ICPOLARITY_BOTHEDGE the input port and pin are read
+       at the start to know the direction of the first edge, the high time
+       and the duty are measured too.
+
+   (#) BSP_TIMCAP_Start() starts the captures, BSP_TIMCAP_BatchCallback() is
+       called from the DMA interrupt with the measures of each half buffer,
+       the first period starting at the last capture of the previous batch.
+       A signal that stops gives no batch. BSP_TIMCAP_Stop() stops the
+       channel. A DMA error stops it and calls BSP_TIMCAP_ErrorCallback().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "py32f4xx_bsp_timcap.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TIMCAP BSP TIMCAP
+  * @brief Input capture measurement BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Private_Constants BSP TIMCAP Private Constants
+  * @{
+  */
+#define TIMCAP_INSTANCES                6U             /* TIM1 to TIM5 and TIM8                       */
+#define TIMCAP_CHANNELS                 4U
+#define TIMCAP_ARM_TRIES                4U             /* Starts retried on an edge during the enable */
+
+#define TIMCAP_EDGE_SEEN                0x00000001U    /* A capture is in Last                        */
+#define TIMCAP_EDGE_RISING              0x00000002U    /* The next capture is a rising edge           */
+#define TIMCAP_EDGE_HIGH                0x00000004U    /* HighTicks measured                          */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Private_Variables BSP TIMCAP Private Variables
+  * @{
+  */
+/* Measure running on each channel, found from the DMA callbacks */
+static BSP_TIMCAP_TypeDef *TIMCAP_Handles[TIMCAP_INSTANCES][TIMCAP_CHANNELS];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Private_Functions BSP TIMCAP Private Functions
+  * @{
+  */
+static uint32_t TIMCAP_GetIndex(const TIM_TypeDef *Instance);
+static BSP_TIMCAP_TypeDef *TIMCAP_GetHandle(const DMA_HandleTypeDef *hdma);
+static HAL_StatusTypeDef TIMCAP_Arm(BSP_TIMCAP_TypeDef *hcap);
+static void     TIMCAP_Disarm(BSP_TIMCAP_TypeDef *hcap);
+static void     TIMCAP_Measure(BSP_TIMCAP_TypeDef *hcap, const uint16_t *pCapture, uint32_t Count);
+static void     TIMCAP_DMAHalfCplt(DMA_HandleTypeDef *hdma);
+static void     TIMCAP_DMACplt(DMA_HandleTypeDef *hdma);
+static void     TIMCAP_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TIMCAP_Exported_Functions BSP TIMCAP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the measure of an input capture channel.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @param  htim TIM handle, initialized, DMA channel of the CCx request linked.
+  * @param  pInit Pointer to a BSP_TIMCAP_InitTypeDef structure.
+  * @param  pBuffer Size captures.
+  * @param  Size Captures of the buffer, even, 4 to 0xFFFE.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMCAP_Init(BSP_TIMCAP_TypeDef *hcap, TIM_HandleTypeDef *htim,
+                                  const BSP_TIMCAP_InitTypeDef *pInit, uint16_t *pBuffer, uint32_t Size)
+{
+  TIM_IC_InitTypeDef ic;
+  DMA_HandleTypeDef *hdma;
+
+  if ((hcap == NULL) || (htim == NULL) || (pInit == NULL) || (pBuffer == NULL) ||
+      (TIMCAP_GetIndex(htim->Instance) >= TIMCAP_INSTANCES) || !IS_TIM_CCX_INSTANCE(htim->Instance, pInit->Channel) ||
+      (htim->Init.Period != 0xFFFFU) || (htim->Init.CounterMode != TIM_COUNTERMODE_UP) ||
+      !IS_TIM_IC_POLARITY(pInit->Polarity) || !IS_TIM_IC_PRESCALER(pInit->Prescaler) ||
+      !IS_TIM_IC_FILTER(pInit->Filter) || (pInit->TickHz == 0U) ||
+      (Size < 4U) || (Size > 0xFFFEU) || ((Size & 1U) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  if ((pInit->Polarity == TIM_ICPOLARITY_BOTHEDGE) &&
+      ((pInit->GPIOx == NULL) || (pInit->Prescaler != TIM_ICPSC_DIV1)))
+  {
+    return HAL_ERROR;
+  }
+
+  hdma = htim->hdma[TIM_DMA_ID_CC1 + (pInit->Channel >> 2)];
+  if ((hdma == NULL) || (hdma->Init.Mode != DMA_CIRCULAR) || (hdma->Init.Direction != DMA_PERIPH_TO_MEMORY) ||
+      (hdma->Init.PeriphDataAlignment != DMA_PDATAALIGN_HALFWORD) ||
+      (hdma->Init.MemDataAlignment != DMA_MDATAALIGN_HALFWORD))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hcap->State == BSP_TIMCAP_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  ic.ICPolarity  = pInit->Polarity;
+  ic.ICSelection = TIM_ICSELECTION_DIRECTTI;
+  ic.ICPrescaler = pInit->Prescaler;
+  ic.ICFilter    = pInit->Filter;
+  if (HAL_TIM_IC_ConfigChannel(htim, &ic, pInit->Channel) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hcap->htim    = htim;
+  hcap->hdma    = hdma;
+  hcap->Init    = *pInit;
+  hcap->pBuffer = pBuffer;
+  hcap->Size    = Size;
+  hcap->State   = BSP_TIMCAP_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the captures, and the counter when it is stopped.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMCAP_Start(BSP_TIMCAP_TypeDef *hcap)
+{
+  uint32_t tries;
+
+  if ((hcap->State != BSP_TIMCAP_STATE_READY) && (hcap->State != BSP_TIMCAP_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  TIMCAP_Handles[TIMCAP_GetIndex(hcap->htim->Instance)][hcap->Init.Channel >> 2] = hcap;
+  hcap->hdma->XferCpltCallback     = TIMCAP_DMACplt;
+  hcap->hdma->XferHalfCpltCallback = TIMCAP_DMAHalfCplt;
+  hcap->hdma->XferErrorCallback    = TIMCAP_DMAError;
+  __HAL_TIM_ENABLE(hcap->htim);
+
+  for (tries = 0U; tries < TIMCAP_ARM_TRIES; tries++)
+  {
+    switch (TIMCAP_Arm(hcap))
+    {
+      case HAL_OK:
+        hcap->State = BSP_TIMCAP_STATE_RUN;
+        return HAL_OK;
+      case HAL_BUSY:
+        /* The input changed during the enable, the first edge is unknown */
+        TIMCAP_Disarm(hcap);
+        break;
+      default:
+        return HAL_ERROR;
+    }
+  }
+
+  return HAL_ERROR;
+}
+
+/**
+  * @brief  Stop the captures of the channel, the counter keeps running.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMCAP_Stop(BSP_TIMCAP_TypeDef *hcap)
+{
+  if (hcap->State != BSP_TIMCAP_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  TIMCAP_Disarm(hcap);
+  hcap->State = BSP_TIMCAP_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Measures of a batch of captures.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @param  pStats Measures, valid during the call.
+  * @retval None
+  */
+__weak void BSP_TIMCAP_BatchCallback(BSP_TIMCAP_TypeDef *hcap, const BSP_TIMCAP_StatsTypeDef *pStats)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcap);
+  UNUSED(pStats);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMCAP_BatchCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Error callback, the channel is stopped.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMCAP_ErrorCallback(BSP_TIMCAP_TypeDef *hcap)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcap);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMCAP_ErrorCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TIMCAP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Index of a timer in TIMCAP_Handles.
+  * @param  Instance TIM instance.
+  * @retval Index, TIMCAP_INSTANCES for another instance
+  */
+static uint32_t TIMCAP_GetIndex(const TIM_TypeDef *Instance)
+{
+  if (Instance == TIM1)
+  {
+    return 0U;
+  }
+  if (Instance == TIM2)
+  {
+    return 1U;
+  }
+  if (Instance == TIM3)
+  {
+    return 2U;
+  }
+  if (Instance == TIM4)
+  {
+    return 3U;
+  }
+  if (Instance == TIM5)
+  {
+    return 4U;
+  }
+  if (Instance == TIM8)
+  {
+    return 5U;
+  }
+
+  return TIMCAP_INSTANCES;
+}
+
+/**
+  * @brief  Measure of a DMA channel.
+  * @param  hdma DMA handle, linked to a CCx request of a timer.
+  * @retval Pointer to a BSP_TIMCAP_TypeDef structure
+  */
+static BSP_TIMCAP_TypeDef *TIMCAP_GetHandle(const DMA_HandleTypeDef *hdma)
+{
+  const TIM_HandleTypeDef *htim = (const TIM_HandleTypeDef *)hdma->Parent;
+  uint32_t channel = 0U;
+
+  while ((channel < (TIMCAP_CHANNELS - 1U)) && (htim->hdma[TIM_DMA_ID_CC1 + channel] != hdma))
+  {
+    channel++;
+  }
+
+  return TIMCAP_Handles[TIMCAP_GetIndex(htim->Instance)][channel];
+}
+
+/**
+  * @brief  Start the DMA, then enable the capture reading the input on both sides.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @retval HAL_OK, HAL_BUSY when the input changed during the enable
+  */
+static HAL_StatusTypeDef TIMCAP_Arm(BSP_TIMCAP_TypeDef *hcap)
+{
+  uint32_t ccr = (uint32_t)&hcap->htim->Instance->CCR1 + hcap->Init.Channel;
+  uint32_t primask_bit;
+  uint32_t before = 0U;
+  uint32_t after = 0U;
+
+  if (HAL_DMA_Start_IT(hcap->hdma, ccr, (uint32_t)hcap->pBuffer, hcap->Size) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  __HAL_TIM_ENABLE_DMA(hcap->htim, TIM_DMA_CC1 << (hcap->Init.Channel >> 2));
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  if (hcap->Init.GPIOx != NULL)
+  {
+    before = hcap->Init.GPIOx->IDR & hcap->Init.GPIO_Pin;
+  }
+  TIM_CCxChannelCmd(hcap->htim->Instance, hcap->Init.Channel, TIM_CCx_ENABLE);
+  if (hcap->Init.GPIOx != NULL)
+  {
+    after = hcap->Init.GPIOx->IDR & hcap->Init.GPIO_Pin;
+  }
+  __set_PRIMASK(primask_bit);
+
+  if (before != after)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The first edge captured leaves the level read */
+  hcap->Edges = (after == 0U) ? TIMCAP_EDGE_RISING : 0U;
+  if (hcap->Init.Polarity != TIM_ICPOLARITY_BOTHEDGE)
+  {
+    hcap->Edges = 0U;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable the capture, its DMA request and the DMA channel.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @retval None
+  */
+static void TIMCAP_Disarm(BSP_TIMCAP_TypeDef *hcap)
+{
+  TIM_CCxChannelCmd(hcap->htim->Instance, hcap->Init.Channel, TIM_CCx_DISABLE);
+  __HAL_TIM_DISABLE_DMA(hcap->htim, TIM_DMA_CC1 << (hcap->Init.Channel >> 2));
+  (void)HAL_DMA_Abort(hcap->hdma);
+}
+
+/**
+  * @brief  Measure a batch of captures and call the batch callback.
+  * @param  hcap Pointer to a BSP_TIMCAP_TypeDef structure.
+  * @param  pCapture First capture of the batch.
+  * @param  Count Captures of the batch.
+  * @retval None
+  */
+static void TIMCAP_Measure(BSP_TIMCAP_TypeDef *hcap, const uint16_t *pCapture, uint32_t Count)
+{
+  BSP_TIMCAP_StatsTypeDef stats;
+  uint32_t edges = hcap->Edges;
+  uint32_t last = hcap->Last;
+  uint32_t both = (hcap->Init.Polarity == TIM_ICPOLARITY_BOTHEDGE) ? 1U : 0U;
+  uint32_t sum = 0U;
+  uint32_t high = 0U;
+  uint32_t reference = 0U;
+  int64_t sum1 = 0;
+  int64_t sum2 = 0;
+  uint32_t period;
+  uint32_t delta;
+  int32_t deviation;
+  uint32_t i;
+
+  stats.Periods   = 0U;
+  stats.PeriodMin = 0xFFFFFFFFU;
+  stats.PeriodMax = 0U;
+
+  for (i = 0U; i < Count; i++)
+  {
+    /* 16-bit difference, a wrap of the counter in between is accounted */
+    delta = (uint32_t)(uint16_t)(pCapture[i] - last);
+    last = pCapture[i];
+    if ((edges & TIMCAP_EDGE_SEEN) == 0U)
+    {
+      edges |= TIMCAP_EDGE_SEEN;
+      edges ^= both << 1;
+      continue;
+    }
+
+    if (both != 0U)
+    {
+      edges ^= TIMCAP_EDGE_RISING;
+      if ((edges & TIMCAP_EDGE_RISING) != 0U)
+      {
+        /* A falling edge, the time since the rising one is high */
+        hcap->HighTicks = delta;
+        edges |= TIMCAP_EDGE_HIGH;
+        continue;
+      }
+      if ((edges & TIMCAP_EDGE_HIGH) == 0U)
+      {
+        continue;
+      }
+      high += hcap->HighTicks;
+      period = hcap->HighTicks + delta;
+    }
+    else
+    {
+      period = delta;
+    }
+
+    if (stats.Periods == 0U)
+    {
+      reference = period;
+    }
+    /* Deviations from the first period keep the sums of squares exact */
+    deviation = (int32_t)period - (int32_t)reference;
+    sum1 += deviation;
+    sum2 += (int64_t)deviation * deviation;
+    sum += period;
+    stats.Periods++;
+    if (period < stats.PeriodMin)
+    {
+      stats.PeriodMin = period;
+    }
+    if (period > stats.PeriodMax)
+    {
+      stats.PeriodMax = period;
+    }
+  }
+  hcap->Edges = edges;
+  hcap->Last = last;
+
+  if (stats.Periods == 0U)
+  {
+    return;
+  }
+
+  stats.PeriodMean = (float)sum / (float)stats.Periods;
+  stats.Jitter     = sqrtf((float)((sum2 * stats.Periods) - (sum1 * sum1)) / ((float)stats.Periods * (float)stats.Periods));
+  stats.Frequency  = ((float)hcap->Init.TickHz * (float)(1UL << (hcap->Init.Prescaler >> TIM_CCMR1_IC1PSC_Pos))) /
+                     stats.PeriodMean;
+  stats.Duty       = (both != 0U) ? ((float)high / (float)sum) : 0.0f;
+
+  BSP_TIMCAP_BatchCallback(hcap, &stats);
+}
+
+/**
+  * @brief  DMA half transfer callback, first half of the buffer captured.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMCAP_DMAHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMCAP_TypeDef *hcap = TIMCAP_GetHandle(hdma);
+
+  TIMCAP_Measure(hcap, hcap->pBuffer, hcap->Size / 2U);
+}
+
+/**
+  * @brief  DMA transfer complete callback, second half of the buffer captured.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMCAP_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMCAP_TypeDef *hcap = TIMCAP_GetHandle(hdma);
+
+  TIMCAP_Measure(hcap, &hcap->pBuffer[hcap->Size / 2U], hcap->Size / 2U);
+}
+
+/**
+  * @brief  DMA error callback, the channel is stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMCAP_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMCAP_TypeDef *hcap = TIMCAP_GetHandle(hdma);
+
+  TIM_CCxChannelCmd(hcap->htim->Instance, hcap->Init.Channel, TIM_CCx_DISABLE);
+  __HAL_TIM_DISABLE_DMA(hcap->htim, TIM_DMA_CC1 << (hcap->Init.Channel >> 2));
+  hcap->State = BSP_TIMCAP_STATE_ERROR;
+  BSP_TIMCAP_ErrorCallback(hcap);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
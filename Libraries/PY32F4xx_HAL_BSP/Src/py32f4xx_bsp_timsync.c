@@ -0,0 +1,500 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timsync.c
+  * @author  MCU Application Team
+  * @brief   Timer synchronization BSP service.
+  *          This file provides functions to run timers as one group:
+  *           + Master/slave chains from a table, internal triggers found by
+  *             the service
+  *           + Start of all the members on the same timer clock
+  *           + 32-bit and 48-bit counters of cascaded 16-bit timers, read
+  *             consistently
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize the time base of every timer of the group, with
+       HAL_TIM_Base_Init(), HAL_TIM_PWM_Init() or a service such as
+       BSP_INVERTER, all of them stopped. Then describe the group in a table
+       of BSP_TIMSYNC_MemberTypeDef, kept by the service, one member per timer:
+      (++) The root, Link BSP_TIMSYNC_LINK_ROOT and Master BSP_TIMSYNC_NONE,
+           is the only timer started by the software.
+      (++) BSP_TIMSYNC_LINK_START: the member is in trigger mode on the
+           enable of its master, the root or another START member. With the
+           master/slave mode of the master, both start on the same clock.
+      (++) BSP_TIMSYNC_LINK_CASCADE: the member is clocked by the updates of
+           its master, forming the high word of a longer counter. TIM2 with
+           TIM3 in cascade is a 32-bit counter, TIM4 added in cascade of TIM3
+           a 48-bit one.
+
+   (#) BSP_TIMSYNC_Init() finds the internal trigger ITR0 to ITR3 of each link,
+       and configures the TRGO of the masters, TIMx_CR1.CEN for the START
+       links and the update for the CASCADE links, and the slave mode of the
+       other members. The links between TIM1, TIM2, TIM3, TIM4, TIM5, TIM8,
+       and TIM9 or TIM12 as slaves, are possible except:
+      (++) TIM1 from TIM8, TIM2 from TIM5, TIM3 from TIM8, TIM4 from TIM5,
+           TIM5 from TIM1, TIM8 from TIM3,
+      (++) TIM9 only from TIM2 and TIM3, TIM12 only from TIM4 and TIM5.
+       The TRGO of a master is used by the group; the ADC can still be
+       triggered by a CASCADE master, on its update.
+
+   (#) BSP_TIMSYNC_Start() enables the CASCADE members, which count nothing
+       until their master runs, then the root: every START member is started
+       by the hardware in the same timer clock. The counters start from their
+       current value, preload it with __HAL_TIM_SET_COUNTER() for a phase
+       offset between members. BSP_TIMSYNC_Stop() stops the root first then
+       the members, within a few bus cycles but not on the same clock.
+
+   (#) BSP_TIMSYNC_GetCounter() returns the counter of a member combined with
+       the counters of its CASCADE slaves: the high words are read before and
+       after the low word, and again on a change. The weight of a word is the
+       product of the periods, ARR + 1, of the words below it.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_timsync.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TIMSYNC BSP TIMSYNC
+  * @brief Timer synchronization BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Private_Types BSP TIMSYNC Private Types
+  * @{
+  */
+typedef struct
+{
+  TIM_TypeDef             *Slave;       /*!< Slave timer                                            */
+
+  TIM_TypeDef             *Itr[4];      /*!< Master of ITR0 to ITR3                                 */
+
+} TIMSYNC_ItrTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Private_Constants BSP TIMSYNC Private Constants
+  * @{
+  */
+#define TIMSYNC_UPPER_NONE              0xFFU
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Private_Variables BSP TIMSYNC Private Variables
+  * @{
+  */
+/* Internal trigger connections, the same on the PY32F403 devices */
+static const TIMSYNC_ItrTypeDef TIMSYNC_Itr[] =
+{
+  { TIM1,  { TIM5, TIM2, TIM3,  TIM4  } },
+  { TIM8,  { TIM1, TIM2, TIM4,  TIM5  } },
+  { TIM2,  { TIM1, TIM8, TIM3,  TIM4  } },
+  { TIM3,  { TIM1, TIM2, TIM5,  TIM4  } },
+  { TIM4,  { TIM1, TIM2, TIM3,  TIM8  } },
+  { TIM5,  { TIM2, TIM3, TIM4,  TIM8  } },
+  { TIM9,  { TIM2, TIM3, TIM10, TIM11 } },
+  { TIM12, { TIM4, TIM5, TIM13, TIM14 } },
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Private_Functions BSP TIMSYNC Private Functions
+  * @{
+  */
+static uint32_t TIMSYNC_Trigger(const TIM_TypeDef *Slave, const TIM_TypeDef *Master);
+static HAL_StatusTypeDef TIMSYNC_Check(BSP_TIMSYNC_TypeDef *hsync);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TIMSYNC_Exported_Functions BSP TIMSYNC Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Configure the triggers of a timer group.
+  * @param  hsync Pointer to a BSP_TIMSYNC_TypeDef structure.
+  * @param  pMembers Members, their time base initialized, kept by the service.
+  * @param  NbrOfMembers Members, 1 to BSP_TIMSYNC_MEMBERS_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMSYNC_Init(BSP_TIMSYNC_TypeDef *hsync, const BSP_TIMSYNC_MemberTypeDef *pMembers,
+                                   uint32_t NbrOfMembers)
+{
+  TIM_MasterConfigTypeDef master;
+  TIM_SlaveConfigTypeDef slave = {0};
+  const BSP_TIMSYNC_MemberTypeDef *member;
+  uint32_t link;
+  uint32_t i;
+  uint32_t j;
+
+  if ((hsync == NULL) || (pMembers == NULL) || (NbrOfMembers == 0U) ||
+      (NbrOfMembers > BSP_TIMSYNC_MEMBERS_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hsync->State == BSP_TIMSYNC_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  hsync->pMembers     = pMembers;
+  hsync->NbrOfMembers = NbrOfMembers;
+  if (TIMSYNC_Check(hsync) != HAL_OK)
+  {
+    hsync->State = BSP_TIMSYNC_STATE_RESET;
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < NbrOfMembers; i++)
+  {
+    member = &pMembers[i];
+
+    /* Master: TRGO from the link of its slaves, checked to be the same */
+    link = BSP_TIMSYNC_LINK_ROOT;
+    for (j = 0U; j < NbrOfMembers; j++)
+    {
+      if (pMembers[j].Master == i)
+      {
+        link = pMembers[j].Link;
+      }
+    }
+    if (link == BSP_TIMSYNC_LINK_START)
+    {
+      master.MasterOutputTrigger = TIM_TRGO_ENABLE;
+      master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_ENABLE;
+    }
+    else
+    {
+      master.MasterOutputTrigger = TIM_TRGO_UPDATE;
+      master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    }
+    if ((link != BSP_TIMSYNC_LINK_ROOT) &&
+        (HAL_TIMEx_MasterConfigSynchronization(member->htim, &master) != HAL_OK))
+    {
+      return HAL_ERROR;
+    }
+
+    /* Slave */
+    if (member->Link != BSP_TIMSYNC_LINK_ROOT)
+    {
+      slave.SlaveMode    = (member->Link == BSP_TIMSYNC_LINK_START) ? TIM_SLAVEMODE_TRIGGER : TIM_SLAVEMODE_EXTERNAL1;
+      slave.InputTrigger = TIMSYNC_Trigger(member->htim->Instance, pMembers[member->Master].htim->Instance);
+      if (HAL_TIM_SlaveConfigSynchro(member->htim, &slave) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+    }
+  }
+
+  hsync->State = BSP_TIMSYNC_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start all the members of the group.
+  * @param  hsync Pointer to a BSP_TIMSYNC_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMSYNC_Start(BSP_TIMSYNC_TypeDef *hsync)
+{
+  uint32_t primask_bit;
+  uint32_t i;
+
+  if (hsync->State != BSP_TIMSYNC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  for (i = 0U; i < hsync->NbrOfMembers; i++)
+  {
+    if ((hsync->pMembers[i].htim->Instance->CR1 & TIM_CR1_CEN) != 0U)
+    {
+      return HAL_BUSY;
+    }
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0U; i < hsync->NbrOfMembers; i++)
+  {
+    if (hsync->pMembers[i].Link == BSP_TIMSYNC_LINK_CASCADE)
+    {
+      __HAL_TIM_ENABLE(hsync->pMembers[i].htim);
+    }
+  }
+  /* The START members are enabled by the hardware, on this write */
+  __HAL_TIM_ENABLE(hsync->pMembers[hsync->Root].htim);
+  hsync->State = BSP_TIMSYNC_STATE_RUN;
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop all the members of the group, the root first.
+  * @param  hsync Pointer to a BSP_TIMSYNC_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMSYNC_Stop(BSP_TIMSYNC_TypeDef *hsync)
+{
+  uint32_t primask_bit;
+  uint32_t i;
+
+  if (hsync->State != BSP_TIMSYNC_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  hsync->pMembers[hsync->Root].htim->Instance->CR1 &= ~TIM_CR1_CEN;
+  for (i = 0U; i < hsync->NbrOfMembers; i++)
+  {
+    hsync->pMembers[i].htim->Instance->CR1 &= ~TIM_CR1_CEN;
+  }
+  hsync->State = BSP_TIMSYNC_STATE_READY;
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Counter of a member extended by its CASCADE slaves.
+  * @param  hsync Pointer to a BSP_TIMSYNC_TypeDef structure.
+  * @param  Member Index of the low word in the group.
+  * @retval Counter, the low word alone without a CASCADE slave
+  */
+uint64_t BSP_TIMSYNC_GetCounter(const BSP_TIMSYNC_TypeDef *hsync, uint32_t Member)
+{
+  TIM_TypeDef *words[BSP_TIMSYNC_MEMBERS_MAX];
+  uint32_t high[BSP_TIMSYNC_MEMBERS_MAX];
+  uint32_t nbr = 0U;
+  uint32_t changed;
+  uint32_t count;
+  uint64_t counter;
+  uint64_t weight;
+  uint32_t i;
+
+  if (Member >= hsync->NbrOfMembers)
+  {
+    return 0U;
+  }
+
+  for (i = Member; i != TIMSYNC_UPPER_NONE; i = hsync->Upper[i])
+  {
+    words[nbr] = hsync->pMembers[i].htim->Instance;
+    nbr++;
+  }
+
+  /* The high words before and after the low word, top first */
+  for (i = nbr - 1U; i > 0U; i--)
+  {
+    high[i] = words[i]->CNT;
+  }
+  do
+  {
+    count = words[0]->CNT;
+    changed = 0U;
+    for (i = nbr - 1U; i > 0U; i--)
+    {
+      if (words[i]->CNT != high[i])
+      {
+        high[i] = words[i]->CNT;
+        changed = 1U;
+      }
+    }
+  } while (changed != 0U);
+
+  counter = count;
+  weight = 1U;
+  for (i = 1U; i < nbr; i++)
+  {
+    weight *= (uint64_t)words[i - 1U]->ARR + 1U;
+    counter += (uint64_t)high[i] * weight;
+  }
+
+  return counter;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TIMSYNC_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Internal trigger of a slave from a master.
+  * @param  Slave Slave timer.
+  * @param  Master Master timer.
+  * @retval TIM_TS_ITR0 to TIM_TS_ITR3, TIM_TS_NONE without a connection
+  */
+static uint32_t TIMSYNC_Trigger(const TIM_TypeDef *Slave, const TIM_TypeDef *Master)
+{
+  static const uint32_t trigger[4] = { TIM_TS_ITR0, TIM_TS_ITR1, TIM_TS_ITR2, TIM_TS_ITR3 };
+  uint32_t i;
+  uint32_t itr;
+
+  for (i = 0U; i < (sizeof(TIMSYNC_Itr) / sizeof(TIMSYNC_Itr[0])); i++)
+  {
+    if (TIMSYNC_Itr[i].Slave == Slave)
+    {
+      for (itr = 0U; itr < 4U; itr++)
+      {
+        if (TIMSYNC_Itr[i].Itr[itr] == Master)
+        {
+          return trigger[itr];
+        }
+      }
+    }
+  }
+
+  return TIM_TS_NONE;
+}
+
+/**
+  * @brief  Check the links of the group and find its root and cascades.
+  * @param  hsync Pointer to a BSP_TIMSYNC_TypeDef structure, pMembers and
+  *         NbrOfMembers set.
+  * @retval HAL_OK, HAL_ERROR on a group not possible
+  */
+static HAL_StatusTypeDef TIMSYNC_Check(BSP_TIMSYNC_TypeDef *hsync)
+{
+  const BSP_TIMSYNC_MemberTypeDef *members = hsync->pMembers;
+  uint32_t n = hsync->NbrOfMembers;
+  uint32_t roots = 0U;
+  uint32_t depth;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0U; i < n; i++)
+  {
+    hsync->Upper[i] = TIMSYNC_UPPER_NONE;
+  }
+
+  for (i = 0U; i < n; i++)
+  {
+    if ((members[i].htim == NULL) || (members[i].htim->Instance == NULL))
+    {
+      return HAL_ERROR;
+    }
+    for (j = 0U; j < i; j++)
+    {
+      if (members[j].htim->Instance == members[i].htim->Instance)
+      {
+        return HAL_ERROR;
+      }
+    }
+
+    if (members[i].Link == BSP_TIMSYNC_LINK_ROOT)
+    {
+      if (members[i].Master != BSP_TIMSYNC_NONE)
+      {
+        return HAL_ERROR;
+      }
+      hsync->Root = i;
+      roots++;
+      continue;
+    }
+
+    if (((members[i].Link != BSP_TIMSYNC_LINK_START) && (members[i].Link != BSP_TIMSYNC_LINK_CASCADE)) ||
+        (members[i].Master >= n) || (members[i].Master == i) ||
+        !IS_TIM_MASTER_INSTANCE(members[members[i].Master].htim->Instance) ||
+        (TIMSYNC_Trigger(members[i].htim->Instance, members[members[i].Master].htim->Instance) == TIM_TS_NONE))
+    {
+      return HAL_ERROR;
+    }
+
+    /* A START master runs from the root start */
+    if ((members[i].Link == BSP_TIMSYNC_LINK_START) &&
+        (members[members[i].Master].Link == BSP_TIMSYNC_LINK_CASCADE))
+    {
+      return HAL_ERROR;
+    }
+
+    for (j = 0U; j < n; j++)
+    {
+      /* One TRGO per master, one high word per low word */
+      if ((j != i) && (members[j].Link != BSP_TIMSYNC_LINK_ROOT) && (members[j].Master == members[i].Master) &&
+          ((members[j].Link != members[i].Link) || (members[i].Link == BSP_TIMSYNC_LINK_CASCADE)))
+      {
+        return HAL_ERROR;
+      }
+    }
+    if (members[i].Link == BSP_TIMSYNC_LINK_CASCADE)
+    {
+      hsync->Upper[members[i].Master] = (uint8_t)i;
+    }
+  }
+
+  if (roots != 1U)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Every member reaches the root, no loop */
+  for (i = 0U; i < n; i++)
+  {
+    j = i;
+    for (depth = 0U; (j != hsync->Root) && (depth < n); depth++)
+    {
+      j = members[j].Master;
+    }
+    if (j != hsync->Root)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
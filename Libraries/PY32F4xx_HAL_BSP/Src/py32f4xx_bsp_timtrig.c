@@ -0,0 +1,440 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timtrig.c
+  * @author  MCU Application Team
+  * @brief   Timer paced DMA BSP service.
+  *          This file provides functions to move data between a buffer and
+  *          a peripheral register at a fixed rate, paced by a basic timer:
+  *           + TIM6 or TIM7 update requests, the DMA request mapped by the
+  *             service
+  *           + Rate in Hz, prescaler and period found by the service
+  *           + Writes from a buffer or reads into it, once or in a loop
+  *           + No interrupt, or one per half buffer
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Periodic I/O from a timer interrupt, a GPIO output pattern, a DAC-like
+       PWM duty stream or the sampling of a port, costs an interrupt per
+       sample. Here the update of TIM6 or TIM7 requests one DMA transfer
+       instead, between the buffer and any peripheral register: GPIOx->ODR,
+       GPIOx->BSRR, GPIOx->IDR, TIMx->CCR1, SPIx->DR.
+
+   (#) In HAL_TIM_Base_MspInit(), enable the clock of the timer and link a
+       DMA channel with __HAL_LINKDMA(htim, hdma[TIM_DMA_ID_UPDATE], hdma),
+       initialized with HAL_DMA_Init(): memory to peripheral to write the
+       register, peripheral to memory to read it, peripheral increment
+       disabled, memory increment enabled, the widths of the register and of
+       the buffer, normal mode for one pass or circular for a loop.
+       BSP_TIMTRIG_Init() maps the DMA channel to the request of the timer and
+       sets the rate. Rate in the handle is the rate obtained, the timer
+       clock over an integer.
+
+   (#) BSP_TIMTRIG_Start() starts the DMA with Length transfers then the
+       timer: the first transfer takes place one period after the call. In
+       normal mode the timer stops at the end of the buffer and
+       BSP_TIMTRIG_CpltCallback() is called. In circular mode
+       BSP_TIMTRIG_HalfCpltCallback() and BSP_TIMTRIG_CpltCallback() tell
+       which half of the buffer can be refilled, or read. Call
+       HAL_DMA_IRQHandler() from the interrupt handler of the channel; without
+       the interrupt enabled, a circular transfer runs with no CPU at all.
+
+   (#) BSP_TIMTRIG_SetRate() changes the rate, running or not, from the next
+       update. BSP_TIMTRIG_GetIndex() gives the next transfer in the buffer.
+       BSP_TIMTRIG_Stop() stops the timer and the DMA. A DMA error stops both
+       and calls BSP_TIMTRIG_ErrorCallback().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_timtrig.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TIMTRIG BSP TIMTRIG
+  * @brief Timer paced DMA BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED) && defined (HAL_DMA_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Private_Macros BSP TIMTRIG Private Macros
+  * @{
+  */
+#define TIMTRIG_INDEX(__INSTANCE__)     (((__INSTANCE__) == TIM6) ? 0U : 1U)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Private_Variables BSP TIMTRIG Private Variables
+  * @{
+  */
+/* Service of TIM6 and TIM7, found from the DMA callbacks */
+static BSP_TIMTRIG_TypeDef *TIMTRIG_Handles[2];
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Private_Functions BSP TIMTRIG Private Functions
+  * @{
+  */
+static uint32_t TIMTRIG_Period(uint32_t RateHz, uint32_t *pPrescaler, uint32_t *pPeriod);
+static void     TIMTRIG_DMAHalfCplt(DMA_HandleTypeDef *hdma);
+static void     TIMTRIG_DMACplt(DMA_HandleTypeDef *hdma);
+static void     TIMTRIG_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TIMTRIG_Exported_Functions BSP TIMTRIG Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a basic timer pacing DMA transfers.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @param  htim TIM handle, Instance TIM6 or TIM7, update DMA channel linked in
+  *         HAL_TIM_Base_MspInit().
+  * @param  RateHz Transfers per second.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMTRIG_Init(BSP_TIMTRIG_TypeDef *htrig, TIM_HandleTypeDef *htim, uint32_t RateHz)
+{
+  uint32_t prescaler;
+  uint32_t period;
+  uint32_t rate;
+
+  if ((htrig == NULL) || (htim == NULL) || ((htim->Instance != TIM6) && (htim->Instance != TIM7)))
+  {
+    return HAL_ERROR;
+  }
+
+  rate = TIMTRIG_Period(RateHz, &prescaler, &period);
+  if (rate == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  if (htrig->State == BSP_TIMTRIG_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  htim->Init.Prescaler         = prescaler;
+  htim->Init.CounterMode       = TIM_COUNTERMODE_UP;
+  htim->Init.Period            = period;
+  htim->Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+  htim->Init.RepetitionCounter = 0U;
+  htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(htim) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Linked by the MSP */
+  if ((htim->hdma[TIM_DMA_ID_UPDATE] == NULL) ||
+      (htim->hdma[TIM_DMA_ID_UPDATE]->Init.Direction == DMA_MEMORY_TO_MEMORY))
+  {
+    return HAL_ERROR;
+  }
+  HAL_DMA_ChannelMap(htim->hdma[TIM_DMA_ID_UPDATE],
+                     (htim->Instance == TIM6) ? DMA_CHANNEL_MAP_TIM6 : DMA_CHANNEL_MAP_TIM7);
+
+  htrig->htim   = htim;
+  htrig->hdma   = htim->hdma[TIM_DMA_ID_UPDATE];
+  htrig->Rate   = rate;
+  htrig->Length = 0U;
+  htrig->State  = BSP_TIMTRIG_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Change the rate, from the next update when running.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @param  RateHz Transfers per second.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMTRIG_SetRate(BSP_TIMTRIG_TypeDef *htrig, uint32_t RateHz)
+{
+  uint32_t prescaler;
+  uint32_t period;
+  uint32_t rate;
+
+  rate = TIMTRIG_Period(RateHz, &prescaler, &period);
+  if ((rate == 0U) || (htrig->State == BSP_TIMTRIG_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+
+  /* PSC and ARR are both preloaded */
+  htrig->htim->Instance->PSC = prescaler;
+  htrig->htim->Instance->ARR = period;
+  htrig->htim->Init.Prescaler = prescaler;
+  htrig->htim->Init.Period    = period;
+  htrig->Rate = rate;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the transfers, the first one a period after the call.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @param  PeriphAddress Address of the peripheral register.
+  * @param  pBuffer Buffer of Length data of the memory width of the DMA.
+  * @param  Length Transfers of the buffer, 1 to 0xFFFF.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMTRIG_Start(BSP_TIMTRIG_TypeDef *htrig, uint32_t PeriphAddress, void *pBuffer,
+                                    uint32_t Length)
+{
+  DMA_HandleTypeDef *hdma = htrig->hdma;
+  TIM_TypeDef *tim;
+  HAL_StatusTypeDef status;
+
+  if ((PeriphAddress == 0U) || (pBuffer == NULL) || (Length == 0U) || (Length > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((htrig->State != BSP_TIMTRIG_STATE_READY) && (htrig->State != BSP_TIMTRIG_STATE_ERROR))
+  {
+    return HAL_BUSY;
+  }
+
+  tim = htrig->htim->Instance;
+  TIMTRIG_Handles[TIMTRIG_INDEX(tim)] = htrig;
+  hdma->XferCpltCallback     = TIMTRIG_DMACplt;
+  hdma->XferHalfCpltCallback = (hdma->Init.Mode == DMA_CIRCULAR) ? TIMTRIG_DMAHalfCplt : NULL;
+  hdma->XferErrorCallback    = TIMTRIG_DMAError;
+  if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+  {
+    status = HAL_DMA_Start_IT(hdma, (uint32_t)pBuffer, PeriphAddress, Length);
+  }
+  else
+  {
+    status = HAL_DMA_Start_IT(hdma, PeriphAddress, (uint32_t)pBuffer, Length);
+  }
+  if (status != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  htrig->Length = Length;
+  htrig->State  = BSP_TIMTRIG_STATE_RUN;
+
+  /* PSC loaded before the request is enabled */
+  tim->EGR = TIM_EGR_UG;
+  __HAL_TIM_CLEAR_FLAG(htrig->htim, TIM_FLAG_UPDATE);
+  __HAL_TIM_ENABLE_DMA(htrig->htim, TIM_DMA_UPDATE);
+  __HAL_TIM_ENABLE(htrig->htim);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the timer and the transfers.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMTRIG_Stop(BSP_TIMTRIG_TypeDef *htrig)
+{
+  if (htrig->State != BSP_TIMTRIG_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  htrig->htim->Instance->CR1 &= ~TIM_CR1_CEN;
+  __HAL_TIM_DISABLE_DMA(htrig->htim, TIM_DMA_UPDATE);
+  (void)HAL_DMA_Abort(htrig->hdma);
+  htrig->State = BSP_TIMTRIG_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Index of the next transfer in the buffer.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @retval Index, 0 to Length - 1, Length at the end of a normal transfer
+  */
+uint32_t BSP_TIMTRIG_GetIndex(const BSP_TIMTRIG_TypeDef *htrig)
+{
+  uint32_t remaining = htrig->hdma->Instance->CNDTR;
+
+  if (htrig->hdma->Init.Mode == DMA_CIRCULAR)
+  {
+    return (htrig->Length - remaining) % htrig->Length;
+  }
+
+  return htrig->Length - remaining;
+}
+
+/**
+  * @brief  Half buffer callback in circular mode, the first half can be used.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMTRIG_HalfCpltCallback(BSP_TIMTRIG_TypeDef *htrig)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrig);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMTRIG_HalfCpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  End of buffer callback, the timer stopped in normal mode.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMTRIG_CpltCallback(BSP_TIMTRIG_TypeDef *htrig)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrig);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMTRIG_CpltCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Error callback, the transfers are stopped.
+  * @param  htrig Pointer to a BSP_TIMTRIG_TypeDef structure.
+  * @retval None
+  */
+__weak void BSP_TIMTRIG_ErrorCallback(BSP_TIMTRIG_TypeDef *htrig)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htrig);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the BSP_TIMTRIG_ErrorCallback can be implemented in the user file.
+   */
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TIMTRIG_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Prescaler and period of a rate.
+  * @param  RateHz Updates per second.
+  * @param  pPrescaler PSC.
+  * @param  pPeriod ARR.
+  * @retval Rate obtained, 0 when out of range
+  */
+static uint32_t TIMTRIG_Period(uint32_t RateHz, uint32_t *pPrescaler, uint32_t *pPeriod)
+{
+  uint32_t clock = HAL_RCC_GetPCLK1Freq();
+  uint32_t ticks;
+  uint32_t prescaler;
+
+  /* TIM6 and TIM7 run from PCLK1, doubled when APB1 is divided */
+  clock = (clock == HAL_RCC_GetHCLKFreq()) ? clock : (2U * clock);
+  if ((RateHz == 0U) || (RateHz > (clock / 2U)))
+  {
+    return 0U;
+  }
+
+  ticks = (clock + (RateHz / 2U)) / RateHz;
+  prescaler = (ticks - 1U) / 0x10000U;
+  if (prescaler > 0xFFFFU)
+  {
+    return 0U;
+  }
+
+  *pPrescaler = prescaler;
+  *pPeriod    = ((ticks + (prescaler / 2U)) / (prescaler + 1U)) - 1U;
+
+  return clock / ((prescaler + 1U) * (*pPeriod + 1U));
+}
+
+/**
+  * @brief  DMA half transfer callback, first half of the buffer done.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMTRIG_DMAHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMTRIG_TypeDef *htrig = TIMTRIG_Handles[TIMTRIG_INDEX(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  BSP_TIMTRIG_HalfCpltCallback(htrig);
+}
+
+/**
+  * @brief  DMA transfer complete callback, end of the buffer.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMTRIG_DMACplt(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMTRIG_TypeDef *htrig = TIMTRIG_Handles[TIMTRIG_INDEX(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  if (hdma->Init.Mode != DMA_CIRCULAR)
+  {
+    htrig->htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    __HAL_TIM_DISABLE_DMA(htrig->htim, TIM_DMA_UPDATE);
+    htrig->State = BSP_TIMTRIG_STATE_READY;
+  }
+  BSP_TIMTRIG_CpltCallback(htrig);
+}
+
+/**
+  * @brief  DMA error callback, the transfers are stopped.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void TIMTRIG_DMAError(DMA_HandleTypeDef *hdma)
+{
+  BSP_TIMTRIG_TypeDef *htrig = TIMTRIG_Handles[TIMTRIG_INDEX(((TIM_HandleTypeDef *)hdma->Parent)->Instance)];
+
+  htrig->htim->Instance->CR1 &= ~TIM_CR1_CEN;
+  __HAL_TIM_DISABLE_DMA(htrig->htim, TIM_DMA_UPDATE);
+  htrig->State = BSP_TIMTRIG_STATE_ERROR;
+  BSP_TIMTRIG_ErrorCallback(htrig);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED && HAL_DMA_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,695 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_timwheel.c
+  * @author  MCU Application Team
+  * @brief   Software timer wheel BSP service.
+  *          This file provides functions to run any number of software
+  *          timers from one hardware timer:
+  *           + 32-bit time from a 16-bit counter and its overflows
+  *           + Hierarchical wheel of 7 levels of 32 slots
+  *           + Start and stop in constant time
+  *           + Tickless, the compare is set to the next slot holding timers
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Initialize a general purpose timer with HAL_TIM_Base_Init(), counting
+       up, Period 0xFFFF, the prescaler giving the tick of the timers: 1 us
+       with a 1 MHz counter clock. The counters of the PY32F403 are 16-bit,
+       the service extends the time to 32 bits with the update interrupt, one
+       every 65.536 ms at 1 MHz. Enable the timer interrupt in the NVIC at a
+       low priority: the timer callbacks run from it.
+
+   (#) Call BSP_TIMWHEEL_Init() then BSP_TIMWHEEL_Start(). The service owns the
+       timer and its channel 1, in output compare timing mode. In the
+       TIMx_IRQHandler() call BSP_TIMWHEEL_IRQHandler() instead of
+       HAL_TIM_IRQHandler().
+
+   (#) Prepare each timer once with BSP_TIMWHEEL_TimerInit() and its callback.
+       BSP_TIMWHEEL_TimerStart() arms it for Delay ticks, then every Period
+       ticks when Period is not 0, up to BSP_TIMWHEEL_DELAY_MAX. Starting an
+       armed timer restarts it. BSP_TIMWHEEL_TimerStop() disarms it. Both take
+       a constant time whatever the number of timers, and can be called from
+       any context, including the timer callbacks.
+
+   (#) A timer is put in the level of the highest 5 bits its expiry differs
+       from the time of the wheel, in the slot of these bits. When the time
+       reaches a slot of level 1 or above, its timers move down to the lower
+       levels; when it reaches a slot of level 0 they expire. The compare
+       channel is only set to the next slot holding timers: a timer of a long
+       delay wakes the CPU once for each level it moves down, a timer of 31
+       ticks or less only at its expiry.
+
+   (#) BSP_TIMWHEEL_GetTime() gives the time in ticks, it wraps after 2^32.
+
+   (#) For a tickless idle, BSP_TIMWHEEL_GetIdleTime() gives the ticks up to
+       the next expiry, not counting the moves down of the timers which can
+       be late. The counter stops in the STOP mode: on the wakeup give the
+       ticks spent there to BSP_TIMWHEEL_Advance(), the timers due expire
+       from the timer interrupt.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_timwheel.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TIMWHEEL BSP TIMWHEEL
+  * @brief Software timer wheel BSP service
+  * @{
+  */
+
+#if defined (HAL_TIM_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Private_Constants BSP TIMWHEEL Private Constants
+  * @{
+  */
+#define TIMWHEEL_SLOT_BITS              5U             /* Bits of the time for a level                */
+#define TIMWHEEL_SLOT_MASK              (BSP_TIMWHEEL_SLOTS - 1U)
+#define TIMWHEEL_INDEXES                (BSP_TIMWHEEL_LEVELS * BSP_TIMWHEEL_SLOTS)
+#define TIMWHEEL_SLOT_PENDING           0xFFFFFFFEU    /* Timer in the pending list                   */
+#define TIMWHEEL_NONE                   0xFFFFFFFFU    /* No slot holds timers                        */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Private_Macros BSP TIMWHEEL Private Macros
+  * @{
+  */
+/* Slots used by a level, the last one only has bits 31:30 */
+#define TIMWHEEL_RING_MASK(__LEVEL__)   ((((__LEVEL__) * TIMWHEEL_SLOT_BITS) + TIMWHEEL_SLOT_BITS > 32U) ? \
+                                         ((1UL << (32U - ((__LEVEL__) * TIMWHEEL_SLOT_BITS))) - 1U) :    \
+                                         TIMWHEEL_SLOT_MASK)
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Private_Functions BSP TIMWHEEL Private Functions
+  * @{
+  */
+static uint32_t TIMWHEEL_GetTime(const BSP_TIMWHEEL_TypeDef *hwheel);
+static uint32_t TIMWHEEL_Next(const BSP_TIMWHEEL_TypeDef *hwheel, uint32_t *pIndex);
+static uint32_t TIMWHEEL_Earliest(const BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Now);
+static void     TIMWHEEL_Insert(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer);
+static void     TIMWHEEL_Unlink(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer);
+static uint32_t TIMWHEEL_Program(BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Now);
+static void     TIMWHEEL_Run(BSP_TIMWHEEL_TypeDef *hwheel);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TIMWHEEL_Exported_Functions BSP TIMWHEEL Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a timer wheel on a 16-bit timer.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  htim TIM handle, initialized counting up with Period 0xFFFF.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_Init(BSP_TIMWHEEL_TypeDef *hwheel, TIM_HandleTypeDef *htim)
+{
+  TIM_OC_InitTypeDef oc = {0};
+  uint32_t i;
+
+  if ((hwheel == NULL) || (htim == NULL) || !IS_TIM_CC1_INSTANCE(htim->Instance) ||
+      (htim->Init.Period != 0xFFFFU) || (htim->Init.CounterMode != TIM_COUNTERMODE_UP))
+  {
+    return HAL_ERROR;
+  }
+
+  if (hwheel->State == BSP_TIMWHEEL_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  /* No preload, a compare written is used at once */
+  oc.OCMode     = TIM_OCMODE_TIMING;
+  oc.Pulse      = 0U;
+  oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+  oc.OCFastMode = TIM_OCFAST_DISABLE;
+  if (HAL_TIM_OC_ConfigChannel(htim, &oc, TIM_CHANNEL_1) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hwheel->htim     = htim;
+  hwheel->High     = 0U;
+  hwheel->Now      = 0U;
+  hwheel->pPending = NULL;
+  for (i = 0U; i < BSP_TIMWHEEL_LEVELS; i++)
+  {
+    hwheel->Bitmap[i] = 0U;
+  }
+  for (i = 0U; i < TIMWHEEL_INDEXES; i++)
+  {
+    hwheel->pSlots[i] = NULL;
+  }
+  hwheel->State = BSP_TIMWHEEL_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the counter, the time starts at 0.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_Start(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  if (hwheel->State != BSP_TIMWHEEL_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_TIM_SET_COUNTER(hwheel->htim, 0U);
+  __HAL_TIM_CLEAR_IT(hwheel->htim, TIM_IT_UPDATE | TIM_IT_CC1);
+  hwheel->State = BSP_TIMWHEEL_STATE_RUN;
+  if (HAL_TIM_Base_Start_IT(hwheel->htim) != HAL_OK)
+  {
+    hwheel->State = BSP_TIMWHEEL_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the counter, the armed timers are kept and frozen.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_Stop(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  if (hwheel->State != BSP_TIMWHEEL_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_TIM_DISABLE_IT(hwheel->htim, TIM_IT_CC1);
+  (void)HAL_TIM_Base_Stop_IT(hwheel->htim);
+  hwheel->State = BSP_TIMWHEEL_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Time of the wheel.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval Time in ticks
+  */
+uint32_t BSP_TIMWHEEL_GetTime(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  uint32_t now;
+
+  __disable_irq();
+  now = TIMWHEEL_GetTime(hwheel);
+  __set_PRIMASK(primask_bit);
+
+  return now;
+}
+
+/**
+  * @brief  Ticks up to the next expiry.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval Ticks, 0 when a timer is due, BSP_TIMWHEEL_IDLE_FOREVER with no timer armed
+  */
+uint32_t BSP_TIMWHEEL_GetIdleTime(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  uint32_t idle;
+
+  __disable_irq();
+  idle = TIMWHEEL_Earliest(hwheel, TIMWHEEL_GetTime(hwheel));
+  __set_PRIMASK(primask_bit);
+
+  return idle;
+}
+
+/**
+  * @brief  Move the time forward over a period the counter did not count.
+  * @note   The timer clock is off in the STOP mode, the armed timers keep their
+  *         expiry in real time.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  Ticks Ticks elapsed with the counter stopped, up to BSP_TIMWHEEL_DELAY_MAX.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_Advance(BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Ticks)
+{
+  TIM_HandleTypeDef *htim = hwheel->htim;
+  uint32_t primask_bit;
+  uint32_t now;
+
+  if (Ticks > BSP_TIMWHEEL_DELAY_MAX)
+  {
+    return HAL_ERROR;
+  }
+  if (hwheel->State != BSP_TIMWHEEL_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  /* The overflow pending is counted in now, the counter and High are set together */
+  now = TIMWHEEL_GetTime(hwheel) + Ticks;
+  __HAL_TIM_CLEAR_IT(htim, TIM_IT_UPDATE);
+  __HAL_TIM_SET_COUNTER(htim, now & 0xFFFFU);
+  hwheel->High = now >> 16;
+
+  if (TIMWHEEL_Program(hwheel, now) != 0U)
+  {
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_CC1);
+    htim->Instance->EGR = TIM_EGR_CC1G;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Prepare a timer, not armed.
+  * @param  pTimer Pointer to a BSP_TIMWHEEL_TimerTypeDef structure.
+  * @param  Callback Function called at the expiry.
+  * @param  pContext User data of the callback.
+  * @retval None
+  */
+void BSP_TIMWHEEL_TimerInit(BSP_TIMWHEEL_TimerTypeDef *pTimer,
+                            void (*Callback)(BSP_TIMWHEEL_TimerTypeDef *pTimer), void *pContext)
+{
+  pTimer->pNext    = NULL;
+  pTimer->ppPrev   = NULL;
+  pTimer->Expiry   = 0U;
+  pTimer->Period   = 0U;
+  pTimer->Slot     = BSP_TIMWHEEL_SLOT_NONE;
+  pTimer->Callback = Callback;
+  pTimer->pContext = pContext;
+}
+
+/**
+  * @brief  Arm a timer, or restart it when armed.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  pTimer Pointer to a BSP_TIMWHEEL_TimerTypeDef structure.
+  * @param  Delay Ticks to the first expiry, up to BSP_TIMWHEEL_DELAY_MAX.
+  * @param  Period Ticks between the next expiries, 0 for one expiry.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TIMWHEEL_TimerStart(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer,
+                                          uint32_t Delay, uint32_t Period)
+{
+  uint32_t primask_bit;
+  uint32_t index;
+  uint32_t now;
+
+  if ((pTimer == NULL) || (pTimer->Callback == NULL) ||
+      (Delay > BSP_TIMWHEEL_DELAY_MAX) || (Period > BSP_TIMWHEEL_DELAY_MAX))
+  {
+    return HAL_ERROR;
+  }
+  if (hwheel->State != BSP_TIMWHEEL_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  now = TIMWHEEL_GetTime(hwheel);
+  if (pTimer->Slot != BSP_TIMWHEEL_SLOT_NONE)
+  {
+    TIMWHEEL_Unlink(hwheel, pTimer);
+  }
+  /* Catch up with the time when no slot was reached, the timer goes in a lower level */
+  if (TIMWHEEL_Next(hwheel, &index) > (now - hwheel->Now))
+  {
+    hwheel->Now = now;
+  }
+  pTimer->Expiry = now + Delay;
+  pTimer->Period = Period;
+  TIMWHEEL_Insert(hwheel, pTimer);
+
+  if (TIMWHEEL_Program(hwheel, now) != 0U)
+  {
+    /* A slot is already due, run the wheel from the interrupt */
+    __HAL_TIM_ENABLE_IT(hwheel->htim, TIM_IT_CC1);
+    hwheel->htim->Instance->EGR = TIM_EGR_CC1G;
+  }
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disarm a timer, nothing is done when it is not armed.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  pTimer Pointer to a BSP_TIMWHEEL_TimerTypeDef structure.
+  * @retval None
+  */
+void BSP_TIMWHEEL_TimerStop(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  if (pTimer->Slot != BSP_TIMWHEEL_SLOT_NONE)
+  {
+    TIMWHEEL_Unlink(hwheel, pTimer);
+  }
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Timer interrupt, counts the overflows and expires the timers.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval None
+  */
+void BSP_TIMWHEEL_IRQHandler(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  TIM_HandleTypeDef *htim = hwheel->htim;
+  uint32_t primask_bit = __get_PRIMASK();
+
+  __disable_irq();
+  if (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) != RESET)
+  {
+    __HAL_TIM_CLEAR_IT(htim, TIM_IT_UPDATE);
+    hwheel->High++;
+  }
+  __set_PRIMASK(primask_bit);
+
+  if (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_CC1) != RESET)
+  {
+    __HAL_TIM_CLEAR_IT(htim, TIM_IT_CC1);
+  }
+
+  TIMWHEEL_Run(hwheel);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TIMWHEEL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  32-bit time, interrupts disabled.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval Time in ticks
+  */
+static uint32_t TIMWHEEL_GetTime(const BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  uint32_t high = hwheel->High;
+  uint32_t count = hwheel->htim->Instance->CNT;
+
+  /* An overflow not counted yet, the counter read after it */
+  if ((__HAL_TIM_GET_FLAG(hwheel->htim, TIM_FLAG_UPDATE) != RESET) && (count < 0x8000U))
+  {
+    high++;
+  }
+
+  return (high << 16) | (count & 0xFFFFU);
+}
+
+/**
+  * @brief  Next slot holding timers.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  pIndex Index of the slot in pSlots.
+  * @retval Ticks from the time of the wheel to the slot, TIMWHEEL_NONE when empty
+  */
+static uint32_t TIMWHEEL_Next(const BSP_TIMWHEEL_TypeDef *hwheel, uint32_t *pIndex)
+{
+  uint32_t best = TIMWHEEL_NONE;
+  uint32_t level;
+  uint32_t shift;
+  uint32_t slot;
+  uint32_t now;
+  uint32_t delta;
+
+  for (level = 0U; level < BSP_TIMWHEEL_LEVELS; level++)
+  {
+    if (hwheel->Bitmap[level] == 0U)
+    {
+      continue;
+    }
+
+    shift = level * TIMWHEEL_SLOT_BITS;
+    now = (hwheel->Now >> shift) & TIMWHEEL_SLOT_MASK;
+    /* First slot from the current one, the slots of a level are a ring */
+    slot = (now + __CLZ(__RBIT(__ROR(hwheel->Bitmap[level], now)))) & TIMWHEEL_SLOT_MASK;
+    delta = ((slot - now) & TIMWHEEL_RING_MASK(level)) << shift;
+    if (level != 0U)
+    {
+      /* From the time to the start of the slot */
+      delta -= hwheel->Now & ((1UL << shift) - 1U);
+    }
+
+    if (delta < best)
+    {
+      best = delta;
+      *pIndex = (level * BSP_TIMWHEEL_SLOTS) + slot;
+    }
+  }
+
+  return best;
+}
+
+/**
+  * @brief  Ticks from the time to the earliest expiry, interrupts disabled.
+  * @note   The first slot holding timers of each level has the earliest
+  *         expiries of the level, only these slots are walked.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  Now Time read before.
+  * @retval Ticks, 0 when due, BSP_TIMWHEEL_IDLE_FOREVER when empty
+  */
+static uint32_t TIMWHEEL_Earliest(const BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Now)
+{
+  const BSP_TIMWHEEL_TimerTypeDef *timer;
+  uint32_t best = BSP_TIMWHEEL_IDLE_FOREVER;
+  uint32_t level;
+  uint32_t slot;
+  uint32_t now;
+  int32_t  delta;
+
+  /* Timers being expired or moved down by the interrupt */
+  for (timer = hwheel->pPending; timer != NULL; timer = timer->pNext)
+  {
+    delta = (int32_t)(timer->Expiry - Now);
+    best = (delta <= 0) ? 0U : (((uint32_t)delta < best) ? (uint32_t)delta : best);
+  }
+
+  for (level = 0U; level < BSP_TIMWHEEL_LEVELS; level++)
+  {
+    if (hwheel->Bitmap[level] == 0U)
+    {
+      continue;
+    }
+
+    now = (hwheel->Now >> (level * TIMWHEEL_SLOT_BITS)) & TIMWHEEL_SLOT_MASK;
+    slot = (now + __CLZ(__RBIT(__ROR(hwheel->Bitmap[level], now)))) & TIMWHEEL_SLOT_MASK;
+    for (timer = hwheel->pSlots[(level * BSP_TIMWHEEL_SLOTS) + slot]; timer != NULL; timer = timer->pNext)
+    {
+      delta = (int32_t)(timer->Expiry - Now);
+      best = (delta <= 0) ? 0U : (((uint32_t)delta < best) ? (uint32_t)delta : best);
+    }
+  }
+
+  return best;
+}
+
+/**
+  * @brief  Link a timer in the slot of its expiry.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  pTimer Pointer to a BSP_TIMWHEEL_TimerTypeDef structure, not linked.
+  * @retval None
+  */
+static void TIMWHEEL_Insert(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  uint32_t diff = pTimer->Expiry ^ hwheel->Now;
+  uint32_t level = (diff == 0U) ? 0U : ((31U - __CLZ(diff)) / TIMWHEEL_SLOT_BITS);
+  uint32_t slot = (pTimer->Expiry >> (level * TIMWHEEL_SLOT_BITS)) & TIMWHEEL_SLOT_MASK;
+  uint32_t index = (level * BSP_TIMWHEEL_SLOTS) + slot;
+
+  pTimer->pNext = hwheel->pSlots[index];
+  if (pTimer->pNext != NULL)
+  {
+    pTimer->pNext->ppPrev = &pTimer->pNext;
+  }
+  pTimer->ppPrev = &hwheel->pSlots[index];
+  pTimer->Slot = index;
+  hwheel->pSlots[index] = pTimer;
+  hwheel->Bitmap[level] |= 1UL << slot;
+}
+
+/**
+  * @brief  Unlink a timer from its slot or from the pending list.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  pTimer Pointer to a BSP_TIMWHEEL_TimerTypeDef structure, linked.
+  * @retval None
+  */
+static void TIMWHEEL_Unlink(BSP_TIMWHEEL_TypeDef *hwheel, BSP_TIMWHEEL_TimerTypeDef *pTimer)
+{
+  *pTimer->ppPrev = pTimer->pNext;
+  if (pTimer->pNext != NULL)
+  {
+    pTimer->pNext->ppPrev = pTimer->ppPrev;
+  }
+  if ((pTimer->Slot < TIMWHEEL_INDEXES) && (hwheel->pSlots[pTimer->Slot] == NULL))
+  {
+    hwheel->Bitmap[pTimer->Slot / BSP_TIMWHEEL_SLOTS] &= ~(1UL << (pTimer->Slot & TIMWHEEL_SLOT_MASK));
+  }
+  pTimer->Slot = BSP_TIMWHEEL_SLOT_NONE;
+}
+
+/**
+  * @brief  Set the compare to the next slot, interrupts disabled.
+  * @note   A slot beyond the current lap of the counter is set by the update
+  *         interrupts.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @param  Now Time read before.
+  * @retval 1 when the slot is already due, 0 otherwise
+  */
+static uint32_t TIMWHEEL_Program(BSP_TIMWHEEL_TypeDef *hwheel, uint32_t Now)
+{
+  TIM_HandleTypeDef *htim = hwheel->htim;
+  uint32_t index;
+  uint32_t next = TIMWHEEL_Next(hwheel, &index);
+
+  if (next == TIMWHEEL_NONE)
+  {
+    __HAL_TIM_DISABLE_IT(htim, TIM_IT_CC1);
+    return 0U;
+  }
+
+  next += hwheel->Now;
+  if ((int32_t)(next - Now) <= 0)
+  {
+    return 1U;
+  }
+  if ((next - Now) > 0xFFFFU)
+  {
+    __HAL_TIM_DISABLE_IT(htim, TIM_IT_CC1);
+    return 0U;
+  }
+
+  __HAL_TIM_SET_COMPARE(htim, TIM_CHANNEL_1, next & 0xFFFFU);
+  __HAL_TIM_CLEAR_IT(htim, TIM_IT_CC1);
+  __HAL_TIM_ENABLE_IT(htim, TIM_IT_CC1);
+
+  /* The counter may have passed the compare while it was written */
+  return ((int32_t)(next - TIMWHEEL_GetTime(hwheel)) <= 0) ? 1U : 0U;
+}
+
+/**
+  * @brief  Advance the wheel to the time, expire and move down the timers.
+  * @note   The callbacks are called with the interrupts enabled.
+  * @param  hwheel Pointer to a BSP_TIMWHEEL_TypeDef structure.
+  * @retval None
+  */
+static void TIMWHEEL_Run(BSP_TIMWHEEL_TypeDef *hwheel)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+  BSP_TIMWHEEL_TimerTypeDef *timer;
+  uint32_t index = 0U;
+  uint32_t delta;
+  uint32_t now;
+
+  __disable_irq();
+  now = TIMWHEEL_GetTime(hwheel);
+
+  for (;;)
+  {
+    delta = TIMWHEEL_Next(hwheel, &index);
+    if (delta > (now - hwheel->Now))
+    {
+      /* No slot reached up to now */
+      hwheel->Now = now;
+      if (TIMWHEEL_Program(hwheel, now) == 0U)
+      {
+        break;
+      }
+      now = TIMWHEEL_GetTime(hwheel);
+      continue;
+    }
+
+    /* Move the slot to the pending list, a callback may stop its timers */
+    hwheel->Now += delta;
+    hwheel->pPending = hwheel->pSlots[index];
+    hwheel->pSlots[index] = NULL;
+    hwheel->Bitmap[index / BSP_TIMWHEEL_SLOTS] &= ~(1UL << (index & TIMWHEEL_SLOT_MASK));
+    if (hwheel->pPending != NULL)
+    {
+      hwheel->pPending->ppPrev = &hwheel->pPending;
+    }
+    for (timer = hwheel->pPending; timer != NULL; timer = timer->pNext)
+    {
+      timer->Slot = TIMWHEEL_SLOT_PENDING;
+    }
+
+    while ((timer = hwheel->pPending) != NULL)
+    {
+      TIMWHEEL_Unlink(hwheel, timer);
+      if (index >= BSP_TIMWHEEL_SLOTS)
+      {
+        TIMWHEEL_Insert(hwheel, timer);
+        continue;
+      }
+
+      /* Level 0, the expiry is the time of the wheel */
+      if (timer->Period != 0U)
+      {
+        timer->Expiry += timer->Period;
+        TIMWHEEL_Insert(hwheel, timer);
+      }
+      __set_PRIMASK(primask_bit);
+      timer->Callback(timer);
+      __disable_irq();
+    }
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_TIM_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
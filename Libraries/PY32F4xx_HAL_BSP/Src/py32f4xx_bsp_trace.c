@@ -0,0 +1,315 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_trace.c
+  * @author  MCU Application Team
+  * @brief   SWO trace BSP service.
+  *          This file provides functions to trace the core on the SWO pin:
+  *           + TPIU, ITM and DWT set up for SWO in NRZ at a chosen rate
+  *           + Output on the ITM stimulus ports
+  *           + Periodic PC sampling, profiled on the host by
+  *             Misc/Tools/swoprofile.py
+  *           + Exception entry and exit trace
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Call BSP_TRACE_Init() with the SWO bit rate, a divider of HCLK: it
+       assigns the trace pin with HAL_DBGMCU_SetTracePinAssignment(), sets the
+       TPIU to NRZ with the formatter bypassed and enables the ITM with its
+       synchronization and the DWT packets. Set the same rate in the SWO
+       viewer of the probe. The TPIU sends at its rate even when no probe
+       listens, so the writers never block for long.
+
+   (#) BSP_TRACE_EnablePort() enables a stimulus port, BSP_TRACE_Write()
+       writes to it, by words then bytes, waiting for the ITM FIFO. It returns
+       0 at once when the ITM or the port is disabled. BSP_TRACE_Putchar()
+       writes to BSP_TRACE_PORT_STDOUT, to be called from __io_putchar() for
+       printf() on SWO. BSP_PROBE_ConfigITM() and BSP_LOG_ConfigITM() call
+       BSP_TRACE_Init() and enable their own port.
+
+   (#) BSP_TRACE_ConfigPcSampling() makes the DWT send the PC every Period
+       cycles: 64 to 1024 by 64, or 1024 to 16384 by 1024, 0 to stop. A sample
+       is 5 bytes, 50 bits in NRZ: at 144 MHz a period of 4096 cycles needs 1.8
+       Mbit/s of SWO, a shorter period loses samples in ITM overflows. The
+       firmware is not changed: the profile only needs BSP_TRACE_Init() and
+       this call, which may stay in a production image.
+
+   (#) BSP_TRACE_ConfigExceptions() makes the DWT send a packet on each
+       exception entry, exit and return, counted per exception by the host.
+
+   (#) On the host, Misc/Tools/swoprofile.py reads a raw SWO capture, or the
+       SWO pin on a serial port, and prints the flat profile of the functions
+       of the ELF, the sleep samples and the exception counts.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_trace.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TRACE BSP TRACE
+  * @brief SWO trace BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_TRACE_Private_Constants BSP TRACE Private Constants
+  * @{
+  */
+#define TRACE_ITM_UNLOCK          0xC5ACCE55U /*!< ITM lock access key */
+#define TRACE_TPIU_NRZ            2U          /*!< SPPR, asynchronous SWO in NRZ */
+#define TRACE_SYNCTAP_24          1U          /*!< Synchronization packet every 2^24 cycles */
+#define TRACE_TAP6_PERIOD         64U         /*!< POSTCNT tapped at CYCCNT bit 6 */
+#define TRACE_TAP10_PERIOD        1024U       /*!< POSTCNT tapped at CYCCNT bit 10 */
+#define TRACE_POSTPRESET_MAX      16U         /*!< POSTCNT reload + 1 */
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_TRACE_Private_Macros BSP TRACE Private Macros
+  * @{
+  */
+#define TRACE_PORT_ENABLED(__PORT__)    (((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0U) && \
+                                         ((ITM->TER & (1UL << (__PORT__))) != 0U))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TRACE_Exported_Functions BSP TRACE Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Assign the SWO pin and enable the TPIU, the ITM and the DWT packets.
+  * @note   The ports, the PC sampling and the exception trace already enabled are kept.
+  * @param  SwoHz SWO bit rate in NRZ, HCLK divided by 1 to 8192.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TRACE_Init(uint32_t SwoHz)
+{
+  uint32_t hclk = HAL_RCC_GetHCLKFreq();
+
+  if ((SwoHz == 0U) || (SwoHz > hclk) || ((hclk % SwoHz) != 0U) ||
+      (((hclk / SwoHz) - 1U) > TPIU_ACPR_PRESCALER_Msk))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_DBGMCU_SetTracePinAssignment(HAL_DBGMCU_TRACE_ASYNCH);
+  HAL_EnableCycleCounter();
+
+  /* SWO in NRZ, the formatter bypassed */
+  TPIU->SPPR = TRACE_TPIU_NRZ;
+  TPIU->ACPR = (hclk / SwoHz) - 1U;
+  TPIU->FFCR = TPIU_FFCR_TrigIn_Msk;
+
+  DWT->CTRL = (DWT->CTRL & ~DWT_CTRL_SYNCTAP_Msk) | (TRACE_SYNCTAP_24 << DWT_CTRL_SYNCTAP_Pos);
+
+  ITM->LAR = TRACE_ITM_UNLOCK;
+  ITM->TPR = 0U;
+  ITM->TCR = (ITM->TCR & ~ITM_TCR_TRACEBUSID_Msk) | ITM_TCR_ITMENA_Msk | ITM_TCR_SYNCENA_Msk |
+             ITM_TCR_DWTENA_Msk | (1UL << ITM_TCR_TRACEBUSID_Pos);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop the trace and release the SWO pin.
+  * @note   The cycle counter is left running for the other services.
+  * @retval None
+  */
+void BSP_TRACE_DeInit(void)
+{
+  DWT->CTRL &= ~(DWT_CTRL_PCSAMPLENA_Msk | DWT_CTRL_EXCTRCENA_Msk);
+
+  ITM->LAR = TRACE_ITM_UNLOCK;
+  ITM->TER = 0U;
+  ITM->TCR = 0U;
+
+  HAL_DBGMCU_SetTracePinAssignment(HAL_DBGMCU_TRACE_NONE);
+}
+
+/**
+  * @brief  Enable a stimulus port.
+  * @param  Port Stimulus port, 0 to BSP_TRACE_PORTS - 1.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TRACE_EnablePort(uint32_t Port)
+{
+  if (Port >= BSP_TRACE_PORTS)
+  {
+    return HAL_ERROR;
+  }
+
+  ITM->TER |= 1UL << Port;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable a stimulus port.
+  * @param  Port Stimulus port, 0 to BSP_TRACE_PORTS - 1.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TRACE_DisablePort(uint32_t Port)
+{
+  if (Port >= BSP_TRACE_PORTS)
+  {
+    return HAL_ERROR;
+  }
+
+  ITM->TER &= ~(1UL << Port);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start or stop the periodic PC sampling.
+  * @param  Period Cycles between samples, 64 to 1024 by 64 or 1024 to 16384 by 1024, 0 to stop.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TRACE_ConfigPcSampling(uint32_t Period)
+{
+  uint32_t tap;
+  uint32_t preset;
+
+  if (Period == 0U)
+  {
+    DWT->CTRL &= ~DWT_CTRL_PCSAMPLENA_Msk;
+    return HAL_OK;
+  }
+
+  if (((Period % TRACE_TAP6_PERIOD) == 0U) && (Period <= TRACE_TAP10_PERIOD))
+  {
+    tap    = 0U;
+    preset = (Period / TRACE_TAP6_PERIOD) - 1U;
+  }
+  else if (((Period % TRACE_TAP10_PERIOD) == 0U) && (Period <= BSP_TRACE_PC_PERIOD_MAX))
+  {
+    tap    = DWT_CTRL_CYCTAP_Msk;
+    preset = (Period / TRACE_TAP10_PERIOD) - 1U;
+  }
+  else
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  /* The counter of the samples is only written with the sampling stopped */
+  DWT->CTRL &= ~DWT_CTRL_PCSAMPLENA_Msk;
+  DWT->CTRL = (DWT->CTRL & ~(DWT_CTRL_CYCTAP_Msk | DWT_CTRL_POSTPRESET_Msk | DWT_CTRL_POSTINIT_Msk)) | tap |
+              (preset << DWT_CTRL_POSTPRESET_Pos) | (preset << DWT_CTRL_POSTINIT_Pos);
+  DWT->CTRL |= DWT_CTRL_PCSAMPLENA_Msk;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start or stop the exception trace.
+  * @param  NewState ENABLE to send a packet on each exception entry, exit and return.
+  * @retval None
+  */
+void BSP_TRACE_ConfigExceptions(FunctionalState NewState)
+{
+  if (NewState != DISABLE)
+  {
+    DWT->CTRL |= DWT_CTRL_EXCTRCENA_Msk;
+  }
+  else
+  {
+    DWT->CTRL &= ~DWT_CTRL_EXCTRCENA_Msk;
+  }
+}
+
+/**
+  * @brief  Write data to a stimulus port.
+  * @note   The data goes by words, then the last bytes one by one, each write
+  *         waiting for room in the ITM FIFO. Writers of different priorities
+  *         on the same port may interleave their words.
+  * @param  Port Stimulus port, 0 to BSP_TRACE_PORTS - 1.
+  * @param  pData Pointer to the data.
+  * @param  Length Number of bytes.
+  * @retval Number of bytes written, 0 when the ITM or the port is disabled
+  */
+uint32_t BSP_TRACE_Write(uint32_t Port, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t written = 0U;
+
+  if ((Port >= BSP_TRACE_PORTS) || !TRACE_PORT_ENABLED(Port))
+  {
+    return 0U;
+  }
+
+  while ((Length - written) >= 4U)
+  {
+    while (ITM->PORT[Port].u32 == 0U)
+    {
+    }
+    ITM->PORT[Port].u32 = __UNALIGNED_UINT32_READ(&pData[written]);
+    written += 4U;
+  }
+
+  while (written < Length)
+  {
+    while (ITM->PORT[Port].u32 == 0U)
+    {
+    }
+    ITM->PORT[Port].u8 = pData[written];
+    written++;
+  }
+
+  return written;
+}
+
+/**
+  * @brief  Write a character to the stimulus port BSP_TRACE_PORT_STDOUT.
+  * @note   To be called from __io_putchar() for printf() on SWO.
+  * @param  ch Character.
+  * @retval The character
+  */
+int BSP_TRACE_Putchar(int ch)
+{
+  uint8_t c = (uint8_t)ch;
+
+  (void)BSP_TRACE_Write(BSP_TRACE_PORT_STDOUT, &c, 1U);
+
+  return ch;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
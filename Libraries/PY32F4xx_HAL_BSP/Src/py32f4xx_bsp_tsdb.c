@@ -0,0 +1,689 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_tsdb.c
+  * @author  MCU Application Team
+  * @brief   Time series store BSP service.
+  *          This file stores the rows of the sensor logs by columns, in blocks
+  *          of a sector of a block device, the SD card or the ESMC and SPI
+  *          flashes:
+  *           + Delta of delta and zig-zag varint coding of each column
+  *           + Minimum and maximum of each column in the block header
+  *           + CRC of each block, sequence numbers to mount the ring
+  *           + Time window queries reading the blocks needed only
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) A row is Columns int32_t values, the time first, not decreasing from
+       a row to the next, ticks or seconds for example. The store packs the
+       rows in blocks of one sector of a BSP_BLKDEV, NbrOfSectors sectors
+       from FirstSector written as a ring, the oldest block replaced when
+       it is full.
+
+   (#) A block holds a BSP_TSDB_HeaderTypeDef, a BSP_TSDB_ColumnTypeDef per
+       column then the data of each column in turn: the first value, the
+       first difference then the differences of the differences, each
+       zig-zag coded in a little endian base 128 varint. A time sampled at
+       a constant rate and a slow sensor take one byte a row, a fourth of
+       the struct, a counter too. The CRC, of the hcrcsw given to
+       BSP_TSDB_Init(), covers the block from its Magic to its Size.
+
+   (#) BSP_TSDB_Init() takes a sector buffer, word aligned, and RowsMax rows
+       of Columns int32_t where the rows wait until a block is full, then
+       mounts the ring: a binary search on the sequence numbers finds the
+       newest block in a few reads. A block torn by a reset while written
+       is lost alone.
+
+   (#) BSP_TSDB_Append() adds a row, writing the block when the next row
+       would not fit or RowsMax rows wait. BSP_TSDB_Flush() writes the rows
+       waiting in a block of their own and synchronizes the device, before
+       a power down for example. The functions are blocking and must not be
+       called from interrupts.
+
+   (#) BSP_TSDB_Query() gives its callback the rows of a time window, from
+       the blocks then from the rows waiting: a binary search on the time
+       range of the blocks reads log2 of the ring blocks to find the first
+       one, and the blocks after the window are not read. A value filter on
+       a column skips the blocks whose range misses it without decoding
+       them. The callback must not append to the store.
+
+   (#) BSP_TSDB_GetStats() tells the density, RawBytes over StoredBytes,
+       and the blocks read and decoded by the queries.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "py32f4xx_bsp_tsdb.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TSDB BSP TSDB
+  * @brief Time series store BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_TSDB_Private_Macros BSP TSDB Private Macros
+  * @{
+  */
+#define TSDB_HEADER_SIZE(__COLUMNS__)   (sizeof(BSP_TSDB_HeaderTypeDef) + ((__COLUMNS__) * sizeof(BSP_TSDB_ColumnTypeDef)))
+#define TSDB_HEADER(__HTSDB__)          ((BSP_TSDB_HeaderTypeDef *)(__HTSDB__)->pBlock)
+#define TSDB_COLUMN(__HTSDB__)          ((BSP_TSDB_ColumnTypeDef *)(TSDB_HEADER(__HTSDB__) + 1))
+#define TSDB_ZIGZAG(__V__)              (((uint32_t)(__V__) << 1) ^ (uint32_t)((__V__) >> 31))
+#define TSDB_UNZIGZAG(__Z__)            ((int32_t)(((__Z__) >> 1) ^ (0U - ((__Z__) & 1U))))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TSDB_Private_Functions BSP TSDB Private Functions
+  * @{
+  */
+static uint32_t          TSDB_Residual(const BSP_TSDB_TypeDef *htsdb, uint32_t Row, uint32_t Column);
+static uint32_t          TSDB_RowBytes(const BSP_TSDB_TypeDef *htsdb, uint32_t Row);
+static uint32_t          TSDB_VarintSize(uint32_t Value);
+static HAL_StatusTypeDef TSDB_Seal(BSP_TSDB_TypeDef *htsdb);
+static HAL_StatusTypeDef TSDB_Load(BSP_TSDB_TypeDef *htsdb, uint32_t Slot, uint32_t *pValid);
+static HAL_StatusTypeDef TSDB_Mount(BSP_TSDB_TypeDef *htsdb);
+static uint32_t          TSDB_Match(const BSP_TSDB_QueryTypeDef *pQuery, const int32_t *pRow);
+static void              TSDB_Decode(BSP_TSDB_TypeDef *htsdb, const BSP_TSDB_QueryTypeDef *pQuery,
+                                     void (*pCallback)(void *pArg, const int32_t *pRow), void *pArg);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TSDB_Exported_Functions BSP TSDB Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a time series store and mount its ring.
+  * @param  htsdb Store.
+  * @param  hdev Block device, initialized.
+  * @param  hcrcsw CRC of the blocks, initialized, a 32-bit model preferably.
+  * @param  FirstSector First sector of the store.
+  * @param  NbrOfSectors Sectors of the store.
+  * @param  Columns Columns of a row, 1 to BSP_TSDB_COLUMNS_MAX, the time first.
+  * @param  pBlock A sector of the device, word aligned.
+  * @param  pRows RowsMax x Columns values.
+  * @param  RowsMax Rows of a block at most, up to 65535.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TSDB_Init(BSP_TSDB_TypeDef *htsdb, BSP_BLKDEV_TypeDef *hdev, BSP_CRC_TypeDef *hcrcsw,
+                                uint32_t FirstSector, uint32_t NbrOfSectors, uint32_t Columns,
+                                uint8_t *pBlock, int32_t *pRows, uint32_t RowsMax)
+{
+  if ((htsdb == NULL) || (hdev == NULL) || (hcrcsw == NULL) || (pBlock == NULL) || (pRows == NULL) ||
+      (Columns == 0U) || (Columns > BSP_TSDB_COLUMNS_MAX) || (RowsMax == 0U) || (RowsMax > 0xFFFFU) ||
+      (NbrOfSectors == 0U) || ((FirstSector + NbrOfSectors) > hdev->SectorCount) ||
+      (hdev->SectorSize > 0xFFFFU) || (hdev->SectorSize < (TSDB_HEADER_SIZE(Columns) + (5U * Columns))))
+  {
+    return HAL_ERROR;
+  }
+
+  htsdb->hdev         = hdev;
+  htsdb->hcrcsw       = hcrcsw;
+  htsdb->FirstSector  = FirstSector;
+  htsdb->NbrOfSectors = NbrOfSectors;
+  htsdb->Columns      = Columns;
+  htsdb->pBlock       = pBlock;
+  htsdb->pRows        = pRows;
+  htsdb->RowsMax      = RowsMax;
+  htsdb->Rows         = 0U;
+  htsdb->Bytes        = 0U;
+  memset(&htsdb->Stats, 0, sizeof(htsdb->Stats));
+
+  return TSDB_Mount(htsdb);
+}
+
+/**
+  * @brief  Append a row, writing a block when it is full.
+  * @param  htsdb Store.
+  * @param  pRow Columns values, the time first.
+  * @retval HAL status, the row not appended on an error
+  */
+HAL_StatusTypeDef BSP_TSDB_Append(BSP_TSDB_TypeDef *htsdb, const int32_t *pRow)
+{
+  uint32_t capacity = htsdb->hdev->SectorSize - TSDB_HEADER_SIZE(htsdb->Columns);
+  uint32_t bytes;
+
+  if (htsdb->Rows == htsdb->RowsMax)
+  {
+    if (TSDB_Seal(htsdb) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  memcpy(&htsdb->pRows[htsdb->Rows * htsdb->Columns], pRow, htsdb->Columns * sizeof(int32_t));
+  bytes = TSDB_RowBytes(htsdb, htsdb->Rows);
+
+  if ((htsdb->Bytes + bytes) > capacity)
+  {
+    if (TSDB_Seal(htsdb) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    memcpy(htsdb->pRows, pRow, htsdb->Columns * sizeof(int32_t));
+    bytes = TSDB_RowBytes(htsdb, 0U);
+  }
+
+  htsdb->Rows++;
+  htsdb->Bytes += bytes;
+  htsdb->Stats.RowsWritten++;
+  htsdb->Stats.RawBytes += htsdb->Columns * sizeof(int32_t);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Write the rows waiting in a block and synchronize the device.
+  * @param  htsdb Store.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TSDB_Flush(BSP_TSDB_TypeDef *htsdb)
+{
+  if (TSDB_Seal(htsdb) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return BSP_BLKDEV_Sync(htsdb->hdev);
+}
+
+/**
+  * @brief  Give the rows of a time window, oldest first, to a callback.
+  * @param  htsdb Store.
+  * @param  pQuery Time window and value filter.
+  * @param  pCallback Called with each row kept.
+  * @param  pArg First argument of the callback.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TSDB_Query(BSP_TSDB_TypeDef *htsdb, const BSP_TSDB_QueryTypeDef *pQuery,
+                                 void (*pCallback)(void *pArg, const int32_t *pRow), void *pArg)
+{
+  const BSP_TSDB_ColumnTypeDef *column = TSDB_COLUMN(htsdb);
+  uint32_t low = 0U;
+  uint32_t high = htsdb->Count;
+  uint32_t middle;
+  uint32_t valid;
+  uint32_t row;
+
+  if ((pQuery == NULL) || (pCallback == NULL) ||
+      ((pQuery->Column != BSP_TSDB_NO_COLUMN) && (pQuery->Column >= htsdb->Columns)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* First block ending at Start or later, the blocks in time order from the oldest */
+  while (low < high)
+  {
+    middle = low + ((high - low) / 2U);
+    if (TSDB_Load(htsdb, (htsdb->Oldest + middle) % htsdb->NbrOfSectors, &valid) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    if ((valid != 0U) && (column[0].Max >= pQuery->Start))
+    {
+      high = middle;
+    }
+    else
+    {
+      low = middle + 1U;
+    }
+  }
+
+  for (; low < htsdb->Count; low++)
+  {
+    if (TSDB_Load(htsdb, (htsdb->Oldest + low) % htsdb->NbrOfSectors, &valid) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    if (valid == 0U)
+    {
+      continue;
+    }
+    if (column[0].Min > pQuery->End)
+    {
+      break;
+    }
+    if ((pQuery->Column != BSP_TSDB_NO_COLUMN) &&
+        ((column[pQuery->Column].Max < pQuery->Low) || (column[pQuery->Column].Min > pQuery->High)))
+    {
+      continue;
+    }
+    TSDB_Decode(htsdb, pQuery, pCallback, pArg);
+  }
+
+  for (row = 0U; row < htsdb->Rows; row++)
+  {
+    if (TSDB_Match(pQuery, &htsdb->pRows[row * htsdb->Columns]) != 0U)
+    {
+      pCallback(pArg, &htsdb->pRows[row * htsdb->Columns]);
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the statistics of a store.
+  * @param  htsdb Store.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_TSDB_GetStats(const BSP_TSDB_TypeDef *htsdb, BSP_TSDB_StatsTypeDef *pStats)
+{
+  *pStats = htsdb->Stats;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TSDB_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Zig-zag coded value of a row of a column waiting, the first value, the first
+  *         difference or a difference of differences.
+  * @param  htsdb Store.
+  * @param  Row Row in the rows waiting.
+  * @param  Column Column.
+  * @retval Zig-zag coded value
+  */
+static uint32_t TSDB_Residual(const BSP_TSDB_TypeDef *htsdb, uint32_t Row, uint32_t Column)
+{
+  const int32_t *value = &htsdb->pRows[(Row * htsdb->Columns) + Column];
+  uint32_t delta;
+
+  if (Row == 0U)
+  {
+    return TSDB_ZIGZAG(value[0]);
+  }
+
+  delta = (uint32_t)value[0] - (uint32_t)value[-(int32_t)htsdb->Columns];
+  if (Row >= 2U)
+  {
+    delta -= (uint32_t)value[-(int32_t)htsdb->Columns] - (uint32_t)value[-2 * (int32_t)htsdb->Columns];
+  }
+
+  return TSDB_ZIGZAG((int32_t)delta);
+}
+
+/**
+  * @brief  Bytes of the columns of a row waiting.
+  * @param  htsdb Store.
+  * @param  Row Row in the rows waiting.
+  * @retval Bytes
+  */
+static uint32_t TSDB_RowBytes(const BSP_TSDB_TypeDef *htsdb, uint32_t Row)
+{
+  uint32_t bytes = 0U;
+  uint32_t column;
+
+  for (column = 0U; column < htsdb->Columns; column++)
+  {
+    bytes += TSDB_VarintSize(TSDB_Residual(htsdb, Row, column));
+  }
+
+  return bytes;
+}
+
+/**
+  * @brief  Bytes of a varint.
+  * @param  Value Value.
+  * @retval 1 to 5
+  */
+static uint32_t TSDB_VarintSize(uint32_t Value)
+{
+  uint32_t size = 1U;
+
+  while (Value >= 0x80U)
+  {
+    Value >>= 7;
+    size++;
+  }
+
+  return size;
+}
+
+/**
+  * @brief  Write the rows waiting in a block at the head of the ring.
+  * @param  htsdb Store.
+  * @retval HAL status, the rows kept waiting on an error
+  */
+static HAL_StatusTypeDef TSDB_Seal(BSP_TSDB_TypeDef *htsdb)
+{
+  BSP_TSDB_HeaderTypeDef *header = TSDB_HEADER(htsdb);
+  BSP_TSDB_ColumnTypeDef *column = TSDB_COLUMN(htsdb);
+  uint32_t size = TSDB_HEADER_SIZE(htsdb->Columns);
+  uint32_t col;
+  uint32_t row;
+  uint32_t value;
+  int32_t sample;
+
+  if (htsdb->Rows == 0U)
+  {
+    return HAL_OK;
+  }
+
+  memset(htsdb->pBlock, 0, htsdb->hdev->SectorSize);
+
+  for (col = 0U; col < htsdb->Columns; col++)
+  {
+    column[col].Min    = htsdb->pRows[col];
+    column[col].Max    = htsdb->pRows[col];
+    column[col].Offset = (uint16_t)size;
+
+    for (row = 0U; row < htsdb->Rows; row++)
+    {
+      sample = htsdb->pRows[(row * htsdb->Columns) + col];
+      if (sample < column[col].Min)
+      {
+        column[col].Min = sample;
+      }
+      if (sample > column[col].Max)
+      {
+        column[col].Max = sample;
+      }
+
+      value = TSDB_Residual(htsdb, row, col);
+      while (value >= 0x80U)
+      {
+        htsdb->pBlock[size++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+      }
+      htsdb->pBlock[size++] = (uint8_t)value;
+    }
+
+    column[col].Length = (uint16_t)(size - column[col].Offset);
+  }
+
+  header->Magic    = BSP_TSDB_MAGIC;
+  header->Sequence = htsdb->Sequence;
+  header->Rows     = (uint16_t)htsdb->Rows;
+  header->Size     = (uint16_t)size;
+  header->Columns  = (uint8_t)htsdb->Columns;
+  header->Version  = BSP_TSDB_VERSION;
+  if (BSP_CRC_Compute(htsdb->hcrcsw, &htsdb->pBlock[4], size - 4U, &value) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  header->Crc = value;
+
+  if (BSP_BLKDEV_Write(htsdb->hdev, htsdb->pBlock, htsdb->FirstSector + htsdb->Head, 1U) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  htsdb->Stats.BlocksWritten++;
+  htsdb->Stats.StoredBytes += size;
+
+  /* The oldest block replaced once the ring is full */
+  htsdb->Sequence++;
+  htsdb->Head = (htsdb->Head + 1U) % htsdb->NbrOfSectors;
+  if (htsdb->Count < htsdb->NbrOfSectors)
+  {
+    htsdb->Count++;
+  }
+  if (htsdb->Count == htsdb->NbrOfSectors)
+  {
+    htsdb->Oldest = htsdb->Head;
+  }
+  htsdb->Rows  = 0U;
+  htsdb->Bytes = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read a block of the ring into the sector buffer and check it.
+  * @param  htsdb Store.
+  * @param  Slot Sector of the ring.
+  * @param  pValid 1 for a block of the store with a right CRC, 0 otherwise.
+  * @retval HAL status of the device
+  */
+static HAL_StatusTypeDef TSDB_Load(BSP_TSDB_TypeDef *htsdb, uint32_t Slot, uint32_t *pValid)
+{
+  const BSP_TSDB_HeaderTypeDef *header = TSDB_HEADER(htsdb);
+  uint32_t crc;
+
+  *pValid = 0U;
+
+  if (BSP_BLKDEV_Read(htsdb->hdev, htsdb->pBlock, htsdb->FirstSector + Slot, 1U) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  htsdb->Stats.BlocksRead++;
+
+  if ((header->Magic != BSP_TSDB_MAGIC) || (header->Version != BSP_TSDB_VERSION) ||
+      (header->Columns != htsdb->Columns) || (header->Rows == 0U) ||
+      (header->Size < TSDB_HEADER_SIZE(htsdb->Columns)) || (header->Size > htsdb->hdev->SectorSize))
+  {
+    return HAL_OK;
+  }
+
+  if ((BSP_CRC_Compute(htsdb->hcrcsw, &htsdb->pBlock[4], header->Size - 4U, &crc) != HAL_OK) ||
+      (crc != header->Crc))
+  {
+    htsdb->Stats.CrcErrors++;
+    return HAL_OK;
+  }
+
+  *pValid = 1U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Find the head and the oldest block of the ring from the sequence numbers.
+  * @note   The blocks from sector 0 to the head follow each other, the ones after it are
+  *         from the lap before.
+  * @param  htsdb Store.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef TSDB_Mount(BSP_TSDB_TypeDef *htsdb)
+{
+  uint32_t count = htsdb->NbrOfSectors;
+  uint32_t first;
+  uint32_t low;
+  uint32_t high;
+  uint32_t middle;
+  uint32_t valid;
+
+  htsdb->Head     = 0U;
+  htsdb->Oldest   = 0U;
+  htsdb->Count    = 0U;
+  htsdb->Sequence = 0U;
+
+  if (TSDB_Load(htsdb, 0U, &valid) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  if (valid == 0U)
+  {
+    /* Sector 0 empty, or torn in a later lap: the newest block is then the last sector */
+    if ((count < 2U) || (TSDB_Load(htsdb, count - 1U, &valid) != HAL_OK) || (valid == 0U))
+    {
+      return HAL_OK;
+    }
+    htsdb->Sequence = TSDB_HEADER(htsdb)->Sequence + 1U;
+    htsdb->Oldest   = 1U;
+    htsdb->Count    = count - 1U;
+    return HAL_OK;
+  }
+
+  /* First sector not following sector 0, the head */
+  first = TSDB_HEADER(htsdb)->Sequence;
+  low   = 1U;
+  high  = count;
+  while (low < high)
+  {
+    middle = low + ((high - low) / 2U);
+    if (TSDB_Load(htsdb, middle, &valid) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    if ((valid != 0U) && (TSDB_HEADER(htsdb)->Sequence == (first + middle)))
+    {
+      low = middle + 1U;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  htsdb->Head     = low % count;
+  htsdb->Sequence = first + low;
+  htsdb->Count    = low;
+
+  /* The lap before, after the head or after a block torn at the head */
+  for (middle = low; (middle < count) && (middle <= (low + 1U)); middle++)
+  {
+    if (TSDB_Load(htsdb, middle, &valid) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    if ((valid != 0U) && (TSDB_HEADER(htsdb)->Sequence == (first + middle - count)))
+    {
+      htsdb->Oldest = middle;
+      htsdb->Count  = count - (middle - low);
+      break;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Check a row against a query.
+  * @param  pQuery Query.
+  * @param  pRow Row.
+  * @retval 1 for a row kept, 0 otherwise
+  */
+static uint32_t TSDB_Match(const BSP_TSDB_QueryTypeDef *pQuery, const int32_t *pRow)
+{
+  if ((pRow[0] < pQuery->Start) || (pRow[0] > pQuery->End))
+  {
+    return 0U;
+  }
+
+  if ((pQuery->Column != BSP_TSDB_NO_COLUMN) &&
+      ((pRow[pQuery->Column] < pQuery->Low) || (pRow[pQuery->Column] > pQuery->High)))
+  {
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+  * @brief  Decode the block in the sector buffer, row by row, and give the rows kept to a callback.
+  * @param  htsdb Store.
+  * @param  pQuery Query.
+  * @param  pCallback Callback.
+  * @param  pArg First argument of the callback.
+  * @retval None
+  */
+static void TSDB_Decode(BSP_TSDB_TypeDef *htsdb, const BSP_TSDB_QueryTypeDef *pQuery,
+                        void (*pCallback)(void *pArg, const int32_t *pRow), void *pArg)
+{
+  const BSP_TSDB_HeaderTypeDef *header = TSDB_HEADER(htsdb);
+  const BSP_TSDB_ColumnTypeDef *column = TSDB_COLUMN(htsdb);
+  uint32_t position[BSP_TSDB_COLUMNS_MAX];
+  uint32_t end[BSP_TSDB_COLUMNS_MAX];
+  int32_t  delta[BSP_TSDB_COLUMNS_MAX];
+  int32_t  row[BSP_TSDB_COLUMNS_MAX];
+  uint32_t col;
+  uint32_t index;
+  uint32_t value;
+  uint32_t shift;
+  uint8_t  byte;
+
+  for (col = 0U; col < htsdb->Columns; col++)
+  {
+    position[col] = column[col].Offset;
+    end[col]      = (uint32_t)column[col].Offset + column[col].Length;
+    if (end[col] > header->Size)
+    {
+      return;
+    }
+  }
+
+  htsdb->Stats.BlocksDecoded++;
+
+  for (index = 0U; index < header->Rows; index++)
+  {
+    for (col = 0U; col < htsdb->Columns; col++)
+    {
+      value = 0U;
+      shift = 0U;
+      do
+      {
+        if ((position[col] >= end[col]) || (shift > 28U))
+        {
+          return;
+        }
+        byte = htsdb->pBlock[position[col]++];
+        value |= (uint32_t)(byte & 0x7FU) << shift;
+        shift += 7U;
+      } while ((byte & 0x80U) != 0U);
+
+      if (index == 0U)
+      {
+        row[col] = TSDB_UNZIGZAG(value);
+      }
+      else
+      {
+        delta[col] = (index == 1U) ? TSDB_UNZIGZAG(value)
+                                   : (int32_t)((uint32_t)delta[col] + (uint32_t)TSDB_UNZIGZAG(value));
+        row[col]   = (int32_t)((uint32_t)row[col] + (uint32_t)delta[col]);
+      }
+    }
+
+    if (TSDB_Match(pQuery, row) != 0U)
+    {
+      pCallback(pArg, row);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,381 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_ttcan.c
+  * @author  MCU Application Team
+  * @brief   CANFD time-triggered schedule BSP service.
+  *          This file provides functions to run a TTCAN (ISO 11898-4) matrix
+  *          cycle from a table:
+  *           + Triggers armed one after the other from the trigger interrupt
+  *           + Messages loaded one trigger ahead of their slot
+  *           + Basic cycles of the matrix, per entry base cycle and repeat
+  *           + Period jitter, missed trigger and load error statistics
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) The CANFD holds one trigger at a time: HAL_CANFD_TT_ActivateTrigRequest()
+       arms it for a time of the cycle, counted from the reference message,
+       and HAL_CANFD_TT_AddMessageToFifo() loads the message of a transmit
+       buffer slot. This service walks a schedule table and arms each next
+       trigger from the interrupt of the previous one.
+
+   (#) Describe the matrix cycle with an array of BSP_TTCAN_EntryTypeDef in
+       the order of their time: the cycle time, the trigger type, the slot
+       and the message of a transmit trigger, and the basic cycles of the
+       entry, used in the cycles where the cycle number modulo Repeat is
+       BaseCycle. An entry of Repeat 1 is used in all the cycles. Two
+       transmit entries following each other use different slots: the next
+       message is loaded while the previous one is sent.
+
+   (#) Start the CANFD with HAL_CANFD_Start(), configure the time-triggered
+       mode with HAL_CANFD_TT_Config(), then call BSP_TTCAN_Init() and
+       BSP_TTCAN_Start() with the basic cycle to start from. The trigger
+       interrupt is enabled.
+
+   (#) Call BSP_TTCAN_TrigHandler() from the HAL trigger callbacks of the
+       types used, HAL_CANFD_TT_TxSingleTrigCallback() and the others, and
+       BSP_TTCAN_TrigErrorHandler() from HAL_CANFD_TT_TrigErrorCallback():
+       a trigger armed after its time is counted as missed and the next
+       entry is armed. BSP_TTCAN_SyncCycle() sets the basic cycle, from the
+       cycle count of a received reference message for instance.
+
+   (#) The payload of an entry is read when it is loaded, one trigger ahead:
+       update it before, the message sent is the one of the time it was
+       loaded. A message not loaded because its slot is still full is
+       counted in LoadErrors, the previous content is sent again.
+
+   (#) BSP_TTCAN_GetStats() gives the triggers, the basic cycles, the missed
+       triggers and the load errors. The DWT cycle counter times the
+       triggers of entry 0: give it Repeat 1, PeriodMax - PeriodMin is the
+       jitter of the basic cycle seen by the CPU.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_ttcan.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_TTCAN BSP TTCAN
+  * @brief CANFD time-triggered schedule BSP service
+  * @{
+  */
+
+#if defined (HAL_CANFD_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/** @defgroup BSP_TTCAN_Private_Macros BSP TTCAN Private Macros
+  * @{
+  */
+#define TTCAN_IS_TX(__TYPE__)           (((__TYPE__) == CANFD_TT_TX_SINGLE_TRIG) || ((__TYPE__) == CANFD_TT_TX_START_TRIG))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_TTCAN_Private_Functions BSP TTCAN Private Functions
+  * @{
+  */
+static void TTCAN_Next(BSP_TTCAN_TypeDef *htt);
+static void TTCAN_Arm(BSP_TTCAN_TypeDef *htt);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_TTCAN_Exported_Functions BSP TTCAN Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize a TTCAN schedule.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @param  hcanfd CANFD handle.
+  * @param  pEntries Entries, in the order of their time, kept by the handle.
+  * @param  NbrOfEntries Entries.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TTCAN_Init(BSP_TTCAN_TypeDef *htt, CANFD_HandleTypeDef *hcanfd,
+                                 const BSP_TTCAN_EntryTypeDef *pEntries, uint32_t NbrOfEntries)
+{
+  const BSP_TTCAN_EntryTypeDef *entry;
+  uint32_t i;
+
+  if ((htt == NULL) || (hcanfd == NULL) || (pEntries == NULL) || (NbrOfEntries == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0U; i < NbrOfEntries; i++)
+  {
+    entry = &pEntries[i];
+    if ((entry->Time > 0xFFFFU) || ((i != 0U) && (entry->Time <= pEntries[i - 1U].Time)) ||
+        (entry->Repeat == 0U) || (entry->Repeat > BSP_TTCAN_CYCLES) ||
+        ((entry->Repeat & (entry->Repeat - 1U)) != 0U) || (entry->BaseCycle >= entry->Repeat) ||
+        ((entry->TriggerType != CANFD_TT_RX_TIME_TRIG) && (entry->TriggerType != CANFD_TT_TX_SINGLE_TRIG) &&
+         (entry->TriggerType != CANFD_TT_TX_START_TRIG) && (entry->TriggerType != CANFD_TT_TX_STOP_TRIG)) ||
+        (entry->Slot >= BSP_TTCAN_SLOTS) ||
+        (TTCAN_IS_TX(entry->TriggerType) && (entry->pHeader == NULL)))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  if (htt->State == BSP_TTCAN_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  htt->hcanfd       = hcanfd;
+  htt->pEntries     = pEntries;
+  htt->NbrOfEntries = NbrOfEntries;
+  htt->Index        = 0U;
+  htt->Cycle        = 0U;
+  htt->State        = BSP_TTCAN_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Arm the first trigger of a basic cycle and enable the trigger interrupt.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @param  Cycle Basic cycle to start from, below BSP_TTCAN_CYCLES.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TTCAN_Start(BSP_TTCAN_TypeDef *htt, uint32_t Cycle)
+{
+  uint32_t primask_bit;
+
+  if (Cycle >= BSP_TTCAN_CYCLES)
+  {
+    return HAL_ERROR;
+  }
+
+  if (htt->State != BSP_TTCAN_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  HAL_EnableCycleCounter();
+
+  if (HAL_CANFD_ActivateNotification(htt->hcanfd, CANFD_IT_TRIGGER_COMPLETE) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  /* From the last entry of the cycle before, the next one is the first of Cycle */
+  htt->Index = htt->NbrOfEntries - 1U;
+  htt->Cycle = (Cycle + BSP_TTCAN_CYCLES - 1U) % BSP_TTCAN_CYCLES;
+  TTCAN_Next(htt);
+  htt->Stamp = 0U;
+  htt->Stats.Triggers   = 0U;
+  htt->Stats.Cycles     = 0U;
+  htt->Stats.Missed     = 0U;
+  htt->Stats.LoadErrors = 0U;
+  htt->Stats.PeriodMin  = 0xFFFFFFFFU;
+  htt->Stats.PeriodMax  = 0U;
+  htt->State = BSP_TTCAN_STATE_RUN;
+  TTCAN_Arm(htt);
+
+  __set_PRIMASK(primask_bit);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Disable the trigger interrupt, no further trigger armed.
+  * @note   The trigger already armed still fires.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_TTCAN_Stop(BSP_TTCAN_TypeDef *htt)
+{
+  if (htt->State != BSP_TTCAN_STATE_RUN)
+  {
+    return HAL_BUSY;
+  }
+
+  (void)HAL_CANFD_DeactivateNotification(htt->hcanfd, CANFD_IT_TRIGGER_COMPLETE);
+  htt->State = BSP_TTCAN_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Set the basic cycle of the next trigger.
+  * @note   The trigger armed is kept, the entries are taken from Cycle after it.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @param  Cycle Basic cycle, below BSP_TTCAN_CYCLES.
+  * @retval None
+  */
+void BSP_TTCAN_SyncCycle(BSP_TTCAN_TypeDef *htt, uint32_t Cycle)
+{
+  htt->Cycle = Cycle % BSP_TTCAN_CYCLES;
+}
+
+/**
+  * @brief  Trigger completed: arm the next entry, its message loaded.
+  * @note   Call it from the HAL_CANFD_TT_xxxTrigCallback() of the trigger types used.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @retval None
+  */
+void BSP_TTCAN_TrigHandler(BSP_TTCAN_TypeDef *htt)
+{
+  uint32_t stamp = DWT->CYCCNT;
+  uint32_t period;
+
+  if (htt->State != BSP_TTCAN_STATE_RUN)
+  {
+    return;
+  }
+
+  htt->Stats.Triggers++;
+  if (htt->Index == 0U)
+  {
+    if (htt->Stamp != 0U)
+    {
+      period = stamp - htt->Stamp;
+      if (period < htt->Stats.PeriodMin)
+      {
+        htt->Stats.PeriodMin = period;
+      }
+      if (period > htt->Stats.PeriodMax)
+      {
+        htt->Stats.PeriodMax = period;
+      }
+    }
+    htt->Stamp = (stamp != 0U) ? stamp : 1U;
+  }
+
+  TTCAN_Next(htt);
+  TTCAN_Arm(htt);
+}
+
+/**
+  * @brief  Trigger error: the trigger missed, the next entry armed.
+  * @note   Call it from HAL_CANFD_TT_TrigErrorCallback().
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @retval None
+  */
+void BSP_TTCAN_TrigErrorHandler(BSP_TTCAN_TypeDef *htt)
+{
+  if (htt->State != BSP_TTCAN_STATE_RUN)
+  {
+    return;
+  }
+
+  htt->Stats.Missed++;
+  TTCAN_Next(htt);
+  TTCAN_Arm(htt);
+}
+
+/**
+  * @brief  Copy the statistics.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @param  pStats Statistics.
+  * @retval None
+  */
+void BSP_TTCAN_GetStats(const BSP_TTCAN_TypeDef *htt, BSP_TTCAN_StatsTypeDef *pStats)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *pStats = htt->Stats;
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_TTCAN_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Move to the next entry used, the basic cycle counted on the wrap.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @retval None
+  */
+static void TTCAN_Next(BSP_TTCAN_TypeDef *htt)
+{
+  const BSP_TTCAN_EntryTypeDef *entry;
+  uint32_t steps;
+
+  /* Each entry is used in one basic cycle of BSP_TTCAN_CYCLES at least */
+  for (steps = 0U; steps < (htt->NbrOfEntries * BSP_TTCAN_CYCLES); steps++)
+  {
+    htt->Index++;
+    if (htt->Index >= htt->NbrOfEntries)
+    {
+      htt->Index = 0U;
+      htt->Cycle = (htt->Cycle + 1U) % BSP_TTCAN_CYCLES;
+      htt->Stats.Cycles++;
+    }
+    entry = &htt->pEntries[htt->Index];
+    if ((htt->Cycle & (entry->Repeat - 1U)) == entry->BaseCycle)
+    {
+      return;
+    }
+  }
+}
+
+/**
+  * @brief  Load the message of the current entry and arm its trigger.
+  * @param  htt Pointer to a BSP_TTCAN_TypeDef structure.
+  * @retval None
+  */
+static void TTCAN_Arm(BSP_TTCAN_TypeDef *htt)
+{
+  const BSP_TTCAN_EntryTypeDef *entry = &htt->pEntries[htt->Index];
+
+  if (TTCAN_IS_TX(entry->TriggerType))
+  {
+    if (HAL_CANFD_TT_AddMessageToFifo(htt->hcanfd, (CANFD_TxHeaderTypeDef *)entry->pHeader,
+                                      (uint8_t *)entry->pData, entry->Slot) != HAL_OK)
+    {
+      htt->Stats.LoadErrors++;
+    }
+  }
+  (void)HAL_CANFD_TT_ActivateTrigRequest(htt->hcanfd, entry->TriggerType, entry->Time, entry->Slot);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CANFD_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
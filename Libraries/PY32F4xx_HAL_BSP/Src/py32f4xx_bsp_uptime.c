@@ -0,0 +1,371 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_uptime.c
+  * @author  MCU Application Team
+  * @brief   RTC uptime clock BSP service.
+  *          This file provides functions to read a monotonic 64-bit time:
+  *           + RTC counter and divider, running in STOP mode and kept over
+  *             a reset with the backup domain
+  *           + Counter overflows kept in a backup register
+  *           + DWT cycle counter interpolation inside an RTC clock cycle
+  *           + Reads without lock from any context
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) HAL_GetTick() starts again from 0 on each reset, stops in STOP mode
+       and wraps after 49 days. The RTC counter runs from the LSE in all
+       modes but STANDBY without VBAT, and over a reset: this service reads
+       it with its divider, to one RTC clock cycle, 30.5 us from the LSE.
+
+   (#) Enable the backup domain access, clock the RTC and initialize it with
+       HAL_RTC_Init(), as for the tickless idle. The counter is then no
+       calendar, HAL_RTC_SetTime() would move the time. Call
+       BSP_UPTIME_Init() with the RTC clock frequency and enable RTC_IRQn in
+       the NVIC, its handler calls BSP_UPTIME_IRQHandler(). The overflows
+       of the 32-bit counter, one in 48 days at 1024 Hz, are counted in the
+       BSP_UPTIME_BKP_EPOCH backup register: Epoch is bits 63:32 of the
+       count, kept over the reset with the counter.
+
+   (#) BSP_UPTIME_GetCycles() gives the RTC clock cycles since the counter
+       started, BSP_UPTIME_GetNs() and BSP_UPTIME_GetUs() the time. The
+       reads take no lock and never wait on another context: Epoch and the
+       edge are updated interrupts disabled, a read done again when Seq
+       changed under it. They are safe from any interrupt handler.
+
+   (#) BSP_UPTIME_EnableInterp() enables the RTC second interrupt, each
+       counter increment, and stamps it with the DWT cycle counter: the time
+       inside the RTC clock cycle then comes from the CPU clock, to some
+       ns. The interpolation stays within the RTC clock cycle read, the
+       time keeps the RTC accuracy and never goes back. Without the stamp
+       of the current count, after a STOP or with interrupts disabled, the
+       read falls back to the RTC alone. The second interrupt wakes the
+       CPU from SLEEP at the counter frequency: keep the interpolation off
+       with the tickless idle on a fast counter.
+
+   (#) After a STOP, the RTC registers read the entry values up to their
+       resynchronization, clear RSF and wait for it as BSP_TICKLESS_Idle()
+       does: the time holds meanwhile.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_uptime.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_UPTIME BSP UPTIME
+  * @brief RTC uptime clock BSP service
+  * @{
+  */
+
+#if defined (HAL_RTC_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_UPTIME_Private_Types BSP UPTIME Private Types
+  * @{
+  */
+typedef struct
+{
+  uint64_t                Count;        /* Counter with the overflows                           */
+  uint32_t                Sub;          /* RTC clock cycles since the counter increment         */
+  uint32_t                Cycles;       /* DWT cycles since the edge stamp, with Edge           */
+  uint32_t                Edge;         /* 1 when the edge stamp is of this count               */
+} UPTIME_SampleTypeDef;
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_UPTIME_Private_Constants BSP UPTIME Private Constants
+  * @{
+  */
+#define UPTIME_NS_PER_S                 1000000000U
+/**
+  * @}
+  */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_UPTIME_Private_Functions BSP UPTIME Private Functions
+  * @{
+  */
+static void     UPTIME_Sample(const BSP_UPTIME_TypeDef *hup, UPTIME_SampleTypeDef *pSample);
+static uint64_t UPTIME_ToNs(const BSP_UPTIME_TypeDef *hup, uint64_t Cycles);
+static void     UPTIME_Overflow(BSP_UPTIME_TypeDef *hup);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_UPTIME_Exported_Functions BSP UPTIME Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Start the uptime clock on an initialized RTC.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @param  hrtc RTC handle, HAL_RTC_Init() done.
+  * @param  RtcClock RTC kernel clock in Hz.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_UPTIME_Init(BSP_UPTIME_TypeDef *hup, RTC_HandleTypeDef *hrtc, uint32_t RtcClock)
+{
+  if ((hup == NULL) || (hrtc == NULL) || (RtcClock == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hrtc->State != HAL_RTC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  hup->hrtc      = hrtc;
+  hup->RtcClock  = RtcClock;
+  hup->Prescaler = (hrtc->Init.AsynchPrediv == RTC_AUTO_1_SECOND) ? RtcClock : (hrtc->Init.AsynchPrediv + 1U);
+  hup->Epoch     = HAL_RTCEx_BKUPRead(hrtc, BSP_UPTIME_BKP_EPOCH);
+  hup->Seq       = 0U;
+  hup->CountEdge = 0U;
+  hup->CycleEdge = 0U;
+  hup->Interp    = 0U;
+
+  /* An overflow while the service did not run */
+  if ((hrtc->Instance->CRL & RTC_CRL_OWF) != 0U)
+  {
+    UPTIME_Overflow(hup);
+  }
+  __HAL_RTC_OVERFLOW_ENABLE_IT(hrtc, RTC_IT_OW);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Interpolate the RTC with the DWT cycle counter.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval None
+  */
+void BSP_UPTIME_EnableInterp(BSP_UPTIME_TypeDef *hup)
+{
+  HAL_EnableCycleCounter();
+
+  hup->Interp = 1U;
+  CLEAR_BIT(hup->hrtc->Instance->CRL, RTC_CRL_SECF);
+  __HAL_RTC_SECOND_ENABLE_IT(hup->hrtc, RTC_IT_SEC);
+}
+
+/**
+  * @brief  Read the RTC alone, the second interrupt disabled.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval None
+  */
+void BSP_UPTIME_DisableInterp(BSP_UPTIME_TypeDef *hup)
+{
+  __HAL_RTC_SECOND_DISABLE_IT(hup->hrtc, RTC_IT_SEC);
+  hup->Interp = 0U;
+}
+
+/**
+  * @brief  Get the RTC clock cycles since the counter started.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval RTC clock cycles
+  */
+uint64_t BSP_UPTIME_GetCycles(const BSP_UPTIME_TypeDef *hup)
+{
+  UPTIME_SampleTypeDef sample;
+
+  UPTIME_Sample(hup, &sample);
+
+  return (sample.Count * hup->Prescaler) + sample.Sub;
+}
+
+/**
+  * @brief  Get the time since the counter started.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval Time in ns
+  */
+uint64_t BSP_UPTIME_GetNs(const BSP_UPTIME_TypeDef *hup)
+{
+  UPTIME_SampleTypeDef sample;
+  uint64_t base;
+  uint64_t low;
+  uint64_t high;
+  uint64_t fine;
+
+  UPTIME_Sample(hup, &sample);
+
+  base = UPTIME_ToNs(hup, sample.Count * hup->Prescaler);
+  low  = ((uint64_t)sample.Sub * UPTIME_NS_PER_S) / hup->RtcClock;
+  if ((sample.Edge == 0U) || (SystemCoreClock == 0U))
+  {
+    return base + low;
+  }
+
+  /* The CPU clock inside the RTC clock cycle read */
+  high = ((((uint64_t)sample.Sub + 1U) * UPTIME_NS_PER_S) / hup->RtcClock) - 1U;
+  fine = ((uint64_t)sample.Cycles * UPTIME_NS_PER_S) / SystemCoreClock;
+  fine = (fine < low) ? low : ((fine > high) ? high : fine);
+
+  return base + fine;
+}
+
+/**
+  * @brief  Get the time since the counter started.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval Time in us
+  */
+uint64_t BSP_UPTIME_GetUs(const BSP_UPTIME_TypeDef *hup)
+{
+  return BSP_UPTIME_GetNs(hup) / 1000U;
+}
+
+/**
+  * @brief  Handle the RTC second and overflow interrupts, from RTC_IRQHandler().
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval None
+  */
+void BSP_UPTIME_IRQHandler(BSP_UPTIME_TypeDef *hup)
+{
+  RTC_TypeDef *rtc = hup->hrtc->Instance;
+  uint32_t cycle = DWT->CYCCNT;
+  uint32_t primask_bit;
+
+  if ((rtc->CRL & RTC_CRL_SECF) != 0U)
+  {
+    /* Not __HAL_RTC_SECOND_CLEAR_FLAG(), its write sets CNF */
+    CLEAR_BIT(rtc->CRL, RTC_CRL_SECF);
+    if (hup->Interp != 0U)
+    {
+      primask_bit = __get_PRIMASK();
+      __disable_irq();
+      hup->CountEdge = ((rtc->CNTH & RTC_CNTH_RTC_CNT) << 16) | (rtc->CNTL & RTC_CNTL_RTC_CNT);
+      hup->CycleEdge = cycle;
+      hup->Seq++;
+      __set_PRIMASK(primask_bit);
+    }
+  }
+
+  if ((rtc->CRL & RTC_CRL_OWF) != 0U)
+  {
+    UPTIME_Overflow(hup);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_UPTIME_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Read the counter, the divider and the edge stamp together.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @param  pSample Sample read.
+  * @retval None
+  */
+static void UPTIME_Sample(const BSP_UPTIME_TypeDef *hup, UPTIME_SampleTypeDef *pSample)
+{
+  RTC_TypeDef *rtc = hup->hrtc->Instance;
+  uint32_t seq;
+  uint32_t epoch;
+  uint32_t high;
+  uint32_t low;
+  uint32_t div;
+  uint32_t owf;
+  uint32_t cycle;
+  uint32_t edge;
+
+  /* Again when an update ran or the counter moved during the reads */
+  do
+  {
+    seq   = hup->Seq;
+    epoch = hup->Epoch;
+    cycle = DWT->CYCCNT;
+    high  = rtc->CNTH & RTC_CNTH_RTC_CNT;
+    low   = rtc->CNTL & RTC_CNTL_RTC_CNT;
+    div   = ((rtc->DIVH & RTC_DIVH_DIV) << 16) | (rtc->DIVL & RTC_DIVL_DIV);
+    owf   = rtc->CRL & RTC_CRL_OWF;
+    edge  = hup->CountEdge;
+    cycle = cycle - hup->CycleEdge;
+  } while ((seq != hup->Seq) || (high != (rtc->CNTH & RTC_CNTH_RTC_CNT)) ||
+           (low != (rtc->CNTL & RTC_CNTL_RTC_CNT)));
+
+  low = (high << 16) | low;
+
+  /* Overflow pending, interrupts disabled or of a higher priority */
+  if ((owf != 0U) && (low < 0x80000000U))
+  {
+    epoch++;
+  }
+
+  pSample->Count  = ((uint64_t)epoch << 32) | low;
+  pSample->Sub    = (div < hup->Prescaler) ? (hup->Prescaler - 1U - div) : 0U;
+  pSample->Cycles = cycle;
+  pSample->Edge   = ((hup->Interp != 0U) && (edge == low) && (seq != 0U)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Convert RTC clock cycles to ns without overflow.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @param  Cycles RTC clock cycles.
+  * @retval Time in ns
+  */
+static uint64_t UPTIME_ToNs(const BSP_UPTIME_TypeDef *hup, uint64_t Cycles)
+{
+  return ((Cycles / hup->RtcClock) * UPTIME_NS_PER_S) +
+         (((Cycles % hup->RtcClock) * UPTIME_NS_PER_S) / hup->RtcClock);
+}
+
+/**
+  * @brief  Count a counter overflow, in RAM and in the backup register.
+  * @param  hup Pointer to a BSP_UPTIME_TypeDef structure.
+  * @retval None
+  */
+static void UPTIME_Overflow(BSP_UPTIME_TypeDef *hup)
+{
+  uint32_t primask_bit = __get_PRIMASK();
+
+  /* Epoch and the flag change together for the reads of any priority */
+  __disable_irq();
+  CLEAR_BIT(hup->hrtc->Instance->CRL, RTC_CRL_OWF);
+  hup->Epoch++;
+  hup->Seq++;
+  __set_PRIMASK(primask_bit);
+
+  HAL_RTCEx_BKUPWrite(hup->hrtc, BSP_UPTIME_BKP_EPOCH, hup->Epoch);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_RTC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,450 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_vio.c
+  * @author  MCU Application Team
+  * @brief   CMSIS VIO on GPIO BSP service.
+  *          This file provides the cmsis_vio.h functions over the GPIO ports,
+  *          for status LEDs, buttons and test pins:
+  *           + vioSetSignal() in one BSRR write per port
+  *           + vioGetSignal() in one IDR read per port
+  *           + Signals without a pin kept in memory, for the debugger
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Build with USE_BSP=y USE_VIO=y, defining USE_BSP_VIO and adding
+       cmsis_vio.h of Libraries/CMSIS/Driver/VIO/Include. USE_VIO=memory
+       builds vio_memory.c of CMSIS instead, all signals in memory: the
+       debugger reads vioSignalOut and writes vioSignalIn, with the
+       cmsis_vio.scvd view for instance.
+
+   (#) Configure the pins with HAL_GPIO_Init(), then call vioInit() and
+       BSP_VIO_AddOutput() and BSP_VIO_AddInput() per port, with the pins,
+       the pins active low and the signals they carry. The pins are matched
+       to the signals in ascending order, bit by bit: LED0 to LED3 on PB12
+       to PB15 are BSP_VIO_AddOutput(GPIOB, GPIO_PIN_12 | GPIO_PIN_13 |
+       GPIO_PIN_14 | GPIO_PIN_15, 0U, vioLED0 | vioLED1 | vioLED2 | vioLED3).
+       An output is driven to its inactive level when added.
+
+   (#) vioSetSignal() sets and clears the pins of the mask on each port in a
+       single BSRR write, without read-modify-write: it is safe from any
+       interrupt, and a set of signals on a port changes at once. Pins in
+       the order of the signals with a constant offset, as above, are mapped
+       by a shift, other orders by a loop on the pins.
+
+   (#) vioGetSignal() reads the IDR of the ports holding signals of the mask,
+       the signals without a pin come from vioSignalIn. vioSetValue() and
+       vioGetValue() hold BSP_VIO_VALUE_NUM values in vioValue.
+
+   (#) vioSignalOut mirrors the outputs for the debugger: calls from
+       several contexts may leave it behind the pins, not the pins
+       themselves.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_bsp_vio.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_VIO BSP VIO
+  * @brief CMSIS VIO on GPIO BSP service
+  * @{
+  */
+
+#if defined (USE_BSP_VIO) && defined (HAL_GPIO_MODULE_ENABLED)
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup BSP_VIO_Private_Types BSP VIO Private Types
+  * @{
+  */
+
+/**
+  * @brief  Signals of a port
+  */
+typedef struct
+{
+  GPIO_TypeDef            *GPIOx;       /*!< GPIO port                                              */
+
+  uint32_t                Pins;         /*!< Pins carrying signals                                  */
+
+  uint32_t                Signals;      /*!< Signals carried, as many bits as Pins                  */
+
+  uint32_t                Invert;       /*!< Pins active low                                        */
+
+  int32_t                 Shift;        /*!< Pins = Signals << Shift, VIO_NO_SHIFT when not linear  */
+
+  uint8_t                 Signal[16];   /*!< Signal bit of each pin, when not linear                */
+
+} VIO_PortTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private define ------------------------------------------------------------*/
+/** @defgroup BSP_VIO_Private_Constants BSP VIO Private Constants
+  * @{
+  */
+#define VIO_NO_SHIFT              0x7FFFFFFF    /*!< Shift of the ports mapped bit by bit */
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_VIO_Private_Variables BSP VIO Private Variables
+  * @{
+  */
+static VIO_PortTypeDef VIO_Outputs[BSP_VIO_PORTS];
+static VIO_PortTypeDef VIO_Inputs[BSP_VIO_PORTS];
+static uint32_t        VIO_NbOutputs;
+static uint32_t        VIO_NbInputs;
+/**
+  * @}
+  */
+
+/* Exported variables --------------------------------------------------------*/
+/** @defgroup BSP_VIO_Exported_Variables BSP VIO Exported Variables
+  * @brief    Memory of the signals and values, names of the CMSIS templates
+  * @{
+  */
+__USED uint32_t vioSignalIn;                     /*!< Input signals, read or written by the debugger  */
+__USED uint32_t vioSignalOut;                    /*!< Output signals, read by the debugger            */
+__USED int32_t  vioValue[BSP_VIO_VALUE_NUM];     /*!< Values of vioSetValue() and vioGetValue()        */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup BSP_VIO_Private_Functions BSP VIO Private Functions
+  * @{
+  */
+static HAL_StatusTypeDef VIO_AddPort(VIO_PortTypeDef *pPorts, uint32_t *pNbPorts, GPIO_TypeDef *GPIOx,
+                                     uint32_t Pins, uint32_t ActiveLow, uint32_t Signals);
+static uint32_t          VIO_ToPins(const VIO_PortTypeDef *pport, uint32_t Signals);
+static uint32_t          VIO_ToSignals(const VIO_PortTypeDef *pport, uint32_t Pins);
+static uint32_t          VIO_BitCount(uint32_t Value);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_VIO_Exported_Functions BSP VIO Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Add the outputs of a port, driven to their inactive level.
+  * @param  GPIOx GPIO port, the pins configured as outputs.
+  * @param  Pins Pins of the signals, any combination of GPIO_PIN_x.
+  * @param  ActiveLow Pins on at the low level, a combination of GPIO_PIN_x of Pins.
+  * @param  Signals Signals carried by Pins, in the same order, as many bits.
+  * @retval HAL status, HAL_BUSY when BSP_VIO_PORTS ports are added
+  */
+HAL_StatusTypeDef BSP_VIO_AddOutput(GPIO_TypeDef *GPIOx, uint32_t Pins, uint32_t ActiveLow, uint32_t Signals)
+{
+  HAL_StatusTypeDef status;
+
+  status = VIO_AddPort(VIO_Outputs, &VIO_NbOutputs, GPIOx, Pins, ActiveLow, Signals);
+  if (status == HAL_OK)
+  {
+    vioSignalOut &= ~Signals;
+    /* Active low pins set, the others reset */
+    GPIOx->BSRR = (ActiveLow & Pins) | ((Pins & ~ActiveLow) << 16U);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Add the inputs of a port.
+  * @param  GPIOx GPIO port, the pins configured as inputs.
+  * @param  Pins Pins of the signals, any combination of GPIO_PIN_x.
+  * @param  ActiveLow Pins active at the low level, a combination of GPIO_PIN_x of Pins.
+  * @param  Signals Signals carried by Pins, in the same order, as many bits.
+  * @retval HAL status, HAL_BUSY when BSP_VIO_PORTS ports are added
+  */
+HAL_StatusTypeDef BSP_VIO_AddInput(GPIO_TypeDef *GPIOx, uint32_t Pins, uint32_t ActiveLow, uint32_t Signals)
+{
+  return VIO_AddPort(VIO_Inputs, &VIO_NbInputs, GPIOx, Pins, ActiveLow, Signals);
+}
+
+/**
+  * @brief  Initialize the signals and values, removing the ports.
+  * @retval None
+  */
+void vioInit(void)
+{
+  uint32_t index;
+
+  VIO_NbOutputs = 0U;
+  VIO_NbInputs  = 0U;
+
+  vioSignalIn  = 0U;
+  vioSignalOut = 0U;
+  for (index = 0U; index < BSP_VIO_VALUE_NUM; index++)
+  {
+    vioValue[index] = 0;
+  }
+}
+
+/**
+  * @brief  Set output signals.
+  * @param  mask Signals to change.
+  * @param  signal Signal values, 1 on.
+  * @retval None
+  */
+void vioSetSignal(uint32_t mask, uint32_t signal)
+{
+  const VIO_PortTypeDef *pport;
+  uint32_t port;
+  uint32_t pins;
+  uint32_t high;
+
+  vioSignalOut = (vioSignalOut & ~mask) | (mask & signal);
+
+  for (port = 0U; port < VIO_NbOutputs; port++)
+  {
+    pport = &VIO_Outputs[port];
+    if ((mask & pport->Signals) == 0U)
+    {
+      continue;
+    }
+
+    pins = VIO_ToPins(pport, mask);
+    high = (VIO_ToPins(pport, mask & signal) ^ pport->Invert) & pins;
+    pport->GPIOx->BSRR = high | ((pins & ~high) << 16U);
+  }
+}
+
+/**
+  * @brief  Get input signals.
+  * @param  mask Signals to read.
+  * @retval Signal values, 1 active
+  */
+uint32_t vioGetSignal(uint32_t mask)
+{
+  const VIO_PortTypeDef *pport;
+  uint32_t port;
+  uint32_t signal = vioSignalIn;
+
+  for (port = 0U; port < VIO_NbInputs; port++)
+  {
+    pport = &VIO_Inputs[port];
+    if ((mask & pport->Signals) == 0U)
+    {
+      continue;
+    }
+
+    signal = (signal & ~pport->Signals) |
+             VIO_ToSignals(pport, (pport->GPIOx->IDR ^ pport->Invert) & pport->Pins);
+  }
+  vioSignalIn = signal;
+
+  return signal & mask;
+}
+
+/**
+  * @brief  Set a value.
+  * @param  id Value index, below BSP_VIO_VALUE_NUM.
+  * @param  value Value.
+  * @retval None
+  */
+void vioSetValue(uint32_t id, int32_t value)
+{
+  if (id < BSP_VIO_VALUE_NUM)
+  {
+    vioValue[id] = value;
+  }
+}
+
+/**
+  * @brief  Get a value.
+  * @param  id Value index, below BSP_VIO_VALUE_NUM.
+  * @retval Value, 0 for an index out of range
+  */
+int32_t vioGetValue(uint32_t id)
+{
+  return (id < BSP_VIO_VALUE_NUM) ? vioValue[id] : 0;
+}
+
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @addtogroup BSP_VIO_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Add a port to a table, finding its mapping.
+  * @param  pPorts Table of the ports.
+  * @param  pNbPorts Ports in the table.
+  * @param  GPIOx GPIO port.
+  * @param  Pins Pins of the signals.
+  * @param  ActiveLow Pins active at the low level.
+  * @param  Signals Signals carried by Pins.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef VIO_AddPort(VIO_PortTypeDef *pPorts, uint32_t *pNbPorts, GPIO_TypeDef *GPIOx,
+                                     uint32_t Pins, uint32_t ActiveLow, uint32_t Signals)
+{
+  VIO_PortTypeDef *pport;
+  uint32_t pin;
+  uint32_t bit;
+  int32_t shift;
+
+  if ((GPIOx == NULL) || (Pins == 0U) || ((Pins & ~GPIO_PIN_MASK) != 0U) ||
+      (VIO_BitCount(Pins) != VIO_BitCount(Signals)))
+  {
+    return HAL_ERROR;
+  }
+  if (*pNbPorts >= BSP_VIO_PORTS)
+  {
+    return HAL_BUSY;
+  }
+
+  pport = &pPorts[*pNbPorts];
+  pport->GPIOx   = GPIOx;
+  pport->Pins    = Pins;
+  pport->Signals = Signals;
+  pport->Invert  = ActiveLow & Pins;
+
+  /* Linear when the pins are the signals shifted, the usual LED row */
+  shift = (int32_t)__CLZ(__RBIT(Pins)) - (int32_t)__CLZ(__RBIT(Signals));
+  if (((shift >= 0) && ((Signals << (uint32_t)shift) == Pins)) ||
+      ((shift < 0) && ((Signals >> (uint32_t)(-shift)) == Pins)))
+  {
+    pport->Shift = shift;
+  }
+  else
+  {
+    pport->Shift = VIO_NO_SHIFT;
+    bit = 0U;
+    for (pin = 0U; pin < 16U; pin++)
+    {
+      if ((Pins & (1UL << pin)) != 0U)
+      {
+        while ((Signals & (1UL << bit)) == 0U)
+        {
+          bit++;
+        }
+        pport->Signal[pin] = (uint8_t)bit;
+        bit++;
+      }
+    }
+  }
+  (*pNbPorts)++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Map signals to the pins of a port.
+  * @param  pport Port.
+  * @param  Signals Signals, bits out of the port ignored.
+  * @retval Pins
+  */
+static uint32_t VIO_ToPins(const VIO_PortTypeDef *pport, uint32_t Signals)
+{
+  uint32_t pins = 0U;
+  uint32_t rest;
+  uint32_t pin;
+
+  if (pport->Shift != VIO_NO_SHIFT)
+  {
+    return ((pport->Shift >= 0) ? (Signals << (uint32_t)pport->Shift) :
+                                  (Signals >> (uint32_t)(-pport->Shift))) & pport->Pins;
+  }
+
+  rest = pport->Pins;
+  while (rest != 0U)
+  {
+    pin   = __CLZ(__RBIT(rest));
+    rest &= rest - 1U;
+    if ((Signals & (1UL << pport->Signal[pin])) != 0U)
+    {
+      pins |= 1UL << pin;
+    }
+  }
+
+  return pins;
+}
+
+/**
+  * @brief  Map pins of a port to their signals.
+  * @param  pport Port.
+  * @param  Pins Pins, within the pins of the port.
+  * @retval Signals
+  */
+static uint32_t VIO_ToSignals(const VIO_PortTypeDef *pport, uint32_t Pins)
+{
+  uint32_t signals = 0U;
+  uint32_t pin;
+
+  if (pport->Shift != VIO_NO_SHIFT)
+  {
+    return (pport->Shift >= 0) ? (Pins >> (uint32_t)pport->Shift) : (Pins << (uint32_t)(-pport->Shift));
+  }
+
+  while (Pins != 0U)
+  {
+    pin   = __CLZ(__RBIT(Pins));
+    Pins &= Pins - 1U;
+    signals |= 1UL << pport->Signal[pin];
+  }
+
+  return signals;
+}
+
+/**
+  * @brief  Count the bits set in a word.
+  * @param  Value Word.
+  * @retval Bits set
+  */
+static uint32_t VIO_BitCount(uint32_t Value)
+{
+  uint32_t count = 0U;
+
+  while (Value != 0U)
+  {
+    Value &= Value - 1U;
+    count++;
+  }
+
+  return count;
+}
+
+/**
+  * @}
+  */
+
+#endif /* USE_BSP_VIO && HAL_GPIO_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
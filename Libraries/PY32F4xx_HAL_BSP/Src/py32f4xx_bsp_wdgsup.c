@@ -0,0 +1,405 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_bsp_wdgsup.c
+  * @author  MCU Application Team
+  * @brief   Watchdog supervisor BSP service.
+  *          This file provides functions to feed the watchdogs only while
+  *          every task is alive:
+  *           + Heartbeats of tasks and interrupt handlers, each with a deadline
+  *           + IWDG and WWDG refreshed only when no task is late
+  *           + Stalled tasks found by the WWDG early wakeup interrupt and
+  *             recorded before the reset
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this service #####
+  ==============================================================================
+  [..]
+   (#) Call BSP_WDGSUP_Init(), then BSP_WDGSUP_AttachIwdg() and or
+       BSP_WDGSUP_AttachWwdg() with the watchdogs initialized by
+       HAL_IWDG_Init() and HAL_WWDG_Init(). The supervisor is then the only
+       one to refresh them.
+
+   (#) BSP_WDGSUP_Register() gives a task, a loop of the application or an
+       interrupt handler, an ID and a deadline in ms. The task calls
+       BSP_WDGSUP_Heartbeat() with its ID at least once per deadline; a
+       heartbeat is a few stores, safe from any interrupt priority.
+       BSP_WDGSUP_SetDeadline() with 0 pauses the supervision of a task, for
+       instance before it waits on an event without timeout.
+
+   (#) Call BSP_WDGSUP_Process() from the main loop, more often than the
+       shortest watchdog period. It returns the mask of the tasks late, bit n
+       for the task n. With none late it refreshes the IWDG, and the WWDG once
+       its counter is below the window, never too early. With a task late it
+       stops refreshing them and calls BSP_WDGSUP_StallCallback() once.
+
+   (#) The WWDG also catches BSP_WDGSUP_Process() itself no longer running.
+       Attach it with WWDG_EWI_ENABLE and its interrupt enabled in the NVIC:
+       when USE_HAL_WWDG_REGISTER_CALLBACKS is 0, call BSP_WDGSUP_EwiCallback()
+       from HAL_WWDG_EarlyWakeupCallback(), otherwise it is registered by
+       BSP_WDGSUP_AttachWwdg(). The early wakeup, one WWDG tick before the
+       reset, calls BSP_WDGSUP_StallCallback() with the late tasks, or
+       BSP_WDGSUP_STALLED_PROCESS when none is late.
+
+   (#) BSP_WDGSUP_StallCallback() records the stalled tasks with
+       BSP_FAULT_Reset(BSP_FAULT_TYPE_WATCHDOG, Stalled) and resets at once:
+       the reset does not wait for the IWDG timeout and BSP_FAULT_GetRecord()
+       names the tasks on the next boot. Redefine it to recover a task
+       instead. BSP_WDGSUP_Print() prints the deadline and the longest gap
+       between two heartbeats of each task, to size the deadlines.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "py32f4xx_bsp_wdgsup.h"
+#include "py32f4xx_bsp_fault.h"
+
+/** @addtogroup PY32F4xx_HAL_BSP
+  * @{
+  */
+
+/** @defgroup BSP_WDGSUP BSP WDGSUP
+  * @brief Watchdog supervisor BSP service
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup BSP_WDGSUP_Private_Variables BSP WDGSUP Private Variables
+  * @{
+  */
+static BSP_WDGSUP_TaskTypeDef WDGSUP_Tasks[BSP_WDGSUP_TASKS];
+static uint32_t WDGSUP_NbTasks;
+static __IO uint32_t WDGSUP_Stalled;
+#if defined (HAL_IWDG_MODULE_ENABLED)
+static IWDG_HandleTypeDef *WDGSUP_Iwdg;
+#endif /* HAL_IWDG_MODULE_ENABLED */
+#if defined (HAL_WWDG_MODULE_ENABLED)
+static WWDG_HandleTypeDef *WDGSUP_Wwdg;
+#endif /* HAL_WWDG_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup BSP_WDGSUP_Private_Functions
+  * @{
+  */
+static uint32_t WDGSUP_Late(uint32_t Now);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup BSP_WDGSUP_Exported_Functions BSP WDGSUP Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Initialize the supervisor, without task nor watchdog.
+  * @retval None
+  */
+void BSP_WDGSUP_Init(void)
+{
+  WDGSUP_NbTasks = 0U;
+  WDGSUP_Stalled = 0U;
+#if defined (HAL_IWDG_MODULE_ENABLED)
+  WDGSUP_Iwdg = NULL;
+#endif /* HAL_IWDG_MODULE_ENABLED */
+#if defined (HAL_WWDG_MODULE_ENABLED)
+  WDGSUP_Wwdg = NULL;
+#endif /* HAL_WWDG_MODULE_ENABLED */
+}
+
+#if defined (HAL_IWDG_MODULE_ENABLED)
+/**
+  * @brief  Refresh the IWDG from the supervisor.
+  * @param  hiwdg Pointer to an IWDG_HandleTypeDef structure, initialized by HAL_IWDG_Init().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_WDGSUP_AttachIwdg(IWDG_HandleTypeDef *hiwdg)
+{
+  if (hiwdg == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  WDGSUP_Iwdg = hiwdg;
+
+  return HAL_IWDG_Refresh(hiwdg);
+}
+#endif /* HAL_IWDG_MODULE_ENABLED */
+
+#if defined (HAL_WWDG_MODULE_ENABLED)
+/**
+  * @brief  Refresh the WWDG from the supervisor and catch its early wakeup.
+  * @param  hwwdg Pointer to a WWDG_HandleTypeDef structure, initialized by HAL_WWDG_Init().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_WDGSUP_AttachWwdg(WWDG_HandleTypeDef *hwwdg)
+{
+  if (hwwdg == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+#if (USE_HAL_WWDG_REGISTER_CALLBACKS == 1)
+  if (HAL_WWDG_RegisterCallback(hwwdg, HAL_WWDG_EWI_CB_ID, BSP_WDGSUP_EwiCallback) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_WWDG_REGISTER_CALLBACKS */
+
+  WDGSUP_Wwdg = hwwdg;
+
+  return HAL_OK;
+}
+#endif /* HAL_WWDG_MODULE_ENABLED */
+
+/**
+  * @brief  Register a task, its deadline counted from now.
+  * @param  pName Task name, a string constant kept by reference, or NULL.
+  * @param  Deadline Milliseconds allowed between heartbeats, 0 to start paused.
+  * @param  pId Returns the ID of the task, for BSP_WDGSUP_Heartbeat().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_WDGSUP_Register(const char *pName, uint32_t Deadline, uint32_t *pId)
+{
+  BSP_WDGSUP_TaskTypeDef *task;
+
+  if ((pId == NULL) || (WDGSUP_NbTasks >= BSP_WDGSUP_TASKS) || (WDGSUP_NbTasks >= 31U))
+  {
+    return HAL_ERROR;
+  }
+
+  task = &WDGSUP_Tasks[WDGSUP_NbTasks];
+  task->pName    = pName;
+  task->Last     = HAL_GetTick();
+  task->Beats    = 0U;
+  task->MaxGap   = 0U;
+  task->Deadline = Deadline;
+
+  /* Checked by the supervisor once the task is complete */
+  __DMB();
+  *pId = WDGSUP_NbTasks;
+  WDGSUP_NbTasks++;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Change the deadline of a task, counted from now.
+  * @param  Id ID of the task.
+  * @param  Deadline Milliseconds allowed between heartbeats, 0 to pause the supervision.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef BSP_WDGSUP_SetDeadline(uint32_t Id, uint32_t Deadline)
+{
+  if (Id >= WDGSUP_NbTasks)
+  {
+    return HAL_ERROR;
+  }
+
+  WDGSUP_Tasks[Id].Last     = HAL_GetTick();
+  WDGSUP_Tasks[Id].Deadline = Deadline;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Heartbeat of a task.
+  * @note   Safe from interrupt handlers of any priority.
+  * @param  Id ID of the task.
+  * @retval None
+  */
+void BSP_WDGSUP_Heartbeat(uint32_t Id)
+{
+  BSP_WDGSUP_TaskTypeDef *task;
+  uint32_t now = HAL_GetTick();
+  uint32_t gap;
+
+  if (Id >= WDGSUP_NbTasks)
+  {
+    return;
+  }
+
+  task = &WDGSUP_Tasks[Id];
+  gap  = now - task->Last;
+  if ((task->Deadline != 0U) && (gap > task->MaxGap))
+  {
+    task->MaxGap = gap;
+  }
+  task->Last = now;
+  task->Beats++;
+}
+
+/**
+  * @brief  Check the tasks and refresh the watchdogs when none is late.
+  * @note   Call from the main loop, more often than the shortest watchdog period.
+  * @retval Mask of the tasks late, bit n for the task n
+  */
+uint32_t BSP_WDGSUP_Process(void)
+{
+  uint32_t late = WDGSUP_Late(HAL_GetTick());
+
+  if (late != 0U)
+  {
+    /* The watchdogs are left to expire, the callback may reset before */
+    if (WDGSUP_Stalled == 0U)
+    {
+      WDGSUP_Stalled = late;
+      BSP_WDGSUP_StallCallback(late);
+    }
+    return late;
+  }
+  WDGSUP_Stalled = 0U;
+
+#if defined (HAL_IWDG_MODULE_ENABLED)
+  if (WDGSUP_Iwdg != NULL)
+  {
+    (void)HAL_IWDG_Refresh(WDGSUP_Iwdg);
+  }
+#endif /* HAL_IWDG_MODULE_ENABLED */
+
+#if defined (HAL_WWDG_MODULE_ENABLED)
+  /* A refresh above the window resets the device */
+  if ((WDGSUP_Wwdg != NULL) && ((WDGSUP_Wwdg->Instance->CR & WWDG_CR_T) < WDGSUP_Wwdg->Init.Window))
+  {
+    (void)HAL_WWDG_Refresh(WDGSUP_Wwdg);
+  }
+#endif /* HAL_WWDG_MODULE_ENABLED */
+
+  return 0U;
+}
+
+/**
+  * @brief  Return the tasks found late by the last BSP_WDGSUP_Process(), 0 when all are alive.
+  * @retval Mask of the tasks, bit n for the task n
+  */
+uint32_t BSP_WDGSUP_GetStalled(void)
+{
+  return WDGSUP_Stalled;
+}
+
+/**
+  * @brief  Return a task, its statistics.
+  * @param  Id ID of the task.
+  * @retval Pointer to the task, NULL if not registered
+  */
+const BSP_WDGSUP_TaskTypeDef *BSP_WDGSUP_GetTask(uint32_t Id)
+{
+  return (Id < WDGSUP_NbTasks) ? &WDGSUP_Tasks[Id] : NULL;
+}
+
+/**
+  * @brief  Print the deadline, the longest gap and the heartbeats of each task.
+  * @retval None
+  */
+void BSP_WDGSUP_Print(void)
+{
+  const BSP_WDGSUP_TaskTypeDef *task;
+  uint32_t id;
+
+  printf("%-3s %-16s %10s %10s %10s\r\n", "id", "task", "deadline", "max gap", "beats");
+  for (id = 0U; id < WDGSUP_NbTasks; id++)
+  {
+    task = &WDGSUP_Tasks[id];
+    printf("%-3lu %-16s %7lu ms %7lu ms %10lu%s\r\n", id, (task->pName != NULL) ? task->pName : "-",
+           task->Deadline, task->MaxGap, task->Beats, (task->Deadline == 0U) ? "  paused" : "");
+  }
+}
+
+#if defined (HAL_WWDG_MODULE_ENABLED)
+/**
+  * @brief  WWDG early wakeup handler of the supervisor.
+  * @note   To be called from HAL_WWDG_EarlyWakeupCallback() when
+  *         USE_HAL_WWDG_REGISTER_CALLBACKS is 0. The WWDG resets one tick later.
+  * @param  hwwdg Pointer to a WWDG_HandleTypeDef structure.
+  * @retval None
+  */
+void BSP_WDGSUP_EwiCallback(WWDG_HandleTypeDef *hwwdg)
+{
+  uint32_t late;
+
+  if (hwwdg != WDGSUP_Wwdg)
+  {
+    return;
+  }
+
+  late = WDGSUP_Late(HAL_GetTick());
+  WDGSUP_Stalled = (late != 0U) ? late : BSP_WDGSUP_STALLED_PROCESS;
+  BSP_WDGSUP_StallCallback(WDGSUP_Stalled);
+}
+#endif /* HAL_WWDG_MODULE_ENABLED */
+
+/**
+  * @brief  Tasks stalled callback, from BSP_WDGSUP_Process() or the WWDG early wakeup.
+  * @note   Records the tasks with BSP_FAULT_Reset() and resets at once.
+  * @param  Stalled Mask of the tasks late, bit n for the task n, or BSP_WDGSUP_STALLED_PROCESS.
+  * @retval None
+  */
+__weak void BSP_WDGSUP_StallCallback(uint32_t Stalled)
+{
+  BSP_FAULT_Reset(BSP_FAULT_TYPE_WATCHDOG, Stalled);
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup BSP_WDGSUP_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Find the tasks late.
+  * @param  Now HAL_GetTick() of the check.
+  * @retval Mask of the tasks, bit n for the task n
+  */
+static uint32_t WDGSUP_Late(uint32_t Now)
+{
+  uint32_t late = 0U;
+  uint32_t deadline;
+  uint32_t id;
+
+  for (id = 0U; id < WDGSUP_NbTasks; id++)
+  {
+    deadline = WDGSUP_Tasks[id].Deadline;
+    if ((deadline != 0U) && ((Now - WDGSUP_Tasks[id].Last) > deadline))
+    {
+      late |= 1UL << id;
+    }
+  }
+
+  return late;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
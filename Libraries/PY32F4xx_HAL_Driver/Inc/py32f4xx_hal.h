@@ -58,6 +58,26 @@ typedef enum
 /**
   * @}
   */
+
+/** @defgroup HAL_WAIT_STRATEGY Wait Strategy
+  * @brief    Values of USE_HAL_WAIT_STRATEGY
+  * @{
+  */
+#define HAL_WAIT_SPIN                   0U             /*!< Timeout loops spin                        */
+#define HAL_WAIT_WFE                    1U             /*!< WFE, woken by any interrupt pending       */
+#define HAL_WAIT_CALLBACK               2U             /*!< HAL_WaitCallback(), an RTOS yield         */
+/**
+  * @}
+  */
+
+#if !defined (USE_HAL_WAIT_STRATEGY)
+#define USE_HAL_WAIT_STRATEGY           HAL_WAIT_SPIN
+#endif
+
+#if !defined (HAL_WAIT_SPIN_TIME)
+#define HAL_WAIT_SPIN_TIME              2U             /*!< ms a timeout loop spins before HAL_Wait()
+                                                            waits                                     */
+#endif
 /**
   * @}
   */
@@ -68,6 +88,7 @@ typedef enum
 /** @addtogroup HAL_Exported_Variables
   * @{
   */
+extern __IO uint32_t uwTick;
 extern uint32_t uwTickPrio;
 extern HAL_TickFreqTypeDef uwTickFreq;
 /**
@@ -157,6 +178,16 @@ extern HAL_TickFreqTypeDef uwTickFreq;
   * @{
   */
 
+/** @brief  Wait in a timeout loop started at __TICKSTART__, as USE_HAL_WAIT_STRATEGY.
+  * @param  __TICKSTART__ HAL_GetTick() at the start of the loop.
+  * @retval None
+  */
+#if (USE_HAL_WAIT_STRATEGY != HAL_WAIT_SPIN)
+#define __HAL_WAIT(__TICKSTART__)       HAL_Wait(__TICKSTART__)
+#else
+#define __HAL_WAIT(__TICKSTART__)       ((void)(__TICKSTART__))
+#endif
+
 /** @defgroup DBGMCU_Freeze_Unfreeze Freeze Unfreeze Peripherals in Debug mode
   * @brief   Freeze/Unfreeze Peripherals in Debug mode
   * Note: On devices PY32F4xx
@@ -497,6 +528,18 @@ HAL_StatusTypeDef HAL_SetTickFreq(HAL_TickFreqTypeDef Freq);
 HAL_TickFreqTypeDef HAL_GetTickFreq(void);
 void HAL_SuspendTick(void);
 void HAL_ResumeTick(void);
+void HAL_EnableCycleCounter(void);
+uint32_t HAL_GetCycles(void);
+uint32_t HAL_UsToCycles(uint32_t Us);
+uint32_t HAL_CyclesToUs(uint32_t Cycles);
+void HAL_DelayUs(uint32_t Delay);
+void HAL_DelayNs(uint32_t Delay);
+#if (USE_HAL_WAIT_STRATEGY != HAL_WAIT_SPIN)
+void HAL_Wait(uint32_t Tickstart);
+#endif
+#if (USE_HAL_WAIT_STRATEGY == HAL_WAIT_CALLBACK)
+void HAL_WaitCallback(void);
+#endif
 uint32_t HAL_GetHalVersion(void);
 uint32_t HAL_GetREVID(void);
 uint32_t HAL_GetDEVID(void);
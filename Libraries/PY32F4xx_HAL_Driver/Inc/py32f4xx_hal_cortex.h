@@ -112,6 +112,19 @@ typedef struct
   * @}
   */
 
+#if (__FPU_PRESENT == 1U)
+/** @defgroup CORTEX_FPU_Context CORTEX FPU Context preservation of the exceptions
+  * @{
+  */
+#define FPU_CONTEXT_NONE               0x00000000U                                   /*!< Never stacked, one user of the FPU only           */
+#define FPU_CONTEXT_IMMEDIATE          FPU_FPCCR_ASPEN_Msk                           /*!< S0-S15 and FPSCR stacked on the entry             */
+#define FPU_CONTEXT_LAZY               (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk)   /*!< Room reserved, stacked on the first FP instruction
+                                                                                          of the handler, the reset value                   */
+/**
+  * @}
+  */
+#endif /* __FPU_PRESENT */
+
 #if (__MPU_PRESENT == 1)
 /** @defgroup CORTEX_MPU_HFNMI_PRIVDEF_Control MPU HFNMI and PRIVILEGED Access control
   * @{
@@ -280,6 +293,8 @@ uint32_t HAL_NVIC_GetPendingIRQ(IRQn_Type IRQn);
 void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn);
 void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
 uint32_t HAL_NVIC_GetActive(IRQn_Type IRQn);
+HAL_StatusTypeDef HAL_NVIC_SetVector(IRQn_Type IRQn, void (*Handler)(void));
+uint32_t HAL_NVIC_GetVector(IRQn_Type IRQn);
 void HAL_SYSTICK_CLKSourceConfig(uint32_t CLKSource);
 void HAL_SYSTICK_IRQHandler(void);
 void HAL_SYSTICK_Callback(void);
@@ -289,6 +304,11 @@ void HAL_MPU_Enable(uint32_t MPU_Control);
 void HAL_MPU_Disable(void);
 void HAL_MPU_ConfigRegion(MPU_Region_InitTypeDef *MPU_Init);
 #endif /* __MPU_PRESENT */
+
+#if (__FPU_PRESENT == 1U)
+void HAL_FPU_ConfigContext(uint32_t Context);
+uint32_t HAL_FPU_GetContext(void);
+#endif /* __FPU_PRESENT */
 /**
   * @}
   */
@@ -318,6 +338,12 @@ void HAL_MPU_ConfigRegion(MPU_Region_InitTypeDef *MPU_Init);
 #define IS_SYSTICK_CLK_SOURCE(SOURCE) (((SOURCE) == SYSTICK_CLKSOURCE_HCLK) || \
                                        ((SOURCE) == SYSTICK_CLKSOURCE_HCLK_DIV8))
 
+#if (__FPU_PRESENT == 1U)
+#define IS_FPU_CONTEXT(CONTEXT)       (((CONTEXT) == FPU_CONTEXT_NONE)      || \
+                                       ((CONTEXT) == FPU_CONTEXT_IMMEDIATE) || \
+                                       ((CONTEXT) == FPU_CONTEXT_LAZY))
+#endif /* __FPU_PRESENT */
+
 #if (__MPU_PRESENT == 1U)
 #define IS_MPU_REGION_ENABLE(STATE) (((STATE) == MPU_REGION_ENABLE) || \
                                      ((STATE) == MPU_REGION_DISABLE))
@@ -57,6 +57,34 @@ typedef enum
 } HAL_CRC_StateTypeDef;
 
 
+/**
+  * @brief CRC Init Structure definition
+  * @note  The polynomial of the peripheral is fixed, CRC_DEFAULT_POLYNOMIAL.
+  *        The initial value and the data inversions are applied by the driver.
+  */
+typedef struct
+{
+  uint8_t DefaultInitValueUse;        /*!< This parameter is a value of @ref CRC_Default_InitValue_Use.
+                                           If set to DEFAULT_INIT_VALUE_ENABLE, resort to default
+                                           0xFFFFFFFF value. In that case, there is no need to set InitValue field.
+                                           If otherwise set to DEFAULT_INIT_VALUE_DISABLE, InitValue field must be set */
+
+  uint32_t InitValue;                 /*!< Init value to initiate CRC computation. Applicable only when
+                                           DefaultInitValueUse is DEFAULT_INIT_VALUE_DISABLE */
+
+  uint32_t InputDataInversionMode;    /*!< This parameter is a value of @ref CRC_Input_Data_Inversion and specifies input data inversion mode.
+                                           Can be either one of the following values
+                                           CRC_INPUTDATA_INVERSION_NONE      no input data inversion
+                                           CRC_INPUTDATA_INVERSION_BYTE      byte-wise inversion, 0x1A2B3C4D becomes 0x58D43CB2
+                                           CRC_INPUTDATA_INVERSION_HALFWORD  halfword-wise inversion, 0x1A2B3C4D becomes 0xD458B23C
+                                           CRC_INPUTDATA_INVERSION_WORD      word-wise inversion, 0x1A2B3C4D becomes 0xB23CD458 */
+
+  uint32_t OutputDataInversionMode;   /*!< This parameter is a value of @ref CRC_Output_Data_Inversion and specifies output data (i.e. CRC) inversion mode.
+                                            Can be either
+                                            CRC_OUTPUTDATA_INVERSION_DISABLE   no CRC inversion,
+                                            CRC_OUTPUTDATA_INVERSION_ENABLE    CRC 0x11223344 is converted into 0x22CC4488 */
+} CRC_InitTypeDef;
+
 /**
   * @brief  CRC Handle Structure definition
   */
@@ -64,11 +92,39 @@ typedef struct
 {
   CRC_TypeDef                 *Instance;   /*!< Register base address        */
 
+  CRC_InitTypeDef             Init;        /*!< CRC configuration parameters */
+
   HAL_LockTypeDef             Lock;        /*!< CRC Locking object           */
 
   __IO HAL_CRC_StateTypeDef   State;       /*!< CRC communication state      */
 
+  uint32_t InputDataFormat;                /*!< This parameter is a value of @ref CRC_Input_Buffer_Format.
+                                                Can be either
+                                                CRC_INPUTDATA_FORMAT_BYTES       input data is a stream of bytes
+                                                CRC_INPUTDATA_FORMAT_HALFWORDS   input data is a stream of half-words
+                                                CRC_INPUTDATA_FORMAT_WORDS       input data is a stream of words
+                                                Left to CRC_INPUTDATA_FORMAT_UNDEFINED, the input data are words */
+
+  DMA_HandleTypeDef           *hdma;       /*!< CRC DMA Handle parameters, memory to memory channel feeding DR */
+
+  uint32_t                    *pBuffPtr;   /*!< Next word fed by the DMA     */
+
+  __IO uint32_t               XferCount;   /*!< Words left to feed by the DMA */
+
 } CRC_HandleTypeDef;
+
+/**
+  * @brief  CRC Context Structure definition
+  */
+typedef struct
+{
+  CRC_InitTypeDef             Init;             /*!< CRC configuration parameters                    */
+
+  uint32_t                    InputDataFormat;  /*!< Input data format, a value of @ref CRC_Input_Buffer_Format */
+
+  uint32_t                    Value;            /*!< Data register, CRC before the output data inversion */
+
+} CRC_ContextTypeDef;
 /**
   * @}
   */
@@ -78,6 +134,65 @@ typedef struct
   * @{
   */
 
+/** @defgroup CRC_Default_Polynomial_Value    Default CRC generating polynomial
+  * @{
+  */
+#define DEFAULT_CRC32_POLY      0x04C11DB7U  /*!<  X^32 + X^26 + X^23 + X^22 + X^16 + X^12 + X^11 + X^10 +X^8 + X^7 + X^5 + X^4 + X^2+ X +1, the polynomial of the peripheral */
+/**
+  * @}
+  */
+
+/** @defgroup CRC_Default_InitValue    Default CRC computation initialization value
+  * @{
+  */
+#define DEFAULT_CRC_INITVALUE   0xFFFFFFFFU  /*!< Initial CRC default value, loaded by a reset of DR */
+/**
+  * @}
+  */
+
+/** @defgroup CRC_Default_InitValue_Use    Indicates whether or not default init value is used
+  * @{
+  */
+#define DEFAULT_INIT_VALUE_ENABLE   ((uint8_t)0x00U) /*!< Use default initialization value */
+#define DEFAULT_INIT_VALUE_DISABLE  ((uint8_t)0x01U) /*!< Use user-defined initialization value */
+/**
+  * @}
+  */
+
+/** @defgroup CRC_Input_Data_Inversion Input Data Inversion Modes
+  * @{
+  */
+#define CRC_INPUTDATA_INVERSION_NONE      0x00000000U  /*!< No input data inversion            */
+#define CRC_INPUTDATA_INVERSION_BYTE      0x00000001U  /*!< Byte-wise input data inversion     */
+#define CRC_INPUTDATA_INVERSION_HALFWORD  0x00000002U  /*!< HalfWord-wise input data inversion */
+#define CRC_INPUTDATA_INVERSION_WORD      0x00000003U  /*!< Word-wise input data inversion     */
+/**
+  * @}
+  */
+
+/** @defgroup CRC_Output_Data_Inversion Output Data Inversion Modes
+  * @{
+  */
+#define CRC_OUTPUTDATA_INVERSION_DISABLE  0x00000000U  /*!< No output data inversion       */
+#define CRC_OUTPUTDATA_INVERSION_ENABLE   0x00000001U  /*!< Bit-wise output data inversion */
+/**
+  * @}
+  */
+
+/** @defgroup CRC_Input_Buffer_Format Input Buffer Format
+  * @{
+  */
+/* CRC_INPUTDATA_FORMAT_UNDEFINED keeps the word buffers of the handles
+ * initialized before the input formats were added: BufferLength is then a
+ * number of words */
+#define CRC_INPUTDATA_FORMAT_UNDEFINED    0x00000000U  /*!< Undefined input data format, handled as words */
+#define CRC_INPUTDATA_FORMAT_BYTES        0x00000001U  /*!< Input data in byte format      */
+#define CRC_INPUTDATA_FORMAT_HALFWORDS    0x00000002U  /*!< Input data in half-word format */
+#define CRC_INPUTDATA_FORMAT_WORDS        0x00000003U  /*!< Input data in word format      */
+/**
+  * @}
+  */
+
 /**
   * @}
   */
@@ -125,6 +240,21 @@ typedef struct
 /** @defgroup  CRC_Private_Macros CRC Private Macros
   * @{
   */
+#define IS_DEFAULT_INIT_VALUE(VALUE)  (((VALUE) == DEFAULT_INIT_VALUE_ENABLE) || \
+                                       ((VALUE) == DEFAULT_INIT_VALUE_DISABLE))
+
+#define IS_CRC_INPUTDATA_INVERSION_MODE(MODE)     (((MODE) == CRC_INPUTDATA_INVERSION_NONE)     || \
+                                                   ((MODE) == CRC_INPUTDATA_INVERSION_BYTE)     || \
+                                                   ((MODE) == CRC_INPUTDATA_INVERSION_HALFWORD) || \
+                                                   ((MODE) == CRC_INPUTDATA_INVERSION_WORD))
+
+#define IS_CRC_OUTPUTDATA_INVERSION_MODE(MODE)    (((MODE) == CRC_OUTPUTDATA_INVERSION_DISABLE) || \
+                                                   ((MODE) == CRC_OUTPUTDATA_INVERSION_ENABLE))
+
+#define IS_CRC_INPUTDATA_FORMAT(FORMAT)           (((FORMAT) == CRC_INPUTDATA_FORMAT_UNDEFINED) || \
+                                                   ((FORMAT) == CRC_INPUTDATA_FORMAT_BYTES)     || \
+                                                   ((FORMAT) == CRC_INPUTDATA_FORMAT_HALFWORDS) || \
+                                                   ((FORMAT) == CRC_INPUTDATA_FORMAT_WORDS))
 
 /**
   * @}
@@ -153,6 +283,13 @@ void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc);
   */
 uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
 uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_GetValue(CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef HAL_CRC_Accumulate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+HAL_StatusTypeDef HAL_CRC_Calculate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+void HAL_CRC_CpltCallback(CRC_HandleTypeDef *hcrc);
+void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef HAL_CRC_SaveContext(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext);
+HAL_StatusTypeDef HAL_CRC_RestoreContext(CRC_HandleTypeDef *hcrc, const CRC_ContextTypeDef *pContext);
 /**
   * @}
   */
@@ -106,9 +106,18 @@ typedef enum
   */
 #define __HAL_RESET_HANDLE_STATE(__HANDLE__) ((__HANDLE__)->State = 0U)
 
+#if !defined (USE_HAL_LOCK)
+#define USE_HAL_LOCK                    1U
+#endif
+
 #if (USE_RTOS == 1U)
 /* Reserved for future use */
 #error "USE_RTOS should be 0 in the current HAL release"
+#elif (USE_HAL_LOCK == 0U)
+/* No lock of the handles: the application never calls the HAL on one handle
+   from two contexts at once, the state checks of the drivers are kept */
+#define __HAL_LOCK(__HANDLE__)          do{ }while (0U)
+#define __HAL_UNLOCK(__HANDLE__)        do{ }while (0U)
 #else
 #define __HAL_LOCK(__HANDLE__)                                           \
                                 do{                                        \
@@ -128,6 +137,174 @@ typedef enum
                                     }while (0U)
 #endif /* USE_RTOS */
 
+/** @brief Critical sections of the HAL.
+  * @note  With HAL_CRITICAL_PRIORITY 0, HAL_EnterCritical() masks all the
+  *        interrupts with PRIMASK. With HAL_CRITICAL_PRIORITY N, 1 to 7, it
+  *        masks with BASEPRI the preemption priorities N and above in number
+  *        only: the interrupts of priorities 0 to N-1 are never delayed by the
+  *        HAL, and must not call it. The tick stays maskable, TICK_INT_PRIORITY
+  *        at least N.
+  */
+#if !defined (HAL_CRITICAL_PRIORITY)
+#define HAL_CRITICAL_PRIORITY           0U
+#endif
+
+#if (HAL_CRITICAL_PRIORITY >= (1UL << __NVIC_PRIO_BITS))
+#error "HAL_CRITICAL_PRIORITY should be below 1 << __NVIC_PRIO_BITS"
+#endif
+
+/**
+  * @brief  Enter a critical section of the HAL, nested or not.
+  * @retval Mask state to restore with HAL_ExitCritical()
+  */
+__STATIC_INLINE uint32_t HAL_EnterCritical(void)
+{
+  uint32_t state;
+
+#if (HAL_CRITICAL_PRIORITY != 0U)
+  state = __get_BASEPRI();
+  __set_BASEPRI_MAX(HAL_CRITICAL_PRIORITY << (8U - __NVIC_PRIO_BITS));
+  __ISB();
+#else
+  state = __get_PRIMASK();
+  __disable_irq();
+#endif
+
+  return state;
+}
+
+/**
+  * @brief  Leave a critical section of the HAL.
+  * @param  State Mask state from HAL_EnterCritical().
+  * @retval None
+  */
+__STATIC_INLINE void HAL_ExitCritical(uint32_t State)
+{
+#if (HAL_CRITICAL_PRIORITY != 0U)
+  __set_BASEPRI(State);
+#else
+  __set_PRIMASK(State);
+#endif
+}
+
+/** @brief Bit-band alias of a bit of the SRAM or of the peripherals.
+  * @note  The first MB of the SRAM (SRAM_BASE) and of the peripherals
+  *        (PERIPH_BASE) is mirrored 32 times larger at SRAM_BB_BASE and
+  *        PERIPH_BB_BASE, one word per bit: writing 1 or 0 to the word sets or
+  *        clears the bit in one bus transaction the interrupts cannot split, a
+  *        read returns the bit. __ADDR__ is a word or byte address, __BIT__
+  *        counted from bit 0 of __ADDR__, up to 31.
+  * @note  A flag of a peripheral register is then set or cleared without the
+  *        read-modify-write of SET_BIT() or CLEAR_BIT(): no lock or critical
+  *        section against an interrupt updating another bit of the register.
+  *        Not for the write 1 to clear bits, the bus still writes the register.
+  */
+#define HAL_BITBAND(__ADDR__, __BIT__)                                                   \
+  ((__IO uint32_t *)((((uint32_t)(__ADDR__)) & 0xF0000000UL) + 0x02000000UL +            \
+                     ((((uint32_t)(__ADDR__)) & 0x000FFFFFUL) * 32UL) + ((uint32_t)(__BIT__) * 4UL)))
+
+#define HAL_BITBAND_SET(__ADDR__, __BIT__)   (*HAL_BITBAND((__ADDR__), (__BIT__)) = 1UL)
+#define HAL_BITBAND_CLEAR(__ADDR__, __BIT__) (*HAL_BITBAND((__ADDR__), (__BIT__)) = 0UL)
+#define HAL_BITBAND_READ(__ADDR__, __BIT__)  (*HAL_BITBAND((__ADDR__), (__BIT__)))
+
+/** @brief Atomic updates of a word of the SRAM shared with the interrupts.
+  * @note  LDREX/STREX retried until no exception ran in between: no interrupt
+  *        is masked, the update is lost by none. The exclusive monitor only
+  *        covers the SRAM, the peripheral registers take HAL_BITBAND().
+  */
+
+/**
+  * @brief  Set bits of a word atomically.
+  * @param  pAddr Word of the SRAM.
+  * @param  Mask Bits to set.
+  * @retval Value before the update
+  */
+__STATIC_INLINE uint32_t HAL_AtomicSetBits(__IO uint32_t *pAddr, uint32_t Mask)
+{
+  uint32_t value;
+
+  do
+  {
+    value = __LDREXW(pAddr);
+  } while (__STREXW(value | Mask, pAddr) != 0U);
+
+  return value;
+}
+
+/**
+  * @brief  Clear bits of a word atomically.
+  * @param  pAddr Word of the SRAM.
+  * @param  Mask Bits to clear.
+  * @retval Value before the update
+  */
+__STATIC_INLINE uint32_t HAL_AtomicClearBits(__IO uint32_t *pAddr, uint32_t Mask)
+{
+  uint32_t value;
+
+  do
+  {
+    value = __LDREXW(pAddr);
+  } while (__STREXW(value & ~Mask, pAddr) != 0U);
+
+  return value;
+}
+
+/**
+  * @brief  Add to a word atomically, a counter shared with the interrupts.
+  * @param  pAddr Word of the SRAM.
+  * @param  Value Added, modulo 2^32: 0xFFFFFFFF subtracts 1.
+  * @retval Value after the update
+  */
+__STATIC_INLINE uint32_t HAL_AtomicAdd(__IO uint32_t *pAddr, uint32_t Value)
+{
+  uint32_t value;
+
+  do
+  {
+    value = __LDREXW(pAddr) + Value;
+  } while (__STREXW(value, pAddr) != 0U);
+
+  return value;
+}
+
+/**
+  * @brief  Replace a word atomically if it holds an expected value.
+  * @param  pAddr Word of the SRAM.
+  * @param  Expected Value the word must hold.
+  * @param  Desired Value written then.
+  * @retval Value before, Expected when Desired was written
+  */
+__STATIC_INLINE uint32_t HAL_AtomicCompareExchange(__IO uint32_t *pAddr, uint32_t Expected, uint32_t Desired)
+{
+  uint32_t value;
+
+  do
+  {
+    value = __LDREXW(pAddr);
+    if (value != Expected)
+    {
+      __CLREX();
+      break;
+    }
+  } while (__STREXW(Desired, pAddr) != 0U);
+
+  return value;
+}
+
+/** @brief Compile time check of a HAL parameter.
+  * @note  With GCC, a constant __EXPR__ found false stops the build with
+  *        "HAL parameter out of range", at any optimization level. A variable
+  *        one costs nothing, its check left to assert_param(). _Static_assert
+  *        only takes constant expressions and cannot skip the variable ones.
+  */
+#if defined ( __GNUC__ ) && !defined (__CC_ARM) /* GNU Compiler */
+extern int HAL_ConstParamError(void) __attribute__((error("HAL parameter out of range")));
+#define __HAL_CHECK_CONST(__EXPR__)     \
+  ((void)((__builtin_constant_p(__EXPR__) && !(__EXPR__)) ? HAL_ConstParamError() : 0))
+#else
+#define __HAL_CHECK_CONST(__EXPR__)     ((void)0U)
+#endif /* __GNUC__ */
+
 #if defined ( __GNUC__ ) && !defined (__CC_ARM) /* GNU Compiler */
 #ifndef __weak
 #define __weak   __attribute__((weak))
@@ -192,6 +369,102 @@ typedef enum
 
 #endif
 
+/**
+  * @brief  __FLASH_RAM_FUNC definition
+  */
+#if defined (USE_FLASH_RAMFUNC) && defined ( __GNUC__ )
+/* GNU Compiler
+   ------------
+  With USE_FLASH_RAMFUNC, the FLASH program and erase functions and the tick
+  are placed with the __RAM_FUNC functions, copied to RAM by the startup with
+  the data. A function is not inlined into a caller running from the FLASH.
+*/
+#define __FLASH_RAM_FUNC __attribute__((section(".RamFunc"), noinline))
+
+#else
+/* Functions stay in the FLASH: code fetched from the FLASH stalls while a
+   program or an erase runs.
+*/
+#define __FLASH_RAM_FUNC
+
+#endif
+
+/**
+  * @brief  __EXTFLASH_FUNC and __EXTFLASH_CONST definition
+  */
+#if defined   (  __GNUC__  )
+/* GNU Compiler
+   ------------
+  Functions and constants executed and read in place from the external flash
+  mapped by the ESMC are placed in the .extflash section of the linker script
+  with "__attribute__((section(".ExtFlashFunc")))" and
+  "__attribute__((section(".ExtFlashConst")))". A function is not inlined
+  into a caller outside of the section.
+*/
+#define __EXTFLASH_FUNC  __attribute__((section(".ExtFlashFunc"), noinline))
+#define __EXTFLASH_CONST __attribute__((section(".ExtFlashConst")))
+
+#else
+/* Other Compilers
+   ---------------
+  Place the objects with the scatter file or the toolchain options.
+*/
+#define __EXTFLASH_FUNC
+#define __EXTFLASH_CONST
+
+#endif
+
+/**
+  * @brief  __PSRAM_DATA definition
+  */
+#if defined   (  __GNUC__  )
+/* GNU Compiler
+   ------------
+  Buffers in the external PSRAM mapped by the ESMC are placed in the .psram
+  section of the linker script with "__attribute__((section(".PsramData")))".
+  They are not initialized by the startup code.
+*/
+#define __PSRAM_DATA __attribute__((section(".PsramData")))
+
+#else
+/* Other Compilers
+   ---------------
+  Place the objects with the scatter file or the toolchain options.
+*/
+#define __PSRAM_DATA
+
+#endif
+
+/**
+  * @brief  __FAST_DATA, __DMA_BUFFER and __NOINIT definition
+  */
+#if defined   (  __GNUC__  )
+/* GNU Compiler
+   ------------
+  __FAST_DATA places a table declared without const with the data copied to
+  RAM by the startup: it is read without the FLASH wait states.
+  __DMA_BUFFER aligns a buffer on 32 bytes in the region of the .bss between
+  _sdmabuf and _edmabuf, zeroed by the startup: the DMA buffers in one
+  contiguous area, that can be checked against the addresses given to the DMA.
+  __NOINIT places an object in the .noinit section, neither copied nor zeroed
+  by the startup: it keeps its value over a reset, the crash records for
+  example, and is random after a power on.
+*/
+#define __FAST_DATA  __attribute__((section(".FastData")))
+#define __DMA_BUFFER __attribute__((section(".bss.DmaBuffer"), aligned(32)))
+#define __NOINIT     __attribute__((section(".NoInit")))
+
+#else
+/* Other Compilers
+   ---------------
+  Place the objects with the scatter file or the toolchain options.
+*/
+#define __FAST_DATA
+#define __DMA_BUFFER
+#define __NOINIT
+
+#endif
+
 /**
   * @brief  __NOINLINE definition
   */
@@ -104,10 +104,30 @@ typedef enum
   HAL_DMA_XFER_HALFCPLT_CB_ID      = 0x01U,    /*!< Half transfer     */
   HAL_DMA_XFER_ERROR_CB_ID         = 0x02U,    /*!< Error             */ 
   HAL_DMA_XFER_ABORT_CB_ID         = 0x03U,    /*!< Abort             */ 
-  HAL_DMA_XFER_ALL_CB_ID           = 0x04U     /*!< All               */ 
+  HAL_DMA_XFER_M1CPLT_CB_ID        = 0x04U,    /*!< M1 Full Transfer  */
+  HAL_DMA_XFER_ALL_CB_ID           = 0x05U     /*!< All               */ 
     
 }HAL_DMA_CallbackIDTypeDef;
 
+/**
+  * @brief  DMA double buffer mode context definition
+  * @note   Used by HAL_DMAEx_MultiBufferStart_IT(), index 0 is memory 0 and
+  *         index 1 is memory 1.
+  */
+typedef struct
+{
+  uint32_t              Address[2];           /*!< Memory buffer addresses                                       */
+
+  uint32_t              Length[2];            /*!< Memory buffer lengths, in data items                           */
+
+  __IO uint8_t          Full[2];              /*!< Set when a buffer is handed over to the application,
+                                                   cleared by HAL_DMAEx_ReleaseMemory() or HAL_DMAEx_ChangeMemory() */
+
+  __IO uint8_t          Target;               /*!< Buffer the channel is transferring to or from                 */
+
+  __IO uint8_t          Active;               /*!< Double buffer mode is running                                 */
+} DMA_DoubleBufferTypeDef;
+
 /** 
   * @brief  DMA handle Structure definition
   */
@@ -130,14 +150,25 @@ typedef struct __DMA_HandleTypeDef
   void                  (* XferErrorCallback)( struct __DMA_HandleTypeDef * hdma);    /*!< DMA transfer error callback            */
 
   void                  (* XferAbortCallback)( struct __DMA_HandleTypeDef * hdma);    /*!< DMA transfer abort callback            */  
+
+  void                  (* XferM1CpltCallback)( struct __DMA_HandleTypeDef * hdma);   /*!< DMA transfer complete Memory1 callback */
   
   __IO uint32_t         ErrorCode;                                                    /*!< DMA Error code                         */
 
   DMA_TypeDef            *DmaBaseAddress;                                             /*!< DMA Channel Base Address               */
   
-  uint32_t               ChannelIndex;                                                /*!< DMA Channel Index                      */  
+  uint32_t               ChannelIndex;                                                /*!< DMA Channel Index                      */
+
+  struct __DMA_ChainDescTypeDef *pChainDesc;                                          /*!< Descriptor being transferred when a
+                                                                                           chain is started by HAL_DMAEx_StartChain(),
+                                                                                           NULL for single block transfers          */
+
+  DMA_DoubleBufferTypeDef DoubleBuffer;                                               /*!< Double buffer mode context             */
+
+  struct __DMA_CoalesceTypeDef *pCoalesce;                                           /*!< Interrupt coalescing group, NULL when
+                                                                                           every transfer raises its interrupt      */
 
-} DMA_HandleTypeDef;    
+} DMA_HandleTypeDef;
 /**
   * @}
   */
@@ -156,6 +187,9 @@ typedef struct __DMA_HandleTypeDef
 #define HAL_DMA_ERROR_NO_XFER                  0x00000004U    /*!< no ongoing transfer  */
 #define HAL_DMA_ERROR_TIMEOUT                  0x00000020U    /*!< Timeout error        */
 #define HAL_DMA_ERROR_NOT_SUPPORTED            0x00000100U    /*!< Not supported mode   */ 
+#define HAL_DMA_ERROR_OVERRUN                  0x00000200U    /*!< Double buffer overrun, the
+                                                                   application did not release
+                                                                   the next buffer in time */
 /**
   * @}
   */
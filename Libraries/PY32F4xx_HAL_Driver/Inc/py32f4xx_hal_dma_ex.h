@@ -39,12 +39,239 @@
   * @{
   */
 
-/* Exported types ------------------------------------------------------------*/ 
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup DMAEx_Exported_Types DMA Extended Exported Types
+  * @{
+  */
+
+/**
+  * @brief  DMA descriptor chain entry definition
+  * @note   Entries are walked by HAL_DMA_IRQHandler() from the transfer complete
+  *         interrupt, so they must stay valid until the chain has completed.
+  */
+typedef struct __DMA_ChainDescTypeDef
+{
+  uint32_t SrcAddress;                        /*!< Source address of the fragment                         */
+
+  uint32_t DstAddress;                        /*!< Destination address of the fragment                    */
+
+  uint32_t DataLength;                        /*!< Number of data items of the fragment, 1 to 0xFFFF       */
+
+  uint32_t Flags;                             /*!< Per fragment options.
+                                                   This parameter can be a combination of @ref DMAEx_Chain_Flags */
+
+  struct __DMA_ChainDescTypeDef *pNext;       /*!< Next fragment of the chain, NULL on the last entry      */
+} DMA_ChainDescTypeDef;
+
+/**
+  * @brief  HAL DMA Memory definition
+  */
+typedef enum
+{
+  MEMORY0      = 0x00U,    /*!< Memory 0     */
+  MEMORY1      = 0x01U     /*!< Memory 1     */
+} HAL_DMA_MemoryTypeDef;
+
+/**
+  * @brief  DMA channel pool entry definition
+  */
+typedef struct
+{
+  DMA_Channel_TypeDef   *Instance;             /*!< Channel registers base address                  */
+
+  DMA_HandleTypeDef     *Owner;                /*!< Handle owning the channel, NULL when it is free */
+
+  uint32_t              Request;               /*!< Request mapped on the channel,
+                                                    a value of @ref DMA_Channel_map                 */
+} DMA_ChannelInfoTypeDef;
+
+/**
+  * @brief  DMA memory to memory request definition
+  * @note   Requests are owned by the caller and queued without copy, they must
+  *         stay valid until their State is DMA_MEM_REQ_DONE or DMA_MEM_REQ_ERROR.
+  */
+typedef struct __DMA_MemRequestTypeDef
+{
+  uint32_t              SrcAddress;           /*!< Source address, unused for a memset request             */
+
+  uint32_t              DstAddress;           /*!< Destination address                                      */
+
+  uint32_t              Size;                 /*!< Number of bytes to copy or set                           */
+
+  uint32_t              Pattern;              /*!< Memset value replicated on 4 bytes, read by the DMA      */
+
+  uint32_t              IsMemSet;             /*!< Non zero for a memset request                            */
+
+  uint32_t              Priority;             /*!< Request priority, a value of @ref DMA_Priority_level, set
+                                                   by the caller before the request is queued               */
+
+  uint32_t              Offset;               /*!< Bytes already transferred, managed by the driver          */
+
+  __IO uint32_t         State;                /*!< Request state, a value of @ref DMAEx_MemRequest_State    */
+
+  void                  (* XferCpltCallback)(struct __DMA_MemRequestTypeDef *pReq); /*!< Completion callback,
+                                                   called from the DMA interrupt, can be NULL              */
+
+  void                  *pContext;            /*!< User context, not used by the driver                     */
+
+  struct __DMA_MemRequestTypeDef *pNext;      /*!< Next queued request, managed by the driver               */
+} DMA_MemRequestTypeDef;
+
+#define DMA_COALESCE_MAX_CHANNELS    4U             /*!< Maximum number of handles in a coalescing group */
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+#define DMA_STATS_HISTOGRAM_SIZE     16U            /*!< Number of latency histogram bins */
+
+/**
+  * @brief  DMA channel statistics definition
+  * @note   Latencies are counted in CPU cycles from the start of a block to the
+  *         transfer complete interrupt (TC to TC in circular mode).
+  */
+typedef struct
+{
+  uint32_t              Transfers;            /*!< Completed blocks                                        */
+
+  uint32_t              Errors;               /*!< Transfer errors                                         */
+
+  uint64_t              Bytes;                /*!< Bytes moved by completed blocks, memory side            */
+
+  uint32_t              MinCycles;            /*!< Shortest block latency                                  */
+
+  uint32_t              MaxCycles;            /*!< Longest block latency                                   */
+
+  uint64_t              TotalCycles;          /*!< Sum of the block latencies, for the average             */
+
+  uint32_t              MaxLag;               /*!< Circular mode: most data items already transferred after
+                                                   the wrap when the interrupt was served, the closer to
+                                                   the buffer length the closer to an overrun               */
+
+  uint32_t              Histogram[DMA_STATS_HISTOGRAM_SIZE]; /*!< Latency histogram, bin 0 counts blocks
+                                                   below 256 cycles, bin n counts [2^(n+7), 2^(n+8)) cycles,
+                                                   the last bin counts all longer blocks                    */
+} DMA_StatsTypeDef;
+#endif /* USE_HAL_DMA_STATISTICS */
+
+/**
+  * @brief  DMA memory to memory engine definition
+  */
+typedef struct
+{
+  DMA_HandleTypeDef     *hdma;                /*!< DMA handle used for the transfers                        */
+
+  DMA_MemRequestTypeDef *pHead;               /*!< Queued requests, highest priority first                  */
+
+  DMA_MemRequestTypeDef *pActive;             /*!< Request of the DMA block in progress, NULL when idle      */
+
+  uint32_t              ChunkSize;            /*!< Maximum bytes per DMA block for requests below
+                                                   DMA_PRIORITY_VERY_HIGH, 0 for no limit                  */
+
+  uint32_t              BlockSize;            /*!< Bytes of the DMA block in progress                       */
+} DMA_MemEngineTypeDef;
+
+/**
+  * @brief  DMA receive ring buffer definition
+  * @note   Single producer, the DMA channel running in circular mode, and single
+  *         consumer. The write position is read back from the channel counter
+  *         so no interrupt is needed to move data into the ring.
+  */
+typedef struct
+{
+  uint8_t               *pBuffer;             /*!< Ring storage, written by the DMA                         */
+
+  uint32_t              Size;                 /*!< Ring size in bytes                                       */
+
+  uint32_t              Items;                /*!< Ring size in DMA data items, set by HAL_DMAEx_RingAttach() */
+
+  uint32_t              Tail;                 /*!< Read offset in bytes, consumer owned                     */
+
+  uint32_t              Acquired;             /*!< Bytes returned by the last HAL_DMAEx_RingAcquire()        */
+
+  DMA_HandleTypeDef     *hdma;                /*!< DMA handle filling the ring                              */
+} DMA_RingTypeDef;
+
+/**
+  * @brief  DMA interrupt coalescing group definition
+  */
+typedef struct __DMA_CoalesceTypeDef
+{
+  DMA_HandleTypeDef     *hdma[DMA_COALESCE_MAX_CHANNELS]; /*!< Member handles                                   */
+
+  uint32_t              Count;                /*!< Number of member handles                                 */
+
+  uint32_t              Threshold;            /*!< Transfers started in the group between two transfer
+                                                   complete interrupts                                      */
+
+  __IO uint32_t         Started;              /*!< Transfers started since the last interrupt request        */
+
+  void                  (* XferBatchCallback)(struct __DMA_CoalesceTypeDef *hco, uint32_t Completed); /*!< Called after
+                                                   the completions of a flush were reported, may be NULL     */
+} DMA_CoalesceTypeDef;
+
+/**
+  * @}
+  */
+
 /* Exported constants --------------------------------------------------------*/
+/** @defgroup DMAEx_Exported_Constants DMA Extended Exported Constants
+  * @{
+  */
+
+/** @defgroup DMAEx_Channel_Number DMA Extended number of channels
+  * @{
+  */
+#if defined (DMA2)
+#define DMA_CHANNEL_NUMBER           12U            /*!< DMA1 channel 1 to 7 and DMA2 channel 1 to 5 */
+#else
+#define DMA_CHANNEL_NUMBER           7U             /*!< DMA1 channel 1 to 7                         */
+#endif /* DMA2 */
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_MemRequest_State DMA Extended memory request state
+  * @{
+  */
+#define DMA_MEM_REQ_IDLE             0x00000000U    /*!< Request not submitted        */
+#define DMA_MEM_REQ_QUEUED           0x00000001U    /*!< Request waiting or in progress */
+#define DMA_MEM_REQ_DONE             0x00000002U    /*!< Request completed            */
+#define DMA_MEM_REQ_ERROR            0x00000003U    /*!< Request aborted by a transfer error */
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Chain_Flags DMA Extended descriptor chain flags
+  * @{
+  */
+#define DMA_CHAIN_FLAG_NONE          0x00000000U    /*!< Address increments taken from the handle Init  */
+#define DMA_CHAIN_FLAG_SRC_FIXED     0x00000001U    /*!< Source address is not incremented              */
+#define DMA_CHAIN_FLAG_DST_FIXED     0x00000002U    /*!< Destination address is not incremented         */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
 /* Exported macro ------------------------------------------------------------*/
 /** @defgroup DMAEx_Exported_Macros DMA Extended Exported Macros
   * @{
   */
+
+/**
+  * @brief  Declare a buffer aligned for word DMA accesses.
+  * @note   Usage: static uint8_t buf[64] __DMA_BUFFER_ALIGNED;
+  */
+#define __DMA_BUFFER_ALIGNED          __ALIGNED(4)
+
+/**
+  * @brief  Check that an address is aligned on a DMA data size field.
+  * @param  __ADDRESS__: Address.
+  * @param  __SIZE__: Data size field, shifted to bit 0 (0: byte, 1: half word, 2: word).
+  * @retval 1 if aligned, 0 otherwise.
+  */
+#define __HAL_DMA_IS_ALIGNED(__ADDRESS__, __SIZE__) \
+  (((((uint32_t)(__ADDRESS__)) & ((1UL << (__SIZE__)) - 1U)) == 0U) ? 1U : 0U)
 /* Interrupt & Flag management */
 /** @defgroup DMAEx_High_density_XL_density_Product_devices DMAEx High density and XL density product devices
   * @{
@@ -164,6 +391,150 @@
   * @}
   */
 
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup DMAEx_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group1
+  * @{
+  */
+/* Descriptor chain functions *************************************************/
+HAL_StatusTypeDef HAL_DMAEx_StartChain(DMA_HandleTypeDef *hdma, DMA_ChainDescTypeDef *pChain);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group2
+  * @{
+  */
+/* Double buffer mode functions ***********************************************/
+HAL_StatusTypeDef HAL_DMAEx_MultiBufferStart_IT(DMA_HandleTypeDef *hdma, uint32_t PeriphAddress,
+                                                uint32_t Mem0Address, uint32_t Mem0Length,
+                                                uint32_t Mem1Address, uint32_t Mem1Length);
+HAL_StatusTypeDef HAL_DMAEx_ChangeMemory(DMA_HandleTypeDef *hdma, uint32_t Address, uint32_t Length, HAL_DMA_MemoryTypeDef memory);
+HAL_StatusTypeDef HAL_DMAEx_ReleaseMemory(DMA_HandleTypeDef *hdma, HAL_DMA_MemoryTypeDef memory);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group3
+  * @{
+  */
+/* Channel pool functions *****************************************************/
+HAL_StatusTypeDef HAL_DMAEx_ChannelAlloc(DMA_HandleTypeDef *hdma, uint32_t MapReqNum);
+HAL_StatusTypeDef HAL_DMAEx_ChannelClaim(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *Instance, uint32_t MapReqNum);
+HAL_StatusTypeDef HAL_DMAEx_ChannelFree(DMA_HandleTypeDef *hdma);
+uint32_t HAL_DMAEx_GetChannelUsage(DMA_ChannelInfoTypeDef *pTable);
+IRQn_Type HAL_DMAEx_GetIRQn(DMA_HandleTypeDef *hdma);
+void HAL_DMAEx_ChannelIRQHandler(DMA_Channel_TypeDef *Instance);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group4
+  * @{
+  */
+/* Memory to memory engine functions ******************************************/
+HAL_StatusTypeDef HAL_DMAEx_MemEngineInit(DMA_MemEngineTypeDef *hmem, DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMAEx_MemCpyAsync(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq,
+                                        void *pDst, const void *pSrc, uint32_t Size);
+HAL_StatusTypeDef HAL_DMAEx_MemSetAsync(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq,
+                                        void *pDst, uint8_t Value, uint32_t Size);
+HAL_StatusTypeDef HAL_DMAEx_MemPollForRequest(DMA_MemRequestTypeDef *pReq, uint32_t Timeout);
+HAL_StatusTypeDef HAL_DMAEx_MemSetChunkSize(DMA_MemEngineTypeDef *hmem, uint32_t ChunkSize);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group6
+  * @{
+  */
+/* Ring buffer functions ******************************************************/
+HAL_StatusTypeDef HAL_DMAEx_RingInit(DMA_RingTypeDef *pRing, uint8_t *pBuffer, uint32_t Size);
+HAL_StatusTypeDef HAL_DMAEx_RingAttach(DMA_RingTypeDef *pRing, DMA_HandleTypeDef *hdma);
+uint32_t HAL_DMAEx_RingGetCount(const DMA_RingTypeDef *pRing);
+uint32_t HAL_DMAEx_RingAcquire(DMA_RingTypeDef *pRing, uint8_t **ppData);
+void HAL_DMAEx_RingCommit(DMA_RingTypeDef *pRing, uint32_t Length);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group7
+  * @{
+  */
+/* Interrupt coalescing functions *********************************************/
+HAL_StatusTypeDef HAL_DMAEx_CoalesceInit(DMA_CoalesceTypeDef *hco, uint32_t Threshold,
+                                         void (* pCallback)(DMA_CoalesceTypeDef *hco, uint32_t Completed));
+HAL_StatusTypeDef HAL_DMAEx_CoalesceAdd(DMA_CoalesceTypeDef *hco, DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMAEx_CoalesceRemove(DMA_CoalesceTypeDef *hco, DMA_HandleTypeDef *hdma);
+void HAL_DMAEx_CoalesceTimeout(DMA_CoalesceTypeDef *hco);
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Exported_Functions_Group8
+  * @{
+  */
+/* Alignment functions ********************************************************/
+uint32_t HAL_DMAEx_GetBestWidth(uint32_t SrcAddress, uint32_t DstAddress, uint32_t Size);
+HAL_StatusTypeDef HAL_DMAEx_CheckBuffer(DMA_HandleTypeDef *hdma, uint32_t MemAddress, uint32_t Size);
+HAL_StatusTypeDef HAL_DMAEx_ConfigDataWidth(DMA_HandleTypeDef *hdma, uint32_t Width);
+/**
+  * @}
+  */
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+/** @addtogroup DMAEx_Exported_Functions_Group5
+  * @{
+  */
+/* Statistics functions *******************************************************/
+HAL_StatusTypeDef HAL_DMAEx_GetStats(DMA_HandleTypeDef *hdma, DMA_StatsTypeDef *pStats);
+void HAL_DMAEx_ResetStats(void);
+void HAL_DMAEx_DumpStats(void);
+/**
+  * @}
+  */
+#endif /* USE_HAL_DMA_STATISTICS */
+
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup DMAEx_Private_Macros DMA Extended Private Macros
+  * @{
+  */
+#define IS_DMA_MEMORY(MEMORY) (((MEMORY) == MEMORY0) || ((MEMORY) == MEMORY1))
+
+#define IS_DMA_CHAIN_FLAGS(FLAGS) (((FLAGS) & ~(DMA_CHAIN_FLAG_SRC_FIXED | DMA_CHAIN_FLAG_DST_FIXED)) == 0U)
+
+#define IS_DMA_WIDTH(WIDTH) (((WIDTH) == 1U) || ((WIDTH) == 2U) || ((WIDTH) == 4U))
+
+#define IS_DMA_CHANNEL_ALIGNED(HANDLE, PADDRESS, MADDRESS) \
+  ((__HAL_DMA_IS_ALIGNED((PADDRESS), (((HANDLE)->Instance->CCR & DMA_CCR_PSIZE) >> DMA_CCR_PSIZE_Pos)) != 0U) && \
+   (__HAL_DMA_IS_ALIGNED((MADDRESS), (((HANDLE)->Instance->CCR & DMA_CCR_MSIZE) >> DMA_CCR_MSIZE_Pos)) != 0U))
+/**
+  * @}
+  */
+
+/* Private functions ---------------------------------------------------------*/
+/** @defgroup DMAEx_Private_Functions DMA Extended Private Functions
+  * @{
+  */
+uint32_t DMA_ChainLoadNext(DMA_HandleTypeDef *hdma);
+void DMA_MultiBufferSwap(DMA_HandleTypeDef *hdma);
+void DMA_CoalesceStart(DMA_HandleTypeDef *hdma);
+uint32_t DMA_CoalesceFlush(DMA_CoalesceTypeDef *hco, uint32_t Completed);
+#if (USE_HAL_DMA_STATISTICS == 1U)
+void DMA_StatsStart(DMA_HandleTypeDef *hdma, uint32_t DataLength);
+void DMA_StatsComplete(DMA_HandleTypeDef *hdma);
+void DMA_StatsError(DMA_HandleTypeDef *hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+/**
+  * @}
+  */
+
 /**
   * @}
   */
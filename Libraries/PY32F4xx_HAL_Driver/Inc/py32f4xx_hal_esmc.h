@@ -561,6 +561,9 @@ typedef void (*pESMC_CallbackTypeDef)(ESMC_HandleTypeDef *hesmc);
   * @}
   */
 
+/* Include ESMC HAL Extended module */
+#include "py32f4xx_hal_esmc_ex.h"
+
 /* Exported functions --------------------------------------------------------*/
 /** @addtogroup ESMC_Exported_Functions
   * @{
@@ -0,0 +1,149 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_esmc_ex.h
+  * @author  MCU Application Team
+  * @brief   Header file of ESMC HAL Extended module.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_HAL_ESMC_EX_H
+#define PY32F4xx_HAL_ESMC_EX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal_def.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @addtogroup ESMCEx
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup ESMCEx_Exported_Constants ESMCEx Exported Constants
+  * @{
+  */
+
+/** @defgroup ESMCEx_XIP_Window ESMCEx XIP Window
+  * @{
+  */
+#define ESMC_XIP_BASE                  0x90000000UL  /*!< Memory-mapped window of the external flash, EXTFLASH
+                                                          region of the linker script */
+/**
+  * @}
+  */
+
+/** @defgroup ESMCEx_XIP_Preset ESMCEx XIP Preset
+  * @brief    Fast read commands of the common serial NOR flashes, lines used
+  *           by the instruction, the address and the data
+  * @{
+  */
+#define ESMCEX_XIP_FAST_READ           0x00000000U   /*!< 1-1-1, 0Bh or 0Ch, 8 dummy cycles              */
+#define ESMCEX_XIP_DUAL_OUTPUT         0x00000001U   /*!< 1-1-2, 3Bh or 3Ch, 8 dummy cycles              */
+#define ESMCEX_XIP_DUAL_IO             0x00000002U   /*!< 1-2-2, BBh or BCh, mode byte, no dummy cycle   */
+#define ESMCEX_XIP_QUAD_OUTPUT         0x00000003U   /*!< 1-1-4, 6Bh or 6Ch, 8 dummy cycles              */
+#define ESMCEX_XIP_QUAD_IO             0x00000004U   /*!< 1-4-4, EBh or ECh, mode byte, 4 dummy cycles   */
+#define ESMCEX_XIP_OCTAL_OUTPUT        0x00000005U   /*!< 1-1-8, 8Bh or 7Ch, 8 dummy cycles              */
+#define ESMCEX_XIP_OCTAL_IO            0x00000006U   /*!< 1-8-8, CBh or CCh, 16 dummy cycles             */
+/**
+  * @}
+  */
+
+/** @defgroup ESMCEx_Dual_Geometry ESMCEx Dual Flash Geometry
+  * @brief    Combined geometry of two serial NOR flashes in ESMC_DUALFLASH_ENABLE
+  * @{
+  */
+#define ESMCEX_DUAL_PAGE_SIZE          0x00000200U   /*!< Two 256-byte pages programmed together         */
+#define ESMCEX_DUAL_SECTOR_SIZE        0x00002000U   /*!< Two 4-Kbyte sectors erased together            */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup ESMCEx_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup ESMCEx_Exported_Functions_Group1
+  * @{
+  */
+/* XIP functions **************************************************************/
+HAL_StatusTypeDef HAL_ESMCEx_GetXIPCommand(uint32_t Preset, uint32_t AddressSize, ESMC_CommandTypeDef *cmd);
+HAL_StatusTypeDef HAL_ESMCEx_EnableXIP(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t AddressSize,
+                                       uint32_t CSPinSel);
+HAL_StatusTypeDef HAL_ESMCEx_DisableXIP(ESMC_HandleTypeDef *hesmc);
+/**
+  * @}
+  */
+
+/** @addtogroup ESMCEx_Exported_Functions_Group2
+  * @{
+  */
+/* Dual flash functions *******************************************************/
+HAL_StatusTypeDef HAL_ESMCEx_DualRead(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t Address,
+                                      uint8_t *pData, uint32_t Size, uint32_t CSPinSel, uint32_t Timeout);
+HAL_StatusTypeDef HAL_ESMCEx_DualProgram(ESMC_HandleTypeDef *hesmc, uint32_t Address, const uint8_t *pData,
+                                         uint32_t Size, uint32_t CSPinSel, uint32_t Timeout);
+HAL_StatusTypeDef HAL_ESMCEx_DualEraseSector(ESMC_HandleTypeDef *hesmc, uint32_t Address, uint32_t CSPinSel,
+                                             uint32_t Timeout);
+HAL_StatusTypeDef HAL_ESMCEx_DualWaitReady(ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel, uint32_t Timeout);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup ESMCEx_Private_Macros ESMCEx Private Macros
+  * @{
+  */
+#define IS_ESMCEX_XIP_PRESET(PRESET)        ((PRESET) <= ESMCEX_XIP_OCTAL_IO)
+#define IS_ESMCEX_DUAL_PRESET(PRESET)       (((PRESET) == ESMCEX_XIP_QUAD_OUTPUT) || \
+                                             ((PRESET) == ESMCEX_XIP_QUAD_IO))
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_HAL_ESMC_EX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
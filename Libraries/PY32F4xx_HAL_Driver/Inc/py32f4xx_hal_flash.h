@@ -121,6 +121,7 @@ typedef struct
 #define FLASH_LATENCY_4                 FLASH_ACR_LATENCY_2                                                /*!< FLASH Four wait state */
 #define FLASH_LATENCY_5                 (FLASH_ACR_LATENCY_0 | FLASH_ACR_LATENCY_2)                        /*!< FLASH Five wait state */
 #define FLASH_LATENCY_6                 (FLASH_ACR_LATENCY_1 | FLASH_ACR_LATENCY_2)                        /*!< FLASH Six wait state */
+#define FLASH_LATENCY_AUTO              0xFFFFFFFFUL                                                       /*!< HAL_RCC_ClockConfig() selects the latency of the new HCLK */
 /**
   * @}
   */
@@ -174,11 +174,159 @@ extern "C" {
   * @}
   */
 
+/** @defgroup GPIOEx_Pin_Descriptor GPIOEx Pin Descriptor
+  * @brief    A pin as one integer constant, port index and pin number, usable
+  *           in a const table or a #define. The macros below reduce to a
+  *           single load or store when the descriptor is a constant.
+  * @{
+  */
+#define GPIO_PORT_A                  0UL    /*!< Port index of GPIOA, as GPIO_GET_INDEX() */
+#define GPIO_PORT_B                  1UL    /*!< Port index of GPIOB                      */
+#define GPIO_PORT_C                  2UL    /*!< Port index of GPIOC                      */
+#define GPIO_PORT_D                  3UL    /*!< Port index of GPIOD                      */
+#define GPIO_PORT_E                  4UL    /*!< Port index of GPIOE                      */
+
+#define GPIO_PIN_DESC(__PORT__, __NUMBER__)  ((((uint32_t)(__PORT__)) << 4U) | ((uint32_t)(__NUMBER__) & 0x0FUL))
+#define GPIO_DESC_PORT(__DESC__)     ((GPIO_TypeDef *)(GPIOA_BASE + (((uint32_t)(__DESC__) >> 4U) * 0x400UL)))
+#define GPIO_DESC_NUMBER(__DESC__)   ((uint32_t)(__DESC__) & 0x0FUL)
+#define GPIO_DESC_MASK(__DESC__)     (1UL << GPIO_DESC_NUMBER(__DESC__))
+#define IS_GPIO_PIN_DESC(__DESC__)   (((uint32_t)(__DESC__) >> 4U) <= GPIO_PORT_E)
+/**
+  * @}
+  */
+
+/** @defgroup GPIOEx_Fast_Pin_Operations GPIOEx Fast Pin Operations
+  * @brief    Operations on a pin descriptor, the arguments checked at compile
+  *           time only: a constant out of range stops the build, see
+  *           __HAL_CHECK_CONST(). The writes are a single store to BSRR or BRR,
+  *           atomic against the other pins of the port. The GPIO ports are out
+  *           of the peripheral bit-band region, BSRR and BRR take the place of
+  *           the bit-band aliases.
+  * @{
+  */
+#define __HAL_GPIO_PIN_SET(__DESC__)     (__HAL_CHECK_CONST(IS_GPIO_PIN_DESC(__DESC__)), \
+                                          GPIO_DESC_PORT(__DESC__)->BSRR = GPIO_DESC_MASK(__DESC__))
+#define __HAL_GPIO_PIN_RESET(__DESC__)   (__HAL_CHECK_CONST(IS_GPIO_PIN_DESC(__DESC__)), \
+                                          GPIO_DESC_PORT(__DESC__)->BRR = GPIO_DESC_MASK(__DESC__))
+#define __HAL_GPIO_PIN_WRITE(__DESC__, __STATE__) \
+          (__HAL_CHECK_CONST(IS_GPIO_PIN_DESC(__DESC__)), __HAL_CHECK_CONST(IS_GPIO_PIN_ACTION(__STATE__)), \
+           GPIO_DESC_PORT(__DESC__)->BSRR = GPIO_DESC_MASK(__DESC__) << (((__STATE__) != GPIO_PIN_RESET) ? 0U : 16U))
+#define __HAL_GPIO_PIN_READ(__DESC__)    (__HAL_CHECK_CONST(IS_GPIO_PIN_DESC(__DESC__)), \
+                                          (GPIO_PinState)((GPIO_DESC_PORT(__DESC__)->IDR >> GPIO_DESC_NUMBER(__DESC__)) & 1UL))
+#define __HAL_GPIO_PIN_TOGGLE(__DESC__)  __HAL_GPIO_PORT_TOGGLE(GPIO_DESC_PORT(__DESC__), GPIO_DESC_MASK(__DESC__))
+
+/**
+  * @brief  Switch a pin between input and output, for a bidirectional line
+  *         driven by software. The output level is kept in ODR.
+  * @note   MODER is read, modified and written: an interrupt changing the
+  *         mode of a pin of the same port in between is lost.
+  * @param  __DESC__ Pin descriptor.
+  * @param  __MODE__ GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_PP, GPIO_MODE_AF_PP or GPIO_MODE_ANALOG,
+  *         the output type kept.
+  * @retval None
+  */
+#define __HAL_GPIO_PIN_SET_MODE(__DESC__, __MODE__) \
+          MODIFY_REG(GPIO_DESC_PORT(__DESC__)->MODER, GPIO_MODER_MODE0 << (GPIO_DESC_NUMBER(__DESC__) * 2U), \
+                     ((uint32_t)(__MODE__) & GPIO_MODER_MODE0) << (GPIO_DESC_NUMBER(__DESC__) * 2U))
+/**
+  * @}
+  */
+
+/** @defgroup GPIOEx_Fast_Port_Operations GPIOEx Fast Port Operations
+  * @brief    Operations on several pins of a port, GPIO_PIN_x combined in __MASK__.
+  * @{
+  */
+#define __HAL_GPIO_PORT_READ(__GPIOx__)              ((__GPIOx__)->IDR & GPIO_PIN_MASK)
+#define __HAL_GPIO_PORT_READ_OUTPUT(__GPIOx__)       ((__GPIOx__)->ODR & GPIO_PIN_MASK)
+#define __HAL_GPIO_PORT_SET(__GPIOx__, __MASK__)     (__HAL_CHECK_CONST(IS_GPIO_PIN(__MASK__)), \
+                                                      (__GPIOx__)->BSRR = (uint32_t)(__MASK__))
+#define __HAL_GPIO_PORT_RESET(__GPIOx__, __MASK__)   (__HAL_CHECK_CONST(IS_GPIO_PIN(__MASK__)), \
+                                                      (__GPIOx__)->BRR = (uint32_t)(__MASK__))
+
+/**
+  * @brief  Write the pins of __MASK__ to the bits of __VALUE__ in one store, the
+  *         other pins untouched, a parallel bus updated at once.
+  * @param  __GPIOx__ GPIO port.
+  * @param  __MASK__ Pins written.
+  * @param  __VALUE__ Levels of the pins, bit x for pin x.
+  * @retval None
+  */
+#define __HAL_GPIO_PORT_WRITE(__GPIOx__, __MASK__, __VALUE__) \
+          (__HAL_CHECK_CONST(IS_GPIO_PIN(__MASK__)), \
+           (__GPIOx__)->BSRR = ((((uint32_t)(__MASK__)) & ~((uint32_t)(__VALUE__))) << 16U) | \
+                               (((uint32_t)(__MASK__)) & ((uint32_t)(__VALUE__))))
+
+/**
+  * @brief  Toggle the pins of __MASK__ in one store, ODR read once.
+  * @param  __GPIOx__ GPIO port.
+  * @param  __MASK__ Pins toggled.
+  * @retval None
+  */
+#define __HAL_GPIO_PORT_TOGGLE(__GPIOx__, __MASK__)   (__HAL_CHECK_CONST(IS_GPIO_PIN(__MASK__)), \
+                                                       HAL_GPIOEx_TogglePort((__GPIOx__), (__MASK__)))
+/**
+  * @}
+  */
+
 /**
   * @}
   */
 
 /* Exported functions --------------------------------------------------------*/
+/** @defgroup GPIOEx_Exported_Functions GPIOEx Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Toggle pins of a port in one store to BSRR.
+  * @param  GPIOx GPIO port.
+  * @param  Mask Pins toggled, any combination of GPIO_PIN_x.
+  * @retval None
+  */
+__STATIC_INLINE void HAL_GPIOEx_TogglePort(GPIO_TypeDef *GPIOx, uint32_t Mask)
+{
+  uint32_t odr = GPIOx->ODR;
+
+  GPIOx->BSRR = ((odr & Mask) << 16U) | (~odr & Mask);
+}
+
+/**
+  * @brief  Spread a pin mask to the 2 bits per pin of MODER, OSPEEDR and PUPDR.
+  * @param  Mask Pins, any combination of GPIO_PIN_x.
+  * @retval Bit 2x set for pin x
+  */
+__STATIC_INLINE uint32_t HAL_GPIOEx_Spread2(uint32_t Mask)
+{
+  Mask &= GPIO_PIN_MASK;
+  Mask = (Mask | (Mask << 8U)) & 0x00FF00FFUL;
+  Mask = (Mask | (Mask << 4U)) & 0x0F0F0F0FUL;
+  Mask = (Mask | (Mask << 2U)) & 0x33333333UL;
+  Mask = (Mask | (Mask << 1U)) & 0x55555555UL;
+
+  return Mask;
+}
+
+/**
+  * @brief  Set the mode of several pins of a port at once.
+  * @note   MODER is read, modified and written, see __HAL_GPIO_PIN_SET_MODE().
+  * @param  GPIOx GPIO port.
+  * @param  Mask Pins, any combination of GPIO_PIN_x.
+  * @param  Mode GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_PP, GPIO_MODE_AF_PP or GPIO_MODE_ANALOG,
+  *         the output type kept.
+  * @retval None
+  */
+__STATIC_INLINE void HAL_GPIOEx_SetPortMode(GPIO_TypeDef *GPIOx, uint32_t Mask, uint32_t Mode)
+{
+  uint32_t spread = HAL_GPIOEx_Spread2(Mask);
+
+  MODIFY_REG(GPIOx->MODER, spread * GPIO_MODER_MODE0, spread * (Mode & GPIO_MODER_MODE0));
+}
+
+void HAL_GPIOEx_ConfigPort(GPIO_TypeDef *GPIOx, const GPIO_InitTypeDef *GPIO_Init);
+/**
+  * @}
+  */
+
 /**
   * @}
   */
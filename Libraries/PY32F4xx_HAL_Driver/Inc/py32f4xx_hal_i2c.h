@@ -528,6 +528,9 @@ typedef  void (*pI2C_AddrCallbackTypeDef)(I2C_HandleTypeDef *hi2c, uint8_t Trans
   * @}
   */
 
+/* Include I2C HAL Extended module */
+#include "py32f4xx_hal_i2c_ex.h"
+
 /* Exported functions --------------------------------------------------------*/
 /** @addtogroup I2C_Exported_Functions
   * @{
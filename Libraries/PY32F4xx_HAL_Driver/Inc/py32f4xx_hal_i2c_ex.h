@@ -0,0 +1,154 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_i2c_ex.h
+  * @author  MCU Application Team
+  * @brief   Header file of I2C HAL Extended module.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_HAL_I2C_EX_H
+#define PY32F4xx_HAL_I2C_EX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal_def.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @addtogroup I2CEx
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup I2CEx_Exported_Types I2CEx Exported Types
+  * @{
+  */
+
+/**
+  * @brief  I2C bus description used by the timing calculation
+  */
+typedef struct
+{
+  uint32_t ClockSpeed;       /*!< Specifies the target SCL frequency in Hz.
+                                  This parameter must be set to a value lower than 400kHz */
+
+  uint32_t RiseTime;         /*!< Specifies the SCL rise time of the bus in ns, 30 % to 70 % of VDD.
+                                  At most 1000 ns in standard mode and 300 ns in fast mode */
+
+  uint32_t FallTime;         /*!< Specifies the SCL fall time of the bus in ns, 70 % to 30 % of VDD.
+                                  At most 300 ns */
+
+  uint32_t AnalogFilter;     /*!< Specifies the I2C pins carrying the bus.
+                                  This parameter can be a combination of @ref SYSCFG_I2C_ANF or 0 */
+
+} I2C_TimingConfigTypeDef;
+
+/**
+  * @brief  I2C timing computed by HAL_I2CEx_CalcTiming()
+  */
+typedef struct
+{
+  uint32_t CCR;              /*!< I2C CCR register value, FS, DUTY and CCR fields         */
+
+  uint32_t TRISE;            /*!< I2C TRISE register value                                */
+
+  uint32_t FreqRange;        /*!< I2C CR2 FREQ field value, PCLK1 in MHz                  */
+
+  uint32_t DutyCycle;        /*!< Fast mode duty cycle, a value of @ref I2C_duty_cycle_in_fast_mode */
+
+  uint32_t ClockSpeed;       /*!< Expected SCL frequency in Hz, at most the target one    */
+
+  uint32_t AnalogFilter;     /*!< Pins whose analog filter is enabled, fast mode only     */
+
+} I2C_TimingTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/** @defgroup I2CEx_Exported_Macros I2CEx Exported Macros
+  * @{
+  */
+
+/** @brief  Polling budget of the fast functions covering two bytes on the bus.
+  * @param  __HCLK__ CPU frequency, HAL_RCC_GetHCLKFreq().
+  * @param  __SPEED__ SCL frequency in Hz.
+  * @retval Number of status register polls, each lasting at least one cycle
+  */
+#define HAL_I2CEX_FAST_BUDGET(__HCLK__, __SPEED__)   (((__HCLK__) / (__SPEED__)) * 18U)
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup I2CEx_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup I2CEx_Exported_Functions_Group1
+  * @{
+  */
+/* Timing functions ***********************************************************/
+HAL_StatusTypeDef HAL_I2CEx_CalcTiming(uint32_t PclkFreq, const I2C_TimingConfigTypeDef *pConfig,
+                                       I2C_TimingTypeDef *pTiming);
+HAL_StatusTypeDef HAL_I2CEx_ConfigTiming(I2C_HandleTypeDef *hi2c, const I2C_TimingTypeDef *pTiming);
+HAL_StatusTypeDef HAL_I2CEx_MeasureClockSpeed(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                              uint16_t Size, uint32_t Timeout, uint32_t *pClockSpeed);
+/**
+  * @}
+  */
+
+/** @addtogroup I2CEx_Exported_Functions_Group2
+  * @{
+  */
+/* Fast IO functions **********************************************************/
+HAL_StatusTypeDef HAL_I2CEx_FastWrite(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, const uint8_t *pData, uint16_t Size, uint32_t Budget);
+HAL_StatusTypeDef HAL_I2CEx_FastRead(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                     uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Budget);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_HAL_I2C_EX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -384,6 +384,9 @@ typedef  void (*pI2S_CallbackTypeDef)(I2S_HandleTypeDef *hi2s); /*!< pointer to
   * @}
   */
 
+/* Include I2S HAL Extended module */
+#include "py32f4xx_hal_i2s_ex.h"
+
 /* Exported functions --------------------------------------------------------*/
 /** @addtogroup I2S_Exported_Functions
   * @{
@@ -424,6 +427,7 @@ void HAL_I2S_IRQHandler(I2S_HandleTypeDef *hi2s);
 /* Non-Blocking mode: DMA */
 HAL_StatusTypeDef HAL_I2S_Transmit_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_I2S_Receive_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2S_ReceiveToRing_DMA(I2S_HandleTypeDef *hi2s, DMA_RingTypeDef *pRing);
 
 HAL_StatusTypeDef HAL_I2S_DMAPause(I2S_HandleTypeDef *hi2s);
 HAL_StatusTypeDef HAL_I2S_DMAResume(I2S_HandleTypeDef *hi2s);
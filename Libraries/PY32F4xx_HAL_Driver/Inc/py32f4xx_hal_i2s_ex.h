@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_i2s_ex.h
+  * @author  MCU Application Team
+  * @brief   Header file of I2S HAL Extended module.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_HAL_I2S_EX_H
+#define PY32F4xx_HAL_I2S_EX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal_def.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @addtogroup I2SEx
+  * @{
+  */
+
+/* Exported types ------------------------------------------------------------*/
+/** @defgroup I2SEx_Exported_Types I2SEx Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Audio stream and clock tree description used by the clock calculation
+  */
+typedef struct
+{
+  uint32_t AudioFreq;        /*!< Specifies the target sample rate in Hz.
+                                  This parameter must be a value between 8 kHz and 192 kHz */
+
+  uint32_t Standard;         /*!< Specifies the I2S standard of the stream.
+                                  This parameter can be a value of @ref I2S_Standard */
+
+  uint32_t DataFormat;       /*!< Specifies the data format of the stream.
+                                  This parameter can be a value of @ref I2S_Data_Format */
+
+  uint32_t MCLKOutput;       /*!< Specifies whether the master clock is output.
+                                  This parameter can be a value of @ref I2S_MCLK_Output */
+
+  uint32_t PLLSources;       /*!< Specifies the PLL entry clocks to try.
+                                  This parameter can be a combination of @ref I2SEx_PLL_Sources */
+
+  uint32_t SysClkMin;        /*!< Specifies the lowest SYSCLK frequency accepted in Hz */
+
+  uint32_t SysClkMax;        /*!< Specifies the highest SYSCLK frequency accepted in Hz,
+                                  0 for @ref I2SEX_SYSCLK_MAX */
+
+  uint32_t Tolerance;        /*!< Specifies the sample rate error in ppb below which a faster
+                                  SYSCLK is preferred to a more accurate one, 0 for the most accurate */
+
+} I2S_ClockConfigTypeDef;
+
+/**
+  * @brief  I2S clock computed by HAL_I2SEx_CalcClock()
+  */
+typedef struct
+{
+  RCC_PLLInitTypeDef PLL;    /*!< PLL setting, ready for HAL_RCC_OscConfig()               */
+
+  uint32_t SysClkFreq;       /*!< SYSCLK frequency in Hz, also the I2S kernel clock        */
+
+  uint32_t I2SPR;            /*!< SPI I2SPR register value, I2SDIV, ODD and MCKOE fields   */
+
+  uint32_t AudioFreq;        /*!< Achieved sample rate in mHz                              */
+
+  int32_t  Error;            /*!< Achieved sample rate error in ppb, positive when faster  */
+
+} I2S_ClockTypeDef;
+
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup I2SEx_Exported_Constants I2SEx Exported Constants
+  * @{
+  */
+
+/** @defgroup I2SEx_PLL_Sources I2SEx PLL Sources
+  * @{
+  */
+#define I2SEX_PLLSOURCE_HSE              (0x00000001U)     /*!< HSE_VALUE                    */
+#define I2SEX_PLLSOURCE_HSE_DIV2         (0x00000002U)     /*!< HSE_VALUE / 2                */
+#define I2SEX_PLLSOURCE_HSI              (0x00000004U)     /*!< HSI_VALUE, 1 % accurate      */
+/**
+  * @}
+  */
+
+#if !defined (I2SEX_SYSCLK_MAX)
+#define I2SEX_SYSCLK_MAX                 (144000000U)      /*!< Highest SYSCLK of the latency table */
+#endif
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @addtogroup I2SEx_Exported_Functions
+  * @{
+  */
+
+/** @addtogroup I2SEx_Exported_Functions_Group1
+  * @{
+  */
+/* Clock functions ************************************************************/
+HAL_StatusTypeDef HAL_I2SEx_CalcClock(const I2S_ClockConfigTypeDef *pConfig, I2S_ClockTypeDef *pClock);
+HAL_StatusTypeDef HAL_I2SEx_ConfigSysClock(const I2S_ClockTypeDef *pClock, const RCC_ClkInitTypeDef *pClkInit);
+HAL_StatusTypeDef HAL_I2SEx_ConfigPrescaler(I2S_HandleTypeDef *hi2s, const I2S_ClockTypeDef *pClock);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_HAL_I2S_EX_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
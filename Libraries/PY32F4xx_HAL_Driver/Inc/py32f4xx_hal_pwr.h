@@ -183,6 +183,17 @@ typedef struct
 #define PWR_STANDBYENTRY_WFI               ((uint8_t)0x01)
 #define PWR_STANDBYENTRY_WFE               ((uint8_t)0x02)
 
+/**
+  * @}
+  */
+
+/** @defgroup PWR_Low_Power_Mode PWR Low Power Mode
+  * @brief    Mode given to the low power mode hooks
+  * @{
+  */
+#define PWR_LOWPOWERMODE_SLEEP          0x00000001U
+#define PWR_LOWPOWERMODE_STOP           0x00000002U
+
 /**
   * @}
   */
@@ -406,6 +417,10 @@ void HAL_PWR_DisableSEVOnPend(void);
 
 void HAL_PWR_PVD_IRQHandler(void);
 void HAL_PWR_PVDCallback(void);
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+void HAL_PWR_EnterModeCallback(uint32_t Mode);
+void HAL_PWR_ExitModeCallback(uint32_t Mode);
+#endif /* USE_HAL_PWR_MODE_HOOKS */
 /**
   * @}
   */
@@ -130,6 +130,7 @@
 void HAL_PWREx_SetWakeupFlashDelay(uint32_t DelayTime);
 uint32_t HAL_PWREx_GetWakeupFlashDelay(void); 
 void HAL_PWREx_DisableHSIWakeupWait(void); 
+void HAL_PWREx_EnableHSIWakeupWait(void);
 uint32_t HAL_PWREx_GetVoltageRange(void);
 void HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling);
 
@@ -1362,6 +1362,7 @@ void              HAL_RCC_EnableCSS(void);
 void              HAL_RCC_DisableCSS(void);
 uint32_t          HAL_RCC_GetSysClockFreq(void);
 uint32_t          HAL_RCC_GetHCLKFreq(void);
+uint32_t          HAL_RCC_GetFlashLatency(uint32_t HCLKFreq);
 uint32_t          HAL_RCC_GetPCLK1Freq(void);
 uint32_t          HAL_RCC_GetPCLK2Freq(void);
 void              HAL_RCC_GetOscConfig(RCC_OscInitTypeDef  *RCC_OscInitStruct);
@@ -114,6 +114,57 @@ typedef struct
   
 } RCC_PeriphCLKInitTypeDef;
 
+/**
+  * @brief  Clock tree constraints, input of HAL_RCCEx_CalcClockTree()
+  */
+typedef struct
+{
+  uint32_t PLLSources;                     /*!< Entry clocks to try, directly or through the PLL.
+                                            This parameter can be a combination of @ref RCCEx_Clock_Tree_Sources */
+
+  uint32_t SysClkMin;                      /*!< Lowest SYSCLK frequency accepted in Hz */
+
+  uint32_t SysClkMax;                      /*!< Highest SYSCLK frequency accepted in Hz, 0 for @ref RCC_SYSCLK_FREQ_MAX */
+
+  uint32_t PCLK1Max;                       /*!< Highest PCLK1 frequency in Hz, 0 for HCLK */
+
+  uint32_t PCLK1Multiple;                  /*!< PCLK1 must be a multiple of this frequency in Hz, 0 for any:
+                                            the baud rate of a UART on APB1, the bit rate times the time
+                                            quanta of a bit */
+
+  uint32_t PCLK2Max;                       /*!< Highest PCLK2 frequency in Hz, 0 for HCLK */
+
+  uint32_t PCLK2Multiple;                  /*!< PCLK2 must be a multiple of this frequency in Hz, 0 for any */
+
+  uint32_t UsbClock;                       /*!< 48 MHz USB clock.
+                                            This parameter can be a value of @ref RCCEx_Clock_Tree_USB */
+
+  uint32_t CanClockFreq;                   /*!< Exact CAN kernel clock in Hz, from the PLL or the HSE, 0 for none */
+
+} RCC_ClockTreeConfigTypeDef;
+
+/**
+  * @brief  Clock tree computed by HAL_RCCEx_CalcClockTree()
+  */
+typedef struct
+{
+  RCC_OscInitTypeDef OscInit;              /*!< Oscillators and PLL, ready for HAL_RCC_OscConfig() */
+
+  RCC_ClkInitTypeDef ClkInit;              /*!< SYSCLK source and bus dividers, ready for HAL_RCC_ClockConfig()
+                                            with FlashLatency */
+
+  uint32_t FlashLatency;                   /*!< FLASH_LATENCY_AUTO, the wait states of the new HCLK */
+
+  RCC_PeriphCLKInitTypeDef PeriphClkInit;  /*!< USB and CAN clocks asked, ready for HAL_RCCEx_PeriphCLKConfig() */
+
+  uint32_t SysClkFreq;                     /*!< SYSCLK and HCLK frequency in Hz */
+
+  uint32_t PCLK1Freq;                      /*!< PCLK1 frequency in Hz */
+
+  uint32_t PCLK2Freq;                      /*!< PCLK2 frequency in Hz */
+
+} RCC_ClockTreeTypeDef;
+
 /**
   * @}
   */
@@ -159,7 +210,7 @@ typedef struct
 #define RCC_USBCLKSOURCE_PLL_DIV3         (RCC_CFGR_USBPRE_2)
 #define RCC_USBCLKSOURCE_PLL_DIV3_5       (RCC_CFGR_USBPRE_2 | RCC_CFGR_USBPRE_0)
 #define RCC_USBCLKSOURCE_PLL_DIV4         (RCC_CFGR_USBPRE_2 | RCC_CFGR_USBPRE_1)
-#define RCC_USBCLKSOURCE_HSI48M           RCC_CFGR1_USBSELHSI48
+#define RCC_USBCLKSOURCE_HSI48M           0x00000001U                 /* RCC_CFGR1_USBSELHSI48, not a USBPRE value */
 
 /**
   * @}
@@ -182,6 +233,33 @@ typedef struct
   * @}
   */
 
+/** @defgroup RCCEx_Clock_Tree_Sources Clock Tree Sources
+  * @{
+  */
+#define RCC_CLOCKTREE_SOURCE_HSE         0x00000001U    /*!< HSE_VALUE, direct or PLL entry */
+#define RCC_CLOCKTREE_SOURCE_HSE_DIV2    0x00000002U    /*!< HSE_VALUE / 2, PLL entry       */
+#define RCC_CLOCKTREE_SOURCE_HSI         0x00000004U    /*!< HSI_VALUE, direct or PLL entry */
+
+/**
+  * @}
+  */
+
+/** @defgroup RCCEx_Clock_Tree_USB Clock Tree USB
+  * @{
+  */
+#define RCC_CLOCKTREE_USB_NONE           0x00000000U    /*!< No USB clock                                */
+#define RCC_CLOCKTREE_USB_PLL            0x00000001U    /*!< PLL divided by the USB prescaler            */
+#define RCC_CLOCKTREE_USB_PLL_OR_HSI48M  0x00000002U    /*!< From the PLL, otherwise the HSI48M, trimmed
+                                                             on the USB SOF by the CTC                   */
+
+/**
+  * @}
+  */
+
+#if !defined (RCC_SYSCLK_FREQ_MAX)
+#define RCC_SYSCLK_FREQ_MAX              144000000U     /*!< Highest SYSCLK of the flash latency table   */
+#endif
+
 /** @defgroup RCCEx_Prediv1_Factor HSE Prediv1 Factor
   * @{
   */
@@ -656,6 +734,41 @@ typedef struct
 #define __HAL_RCC_TIM10_RELEASE_RESET()     (RCC->APB2RSTR &= ~(RCC_APB2RSTR_TIM10RST))
 #define __HAL_RCC_TIM11_RELEASE_RESET()     (RCC->APB2RSTR &= ~(RCC_APB2RSTR_TIM11RST))
 
+/**
+  * @}
+  */
+
+/** @defgroup RCCEx_PLL_Factor PLL Factor
+  * @brief  Macros computing a PLL setting, usable in preprocessor conditions.
+  * @{
+  */
+
+/**
+  * @brief  RCC_PLL_MULx value of a multiplication factor, PLLMULL[3:0] and PLLMULL[5:4] apart in CFGR.
+  * @param  __FACTOR__ Multiplication factor, 2 to 63.
+  */
+#define RCC_PLL_MUL_FACTOR(__FACTOR__) \
+  (((((__FACTOR__) - 2U) & 0x0FU) << RCC_CFGR_PLLMULL_Pos) | ((((__FACTOR__) - 2U) >> 4U) << (RCC_CFGR_PLLMULL_Pos + 11U)))
+
+/**
+  * @brief  Highest multiplication factor of an entry clock, SYSCLK at most a frequency.
+  * @param  __ENTRY__ PLL entry clock in Hz.
+  * @param  __SYSCLK_MAX__ Highest SYSCLK in Hz.
+  * @retval Factor, up to 63, below 2 when the entry clock is too fast
+  */
+#define RCC_PLL_FACTOR_MAX(__ENTRY__, __SYSCLK_MAX__) \
+  ((((__SYSCLK_MAX__) / (__ENTRY__)) > 63U) ? 63U : ((__SYSCLK_MAX__) / (__ENTRY__)))
+
+/**
+  * @brief  Multiplication factor of an entry clock giving a SYSCLK exactly.
+  * @param  __ENTRY__ PLL entry clock in Hz.
+  * @param  __SYSCLK__ SYSCLK in Hz.
+  * @retval Factor, 2 to 63, 0 when the SYSCLK cannot be reached
+  */
+#define RCC_PLL_FACTOR_EXACT(__ENTRY__, __SYSCLK__) \
+  (((((__SYSCLK__) % (__ENTRY__)) == 0U) && (((__SYSCLK__) / (__ENTRY__)) >= 2U) && \
+    (((__SYSCLK__) / (__ENTRY__)) <= 63U)) ? ((__SYSCLK__) / (__ENTRY__)) : 0U)
+
 /**
   * @}
   */
@@ -791,6 +904,16 @@ HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef  *PeriphClk
 void              HAL_RCCEx_GetPeriphCLKConfig(RCC_PeriphCLKInitTypeDef  *PeriphClkInit);
 uint32_t          HAL_RCCEx_GetPeriphCLKFreq(uint32_t PeriphClk);
 
+/**
+  * @}
+  */
+
+/** @addtogroup RCCEx_Exported_Functions_Group2
+  * @{
+  */
+
+HAL_StatusTypeDef HAL_RCCEx_CalcClockTree(const RCC_ClockTreeConfigTypeDef *pConfig, RCC_ClockTreeTypeDef *pTree);
+
 /**
   * @}
   */
@@ -232,6 +232,45 @@ typedef  void (*pSMARTCARD_CallbackTypeDef)(SMARTCARD_HandleTypeDef *hsc);  /*!<
 
 #endif /* USE_HAL_SMARTCARD_REGISTER_CALLBACKS */
 
+/* T=1 block layout: prologue, information field and up to 2 bytes of EDC */
+#define SMARTCARD_T1_PROLOGUE_SIZE          3U             /*!< NAD, PCB and LEN                       */
+#define SMARTCARD_T1_INF_SIZE               254U           /*!< Maximum information field size         */
+#define SMARTCARD_T1_BLOCK_SIZE             (SMARTCARD_T1_PROLOGUE_SIZE + SMARTCARD_T1_INF_SIZE + 2U)
+
+/**
+  * @brief  SMARTCARD T=1 block protocol context definition
+  * @note   NAD, IFSC, EDC, BWT and Retries are set by the application from the card ATR
+  *         before HAL_SMARTCARD_T1_Init(), the other members are managed by the driver.
+  */
+typedef struct
+{
+  uint8_t                          NAD;              /*!< Node address byte of the blocks sent */
+
+  uint8_t                          IFSC;             /*!< Maximum information field size accepted by the card, 1 to 254 */
+
+  uint8_t                          NS;               /*!< Send sequence number of the next I-block */
+
+  uint8_t                          NR;               /*!< Send sequence number of the next I-block expected from the card */
+
+  uint32_t                         EDC;              /*!< Epilogue error detection code.
+                                                          This parameter can be a value of @ref SMARTCARD_T1_EDC */
+
+  uint32_t                         BWT;              /*!< Block waiting time in ms */
+
+  uint32_t                         Retries;          /*!< Number of retransmissions of a block before the exchange fails */
+
+  uint32_t                         WTX;              /*!< BWT multiplier granted to the card for the next block */
+
+  uint32_t                         Tickstamp;        /*!< Tick of the end of the last block received */
+
+  uint32_t                         TxLength;         /*!< Length of the block in TxBlock */
+
+  uint8_t                          TxBlock[SMARTCARD_T1_BLOCK_SIZE]; /*!< Last block sent, kept for retransmission */
+
+  uint8_t                          RxBlock[SMARTCARD_T1_BLOCK_SIZE]; /*!< Last block received */
+
+} SMARTCARD_T1TypeDef;
+
 /**
   * @}
   */
@@ -253,6 +292,8 @@ typedef  void (*pSMARTCARD_CallbackTypeDef)(SMARTCARD_HandleTypeDef *hsc);  /*!<
 #if (USE_HAL_SMARTCARD_REGISTER_CALLBACKS == 1)
 #define HAL_SMARTCARD_ERROR_INVALID_CALLBACK 0x00000020U   /*!< Invalid Callback error  */
 #endif /* USE_HAL_SMARTCARD_REGISTER_CALLBACKS */
+#define HAL_SMARTCARD_ERROR_EDC              0x00000040U   /*!< T=1 block EDC error     */
+#define HAL_SMARTCARD_ERROR_PROTOCOL         0x00000080U   /*!< T=1 protocol error      */
 /**
   * @}
   */
@@ -338,6 +379,15 @@ typedef  void (*pSMARTCARD_CallbackTypeDef)(SMARTCARD_HandleTypeDef *hsc);  /*!<
   * @}
   */
 
+/** @defgroup SMARTCARD_T1_EDC SMARTCARD T=1 Error Detection Code
+  * @{
+  */
+#define SMARTCARD_T1_EDC_LRC                0x00000000U    /*!< Longitudinal redundancy check, 1 byte */
+#define SMARTCARD_T1_EDC_CRC                0x00000001U    /*!< ISO/IEC 13239 CRC, 2 bytes             */
+/**
+  * @}
+  */
+
 /** @defgroup SMARTCARD_Prescaler SMARTCARD Prescaler
   * @{
   */
@@ -669,6 +719,18 @@ uint32_t HAL_SMARTCARD_GetError(SMARTCARD_HandleTypeDef *hsc);
   * @}
   */
 
+/** @addtogroup SMARTCARD_Exported_Functions_Group4
+  * @{
+  */
+/* T=1 block protocol functions *************************************************/
+HAL_StatusTypeDef HAL_SMARTCARD_T1_Init(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1);
+HAL_StatusTypeDef HAL_SMARTCARD_T1_Transceive(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1,
+                                              const uint8_t *pCommand, uint32_t CommandLength,
+                                              uint8_t *pResponse, uint32_t ResponseSize, uint32_t *pResponseLength);
+/**
+  * @}
+  */
+
 /**
   * @}
   */
@@ -708,6 +770,7 @@ uint32_t HAL_SMARTCARD_GetError(SMARTCARD_HandleTypeDef *hsc);
 #define IS_SMARTCARD_NACK_STATE(NACK)       (((NACK) == SMARTCARD_NACK_ENABLE) || \
                                              ((NACK) == SMARTCARD_NACK_DISABLE))
 #define IS_SMARTCARD_BAUDRATE(BAUDRATE)     ((BAUDRATE) < 4500001U)
+#define IS_SMARTCARD_T1_EDC(EDC)            (((EDC) == SMARTCARD_T1_EDC_LRC) || ((EDC) == SMARTCARD_T1_EDC_CRC))
 
 #define SMARTCARD_DIV(__PCLK__, __BAUD__)                (((__PCLK__)*25U)/(4U*(__BAUD__)))
 #define SMARTCARD_DIVMANT(__PCLK__, __BAUD__)            (SMARTCARD_DIV((__PCLK__), (__BAUD__))/100U)
@@ -102,6 +102,27 @@ typedef enum
   HAL_SPI_STATE_ABORT      = 0x07U     /*!< SPI abort is ongoing                               */
 } HAL_SPI_StateTypeDef;
 
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+struct __SPI_HandleTypeDef;
+
+/**
+  * @brief  SPI callback table definition, const to stay in FLASH and shared by the handles
+  */
+typedef struct
+{
+  void (* TxCpltCallback)(struct __SPI_HandleTypeDef *hspi);             /*!< SPI Tx Completed callback          */
+  void (* RxCpltCallback)(struct __SPI_HandleTypeDef *hspi);             /*!< SPI Rx Completed callback          */
+  void (* TxRxCpltCallback)(struct __SPI_HandleTypeDef *hspi);           /*!< SPI TxRx Completed callback        */
+  void (* TxHalfCpltCallback)(struct __SPI_HandleTypeDef *hspi);         /*!< SPI Tx Half Completed callback     */
+  void (* RxHalfCpltCallback)(struct __SPI_HandleTypeDef *hspi);         /*!< SPI Rx Half Completed callback     */
+  void (* TxRxHalfCpltCallback)(struct __SPI_HandleTypeDef *hspi);       /*!< SPI TxRx Half Completed callback   */
+  void (* ErrorCallback)(struct __SPI_HandleTypeDef *hspi);              /*!< SPI Error callback                 */
+  void (* AbortCpltCallback)(struct __SPI_HandleTypeDef *hspi);          /*!< SPI Abort callback                 */
+  void (* MspInitCallback)(struct __SPI_HandleTypeDef *hspi);            /*!< SPI Msp Init callback              */
+  void (* MspDeInitCallback)(struct __SPI_HandleTypeDef *hspi);          /*!< SPI Msp DeInit callback            */
+} SPI_CallbacksTypeDef;
+#endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
+
 /**
   * @brief  SPI handle Structure definition
   */
@@ -151,6 +172,8 @@ typedef struct __SPI_HandleTypeDef
   void (* MspInitCallback)(struct __SPI_HandleTypeDef *hspi);            /*!< SPI Msp Init callback              */
   void (* MspDeInitCallback)(struct __SPI_HandleTypeDef *hspi);          /*!< SPI Msp DeInit callback            */
 
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  const SPI_CallbacksTypeDef *pCallbacks;    /*!< SPI callback table, the default one when NULL at init */
 #endif  /* USE_HAL_SPI_REGISTER_CALLBACKS */
 } SPI_HandleTypeDef;
 
@@ -199,7 +222,7 @@ typedef  void (*pSPI_CallbackTypeDef)(SPI_HandleTypeDef *hspi); /*!< pointer to
 #define HAL_SPI_ERROR_DMA               (0x00000010U)   /*!< DMA transfer error                     */
 #define HAL_SPI_ERROR_FLAG              (0x00000020U)   /*!< Error on RXNE/TXE/BSY/FTLVL/FRLVL Flag */
 #define HAL_SPI_ERROR_ABORT             (0x00000040U)   /*!< Error during SPI Abort procedure       */
-#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
+#if (USE_HAL_SPI_REGISTER_CALLBACKS != 0U)
 #define HAL_SPI_ERROR_INVALID_CALLBACK  (0x00000080U)   /*!< Invalid Callback error                 */
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
 /**
@@ -701,6 +724,8 @@ void HAL_SPI_MspDeInit(SPI_HandleTypeDef *hspi);
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
 HAL_StatusTypeDef HAL_SPI_RegisterCallback(SPI_HandleTypeDef *hspi, HAL_SPI_CallbackIDTypeDef CallbackID, pSPI_CallbackTypeDef pCallback);
 HAL_StatusTypeDef HAL_SPI_UnRegisterCallback(SPI_HandleTypeDef *hspi, HAL_SPI_CallbackIDTypeDef CallbackID);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+HAL_StatusTypeDef HAL_SPI_RegisterCallbackTable(SPI_HandleTypeDef *hspi, const SPI_CallbacksTypeDef *pCallbacks);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
 /**
   * @}
@@ -720,6 +745,9 @@ HAL_StatusTypeDef HAL_SPI_TransmitReceive_IT(SPI_HandleTypeDef *hspi, uint8_t *p
                                              uint16_t Size);
 HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_ReceiveToRing_DMA(SPI_HandleTypeDef *hspi, DMA_RingTypeDef *pRing);
+HAL_StatusTypeDef HAL_SPI_TransmitReceiveStream_DMA(SPI_HandleTypeDef *hspi, uint8_t *pPattern, uint16_t PatternSize,
+                                                    uint8_t *pRxData, uint16_t Size);
 HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
                                               uint16_t Size);
 HAL_StatusTypeDef HAL_SPI_DMAPause(SPI_HandleTypeDef *hspi);
@@ -53,6 +53,11 @@ extern "C" {
   * @{
   */
 HAL_StatusTypeDef HAL_SPIEx_FlushRxFifo(SPI_HandleTypeDef *hspi);
+#if (USE_SPI_CRC != 0U)
+HAL_StatusTypeDef HAL_SPIEx_TransmitReceiveCRC_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                                   uint16_t Size, uint32_t Polynomial);
+HAL_StatusTypeDef HAL_SPIEx_DisableCRC(SPI_HandleTypeDef *hspi);
+#endif /* USE_SPI_CRC */
 /**
   * @}
   */
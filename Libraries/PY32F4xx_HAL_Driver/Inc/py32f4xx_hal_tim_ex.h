@@ -92,6 +92,16 @@ typedef struct
   * @{
   */
 
+/**
+  * @brief  Build a GPIO BSRR word for HAL_TIMEx_GPIOWave_Start_DMA().
+  * @param  __SET__ Pins driven high, combination of GPIO_PIN_x.
+  * @param  __RESET__ Pins driven low, combination of GPIO_PIN_x. Set wins
+  *         when a pin is in both masks.
+  * @retval BSRR word
+  */
+#define __HAL_TIM_GPIO_BSRR(__SET__, __RESET__)                                           \
+          ((((uint32_t)(__RESET__) & 0xFFFFU) << 16U) | ((uint32_t)(__SET__) & 0xFFFFU))
+
 /**
   * @}
   */
@@ -235,6 +245,19 @@ HAL_TIM_StateTypeDef HAL_TIMEx_HallSensor_GetState(TIM_HandleTypeDef *htim);
   * @}
   */
 
+/** @addtogroup TIMEx_Exported_Functions_Group8 Extended Timer GPIO waveform functions
+  * @brief    Extended Timer GPIO waveform functions
+  * @{
+  */
+/* Extended GPIO waveform functions  ******************************************/
+HAL_StatusTypeDef HAL_TIMEx_GPIOWave_Start_DMA(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx,
+                                               const uint32_t *pData, uint16_t Length);
+HAL_StatusTypeDef HAL_TIMEx_GPIOCapture_Start_DMA(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx,
+                                                  uint16_t *pData, uint16_t Length);
+/**
+  * @}
+  */
+
 /**
   * @}
   */
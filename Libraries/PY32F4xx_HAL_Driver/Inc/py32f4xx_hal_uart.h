@@ -154,6 +154,54 @@ typedef struct
 } UART_AdvFeatureInitTypeDef;
 
 
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+/**
+  * @brief  HAL UART Reception timestamp definition
+  * @note   Values are DWT->CYCCNT core cycle counts. The silent time between two
+  *         frames separated by an IDLE line is the Start of the second one minus
+  *         the End of the first one.
+  */
+typedef struct
+{
+  uint32_t Start;                     /*!< Cycle count at the first byte of the frame (RXNE of its stop bit) */
+
+  uint32_t End;                       /*!< Cycle count at the event reporting the frame (IDLE line, DMA half
+                                           transfer or transfer complete) */
+} UART_RxTimestampTypeDef;
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
+/**
+  * @brief  HAL UART Reception type definition
+  * @note   HAL UART Reception type value aims to identify which type of Reception is ongoing.
+  *         It is expected to admit following values :
+  *           HAL_UART_RECEPTION_STANDARD         = 0x00U,
+  *           HAL_UART_RECEPTION_TOIDLE           = 0x01U,
+  */
+typedef uint32_t HAL_UART_RxTypeTypeDef;
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+struct __UART_HandleTypeDef;
+
+/**
+  * @brief  UART callback table definition, const to stay in FLASH and shared by the handles
+  */
+typedef struct
+{
+  void (* TxHalfCpltCallback)(struct __UART_HandleTypeDef *huart);        /*!< UART Tx Half Complete Callback        */
+  void (* TxCpltCallback)(struct __UART_HandleTypeDef *huart);            /*!< UART Tx Complete Callback             */
+  void (* RxHalfCpltCallback)(struct __UART_HandleTypeDef *huart);        /*!< UART Rx Half Complete Callback        */
+  void (* RxCpltCallback)(struct __UART_HandleTypeDef *huart);            /*!< UART Rx Complete Callback             */
+  void (* ErrorCallback)(struct __UART_HandleTypeDef *huart);             /*!< UART Error Callback                   */
+  void (* AbortCpltCallback)(struct __UART_HandleTypeDef *huart);         /*!< UART Abort Complete Callback          */
+  void (* AbortTransmitCpltCallback)(struct __UART_HandleTypeDef *huart); /*!< UART Abort Transmit Complete Callback */
+  void (* AbortReceiveCpltCallback)(struct __UART_HandleTypeDef *huart);  /*!< UART Abort Receive Complete Callback  */
+  void (* RxFrameCallback)(struct __UART_HandleTypeDef *huart, uint16_t Offset, uint16_t Length); /*!< UART Reception Frame Callback */
+
+  void (* MspInitCallback)(struct __UART_HandleTypeDef *huart);           /*!< UART Msp Init callback                */
+  void (* MspDeInitCallback)(struct __UART_HandleTypeDef *huart);         /*!< UART Msp DeInit callback              */
+} UART_CallbacksTypeDef;
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
 /**
   * @brief  UART handle Structure definition
   */
@@ -177,6 +225,19 @@ typedef struct __UART_HandleTypeDef
 
   __IO uint16_t                 RxXferCount;      /*!< UART Rx Transfer Counter           */
 
+  __IO HAL_UART_RxTypeTypeDef   ReceptionType;    /*!< Type of ongoing reception          */
+
+  uint16_t                      RxFramePos;       /*!< Rx buffer offset of the next frame reported
+                                                       in reception till idle mode       */
+
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+  UART_RxTimestampTypeDef       RxTimestamp;      /*!< Timestamps of the frame reported in reception
+                                                       till idle mode                    */
+
+  __IO uint32_t                 RxStartCycle;     /*!< Cycle count of the first byte after the previous
+                                                       frame report                      */
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
   DMA_HandleTypeDef             *hdmatx;          /*!< UART Tx DMA Handle parameters      */
 
   DMA_HandleTypeDef             *hdmarx;          /*!< UART Rx DMA Handle parameters      */
@@ -202,9 +263,12 @@ typedef struct __UART_HandleTypeDef
   void (* AbortTransmitCpltCallback)(struct __UART_HandleTypeDef *huart); /*!< UART Abort Transmit Complete Callback */
   void (* AbortReceiveCpltCallback)(struct __UART_HandleTypeDef *huart);  /*!< UART Abort Receive Complete Callback  */
   void (* WakeupCallback)(struct __UART_HandleTypeDef *huart);            /*!< UART Wakeup Callback                  */
+  void (* RxFrameCallback)(struct __UART_HandleTypeDef *huart, uint16_t Offset, uint16_t Length); /*!< UART Reception Frame Callback */
 
   void (* MspInitCallback)(struct __UART_HandleTypeDef *huart);           /*!< UART Msp Init callback                */
   void (* MspDeInitCallback)(struct __UART_HandleTypeDef *huart);         /*!< UART Msp DeInit callback              */
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  const UART_CallbacksTypeDef   *pCallbacks;      /*!< UART callback table, the default one when NULL at init */
 #endif  /* USE_HAL_UART_REGISTER_CALLBACKS */
 
 } UART_HandleTypeDef;
@@ -234,6 +298,7 @@ typedef enum
   * @brief  HAL UART Callback pointer definition
   */
 typedef  void (*pUART_CallbackTypeDef)(UART_HandleTypeDef *huart);  /*!< pointer to an UART callback function */
+typedef  void (*pUART_RxFrameCallbackTypeDef)(struct __UART_HandleTypeDef *huart, uint16_t Offset, uint16_t Length);  /*!< pointer to a UART Rx Frame specific callback function */
 
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 
@@ -246,6 +311,15 @@ typedef  void (*pUART_CallbackTypeDef)(UART_HandleTypeDef *huart);  /*!< pointer
   * @{
   */
 
+/** @defgroup UART_Reception_Type_Values  UART Reception type values
+  * @{
+  */
+#define HAL_UART_RECEPTION_STANDARD          (0x00000000U)             /*!< Standard reception                       */
+#define HAL_UART_RECEPTION_TOIDLE            (0x00000001U)             /*!< Reception till completion or IDLE event  */
+/**
+  * @}
+  */
+
 /** @defgroup UART_Error_Code UART Error Code
   * @{
   */
@@ -255,7 +329,7 @@ typedef  void (*pUART_CallbackTypeDef)(UART_HandleTypeDef *huart);  /*!< pointer
 #define HAL_UART_ERROR_FE                0x00000004U   /*!< Frame error         */
 #define HAL_UART_ERROR_ORE               0x00000008U   /*!< Overrun error       */
 #define HAL_UART_ERROR_DMA               0x00000010U   /*!< DMA transfer error  */
-#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+#if (USE_HAL_UART_REGISTER_CALLBACKS != 0)
 #define  HAL_UART_ERROR_INVALID_CALLBACK 0x00000020U   /*!< Invalid Callback error  */
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 /**
@@ -745,6 +819,11 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
 HAL_StatusTypeDef HAL_UART_RegisterCallback(UART_HandleTypeDef *huart, HAL_UART_CallbackIDTypeDef CallbackID, pUART_CallbackTypeDef pCallback);
 HAL_StatusTypeDef HAL_UART_UnRegisterCallback(UART_HandleTypeDef *huart, HAL_UART_CallbackIDTypeDef CallbackID);
+
+HAL_StatusTypeDef HAL_UART_RegisterRxFrameCallback(UART_HandleTypeDef *huart, pUART_RxFrameCallbackTypeDef pCallback);
+HAL_StatusTypeDef HAL_UART_UnRegisterRxFrameCallback(UART_HandleTypeDef *huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+HAL_StatusTypeDef HAL_UART_RegisterCallbackTable(UART_HandleTypeDef *huart, const UART_CallbacksTypeDef *pCallbacks);
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 
 /**
@@ -762,6 +841,8 @@ HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, uint8_t *pData
 HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_ReceiveToRing_DMA(UART_HandleTypeDef *huart, DMA_RingTypeDef *pRing);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_UART_DMAPause(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_UART_DMAResume(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart);
@@ -784,6 +865,12 @@ void HAL_UART_AbortTransmitCpltCallback(UART_HandleTypeDef *huart);
 void HAL_UART_AbortReceiveCpltCallback(UART_HandleTypeDef *huart);
 void HAL_UART_IdleFrameDetectCpltCallback(UART_HandleTypeDef *huart);
 
+void HAL_UARTEx_RxFrameCallback(UART_HandleTypeDef *huart, uint16_t Offset, uint16_t Length);
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+void HAL_UARTEx_GetRxTimestamp(UART_HandleTypeDef *huart, UART_RxTimestampTypeDef *pTimestamp);
+uint32_t HAL_UARTEx_GetCharCycles(UART_HandleTypeDef *huart);
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
 /**
   * @}
   */
@@ -797,6 +884,9 @@ HAL_StatusTypeDef HAL_MultiProcessor_EnterMuteMode(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_MultiProcessor_ExitMuteMode(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_HalfDuplex_EnableTransmitter(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_HalfDuplex_EnableReceiver(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_SetBaudRate(UART_HandleTypeDef *huart, uint32_t BaudRate);
+uint32_t          HAL_UARTEx_GetBaudRate(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_AutoBaudRate(UART_HandleTypeDef *huart, uint32_t Mode, uint32_t Timeout);
 /**
   * @}
   */
@@ -315,6 +315,14 @@ typedef  void (*pUSART_CallbackTypeDef)(USART_HandleTypeDef *husart);  /*!< poin
   * @}
   */
 
+/** @defgroup USART_Stream USART Stream
+  * @{
+  */
+#define USART_STREAM_SEGMENT_SIZE    0xFFFFU       /*!< Maximum number of data elements of one DMA segment */
+/**
+  * @}
+  */
+
 /**
   * @}
   */
@@ -480,6 +488,12 @@ typedef  void (*pUSART_CallbackTypeDef)(USART_HandleTypeDef *husart);  /*!< poin
   */
 #define __HAL_USART_DISABLE(__HANDLE__)              ((__HANDLE__)->Instance->CR1 &= ~USART_CR1_UE)
 
+/** @brief  Number of DMA descriptors needed by a stream transfer.
+  * @param  __SIZE__ Amount of data elements (u8 or u16) of the stream.
+  * @retval Number of DMA_ChainDescTypeDef entries for each direction
+  */
+#define __HAL_USART_STREAM_DESC_NUMBER(__SIZE__)     (((__SIZE__) + USART_STREAM_SEGMENT_SIZE - 1U) / USART_STREAM_SEGMENT_SIZE)
+
 /**
   * @}
   */
@@ -521,6 +535,9 @@ HAL_StatusTypeDef HAL_USART_TransmitReceive_IT(USART_HandleTypeDef *husart, uint
 HAL_StatusTypeDef HAL_USART_Transmit_DMA(USART_HandleTypeDef *husart, uint8_t *pTxData, uint16_t Size);
 HAL_StatusTypeDef HAL_USART_Receive_DMA(USART_HandleTypeDef *husart, uint8_t *pRxData, uint16_t Size);
 HAL_StatusTypeDef HAL_USART_TransmitReceive_DMA(USART_HandleTypeDef *husart, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size);
+HAL_StatusTypeDef HAL_USART_Transmit_Stream_DMA(USART_HandleTypeDef *husart, DMA_ChainDescTypeDef *pTxDesc, uint8_t *pTxData, uint32_t Size);
+HAL_StatusTypeDef HAL_USART_TransmitReceive_Stream_DMA(USART_HandleTypeDef *husart, DMA_ChainDescTypeDef *pTxDesc, DMA_ChainDescTypeDef *pRxDesc,
+                                                       uint8_t *pTxData, uint8_t *pRxData, uint32_t Size);
 HAL_StatusTypeDef HAL_USART_DMAPause(USART_HandleTypeDef *husart);
 HAL_StatusTypeDef HAL_USART_DMAResume(USART_HandleTypeDef *husart);
 HAL_StatusTypeDef HAL_USART_DMAStop(USART_HandleTypeDef *husart);
@@ -0,0 +1,433 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_ll_adc.h
+  * @author  MCU Application Team
+  * @brief   Header file of ADC LL module.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+    Configure and calibrate the ADC with the HAL ADC, then start the
+    conversions with LL_ADC_REG_StartConversionSWStart() and read them with
+    LL_ADC_REG_ReadConversionData() on the EOC flag, with no handle nor lock.
+    [..]
+    The configuration functions below are for the ADC disabled, or with no
+    conversion on going. The channel of LL_ADC_SetChannelSamplingTime() and
+    LL_ADC_REG_SetSequencerRank1() is a number, 0 to 18.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_LL_ADC_H
+#define PY32F4xx_LL_ADC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx.h"
+
+/** @addtogroup PY32F4xx_LL_Driver
+  * @{
+  */
+
+/** @defgroup ADC_LL ADC
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup ADC_LL_Exported_Constants ADC Exported Constants
+  * @{
+  */
+
+/** @defgroup ADC_LL_EC_RESOLUTION ADC instance - Resolution
+  * @{
+  */
+#define LL_ADC_RESOLUTION_12B           0x00000000U                      /*!< ADC resolution 12 bits */
+#define LL_ADC_RESOLUTION_10B           ADC_CR1_RESSEL_0                 /*!< ADC resolution 10 bits */
+#define LL_ADC_RESOLUTION_8B            ADC_CR1_RESSEL_1                 /*!< ADC resolution  8 bits */
+#define LL_ADC_RESOLUTION_6B            ADC_CR1_RESSEL                   /*!< ADC resolution  6 bits */
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EC_DATA_ALIGN ADC instance - Data alignment
+  * @{
+  */
+#define LL_ADC_DATA_ALIGN_RIGHT         0x00000000U                      /*!< ADC conversion data alignment: right aligned */
+#define LL_ADC_DATA_ALIGN_LEFT          ADC_CR2_ALIGN                    /*!< ADC conversion data alignment: left aligned */
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EC_CHANNEL_SAMPLINGTIME Channel - Sampling time
+  * @{
+  */
+#define LL_ADC_SAMPLINGTIME_3CYCLES_5   0x00000000U                      /*!< Sampling time 3.5 ADC clock cycles   */
+#define LL_ADC_SAMPLINGTIME_5CYCLES_5   0x00000001U                      /*!< Sampling time 5.5 ADC clock cycles   */
+#define LL_ADC_SAMPLINGTIME_7CYCLES_5   0x00000002U                      /*!< Sampling time 7.5 ADC clock cycles   */
+#define LL_ADC_SAMPLINGTIME_13CYCLES_5  0x00000003U                      /*!< Sampling time 13.5 ADC clock cycles  */
+#define LL_ADC_SAMPLINGTIME_28CYCLES_5  0x00000004U                      /*!< Sampling time 28.5 ADC clock cycles  */
+#define LL_ADC_SAMPLINGTIME_41CYCLES_5  0x00000005U                      /*!< Sampling time 41.5 ADC clock cycles  */
+#define LL_ADC_SAMPLINGTIME_134CYCLES_5 0x00000006U                      /*!< Sampling time 134.5 ADC clock cycles */
+#define LL_ADC_SAMPLINGTIME_239CYCLES_5 0x00000007U                      /*!< Sampling time 239.5 ADC clock cycles */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup ADC_LL_Exported_Functions ADC Exported Functions
+  * @{
+  */
+
+/** @defgroup ADC_LL_EF_Configuration_ADC_Instance Configuration of ADC hierarchical scope: ADC instance
+  * @{
+  */
+
+/**
+  * @brief  Set the resolution.
+  * @rmtoll CR1          RESSEL        LL_ADC_SetResolution
+  * @param  ADCx ADC instance
+  * @param  Resolution A value of @ref ADC_LL_EC_RESOLUTION
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_SetResolution(ADC_TypeDef *ADCx, uint32_t Resolution)
+{
+  MODIFY_REG(ADCx->CR1, ADC_CR1_RESSEL, Resolution);
+}
+
+/**
+  * @brief  Set the alignment of the data in DR.
+  * @rmtoll CR2          ALIGN         LL_ADC_SetDataAlignment
+  * @param  ADCx ADC instance
+  * @param  DataAlignment A value of @ref ADC_LL_EC_DATA_ALIGN
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_SetDataAlignment(ADC_TypeDef *ADCx, uint32_t DataAlignment)
+{
+  MODIFY_REG(ADCx->CR2, ADC_CR2_ALIGN, DataAlignment);
+}
+
+/**
+  * @brief  Convert the ranks of the sequencer one after the other.
+  * @rmtoll CR1          SCAN          LL_ADC_EnableScan
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_EnableScan(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR1, ADC_CR1_SCAN);
+}
+
+/**
+  * @brief  Convert the first rank of the sequencer only.
+  * @rmtoll CR1          SCAN          LL_ADC_DisableScan
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_DisableScan(ADC_TypeDef *ADCx)
+{
+  CLEAR_BIT(ADCx->CR1, ADC_CR1_SCAN);
+}
+
+/**
+  * @brief  Set the sampling time of a channel.
+  * @rmtoll SMPR1        SMPx          LL_ADC_SetChannelSamplingTime\n
+  *         SMPR2        SMPx          LL_ADC_SetChannelSamplingTime
+  * @param  ADCx ADC instance
+  * @param  Channel Number of the channel, 0 to 18
+  * @param  SamplingTime A value of @ref ADC_LL_EC_CHANNEL_SAMPLINGTIME
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_SetChannelSamplingTime(ADC_TypeDef *ADCx, uint32_t Channel, uint32_t SamplingTime)
+{
+  if (Channel < 10U)
+  {
+    MODIFY_REG(ADCx->SMPR2, 0x7UL << (Channel * 3U), SamplingTime << (Channel * 3U));
+  }
+  else
+  {
+    MODIFY_REG(ADCx->SMPR1, 0x7UL << ((Channel - 10U) * 3U), SamplingTime << ((Channel - 10U) * 3U));
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EF_Configuration_ADC_Group_Regular Configuration of ADC hierarchical scope: group regular
+  * @{
+  */
+
+/**
+  * @brief  Set the number of ranks of the sequencer.
+  * @rmtoll SQR1         L             LL_ADC_REG_SetSequencerLength
+  * @param  ADCx ADC instance
+  * @param  Length Number of ranks, 1 to 16
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_REG_SetSequencerLength(ADC_TypeDef *ADCx, uint32_t Length)
+{
+  MODIFY_REG(ADCx->SQR1, ADC_SQR1_L, (Length - 1U) << ADC_SQR1_L_Pos);
+}
+
+/**
+  * @brief  Set the channel of the first rank of the sequencer.
+  * @rmtoll SQR3         SQ1           LL_ADC_REG_SetSequencerRank1
+  * @param  ADCx ADC instance
+  * @param  Channel Number of the channel, 0 to 18
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_REG_SetSequencerRank1(ADC_TypeDef *ADCx, uint32_t Channel)
+{
+  MODIFY_REG(ADCx->SQR3, ADC_SQR3_SQ1, Channel << ADC_SQR3_SQ1_Pos);
+}
+
+/**
+  * @brief  Start a new conversion at the end of each one.
+  * @rmtoll CR2          CONT          LL_ADC_REG_SetContinuousMode
+  * @param  ADCx ADC instance
+  * @param  Continuous 1 for the continuous mode, 0 for a single conversion
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_REG_SetContinuousMode(ADC_TypeDef *ADCx, uint32_t Continuous)
+{
+  MODIFY_REG(ADCx->CR2, ADC_CR2_CONT, (Continuous != 0U) ? ADC_CR2_CONT : 0U);
+}
+
+/**
+  * @brief  Request the DMA at the end of each conversion.
+  * @rmtoll CR2          DMA           LL_ADC_REG_SetDMATransfer
+  * @param  ADCx ADC instance
+  * @param  Enable 1 for a DMA request per conversion, 0 for none
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_REG_SetDMATransfer(ADC_TypeDef *ADCx, uint32_t Enable)
+{
+  MODIFY_REG(ADCx->CR2, ADC_CR2_DMA, (Enable != 0U) ? ADC_CR2_DMA : 0U);
+}
+
+/**
+  * @brief  Return the address of DR, for LL_DMA_SetPeriphAddress().
+  * @rmtoll DR           DATA          LL_ADC_DMA_GetRegAddr
+  * @param  ADCx ADC instance
+  * @retval Address of data register
+  */
+__STATIC_INLINE uint32_t LL_ADC_DMA_GetRegAddr(ADC_TypeDef *ADCx)
+{
+  return (uint32_t) &(ADCx->DR);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EF_Operation_ADC_Instance Operation on ADC hierarchical scope: ADC instance
+  * @{
+  */
+
+/**
+  * @brief  Enable the ADC.
+  * @note   Wait for the stabilization time of the ADC before the first
+  *         conversion.
+  * @rmtoll CR2          ADON          LL_ADC_Enable
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_Enable(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR2, ADC_CR2_ADON);
+}
+
+/**
+  * @brief  Disable the ADC.
+  * @rmtoll CR2          ADON          LL_ADC_Disable
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_Disable(ADC_TypeDef *ADCx)
+{
+  CLEAR_BIT(ADCx->CR2, ADC_CR2_ADON);
+}
+
+/**
+  * @brief  Return 1 if the ADC is enabled.
+  * @rmtoll CR2          ADON          LL_ADC_IsEnabled
+  * @param  ADCx ADC instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_ADC_IsEnabled(ADC_TypeDef *ADCx)
+{
+  return ((READ_BIT(ADCx->CR2, ADC_CR2_ADON) == (ADC_CR2_ADON)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Reset the calibration registers, the ADC enabled.
+  * @rmtoll CR2          RSTCAL        LL_ADC_ResetCalibration
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_ResetCalibration(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR2, ADC_CR2_RSTCAL);
+}
+
+/**
+  * @brief  Start the calibration, the ADC enabled.
+  * @rmtoll CR2          CAL           LL_ADC_StartCalibration
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_StartCalibration(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR2, ADC_CR2_CAL);
+}
+
+/**
+  * @brief  Return 1 while the calibration or its reset is on going.
+  * @rmtoll CR2          CAL           LL_ADC_IsCalibrationOnGoing\n
+  *         CR2          RSTCAL        LL_ADC_IsCalibrationOnGoing
+  * @param  ADCx ADC instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_ADC_IsCalibrationOnGoing(ADC_TypeDef *ADCx)
+{
+  return ((READ_BIT(ADCx->CR2, ADC_CR2_CAL | ADC_CR2_RSTCAL) != 0U) ? 1UL : 0UL);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EF_Operation_ADC_Group_Regular Operation on ADC hierarchical scope: group regular
+  * @{
+  */
+
+/**
+  * @brief  Start a conversion of the regular group by software.
+  * @note   The software trigger is an external trigger, EXTTRIG is set with
+  *         SWSTART.
+  * @rmtoll CR2          SWSTART       LL_ADC_REG_StartConversionSWStart\n
+  *         CR2          EXTTRIG       LL_ADC_REG_StartConversionSWStart
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_REG_StartConversionSWStart(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR2, ADC_CR2_SWSTART | ADC_CR2_EXTTRIG);
+}
+
+/**
+  * @brief  Return the data of the last conversion, the EOC flag cleared.
+  * @rmtoll DR           DATA          LL_ADC_REG_ReadConversionData
+  * @param  ADCx ADC instance
+  * @retval Value between Min_Data=0x0000 and Max_Data=0xFFFF
+  */
+__STATIC_INLINE uint16_t LL_ADC_REG_ReadConversionData(ADC_TypeDef *ADCx)
+{
+  return (uint16_t)(READ_BIT(ADCx->DR, ADC_DR_DATA));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EF_FLAG_Management ADC flag management
+  * @{
+  */
+
+/**
+  * @brief  Return 1 at the end of a conversion of the regular group.
+  * @rmtoll SR           EOC           LL_ADC_IsActiveFlag_EOC
+  * @param  ADCx ADC instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_ADC_IsActiveFlag_EOC(ADC_TypeDef *ADCx)
+{
+  return ((READ_BIT(ADCx->SR, ADC_SR_EOC) == (ADC_SR_EOC)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Clear the end of conversion flag, with no read of DR.
+  * @rmtoll SR           EOC           LL_ADC_ClearFlag_EOC
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_ClearFlag_EOC(ADC_TypeDef *ADCx)
+{
+  WRITE_REG(ADCx->SR, ~(ADC_SR_EOC));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_LL_EF_IT_Management ADC IT management
+  * @{
+  */
+
+/**
+  * @brief  Enable the interrupt at the end of a conversion of the regular group.
+  * @rmtoll CR1          EOCIE         LL_ADC_EnableIT_EOC
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_EnableIT_EOC(ADC_TypeDef *ADCx)
+{
+  SET_BIT(ADCx->CR1, ADC_CR1_EOCIE);
+}
+
+/**
+  * @brief  Disable the interrupt at the end of a conversion of the regular group.
+  * @rmtoll CR1          EOCIE         LL_ADC_DisableIT_EOC
+  * @param  ADCx ADC instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_ADC_DisableIT_EOC(ADC_TypeDef *ADCx)
+{
+  CLEAR_BIT(ADCx->CR1, ADC_CR1_EOCIE);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_LL_ADC_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,476 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_ll_dma.h
+  * @author  MCU Application Team
+  * @brief   Header file of DMA LL module.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+    A channel is given by its controller, DMA1 or DMA2, and LL_DMA_CHANNEL_x,
+    channels 1 to 7 of DMA1 and 1 to 5 of DMA2. Reload a configured channel
+    from a hot path with LL_DMA_DisableChannel(), LL_DMA_SetMemoryAddress(),
+    LL_DMA_SetDataLength() and LL_DMA_EnableChannel(), the flags of the
+    channel cleared with LL_DMA_ClearFlag_GI().
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_LL_DMA_H
+#define PY32F4xx_LL_DMA_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx.h"
+
+/** @addtogroup PY32F4xx_LL_Driver
+  * @{
+  */
+
+/** @defgroup DMA_LL DMA
+  * @{
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup DMA_LL_Private_Macros DMA Private Macros
+  * @{
+  */
+/* Registers of a channel, 0x14 bytes apart from 0x08 */
+#define __LL_DMA_CHANNEL(__DMAx__, __CHANNEL__)                                       \
+  ((DMA_Channel_TypeDef *)((uint32_t)(__DMAx__) + 0x08UL +                             \
+                           ((uint32_t)(__CHANNEL__) * ((uint32_t)DMA1_Channel2 - (uint32_t)DMA1_Channel1))))
+
+/* Request map of a channel in SYSCFG CFGR[2..4], DMA2 channels after the 7 of DMA1 */
+#define __LL_DMA_MAP_POSITION(__DMAx__, __CHANNEL__) \
+  (((__DMAx__) == DMA1) ? (uint32_t)(__CHANNEL__) : ((uint32_t)(__CHANNEL__) + 7UL))
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup DMA_LL_Exported_Constants DMA Exported Constants
+  * @{
+  */
+
+/** @defgroup DMA_LL_EC_CHANNEL CHANNEL
+  * @{
+  */
+#define LL_DMA_CHANNEL_1                0x00000000U /*!< DMA Channel 1 */
+#define LL_DMA_CHANNEL_2                0x00000001U /*!< DMA Channel 2 */
+#define LL_DMA_CHANNEL_3                0x00000002U /*!< DMA Channel 3 */
+#define LL_DMA_CHANNEL_4                0x00000003U /*!< DMA Channel 4 */
+#define LL_DMA_CHANNEL_5                0x00000004U /*!< DMA Channel 5 */
+#define LL_DMA_CHANNEL_6                0x00000005U /*!< DMA Channel 6, DMA1 only */
+#define LL_DMA_CHANNEL_7                0x00000006U /*!< DMA Channel 7, DMA1 only */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_DIRECTION Transfer Direction
+  * @{
+  */
+#define LL_DMA_DIRECTION_PERIPH_TO_MEMORY 0x00000000U     /*!< Peripheral to memory direction */
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH DMA_CCR_DIR     /*!< Memory to peripheral direction */
+#define LL_DMA_DIRECTION_MEMORY_TO_MEMORY DMA_CCR_MEM2MEM /*!< Memory to memory direction     */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_MODE Transfer mode
+  * @{
+  */
+#define LL_DMA_MODE_NORMAL              0x00000000U       /*!< Normal Mode   */
+#define LL_DMA_MODE_CIRCULAR            DMA_CCR_CIRC      /*!< Circular Mode */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_PERIPH Peripheral increment mode
+  * @{
+  */
+#define LL_DMA_PERIPH_NOINCREMENT       0x00000000U       /*!< Peripheral increment mode Disable */
+#define LL_DMA_PERIPH_INCREMENT         DMA_CCR_PINC      /*!< Peripheral increment mode Enable  */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_MEMORY Memory increment mode
+  * @{
+  */
+#define LL_DMA_MEMORY_NOINCREMENT       0x00000000U       /*!< Memory increment mode Disable */
+#define LL_DMA_MEMORY_INCREMENT         DMA_CCR_MINC      /*!< Memory increment mode Enable  */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_PDATAALIGN Peripheral data alignment
+  * @{
+  */
+#define LL_DMA_PDATAALIGN_BYTE          0x00000000U       /*!< Peripheral data alignment : Byte     */
+#define LL_DMA_PDATAALIGN_HALFWORD      DMA_CCR_PSIZE_0   /*!< Peripheral data alignment : HalfWord */
+#define LL_DMA_PDATAALIGN_WORD          DMA_CCR_PSIZE_1   /*!< Peripheral data alignment : Word     */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_MDATAALIGN Memory data alignment
+  * @{
+  */
+#define LL_DMA_MDATAALIGN_BYTE          0x00000000U       /*!< Memory data alignment : Byte     */
+#define LL_DMA_MDATAALIGN_HALFWORD      DMA_CCR_MSIZE_0   /*!< Memory data alignment : HalfWord */
+#define LL_DMA_MDATAALIGN_WORD          DMA_CCR_MSIZE_1   /*!< Memory data alignment : Word     */
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EC_PRIORITY Transfer Priority level
+  * @{
+  */
+#define LL_DMA_PRIORITY_LOW             0x00000000U       /*!< Priority level : Low       */
+#define LL_DMA_PRIORITY_MEDIUM          DMA_CCR_PL_0      /*!< Priority level : Medium    */
+#define LL_DMA_PRIORITY_HIGH            DMA_CCR_PL_1      /*!< Priority level : High      */
+#define LL_DMA_PRIORITY_VERYHIGH        DMA_CCR_PL        /*!< Priority level : Very_High */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup DMA_LL_Exported_Functions DMA Exported Functions
+  * @{
+  */
+
+/** @defgroup DMA_LL_EF_Configuration Configuration
+  * @{
+  */
+
+/**
+  * @brief  Enable a channel.
+  * @rmtoll CCR          EN            LL_DMA_EnableChannel
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_EnableChannel(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  SET_BIT(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, DMA_CCR_EN);
+}
+
+/**
+  * @brief  Disable a channel.
+  * @rmtoll CCR          EN            LL_DMA_DisableChannel
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_DisableChannel(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  CLEAR_BIT(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, DMA_CCR_EN);
+}
+
+/**
+  * @brief  Return 1 if a channel is enabled.
+  * @rmtoll CCR          EN            LL_DMA_IsEnabledChannel
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_DMA_IsEnabledChannel(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return ((READ_BIT(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, DMA_CCR_EN) == (DMA_CCR_EN)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Configure a disabled channel in one write.
+  * @rmtoll CCR          DIR           LL_DMA_ConfigTransfer\n
+  *         CCR          MEM2MEM       LL_DMA_ConfigTransfer\n
+  *         CCR          CIRC          LL_DMA_ConfigTransfer\n
+  *         CCR          PINC          LL_DMA_ConfigTransfer\n
+  *         CCR          MINC          LL_DMA_ConfigTransfer\n
+  *         CCR          PSIZE         LL_DMA_ConfigTransfer\n
+  *         CCR          MSIZE         LL_DMA_ConfigTransfer\n
+  *         CCR          PL            LL_DMA_ConfigTransfer
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  Configuration One value of each of @ref DMA_LL_EC_DIRECTION, @ref DMA_LL_EC_MODE,
+  *         @ref DMA_LL_EC_PERIPH, @ref DMA_LL_EC_MEMORY, @ref DMA_LL_EC_PDATAALIGN,
+  *         @ref DMA_LL_EC_MDATAALIGN and @ref DMA_LL_EC_PRIORITY combined.
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_ConfigTransfer(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Configuration)
+{
+  MODIFY_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CCR,
+             DMA_CCR_DIR | DMA_CCR_MEM2MEM | DMA_CCR_CIRC | DMA_CCR_PINC | DMA_CCR_MINC |
+             DMA_CCR_PSIZE | DMA_CCR_MSIZE | DMA_CCR_PL,
+             Configuration);
+}
+
+/**
+  * @brief  Set the circular or normal mode of a channel.
+  * @rmtoll CCR          CIRC          LL_DMA_SetMode
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  Mode A value of @ref DMA_LL_EC_MODE
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_SetMode(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Mode)
+{
+  MODIFY_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, DMA_CCR_CIRC, Mode);
+}
+
+/**
+  * @brief  Set the number of data to transfer, the channel disabled.
+  * @rmtoll CNDTR        NDT           LL_DMA_SetDataLength
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  NbData Between 0 and 0xFFFF
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_SetDataLength(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t NbData)
+{
+  WRITE_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CNDTR, NbData);
+}
+
+/**
+  * @brief  Return the number of data left to transfer.
+  * @rmtoll CNDTR        NDT           LL_DMA_GetDataLength
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval Between 0 and 0xFFFF
+  */
+__STATIC_INLINE uint32_t LL_DMA_GetDataLength(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return READ_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CNDTR);
+}
+
+/**
+  * @brief  Set the peripheral address, the channel disabled.
+  * @note   With LL_DMA_DIRECTION_MEMORY_TO_MEMORY, the source address.
+  * @rmtoll CPAR         PA            LL_DMA_SetPeriphAddress
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  PeriphAddress Between 0 and 0xFFFFFFFF
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_SetPeriphAddress(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t PeriphAddress)
+{
+  WRITE_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CPAR, PeriphAddress);
+}
+
+/**
+  * @brief  Set the memory address, the channel disabled.
+  * @note   With LL_DMA_DIRECTION_MEMORY_TO_MEMORY, the destination address.
+  * @rmtoll CMAR         MA            LL_DMA_SetMemoryAddress
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  MemoryAddress Between 0 and 0xFFFFFFFF
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_SetMemoryAddress(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t MemoryAddress)
+{
+  WRITE_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CMAR, MemoryAddress);
+}
+
+/**
+  * @brief  Return the memory address.
+  * @rmtoll CMAR         MA            LL_DMA_GetMemoryAddress
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval Between 0 and 0xFFFFFFFF
+  */
+__STATIC_INLINE uint32_t LL_DMA_GetMemoryAddress(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return READ_REG(__LL_DMA_CHANNEL(DMAx, Channel)->CMAR);
+}
+
+/**
+  * @brief  Map a peripheral request on a channel.
+  * @note   The SYSCFG clock must be enabled.
+  * @rmtoll SYSCFG_CFGR  DMAx_MAP      LL_DMA_SetPeriphRequest
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  Request A DMA_CHANNEL_MAP_x of the HAL DMA, 0 to 0x7F
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_SetPeriphRequest(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Request)
+{
+  uint32_t position = __LL_DMA_MAP_POSITION(DMAx, Channel);
+
+  MODIFY_REG(SYSCFG->CFGR[2U + (position >> 2U)], (0x7FUL << (8U * (position & 0x03U))),
+             (Request << (8U * (position & 0x03U))));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EF_FLAG_Management FLAG_Management
+  * @{
+  */
+
+/**
+  * @brief  Return 1 if the transfer of a channel is complete.
+  * @rmtoll ISR          TCIFx         LL_DMA_IsActiveFlag_TC
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_TC(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return ((READ_BIT(DMAx->ISR, (DMA_ISR_TCIF1 << (Channel * 4U))) != 0U) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if half of the transfer of a channel is done.
+  * @rmtoll ISR          HTIFx         LL_DMA_IsActiveFlag_HT
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_HT(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return ((READ_BIT(DMAx->ISR, (DMA_ISR_HTIF1 << (Channel * 4U))) != 0U) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if a channel stopped on a transfer error.
+  * @rmtoll ISR          TEIFx         LL_DMA_IsActiveFlag_TE
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_TE(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  return ((READ_BIT(DMAx->ISR, (DMA_ISR_TEIF1 << (Channel * 4U))) != 0U) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Clear the flags of a channel: global, complete, half and error.
+  * @rmtoll IFCR         CGIFx         LL_DMA_ClearFlag_GI
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_ClearFlag_GI(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  WRITE_REG(DMAx->IFCR, (DMA_IFCR_CGIF1 << (Channel * 4U)));
+}
+
+/**
+  * @brief  Clear the transfer complete flag of a channel.
+  * @rmtoll IFCR         CTCIFx        LL_DMA_ClearFlag_TC
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_ClearFlag_TC(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  WRITE_REG(DMAx->IFCR, (DMA_IFCR_CTCIF1 << (Channel * 4U)));
+}
+
+/**
+  * @brief  Clear the half transfer flag of a channel.
+  * @rmtoll IFCR         CHTIFx        LL_DMA_ClearFlag_HT
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_ClearFlag_HT(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  WRITE_REG(DMAx->IFCR, (DMA_IFCR_CHTIF1 << (Channel * 4U)));
+}
+
+/**
+  * @brief  Clear the transfer error flag of a channel.
+  * @rmtoll IFCR         CTEIFx        LL_DMA_ClearFlag_TE
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_ClearFlag_TE(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+  WRITE_REG(DMAx->IFCR, (DMA_IFCR_CTEIF1 << (Channel * 4U)));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_LL_EF_IT_Management IT_Management
+  * @{
+  */
+
+/**
+  * @brief  Enable the interrupts of a channel.
+  * @rmtoll CCR          TCIE          LL_DMA_EnableIT\n
+  *         CCR          HTIE          LL_DMA_EnableIT\n
+  *         CCR          TEIE          LL_DMA_EnableIT
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  Interrupts Any combination of DMA_CCR_TCIE, DMA_CCR_HTIE and DMA_CCR_TEIE
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_EnableIT(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Interrupts)
+{
+  SET_BIT(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, Interrupts);
+}
+
+/**
+  * @brief  Disable the interrupts of a channel.
+  * @rmtoll CCR          TCIE          LL_DMA_DisableIT\n
+  *         CCR          HTIE          LL_DMA_DisableIT\n
+  *         CCR          TEIE          LL_DMA_DisableIT
+  * @param  DMAx DMA1 or DMA2
+  * @param  Channel A value of @ref DMA_LL_EC_CHANNEL
+  * @param  Interrupts Any combination of DMA_CCR_TCIE, DMA_CCR_HTIE and DMA_CCR_TEIE
+  * @retval None
+  */
+__STATIC_INLINE void LL_DMA_DisableIT(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Interrupts)
+{
+  CLEAR_BIT(__LL_DMA_CHANNEL(DMAx, Channel)->CCR, Interrupts);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_LL_DMA_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,415 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_ll_gpio.h
+  * @author  MCU Application Team
+  * @brief   Header file of GPIO LL module.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+    The LL drivers are static inline functions on the registers of the
+    device header, py32f403xD.h and its variants, one register access each,
+    without handle nor state: a constant port and pin compile to a single
+    load or store. They sit next to the HAL, which stays the way to
+    configure a peripheral, and take over the operations of the hot paths
+    once it is configured.
+    [..]
+    The pins are given as masks, LL_GPIO_PIN_x, as GPIO_PIN_x of the HAL. The
+    configuration functions take a single pin, the output and lock ones any
+    combination.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_LL_GPIO_H
+#define PY32F4xx_LL_GPIO_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx.h"
+
+/** @addtogroup PY32F4xx_LL_Driver
+  * @{
+  */
+
+/** @defgroup GPIO_LL GPIO
+  * @{
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup GPIO_LL_Private_Macros GPIO Private Macros
+  * @{
+  */
+#define __LL_GPIO_POSITION(__PIN__)     (__CLZ(__RBIT((uint32_t)(__PIN__))))
+/**
+  * @}
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup GPIO_LL_Exported_Constants GPIO Exported Constants
+  * @{
+  */
+
+/** @defgroup GPIO_LL_EC_PIN PIN
+  * @{
+  */
+#define LL_GPIO_PIN_0                   GPIO_BSRR_BS0          /*!< Select pin 0  */
+#define LL_GPIO_PIN_1                   GPIO_BSRR_BS1          /*!< Select pin 1  */
+#define LL_GPIO_PIN_2                   GPIO_BSRR_BS2          /*!< Select pin 2  */
+#define LL_GPIO_PIN_3                   GPIO_BSRR_BS3          /*!< Select pin 3  */
+#define LL_GPIO_PIN_4                   GPIO_BSRR_BS4          /*!< Select pin 4  */
+#define LL_GPIO_PIN_5                   GPIO_BSRR_BS5          /*!< Select pin 5  */
+#define LL_GPIO_PIN_6                   GPIO_BSRR_BS6          /*!< Select pin 6  */
+#define LL_GPIO_PIN_7                   GPIO_BSRR_BS7          /*!< Select pin 7  */
+#define LL_GPIO_PIN_8                   GPIO_BSRR_BS8          /*!< Select pin 8  */
+#define LL_GPIO_PIN_9                   GPIO_BSRR_BS9          /*!< Select pin 9  */
+#define LL_GPIO_PIN_10                  GPIO_BSRR_BS10         /*!< Select pin 10 */
+#define LL_GPIO_PIN_11                  GPIO_BSRR_BS11         /*!< Select pin 11 */
+#define LL_GPIO_PIN_12                  GPIO_BSRR_BS12         /*!< Select pin 12 */
+#define LL_GPIO_PIN_13                  GPIO_BSRR_BS13         /*!< Select pin 13 */
+#define LL_GPIO_PIN_14                  GPIO_BSRR_BS14         /*!< Select pin 14 */
+#define LL_GPIO_PIN_15                  GPIO_BSRR_BS15         /*!< Select pin 15 */
+#define LL_GPIO_PIN_ALL                 0x0000FFFFU            /*!< Select all pins */
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EC_MODE Mode
+  * @{
+  */
+#define LL_GPIO_MODE_INPUT              0x00000000U            /*!< Select input mode              */
+#define LL_GPIO_MODE_OUTPUT             GPIO_MODER_MODE0_0     /*!< Select output mode             */
+#define LL_GPIO_MODE_ALTERNATE          GPIO_MODER_MODE0_1     /*!< Select alternate function mode */
+#define LL_GPIO_MODE_ANALOG             GPIO_MODER_MODE0       /*!< Select analog mode             */
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EC_OUTPUT Output Type
+  * @{
+  */
+#define LL_GPIO_OUTPUT_PUSHPULL         0x00000000U            /*!< Select push-pull as output type  */
+#define LL_GPIO_OUTPUT_OPENDRAIN        GPIO_OTYPER_OT0        /*!< Select open-drain as output type */
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EC_SPEED Output Speed
+  * @{
+  */
+#define LL_GPIO_SPEED_FREQ_LOW          0x00000000U            /*!< Select I/O low output speed       */
+#define LL_GPIO_SPEED_FREQ_MEDIUM       GPIO_OSPEEDR_OSPEED0_0 /*!< Select I/O medium output speed    */
+#define LL_GPIO_SPEED_FREQ_HIGH         GPIO_OSPEEDR_OSPEED0_1 /*!< Select I/O high output speed      */
+#define LL_GPIO_SPEED_FREQ_VERY_HIGH    GPIO_OSPEEDR_OSPEED0   /*!< Select I/O very high output speed */
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EC_PULL Pull Up Pull Down
+  * @{
+  */
+#define LL_GPIO_PULL_NO                 0x00000000U            /*!< Select I/O no pull */
+#define LL_GPIO_PULL_UP                 GPIO_PUPDR_PUPD0_0     /*!< Select I/O pull up */
+#define LL_GPIO_PULL_DOWN               GPIO_PUPDR_PUPD0_1     /*!< Select I/O pull down */
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EC_AF Alternate Function
+  * @{
+  */
+#define LL_GPIO_AF_0                    0x0000000U             /*!< Select alternate function 0  */
+#define LL_GPIO_AF_1                    0x0000001U             /*!< Select alternate function 1  */
+#define LL_GPIO_AF_2                    0x0000002U             /*!< Select alternate function 2  */
+#define LL_GPIO_AF_3                    0x0000003U             /*!< Select alternate function 3  */
+#define LL_GPIO_AF_4                    0x0000004U             /*!< Select alternate function 4  */
+#define LL_GPIO_AF_5                    0x0000005U             /*!< Select alternate function 5  */
+#define LL_GPIO_AF_6                    0x0000006U             /*!< Select alternate function 6  */
+#define LL_GPIO_AF_7                    0x0000007U             /*!< Select alternate function 7  */
+#define LL_GPIO_AF_8                    0x0000008U             /*!< Select alternate function 8  */
+#define LL_GPIO_AF_9                    0x0000009U             /*!< Select alternate function 9  */
+#define LL_GPIO_AF_10                   0x000000AU             /*!< Select alternate function 10 */
+#define LL_GPIO_AF_11                   0x000000BU             /*!< Select alternate function 11 */
+#define LL_GPIO_AF_12                   0x000000CU             /*!< Select alternate function 12 */
+#define LL_GPIO_AF_13                   0x000000DU             /*!< Select alternate function 13 */
+#define LL_GPIO_AF_14                   0x000000EU             /*!< Select alternate function 14 */
+#define LL_GPIO_AF_15                   0x000000FU             /*!< Select alternate function 15 */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup GPIO_LL_Exported_Functions GPIO Exported Functions
+  * @{
+  */
+
+/** @defgroup GPIO_LL_EF_Port_Configuration Port Configuration
+  * @{
+  */
+
+/**
+  * @brief  Configure the mode of a pin.
+  * @note   MODER is read, modified and written.
+  * @rmtoll MODER        MODEy         LL_GPIO_SetPinMode
+  * @param  GPIOx GPIO Port
+  * @param  Pin One LL_GPIO_PIN_x.
+  * @param  Mode A value of @ref GPIO_LL_EC_MODE
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetPinMode(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Mode)
+{
+  MODIFY_REG(GPIOx->MODER, (GPIO_MODER_MODE0 << (__LL_GPIO_POSITION(Pin) * 2U)),
+             (Mode << (__LL_GPIO_POSITION(Pin) * 2U)));
+}
+
+/**
+  * @brief  Return the mode of a pin.
+  * @rmtoll MODER        MODEy         LL_GPIO_GetPinMode
+  * @param  GPIOx GPIO Port
+  * @param  Pin One LL_GPIO_PIN_x.
+  * @retval A value of @ref GPIO_LL_EC_MODE
+  */
+__STATIC_INLINE uint32_t LL_GPIO_GetPinMode(GPIO_TypeDef *GPIOx, uint32_t Pin)
+{
+  return (READ_BIT(GPIOx->MODER, (GPIO_MODER_MODE0 << (__LL_GPIO_POSITION(Pin) * 2U))) >>
+          (__LL_GPIO_POSITION(Pin) * 2U));
+}
+
+/**
+  * @brief  Configure the output type of several pins.
+  * @rmtoll OTYPER       OTy           LL_GPIO_SetPinOutputType
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @param  OutputType A value of @ref GPIO_LL_EC_OUTPUT
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetPinOutputType(GPIO_TypeDef *GPIOx, uint32_t PinMask, uint32_t OutputType)
+{
+  MODIFY_REG(GPIOx->OTYPER, PinMask, (PinMask * OutputType));
+}
+
+/**
+  * @brief  Configure the output speed of a pin.
+  * @rmtoll OSPEEDR      OSPEEDy       LL_GPIO_SetPinSpeed
+  * @param  GPIOx GPIO Port
+  * @param  Pin One LL_GPIO_PIN_x.
+  * @param  Speed A value of @ref GPIO_LL_EC_SPEED
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetPinSpeed(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Speed)
+{
+  MODIFY_REG(GPIOx->OSPEEDR, (GPIO_OSPEEDR_OSPEED0 << (__LL_GPIO_POSITION(Pin) * 2U)),
+             (Speed << (__LL_GPIO_POSITION(Pin) * 2U)));
+}
+
+/**
+  * @brief  Configure the pull-up or pull-down of a pin.
+  * @rmtoll PUPDR        PUPDy         LL_GPIO_SetPinPull
+  * @param  GPIOx GPIO Port
+  * @param  Pin One LL_GPIO_PIN_x.
+  * @param  Pull A value of @ref GPIO_LL_EC_PULL
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetPinPull(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Pull)
+{
+  MODIFY_REG(GPIOx->PUPDR, (GPIO_PUPDR_PUPD0 << (__LL_GPIO_POSITION(Pin) * 2U)),
+             (Pull << (__LL_GPIO_POSITION(Pin) * 2U)));
+}
+
+/**
+  * @brief  Configure the alternate function of a pin, 0 to 15.
+  * @rmtoll AFRL         AFSELy        LL_GPIO_SetAFPin\n
+  *         AFRH         AFSELy        LL_GPIO_SetAFPin
+  * @param  GPIOx GPIO Port
+  * @param  Pin One LL_GPIO_PIN_x.
+  * @param  Alternate A value of @ref GPIO_LL_EC_AF
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetAFPin(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Alternate)
+{
+  uint32_t position = __LL_GPIO_POSITION(Pin);
+
+  MODIFY_REG(GPIOx->AFR[position >> 3U], (0xFU << ((position & 7U) * 4U)),
+             (Alternate << ((position & 7U) * 4U)));
+}
+
+/**
+  * @brief  Lock the configuration of several pins until the next reset.
+  * @rmtoll LCKR         LCKK          LL_GPIO_LockPin
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_LockPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  __IO uint32_t temp;
+
+  WRITE_REG(GPIOx->LCKR, GPIO_LCKR_LCKK | PinMask);
+  WRITE_REG(GPIOx->LCKR, PinMask);
+  WRITE_REG(GPIOx->LCKR, GPIO_LCKR_LCKK | PinMask);
+  temp = READ_REG(GPIOx->LCKR);
+  (void) temp;
+}
+
+/**
+  * @brief  Return 1 if all the pins of the mask are locked.
+  * @rmtoll LCKR         LCKy          LL_GPIO_IsPinLocked
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_GPIO_IsPinLocked(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  return ((READ_BIT(GPIOx->LCKR, PinMask) == (PinMask)) ? 1UL : 0UL);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup GPIO_LL_EF_Data_Access Data Access
+  * @{
+  */
+
+/**
+  * @brief  Return the input levels of the port.
+  * @rmtoll IDR          IDy           LL_GPIO_ReadInputPort
+  * @param  GPIOx GPIO Port
+  * @retval Input data register value of port
+  */
+__STATIC_INLINE uint32_t LL_GPIO_ReadInputPort(GPIO_TypeDef *GPIOx)
+{
+  return (uint32_t)(READ_REG(GPIOx->IDR));
+}
+
+/**
+  * @brief  Return 1 if all the pins of the mask are high.
+  * @rmtoll IDR          IDy           LL_GPIO_IsInputPinSet
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_GPIO_IsInputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  return ((READ_BIT(GPIOx->IDR, PinMask) == (PinMask)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Write the output levels of the whole port.
+  * @rmtoll ODR          ODy           LL_GPIO_WriteOutputPort
+  * @param  GPIOx GPIO Port
+  * @param  PortValue Level of the 16 pins.
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_WriteOutputPort(GPIO_TypeDef *GPIOx, uint32_t PortValue)
+{
+  WRITE_REG(GPIOx->ODR, PortValue);
+}
+
+/**
+  * @brief  Return the output levels of the port.
+  * @rmtoll ODR          ODy           LL_GPIO_ReadOutputPort
+  * @param  GPIOx GPIO Port
+  * @retval Output data register value of port
+  */
+__STATIC_INLINE uint32_t LL_GPIO_ReadOutputPort(GPIO_TypeDef *GPIOx)
+{
+  return (uint32_t)(READ_REG(GPIOx->ODR));
+}
+
+/**
+  * @brief  Return 1 if all the pins of the mask are driven high.
+  * @rmtoll ODR          ODy           LL_GPIO_IsOutputPinSet
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_GPIO_IsOutputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  return ((READ_BIT(GPIOx->ODR, PinMask) == (PinMask)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Drive several pins high, the others untouched.
+  * @rmtoll BSRR         BSy           LL_GPIO_SetOutputPin
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_SetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  WRITE_REG(GPIOx->BSRR, PinMask);
+}
+
+/**
+  * @brief  Drive several pins low, the others untouched.
+  * @rmtoll BRR          BRy           LL_GPIO_ResetOutputPin
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_ResetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  WRITE_REG(GPIOx->BRR, PinMask);
+}
+
+/**
+  * @brief  Toggle several pins in one store, ODR read once.
+  * @rmtoll BSRR         BSy           LL_GPIO_TogglePin\n
+  *         BSRR         BRy           LL_GPIO_TogglePin
+  * @param  GPIOx GPIO Port
+  * @param  PinMask Any combination of LL_GPIO_PIN_x.
+  * @retval None
+  */
+__STATIC_INLINE void LL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+  uint32_t odr = READ_REG(GPIOx->ODR);
+
+  WRITE_REG(GPIOx->BSRR, ((odr & PinMask) << 16U) | (~odr & PinMask));
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_LL_GPIO_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,549 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_ll_tim.h
+  * @author  MCU Application Team
+  * @brief   Header file of TIM LL module.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+    Configure the timer and its channels with the HAL TIM, then drive the
+    counter, the period and the compare values with the functions below,
+    from an interrupt handler or a loop, with no handle nor lock.
+    [..]
+    The flags of SR are cleared by a write of 0, LL_TIM_ClearFlag_x()
+    writes the complement of the flag and leaves the others as they are.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_LL_TIM_H
+#define PY32F4xx_LL_TIM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx.h"
+
+/** @addtogroup PY32F4xx_LL_Driver
+  * @{
+  */
+
+/** @defgroup TIM_LL TIM
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup TIM_LL_Exported_Constants TIM Exported Constants
+  * @{
+  */
+
+/** @defgroup TIM_LL_EC_CHANNEL Channel
+  * @{
+  */
+#define LL_TIM_CHANNEL_CH1              TIM_CCER_CC1E                    /*!< Timer input/output channel 1 */
+#define LL_TIM_CHANNEL_CH1N             TIM_CCER_CC1NE                   /*!< Timer complementary output channel 1 */
+#define LL_TIM_CHANNEL_CH2              TIM_CCER_CC2E                    /*!< Timer input/output channel 2 */
+#define LL_TIM_CHANNEL_CH2N             TIM_CCER_CC2NE                   /*!< Timer complementary output channel 2 */
+#define LL_TIM_CHANNEL_CH3              TIM_CCER_CC3E                    /*!< Timer input/output channel 3 */
+#define LL_TIM_CHANNEL_CH3N             TIM_CCER_CC3NE                   /*!< Timer complementary output channel 3 */
+#define LL_TIM_CHANNEL_CH4              TIM_CCER_CC4E                    /*!< Timer input/output channel 4 */
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EC_ONEPULSEMODE One Pulse Mode
+  * @{
+  */
+#define LL_TIM_ONEPULSEMODE_REPETITIVE  0x00000000U                      /*!< Counter keeps counting at the update event */
+#define LL_TIM_ONEPULSEMODE_SINGLE      TIM_CR1_OPM                      /*!< Counter stops at the update event */
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EC_UPDATESOURCE Update Source
+  * @{
+  */
+#define LL_TIM_UPDATESOURCE_REGULAR     0x00000000U                      /*!< Overflow, underflow, UG bit and slave mode controller generate an update request */
+#define LL_TIM_UPDATESOURCE_COUNTER     TIM_CR1_URS                      /*!< Only overflow and underflow generate an update request */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup TIM_LL_Exported_Functions TIM Exported Functions
+  * @{
+  */
+
+/** @defgroup TIM_LL_EF_Time_Base Time Base configuration
+  * @{
+  */
+
+/**
+  * @brief  Enable the counter.
+  * @rmtoll CR1          CEN           LL_TIM_EnableCounter
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_EnableCounter(TIM_TypeDef *TIMx)
+{
+  SET_BIT(TIMx->CR1, TIM_CR1_CEN);
+}
+
+/**
+  * @brief  Disable the counter.
+  * @rmtoll CR1          CEN           LL_TIM_DisableCounter
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_DisableCounter(TIM_TypeDef *TIMx)
+{
+  CLEAR_BIT(TIMx->CR1, TIM_CR1_CEN);
+}
+
+/**
+  * @brief  Return 1 if the counter is enabled.
+  * @rmtoll CR1          CEN           LL_TIM_IsEnabledCounter
+  * @param  TIMx Timer instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_TIM_IsEnabledCounter(TIM_TypeDef *TIMx)
+{
+  return ((READ_BIT(TIMx->CR1, TIM_CR1_CEN) == (TIM_CR1_CEN)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Buffer the auto-reload register, the new period at the update event.
+  * @rmtoll CR1          ARPE          LL_TIM_EnableARRPreload
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_EnableARRPreload(TIM_TypeDef *TIMx)
+{
+  SET_BIT(TIMx->CR1, TIM_CR1_ARPE);
+}
+
+/**
+  * @brief  Write the auto-reload register through, the new period at once.
+  * @rmtoll CR1          ARPE          LL_TIM_DisableARRPreload
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_DisableARRPreload(TIM_TypeDef *TIMx)
+{
+  CLEAR_BIT(TIMx->CR1, TIM_CR1_ARPE);
+}
+
+/**
+  * @brief  Set the one pulse mode.
+  * @rmtoll CR1          OPM           LL_TIM_SetOnePulseMode
+  * @param  TIMx Timer instance
+  * @param  OnePulseMode A value of @ref TIM_LL_EC_ONEPULSEMODE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetOnePulseMode(TIM_TypeDef *TIMx, uint32_t OnePulseMode)
+{
+  MODIFY_REG(TIMx->CR1, TIM_CR1_OPM, OnePulseMode);
+}
+
+/**
+  * @brief  Set the sources of the update event.
+  * @rmtoll CR1          URS           LL_TIM_SetUpdateSource
+  * @param  TIMx Timer instance
+  * @param  UpdateSource A value of @ref TIM_LL_EC_UPDATESOURCE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetUpdateSource(TIM_TypeDef *TIMx, uint32_t UpdateSource)
+{
+  MODIFY_REG(TIMx->CR1, TIM_CR1_URS, UpdateSource);
+}
+
+/**
+  * @brief  Set the counter value.
+  * @rmtoll CNT          CNT           LL_TIM_SetCounter
+  * @param  TIMx Timer instance
+  * @param  Counter Counter value (between Min_Data=0 and Max_Data=0xFFFF)
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetCounter(TIM_TypeDef *TIMx, uint32_t Counter)
+{
+  WRITE_REG(TIMx->CNT, Counter);
+}
+
+/**
+  * @brief  Return the counter value.
+  * @rmtoll CNT          CNT           LL_TIM_GetCounter
+  * @param  TIMx Timer instance
+  * @retval Counter value (between Min_Data=0 and Max_Data=0xFFFF)
+  */
+__STATIC_INLINE uint32_t LL_TIM_GetCounter(TIM_TypeDef *TIMx)
+{
+  return (uint32_t)(READ_REG(TIMx->CNT));
+}
+
+/**
+  * @brief  Set the prescaler, the counter clock divided by Prescaler + 1.
+  * @note   Taken at the next update event, LL_TIM_GenerateEvent_UPDATE() to
+  *         take it at once.
+  * @rmtoll PSC          PSC           LL_TIM_SetPrescaler
+  * @param  TIMx Timer instance
+  * @param  Prescaler between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetPrescaler(TIM_TypeDef *TIMx, uint32_t Prescaler)
+{
+  WRITE_REG(TIMx->PSC, Prescaler);
+}
+
+/**
+  * @brief  Return the prescaler.
+  * @rmtoll PSC          PSC           LL_TIM_GetPrescaler
+  * @param  TIMx Timer instance
+  * @retval Prescaler value between Min_Data=0 and Max_Data=65535
+  */
+__STATIC_INLINE uint32_t LL_TIM_GetPrescaler(TIM_TypeDef *TIMx)
+{
+  return (uint32_t)(READ_REG(TIMx->PSC));
+}
+
+/**
+  * @brief  Set the auto-reload value, the period minus 1.
+  * @rmtoll ARR          ARR           LL_TIM_SetAutoReload
+  * @param  TIMx Timer instance
+  * @param  AutoReload between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetAutoReload(TIM_TypeDef *TIMx, uint32_t AutoReload)
+{
+  WRITE_REG(TIMx->ARR, AutoReload);
+}
+
+/**
+  * @brief  Return the auto-reload value.
+  * @rmtoll ARR          ARR           LL_TIM_GetAutoReload
+  * @param  TIMx Timer instance
+  * @retval Auto-reload value
+  */
+__STATIC_INLINE uint32_t LL_TIM_GetAutoReload(TIM_TypeDef *TIMx)
+{
+  return (uint32_t)(READ_REG(TIMx->ARR));
+}
+
+/**
+  * @brief  Set the repetition counter, of the advanced timers.
+  * @rmtoll RCR          REP           LL_TIM_SetRepetitionCounter
+  * @param  TIMx Timer instance
+  * @param  RepetitionCounter between Min_Data=0 and Max_Data=255
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_SetRepetitionCounter(TIM_TypeDef *TIMx, uint32_t RepetitionCounter)
+{
+  WRITE_REG(TIMx->RCR, RepetitionCounter);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EF_Output_Channel Output channel configuration
+  * @{
+  */
+
+/**
+  * @brief  Enable capture/compare channels.
+  * @rmtoll CCER         CC1E          LL_TIM_CC_EnableChannel\n
+  *         CCER         CC1NE         LL_TIM_CC_EnableChannel\n
+  *         CCER         CC2E          LL_TIM_CC_EnableChannel\n
+  *         CCER         CC4E          LL_TIM_CC_EnableChannel
+  * @param  TIMx Timer instance
+  * @param  Channels Any combination of @ref TIM_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_CC_EnableChannel(TIM_TypeDef *TIMx, uint32_t Channels)
+{
+  SET_BIT(TIMx->CCER, Channels);
+}
+
+/**
+  * @brief  Disable capture/compare channels.
+  * @rmtoll CCER         CC1E          LL_TIM_CC_DisableChannel\n
+  *         CCER         CC1NE         LL_TIM_CC_DisableChannel\n
+  *         CCER         CC2E          LL_TIM_CC_DisableChannel\n
+  *         CCER         CC4E          LL_TIM_CC_DisableChannel
+  * @param  TIMx Timer instance
+  * @param  Channels Any combination of @ref TIM_LL_EC_CHANNEL
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_CC_DisableChannel(TIM_TypeDef *TIMx, uint32_t Channels)
+{
+  CLEAR_BIT(TIMx->CCER, Channels);
+}
+
+/**
+  * @brief  Set the compare value of channel 1.
+  * @rmtoll CCR1         CCR1          LL_TIM_OC_SetCompareCH1
+  * @param  TIMx Timer instance
+  * @param  CompareValue between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH1(TIM_TypeDef *TIMx, uint32_t CompareValue)
+{
+  WRITE_REG(TIMx->CCR1, CompareValue);
+}
+
+/**
+  * @brief  Set the compare value of channel 2.
+  * @rmtoll CCR2         CCR2          LL_TIM_OC_SetCompareCH2
+  * @param  TIMx Timer instance
+  * @param  CompareValue between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH2(TIM_TypeDef *TIMx, uint32_t CompareValue)
+{
+  WRITE_REG(TIMx->CCR2, CompareValue);
+}
+
+/**
+  * @brief  Set the compare value of channel 3.
+  * @rmtoll CCR3         CCR3          LL_TIM_OC_SetCompareCH3
+  * @param  TIMx Timer instance
+  * @param  CompareValue between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH3(TIM_TypeDef *TIMx, uint32_t CompareValue)
+{
+  WRITE_REG(TIMx->CCR3, CompareValue);
+}
+
+/**
+  * @brief  Set the compare value of channel 4.
+  * @rmtoll CCR4         CCR4          LL_TIM_OC_SetCompareCH4
+  * @param  TIMx Timer instance
+  * @param  CompareValue between Min_Data=0 and Max_Data=65535
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH4(TIM_TypeDef *TIMx, uint32_t CompareValue)
+{
+  WRITE_REG(TIMx->CCR4, CompareValue);
+}
+
+/**
+  * @brief  Return the captured value of channel 1.
+  * @rmtoll CCR1         CCR1          LL_TIM_IC_GetCaptureCH1
+  * @param  TIMx Timer instance
+  * @retval CapturedValue between Min_Data=0 and Max_Data=65535
+  */
+__STATIC_INLINE uint32_t LL_TIM_IC_GetCaptureCH1(TIM_TypeDef *TIMx)
+{
+  return (uint32_t)(READ_REG(TIMx->CCR1));
+}
+
+/**
+  * @brief  Enable the outputs of an advanced timer.
+  * @rmtoll BDTR         MOE           LL_TIM_EnableAllOutputs
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_EnableAllOutputs(TIM_TypeDef *TIMx)
+{
+  SET_BIT(TIMx->BDTR, TIM_BDTR_MOE);
+}
+
+/**
+  * @brief  Disable the outputs of an advanced timer.
+  * @rmtoll BDTR         MOE           LL_TIM_DisableAllOutputs
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_DisableAllOutputs(TIM_TypeDef *TIMx)
+{
+  CLEAR_BIT(TIMx->BDTR, TIM_BDTR_MOE);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EF_FLAG_Management FLAG-Management
+  * @{
+  */
+
+/**
+  * @brief  Return 1 if the update event occurred.
+  * @rmtoll SR           UIF           LL_TIM_IsActiveFlag_UPDATE
+  * @param  TIMx Timer instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_TIM_IsActiveFlag_UPDATE(TIM_TypeDef *TIMx)
+{
+  return ((READ_BIT(TIMx->SR, TIM_SR_UIF) == (TIM_SR_UIF)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Clear the update flag.
+  * @rmtoll SR           UIF           LL_TIM_ClearFlag_UPDATE
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_ClearFlag_UPDATE(TIM_TypeDef *TIMx)
+{
+  WRITE_REG(TIMx->SR, ~(TIM_SR_UIF));
+}
+
+/**
+  * @brief  Return 1 if a capture/compare flag is set.
+  * @rmtoll SR           CC1IF         LL_TIM_IsActiveFlag_CC\n
+  *         SR           CC2IF         LL_TIM_IsActiveFlag_CC\n
+  *         SR           CC3IF         LL_TIM_IsActiveFlag_CC\n
+  *         SR           CC4IF         LL_TIM_IsActiveFlag_CC
+  * @param  TIMx Timer instance
+  * @param  Flag One of TIM_SR_CC1IF, TIM_SR_CC2IF, TIM_SR_CC3IF and TIM_SR_CC4IF
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_TIM_IsActiveFlag_CC(TIM_TypeDef *TIMx, uint32_t Flag)
+{
+  return ((READ_BIT(TIMx->SR, Flag) == (Flag)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Clear capture/compare flags.
+  * @rmtoll SR           CC1IF         LL_TIM_ClearFlag_CC\n
+  *         SR           CC2IF         LL_TIM_ClearFlag_CC\n
+  *         SR           CC3IF         LL_TIM_ClearFlag_CC\n
+  *         SR           CC4IF         LL_TIM_ClearFlag_CC
+  * @param  TIMx Timer instance
+  * @param  Flags Any combination of TIM_SR_CC1IF, TIM_SR_CC2IF, TIM_SR_CC3IF and TIM_SR_CC4IF
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_ClearFlag_CC(TIM_TypeDef *TIMx, uint32_t Flags)
+{
+  WRITE_REG(TIMx->SR, ~(Flags));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EF_IT_Management IT-Management
+  * @{
+  */
+
+/**
+  * @brief  Enable interrupts of DIER.
+  * @rmtoll DIER         UIE           LL_TIM_EnableIT\n
+  *         DIER         CC1IE         LL_TIM_EnableIT\n
+  *         DIER         CC4IE         LL_TIM_EnableIT
+  * @param  TIMx Timer instance
+  * @param  Interrupts Any combination of TIM_DIER_UIE and TIM_DIER_CC1IE to TIM_DIER_CC4IE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_EnableIT(TIM_TypeDef *TIMx, uint32_t Interrupts)
+{
+  SET_BIT(TIMx->DIER, Interrupts);
+}
+
+/**
+  * @brief  Disable interrupts of DIER.
+  * @rmtoll DIER         UIE           LL_TIM_DisableIT\n
+  *         DIER         CC1IE         LL_TIM_DisableIT\n
+  *         DIER         CC4IE         LL_TIM_DisableIT
+  * @param  TIMx Timer instance
+  * @param  Interrupts Any combination of TIM_DIER_UIE and TIM_DIER_CC1IE to TIM_DIER_CC4IE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_DisableIT(TIM_TypeDef *TIMx, uint32_t Interrupts)
+{
+  CLEAR_BIT(TIMx->DIER, Interrupts);
+}
+
+/**
+  * @brief  Enable DMA requests of DIER.
+  * @rmtoll DIER         UDE           LL_TIM_EnableDMAReq\n
+  *         DIER         CC1DE         LL_TIM_EnableDMAReq\n
+  *         DIER         CC4DE         LL_TIM_EnableDMAReq
+  * @param  TIMx Timer instance
+  * @param  Requests Any combination of TIM_DIER_UDE and TIM_DIER_CC1DE to TIM_DIER_CC4DE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_EnableDMAReq(TIM_TypeDef *TIMx, uint32_t Requests)
+{
+  SET_BIT(TIMx->DIER, Requests);
+}
+
+/**
+  * @brief  Disable DMA requests of DIER.
+  * @rmtoll DIER         UDE           LL_TIM_DisableDMAReq\n
+  *         DIER         CC1DE         LL_TIM_DisableDMAReq\n
+  *         DIER         CC4DE         LL_TIM_DisableDMAReq
+  * @param  TIMx Timer instance
+  * @param  Requests Any combination of TIM_DIER_UDE and TIM_DIER_CC1DE to TIM_DIER_CC4DE
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_DisableDMAReq(TIM_TypeDef *TIMx, uint32_t Requests)
+{
+  CLEAR_BIT(TIMx->DIER, Requests);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup TIM_LL_EF_EVENT_Management EVENT-Management
+  * @{
+  */
+
+/**
+  * @brief  Generate an update event, the prescaler and the auto-reload taken.
+  * @rmtoll EGR          UG            LL_TIM_GenerateEvent_UPDATE
+  * @param  TIMx Timer instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_TIM_GenerateEvent_UPDATE(TIM_TypeDef *TIMx)
+{
+  SET_BIT(TIMx->EGR, TIM_EGR_UG);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_LL_TIM_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -0,0 +1,535 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_ll_usart.h
+  * @author  MCU Application Team
+  * @brief   Header file of USART LL module.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+    Configure the USART with the HAL UART, then move the data with
+    LL_USART_TransmitData8() and LL_USART_ReceiveData8() on the flags, with
+    no handle nor lock on the way. The error flags PE, FE, NE, ORE and the
+    IDLE flag are cleared by a read of SR then of DR, LL_USART_ClearFlag_x()
+    does both: the data received at that time is lost.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PY32F4xx_LL_USART_H
+#define PY32F4xx_LL_USART_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx.h"
+
+/** @addtogroup PY32F4xx_LL_Driver
+  * @{
+  */
+
+/** @defgroup USART_LL USART
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/** @defgroup USART_LL_Exported_Constants USART Exported Constants
+  * @{
+  */
+
+/** @defgroup USART_LL_EC_DIRECTION Communication Direction
+  * @{
+  */
+#define LL_USART_DIRECTION_NONE         0x00000000U                      /*!< Transmitter and Receiver are disabled */
+#define LL_USART_DIRECTION_RX           USART_CR1_RE                     /*!< Transmitter is disabled and Receiver is enabled */
+#define LL_USART_DIRECTION_TX           USART_CR1_TE                     /*!< Transmitter is enabled and Receiver is disabled */
+#define LL_USART_DIRECTION_TX_RX        (USART_CR1_TE |USART_CR1_RE)     /*!< Transmitter and Receiver are enabled */
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EC_PARITY Parity Control
+  * @{
+  */
+#define LL_USART_PARITY_NONE            0x00000000U                      /*!< Parity control disabled */
+#define LL_USART_PARITY_EVEN            USART_CR1_PCE                    /*!< Parity control enabled and Even Parity is selected */
+#define LL_USART_PARITY_ODD             (USART_CR1_PCE | USART_CR1_PS)   /*!< Parity control enabled and Odd Parity is selected */
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EC_DATAWIDTH Datawidth
+  * @{
+  */
+#define LL_USART_DATAWIDTH_8B           0x00000000U                      /*!< 8 bits word length : Start bit, 8 data bits, n stop bits */
+#define LL_USART_DATAWIDTH_9B           USART_CR1_M                      /*!< 9 bits word length : Start bit, 9 data bits, n stop bits */
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EC_STOPBITS Stop Bits
+  * @{
+  */
+#define LL_USART_STOPBITS_1             0x00000000U                      /*!< 1 stop bit */
+#define LL_USART_STOPBITS_0_5           USART_CR2_STOP_0                 /*!< 0.5 stop bit */
+#define LL_USART_STOPBITS_2             USART_CR2_STOP_1                 /*!< 2 stop bits */
+#define LL_USART_STOPBITS_1_5           USART_CR2_STOP                   /*!< 1.5 stop bits */
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EC_OVERSAMPLING Oversampling
+  * @{
+  */
+#define LL_USART_OVERSAMPLING_16        0x00000000U                      /*!< Oversampling by 16 */
+#define LL_USART_OVERSAMPLING_8         USART_CR3_OVER8                  /*!< Oversampling by 8 */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+/** @defgroup USART_LL_Exported_Functions USART Exported Functions
+  * @{
+  */
+
+/** @defgroup USART_LL_EF_Configuration Configuration functions
+  * @{
+  */
+
+/**
+  * @brief  Enable the USART.
+  * @rmtoll CR1          UE            LL_USART_Enable
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_Enable(USART_TypeDef *USARTx)
+{
+  SET_BIT(USARTx->CR1, USART_CR1_UE);
+}
+
+/**
+  * @brief  Disable the USART, at the end of the current frame.
+  * @rmtoll CR1          UE            LL_USART_Disable
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_Disable(USART_TypeDef *USARTx)
+{
+  CLEAR_BIT(USARTx->CR1, USART_CR1_UE);
+}
+
+/**
+  * @brief  Return 1 if the USART is enabled.
+  * @rmtoll CR1          UE            LL_USART_IsEnabled
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsEnabled(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->CR1, USART_CR1_UE) == (USART_CR1_UE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Enable the transmitter, the receiver or both.
+  * @rmtoll CR1          RE            LL_USART_SetTransferDirection\n
+  *         CR1          TE            LL_USART_SetTransferDirection
+  * @param  USARTx USART Instance
+  * @param  TransferDirection A value of @ref USART_LL_EC_DIRECTION
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_SetTransferDirection(USART_TypeDef *USARTx, uint32_t TransferDirection)
+{
+  MODIFY_REG(USARTx->CR1, USART_CR1_RE | USART_CR1_TE, TransferDirection);
+}
+
+/**
+  * @brief  Configure the frame, the USART disabled.
+  * @rmtoll CR1          PS            LL_USART_ConfigCharacter\n
+  *         CR1          PCE           LL_USART_ConfigCharacter\n
+  *         CR1          M             LL_USART_ConfigCharacter\n
+  *         CR2          STOP          LL_USART_ConfigCharacter
+  * @param  USARTx USART Instance
+  * @param  DataWidth A value of @ref USART_LL_EC_DATAWIDTH
+  * @param  Parity A value of @ref USART_LL_EC_PARITY
+  * @param  StopBits A value of @ref USART_LL_EC_STOPBITS
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_ConfigCharacter(USART_TypeDef *USARTx, uint32_t DataWidth, uint32_t Parity,
+                                              uint32_t StopBits)
+{
+  MODIFY_REG(USARTx->CR1, USART_CR1_PS | USART_CR1_PCE | USART_CR1_M, Parity | DataWidth);
+  MODIFY_REG(USARTx->CR2, USART_CR2_STOP, StopBits);
+}
+
+/**
+  * @brief  Set the baud rate, the USART disabled.
+  * @note   The divider is rounded to the nearest, in 1/16 or 1/8 of the
+  *         peripheral clock as the oversampling of CR3 OVER8.
+  * @rmtoll BRR          DIV_Mantissa  LL_USART_SetBaudRate\n
+  *         BRR          DIV_Fraction  LL_USART_SetBaudRate
+  * @param  USARTx USART Instance
+  * @param  PeriphClk Frequency of the APB clock of the USART, in Hz
+  * @param  BaudRate Baud rate, in bit/s, not 0
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_SetBaudRate(USART_TypeDef *USARTx, uint32_t PeriphClk, uint32_t BaudRate)
+{
+  uint32_t div;
+
+  if (READ_BIT(USARTx->CR3, USART_CR3_OVER8) != 0U)
+  {
+    div = ((PeriphClk * 2U) + (BaudRate / 2U)) / BaudRate;
+    WRITE_REG(USARTx->BRR, (div & 0xFFF0U) | ((div & 0x000FU) >> 1U));
+  }
+  else
+  {
+    div = (PeriphClk + (BaudRate / 2U)) / BaudRate;
+    WRITE_REG(USARTx->BRR, div & 0xFFFFU);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EF_FLAG_Management FLAG_Management
+  * @{
+  */
+
+/**
+  * @brief  Return 1 if the transmit data register is empty.
+  * @rmtoll SR           TXE           LL_USART_IsActiveFlag_TXE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_TXE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_TXE) == (USART_SR_TXE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if the last frame is sent.
+  * @rmtoll SR           TC            LL_USART_IsActiveFlag_TC
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_TC(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_TC) == (USART_SR_TC)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if a data is received.
+  * @rmtoll SR           RXNE          LL_USART_IsActiveFlag_RXNE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_RXNE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_RXNE) == (USART_SR_RXNE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if the line is idle after a frame.
+  * @rmtoll SR           IDLE          LL_USART_IsActiveFlag_IDLE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_IDLE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_IDLE) == (USART_SR_IDLE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if a data was received before the previous one was read.
+  * @rmtoll SR           ORE           LL_USART_IsActiveFlag_ORE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_ORE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_ORE) == (USART_SR_ORE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if a framing error was found.
+  * @rmtoll SR           FE            LL_USART_IsActiveFlag_FE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_FE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_FE) == (USART_SR_FE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if noise was found on a frame.
+  * @rmtoll SR           NE            LL_USART_IsActiveFlag_NE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_NE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_NE) == (USART_SR_NE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Return 1 if a parity error was found.
+  * @rmtoll SR           PE            LL_USART_IsActiveFlag_PE
+  * @param  USARTx USART Instance
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_PE(USART_TypeDef *USARTx)
+{
+  return ((READ_BIT(USARTx->SR, USART_SR_PE) == (USART_SR_PE)) ? 1UL : 0UL);
+}
+
+/**
+  * @brief  Clear the transmission complete flag.
+  * @rmtoll SR           TC            LL_USART_ClearFlag_TC
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_ClearFlag_TC(USART_TypeDef *USARTx)
+{
+  WRITE_REG(USARTx->SR, ~(USART_SR_TC));
+}
+
+/**
+  * @brief  Clear the error flags PE, FE, NE and ORE and the IDLE flag.
+  * @note   A read of SR then of DR, the data received is dropped.
+  * @rmtoll SR           PE            LL_USART_ClearFlag_Errors\n
+  *         SR           FE            LL_USART_ClearFlag_Errors\n
+  *         SR           NE            LL_USART_ClearFlag_Errors\n
+  *         SR           ORE           LL_USART_ClearFlag_Errors\n
+  *         SR           IDLE          LL_USART_ClearFlag_Errors
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_ClearFlag_Errors(USART_TypeDef *USARTx)
+{
+  __IO uint32_t tmpreg;
+
+  tmpreg = USARTx->SR;
+  (void) tmpreg;
+  tmpreg = USARTx->DR;
+  (void) tmpreg;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EF_IT_Management IT_Management
+  * @{
+  */
+
+/**
+  * @brief  Enable interrupts of CR1.
+  * @rmtoll CR1          IDLEIE        LL_USART_EnableIT\n
+  *         CR1          RXNEIE        LL_USART_EnableIT\n
+  *         CR1          TCIE          LL_USART_EnableIT\n
+  *         CR1          TXEIE         LL_USART_EnableIT\n
+  *         CR1          PEIE          LL_USART_EnableIT
+  * @param  USARTx USART Instance
+  * @param  Interrupts Any combination of USART_CR1_IDLEIE, USART_CR1_RXNEIE, USART_CR1_TCIE,
+  *         USART_CR1_TXEIE and USART_CR1_PEIE
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_EnableIT(USART_TypeDef *USARTx, uint32_t Interrupts)
+{
+  SET_BIT(USARTx->CR1, Interrupts);
+}
+
+/**
+  * @brief  Disable interrupts of CR1.
+  * @rmtoll CR1          IDLEIE        LL_USART_DisableIT\n
+  *         CR1          RXNEIE        LL_USART_DisableIT\n
+  *         CR1          TCIE          LL_USART_DisableIT\n
+  *         CR1          TXEIE         LL_USART_DisableIT\n
+  *         CR1          PEIE          LL_USART_DisableIT
+  * @param  USARTx USART Instance
+  * @param  Interrupts Any combination of USART_CR1_IDLEIE, USART_CR1_RXNEIE, USART_CR1_TCIE,
+  *         USART_CR1_TXEIE and USART_CR1_PEIE
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_DisableIT(USART_TypeDef *USARTx, uint32_t Interrupts)
+{
+  CLEAR_BIT(USARTx->CR1, Interrupts);
+}
+
+/**
+  * @brief  Return 1 if the interrupt is enabled.
+  * @rmtoll CR1          TXEIE         LL_USART_IsEnabledIT\n
+  *         CR1          RXNEIE        LL_USART_IsEnabledIT
+  * @param  USARTx USART Instance
+  * @param  Interrupt One of USART_CR1_IDLEIE, USART_CR1_RXNEIE, USART_CR1_TCIE,
+  *         USART_CR1_TXEIE and USART_CR1_PEIE
+  * @retval State of bit (1 or 0).
+  */
+__STATIC_INLINE uint32_t LL_USART_IsEnabledIT(USART_TypeDef *USARTx, uint32_t Interrupt)
+{
+  return ((READ_BIT(USARTx->CR1, Interrupt) == (Interrupt)) ? 1UL : 0UL);
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EF_DMA_Management DMA_Management
+  * @{
+  */
+
+/**
+  * @brief  Enable the DMA requests of the receiver.
+  * @rmtoll CR3          DMAR          LL_USART_EnableDMAReq_RX
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_EnableDMAReq_RX(USART_TypeDef *USARTx)
+{
+  SET_BIT(USARTx->CR3, USART_CR3_DMAR);
+}
+
+/**
+  * @brief  Disable the DMA requests of the receiver.
+  * @rmtoll CR3          DMAR          LL_USART_DisableDMAReq_RX
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_DisableDMAReq_RX(USART_TypeDef *USARTx)
+{
+  CLEAR_BIT(USARTx->CR3, USART_CR3_DMAR);
+}
+
+/**
+  * @brief  Enable the DMA requests of the transmitter.
+  * @rmtoll CR3          DMAT          LL_USART_EnableDMAReq_TX
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_EnableDMAReq_TX(USART_TypeDef *USARTx)
+{
+  SET_BIT(USARTx->CR3, USART_CR3_DMAT);
+}
+
+/**
+  * @brief  Disable the DMA requests of the transmitter.
+  * @rmtoll CR3          DMAT          LL_USART_DisableDMAReq_TX
+  * @param  USARTx USART Instance
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_DisableDMAReq_TX(USART_TypeDef *USARTx)
+{
+  CLEAR_BIT(USARTx->CR3, USART_CR3_DMAT);
+}
+
+/**
+  * @brief  Return the address of DR, for LL_DMA_SetPeriphAddress().
+  * @rmtoll DR           DR            LL_USART_DMA_GetRegAddr
+  * @param  USARTx USART Instance
+  * @retval Address of data register
+  */
+__STATIC_INLINE uint32_t LL_USART_DMA_GetRegAddr(USART_TypeDef *USARTx)
+{
+  return ((uint32_t) &(USARTx->DR));
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_LL_EF_Data_Management Data_Management
+  * @{
+  */
+
+/**
+  * @brief  Read a data received, 8 bits.
+  * @rmtoll DR           DR            LL_USART_ReceiveData8
+  * @param  USARTx USART Instance
+  * @retval Value between 0x00 and 0xFF
+  */
+__STATIC_INLINE uint8_t LL_USART_ReceiveData8(USART_TypeDef *USARTx)
+{
+  return (uint8_t)(READ_REG(USARTx->DR));
+}
+
+/**
+  * @brief  Read a data received, 9 bits.
+  * @rmtoll DR           DR            LL_USART_ReceiveData9
+  * @param  USARTx USART Instance
+  * @retval Value between 0x000 and 0x1FF
+  */
+__STATIC_INLINE uint16_t LL_USART_ReceiveData9(USART_TypeDef *USARTx)
+{
+  return (uint16_t)(READ_REG(USARTx->DR) & 0x1FFU);
+}
+
+/**
+  * @brief  Write a data to send, 8 bits.
+  * @rmtoll DR           DR            LL_USART_TransmitData8
+  * @param  USARTx USART Instance
+  * @param  Value between 0x00 and 0xFF
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_TransmitData8(USART_TypeDef *USARTx, uint8_t Value)
+{
+  WRITE_REG(USARTx->DR, Value);
+}
+
+/**
+  * @brief  Write a data to send, 9 bits.
+  * @rmtoll DR           DR            LL_USART_TransmitData9
+  * @param  USARTx USART Instance
+  * @param  Value between 0x000 and 0x1FF
+  * @retval None
+  */
+__STATIC_INLINE void LL_USART_TransmitData9(USART_TypeDef *USARTx, uint16_t Value)
+{
+  WRITE_REG(USARTx->DR, Value & 0x1FFU);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PY32F4xx_LL_USART_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
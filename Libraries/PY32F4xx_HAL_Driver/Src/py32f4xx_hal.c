@@ -67,6 +67,10 @@
 
 #define IDCODE_DEVID_MASK    0x00000FFFU
 
+#if (HAL_CRITICAL_PRIORITY != 0U) && (TICK_INT_PRIORITY < HAL_CRITICAL_PRIORITY)
+#error "TICK_INT_PRIORITY should not be in the zero-latency tier of HAL_CRITICAL_PRIORITY"
+#endif
+
 /**
   * @}
   */
@@ -148,6 +152,11 @@ HAL_StatusTypeDef HAL_Init(void)
   /* Use systick as time base source and configure 1ms tick (default clock after Reset is HSI) */
   HAL_InitTick(TICK_INT_PRIORITY);
 
+#if (USE_HAL_WAIT_STRATEGY != HAL_WAIT_SPIN)
+  /* Wake the WFE of the timeout loops on any interrupt pending, enabled or not */
+  SET_BIT(SCB->SCR, SCB_SCR_SEVONPEND_Msk);
+#endif
+
   /* Init the low level hardware */
   HAL_MspInit();
 
@@ -258,6 +267,8 @@ __weak HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
     [..]  This section provides functions allowing to:
       (+) Provide a tick value in millisecond
       (+) Provide a blocking delay in millisecond
+      (+) Wait in the timeout loops as USE_HAL_WAIT_STRATEGY
+      (+) Provide a cycle count and busy-wait delays in microsecond and nanosecond
       (+) Suspend the time base source interrupt
       (+) Resume the time base source interrupt
       (+) Get the HAL API driver version
@@ -280,7 +291,7 @@ __weak HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
   *      implementations in user file.
   * @retval None
   */
-__weak void HAL_IncTick(void)
+__weak __FLASH_RAM_FUNC void HAL_IncTick(void)
 {
   uwTick += uwTickFreq;
 }
@@ -291,7 +302,7 @@ __weak void HAL_IncTick(void)
   *       implementations in user file.
   * @retval tick value
   */
-__weak uint32_t HAL_GetTick(void)
+__weak __FLASH_RAM_FUNC uint32_t HAL_GetTick(void)
 {
   return uwTick;
 }
@@ -360,8 +371,47 @@ __weak void HAL_Delay(uint32_t Delay)
 
   while ((HAL_GetTick() - tickstart) < wait)
   {
+    __HAL_WAIT(tickstart);
+  }
+}
+
+#if (USE_HAL_WAIT_STRATEGY != HAL_WAIT_SPIN)
+/**
+  * @brief Wait in a timeout loop, called by __HAL_WAIT() of HAL_Delay() and of the drivers.
+  * @note  The loop spins its first HAL_WAIT_SPIN_TIME ms, then each call waits
+  *        with WFE for the next interrupt, the tick at the latest, or calls
+  *        HAL_WaitCallback(), as USE_HAL_WAIT_STRATEGY.
+  * @note  A flag without interrupt is then seen up to a tick late.
+  * @param Tickstart HAL_GetTick() at the start of the loop.
+  * @retval None
+  */
+void HAL_Wait(uint32_t Tickstart)
+{
+  if ((HAL_GetTick() - Tickstart) < HAL_WAIT_SPIN_TIME)
+  {
+    return;
   }
+
+#if (USE_HAL_WAIT_STRATEGY == HAL_WAIT_WFE)
+  __WFE();
+#else
+  HAL_WaitCallback();
+#endif
+}
+#endif /* USE_HAL_WAIT_STRATEGY */
+
+#if (USE_HAL_WAIT_STRATEGY == HAL_WAIT_CALLBACK)
+/**
+  * @brief Wait callback of HAL_Wait(), a yield to the other tasks.
+  * @retval None
+  */
+__weak void HAL_WaitCallback(void)
+{
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_WaitCallback could be implemented in the user file
+   */
 }
+#endif /* USE_HAL_WAIT_STRATEGY */
 
 /**
   * @brief Suspend Tick increment.
@@ -395,6 +445,96 @@ __weak void HAL_ResumeTick(void)
   SET_BIT(SysTick->CTRL, SysTick_CTRL_TICKINT_Msk);
 }
 
+/**
+  * @brief Start the DWT cycle counter, left counting when it already runs.
+  * @note  CYCCNT counts the HCLK cycles of the core, a debugger attached or not.
+  * @retval None
+  */
+void HAL_EnableCycleCounter(void)
+{
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+  {
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+}
+
+/**
+  * @brief Provide the DWT cycle count, wrapping every 2^32 cycles.
+  * @note  The counter runs once HAL_EnableCycleCounter() is called.
+  * @retval Cycle count
+  */
+uint32_t HAL_GetCycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief Convert microseconds to core cycles at the current SystemCoreClock.
+  * @param Us Microseconds.
+  * @retval Cycles, rounded up, 0xFFFFFFFF at most
+  */
+uint32_t HAL_UsToCycles(uint32_t Us)
+{
+  uint64_t cycles = (((uint64_t)Us * SystemCoreClock) + 999999U) / 1000000U;
+
+  return (cycles > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)cycles;
+}
+
+/**
+  * @brief Convert core cycles to microseconds at the current SystemCoreClock.
+  * @param Cycles Core cycles, a difference of HAL_GetCycles().
+  * @retval Microseconds, rounded down
+  */
+uint32_t HAL_CyclesToUs(uint32_t Cycles)
+{
+  return (uint32_t)(((uint64_t)Cycles * 1000000U) / SystemCoreClock);
+}
+
+/**
+  * @brief This function provides a busy-wait delay in microseconds on the DWT cycle counter.
+  * @note  The cycles are computed from SystemCoreClock at the call, the delay
+  *        staying right after a clock change. Up to 2^32 cycles, 26 s at 160 MHz.
+  * @note  Interrupts taken during the delay lengthen it.
+  * @param Delay specifies the delay time length, in microseconds.
+  * @retval None
+  */
+void HAL_DelayUs(uint32_t Delay)
+{
+  uint32_t start;
+  uint32_t cycles;
+
+  HAL_EnableCycleCounter();
+  start  = DWT->CYCCNT;
+  cycles = HAL_UsToCycles(Delay);
+
+  while ((DWT->CYCCNT - start) < cycles)
+  {
+  }
+}
+
+/**
+  * @brief This function provides a busy-wait delay in nanoseconds on the DWT cycle counter.
+  * @note  The delay is rounded up to a whole cycle, plus the cycles of the
+  *        call itself, about 30: use it for the waits of a few hundred ns or more.
+  * @param Delay specifies the delay time length, in nanoseconds.
+  * @retval None
+  */
+void HAL_DelayNs(uint32_t Delay)
+{
+  uint32_t start;
+  uint32_t cycles;
+
+  HAL_EnableCycleCounter();
+  start  = DWT->CYCCNT;
+  cycles = (uint32_t)((((uint64_t)Delay * SystemCoreClock) + 999999999U) / 1000000000U);
+
+  while ((DWT->CYCCNT - start) < cycles)
+  {
+  }
+}
+
 /**
   * @brief  Returns the HAL revision
   * @retval version 0xXYZR (8bits for each decimal, R for RC)
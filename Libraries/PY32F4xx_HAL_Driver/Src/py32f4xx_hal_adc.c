@@ -1349,6 +1349,8 @@ HAL_StatusTypeDef HAL_ADC_PollForEvent(ADC_HandleTypeDef* hadc, uint32_t EventTy
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(tickstart);
   }
   
   /* Analog watchdog (level out of window) event */
@@ -1983,7 +1985,6 @@ __weak void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
 HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig)
 { 
   HAL_StatusTypeDef tmp_hal_status = HAL_OK;
-  __IO uint32_t wait_loop_index = 0U;
   
   /* Check the parameters */
   assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
@@ -2051,12 +2052,7 @@ HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConf
         if (sConfig->Channel == ADC_CHANNEL_TEMPSENSOR)
         {
           /* Delay for temperature sensor stabilization time */
-          /* Compute number of CPU cycles to wait for */
-          wait_loop_index = (ADC_TEMPSENSOR_DELAY_US * (SystemCoreClock / 1000000U));
-          while(wait_loop_index != 0U)
-          {
-            wait_loop_index--;
-          }
+          HAL_DelayUs(ADC_TEMPSENSOR_DELAY_US);
         }
       }
     }
@@ -2215,7 +2211,6 @@ uint32_t HAL_ADC_GetError(ADC_HandleTypeDef *hadc)
 HAL_StatusTypeDef ADC_Enable(ADC_HandleTypeDef* hadc)
 {
   uint32_t tickstart = 0U;
-  __IO uint32_t wait_loop_index = 0U;
   
   /* ADC enable and wait for ADC ready (in case of ADC is disabled or         */
   /* enabling phase not yet completed: flag ADC ready not yet set).           */
@@ -2230,12 +2225,7 @@ HAL_StatusTypeDef ADC_Enable(ADC_HandleTypeDef* hadc)
     __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_JSTRT);     
     
     /* Delay for ADC stabilization time */
-    /* Compute number of CPU cycles to wait for */
-    wait_loop_index = (ADC_STAB_DELAY_US * (SystemCoreClock / 1000000U));
-    while(wait_loop_index != 0U)
-    {
-      wait_loop_index--;
-    }
+    HAL_DelayUs(ADC_STAB_DELAY_US);
     
     /* Get tick count */
     tickstart = HAL_GetTick();
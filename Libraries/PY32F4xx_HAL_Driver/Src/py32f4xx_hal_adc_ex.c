@@ -125,7 +125,6 @@ HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc)
 {
   HAL_StatusTypeDef tmp_hal_status = HAL_OK;
   uint32_t tickstart;
-  __IO uint32_t wait_loop_index = 0U;
   
   /* Check the parameters */
   assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
@@ -149,16 +148,9 @@ HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc)
                       HAL_ADC_STATE_BUSY_INTERNAL);
     
     /* Hardware prerequisite: delay before starting the calibration.          */
-    /*  - Computation of CPU clock cycles corresponding to ADC clock cycles.  */
     /*  - Wait for the expected ADC clock cycles delay */
-    wait_loop_index = ((SystemCoreClock
-                        / HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC))
-                       * ADC_PRECALIBRATION_DELAY_ADCCLOCKCYCLES        );
-
-    while(wait_loop_index != 0U)
-    {
-      wait_loop_index--;
-    }
+    HAL_DelayNs(((ADC_PRECALIBRATION_DELAY_ADCCLOCKCYCLES * 1000000000U)
+                 / HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC)) + 1U);
     
     /* 2. Check the ADC enable registers */
     if(HAL_IS_BIT_SET(hadc->Instance->CR2, ADC_CR2_ADON))
@@ -253,7 +245,6 @@ HAL_StatusTypeDef HAL_ADCEx_Calibration_SetAndStart(ADC_HandleTypeDef* hadc,uint
 {
   HAL_StatusTypeDef tmp_hal_status = HAL_OK;
   uint32_t tickstart;
-  __IO uint32_t wait_loop_index = 0U;
   
   /* Check the parameters */
   assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
@@ -279,16 +270,9 @@ HAL_StatusTypeDef HAL_ADCEx_Calibration_SetAndStart(ADC_HandleTypeDef* hadc,uint
                       HAL_ADC_STATE_BUSY_INTERNAL);
     
     /* Hardware prerequisite: delay before starting the calibration.          */
-    /*  - Computation of CPU clock cycles corresponding to ADC clock cycles.  */
     /*  - Wait for the expected ADC clock cycles delay */
-    wait_loop_index = ((SystemCoreClock
-                        / HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC))
-                       * ADC_PRECALIBRATION_DELAY_ADCCLOCKCYCLES        );
-
-    while(wait_loop_index != 0U)
-    {
-      wait_loop_index--;
-    }
+    HAL_DelayNs(((ADC_PRECALIBRATION_DELAY_ADCCLOCKCYCLES * 1000000000U)
+                 / HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC)) + 1U);
     
     /* 2. Check the ADC enable registers */
     if(HAL_IS_BIT_SET(hadc->Instance->CR2, ADC_CR2_ADON))
@@ -1197,7 +1181,6 @@ __weak void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef* hadc)
 HAL_StatusTypeDef HAL_ADCEx_InjectedConfigChannel(ADC_HandleTypeDef* hadc, ADC_InjectionConfTypeDef* sConfigInjected)
 {
   HAL_StatusTypeDef tmp_hal_status = HAL_OK;
-  __IO uint32_t wait_loop_index = 0U;
   
   /* Check the parameters */
   assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
@@ -1411,12 +1394,7 @@ HAL_StatusTypeDef HAL_ADCEx_InjectedConfigChannel(ADC_HandleTypeDef* hadc, ADC_I
         if (sConfigInjected->InjectedChannel == ADC_CHANNEL_TEMPSENSOR)
         {
           /* Delay for temperature sensor stabilization time */
-          /* Compute number of CPU cycles to wait for */
-          wait_loop_index = (ADC_TEMPSENSOR_DELAY_US * (SystemCoreClock / 1000000U));
-          while(wait_loop_index != 0U)
-          {
-            wait_loop_index--;
-          }
+          HAL_DelayUs(ADC_TEMPSENSOR_DELAY_US);
         }
       }
     }
@@ -25,6 +25,12 @@
     (#) Configure the priority of the selected IRQ Channels using HAL_NVIC_SetPriority(). 
     (#) Enable the selected IRQ Channels using HAL_NVIC_EnableIRQ().
     (#) please refer to programming manual for details in how to configure priority. 
+    (#) Built with USE_VECT_TAB_RAM=y, the vector table is copied to SRAM by
+        SystemInit(): install handlers at run time with HAL_NVIC_SetVector().
+    (#) With HAL_CRITICAL_PRIORITY N of py32f4xx_hal_conf.h, the critical sections
+        of the HAL mask only the preemption priorities N and above in number: the
+        IRQs given a preemption priority below N are never delayed by the HAL and
+        must not call any HAL function.
       
      -@- When the NVIC_PRIORITYGROUP_0 is selected, IRQ preemption is no more possible. 
          The pending IRQ priority will be managed only by the sub priority.
@@ -63,7 +69,27 @@
        Reload Value = SysTick Counter Clock (Hz) x  Desired Time base (s)
        (++) Reload Value is the parameter to be passed for HAL_SYSTICK_Config() function
        (++) Reload Value should not exceed 0xFFFFFF
-   
+
+    [..]
+    *** How to configure the FPU context of the interrupts ***
+    ==========================================================
+    [..]
+    Once the code interrupted has used the FPU, the core stacks S0-S15 and FPSCR
+    with the frame of an exception, 17 words more, for a handler which may use
+    the FPU too.
+
+   (+) FPU_CONTEXT_LAZY, the reset value, only reserves the room: the registers
+       are written by the first FP instruction of the handler. An integer-only
+       handler pays a few cycles, one using the FPU the stacking on its first
+       FP instruction.
+   (+) FPU_CONTEXT_IMMEDIATE stacks them on the entry, a fixed but longer
+       latency, the same whether the handler uses the FPU or not.
+   (+) FPU_CONTEXT_NONE never stacks them: the shortest entry, but only one of
+       the thread code or the handlers may use the FPU.
+   (+) Call HAL_FPU_ConfigContext() early in main(), in Thread mode, before any
+       handler using the FPU may run. Examples/Benchmark/FPU_Context measures the
+       entry and exit of an interrupt in each case.
+
   @endverbatim
   ******************************************************************************
   * @attention
@@ -338,6 +364,47 @@ void HAL_MPU_ConfigRegion(MPU_Region_InitTypeDef *MPU_Init)
 }
 #endif /* __MPU_PRESENT */
 
+#if (__FPU_PRESENT == 1U)
+/**
+  * @brief  Set how the FPU registers are preserved by the exceptions.
+  * @note   With FPU_CONTEXT_NONE the FP context of the thread is dropped: the
+  *         next exception stacks the basic frame, the FP registers keeping
+  *         their values but no longer preserved.
+  * @param  Context: Preservation of S0-S15 and FPSCR.
+  *         This parameter can be one of the following values:
+  *            @arg FPU_CONTEXT_NONE
+  *            @arg FPU_CONTEXT_IMMEDIATE
+  *            @arg FPU_CONTEXT_LAZY
+  * @retval None
+  */
+void HAL_FPU_ConfigContext(uint32_t Context)
+{
+  /* Check the parameters */
+  assert_param(IS_FPU_CONTEXT(Context));
+
+  MODIFY_REG(FPU->FPCCR, FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk, Context);
+  if (Context == FPU_CONTEXT_NONE)
+  {
+    __set_CONTROL(__get_CONTROL() & ~CONTROL_FPCA_Msk);
+  }
+
+  __DSB();
+  __ISB();
+}
+
+/**
+  * @brief  Get how the FPU registers are preserved by the exceptions.
+  * @retval FPU_CONTEXT_NONE, FPU_CONTEXT_IMMEDIATE or FPU_CONTEXT_LAZY
+  */
+uint32_t HAL_FPU_GetContext(void)
+{
+  uint32_t context = FPU->FPCCR & (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+
+  /* LSPEN alone acts as none, ASPEN clear */
+  return ((context & FPU_FPCCR_ASPEN_Msk) != 0U) ? context : FPU_CONTEXT_NONE;
+}
+#endif /* __FPU_PRESENT */
+
 /**
   * @brief  Gets the priority grouping field from the NVIC Interrupt Controller.
   * @retval Priority grouping field (SCB->AIRCR [10:8] PRIGROUP field)
@@ -442,6 +509,46 @@ uint32_t HAL_NVIC_GetActive(IRQn_Type IRQn)
   return NVIC_GetActive(IRQn);
 }
 
+/**
+  * @brief  Installs the handler of an interrupt in the vector table.
+  * @note   The vector table should be in SRAM, see USE_VECT_TAB_RAM of the
+  *         Makefile: it stays in the FLASH otherwise and HAL_ERROR is returned.
+  *         The interrupt may be enabled: the new handler is taken from the
+  *         next entry on.
+  * @param  IRQn External interrupt number, or a processor exception number.
+  *         This parameter can be an enumerator of IRQn_Type enumeration
+  *         (For the complete PY32 Devices IRQ Channels list, please refer to the appropriate CMSIS device file (py32f4xx.h))
+  * @param  Handler Interrupt handler.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_NVIC_SetVector(IRQn_Type IRQn, void (*Handler)(void))
+{
+  if ((Handler == NULL) || (IRQn < NonMaskableInt_IRQn) || (SCB->VTOR < SRAM_BASE))
+  {
+    return HAL_ERROR;
+  }
+
+  NVIC_SetVector(IRQn, (uint32_t)Handler);
+  __DSB();
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Gets the handler of an interrupt from the vector table.
+  * @param  IRQn External interrupt number, or a processor exception number.
+  *         This parameter can be an enumerator of IRQn_Type enumeration
+  *         (For the complete PY32 Devices IRQ Channels list, please refer to the appropriate CMSIS device file (py32f4xx.h))
+  * @retval Address of the interrupt handler
+  */
+uint32_t HAL_NVIC_GetVector(IRQn_Type IRQn)
+{
+  /* Check the parameters */
+  assert_param(IRQn >= NonMaskableInt_IRQn);
+
+  return NVIC_GetVector(IRQn);
+}
+
 /**
   * @brief  Configures the SysTick clock source.
   * @param  CLKSource: specifies the SysTick clock source.
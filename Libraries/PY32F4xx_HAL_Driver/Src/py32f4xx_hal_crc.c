@@ -16,7 +16,8 @@
     [..]
          (+) Enable CRC AHB clock using __HAL_RCC_CRC_CLK_ENABLE();
          (+) Initialize CRC calculator
-             (++) specify generating polynomial (peripheral default or non-default one)
+             (++) the generating polynomial is fixed by the peripheral,
+                  DEFAULT_CRC32_POLY
              (++) specify initialization value (peripheral default or non-default one)
              (++) specify input data format
              (++) specify input or output data inversion mode if any
@@ -26,6 +27,35 @@
          (+) Use HAL_CRC_Calculate() function to compute the CRC value of the
              input data buffer starting with the defined initialization value
              (default or non-default) to initiate CRC calculation
+         (+) Use HAL_CRC_Calculate_DMA() or HAL_CRC_Accumulate_DMA() to feed a
+             word buffer with a memory to memory DMA channel
+             (++) link the channel with __HAL_LINKDMA(hcrc, hdma, hdma_crc) and
+                  initialize it in HAL_CRC_MspInit(): Direction
+                  DMA_MEMORY_TO_MEMORY, PeriphInc DMA_PINC_ENABLE (the buffer),
+                  MemInc DMA_MINC_DISABLE (DR), word alignments, DMA_NORMAL
+             (++) enable the DMA channel interrupt, the buffer is fed by
+                  chunks of 65535 words
+             (++) HAL_CRC_CpltCallback() is called at the end of the buffer,
+                  get the CRC with HAL_CRC_GetValue()
+         (+) Use HAL_CRC_SaveContext() and HAL_CRC_RestoreContext() to share the
+             calculator between computations: the context holds the
+             configuration and the data register, an accumulation restored
+             goes on where it was saved
+
+    [..]
+      (@) The peripheral only has a 32-bit data register reset to
+          DEFAULT_CRC_INITVALUE. The driver packs the bytes and half-words
+          into words, most significant first, applies the data inversions
+          with the core bit reversal instructions and computes the last bytes
+          or half-word of a buffer by software. A non default initial value is
+          loaded by feeding the word that leads DR to it.
+      (@) The DMA feeds the words as they are in memory: it needs the word
+          format and no input data inversion. The output data inversion is
+          applied by HAL_CRC_GetValue().
+      (@) The standard CRC-32 (Ethernet, zlib) of a byte stream is given by
+          the byte format, CRC_INPUTDATA_INVERSION_BYTE,
+          CRC_OUTPUTDATA_INVERSION_ENABLE and the default initial value, the
+          result XORed with 0xFFFFFFFF.
 
   @endverbatim
   ******************************************************************************
@@ -61,9 +91,35 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+/** @defgroup CRC_Private_Constants CRC Private Constants
+  * @{
+  */
+#define CRC_DMA_MAX_LENGTH    0xFFFFU   /* Words fed by one DMA transfer */
+/**
+  * @}
+  */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+/** @defgroup CRC_Private_Functions CRC Private Functions
+  * @{
+  */
+static uint32_t CRC_Shift(uint32_t Crc, uint32_t Data, uint32_t Bits);
+static void CRC_Load(CRC_HandleTypeDef *hcrc, uint32_t Value);
+static uint32_t CRC_InvertWord(CRC_HandleTypeDef *hcrc, uint32_t Data);
+static uint32_t CRC_Output(CRC_HandleTypeDef *hcrc, uint32_t Crc);
+static uint32_t CRC_Handle_8(CRC_HandleTypeDef *hcrc, uint8_t pBuffer[], uint32_t BufferLength);
+static uint32_t CRC_Handle_16(CRC_HandleTypeDef *hcrc, uint16_t pBuffer[], uint32_t BufferLength);
+static uint32_t CRC_Handle(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+static HAL_StatusTypeDef CRC_Start_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength,
+                                       uint32_t Reset);
+static HAL_StatusTypeDef CRC_DMANext(CRC_HandleTypeDef *hcrc);
+static void CRC_DMAXferCplt(DMA_HandleTypeDef *hdma);
+static void CRC_DMAError(DMA_HandleTypeDef *hdma);
+/**
+  * @}
+  */
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -105,6 +161,10 @@ HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
 
   /* Check the parameters */
   assert_param(IS_CRC_ALL_INSTANCE(hcrc->Instance));
+  assert_param(IS_DEFAULT_INIT_VALUE(hcrc->Init.DefaultInitValueUse));
+  assert_param(IS_CRC_INPUTDATA_INVERSION_MODE(hcrc->Init.InputDataInversionMode));
+  assert_param(IS_CRC_OUTPUTDATA_INVERSION_MODE(hcrc->Init.OutputDataInversionMode));
+  assert_param(IS_CRC_INPUTDATA_FORMAT(hcrc->InputDataFormat));
 
   if (hcrc->State == HAL_CRC_STATE_RESET)
   {
@@ -207,80 +267,210 @@ __weak void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc)
                       ##### Peripheral Control functions #####
  ===============================================================================
     [..]  This section provides functions allowing to:
-      (+) compute the 32-bit CRC value of a 32-bit data buffer
+      (+) compute the 32-bit CRC value of a 8-bit, 16-bit or 32-bit data buffer
           using combination of the previous CRC value and the new one.
 
        [..]  or
 
-      (+) compute the 32-bit CRC value of a 32-bit data buffer
+      (+) compute the 32-bit CRC value of a 8-bit, 16-bit or 32-bit data buffer
           independently of the previous CRC value.
 
+      (+) feed a 32-bit data buffer with the DMA, with or without the previous
+          CRC value, and get the CRC value at the end of the transfer.
+
+      (+) save and restore the computation context.
+
 @endverbatim
   * @{
   */
 
 /**
-  * @brief  Compute the 32-bit CRC value of a 32-bit data buffer
+  * @brief  Compute the 32-bit CRC value of a 8, 16 or 32-bit data buffer
   *         starting with the previously computed CRC as initialization value.
   * @param  hcrc CRC handle
-  * @param  pBuffer pointer to the input data buffer.
-  * @param  BufferLength input data buffer length (number of uint32_t words).
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note  By default, the API expects a uint32_t pointer as input buffer parameter.
+  *        Input buffer pointers with other types simply need to be cast in uint32_t
+  *        and the API will internally adjust its input data processing based on the
+  *        handle field hcrc->InputDataFormat.
   * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
   */
 uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
 {
-  uint32_t index;      /* CRC input data buffer index */
   uint32_t temp = 0U;  /* CRC output (read from hcrc->Instance->DR register) */
 
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_BUSY;
 
-  /* Enter Data to the CRC calculator */
-  for (index = 0U; index < BufferLength; index++)
-  {
-    hcrc->Instance->DR = pBuffer[index];
-  }
-  temp = hcrc->Instance->DR;
+  temp = CRC_Handle(hcrc, pBuffer, BufferLength);
 
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_READY;
 
   /* Return the CRC computed value */
-  return temp;
+  return CRC_Output(hcrc, temp);
 }
 
 /**
-  * @brief  Compute the 32-bit CRC value of a 32-bit data buffer
-  *         starting with hcrc->Instance->INIT as initialization value.
+  * @brief  Compute the 32-bit CRC value of a 8, 16 or 32-bit data buffer
+  *         starting with the defined initialization value.
   * @param  hcrc CRC handle
-  * @param  pBuffer pointer to the input data buffer.
-  * @param  BufferLength input data buffer length (number of uint32_t words).
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note  By default, the API expects a uint32_t pointer as input buffer parameter.
+  *        Input buffer pointers with other types simply need to be cast in uint32_t
+  *        and the API will internally adjust its input data processing based on the
+  *        handle field hcrc->InputDataFormat.
   * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
   */
 uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
 {
-  uint32_t index;      /* CRC input data buffer index */
   uint32_t temp = 0U;  /* CRC output (read from hcrc->Instance->DR register) */
 
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_BUSY;
 
-  /* Reset CRC Calculation Unit (hcrc->Instance->INIT is
-  *  written in hcrc->Instance->DR) */
+  /* Reset CRC Calculation Unit (DEFAULT_CRC_INITVALUE is written in
+  *  hcrc->Instance->DR), then load the user-defined initialization value */
   __HAL_CRC_DR_RESET(hcrc);
-
-  /* Enter 32-bit input data to the CRC calculator */
-  for (index = 0U; index < BufferLength; index++)
+  if (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_DISABLE)
   {
-    hcrc->Instance->DR = pBuffer[index];
+    CRC_Load(hcrc, hcrc->Init.InitValue);
   }
-  temp = hcrc->Instance->DR;
+
+  temp = CRC_Handle(hcrc, pBuffer, BufferLength);
 
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_READY;
 
   /* Return the CRC computed value */
-  return temp;
+  return CRC_Output(hcrc, temp);
+}
+
+/**
+  * @brief  Return the CRC value of the data fed so far.
+  * @note   Used at the end of a DMA transfer, the output data inversion is
+  *         applied.
+  * @param  hcrc CRC handle
+  * @retval uint32_t CRC
+  */
+uint32_t HAL_CRC_GetValue(CRC_HandleTypeDef *hcrc)
+{
+  return CRC_Output(hcrc, hcrc->Instance->DR);
+}
+
+/**
+  * @brief  Feed a 32-bit data buffer with the DMA starting with the previously
+  *         computed CRC as initialization value.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer, word aligned.
+  * @param  BufferLength input data buffer length (number of uint32_t words).
+  * @note   The buffer must stay unchanged until HAL_CRC_CpltCallback().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_Accumulate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  return CRC_Start_DMA(hcrc, pBuffer, BufferLength, 0U);
+}
+
+/**
+  * @brief  Feed a 32-bit data buffer with the DMA starting with the defined
+  *         initialization value.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer, word aligned.
+  * @param  BufferLength input data buffer length (number of uint32_t words).
+  * @note   The buffer must stay unchanged until HAL_CRC_CpltCallback().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_Calculate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  return CRC_Start_DMA(hcrc, pBuffer, BufferLength, 1U);
+}
+
+/**
+  * @brief  CRC DMA transfer completed callback.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+__weak void HAL_CRC_CpltCallback(CRC_HandleTypeDef *hcrc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcrc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_CRC_CpltCallback can be implemented in the user file
+   */
+}
+
+/**
+  * @brief  CRC DMA transfer error callback.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+__weak void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *hcrc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcrc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_CRC_ErrorCallback can be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Save the computation context.
+  * @note   Not to be called while a DMA transfer feeds the data register.
+  * @param  hcrc CRC handle
+  * @param  pContext Pointer to a CRC_ContextTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_SaveContext(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext)
+{
+  if (pContext == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  pContext->Init            = hcrc->Init;
+  pContext->InputDataFormat = hcrc->InputDataFormat;
+  pContext->Value           = hcrc->Instance->DR;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Restore a computation context.
+  * @note   The data register is loaded with the saved value, HAL_CRC_Accumulate()
+  *         then goes on with the saved computation.
+  * @param  hcrc CRC handle
+  * @param  pContext Pointer to a CRC_ContextTypeDef structure saved by
+  *         HAL_CRC_SaveContext() or filled by the user.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_RestoreContext(CRC_HandleTypeDef *hcrc, const CRC_ContextTypeDef *pContext)
+{
+  if (pContext == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Check the parameters */
+  assert_param(IS_CRC_INPUTDATA_INVERSION_MODE(pContext->Init.InputDataInversionMode));
+  assert_param(IS_CRC_OUTPUTDATA_INVERSION_MODE(pContext->Init.OutputDataInversionMode));
+  assert_param(IS_CRC_INPUTDATA_FORMAT(pContext->InputDataFormat));
+
+  hcrc->Init            = pContext->Init;
+  hcrc->InputDataFormat = pContext->InputDataFormat;
+  CRC_Load(hcrc, pContext->Value);
+
+  return HAL_OK;
 }
 
 /**
@@ -320,6 +510,345 @@ HAL_CRC_StateTypeDef HAL_CRC_GetState(CRC_HandleTypeDef *hcrc)
   * @}
   */
 
+/** @addtogroup CRC_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Shift data into a CRC by software, most significant bit first.
+  * @param  Crc CRC value
+  * @param  Data Data, right aligned
+  * @param  Bits Number of bits of Data, 8 or 16
+  * @retval uint32_t CRC
+  */
+static uint32_t CRC_Shift(uint32_t Crc, uint32_t Data, uint32_t Bits)
+{
+  uint32_t bit;
+
+  Crc ^= Data << (32U - Bits);
+  for (bit = 0U; bit < Bits; bit++)
+  {
+    Crc = ((Crc & 0x80000000U) != 0U) ? ((Crc << 1U) ^ DEFAULT_CRC32_POLY) : (Crc << 1U);
+  }
+
+  return Crc;
+}
+
+/**
+  * @brief  Load a value in the CRC data register.
+  * @note   A word w written in DR gives M(DR ^ w), M being the 32 shifts of
+  *         the polynomial. M is inverted by shifting the value back, the
+  *         polynomial having its bit 0 set: writing DR ^ M^-1(Value) gives
+  *         Value.
+  * @param  hcrc CRC handle
+  * @param  Value New value of DR
+  * @retval None
+  */
+static void CRC_Load(CRC_HandleTypeDef *hcrc, uint32_t Value)
+{
+  uint32_t bit;
+
+  for (bit = 0U; bit < 32U; bit++)
+  {
+    Value = ((Value & 1U) != 0U) ? (((Value ^ DEFAULT_CRC32_POLY) >> 1U) | 0x80000000U) : (Value >> 1U);
+  }
+  hcrc->Instance->DR = hcrc->Instance->DR ^ Value;
+}
+
+/**
+  * @brief  Apply the input data inversion to a word.
+  * @param  hcrc CRC handle
+  * @param  Data Input word
+  * @retval uint32_t Inverted word
+  */
+static uint32_t CRC_InvertWord(CRC_HandleTypeDef *hcrc, uint32_t Data)
+{
+  switch (hcrc->Init.InputDataInversionMode)
+  {
+    case CRC_INPUTDATA_INVERSION_BYTE:
+      return __REV(__RBIT(Data));
+    case CRC_INPUTDATA_INVERSION_HALFWORD:
+      return __ROR(__RBIT(Data), 16U);
+    case CRC_INPUTDATA_INVERSION_WORD:
+      return __RBIT(Data);
+    default:
+      return Data;
+  }
+}
+
+/**
+  * @brief  Apply the output data inversion to a CRC.
+  * @param  hcrc CRC handle
+  * @param  Crc CRC value
+  * @retval uint32_t CRC
+  */
+static uint32_t CRC_Output(CRC_HandleTypeDef *hcrc, uint32_t Crc)
+{
+  return (hcrc->Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE) ? __RBIT(Crc) : Crc;
+}
+
+/**
+  * @brief  Enter 8-bit input data to the CRC calculator.
+  * @note   The bytes are packed by four, the first one most significant, the
+  *         last one to three are computed by software and loaded back in DR.
+  *         With an inversion, the bits of the last bytes are reversed in each
+  *         byte.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer
+  * @param  BufferLength input data buffer length
+  * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
+  */
+static uint32_t CRC_Handle_8(CRC_HandleTypeDef *hcrc, uint8_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t i; /* input data buffer index */
+  uint32_t crc;
+  uint32_t data;
+
+  /* Processing time optimization: 4 bytes are entered in a row with a single word write,
+   * last bytes must be carefully fed to the CRC calculator to ensure a correct type
+   * handling by the peripheral */
+  for (i = 0U; i < (BufferLength / 4U); i++)
+  {
+    data = ((uint32_t)pBuffer[4U * i] << 24U) | ((uint32_t)pBuffer[(4U * i) + 1U] << 16U) | \
+           ((uint32_t)pBuffer[(4U * i) + 2U] << 8U) | (uint32_t)pBuffer[(4U * i) + 3U];
+    hcrc->Instance->DR = CRC_InvertWord(hcrc, data);
+  }
+
+  crc = hcrc->Instance->DR;
+  if ((BufferLength % 4U) != 0U)
+  {
+    for (i = 4U * (BufferLength / 4U); i < BufferLength; i++)
+    {
+      data = pBuffer[i];
+      if (hcrc->Init.InputDataInversionMode != CRC_INPUTDATA_INVERSION_NONE)
+      {
+        data = __RBIT(data) >> 24U;
+      }
+      crc = CRC_Shift(crc, data, 8U);
+    }
+    CRC_Load(hcrc, crc);
+  }
+
+  /* Return the CRC computed value */
+  return crc;
+}
+
+/**
+  * @brief  Enter 16-bit input data to the CRC calculator.
+  * @note   The half-words are packed by two, the first one most significant,
+  *         the last one is computed by software and loaded back in DR. With
+  *         an inversion, the bits of the last half-word are reversed in each
+  *         byte for CRC_INPUTDATA_INVERSION_BYTE, in the half-word otherwise.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer
+  * @param  BufferLength input data buffer length
+  * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
+  */
+static uint32_t CRC_Handle_16(CRC_HandleTypeDef *hcrc, uint16_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t i;  /* input data buffer index */
+  uint32_t crc;
+  uint32_t data;
+
+  /* Processing time optimization: 2 HalfWords are entered in a row with a single word write,
+   * in case of odd length, last HalfWord must be carefully fed to the CRC calculator to ensure
+   * a correct type handling by the peripheral */
+  for (i = 0U; i < (BufferLength / 2U); i++)
+  {
+    data = ((uint32_t)pBuffer[2U * i] << 16U) | (uint32_t)pBuffer[(2U * i) + 1U];
+    hcrc->Instance->DR = CRC_InvertWord(hcrc, data);
+  }
+
+  crc = hcrc->Instance->DR;
+  if ((BufferLength % 2U) != 0U)
+  {
+    data = pBuffer[2U * (BufferLength / 2U)];
+    if (hcrc->Init.InputDataInversionMode == CRC_INPUTDATA_INVERSION_BYTE)
+    {
+      data = __REV(__RBIT(data)) & 0xFFFFU;
+    }
+    else if (hcrc->Init.InputDataInversionMode != CRC_INPUTDATA_INVERSION_NONE)
+    {
+      data = __RBIT(data) >> 16U;
+    }
+    else
+    {
+      /* No inversion */
+    }
+    crc = CRC_Shift(crc, data, 16U);
+    CRC_Load(hcrc, crc);
+  }
+
+  /* Return the CRC computed value */
+  return crc;
+}
+
+/**
+  * @brief  Enter input data to the CRC calculator in the handle format.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer
+  * @param  BufferLength input data buffer length, in units of the format
+  * @retval uint32_t CRC, before the output data inversion
+  */
+static uint32_t CRC_Handle(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t index;      /* CRC input data buffer index */
+
+  switch (hcrc->InputDataFormat)
+  {
+    case CRC_INPUTDATA_FORMAT_BYTES:
+      return CRC_Handle_8(hcrc, (uint8_t *)pBuffer, BufferLength);
+    case CRC_INPUTDATA_FORMAT_HALFWORDS:
+      return CRC_Handle_16(hcrc, (uint16_t *)(void *)pBuffer, BufferLength);
+    default:
+      /* Enter 32-bit input data to the CRC calculator */
+      if (hcrc->Init.InputDataInversionMode == CRC_INPUTDATA_INVERSION_NONE)
+      {
+        for (index = 0U; index < BufferLength; index++)
+        {
+          hcrc->Instance->DR = pBuffer[index];
+        }
+      }
+      else
+      {
+        for (index = 0U; index < BufferLength; index++)
+        {
+          hcrc->Instance->DR = CRC_InvertWord(hcrc, pBuffer[index]);
+        }
+      }
+      return hcrc->Instance->DR;
+  }
+}
+
+/**
+  * @brief  Start feeding a word buffer with the DMA.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer
+  * @param  BufferLength input data buffer length (number of uint32_t words)
+  * @param  Reset 1 to start from the initialization value, 0 to accumulate
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRC_Start_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength,
+                                       uint32_t Reset)
+{
+  /* The DMA writes the words as they are */
+  if ((hcrc->hdma == NULL) || (pBuffer == NULL) || (BufferLength == 0U) || \
+      ((hcrc->InputDataFormat != CRC_INPUTDATA_FORMAT_UNDEFINED) && (hcrc->InputDataFormat != CRC_INPUTDATA_FORMAT_WORDS)) || \
+      (hcrc->Init.InputDataInversionMode != CRC_INPUTDATA_INVERSION_NONE))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(hcrc);
+
+  if (hcrc->State != HAL_CRC_STATE_READY)
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_BUSY;
+  }
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_BUSY;
+
+  if (Reset != 0U)
+  {
+    __HAL_CRC_DR_RESET(hcrc);
+    if (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_DISABLE)
+    {
+      CRC_Load(hcrc, hcrc->Init.InitValue);
+    }
+  }
+
+  hcrc->pBuffPtr  = pBuffer;
+  hcrc->XferCount = BufferLength;
+
+  hcrc->hdma->XferCpltCallback     = CRC_DMAXferCplt;
+  hcrc->hdma->XferHalfCpltCallback = NULL;
+  hcrc->hdma->XferErrorCallback    = CRC_DMAError;
+  hcrc->hdma->XferAbortCallback    = NULL;
+
+  if (CRC_DMANext(hcrc) != HAL_OK)
+  {
+    hcrc->State = HAL_CRC_STATE_READY;
+
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_ERROR;
+  }
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hcrc);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the DMA transfer of the next chunk of the buffer.
+  * @param  hcrc CRC handle
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRC_DMANext(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t length = hcrc->XferCount;
+  uint32_t *src = hcrc->pBuffPtr;
+
+  if (length > CRC_DMA_MAX_LENGTH)
+  {
+    length = CRC_DMA_MAX_LENGTH;
+  }
+  hcrc->XferCount -= length;
+  hcrc->pBuffPtr  += length;
+
+  /* Memory to memory: the source is the peripheral side of the channel */
+  return HAL_DMA_Start_IT(hcrc->hdma, (uint32_t)src, (uint32_t)&hcrc->Instance->DR, length);
+}
+
+/**
+  * @brief  DMA CRC transfer complete callback.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRC_DMAXferCplt(DMA_HandleTypeDef *hdma)
+{
+  CRC_HandleTypeDef *hcrc = (CRC_HandleTypeDef *)(hdma->Parent);
+
+  if (hcrc->XferCount != 0U)
+  {
+    if (CRC_DMANext(hcrc) != HAL_OK)
+    {
+      hcrc->State = HAL_CRC_STATE_ERROR;
+      HAL_CRC_ErrorCallback(hcrc);
+    }
+    return;
+  }
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_READY;
+
+  HAL_CRC_CpltCallback(hcrc);
+}
+
+/**
+  * @brief  DMA CRC communication error callback.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRC_DMAError(DMA_HandleTypeDef *hdma)
+{
+  CRC_HandleTypeDef *hcrc = (CRC_HandleTypeDef *)(hdma->Parent);
+
+  hcrc->XferCount = 0U;
+  hcrc->State = HAL_CRC_STATE_ERROR;
+
+  HAL_CRC_ErrorCallback(hcrc);
+}
+
+/**
+  * @}
+  */
+
 
 #endif /* HAL_CRC_MODULE_ENABLED */
 /**
@@ -206,6 +206,13 @@ HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
   /* Initialise the error code */
   hdma->ErrorCode = HAL_DMA_ERROR_NONE;
 
+  /* No descriptor chain attached, double buffer mode stopped */
+  hdma->pChainDesc = NULL;
+  hdma->DoubleBuffer.Active = 0U;
+
+  /* Not part of an interrupt coalescing group */
+  hdma->pCoalesce = NULL;
+
   /* Initialize the DMA state*/
   hdma->State = HAL_DMA_STATE_READY;
   /* Allocate lock resource and initialize it */
@@ -269,11 +276,19 @@ HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
   /* Clear all flags */
   hdma->DmaBaseAddress->IFCR = (DMA_ISR_GIF1 << (hdma->ChannelIndex));
 
+  /* No descriptor chain attached, double buffer mode stopped */
+  hdma->pChainDesc = NULL;
+  hdma->DoubleBuffer.Active = 0U;
+
+  /* Leave the interrupt coalescing group */
+  hdma->pCoalesce = NULL;
+
   /* Clean all callbacks */
   hdma->XferCpltCallback = NULL;
   hdma->XferHalfCpltCallback = NULL;
   hdma->XferErrorCallback = NULL;
   hdma->XferAbortCallback = NULL;
+  hdma->XferM1CpltCallback = NULL;
 
   /* Reset the error code */
   hdma->ErrorCode = HAL_DMA_ERROR_NONE;
@@ -396,6 +411,13 @@ HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
       __HAL_DMA_DISABLE_IT(hdma, DMA_IT_HT);
       __HAL_DMA_ENABLE_IT(hdma, (DMA_IT_TC | DMA_IT_TE));
     }
+
+    /* Coalescing group: only some transfers raise the complete interrupt */
+    if(hdma->pCoalesce != NULL)
+    {
+      DMA_CoalesceStart(hdma);
+    }
+
     /* Enable the Peripheral */
     __HAL_DMA_ENABLE(hdma);
   }
@@ -440,6 +462,12 @@ HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
       
     /* Clear all flags */
     hdma->DmaBaseAddress->IFCR = (DMA_ISR_GIF1 << hdma->ChannelIndex);
+
+    /* Drop the remaining fragments of a descriptor chain */
+    hdma->pChainDesc = NULL;
+
+    /* Stop the double buffer mode */
+    hdma->DoubleBuffer.Active = 0U;
   }
   /* Change the DMA state */
   hdma->State = HAL_DMA_STATE_READY;
@@ -478,6 +506,12 @@ HAL_StatusTypeDef HAL_DMA_Abort_IT(DMA_HandleTypeDef *hdma)
     /* Clear all flags */
     __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_GI_FLAG_INDEX(hdma));
 
+    /* Drop the remaining fragments of a descriptor chain */
+    hdma->pChainDesc = NULL;
+
+    /* Stop the double buffer mode */
+    hdma->DoubleBuffer.Active = 0U;
+
     /* Change the DMA state */
     hdma->State = HAL_DMA_STATE_READY;
 
@@ -548,6 +582,10 @@ HAL_StatusTypeDef HAL_DMA_PollForTransfer(DMA_HandleTypeDef *hdma, uint32_t Comp
       /* Update error code */
       SET_BIT(hdma->ErrorCode, HAL_DMA_ERROR_TE);
 
+#if (USE_HAL_DMA_STATISTICS == 1U)
+      DMA_StatsError(hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+
       /* Change the DMA state */
       hdma->State= HAL_DMA_STATE_READY;
 
@@ -580,6 +618,10 @@ HAL_StatusTypeDef HAL_DMA_PollForTransfer(DMA_HandleTypeDef *hdma, uint32_t Comp
     /* Clear the transfer complete flag */
     __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma));
 
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsComplete(hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+
     /* The selected Channelx EN bit is cleared (DMA is disabled and
     all transfers are complete) */
     hdma->State = HAL_DMA_STATE_READY;
@@ -632,6 +674,30 @@ void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
   /* Transfer Complete Interrupt management ***********************************/
   else if (((flag_it & (DMA_FLAG_TC1 << hdma->ChannelIndex)) != RESET) && ((source_it & DMA_IT_TC) != RESET))
   {
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsComplete(hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+    /* Descriptor chain: restart the channel on the next fragment */
+    if(hdma->pChainDesc != NULL)
+    {
+      hdma->DmaBaseAddress->IFCR = (DMA_FLAG_TC1 << hdma->ChannelIndex);
+
+      if(DMA_ChainLoadNext(hdma) != 0U)
+      {
+        return;
+      }
+    }
+
+    /* Double buffer mode: switch to the other buffer */
+    if(hdma->DoubleBuffer.Active != 0U)
+    {
+      hdma->DmaBaseAddress->IFCR = (DMA_FLAG_TC1 << hdma->ChannelIndex);
+
+      DMA_MultiBufferSwap(hdma);
+      return;
+    }
+
     if((hdma->Instance->CCR & DMA_CCR_CIRC) == 0U)
     {
       /* Disable the transfer complete and error interrupt */
@@ -651,6 +717,12 @@ void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
       /* Transfer complete callback */
       hdma->XferCpltCallback(hdma);
     }
+
+    /* Coalescing group: report the other completed transfers of the group */
+    if(hdma->pCoalesce != NULL)
+    {
+      (void)DMA_CoalesceFlush(hdma->pCoalesce, 1U);
+    }
   }
 
   /* Transfer Error Interrupt management **************************************/
@@ -667,6 +739,13 @@ void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
     /* Update error code */
     hdma->ErrorCode = HAL_DMA_ERROR_TE;
 
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsError(hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+    /* Stop the double buffer mode */
+    hdma->DoubleBuffer.Active = 0U;
+
     /* Change the DMA state */
     hdma->State = HAL_DMA_STATE_READY;
 
@@ -718,6 +797,10 @@ HAL_StatusTypeDef HAL_DMA_RegisterCallback(DMA_HandleTypeDef *hdma, HAL_DMA_Call
     case  HAL_DMA_XFER_ABORT_CB_ID:
       hdma->XferAbortCallback = pCallback;
       break; 
+
+    case  HAL_DMA_XFER_M1CPLT_CB_ID:
+      hdma->XferM1CpltCallback = pCallback;
+      break;
       
     default:
       status = HAL_ERROR;
@@ -770,11 +853,16 @@ HAL_StatusTypeDef HAL_DMA_UnRegisterCallback(DMA_HandleTypeDef *hdma, HAL_DMA_Ca
       hdma->XferAbortCallback = NULL;
       break; 
 
+    case  HAL_DMA_XFER_M1CPLT_CB_ID:
+      hdma->XferM1CpltCallback = NULL;
+      break;
+
     case   HAL_DMA_XFER_ALL_CB_ID:
       hdma->XferCpltCallback = NULL;
       hdma->XferHalfCpltCallback = NULL;
       hdma->XferErrorCallback = NULL;
       hdma->XferAbortCallback = NULL;
+      hdma->XferM1CpltCallback = NULL;
       break; 
 
     default:
@@ -889,6 +977,20 @@ uint32_t HAL_DMA_GetError(DMA_HandleTypeDef *hdma)
   */
 static void DMA_SetConfig(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
 {
+  /* Single block transfer, no descriptor chain nor double buffer */
+  hdma->pChainDesc = NULL;
+  hdma->DoubleBuffer.Active = 0U;
+
+  /* The DMA ignores the low address bits of half word and word accesses */
+  if((hdma->Init.Direction) == DMA_MEMORY_TO_PERIPH)
+  {
+    assert_param(IS_DMA_CHANNEL_ALIGNED(hdma, DstAddress, SrcAddress));
+  }
+  else
+  {
+    assert_param(IS_DMA_CHANNEL_ALIGNED(hdma, SrcAddress, DstAddress));
+  }
+
   /* Clear all flags */
   hdma->DmaBaseAddress->IFCR = (DMA_ISR_GIF1 << hdma->ChannelIndex);
 
@@ -913,6 +1015,10 @@ static void DMA_SetConfig(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t
     /* Configure DMA Channel destination address */
     hdma->Instance->CMAR = DstAddress;
   }
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+  DMA_StatsStart(hdma, DataLength);
+#endif /* USE_HAL_DMA_STATISTICS */
 }
 
 /**
@@ -0,0 +1,2107 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_dma_ex.c
+  * @author  MCU Application Team
+  * @brief   DMA Extension HAL module driver
+  *          This file provides firmware functions to manage the following
+  *          functionalities of the DMA Extension peripheral:
+  *           + Extended features functions
+  *
+  @verbatim
+  ==============================================================================
+                        ##### How to use this driver #####
+  ==============================================================================
+  [..]
+  The DMA Extension HAL driver can be used as follows:
+   (#) Initialize the DMA Channel with HAL_DMA_Init() as for a single block transfer.
+
+   (#) Descriptor chain operation:
+       (+) Build a linked list of DMA_ChainDescTypeDef entries, each describing
+           one fragment (source, destination, length and flags). The last entry
+           must have pNext set to NULL.
+       (+) Use HAL_DMAEx_StartChain() to start the chain. The first fragment is
+           programmed immediately, the next ones are loaded by HAL_DMA_IRQHandler()
+           from the transfer complete interrupt.
+       (+) Only the registers which differ from the previous fragment are written
+           when a fragment is loaded.
+       (+) XferCpltCallback is called once, after the last fragment. A transfer
+           error stops the chain and calls XferErrorCallback; hdma->pChainDesc
+           then points to the failing fragment.
+
+     -@-  The chain must stay in memory until the completion callback is called.
+     -@-  Circular mode is not allowed with descriptor chains.
+
+   (#) Double buffer operation:
+       (+) Use HAL_DMAEx_MultiBufferStart_IT() with two independent buffers. They
+           do not need to be contiguous nor to have the same length.
+       (+) When a buffer is done the channel is switched to the other one and
+           XferCpltCallback (memory 0) or XferM1CpltCallback (memory 1) is called.
+           The buffer is then owned by the application until it calls
+           HAL_DMAEx_ReleaseMemory(), or HAL_DMAEx_ChangeMemory() to hand over a
+           new buffer in its place. Both can be called from the callback.
+       (+) If the next buffer is still owned by the application when the channel
+           must switch to it, the transfer is stopped, HAL_DMA_ERROR_OVERRUN is
+           set and XferErrorCallback is called.
+       (+) Use HAL_DMA_Abort() or HAL_DMA_Abort_IT() to stop the stream.
+
+     -@-  The channel must be configured in DMA_NORMAL mode, the buffers are
+          switched by software. Memory to memory direction is not supported.
+
+   (#) Channel pool operation:
+       (+) Use HAL_DMAEx_ChannelAlloc() before HAL_DMA_Init() instead of setting
+           hdma->Instance by hand. A free channel is selected according to
+           hdma->Init.Priority, the request is mapped on it with
+           HAL_DMA_ChannelMap() and the handle is recorded as its owner.
+           High priority requests get the lowest channel numbers, which win the
+           hardware arbitration, low priority requests get the highest ones.
+       (+) Use HAL_DMAEx_ChannelClaim() for a channel that must be fixed, the
+           call fails if another handle already owns it.
+       (+) Use HAL_DMAEx_GetIRQn() to enable the channel interrupt and call
+           HAL_DMAEx_ChannelIRQHandler() from the DMA channel IRQ handlers to
+           reach the owner handle.
+       (+) Use HAL_DMAEx_ChannelFree() after HAL_DMA_DeInit() to return the
+           channel to the pool, and HAL_DMAEx_GetChannelUsage() to dump the
+           ownership table.
+
+   (#) Memory to memory engine operation:
+       (+) Set hdma->Instance (or use HAL_DMAEx_ChannelAlloc()) and
+           hdma->Init.Priority, enable the channel interrupt, then call
+           HAL_DMAEx_MemEngineInit(). It initializes the channel in memory to
+           memory mode and takes over its callbacks.
+       (+) Use HAL_DMAEx_MemCpyAsync() or HAL_DMAEx_MemSetAsync() to queue a
+           request. Each request is split in blocks
+           of at most 65535 data items, using word accesses whenever the
+           addresses and the remaining size allow it.
+       (+) Requests are served by priority, set in the request Priority field,
+           then in order. The channel priority follows the request being
+           transferred, so low priority copies give way to the peripheral
+           channels in the DMA arbiter.
+       (+) Use HAL_DMAEx_MemSetChunkSize() to split the requests below
+           DMA_PRIORITY_VERY_HIGH in shorter blocks: a request of higher
+           priority then starts at the next block boundary, so it waits for
+           at most one chunk of the request in progress.
+       (+) Completion is reported by the request XferCpltCallback, or by
+           polling the request with HAL_DMAEx_MemPollForRequest().
+
+   (#) Statistics operation:
+       (+) Set USE_HAL_DMA_STATISTICS to 1U in py32f4xx_hal_conf.h. The driver
+           then counts, for each channel, the completed blocks, the transfer
+           errors, the bytes moved and the block latency measured with the
+           DWT cycle counter, which is enabled on the first transfer.
+       (+) Use HAL_DMAEx_GetStats() to read the counters of a channel,
+           HAL_DMAEx_DumpStats() to print all active channels with printf()
+           and HAL_DMAEx_ResetStats() to clear them.
+
+   (#) Receive ring buffer operation:
+       (+) Initialize the peripheral Rx DMA handle in DMA_CIRCULAR mode and
+           call HAL_DMAEx_RingInit() with the ring storage.
+       (+) Start the reception with HAL_UART_ReceiveToRing_DMA(),
+           HAL_SPI_ReceiveToRing_DMA() or HAL_I2S_ReceiveToRing_DMA(), or
+           call HAL_DMAEx_RingAttach() then start the channel on the ring
+           storage for any other peripheral.
+       (+) In the consumer, HAL_DMAEx_RingAcquire() returns the largest
+           contiguous block of received bytes, which is processed in place
+           and released with HAL_DMAEx_RingCommit(). Two calls are needed to
+           drain the ring when the data wraps around its end.
+       (+) The ring does not detect overruns: it must be drained faster than
+           the channel fills it. The half transfer and transfer complete
+           callbacks of the peripheral can be used to wake up the consumer.
+
+   (#) Interrupt coalescing operation:
+       (+) Call HAL_DMAEx_CoalesceInit() with the number N of transfers
+           started in the group between two transfer complete interrupts,
+           then HAL_DMAEx_CoalesceAdd() for each channel, after HAL_DMA_Init().
+       (+) Transfers started with HAL_DMA_Start_IT() on a member channel,
+           directly or through a peripheral driver, only enable the transfer
+           complete interrupt for every Nth start of the group. When it fires,
+           all completed transfers of the group are reported, each one through
+           its XferCpltCallback, and XferBatchCallback then gets their number.
+       (+) Call HAL_DMAEx_CoalesceTimeout() periodically, typically from the
+           period elapsed callback of a basic timer such as TIM6 or TIM7, to
+           bound the completion latency to one timer period.
+       (+) A channel stays busy until its completion is reported, so this
+           mode suits groups of channels running small independent transfers.
+           Transfer errors are still reported immediately.
+
+   (#) Alignment operation:
+       (+) Declare DMA buffers with __DMA_BUFFER_ALIGNED so that half word and
+           word accesses can be used. The DMA ignores the low address bits of
+           wider accesses, so a misaligned buffer is silently shifted:
+           HAL_DMA_Start() and HAL_DMA_Start_IT() assert the alignment when
+           USE_FULL_ASSERT is defined, HAL_DMAEx_CheckBuffer() does it at run
+           time.
+       (+) HAL_DMAEx_GetBestWidth() returns the widest access usable for a
+           transfer and HAL_DMAEx_ConfigDataWidth() switches the peripheral
+           and memory data sizes of an idle channel, e.g. before a memory to
+           memory transfer or a 16-bit SPI frame. Peripherals with a byte
+           data register still need byte accesses on both sides: the DMA does
+           not pack bytes into words.
+
+  @endverbatim
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @defgroup DMAEx DMAEx
+  * @brief DMA Extended HAL module driver
+  * @{
+  */
+
+#ifdef HAL_DMA_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+#if (USE_HAL_DMA_STATISTICS == 1U)
+/** @defgroup DMAEx_Private_Types DMAEx Private Types
+  * @{
+  */
+typedef struct
+{
+  DMA_StatsTypeDef      Stats;                /* Published counters                   */
+  uint32_t              StartCycle;           /* DWT cycle count at block start       */
+  uint32_t              Length;               /* Data items of the block in progress  */
+  uint32_t              Bytes;                /* Bytes of the block in progress       */
+} DMA_ChannelStatsTypeDef;
+/**
+  * @}
+  */
+#endif /* USE_HAL_DMA_STATISTICS */
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup DMAEx_Private_Variables DMAEx Private Variables
+  * @{
+  */
+/* Channel pool, in HAL_DMA_ChannelMap() position order */
+static DMA_ChannelInfoTypeDef DMA_ChannelPool[DMA_CHANNEL_NUMBER] =
+{
+  {DMA1_Channel1, NULL, 0U},
+  {DMA1_Channel2, NULL, 0U},
+  {DMA1_Channel3, NULL, 0U},
+  {DMA1_Channel4, NULL, 0U},
+  {DMA1_Channel5, NULL, 0U},
+  {DMA1_Channel6, NULL, 0U},
+  {DMA1_Channel7, NULL, 0U},
+#if defined (DMA2)
+  {DMA2_Channel1, NULL, 0U},
+  {DMA2_Channel2, NULL, 0U},
+  {DMA2_Channel3, NULL, 0U},
+  {DMA2_Channel4, NULL, 0U},
+  {DMA2_Channel5, NULL, 0U},
+#endif /* DMA2 */
+};
+
+/* Pool search order for high priority requests: channel 1 of both controllers
+   first, then channel 2 and so on. Low priority requests walk it backwards. */
+static const uint8_t DMA_ChannelOrder[DMA_CHANNEL_NUMBER] =
+{
+#if defined (DMA2)
+  0U, 7U, 1U, 8U, 2U, 9U, 3U, 10U, 4U, 11U, 5U, 6U
+#else
+  0U, 1U, 2U, 3U, 4U, 5U, 6U
+#endif /* DMA2 */
+};
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+/* Per channel statistics, in DMA_ChannelPool order */
+static DMA_ChannelStatsTypeDef DMA_Stats[DMA_CHANNEL_NUMBER];
+#endif /* USE_HAL_DMA_STATISTICS */
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup DMAEx_Private_Functions
+  * @{
+  */
+static uint32_t DMA_ChainGetCCR(DMA_HandleTypeDef *hdma, const DMA_ChainDescTypeDef *pDesc);
+static int32_t DMA_ChannelPoolIndex(const DMA_Channel_TypeDef *Instance);
+static HAL_StatusTypeDef DMA_MemSubmit(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq);
+static HAL_StatusTypeDef DMA_MemStartBlock(DMA_MemEngineTypeDef *hmem);
+static void DMA_MemXferCplt(DMA_HandleTypeDef *hdma);
+static void DMA_MemXferError(DMA_HandleTypeDef *hdma);
+static void DMA_MemRequestDone(DMA_MemEngineTypeDef *hmem, uint32_t State);
+static uint32_t DMA_RingGetHead(const DMA_RingTypeDef *pRing);
+#if (USE_HAL_DMA_STATISTICS == 1U)
+static uint32_t DMA_StatsIndex(const DMA_HandleTypeDef *hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+/**
+  * @}
+  */
+
+/* Exported functions ---------------------------------------------------------*/
+
+/** @defgroup DMAEx_Exported_Functions DMAEx Exported Functions
+  * @{
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group1 Descriptor chain functions
+  *  @brief   Descriptor chain functions
+  *
+@verbatim
+ ===============================================================================
+                  #####  Descriptor chain functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Start a transfer made of several fragments described by a linked list
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start a descriptor chain transfer with interrupt enabled.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @param  pChain: Pointer to the first entry of the descriptor chain.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_StartChain(DMA_HandleTypeDef *hdma, DMA_ChainDescTypeDef *pChain)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* Check the parameters */
+  if(pChain == NULL)
+  {
+    return HAL_ERROR;
+  }
+  assert_param(IS_DMA_BUFFER_SIZE(pChain->DataLength));
+  assert_param(IS_DMA_CHAIN_FLAGS(pChain->Flags));
+
+  /* Process locked */
+  __HAL_LOCK(hdma);
+
+  if(HAL_DMA_STATE_READY == hdma->State)
+  {
+    /* Chained fragments are reloaded by software, circular mode would never end */
+    if(hdma->Init.Mode != DMA_NORMAL)
+    {
+      hdma->ErrorCode = HAL_DMA_ERROR_NOT_SUPPORTED;
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(hdma);
+
+      return HAL_ERROR;
+    }
+
+    /* Change DMA peripheral state */
+    hdma->State = HAL_DMA_STATE_BUSY;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+
+    /* Disable the peripheral */
+    __HAL_DMA_DISABLE(hdma);
+
+    /* Clear all flags */
+    hdma->DmaBaseAddress->IFCR = (DMA_ISR_GIF1 << hdma->ChannelIndex);
+
+    /* Configure the first fragment */
+    hdma->pChainDesc = pChain;
+    hdma->Instance->CNDTR = pChain->DataLength;
+    if((hdma->Init.Direction) == DMA_MEMORY_TO_PERIPH)
+    {
+      hdma->Instance->CPAR = pChain->DstAddress;
+      hdma->Instance->CMAR = pChain->SrcAddress;
+    }
+    else
+    {
+      hdma->Instance->CPAR = pChain->SrcAddress;
+      hdma->Instance->CMAR = pChain->DstAddress;
+    }
+
+    /* Enable the transfer complete and the transfer error interrupts, the
+       half transfer interrupt is meaningless for a chain */
+    hdma->Instance->CCR = (DMA_ChainGetCCR(hdma, pChain) & ~DMA_IT_HT) | DMA_IT_TC | DMA_IT_TE;
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsStart(hdma, pChain->DataLength);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+    /* Enable the Peripheral */
+    __HAL_DMA_ENABLE(hdma);
+  }
+  else
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hdma);
+
+    /* Remain BUSY */
+    status = HAL_BUSY;
+  }
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group2 Double buffer mode functions
+  *  @brief   Double buffer mode functions
+  *
+@verbatim
+ ===============================================================================
+                  #####  Double buffer mode functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Start a ping-pong transfer between one peripheral and two buffers
+      (+) Replace or release a buffer while the transfer is running
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start the double buffer mode transfer with interrupt enabled.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @param  PeriphAddress: The peripheral data register address
+  * @param  Mem0Address: The memory 0 buffer address
+  * @param  Mem0Length: The length of memory 0 buffer, in data items
+  * @param  Mem1Address: The memory 1 buffer address
+  * @param  Mem1Length: The length of memory 1 buffer, in data items
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_MultiBufferStart_IT(DMA_HandleTypeDef *hdma, uint32_t PeriphAddress,
+                                                uint32_t Mem0Address, uint32_t Mem0Length,
+                                                uint32_t Mem1Address, uint32_t Mem1Length)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* Check the parameters */
+  assert_param(IS_DMA_BUFFER_SIZE(Mem0Length));
+  assert_param(IS_DMA_BUFFER_SIZE(Mem1Length));
+
+  /* Process locked */
+  __HAL_LOCK(hdma);
+
+  if(HAL_DMA_STATE_READY == hdma->State)
+  {
+    /* Buffers are switched by software on transfer complete */
+    if((hdma->Init.Mode != DMA_NORMAL) || (hdma->Init.Direction == DMA_MEMORY_TO_MEMORY))
+    {
+      hdma->ErrorCode = HAL_DMA_ERROR_NOT_SUPPORTED;
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(hdma);
+
+      return HAL_ERROR;
+    }
+
+    /* Change DMA peripheral state */
+    hdma->State = HAL_DMA_STATE_BUSY;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+
+    /* Disable the peripheral */
+    __HAL_DMA_DISABLE(hdma);
+
+    /* Initialize the double buffer context */
+    hdma->pChainDesc = NULL;
+    hdma->DoubleBuffer.Address[0] = Mem0Address;
+    hdma->DoubleBuffer.Length[0]  = Mem0Length;
+    hdma->DoubleBuffer.Address[1] = Mem1Address;
+    hdma->DoubleBuffer.Length[1]  = Mem1Length;
+    hdma->DoubleBuffer.Full[0]    = 0U;
+    hdma->DoubleBuffer.Full[1]    = 0U;
+    hdma->DoubleBuffer.Target     = (uint8_t)MEMORY0;
+    hdma->DoubleBuffer.Active     = 1U;
+
+    /* Clear all flags */
+    hdma->DmaBaseAddress->IFCR = (DMA_ISR_GIF1 << hdma->ChannelIndex);
+
+    /* Program memory 0 */
+    hdma->Instance->CNDTR = Mem0Length;
+    hdma->Instance->CPAR = PeriphAddress;
+    hdma->Instance->CMAR = Mem0Address;
+
+    /* Enable the transfer complete and the transfer error interrupts */
+    __HAL_DMA_DISABLE_IT(hdma, DMA_IT_HT);
+    __HAL_DMA_ENABLE_IT(hdma, (DMA_IT_TC | DMA_IT_TE));
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsStart(hdma, Mem0Length);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+    /* Enable the Peripheral */
+    __HAL_DMA_ENABLE(hdma);
+  }
+  else
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hdma);
+
+    /* Remain BUSY */
+    status = HAL_BUSY;
+  }
+  return status;
+}
+
+/**
+  * @brief  Hand over a new buffer for the next transfer of a double buffer stream.
+  * @note   The buffer being transferred cannot be changed. The replaced buffer
+  *         is released, so this function can be called instead of
+  *         HAL_DMAEx_ReleaseMemory() for zero-copy streaming.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @param  Address: The new memory buffer address
+  * @param  Length: The length of the new buffer, in data items
+  * @param  memory: the memory buffer to be changed, This parameter can be one of
+  *                     the following values:
+  *                      MEMORY0 /
+  *                      MEMORY1
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_ChangeMemory(DMA_HandleTypeDef *hdma, uint32_t Address, uint32_t Length, HAL_DMA_MemoryTypeDef memory)
+{
+  /* Check the parameters */
+  assert_param(IS_DMA_MEMORY(memory));
+  assert_param(IS_DMA_BUFFER_SIZE(Length));
+
+  if((hdma->DoubleBuffer.Active != 0U) && (hdma->DoubleBuffer.Target == (uint8_t)memory))
+  {
+    /* Buffer in use by the channel */
+    return HAL_ERROR;
+  }
+
+  hdma->DoubleBuffer.Address[memory] = Address;
+  hdma->DoubleBuffer.Length[memory]  = Length;
+  hdma->DoubleBuffer.Full[memory]    = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Give a buffer back to the channel of a double buffer stream.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @param  memory: the memory buffer to be released, This parameter can be one of
+  *                     the following values:
+  *                      MEMORY0 /
+  *                      MEMORY1
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_ReleaseMemory(DMA_HandleTypeDef *hdma, HAL_DMA_MemoryTypeDef memory)
+{
+  /* Check the parameters */
+  assert_param(IS_DMA_MEMORY(memory));
+
+  hdma->DoubleBuffer.Full[memory] = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group3 Channel pool functions
+  *  @brief   Channel pool functions
+  *
+@verbatim
+ ===============================================================================
+                    #####  Channel pool functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Allocate a DMA channel at runtime and map a request on it
+      (+) Claim a fixed channel with conflict detection
+      (+) Release a channel and dump the channel ownership
+      (+) Dispatch a channel interrupt to its owner
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Allocate a free DMA channel to a handle and map a request on it.
+  * @note   hdma->Init.Priority selects the search order, the selected channel
+  *         is written to hdma->Instance. Call HAL_DMA_Init() afterwards.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @param  MapReqNum: DMA request, a value of @ref DMA_Channel_map
+  * @retval HAL status, HAL_BUSY when no channel is available
+  */
+HAL_StatusTypeDef HAL_DMAEx_ChannelAlloc(DMA_HandleTypeDef *hdma, uint32_t MapReqNum)
+{
+  uint32_t critical;
+  uint32_t i;
+  uint32_t index = DMA_CHANNEL_NUMBER;
+
+  /* Check the parameters */
+  if(hdma == NULL)
+  {
+    return HAL_ERROR;
+  }
+  assert_param(IS_DMA_MAP_VALUE(MapReqNum));
+  assert_param(IS_DMA_PRIORITY(hdma->Init.Priority));
+
+  /* Enter critical section */
+  critical = HAL_EnterCritical();
+
+  for(i = 0U; i < DMA_CHANNEL_NUMBER; i++)
+  {
+    if(hdma->Init.Priority >= DMA_PRIORITY_HIGH)
+    {
+      index = DMA_ChannelOrder[i];
+    }
+    else
+    {
+      index = DMA_ChannelOrder[DMA_CHANNEL_NUMBER - 1U - i];
+    }
+
+    if(DMA_ChannelPool[index].Owner == NULL)
+    {
+      DMA_ChannelPool[index].Owner = hdma;
+      DMA_ChannelPool[index].Request = MapReqNum;
+      break;
+    }
+  }
+
+  /* Exit critical section: restore previous priority mask */
+  HAL_ExitCritical(critical);
+
+  if(i == DMA_CHANNEL_NUMBER)
+  {
+    /* All channels in use */
+    return HAL_BUSY;
+  }
+
+  hdma->Instance = DMA_ChannelPool[index].Instance;
+  HAL_DMA_ChannelMap(hdma, MapReqNum);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Claim a given DMA channel for a handle and map a request on it.
+  * @note   The selected channel is written to hdma->Instance. Claiming again a
+  *         channel already owned by the same handle only updates the request.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @param  Instance: DMA channel to claim.
+  * @param  MapReqNum: DMA request, a value of @ref DMA_Channel_map
+  * @retval HAL status, HAL_BUSY when the channel is owned by another handle
+  */
+HAL_StatusTypeDef HAL_DMAEx_ChannelClaim(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *Instance, uint32_t MapReqNum)
+{
+  uint32_t critical;
+  int32_t index;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* Check the parameters */
+  if(hdma == NULL)
+  {
+    return HAL_ERROR;
+  }
+  assert_param(IS_DMA_ALL_INSTANCE(Instance));
+  assert_param(IS_DMA_MAP_VALUE(MapReqNum));
+
+  index = DMA_ChannelPoolIndex(Instance);
+  if(index < 0)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Enter critical section */
+  critical = HAL_EnterCritical();
+
+  if((DMA_ChannelPool[index].Owner == NULL) || (DMA_ChannelPool[index].Owner == hdma))
+  {
+    DMA_ChannelPool[index].Owner = hdma;
+    DMA_ChannelPool[index].Request = MapReqNum;
+  }
+  else
+  {
+    status = HAL_BUSY;
+  }
+
+  /* Exit critical section: restore previous priority mask */
+  HAL_ExitCritical(critical);
+
+  if(status == HAL_OK)
+  {
+    hdma->Instance = Instance;
+    HAL_DMA_ChannelMap(hdma, MapReqNum);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Return the channel owned by a handle to the pool.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_ChannelFree(DMA_HandleTypeDef *hdma)
+{
+  int32_t index;
+
+  if(hdma == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  index = DMA_ChannelPoolIndex(hdma->Instance);
+  if((index < 0) || (DMA_ChannelPool[index].Owner != hdma))
+  {
+    return HAL_ERROR;
+  }
+
+  DMA_ChannelPool[index].Owner = NULL;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy the channel ownership table.
+  * @param  pTable: Array of DMA_CHANNEL_NUMBER entries filled in channel order,
+  *                 can be NULL to only count the channels in use.
+  * @retval Number of channels in use
+  */
+uint32_t HAL_DMAEx_GetChannelUsage(DMA_ChannelInfoTypeDef *pTable)
+{
+  uint32_t i;
+  uint32_t used = 0U;
+
+  for(i = 0U; i < DMA_CHANNEL_NUMBER; i++)
+  {
+    if(pTable != NULL)
+    {
+      pTable[i] = DMA_ChannelPool[i];
+    }
+    if(DMA_ChannelPool[i].Owner != NULL)
+    {
+      used++;
+    }
+  }
+
+  return used;
+}
+
+/**
+  * @brief  Return the interrupt number of the channel used by a handle.
+  * @note   DMA2 channel 4 and channel 5 share the same interrupt.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval IRQ number
+  */
+IRQn_Type HAL_DMAEx_GetIRQn(DMA_HandleTypeDef *hdma)
+{
+  uint32_t position;
+
+  assert_param(IS_DMA_ALL_INSTANCE(hdma->Instance));
+
+#if defined (DMA2)
+  if ((uint32_t)(hdma->Instance) >= (uint32_t)(DMA2_Channel1))
+  {
+    /* DMA2 */
+    position = ((uint32_t)hdma->Instance - (uint32_t)DMA2_Channel1) / ((uint32_t)DMA2_Channel2 - (uint32_t)DMA2_Channel1);
+    if(position > 3U)
+    {
+      position = 3U;
+    }
+    return (IRQn_Type)((uint32_t)DMA2_Channel1_IRQn + position);
+  }
+#endif /* DMA2 */
+
+  /* DMA1 */
+  position = ((uint32_t)hdma->Instance - (uint32_t)DMA1_Channel1) / ((uint32_t)DMA1_Channel2 - (uint32_t)DMA1_Channel1);
+  return (IRQn_Type)((uint32_t)DMA1_Channel1_IRQn + position);
+}
+
+/**
+  * @brief  Handle a DMA channel interrupt for the handle owning the channel.
+  * @note   For DMA2_Channel4_5_IRQHandler() call this function for both channels.
+  * @param  Instance: DMA channel which raised the interrupt.
+  * @retval None
+  */
+void HAL_DMAEx_ChannelIRQHandler(DMA_Channel_TypeDef *Instance)
+{
+  int32_t index = DMA_ChannelPoolIndex(Instance);
+
+  if((index >= 0) && (DMA_ChannelPool[index].Owner != NULL))
+  {
+    HAL_DMA_IRQHandler(DMA_ChannelPool[index].Owner);
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group4 Memory to memory engine functions
+  *  @brief   Memory to memory engine functions
+  *
+@verbatim
+ ===============================================================================
+             #####  Memory to memory engine functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Bind a DMA channel to a memory to memory engine
+      (+) Queue asynchronous memcpy and memset requests
+      (+) Poll for the completion of a request
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a memory to memory engine on a DMA channel.
+  * @note   hdma->Instance and hdma->Init.Priority must be set, the other
+  *         Init fields are overwritten.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_MemEngineInit(DMA_MemEngineTypeDef *hmem, DMA_HandleTypeDef *hdma)
+{
+  if((hmem == NULL) || (hdma == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  hdma->Init.Direction           = DMA_MEMORY_TO_MEMORY;
+  hdma->Init.PeriphInc           = DMA_PINC_ENABLE;
+  hdma->Init.MemInc              = DMA_MINC_ENABLE;
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hdma->Init.Mode                = DMA_NORMAL;
+
+  if(HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  hdma->XferCpltCallback     = DMA_MemXferCplt;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferErrorCallback    = DMA_MemXferError;
+  hdma->XferAbortCallback    = NULL;
+  hdma->Parent               = hmem;
+
+  hmem->hdma      = hdma;
+  hmem->pHead     = NULL;
+  hmem->pActive   = NULL;
+  hmem->ChunkSize = 0U;
+  hmem->BlockSize = 0U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue an asynchronous memory copy.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  pReq: Request storage, owned by the caller until completion.
+  *               Priority, XferCpltCallback and pContext must be set before
+  *               the call.
+  * @param  pDst: Destination buffer.
+  * @param  pSrc: Source buffer.
+  * @param  Size: Number of bytes to copy.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_MemCpyAsync(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq,
+                                        void *pDst, const void *pSrc, uint32_t Size)
+{
+  if((pReq == NULL) || (pDst == NULL) || (pSrc == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  pReq->SrcAddress = (uint32_t)pSrc;
+  pReq->DstAddress = (uint32_t)pDst;
+  pReq->Size       = Size;
+  pReq->Pattern    = 0U;
+  pReq->IsMemSet   = 0U;
+
+  return DMA_MemSubmit(hmem, pReq);
+}
+
+/**
+  * @brief  Queue an asynchronous memory set.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  pReq: Request storage, owned by the caller until completion.
+  *               Priority, XferCpltCallback and pContext must be set before
+  *               the call.
+  * @param  pDst: Destination buffer.
+  * @param  Value: Byte value to write.
+  * @param  Size: Number of bytes to set.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_MemSetAsync(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq,
+                                        void *pDst, uint8_t Value, uint32_t Size)
+{
+  if((pReq == NULL) || (pDst == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  pReq->SrcAddress = (uint32_t)&pReq->Pattern;
+  pReq->DstAddress = (uint32_t)pDst;
+  pReq->Size       = Size;
+  pReq->Pattern    = (uint32_t)Value * 0x01010101U;
+  pReq->IsMemSet   = 1U;
+
+  return DMA_MemSubmit(hmem, pReq);
+}
+
+/**
+  * @brief  Wait for the completion of a memory request.
+  * @note   Completion is detected by the DMA interrupt, it must be enabled.
+  * @param  pReq: Request to wait for.
+  * @param  Timeout: Timeout duration in ms.
+  * @retval HAL status, HAL_ERROR if the request ended with a transfer error
+  */
+HAL_StatusTypeDef HAL_DMAEx_MemPollForRequest(DMA_MemRequestTypeDef *pReq, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while(pReq->State == DMA_MEM_REQ_QUEUED)
+  {
+    if(Timeout != HAL_MAX_DELAY)
+    {
+      if((Timeout == 0U) || ((HAL_GetTick() - tickstart) > Timeout))
+      {
+        return HAL_TIMEOUT;
+      }
+    }
+  }
+
+  return (pReq->State == DMA_MEM_REQ_DONE) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Limit the DMA block size of the requests below DMA_PRIORITY_VERY_HIGH.
+  * @note   Takes effect from the next DMA block.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  ChunkSize: Maximum number of bytes per block, 0 for no limit. Rounded
+  *         down to a multiple of the access width, at least one data item.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_MemSetChunkSize(DMA_MemEngineTypeDef *hmem, uint32_t ChunkSize)
+{
+  if(hmem == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  hmem->ChunkSize = ChunkSize;
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group8 Alignment functions
+  *  @brief   Alignment functions
+  *
+@verbatim
+ ===============================================================================
+                       #####  Alignment functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Find the widest access usable for a transfer
+      (+) Check a buffer against the data sizes of a channel
+      (+) Switch the data sizes of a channel
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Get the widest access usable for a transfer.
+  * @param  SrcAddress: Source address.
+  * @param  DstAddress: Destination address.
+  * @param  Size: Number of bytes.
+  * @retval Access width in bytes: 4, 2 or 1
+  */
+uint32_t HAL_DMAEx_GetBestWidth(uint32_t SrcAddress, uint32_t DstAddress, uint32_t Size)
+{
+  uint32_t bits = SrcAddress | DstAddress | Size;
+
+  if((bits & 3U) == 0U)
+  {
+    return 4U;
+  }
+  if((bits & 1U) == 0U)
+  {
+    return 2U;
+  }
+  return 1U;
+}
+
+/**
+  * @brief  Check a memory buffer against the data sizes of a channel.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, initialized.
+  * @param  MemAddress: Buffer address.
+  * @param  Size: Buffer size in bytes.
+  * @retval HAL_OK if the buffer is aligned, a whole number of data items and at
+  *         most 65535 data items long, HAL_ERROR otherwise
+  */
+HAL_StatusTypeDef HAL_DMAEx_CheckBuffer(DMA_HandleTypeDef *hdma, uint32_t MemAddress, uint32_t Size)
+{
+  uint32_t shift;
+
+  if((hdma == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  shift = hdma->Init.MemDataAlignment >> DMA_CCR_MSIZE_Pos;
+  if((__HAL_DMA_IS_ALIGNED(MemAddress, shift) == 0U) || (__HAL_DMA_IS_ALIGNED(Size, shift) == 0U) ||
+     ((Size >> shift) > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Switch the peripheral and memory data sizes of an idle channel.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, initialized.
+  * @param  Width: Access width in bytes: 1, 2 or 4.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_ConfigDataWidth(DMA_HandleTypeDef *hdma, uint32_t Width)
+{
+  uint32_t size;
+
+  /* Check the parameters */
+  assert_param(IS_DMA_WIDTH(Width));
+
+  if(hdma == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(hdma);
+
+  if(hdma->State != HAL_DMA_STATE_READY)
+  {
+    __HAL_UNLOCK(hdma);
+    return HAL_BUSY;
+  }
+
+  size = (Width == 4U) ? 2U : ((Width == 2U) ? 1U : 0U);
+  hdma->Init.PeriphDataAlignment = size << DMA_CCR_PSIZE_Pos;
+  hdma->Init.MemDataAlignment    = size << DMA_CCR_MSIZE_Pos;
+  MODIFY_REG(hdma->Instance->CCR, (DMA_CCR_PSIZE | DMA_CCR_MSIZE),
+             (hdma->Init.PeriphDataAlignment | hdma->Init.MemDataAlignment));
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hdma);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group6 Ring buffer functions
+  *  @brief   Ring buffer functions
+  *
+@verbatim
+ ===============================================================================
+                      #####  Ring buffer functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Initialize a receive ring buffer
+      (+) Attach the ring to the circular DMA channel filling it
+      (+) Read the received data in place
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a DMA receive ring buffer.
+  * @param  pRing: Ring buffer.
+  * @param  pBuffer: Ring storage, aligned on the DMA memory data size.
+  * @param  Size: Ring size in bytes.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_RingInit(DMA_RingTypeDef *pRing, uint8_t *pBuffer, uint32_t Size)
+{
+  if((pRing == NULL) || (pBuffer == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  pRing->pBuffer = pBuffer;
+  pRing->Size = Size;
+  pRing->Items = 0U;
+  pRing->Tail = 0U;
+  pRing->Acquired = 0U;
+  pRing->hdma = NULL;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Attach a ring buffer to the DMA channel which fills it.
+  * @note   The channel must be initialized in DMA_CIRCULAR mode and is started
+  *         by the caller, on the ring storage, for pRing->Items data items.
+  *         The ring is emptied.
+  * @param  pRing: Ring buffer, initialized.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, initialized.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_RingAttach(DMA_RingTypeDef *pRing, DMA_HandleTypeDef *hdma)
+{
+  uint32_t shift;
+
+  if((pRing == NULL) || (hdma == NULL) || (pRing->pBuffer == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if((hdma->Init.Mode != DMA_CIRCULAR) || (hdma->Init.Direction == DMA_MEMORY_TO_MEMORY))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The ring must hold a whole number of data items, at most 65535 */
+  shift = hdma->Init.MemDataAlignment >> DMA_CCR_MSIZE_Pos;
+  if(((pRing->Size & ((1UL << shift) - 1U)) != 0U) ||
+     (((uint32_t)pRing->pBuffer & ((1UL << shift) - 1U)) != 0U) ||
+     ((pRing->Size >> shift) > 0xFFFFU))
+  {
+    return HAL_ERROR;
+  }
+
+  pRing->Items = pRing->Size >> shift;
+  pRing->Tail = 0U;
+  pRing->Acquired = 0U;
+  pRing->hdma = hdma;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Get the number of received bytes waiting in the ring.
+  * @param  pRing: Ring buffer, attached.
+  * @retval Number of bytes
+  */
+uint32_t HAL_DMAEx_RingGetCount(const DMA_RingTypeDef *pRing)
+{
+  uint32_t head;
+
+  head = DMA_RingGetHead(pRing);
+
+  if(head >= pRing->Tail)
+  {
+    return head - pRing->Tail;
+  }
+  return (pRing->Size - pRing->Tail) + head;
+}
+
+/**
+  * @brief  Get the largest contiguous block of received bytes.
+  * @note   The block stays valid until HAL_DMAEx_RingCommit() is called, as
+  *         long as the ring is drained faster than the channel fills it.
+  * @param  pRing: Ring buffer, attached.
+  * @param  ppData: Start of the block.
+  * @retval Number of bytes of the block, 0 when the ring is empty
+  */
+uint32_t HAL_DMAEx_RingAcquire(DMA_RingTypeDef *pRing, uint8_t **ppData)
+{
+  uint32_t head;
+  uint32_t length;
+
+  head = DMA_RingGetHead(pRing);
+
+  /* Stop at the end of the storage when the data wraps around */
+  length = (head >= pRing->Tail) ? (head - pRing->Tail) : (pRing->Size - pRing->Tail);
+
+  *ppData = &pRing->pBuffer[pRing->Tail];
+  pRing->Acquired = length;
+
+  return length;
+}
+
+/**
+  * @brief  Release bytes of the block returned by HAL_DMAEx_RingAcquire().
+  * @param  pRing: Ring buffer, attached.
+  * @param  Length: Number of bytes consumed, clipped to the acquired block.
+  * @retval None
+  */
+void HAL_DMAEx_RingCommit(DMA_RingTypeDef *pRing, uint32_t Length)
+{
+  uint32_t tail;
+
+  if(Length > pRing->Acquired)
+  {
+    Length = pRing->Acquired;
+  }
+
+  tail = pRing->Tail + Length;
+  if(tail >= pRing->Size)
+  {
+    tail = 0U;
+  }
+
+  pRing->Acquired -= Length;
+  pRing->Tail = tail;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup DMAEx_Exported_Functions_Group7 Interrupt coalescing functions
+  *  @brief   Interrupt coalescing functions
+  *
+@verbatim
+ ===============================================================================
+                 #####  Interrupt coalescing functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Initialize an interrupt coalescing group
+      (+) Add or remove channels of the group
+      (+) Report the completed transfers of the group on a timeout
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a DMA interrupt coalescing group.
+  * @param  hco: Coalescing group.
+  * @param  Threshold: Transfers started in the group between two transfer
+  *         complete interrupts, 1 disables the coalescing.
+  * @param  pCallback: Called after the completions of a flush were reported,
+  *         may be NULL.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_CoalesceInit(DMA_CoalesceTypeDef *hco, uint32_t Threshold,
+                                         void (* pCallback)(DMA_CoalesceTypeDef *hco, uint32_t Completed))
+{
+  uint32_t i;
+
+  if((hco == NULL) || (Threshold == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  for(i = 0U; i < DMA_COALESCE_MAX_CHANNELS; i++)
+  {
+    hco->hdma[i] = NULL;
+  }
+  hco->Count = 0U;
+  hco->Threshold = Threshold;
+  hco->Started = 0U;
+  hco->XferBatchCallback = pCallback;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Add a DMA channel to an interrupt coalescing group.
+  * @param  hco: Coalescing group, initialized.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, initialized and idle.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_CoalesceAdd(DMA_CoalesceTypeDef *hco, DMA_HandleTypeDef *hdma)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t critical;
+  uint32_t i;
+
+  if((hco == NULL) || (hdma == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if(hdma->State != HAL_DMA_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  critical = HAL_EnterCritical();
+
+  /* Already a member when added again after HAL_DMA_Init() */
+  for(i = 0U; i < hco->Count; i++)
+  {
+    if(hco->hdma[i] == hdma)
+    {
+      break;
+    }
+  }
+
+  if(i < hco->Count)
+  {
+    hdma->pCoalesce = hco;
+  }
+  else if(hco->Count < DMA_COALESCE_MAX_CHANNELS)
+  {
+    hco->hdma[hco->Count] = hdma;
+    hco->Count++;
+    hdma->pCoalesce = hco;
+  }
+  else
+  {
+    status = HAL_ERROR;
+  }
+
+  HAL_ExitCritical(critical);
+
+  return status;
+}
+
+/**
+  * @brief  Remove a DMA channel from its interrupt coalescing group.
+  * @param  hco: Coalescing group.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, idle.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_CoalesceRemove(DMA_CoalesceTypeDef *hco, DMA_HandleTypeDef *hdma)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+  uint32_t critical;
+  uint32_t i;
+
+  if((hco == NULL) || (hdma == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if(hdma->State == HAL_DMA_STATE_BUSY)
+  {
+    return HAL_BUSY;
+  }
+
+  critical = HAL_EnterCritical();
+
+  for(i = 0U; i < hco->Count; i++)
+  {
+    if(hco->hdma[i] == hdma)
+    {
+      /* Keep the member table packed */
+      hco->Count--;
+      hco->hdma[i] = hco->hdma[hco->Count];
+      hco->hdma[hco->Count] = NULL;
+      if(hdma->pCoalesce == hco)
+      {
+        hdma->pCoalesce = NULL;
+      }
+      status = HAL_OK;
+      break;
+    }
+  }
+
+  HAL_ExitCritical(critical);
+
+  return status;
+}
+
+/**
+  * @brief  Report the completed transfers of an interrupt coalescing group.
+  * @note   To be called periodically, for instance from
+  *         HAL_TIM_PeriodElapsedCallback() of a basic timer.
+  * @param  hco: Coalescing group.
+  * @retval None
+  */
+void HAL_DMAEx_CoalesceTimeout(DMA_CoalesceTypeDef *hco)
+{
+  /* Also restart the interrupt period, the flush is the timer one */
+  hco->Started = 0U;
+
+  (void)DMA_CoalesceFlush(hco, 0U);
+}
+
+/**
+  * @}
+  */
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+/** @defgroup DMAEx_Exported_Functions_Group5 Statistics functions
+  *  @brief   Statistics functions
+  *
+@verbatim
+ ===============================================================================
+                      #####  Statistics functions  #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Read the transfer statistics of a channel
+      (+) Clear the statistics of all channels
+      (+) Print the statistics of all active channels
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Read the statistics of the channel used by a handle.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, initialized.
+  * @param  pStats: Statistics copy.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DMAEx_GetStats(DMA_HandleTypeDef *hdma, DMA_StatsTypeDef *pStats)
+{
+  uint32_t critical;
+
+  if((hdma == NULL) || (pStats == NULL) || (hdma->DmaBaseAddress == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Counters are updated from interrupts, take a consistent copy */
+  critical = HAL_EnterCritical();
+  *pStats = DMA_Stats[DMA_StatsIndex(hdma)].Stats;
+  HAL_ExitCritical(critical);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Clear the statistics of all channels.
+  * @retval None
+  */
+void HAL_DMAEx_ResetStats(void)
+{
+  uint32_t critical;
+  uint32_t i;
+  uint32_t j;
+
+  critical = HAL_EnterCritical();
+  for(i = 0U; i < DMA_CHANNEL_NUMBER; i++)
+  {
+    DMA_Stats[i].Stats.Transfers   = 0U;
+    DMA_Stats[i].Stats.Errors      = 0U;
+    DMA_Stats[i].Stats.Bytes       = 0U;
+    DMA_Stats[i].Stats.MinCycles   = 0U;
+    DMA_Stats[i].Stats.MaxCycles   = 0U;
+    DMA_Stats[i].Stats.TotalCycles = 0U;
+    DMA_Stats[i].Stats.MaxLag      = 0U;
+    for(j = 0U; j < DMA_STATS_HISTOGRAM_SIZE; j++)
+    {
+      DMA_Stats[i].Stats.Histogram[j] = 0U;
+    }
+  }
+  HAL_ExitCritical(critical);
+}
+
+/**
+  * @brief  Print the statistics of the channels which have been used.
+  * @note   Output goes through printf(), byte counts are printed in KiB.
+  * @retval None
+  */
+void HAL_DMAEx_DumpStats(void)
+{
+  DMA_StatsTypeDef stats;
+  uint32_t critical;
+  uint32_t avg;
+  uint32_t i;
+  uint32_t j;
+
+  printf("DMA ch   xfers   errors        KiB   min/avg/max cycles   lag\r\n");
+  for(i = 0U; i < DMA_CHANNEL_NUMBER; i++)
+  {
+    critical = HAL_EnterCritical();
+    stats = DMA_Stats[i].Stats;
+    HAL_ExitCritical(critical);
+
+    if((stats.Transfers == 0U) && (stats.Errors == 0U))
+    {
+      continue;
+    }
+
+    avg = (stats.Transfers != 0U) ? (uint32_t)(stats.TotalCycles / stats.Transfers) : 0U;
+    printf("DMA%lu %lu %8lu %8lu %10lu   %lu/%lu/%lu   %lu\r\n",
+           (i < 7U) ? 1UL : 2UL, (unsigned long)((i < 7U) ? (i + 1U) : (i - 6U)),
+           (unsigned long)stats.Transfers, (unsigned long)stats.Errors,
+           (unsigned long)(stats.Bytes >> 10),
+           (unsigned long)stats.MinCycles, (unsigned long)avg, (unsigned long)stats.MaxCycles,
+           (unsigned long)stats.MaxLag);
+
+    printf("  histogram:");
+    for(j = 0U; j < DMA_STATS_HISTOGRAM_SIZE; j++)
+    {
+      printf(" %lu", (unsigned long)stats.Histogram[j]);
+    }
+    printf("\r\n");
+  }
+}
+
+/**
+  * @}
+  */
+#endif /* USE_HAL_DMA_STATISTICS */
+
+/**
+  * @}
+  */
+
+/** @addtogroup DMAEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Insert a request in the engine queue, start it if the engine is idle.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  pReq: Request to queue.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef DMA_MemSubmit(DMA_MemEngineTypeDef *hmem, DMA_MemRequestTypeDef *pReq)
+{
+  DMA_MemRequestTypeDef **ppos;
+  uint32_t critical;
+  uint32_t idle;
+
+  if(!IS_DMA_PRIORITY(pReq->Priority))
+  {
+    return HAL_ERROR;
+  }
+
+  pReq->Offset = 0U;
+  pReq->State = DMA_MEM_REQ_QUEUED;
+
+  /* Enter critical section */
+  critical = HAL_EnterCritical();
+
+  /* After the requests of the same or a higher priority */
+  ppos = &hmem->pHead;
+  while((*ppos != NULL) && ((*ppos)->Priority >= pReq->Priority))
+  {
+    ppos = &(*ppos)->pNext;
+  }
+  pReq->pNext = *ppos;
+  *ppos = pReq;
+
+  idle = (hmem->pActive == NULL) ? 1U : 0U;
+  if(idle != 0U)
+  {
+    hmem->pActive = hmem->pHead;
+  }
+
+  /* Exit critical section: restore previous priority mask */
+  HAL_ExitCritical(critical);
+
+  if(idle != 0U)
+  {
+    if(DMA_MemStartBlock(hmem) != HAL_OK)
+    {
+      DMA_MemRequestDone(hmem, DMA_MEM_REQ_ERROR);
+      return HAL_ERROR;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start the next DMA block of the active request.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef DMA_MemStartBlock(DMA_MemEngineTypeDef *hmem)
+{
+  DMA_HandleTypeDef *hdma = hmem->hdma;
+  DMA_MemRequestTypeDef *preq = hmem->pActive;
+  uint32_t remaining = preq->Size - preq->Offset;
+  uint32_t dst = preq->DstAddress + preq->Offset;
+  uint32_t src;
+  uint32_t misalign;
+  uint32_t width;
+  uint32_t count;
+  uint32_t head;
+  uint32_t ccr;
+
+  if(preq->IsMemSet != 0U)
+  {
+    /* Fixed source: the 4 bytes of the pattern are equal */
+    src = preq->SrcAddress;
+    misalign = 0U;
+    ccr = 0U;
+  }
+  else
+  {
+    src = preq->SrcAddress + preq->Offset;
+    misalign = (src ^ dst) & 3U;
+    ccr = DMA_CCR_PINC;
+  }
+
+  /* Widest access allowed by both addresses and the remaining size */
+  if(((dst & 3U) == 0U) && (misalign == 0U) && (remaining >= 4U))
+  {
+    width = 4U;
+    ccr |= DMA_PDATAALIGN_WORD | DMA_MDATAALIGN_WORD;
+  }
+  else if(((dst & 1U) == 0U) && ((misalign & 1U) == 0U) && (remaining >= 2U))
+  {
+    width = 2U;
+    ccr |= DMA_PDATAALIGN_HALFWORD | DMA_MDATAALIGN_HALFWORD;
+  }
+  else
+  {
+    width = 1U;
+  }
+
+  count = remaining / width;
+  if((misalign == 0U) && ((dst & 3U) != 0U))
+  {
+    /* Same misalignment on both sides: stop at the next word boundary */
+    head = (4U - (dst & 3U)) / width;
+    if(head < count)
+    {
+      count = head;
+    }
+  }
+  if(count > 0xFFFFU)
+  {
+    count = 0xFFFFU;
+  }
+
+  /* Bounded blocks below the highest priority, the queue is checked between them */
+  if((hmem->ChunkSize != 0U) && (preq->Priority != DMA_PRIORITY_VERY_HIGH) &&
+     (count > (hmem->ChunkSize / width)))
+  {
+    count = (hmem->ChunkSize < width) ? 1U : (hmem->ChunkSize / width);
+  }
+  hmem->BlockSize = count * width;
+
+  /* Data sizes, source increment and priority can only be changed while disabled */
+  __HAL_DMA_DISABLE(hdma);
+  MODIFY_REG(hdma->Instance->CCR, (DMA_CCR_PINC | DMA_CCR_PSIZE | DMA_CCR_MSIZE | DMA_CCR_PL),
+             (ccr | preq->Priority));
+
+  return HAL_DMA_Start_IT(hdma, src, dst, count);
+}
+
+/**
+  * @brief  Memory engine DMA transfer complete callback.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void DMA_MemXferCplt(DMA_HandleTypeDef *hdma)
+{
+  DMA_MemEngineTypeDef *hmem = (DMA_MemEngineTypeDef *)hdma->Parent;
+  DMA_MemRequestTypeDef *preq = hmem->pActive;
+  uint32_t critical;
+
+  preq->Offset += hmem->BlockSize;
+
+  if(preq->Offset < preq->Size)
+  {
+    /* Next block of the highest priority request, which may preempt this one */
+    critical = HAL_EnterCritical();
+    hmem->pActive = hmem->pHead;
+    HAL_ExitCritical(critical);
+
+    if(DMA_MemStartBlock(hmem) == HAL_OK)
+    {
+      return;
+    }
+    DMA_MemRequestDone(hmem, DMA_MEM_REQ_ERROR);
+  }
+  else
+  {
+    DMA_MemRequestDone(hmem, DMA_MEM_REQ_DONE);
+  }
+}
+
+/**
+  * @brief  Memory engine DMA transfer error callback.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+static void DMA_MemXferError(DMA_HandleTypeDef *hdma)
+{
+  DMA_MemRequestDone((DMA_MemEngineTypeDef *)hdma->Parent, DMA_MEM_REQ_ERROR);
+}
+
+/**
+  * @brief  Retire the active request and start the following ones.
+  * @param  hmem: pointer to a DMA_MemEngineTypeDef structure.
+  * @param  State: Final state of the active request.
+  * @retval None
+  */
+static void DMA_MemRequestDone(DMA_MemEngineTypeDef *hmem, uint32_t State)
+{
+  DMA_MemRequestTypeDef **ppos;
+  DMA_MemRequestTypeDef *pdone;
+  DMA_MemRequestTypeDef *pfail = NULL;
+  DMA_MemRequestTypeDef *pnext;
+  uint32_t critical;
+
+  /* Enter critical section */
+  critical = HAL_EnterCritical();
+
+  /* Unlink the active request, a preempting request may be queued before it */
+  pdone = hmem->pActive;
+  ppos = &hmem->pHead;
+  while((*ppos != NULL) && (*ppos != pdone))
+  {
+    ppos = &(*ppos)->pNext;
+  }
+  if(*ppos != NULL)
+  {
+    *ppos = pdone->pNext;
+  }
+  hmem->pActive = hmem->pHead;
+
+  /* Exit critical section: restore previous priority mask */
+  HAL_ExitCritical(critical);
+
+  /* Keep the channel busy with the next request before notifying */
+  if((hmem->pActive != NULL) && (DMA_MemStartBlock(hmem) != HAL_OK))
+  {
+    /* Channel not usable: fail the whole queue */
+    critical = HAL_EnterCritical();
+    pfail = hmem->pHead;
+    hmem->pHead = NULL;
+    hmem->pActive = NULL;
+    HAL_ExitCritical(critical);
+  }
+
+  pdone->State = State;
+  if(pdone->XferCpltCallback != NULL)
+  {
+    pdone->XferCpltCallback(pdone);
+  }
+
+  while(pfail != NULL)
+  {
+    pnext = pfail->pNext;
+    pfail->State = DMA_MEM_REQ_ERROR;
+    if(pfail->XferCpltCallback != NULL)
+    {
+      pfail->XferCpltCallback(pfail);
+    }
+    pfail = pnext;
+  }
+}
+
+/**
+  * @brief  Get the pool index of a DMA channel.
+  * @param  Instance: DMA channel.
+  * @retval Index in DMA_ChannelPool, -1 if the channel is unknown.
+  */
+static int32_t DMA_ChannelPoolIndex(const DMA_Channel_TypeDef *Instance)
+{
+  int32_t i;
+
+  for(i = 0; i < (int32_t)DMA_CHANNEL_NUMBER; i++)
+  {
+    if(DMA_ChannelPool[i].Instance == Instance)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  * @brief  Load the next fragment of a descriptor chain.
+  * @note   Called by HAL_DMA_IRQHandler() on transfer complete, the transfer
+  *         complete flag must already be cleared.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @retval 1 if a fragment has been started, 0 if the chain is finished.
+  */
+uint32_t DMA_ChainLoadNext(DMA_HandleTypeDef *hdma)
+{
+  DMA_ChainDescTypeDef *pprev = hdma->pChainDesc;
+  DMA_ChainDescTypeDef *pdesc = pprev->pNext;
+  uint32_t ccr;
+
+  if(pdesc == NULL)
+  {
+    /* Last fragment done */
+    hdma->pChainDesc = NULL;
+    return 0U;
+  }
+
+  assert_param(IS_DMA_BUFFER_SIZE(pdesc->DataLength));
+  assert_param(IS_DMA_CHAIN_FLAGS(pdesc->Flags));
+
+  /* CNDTR, CMAR and CPAR can only be written while the channel is disabled */
+  ccr = DMA_ChainGetCCR(hdma, pdesc);
+  hdma->Instance->CCR = ccr & ~DMA_CCR_EN;
+
+  hdma->Instance->CNDTR = pdesc->DataLength;
+
+  /* Address registers keep their value, only rewrite the ones which change */
+  if((hdma->Init.Direction) == DMA_MEMORY_TO_PERIPH)
+  {
+    if(pdesc->DstAddress != pprev->DstAddress)
+    {
+      hdma->Instance->CPAR = pdesc->DstAddress;
+    }
+    if(pdesc->SrcAddress != pprev->SrcAddress)
+    {
+      hdma->Instance->CMAR = pdesc->SrcAddress;
+    }
+  }
+  else
+  {
+    if(pdesc->SrcAddress != pprev->SrcAddress)
+    {
+      hdma->Instance->CPAR = pdesc->SrcAddress;
+    }
+    if(pdesc->DstAddress != pprev->DstAddress)
+    {
+      hdma->Instance->CMAR = pdesc->DstAddress;
+    }
+  }
+
+  hdma->pChainDesc = pdesc;
+
+  /* Restart the channel */
+  hdma->Instance->CCR = ccr | DMA_CCR_EN;
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+  DMA_StatsStart(hdma, pdesc->DataLength);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+  return 1U;
+}
+
+/**
+  * @brief  Switch a double buffer stream to its other buffer.
+  * @note   Called by HAL_DMA_IRQHandler() on transfer complete, the transfer
+  *         complete flag must already be cleared.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @retval None
+  */
+void DMA_MultiBufferSwap(DMA_HandleTypeDef *hdma)
+{
+  uint32_t done = hdma->DoubleBuffer.Target;
+  uint32_t next = done ^ 1U;
+  uint32_t ccr;
+
+  /* Hand the finished buffer over to the application */
+  hdma->DoubleBuffer.Full[done] = 1U;
+
+  if(hdma->DoubleBuffer.Full[next] == 0U)
+  {
+    /* Restart on the other buffer before notifying, to keep the gap short */
+    ccr = hdma->Instance->CCR;
+    hdma->Instance->CCR = ccr & ~DMA_CCR_EN;
+    hdma->Instance->CNDTR = hdma->DoubleBuffer.Length[next];
+    hdma->Instance->CMAR = hdma->DoubleBuffer.Address[next];
+    hdma->DoubleBuffer.Target = (uint8_t)next;
+    hdma->Instance->CCR = ccr | DMA_CCR_EN;
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+    DMA_StatsStart(hdma, hdma->DoubleBuffer.Length[next]);
+#endif /* USE_HAL_DMA_STATISTICS */
+  }
+  else
+  {
+    /* Consumer too slow: stop instead of overwriting a buffer in use */
+    __HAL_DMA_DISABLE_IT(hdma, (DMA_IT_TC | DMA_IT_HT | DMA_IT_TE));
+    __HAL_DMA_DISABLE(hdma);
+
+    hdma->DoubleBuffer.Active = 0U;
+    hdma->ErrorCode |= HAL_DMA_ERROR_OVERRUN;
+
+    /* Change the DMA state */
+    hdma->State = HAL_DMA_STATE_READY;
+
+    /* Process Unlocked */
+    __HAL_UNLOCK(hdma);
+  }
+
+  if(done == (uint32_t)MEMORY0)
+  {
+    if(hdma->XferCpltCallback != NULL)
+    {
+      /* Memory 0 transfer complete callback */
+      hdma->XferCpltCallback(hdma);
+    }
+  }
+  else
+  {
+    if(hdma->XferM1CpltCallback != NULL)
+    {
+      /* Memory 1 transfer complete callback */
+      hdma->XferM1CpltCallback(hdma);
+    }
+  }
+
+  if(((hdma->ErrorCode & HAL_DMA_ERROR_OVERRUN) != 0U) && (hdma->XferErrorCallback != NULL))
+  {
+    /* Transfer error callback */
+    hdma->XferErrorCallback(hdma);
+  }
+}
+
+/**
+  * @brief  Select whether a transfer of a coalescing group raises its
+  *         transfer complete interrupt.
+  * @note   Called by HAL_DMA_Start_IT() before the channel is enabled.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure, member of a group.
+  * @retval None
+  */
+void DMA_CoalesceStart(DMA_HandleTypeDef *hdma)
+{
+  DMA_CoalesceTypeDef *hco = hdma->pCoalesce;
+  uint32_t critical;
+  uint32_t started;
+
+  critical = HAL_EnterCritical();
+  started = hco->Started + 1U;
+  if(started >= hco->Threshold)
+  {
+    started = 0U;
+  }
+  hco->Started = started;
+  HAL_ExitCritical(critical);
+
+  if(started != 0U)
+  {
+    /* Completion reported by the next flush of the group */
+    __HAL_DMA_DISABLE_IT(hdma, DMA_IT_TC);
+  }
+}
+
+/**
+  * @brief  Report the completed transfers of a coalescing group whose transfer
+  *         complete interrupt is disabled.
+  * @param  hco: Coalescing group.
+  * @param  Completed: Completions already reported by the caller, added to the
+  *         count given to XferBatchCallback.
+  * @retval Number of completions reported by the flush
+  */
+uint32_t DMA_CoalesceFlush(DMA_CoalesceTypeDef *hco, uint32_t Completed)
+{
+  DMA_HandleTypeDef *hdma;
+  uint32_t critical;
+  uint32_t flushed = 0U;
+  uint32_t done;
+  uint32_t i;
+
+  for(i = 0U; i < hco->Count; i++)
+  {
+    hdma = hco->hdma[i];
+    done = 0U;
+
+    /* Claim the completion, a flush may run at another interrupt priority */
+    critical = HAL_EnterCritical();
+    if((hdma != NULL) && (hdma->pCoalesce == hco) && (hdma->State == HAL_DMA_STATE_BUSY) &&
+       ((hdma->Instance->CCR & DMA_IT_TC) == 0U) &&
+       ((hdma->DmaBaseAddress->ISR & (DMA_FLAG_TC1 << hdma->ChannelIndex)) != 0U))
+    {
+      hdma->DmaBaseAddress->IFCR = (DMA_FLAG_TC1 << hdma->ChannelIndex);
+
+      if((hdma->Instance->CCR & DMA_CCR_CIRC) == 0U)
+      {
+        /* Disable the transfer error interrupt */
+        __HAL_DMA_DISABLE_IT(hdma, DMA_IT_TE);
+
+        /* Change the DMA state */
+        hdma->State = HAL_DMA_STATE_READY;
+      }
+      done = 1U;
+    }
+    HAL_ExitCritical(critical);
+
+    if(done != 0U)
+    {
+#if (USE_HAL_DMA_STATISTICS == 1U)
+      DMA_StatsComplete(hdma);
+#endif /* USE_HAL_DMA_STATISTICS */
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(hdma);
+
+      if(hdma->XferCpltCallback != NULL)
+      {
+        hdma->XferCpltCallback(hdma);
+      }
+      flushed++;
+    }
+  }
+
+  if(((flushed + Completed) != 0U) && (hco->XferBatchCallback != NULL))
+  {
+    hco->XferBatchCallback(hco, flushed + Completed);
+  }
+
+  return flushed;
+}
+
+/**
+  * @brief  Get the write offset of the DMA in a ring buffer.
+  * @param  pRing: Ring buffer, attached.
+  * @retval Offset in bytes
+  */
+static uint32_t DMA_RingGetHead(const DMA_RingTypeDef *pRing)
+{
+  uint32_t remaining = pRing->hdma->Instance->CNDTR;
+  uint32_t head;
+
+  /* The counter reads 0 for a moment at the reload, or before the start */
+  if((remaining == 0U) || (remaining > pRing->Items))
+  {
+    remaining = pRing->Items;
+  }
+
+  head = (pRing->Items - remaining) << (pRing->hdma->Init.MemDataAlignment >> DMA_CCR_MSIZE_Pos);
+
+  return head;
+}
+
+#if (USE_HAL_DMA_STATISTICS == 1U)
+/**
+  * @brief  Record the start of a DMA block.
+  * @note   Called by the driver once the channel registers are programmed.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @param  DataLength: Number of data items of the block.
+  * @retval None
+  */
+void DMA_StatsStart(DMA_HandleTypeDef *hdma, uint32_t DataLength)
+{
+  DMA_ChannelStatsTypeDef *pstats = &DMA_Stats[DMA_StatsIndex(hdma)];
+
+  /* Start the cycle counter if nobody did */
+  HAL_EnableCycleCounter();
+
+  pstats->Length = DataLength;
+  pstats->Bytes = DataLength << ((hdma->Instance->CCR & DMA_CCR_MSIZE) >> DMA_CCR_MSIZE_Pos);
+  pstats->StartCycle = DWT->CYCCNT;
+}
+
+/**
+  * @brief  Record the completion of a DMA block.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+void DMA_StatsComplete(DMA_HandleTypeDef *hdma)
+{
+  DMA_ChannelStatsTypeDef *pstats = &DMA_Stats[DMA_StatsIndex(hdma)];
+  uint32_t now = DWT->CYCCNT;
+  uint32_t cycles = now - pstats->StartCycle;
+  uint32_t bin;
+  uint32_t lag;
+
+  if((pstats->Stats.Transfers == 0U) || (cycles < pstats->Stats.MinCycles))
+  {
+    pstats->Stats.MinCycles = cycles;
+  }
+  if(cycles > pstats->Stats.MaxCycles)
+  {
+    pstats->Stats.MaxCycles = cycles;
+  }
+  pstats->Stats.TotalCycles += cycles;
+  pstats->Stats.Bytes += pstats->Bytes;
+  pstats->Stats.Transfers++;
+
+  /* Bin 0 below 2^8 cycles, then one bin per power of two */
+  bin = 31U - (uint32_t)__CLZ(cycles | 1U);
+  bin = (bin < 8U) ? 0U : (bin - 7U);
+  if(bin >= DMA_STATS_HISTOGRAM_SIZE)
+  {
+    bin = DMA_STATS_HISTOGRAM_SIZE - 1U;
+  }
+  pstats->Stats.Histogram[bin]++;
+
+  if((hdma->Instance->CCR & DMA_CCR_CIRC) != 0U)
+  {
+    /* The channel already restarted: measure how far it went */
+    lag = pstats->Length - hdma->Instance->CNDTR;
+    if(lag > pstats->Stats.MaxLag)
+    {
+      pstats->Stats.MaxLag = lag;
+    }
+    pstats->StartCycle = now;
+  }
+}
+
+/**
+  * @brief  Record a DMA transfer error.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval None
+  */
+void DMA_StatsError(DMA_HandleTypeDef *hdma)
+{
+  DMA_Stats[DMA_StatsIndex(hdma)].Stats.Errors++;
+}
+
+/**
+  * @brief  Get the statistics index of the channel used by a handle.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure.
+  * @retval Index in DMA_Stats
+  */
+static uint32_t DMA_StatsIndex(const DMA_HandleTypeDef *hdma)
+{
+#if defined (DMA2)
+  if(hdma->DmaBaseAddress == DMA2)
+  {
+    return 7U + (hdma->ChannelIndex >> 2);
+  }
+#endif /* DMA2 */
+  return hdma->ChannelIndex >> 2;
+}
+#endif /* USE_HAL_DMA_STATISTICS */
+
+/**
+  * @brief  Compute the channel control register value for a chain fragment.
+  * @param  hdma: pointer to a DMA_HandleTypeDef structure that contains
+  *               the configuration information for the specified DMA Channel.
+  * @param  pDesc: Chain fragment.
+  * @retval CCR value, the enable bit is left as it is in the register.
+  */
+static uint32_t DMA_ChainGetCCR(DMA_HandleTypeDef *hdma, const DMA_ChainDescTypeDef *pDesc)
+{
+  uint32_t ccr = hdma->Instance->CCR & ~(DMA_CCR_MINC | DMA_CCR_PINC);
+  uint32_t srcinc;
+  uint32_t dstinc;
+
+  if((hdma->Init.Direction) == DMA_MEMORY_TO_PERIPH)
+  {
+    srcinc = hdma->Init.MemInc;
+    dstinc = hdma->Init.PeriphInc;
+  }
+  else
+  {
+    srcinc = hdma->Init.PeriphInc;
+    dstinc = hdma->Init.MemInc;
+  }
+
+  if((pDesc->Flags & DMA_CHAIN_FLAG_SRC_FIXED) != 0U)
+  {
+    srcinc = 0U;
+  }
+  if((pDesc->Flags & DMA_CHAIN_FLAG_DST_FIXED) != 0U)
+  {
+    dstinc = 0U;
+  }
+
+  return ccr | srcinc | dstinc;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_DMA_MODULE_ENABLED */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE******************/
@@ -1842,6 +1842,13 @@ static void ESMC_DMARxCplt(DMA_HandleTypeDef *hdma)
 
   /* Restore default values */
   hesmc->Contex = ESMC_CONTEXT_NONE;
+
+  /* RX Complete callback */
+#if (USE_HAL_ESMC_REGISTER_CALLBACKS == 1)
+  hesmc->RxCpltCallback(hesmc);
+#else
+  HAL_ESMC_RxCpltCallback(hesmc);
+#endif
 }
 
 /**
@@ -1916,6 +1923,12 @@ static void ESMC_DMAError(DMA_HandleTypeDef *hdma)
   /* Abort the ESMC */
   HAL_ESMC_Abort_IT(hesmc);
 
+  /* DMAEN being cleared, the abort does not report the error */
+#if (USE_HAL_ESMC_REGISTER_CALLBACKS == 1)
+  hesmc->ErrorCallback(hesmc);
+#else
+  HAL_ESMC_ErrorCallback(hesmc);
+#endif
 }
 
 /**
@@ -1975,6 +1988,8 @@ static HAL_StatusTypeDef ESMC_WaitFlagStateUntilTimeout(ESMC_HandleTypeDef *hesm
         return HAL_ERROR;
       }
     }
+
+    __HAL_WAIT(tickstart);
   }
   return HAL_OK;
 }
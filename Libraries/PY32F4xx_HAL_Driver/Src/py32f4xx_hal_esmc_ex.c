@@ -0,0 +1,575 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_esmc_ex.c
+  * @author  MCU Application Team
+  * @brief   Extended ESMC HAL module driver.
+  *          This file provides firmware functions to manage the following
+  *          ESMC peripheral extended functionalities :
+  *           + Execute-in-place functions
+  *           + Dual flash functions
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @defgroup ESMCEx ESMCEx
+  * @brief ESMC Extended HAL module driver
+  * @{
+  */
+#ifdef HAL_ESMC_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup ESMCEx_Private_Types ESMCEx Private Types
+  * @{
+  */
+
+/**
+  * @brief  Fast read command of a preset
+  */
+typedef struct
+{
+  uint8_t  Instruction;      /* Command with a 24-bit address     */
+  uint8_t  Instruction4B;    /* Command with a 32-bit address     */
+  uint8_t  AlternateByte;    /* Mode byte sent after the address  */
+  uint8_t  DummyCycles;      /* Dummy cycles before the data      */
+  uint32_t TransferFormat;   /* Lines of the data phase           */
+  uint32_t AddressMode;      /* Lines of the address phase        */
+  uint32_t AlternateByteMode; /* Mode byte sent or not            */
+} ESMCEx_ReadCommandTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private defines -----------------------------------------------------------*/
+/** @defgroup ESMCEx_Private_Constants ESMCEx Private Constants
+  * @{
+  */
+/* Mode byte keeping the flash out of the continuous read mode */
+#define ESMCEX_MODE_BYTE          0xFFU
+
+/* Serial NOR flash commands of the dual flash functions */
+#define ESMCEX_CMD_WRITE_ENABLE   0x06U     /* Write enable                    */
+#define ESMCEX_CMD_READ_STATUS    0x05U     /* Read status register 1          */
+#define ESMCEX_CMD_QUAD_PROGRAM   0x32U     /* Quad input page program, 1-1-4  */
+#define ESMCEX_CMD_SECTOR_ERASE   0x20U     /* 4-Kbyte sector erase            */
+#define ESMCEX_STATUS_WIP         0x01U     /* Write in progress bit           */
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup ESMCEx_Private_Variables ESMCEx Private Variables
+  * @{
+  */
+static const ESMCEx_ReadCommandTypeDef ESMCEx_ReadCommands[ESMCEX_XIP_OCTAL_IO + 1U] =
+{
+  {0x0BU, 0x0CU, 0x00U,              8U,  ESMC_TRANSFER_FORMAT_SINGLE, ESMC_ADDRESS_SINGLE_LINE, ESMC_ALTERNATE_BYTES_DISABLE},
+  {0x3BU, 0x3CU, 0x00U,              8U,  ESMC_TRANSFER_FORMAT_DUAL,   ESMC_ADDRESS_SINGLE_LINE, ESMC_ALTERNATE_BYTES_DISABLE},
+  {0xBBU, 0xBCU, ESMCEX_MODE_BYTE,   0U,  ESMC_TRANSFER_FORMAT_DUAL,   ESMC_ADDRESS_MULTI_LINES, ESMC_ALTERNATE_BYTES_ENABLE},
+  {0x6BU, 0x6CU, 0x00U,              8U,  ESMC_TRANSFER_FORMAT_QUAD,   ESMC_ADDRESS_SINGLE_LINE, ESMC_ALTERNATE_BYTES_DISABLE},
+  {0xEBU, 0xECU, ESMCEX_MODE_BYTE,   4U,  ESMC_TRANSFER_FORMAT_QUAD,   ESMC_ADDRESS_MULTI_LINES, ESMC_ALTERNATE_BYTES_ENABLE},
+  {0x8BU, 0x7CU, 0x00U,              8U,  ESMC_TRANSFER_FORMAT_OCTAL,  ESMC_ADDRESS_SINGLE_LINE, ESMC_ALTERNATE_BYTES_DISABLE},
+  {0xCBU, 0xCCU, 0x00U,              16U, ESMC_TRANSFER_FORMAT_OCTAL,  ESMC_ADDRESS_MULTI_LINES, ESMC_ALTERNATE_BYTES_DISABLE}
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @addtogroup ESMCEx_Private_Functions
+  * @{
+  */
+static HAL_StatusTypeDef ESMCEx_DualCommand(ESMC_HandleTypeDef *hesmc, uint32_t Instruction, uint32_t Address,
+                                            uint32_t AddressMode, uint32_t CSPinSel, uint32_t Timeout);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+
+/** @defgroup ESMCEx_Exported_Functions ESMCEx Exported Functions
+  * @{
+  */
+
+/** @defgroup ESMCEx_Exported_Functions_Group1 XIP functions
+  *  @brief   Execute-in-place functions
+  *
+@verbatim
+  ==============================================================================
+                      ##### XIP functions #####
+ ===============================================================================
+ [..]
+    This subsection provides a set of extended functions to run code and read
+    constant data from an external serial NOR flash through the memory-mapped
+    window at ESMC_XIP_BASE.
+
+    (#) HAL_ESMCEx_GetXIPCommand() fills a memory-mapped read command from a
+        preset of @ref ESMCEx_XIP_Preset, for an adjustment of the dummy
+        cycles of a given part before HAL_ESMC_MemoryMapped():
+        (++) The dual and quad I/O presets send the mode byte 0xFF, which
+             keeps the flash out of its continuous read mode.
+        (++) The quad presets need the QE bit of the flash status register
+             set beforehand, with HAL_ESMC_Command() in indirect mode. It is
+             non-volatile on most parts: set it once in production.
+        (++) The 32-bit address commands read the whole array of the parts
+             above 16 Mbytes without the 4-byte address mode of the flash.
+
+    (#) HAL_ESMCEx_EnableXIP() initializes the ESMC if needed and maps the
+        flash with a preset. The ClockPrescaler of the Init structure sets the
+        SCK frequency from HCLK: choose it for the final HCLK and the fast read
+        frequency of the part. With ESMC_DUALFLASH_ENABLE only the quad
+        presets are accepted, the window then spans both flashes.
+
+    (#) HAL_ESMCEx_DisableXIP() ends the memory-mapped mode, for instance to
+        erase and program the flash in indirect mode. No code or data of the
+        window may be accessed until XIP is enabled again: run it from the
+        internal flash or RAM with the interrupts served from there.
+
+    (#) With DATA_IN_ExtFlash defined, SystemInit() maps the flash before the
+        constructors and main(), the __EXTFLASH_FUNC and __EXTFLASH_CONST
+        objects of the .extflash section are then usable from the start.
+
+    (#) The ESMC has no prefetch or cache control: every fetch of the window
+        runs a read command on the bus. Keep the interrupt handlers and the
+        hot loops in the internal flash, and use the window for cold code and
+        large tables read in sequence.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Fill a memory-mapped read command from a preset.
+  * @param  Preset Fast read command, a value of @ref ESMCEx_XIP_Preset.
+  * @param  AddressSize Flash address size, ESMC_ADDRESS_24_BITS or ESMC_ADDRESS_32_BITS.
+  * @param  cmd Command filled, CSPinSel is left unchanged.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_GetXIPCommand(uint32_t Preset, uint32_t AddressSize, ESMC_CommandTypeDef *cmd)
+{
+  const ESMCEx_ReadCommandTypeDef *pread;
+
+  if ((cmd == NULL) || (!IS_ESMCEX_XIP_PRESET(Preset)) ||
+      ((AddressSize != ESMC_ADDRESS_24_BITS) && (AddressSize != ESMC_ADDRESS_32_BITS)))
+  {
+    return HAL_ERROR;
+  }
+
+  pread = &ESMCEx_ReadCommands[Preset];
+
+  cmd->TransferFormat    = pread->TransferFormat;
+  cmd->Instruction       = (AddressSize == ESMC_ADDRESS_32_BITS) ? pread->Instruction4B : pread->Instruction;
+  cmd->InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd->Address           = 0U;
+  cmd->AddressMode       = pread->AddressMode;
+  cmd->AddressSize       = AddressSize;
+  cmd->AlternateByte     = pread->AlternateByte;
+  cmd->AlternateByteMode = pread->AlternateByteMode;
+  cmd->DataMode          = ESMC_DATA_READ;
+  cmd->NbData            = 0U;
+  cmd->DdrMode           = ESMC_DDR_DISABLE;
+  cmd->DummyCycles       = pread->DummyCycles;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Map the external flash with a fast read preset.
+  * @note   The ESMC is initialized with HAL_ESMC_Init() when its state is reset.
+  * @param  hesmc ESMC handle
+  * @param  Preset Fast read command, a value of @ref ESMCEx_XIP_Preset.
+  * @param  AddressSize Flash address size, ESMC_ADDRESS_24_BITS or ESMC_ADDRESS_32_BITS.
+  * @param  CSPinSel Chip select of the flash, a value of @ref ESMC_CS_PIN_SEL.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_EnableXIP(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t AddressSize,
+                                       uint32_t CSPinSel)
+{
+  ESMC_CommandTypeDef cmd;
+  HAL_StatusTypeDef status;
+
+  if (hesmc == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* The data phase of the two flashes takes the 8 lines, quad each */
+  if ((hesmc->Init.DualFlash == ESMC_DUALFLASH_ENABLE) && (!IS_ESMCEX_DUAL_PRESET(Preset)))
+  {
+    return HAL_ERROR;
+  }
+
+  status = HAL_ESMCEx_GetXIPCommand(Preset, AddressSize, &cmd);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  cmd.CSPinSel = CSPinSel;
+
+  if (hesmc->State == HAL_ESMC_STATE_RESET)
+  {
+    status = HAL_ESMC_Init(hesmc);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+  }
+
+  return HAL_ESMC_MemoryMapped(hesmc, &cmd);
+}
+
+/**
+  * @brief  End the memory-mapped mode.
+  * @note   To be called from code outside of the window.
+  * @param  hesmc ESMC handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_DisableXIP(ESMC_HandleTypeDef *hesmc)
+{
+  uint32_t tickstart;
+
+  if (hesmc == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if (hesmc->State != HAL_ESMC_STATE_BUSY_MEM_MAPPED)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(hesmc);
+
+  /* Let the last fetch end */
+  tickstart = HAL_GetTick();
+  while (__HAL_ESMC_GET_FLAG(hesmc, ESMC_FLAG_IDLE) == RESET)
+  {
+    if ((HAL_GetTick() - tickstart) > hesmc->Timeout)
+    {
+      hesmc->ErrorCode |= HAL_ESMC_ERROR_TIMEOUT;
+      __HAL_UNLOCK(hesmc);
+      return HAL_TIMEOUT;
+    }
+  }
+
+  CLEAR_BIT(hesmc->Instance->CR, ESMC_CR_XIPEN);
+  __HAL_ESMC_DISABLE_SLAVE(hesmc);
+
+  hesmc->State = HAL_ESMC_STATE_READY;
+
+  __HAL_UNLOCK(hesmc);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup ESMCEx_Exported_Functions_Group2 Dual flash functions
+  *  @brief   Dual flash functions
+  *
+@verbatim
+  ==============================================================================
+                      ##### Dual flash functions #####
+ ===============================================================================
+ [..]
+    This subsection provides a set of extended functions to use two identical
+    quad serial NOR flashes in parallel, initialized with DualFlash set to
+    ESMC_DUALFLASH_ENABLE: the first flash on IO0 to IO3, the second one on
+    IO4 to IO7, both selected by the same chip select.
+
+    (#) Every command goes to both flashes. The data are striped: the even
+        bytes of the combined memory are in the first flash, the odd bytes in
+        the second one, at the combined address divided by 2. The combined
+        address is given to the functions, it must be even as the size.
+
+    (#) HAL_ESMCEx_DualEraseSector() erases the two 4-Kbyte sectors of an
+        ESMCEX_DUAL_SECTOR_SIZE combined sector, HAL_ESMCEx_DualProgram()
+        programs with the quad page program in ESMCEX_DUAL_PAGE_SIZE combined
+        pages. Both wait for the end of the operation in the two flashes with
+        HAL_ESMCEx_DualWaitReady(): the status register is read back as two
+        bytes, one per flash. The QE bit must be set in both flashes.
+
+    (#) HAL_ESMCEx_DualRead() reads with a quad preset in indirect mode,
+        HAL_ESMCEx_EnableXIP() maps the combined memory with the same presets.
+        Each flash sends half of the data: the throughput is twice the one of
+        a single flash at the same SCK frequency.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Read the combined memory of two flashes in indirect mode.
+  * @param  hesmc ESMC handle, DualFlash enabled
+  * @param  Preset Fast read command, ESMCEX_XIP_QUAD_OUTPUT or ESMCEX_XIP_QUAD_IO.
+  * @param  Address Combined address, even.
+  * @param  pData Destination buffer.
+  * @param  Size Number of bytes, even.
+  * @param  CSPinSel Chip select of the flashes, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Timeout Timeout duration, ms
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_DualRead(ESMC_HandleTypeDef *hesmc, uint32_t Preset, uint32_t Address,
+                                      uint8_t *pData, uint32_t Size, uint32_t CSPinSel, uint32_t Timeout)
+{
+  ESMC_CommandTypeDef cmd;
+  HAL_StatusTypeDef status;
+
+  if ((hesmc == NULL) || (pData == NULL) || (Size == 0U) || ((Address & 1U) != 0U) || ((Size & 1U) != 0U) ||
+      (hesmc->Init.DualFlash != ESMC_DUALFLASH_ENABLE) || (!IS_ESMCEX_DUAL_PRESET(Preset)))
+  {
+    return HAL_ERROR;
+  }
+
+  status = HAL_ESMCEx_GetXIPCommand(Preset, ESMC_ADDRESS_24_BITS, &cmd);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  cmd.Address  = Address;
+  cmd.NbData   = Size;
+  cmd.CSPinSel = CSPinSel;
+
+  status = HAL_ESMC_Command(hesmc, &cmd, Timeout);
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMC_Receive(hesmc, pData, Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Program the combined memory of two flashes.
+  * @note   The area must be erased. Each combined page is programmed then
+  *         waited for with HAL_ESMCEx_DualWaitReady().
+  * @param  hesmc ESMC handle, DualFlash enabled
+  * @param  Address Combined address, even.
+  * @param  pData Data to program.
+  * @param  Size Number of bytes, even.
+  * @param  CSPinSel Chip select of the flashes, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Timeout Timeout duration of each page, ms
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_DualProgram(ESMC_HandleTypeDef *hesmc, uint32_t Address, const uint8_t *pData,
+                                         uint32_t Size, uint32_t CSPinSel, uint32_t Timeout)
+{
+  ESMC_CommandTypeDef cmd = {0};
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t chunk;
+
+  if ((hesmc == NULL) || (pData == NULL) || (Size == 0U) || ((Address & 1U) != 0U) || ((Size & 1U) != 0U) ||
+      (hesmc->Init.DualFlash != ESMC_DUALFLASH_ENABLE))
+  {
+    return HAL_ERROR;
+  }
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_QUAD;
+  cmd.Instruction       = ESMCEX_CMD_QUAD_PROGRAM;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_SINGLE_LINE;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_WRITE;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.DummyCycles       = 0U;
+  cmd.CSPinSel          = CSPinSel;
+
+  while ((status == HAL_OK) && (Size != 0U))
+  {
+    /* A page program wraps at the end of the page of each flash */
+    chunk = ESMCEX_DUAL_PAGE_SIZE - (Address & (ESMCEX_DUAL_PAGE_SIZE - 1U));
+    if (chunk > Size)
+    {
+      chunk = Size;
+    }
+
+    status = ESMCEx_DualCommand(hesmc, ESMCEX_CMD_WRITE_ENABLE, 0U, ESMC_ADDRESS_NONE, CSPinSel, Timeout);
+    if (status == HAL_OK)
+    {
+      cmd.Address = Address;
+      cmd.NbData  = chunk;
+      status = HAL_ESMC_Command(hesmc, &cmd, Timeout);
+    }
+    if (status == HAL_OK)
+    {
+      status = HAL_ESMC_Transmit(hesmc, (uint8_t *)pData, Timeout);
+    }
+    if (status == HAL_OK)
+    {
+      status = HAL_ESMCEx_DualWaitReady(hesmc, CSPinSel, Timeout);
+    }
+
+    Address += chunk;
+    pData   += chunk;
+    Size    -= chunk;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Erase a combined sector of two flashes.
+  * @param  hesmc ESMC handle, DualFlash enabled
+  * @param  Address Combined address, in the ESMCEX_DUAL_SECTOR_SIZE sector to erase.
+  * @param  CSPinSel Chip select of the flashes, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Timeout Timeout duration of the erase, ms
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ESMCEx_DualEraseSector(ESMC_HandleTypeDef *hesmc, uint32_t Address, uint32_t CSPinSel,
+                                             uint32_t Timeout)
+{
+  HAL_StatusTypeDef status;
+
+  if ((hesmc == NULL) || (hesmc->Init.DualFlash != ESMC_DUALFLASH_ENABLE))
+  {
+    return HAL_ERROR;
+  }
+
+  Address &= ~(ESMCEX_DUAL_SECTOR_SIZE - 1U);
+
+  status = ESMCEx_DualCommand(hesmc, ESMCEX_CMD_WRITE_ENABLE, 0U, ESMC_ADDRESS_NONE, CSPinSel, Timeout);
+  if (status == HAL_OK)
+  {
+    status = ESMCEx_DualCommand(hesmc, ESMCEX_CMD_SECTOR_ERASE, Address, ESMC_ADDRESS_SINGLE_LINE, CSPinSel,
+                                Timeout);
+  }
+  if (status == HAL_OK)
+  {
+    status = HAL_ESMCEx_DualWaitReady(hesmc, CSPinSel, Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Wait for the end of a program or erase in both flashes.
+  * @param  hesmc ESMC handle, DualFlash enabled
+  * @param  CSPinSel Chip select of the flashes, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Timeout Timeout duration, ms
+  * @retval HAL status, HAL_TIMEOUT when a flash is still busy
+  */
+HAL_StatusTypeDef HAL_ESMCEx_DualWaitReady(ESMC_HandleTypeDef *hesmc, uint32_t CSPinSel, uint32_t Timeout)
+{
+  ESMC_CommandTypeDef cmd = {0};
+  HAL_StatusTypeDef status;
+  uint32_t tickstart = HAL_GetTick();
+  uint8_t sr[2];
+
+  if ((hesmc == NULL) || (hesmc->Init.DualFlash != ESMC_DUALFLASH_ENABLE))
+  {
+    return HAL_ERROR;
+  }
+
+  /* One status byte per flash, the first flash first */
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = ESMCEX_CMD_READ_STATUS;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.AddressMode       = ESMC_ADDRESS_NONE;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_READ;
+  cmd.NbData            = sizeof(sr);
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = CSPinSel;
+
+  for (;;)
+  {
+    status = HAL_ESMC_Command(hesmc, &cmd, Timeout);
+    if (status == HAL_OK)
+    {
+      status = HAL_ESMC_Receive(hesmc, sr, Timeout);
+    }
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+    if (((sr[0] | sr[1]) & ESMCEX_STATUS_WIP) == 0U)
+    {
+      return HAL_OK;
+    }
+    if ((HAL_GetTick() - tickstart) > Timeout)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup ESMCEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Send an instruction, with an optional address, to both flashes.
+  * @param  hesmc ESMC handle
+  * @param  Instruction Flash command.
+  * @param  Address Combined address, when AddressMode is not ESMC_ADDRESS_NONE.
+  * @param  AddressMode ESMC_ADDRESS_NONE or ESMC_ADDRESS_SINGLE_LINE.
+  * @param  CSPinSel Chip select of the flashes, a value of @ref ESMC_CS_PIN_SEL.
+  * @param  Timeout Timeout duration, ms
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef ESMCEx_DualCommand(ESMC_HandleTypeDef *hesmc, uint32_t Instruction, uint32_t Address,
+                                            uint32_t AddressMode, uint32_t CSPinSel, uint32_t Timeout)
+{
+  ESMC_CommandTypeDef cmd = {0};
+
+  cmd.TransferFormat    = ESMC_TRANSFER_FORMAT_SINGLE;
+  cmd.Instruction       = Instruction;
+  cmd.InstructionMode   = ESMC_INSTRUCTION_SINGLE_LINE;
+  cmd.Address           = Address;
+  cmd.AddressMode       = AddressMode;
+  cmd.AddressSize       = ESMC_ADDRESS_24_BITS;
+  cmd.AlternateByteMode = ESMC_ALTERNATE_BYTES_DISABLE;
+  cmd.DataMode          = ESMC_DATA_NONE;
+  cmd.DdrMode           = ESMC_DDR_DISABLE;
+  cmd.CSPinSel          = CSPinSel;
+
+  return HAL_ESMC_Command(hesmc, &cmd, Timeout);
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_ESMC_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -263,7 +263,7 @@ uint32_t HAL_FLASH_GetError(void)
   * @param  Timeout maximum flash operation timeout
   * @retval HAL_StatusTypeDef HAL Status
   */
-HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout)
+__FLASH_RAM_FUNC HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout)
 {
   /* Wait for the FLASH operation to complete by polling on BUSY flag to be reset.
      Even if the FLASH operation fails, the BUSY flag will be reset and an error
@@ -277,6 +277,14 @@ HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout)
     {
       return HAL_TIMEOUT;
     }
+#if (USE_HAL_WAIT_STRATEGY != HAL_WAIT_SPIN)
+    /* A fetch from the FLASH stalls to the end of the operation: no HAL_Wait(),
+       WFE to the next interrupt whatever the strategy */
+    if ((HAL_GetTick() - (timeout - Timeout)) >= HAL_WAIT_SPIN_TIME)
+    {
+      __WFE();
+    }
+#endif /* USE_HAL_WAIT_STRATEGY */
   }
 
   /* Clear SR register */
@@ -289,7 +297,7 @@ HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout)
   * @brief  Full erase of FLASH memory
   * @retval None
   */
-static void FLASH_MassErase(void)   
+static __FLASH_RAM_FUNC void FLASH_MassErase(void)
 {
   /* Clean the error context */
   pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
@@ -304,7 +312,7 @@ static void FLASH_MassErase(void)
   * @param  PageAddress page erase address
   * @retval None
   */
-static void FLASH_PageErase(uint32_t PageAddress)
+static __FLASH_RAM_FUNC void FLASH_PageErase(uint32_t PageAddress)
 {
   /* Clean the error context */
   pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
@@ -317,7 +325,7 @@ static void FLASH_PageErase(uint32_t PageAddress)
   * @param  SectorAddress sector erase address
   * @retval None
   */
-static void FLASH_SectorErase(uint32_t SectorAddress)
+static __FLASH_RAM_FUNC void FLASH_SectorErase(uint32_t SectorAddress)
 {
   SET_BIT(FLASH->CR, FLASH_CR_SER);
   *(__IO uint32_t *)(SectorAddress) = 0xFF;
@@ -328,7 +336,7 @@ static void FLASH_SectorErase(uint32_t SectorAddress)
   * @param  BlockAddress block erase address
   * @retval None
   */
-static void FLASH_BlockErase(uint32_t BlockAddress)
+static __FLASH_RAM_FUNC void FLASH_BlockErase(uint32_t BlockAddress)
 {
   SET_BIT(FLASH->CR, FLASH_CR_BER);
   *(__IO uint32_t *)(BlockAddress) = 0xFF;
@@ -340,7 +348,7 @@ static void FLASH_BlockErase(uint32_t BlockAddress)
   * @param  DataAddress  Specifies the data to be programmed
   * @retval None
   */
-static void FLASH_Program_Page(uint32_t Address, uint32_t * DataAddress)
+static __FLASH_RAM_FUNC void FLASH_Program_Page(uint32_t Address, uint32_t * DataAddress)
 {
   uint8_t index=0;
   uint32_t dest = Address;
@@ -348,7 +356,8 @@ static void FLASH_Program_Page(uint32_t Address, uint32_t * DataAddress)
   uint32_t primask_bit;
 
   SET_BIT(FLASH->CR, FLASH_CR_PG);
-  /* Enter critical section */
+  /* Enter critical section, PRIMASK whatever HAL_CRITICAL_PRIORITY: no
+     interrupt may fetch from the flash while the page buffer is filled */
   primask_bit = __get_PRIMASK();
   __disable_irq();
   /* 64 words*/
@@ -404,7 +413,7 @@ static void FLASH_Program_Page(uint32_t Address, uint32_t * DataAddress)
   *         (0xFFFFFFFF means that all the pages or sectors or blocks have been correctly erased)
   * @retval HAL_StatusTypeDef HAL Status
   */
-HAL_StatusTypeDef HAL_FLASH_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageSectorBlockError)
+__FLASH_RAM_FUNC HAL_StatusTypeDef HAL_FLASH_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageSectorBlockError)
 {
   HAL_StatusTypeDef status = HAL_ERROR;
   uint32_t address = 0U;
@@ -629,7 +638,7 @@ HAL_StatusTypeDef HAL_FLASH_PageProgram(uint32_t Address, uint32_t * DataAddr )
   * @param  DataAddr Page Start Address
   * @retval HAL_StatusTypeDef HAL Status
   */
-HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t * DataAddr )
+__FLASH_RAM_FUNC HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t * DataAddr )
 {
   HAL_StatusTypeDef status = HAL_ERROR;
 
@@ -990,7 +999,7 @@ void HAL_FLASH_OBGetConfig(FLASH_OBProgramInitTypeDef *pOBInit)
   * @brief Handle FLASH interrupt request.
   * @retval None
   */
-void HAL_FLASH_IRQHandler(void)
+__FLASH_RAM_FUNC void HAL_FLASH_IRQHandler(void)
 {
   uint32_t param = 0xFFFFFFFFU;
   uint32_t error;
@@ -1103,11 +1112,19 @@ void HAL_FLASH_IRQHandler(void)
        
     }
 
+    if (pFlash.ProcedureOnGoing == FLASH_TYPENONE)
+    {
+      /* Disable End of Operation and Error interrupts */
+      __HAL_FLASH_DISABLE_IT(FLASH_IT_EOP | FLASH_IT_OPERR);
+
+      /* Process Unlocked: the callback can start the next operation */
+      __HAL_UNLOCK(&pFlash);
+    }
+
     /* User callback */
     HAL_FLASH_EndOfOperationCallback(param);
   }
-
-  if (pFlash.ProcedureOnGoing == FLASH_TYPENONE)
+  else if (pFlash.ProcedureOnGoing == FLASH_TYPENONE)
   {
     /* Disable End of Operation and Error interrupts */
     __HAL_FLASH_DISABLE_IT(FLASH_IT_EOP | FLASH_IT_OPERR);
@@ -1115,6 +1132,10 @@ void HAL_FLASH_IRQHandler(void)
     /* Process Unlocked */
     __HAL_UNLOCK(&pFlash);
   }
+  else
+  {
+    /* Nothing to do */
+  }
 }
 
 /**
@@ -74,6 +74,16 @@
 
     (#) To lock pin configuration until next reset use HAL_GPIO_LockPin().
 
+    (#) In a hot loop, describe a pin with GPIO_PIN_DESC() and use the
+        __HAL_GPIO_PIN_x() macros of the extended module: a constant
+        descriptor reduces a write to one store to BSRR or BRR, and is
+        checked at build time rather than by assert_param(). The
+        __HAL_GPIO_PORT_x() macros read and write several pins of a port at
+        once, __HAL_GPIO_PIN_SET_MODE() and HAL_GPIOEx_SetPortMode() switch
+        a bidirectional line between input and output, and
+        HAL_GPIOEx_ConfigPort() configures the pins of a mask without the
+        loop of HAL_GPIO_Init(), the EXTI left out.
+
     (#) During and just after reset, the alternate functions are not
         active and the GPIO pins are configured in input floating mode (except JTAG
         pins).
@@ -348,6 +358,60 @@ void HAL_GPIO_DeInit(GPIO_TypeDef  *GPIOx, uint32_t GPIO_Pin)
     }
 }
 
+/**
+  * @brief  Configure several pins of a port at once, without the loop over the pins.
+  * @note   Each register is written once for all the pins of the mask, a
+  *         port of a parallel bus configured in a few cycles. The EXTI is not
+  *         configured: use HAL_GPIO_Init() for the GPIO_MODE_IT_x and
+  *         GPIO_MODE_EVT_x modes.
+  * @param  GPIOx where x can be (A..E) to select the GPIO peripheral for PY32F4 family
+  * @param  GPIO_Init pointer to a GPIO_InitTypeDef structure, Mode one of
+  *         GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_x, GPIO_MODE_AF_x or GPIO_MODE_ANALOG.
+  * @retval None
+  */
+void HAL_GPIOEx_ConfigPort(GPIO_TypeDef *GPIOx, const GPIO_InitTypeDef *GPIO_Init)
+{
+    uint32_t spread2 = HAL_GPIOEx_Spread2(GPIO_Init->Pin);
+    uint32_t spread4;
+    uint32_t half;
+    uint32_t index;
+
+    /* Check the parameters */
+    assert_param(IS_GPIO_ALL_INSTANCE(GPIOx));
+    assert_param(IS_GPIO_PIN(GPIO_Init->Pin));
+    assert_param(IS_GPIO_MODE(GPIO_Init->Mode));
+    assert_param(IS_GPIO_PULL(GPIO_Init->Pull));
+    assert_param(IS_GPIO_SPEED(GPIO_Init->Speed));
+
+    if ((GPIO_Init->Mode == GPIO_MODE_AF_PP) || (GPIO_Init->Mode == GPIO_MODE_AF_OD))
+    {
+        /* Check the Alternate function parameters */
+        assert_param(IS_GPIO_AF_INSTANCE(GPIOx));
+        assert_param(IS_GPIO_AF(GPIO_Init->Alternate));
+
+        /* Spread each half of the mask to the 4 bits per pin of AFRL and AFRH */
+        for (index = 0u; index < 2u; index++)
+        {
+            half = (GPIO_Init->Pin >> (index * 8u)) & 0xFFu;
+            if (half != 0x00u)
+            {
+                spread4 = (half | (half << 12u)) & 0x000F000Fu;
+                spread4 = (spread4 | (spread4 << 6u)) & 0x03030303u;
+                spread4 = (spread4 | (spread4 << 3u)) & 0x11111111u;
+                MODIFY_REG(GPIOx->AFR[index], spread4 * 0xFu, spread4 * GPIO_Init->Alternate);
+            }
+        }
+    }
+
+    MODIFY_REG(GPIOx->OSPEEDR, spread2 * GPIO_OSPEEDR_OSPEED0, spread2 * GPIO_Init->Speed);
+    MODIFY_REG(GPIOx->OTYPER, GPIO_Init->Pin & GPIO_PIN_MASK,
+               ((GPIO_Init->Mode & GPIO_OUTPUT_TYPE) != 0x00u) ? (GPIO_Init->Pin & GPIO_PIN_MASK) : 0x00u);
+    MODIFY_REG(GPIOx->PUPDR, spread2 * GPIO_PUPDR_PUPD0, spread2 * GPIO_Init->Pull);
+
+    /* Mode last, the pins drive with their speed and type set */
+    MODIFY_REG(GPIOx->MODER, spread2 * GPIO_MODER_MODE0, spread2 * (GPIO_Init->Mode & GPIO_MODE));
+}
+
 /**
   * @}
   */
@@ -1167,6 +1167,7 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
 {
   /* Init tickstart for timeout management*/
   uint32_t tickstart = HAL_GetTick();
+  uint32_t critical;
 
   if (hi2c->State == HAL_I2C_STATE_READY)
   {
@@ -1218,9 +1219,9 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
       /* Disable Acknowledge */
       CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-      /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+      /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
       software sequence must complete before the current byte end of transfer */
-      __disable_irq();
+      critical = HAL_EnterCritical();
 
       /* Clear ADDR flag */
       __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
@@ -1228,17 +1229,17 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
       /* Generate Stop */
       SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
 
-      /* Re-enable IRQs */
-      __enable_irq();
+      /* Unmask the IRQs */
+      HAL_ExitCritical(critical);
     }
     else if (hi2c->XferSize == 2U)
     {
       /* Enable Pos */
       SET_BIT(hi2c->Instance->CR1, I2C_CR1_POS);
 
-      /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+      /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
       software sequence must complete before the current byte end of transfer */
-      __disable_irq();
+      critical = HAL_EnterCritical();
 
       /* Clear ADDR flag */
       __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
@@ -1246,8 +1247,8 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
       /* Disable Acknowledge */
       CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-      /* Re-enable IRQs */
-      __enable_irq();
+      /* Unmask the IRQs */
+      HAL_ExitCritical(critical);
     }
     else
     {
@@ -1290,9 +1291,9 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
             return HAL_ERROR;
           }
 
-          /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+          /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
              software sequence must complete before the current byte end of transfer */
-          __disable_irq();
+          critical = HAL_EnterCritical();
 
           /* Generate Stop */
           SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
@@ -1307,8 +1308,8 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
           hi2c->XferSize--;
           hi2c->XferCount--;
 
-          /* Re-enable IRQs */
-          __enable_irq();
+          /* Unmask the IRQs */
+          HAL_ExitCritical(critical);
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -1332,9 +1333,9 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
           /* Disable Acknowledge */
           CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-          /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+          /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
              software sequence must complete before the current byte end of transfer */
-          __disable_irq();
+          critical = HAL_EnterCritical();
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -1365,8 +1366,8 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
           hi2c->XferSize--;
           hi2c->XferCount--;
 
-          /* Re-enable IRQs */
-          __enable_irq();
+          /* Unmask the IRQs */
+          HAL_ExitCritical(critical);
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -2572,6 +2573,7 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
 {
   /* Init tickstart for timeout management*/
   uint32_t tickstart = HAL_GetTick();
+  uint32_t critical;
 
   /* Check the parameters */
   assert_param(IS_I2C_MEMADD_SIZE(MemAddSize));
@@ -2626,9 +2628,9 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
       /* Disable Acknowledge */
       CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-      /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+      /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
          software sequence must complete before the current byte end of transfer */
-      __disable_irq();
+      critical = HAL_EnterCritical();
 
       /* Clear ADDR flag */
       __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
@@ -2636,17 +2638,17 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
       /* Generate Stop */
       SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
 
-      /* Re-enable IRQs */
-      __enable_irq();
+      /* Unmask the IRQs */
+      HAL_ExitCritical(critical);
     }
     else if (hi2c->XferSize == 2U)
     {
       /* Enable Pos */
       SET_BIT(hi2c->Instance->CR1, I2C_CR1_POS);
 
-      /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+      /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
          software sequence must complete before the current byte end of transfer */
-      __disable_irq();
+      critical = HAL_EnterCritical();
 
       /* Clear ADDR flag */
       __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
@@ -2654,8 +2656,8 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
       /* Disable Acknowledge */
       CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-      /* Re-enable IRQs */
-      __enable_irq();
+      /* Unmask the IRQs */
+      HAL_ExitCritical(critical);
     }
     else
     {
@@ -2697,9 +2699,9 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
             return HAL_ERROR;
           }
 
-          /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+          /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
              software sequence must complete before the current byte end of transfer */
-          __disable_irq();
+          critical = HAL_EnterCritical();
 
           /* Generate Stop */
           SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
@@ -2714,8 +2716,8 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
           hi2c->XferSize--;
           hi2c->XferCount--;
 
-          /* Re-enable IRQs */
-          __enable_irq();
+          /* Unmask the IRQs */
+          HAL_ExitCritical(critical);
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -2739,9 +2741,9 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
           /* Disable Acknowledge */
           CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_ACK);
 
-          /* Disable all active IRQs around ADDR clearing and STOP programming because the EV6_3
+          /* Mask the IRQs of the HAL priorities around ADDR clearing and STOP programming because the EV6_3
              software sequence must complete before the current byte end of transfer */
-          __disable_irq();
+          critical = HAL_EnterCritical();
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -2772,8 +2774,8 @@ HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
           hi2c->XferSize--;
           hi2c->XferCount--;
 
-          /* Re-enable IRQs */
-          __enable_irq();
+          /* Unmask the IRQs */
+          HAL_ExitCritical(critical);
 
           /* Read data from DR */
           *hi2c->pBuffPtr = (uint8_t)hi2c->Instance->DR;
@@ -6905,6 +6907,8 @@ static HAL_StatusTypeDef I2C_WaitOnFlagUntilTimeout(I2C_HandleTypeDef *hi2c, uin
         return HAL_ERROR;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -6957,6 +6961,8 @@ static HAL_StatusTypeDef I2C_WaitOnMasterAddressFlagUntilTimeout(I2C_HandleTypeD
         return HAL_ERROR;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -6995,6 +7001,8 @@ static HAL_StatusTypeDef I2C_WaitOnTXEFlagUntilTimeout(I2C_HandleTypeDef *hi2c,
         return HAL_ERROR;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -7033,6 +7041,8 @@ static HAL_StatusTypeDef I2C_WaitOnBTFFlagUntilTimeout(I2C_HandleTypeDef *hi2c,
         return HAL_ERROR;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -7068,6 +7078,8 @@ static HAL_StatusTypeDef I2C_WaitOnSTOPFlagUntilTimeout(I2C_HandleTypeDef *hi2c,
 
       return HAL_ERROR;
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -7115,6 +7127,8 @@ static HAL_StatusTypeDef I2C_WaitOnRXNEFlagUntilTimeout(I2C_HandleTypeDef *hi2c,
 
       return HAL_ERROR;
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -0,0 +1,770 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_i2c_ex.c
+  * @author  MCU Application Team
+  * @brief   Extended I2C HAL module driver.
+  *          This file provides firmware functions to manage the following
+  *          I2C peripheral extended functionalities :
+  *           + Timing functions
+  *           + Fast IO functions
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @defgroup I2CEx I2CEx
+  * @brief I2C Extended HAL module driver
+  * @{
+  */
+#ifdef HAL_I2C_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/** @defgroup I2CEx_Private_Types I2CEx Private Types
+  * @{
+  */
+
+/**
+  * @brief  SCL waveform of one CCR setting: low and high periods in CCR units
+  */
+typedef struct
+{
+  uint32_t Low;              /* Low period, in CCR units  */
+  uint32_t High;             /* High period, in CCR units */
+  uint32_t CCRMin;           /* Smallest CCR value        */
+  uint32_t Mode;             /* CCR FS and DUTY bits      */
+} I2CEx_WaveTypeDef;
+
+/**
+  * @}
+  */
+
+/* Private defines -----------------------------------------------------------*/
+/** @defgroup I2CEx_Private_Constants I2CEx Private Constants
+  * @{
+  */
+#define I2CEX_STANDARD_SPEED_MAX  100000U     /* Standard mode limit, Hz          */
+#define I2CEX_STANDARD_LOW_MIN    4700U       /* tLOW min, ns                     */
+#define I2CEX_STANDARD_HIGH_MIN   4000U       /* tHIGH min, ns                    */
+#define I2CEX_STANDARD_RISE_MAX   1000U       /* tr max, ns                       */
+#define I2CEX_FAST_LOW_MIN        1300U       /* tLOW min, ns                     */
+#define I2CEX_FAST_HIGH_MIN       600U        /* tHIGH min, ns                    */
+#define I2CEX_FAST_RISE_MAX       300U        /* tr max, ns                       */
+#define I2CEX_FALL_MAX            300U        /* tf max, ns                       */
+
+/* Bits of a write of Size bytes: start, address and data with their ACK, stop */
+#define I2CEX_FRAME_BITS(__SIZE__) ((9U * ((uint32_t)(__SIZE__) + 1U)) + 2U)
+
+#define I2CEX_SR1_ERRORS          (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF)
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup I2CEx_Private_Macros I2CEx Private Macros
+  * @{
+  */
+/* Number of PCLK cycles covering __NS__ nanoseconds, rounded up */
+#define I2CEX_NS_TO_CYCLES(__PCLK__, __NS__) \
+  ((uint32_t)((((uint64_t)(__NS__) * (__PCLK__)) + 999999999U) / 1000000000U))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/** @defgroup I2CEx_Private_Variables I2CEx Private Variables
+  * @{
+  */
+static const I2CEx_WaveTypeDef I2CEx_StandardWave = {1U, 1U, 4U, 0U};
+static const I2CEx_WaveTypeDef I2CEx_FastWaves[2] =
+{
+  {2U, 1U, 1U, I2C_CCR_FS | I2C_DUTYCYCLE_2},
+  {16U, 9U, 1U, I2C_CCR_FS | I2C_DUTYCYCLE_16_9}
+};
+/**
+  * @}
+  */
+
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup I2CEx_Private_Functions I2CEx Private Functions
+  * @{
+  */
+static uint32_t I2CEx_FitWave(const I2CEx_WaveTypeDef *pWave, uint32_t Period, uint32_t Rise, uint32_t Fall,
+                              uint32_t LowMin, uint32_t HighMin);
+static HAL_StatusTypeDef I2CEx_FastWait(I2C_HandleTypeDef *hi2c, uint32_t Flag, uint32_t Budget);
+static HAL_StatusTypeDef I2CEx_FastStart(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                         uint16_t MemAddSize, uint32_t Budget);
+static HAL_StatusTypeDef I2CEx_FastAbort(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef Status);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+
+/** @defgroup I2CEx_Exported_Functions I2CEx Exported Functions
+  * @{
+  */
+
+/** @defgroup I2CEx_Exported_Functions_Group1 Timing functions
+  *  @brief   Bus timing functions
+  *
+@verbatim
+  ==============================================================================
+                      ##### Timing functions #####
+ ===============================================================================
+ [..]
+    This subsection provides a set of extended functions to run the I2C at the
+    fastest SCL frequency the bus allows.
+
+    (#) HAL_I2CEx_CalcTiming() derives the CR2 FREQ, TRISE and CCR values from
+        the PCLK1 frequency, the target frequency and the measured SCL rise
+        and fall times of the bus:
+        (++) The SCL period is the low and high periods counted by the I2C in
+             PCLK1 cycles plus the rise time, the I2C starts counting the high
+             period once it sees SCL high. The low period seen by the devices
+             is the counted one less the fall time.
+        (++) The smallest CCR reaching at most the target frequency and
+             meeting the tLOW and tHIGH minimums of the mode is kept. In fast
+             mode both duty cycles are tried and the faster one is kept, the
+             16/9 one pays off with a PCLK1 multiple of 10 MHz.
+        (++) TRISE is set from the maximum rise time of the mode, 1000 ns or
+             300 ns. A bus slower than that is rejected: lower the pull-up
+             resistors or the target frequency.
+        (++) The analog filter of the given pins is enabled in fast mode only,
+             where the I2C specification asks for the 50 ns spike suppression.
+             Its delay adds to the rise time, validate the result with
+             HAL_I2CEx_MeasureClockSpeed().
+        (++) The I2C of this device runs up to 400 kHz, a Fast-mode Plus target
+             is rejected. The CR2 FREQ and TRISE fields are 6 bits wide, which
+             bounds PCLK1 to 63 MHz, less in standard mode.
+
+    (#) HAL_I2CEx_ConfigTiming() applies a computed timing to an initialized
+        I2C, and updates the ClockSpeed and DutyCycle of its Init structure.
+
+    (#) HAL_I2CEx_MeasureClockSpeed() writes a buffer to a device acknowledging
+        its address, for instance a second I2C of the device in slave mode, and
+        returns the SCL frequency seen from the DWT cycle counter. The software
+        overhead around the transfer is included: use at least 16 bytes.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Compute the register values of an I2C bus timing.
+  * @param  PclkFreq I2C kernel clock, HAL_RCC_GetPCLK1Freq().
+  * @param  pConfig Bus description.
+  * @param  pTiming Computed timing.
+  * @retval HAL status, HAL_ERROR when no setting meets the bus constraints
+  */
+HAL_StatusTypeDef HAL_I2CEx_CalcTiming(uint32_t PclkFreq, const I2C_TimingConfigTypeDef *pConfig,
+                                       I2C_TimingTypeDef *pTiming)
+{
+  const I2CEx_WaveTypeDef *pwave;
+  uint32_t freqrange;
+  uint32_t period;
+  uint32_t rise;
+  uint32_t fall;
+  uint32_t lowmin;
+  uint32_t highmin;
+  uint32_t risemax;
+  uint32_t ccr;
+  uint32_t speed;
+  uint32_t index;
+
+  if ((pConfig == NULL) || (pTiming == NULL) || (!IS_I2C_CLOCK_SPEED(pConfig->ClockSpeed)) ||
+      (pConfig->FallTime > I2CEX_FALL_MAX) || (I2C_MIN_PCLK_FREQ(PclkFreq, pConfig->ClockSpeed) == 1U))
+  {
+    return HAL_ERROR;
+  }
+
+  freqrange = I2C_FREQRANGE(PclkFreq);
+  if (freqrange > (I2C_CR2_FREQ >> I2C_CR2_FREQ_Pos))
+  {
+    return HAL_ERROR;
+  }
+
+  if (pConfig->ClockSpeed <= I2CEX_STANDARD_SPEED_MAX)
+  {
+    lowmin  = I2CEX_STANDARD_LOW_MIN;
+    highmin = I2CEX_STANDARD_HIGH_MIN;
+    risemax = I2CEX_STANDARD_RISE_MAX;
+  }
+  else
+  {
+    lowmin  = I2CEX_FAST_LOW_MIN;
+    highmin = I2CEX_FAST_HIGH_MIN;
+    risemax = I2CEX_FAST_RISE_MAX;
+  }
+  if ((pConfig->RiseTime > risemax) ||
+      ((((risemax * freqrange) / 1000U) + 1U) > (I2C_TRISE_TRISE >> I2C_TRISE_TRISE_Pos)))
+  {
+    return HAL_ERROR;
+  }
+
+  period = (PclkFreq + pConfig->ClockSpeed - 1U) / pConfig->ClockSpeed;
+  rise   = I2CEX_NS_TO_CYCLES(PclkFreq, pConfig->RiseTime);
+  fall   = I2CEX_NS_TO_CYCLES(PclkFreq, pConfig->FallTime);
+  lowmin  = I2CEX_NS_TO_CYCLES(PclkFreq, lowmin);
+  highmin = I2CEX_NS_TO_CYCLES(PclkFreq, highmin);
+
+  pTiming->ClockSpeed = 0U;
+  for (index = 0U; index < ((pConfig->ClockSpeed <= I2CEX_STANDARD_SPEED_MAX) ? 1U : 2U); index++)
+  {
+    pwave = (pConfig->ClockSpeed <= I2CEX_STANDARD_SPEED_MAX) ? &I2CEx_StandardWave : &I2CEx_FastWaves[index];
+    ccr = I2CEx_FitWave(pwave, period, rise, fall, lowmin, highmin);
+    if (ccr == 0U)
+    {
+      continue;
+    }
+    speed = PclkFreq / (((pwave->Low + pwave->High) * ccr) + rise);
+    if (speed > pTiming->ClockSpeed)
+    {
+      pTiming->ClockSpeed = speed;
+      pTiming->CCR        = pwave->Mode | ccr;
+      pTiming->DutyCycle  = pwave->Mode & I2C_CCR_DUTY;
+    }
+  }
+  if (pTiming->ClockSpeed == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  pTiming->FreqRange    = freqrange;
+  pTiming->TRISE        = ((risemax * freqrange) / 1000U) + 1U;
+  pTiming->AnalogFilter = (pConfig->ClockSpeed <= I2CEX_STANDARD_SPEED_MAX) ? 0U : pConfig->AnalogFilter;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Apply a timing computed by HAL_I2CEx_CalcTiming().
+  * @note   The SYSCFG clock must be enabled when the timing has analog filters.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  pTiming Timing to apply.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2CEx_ConfigTiming(I2C_HandleTypeDef *hi2c, const I2C_TimingTypeDef *pTiming)
+{
+  uint32_t pin;
+
+  if ((hi2c == NULL) || (pTiming == NULL))
+  {
+    return HAL_ERROR;
+  }
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(hi2c);
+
+  /* The analog filter enable takes one pin at a time */
+  for (pin = HAL_SYSCFG_I2C_ANF_PB5; pin <= HAL_SYSCFG_I2C_ANF_PB12; pin <<= 1U)
+  {
+    if ((pTiming->AnalogFilter & pin) != 0U)
+    {
+      HAL_SYSCFG_EnableI2CAnalogFilter(pin);
+    }
+  }
+
+  __HAL_I2C_DISABLE(hi2c);
+  MODIFY_REG(hi2c->Instance->CR2, I2C_CR2_FREQ, pTiming->FreqRange);
+  MODIFY_REG(hi2c->Instance->TRISE, I2C_TRISE_TRISE, pTiming->TRISE);
+  MODIFY_REG(hi2c->Instance->CCR, (I2C_CCR_FS | I2C_CCR_DUTY | I2C_CCR_CCR), pTiming->CCR);
+  __HAL_I2C_ENABLE(hi2c);
+
+  hi2c->Init.ClockSpeed = pTiming->ClockSpeed;
+  hi2c->Init.DutyCycle  = pTiming->DutyCycle;
+
+  __HAL_UNLOCK(hi2c);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Measure the SCL frequency with a blocking write to a device.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  DevAddress Target device address: The device 7 bits address value
+  *         in datasheet must be shifted to the left before calling the interface
+  * @param  pData Pointer to data buffer
+  * @param  Size Amount of data to be sent
+  * @param  Timeout Timeout duration
+  * @param  pClockSpeed Measured SCL frequency in Hz.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2CEx_MeasureClockSpeed(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                              uint16_t Size, uint32_t Timeout, uint32_t *pClockSpeed)
+{
+  HAL_StatusTypeDef status;
+  uint32_t start;
+  uint32_t cycles;
+
+  if ((pData == NULL) || (Size == 0U) || (pClockSpeed == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_EnableCycleCounter();
+
+  start = DWT->CYCCNT;
+  status = HAL_I2C_Master_Transmit(hi2c, DevAddress, pData, Size, Timeout);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  /* The stop condition ends the frame */
+  while (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) != RESET)
+  {
+  }
+  cycles = DWT->CYCCNT - start;
+
+  *pClockSpeed = (uint32_t)(((uint64_t)I2CEX_FRAME_BITS(Size) * HAL_RCC_GetHCLKFreq()) / cycles);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup I2CEx_Exported_Functions_Group2 Fast IO functions
+  *  @brief   Lean polling register access functions
+  *
+@verbatim
+  ==============================================================================
+                      ##### Fast IO functions #####
+ ===============================================================================
+ [..]
+    This subsection provides a set of extended functions for the short register
+    accesses of sensors and EEPROMs, where the generic HAL_I2C_Mem_Write() and
+    HAL_I2C_Mem_Read() spend more time in their state machine than on the bus.
+
+    (#) HAL_I2CEx_FastWrite() and HAL_I2CEx_FastRead() run the same transfer
+        as the generic memory functions in master mode, polling the event
+        flags directly:
+        (++) The timeout is a budget of status register polls per bus event,
+             with no SysTick read in the loop. HAL_I2CEX_FAST_BUDGET() gives a
+             budget covering two bytes at the bus frequency. The functions
+             also run with the SysTick interrupt masked.
+        (++) A NACK, an arbitration loss or a bus error ends the transfer with
+             HAL_ERROR and the matching ErrorCode, an expired budget with
+             HAL_TIMEOUT. A stop condition is generated unless the arbitration
+             was lost.
+        (++) Interrupts are masked in the one and two bytes read sequences,
+             from the address acknowledge to the stop condition, as done by
+             HAL_I2C_Mem_Read().
+        (++) Only the memory transfers in 7-bit addressing mode are covered.
+             No callback is called and the abort functions do not apply.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Write an amount of data in blocking mode to a specific memory address, polling the flags only.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  DevAddress Target device address: The device 7 bits address value
+  *         in datasheet must be shifted to the left before calling the interface
+  * @param  MemAddress Internal memory address
+  * @param  MemAddSize Size of internal memory address
+  * @param  pData Pointer to data buffer
+  * @param  Size Amount of data to be sent
+  * @param  Budget Status register polls allowed per bus event, see HAL_I2CEX_FAST_BUDGET()
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2CEx_FastWrite(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, const uint8_t *pData, uint16_t Size, uint32_t Budget)
+{
+  I2C_TypeDef *i2c = hi2c->Instance;
+  HAL_StatusTypeDef status;
+
+  assert_param(IS_I2C_MEMADD_SIZE(MemAddSize));
+
+  if ((pData == NULL) || (Size == 0U) || (Budget == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(hi2c);
+
+  hi2c->State     = HAL_I2C_STATE_BUSY_TX;
+  hi2c->Mode      = HAL_I2C_MODE_MEM;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+  status = I2CEx_FastStart(hi2c, DevAddress, MemAddress, MemAddSize, Budget);
+  while ((status == HAL_OK) && (Size != 0U))
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_TXE, Budget);
+    if (status == HAL_OK)
+    {
+      i2c->DR = *pData;
+      pData++;
+      Size--;
+    }
+  }
+  if (status == HAL_OK)
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_BTF, Budget);
+  }
+  if (status != HAL_OK)
+  {
+    return I2CEx_FastAbort(hi2c, status);
+  }
+
+  SET_BIT(i2c->CR1, I2C_CR1_STOP);
+
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->Mode  = HAL_I2C_MODE_NONE;
+
+  __HAL_UNLOCK(hi2c);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Read an amount of data in blocking mode from a specific memory address, polling the flags only.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  DevAddress Target device address: The device 7 bits address value
+  *         in datasheet must be shifted to the left before calling the interface
+  * @param  MemAddress Internal memory address
+  * @param  MemAddSize Size of internal memory address
+  * @param  pData Pointer to data buffer
+  * @param  Size Amount of data to be received
+  * @param  Budget Status register polls allowed per bus event, see HAL_I2CEX_FAST_BUDGET()
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2CEx_FastRead(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                     uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Budget)
+{
+  I2C_TypeDef *i2c = hi2c->Instance;
+  HAL_StatusTypeDef status;
+  uint32_t critical;
+
+  assert_param(IS_I2C_MEMADD_SIZE(MemAddSize));
+
+  if ((pData == NULL) || (Size == 0U) || (Budget == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(hi2c);
+
+  hi2c->State     = HAL_I2C_STATE_BUSY_RX;
+  hi2c->Mode      = HAL_I2C_MODE_MEM;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+  /* Memory address, then repeated start in read direction */
+  status = I2CEx_FastStart(hi2c, DevAddress, MemAddress, MemAddSize, Budget);
+  if (status == HAL_OK)
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_TXE, Budget);
+  }
+  if (status == HAL_OK)
+  {
+    SET_BIT(i2c->CR1, I2C_CR1_START);
+    status = I2CEx_FastWait(hi2c, I2C_SR1_SB, Budget);
+  }
+  if (status == HAL_OK)
+  {
+    i2c->DR = I2C_7BIT_ADD_READ(DevAddress);
+    status = I2CEx_FastWait(hi2c, I2C_SR1_ADDR, Budget);
+  }
+  if (status != HAL_OK)
+  {
+    return I2CEx_FastAbort(hi2c, status);
+  }
+
+  if (Size == 1U)
+  {
+    /* NACK and stop set while the byte is received */
+    CLEAR_BIT(i2c->CR1, I2C_CR1_ACK);
+    critical = HAL_EnterCritical();
+    __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
+    SET_BIT(i2c->CR1, I2C_CR1_STOP);
+    HAL_ExitCritical(critical);
+  }
+  else if (Size == 2U)
+  {
+    /* NACK applies to the byte after the one being received */
+    CLEAR_BIT(i2c->CR1, I2C_CR1_ACK);
+    SET_BIT(i2c->CR1, I2C_CR1_POS);
+    critical = HAL_EnterCritical();
+    __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
+    HAL_ExitCritical(critical);
+  }
+  else
+  {
+    SET_BIT(i2c->CR1, I2C_CR1_ACK);
+    __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
+  }
+
+  while ((status == HAL_OK) && (Size > 3U))
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_RXNE, Budget);
+    if (status == HAL_OK)
+    {
+      *pData = (uint8_t)i2c->DR;
+      pData++;
+      Size--;
+    }
+  }
+  if ((status == HAL_OK) && (Size == 3U))
+  {
+    /* Byte N-2 in DR, byte N-1 in the shift register: NACK byte N */
+    status = I2CEx_FastWait(hi2c, I2C_SR1_BTF, Budget);
+    if (status == HAL_OK)
+    {
+      CLEAR_BIT(i2c->CR1, I2C_CR1_ACK);
+      *pData = (uint8_t)i2c->DR;
+      pData++;
+      Size--;
+    }
+  }
+  if ((status == HAL_OK) && (Size == 2U))
+  {
+    /* Byte N-1 in DR, byte N in the shift register */
+    status = I2CEx_FastWait(hi2c, I2C_SR1_BTF, Budget);
+    if (status == HAL_OK)
+    {
+      critical = HAL_EnterCritical();
+      SET_BIT(i2c->CR1, I2C_CR1_STOP);
+      *pData = (uint8_t)i2c->DR;
+      pData++;
+      Size--;
+      HAL_ExitCritical(critical);
+    }
+  }
+  if ((status == HAL_OK) && (Size == 1U))
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_RXNE, Budget);
+    if (status == HAL_OK)
+    {
+      *pData = (uint8_t)i2c->DR;
+    }
+  }
+  if (status != HAL_OK)
+  {
+    return I2CEx_FastAbort(hi2c, status);
+  }
+
+  CLEAR_BIT(i2c->CR1, I2C_CR1_POS);
+
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->Mode  = HAL_I2C_MODE_NONE;
+
+  __HAL_UNLOCK(hi2c);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup I2CEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Find the smallest CCR of a waveform within the bus constraints.
+  * @param  pWave Waveform tried.
+  * @param  Period Shortest SCL period allowed, PCLK1 cycles.
+  * @param  Rise SCL rise time, PCLK1 cycles.
+  * @param  Fall SCL fall time, PCLK1 cycles.
+  * @param  LowMin tLOW minimum, PCLK1 cycles.
+  * @param  HighMin tHIGH minimum, PCLK1 cycles.
+  * @retval CCR value, 0 when none fits the CCR field
+  */
+static uint32_t I2CEx_FitWave(const I2CEx_WaveTypeDef *pWave, uint32_t Period, uint32_t Rise, uint32_t Fall,
+                              uint32_t LowMin, uint32_t HighMin)
+{
+  uint32_t ccr = pWave->CCRMin;
+  uint32_t units = pWave->Low + pWave->High;
+  uint32_t min;
+
+  if (Period > Rise)
+  {
+    min = ((Period - Rise) + units - 1U) / units;
+    ccr = (min > ccr) ? min : ccr;
+  }
+  min = ((LowMin + Fall) + pWave->Low - 1U) / pWave->Low;
+  ccr = (min > ccr) ? min : ccr;
+  min = (HighMin + pWave->High - 1U) / pWave->High;
+  ccr = (min > ccr) ? min : ccr;
+
+  return (ccr > I2C_CCR_CCR) ? 0U : ccr;
+}
+
+/**
+  * @brief  Wait for an event flag of a fast transfer.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  Flag SR1 event flag.
+  * @param  Budget Status register polls allowed.
+  * @retval HAL status, HAL_ERROR on a bus error, HAL_TIMEOUT when the budget expires
+  */
+static HAL_StatusTypeDef I2CEx_FastWait(I2C_HandleTypeDef *hi2c, uint32_t Flag, uint32_t Budget)
+{
+  uint32_t sr1;
+
+  do
+  {
+    sr1 = hi2c->Instance->SR1;
+    if ((sr1 & Flag) != 0U)
+    {
+      return HAL_OK;
+    }
+    if ((sr1 & I2CEX_SR1_ERRORS) != 0U)
+    {
+      hi2c->ErrorCode |= (((sr1 & I2C_SR1_BERR) != 0U) ? HAL_I2C_ERROR_BERR : 0U) |
+                         (((sr1 & I2C_SR1_ARLO) != 0U) ? HAL_I2C_ERROR_ARLO : 0U) |
+                         (((sr1 & I2C_SR1_AF)   != 0U) ? HAL_I2C_ERROR_AF   : 0U);
+      return HAL_ERROR;
+    }
+    Budget--;
+  } while (Budget != 0U);
+
+  hi2c->ErrorCode |= HAL_I2C_ERROR_TIMEOUT;
+
+  return HAL_TIMEOUT;
+}
+
+/**
+  * @brief  Address a device in write direction and send the memory address.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  DevAddress Target device address
+  * @param  MemAddress Internal memory address
+  * @param  MemAddSize Size of internal memory address
+  * @param  Budget Status register polls allowed per bus event.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef I2CEx_FastStart(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                         uint16_t MemAddSize, uint32_t Budget)
+{
+  I2C_TypeDef *i2c = hi2c->Instance;
+  HAL_StatusTypeDef status;
+  uint32_t budget = Budget;
+
+  while ((i2c->SR2 & I2C_SR2_BUSY) != 0U)
+  {
+    budget--;
+    if (budget == 0U)
+    {
+      hi2c->ErrorCode |= HAL_I2C_ERROR_TIMEOUT;
+      return HAL_TIMEOUT;
+    }
+  }
+
+  CLEAR_BIT(i2c->CR1, I2C_CR1_POS);
+  SET_BIT(i2c->CR1, I2C_CR1_START);
+  status = I2CEx_FastWait(hi2c, I2C_SR1_SB, Budget);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  i2c->DR = I2C_7BIT_ADD_WRITE(DevAddress);
+  status = I2CEx_FastWait(hi2c, I2C_SR1_ADDR, Budget);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+  __HAL_I2C_CLEAR_ADDRFLAG(hi2c);
+
+  if (MemAddSize == I2C_MEMADD_SIZE_16BIT)
+  {
+    status = I2CEx_FastWait(hi2c, I2C_SR1_TXE, Budget);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+    i2c->DR = I2C_MEM_ADD_MSB(MemAddress);
+  }
+  status = I2CEx_FastWait(hi2c, I2C_SR1_TXE, Budget);
+  if (status == HAL_OK)
+  {
+    i2c->DR = I2C_MEM_ADD_LSB(MemAddress);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End a failed fast transfer.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *         the configuration information for the specified I2C.
+  * @param  Status Status of the failed step.
+  * @retval Status
+  */
+static HAL_StatusTypeDef I2CEx_FastAbort(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef Status)
+{
+  I2C_TypeDef *i2c = hi2c->Instance;
+
+  /* The bus belongs to the other master after an arbitration loss */
+  if ((hi2c->ErrorCode & HAL_I2C_ERROR_ARLO) == 0U)
+  {
+    SET_BIT(i2c->CR1, I2C_CR1_STOP);
+  }
+  CLEAR_BIT(i2c->CR1, (I2C_CR1_ACK | I2C_CR1_POS));
+  WRITE_REG(i2c->SR1, ~I2CEX_SR1_ERRORS & I2C_FLAG_MASK);
+
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->Mode  = HAL_I2C_MODE_NONE;
+
+  __HAL_UNLOCK(hi2c);
+
+  return Status;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2C_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
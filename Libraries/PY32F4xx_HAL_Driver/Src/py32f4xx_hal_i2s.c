@@ -1272,6 +1272,49 @@ HAL_StatusTypeDef HAL_I2S_Receive_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData,
   return HAL_OK;
 }
 
+/**
+  * @brief  Receive audio data continuously in DMA mode into a ring buffer.
+  * @note   The Rx DMA handle must be initialized in DMA_CIRCULAR mode with half
+  *         word memory accesses. Received samples are read in place with
+  *         HAL_DMAEx_RingAcquire() and released with HAL_DMAEx_RingCommit(),
+  *         the reception runs until HAL_I2S_DMAStop() is called.
+  * @note   With the 24-bit or 32-bit data formats the ring size must be a
+  *         multiple of 4 bytes.
+  * @param  hi2s pointer to a I2S_HandleTypeDef structure that contains
+  *         the configuration information for I2S module
+  * @param  pRing Ring buffer initialized with HAL_DMAEx_RingInit().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2S_ReceiveToRing_DMA(I2S_HandleTypeDef *hi2s, DMA_RingTypeDef *pRing)
+{
+  uint32_t tmpreg_cfgr;
+  uint32_t size;
+
+  if (hi2s->State != HAL_I2S_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_DMAEx_RingAttach(pRing, hi2s->hdmarx) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* HAL_I2S_Receive_DMA() counts 24-bit and 32-bit samples as two half words */
+  size = pRing->Items;
+  tmpreg_cfgr = hi2s->Instance->I2SCFGR & (SPI_I2SCFGR_DATLEN | SPI_I2SCFGR_CHLEN);
+  if ((tmpreg_cfgr == I2S_DATAFORMAT_24B) || (tmpreg_cfgr == I2S_DATAFORMAT_32B))
+  {
+    if ((size & 1U) != 0U)
+    {
+      return HAL_ERROR;
+    }
+    size >>= 1U;
+  }
+
+  return HAL_I2S_Receive_DMA(hi2s, (uint16_t *)pRing->pBuffer, (uint16_t)size);
+}
+
 /**
   * @brief  Pauses the audio DMA Stream/Channel playing from the Media.
   * @param  hi2s pointer to a I2S_HandleTypeDef structure that contains
@@ -1789,6 +1832,8 @@ static HAL_StatusTypeDef I2S_WaitFlagStateUntilTimeout(I2S_HandleTypeDef *hi2s,
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(tickstart);
   }
   return HAL_OK;
 }
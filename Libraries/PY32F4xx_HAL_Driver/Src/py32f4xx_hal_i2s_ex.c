@@ -0,0 +1,368 @@
+/**
+  ******************************************************************************
+  * @file    py32f4xx_hal_i2s_ex.c
+  * @author  MCU Application Team
+  * @brief   Extended I2S HAL module driver.
+  *          This file provides firmware functions to manage the following
+  *          I2S peripheral extended functionalities :
+  *           + Clock functions
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "py32f4xx_hal.h"
+
+/** @addtogroup PY32F4xx_HAL_Driver
+  * @{
+  */
+
+/** @defgroup I2SEx I2SEx
+  * @brief I2S Extended HAL module driver
+  * @{
+  */
+#ifdef HAL_I2S_MODULE_ENABLED
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/** @defgroup I2SEx_Private_Constants I2SEx Private Constants
+  * @{
+  */
+#define I2SEX_PLL_MUL_MIN         2U          /* RCC_PLL_MUL2                     */
+#define I2SEX_PLL_MUL_MAX         63U         /* RCC_PLL_MUL63                    */
+#define I2SEX_DIVIDER_MIN         4U          /* 2 x I2SDIV + ODD, I2SDIV of 2    */
+#define I2SEX_DIVIDER_MAX         511U        /* 2 x I2SDIV + ODD, I2SDIV of 255  */
+#define I2SEX_PLLSOURCE_ALL       (I2SEX_PLLSOURCE_HSE | I2SEX_PLLSOURCE_HSE_DIV2 | I2SEX_PLLSOURCE_HSI)
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/** @defgroup I2SEx_Private_Macros I2SEx Private Macros
+  * @{
+  */
+#define I2SEX_ABS(__VALUE__)      (((__VALUE__) < 0) ? -(__VALUE__) : (__VALUE__))
+/**
+  * @}
+  */
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/** @defgroup I2SEx_Private_Functions I2SEx Private Functions
+  * @{
+  */
+static uint32_t I2SEx_GetFrameFactor(const I2S_ClockConfigTypeDef *pConfig);
+static uint32_t I2SEx_IsBetter(const I2S_ClockConfigTypeDef *pConfig, uint32_t SysClk, int64_t Error,
+                               const I2S_ClockTypeDef *pBest);
+/**
+  * @}
+  */
+
+/* Exported functions --------------------------------------------------------*/
+
+/** @defgroup I2SEx_Exported_Functions I2SEx Exported Functions
+  * @{
+  */
+
+/** @defgroup I2SEx_Exported_Functions_Group1 Clock functions
+  *  @brief   Sample rate clock functions
+  *
+@verbatim
+  ==============================================================================
+                      ##### Clock functions #####
+ ===============================================================================
+ [..]
+    This subsection provides a set of extended functions to run the I2S at an
+    exact sample rate with the fastest CPU the sample rate allows.
+
+    (#) The I2S kernel clock of this device is SYSCLK, there is no separate
+        audio PLL: the sample rate is SYSCLK / (F x (2 x I2SDIV + ODD)), F
+        being 256 with the master clock output and the frame length in bits
+        otherwise, 128 in PCM. HAL_I2S_Init() rounds the divider for the
+        running SYSCLK, which misses 48 kHz by 2.3 % at 144 MHz with the
+        master clock output.
+
+    (#) HAL_I2SEx_CalcClock() searches the PLL entry clocks allowed by the
+        PLLSources field, HSE, HSE / 2 or HSI, the PLL multiplication factors
+        and the dividers, within the SysClkMin and SysClkMax bounds:
+        (++) Among the settings whose error is at most the Tolerance, the
+             fastest SYSCLK is kept, then the smallest error.
+        (++) Without any such setting, the smallest error is kept, then the
+             fastest SYSCLK.
+        (++) SysClkMax defaults to I2SEX_SYSCLK_MAX, the highest frequency of
+             the flash latency table. The HSI accuracy, 1 %, is not part of
+             the error: prefer a crystal for audio.
+
+    (#) HAL_I2SEx_ConfigSysClock() moves SYSCLK to the computed PLL setting:
+        SYSCLK goes through HSI while the PLL is locked again, then comes back
+        to the PLL with the AHB and APB dividers of the given configuration
+        and the wait states of the new HCLK. A HSE source must be running.
+        Clocks derived from SYSCLK change: UART, timer and SPI settings made
+        before are to be made again.
+
+    (#) HAL_I2SEx_ConfigPrescaler() applies the computed divider to an I2S
+        initialized by HAL_I2S_Init() and not yet started, and updates the
+        AudioFreq of its Init structure.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Compute the PLL and the I2S divider closest to a sample rate.
+  * @param  pConfig Stream and clock tree description.
+  * @param  pClock Computed clock.
+  * @retval HAL status, HAL_ERROR when no SYSCLK falls within the bounds
+  */
+HAL_StatusTypeDef HAL_I2SEx_CalcClock(const I2S_ClockConfigTypeDef *pConfig, I2S_ClockTypeDef *pClock)
+{
+  uint32_t sources[3];
+  uint32_t entries[3];
+  uint32_t sysclkmax;
+  uint32_t factor;
+  uint32_t period;
+  uint32_t sysclk;
+  uint32_t divider;
+  uint32_t index;
+  uint32_t mul;
+  uint32_t found = 0U;
+  int64_t  error;
+
+  if ((pConfig == NULL) || (pClock == NULL) || (!IS_I2S_AUDIO_FREQ(pConfig->AudioFreq)) ||
+      (pConfig->AudioFreq == I2S_AUDIOFREQ_DEFAULT) || (!IS_I2S_STANDARD(pConfig->Standard)) ||
+      (!IS_I2S_DATA_FORMAT(pConfig->DataFormat)) || (!IS_I2S_MCLK_OUTPUT(pConfig->MCLKOutput)) ||
+      ((pConfig->PLLSources & I2SEX_PLLSOURCE_ALL) == 0U) || ((pConfig->PLLSources & ~I2SEX_PLLSOURCE_ALL) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  sysclkmax = (pConfig->SysClkMax == 0U) ? I2SEX_SYSCLK_MAX : pConfig->SysClkMax;
+  if ((pConfig->SysClkMin > sysclkmax) || (sysclkmax > I2SEX_SYSCLK_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  sources[0] = RCC_PLLSOURCE_HSE;
+  entries[0] = ((pConfig->PLLSources & I2SEX_PLLSOURCE_HSE) != 0U) ? HSE_VALUE : 0U;
+  sources[1] = RCC_PLLSOURCE_HSE_DIV2;
+  entries[1] = ((pConfig->PLLSources & I2SEX_PLLSOURCE_HSE_DIV2) != 0U) ? (HSE_VALUE / 2U) : 0U;
+  sources[2] = RCC_PLLSOURCE_HSI;
+  entries[2] = ((pConfig->PLLSources & I2SEX_PLLSOURCE_HSI) != 0U) ? HSI_VALUE : 0U;
+
+  /* SYSCLK cycles of one sample at a divider of 1 */
+  factor = I2SEx_GetFrameFactor(pConfig);
+  period = factor * pConfig->AudioFreq;
+
+  for (index = 0U; index < 3U; index++)
+  {
+    for (mul = I2SEX_PLL_MUL_MIN; (entries[index] != 0U) && (mul <= I2SEX_PLL_MUL_MAX); mul++)
+    {
+      sysclk = entries[index] * mul;
+      if ((sysclk < pConfig->SysClkMin) || (sysclk > sysclkmax))
+      {
+        continue;
+      }
+
+      divider = (sysclk + (period / 2U)) / period;
+      if (divider < I2SEX_DIVIDER_MIN)
+      {
+        divider = I2SEX_DIVIDER_MIN;
+      }
+      else if (divider > I2SEX_DIVIDER_MAX)
+      {
+        divider = I2SEX_DIVIDER_MAX;
+      }
+      error = (((int64_t)sysclk - ((int64_t)period * divider)) * 1000000000) / ((int64_t)period * divider);
+
+      if ((found == 0U) || (I2SEx_IsBetter(pConfig, sysclk, error, pClock) != 0U))
+      {
+        found = 1U;
+        pClock->PLL.PLLState  = RCC_PLL_ON;
+        pClock->PLL.PLLSource = sources[index];
+        pClock->PLL.PLLMUL    = RCC_PLL_MUL_FACTOR(mul);
+        pClock->SysClkFreq    = sysclk;
+        pClock->I2SPR         = (divider >> 1U) | ((divider & 1U) << SPI_I2SPR_ODD_Pos) | pConfig->MCLKOutput;
+        pClock->AudioFreq     = (uint32_t)((((uint64_t)sysclk * 1000U) + ((factor * divider) / 2U)) /
+                                           (factor * divider));
+        pClock->Error         = (int32_t)error;
+      }
+    }
+  }
+
+  return (found != 0U) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Move SYSCLK to a PLL setting computed by HAL_I2SEx_CalcClock().
+  * @note   The HSI must be enabled, it clocks the device while the PLL locks.
+  * @param  pClock Clock to apply.
+  * @param  pClkInit AHB and APB dividers to use with the new SYSCLK, the
+  *         ClockType and SYSCLKSource fields are not used.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2SEx_ConfigSysClock(const I2S_ClockTypeDef *pClock, const RCC_ClkInitTypeDef *pClkInit)
+{
+  RCC_OscInitTypeDef oscinit = {0};
+  RCC_ClkInitTypeDef clkinit = {0};
+  HAL_StatusTypeDef status;
+
+  if ((pClock == NULL) || (pClkInit == NULL) || (pClock->PLL.PLLState != RCC_PLL_ON))
+  {
+    return HAL_ERROR;
+  }
+  if ((pClock->PLL.PLLSource != RCC_PLLSOURCE_HSI) && (__HAL_RCC_GET_FLAG(RCC_FLAG_HSERDY) == RESET))
+  {
+    return HAL_ERROR;
+  }
+  if (__HAL_RCC_GET_FLAG(RCC_FLAG_HSIRDY) == RESET)
+  {
+    return HAL_ERROR;
+  }
+
+  /* The PLL cannot be configured while it clocks the device */
+  if (__HAL_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+  {
+    clkinit.ClockType    = RCC_CLOCKTYPE_SYSCLK;
+    clkinit.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+    status = HAL_RCC_ClockConfig(&clkinit, FLASH_LATENCY_AUTO);
+    if (status != HAL_OK)
+    {
+      return status;
+    }
+  }
+
+  oscinit.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+  oscinit.PLL            = pClock->PLL;
+  status = HAL_RCC_OscConfig(&oscinit);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  clkinit                = *pClkInit;
+  clkinit.ClockType      = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  clkinit.SYSCLKSource   = RCC_SYSCLKSOURCE_PLLCLK;
+
+  return HAL_RCC_ClockConfig(&clkinit, FLASH_LATENCY_AUTO);
+}
+
+/**
+  * @brief  Apply the I2S divider of a clock computed by HAL_I2SEx_CalcClock().
+  * @note   SYSCLK must run at the computed frequency, HAL_I2SEx_ConfigSysClock().
+  * @param  hi2s Pointer to a I2S_HandleTypeDef structure that contains
+  *         the configuration information for I2S module.
+  * @param  pClock Clock to apply.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2SEx_ConfigPrescaler(I2S_HandleTypeDef *hi2s, const I2S_ClockTypeDef *pClock)
+{
+  if ((hi2s == NULL) || (pClock == NULL) || ((pClock->I2SPR & SPI_I2SPR_MCKOE) != hi2s->Init.MCLKOutput))
+  {
+    return HAL_ERROR;
+  }
+  if ((hi2s->State != HAL_I2S_STATE_READY) || (READ_BIT(hi2s->Instance->I2SCFGR, SPI_I2SCFGR_I2SE) != 0U))
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(hi2s);
+
+  WRITE_REG(hi2s->Instance->I2SPR, pClock->I2SPR);
+  hi2s->Init.AudioFreq = (pClock->AudioFreq + 500U) / 1000U;
+
+  __HAL_UNLOCK(hi2s);
+
+  return HAL_OK;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/** @addtogroup I2SEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  SYSCLK cycles of one sample for a divider of 1, the F of the sample rate.
+  * @param  pConfig Stream description.
+  * @retval Factor, the same as the one of HAL_I2S_Init()
+  */
+static uint32_t I2SEx_GetFrameFactor(const I2S_ClockConfigTypeDef *pConfig)
+{
+  uint32_t packetlength = (pConfig->DataFormat == I2S_DATAFORMAT_16B) ? 16U : 32U;
+
+  /* Two channels per frame but in PCM */
+  if (pConfig->Standard <= I2S_STANDARD_LSB)
+  {
+    packetlength = packetlength * 2U;
+  }
+
+  if (pConfig->MCLKOutput == I2S_MCLKOUTPUT_ENABLE)
+  {
+    return (pConfig->DataFormat == I2S_DATAFORMAT_16B) ? (packetlength * 8U) : (packetlength * 4U);
+  }
+
+  return packetlength;
+}
+
+/**
+  * @brief  Compare a candidate setting with the best one found so far.
+  * @param  pConfig Tolerance of the search.
+  * @param  SysClk Candidate SYSCLK frequency.
+  * @param  Error Candidate sample rate error in ppb.
+  * @param  pBest Best setting.
+  * @retval 1 when the candidate is better, 0 otherwise
+  */
+static uint32_t I2SEx_IsBetter(const I2S_ClockConfigTypeDef *pConfig, uint32_t SysClk, int64_t Error,
+                               const I2S_ClockTypeDef *pBest)
+{
+  int64_t error = I2SEX_ABS(Error);
+  int64_t besterror = I2SEX_ABS((int64_t)pBest->Error);
+  uint32_t within = (error <= (int64_t)pConfig->Tolerance) ? 1U : 0U;
+  uint32_t bestwithin = (besterror <= (int64_t)pConfig->Tolerance) ? 1U : 0U;
+
+  if (within != bestwithin)
+  {
+    return within;
+  }
+  if (within != 0U)
+  {
+    return ((SysClk > pBest->SysClkFreq) || ((SysClk == pBest->SysClkFreq) && (error < besterror))) ? 1U : 0U;
+  }
+  return ((error < besterror) || ((error == besterror) && (SysClk > pBest->SysClkFreq))) ? 1U : 0U;
+}
+
+/**
+  * @}
+  */
+
+#endif /* HAL_I2S_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
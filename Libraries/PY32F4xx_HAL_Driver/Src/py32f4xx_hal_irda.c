@@ -2250,6 +2250,8 @@ static HAL_StatusTypeDef IRDA_WaitOnFlagUntilTimeout(IRDA_HandleTypeDef *hirda,
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -439,6 +439,10 @@ void HAL_PWR_EnterSLEEPMode(uint8_t SLEEPEntry)
   /* Clear SLEEPDEEP bit of Cortex System Control Register */
   CLEAR_BIT(SCB->SCR, ((uint32_t)SCB_SCR_SLEEPDEEP_Msk));
 
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+  HAL_PWR_EnterModeCallback(PWR_LOWPOWERMODE_SLEEP);
+#endif /* USE_HAL_PWR_MODE_HOOKS */
+
   /* Select SLEEP mode entry -------------------------------------------------*/
   if(SLEEPEntry == PWR_SLEEPENTRY_WFI)
   {
@@ -452,6 +456,10 @@ void HAL_PWR_EnterSLEEPMode(uint8_t SLEEPEntry)
     __WFE();
     __WFE();
   }
+
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+  HAL_PWR_ExitModeCallback(PWR_LOWPOWERMODE_SLEEP);
+#endif /* USE_HAL_PWR_MODE_HOOKS */
 }
 
 /**
@@ -485,6 +493,10 @@ void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
   /* Select the voltage regulator mode by setting LPDS bit in PWR register according to Regulator parameter value */
   MODIFY_REG(PWR->CR, PWR_CR_LPDS, Regulator);
 
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+  HAL_PWR_EnterModeCallback(PWR_LOWPOWERMODE_STOP);
+#endif /* USE_HAL_PWR_MODE_HOOKS */
+
   /* Set SLEEPDEEP bit of Cortex System Control Register */
   SET_BIT(SCB->SCR, ((uint32_t)SCB_SCR_SLEEPDEEP_Msk));
 
@@ -503,6 +515,10 @@ void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
   }
   /* Reset SLEEPDEEP bit of Cortex System Control Register */
   CLEAR_BIT(SCB->SCR, ((uint32_t)SCB_SCR_SLEEPDEEP_Msk));
+
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+  HAL_PWR_ExitModeCallback(PWR_LOWPOWERMODE_STOP);
+#endif /* USE_HAL_PWR_MODE_HOOKS */
 }
 
 /**
@@ -608,6 +624,38 @@ __weak void HAL_PWR_PVDCallback(void)
    */ 
 }
 
+#if (USE_HAL_PWR_MODE_HOOKS == 1U)
+/**
+  * @brief  Low power mode entry hook, just before WFI or WFE.
+  * @param  Mode A value of @ref PWR_Low_Power_Mode.
+  * @retval None
+  */
+__weak void HAL_PWR_EnterModeCallback(uint32_t Mode)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(Mode);
+
+  /* NOTE : This function Should not be modified, when the callback is needed,
+            the HAL_PWR_EnterModeCallback could be implemented in the user file
+   */
+}
+
+/**
+  * @brief  Low power mode exit hook, on the wakeup, on HSI after the STOP mode.
+  * @param  Mode A value of @ref PWR_Low_Power_Mode.
+  * @retval None
+  */
+__weak void HAL_PWR_ExitModeCallback(uint32_t Mode)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(Mode);
+
+  /* NOTE : This function Should not be modified, when the callback is needed,
+            the HAL_PWR_ExitModeCallback could be implemented in the user file
+   */
+}
+#endif /* USE_HAL_PWR_MODE_HOOKS */
+
 /**
   * @}
   */
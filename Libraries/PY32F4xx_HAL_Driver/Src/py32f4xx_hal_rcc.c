@@ -80,6 +80,8 @@
 /** @defgroup RCC_Private_Constants RCC Private Constants
  * @{
  */
+#define RCC_FLASH_LATENCY_STEP    24000000U  /* HCLK range of one FLASH wait state in voltage scale 1,
+                                                FLASH_LATENCY_5 up to 144 MHz */
 /**
   * @}
   */
@@ -106,6 +108,8 @@
 
 /* Private function prototypes -----------------------------------------------*/
 static void RCC_Delay(uint32_t mdelay);
+static uint32_t RCC_GetPLLClockFreq(void);
+static uint32_t RCC_GetTargetHCLKFreq(const RCC_ClkInitTypeDef *RCC_ClkInitStruct);
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -704,7 +708,9 @@ HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef  *RCC_OscInitStruct)
   * @param  RCC_ClkInitStruct pointer to an RCC_OscInitTypeDef structure that
   *         contains the configuration information for the RCC peripheral.
   * @param  FLatency FLASH Latency
-  *          The value of this parameter depend on device used within the same series
+  *          The value of this parameter depend on device used within the same series,
+  *          FLASH_LATENCY_AUTO selects the fewest wait states for the new HCLK,
+  *          see @ref HAL_RCC_GetFlashLatency()
   * @note   The SystemCoreClock CMSIS variable is used to store System Clock Frequency
   *         and updated by @ref HAL_RCC_GetHCLKFreq() function called within this function
   *
@@ -733,11 +739,15 @@ HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef  *RCC_ClkInitStruct, ui
 
   /* Check the parameters */
   assert_param(IS_RCC_CLOCKTYPE(RCC_ClkInitStruct->ClockType));
-  assert_param(IS_FLASH_LATENCY(FLatency));
+  assert_param((FLatency == FLASH_LATENCY_AUTO) || IS_FLASH_LATENCY(FLatency));
 
   /* To correctly read data from FLASH memory, the number of wait states (LATENCY)
   must be correctly programmed according to the frequency of the CPU clock
     (HCLK) of the device. */
+  if (FLatency == FLASH_LATENCY_AUTO)
+  {
+    FLatency = HAL_RCC_GetFlashLatency(RCC_GetTargetHCLKFreq(RCC_ClkInitStruct));
+  }
 
 #if defined(FLASH_ACR_LATENCY)
   /* Increasing the number of wait states because of higher CPU frequency */
@@ -988,20 +998,10 @@ void HAL_RCC_DisableCSS(void)
   */
 uint32_t HAL_RCC_GetSysClockFreq(void)
 {
-
-  const uint8_t aPLLMULFactorTable[64] = {2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, \
-                                          18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, \
-                                          34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, \
-                                          50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 63, 63};
-  const uint8_t aPredivFactorTable[2] = {1, 2};
-
-  uint32_t tmpreg = 0U, prediv = 0U, pllclk = 0U, pllmul = 0U;
   uint32_t sysclockfreq = 0U;
 
-  tmpreg = RCC->CFGR;
-
   /* Get SYSCLK source -------------------------------------------------------*/
-  switch (tmpreg & RCC_CFGR_SWS)
+  switch (RCC->CFGR & RCC_CFGR_SWS)
   {
     case RCC_SYSCLKSOURCE_STATUS_HSE:  /* HSE used as system clock */
     {
@@ -1010,22 +1010,7 @@ uint32_t HAL_RCC_GetSysClockFreq(void)
     }
     case RCC_SYSCLKSOURCE_STATUS_PLLCLK:  /* PLL used as system clock */
     {
-      pllmul = aPLLMULFactorTable[(((tmpreg&(RCC_CFGR_PLLMULL_4|RCC_CFGR_PLLMULL_5))>>7) | (tmpreg&(RCC_CFGR_PLLMULL_0| \
-                                     RCC_CFGR_PLLMULL_1|RCC_CFGR_PLLMULL_2|RCC_CFGR_PLLMULL_3)))>>RCC_CFGR_PLLMULL_Pos];
-      
-      if ((((tmpreg & (RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE)) == RCC_PLLSOURCE_HSE) || ((tmpreg & (RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE)) == RCC_PLLSOURCE_HSE_DIV2)))
-      {
-        prediv = aPredivFactorTable[(uint32_t)(RCC->CFGR & RCC_CFGR_PLLXTPRE) >> RCC_CFGR_PLLXTPRE_Pos];
-        
-        /* HSE used as PLL clock source : PLLCLK = HSE/PREDIV1 * PLLMUL */
-        pllclk = (uint32_t)((HSE_VALUE  * pllmul) / prediv);
-      }
-      else
-      {
-        /* HSI used as PLL clock source : PLLCLK = HSI * PLLMUL */
-        pllclk = (uint32_t)(HSI_VALUE * pllmul);
-      }
-      sysclockfreq = pllclk;
+      sysclockfreq = RCC_GetPLLClockFreq();
       break;
     }
     case RCC_SYSCLKSOURCE_STATUS_HSI:  /* HSI used as system clock source */
@@ -1038,6 +1023,44 @@ uint32_t HAL_RCC_GetSysClockFreq(void)
   return sysclockfreq;
 }
 
+/**
+  * @brief  Returns the fewest FLASH wait states for an HCLK frequency
+  * @note   The voltage range is read as with HAL_PWREx_GetVoltageRange(). In
+  *         voltage scale 1, each wait state adds RCC_FLASH_LATENCY_STEP (24 MHz)
+  *         of HCLK; there is no FLASH_LATENCY_2, FLASH_LATENCY_3 is used
+  *         instead. The reduced voltage scales have no wait state figures,
+  *         FLASH_LATENCY_5 is returned for them.
+  * @note   The FLASH interface has no prefetch buffer nor cache to enable.
+  * @param  HCLKFreq HCLK frequency in Hz
+  * @retval FLASH latency, a value of @ref FLASH_Latency
+  */
+uint32_t HAL_RCC_GetFlashLatency(uint32_t HCLKFreq)
+{
+  uint32_t waitstates;
+
+  /* Reduced voltage scale, PWR_REGULATOR_VOLTAGE_SCALE1 is 0 */
+  if (READ_BIT(PWR->CR, PWR_CR_VOS) != 0U)
+  {
+    return FLASH_LATENCY_5;
+  }
+
+  waitstates = (HCLKFreq == 0U) ? 0U : ((HCLKFreq - 1U) / RCC_FLASH_LATENCY_STEP);
+  switch (waitstates)
+  {
+    case 0U:
+      return FLASH_LATENCY_0;
+    case 1U:
+      return FLASH_LATENCY_1;
+    case 2U:
+    case 3U:
+      return FLASH_LATENCY_3;
+    case 4U:
+      return FLASH_LATENCY_4;
+    default:
+      return FLASH_LATENCY_5;
+  }
+}
+
 /**
   * @brief  Returns the HCLK frequency
   * @note   Each time HCLK changes, this function must be called to update the
@@ -1237,6 +1260,79 @@ static void RCC_Delay(uint32_t mdelay)
   while (Delay --);
 }
 
+/**
+  * @brief  Returns the PLL output frequency from its configuration
+  * @retval PLLCLK frequency
+  */
+static uint32_t RCC_GetPLLClockFreq(void)
+{
+  const uint8_t aPLLMULFactorTable[64] = {2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, \
+                                          18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, \
+                                          34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, \
+                                          50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 63, 63};
+  const uint8_t aPredivFactorTable[2] = {1, 2};
+
+  uint32_t tmpreg = 0U, prediv = 0U, pllclk = 0U, pllmul = 0U;
+
+  tmpreg = RCC->CFGR;
+
+  pllmul = aPLLMULFactorTable[(((tmpreg&(RCC_CFGR_PLLMULL_4|RCC_CFGR_PLLMULL_5))>>7) | (tmpreg&(RCC_CFGR_PLLMULL_0| \
+                                 RCC_CFGR_PLLMULL_1|RCC_CFGR_PLLMULL_2|RCC_CFGR_PLLMULL_3)))>>RCC_CFGR_PLLMULL_Pos];
+
+  if ((((tmpreg & (RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE)) == RCC_PLLSOURCE_HSE) || ((tmpreg & (RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE)) == RCC_PLLSOURCE_HSE_DIV2)))
+  {
+    prediv = aPredivFactorTable[(uint32_t)(RCC->CFGR & RCC_CFGR_PLLXTPRE) >> RCC_CFGR_PLLXTPRE_Pos];
+
+    /* HSE used as PLL clock source : PLLCLK = HSE/PREDIV1 * PLLMUL */
+    pllclk = (uint32_t)((HSE_VALUE  * pllmul) / prediv);
+  }
+  else
+  {
+    /* HSI used as PLL clock source : PLLCLK = HSI * PLLMUL */
+    pllclk = (uint32_t)(HSI_VALUE * pllmul);
+  }
+
+  return pllclk;
+}
+
+/**
+  * @brief  Returns the HCLK frequency HAL_RCC_ClockConfig() is about to set
+  * @param  RCC_ClkInitStruct pointer to the new clock configuration
+  * @retval HCLK frequency
+  */
+static uint32_t RCC_GetTargetHCLKFreq(const RCC_ClkInitTypeDef *RCC_ClkInitStruct)
+{
+  uint32_t sysclockfreq;
+  uint32_t hpre = RCC->CFGR & RCC_CFGR_HPRE;
+
+  if (((RCC_ClkInitStruct->ClockType) & RCC_CLOCKTYPE_SYSCLK) == RCC_CLOCKTYPE_SYSCLK)
+  {
+    if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_HSE)
+    {
+      sysclockfreq = HSE_VALUE;
+    }
+    else if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK)
+    {
+      sysclockfreq = RCC_GetPLLClockFreq();
+    }
+    else
+    {
+      sysclockfreq = HSI_VALUE;
+    }
+  }
+  else
+  {
+    sysclockfreq = HAL_RCC_GetSysClockFreq();
+  }
+
+  if (((RCC_ClkInitStruct->ClockType) & RCC_CLOCKTYPE_HCLK) == RCC_CLOCKTYPE_HCLK)
+  {
+    hpre = RCC_ClkInitStruct->AHBCLKDivider & RCC_CFGR_HPRE;
+  }
+
+  return sysclockfreq >> AHBPrescTable[hpre >> RCC_CFGR_HPRE_Pos];
+}
+
 /**
   * @brief  RCC Clock Security System interrupt callback
   * @retval none
@@ -7,6 +7,7 @@
   *          functionalities RCC extended peripheral:
   *           + Extended Peripheral Control functions
   *           + Extended Clock management functions
+  *           + Clock tree functions
   *
   ******************************************************************************
   * @attention
@@ -44,6 +45,11 @@
 /** @defgroup RCCEx_Private_Constants RCCEx Private Constants
   * @{
   */
+#define RCCEX_PLL_FACTOR_MIN      2U          /* RCC_PLL_MUL2                     */
+#define RCCEX_PLL_FACTOR_MAX      63U         /* RCC_PLL_MUL63                    */
+#define RCCEX_CAN_DIVIDER_MAX     8U          /* RCC_CANCLKSOURCE_PLL_DIV8        */
+#define RCCEX_USB_FREQ            48000000U   /* USB clock                        */
+#define RCCEX_CLOCKTREE_SOURCE_ALL (RCC_CLOCKTREE_SOURCE_HSE | RCC_CLOCKTREE_SOURCE_HSE_DIV2 | RCC_CLOCKTREE_SOURCE_HSI)
 /**
   * @}
   */
@@ -58,6 +64,16 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+/** @defgroup RCCEx_Private_Functions RCCEx Private Functions
+  * @{
+  */
+static uint32_t RCCEx_CalcApbDivider(uint32_t HCLKFreq, uint32_t Max, uint32_t Multiple);
+static uint32_t RCCEx_CalcUsbSource(uint32_t PLLFreq);
+static uint32_t RCCEx_CalcCanSource(const RCC_ClockTreeConfigTypeDef *pConfig, uint32_t PLLFreq);
+/**
+  * @}
+  */
+
 /* Private functions ---------------------------------------------------------*/
 
 /** @defgroup RCCEx_Exported_Functions RCCEx Exported Functions
@@ -244,7 +260,7 @@ void HAL_RCCEx_GetPeriphCLKConfig(RCC_PeriphCLKInitTypeDef  *PeriphClkInit)
 
   /* Get the USB clock configuration -----------------------------------------*/
   PeriphClkInit->PeriphClockSelection |= RCC_PERIPHCLK_USB;
-  if(READ_BIT(RCC->CFGR1,RCC_USBCLKSOURCE_HSI48M) != RCC_USBCLKSOURCE_HSI48M)
+  if(READ_BIT(RCC->CFGR1,RCC_CFGR1_USBSELHSI48) != RCC_CFGR1_USBSELHSI48)
   {
     PeriphClkInit->UsbClockSelection = __HAL_RCC_GET_USB_SOURCE();
   }
@@ -361,11 +377,11 @@ uint32_t HAL_RCCEx_GetPeriphCLKFreq(uint32_t PeriphClk)
       /* Get RCC CFGR1 configuration ------------------------------------------------------*/
       temp_reg = RCC->CFGR1;
       
-      if(((temp_reg & RCC_USBCLKSOURCE_HSI48M) == RCC_USBCLKSOURCE_HSI48M) && (HAL_IS_BIT_SET(RCC->CFGR1, RCC_CFGR1_HSI48RDY)))
+      if(((temp_reg & RCC_CFGR1_USBSELHSI48) == RCC_CFGR1_USBSELHSI48) && (HAL_IS_BIT_SET(RCC->CFGR1, RCC_CFGR1_HSI48RDY)))
       {
         frequency = HSI48_VALUE;
       }
-      else if(((temp_reg & RCC_USBCLKSOURCE_HSI48M) != RCC_USBCLKSOURCE_HSI48M) && (HAL_IS_BIT_SET(RCC->CR, RCC_CR_PLLRDY)))
+      else if(((temp_reg & RCC_CFGR1_USBSELHSI48) != RCC_CFGR1_USBSELHSI48) && (HAL_IS_BIT_SET(RCC->CR, RCC_CR_PLLRDY)))
       {
         tmpreg = RCC->CFGR;
         pllmul = aPLLMULFactorTable[(((tmpreg&(RCC_CFGR_PLLMULL_4|RCC_CFGR_PLLMULL_5))>>7) | (tmpreg&(RCC_CFGR_PLLMULL_0| \
@@ -481,6 +497,278 @@ uint32_t HAL_RCCEx_GetPeriphCLKFreq(uint32_t PeriphClk)
   return (frequency);
 }
 
+/**
+  * @}
+  */
+
+/** @defgroup RCCEx_Exported_Functions_Group2 Clock tree functions
+  *  @brief   Clock tree solver functions
+  *
+@verbatim
+ ===============================================================================
+                      ##### Clock tree functions #####
+ ===============================================================================
+    [..]
+    This subsection provides a function computing the fastest clock tree that
+    meets the constraints of the application, instead of a fixed PLL setting.
+
+    (#) HAL_RCCEx_CalcClockTree() tries the entry clocks allowed by PLLSources,
+        directly and through the PLL factors 2 to 63, within the SysClkMin and
+        SysClkMax bounds, HCLK being SYSCLK:
+        (++) Each APB takes the smallest divider keeping PCLK at most its Max
+             and a multiple of its Multiple: a UART is exact when PCLK is a
+             multiple of its baud rate, a CAN bit when PCLK1 is a multiple of
+             the bit rate times the time quanta of a bit.
+        (++) The USB clock is 48 MHz from the PLL divided by 1 to 4 in steps
+             of 0.5, or the HSI48M when RCC_CLOCKTREE_USB_PLL_OR_HSI48M allows.
+        (++) The CAN kernel clock is the PLL divided by 1 to 8, or the HSE.
+        (++) The fastest SYSCLK is kept, then a USB clock from the PLL, then
+             the HSE before the HSI.
+
+    (#) The result is ready for HAL_RCC_OscConfig(), HAL_RCC_ClockConfig() and
+        HAL_RCCEx_PeriphCLKConfig(). SYSCLK must not run from the PLL while
+        the PLL is configured again: switch to HSI first.
+
+    (#) At compile time, RCC_PLL_FACTOR_MAX() gives the factor of the fastest
+        SYSCLK of an entry clock and RCC_PLL_FACTOR_EXACT() checks an exact
+        one in a preprocessor condition, RCC_PLL_MUL_FACTOR() giving the
+        RCC_PLL_MULx value of the factor.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Compute the fastest clock tree meeting constraints.
+  * @param  pConfig Constraints of the clock tree.
+  * @param  pTree Clock tree computed.
+  * @retval HAL status, HAL_ERROR when no clock tree meets the constraints
+  */
+HAL_StatusTypeDef HAL_RCCEx_CalcClockTree(const RCC_ClockTreeConfigTypeDef *pConfig, RCC_ClockTreeTypeDef *pTree)
+{
+  const uint32_t aApbDivider[5] = {RCC_HCLK_DIV1, RCC_HCLK_DIV2, RCC_HCLK_DIV4, RCC_HCLK_DIV8, RCC_HCLK_DIV16};
+  uint32_t sources[3];
+  uint32_t entries[3];
+  uint32_t sysclkmax;
+  uint32_t sysclk;
+  uint32_t apb1;
+  uint32_t apb2;
+  uint32_t usb;
+  uint32_t can;
+  uint32_t index;
+  uint32_t factor;
+  uint32_t usbpll;
+  uint32_t bestusbpll = 0U;
+  uint32_t found = 0U;
+
+  if ((pConfig == NULL) || (pTree == NULL) || ((pConfig->PLLSources & RCCEX_CLOCKTREE_SOURCE_ALL) == 0U) ||
+      ((pConfig->PLLSources & ~RCCEX_CLOCKTREE_SOURCE_ALL) != 0U) ||
+      (pConfig->UsbClock > RCC_CLOCKTREE_USB_PLL_OR_HSI48M))
+  {
+    return HAL_ERROR;
+  }
+
+  sysclkmax = (pConfig->SysClkMax == 0U) ? RCC_SYSCLK_FREQ_MAX : pConfig->SysClkMax;
+  if ((pConfig->SysClkMin > sysclkmax) || (sysclkmax > RCC_SYSCLK_FREQ_MAX))
+  {
+    return HAL_ERROR;
+  }
+
+  sources[0] = RCC_PLLSOURCE_HSE;
+  entries[0] = ((pConfig->PLLSources & RCC_CLOCKTREE_SOURCE_HSE) != 0U) ? HSE_VALUE : 0U;
+  sources[1] = RCC_PLLSOURCE_HSE_DIV2;
+  entries[1] = ((pConfig->PLLSources & RCC_CLOCKTREE_SOURCE_HSE_DIV2) != 0U) ? (HSE_VALUE / 2U) : 0U;
+  sources[2] = RCC_PLLSOURCE_HSI;
+  entries[2] = ((pConfig->PLLSources & RCC_CLOCKTREE_SOURCE_HSI) != 0U) ? HSI_VALUE : 0U;
+
+  for (index = 0U; index < 3U; index++)
+  {
+    /* Factor 1 is the entry clock as SYSCLK, without the PLL */
+    for (factor = (index == 1U) ? RCCEX_PLL_FACTOR_MIN : 1U;
+         (entries[index] != 0U) && (factor <= RCCEX_PLL_FACTOR_MAX); factor++)
+    {
+      sysclk = entries[index] * factor;
+      if ((sysclk < pConfig->SysClkMin) || (sysclk > sysclkmax))
+      {
+        continue;
+      }
+
+      apb1 = RCCEx_CalcApbDivider(sysclk, pConfig->PCLK1Max, pConfig->PCLK1Multiple);
+      apb2 = RCCEx_CalcApbDivider(sysclk, pConfig->PCLK2Max, pConfig->PCLK2Multiple);
+      if ((apb1 > 4U) || (apb2 > 4U))
+      {
+        continue;
+      }
+
+      usb = RCC_USBCLKSOURCE_HSI48M;
+      usbpll = 0U;
+      if (pConfig->UsbClock != RCC_CLOCKTREE_USB_NONE)
+      {
+        usb = RCCEx_CalcUsbSource((factor > 1U) ? sysclk : 0U);
+        usbpll = (usb != RCC_USBCLKSOURCE_HSI48M) ? 1U : 0U;
+        if ((usbpll == 0U) && (pConfig->UsbClock == RCC_CLOCKTREE_USB_PLL))
+        {
+          continue;
+        }
+      }
+
+      can = RCC_CANCLKSOURCE_PLL;
+      if (pConfig->CanClockFreq != 0U)
+      {
+        can = RCCEx_CalcCanSource(pConfig, (factor > 1U) ? sysclk : 0U);
+        if (can == 0xFFFFFFFFU)
+        {
+          continue;
+        }
+      }
+
+      if ((found != 0U) && ((sysclk < pTree->SysClkFreq) ||
+                            ((sysclk == pTree->SysClkFreq) && (usbpll <= bestusbpll))))
+      {
+        continue;
+      }
+
+      found = 1U;
+      bestusbpll = usbpll;
+
+      pTree->OscInit.OscillatorType = (index == 2U) ? RCC_OSCILLATORTYPE_HSI : RCC_OSCILLATORTYPE_HSE;
+      pTree->OscInit.HSEState       = RCC_HSE_ON;
+      pTree->OscInit.HSEFreq        = (HSE_VALUE <= 6000000U)  ? RCC_HSE_4_6MHz :
+                                      (HSE_VALUE <= 8000000U)  ? RCC_HSE_4_8MHz :
+                                      (HSE_VALUE <= 16000000U) ? RCC_HSE_8_16MHz : RCC_HSE_16_32MHz;
+      pTree->OscInit.HSIState       = RCC_HSI_ON;
+      pTree->OscInit.HSI48MState    = RCC_HSI48M_ON;
+      pTree->OscInit.LSEState       = RCC_LSE_OFF;
+      pTree->OscInit.LSEDriver      = 0U;
+      pTree->OscInit.LSIState       = RCC_LSI_OFF;
+      pTree->OscInit.PLL.PLLState   = (factor > 1U) ? RCC_PLL_ON : RCC_PLL_NONE;
+      pTree->OscInit.PLL.PLLSource  = sources[index];
+      pTree->OscInit.PLL.PLLMUL     = (factor > 1U) ? RCC_PLL_MUL_FACTOR(factor) : 0U;
+
+      /* The HSE of the CAN kernel clock runs next to a PLL on HSI */
+      if ((pConfig->CanClockFreq != 0U) && (can == RCC_CANCLKSOURCE_HSE))
+      {
+        pTree->OscInit.OscillatorType |= RCC_OSCILLATORTYPE_HSE;
+      }
+      if ((pConfig->UsbClock != RCC_CLOCKTREE_USB_NONE) && (usbpll == 0U))
+      {
+        pTree->OscInit.OscillatorType |= RCC_OSCILLATORTYPE_HSI48M;
+      }
+
+      pTree->ClkInit.ClockType      = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+      pTree->ClkInit.SYSCLKSource   = (factor > 1U) ? RCC_SYSCLKSOURCE_PLLCLK :
+                                      ((index == 2U) ? RCC_SYSCLKSOURCE_HSI : RCC_SYSCLKSOURCE_HSE);
+      pTree->ClkInit.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+      pTree->ClkInit.APB1CLKDivider = aApbDivider[apb1];
+      pTree->ClkInit.APB2CLKDivider = aApbDivider[apb2];
+      pTree->FlashLatency           = FLASH_LATENCY_AUTO;
+
+      pTree->PeriphClkInit.PeriphClockSelection = 0U;
+      pTree->PeriphClkInit.RtcClockSelection    = 0U;
+      pTree->PeriphClkInit.AdcClockSelection    = 0U;
+      pTree->PeriphClkInit.UsbClockSelection    = usb;
+      pTree->PeriphClkInit.CanClockSelection    = can;
+      if (pConfig->UsbClock != RCC_CLOCKTREE_USB_NONE)
+      {
+        pTree->PeriphClkInit.PeriphClockSelection |= RCC_PERIPHCLK_USB;
+      }
+      if (pConfig->CanClockFreq != 0U)
+      {
+        pTree->PeriphClkInit.PeriphClockSelection |= RCC_PERIPHCLK_CAN;
+      }
+
+      pTree->SysClkFreq = sysclk;
+      pTree->PCLK1Freq  = sysclk >> apb1;
+      pTree->PCLK2Freq  = sysclk >> apb2;
+    }
+  }
+
+  return (found != 0U) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @}
+  */
+
+/** @addtogroup RCCEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Smallest APB divider meeting the constraints of a PCLK.
+  * @param  HCLKFreq HCLK frequency in Hz.
+  * @param  Max Highest PCLK in Hz, 0 for HCLK.
+  * @param  Multiple PCLK multiple of this frequency in Hz, 0 for any.
+  * @retval Divider as a shift, 0 to 4, 5 when none meets them
+  */
+static uint32_t RCCEx_CalcApbDivider(uint32_t HCLKFreq, uint32_t Max, uint32_t Multiple)
+{
+  uint32_t shift;
+  uint32_t pclk;
+
+  for (shift = 0U; shift <= 4U; shift++)
+  {
+    pclk = HCLKFreq >> shift;
+    if ((((HCLKFreq & ((1UL << shift) - 1U)) == 0U) || (Multiple == 0U)) &&
+        ((Max == 0U) || (pclk <= Max)) && ((Multiple == 0U) || ((pclk % Multiple) == 0U)))
+    {
+      break;
+    }
+  }
+
+  return shift;
+}
+
+/**
+  * @brief  USB prescaler of a PLL frequency giving 48 MHz.
+  * @param  PLLFreq PLL output in Hz, 0 when SYSCLK is not the PLL.
+  * @retval RCC_USBCLKSOURCE_PLLx value, RCC_USBCLKSOURCE_HSI48M when none gives it
+  */
+static uint32_t RCCEx_CalcUsbSource(uint32_t PLLFreq)
+{
+  /* PLL divided by 1 to 4 in steps of 0.5, indexed by twice the divider less 2 */
+  const uint32_t aUsbSource[7] = {RCC_USBCLKSOURCE_PLL, RCC_USBCLKSOURCE_PLL_DIV1_5, RCC_USBCLKSOURCE_PLL_DIV2,
+                                  RCC_USBCLKSOURCE_PLL_DIV2_5, RCC_USBCLKSOURCE_PLL_DIV3,
+                                  RCC_USBCLKSOURCE_PLL_DIV3_5, RCC_USBCLKSOURCE_PLL_DIV4};
+  uint32_t halves;
+
+  if ((PLLFreq == 0U) || (((2U * (uint64_t)PLLFreq) % RCCEX_USB_FREQ) != 0U))
+  {
+    return RCC_USBCLKSOURCE_HSI48M;
+  }
+
+  halves = (uint32_t)((2U * (uint64_t)PLLFreq) / RCCEX_USB_FREQ);
+
+  return ((halves >= 2U) && (halves <= 8U)) ? aUsbSource[halves - 2U] : RCC_USBCLKSOURCE_HSI48M;
+}
+
+/**
+  * @brief  CAN kernel clock source giving the frequency asked.
+  * @param  pConfig Constraints of the clock tree.
+  * @param  PLLFreq PLL output in Hz, 0 when SYSCLK is not the PLL.
+  * @retval RCC_CANCLKSOURCE_x value, 0xFFFFFFFF when none gives it
+  */
+static uint32_t RCCEx_CalcCanSource(const RCC_ClockTreeConfigTypeDef *pConfig, uint32_t PLLFreq)
+{
+  uint32_t divider;
+
+  if ((PLLFreq != 0U) && ((PLLFreq % pConfig->CanClockFreq) == 0U))
+  {
+    divider = PLLFreq / pConfig->CanClockFreq;
+    if (divider <= RCCEX_CAN_DIVIDER_MAX)
+    {
+      return (divider - 1U) << RCC_CFGR2_CANCKSEL_Pos;
+    }
+  }
+
+  if (((pConfig->PLLSources & RCC_CLOCKTREE_SOURCE_HSE) != 0U) && (pConfig->CanClockFreq == HSE_VALUE))
+  {
+    return RCC_CANCLKSOURCE_HSE;
+  }
+
+  return 0xFFFFFFFFU;
+}
+
 /**
   * @}
   */
@@ -1454,6 +1454,8 @@ HAL_StatusTypeDef HAL_RTC_PollForAlarmAEvent(RTC_HandleTypeDef *hrtc, uint32_t T
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(tickstart);
   }
 
   /* Clear the Alarm interrupt pending bit */
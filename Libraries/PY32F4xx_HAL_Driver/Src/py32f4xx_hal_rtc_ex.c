@@ -284,6 +284,8 @@ HAL_StatusTypeDef HAL_RTCEx_PollForTamper1Event(RTC_HandleTypeDef *hrtc, uint32_
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(tickstart);
   }
 
   /* Clear the Tamper Flag */
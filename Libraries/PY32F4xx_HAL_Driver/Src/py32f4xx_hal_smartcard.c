@@ -82,6 +82,13 @@
       (+) In case of transfer Error, HAL_SMARTCARD_ErrorCallback() function is executed and user can
           add his own code by customization of function pointer HAL_SMARTCARD_ErrorCallback
 
+    *** T=1 block protocol ***
+    ==========================
+    [..]
+      (+) Initialize a SMARTCARD_T1TypeDef context from the card ATR using HAL_SMARTCARD_T1_Init()
+      (+) Exchange a complete APDU using HAL_SMARTCARD_T1_Transceive(), the blocks are moved by
+          DMA and the block level error recovery is handled by the driver
+
     *** SMARTCARD HAL driver macros list ***
     ========================================
     [..]
@@ -192,11 +199,35 @@
 /** @addtogroup SMARTCARD_Private_Constants
   * @{
   */
+#define SMARTCARD_T1_PCB_R_BLOCK            0x80U          /*!< R-block, N(R) in bit 4               */
+#define SMARTCARD_T1_PCB_S_BLOCK            0xC0U          /*!< S-block                              */
+#define SMARTCARD_T1_PCB_BLOCK_MASK         0xC0U
+#define SMARTCARD_T1_PCB_I_NS               0x40U          /*!< I-block send sequence number         */
+#define SMARTCARD_T1_PCB_I_MORE             0x20U          /*!< I-block chaining, more data follows  */
+#define SMARTCARD_T1_PCB_R_NR               0x10U          /*!< R-block sequence number              */
+#define SMARTCARD_T1_PCB_R_EDC_ERROR        0x01U          /*!< R-block, EDC or parity error         */
+#define SMARTCARD_T1_PCB_R_OTHER_ERROR      0x02U          /*!< R-block, other error                 */
+#define SMARTCARD_T1_PCB_S_IFS_REQ          0xC1U          /*!< S(IFS request)                       */
+#define SMARTCARD_T1_PCB_S_WTX_REQ          0xC3U          /*!< S(WTX request)                       */
+#define SMARTCARD_T1_PCB_S_RESPONSE         0x20U          /*!< S-block response bit                 */
+
+#define SMARTCARD_T1_CHAR_ETU               12U            /*!< Character duration without guard time */
+#define SMARTCARD_T1_BGT_ETU                22U            /*!< Block guard time                     */
 /**
   * @}
   */
 
 /* Private macro -------------------------------------------------------------*/
+/** @addtogroup SMARTCARD_Private_Macros
+  * @{
+  */
+/* Duration of a number of etu in ms, rounded up */
+#define SMARTCARD_T1_ETU_TO_MS(__HANDLE__, __ETU__)  ((((__ETU__) * 1000U) + (__HANDLE__)->Init.BaudRate - 1U) / \
+                                                      (__HANDLE__)->Init.BaudRate)
+/**
+  * @}
+  */
+
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 /** @addtogroup SMARTCARD_Private_Functions
@@ -220,6 +251,11 @@ static void SMARTCARD_DMARxAbortCallback(DMA_HandleTypeDef *hdma);
 static void SMARTCARD_DMATxOnlyAbortCallback(DMA_HandleTypeDef *hdma);
 static void SMARTCARD_DMARxOnlyAbortCallback(DMA_HandleTypeDef *hdma);
 static HAL_StatusTypeDef SMARTCARD_WaitOnFlagUntilTimeout(SMARTCARD_HandleTypeDef *hsc, uint32_t Flag, FlagStatus Status, uint32_t Tickstart, uint32_t Timeout);
+static uint32_t SMARTCARD_T1_ComputeEDC(const SMARTCARD_T1TypeDef *hT1, const uint8_t *pData, uint32_t Length);
+static void SMARTCARD_T1_BuildBlock(SMARTCARD_T1TypeDef *hT1, uint8_t Pcb, const uint8_t *pInf, uint32_t Length);
+static HAL_StatusTypeDef SMARTCARD_T1_WaitReady(__IO HAL_SMARTCARD_StateTypeDef *pState, uint32_t Tickstart, uint32_t Timeout);
+static HAL_StatusTypeDef SMARTCARD_T1_SendBlock(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1);
+static HAL_StatusTypeDef SMARTCARD_T1_ReceiveBlock(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1);
 /**
   * @}
   */
@@ -1805,6 +1841,259 @@ uint32_t HAL_SMARTCARD_GetError(SMARTCARD_HandleTypeDef *hsc)
   * @}
   */
 
+/**
+  * @}
+  */
+
+/** @defgroup SMARTCARD_Exported_Functions_Group4 T=1 block protocol functions
+  *  @brief   ISO/IEC 7816-3 T=1 block protocol functions
+  *
+@verbatim
+ ===============================================================================
+                ##### T=1 block protocol functions #####
+ ===============================================================================
+    [..]
+    This subsection provides functions exchanging a complete APDU with a T=1 card.
+     (+) Set NAD, IFSC, EDC, BWT and Retries of a SMARTCARD_T1TypeDef context from the
+         card ATR, then call HAL_SMARTCARD_T1_Init().
+     (+) HAL_SMARTCARD_T1_Transceive() sends a command APDU and returns the response APDU.
+         Every block is moved by the SMARTCARD DMA path: only the DMA and USART transfer
+         complete interrupts are taken per block instead of one interrupt per character.
+     (+) The character guard time is inserted by the hardware from Init.GuardTime, the
+         22 etu block guard time is waited before each block sent.
+     (+) A block received late, with a parity error or a wrong EDC is requested again with
+         an R-block, a retransmission request from the card is served by sending the last
+         I-block again, up to Retries times.
+     (+) Command APDUs longer than IFSC are sent in chained I-blocks, chained responses are
+         acknowledged and concatenated, IFS and WTX requests from the card are answered.
+     -@- T=1 recovers character errors at block level, HAL_SMARTCARD_T1_Init() disables
+         the T=0 character repetition (NACK).
+     -@- The EDC CRC is computed by software: the CRC peripheral only implements CRC-32.
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Initialize a T=1 block protocol context.
+  * @param  hsc    Pointer to a SMARTCARD_HandleTypeDef structure that contains
+  *                the configuration information for SMARTCARD module.
+  * @param  hT1    Pointer to a SMARTCARD_T1TypeDef structure with NAD, IFSC, EDC, BWT
+  *                and Retries set.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SMARTCARD_T1_Init(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1)
+{
+  /* Check the parameters */
+  if((hT1 == NULL) || (hT1->IFSC == 0U) || (hT1->IFSC > SMARTCARD_T1_INF_SIZE) || (hT1->BWT == 0U))
+  {
+    return HAL_ERROR;
+  }
+  assert_param(IS_SMARTCARD_T1_EDC(hT1->EDC));
+
+  if((hsc->gState != HAL_SMARTCARD_STATE_READY) || (hsc->RxState != HAL_SMARTCARD_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hsc);
+
+  /* Character errors are recovered at block level, no character repetition */
+  hsc->Init.NACKState = SMARTCARD_NACK_DISABLE;
+  CLEAR_BIT(hsc->Instance->CR3, USART_CR3_NACK);
+
+  hT1->NS = 0U;
+  hT1->NR = 0U;
+  hT1->WTX = 1U;
+  hT1->TxLength = 0U;
+  hT1->Tickstamp = HAL_GetTick();
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hsc);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Exchange an APDU with a T=1 card.
+  * @note   The function returns when the whole response has been received, the
+  *         blocks are transferred by DMA in the background.
+  * @param  hsc             Pointer to a SMARTCARD_HandleTypeDef structure that contains
+  *                         the configuration information for SMARTCARD module.
+  * @param  hT1             Pointer to a SMARTCARD_T1TypeDef structure initialized by
+  *                         HAL_SMARTCARD_T1_Init().
+  * @param  pCommand        Pointer to the command APDU.
+  * @param  CommandLength   Length of the command APDU.
+  * @param  pResponse       Pointer to the response APDU buffer.
+  * @param  ResponseSize    Size of the response APDU buffer.
+  * @param  pResponseLength Pointer to the length of the response APDU received.
+  * @retval HAL status, the reason of a failure is given by HAL_SMARTCARD_GetError()
+  */
+HAL_StatusTypeDef HAL_SMARTCARD_T1_Transceive(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1,
+                                              const uint8_t *pCommand, uint32_t CommandLength,
+                                              uint8_t *pResponse, uint32_t ResponseSize, uint32_t *pResponseLength)
+{
+  HAL_StatusTypeDef status;
+  uint32_t offset = 0U;
+  uint32_t chunk;
+  uint32_t received = 0U;
+  uint32_t retries = 0U;
+  uint32_t acked = 0U;
+  uint32_t length;
+  uint32_t i;
+  uint8_t pcb;
+
+  if((hT1 == NULL) || (pCommand == NULL) || (CommandLength == 0U) || (pResponse == NULL) || (pResponseLength == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  if((hsc->gState != HAL_SMARTCARD_STATE_READY) || (hsc->RxState != HAL_SMARTCARD_STATE_READY))
+  {
+    return HAL_BUSY;
+  }
+
+  *pResponseLength = 0U;
+
+  /* First I-block of the command */
+  chunk = ((CommandLength - offset) > hT1->IFSC) ? hT1->IFSC : (CommandLength - offset);
+  pcb = (uint8_t)((hT1->NS != 0U) ? SMARTCARD_T1_PCB_I_NS : 0U);
+  pcb |= (uint8_t)(((offset + chunk) < CommandLength) ? SMARTCARD_T1_PCB_I_MORE : 0U);
+  SMARTCARD_T1_BuildBlock(hT1, pcb, &pCommand[offset], chunk);
+
+  for(;;)
+  {
+    status = SMARTCARD_T1_SendBlock(hsc, hT1);
+    if(status != HAL_OK)
+    {
+      return status;
+    }
+
+    status = SMARTCARD_T1_ReceiveBlock(hsc, hT1);
+    if(status != HAL_OK)
+    {
+      /* Lost or corrupted block: request it again */
+      if(++retries > hT1->Retries)
+      {
+        return status;
+      }
+      pcb = (uint8_t)(SMARTCARD_T1_PCB_R_BLOCK | ((hT1->NR != 0U) ? SMARTCARD_T1_PCB_R_NR : 0U));
+      pcb |= (uint8_t)(((hsc->ErrorCode & (HAL_SMARTCARD_ERROR_EDC | HAL_SMARTCARD_ERROR_PE)) != 0U) ?
+                       SMARTCARD_T1_PCB_R_EDC_ERROR : SMARTCARD_T1_PCB_R_OTHER_ERROR);
+      SMARTCARD_T1_BuildBlock(hT1, pcb, NULL, 0U);
+      continue;
+    }
+
+    pcb = hT1->RxBlock[1];
+    length = hT1->RxBlock[2];
+
+    if((pcb & SMARTCARD_T1_PCB_R_BLOCK) == 0U)
+    {
+      /* I-block: only valid once the whole command is sent, with the expected N(S) */
+      if(((offset + chunk) < CommandLength) || (((pcb & SMARTCARD_T1_PCB_I_NS) != 0U) != (hT1->NR != 0U)))
+      {
+        if(++retries > hT1->Retries)
+        {
+          hsc->ErrorCode = HAL_SMARTCARD_ERROR_PROTOCOL;
+          return HAL_ERROR;
+        }
+        pcb = (uint8_t)(SMARTCARD_T1_PCB_R_BLOCK | SMARTCARD_T1_PCB_R_OTHER_ERROR |
+                        ((hT1->NR != 0U) ? SMARTCARD_T1_PCB_R_NR : 0U));
+        SMARTCARD_T1_BuildBlock(hT1, pcb, NULL, 0U);
+        continue;
+      }
+
+      /* The first response block acknowledges the last command block */
+      if(acked == 0U)
+      {
+        hT1->NS ^= 1U;
+        acked = 1U;
+      }
+
+      if((received + length) > ResponseSize)
+      {
+        hsc->ErrorCode = HAL_SMARTCARD_ERROR_PROTOCOL;
+        return HAL_ERROR;
+      }
+      for(i = 0U; i < length; i++)
+      {
+        pResponse[received + i] = hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE + i];
+      }
+      received += length;
+      hT1->NR ^= 1U;
+      retries = 0U;
+
+      if((pcb & SMARTCARD_T1_PCB_I_MORE) == 0U)
+      {
+        *pResponseLength = received;
+        return HAL_OK;
+      }
+
+      /* Chained response: acknowledge and ask for the next block */
+      pcb = (uint8_t)(SMARTCARD_T1_PCB_R_BLOCK | ((hT1->NR != 0U) ? SMARTCARD_T1_PCB_R_NR : 0U));
+      SMARTCARD_T1_BuildBlock(hT1, pcb, NULL, 0U);
+    }
+    else if((pcb & SMARTCARD_T1_PCB_BLOCK_MASK) == SMARTCARD_T1_PCB_R_BLOCK)
+    {
+      if((acked == 0U) && ((offset + chunk) < CommandLength) &&
+         (((pcb & SMARTCARD_T1_PCB_R_NR) != 0U) != (hT1->NS != 0U)))
+      {
+        /* Chained command block acknowledged: send the next one */
+        hT1->NS ^= 1U;
+        offset += chunk;
+        retries = 0U;
+      }
+      else
+      {
+        if(++retries > hT1->Retries)
+        {
+          hsc->ErrorCode = HAL_SMARTCARD_ERROR_PROTOCOL;
+          return HAL_ERROR;
+        }
+        if(acked != 0U)
+        {
+          /* Acknowledge of the chained response lost: send it again */
+          pcb = (uint8_t)(SMARTCARD_T1_PCB_R_BLOCK | ((hT1->NR != 0U) ? SMARTCARD_T1_PCB_R_NR : 0U));
+          SMARTCARD_T1_BuildBlock(hT1, pcb, NULL, 0U);
+          continue;
+        }
+        /* Retransmission request of the last command block */
+      }
+
+      chunk = ((CommandLength - offset) > hT1->IFSC) ? hT1->IFSC : (CommandLength - offset);
+      pcb = (uint8_t)((hT1->NS != 0U) ? SMARTCARD_T1_PCB_I_NS : 0U);
+      pcb |= (uint8_t)(((offset + chunk) < CommandLength) ? SMARTCARD_T1_PCB_I_MORE : 0U);
+      SMARTCARD_T1_BuildBlock(hT1, pcb, &pCommand[offset], chunk);
+    }
+    else if(((pcb == SMARTCARD_T1_PCB_S_IFS_REQ) || (pcb == SMARTCARD_T1_PCB_S_WTX_REQ)) && (length == 1U))
+    {
+      if(pcb == SMARTCARD_T1_PCB_S_IFS_REQ)
+      {
+        if((hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE] != 0U) &&
+           (hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE] <= SMARTCARD_T1_INF_SIZE))
+        {
+          hT1->IFSC = hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE];
+        }
+      }
+      else
+      {
+        /* Waiting time extension for the next block only */
+        hT1->WTX = (hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE] != 0U) ? hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE] : 1U;
+      }
+
+      /* Answer with the same INF, the pending block is then expected again */
+      SMARTCARD_T1_BuildBlock(hT1, (uint8_t)(pcb | SMARTCARD_T1_PCB_S_RESPONSE),
+                              &hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE], 1U);
+    }
+    else
+    {
+      /* Resynchronization, abort or malformed S-block: left to the application */
+      hsc->ErrorCode = HAL_SMARTCARD_ERROR_PROTOCOL;
+      return HAL_ERROR;
+    }
+  }
+}
+
 /**
   * @}
   */
@@ -1921,6 +2210,215 @@ static void SMARTCARD_DMAError(DMA_HandleTypeDef *hdma)
 #endif /* USE_HAL_SMARTCARD_REGISTER_CALLBACK */
 }
 
+/**
+  * @brief  Compute the EDC of a T=1 block.
+  * @param  hT1    Pointer to a SMARTCARD_T1TypeDef structure.
+  * @param  pData  Pointer to the block, from the prologue.
+  * @param  Length Length of the block without EDC.
+  * @retval LRC in the low byte, or CRC
+  */
+static uint32_t SMARTCARD_T1_ComputeEDC(const SMARTCARD_T1TypeDef *hT1, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t edc;
+  uint32_t i;
+  uint32_t bit;
+
+  if(hT1->EDC == SMARTCARD_T1_EDC_LRC)
+  {
+    edc = 0U;
+    for(i = 0U; i < Length; i++)
+    {
+      edc ^= pData[i];
+    }
+  }
+  else
+  {
+    /* Reflected CRC-16 CCITT, initial value 0xFFFF */
+    edc = 0xFFFFU;
+    for(i = 0U; i < Length; i++)
+    {
+      edc ^= pData[i];
+      for(bit = 0U; bit < 8U; bit++)
+      {
+        edc = ((edc & 1U) != 0U) ? ((edc >> 1U) ^ 0x8408U) : (edc >> 1U);
+      }
+    }
+  }
+
+  return edc;
+}
+
+/**
+  * @brief  Build a T=1 block in the transmit buffer of the context.
+  * @param  hT1    Pointer to a SMARTCARD_T1TypeDef structure.
+  * @param  Pcb    Protocol control byte.
+  * @param  pInf   Pointer to the information field, NULL when Length is 0.
+  * @param  Length Length of the information field.
+  * @retval None
+  */
+static void SMARTCARD_T1_BuildBlock(SMARTCARD_T1TypeDef *hT1, uint8_t Pcb, const uint8_t *pInf, uint32_t Length)
+{
+  uint32_t edc;
+  uint32_t i;
+
+  hT1->TxBlock[0] = hT1->NAD;
+  hT1->TxBlock[1] = Pcb;
+  hT1->TxBlock[2] = (uint8_t)Length;
+  for(i = 0U; i < Length; i++)
+  {
+    hT1->TxBlock[SMARTCARD_T1_PROLOGUE_SIZE + i] = pInf[i];
+  }
+  Length += SMARTCARD_T1_PROLOGUE_SIZE;
+
+  edc = SMARTCARD_T1_ComputeEDC(hT1, hT1->TxBlock, Length);
+  if(hT1->EDC == SMARTCARD_T1_EDC_LRC)
+  {
+    hT1->TxBlock[Length++] = (uint8_t)edc;
+  }
+  else
+  {
+    hT1->TxBlock[Length++] = (uint8_t)(edc >> 8U);
+    hT1->TxBlock[Length++] = (uint8_t)edc;
+  }
+
+  hT1->TxLength = Length;
+}
+
+/**
+  * @brief  Wait for the end of a DMA transfer of a T=1 block.
+  * @param  pState    Pointer to the gState or RxState of the handle.
+  * @param  Tickstart Tick start value.
+  * @param  Timeout   Timeout duration in ms.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SMARTCARD_T1_WaitReady(__IO HAL_SMARTCARD_StateTypeDef *pState, uint32_t Tickstart, uint32_t Timeout)
+{
+  while(*pState != HAL_SMARTCARD_STATE_READY)
+  {
+    if((HAL_GetTick() - Tickstart) > Timeout)
+    {
+      return HAL_TIMEOUT;
+    }
+
+    __HAL_WAIT(Tickstart);
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Send the block of the transmit buffer of a T=1 context.
+  * @param  hsc    Pointer to a SMARTCARD_HandleTypeDef structure that contains
+  *                the configuration information for SMARTCARD module.
+  * @param  hT1    Pointer to a SMARTCARD_T1TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SMARTCARD_T1_SendBlock(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1)
+{
+  uint32_t timeout;
+
+  /* Block guard time between the last character received and the first one sent */
+  while((HAL_GetTick() - hT1->Tickstamp) <= SMARTCARD_T1_ETU_TO_MS(hsc, SMARTCARD_T1_BGT_ETU))
+  {
+  }
+
+  if(HAL_SMARTCARD_Transmit_DMA(hsc, hT1->TxBlock, (uint16_t)hT1->TxLength) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  timeout = SMARTCARD_T1_ETU_TO_MS(hsc, hT1->TxLength * (SMARTCARD_T1_CHAR_ETU + hsc->Init.GuardTime)) + 1U;
+  if(SMARTCARD_T1_WaitReady(&hsc->gState, HAL_GetTick(), timeout) != HAL_OK)
+  {
+    (void)HAL_SMARTCARD_AbortTransmit(hsc);
+    return HAL_TIMEOUT;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Receive a block in the receive buffer of a T=1 context and check it.
+  * @note   The prologue is received first, the rest of the block is then received
+  *         with a second DMA transfer sized from LEN.
+  * @param  hsc    Pointer to a SMARTCARD_HandleTypeDef structure that contains
+  *                the configuration information for SMARTCARD module.
+  * @param  hT1    Pointer to a SMARTCARD_T1TypeDef structure.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SMARTCARD_T1_ReceiveBlock(SMARTCARD_HandleTypeDef *hsc, SMARTCARD_T1TypeDef *hT1)
+{
+  HAL_StatusTypeDef status;
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t length;
+  uint32_t edc;
+  uint32_t edcsize = (hT1->EDC == SMARTCARD_T1_EDC_LRC) ? 1U : 2U;
+
+  /* Drop the echo of the block sent on the half duplex line and its error flags */
+  __HAL_SMARTCARD_CLEAR_PEFLAG(hsc);
+
+  /* Prologue: the first character is due within BWT, times the granted extension */
+  status = HAL_SMARTCARD_Receive_DMA(hsc, hT1->RxBlock, (uint16_t)SMARTCARD_T1_PROLOGUE_SIZE);
+  if(status == HAL_OK)
+  {
+    status = SMARTCARD_T1_WaitReady(&hsc->RxState, tickstart, (hT1->BWT * hT1->WTX) +
+                                    SMARTCARD_T1_ETU_TO_MS(hsc, SMARTCARD_T1_PROLOGUE_SIZE * SMARTCARD_T1_CHAR_ETU));
+  }
+  hT1->WTX = 1U;
+
+  /* Information field and epilogue */
+  length = hT1->RxBlock[2];
+  if((status == HAL_OK) && (hsc->ErrorCode == HAL_SMARTCARD_ERROR_NONE))
+  {
+    if(length > SMARTCARD_T1_INF_SIZE)
+    {
+      hsc->ErrorCode = HAL_SMARTCARD_ERROR_PROTOCOL;
+      status = HAL_ERROR;
+    }
+    else
+    {
+      status = HAL_SMARTCARD_Receive_DMA(hsc, &hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE], (uint16_t)(length + edcsize));
+      if(status == HAL_OK)
+      {
+        status = SMARTCARD_T1_WaitReady(&hsc->RxState, HAL_GetTick(), hT1->BWT +
+                                        SMARTCARD_T1_ETU_TO_MS(hsc, (length + edcsize) * SMARTCARD_T1_CHAR_ETU));
+      }
+    }
+  }
+
+  if(status == HAL_TIMEOUT)
+  {
+    (void)HAL_SMARTCARD_AbortReceive(hsc);
+  }
+  hT1->Tickstamp = HAL_GetTick();
+
+  if(status != HAL_OK)
+  {
+    return status;
+  }
+  if(hsc->ErrorCode != HAL_SMARTCARD_ERROR_NONE)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Check the epilogue */
+  edc = SMARTCARD_T1_ComputeEDC(hT1, hT1->RxBlock, SMARTCARD_T1_PROLOGUE_SIZE + length);
+  if(edcsize == 1U)
+  {
+    status = (hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE + length] == (uint8_t)edc) ? HAL_OK : HAL_ERROR;
+  }
+  else
+  {
+    status = ((hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE + length] == (uint8_t)(edc >> 8U)) &&
+              (hT1->RxBlock[SMARTCARD_T1_PROLOGUE_SIZE + length + 1U] == (uint8_t)edc)) ? HAL_OK : HAL_ERROR;
+  }
+  if(status != HAL_OK)
+  {
+    hsc->ErrorCode = HAL_SMARTCARD_ERROR_EDC;
+  }
+
+  return status;
+}
+
 /**
   * @brief  This function handles SMARTCARD Communication Timeout.
   * @param  hsc    Pointer to a SMARTCARD_HandleTypeDef structure that contains
@@ -1954,6 +2452,8 @@ static HAL_StatusTypeDef SMARTCARD_WaitOnFlagUntilTimeout(SMARTCARD_HandleTypeDe
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -50,6 +50,18 @@
       (#) The CRC feature is not managed when the DMA circular mode is enabled
       (#) When the SPI DMA Pause/Stop features are used, we must use the following APIs
           the HAL_SPI_DMAPause()/ HAL_SPI_DMAStop() only under the SPI callbacks
+     [..]
+       Continuous streaming:
+      (#) HAL_SPI_TransmitReceiveStream_DMA() runs both DMA channels in circular mode:
+          the Tx pattern (dummy bytes or a conversion command) is repeated and the Rx
+          buffer is filled as two blocks reported by HAL_SPI_TxRxHalfCpltCallback()
+          and HAL_SPI_TxRxCpltCallback(), without any gap between the blocks.
+      (#) To pace the frames, e.g. with the sample rate of an external ADC, map the
+          Tx DMA channel with HAL_DMA_ChannelMap() to the update request of a timer
+          (DMA_CHANNEL_MAP_TIMx_UP) instead of DMA_CHANNEL_MAP_SPIx_WR and enable
+          the timer update DMA request: one pattern item is sent per timer period.
+          A PWM channel of the same timer can drive the chip select or the
+          conversion start pin of the converter.
      [..]
        Master Receive mode restriction:
       (#) In Master unidirectional receive-only mode (MSTR =1, BIDIMODE=0, RXONLY=1) or
@@ -114,6 +126,15 @@
        using HAL_SPI_RegisterCallback() before calling HAL_SPI_DeInit()
        or HAL_SPI_Init() function.
 
+       [..]
+       When the compilation define USE_HAL_SPI_REGISTER_CALLBACKS is set to 2,
+       the handle holds a pointer to a const callback table, in FLASH and shared
+       by the handles, instead of a pointer per callback in RAM.
+       Use function HAL_SPI_RegisterCallbackTable() to set the table of a handle,
+       in HAL_SPI_STATE_RESET or HAL_SPI_STATE_READY state, all its callbacks
+       set: the weak ones where no user callback is needed.
+       A handle without a table gets the one of the weak callbacks at init.
+
        [..]
        When the compilation define USE_HAL_PPP_REGISTER_CALLBACKS is set to 0 or
        not defined, the callback registering feature is not available
@@ -226,6 +247,22 @@
 
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+/* Callback table of the handles without one, the legacy weak callbacks */
+static const SPI_CallbacksTypeDef SPI_DefaultCallbacks =
+{
+  .TxCpltCallback       = HAL_SPI_TxCpltCallback,
+  .RxCpltCallback       = HAL_SPI_RxCpltCallback,
+  .TxRxCpltCallback     = HAL_SPI_TxRxCpltCallback,
+  .TxHalfCpltCallback   = HAL_SPI_TxHalfCpltCallback,
+  .RxHalfCpltCallback   = HAL_SPI_RxHalfCpltCallback,
+  .TxRxHalfCpltCallback = HAL_SPI_TxRxHalfCpltCallback,
+  .ErrorCallback        = HAL_SPI_ErrorCallback,
+  .AbortCpltCallback    = HAL_SPI_AbortCpltCallback,
+  .MspInitCallback      = HAL_SPI_MspInit,
+  .MspDeInitCallback    = HAL_SPI_MspDeInit,
+};
+#endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
 /* Private function prototypes -----------------------------------------------*/
 /** @defgroup SPI_Private_Functions SPI Private Functions
   * @{
@@ -377,6 +414,14 @@ HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
 
     /* Init the low level hardware : GPIO, CLOCK, NVIC... */
     hspi->MspInitCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    if (hspi->pCallbacks == NULL)
+    {
+      hspi->pCallbacks = &SPI_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC... */
+    hspi->pCallbacks->MspInitCallback(hspi);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC... */
     HAL_SPI_MspInit(hspi);
@@ -473,6 +518,14 @@ HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef *hspi)
 
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC... */
   hspi->MspDeInitCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  if (hspi->pCallbacks == NULL)
+  {
+    hspi->pCallbacks = &SPI_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware: GPIO, CLOCK, NVIC... */
+  hspi->pCallbacks->MspDeInitCallback(hspi);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC... */
   HAL_SPI_MspDeInit(hspi);
@@ -734,6 +787,57 @@ HAL_StatusTypeDef HAL_SPI_UnRegisterCallback(SPI_HandleTypeDef *hspi, HAL_SPI_Ca
   __HAL_UNLOCK(hspi);
   return status;
 }
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+/**
+  * @brief  Register a User SPI callback table
+  *         To be used instead of the weak predefined callbacks
+  * @note   The table is const, placed in FLASH and shared by the handles
+  *         having the same callbacks: each of its callbacks must be set,
+  *         to the weak predefined one when not needed.
+  * @param  hspi Pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for the specified SPI.
+  * @param  pCallbacks pointer to the callback table, NULL for the default one
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_RegisterCallbackTable(SPI_HandleTypeDef *hspi, const SPI_CallbacksTypeDef *pCallbacks)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (pCallbacks == NULL)
+  {
+    pCallbacks = &SPI_DefaultCallbacks;
+  }
+  if ((pCallbacks->TxCpltCallback == NULL) || (pCallbacks->RxCpltCallback == NULL) ||
+      (pCallbacks->TxRxCpltCallback == NULL) || (pCallbacks->TxHalfCpltCallback == NULL) ||
+      (pCallbacks->RxHalfCpltCallback == NULL) || (pCallbacks->TxRxHalfCpltCallback == NULL) ||
+      (pCallbacks->ErrorCallback == NULL) || (pCallbacks->AbortCpltCallback == NULL) ||
+      (pCallbacks->MspInitCallback == NULL) || (pCallbacks->MspDeInitCallback == NULL))
+  {
+    /* Update the error code */
+    hspi->ErrorCode |= HAL_SPI_ERROR_INVALID_CALLBACK;
+
+    return HAL_ERROR;
+  }
+  /* Process locked */
+  __HAL_LOCK(hspi);
+
+  if ((HAL_SPI_STATE_READY == hspi->State) || (HAL_SPI_STATE_RESET == hspi->State))
+  {
+    hspi->pCallbacks = pCallbacks;
+  }
+  else
+  {
+    /* Update the error code */
+    SET_BIT(hspi->ErrorCode, HAL_SPI_ERROR_INVALID_CALLBACK);
+
+    /* Return error status */
+    status =  HAL_ERROR;
+  }
+
+  /* Release Lock */
+  __HAL_UNLOCK(hspi);
+  return status;
+}
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
 /**
   * @}
@@ -1970,6 +2074,180 @@ error:
   return errorcode;
 }
 
+/**
+  * @brief  Receive data continuously in DMA mode into a ring buffer.
+  * @note   The Rx DMA handle must be initialized in DMA_CIRCULAR mode. In master
+  *         full duplex mode the ring is also sent as dummy data, so the Tx DMA
+  *         handle must be circular too.
+  *         Received data is read in place with HAL_DMAEx_RingAcquire() and
+  *         released with HAL_DMAEx_RingCommit(), the reception runs until
+  *         HAL_SPI_DMAStop() or HAL_SPI_Abort() is called.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pRing Ring buffer initialized with HAL_DMAEx_RingInit().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_ReceiveToRing_DMA(SPI_HandleTypeDef *hspi, DMA_RingTypeDef *pRing)
+{
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (HAL_DMAEx_RingAttach(pRing, hspi->hdmarx) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_SPI_Receive_DMA(hspi, pRing->pBuffer, (uint16_t)pRing->Items);
+}
+
+/**
+  * @brief  Transmit a repeated pattern and receive continuously in DMA mode.
+  * @note   Both the Tx and the Rx DMA handles must be initialized in DMA_CIRCULAR
+  *         mode with a memory alignment matching the SPI data size. The pattern
+  *         is sent again and again while pRxData is filled as a double buffer:
+  *         HAL_SPI_TxRxHalfCpltCallback() reports the first Size/2 items and
+  *         HAL_SPI_TxRxCpltCallback() the second half, the DMA writing the other
+  *         half meanwhile. The streaming runs until HAL_SPI_DMAStop() or
+  *         HAL_SPI_Abort() is called.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pPattern pointer to the data sent repeatedly, e.g. a dummy or a
+  *               conversion command
+  * @param  PatternSize amount of data of the pattern
+  * @param  pRxData pointer to reception data buffer
+  * @param  Size amount of data of the reception buffer, two blocks
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_TransmitReceiveStream_DMA(SPI_HandleTypeDef *hspi, uint8_t *pPattern, uint16_t PatternSize,
+                                                    uint8_t *pRxData, uint16_t Size)
+{
+  uint32_t tmp_align;
+  HAL_StatusTypeDef errorcode = HAL_OK;
+
+  /* Check rx & tx dma handles */
+  assert_param(IS_SPI_DMA_HANDLE(hspi->hdmarx));
+  assert_param(IS_SPI_DMA_HANDLE(hspi->hdmatx));
+
+  /* Check Direction parameter */
+  assert_param(IS_SPI_DIRECTION_2LINES(hspi->Init.Direction));
+
+  /* Process locked */
+  __HAL_LOCK(hspi);
+
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    errorcode = HAL_BUSY;
+    goto error;
+  }
+
+  if ((pPattern == NULL) || (pRxData == NULL) || (PatternSize == 0U) || (Size < 2U) || ((Size & 0x1U) != 0U))
+  {
+    errorcode = HAL_ERROR;
+    goto error;
+  }
+
+  /* The streaming relies on both channels reloading themselves without gap */
+  tmp_align = (hspi->Init.DataSize > SPI_DATASIZE_8BIT) ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+  if ((hspi->hdmatx->Init.Mode != DMA_CIRCULAR) || (hspi->hdmarx->Init.Mode != DMA_CIRCULAR) ||
+      (hspi->hdmatx->Init.MemDataAlignment != tmp_align) || (hspi->hdmarx->Init.MemDataAlignment != tmp_align))
+  {
+    errorcode = HAL_ERROR;
+    goto error;
+  }
+
+  hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+
+  /* Set the transaction information */
+  hspi->ErrorCode   = HAL_SPI_ERROR_NONE;
+  hspi->pTxBuffPtr  = (uint8_t *)pPattern;
+  hspi->TxXferSize  = PatternSize;
+  hspi->TxXferCount = PatternSize;
+  hspi->pRxBuffPtr  = (uint8_t *)pRxData;
+  hspi->RxXferSize  = Size;
+  hspi->RxXferCount = Size;
+
+  /* Init field not used in handle to zero */
+  hspi->RxISR       = NULL;
+  hspi->TxISR       = NULL;
+
+  /* Reset the threshold bit, no data packing */
+  CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_LDMA_TX | SPI_CR2_LDMA_RX);
+
+  if (hspi->Init.DataSize > SPI_DATASIZE_8BIT)
+  {
+    /* Set fiforxthreshold according the reception data length: 16bit */
+    CLEAR_BIT(hspi->Instance->CR2, SPI_RXFIFO_THRESHOLD);
+  }
+  else
+  {
+    /* Set RX Fifo threshold according the reception data length: 8bit */
+    SET_BIT(hspi->Instance->CR2, SPI_RXFIFO_THRESHOLD);
+  }
+
+  /* Set the SPI Tx/Rx DMA Half transfer complete callback, the circular mode
+  keeps the transfer running from these callbacks */
+  hspi->hdmarx->XferHalfCpltCallback = SPI_DMAHalfTransmitReceiveCplt;
+  hspi->hdmarx->XferCpltCallback     = SPI_DMATransmitReceiveCplt;
+  hspi->hdmarx->XferErrorCallback    = SPI_DMAError;
+  hspi->hdmarx->XferAbortCallback    = NULL;
+
+  /* Enable the Rx DMA Stream/Channel  */
+  if (HAL_OK != HAL_DMA_Start_IT(hspi->hdmarx, (uint32_t)&hspi->Instance->DR, (uint32_t)hspi->pRxBuffPtr,
+                                 hspi->RxXferCount))
+  {
+    /* Update SPI error code */
+    SET_BIT(hspi->ErrorCode, HAL_SPI_ERROR_DMA);
+    errorcode = HAL_ERROR;
+
+    hspi->State = HAL_SPI_STATE_READY;
+    goto error;
+  }
+
+  /* Enable Rx DMA Request */
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+
+  /* The pattern wraps silently, only the Tx errors are reported */
+  hspi->hdmatx->XferHalfCpltCallback = NULL;
+  hspi->hdmatx->XferCpltCallback     = NULL;
+  hspi->hdmatx->XferErrorCallback    = SPI_DMAError;
+  hspi->hdmatx->XferAbortCallback    = NULL;
+
+  /* Enable the Tx DMA Stream/Channel  */
+  if (HAL_OK != HAL_DMA_Start_IT(hspi->hdmatx, (uint32_t)hspi->pTxBuffPtr, (uint32_t)&hspi->Instance->DR,
+                                 hspi->TxXferCount))
+  {
+    /* Stop the reception already armed */
+    CLEAR_BIT(hspi->Instance->CR2, SPI_CR2_RXDMAEN);
+    (void)HAL_DMA_Abort(hspi->hdmarx);
+
+    /* Update SPI error code */
+    SET_BIT(hspi->ErrorCode, HAL_SPI_ERROR_DMA);
+    errorcode = HAL_ERROR;
+
+    hspi->State = HAL_SPI_STATE_READY;
+    goto error;
+  }
+
+  /* Check if the SPI is already enabled */
+  if ((hspi->Instance->CR1 & SPI_CR1_SPE) != SPI_CR1_SPE)
+  {
+    /* Enable SPI peripheral */
+    __HAL_SPI_ENABLE(hspi);
+  }
+  /* Enable the SPI Error Interrupt Bit */
+  __HAL_SPI_ENABLE_IT(hspi, (SPI_IT_ERR));
+
+  /* Enable Tx DMA Request */
+  SET_BIT(hspi->Instance->CR2, SPI_CR2_TXDMAEN);
+
+error :
+  /* Process Unlocked */
+  __HAL_UNLOCK(hspi);
+  return errorcode;
+}
+
 /**
   * @brief  Transmit and Receive an amount of data in non-blocking mode with DMA.
   * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
@@ -2479,6 +2757,8 @@ HAL_StatusTypeDef HAL_SPI_Abort_IT(SPI_HandleTypeDef *hspi)
     /* As no DMA to be aborted, call directly user Abort complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
     hspi->AbortCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    hspi->pCallbacks->AbortCpltCallback(hspi);
 #else
     HAL_SPI_AbortCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -2660,6 +2940,8 @@ void HAL_SPI_IRQHandler(SPI_HandleTypeDef *hspi)
         /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
         hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+        hspi->pCallbacks->ErrorCallback(hspi);
 #else
         HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -2898,6 +3180,8 @@ static void SPI_DMATransmitCplt(DMA_HandleTypeDef *hdma)
       /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->ErrorCallback(hspi);
 #else
       HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -2907,6 +3191,8 @@ static void SPI_DMATransmitCplt(DMA_HandleTypeDef *hdma)
   /* Call user Tx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->TxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->TxCpltCallback(hspi);
 #else
   HAL_SPI_TxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3002,6 +3288,8 @@ static void SPI_DMAReceiveCplt(DMA_HandleTypeDef *hdma)
       /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->ErrorCallback(hspi);
 #else
       HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3011,6 +3299,8 @@ static void SPI_DMAReceiveCplt(DMA_HandleTypeDef *hdma)
   /* Call user Rx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->RxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->RxCpltCallback(hspi);
 #else
   HAL_SPI_RxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3102,6 +3392,8 @@ static void SPI_DMATransmitReceiveCplt(DMA_HandleTypeDef *hdma)
       /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->ErrorCallback(hspi);
 #else
       HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3111,6 +3403,8 @@ static void SPI_DMATransmitReceiveCplt(DMA_HandleTypeDef *hdma)
   /* Call user TxRx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->TxRxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->TxRxCpltCallback(hspi);
 #else
   HAL_SPI_TxRxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3129,6 +3423,8 @@ static void SPI_DMAHalfTransmitCplt(DMA_HandleTypeDef *hdma)
   /* Call user Tx half complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->TxHalfCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->TxHalfCpltCallback(hspi);
 #else
   HAL_SPI_TxHalfCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3147,6 +3443,8 @@ static void SPI_DMAHalfReceiveCplt(DMA_HandleTypeDef *hdma)
   /* Call user Rx half complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->RxHalfCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->RxHalfCpltCallback(hspi);
 #else
   HAL_SPI_RxHalfCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3165,6 +3463,8 @@ static void SPI_DMAHalfTransmitReceiveCplt(DMA_HandleTypeDef *hdma)
   /* Call user TxRx half complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->TxRxHalfCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->TxRxHalfCpltCallback(hspi);
 #else
   HAL_SPI_TxRxHalfCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3188,6 +3488,8 @@ static void SPI_DMAError(DMA_HandleTypeDef *hdma)
   /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->ErrorCallback(hspi);
 #else
   HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3208,6 +3510,8 @@ static void SPI_DMAAbortOnError(DMA_HandleTypeDef *hdma)
   /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->ErrorCallback(hspi);
 #else
   HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3274,6 +3578,8 @@ static void SPI_DMATxAbortCallback(DMA_HandleTypeDef *hdma)
   /* Call user Abort complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->AbortCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->AbortCpltCallback(hspi);
 #else
   HAL_SPI_AbortCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3341,6 +3647,8 @@ static void SPI_DMARxAbortCallback(DMA_HandleTypeDef *hdma)
   /* Call user Abort complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
   hspi->AbortCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+  hspi->pCallbacks->AbortCpltCallback(hspi);
 #else
   HAL_SPI_AbortCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3778,6 +4086,8 @@ static HAL_StatusTypeDef SPI_WaitFlagStateUntilTimeout(SPI_HandleTypeDef *hspi,
       }
       count--;
     }
+
+    __HAL_WAIT(tmp_tickstart);
   }
 
   return HAL_OK;
@@ -3860,6 +4170,8 @@ static HAL_StatusTypeDef SPI_WaitFifoStateUntilTimeout(SPI_HandleTypeDef *hspi,
       }      
       count--;
     }
+
+    __HAL_WAIT(tmp_tickstart);
   }
 
   return HAL_OK;
@@ -3967,6 +4279,8 @@ static void SPI_CloseRxTx_ISR(SPI_HandleTypeDef *hspi)
     /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
     hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    hspi->pCallbacks->ErrorCallback(hspi);
 #else
     HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3982,6 +4296,8 @@ static void SPI_CloseRxTx_ISR(SPI_HandleTypeDef *hspi)
         /* Call user Rx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
         hspi->RxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+        hspi->pCallbacks->RxCpltCallback(hspi);
 #else
         HAL_SPI_RxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -3992,6 +4308,8 @@ static void SPI_CloseRxTx_ISR(SPI_HandleTypeDef *hspi)
         /* Call user TxRx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
         hspi->TxRxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+        hspi->pCallbacks->TxRxCpltCallback(hspi);
 #else
         HAL_SPI_TxRxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4003,6 +4321,8 @@ static void SPI_CloseRxTx_ISR(SPI_HandleTypeDef *hspi)
       /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->ErrorCallback(hspi);
 #else
       HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4039,6 +4359,8 @@ static void SPI_CloseRx_ISR(SPI_HandleTypeDef *hspi)
     /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
     hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    hspi->pCallbacks->ErrorCallback(hspi);
 #else
     HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4051,6 +4373,8 @@ static void SPI_CloseRx_ISR(SPI_HandleTypeDef *hspi)
       /* Call user Rx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->RxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->RxCpltCallback(hspi);
 #else
       HAL_SPI_RxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4060,6 +4384,8 @@ static void SPI_CloseRx_ISR(SPI_HandleTypeDef *hspi)
       /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
       hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+      hspi->pCallbacks->ErrorCallback(hspi);
 #else
       HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4103,6 +4429,8 @@ static void SPI_CloseTx_ISR(SPI_HandleTypeDef *hspi)
     /* Call user error callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
     hspi->ErrorCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    hspi->pCallbacks->ErrorCallback(hspi);
 #else
     HAL_SPI_ErrorCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
@@ -4112,6 +4440,8 @@ static void SPI_CloseTx_ISR(SPI_HandleTypeDef *hspi)
     /* Call user Rx complete callback */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
     hspi->TxCpltCallback(hspi);
+#elif (USE_HAL_SPI_REGISTER_CALLBACKS == 2U)
+    hspi->pCallbacks->TxCpltCallback(hspi);
 #else
     HAL_SPI_TxCpltCallback(hspi);
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
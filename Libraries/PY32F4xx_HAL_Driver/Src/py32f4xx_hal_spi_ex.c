@@ -70,6 +70,17 @@
     (#) Rx data flush function:
         (++) HAL_SPIEx_FlushRxFifo()
 
+    (#) Hardware CRC framed transfer functions, when USE_SPI_CRC is set to 1U:
+        (++) HAL_SPIEx_TransmitReceiveCRC_DMA() enables the CRC unit with the
+             given polynomial and starts a full duplex DMA transfer. The CRC of
+             the data sent is appended by the SPI at the end of the Tx DMA
+             transfer and the received CRC is checked against the RXCRCR value:
+             HAL_SPI_TxRxCpltCallback() is called for a valid frame, and
+             HAL_SPI_ErrorCallback() with HAL_SPI_ERROR_CRC otherwise.
+        (++) The CRC is 8-bit for SPI_DATASIZE_8BIT and 16-bit for
+             SPI_DATASIZE_16BIT, the buffers hold the payload only.
+        (++) HAL_SPIEx_DisableCRC() returns to plain transfers.
+
 @endverbatim
   * @{
   */
@@ -97,6 +108,79 @@ HAL_StatusTypeDef HAL_SPIEx_FlushRxFifo(SPI_HandleTypeDef *hspi)
   return HAL_OK;
 }
 
+#if (USE_SPI_CRC != 0U)
+/**
+  * @brief  Transmit and receive a CRC protected frame in non-blocking mode with DMA.
+  * @note   The CRC unit is reconfigured only when the polynomial differs from
+  *         the one in use, the SPI is disabled meanwhile.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for the specified SPI module.
+  * @param  pTxData pointer to transmission data buffer, CRC excluded
+  * @param  pRxData pointer to reception data buffer, CRC excluded
+  * @param  Size amount of data to be sent, CRC excluded
+  * @param  Polynomial CRC polynomial, an odd value between 0x1 and 0xFFFF
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPIEx_TransmitReceiveCRC_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                                   uint16_t Size, uint32_t Polynomial)
+{
+  /* Check the parameters */
+  assert_param(IS_SPI_CRC_POLYNOMIAL(Polynomial));
+
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* CRC calculation is valid only for 16Bit and 8 Bit */
+  if ((hspi->Init.DataSize != SPI_DATASIZE_16BIT) && (hspi->Init.DataSize != SPI_DATASIZE_8BIT))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((hspi->Init.CRCCalculation != SPI_CRCCALCULATION_ENABLE) || (hspi->Init.CRCPolynomial != Polynomial))
+  {
+    /* CRCEN and CRCPR may only be written while the SPI is disabled */
+    __HAL_SPI_DISABLE(hspi);
+
+    hspi->Init.CRCCalculation = SPI_CRCCALCULATION_ENABLE;
+    hspi->Init.CRCPolynomial  = Polynomial;
+
+    WRITE_REG(hspi->Instance->CRCPR, (Polynomial & SPI_CRCPR_CRCPOLY_Msk));
+    SET_BIT(hspi->Instance->CR1, SPI_CR1_CRCEN);
+  }
+
+  /* The CRC is reset, sent and checked by the DMA transfer */
+  return HAL_SPI_TransmitReceive_DMA(hspi, pTxData, pRxData, Size);
+}
+
+/**
+  * @brief  Disable the hardware CRC of the SPI transfers.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for the specified SPI module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPIEx_DisableCRC(SPI_HandleTypeDef *hspi)
+{
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (hspi->Init.CRCCalculation == SPI_CRCCALCULATION_ENABLE)
+  {
+    /* CRCEN may only be written while the SPI is disabled */
+    __HAL_SPI_DISABLE(hspi);
+
+    hspi->Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+
+    CLEAR_BIT(hspi->Instance->CR1, SPI_CR1_CRCEN);
+  }
+
+  return HAL_OK;
+}
+#endif /* USE_SPI_CRC */
+
 /**
   * @}
   */
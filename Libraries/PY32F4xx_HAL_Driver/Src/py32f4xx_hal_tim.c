@@ -162,6 +162,15 @@ all interrupt callbacks are set to the corresponding weak functions:
   In that case first register the MspInit/MspDeInit user callbacks
       using @ref HAL_TIM_RegisterCallback() before calling DeInit or Init function.
 
+  [..]
+      When The compilation define USE_HAL_TIM_REGISTER_CALLBACKS is set to 2,
+      the handle holds a pointer to a const callback table, in FLASH and shared
+      by the handles, instead of a pointer per callback in RAM.
+      Use function @ref HAL_TIM_RegisterCallbackTable() to set the table of a
+      handle, in HAL_TIM_STATE_RESET or HAL_TIM_STATE_READY state, all its
+      callbacks set: the weak ones where no user callback is needed.
+      A handle without a table gets the one of the weak callbacks at init.
+
   [..]
       When The compilation define USE_HAL_TIM_REGISTER_CALLBACKS is set to 0 or
       not defined, the callback registration feature is not available and all callbacks
@@ -203,6 +212,39 @@ all interrupt callbacks are set to the corresponding weak functions:
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+/* Callback table of the handles without one, the legacy weak callbacks, used by the TIMEx functions too */
+const TIM_CallbacksTypeDef TIM_DefaultCallbacks =
+{
+  .Base_MspInitCallback              = HAL_TIM_Base_MspInit,
+  .Base_MspDeInitCallback            = HAL_TIM_Base_MspDeInit,
+  .IC_MspInitCallback                = HAL_TIM_IC_MspInit,
+  .IC_MspDeInitCallback              = HAL_TIM_IC_MspDeInit,
+  .OC_MspInitCallback                = HAL_TIM_OC_MspInit,
+  .OC_MspDeInitCallback              = HAL_TIM_OC_MspDeInit,
+  .PWM_MspInitCallback               = HAL_TIM_PWM_MspInit,
+  .PWM_MspDeInitCallback             = HAL_TIM_PWM_MspDeInit,
+  .OnePulse_MspInitCallback          = HAL_TIM_OnePulse_MspInit,
+  .OnePulse_MspDeInitCallback        = HAL_TIM_OnePulse_MspDeInit,
+  .Encoder_MspInitCallback           = HAL_TIM_Encoder_MspInit,
+  .Encoder_MspDeInitCallback         = HAL_TIM_Encoder_MspDeInit,
+  .HallSensor_MspInitCallback        = HAL_TIMEx_HallSensor_MspInit,
+  .HallSensor_MspDeInitCallback      = HAL_TIMEx_HallSensor_MspDeInit,
+  .PeriodElapsedCallback             = HAL_TIM_PeriodElapsedCallback,
+  .PeriodElapsedHalfCpltCallback     = HAL_TIM_PeriodElapsedHalfCpltCallback,
+  .TriggerCallback                   = HAL_TIM_TriggerCallback,
+  .TriggerHalfCpltCallback           = HAL_TIM_TriggerHalfCpltCallback,
+  .IC_CaptureCallback                = HAL_TIM_IC_CaptureCallback,
+  .IC_CaptureHalfCpltCallback        = HAL_TIM_IC_CaptureHalfCpltCallback,
+  .OC_DelayElapsedCallback           = HAL_TIM_OC_DelayElapsedCallback,
+  .PWM_PulseFinishedCallback         = HAL_TIM_PWM_PulseFinishedCallback,
+  .PWM_PulseFinishedHalfCpltCallback = HAL_TIM_PWM_PulseFinishedHalfCpltCallback,
+  .ErrorCallback                     = HAL_TIM_ErrorCallback,
+  .CommutationCallback               = HAL_TIMEx_CommutCallback,
+  .CommutationHalfCpltCallback       = HAL_TIMEx_CommutHalfCpltCallback,
+  .BreakCallback                     = HAL_TIMEx_BreakCallback,
+};
+#endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
 /* Private function prototypes -----------------------------------------------*/
 /** @addtogroup TIM_Private_Functions
   * @{
@@ -294,6 +336,14 @@ HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->Base_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->Base_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_Base_MspInit(htim);
@@ -334,6 +384,14 @@ HAL_StatusTypeDef HAL_TIM_Base_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->Base_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->Base_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_Base_MspDeInit(htim);
@@ -626,6 +684,14 @@ HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef *htim)
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->OC_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->OC_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIM_OC_MspInit(htim);
@@ -666,6 +732,14 @@ HAL_StatusTypeDef HAL_TIM_OC_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->OC_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->OC_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC and DMA */
   HAL_TIM_OC_MspDeInit(htim);
@@ -1199,6 +1273,14 @@ HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->PWM_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->PWM_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIM_PWM_MspInit(htim);
@@ -1239,6 +1321,14 @@ HAL_StatusTypeDef HAL_TIM_PWM_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->PWM_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->PWM_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC and DMA */
   HAL_TIM_PWM_MspDeInit(htim);
@@ -1773,6 +1863,14 @@ HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim)
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->IC_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->IC_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIM_IC_MspInit(htim);
@@ -1813,6 +1911,14 @@ HAL_StatusTypeDef HAL_TIM_IC_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->IC_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->IC_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC and DMA */
   HAL_TIM_IC_MspDeInit(htim);
@@ -2313,6 +2419,14 @@ HAL_StatusTypeDef HAL_TIM_OnePulse_Init(TIM_HandleTypeDef *htim, uint32_t OnePul
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->OnePulse_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->OnePulse_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIM_OnePulse_MspInit(htim);
@@ -2359,6 +2473,14 @@ HAL_StatusTypeDef HAL_TIM_OnePulse_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->OnePulse_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->OnePulse_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_OnePulse_MspDeInit(htim);
@@ -2638,6 +2760,14 @@ HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim,  TIM_Encoder_Ini
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->Encoder_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->Encoder_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIM_Encoder_MspInit(htim);
@@ -2717,6 +2847,14 @@ HAL_StatusTypeDef HAL_TIM_Encoder_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->Encoder_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->Encoder_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_Encoder_MspDeInit(htim);
@@ -3182,6 +3320,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
         {
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
           htim->IC_CaptureCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+          htim->pCallbacks->IC_CaptureCallback(htim);
 #else
           HAL_TIM_IC_CaptureCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3192,6 +3332,9 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
           htim->OC_DelayElapsedCallback(htim);
           htim->PWM_PulseFinishedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+          htim->pCallbacks->OC_DelayElapsedCallback(htim);
+          htim->pCallbacks->PWM_PulseFinishedCallback(htim);
 #else
           HAL_TIM_OC_DelayElapsedCallback(htim);
           HAL_TIM_PWM_PulseFinishedCallback(htim);
@@ -3213,6 +3356,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       {
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->IC_CaptureCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->IC_CaptureCallback(htim);
 #else
         HAL_TIM_IC_CaptureCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3223,6 +3368,9 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->OC_DelayElapsedCallback(htim);
         htim->PWM_PulseFinishedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->OC_DelayElapsedCallback(htim);
+        htim->pCallbacks->PWM_PulseFinishedCallback(htim);
 #else
         HAL_TIM_OC_DelayElapsedCallback(htim);
         HAL_TIM_PWM_PulseFinishedCallback(htim);
@@ -3243,6 +3391,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       {
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->IC_CaptureCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->IC_CaptureCallback(htim);
 #else
         HAL_TIM_IC_CaptureCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3253,6 +3403,9 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->OC_DelayElapsedCallback(htim);
         htim->PWM_PulseFinishedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->OC_DelayElapsedCallback(htim);
+        htim->pCallbacks->PWM_PulseFinishedCallback(htim);
 #else
         HAL_TIM_OC_DelayElapsedCallback(htim);
         HAL_TIM_PWM_PulseFinishedCallback(htim);
@@ -3273,6 +3426,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       {
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->IC_CaptureCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->IC_CaptureCallback(htim);
 #else
         HAL_TIM_IC_CaptureCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3283,6 +3438,9 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
         htim->OC_DelayElapsedCallback(htim);
         htim->PWM_PulseFinishedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+        htim->pCallbacks->OC_DelayElapsedCallback(htim);
+        htim->pCallbacks->PWM_PulseFinishedCallback(htim);
 #else
         HAL_TIM_OC_DelayElapsedCallback(htim);
         HAL_TIM_PWM_PulseFinishedCallback(htim);
@@ -3299,6 +3457,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       __HAL_TIM_CLEAR_IT(htim, TIM_IT_UPDATE);
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
       htim->PeriodElapsedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+      htim->pCallbacks->PeriodElapsedCallback(htim);
 #else
       HAL_TIM_PeriodElapsedCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3312,6 +3472,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       __HAL_TIM_CLEAR_IT(htim, TIM_IT_BREAK);
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
       htim->BreakCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+      htim->pCallbacks->BreakCallback(htim);
 #else
       HAL_TIMEx_BreakCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3325,6 +3487,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       __HAL_TIM_CLEAR_IT(htim, TIM_IT_TRIGGER);
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
       htim->TriggerCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+      htim->pCallbacks->TriggerCallback(htim);
 #else
       HAL_TIM_TriggerCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -3338,6 +3502,8 @@ void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
       __HAL_TIM_CLEAR_IT(htim, TIM_FLAG_COM);
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
       htim->CommutationCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+      htim->pCallbacks->CommutationCallback(htim);
 #else
       HAL_TIMEx_CommutCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -5868,6 +6034,61 @@ HAL_StatusTypeDef HAL_TIM_UnRegisterCallback(TIM_HandleTypeDef *htim, HAL_TIM_Ca
 
   return status;
 }
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+/**
+  * @brief  Register a User TIM callback table
+  *         To be used instead of the weak predefined callbacks
+  * @note   The table is const, placed in FLASH and shared by the handles
+  *         having the same callbacks: each of its callbacks must be set,
+  *         to the weak predefined one when not needed.
+  * @param  htim tim handle
+  * @param  pCallbacks pointer to the callback table, NULL for the default one
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIM_RegisterCallbackTable(TIM_HandleTypeDef *htim, const TIM_CallbacksTypeDef *pCallbacks)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (pCallbacks == NULL)
+  {
+    pCallbacks = &TIM_DefaultCallbacks;
+  }
+  if ((pCallbacks->Base_MspInitCallback == NULL) || (pCallbacks->Base_MspDeInitCallback == NULL) ||
+      (pCallbacks->IC_MspInitCallback == NULL) || (pCallbacks->IC_MspDeInitCallback == NULL) ||
+      (pCallbacks->OC_MspInitCallback == NULL) || (pCallbacks->OC_MspDeInitCallback == NULL) ||
+      (pCallbacks->PWM_MspInitCallback == NULL) || (pCallbacks->PWM_MspDeInitCallback == NULL) ||
+      (pCallbacks->OnePulse_MspInitCallback == NULL) || (pCallbacks->OnePulse_MspDeInitCallback == NULL) ||
+      (pCallbacks->Encoder_MspInitCallback == NULL) || (pCallbacks->Encoder_MspDeInitCallback == NULL) ||
+      (pCallbacks->HallSensor_MspInitCallback == NULL) || (pCallbacks->HallSensor_MspDeInitCallback == NULL) ||
+      (pCallbacks->PeriodElapsedCallback == NULL) || (pCallbacks->PeriodElapsedHalfCpltCallback == NULL) ||
+      (pCallbacks->TriggerCallback == NULL) || (pCallbacks->TriggerHalfCpltCallback == NULL) ||
+      (pCallbacks->IC_CaptureCallback == NULL) || (pCallbacks->IC_CaptureHalfCpltCallback == NULL) ||
+      (pCallbacks->OC_DelayElapsedCallback == NULL) || (pCallbacks->PWM_PulseFinishedCallback == NULL) ||
+      (pCallbacks->PWM_PulseFinishedHalfCpltCallback == NULL) || (pCallbacks->ErrorCallback == NULL) ||
+      (pCallbacks->CommutationCallback == NULL) || (pCallbacks->CommutationHalfCpltCallback == NULL) ||
+      (pCallbacks->BreakCallback == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(htim);
+
+  if ((htim->State == HAL_TIM_STATE_READY) || (htim->State == HAL_TIM_STATE_RESET))
+  {
+    htim->pCallbacks = pCallbacks;
+  }
+  else
+  {
+    /* Return error status */
+    status =  HAL_ERROR;
+  }
+
+  /* Release Lock */
+  __HAL_UNLOCK(htim);
+
+  return status;
+}
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
 
 /**
@@ -5974,6 +6195,8 @@ void TIM_DMAError(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->ErrorCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->ErrorCallback(htim);
 #else
   HAL_TIM_ErrorCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6013,6 +6236,8 @@ void TIM_DMADelayPulseCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->PWM_PulseFinishedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PWM_PulseFinishedCallback(htim);
 #else
   HAL_TIM_PWM_PulseFinishedCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6054,6 +6279,8 @@ void TIM_DMADelayPulseHalfCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->PWM_PulseFinishedHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PWM_PulseFinishedHalfCpltCallback(htim);
 #else
   HAL_TIM_PWM_PulseFinishedHalfCpltCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6095,6 +6322,8 @@ void TIM_DMACaptureCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->IC_CaptureCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->IC_CaptureCallback(htim);
 #else
   HAL_TIM_IC_CaptureCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6136,6 +6365,8 @@ void TIM_DMACaptureHalfCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->IC_CaptureHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->IC_CaptureHalfCpltCallback(htim);
 #else
   HAL_TIM_IC_CaptureHalfCpltCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6156,6 +6387,8 @@ static void TIM_DMAPeriodElapsedCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->PeriodElapsedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PeriodElapsedCallback(htim);
 #else
   HAL_TIM_PeriodElapsedCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6174,6 +6407,8 @@ static void TIM_DMAPeriodElapsedHalfCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->PeriodElapsedHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PeriodElapsedHalfCpltCallback(htim);
 #else
   HAL_TIM_PeriodElapsedHalfCpltCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6192,6 +6427,8 @@ static void TIM_DMATriggerCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->TriggerCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->TriggerCallback(htim);
 #else
   HAL_TIM_TriggerCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -6210,6 +6447,8 @@ static void TIM_DMATriggerHalfCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->TriggerHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->TriggerHalfCpltCallback(htim);
 #else
   HAL_TIM_TriggerHalfCpltCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -10,6 +10,7 @@
   *           + Time Complementary signal break and dead time configuration
   *           + Time Master and Slave synchronization configuration
   *           + Timer remapping capabilities configuration
+  *           + Timer paced GPIO waveform output and capture
   @verbatim
   ==============================================================================
                       ##### TIMER Extended features #####
@@ -58,6 +59,20 @@
            (++) Complementary PWM generation : HAL_TIMEx_PWMN_Start(), HAL_TIMEx_PWMN_Start_DMA(), HAL_TIMEx_PWMN_Start_IT()
            (++) Complementary One-pulse mode output : HAL_TIMEx_OnePulseN_Start(), HAL_TIMEx_OnePulseN_Start_IT()
            (++) Hall Sensor output : HAL_TIMEx_HallSensor_Start(), HAL_TIMEx_HallSensor_Start_DMA(), HAL_TIMEx_HallSensor_Start_IT().
+           (++) GPIO waveform : HAL_TIMEx_GPIOWave_Start_DMA(), HAL_TIMEx_GPIOCapture_Start_DMA().
+
+     (#) GPIO waveform output and capture:
+          (++) Link a DMA channel to the update request of the timer, hdma[TIM_DMA_ID_UPDATE],
+               with word memory and peripheral data sizes for the output, or word peripheral
+               and half word memory data sizes for the capture. The circular DMA mode repeats
+               the waveform or fills the capture buffer continuously.
+          (++) Each update event of the timer writes one word of the buffer to the BSRR
+               register of the port, see __HAL_TIM_GPIO_BSRR(), or stores one sample of the
+               IDR register of the port. The pins and the timer period are set by the
+               application, only the DMA moves the data.
+          (++) The end of the buffer is reported by HAL_TIM_PeriodElapsedCallback() and the
+               half of it by HAL_TIM_PeriodElapsedHalfCpltCallback(). Use
+               HAL_TIM_Base_Stop_DMA() to stop.
 
   @endverbatim
   ******************************************************************************
@@ -97,6 +112,10 @@
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void TIM_CCxNChannelCmd(TIM_TypeDef *TIMx, uint32_t Channel, uint32_t ChannelNState);
+static HAL_StatusTypeDef TIMEx_GPIO_Start_DMA(TIM_HandleTypeDef *htim, uint32_t SrcAddress,
+                                              uint32_t DstAddress, uint16_t Length);
+static void TIMEx_DMAGPIOCplt(DMA_HandleTypeDef *hdma);
+static void TIMEx_DMAGPIOHalfCplt(DMA_HandleTypeDef *hdma);
 
 /* Exported functions --------------------------------------------------------*/
 /** @defgroup TIMEx_Exported_Functions TIM Extended Exported Functions
@@ -164,6 +183,14 @@ HAL_StatusTypeDef HAL_TIMEx_HallSensor_Init(TIM_HandleTypeDef *htim, TIM_HallSen
     }
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     htim->HallSensor_MspInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+    if (htim->pCallbacks == NULL)
+    {
+      htim->pCallbacks = &TIM_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware : GPIO, CLOCK, NVIC */
+    htim->pCallbacks->HallSensor_MspInitCallback(htim);
 #else
     /* Init the low level hardware : GPIO, CLOCK, NVIC and DMA */
     HAL_TIMEx_HallSensor_MspInit(htim);
@@ -239,6 +266,14 @@ HAL_StatusTypeDef HAL_TIMEx_HallSensor_DeInit(TIM_HandleTypeDef *htim)
   }
   /* DeInit the low level hardware */
   htim->HallSensor_MspDeInitCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  if (htim->pCallbacks == NULL)
+  {
+    htim->pCallbacks = &TIM_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  htim->pCallbacks->HallSensor_MspDeInitCallback(htim);
 #else
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIMEx_HallSensor_MspDeInit(htim);
@@ -1847,6 +1882,81 @@ HAL_TIM_StateTypeDef HAL_TIMEx_HallSensor_GetState(TIM_HandleTypeDef *htim)
   return htim->State;
 }
 
+/**
+  * @}
+  */
+
+/** @defgroup TIMEx_Exported_Functions_Group8 Extended Timer GPIO waveform functions
+  * @brief    Extended Timer GPIO waveform functions
+  *
+@verbatim
+  ==============================================================================
+                ##### Extended GPIO waveform functions #####
+  ==============================================================================
+  [..]
+    This section provides functions allowing to:
+      (+) Play a buffer of BSRR words on a GPIO port, one word per update event.
+      (+) Sample the IDR register of a GPIO port into a buffer, one sample per
+          update event.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Starts writing a buffer to the BSRR register of a GPIO port on each
+  *         update event.
+  * @note   The pins must be configured as outputs and the update DMA handle as
+  *         memory to peripheral with word data sizes.
+  * @param  htim TIM Base handle
+  * @param  GPIOx GPIO port, where x can be (A..E)
+  * @param  pData Buffer of BSRR words, see __HAL_TIM_GPIO_BSRR()
+  * @param  Length Number of words
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIMEx_GPIOWave_Start_DMA(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx,
+                                               const uint32_t *pData, uint16_t Length)
+{
+  /* Check the parameters */
+  assert_param(IS_TIM_DMA_INSTANCE(htim->Instance));
+  assert_param(IS_GPIO_ALL_INSTANCE(GPIOx));
+
+  if ((pData == NULL) || (Length == 0U) ||
+      (htim->hdma[TIM_DMA_ID_UPDATE]->Init.Direction != DMA_MEMORY_TO_PERIPH))
+  {
+    return HAL_ERROR;
+  }
+
+  return TIMEx_GPIO_Start_DMA(htim, (uint32_t)pData, (uint32_t)&GPIOx->BSRR, Length);
+}
+
+/**
+  * @brief  Starts sampling the IDR register of a GPIO port into a buffer on each
+  *         update event.
+  * @note   The update DMA handle must be configured as peripheral to memory with
+  *         a word peripheral data size and a half word memory data size.
+  * @param  htim TIM Base handle
+  * @param  GPIOx GPIO port, where x can be (A..E)
+  * @param  pData Buffer of samples
+  * @param  Length Number of samples
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIMEx_GPIOCapture_Start_DMA(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx,
+                                                  uint16_t *pData, uint16_t Length)
+{
+  /* Check the parameters */
+  assert_param(IS_TIM_DMA_INSTANCE(htim->Instance));
+  assert_param(IS_GPIO_ALL_INSTANCE(GPIOx));
+
+  if ((pData == NULL) || (Length == 0U) ||
+      (htim->hdma[TIM_DMA_ID_UPDATE]->Init.Direction != DMA_PERIPH_TO_MEMORY))
+  {
+    return HAL_ERROR;
+  }
+
+  return TIMEx_GPIO_Start_DMA(htim, (uint32_t)&GPIOx->IDR, (uint32_t)pData, Length);
+}
+
 /**
   * @}
   */
@@ -1874,6 +1984,8 @@ void TIMEx_DMACommutationCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->CommutationCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->CommutationCallback(htim);
 #else
   HAL_TIMEx_CommutCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
@@ -1893,12 +2005,103 @@ void TIMEx_DMACommutationHalfCplt(DMA_HandleTypeDef *hdma)
 
 #if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
   htim->CommutationHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->CommutationHalfCpltCallback(htim);
 #else
   HAL_TIMEx_CommutHalfCpltCallback(htim);
 #endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
 }
 
 
+/**
+  * @brief  Start the update DMA request of a timer between a buffer and a GPIO port.
+  * @param  htim TIM Base handle
+  * @param  SrcAddress DMA source address
+  * @param  DstAddress DMA destination address
+  * @param  Length Number of data items
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef TIMEx_GPIO_Start_DMA(TIM_HandleTypeDef *htim, uint32_t SrcAddress,
+                                              uint32_t DstAddress, uint16_t Length)
+{
+  uint32_t tmpsmcr;
+
+  if (htim->State != HAL_TIM_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+  htim->State = HAL_TIM_STATE_BUSY;
+
+  /* Set the DMA Period elapsed callbacks */
+  htim->hdma[TIM_DMA_ID_UPDATE]->XferCpltCallback = TIMEx_DMAGPIOCplt;
+  htim->hdma[TIM_DMA_ID_UPDATE]->XferHalfCpltCallback = TIMEx_DMAGPIOHalfCplt;
+
+  /* Set the DMA error callback */
+  htim->hdma[TIM_DMA_ID_UPDATE]->XferErrorCallback = TIM_DMAError ;
+
+  /* Enable the DMA channel */
+  if (HAL_DMA_Start_IT(htim->hdma[TIM_DMA_ID_UPDATE], SrcAddress, DstAddress, Length) != HAL_OK)
+  {
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  /* Enable the TIM Update DMA request */
+  __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+
+  /* Enable the Peripheral, except in trigger mode where enable is automatically done with trigger */
+  tmpsmcr = htim->Instance->SMCR & TIM_SMCR_SMS;
+  if (!IS_TIM_SLAVEMODE_TRIGGER_ENABLED(tmpsmcr))
+  {
+    __HAL_TIM_ENABLE(htim);
+  }
+
+  /* Return function status */
+  return HAL_OK;
+}
+
+/**
+  * @brief  TIM DMA GPIO waveform complete callback.
+  * @param  hdma pointer to DMA handle.
+  * @retval None
+  */
+static void TIMEx_DMAGPIOCplt(DMA_HandleTypeDef *hdma)
+{
+  TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;
+
+  /* Circular transfers keep the timer busy until HAL_TIM_Base_Stop_DMA() */
+  if (hdma->Init.Mode == DMA_NORMAL)
+  {
+    htim->State = HAL_TIM_STATE_READY;
+  }
+
+#if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
+  htim->PeriodElapsedCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PeriodElapsedCallback(htim);
+#else
+  HAL_TIM_PeriodElapsedCallback(htim);
+#endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
+}
+
+/**
+  * @brief  TIM DMA GPIO waveform half complete callback.
+  * @param  hdma pointer to DMA handle.
+  * @retval None
+  */
+static void TIMEx_DMAGPIOHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;
+
+#if (USE_HAL_TIM_REGISTER_CALLBACKS == 1)
+  htim->PeriodElapsedHalfCpltCallback(htim);
+#elif (USE_HAL_TIM_REGISTER_CALLBACKS == 2)
+  htim->pCallbacks->PeriodElapsedHalfCpltCallback(htim);
+#else
+  HAL_TIM_PeriodElapsedHalfCpltCallback(htim);
+#endif /* USE_HAL_TIM_REGISTER_CALLBACKS */
+}
+
 /**
   * @brief  Enables or disables the TIM Capture Compare Channel xN.
   * @param  TIMx to select the TIM peripheral
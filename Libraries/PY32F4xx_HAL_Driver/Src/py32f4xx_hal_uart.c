@@ -123,6 +123,15 @@
     using @ref HAL_UART_RegisterCallback() before calling @ref HAL_UART_DeInit()
     or @ref HAL_UART_Init() function.
 
+    [..]
+    When The compilation define USE_HAL_UART_REGISTER_CALLBACKS is set to 2,
+    the handle holds a pointer to a const callback table, in FLASH and shared
+    by the handles, instead of a pointer per callback in RAM.
+    Use function @ref HAL_UART_RegisterCallbackTable() to set the table of a
+    handle, in HAL_UART_STATE_RESET or HAL_UART_STATE_READY state, all its
+    callbacks set: the weak ones where no user callback is needed.
+    A handle without a table gets the one of the weak callbacks at init.
+
     [..]
     When The compilation define USE_HAL_UART_REGISTER_CALLBACKS is set to 0 or
     not defined, the callback registration feature is not available
@@ -241,6 +250,23 @@
   */
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+/* Callback table of the handles without one, the legacy weak callbacks */
+static const UART_CallbacksTypeDef UART_DefaultCallbacks =
+{
+  .TxHalfCpltCallback        = HAL_UART_TxHalfCpltCallback,
+  .TxCpltCallback            = HAL_UART_TxCpltCallback,
+  .RxHalfCpltCallback        = HAL_UART_RxHalfCpltCallback,
+  .RxCpltCallback            = HAL_UART_RxCpltCallback,
+  .ErrorCallback             = HAL_UART_ErrorCallback,
+  .AbortCpltCallback         = HAL_UART_AbortCpltCallback,
+  .AbortTransmitCpltCallback = HAL_UART_AbortTransmitCpltCallback,
+  .AbortReceiveCpltCallback  = HAL_UART_AbortReceiveCpltCallback,
+  .RxFrameCallback           = HAL_UARTEx_RxFrameCallback,
+  .MspInitCallback           = HAL_UART_MspInit,
+  .MspDeInitCallback         = HAL_UART_MspDeInit,
+};
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 /* Private function prototypes -----------------------------------------------*/
 /** @addtogroup UART_Private_Functions  UART Private Functions
   * @{
@@ -251,6 +277,11 @@ void UART_InitCallbacksToDefault(UART_HandleTypeDef *huart);
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 static void UART_EndTxTransfer(UART_HandleTypeDef *huart);
 static void UART_EndRxTransfer(UART_HandleTypeDef *huart);
+static HAL_StatusTypeDef UART_Start_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+static void UART_RxFrameEvent(UART_HandleTypeDef *huart);
+#if (USE_HAL_UART_FAST_IRQ == 1U)
+static void UART_IRQHandler(UART_HandleTypeDef *huart);
+#endif /* USE_HAL_UART_FAST_IRQ */
 static void UART_DMATransmitCplt(DMA_HandleTypeDef *hdma);
 static void UART_DMAReceiveCplt(DMA_HandleTypeDef *hdma);
 static void UART_DMATxHalfCplt(DMA_HandleTypeDef *hdma);
@@ -266,6 +297,7 @@ static HAL_StatusTypeDef UART_EndTransmit_IT(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart, uint32_t Flag, FlagStatus Status, uint32_t Tickstart, uint32_t Timeout);
 static void UART_SetConfig(UART_HandleTypeDef *huart);
+static void UART_SetBRR(UART_HandleTypeDef *huart);
 static void UART_AdvFeatureConfig(UART_HandleTypeDef *huart);
 /**
   * @}
@@ -351,6 +383,14 @@ HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
 
     /* Init the low level hardware */
     huart->MspInitCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    if (huart->pCallbacks == NULL)
+    {
+      huart->pCallbacks = &UART_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware */
+    huart->pCallbacks->MspInitCallback(huart);
 #else
     /* Init the low level hardware : GPIO, CLOCK */
     HAL_UART_MspInit(huart);
@@ -424,6 +464,14 @@ HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
 
     /* Init the low level hardware */
     huart->MspInitCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    if (huart->pCallbacks == NULL)
+    {
+      huart->pCallbacks = &UART_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware */
+    huart->pCallbacks->MspInitCallback(huart);
 #else
     /* Init the low level hardware : GPIO, CLOCK */
     HAL_UART_MspInit(huart);
@@ -503,6 +551,14 @@ HAL_StatusTypeDef HAL_LIN_Init(UART_HandleTypeDef *huart, uint32_t BreakDetectLe
 
     /* Init the low level hardware */
     huart->MspInitCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    if (huart->pCallbacks == NULL)
+    {
+      huart->pCallbacks = &UART_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware */
+    huart->pCallbacks->MspInitCallback(huart);
 #else
     /* Init the low level hardware : GPIO, CLOCK */
     HAL_UART_MspInit(huart);
@@ -591,6 +647,14 @@ HAL_StatusTypeDef HAL_MultiProcessor_Init(UART_HandleTypeDef *huart, uint8_t Add
 
     /* Init the low level hardware */
     huart->MspInitCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    if (huart->pCallbacks == NULL)
+    {
+      huart->pCallbacks = &UART_DefaultCallbacks;
+    }
+
+    /* Init the low level hardware */
+    huart->pCallbacks->MspInitCallback(huart);
 #else
     /* Init the low level hardware : GPIO, CLOCK */
     HAL_UART_MspInit(huart);
@@ -659,6 +723,14 @@ HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
   }
   /* DeInit the low level hardware */
   huart->MspDeInitCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  if (huart->pCallbacks == NULL)
+  {
+    huart->pCallbacks = &UART_DefaultCallbacks;
+  }
+
+  /* DeInit the low level hardware */
+  huart->pCallbacks->MspDeInitCallback(huart);
 #else
   /* DeInit the low level hardware */
   HAL_UART_MspDeInit(huart);
@@ -940,6 +1012,124 @@ HAL_StatusTypeDef HAL_UART_UnRegisterCallback(UART_HandleTypeDef *huart, HAL_UAR
 
   return status;
 }
+
+/**
+  * @brief  Register a User UART Rx Frame Callback
+  *         To be used instead of the weak predefined callback
+  * @param  huart     Uart handle
+  * @param  pCallback Pointer to the Rx Frame Callback function
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_RegisterRxFrameCallback(UART_HandleTypeDef *huart, pUART_RxFrameCallbackTypeDef pCallback)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (pCallback == NULL)
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_INVALID_CALLBACK;
+
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(huart);
+
+  if (huart->gState == HAL_UART_STATE_READY)
+  {
+    huart->RxFrameCallback = pCallback;
+  }
+  else
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_INVALID_CALLBACK;
+
+    status =  HAL_ERROR;
+  }
+
+  /* Release Lock */
+  __HAL_UNLOCK(huart);
+
+  return status;
+}
+
+/**
+  * @brief  UnRegister the UART Rx Frame Callback
+  *         UART Rx Frame Callback is redirected to the weak HAL_UARTEx_RxFrameCallback() predefined callback
+  * @param  huart     Uart handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_UnRegisterRxFrameCallback(UART_HandleTypeDef *huart)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* Process locked */
+  __HAL_LOCK(huart);
+
+  if (huart->gState == HAL_UART_STATE_READY)
+  {
+    huart->RxFrameCallback = HAL_UARTEx_RxFrameCallback; /* Legacy weak UART Rx Frame Callback  */
+  }
+  else
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_INVALID_CALLBACK;
+
+    status =  HAL_ERROR;
+  }
+
+  /* Release Lock */
+  __HAL_UNLOCK(huart);
+
+  return status;
+}
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+/**
+  * @brief  Register a User UART callback table
+  *         To be used instead of the weak predefined callbacks
+  * @note   The table is const, placed in FLASH and shared by the handles
+  *         having the same callbacks: each of its callbacks must be set,
+  *         to the weak predefined one when not needed.
+  * @param  huart uart handle
+  * @param  pCallbacks pointer to the callback table, NULL for the default one
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_RegisterCallbackTable(UART_HandleTypeDef *huart, const UART_CallbacksTypeDef *pCallbacks)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (pCallbacks == NULL)
+  {
+    pCallbacks = &UART_DefaultCallbacks;
+  }
+  if ((pCallbacks->TxHalfCpltCallback == NULL) || (pCallbacks->TxCpltCallback == NULL) ||
+      (pCallbacks->RxHalfCpltCallback == NULL) || (pCallbacks->RxCpltCallback == NULL) ||
+      (pCallbacks->ErrorCallback == NULL) || (pCallbacks->AbortCpltCallback == NULL) ||
+      (pCallbacks->AbortTransmitCpltCallback == NULL) || (pCallbacks->AbortReceiveCpltCallback == NULL) ||
+      (pCallbacks->RxFrameCallback == NULL) ||
+      (pCallbacks->MspInitCallback == NULL) || (pCallbacks->MspDeInitCallback == NULL))
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_INVALID_CALLBACK;
+
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(huart);
+
+  if ((huart->gState == HAL_UART_STATE_READY) || (huart->gState == HAL_UART_STATE_RESET))
+  {
+    huart->pCallbacks = pCallbacks;
+  }
+  else
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_INVALID_CALLBACK;
+
+    status =  HAL_ERROR;
+  }
+
+  /* Release Lock */
+  __HAL_UNLOCK(huart);
+
+  return status;
+}
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 
 /**
@@ -985,12 +1175,26 @@ HAL_StatusTypeDef HAL_UART_UnRegisterCallback(UART_HandleTypeDef *huart, HAL_UAR
         (+) HAL_UART_DMAResume()
         (+) HAL_UART_DMAStop()
 
+    (#) Non-Blocking mode API's with DMA and IDLE line framing are :
+        (+) HAL_UARTEx_ReceiveToIdle_DMA()
+        With a circular Rx DMA channel the reception never stops: each IDLE
+        line, half transfer and transfer complete event reports the bytes
+        received since the previous event, as an offset and a length in the
+        buffer, through HAL_UARTEx_RxFrameCallback(). A frame crossing the end
+        of the buffer is reported in two parts.
+        With USE_HAL_UART_RX_TIMESTAMP set to 1U in py32f4xx_hal_conf.h, the
+        DWT cycle counts of the first byte and of the report of the frame are
+        read with HAL_UARTEx_GetRxTimestamp() from the callback, and
+        HAL_UARTEx_GetCharCycles() gives the duration of one character, e.g.
+        to check the 3.5 character silence between two Modbus RTU frames.
+
     (#) A set of Transfer Complete Callbacks are provided in Non_Blocking mode:
         (+) HAL_UART_TxHalfCpltCallback()
         (+) HAL_UART_TxCpltCallback()
         (+) HAL_UART_RxHalfCpltCallback()
         (+) HAL_UART_RxCpltCallback()
         (+) HAL_UART_ErrorCallback()
+        (+) HAL_UARTEx_RxFrameCallback()
 
     (#) Non-Blocking mode transfers could be aborted using Abort API's :
         (+) HAL_UART_Abort()
@@ -1162,6 +1366,7 @@ HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, ui
     __HAL_LOCK(huart);
 
     huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
     huart->RxState = HAL_UART_STATE_BUSY_RX;
 
     /* Init tickstart for timeout managment */
@@ -1280,6 +1485,14 @@ HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData,
       return HAL_ERROR;
     }
 
+#if (USE_HAL_UART_FAST_IRQ == 1U)
+    /* The fast IRQ path only stores 8 data bits */
+    if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE))
+    {
+      return HAL_ERROR;
+    }
+#endif /* USE_HAL_UART_FAST_IRQ */
+
     /* Process Locked */
     __HAL_LOCK(huart);
 
@@ -1288,6 +1501,7 @@ HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData,
     huart->RxXferCount = Size;
 
     huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
     huart->RxState = HAL_UART_STATE_BUSY_RX;
 
     /* Process Unlocked */
@@ -1391,7 +1605,6 @@ HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pDat
   */
 HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
 {
-
   /* Check that a Rx process is not already ongoing */
   if (huart->RxState == HAL_UART_STATE_READY)
   {
@@ -1399,62 +1612,102 @@ HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData
     {
       return HAL_ERROR;
     }
-    /* In case of 9bits/No Parity transfer, pData buffer provided as input parameter
-       should be aligned on a u16 frontier, as data copy from RDR will be
-       handled by DMA from a u16 frontier. */
-    if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE))
-    {
-      if ((((uint32_t)pData) & 1U) != 0U)
-      {
-        return  HAL_ERROR;
-      }
-    }
-    /* Process Locked */
-    __HAL_LOCK(huart);
 
-    huart->pRxBuffPtr = pData;
-    huart->RxXferSize = Size;
-
-    huart->ErrorCode = HAL_UART_ERROR_NONE;
-    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    /* Set Reception type to Standard reception */
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
-    /* Set the UART DMA transfer complete callback */
-    huart->hdmarx->XferCpltCallback = UART_DMAReceiveCplt;
+    return UART_Start_Receive_DMA(huart, pData, Size);
+  }
+  else
+  {
+    return HAL_BUSY;
+  }
+}
 
-    /* Set the UART DMA Half transfer complete callback */
-    huart->hdmarx->XferHalfCpltCallback = UART_DMARxHalfCplt;
+/**
+  * @brief  Receives data continuously in DMA mode, reporting frames on IDLE line events.
+  * @note   With the Rx DMA handle in DMA_CIRCULAR mode, the reception runs until
+  *         HAL_UART_DMAStop() or an abort. Each IDLE line, half transfer and
+  *         transfer complete event reports the bytes received since the previous
+  *         event through HAL_UARTEx_RxFrameCallback(), as an offset and a length
+  *         in pData. In DMA_NORMAL mode the reception ends when the buffer is full.
+  * @note   When UART parity is not enabled (PCE = 0), and Word Length is configured to 9 bits (M1-M0 = 01),
+  *         the received data is handled as a set of u16, offsets and lengths are then counted in u16.
+  * @param  huart Pointer to a UART_HandleTypeDef structure that contains
+  *               the configuration information for the specified UART module.
+  * @param  pData Pointer to data buffer (u8 or u16 data elements).
+  * @param  Size  Amount of data elements (u8 or u16) in the buffer.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
 
-    /* Set the DMA error callback */
-    huart->hdmarx->XferErrorCallback = UART_DMAError;
+  /* Check that a Rx process is not already ongoing */
+  if (huart->RxState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
 
-    /* Set the DMA abort callback */
-    huart->hdmarx->XferAbortCallback = NULL;
+  if ((pData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
 
-    /* Enable the DMA channel */
-    HAL_DMA_Start_IT(huart->hdmarx, (uint32_t)&huart->Instance->DR,(uint32_t)huart->pRxBuffPtr, Size);
+  /* Set Reception type to reception till IDLE Event, first frame at the buffer start */
+  huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+  huart->RxFramePos = 0U;
 
-    /* Clear the Overrun flag just before enabling the DMA Rx request: can be mandatory for the second transfer */
-    __HAL_UART_CLEAR_OREFLAG(huart);
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+  /* Start the cycle counter if nobody did */
+  HAL_EnableCycleCounter();
+  huart->RxTimestamp.End = DWT->CYCCNT;
+  huart->RxStartCycle = huart->RxTimestamp.End;
 
-    /* Process Unlocked */
-    __HAL_UNLOCK(huart);
+  /* RXNEIE only timestamps the first byte, keep the interrupt reception path out of it */
+  huart->RxXferCount = 0U;
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
 
-    /* Enable the UART Parity Error Interrupt */
-    SET_BIT(huart->Instance->CR1, USART_CR1_PEIE);
+  status = UART_Start_Receive_DMA(huart, pData, Size);
 
-    /* Enable the UART Error Interrupt: (Frame error, noise error, overrun error) */
-    SET_BIT(huart->Instance->CR3, USART_CR3_EIE);
+  if (status == HAL_OK)
+  {
+    __HAL_UART_CLEAR_IDLEFLAG(huart);
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+    SET_BIT(huart->Instance->CR1, USART_CR1_IDLEIE | USART_CR1_RXNEIE);
+#else
+    SET_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+  }
 
-    /* Enable the DMA transfer for the receiver request by setting the DMAR bit
-    in the UART CR3 register */
-    SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+  return status;
+}
 
-    return HAL_OK;
-  }
-  else
+/**
+  * @brief  Receives data continuously in DMA mode into a ring buffer.
+  * @note   The Rx DMA handle must be initialized in DMA_CIRCULAR mode. Received
+  *         data is read in place with HAL_DMAEx_RingAcquire() and released with
+  *         HAL_DMAEx_RingCommit(), the reception runs until HAL_UART_DMAStop()
+  *         or HAL_UART_AbortReceive() is called.
+  * @param  huart Pointer to a UART_HandleTypeDef structure that contains
+  *               the configuration information for the specified UART module.
+  * @param  pRing Ring buffer initialized with HAL_DMAEx_RingInit().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_ReceiveToRing_DMA(UART_HandleTypeDef *huart, DMA_RingTypeDef *pRing)
+{
+  /* Check that a Rx process is not already ongoing */
+  if (huart->RxState != HAL_UART_STATE_READY)
   {
     return HAL_BUSY;
   }
+
+  if (HAL_DMAEx_RingAttach(pRing, huart->hdmarx) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_UART_Receive_DMA(huart, pRing->pBuffer, (uint16_t)pRing->Items);
 }
 
 /**
@@ -1594,6 +1847,12 @@ HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
   CLEAR_BIT(huart->Instance->CR1, (USART_CR1_RXNEIE | USART_CR1_PEIE | USART_CR1_TXEIE | USART_CR1_TCIE));
   CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
 
+  /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  }
+
   /* Disable the UART DMA Tx request if enabled */
   if (HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAT))
   {
@@ -1653,6 +1912,7 @@ HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
 
   /* Restore huart->RxState and huart->gState to Ready */
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
   huart->gState = HAL_UART_STATE_READY;
 
   return HAL_OK;
@@ -1727,6 +1987,12 @@ HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
   CLEAR_BIT(huart->Instance->CR1, (USART_CR1_RXNEIE | USART_CR1_PEIE));
   CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
 
+  /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  }
+
   /* Disable the UART DMA Rx request if enabled */
   if (HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR))
   {
@@ -1757,6 +2023,7 @@ HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
 
   /* Restore huart->RxState to Ready */
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
   return HAL_OK;
 }
@@ -1783,6 +2050,12 @@ HAL_StatusTypeDef HAL_UART_Abort_IT(UART_HandleTypeDef *huart)
   CLEAR_BIT(huart->Instance->CR1, (USART_CR1_RXNEIE | USART_CR1_PEIE | USART_CR1_TXEIE | USART_CR1_TCIE));
   CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
 
+  /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  }
+
   /* If DMA Tx and/or DMA Rx Handles are associated to UART Handle, DMA Abort complete callbacks should be initialised
      before any call to DMA Abort functions */
   /* DMA Tx Handle is valid */
@@ -1875,11 +2148,14 @@ HAL_StatusTypeDef HAL_UART_Abort_IT(UART_HandleTypeDef *huart)
     /* Restore huart->gState and huart->RxState to Ready */
     huart->gState  = HAL_UART_STATE_READY;
     huart->RxState = HAL_UART_STATE_READY;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
     /* As no DMA to be aborted, call directly user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
     /* Call registered Abort complete callback */
     huart->AbortCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->AbortCpltCallback(huart);
 #else
     /* Call legacy weak Abort complete callback */
     HAL_UART_AbortCpltCallback(huart);
@@ -1939,6 +2215,8 @@ HAL_StatusTypeDef HAL_UART_AbortTransmit_IT(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
       /* Call registered Abort Transmit Complete Callback */
       huart->AbortTransmitCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+      huart->pCallbacks->AbortTransmitCpltCallback(huart);
 #else
       /* Call legacy weak Abort Transmit Complete Callback */
       HAL_UART_AbortTransmitCpltCallback(huart);
@@ -1957,6 +2235,8 @@ HAL_StatusTypeDef HAL_UART_AbortTransmit_IT(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
     /* Call registered Abort Transmit Complete Callback */
     huart->AbortTransmitCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->AbortTransmitCpltCallback(huart);
 #else
     /* Call legacy weak Abort Transmit Complete Callback */
     HAL_UART_AbortTransmitCpltCallback(huart);
@@ -1986,6 +2266,12 @@ HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
   CLEAR_BIT(huart->Instance->CR1, (USART_CR1_RXNEIE | USART_CR1_PEIE));
   CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
 
+  /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  }
+
   /* Disable the UART DMA Rx request if enabled */
   if (HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR))
   {
@@ -2012,11 +2298,14 @@ HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
 
       /* Restore huart->RxState to Ready */
       huart->RxState = HAL_UART_STATE_READY;
+      huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
       /* As no DMA to be aborted, call directly user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
       /* Call registered Abort Receive Complete Callback */
       huart->AbortReceiveCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+      huart->pCallbacks->AbortReceiveCpltCallback(huart);
 #else
       /* Call legacy weak Abort Receive Complete Callback */
       HAL_UART_AbortReceiveCpltCallback(huart);
@@ -2030,11 +2319,14 @@ HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
 
     /* Restore huart->RxState to Ready */
     huart->RxState = HAL_UART_STATE_READY;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
     /* As no DMA to be aborted, call directly user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
     /* Call registered Abort Receive Complete Callback */
     huart->AbortReceiveCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->AbortReceiveCpltCallback(huart);
 #else
     /* Call legacy weak Abort Receive Complete Callback */
     HAL_UART_AbortReceiveCpltCallback(huart);
@@ -2044,6 +2336,41 @@ HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
   return HAL_OK;
 }
 
+#if (USE_HAL_UART_FAST_IRQ == 1U)
+/**
+  * @brief  This function handles UART interrupt request.
+  * @note   Fast IRQ path (USE_HAL_UART_FAST_IRQ): an error free received byte of an
+  *         interrupt reception is stored with two register reads and no call,
+  *         the last byte and every other event go through UART_IRQHandler().
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+  USART_TypeDef *instance = huart->Instance;
+  uint32_t isrflags = READ_REG(instance->SR);
+
+  if (((isrflags & (USART_SR_RXNE | USART_SR_PE | USART_SR_FE | USART_SR_ORE | USART_SR_NE)) == USART_SR_RXNE) &&
+      (huart->RxXferCount > 1U) && (huart->RxState == HAL_UART_STATE_BUSY_RX) &&
+      ((READ_REG(instance->CR1) & USART_CR1_RXNEIE) != 0U))
+  {
+    *huart->pRxBuffPtr++ = (uint8_t)(instance->DR & (uint8_t)0x00FF);
+    huart->RxXferCount--;
+    return;
+  }
+
+  UART_IRQHandler(huart);
+}
+
+/**
+  * @brief  Generic UART interrupt request handling of the fast IRQ path.
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+static void UART_IRQHandler(UART_HandleTypeDef *huart)
+#else
 /**
   * @brief  This function handles UART interrupt request.
   * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
@@ -2051,13 +2378,28 @@ HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef *huart)
   * @retval None
   */
 void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+#endif /* USE_HAL_UART_FAST_IRQ */
 {
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+  uint32_t cycles     = DWT->CYCCNT;
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
   uint32_t isrflags   = READ_REG(huart->Instance->SR);
   uint32_t cr1its     = READ_REG(huart->Instance->CR1);
   uint32_t cr3its     = READ_REG(huart->Instance->CR3);
   uint32_t errorflags = 0x00U;
   uint32_t dmarequest = 0x00U;
 
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+  /* First byte of a frame in reception till idle mode: the DMA reads the data,
+     RXNEIE was only armed to timestamp it */
+  if (((cr1its & USART_CR1_RXNEIE) != RESET) && (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE))
+  {
+    huart->RxStartCycle = cycles;
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_RXNEIE);
+    cr1its &= ~USART_CR1_RXNEIE;
+  }
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
   /* If no error occurs */
   errorflags = (isrflags & (uint32_t)(USART_SR_PE | USART_SR_FE | USART_SR_ORE | USART_SR_NE));
   if (errorflags == RESET)
@@ -2139,6 +2481,8 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
             /*Call registered error callback*/
             huart->ErrorCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+            huart->pCallbacks->ErrorCallback(huart);
 #else
             /*Call legacy weak error callback*/
             HAL_UART_ErrorCallback(huart);
@@ -2151,6 +2495,8 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
           /*Call registered error callback*/
           huart->ErrorCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+          huart->pCallbacks->ErrorCallback(huart);
 #else
           /*Call legacy weak error callback*/
           HAL_UART_ErrorCallback(huart);
@@ -2164,6 +2510,8 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
         /*Call registered error callback*/
         huart->ErrorCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+        huart->pCallbacks->ErrorCallback(huart);
 #else
         /*Call legacy weak error callback*/
         HAL_UART_ErrorCallback(huart);
@@ -2179,8 +2527,15 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
   if (((isrflags & USART_SR_IDLE) != RESET) && ((cr1its & USART_CR1_IDLEIE) != RESET))
   {
     __HAL_UART_CLEAR_IDLEFLAG(huart);
-    
-    HAL_UART_IdleFrameDetectCpltCallback(huart);
+
+    if ((huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE) && (huart->RxState == HAL_UART_STATE_BUSY_RX))
+    {
+      UART_RxFrameEvent(huart);
+    }
+    else
+    {
+      HAL_UART_IdleFrameDetectCpltCallback(huart);
+    }
   }
 
   /* UART in mode Transmitter ------------------------------------------------*/
@@ -2333,6 +2688,64 @@ __weak void HAL_UART_IdleFrameDetectCpltCallback(UART_HandleTypeDef *huart)
    */
 }
 
+/**
+  * @brief  Reception frame callback (Rx frame reported in reception till idle mode).
+  * @param  huart UART handle
+  * @param  Offset Offset of the frame in the reception buffer, in data elements.
+  * @param  Length Number of data elements of the frame.
+  * @retval None
+  */
+__weak void HAL_UARTEx_RxFrameCallback(UART_HandleTypeDef *huart, uint16_t Offset, uint16_t Length)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(huart);
+  UNUSED(Offset);
+  UNUSED(Length);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_UARTEx_RxFrameCallback can be implemented in the user file.
+   */
+}
+
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+/**
+  * @brief  Read the timestamps of the frame reported in reception till idle mode.
+  * @note   To be called from HAL_UARTEx_RxFrameCallback(), both parts of a frame
+  *         crossing the end of the buffer carry the same timestamps. Start is
+  *         taken in the UART interrupt, its latency adds to the value.
+  * @param  huart Pointer to a UART_HandleTypeDef structure that contains
+  *               the configuration information for the specified UART module.
+  * @param  pTimestamp Timestamps of the frame, in DWT->CYCCNT cycles.
+  * @retval None
+  */
+void HAL_UARTEx_GetRxTimestamp(UART_HandleTypeDef *huart, UART_RxTimestampTypeDef *pTimestamp)
+{
+  pTimestamp->Start = huart->RxTimestamp.Start;
+  pTimestamp->End   = huart->RxTimestamp.End;
+}
+
+/**
+  * @brief  Return the duration of one character in core cycles.
+  * @note   Start, data, parity and stop bits at the baud rate programmed in the UART.
+  * @param  huart Pointer to a UART_HandleTypeDef structure that contains
+  *               the configuration information for the specified UART module.
+  * @retval Number of DWT->CYCCNT cycles, 0 when the baud rate is not set
+  */
+uint32_t HAL_UARTEx_GetCharCycles(UART_HandleTypeDef *huart)
+{
+  uint32_t baudrate = HAL_UARTEx_GetBaudRate(huart);
+  uint32_t bits = 1U + ((huart->Init.WordLength == UART_WORDLENGTH_9B) ? 9U : 8U) +
+                  ((huart->Init.StopBits == UART_STOPBITS_2) ? 2U : 1U);
+
+  if (baudrate == 0U)
+  {
+    return 0U;
+  }
+
+  return ((HAL_RCC_GetHCLKFreq() * bits) + (baudrate / 2U)) / baudrate;
+}
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
 /**
   * @}
   */
@@ -2351,6 +2764,9 @@ __weak void HAL_UART_IdleFrameDetectCpltCallback(UART_HandleTypeDef *huart)
     (+) HAL_MultiProcessor_ExitMuteMode() API can be helpful to exit the UART mute mode by software.
     (+) HAL_HalfDuplex_EnableTransmitter() API to enable the UART transmitter and disables the UART receiver in Half Duplex mode
     (+) HAL_HalfDuplex_EnableReceiver() API to enable the UART receiver and disables the UART transmitter in Half Duplex mode
+    (+) HAL_UARTEx_SetBaudRate() API to change the baud rate without HAL_UART_DeInit() and HAL_UART_Init()
+    (+) HAL_UARTEx_GetBaudRate() API to read back the baud rate programmed in the UART
+    (+) HAL_UARTEx_AutoBaudRate() API to measure the baud rate of the peer with the auto baud rate detection unit
 
 @endverbatim
   * @{
@@ -2507,6 +2923,151 @@ HAL_StatusTypeDef HAL_HalfDuplex_EnableReceiver(UART_HandleTypeDef *huart)
   return HAL_OK;
 }
 
+/**
+  * @brief  Change the baud rate of an initialized UART.
+  * @note   Only the BRR register is written, computed from the current PCLK
+  *         frequency: the MSP and the other parameters are kept. Call it again
+  *         after a PCLK frequency change.
+  * @note   The transmitter must be idle. A reception in progress goes on at the
+  *         new rate, the frame being received when BRR is written is lost.
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  BaudRate New baud rate.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_SetBaudRate(UART_HandleTypeDef *huart, uint32_t BaudRate)
+{
+  /* Check the parameters */
+  assert_param(IS_UART_BAUDRATE(BaudRate));
+
+  if ((BaudRate == 0U) || (huart->gState == HAL_UART_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+  if (huart->gState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(huart);
+
+  huart->Init.BaudRate = BaudRate;
+  UART_SetBRR(huart);
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(huart);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the baud rate programmed in the UART.
+  * @note   The value is computed back from BRR and the current PCLK frequency,
+  *         it reflects the result of an auto baud rate detection.
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval Baud rate, 0 when BRR is not programmed
+  */
+uint32_t HAL_UARTEx_GetBaudRate(UART_HandleTypeDef *huart)
+{
+  uint32_t pclk;
+  uint32_t brr = READ_REG(huart->Instance->BRR) & 0xFFFFU;
+
+  if (huart->Instance == USART1)
+  {
+    pclk = HAL_RCC_GetPCLK2Freq();
+  }
+  else
+  {
+    pclk = HAL_RCC_GetPCLK1Freq();
+  }
+
+#if defined(USART_CR3_OVER8)
+  /* In 8 times oversampling the fraction has 3 bits, BRR[3] is not used */
+  if (HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_OVER8))
+  {
+    brr = ((brr >> 4U) << 3U) | (brr & 0x07U);
+  }
+#endif /* USART_CR3_OVER8 */
+
+  if (brr == 0U)
+  {
+    return 0U;
+  }
+  return (pclk + (brr / 2U)) / brr;
+}
+
+/**
+  * @brief  Measure the baud rate of the peer with the auto baud rate detection unit.
+  * @note   The function waits for the peer to send the measurement character:
+  *         any character starting with a 1 bit for UART_ADVFEATURE_AUTOBAUDRATE_ONSTARTBIT,
+  *         a character starting with 10xx bits for UART_ADVFEATURE_AUTOBAUDRATE_ONFALLINGEDGE.
+  *         BRR is then programmed by the hardware and huart->Init.BaudRate updated.
+  * @note   The measurement character is received as a normal character.
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  Mode Detection mode, a value of @ref UART_AutoBaud_Rate_Mode.
+  * @param  Timeout Timeout duration.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_AutoBaudRate(UART_HandleTypeDef *huart, uint32_t Mode, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t tickstart;
+  uint32_t cr3;
+
+  /* Check the parameters */
+  assert_param(IS_USART_AUTOBAUDRATE_DETECTION_INSTANCE(huart->Instance));
+  assert_param(IS_UART_ADVFEATURE_AUTOBAUDRATEMODE(Mode));
+
+  if (huart->RxState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(huart);
+
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+
+  /* Start a new detection, the request clears ABRF */
+  cr3 = READ_REG(huart->Instance->CR3);
+  MODIFY_REG(huart->Instance->CR3, (USART_CR3_ABREN | USART_CR3_ABRMOD), (USART_CR3_ABREN | Mode));
+  __HAL_UART_SEND_AUTOBAUD_REQ(huart);
+
+  tickstart = HAL_GetTick();
+  while ((READ_REG(huart->Instance->SR) & (USART_SR_ABRF | USART_SR_ABRE)) == 0U)
+  {
+    if ((Timeout != HAL_MAX_DELAY) && ((Timeout == 0U) || ((HAL_GetTick() - tickstart) > Timeout)))
+    {
+      status = HAL_TIMEOUT;
+      break;
+    }
+  }
+
+  if ((status == HAL_OK) && (HAL_IS_BIT_SET(huart->Instance->SR, USART_SR_ABRE)))
+  {
+    status = HAL_ERROR;
+  }
+
+  /* Restore the detection setting of HAL_UART_Init() */
+  MODIFY_REG(huart->Instance->CR3, (USART_CR3_ABREN | USART_CR3_ABRMOD), (cr3 & (USART_CR3_ABREN | USART_CR3_ABRMOD)));
+
+  if (status == HAL_OK)
+  {
+    huart->Init.BaudRate = HAL_UARTEx_GetBaudRate(huart);
+  }
+
+  huart->RxState = HAL_UART_STATE_READY;
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(huart);
+
+  return status;
+}
+
 /**
   * @}
   */
@@ -2584,6 +3145,7 @@ void UART_InitCallbacksToDefault(UART_HandleTypeDef *huart)
   huart->AbortCpltCallback         = HAL_UART_AbortCpltCallback;         /* Legacy weak AbortCpltCallback         */
   huart->AbortTransmitCpltCallback = HAL_UART_AbortTransmitCpltCallback; /* Legacy weak AbortTransmitCpltCallback */
   huart->AbortReceiveCpltCallback  = HAL_UART_AbortReceiveCpltCallback;  /* Legacy weak AbortReceiveCpltCallback  */
+  huart->RxFrameCallback           = HAL_UARTEx_RxFrameCallback;         /* Legacy weak RxFrameCallback           */
 
 }
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
@@ -2616,6 +3178,8 @@ static void UART_DMATransmitCplt(DMA_HandleTypeDef *hdma)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
     /*Call registered Tx complete callback*/
     huart->TxCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->TxCpltCallback(huart);
 #else
     /*Call legacy weak Tx complete callback*/
     HAL_UART_TxCpltCallback(huart);
@@ -2636,6 +3200,8 @@ static void UART_DMATxHalfCplt(DMA_HandleTypeDef *hdma)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /*Call registered Tx complete callback*/
   huart->TxHalfCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->TxHalfCpltCallback(huart);
 #else
   /*Call legacy weak Tx complete callback*/
   HAL_UART_TxHalfCpltCallback(huart);
@@ -2666,14 +3232,36 @@ static void UART_DMAReceiveCplt(DMA_HandleTypeDef *hdma)
 
     /* At end of Rx process, restore huart->RxState to Ready */
     huart->RxState = HAL_UART_STATE_READY;
+
+    /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+    if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+    {
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+      CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE | USART_CR1_RXNEIE);
+#else
+      CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+    }
+  }
+
+  /* Check current reception Mode :
+     If Reception till IDLE event has been selected : report the last frame */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    UART_RxFrameEvent(huart);
   }
+  else
+  {
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
-  /*Call registered Rx complete callback*/
-  huart->RxCpltCallback(huart);
+    /*Call registered Rx complete callback*/
+    huart->RxCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->RxCpltCallback(huart);
 #else
-  /*Call legacy weak Rx complete callback*/
-  HAL_UART_RxCpltCallback(huart);
+    /*Call legacy weak Rx complete callback*/
+    HAL_UART_RxCpltCallback(huart);
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+  }
 }
 
 /**
@@ -2686,13 +3274,106 @@ static void UART_DMARxHalfCplt(DMA_HandleTypeDef *hdma)
 {
   UART_HandleTypeDef *huart = (UART_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;
 
+  /* Check current reception Mode :
+     If Reception till IDLE event has been selected : report the received frame */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    UART_RxFrameEvent(huart);
+  }
+  else
+  {
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
-  /*Call registered Rx Half complete callback*/
-  huart->RxHalfCpltCallback(huart);
+    /*Call registered Rx Half complete callback*/
+    huart->RxHalfCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->RxHalfCpltCallback(huart);
 #else
-  /*Call legacy weak Rx Half complete callback*/
-  HAL_UART_RxHalfCpltCallback(huart);
+    /*Call legacy weak Rx Half complete callback*/
+    HAL_UART_RxHalfCpltCallback(huart);
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+  }
+}
+
+/**
+  * @brief  Report the data received since the previous event in reception till idle mode.
+  * @note   Called on IDLE line, DMA half transfer and DMA transfer complete events,
+  *         which can run at different interrupt priorities.
+  * @param  huart UART handle.
+  * @retval None
+  */
+static void UART_RxFrameEvent(UART_HandleTypeDef *huart)
+{
+  uint32_t critical;
+  uint16_t pos;
+  uint16_t offset;
+  uint16_t length;
+  uint16_t wrapped = 0U;
+
+  critical = HAL_EnterCritical();
+
+  /* DMA write position, the counter reloads to RxXferSize on a circular wrap */
+  pos = (uint16_t)(huart->RxXferSize - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+  offset = huart->RxFramePos;
+  if (pos >= offset)
+  {
+    length = pos - offset;
+  }
+  else
+  {
+    /* The buffer wrapped since the previous event */
+    length = huart->RxXferSize - offset;
+    wrapped = pos;
+  }
+  huart->RxFramePos = (pos == huart->RxXferSize) ? 0U : pos;
+
+#if (USE_HAL_UART_RX_TIMESTAMP == 1U)
+  if ((length != 0U) || (wrapped != 0U))
+  {
+    /* RXNEIE still armed: the data was already flowing at the previous report */
+    if (READ_BIT(huart->Instance->CR1, USART_CR1_RXNEIE) == 0U)
+    {
+      huart->RxTimestamp.Start = huart->RxStartCycle;
+    }
+    else
+    {
+      huart->RxTimestamp.Start = huart->RxTimestamp.End;
+    }
+    huart->RxTimestamp.End = DWT->CYCCNT;
+
+    /* Timestamp the first byte of the next frame */
+    if (huart->RxState == HAL_UART_STATE_BUSY_RX)
+    {
+      SET_BIT(huart->Instance->CR1, USART_CR1_RXNEIE);
+    }
+  }
+#endif /* USE_HAL_UART_RX_TIMESTAMP */
+
+  HAL_ExitCritical(critical);
+
+  if (length != 0U)
+  {
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+    /*Call registered Rx Frame callback*/
+    huart->RxFrameCallback(huart, offset, length);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->RxFrameCallback(huart, offset, length);
+#else
+    /*Call legacy weak Rx Frame callback*/
+    HAL_UARTEx_RxFrameCallback(huart, offset, length);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+  }
+  if (wrapped != 0U)
+  {
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+    /*Call registered Rx Frame callback*/
+    huart->RxFrameCallback(huart, 0U, wrapped);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+    huart->pCallbacks->RxFrameCallback(huart, 0U, wrapped);
+#else
+    /*Call legacy weak Rx Frame callback*/
+    HAL_UARTEx_RxFrameCallback(huart, 0U, wrapped);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+  }
 }
 
 /**
@@ -2726,6 +3407,8 @@ static void UART_DMAError(DMA_HandleTypeDef *hdma)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /*Call registered error callback*/
   huart->ErrorCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->ErrorCallback(huart);
 #else
   /*Call legacy weak error callback*/
   HAL_UART_ErrorCallback(huart);
@@ -2765,6 +3448,8 @@ static HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart,
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
@@ -2783,6 +3468,71 @@ static void UART_EndTxTransfer(UART_HandleTypeDef *huart)
   huart->gState = HAL_UART_STATE_READY;
 }
 
+/**
+  * @brief  Start Receive operation in DMA mode.
+  * @note   This function could be called by all HAL UART API providing reception in DMA mode.
+  * @note   When calling this function, parameters validity is considered as already checked,
+  *         i.e. Rx State, buffer address, ...
+  * @param  huart UART handle.
+  * @param  pData Pointer to data buffer (u8 or u16 data elements).
+  * @param  Size  Amount of data elements (u8 or u16) to be received.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef UART_Start_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  /* In case of 9bits/No Parity transfer, pData buffer provided as input parameter
+     should be aligned on a u16 frontier, as data copy from RDR will be
+     handled by DMA from a u16 frontier. */
+  if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE))
+  {
+    if ((((uint32_t)pData) & 1U) != 0U)
+    {
+      return  HAL_ERROR;
+    }
+  }
+  /* Process Locked */
+  __HAL_LOCK(huart);
+
+  huart->pRxBuffPtr = pData;
+  huart->RxXferSize = Size;
+
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+
+  /* Set the UART DMA transfer complete callback */
+  huart->hdmarx->XferCpltCallback = UART_DMAReceiveCplt;
+
+  /* Set the UART DMA Half transfer complete callback */
+  huart->hdmarx->XferHalfCpltCallback = UART_DMARxHalfCplt;
+
+  /* Set the DMA error callback */
+  huart->hdmarx->XferErrorCallback = UART_DMAError;
+
+  /* Set the DMA abort callback */
+  huart->hdmarx->XferAbortCallback = NULL;
+
+  /* Enable the DMA channel */
+  HAL_DMA_Start_IT(huart->hdmarx, (uint32_t)&huart->Instance->DR,(uint32_t)huart->pRxBuffPtr, Size);
+
+  /* Clear the Overrun flag just before enabling the DMA Rx request: can be mandatory for the second transfer */
+  __HAL_UART_CLEAR_OREFLAG(huart);
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(huart);
+
+  /* Enable the UART Parity Error Interrupt */
+  SET_BIT(huart->Instance->CR1, USART_CR1_PEIE);
+
+  /* Enable the UART Error Interrupt: (Frame error, noise error, overrun error) */
+  SET_BIT(huart->Instance->CR3, USART_CR3_EIE);
+
+  /* Enable the DMA transfer for the receiver request by setting the DMAR bit
+  in the UART CR3 register */
+  SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+
+  return HAL_OK;
+}
+
 /**
   * @brief  End ongoing Rx transfer on UART peripheral (following error detection or Reception completion).
   * @param  huart UART handle.
@@ -2794,8 +3544,15 @@ static void UART_EndRxTransfer(UART_HandleTypeDef *huart)
   CLEAR_BIT(huart->Instance->CR1, (USART_CR1_RXNEIE | USART_CR1_PEIE));
   CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
 
+  /* If Reception till IDLE event was ongoing, disable IDLEIE interrupt */
+  if (huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+  {
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+  }
+
   /* At end of Rx process, restore huart->RxState to Ready */
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 }
 
 /**
@@ -2814,6 +3571,8 @@ static void UART_DMAAbortOnError(DMA_HandleTypeDef *hdma)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /*Call registered error callback*/
   huart->ErrorCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->ErrorCallback(huart);
 #else
   /*Call legacy weak error callback*/
   HAL_UART_ErrorCallback(huart);
@@ -2854,11 +3613,14 @@ static void UART_DMATxAbortCallback(DMA_HandleTypeDef *hdma)
   /* Restore huart->gState and huart->RxState to Ready */
   huart->gState  = HAL_UART_STATE_READY;
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
   /* Call user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /* Call registered Abort complete callback */
   huart->AbortCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->AbortCpltCallback(huart);
 #else
   /* Call legacy weak Abort complete callback */
   HAL_UART_AbortCpltCallback(huart);
@@ -2899,11 +3661,14 @@ static void UART_DMARxAbortCallback(DMA_HandleTypeDef *hdma)
   /* Restore huart->gState and huart->RxState to Ready */
   huart->gState  = HAL_UART_STATE_READY;
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
   /* Call user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /* Call registered Abort complete callback */
   huart->AbortCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->AbortCpltCallback(huart);
 #else
   /* Call legacy weak Abort complete callback */
   HAL_UART_AbortCpltCallback(huart);
@@ -2932,6 +3697,8 @@ static void UART_DMATxOnlyAbortCallback(DMA_HandleTypeDef *hdma)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /* Call registered Abort Transmit Complete Callback */
   huart->AbortTransmitCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->AbortTransmitCpltCallback(huart);
 #else
   /* Call legacy weak Abort Transmit Complete Callback */
   HAL_UART_AbortTransmitCpltCallback(huart);
@@ -2955,11 +3722,14 @@ static void UART_DMARxOnlyAbortCallback(DMA_HandleTypeDef *hdma)
 
   /* Restore huart->RxState to Ready */
   huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
 
   /* Call user Abort complete callback */
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /* Call registered Abort Receive Complete Callback */
   huart->AbortReceiveCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->AbortReceiveCpltCallback(huart);
 #else
   /* Call legacy weak Abort Receive Complete Callback */
   HAL_UART_AbortReceiveCpltCallback(huart);
@@ -3025,6 +3795,8 @@ static HAL_StatusTypeDef UART_EndTransmit_IT(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   /*Call registered Tx complete callback*/
   huart->TxCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+  huart->pCallbacks->TxCpltCallback(huart);
 #else
   /*Call legacy weak Tx complete callback*/
   HAL_UART_TxCpltCallback(huart);
@@ -3076,6 +3848,8 @@ static HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart)
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
       /*Call registered Rx complete callback*/
       huart->RxCpltCallback(huart);
+#elif (USE_HAL_UART_REGISTER_CALLBACKS == 2)
+      huart->pCallbacks->RxCpltCallback(huart);
 #else
       /*Call legacy weak Rx complete callback*/
       HAL_UART_RxCpltCallback(huart);
@@ -3100,7 +3874,6 @@ static HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart)
 static void UART_SetConfig(UART_HandleTypeDef *huart)
 {
   uint32_t tmpreg;
-  uint32_t pclk;
 
   /* Check the parameters */
   assert_param(IS_UART_BAUDRATE(huart->Init.BaudRate));
@@ -3132,6 +3905,20 @@ static void UART_SetConfig(UART_HandleTypeDef *huart)
   MODIFY_REG(huart->Instance->CR3, (uint32_t)(USART_CR3_OVER8), (uint32_t) huart->Init.OverSampling);
 #endif /* USART_CR3_OVER8 */
 
+  /*-------------------------- USART BRR Configuration -----------------------*/
+  UART_SetBRR(huart);
+}
+
+/**
+  * @brief  Configures the UART baud rate from the current PCLK frequency.
+  * @param  huart  Pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+static void UART_SetBRR(UART_HandleTypeDef *huart)
+{
+  uint32_t pclk;
+
 #if defined(USART_CR3_OVER8)
   /* Check the Over Sampling */
   if(huart->Init.OverSampling == UART_OVERSAMPLING_8)
@@ -87,6 +87,21 @@
        (+) Resume the DMA Transfer using HAL_USART_DMAResume()
        (+) Stop the DMA Transfer using HAL_USART_DMAStop()
 
+     *** DMA stream mode IO operation ***
+     ====================================
+     [..]
+       (+) Send or exchange more than 65535 data elements without any clock gap
+           using HAL_USART_Transmit_Stream_DMA() or HAL_USART_TransmitReceive_Stream_DMA()
+       (+) The transfer is split in segments of at most USART_STREAM_SEGMENT_SIZE elements
+           described in application provided arrays of __HAL_USART_STREAM_DESC_NUMBER(Size)
+           DMA_ChainDescTypeDef entries. The next segment is loaded by HAL_DMA_IRQHandler()
+           from the transfer complete interrupt of the previous one, while the last element
+           of the previous segment is still shifted out
+       (+) The DMA channels must be in DMA_NORMAL mode and their interrupts must have a
+           priority high enough to be served within one character time
+       (+) HAL_USART_TxCpltCallback() or HAL_USART_TxRxCpltCallback() is executed once,
+           at the end of the whole stream
+
      *** USART HAL driver macros list ***
      =============================================
      [..]
@@ -242,6 +257,7 @@ static void USART_DMATxHalfCplt(DMA_HandleTypeDef *hdma);
 static void USART_DMAReceiveCplt(DMA_HandleTypeDef *hdma);
 static void USART_DMARxHalfCplt(DMA_HandleTypeDef *hdma);
 static void USART_DMAError(DMA_HandleTypeDef *hdma);
+static void USART_StreamBuildChain(DMA_HandleTypeDef *hdma, DMA_ChainDescTypeDef *pDesc, uint32_t Address, uint32_t Size);
 static void USART_DMAAbortOnError(DMA_HandleTypeDef *hdma);
 static void USART_DMATxAbortCallback(DMA_HandleTypeDef *hdma);
 static void USART_DMARxAbortCallback(DMA_HandleTypeDef *hdma);
@@ -698,6 +714,8 @@ HAL_StatusTypeDef HAL_USART_UnRegisterCallback(USART_HandleTypeDef *husart, HAL_
         (++) HAL_USART_Transmit_DMA()in simplex mode
         (++) HAL_USART_Receive_DMA() in full duplex receive only
         (++) HAL_USART_TransmitReceive_DMA() in full duplex mode
+        (++) HAL_USART_Transmit_Stream_DMA() in simplex mode, more than 65535 data elements
+        (++) HAL_USART_TransmitReceive_Stream_DMA() in full duplex mode, more than 65535 data elements
         (++) HAL_USART_DMAPause()
         (++) HAL_USART_DMAResume()
         (++) HAL_USART_DMAStop()
@@ -1456,6 +1474,213 @@ HAL_StatusTypeDef HAL_USART_TransmitReceive_DMA(USART_HandleTypeDef *husart, uin
   }
 }
 
+/**
+  * @brief  Simplex Send a stream of data in DMA mode.
+  * @note   The stream is split in segments of at most USART_STREAM_SEGMENT_SIZE elements,
+  *         chained by the transfer complete interrupt of the Tx DMA channel so that the
+  *         clock keeps running between two segments.
+  * @note   When UART parity is not enabled (PCE = 0), and Word Length is configured to 9 bits (M1-M0 = 01),
+  *         the sent data is handled as a set of u16. In this case, Size must indicate the number
+  *         of u16 provided through pTxData.
+  * @param  husart  Pointer to a USART_HandleTypeDef structure that contains
+  *                 the configuration information for the specified USART module.
+  * @param  pTxDesc Pointer to an array of __HAL_USART_STREAM_DESC_NUMBER(Size) descriptors,
+  *                 which must stay valid until the end of the transfer.
+  * @param  pTxData Pointer to data buffer (u8 or u16 data elements).
+  * @param  Size    Amount of data elements (u8 or u16) to be sent.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_USART_Transmit_Stream_DMA(USART_HandleTypeDef *husart, DMA_ChainDescTypeDef *pTxDesc, uint8_t *pTxData, uint32_t Size)
+{
+  uint32_t *tmp;
+
+  if (husart->State == HAL_USART_STATE_READY)
+  {
+    if ((pTxDesc == NULL) || (pTxData == NULL) || (Size == 0U))
+    {
+      return HAL_ERROR;
+    }
+    /* Process Locked */
+    __HAL_LOCK(husart);
+
+    husart->pTxBuffPtr = pTxData;
+    husart->TxXferSize = (uint16_t)((Size > USART_STREAM_SEGMENT_SIZE) ? USART_STREAM_SEGMENT_SIZE : Size);
+    husart->TxXferCount = husart->TxXferSize;
+
+    husart->ErrorCode = HAL_USART_ERROR_NONE;
+    husart->State = HAL_USART_STATE_BUSY_TX;
+
+    /* Set the USART DMA transfer complete callback */
+    husart->hdmatx->XferCpltCallback = USART_DMATransmitCplt;
+
+    /* Set the USART DMA Half transfer complete callback */
+    husart->hdmatx->XferHalfCpltCallback = USART_DMATxHalfCplt;
+
+    /* Set the DMA error callback */
+    husart->hdmatx->XferErrorCallback = USART_DMAError;
+
+    /* Set the DMA abort callback */
+    husart->hdmatx->XferAbortCallback = NULL;
+
+    /* Split the stream in DMA segments */
+    tmp = (uint32_t *)&pTxData;
+    USART_StreamBuildChain(husart->hdmatx, pTxDesc, *(uint32_t *)tmp, Size);
+
+    /* Enable the USART transmit DMA channel */
+    if (HAL_DMAEx_StartChain(husart->hdmatx, pTxDesc) != HAL_OK)
+    {
+      husart->ErrorCode = HAL_USART_ERROR_DMA;
+      husart->State = HAL_USART_STATE_READY;
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(husart);
+
+      return HAL_ERROR;
+    }
+
+    /* Clear the TC flag in the SR register by writing 0 to it */
+    __HAL_USART_CLEAR_FLAG(husart, USART_FLAG_TC);
+
+    /* Process Unlocked */
+    __HAL_UNLOCK(husart);
+
+    /* Enable the DMA transfer for transmit request by setting the DMAT bit
+    in the USART CR3 register */
+    SET_BIT(husart->Instance->CR3, USART_CR3_DMAT);
+
+    return HAL_OK;
+  }
+  else
+  {
+    return HAL_BUSY;
+  }
+}
+
+/**
+  * @brief  Full-Duplex Transmit Receive a stream of data in DMA mode.
+  * @note   The stream is split in segments of at most USART_STREAM_SEGMENT_SIZE elements,
+  *         chained by the transfer complete interrupts of the Tx and Rx DMA channels so that
+  *         the clock keeps running between two segments. Both channel interrupts must be
+  *         served within one character time, otherwise the clock is only stretched on Tx
+  *         but an overrun error stops the transfer on Rx.
+  * @note   When UART parity is not enabled (PCE = 0), and Word Length is configured to 9 bits (M1-M0 = 01),
+  *         the sent data and the received data are handled as sets of u16. In this case, Size must indicate the number
+  *         of u16 available through pTxData and through pRxData.
+  * @param  husart  Pointer to a USART_HandleTypeDef structure that contains
+  *                 the configuration information for the specified USART module.
+  * @param  pTxDesc Pointer to an array of __HAL_USART_STREAM_DESC_NUMBER(Size) descriptors for Tx.
+  * @param  pRxDesc Pointer to an array of __HAL_USART_STREAM_DESC_NUMBER(Size) descriptors for Rx.
+  * @param  pTxData Pointer to TX data buffer (u8 or u16 data elements).
+  * @param  pRxData Pointer to RX data buffer (u8 or u16 data elements).
+  * @param  Size    Amount of data elements (u8 or u16) to be received/sent.
+  * @note   When the USART parity is enabled (PCE = 1) the data received contain the parity bit.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_USART_TransmitReceive_Stream_DMA(USART_HandleTypeDef *husart, DMA_ChainDescTypeDef *pTxDesc, DMA_ChainDescTypeDef *pRxDesc,
+                                                       uint8_t *pTxData, uint8_t *pRxData, uint32_t Size)
+{
+  uint32_t *tmp;
+
+  if (husart->State == HAL_USART_STATE_READY)
+  {
+    if ((pTxDesc == NULL) || (pRxDesc == NULL) || (pTxData == NULL) || (pRxData == NULL) || (Size == 0U))
+    {
+      return HAL_ERROR;
+    }
+    /* Process Locked */
+    __HAL_LOCK(husart);
+
+    husart->pRxBuffPtr = pRxData;
+    husart->RxXferSize = (uint16_t)((Size > USART_STREAM_SEGMENT_SIZE) ? USART_STREAM_SEGMENT_SIZE : Size);
+    husart->pTxBuffPtr = pTxData;
+    husart->TxXferSize = husart->RxXferSize;
+
+    husart->ErrorCode = HAL_USART_ERROR_NONE;
+    husart->State = HAL_USART_STATE_BUSY_TX_RX;
+
+    /* Set the USART DMA Rx transfer complete callback */
+    husart->hdmarx->XferCpltCallback = USART_DMAReceiveCplt;
+
+    /* Set the USART DMA Half transfer complete callback */
+    husart->hdmarx->XferHalfCpltCallback = USART_DMARxHalfCplt;
+
+    /* Set the USART DMA Tx transfer complete callback */
+    husart->hdmatx->XferCpltCallback = USART_DMATransmitCplt;
+
+    /* Set the USART DMA Half transfer complete callback */
+    husart->hdmatx->XferHalfCpltCallback = USART_DMATxHalfCplt;
+
+    /* Set the USART DMA Tx transfer error callback */
+    husart->hdmatx->XferErrorCallback = USART_DMAError;
+
+    /* Set the USART DMA Rx transfer error callback */
+    husart->hdmarx->XferErrorCallback = USART_DMAError;
+
+    /* Set the DMA abort callback */
+    husart->hdmarx->XferAbortCallback = NULL;
+
+    /* Split the stream in DMA segments */
+    tmp = (uint32_t *)&pRxData;
+    USART_StreamBuildChain(husart->hdmarx, pRxDesc, *(uint32_t *)tmp, Size);
+    tmp = (uint32_t *)&pTxData;
+    USART_StreamBuildChain(husart->hdmatx, pTxDesc, *(uint32_t *)tmp, Size);
+
+    /* Enable the USART receive DMA channel first, then the transmit one which
+       generates the clock */
+    if (HAL_DMAEx_StartChain(husart->hdmarx, pRxDesc) != HAL_OK)
+    {
+      husart->ErrorCode = HAL_USART_ERROR_DMA;
+      husart->State = HAL_USART_STATE_READY;
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(husart);
+
+      return HAL_ERROR;
+    }
+    if (HAL_DMAEx_StartChain(husart->hdmatx, pTxDesc) != HAL_OK)
+    {
+      (void)HAL_DMA_Abort(husart->hdmarx);
+
+      husart->ErrorCode = HAL_USART_ERROR_DMA;
+      husart->State = HAL_USART_STATE_READY;
+
+      /* Process Unlocked */
+      __HAL_UNLOCK(husart);
+
+      return HAL_ERROR;
+    }
+
+    /* Clear the TC flag in the SR register by writing 0 to it */
+    __HAL_USART_CLEAR_FLAG(husart, USART_FLAG_TC);
+
+    /* Clear the Overrun flag before starting the reception */
+    __HAL_USART_CLEAR_OREFLAG(husart);
+
+    /* Process Unlocked */
+    __HAL_UNLOCK(husart);
+
+    /* Enable the USART Parity Error Interrupt */
+    SET_BIT(husart->Instance->CR1, USART_CR1_PEIE);
+
+    /* Enable the USART Error Interrupt: (Frame error, noise error, overrun error) */
+    SET_BIT(husart->Instance->CR3, USART_CR3_EIE);
+
+    /* Enable the DMA transfer for the receiver request by setting the DMAR bit
+       in the USART CR3 register */
+    SET_BIT(husart->Instance->CR3, USART_CR3_DMAR);
+
+    /* Enable the DMA transfer for transmit request by setting the DMAT bit
+       in the USART CR3 register */
+    SET_BIT(husart->Instance->CR3, USART_CR3_DMAT);
+
+    return HAL_OK;
+  }
+  else
+  {
+    return HAL_BUSY;
+  }
+}
+
 /**
   * @brief  Pauses the DMA Transfer.
   * @param  husart Pointer to a USART_HandleTypeDef structure that contains
@@ -2272,6 +2497,47 @@ static void USART_DMAError(DMA_HandleTypeDef *hdma)
 #endif /* USE_HAL_USART_REGISTER_CALLBACKS */
 }
 
+/**
+  * @brief  Split a stream in DMA descriptor chain segments.
+  * @param  hdma    Pointer to a DMA_HandleTypeDef structure of the channel which
+  *                 runs the chain.
+  * @param  pDesc   Pointer to an array of __HAL_USART_STREAM_DESC_NUMBER(Size) descriptors.
+  * @param  Address Memory address of the stream.
+  * @param  Size    Amount of data elements (u8 or u16) of the stream.
+  * @retval None
+  */
+static void USART_StreamBuildChain(DMA_HandleTypeDef *hdma, DMA_ChainDescTypeDef *pDesc, uint32_t Address, uint32_t Size)
+{
+  USART_HandleTypeDef *husart = (USART_HandleTypeDef *)hdma->Parent;
+  uint32_t periph = (uint32_t)&husart->Instance->DR;
+  uint32_t width = 1UL << (hdma->Init.MemDataAlignment >> DMA_CCR_MSIZE_Pos);
+  uint32_t length;
+
+  while (Size != 0U)
+  {
+    length = (Size > USART_STREAM_SEGMENT_SIZE) ? USART_STREAM_SEGMENT_SIZE : Size;
+
+    if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+    {
+      pDesc->SrcAddress = Address;
+      pDesc->DstAddress = periph;
+    }
+    else
+    {
+      pDesc->SrcAddress = periph;
+      pDesc->DstAddress = Address;
+    }
+    pDesc->DataLength = length;
+    pDesc->Flags = DMA_CHAIN_FLAG_NONE;
+
+    Address += length * width;
+    Size -= length;
+
+    pDesc->pNext = (Size != 0U) ? (pDesc + 1U) : NULL;
+    pDesc++;
+  }
+}
+
 /**
   * @brief  This function handles USART Communication Timeout.
   * @param  husart Pointer to a USART_HandleTypeDef structure that contains
@@ -2312,6 +2578,8 @@ static HAL_StatusTypeDef USART_WaitOnFlagUntilTimeout(USART_HandleTypeDef *husar
         return HAL_TIMEOUT;
       }
     }
+
+    __HAL_WAIT(Tickstart);
   }
   return HAL_OK;
 }
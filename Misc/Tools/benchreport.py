@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Compare the BENCH lines of a benchmark image with a stored baseline.
+
+Usage: benchreport.py (--port DEV | --command CMD | --input FILE)
+                      --baseline FILE [--threshold PCT] [--runs N] [--update]
+
+Reads the output of an image of Examples/Benchmark, from a serial port, from
+the stdout of a command (a probe tool printing the semihosting console), or
+from a captured log. A pass is framed by
+
+    BENCH_START [key=value ...]
+    BENCH <name> <arg> <min> <median> <max>
+    BENCH <name> <arg> err
+    BENCH_END <lines>
+
+The median of each benchmark is the best of --runs passes, then compared with
+the baseline: a benchmark slower than its baseline by more than the threshold,
+in err, or gone from the output, is a regression and the exit status is 1.
+--update writes the baseline from the passes instead, keeping the thresholds
+set in the file. The baseline is JSON:
+
+    {"threshold": 10, "thresholds": {"irq_entry 0": 5},
+     "bench": {"gpio_write 1": {"min": 52, "median": 53, "max": 60}, ...}}
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+
+def lines_serial(port, baud, timeout):
+    """Lines read on a serial port, until the timeout."""
+    try:
+        import serial
+    except ImportError:
+        sys.exit('pyserial is needed for --port, pip install pyserial')
+    end = time.monotonic() + timeout
+    with serial.Serial(port, baud, timeout=0.5) as tty:
+        while time.monotonic() < end:
+            line = tty.readline()
+            if line:
+                yield line.decode('ascii', errors='replace').strip()
+
+
+def lines_command(command, timeout):
+    """Lines of the stdout of a command, until the timeout."""
+    proc = subprocess.Popen(command, shell=True, stdout=subprocess.PIPE, text=True, errors='replace')
+    end = time.monotonic() + timeout
+    try:
+        for line in proc.stdout:
+            yield line.strip()
+            if time.monotonic() > end:
+                break
+    finally:
+        proc.kill()
+
+
+def lines_file(path):
+    """Lines of a captured log, '-' for stdin."""
+    log = sys.stdin if path == '-' else open(path, encoding='utf-8', errors='replace')
+    with log:
+        for line in log:
+            yield line.strip()
+
+
+def passes(lines, runs):
+    """Benchmarks of each complete pass, the first one may be cut by the reset."""
+    found = []
+    bench = None
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        if fields[0] == 'BENCH_START':
+            bench = {}
+            print(line)
+        elif fields[0] == 'BENCH' and bench is not None and len(fields) >= 4:
+            key = '%s %s' % (fields[1], fields[2])
+            if fields[3] == 'err':
+                bench[key] = None
+            elif len(fields) == 6:
+                bench[key] = dict(zip(('min', 'median', 'max'), (int(f) for f in fields[3:6])))
+        elif fields[0] == 'BENCH_END' and bench is not None:
+            if len(fields) > 1 and int(fields[1]) != len(bench):
+                print('pass dropped, %d of %s lines read' % (len(bench), fields[1]))
+            else:
+                found.append(bench)
+                if len(found) == runs:
+                    return found
+            bench = None
+    if not found:
+        sys.exit('no complete BENCH_START ... BENCH_END pass read')
+    print('%d of %d passes read' % (len(found), runs))
+    return found
+
+
+def best(found):
+    """Each benchmark with the lowest median of the passes, err if any pass failed."""
+    result = {}
+    for bench in found:
+        for key, value in bench.items():
+            if key in result and result[key] is None:
+                continue
+            if value is None or key not in result or value['median'] < result[key]['median']:
+                result[key] = value
+    return result
+
+
+def compare(result, baseline):
+    """Print the table of the result against the baseline, number of regressions."""
+    default = float(baseline.get('threshold', 10))
+    thresholds = baseline.get('thresholds', {})
+    base = baseline.get('bench', {})
+    failed = 0
+
+    print('%-24s %10s %10s %8s %7s' % ('benchmark', 'baseline', 'median', 'delta', 'limit'))
+    for key in sorted(set(base) | set(result)):
+        limit = float(thresholds.get(key, default))
+        old = base.get(key)
+        new = result.get(key, 'gone')
+        if old is None:
+            status = 'new' if new not in (None, 'gone') else 'err'
+            failed += status == 'err'
+            print('%-24s %10s %10s %8s %7s  %s' % (key, '-', '-' if new is None else new['median'], '', '', status))
+            continue
+        if new in (None, 'gone'):
+            failed += 1
+            print('%-24s %10d %10s %8s %6.1f%%  %s' % (key, old['median'], '-', '', limit,
+                                                       'err' if new is None else 'gone'))
+            continue
+        delta = 100.0 * (new['median'] - old['median']) / old['median'] if old['median'] else 0.0
+        status = ''
+        if delta > limit:
+            status = 'REGRESSED'
+            failed += 1
+        elif delta < -limit:
+            status = 'improved'
+        print('%-24s %10d %10d %+7.1f%% %6.1f%%  %s' % (key, old['median'], new['median'], delta, limit, status))
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='serial port of the UART output')
+    source.add_argument('--command', help='command printing the output, the semihosting console')
+    source.add_argument('--input', help='captured output, - for stdin')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--timeout', type=float, default=60.0, help='seconds to read the passes')
+    parser.add_argument('--runs', type=int, default=3, help='passes read, the best median is kept')
+    parser.add_argument('--baseline', required=True)
+    parser.add_argument('--threshold', type=float, help='percent slower allowed, over the one of the baseline')
+    parser.add_argument('--update', action='store_true', help='write the baseline from the passes')
+    args = parser.parse_args()
+
+    if args.port:
+        lines = lines_serial(args.port, args.baud, args.timeout)
+    elif args.command:
+        lines = lines_command(args.command, args.timeout)
+    else:
+        lines = lines_file(args.input)
+    result = best(passes(lines, args.runs))
+
+    baseline = {}
+    if os.path.isfile(args.baseline):
+        with open(args.baseline, encoding='utf-8') as f:
+            baseline = json.load(f)
+    if args.threshold is not None:
+        baseline['threshold'] = args.threshold
+
+    if args.update:
+        errors = [key for key, value in result.items() if value is None]
+        if errors:
+            sys.exit('baseline not written, err in %s' % ', '.join(sorted(errors)))
+        baseline['bench'] = result
+        baseline.setdefault('threshold', 10)
+        with open(args.baseline, 'w', encoding='utf-8') as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('%s: %d benchmarks written' % (args.baseline, len(result)))
+        return 0
+
+    if not baseline.get('bench'):
+        sys.exit('%s has no benchmarks, run with --update first' % args.baseline)
+    failed = compare(result, baseline)
+    print('%d regression%s' % (failed, '' if failed == 1 else 's'))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Compress the .data of an image into the LZ4 block decoded by the startup.
+
+Usage: datalz.py pack <first.elf> <block.bin> [--objcopy OBJCOPY]
+       datalz.py check <image.elf> <block.bin> [--objcopy OBJCOPY]
+
+Run by rules.mk for USE_DATALZ=y, the image being linked twice with the
+LDScripts/DataLz/py32f403xx_data.ld fragment:
+
+  pack   reads the .data of the first link, without the block, and writes
+         block.bin and block.s, the block in a .DataLz section for the
+         second link. .datalz is the last section of the flash image, so
+         the second link moves nothing the data points to.
+  check  decodes block.bin and compares it with the .data of the second
+         link, and the block with its .datalz section: the exit status is 1
+         when the data moved or the block is not the one linked.
+
+The block is an LZ4 block (lz4 -d decodes it with a frame header): sequences
+of a token, literals, a 16-bit offset and a match of 4 bytes or more, the
+last sequence literals only, its 5 last bytes at least. Runs of zeros are
+a literal and a match of offset 1, filled by words by SystemDataDecode() of
+the startup.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+MIN_MATCH = 4
+MAX_OFFSET = 0xFFFF
+LAST_LITERALS = 5     # the last bytes are literals
+MATCH_LIMIT = 12      # no match starts in the last bytes
+CHAIN_DEPTH = 64      # candidates tried at each position
+
+
+def section(objcopy, elf, name):
+    """Bytes of a section of an ELF file, empty when missing."""
+    with tempfile.TemporaryDirectory() as tmp:
+        out = os.path.join(tmp, 'section.bin')
+        subprocess.run([objcopy, '-O', 'binary', '-j', name, elf, out], check=True)
+        if not os.path.exists(out):
+            return b''
+        with open(out, 'rb') as f:
+            return f.read()
+
+
+def length_bytes(n):
+    """LZ4 extension bytes of a length over 14."""
+    out = bytearray()
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+    return out
+
+
+def sequence(literals, offset, match):
+    """A sequence, the last one with offset 0."""
+    lit = len(literals)
+    ml = match - MIN_MATCH if offset else 0
+    out = bytearray([(min(lit, 15) << 4) | min(ml, 15)])
+    if lit >= 15:
+        out += length_bytes(lit - 15)
+    out += literals
+    if offset:
+        out += offset.to_bytes(2, 'little')
+        if ml >= 15:
+            out += length_bytes(ml - 15)
+    return out
+
+
+def compress(data):
+    """Greedy LZ4 block, a hash chain of the 4-byte prefixes."""
+    n = len(data)
+    out = bytearray()
+    heads = {}
+    prev = [-1] * n
+    anchor = 0
+    pos = 0
+    limit = n - MATCH_LIMIT
+
+    def insert(p):
+        key = data[p:p + MIN_MATCH]
+        prev[p] = heads.get(key, -1)
+        heads[key] = p
+
+    while pos <= limit:
+        best_len = 0
+        best_off = 0
+        cand = heads.get(data[pos:pos + MIN_MATCH], -1)
+        depth = CHAIN_DEPTH
+        end = n - LAST_LITERALS
+        while cand >= 0 and depth and pos - cand <= MAX_OFFSET:
+            length = 0
+            while pos + length < end and data[cand + length] == data[pos + length]:
+                length += 1
+            if length > best_len:
+                best_len = length
+                best_off = pos - cand
+            cand = prev[cand]
+            depth -= 1
+        if best_len < MIN_MATCH:
+            insert(pos)
+            pos += 1
+            continue
+        out += sequence(data[anchor:pos], best_off, best_len)
+        for p in range(pos, min(pos + best_len, limit + 1)):
+            insert(p)
+        pos += best_len
+        anchor = pos
+
+    out += sequence(data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def decompress(block):
+    """Bytes of an LZ4 block, as SystemDataDecode()."""
+    out = bytearray()
+    i = 0
+    while True:
+        token = block[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = block[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        out += block[i:i + lit]
+        i += lit
+        if i >= len(block):
+            return bytes(out)
+        offset = block[i] | (block[i + 1] << 8)
+        i += 2
+        ml = token & 15
+        if ml == 15:
+            while True:
+                b = block[i]
+                i += 1
+                ml += b
+                if b != 255:
+                    break
+        ml += MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise ValueError('offset %d out of the output' % offset)
+        for _ in range(ml):
+            out.append(out[-offset])
+
+
+def write_asm(path, block, source):
+    """The block in a .DataLz section."""
+    with open(path, 'w') as f:
+        f.write('/* LZ4 block of the .data of %s\n' % os.path.basename(source))
+        f.write('   Generated by Misc/Tools/datalz.py, do not edit. */\n\n')
+        f.write('  .section .DataLz,"a",%progbits\n')
+        for i in range(0, len(block), 16):
+            f.write('  .byte %s\n' % ', '.join('0x%02x' % b for b in block[i:i + 16]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='.data of an image to the LZ4 block of the startup')
+    parser.add_argument('command', choices=('pack', 'check'))
+    parser.add_argument('elf')
+    parser.add_argument('block', help='block.bin, block.s written next to it by pack')
+    parser.add_argument('--objcopy', default='arm-none-eabi-objcopy')
+    args = parser.parse_args()
+
+    data = section(args.objcopy, args.elf, '.data')
+
+    if args.command == 'pack':
+        block = compress(data)
+        if decompress(block) != data:
+            sys.exit('datalz: block does not decode to the .data, please report')
+        with open(args.block, 'wb') as f:
+            f.write(block)
+        write_asm(os.path.splitext(args.block)[0] + '.s', block, args.elf)
+        print('  DATALZ\t.data %d bytes, LZ4 block %d bytes, %d bytes of flash saved'
+              % (len(data), len(block), len(data) - ((len(block) + 3) & ~3)))
+        return 0
+
+    with open(args.block, 'rb') as f:
+        block = f.read()
+    if decompress(block) != data:
+        sys.exit('datalz: the .data of %s moved in the second link, no USE_DATALZ for it' % args.elf)
+    if section(args.objcopy, args.elf, '.datalz')[:len(block)] != block:
+        sys.exit('datalz: .datalz of %s is not %s' % (args.elf, args.block))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Generate the CAN database decoders of py32f4xx_bsp_candb from a DBC file.
+
+Usage: dbc2c.py <file.dbc> [--prefix NAME] [--out DIR]
+
+Writes <name>.h and <name>.c: per message a structure of the raw signal
+values, inline Unpack()/Pack() functions calling BSP_CANDB_GetLE/GetBE and
+BSP_CANDB_SetLE/SetBE with constant arguments, a weak RxCallback, and the
+<PREFIX>_Messages table of BSP_CANDB_Init().
+"""
+
+import argparse
+import os
+import re
+import sys
+
+BO_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+SG_RE = re.compile(r'^SG_\s+(\w+)\s*(M|m\d+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+                   r'\(([^,]+),([^)]+)\)\s*\[([^|]*)\|([^\]]*)\]\s*"([^"]*)"')
+
+INDEPENDENT_ID = 0xC0000000
+
+
+def ident(name):
+    """C identifier of a DBC name."""
+    name = re.sub(r'\W', '_', name)
+    return name if not name[0].isdigit() else '_' + name
+
+
+def parse(path):
+    messages = []
+    msg = None
+    with open(path, encoding='latin-1') as dbc:
+        for line in dbc:
+            line = line.strip()
+            m = BO_RE.match(line)
+            if m:
+                raw = int(m.group(1))
+                msg = None
+                if raw == INDEPENDENT_ID:
+                    continue
+                msg = {
+                    'id': raw & 0x1FFFFFFF,
+                    'extended': (raw & 0x80000000) != 0,
+                    'name': ident(m.group(2)),
+                    'length': int(m.group(3)),
+                    'signals': [],
+                }
+                messages.append(msg)
+                continue
+            m = SG_RE.match(line)
+            if m and msg is not None:
+                length = int(m.group(4))
+                if length == 0 or length > 32:
+                    sys.stderr.write('%s.%s: %d bits, skipped (1 to 32 supported)\n'
+                                     % (msg['name'], m.group(1), length))
+                    continue
+                msg['signals'].append({
+                    'name': ident(m.group(1)),
+                    'mux': m.group(2),
+                    'start': int(m.group(3)),
+                    'length': length,
+                    'intel': m.group(5) == '1',
+                    'signed': m.group(6) == '-',
+                    'factor': m.group(7).strip(),
+                    'offset': m.group(8).strip(),
+                    'min': m.group(9).strip(),
+                    'max': m.group(10).strip(),
+                    'unit': m.group(11),
+                })
+    return messages
+
+
+def ctype(sig):
+    bits = 8 if sig['length'] <= 8 else 16 if sig['length'] <= 16 else 32
+    return ('int%d_t' if sig['signed'] else 'uint%d_t') % bits
+
+
+def cfloat(text):
+    return repr(float(text)) + 'f'
+
+
+def banner(filename, brief):
+    return ('/**\n'
+            '  ******************************************************************************\n'
+            '  * @file    %s\n'
+            '  * @brief   %s\n'
+            '  *          Generated by Misc/Tools/dbc2c.py, do not edit.\n'
+            '  ******************************************************************************\n'
+            '  */\n\n' % (filename, brief))
+
+
+def header(prefix, base, source, messages):
+    guard = '__%s_H' % ident(base).upper()
+    out = [banner(base + '.h', 'Header file of the %s CAN database, from %s.' % (prefix, source))]
+    out.append('/* Define to prevent recursive inclusion -------------------------------------*/\n')
+    out.append('#ifndef %s\n#define %s\n\n' % (guard, guard))
+    out.append('#ifdef __cplusplus\n extern "C" {\n#endif\n\n')
+    out.append('/* Includes ------------------------------------------------------------------*/\n')
+    out.append('#include "py32f4xx_bsp_candb.h"\n\n')
+    out.append('/* Exported constants --------------------------------------------------------*/\n')
+    out.append('#define %-40s %dU\n\n' % (prefix + '_MESSAGES', len(messages)))
+    for msg in messages:
+        up = '%s_%s' % (prefix, msg['name'].upper())
+        out.append('#define %-40s 0x%XU\n' % (up + '_ID', msg['id']))
+        out.append('#define %-40s %s\n' % (up + '_IDTYPE',
+                                           'CANFD_EXTENDED_ID' if msg['extended'] else 'CANFD_STANDARD_ID'))
+        out.append('#define %-40s %dU\n' % (up + '_LENGTH', msg['length']))
+        for sig in msg['signals']:
+            out.append('#define %-40s (%s)\n' % ('%s_%s_FACTOR' % (up, sig['name'].upper()), cfloat(sig['factor'])))
+            out.append('#define %-40s (%s)\n' % ('%s_%s_OFFSET' % (up, sig['name'].upper()), cfloat(sig['offset'])))
+        out.append('\n')
+
+    out.append('/* Exported types ------------------------------------------------------------*/\n')
+    for msg in messages:
+        out.append('/**\n  * @brief  %s, raw signal values\n  */\ntypedef struct\n{\n' % msg['name'])
+        for sig in msg['signals']:
+            note = '%s to %s %s' % (sig['min'], sig['max'], sig['unit'])
+            if sig['mux'] is not None:
+                note += ', multiplexer' if sig['mux'] == 'M' else ', multiplexed %s' % sig['mux'][1:]
+            out.append('  %-23s %s; /*!< %s */\n' % (ctype(sig), sig['name'], note.strip()))
+        if not msg['signals']:
+            out.append('  uint8_t                 Reserved;\n')
+        out.append('} %s_%s_TypeDef;\n\n' % (prefix, msg['name']))
+
+    out.append('/* Exported functions --------------------------------------------------------*/\n')
+    for msg in messages:
+        name = '%s_%s' % (prefix, msg['name'])
+        out.append('__STATIC_INLINE void %s_Unpack(%s_TypeDef *pMsg, const uint8_t *pData)\n{\n' % (name, name))
+        for sig in msg['signals']:
+            get = 'BSP_CANDB_Get%s(pData, %dU, %dU)' % ('LE' if sig['intel'] else 'BE', sig['start'], sig['length'])
+            if sig['signed']:
+                get = 'BSP_CANDB_SIGNED(%s, %dU)' % (get, sig['length'])
+            out.append('  pMsg->%s = (%s)%s;\n' % (sig['name'], ctype(sig), get))
+        if not msg['signals']:
+            out.append('  UNUSED(pMsg);\n  UNUSED(pData);\n')
+        out.append('}\n\n')
+        out.append('__STATIC_INLINE void %s_Pack(const %s_TypeDef *pMsg, uint8_t *pData)\n{\n' % (name, name))
+        for sig in msg['signals']:
+            out.append('  BSP_CANDB_Set%s(pData, %dU, %dU, (uint32_t)pMsg->%s);\n'
+                       % ('LE' if sig['intel'] else 'BE', sig['start'], sig['length'], sig['name']))
+        if not msg['signals']:
+            out.append('  UNUSED(pMsg);\n  UNUSED(pData);\n')
+        out.append('}\n\n')
+    for msg in messages:
+        name = '%s_%s' % (prefix, msg['name'])
+        out.append('void %s_RxCallback(const %s_TypeDef *pMsg);\n' % (name, name))
+    out.append('\nextern const BSP_CANDB_MessageTypeDef %s_Messages[%s_MESSAGES];\n\n' % (prefix, prefix))
+    out.append('#ifdef __cplusplus\n}\n#endif\n\n#endif /* %s */\n' % guard)
+    return ''.join(out)
+
+
+def source(prefix, base, dbc, messages):
+    out = [banner(base + '.c', '%s CAN database decoders, from %s.' % (prefix, dbc))]
+    out.append('/* Includes ------------------------------------------------------------------*/\n')
+    out.append('#include "%s.h"\n\n' % base)
+    out.append('/* Private functions ---------------------------------------------------------*/\n')
+    for msg in messages:
+        name = '%s_%s' % (prefix, msg['name'])
+        out.append('static void %s_Handler(const BSP_CANRX_FrameTypeDef *pFrame)\n{\n' % name)
+        out.append('  %s_TypeDef msg;\n\n' % name)
+        out.append('  %s_Unpack(&msg, BSP_CANRX_GET_DATA(pFrame));\n' % name)
+        out.append('  %s_RxCallback(&msg);\n}\n\n' % name)
+    out.append('/* Exported variables --------------------------------------------------------*/\n')
+    out.append('const BSP_CANDB_MessageTypeDef %s_Messages[%s_MESSAGES] =\n{\n' % (prefix, prefix))
+    for msg in messages:
+        up = '%s_%s' % (prefix, msg['name'].upper())
+        out.append('  {%s_ID, %s_IDTYPE, %s_LENGTH, %s_%s_Handler},\n' % (up, up, up, prefix, msg['name']))
+    out.append('};\n\n')
+    out.append('/* Exported functions --------------------------------------------------------*/\n')
+    for msg in messages:
+        name = '%s_%s' % (prefix, msg['name'])
+        out.append('__weak void %s_RxCallback(const %s_TypeDef *pMsg)\n{\n' % (name, name))
+        out.append('  /* Prevent unused argument(s) compilation warning */\n  UNUSED(pMsg);\n')
+        out.append('  /* NOTE : This function should not be modified, when the callback is needed,\n'
+                   '            the %s_RxCallback can be implemented in the user file\n   */\n}\n\n' % name)
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='DBC to py32f4xx_bsp_candb decoders')
+    parser.add_argument('dbc')
+    parser.add_argument('--prefix', help='prefix of the C names, default the DBC file name')
+    parser.add_argument('--out', default='.', help='output directory')
+    args = parser.parse_args()
+
+    base = os.path.splitext(os.path.basename(args.dbc))[0].lower()
+    prefix = ident(args.prefix if args.prefix else base).upper()
+    messages = parse(args.dbc)
+    if not messages:
+        sys.exit('%s: no message' % args.dbc)
+
+    with open(os.path.join(args.out, base + '.h'), 'w', newline='\n') as out:
+        out.write(header(prefix, base, os.path.basename(args.dbc), messages))
+    with open(os.path.join(args.out, base + '.c'), 'w', newline='\n') as out:
+        out.write(source(prefix, base, os.path.basename(args.dbc), messages))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""Make the patch of a delta firmware update, applied by BSP_FWPATCH.
+
+Usage: fwpatch.py <old.bin> <new.bin> -o <patch> [--version N] [--window BITS]
+                  [--lookahead BITS]
+       fwpatch.py <old.bin> --apply <patch> -o <new.bin>
+
+old.bin is the binary of the image running on the device, built for its slot,
+new.bin the one of the new image built for the other slot (FW_SLOT=a or b).
+The patch is a 32-byte header, little endian:
+
+    magic "FWPT", old size, old CRC, new size, new version, new CRC,
+    window bits, lookahead bits, 0 (16 bits), ~(XOR of the 7 words above)
+
+then records compressed with the LZSS of BSP_LZSS. A record is the varints
+(7 bits a byte, low first) of the jump in the old image, zig-zag coded, of the
+bytes of difference and of the new bytes, followed by the difference bytes,
+each added to the next old byte, then the new bytes. The CRCs are the ones of
+the slot trailers: CRC-32/MPEG-2 of the little-endian words of the image
+padded with 0xFF. --apply rebuilds the new image from a patch, as the device.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x54505746
+HEADER = struct.Struct('<6I2BHI')
+GRAM = 8
+CANDIDATES = 16
+
+
+def crc(data):
+    """CRC of an image as computed by the CRC peripheral over its words."""
+    data = data + b'\xff' * (-len(data) % 4)
+    value = 0xFFFFFFFF
+    for (word,) in struct.iter_unpack('<I', data):
+        value ^= word
+        for _ in range(32):
+            value = ((value << 1) ^ 0x04C11DB7) if value & 0x80000000 else (value << 1)
+            value &= 0xFFFFFFFF
+    return value
+
+
+def varint(value):
+    """Bytes of an unsigned varint."""
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def extend(old, new, opos, npos, step, limit):
+    """Length of the approximate match from (opos, npos), going forward or back.
+
+    The length kept is the one with the most matches over mismatches, as bsdiff.
+    """
+    best = score = length = kept = 0
+    while length < limit:
+        o = opos + step * length if step > 0 else opos - 1 - length
+        n = npos + step * length if step > 0 else npos - 1 - length
+        if o < 0 or o >= len(old) or n < 0 or n >= len(new):
+            break
+        length += 1
+        score += 1 if old[o] == new[n] else -1
+        if score > best:
+            best, kept = score, length
+        if score < best - 32:
+            break
+    return kept if best > 0 else 0
+
+
+def diff(old, new):
+    """Records (old start, new start, difference length, new bytes length) of the new image."""
+    index = {}
+    for i in range(len(old) - GRAM + 1):
+        index.setdefault(old[i:i + GRAM], []).append(i)
+
+    regions = []
+    shift = 0
+    npos = 0
+    end = 0
+    while npos + GRAM <= len(new):
+        key = new[npos:npos + GRAM]
+        found = None
+        # The alignment of the previous region first: a few bytes moved by the slot change
+        if 0 <= npos + shift and old[npos + shift:npos + shift + GRAM] == key:
+            found = npos + shift
+        else:
+            best = 0
+            for candidate in index.get(key, ())[-CANDIDATES:]:
+                length = extend(old, new, candidate, npos, 1, len(new))
+                if length > best:
+                    best, found = length, candidate
+        if found is None:
+            npos += 1
+            continue
+
+        back = extend(old, new, found, npos, -1, min(npos - end, found))
+        forward = extend(old, new, found, npos, 1, len(new))
+        regions.append((found - back, npos - back, back + forward))
+        shift = found - npos
+        npos += forward
+        end = npos
+
+    records = []
+    start = 0
+    ostart = 0
+    length = 0
+    for oregion, nregion, size in regions:
+        records.append((ostart, start, length, nregion - start - length))
+        ostart, start, length = oregion, nregion, size
+    records.append((ostart, start, length, len(new) - start - length))
+    return records
+
+
+def body(old, new, records):
+    """Records as the bytes of the patch before compression."""
+    out = bytearray()
+    opos = 0
+    for ostart, nstart, length, extra in records:
+        if length == 0 and extra == 0:
+            continue
+        jump = ostart - opos
+        out += varint(jump * 2 if jump >= 0 else -jump * 2 - 1) + varint(length) + varint(extra)
+        out += bytes((new[nstart + i] - old[ostart + i]) & 0xFF for i in range(length))
+        out += new[nstart + length:nstart + length + extra]
+        opos = ostart + length
+    return bytes(out)
+
+
+def compress(data, window, lookahead):
+    """LZSS stream of BSP_LZSS: literal 1 + 8 bits, back reference 0 + distance - 1 + length - 1."""
+    bits = []
+    heads = {}
+    minimum = (1 + window + lookahead) // 9 + 1
+    pos = 0
+    while pos < len(data):
+        best = 0
+        distance = 0
+        for candidate in reversed(heads.get(data[pos:pos + 2], [])[-32:]):
+            if pos - candidate > (1 << window):
+                break
+            length = 0
+            while (length < (1 << lookahead) and pos + length < len(data)
+                   and data[candidate + length] == data[pos + length]):
+                length += 1
+            if length > best:
+                best, distance = length, pos - candidate
+        if best >= minimum:
+            bits.append((0, 1))
+            bits.append((distance - 1, window))
+            bits.append((best - 1, lookahead))
+            step = best
+        else:
+            bits.append((1, 1))
+            bits.append((data[pos], 8))
+            step = 1
+        for i in range(pos, pos + step):
+            heads.setdefault(data[i:i + 2], []).append(i)
+        pos += step
+
+    out = bytearray()
+    acc = count = 0
+    for value, width in bits:
+        acc = (acc << width) | value
+        count += width
+        while count >= 8:
+            count -= 8
+            out.append((acc >> count) & 0xFF)
+    if count:
+        out.append((acc << (8 - count)) & 0xFF)
+    return bytes(out)
+
+
+def decompress(data, window, lookahead):
+    """Bytes of an LZSS stream of BSP_LZSS."""
+    out = bytearray()
+    value = int.from_bytes(data, 'big')
+    left = len(data) * 8
+    backref = 1 + window + lookahead
+    while left >= 9:
+        if (value >> (left - 1)) & 1:
+            left -= 9
+            out.append((value >> left) & 0xFF)
+        elif left >= backref:
+            left -= backref
+            field = value >> left
+            length = (field & ((1 << lookahead) - 1)) + 1
+            distance = ((field >> lookahead) & ((1 << window) - 1)) + 1
+            for _ in range(length):
+                out.append(out[-distance])
+        else:
+            break
+    return bytes(out)
+
+
+def make(old, new, version, window, lookahead):
+    """Patch making new from old."""
+    words = [MAGIC, len(old), crc(old), len(new), version, crc(new)]
+    words.append(window | lookahead << 8)
+    check = 0
+    for word in words:
+        check ^= word
+    header = HEADER.pack(*words[:6], window, lookahead, 0, ~check & 0xFFFFFFFF)
+    return header + compress(body(old, new, diff(old, new)), window, lookahead)
+
+
+def apply(old, patch):
+    """New image of a patch, checked as the device does."""
+    magic, osize, ocrc, nsize, version, ncrc, window, lookahead, _, check = HEADER.unpack_from(patch)
+    words = struct.unpack_from('<7I', patch)
+    expected = 0
+    for word in words:
+        expected ^= word
+    if magic != MAGIC or check != ~expected & 0xFFFFFFFF:
+        sys.exit('not a patch')
+    if osize != len(old) or ocrc != crc(old):
+        sys.exit('patch not made for this image')
+
+    data = decompress(patch[HEADER.size:], window, lookahead)
+    new = bytearray()
+    pos = opos = 0
+    while len(new) < nsize:
+        fields = []
+        while len(fields) < 3:
+            value = shift = 0
+            while True:
+                byte = data[pos]
+                pos += 1
+                value |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            fields.append(value)
+        jump, length, extra = fields
+        opos += (jump >> 1) ^ -(jump & 1)
+        new += bytes((old[opos + i] + data[pos + i]) & 0xFF for i in range(length))
+        opos += length
+        pos += length
+        new += data[pos:pos + extra]
+        pos += extra
+    if crc(new) != ncrc:
+        sys.exit('wrong CRC of the new image')
+    return bytes(new), version
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('old', help='binary of the running image')
+    parser.add_argument('new', nargs='?', help='binary of the new image')
+    parser.add_argument('-o', '--output', required=True, help='patch, or new image with --apply')
+    parser.add_argument('--apply', metavar='PATCH', help='rebuild the new image from a patch')
+    parser.add_argument('--version', type=lambda s: int(s, 0), default=1, help='version of the new image')
+    parser.add_argument('--window', type=int, default=10, help='LZSS window bits, up to BSP_FWPATCH_WINDOW_BITS')
+    parser.add_argument('--lookahead', type=int, default=4, help='LZSS lookahead bits')
+    args = parser.parse_args()
+
+    with open(args.old, 'rb') as f:
+        old = f.read()
+
+    if args.apply:
+        with open(args.apply, 'rb') as f:
+            new, version = apply(old, f.read())
+        with open(args.output, 'wb') as f:
+            f.write(new)
+        print('%d bytes, version %d' % (len(new), version))
+        return
+
+    if args.new is None:
+        parser.error('the new image is needed to make a patch')
+    with open(args.new, 'rb') as f:
+        new = f.read()
+    patch = make(old, new, args.version, args.window, args.lookahead)
+    if apply(old, patch)[0] != new:
+        sys.exit('patch does not rebuild the new image')
+    with open(args.output, 'wb') as f:
+        f.write(patch)
+    print('%d bytes for an image of %d, %.1f%%' % (len(patch), len(new), 100.0 * len(patch) / len(new)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Print the records of the BSP_LOG deferred log of an image.
+
+Usage: logdecode.py <elf> (--port DEV | --input FILE | --pyocd)
+                    [--itm PORT] [--hclk HZ] [--objcopy OBJCOPY] [--nm NM]
+
+The formats are read from the .bsplog section of the ELF, which the image does
+not load. A record is little-endian words:
+
+    0xB << 28 | argument count << 24 | ID, DWT cycle count, arguments
+
+the ID being the offset of 'level|file|line|format' in .bsplog, and the ID
+0xFFFFFF the number of records lost before. --port reads the UART transport,
+--input a capture of it, or with --itm the raw SWO capture of the ITM
+transport, keeping the stimulus port given. --pyocd reads the ring of the
+memory transport in RAM through the debugger, while the core runs.
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+SYNC = 0xB
+DROPPED = 0xFFFFFF
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|j|z|t)?([diouxXcsfFeEgGp%])')
+
+
+def section(objcopy, elf):
+    """Contents of the .bsplog section of the image."""
+    with tempfile.TemporaryDirectory() as tmp:
+        out = os.path.join(tmp, 'bsplog.bin')
+        subprocess.run([objcopy, '--dump-section', '.bsplog=' + out, elf], check=True, capture_output=True)
+        with open(out, 'rb') as f:
+            return f.read()
+
+
+def symbol(nm, elf, name):
+    """Address of a symbol of the image."""
+    out = subprocess.run([nm, elf], check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == name:
+            return int(fields[0], 16)
+    sys.exit('%s not found in %s, build with USE_LOG=y' % (name, elf))
+
+
+def string(table, offset):
+    """String constant at an offset of .bsplog, None if it is not one."""
+    if offset >= len(table):
+        return None
+    end = table.find(b'\0', offset)
+    return table[offset:end if end >= 0 else len(table)].decode('utf-8', errors='replace')
+
+
+def render(table, fmt, args):
+    """The format of a record with its arguments, converted as printf would."""
+    args = list(args)
+
+    def convert(match):
+        flags, conv = match.group(1), match.group(3)
+        if conv == '%':
+            return '%'
+        if not args:
+            return '<?>'
+        value = args.pop(0)
+        if conv in 'di':
+            value -= (value & 0x80000000) << 1
+        elif conv in 'fFeEgG':
+            value = struct.unpack('<f', struct.pack('<I', value))[0]
+        elif conv == 's':
+            text = string(table, value)
+            value = '<0x%08x>' % value if text is None else text
+        elif conv == 'p':
+            conv, flags = 'x', '#' + flags
+        elif conv == 'u':
+            conv = 'd'
+        return ('%' + flags + conv) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder:
+    """Records of a byte stream, resynchronized on the sync nibble of a known ID."""
+
+    def __init__(self, table, hclk):
+        self.table = table
+        self.hclk = hclk
+        self.buffer = bytearray()
+        self.last = None
+        self.time = 0
+
+    def valid(self, word):
+        count, ident = (word >> 24) & 0x0F, word & 0xFFFFFF
+        if (word >> 28) != SYNC or count > 8:
+            return False
+        if ident == DROPPED:
+            return True
+        text = string(self.table, ident)
+        return text is not None and (ident == 0 or self.table[ident - 1] == 0) and text.count('|') >= 3
+
+    def feed(self, data):
+        self.buffer += data
+        while len(self.buffer) >= 8:
+            word = struct.unpack_from('<I', self.buffer)[0]
+            if not self.valid(word):
+                del self.buffer[0]
+                continue
+            size = 8 + 4 * ((word >> 24) & 0x0F)
+            if len(self.buffer) < size:
+                break
+            words = struct.unpack_from('<%dI' % (size // 4), self.buffer)
+            del self.buffer[:size]
+            self.record(words[0] & 0xFFFFFF, words[1], words[2:])
+
+    def record(self, ident, cycles, args):
+        # Cycle count extended over its 32 bits, records being in order
+        self.time += 0 if self.last is None else (cycles - self.last) & 0xFFFFFFFF
+        self.last = cycles
+        stamp = '%12.3f us' % (self.time * 1e6 / self.hclk) if self.hclk else '%12d cy' % self.time
+        if ident == DROPPED:
+            print('[%s] - %d records lost' % (stamp, args[0] if args else 0))
+            return
+        level, source, line, fmt = string(self.table, ident).split('|', 3)
+        print('[%s] %s %s:%s %s' % (stamp, level, os.path.basename(source), line, render(self.table, fmt, args)))
+        sys.stdout.flush()
+
+
+def itm(data, port, state):
+    """Payload of a stimulus port in a raw SWO capture, state kept over the calls."""
+    out = bytearray()
+    pending = state.get('pending', bytearray()) + data
+    i = 0
+    while i < len(pending):
+        header = pending[i]
+        if header == 0 or header == 0x80:
+            i += 1
+        elif header & 0x03:
+            size = (1, 2, 4)[(header & 0x03) - 1]
+            if i + 1 + size > len(pending):
+                break
+            if not header & 0x04 and header >> 3 == port:
+                out += pending[i + 1:i + 1 + size]
+            i += 1 + size
+        else:
+            # Overflow, timestamp or extension packet, continuation bytes skipped
+            j = i + 1
+            while header & 0x80 and j < len(pending):
+                header = pending[j]
+                j += 1
+            if header & 0x80:
+                break
+            i = j
+    state['pending'] = pending[i:]
+    return bytes(out)
+
+
+def read_pyocd(address, decoder, target_name):
+    """Ring of the memory transport read through the debugger, Released written back."""
+    try:
+        from pyocd.core.helpers import ConnectHelper
+    except ImportError:
+        sys.exit('pyocd is needed for --pyocd, pip install pyocd')
+    with ConnectHelper.session_with_chosen_probe(target_override=target_name) as session:
+        target = session.board.target
+        while True:
+            magic, buffer, size, _, committed, _, released = target.read_memory_block32(address, 7)
+            if magic != 0x474F4C42 or size == 0:
+                time.sleep(0.2)
+                continue
+            words = []
+            while released != committed:
+                offset = released & (size - 1)
+                count = min((committed - released) & 0xFFFFFFFF, size - offset)
+                words += target.read_memory_block32(buffer + 4 * offset, count)
+                released = (released + count) & 0xFFFFFFFF
+            if words:
+                target.write32(address + 24, committed)
+                decoder.feed(struct.pack('<%dI' % len(words), *words))
+            else:
+                time.sleep(0.05)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='serial port of the UART transport')
+    source.add_argument('--input', help='captured output, - for stdin')
+    source.add_argument('--pyocd', action='store_true', help='ring of the memory transport, through the debugger')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--itm', type=int, help='stimulus port of a raw SWO capture, BSP_LOG_ITM_PORT')
+    parser.add_argument('--hclk', type=float, help='HCLK in Hz, timestamps in us instead of cycles')
+    parser.add_argument('--target', default='py32f403xd', help='pyocd target')
+    parser.add_argument('--objcopy', default='arm-none-eabi-objcopy')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    args = parser.parse_args()
+
+    table = section(args.objcopy, args.elf)
+    if not table:
+        sys.exit('%s has no .bsplog section, build with USE_LOG=y' % args.elf)
+    decoder = Decoder(table, args.hclk)
+    state = {}
+
+    def feed(data):
+        decoder.feed(itm(data, args.itm, state) if args.itm is not None else data)
+
+    try:
+        if args.pyocd:
+            read_pyocd(symbol(args.nm, args.elf, 'BSP_Log'), decoder, args.target)
+        elif args.port:
+            try:
+                import serial
+            except ImportError:
+                sys.exit('pyserial is needed for --port, pip install pyserial')
+            with serial.Serial(args.port, args.baud, timeout=0.1) as tty:
+                while True:
+                    feed(tty.read(256))
+        else:
+            log = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+            with log:
+                for data in iter(lambda: log.read(4096), b''):
+                    feed(data)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Generate the lookup tables of py32f4xx_bsp_lut from an expression or points.
+
+Usage: lut2c.py <name> (--expr EXPR (--range X0 X1 | --breaks X,X,...) | --csv FILE)
+                [--type i32|f32] [--interp linear|cubic]
+                [--shift S] [--points N] [--scale K] [--prefix NAME] [--out DIR]
+
+Writes <name>.h and <name>.c: the const points and the const
+BSP_LUT_I32_TypeDef or BSP_LUT_F32_TypeDef <PREFIX>_Table, all in the flash.
+
+  --expr    Python expression of x, the math functions available, e.g. for a
+            10k NTC of B 3950 under a 10k pull-up, on 12-bit ADC codes:
+            "1/(1/298.15+log(x/(4095-x))/3950)-273.15"
+  --range   Abscissas covered by a uniform table, integers for i32.
+  --shift   i32 uniform table: step of 2^S between the points.
+  --points  f32 uniform table: number of points.
+  --breaks  Non uniform table of the expression at these abscissas, increasing.
+  --csv     Non uniform table, one "x,y" line per point, x increasing.
+  --scale   i32: the values are round(y * K), e.g. 1000 for millidegrees.
+
+The table is checked against the expression at each integer abscissa for i32,
+at 16 points by interval for f32, as bsp_lut interpolates: the largest error
+is printed, in the units of y, to choose the step and the interpolation.
+"""
+
+import argparse
+import csv
+import math
+import os
+import re
+import sys
+
+SHIFT_MAX = 24
+
+
+def ident(name):
+    """C identifier of a name."""
+    name = re.sub(r'\W', '_', name)
+    return name if not name[0].isdigit() else '_' + name
+
+
+def banner(filename, brief):
+    return ('/**\n'
+            '  ******************************************************************************\n'
+            '  * @file    %s\n'
+            '  * @brief   %s\n'
+            '  *          Generated by Misc/Tools/lut2c.py, do not edit.\n'
+            '  ******************************************************************************\n'
+            '  */\n\n' % (filename, brief))
+
+
+def function(expr):
+    """Function of x of an expression."""
+    names = {k: v for k, v in vars(math).items() if not k.startswith('_')}
+    code = compile(expr, '<expr>', 'eval')
+    return lambda x: float(eval(code, {'__builtins__': {}}, dict(names, x=x)))
+
+
+def hermite(p1, p2, d1, d2, t):
+    """Cubic Hermite of bsp_lut, the slopes doubled and scaled to the interval."""
+    d = p2 - p1
+    return p1 + 0.5 * t * (d1 + t * ((6 * d - 2 * d1 - d2) + t * (d1 + d2 - 4 * d)))
+
+
+def interpolate(xs, ys, cubic, x):
+    """Value at x of the table, as bsp_lut computes it, without the rounding."""
+    last = len(xs) - 1
+    if x <= xs[0]:
+        return ys[0]
+    if x >= xs[last]:
+        return ys[last]
+    i = max(k for k in range(last) if xs[k] <= x)
+    width = xs[i + 1] - xs[i]
+    t = (x - xs[i]) / width
+    d = ys[i + 1] - ys[i]
+    if not cubic:
+        return ys[i] + d * t
+    d1 = 2 * d if i == 0 else 2 * (ys[i + 1] - ys[i - 1]) * width / (xs[i + 1] - xs[i - 1])
+    d2 = 2 * d if i + 1 == last else 2 * (ys[i + 2] - ys[i]) * width / (xs[i + 2] - xs[i])
+    return hermite(ys[i], ys[i + 1], d1, d2, t)
+
+
+def cfloat(value):
+    text = repr(float(value))
+    return text + ('f' if ('.' in text or 'e' in text) else '.0f')
+
+
+def header(prefix, base, kind, note):
+    guard = '__%s_H' % ident(base).upper()
+    out = [banner(base + '.h', 'Header file of the %s lookup table, %s.' % (prefix, note))]
+    out.append('/* Define to prevent recursive inclusion -------------------------------------*/\n')
+    out.append('#ifndef %s\n#define %s\n\n' % (guard, guard))
+    out.append('#ifdef __cplusplus\n extern "C" {\n#endif\n\n')
+    out.append('/* Includes ------------------------------------------------------------------*/\n')
+    out.append('#include "py32f4xx_bsp_lut.h"\n\n')
+    out.append('/* Exported variables --------------------------------------------------------*/\n')
+    out.append('extern const BSP_LUT_%s_TypeDef %s_Table;\n\n' % (kind, prefix))
+    out.append('#ifdef __cplusplus\n}\n#endif\n\n#endif /* %s */\n' % guard)
+    return ''.join(out)
+
+
+def array(ctype, name, values, fmt, per_line):
+    out = ['static const %s %s[%d] =\n{\n' % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        out.append('  ' + ', '.join(fmt(v) for v in values[i:i + per_line]) + ',\n')
+    out.append('};\n\n')
+    return ''.join(out)
+
+
+def source(prefix, base, kind, note, table):
+    ctype = 'int32_t' if kind == 'I32' else 'float'
+    fmt = (lambda v: '%d' % v) if kind == 'I32' else cfloat
+    per_line = 8 if kind == 'I32' else 4
+    out = [banner(base + '.c', '%s lookup table, %s.' % (prefix, note))]
+    out.append('/* Includes ------------------------------------------------------------------*/\n')
+    out.append('#include "%s.h"\n\n' % base)
+    out.append('/* Private variables ---------------------------------------------------------*/\n')
+    if table['x'] is not None:
+        out.append(array(ctype, prefix + '_X', table['x'], fmt, per_line))
+    out.append(array(ctype, prefix + '_Y', table['y'], fmt, per_line))
+    out.append('/* Exported variables --------------------------------------------------------*/\n')
+    out.append('const BSP_LUT_%s_TypeDef %s_Table =\n{\n' % (kind, prefix))
+    out.append('  .pX      = %s,\n' % ((prefix + '_X') if table['x'] is not None else 'NULL'))
+    out.append('  .pY      = %s_Y,\n' % prefix)
+    out.append('  .Count   = %dU,\n' % len(table['y']))
+    if table['x'] is None and kind == 'I32':
+        out.append('  .X0      = %d,\n' % table['x0'])
+        out.append('  .Shift   = %dU,\n' % table['shift'])
+    elif table['x'] is None:
+        out.append('  .X0      = %s,\n' % cfloat(table['x0']))
+        out.append('  .InvStep = %s,\n' % cfloat(1.0 / table['step']))
+    out.append('  .Interp  = %s,\n' % ('BSP_LUT_CUBIC' if table['cubic'] else 'BSP_LUT_LINEAR'))
+    out.append('};\n')
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Expression or points to py32f4xx_bsp_lut tables')
+    parser.add_argument('name')
+    parser.add_argument('--expr', help='y as a Python expression of x')
+    parser.add_argument('--range', nargs=2, type=float, metavar=('X0', 'X1'))
+    parser.add_argument('--breaks', help='abscissas of a non uniform table of the expression, x,x,...')
+    parser.add_argument('--csv', help='x,y points of a non uniform table')
+    parser.add_argument('--type', choices=('i32', 'f32'), default='i32')
+    parser.add_argument('--interp', choices=('linear', 'cubic'), default='linear')
+    parser.add_argument('--shift', type=int, help='i32 uniform table, step 2^S')
+    parser.add_argument('--points', type=int, help='f32 uniform table, number of points')
+    parser.add_argument('--scale', type=float, default=1.0, help='i32 values are round(y * K)')
+    parser.add_argument('--prefix', help='prefix of the C names, default the name')
+    parser.add_argument('--out', default='.', help='output directory')
+    args = parser.parse_args()
+
+    base = args.name.lower()
+    prefix = ident(args.prefix if args.prefix else args.name).upper()
+    kind = args.type.upper()
+    cubic = args.interp == 'cubic'
+    scale = args.scale if kind == 'I32' else 1.0
+    quantize = (lambda v: int(round(v * scale))) if kind == 'I32' else float
+    table = {'x': None, 'cubic': cubic}
+
+    if args.csv:
+        with open(args.csv, newline='') as points:
+            rows = [r for r in csv.reader(points) if r and not r[0].lstrip().startswith('#')]
+        xs = [int(r[0]) if kind == 'I32' else float(r[0]) for r in rows]
+        if len(xs) < 2 or any(b <= a for a, b in zip(xs, xs[1:])):
+            sys.exit('%s: 2 points or more needed, x increasing' % args.csv)
+        table['x'] = xs
+        table['y'] = [quantize(float(r[1])) for r in rows]
+        note = 'from %s' % os.path.basename(args.csv)
+        fn = None
+    elif args.expr and args.breaks:
+        fn = function(args.expr)
+        xs = [int(v) if kind == 'I32' else float(v) for v in args.breaks.split(',')]
+        if len(xs) < 2 or any(b <= a for a, b in zip(xs, xs[1:])):
+            sys.exit('--breaks: 2 abscissas or more needed, increasing')
+        table['x'] = xs
+        table['y'] = [quantize(fn(x)) for x in xs]
+        note = 'y = %s' % args.expr
+    elif args.expr and args.range:
+        fn = function(args.expr)
+        x0, x1 = args.range
+        if kind == 'I32':
+            if args.shift is None or not 0 <= args.shift <= SHIFT_MAX:
+                sys.exit('--shift 0 to %d needed for an i32 table' % SHIFT_MAX)
+            x0, x1 = int(x0), int(x1)
+            step = 1 << args.shift
+            count = -(-(x1 - x0) // step) + 1
+            xs = [x0 + i * step for i in range(count)]
+            table.update(x0=x0, shift=args.shift)
+        else:
+            if args.points is None or args.points < 2:
+                sys.exit('--points 2 or above needed for an f32 table')
+            step = (x1 - x0) / (args.points - 1)
+            xs = [x0 + i * step for i in range(args.points)]
+            table.update(x0=x0, step=step)
+        table['y'] = [quantize(fn(x)) for x in xs]
+        note = 'y = %s' % args.expr
+    else:
+        sys.exit('--expr with --range or --breaks, or --csv, needed')
+
+    with open(os.path.join(args.out, base + '.h'), 'w', newline='\n') as out:
+        out.write(header(prefix, base, kind, note))
+    with open(os.path.join(args.out, base + '.c'), 'w', newline='\n') as out:
+        out.write(source(prefix, base, kind, note, table))
+
+    ys = [y / scale for y in table['y']]
+    if fn is not None:
+        if kind == 'I32':
+            probes = range(xs[0], xs[-1] + 1, max(1, (xs[-1] - xs[0]) // 65536))
+        else:
+            probes = [xs[i] + (xs[i + 1] - xs[i]) * k / 16.0 for i in range(len(xs) - 1) for k in range(16)]
+        worst, where = max((abs(interpolate(xs, ys, cubic, x) - fn(x)), x) for x in probes)
+        print('%s: %d points, %s, largest error %.6g at x = %g'
+              % (prefix, len(xs), args.interp, worst, where))
+    else:
+        print('%s: %d points, %s' % (prefix, len(xs), args.interp))
+
+
+if __name__ == '__main__':
+    main()
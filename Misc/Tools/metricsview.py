@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""Show the snapshots of the BSP_METRICS registry of an image.
+
+Usage: metricsview.py (--port DEV | --input FILE | --pyocd ELF)
+                      [--itm PORT] [--hclk HZ] [--plain] [--interval S]
+
+A frame is little-endian words:
+
+    0x54454D42 'BMET', kind << 24 | payload words, snapshot number,
+    DWT cycle count, payload, checksum
+
+the words after the sync summing to 0. A layout frame, kind 1, gives the count
+of metrics then per metric type | edges << 8 | value words << 16 | name words
+<< 24, the name and the bucket edges; a snapshot frame, kind 2, the count then
+the value words of all the metrics. --port reads the UART transport, --input a
+capture of it, or with --itm the raw SWO capture of the ITM transport, keeping
+the stimulus port given. --pyocd reads the frames of the memory transport in
+RAM through the debugger, requesting a snapshot every --interval seconds.
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+import time
+
+SYNC = 0x54454D42
+LAYOUT = 1
+SNAPSHOT = 2
+COUNTER, GAUGE, HISTOGRAM = 0, 1, 2
+
+
+def symbol(nm, elf, name):
+    """Address of a symbol of the image."""
+    out = subprocess.run([nm, elf], check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == name:
+            return int(fields[0], 16)
+    sys.exit('%s not found in %s, the image does not call BSP_METRICS_Init()' % (name, elf))
+
+
+def signed(value):
+    return value - ((value & 0x80000000) << 1)
+
+
+class Metric:
+    """Entry of a layout frame."""
+
+    def __init__(self, kind, name, words, edges):
+        self.kind = kind
+        self.name = name
+        self.words = words
+        self.edges = edges
+
+
+class Viewer:
+    """Frames of a byte stream, resynchronized on the sync word and the checksum."""
+
+    def __init__(self, hclk, plain):
+        self.hclk = hclk
+        self.plain = plain
+        self.buffer = bytearray()
+        self.layout = None
+        self.previous = None
+
+    def feed(self, data):
+        self.buffer += data
+        while len(self.buffer) >= 24:
+            start = self.buffer.find(struct.pack('<I', SYNC))
+            if start < 0:
+                del self.buffer[:-3]
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < 8:
+                return
+            header = struct.unpack_from('<I', self.buffer, 4)[0]
+            kind, payload = header >> 24, header & 0xFFFF
+            size = 4 * (4 + payload + 1)
+            if kind not in (LAYOUT, SNAPSHOT) or payload == 0:
+                del self.buffer[0]
+                continue
+            if len(self.buffer) < size:
+                return
+            words = struct.unpack_from('<%dI' % (size // 4), self.buffer)
+            if sum(words[1:]) & 0xFFFFFFFF:
+                del self.buffer[0]
+                continue
+            del self.buffer[:size]
+            self.frame(kind, words[2], words[3], words[4:-1])
+
+    def frame(self, kind, number, cycles, payload):
+        if kind == LAYOUT:
+            self.layout = self.parse_layout(payload)
+            self.previous = None
+        elif self.layout is None:
+            if self.plain:
+                print('snapshot %d before a layout frame, waiting for one' % number)
+        elif payload[0] != len(self.layout):
+            self.layout = None
+        else:
+            values, i = [], 1
+            for metric in self.layout:
+                values.append(payload[i:i + metric.words])
+                i += metric.words
+            self.show(number, cycles, values)
+
+    @staticmethod
+    def parse_layout(payload):
+        metrics, i = [], 1
+        for _ in range(payload[0]):
+            word = payload[i]
+            kind, edges, words, name = word & 0xFF, (word >> 8) & 0xFF, (word >> 16) & 0xFF, word >> 24
+            text = struct.pack('<%dI' % name, *payload[i + 1:i + 1 + name]).split(b'\0')[0]
+            i += 1 + name
+            metrics.append(Metric(kind, text.decode('utf-8', errors='replace'), words, payload[i:i + edges]))
+            i += edges
+        return metrics
+
+    def show(self, number, cycles, values):
+        elapsed = None
+        if self.previous is not None:
+            elapsed = (cycles - self.previous[1]) & 0xFFFFFFFF
+            if self.hclk:
+                elapsed /= self.hclk
+        unit = '/s' if self.hclk else '/snap'
+        lines = ['snapshot %d  cycle %d' % (number, cycles), '%-32s %-9s %14s %14s' % ('name', 'type', 'value', 'rate/max')]
+        for index, (metric, words) in enumerate(zip(self.layout, values)):
+            before = self.previous[0][index] if self.previous is not None else None
+            if metric.kind == COUNTER:
+                rate = ''
+                if before is not None and elapsed:
+                    delta = (words[0] - before[0]) & 0xFFFFFFFF
+                    rate = '%.1f%s' % (delta / elapsed if self.hclk else delta, unit)
+                lines.append('%-32s %-9s %14d %14s' % (metric.name, 'counter', words[0], rate))
+            elif metric.kind == GAUGE:
+                peak = str(signed(words[1])) if metric.words > 1 else ''
+                lines.append('%-32s %-9s %14d %14s' % (metric.name, 'gauge', signed(words[0]), peak))
+            else:
+                buckets, total = words[:-1], words[-1]
+                count = sum(buckets)
+                mean = '%.1f' % (total / count) if count else '-'
+                lines.append('%-32s %-9s %14d %14s' % (metric.name, 'histogram', count, 'mean ' + mean))
+                bounds = ['<%d' % edge for edge in metric.edges] + ['>=%d' % metric.edges[-1]]
+                lines.append('    ' + '  '.join('%s:%d' % pair for pair in zip(bounds, buckets)))
+        self.previous = (values, cycles)
+        if not self.plain:
+            sys.stdout.write('\x1b[H\x1b[J')
+        print('\n'.join(lines))
+        sys.stdout.flush()
+
+
+def itm(data, port, state):
+    """Payload of a stimulus port in a raw SWO capture, state kept over the calls."""
+    out = bytearray()
+    pending = state.get('pending', bytearray()) + data
+    i = 0
+    while i < len(pending):
+        header = pending[i]
+        if header == 0 or header == 0x80:
+            i += 1
+        elif header & 0x03:
+            size = (1, 2, 4)[(header & 0x03) - 1]
+            if i + 1 + size > len(pending):
+                break
+            if not header & 0x04 and header >> 3 == port:
+                out += pending[i + 1:i + 1 + size]
+            i += 1 + size
+        else:
+            # Overflow, timestamp or extension packet, continuation bytes skipped
+            j = i + 1
+            while header & 0x80 and j < len(pending):
+                header = pending[j]
+                j += 1
+            if header & 0x80:
+                break
+            i = j
+    state['pending'] = pending[i:]
+    return bytes(out)
+
+
+def read_pyocd(address, viewer, target_name, interval):
+    """Frames of the memory transport read through the debugger, a snapshot requested every interval."""
+    try:
+        from pyocd.core.helpers import ConnectHelper
+    except ImportError:
+        sys.exit('pyocd is needed for --pyocd, pip install pyocd')
+    with ConnectHelper.session_with_chosen_probe(target_override=target_name) as session:
+        target = session.board.target
+        shown = None
+        while True:
+            magic, buffer, _, length, sequence, _ = target.read_memory_block32(address, 6)
+            if magic == SYNC and not sequence & 1 and sequence != shown and length:
+                words = target.read_memory_block32(buffer, length)
+                if target.read32(address + 16) == sequence:
+                    shown = sequence
+                    viewer.feed(struct.pack('<%dI' % length, *words))
+                    continue
+            if magic == SYNC:
+                target.write32(address + 20, 1)
+            time.sleep(interval)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='serial port of the UART transport')
+    source.add_argument('--input', help='captured output, - for stdin')
+    source.add_argument('--pyocd', metavar='ELF', help='frames of the memory transport, through the debugger')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--itm', type=int, help='stimulus port of a raw SWO capture, BSP_METRICS_ITM_PORT')
+    parser.add_argument('--hclk', type=float, help='HCLK in Hz, counter rates per second instead of per snapshot')
+    parser.add_argument('--plain', action='store_true', help='print the snapshots one after the other')
+    parser.add_argument('--interval', type=float, default=1.0, help='seconds between two --pyocd snapshots')
+    parser.add_argument('--target', default='py32f403xd', help='pyocd target')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    args = parser.parse_args()
+
+    viewer = Viewer(args.hclk, args.plain or args.input is not None)
+    state = {}
+
+    def feed(data):
+        viewer.feed(itm(data, args.itm, state) if args.itm is not None else data)
+
+    try:
+        if args.pyocd:
+            read_pyocd(symbol(args.nm, args.pyocd, 'BSP_Metrics'), viewer, args.target, args.interval)
+        elif args.port:
+            try:
+                import serial
+            except ImportError:
+                sys.exit('pyserial is needed for --port, pip install pyserial')
+            with serial.Serial(args.port, args.baud, timeout=0.1) as tty:
+                while True:
+                    feed(tty.read(256))
+        else:
+            capture = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+            with capture:
+                for data in iter(lambda: capture.read(4096), b''):
+                    feed(data)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Compare the sizes of the images of the build profiles.
+
+Usage: profilereport.py [--nm NM] [--size SIZE] [--top N] <elf> <elf> ...
+
+Prints the text, data and bss of each image, given by 'make profiles' in
+the order of PROFILES, then the functions whose code changed most from the
+first image to each other: the inlining and unrolling of the speed profile,
+or what the size profile saved.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+
+def sections(size, elf):
+    """Text, data and bss bytes of an image, in the Berkeley format of size."""
+    out = subprocess.run([size, elf], check=True, capture_output=True, text=True).stdout
+    text, data, bss = out.splitlines()[1].split()[:3]
+    return int(text), int(data), int(bss)
+
+
+def functions(nm, elf):
+    """Bytes of each function of an image."""
+    out = subprocess.run([nm, '--size-sort', '-S', elf], check=True, capture_output=True, text=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in 'tTwW':
+            sizes[fields[3]] = sizes.get(fields[3], 0) + int(fields[1], 16)
+    return sizes
+
+
+def profile(elf):
+    """Name of the profile, the folder of the image."""
+    return os.path.basename(os.path.dirname(os.path.abspath(elf)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', nargs='+')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    parser.add_argument('--size', default='arm-none-eabi-size')
+    parser.add_argument('--top', type=int, default=10, help='functions listed per profile')
+    args = parser.parse_args()
+
+    for elf in args.elf:
+        if not os.path.isfile(elf):
+            sys.exit('%s not found, run make profiles' % elf)
+
+    print('%-12s %10s %10s %10s %10s' % ('profile', 'text', 'data', 'bss', 'flash'))
+    base = None
+    for elf in args.elf:
+        text, data, bss = sections(args.size, elf)
+        flash = text + data
+        delta = '' if base is None else ' %+.1f%%' % (100.0 * (flash - base) / base)
+        base = flash if base is None else base
+        print('%-12s %10d %10d %10d %10d%s' % (profile(elf), text, data, bss, flash, delta))
+
+    first = functions(args.nm, args.elf[0])
+    for elf in args.elf[1:]:
+        other = functions(args.nm, elf)
+        changes = []
+        for name in set(first) | set(other):
+            changes.append((other.get(name, 0) - first.get(name, 0), name))
+        changes.sort(key=lambda change: -abs(change[0]))
+        print('%s against %s:' % (profile(elf), profile(args.elf[0])))
+        for delta, name in changes[:args.top]:
+            if delta == 0:
+                break
+            note = ' (gone, inlined or dropped)' if name not in other else ' (new)' if name not in first else ''
+            print('    %-40s %+7d bytes%s' % (name, delta, note))
+
+
+if __name__ == '__main__':
+    main()
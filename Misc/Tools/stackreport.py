@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Report the worst case stack of main() and of the handlers from the call graph.
+
+Usage: stackreport.py <build dir> [--root NAME ...] [--top N]
+
+Reads the .ci files of gcc -fcallgraph-info=su, written next to the objects
+with USE_STACK_USAGE=y, merges them into one call graph and prints, for
+main() and each *_Handler / *_IRQHandler, the deepest chain of calls and its
+bytes. A chain through an indirect call, a recursion, a function without
+stack usage (assembly, libraries) or a dynamic frame is marked: its total is
+then a lower bound. The frame of an exception entry, 104 bytes with the FPU
+context, is added to each handler.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+NODE_RE = re.compile(r'^node:\s*\{\s*title:\s*"([^"]*)"\s*label:\s*"([^"]*)"')
+EDGE_RE = re.compile(r'^edge:\s*\{\s*sourcename:\s*"([^"]*)"\s*targetname:\s*"([^"]*)"')
+BYTES_RE = re.compile(r'(\d+) bytes \(([^)]*)\)')
+
+INDIRECT = '__indirect_call'
+EXCEPTION_FRAME = 104
+HANDLER_RE = re.compile(r'.*_(IRQ)?Handler$')
+
+
+def parse(build_dir):
+    """Frames in bytes, kinds of frame and callees of each function."""
+    frames = {}
+    kinds = {}
+    calls = {}
+    for top, _, files in os.walk(build_dir):
+        for name in files:
+            if not name.endswith('.ci'):
+                continue
+            with open(os.path.join(top, name), encoding='utf-8', errors='replace') as ci:
+                for line in ci:
+                    m = NODE_RE.match(line.strip())
+                    if m:
+                        b = BYTES_RE.search(m.group(2).replace('\\n', '\n'))
+                        if b:
+                            frames[m.group(1)] = max(frames.get(m.group(1), 0), int(b.group(1)))
+                            kinds[m.group(1)] = b.group(2)
+                        continue
+                    m = EDGE_RE.match(line.strip())
+                    if m:
+                        calls.setdefault(m.group(1), set()).add(m.group(2))
+    return frames, kinds, calls
+
+
+def worst(name, frames, kinds, calls, memo, path):
+    """Bytes, chain and flags of the deepest chain from a function."""
+    if name in memo:
+        return memo[name]
+    if name in path:
+        return 0, [name], {'recursion'}
+    if name == INDIRECT:
+        return 0, [name], {'indirect'}
+
+    flags = set()
+    if name not in frames:
+        flags.add('unknown')
+    elif kinds[name] != 'static':
+        flags.add(kinds[name])
+
+    best = (0, [], set())
+    path.add(name)
+    for callee in sorted(calls.get(name, ())):
+        result = worst(callee, frames, kinds, calls, memo, path)
+        flags |= result[2]
+        if result[0] > best[0] or not best[1]:
+            best = result
+    path.discard(name)
+
+    result = (frames.get(name, 0) + best[0], [name] + best[1], flags)
+    memo[name] = result
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('build_dir')
+    parser.add_argument('--root', action='append', default=[], help='function reported, main and the handlers by default')
+    parser.add_argument('--top', type=int, default=10, help='largest frames listed')
+    args = parser.parse_args()
+
+    frames, kinds, calls = parse(args.build_dir)
+    if not frames:
+        sys.exit('no .ci file in %s, build with USE_STACK_USAGE=y' % args.build_dir)
+
+    roots = args.root or sorted(n for n in frames if n == 'main' or HANDLER_RE.match(n))
+    memo = {}
+    handlers = 0
+    for root in roots:
+        total, chain, flags = worst(root, frames, kinds, calls, memo, set())
+        if root != 'main':
+            total += EXCEPTION_FRAME
+            handlers = max(handlers, total)
+        mark = ' (at least: %s)' % ', '.join(sorted(flags)) if flags else ''
+        print('%-32s %6d bytes%s' % (root, total, mark))
+        print('    ' + ' > '.join(c.split(':')[-1] for c in chain))
+
+    if 'main' in memo:
+        print('main and one handler              %6d bytes, each nesting level adds up to %d'
+              % (memo['main'][0] + handlers, handlers))
+
+    print('largest frames:')
+    for name in sorted(frames, key=lambda n: -frames[n])[:args.top]:
+        print('    %-40s %6d bytes %s' % (name, frames[name], kinds[name]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Flat profile of the functions of an image from the PC samples on SWO.
+
+Usage: swoprofile.py <elf> (--port DEV | --input FILE)
+                     [--baud BAUD] [--seconds S] [--top N] [--nm NM]
+
+Reads the raw SWO output of an image calling BSP_TRACE_Init() and
+BSP_TRACE_ConfigPcSampling(): a capture of the probe (the SWO viewer saving to
+a file, or 'openocd ... -c "tpiu config internal swo.bin uart off <hclk>
+<baud>"'), or the SWO pin wired to a serial port at the SWO bit rate.
+
+The PC samples are counted per function of the symbol table of the ELF,
+given by nm, then printed by count with their share of the samples. Sleep
+samples are the core in WFI or WFE. The exception trace of
+BSP_TRACE_ConfigExceptions() is counted per exception, and the stimulus port
+bytes per port; ITM overflows mean the SWO rate is too low for the sample
+period, the profile is still right but on fewer samples.
+"""
+
+import argparse
+import bisect
+import subprocess
+import sys
+import time
+
+EXCEPTIONS = {1: 'Reset', 2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault', 6: 'UsageFault',
+              11: 'SVCall', 12: 'DebugMon', 14: 'PendSV', 15: 'SysTick'}
+
+
+class Symbols:
+    """Functions of the image, sorted by address."""
+
+    def __init__(self, nm, elf):
+        out = subprocess.run([nm, '-n', '-S', '-C', elf], check=True, capture_output=True, text=True).stdout
+        self.starts, self.ends, self.names = [], [], []
+        for line in out.splitlines():
+            fields = line.split(None, 3)
+            if len(fields) == 4 and fields[2] in 'tTwW':
+                start = int(fields[0], 16) & ~1
+                self.starts.append(start)
+                self.ends.append(start + int(fields[1], 16))
+                self.names.append(fields[3])
+
+    def lookup(self, pc):
+        i = bisect.bisect_right(self.starts, pc) - 1
+        if i >= 0 and pc < self.ends[i]:
+            return self.names[i]
+        return '0x%08x' % pc
+
+
+class Parser:
+    """ITM and DWT packets of a raw SWO stream."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.pcs = {}
+        self.sleep = 0
+        self.overflows = 0
+        self.exceptions = {}
+        self.ports = {}
+
+    def feed(self, data):
+        buf = self.pending + data
+        i = 0
+        while i < len(buf):
+            header = buf[i]
+            if header in (0x00, 0x80):
+                # Synchronization
+                i += 1
+            elif header == 0x70:
+                self.overflows += 1
+                i += 1
+            elif header & 0x03:
+                size = (1, 2, 4)[(header & 0x03) - 1]
+                if i + 1 + size > len(buf):
+                    break
+                payload = int.from_bytes(buf[i + 1:i + 1 + size], 'little')
+                self.source(header >> 3, (header & 0x04) != 0, size, payload)
+                i += 1 + size
+            else:
+                # Timestamp or extension, continuation bytes while bit 7 is set
+                j = i + 1
+                last = header
+                while last & 0x80 and j < len(buf):
+                    last = buf[j]
+                    j += 1
+                if last & 0x80:
+                    break
+                i = j
+        self.pending = buf[i:]
+
+    def source(self, ident, hardware, size, payload):
+        if not hardware:
+            self.ports[ident] = self.ports.get(ident, 0) + size
+        elif ident == 2 and size == 4:
+            self.pcs[payload] = self.pcs.get(payload, 0) + 1
+        elif ident == 2:
+            self.sleep += 1
+        elif ident == 1 and size == 2:
+            number, function = payload & 0x1FF, (payload >> 12) & 0x3
+            if function == 1:
+                self.exceptions[number] = self.exceptions.get(number, 0) + 1
+
+
+def exception_name(number):
+    return EXCEPTIONS.get(number, 'IRQ %d' % (number - 16) if number >= 16 else 'exception %d' % number)
+
+
+def report(parser, symbols, top):
+    functions = {}
+    for pc, count in parser.pcs.items():
+        name = symbols.lookup(pc)
+        functions[name] = functions.get(name, 0) + count
+    total = sum(functions.values()) + parser.sleep
+    if not total:
+        sys.exit('no PC sample read, is BSP_TRACE_ConfigPcSampling() called and the SWO rate right?')
+
+    print('%10s %7s  %s' % ('samples', 'share', 'function'))
+    rows = sorted(functions.items(), key=lambda item: -item[1])
+    if parser.sleep:
+        rows = sorted(rows + [('(sleep)', parser.sleep)], key=lambda item: -item[1])
+    for name, count in rows[:top]:
+        print('%10d %6.2f%%  %s' % (count, 100.0 * count / total, name))
+    if len(rows) > top:
+        rest = sum(count for _, count in rows[top:])
+        print('%10d %6.2f%%  (%d other functions)' % (rest, 100.0 * rest / total, len(rows) - top))
+    print('%d samples, %d ITM overflows' % (total, parser.overflows))
+
+    if parser.exceptions:
+        print('\n%10s  %s' % ('entries', 'exception'))
+        for number, count in sorted(parser.exceptions.items(), key=lambda item: -item[1]):
+            print('%10d  %s' % (count, exception_name(number)))
+    if parser.ports:
+        print('\n%10s  %s' % ('bytes', 'stimulus port'))
+        for port, count in sorted(parser.ports.items()):
+            print('%10d  %d' % (count, port))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', help='serial port wired to SWO')
+    source.add_argument('--input', help='raw SWO capture, - for stdin')
+    parser.add_argument('--baud', type=int, default=2000000, help='SWO bit rate of BSP_TRACE_Init()')
+    parser.add_argument('--seconds', type=float, default=10.0, help='time read on --port')
+    parser.add_argument('--top', type=int, default=30, help='functions listed')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    args = parser.parse_args()
+
+    symbols = Symbols(args.nm, args.elf)
+    packets = Parser()
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit('pyserial is needed for --port, pip install pyserial')
+        end = time.monotonic() + args.seconds
+        with serial.Serial(args.port, args.baud, timeout=0.1) as tty:
+            while time.monotonic() < end:
+                packets.feed(tty.read(4096))
+    else:
+        log = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+        with log:
+            for data in iter(lambda: log.read(65536), b''):
+                packets.feed(data)
+
+    report(packets, symbols, args.top)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
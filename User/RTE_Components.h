@@ -0,0 +1,29 @@
+/**
+  ******************************************************************************
+  * @file    RTE_Components.h
+  * @author  MCU Application Team
+  * @brief   CMSIS component configuration, the device header of the CMSIS
+  *          sources built with USE_RTOS, os_systick.c.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) Puya Semiconductor Co.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef RTE_COMPONENTS_H
+#define RTE_COMPONENTS_H
+
+#define CMSIS_device_header "py32f4xx.h"
+
+#endif /* RTE_COMPONENTS_H */
+
+/************************ (C) COPYRIGHT Puya *****END OF FILE****/
@@ -35,9 +35,11 @@ static void APP_GpioConfig(void)
 
 static void APP_SystemClockConfig(void)
 {
+  /* With USE_FAST_BOOT, SYSCLK is already on the PLL, set by SystemEarlyInit() */
+#if !defined (USE_FAST_BOOT)
   RCC_OscInitTypeDef  OscInitstruct = {0};
   RCC_ClkInitTypeDef  ClkInitstruct = {0};
-  
+
   OscInitstruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE | 
                                   RCC_OSCILLATORTYPE_LSI | RCC_OSCILLATORTYPE_HSI48M;
   OscInitstruct.HSEState        = RCC_HSE_OFF;                              /* Disable HSE */
@@ -61,11 +63,12 @@ static void APP_SystemClockConfig(void)
   ClkInitstruct.AHBCLKDivider   = RCC_SYSCLK_DIV1;                      /* AHB clock not divided */
   ClkInitstruct.APB1CLKDivider  = RCC_HCLK_DIV1;                        /* APB1 clock not divided */
   ClkInitstruct.APB2CLKDivider  = RCC_HCLK_DIV2;                        /* APB1 clock divided by 2 */
-  /* Configure Clocks */
-  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_0) != HAL_OK)
+  /* Configure Clocks, with the fewest FLASH wait states for the new HCLK */
+  if(HAL_RCC_ClockConfig(&ClkInitstruct, FLASH_LATENCY_AUTO) != HAL_OK)
   {
     APP_ErrorHandler();
   }
+#endif /* USE_FAST_BOOT */
 }
 
 void APP_ErrorHandler(void)
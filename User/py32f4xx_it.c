@@ -33,6 +33,9 @@
 #include "py32f4xx_it.h"
 
 /* Private includes ----------------------------------------------------------*/
+#if defined (USE_BSP_RTOS)
+#include "py32f4xx_bsp_rtos.h"
+#endif
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
@@ -53,6 +56,7 @@ void NMI_Handler(void)
 {
 }
 
+#if !defined (USE_BSP_FAULT)
 /**
   * @brief  This function handles Hard Fault exception.
   * @param  None
@@ -104,6 +108,7 @@ void UsageFault_Handler(void)
   {
   }
 }
+#endif /* USE_BSP_FAULT */
 
 /**
   * @brief  This function handles SVCall exception.
@@ -114,32 +119,42 @@ void SVC_Handler(void)
 {
 }
 
+#if !defined (USE_BSP_GUARD)
 /**
   * @brief  This function handles Debug Monitor exception.
+  * @note   With USE_BSP_GUARD, the one of py32f4xx_bsp_guard.c reports the memory guard hits.
   * @param  None
   * @retval None
   */
 void DebugMon_Handler(void)
 {
 }
+#endif /* USE_BSP_GUARD */
 
+#if !defined (USE_BSP_RTOS)
 /**
   * @brief  This function handles PendSVC exception.
+  * @note   With USE_BSP_RTOS, the one of py32f4xx_bsp_rtos.c switches the threads.
   * @param  None
   * @retval None
   */
 void PendSV_Handler(void)
 {
 }
+#endif /* USE_BSP_RTOS */
 
 /**
   * @brief  This function handles SysTick Handler.
   * @param  None
   * @retval None
   */
-void SysTick_Handler(void)
+__FLASH_RAM_FUNC void SysTick_Handler(void)
 {
+#if defined (USE_BSP_RTOS)
+  BSP_RTOS_TickHandler();
+#else
   HAL_IncTick();
+#endif
 }
 
 /******************************************************************************/
@@ -10,6 +10,8 @@ CC			= $(PREFIX)gcc
 AS			= $(PREFIX)as
 LD			= $(PREFIX)ld
 OBJCOPY		= $(PREFIX)objcopy
+NM			= $(PREFIX)nm
+SIZE		= $(PREFIX)size
 # `$(shell pwd)` or `.`, both works
 TOP			= .
 BDIR		= $(TOP)/$(BUILD_DIR)
@@ -37,8 +39,21 @@ ARCH_FLAGS	:= -mthumb -mcpu=cortex-m4 -mfpu=fpv4-sp-d16 -mfloat-abi=hard
 #  -gdwarf: in DWARF format, -gdwarf-2,-gdwarf-3,-gdwarf-4,-gdwarf-5
 DEBUG_FLAGS ?= -gdwarf-3
 
-# c flags
+# Optimization of the profile, OPT and LTO given on the command line win
+ifeq ($(BUILD_PROFILE),speed)
+OPT			?= -O2
+LTO			?= y
+else ifeq ($(BUILD_PROFILE),size)
+OPT			?= -Os
+LTO			?= y
+else ifeq ($(BUILD_PROFILE),debug)
 OPT			?= -Og
+LTO			?= n
+else
+$(error BUILD_PROFILE $(BUILD_PROFILE) unknown, debug, speed or size)
+endif
+
+# c flags
 CSTD		?= -std=c99
 TGT_CFLAGS 	+= $(ARCH_FLAGS) $(DEBUG_FLAGS) $(OPT) $(CSTD) $(addprefix -D, $(LIB_FLAGS)) -Wall -ffunction-sections -fdata-sections
 
@@ -49,7 +64,10 @@ TGT_ASFLAGS += $(ARCH_FLAGS) $(DEBUG_FLAGS) $(OPT) -Wa,--warn
 TGT_LDFLAGS += $(ARCH_FLAGS) -specs=nano.specs -specs=nosys.specs -static -lc -lm \
 				-Wl,-Map=$(BDIR)/$(PROJECT).map \
 				-Wl,--gc-sections \
-				-Wl,--print-memory-usage
+				-Wl,--print-memory-usage \
+				$(if $(filter y,$(USE_DATALZ)),-L$(TOP)/Libraries/LDScripts/DataLz) \
+				-L$(TOP)/$(dir $(LDSCRIPT)) \
+				-L$(TOP)/Libraries/LDScripts
 
 GCC_VERSION := $(shell $(CC) -dumpversion)
 IS_GCC_ABOVE_12 := $(shell expr "$(GCC_VERSION)" ">=" "12")
@@ -57,17 +75,41 @@ ifeq "$(IS_GCC_ABOVE_12)" "1"
     TGT_LDFLAGS += -Wl,--no-warn-rwx-segments
 endif
 
-ifeq ($(ENABLE_PRINTF_FLOAT),y)
+# Link time optimization, the link run at $(OPT). The options of each object
+# are kept for its functions, HOT_OPT included
+ifeq ($(LTO),y)
+TGT_CFLAGS	+= -flto
+TGT_LDFLAGS	+= $(OPT) -flto
+endif
+
+# .su and .ci files next to the objects, read by Misc/Tools/stackreport.py
+ifeq ($(USE_STACK_USAGE),y)
+TGT_CFLAGS	+= -fstack-usage -fcallgraph-info=su
+endif
+
+# Floats of the newlib-nano printf(), not needed by the one of USE_PRINTF
+ifeq ($(ENABLE_PRINTF_FLOAT)-$(USE_PRINTF),y-n)
 TGT_LDFLAGS	+= -u _printf_float
 endif
 
+# Sections left out of the flash images: the external flash image apart, and
+# .data linked in RAM only when decoded from .datalz
+OBJCOPY_REMOVE	:= -R .extflash $(if $(filter y,$(USE_DATALZ)),-R .data)
+
 # include paths
 TGT_INCFLAGS := $(addprefix -I $(TOP)/, $(INCLUDES))
 
+# HOT_OPT for the objects of HOT_SOURCES, after $(OPT) to override it
+ifeq ($(BUILD_PROFILE),speed)
+$(foreach src, $(filter %.c, $(HOT_SOURCES)), $(eval $(BDIR)/$(src:.c=.o): HOT_CFLAGS := $(HOT_OPT)))
+$(foreach dir, $(filter-out %.c, $(HOT_SOURCES)), $(eval $(BDIR)/$(dir:%/=%)/%.o: HOT_CFLAGS := $(HOT_OPT)))
+endif
+
 
-.PHONY: all clean flash echo
+.PHONY: all clean flash echo stack profiles bench
 
-all: fullcheck $(BDIR)/$(PROJECT).elf $(BDIR)/$(PROJECT).bin $(BDIR)/$(PROJECT).hex
+all: fullcheck $(BDIR)/$(PROJECT).elf $(BDIR)/$(PROJECT).bin $(BDIR)/$(PROJECT).hex \
+	$(if $(filter y,$(USE_EXTFLASH)),$(BDIR)/$(PROJECT)_extflash.bin)
 
 fullcheck:
 	@if [ '$(findstring PY32F07,$(MCU_TYPE))' = 'PY32F07' ] && [ '$(USE_LL_LIB)' = 'y' ]; then \
@@ -90,7 +132,7 @@ echo:
 $(BDIR)/%.o: %.c
 	@printf "  CC\t$<\n"
 	@mkdir -p $(dir $@)
-	$(Q)$(CC) $(TGT_CFLAGS) $(TGT_INCFLAGS) -MT $@ -o $@ -c $< -MD -MF $(BDIR)/$*.d -MP
+	$(Q)$(CC) $(TGT_CFLAGS) $(HOT_CFLAGS) $(TGT_INCFLAGS) -MT $@ -o $@ -c $< -MD -MF $(BDIR)/$*.d -MP
 
 # Compile asm to obj
 $(BDIR)/%.o: %.s
@@ -99,19 +141,64 @@ $(BDIR)/%.o: %.s
 	$(Q)$(CC) $(TGT_ASFLAGS) -o $@ -c $<
 
 # Link object files to elf
+ifeq ($(USE_DATALZ),y)
+# Twice: the .data of the first link compressed by Misc/Tools/datalz.py into
+# the .datalz section of the second one, then checked against it
+$(BDIR)/$(PROJECT).elf: $(OBJS) $(TOP)/$(LDSCRIPT)
+	@printf "  LD\t$(LDSCRIPT) -> $(BDIR)/$(PROJECT)_nolz.elf\n"
+	$(Q)$(CC) $(TGT_LDFLAGS) -T$(TOP)/$(LDSCRIPT) $(OBJS) -o $(BDIR)/$(PROJECT)_nolz.elf > /dev/null
+	$(Q)python3 $(TOP)/Misc/Tools/datalz.py pack $(BDIR)/$(PROJECT)_nolz.elf $(BDIR)/$(PROJECT)_datalz.bin --objcopy $(OBJCOPY)
+	$(Q)$(CC) $(TGT_ASFLAGS) -o $(BDIR)/$(PROJECT)_datalz.o -c $(BDIR)/$(PROJECT)_datalz.s
+	@printf "  LD\t$(LDSCRIPT) -> $@\n"
+	$(Q)$(CC) $(TGT_LDFLAGS) -T$(TOP)/$(LDSCRIPT) $(OBJS) $(BDIR)/$(PROJECT)_datalz.o -o $@
+	$(Q)python3 $(TOP)/Misc/Tools/datalz.py check $@ $(BDIR)/$(PROJECT)_datalz.bin --objcopy $(OBJCOPY)
+else
 $(BDIR)/$(PROJECT).elf: $(OBJS) $(TOP)/$(LDSCRIPT)
 	@printf "  LD\t$(LDSCRIPT) -> $@\n"
 	$(Q)$(CC) $(TGT_LDFLAGS) -T$(TOP)/$(LDSCRIPT) $(OBJS) -o $@
+endif
+
+# Linker script of a FW_SLOT, the memory of MCU_TYPE set in the template
+$(BDIR)/%.ld: $(TOP)/Libraries/LDScripts/py32f403xx_slot.ld.in $(TOP)/Makefile
+	@printf "  GEN\t$@\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(CC) -E -P -undef -x c $(addprefix -D, $(LDSCRIPT_FLAGS)) $< -o $@
+
+# Convert elf to bin, the external flash section apart
+%_extflash.bin: %.elf
+	@printf "  OBJCP BIN\t$@\n"
+	$(Q)$(OBJCOPY) -I elf32-littlearm -O binary -j .extflash $< $@
 
-# Convert elf to bin
 %.bin: %.elf
 	@printf "  OBJCP BIN\t$@\n"
-	$(Q)$(OBJCOPY) -I elf32-littlearm -O binary  $< $@
+	$(Q)$(OBJCOPY) -I elf32-littlearm -O binary $(OBJCOPY_REMOVE) $< $@
 
 # Convert elf to hex
 %.hex: %.elf
 	@printf "  OBJCP HEX\t$@\n"
-	$(Q)$(OBJCOPY) -I elf32-littlearm -O ihex  $< $@
+	$(Q)$(OBJCOPY) -I elf32-littlearm -O ihex $(OBJCOPY_REMOVE) $< $@
+
+# Worst case stack of main() and of the handlers, built with USE_STACK_USAGE=y
+stack: $(BDIR)/$(PROJECT).elf
+	$(Q)python3 $(TOP)/Misc/Tools/stackreport.py $(BDIR)
+
+# Each of PROFILES built apart, then their sizes side by side. Run the
+# Benchmark examples built this way for the cycles of each profile
+profiles:
+	$(Q)for p in $(PROFILES); do \
+		$(MAKE) --no-print-directory BUILD_PROFILE=$$p BUILD_DIR=$(BUILD_DIR)/$$p all > /dev/null || exit 1; \
+	done
+	$(Q)python3 $(TOP)/Misc/Tools/profilereport.py --nm $(NM) --size $(SIZE) \
+		$(foreach p, $(PROFILES), $(BDIR)/$(p)/$(PROJECT).elf)
+
+# Flash the image and compare the BENCH lines it prints with BENCH_BASELINE,
+# the exit status is 1 on a regression over BENCH_THRESHOLD percent
+bench: all
+	$(Q)$(MAKE) --no-print-directory flash
+	$(Q)python3 $(TOP)/Misc/Tools/benchreport.py \
+		$(if $(BENCH_COMMAND),--command '$(BENCH_COMMAND)',--port $(BENCH_PORT)) \
+		--baseline $(BENCH_BASELINE) --threshold $(BENCH_THRESHOLD) --runs $(BENCH_RUNS) \
+		$(if $(filter y,$(BENCH_UPDATE)),--update)
 
 clean:
 	rm -rf $(BDIR)/*